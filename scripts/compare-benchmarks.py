@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+#
+# Compare two JSON result files of mlpack_benchmark (e.g. of two commits), and
+# print the ratio of the median times of the cases that appear in both.
+#
+# Usage:
+#
+#   scripts/compare-benchmarks.py old.json new.json [--threshold 0.1]
+#
+# The exit status is 1 if any case is slower than the threshold (by default,
+# 10% slower).
+import argparse
+import json
+import sys
+
+parser = argparse.ArgumentParser(
+    description='Compare the results of two runs of mlpack_benchmark.')
+parser.add_argument('old', help='JSON results of the baseline.')
+parser.add_argument('new', help='JSON results to compare to the baseline.')
+parser.add_argument('--threshold', type=float, default=0.1,
+    help='Relative slowdown of the median above which a case is reported as a '
+    'regression.')
+args = parser.parse_args()
+
+def load(filename):
+  with open(filename) as f:
+    results = json.load(f)
+  return { b['name']: b for b in results['benchmarks'] }
+
+old = load(args.old)
+new = load(args.new)
+
+regressions = 0
+width = max([len(name) for name in old.keys() & new.keys()] + [4])
+print('%-*s %12s %12s %8s' % (width, 'case', 'old (s)', 'new (s)', 'ratio'))
+for name in sorted(old.keys() & new.keys()):
+  o = old[name]['median']
+  n = new[name]['median']
+  ratio = n / o if o > 0 else float('inf')
+  flag = ''
+  if ratio > 1.0 + args.threshold:
+    flag = '  slower'
+    regressions += 1
+  elif ratio < 1.0 - args.threshold:
+    flag = '  faster'
+  print('%-*s %12.6f %12.6f %8.3f%s' % (width, name, o, n, ratio, flag))
+
+for name in sorted(old.keys() - new.keys()):
+  print('%-*s only in %s' % (width, name, args.old))
+for name in sorted(new.keys() - old.keys()):
+  print('%-*s only in %s' % (width, name, args.new))
+
+sys.exit(1 if regressions > 0 else 0)
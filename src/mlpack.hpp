@@ -42,7 +42,9 @@
 #include "mlpack/methods/fastmks.hpp"
 #include "mlpack/methods/gmm.hpp"
 #include "mlpack/methods/hmm.hpp"
+#include "mlpack/methods/hnsw.hpp"
 #include "mlpack/methods/hoeffding_trees.hpp"
+#include "mlpack/methods/ivf_pq.hpp"
 #include "mlpack/methods/kde.hpp"
 #include "mlpack/methods/kernel_pca.hpp"
 #include "mlpack/methods/kmeans.hpp"
@@ -75,6 +77,7 @@
 #include "mlpack/methods/sparse_autoencoder.hpp"
 #include "mlpack/methods/sparse_coding.hpp"
 #include "mlpack/methods/svdplusplus.hpp"
+#include "mlpack/methods/xgboost.hpp"
 
 // Include reverse compatibility.
 #include "mlpack/namespace_compat.hpp"
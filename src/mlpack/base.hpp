@@ -100,8 +100,24 @@
   #define MLPACK_STRING_VIEW core::v2::string_view
 #endif
 
+// If memory tracking is enabled, Armadillo allocates through the counting
+// functions of MemoryTracker.
+#ifdef MLPACK_TRACK_MEMORY
+  #include <mlpack/core/util/memory_tracker.hpp>
+  #define ARMA_ALIEN_MEM_ALLOC_FUNCTION mlpack::MemoryTracker::ArmaAllocate
+  #define ARMA_ALIEN_MEM_FREE_FUNCTION mlpack::MemoryTracker::ArmaFree
+#endif
+
 // Now include Armadillo through the special mlpack extensions.
 #include <mlpack/core/arma_extend/arma_extend.hpp>
+
+// If mlpack is used with Bandicoot (the GPU linear algebra library with an
+// Armadillo-like API), MLPACK_HAS_COOT must be defined, and Bandicoot is
+// included here.
+#ifdef MLPACK_HAS_COOT
+  #include <bandicoot>
+#endif
+
 #include <mlpack/core/util/arma_traits.hpp>
 
 // On Visual Studio, disable C4519 (default arguments for function templates)
@@ -0,0 +1,147 @@
+/**
+ * @file benchmarks/ann_benchmark.cpp
+ *
+ * Benchmarks of the forward and backward passes of individual FFN layers, and
+ * of a whole small network.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann.hpp>
+
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+/**
+ * Time the forward pass, the backward pass and (for layers with weights) the
+ * gradient computation of the given layer, on a batch of random inputs.
+ *
+ * @param runner Runner of the benchmarks.
+ * @param name Name of the layer.
+ * @param layer Layer to time.
+ * @param inputDimensions Dimensions of one input of the layer.
+ * @param batchSize Number of inputs in the batch.
+ */
+void BenchmarkLayer(BenchmarkRunner& runner,
+                    const std::string& name,
+                    Layer<arma::mat>& layer,
+                    const std::vector<size_t>& inputDimensions,
+                    const size_t batchSize)
+{
+  const std::string prefix = "ann/" + name;
+  if (!runner.Selected(prefix))
+    return;
+
+  layer.InputDimensions() = inputDimensions;
+  layer.ComputeOutputDimensions();
+  arma::mat weights(layer.WeightSize(), 1, arma::fill::randn);
+  weights *= 0.01;
+  if (layer.WeightSize() > 0)
+    layer.SetWeights(weights.memptr());
+  layer.Training() = true;
+
+  size_t inputSize = 1;
+  for (const size_t d : inputDimensions)
+    inputSize *= d;
+
+  const arma::mat input(inputSize, batchSize, arma::fill::randn);
+  arma::mat output(layer.OutputSize(), batchSize);
+  const arma::mat gy(layer.OutputSize(), batchSize, arma::fill::randn);
+  arma::mat g(inputSize, batchSize);
+  arma::mat gradient(layer.WeightSize(), 1);
+
+  runner.Run(prefix + "/forward", [&]() { layer.Forward(input, output); });
+  layer.Forward(input, output);
+  runner.Run(prefix + "/backward", [&]()
+  {
+    layer.Backward(input, output, gy, g);
+  });
+  if (layer.WeightSize() > 0)
+  {
+    runner.Run(prefix + "/gradient", [&]()
+    {
+      layer.Gradient(input, gy, gradient);
+    });
+  }
+}
+
+BENCHMARK_CASE(ANNLayerBenchmark)
+{
+  const size_t batchSize = 64;
+
+  Linear linear(256);
+  BenchmarkLayer(runner, "linear/256x256", linear, { 256 }, batchSize);
+
+  LinearNoBias linearNoBias(256);
+  BenchmarkLayer(runner, "linear-no-bias/256x256", linearNoBias, { 256 },
+      batchSize);
+
+  ReLU relu;
+  BenchmarkLayer(runner, "relu/1024", relu, { 1024 }, batchSize);
+
+  Sigmoid sigmoid;
+  BenchmarkLayer(runner, "sigmoid/1024", sigmoid, { 1024 }, batchSize);
+
+  LogSoftMax logSoftMax;
+  BenchmarkLayer(runner, "log-softmax/1024", logSoftMax, { 1024 }, batchSize);
+
+  Dropout dropout(0.5);
+  BenchmarkLayer(runner, "dropout/1024", dropout, { 1024 }, batchSize);
+
+  BatchNorm batchNorm;
+  BenchmarkLayer(runner, "batch-norm/1024", batchNorm, { 1024 }, batchSize);
+
+  LayerNorm layerNorm;
+  BenchmarkLayer(runner, "layer-norm/1024", layerNorm, { 1024 }, batchSize);
+
+  Convolution convolution(16, 3, 3);
+  BenchmarkLayer(runner, "convolution/28x28x1-16x3x3", convolution,
+      { 28, 28, 1 }, batchSize);
+
+  Convolution deepConvolution(32, 3, 3, 1, 1, 1, 1);
+  BenchmarkLayer(runner, "convolution/14x14x16-32x3x3", deepConvolution,
+      { 14, 14, 16 }, batchSize);
+
+  MaxPooling maxPooling(2, 2, 2, 2);
+  BenchmarkLayer(runner, "max-pooling/28x28x16-2x2", maxPooling,
+      { 28, 28, 16 }, batchSize);
+
+  MeanPooling meanPooling(2, 2, 2, 2);
+  BenchmarkLayer(runner, "mean-pooling/28x28x16-2x2", meanPooling,
+      { 28, 28, 16 }, batchSize);
+}
+
+BENCHMARK_CASE(FFNBenchmark)
+{
+  if (!runner.Selected("ann/ffn"))
+    return;
+
+  // A multilayer perceptron for inputs of the size of MNIST digits.
+  FFN<NegativeLogLikelihood> model;
+  model.Add<Linear>(256);
+  model.Add<ReLU>();
+  model.Add<Linear>(10);
+  model.Add<LogSoftMax>();
+  model.Reset(784);
+
+  const arma::mat inputs(784, 128, arma::fill::randu);
+  arma::mat targets(1, 128);
+  for (size_t i = 0; i < targets.n_cols; ++i)
+    targets[i] = i % 10;
+
+  arma::mat results, gradients;
+  runner.Run("ann/ffn/mlp-784-256-10/forward", [&]()
+  {
+    model.Forward(inputs, results);
+  });
+  runner.Run("ann/ffn/mlp-784-256-10/forward-backward", [&]()
+  {
+    model.Forward(inputs, results);
+    DoNotOptimize(model.Backward(inputs, targets, gradients));
+  });
+}
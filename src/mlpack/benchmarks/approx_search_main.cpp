@@ -0,0 +1,620 @@
+/**
+ * @file benchmarks/approx_search_main.cpp
+ *
+ * Entry point of mlpack_approx_search_benchmark, which compares the
+ * approximate neighbor search methods of mlpack on one dataset.  The exact
+ * neighbors of the queries are computed once (and optionally cached), then the
+ * parameters of each method are swept; for each setting the build time, the
+ * size of the model, the query throughput and the recall@k are measured, and
+ * the settings that are not dominated in recall and throughput (the Pareto
+ * frontier) are printed.
+ *
+ * The swept methods are LSHSearch (projections, tables and multiprobe bins),
+ * RASearch (tau and alpha), defeatist search on spill trees (overlap tau),
+ * dual-tree kd-tree search with a relative error (epsilon), and QDAFN (l and
+ * m).  QDAFN searches for furthest neighbors, so its recall is computed
+ * against the exact furthest neighbors and it has its own frontier.
+ *
+ * Usage:
+ *
+ *   mlpack_approx_search_benchmark [--reference <file>] [--query <file>]
+ *       [--num_queries <n>] [--k <k>] [--ground_truth <prefix>]
+ *       [--filter <substring>] [--repetitions <n>] [--output <file.csv>]
+ *       [--verbose]
+ *
+ * If no reference set is given, a synthetic mixture of Gaussians is used; if no
+ * query set is given, the queries are held out from the reference set.  With
+ * --ground_truth, the exact neighbors are loaded from (or saved to)
+ * <prefix>.knn.neighbors.bin and similar files; the cache is only checked
+ * against the number of queries and k, so use a different prefix for each
+ * dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/approx_kfn.hpp>
+#include <mlpack/methods/lsh.hpp>
+#include <mlpack/methods/neighbor_search.hpp>
+#include <mlpack/methods/rann.hpp>
+
+using namespace mlpack;
+
+/**
+ * The measurements of one setting of one approximate search method.
+ */
+struct ApproxSearchResult
+{
+  //! Name of the method, e.g. "lsh".
+  std::string method;
+  //! Values of the swept parameters, e.g. "projections=10 tables=30 T=0".
+  std::string parameters;
+  //! Whether the method searches for furthest neighbors.
+  bool furthest;
+  //! Time to build the model, in seconds.
+  double buildTime;
+  //! Size of the serialized model, in bytes (this includes the copy of the
+  //! reference set held by the model).
+  size_t modelSize;
+  //! Number of queries answered per second (median of the repetitions).
+  double queriesPerSecond;
+  //! Fraction of the true k neighbors that were found.
+  double recall;
+  //! Whether no other setting has both a higher recall and a higher throughput.
+  bool frontier;
+};
+
+/**
+ * Return the number of seconds taken by the given function.
+ */
+template<typename FunctionType>
+double Time(const FunctionType& function)
+{
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  function();
+  const std::chrono::steady_clock::time_point end =
+      std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+/**
+ * Return the size of the given model once serialized in binary form, which is
+ * an estimate of the memory it uses.
+ */
+template<typename ModelType>
+size_t SerializedSize(ModelType& model)
+{
+  std::ostringstream stream;
+  {
+    cereal::BinaryOutputArchive ar(stream);
+    ar(cereal::make_nvp("model", model));
+  }
+  return stream.str().size();
+}
+
+/**
+ * Load the exact k nearest (or furthest) neighbors of the queries from the
+ * cache, or compute them with an exact dual-tree search and save them to the
+ * cache.  The cache is not used if its name is empty.
+ */
+template<typename SortPolicy>
+void GroundTruth(const arma::mat& referenceSet,
+                 const arma::mat& querySet,
+                 const size_t k,
+                 const std::string& cache,
+                 arma::Mat<size_t>& neighbors,
+                 arma::mat& distances)
+{
+  const std::string neighborsFile = cache + ".neighbors.bin";
+  const std::string distancesFile = cache + ".distances.bin";
+  if (!cache.empty() &&
+      data::Load(neighborsFile, neighbors, false, false) &&
+      data::Load(distancesFile, distances, false, false) &&
+      neighbors.n_rows >= k && neighbors.n_cols == querySet.n_cols &&
+      distances.n_rows == neighbors.n_rows &&
+      distances.n_cols == neighbors.n_cols)
+  {
+    Log::Info << "Loaded the exact neighbors from '" << neighborsFile << "'."
+        << std::endl;
+    neighbors = neighbors.rows(0, k - 1);
+    distances = distances.rows(0, k - 1);
+    return;
+  }
+
+  NeighborSearch<SortPolicy> exact(referenceSet);
+  const double time = Time([&]()
+  {
+    exact.Search(querySet, k, neighbors, distances);
+  });
+  Log::Info << "Computed the exact neighbors in " << time << "s." << std::endl;
+
+  if (!cache.empty())
+  {
+    data::Save(neighborsFile, neighbors, false, false);
+    data::Save(distancesFile, distances, false, false);
+  }
+}
+
+/**
+ * Runs the approximate searches that match the filter and keeps their
+ * results.
+ */
+class ApproxSearchBenchmark
+{
+ public:
+  ApproxSearchBenchmark(const arma::mat& referenceSet,
+                        const arma::mat& querySet,
+                        const size_t k,
+                        const std::string& filter,
+                        const size_t repetitions,
+                        const std::string& groundTruth) :
+      referenceSet(referenceSet),
+      querySet(querySet),
+      k(k),
+      filter(filter),
+      repetitions(std::max(size_t(1), repetitions)),
+      groundTruth(groundTruth)
+  { }
+
+  //! Return whether the given method would be run.
+  bool Selected(const std::string& method) const
+  {
+    return method.find(filter) != std::string::npos;
+  }
+
+  /**
+   * Time the given search (once untimed, then the given number of times) and
+   * compute its recall@k against the exact neighbors.
+   *
+   * @param method Name of the method.
+   * @param parameters Values of the swept parameters.
+   * @param furthest Whether the search is for furthest neighbors.
+   * @param buildTime Time taken to build the model.
+   * @param modelSize Size of the serialized model.
+   * @param search Search function, which stores the found neighbors.
+   */
+  void Evaluate(const std::string& method,
+                const std::string& parameters,
+                const bool furthest,
+                const double buildTime,
+                const size_t modelSize,
+                const std::function<void(arma::Mat<size_t>&)>& search)
+  {
+    arma::Mat<size_t> neighbors;
+    std::vector<double> times;
+    for (size_t i = 0; i <= repetitions; ++i)
+    {
+      const double time = Time([&]() { search(neighbors); });
+      // The first run only warms up.
+      if (i > 0)
+        times.push_back(time);
+    }
+    std::sort(times.begin(), times.end());
+
+    ApproxSearchResult result;
+    result.method = method;
+    result.parameters = parameters;
+    result.furthest = furthest;
+    result.buildTime = buildTime;
+    result.modelSize = modelSize;
+    result.queriesPerSecond = querySet.n_cols / times[times.size() / 2];
+    result.recall = LSHSearch<>::ComputeRecall(neighbors,
+        furthest ? ExactFurthest() : ExactNearest());
+    result.frontier = false;
+    results.push_back(result);
+
+    Log::Info << method << " (" << parameters << "): recall " << result.recall
+        << ", " << result.queriesPerSecond << " queries/s." << std::endl;
+  }
+
+  //! Sweep the number of projections, of tables and of multiprobe bins of
+  //! LSHSearch.
+  void RunLSH()
+  {
+    if (!Selected("lsh"))
+      return;
+
+    for (const size_t numProj : { 5, 10, 20 })
+    {
+      for (const size_t numTables : { 5, 10, 30 })
+      {
+        LSHSearch<> lsh;
+        const double buildTime = Time([&]()
+        {
+          lsh.Train(referenceSet, numProj, numTables);
+        });
+        const size_t modelSize = SerializedSize(lsh);
+
+        for (const size_t T : { 0, 5, 20 })
+        {
+          std::ostringstream parameters;
+          parameters << "projections=" << numProj << " tables=" << numTables
+              << " T=" << T;
+          Evaluate("lsh", parameters.str(), false, buildTime, modelSize,
+              [&](arma::Mat<size_t>& neighbors)
+          {
+            arma::mat distances;
+            lsh.Search(querySet, k, neighbors, distances, 0, T);
+          });
+        }
+      }
+    }
+  }
+
+  //! Sweep tau and alpha of RASearch (dual-tree, on a kd-tree).
+  void RunRASearch()
+  {
+    if (!Selected("rann"))
+      return;
+
+    std::unique_ptr<KRANN> rann;
+    const double buildTime = Time([&]()
+    {
+      rann.reset(new KRANN(referenceSet));
+    });
+    const size_t modelSize = SerializedSize(*rann);
+
+    for (const double tau : { 1.0, 2.0, 5.0, 10.0 })
+    {
+      // tau is too low if the top tau percent of the points holds fewer than k
+      // points.
+      if (tau * referenceSet.n_cols / 100.0 <= k)
+        continue;
+
+      for (const double alpha : { 0.9, 0.95, 0.99 })
+      {
+        std::ostringstream parameters;
+        parameters << "tau=" << tau << " alpha=" << alpha;
+        rann->Tau() = tau;
+        rann->Alpha() = alpha;
+        Evaluate("rann", parameters.str(), false, buildTime, modelSize,
+            [&](arma::Mat<size_t>& neighbors)
+        {
+          arma::mat distances;
+          rann->Search(querySet, k, neighbors, distances);
+        });
+      }
+    }
+  }
+
+  //! Sweep the overlap of spill trees, as a multiple of the mean distance to
+  //! the exact kth nearest neighbor, with defeatist single-tree search.
+  void RunSpillTree()
+  {
+    if (!Selected("spill"))
+      return;
+
+    const double scale = arma::mean(ExactNearestDistances().row(k - 1));
+    for (const double factor : { 0.0, 0.25, 0.5, 1.0, 2.0 })
+    {
+      const double tau = factor * scale;
+      std::unique_ptr<SpillKNN> knn;
+      const double buildTime = Time([&]()
+      {
+        SpillKNN::Tree tree(referenceSet, tau);
+        knn.reset(new SpillKNN(std::move(tree), SINGLE_TREE_MODE));
+      });
+
+      std::ostringstream parameters;
+      parameters << "tau=" << tau;
+      Evaluate("spill", parameters.str(), false, buildTime,
+          SerializedSize(*knn), [&](arma::Mat<size_t>& neighbors)
+      {
+        arma::mat distances;
+        knn->Search(querySet, k, neighbors, distances);
+      });
+    }
+  }
+
+  //! Sweep the relative error of dual-tree search on a kd-tree.
+  void RunKDTree()
+  {
+    if (!Selected("kd-tree"))
+      return;
+
+    std::unique_ptr<KNN> knn;
+    const double buildTime = Time([&]()
+    {
+      knn.reset(new KNN(referenceSet));
+    });
+    const size_t modelSize = SerializedSize(*knn);
+
+    for (const double epsilon : { 0.0, 0.1, 0.25, 0.5, 1.0, 2.0 })
+    {
+      std::ostringstream parameters;
+      parameters << "epsilon=" << epsilon;
+      knn->Epsilon() = epsilon;
+      Evaluate("kd-tree", parameters.str(), false, buildTime, modelSize,
+          [&](arma::Mat<size_t>& neighbors)
+      {
+        arma::mat distances;
+        knn->Search(querySet, k, neighbors, distances);
+      });
+    }
+  }
+
+  //! Sweep the number of projections (l) and of points per projection (m) of
+  //! QDAFN, which searches for furthest neighbors.
+  void RunQDAFN()
+  {
+    if (!Selected("qdafn"))
+      return;
+
+    for (const size_t l : { 5, 10, 20 })
+    {
+      for (const size_t m : { 20, 50, 100 })
+      {
+        // QDAFN cannot return more than m neighbors.
+        if (m < k)
+          continue;
+
+        QDAFN<> qdafn(l, m);
+        const double buildTime = Time([&]() { qdafn.Train(referenceSet); });
+
+        std::ostringstream parameters;
+        parameters << "l=" << l << " m=" << m;
+        Evaluate("qdafn", parameters.str(), true, buildTime,
+            SerializedSize(qdafn), [&](arma::Mat<size_t>& neighbors)
+        {
+          arma::mat distances;
+          qdafn.Search(querySet, k, neighbors, distances);
+        });
+      }
+    }
+  }
+
+  //! Mark the results that are on the Pareto frontier of recall and
+  //! throughput; nearest and furthest neighbor searches are compared
+  //! separately.
+  void ComputeFrontier()
+  {
+    for (ApproxSearchResult& r : results)
+    {
+      r.frontier = true;
+      for (const ApproxSearchResult& other : results)
+      {
+        if (other.furthest == r.furthest &&
+            other.recall >= r.recall &&
+            other.queriesPerSecond >= r.queriesPerSecond &&
+            (other.recall > r.recall ||
+             other.queriesPerSecond > r.queriesPerSecond))
+        {
+          r.frontier = false;
+          break;
+        }
+      }
+    }
+  }
+
+  //! Print every result, then the frontiers, sorted by decreasing recall.
+  void Print(std::ostream& stream) const
+  {
+    std::vector<ApproxSearchResult> sorted = results;
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [](const ApproxSearchResult& a, const ApproxSearchResult& b)
+        {
+          return a.recall > b.recall;
+        });
+
+    stream << std::setprecision(4);
+    for (const bool onlyFrontier : { false, true })
+    {
+      for (const bool furthest : { false, true })
+      {
+        stream << (onlyFrontier ? "Pareto frontier" : "All settings")
+            << " (recall@" << k << " of " << (furthest ? "furthest" :
+            "nearest") << " neighbors):" << std::endl;
+        for (const ApproxSearchResult& r : sorted)
+        {
+          if (r.furthest != furthest || (onlyFrontier && !r.frontier))
+            continue;
+
+          stream << "  " << std::left << std::setw(8) << r.method
+              << std::setw(32) << r.parameters << " recall " << std::setw(8)
+              << r.recall << " " << std::setw(10) << r.queriesPerSecond
+              << " queries/s  build " << std::setw(8) << r.buildTime
+              << "s  " << (r.modelSize / 1048576.0) << " MB" << std::endl;
+        }
+      }
+    }
+  }
+
+  //! Write every result as CSV.
+  void Save(std::ostream& stream) const
+  {
+    stream << "method,parameters,task,build_seconds,model_bytes,"
+        << "queries_per_second,recall,frontier" << std::endl;
+    stream << std::setprecision(9);
+    for (const ApproxSearchResult& r : results)
+    {
+      stream << r.method << "," << r.parameters << ","
+          << (r.furthest ? "kfn" : "knn") << "," << r.buildTime << ","
+          << r.modelSize << "," << r.queriesPerSecond << "," << r.recall << ","
+          << (r.frontier ? 1 : 0) << std::endl;
+    }
+  }
+
+ private:
+  //! Get the exact nearest neighbors, computing them the first time.
+  const arma::Mat<size_t>& ExactNearest()
+  {
+    if (nearestNeighbors.n_elem == 0)
+    {
+      GroundTruth<NearestNeighborSort>(referenceSet, querySet, k,
+          groundTruth.empty() ? "" : groundTruth + ".knn", nearestNeighbors,
+          nearestDistances);
+    }
+    return nearestNeighbors;
+  }
+
+  //! Get the distances to the exact nearest neighbors.
+  const arma::mat& ExactNearestDistances()
+  {
+    ExactNearest();
+    return nearestDistances;
+  }
+
+  //! Get the exact furthest neighbors, computing them the first time.
+  const arma::Mat<size_t>& ExactFurthest()
+  {
+    if (furthestNeighbors.n_elem == 0)
+    {
+      GroundTruth<FurthestNeighborSort>(referenceSet, querySet, k,
+          groundTruth.empty() ? "" : groundTruth + ".kfn", furthestNeighbors,
+          furthestDistances);
+    }
+    return furthestNeighbors;
+  }
+
+  //! The set of points to search in.
+  const arma::mat& referenceSet;
+  //! The queries.
+  const arma::mat& querySet;
+  //! Number of neighbors to search for.
+  size_t k;
+  //! Only methods whose name contains this string are run.
+  std::string filter;
+  //! Number of timed runs of each search.
+  size_t repetitions;
+  //! Prefix of the cache of the exact neighbors (empty for no cache).
+  std::string groundTruth;
+
+  //! Exact nearest neighbors of the queries.
+  arma::Mat<size_t> nearestNeighbors;
+  //! Distances to the exact nearest neighbors.
+  arma::mat nearestDistances;
+  //! Exact furthest neighbors of the queries.
+  arma::Mat<size_t> furthestNeighbors;
+  //! Distances to the exact furthest neighbors.
+  arma::mat furthestDistances;
+
+  //! Results of the settings that were run.
+  std::vector<ApproxSearchResult> results;
+};
+
+int main(int argc, char** argv)
+{
+  std::string referenceFile = "";
+  std::string queryFile = "";
+  std::string groundTruth = "";
+  std::string filter = "";
+  std::string output = "";
+  size_t numQueries = 1000;
+  size_t k = 10;
+  size_t repetitions = 3;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--verbose" || arg == "-v")
+    {
+      Log::Info.ignoreInput = false;
+      continue;
+    }
+
+    if (i + 1 >= argc)
+    {
+      std::cerr << "Usage: " << argv[0] << " [--reference <file>] "
+          << "[--query <file>] [--num_queries <n>] [--k <k>] "
+          << "[--ground_truth <prefix>] [--filter <substring>] "
+          << "[--repetitions <n>] [--output <file.csv>] [--verbose]"
+          << std::endl;
+      return 1;
+    }
+
+    if (arg == "--reference")
+      referenceFile = argv[++i];
+    else if (arg == "--query")
+      queryFile = argv[++i];
+    else if (arg == "--num_queries")
+      numQueries = std::stoul(argv[++i]);
+    else if (arg == "--k")
+      k = std::stoul(argv[++i]);
+    else if (arg == "--ground_truth")
+      groundTruth = argv[++i];
+    else if (arg == "--filter")
+      filter = argv[++i];
+    else if (arg == "--repetitions")
+      repetitions = std::stoul(argv[++i]);
+    else if (arg == "--output")
+      output = argv[++i];
+    else
+    {
+      std::cerr << "Unknown option '" << arg << "'." << std::endl;
+      return 1;
+    }
+  }
+
+  // The same synthetic data, held-out queries and random projections are used
+  // for every run.
+  RandomSeed(42);
+
+  arma::mat referenceSet, querySet;
+  if (referenceFile.empty())
+  {
+    // A mixture of 20 Gaussians in 16 dimensions.
+    const arma::mat centroids = 10.0 * arma::randu<arma::mat>(16, 20);
+    referenceSet = arma::randn<arma::mat>(16, 20000);
+    for (size_t i = 0; i < referenceSet.n_cols; ++i)
+      referenceSet.col(i) += centroids.col(RandInt(centroids.n_cols));
+  }
+  else
+  {
+    data::Load(referenceFile, referenceSet, true);
+  }
+
+  if (!queryFile.empty())
+  {
+    data::Load(queryFile, querySet, true);
+  }
+  else
+  {
+    // Hold out the queries from the reference set.
+    if (numQueries == 0 || numQueries >= referenceSet.n_cols)
+    {
+      std::cerr << "--num_queries must be between 1 and the number of "
+          << "reference points minus one." << std::endl;
+      return 1;
+    }
+
+    const arma::uvec order = arma::randperm(referenceSet.n_cols);
+    querySet = referenceSet.cols(order.head(numQueries));
+    referenceSet = arma::mat(referenceSet.cols(order.tail(
+        referenceSet.n_cols - numQueries)));
+  }
+
+  if (k == 0 || k > referenceSet.n_cols || querySet.n_rows !=
+      referenceSet.n_rows)
+  {
+    std::cerr << "--k must be between 1 and the number of reference points, "
+        << "and the query and reference sets must have the same "
+        << "dimensionality." << std::endl;
+    return 1;
+  }
+
+  ApproxSearchBenchmark benchmark(referenceSet, querySet, k, filter,
+      repetitions, groundTruth);
+  benchmark.RunLSH();
+  benchmark.RunRASearch();
+  benchmark.RunSpillTree();
+  benchmark.RunKDTree();
+  benchmark.RunQDAFN();
+  benchmark.ComputeFrontier();
+  benchmark.Print(std::cout);
+
+  if (!output.empty())
+  {
+    std::ofstream stream(output);
+    if (!stream.is_open())
+    {
+      std::cerr << "Cannot open '" << output << "' for writing." << std::endl;
+      return 1;
+    }
+    benchmark.Save(stream);
+  }
+
+  return 0;
+}
@@ -0,0 +1,217 @@
+/**
+ * @file benchmarks/benchmark.hpp
+ *
+ * A small harness for the benchmarks of mlpack.  Each benchmark file registers
+ * functions with BENCHMARK_CASE(); these time the cases they are interested in
+ * with BenchmarkRunner::Run(), and the results are written as JSON, so that
+ * the results of two commits can be compared with
+ * scripts/compare-benchmarks.py.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BENCHMARKS_BENCHMARK_HPP
+#define MLPACK_BENCHMARKS_BENCHMARK_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace benchmark {
+
+/**
+ * The timings of one benchmark case, in seconds.
+ */
+struct BenchmarkResult
+{
+  //! Name of the case, e.g. "knn/kd-tree/d=10".
+  std::string name;
+  //! Number of timed runs.
+  size_t repetitions;
+  //! Fastest run.
+  double min;
+  //! Median run.
+  double median;
+  //! Mean of the runs.
+  double mean;
+  //! Slowest run.
+  double max;
+};
+
+/**
+ * Prevent the compiler from removing a computation whose result is unused, by
+ * making the address of the result escape.
+ */
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+  static const void* volatile sink;
+  sink = &value;
+}
+
+/**
+ * The BenchmarkRunner runs the benchmark cases whose names match the filter,
+ * times them, and keeps the results.  Each case is run once untimed, to warm
+ * up the caches, and then the given number of times.
+ */
+class BenchmarkRunner
+{
+ public:
+  /**
+   * Create a runner.
+   *
+   * @param filter Only cases whose name contains this string are run.
+   * @param repetitions Number of timed runs of each case.
+   * @param dataDir Directory of the standard datasets (the test data).
+   */
+  BenchmarkRunner(const std::string& filter,
+                  const size_t repetitions,
+                  const std::string& dataDir) :
+      filter(filter),
+      repetitions(std::max(size_t(1), repetitions)),
+      dataDir(dataDir)
+  { }
+
+  //! Return whether a case with the given name would be run.
+  bool Selected(const std::string& name) const
+  {
+    return name.find(filter) != std::string::npos;
+  }
+
+  /**
+   * Time the given case, if its name matches the filter.  The setup function
+   * is called before each run and is not timed; use it to restore state that
+   * the case modifies.
+   *
+   * @param name Name of the case.
+   * @param run Function to time.
+   * @param setup Function called before each run.
+   */
+  void Run(const std::string& name,
+           const std::function<void()>& run,
+           const std::function<void()>& setup = std::function<void()>())
+  {
+    if (!Selected(name))
+      return;
+
+    std::vector<double> times;
+    for (size_t i = 0; i <= repetitions; ++i)
+    {
+      if (setup)
+        setup();
+
+      const std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+      run();
+      const std::chrono::steady_clock::time_point end =
+          std::chrono::steady_clock::now();
+
+      // The first run only warms up.
+      if (i > 0)
+        times.push_back(std::chrono::duration<double>(end - start).count());
+    }
+
+    std::sort(times.begin(), times.end());
+    BenchmarkResult result;
+    result.name = name;
+    result.repetitions = times.size();
+    result.min = times.front();
+    result.max = times.back();
+    result.median = (times.size() % 2 == 1) ? times[times.size() / 2] :
+        (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2.0;
+    result.mean = std::accumulate(times.begin(), times.end(), 0.0) /
+        times.size();
+    results.push_back(result);
+
+    Log::Info << name << ": median " << result.median << "s, min "
+        << result.min << "s" << std::endl;
+  }
+
+  /**
+   * Load a standard dataset from the data directory.  Returns false (and the
+   * cases that need it should be skipped) if it cannot be loaded.
+   */
+  template<typename MatType>
+  bool LoadDataset(const std::string& filename, MatType& dataset) const
+  {
+    if (!data::Load(dataDir + "/" + filename, dataset, false, true))
+    {
+      Log::Warn << "Cannot load '" << dataDir << "/" << filename
+          << "'; skipping the benchmarks that use it." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * Write the results as JSON, along with the version of mlpack and the number
+   * of threads, so that results of different commits can be compared.
+   */
+  void Save(std::ostream& stream) const
+  {
+    stream << "{\n  \"mlpack_version\": \"" << util::GetVersion() << "\",\n"
+        << "  \"threads\": " << NumThreads() << ",\n"
+        << "  \"repetitions\": " << repetitions << ",\n"
+        << "  \"benchmarks\": [";
+    stream << std::setprecision(9);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      const BenchmarkResult& r = results[i];
+      stream << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << r.name
+          << "\", \"repetitions\": " << r.repetitions << ", \"min\": "
+          << r.min << ", \"median\": " << r.median << ", \"mean\": " << r.mean
+          << ", \"max\": " << r.max << "}";
+    }
+    stream << "\n  ]\n}\n";
+  }
+
+  //! Get the results of the cases that were run.
+  const std::vector<BenchmarkResult>& Results() const { return results; }
+  //! Get the directory of the standard datasets.
+  const std::string& DataDir() const { return dataDir; }
+
+ private:
+  //! Only cases whose name contains this string are run.
+  std::string filter;
+  //! Number of timed runs of each case.
+  size_t repetitions;
+  //! Directory of the standard datasets.
+  std::string dataDir;
+  //! Results of the cases that were run.
+  std::vector<BenchmarkResult> results;
+};
+
+//! A function that runs a group of benchmark cases.
+typedef void (*BenchmarkFunction)(BenchmarkRunner&);
+
+//! Get the list of registered benchmark functions.
+inline std::vector<std::pair<std::string, BenchmarkFunction>>& Benchmarks()
+{
+  static std::vector<std::pair<std::string, BenchmarkFunction>> benchmarks;
+  return benchmarks;
+}
+
+//! Registers a benchmark function at static initialization time.
+struct BenchmarkRegistrar
+{
+  BenchmarkRegistrar(const std::string& name, BenchmarkFunction function)
+  {
+    Benchmarks().push_back(std::make_pair(name, function));
+  }
+};
+
+} // namespace benchmark
+} // namespace mlpack
+
+/**
+ * Define and register a function that runs a group of benchmark cases.  The
+ * function gets a BenchmarkRunner named 'runner'.
+ */
+#define BENCHMARK_CASE(NAME) \
+    static void NAME(mlpack::benchmark::BenchmarkRunner& runner); \
+    static mlpack::benchmark::BenchmarkRegistrar NAME##Registrar(#NAME, \
+        &NAME); \
+    static void NAME(mlpack::benchmark::BenchmarkRunner& runner)
+
+#endif
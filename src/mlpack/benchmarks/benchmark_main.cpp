@@ -0,0 +1,91 @@
+/**
+ * @file benchmarks/benchmark_main.cpp
+ *
+ * Entry point of mlpack_benchmark, which runs every registered benchmark and
+ * writes the timings as JSON.
+ *
+ * Usage:
+ *
+ *   mlpack_benchmark [--filter <substring>] [--repetitions <n>]
+ *       [--data_dir <dir>] [--output <file.json>] [--verbose]
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+#ifndef MLPACK_BENCHMARK_DATA_DIR
+  #define MLPACK_BENCHMARK_DATA_DIR "."
+#endif
+
+int main(int argc, char** argv)
+{
+  std::string filter = "";
+  std::string output = "";
+  std::string dataDir = MLPACK_BENCHMARK_DATA_DIR;
+  size_t repetitions = 5;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--verbose" || arg == "-v")
+    {
+      Log::Info.ignoreInput = false;
+      continue;
+    }
+
+    if (i + 1 >= argc)
+    {
+      std::cerr << "Usage: " << argv[0] << " [--filter <substring>] "
+          << "[--repetitions <n>] [--data_dir <dir>] [--output <file.json>] "
+          << "[--verbose]" << std::endl;
+      return 1;
+    }
+
+    if (arg == "--filter")
+      filter = argv[++i];
+    else if (arg == "--repetitions")
+      repetitions = std::stoul(argv[++i]);
+    else if (arg == "--data_dir")
+      dataDir = argv[++i];
+    else if (arg == "--output")
+      output = argv[++i];
+    else
+    {
+      std::cerr << "Unknown option '" << arg << "'." << std::endl;
+      return 1;
+    }
+  }
+
+  BenchmarkRunner runner(filter, repetitions, dataDir);
+  for (const std::pair<std::string, BenchmarkFunction>& b : Benchmarks())
+  {
+    // The same random data is generated for every run, whatever the filter, so
+    // that runs of different commits time the same computations.
+    RandomSeed(42);
+    Log::Info << "Running " << b.first << "..." << std::endl;
+    b.second(runner);
+  }
+
+  if (output.empty())
+  {
+    runner.Save(std::cout);
+  }
+  else
+  {
+    std::ofstream stream(output);
+    if (!stream.is_open())
+    {
+      std::cerr << "Cannot open '" << output << "' for writing." << std::endl;
+      return 1;
+    }
+    runner.Save(stream);
+  }
+
+  return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file benchmarks/kmeans_benchmark.cpp
+ *
+ * Benchmarks of k-means clustering with each LloydStepType.  Every run starts
+ * from the same centroids and runs a fixed number of iterations, so that the
+ * cost of the iterations is compared.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kmeans.hpp>
+
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+/**
+ * Time 10 iterations of k-means with the given Lloyd step, starting from the
+ * given centroids.
+ */
+template<template<class, class> class LloydStepType>
+void Cluster(BenchmarkRunner& runner,
+             const std::string& stepName,
+             const std::string& datasetName,
+             const arma::mat& dataset,
+             const arma::mat& initialCentroids)
+{
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      LloydStepType> kmeans(10);
+  arma::mat centroids;
+  runner.Run("kmeans/" + stepName + "/" + datasetName, [&]()
+  {
+    kmeans.Cluster(dataset, initialCentroids.n_cols, centroids, true);
+  }, [&]() { centroids = initialCentroids; });
+}
+
+/**
+ * Time every Lloyd step on the given dataset.
+ */
+void ClusterAll(BenchmarkRunner& runner,
+                const std::string& datasetName,
+                const arma::mat& dataset,
+                const size_t clusters)
+{
+  // Take the first points as the initial centroids, so every step starts from
+  // the same place.
+  const arma::mat initialCentroids = dataset.cols(0, clusters - 1);
+
+  Cluster<NaiveKMeans>(runner, "naive", datasetName, dataset,
+      initialCentroids);
+  Cluster<ElkanKMeans>(runner, "elkan", datasetName, dataset,
+      initialCentroids);
+  Cluster<HamerlyKMeans>(runner, "hamerly", datasetName, dataset,
+      initialCentroids);
+  Cluster<PellegMooreKMeans>(runner, "pelleg-moore", datasetName, dataset,
+      initialCentroids);
+  Cluster<DefaultDualTreeKMeans>(runner, "dualtree", datasetName, dataset,
+      initialCentroids);
+  Cluster<CoverTreeDualTreeKMeans>(runner, "dualtree-covertree", datasetName,
+      dataset, initialCentroids);
+  Cluster<MiniBatchKMeans>(runner, "minibatch", datasetName, dataset,
+      initialCentroids);
+}
+
+BENCHMARK_CASE(KMeansBenchmark)
+{
+  // Gaussian clusters around random centers.
+  for (const size_t d : { 3, 10 })
+  {
+    const arma::mat centers(d, 20, arma::fill::randu);
+    arma::mat dataset(d, 20000, arma::fill::randn);
+    dataset *= 0.05;
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      dataset.col(i) += centers.col(i % centers.n_cols);
+    ClusterAll(runner, "gaussian-d=" + std::to_string(d), dataset, 20);
+  }
+
+  arma::mat iris;
+  if (runner.LoadDataset("iris.csv", iris))
+    ClusterAll(runner, "iris", iris, 3);
+}
@@ -0,0 +1,60 @@
+/**
+ * @file benchmarks/load_benchmark.cpp
+ *
+ * Benchmarks of data::Load() for CSV and binary files.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+/**
+ * Time loading the given file as a numeric matrix, and with a DatasetInfo (the
+ * path that also handles categorical features).
+ */
+void LoadFile(BenchmarkRunner& runner,
+              const std::string& name,
+              const std::string& filename,
+              const bool withInfo)
+{
+  arma::mat dataset;
+  runner.Run("load/" + name, [&]() { data::Load(filename, dataset, true); });
+
+  if (withInfo)
+  {
+    data::DatasetInfo info;
+    runner.Run("load/" + name + "/dataset-info", [&]()
+    {
+      data::Load(filename, dataset, info, true);
+    });
+  }
+}
+
+BENCHMARK_CASE(LoadBenchmark)
+{
+  if (!runner.Selected("load/"))
+    return;
+
+  // Synthetic files, written once outside of the timed sections.
+  const arma::mat dataset(50, 20000, arma::fill::randu);
+  data::Save("benchmark_load.csv", dataset, true);
+  data::Save("benchmark_load.bin", dataset, true);
+
+  LoadFile(runner, "csv/50x20000", "benchmark_load.csv", true);
+  LoadFile(runner, "binary/50x20000", "benchmark_load.bin", false);
+
+  remove("benchmark_load.csv");
+  remove("benchmark_load.bin");
+
+  // A standard dataset.
+  const std::string filename = runner.DataDir() + "/nbc_high_dim_train.csv";
+  if (std::ifstream(filename).good())
+    LoadFile(runner, "csv/nbc_high_dim_train", filename, true);
+}
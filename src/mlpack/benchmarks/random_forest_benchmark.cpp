@@ -0,0 +1,78 @@
+/**
+ * @file benchmarks/random_forest_benchmark.cpp
+ *
+ * Benchmarks of RandomForest training and prediction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/random_forest.hpp>
+
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+/**
+ * Time training a forest of 20 trees on the given dataset, and predicting the
+ * labels and the probabilities of the dataset.
+ */
+void TrainAndPredict(BenchmarkRunner& runner,
+                     const std::string& name,
+                     const arma::mat& dataset,
+                     const arma::Row<size_t>& labels,
+                     const size_t numClasses)
+{
+  const std::string prefix = "random_forest/" + name;
+  if (!runner.Selected(prefix))
+    return;
+
+  RandomForest<> rf;
+  runner.Run(prefix + "/train", [&]()
+  {
+    rf.Train(dataset, labels, numClasses, 20);
+  });
+
+  rf.Train(dataset, labels, numClasses, 20);
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  runner.Run(prefix + "/classify", [&]()
+  {
+    rf.Classify(dataset, predictions);
+  });
+  runner.Run(prefix + "/probabilities", [&]()
+  {
+    rf.Classify(dataset, predictions, probabilities);
+  });
+}
+
+BENCHMARK_CASE(RandomForestBenchmark)
+{
+  // Two overlapping Gaussian classes.
+  for (const size_t d : { 10, 50 })
+  {
+    arma::mat dataset(d, 10000, arma::fill::randn);
+    arma::Row<size_t> labels(dataset.n_cols);
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      labels[i] = i % 2;
+      dataset.col(i) += labels[i];
+    }
+    TrainAndPredict(runner, "gaussian-d=" + std::to_string(d), dataset, labels,
+        2);
+  }
+
+  // The last row of the thyroid dataset holds the labels, from 1 to 3.
+  arma::mat thyroid;
+  if (runner.LoadDataset("thyroid_train.csv", thyroid))
+  {
+    const arma::Row<size_t> labels =
+        arma::conv_to<arma::Row<size_t>>::from(thyroid.row(thyroid.n_rows - 1))
+        - 1;
+    thyroid.shed_row(thyroid.n_rows - 1);
+    TrainAndPredict(runner, "thyroid", thyroid, labels, 3);
+  }
+}
@@ -0,0 +1,176 @@
+/**
+ * @file benchmarks/search_benchmark.cpp
+ *
+ * Benchmarks of k-nearest-neighbor search, range search and kernel density
+ * estimation, with each tree type and at several dimensionalities.  Trees are
+ * built outside of the timed sections.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kde.hpp>
+#include <mlpack/methods/neighbor_search.hpp>
+#include <mlpack/methods/range_search.hpp>
+
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+/**
+ * Time dual-tree and single-tree 5-nearest-neighbor search with the given tree
+ * type.
+ */
+template<template<typename MetricType,
+                  typename StatisticType,
+                  typename MatType> class TreeType>
+void SearchKNN(BenchmarkRunner& runner,
+               const std::string& name,
+               const arma::mat& referenceSet,
+               const arma::mat& querySet)
+{
+  const std::string prefix = "knn/" + name;
+  if (!runner.Selected(prefix))
+    return;
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      TreeType> KNNType;
+  KNNType knn(referenceSet);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  knn.SearchMode() = DUAL_TREE_MODE;
+  runner.Run(prefix + "/dual", [&]()
+  {
+    knn.Search(querySet, 5, neighbors, distances);
+  });
+
+  knn.SearchMode() = SINGLE_TREE_MODE;
+  runner.Run(prefix + "/single", [&]()
+  {
+    knn.Search(querySet, 5, neighbors, distances);
+  });
+}
+
+/**
+ * Time dual-tree range search with the given tree type.
+ */
+template<template<typename MetricType,
+                  typename StatisticType,
+                  typename MatType> class TreeType>
+void SearchRange(BenchmarkRunner& runner,
+                 const std::string& name,
+                 const arma::mat& referenceSet,
+                 const arma::mat& querySet,
+                 const double radius)
+{
+  const std::string caseName = "range/" + name;
+  if (!runner.Selected(caseName))
+    return;
+
+  RangeSearch<EuclideanDistance, arma::mat, TreeType> rs(referenceSet);
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<double>> distances;
+  runner.Run(caseName, [&]()
+  {
+    rs.Search(querySet, Range(0.0, radius), neighbors, distances);
+  });
+}
+
+/**
+ * Time dual-tree kernel density estimation with the Gaussian kernel and the
+ * given tree type.
+ */
+template<template<typename MetricType,
+                  typename StatisticType,
+                  typename MatType> class TreeType>
+void EstimateKDE(BenchmarkRunner& runner,
+                 const std::string& name,
+                 const arma::mat& referenceSet,
+                 const arma::mat& querySet)
+{
+  const std::string caseName = "kde/" + name;
+  if (!runner.Selected(caseName))
+    return;
+
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, TreeType> kde(0.05, 0.0,
+      GaussianKernel(0.25));
+  kde.Train(referenceSet);
+  arma::vec estimations;
+  runner.Run(caseName, [&]()
+  {
+    kde.Evaluate(querySet, estimations);
+  });
+}
+
+BENCHMARK_CASE(KNNBenchmark)
+{
+  for (const size_t d : { 3, 10, 30 })
+  {
+    const std::string dim = "/d=" + std::to_string(d);
+    const arma::mat referenceSet(d, 10000, arma::fill::randu);
+    const arma::mat querySet(d, 1000, arma::fill::randu);
+
+    SearchKNN<KDTree>(runner, "kd" + dim, referenceSet, querySet);
+    SearchKNN<BallTree>(runner, "ball" + dim, referenceSet, querySet);
+    SearchKNN<StandardCoverTree>(runner, "cover" + dim, referenceSet,
+        querySet);
+    SearchKNN<RTree>(runner, "r" + dim, referenceSet, querySet);
+    SearchKNN<RStarTree>(runner, "r-star" + dim, referenceSet, querySet);
+    SearchKNN<VPTree>(runner, "vp" + dim, referenceSet, querySet);
+    SearchKNN<RPTree>(runner, "rp" + dim, referenceSet, querySet);
+    SearchKNN<UBTree>(runner, "ub" + dim, referenceSet, querySet);
+    if (d <= 10)
+      SearchKNN<Octree>(runner, "oct" + dim, referenceSet, querySet);
+  }
+}
+
+BENCHMARK_CASE(RangeSearchBenchmark)
+{
+  for (const size_t d : { 3, 10, 30 })
+  {
+    const std::string dim = "/d=" + std::to_string(d);
+    const arma::mat referenceSet(d, 10000, arma::fill::randu);
+    const arma::mat querySet(d, 1000, arma::fill::randu);
+    // Keep roughly the same number of results per query in each dimension.
+    const double radius = 0.1 * std::sqrt((double) d);
+
+    SearchRange<KDTree>(runner, "kd" + dim, referenceSet, querySet, radius);
+    SearchRange<BallTree>(runner, "ball" + dim, referenceSet, querySet,
+        radius);
+    SearchRange<StandardCoverTree>(runner, "cover" + dim, referenceSet,
+        querySet, radius);
+    SearchRange<RTree>(runner, "r" + dim, referenceSet, querySet, radius);
+    SearchRange<VPTree>(runner, "vp" + dim, referenceSet, querySet, radius);
+    if (d <= 10)
+    {
+      SearchRange<Octree>(runner, "oct" + dim, referenceSet, querySet,
+          radius);
+    }
+  }
+}
+
+BENCHMARK_CASE(KDEBenchmark)
+{
+  for (const size_t d : { 3, 10 })
+  {
+    const std::string dim = "/d=" + std::to_string(d);
+    const arma::mat referenceSet(d, 10000, arma::fill::randu);
+    const arma::mat querySet(d, 1000, arma::fill::randu);
+
+    EstimateKDE<KDTree>(runner, "kd" + dim, referenceSet, querySet);
+    EstimateKDE<BallTree>(runner, "ball" + dim, referenceSet, querySet);
+    EstimateKDE<StandardCoverTree>(runner, "cover" + dim, referenceSet,
+        querySet);
+    EstimateKDE<RTree>(runner, "r" + dim, referenceSet, querySet);
+    EstimateKDE<Octree>(runner, "oct" + dim, referenceSet, querySet);
+  }
+
+  // A standard dataset, used as both the reference and the query set.
+  arma::mat iris;
+  if (runner.LoadDataset("iris.csv", iris))
+    EstimateKDE<KDTree>(runner, "kd/iris", iris, iris);
+}
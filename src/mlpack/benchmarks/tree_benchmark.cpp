@@ -0,0 +1,75 @@
+/**
+ * @file benchmarks/tree_benchmark.cpp
+ *
+ * Benchmarks of the construction of each tree type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+/**
+ * Time the construction of a tree of the given type on the given dataset.
+ */
+template<template<typename MetricType,
+                  typename StatisticType,
+                  typename MatType> class TreeType>
+void BuildTree(BenchmarkRunner& runner,
+               const std::string& treeName,
+               const std::string& datasetName,
+               const arma::mat& dataset)
+{
+  typedef TreeType<EuclideanDistance, EmptyStatistic, arma::mat> Tree;
+  runner.Run("tree/" + treeName + "/" + datasetName, [&]()
+  {
+    Tree tree(dataset);
+    DoNotOptimize(tree);
+  });
+}
+
+/**
+ * Time the construction of every tree type on the given dataset.
+ */
+void BuildTrees(BenchmarkRunner& runner,
+                const std::string& datasetName,
+                const arma::mat& dataset)
+{
+  BuildTree<KDTree>(runner, "kd", datasetName, dataset);
+  BuildTree<MeanSplitKDTree>(runner, "mean-kd", datasetName, dataset);
+  BuildTree<BallTree>(runner, "ball", datasetName, dataset);
+  BuildTree<VPTree>(runner, "vp", datasetName, dataset);
+  BuildTree<RPTree>(runner, "rp", datasetName, dataset);
+  BuildTree<MaxRPTree>(runner, "max-rp", datasetName, dataset);
+  BuildTree<UBTree>(runner, "ub", datasetName, dataset);
+  BuildTree<StandardCoverTree>(runner, "cover", datasetName, dataset);
+  BuildTree<RTree>(runner, "r", datasetName, dataset);
+  BuildTree<RStarTree>(runner, "r-star", datasetName, dataset);
+  BuildTree<XTree>(runner, "x", datasetName, dataset);
+  BuildTree<HilbertRTree>(runner, "hilbert-r", datasetName, dataset);
+  BuildTree<RPlusTree>(runner, "r-plus", datasetName, dataset);
+  BuildTree<RPlusPlusTree>(runner, "r-plus-plus", datasetName, dataset);
+  BuildTree<SPTree>(runner, "sp", datasetName, dataset);
+  // The number of children of an octree is exponential in the dimension.
+  if (dataset.n_rows <= 10)
+    BuildTree<Octree>(runner, "oct", datasetName, dataset);
+}
+
+BENCHMARK_CASE(TreeBenchmark)
+{
+  for (const size_t d : { 3, 10 })
+  {
+    const arma::mat dataset(d, 20000, arma::fill::randu);
+    BuildTrees(runner, "uniform-d=" + std::to_string(d), dataset);
+  }
+
+  arma::mat dataset;
+  if (runner.LoadDataset("test_data_3_1000.csv", dataset))
+    BuildTrees(runner, "test_data_3_1000", dataset);
+}
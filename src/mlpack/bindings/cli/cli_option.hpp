@@ -31,6 +31,7 @@
 #include "get_allocated_memory.hpp"
 #include "delete_allocated_memory.hpp"
 #include "in_place_copy.hpp"
+#include "serve_param.hpp"
 
 namespace mlpack {
 namespace bindings {
@@ -124,6 +125,8 @@ class CLIOption
     IO::AddFunction(tname, "GetAllocatedMemory", &GetAllocatedMemory<N>);
     IO::AddFunction(tname, "DeleteAllocatedMemory", &DeleteAllocatedMemory<N>);
     IO::AddFunction(tname, "InPlaceCopy", &InPlaceCopy<N>);
+    IO::AddFunction(tname, "ReadServeParam", &ReadServeParam<N>);
+    IO::AddFunction(tname, "WriteServeParam", &WriteServeParam<N>);
 
     IO::AddParameter(bindingName, std::move(data));
   }
@@ -3,7 +3,8 @@
  * @author Ryan Curtin
  * @author Matthew Amidon
  *
- * Terminate the program; handle --verbose option; print output parameters.
+ * Terminate the program; handle --verbose, --print_memory and --trace_file
+ * options; print output parameters (unless the program was serving requests).
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -28,12 +29,14 @@ inline void EndProgram(util::Params& params, util::Timers& timers)
   // Stop the timers.
   timers.StopAllTimers();
 
-  // Print any output.
+  // Print any output.  When serving, the output of each request was written
+  // with its response instead.
   std::map<std::string, util::ParamData>& parameters = params.Parameters();
+  const bool served = params.Has("serve") || params.Has("serve_socket");
   for (auto& it : parameters)
   {
     util::ParamData& d = it.second;
-    if (!d.input)
+    if (!d.input && !served)
       params.functionMap[d.tname]["OutputParam"](d, NULL, NULL);
   }
 
@@ -79,6 +82,70 @@ inline void EndProgram(util::Params& params, util::Timers& timers)
     }
   }
 
+  // Print the memory counters and the memory of each timer, if requested.
+  if (params.Has("print_memory"))
+  {
+    // This is printed even without --verbose.
+    const bool ignoreInput = Log::Info.ignoreInput;
+    Log::Info.ignoreInput = false;
+
+    if (!MemoryTracker::Enabled())
+    {
+      Log::Warn << "mlpack was built without memory tracking (the TRACK_MEMORY "
+          << "CMake option), so no memory was counted." << std::endl;
+    }
+
+    Log::Info << "Program memory:" << std::endl;
+    Log::Info << "  peak: " << MemoryTracker::PrintBytes(
+        MemoryTracker::PeakBytes()) << std::endl;
+    Log::Info << "  current: " << MemoryTracker::PrintBytes(
+        MemoryTracker::CurrentBytes()) << std::endl;
+    Log::Info << "  armadillo allocations: " << MemoryTracker::Allocations(
+        MemoryTracker::Armadillo) << " (peak " << MemoryTracker::PrintBytes(
+        MemoryTracker::PeakBytes(MemoryTracker::Armadillo)) << ")"
+        << std::endl;
+    Log::Info << "  tree nodes: " << MemoryTracker::Allocations(
+        MemoryTracker::TreeNodes) << " (peak " << MemoryTracker::PrintBytes(
+        MemoryTracker::PeakBytes(MemoryTracker::TreeNodes)) << ")"
+        << std::endl;
+
+    // Merge the global timers with the binding-specific ones.
+    std::map<std::string, util::PhaseMemory> memoryMap =
+        timers.GetAllMemory();
+    std::map<std::string, util::PhaseMemory> globalMemoryMap =
+        Timer::GetAllMemory();
+    for (auto& it : globalMemoryMap)
+    {
+      util::PhaseMemory& m = memoryMap[it.first];
+      m.peakBytes = std::max(m.peakBytes, it.second.peakBytes);
+      m.netBytes += it.second.netBytes;
+    }
+
+    for (auto& it : memoryMap)
+    {
+      Log::Info << "  " << it.first << ": peak "
+          << MemoryTracker::PrintBytes(it.second.peakBytes) << ", net "
+          << MemoryTracker::PrintBytes(it.second.netBytes) << std::endl;
+    }
+
+    Log::Info.ignoreInput = ignoreInput;
+  }
+
+  // Save the trace of the timers, if requested.
+  if (params.Has("trace_file"))
+  {
+    const std::string traceFile = params.Get<std::string>("trace_file");
+    try
+    {
+      Trace::Save(traceFile);
+      Log::Info << "Saved timer trace to '" << traceFile << "'." << std::endl;
+    }
+    catch (const std::runtime_error& e)
+    {
+      Log::Warn << e.what() << std::endl;
+    }
+  }
+
   // Lastly clean up any memory.  If we are holding any pointers, then we "own"
   // them.  But we may hold the same pointer twice, so we have to be careful to
   // not delete it multiple times.
@@ -88,6 +88,8 @@ using Option = mlpack::bindings::cli::CLIOption<T>;
 #include <mlpack/core/util/io.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
+#include <mlpack/bindings/util/num_threads.hpp>
 
 // Forward definition of the binding function.
 void BINDING_FUNCTION(mlpack::util::Params&, mlpack::util::Timers&);
@@ -105,7 +107,12 @@ int main(int argc, char** argv)
 
   // A "total_time" timer is run by default for each mlpack program.
   timers.Start("total_time");
-  BINDING_FUNCTION(params, timers);
+  // With --serve or --serve_socket the binding is run for each request;
+  // otherwise, it runs once.  It uses at most --num_threads threads.
+  if (params.Has("serve") || params.Has("serve_socket"))
+    mlpack::bindings::cli::Serve(params, timers, &BINDING_NAME);
+  else
+    mlpack::util::CallWithNumThreads(params, timers, &BINDING_NAME);
   timers.Stop("total_time");
 
   // Print output options, print verbose information, save model parameters,
@@ -121,7 +128,26 @@ PARAM_GLOBAL(std::string, "info", "Print help on a specific option.", "",
 PARAM_GLOBAL(bool, "verbose", "Display informational messages and the full "
     "list of parameters and timers at the end of execution.", "v", "bool",
     false, true, false, false);
+PARAM_GLOBAL(int, "num_threads", "Maximum number of threads to use; 0 "
+    "uses all the threads of the executor (by default, OMP_NUM_THREADS).", "",
+    "int", false, true, false, 0);
 PARAM_GLOBAL(bool, "version", "Display the version of mlpack.", "V", "bool",
     false, true, false, false);
+PARAM_GLOBAL(std::string, "trace_file", "If specified, save a trace of the "
+    "timers of the program to this file: a table of the calls and times of "
+    "each scope if the extension is '.csv', and a Chrome trace (which can be "
+    "opened with Perfetto) otherwise.", "", "std::string", false, true, false,
+    "");
+PARAM_GLOBAL(bool, "print_memory", "Print the memory allocated by the "
+    "program and the peak memory of each timer at the end of execution (if "
+    "mlpack was built with memory tracking).", "", "bool", false, true, false,
+    false);
+PARAM_GLOBAL(bool, "serve", "If specified, load the model and the other "
+    "options once, then run the program for each request read from stdin "
+    "(see the documentation of command-line programs for the format).", "",
+    "bool", false, true, false, false);
+PARAM_GLOBAL(std::string, "serve_socket", "If specified, serve requests like "
+    "--serve, but from the connections to a Unix socket at this path.", "",
+    "std::string", false, true, false, "");
 
 #endif
@@ -131,9 +131,15 @@ mlpack::util::Params ParseCommandLine(
     Log::Info.ignoreInput = false;
   }
 
-  // Now, issue an error if we forgot any required options.
+  // Record a trace of the timers, to be saved by EndProgram().
+  if (params.Has("trace_file"))
+    Trace::Enable();
+
+  // Now, issue an error if we forgot any required options.  When serving,
+  // they may be given with each request instead.
+  const bool serving = params.Has("serve") || params.Has("serve_socket");
   for (std::map<std::string, util::ParamData>::const_iterator iter =
-       parameters.begin(); iter != parameters.end(); ++iter)
+       parameters.begin(); iter != parameters.end() && !serving; ++iter)
   {
     util::ParamData d = iter->second;
     if (d.required)
@@ -0,0 +1,355 @@
+/**
+ * @file bindings/cli/serve.hpp
+ *
+ * Serve requests with a command-line program: the models and other options
+ * given on the command line are loaded once, and then the binding is run for
+ * each request read from stdin or from the connections to a Unix socket.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_SERVE_HPP
+#define MLPACK_BINDINGS_CLI_SERVE_HPP
+
+#include <mlpack/core/util/io.hpp>
+#include <mlpack/bindings/util/num_threads.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <set>
+
+#ifndef _WIN32
+  #include <sys/socket.h>
+  #include <sys/un.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Run the given binding function for each request read from the input stream,
+ * and write each response to the output stream, until the input ends.
+ *
+ * The parameters given on the command line (in particular, input models) are
+ * loaded once, before the first request; each request is then run with a copy
+ * of them, in which the parameters of the request are set.  A request is a
+ * sequence of lines that ends with an empty line:
+ *
+ * @code
+ * --test
+ * 0.5,1.2,3.1
+ * 0.7,1.0,2.8
+ * --k 3
+ *
+ * @endcode
+ *
+ * A line that starts with "--" names a parameter, either by its name or by its
+ * command-line name (so "--test" and "--test_file" are the same); the rest of
+ * the line is its value.  The value of a matrix parameter is given instead by
+ * the CSV lines that follow, one point per line.  A flag is set by giving its
+ * name alone.
+ *
+ * The response has a line "name: value" for each output parameter, except
+ * that matrices are given as "name:" followed by their CSV lines, and that
+ * empty matrices and models are not written.  If the request fails, the
+ * response is a single line "error: " followed by the reason.  Each response
+ * ends with an empty line.
+ *
+ * @param params Parameters given on the command line.
+ * @param timers Timers of the program.
+ * @param function Binding function to run for each request.
+ * @param input Stream to read requests from.
+ * @param output Stream to write responses to.
+ * @return Number of requests served.
+ */
+inline size_t ServeStream(util::Params& params,
+                          util::Timers& timers,
+                          void (*function)(util::Params&, util::Timers&),
+                          std::istream& input,
+                          std::ostream& output)
+{
+  std::map<std::string, util::ParamData>& parameters = params.Parameters();
+
+  // Load everything that was given on the command line, so that it is not
+  // loaded again for each request.  Also map the command-line names of the
+  // parameters to their names.
+  std::map<std::string, std::string> names;
+  for (auto& it : parameters)
+  {
+    util::ParamData& d = it.second;
+    if (d.input && d.wasPassed)
+    {
+      void* value;
+      params.functionMap[d.tname]["GetParam"](d, NULL, (void*) &value);
+    }
+
+    std::string cliName;
+    params.functionMap[d.tname]["MapParameterName"](d, NULL,
+        (void*) &cliName);
+    names[d.name] = d.name;
+    names[cliName] = d.name;
+  }
+
+  // The memory held by the parameters of the command line is freed by
+  // EndProgram(); the memory of each request is freed after the request.
+  std::set<void*> commandLineMemory;
+  for (auto& it : parameters)
+  {
+    void* memory;
+    params.functionMap[it.second.tname]["GetAllocatedMemory"](it.second, NULL,
+        (void*) &memory);
+    if (memory != NULL)
+      commandLineMemory.insert(memory);
+  }
+
+  size_t requests = 0;
+  std::string line;
+  while (input.good())
+  {
+    // Read the lines of the request, up to an empty line or the end of the
+    // input.
+    std::vector<std::pair<std::string, std::string>> values;
+    bool empty = true;
+    while (std::getline(input, line))
+    {
+      if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+      if (line.empty())
+        break;
+
+      empty = false;
+      if (line.compare(0, 2, "--") == 0)
+      {
+        const size_t space = line.find(' ');
+        values.push_back(std::make_pair(line.substr(2, space - 2),
+            (space == std::string::npos) ? "" : line.substr(space + 1)));
+      }
+      else if (!values.empty())
+      {
+        values.back().second += line + "\n";
+      }
+      else
+      {
+        values.push_back(std::make_pair("", line));
+      }
+    }
+
+    if (empty)
+      continue;
+
+    util::Params request(params);
+    try
+    {
+      for (const std::pair<std::string, std::string>& v : values)
+      {
+        if (names.count(v.first) == 0)
+        {
+          throw std::invalid_argument(v.first.empty() ?
+              "the request must start with a parameter name" :
+              "unknown parameter '" + v.first + "'");
+        }
+
+        util::ParamData& d = request.Parameters()[names.at(v.first)];
+        if (!d.input)
+        {
+          throw std::invalid_argument("parameter '" + d.name + "' is not an "
+              "input parameter");
+        }
+        request.functionMap[d.tname]["ReadServeParam"](d, (void*) &v.second,
+            NULL);
+      }
+
+      for (auto& it : request.Parameters())
+      {
+        if (it.second.required && !it.second.wasPassed)
+        {
+          throw std::invalid_argument("required parameter '" + it.first +
+              "' was not given");
+        }
+      }
+
+      util::CallWithNumThreads(request, timers, function);
+
+      for (auto& it : request.Parameters())
+      {
+        util::ParamData& d = it.second;
+        if (!d.input)
+        {
+          request.functionMap[d.tname]["WriteServeParam"](d, NULL,
+              (void*) &output);
+        }
+      }
+    }
+    catch (const std::exception& e)
+    {
+      output << "error: " << e.what() << std::endl;
+    }
+    output << std::endl;
+    output.flush();
+    ++requests;
+
+    // Free the models that were created for this request only.
+    std::set<void*> requestMemory;
+    for (auto& it : request.Parameters())
+    {
+      util::ParamData& d = it.second;
+      void* memory;
+      request.functionMap[d.tname]["GetAllocatedMemory"](d, NULL,
+          (void*) &memory);
+      if (memory != NULL && commandLineMemory.count(memory) == 0 &&
+          requestMemory.count(memory) == 0)
+      {
+        requestMemory.insert(memory);
+        request.functionMap[d.tname]["DeleteAllocatedMemory"](d, NULL, NULL);
+      }
+    }
+  }
+
+  return requests;
+}
+
+#ifndef _WIN32
+
+/**
+ * A stream buffer that reads from and writes to a file descriptor, so that
+ * the connections to a socket can be served as streams.
+ */
+class FileDescriptorBuffer : public std::streambuf
+{
+ public:
+  //! Create the buffer for the given file descriptor.
+  FileDescriptorBuffer(const int fd) : fd(fd)
+  {
+    setg(inBuffer, inBuffer, inBuffer);
+    setp(outBuffer, outBuffer + sizeof(outBuffer));
+  }
+
+  //! Write what remains in the buffer.
+  ~FileDescriptorBuffer() { sync(); }
+
+ protected:
+  //! Read more data.
+  int_type underflow()
+  {
+    const ssize_t n = ::read(fd, inBuffer, sizeof(inBuffer));
+    if (n <= 0)
+      return traits_type::eof();
+    setg(inBuffer, inBuffer, inBuffer + n);
+    return traits_type::to_int_type(inBuffer[0]);
+  }
+
+  //! Write the buffer, then the given character.
+  int_type overflow(int_type c)
+  {
+    if (sync() != 0)
+      return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  //! Write the buffer.
+  int sync()
+  {
+    const char* data = pbase();
+    while (data < pptr())
+    {
+      const ssize_t n = ::write(fd, data, pptr() - data);
+      if (n <= 0)
+        return -1;
+      data += n;
+    }
+    setp(outBuffer, outBuffer + sizeof(outBuffer));
+    return 0;
+  }
+
+ private:
+  //! The file descriptor.
+  int fd;
+  //! Buffer of read data.
+  char inBuffer[4096];
+  //! Buffer of data to write.
+  char outBuffer[4096];
+};
+
+#endif
+
+/**
+ * Serve requests with the given binding function: from the Unix socket given
+ * with --serve_socket, one connection at a time, or from stdin otherwise.  See
+ * ServeStream() for the format of requests and responses.
+ *
+ * @param params Parameters given on the command line.
+ * @param timers Timers of the program.
+ * @param function Binding function to run for each request.
+ */
+inline void Serve(util::Params& params,
+                  util::Timers& timers,
+                  void (*function)(util::Params&, util::Timers&))
+{
+  if (!params.Has("serve_socket"))
+  {
+    const size_t requests = ServeStream(params, timers, function, std::cin,
+        std::cout);
+    Log::Info << "Served " << requests << " requests." << std::endl;
+    return;
+  }
+
+#ifdef _WIN32
+  Log::Fatal << "--serve_socket is not supported on Windows; use --serve to "
+      << "read requests from stdin." << std::endl;
+#else
+  const std::string path = params.Get<std::string>("serve_socket");
+  sockaddr_un address;
+  if (path.size() >= sizeof(address.sun_path))
+    Log::Fatal << "Socket path '" << path << "' is too long!" << std::endl;
+
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+  const int server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  ::unlink(path.c_str());
+  if (server < 0 || ::bind(server, (sockaddr*) &address, sizeof(address)) != 0
+      || ::listen(server, 16) != 0)
+  {
+    Log::Fatal << "Cannot listen on socket '" << path << "': "
+        << std::strerror(errno) << "." << std::endl;
+  }
+
+  Log::Info << "Serving requests on '" << path << "'." << std::endl;
+  while (true)
+  {
+    const int connection = ::accept(server, NULL, NULL);
+    if (connection < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+
+    {
+      FileDescriptorBuffer buffer(connection);
+      std::iostream stream(&buffer);
+      ServeStream(params, timers, function, stream, stream);
+    }
+    ::close(connection);
+  }
+
+  ::close(server);
+  ::unlink(path.c_str());
+#endif
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
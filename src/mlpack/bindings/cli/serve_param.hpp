@@ -0,0 +1,307 @@
+/**
+ * @file bindings/cli/serve_param.hpp
+ *
+ * Read the value of a parameter from a request, and write the value of an
+ * output parameter to a response, when a command-line program is serving
+ * requests (see serve.hpp).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_SERVE_PARAM_HPP
+#define MLPACK_BINDINGS_CLI_SERVE_PARAM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/param_data.hpp>
+#include <mlpack/core/util/is_std_vector.hpp>
+#include "parameter_type.hpp"
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Read a simple value (a number or a string) from the text given in a
+ * request.  A flag is set when it is given without a value.
+ */
+template<typename T>
+void ReadServeParamImpl(
+    util::ParamData& d,
+    const std::string& text,
+    const typename std::enable_if<!arma::is_arma_type<T>::value>::type* = 0,
+    const typename std::enable_if<!util::IsStdVector<T>::value>::type* = 0,
+    const typename std::enable_if<!data::HasSerialize<T>::value>::type* = 0,
+    const typename std::enable_if<!std::is_same<T,
+        std::tuple<data::DatasetInfo, arma::mat>>::value>::type* = 0)
+{
+  if (std::is_same<T, bool>::value)
+  {
+    d.value = (text != "false" && text != "0");
+    return;
+  }
+
+  if (std::is_same<T, std::string>::value)
+  {
+    d.value = text;
+    return;
+  }
+
+  std::istringstream stream(text);
+  T value;
+  stream >> value;
+  if (stream.fail() || !(stream >> std::ws).eof())
+  {
+    throw std::invalid_argument("cannot parse value '" + text + "' of "
+        "parameter '" + d.name + "'");
+  }
+  d.value = value;
+}
+
+/**
+ * Read a vector from the text given in a request; the elements are separated
+ * by spaces or commas.
+ */
+template<typename T>
+void ReadServeParamImpl(
+    util::ParamData& d,
+    const std::string& text,
+    const typename std::enable_if<util::IsStdVector<T>::value>::type* = 0)
+{
+  std::string elements(text);
+  std::replace(elements.begin(), elements.end(), ',', ' ');
+  std::istringstream stream(elements);
+
+  T vector;
+  typename T::value_type element;
+  while (stream >> element)
+    vector.push_back(element);
+  if (!stream.eof())
+  {
+    throw std::invalid_argument("cannot parse value '" + text + "' of "
+        "parameter '" + d.name + "'");
+  }
+  d.value = vector;
+}
+
+/**
+ * Read a matrix from the CSV rows given in a request.  As with files, each row
+ * is a point, unless the parameter is not transposed.
+ */
+template<typename T>
+void ReadServeParamImpl(
+    util::ParamData& d,
+    const std::string& text,
+    const typename std::enable_if<arma::is_arma_type<T>::value>::type* = 0)
+{
+  typedef std::tuple<T, typename ParameterType<T>::type> TupleType;
+  TupleType& tuple = *MLPACK_ANY_CAST<TupleType>(&d.value);
+
+  arma::Mat<typename T::elem_type> matrix;
+  std::istringstream stream(text);
+  if (!matrix.load(stream, arma::csv_ascii))
+  {
+    throw std::invalid_argument("cannot parse matrix given for parameter '" +
+        d.name + "'");
+  }
+
+  if (arma::is_Row<T>::value || arma::is_Col<T>::value)
+    std::get<0>(tuple) = arma::conv_to<T>::from(arma::vectorise(matrix));
+  else if (d.noTranspose)
+    std::get<0>(tuple) = std::move(matrix);
+  else
+    std::get<0>(tuple) = matrix.t();
+
+  std::get<1>(std::get<1>(tuple)) = std::get<0>(tuple).n_rows;
+  std::get<2>(std::get<1>(tuple)) = std::get<0>(tuple).n_cols;
+  d.loaded = true;
+}
+
+/**
+ * Read a matrix with dataset information from the CSV rows given in a request;
+ * every dimension is numeric.
+ */
+template<typename T>
+void ReadServeParamImpl(
+    util::ParamData& d,
+    const std::string& text,
+    const typename std::enable_if<std::is_same<T,
+        std::tuple<data::DatasetInfo, arma::mat>>::value>::type* = 0)
+{
+  typedef std::tuple<T, std::tuple<std::string, size_t, size_t>> TupleType;
+  TupleType& tuple = *MLPACK_ANY_CAST<TupleType>(&d.value);
+
+  arma::mat matrix;
+  std::istringstream stream(text);
+  if (!matrix.load(stream, arma::csv_ascii))
+  {
+    throw std::invalid_argument("cannot parse matrix given for parameter '" +
+        d.name + "'");
+  }
+
+  arma::mat& m = std::get<1>(std::get<0>(tuple));
+  m = d.noTranspose ? matrix : arma::mat(matrix.t());
+  std::get<0>(std::get<0>(tuple)) = data::DatasetInfo(m.n_rows);
+  std::get<1>(std::get<1>(tuple)) = m.n_rows;
+  std::get<2>(std::get<1>(tuple)) = m.n_cols;
+  d.loaded = true;
+}
+
+/**
+ * Models are loaded once, when serving starts, so they cannot be given in a
+ * request.
+ */
+template<typename T>
+void ReadServeParamImpl(
+    util::ParamData& d,
+    const std::string& /* text */,
+    const typename std::enable_if<!arma::is_arma_type<T>::value>::type* = 0,
+    const typename std::enable_if<data::HasSerialize<T>::value>::type* = 0)
+{
+  throw std::invalid_argument("model parameter '" + d.name + "' cannot be "
+      "given in a request; pass it on the command line instead");
+}
+
+/**
+ * Write a simple output value as "name: value".
+ */
+template<typename T>
+void WriteServeParamImpl(
+    util::ParamData& d,
+    std::ostream& stream,
+    const typename std::enable_if<!arma::is_arma_type<T>::value>::type* = 0,
+    const typename std::enable_if<!util::IsStdVector<T>::value>::type* = 0,
+    const typename std::enable_if<!data::HasSerialize<T>::value>::type* = 0,
+    const typename std::enable_if<!std::is_same<T,
+        std::tuple<data::DatasetInfo, arma::mat>>::value>::type* = 0)
+{
+  stream << d.name << ": " << *MLPACK_ANY_CAST<T>(&d.value) << std::endl;
+}
+
+/**
+ * Write an output vector as "name: a b c".
+ */
+template<typename T>
+void WriteServeParamImpl(
+    util::ParamData& d,
+    std::ostream& stream,
+    const typename std::enable_if<util::IsStdVector<T>::value>::type* = 0)
+{
+  stream << d.name << ":";
+  const T& t = *MLPACK_ANY_CAST<T>(&d.value);
+  for (size_t i = 0; i < t.size(); ++i)
+    stream << " " << t[i];
+  stream << std::endl;
+}
+
+/**
+ * Write an output matrix as "name:" followed by its CSV rows; nothing is
+ * written if the matrix is empty.
+ */
+template<typename T>
+void WriteServeParamImpl(
+    util::ParamData& d,
+    std::ostream& stream,
+    const typename std::enable_if<arma::is_arma_type<T>::value>::type* = 0)
+{
+  typedef std::tuple<T, typename ParameterType<T>::type> TupleType;
+  const T& output = std::get<0>(*MLPACK_ANY_CAST<TupleType>(&d.value));
+  if (output.n_elem == 0)
+    return;
+
+  stream << d.name << ":" << std::endl;
+  if (arma::is_Row<T>::value || arma::is_Col<T>::value)
+  {
+    // Vectors are written with one element per line, like label files.
+    const arma::Col<typename T::elem_type> column = arma::vectorise(output);
+    column.save(stream, arma::csv_ascii);
+  }
+  else if (d.noTranspose)
+  {
+    output.save(stream, arma::csv_ascii);
+  }
+  else
+  {
+    arma::Mat<typename T::elem_type>(output.t()).save(stream,
+        arma::csv_ascii);
+  }
+}
+
+/**
+ * Write an output matrix with dataset information; only the matrix is
+ * written.
+ */
+template<typename T>
+void WriteServeParamImpl(
+    util::ParamData& d,
+    std::ostream& stream,
+    const typename std::enable_if<std::is_same<T,
+        std::tuple<data::DatasetInfo, arma::mat>>::value>::type* = 0)
+{
+  typedef std::tuple<T, std::tuple<std::string, size_t, size_t>> TupleType;
+  const arma::mat& output =
+      std::get<1>(std::get<0>(*MLPACK_ANY_CAST<TupleType>(&d.value)));
+  if (output.n_elem == 0)
+    return;
+
+  stream << d.name << ":" << std::endl;
+  if (d.noTranspose)
+    output.save(stream, arma::csv_ascii);
+  else
+    arma::mat(output.t()).save(stream, arma::csv_ascii);
+}
+
+/**
+ * Output models stay in memory while serving, so they are not written.
+ */
+template<typename T>
+void WriteServeParamImpl(
+    util::ParamData& /* d */,
+    std::ostream& /* stream */,
+    const typename std::enable_if<!arma::is_arma_type<T>::value>::type* = 0,
+    const typename std::enable_if<data::HasSerialize<T>::value>::type* = 0)
+{
+  // Nothing to do.
+}
+
+/**
+ * Set the value of a parameter from the text of a request, and mark it as
+ * passed.  This is the function that will be called by the IO module.
+ *
+ * @param d Parameter information.
+ * @param input The text given for the parameter (a std::string*).
+ * @param * (output) Unused parameter.
+ */
+template<typename T>
+void ReadServeParam(util::ParamData& d,
+                    const void* input,
+                    void* /* output */)
+{
+  ReadServeParamImpl<typename std::remove_pointer<T>::type>(d,
+      *((const std::string*) input));
+  d.wasPassed = true;
+}
+
+/**
+ * Write the value of an output parameter to a response.  This is the function
+ * that will be called by the IO module.
+ *
+ * @param d Parameter information.
+ * @param * (input) Unused parameter.
+ * @param output The stream to write to (a std::ostream*).
+ */
+template<typename T>
+void WriteServeParam(util::ParamData& d,
+                     const void* /* input */,
+                     void* output)
+{
+  WriteServeParamImpl<typename std::remove_pointer<T>::type>(d,
+      *((std::ostream*) output));
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
@@ -80,8 +80,12 @@ class MDOption
     IO::AddFunction(data.tname, "IsSerializable", &IsSerializable<T>);
 
     // Add the option.
-    if (identifier != "verbose" && identifier != "copy_all_inputs" &&
-        identifier != "help" && identifier != "info" && identifier != "version")
+    if (identifier != "verbose" && identifier != "num_threads" &&
+        identifier != "copy_all_inputs" &&
+        identifier != "help" && identifier != "info" &&
+        identifier != "version" && identifier != "trace_file" &&
+        identifier != "print_memory" && identifier != "serve" &&
+        identifier != "serve_socket")
     {
       IO::AddParameter(bindingName, std::move(data));
     }
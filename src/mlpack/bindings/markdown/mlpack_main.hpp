@@ -125,10 +125,13 @@ using Option = mlpack::bindings::markdown::MDOption<T>;
 
 #include <mlpack/core/util/param.hpp>
 
-// This parameter is available for all languages.
+// These parameters are available for all languages.
 PARAM_GLOBAL(bool, "verbose", "Display informational messages and the full "
     "list of parameters and timers at the end of execution.", "v", "bool",
     false, true, false, false);
+PARAM_GLOBAL(int, "num_threads", "Maximum number of threads to use; 0 "
+    "uses all the threads of the executor (by default, OMP_NUM_THREADS).", "",
+    "int", false, true, false, 0);
 
 // CLI-specific parameters.
 PARAM_GLOBAL(bool, "help", "Default help info.", "h", "bool", false, true,
@@ -137,6 +140,22 @@ PARAM_GLOBAL(std::string, "info", "Print help on a specific option.", "",
     "std::string", false, true, false, "");
 PARAM_GLOBAL(bool, "version", "Display the version of mlpack.", "V", "bool",
     false, true, false, false);
+PARAM_GLOBAL(std::string, "trace_file", "If specified, save a trace of the "
+    "timers of the program to this file: a table of the calls and times of "
+    "each scope if the extension is '.csv', and a Chrome trace (which can be "
+    "opened with Perfetto) otherwise.", "", "std::string", false, true, false,
+    "");
+PARAM_GLOBAL(bool, "print_memory", "Print the memory allocated by the "
+    "program and the peak memory of each timer at the end of execution (if "
+    "mlpack was built with memory tracking).", "", "bool", false, true, false,
+    false);
+PARAM_GLOBAL(bool, "serve", "If specified, load the model and the other "
+    "options once, then run the program for each request read from stdin "
+    "(see the documentation of command-line programs for the format).", "",
+    "bool", false, true, false, false);
+PARAM_GLOBAL(std::string, "serve_socket", "If specified, serve requests like "
+    "--serve, but from the connections to a Unix socket at this path.", "",
+    "std::string", false, true, false, "");
 
 // Python-specific parameters.
 PARAM_GLOBAL(bool, "copy_all_inputs", "If specified, all input parameters will "
@@ -43,7 +43,9 @@ void PrintParamTable(const string& bindingName,
 
     if (language != "cli" &&
         (it->second.name == "help" || it->second.name == "info" ||
-        it->second.name == "version"))
+        it->second.name == "version" || it->second.name == "trace_file" ||
+        it->second.name == "print_memory" || it->second.name == "serve" ||
+        it->second.name == "serve_socket"))
       continue;
 
     if (paramsSet.find(it->second.name) != paramsSet.end())
@@ -116,7 +118,10 @@ void PrintParamTable(const string& bindingName,
       cout << desc; // just a string
       // Print whether or not it's a "special" language-only parameter.
       if (it->second.name == "copy_all_inputs" || it->second.name == "help" ||
-          it->second.name == "info" || it->second.name == "version")
+          it->second.name == "info" || it->second.name == "version" ||
+          it->second.name == "trace_file" ||
+          it->second.name == "print_memory" || it->second.name == "serve" ||
+          it->second.name == "serve_socket")
       {
         cout << "  <span class=\"special\">Only exists in "
             << PrintLanguage(language) << " binding.</span>";
@@ -3,10 +3,61 @@
 This is an autogenerated file that allows convenient imports of mlpack
 functionality.
 
+The binding functions and wrapper classes are imported lazily: the compiled
+module of a binding is only loaded the first time it is accessed (for instance
+with `from mlpack import knn` or `mlpack.knn`), so that importing mlpack does
+not load every binding.
+
 mlpack is free software; you may redistribute it and/or modify it under the
 terms of the 3-clause BSD license.  You should have received a copy of the
 3-clause BSD license along with mlpack.  If not, see
 http://www.opensource.org/licenses/BSD-3-Clause for more information.
 """
+import importlib
+import sys
+import types
 import warnings
 warnings.filterwarnings("default", category=ImportWarning)
+
+# Map from the name of each binding function and wrapper class to the name of
+# the module that defines it.
+_lazy_modules = {}
+__all__ = []
+
+def _lazy_import(name, module):
+  """
+  Register the given function or class of the given module, to be imported on
+  first access.
+  """
+  _lazy_modules[name] = module
+  __all__.append(name)
+
+class _LazyModule(types.ModuleType):
+  """
+  The type of the mlpack package, which imports the module of a binding the
+  first time one of its functions or classes is accessed.
+  """
+  def __getattr__(self, name):
+    if name not in _lazy_modules:
+      raise AttributeError("module '" + self.__name__ + "' has no attribute '"
+          + name + "'")
+
+    module = importlib.import_module('.' + _lazy_modules[name], self.__name__)
+    value = getattr(module, name)
+    setattr(self, name, value)
+    return value
+
+  def __setattr__(self, name, value):
+    # Importing a submodule sets it as an attribute of the package; when the
+    # submodule has the same name as its binding function, keep the function.
+    if isinstance(value, types.ModuleType) and \
+        _lazy_modules.get(name) == name and \
+        value.__name__ == self.__name__ + '.' + name:
+      value = getattr(value, name)
+    super().__setattr__(name, value)
+
+  def __dir__(self):
+    return sorted(set(super().__dir__()) | set(_lazy_modules.keys()))
+
+sys.modules[__name__].__class__ = _LazyModule
+
@@ -12,6 +12,11 @@ object, then the numpy object will "own" the matrix.
 Thus, know that if you convert a matrix type, remember that the resulting type
 is what "owns" the allocated memory.
 
+A C-ordered numpy array with one point per row has the same layout as a
+column-major Armadillo matrix with one point per column, so it is used in place
+whether or not it owns its memory (views, memory maps and the values of a
+DataFrame are not copied).  Only arrays that are not C-contiguous are copied.
+
 mlpack is free software; you may redistribute it and/or modify it under the
 terms of the 3-clause BSD license.  You should have received a copy of the
 3-clause BSD license along with mlpack.  If not, see
@@ -45,6 +50,12 @@ cdef extern from "<mlpack/bindings/python/mlpack/arma_util.hpp>":
   size_t* GetMemory(Mat[size_t]& m)
   size_t* GetMemory(Col[size_t]& m)
   size_t* GetMemory(Row[size_t]& m)
+  bool MemoryTransferable()
+
+# Memory can only be handed between Armadillo and numpy when both free it the
+# same way; otherwise (on Windows, or when mlpack tracks the memory Armadillo
+# allocates) it is copied.
+cdef bool copyMemory = isWin or not MemoryTransferable()
 
 cdef Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
                                  bool takeOwnership) except +:
@@ -52,17 +63,20 @@ cdef Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
   cdef int flags = PyArray_FLAGS(X)
-  if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS) or \
-    (not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
+  if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS):
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
     takeOwnership = True
+  elif not (flags & numpy.NPY_ARRAY_OWNDATA):
+    # Views of other arrays (slices, memory maps, the values of a DataFrame)
+    # are used in place; we cannot take ownership of their memory.
+    takeOwnership = False
 
   cdef Mat[double]* m = new Mat[double](<double*> PyArray_DATA(X),
-      PyArray_SHAPE(X)[1], PyArray_SHAPE(X)[0], isWin, False)
+      PyArray_SHAPE(X)[1], PyArray_SHAPE(X)[0], copyMemory, False)
 
-  # Take ownership of the memory, if we need to and we are not on Windows.
-  if takeOwnership and not isWin:
+  # Take ownership of the memory, if we need to and we can.
+  if takeOwnership and not copyMemory:
     PyArray_CLEARFLAGS(X, numpy.NPY_ARRAY_OWNDATA)
     SetMemState[Mat[double]](m[0], 0)
 
@@ -74,18 +88,20 @@ cdef Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
   cdef int flags = PyArray_FLAGS(X)
-  if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS) or \
-    (not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS):
+    # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
     takeOwnership = True
+  elif not (flags & numpy.NPY_ARRAY_OWNDATA):
+    # Views of other arrays (slices, memory maps, the values of a DataFrame)
+    # are used in place; we cannot take ownership of their memory.
+    takeOwnership = False
 
   cdef Mat[size_t]* m = new Mat[size_t](<size_t*> PyArray_DATA(X),
-      PyArray_SHAPE(X)[1], PyArray_SHAPE(X)[0], isWin, False)
+      PyArray_SHAPE(X)[1], PyArray_SHAPE(X)[0], copyMemory, False)
 
   # Take ownership of the memory, if we need to.
-  if takeOwnership and not isWin:
+  if takeOwnership and not copyMemory:
     PyArray_CLEARFLAGS(X, numpy.NPY_ARRAY_OWNDATA)
     SetMemState[Mat[size_t]](m[0], 0)
 
@@ -100,13 +116,17 @@ cdef numpy.ndarray[numpy.double_t, ndim=2] mat_to_numpy_d(Mat[double]& X) \
   cdef numpy.npy_intp dims[2]
   dims[0] = <numpy.npy_intp> X.n_cols
   dims[1] = <numpy.npy_intp> X.n_rows
-  cdef numpy.ndarray[numpy.double_t, ndim=2] output = \
-      numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_DOUBLE, GetMemory(X))
-  if isWin:
-    output = output.copy(order="C")
+  cdef numpy.ndarray[numpy.double_t, ndim=2] output
+  if copyMemory:
+    # numpy cannot free the memory of X, so it gets a copy.
+    output = numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_DOUBLE,
+        X.memptr()).copy(order="C")
+    return output
+
+  output = numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_DOUBLE, GetMemory(X))
 
   # Transfer memory ownership, if needed.
-  if GetMemState[Mat[double]](X) == 0 and not isWin:
+  if GetMemState[Mat[double]](X) == 0:
     SetMemState[Mat[double]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_ARRAY_OWNDATA)
 
@@ -121,13 +141,17 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=2] mat_to_numpy_s(Mat[size_t]& X) \
   cdef numpy.npy_intp dims[2]
   dims[0] = <numpy.npy_intp> X.n_cols
   dims[1] = <numpy.npy_intp> X.n_rows
-  cdef numpy.ndarray[numpy.npy_intp, ndim=2] output = \
-      numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_INTP, GetMemory(X))
-  if isWin:
-    output = output.copy(order="C")
+  cdef numpy.ndarray[numpy.npy_intp, ndim=2] output
+  if copyMemory:
+    # numpy cannot free the memory of X, so it gets a copy.
+    output = numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_INTP,
+        X.memptr()).copy(order="C")
+    return output
+
+  output = numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_INTP, GetMemory(X))
 
   # Transfer memory ownership, if needed.
-  if GetMemState[Mat[size_t]](X) == 0 and not isWin:
+  if GetMemState[Mat[size_t]](X) == 0:
     SetMemState[Mat[size_t]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_ARRAY_OWNDATA)
 
@@ -140,18 +164,20 @@ cdef Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   owned by numpy.
   """
   cdef int flags = PyArray_FLAGS(X)
-  if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS) or \
-    (not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS):
+    # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
     takeOwnership = True
+  elif not (flags & numpy.NPY_ARRAY_OWNDATA):
+    # Views of other arrays (slices, memory maps, the values of a DataFrame)
+    # are used in place; we cannot take ownership of their memory.
+    takeOwnership = False
 
   cdef Row[double]* m = new Row[double](<double*> PyArray_DATA(X),
-    PyArray_SHAPE(X)[0], isWin, False)
+    PyArray_SHAPE(X)[0], copyMemory, False)
 
   # Transfer memory ownership, if needed.
-  if takeOwnership and not isWin:
+  if takeOwnership and not copyMemory:
     PyArray_CLEARFLAGS(X, numpy.NPY_ARRAY_OWNDATA)
     SetMemState[Row[double]](m[0], 0)
 
@@ -164,18 +190,20 @@ cdef Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   owned by numpy.
   """
   cdef int flags = PyArray_FLAGS(X)
-  if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS) or \
-    (not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS):
+    # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
     takeOwnership = True
+  elif not (flags & numpy.NPY_ARRAY_OWNDATA):
+    # Views of other arrays (slices, memory maps, the values of a DataFrame)
+    # are used in place; we cannot take ownership of their memory.
+    takeOwnership = False
 
   cdef Row[size_t]* m = new Row[size_t](<size_t*> PyArray_DATA(X),
-      PyArray_SHAPE(X)[0], isWin, False)
+      PyArray_SHAPE(X)[0], copyMemory, False)
 
   # Transfer memory ownership, if needed.
-  if takeOwnership and not isWin:
+  if takeOwnership and not copyMemory:
     PyArray_CLEARFLAGS(X, numpy.NPY_ARRAY_OWNDATA)
     SetMemState[Row[size_t]](m[0], 0)
 
@@ -188,13 +216,17 @@ cdef numpy.ndarray[numpy.double_t, ndim=1] row_to_numpy_d(Row[double]& X) \
   """
   # Extract dimensions.
   cdef numpy.npy_intp dim = <numpy.npy_intp> X.n_elem
-  cdef numpy.ndarray[numpy.double_t, ndim=1] output = \
-      numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_DOUBLE, GetMemory(X))
-  if isWin:
-    output = output.copy(order="C")
+  cdef numpy.ndarray[numpy.double_t, ndim=1] output
+  if copyMemory:
+    # numpy cannot free the memory of X, so it gets a copy.
+    output = numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_DOUBLE,
+        X.memptr()).copy(order="C")
+    return output
+
+  output = numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_DOUBLE, GetMemory(X))
 
   # Transfer memory ownership, if needed.
-  if GetMemState[Row[double]](X) == 0 and not isWin:
+  if GetMemState[Row[double]](X) == 0:
     SetMemState[Row[double]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_ARRAY_OWNDATA)
 
@@ -208,13 +240,17 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=1] row_to_numpy_s(Row[size_t]& X) \
 #  print("called row_to_numpy_s()\n")
   # Extract dimensions.
   cdef numpy.npy_intp dim = <numpy.npy_intp> X.n_elem
-  cdef numpy.ndarray[numpy.npy_intp, ndim=1] output = \
-      numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_INTP, GetMemory(X))
-  if isWin:
-    output = output.copy(order="C")
+  cdef numpy.ndarray[numpy.npy_intp, ndim=1] output
+  if copyMemory:
+    # numpy cannot free the memory of X, so it gets a copy.
+    output = numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_INTP,
+        X.memptr()).copy(order="C")
+    return output
+
+  output = numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_INTP, GetMemory(X))
 
   # Transfer memory ownership, if needed.
-  if GetMemState[Row[size_t]](X) == 0 and not isWin:
+  if GetMemState[Row[size_t]](X) == 0:
     SetMemState[Row[size_t]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_ARRAY_OWNDATA)
 
@@ -227,18 +263,20 @@ cdef Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   still be owned by numpy.
   """
   cdef int flags = PyArray_FLAGS(X)
-  if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS) or \
-    (not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS):
+    # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
     takeOwnership = True
+  elif not (flags & numpy.NPY_ARRAY_OWNDATA):
+    # Views of other arrays (slices, memory maps, the values of a DataFrame)
+    # are used in place; we cannot take ownership of their memory.
+    takeOwnership = False
 
   cdef Col[double]* m = new Col[double](<double*> PyArray_DATA(X),
-      PyArray_SHAPE(X)[0], isWin, False)
+      PyArray_SHAPE(X)[0], copyMemory, False)
 
   # Transfer memory ownership, if needed.
-  if takeOwnership and not isWin:
+  if takeOwnership and not copyMemory:
     PyArray_CLEARFLAGS(X, numpy.NPY_ARRAY_OWNDATA)
     SetMemState[Col[double]](m[0], 0)
 
@@ -251,18 +289,20 @@ cdef Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   still be owned by numpy.
   """
   cdef int flags = PyArray_FLAGS(X)
-  if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS) or \
-    (not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS):
+    # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
     takeOwnership = True
+  elif not (flags & numpy.NPY_ARRAY_OWNDATA):
+    # Views of other arrays (slices, memory maps, the values of a DataFrame)
+    # are used in place; we cannot take ownership of their memory.
+    takeOwnership = False
 
   cdef Col[size_t]* m = new Col[size_t](<size_t*> PyArray_DATA(X), 
-      PyArray_SHAPE(X)[0], isWin, False)
+      PyArray_SHAPE(X)[0], copyMemory, False)
 
   # Transfer memory ownership, if needed.
-  if takeOwnership and not isWin:
+  if takeOwnership and not copyMemory:
     PyArray_CLEARFLAGS(X, numpy.NPY_ARRAY_OWNDATA)
     SetMemState[Col[size_t]](m[0], 0)
 
@@ -275,13 +315,17 @@ cdef numpy.ndarray[numpy.double_t, ndim=1] col_to_numpy_d(Col[double]& X) \
   """
   # Extract dimension.
   cdef numpy.npy_intp dim = <numpy.npy_intp> X.n_elem
-  cdef numpy.ndarray[numpy.double_t, ndim=1] output = \
-      numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_DOUBLE, GetMemory(X))
-  if isWin:
-    output = output.copy(order="C")
+  cdef numpy.ndarray[numpy.double_t, ndim=1] output
+  if copyMemory:
+    # numpy cannot free the memory of X, so it gets a copy.
+    output = numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_DOUBLE,
+        X.memptr()).copy(order="C")
+    return output
+
+  output = numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_DOUBLE, GetMemory(X))
 
   # Transfer memory ownership, if needed.
-  if GetMemState[Col[double]](X) == 0 and not isWin:
+  if GetMemState[Col[double]](X) == 0:
     SetMemState[Col[double]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_ARRAY_OWNDATA)
 
@@ -294,13 +338,17 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=1] col_to_numpy_s(Col[size_t]& X) \
   """
   # Extract dimension.
   cdef numpy.npy_intp dim = <numpy.npy_intp> X.n_elem
-  cdef numpy.ndarray[numpy.npy_intp, ndim=1] output = \
-      numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_INTP, GetMemory(X))
-  if isWin:
-    output = output.copy(order="C")
+  cdef numpy.ndarray[numpy.npy_intp, ndim=1] output
+  if copyMemory:
+    # numpy cannot free the memory of X, so it gets a copy.
+    output = numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_INTP,
+        X.memptr()).copy(order="C")
+    return output
+
+  output = numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_INTP, GetMemory(X))
 
   # Transfer memory ownership, if needed.
-  if GetMemState[Col[size_t]](X) == 0 and not isWin:
+  if GetMemState[Col[size_t]](X) == 0:
     SetMemState[Col[size_t]](X, 1)
     PyArray_ENABLEFLAGS(output, numpy.NPY_ARRAY_OWNDATA)
 
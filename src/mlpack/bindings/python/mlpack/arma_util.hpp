@@ -44,6 +44,16 @@ size_t GetMemState(T& t)
   return (size_t) t.mem_state;
 }
 
+/**
+ * Return whether memory allocated by Armadillo can be freed by numpy, and the
+ * other way around.  This is not the case when mlpack tracks the memory that
+ * Armadillo allocates, since then allocations have a header.
+ */
+inline bool MemoryTransferable()
+{
+  return !mlpack::MemoryTracker::Enabled();
+}
+
 /**
  * Return the matrix's allocated memory pointer, unless the matrix is using its
  * internal preallocated memory, in which case we copy that and return a
@@ -5,7 +5,7 @@ io.pyx: Cython functionality for mlpack::IO and other utilities.
 This file imports the Parameters() function from mlpack::IO, plus other utility
 functions: SetParam(), SetParamPtr(), SetParamWithInfo(), GetParam(),
 GetParamWithInfo(), EnableVerbose(), DisableVerbose(), DisableBacktrace(),
-EnableTimers() and ResetTimers().
+EnableTimers(), ResetTimers(), MemoryStatistics() and TimerMemory().
 
 mlpack is free software; you may redistribute it and/or modify it under the
 terms of the 3-clause BSD license.  You should have received a copy of the
@@ -15,7 +15,9 @@ http://www.opensource.org/licenses/BSD-3-Clause for more information.
 cimport cython
 from libcpp.string cimport string
 from libcpp cimport bool
+from libcpp.map cimport map
 from .params cimport Params
+from .timers cimport Timers
 
 cdef extern from "<mlpack/core/util/io.hpp>" namespace "mlpack" nogil:
   cdef cppclass IO:
@@ -35,3 +37,5 @@ cdef extern from "<mlpack/bindings/python/mlpack/io_util.hpp>" \
   void DisableBacktrace() nogil except +
   void ResetTimers() nogil except +
   void EnableTimers() nogil except +
+  map[string, size_t] MemoryStatistics() nogil except +
+  map[string, map[string, long long]] TimerMemory(Timers&) nogil except +
@@ -194,6 +194,38 @@ inline void EnableTimers()
   Timer::EnableTiming();
 }
 
+/**
+ * Get the counters of the memory tracker (see MemoryTracker::Statistics()).
+ */
+inline std::map<std::string, size_t> MemoryStatistics()
+{
+  return MemoryTracker::Statistics();
+}
+
+/**
+ * Get the peak and net bytes of each timer of the given binding timers and of
+ * the global timers, as "peak_bytes" and "net_bytes".
+ */
+inline std::map<std::string, std::map<std::string, long long>> TimerMemory(
+    util::Timers& timers)
+{
+  std::map<std::string, util::PhaseMemory> memory = timers.GetAllMemory();
+  for (auto& it : Timer::GetAllMemory())
+  {
+    util::PhaseMemory& m = memory[it.first];
+    m.peakBytes = std::max(m.peakBytes, it.second.peakBytes);
+    m.netBytes += it.second.netBytes;
+  }
+
+  std::map<std::string, std::map<std::string, long long>> result;
+  for (auto& it : memory)
+  {
+    result[it.first]["peak_bytes"] = (long long) it.second.peakBytes;
+    result[it.first]["net_bytes"] = (long long) it.second.netBytes;
+  }
+  return result;
+}
+
 } // namespace util
 } // namespace mlpack
 
@@ -124,17 +124,29 @@ using Option = mlpack::bindings::python::PyOption<T>;
 }
 
 #include <mlpack/core/util/param.hpp>
+#include <mlpack/bindings/util/num_threads.hpp>
 
-// In Python, we want to call the binding function mlpack_<BINDING_NAME>()
-// instead of just <BINDING_NAME>(), so we change the definition of
-// BINDING_FUNCTION().
+// In Python, the binding is called as mlpack_<BINDING_NAME>() instead of just
+// <BINDING_NAME>(); that function applies the num_threads parameter to the call
+// and runs the binding function, which is named mlpack_run_<BINDING_NAME>().
 #undef BINDING_FUNCTION
-#define BINDING_FUNCTION(...) JOIN(mlpack_, BINDING_NAME)(__VA_ARGS__)
+#define BINDING_FUNCTION(...) JOIN(mlpack_run_, BINDING_NAME)(__VA_ARGS__)
+
+void BINDING_FUNCTION(mlpack::util::Params&, mlpack::util::Timers&);
+inline void JOIN(mlpack_, BINDING_NAME)(mlpack::util::Params& params,
+                                      mlpack::util::Timers& timers)
+{
+  mlpack::util::CallWithNumThreads(params, timers,
+      &JOIN(mlpack_run_, BINDING_NAME));
+}
 
 // Define parameters available in every Python binding.
 PARAM_GLOBAL(bool, "verbose", "Display informational messages and the full "
     "list of parameters and timers at the end of execution.", "v", "bool",
     false, true, false, false);
+PARAM_GLOBAL(int, "num_threads", "Maximum number of threads to use; 0 "
+    "uses all the threads of the executor (by default, OMP_NUM_THREADS).", "",
+    "int", false, true, false, 0);
 PARAM_GLOBAL(bool, "copy_all_inputs", "If specified, all input parameters "
     "will be deep copied before the method is run.  This is useful for "
     "debugging problems where the input parameters are being modified "
@@ -84,7 +84,7 @@ void PrintPYX(const util::BindingDetails& doc,
   cout << "from .io cimport SetParam, SetParamPtr, SetParamWithInfo, "
       << "GetParamPtr" << endl;
   cout << "from .io cimport EnableVerbose, DisableVerbose, DisableBacktrace, "
-      << "ResetTimers, EnableTimers" << endl;
+      << "ResetTimers, EnableTimers, MemoryStatistics, TimerMemory" << endl;
   cout << "from .matrix_utils import to_matrix, to_matrix_with_info" << endl;
   cout << "from .preprocess_json_params import process_params_out, "
       << "process_params_in" << endl;
@@ -195,7 +195,9 @@ void PrintPYX(const util::BindingDetails& doc,
   }
   cout << endl;
   cout << "A dict containing each of the named output parameters will be "
-      << "returned." << endl;
+      << "returned, along with a 'memory' dict of the memory counters and the "
+      << "memory of each timer (which are zero unless mlpack was built with "
+      << "memory tracking)." << endl;
   cout << "  \"\"\"" << endl;
 
   // Reset any timers and disable backtraces.
@@ -249,9 +251,13 @@ void PrintPYX(const util::BindingDetails& doc,
   cout << "  if check_input_matrices:" << endl;
   cout << "    p.CheckInputMatrices()" << endl;
 
-  // Call the method.
-  cout << "  # Call the mlpack program." << endl;
-  cout << "  mlpack_" << bindingName << "(p, t)" << endl;
+  // Call the method.  The inputs are all converted by now, so the GIL is
+  // released during the call; it is reacquired for the output processing.
+  cout << "  # Call the mlpack program without the GIL, so that other Python "
+      << "threads can" << endl;
+  cout << "  # run at the same time." << endl;
+  cout << "  with nogil:" << endl;
+  cout << "    mlpack_" << bindingName << "(p, t)" << endl;
 
   // Do any output processing and return.
   cout << "  # Initialize result dictionary." << endl;
@@ -271,6 +277,15 @@ void PrintPYX(const util::BindingDetails& doc,
   }
   cout << endl;
 
+  // Add the memory counters and the memory used during each timer.
+  cout << "  # Add the memory usage." << endl;
+  cout << "  result['memory'] = {k.decode('UTF-8'): v for k, v in "
+      << "MemoryStatistics().items()}" << endl;
+  cout << "  result['memory']['timers'] = {k.decode('UTF-8'): "
+      << "{kk.decode('UTF-8'): vv for kk, vv in v.items()} for k, v in "
+      << "TimerMemory(t).items()}" << endl;
+  cout << endl;
+
   cout << "  return result" << endl;
 }
 
@@ -13,6 +13,7 @@ import unittest
 import pandas as pd
 import numpy as np
 import copy
+import threading
 
 from mlpack.test_python_binding import test_python_binding
 
@@ -37,6 +38,19 @@ class TestPythonBinding(unittest.TestCase):
     self.assertEqual(output['int_out'], 13)
     self.assertEqual(output['double_out'], 5.0)
 
+  def testLazyImport(self):
+    """
+    The binding is available from the mlpack package, which imports it on first
+    access, and stays a function after its module has been imported.
+    """
+    import mlpack
+    import mlpack.test_python_binding
+
+    self.assertTrue('test_python_binding' in dir(mlpack))
+    self.assertTrue('test_python_binding' in mlpack.__all__)
+    self.assertIs(mlpack.test_python_binding, test_python_binding)
+    self.assertRaises(AttributeError, lambda : mlpack.not_a_binding)
+
   def testRunBindingNoFlag(self):
     """
     If we forget the mandatory flag, we should get wrong results.
@@ -77,6 +91,28 @@ class TestPythonBinding(unittest.TestCase):
 
     self.assertNotEqual(output['int_out'], 13)
 
+  def testRunBindingNumThreads(self):
+    """
+    The number of threads can be set for a call; a negative number is an error.
+    """
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 mat_req_in=[[1.0]],
+                                 col_req_in=[1.0],
+                                 flag1=True,
+                                 num_threads=1)
+
+    self.assertEqual(output['int_out'], 13)
+
+    self.assertRaises(RuntimeError,
+                      lambda : test_python_binding(string_in='hello',
+                                                   int_in=12,
+                                                   double_in=4.0,
+                                                   mat_req_in=[[1.0]],
+                                                   col_req_in=[1.0],
+                                                   num_threads=-1))
+
   def testRunBindingWrongDouble(self):
     """
     If we give the wrong double, we should get wrong results.
@@ -131,6 +167,68 @@ class TestPythonBinding(unittest.TestCase):
     for j in range(100):
       self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
 
+  def testConcurrentCalls(self):
+    """
+    Several threads can call the binding at the same time, and each call gets
+    its own results.
+    """
+    inputs = [np.random.rand(100, 5) for i in range(8)]
+    outputs = [None] * len(inputs)
+
+    def run(i):
+      outputs[i] = test_python_binding(string_in='hello',
+                                       int_in=12,
+                                       double_in=4.0,
+                                       mat_req_in=[[1.0]],
+                                       col_req_in=[1.0],
+                                       matrix_in=inputs[i],
+                                       flag1=True,
+                                       copy_all_inputs=True)
+
+    threads = [threading.Thread(target=run, args=(i,))
+               for i in range(len(inputs))]
+    for t in threads:
+      t.start()
+    for t in threads:
+      t.join()
+
+    for i in range(len(inputs)):
+      self.assertEqual(outputs[i]['int_out'], 13)
+      self.assertEqual(outputs[i]['matrix_out'].shape[0], 100)
+      self.assertEqual(outputs[i]['matrix_out'].shape[1], 4)
+      for j in range(100):
+        self.assertEqual(2 * inputs[i][j, 2], outputs[i]['matrix_out'][j, 2])
+
+  def testNumpyMatrixView(self):
+    """
+    A view of a matrix that does not own its memory is used in place; we should
+    still get back the rows of the view with the third dimension doubled and
+    the fifth forgotten, and the matrix should not be modified.
+    """
+    x = np.random.rand(200, 5);
+    z = copy.deepcopy(x)
+    view = z[50:150]
+    self.assertFalse(view.flags.owndata)
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 mat_req_in=[[1.0]],
+                                 col_req_in=[1.0],
+                                 matrix_in=view)
+
+    self.assertEqual(output['matrix_out'].shape[0], 100)
+    self.assertEqual(output['matrix_out'].shape[1], 4)
+    self.assertEqual(output['matrix_out'].dtype, np.double)
+    for i in [0, 1, 3]:
+      for j in range(100):
+        self.assertEqual(x[j + 50, i], output['matrix_out'][j, i])
+
+    for j in range(100):
+      self.assertEqual(2 * x[j + 50, 2], output['matrix_out'][j, 2])
+
+    self.assertTrue((z == x).all())
+
   def testNumpyMatrixForceCopy(self):
     """
     The matrix we pass in, we should get back with the third dimension doubled
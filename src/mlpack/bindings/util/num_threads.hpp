@@ -0,0 +1,56 @@
+/**
+ * @file bindings/util/num_threads.hpp
+ *
+ * Apply the "num_threads" parameter that every binding has to a call of the
+ * binding.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_UTIL_NUM_THREADS_HPP
+#define MLPACK_BINDINGS_UTIL_NUM_THREADS_HPP
+
+#include <mlpack/core/util/executor.hpp>
+#include <mlpack/core/util/log.hpp>
+#include <mlpack/core/util/params.hpp>
+#include <mlpack/core/util/timers.hpp>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * Call the given binding function with the number of threads of its parallel
+ * loops and OpenMP regions capped by the "num_threads" parameter (see
+ * ThreadLimit).  If the parameter is 0 or was not passed, all the threads of
+ * the executor are used.  The number of threads in effect before the call is
+ * restored afterwards, so each call of a binding can use a different number.
+ *
+ * @param params Parameters of the call.
+ * @param timers Timers of the call.
+ * @param function Binding function to call.
+ */
+inline void CallWithNumThreads(Params& params,
+                               Timers& timers,
+                               void (*function)(Params&, Timers&))
+{
+  int numThreads = 0;
+  if (params.Parameters().count("num_threads") > 0 &&
+      params.Has("num_threads"))
+    numThreads = params.Get<int>("num_threads");
+
+  if (numThreads < 0)
+  {
+    Log::Fatal << "Invalid value of num_threads (" << numThreads << "); it "
+        << "must be 0 (use all threads) or positive!" << std::endl;
+  }
+
+  ThreadLimit limit((size_t) numThreads);
+  function(params, timers);
+}
+
+} // namespace util
+} // namespace mlpack
+
+#endif
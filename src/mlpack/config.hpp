@@ -46,6 +46,48 @@
 #endif
 #endif
 
+//
+// mlpack can load Apache Arrow IPC files and Parquet files with data::Load(),
+// if Arrow and Parquet are available (and C++17 is used).  This is an optional
+// dependency, enabled with the USE_ARROW CMake option; when MLPACK_HAS_ARROW is
+// defined, programs that use mlpack must be linked with -larrow -lparquet.
+//
+#ifndef MLPACK_HAS_ARROW
+// #define MLPACK_HAS_ARROW
+#endif
+
+//
+// Sections of sectioned model files (see data::SectionedModelWriter) can be
+// compressed with zlib, if it is available.  This is an optional dependency,
+// enabled with the USE_ZLIB CMake option; when MLPACK_HAS_ZLIB is defined,
+// programs that use mlpack must be linked with -lz.
+//
+#ifndef MLPACK_HAS_ZLIB
+// #define MLPACK_HAS_ZLIB
+#endif
+
+//
+// The memory allocated by Armadillo and by tree nodes can be counted, and the
+// peak memory of each timed phase reported (see MemoryTracker), if
+// MLPACK_TRACK_MEMORY is defined.  This is enabled with the TRACK_MEMORY CMake
+// option, and makes allocations slower.
+//
+#ifndef MLPACK_TRACK_MEMORY
+// #define MLPACK_TRACK_MEMORY
+#endif
+
+//
+// Commonly used instantiations of method templates (the types held by NSModel,
+// RSModel and KDEModel, and the default FFN and layer types) can be compiled
+// once into libmlpack, with the BUILD_PREBUILT_LIBRARY CMake option.  When
+// MLPACK_USE_PREBUILT is defined, these instantiations are declared extern, so
+// that programs using them compile faster and are smaller; such programs must
+// be linked with -lmlpack.
+//
+#ifndef MLPACK_USE_PREBUILT
+// #define MLPACK_USE_PREBUILT
+#endif
+
 //
 // If the version of mlpack is built from a git repository and is not an
 // official release, then MLPACK_GIT_VERSION will be defined.  This causes
@@ -110,6 +152,10 @@
   #undef MLPACK_HAS_NO_STB_DIR
 #endif
 
+#ifdef MLPACK_DISABLE_ARROW
+  #undef MLPACK_HAS_ARROW
+#endif
+
 #ifdef MLPACK_DISABLE_BFD_DL
   #undef MLPACK_HAS_BFD_DL
 #endif
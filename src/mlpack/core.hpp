@@ -42,6 +42,8 @@
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/io.hpp>
 #include <mlpack/core/util/deprecated.hpp>
+#include <mlpack/core/util/executor.hpp>
+#include <mlpack/core/util/all_reduce.hpp>
 #include <mlpack/core/data/data.hpp>
 #include <mlpack/core/math/math.hpp>
 
@@ -17,6 +17,7 @@
 #include <cereal/archives/json.hpp>
 
 #include <mlpack/core/cereal/array_wrapper.hpp>
+#include <mlpack/core/cereal/mapped_archive.hpp>
 
 #include <armadillo>
 
@@ -72,6 +73,32 @@ void serialize(Archive& ar, arma::Mat<eT>& mat)
   ar(CEREAL_NVP(n_cols));
   ar(CEREAL_NVP(vec_state));
 
+  // Mapped archives keep the elements in a separate section of the file, and
+  // loaded matrices use the mapped memory directly instead of a copy of it.
+  MappedOutputArchive* mappedOutput = AsMappedOutputArchive(ar);
+  MappedInputArchive* mappedInput = AsMappedInputArchive(ar);
+  if ((mappedOutput || mappedInput) && (size_t(n_rows) * n_cols > 0))
+  {
+    const size_t bytes = size_t(n_rows) * n_cols * sizeof(eT);
+    size_t offset = 0;
+    if (mappedOutput)
+      offset = mappedOutput->SaveBlock(mat.memptr(), bytes, sizeof(eT));
+
+    ar(CEREAL_NVP(offset));
+
+    if (mappedInput)
+    {
+      // Non-strict auxiliary memory: if the matrix is resized later, it gets
+      // its own memory again.
+      arma::Mat<eT> mapped((eT*) mappedInput->Block(offset, bytes), n_rows,
+          n_cols, false, false);
+      mat.steal_mem(mapped);
+      arma::access::rw(mat.vec_state) = vec_state;
+    }
+
+    return;
+  }
+
   if (cereal::is_loading<Archive>())
   {
     mat.set_size(n_rows, n_cols);
@@ -0,0 +1,168 @@
+/**
+ * @file core/cereal/mapped_archive.hpp
+ *
+ * Binary cereal archives that store the elements of dense matrices in a
+ * separate section of a file, so that they can be loaded from a memory-mapped
+ * file without being copied.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CEREAL_MAPPED_ARCHIVE_HPP
+#define MLPACK_CORE_CEREAL_MAPPED_ARCHIVE_HPP
+
+#include <cereal/archives/binary.hpp>
+
+namespace cereal {
+
+/**
+ * An output archive that behaves exactly like cereal::BinaryOutputArchive,
+ * except that the elements of dense Armadillo matrices are written to a
+ * separate data stream, and only their offsets in that stream are written to
+ * the archive.  Since everything else is dispatched through
+ * BinaryOutputArchive, serialize() functions do not need to know about this
+ * archive at all.
+ */
+class MappedOutputArchive : public BinaryOutputArchive
+{
+ public:
+  /**
+   * Create the archive.
+   *
+   * @param stream Stream to write the structure of the object to.
+   * @param dataStream Stream to write the elements of matrices to.
+   * @param dataOffset Offset of the data stream's current position in the file
+   *     that it writes to.
+   */
+  MappedOutputArchive(std::ostream& stream,
+                      std::ostream& dataStream,
+                      const size_t dataOffset) :
+      BinaryOutputArchive(stream),
+      dataStream(dataStream),
+      dataOffset(dataOffset)
+  {
+    // Nothing to do.
+  }
+
+  //! The alignment of blocks of at least this many bytes.
+  static const size_t pageSize = 4096;
+
+  /**
+   * Write the given block of memory to the data stream, and return its offset
+   * in the file.  Blocks of at least a page are aligned to a page, so that a
+   * mapped block (like the parameters of a network) starts on its own page;
+   * other large blocks are aligned to 64 bytes (a cache line), and small ones
+   * only to the size of their elements.
+   *
+   * @param block Memory to write.
+   * @param bytes Size of the memory, in bytes.
+   * @param elemSize Size of each element of the memory, in bytes.
+   */
+  size_t SaveBlock(const void* block, const size_t bytes, const size_t elemSize)
+  {
+    static const char zeros[pageSize] = { 0 };
+    size_t alignment = elemSize;
+    if (bytes >= pageSize)
+      alignment = pageSize;
+    else if (bytes >= 1024)
+      alignment = 64;
+
+    const size_t padding = (alignment - (dataOffset % alignment)) % alignment;
+    dataStream.write(zeros, padding);
+    dataOffset += padding;
+
+    const size_t offset = dataOffset;
+    dataStream.write((const char*) block, bytes);
+    dataOffset += bytes;
+    if (!dataStream)
+      throw Exception("Failed to write matrix data to the mapped file.");
+
+    return offset;
+  }
+
+  //! Get the offset of the data stream's current position in the file.
+  size_t DataOffset() const { return dataOffset; }
+
+ private:
+  //! The stream that the elements of matrices are written to.
+  std::ostream& dataStream;
+  //! The offset of the data stream's current position in the file.
+  size_t dataOffset;
+};
+
+/**
+ * An input archive that behaves exactly like cereal::BinaryInputArchive, but
+ * that can also give the memory of blocks written by a MappedOutputArchive, so
+ * that dense Armadillo matrices can use it directly as auxiliary memory.
+ */
+class MappedInputArchive : public BinaryInputArchive
+{
+ public:
+  /**
+   * Create the archive.
+   *
+   * @param stream Stream to read the structure of the object from.
+   * @param data Start of the (mapped) file that holds the blocks.
+   * @param size Size of the file, in bytes.
+   */
+  MappedInputArchive(std::istream& stream, char* data, const size_t size) :
+      BinaryInputArchive(stream),
+      data(data),
+      size(size)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Get the block of memory at the given offset of the file.  An exception is
+   * thrown if the block does not fit in the file.
+   *
+   * @param offset Offset of the block, in bytes.
+   * @param bytes Size of the block, in bytes.
+   */
+  char* Block(const size_t offset, const size_t bytes) const
+  {
+    if (offset > size || bytes > size - offset)
+      throw Exception("Matrix data lies outside of the mapped file.");
+
+    return data + offset;
+  }
+
+ private:
+  //! The start of the file that holds the blocks.
+  char* data;
+  //! The size of the file, in bytes.
+  size_t size;
+};
+
+//! Return the given archive as a MappedOutputArchive, or NULL if it is not one.
+template<typename Archive>
+inline MappedOutputArchive* AsMappedOutputArchive(Archive& /* ar */)
+{
+  return NULL;
+}
+
+//! Return the given archive as a MappedOutputArchive, or NULL if it is not one.
+inline MappedOutputArchive* AsMappedOutputArchive(BinaryOutputArchive& ar)
+{
+  return dynamic_cast<MappedOutputArchive*>(&ar);
+}
+
+//! Return the given archive as a MappedInputArchive, or NULL if it is not one.
+template<typename Archive>
+inline MappedInputArchive* AsMappedInputArchive(Archive& /* ar */)
+{
+  return NULL;
+}
+
+//! Return the given archive as a MappedInputArchive, or NULL if it is not one.
+inline MappedInputArchive* AsMappedInputArchive(BinaryInputArchive& ar)
+{
+  return dynamic_cast<MappedInputArchive*>(&ar);
+}
+
+} // namespace cereal
+
+#endif
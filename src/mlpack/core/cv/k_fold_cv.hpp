@@ -43,6 +43,11 @@ namespace mlpack {
  * the @c Shuffle() function.  Shuffling is performed at construction time if
  * the parameter @c shuffle is set to @c true in the constructor.
  *
+ * If @c Parallel() is set to @c true, the folds are trained and evaluated at
+ * the same time in different threads, each with its own model.  In that case
+ * the data is not rotated for each fold, so the training subsets of the folds
+ * that wrap around the end of the dataset are copied.
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam MatType The type of data.
@@ -176,9 +181,29 @@ class KFoldCV
   template<typename... MLAlgorithmArgs>
   double Evaluate(const MLAlgorithmArgs& ...args);
 
+  /**
+   * Run k-fold cross-validation as Evaluate() does, but store the model of the
+   * last fold in the given pointer rather than in this object.  This object is
+   * not modified (the folds are evaluated one after another, without rotating
+   * the data), so several calls can run at once in different threads, for
+   * instance to evaluate several sets of hyperparameters at the same time.
+   *
+   * @param model Pointer to store the model of the last fold into.
+   * @param args Arguments for MLAlgorithm (in addition to the passed
+   *     ones in the constructor).
+   */
+  template<typename... MLAlgorithmArgs>
+  double EvaluateModel(std::unique_ptr<MLAlgorithm>& model,
+                       const MLAlgorithmArgs& ...args);
+
   //! Access and modify a model from the last run of k-fold cross-validation.
   MLAlgorithm& Model();
 
+  //! Get whether the folds are evaluated in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the folds are evaluated in parallel.
+  bool& Parallel() { return parallel; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -208,11 +233,11 @@ class KFoldCV
   //! The number of bins in the dataset.
   const size_t k;
 
-  //! The extended (by repeating the first k - 2 bins) data points.
+  //! The data points, with their columns rotated for the current fold.
   MatType xs;
-  //! The extended (by repeating the first k - 2 bins) predictions.
+  //! The predictions, with their columns rotated for the current fold.
   PredictionsType ys;
-  //! The extended (by repeating the first k - 2 bins) weights.
+  //! The weights, with their columns rotated for the current fold.
   WeightsType weights;
 
   //! The original size of the dataset.
@@ -221,6 +246,12 @@ class KFoldCV
   //! The size of each bin in terms of data points.
   size_t binSize;
 
+  //! The number of columns by which the data is rotated to the left.
+  size_t rotation;
+
+  //! Whether the folds are evaluated in parallel.
+  bool parallel;
+
   //! A pointer to a model from the last run of k-fold cross-validation.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
@@ -246,64 +277,132 @@ class KFoldCV
           const bool shuffle);
 
   /**
-   * Initialize the given destination matrix with the given source joined with
-   * its first k - 2 bins.
+   * Initialize the given destination matrix with the given source, and set the
+   * sizes of the bins.
    */
   template<typename DataType>
   void InitKFoldCVMat(const DataType& source, DataType& destination);
 
   /**
-   * Train and run evaluation in the case of non-weighted learning.
+   * Rotate the columns of the data so that the ith training subset is the first
+   * columns and the ith validation subset is the last columns.  The ith
+   * validation subset is the (i - 1)th bin (the last bin if i is 0), and the
+   * training subset starts with the bin after it.  The rotation is done in
+   * place, so no copy of the data is made for any fold.
+   */
+  void ArrangeFold(const size_t i);
+
+  /**
+   * Rotate the columns of the given matrix to the left by the given number of
+   * columns, in place.
+   */
+  template<typename DataType>
+  static void RotateColumns(DataType& m, const size_t cols);
+
+  /**
+   * Train and run evaluation in the case of non-weighted learning.  The model
+   * of the last fold is stored in the given pointer.  If arranged is true, the
+   * data is rotated for each fold; otherwise, the folds are evaluated in
+   * parallel if concurrent is true.
    */
   template<typename... MLAlgorithmArgs,
            bool Enabled = !Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type>
-  double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+  double TrainAndEvaluate(std::unique_ptr<MLAlgorithm>& model,
+                          const bool arranged,
+                          const bool concurrent,
+                          const MLAlgorithmArgs& ...mlAlgorithmArgs);
 
   /**
-   * Train and run evaluation in the case of supporting weighted learning.
+   * Train and run evaluation in the case of supporting weighted learning (see
+   * the other overload of TrainAndEvaluate()).
    */
   template<typename... MLAlgorithmArgs,
            bool Enabled = Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type,
            typename = void>
-  double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+  double TrainAndEvaluate(std::unique_ptr<MLAlgorithm>& model,
+                          const bool arranged,
+                          const bool concurrent,
+                          const MLAlgorithmArgs& ...mlAlgorithmArgs);
 
   /**
-   * Calculate the index of the first column of the ith validation subset.
-   *
-   * We take the ith validation subset after the ith training subset if
-   * i < k - 1 and before it otherwise.
+   * Compute the score of each fold, and store the model of the last fold in
+   * the given pointer (see TrainAndEvaluate()).
+   */
+  template<typename... MLAlgorithmArgs>
+  void EvaluateFolds(arma::vec& evaluations,
+                     std::unique_ptr<MLAlgorithm>& model,
+                     const bool arranged,
+                     const bool concurrent,
+                     const MLAlgorithmArgs& ...mlAlgorithmArgs);
+
+  /**
+   * Train a model on the ith training subset, in the case of non-weighted
+   * learning.
+   */
+  template<typename... MLAlgorithmArgs,
+           bool Enabled = !Base::MIE::SupportsWeights,
+           typename = typename std::enable_if<Enabled>::type>
+  MLAlgorithm TrainFold(const size_t i,
+                        const bool arranged,
+                        const MLAlgorithmArgs& ...mlAlgorithmArgs);
+
+  /**
+   * Train a model on the ith training subset, in the case of supporting
+   * weighted learning.
+   */
+  template<typename... MLAlgorithmArgs,
+           bool Enabled = Base::MIE::SupportsWeights,
+           typename = typename std::enable_if<Enabled>::type,
+           typename = void>
+  MLAlgorithm TrainFold(const size_t i,
+                        const bool arranged,
+                        const MLAlgorithmArgs& ...mlAlgorithmArgs);
+
+  /**
+   * Calculate the index of the first column of the ith validation subset.  If
+   * arranged is true, the validation subset is after the ith training subset
+   * (once ArrangeFold(i) is called); otherwise it is the (i - 1)th bin (the
+   * last bin if i is 0) of the data in its original order.
    */
-  inline size_t ValidationSubsetFirstCol(const size_t i);
+  inline size_t ValidationSubsetFirstCol(const size_t i, const bool arranged);
 
   /**
-   * Get the ith training subset from a variable of a matrix type.
+   * Get the ith training subset from a variable of a matrix type.  If arranged
+   * is false, the data is in its original order.
    */
   template<typename ElementType>
   inline arma::Mat<ElementType> GetTrainingSubset(arma::Mat<ElementType>& m,
-                                                  const size_t i);
+                                                  const size_t i,
+                                                  const bool arranged);
 
   /**
-   * Get the ith training subset from a variable of a row type.
+   * Get the ith training subset from a variable of a row type.  If arranged
+   * is false, the data is in its original order.
    */
   template<typename ElementType>
   inline arma::Row<ElementType> GetTrainingSubset(arma::Row<ElementType>& r,
-                                                  const size_t i);
+                                                  const size_t i,
+                                                  const bool arranged);
 
   /**
-   * Get the ith validation subset from a variable of a matrix type.
+   * Get the ith validation subset from a variable of a matrix type.  If
+   * arranged is false, the data is in its original order.
    */
   template<typename ElementType>
   inline arma::Mat<ElementType> GetValidationSubset(arma::Mat<ElementType>& m,
-                                                    const size_t i);
+                                                    const size_t i,
+                                                    const bool arranged);
 
   /**
-   * Get the ith validation subset from a variable of a row type.
+   * Get the ith validation subset from a variable of a row type.  If
+   * arranged is false, the data is in its original order.
    */
   template<typename ElementType>
   inline arma::Row<ElementType> GetValidationSubset(arma::Row<ElementType>& r,
-                                                    const size_t i);
+                                                    const size_t i,
+                                                    const bool arranged);
 };
 
 } // namespace mlpack
@@ -12,6 +12,9 @@
 #ifndef MLPACK_CORE_CV_K_FOLD_CV_IMPL_HPP
 #define MLPACK_CORE_CV_K_FOLD_CV_IMPL_HPP
 
+#include <exception>
+#include <mlpack/core/util/executor.hpp>
+
 namespace mlpack {
 
 template<typename MLAlgorithm,
@@ -134,7 +137,9 @@ KFoldCV<MLAlgorithm,
                               const PredictionsType& ys,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    rotation(0),
+    parallel(false)
 {
   if (k < 2)
     throw std::invalid_argument("KFoldCV: k should not be less than 2");
@@ -165,7 +170,9 @@ KFoldCV<MLAlgorithm,
                               const WeightsType& weights,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    rotation(0),
+    parallel(false)
 {
   Base::AssertWeightsConsistency(xs, weights);
 
@@ -190,7 +197,23 @@ double KFoldCV<MLAlgorithm,
                PredictionsType,
                WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
 {
-  return TrainAndEvaluate(args...);
+  return TrainAndEvaluate(modelPtr, !parallel, parallel, args...);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+double KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::EvaluateModel(std::unique_ptr<MLAlgorithm>& model,
+                                           const MLAlgorithmArgs&... args)
+{
+  return TrainAndEvaluate(model, false, false, args...);
 }
 
 template<typename MLAlgorithm,
@@ -227,8 +250,53 @@ void KFoldCV<MLAlgorithm,
   binSize = source.n_cols / k;
   lastBinSize = source.n_cols - ((k - 1) * binSize);
 
-  destination = (k == 2) ? source : join_rows(source,
-      source.cols(0, source.n_cols - lastBinSize - 1));
+  destination = source;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+void KFoldCV<MLAlgorithm,
+             Metric,
+             MatType,
+             PredictionsType,
+             WeightsType>::ArrangeFold(const size_t i)
+{
+  // The data is rotated by one bin for each fold, so that the training subset
+  // of each fold is contiguous.
+  const size_t n = xs.n_cols;
+  if (n == 0)
+    return;
+
+  const size_t target = binSize * i;
+  const size_t cols = (target + n - rotation) % n;
+  if (cols != 0)
+  {
+    RotateColumns(xs, cols);
+    RotateColumns(ys, cols);
+    if (weights.n_elem > 0)
+      RotateColumns(weights, cols);
+  }
+
+  rotation = target;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename DataType>
+void KFoldCV<MLAlgorithm,
+             Metric,
+             MatType,
+             PredictionsType,
+             WeightsType>::RotateColumns(DataType& m, const size_t cols)
+{
+  // Columns are contiguous, so this is a rotation of the memory.
+  std::rotate(m.memptr(), m.memptr() + cols * m.n_rows, m.memptr() + m.n_elem);
 }
 
 template<typename MLAlgorithm,
@@ -241,17 +309,18 @@ double KFoldCV<MLAlgorithm,
                 Metric,
                 MatType,
                 PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+                WeightsType>::TrainAndEvaluate(
+    std::unique_ptr<MLAlgorithm>& model,
+    const bool arranged,
+    const bool concurrent,
+    const MLAlgorithmArgs&... args)
 {
-  arma::vec evaluations(k);
+  arma::vec evaluations;
+  EvaluateFolds(evaluations, model, arranged, concurrent, args...);
 
   size_t numInvalidScores = 0;
   for (size_t i = 0; i < k; ++i)
   {
-    MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
-        GetTrainingSubset(ys, i), args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
     if (std::isnan(evaluations(i)) || std::isinf(evaluations(i)))
     {
       ++numInvalidScores;
@@ -259,8 +328,6 @@ double KFoldCV<MLAlgorithm,
           << "a score of " << evaluations(i) << "; ignoring when computing "
           << "the average score." << std::endl;
     }
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
   }
 
   if (numInvalidScores == k)
@@ -283,24 +350,125 @@ double KFoldCV<MLAlgorithm,
                 Metric,
                 MatType,
                 PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+                WeightsType>::TrainAndEvaluate(
+    std::unique_ptr<MLAlgorithm>& model,
+    const bool arranged,
+    const bool concurrent,
+    const MLAlgorithmArgs&... args)
 {
-  arma::vec evaluations(k);
+  arma::vec evaluations;
+  EvaluateFolds(evaluations, model, arranged, concurrent, args...);
 
+  return arma::mean(evaluations);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+void KFoldCV<MLAlgorithm,
+             Metric,
+             MatType,
+             PredictionsType,
+             WeightsType>::EvaluateFolds(arma::vec& evaluations,
+                                         std::unique_ptr<MLAlgorithm>& model,
+                                         const bool arranged,
+                                         const bool concurrent,
+                                         const MLAlgorithmArgs&... args)
+{
+  evaluations.set_size(k);
+
+  if (arranged)
+  {
+    for (size_t i = 0; i < k; ++i)
+    {
+      ArrangeFold(i);
+      MLAlgorithm foldModel = TrainFold(i, true, args...);
+      evaluations(i) = Metric::Evaluate(foldModel,
+          GetValidationSubset(xs, i, true), GetValidationSubset(ys, i, true));
+      if (i == k - 1)
+        model.reset(new MLAlgorithm(std::move(foldModel)));
+    }
+
+    // Restore the original order of the data.
+    ArrangeFold(0);
+    return;
+  }
+
+  // Each fold has its own model, and the data is only read, so the folds can
+  // be evaluated at the same time.  An exception cannot leave an OpenMP loop,
+  // so the first one is kept and thrown after the loop.
+  std::exception_ptr exception;
+  #pragma omp parallel for schedule(dynamic) if (concurrent) \
+      num_threads((int) NumThreads())
   for (size_t i = 0; i < k; ++i)
   {
-    MLAlgorithm&& model = (weights.n_elem > 0) ?
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            GetTrainingSubset(weights, i), args...) :
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
+    try
+    {
+      MLAlgorithm foldModel = TrainFold(i, false, args...);
+      evaluations(i) = Metric::Evaluate(foldModel,
+          GetValidationSubset(xs, i, false),
+          GetValidationSubset(ys, i, false));
+      if (i == k - 1)
+        model.reset(new MLAlgorithm(std::move(foldModel)));
+    }
+    catch (...)
+    {
+      #pragma omp critical
+      {
+        if (!exception)
+          exception = std::current_exception();
+      }
+    }
   }
 
-  return arma::mean(evaluations);
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs, bool Enabled, typename>
+MLAlgorithm KFoldCV<MLAlgorithm,
+                    Metric,
+                    MatType,
+                    PredictionsType,
+                    WeightsType>::TrainFold(const size_t i,
+                                            const bool arranged,
+                                            const MLAlgorithmArgs&... args)
+{
+  return base.Train(GetTrainingSubset(xs, i, arranged),
+      GetTrainingSubset(ys, i, arranged), args...);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs, bool Enabled, typename, typename>
+MLAlgorithm KFoldCV<MLAlgorithm,
+                    Metric,
+                    MatType,
+                    PredictionsType,
+                    WeightsType>::TrainFold(const size_t i,
+                                            const bool arranged,
+                                            const MLAlgorithmArgs&... args)
+{
+  if (weights.n_elem > 0)
+  {
+    return base.Train(GetTrainingSubset(xs, i, arranged),
+        GetTrainingSubset(ys, i, arranged),
+        GetTrainingSubset(weights, i, arranged), args...);
+  }
+
+  return base.Train(GetTrainingSubset(xs, i, arranged),
+      GetTrainingSubset(ys, i, arranged), args...);
 }
 
 template<typename MLAlgorithm,
@@ -315,14 +483,9 @@ void KFoldCV<MLAlgorithm,
              PredictionsType,
              WeightsType>::Shuffle()
 {
-  MatType xsOrig = xs.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  PredictionsType ysOrig = ys.cols(0, (k - 1) * binSize + lastBinSize - 1);
-
-  // Now shuffle the data.
-  ShuffleData(xsOrig, ysOrig, xsOrig, ysOrig);
-
-  InitKFoldCVMat(xsOrig, xs);
-  InitKFoldCVMat(ysOrig, ys);
+  // Shuffle the data from its original order.
+  ArrangeFold(0);
+  ShuffleData(xs, ys, xs, ys);
 }
 
 template<typename MLAlgorithm,
@@ -337,22 +500,12 @@ void KFoldCV<MLAlgorithm,
              PredictionsType,
              WeightsType>::Shuffle()
 {
-  MatType xsOrig = xs.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  PredictionsType ysOrig = ys.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  WeightsType weightsOrig;
-  if (weights.n_elem > 0)
-    weightsOrig = weights.cols(0, (k - 1) * binSize + lastBinSize - 1);
-
-  // Now shuffle the data.
+  // Shuffle the data from its original order.
+  ArrangeFold(0);
   if (weights.n_elem > 0)
-    ShuffleData(xsOrig, ysOrig, weightsOrig, xsOrig, ysOrig, weightsOrig);
+    ShuffleData(xs, ys, weights, xs, ys, weights);
   else
-    ShuffleData(xsOrig, ysOrig, xsOrig, ysOrig);
-
-  InitKFoldCVMat(xsOrig, xs);
-  InitKFoldCVMat(ysOrig, ys);
-  if (weights.n_elem > 0)
-    InitKFoldCVMat(weightsOrig, weights);
+    ShuffleData(xs, ys, xs, ys);
 }
 
 template<typename MLAlgorithm,
@@ -364,10 +517,14 @@ size_t KFoldCV<MLAlgorithm,
                Metric,
                MatType,
                PredictionsType,
-               WeightsType>::ValidationSubsetFirstCol(const size_t i)
+               WeightsType>::ValidationSubsetFirstCol(const size_t i,
+                                                      const bool arranged)
 {
-  // Use as close to the beginning of the dataset as we can.
-  return (i == 0) ? binSize * (k - 1) : binSize * (i - 1);
+  // The validation subset is the last columns of the arranged data.
+  if (arranged)
+    return xs.n_cols - ((i == 0) ? lastBinSize : binSize);
+  else
+    return (i == 0) ? binSize * (k - 1) : binSize * (i - 1);
 }
 
 template<typename MLAlgorithm,
@@ -382,7 +539,8 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
                                PredictionsType,
                                WeightsType>::GetTrainingSubset(
     arma::Mat<ElementType>& m,
-    const size_t i)
+    const size_t i,
+    const bool arranged)
 {
   // If this is not the first fold, we have to handle it a little bit
   // differently, since the last fold may contain slightly more than 'binSize'
@@ -390,7 +548,16 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
   const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
       (k - 1) * binSize;
 
-  return arma::Mat<ElementType>(m.colptr(binSize * i), m.n_rows, subsetSize,
+  // In the original order, the training subset starts at the ith bin, and
+  // wraps around the end of the data after the second fold.
+  if (!arranged && i > 1)
+  {
+    return arma::join_rows(m.cols(binSize * i, m.n_cols - 1),
+        m.cols(0, binSize * (i - 1) - 1));
+  }
+
+  const size_t firstCol = arranged ? 0 : binSize * i;
+  return arma::Mat<ElementType>(m.colptr(firstCol), m.n_rows, subsetSize,
       false, true);
 }
 
@@ -406,7 +573,8 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
                                PredictionsType,
                                WeightsType>::GetTrainingSubset(
     arma::Row<ElementType>& r,
-    const size_t i)
+    const size_t i,
+    const bool arranged)
 {
   // If this is not the first fold, we have to handle it a little bit
   // differently, since the last fold may contain slightly more than 'binSize'
@@ -414,7 +582,16 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
   const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
       (k - 1) * binSize;
 
-  return arma::Row<ElementType>(r.colptr(binSize * i), subsetSize, false, true);
+  // In the original order, the training subset starts at the ith bin, and
+  // wraps around the end of the data after the second fold.
+  if (!arranged && i > 1)
+  {
+    return arma::join_rows(r.cols(binSize * i, r.n_cols - 1),
+        r.cols(0, binSize * (i - 1) - 1));
+  }
+
+  const size_t firstCol = arranged ? 0 : binSize * i;
+  return arma::Row<ElementType>(r.colptr(firstCol), subsetSize, false, true);
 }
 
 template<typename MLAlgorithm,
@@ -429,11 +606,12 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
                                PredictionsType,
                                WeightsType>::GetValidationSubset(
     arma::Mat<ElementType>& m,
-    const size_t i)
+    const size_t i,
+    const bool arranged)
 {
   const size_t subsetSize = (i == 0) ? lastBinSize : binSize;
-  return arma::Mat<ElementType>(m.colptr(ValidationSubsetFirstCol(i)), m.n_rows,
-      subsetSize, false, true);
+  return arma::Mat<ElementType>(m.colptr(ValidationSubsetFirstCol(i,
+      arranged)), m.n_rows, subsetSize, false, true);
 }
 
 template<typename MLAlgorithm,
@@ -448,11 +626,12 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
                                PredictionsType,
                                WeightsType>::GetValidationSubset(
     arma::Row<ElementType>& r,
-    const size_t i)
+    const size_t i,
+    const bool arranged)
 {
   const size_t subsetSize = (i == 0) ? lastBinSize : binSize;
-  return arma::Row<ElementType>(r.colptr(ValidationSubsetFirstCol(i)),
-      subsetSize, false, true);
+  return arma::Row<ElementType>(r.colptr(ValidationSubsetFirstCol(i,
+      arranged)), subsetSize, false, true);
 }
 
 } // namespace mlpack
@@ -43,6 +43,22 @@ class ROCAUCScore
   static double Evaluate(const arma::Row<size_t>& labels,
                          const arma::Row<double>& scores);
 
+  /**
+   * Estimate the area under the ROC curve without sorting the scores: the
+   * range of the scores is split into numBins bins of equal width, the numbers
+   * of positive and negative points in each bin are counted in parallel, and
+   * the points of each bin are treated as tied.  This takes O(n + numBins)
+   * time; the estimate is exact if no bin holds points of both classes with
+   * different scores.
+   *
+   * @param labels Ground truth (correct) labels.
+   * @param scores Probability scores of positive class.
+   * @param numBins Number of bins of the scores.
+   */
+  static double Evaluate(const arma::Row<size_t>& labels,
+                         const arma::Row<double>& scores,
+                         const size_t numBins);
+
   /**
    * Information for hyper-parameter tuning code. It indicates that we want
    * to maximize the metric.
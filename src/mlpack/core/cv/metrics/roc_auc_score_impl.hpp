@@ -84,6 +84,80 @@ double ROCAUCScore<PositiveClass>::Evaluate(const arma::Row<size_t>& labels,
   return auc(0, 0);
 }
 
+template<size_t PositiveClass>
+double ROCAUCScore<PositiveClass>::Evaluate(const arma::Row<size_t>& labels,
+                                            const arma::rowvec& scores,
+                                            const size_t numBins)
+{
+  util::CheckSameSizes(labels, scores, "ROCAUCScore::Evaluate()");
+
+  if (labels.n_cols == 0)
+  {
+    throw std::invalid_argument(
+        "ROCAUCScore::Evaluate(): "
+        "number of points in input data cannot be zero");
+  }
+
+  if (numBins == 0)
+  {
+    throw std::invalid_argument(
+        "ROCAUCScore::Evaluate(): number of bins must be positive");
+  }
+
+  const double lo = scores.min();
+  const double hi = scores.max();
+  const double scale = (hi > lo) ? numBins / (hi - lo) : 0.0;
+
+  // Count the positive and negative points of each bin; each chunk of points
+  // has its own histograms, which are then summed.
+  const size_t numChunks = std::min((size_t) 64,
+      (size_t) (labels.n_elem + 65535) / 65536);
+  const size_t chunkSize = (labels.n_elem + numChunks - 1) / numChunks;
+  arma::Mat<size_t> positives(numBins, numChunks, arma::fill::zeros);
+  arma::Mat<size_t> negatives(numBins, numChunks, arma::fill::zeros);
+
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    const size_t end = std::min((c + 1) * chunkSize, (size_t) labels.n_elem);
+    for (size_t i = c * chunkSize; i < end; ++i)
+    {
+      const size_t bin = std::min((size_t) ((scores[i] - lo) * scale),
+          numBins - 1);
+      if (labels[i] == PositiveClass)
+        ++positives(bin, c);
+      else
+        ++negatives(bin, c);
+    }
+  }
+
+  const arma::Col<size_t> binPositives = arma::sum(positives, 1);
+  const arma::Col<size_t> binNegatives = arma::sum(negatives, 1);
+  const size_t numberOfTrueLabels = arma::accu(binPositives);
+  const size_t numberOfFalseLabels = labels.n_elem - numberOfTrueLabels;
+
+  // Check if only one class is given in labels.
+  if (numberOfTrueLabels == 0 || numberOfFalseLabels == 0)
+  {
+    throw std::invalid_argument(
+        "ROCAUCScore::Evaluate(): "
+        "only one class is given in labels, ROCAUCScore is undefined");
+  }
+
+  // Go through the bins from the highest scores; each negative point counts
+  // the positive points with higher scores, and half of those with the same
+  // score.  This is the area under the curve of the trapezoidal rule.
+  double auc = 0.0;
+  size_t positivesAbove = 0;
+  for (size_t b = numBins; b > 0; --b)
+  {
+    auc += binNegatives[b - 1] * (positivesAbove + 0.5 * binPositives[b - 1]);
+    positivesAbove += binPositives[b - 1];
+  }
+
+  return auc / ((double) numberOfTrueLabels * numberOfFalseLabels);
+}
+
 } // namespace mlpack
 
 #endif
@@ -45,12 +45,15 @@ class SilhouetteScore
    * @param X Column-major data used for clustering.
    * @param labels Labels assigned to data by clustering.
    * @param metric Metric to be used to calculate dissimilarity.
+   * @param samplesPerCluster If positive, the mean distances to each cluster
+   *     are estimated from at most this many random points of the cluster.
    * @return (double) silhouette score.
    */
   template<typename DataType, typename Metric>
   static double Overall(const DataType& X,
                         const arma::Row<size_t>& labels,
-                        const Metric& metric);
+                        const Metric& metric,
+                        const size_t samplesPerCluster = 0);
 
   /**
    * Find the individual silhouette scores for precomputted dissimilarites.
@@ -67,15 +70,26 @@ class SilhouetteScore
    * Find silhouette score of all individual elements.
    * (Distance not precomputed).
    *
+   * The distance matrix is not stored: the distances are computed in blocks,
+   * in parallel, with the batch Evaluate() method of the metric if it has one
+   * (see HasBatchEvaluate), and only the sums of the distances from each point
+   * to each cluster are kept.  This takes O(n k) memory for n points and k
+   * clusters.  If samplesPerCluster is positive, the sums are taken over at
+   * most samplesPerCluster random points of each cluster, which takes
+   * O(n k samplesPerCluster) time instead of O(n^2).
+   *
    * @param X Column-major data used for clustering.
    * @param labels Labels assigned to data by clustering.
    * @param metric Metric to be used to calculate dissimilarity.
+   * @param samplesPerCluster If positive, the mean distances to each cluster
+   *     are estimated from at most this many random points of the cluster.
    * @return (arma::rowvec) element-wise silhouette score.
    */
   template<typename DataType, typename Metric>
   static arma::rowvec SamplesScore(const DataType& X,
                                    const arma::Row<size_t>& labels,
-                                   const Metric& metric);
+                                   const Metric& metric,
+                                   const size_t samplesPerCluster = 0);
 
   /**
    * Find mean distance of element from a given cluster.
@@ -96,6 +110,30 @@ class SilhouetteScore
    * to maximize the metric.
    */
   static const bool NeedsMinimization = false;
+
+ private:
+  /**
+   * Compute sums(c, i), the sum of the distances from X.col(i) to the points
+   * of X with the given indices that are in cluster c, skipping the distance
+   * of each point to itself.
+   *
+   * @param X Column-major data used for clustering.
+   * @param indices Indices of the points to sum the distances to.
+   * @param clusters Cluster of each point in X.
+   * @param numClusters Number of clusters.
+   * @param metric Metric to be used to calculate dissimilarity.
+   * @param sums Will contain the sums of distances to each cluster.
+   */
+  template<typename DataType, typename Metric>
+  static void ClusterDistanceSums(const DataType& X,
+                                  const arma::uvec& indices,
+                                  const arma::uvec& clusters,
+                                  const size_t numClusters,
+                                  const Metric& metric,
+                                  arma::mat& sums);
+
+  //! Number of points of each side of a block of distances.
+  static constexpr size_t BlockSize = 256;
 };
 
 } // namespace mlpack
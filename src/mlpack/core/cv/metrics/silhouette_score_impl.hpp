@@ -13,16 +13,19 @@
 #define MLPACK_CORE_CV_METRICS_SILHOUETTE_SCORE_IMPL_HPP
 
 #include <mlpack/core/cv/metrics/facilities.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+#include <mlpack/core/util/executor.hpp>
 
 namespace mlpack {
 
 template<typename DataType, typename Metric>
 double SilhouetteScore::Overall(const DataType& X,
                                 const arma::Row<size_t>& labels,
-                                const Metric& metric)
+                                const Metric& metric,
+                                const size_t samplesPerCluster)
 {
   util::CheckSameSizes(X, labels, "SilhouetteScore::Overall()");
-  return arma::mean(SamplesScore(X, labels, metric));
+  return arma::mean(SamplesScore(X, labels, metric, samplesPerCluster));
 }
 
 template<typename DataType>
@@ -73,11 +76,154 @@ arma::rowvec SilhouetteScore::SamplesScore(const DataType& distances,
 template<typename DataType, typename Metric>
 arma::rowvec SilhouetteScore::SamplesScore(const DataType& X,
                                            const arma::Row<size_t>& labels,
-                                           const Metric& metric)
+                                           const Metric& metric,
+                                           const size_t samplesPerCluster)
 {
   util::CheckSameSizes(X, labels, "SilhouetteScore::SamplesScore()");
-  DataType distances = PairwiseDistances(X, metric);
-  return SamplesScore(distances, labels);
+  if (labels.n_elem == 0)
+    return arma::rowvec();
+
+  // Map the labels to clusters 0, ..., numClusters - 1.
+  const arma::Row<size_t> clusterLabels = arma::unique(labels);
+  const size_t numClusters = clusterLabels.n_elem;
+  arma::uvec clusters(labels.n_elem);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    clusters[i] = std::lower_bound(clusterLabels.begin(), clusterLabels.end(),
+        labels[i]) - clusterLabels.begin();
+  }
+
+  // Choose the points that the distances are summed over: all of them, or a
+  // random sample of each cluster.
+  arma::uvec indices;
+  if (samplesPerCluster == 0)
+  {
+    indices = arma::regspace<arma::uvec>(0, labels.n_elem - 1);
+  }
+  else
+  {
+    std::vector<arma::uvec> samples(numClusters);
+    size_t numSamples = 0;
+    for (size_t c = 0; c < numClusters; ++c)
+    {
+      const arma::uvec members = arma::find(clusters == c);
+      samples[c] = (members.n_elem <= samplesPerCluster) ? members :
+          arma::uvec(members.elem(arma::randperm(members.n_elem,
+          samplesPerCluster)));
+      numSamples += samples[c].n_elem;
+    }
+
+    indices.set_size(numSamples);
+    size_t next = 0;
+    for (size_t c = 0; c < numClusters; ++c)
+    {
+      indices.subvec(next, next + samples[c].n_elem - 1) = samples[c];
+      next += samples[c].n_elem;
+    }
+  }
+
+  // Count the sampled points of each cluster, and mark which points are
+  // sampled, since they are not counted in their own mean distance.
+  arma::Col<size_t> counts(numClusters, arma::fill::zeros);
+  std::vector<bool> sampled(labels.n_elem, false);
+  for (size_t j = 0; j < indices.n_elem; ++j)
+  {
+    ++counts[clusters[indices[j]]];
+    sampled[indices[j]] = true;
+  }
+
+  arma::mat sums;
+  ClusterDistanceSums(X, indices, clusters, numClusters, metric, sums);
+
+  arma::rowvec sampleScores(labels.n_elem);
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    const size_t cluster = clusters[i];
+    const size_t sameCount = counts[cluster] - (sampled[i] ? 1 : 0);
+    const double intraClusterDistance = (sameCount == 0) ? 0.0 :
+        sums(cluster, i) / sameCount;
+    if (intraClusterDistance == 0)
+    {
+      // i is the only element in the cluster.
+      sampleScores[i] = 0.0;
+      continue;
+    }
+
+    double minInterClusterDistance = DBL_MAX;
+    for (size_t c = 0; c < numClusters; ++c)
+    {
+      if (c != cluster && counts[c] > 0)
+      {
+        minInterClusterDistance = std::min(minInterClusterDistance,
+            sums(c, i) / counts[c]);
+      }
+    }
+
+    sampleScores[i] = (minInterClusterDistance - intraClusterDistance) /
+        std::max(intraClusterDistance, minInterClusterDistance);
+  }
+
+  return sampleScores;
+}
+
+template<typename DataType, typename Metric>
+void SilhouetteScore::ClusterDistanceSums(const DataType& X,
+                                          const arma::uvec& indices,
+                                          const arma::uvec& clusters,
+                                          const size_t numClusters,
+                                          const Metric& metric,
+                                          arma::mat& sums)
+{
+  sums.zeros(numClusters, X.n_cols);
+
+  // Only a block of the points that the distances are summed over is gathered
+  // at a time, unless they are all the points.
+  const bool allPoints = (indices.n_elem == X.n_cols);
+  const size_t queryBlocks = (X.n_cols + BlockSize - 1) / BlockSize;
+  const size_t referenceBlocks = (indices.n_elem + BlockSize - 1) / BlockSize;
+
+  // Each block of points has its own columns of sums.
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t q = 0; q < queryBlocks; ++q)
+  {
+    Metric localMetric(metric);
+    const size_t queryBegin = q * BlockSize;
+    const size_t queryEnd = std::min(queryBegin + BlockSize,
+        (size_t) X.n_cols);
+
+    arma::mat distances;
+    for (size_t r = 0; r < referenceBlocks; ++r)
+    {
+      const size_t referenceBegin = r * BlockSize;
+      const size_t referenceEnd = std::min(referenceBegin + BlockSize,
+          (size_t) indices.n_elem);
+
+      if (allPoints)
+      {
+        KernelMatrixTile(localMetric, X, X, queryBegin, queryEnd,
+            referenceBegin, referenceEnd, distances,
+            HasBatchEvaluate<Metric>());
+      }
+      else
+      {
+        const DataType references = X.cols(indices.subvec(referenceBegin,
+            referenceEnd - 1));
+        KernelMatrixTile(localMetric, X, references, queryBegin, queryEnd,
+            0, references.n_cols, distances, HasBatchEvaluate<Metric>());
+      }
+
+      for (size_t j = referenceBegin; j < referenceEnd; ++j)
+      {
+        const size_t cluster = clusters[indices[j]];
+        for (size_t i = queryBegin; i < queryEnd; ++i)
+        {
+          if (i != indices[j])
+            sums(cluster, i) += distances(i - queryBegin, j - referenceBegin);
+        }
+      }
+    }
+  }
 }
 
 inline double SilhouetteScore::MeanDistanceFromCluster(
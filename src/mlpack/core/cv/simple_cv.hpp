@@ -207,6 +207,20 @@ class SimpleCV
   template<typename... MLAlgorithmArgs>
   double Evaluate(const MLAlgorithmArgs&... args);
 
+  /**
+   * Train and evaluate as Evaluate() does, but store the trained model in the
+   * given pointer rather than in this object.  This object is not modified, so
+   * several calls can run at once in different threads, for instance to
+   * evaluate several sets of hyperparameters at the same time.
+   *
+   * @param model Pointer to store the trained model into.
+   * @param args Arguments for the given MLAlgorithm taken by its constructor
+   *     (in addition to the passed ones in the SimpleCV constructor).
+   */
+  template<typename... MLAlgorithmArgs>
+  double EvaluateModel(std::unique_ptr<MLAlgorithm>& model,
+                       const MLAlgorithmArgs&... args);
+
   //! Access and modify the last trained model.
   MLAlgorithm& Model();
 
@@ -285,21 +299,25 @@ class SimpleCV
                                    const size_t lastCol);
 
   /**
-   * Train and run evaluation in the case of non-weighted learning.
+   * Train and run evaluation in the case of non-weighted learning, storing the
+   * trained model in the given pointer.
    */
   template<typename... MLAlgorithmArgs,
            bool Enabled = !Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type>
-  double TrainAndEvaluate(const MLAlgorithmArgs&... args);
+  double TrainAndEvaluate(std::unique_ptr<MLAlgorithm>& model,
+                          const MLAlgorithmArgs&... args);
 
   /**
-   * Train and run evaluation in the case of supporting weighted learning.
+   * Train and run evaluation in the case of supporting weighted learning,
+   * storing the trained model in the given pointer.
    */
   template<typename... MLAlgorithmArgs,
            bool Enabled = Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type,
            typename = void>
-  double TrainAndEvaluate(const MLAlgorithmArgs&... args);
+  double TrainAndEvaluate(std::unique_ptr<MLAlgorithm>& model,
+                          const MLAlgorithmArgs&... args);
 };
 
 } // namespace mlpack
@@ -193,7 +193,24 @@ double SimpleCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
 {
-  return TrainAndEvaluate(args...);
+  return TrainAndEvaluate(modelPtr, args...);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+double SimpleCV<MLAlgorithm,
+                Metric,
+                MatType,
+                PredictionsType,
+                WeightsType>::EvaluateModel(
+    std::unique_ptr<MLAlgorithm>& model,
+    const MLAlgorithmArgs&... args)
+{
+  return TrainAndEvaluate(model, args...);
 }
 
 template<typename MLAlgorithm,
@@ -290,11 +307,13 @@ double SimpleCV<MLAlgorithm,
                 Metric,
                 MatType,
                 PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+                WeightsType>::TrainAndEvaluate(
+    std::unique_ptr<MLAlgorithm>& model,
+    const MLAlgorithmArgs&... args)
 {
-  modelPtr.reset(new MLAlgorithm(base.Train(trainingXs, trainingYs, args...)));
+  model.reset(new MLAlgorithm(base.Train(trainingXs, trainingYs, args...)));
 
-  return Metric::Evaluate(*modelPtr, validationXs, validationYs);
+  return Metric::Evaluate(*model, validationXs, validationYs);
 }
 
 template<typename MLAlgorithm,
@@ -307,16 +326,18 @@ double SimpleCV<MLAlgorithm,
                 Metric,
                 MatType,
                 PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+                WeightsType>::TrainAndEvaluate(
+    std::unique_ptr<MLAlgorithm>& model,
+    const MLAlgorithmArgs&... args)
 {
   if (trainingWeights.n_elem > 0)
-    modelPtr.reset(new MLAlgorithm(
+    model.reset(new MLAlgorithm(
         base.Train(trainingXs, trainingYs, trainingWeights, args...)));
   else
-    modelPtr.reset(new MLAlgorithm(
+    model.reset(new MLAlgorithm(
         base.Train(trainingXs, trainingYs, args...)));
 
-  return Metric::Evaluate(*modelPtr, validationXs, validationYs);
+  return Metric::Evaluate(*model, validationXs, validationYs);
 }
 
 } // namespace mlpack
@@ -0,0 +1,353 @@
+/**
+ * @file core/data/chunked_loader.hpp
+ *
+ * A loader that reads a numeric text dataset from disk a fixed number of points
+ * at a time, so that datasets larger than memory can be processed in chunks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHUNKED_LOADER_HPP
+#define MLPACK_CORE_DATA_CHUNKED_LOADER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "dataset_mapper.hpp"
+#include "extension.hpp"
+#include "load_numeric_csv.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A ChunkedLoader reads a numeric dataset from a text file in chunks of at
+ * most a given number of points, instead of loading the whole dataset into
+ * memory like data::Load().  As with data::Load(), each line of the file is a
+ * point, and each chunk is returned transposed, with one point per column.
+ *
+ * The supported types of files are:
+ *
+ *  - CSV, denoted by .csv; a header row is skipped if it is detected (that is,
+ *    if any token of the first row is not a number)
+ *  - TSV, denoted by .tsv
+ *  - whitespace-separated ASCII, denoted by .txt
+ *
+ * Empty lines are skipped.  Every point must have the same number of
+ * dimensions as the first point in the file; a std::runtime_error is thrown
+ * otherwise, or if the file cannot be opened or contains a token that is not a
+ * number.
+ *
+ * If a DatasetInfo is given, the dataset may also hold categorical dimensions,
+ * as with the data::Load() overload that takes a DatasetInfo: no header row is
+ * skipped, and every dimension with a token that is not a number is
+ * categorical.  To map the tokens in the same way in every chunk, the whole
+ * file is read twice when the loader is created; the first pass finds the
+ * categorical dimensions, and the second maps all of their tokens, in the
+ * order they appear.  So the DatasetInfo is complete before the first chunk is
+ * read, and is not modified by Next().
+ *
+ * The dataset can be read several times, by calling Reset() after each pass:
+ *
+ * @code
+ * data::ChunkedLoader loader("dataset.csv", 100000);
+ * arma::mat chunk;
+ * for (size_t pass = 0; pass < 10; ++pass)
+ * {
+ *   loader.Reset();
+ *   while (loader.Next(chunk))
+ *   {
+ *     // Process chunk, which has at most 100000 columns.
+ *   }
+ * }
+ * @endcode
+ */
+class ChunkedLoader
+{
+ public:
+  /**
+   * Open the given file for chunked loading.  The first point is read to find
+   * the dimensionality of the dataset.
+   *
+   * @param filename Name of the file to load.
+   * @param chunkSize Maximum number of points in each chunk.
+   */
+  ChunkedLoader(const std::string& filename, const size_t chunkSize) :
+      ChunkedLoader(filename, chunkSize, nullptr)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Open the given file for chunked loading of a dataset that may have
+   * categorical dimensions.  The file is read twice to fill the given
+   * DatasetInfo with the type of each dimension and the mappings of the tokens
+   * of the categorical dimensions; the DatasetInfo must outlive the loader.
+   *
+   * @param filename Name of the file to load.
+   * @param chunkSize Maximum number of points in each chunk.
+   * @param info DatasetInfo to fill with the types and mappings of the dataset.
+   */
+  ChunkedLoader(const std::string& filename,
+                const size_t chunkSize,
+                DatasetInfo& info) :
+      ChunkedLoader(filename, chunkSize, &info)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Read the next chunk of points from the file.  When the end of the file is
+   * reached, the chunk is empty and false is returned.
+   *
+   * @param chunk Matrix to load the next chunk into (one point per column).
+   * @return true if any points were read.
+   */
+  template<typename eT>
+  bool Next(arma::Mat<eT>& chunk)
+  {
+    chunk.set_size(dimensionality, chunkSize);
+
+    size_t count = 0;
+    std::vector<std::string> tokens;
+    while (count < chunkSize && NextPoint(tokens))
+    {
+      for (size_t i = 0; i < dimensionality; ++i)
+      {
+        if (info && info->Type(i) == Datatype::categorical)
+        {
+          // All the tokens were mapped when the loader was created.
+          chunk(i, count) = info->MapString<eT>(tokens[i], i);
+        }
+        else if (!parser.ConvertToken(chunk(i, count), tokens[i]))
+        {
+          std::ostringstream oss;
+          oss << "ChunkedLoader::Next(): cannot convert token '" << tokens[i]
+              << "' on line " << lineNumber << " of '" << filename << "'.";
+          throw std::runtime_error(oss.str());
+        }
+      }
+
+      ++count;
+    }
+
+    if (count < chunkSize)
+      chunk.resize(dimensionality, count);
+
+    pointsRead += count;
+    return (count > 0);
+  }
+
+  //! Go back to the first point of the file, to start a new pass.
+  void Reset()
+  {
+    stream.clear();
+    stream.seekg(dataStart);
+    pointsRead = 0;
+    lineNumber = 0;
+  }
+
+  //! Get the number of dimensions of each point.
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Get the maximum number of points in each chunk.
+  size_t ChunkSize() const { return chunkSize; }
+
+  //! Get the number of points read since the last call to Reset().
+  size_t PointsRead() const { return pointsRead; }
+
+  //! Get the name of the file being loaded.
+  const std::string& Filename() const { return filename; }
+
+  //! Get the DatasetInfo of the dataset, or nullptr if none was given.
+  const DatasetInfo* Info() const { return info; }
+
+ private:
+  //! Open the given file; if info is not nullptr, fill it with the types and
+  //! mappings of the dataset.
+  ChunkedLoader(const std::string& filename,
+                const size_t chunkSize,
+                DatasetInfo* info) :
+      filename(filename),
+      info(info),
+      chunkSize(chunkSize),
+      dimensionality(0),
+      pointsRead(0)
+  {
+    if (chunkSize == 0)
+    {
+      throw std::invalid_argument("ChunkedLoader::ChunkedLoader(): chunk size "
+          "must be positive!");
+    }
+
+    const std::string extension = Extension(filename);
+    if (extension == "csv")
+      delim = ',';
+    else if (extension == "tsv")
+      delim = '\t';
+    else if (extension == "txt")
+      delim = ' ';
+    else
+    {
+      throw std::runtime_error("ChunkedLoader::ChunkedLoader(): cannot load '" +
+          filename + "' in chunks; only .csv, .tsv, and .txt files are "
+          "supported.");
+    }
+
+    stream.open(filename, std::ios::in);
+    if (!stream.is_open())
+    {
+      throw std::runtime_error("ChunkedLoader::ChunkedLoader(): cannot open '"
+          + filename + "'.");
+    }
+
+    // Find the first non-empty line, and check whether it is a header.
+    std::string line;
+    std::vector<std::string> tokens;
+    dataStart = stream.tellg();
+    while (std::getline(stream, line))
+    {
+      Split(line, tokens);
+      if (!tokens.empty())
+        break;
+      dataStart = stream.tellg();
+    }
+
+    if (tokens.empty())
+    {
+      throw std::runtime_error("ChunkedLoader::ChunkedLoader(): '" + filename +
+          "' contains no points.");
+    }
+
+    // With categorical dimensions, the first row is always a point.
+    double value;
+    bool header = false;
+    for (size_t i = 0; i < tokens.size() && !info; ++i)
+      if (!parser.ConvertToken(value, tokens[i]))
+        header = true;
+
+    if (header && delim != ',')
+    {
+      throw std::runtime_error("ChunkedLoader::ChunkedLoader(): '" + filename +
+          "' contains a token that is not a number in its first row.");
+    }
+    else if (header)
+    {
+      // Skip the header.
+      dataStart = stream.tellg();
+    }
+
+    dimensionality = tokens.size();
+    Reset();
+
+    if (info)
+    {
+      // The first pass finds the categorical dimensions, and the second maps
+      // their tokens.
+      *info = DatasetInfo(dimensionality);
+      for (size_t pass = 0; pass < 2; ++pass)
+      {
+        while (NextPoint(tokens))
+        {
+          for (size_t i = 0; i < dimensionality; ++i)
+          {
+            if (pass == 0)
+              info->MapFirstPass<double>(tokens[i], i);
+            else if (info->Type(i) == Datatype::categorical)
+              info->MapString<double>(tokens[i], i);
+          }
+        }
+
+        Reset();
+      }
+    }
+  }
+
+  //! Read the tokens of the next non-empty line of the file into tokens.
+  //! Returns false at the end of the file.
+  bool NextPoint(std::vector<std::string>& tokens)
+  {
+    std::string line;
+    while (std::getline(stream, line))
+    {
+      ++lineNumber;
+      Split(line, tokens);
+      if (tokens.empty())
+        continue;
+
+      if (tokens.size() != dimensionality)
+      {
+        std::ostringstream oss;
+        oss << "ChunkedLoader::Next(): line " << lineNumber << " of '"
+            << filename << "' has " << tokens.size() << " values, but "
+            << dimensionality << " were expected.";
+        throw std::runtime_error(oss.str());
+      }
+
+      return true;
+    }
+
+    return false;
+  }
+
+  //! Split a line into tokens.  Lines of .txt files are split on any
+  //! whitespace; tokens of other files are trimmed.
+  void Split(const std::string& line, std::vector<std::string>& tokens) const
+  {
+    tokens.clear();
+    if (delim == ' ')
+    {
+      std::istringstream lineStream(line);
+      std::string token;
+      while (lineStream >> token)
+        tokens.push_back(token);
+    }
+    else
+    {
+      if (line.find_first_not_of(" \t\r") == std::string::npos)
+        return;
+
+      std::istringstream lineStream(line);
+      std::string token;
+      while (std::getline(lineStream, token, delim))
+      {
+        const size_t first = token.find_first_not_of(" \t\r");
+        const size_t last = token.find_last_not_of(" \t\r");
+        tokens.push_back((first == std::string::npos) ? std::string() :
+            token.substr(first, last - first + 1));
+      }
+
+      // A trailing delimiter gives one more empty token.
+      if (!line.empty() && line.back() == delim)
+        tokens.push_back("");
+    }
+  }
+
+  //! The name of the file being loaded.
+  std::string filename;
+  //! The file being loaded.
+  std::ifstream stream;
+  //! The position of the first point in the file.
+  std::streampos dataStart;
+  //! The delimiter between tokens (' ' means any whitespace).
+  char delim;
+  //! Used to convert tokens to numbers.
+  LoadCSV parser;
+  //! The types and mappings of the dataset, if it may be categorical.
+  DatasetInfo* info;
+
+  //! The maximum number of points in each chunk.
+  size_t chunkSize;
+  //! The number of dimensions of each point.
+  size_t dimensionality;
+  //! The number of points read since the last call to Reset().
+  size_t pointsRead;
+  //! The number of lines read since the last call to Reset() (for errors).
+  size_t lineNumber;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
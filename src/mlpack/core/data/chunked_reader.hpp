@@ -0,0 +1,408 @@
+/**
+ * @file core/data/chunked_reader.hpp
+ *
+ * A reader that gives the points of a text, binary, or memory-mapped dataset
+ * file in chunks, optionally reading the next chunk on a background thread, so
+ * that streaming algorithms can process datasets larger than memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHUNKED_READER_HPP
+#define MLPACK_CORE_DATA_CHUNKED_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <future>
+
+#include "chunked_loader.hpp"
+#include "dataset_mapper.hpp"
+#include "extension.hpp"
+#include "mapped_file.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A ChunkedReader gives the points of a dataset file in chunks of at most a
+ * given number of points, one point per column, with the same Next(), Reset()
+ * and Dimensionality() methods as ChunkedLoader; so it can be given to any
+ * algorithm that reads a dataset in chunks, such as StreamingKMeans,
+ * IncrementalSVDPolicy, LinearRegressionStatistics, or
+ * HoeffdingTree::TrainChunks().  The supported types of files are:
+ *
+ *  - text files (.csv, .tsv and .txt), read as with ChunkedLoader
+ *  - Armadillo binary files (as saved by data::Save() with one point per
+ *    column, so that the file holds one point per row)
+ *  - matrices saved with data::SaveMapped() (one point per column)
+ *
+ * Binary files are detected from their contents, and mapped into memory
+ * read-only, so that only the pages of the current chunk need to be in memory;
+ * their elements are converted to the element type of MatType.
+ *
+ * The Info() of the reader gives the type of each dimension.  If `categorical`
+ * is true, text files may have categorical dimensions; all of their tokens are
+ * mapped when the reader is created, so that they are mapped in the same way
+ * in every chunk (see ChunkedLoader).  Every dimension of a binary file is
+ * numeric.
+ *
+ * If `prefetch` is true, the next chunk is read on a background thread while
+ * the current one is being used.  If reading a chunk fails, the exception is
+ * thrown by the call to Next() that would have returned it.
+ *
+ * @code
+ * data::ChunkedReader<> reader("dataset.bin", 100000, true);
+ * arma::mat chunk;
+ * for (size_t pass = 0; pass < 10; ++pass)
+ * {
+ *   reader.Reset();
+ *   while (reader.Next(chunk))
+ *   {
+ *     // Process chunk, which has at most 100000 columns.
+ *   }
+ * }
+ * @endcode
+ *
+ * @tparam MatType Type of the matrix that chunks are read into.
+ */
+template<typename MatType = arma::mat>
+class ChunkedReader
+{
+ public:
+  //! The element type of the chunks that are read.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Open the given file for chunked reading.  A std::runtime_error is thrown
+   * if the file cannot be opened or is not of a supported type.
+   *
+   * @param filename Name of the file to read.
+   * @param chunkSize Maximum number of points in each chunk.
+   * @param prefetch If true, read the next chunk on a background thread.
+   * @param categorical If true, text files may have categorical dimensions.
+   */
+  ChunkedReader(const std::string& filename,
+                const size_t chunkSize,
+                const bool prefetch = false,
+                const bool categorical = false) :
+      filename(filename),
+      chunkSize(chunkSize),
+      prefetch(prefetch),
+      elements(nullptr),
+      elemKind(0),
+      elemSize(0),
+      dimensionality(0),
+      numPoints(0),
+      pointsAreRows(false),
+      nextPoint(0),
+      pointsRead(0)
+  {
+    if (chunkSize == 0)
+    {
+      throw std::invalid_argument("ChunkedReader::ChunkedReader(): chunk size "
+          "must be positive!");
+    }
+
+    const std::string extension = Extension(filename);
+    if (extension == "csv" || extension == "tsv" || extension == "txt")
+    {
+      if (categorical)
+        text.reset(new ChunkedLoader(filename, chunkSize, info));
+      else
+        text.reset(new ChunkedLoader(filename, chunkSize));
+
+      dimensionality = text->Dimensionality();
+      if (!categorical)
+        info = DatasetInfo(dimensionality);
+      return;
+    }
+
+    file.Open(filename, true);
+    if (!OpenMappedMatrix() && !OpenArmaBinary())
+    {
+      throw std::runtime_error("ChunkedReader::ChunkedReader(): cannot read '"
+          + filename + "' in chunks; only text files, Armadillo binary files, "
+          "and matrices saved with data::SaveMapped() are supported.");
+    }
+
+    info = DatasetInfo(dimensionality);
+  }
+
+  //! Wait for the chunk being read in the background, if any.
+  ~ChunkedReader()
+  {
+    if (pending.valid())
+      pending.wait();
+  }
+
+  // The background thread points at the reader, so it cannot be copied or
+  // moved.
+  ChunkedReader(const ChunkedReader&) = delete;
+  ChunkedReader& operator=(const ChunkedReader&) = delete;
+
+  /**
+   * Get the next chunk of points.  When every point has been read since the
+   * last call to Reset(), the chunk is empty and false is returned.
+   *
+   * @param chunk Matrix to store the next chunk in (one point per column).
+   * @return true if any points were read.
+   */
+  template<typename eT>
+  bool Next(arma::Mat<eT>& chunk)
+  {
+    MatType next;
+    bool read;
+    if (prefetch)
+    {
+      if (!pending.valid())
+        StartRead();
+
+      // This rethrows any exception thrown while reading the chunk.
+      read = pending.get();
+      next = std::move(buffer);
+      if (read)
+        StartRead();
+    }
+    else
+    {
+      read = Read(next);
+    }
+
+    if (!read)
+    {
+      chunk.set_size(dimensionality, 0);
+      return false;
+    }
+
+    Store(next, chunk);
+    pointsRead += chunk.n_cols;
+    return true;
+  }
+
+  /**
+   * Go back to the first point of the file, to start a new pass.  A chunk
+   * being read in the background is discarded.
+   */
+  void Reset()
+  {
+    if (pending.valid())
+    {
+      pending.wait();
+      pending = std::future<bool>();
+    }
+
+    if (text)
+      text->Reset();
+    nextPoint = 0;
+    pointsRead = 0;
+  }
+
+  //! Get the number of dimensions of each point.
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Get the maximum number of points in each chunk.
+  size_t ChunkSize() const { return chunkSize; }
+
+  //! Get the number of points read since the last call to Reset().
+  size_t PointsRead() const { return pointsRead; }
+
+  //! Get whether the next chunk is read on a background thread.
+  bool Prefetch() const { return prefetch; }
+
+  //! Get the type of each dimension, and the mappings of categorical ones.
+  const DatasetInfo& Info() const { return info; }
+
+  //! Get the name of the file being read.
+  const std::string& Filename() const { return filename; }
+
+ private:
+  //! Check whether the mapped file is a matrix saved with SaveMapped(), and if
+  //! so, describe its elements.
+  bool OpenMappedMatrix()
+  {
+    MappedMatrixHeader header;
+    if (file.Size() < MappedMatrixHeader::reservedSize)
+      return false;
+
+    std::memcpy(&header, file.Data(), sizeof(MappedMatrixHeader));
+    if (std::memcmp(header.magic, MappedMatrixHeader::Magic(),
+        sizeof(header.magic)) != 0 ||
+        header.version != MappedMatrixHeader::currentVersion)
+      return false;
+
+    return SetElements(header.dataOffset, (char) header.elemKind,
+        header.elemSize, header.nRows, header.nCols, false);
+  }
+
+  //! Check whether the mapped file is an Armadillo binary file, and if so,
+  //! describe its elements.  The file holds one point per row.
+  bool OpenArmaBinary()
+  {
+    // The header is "ARMA_MAT_BIN_<type>\n<rows> <cols>\n".
+    const std::string magic = "ARMA_MAT_BIN_";
+    if (file.Size() < magic.size())
+      return false;
+
+    const size_t headerSize = std::min(file.Size(), (size_t) 128);
+    const std::string header(file.Data(), headerSize);
+    if (header.compare(0, magic.size(), magic) != 0)
+      return false;
+
+    const size_t firstLine = header.find('\n');
+    const size_t secondLine = (firstLine == std::string::npos) ?
+        std::string::npos : header.find('\n', firstLine + 1);
+    if (secondLine == std::string::npos)
+      return false;
+
+    // The type is "FN", "IS" or "IU", then the size of the elements in bytes.
+    const std::string type = header.substr(magic.size(),
+        firstLine - magic.size());
+    std::istringstream shape(header.substr(firstLine + 1,
+        secondLine - firstLine - 1));
+    size_t rows, cols;
+    if (type.size() != 5 || !(shape >> rows >> cols))
+      return false;
+
+    const char kind = (type.compare(0, 2, "FN") == 0) ? 'f' :
+        (type.compare(0, 2, "IS") == 0) ? 'i' :
+        (type.compare(0, 2, "IU") == 0) ? 'u' : 0;
+    const size_t size = std::strtoul(type.c_str() + 2, NULL, 10);
+    return SetElements(secondLine + 1, kind, size, cols, rows, true);
+  }
+
+  //! Describe the elements of the mapped file, if they are of a supported
+  //! type and lie inside the file.
+  bool SetElements(const size_t offset,
+                   const char kind,
+                   const size_t size,
+                   const size_t dims,
+                   const size_t points,
+                   const bool rows)
+  {
+    const bool supported = (kind == 'f' && (size == 4 || size == 8)) ||
+        ((kind == 'i' || kind == 'u') &&
+        (size == 1 || size == 2 || size == 4 || size == 8));
+    if (!supported || offset > file.Size() ||
+        (points > 0 && dims > (file.Size() - offset) / size / points))
+      return false;
+
+    elements = file.Data() + offset;
+    elemKind = kind;
+    elemSize = size;
+    dimensionality = dims;
+    numPoints = points;
+    pointsAreRows = rows;
+    return true;
+  }
+
+  //! Read the next chunk from the file into the given matrix.
+  bool Read(MatType& chunk)
+  {
+    if (text)
+      return text->Next(chunk);
+
+    if (nextPoint >= numPoints)
+      return false;
+
+    const size_t count = std::min(chunkSize, numPoints - nextPoint);
+    chunk.set_size(dimensionality, count);
+    switch (elemKind == 'f' ? elemSize : elemKind == 'i' ? 10 + elemSize :
+        20 + elemSize)
+    {
+      case 4: CopyPoints<float>(chunk); break;
+      case 8: CopyPoints<double>(chunk); break;
+      case 11: CopyPoints<int8_t>(chunk); break;
+      case 12: CopyPoints<int16_t>(chunk); break;
+      case 14: CopyPoints<int32_t>(chunk); break;
+      case 18: CopyPoints<int64_t>(chunk); break;
+      case 21: CopyPoints<uint8_t>(chunk); break;
+      case 22: CopyPoints<uint16_t>(chunk); break;
+      case 24: CopyPoints<uint32_t>(chunk); break;
+      case 28: CopyPoints<uint64_t>(chunk); break;
+    }
+
+    nextPoint += count;
+    return true;
+  }
+
+  //! Convert the points of the chunk from the mapped elements of type T.
+  template<typename T>
+  void CopyPoints(MatType& chunk) const
+  {
+    // The elements may not be aligned (in Armadillo binary files), so they are
+    // copied one at a time.
+    T value;
+    for (size_t j = 0; j < (size_t) chunk.n_cols; ++j)
+    {
+      for (size_t d = 0; d < dimensionality; ++d)
+      {
+        const size_t index = pointsAreRows ?
+            d * numPoints + nextPoint + j :
+            (nextPoint + j) * dimensionality + d;
+        std::memcpy(&value, elements + index * sizeof(T), sizeof(T));
+        chunk(d, j) = (ElemType) value;
+      }
+    }
+  }
+
+  //! Start reading the next chunk into the buffer on a background thread.
+  void StartRead()
+  {
+    pending = std::async(std::launch::async,
+        [this]() { return Read(buffer); });
+  }
+
+  //! Give a chunk read with the element type of MatType.
+  static void Store(MatType& from, MatType& to) { to = std::move(from); }
+
+  //! Give a chunk read with another element type.
+  template<typename OutMatType>
+  static void Store(const MatType& from, OutMatType& to)
+  {
+    to = ConvTo<OutMatType>::From(from);
+  }
+
+  //! The name of the file being read.
+  std::string filename;
+  //! The maximum number of points in each chunk.
+  size_t chunkSize;
+  //! If true, the next chunk is read on a background thread.
+  bool prefetch;
+  //! The type of each dimension of the dataset.
+  DatasetInfo info;
+
+  //! The loader of text files.
+  std::unique_ptr<ChunkedLoader> text;
+  //! The mapping of binary files.
+  MappedFile file;
+  //! The first element of binary files.
+  const char* elements;
+  //! The kind of the elements of binary files ('f', 'i' or 'u').
+  char elemKind;
+  //! The size of the elements of binary files, in bytes.
+  size_t elemSize;
+
+  //! The number of dimensions of each point.
+  size_t dimensionality;
+  //! The number of points of binary files.
+  size_t numPoints;
+  //! If true, binary files hold one point per row.
+  bool pointsAreRows;
+  //! The next point of binary files to read.
+  size_t nextPoint;
+  //! The number of points given by Next() since the last call to Reset().
+  size_t pointsRead;
+
+  //! The chunk read in the background.
+  MatType buffer;
+  //! The result of reading the chunk in the background.  It is declared last,
+  //! so that the background thread is finished before the rest is destroyed.
+  std::future<bool> pending;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -28,13 +28,21 @@
 
 #include "binarize.hpp"
 #include "check_categorical_param.hpp"
+#include "chunked_loader.hpp"
+#include "chunked_reader.hpp"
 #include "confusion_matrix.hpp"
 #include "dataset_mapper.hpp"
+#include "image_chunk_loader.hpp"
 #include "image_info.hpp"
 #include "imputer.hpp"
 #include "is_naninf.hpp"
+#include "mapped_file.hpp"
+#include "matrix_chunk_loader.hpp"
 #include "normalize_labels.hpp"
 #include "one_hot_encoding.hpp"
+#include "pack_binary.hpp"
+#include "prefetching_loader.hpp"
+#include "sectioned_model.hpp"
 #include "split_data.hpp"
 #include "string_algorithms.hpp"
 #include "types.hpp"
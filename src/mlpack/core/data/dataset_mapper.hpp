@@ -73,6 +73,21 @@ class DatasetMapper
   template<typename T>
   void MapFirstPass(const InputType& input, const size_t dimension);
 
+  /**
+   * Call mapDimension(d) for every dimension d, where mapDimension maps the
+   * inputs of dimension d only, with MapFirstPass() and MapString().  If the
+   * policy maps each dimension independently of the others (that is, if
+   * PolicyType::IndependentDimensions is true, as for IncrementPolicy and
+   * MissingPolicy), the dimensions are mapped in parallel with OpenMP;
+   * otherwise they are mapped serially, in order.  The mappings of each
+   * dimension are the same either way.  If mapDimension throws an exception,
+   * it is thrown again once the other dimensions are mapped.
+   *
+   * @param mapDimension Function to call for each dimension.
+   */
+  template<typename FunctionType>
+  void MapDimensions(FunctionType&& mapDimension);
+
   /**
    * Given the input and the dimension to which it belongs, return its numeric
    * mapping.  If no mapping yet exists, the input is added to the list of
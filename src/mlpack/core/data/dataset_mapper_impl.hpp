@@ -15,6 +15,9 @@
 
 // In case it hasn't already been included.
 #include "dataset_mapper.hpp"
+#include <mlpack/core/util/executor.hpp>
+
+#include <exception>
 
 namespace mlpack {
 namespace data {
@@ -78,6 +81,79 @@ void DatasetMapper<PolicyType, InputType>::MapFirstPass(const InputType& input,
   CallMapFirstPass<PolicyType, InputType, T>(policy, input, dimension, types);
 }
 
+/**
+ * HasIndependentDimensions<PolicyType>::value is true if the policy has a
+ * static IndependentDimensions member that is true.
+ */
+template<typename PolicyType, typename = void>
+struct HasIndependentDimensions : std::false_type { };
+
+template<typename PolicyType>
+struct HasIndependentDimensions<PolicyType,
+    typename std::enable_if<PolicyType::IndependentDimensions>::type> :
+    std::true_type { };
+
+// Utility helper function to map the dimensions in parallel.
+template<typename MapType, typename FunctionType>
+void CallMapDimensions(
+    MapType& maps,
+    const size_t dimensionality,
+    FunctionType& mapDimension,
+    const std::true_type& /* independentDimensions */)
+{
+  // Create the maps of all dimensions first, so that the policy only modifies
+  // the map of its own dimension while the dimensions are mapped in parallel.
+  for (size_t d = 0; d < dimensionality; ++d)
+    maps[d];
+
+  std::exception_ptr error;
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t d = 0; d < dimensionality; ++d)
+  {
+    try
+    {
+      mapDimension(d);
+    }
+    catch (...)
+    {
+      #pragma omp critical
+      {
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+  }
+
+  // Map entries only exist for categorical dimensions.
+  for (size_t d = 0; d < dimensionality; ++d)
+    if (maps[d].first.empty())
+      maps.erase(d);
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+// Utility helper function to map the dimensions serially.
+template<typename MapType, typename FunctionType>
+void CallMapDimensions(
+    MapType& /* maps */,
+    const size_t dimensionality,
+    FunctionType& mapDimension,
+    const std::false_type& /* independentDimensions */)
+{
+  for (size_t d = 0; d < dimensionality; ++d)
+    mapDimension(d);
+}
+
+template<typename PolicyType, typename InputType>
+template<typename FunctionType>
+void DatasetMapper<PolicyType, InputType>::MapDimensions(
+    FunctionType&& mapDimension)
+{
+  CallMapDimensions(maps, types.size(), mapDimension,
+      HasIndependentDimensions<PolicyType>());
+}
+
 // When we want to insert value into the map, we use the policy to map the
 // input.
 template<typename PolicyType, typename InputType>
@@ -0,0 +1,157 @@
+/**
+ * @file core/data/image_chunk_loader.hpp
+ *
+ * A loader that gives the images of a list of files in chunks, with the same
+ * interface as ChunkedLoader, so that collections of images that do not fit
+ * in memory can be streamed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_IMAGE_CHUNK_LOADER_HPP
+#define MLPACK_CORE_DATA_IMAGE_CHUNK_LOADER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "load_image.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * An ImageChunkLoader gives the images of a list of files in chunks of at most
+ * a given number of images, one image per column.  The images of each chunk
+ * are decoded in parallel, straight into the chunk (see data::Load() for
+ * multiple image files), and only one chunk is held in memory at a time.  It
+ * has the same Next(), Reset(), Dimensionality() and PointsRead() methods as
+ * ChunkedLoader, so it can be given to any algorithm that reads a dataset with
+ * a ChunkedLoader, such as StreamingKMeans.
+ *
+ * @code
+ * std::vector<std::string> files = ...;
+ * data::ImageInfo info(0, 0, 1); // Load grayscale images.
+ * data::ImageChunkLoader loader(files, 256, info);
+ * arma::mat chunk;
+ * while (loader.Next(chunk))
+ * {
+ *   // Process chunk, which has at most 256 images.
+ * }
+ * @endcode
+ *
+ * All the images must have the same size.  A std::runtime_error is thrown if
+ * an image cannot be loaded.
+ */
+class ImageChunkLoader
+{
+ public:
+  /**
+   * Create a loader for the images of the given files.  The first image is
+   * decoded to find the size of the images.
+   *
+   * @param files Names of the image files.
+   * @param chunkSize Maximum number of images in each chunk.
+   * @param info Information used to load the images (e.g. the number of
+   *     channels to load); its size is set from the first image.
+   */
+  ImageChunkLoader(const std::vector<std::string>& files,
+                   const size_t chunkSize,
+                   const ImageInfo& info = ImageInfo()) :
+      files(files),
+      chunkSize(chunkSize),
+      info(info),
+      pointsRead(0)
+  {
+    if (chunkSize == 0)
+    {
+      throw std::invalid_argument("ImageChunkLoader::ImageChunkLoader(): "
+          "chunk size must be positive!");
+    }
+
+    if (files.empty())
+    {
+      throw std::invalid_argument("ImageChunkLoader::ImageChunkLoader(): "
+          "no image files given!");
+    }
+
+    std::string error;
+    unsigned char* image = DecodeImage(files[0], this->info, error);
+    if (!image)
+    {
+      throw std::runtime_error("ImageChunkLoader::ImageChunkLoader(): " +
+          error);
+    }
+    FreeImage(image);
+  }
+
+  /**
+   * Load the next chunk of images, one image per column.  Returns false when
+   * every image has been read since the last call to Reset().
+   *
+   * @param chunk Matrix to load the next chunk into.
+   * @return Whether a chunk was read.
+   */
+  template<typename eT>
+  bool Next(arma::Mat<eT>& chunk)
+  {
+    if (pointsRead >= files.size())
+      return false;
+
+    const size_t end = std::min(pointsRead + chunkSize, files.size());
+    const std::vector<std::string> chunkFiles(files.begin() + pointsRead,
+        files.begin() + end);
+
+    ImageInfo chunkInfo(info);
+    if (!Load(chunkFiles, chunk, chunkInfo, true))
+    {
+      throw std::runtime_error("ImageChunkLoader::Next(): cannot load images "
+          "from '" + chunkFiles[0] + "'!");
+    }
+
+    if (chunk.n_rows != Dimensionality())
+    {
+      std::ostringstream oss;
+      oss << "ImageChunkLoader::Next(): image '" << chunkFiles[0] << "' has "
+          << chunk.n_rows << " values, but the first image has "
+          << Dimensionality() << " values!";
+      throw std::runtime_error(oss.str());
+    }
+
+    pointsRead = end;
+    return true;
+  }
+
+  //! Restart reading from the first image.
+  void Reset() { pointsRead = 0; }
+
+  //! Get the dimensionality of the points (the number of values of an image).
+  size_t Dimensionality() const
+  {
+    return info.Width() * info.Height() * info.Channels();
+  }
+
+  //! Get the size of the images.
+  const ImageInfo& Info() const { return info; }
+  //! Get the names of the image files.
+  const std::vector<std::string>& Files() const { return files; }
+  //! Get the maximum number of images in each chunk.
+  size_t ChunkSize() const { return chunkSize; }
+  //! Get the number of images read since the last call to Reset().
+  size_t PointsRead() const { return pointsRead; }
+
+ private:
+  //! Names of the image files.
+  std::vector<std::string> files;
+  //! Maximum number of images in each chunk.
+  size_t chunkSize;
+  //! Size of the images.
+  ImageInfo info;
+  //! Number of images read since the last call to Reset().
+  size_t pointsRead;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
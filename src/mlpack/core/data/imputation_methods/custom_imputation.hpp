@@ -30,6 +30,10 @@ class CustomImputation
     // nothing to initialize here
   }
 
+  //! Each dimension is imputed independently of the other dimensions, so
+  //! different dimensions can be imputed in parallel.
+  static const bool IndependentDimensions = true;
+
   /**
    * Impute function searches through the input looking for mappedValue and
    * replaces it with the user-defined custom value of the given dimension.
@@ -24,10 +24,15 @@ template <typename T>
 class MeanImputation
 {
  public:
+  //! Each dimension is imputed independently of the other dimensions, so
+  //! different dimensions can be imputed in parallel.
+  static const bool IndependentDimensions = true;
+
   /**
    * Impute function searches through the input looking for mappedValue and
    * replaces it with the mean of the given dimension. The result is overwritten
-   * to the input matrix.
+   * to the input matrix.  The dimension is read only once; only the missing
+   * elements are visited again.
    *
    * @param input Matrix that contains mappedValue.
    * @param mappedValue Value that the user wants to get rid of.
@@ -42,43 +47,29 @@ class MeanImputation
     double sum = 0;
     size_t elems = 0; // excluding nan or missing target
 
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
+    // The elements of the dimension are elements[0], elements[stride], and so
+    // on.
+    T* elements = columnMajor ? input.memptr() + dimension :
+        input.colptr(dimension);
+    const size_t stride = columnMajor ? input.n_rows : 1;
+    const size_t numElements = columnMajor ? input.n_cols : input.n_rows;
 
+    // offsets of the missing elements are saved inside this vector.
+    std::vector<size_t> targets;
 
     // calculate number of elements and sum of them excluding mapped value or
     // nan. while doing that, remember where mappedValue or NaN exists.
-    if (columnMajor)
+    for (size_t i = 0; i < numElements; ++i)
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
+      const T& element = elements[i * stride];
+      if (element == mappedValue || std::isnan(element))
       {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          targets.emplace_back(dimension, i);
-        }
-        else
-        {
-          elems++;
-          sum += input(dimension, i);
-        }
+        targets.push_back(i * stride);
       }
-    }
-    else
-    {
-      for (size_t i = 0; i < input.n_rows; ++i)
+      else
       {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          targets.emplace_back(i, dimension);
-        }
-        else
-        {
-          elems++;
-          sum += input(i, dimension);
-        }
+        elems++;
+        sum += element;
       }
     }
 
@@ -91,10 +82,8 @@ class MeanImputation
 
     // Now replace the calculated mean to the missing variables
     // It only needs to loop through targets vector, not the whole matrix.
-    for (const PairType& target : targets)
-    {
-      input(target.first, target.second) = mean;
-    }
+    for (const size_t target : targets)
+      elements[target] = mean;
   }
 }; // class MeanImputation
 
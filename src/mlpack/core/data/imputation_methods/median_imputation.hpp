@@ -25,10 +25,16 @@ template <typename T>
 class MedianImputation
 {
  public:
+  //! Each dimension is imputed independently of the other dimensions, so
+  //! different dimensions can be imputed in parallel.
+  static const bool IndependentDimensions = true;
+
   /**
    * Impute function searches through the input looking for mappedValue and
    * replaces it with the median of the given dimension. The result is
-   * overwritten to the input matrix.
+   * overwritten to the input matrix.  The dimension is read only once, and the
+   * median is selected with std::nth_element(), so the good elements are not
+   * sorted.
    *
    * @param input Matrix that contains mappedValue.
    * @param mappedValue Value that the user wants to get rid of.
@@ -40,50 +46,52 @@ class MedianImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
+    // The elements of the dimension are elements[0], elements[stride], and so
+    // on.
+    T* elements = columnMajor ? input.memptr() + dimension :
+        input.colptr(dimension);
+    const size_t stride = columnMajor ? input.n_rows : 1;
+    const size_t numElements = columnMajor ? input.n_cols : input.n_rows;
+
+    // offsets of the missing elements are saved inside this vector.
+    std::vector<size_t> targets;
     // good elements are kept inside this vector.
     std::vector<double> elemsToKeep;
+    elemsToKeep.reserve(numElements);
 
-    if (columnMajor)
+    for (size_t i = 0; i < numElements; ++i)
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          targets.emplace_back(dimension, i);
-        }
-        else
-        {
-          elemsToKeep.push_back(input(dimension, i));
-        }
-      }
+      const T& element = elements[i * stride];
+      if (element == mappedValue || std::isnan(element))
+        targets.push_back(i * stride);
+      else
+        elemsToKeep.push_back(element);
     }
-    else
+
+    if (targets.empty())
+      return;
+
+    if (elemsToKeep.empty())
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
-      {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          targets.emplace_back(i, dimension);
-        }
-        else
-        {
-           elemsToKeep.push_back(input(i, dimension));
-        }
-      }
+      throw std::logic_error("MedianImputation::Impute(): it is impossible to "
+          "calculate median; no valid elements in the dimension!");
     }
 
-    // calculate median
-    const double median = arma::median(arma::vec(elemsToKeep));
-
-    for (const PairType& target : targets)
+    // calculate median; for an even number of elements, it is the average of
+    // the two middle elements, which are the largest element of the lower half
+    // after selection and the selected element.
+    const size_t middle = elemsToKeep.size() / 2;
+    std::nth_element(elemsToKeep.begin(), elemsToKeep.begin() + middle,
+        elemsToKeep.end());
+    double median = elemsToKeep[middle];
+    if (elemsToKeep.size() % 2 == 0)
     {
-       input(target.first, target.second) = median;
+      median = (median + *std::max_element(elemsToKeep.begin(),
+          elemsToKeep.begin() + middle)) / 2.0;
     }
+
+    for (const size_t target : targets)
+      elements[target] = median;
   }
 }; // class MedianImputation
 
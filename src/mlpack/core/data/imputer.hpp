@@ -17,6 +17,9 @@
 #include "dataset_mapper.hpp"
 #include "map_policies/missing_policy.hpp"
 #include "map_policies/increment_policy.hpp"
+#include <mlpack/core/util/executor.hpp>
+
+#include <exception>
 
 namespace mlpack {
 namespace data {
@@ -65,6 +68,33 @@ class Imputer
     strategy.Impute(input, mappedValue, dimension, columnMajor);
   }
 
+  /**
+   * Given an input dataset, replace missing values of each of the given
+   * dimensions with the imputation strategy, overwriting the input matrix.  If
+   * the strategy imputes each dimension independently of the other dimensions
+   * (StrategyType::IndependentDimensions is true, as for MeanImputation,
+   * MedianImputation and CustomImputation), the dimensions are imputed in
+   * parallel with OpenMP; otherwise (e.g. for ListwiseDeletion, which removes
+   * points) they are imputed one after another.
+   *
+   * @param input Input dataset to apply imputation.
+   * @param missingValue User defined missing value; it can be anything.
+   * @param dimensions Dimensions to apply the imputation.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::string& missingValue,
+              const std::vector<size_t>& dimensions)
+  {
+    // Each dimension must only be imputed once, even in parallel.
+    std::vector<size_t> uniqueDimensions(dimensions);
+    std::sort(uniqueDimensions.begin(), uniqueDimensions.end());
+    uniqueDimensions.erase(std::unique(uniqueDimensions.begin(),
+        uniqueDimensions.end()), uniqueDimensions.end());
+
+    ImputeDimensions(input, missingValue, uniqueDimensions,
+        HasIndependentDimensions<StrategyType>());
+  }
+
   //! Get the strategy.
   const StrategyType& Strategy() const { return strategy; }
 
@@ -78,6 +108,52 @@ class Imputer
   MapperType& Mapper() { return mapper; }
 
  private:
+  //! Impute the given dimensions one after another.
+  void ImputeDimensions(arma::Mat<T>& input,
+                        const std::string& missingValue,
+                        const std::vector<size_t>& dimensions,
+                        const std::false_type& /* independentDimensions */)
+  {
+    for (const size_t dimension : dimensions)
+      Impute(input, missingValue, dimension);
+  }
+
+  //! Impute the given dimensions in parallel.
+  void ImputeDimensions(arma::Mat<T>& input,
+                        const std::string& missingValue,
+                        const std::vector<size_t>& dimensions,
+                        const std::true_type& /* independentDimensions */)
+  {
+    // The mapper is not modified while the dimensions are imputed.
+    std::vector<T> mappedValues(dimensions.size());
+    for (size_t i = 0; i < dimensions.size(); ++i)
+    {
+      mappedValues[i] = static_cast<T>(mapper.UnmapValue(missingValue,
+          dimensions[i]));
+    }
+
+    std::exception_ptr error;
+    #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+    for (size_t i = 0; i < dimensions.size(); ++i)
+    {
+      try
+      {
+        strategy.Impute(input, mappedValues[i], dimensions[i], columnMajor);
+      }
+      catch (...)
+      {
+        #pragma omp critical
+        {
+          if (!error)
+            error = std::current_exception();
+        }
+      }
+    }
+
+    if (error)
+      std::rethrow_exception(error);
+  }
+
   // StrategyType
   StrategyType strategy;
 
@@ -23,7 +23,10 @@
 #include "image_info.hpp"
 #include "load_csv.hpp"
 #include "load_arff.hpp"
+#include "load_arrow.hpp"
 #include "load_image.hpp"
+#include "mapped_file.hpp"
+#include "chunked_loader.hpp"
 
 namespace mlpack {
 namespace data /** Functions to load and save matrices and models. */ {
@@ -45,6 +48,10 @@ namespace data /** Functions to load and save matrices and models. */ {
  *  - Armadillo binary (arma::arma_binary), denoted by .bin
  *  - HDF5 (arma::hdf5_binary), denoted by .hdf, .hdf5, .h5, or .he5
  *
+ * If mlpack was compiled with Arrow support (MLPACK_HAS_ARROW), Arrow IPC files
+ * (denoted by .arrow or .feather) and Parquet files (denoted by .parquet) can
+ * also be loaded, if all of their columns are numeric (see LoadArrow()).
+ *
  * By default, this function will try to automatically determine the type of
  * file to load based on its extension and by inspecting the file.  If you know
  * the file type and want to specify it manually, override the default
@@ -185,6 +192,10 @@ bool Load(const std::string& filename,
  * - CSV (csv_ascii), denoted by .csv, or optionally .txt
  * - TSV (raw_ascii), denoted by .tsv, .csv, or .txt
  * - ASCII (raw_ascii), denoted by .txt
+ * - ARFF, denoted by .arff
+ * - Arrow IPC, denoted by .arrow or .feather, and Parquet, denoted by .parquet,
+ *   if mlpack was compiled with Arrow support (MLPACK_HAS_ARROW); string
+ *   columns are categorical (see LoadArrow())
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -250,6 +261,58 @@ bool Load(const std::string& filename,
           const bool fatal = false,
           format f = format::autodetect);
 
+/**
+ * Load a model from a file saved with data::SaveMapped(), without copying its
+ * dense matrices: the file is mapped into memory with the given MappedFile, and
+ * the matrices of the loaded model (for instance the dataset of a tree) use the
+ * mapped memory directly.  Startup is therefore almost instantaneous even for
+ * very large models, and several processes that load the same file share the
+ * same physical memory.  The rest of the model (such as the nodes of a tree) is
+ * deserialized as usual.
+ *
+ * The MappedFile must outlive the loaded model; any file that it mapped before
+ * is unmapped once the new model has been loaded.  Writing to the matrices of
+ * the model only changes the copy of this process, never the file.
+ *
+ * The name parameter should be the same as the name that was used to save the
+ * structure (otherwise, the loading procedure will fail).
+ *
+ * If the parameter 'fatal' is set to true, then an exception will be thrown in
+ * the event of load failure.  Otherwise, the method will return false and the
+ * relevant error information will be printed to Log::Warn.
+ */
+template<typename T>
+bool LoadMapped(const std::string& filename,
+                const std::string& name,
+                T& t,
+                MappedFile& file,
+                const bool fatal = false);
+
+/**
+ * Load a matrix from a file saved with data::SaveMapped(), without copying its
+ * elements: the file is mapped into memory with the given MappedFile, and the
+ * matrix uses the mapped memory as auxiliary memory.  The mapping is
+ * copy-on-write, so several processes that load the same file share the same
+ * physical memory, and writing to the matrix only changes the copy of this
+ * process.  If readOnly is true, the pages can never be copied, and writing to
+ * the matrix crashes the process (on Windows, the file is read into memory
+ * instead).  If the matrix is resized, it gets its own memory again.
+ *
+ * The MappedFile must outlive the loaded matrix; any file that it mapped
+ * before is unmapped once the new matrix has been loaded.  The type of the
+ * elements of the matrix must be the type the matrix was saved with.
+ *
+ * If the parameter 'fatal' is set to true, then an exception will be thrown in
+ * the event of load failure.  Otherwise, the method will return false and the
+ * relevant error information will be printed to Log::Warn.
+ */
+template<typename eT>
+bool LoadMapped(const std::string& filename,
+                arma::Mat<eT>& matrix,
+                MappedFile& file,
+                const bool fatal = false,
+                const bool readOnly = false);
+
 } // namespace data
 } // namespace mlpack
 
@@ -259,5 +322,7 @@ bool Load(const std::string& filename,
 #include "load_model_impl.hpp"
 // Include implementation of Load() for vectors.
 #include "load_vec_impl.hpp"
+// Include implementation of LoadMapped().
+#include "load_mapped_impl.hpp"
 
 #endif
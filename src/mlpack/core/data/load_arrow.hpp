@@ -0,0 +1,81 @@
+/**
+ * @file core/data/load_arrow.hpp
+ *
+ * Load a dataset stored in an Apache Arrow IPC file or in an Apache Parquet
+ * file, if mlpack was compiled with Arrow support.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_ARROW_HPP
+#define MLPACK_CORE_DATA_LOAD_ARROW_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "dataset_mapper.hpp"
+#include "extension.hpp"
+
+#ifdef MLPACK_HAS_ARROW
+  #include <arrow/api.h>
+  #include <arrow/io/api.h>
+  #include <arrow/ipc/api.h>
+  #include <parquet/arrow/reader.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Return true if the given file is an Arrow IPC file (denoted by .arrow or
+ * .feather) or a Parquet file (denoted by .parquet), judging from its
+ * extension.
+ */
+inline bool IsArrowFile(const std::string& filename)
+{
+  const std::string extension = Extension(filename);
+  return (extension == "arrow" || extension == "feather" ||
+      extension == "parquet");
+}
+
+/**
+ * Load an Arrow IPC file or a Parquet file, where each column of the table is
+ * a dimension and each row is a point.  As with data::Load(), the points are
+ * the columns of the matrix if transpose is true, and its rows otherwise.
+ *
+ * Numeric columns (integers, floating-point numbers and booleans) are copied
+ * into the matrix one column at a time, without converting values to and from
+ * text; null values are loaded as NaN (or an exception is thrown if eT cannot
+ * hold NaN).  String columns are categorical: for dictionary-encoded columns
+ * (which is how Parquet stores strings, and how Parquet files are read here),
+ * each entry of the dictionary of each chunk is mapped once with the
+ * DatasetInfo, and the values of the column are the mappings of their
+ * indices.  Columns of other types are not supported.
+ *
+ * As with LoadARFF(), a pre-existing DatasetInfo object can be given, so that
+ * a test set is loaded with the same mappings as the training set; a
+ * std::invalid_argument exception is thrown if its dimensionality does not
+ * match the number of columns of the table, or if a numeric column is
+ * categorical in the DatasetInfo.  A std::runtime_error exception is thrown if
+ * the file cannot be read, or if mlpack was compiled without Arrow support
+ * (see MLPACK_HAS_ARROW in config.hpp).
+ *
+ * @param filename Name of the file to load.
+ * @param matrix Matrix to load the data into.
+ * @param info DatasetInfo object; can be default-constructed or pre-existing
+ *     from another call to LoadArrow().
+ * @param transpose If true, each point is a column of the matrix.
+ */
+template<typename eT, typename PolicyType>
+void LoadArrow(const std::string& filename,
+               arma::Mat<eT>& matrix,
+               DatasetMapper<PolicyType>& info,
+               const bool transpose = true);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "load_arrow_impl.hpp"
+
+#endif
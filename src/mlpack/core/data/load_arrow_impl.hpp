@@ -0,0 +1,312 @@
+/**
+ * @file core/data/load_arrow_impl.hpp
+ *
+ * Implementation of LoadArrow(), which loads Arrow IPC files and Parquet files.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_ARROW_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_ARROW_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_arrow.hpp"
+
+namespace mlpack {
+namespace data {
+
+#ifdef MLPACK_HAS_ARROW // Compile this only if Arrow is present.
+
+//! Throw a std::runtime_error if the given Arrow operation failed.
+inline void CheckArrowStatus(const arrow::Status& status,
+                             const std::string& filename)
+{
+  if (!status.ok())
+  {
+    throw std::runtime_error("data::LoadArrow(): cannot read '" + filename +
+        "': " + status.ToString());
+  }
+}
+
+//! Read the whole table of an Arrow IPC file or a Parquet file.
+inline std::shared_ptr<arrow::Table> ReadArrowTable(
+    const std::string& filename)
+{
+  // The file is mapped, so that the buffers of Arrow IPC files are not copied
+  // before their values are copied into the matrix.
+  arrow::Result<std::shared_ptr<arrow::io::MemoryMappedFile>> file =
+      arrow::io::MemoryMappedFile::Open(filename, arrow::io::FileMode::READ);
+  CheckArrowStatus(file.status(), filename);
+
+  std::shared_ptr<arrow::Table> table;
+  if (Extension(filename) == "parquet")
+  {
+    parquet::arrow::FileReaderBuilder builder;
+    CheckArrowStatus(builder.Open(*file), filename);
+
+    // Read string columns as dictionaries, so that each distinct string of a
+    // chunk is mapped only once.
+    parquet::ArrowReaderProperties properties;
+    const parquet::SchemaDescriptor* schema =
+        builder.raw_reader()->metadata()->schema();
+    for (int i = 0; i < schema->num_columns(); ++i)
+      if (schema->Column(i)->physical_type() == parquet::Type::BYTE_ARRAY)
+        properties.set_read_dictionary(i, true);
+
+    std::unique_ptr<parquet::arrow::FileReader> reader;
+    CheckArrowStatus(builder.properties(properties)->Build(&reader), filename);
+    CheckArrowStatus(reader->ReadTable(&table), filename);
+  }
+  else
+  {
+    arrow::Result<std::shared_ptr<arrow::ipc::RecordBatchFileReader>> reader =
+        arrow::ipc::RecordBatchFileReader::Open(*file);
+    CheckArrowStatus(reader.status(), filename);
+
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    for (int i = 0; i < (*reader)->num_record_batches(); ++i)
+    {
+      arrow::Result<std::shared_ptr<arrow::RecordBatch>> batch =
+          (*reader)->ReadRecordBatch(i);
+      CheckArrowStatus(batch.status(), filename);
+      batches.push_back(*batch);
+    }
+
+    arrow::Result<std::shared_ptr<arrow::Table>> result =
+        arrow::Table::FromRecordBatches((*reader)->schema(), batches);
+    CheckArrowStatus(result.status(), filename);
+    table = *result;
+  }
+
+  return table;
+}
+
+//! Return true if the columns of the given type hold strings (possibly
+//! dictionary-encoded).
+inline bool IsArrowStringType(const arrow::DataType& type)
+{
+  const arrow::Type::type id = (type.id() == arrow::Type::DICTIONARY) ?
+      static_cast<const arrow::DictionaryType&>(type).value_type()->id() :
+      type.id();
+  return (id == arrow::Type::STRING || id == arrow::Type::LARGE_STRING);
+}
+
+//! Load the null values of the given array as NaN.
+template<typename eT>
+void SetArrowNulls(const arrow::Array& array,
+                   eT* out,
+                   const size_t stride,
+                   const std::string& name)
+{
+  if (!std::numeric_limits<eT>::has_quiet_NaN)
+  {
+    throw std::runtime_error("data::LoadArrow(): column '" + name + "' has "
+        "null values, which cannot be loaded into a matrix of integers.");
+  }
+
+  for (int64_t i = 0; i < array.length(); ++i)
+    if (array.IsNull(i))
+      out[i * stride] = std::numeric_limits<eT>::quiet_NaN();
+}
+
+//! Copy the values of a numeric array of the given Arrow type to out,
+//! out + stride, and so on.
+template<typename ArrowType, typename eT>
+void CopyArrowValues(const arrow::Array& array,
+                     eT* out,
+                     const size_t stride)
+{
+  const typename ArrowType::c_type* values =
+      static_cast<const arrow::NumericArray<ArrowType>&>(array).raw_values();
+  for (int64_t i = 0; i < array.length(); ++i)
+    out[i * stride] = (eT) values[i];
+}
+
+//! Copy the values of a numeric array to out, out + stride, and so on.
+template<typename eT>
+void CopyArrowColumn(const arrow::Array& array,
+                     eT* out,
+                     const size_t stride,
+                     const std::string& name)
+{
+  switch (array.type_id())
+  {
+    case arrow::Type::DOUBLE:
+      CopyArrowValues<arrow::DoubleType>(array, out, stride); break;
+    case arrow::Type::FLOAT:
+      CopyArrowValues<arrow::FloatType>(array, out, stride); break;
+    case arrow::Type::INT8:
+      CopyArrowValues<arrow::Int8Type>(array, out, stride); break;
+    case arrow::Type::INT16:
+      CopyArrowValues<arrow::Int16Type>(array, out, stride); break;
+    case arrow::Type::INT32:
+      CopyArrowValues<arrow::Int32Type>(array, out, stride); break;
+    case arrow::Type::INT64:
+      CopyArrowValues<arrow::Int64Type>(array, out, stride); break;
+    case arrow::Type::UINT8:
+      CopyArrowValues<arrow::UInt8Type>(array, out, stride); break;
+    case arrow::Type::UINT16:
+      CopyArrowValues<arrow::UInt16Type>(array, out, stride); break;
+    case arrow::Type::UINT32:
+      CopyArrowValues<arrow::UInt32Type>(array, out, stride); break;
+    case arrow::Type::UINT64:
+      CopyArrowValues<arrow::UInt64Type>(array, out, stride); break;
+    case arrow::Type::BOOL:
+    {
+      // Booleans are packed in bits.
+      const arrow::BooleanArray& values =
+          static_cast<const arrow::BooleanArray&>(array);
+      for (int64_t i = 0; i < array.length(); ++i)
+        out[i * stride] = values.Value(i) ? eT(1) : eT(0);
+      break;
+    }
+    default:
+      throw std::runtime_error("data::LoadArrow(): column '" + name + "' has "
+          "type " + array.type()->ToString() + ", which is not supported.");
+  }
+
+  if (array.null_count() > 0)
+    SetArrowNulls(array, out, stride, name);
+}
+
+//! Get the values of an array of strings.
+inline std::vector<std::string> ArrowStrings(const arrow::Array& array)
+{
+  std::vector<std::string> strings(array.length());
+  if (array.type_id() == arrow::Type::STRING)
+  {
+    const arrow::StringArray& values =
+        static_cast<const arrow::StringArray&>(array);
+    for (int64_t i = 0; i < array.length(); ++i)
+      strings[i] = values.GetString(i);
+  }
+  else
+  {
+    const arrow::LargeStringArray& values =
+        static_cast<const arrow::LargeStringArray&>(array);
+    for (int64_t i = 0; i < array.length(); ++i)
+      strings[i] = values.GetString(i);
+  }
+
+  return strings;
+}
+
+//! Map the values of an array of strings (possibly dictionary-encoded) to out,
+//! out + stride, and so on.  Each distinct string is mapped only once, when it
+//! is first used; null values are mapped as empty strings.
+template<typename eT, typename PolicyType>
+void MapArrowStrings(const arrow::Array& array,
+                     DatasetMapper<PolicyType>& info,
+                     const size_t dimension,
+                     eT* out,
+                     const size_t stride)
+{
+  const arrow::DictionaryArray* dictionary =
+      (array.type_id() == arrow::Type::DICTIONARY) ?
+      static_cast<const arrow::DictionaryArray*>(&array) : nullptr;
+  const std::vector<std::string> strings =
+      ArrowStrings(dictionary ? *dictionary->dictionary() : array);
+
+  std::vector<eT> mappings(strings.size());
+  std::vector<bool> mapped(strings.size(), false);
+  for (int64_t i = 0; i < array.length(); ++i)
+  {
+    if (array.IsNull(i))
+    {
+      out[i * stride] = info.template MapString<eT>(std::string(), dimension);
+      continue;
+    }
+
+    const size_t index = dictionary ? dictionary->GetValueIndex(i) : i;
+    if (!mapped[index])
+    {
+      mappings[index] = info.template MapString<eT>(strings[index],
+          dimension);
+      mapped[index] = true;
+    }
+
+    out[i * stride] = mappings[index];
+  }
+}
+
+template<typename eT, typename PolicyType>
+void LoadArrow(const std::string& filename,
+               arma::Mat<eT>& matrix,
+               DatasetMapper<PolicyType>& info,
+               const bool transpose)
+{
+  std::shared_ptr<arrow::Table> table = ReadArrowTable(filename);
+  const size_t dimensionality = table->num_columns();
+  const size_t numPoints = table->num_rows();
+
+  if (info.Dimensionality() == 0)
+  {
+    info = DatasetMapper<PolicyType>(dimensionality);
+  }
+  else if (info.Dimensionality() != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "data::LoadArrow(): given DatasetInfo has dimensionality "
+        << info.Dimensionality() << ", but data has dimensionality "
+        << dimensionality;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (transpose)
+    matrix.set_size(dimensionality, numPoints);
+  else
+    matrix.set_size(numPoints, dimensionality);
+
+  // The values of each dimension are contiguous if the matrix is not
+  // transposed.
+  const size_t stride = transpose ? dimensionality : 1;
+  for (size_t d = 0; d < dimensionality; ++d)
+  {
+    const std::string& name = table->field(d)->name();
+    const arrow::ChunkedArray& column = *table->column(d);
+    const bool strings = IsArrowStringType(*column.type());
+    if (strings)
+    {
+      info.Type(d) = Datatype::categorical;
+    }
+    else if (info.Type(d) == Datatype::categorical)
+    {
+      throw std::invalid_argument("data::LoadArrow(): column '" + name +
+          "' is numeric, but it is categorical in the given DatasetInfo.");
+    }
+
+    eT* out = transpose ? matrix.memptr() + d : matrix.colptr(d);
+    for (int k = 0; k < column.num_chunks(); ++k)
+    {
+      const arrow::Array& array = *column.chunk(k);
+      if (strings)
+        MapArrowStrings(array, info, d, out, stride);
+      else
+        CopyArrowColumn(array, out, stride, name);
+
+      out += array.length() * stride;
+    }
+  }
+}
+
+#else // MLPACK_HAS_ARROW
+
+template<typename eT, typename PolicyType>
+void LoadArrow(const std::string& filename,
+               arma::Mat<eT>& /* matrix */,
+               DatasetMapper<PolicyType>& /* info */,
+               const bool /* transpose */)
+{
+  throw std::runtime_error("data::LoadArrow(): cannot load '" + filename +
+      "'; mlpack was not compiled with Arrow support (see MLPACK_HAS_ARROW in "
+      "config.hpp).");
+}
+
+#endif // MLPACK_HAS_ARROW
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -24,7 +24,18 @@ void LoadCSV::LoadCategoricalCSV(arma::Mat<eT> &inout,
 {
   CheckOpen();
 
-  if (transpose)
+  // Parse the file in parallel from a memory mapping, if it can be mapped (an
+  // empty file cannot, for instance).
+  MappedFile file;
+  try
+  {
+    file.Open(filename);
+  }
+  catch (const std::runtime_error&) { }
+
+  if (file.IsOpen())
+    ParallelCategoricalParse(inout, infoSet, file, transpose);
+  else if (transpose)
     TransposeParse(inout, infoSet);
   else
     NonTransposeParse(inout, infoSet);
@@ -50,6 +50,7 @@
 #include "extension.hpp"
 #include "format.hpp"
 #include "dataset_mapper.hpp"
+#include "mapped_file.hpp"
 #include "types.hpp"
 
 namespace mlpack {
@@ -128,6 +129,48 @@ class LoadCSV
   template<typename eT>
   bool ConvertToken(eT& val, const std::string& token);
 
+  /**
+   * Parse a csv file that has been mapped into memory, and load the data into
+   * the given matrix.  The file is split into chunks of lines that are parsed
+   * in parallel, directly into the output matrix: a first pass counts the
+   * lines and columns of each chunk, and a second pass converts the tokens.
+   * The result is the same as with LoadNumericCSV(arma::Mat<eT>&,
+   * std::fstream&), transposed if requested.
+   *
+   * @param x Matrix in which data will be loaded.
+   * @param file Mapped data file.
+   * @param transpose If true, each line of the file is a column of x.
+   */
+  template<typename eT>
+  bool LoadNumericCSV(arma::Mat<eT>& x,
+                      const MappedFile& file,
+                      const bool transpose);
+
+  /**
+   * Convert the token in the given range of characters to the given datatype.
+   * Simple decimal numbers are converted directly, without copying the token;
+   * other tokens go through ConvertToken(eT&, const std::string&).
+   *
+   * @param val Token's value will be assigned to this address.
+   * @param begin Start of the token.
+   * @param end End of the token (one past the last character).
+   */
+  template<typename eT>
+  bool ConvertToken(eT& val, const char* begin, const char* end);
+
+  /**
+   * Convert the token in the given range of characters to the given datatype,
+   * if it is a simple decimal number that can be converted directly (see
+   * ConvertToken(eT&, const char*, const char*)).  Return false, without
+   * modifying val, for any other token, including an empty one.
+   *
+   * @param val Token's value will be assigned to this address.
+   * @param begin Start of the token.
+   * @param end End of the token (one past the last character).
+   */
+  template<typename eT>
+  static bool FastConvertToken(eT& val, const char* begin, const char* end);
+
   /**
    * Calculate the number of columns in each row
    * and assign the value to the col. This function
@@ -297,6 +340,97 @@ class LoadCSV
   template<typename T, typename PolicyType>
   void TransposeParse(arma::Mat<T>& inout, DatasetMapper<PolicyType>& infoSet);
 
+  /**
+  * Parse a (transposed or not) matrix from the mapped file, in parallel.  The
+  * tokens of each chunk of lines are split in parallel, the distinct tokens of
+  * each dimension are then mapped by infoSet in order of first appearance,
+  * and the mapped values are written to the matrix in parallel.
+  *
+  * @param inout Matrix to load into.
+  * @param infoSet DatasetMapper to load with.
+  * @param file Mapped data file.
+  * @param transpose If true, each line of the file is a point.
+  */
+  template<typename T, typename PolicyType>
+  void ParallelCategoricalParse(arma::Mat<T>& inout,
+                                DatasetMapper<PolicyType>& infoSet,
+                                const MappedFile& file,
+                                const bool transpose);
+
+  /**
+  * Split the given line into tokens, as NonTransposeParse() and
+  * TransposeParse() do.
+  */
+  inline void SplitCategoricalLine(const char* begin,
+                                   const char* end,
+                                   std::vector<std::string>& tokens) const;
+
+  /**
+  * A distinct token of a chunk, interned in the arena of the chunk: the
+  * dimension (or line of the chunk) of the token, and the position of its
+  * characters in the arena.
+  */
+  struct InternedToken
+  {
+    size_t key;
+    size_t offset;
+    size_t length;
+  };
+
+  //! Hash an interned token from its key and its characters in the arena.
+  struct InternedTokenHash
+  {
+    const std::string* arena;
+
+    inline size_t operator()(const InternedToken& token) const;
+  };
+
+  //! Compare interned tokens by key and by their characters in the arena.
+  struct InternedTokenEqual
+  {
+    const std::string* arena;
+
+    inline bool operator()(const InternedToken& a,
+                           const InternedToken& b) const;
+  };
+
+  /**
+  * Return true if the policy maps every number of a numeric dimension to its
+  * value, as read by a stringstream, and keeps the dimension numeric; then the
+  * numbers that FastConvertToken() converts do not need to be mapped.
+  */
+  template<typename PolicyType>
+  static bool MapsNumbersToValues(const PolicyType& /* policy */)
+  {
+    return false;
+  }
+
+  static bool MapsNumbersToValues(const IncrementPolicy& policy)
+  {
+    return !policy.ForceAllMappings();
+  }
+
+  // Functions for parallel parsing.
+
+  /**
+  * Split the given memory into chunks of whole lines, to be parsed in
+  * parallel; the returned vector holds the offset of the start of each chunk,
+  * then the size.
+  */
+  inline static std::vector<size_t> LineChunks(const char* data,
+                                               const size_t size);
+
+  /**
+  * Get the end of the line that starts at the given position (without the
+  * newline, and without the carriage return of a Windows line ending).
+  */
+  inline static const char* LineEnd(const char* begin, const char* end);
+
+  /**
+  * Get the start of the line after the line that starts at the given position.
+  */
+  inline static const char* NextLine(const char* begin, const char* end);
+
   //! Extension (type) of file.
   std::string extension;
   //! Name of file.
@@ -312,5 +446,6 @@ class LoadCSV
 
 #include "load_numeric_csv.hpp"
 #include "load_categorical_csv.hpp"
+#include "load_parallel_csv.hpp"
 
 #endif
@@ -64,7 +64,11 @@ bool Load(const std::string& filename,
           const bool fatal = false);
 
 /**
- * Load the image file into the given matrix.
+ * Load the image files into the given matrix, one image per column.  The
+ * images are decoded in parallel (if OpenMP is enabled), and each one is
+ * converted directly into its column of the matrix.  The first image gives
+ * the size of the images in info; loading fails if any image has a different
+ * size.
  *
  * @param files A vector consisting of filenames.
  * @param matrix Matrix to save the image from.
@@ -84,6 +88,26 @@ inline bool LoadImage(const std::string& filename,
                       ImageInfo& info,
                       const bool fatal = false);
 
+/**
+ * Decode the given image file, and set the width, height and number of
+ * channels of info (as LoadImage() does).  The decoded pixels must be freed
+ * with FreeImage().  If the image cannot be decoded, NULL is returned and
+ * error is set to the reason; nothing is logged, so that images can be decoded
+ * from several threads at once.
+ *
+ * @param filename Name of the image file.
+ * @param info An object of ImageInfo class.
+ * @param error Set to the reason of the failure, if the image cannot be
+ *     decoded.
+ * @return The decoded pixels, or NULL.
+ */
+inline unsigned char* DecodeImage(const std::string& filename,
+                                  ImageInfo& info,
+                                  std::string& error);
+
+//! Free the pixels returned by DecodeImage().
+inline void FreeImage(unsigned char* image);
+
 } // namespace data
 } // namespace mlpack
 
@@ -15,10 +15,23 @@
 // In case it hasn't been included yet.
 #include "load_image.hpp"
 #include "image_info.hpp"
+#include <mlpack/core/util/executor.hpp>
 
 namespace mlpack {
 namespace data {
 
+//! Report the given image loading error as fatal or as a warning, and return
+//! false.
+inline bool ImageLoadFailed(const std::string& error, const bool fatal)
+{
+  if (fatal)
+    Log::Fatal << "Load(): " << error << std::endl;
+  else
+    Log::Warn << "Load(): " << error << std::endl;
+
+  return false;
+}
+
 // Image loading API.
 template<typename eT>
 bool Load(const std::string& filename,
@@ -28,19 +41,22 @@ bool Load(const std::string& filename,
 {
   Timer::Start("loading_image");
 
-  // STB loads into unsigned char matrices, so we may have to convert once
-  // loaded.
-  arma::Mat<unsigned char> tempMatrix;
-  const bool result = LoadImage(filename, tempMatrix, info, fatal);
+  // STB decodes into unsigned chars, which are converted as they are copied
+  // into the matrix.
+  std::string error;
+  unsigned char* image = DecodeImage(filename, info, error);
 
   // If fatal is true, then the program will have already thrown an exception.
-  if (!result)
+  if (!image)
   {
     Timer::Stop("loading_image");
-    return false;
+    return ImageLoadFailed(error, fatal);
   }
 
-  matrix = arma::conv_to<arma::Mat<eT>>::from(tempMatrix);
+  matrix.set_size(info.Width() * info.Height() * info.Channels(), 1);
+  std::copy(image, image + matrix.n_elem, matrix.memptr());
+  FreeImage(image);
+
   Timer::Stop("loading_image");
   return true;
 }
@@ -65,60 +81,92 @@ bool Load(const std::vector<std::string>& files,
     return false;
   }
 
-  arma::Mat<unsigned char> img;
-  bool status = LoadImage(files[0], img, info, fatal);
-
-  if (!status)
-    return false;
+  std::string error;
+  unsigned char* image = DecodeImage(files[0], info, error);
+  if (!image)
+    return ImageLoadFailed(error, fatal);
 
   // Decide matrix dimension using the image height and width.
-  arma::Mat<unsigned char> tmpMatrix(
-      info.Width() * info.Height() * info.Channels(), files.size());
-  tmpMatrix.col(0) = img;
+  const size_t imageSize = info.Width() * info.Height() * info.Channels();
+  matrix.set_size(imageSize, files.size());
+  std::copy(image, image + imageSize, matrix.colptr(0));
+  FreeImage(image);
+
+  // Decode the other images in parallel, straight into their columns.  The
+  // error of each file is kept, so that the first failure can be reported.
+  std::vector<std::string> errors(files.size());
 
-  for (size_t i = 1; i < files.size() ; ++i)
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t i = 1; i < files.size(); ++i)
   {
-    arma::Mat<unsigned char> colImg(tmpMatrix.colptr(i), tmpMatrix.n_rows, 1,
-        false, true);
-    status = LoadImage(files[i], colImg, info, fatal);
+    ImageInfo fileInfo(info);
+    unsigned char* fileImage = DecodeImage(files[i], fileInfo, errors[i]);
+    if (!fileImage)
+      continue;
+
+    const size_t fileSize = fileInfo.Width() * fileInfo.Height() *
+        fileInfo.Channels();
+    if (fileSize != imageSize)
+    {
+      std::ostringstream oss;
+      oss << "image '" << files[i] << "' has " << fileSize << " values, but "
+          << "image '" << files[0] << "' has " << imageSize << " values.";
+      errors[i] = oss.str();
+    }
+    else
+    {
+      std::copy(fileImage, fileImage + imageSize, matrix.colptr(i));
+    }
 
-    if (!status)
-      return false;
+    FreeImage(fileImage);
   }
 
-  matrix = arma::conv_to<arma::Mat<eT>>::from(tmpMatrix);
+  for (size_t i = 1; i < files.size(); ++i)
+    if (!errors[i].empty())
+      return ImageLoadFailed(errors[i], fatal);
+
   return true;
 }
 
-#ifdef MLPACK_HAS_STB
-
 inline bool LoadImage(const std::string& filename,
                       arma::Mat<unsigned char>& matrix,
                       ImageInfo& info,
                       const bool fatal)
+{
+  std::string error;
+  unsigned char* image = DecodeImage(filename, info, error);
+  if (!image)
+    return ImageLoadFailed(error, fatal);
+
+  // Copy image into armadillo Mat.
+  matrix = arma::Mat<unsigned char>(image, info.Width() * info.Height() *
+      info.Channels(), 1, true, true);
+
+  // Free the image pointer.
+  FreeImage(image);
+  return true;
+}
+
+#ifdef MLPACK_HAS_STB
+
+inline unsigned char* DecodeImage(const std::string& filename,
+                                  ImageInfo& info,
+                                  std::string& error)
 {
   unsigned char* image;
 
   if (!ImageFormatSupported(filename))
   {
     std::ostringstream oss;
-    oss << "Load(): file type " << Extension(filename) << " not supported. ";
+    oss << "file type " << Extension(filename) << " not supported. ";
     oss << "Currently it supports:";
     auto x = LoadFileTypes();
     for (auto extension : x)
       oss << " " << extension;
-    oss << "." << std::endl;
+    oss << ".";
+    error = oss.str();
 
-    if (fatal)
-    {
-      Log::Fatal << oss.str();
-    }
-    else
-    {
-      Log::Warn << oss.str();
-    }
-
-    return false;
+    return NULL;
   }
 
   // Temporary variables needed as stb_image.h supports int parameters.
@@ -138,18 +186,9 @@ inline bool LoadImage(const std::string& filename,
 
   if (!image)
   {
-    if (fatal)
-    {
-      Log::Fatal << "Load(): failed to load image '" << filename << "': "
-          << stbi_failure_reason() << std::endl;
-    }
-    else
-    {
-      Log::Warn << "Load(): failed to load image '" << filename << "': "
-          << stbi_failure_reason() << std::endl;
-    }
-
-    return false;
+    error = "failed to load image '" + filename + "': " +
+        stbi_failure_reason();
+    return NULL;
   }
 
   info.Width() = tempWidth;
@@ -158,34 +197,28 @@ inline bool LoadImage(const std::string& filename,
   if (info.Channels() != 1)
     info.Channels() = tempChannels;
 
-  // Copy image into armadillo Mat.
-  matrix = arma::Mat<unsigned char>(image, info.Width() * info.Height() *
-      info.Channels(), 1, true, true);
+  return image;
+}
 
-  // Free the image pointer.
+inline void FreeImage(unsigned char* image)
+{
   stbi_image_free(image);
-  return true;
 }
 
 #else // MLPACK_HAS_STB
 
-inline bool LoadImage(const std::string& /* filename */,
-                      arma::Mat<unsigned char>& /* matrix */,
-                      ImageInfo& /* info */,
-                      const bool fatal)
+inline unsigned char* DecodeImage(const std::string& /* filename */,
+                                  ImageInfo& /* info */,
+                                  std::string& error)
 {
-  if (fatal)
-  {
-    Log::Fatal << "Load(): mlpack was not compiled with STB support, so images "
-        << "cannot be loaded!" << std::endl;
-  }
-  else
-  {
-    Log::Warn << "Load(): mlpack was not compiled with STB support, so images "
-        << "cannot be loaded!" << std::endl;
-  }
+  error = "mlpack was not compiled with STB support, so images cannot be "
+      "loaded!";
+  return NULL;
+}
 
-  return false;
+inline void FreeImage(unsigned char* /* image */)
+{
+  // Nothing is ever decoded.
 }
 
 #endif
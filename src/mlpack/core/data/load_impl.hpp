@@ -108,6 +108,40 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  if (inputLoadType == FileType::AutoDetect && IsArrowFile(filename))
+  {
+    Log::Info << "Loading '" << filename << "' as Arrow data.  " << std::flush;
+    try
+    {
+      DatasetInfo info;
+      LoadArrow(filename, matrix, info, transpose);
+      for (size_t i = 0; i < info.Dimensionality(); ++i)
+      {
+        if (info.Type(i) == Datatype::categorical)
+        {
+          throw std::runtime_error("'" + filename + "' has string columns; "
+              "load it with a DatasetInfo instead.");
+        }
+      }
+    }
+    catch (std::exception& e)
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols
+        << ".\n";
+    Timer::Stop("loading_data");
+    return true;
+  }
+
   FileType loadType = inputLoadType;
   std::string stringType;
   if (inputLoadType == FileType::AutoDetect)
@@ -159,12 +193,33 @@ bool Load(const std::string& filename,
 
   // We can't use the stream if the type is HDF5.
   bool success;
+  bool transposed = false;
   LoadCSV loader;
   
   if (loadType != FileType::HDF5Binary)
   {
     if (loadType == FileType::CSVASCII)
-      success = loader.LoadNumericCSV(matrix, stream);
+    {
+      // Parse the file in parallel from a memory mapping, directly into the
+      // transposed matrix if needed, if the file can be mapped (an empty file
+      // cannot, for instance).
+      MappedFile file;
+      try
+      {
+        file.Open(filename);
+      }
+      catch (const std::runtime_error&) { }
+
+      if (file.IsOpen())
+      {
+        success = loader.LoadNumericCSV(matrix, file, transpose);
+        transposed = transpose;
+      }
+      else
+      {
+        success = loader.LoadNumericCSV(matrix, stream);
+      }
+    }
     else
       success = matrix.load(stream, ToArmaFileType(loadType));
   }
@@ -182,12 +237,15 @@ bool Load(const std::string& filename,
 
     return false;
   }
+  else if (transposed)
+    Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols
+        << ".\n";
   else
     Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
         << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
 
   // Now transpose the matrix, if necessary.
-  if (transpose)
+  if (transpose && !transposed)
   {
     success = inplace_transpose(matrix, fatal);
   }
@@ -247,6 +305,25 @@ bool Load(const std::string& filename,
       return false;
     }
   }
+  else if (IsArrowFile(filename))
+  {
+    Log::Info << "Loading '" << filename << "' as Arrow dataset.  "
+        << std::flush;
+    try
+    {
+      LoadArrow(filename, matrix, info, transpose);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+  }
   else if (extension == "arff")
   {
     Log::Info << "Loading '" << filename << "' as ARFF dataset.  "
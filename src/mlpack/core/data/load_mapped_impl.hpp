@@ -0,0 +1,186 @@
+/**
+ * @file core/data/load_mapped_impl.hpp
+ *
+ * Implementation of LoadMapped(), which loads a model or a matrix saved with
+ * SaveMapped() from a memory-mapped file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_MAPPED_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_MAPPED_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "load.hpp"
+
+#include <mlpack/core/cereal/mapped_archive.hpp>
+
+namespace mlpack {
+namespace data {
+
+template<typename T>
+bool LoadMapped(const std::string& filename,
+                const std::string& name,
+                T& t,
+                MappedFile& file,
+                const bool fatal)
+{
+  // Map the new file first: the model may still refer to the old one.
+  MappedFile newFile;
+  try
+  {
+    newFile.Open(filename);
+  }
+  catch (std::runtime_error& e)
+  {
+    if (fatal)
+      Log::Fatal << "Unable to load object '" << name << "': " << e.what()
+          << std::endl;
+    else
+      Log::Warn << "Unable to load object '" << name << "': " << e.what()
+          << std::endl;
+
+    return false;
+  }
+
+  MappedFileHeader header;
+  bool valid = (newFile.Size() >= MappedFileHeader::reservedSize);
+  if (valid)
+  {
+    std::memcpy(&header, newFile.Data(), sizeof(MappedFileHeader));
+    valid = (std::memcmp(header.magic, MappedFileHeader::Magic(),
+        sizeof(header.magic)) == 0) &&
+        (header.version == MappedFileHeader::currentVersion) &&
+        (header.structureOffset <= newFile.Size()) &&
+        (header.structureSize <= newFile.Size() - header.structureOffset);
+  }
+
+  if (!valid)
+  {
+    if (fatal)
+      Log::Fatal << "'" << filename << "' is not a file saved with "
+          << "data::SaveMapped(); cannot load object '" << name << "'."
+          << std::endl;
+    else
+      Log::Warn << "'" << filename << "' is not a file saved with "
+          << "data::SaveMapped(); cannot load object '" << name << "'."
+          << std::endl;
+
+    return false;
+  }
+
+  std::string error;
+  try
+  {
+    MemoryStreamBuffer buffer(newFile.Data() + header.structureOffset,
+        header.structureSize);
+    std::istream stream(&buffer);
+    cereal::MappedInputArchive ar(stream, newFile.Data(), newFile.Size());
+    ar(cereal::make_nvp(name.c_str(), t));
+  }
+  catch (cereal::Exception& e)
+  {
+    error = e.what();
+  }
+
+  // Even after a failure, parts of the model may refer to the new mapping, so
+  // it must be kept.
+  file = std::move(newFile);
+
+  if (!error.empty())
+  {
+    if (fatal)
+      Log::Fatal << error << std::endl;
+    else
+      Log::Warn << error << std::endl;
+
+    return false;
+  }
+
+  return true;
+}
+
+template<typename eT>
+bool LoadMapped(const std::string& filename,
+                arma::Mat<eT>& matrix,
+                MappedFile& file,
+                const bool fatal,
+                const bool readOnly)
+{
+  MappedFile newFile;
+  try
+  {
+    newFile.Open(filename, readOnly);
+  }
+  catch (std::runtime_error& e)
+  {
+    if (fatal)
+      Log::Fatal << "Unable to load matrix: " << e.what() << std::endl;
+    else
+      Log::Warn << "Unable to load matrix: " << e.what() << std::endl;
+
+    return false;
+  }
+
+  std::ostringstream error;
+  MappedMatrixHeader header;
+  if (newFile.Size() < MappedMatrixHeader::reservedSize)
+  {
+    error << "'" << filename << "' is not a matrix saved with "
+        << "data::SaveMapped().";
+  }
+  else
+  {
+    std::memcpy(&header, newFile.Data(), sizeof(MappedMatrixHeader));
+    if (std::memcmp(header.magic, MappedMatrixHeader::Magic(),
+        sizeof(header.magic)) != 0 ||
+        header.version != MappedMatrixHeader::currentVersion)
+    {
+      error << "'" << filename << "' is not a matrix saved with "
+          << "data::SaveMapped().";
+    }
+    else if (header.elemKind != (uint64_t) MappedMatrixHeader::ElemKind<eT>() ||
+        header.elemSize != sizeof(eT))
+    {
+      error << "'" << filename << "' holds elements of kind '"
+          << (char) header.elemKind << "' with " << header.elemSize
+          << " bytes, but the matrix has elements of kind '"
+          << MappedMatrixHeader::ElemKind<eT>() << "' with " << sizeof(eT)
+          << " bytes.";
+    }
+    else if (header.dataOffset % sizeof(eT) != 0 ||
+        header.dataOffset > newFile.Size() ||
+        (header.nCols > 0 && header.nRows > (newFile.Size() -
+        header.dataOffset) / sizeof(eT) / header.nCols))
+    {
+      error << "The elements of the matrix lie outside of '" << filename
+          << "'.";
+    }
+  }
+
+  if (!error.str().empty())
+  {
+    if (fatal)
+      Log::Fatal << error.str() << std::endl;
+    else
+      Log::Warn << error.str() << std::endl;
+
+    return false;
+  }
+
+  // Non-strict auxiliary memory: if the matrix is resized later, it gets its
+  // own memory again.
+  arma::Mat<eT> mapped((eT*) (newFile.Data() + header.dataOffset),
+      header.nRows, header.nCols, false, false);
+  matrix.steal_mem(mapped);
+  file = std::move(newFile);
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
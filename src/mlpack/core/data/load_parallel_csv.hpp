@@ -0,0 +1,633 @@
+/**
+ * @file core/data/load_parallel_csv.hpp
+ *
+ * Parallel parsing of CSV files from a memory mapping.  The mapped file is
+ * split into chunks that start at the beginning of a line, and each chunk is
+ * parsed by one thread directly into the output matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_PARALLEL_CSV_HPP
+#define MLPACK_CORE_DATA_LOAD_PARALLEL_CSV_HPP
+
+#include "load_csv.hpp"
+#include <mlpack/core/util/executor.hpp>
+
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace mlpack {
+namespace data {
+
+inline std::vector<size_t> LoadCSV::LineChunks(const char* data,
+                                               const size_t size)
+{
+  // Use several chunks per thread so that the work is balanced, but keep the
+  // chunks large enough that the cost of each one is negligible.
+  const size_t minChunkSize = 1 << 20;
+  const size_t numChunks = std::max((size_t) 1, std::min(size / minChunkSize,
+      8 * NumThreads()));
+
+  std::vector<size_t> bounds(1, 0);
+  for (size_t c = 1; c < numChunks; ++c)
+  {
+    // Move to the start of the line after the target position.
+    const size_t target = std::max(bounds.back(), c * (size / numChunks));
+    const char* newline = (const char*) std::memchr(data + target, '\n',
+        size - target);
+    if (newline == NULL || (size_t) (newline - data) + 1 >= size)
+      break;
+
+    bounds.push_back((newline - data) + 1);
+  }
+  bounds.push_back(size);
+
+  return bounds;
+}
+
+inline const char* LoadCSV::LineEnd(const char* begin, const char* end)
+{
+  const char* newline = (const char*) std::memchr(begin, '\n', end - begin);
+  const char* lineEnd = (newline == NULL) ? end : newline;
+  if (lineEnd > begin && *(lineEnd - 1) == '\r')
+    --lineEnd;
+
+  return lineEnd;
+}
+
+inline const char* LoadCSV::NextLine(const char* begin, const char* end)
+{
+  const char* newline = (const char*) std::memchr(begin, '\n', end - begin);
+  return (newline == NULL) ? end : newline + 1;
+}
+
+template<typename eT>
+bool LoadCSV::FastConvertToken(eT& val,
+                               const char* begin,
+                               const char* end)
+{
+  // Exact powers of ten that can be represented by a double.
+  static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+      1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+      1e20, 1e21, 1e22 };
+
+  // Only tokens of the form [+-]digits[.digits][e[+-]digits] with at most 19
+  // significant digits are converted, as from_chars() would.
+  if (begin == end)
+    return false;
+
+  const char* p = begin;
+  const bool neg = (*p == '-');
+  if (*p == '-' || *p == '+')
+    ++p;
+
+  uint64_t mantissa = 0;
+  int digits = 0, exponent = 0;
+  bool anyDigit = false, integer = true;
+  for (; p != end && *p >= '0' && *p <= '9'; ++p)
+  {
+    anyDigit = true;
+    if (mantissa != 0 || *p != '0')
+    {
+      mantissa = 10 * mantissa + (uint64_t) (*p - '0');
+      ++digits;
+    }
+  }
+
+  if (p != end && *p == '.')
+  {
+    integer = false;
+    for (++p; p != end && *p >= '0' && *p <= '9'; ++p)
+    {
+      anyDigit = true;
+      if (mantissa != 0 || *p != '0')
+      {
+        mantissa = 10 * mantissa + (uint64_t) (*p - '0');
+        ++digits;
+      }
+      --exponent;
+    }
+  }
+
+  if (anyDigit && p != end && (*p == 'e' || *p == 'E') && p + 1 != end)
+  {
+    integer = false;
+    const char* q = p + 1;
+    const bool negExponent = (*q == '-');
+    if (*q == '-' || *q == '+')
+      ++q;
+
+    int e = 0;
+    const char* digitsBegin = q;
+    for (; q != end && *q >= '0' && *q <= '9' && e < 10000; ++q)
+      e = 10 * e + (*q - '0');
+
+    if (q != digitsBegin)
+    {
+      exponent += negExponent ? -e : e;
+      p = q;
+    }
+  }
+
+  if (!anyDigit || p != end || digits > 19)
+    return false;
+
+  if (std::is_floating_point<eT>::value)
+  {
+    // A double holds any integer below 2^53 exactly, so multiplying or
+    // dividing it by an exact power of ten is correctly rounded.
+    if (mantissa > (uint64_t(1) << 53) || exponent < -22 || exponent > 22)
+      return false;
+
+    double result = (double) mantissa;
+    result = (exponent < 0) ? result / powers[-exponent] :
+        result * powers[exponent];
+    val = eT(neg ? -result : result);
+    return true;
+  }
+  else if (std::is_integral<eT>::value)
+  {
+    if (!integer || digits > 18)
+      return false;
+
+    // As in the other overload, negative numbers are 0 for unsigned types.
+    if (std::is_signed<eT>::value)
+      val = neg ? eT(-((long long) mantissa)) : eT(mantissa);
+    else
+      val = neg ? eT(0) : eT(mantissa);
+    return true;
+  }
+
+  return false;
+}
+
+template<typename eT>
+bool LoadCSV::ConvertToken(eT& val, const char* begin, const char* end)
+{
+  // Fill empty data points with 0.
+  if (begin == end)
+  {
+    val = eT(0);
+    return true;
+  }
+
+  // Anything that the fast path does not handle (leading whitespace,
+  // infinities, trailing characters...) is given to the slower ConvertToken()
+  // overload, so the results are the same.
+  if (FastConvertToken(val, begin, end))
+    return true;
+
+  return ConvertToken(val, std::string(begin, end));
+}
+
+template<typename eT>
+bool LoadCSV::LoadNumericCSV(arma::Mat<eT>& x,
+                             const MappedFile& file,
+                             const bool transpose)
+{
+  const char* data = file.Data();
+  const std::vector<size_t> bounds = LineChunks(data, file.Size());
+  const size_t numChunks = bounds.size() - 1;
+
+  // First pass: count the lines and the columns of each chunk.  As with
+  // LoadNumericCSV(arma::Mat<eT>&, std::fstream&), the matrix ends at the first
+  // empty line.
+  std::vector<size_t> chunkLines(numChunks, 0);
+  std::vector<size_t> chunkCols(numChunks, 0);
+  std::vector<char> chunkEnded(numChunks, 0);
+
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    const char* end = data + bounds[c + 1];
+    for (const char* line = data + bounds[c]; line < end;
+         line = NextLine(line, end))
+    {
+      const char* lineEnd = LineEnd(line, end);
+      if (lineEnd == line)
+      {
+        chunkEnded[c] = 1;
+        break;
+      }
+
+      const size_t cols = std::count(line, lineEnd, ',') + 1;
+      chunkCols[c] = std::max(chunkCols[c], cols);
+      ++chunkLines[c];
+    }
+  }
+
+  // Find the first row of each chunk.
+  std::vector<size_t> firstRow(numChunks + 1, 0);
+  size_t usedChunks = 0, cols = 0;
+  while (usedChunks < numChunks)
+  {
+    firstRow[usedChunks + 1] = firstRow[usedChunks] + chunkLines[usedChunks];
+    cols = std::max(cols, chunkCols[usedChunks]);
+    if (chunkEnded[usedChunks++])
+      break;
+  }
+  const size_t rows = firstRow[usedChunks];
+
+  // When transposing, each line is a column of the matrix, so the threads
+  // write to separate contiguous blocks of memory.
+  if (transpose)
+    x.set_size(cols, rows);
+  else
+    x.set_size(rows, cols);
+
+  // Second pass: convert the tokens.  The first failure of each chunk is
+  // recorded, so that the first failure of the file can be reported.
+  std::vector<std::string> failedToken(usedChunks);
+  std::vector<size_t> failedRow(usedChunks, rows);
+  std::vector<size_t> failedCol(usedChunks, 0);
+
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t c = 0; c < usedChunks; ++c)
+  {
+    const char* end = data + bounds[c + 1];
+    const char* line = data + bounds[c];
+    for (size_t row = firstRow[c]; row < firstRow[c + 1]; ++row)
+    {
+      const char* lineEnd = LineEnd(line, end);
+      size_t col = 0;
+      for (const char* token = line; col < cols; ++col)
+      {
+        const char* tokenEnd = (const char*) std::memchr(token, ',',
+            lineEnd - token);
+        if (tokenEnd == NULL)
+          tokenEnd = lineEnd;
+
+        eT val;
+        if (!ConvertToken(val, token, tokenEnd))
+        {
+          failedToken[c] = std::string(token, tokenEnd);
+          failedRow[c] = row;
+          failedCol[c] = col;
+          break;
+        }
+
+        if (transpose)
+          x.at(col, row) = val;
+        else
+          x.at(row, col) = val;
+
+        if (tokenEnd == lineEnd)
+        {
+          ++col;
+          break;
+        }
+        token = tokenEnd + 1;
+      }
+
+      if (failedRow[c] != rows)
+        break;
+
+      // Fill the missing elements of short lines with 0.
+      for (; col < cols; ++col)
+      {
+        if (transpose)
+          x.at(col, row) = eT(0);
+        else
+          x.at(row, col) = eT(0);
+      }
+
+      line = NextLine(line, end);
+    }
+  }
+
+  for (size_t c = 0; c < usedChunks; ++c)
+  {
+    if (failedRow[c] != rows)
+    {
+      // Printing failed token and it's location.
+      Log::Warn << "Failed to convert token " << failedToken[c] << ", at row "
+          << failedRow[c] << ", column " << failedCol[c] << " of matrix!";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+inline void LoadCSV::SplitCategoricalLine(const char* begin,
+                                          const char* end,
+                                          std::vector<std::string>& tokens)
+    const
+{
+  // Split the line as NonTransposeParse() and TransposeParse() do: each token
+  // is trimmed, and a token that starts with a quote extends to the next token
+  // that ends with a quote.
+  tokens.clear();
+  const char* piece = begin;
+  bool last = false;
+  while (!last)
+  {
+    const char* pieceEnd = (const char*) std::memchr(piece, delim,
+        end - piece);
+    last = (pieceEnd == NULL);
+    if (last)
+      pieceEnd = end;
+
+    std::string token(piece, pieceEnd);
+    Trim(token);
+    piece = pieceEnd + 1;
+
+    if (!token.empty() && token[0] == '"' && token.back() != '"')
+    {
+      std::string rawPiece = token;
+      while (!last && (rawPiece.empty() || rawPiece.back() != '"'))
+      {
+        pieceEnd = (const char*) std::memchr(piece, delim, end - piece);
+        last = (pieceEnd == NULL);
+        if (last)
+          pieceEnd = end;
+
+        rawPiece.assign(piece, pieceEnd);
+        token += delim;
+        token += rawPiece;
+        piece = pieceEnd + 1;
+      }
+    }
+
+    tokens.push_back(std::move(token));
+  }
+}
+
+inline size_t LoadCSV::InternedTokenHash::operator()(
+    const InternedToken& token) const
+{
+  // FNV-1a hash of the characters, starting from the key.
+  uint64_t hash = 14695981039346656037ULL ^ (uint64_t) token.key;
+  const char* c = arena->data() + token.offset;
+  for (size_t i = 0; i < token.length; ++i)
+    hash = (hash ^ (uint64_t) (unsigned char) c[i]) * 1099511628211ULL;
+
+  return (size_t) hash;
+}
+
+inline bool LoadCSV::InternedTokenEqual::operator()(
+    const InternedToken& a,
+    const InternedToken& b) const
+{
+  return (a.key == b.key && a.length == b.length &&
+      std::memcmp(arena->data() + a.offset, arena->data() + b.offset,
+      a.length) == 0);
+}
+
+template<typename T, typename PolicyType>
+void LoadCSV::ParallelCategoricalParse(arma::Mat<T>& inout,
+                                       DatasetMapper<PolicyType>& infoSet,
+                                       const MappedFile& file,
+                                       const bool transpose)
+{
+  const char* data = file.Data();
+  const std::vector<size_t> bounds = LineChunks(data, file.Size());
+  const size_t numChunks = bounds.size() - 1;
+
+  // With IncrementPolicy, a dimension whose distinct tokens are all numbers
+  // stays numeric, and its tokens are their values; so the numbers are
+  // converted while the tokens are split, and such dimensions are not mapped
+  // at all.  FastConvertToken() gives the same values as a stringstream for
+  // doubles only.
+  const bool fastNumbers = std::is_same<T, double>::value &&
+      MapsNumbersToValues(infoSet.Policy());
+
+  // The tokens of each chunk are split in parallel.  The tokens of a chunk are
+  // stored as indices into the list of distinct tokens of their dimension in
+  // the chunk, in order of first appearance.  A dimension is a token position
+  // on a line if the matrix is transposed, and a line otherwise.  The
+  // characters of the distinct tokens of a chunk are stored one after the
+  // other in the arena of the chunk, so that each distinct token is only
+  // allocated once.
+  std::vector<size_t> chunkLines(numChunks, 0);
+  std::vector<std::vector<size_t>> lineTokens(numChunks);
+  std::vector<std::vector<size_t>> tokenIds(numChunks);
+  std::vector<std::string> arenas(numChunks);
+  std::vector<std::vector<std::vector<InternedToken>>> distinct(numChunks);
+  // The values of the distinct tokens, and whether they are all numbers, if
+  // fastNumbers is true.
+  std::vector<std::vector<std::vector<T>>> numbers(numChunks);
+  std::vector<std::vector<char>> allNumbers(numChunks);
+
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    std::vector<std::string> tokens;
+
+    #pragma omp for schedule(dynamic)
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      std::string& arena = arenas[c];
+      std::unordered_map<InternedToken, size_t, InternedTokenHash,
+          InternedTokenEqual> ids(1024, InternedTokenHash{ &arena },
+          InternedTokenEqual{ &arena });
+
+      const char* end = data + bounds[c + 1];
+      for (const char* line = data + bounds[c]; line < end;
+           line = NextLine(line, end))
+      {
+        // Skip empty lines.
+        const char* lineEnd = LineEnd(line, end);
+        std::string trimmed(line, lineEnd);
+        Trim(trimmed);
+        if (trimmed.empty())
+          continue;
+
+        SplitCategoricalLine(trimmed.data(), trimmed.data() + trimmed.size(),
+            tokens);
+        lineTokens[c].push_back(tokens.size());
+
+        for (size_t t = 0; t < tokens.size(); ++t)
+        {
+          const size_t key = transpose ? t : chunkLines[c];
+          if (key >= distinct[c].size())
+          {
+            distinct[c].resize(key + 1);
+            if (fastNumbers)
+            {
+              numbers[c].resize(key + 1);
+              allNumbers[c].resize(key + 1, 1);
+            }
+          }
+
+          // Intern the token: its characters are appended to the arena, and
+          // removed again if the token has already been seen.
+          const InternedToken token = { key, arena.size(), tokens[t].size() };
+          arena.append(tokens[t]);
+          auto it = ids.find(token);
+          if (it != ids.end())
+          {
+            arena.resize(token.offset);
+          }
+          else
+          {
+            it = ids.emplace(token, distinct[c][key].size()).first;
+            distinct[c][key].push_back(token);
+
+            if (fastNumbers)
+            {
+              T value = T(0);
+              if (!FastConvertToken(value, tokens[t].data(),
+                  tokens[t].data() + tokens[t].size()))
+                allNumbers[c][key] = 0;
+              numbers[c][key].push_back(value);
+            }
+          }
+          tokenIds[c].push_back(it->second);
+        }
+
+        ++chunkLines[c];
+      }
+    }
+  }
+
+  // Find the size of the matrix, and check that every line has the same
+  // number of tokens.
+  size_t lines = 0, maxTokens = 0;
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    lines += chunkLines[c];
+    for (size_t l = 0; l < lineTokens[c].size(); ++l)
+      maxTokens = std::max(maxTokens, lineTokens[c][l]);
+  }
+
+  size_t line = 0;
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    for (size_t l = 0; l < lineTokens[c].size(); ++l, ++line)
+    {
+      if (lineTokens[c][l] != maxTokens)
+      {
+        std::ostringstream oss;
+        oss << "LoadCSV::" << (transpose ? "TransposeParse" :
+            "NonTransposeParse") << "(): wrong number of dimensions ("
+            << lineTokens[c][l] << ") on line " << line << "; should be "
+            << maxTokens << " dimensions.";
+        throw std::runtime_error(oss.str());
+      }
+    }
+  }
+
+  const size_t rows = transpose ? maxTokens : lines;
+  const size_t cols = transpose ? lines : maxTokens;
+  if (infoSet.Dimensionality() == 0)
+  {
+    infoSet.SetDimensionality(rows);
+  }
+  else if (infoSet.Dimensionality() != rows)
+  {
+    std::ostringstream oss;
+    oss << "data::LoadCSV(): given DatasetInfo has dimensionality "
+        << infoSet.Dimensionality() << ", but data has dimensionality "
+        << rows;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Merge step: the distinct tokens of each dimension are mapped in order of
+  // first appearance in the file.  Mapping a token again gives the same value
+  // with policies such as IncrementPolicy and MissingPolicy, so this gives the
+  // same mappings as mapping every token in order.  The dimensions themselves
+  // are mapped in parallel if the policy allows it.
+  std::vector<size_t> firstLine(numChunks + 1, 0);
+  for (size_t c = 0; c < numChunks; ++c)
+    firstLine[c + 1] = firstLine[c] + chunkLines[c];
+
+  std::vector<std::vector<std::vector<T>>> values(numChunks);
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    values[c].resize(distinct[c].size());
+    for (size_t key = 0; key < distinct[c].size(); ++key)
+      values[c][key].resize(distinct[c][key].size());
+  }
+
+  infoSet.MapDimensions([&](const size_t dim)
+  {
+    // The tokens of a dimension are in every chunk if the matrix is
+    // transposed, and in the chunk that holds the line otherwise.
+    size_t firstChunk = 0, lastChunk = numChunks;
+    if (!transpose)
+    {
+      firstChunk = (std::upper_bound(firstLine.begin(), firstLine.end(), dim) -
+          firstLine.begin()) - 1;
+      lastChunk = firstChunk + 1;
+    }
+
+    bool numeric = fastNumbers && (infoSet.Type(dim) == Datatype::numeric);
+    for (size_t c = firstChunk; c < lastChunk && numeric; ++c)
+    {
+      const size_t key = transpose ? dim : dim - firstLine[c];
+      if (key < distinct[c].size() && !allNumbers[c][key])
+        numeric = false;
+    }
+
+    for (size_t c = firstChunk; c < lastChunk; ++c)
+    {
+      const size_t key = transpose ? dim : dim - firstLine[c];
+      if (key >= distinct[c].size())
+        continue;
+
+      if (numeric)
+      {
+        values[c][key].swap(numbers[c][key]);
+      }
+      else if (PolicyType::NeedsFirstPass)
+      {
+        for (const InternedToken& token : distinct[c][key])
+        {
+          infoSet.template MapFirstPass<T>(
+              arenas[c].substr(token.offset, token.length), dim);
+        }
+      }
+    }
+
+    if (numeric)
+      return;
+
+    for (size_t c = firstChunk; c < lastChunk; ++c)
+    {
+      const size_t key = transpose ? dim : dim - firstLine[c];
+      if (key >= distinct[c].size())
+        continue;
+
+      for (size_t i = 0; i < distinct[c][key].size(); ++i)
+      {
+        const InternedToken& token = distinct[c][key][i];
+        values[c][key][i] = infoSet.template MapString<T>(
+            arenas[c].substr(token.offset, token.length), dim);
+      }
+    }
+  });
+
+  // The tokens are not needed anymore.
+  std::vector<std::string>().swap(arenas);
+  std::vector<std::vector<std::vector<InternedToken>>>().swap(distinct);
+
+  // Write the mapped values into the matrix in parallel.
+  inout.set_size(rows, cols);
+
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    size_t k = 0;
+    for (size_t l = 0; l < chunkLines[c]; ++l)
+    {
+      for (size_t t = 0; t < maxTokens; ++t, ++k)
+      {
+        const size_t key = transpose ? t : l;
+        const T value = values[c][key][tokenIds[c][k]];
+        if (transpose)
+          inout(t, firstLine[c] + l) = value;
+        else
+          inout(firstLine[c] + l, t) = value;
+      }
+    }
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -42,6 +42,10 @@ class IncrementPolicy
   //! We do need a first pass over the data to set the dimension types right.
   static const bool NeedsFirstPass = true;
 
+  //! Each dimension is mapped independently of the other dimensions, so
+  //! different dimensions can be mapped in parallel.
+  static const bool IndependentDimensions = true;
+
   /**
    * Determine if the dimension is numeric or categorical.
    */
@@ -142,6 +146,9 @@ class IncrementPolicy
     }
   }
 
+  //! Get whether all inputs are mapped, even those that are numbers.
+  bool ForceAllMappings() const { return forceAllMappings; }
+
  private:
   // Whether or not we should map all tokens.
   bool forceAllMappings;
@@ -55,6 +55,10 @@ class MissingPolicy
   //! This doesn't need a first pass over the data to set up.
   static const bool NeedsFirstPass = false;
 
+  //! Each dimension is mapped independently of the other dimensions, so
+  //! different dimensions can be mapped in parallel.
+  static const bool IndependentDimensions = true;
+
   /**
    * There is nothing for us to do here, but this is required by the MapPolicy
    * type.
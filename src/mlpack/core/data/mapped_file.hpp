@@ -0,0 +1,305 @@
+/**
+ * @file core/data/mapped_file.hpp
+ *
+ * The MappedFile class, which maps a file into memory so that objects saved
+ * with data::SaveMapped() can be loaded without copying their matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_FILE_HPP
+#define MLPACK_CORE_DATA_MAPPED_FILE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <cstring>
+#include <streambuf>
+
+#ifndef _WIN32
+  #include <cerrno>
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A MappedFile holds the contents of a file mapped into memory.  The mapping
+ * is private and copy-on-write: every process that maps the same file shares
+ * the same physical pages (through the page cache) until one of them writes to
+ * a page, and nothing is ever written back to the file.  Pages are only read
+ * from disk when they are first accessed, so opening even a very large file is
+ * almost instantaneous.
+ *
+ * Objects loaded with data::LoadMapped() refer to the memory of the MappedFile
+ * they were loaded from, so the MappedFile must outlive them.
+ *
+ * A file can also be mapped read-only, so that the pages are always shared;
+ * writing to the mapped memory then crashes the process instead of copying the
+ * page.
+ *
+ * On Windows, the file is read into memory instead, so objects can still be
+ * loaded but the memory is not shared between processes.
+ */
+class MappedFile
+{
+ public:
+  //! Create an empty MappedFile, which does not map anything.
+  MappedFile() : data(NULL), size(0), readOnly(false) { }
+
+  /**
+   * Map the given file into memory.  A std::runtime_error is thrown if the
+   * file cannot be opened or mapped.
+   *
+   * @param filename Name of the file to map.
+   * @param readOnly If true, the mapped memory cannot be written to.
+   */
+  MappedFile(const std::string& filename, const bool readOnly = false) :
+      data(NULL),
+      size(0),
+      readOnly(false)
+  {
+    Open(filename, readOnly);
+  }
+
+  //! Take ownership of the mapping of the given MappedFile.
+  MappedFile(MappedFile&& other) :
+      data(other.data),
+      size(other.size),
+      readOnly(other.readOnly)
+  {
+    other.data = NULL;
+    other.size = 0;
+  #ifdef _WIN32
+    buffer = std::move(other.buffer);
+  #endif
+  }
+
+  //! Take ownership of the mapping of the given MappedFile.
+  MappedFile& operator=(MappedFile&& other)
+  {
+    if (this != &other)
+    {
+      Close();
+      data = other.data;
+      size = other.size;
+      readOnly = other.readOnly;
+      other.data = NULL;
+      other.size = 0;
+    #ifdef _WIN32
+      buffer = std::move(other.buffer);
+    #endif
+    }
+
+    return *this;
+  }
+
+  // A mapping cannot be copied.
+  MappedFile(const MappedFile& other) = delete;
+  MappedFile& operator=(const MappedFile& other) = delete;
+
+  //! Unmap the file.
+  ~MappedFile() { Close(); }
+
+  /**
+   * Map the given file into memory, unmapping the file that was mapped before
+   * (if any).  A std::runtime_error is thrown if the file cannot be opened or
+   * mapped.
+   *
+   * @param filename Name of the file to map.
+   * @param readOnly If true, the mapped memory cannot be written to.
+   */
+  void Open(const std::string& filename, const bool readOnly = false)
+  {
+    Close();
+
+  #ifdef _WIN32
+    std::ifstream ifs(filename, std::ifstream::in | std::ifstream::binary);
+    if (!ifs.is_open())
+    {
+      throw std::runtime_error("MappedFile::Open(): cannot open '" + filename +
+          "'");
+    }
+
+    buffer.assign(std::istreambuf_iterator<char>(ifs),
+        std::istreambuf_iterator<char>());
+    if (buffer.empty())
+    {
+      throw std::runtime_error("MappedFile::Open(): '" + filename +
+          "' is empty");
+    }
+
+    data = buffer.data();
+    size = buffer.size();
+  #else
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+      throw std::runtime_error("MappedFile::Open(): cannot open '" + filename +
+          "': " + std::strerror(errno));
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size == 0)
+    {
+      close(fd);
+      throw std::runtime_error("MappedFile::Open(): cannot map '" + filename +
+          "': the file is empty or cannot be read");
+    }
+
+    // The mapping stays valid after the file descriptor is closed.
+    void* mapping = mmap(NULL, (size_t) status.st_size,
+        readOnly ? PROT_READ : (PROT_READ | PROT_WRITE), MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+      throw std::runtime_error("MappedFile::Open(): cannot map '" + filename +
+          "': " + std::strerror(errno));
+    }
+
+    data = (char*) mapping;
+    size = (size_t) status.st_size;
+  #endif
+    this->readOnly = readOnly;
+  }
+
+  //! Unmap the file, if one is mapped.
+  void Close()
+  {
+  #ifdef _WIN32
+    buffer.clear();
+    buffer.shrink_to_fit();
+  #else
+    if (data)
+      munmap(data, size);
+  #endif
+
+    data = NULL;
+    size = 0;
+    readOnly = false;
+  }
+
+  //! Return whether a file is mapped.
+  bool IsOpen() const { return (data != NULL); }
+
+  //! Get a pointer to the start of the mapped memory.
+  char* Data() const { return data; }
+  //! Get the size of the mapped memory, in bytes.
+  size_t Size() const { return size; }
+  //! Return whether the mapped memory is read-only.
+  bool ReadOnly() const { return readOnly; }
+
+  //! Return whether the given pointer points into the mapped memory.
+  bool Contains(const void* pointer) const
+  {
+    const char* p = (const char*) pointer;
+    return (data != NULL) && (p >= data) && (p < data + size);
+  }
+
+ private:
+  //! The start of the mapped memory.
+  char* data;
+  //! The size of the mapped memory.
+  size_t size;
+  //! Whether the mapped memory is read-only.
+  bool readOnly;
+#ifdef _WIN32
+  //! The contents of the file, since it is read instead of mapped.
+  std::vector<char> buffer;
+#endif
+};
+
+/**
+ * A read-only std::streambuf over a block of memory, so that the structure of
+ * a mapped file can be read by a cereal archive without being copied.
+ */
+class MemoryStreamBuffer : public std::streambuf
+{
+ public:
+  /**
+   * Create the buffer over the given memory.
+   *
+   * @param data Start of the memory.
+   * @param size Size of the memory, in bytes.
+   */
+  MemoryStreamBuffer(const char* data, const size_t size)
+  {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+
+/**
+ * The header of a file written by data::SaveMapped().  The file consists of
+ * this header, then the elements of every dense matrix of the saved object,
+ * then the rest of the object in cereal's binary format.
+ */
+struct MappedFileHeader
+{
+  //! The magic string identifying the format.
+  static constexpr const char* Magic() { return "MLPKMMAP"; }
+  //! The version of the format.
+  static const uint64_t currentVersion = 1;
+  //! The size reserved for the header at the start of the file, in bytes.
+  static const size_t reservedSize = 64;
+
+  //! The magic string, without terminating zero.
+  char magic[8];
+  //! The version of the format.
+  uint64_t version;
+  //! The offset of the binary structure in the file, in bytes.
+  uint64_t structureOffset;
+  //! The size of the binary structure, in bytes.
+  uint64_t structureSize;
+};
+
+/**
+ * The header of a matrix file written by data::SaveMapped().  The file
+ * consists of this header, padded to a page, then the elements of the matrix in
+ * column-major order, so that the mapped elements are page-aligned.
+ */
+struct MappedMatrixHeader
+{
+  //! The magic string identifying the format.
+  static constexpr const char* Magic() { return "MLPKMMAT"; }
+  //! The version of the format.
+  static const uint64_t currentVersion = 1;
+  //! The size reserved for the header at the start of the file, in bytes.
+  static const size_t reservedSize = 4096;
+
+  /**
+   * Get the code of the kind of the given element type: 'f' for floating-point
+   * types, 'i' for signed integers and 'u' for unsigned integers.
+   */
+  template<typename eT>
+  static char ElemKind()
+  {
+    return std::is_floating_point<eT>::value ? 'f' :
+        (std::is_signed<eT>::value ? 'i' : 'u');
+  }
+
+  //! The magic string, without terminating zero.
+  char magic[8];
+  //! The version of the format.
+  uint64_t version;
+  //! The kind of the elements (see ElemKind()).
+  uint64_t elemKind;
+  //! The size of each element, in bytes.
+  uint64_t elemSize;
+  //! The number of rows of the matrix.
+  uint64_t nRows;
+  //! The number of columns of the matrix.
+  uint64_t nCols;
+  //! The offset of the elements in the file, in bytes.
+  uint64_t dataOffset;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
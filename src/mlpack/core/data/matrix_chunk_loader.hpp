@@ -0,0 +1,104 @@
+/**
+ * @file core/data/matrix_chunk_loader.hpp
+ *
+ * A loader that gives the columns of a matrix held in memory in chunks, with
+ * the same interface as ChunkedLoader, so that algorithms written for chunked
+ * data sources can also process in-memory datasets one block at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MATRIX_CHUNK_LOADER_HPP
+#define MLPACK_CORE_DATA_MATRIX_CHUNK_LOADER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A MatrixChunkLoader gives the columns of a dense or sparse matrix in chunks
+ * of at most a given number of points, as dense matrices of any element type.
+ * It has the same Next(), Reset() and Dimensionality() methods as
+ * ChunkedLoader, so it can be given to any algorithm that reads a dataset with
+ * a ChunkedLoader.  Only one chunk is converted to a dense matrix at a time;
+ * the matrix is not copied, so it must outlive the loader.
+ *
+ * @code
+ * extern arma::sp_mat data;
+ * data::MatrixChunkLoader<arma::sp_mat> loader(data, 1000);
+ * arma::fmat chunk;
+ * while (loader.Next(chunk))
+ * {
+ *   // Process chunk, which has at most 1000 columns.
+ * }
+ * @endcode
+ *
+ * @tparam MatType Type of the matrix (dense or sparse).
+ */
+template<typename MatType>
+class MatrixChunkLoader
+{
+ public:
+  /**
+   * Create a loader for the columns of the given matrix.
+   *
+   * @param data Matrix to read, one point per column.
+   * @param chunkSize Maximum number of points in each chunk.
+   */
+  MatrixChunkLoader(const MatType& data, const size_t chunkSize) :
+      data(data),
+      chunkSize(chunkSize),
+      pointsRead(0)
+  {
+    if (chunkSize == 0)
+    {
+      throw std::invalid_argument("MatrixChunkLoader::MatrixChunkLoader(): "
+          "chunk size must be positive!");
+    }
+  }
+
+  /**
+   * Get the next chunk of points, one point per column.  Returns false when
+   * every point has been read since the last call to Reset().
+   *
+   * @param chunk Matrix to store the next chunk in.
+   * @return Whether a chunk was read.
+   */
+  template<typename eT>
+  bool Next(arma::Mat<eT>& chunk)
+  {
+    if (pointsRead >= data.n_cols)
+      return false;
+
+    const size_t end = std::min(pointsRead + chunkSize, (size_t) data.n_cols);
+    chunk = ConvTo<arma::Mat<eT>>::From(data.cols(pointsRead, end - 1));
+    pointsRead = end;
+    return true;
+  }
+
+  //! Restart reading from the first point.
+  void Reset() { pointsRead = 0; }
+
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return data.n_rows; }
+  //! Get the maximum number of points in each chunk.
+  size_t ChunkSize() const { return chunkSize; }
+  //! Get the number of points read since the last call to Reset().
+  size_t PointsRead() const { return pointsRead; }
+
+ private:
+  //! The matrix to read.
+  const MatType& data;
+  //! Maximum number of points in each chunk.
+  size_t chunkSize;
+  //! Number of points read since the last call to Reset().
+  size_t pointsRead;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -62,6 +62,103 @@ void OneHotEncoding(const arma::Mat<eT>& input,
                     arma::Mat<eT>& output,
                     const data::DatasetInfo& datasetInfo);
 
+/**
+ * Overloaded function for the labels version above, which outputs a sparse
+ * matrix.  The output is built at once from the positions of its ones, so its
+ * cost does not grow with the number of categories.
+ *
+ * @param labelsIn Input labels of arbitrary datatype.
+ * @param output Sparse binary matrix.
+ */
+template<typename RowType, typename eT>
+void OneHotEncoding(const RowType& labelsIn,
+                    arma::SpMat<eT>& output);
+
+/**
+ * Overloaded function for the matrix version above, which outputs a sparse
+ * matrix, so that dimensions with many categories take no more memory than
+ * one element per point.  Numeric dimensions are copied, and their zeros are
+ * not stored.  The sparse output can be given directly to the learners that
+ * accept sparse data, such as LogisticRegression<arma::sp_mat> or LinearSVM.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param output Encoded sparse matrix.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::SpMat<eT>& output);
+
+/**
+ * Overloaded function for the DatasetInfo version above, which outputs a
+ * sparse matrix.
+ *
+ * @param input Input dataset to be encoded.
+ * @param output Encoded sparse matrix.
+ * @param datasetInfo DatasetInfo object that has information about data.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    arma::SpMat<eT>& output,
+                    const data::DatasetInfo& datasetInfo);
+
+/**
+ * Return the number of dimensions of the output of OneHotEncodeChunk() with
+ * the given DatasetInfo: one per numeric dimension, and one per category
+ * (mapping) of each categorical dimension.
+ *
+ * @param datasetInfo DatasetInfo object that has information about data.
+ */
+inline size_t OneHotEncodedDimensionality(const data::DatasetInfo& datasetInfo);
+
+/**
+ * One-hot encode a chunk of a dataset whose categorical dimensions were mapped
+ * with the given DatasetInfo, which is fixed ahead of time (for instance, by a
+ * ChunkedLoader, which maps the whole file before the first chunk).  Unlike
+ * the OneHotEncoding() overloads, which number the categories of each chunk in
+ * the order they appear, category v of a categorical dimension (the value
+ * that the DatasetInfo maps it to) always takes the v'th dimension of its
+ * block, so every chunk is encoded into the same dimensions, and the encoded
+ * chunks can be streamed into a learner:
+ *
+ * @code
+ * data::DatasetInfo info;
+ * data::ChunkedLoader loader("dataset.csv", 100000, info);
+ * arma::mat chunk;
+ * arma::sp_mat encoded;
+ * while (loader.Next(chunk))
+ * {
+ *   data::OneHotEncodeChunk(chunk, encoded, info);
+ *   // Process encoded, which has OneHotEncodedDimensionality(info) rows.
+ * }
+ * @endcode
+ *
+ * A std::invalid_argument is thrown if the chunk does not have the
+ * dimensionality of the DatasetInfo, or if a value of a categorical dimension
+ * is not one of its mappings.
+ *
+ * @param input Chunk to be encoded.
+ * @param output Encoded chunk.
+ * @param datasetInfo DatasetInfo object that the chunk was mapped with.
+ */
+template<typename eT>
+void OneHotEncodeChunk(const arma::Mat<eT>& input,
+                       arma::Mat<eT>& output,
+                       const data::DatasetInfo& datasetInfo);
+
+/**
+ * Overloaded function for the above function, which outputs a sparse matrix.
+ *
+ * @param input Chunk to be encoded.
+ * @param output Encoded sparse chunk.
+ * @param datasetInfo DatasetInfo object that the chunk was mapped with.
+ */
+template<typename eT>
+void OneHotEncodeChunk(const arma::Mat<eT>& input,
+                       arma::SpMat<eT>& output,
+                       const data::DatasetInfo& datasetInfo);
+
 } // namespace data
 } // namespace mlpack
 
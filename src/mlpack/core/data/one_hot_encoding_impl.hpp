@@ -15,6 +15,9 @@
 
 // In case it hasn't been included yet.
 #include "one_hot_encoding.hpp"
+#include <mlpack/core/util/executor.hpp>
+
+#include <exception>
 
 namespace mlpack {
 namespace data {
@@ -66,35 +69,31 @@ void OneHotEncoding(const RowType& labelsIn,
 }
 
 /**
- * Overloaded function for the above function, which takes a matrix as input
- * and also a vector of indices to encode and outputs a matrix.
- * Indices represent the IDs of the dimensions to be one-hot encoded.
+ * Compute the mappings of the values of the dimensions to encode to the index
+ * of their dimension in the one-hot encoded matrix, in the order the values
+ * appear, and the offset of each dimension of the input in the encoded matrix.
  *
  * @param input Input dataset to be encoded.
  * @param indices Index of rows to be encoded.
- * @param output Encoded matrix.
+ * @param dimensionOffsets Set to the cumulative number of encoded dimensions
+ *     of each input dimension, so that dimension i starts at
+ *     dimensionOffsets[i - 1] (and dimension 0 at 0).
+ * @param mappings Set to the mappings of each encoded dimension.
  */
 template<typename eT>
-void OneHotEncoding(const arma::Mat<eT>& input,
-                    const arma::Col<size_t>& indices,
-                    arma::Mat<eT>& output)
+void OneHotEncodingMappings(
+    const arma::Mat<eT>& input,
+    const arma::Col<size_t>& indices,
+    arma::Col<size_t>& dimensionOffsets,
+    std::unordered_map<size_t, std::unordered_map<eT, size_t>>& mappings)
 {
-  // Handle the edge case where there is nothing to encode.
-  if (indices.n_elem == 0)
-  {
-    output = input;
-    return;
-  }
-
-  // First, we need to compute the size of the output matrix.
-
   // This vector will eventually hold the offsets for each dimension in the
   // one-hot encoded matrix, but first it will just hold the counts of
   // dimensions for each dimension.
-  arma::Col<size_t> dimensionOffsets(input.n_rows, arma::fill::ones);
+  dimensionOffsets.ones(input.n_rows);
   // This will hold the mappings from a value that should be one-hot encoded to
   // the index of the dimension it should take.
-  std::unordered_map<size_t, std::unordered_map<eT, size_t>> mappings;
+  mappings.clear();
   for (size_t i = 0; i < indices.n_elem; ++i)
   {
     dimensionOffsets[indices[i]] = 0;
@@ -120,6 +119,106 @@ void OneHotEncoding(const arma::Mat<eT>& input,
   // dimension *2* (not 1).
   for (size_t i = 1; i < dimensionOffsets.n_elem; ++i)
     dimensionOffsets[i] += dimensionOffsets[i - 1];
+}
+
+/**
+ * Build a sparse one-hot encoded matrix straight into its compressed sparse
+ * column arrays: the non-zero elements of each column are counted, and then
+ * written, in parallel.  Dimension r of the input starts at dimension
+ * offsets[r] of the output; if encoded[r] is true, its value v is encoded as a
+ * one in dimension offsets[r] + category(r, v), and otherwise non-zero values
+ * are copied.
+ */
+template<typename eT, typename CategoryFunction>
+void OneHotEncodingSparse(const arma::Mat<eT>& input,
+                          const std::vector<size_t>& offsets,
+                          const std::vector<char>& encoded,
+                          const size_t outputDimensionality,
+                          const CategoryFunction& category,
+                          arma::SpMat<eT>& output)
+{
+  arma::uvec colPtrs(input.n_cols + 1);
+  colPtrs[0] = 0;
+
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t col = 0; col < input.n_cols; ++col)
+  {
+    size_t nonZeros = 0;
+    for (size_t row = 0; row < input.n_rows; ++row)
+      if (encoded[row] || input(row, col) != eT(0))
+        ++nonZeros;
+    colPtrs[col + 1] = nonZeros;
+  }
+
+  for (size_t col = 0; col < input.n_cols; ++col)
+    colPtrs[col + 1] += colPtrs[col];
+
+  arma::uvec rowIndices(colPtrs[input.n_cols]);
+  arma::Col<eT> values(colPtrs[input.n_cols]);
+
+  std::exception_ptr error;
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t col = 0; col < input.n_cols; ++col)
+  {
+    try
+    {
+      size_t k = colPtrs[col];
+      for (size_t row = 0; row < input.n_rows; ++row)
+      {
+        if (encoded[row])
+        {
+          rowIndices[k] = offsets[row] + category(row, input(row, col));
+          values[k++] = eT(1);
+        }
+        else if (input(row, col) != eT(0))
+        {
+          rowIndices[k] = offsets[row];
+          values[k++] = input(row, col);
+        }
+      }
+    }
+    catch (...)
+    {
+      #pragma omp critical
+      {
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+
+  output = arma::SpMat<eT>(rowIndices, colPtrs, values, outputDimensionality,
+      input.n_cols);
+}
+
+/**
+ * Overloaded function for the above function, which takes a matrix as input
+ * and also a vector of indices to encode and outputs a matrix.
+ * Indices represent the IDs of the dimensions to be one-hot encoded.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param output Encoded matrix.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::Mat<eT>& output)
+{
+  // Handle the edge case where there is nothing to encode.
+  if (indices.n_elem == 0)
+  {
+    output = input;
+    return;
+  }
+
+  // First, we need to compute the size of the output matrix.
+  arma::Col<size_t> dimensionOffsets;
+  std::unordered_map<size_t, std::unordered_map<eT, size_t>> mappings;
+  OneHotEncodingMappings(input, indices, dimensionOffsets, mappings);
 
   // Now, initialize the output matrix to the right size.
   output.zeros(dimensionOffsets[dimensionOffsets.n_elem - 1], input.n_cols);
@@ -169,6 +268,183 @@ void OneHotEncoding(const arma::Mat<eT>& input,
   OneHotEncoding(input, arma::Col<size_t>(indices), output);
 }
 
+template<typename RowType, typename eT>
+void OneHotEncoding(const RowType& labelsIn,
+                    arma::SpMat<eT>& output)
+{
+  // Map the labels in the order they appear, as for dense output, and build
+  // the output from the positions of its ones.
+  std::unordered_map<typename RowType::elem_type, size_t> labelMap;
+  arma::umat locations(2, labelsIn.n_elem);
+  for (size_t i = 0; i < labelsIn.n_elem; ++i)
+  {
+    const auto it = labelMap.insert(std::make_pair(labelsIn[i],
+        labelMap.size())).first;
+    locations(0, i) = it->second;
+    locations(1, i) = i;
+  }
+
+  output = arma::SpMat<eT>(locations, arma::ones<arma::Col<eT>>(
+      labelsIn.n_elem), labelMap.size(), labelsIn.n_elem);
+}
+
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::SpMat<eT>& output)
+{
+  arma::Col<size_t> dimensionOffsets;
+  std::unordered_map<size_t, std::unordered_map<eT, size_t>> mappings;
+  OneHotEncodingMappings(input, indices, dimensionOffsets, mappings);
+
+  std::vector<size_t> offsets(input.n_rows, 0);
+  std::vector<char> encoded(input.n_rows, 0);
+  for (size_t row = 0; row < input.n_rows; ++row)
+  {
+    offsets[row] = (row == 0) ? 0 : dimensionOffsets[row - 1];
+    encoded[row] = (mappings.count(row) != 0);
+  }
+
+  // Only look the mappings up, so that they can be read in parallel.
+  const size_t outputDimensionality = (dimensionOffsets.n_elem == 0) ? 0 :
+      dimensionOffsets[dimensionOffsets.n_elem - 1];
+  OneHotEncodingSparse(input, offsets, encoded, outputDimensionality,
+      [&mappings](const size_t row, const eT value)
+      {
+        return mappings.at(row).at(value);
+      }, output);
+}
+
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    arma::SpMat<eT>& output,
+                    const data::DatasetInfo& datasetInfo)
+{
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+  {
+    if (datasetInfo.Type(i) == data::Datatype::categorical)
+    {
+      indices.push_back(i);
+    }
+  }
+  OneHotEncoding(input, arma::Col<size_t>(indices), output);
+}
+
+inline size_t OneHotEncodedDimensionality(const data::DatasetInfo& datasetInfo)
+{
+  size_t dimensionality = 0;
+  for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+  {
+    dimensionality += (datasetInfo.Type(i) == data::Datatype::categorical) ?
+        datasetInfo.NumMappings(i) : 1;
+  }
+  return dimensionality;
+}
+
+/**
+ * Compute the offset of each dimension of a chunk in its one-hot encoding with
+ * the given fixed DatasetInfo, and whether it is encoded, checking that the
+ * chunk has the dimensionality of the DatasetInfo.
+ */
+template<typename eT>
+void OneHotEncodeChunkOffsets(const arma::Mat<eT>& input,
+                              const data::DatasetInfo& datasetInfo,
+                              std::vector<size_t>& offsets,
+                              std::vector<char>& encoded)
+{
+  if (input.n_rows != datasetInfo.Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "data::OneHotEncodeChunk(): chunk has " << input.n_rows
+        << " dimensions, but the DatasetInfo has dimensionality "
+        << datasetInfo.Dimensionality() << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  offsets.assign(input.n_rows, 0);
+  encoded.assign(input.n_rows, 0);
+  size_t offset = 0;
+  for (size_t row = 0; row < input.n_rows; ++row)
+  {
+    offsets[row] = offset;
+    encoded[row] = (datasetInfo.Type(row) == data::Datatype::categorical);
+    offset += encoded[row] ? datasetInfo.NumMappings(row) : 1;
+  }
+}
+
+/**
+ * Return the category of the given value of a categorical dimension mapped
+ * with the given DatasetInfo, or throw a std::invalid_argument if it is not
+ * one of the mappings of the dimension.
+ */
+template<typename eT>
+size_t OneHotEncodeChunkCategory(const data::DatasetInfo& datasetInfo,
+                                 const size_t dimension,
+                                 const eT value)
+{
+  // A category is a non-negative integer smaller than the number of mappings
+  // (NaN fails the comparisons).
+  const double category = double(value);
+  if (!(category >= 0.0 &&
+        category < double(datasetInfo.NumMappings(dimension)) &&
+        category == std::floor(category)))
+  {
+    std::ostringstream oss;
+    oss << "data::OneHotEncodeChunk(): value " << value << " of categorical "
+        << "dimension " << dimension << " is not one of its "
+        << datasetInfo.NumMappings(dimension) << " mappings in the "
+        << "DatasetInfo!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  return size_t(category);
+}
+
+template<typename eT>
+void OneHotEncodeChunk(const arma::Mat<eT>& input,
+                       arma::Mat<eT>& output,
+                       const data::DatasetInfo& datasetInfo)
+{
+  std::vector<size_t> offsets;
+  std::vector<char> encoded;
+  OneHotEncodeChunkOffsets(input, datasetInfo, offsets, encoded);
+
+  output.zeros(OneHotEncodedDimensionality(datasetInfo), input.n_cols);
+  for (size_t col = 0; col < input.n_cols; ++col)
+  {
+    for (size_t row = 0; row < input.n_rows; ++row)
+    {
+      if (encoded[row])
+      {
+        output(offsets[row] + OneHotEncodeChunkCategory(datasetInfo, row,
+            input(row, col)), col) = eT(1);
+      }
+      else
+      {
+        output(offsets[row], col) = input(row, col);
+      }
+    }
+  }
+}
+
+template<typename eT>
+void OneHotEncodeChunk(const arma::Mat<eT>& input,
+                       arma::SpMat<eT>& output,
+                       const data::DatasetInfo& datasetInfo)
+{
+  std::vector<size_t> offsets;
+  std::vector<char> encoded;
+  OneHotEncodeChunkOffsets(input, datasetInfo, offsets, encoded);
+
+  OneHotEncodingSparse(input, offsets, encoded,
+      OneHotEncodedDimensionality(datasetInfo),
+      [&datasetInfo](const size_t row, const eT value)
+      {
+        return OneHotEncodeChunkCategory(datasetInfo, row, value);
+      }, output);
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -0,0 +1,115 @@
+/**
+ * @file core/data/pack_binary.hpp
+ *
+ * Defines PackBinary() and UnpackBinary(), which convert binary codes stored
+ * with one bit per element into codes with many bits per element, as used by
+ * the HammingDistance.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_PACK_BINARY_HPP
+#define MLPACK_CORE_DATA_PACK_BINARY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Return the number of bits of a binary code that PackBinary() stores in each
+ * element of type eT.  This is the number of bits of the largest integer that
+ * eT holds exactly: 53 for double, 24 for float, and 64 for arma::u64.
+ */
+template<typename eT>
+constexpr size_t BitsPerPackedElement()
+{
+  return (size_t) std::numeric_limits<eT>::digits;
+}
+
+/**
+ * Pack binary codes, stored with one bit per element (each nonzero element is
+ * a 1 bit), into codes with BitsPerPackedElement<U>() bits per element.  Bit j
+ * of a code goes to bit (j % BitsPerPackedElement<U>()) of element
+ * (j / BitsPerPackedElement<U>()); the unused bits of the last element are 0.
+ * Each element of the output is a nonnegative integer, so the packed codes can
+ * be copied, saved and loaded like any other matrix.
+ *
+ * @code
+ * arma::mat codes = loadCodes(); // 256 x n, with values 0 or 1.
+ * arma::mat packed;
+ *
+ * // packed is 5 x n (256 bits in elements of 53 bits).
+ * data::PackBinary(codes, packed);
+ * @endcode
+ *
+ * @param input Binary codes to pack, one code per column.
+ * @param output Matrix to store the packed codes in.
+ */
+template<typename T, typename U>
+void PackBinary(const arma::Mat<T>& input, arma::Mat<U>& output)
+{
+  const size_t bits = BitsPerPackedElement<U>();
+  output.zeros((input.n_rows + bits - 1) / bits, input.n_cols);
+
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t i = 0; i < (size_t) input.n_cols; ++i)
+  {
+    for (size_t e = 0; e < output.n_rows; ++e)
+    {
+      const size_t end = std::min((size_t) input.n_rows, (e + 1) * bits);
+      uint64_t word = 0;
+      for (size_t j = e * bits; j < end; ++j)
+      {
+        if (input(j, i) != T(0))
+          word |= (uint64_t(1) << (j - e * bits));
+      }
+
+      output(e, i) = (U) word;
+    }
+  }
+}
+
+/**
+ * Unpack binary codes that were packed with PackBinary() into codes with one
+ * bit (0 or 1) per element.
+ *
+ * @param input Packed binary codes, one code per column.
+ * @param output Matrix to store the unpacked codes in.
+ * @param dimensionality Number of bits of each code.
+ */
+template<typename T, typename U>
+void UnpackBinary(const arma::Mat<U>& input,
+                  arma::Mat<T>& output,
+                  const size_t dimensionality)
+{
+  const size_t bits = BitsPerPackedElement<U>();
+  if (dimensionality > input.n_rows * bits)
+  {
+    std::ostringstream oss;
+    oss << "data::UnpackBinary(): cannot unpack " << dimensionality
+        << " bits from codes of " << input.n_rows << " elements of " << bits
+        << " bits!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  output.set_size(dimensionality, input.n_cols);
+
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t i = 0; i < (size_t) input.n_cols; ++i)
+  {
+    for (size_t j = 0; j < dimensionality; ++j)
+    {
+      const uint64_t word = (uint64_t) input(j / bits, i);
+      output(j, i) = (T) ((word >> (j % bits)) & 1);
+    }
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,301 @@
+/**
+ * @file core/data/prefetching_loader.hpp
+ *
+ * A loader that reads the shards of a dataset from disk with worker threads,
+ * so that the next shards are ready when the current one has been used, and
+ * datasets larger than memory can be used for training.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_PREFETCHING_LOADER_HPP
+#define MLPACK_CORE_DATA_PREFETCHING_LOADER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "load.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A PrefetchingLoader gives the shards of a dataset (each one a matrix of
+ * predictors and a matrix of responses, with one point per column) one after
+ * another, in order.  The shards are read by worker threads with a
+ * user-supplied reader function and then passed through an optional transform
+ * (e.g. data augmentation), while the previous shards are being used; at most
+ * `capacity` shards are held in memory at once (including the one being read
+ * by each worker).
+ *
+ * The reader is called as `reader(i, predictors, responses)` to read shard
+ * `i`; it may be called from several threads at once for different shards.
+ * FileReader() gives a reader for shards stored in matrix files that can be
+ * loaded with data::Load(); for images, something like the following can be
+ * used:
+ *
+ * @code
+ * // imageFiles[i] holds the names of the images of shard i.
+ * std::vector<std::vector<std::string>> imageFiles = ...;
+ * std::vector<std::string> labelFiles = ...;
+ * auto reader = [&](const size_t i, arma::mat& predictors,
+ *                   arma::mat& responses)
+ * {
+ *   data::ImageInfo info;
+ *   data::Load(imageFiles[i], predictors, info, true);
+ *   data::Load(labelFiles[i], responses, true);
+ * };
+ *
+ * data::PrefetchingLoader<arma::mat> loader(imageFiles.size(), reader);
+ * arma::mat predictors, responses;
+ * for (size_t pass = 0; pass < 10; ++pass)
+ * {
+ *   loader.Reset();
+ *   while (loader.Next(predictors, responses))
+ *   {
+ *     // Use the shard.
+ *   }
+ * }
+ * @endcode
+ *
+ * `FFN::Train()` and `RNN::Train()` can be given a PrefetchingLoader directly.
+ * If the reader or the transform throws an exception, it is thrown again by
+ * the call to Next() that would have returned the shard.
+ *
+ * @tparam MatType Type of the predictors and responses of each shard (e.g.
+ *     `arma::mat`, or `arma::cube` for recurrent networks).
+ */
+template<typename MatType = arma::mat>
+class PrefetchingLoader
+{
+ public:
+  //! The type of the function that reads one shard.
+  typedef std::function<void(const size_t, MatType&, MatType&)> ReaderType;
+  //! The type of the function that transforms each shard after it is read.
+  typedef std::function<void(MatType&, MatType&)> TransformType;
+
+  /**
+   * Create the loader, and start reading the first shards.
+   *
+   * @param numShards Number of shards in the dataset.
+   * @param reader Function that reads the given shard.
+   * @param threads Number of worker threads that read shards.
+   * @param capacity Maximum number of shards held in memory at once; it must
+   *     be at least `threads`.
+   * @param transform Function to apply to each shard after it is read (may be
+   *     empty).
+   */
+  PrefetchingLoader(const size_t numShards,
+                    ReaderType reader,
+                    const size_t threads = 2,
+                    const size_t capacity = 4,
+                    TransformType transform = TransformType()) :
+      numShards(numShards),
+      reader(std::move(reader)),
+      transform(std::move(transform)),
+      capacity(capacity),
+      nextShard(0),
+      nextToRead(0),
+      stop(false)
+  {
+    if (threads == 0)
+    {
+      throw std::invalid_argument("PrefetchingLoader::PrefetchingLoader(): "
+          "number of threads must be positive!");
+    }
+
+    if (capacity < threads)
+    {
+      throw std::invalid_argument("PrefetchingLoader::PrefetchingLoader(): "
+          "capacity must be at least the number of threads!");
+    }
+
+    for (size_t i = 0; i < threads; ++i)
+      workers.push_back(std::thread(&PrefetchingLoader::Work, this));
+  }
+
+  //! Stop the worker threads.
+  ~PrefetchingLoader()
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      stop = true;
+    }
+    readable.notify_all();
+    for (size_t i = 0; i < workers.size(); ++i)
+      workers[i].join();
+  }
+
+  // The worker threads point at the loader, so it cannot be copied or moved.
+  PrefetchingLoader(const PrefetchingLoader&) = delete;
+  PrefetchingLoader& operator=(const PrefetchingLoader&) = delete;
+
+  /**
+   * Get the next shard, waiting for it to be read if necessary.  When all the
+   * shards of the pass have been given, false is returned and the matrices are
+   * left unchanged.
+   *
+   * @param predictors Matrix to store the predictors of the shard in.
+   * @param responses Matrix to store the responses of the shard in.
+   * @return true if a shard was given.
+   */
+  bool Next(MatType& predictors, MatType& responses)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (nextShard >= numShards)
+      return false;
+
+    ready.wait(lock, [this]() { return shards.count(nextShard) > 0; });
+    Shard& shard = shards[nextShard];
+    if (shard.error)
+    {
+      std::exception_ptr error = shard.error;
+      shards.erase(nextShard++);
+      readable.notify_all();
+      std::rethrow_exception(error);
+    }
+
+    predictors = std::move(shard.predictors);
+    responses = std::move(shard.responses);
+    shards.erase(nextShard++);
+
+    // There is room for the workers to read one more shard.
+    readable.notify_all();
+    return true;
+  }
+
+  /**
+   * Go back to the first shard, to start a new pass.  The shards of the
+   * current pass that have been read but not given by Next() are discarded.
+   */
+  void Reset()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    // Wait for the workers to finish the shards that they are reading, so that
+    // the shards of the old pass are not mixed up with those of the new pass.
+    ready.wait(lock, [this]() { return reading.empty(); });
+
+    shards.clear();
+    nextShard = 0;
+    nextToRead = 0;
+    readable.notify_all();
+  }
+
+  //! Get the number of shards in the dataset.
+  size_t NumShards() const { return numShards; }
+
+  /**
+   * Get a reader for shards stored in files that can be loaded with
+   * data::Load(): shard `i` is made of the predictors in
+   * `predictorFiles[i]` and the responses in `responseFiles[i]`, each stored
+   * with one point per row.  A std::runtime_error is thrown if a file cannot
+   * be loaded.
+   *
+   * @param predictorFiles Names of the files holding the predictors.
+   * @param responseFiles Names of the files holding the responses.
+   */
+  static ReaderType FileReader(const std::vector<std::string>& predictorFiles,
+                               const std::vector<std::string>& responseFiles)
+  {
+    if (predictorFiles.size() != responseFiles.size())
+    {
+      throw std::invalid_argument("PrefetchingLoader::FileReader(): number of "
+          "predictor files must match the number of response files!");
+    }
+
+    return [predictorFiles, responseFiles](const size_t i,
+                                           MatType& predictors,
+                                           MatType& responses)
+    {
+      Load(predictorFiles[i], predictors, true);
+      Load(responseFiles[i], responses, true);
+    };
+  }
+
+ private:
+  //! A shard that has been read, or the error given while reading it.
+  struct Shard
+  {
+    MatType predictors;
+    MatType responses;
+    std::exception_ptr error;
+  };
+
+  //! Read shards until the loader is destroyed.
+  void Work()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+      // Wait until there is a shard to read and room to store it.
+      readable.wait(lock, [this]() { return stop || (nextToRead < numShards &&
+          nextToRead < nextShard + capacity); });
+      if (stop)
+        return;
+
+      const size_t index = nextToRead++;
+      reading.insert(index);
+      lock.unlock();
+
+      Shard shard;
+      try
+      {
+        reader(index, shard.predictors, shard.responses);
+        if (transform)
+          transform(shard.predictors, shard.responses);
+      }
+      catch (...)
+      {
+        shard.error = std::current_exception();
+      }
+
+      lock.lock();
+      reading.erase(index);
+      shards[index] = std::move(shard);
+      ready.notify_all();
+    }
+  }
+
+  //! The number of shards in the dataset.
+  size_t numShards;
+  //! The function that reads a shard.
+  ReaderType reader;
+  //! The function applied to each shard after it is read.
+  TransformType transform;
+  //! The maximum number of shards held at once.
+  size_t capacity;
+
+  //! The index of the next shard given by Next().
+  size_t nextShard;
+  //! The index of the next shard to be read by a worker.
+  size_t nextToRead;
+  //! The shards that have been read but not yet given by Next().
+  std::map<size_t, Shard> shards;
+  //! The shards that are being read by the workers.
+  std::set<size_t> reading;
+  //! If true, the workers must stop.
+  bool stop;
+
+  //! Protects all of the members above.
+  std::mutex mutex;
+  //! Signalled when a shard has been read.
+  std::condition_variable ready;
+  //! Signalled when the workers may be able to read another shard.
+  std::condition_variable readable;
+  //! The worker threads.
+  std::vector<std::thread> workers;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -23,6 +23,7 @@
 #include "image_info.hpp"
 #include "detect_file_type.hpp"
 #include "save_image.hpp"
+#include "mapped_file.hpp"
 
 namespace mlpack {
 namespace data /** Functions to load and save matrices. */ {
@@ -132,10 +133,51 @@ bool Save(const std::string& filename,
           const bool fatal = false,
           format f = format::autodetect);
 
+/**
+ * Save a model to a file that can be loaded with data::LoadMapped().  The file
+ * holds the elements of every dense matrix of the model (such as the dataset
+ * of a tree) as raw, aligned arrays, followed by the rest of the model in
+ * cereal's binary format.  Like binary files, mapped files can only be loaded
+ * on machines with the same architecture as the one they were saved on.
+ *
+ * The name parameter should be specified to indicate the name of the structure
+ * to be saved.  If LoadMapped() is later called on the generated file, the name
+ * used to load should be the same as the name used for this call.
+ *
+ * If the parameter 'fatal' is set to true, then an exception will be thrown in
+ * the event of a save failure.  Otherwise, the method will return false and the
+ * relevant error information will be printed to Log::Warn.
+ */
+template<typename T>
+bool SaveMapped(const std::string& filename,
+                const std::string& name,
+                T& t,
+                const bool fatal = false);
+
+/**
+ * Save a matrix to a file that can be loaded with data::LoadMapped() without
+ * copying its elements.  The file holds a header that describes the matrix
+ * (element type, number of rows and columns), padded to a page, then the
+ * elements of the matrix in column-major order.  The matrix is saved as it is
+ * in memory (it is not transposed).  Like binary files, mapped files can only
+ * be loaded on machines with the same architecture as the one they were saved
+ * on.
+ *
+ * If the parameter 'fatal' is set to true, then an exception will be thrown in
+ * the event of a save failure.  Otherwise, the method will return false and the
+ * relevant error information will be printed to Log::Warn.
+ */
+template<typename eT>
+bool SaveMapped(const std::string& filename,
+                const arma::Mat<eT>& matrix,
+                const bool fatal = false);
+
 } // namespace data
 } // namespace mlpack
 
 // Include implementation.
 #include "save_impl.hpp"
+// Include implementation of SaveMapped().
+#include "save_mapped_impl.hpp"
 
 #endif
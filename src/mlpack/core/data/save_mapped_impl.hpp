@@ -0,0 +1,135 @@
+/**
+ * @file core/data/save_mapped_impl.hpp
+ *
+ * Implementation of SaveMapped(), which saves a model in a format whose
+ * matrices can be loaded without copying them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SAVE_MAPPED_IMPL_HPP
+#define MLPACK_CORE_DATA_SAVE_MAPPED_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "save.hpp"
+
+#include <mlpack/core/cereal/mapped_archive.hpp>
+
+namespace mlpack {
+namespace data {
+
+template<typename T>
+bool SaveMapped(const std::string& filename,
+                const std::string& name,
+                T& t,
+                const bool fatal)
+{
+  std::ofstream ofs(filename, std::ofstream::out | std::ofstream::binary);
+  if (!ofs.is_open())
+  {
+    if (fatal)
+      Log::Fatal << "Unable to open file '" << filename << "' to save object '"
+          << name << "'." << std::endl;
+    else
+      Log::Warn << "Unable to open file '" << filename << "' to save object '"
+          << name << "'." << std::endl;
+
+    return false;
+  }
+
+  try
+  {
+    // Leave room for the header, which can only be filled in at the end.
+    const char zeros[MappedFileHeader::reservedSize] = { 0 };
+    ofs.write(zeros, MappedFileHeader::reservedSize);
+
+    // The matrix data goes straight to the file; the rest of the object is
+    // gathered in memory and written after it.
+    std::ostringstream structure;
+    size_t structureOffset;
+    {
+      cereal::MappedOutputArchive ar(structure, ofs,
+          MappedFileHeader::reservedSize);
+      ar(cereal::make_nvp(name.c_str(), t));
+      structureOffset = ar.DataOffset();
+    }
+
+    const std::string structureBytes = structure.str();
+    ofs.write(structureBytes.data(), structureBytes.size());
+
+    MappedFileHeader header;
+    std::memcpy(header.magic, MappedFileHeader::Magic(), sizeof(header.magic));
+    header.version = MappedFileHeader::currentVersion;
+    header.structureOffset = structureOffset;
+    header.structureSize = structureBytes.size();
+    ofs.seekp(0);
+    ofs.write((const char*) &header, sizeof(MappedFileHeader));
+
+    if (!ofs)
+      throw cereal::Exception("Failed to write to '" + filename + "'.");
+
+    return true;
+  }
+  catch (cereal::Exception& e)
+  {
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
+}
+
+template<typename eT>
+bool SaveMapped(const std::string& filename,
+                const arma::Mat<eT>& matrix,
+                const bool fatal)
+{
+  std::ofstream ofs(filename, std::ofstream::out | std::ofstream::binary);
+  if (!ofs.is_open())
+  {
+    if (fatal)
+      Log::Fatal << "Unable to open file '" << filename << "' to save matrix."
+          << std::endl;
+    else
+      Log::Warn << "Unable to open file '" << filename << "' to save matrix."
+          << std::endl;
+
+    return false;
+  }
+
+  // The header is padded to a page, so that the elements start on a page.
+  std::vector<char> header(MappedMatrixHeader::reservedSize, 0);
+  MappedMatrixHeader* h = (MappedMatrixHeader*) header.data();
+  std::memcpy(h->magic, MappedMatrixHeader::Magic(), sizeof(h->magic));
+  h->version = MappedMatrixHeader::currentVersion;
+  h->elemKind = (uint64_t) MappedMatrixHeader::ElemKind<eT>();
+  h->elemSize = sizeof(eT);
+  h->nRows = matrix.n_rows;
+  h->nCols = matrix.n_cols;
+  h->dataOffset = MappedMatrixHeader::reservedSize;
+
+  ofs.write(header.data(), header.size());
+  ofs.write((const char*) matrix.memptr(), matrix.n_elem * sizeof(eT));
+  if (!ofs)
+  {
+    if (fatal)
+      Log::Fatal << "Failed to write matrix to '" << filename << "'."
+          << std::endl;
+    else
+      Log::Warn << "Failed to write matrix to '" << filename << "'."
+          << std::endl;
+
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
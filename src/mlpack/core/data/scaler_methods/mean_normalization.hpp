@@ -14,6 +14,9 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "scaler_statistics.hpp"
+#include <mlpack/core/util/executor.hpp>
+
 namespace mlpack {
 namespace data {
 
@@ -42,10 +45,19 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * The mean, minimum and maximum are computed in a single parallel pass.  A
+ * dataset that does not fit in memory can be fitted one chunk at a time with
+ * PartialFit(), and scalers fitted on different parts of a dataset can be
+ * combined with Merge().  Transform() and InverseTransform() also have
+ * in-place overloads, which do not allocate another matrix.
  */
 class MeanNormalization
 {
  public:
+  //! Create a scaler that has not been fitted.
+  MeanNormalization() : count(0) { }
+
   /**
    * Function to fit features, to find out the min max and scale.
    *
@@ -54,17 +66,47 @@ class MeanNormalization
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    itemMin = min(input, 1);
-    itemMax = arma::max(input, 1);
-    scale = itemMax - itemMin;
-    // Handling zeros in scale vector.
-    scale.for_each([](arma::vec::elem_type& val) { val =
-        (val == 0) ? 1 : val; });
+    count = 0;
+    PartialFit(input);
+  }
+
+  /**
+   * Update the fitted features with another chunk of the dataset.  Once every
+   * chunk has been given, the scaler is the same (up to rounding) as if Fit()
+   * had been called on the whole dataset.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    if (input.n_cols == 0)
+      return;
+
+    arma::vec chunkMin, chunkMax, chunkSum;
+    FeatureRange(input, chunkMin, chunkMax, &chunkSum);
+    MergeStatistics(input.n_cols, chunkSum / double(input.n_cols), chunkMin,
+        chunkMax, "PartialFit");
+  }
+
+  /**
+   * Merge the features fitted by another scaler (for instance on another chunk
+   * of the dataset) into this one, so that this scaler is fitted on the points
+   * given to both.
+   *
+   * @param other Scaler to merge into this one.
+   */
+  void Merge(const MeanNormalization& other)
+  {
+    if (other.count > 0)
+    {
+      MergeStatistics(other.count, other.itemMean, other.itemMin,
+          other.itemMax, "Merge");
+    }
   }
 
   /**
-   * Function to scale features.
+   * Function to scale features.  The output matrix can be the input matrix.
    *
    * @param input Dataset to scale features.
    * @param output Output matrix with scaled features.
@@ -77,12 +119,32 @@ class MeanNormalization
       throw std::runtime_error("Call Fit() before Transform(), please"
         " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() - itemMean).each_col() / scale;
+    output.set_size(input.n_rows, input.n_cols);
+
+    // Each element only depends on the same element of the input, so the
+    // output is computed in one pass, without temporary matrices.
+    using ElemType = typename MatType::elem_type;
+    #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      const ElemType* in = input.colptr(i);
+      ElemType* out = output.colptr(i);
+      for (size_t j = 0; j < input.n_rows; ++j)
+        out[j] = (in[j] - itemMean[j]) / scale[j];
+    }
   }
 
   /**
-   * Function to retrieve original dataset.
+   * Function to scale features in place.
+   *
+   * @param input Dataset to scale features; it is overwritten.
+   */
+  template<typename MatType>
+  void Transform(MatType& input) { Transform(input, input); }
+
+  /**
+   * Function to retrieve original dataset.  The output matrix can be the input
+   * matrix.
    *
    * @param input Scaled dataset.
    * @param output Output matrix with original Dataset.
@@ -90,10 +152,27 @@ class MeanNormalization
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output.copy_size(input);
-    output = (input.each_col() % scale).each_col() + itemMean;
+    output.set_size(input.n_rows, input.n_cols);
+
+    using ElemType = typename MatType::elem_type;
+    #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      const ElemType* in = input.colptr(i);
+      ElemType* out = output.colptr(i);
+      for (size_t j = 0; j < input.n_rows; ++j)
+        out[j] = in[j] * scale[j] + itemMean[j];
+    }
   }
 
+  /**
+   * Function to retrieve original dataset in place.
+   *
+   * @param input Scaled dataset; it is overwritten with the original dataset.
+   */
+  template<typename MatType>
+  void InverseTransform(MatType& input) { InverseTransform(input, input); }
+
   //! Get the Mean row vector.
   const arma::vec& ItemMean() const { return itemMean; }
   //! Get the Min row vector.
@@ -102,17 +181,63 @@ class MeanNormalization
   const arma::vec& ItemMax() const { return itemMax; }
   //! Get the Scale row vector.
   const arma::vec& Scale() const { return scale; }
+  //! Get the number of points that have been fitted.
+  size_t Count() const { return count; }
 
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */)
+  void serialize(Archive& ar, const uint32_t version)
   {
     ar(CEREAL_NVP(itemMin));
     ar(CEREAL_NVP(itemMax));
     ar(CEREAL_NVP(scale));
     ar(CEREAL_NVP(itemMean));
+
+    // Scalers saved before version 1 cannot be updated with PartialFit() or
+    // Merge(); they are treated as if they had not been fitted.
+    if (cereal::is_loading<Archive>() && version == 0)
+      count = 0;
+    else
+      ar(CEREAL_NVP(count));
   }
 
  private:
+  //! Merge the given statistics of a set of points into the fitted ones, and
+  //! update the scale.
+  void MergeStatistics(const size_t otherCount,
+                       const arma::vec& otherMean,
+                       const arma::vec& otherMin,
+                       const arma::vec& otherMax,
+                       const std::string& function)
+  {
+    if (count == 0)
+    {
+      itemMean = otherMean;
+      itemMin = otherMin;
+      itemMax = otherMax;
+    }
+    else if (otherMean.n_elem != itemMean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "MeanNormalization::" << function << "(): given points have "
+          << otherMean.n_elem << " dimensions, but the scaler was fitted on "
+          << itemMean.n_elem << " dimensions!";
+      throw std::invalid_argument(oss.str());
+    }
+    else
+    {
+      const double total = double(count + otherCount);
+      itemMean += (otherMean - itemMean) * (otherCount / total);
+      itemMin = arma::min(itemMin, otherMin);
+      itemMax = arma::max(itemMax, otherMax);
+    }
+    count += otherCount;
+
+    scale = itemMax - itemMin;
+    // Handling zeros in scale vector.
+    scale.for_each([](arma::vec::elem_type& val) { val =
+        (val == 0) ? 1 : val; });
+  }
+
   // Vector which holds mean of each feature.
   arma::vec itemMean;
   // Vector which holds minimum of each feature.
@@ -121,9 +246,13 @@ class MeanNormalization
   arma::vec itemMax;
   // Vector which is used to scale up each feature.
   arma::vec scale;
+  // Number of points that have been fitted.
+  size_t count;
 }; // class MeanNormalization
 
 } // namespace data
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::data::MeanNormalization, 1);
+
 #endif
@@ -14,6 +14,9 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "scaler_statistics.hpp"
+#include <mlpack/core/util/executor.hpp>
+
 namespace mlpack {
 namespace data {
 
@@ -44,6 +47,12 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * The minimum and maximum are computed in a single parallel pass.  A dataset
+ * that does not fit in memory can be fitted one chunk at a time with
+ * PartialFit(), and scalers fitted on different parts of a dataset can be
+ * combined with Merge().  Transform() and InverseTransform() also have
+ * in-place overloads, which do not allocate another matrix.
  */
 class MinMaxScaler
 {
@@ -73,20 +82,44 @@ class MinMaxScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMin = min(input, 1);
-    itemMax = arma::max(input, 1);
-    scale = itemMax - itemMin;
-    // Handle zeros in scale vector.
-    scale.for_each([](arma::vec::elem_type& val) { val =
-        (val == 0) ? 1 : val; });
-    scale = (scaleMax - scaleMin) / scale;
-    scalerowmin.copy_size(itemMin);
-    scalerowmin.fill(scaleMin);
-    scalerowmin = scalerowmin - itemMin % scale;
+    itemMin.clear();
+    itemMax.clear();
+    PartialFit(input);
   }
 
   /**
-   * Function to scale features.
+   * Update the fitted features with another chunk of the dataset.  Once every
+   * chunk has been given, the scaler is the same as if Fit() had been called on
+   * the whole dataset.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    if (input.n_cols == 0)
+      return;
+
+    arma::vec chunkMin, chunkMax;
+    FeatureRange(input, chunkMin, chunkMax);
+    MergeRange(chunkMin, chunkMax, "PartialFit");
+  }
+
+  /**
+   * Merge the features fitted by another scaler (for instance on another chunk
+   * of the dataset) into this one, so that this scaler is fitted on the points
+   * given to both.  The range of this scaler is kept.
+   *
+   * @param other Scaler to merge into this one.
+   */
+  void Merge(const MinMaxScaler& other)
+  {
+    if (!other.itemMin.is_empty())
+      MergeRange(other.itemMin, other.itemMax, "Merge");
+  }
+
+  /**
+   * Function to scale features.  The output matrix can be the input matrix.
    *
    * @param input Dataset to scale features.
    * @param output Output matrix with scaled features.
@@ -99,12 +132,32 @@ class MinMaxScaler
       throw std::runtime_error("Call Fit() before Transform(), please"
           " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() % scale).each_col() + scalerowmin;
+    output.set_size(input.n_rows, input.n_cols);
+
+    // Each element only depends on the same element of the input, so the
+    // output is computed in one pass, without temporary matrices.
+    using ElemType = typename MatType::elem_type;
+    #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      const ElemType* in = input.colptr(i);
+      ElemType* out = output.colptr(i);
+      for (size_t j = 0; j < input.n_rows; ++j)
+        out[j] = in[j] * scale[j] + scalerowmin[j];
+    }
   }
 
   /**
-   * Function to retrieve original dataset.
+   * Function to scale features in place.
+   *
+   * @param input Dataset to scale features; it is overwritten.
+   */
+  template<typename MatType>
+  void Transform(MatType& input) { Transform(input, input); }
+
+  /**
+   * Function to retrieve original dataset.  The output matrix can be the input
+   * matrix.
    *
    * @param input Scaled dataset.
    * @param output Output matrix with original Dataset.
@@ -112,10 +165,27 @@ class MinMaxScaler
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output.copy_size(input);
-    output = (input.each_col() - scalerowmin).each_col() / scale;
+    output.set_size(input.n_rows, input.n_cols);
+
+    using ElemType = typename MatType::elem_type;
+    #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      const ElemType* in = input.colptr(i);
+      ElemType* out = output.colptr(i);
+      for (size_t j = 0; j < input.n_rows; ++j)
+        out[j] = (in[j] - scalerowmin[j]) / scale[j];
+    }
   }
 
+  /**
+   * Function to retrieve original dataset in place.
+   *
+   * @param input Scaled dataset; it is overwritten with the original dataset.
+   */
+  template<typename MatType>
+  void InverseTransform(MatType& input) { InverseTransform(input, input); }
+
   //! Get the Min row vector.
   const arma::vec& ItemMin() const { return itemMin; }
   //! Get the Max row vector.
@@ -139,6 +209,41 @@ class MinMaxScaler
   }
 
  private:
+  //! Merge the given minimum and maximum of each feature into the fitted ones,
+  //! and update the scale.
+  void MergeRange(const arma::vec& otherMin,
+                  const arma::vec& otherMax,
+                  const std::string& function)
+  {
+    if (itemMin.is_empty())
+    {
+      itemMin = otherMin;
+      itemMax = otherMax;
+    }
+    else if (otherMin.n_elem != itemMin.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "MinMaxScaler::" << function << "(): given points have "
+          << otherMin.n_elem << " dimensions, but the scaler was fitted on "
+          << itemMin.n_elem << " dimensions!";
+      throw std::invalid_argument(oss.str());
+    }
+    else
+    {
+      itemMin = arma::min(itemMin, otherMin);
+      itemMax = arma::max(itemMax, otherMax);
+    }
+
+    scale = itemMax - itemMin;
+    // Handle zeros in scale vector.
+    scale.for_each([](arma::vec::elem_type& val) { val =
+        (val == 0) ? 1 : val; });
+    scale = (scaleMax - scaleMin) / scale;
+    scalerowmin.copy_size(itemMin);
+    scalerowmin.fill(scaleMin);
+    scalerowmin = scalerowmin - itemMin % scale;
+  }
+
   // Vector which holds minimum of each feature.
   arma::vec itemMin;
   // Vector which holds maximum of each feature.
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/ccov.hpp>
+#include <mlpack/methods/randomized_svd/randomized_svd.hpp>
 
 namespace mlpack {
 namespace data {
@@ -42,16 +43,28 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * The full eigendecomposition of the d x d covariance matrix takes O(d^3)
+ * time, which is infeasible for high-dimensional data.  If a rank is given,
+ * only the eigenvectors of the rank largest eigenvalues are computed, with the
+ * randomized SVD of the centered data (see RandomizedSVD), and Transform()
+ * projects the data onto these rank directions, so that the output has rank
+ * rows.  In both cases, Transform() and InverseTransform() process the points
+ * in blocks, and never form a d x d matrix other than the eigenvectors of the
+ * full decomposition.  arma::fmat data is transformed in single precision.
  */
 class PCAWhitening
 {
  public:
   /**
-   * A constructor to set the regularization parameter.
+   * A constructor to set the regularization parameter and, optionally, the
+   * rank of the whitening.
    *
    * @param eps Regularization parameter.
+   * @param rank Number of directions to keep, computed with the randomized
+   *     SVD; 0 keeps all of them, with the full eigendecomposition.
    */
-  PCAWhitening(double eps = 0.00005)
+  PCAWhitening(double eps = 0.00005, const size_t rank = 0) : rank(rank)
   {
     epsilon = eps;
     // Ensure scaleMin is smaller than scaleMax.
@@ -69,10 +82,43 @@ class PCAWhitening
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    // Get eigenvectors and eigenvalues of covariance of input matrix.
-    eig_sym(eigenValues, eigenVectors, ColumnCovariance(
-        input.each_col() - itemMean));
+    typedef typename MatType::elem_type ElemType;
+
+    itemMean = arma::conv_to<arma::vec>::from(arma::mean(input, 1));
+    if (rank == 0)
+    {
+      // Get eigenvectors and eigenvalues of covariance of input matrix.
+      arma::Mat<ElemType> centered = input;
+      centered.each_col() -= arma::conv_to<arma::Col<ElemType>>::from(
+          itemMean);
+      eig_sym(eigenValues, eigenVectors,
+          arma::conv_to<arma::mat>::from(ColumnCovariance(centered)));
+    }
+    else
+    {
+      if (rank > std::min(input.n_rows, input.n_cols))
+      {
+        std::ostringstream oss;
+        oss << "PCAWhitening::Fit(): rank (" << rank << ") must not be greater "
+            << "than the dimensionality or the number of points of the data!";
+        throw std::invalid_argument(oss.str());
+      }
+
+      // The left singular vectors of the centered data are the eigenvectors of
+      // its covariance, and the squared singular values give the eigenvalues.
+      // The randomized SVD centers the data itself.
+      arma::Mat<ElemType> u, v;
+      arma::Col<ElemType> s;
+      RandomizedSVD rsvd;
+      rsvd.Apply(input, u, s, v, rank);
+
+      // Order the eigenvalues increasingly, as eig_sym() does.
+      eigenVectors = arma::fliplr(arma::conv_to<arma::mat>::from(
+          u.head_cols(rank)));
+      const double normalization = std::max((double) input.n_cols - 1, 1.0);
+      eigenValues = arma::flipud(arma::square(arma::conv_to<arma::vec>::from(
+          s.head(rank)))) / normalization;
+    }
     eigenValues += epsilon;
   }
 
@@ -85,15 +131,32 @@ class PCAWhitening
   template<typename MatType>
   void Transform(const MatType& input, MatType& output)
   {
+    typedef typename MatType::elem_type ElemType;
+
     if (eigenValues.is_empty() || eigenVectors.is_empty())
     {
       throw std::runtime_error("Call Fit() before Transform(), please"
           " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() - itemMean);
-    output = arma::diagmat(1.0 / (sqrt(eigenValues))) * eigenVectors.t()
-        * output;
+
+    // Scale the rows of the projection instead of forming a diagonal matrix.
+    arma::Mat<ElemType> projection = arma::conv_to<arma::Mat<ElemType>>::from(
+        eigenVectors.t());
+    projection.each_col() %= arma::conv_to<arma::Col<ElemType>>::from(
+        1.0 / arma::sqrt(eigenValues));
+    const arma::Col<ElemType> mean =
+        arma::conv_to<arma::Col<ElemType>>::from(itemMean);
+
+    // The input and output may be the same matrix.
+    MatType result(projection.n_rows, input.n_cols);
+    for (size_t begin = 0; begin < input.n_cols; begin += BlockSize)
+    {
+      const size_t end = std::min(begin + BlockSize, (size_t) input.n_cols);
+      arma::Mat<ElemType> block = input.cols(begin, end - 1);
+      block.each_col() -= mean;
+      result.cols(begin, end - 1) = projection * block;
+    }
+    output = std::move(result);
   }
 
   /**
@@ -105,9 +168,25 @@ class PCAWhitening
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output = arma::diagmat(sqrt(eigenValues)) * inv(eigenVectors.t())
-        * input;
-    output = (output.each_col() + itemMean);
+    typedef typename MatType::elem_type ElemType;
+
+    // The eigenvectors are orthonormal, so the inverse of their transpose is
+    // themselves.
+    arma::Mat<ElemType> projection = arma::conv_to<arma::Mat<ElemType>>::from(
+        eigenVectors);
+    projection.each_row() %= arma::conv_to<arma::Row<ElemType>>::from(
+        arma::sqrt(eigenValues).t());
+    const arma::Col<ElemType> mean =
+        arma::conv_to<arma::Col<ElemType>>::from(itemMean);
+
+    MatType result(projection.n_rows, input.n_cols);
+    for (size_t begin = 0; begin < input.n_cols; begin += BlockSize)
+    {
+      const size_t end = std::min(begin + BlockSize, (size_t) input.n_cols);
+      result.cols(begin, end - 1) = projection * input.cols(begin, end - 1);
+      result.cols(begin, end - 1).each_col() += mean;
+    }
+    output = std::move(result);
   }
 
   //! Get the mean row vector.
@@ -118,17 +197,29 @@ class PCAWhitening
   const arma::mat& EigenVectors() const { return eigenVectors; }
   //! Get the regularization parameter.
   const double& Epsilon() const { return epsilon; }
+  //! Get the rank of the whitening (0 means full rank).
+  size_t Rank() const { return rank; }
 
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */)
+  void serialize(Archive& ar, const uint32_t version)
   {
     ar(CEREAL_NVP(eigenValues));
     ar(CEREAL_NVP(eigenVectors));
     ar(CEREAL_NVP(itemMean));
     ar(CEREAL_NVP(epsilon));
+
+    // Scalers saved before version 1 were all full rank.
+    if (cereal::is_loading<Archive>() && version == 0)
+      rank = 0;
+    else
+      ar(CEREAL_NVP(rank));
   }
 
  private:
+  //! Number of points transformed at once.
+  static constexpr size_t BlockSize = 4096;
+
+
   // Vector which holds mean of each feature.
   arma::vec itemMean;
   // Mat which hold the eigenvectors.
@@ -137,9 +228,13 @@ class PCAWhitening
   double epsilon;
   // Vector which hold the eigenvalues.
   arma::vec eigenValues;
+  // Number of directions to keep (0 means all of them).
+  size_t rank;
 }; // class PCAWhitening
 
 } // namespace data
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::data::PCAWhitening, 1);
+
 #endif
@@ -0,0 +1,189 @@
+/**
+ * @file core/data/scaler_methods/scaler_statistics.hpp
+ *
+ * Single-pass parallel computation of the statistics of each feature that are
+ * used by the scaler methods, and merging of statistics of several chunks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SCALER_METHODS_SCALER_STATISTICS_HPP
+#define MLPACK_CORE_DATA_SCALER_METHODS_SCALER_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
+
+namespace mlpack {
+namespace data {
+
+//! The largest number of blocks of columns that the statistics are computed
+//! in.
+constexpr size_t ScalerStatisticsMaxBlocks = 64;
+
+/**
+ * Get the number of blocks of columns that the statistics of the given number
+ * of points are computed in: ScalerStatisticsMaxBlocks, or one per point if
+ * there are fewer points, and at least one.  The blocks (and so the rounding
+ * of the results) do not depend on the number of threads.
+ */
+inline size_t ScalerStatisticsBlocks(const size_t numPoints)
+{
+  return std::max(size_t(1), std::min(ScalerStatisticsMaxBlocks, numPoints));
+}
+
+/**
+ * Compute the minimum and the maximum of each feature (row) of the given
+ * dataset, and also the sum of each feature if sum is not NULL.  The dataset
+ * is read once; the threads read blocks of columns.
+ *
+ * @param input Dataset, with one point per column.
+ * @param minimum Vector to store the minimum of each feature into.
+ * @param maximum Vector to store the maximum of each feature into.
+ * @param sum If not NULL, vector to store the sum of each feature into.
+ */
+template<typename MatType>
+void FeatureRange(const MatType& input,
+                  arma::vec& minimum,
+                  arma::vec& maximum,
+                  arma::vec* sum = NULL)
+{
+  using ElemType = typename MatType::elem_type;
+
+  const size_t numBlocks = ScalerStatisticsBlocks(input.n_cols);
+  arma::mat blockMin(input.n_rows, numBlocks);
+  arma::mat blockMax(input.n_rows, numBlocks);
+  arma::mat blockSum(input.n_rows, numBlocks, arma::fill::zeros);
+  blockMin.fill(std::numeric_limits<double>::infinity());
+  blockMax.fill(-std::numeric_limits<double>::infinity());
+
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * input.n_cols / numBlocks;
+    const size_t end = (b + 1) * input.n_cols / numBlocks;
+    double* bMin = blockMin.colptr(b);
+    double* bMax = blockMax.colptr(b);
+    double* bSum = blockSum.colptr(b);
+    for (size_t i = begin; i < end; ++i)
+    {
+      const ElemType* x = input.colptr(i);
+      for (size_t j = 0; j < input.n_rows; ++j)
+      {
+        const double value = x[j];
+        bMin[j] = std::min(bMin[j], value);
+        bMax[j] = std::max(bMax[j], value);
+        bSum[j] += value;
+      }
+    }
+  }
+
+  minimum = arma::min(blockMin, 1);
+  maximum = arma::max(blockMax, 1);
+  if (sum)
+    *sum = arma::sum(blockSum, 1);
+}
+
+/**
+ * Merge the mean and the sum of squared deviations from the mean of each
+ * feature of a set of points with those of another set of points, as in Chan
+ * et al.'s parallel algorithm, so that they become those of both sets.
+ *
+ * @param count Number of points of the first set; set to the total count.
+ * @param mean Mean of each feature of the first set; set to the merged mean.
+ * @param m2 Sum of squared deviations of each feature of the first set; set to
+ *     the merged sum.
+ * @param otherCount Number of points of the second set.
+ * @param otherMean Mean of each feature of the second set.
+ * @param otherM2 Sum of squared deviations of each feature of the second set.
+ */
+inline void MergeFeatureMoments(size_t& count,
+                                arma::vec& mean,
+                                arma::vec& m2,
+                                const size_t otherCount,
+                                const arma::vec& otherMean,
+                                const arma::vec& otherM2)
+{
+  if (otherCount == 0)
+    return;
+
+  if (count == 0)
+  {
+    count = otherCount;
+    mean = otherMean;
+    m2 = otherM2;
+    return;
+  }
+
+  const double total = double(count + otherCount);
+  const arma::vec delta = otherMean - mean;
+  mean += delta * (otherCount / total);
+  m2 += otherM2 + arma::square(delta) * (count * (otherCount / total));
+  count += otherCount;
+}
+
+/**
+ * Compute the mean of each feature (row) of the given dataset and the sum of
+ * squared deviations from the mean, using Welford's algorithm, so that the
+ * dataset is read only once.  The threads read blocks of columns, and the
+ * results of the blocks are merged with MergeFeatureMoments().
+ *
+ * @param input Dataset, with one point per column.
+ * @param mean Vector to store the mean of each feature into.
+ * @param m2 Vector to store the sum of squared deviations of each feature
+ *     into.
+ */
+template<typename MatType>
+void FeatureMoments(const MatType& input, arma::vec& mean, arma::vec& m2)
+{
+  using ElemType = typename MatType::elem_type;
+
+  const size_t numBlocks = ScalerStatisticsBlocks(input.n_cols);
+  arma::mat blockMean(input.n_rows, numBlocks, arma::fill::zeros);
+  arma::mat blockM2(input.n_rows, numBlocks, arma::fill::zeros);
+
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * input.n_cols / numBlocks;
+    const size_t end = (b + 1) * input.n_cols / numBlocks;
+    double* bMean = blockMean.colptr(b);
+    double* bM2 = blockM2.colptr(b);
+    for (size_t i = begin; i < end; ++i)
+    {
+      const ElemType* x = input.colptr(i);
+      const double weight = 1.0 / double(i - begin + 1);
+      for (size_t j = 0; j < input.n_rows; ++j)
+      {
+        const double delta = x[j] - bMean[j];
+        bMean[j] += delta * weight;
+        bM2[j] += delta * (x[j] - bMean[j]);
+      }
+    }
+  }
+
+  // Merge the blocks in order; since the blocks do not depend on the number of
+  // threads, neither does the result.
+  size_t count = 0;
+  mean.clear();
+  m2.clear();
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * input.n_cols / numBlocks;
+    const size_t end = (b + 1) * input.n_cols / numBlocks;
+    MergeFeatureMoments(count, mean, m2, end - begin, blockMean.col(b),
+        blockM2.col(b));
+  }
+
+  if (count == 0)
+  {
+    mean.zeros(input.n_rows);
+    m2.zeros(input.n_rows);
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
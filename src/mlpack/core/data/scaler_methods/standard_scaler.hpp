@@ -14,6 +14,9 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "scaler_statistics.hpp"
+#include <mlpack/core/util/executor.hpp>
+
 namespace mlpack {
 namespace data {
 
@@ -43,10 +46,20 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * The mean and standard deviation are computed in a single parallel pass
+ * (with Welford's algorithm).  A dataset that does not fit in memory can be
+ * fitted one chunk at a time with PartialFit(), and scalers fitted on
+ * different parts of a dataset can be combined with Merge().  Transform() and
+ * InverseTransform() also have in-place overloads, which do not allocate
+ * another matrix.
  */
 class StandardScaler
 {
  public:
+  //! Create a scaler that has not been fitted.
+  StandardScaler() : count(0) { }
+
   /**
    * Function to fit features, to find out the min max and scale.
    *
@@ -55,15 +68,52 @@ class StandardScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    itemStdDev = arma::stddev(input, 1, 1);
-    // Handle zeros in scale vector.
-    itemStdDev.for_each([](arma::vec::elem_type& val) { val =
-        (val == 0) ? 1 : val; });
+    count = 0;
+    itemMean.clear();
+    itemM2.clear();
+    PartialFit(input);
+  }
+
+  /**
+   * Update the fitted features with another chunk of the dataset.  Once every
+   * chunk has been given, the scaler is the same (up to rounding) as if Fit()
+   * had been called on the whole dataset.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    if (input.n_cols == 0)
+      return;
+
+    CheckDimensionality(input.n_rows, "PartialFit");
+    arma::vec mean, m2;
+    FeatureMoments(input, mean, m2);
+    MergeFeatureMoments(count, itemMean, itemM2, input.n_cols, mean, m2);
+    UpdateStdDev();
   }
 
   /**
-   * Function to scale features.
+   * Merge the features fitted by another scaler (for instance on another chunk
+   * of the dataset) into this one, so that this scaler is fitted on the points
+   * given to both.
+   *
+   * @param other Scaler to merge into this one.
+   */
+  void Merge(const StandardScaler& other)
+  {
+    if (other.count == 0)
+      return;
+
+    CheckDimensionality(other.itemMean.n_elem, "Merge");
+    MergeFeatureMoments(count, itemMean, itemM2, other.count, other.itemMean,
+        other.itemM2);
+    UpdateStdDev();
+  }
+
+  /**
+   * Function to scale features.  The output matrix can be the input matrix.
    *
    * @param input Dataset to scale features.
    * @param output Output matrix with scaled features.
@@ -76,12 +126,32 @@ class StandardScaler
       throw std::runtime_error("Call Fit() before Transform(), please"
         " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() - itemMean).each_col() / itemStdDev;
+    output.set_size(input.n_rows, input.n_cols);
+
+    // Each element only depends on the same element of the input, so the
+    // output is computed in one pass, without temporary matrices.
+    using ElemType = typename MatType::elem_type;
+    #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      const ElemType* in = input.colptr(i);
+      ElemType* out = output.colptr(i);
+      for (size_t j = 0; j < input.n_rows; ++j)
+        out[j] = (in[j] - itemMean[j]) / itemStdDev[j];
+    }
   }
 
   /**
-   * Function to retrieve original dataset.
+   * Function to scale features in place.
+   *
+   * @param input Dataset to scale features; it is overwritten.
+   */
+  template<typename MatType>
+  void Transform(MatType& input) { Transform(input, input); }
+
+  /**
+   * Function to retrieve original dataset.  The output matrix can be the input
+   * matrix.
    *
    * @param input Scaled dataset.
    * @param output Output matrix with original Dataset.
@@ -89,30 +159,92 @@ class StandardScaler
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output.copy_size(input);
-    output = (input.each_col() % itemStdDev).each_col() + itemMean;
+    output.set_size(input.n_rows, input.n_cols);
+
+    using ElemType = typename MatType::elem_type;
+    #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      const ElemType* in = input.colptr(i);
+      ElemType* out = output.colptr(i);
+      for (size_t j = 0; j < input.n_rows; ++j)
+        out[j] = in[j] * itemStdDev[j] + itemMean[j];
+    }
   }
 
+  /**
+   * Function to retrieve original dataset in place.
+   *
+   * @param input Scaled dataset; it is overwritten with the original dataset.
+   */
+  template<typename MatType>
+  void InverseTransform(MatType& input) { InverseTransform(input, input); }
+
   //! Get the mean row vector.
   const arma::vec& ItemMean() const { return itemMean; }
   //! Get the standard deviation row vector.
   const arma::vec& ItemStdDev() const { return itemStdDev; }
+  //! Get the number of points that have been fitted.
+  size_t Count() const { return count; }
 
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */)
+  void serialize(Archive& ar, const uint32_t version)
   {
     ar(CEREAL_NVP(itemMean));
     ar(CEREAL_NVP(itemStdDev));
+
+    // Scalers saved before version 1 cannot be updated with PartialFit() or
+    // Merge(); they are treated as if they had not been fitted.
+    if (cereal::is_loading<Archive>() && version == 0)
+    {
+      count = 0;
+      itemM2.clear();
+    }
+    else
+    {
+      ar(CEREAL_NVP(count));
+      ar(CEREAL_NVP(itemM2));
+    }
   }
 
  private:
+  //! Throw an exception if points of the given dimensionality cannot be fitted.
+  void CheckDimensionality(const size_t dimensionality,
+                           const std::string& function) const
+  {
+    if (count > 0 && dimensionality != itemMean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "StandardScaler::" << function << "(): given points have "
+          << dimensionality << " dimensions, but the scaler was fitted on "
+          << itemMean.n_elem << " dimensions!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  //! Compute the standard deviation from the sum of squared deviations.
+  void UpdateStdDev()
+  {
+    itemStdDev = arma::sqrt(itemM2 / double(count));
+    // Handle zeros in scale vector.
+    itemStdDev.for_each([](arma::vec::elem_type& val) { val =
+        (val == 0) ? 1 : val; });
+  }
+
   // Vector which holds mean of each feature.
   arma::vec itemMean;
   // Vector which holds standard devation of each feature.
   arma::vec itemStdDev;
+  // Number of points that have been fitted.
+  size_t count;
+  // Vector which holds the sum of squared deviations from the mean of each
+  // feature.
+  arma::vec itemM2;
 }; // class StandardScaler
 
 } // namespace data
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::data::StandardScaler, 1);
+
 #endif
@@ -42,16 +42,26 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * If a rank is given, the whitening is fitted with the randomized SVD of the
+ * centered data (see PCAWhitening), and only the rank directions of largest
+ * variance are whitened; the components of the data orthogonal to them are
+ * dropped.  The transforms are applied with the d x rank eigenvectors, and
+ * never form a d x d matrix.
  */
 class ZCAWhitening
 {
  public:
   /**
-   * A constructor to set the regularization parameter.
+   * A constructor to set the regularization parameter and, optionally, the
+   * rank of the whitening.
    *
    * @param eps Regularization parameter.
+   * @param rank Number of directions to keep, computed with the randomized
+   *     SVD; 0 keeps all of them, with the full eigendecomposition.
    */
-  ZCAWhitening(double eps = 0.00005) : pca(eps) { }
+  ZCAWhitening(double eps = 0.00005, const size_t rank = 0) : pca(eps, rank)
+  { }
 
   /**
    * Function to fit features, to find out the min max and scale.
@@ -74,7 +84,8 @@ class ZCAWhitening
   void Transform(const MatType& input, MatType& output)
   {
     pca.Transform(input, output);
-    output = pca.EigenVectors() * output;
+    output = arma::conv_to<arma::Mat<typename MatType::elem_type>>::from(
+        pca.EigenVectors()) * output;
   }
 
   /**
@@ -86,9 +97,12 @@ class ZCAWhitening
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output = inv(pca.EigenVectors()) * arma::diagmat(sqrt(
-        pca.EigenValues())) * inv(pca.EigenVectors().t()) * input;
-    output = (output.each_col() + pca.ItemMean());
+    // Undo the rotation back to the whitened principal components; the
+    // eigenvectors are orthonormal, so the inverse of their transpose is
+    // themselves.
+    output = arma::conv_to<arma::Mat<typename MatType::elem_type>>::from(
+        pca.EigenVectors().t()) * input;
+    pca.InverseTransform(output, output);
   }
 
   //! Get the mean row vector.
@@ -99,6 +113,8 @@ class ZCAWhitening
   const arma::mat& EigenVectors() const { return pca.EigenVectors(); }
   //! Get the regularization parameter.
   double Epsilon() const { return pca.Epsilon(); }
+  //! Get the rank of the whitening (0 means full rank).
+  size_t Rank() const { return pca.Rank(); }
 
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
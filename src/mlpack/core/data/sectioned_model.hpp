@@ -0,0 +1,527 @@
+/**
+ * @file core/data/sectioned_model.hpp
+ *
+ * A binary container for models, made of named sections that are serialized
+ * independently, so that a section can be loaded without deserializing the
+ * rest of the file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SECTIONED_MODEL_HPP
+#define MLPACK_CORE_DATA_SECTIONED_MODEL_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <cereal/archives/binary.hpp>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef MLPACK_HAS_ZLIB
+  #include <zlib.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The first bytes of a sectioned model file.  The file holds, in order:
+ *
+ *  - the magic string "MLPACKSM" and the version of the format (1);
+ *  - the number of sections;
+ *  - the table of sections: for each section, the length of its name, its
+ *    name, whether it is compressed, the offset of its data from the start of
+ *    the file, the size of its stored data, and the size of its uncompressed
+ *    data;
+ *  - the data of each section, a cereal binary archive of the object of the
+ *    section (compressed with zlib if the section is compressed).
+ *
+ * All the numbers are 64-bit little-endian unsigned integers.
+ */
+static const char SectionedModelMagic[] = "MLPACKSM";
+//! The version of the sectioned model format.
+static const uint64_t SectionedModelVersion = 1;
+
+//! Write a number of the table of a sectioned model file.
+inline void WriteSectionNumber(std::ostream& stream, const uint64_t number)
+{
+  char bytes[8];
+  for (size_t i = 0; i < 8; ++i)
+    bytes[i] = char((number >> (8 * i)) & 0xFF);
+  stream.write(bytes, 8);
+}
+
+//! Read a number of the table of a sectioned model file.
+inline uint64_t ReadSectionNumber(std::istream& stream,
+                                  const std::string& filename)
+{
+  unsigned char bytes[8];
+  if (!stream.read((char*) bytes, 8))
+  {
+    throw std::runtime_error("SectionedModelReader: '" + filename + "' is "
+        "truncated!");
+  }
+
+  uint64_t number = 0;
+  for (size_t i = 0; i < 8; ++i)
+    number |= uint64_t(bytes[i]) << (8 * i);
+  return number;
+}
+
+//! Compress the data of a section with zlib.
+inline std::string CompressSection(const std::string& data,
+                                   const std::string& name)
+{
+#ifdef MLPACK_HAS_ZLIB
+  uLongf size = compressBound(data.size());
+  std::string compressed(size, '\0');
+  if (compress2((Bytef*) &compressed[0], &size, (const Bytef*) data.data(),
+      data.size(), Z_DEFAULT_COMPRESSION) != Z_OK)
+  {
+    throw std::runtime_error("SectionedModelWriter::Add(): cannot compress "
+        "section '" + name + "'!");
+  }
+
+  compressed.resize(size);
+  return compressed;
+#else
+  (void) data;
+  throw std::runtime_error("SectionedModelWriter::Add(): cannot compress "
+      "section '" + name + "'; mlpack was not compiled with zlib support (see "
+      "MLPACK_HAS_ZLIB in config.hpp).");
+#endif
+}
+
+//! Decompress the data of a section with zlib.
+inline std::string DecompressSection(const std::string& data,
+                                     const size_t size,
+                                     const std::string& name)
+{
+#ifdef MLPACK_HAS_ZLIB
+  std::string decompressed(size, '\0');
+  uLongf decompressedSize = size;
+  if (uncompress((Bytef*) &decompressed[0], &decompressedSize,
+      (const Bytef*) data.data(), data.size()) != Z_OK ||
+      decompressedSize != size)
+  {
+    throw std::runtime_error("SectionedModelReader::Load(): cannot "
+        "decompress section '" + name + "'!");
+  }
+
+  return decompressed;
+#else
+  (void) data;
+  (void) size;
+  throw std::runtime_error("SectionedModelReader::Load(): section '" + name +
+      "' is compressed, but mlpack was not compiled with zlib support (see "
+      "MLPACK_HAS_ZLIB in config.hpp).");
+#endif
+}
+
+/**
+ * A SectionedModelWriter builds a sectioned model file: each object added to
+ * it is serialized into its own named section, which can later be loaded by
+ * itself with a SectionedModelReader.  Large models can be split into many
+ * sections (for instance, one per tree of a RandomForest; see
+ * RandomForest::SaveSections()), and sections can be compressed one by one.
+ *
+ * @code
+ * data::SectionedModelWriter writer;
+ * writer.Add("metadata", numClasses);
+ * writer.Add("model", model);
+ * writer.Add("dataset", dataset, true); // Compress the dataset.
+ * writer.Save("model.bin");
+ * @endcode
+ *
+ * The sections are kept in memory until Save() is called.
+ */
+class SectionedModelWriter
+{
+ public:
+  /**
+   * Serialize the given object into a new section.  The object must be
+   * serializable with cereal (as all mlpack models and Armadillo objects are).
+   * A std::invalid_argument is thrown if a section with the same name has
+   * already been added, and a std::runtime_error if the section should be
+   * compressed but mlpack was not compiled with zlib support.
+   *
+   * @param name Name of the section.
+   * @param object Object to serialize.
+   * @param compress Whether to compress the data of the section.
+   */
+  template<typename T>
+  void Add(const std::string& name,
+           const T& object,
+           const bool compress = false)
+  {
+    if (index.count(name) != 0)
+    {
+      throw std::invalid_argument("SectionedModelWriter::Add(): section '" +
+          name + "' has already been added!");
+    }
+
+    std::ostringstream stream(std::ios::out | std::ios::binary);
+    {
+      cereal::BinaryOutputArchive ar(stream);
+      ar(cereal::make_nvp(name.c_str(), object));
+    }
+
+    Section section;
+    section.name = name;
+    section.compressed = compress;
+    section.data = stream.str();
+    section.size = section.data.size();
+    if (compress)
+      section.data = CompressSection(section.data, name);
+
+    index[name] = sections.size();
+    sections.push_back(std::move(section));
+  }
+
+  /**
+   * Write all the sections to the given file.  A std::runtime_error is thrown
+   * if the file cannot be written.
+   *
+   * @param filename Name of the file to write.
+   */
+  void Save(const std::string& filename) const
+  {
+    std::ofstream stream(filename, std::ios::out | std::ios::binary);
+    if (!stream.is_open())
+    {
+      throw std::runtime_error("SectionedModelWriter::Save(): cannot open '" +
+          filename + "' for writing!");
+    }
+
+    // The data of the sections starts after the table.
+    uint64_t offset = 8 + 8 + 8;
+    for (const Section& section : sections)
+      offset += 8 + section.name.size() + 4 * 8;
+
+    stream.write(SectionedModelMagic, 8);
+    WriteSectionNumber(stream, SectionedModelVersion);
+    WriteSectionNumber(stream, sections.size());
+    for (const Section& section : sections)
+    {
+      WriteSectionNumber(stream, section.name.size());
+      stream.write(section.name.data(), section.name.size());
+      WriteSectionNumber(stream, section.compressed ? 1 : 0);
+      WriteSectionNumber(stream, offset);
+      WriteSectionNumber(stream, section.data.size());
+      WriteSectionNumber(stream, section.size);
+      offset += section.data.size();
+    }
+
+    for (const Section& section : sections)
+      stream.write(section.data.data(), section.data.size());
+
+    if (!stream)
+    {
+      throw std::runtime_error("SectionedModelWriter::Save(): cannot write "
+          "'" + filename + "'!");
+    }
+  }
+
+  //! Get the number of sections.
+  size_t NumSections() const { return sections.size(); }
+
+ private:
+  //! A section that has been added.
+  struct Section
+  {
+    //! Name of the section.
+    std::string name;
+    //! Whether the data is compressed.
+    bool compressed;
+    //! Size of the uncompressed data.
+    size_t size;
+    //! Stored (possibly compressed) data.
+    std::string data;
+  };
+
+  //! The sections, in the order they were added.
+  std::vector<Section> sections;
+  //! Index of each section in sections, by name.
+  std::unordered_map<std::string, size_t> index;
+};
+
+/**
+ * A SectionedModelReader reads the table of sections of a file written by a
+ * SectionedModelWriter, and loads sections by name when they are asked for:
+ * only the data of the requested section is read from the file and
+ * deserialized.
+ *
+ * @code
+ * data::SectionedModelReader reader("model.bin");
+ * size_t numClasses;
+ * reader.Load("metadata", numClasses); // The model is not read.
+ * @endcode
+ *
+ * Load() opens the file for each section, so a reader can be shared by
+ * several threads.  See also LazySection, which loads a section at its first
+ * use.
+ */
+class SectionedModelReader
+{
+ public:
+  /**
+   * Read the table of sections of the given file.  A std::runtime_error is
+   * thrown if the file cannot be read or is not a sectioned model file.
+   *
+   * @param filename Name of the file to read.
+   */
+  explicit SectionedModelReader(const std::string& filename) :
+      filename(filename)
+  {
+    std::ifstream stream(filename, std::ios::in | std::ios::binary);
+    if (!stream.is_open())
+    {
+      throw std::runtime_error("SectionedModelReader: cannot open '" +
+          filename + "'!");
+    }
+
+    stream.seekg(0, std::ios::end);
+    const uint64_t fileSize = stream.tellg();
+    stream.seekg(0, std::ios::beg);
+
+    char magic[8];
+    if (!stream.read(magic, 8) ||
+        std::string(magic, 8) != std::string(SectionedModelMagic, 8))
+    {
+      throw std::runtime_error("SectionedModelReader: '" + filename + "' is "
+          "not a sectioned model file!");
+    }
+
+    const uint64_t version = ReadSectionNumber(stream, filename);
+    if (version > SectionedModelVersion)
+    {
+      std::ostringstream oss;
+      oss << "SectionedModelReader: '" << filename << "' has format version "
+          << version << ", but only versions up to " << SectionedModelVersion
+          << " are supported!";
+      throw std::runtime_error(oss.str());
+    }
+
+    const uint64_t numSections = ReadSectionNumber(stream, filename);
+    for (uint64_t i = 0; i < numSections; ++i)
+    {
+      SectionInfo section;
+      const uint64_t nameLength = ReadSectionNumber(stream, filename);
+      if (nameLength > fileSize)
+      {
+        throw std::runtime_error("SectionedModelReader: '" + filename +
+            "' is corrupted!");
+      }
+
+      section.name.resize(nameLength);
+      if (!stream.read(&section.name[0], nameLength))
+      {
+        throw std::runtime_error("SectionedModelReader: '" + filename +
+            "' is truncated!");
+      }
+
+      section.compressed = (ReadSectionNumber(stream, filename) != 0);
+      section.offset = ReadSectionNumber(stream, filename);
+      section.storedSize = ReadSectionNumber(stream, filename);
+      section.size = ReadSectionNumber(stream, filename);
+      if (section.offset > fileSize ||
+          section.storedSize > fileSize - section.offset)
+      {
+        throw std::runtime_error("SectionedModelReader: section '" +
+            section.name + "' of '" + filename + "' is truncated!");
+      }
+
+      index[section.name] = sections.size();
+      sections.push_back(std::move(section));
+    }
+  }
+
+  /**
+   * Deserialize the object of the given section.  A std::invalid_argument is
+   * thrown if there is no such section, and a std::runtime_error if it cannot
+   * be read.
+   *
+   * @param name Name of the section.
+   * @param object Object to deserialize the section into.
+   */
+  template<typename T>
+  void Load(const std::string& name, T& object) const
+  {
+    std::istringstream stream(ReadSection(name),
+        std::ios::in | std::ios::binary);
+    cereal::BinaryInputArchive ar(stream);
+    ar(cereal::make_nvp(name.c_str(), object));
+  }
+
+  //! Return whether the file has a section with the given name.
+  bool HasSection(const std::string& name) const
+  {
+    return index.count(name) != 0;
+  }
+
+  //! Get the names of the sections, in the order they are stored.
+  std::vector<std::string> SectionNames() const
+  {
+    std::vector<std::string> names;
+    for (const SectionInfo& section : sections)
+      names.push_back(section.name);
+    return names;
+  }
+
+  //! Get the size of the serialized (uncompressed) data of a section.
+  size_t SectionSize(const std::string& name) const
+  {
+    return Find(name).size;
+  }
+
+  //! Get whether a section is compressed.
+  bool SectionCompressed(const std::string& name) const
+  {
+    return Find(name).compressed;
+  }
+
+  //! Get the number of sections.
+  size_t NumSections() const { return sections.size(); }
+
+  //! Get the name of the file.
+  const std::string& Filename() const { return filename; }
+
+ private:
+  //! The location of a section in the file.
+  struct SectionInfo
+  {
+    //! Name of the section.
+    std::string name;
+    //! Whether the data is compressed.
+    bool compressed;
+    //! Offset of the data from the start of the file.
+    uint64_t offset;
+    //! Size of the stored (possibly compressed) data.
+    uint64_t storedSize;
+    //! Size of the uncompressed data.
+    uint64_t size;
+  };
+
+  //! Find the given section, or throw a std::invalid_argument.
+  const SectionInfo& Find(const std::string& name) const
+  {
+    std::unordered_map<std::string, size_t>::const_iterator it =
+        index.find(name);
+    if (it == index.end())
+    {
+      throw std::invalid_argument("SectionedModelReader: '" + filename +
+          "' has no section '" + name + "'!");
+    }
+
+    return sections[it->second];
+  }
+
+  //! Read the (uncompressed) data of the given section.
+  std::string ReadSection(const std::string& name) const
+  {
+    const SectionInfo& section = Find(name);
+
+    std::ifstream stream(filename, std::ios::in | std::ios::binary);
+    std::string data(section.storedSize, '\0');
+    stream.seekg(section.offset);
+    if (!stream.read(&data[0], section.storedSize))
+    {
+      throw std::runtime_error("SectionedModelReader::Load(): cannot read "
+          "section '" + name + "' of '" + filename + "'!");
+    }
+
+    if (section.compressed)
+      return DecompressSection(data, section.size, name);
+
+    return data;
+  }
+
+  //! Name of the file.
+  std::string filename;
+  //! The sections, in the order they are stored.
+  std::vector<SectionInfo> sections;
+  //! Index of each section in sections, by name.
+  std::unordered_map<std::string, size_t> index;
+};
+
+/**
+ * A LazySection is an object of a sectioned model file that is only loaded
+ * the first time it is used, so that a served model can start without reading
+ * its heavy sections.  Get() can be called by several threads; the section is
+ * loaded once.  If loading fails, the exception is thrown by Get() and the
+ * section is loaded again at the next call.
+ *
+ * @code
+ * auto reader = std::make_shared<data::SectionedModelReader>("model.bin");
+ * data::LazySection<arma::mat> dataset(reader, "dataset");
+ * // ...
+ * const arma::mat& m = dataset.Get(); // The dataset is loaded here.
+ * @endcode
+ *
+ * @tparam T Type of the object of the section.
+ */
+template<typename T>
+class LazySection
+{
+ public:
+  /**
+   * Create a lazy section; nothing is loaded yet.
+   *
+   * @param reader Reader of the file that holds the section.
+   * @param name Name of the section.
+   */
+  LazySection(std::shared_ptr<const SectionedModelReader> reader,
+              const std::string& name) :
+      reader(std::move(reader)),
+      name(name)
+  {
+    if (!this->reader->HasSection(name))
+    {
+      throw std::invalid_argument("LazySection: '" +
+          this->reader->Filename() + "' has no section '" + name + "'!");
+    }
+  }
+
+  //! Get the object of the section, loading it if it has not been loaded yet.
+  const T& Get() const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!object)
+    {
+      std::unique_ptr<T> loaded(new T());
+      reader->Load(name, *loaded);
+      object = std::move(loaded);
+    }
+
+    return *object;
+  }
+
+  //! Return whether the section has been loaded.
+  bool Loaded() const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return object != nullptr;
+  }
+
+  //! Get the name of the section.
+  const std::string& Name() const { return name; }
+
+ private:
+  //! Reader of the file that holds the section.
+  std::shared_ptr<const SectionedModelReader> reader;
+  //! Name of the section.
+  std::string name;
+  //! The object, once it has been loaded.
+  mutable std::unique_ptr<T> object;
+  //! Protects the loading of the object.
+  mutable std::mutex mutex;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * @file core/data/sparse_encoding_output.hpp
+ *
+ * Definition of the SparseEncodingOutput class, which collects the values
+ * written by a string encoding policy and builds a sparse matrix from them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SPARSE_ENCODING_OUTPUT_HPP
+#define MLPACK_CORE_DATA_SPARSE_ENCODING_OUTPUT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <unordered_map>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * SparseEncodingOutput can be given to the InitMatrix() and Encode() methods
+ * of a string encoding policy in place of an arma::SpMat<eT>.  Writing an
+ * element of an arma::SpMat<eT> one at a time costs time proportional to the
+ * number of non-zero elements, so instead the elements written for one
+ * document are accumulated in a small hash map, and the non-zero elements of
+ * all the documents are inserted into the sparse matrix at once by Finish().
+ *
+ * The policy must only write the elements of document i while document i is
+ * encoded (as BagOfWordsEncodingPolicy, TfIdfEncodingPolicy and
+ * DictionaryEncodingPolicy do), and NextDocument() must be called after each
+ * document.
+ *
+ * @tparam eT Type of the elements of the sparse matrix.
+ */
+template<typename eT>
+class SparseEncodingOutput
+{
+ public:
+  //! The type of the elements, as for Armadillo matrices.
+  using elem_type = eT;
+
+  //! Create an empty output.
+  SparseEncodingOutput() : n_rows(0), n_cols(0) { }
+
+  /**
+   * Set the size of the output, and remove all its elements.
+   *
+   * @param rows Number of rows of the sparse matrix.
+   * @param cols Number of columns of the sparse matrix.
+   */
+  void zeros(const size_t rows, const size_t cols)
+  {
+    n_rows = rows;
+    n_cols = cols;
+    document.clear();
+    locations.clear();
+    values.clear();
+  }
+
+  /**
+   * Get a reference to the given element of the document that is being
+   * encoded; the element is zero if it has not been written yet.
+   */
+  eT& operator()(const size_t row, const size_t col)
+  {
+    return document[col * n_rows + row];
+  }
+
+  //! Store the non-zero elements of the document that was encoded.
+  void NextDocument()
+  {
+    for (const std::pair<const size_t, eT>& element : document)
+    {
+      if (element.second != eT(0))
+      {
+        locations.push_back(element.first);
+        values.push_back(element.second);
+      }
+    }
+
+    document.clear();
+  }
+
+  //! Build the sparse matrix from the non-zero elements of all documents.
+  void Finish(arma::SpMat<eT>& output)
+  {
+    NextDocument();
+
+    arma::umat positions(2, locations.size());
+    for (size_t i = 0; i < locations.size(); ++i)
+    {
+      positions(0, i) = locations[i] % n_rows;
+      positions(1, i) = locations[i] / n_rows;
+    }
+
+    output = arma::SpMat<eT>(positions, arma::Col<eT>(values), n_rows, n_cols);
+  }
+
+  //! Number of rows of the sparse matrix.
+  size_t n_rows;
+  //! Number of columns of the sparse matrix.
+  size_t n_cols;
+
+ private:
+  //! The elements written for the current document, by column-major index.
+  std::unordered_map<size_t, eT> document;
+  //! The column-major indices of the non-zero elements of previous documents.
+  std::vector<size_t> locations;
+  //! The values of the non-zero elements of previous documents.
+  std::vector<eT> values;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
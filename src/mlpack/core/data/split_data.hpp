@@ -613,6 +613,183 @@ Split(const FieldType& input,
                          std::move(testData));
 }
 
+/**
+ * Given the number of points of a dataset, get the indices of the points of a
+ * training set and of a test set, without copying any data.  The indices are
+ * those of the points that Split() would put in each set (with the same random
+ * seed), so `input.cols(trainIndices)` holds the same points as the training
+ * set given by Split(); an Armadillo non-contiguous column view such as
+ * `input.cols(trainIndices)` can often be used directly instead of a copy.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::uvec trainIndices, testIndices;
+ * SplitIndices(input.n_cols, trainIndices, testIndices, 0.3);
+ * double trainMean = arma::accu(input.cols(trainIndices)) /
+ *     input.cols(trainIndices).n_elem;
+ * @endcode
+ *
+ * @param numPoints Number of points in the dataset.
+ * @param trainIndices Vector to store the indices of the training points into.
+ * @param testIndices Vector to store the indices of the test points into.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *       sample is visited in linear order. (Default true).
+ */
+inline void SplitIndices(const size_t numPoints,
+                         arma::uvec& trainIndices,
+                         arma::uvec& testIndices,
+                         const double testRatio,
+                         const bool shuffleData = true)
+{
+  const size_t testSize = static_cast<size_t>(numPoints * testRatio);
+  const size_t trainSize = numPoints - testSize;
+
+  arma::uvec order = arma::linspace<arma::uvec>(0, numPoints - 1, numPoints);
+  if (shuffleData)
+    order = arma::shuffle(order);
+
+  trainIndices = order.head(trainSize);
+  testIndices = order.tail(testSize);
+}
+
+/**
+ * Given the number of points of a dataset, get the indices of the points of a
+ * training set and of a test set (see the other overload of SplitIndices()).
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::uvec trainIndices, testIndices;
+ * std::tie(trainIndices, testIndices) = SplitIndices(input.n_cols, 0.3);
+ * @endcode
+ *
+ * @param numPoints Number of points in the dataset.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *       sample is visited in linear order. (Default true).
+ * @return std::tuple containing the indices of the training points and the
+ *      indices of the test points (arma::uvec).
+ */
+inline std::tuple<arma::uvec, arma::uvec>
+SplitIndices(const size_t numPoints,
+             const double testRatio,
+             const bool shuffleData = true)
+{
+  arma::uvec trainIndices;
+  arma::uvec testIndices;
+  SplitIndices(numPoints, trainIndices, testIndices, testRatio, shuffleData);
+
+  return std::make_tuple(std::move(trainIndices), std::move(testIndices));
+}
+
+/**
+ * Reorder the columns of the given matrix in place, so that column i becomes
+ * the old column order[i].  Only one column is held in temporary memory.
+ */
+template<typename MatType>
+void PermuteColumns(MatType& m, const arma::uvec& order)
+{
+  std::vector<bool> placed(order.n_elem, false);
+  for (size_t start = 0; start < order.n_elem; ++start)
+  {
+    if (placed[start])
+      continue;
+
+    // Follow the cycle of the permutation that starts at this column.
+    const MatType first = m.col(start);
+    size_t i = start;
+    while (order[i] != start)
+    {
+      m.col(i) = m.col(order[i]);
+      placed[i] = true;
+      i = order[i];
+    }
+    m.col(i) = first;
+    placed[i] = true;
+  }
+}
+
+/**
+ * Given an input dataset, split it in place into a training set and a test
+ * set: the columns of the dataset are reordered so that the training set is
+ * the first columns and the test set is the last columns, and the number of
+ * training points is returned.  The sets are the same as those given by
+ * Split() (with the same random seed), but no copy of the dataset is made; the
+ * sets can be used through contiguous views such as `input.cols(0, trainSize
+ * - 1)`.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * const size_t trainSize = SplitInPlace(input, 0.3);
+ * // An alias of the training set, which can be given to Train() methods.
+ * arma::mat trainData(input.colptr(0), input.n_rows, trainSize, false, true);
+ * @endcode
+ *
+ * @param input Input dataset to split; its columns are reordered.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *       sample is visited in linear order. (Default true).
+ * @return The number of points in the training set.
+ */
+template<typename T>
+size_t SplitInPlace(arma::Mat<T>& input,
+                    const double testRatio,
+                    const bool shuffleData = true)
+{
+  arma::uvec trainIndices, testIndices;
+  SplitIndices(input.n_cols, trainIndices, testIndices, testRatio,
+      shuffleData);
+
+  if (shuffleData)
+    PermuteColumns(input, arma::join_cols(trainIndices, testIndices));
+
+  return trainIndices.n_elem;
+}
+
+/**
+ * Given an input dataset and labels, split them in place into a training set
+ * and a test set (see the other overload of SplitInPlace()).  The columns of
+ * the dataset and of the labels are reordered in the same way.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::Row<size_t> labels = loadLabels();
+ * const size_t trainSize = SplitInPlace(input, labels, 0.3);
+ * @endcode
+ *
+ * @tparam T Type of the elements of the input matrix.
+ * @tparam LabelsType Type of input labels. It can be arma::Mat, arma::Row or
+ *       arma::Col.
+ * @param input Input dataset to split; its columns are reordered.
+ * @param inputLabel Input labels to split; its columns are reordered.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *       sample is visited in linear order. (Default true).
+ * @return The number of points in the training set.
+ */
+template<typename T, typename LabelsType,
+         typename = std::enable_if_t<arma::is_arma_type<LabelsType>::value> >
+size_t SplitInPlace(arma::Mat<T>& input,
+                    LabelsType& inputLabel,
+                    const double testRatio,
+                    const bool shuffleData = true)
+{
+  util::CheckSameSizes(input, inputLabel, "data::SplitInPlace()");
+
+  arma::uvec trainIndices, testIndices;
+  SplitIndices(input.n_cols, trainIndices, testIndices, testRatio,
+      shuffleData);
+
+  if (shuffleData)
+  {
+    const arma::uvec order = arma::join_cols(trainIndices, testIndices);
+    PermuteColumns(input, order);
+    PermuteColumns(inputLabel, order);
+  }
+
+  return trainIndices.n_elem;
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/data/string_encoding_dictionary.hpp>
 #include <mlpack/core/data/string_encoding_policies/policy_traits.hpp>
+#include <mlpack/core/data/sparse_encoding_output.hpp>
 #include <vector>
 
 namespace mlpack {
@@ -96,7 +97,13 @@ class StringEncoding
    *
    * If the output type is either arma::mat or arma::sp_mat then the function
    * writes it in the column-major order. If the output type is 2D std::vector
-   * then the function writes it in the row major order.
+   * then the function writes it in the row major order.  An arma::sp_mat
+   * output is built at once from its non-zero elements, so it is much cheaper
+   * than an arma::mat output for large vocabularies.
+   *
+   * Unless the policy supports one pass encoding, the documents are tokenized
+   * in parallel (if OpenMP is enabled), and the tokens are labeled in order of
+   * first appearance, as if the documents were tokenized one at a time.
    *
    * @tparam OutputType Type of the output container. The function supports
    *                    the following types: arma::mat, arma::sp_mat,
@@ -113,6 +120,7 @@ class StringEncoding
    * the extracted token and returns the token;
    * 2. IsTokenEmpty() that accepts a token and returns true if the given
    *    token is empty.
+   * The operator() method must be safe to call from several threads at once.
    */
   template<typename OutputType, typename TokenizerType>
   void Encode(const std::vector<std::string>& input,
@@ -170,6 +178,47 @@ class StringEncoding
                     const TokenizerType& tokenizer,
                     PolicyType& policy);
 
+  /**
+   * A helper function to encode the given text and write the result to
+   * the given sparse matrix, in the column-major order.  The values written
+   * by the policy are collected by a SparseEncodingOutput object, and the
+   * sparse matrix is built from them at once.
+   *
+   * @tparam TokenizerType Type of the tokenizer.
+   * @tparam PolicyType The type of the encoding policy. It has to be
+   *                    equal to EncodingPolicyType.
+   * @tparam ElemType Type of the output values.
+   *
+   * @param input Corpus of text to encode.
+   * @param output Output sparse matrix to store the result.
+   * @param tokenizer The tokenizer object.
+   * @param policy The policy object.
+   */
+  template<typename TokenizerType, typename PolicyType, typename ElemType>
+  void EncodeHelper(const std::vector<std::string>& input,
+                    arma::SpMat<ElemType>& output,
+                    const TokenizerType& tokenizer,
+                    PolicyType& policy);
+
+  /**
+   * Tokenize the given documents in parallel, and get the labels of the tokens
+   * of each document.  Each block of documents is tokenized with its own
+   * dictionary of distinct tokens (the tokens themselves are views of the
+   * documents for MLPACK_STRING_VIEW tokenizers), and the distinct tokens of
+   * the blocks are then added to the dictionary in order, so that the labels
+   * are the same as if the documents were tokenized one at a time.
+   *
+   * @tparam TokenizerType Type of the tokenizer.
+   *
+   * @param input Corpus of text to tokenize.
+   * @param tokenizer The tokenizer object.
+   * @param labels Labels of the tokens of each document.
+   */
+  template<typename TokenizerType>
+  void TokenizeCorpus(const std::vector<std::string>& input,
+                      const TokenizerType& tokenizer,
+                      std::vector<std::vector<size_t>>& labels);
+
   /**
    * A helper function to encode the given text and write the result to
    * the given output. This is an optimized overload for policies that support
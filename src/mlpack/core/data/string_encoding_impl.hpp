@@ -15,7 +15,10 @@
 
 // In case it hasn't been included yet.
 #include "string_encoding.hpp"
+#include <mlpack/core/util/executor.hpp>
+
 #include <type_traits>
+#include <unordered_map>
 
 namespace mlpack {
 namespace data {
@@ -97,6 +100,95 @@ void StringEncoding<EncodingPolicyType, DictionaryType>::Encode(
 }
 
 
+//! Nothing needs to be done after each document for dense outputs.
+template<typename MatType>
+void EndEncodedDocument(MatType& /* output */) { }
+
+//! Store the values of each document of a sparse output.
+template<typename eT>
+void EndEncodedDocument(SparseEncodingOutput<eT>& output)
+{
+  output.NextDocument();
+}
+
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename TokenizerType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::TokenizeCorpus(
+    const std::vector<std::string>& input,
+    const TokenizerType& tokenizer,
+    std::vector<std::vector<size_t>>& labels)
+{
+  using TokenType = typename std::decay<decltype(tokenizer(
+      std::declval<MLPACK_STRING_VIEW&>()))>::type;
+
+  static_assert(
+      std::is_same<TokenType,
+                   typename std::remove_reference<typename DictionaryType::
+                      TokenType>::type>::value,
+      "The dictionary token type doesn't match the return value type "
+      "of the tokenizer.");
+
+  // Use several blocks of documents per thread so that the work is balanced.
+  const size_t numBlocks = std::min(input.size(),
+      8 * NumThreads());
+
+  // The labels of each block are first indices into the distinct tokens of the
+  // block, in order of first appearance.
+  labels.clear();
+  labels.resize(input.size());
+  std::vector<std::vector<TokenType>> blockTokens(numBlocks);
+
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    std::unordered_map<TokenType, size_t> ids;
+    const size_t end = input.size() * (b + 1) / numBlocks;
+    for (size_t i = input.size() * b / numBlocks; i < end; ++i)
+    {
+      MLPACK_STRING_VIEW strView(input[i]);
+      TokenType token = tokenizer(strView);
+
+      while (!tokenizer.IsTokenEmpty(token))
+      {
+        auto it = ids.find(token);
+        if (it == ids.end())
+        {
+          it = ids.emplace(token, blockTokens[b].size()).first;
+          blockTokens[b].push_back(std::move(token));
+        }
+        labels[i].push_back(it->second);
+
+        token = tokenizer(strView);
+      }
+    }
+  }
+
+  // The distinct tokens of the blocks are added to the dictionary in order,
+  // so a token gets the label it would get when the documents are tokenized
+  // one at a time.
+  std::vector<std::vector<size_t>> blockLabels(numBlocks);
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    blockLabels[b].resize(blockTokens[b].size());
+    for (size_t k = 0; k < blockTokens[b].size(); ++k)
+    {
+      if (dictionary.HasToken(blockTokens[b][k]))
+        blockLabels[b][k] = dictionary.Value(blockTokens[b][k]);
+      else
+        blockLabels[b][k] = dictionary.AddToken(std::move(blockTokens[b][k]));
+    }
+  }
+
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t end = input.size() * (b + 1) / numBlocks;
+    for (size_t i = input.size() * b / numBlocks; i < end; ++i)
+      for (size_t j = 0; j < labels[i].size(); ++j)
+        labels[i][j] = blockLabels[b][labels[i][j]];
+  }
+}
+
 template<typename EncodingPolicyType, typename DictionaryType>
 template<typename MatType, typename TokenizerType, typename PolicyType>
 void StringEncoding<EncodingPolicyType, DictionaryType>::
@@ -110,32 +202,15 @@ EncodeHelper(const std::vector<std::string>& input,
   policy.Reset();
 
   // The first pass adds the extracted tokens to the dictionary.
+  std::vector<std::vector<size_t>> labels;
+  TokenizeCorpus(input, tokenizer, labels);
+
   for (size_t i = 0; i < input.size(); ++i)
   {
-    MLPACK_STRING_VIEW strView(input[i]);
-    auto token = tokenizer(strView);
+    for (size_t j = 0; j < labels[i].size(); ++j)
+      policy.PreprocessToken(i, j, labels[i][j]);
 
-    static_assert(
-        std::is_same<typename std::remove_reference<decltype(token)>::type,
-                     typename std::remove_reference<typename DictionaryType::
-                        TokenType>::type>::value,
-        "The dictionary token type doesn't match the return value type "
-        "of the tokenizer.");
-
-    size_t numTokens = 0;
-
-    while (!tokenizer.IsTokenEmpty(token))
-    {
-      if (!dictionary.HasToken(token))
-        dictionary.AddToken(std::move(token));
-
-      policy.PreprocessToken(i, numTokens, dictionary.Value(token));
-
-      token = tokenizer(strView);
-      numTokens++;
-    }
-
-    numColumns = std::max(numColumns, numTokens);
+    numColumns = std::max(numColumns, labels[i].size());
   }
 
   policy.InitMatrix(output, input.size(), numColumns, dictionary.Size());
@@ -143,19 +218,26 @@ EncodeHelper(const std::vector<std::string>& input,
   // The second pass writes the encoded values to the output.
   for (size_t i = 0; i < input.size(); ++i)
   {
-    MLPACK_STRING_VIEW strView(input[i]);
-    auto token = tokenizer(strView);
-    size_t numTokens = 0;
+    for (size_t j = 0; j < labels[i].size(); ++j)
+      policy.Encode(output, labels[i][j], i, j);
 
-    while (!tokenizer.IsTokenEmpty(token))
-    {
-      policy.Encode(output, dictionary.Value(token), i, numTokens);
-      token = tokenizer(strView);
-      numTokens++;
-    }
+    EndEncodedDocument(output);
   }
 }
 
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename TokenizerType, typename PolicyType, typename ElemType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::
+EncodeHelper(const std::vector<std::string>& input,
+             arma::SpMat<ElemType>& output,
+             const TokenizerType& tokenizer,
+             PolicyType& policy)
+{
+  SparseEncodingOutput<ElemType> sparseOutput;
+  EncodeHelper(input, sparseOutput, tokenizer, policy);
+  sparseOutput.Finish(output);
+}
+
 template<typename EncodingPolicyType, typename DictionaryType>
 template<typename TokenizerType, typename PolicyType, typename ElemType>
 void StringEncoding<EncodingPolicyType, DictionaryType>::
@@ -80,14 +80,28 @@ class DiagonalGaussianDistribution
    */
   void Probability(const arma::mat& x, arma::vec& probabilities) const
   {
-    arma::vec logProbabilities;
-    LogProbability(x, logProbabilities);
-    probabilities = exp(logProbabilities);
+    LogProbability(x, probabilities);
+    probabilities = exp(probabilities);
+  }
+
+  /**
+   * Calculate the multivariate Gaussian probability density function for each
+   * data point (column) in the given single-precision matrix.
+   *
+   * @param x Matrix of observations.
+   * @param probabilities Output probabilities for each input observation.
+   */
+  void Probability(const arma::fmat& x, arma::fvec& probabilities) const
+  {
+    LogProbability(x, probabilities);
+    probabilities = exp(probabilities);
   }
 
   /**
    * Calculate the multivariate Gaussian log probability density function for
-   * each data point (column) in the given matrix.
+   * each data point (column) in the given matrix.  No temporary matrix is
+   * created, and logProbabilities is only resized if it does not have one
+   * element per observation already.
    *
    * @param observations Matrix of observations.
    * @param logProbabilities Output log probabilities for each observation.
@@ -95,6 +109,16 @@ class DiagonalGaussianDistribution
   void LogProbability(const arma::mat& observations,
                       arma::vec& logProbabilities) const;
 
+  /**
+   * Calculate the multivariate Gaussian log probability density function for
+   * each data point (column) in the given single-precision matrix.
+   *
+   * @param observations Matrix of observations.
+   * @param logProbabilities Output log probabilities for each observation.
+   */
+  void LogProbability(const arma::fmat& observations,
+                      arma::fvec& logProbabilities) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
@@ -137,6 +161,12 @@ class DiagonalGaussianDistribution
   //! Set the covariance matrix using move assignment.
   void Covariance(arma::vec&& covariance);
 
+  //! Return the inverse of the diagonal covariance.
+  const arma::vec& InvCov() const { return invCov; }
+
+  //! Return logdet(cov).
+  double LogDetCov() const { return logDetCov; }
+
   //! Serialize the distribution.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -147,6 +177,19 @@ class DiagonalGaussianDistribution
     ar(CEREAL_NVP(invCov));
     ar(CEREAL_NVP(logDetCov));
   }
+
+ private:
+  /**
+   * Compute the log probabilities of the given observations with the given
+   * mean and inverse covariance (of the same element type as the
+   * observations).  The points are processed in parallel, and the quadratic
+   * form of each point is one vectorized loop over its dimensions.
+   */
+  template<typename eT>
+  void BatchLogProbability(const arma::Mat<eT>& observations,
+                           const arma::Col<eT>& m,
+                           const arma::Col<eT>& inv,
+                           arma::Col<eT>& logProbabilities) const;
 };
 
 } // namespace mlpack
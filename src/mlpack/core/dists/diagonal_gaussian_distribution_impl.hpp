@@ -14,6 +14,7 @@
 
 #include "diagonal_gaussian_distribution.hpp"
 #include <mlpack/methods/gmm/diagonal_constraint.hpp>
+#include <mlpack/core/util/executor.hpp>
 
 namespace mlpack {
 
@@ -51,18 +52,49 @@ inline double DiagonalGaussianDistribution::LogProbability(
 inline void DiagonalGaussianDistribution::LogProbability(
     const arma::mat& observations,
     arma::vec& logProbabilities) const
+{
+  BatchLogProbability(observations, mean, invCov, logProbabilities);
+}
+
+inline void DiagonalGaussianDistribution::LogProbability(
+    const arma::fmat& observations,
+    arma::fvec& logProbabilities) const
+{
+  BatchLogProbability(observations, arma::conv_to<arma::fvec>::from(mean),
+      arma::conv_to<arma::fvec>::from(invCov), logProbabilities);
+}
+
+template<typename eT>
+void DiagonalGaussianDistribution::BatchLogProbability(
+    const arma::Mat<eT>& observations,
+    const arma::Col<eT>& m,
+    const arma::Col<eT>& inv,
+    arma::Col<eT>& logProbabilities) const
 {
   const size_t k = observations.n_rows;
+  const eT constant = eT(-0.5 * k * log2pi - 0.5 * logDetCov);
+  logProbabilities.set_size(observations.n_cols);
 
-  // Column i of 'diffs' is the difference between observations.col(i) and
-  // the mean.
-  arma::mat diffs = observations.each_col() - mean;
+  const eT* meanPtr = m.memptr();
+  const eT* invPtr = inv.memptr();
 
   // Calculates log of exponent equation in multivariate Gaussian
-  // distribution. We use only diagonal part for faster computation.
-  arma::vec logExponents = -0.5 * trans(diffs % diffs) * invCov;
-
-  logProbabilities = -0.5 * k * log2pi - 0.5 * logDetCov + logExponents;
+  // distribution. We use only diagonal part for faster computation, directly
+  // on the memory of each observation.
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t j = 0; j < observations.n_cols; ++j)
+  {
+    const eT* x = observations.colptr(j);
+    eT quadratic = 0;
+    #pragma omp simd reduction(+:quadratic)
+    for (size_t i = 0; i < k; ++i)
+    {
+      const eT diff = x[i] - meanPtr[i];
+      quadratic += diff * diff * invPtr[i];
+    }
+
+    logProbabilities[j] = constant - quadratic / 2;
+  }
 }
 
 inline arma::vec DiagonalGaussianDistribution::Random() const
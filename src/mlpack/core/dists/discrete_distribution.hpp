@@ -180,7 +180,8 @@ class DiscreteDistribution
 
   /**
    * Returns the Log probability of the given matrix. These values are stored
-   * in logProbabilities.
+   * in logProbabilities.  The logarithms of the probabilities of each possible
+   * observation are computed once, and then gathered for each observation.
    *
    * @param x List of observations.
    * @param logProbabilities Output log-probabilities for each input
@@ -188,11 +189,35 @@ class DiscreteDistribution
    */
   void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const
   {
-    logProbabilities.set_size(x.n_cols);
-    for (size_t i = 0; i < x.n_cols; ++i)
-      logProbabilities(i) = std::log(Probability(x.unsafe_col(i)));
+    std::vector<arma::vec> logTables;
+    LogProbabilityTables(logTables);
+    LogProbability(logTables, x, logProbabilities);
   }
 
+  /**
+   * Compute the logarithm of the probability of each possible observation, in
+   * each dimension.  These tables can be given to the static LogProbability()
+   * overload as long as the distribution does not change, so that no logarithm
+   * has to be computed for each observation.
+   *
+   * @param logTables Output log-probabilities of the observations of each
+   *   dimension.
+   */
+  void LogProbabilityTables(std::vector<arma::vec>& logTables) const;
+
+  /**
+   * Compute the log probability of each of the given observations from the
+   * log-probability tables of a distribution (see LogProbabilityTables()).
+   *
+   * @param logTables Log-probabilities of the observations of each dimension.
+   * @param x List of observations.
+   * @param logProbabilities Output log-probabilities for each input
+   *   observation.
+   */
+  static void LogProbability(const std::vector<arma::vec>& logTables,
+                             const arma::mat& x,
+                             arma::vec& logProbabilities);
+
   /**
    * Return a randomly generated observation (one-dimensional vector; one
    * observation) according to the probability distribution defined by this
@@ -52,6 +52,56 @@ inline arma::vec DiscreteDistribution::Random() const
   return result;
 }
 
+/**
+ * Compute the log-probability of each possible observation in each dimension.
+ */
+inline void DiscreteDistribution::LogProbabilityTables(
+    std::vector<arma::vec>& logTables) const
+{
+  logTables.resize(probabilities.size());
+  for (size_t d = 0; d < probabilities.size(); ++d)
+    logTables[d] = arma::log(probabilities[d]);
+}
+
+/**
+ * Gather the log-probabilities of the given observations from the tables.
+ */
+inline void DiscreteDistribution::LogProbability(
+    const std::vector<arma::vec>& logTables,
+    const arma::mat& x,
+    arma::vec& logProbabilities)
+{
+  // Ensure the observations have the same dimension as the tables.
+  if (x.n_rows != logTables.size())
+  {
+    Log::Fatal << "DiscreteDistribution::LogProbability(): observations have "
+        << "incorrect dimension " << x.n_rows << " but should have dimension "
+        << logTables.size() << "!" << std::endl;
+  }
+
+  logProbabilities.zeros(x.n_cols);
+  for (size_t d = 0; d < logTables.size(); ++d)
+  {
+    const arma::vec& logTable = logTables[d];
+    for (size_t i = 0; i < x.n_cols; ++i)
+    {
+      // Adding 0.5 helps ensure that we cast the floating point to a size_t
+      // correctly.
+      const size_t obs = size_t(x(d, i) + 0.5);
+
+      // Ensure that the observation is within the bounds.
+      if (obs >= logTable.n_elem)
+      {
+        Log::Fatal << "DiscreteDistribution::LogProbability(): received "
+            << "observation " << obs << "; observation must be in [0, "
+            << logTable.n_elem << "] for this distribution." << std::endl;
+      }
+
+      logProbabilities[i] += logTable[obs];
+    }
+  }
+}
+
 /**
  * Estimate the probability distribution directly from the given observations.
  */
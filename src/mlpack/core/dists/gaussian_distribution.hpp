@@ -29,6 +29,9 @@ class GaussianDistribution
   arma::mat covariance;
   //! Lower triangular factor of cov (e.g. cov = LL^T).
   arma::mat covLower;
+  //! Cached inverse of covLower, so that (x - mean)^T cov^-1 (x - mean) is the
+  //! squared norm of invCovLower * (x - mean).
+  arma::mat invCovLower;
   //! Cached inverse of covariance.
   arma::mat invCov;
   //! Cached logdet(cov).
@@ -51,6 +54,7 @@ class GaussianDistribution
       mean(arma::zeros<arma::vec>(dimension)),
       covariance(arma::eye<arma::mat>(dimension, dimension)),
       covLower(arma::eye<arma::mat>(dimension, dimension)),
+      invCovLower(arma::eye<arma::mat>(dimension, dimension)),
       invCov(arma::eye<arma::mat>(dimension, dimension)),
       logDetCov(0)
   { /* Nothing to do. */ }
@@ -90,31 +94,46 @@ class GaussianDistribution
   void Probability(const arma::mat& x, arma::vec& probabilities) const
   {
     // Use LogProbability(), then transform the log-probabilities out of
-    // logspace.
-    arma::vec logProbs;
-    LogProbability(x, logProbs);
-    probabilities = exp(logProbs);
+    // logspace, in place.
+    LogProbability(x, probabilities);
+    probabilities = exp(probabilities);
+  }
+
+  /**
+   * Calculates the multivariate Gaussian probability density function for each
+   * data point (column) in the given single-precision matrix.
+   *
+   * @param x List of observations.
+   * @param probabilities Output probabilities for each input observation.
+   */
+  void Probability(const arma::fmat& x, arma::fvec& probabilities) const
+  {
+    LogProbability(x, probabilities);
+    probabilities = exp(probabilities);
   }
 
   /**
    * Returns the Log probability of the given matrix. These values are stored
-   * in logProbabilities.
+   * in logProbabilities, which is only resized if it does not have one element
+   * per observation already (so it can be an alias of caller-owned memory).
+   * The points are processed in blocks, in parallel, using the cached inverse
+   * of the Cholesky factor of the covariance.
    *
    * @param x List of observations.
    * @param logProbabilities Output log probabilities for each input
    *     observation.
    */
-  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const
-  {
-    // Column i of 'diffs' is the difference between x.col(i) and the mean.
-    arma::mat diffs = x;
-    diffs.each_col() -= mean;
-
-    // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1
-    // * diffs).  We just don't need any of the other elements.
-    logProbabilities = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov +
-        sum(diffs % (-0.5 * invCov * diffs), 0).t();
-  }
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
+
+  /**
+   * Returns the Log probability of the given single-precision matrix.  The
+   * factors of the distribution are converted to single precision once.
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each input
+   *     observation.
+   */
+  void LogProbability(const arma::fmat& x, arma::fvec& logProbabilities) const;
 
   /**
    * Return a randomly generated observation according to the probability
@@ -164,6 +183,10 @@ class GaussianDistribution
   //! Return the invCov.
   const arma::mat& InvCov() const { return invCov; }
 
+  //! Return the inverse of the lower triangular Cholesky factor of the
+  //! covariance.
+  const arma::mat& InvCovLower() const { return invCovLower; }
+
   //! Return the logDetCov.
   double LogDetCov() const { return logDetCov; }
 
@@ -179,9 +202,28 @@ class GaussianDistribution
     ar(CEREAL_NVP(covLower));
     ar(CEREAL_NVP(invCov));
     ar(CEREAL_NVP(logDetCov));
+
+    // The inverse of the Cholesky factor is not serialized.
+    if (cereal::is_loading<Archive>())
+      invCovLower = arma::inv(arma::trimatl(covLower));
   }
 
  private:
+  /**
+   * Compute the log probabilities of the given observations with the given
+   * mean and inverse Cholesky factor (of the same element type as the
+   * observations).  The buffers of each thread are reused for all of its
+   * blocks of points.
+   */
+  template<typename eT>
+  void BatchLogProbability(const arma::Mat<eT>& x,
+                           const arma::Col<eT>& m,
+                           const arma::Mat<eT>& invLower,
+                           arma::Col<eT>& logProbabilities) const;
+
+  //! Number of points of each block of BatchLogProbability().
+  static constexpr size_t BlockSize = 256;
+
   /**
    * This factors the covariance using arma::chol().  The function assumes that
    * the given matrix is factorizable via the Cholesky decomposition.  If not,
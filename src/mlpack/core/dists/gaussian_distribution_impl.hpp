@@ -15,6 +15,7 @@
 
 #include "gaussian_distribution.hpp"
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
+#include <mlpack/core/util/executor.hpp>
 
 namespace mlpack {
 
@@ -63,7 +64,7 @@ inline void GaussianDistribution::FactorCovariance()
   // 0 after the method. That last part is unnecessary, but baked into
   // Armadillo, so there's not really much that can be done about that without
   // discussion with the Armadillo maintainer.
-  const arma::mat invCovLower = arma::inv(arma::trimatl(covLower));
+  invCovLower = arma::inv(arma::trimatl(covLower));
 
   invCov = invCovLower.t() * invCovLower;
   double sign = 0.;
@@ -75,9 +76,65 @@ inline double GaussianDistribution::LogProbability(
     const arma::vec& observation) const
 {
   const size_t k = observation.n_elem;
-  const arma::vec diff = mean - observation;
-  const arma::vec v = (diff.t() * invCov * diff);
-  return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * v(0);
+  const arma::vec z = invCovLower * (observation - mean);
+  return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * arma::dot(z, z);
+}
+
+inline void GaussianDistribution::LogProbability(
+    const arma::mat& x,
+    arma::vec& logProbabilities) const
+{
+  BatchLogProbability(x, mean, invCovLower, logProbabilities);
+}
+
+inline void GaussianDistribution::LogProbability(
+    const arma::fmat& x,
+    arma::fvec& logProbabilities) const
+{
+  BatchLogProbability(x, arma::conv_to<arma::fvec>::from(mean),
+      arma::conv_to<arma::fmat>::from(invCovLower), logProbabilities);
+}
+
+template<typename eT>
+void GaussianDistribution::BatchLogProbability(
+    const arma::Mat<eT>& x,
+    const arma::Col<eT>& m,
+    const arma::Mat<eT>& invLower,
+    arma::Col<eT>& logProbabilities) const
+{
+  const size_t k = x.n_rows;
+  const size_t numBlocks = (x.n_cols + BlockSize - 1) / BlockSize;
+  const eT constant = eT(-0.5 * k * log2pi - 0.5 * logDetCov);
+  logProbabilities.set_size(x.n_cols);
+
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    // The quadratic form of x is ||L^-1 (x - mean)||^2, which is computed with
+    // one matrix multiplication per block of points.
+    arma::Mat<eT> diffs, z;
+
+    #pragma omp for schedule(static)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * BlockSize;
+      const size_t end = std::min(begin + (size_t) BlockSize,
+          (size_t) x.n_cols);
+      diffs = x.cols(begin, end - 1);
+      diffs.each_col() -= m;
+      z = invLower * diffs;
+
+      for (size_t j = 0; j < z.n_cols; ++j)
+      {
+        const eT* zj = z.colptr(j);
+        eT quadratic = 0;
+        #pragma omp simd reduction(+:quadratic)
+        for (size_t i = 0; i < k; ++i)
+          quadratic += zj[i] * zj[i];
+
+        logProbabilities[begin + j] = constant - quadratic / 2;
+      }
+    }
+  }
 }
 
 inline arma::vec GaussianDistribution::Random() const
@@ -14,6 +14,9 @@
 
 #include <mlpack/core.hpp>
 
+#include <exception>
+#include <map>
+
 namespace mlpack {
 
 /**
@@ -65,13 +68,29 @@ class CVFunction
              const BoundArgs&... args);
 
   /**
-   * Run cross-validation with the bound and passed parameters.
+   * Run cross-validation with the bound and passed parameters.  The objective
+   * of each set of parameters is cached, so cross-validation is run only once
+   * for each set of parameters.
    *
    * @param parameters Arguments (rather than the bound arguments) that should
    *     be passed into the Evaluate method of the CVType object.
    */
   double Evaluate(const arma::mat& parameters);
 
+  /**
+   * Run cross-validation for each of the given sets of parameters, at the same
+   * time in different threads (each with its own model), and cache the
+   * objectives so that later calls to Evaluate() with these parameters return
+   * at once.  The best model is updated as if the sets of parameters were given
+   * to Evaluate() one after another, in order.  The CVType object must have an
+   * EvaluateModel() method that can be called from several threads at once (as
+   * SimpleCV and KFoldCV have).
+   *
+   * @param points Sets of parameters to evaluate.
+   * @return The objective of each set of parameters.
+   */
+  arma::vec EvaluatePoints(const std::vector<arma::mat>& points);
+
   /**
    * Evaluate numerically the gradient of the CVFunction with the given
    * parameters.
@@ -124,6 +143,22 @@ class CVFunction
   //! Minimum absolute increase of arguments for calculation of gradient.
   double minDelta;
 
+  //! The objectives of the sets of parameters that have been evaluated.
+  std::map<std::vector<double>, double> cache;
+
+  /**
+   * Replace the best model with the given one if the objective is better, or
+   * if no model has been assigned yet.
+   */
+  void UpdateBestModel(const double objective, MLAlgorithm& model);
+
+  /**
+   * Collect all arguments and run cross-validation.  If model is not null, the
+   * trained model is stored there rather than in the CVType object.
+   */
+  inline double Evaluate(const arma::mat& parameters,
+                         std::unique_ptr<MLAlgorithm>* model);
+
   /**
    * Collect all arguments and run cross-validation.
    */
@@ -132,7 +167,9 @@ class CVFunction
            typename... Args,
            typename = typename
                std::enable_if<(BoundArgIndex + ParamIndex < TotalArgs)>::type>
-  inline double Evaluate(const arma::mat& parameters, const Args&... args);
+  inline double Evaluate(const arma::mat& parameters,
+                         std::unique_ptr<MLAlgorithm>* model,
+                         const Args&... args);
 
   /**
    * Run cross-validation with the collected arguments.
@@ -143,7 +180,9 @@ class CVFunction
            typename = typename
                std::enable_if<BoundArgIndex + ParamIndex == TotalArgs>::type,
            typename = void>
-  inline double Evaluate(const arma::mat& parameters, const Args&... args);
+  inline double Evaluate(const arma::mat& parameters,
+                         std::unique_ptr<MLAlgorithm>* model,
+                         const Args&... args);
 
   /**
    * Put the bound argument (at the BoundArgIndex position) as the next one.
@@ -153,7 +192,9 @@ class CVFunction
            typename... Args,
            typename = typename std::enable_if<
                UseBoundArg<BoundArgIndex, ParamIndex>::value>::type>
-  inline double PutNextArg(const arma::mat& parameters, const Args&... args);
+  inline double PutNextArg(const arma::mat& parameters,
+                           std::unique_ptr<MLAlgorithm>* model,
+                           const Args&... args);
 
   /**
    * Put the element (at the ParamIndex position) of the parameters as the next
@@ -165,7 +206,9 @@ class CVFunction
            typename = typename std::enable_if<
                !UseBoundArg<BoundArgIndex, ParamIndex>::value>::type,
            typename = void>
-  inline double PutNextArg(const arma::mat& parameters, const Args&... args);
+  inline double PutNextArg(const arma::mat& parameters,
+                           std::unique_ptr<MLAlgorithm>* model,
+                           const Args&... args);
 };
 
 
@@ -64,7 +64,125 @@ template<typename CVType,
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& parameters)
 {
-  return Evaluate<0, 0>(parameters);
+  const std::vector<double> key(parameters.begin(), parameters.end());
+  typename std::map<std::vector<double>, double>::const_iterator it =
+      cache.find(key);
+  if (it != cache.end())
+    return it->second;
+
+  const double objective = Evaluate(parameters, nullptr);
+  UpdateBestModel(objective, cv.Model());
+  cache[key] = objective;
+
+  return objective;
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+arma::vec CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::
+EvaluatePoints(const std::vector<arma::mat>& points)
+{
+  // Find the sets of parameters that have not been evaluated yet, without
+  // duplicates.
+  std::vector<size_t> toEvaluate;
+  std::map<std::vector<double>, size_t> seen;
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    const std::vector<double> key(points[i].begin(), points[i].end());
+    if (cache.count(key) == 0 && seen.count(key) == 0)
+    {
+      seen[key] = i;
+      toEvaluate.push_back(i);
+    }
+  }
+
+  // The best model of this batch is kept as it is found; ties are broken as
+  // in a serial run, by the order of the sets of parameters.
+  arma::vec objectives(toEvaluate.size());
+  std::unique_ptr<MLAlgorithm> batchBestModel;
+  size_t batchBestIndex = toEvaluate.size();
+  std::exception_ptr exception;
+
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t j = 0; j < toEvaluate.size(); ++j)
+  {
+    try
+    {
+      std::unique_ptr<MLAlgorithm> model;
+      objectives[j] = Evaluate(points[toEvaluate[j]], &model);
+
+      #pragma omp critical
+      {
+        if (batchBestIndex == toEvaluate.size() ||
+            objectives[j] < objectives[batchBestIndex] ||
+            (objectives[j] == objectives[batchBestIndex] &&
+             j < batchBestIndex))
+        {
+          batchBestIndex = j;
+          batchBestModel = std::move(model);
+        }
+      }
+    }
+    catch (...)
+    {
+      #pragma omp critical
+      {
+        if (!exception)
+          exception = std::current_exception();
+      }
+    }
+  }
+
+  if (exception)
+    std::rethrow_exception(exception);
+
+  for (size_t j = 0; j < toEvaluate.size(); ++j)
+  {
+    const arma::mat& point = points[toEvaluate[j]];
+    cache[std::vector<double>(point.begin(), point.end())] = objectives[j];
+  }
+
+  if (batchBestModel)
+    UpdateBestModel(objectives[batchBestIndex], *batchBestModel);
+
+  arma::vec result(points.size());
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    result[i] = cache[std::vector<double>(points[i].begin(),
+        points[i].end())];
+  }
+
+  return result;
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+void CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::
+UpdateBestModel(const double objective, MLAlgorithm& model)
+{
+  // Change the best model if we have got a better score, or if we probably
+  // have not assigned any valid (trained) model yet.
+  if (bestObjective > objective ||
+      bestObjective == std::numeric_limits<double>::max())
+  {
+    bestObjective = objective;
+    bestModel = std::move(model);
+  }
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
+    const arma::mat& parameters,
+    std::unique_ptr<MLAlgorithm>* model)
+{
+  return Evaluate<0, 0>(parameters, model);
 }
 
 template<typename CVType,
@@ -98,9 +216,10 @@ template<size_t BoundArgIndex,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& parameters,
+    std::unique_ptr<MLAlgorithm>* model,
     const Args&... args)
 {
-  return PutNextArg<BoundArgIndex, ParamIndex>(parameters, args...);
+  return PutNextArg<BoundArgIndex, ParamIndex>(parameters, model, args...);
 }
 
 template<typename CVType,
@@ -114,20 +233,13 @@ template<size_t BoundArgIndex,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& /* parameters */,
+    std::unique_ptr<MLAlgorithm>* model,
     const Args&... args)
 {
-  double objective = cv.Evaluate(args...);
-
-  // Change the best model if we have got a better score, or if we probably
-  // have not assigned any valid (trained) model yet.
-  if (bestObjective > objective ||
-      bestObjective == std::numeric_limits<double>::max())
-  {
-    bestObjective = objective;
-    bestModel = std::move(cv.Model());
-  }
-
-  return objective;
+  if (model == nullptr)
+    return cv.Evaluate(args...);
+  else
+    return cv.EvaluateModel(*model, args...);
 }
 
 template<typename CVType,
@@ -140,10 +252,11 @@ template<size_t BoundArgIndex,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::PutNextArg(
     const arma::mat& parameters,
+    std::unique_ptr<MLAlgorithm>* model,
     const Args&... args)
 {
   return Evaluate<BoundArgIndex + 1, ParamIndex>(
-      parameters, args..., std::get<BoundArgIndex>(boundArgs).value);
+      parameters, model, args..., std::get<BoundArgIndex>(boundArgs).value);
 }
 
 template<typename CVType,
@@ -157,16 +270,17 @@ template<size_t BoundArgIndex,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::PutNextArg(
     const arma::mat& parameters,
+    std::unique_ptr<MLAlgorithm>* model,
     const Args&... args)
 {
   if (datasetInfo.Type(ParamIndex) == data::Datatype::categorical)
   {
-    return Evaluate<BoundArgIndex, ParamIndex + 1>(parameters, args...,
+    return Evaluate<BoundArgIndex, ParamIndex + 1>(parameters, model, args...,
         datasetInfo.UnmapString(size_t(parameters(ParamIndex, 0)), ParamIndex));
   }
   else
   {
-    return Evaluate<BoundArgIndex, ParamIndex + 1>(parameters, args...,
+    return Evaluate<BoundArgIndex, ParamIndex + 1>(parameters, model, args...,
         parameters(ParamIndex, 0));
   }
 }
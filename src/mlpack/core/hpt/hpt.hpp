@@ -67,6 +67,13 @@ namespace mlpack {
  *     Fixed(useCholesky), lambda1Set, lambda2Set);
  * @endcode
  *
+ * If Parallel() is set to true and every hyper-parameter that is not fixed is
+ * chosen from a set of values (as with GridSearch), all the combinations of
+ * values are cross-validated at the same time in different threads, each with
+ * its own model, before the optimizer is run; the optimizer then gets the
+ * cached results.  With any optimizer, each set of hyper-parameters is
+ * cross-validated only once.
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam CV A cross-validation strategy used to assess a set of
@@ -150,6 +157,22 @@ class HyperParameterTuner
    */
   double& MinDelta() { return minDelta; }
 
+  /**
+   * Get whether the sets of values of the hyper-parameters are
+   * cross-validated in parallel.
+   *
+   * The default value is false.
+   */
+  bool Parallel() const { return parallel; }
+
+  /**
+   * Modify whether the sets of values of the hyper-parameters are
+   * cross-validated in parallel.
+   *
+   * The default value is false.
+   */
+  bool& Parallel() { return parallel; }
+
   /**
    * Find the best hyper-parameters by using the given Optimizer. For each
    * hyper-parameter one of the following should be passed as an argument.
@@ -229,6 +252,9 @@ class HyperParameterTuner
    */
   double minDelta;
 
+  //! Whether the sets of hyper-parameters are cross-validated in parallel.
+  bool parallel;
+
   /**
    * A type function to check whether the element I of the tuple type is a
    * PreFixedArg.
@@ -31,7 +31,7 @@ HyperParameterTuner<MLAlgorithm,
                     MatType,
                     PredictionsType,
                     WeightsType>::HyperParameterTuner(const CVArgs&... args) :
-    cv(args...), relativeDelta(0.01), minDelta(1e-10) {}
+    cv(args...), relativeDelta(0.01), minDelta(1e-10), parallel(false) {}
 
 template<typename MLAlgorithm,
          typename Metric,
@@ -103,6 +103,30 @@ void HyperParameterTuner<MLAlgorithm,
 
   CVFunction<CVType, MLAlgorithm, totalArgs, FixedArgs...>
       cvFunction(cv, datasetInfo, relativeDelta, minDelta, fixedArgs...);
+
+  // If every hyper-parameter is chosen from a set of values, cross-validate
+  // all the combinations of values in parallel; the optimizer then gets the
+  // cached objectives.  The combinations are listed in the order GridSearch
+  // visits them, with the first hyper-parameter changing the slowest.
+  const bool allCategorical = std::all_of(categoricalDimensions.begin(),
+      categoricalDimensions.end(), [](const bool c) { return c; });
+  if (parallel && allCategorical && !categoricalDimensions.empty())
+  {
+    std::vector<arma::mat> points(arma::prod(numCategories));
+    for (size_t p = 0; p < points.size(); ++p)
+    {
+      points[p].set_size(numCategories.n_elem, 1);
+      size_t index = p;
+      for (size_t d = numCategories.n_elem; d > 0; --d)
+      {
+        points[p](d - 1) = index % numCategories[d - 1];
+        index /= numCategories[d - 1];
+      }
+    }
+
+    cvFunction.EvaluatePoints(points);
+  }
+
   bestObjective = Metric::NeedsMinimization ? optimizer.Optimize(cvFunction,
       bestParams, categoricalDimensions, numCategories) :
       -optimizer.Optimize(cvFunction, bestParams, categoricalDimensions,
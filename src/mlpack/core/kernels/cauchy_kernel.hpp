@@ -61,12 +61,33 @@ class CauchyKernel
    * @return K(a, b).
    */
   template<typename VecTypeA, typename VecTypeB>
-  double Evaluate(const VecTypeA& a, const VecTypeB& b)
+  double Evaluate(const VecTypeA& a, const VecTypeB& b) const
   {
     return 1 / (1 + (
         std::pow(EuclideanDistance::Evaluate(a, b) / bandwidth, 2)));
   }
 
+  /**
+   * Evaluate the Cauchy kernel between every point of a and every point of b,
+   * so that output(i, j) = K(a.col(i), b.col(j)).  The squared distances are
+   * computed with one matrix multiplication.
+   *
+   * @tparam MatTypeA Type of first matrix (likely arma::mat or arma::sp_mat).
+   * @tparam MatTypeB Type of second matrix.
+   * @tparam OutputMatType Type of the output matrix (likely arma::mat).
+   * @param a First set of points, one column per point.
+   * @param b Second set of points, one column per point.
+   * @param output Matrix to store the a.n_cols x b.n_cols kernel values in.
+   */
+  template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+  void Evaluate(const MatTypeA& a,
+                const MatTypeB& b,
+                OutputMatType& output) const
+  {
+    SquaredEuclideanDistance::Evaluate(a, b, output);
+    output = 1 / (1 + output / (bandwidth * bandwidth));
+  }
+
   /**
    * Serialize the kernel.
    */
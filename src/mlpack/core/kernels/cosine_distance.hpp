@@ -40,6 +40,20 @@ class CosineDistance
   template<typename VecTypeA, typename VecTypeB>
   static double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Computes the cosine distance between every point of a and every point of
+   * b, so that output(i, j) = d(a.col(i), b.col(j)).  The dot products are
+   * computed with one matrix multiplication.
+   *
+   * @param a First set of points, one column per point.
+   * @param b Second set of points, one column per point.
+   * @param output Matrix to store the a.n_cols x b.n_cols distances in.
+   */
+  template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+  static void Evaluate(const MatTypeA& a,
+                       const MatTypeB& b,
+                       OutputMatType& output);
+
   //! Serialize the class (there's nothing to save).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
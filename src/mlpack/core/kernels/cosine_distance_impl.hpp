@@ -31,6 +31,25 @@ double CosineDistance::Evaluate(const VecTypeA& a, const VecTypeB& b)
     return dot(a, b) / denominator;
 }
 
+template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+void CosineDistance::Evaluate(const MatTypeA& a,
+                              const MatTypeB& b,
+                              OutputMatType& output)
+{
+  typedef typename OutputMatType::elem_type ElemType;
+
+  // As above, the distance to a point with zero norm is 0; that is what we get
+  // by dividing by 1 instead.
+  arma::Col<ElemType> aNorms(arma::sqrt(arma::sum(arma::square(a), 0)).t());
+  arma::Row<ElemType> bNorms(arma::sqrt(arma::sum(arma::square(b), 0)));
+  aNorms.replace(ElemType(0), ElemType(1));
+  bNorms.replace(ElemType(0), ElemType(1));
+
+  output = a.t() * b;
+  output.each_col() /= aNorms;
+  output.each_row() /= bNorms;
+}
+
 } // namespace mlpack
 
 #endif
@@ -50,6 +50,23 @@ class EpanechnikovKernel
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b) const;
 
+  /**
+   * Evaluate the Epanechnikov kernel between every point of a and every point
+   * of b, so that output(i, j) = K(a.col(i), b.col(j)).  The squared distances
+   * are computed with one matrix multiplication.
+   *
+   * @tparam MatTypeA Type of first matrix.
+   * @tparam MatTypeB Type of second matrix.
+   * @tparam OutputMatType Type of the output matrix.
+   * @param a One set of points, one column per point.
+   * @param b The other set of points, one column per point.
+   * @param output Matrix to store the a.n_cols x b.n_cols kernel values in.
+   */
+  template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+  void Evaluate(const MatTypeA& a,
+                const MatTypeB& b,
+                OutputMatType& output) const;
+
   /**
    * Evaluate the Epanechnikov kernel given that the distance between the two
    * input points is known.
@@ -28,6 +28,19 @@ inline double EpanechnikovKernel::Evaluate(const VecTypeA& a, const VecTypeB& b)
       * inverseBandwidthSquared);
 }
 
+template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+inline void EpanechnikovKernel::Evaluate(const MatTypeA& a,
+                                         const MatTypeB& b,
+                                         OutputMatType& output) const
+{
+  typedef typename OutputMatType::elem_type ElemType;
+
+  SquaredEuclideanDistance::Evaluate(a, b, output);
+  const ElemType scale = (ElemType) inverseBandwidthSquared;
+  output.transform([scale](const ElemType d)
+      { return std::max(ElemType(0), ElemType(1) - d * scale); });
+}
+
 /**
  * Compute the normalizer of this Epanechnikov kernel for the given dimension.
  *
@@ -67,6 +67,27 @@ class GaussianKernel
     return std::exp(gamma * SquaredEuclideanDistance::Evaluate(a, b));
   }
 
+  /**
+   * Evaluate the Gaussian kernel between every point of a and every point of
+   * b, so that output(i, j) = K(a.col(i), b.col(j)).  The squared distances are
+   * computed with one matrix multiplication.
+   *
+   * @tparam MatTypeA Type of first matrix (likely arma::mat or arma::sp_mat).
+   * @tparam MatTypeB Type of second matrix.
+   * @tparam OutputMatType Type of the output matrix (likely arma::mat).
+   * @param a First set of points, one column per point.
+   * @param b Second set of points, one column per point.
+   * @param output Matrix to store the a.n_cols x b.n_cols kernel values in.
+   */
+  template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+  void Evaluate(const MatTypeA& a,
+                const MatTypeB& b,
+                OutputMatType& output) const
+  {
+    SquaredEuclideanDistance::Evaluate(a, b, output);
+    output = arma::exp(gamma * output);
+  }
+
   /**
    * Evaluation of the Gaussian kernel given the distance between two points.
    *
@@ -56,11 +56,33 @@ class HyperbolicTangentKernel
    * @return K(a, b).
    */
   template<typename VecTypeA, typename VecTypeB>
-  double Evaluate(const VecTypeA& a, const VecTypeB& b)
+  double Evaluate(const VecTypeA& a, const VecTypeB& b) const
   {
     return tanh(scale * dot(a, b) + offset);
   }
 
+  /**
+   * Evaluate the hyperbolic tangent kernel between every point of a and every
+   * point of b, so that output(i, j) = K(a.col(i), b.col(j)).  The dot products
+   * are computed with one matrix multiplication.
+   *
+   * @tparam MatTypeA Type of first matrix (should be arma::mat or
+   *      arma::sp_mat).
+   * @tparam MatTypeB Type of second matrix (arma::mat / arma::sp_mat).
+   * @tparam OutputMatType Type of the output matrix (arma::mat).
+   * @param a First set of points, one column per point.
+   * @param b Second set of points, one column per point.
+   * @param output Matrix to store the a.n_cols x b.n_cols kernel values in.
+   */
+  template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+  void Evaluate(const MatTypeA& a,
+                const MatTypeB& b,
+                OutputMatType& output) const
+  {
+    output = a.t() * b;
+    output = arma::tanh(scale * output + offset);
+  }
+
   //! Get scale factor.
   double Scale() const { return scale; }
   //! Modify scale factor.
@@ -0,0 +1,182 @@
+/**
+ * @file core/kernels/kernel_matrix.hpp
+ *
+ * Functions to compute the kernel matrix between two sets of points, one tile
+ * at a time and in parallel, with the batch Evaluate() method of the kernel if
+ * it has one.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
+
+namespace mlpack {
+
+/**
+ * HasBatchEvaluate<KernelType>::value is true if the kernel has a batch
+ * `Evaluate(a, b, output)` method that computes the kernel values between all
+ * the points of the matrices a and b at once (as GaussianKernel, LinearKernel,
+ * PolynomialKernel, LaplacianKernel, EpanechnikovKernel, CauchyKernel,
+ * HyperbolicTangentKernel, TriangularKernel, SphericalKernel and
+ * CosineDistance do).
+ */
+template<typename KernelType, typename = void>
+struct HasBatchEvaluate : std::false_type { };
+
+template<typename KernelType>
+struct HasBatchEvaluate<KernelType, decltype(
+    std::declval<const KernelType&>().Evaluate(
+        std::declval<const arma::mat&>(),
+        std::declval<const arma::mat&>(),
+        std::declval<arma::mat&>()), void())> : std::true_type { };
+
+/**
+ * Compute the kernel values between the points of a in [rowBegin, rowEnd) and
+ * the points of b in [colBegin, colEnd), with the batch Evaluate() method of
+ * the kernel.
+ */
+template<typename KernelType, typename MatTypeA, typename MatTypeB,
+         typename eT>
+void KernelMatrixTile(KernelType& kernel,
+                      const MatTypeA& a,
+                      const MatTypeB& b,
+                      const size_t rowBegin,
+                      const size_t rowEnd,
+                      const size_t colBegin,
+                      const size_t colEnd,
+                      arma::Mat<eT>& tile,
+                      const std::true_type& /* hasBatchEvaluate */)
+{
+  kernel.Evaluate(a.cols(rowBegin, rowEnd - 1), b.cols(colBegin, colEnd - 1),
+      tile);
+}
+
+/**
+ * Compute the kernel values between the points of a in [rowBegin, rowEnd) and
+ * the points of b in [colBegin, colEnd), one pair of points at a time, for
+ * kernels without a batch Evaluate() method.
+ */
+template<typename KernelType, typename MatTypeA, typename MatTypeB,
+         typename eT>
+void KernelMatrixTile(KernelType& kernel,
+                      const MatTypeA& a,
+                      const MatTypeB& b,
+                      const size_t rowBegin,
+                      const size_t rowEnd,
+                      const size_t colBegin,
+                      const size_t colEnd,
+                      arma::Mat<eT>& tile,
+                      const std::false_type& /* hasBatchEvaluate */)
+{
+  tile.set_size(rowEnd - rowBegin, colEnd - colBegin);
+  for (size_t j = colBegin; j < colEnd; ++j)
+    for (size_t i = rowBegin; i < rowEnd; ++i)
+      tile(i - rowBegin, j - colBegin) = kernel.Evaluate(a.col(i), b.col(j));
+}
+
+/**
+ * Compute the kernel matrix between the points of a and the points of b, so
+ * that output(i, j) = K(a.col(i), b.col(j)).  The matrix is computed in square
+ * tiles of tileSize x tileSize kernel values, in parallel if OpenMP is
+ * enabled; each tile is computed with one call to the batch Evaluate() method
+ * of the kernel if it has one (see HasBatchEvaluate), or one pair of points at
+ * a time otherwise.  The kernel must be safe to evaluate from several threads.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param a First set of points, one column per point.
+ * @param b Second set of points, one column per point.
+ * @param output Matrix to store the a.n_cols x b.n_cols kernel values in.
+ * @param tileSize Number of points of each side of a tile.
+ */
+template<typename KernelType, typename MatTypeA, typename MatTypeB,
+         typename eT>
+void KernelMatrix(KernelType& kernel,
+                  const MatTypeA& a,
+                  const MatTypeB& b,
+                  arma::Mat<eT>& output,
+                  const size_t tileSize = 256)
+{
+  if (tileSize == 0)
+  {
+    throw std::invalid_argument("KernelMatrix(): the tile size must be "
+        "positive!");
+  }
+
+  output.set_size(a.n_cols, b.n_cols);
+  const size_t rowTiles = (a.n_cols + tileSize - 1) / tileSize;
+  const size_t colTiles = (b.n_cols + tileSize - 1) / tileSize;
+
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t t = 0; t < rowTiles * colTiles; ++t)
+  {
+    const size_t rowBegin = (t % rowTiles) * tileSize;
+    const size_t rowEnd = std::min(rowBegin + tileSize, (size_t) a.n_cols);
+    const size_t colBegin = (t / rowTiles) * tileSize;
+    const size_t colEnd = std::min(colBegin + tileSize, (size_t) b.n_cols);
+
+    arma::Mat<eT> tile;
+    KernelMatrixTile(kernel, a, b, rowBegin, rowEnd, colBegin, colEnd, tile,
+        HasBatchEvaluate<KernelType>());
+    output.submat(rowBegin, colBegin, rowEnd - 1, colEnd - 1) = tile;
+  }
+}
+
+/**
+ * Compute the symmetric kernel matrix of the given points, so that
+ * output(i, j) = K(data.col(i), data.col(j)).  Only the tiles of the upper
+ * triangular part are computed (see KernelMatrix()), and the upper triangular
+ * part is then copied to the lower triangular part.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param data Set of points, one column per point.
+ * @param output Matrix to store the data.n_cols x data.n_cols kernel values
+ *     in.
+ * @param tileSize Number of points of each side of a tile.
+ */
+template<typename KernelType, typename MatType, typename eT>
+void SymmetricKernelMatrix(KernelType& kernel,
+                           const MatType& data,
+                           arma::Mat<eT>& output,
+                           const size_t tileSize = 256)
+{
+  if (tileSize == 0)
+  {
+    throw std::invalid_argument("SymmetricKernelMatrix(): the tile size must "
+        "be positive!");
+  }
+
+  output.set_size(data.n_cols, data.n_cols);
+  const size_t tiles = (data.n_cols + tileSize - 1) / tileSize;
+
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t t = 0; t < tiles * tiles; ++t)
+  {
+    const size_t rowTile = t % tiles;
+    const size_t colTile = t / tiles;
+    if (rowTile > colTile)
+      continue;
+
+    const size_t rowBegin = rowTile * tileSize;
+    const size_t rowEnd = std::min(rowBegin + tileSize, (size_t) data.n_cols);
+    const size_t colBegin = colTile * tileSize;
+    const size_t colEnd = std::min(colBegin + tileSize, (size_t) data.n_cols);
+
+    arma::Mat<eT> tile;
+    KernelMatrixTile(kernel, data, data, rowBegin, rowEnd, colBegin, colEnd,
+        tile, HasBatchEvaluate<KernelType>());
+    output.submat(rowBegin, colBegin, rowEnd - 1, colEnd - 1) = tile;
+  }
+
+  // Copy the upper triangular part to the lower triangular part.
+  output = arma::symmatu(output);
+}
+
+} // namespace mlpack
+
+#endif
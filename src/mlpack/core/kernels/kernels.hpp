@@ -20,6 +20,7 @@
 #include "example_kernel.hpp"
 #include "gaussian_kernel.hpp"
 #include "hyperbolic_tangent_kernel.hpp"
+#include "kernel_matrix.hpp"
 #include "laplacian_kernel.hpp"
 #include "linear_kernel.hpp"
 #include "polynomial_kernel.hpp"
@@ -54,6 +54,27 @@ class LinearKernel
     return dot(a, b);
   }
 
+  /**
+   * Evaluate the linear kernel between every point of a and every point of b,
+   * so that output(i, j) = K(a.col(i), b.col(j)), with one matrix
+   * multiplication.
+   *
+   * @tparam MatTypeA Type of first matrix (should be arma::mat or
+   *      arma::sp_mat).
+   * @tparam MatTypeB Type of second matrix (arma::mat / arma::sp_mat).
+   * @tparam OutputMatType Type of the output matrix (arma::mat).
+   * @param a First set of points, one column per point.
+   * @param b Second set of points, one column per point.
+   * @param output Matrix to store the a.n_cols x b.n_cols kernel values in.
+   */
+  template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+  static void Evaluate(const MatTypeA& a,
+                       const MatTypeB& b,
+                       OutputMatType& output)
+  {
+    output = a.t() * b;
+  }
+
   //! Serialize the kernel (it has no members... do nothing).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
@@ -56,6 +56,28 @@ class PolynomialKernel
     return std::pow((dot(a, b) + offset), degree);
   }
 
+  /**
+   * Evaluate the polynomial kernel between every point of a and every point of
+   * b, so that output(i, j) = K(a.col(i), b.col(j)).  The dot products are
+   * computed with one matrix multiplication.
+   *
+   * @tparam MatTypeA Type of first matrix (should be arma::mat or
+   *      arma::sp_mat).
+   * @tparam MatTypeB Type of second matrix (arma::mat / arma::sp_mat).
+   * @tparam OutputMatType Type of the output matrix (arma::mat).
+   * @param a First set of points, one column per point.
+   * @param b Second set of points, one column per point.
+   * @param output Matrix to store the a.n_cols x b.n_cols kernel values in.
+   */
+  template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+  void Evaluate(const MatTypeA& a,
+                const MatTypeB& b,
+                OutputMatType& output) const
+  {
+    output = a.t() * b;
+    output = arma::pow(output + offset, degree);
+  }
+
   //! Get the degree of the polynomial.
   const double& Degree() const { return degree; }
   //! Modify the degree of the polynomial.
@@ -11,6 +11,7 @@
 #define MLPACK_CORE_KERNELS_SPHERICAL_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 
 namespace mlpack {
 
@@ -45,6 +46,31 @@ class SphericalKernel
         1.0 : 0.0;
   }
 
+  /**
+   * Evaluate the spherical kernel between every point of a and every point of
+   * b, so that output(i, j) = K(a.col(i), b.col(j)).  The squared distances are
+   * computed with one matrix multiplication.
+   *
+   * @tparam MatTypeA Type of first matrix.
+   * @tparam MatTypeB Type of second matrix.
+   * @tparam OutputMatType Type of the output matrix.
+   * @param a First set of points, one column per point.
+   * @param b Second set of points, one column per point.
+   * @param output Matrix to store the a.n_cols x b.n_cols kernel values in.
+   */
+  template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+  void Evaluate(const MatTypeA& a,
+                const MatTypeB& b,
+                OutputMatType& output) const
+  {
+    typedef typename OutputMatType::elem_type ElemType;
+
+    SquaredEuclideanDistance::Evaluate(a, b, output);
+    const ElemType radius = (ElemType) bandwidthSquared;
+    output.transform([radius](const ElemType d)
+        { return (d <= radius) ? ElemType(1) : ElemType(0); });
+  }
+
   double Normalizer(size_t dimension) const
   {
     return std::pow(bandwidth, (double) dimension) *
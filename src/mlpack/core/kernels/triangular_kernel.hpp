@@ -50,6 +50,31 @@ class TriangularKernel
     return std::max(0.0, (1 - EuclideanDistance::Evaluate(a, b) / bandwidth));
   }
 
+  /**
+   * Evaluate the triangular kernel between every point of a and every point of
+   * b, so that output(i, j) = K(a.col(i), b.col(j)).  The distances are
+   * computed with one matrix multiplication.
+   *
+   * @tparam MatTypeA Type of first matrix.
+   * @tparam MatTypeB Type of second matrix.
+   * @tparam OutputMatType Type of the output matrix.
+   * @param a First set of points, one column per point.
+   * @param b Second set of points, one column per point.
+   * @param output Matrix to store the a.n_cols x b.n_cols kernel values in.
+   */
+  template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+  void Evaluate(const MatTypeA& a,
+                const MatTypeB& b,
+                OutputMatType& output) const
+  {
+    typedef typename OutputMatType::elem_type ElemType;
+
+    EuclideanDistance::Evaluate(a, b, output);
+    const ElemType scale = (ElemType) (1.0 / bandwidth);
+    output.transform([scale](const ElemType d)
+        { return std::max(ElemType(0), ElemType(1) - d * scale); });
+  }
+
   /**
    * Evaluate the triangular kernel given that the distance between the two
    * points is known.
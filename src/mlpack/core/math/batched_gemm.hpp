@@ -0,0 +1,61 @@
+/**
+ * @file core/math/batched_gemm.hpp
+ *
+ * Strided batched matrix multiplication on the slices of cubes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_BATCHED_GEMM_HPP
+#define MLPACK_CORE_MATH_BATCHED_GEMM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * Compute `C.slice(i) = alpha * op(A.slice(i)) * op(B.slice(i)) +
+ * beta * C.slice(i)` for every slice `i`, where `op()` optionally transposes
+ * its argument.  The slices of each cube are stored one after the other in
+ * memory, so this is a strided batched GEMM.  `A` or `B` may have a single
+ * slice; it is then shared by every product (i.e. it has a stride of zero),
+ * which is how a weight matrix is applied to a batch.
+ *
+ * When the shared operand allows it, the whole batch is computed with a single
+ * large GEMM instead of one small GEMM per slice: `op(A) * [B_0, ..., B_s]`
+ * when `A` is shared and `B` is not transposed, and `trans(B * [A_0, ...,
+ * A_s])` when `B` is shared and both operands are transposed.  Otherwise one
+ * GEMM is done per slice; when the slices are small, the slices are
+ * distributed over the OpenMP threads, since a single small GEMM is then
+ * dominated by the overhead of the call.
+ *
+ * If `beta` is zero, `C` is resized to the size of the result (and its
+ * previous contents are ignored); otherwise `C` must already have the size of
+ * the result.  `C` must not overlap `A` or `B`.  A `std::invalid_argument` is
+ * thrown if the sizes of the operands do not match.
+ *
+ * @param c Cube to store the result in.
+ * @param a First operand, with one slice or as many slices as the result.
+ * @param b Second operand, with one slice or as many slices as the result.
+ * @param aTranspose Whether the slices of `a` have to be transposed.
+ * @param bTranspose Whether the slices of `b` have to be transposed.
+ * @param alpha Scale of the products.
+ * @param beta Scale of the previous contents of `c`.
+ */
+template<typename CubeType>
+void BatchedGemm(CubeType& c,
+                 const CubeType& a,
+                 const CubeType& b,
+                 const bool aTranspose = false,
+                 const bool bTranspose = false,
+                 const typename CubeType::elem_type alpha = 1,
+                 const typename CubeType::elem_type beta = 0);
+
+} // namespace mlpack
+
+// Include implementation.
+#include "batched_gemm_impl.hpp"
+
+#endif
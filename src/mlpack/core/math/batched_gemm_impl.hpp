@@ -0,0 +1,173 @@
+/**
+ * @file core/math/batched_gemm_impl.hpp
+ *
+ * Implementation of strided batched matrix multiplication on the slices of
+ * cubes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_BATCHED_GEMM_IMPL_HPP
+#define MLPACK_CORE_MATH_BATCHED_GEMM_IMPL_HPP
+
+#include "batched_gemm.hpp"
+#include <mlpack/core/util/executor.hpp>
+
+namespace mlpack {
+
+/**
+ * Compute `c = alpha * op(a) * op(b) + beta * c` for single matrices.  The
+ * products are written so that Armadillo hands them to one GEMM call without
+ * any temporaries.
+ */
+template<typename eT>
+inline void BatchedGemmSlice(arma::Mat<eT>& c,
+                             const arma::Mat<eT>& a,
+                             const arma::Mat<eT>& b,
+                             const bool aTranspose,
+                             const bool bTranspose,
+                             const eT alpha,
+                             const eT beta)
+{
+  if (beta == eT(0))
+  {
+    if (aTranspose && bTranspose)
+      c = alpha * a.t() * b.t();
+    else if (aTranspose)
+      c = alpha * a.t() * b;
+    else if (bTranspose)
+      c = alpha * a * b.t();
+    else
+      c = alpha * a * b;
+  }
+  else
+  {
+    if (beta != eT(1))
+      c *= beta;
+
+    if (aTranspose && bTranspose)
+      c += alpha * a.t() * b.t();
+    else if (aTranspose)
+      c += alpha * a.t() * b;
+    else if (bTranspose)
+      c += alpha * a * b.t();
+    else
+      c += alpha * a * b;
+  }
+}
+
+template<typename CubeType>
+void BatchedGemm(CubeType& c,
+                 const CubeType& a,
+                 const CubeType& b,
+                 const bool aTranspose,
+                 const bool bTranspose,
+                 const typename CubeType::elem_type alpha,
+                 const typename CubeType::elem_type beta)
+{
+  typedef typename CubeType::elem_type eT;
+  typedef arma::Mat<eT> MatType;
+
+  const size_t slices = std::max(a.n_slices, b.n_slices);
+  if ((a.n_slices != slices && a.n_slices != 1) ||
+      (b.n_slices != slices && b.n_slices != 1))
+  {
+    std::ostringstream oss;
+    oss << "BatchedGemm(): number of slices of the operands (" << a.n_slices
+        << " and " << b.n_slices << ") must match, or one operand must have "
+        << "a single slice!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t m = aTranspose ? a.n_cols : a.n_rows;
+  const size_t k = aTranspose ? a.n_rows : a.n_cols;
+  const size_t n = bTranspose ? b.n_rows : b.n_cols;
+  if ((bTranspose ? b.n_cols : b.n_rows) != k)
+  {
+    std::ostringstream oss;
+    oss << "BatchedGemm(): inner dimensions of the slices of the operands ("
+        << k << " and " << (bTranspose ? b.n_cols : b.n_rows)
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (beta == eT(0))
+  {
+    c.set_size(m, n, slices);
+  }
+  else if (c.n_rows != m || c.n_cols != n || c.n_slices != slices)
+  {
+    std::ostringstream oss;
+    oss << "BatchedGemm(): size of the result (" << c.n_rows << " x "
+        << c.n_cols << " x " << c.n_slices << ") must be " << m << " x " << n
+        << " x " << slices << " when beta is not zero!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (c.n_elem == 0)
+    return;
+
+  // A shared first operand can be applied to all the slices of a
+  // non-transposed second operand at once, since these slices are the
+  // consecutive columns of one matrix.
+  if (a.n_slices == 1 && slices > 1 && !bTranspose)
+  {
+    const MatType aMat(const_cast<eT*>(a.memptr()), a.n_rows, a.n_cols,
+        false, true);
+    const MatType bAll(const_cast<eT*>(b.memptr()), k, n * slices, false,
+        true);
+    MatType cAll(c.memptr(), m, n * slices, false, true);
+    BatchedGemmSlice(cAll, aMat, bAll, aTranspose, false, alpha, beta);
+    return;
+  }
+
+  // Similarly, op(A_i) * op(B) = trans(B * A_i) for a shared second operand
+  // when both operands are transposed, so all the products can be computed at
+  // once and then transposed into place.
+  if (b.n_slices == 1 && slices > 1 && aTranspose && bTranspose)
+  {
+    const MatType aAll(const_cast<eT*>(a.memptr()), k, m * slices, false,
+        true);
+    const MatType bMat(const_cast<eT*>(b.memptr()), b.n_rows, b.n_cols,
+        false, true);
+    const MatType products = alpha * bMat * aAll;
+    for (size_t i = 0; i < slices; ++i)
+    {
+      MatType cSlice(c.slice_memptr(i), m, n, false, true);
+      if (beta == eT(0))
+      {
+        cSlice = trans(products.cols(i * m, (i + 1) * m - 1));
+      }
+      else
+      {
+        cSlice *= beta;
+        cSlice += trans(products.cols(i * m, (i + 1) * m - 1));
+      }
+    }
+    return;
+  }
+
+  // Otherwise, do one GEMM per slice.  A multithreaded BLAS already uses all
+  // the cores for large products; small products are instead distributed over
+  // the threads.
+  const bool parallel = (slices > 1) && (m * n * k <= 64 * 64 * 64);
+  #pragma omp parallel for if (parallel) num_threads((int) NumThreads())
+  for (size_t i = 0; i < slices; ++i)
+  {
+    // Aliases are used instead of Cube::slice(), which is not thread-safe.
+    const size_t aSlice = (a.n_slices == 1) ? 0 : i;
+    const size_t bSlice = (b.n_slices == 1) ? 0 : i;
+    const MatType aMat(const_cast<eT*>(a.slice_memptr(aSlice)), a.n_rows,
+        a.n_cols, false, true);
+    const MatType bMat(const_cast<eT*>(b.slice_memptr(bSlice)), b.n_rows,
+        b.n_cols, false, true);
+    MatType cSlice(c.slice_memptr(i), m, n, false, true);
+    BatchedGemmSlice(cSlice, aMat, bMat, aTranspose, bTranspose, alpha, beta);
+  }
+}
+
+} // namespace mlpack
+
+#endif
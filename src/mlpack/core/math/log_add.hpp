@@ -35,6 +35,19 @@ T LogAdd(T x, T y);
 template<typename T>
 typename T::elem_type AccuLog(const T& x);
 
+/**
+ * Log-sum the elementwise sum of two arrays of log values, without allocating
+ * any temporaries.  This is used in inner loops (such as the HMM forward and
+ * backward recursions), where x and y are columns of matrices.
+ *
+ * @param x array of n log values
+ * @param y array of n log values
+ * @param n number of elements in each array
+ * @return log(e^(x0 + y0) + e^(x1 + y1) + ...)
+ */
+template<typename eT>
+eT AccuLogSum(const eT* x, const eT* y, const size_t n);
+
 /**
  * Compute the sum of exponentials of each element in each column, then compute
  * the log of that.  If InPlace is true, then the values of `y` will also be
@@ -68,6 +68,29 @@ typename T::elem_type AccuLog(const T& x)
   return maxVal + std::log(sum(exp(x - maxVal)));;
 }
 
+/**
+ * Log-sum the elementwise sum of two arrays of log values.  The maximum is
+ * found first so that the exponentials cannot overflow; both loops are over
+ * contiguous memory and have no branches, so that the compiler can vectorize
+ * them.
+ */
+template<typename eT>
+eT AccuLogSum(const eT* x, const eT* y, const size_t n)
+{
+  eT maxVal = -std::numeric_limits<eT>::infinity();
+  for (size_t i = 0; i < n; ++i)
+    maxVal = std::max(maxVal, x[i] + y[i]);
+
+  if (maxVal == -std::numeric_limits<eT>::infinity())
+    return maxVal;
+
+  eT sum = 0;
+  for (size_t i = 0; i < n; ++i)
+    sum += std::exp(x[i] + y[i] - maxVal);
+
+  return maxVal + std::log(sum);
+}
+
 /**
  * Compute the sum of exponentials of each element in each column, then compute
  * the log of that.  If InPlace is true, then the values of `y` will also be
@@ -12,6 +12,7 @@
 #ifndef MLPACK_CORE_MATH_MATH_HPP
 #define MLPACK_CORE_MATH_MATH_HPP
 
+#include "batched_gemm.hpp"
 #include "ccov.hpp"
 #include "columns_to_blocks.hpp"
 #include "digamma.hpp"
@@ -17,6 +17,11 @@
 
 namespace mlpack {
 
+/**
+ * The functions below are convenience wrappers around BatchedGemm() that
+ * return the result in a new cube.
+ */
+
 /**
  * Matrix multiplication of slices of two cubes. This function expects
  * both cubes to have the same number of slices. For example, a valid operation
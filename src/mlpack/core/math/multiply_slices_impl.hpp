@@ -14,6 +14,7 @@
 #define MLPACK_CORE_MATH_MULTIPLY_SLICES_IMPL_HPP
 
 #include "multiply_slices.hpp"
+#include "batched_gemm.hpp"
 
 namespace mlpack {
 
@@ -23,8 +24,6 @@ CubeType MultiplyCube2Cube(const CubeType& cubeA,
     const bool aTranspose,
     const bool bTranspose)
 {
-  size_t rows = cubeA.n_rows, cols = cubeB.n_cols, slices = cubeA.n_slices;
-
   if (cubeA.n_slices != cubeB.n_slices)
     Log::Fatal << "Number of slices is not same in both cubes." << std::endl;
 
@@ -32,20 +31,16 @@ CubeType MultiplyCube2Cube(const CubeType& cubeA,
   {
     if (cubeA.n_rows != cubeB.n_cols)
       Log::Fatal << "Matrix multiplication invalid!" << std::endl;
-    rows = cubeA.n_cols;
-    cols = cubeB.n_rows;
   }
   else if (bTranspose && !aTranspose)
   {
     if (cubeA.n_cols != cubeB.n_cols)
       Log::Fatal << "Matrix multiplication invalid!" << std::endl;
-    cols = cubeB.n_rows;
   }
   else if (aTranspose && !bTranspose)
   {
     if (cubeA.n_rows != cubeB.n_rows)
       Log::Fatal << "Matrix multiplication invalid!" << std::endl;
-    rows = cubeA.n_cols;
   }
   else
   {
@@ -53,28 +48,8 @@ CubeType MultiplyCube2Cube(const CubeType& cubeA,
       Log::Fatal << "Matrix multiplication invalid!" << std::endl;
   }
 
-  CubeType z(rows, cols, slices);
-
-  if (aTranspose && bTranspose)
-  {
-    for (size_t i = 0; i < slices; ++i)
-      z.slice(i) = trans(cubeB.slice(i) * cubeA.slice(i));
-  }
-  else if (bTranspose && !aTranspose)
-  {
-    for (size_t i = 0; i < slices; ++i)
-      z.slice(i) = cubeA.slice(i) * cubeB.slice(i).t();
-  }
-  else if (aTranspose && !bTranspose)
-  {
-    for (size_t i = 0; i < slices; ++i)
-      z.slice(i) = cubeA.slice(i).t() * cubeB.slice(i);
-  }
-  else
-  {
-    for (size_t i = 0; i < slices; ++i)
-      z.slice(i) = cubeA.slice(i) * cubeB.slice(i);
-  }
+  CubeType z;
+  BatchedGemm(z, cubeA, cubeB, aTranspose, bTranspose);
   return z;
 }
 
@@ -84,26 +59,20 @@ CubeType MultiplyMat2Cube(const MatType& matA,
     const bool aTranspose,
     const bool bTranspose)
 {
-  size_t rows = matA.n_rows, cols = cubeB.n_cols, slices = cubeB.n_slices;
-
   if (aTranspose && bTranspose)
   {
     if (matA.n_rows != cubeB.n_cols)
       Log::Fatal << "Matrix multiplication invalid!" << std::endl;
-    rows = matA.n_cols;
-    cols = cubeB.n_rows;
   }
   else if (bTranspose && !aTranspose)
   {
     if (matA.n_cols != cubeB.n_cols)
       Log::Fatal << "Matrix multiplication invalid!" << std::endl;
-    cols = cubeB.n_rows;
   }
   else if (aTranspose && !bTranspose)
   {
     if (matA.n_rows != cubeB.n_rows)
       Log::Fatal << "Matrix multiplication invalid!" << std::endl;
-    rows = matA.n_cols;
   }
   else
   {
@@ -111,28 +80,13 @@ CubeType MultiplyMat2Cube(const MatType& matA,
       Log::Fatal << "Matrix multiplication invalid!" << std::endl;
   }
 
-  CubeType z(rows, cols, slices);
+  // The matrix is shared by all the slices.
+  typedef typename CubeType::elem_type eT;
+  const CubeType cubeA(const_cast<eT*>(matA.memptr()), matA.n_rows,
+      matA.n_cols, 1, false, true);
 
-  if (aTranspose && bTranspose)
-  {
-    for (size_t i = 0; i < slices; ++i)
-      z.slice(i) = trans(cubeB.slice(i) * matA);
-  }
-  else if (bTranspose)
-  {
-    for (size_t i = 0; i < slices; ++i)
-      z.slice(i) = matA * cubeB.slice(i).t();
-  }
-  else if (aTranspose)
-  {
-    for (size_t i = 0; i < slices; ++i)
-      z.slice(i) = matA.t() * cubeB.slice(i);
-  }
-  else
-  {
-    for (size_t i = 0; i < slices; ++i)
-      z.slice(i) = matA * cubeB.slice(i);
-  }
+  CubeType z;
+  BatchedGemm(z, cubeA, cubeB, aTranspose, bTranspose);
   return z;
 }
 
@@ -142,53 +96,32 @@ CubeType MultiplyCube2Mat(const CubeType& cubeA,
     const bool aTranspose,
     const bool bTranspose)
 {
-  size_t rows = cubeA.n_rows, cols = matB.n_cols, slices = cubeA.n_slices;
-
   if (aTranspose && bTranspose)
   {
     if (cubeA.n_rows != matB.n_cols)
       Log::Fatal << "Matrix multiplication invalid!" << std::endl;
-    rows = cubeA.n_cols;
-    cols = matB.n_rows;
   }
   else if (bTranspose && !aTranspose)
   {
     if (cubeA.n_cols != matB.n_cols)
       Log::Fatal << "Matrix multiplication invalid!" << std::endl;
-    cols = matB.n_rows;
   }
   else if (aTranspose && !bTranspose)
   {
     if (cubeA.n_rows != matB.n_rows)
       Log::Fatal << "Matrix multiplication invalid!" << std::endl;
-    rows = cubeA.n_cols;
   }
   else
     if (cubeA.n_cols != matB.n_rows)
       Log::Fatal << "Matrix multiplication invalid!" << std::endl;
 
-  CubeType z(rows, cols, slices);
+  // The matrix is shared by all the slices.
+  typedef typename CubeType::elem_type eT;
+  const CubeType cubeB(const_cast<eT*>(matB.memptr()), matB.n_rows,
+      matB.n_cols, 1, false, true);
 
-  if (aTranspose && bTranspose)
-  {
-    for (size_t i = 0; i < slices; ++i)
-      z.slice(i) = trans(matB * cubeA.slice(i));
-  }
-  else if (bTranspose && !aTranspose)
-  {
-    for (size_t i = 0; i < slices; ++i)
-      z.slice(i) = cubeA.slice(i) * matB.t();
-  }
-  else if (aTranspose && !bTranspose)
-  {
-    for (size_t i = 0; i < slices; ++i)
-      z.slice(i) = cubeA.slice(i).t() * matB;
-  }
-  else
-  {
-    for (size_t i = 0; i < slices; ++i)
-      z.slice(i) = cubeA.slice(i) * matB;
-  }
+  CubeType z;
+  BatchedGemm(z, cubeA, cubeB, aTranspose, bTranspose);
   return z;
 }
 
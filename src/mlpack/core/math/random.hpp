@@ -12,6 +12,7 @@
 #define MLPACK_CORE_MATH_RANDOM_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
 #include <random>
 
 namespace mlpack {
@@ -166,6 +167,318 @@ inline double RandNormal(const double mean, const double stddev)
   return stddev * RandNormalDist()(RandGen()) + mean;
 }
 
+/**
+ * A counter-based random number generator (Philox4x32-10), whose output is a
+ * function of a seed, a stream ID and the index of the number in the stream.
+ * Unlike RandGen(), which belongs to the thread that uses it, a RandomStream
+ * can be given to each task of a parallel computation (with the index of the
+ * task as its stream ID), so that the random numbers of each task do not
+ * depend on which thread runs it or on how many threads there are.  Creating
+ * a stream is also much cheaper than seeding a std::mt19937.
+ *
+ * RandomStream satisfies the requirements of a uniform random bit generator,
+ * so it can be used with the distributions of the standard library.
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{salmon2011parallel,
+ *   title = {Parallel Random Numbers: As Easy as 1, 2, 3},
+ *   author = {Salmon, John K. and Moraes, Mark A. and Dror, Ron O. and
+ *       Shaw, David E.},
+ *   booktitle = {Proceedings of the International Conference for High
+ *       Performance Computing, Networking, Storage and Analysis (SC '11)},
+ *   year = {2011}
+ * }
+ * @endcode
+ */
+class RandomStream
+{
+ public:
+  //! The type of the generated numbers.
+  typedef uint32_t result_type;
+
+  /**
+   * Create the stream with the given seed and stream ID.
+   *
+   * @param seed Seed of the stream.
+   * @param stream ID of the stream; streams with the same seed and different
+   *     IDs are independent.
+   */
+  RandomStream(const uint64_t seed = 0, const uint64_t stream = 0) :
+      seed(seed), stream(stream), block(0), position(4), hasNormal(false),
+      normal(0.0)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the smallest value that can be generated.
+  static constexpr result_type min() { return 0; }
+  //! Get the largest value that can be generated.
+  static constexpr result_type max() { return 0xFFFFFFFF; }
+
+  //! Generate a random 32-bit integer.
+  result_type operator()()
+  {
+    if (position == 4)
+    {
+      Block(seed, stream, block++, buffer);
+      position = 0;
+    }
+    return buffer[position++];
+  }
+
+  //! Generate a uniform random number in [0, 1).
+  double Random()
+  {
+    const uint32_t hi = (*this)();
+    return ToUniform(hi, (*this)());
+  }
+
+  //! Generate a uniform random number in [lo, hi).
+  double Random(const double lo, const double hi)
+  {
+    return lo + (hi - lo) * Random();
+  }
+
+  //! Generate a uniform random integer in [0, hiExclusive).
+  size_t RandInt(const size_t hiExclusive)
+  {
+    return std::min((size_t) std::floor(hiExclusive * Random()),
+        hiExclusive - 1);
+  }
+
+  //! Generate a normally distributed random number with mean 0 and standard
+  //! deviation 1.
+  double RandNormal()
+  {
+    if (hasNormal)
+    {
+      hasNormal = false;
+      return normal;
+    }
+
+    uint32_t words[4];
+    for (size_t i = 0; i < 4; ++i)
+      words[i] = (*this)();
+    double first;
+    BoxMuller(words, first, normal);
+    hasNormal = true;
+    return first;
+  }
+
+  //! Get the seed of the stream.
+  uint64_t Seed() const { return seed; }
+  //! Get the ID of the stream.
+  uint64_t Stream() const { return stream; }
+
+  /**
+   * Compute the given block of four random 32-bit integers of the given
+   * stream; the stream generates the blocks 0, 1, 2, ... in order.
+   *
+   * @param seed Seed of the stream.
+   * @param stream ID of the stream.
+   * @param index Index of the block.
+   * @param output Will contain the four integers of the block.
+   */
+  static void Block(const uint64_t seed,
+                    const uint64_t stream,
+                    const uint64_t index,
+                    uint32_t output[4])
+  {
+    uint32_t c0 = (uint32_t) index, c1 = (uint32_t) (index >> 32);
+    uint32_t c2 = (uint32_t) stream, c3 = (uint32_t) (stream >> 32);
+    uint32_t k0 = (uint32_t) seed, k1 = (uint32_t) (seed >> 32);
+    for (size_t round = 0; round < 10; ++round)
+    {
+      const uint64_t p0 = (uint64_t) 0xD2511F53 * c0;
+      const uint64_t p1 = (uint64_t) 0xCD9E8D57 * c2;
+      c0 = ((uint32_t) (p1 >> 32)) ^ c1 ^ k0;
+      c1 = (uint32_t) p1;
+      c2 = ((uint32_t) (p0 >> 32)) ^ c3 ^ k1;
+      c3 = (uint32_t) p0;
+      k0 += 0x9E3779B9;
+      k1 += 0xBB67AE85;
+    }
+
+    output[0] = c0;
+    output[1] = c1;
+    output[2] = c2;
+    output[3] = c3;
+  }
+
+  //! Convert two random 32-bit integers to a uniform number in [0, 1) with 53
+  //! random bits.
+  static double ToUniform(const uint32_t hi, const uint32_t lo)
+  {
+    return ((hi >> 5) * 67108864.0 + (lo >> 6)) / 9007199254740992.0;
+  }
+
+  //! Convert four random 32-bit integers to two independent normally
+  //! distributed numbers with the Box-Muller transform.
+  static void BoxMuller(const uint32_t words[4], double& first, double& second)
+  {
+    // Shift the first number to (0, 1] so that its log is finite.
+    const double u1 = 1.0 - ToUniform(words[0], words[1]);
+    const double u2 = ToUniform(words[2], words[3]);
+    const double radius = std::sqrt(-2.0 * std::log(u1));
+    first = radius * std::cos(2 * M_PI * u2);
+    second = radius * std::sin(2 * M_PI * u2);
+  }
+
+ private:
+  //! Seed of the stream.
+  uint64_t seed;
+  //! ID of the stream.
+  uint64_t stream;
+  //! Index of the next block.
+  uint64_t block;
+  //! The integers of the current block.
+  uint32_t buffer[4];
+  //! Position of the next integer in the current block.
+  size_t position;
+  //! Whether the second number of the last Box-Muller transform is unused.
+  bool hasNormal;
+  //! The second number of the last Box-Muller transform.
+  double normal;
+};
+
+/**
+ * Generate a 64-bit seed for a RandomStream from RandGen(), so that the
+ * streams follow RandomSeed().
+ */
+inline uint64_t RandomStreamSeed()
+{
+  const uint64_t hi = RandGen()();
+  return (hi << 32) | (uint64_t) RandGen()();
+}
+
+/**
+ * Fill the given matrix (or vector, or cube) with uniform random numbers in
+ * [0, 1), in parallel.  Element i is computed from block i / 2 of the given
+ * stream, so the result only depends on the seed and the stream ID, and not
+ * on the number of threads.
+ *
+ * @param x Matrix to fill; it must already have its size.
+ * @param seed Seed of the random numbers.
+ * @param stream ID of the stream of random numbers.
+ */
+template<typename MatType>
+void RandUniformFill(MatType& x,
+                     const uint64_t seed,
+                     const uint64_t stream = 0)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  ElemType* mem = x.memptr();
+  const size_t numElem = x.n_elem;
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t b = 0; b < (numElem + 1) / 2; ++b)
+  {
+    uint32_t words[4];
+    RandomStream::Block(seed, stream, b, words);
+    mem[2 * b] = (ElemType) RandomStream::ToUniform(words[0], words[1]);
+    if (2 * b + 1 < numElem)
+      mem[2 * b + 1] = (ElemType) RandomStream::ToUniform(words[2], words[3]);
+  }
+}
+
+/**
+ * Fill the given matrix (or vector, or cube) with uniform random numbers in
+ * [0, 1), in parallel, from a seed given by RandGen().
+ *
+ * @param x Matrix to fill; it must already have its size.
+ */
+template<typename MatType>
+void RandUniformFill(MatType& x)
+{
+  RandUniformFill(x, RandomStreamSeed());
+}
+
+/**
+ * Fill the given matrix (or vector, or cube) with normally distributed random
+ * numbers with mean 0 and standard deviation 1, in parallel.  Elements 2i and
+ * 2i + 1 are computed from block i of the given stream, so the result only
+ * depends on the seed and the stream ID, and not on the number of threads.
+ *
+ * @param x Matrix to fill; it must already have its size.
+ * @param seed Seed of the random numbers.
+ * @param stream ID of the stream of random numbers.
+ */
+template<typename MatType>
+void RandNormalFill(MatType& x,
+                    const uint64_t seed,
+                    const uint64_t stream = 0)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  ElemType* mem = x.memptr();
+  const size_t numElem = x.n_elem;
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t b = 0; b < (numElem + 1) / 2; ++b)
+  {
+    uint32_t words[4];
+    RandomStream::Block(seed, stream, b, words);
+    double first, second;
+    RandomStream::BoxMuller(words, first, second);
+    mem[2 * b] = (ElemType) first;
+    if (2 * b + 1 < numElem)
+      mem[2 * b + 1] = (ElemType) second;
+  }
+}
+
+/**
+ * Fill the given matrix (or vector, or cube) with normally distributed random
+ * numbers with mean 0 and standard deviation 1, in parallel, from a seed given
+ * by RandGen().
+ *
+ * @param x Matrix to fill; it must already have its size.
+ */
+template<typename MatType>
+void RandNormalFill(MatType& x)
+{
+  RandNormalFill(x, RandomStreamSeed());
+}
+
+/**
+ * Sample each element of the given matrix (or vector, or cube) from a
+ * Bernoulli distribution, in parallel: element i is set to 1 with probability
+ * `probabilities[i]`, and to 0 otherwise.  The uniform numbers are the same as
+ * for RandUniformFill() with the same seed and stream ID, so the result does
+ * not depend on the number of threads.  `x` may be `probabilities` itself.
+ *
+ * @param x Matrix to store the samples in.
+ * @param probabilities Probability of a 1 for each element.
+ * @param seed Seed of the random numbers.
+ * @param stream ID of the stream of random numbers.
+ */
+template<typename MatType, typename InputMatType>
+void RandBernoulliFill(MatType& x,
+                       const InputMatType& probabilities,
+                       const uint64_t seed,
+                       const uint64_t stream = 0)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  x.set_size(arma::size(probabilities));
+  const typename InputMatType::elem_type* p = probabilities.memptr();
+  ElemType* mem = x.memptr();
+  const size_t numElem = x.n_elem;
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t b = 0; b < (numElem + 1) / 2; ++b)
+  {
+    uint32_t words[4];
+    RandomStream::Block(seed, stream, b, words);
+    mem[2 * b] = (RandomStream::ToUniform(words[0], words[1]) < p[2 * b]) ?
+        ElemType(1) : ElemType(0);
+    if (2 * b + 1 < numElem)
+    {
+      mem[2 * b + 1] = (RandomStream::ToUniform(words[2], words[3]) <
+          p[2 * b + 1]) ? ElemType(1) : ElemType(0);
+    }
+  }
+}
+
 } // namespace mlpack
 
 #endif // MLPACK_CORE_MATH_RANDOM_HPP
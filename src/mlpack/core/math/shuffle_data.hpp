@@ -16,12 +16,102 @@
 
 namespace mlpack {
 
+/**
+ * Store in the given matrix (or row vector) the columns of the input in the
+ * given order, so that column i of the output is column ordering[i] of the
+ * input.  If the input and the output are the same object, the columns are
+ * permuted in place, by following the cycles of the permutation, so that only
+ * one column is held outside of the matrix.
+ */
+template<typename MatType>
+void PermuteColumns(const MatType& input,
+                    MatType& output,
+                    const arma::uvec& ordering)
+{
+  if (&input != &output)
+  {
+    output = input.cols(ordering);
+    return;
+  }
+
+  std::vector<bool> done(ordering.n_elem, false);
+  arma::Mat<typename MatType::elem_type> column;
+  for (size_t start = 0; start < ordering.n_elem; ++start)
+  {
+    if (done[start] || ordering[start] == start)
+      continue;
+
+    column = output.col(start);
+    size_t i = start;
+    while (ordering[i] != start)
+    {
+      output.col(i) = output.col(ordering[i]);
+      done[i] = true;
+      i = ordering[i];
+    }
+    output.col(i) = column;
+    done[i] = true;
+  }
+}
+
+/**
+ * Store in the given cube the columns of the input in the given order, so that
+ * column ordering[i] of the output is column i of the input.  If the input and
+ * the output are the same object, the columns are permuted in place.
+ */
+template<typename CubeType>
+void ScatterCubeColumns(const CubeType& input,
+                        CubeType& output,
+                        const arma::uvec& ordering)
+{
+  if (&input != &output)
+  {
+    output.set_size(input.n_rows, input.n_cols, input.n_slices);
+    for (size_t i = 0; i < ordering.n_elem; ++i)
+    {
+      output.tube(0, ordering[i], output.n_rows - 1, ordering[i]) =
+          input.tube(0, i, input.n_rows - 1, i);
+    }
+    return;
+  }
+  else if (ordering.n_elem == 0)
+  {
+    return;
+  }
+
+  // Column i of the result holds column inverse[i] of the input; follow the
+  // cycles of the inverse permutation.
+  arma::uvec inverse(ordering.n_elem);
+  inverse.elem(ordering) = arma::regspace<arma::uvec>(0, ordering.n_elem - 1);
+
+  std::vector<bool> done(ordering.n_elem, false);
+  CubeType column;
+  for (size_t start = 0; start < inverse.n_elem; ++start)
+  {
+    if (done[start] || inverse[start] == start)
+      continue;
+
+    column = output.tube(0, start, output.n_rows - 1, start);
+    size_t i = start;
+    while (inverse[i] != start)
+    {
+      output.tube(0, i, output.n_rows - 1, i) = CubeType(output.tube(0,
+          inverse[i], output.n_rows - 1, inverse[i]));
+      done[i] = true;
+      i = inverse[i];
+    }
+    output.tube(0, i, output.n_rows - 1, i) = column;
+    done[i] = true;
+  }
+}
+
 /**
  * Shuffle a dataset and associated labels (or responses).  It is expected that
  * inputPoints and inputLabels have the same number of columns (so, be sure that
  * inputLabels, if it is a vector, is a row vector).
  *
- * Shuffled data will be output into outputPoints and outputLabels.
+ * Shuffled data will be output into outputPoints and outputLabels.  If the
+ * outputs are the inputs, they are shuffled in place, without a copy.
  */
 template<typename MatType, typename LabelsType>
 void ShuffleData(const MatType& inputPoints,
@@ -35,8 +125,8 @@ void ShuffleData(const MatType& inputPoints,
   arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
       inputPoints.n_cols - 1, inputPoints.n_cols));
 
-  outputPoints = inputPoints.cols(ordering);
-  outputLabels = inputLabels.cols(ordering);
+  PermuteColumns(inputPoints, outputPoints, ordering);
+  PermuteColumns(inputLabels, outputLabels, ordering);
 }
 
 /**
@@ -96,7 +186,8 @@ void ShuffleData(const MatType& inputPoints,
  * also cube-shaped.  It is expected that inputPoints and inputLabels have the
  * same number of columns.
  *
- * Shuffled data will be output into outputPoints and outputLabels.
+ * Shuffled data will be output into outputPoints and outputLabels.  If the
+ * outputs are the inputs, they are shuffled in place, without a copy.
  */
 template<typename MatType, typename LabelsType>
 void ShuffleData(const MatType& inputPoints,
@@ -111,39 +202,8 @@ void ShuffleData(const MatType& inputPoints,
   arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
       inputPoints.n_cols - 1, inputPoints.n_cols));
 
-  // Properly handle the case where the input and output data are the same
-  // object.
-  MatType* outputPointsPtr = &outputPoints;
-  LabelsType* outputLabelsPtr = &outputLabels;
-  if (&inputPoints == &outputPoints)
-    outputPointsPtr = new MatType();
-  if (&inputLabels == &outputLabels)
-    outputLabelsPtr = new LabelsType();
-
-  outputPointsPtr->set_size(inputPoints.n_rows, inputPoints.n_cols,
-      inputPoints.n_slices);
-  outputLabelsPtr->set_size(inputLabels.n_rows, inputLabels.n_cols,
-      inputLabels.n_slices);
-  for (size_t i = 0; i < ordering.n_elem; ++i)
-  {
-    outputPointsPtr->tube(0, ordering[i], outputPointsPtr->n_rows - 1,
-        ordering[i]) = inputPoints.tube(0, i, inputPoints.n_rows - 1, i);
-    outputLabelsPtr->tube(0, ordering[i], outputLabelsPtr->n_rows - 1,
-        ordering[i]) = inputLabels.tube(0, i, inputLabels.n_rows - 1, i);
-  }
-
-  // Clean up memory if needed.
-  if (&inputPoints == &outputPoints)
-  {
-    outputPoints = std::move(*outputPointsPtr);
-    delete outputPointsPtr;
-  }
-
-  if (&inputLabels == &outputLabels)
-  {
-    outputLabels = std::move(*outputLabelsPtr);
-    delete outputLabelsPtr;
-  }
+  ScatterCubeColumns(inputPoints, outputPoints, ordering);
+  ScatterCubeColumns(inputLabels, outputLabels, ordering);
 }
 
 /**
@@ -153,7 +213,8 @@ void ShuffleData(const MatType& inputPoints,
  * vector).
  *
  * Shuffled data will be output into outputPoints and outputLabels and
- * outputWeights.
+ * outputWeights.  If the outputs are the inputs, they are shuffled in place,
+ * without a copy.
  */
 template<typename MatType, typename LabelsType, typename WeightsType>
 void ShuffleData(const MatType& inputPoints,
@@ -169,9 +230,9 @@ void ShuffleData(const MatType& inputPoints,
   arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
       inputPoints.n_cols - 1, inputPoints.n_cols));
 
-  outputPoints = inputPoints.cols(ordering);
-  outputLabels = inputLabels.cols(ordering);
-  outputWeights = inputWeights.cols(ordering);
+  PermuteColumns(inputPoints, outputPoints, ordering);
+  PermuteColumns(inputLabels, outputLabels, ordering);
+  PermuteColumns(inputWeights, outputWeights, ordering);
 }
 
 /**
@@ -236,6 +297,28 @@ void ShuffleData(const MatType& inputPoints,
   }
 }
 
+/**
+ * Shuffle a dataset and associated labels (or responses) in place.  This is
+ * the same as ShuffleData(points, labels, points, labels); dense and cube
+ * datasets are not copied.
+ */
+template<typename MatType, typename LabelsType>
+void ShuffleData(MatType& points, LabelsType& labels)
+{
+  ShuffleData(points, labels, points, labels);
+}
+
+/**
+ * Shuffle a dataset and associated labels (or responses) and weights in place.
+ * This is the same as ShuffleData(points, labels, weights, points, labels,
+ * weights); dense datasets are not copied.
+ */
+template<typename MatType, typename LabelsType, typename WeightsType>
+void ShuffleData(MatType& points, LabelsType& labels, WeightsType& weights)
+{
+  ShuffleData(points, labels, weights, points, labels, weights);
+}
+
 } // namespace mlpack
 
 #endif
@@ -0,0 +1,65 @@
+/**
+ * @file core/metrics/fixed_dimension.hpp
+ *
+ * Utilities for distance computations over a small number of dimensions that
+ * is known at compile time, so that the loops over the dimensions can be
+ * unrolled and vectorized by the compiler.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_FIXED_DIMENSION_HPP
+#define MLPACK_CORE_METRICS_FIXED_DIMENSION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * Whether VecType is a dense vector of floating-point elements that can be read
+ * directly with operator[], so that fixed-dimension loops can be used on it.
+ * This is the case for dense columns and rows and for columns of dense
+ * matrices (as returned by Mat::col()).
+ */
+template<typename VecType>
+struct IsFixedDimensionVector
+{
+  static const bool value = false;
+};
+
+template<typename eT>
+struct IsFixedDimensionVector<arma::Col<eT>>
+{
+  static const bool value = std::is_floating_point<eT>::value;
+};
+
+template<typename eT>
+struct IsFixedDimensionVector<arma::Row<eT>>
+{
+  static const bool value = std::is_floating_point<eT>::value;
+};
+
+template<typename eT>
+struct IsFixedDimensionVector<arma::subview_col<eT>>
+{
+  static const bool value = std::is_floating_point<eT>::value;
+};
+
+/**
+ * Return whether distance computations over the given number of dimensions
+ * should use the fixed-dimension code paths.  These are instantiated for 2 to
+ * 8 dimensions; for larger dimensionalities the per-call overhead of the
+ * generic loops is negligible compared to the work done.
+ *
+ * @param dim Number of dimensions.
+ */
+inline bool UseFixedDimension(const size_t dim)
+{
+  return (dim >= 2) && (dim <= 8);
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * @file core/metrics/hamming_distance.hpp
+ *
+ * The Hamming distance between binary codes that are packed into the elements
+ * of a matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_HAMMING_DISTANCE_HPP
+#define MLPACK_CORE_METRICS_HAMMING_DISTANCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "metric_traits.hpp"
+
+namespace mlpack {
+
+/**
+ * The Hamming distance, that is, the number of bits that differ between two
+ * binary codes.  Each element of the vectors holds several bits of the code as
+ * a nonnegative integer (see data::PackBinary()), so a 256-bit code takes 5
+ * elements of an arma::mat or 4 elements of an arma::Mat<arma::u64> instead of
+ * 256 elements.  The distance is the sum of the population counts of the
+ * exclusive or of the elements; since a code with one bit per element is also
+ * a valid packed code, the distance between unpacked 0/1 vectors is the
+ * Hamming distance too.
+ *
+ * The population count uses __builtin_popcountll() with GCC and clang, which
+ * is a single instruction when the POPCNT instruction set is enabled (e.g.
+ * with -mpopcnt or -march=native), and __popcnt64() with 64-bit MSVC.
+ *
+ * Packed codes can be searched with NeighborSearch and vantage point trees, or
+ * with bit-sampling LSH in LSHSearch:
+ *
+ * @code
+ * arma::mat codes; // One 256-bit code per column, one bit per element.
+ * arma::mat packed;
+ * data::PackBinary(codes, packed);
+ *
+ * NeighborSearch<NearestNeighborSort, HammingDistance, arma::mat, VPTree>
+ *     knn(std::move(packed));
+ * @endcode
+ */
+class HammingDistance
+{
+ public:
+  /**
+   * Default constructor does nothing, but is required to satisfy the Metric
+   * policy.
+   */
+  HammingDistance() { }
+
+  /**
+   * Computes the number of bits that differ between two packed codes.  Every
+   * element must be a nonnegative integer that fits in
+   * data::BitsPerPackedElement() bits.
+   *
+   * @param a First code.
+   * @param b Second code.
+   * @return Number of bits that differ between a and b.
+   */
+  template<typename VecTypeA, typename VecTypeB>
+  static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
+                                               const VecTypeB& b);
+
+  //! Return the number of bits set in the given word.
+  static size_t PopCount(const uint64_t word);
+
+  //! Serialize the metric (nothing to do).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const uint32_t /* version */) { }
+};
+
+/**
+ * The center of a ball has to stay a valid code, so ball bounds do not move it.
+ */
+template<>
+class MetricTraits<HammingDistance>
+{
+ public:
+  static const bool IsNormInduced = false;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "hamming_distance_impl.hpp"
+
+#endif
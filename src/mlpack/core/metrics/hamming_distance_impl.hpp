@@ -0,0 +1,53 @@
+/**
+ * @file core/metrics/hamming_distance_impl.hpp
+ *
+ * Implementation of the Hamming distance between packed binary codes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_HAMMING_DISTANCE_IMPL_HPP
+#define MLPACK_CORE_METRICS_HAMMING_DISTANCE_IMPL_HPP
+
+// In case it hasn't been included.
+#include "hamming_distance.hpp"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+  #include <intrin.h>
+#endif
+
+namespace mlpack {
+
+template<typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type HammingDistance::Evaluate(
+    const VecTypeA& a,
+    const VecTypeB& b)
+{
+  size_t distance = 0;
+  for (size_t i = 0; i < a.n_elem; ++i)
+    distance += PopCount(((uint64_t) a[i]) ^ ((uint64_t) b[i]));
+
+  return (typename VecTypeA::elem_type) distance;
+}
+
+inline size_t HammingDistance::PopCount(const uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  return __popcnt64(word);
+#else
+  // Count the bits of each 2-bit, 4-bit and 8-bit group in parallel, then add
+  // the bytes up with one multiplication.
+  uint64_t x = word - ((word >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (x * 0x0101010101010101ULL) >> 56;
+#endif
+}
+
+} // namespace mlpack
+
+#endif
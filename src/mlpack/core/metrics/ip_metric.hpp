@@ -58,6 +58,22 @@ class IPMetric
   template<typename VecTypeA, typename VecTypeB>
   typename VecTypeA::elem_type Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Evaluate the metric between every point of a and every point of b, so
+   * that output(i, j) = d(a.col(i), b.col(j)).  The kernel values between the
+   * two sets are computed with the batch Evaluate() method of the kernel if it
+   * has one (see HasBatchEvaluate).
+   *
+   * @tparam MatTypeA Type of first matrix.
+   * @tparam MatTypeB Type of second matrix.
+   * @tparam OutputMatType Type of the output matrix (generally arma::mat).
+   * @param a First set of points, one column per point.
+   * @param b Second set of points, one column per point.
+   * @param output Matrix to store the a.n_cols x b.n_cols distances in.
+   */
+  template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, OutputMatType& output);
+
   //! Get the kernel.
   const KernelType& Kernel() const { return *kernel; }
   //! Modify the kernel.
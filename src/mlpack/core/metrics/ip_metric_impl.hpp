@@ -17,6 +17,8 @@
 
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/kernels/linear_kernel.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 
 namespace mlpack {
 
@@ -80,6 +82,43 @@ inline typename Vec1Type::elem_type IPMetric<KernelType>::Evaluate(
       2 * kernel->Evaluate(a, b));
 }
 
+template<typename KernelType>
+template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+void IPMetric<KernelType>::Evaluate(const MatTypeA& a,
+                                    const MatTypeB& b,
+                                    OutputMatType& output)
+{
+  typedef typename OutputMatType::elem_type ElemType;
+
+  if (a.n_cols == 0 || b.n_cols == 0)
+  {
+    output.zeros(a.n_cols, b.n_cols);
+    return;
+  }
+
+  // d(a_i, b_j)^2 = K(a_i, a_i) + K(b_j, b_j) - 2 K(a_i, b_j); the self-kernels
+  // are 1 for normalized kernels.
+  KernelMatrixTile(*kernel, a, b, 0, a.n_cols, 0, b.n_cols, output,
+      HasBatchEvaluate<KernelType>());
+  arma::Col<ElemType> aSelf(a.n_cols, arma::fill::ones);
+  arma::Row<ElemType> bSelf(b.n_cols, arma::fill::ones);
+  if (!KernelTraits<KernelType>::IsNormalized)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+      aSelf[i] = kernel->Evaluate(a.col(i), a.col(i));
+    for (size_t j = 0; j < b.n_cols; ++j)
+      bSelf[j] = kernel->Evaluate(b.col(j), b.col(j));
+  }
+
+  output *= -2;
+  output.each_col() += aSelf;
+  output.each_row() += bSelf;
+
+  // Rounding can make the distance between very close points negative.
+  output.transform([](const ElemType x) { return std::max(x, ElemType(0)); });
+  output = arma::sqrt(output);
+}
+
 // Serialize the kernel.
 template<typename KernelType>
 template<typename Archive>
@@ -16,6 +16,7 @@
 #define MLPACK_CORE_METRICS_LMETRIC_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "fixed_dimension.hpp"
 
 namespace mlpack {
 
@@ -82,6 +83,43 @@ class LMetric
   static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
                                                const VecTypeB& b);
 
+  /**
+   * Computes the distances between every point of a and every point of b, so
+   * that output(i, j) is the distance between a.col(i) and b.col(j).  For the
+   * L2 distances, the matrix is computed with one matrix multiplication, as
+   * ||a_i||^2 + ||b_j||^2 - 2 a_i^T b_j, which is much faster than evaluating
+   * each pair of points separately.
+   *
+   * @tparam MatTypeA Type of first matrix (generally arma::mat or
+   *      arma::sp_mat).
+   * @tparam MatTypeB Type of second matrix.
+   * @tparam OutputMatType Type of the output matrix (generally arma::mat).
+   * @param a First set of points, one column per point.
+   * @param b Second set of points, one column per point.
+   * @param output Matrix to store the a.n_cols x b.n_cols distances in.
+   */
+  template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+  static void Evaluate(const MatTypeA& a,
+                       const MatTypeB& b,
+                       OutputMatType& output);
+
+  /**
+   * Computes the distance between two dense vectors that have exactly Dim
+   * elements.  Because the number of dimensions is known at compile time, the
+   * loop over the dimensions is unrolled and vectorized, and no temporaries are
+   * created.  Evaluate() calls this for dense floating-point vectors with 2 to
+   * 8 elements (see UseFixedDimension()), so it rarely needs to be called
+   * directly.
+   *
+   * @tparam Dim Number of elements of the vectors.
+   * @param a First vector.
+   * @param b Second vector.
+   * @return Distance between vectors a and b.
+   */
+  template<size_t Dim, typename VecTypeA, typename VecTypeB>
+  static typename VecTypeA::elem_type EvaluateFixed(const VecTypeA& a,
+                                                    const VecTypeB& b);
+
   //! Serialize the metric (nothing to do).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
@@ -90,6 +128,31 @@ class LMetric
   static const int Power = TPower;
   //! Whether or not the root is taken.
   static const bool TakeRoot = TTakeRoot;
+
+ private:
+  /**
+   * If a and b are dense vectors whose dimensionality has a fixed-dimension
+   * code path, store the distance between them in result and return true.
+   */
+  template<typename VecTypeA, typename VecTypeB>
+  static bool EvaluateFixedDimension(
+      const VecTypeA& a,
+      const VecTypeB& b,
+      typename VecTypeA::elem_type& result,
+      const std::enable_if_t<IsFixedDimensionVector<VecTypeA>::value &&
+          IsFixedDimensionVector<VecTypeB>::value>* = 0);
+
+  //! Other vector types have no fixed-dimension code path; return false.
+  template<typename VecTypeA, typename VecTypeB>
+  static bool EvaluateFixedDimension(
+      const VecTypeA& /* a */,
+      const VecTypeB& /* b */,
+      typename VecTypeA::elem_type& /* result */,
+      const std::enable_if_t<!IsFixedDimensionVector<VecTypeA>::value ||
+          !IsFixedDimensionVector<VecTypeB>::value>* = 0)
+  {
+    return false;
+  }
 };
 
 // Convenience typedefs.
@@ -25,6 +25,9 @@ typename VecTypeA::elem_type LMetric<Power, TakeRoot>::Evaluate(
     const VecTypeB& b)
 {
   typename VecTypeA::elem_type sum = 0;
+  if (EvaluateFixedDimension(a, b, sum))
+    return sum;
+
   for (size_t i = 0; i < a.n_elem; ++i)
     sum += std::pow(fabs(a[i] - b[i]), Power);
 
@@ -41,6 +44,10 @@ typename VecTypeA::elem_type LMetric<1, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
+  typename VecTypeA::elem_type result;
+  if (EvaluateFixedDimension(a, b, result))
+    return result;
+
   return accu(abs(a - b));
 }
 
@@ -50,6 +57,10 @@ typename VecTypeA::elem_type LMetric<1, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
+  typename VecTypeA::elem_type result;
+  if (EvaluateFixedDimension(a, b, result))
+    return result;
+
   return accu(abs(a - b));
 }
 
@@ -60,6 +71,10 @@ typename VecTypeA::elem_type LMetric<2, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
+  typename VecTypeA::elem_type result;
+  if (EvaluateFixedDimension(a, b, result))
+    return result;
+
   return arma::norm(a - b, 2);
 }
 
@@ -69,6 +84,10 @@ typename VecTypeA::elem_type LMetric<2, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
+  typename VecTypeA::elem_type result;
+  if (EvaluateFixedDimension(a, b, result))
+    return result;
+
   return accu(arma::square(a - b));
 }
 
@@ -80,6 +99,9 @@ typename VecTypeA::elem_type LMetric<3, true>::Evaluate(
     const VecTypeB& b)
 {
   typename VecTypeA::elem_type sum = 0;
+  if (EvaluateFixedDimension(a, b, sum))
+    return sum;
+
   for (size_t i = 0; i < a.n_elem; ++i)
     sum += std::pow(fabs(a[i] - b[i]), 3.0);
 
@@ -92,6 +114,10 @@ typename VecTypeA::elem_type LMetric<3, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
+  typename VecTypeA::elem_type result;
+  if (EvaluateFixedDimension(a, b, result))
+    return result;
+
   return accu(pow(arma::abs(a - b), 3.0));
 }
 
@@ -102,9 +128,107 @@ typename VecTypeA::elem_type LMetric<INT_MAX, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
+  typename VecTypeA::elem_type result;
+  if (EvaluateFixedDimension(a, b, result))
+    return result;
+
   return arma::as_scalar(arma::max(arma::abs(a - b)));
 }
 
+template<int Power, bool TakeRoot>
+template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+void LMetric<Power, TakeRoot>::Evaluate(const MatTypeA& a,
+                                        const MatTypeB& b,
+                                        OutputMatType& output)
+{
+  typedef typename OutputMatType::elem_type ElemType;
+
+  if (a.n_rows != b.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "LMetric::Evaluate(): the points of the first matrix have "
+        << a.n_rows << " dimensions, but the points of the second matrix have "
+        << b.n_rows << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The compiler should optimize this correctly at compile-time.
+  if (Power != 2)
+  {
+    output.set_size(a.n_cols, b.n_cols);
+    for (size_t j = 0; j < b.n_cols; ++j)
+      for (size_t i = 0; i < a.n_cols; ++i)
+        output(i, j) = Evaluate(a.col(i), b.col(j));
+    return;
+  }
+
+  // ||a_i - b_j||^2 = ||a_i||^2 + ||b_j||^2 - 2 a_i^T b_j.
+  const arma::Row<ElemType> aNorms(arma::sum(arma::square(a), 0));
+  const arma::Row<ElemType> bNorms(arma::sum(arma::square(b), 0));
+  output = -2 * (a.t() * b);
+  output.each_col() += aNorms.t();
+  output.each_row() += bNorms;
+
+  // Rounding can make the distance between very close points negative.
+  output.transform([](const ElemType x) { return std::max(x, ElemType(0)); });
+  if (TakeRoot)
+    output = arma::sqrt(output);
+}
+
+template<int Power, bool TakeRoot>
+template<size_t Dim, typename VecTypeA, typename VecTypeB>
+typename VecTypeA::elem_type LMetric<Power, TakeRoot>::EvaluateFixed(
+    const VecTypeA& a,
+    const VecTypeB& b)
+{
+  typedef typename VecTypeA::elem_type ElemType;
+
+  // The compiler should optimize out the if statements on Power entirely, and
+  // fully unroll the loop.
+  ElemType sum = 0;
+  for (size_t d = 0; d < Dim; ++d)
+  {
+    const ElemType diff = std::abs(a[d] - b[d]);
+    if (Power == 1)
+      sum += diff;
+    else if (Power == 2)
+      sum += diff * diff;
+    else if (Power == INT_MAX)
+      sum = std::max(sum, diff);
+    else
+      sum += std::pow(diff, (ElemType) Power);
+  }
+
+  if (!TakeRoot || Power == 1 || Power == INT_MAX)
+    return sum;
+  else if (Power == 2)
+    return std::sqrt(sum);
+  else
+    return std::pow(sum, (ElemType) (1.0 / Power));
+}
+
+template<int Power, bool TakeRoot>
+template<typename VecTypeA, typename VecTypeB>
+bool LMetric<Power, TakeRoot>::EvaluateFixedDimension(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    typename VecTypeA::elem_type& result,
+    const std::enable_if_t<IsFixedDimensionVector<VecTypeA>::value &&
+        IsFixedDimensionVector<VecTypeB>::value>*)
+{
+  switch (a.n_elem)
+  {
+    case 2: result = EvaluateFixed<2>(a, b); return true;
+    case 3: result = EvaluateFixed<3>(a, b); return true;
+    case 4: result = EvaluateFixed<4>(a, b); return true;
+    case 5: result = EvaluateFixed<5>(a, b); return true;
+    case 6: result = EvaluateFixed<6>(a, b); return true;
+    case 7: result = EvaluateFixed<7>(a, b); return true;
+    case 8: result = EvaluateFixed<8>(a, b); return true;
+    default: return false;
+  }
+}
+
 } // namespace mlpack
 
 #endif
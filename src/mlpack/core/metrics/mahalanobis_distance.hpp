@@ -13,6 +13,7 @@
 #define MLPACK_CORE_METRICS_MAHALANOBIS_DISTANCE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 
 namespace mlpack {
 
@@ -37,9 +38,13 @@ namespace mlpack {
  * If you wish to use the KNN class or other tree-based algorithms with this
  * distance, it is recommended to instead stretch the dataset first, by
  * decomposing Q = L^T L (perhaps via a Cholesky decomposition), and then
- * multiply the data by L.  If you still wish to use the KNN class with a custom
- * distance anyway, you will need to use a different tree type than the default
- * KDTree, which only works with the LMetric class.
+ * multiply the data by L.  Factorize() computes this decomposition, and
+ * Transform() stretches a dataset with it, so that the Euclidean distance
+ * between the stretched points is this distance.  Once Factorize() has been
+ * called, Evaluate() also uses the factor, which is triangular, instead of Q.
+ * If you still wish to use the KNN class with a custom distance anyway, you
+ * will need to use a different tree type than the default KDTree, which only
+ * works with the LMetric class.
  *
  * Similar to the LMetric class, this offers a template parameter TakeRoot
  * which, when set to false, will instead evaluate the distance
@@ -63,7 +68,7 @@ class MahalanobisDistance
    * Initialize the Mahalanobis distance with the empty matrix as covariance.
    * Don't call Evaluate() until you set the covariance with Covariance()!
    */
-  MahalanobisDistance() { }
+  MahalanobisDistance() : triangularFactor(false) { }
 
   /**
    * Initialize the Mahalanobis distance with the identity matrix of the given
@@ -72,7 +77,8 @@ class MahalanobisDistance
    * @param dimensionality Dimesnsionality of the covariance matrix.
    */
   MahalanobisDistance(const size_t dimensionality) :
-      covariance(arma::eye<arma::mat>(dimensionality, dimensionality)) { }
+      covariance(arma::eye<arma::mat>(dimensionality, dimensionality)),
+      triangularFactor(false) { }
 
   /**
    * Initialize the Mahalanobis distance with the given covariance matrix.  The
@@ -81,7 +87,8 @@ class MahalanobisDistance
    * @param covariance The covariance matrix to use for this distance.
    */
   MahalanobisDistance(arma::mat covariance) :
-      covariance(std::move(covariance)) { }
+      covariance(std::move(covariance)),
+      triangularFactor(false) { }
 
   /**
    * Evaluate the distance between the two given points using this Mahalanobis
@@ -95,6 +102,22 @@ class MahalanobisDistance
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Evaluate the distance between every point of a and every point of b, so
+   * that output(i, j) = d(a.col(i), b.col(j)).  The distances are computed with
+   * matrix multiplications, using
+   * (x - y)^T Q (x - y) = x^T Q x + y^T Q y - 2 x^T Q y with the symmetric part
+   * of Q, or as Euclidean distances between the points multiplied by the
+   * factor of Q if Factorize() was called.  If the covariance matrix has not
+   * been set, the identity matrix is used.
+   *
+   * @param a First set of points, one column per point.
+   * @param b Second set of points, one column per point.
+   * @param output Matrix to store the a.n_cols x b.n_cols distances in.
+   */
+  template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, OutputMatType& output);
+
   /**
    * Access the covariance matrix.
    *
@@ -109,6 +132,36 @@ class MahalanobisDistance
    */
   arma::mat& Covariance() { return covariance; }
 
+  /**
+   * Decompose the (symmetric part of the) covariance matrix as Q = L^T L, so
+   * that d(x, y) = || L x - L y ||.  L is the upper triangular Cholesky factor
+   * of Q if Q is positive definite; otherwise (if Q is only positive
+   * semidefinite), it is computed from the eigendecomposition of Q, and is not
+   * triangular.  After this is called, Evaluate() uses L instead of Q.  If the
+   * covariance matrix is modified, Factorize() must be called again.  A
+   * std::invalid_argument is thrown if Q is not positive semidefinite.
+   */
+  void Factorize();
+
+  //! Get whether the covariance matrix has been factorized.
+  bool Factorized() const { return factor.n_elem > 0; }
+  //! Get the factor L of the covariance matrix (see Factorize()).
+  const arma::mat& Factor() const { return factor; }
+
+  /**
+   * Stretch the given points with the factor of the covariance matrix, so
+   * that the Euclidean distance between two stretched points is the
+   * Mahalanobis distance between the points.  Searches with this distance can
+   * then be done with the Euclidean distance (and KD-trees) on the stretched
+   * points.  The covariance matrix is factorized first if Factorize() has not
+   * been called.
+   *
+   * @param data Points to stretch, one column per point.
+   * @return The stretched points, L * data.
+   */
+  template<typename MatType>
+  arma::Mat<typename MatType::elem_type> Transform(const MatType& data);
+
   //! Serialize the Mahalanobis distance.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t version);
@@ -116,10 +169,24 @@ class MahalanobisDistance
  private:
   //! The covariance matrix associated with this distance.
   arma::mat covariance;
+  //! The factor of the covariance matrix, if Factorize() was called.
+  arma::mat factor;
+  //! If true, the factor is upper triangular.
+  bool triangularFactor;
+
+  //! Multiply the given points by the factor of the covariance matrix.
+  template<typename MatType>
+  arma::Mat<typename MatType::elem_type> ApplyFactor(const MatType& x) const;
+
+  //! Get (x - y)^T Q (x - y) for m = x - y, with the factor of Q.
+  double FactorSquaredNorm(const arma::vec& m) const;
 };
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((bool TakeRoot),
+    (mlpack::MahalanobisDistance<TakeRoot>), (1));
+
 #include "mahalanobis_distance_impl.hpp"
 
 #endif
@@ -25,6 +25,9 @@ double MahalanobisDistance<false>::Evaluate(const VecTypeA& a,
                                             const VecTypeB& b)
 {
   arma::vec m = (a - b);
+  if (factor.n_elem > 0)
+    return FactorSquaredNorm(m);
+
   arma::mat out = trans(m) * covariance * m; // 1x1
   return out[0];
 }
@@ -42,17 +45,158 @@ double MahalanobisDistance<true>::Evaluate(const VecTypeA& a,
     covariance = arma::eye<arma::mat>(a.n_elem, a.n_elem);
 
   arma::vec m = (a - b);
+  if (factor.n_elem > 0)
+    return std::sqrt(FactorSquaredNorm(m));
+
   arma::mat out = trans(m) * covariance * m; // 1x1;
   return std::sqrt(out[0]);
 }
 
+template<bool TakeRoot>
+template<typename MatTypeA, typename MatTypeB, typename OutputMatType>
+void MahalanobisDistance<TakeRoot>::Evaluate(const MatTypeA& a,
+                                             const MatTypeB& b,
+                                             OutputMatType& output)
+{
+  typedef typename OutputMatType::elem_type ElemType;
+
+  if (a.n_rows != b.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "MahalanobisDistance::Evaluate(): the points of the first matrix "
+        << "have " << a.n_rows << " dimensions, but the points of the second "
+        << "matrix have " << b.n_rows << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (covariance.n_rows == 0)
+    covariance = arma::eye<arma::mat>(a.n_rows, a.n_rows);
+
+  // With the factor, these are Euclidean distances between stretched points.
+  if (factor.n_elem > 0)
+  {
+    LMetric<2, TakeRoot>::Evaluate(ApplyFactor(a), ApplyFactor(b), output);
+    return;
+  }
+
+  // Only the symmetric part of Q contributes to the distance.
+  const arma::Mat<ElemType> q = arma::conv_to<arma::Mat<ElemType>>::from(
+      0.5 * (covariance + covariance.t()));
+  const arma::Mat<ElemType> qa = q * a;
+  const arma::Mat<ElemType> qb = q * b;
+  const arma::Col<ElemType> aNorms(arma::sum(qa % a, 0).t());
+  const arma::Row<ElemType> bNorms(arma::sum(qb % b, 0));
+
+  output = -2 * (qa.t() * b);
+  output.each_col() += aNorms;
+  output.each_row() += bNorms;
+
+  // Rounding can make the distance between very close points negative.
+  output.transform([](const ElemType x) { return std::max(x, ElemType(0)); });
+  if (TakeRoot)
+    output = arma::sqrt(output);
+}
+
+template<bool TakeRoot>
+void MahalanobisDistance<TakeRoot>::Factorize()
+{
+  if (covariance.n_rows == 0)
+  {
+    throw std::logic_error("MahalanobisDistance::Factorize(): the covariance "
+        "matrix has not been set!");
+  }
+
+  // Only the symmetric part of Q contributes to the distance.  Armadillo gives
+  // the upper triangular factor R with Q = R^T R.
+  const arma::mat q = 0.5 * (covariance + covariance.t());
+  triangularFactor = arma::chol(factor, q);
+  if (triangularFactor)
+    return;
+
+  // Q is not positive definite; use Q = V D V^T = (D^(1/2) V^T)^T D^(1/2) V^T.
+  // Rounding may make the eigenvalues of a semidefinite Q slightly negative.
+  arma::vec eigenvalues;
+  arma::mat eigenvectors;
+  if (!arma::eig_sym(eigenvalues, eigenvectors, q))
+  {
+    factor.clear();
+    throw std::runtime_error("MahalanobisDistance::Factorize(): the "
+        "eigendecomposition of the covariance matrix failed!");
+  }
+
+  if (eigenvalues.min() < -1e-10 * std::max(1.0, std::abs(eigenvalues.max())))
+  {
+    factor.clear();
+    throw std::invalid_argument("MahalanobisDistance::Factorize(): the "
+        "covariance matrix is not positive semidefinite!");
+  }
+
+  eigenvalues.transform([](const double x) { return std::max(x, 0.0); });
+  factor = arma::diagmat(arma::sqrt(eigenvalues)) * eigenvectors.t();
+}
+
+template<bool TakeRoot>
+template<typename MatType>
+arma::Mat<typename MatType::elem_type> MahalanobisDistance<TakeRoot>::Transform(
+    const MatType& data)
+{
+  if (factor.n_elem == 0)
+    Factorize();
+
+  if (data.n_rows != factor.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "MahalanobisDistance::Transform(): the points have " << data.n_rows
+        << " dimensions, but the covariance matrix has " << factor.n_cols
+        << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  return ApplyFactor(data);
+}
+
+template<bool TakeRoot>
+template<typename MatType>
+arma::Mat<typename MatType::elem_type>
+MahalanobisDistance<TakeRoot>::ApplyFactor(const MatType& x) const
+{
+  typedef typename MatType::elem_type ElemType;
+
+  const arma::Mat<ElemType> f = arma::conv_to<arma::Mat<ElemType>>::from(
+      factor);
+  if (triangularFactor)
+    return arma::trimatu(f) * x;
+  else
+    return f * x;
+}
+
+template<bool TakeRoot>
+double MahalanobisDistance<TakeRoot>::FactorSquaredNorm(const arma::vec& m)
+    const
+{
+  const arma::vec r = triangularFactor ? arma::vec(arma::trimatu(factor) * m)
+      : arma::vec(factor * m);
+  return arma::dot(r, r);
+}
+
 // Serialize the Mahalanobis distance.
 template<bool TakeRoot>
 template<typename Archive>
 void MahalanobisDistance<TakeRoot>::serialize(Archive& ar,
-                                              const uint32_t /* version */)
+                                              const uint32_t version)
 {
   ar(CEREAL_NVP(covariance));
+
+  // Older versions did not have the factor of the covariance matrix.
+  if (cereal::is_loading<Archive>() && version == 0)
+  {
+    factor.clear();
+    triangularFactor = false;
+    return;
+  }
+
+  ar(CEREAL_NVP(factor));
+  ar(CEREAL_NVP(triangularFactor));
 }
 
 } // namespace mlpack
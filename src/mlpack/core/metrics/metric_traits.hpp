@@ -0,0 +1,37 @@
+/**
+ * @file core/metrics/metric_traits.hpp
+ *
+ * This provides the MetricTraits class, a template class to get information
+ * about various metrics.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_METRIC_TRAITS_HPP
+#define MLPACK_CORE_METRICS_METRIC_TRAITS_HPP
+
+namespace mlpack {
+
+/**
+ * This is a template class that can provide information about various metrics.
+ * A metric that doesn't need to override a value doesn't need a MetricTraits
+ * specialization.
+ */
+template<typename MetricType>
+class MetricTraits
+{
+ public:
+  /**
+   * If true, then the metric is induced by a norm, d(x, y) = ||x - y||, like
+   * the LMetric and the MahalanobisDistance.  Ball bounds then move their
+   * center along the segment towards each new point; otherwise, the center of
+   * a ball bound is always a point of the dataset, and only the radius grows.
+   */
+  static const bool IsNormInduced = true;
+};
+
+} // namespace mlpack
+
+#endif
@@ -14,10 +14,12 @@
 #define MLPACK_CORE_METRICS_METRICS_HPP
 
 #include "bleu.hpp" // Technically this should go somewhere else...
+#include "hamming_distance.hpp"
 #include "iou_metric.hpp"
 #include "ip_metric.hpp"
 #include "lmetric.hpp"
 #include "mahalanobis_distance.hpp"
+#include "metric_traits.hpp"
 #include "non_maximal_suppression.hpp"
 
 #endif
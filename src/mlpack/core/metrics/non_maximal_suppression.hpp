@@ -69,11 +69,93 @@ class NMS
                        OutputType& selectedIndices,
                        const double threshold = 0.5);
 
+  /**
+   * Performs non-maximal suppression like Evaluate(), but with a uniform grid
+   * over the boxes.  The boxes are swept in descending order of confidence
+   * scores; each box is compared only with the selected boxes in the grid cells
+   * it covers (the only ones it can overlap), and its IoU with all of them is
+   * computed at once.  The selected boxes are the same as with Evaluate(), but
+   * the time grows with the number of overlapping boxes instead of
+   * quadratically, so this is much faster for many boxes.
+   *
+   * @param boundingBoxes Column major representation of bounding boxes, as
+   *     for Evaluate().
+   * @param confidenceScores Vector containing confidence score corresponding
+   *     to each bounding box.
+   * @param selectedIndices Indices of the selected bounding boxes, sorted in
+   *     descending order of the confidence scores.
+   * @param threshold Threshold used to discard all overlapping bounding boxes
+   *     that have IoU greater than the threshold.
+   * @param cellSize Side of the cells of the grid; if 0, the median of the
+   *     larger side of the boxes is used.
+   */
+  template<
+      typename BoundingBoxesType,
+      typename ConfidenceScoreType,
+      typename OutputType
+  >
+  static void EvaluateIndexed(const BoundingBoxesType& boundingBoxes,
+                              const ConfidenceScoreType& confidenceScores,
+                              OutputType& selectedIndices,
+                              const double threshold = 0.5,
+                              const double cellSize = 0.0);
+
+  /**
+   * Performs non-maximal suppression on a batch of images at once: the boxes
+   * of each image are suppressed only by the boxes of the same image, as with
+   * EvaluateIndexed().
+   *
+   * @param boundingBoxes Column major representation of the bounding boxes of
+   *     all the images, as for Evaluate().
+   * @param confidenceScores Vector containing confidence score corresponding
+   *     to each bounding box.
+   * @param imageIndices Vector containing the index of the image of each
+   *     bounding box.
+   * @param selectedIndices Indices of the selected bounding boxes, sorted by
+   *     image index and then in descending order of the confidence scores.
+   * @param threshold Threshold used to discard all overlapping bounding boxes
+   *     that have IoU greater than the threshold.
+   * @param cellSize Side of the cells of the grid; if 0, the median of the
+   *     larger side of the boxes of each image is used.
+   */
+  template<
+      typename BoundingBoxesType,
+      typename ConfidenceScoreType,
+      typename ImageIndicesType,
+      typename OutputType
+  >
+  static void EvaluateBatch(const BoundingBoxesType& boundingBoxes,
+                            const ConfidenceScoreType& confidenceScores,
+                            const ImageIndicesType& imageIndices,
+                            OutputType& selectedIndices,
+                            const double threshold = 0.5,
+                            const double cellSize = 0.0);
+
   static const bool useCoordinates = UseCoordinates;
 
   //! Serialize the metric.
   template <typename Archive>
   void serialize(Archive &ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Convert the bounding boxes to the {x0, y0, x1, y1} representation, and
+   * check their number against the number of confidence scores.
+   */
+  template<typename BoundingBoxesType>
+  static arma::mat Coordinates(const BoundingBoxesType& boundingBoxes,
+                               const size_t numScores);
+
+  /**
+   * Sweep the boxes with the given indices, which must be sorted in
+   * descending order of confidence scores, and append the indices of the
+   * selected ones to selected.  The boxes are given as {x0, y0, x1, y1}.
+   */
+  static void SuppressIndexed(const arma::mat& coordinates,
+                              const arma::uvec& order,
+                              const double threshold,
+                              const double cellSize,
+                              std::vector<size_t>& selected);
 }; // Class NMS.
 
 } // namespace mlpack
@@ -15,6 +15,8 @@
 // In case it hasn't been included.
 #include "non_maximal_suppression.hpp"
 
+#include <unordered_map>
+
 namespace mlpack {
 
 template<bool UseCoordinates>
@@ -123,6 +125,229 @@ void NMS<UseCoordinates>::Evaluate(
   selectedIndices = arma::flipud(selectedIndices);
 }
 
+template<bool UseCoordinates>
+template<
+    typename BoundingBoxesType,
+    typename ConfidenceScoreType,
+    typename OutputType
+>
+void NMS<UseCoordinates>::EvaluateIndexed(
+    const BoundingBoxesType& boundingBoxes,
+    const ConfidenceScoreType& confidenceScores,
+    OutputType& selectedIndices,
+    const double threshold,
+    const double cellSize)
+{
+  const arma::mat coordinates = Coordinates(boundingBoxes,
+      confidenceScores.n_elem);
+
+  const arma::uvec order = arma::stable_sort_index(confidenceScores,
+      "descend");
+  std::vector<size_t> selected;
+  SuppressIndexed(coordinates, order, threshold, cellSize, selected);
+  selectedIndices = arma::conv_to<OutputType>::from(selected);
+}
+
+template<bool UseCoordinates>
+template<
+    typename BoundingBoxesType,
+    typename ConfidenceScoreType,
+    typename ImageIndicesType,
+    typename OutputType
+>
+void NMS<UseCoordinates>::EvaluateBatch(
+    const BoundingBoxesType& boundingBoxes,
+    const ConfidenceScoreType& confidenceScores,
+    const ImageIndicesType& imageIndices,
+    OutputType& selectedIndices,
+    const double threshold,
+    const double cellSize)
+{
+  const arma::mat coordinates = Coordinates(boundingBoxes,
+      confidenceScores.n_elem);
+  if (imageIndices.n_elem != boundingBoxes.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "NMS::EvaluateBatch(): " << imageIndices.n_elem << " image indices "
+        << "given for " << boundingBoxes.n_cols << " bounding boxes!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Sort the boxes by image, and then in descending order of scores.
+  arma::uvec order = arma::stable_sort_index(confidenceScores, "descend");
+  const arma::uvec images = arma::conv_to<arma::uvec>::from(imageIndices);
+  const arma::uvec imageOrder = arma::stable_sort_index(images(order));
+  order = order(imageOrder);
+
+  std::vector<size_t> selected;
+  size_t begin = 0;
+  while (begin < order.n_elem)
+  {
+    size_t end = begin + 1;
+    while (end < order.n_elem && images[order[end]] == images[order[begin]])
+      ++end;
+
+    SuppressIndexed(coordinates, order.subvec(begin, end - 1), threshold,
+        cellSize, selected);
+    begin = end;
+  }
+
+  selectedIndices = arma::conv_to<OutputType>::from(selected);
+}
+
+template<bool UseCoordinates>
+template<typename BoundingBoxesType>
+arma::mat NMS<UseCoordinates>::Coordinates(
+    const BoundingBoxesType& boundingBoxes,
+    const size_t numScores)
+{
+  if (boundingBoxes.n_rows != 4)
+  {
+    throw std::invalid_argument("NMS: bounding boxes must contain only 4 rows "
+        "determining coordinates of bounding box either in {x1, y1, x2, y2} or "
+        "{x1, y1, h, w} format.");
+  }
+
+  if (numScores != boundingBoxes.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "NMS: found " << numScores << " confidence scores for "
+        << boundingBoxes.n_cols << " bounding boxes!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::mat coordinates = arma::conv_to<arma::mat>::from(boundingBoxes);
+  if (!UseCoordinates)
+  {
+    // Change height - width representation to coordinate represention.
+    coordinates.row(2) += coordinates.row(0);
+    coordinates.row(3) += coordinates.row(1);
+  }
+
+  return coordinates;
+}
+
+template<bool UseCoordinates>
+void NMS<UseCoordinates>::SuppressIndexed(
+    const arma::mat& coordinates,
+    const arma::uvec& order,
+    const double threshold,
+    const double cellSize,
+    std::vector<size_t>& selected)
+{
+  if (order.n_elem == 0)
+    return;
+
+  // With a negative threshold, the first box suppresses all the others, even
+  // those that it does not overlap.
+  if (threshold < 0.0)
+  {
+    selected.push_back(order[0]);
+    return;
+  }
+
+  const arma::vec x0 = coordinates.row(0).t();
+  const arma::vec y0 = coordinates.row(1).t();
+  const arma::vec x1 = coordinates.row(2).t();
+  const arma::vec y1 = coordinates.row(3).t();
+  const arma::vec area = (x1 - x0) % (y1 - y0);
+
+  // Boxes that overlap share at least one cell of the grid.
+  double side = cellSize;
+  if (side <= 0.0)
+  {
+    side = arma::median(arma::max(x1(order) - x0(order),
+        y1(order) - y0(order)));
+  }
+  if (!(side > 0.0))
+    side = 1.0;
+
+  const double minX = x0(order).min();
+  const double minY = y0(order).min();
+  const size_t rows = (size_t) ((y1(order).max() - minY) / side) + 1;
+  std::unordered_map<size_t, std::vector<size_t>> grid;
+
+  // Boxes that cover more than this many cells are not put in the grid: they
+  // are compared with all the selected boxes, and all boxes are compared with
+  // them.
+  const size_t maxCells = 64;
+  std::vector<size_t> largeBoxes;
+  const size_t selectedBegin = selected.size();
+
+  // lastCandidate[k] is the last box that was compared with the selected box
+  // k, so that a selected box in several cells is only compared once.
+  std::vector<size_t> lastCandidate(coordinates.n_cols, order.n_elem);
+  std::vector<size_t> neighbors;
+  for (size_t i = 0; i < order.n_elem; ++i)
+  {
+    const size_t c = order[i];
+    const size_t cellX0 = (size_t) ((x0[c] - minX) / side);
+    const size_t cellX1 = std::max((size_t) (std::max(x1[c] - minX, 0.0) /
+        side), cellX0);
+    const size_t cellY0 = (size_t) ((y0[c] - minY) / side);
+    const size_t cellY1 = std::max((size_t) (std::max(y1[c] - minY, 0.0) /
+        side), cellY0);
+    const bool large = ((cellX1 - cellX0 + 1) * (cellY1 - cellY0 + 1) >
+        maxCells);
+
+    if (large)
+    {
+      neighbors.assign(selected.begin() + selectedBegin, selected.end());
+    }
+    else
+    {
+      neighbors = largeBoxes;
+      for (size_t cx = cellX0; cx <= cellX1; ++cx)
+      {
+        for (size_t cy = cellY0; cy <= cellY1; ++cy)
+        {
+          auto it = grid.find(cx * rows + cy);
+          if (it == grid.end())
+            continue;
+
+          for (const size_t k : it->second)
+          {
+            if (lastCandidate[k] != i)
+            {
+              lastCandidate[k] = i;
+              neighbors.push_back(k);
+            }
+          }
+        }
+      }
+    }
+
+    if (!neighbors.empty())
+    {
+      // Compute the IoU with all the selected neighbors at once.
+      const arma::uvec n = arma::conv_to<arma::uvec>::from(neighbors);
+      const arma::vec width = arma::clamp(arma::clamp(x1(n), -DBL_MAX, x1[c]) -
+          arma::clamp(x0(n), x0[c], DBL_MAX), 0.0, DBL_MAX);
+      const arma::vec height = arma::clamp(arma::clamp(y1(n), -DBL_MAX, y1[c]) -
+          arma::clamp(y0(n), y0[c], DBL_MAX), 0.0, DBL_MAX);
+      const arma::vec intersection = width % height;
+      const arma::vec iou = intersection / (area(n) + area[c] - intersection);
+
+      // As with Evaluate(), a box is only kept if its IoU is at most the
+      // threshold (so a NaN IoU suppresses it).
+      if (arma::any(iou > threshold) || iou.has_nan())
+        continue;
+    }
+
+    selected.push_back(c);
+    if (large)
+    {
+      largeBoxes.push_back(c);
+    }
+    else
+    {
+      for (size_t cx = cellX0; cx <= cellX1; ++cx)
+        for (size_t cy = cellY0; cy <= cellY1; ++cy)
+          grid[cx * rows + cy].push_back(c);
+    }
+  }
+}
+
 template<bool UseCoordinates>
 template<typename Archive>
 void NMS<UseCoordinates>::serialize(
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/metric_traits.hpp>
 #include "bound_traits.hpp"
 
 namespace mlpack {
@@ -24,15 +25,15 @@ namespace mlpack {
  * to the Euclidean (L2) distance.
  *
  * @tparam MetricType metric type used in the distance measure.
+ * @tparam ElemType Type of element held by the bound (double or float).
  * @tparam VecType Type of vector (arma::vec or arma::sp_vec or similar).
  */
 template<typename MetricType = LMetric<2, true>,
-         typename VecType = arma::vec>
+         typename ElemType = double,
+         typename VecType = arma::Col<ElemType>>
 class BallBound
 {
  public:
-  //! The underlying data type.
-  typedef typename VecType::elem_type ElemType;
   //! A public version of the vector type.
   typedef VecType Vec;
 
@@ -209,8 +210,8 @@ class BallBound
 };
 
 //! A specialization of BoundTraits for this bound type.
-template<typename MetricType, typename VecType>
-struct BoundTraits<BallBound<MetricType, VecType>>
+template<typename MetricType, typename ElemType, typename VecType>
+struct BoundTraits<BallBound<MetricType, ElemType, VecType>>
 {
   //! These bounds are potentially loose in some dimensions.
   const static bool HasTightBounds = false;
@@ -20,8 +20,8 @@
 namespace mlpack {
 
 //! Empty Constructor.
-template<typename MetricType, typename VecType>
-BallBound<MetricType, VecType>::BallBound() :
+template<typename MetricType, typename ElemType, typename VecType>
+BallBound<MetricType, ElemType, VecType>::BallBound() :
     radius(std::numeric_limits<ElemType>::lowest()),
     metric(new MetricType()),
     ownsMetric(true)
@@ -32,8 +32,8 @@ BallBound<MetricType, VecType>::BallBound() :
  *
  * @param dimension Dimensionality of ball bound.
  */
-template<typename MetricType, typename VecType>
-BallBound<MetricType, VecType>::BallBound(const size_t dimension) :
+template<typename MetricType, typename ElemType, typename VecType>
+BallBound<MetricType, ElemType, VecType>::BallBound(const size_t dimension) :
     radius(std::numeric_limits<ElemType>::lowest()),
     center(dimension),
     metric(new MetricType()),
@@ -46,8 +46,8 @@ BallBound<MetricType, VecType>::BallBound(const size_t dimension) :
  * @param radius Radius of ball bound.
  * @param center Center of ball bound.
  */
-template<typename MetricType, typename VecType>
-BallBound<MetricType, VecType>::BallBound(const ElemType radius,
+template<typename MetricType, typename ElemType, typename VecType>
+BallBound<MetricType, ElemType, VecType>::BallBound(const ElemType radius,
                                            const VecType& center) :
     radius(radius),
     center(center),
@@ -56,8 +56,8 @@ BallBound<MetricType, VecType>::BallBound(const ElemType radius,
 { /* Nothing to do. */ }
 
 //! Copy Constructor. To prevent memory leaks.
-template<typename MetricType, typename VecType>
-BallBound<MetricType, VecType>::BallBound(const BallBound& other) :
+template<typename MetricType, typename ElemType, typename VecType>
+BallBound<MetricType, ElemType, VecType>::BallBound(const BallBound& other) :
     radius(other.radius),
     center(other.center),
     metric(other.metric),
@@ -65,8 +65,9 @@ BallBound<MetricType, VecType>::BallBound(const BallBound& other) :
 { /* Nothing to do. */ }
 
 //! For the same reason as the copy constructor: to prevent memory leaks.
-template<typename MetricType, typename VecType>
-BallBound<MetricType, VecType>& BallBound<MetricType, VecType>::operator=(
+template<typename MetricType, typename ElemType, typename VecType>
+BallBound<MetricType, ElemType, VecType>&
+BallBound<MetricType, ElemType, VecType>::operator=(
     const BallBound& other)
 {
   if (this != &other)
@@ -80,8 +81,8 @@ BallBound<MetricType, VecType>& BallBound<MetricType, VecType>::operator=(
 }
 
 //! Move constructor.
-template<typename MetricType, typename VecType>
-BallBound<MetricType, VecType>::BallBound(BallBound&& other) :
+template<typename MetricType, typename ElemType, typename VecType>
+BallBound<MetricType, ElemType, VecType>::BallBound(BallBound&& other) :
     radius(other.radius),
     center(other.center),
     metric(other.metric),
@@ -95,8 +96,9 @@ BallBound<MetricType, VecType>::BallBound(BallBound&& other) :
 }
 
 //! Move assignment operator.
-template<typename MetricType, typename VecType>
-BallBound<MetricType, VecType>& BallBound<MetricType, VecType>::operator=(
+template<typename MetricType, typename ElemType, typename VecType>
+BallBound<MetricType, ElemType, VecType>&
+BallBound<MetricType, ElemType, VecType>::operator=(
     BallBound&& other)
 {
   if (this != &other)
@@ -115,17 +117,17 @@ BallBound<MetricType, VecType>& BallBound<MetricType, VecType>::operator=(
 }
 
 //! Destructor to release allocated memory.
-template<typename MetricType, typename VecType>
-BallBound<MetricType, VecType>::~BallBound()
+template<typename MetricType, typename ElemType, typename VecType>
+BallBound<MetricType, ElemType, VecType>::~BallBound()
 {
   if (ownsMetric)
     delete metric;
 }
 
 //! Get the range in a certain dimension.
-template<typename MetricType, typename VecType>
-RangeType<typename BallBound<MetricType, VecType>::ElemType>
-BallBound<MetricType, VecType>::operator[](const size_t i) const
+template<typename MetricType, typename ElemType, typename VecType>
+RangeType<ElemType>
+BallBound<MetricType, ElemType, VecType>::operator[](const size_t i) const
 {
   if (radius < 0)
     return Range();
@@ -136,8 +138,9 @@ BallBound<MetricType, VecType>::operator[](const size_t i) const
 /**
  * Determines if a point is within the bound.
  */
-template<typename MetricType, typename VecType>
-bool BallBound<MetricType, VecType>::Contains(const VecType& point) const
+template<typename MetricType, typename ElemType, typename VecType>
+bool BallBound<MetricType, ElemType, VecType>::Contains(
+    const VecType& point) const
 {
   if (radius < 0)
     return false;
@@ -148,10 +151,10 @@ bool BallBound<MetricType, VecType>::Contains(const VecType& point) const
 /**
  * Calculates minimum bound-to-point squared distance.
  */
-template<typename MetricType, typename VecType>
+template<typename MetricType, typename ElemType, typename VecType>
 template<typename OtherVecType>
-typename BallBound<MetricType, VecType>::ElemType
-BallBound<MetricType, VecType>::MinDistance(
+ElemType
+BallBound<MetricType, ElemType, VecType>::MinDistance(
     const OtherVecType& point,
     typename std::enable_if_t<IsVector<OtherVecType>::value>* /* junk */) const
 {
@@ -164,9 +167,9 @@ BallBound<MetricType, VecType>::MinDistance(
 /**
  * Calculates minimum bound-to-bound squared distance.
  */
-template<typename MetricType, typename VecType>
-typename BallBound<MetricType, VecType>::ElemType
-BallBound<MetricType, VecType>::MinDistance(const BallBound& other)
+template<typename MetricType, typename ElemType, typename VecType>
+ElemType
+BallBound<MetricType, ElemType, VecType>::MinDistance(const BallBound& other)
     const
 {
   if (radius < 0)
@@ -182,10 +185,10 @@ BallBound<MetricType, VecType>::MinDistance(const BallBound& other)
 /**
  * Computes maximum distance.
  */
-template<typename MetricType, typename VecType>
+template<typename MetricType, typename ElemType, typename VecType>
 template<typename OtherVecType>
-typename BallBound<MetricType, VecType>::ElemType
-BallBound<MetricType, VecType>::MaxDistance(
+ElemType
+BallBound<MetricType, ElemType, VecType>::MaxDistance(
     const OtherVecType& point,
     typename std::enable_if_t<IsVector<OtherVecType>::value>* /* junk */) const
 {
@@ -198,9 +201,9 @@ BallBound<MetricType, VecType>::MaxDistance(
 /**
  * Computes maximum distance.
  */
-template<typename MetricType, typename VecType>
-typename BallBound<MetricType, VecType>::ElemType
-BallBound<MetricType, VecType>::MaxDistance(const BallBound& other)
+template<typename MetricType, typename ElemType, typename VecType>
+ElemType
+BallBound<MetricType, ElemType, VecType>::MaxDistance(const BallBound& other)
     const
 {
   if (radius < 0)
@@ -214,10 +217,10 @@ BallBound<MetricType, VecType>::MaxDistance(const BallBound& other)
  *
  * Example: bound1.MinDistanceSq(other) for minimum squared distance.
  */
-template<typename MetricType, typename VecType>
+template<typename MetricType, typename ElemType, typename VecType>
 template<typename OtherVecType>
-RangeType<typename BallBound<MetricType, VecType>::ElemType>
-BallBound<MetricType, VecType>::RangeDistance(
+RangeType<ElemType>
+BallBound<MetricType, ElemType, VecType>::RangeDistance(
     const OtherVecType& point,
     typename std::enable_if_t<IsVector<OtherVecType>::value>* /* junk */) const
 {
@@ -231,9 +234,9 @@ BallBound<MetricType, VecType>::RangeDistance(
   }
 }
 
-template<typename MetricType, typename VecType>
-RangeType<typename BallBound<MetricType, VecType>::ElemType>
-BallBound<MetricType, VecType>::RangeDistance(
+template<typename MetricType, typename ElemType, typename VecType>
+RangeType<ElemType>
+BallBound<MetricType, ElemType, VecType>::RangeDistance(
     const BallBound& other) const
 {
   if (radius < 0)
@@ -250,10 +253,10 @@ BallBound<MetricType, VecType>::RangeDistance(
 /**
  * Expand the bound to include the given bound.
  *
-template<typename MetricType, typename VecType>
-const BallBound<VecType>&
-BallBound<MetricType, VecType>::operator|=(
-    const BallBound<VecType>& other)
+template<typename MetricType, typename ElemType, typename VecType>
+const BallBound<MetricType, ElemType, VecType>&
+BallBound<MetricType, ElemType, VecType>::operator|=(
+    const BallBound<MetricType, ElemType, VecType>& other)
 {
   double dist = metric->Evaluate(center, other);
 
@@ -270,10 +273,10 @@ BallBound<MetricType, VecType>::operator|=(
  * The difference lies in the way we initialize the ball bound. The way we
  * expand the bound is same.
  */
-template<typename MetricType, typename VecType>
+template<typename MetricType, typename ElemType, typename VecType>
 template<typename MatType>
-const BallBound<MetricType, VecType>&
-BallBound<MetricType, VecType>::operator|=(const MatType& data)
+const BallBound<MetricType, ElemType, VecType>&
+BallBound<MetricType, ElemType, VecType>::operator|=(const MatType& data)
 {
   if (radius < 0)
   {
@@ -287,7 +290,13 @@ BallBound<MetricType, VecType>::operator|=(const MatType& data)
     const ElemType dist = metric->Evaluate(center, (VecType) data.col(i));
 
     // See if the new point lies outside the bound.
-    if (dist > radius)
+    if (dist > radius && !MetricTraits<MetricType>::IsNormInduced)
+    {
+      // Without a norm, there is no point between the center and the new
+      // point to move to, so only the radius grows.
+      radius = dist;
+    }
+    else if (dist > radius)
     {
       // Move towards the new point and increase the radius just enough to
       // accommodate the new point.
@@ -297,13 +306,20 @@ BallBound<MetricType, VecType>::operator|=(const MatType& data)
     }
   }
 
+  // Moving the center can leave points that were added earlier just outside
+  // the ball because of rounding (this matters mostly when ElemType is float),
+  // so make sure that the radius covers all of them.
+  for (size_t i = 0; i < data.n_cols; ++i)
+    radius = std::max(radius,
+        (ElemType) metric->Evaluate(center, (VecType) data.col(i)));
+
   return *this;
 }
 
 //! Serialize the BallBound.
-template<typename MetricType, typename VecType>
+template<typename MetricType, typename ElemType, typename VecType>
 template<typename Archive>
-void BallBound<MetricType, VecType>::serialize(
+void BallBound<MetricType, ElemType, VecType>::serialize(
     Archive& ar,
     const uint32_t /* version */)
 {
@@ -13,11 +13,18 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <unordered_map>
+#include <unordered_set>
+
 #include "../statistic.hpp"
 #include "midpoint_split.hpp"
 
 namespace mlpack {
 
+// Forward declaration so that it can be detected when building in parallel.
+template<typename BoundType, typename MatType>
+class UBTreeSplit;
+
 /**
  * A binary space partitioning tree, such as a KD-tree or a ball tree.  Once the
  * bound and type of dataset is defined, the tree will construct itself.  Call
@@ -31,6 +38,16 @@ namespace mlpack {
  * This tree does take one runtime parameter in the constructor, which is the
  * max leaf size to be used.
  *
+ * If mlpack is compiled with OpenMP, the tree is built in parallel: every node
+ * with more than ParallelBuildCutoff points builds its left child in a separate
+ * OpenMP task.  The number of threads used is controlled by OpenMP (e.g., with
+ * the OMP_NUM_THREADS environment variable or omp_set_num_threads()).  The
+ * resulting tree and the oldFromNew mapping do not depend on the number of
+ * threads, except for randomized splitters, which draw from per-thread random
+ * number generators.  UBTreeSplit does not support parallel construction, so a
+ * UB tree is always built serially; trees on sparse matrices are also built
+ * serially, since splitting a node moves the nonzero elements of the matrix.
+ *
  * @tparam MetricType The metric used for tree-building.  The BoundType may
  *     place restrictions on the metrics that can be used.
  * @tparam StatisticType Extra data contained in the node.  See statistic.hpp
@@ -58,7 +75,32 @@ class BinarySpaceTree
   //! The type of element held in MatType.
   typedef typename MatType::elem_type ElemType;
 
-  typedef SplitType<BoundType<MetricType>, MatType> Split;
+  typedef SplitType<BoundType<MetricType, ElemType>, MatType> Split;
+
+  //! Nodes with at least this many points build their children in parallel
+  //! (when OpenMP is available).
+  static constexpr size_t ParallelBuildCutoff = 4096;
+
+  //! Whether the children of a node can be built in parallel.  UBTreeSplit
+  //! modifies the addresses of neighboring nodes during the split, so UB trees
+  //! are always built serially.  The columns of a sparse matrix share their
+  //! storage, so trees on sparse matrices are built serially too.
+  static constexpr bool ParallelBuild =
+      !std::is_same<Split,
+          UBTreeSplit<BoundType<MetricType, ElemType>, MatType>>::value &&
+      !arma::is_SpMat<MatType>::value;
+
+  //! Whether single subtrees can be rebuilt after points are inserted or
+  //! deleted.  UBTreeSplit computes the addresses of all points when it splits
+  //! the root, so UB trees are always rebuilt from the root.
+  static constexpr bool PartialRebuild =
+      !std::is_same<Split,
+          UBTreeSplit<BoundType<MetricType, ElemType>, MatType>>::value;
+
+  //! A subtree is rebuilt once the number of points inserted into or deleted
+  //! from it since it was built exceeds this fraction of its size (see
+  //! InsertPoints() and DeletePoints()).
+  static constexpr double RebuildFraction = 0.5;
 
  private:
   //! The left child node.
@@ -74,7 +116,7 @@ class BinarySpaceTree
   //! children).
   size_t count;
   //! The bound object for this node.
-  BoundType<MetricType> bound;
+  BoundType<MetricType, ElemType> bound;
   //! Any extra data contained in the node.
   StatisticType stat;
   //! The distance from the centroid of this node to the centroid of the parent.
@@ -87,6 +129,14 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! If Compact() has been called on this node (which must be the root), this
+  //! holds every descendant node contiguously in depth-first order.
+  BinarySpaceTree* compactNodes = NULL;
+  //! The number of nodes held in compactNodes.
+  size_t numCompactNodes = 0;
+  //! The number of points inserted into or deleted from this subtree since it
+  //! was built.
+  size_t updates = 0;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -206,12 +256,15 @@ class BinarySpaceTree
    * @param count Number of points to use to construct tree.
    * @param splitter Instantiated node splitter object.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param siblingCenter If not NULL, the center of the bound of the left
+   *     sibling of this node, which is the hollow center of a HollowBallBound.
    */
   BinarySpaceTree(BinarySpaceTree* parent,
                   const size_t begin,
                   const size_t count,
-                  SplitType<BoundType<MetricType>, MatType>& splitter,
-                  const size_t maxLeafSize = 20);
+                  SplitType<BoundType<MetricType, ElemType>, MatType>& splitter,
+                  const size_t maxLeafSize = 20,
+                  const arma::Col<ElemType>* siblingCenter = NULL);
 
   /**
    * Construct this node as a child of the given parent, starting at column
@@ -231,13 +284,16 @@ class BinarySpaceTree
    *     each new point.
    * @param splitter Instantiated node splitter object.
    * @param maxLeafSize Size of each leaf in the tree.
+   * @param siblingCenter If not NULL, the center of the bound of the left
+   *     sibling of this node, which is the hollow center of a HollowBallBound.
    */
   BinarySpaceTree(BinarySpaceTree* parent,
                   const size_t begin,
                   const size_t count,
                   std::vector<size_t>& oldFromNew,
-                  SplitType<BoundType<MetricType>, MatType>& splitter,
-                  const size_t maxLeafSize = 20);
+                  SplitType<BoundType<MetricType, ElemType>, MatType>& splitter,
+                  const size_t maxLeafSize = 20,
+                  const arma::Col<ElemType>* siblingCenter = NULL);
 
   /**
    * Construct this node as a child of the given parent, starting at column
@@ -266,7 +322,7 @@ class BinarySpaceTree
                   const size_t count,
                   std::vector<size_t>& oldFromNew,
                   std::vector<size_t>& newFromOld,
-                  SplitType<BoundType<MetricType>, MatType>& splitter,
+                  SplitType<BoundType<MetricType, ElemType>, MatType>& splitter,
                   const size_t maxLeafSize = 20);
 
   /**
@@ -314,10 +370,108 @@ class BinarySpaceTree
    */
   ~BinarySpaceTree();
 
+  /**
+   * Reallocate all of the descendants of this node in one contiguous block of
+   * memory, in depth-first (pre-order) order, so that a node's left child
+   * directly follows it in memory.  This reduces cache misses when traversing
+   * the tree.  Pointers to the nodes of the tree are invalidated (except for
+   * the root), but the structure of the tree is unchanged, so any traverser
+   * and rule type can be used on the compacted tree as usual.  If the tree is
+   * compacted already, the nodes are reallocated again.
+   *
+   * This must be called on the root of the tree.  Statistics that store
+   * pointers to other nodes of the tree are not updated, so call this before
+   * they are initialized.
+   */
+  void Compact();
+
+  //! Return whether or not the descendants of this node are held contiguously.
+  bool IsCompact() const { return compactNodes != NULL; }
+
+  /**
+   * Insert the given points into the tree.  Each point is added to the leaf
+   * whose bound is closest to it, and the bounds, statistics and cached
+   * distances of the nodes it passes through are updated.  Leaves that grow
+   * beyond maxLeafSize are split, and any subtree that has seen more than
+   * RebuildFraction times its size in insertions and deletions since it was
+   * built is rebuilt from scratch, so the tree stays close to a freshly built
+   * one (as in scapegoat trees).  The bounds of nodes that are not rebuilt may
+   * be somewhat looser than those of a freshly built tree.
+   *
+   * The points of each node are contiguous in the dataset, so the dataset is
+   * rearranged once for every call; inserting many points in one call is much
+   * cheaper than inserting them one at a time.  This must be called on the
+   * root of the tree, and references to the dataset and pointers to nodes that
+   * are rebuilt are invalidated.  The new points are appended to the leaves
+   * they are inserted into, so the positions of the existing points in
+   * Dataset() may change; use the other overload to keep track of them.
+   *
+   * @param points Points to insert (one per column).
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   */
+  void InsertPoints(const MatType& points, const size_t maxLeafSize = 20);
+
+  /**
+   * Insert the given points into the tree, as above, and update the mapping
+   * from tree positions to original indices that was returned when the tree
+   * was built.  The new points are given the original indices N, ..., N + m - 1,
+   * where N is the number of points in the tree before the insertion and m is
+   * the number of new points.
+   *
+   * @param points Points to insert (one per column).
+   * @param oldFromNew Mapping from positions in Dataset() to original indices.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   */
+  void InsertPoints(const MatType& points,
+                    std::vector<size_t>& oldFromNew,
+                    const size_t maxLeafSize = 20);
+
+  /**
+   * Delete the points at the given positions of Dataset() from the tree.  The
+   * bounds of the leaves that held the points are recomputed, and subtrees are
+   * rebuilt when they become too small or have seen too many updates, as in
+   * InsertPoints().  This must be called on the root of the tree, and the
+   * positions of the remaining points in Dataset() may change.
+   *
+   * @param points Positions of the points to delete in Dataset().
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   */
+  void DeletePoints(const std::vector<size_t>& points,
+                    const size_t maxLeafSize = 20);
+
+  /**
+   * Delete the points at the given positions of Dataset() from the tree, as
+   * above, and update the mapping from tree positions to original indices.
+   * The original indices of the remaining points are renumbered to be
+   * contiguous again, keeping their order (as with arma::Mat::shed_cols()).
+   *
+   * @param points Positions of the points to delete in Dataset().
+   * @param oldFromNew Mapping from positions in Dataset() to original indices.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   */
+  void DeletePoints(const std::vector<size_t>& points,
+                    std::vector<size_t>& oldFromNew,
+                    const size_t maxLeafSize = 20);
+
+  /**
+   * Recompute the bound, the cached distances and the statistic of every node
+   * of this subtree, keeping its structure, after the points of Dataset() have
+   * been modified in place (for instance, after all of them were mapped by the
+   * same transformation).  Searches on the refitted tree are still exact, and
+   * refitting is much cheaper than building a new tree; but if the points
+   * moved a lot relative to each other, the bounds may overlap much more than
+   * those of a new tree, and searches may be slower.
+   */
+  void RefitBounds();
+
+  //! Return the number of points inserted into or deleted from this subtree
+  //! since it was built.
+  size_t Updates() const { return updates; }
+
   //! Return the bound object for this node.
-  const BoundType<MetricType>& Bound() const { return bound; }
+  const BoundType<MetricType, ElemType>& Bound() const { return bound; }
   //! Return the bound object for this node.
-  BoundType<MetricType>& Bound() { return bound; }
+  BoundType<MetricType, ElemType>& Bound() { return bound; }
 
   //! Return the statistic object for this node.
   const StatisticType& Stat() const { return stat; }
@@ -512,9 +666,12 @@ class BinarySpaceTree
    *
    * @param maxLeafSize Maximum number of points held in a leaf.
    * @param splitter Instantiated SplitType object.
+   * @param siblingCenter Center of the bound of the left sibling (see
+   *     UpdateBound()), or NULL.
    */
   void SplitNode(const size_t maxLeafSize,
-                 SplitType<BoundType<MetricType>, MatType>& splitter);
+                 SplitType<BoundType<MetricType, ElemType>, MatType>& splitter,
+                 const arma::Col<ElemType>* siblingCenter = NULL);
 
   /**
    * Splits the current node, assigning its left and right children recursively.
@@ -523,27 +680,134 @@ class BinarySpaceTree
    * @param oldFromNew Vector holding permuted indices.
    * @param maxLeafSize Maximum number of points held in a leaf.
    * @param splitter Instantiated SplitType object.
+   * @param siblingCenter Center of the bound of the left sibling (see
+   *     UpdateBound()), or NULL.
    */
   void SplitNode(std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize,
-                 SplitType<BoundType<MetricType>, MatType>& splitter);
+                 SplitType<BoundType<MetricType, ElemType>, MatType>& splitter,
+                 const arma::Col<ElemType>* siblingCenter = NULL);
+
+  /**
+   * Construct the left and right children of this node, given the column at
+   * which the points of this node were partitioned.  If OpenMP is available,
+   * the left child is built in a separate task; if this is the root of the
+   * tree, the parallel region for all tasks is opened here.
+   *
+   * @param splitCol Index of the first point that belongs to the right child.
+   * @param oldFromNew Vector holding permuted indices (NULL if not needed).
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  void SplitChildren(const size_t splitCol,
+                     std::vector<size_t>* oldFromNew,
+                     const size_t maxLeafSize,
+                     Split& splitter);
+
+  /**
+   * Construct the children of this node; called by SplitChildren(), possibly
+   * from inside of a parallel region.
+   */
+  void BuildChildren(const size_t splitCol,
+                     std::vector<size_t>* oldFromNew,
+                     const size_t maxLeafSize,
+                     Split& splitter);
+
+  /**
+   * Delete the children of this node, whether they are allocated individually
+   * or held in the contiguous block created by Compact().
+   */
+  void DeleteChildren();
+
+  /**
+   * Allocate every descendant of this node individually again, undoing
+   * Compact().
+   */
+  void Expand();
+
+  /**
+   * Insert and delete points; this is the implementation of InsertPoints() and
+   * DeletePoints().
+   *
+   * @param points Points to insert.
+   * @param deleted Positions in the dataset of the points to delete.
+   * @param oldFromNew Vector holding permuted indices (NULL if not needed).
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   */
+  void Update(const MatType& points,
+              const std::vector<size_t>& deleted,
+              std::vector<size_t>* oldFromNew,
+              const size_t maxLeafSize);
+
+  /**
+   * Copy the points of this subtree that are kept, followed by the points to
+   * be inserted into each leaf, into newDataset starting at the given column,
+   * and set the new begin and count of each node.  Returns the column after
+   * the last point of this subtree.
+   */
+  size_t Relayout(
+      const MatType& points,
+      const std::vector<bool>& isDeleted,
+      const std::unordered_map<const BinarySpaceTree*, std::vector<size_t>>&
+          insertions,
+      const std::vector<size_t>* oldFromNew,
+      const size_t firstNewIndex,
+      MatType& newDataset,
+      std::vector<size_t>& newOldFromNew,
+      size_t offset);
+
+  /**
+   * Rebuild the nodes of this subtree that were changed by an update and need
+   * it, and recompute the cached distances and statistics of every changed
+   * node.
+   */
+  void Refresh(const std::unordered_set<BinarySpaceTree*>& changed,
+               std::vector<size_t>* oldFromNew,
+               const size_t maxLeafSize);
 
   /**
    * Update the bound of the current node. This method does not take into
    * account bound-specific properties.
    *
    * @param boundToUpdate The bound to update.
+   * @param siblingCenter Ignored.
    */
   template<typename BoundType2>
-  void UpdateBound(BoundType2& boundToUpdate);
+  void UpdateBound(BoundType2& boundToUpdate,
+                   const arma::Col<ElemType>* siblingCenter = NULL);
 
   /**
    * Update the bound of the current node. This method is designed for
-   * HollowBallBound only.
+   * HollowBallBound only: the hollow of a right child is centered at the
+   * center of its left sibling.  While the tree is built, the sibling may be
+   * under construction in another task, so its center is given by the parent
+   * in siblingCenter; otherwise it is read from the sibling.
    *
    * @param boundToUpdate The bound to update.
+   * @param siblingCenter Center of the bound of the left sibling, or NULL.
    */
-  void UpdateBound(HollowBallBound<MetricType>& boundToUpdate);
+  void UpdateBound(HollowBallBound<MetricType, ElemType>& boundToUpdate,
+                   const arma::Col<ElemType>* siblingCenter = NULL);
+
+  /**
+   * Store in center the center that the bound of the left child of this node
+   * will have, given the column at which the points of this node were
+   * partitioned.  This is only needed for HollowBallBound; for other bounds
+   * center is left empty.
+   */
+  template<typename BoundType2>
+  void LeftChildCenter(const BoundType2& /* bound */,
+                       const size_t /* splitCol */,
+                       arma::Col<ElemType>& /* center */) const { }
+
+  /**
+   * Store in center the center that the bound of the left child of this node
+   * will have, given the column at which the points of this node were
+   * partitioned.
+   */
+  void LeftChildCenter(const HollowBallBound<MetricType, ElemType>& bound,
+                       const size_t splitCol,
+                       arma::Col<ElemType>& center) const;
 
  protected:
   /**
@@ -563,6 +827,12 @@ class BinarySpaceTree
    */
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t version);
+
+ private:
+  #ifdef MLPACK_TRACK_MEMORY
+  //! Counts this node in MemoryTracker for as long as it exists.
+  MemoryTracker::NodeCounter nodeCounter { sizeof(BinarySpaceTree) };
+  #endif
 };
 
 } // namespace mlpack
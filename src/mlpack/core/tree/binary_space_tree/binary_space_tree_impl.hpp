@@ -15,7 +15,13 @@
 #include "binary_space_tree.hpp"
 
 #include <mlpack/core/util/log.hpp>
+#include <mlpack/core/util/executor.hpp>
 #include <queue>
+#include <stack>
+
+#ifdef MLPACK_USE_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 
@@ -41,7 +47,7 @@ BinarySpaceTree(
     dataset(new MatType(data)) // Copies the dataset.
 {
   // Do the actual splitting of this node.
-  SplitType<BoundType<MetricType>, MatType> splitter;
+  SplitType<BoundType<MetricType, ElemType>, MatType> splitter;
   SplitNode(maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
@@ -74,7 +80,7 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
+  SplitType<BoundType<MetricType, ElemType>, MatType> splitter;
   SplitNode(oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
@@ -108,7 +114,7 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
+  SplitType<BoundType<MetricType, ElemType>, MatType> splitter;
   SplitNode(oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
@@ -138,7 +144,7 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     dataset(new MatType(std::move(data)))
 {
   // Do the actual splitting of this node.
-  SplitType<BoundType<MetricType>, MatType> splitter;
+  SplitType<BoundType<MetricType, ElemType>, MatType> splitter;
   SplitNode(maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
@@ -171,7 +177,7 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
+  SplitType<BoundType<MetricType, ElemType>, MatType> splitter;
   SplitNode(oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
@@ -205,7 +211,7 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
+  SplitType<BoundType<MetricType, ElemType>, MatType> splitter;
   SplitNode(oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
@@ -228,8 +234,9 @@ BinarySpaceTree(
     BinarySpaceTree* parent,
     const size_t begin,
     const size_t count,
-    SplitType<BoundType<MetricType>, MatType>& splitter,
-    const size_t maxLeafSize) :
+    SplitType<BoundType<MetricType, ElemType>, MatType>& splitter,
+    const size_t maxLeafSize,
+    const arma::Col<ElemType>* siblingCenter) :
     left(NULL),
     right(NULL),
     parent(parent),
@@ -239,7 +246,7 @@ BinarySpaceTree(
     dataset(&parent->Dataset()) // Point to the parent's dataset.
 {
   // Perform the actual splitting.
-  SplitNode(maxLeafSize, splitter);
+  SplitNode(maxLeafSize, splitter, siblingCenter);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -257,8 +264,9 @@ BinarySpaceTree(
     const size_t begin,
     const size_t count,
     std::vector<size_t>& oldFromNew,
-    SplitType<BoundType<MetricType>, MatType>& splitter,
-    const size_t maxLeafSize) :
+    SplitType<BoundType<MetricType, ElemType>, MatType>& splitter,
+    const size_t maxLeafSize,
+    const arma::Col<ElemType>* siblingCenter) :
     left(NULL),
     right(NULL),
     parent(parent),
@@ -272,7 +280,7 @@ BinarySpaceTree(
   assert(oldFromNew.size() == dataset->n_cols);
 
   // Perform the actual splitting.
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitNode(oldFromNew, maxLeafSize, splitter, siblingCenter);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -291,7 +299,7 @@ BinarySpaceTree(
     const size_t count,
     std::vector<size_t>& oldFromNew,
     std::vector<size_t>& newFromOld,
-    SplitType<BoundType<MetricType>, MatType>& splitter,
+    SplitType<BoundType<MetricType, ElemType>, MatType>& splitter,
     const size_t maxLeafSize) :
     left(NULL),
     right(NULL),
@@ -341,7 +349,8 @@ BinarySpaceTree(
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    updates(other.updates)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -397,11 +406,8 @@ operator=(const BinarySpaceTree& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  DeleteChildren();
 
-  left = NULL;
-  right = NULL;
   parent = other.Parent();
   begin = other.Begin();
   count = other.Count();
@@ -412,6 +418,7 @@ operator=(const BinarySpaceTree& other)
   minimumBoundDistance = other.MinimumBoundDistance();
   // Copy matrix, but only if we are the root.
   dataset = ((other.parent == NULL) ? new MatType(*other.dataset) : NULL);
+  updates = other.updates;
 
   // Create left and right children (if any).
   if (other.Left())
@@ -469,12 +476,13 @@ operator=(BinarySpaceTree&& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  DeleteChildren();
 
   parent = other.Parent();
   left = other.Left();
   right = other.Right();
+  compactNodes = other.compactNodes;
+  numCompactNodes = other.numCompactNodes;
   begin = other.Begin();
   count = other.Count();
   bound = std::move(other.bound);
@@ -483,6 +491,7 @@ operator=(BinarySpaceTree&& other)
   furthestDescendantDistance = other.FurthestDescendantDistance();
   minimumBoundDistance = other.MinimumBoundDistance();
   dataset = other.dataset;
+  updates = other.updates;
 
   other.left = NULL;
   other.right = NULL;
@@ -493,6 +502,15 @@ operator=(BinarySpaceTree&& other)
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.compactNodes = NULL;
+  other.numCompactNodes = 0;
+  other.updates = 0;
+
+  // Set new parent.
+  if (left)
+    left->parent = this;
+  if (right)
+    right->parent = this;
 
   return *this;
 }
@@ -519,19 +537,25 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    compactNodes(other.compactNodes),
+    numCompactNodes(other.numCompactNodes),
+    updates(other.updates)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
   other.left = NULL;
   other.right = NULL;
   other.parent = NULL;
+  other.compactNodes = NULL;
+  other.numCompactNodes = 0;
   other.begin = 0;
   other.count = 0;
   other.parentDistance = 0.0;
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.updates = 0;
 
   // Set new parent.
   if (left)
@@ -575,14 +599,576 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  DeleteChildren();
 
   // If we're the root, delete the matrix.
   if (!parent)
     delete dataset;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Compact()
+{
+  if (parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Compact(): must be called on "
+        "the root of the tree!");
+  }
+
+  // Count the number of descendant nodes.
+  size_t numNodes = 0;
+  std::stack<BinarySpaceTree*> stack;
+  if (left)
+    stack.push(left);
+  if (right)
+    stack.push(right);
+  while (!stack.empty())
+  {
+    BinarySpaceTree* node = stack.top();
+    stack.pop();
+    ++numNodes;
+
+    if (node->left)
+      stack.push(node->left);
+    if (node->right)
+      stack.push(node->right);
+  }
+
+  if (numNodes == 0)
+    return;
+
+  // Allocate raw memory for all of the nodes; each one is constructed in place
+  // by moving from the old node.
+  BinarySpaceTree* newNodes = static_cast<BinarySpaceTree*>(
+      ::operator new(numNodes * sizeof(BinarySpaceTree)));
+
+  // Each entry holds the node to be moved, the new parent of that node, and
+  // whether it is the left child of that parent.  The right child is pushed
+  // first so that the left child is placed directly after its parent.
+  std::stack<std::tuple<BinarySpaceTree*, BinarySpaceTree*, bool>> moveStack;
+  moveStack.push(std::make_tuple(right, this, false));
+  moveStack.push(std::make_tuple(left, this, true));
+
+  const bool wasCompact = (compactNodes != NULL);
+  size_t next = 0;
+  while (!moveStack.empty())
+  {
+    BinarySpaceTree* oldNode = std::get<0>(moveStack.top());
+    BinarySpaceTree* newParent = std::get<1>(moveStack.top());
+    const bool isLeft = std::get<2>(moveStack.top());
+    moveStack.pop();
+
+    // The move constructor takes the children of the old node and points them
+    // at the new node.
+    BinarySpaceTree* newNode = new (newNodes + next++)
+        BinarySpaceTree(std::move(*oldNode));
+    newNode->parent = newParent;
+    newNode->dataset = dataset;
+    if (isLeft)
+      newParent->left = newNode;
+    else
+      newParent->right = newNode;
+
+    // The old node holds nothing anymore.  If it lived in a previous compact
+    // block, that block is freed below.
+    if (!wasCompact)
+      delete oldNode;
+
+    if (newNode->left)
+    {
+      moveStack.push(std::make_tuple(newNode->right, newNode, false));
+      moveStack.push(std::make_tuple(newNode->left, newNode, true));
+    }
+  }
+
+  if (wasCompact)
+  {
+    for (size_t i = 0; i < numCompactNodes; ++i)
+      compactNodes[i].~BinarySpaceTree();
+    ::operator delete(compactNodes);
+  }
+
+  compactNodes = newNodes;
+  numCompactNodes = numNodes;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DeleteChildren()
+{
+  if (compactNodes)
+  {
+    // Every descendant is held in the contiguous block, so none of them should
+    // delete their children individually.
+    for (size_t i = 0; i < numCompactNodes; ++i)
+    {
+      compactNodes[i].left = NULL;
+      compactNodes[i].right = NULL;
+    }
+
+    for (size_t i = 0; i < numCompactNodes; ++i)
+      compactNodes[i].~BinarySpaceTree();
+    ::operator delete(compactNodes);
+
+    compactNodes = NULL;
+    numCompactNodes = 0;
+  }
+  else
+  {
+    delete left;
+    delete right;
+  }
+
+  left = NULL;
+  right = NULL;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Expand()
+{
+  if (!compactNodes)
+    return;
+
+  BinarySpaceTree* nodes = compactNodes;
+  const size_t numNodes = numCompactNodes;
+  compactNodes = NULL;
+  numCompactNodes = 0;
+
+  // Move every node out of the block.  The move constructor takes the children
+  // of the old node and points them at the new node, so the children are moved
+  // after their parent.
+  std::stack<BinarySpaceTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    BinarySpaceTree* node = stack.top();
+    stack.pop();
+
+    if (!node->left)
+      continue;
+
+    node->left = new BinarySpaceTree(std::move(*node->left));
+    node->right = new BinarySpaceTree(std::move(*node->right));
+    node->left->parent = node;
+    node->right->parent = node;
+
+    stack.push(node->right);
+    stack.push(node->left);
+  }
+
+  // The nodes left in the block hold nothing anymore.
+  for (size_t i = 0; i < numNodes; ++i)
+    nodes[i].~BinarySpaceTree();
+  ::operator delete(nodes);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    InsertPoints(const MatType& points, const size_t maxLeafSize)
+{
+  Update(points, std::vector<size_t>(), NULL, maxLeafSize);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    InsertPoints(const MatType& points,
+                 std::vector<size_t>& oldFromNew,
+                 const size_t maxLeafSize)
+{
+  Update(points, std::vector<size_t>(), &oldFromNew, maxLeafSize);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DeletePoints(const std::vector<size_t>& points, const size_t maxLeafSize)
+{
+  Update(MatType(), points, NULL, maxLeafSize);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DeletePoints(const std::vector<size_t>& points,
+                 std::vector<size_t>& oldFromNew,
+                 const size_t maxLeafSize)
+{
+  Update(MatType(), points, &oldFromNew, maxLeafSize);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Update(const MatType& points,
+           const std::vector<size_t>& deleted,
+           std::vector<size_t>* oldFromNew,
+           const size_t maxLeafSize)
+{
+  if (parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree::InsertPoints() and "
+        "DeletePoints() must be called on the root of the tree!");
+  }
+
+  if (points.n_cols > 0 && points.n_rows != dataset->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "BinarySpaceTree::InsertPoints(): dimensionality of points ("
+        << points.n_rows << ") does not match dimensionality of the tree ("
+        << dataset->n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (oldFromNew && oldFromNew->size() != count)
+  {
+    std::ostringstream oss;
+    oss << "BinarySpaceTree::InsertPoints() and DeletePoints(): size of "
+        << "oldFromNew (" << oldFromNew->size() << ") does not match the number "
+        << "of points in the tree (" << count << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Check all of the positions before anything is modified.  Positions that
+  // are given more than once are only deleted once.
+  std::vector<bool> isDeleted(count, false);
+  size_t numDeleted = 0;
+  for (size_t i = 0; i < deleted.size(); ++i)
+  {
+    if (deleted[i] >= count)
+    {
+      std::ostringstream oss;
+      oss << "BinarySpaceTree::DeletePoints(): position " << deleted[i]
+          << " is out of bounds (the tree holds " << count << " points)!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (!isDeleted[deleted[i]])
+    {
+      isDeleted[deleted[i]] = true;
+      ++numDeleted;
+    }
+  }
+
+  if (points.n_cols == 0 && numDeleted == 0)
+    return;
+
+  // Nodes in the compact block cannot be deleted individually when subtrees
+  // are rebuilt, so the tree is compacted again at the end.
+  const bool wasCompact = IsCompact();
+  Expand();
+
+  // Find the leaf that each new point goes to, and count the update in every
+  // node on the way.  Each point goes to the child whose bound is closest;
+  // ties (for instance, a point inside of both children) go to the smaller
+  // child.
+  std::unordered_set<BinarySpaceTree*> changed;
+  std::unordered_map<const BinarySpaceTree*, std::vector<size_t>> insertions;
+  std::vector<BinarySpaceTree*> leaves(points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    BinarySpaceTree* node = this;
+    while (true)
+    {
+      ++node->updates;
+      changed.insert(node);
+      if (node->IsLeaf())
+        break;
+
+      const ElemType leftDistance = node->left->MinDistance(points.col(i));
+      const ElemType rightDistance = node->right->MinDistance(points.col(i));
+      if (leftDistance < rightDistance || (leftDistance == rightDistance &&
+          node->left->count <= node->right->count))
+        node = node->left;
+      else
+        node = node->right;
+    }
+
+    insertions[node].push_back(i);
+    leaves[i] = node;
+  }
+
+  // Do the same for the leaves that hold the deleted points.
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (!isDeleted[i])
+      continue;
+
+    BinarySpaceTree* node = this;
+    while (true)
+    {
+      ++node->updates;
+      changed.insert(node);
+      if (node->IsLeaf())
+        break;
+
+      node = (i < node->right->begin) ? node->left : node->right;
+    }
+  }
+
+  // The original indices of the remaining points are renumbered to be
+  // contiguous, keeping their order.
+  std::vector<size_t> renumbered;
+  const std::vector<size_t>* keptOldFromNew = oldFromNew;
+  if (oldFromNew && numDeleted > 0)
+  {
+    std::vector<size_t> removedBefore(count, 0);
+    for (size_t i = 0; i < count; ++i)
+      if (isDeleted[i])
+        removedBefore[(*oldFromNew)[i]] = 1;
+
+    size_t removed = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      const size_t isRemoved = removedBefore[i];
+      removedBefore[i] = removed;
+      removed += isRemoved;
+    }
+
+    renumbered.resize(count);
+    for (size_t i = 0; i < count; ++i)
+      renumbered[i] = (*oldFromNew)[i] - removedBefore[(*oldFromNew)[i]];
+    keptOldFromNew = &renumbered;
+  }
+
+  // Rearrange the dataset in one pass, so that the points of every node are
+  // contiguous again.
+  const size_t newCount = count - numDeleted + points.n_cols;
+  MatType newDataset(dataset->n_rows, newCount);
+  std::vector<size_t> newOldFromNew;
+  if (oldFromNew)
+    newOldFromNew.reserve(newCount);
+  Relayout(points, isDeleted, insertions, keptOldFromNew, count - numDeleted,
+      newDataset, newOldFromNew, 0);
+  *dataset = std::move(newDataset);
+  if (oldFromNew)
+    *oldFromNew = std::move(newOldFromNew);
+
+  // The leaves that changed get a fresh bound, and the new points are added to
+  // the bounds of the nodes above them.  The bounds of those nodes are not
+  // shrunk when points are deleted, so they may be looser than necessary, but
+  // they still contain all of their points.
+  for (BinarySpaceTree* node : changed)
+  {
+    if (node->IsLeaf())
+    {
+      node->bound = BoundType<MetricType, ElemType>(dataset->n_rows);
+      node->UpdateBound(node->bound);
+    }
+  }
+
+  std::unordered_map<const BinarySpaceTree*, size_t> inserted;
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    const BinarySpaceTree* leaf = leaves[i];
+    const size_t col = leaf->begin + leaf->count -
+        insertions.at(leaf).size() + inserted[leaf]++;
+    for (BinarySpaceTree* node = leaf->parent; node; node = node->parent)
+      node->bound |= dataset->cols(col, col);
+  }
+
+  Refresh(changed, oldFromNew, maxLeafSize);
+
+  if (wasCompact)
+    Compact();
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+                       SplitType>::
+    Relayout(
+        const MatType& points,
+        const std::vector<bool>& isDeleted,
+        const std::unordered_map<const BinarySpaceTree*, std::vector<size_t>>&
+            insertions,
+        const std::vector<size_t>* oldFromNew,
+        const size_t firstNewIndex,
+        MatType& newDataset,
+        std::vector<size_t>& newOldFromNew,
+        size_t offset)
+{
+  const size_t oldBegin = begin;
+  const size_t oldCount = count;
+  begin = offset;
+
+  if (left)
+  {
+    offset = left->Relayout(points, isDeleted, insertions, oldFromNew,
+        firstNewIndex, newDataset, newOldFromNew, offset);
+    offset = right->Relayout(points, isDeleted, insertions, oldFromNew,
+        firstNewIndex, newDataset, newOldFromNew, offset);
+  }
+  else
+  {
+    // The points that are kept come first, followed by the new points.
+    for (size_t i = oldBegin; i < oldBegin + oldCount; ++i)
+    {
+      if (isDeleted[i])
+        continue;
+
+      newDataset.col(offset) = dataset->col(i);
+      if (oldFromNew)
+        newOldFromNew.push_back((*oldFromNew)[i]);
+      ++offset;
+    }
+
+    typename std::unordered_map<const BinarySpaceTree*,
+        std::vector<size_t>>::const_iterator it = insertions.find(this);
+    if (it != insertions.end())
+    {
+      for (size_t j = 0; j < it->second.size(); ++j)
+      {
+        newDataset.col(offset) = points.col(it->second[j]);
+        if (oldFromNew)
+          newOldFromNew.push_back(firstNewIndex + it->second[j]);
+        ++offset;
+      }
+    }
+  }
+
+  count = offset - begin;
+  return offset;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Refresh(const std::unordered_set<BinarySpaceTree*>& changed,
+            std::vector<size_t>* oldFromNew,
+            const size_t maxLeafSize)
+{
+  // Nodes that were not changed keep their points, so nothing below them has
+  // to be recomputed.
+  if (changed.count(this) == 0)
+    return;
+
+  // Leaves that grew too large are split.  Subtrees are rebuilt when they
+  // become too small, when one of their children lost all of its points, or
+  // when they have seen too many updates since they were built.
+  bool rebuild;
+  if (!PartialRebuild)
+    rebuild = true;
+  else if (IsLeaf())
+    rebuild = (count > maxLeafSize);
+  else
+    rebuild = (count <= maxLeafSize || left->count == 0 || right->count == 0 ||
+        updates > RebuildFraction * count);
+
+  if (rebuild)
+  {
+    DeleteChildren();
+    bound = BoundType<MetricType, ElemType>(dataset->n_rows);
+    updates = 0;
+
+    Split splitter;
+    if (oldFromNew)
+      SplitNode(*oldFromNew, maxLeafSize, splitter);
+    else
+      SplitNode(maxLeafSize, splitter);
+  }
+  else
+  {
+    furthestDescendantDistance = 0.5 * bound.Diameter();
+
+    if (left)
+    {
+      left->Refresh(changed, oldFromNew, maxLeafSize);
+      right->Refresh(changed, oldFromNew, maxLeafSize);
+
+      // The centers of this node and of its children may have moved.
+      arma::Col<ElemType> center, leftCenter, rightCenter;
+      Center(center);
+      left->Center(leftCenter);
+      right->Center(rightCenter);
+
+      left->ParentDistance() = bound.Metric().Evaluate(center, leftCenter);
+      right->ParentDistance() = bound.Metric().Evaluate(center, rightCenter);
+    }
+  }
+
+  // Initialize the statistic after the statistics of the children.
+  stat = StatisticType(*this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    RefitBounds()
+{
+  bound = BoundType<MetricType, ElemType>(dataset->n_rows);
+  UpdateBound(bound);
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  if (left)
+  {
+    left->RefitBounds();
+    right->RefitBounds();
+
+    // The centers of this node and of its children have moved.
+    arma::Col<ElemType> center, leftCenter, rightCenter;
+    Center(center);
+    left->Center(leftCenter);
+    right->Center(rightCenter);
+
+    left->ParentDistance() = bound.Metric().Evaluate(center, leftCenter);
+    right->ParentDistance() = bound.Metric().Evaluate(center, rightCenter);
+  }
+
+  // Initialize the statistic after the statistics of the children.
+  stat = StatisticType(*this);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -865,10 +1451,11 @@ template<typename MetricType,
              class SplitType>
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     SplitNode(const size_t maxLeafSize,
-              SplitType<BoundType<MetricType>, MatType>& splitter)
+              SplitType<BoundType<MetricType, ElemType>, MatType>& splitter,
+              const arma::Col<ElemType>* siblingCenter)
 {
   // We need to expand the bounds of this node properly.
-  UpdateBound(bound);
+  UpdateBound(bound, siblingCenter);
 
   // Calculate the furthest descendant distance.
   furthestDescendantDistance = 0.5 * bound.Diameter();
@@ -903,24 +1490,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
-      maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      splitter, maxLeafSize);
-
-  // Calculate parent distances for those two nodes.
-  arma::Col<ElemType> center, leftCenter, rightCenter;
-  Center(center);
-  left->Center(leftCenter);
-  right->Center(rightCenter);
-
-  const ElemType leftParentDistance = bound.Metric().Evaluate(center,
-      leftCenter);
-  const ElemType rightParentDistance = bound.Metric().Evaluate(center,
-      rightCenter);
-
-  left->ParentDistance() = leftParentDistance;
-  right->ParentDistance() = rightParentDistance;
+  SplitChildren(splitCol, NULL, maxLeafSize, splitter);
 }
 
 template<typename MetricType,
@@ -932,10 +1502,11 @@ template<typename MetricType,
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 SplitNode(std::vector<size_t>& oldFromNew,
           const size_t maxLeafSize,
-          SplitType<BoundType<MetricType>, MatType>& splitter)
+          SplitType<BoundType<MetricType, ElemType>, MatType>& splitter,
+          const arma::Col<ElemType>* siblingCenter)
 {
   // We need to expand the bounds of this node properly.
-  UpdateBound(bound);
+  UpdateBound(bound, siblingCenter);
 
   // Calculate the furthest descendant distance.
   furthestDescendantDistance = 0.5 * bound.Diameter();
@@ -971,10 +1542,40 @@ SplitNode(std::vector<size_t>& oldFromNew,
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, oldFromNew,
-      splitter, maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      oldFromNew, splitter, maxLeafSize);
+  SplitChildren(splitCol, &oldFromNew, maxLeafSize, splitter);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+SplitChildren(const size_t splitCol,
+              std::vector<size_t>* oldFromNew,
+              const size_t maxLeafSize,
+              SplitType<BoundType<MetricType, ElemType>, MatType>& splitter)
+{
+  #ifdef MLPACK_USE_OPENMP
+  // Only the outermost call needs to create the threads that the tasks for
+  // each child run on; recursive calls are already inside of that region.
+  if (ParallelBuild && count >= ParallelBuildCutoff && !omp_in_parallel() &&
+      NumThreads() > 1)
+  {
+    #pragma omp parallel num_threads((int) NumThreads())
+    {
+      #pragma omp single
+      BuildChildren(splitCol, oldFromNew, maxLeafSize, splitter);
+    }
+  }
+  else
+  {
+    BuildChildren(splitCol, oldFromNew, maxLeafSize, splitter);
+  }
+  #else
+  BuildChildren(splitCol, oldFromNew, maxLeafSize, splitter);
+  #endif
 
   // Calculate parent distances for those two nodes.
   arma::Col<ElemType> center, leftCenter, rightCenter;
@@ -991,6 +1592,62 @@ SplitNode(std::vector<size_t>& oldFromNew,
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BuildChildren(const size_t splitCol,
+              std::vector<size_t>* oldFromNew,
+              const size_t maxLeafSize,
+              SplitType<BoundType<MetricType, ElemType>, MatType>& splitter)
+{
+  // The two children hold disjoint ranges of the dataset (and of oldFromNew),
+  // so they can be built at the same time.  Small children are not worth the
+  // overhead of a task.
+  const size_t leftCount = splitCol - begin;
+  const size_t rightCount = begin + count - splitCol;
+
+  // The right child may need the center of the bound of the left child (for
+  // HollowBallBound).  It is computed here, before the task for the left child
+  // starts to reorder the points of the left child, so that neither child
+  // reads the points of the other.
+  arma::Col<ElemType> leftCenter;
+  LeftChildCenter(bound, splitCol, leftCenter);
+  const arma::Col<ElemType>* siblingCenter =
+      (leftCenter.n_elem > 0) ? &leftCenter : NULL;
+
+  #pragma omp task if (ParallelBuild && leftCount >= ParallelBuildCutoff) \
+      default(shared)
+  {
+    if (oldFromNew)
+    {
+      left = new BinarySpaceTree(this, begin, leftCount, *oldFromNew, splitter,
+          maxLeafSize);
+    }
+    else
+    {
+      left = new BinarySpaceTree(this, begin, leftCount, splitter,
+          maxLeafSize);
+    }
+  }
+
+  if (oldFromNew)
+  {
+    right = new BinarySpaceTree(this, splitCol, rightCount, *oldFromNew,
+        splitter, maxLeafSize, siblingCenter);
+  }
+  else
+  {
+    right = new BinarySpaceTree(this, splitCol, rightCount, splitter,
+        maxLeafSize, siblingCenter);
+  }
+
+  #pragma omp taskwait
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -999,7 +1656,8 @@ template<typename MetricType,
              class SplitType>
 template<typename BoundType2>
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
-UpdateBound(BoundType2& boundToUpdate)
+UpdateBound(BoundType2& boundToUpdate,
+            const arma::Col<ElemType>* /* siblingCenter */)
 {
   if (count > 0)
     boundToUpdate |= dataset->cols(begin, begin + count - 1);
@@ -1012,7 +1670,8 @@ template<typename MetricType,
          template<typename SplitBoundType, typename SplitMatType>
              class SplitType>
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
-UpdateBound(HollowBallBound<MetricType>& boundToUpdate)
+UpdateBound(HollowBallBound<MetricType, ElemType>& boundToUpdate,
+            const arma::Col<ElemType>* siblingCenter)
 {
   if (!parent)
   {
@@ -1021,7 +1680,16 @@ UpdateBound(HollowBallBound<MetricType>& boundToUpdate)
     return;
   }
 
-  if (parent->left != NULL && parent->left != this)
+  // If this is the right child, the hollow is centered at the center of the
+  // left sibling.  During construction the parent passes that center down,
+  // since the sibling may still be built in another task; when the bounds are
+  // updated later, the sibling is complete and its center can be read.
+  if (siblingCenter)
+  {
+    boundToUpdate.HollowCenter() = *siblingCenter;
+    boundToUpdate.InnerRadius() = std::numeric_limits<ElemType>::max();
+  }
+  else if (parent->left != NULL && parent->left != this)
   {
     boundToUpdate.HollowCenter() = parent->left->bound.Center();
     boundToUpdate.InnerRadius() = std::numeric_limits<ElemType>::max();
@@ -1031,6 +1699,26 @@ UpdateBound(HollowBallBound<MetricType>& boundToUpdate)
     boundToUpdate |= dataset->cols(begin, begin + count - 1);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+LeftChildCenter(const HollowBallBound<MetricType, ElemType>& /* bound */,
+                const size_t splitCol,
+                arma::Col<ElemType>& center) const
+{
+  // The bound of the left child has no hollow center of a sibling, so it is
+  // built from the points of the left child alone, in their current order.
+  // The result of operator|= depends on that order, so this must be done
+  // before the left child reorders its points.
+  HollowBallBound<MetricType, ElemType> leftBound(dataset->n_rows);
+  leftBound |= dataset->cols(begin, splitCol - 1);
+  center = leftBound.Center();
+}
+
 // Default constructor (private), for cereal.
 template<typename MetricType,
          typename StatisticType,
@@ -1069,16 +1757,11 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (cereal::is_loading<Archive>())
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    DeleteChildren();
     if (!parent)
       delete dataset;
 
     parent = NULL;
-    left = NULL;
-    right = NULL;
   }
 
   ar(CEREAL_NVP(begin));
@@ -19,6 +19,7 @@
 #include <queue>
 
 #include "../binary_space_tree.hpp"
+#include "leaf_base_cases.hpp"
 
 namespace mlpack {
 
@@ -101,6 +102,10 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
+
+  //! Query points passed to batched leaf base cases, held in the class so that
+  //! it isn't continually being reallocated.
+  std::vector<size_t> leafQueries;
 };
 
 } // namespace mlpack
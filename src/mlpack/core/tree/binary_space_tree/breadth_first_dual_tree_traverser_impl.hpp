@@ -128,24 +128,11 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
     // If both are leaves, we must evaluate the base case.
     if (queryNode.IsLeaf() && referenceNode.IsLeaf())
     {
-      // Loop through each of the points in each node.
-      const size_t queryEnd = queryNode.Begin() + queryNode.Count();
-      const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
-      for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
-      {
-        // See if we need to investigate this point (this function should be
-        // implemented for the single-tree recursion too).  Restore the
-        // traversal information first.
-//        const double childScore = rule.Score(query, referenceNode);
-
-//        if (childScore == DBL_MAX)
-//          continue; // We can't improve this particular point.
-
-        for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
-          rule.BaseCase(query, ref);
-
-        numBaseCases += referenceNode.Count();
-      }
+      // Compute the base cases between each pair of points in the nodes.  The
+      // individual query points are not scored here.  If the rules provide a
+      // batched base case for two leaves, it will be used.
+      numBaseCases += LeafBaseCases(rule, queryNode, referenceNode, ti, false,
+          leafQueries);
     }
     else if ((!queryNode.IsLeaf()) && referenceNode.IsLeaf())
     {
@@ -18,6 +18,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include "binary_space_tree.hpp"
+#include "leaf_base_cases.hpp"
 
 namespace mlpack {
 
@@ -85,6 +86,10 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
+
+  //! Query points passed to batched leaf base cases, held in the class so that
+  //! it isn't continually being reallocated.
+  std::vector<size_t> leafQueries;
 };
 
 } // namespace mlpack
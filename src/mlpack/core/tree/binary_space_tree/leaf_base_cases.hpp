@@ -0,0 +1,119 @@
+/**
+ * @file core/tree/binary_space_tree/leaf_base_cases.hpp
+ *
+ * Helper functions used by the BinarySpaceTree traversers to compute all of the
+ * base cases between two leaves.  If the rule set provides a batched
+ * LeafBaseCases() method, it is used; otherwise, BaseCase() is called for each
+ * pair of points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_LEAF_BASE_CASES_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_LEAF_BASE_CASES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+
+// This gives us a HasLeafBaseCases<T, U> type (where U is a function pointer)
+// we can use with SFINAE to catch when a rule set has a batched base case.
+HAS_MEM_FUNC(LeafBaseCases, HasLeafBaseCases);
+
+//! Utility struct: true if RuleType::LeafBaseCases() exists for TreeType.
+template<typename RuleType, typename TreeType>
+struct UseLeafBaseCases
+{
+  static const bool value = HasLeafBaseCases<RuleType,
+      void(RuleType::*)(const std::vector<size_t>&, TreeType&)>::value;
+};
+
+/**
+ * Compute the base cases between every point in the query leaf and every point
+ * in the reference leaf, using the batched LeafBaseCases() method of the rule
+ * set.  Query points that can be pruned are not passed to LeafBaseCases().
+ *
+ * @param rule Instantiated rule set.
+ * @param queryNode Query leaf.
+ * @param referenceNode Reference leaf.
+ * @param traversalInfo Traversal information to restore before each Score().
+ * @param scoreQueries If true, call Score() for each query point first and skip
+ *     the query points that can be pruned.
+ * @param queries Storage for the query indices, to avoid reallocation.
+ * @return Number of base cases that were computed.
+ */
+template<typename RuleType, typename TreeType>
+size_t LeafBaseCases(
+    RuleType& rule,
+    TreeType& queryNode,
+    TreeType& referenceNode,
+    const typename RuleType::TraversalInfoType& traversalInfo,
+    const bool scoreQueries,
+    std::vector<size_t>& queries,
+    const std::enable_if_t<UseLeafBaseCases<RuleType, TreeType>::value>* = 0)
+{
+  queries.clear();
+  const size_t queryEnd = queryNode.Begin() + queryNode.Count();
+  for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+  {
+    if (scoreQueries)
+    {
+      rule.TraversalInfo() = traversalInfo;
+      if (rule.Score(query, referenceNode) == DBL_MAX)
+        continue; // We can't improve this particular point.
+    }
+
+    queries.push_back(query);
+  }
+
+  if (!queries.empty())
+    rule.LeafBaseCases(queries, referenceNode);
+
+  return queries.size() * referenceNode.Count();
+}
+
+/**
+ * Compute the base cases between every point in the query leaf and every point
+ * in the reference leaf, one at a time, for rule sets that do not have a
+ * batched LeafBaseCases() method.
+ */
+template<typename RuleType, typename TreeType>
+size_t LeafBaseCases(
+    RuleType& rule,
+    TreeType& queryNode,
+    TreeType& referenceNode,
+    const typename RuleType::TraversalInfoType& traversalInfo,
+    const bool scoreQueries,
+    std::vector<size_t>& /* queries */,
+    const std::enable_if_t<!UseLeafBaseCases<RuleType, TreeType>::value>* = 0)
+{
+  size_t baseCases = 0;
+  const size_t queryEnd = queryNode.Begin() + queryNode.Count();
+  const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
+  for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+  {
+    // See if we need to investigate this point (this function should be
+    // implemented for the single-tree recursion too).  Restore the traversal
+    // information first.
+    if (scoreQueries)
+    {
+      rule.TraversalInfo() = traversalInfo;
+      if (rule.Score(query, referenceNode) == DBL_MAX)
+        continue; // We can't improve this particular point.
+    }
+
+    for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
+      rule.BaseCase(query, ref);
+
+    baseCases += referenceNode.Count();
+  }
+
+  return baseCases;
+}
+
+} // namespace mlpack
+
+#endif
@@ -59,13 +59,22 @@ class CosineTree
    * input matrix's projection on the obtained subspace is less than a fraction
    * of the norm of the input matrix.
    *
+   * Each round of splitting pops up to 'splitsPerRound' nodes from the queue
+   * and splits them at the same time (with OpenMP, if available), and the
+   * Monte Carlo estimate is only checked at the end of the round; so when more
+   * than one node is split per round, the basis may get a few more vectors
+   * than necessary.  With one split per round, the tree is the same as if it
+   * were built serially, for any number of threads.
+   *
    * @param dataset Matrix for which the CosineTree is constructed.
    * @param epsilon Error tolerance fraction for calculated subspace.
    * @param delta Cumulative probability for Monte Carlo error lower bound.
+   * @param splitsPerRound Maximum number of nodes split in each round.
    */
   CosineTree(const arma::mat& dataset,
              const double epsilon,
-             const double delta);
+             const double delta,
+             const size_t splitsPerRound = 1);
 
   /**
    * Copy the given tree.  Be careful!  This may use a lot of memory.
@@ -146,6 +155,21 @@ class CosineTree
    */
   void CosineNodeSplit();
 
+  /**
+   * Compute the columns that would be held by the left and right children of
+   * the node, if it were split; CosineNodeSplit() then creates the children
+   * with these columns.  This doesn't modify the node, so it can be called for
+   * several nodes at the same time.
+   *
+   * @param leftIndices Vector to store the indices (in this node) of the
+   *     columns of the left child in.
+   * @param rightIndices Vector to store the indices (in this node) of the
+   *     columns of the right child in.
+   * @return false if the node has too few columns to be split.
+   */
+  bool SplitColumns(std::vector<size_t>& leftIndices,
+                    std::vector<size_t>& rightIndices) const;
+
   /**
    * Sample 'numSamples' points from the Length-Squared distribution of the
    * cosine node. The function uses 'l2NormsSquared' to calculate the cumulative
@@ -185,7 +209,7 @@ class CosineTree
    *
    * @param cosines Vector to store the cosine values in.
    */
-  void CalculateCosines(arma::vec& cosines);
+  void CalculateCosines(arma::vec& cosines) const;
 
   /**
    * Calculate centroid of the columns present in the node. The calculated
@@ -241,6 +265,10 @@ class CosineTree
   size_t SplitPointIndex() const { return indices[splitPointIndex]; }
 
  private:
+  //! Number of rows handled by each thread when vectors of the size of a
+  //! column are accumulated in parallel.
+  static constexpr size_t RowBlockSize = 64;
+
   //! Matrix for which cosine tree is constructed.
   const arma::mat* dataset;
   //! Cumulative probability for Monte Carlo error lower bound.
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_TREE_COSINE_TREE_COSINE_TREE_IMPL_HPP
 
 #include "cosine_tree.hpp"
+#include <mlpack/core/util/executor.hpp>
 
 namespace mlpack {
 
@@ -29,6 +30,7 @@ inline CosineTree::CosineTree(const arma::mat& dataset) :
   l2NormsSquared.zeros(numColumns);
 
   // Set indices and calculate squared norms of the columns.
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
   for (size_t i = 0; i < numColumns; ++i)
   {
     indices[i] = i;
@@ -76,13 +78,20 @@ inline CosineTree::CosineTree(CosineTree& parentNode,
 
 inline CosineTree::CosineTree(const arma::mat& dataset,
                               const double epsilon,
-                              const double delta) :
+                              const double delta,
+                              const size_t splitsPerRound) :
     dataset(&dataset),
     delta(delta),
     left(NULL),
     right(NULL),
     localDataset(false)
 {
+  if (splitsPerRound == 0)
+  {
+    throw std::invalid_argument("CosineTree::CosineTree(): splitsPerRound "
+        "must be positive");
+  }
+
   // Declare the cosine tree priority queue.
   CosineNodeQueue treeQueue;
   CompareCosineNode comp;
@@ -97,59 +106,85 @@ inline CosineTree::CosineTree(const arma::mat& dataset,
   // Initialize Monte Carlo error estimate for comparison.
   double monteCarloError = root.FrobNormSquared();
 
+  bool canImprove = true;
   while (treeQueue.size() > 0 &&
          (monteCarloError > epsilon * root.FrobNormSquared()))
   {
-    // Pop node from queue with highest projection error.
-    CosineTree* currentNode;
-    currentNode = treeQueue.front();
-    std::pop_heap(treeQueue.begin(), treeQueue.end(), comp);
-    treeQueue.pop_back();
-
-    // If the priority is 0, we can't improve anything, and we can assume that
-    // we've done the best we can.
-    if (currentNode->L2Error() == 0.0)
+    // Pop the nodes from queue with highest projection error.
+    std::vector<CosineTree*> currentNodes;
+    while (currentNodes.size() < splitsPerRound && treeQueue.size() > 0)
     {
-      Log::Warn << "CosineTree::CosineTree(): could not build tree to "
-          << "desired relative error " << epsilon << "; failing with estimated "
-          << "relative error " << (monteCarloError / root.FrobNormSquared())
-          << "." << std::endl;
-      break;
+      CosineTree* currentNode;
+      currentNode = treeQueue.front();
+      std::pop_heap(treeQueue.begin(), treeQueue.end(), comp);
+      treeQueue.pop_back();
+
+      // If the priority is 0, we can't improve anything, and we can assume
+      // that we've done the best we can.
+      if (currentNode->L2Error() == 0.0)
+      {
+        canImprove = false;
+        break;
+      }
+
+      currentNodes.push_back(currentNode);
     }
 
-    // Split the node into left and right children.  We assume that this cannot
-    // fail; it might fail if L2Error() is 0, but we have already avoided that
-    // case.
-    currentNode->CosineNodeSplit();
-
-    // Obtain pointers to the left and right children of the current node.
-    CosineTree *currentLeft, *currentRight;
-    currentLeft = currentNode->Left();
-    currentRight = currentNode->Right();
-
-    // Calculate basis vectors of left and right children.
-    arma::vec lBasisVector, rBasisVector;
-
-    ModifiedGramSchmidt(treeQueue, currentLeft->Centroid(), lBasisVector);
-    ModifiedGramSchmidt(treeQueue, currentRight->Centroid(), rBasisVector,
-                        &lBasisVector);
-
-    // Add basis vectors to their respective nodes.
-    currentLeft->BasisVector(lBasisVector);
-    currentRight->BasisVector(rBasisVector);
+    // Split the nodes into left and right children.  We assume that this
+    // cannot fail; it might fail if L2Error() is 0, but we have already avoided
+    // that case.  Finding the columns of the children is the expensive part,
+    // and it is independent for each node, so it is done for all of them at
+    // the same time; the children are then created in order, so that they
+    // sample their split points in the same order for any number of threads.
+    std::vector<std::vector<size_t>> leftIndices(currentNodes.size());
+    std::vector<std::vector<size_t>> rightIndices(currentNodes.size());
+    #pragma omp parallel for schedule(dynamic) if (currentNodes.size() > 1) \
+        num_threads((int) NumThreads())
+    for (size_t i = 0; i < currentNodes.size(); ++i)
+      currentNodes[i]->SplitColumns(leftIndices[i], rightIndices[i]);
+
+    const size_t oldQueueSize = treeQueue.size();
+    for (size_t i = 0; i < currentNodes.size(); ++i)
+    {
+      CosineTree* currentNode = currentNodes[i];
+      currentNode->Left() = new CosineTree(*currentNode, leftIndices[i]);
+      currentNode->Right() = new CosineTree(*currentNode, rightIndices[i]);
+
+      // Calculate basis vectors of left and right children.  Each one is
+      // orthogonalized against the queue, which holds the basis vectors of
+      // the children already added in this round.
+      CosineTree* children[2] = { currentNode->Left(), currentNode->Right() };
+      for (size_t c = 0; c < 2; ++c)
+      {
+        arma::vec basisVector;
+        ModifiedGramSchmidt(treeQueue, children[c]->Centroid(), basisVector);
+        children[c]->BasisVector(basisVector);
+        treeQueue.push_back(children[c]);
+      }
+    }
 
-    // Calculate Monte Carlo error estimates for child nodes.
-    MonteCarloError(currentLeft, treeQueue, &lBasisVector, &rBasisVector);
-    MonteCarloError(currentRight, treeQueue, &lBasisVector, &rBasisVector);
+    // Calculate Monte Carlo error estimates for child nodes, now that the
+    // whole new basis is in the queue.
+    for (size_t i = oldQueueSize; i < treeQueue.size(); ++i)
+      MonteCarloError(treeQueue[i], treeQueue);
 
-    // Push child nodes into the priority queue.
-    treeQueue.push_back(currentLeft);
-    std::push_heap(treeQueue.begin(), treeQueue.end(), comp);
-    treeQueue.push_back(currentRight);
-    std::push_heap(treeQueue.begin(), treeQueue.end(), comp);
+    // Now that the errors of the children are known, restore the priority
+    // queue.
+    for (size_t i = oldQueueSize; i < treeQueue.size(); ++i)
+      std::push_heap(treeQueue.begin(), treeQueue.begin() + i + 1, comp);
 
     // Calculate Monte Carlo error estimate for the root node.
-    monteCarloError = MonteCarloError(&root, treeQueue);
+    if (!currentNodes.empty())
+      monteCarloError = MonteCarloError(&root, treeQueue);
+
+    if (!canImprove)
+    {
+      Log::Warn << "CosineTree::CosineTree(): could not build tree to "
+          << "desired relative error " << epsilon << "; failing with estimated "
+          << "relative error " << (monteCarloError / root.FrobNormSquared())
+          << "." << std::endl;
+      break;
+    }
   }
 
   // Construct the subspace basis from the current priority queue.
@@ -378,18 +413,29 @@ inline void CosineTree::ModifiedGramSchmidt(CosineNodeQueue& treeQueue,
   // Set new basis vector to centroid.
   newBasisVector = centroid;
 
-  // Variables for iterating throught the priority queue.
-  CosineTree *currentNode;
-  CosineNodeQueue::const_iterator i = treeQueue.cbegin();
+  // Compute the projection of the centroid onto every vector in the current
+  // basis.
+  arma::vec projections(treeQueue.size());
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t i = 0; i < treeQueue.size(); ++i)
+    projections[i] = dot(treeQueue[i]->BasisVector(), centroid);
 
   // For every vector in the current basis, remove its projection from the
-  // centroid.
-  for ( ; i != treeQueue.cend(); ++i)
+  // centroid.  Each block of rows is handled by one thread, in the order of
+  // the queue, so the result doesn't depend on the number of threads.
+  const size_t numBlocks = (newBasisVector.n_elem + RowBlockSize - 1) /
+      RowBlockSize;
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
   {
-    currentNode = *i;
-
-    double projection = dot(currentNode->BasisVector(), centroid);
-    newBasisVector -= projection * currentNode->BasisVector();
+    const size_t first = b * RowBlockSize;
+    const size_t last = std::min(first + RowBlockSize,
+        (size_t) newBasisVector.n_elem) - 1;
+    for (size_t i = 0; i < treeQueue.size(); ++i)
+    {
+      newBasisVector.subvec(first, last) -= projections[i] *
+          treeQueue[i]->BasisVector().subvec(first, last);
+    }
   }
 
   // If additional basis vector is passed, take it into account.
@@ -432,36 +478,37 @@ inline double CosineTree::MonteCarloError(CosineTree* node,
   else
     projectionSize = treeQueue.size();
 
-  // For each sample, calculate the weighted projection onto the current basis.
-  for (size_t i = 0; i < numSamples; ++i)
+  // Compute the projection of the sampled vectors onto the existing subspace.
+  // There are only O(log m) samples, so the work is split over the vectors of
+  // the basis.
+  arma::mat projections(projectionSize, numSamples);
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t k = 0; k < treeQueue.size(); ++k)
   {
-    // Initialize projection as a vector of zeros.
-    arma::vec projection;
-    projection.zeros(projectionSize);
-
-    CosineTree *currentNode;
-    CosineNodeQueue::const_iterator j = treeQueue.cbegin();
-
-    size_t k = 0;
-    // Compute the projection of the sampled vector onto the existing subspace.
-    for ( ; j != treeQueue.cend(); ++j, ++k)
+    for (size_t i = 0; i < numSamples; ++i)
     {
-      currentNode = *j;
-
-      projection(k) = dot(dataset.col(sampledIndices[i]),
-                                currentNode->BasisVector());
+      projections(k, i) = dot(dataset.col(sampledIndices[i]),
+                              treeQueue[k]->BasisVector());
     }
-    // If two additional vectors are passed, take their projections.
-    if (addBasisVector1 && addBasisVector2)
+  }
+
+  // If two additional vectors are passed, take their projections.
+  if (addBasisVector1 && addBasisVector2)
+  {
+    for (size_t i = 0; i < numSamples; ++i)
     {
-      projection(k++) = dot(dataset.col(sampledIndices[i]),
-                                  *addBasisVector1);
-      projection(k) = dot(dataset.col(sampledIndices[i]),
-                                *addBasisVector2);
+      projections(treeQueue.size(), i) = dot(dataset.col(sampledIndices[i]),
+                                             *addBasisVector1);
+      projections(treeQueue.size() + 1, i) =
+          dot(dataset.col(sampledIndices[i]), *addBasisVector2);
     }
+  }
 
+  // For each sample, calculate the weighted projection onto the current basis.
+  for (size_t i = 0; i < numSamples; ++i)
+  {
     // Calculate the Frobenius norm squared of the projected vector.
-    double frobProjection = arma::norm(projection, "frob");
+    double frobProjection = arma::norm(projections.col(i), "frob");
     double frobProjectionSquared = frobProjection * frobProjection;
 
     // Calculate the weighted projection magnitude.
@@ -507,11 +554,23 @@ inline void CosineTree::ConstructBasis(CosineNodeQueue& treeQueue)
 }
 
 inline void CosineTree::CosineNodeSplit()
+{
+  std::vector<size_t> leftIndices, rightIndices;
+  if (!SplitColumns(leftIndices, rightIndices))
+    return;
+
+  // Split the node into left and right children.
+  left = new CosineTree(*this, leftIndices);
+  right = new CosineTree(*this, rightIndices);
+}
+
+inline bool CosineTree::SplitColumns(std::vector<size_t>& leftIndices,
+                                     std::vector<size_t>& rightIndices) const
 {
   // If less than two points, splitting does not make sense---there is nothing
   // to split.
   if (numColumns < 2)
-    return;
+    return false;
 
   // Calculate cosines with respect to the splitting point.
   arma::vec cosines;
@@ -522,7 +581,8 @@ inline void CosineTree::CosineNodeSplit()
   cosineMax = arma::max(cosines % (cosines < 1));
   cosineMin = min(cosines);
 
-  std::vector<size_t> leftIndices, rightIndices;
+  leftIndices.clear();
+  rightIndices.clear();
 
   // Split columns into left and right children. The splitting condition for the
   // column to be in the left child is as follows:
@@ -538,9 +598,7 @@ inline void CosineTree::CosineNodeSplit()
       rightIndices.push_back(i);
   }
 
-  // Split the node into left and right children.
-  left = new CosineTree(*this, leftIndices);
-  right = new CosineTree(*this, rightIndices);
+  return true;
 }
 
 inline void CosineTree::ColumnSamplesLS(std::vector<size_t>& sampledIndices,
@@ -630,11 +688,12 @@ inline size_t CosineTree::BinarySearch(arma::vec& cDistribution,
   }
 }
 
-inline void CosineTree::CalculateCosines(arma::vec& cosines)
+inline void CosineTree::CalculateCosines(arma::vec& cosines) const
 {
   // Initialize cosine vector as a vector of zeros.
   cosines.zeros(numColumns);
 
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
   for (size_t i = 0; i < numColumns; ++i)
   {
     // If norm is zero, store cosine value as zero. Else, calculate cosine value
@@ -657,10 +716,22 @@ inline void CosineTree::CalculateCentroid()
   // Initialize centroid as vector of zeros.
   centroid.zeros(dataset->n_rows);
 
-  // Calculate centroid of columns in the node.
-  for (size_t i = 0; i < numColumns; ++i)
+  // Calculate centroid of columns in the node.  Each block of rows is summed
+  // by one thread, in the order of the columns, so the result doesn't depend
+  // on the number of threads.
+  const size_t numBlocks = (centroid.n_elem + RowBlockSize - 1) /
+      RowBlockSize;
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
   {
-    centroid += dataset->col(indices[i]);
+    const size_t first = b * RowBlockSize;
+    const size_t last = std::min(first + RowBlockSize,
+        (size_t) centroid.n_elem) - 1;
+    for (size_t i = 0; i < numColumns; ++i)
+    {
+      centroid.subvec(first, last) += dataset->submat(first, indices[i], last,
+          indices[i]);
+    }
   }
   centroid /= numColumns;
 }
@@ -363,11 +363,12 @@ class CoverTree
   ElemType MinDistance(const CoverTree& other, const ElemType distance) const;
 
   //! Return the minimum distance to another point.
-  ElemType MinDistance(const arma::vec& other) const;
+  ElemType MinDistance(const arma::Col<ElemType>& other) const;
 
   //! Return the minimum distance to another point given that the distance from
   //! the center to the point has already been calculated.
-  ElemType MinDistance(const arma::vec& other, const ElemType distance) const;
+  ElemType MinDistance(const arma::Col<ElemType>& other,
+                       const ElemType distance) const;
 
   //! Return the maximum distance to another node.
   ElemType MaxDistance(const CoverTree& other) const;
@@ -377,11 +378,12 @@ class CoverTree
   ElemType MaxDistance(const CoverTree& other, const ElemType distance) const;
 
   //! Return the maximum distance to another point.
-  ElemType MaxDistance(const arma::vec& other) const;
+  ElemType MaxDistance(const arma::Col<ElemType>& other) const;
 
   //! Return the maximum distance to another point given that the distance from
   //! the center to the point has already been calculated.
-  ElemType MaxDistance(const arma::vec& other, const ElemType distance) const;
+  ElemType MaxDistance(const arma::Col<ElemType>& other,
+                       const ElemType distance) const;
 
   //! Return the minimum and maximum distance to another node.
   RangeType<ElemType> RangeDistance(const CoverTree& other) const;
@@ -392,11 +394,11 @@ class CoverTree
                                           const ElemType distance) const;
 
   //! Return the minimum and maximum distance to another point.
-  RangeType<ElemType> RangeDistance(const arma::vec& other) const;
+  RangeType<ElemType> RangeDistance(const arma::Col<ElemType>& other) const;
 
   //! Return the minimum and maximum distance to another point given that the
   //! point-to-point distance has already been calculated.
-  RangeType<ElemType> RangeDistance(const arma::vec& other,
+  RangeType<ElemType> RangeDistance(const arma::Col<ElemType>& other,
                                           const ElemType distance) const;
 
   //! Get the parent node.
@@ -424,9 +426,9 @@ class CoverTree
   ElemType MinimumBoundDistance() const { return furthestDescendantDistance; }
 
   //! Get the center of the node and store it in the given vector.
-  void Center(arma::vec& center) const
+  void Center(arma::Col<ElemType>& center) const
   {
-    center = arma::vec(dataset->col(point));
+    center = arma::Col<ElemType>(dataset->col(point));
   }
 
   //! Get the instantiated metric.
@@ -473,7 +475,8 @@ class CoverTree
    * Fill the vector of distances with the distances between the point specified
    * by pointIndex and each point in the indices array.  The distances of the
    * first pointSetSize points in indices are calculated (so, this does not
-   * necessarily need to use all of the points in the arrays).
+   * necessarily need to use all of the points in the arrays).  For large point
+   * sets, the distances are computed in parallel when OpenMP is available.
    *
    * @param pointIndex Point to build the distances for.
    * @param indices List of indices to compute distances for.
@@ -572,6 +575,11 @@ class CoverTree
 
  private:
   size_t distanceComps;
+
+  #ifdef MLPACK_TRACK_MEMORY
+  //! Counts this node in MemoryTracker for as long as it exists.
+  MemoryTracker::NodeCounter nodeCounter { sizeof(CoverTree) };
+  #endif
 };
 
 } // namespace mlpack
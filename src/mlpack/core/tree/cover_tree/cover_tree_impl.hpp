@@ -14,6 +14,7 @@
 
 // In case it hasn't already been included.
 #include "cover_tree.hpp"
+#include <mlpack/core/util/executor.hpp>
 
 #include <queue>
 #include <string>
@@ -934,7 +935,8 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
   // Every cover tree node will contain points up to base^(scale + 1) away.
   return std::max(metric->Evaluate(dataset->col(point),
       other.Dataset().col(other.Point())) -
-      furthestDescendantDistance - other.FurthestDescendantDistance(), 0.0);
+      furthestDescendantDistance - other.FurthestDescendantDistance(),
+      (ElemType) 0.0);
 }
 
 template<
@@ -950,7 +952,8 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
 {
   // We already have the distance as evaluated by the metric.
   return std::max(distance - furthestDescendantDistance -
-      other.FurthestDescendantDistance(), 0.0);
+      other.FurthestDescendantDistance(),
+      (ElemType) 0.0);
 }
 
 template<
@@ -962,10 +965,10 @@ template<
 typename CoverTree<MetricType, StatisticType, MatType,
     RootPointPolicy>::ElemType
 CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    MinDistance(const arma::vec& other) const
+    MinDistance(const arma::Col<ElemType>& other) const
 {
   return std::max(metric->Evaluate(dataset->col(point), other) -
-      furthestDescendantDistance, 0.0);
+      furthestDescendantDistance, (ElemType) 0.0);
 }
 
 template<
@@ -977,9 +980,10 @@ template<
 typename CoverTree<MetricType, StatisticType, MatType,
     RootPointPolicy>::ElemType
 CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    MinDistance(const arma::vec& /* other */, const ElemType distance) const
+    MinDistance(const arma::Col<ElemType>& /* other */,
+                const ElemType distance) const
 {
-  return std::max(distance - furthestDescendantDistance, 0.0);
+  return std::max(distance - furthestDescendantDistance, (ElemType) 0.0);
 }
 
 template<
@@ -1023,7 +1027,7 @@ template<
 typename CoverTree<MetricType, StatisticType, MatType,
     RootPointPolicy>::ElemType
 CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    MaxDistance(const arma::vec& other) const
+    MaxDistance(const arma::Col<ElemType>& other) const
 {
   return metric->Evaluate(dataset->col(point), other) +
       furthestDescendantDistance;
@@ -1038,7 +1042,8 @@ template<
 typename CoverTree<MetricType, StatisticType, MatType,
     RootPointPolicy>::ElemType
 CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    MaxDistance(const arma::vec& /* other */, const ElemType distance) const
+    MaxDistance(const arma::Col<ElemType>& /* other */,
+                const ElemType distance) const
 {
   return distance + furthestDescendantDistance;
 }
@@ -1060,7 +1065,8 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
 
   RangeType<ElemType> result;
   result.Lo() = std::max(distance - furthestDescendantDistance -
-      other.FurthestDescendantDistance(), 0.0);
+      other.FurthestDescendantDistance(),
+      (ElemType) 0.0);
   result.Hi() = distance + furthestDescendantDistance +
       other.FurthestDescendantDistance();
 
@@ -1083,7 +1089,8 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
 {
   RangeType<ElemType> result;
   result.Lo() = std::max(distance - furthestDescendantDistance -
-      other.FurthestDescendantDistance(), 0.0);
+      other.FurthestDescendantDistance(),
+      (ElemType) 0.0);
   result.Hi() = distance + furthestDescendantDistance +
       other.FurthestDescendantDistance();
 
@@ -1100,12 +1107,12 @@ template<
 RangeType<typename
     CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::ElemType>
 CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    RangeDistance(const arma::vec& other) const
+    RangeDistance(const arma::Col<ElemType>& other) const
 {
   const ElemType distance = metric->Evaluate(dataset->col(point), other);
 
   return RangeType<ElemType>(
-      std::max(distance - furthestDescendantDistance, 0.0),
+      std::max(distance - furthestDescendantDistance, (ElemType) 0.0),
       distance + furthestDescendantDistance);
 }
 
@@ -1120,11 +1127,11 @@ template<
 RangeType<typename
     CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::ElemType>
 CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    RangeDistance(const arma::vec& /* other */,
+    RangeDistance(const arma::Col<ElemType>& /* other */,
                   const ElemType distance) const
 {
   return RangeType<ElemType>(
-      std::max(distance - furthestDescendantDistance, 0.0),
+      std::max(distance - furthestDescendantDistance, (ElemType) 0.0),
       distance + furthestDescendantDistance);
 }
 
@@ -1395,8 +1402,12 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
                      const size_t pointSetSize)
 {
   // For each point, rebuild the distances.  The indices do not need to be
-  // modified.
+  // modified.  The distances are independent, so large point sets (near the
+  // top of the tree, where most of the distances of the construction are
+  // computed) are split into contiguous blocks, one per thread.
   distanceComps += pointSetSize;
+  #pragma omp parallel for schedule(static) if (pointSetSize >= 1024) \
+      num_threads((int) NumThreads())
   for (size_t i = 0; i < pointSetSize; ++i)
   {
     distances[i] = metric->Evaluate(dataset->col(pointIndex),
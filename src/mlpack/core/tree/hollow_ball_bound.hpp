@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/metric_traits.hpp>
 #include "bound_traits.hpp"
 
 namespace mlpack {
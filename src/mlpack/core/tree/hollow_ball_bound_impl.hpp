@@ -400,8 +400,14 @@ HollowBallBound<TMetricType, ElemType>::operator|=(const MatType& data)
     const ElemType dist = metric->Evaluate(center, data.col(i));
     const ElemType hollowDist = metric->Evaluate(hollowCenter, data.col(i));
 
-    // See if the new point lies outside the bound.
-    if (dist > radii.Hi())
+    // See if the new point lies outside the bound.  Without a norm, there is
+    // no point between the center and the new point to move to, so only the
+    // radius grows.
+    if (dist > radii.Hi() && !MetricTraits<TMetricType>::IsNormInduced)
+    {
+      radii.Hi() = dist;
+    }
+    else if (dist > radii.Hi())
     {
       // Move towards the new point and increase the radius just enough to
       // accommodate the new point.
@@ -184,6 +184,26 @@ class HRectBound
   template<typename MatType>
   HRectBound& operator|=(const MatType& data);
 
+  /**
+   * Expands this region to include the columns of a sparse matrix.  Only the
+   * nonzero elements are visited; a dimension gets the value 0 if any of the
+   * points has no nonzero element in it.
+   *
+   * @param data Sparse data points to expand this region to include.
+   */
+  template<typename eT>
+  HRectBound& operator|=(const arma::SpMat<eT>& data);
+
+  /**
+   * Expands this region to include the points of a sparse subview (usually the
+   * columns of a node of a tree built on a sparse matrix).  Only the nonzero
+   * elements are visited.
+   *
+   * @param data Sparse data points to expand this region to include.
+   */
+  template<typename eT>
+  HRectBound& operator|=(const arma::SpSubview<eT>& data);
+
   /**
    * Expands this region to encompass another bound.
    */
@@ -231,6 +251,35 @@ class HRectBound
   void serialize(Archive& ar, const uint32_t version);
 
  private:
+  /**
+   * Calculate the minimum bound-to-point distance, looping over FixedDim
+   * dimensions (or over Dim() dimensions if FixedDim is 0).  The public
+   * functions call these with a compile-time dimension for 2 to 8 dimensions,
+   * so that the loop is unrolled and vectorized.
+   */
+  template<size_t FixedDim, typename VecType>
+  ElemType MinDistanceImpl(const VecType& point) const;
+
+  //! Calculate the minimum bound-to-bound distance over FixedDim dimensions.
+  template<size_t FixedDim>
+  ElemType MinDistanceImpl(const HRectBound& other) const;
+
+  //! Calculate the maximum bound-to-point distance over FixedDim dimensions.
+  template<size_t FixedDim, typename VecType>
+  ElemType MaxDistanceImpl(const VecType& point) const;
+
+  //! Calculate the maximum bound-to-bound distance over FixedDim dimensions.
+  template<size_t FixedDim>
+  ElemType MaxDistanceImpl(const HRectBound& other) const;
+
+  //! Expand the region to include the columns firstCol to firstCol + nCols - 1
+  //! of the sparse matrix m, using the rows firstRow to firstRow + Dim() - 1.
+  template<typename eT>
+  void ExpandSparse(const arma::SpMat<eT>& m,
+                    const size_t firstRow,
+                    const size_t firstCol,
+                    const size_t nCols);
+
   //! The dimensionality of the bound.
   size_t dim;
   //! The bounds for each dimension.
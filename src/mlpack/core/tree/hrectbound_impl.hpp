@@ -191,10 +191,31 @@ inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
 {
   Log::Assert(point.n_elem == dim);
 
+  switch (dim)
+  {
+    case 2: return MinDistanceImpl<2>(point);
+    case 3: return MinDistanceImpl<3>(point);
+    case 4: return MinDistanceImpl<4>(point);
+    case 5: return MinDistanceImpl<5>(point);
+    case 6: return MinDistanceImpl<6>(point);
+    case 7: return MinDistanceImpl<7>(point);
+    case 8: return MinDistanceImpl<8>(point);
+    default: return MinDistanceImpl<0>(point);
+  }
+}
+
+template<typename MetricType, typename ElemType>
+template<size_t FixedDim, typename VecType>
+inline ElemType HRectBound<MetricType, ElemType>::MinDistanceImpl(
+    const VecType& point) const
+{
+  // If the dimensionality is known at compile time, the compiler can unroll
+  // the loop.
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
   ElemType sum = 0;
 
   ElemType lower, higher;
-  for (size_t d = 0; d < dim; d++)
+  for (size_t d = 0; d < n; d++)
   {
     lower = bounds[d].Lo() - point[d];
     higher = point[d] - bounds[d].Hi();
@@ -248,12 +269,33 @@ ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
 {
   Log::Assert(dim == other.dim);
 
+  switch (dim)
+  {
+    case 2: return MinDistanceImpl<2>(other);
+    case 3: return MinDistanceImpl<3>(other);
+    case 4: return MinDistanceImpl<4>(other);
+    case 5: return MinDistanceImpl<5>(other);
+    case 6: return MinDistanceImpl<6>(other);
+    case 7: return MinDistanceImpl<7>(other);
+    case 8: return MinDistanceImpl<8>(other);
+    default: return MinDistanceImpl<0>(other);
+  }
+}
+
+template<typename MetricType, typename ElemType>
+template<size_t FixedDim>
+inline ElemType HRectBound<MetricType, ElemType>::MinDistanceImpl(
+    const HRectBound& other) const
+{
+  // If the dimensionality is known at compile time, the compiler can unroll
+  // the loop.
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
   ElemType sum = 0;
   const RangeType<ElemType>* mbound = bounds;
   const RangeType<ElemType>* obound = other.bounds;
 
   ElemType lower, higher;
-  for (size_t d = 0; d < dim; d++)
+  for (size_t d = 0; d < n; d++)
   {
     lower = obound->Lo() - mbound->Hi();
     higher = mbound->Lo() - obound->Hi();
@@ -309,11 +351,32 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
 {
-  ElemType sum = 0;
-
   Log::Assert(point.n_elem == dim);
 
-  for (size_t d = 0; d < dim; d++)
+  switch (dim)
+  {
+    case 2: return MaxDistanceImpl<2>(point);
+    case 3: return MaxDistanceImpl<3>(point);
+    case 4: return MaxDistanceImpl<4>(point);
+    case 5: return MaxDistanceImpl<5>(point);
+    case 6: return MaxDistanceImpl<6>(point);
+    case 7: return MaxDistanceImpl<7>(point);
+    case 8: return MaxDistanceImpl<8>(point);
+    default: return MaxDistanceImpl<0>(point);
+  }
+}
+
+template<typename MetricType, typename ElemType>
+template<size_t FixedDim, typename VecType>
+inline ElemType HRectBound<MetricType, ElemType>::MaxDistanceImpl(
+    const VecType& point) const
+{
+  // If the dimensionality is known at compile time, the compiler can unroll
+  // the loop.
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
+  ElemType sum = 0;
+
+  for (size_t d = 0; d < n; d++)
   {
     ElemType v = std::max(fabs(point[d] - bounds[d].Lo()),
         fabs(bounds[d].Hi() - point[d]));
@@ -350,12 +413,33 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     const HRectBound& other)
     const
 {
-  ElemType sum = 0;
-
   Log::Assert(dim == other.dim);
 
+  switch (dim)
+  {
+    case 2: return MaxDistanceImpl<2>(other);
+    case 3: return MaxDistanceImpl<3>(other);
+    case 4: return MaxDistanceImpl<4>(other);
+    case 5: return MaxDistanceImpl<5>(other);
+    case 6: return MaxDistanceImpl<6>(other);
+    case 7: return MaxDistanceImpl<7>(other);
+    case 8: return MaxDistanceImpl<8>(other);
+    default: return MaxDistanceImpl<0>(other);
+  }
+}
+
+template<typename MetricType, typename ElemType>
+template<size_t FixedDim>
+inline ElemType HRectBound<MetricType, ElemType>::MaxDistanceImpl(
+    const HRectBound& other) const
+{
+  // If the dimensionality is known at compile time, the compiler can unroll
+  // the loop.
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
+  ElemType sum = 0;
+
   ElemType v;
-  for (size_t d = 0; d < dim; d++)
+  for (size_t d = 0; d < n; d++)
   {
     v = std::max(fabs(other.bounds[d].Hi() - bounds[d].Lo()),
         fabs(bounds[d].Hi() - other.bounds[d].Lo()));
@@ -553,6 +637,85 @@ HRectBound<MetricType, ElemType>::operator|=(const MatType& data)
   return *this;
 }
 
+/**
+ * Expands this region to include the columns of a sparse matrix.
+ */
+template<typename MetricType, typename ElemType>
+template<typename eT>
+inline HRectBound<MetricType, ElemType>&
+HRectBound<MetricType, ElemType>::operator|=(const arma::SpMat<eT>& data)
+{
+  Log::Assert(data.n_rows == dim);
+
+  ExpandSparse(data, 0, 0, data.n_cols);
+  return *this;
+}
+
+/**
+ * Expands this region to include the points of a sparse subview.
+ */
+template<typename MetricType, typename ElemType>
+template<typename eT>
+inline HRectBound<MetricType, ElemType>&
+HRectBound<MetricType, ElemType>::operator|=(const arma::SpSubview<eT>& data)
+{
+  Log::Assert(data.n_rows == dim);
+
+  ExpandSparse(data.m, data.aux_row1, data.aux_col1, data.n_cols);
+  return *this;
+}
+
+template<typename MetricType, typename ElemType>
+template<typename eT>
+inline void HRectBound<MetricType, ElemType>::ExpandSparse(
+    const arma::SpMat<eT>& m,
+    const size_t firstRow,
+    const size_t firstCol,
+    const size_t nCols)
+{
+  if (nCols == 0)
+    return;
+
+  arma::Col<ElemType> mins(dim);
+  arma::Col<ElemType> maxs(dim);
+  mins.fill(std::numeric_limits<ElemType>::max());
+  maxs.fill(std::numeric_limits<ElemType>::lowest());
+  arma::uvec nonzeros(dim, arma::fill::zeros);
+
+  m.sync();
+  for (size_t col = firstCol; col < firstCol + nCols; ++col)
+  {
+    for (size_t i = m.col_ptrs[col]; i < m.col_ptrs[col + 1]; ++i)
+    {
+      const size_t row = m.row_indices[i];
+      if (row < firstRow || row >= firstRow + dim)
+        continue;
+
+      const size_t d = row - firstRow;
+      const ElemType value = m.values[i];
+      mins[d] = std::min(mins[d], value);
+      maxs[d] = std::max(maxs[d], value);
+      ++nonzeros[d];
+    }
+  }
+
+  minWidth = std::numeric_limits<ElemType>::max();
+  for (size_t i = 0; i < dim; ++i)
+  {
+    // The points without a nonzero element in this dimension are at 0.
+    if (nonzeros[i] < nCols)
+    {
+      mins[i] = std::min(mins[i], ElemType(0));
+      maxs[i] = std::max(maxs[i], ElemType(0));
+    }
+
+    bounds[i] |= RangeType<ElemType>(mins[i], maxs[i]);
+    const ElemType width = bounds[i].Width();
+    if (width < minWidth)
+      minWidth = width;
+  }
+}
+
 /**
  * Expands this region to encompass another bound.
  */
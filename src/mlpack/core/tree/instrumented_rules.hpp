@@ -0,0 +1,178 @@
+/**
+ * @file core/tree/instrumented_rules.hpp
+ *
+ * The InstrumentedRules class wraps any RuleType class and records the calls
+ * that a traverser makes to it in a TraversalStatistics object.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_INSTRUMENTED_RULES_HPP
+#define MLPACK_CORE_TREE_INSTRUMENTED_RULES_HPP
+
+#include "traversal_statistics.hpp"
+
+namespace mlpack {
+
+/**
+ * InstrumentedRules is a RuleType class that behaves exactly like the RuleType
+ * it derives from, but records every call to Score(), Rescore() and BaseCase()
+ * made by the traverser in the given TraversalStatistics object.  If the
+ * statistics pointer is NULL, nothing is recorded and the only overhead is one
+ * check per call; so a method can always use InstrumentedRules, and only pay
+ * for collecting statistics when they are asked for.
+ *
+ * Base cases are attributed to the level of the last reference node that was
+ * scored.  Calls that the rules make to their own BaseCase() (for instance
+ * from inside Score()) are not seen by the wrapper, so their time is counted
+ * as part of Score().
+ *
+ * @code
+ * TraversalStatistics statistics(true);
+ * InstrumentedRules<RuleType> rules(&statistics, ...);
+ * DualTreeTraverser<InstrumentedRules<RuleType>> traverser(rules);
+ * traverser.Traverse(queryTree, referenceTree);
+ * std::cout << statistics.ToJSON() << std::endl;
+ * @endcode
+ *
+ * @tparam RuleType Type of rules to record the calls of.
+ */
+template<typename RuleType>
+class InstrumentedRules : public RuleType
+{
+ public:
+  /**
+   * Construct the rules; all arguments but the first are passed to the
+   * constructor of RuleType.
+   *
+   * @param statistics Object to record the calls in, or NULL to record
+   *     nothing.
+   * @param args Arguments of the RuleType constructor.
+   */
+  template<typename... Args>
+  InstrumentedRules(TraversalStatistics* statistics, Args&&... args) :
+      RuleType(std::forward<Args>(args)...),
+      statistics(statistics),
+      level(0)
+  {
+    // Nothing to do.
+  }
+
+  //! Compute the base case, and record it.
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex)
+  {
+    if (!statistics)
+      return RuleType::BaseCase(queryIndex, referenceIndex);
+
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    const double result = RuleType::BaseCase(queryIndex, referenceIndex);
+    statistics->AddBaseCase(level, TraversalStatistics::Seconds(start));
+    return result;
+  }
+
+  /**
+   * Compute the base cases between the given query points and every point of
+   * the given reference leaf with the batched LeafBaseCases() of RuleType, and
+   * record them.  This only exists if RuleType has LeafBaseCases(), so that the
+   * traversers still detect whether the wrapped rules can batch base cases.
+   */
+  template<typename TreeType>
+  auto LeafBaseCases(const std::vector<size_t>& queryIndices,
+                     TreeType& referenceNode)
+      -> decltype(std::declval<RuleType&>().LeafBaseCases(queryIndices,
+                                                          referenceNode))
+  {
+    if (!statistics)
+      return RuleType::LeafBaseCases(queryIndices, referenceNode);
+
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    RuleType::LeafBaseCases(queryIndices, referenceNode);
+    statistics->AddBaseCase(level, TraversalStatistics::Seconds(start),
+        queryIndices.size() * referenceNode.Count());
+  }
+
+  //! Score the given query point and reference node, and record it.
+  template<typename TreeType>
+  double Score(const size_t queryIndex, TreeType& referenceNode)
+  {
+    if (!statistics)
+      return RuleType::Score(queryIndex, referenceNode);
+
+    level = TraversalStatistics::Depth(referenceNode);
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    const double score = RuleType::Score(queryIndex, referenceNode);
+    statistics->AddScore(level, score == DBL_MAX, referenceNode.IsLeaf(),
+        TraversalStatistics::Seconds(start));
+    return score;
+  }
+
+  //! Score the given query node and reference node, and record it.
+  template<typename TreeType>
+  double Score(TreeType& queryNode, TreeType& referenceNode)
+  {
+    if (!statistics)
+      return RuleType::Score(queryNode, referenceNode);
+
+    level = TraversalStatistics::Depth(referenceNode);
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    const double score = RuleType::Score(queryNode, referenceNode);
+    statistics->AddScore(level, score == DBL_MAX, queryNode.IsLeaf() &&
+        referenceNode.IsLeaf(), TraversalStatistics::Seconds(start));
+    return score;
+  }
+
+  //! Rescore the given query point and reference node, and record it.
+  template<typename TreeType>
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore)
+  {
+    if (!statistics || oldScore == DBL_MAX)
+      return RuleType::Rescore(queryIndex, referenceNode, oldScore);
+
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    const double score = RuleType::Rescore(queryIndex, referenceNode,
+        oldScore);
+    statistics->AddRescore(TraversalStatistics::Depth(referenceNode),
+        score == DBL_MAX, TraversalStatistics::Seconds(start));
+    return score;
+  }
+
+  //! Rescore the given query node and reference node, and record it.
+  template<typename TreeType>
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore)
+  {
+    if (!statistics || oldScore == DBL_MAX)
+      return RuleType::Rescore(queryNode, referenceNode, oldScore);
+
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    const double score = RuleType::Rescore(queryNode, referenceNode,
+        oldScore);
+    statistics->AddRescore(TraversalStatistics::Depth(referenceNode),
+        score == DBL_MAX, TraversalStatistics::Seconds(start));
+    return score;
+  }
+
+  //! Get the statistics object that calls are recorded in (or NULL).
+  TraversalStatistics* Statistics() const { return statistics; }
+
+ private:
+  //! The object to record calls in, or NULL.
+  TraversalStatistics* statistics;
+  //! The level of the last reference node that was scored.
+  size_t level;
+};
+
+} // namespace mlpack
+
+#endif
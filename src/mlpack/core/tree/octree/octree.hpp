@@ -18,6 +18,27 @@
 
 namespace mlpack {
 
+/**
+ * An octree (or, in d dimensions, a 2^d-tree) recursively splits the bounding
+ * box of the data into 2^d cells of equal size around its center; empty cells
+ * get no node.
+ *
+ * The root nodes are built from Morton codes: the cell that each point falls
+ * into at each level is computed for all points in parallel and interleaved
+ * into one code per point, the points are radix sorted by their codes, and
+ * each node is then made of the points whose codes share a prefix.  So the
+ * dataset is reordered once, in Z-order, instead of being partitioned again at
+ * every level; nodes that are still too big when the bits of the codes run out
+ * (which takes 64 / d levels) are split recursively as before.  If mlpack is
+ * compiled with OpenMP, children with more than ParallelBuildCutoff points are
+ * built in separate OpenMP tasks.  The resulting tree and ordering of the data
+ * do not depend on the number of threads.
+ *
+ * @tparam MetricType The metric used for tree-building.
+ * @tparam StatisticType Extra data contained in the node.  See statistic.hpp
+ *     for the necessary skeleton interface.
+ * @tparam MatType The dataset class.
+ */
 template<typename MetricType = EuclideanDistance,
          typename StatisticType = EmptyStatistic,
          typename MatType = arma::mat>
@@ -29,6 +50,10 @@ class Octree
   //! The type of element held in MatType.
   typedef typename MatType::elem_type ElemType;
 
+  //! Nodes with at least this many points build their children in parallel
+  //! (when OpenMP is available).
+  static constexpr size_t ParallelBuildCutoff = 4096;
+
   //! A single-tree traverser; see single_tree_traverser.hpp.
   template<typename RuleType>
   class SingleTreeTraverser;
@@ -49,7 +74,7 @@ class Octree
   size_t count;
   //! The minimum bounding rectangle of the points held in the node (and its
   //! children).
-  HRectBound<MetricType> bound;
+  HRectBound<MetricType, ElemType> bound;
   //! The dataset.
   MatType* dataset;
   //! The parent (NULL if this node is the root).
@@ -172,7 +197,7 @@ class Octree
   Octree(Octree* parent,
          const size_t begin,
          const size_t count,
-         const arma::vec& center,
+         const arma::Col<ElemType>& center,
          const double width,
          const size_t maxLeafSize = 20);
 
@@ -200,7 +225,7 @@ class Octree
          const size_t begin,
          const size_t count,
          std::vector<size_t>& oldFromNew,
-         const arma::vec& center,
+         const arma::Col<ElemType>& center,
          const double width,
          const size_t maxLeafSize = 20);
 
@@ -257,9 +282,9 @@ class Octree
   Octree*& Parent() { return parent; }
 
   //! Return the bound object for this node.
-  const HRectBound<MetricType>& Bound() const { return bound; }
+  const HRectBound<MetricType, ElemType>& Bound() const { return bound; }
   //! Modify the bound object for this node.
-  HRectBound<MetricType>& Bound() { return bound; }
+  HRectBound<MetricType, ElemType>& Bound() { return bound; }
 
   //! Return the statistic object for this node.
   const StatisticType& Stat() const { return stat; }
@@ -393,7 +418,7 @@ class Octree
       typename std::enable_if_t<IsVector<VecType>::value>* = 0) const;
 
   //! Store the center of the bounding region in the given vector.
-  void Center(arma::vec& center) const { bound.Center(center); }
+  void Center(arma::Col<ElemType>& center) const { bound.Center(center); }
 
   //! Serialize the tree.
   template<typename Archive>
@@ -420,7 +445,7 @@ class Octree
    * @param width Width of the current node.
    * @param maxLeafSize Maximum number of points allowed in a leaf.
    */
-  void SplitNode(const arma::vec& center,
+  void SplitNode(const arma::Col<ElemType>& center,
                  const double width,
                  const size_t maxLeafSize);
 
@@ -433,11 +458,90 @@ class Octree
    * @param oldFromNew Mappings from old to new.
    * @param maxLeafSize Maximum number of points allowed in a leaf.
    */
-  void SplitNode(const arma::vec& center,
+  void SplitNode(const arma::Col<ElemType>& center,
                  const double width,
                  std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize);
 
+  /**
+   * Construct this node as a child of the given parent, from the points
+   * between begin and (begin + count) of the parent's dataset, which are
+   * sorted by their Morton codes.  This is used by BuildMorton().
+   *
+   * @param parent Parent of this node.
+   * @param begin Index of point to start tree construction with.
+   * @param count Number of points to use to construct tree.
+   * @param center Center of the node (for splitting).
+   * @param width Width of the node in each dimension.
+   * @param codes Morton codes of the points of the dataset.
+   * @param level Level of the node (the root is at level 0).
+   * @param oldFromNew Mappings from old to new (NULL if not needed).
+   * @param maxLeafSize Maximum number of points in a leaf node.
+   */
+  Octree(Octree* parent,
+         const size_t begin,
+         const size_t count,
+         const arma::Col<ElemType>& center,
+         const double width,
+         const std::vector<uint64_t>& codes,
+         const size_t level,
+         std::vector<size_t>* oldFromNew,
+         const size_t maxLeafSize);
+
+  /**
+   * Build the tree below the root from the Morton codes of the points: compute
+   * the codes, sort the dataset (and oldFromNew, if given) in Z-order, and
+   * split the root with SplitNodeMorton().
+   *
+   * @param center Center of the node.
+   * @param width Width of the current node.
+   * @param oldFromNew Mappings from old to new (NULL if not needed).
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void BuildMorton(const arma::Col<ElemType>& center,
+                   const double width,
+                   std::vector<size_t>* oldFromNew,
+                   const size_t maxLeafSize);
+
+  /**
+   * Split the node into the children given by the next digit of the Morton
+   * codes of its points, which are already sorted.  If no digits are left, the
+   * node is split with SplitNode() instead.
+   *
+   * @param center Center of the node.
+   * @param width Width of the current node.
+   * @param codes Morton codes of the points of the dataset.
+   * @param level Level of the node (the root is at level 0).
+   * @param oldFromNew Mappings from old to new (NULL if not needed).
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void SplitNodeMorton(const arma::Col<ElemType>& center,
+                       const double width,
+                       const std::vector<uint64_t>& codes,
+                       const size_t level,
+                       std::vector<size_t>* oldFromNew,
+                       const size_t maxLeafSize);
+
+  /**
+   * Sort the given Morton codes with a stable radix sort, and fill order with
+   * the original index of each sorted code.
+   *
+   * @param codes Codes to sort.
+   * @param bits Number of low bits used by the codes.
+   * @param order Vector which will be filled with the sorting permutation.
+   */
+  static void RadixSort(std::vector<uint64_t>& codes,
+                        const size_t bits,
+                        std::vector<size_t>& order);
+
+  //! Get the number of levels that a Morton code holds in the given number of
+  //! dimensions.
+  static size_t MortonLevels(const size_t dimensionality)
+  {
+    return (dimensionality == 0 || dimensionality >= 64) ? 0 :
+        64 / dimensionality;
+  }
+
   /**
    * This is used for sorting points while splitting.
    */
@@ -446,12 +550,13 @@ class Octree
     struct SplitInfo
     {
       //! Create the SplitInfo object.
-      SplitInfo(const size_t d, const arma::vec& c) : d(d), center(c) {}
+      SplitInfo(const size_t d, const arma::Col<ElemType>& c) :
+          d(d), center(c) { }
 
       //! The dimension we are splitting on.
       size_t d;
       //! The center of the node.
-      const arma::vec& center;
+      const arma::Col<ElemType>& center;
     };
 
     template<typename VecType>
@@ -460,6 +565,12 @@ class Octree
       return point[s.d] < s.center[s.d];
     }
   };
+
+ private:
+  #ifdef MLPACK_TRACK_MEMORY
+  //! Counts this node in MemoryTracker for as long as it exists.
+  MemoryTracker::NodeCounter nodeCounter { sizeof(Octree) };
+  #endif
 };
 
 } // namespace mlpack
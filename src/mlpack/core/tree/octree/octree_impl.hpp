@@ -14,6 +14,7 @@
 
 #include "octree.hpp"
 #include <mlpack/core/tree/perform_split.hpp>
+#include <mlpack/core/util/executor.hpp>
 #include <stack>
 
 namespace mlpack {
@@ -33,7 +34,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(const MatType& dataset,
   {
     // Calculate empirical center of data.
     bound |= *this->dataset;
-    arma::vec center;
+    arma::Col<ElemType> center;
     bound.Center(center);
 
     double maxWidth = 0.0;
@@ -41,7 +42,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(const MatType& dataset,
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, maxLeafSize);
+    BuildMorton(center, maxWidth, NULL, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -75,7 +76,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   {
     // Calculate empirical center of data.
     bound |= *this->dataset;
-    arma::vec center;
+    arma::Col<ElemType> center;
     bound.Center(center);
 
     double maxWidth = 0.0;
@@ -83,7 +84,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    BuildMorton(center, maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -118,7 +119,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   {
     // Calculate empirical center of data.
     bound |= *this->dataset;
-    arma::vec center;
+    arma::Col<ElemType> center;
     bound.Center(center);
 
     double maxWidth = 0.0;
@@ -126,7 +127,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    BuildMorton(center, maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -159,7 +160,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(MatType&& dataset,
   {
     // Calculate empirical center of data.
     bound |= *this->dataset;
-    arma::vec center;
+    arma::Col<ElemType> center;
     bound.Center(center);
 
     double maxWidth = 0.0;
@@ -167,7 +168,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(MatType&& dataset,
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, maxLeafSize);
+    BuildMorton(center, maxWidth, NULL, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -201,7 +202,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   {
     // Calculate empirical center of data.
     bound |= *this->dataset;
-    arma::vec center;
+    arma::Col<ElemType> center;
     bound.Center(center);
 
     double maxWidth = 0.0;
@@ -209,7 +210,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    BuildMorton(center, maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -244,7 +245,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   {
     // Calculate empirical center of data.
     bound |= *this->dataset;
-    arma::vec center;
+    arma::Col<ElemType> center;
     bound.Center(center);
 
     double maxWidth = 0.0;
@@ -252,7 +253,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    BuildMorton(center, maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -276,7 +277,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     Octree* parent,
     const size_t begin,
     const size_t count,
-    const arma::vec& center,
+    const arma::Col<ElemType>& center,
     const double width,
     const size_t maxLeafSize) :
     begin(begin),
@@ -293,7 +294,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
 
   // Calculate the distance from the empirical center of this node to the
   // empirical center of the parent.
-  arma::vec trueCenter, parentCenter;
+  arma::Col<ElemType> trueCenter, parentCenter;
   bound.Center(trueCenter);
   parent->Bound().Center(parentCenter);
   parentDistance = metric.Evaluate(trueCenter, parentCenter);
@@ -311,7 +312,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     const size_t begin,
     const size_t count,
     std::vector<size_t>& oldFromNew,
-    const arma::vec& center,
+    const arma::Col<ElemType>& center,
     const double width,
     const size_t maxLeafSize) :
     begin(begin),
@@ -328,7 +329,44 @@ Octree<MetricType, StatisticType, MatType>::Octree(
 
   // Calculate the distance from the empirical center of this node to the
   // empirical center of the parent.
-  arma::vec trueCenter, parentCenter;
+  arma::Col<ElemType> trueCenter, parentCenter;
+  bound.Center(trueCenter);
+  parent->Bound().Center(parentCenter);
+  parentDistance = metric.Evaluate(trueCenter, parentCenter);
+
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  // Initialize the statistic.
+  stat = StatisticType(*this);
+}
+
+//! Construct a child node from points sorted by their Morton codes.
+template<typename MetricType, typename StatisticType, typename MatType>
+Octree<MetricType, StatisticType, MatType>::Octree(
+    Octree* parent,
+    const size_t begin,
+    const size_t count,
+    const arma::Col<ElemType>& center,
+    const double width,
+    const std::vector<uint64_t>& codes,
+    const size_t level,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize) :
+    begin(begin),
+    count(count),
+    bound(parent->dataset->n_rows),
+    dataset(parent->dataset),
+    parent(parent)
+{
+  // Calculate empirical center of data.
+  bound |= dataset->cols(begin, begin + count - 1);
+
+  // Now split the node.
+  SplitNodeMorton(center, width, codes, level, oldFromNew, maxLeafSize);
+
+  // Calculate the distance from the empirical center of this node to the
+  // empirical center of the parent.
+  arma::Col<ElemType> trueCenter, parentCenter;
   bound.Center(trueCenter);
   parent->Bound().Center(parentCenter);
   parentDistance = metric.Evaluate(trueCenter, parentCenter);
@@ -518,7 +556,7 @@ size_t Octree<MetricType, StatisticType, MatType>::GetNearestChild(
 {
   // It's possible that this could be improved by caching which children we have
   // and which we don't, but for now this is just a brute force search.
-  ElemType bestDistance = DBL_MAX;
+  ElemType bestDistance = std::numeric_limits<ElemType>::max();
   size_t bestIndex = NumChildren();
   for (size_t i = 0; i < NumChildren(); ++i)
   {
@@ -562,7 +600,7 @@ size_t Octree<MetricType, StatisticType, MatType>::GetNearestChild(
 {
   // It's possible that this could be improved by caching which children we have
   // and which we don't, but for now this is just a brute force search.
-  ElemType bestDistance = DBL_MAX;
+  ElemType bestDistance = std::numeric_limits<ElemType>::max();
   size_t bestIndex = NumChildren();
   for (size_t i = 0; i < NumChildren(); ++i)
   {
@@ -769,10 +807,241 @@ void Octree<MetricType, StatisticType, MatType>::serialize(
   }
 }
 
+//! Build the tree from the Morton codes of the points.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::BuildMorton(
+    const arma::Col<ElemType>& center,
+    const double width,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  // No need to split if we have fewer than the maximum number of points in this
+  // node.
+  if (count <= maxLeafSize)
+    return;
+
+  // If not even one level fits in a code, split the usual way.
+  const size_t dims = dataset->n_rows;
+  const size_t levels = MortonLevels(dims);
+  if (levels == 0)
+  {
+    if (oldFromNew)
+      SplitNode(center, width, *oldFromNew, maxLeafSize);
+    else
+      SplitNode(center, width, maxLeafSize);
+    return;
+  }
+
+  // Compute the code of each point.  The digit of each level holds one bit for
+  // each dimension, which is set if the point is in the right half of its cell
+  // in that dimension; the cells are computed exactly like in SplitNode(), so
+  // the tree is the same.
+  std::vector<uint64_t> codes(count);
+  #pragma omp parallel if (count >= ParallelBuildCutoff) \
+      num_threads((int) NumThreads())
+  {
+    arma::Col<ElemType> cellCenter(dims);
+
+    #pragma omp for schedule(static)
+    for (size_t i = 0; i < count; ++i)
+    {
+      cellCenter = center;
+      double cellWidth = width;
+      uint64_t code = 0;
+      for (size_t l = 0; l < levels; ++l)
+      {
+        cellWidth /= 2.0;
+        uint64_t digit = 0;
+        for (size_t d = 0; d < dims; ++d)
+        {
+          if (SplitType::AssignToLeftNode(dataset->col(i),
+              typename SplitType::SplitInfo(d, cellCenter)))
+          {
+            cellCenter[d] = cellCenter[d] - cellWidth;
+          }
+          else
+          {
+            digit |= ((uint64_t) 1 << d);
+            cellCenter[d] = cellCenter[d] + cellWidth;
+          }
+        }
+
+        code = (code << dims) | digit;
+      }
+
+      codes[i] = code;
+    }
+  }
+
+  std::vector<size_t> order;
+  RadixSort(codes, levels * dims, order);
+
+  // Now reorder the dataset (and the mappings) in Z-order.  Sparse columns
+  // can't be set concurrently.
+  MatType sorted(dims, count);
+  #pragma omp parallel for schedule(static) \
+      if (count >= ParallelBuildCutoff && !arma::is_SpMat<MatType>::value) \
+      num_threads((int) NumThreads())
+  for (size_t i = 0; i < count; ++i)
+    sorted.col(i) = dataset->col(order[i]);
+  *dataset = std::move(sorted);
+
+  if (oldFromNew)
+  {
+    std::vector<size_t> sortedOldFromNew(count);
+    for (size_t i = 0; i < count; ++i)
+      sortedOldFromNew[i] = (*oldFromNew)[order[i]];
+    oldFromNew->swap(sortedOldFromNew);
+  }
+
+  SplitNodeMorton(center, width, codes, 0, oldFromNew, maxLeafSize);
+}
+
+//! Split the node using the sorted Morton codes of its points.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::SplitNodeMorton(
+    const arma::Col<ElemType>& center,
+    const double width,
+    const std::vector<uint64_t>& codes,
+    const size_t level,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  // No need to split if we have fewer than the maximum number of points in this
+  // node.
+  if (count <= maxLeafSize)
+    return;
+
+  // If the codes have no digits left, the points are split the usual way.
+  const size_t dims = dataset->n_rows;
+  const size_t levels = MortonLevels(dims);
+  if (level == levels)
+  {
+    if (oldFromNew)
+      SplitNode(center, width, *oldFromNew, maxLeafSize);
+    else
+      SplitNode(center, width, maxLeafSize);
+    return;
+  }
+
+  // The codes of the points in this node share the digits of all the previous
+  // levels, so the points of each child are contiguous, and empty children
+  // are skipped.
+  const size_t shift = (levels - 1 - level) * dims;
+  const uint64_t mask = ((uint64_t) 1 << dims) - 1;
+  std::vector<size_t> childIndices, childBegins, childCounts;
+  for (size_t i = begin; i < begin + count; )
+  {
+    const uint64_t childIndex = (codes[i] >> shift) & mask;
+    const size_t end = std::partition_point(codes.begin() + i,
+        codes.begin() + begin + count, [&](const uint64_t code)
+        {
+          return ((code >> shift) & mask) == childIndex;
+        }) - codes.begin();
+
+    childIndices.push_back(childIndex);
+    childBegins.push_back(i);
+    childCounts.push_back(end - i);
+    i = end;
+  }
+
+  // The children hold disjoint ranges of the dataset (and of oldFromNew), so
+  // they can be built at the same time.  Small children are not worth the
+  // overhead of a task.
+  children.resize(childIndices.size(), NULL);
+  const double childWidth = width / 2.0;
+  auto buildChildren = [&]()
+  {
+    for (size_t c = 0; c < childIndices.size(); ++c)
+    {
+      #pragma omp task if (childCounts[c] >= ParallelBuildCutoff) \
+          default(shared) firstprivate(c)
+      {
+        // Create the correct center.
+        arma::Col<ElemType> childCenter(center.n_elem);
+        for (size_t d = 0; d < center.n_elem; ++d)
+        {
+          // Is the dimension "right" (1) or "left" (0)?
+          if (((childIndices[c] >> d) & 1) == 0)
+            childCenter[d] = center[d] - childWidth;
+          else
+            childCenter[d] = center[d] + childWidth;
+        }
+
+        children[c] = new Octree(this, childBegins[c], childCounts[c],
+            childCenter, childWidth, codes, level + 1, oldFromNew,
+            maxLeafSize);
+      }
+    }
+
+    #pragma omp taskwait
+  };
+
+  #ifdef MLPACK_USE_OPENMP
+  // Only the outermost call needs to create the threads that the tasks for
+  // each child run on; recursive calls are already inside of that region.
+  if (count >= ParallelBuildCutoff && !omp_in_parallel() &&
+      NumThreads() > 1)
+  {
+    #pragma omp parallel num_threads((int) NumThreads())
+    {
+      #pragma omp single
+      buildChildren();
+    }
+  }
+  else
+  {
+    buildChildren();
+  }
+  #else
+  buildChildren();
+  #endif
+}
+
+//! Sort the Morton codes.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::RadixSort(
+    std::vector<uint64_t>& codes,
+    const size_t bits,
+    std::vector<size_t>& order)
+{
+  const size_t n = codes.size();
+  order.resize(n);
+  for (size_t i = 0; i < n; ++i)
+    order[i] = i;
+
+  // Sort by one byte at a time, from the lowest; each pass is stable.
+  std::vector<uint64_t> sortedCodes(n);
+  std::vector<size_t> sortedOrder(n);
+  for (size_t shift = 0; shift < bits; shift += 8)
+  {
+    std::vector<size_t> offsets(257, 0);
+    for (size_t i = 0; i < n; ++i)
+      ++offsets[((codes[i] >> shift) & 0xFF) + 1];
+
+    // If every code has the same byte, this pass would change nothing.
+    if (std::find(offsets.begin(), offsets.end(), n) != offsets.end())
+      continue;
+
+    for (size_t b = 1; b < 257; ++b)
+      offsets[b] += offsets[b - 1];
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      const size_t j = offsets[(codes[i] >> shift) & 0xFF]++;
+      sortedCodes[j] = codes[i];
+      sortedOrder[j] = order[i];
+    }
+
+    codes.swap(sortedCodes);
+    order.swap(sortedOrder);
+  }
+}
+
 //! Split the node.
 template<typename MetricType, typename StatisticType, typename MatType>
 void Octree<MetricType, StatisticType, MatType>::SplitNode(
-    const arma::vec& center,
+    const arma::Col<ElemType>& center,
     const double width,
     const size_t maxLeafSize)
 {
@@ -846,7 +1115,7 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   }
 
   // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
+  arma::Col<ElemType> childCenter(center.n_elem);
   const double childWidth = width / 2.0;
   for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
   {
@@ -873,7 +1142,7 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
 //! Split the node, and store mappings.
 template<typename MetricType, typename StatisticType, typename MatType>
 void Octree<MetricType, StatisticType, MatType>::SplitNode(
-    const arma::vec& center,
+    const arma::Col<ElemType>& center,
     const double width,
     std::vector<size_t>& oldFromNew,
     const size_t maxLeafSize)
@@ -948,7 +1217,7 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   }
 
   // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
+  arma::Col<ElemType> childCenter(center.n_elem);
   const double childWidth = width / 2.0;
   for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
   {
@@ -0,0 +1,189 @@
+/**
+ * @file core/tree/parallel_dual_tree_traversal.hpp
+ *
+ * Functions that split a dual-tree traversal into independent traversals of
+ * disjoint query subtrees, and run those traversals in parallel as OpenMP
+ * tasks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSAL_HPP
+#define MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSAL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
+
+#ifdef MLPACK_USE_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+
+/**
+ * Return the number of tasks that work on the given number of points should be
+ * split into so that it can be done in parallel.  This is a few tasks per
+ * thread, so that the work stays balanced even when some tasks are much more
+ * expensive than others.  It is 1 when OpenMP is not available, when only one
+ * thread is available, or when this is called from inside a parallel region.
+ *
+ * @param numPoints Number of points the work is done on.
+ */
+inline size_t NumParallelTasks(const size_t numPoints)
+{
+#ifdef MLPACK_USE_OPENMP
+  const size_t numThreads = NumThreads();
+  if (numThreads <= 1)
+    return 1;
+
+  return std::max(std::min(numPoints, 4 * numThreads), (size_t) 1);
+#else
+  (void) numPoints;
+  return 1;
+#endif
+}
+
+/**
+ * Split the given query tree into at most `maxSubtrees` disjoint subtrees, by
+ * repeatedly replacing the largest non-leaf subtree with its children.  Every
+ * descendant point of the query tree is a descendant of exactly one of the
+ * subtrees, and for trees that rearrange the dataset, the descendants of each
+ * subtree are a contiguous range of points.  The subtrees are returned from
+ * largest to smallest.
+ *
+ * @param queryTree Tree to split.
+ * @param maxSubtrees Maximum number of subtrees to split the tree into.
+ */
+template<typename TreeType>
+std::vector<TreeType*> SplitQueryTree(TreeType& queryTree,
+                                      const size_t maxSubtrees)
+{
+  std::vector<TreeType*> subtrees(1, &queryTree);
+  while (subtrees.size() < maxSubtrees)
+  {
+    size_t largest = subtrees.size();
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      if (!subtrees[i]->IsLeaf() && (largest == subtrees.size() ||
+          subtrees[i]->NumDescendants() > subtrees[largest]->NumDescendants()))
+        largest = i;
+    }
+
+    // Stop if every subtree is a leaf, or if splitting the largest one would
+    // give too many subtrees.
+    if (largest == subtrees.size() || subtrees.size() +
+        subtrees[largest]->NumChildren() - 1 > maxSubtrees)
+      break;
+
+    TreeType* node = subtrees[largest];
+    subtrees[largest] = &node->Child(0);
+    for (size_t i = 1; i < node->NumChildren(); ++i)
+      subtrees.push_back(&node->Child(i));
+  }
+
+  std::stable_sort(subtrees.begin(), subtrees.end(),
+      [](const TreeType* a, const TreeType* b)
+      {
+        return a->NumDescendants() > b->NumDescendants();
+      });
+
+  return subtrees;
+}
+
+/**
+ * Call `search(queryNode)` for each of the given disjoint query subtrees, each
+ * as a separate OpenMP task, as in the overload below.  This is useful when
+ * the subtrees (as returned by SplitQueryTree()) must be prepared before the
+ * traversal, for instance to set the statistics of their ancestors, which are
+ * not visited by any of the traversals.
+ *
+ * @param subtrees Disjoint query subtrees to traverse.
+ * @param search Function that traverses one query subtree.
+ */
+template<typename TreeType, typename SearchType>
+void ParallelDualTreeTraversal(const std::vector<TreeType*>& subtrees,
+                               SearchType&& search)
+{
+  if (subtrees.size() == 1)
+  {
+    search(*subtrees[0]);
+    return;
+  }
+
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    #pragma omp single
+    {
+      for (size_t i = 0; i < subtrees.size(); ++i)
+      {
+        #pragma omp task firstprivate(i)
+        search(*subtrees[i]);
+      }
+    }
+  }
+}
+
+/**
+ * Run a dual-tree traversal of the given query tree in parallel.  The query
+ * tree is split with SplitQueryTree() into at most `numSubtrees` disjoint
+ * subtrees, and `search(queryNode)` is called once for each subtree, as a
+ * separate OpenMP task.  The tasks of the largest subtrees are created first;
+ * idle threads then take the remaining tasks from the task queues of the
+ * OpenMP runtime, which steals work between threads, so the load stays balanced
+ * even when the cost of the subtrees is very uneven.  If `numSubtrees` is 1
+ * (see NumParallelTasks()), `search(queryTree)` is simply called once.
+ *
+ * `search` must traverse the given query node against the reference tree with
+ * its own RuleType and traverser, because rules hold state (such as the
+ * TraversalInfo and the cached last base case) that can't be shared between
+ * threads.  It may be called from several threads at once, so anything it
+ * writes that isn't local to the task (such as total score counts) must be
+ * combined with a critical section or atomics.  For example:
+ *
+ * @code
+ * ParallelDualTreeTraversal(queryTree, NumParallelTasks(queryTree.Count()),
+ *     [&](TreeType& queryNode)
+ *     {
+ *       RuleType rules(...);
+ *       DualTreeTraverser<RuleType> traverser(rules);
+ *       traverser.Traverse(queryNode, referenceTree);
+ *
+ *       #pragma omp critical
+ *       totalScores += rules.Scores();
+ *     });
+ * @endcode
+ *
+ * This is only correct for rules whose results for a query point depend only
+ * on the query point, the query nodes holding it, and the (unmodified)
+ * reference tree.  Rules that keep global state across all query points (for
+ * instance the component bounds of the dual-tree Boruvka EMST) must update it
+ * with locks or atomics, as DTBRules does, and rules that write the statistics
+ * of reference nodes during the traversal can't be split this way.  The
+ * traversals of different subtrees also write the statistics of different
+ * query nodes, so the query tree should not share nodes with the reference
+ * tree unless the rules only read reference statistics that are never written.
+ *
+ * @param queryTree Query tree to traverse.
+ * @param numSubtrees Maximum number of subtrees to split the query tree into.
+ * @param search Function that traverses one query subtree.
+ */
+template<typename TreeType, typename SearchType>
+void ParallelDualTreeTraversal(TreeType& queryTree,
+                               const size_t numSubtrees,
+                               SearchType&& search)
+{
+  if (numSubtrees <= 1)
+  {
+    search(queryTree);
+    return;
+  }
+
+  ParallelDualTreeTraversal(SplitQueryTree(queryTree, numSubtrees),
+      std::forward<SearchType>(search));
+}
+
+} // namespace mlpack
+
+#endif
@@ -31,10 +31,12 @@ namespace mlpack {
  * @param splitInfo The information about the split.
  */
 template<typename MatType, typename SplitType>
-size_t PerformSplit(MatType& data,
-                    const size_t begin,
-                    const size_t count,
-                    const typename SplitType::SplitInfo& splitInfo)
+size_t PerformSplit(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const typename SplitType::SplitInfo& splitInfo,
+    const std::enable_if_t<!arma::is_SpMat<MatType>::value>* = 0)
 {
   // This method modifies the input dataset.  We loop both from the left and
   // right sides of the points contained in this node.
@@ -96,11 +98,13 @@ size_t PerformSplit(MatType& data,
  *    each new point.
  */
 template<typename MatType, typename SplitType>
-size_t PerformSplit(MatType& data,
-                    const size_t begin,
-                    const size_t count,
-                    const typename SplitType::SplitInfo& splitInfo,
-                    std::vector<size_t>& oldFromNew)
+size_t PerformSplit(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const typename SplitType::SplitInfo& splitInfo,
+    std::vector<size_t>& oldFromNew,
+    const std::enable_if_t<!arma::is_SpMat<MatType>::value>* = 0)
 {
   // This method modifies the input dataset.  We loop both from the left and
   // right sides of the points contained in this node.
@@ -150,6 +154,182 @@ size_t PerformSplit(MatType& data,
   return left;
 }
 
+/**
+ * Compute the order of the points of a node after the split, without moving
+ * them.  The same swaps as the dense PerformSplit() are made, but on the
+ * indices of the points only, so sparse and dense trees built on the same data
+ * are identical.  After the call, order[i] is the offset (from begin) of the
+ * point that belongs at column begin + i.
+ *
+ * @param data The dataset used by the binary space tree.
+ * @param begin Index of the starting point in the dataset that belongs to
+ *    this node.
+ * @param count Number of points in this node.
+ * @param splitInfo The information about the split.
+ * @param order Vector to store the new order of the points in.
+ * @param oldFromNew If not NULL, the old positions of the points are swapped
+ *    like the points.
+ * @return The first column of the right child.
+ */
+template<typename MatType, typename SplitType>
+size_t SplitOrder(const MatType& data,
+                  const size_t begin,
+                  const size_t count,
+                  const typename SplitType::SplitInfo& splitInfo,
+                  std::vector<size_t>& order,
+                  std::vector<size_t>* oldFromNew)
+{
+  // Each column is only read once.
+  std::vector<char> goesLeft(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    goesLeft[i] = SplitType::AssignToLeftNode(data.col(begin + i),
+        splitInfo);
+  }
+
+  order.resize(count);
+  for (size_t i = 0; i < count; ++i)
+    order[i] = i;
+
+  // The bounds are checked first here, so that no point outside of the node is
+  // looked at; the result is the same as for the dense PerformSplit().
+  auto isLeft = [&](const size_t col) { return goesLeft[order[col - begin]]; };
+
+  size_t left = begin;
+  size_t right = begin + count - 1;
+  while ((left <= right) && isLeft(left))
+    left++;
+  while ((left <= right) && (right > 0) && !isLeft(right))
+    right--;
+
+  // Shortcut for when all points are on the right.
+  if (left == right && right == 0)
+    return left;
+
+  while (left <= right)
+  {
+    std::swap(order[left - begin], order[right - begin]);
+    if (oldFromNew)
+      std::swap((*oldFromNew)[left], (*oldFromNew)[right]);
+
+    while ((left <= right) && isLeft(left))
+      left++;
+    while ((left <= right) && !isLeft(right))
+      right--;
+  }
+
+  Log::Assert(left == right + 1);
+  return left;
+}
+
+/**
+ * Reorder the columns begin to begin + order.size() - 1 of a sparse matrix, so
+ * that column begin + i holds the old column begin + order[i].  A sparse
+ * column swap has to shift all the nonzero elements stored after the columns,
+ * so instead the nonzero elements of the node are moved at once, which only
+ * takes time linear in the number of nonzero elements of the node.
+ *
+ * @param data The sparse dataset used by the binary space tree.
+ * @param begin Index of the first column to reorder.
+ * @param order New order of the columns.
+ */
+template<typename eT>
+void PermuteSparseColumns(arma::SpMat<eT>& data,
+                          const size_t begin,
+                          const std::vector<size_t>& order)
+{
+  data.sync();
+
+  const size_t count = order.size();
+  const size_t first = data.col_ptrs[begin];
+  const size_t nonzeros = data.col_ptrs[begin + count] - first;
+
+  std::vector<arma::uword> rowIndices(nonzeros);
+  std::vector<eT> values(nonzeros);
+  std::vector<arma::uword> colPtrs(count);
+  size_t pos = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    const size_t colBegin = data.col_ptrs[begin + order[i]];
+    const size_t colEnd = data.col_ptrs[begin + order[i] + 1];
+    std::copy(data.row_indices + colBegin, data.row_indices + colEnd,
+        rowIndices.begin() + pos);
+    std::copy(data.values + colBegin, data.values + colEnd,
+        values.begin() + pos);
+    colPtrs[i] = first + pos;
+    pos += colEnd - colBegin;
+  }
+
+  // The total number of nonzero elements of the node does not change, so the
+  // column pointers before and after the node stay valid.
+  std::copy(rowIndices.begin(), rowIndices.end(),
+      arma::access::rwp(data.row_indices) + first);
+  std::copy(values.begin(), values.end(),
+      arma::access::rwp(data.values) + first);
+  std::copy(colPtrs.begin(), colPtrs.end(),
+      arma::access::rwp(data.col_ptrs) + begin);
+
+  // Resizing to the same size only invalidates the element cache of the
+  // matrix, which does not hold the new order.
+  data.mem_resize(data.n_nonzero);
+}
+
+/**
+ * This function implements the default split behavior for sparse matrices.
+ * The points end up in the same order as with the dense PerformSplit(), but
+ * the columns are moved only once, with PermuteSparseColumns().
+ *
+ * @param data The sparse dataset used by the binary space tree.
+ * @param begin Index of the starting point in the dataset that belongs to
+ *    this node.
+ * @param count Number of points in this node.
+ * @param splitInfo The information about the split.
+ */
+template<typename MatType, typename SplitType>
+size_t PerformSplit(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const typename SplitType::SplitInfo& splitInfo,
+    const std::enable_if_t<arma::is_SpMat<MatType>::value>* = 0)
+{
+  std::vector<size_t> order;
+  const size_t splitCol = SplitOrder<MatType, SplitType>(data, begin, count,
+      splitInfo, order, NULL);
+  PermuteSparseColumns(data, begin, order);
+  return splitCol;
+}
+
+/**
+ * This function implements the default split behavior for sparse matrices,
+ * and returns the list of changed indices.  The points end up in the same
+ * order as with the dense PerformSplit(), but the columns are moved only once,
+ * with PermuteSparseColumns().
+ *
+ * @param data The sparse dataset used by the binary space tree.
+ * @param begin Index of the starting point in the dataset that belongs to
+ *    this node.
+ * @param count Number of points in this node.
+ * @param splitInfo The information about the split.
+ * @param oldFromNew Vector which will be filled with the old positions for
+ *    each new point.
+ */
+template<typename MatType, typename SplitType>
+size_t PerformSplit(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const typename SplitType::SplitInfo& splitInfo,
+    std::vector<size_t>& oldFromNew,
+    const std::enable_if_t<arma::is_SpMat<MatType>::value>* = 0)
+{
+  std::vector<size_t> order;
+  const size_t splitCol = SplitOrder<MatType, SplitType>(data, begin, count,
+      splitInfo, order, &oldFromNew);
+  PermuteSparseColumns(data, begin, order);
+  return splitCol;
+}
+
 } // namespace mlpack
 
 
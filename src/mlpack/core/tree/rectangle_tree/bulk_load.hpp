@@ -0,0 +1,83 @@
+/**
+ * @file core/tree/rectangle_tree/bulk_load.hpp
+ *
+ * Definitions used by the bulk-loading constructors of RectangleTree, which
+ * pack a whole dataset into a tree at once instead of inserting the points one
+ * by one.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * The packing that a bulk-loaded RectangleTree is built with.  Both packings
+ * fill every node to (nearly) its maximum size, and give a tree whose leaves
+ * are all at the same level, so that points can still be inserted into and
+ * deleted from it afterwards.
+ */
+enum class RectangleTreeBulkLoad
+{
+  /**
+   * Sort-Tile-Recursive packing: the points are sorted along the first
+   * dimension and cut into slabs, each slab is sorted along the second
+   * dimension and cut again, and so on, until each tile fills one leaf.  The
+   * levels above the leaves are built the same way from the centers of the
+   * nodes below.
+   *
+   * @code
+   * @inproceedings{leutenegger1997str,
+   *   title={{STR}: A simple and efficient algorithm for {R}-tree packing},
+   *   author={Leutenegger, S.T. and Lopez, M.A. and Edgington, J.},
+   *   booktitle={Proceedings of the 13th International Conference on Data
+   *       Engineering (ICDE '97)},
+   *   pages={497--506},
+   *   year={1997}
+   * }
+   * @endcode
+   */
+  STR,
+
+  /**
+   * Hilbert packing: the points are sorted by their (discrete) Hilbert
+   * values, and consecutive runs of points and then of nodes are packed into
+   * each node.
+   *
+   * @code
+   * @inproceedings{kamel1993packing,
+   *   title={On packing {R}-trees},
+   *   author={Kamel, I. and Faloutsos, C.},
+   *   booktitle={Proceedings of the Second International Conference on
+   *       Information and Knowledge Management (CIKM '93)},
+   *   pages={490--499},
+   *   year={1993}
+   * }
+   * @endcode
+   */
+  HILBERT
+};
+
+/**
+ * Whether a RectangleTree with the given auxiliary information can be bulk
+ * loaded.  Auxiliary information that can only be built by inserting points one
+ * at a time (such as the ordering of the Hilbert R tree) should specialize this
+ * to false.
+ *
+ * @tparam AuxiliaryInformationType The auxiliary information of the tree.
+ */
+template<typename AuxiliaryInformationType>
+struct RectangleTreeBulkLoadable
+{
+  static const bool value = true;
+};
+
+} // namespace mlpack
+
+#endif
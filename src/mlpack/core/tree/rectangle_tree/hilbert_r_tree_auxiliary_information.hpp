@@ -14,6 +14,8 @@
 #ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_HR_TREE_AUXILIARY_INFO_HPP
 #define MLPACK_CORE_TREE_RECTANGLE_TREE_HR_TREE_AUXILIARY_INFO_HPP
 
+#include "bulk_load.hpp"
+
 namespace mlpack {
 
 template<typename TreeType,
@@ -141,6 +143,19 @@ class HilbertRTreeAuxiliaryInformation
   void serialize(Archive& ar, const uint32_t /* version */);
 };
 
+/**
+ * The Hilbert values of the Hilbert R tree are stored in buffers that are
+ * shared between nodes as the tree grows, so the tree can only be built by
+ * inserting the points one at a time.
+ */
+template<typename TreeType,
+         template<typename> class HilbertValueType>
+struct RectangleTreeBulkLoadable<
+    HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>>
+{
+  static const bool value = false;
+};
+
 } // namespace mlpack
 
 #include "hilbert_r_tree_auxiliary_information_impl.hpp"
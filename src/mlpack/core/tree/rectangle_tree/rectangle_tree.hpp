@@ -20,6 +20,7 @@
 #include "r_tree_split.hpp"
 #include "r_tree_descent_heuristic.hpp"
 #include "no_auxiliary_information.hpp"
+#include "bulk_load.hpp"
 
 namespace mlpack {
 
@@ -155,6 +156,55 @@ class RectangleTree
                 const size_t minNumChildren = 2,
                 const size_t firstDataIndex = 0);
 
+  /**
+   * Construct this as the root node of a rectangle type tree by bulk loading
+   * the given dataset: instead of inserting the points one at a time, the
+   * points are packed into full leaves with the given packing (see
+   * RectangleTreeBulkLoad), and the leaves into full nodes, level by level.
+   * This is much faster than inserting the points, and usually gives tighter
+   * bounds; sorting and tiling is done in parallel when OpenMP is available.
+   * Points can still be inserted into and deleted from the tree afterwards.
+   *
+   * Bulk loading is not available for trees whose children must not overlap
+   * (the R+ and R++ trees) or for the Hilbert R tree.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param packing The packing to build the tree with.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(const MatType& data,
+                const RectangleTreeBulkLoad packing,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
+  /**
+   * Construct this as the root node of a rectangle type tree by bulk loading
+   * the given dataset, and taking ownership of the given dataset.  See the
+   * constructor above for details.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param packing The packing to build the tree with.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(MatType&& data,
+                const RectangleTreeBulkLoad packing,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
   /**
    * Construct this as an empty node with the specified parent.  Copying the
    * parameters (maxLeafSize, minLeafSize, maxNumChildren, minNumChildren,
@@ -311,9 +361,12 @@ class RectangleTree
   RectangleTree* FindByBeginCount(size_t begin, size_t count);
 
   //! Return the bound object for this node.
-  const HRectBound<MetricType>& Bound() const { return bound; }
+  const HRectBound<EuclideanDistance, ElemType>& Bound() const
+  {
+    return bound;
+  }
   //! Modify the bound object for this node.
-  HRectBound<MetricType>& Bound() { return bound; }
+  HRectBound<EuclideanDistance, ElemType>& Bound() { return bound; }
 
   //! Return the statistic object for this node.
   const StatisticType& Stat() const { return stat; }
@@ -364,7 +417,7 @@ class RectangleTree
   MetricType Metric() const { return MetricType(); }
 
   //! Get the centroid of the node and store it in the given vector.
-  void Center(arma::vec& center) { bound.Center(center); }
+  void Center(arma::Col<ElemType>& center) { bound.Center(center); }
 
   //! Return the number of child nodes.  (One level beneath this one only.)
   size_t NumChildren() const { return numChildren; }
@@ -563,6 +616,58 @@ class RectangleTree
    */
   void BuildStatistics(RectangleTree* node);
 
+  /**
+   * Build the tree on all points of the dataset with the given packing.  This
+   * must only be called on an empty root node.
+   *
+   * @param packing The packing to build the tree with.
+   */
+  void BulkLoad(const RectangleTreeBulkLoad packing);
+
+  /**
+   * Order the given points (or node centers) so that each of the given number
+   * of groups of consecutive points should be packed into one node, and
+   * compute the first index of each group.
+   *
+   * @param centers Points to pack, one per column.
+   * @param packing The packing to use.
+   * @param numGroups Number of groups to pack the points into.
+   * @param order Indices of the points; this is reordered.
+   * @param groupBegins Will be set to the index in order of the first point of
+   *      each group, followed by the number of points.
+   */
+  template<typename CentersType>
+  static void Pack(const CentersType& centers,
+                   const RectangleTreeBulkLoad packing,
+                   const size_t numGroups,
+                   std::vector<size_t>& order,
+                   std::vector<size_t>& groupBegins);
+
+  /**
+   * Sort-Tile-Recursive packing of the points order[begin] to order[end - 1]
+   * into the groups firstGroup to firstGroup + numGroups - 1, starting at the
+   * given dimension.
+   */
+  template<typename CentersType>
+  static void TileSTR(const CentersType& centers,
+                      std::vector<size_t>& order,
+                      const size_t begin,
+                      const size_t end,
+                      const size_t dim,
+                      const size_t firstGroup,
+                      const size_t numGroups,
+                      std::vector<size_t>& groupBegins);
+
+  /**
+   * Sort order[begin] to order[end - 1] with the given comparison, splitting
+   * the sort into OpenMP tasks when the range is large.
+   */
+  template<typename CompareType>
+  static void ParallelSort(std::vector<size_t>& order,
+                           const size_t begin,
+                           const size_t end,
+                           const CompareType& compare);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -598,7 +703,7 @@ class RectangleTree
    * @param relevels The levels that have been reinserted to on this top level
    *      insertion.
    */
-  void CondenseTree(const arma::vec& point,
+  void CondenseTree(const arma::Col<ElemType>& point,
                     std::vector<bool>& relevels,
                     const bool usePoint);
 
@@ -609,7 +714,7 @@ class RectangleTree
    *      shrinking.
    * @return true if the bound needed to be changed, false if it did not.
    */
-  bool ShrinkBoundForPoint(const arma::vec& point);
+  bool ShrinkBoundForPoint(const arma::Col<ElemType>& point);
 
   /**
    * Shrink the bound object of this node for the removal of a child node.
@@ -618,7 +723,8 @@ class RectangleTree
    *      shrinking.
    * @return true if the bound needed to be changed, false if it did not.
    */
-  bool ShrinkBoundForBound(const HRectBound<MetricType>& changedBound);
+  bool ShrinkBoundForBound(
+      const HRectBound<EuclideanDistance, ElemType>& changedBound);
 
   /**
    * Make an exact copy of this node, pointers and everything.
@@ -630,6 +736,12 @@ class RectangleTree
    */
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  #ifdef MLPACK_TRACK_MEMORY
+  //! Counts this node in MemoryTracker for as long as it exists.
+  MemoryTracker::NodeCounter nodeCounter { sizeof(RectangleTree) };
+  #endif
 };
 
 } // namespace mlpack
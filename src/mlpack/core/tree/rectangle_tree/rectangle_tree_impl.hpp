@@ -14,8 +14,12 @@
 
 // In case it wasn't included already for some reason.
 #include "rectangle_tree.hpp"
+#include "discrete_hilbert_value.hpp"
+#include "../tree_traits.hpp"
 
 #include <mlpack/core/util/log.hpp>
+#include <mlpack/core/util/executor.hpp>
+#include <numeric>
 
 namespace mlpack {
 
@@ -120,6 +124,327 @@ RectangleTree(MatType&& data,
   BuildStatistics(this);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const MatType& data,
+              const RectangleTreeBulkLoad packing,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad(packing);
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(MatType&& data,
+              const RectangleTreeBulkLoad packing,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad(packing);
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
+/**
+ * Pack all points of the dataset into full leaves, and then the nodes of each
+ * level into full nodes of the level above, until the nodes fit into the root.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+BulkLoad(const RectangleTreeBulkLoad packing)
+{
+  static_assert(TreeTraits<RectangleTree>::HasOverlappingChildren,
+      "RectangleTree: trees whose children must not overlap can't be bulk "
+      "loaded.");
+  static_assert(RectangleTreeBulkLoadable<AuxiliaryInformation>::value,
+      "RectangleTree: this type of tree can't be bulk loaded.");
+
+  const size_t numPoints = dataset->n_cols;
+  numDescendants = numPoints;
+
+  // If all points fit in one leaf, the root is that leaf.
+  if (numPoints <= maxLeafSize)
+  {
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      points[i] = i;
+      bound |= dataset->col(i);
+    }
+    count = numPoints;
+    return;
+  }
+
+  std::vector<size_t> order(numPoints);
+  std::iota(order.begin(), order.end(), 0);
+  std::vector<size_t> groupBegins;
+  size_t numGroups = (numPoints + maxLeafSize - 1) / maxLeafSize;
+  Pack(*dataset, packing, numGroups, order, groupBegins);
+
+  // The nodes are created as children of the root, so that they take their
+  // parameters from it; their parents are set when the level above is built.
+  std::vector<RectangleTree*> nodes(numGroups);
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t i = 0; i < numGroups; ++i)
+  {
+    RectangleTree* leaf = new RectangleTree(this);
+    for (size_t j = groupBegins[i]; j < groupBegins[i + 1]; ++j)
+    {
+      leaf->points[leaf->count++] = order[j];
+      leaf->bound |= dataset->col(order[j]);
+    }
+    leaf->numDescendants = leaf->count;
+    nodes[i] = leaf;
+  }
+
+  while (nodes.size() > maxNumChildren)
+  {
+    numGroups = (nodes.size() + maxNumChildren - 1) / maxNumChildren;
+    order.resize(nodes.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (packing == RectangleTreeBulkLoad::STR)
+    {
+      arma::Mat<ElemType> centers(bound.Dim(), nodes.size());
+      arma::Col<ElemType> center;
+      for (size_t i = 0; i < nodes.size(); ++i)
+      {
+        nodes[i]->bound.Center(center);
+        centers.col(i) = center;
+      }
+
+      Pack(centers, packing, numGroups, order, groupBegins);
+    }
+    else
+    {
+      // The nodes are already in the order of the Hilbert values of their
+      // points, so consecutive nodes are packed together.
+      groupBegins.resize(numGroups + 1);
+      for (size_t i = 0; i <= numGroups; ++i)
+        groupBegins[i] = (nodes.size() * i) / numGroups;
+    }
+
+    std::vector<RectangleTree*> parents(numGroups);
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t i = 0; i < numGroups; ++i)
+    {
+      RectangleTree* node = new RectangleTree(this);
+      for (size_t j = groupBegins[i]; j < groupBegins[i + 1]; ++j)
+      {
+        RectangleTree* child = nodes[order[j]];
+        node->children[node->numChildren++] = child;
+        child->parent = node;
+        node->bound |= child->bound;
+        node->numDescendants += child->numDescendants;
+      }
+      parents[i] = node;
+    }
+    nodes.swap(parents);
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    children[numChildren++] = nodes[i];
+    nodes[i]->parent = this;
+    bound |= nodes[i]->bound;
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename CentersType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+Pack(const CentersType& centers,
+     const RectangleTreeBulkLoad packing,
+     const size_t numGroups,
+     std::vector<size_t>& order,
+     std::vector<size_t>& groupBegins)
+{
+  groupBegins.resize(numGroups + 1);
+  groupBegins[numGroups] = order.size();
+
+  if (packing == RectangleTreeBulkLoad::STR)
+  {
+    #pragma omp parallel num_threads((int) NumThreads())
+    {
+      #pragma omp single
+      TileSTR(centers, order, 0, order.size(), 0, 0, numGroups, groupBegins);
+    }
+  }
+  else
+  {
+    typedef DiscreteHilbertValue<ElemType> HilbertValue;
+    std::vector<arma::Col<typename HilbertValue::HilbertElemType>> values(
+        centers.n_cols);
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t i = 0; i < (size_t) centers.n_cols; ++i)
+    {
+      values[i] = HilbertValue::CalculateValue(
+          arma::Col<ElemType>(centers.col(i)));
+    }
+
+    #pragma omp parallel num_threads((int) NumThreads())
+    {
+      #pragma omp single
+      ParallelSort(order, 0, order.size(),
+          [&values](const size_t a, const size_t b)
+          {
+            return HilbertValue::CompareValues(values[a], values[b]) < 0;
+          });
+    }
+
+    for (size_t i = 0; i < numGroups; ++i)
+      groupBegins[i] = (order.size() * i) / numGroups;
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename CentersType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+TileSTR(const CentersType& centers,
+        std::vector<size_t>& order,
+        const size_t begin,
+        const size_t end,
+        const size_t dim,
+        const size_t firstGroup,
+        const size_t numGroups,
+        std::vector<size_t>& groupBegins)
+{
+  if (numGroups == 1)
+  {
+    groupBegins[firstGroup] = begin;
+    return;
+  }
+
+  ParallelSort(order, begin, end,
+      [&centers, dim](const size_t a, const size_t b)
+      {
+        return centers(dim, a) < centers(dim, b);
+      });
+
+  // Cut the sorted points into slabs of whole groups, so that the tiles are
+  // roughly square: with d dimensions left, that is the (1 / d)-th power of
+  // the number of groups.  Along the last dimension, each slab is one group.
+  const size_t dimsLeft = centers.n_rows - dim;
+  const size_t numSlabs = (dimsLeft == 1) ? numGroups : std::min(numGroups,
+      (size_t) std::ceil(std::pow((double) numGroups, 1.0 / dimsLeft)));
+  const size_t count = end - begin;
+  for (size_t s = 0; s < numSlabs; ++s)
+  {
+    const size_t slabFirstGroup = (numGroups * s) / numSlabs;
+    const size_t slabNumGroups = (numGroups * (s + 1)) / numSlabs -
+        slabFirstGroup;
+    const size_t slabBegin = begin + (count * slabFirstGroup) / numGroups;
+    const size_t slabEnd = begin + (count * (slabFirstGroup + slabNumGroups)) /
+        numGroups;
+
+    #pragma omp task shared(centers, order, groupBegins) \
+        if (slabEnd - slabBegin > 1024)
+    TileSTR(centers, order, slabBegin, slabEnd, dim + 1,
+        firstGroup + slabFirstGroup, slabNumGroups, groupBegins);
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename CompareType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+ParallelSort(std::vector<size_t>& order,
+             const size_t begin,
+             const size_t end,
+             const CompareType& compare)
+{
+  if (end - begin <= 16384)
+  {
+    std::sort(order.begin() + begin, order.begin() + end, compare);
+    return;
+  }
+
+  // Sort both halves as separate tasks, and merge them.
+  const size_t middle = begin + (end - begin) / 2;
+  #pragma omp task shared(order, compare)
+  ParallelSort(order, begin, middle, compare);
+  #pragma omp task shared(order, compare)
+  ParallelSort(order, middle, end, compare);
+  #pragma omp taskwait
+
+  std::inplace_merge(order.begin() + begin, order.begin() + middle,
+      order.begin() + end, compare);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -696,7 +1021,7 @@ bool RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
         tree->numDescendants -= node->numDescendants;
         tree = tree->Parent();
       }
-      CondenseTree(arma::vec(), relevels, false);
+      CondenseTree(arma::Col<ElemType>(), relevels, false);
       return true;
     }
 
@@ -1073,7 +1398,7 @@ template<typename MetricType,
          template<typename> class AuxiliaryInformationType>
 void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
                    AuxiliaryInformationType>::
-    CondenseTree(const arma::vec& point,
+    CondenseTree(const arma::Col<ElemType>& point,
                  std::vector<bool>& relevels,
                  const bool usePoint)
 {
@@ -1257,7 +1582,7 @@ template<typename MetricType,
          template<typename> class AuxiliaryInformationType>
 bool RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
                    AuxiliaryInformationType>::
-    ShrinkBoundForPoint(const arma::vec& point)
+    ShrinkBoundForPoint(const arma::Col<ElemType>& point)
 {
   bool shrunk = false;
   if (IsLeaf())
@@ -1355,7 +1680,8 @@ template<typename MetricType,
          template<typename> class AuxiliaryInformationType>
 bool RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
                    AuxiliaryInformationType>::
-    ShrinkBoundForBound(const HRectBound<MetricType>& /* b */)
+    ShrinkBoundForBound(
+        const HRectBound<EuclideanDistance, ElemType>& /* b */)
 {
   // Using the sum is safe since none of the dimensions can increase.
   ElemType sum = 0;
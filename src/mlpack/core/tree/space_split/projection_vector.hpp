@@ -67,9 +67,9 @@ class AxisParallelProjVector
    * @param bound Bound to be projected.
    * @return Range of projected values.
    */
-  template<typename MetricType, typename VecType>
-  RangeType<typename VecType::elem_type> Project(
-      const BallBound<MetricType, VecType>& bound) const
+  template<typename MetricType, typename ElemType, typename VecType>
+  RangeType<ElemType> Project(
+      const BallBound<MetricType, ElemType, VecType>& bound) const
   {
     return bound[dim];
   }
@@ -102,12 +102,17 @@ class ProjVector
   {};
 
   /**
-   * Create the projection vector based on the specified vector.
+   * Create the projection vector based on the specified vector.  The
+   * projection vector is always held in double precision, so that projections
+   * of single-precision points do not lose accuracy.
    *
    * @param vect Vector to be considered.
    */
-  ProjVector(const arma::vec& vect) :
-      projVect(normalise(vect))
+  template<typename VecType>
+  ProjVector(const VecType& vect,
+             typename std::enable_if_t<
+                 arma::is_arma_type<VecType>::value>* = 0) :
+      projVect(normalise(arma::conv_to<arma::vec>::from(vect)))
   {};
 
   /**
@@ -128,11 +133,10 @@ class ProjVector
    * @param bound Bound to be projected.
    * @return Range of projected values.
    */
-  template<typename MetricType, typename VecType>
-  RangeType<typename VecType::elem_type> Project(
-      const BallBound<MetricType, VecType>& bound) const
+  template<typename MetricType, typename ElemType, typename VecType>
+  RangeType<ElemType> Project(
+      const BallBound<MetricType, ElemType, VecType>& bound) const
   {
-    typedef typename VecType::elem_type ElemType;
     const double center = Project(bound.Center());
     const ElemType radius = bound.Radius();
     return RangeType<ElemType>(center - radius, center + radius);
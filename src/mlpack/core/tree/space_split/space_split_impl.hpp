@@ -94,7 +94,8 @@ bool SpaceSplit<MetricType, MatType>::GetProjVector(
   // Calculate the normalized projection vector.
   projVector = ProjVector(data.col(snd) - data.col(fst));
 
-  arma::vec midPoint = (data.col(snd) + data.col(fst)) / 2;
+  const arma::Col<typename MatType::elem_type> midPoint =
+      (data.col(snd) + data.col(fst)) / 2;
 
   midValue = projVector.Project(midPoint);
 
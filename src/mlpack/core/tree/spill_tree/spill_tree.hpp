@@ -35,6 +35,18 @@ namespace mlpack {
  * from it.  If you need to add or delete a node, the better procedure is to
  * rebuild the tree entirely.
  *
+ * The points of the overlapping buffer are not copied into each child: an
+ * overlapping node keeps the indexes of its points arranged so that those of
+ * the left child come first and those of the right child come last, with the
+ * overlapping buffer in between, and each child holds a view of its part.
+ * Leaves below an overlapping node also use these views, so the indexes of an
+ * overlapping node and of its leaves are stored once.  Nodes built by copying
+ * or loading a tree own their indexes.
+ *
+ * If mlpack is compiled with OpenMP, the tree is built in parallel: every node
+ * with more than ParallelBuildCutoff points builds its left child in a separate
+ * OpenMP task.  The resulting tree does not depend on the number of threads.
+ *
  * Three runtime parameters are required in the constructor:
  *  - maxLeafSize: Max leaf size to be used.
  *  - tau: Overlapping size.
@@ -79,6 +91,10 @@ class SpillTree
   //! The bound type.
   typedef typename HyperplaneType<MetricType>::BoundType BoundType;
 
+  //! Nodes with at least this many points build their children in parallel
+  //! (when OpenMP is available).
+  static constexpr size_t ParallelBuildCutoff = 4096;
+
  private:
   //! The left child node.
   SpillTree* left;
@@ -90,7 +106,8 @@ class SpillTree
   //! children).
   size_t count;
   //! The list of indexes of points contained in this node (non-NULL if the node
-  //! is a leaf or if overlappingNode is true).
+  //! is a leaf or if overlappingNode is true).  The leaves of an overlapping
+  //! node hold views of the indexes of their parent.
   arma::Col<size_t>* pointsIndex;
   //! Flag to distinguish overlapping nodes from non-overlapping nodes.
   bool overlappingNode;
@@ -451,20 +468,64 @@ class SpillTree
                  const double rho);
 
   /**
-   * Split the list of points.
+   * Split the list of points.  The points are arranged in splitPoints so that
+   * the points of the left child come first and the points of the right child
+   * come last.  If the overlapping buffer is included, its points are held by
+   * both children and lie in between, so rightBegin is less than leftCount.
    *
    * @param tau Overlapping size.
    * @param rho Balance threshold.
    * @param points Vector of indexes of points to be included.
-   * @param leftPoints Indexes of points to be included in left child.
-   * @param rightPoints Indexes of points to be included in right child.
+   * @param splitPoints Indexes of the points of both children.
+   * @param leftCount Number of points included in the left child (the first
+   *     ones of splitPoints).
+   * @param rightBegin Index in splitPoints of the first point included in the
+   *     right child.
    * @return Flag to know if the overlapping buffer was included.
    */
   bool SplitPoints(const double tau,
                    const double rho,
                    const arma::Col<size_t>& points,
-                   arma::Col<size_t>& leftPoints,
-                   arma::Col<size_t>& rightPoints);
+                   arma::Col<size_t>& splitPoints,
+                   size_t& leftCount,
+                   size_t& rightBegin);
+
+  /**
+   * Construct the left and right children of this node, given the indexes of
+   * their points.  If OpenMP is available, the left child is built in a
+   * separate task; if this is the root of the tree, the parallel region for all
+   * tasks is opened here.
+   *
+   * @param leftPoints Indexes of points to be included in left child.
+   * @param rightPoints Indexes of points to be included in right child.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param tau Overlapping size.
+   * @param rho Balance threshold.
+   */
+  void SplitChildren(arma::Col<size_t>& leftPoints,
+                     arma::Col<size_t>& rightPoints,
+                     const size_t maxLeafSize,
+                     const double tau,
+                     const double rho);
+
+  /**
+   * Construct the children of this node; called by SplitChildren(), possibly
+   * from inside of a parallel region.
+   */
+  void BuildChildren(arma::Col<size_t>& leftPoints,
+                     arma::Col<size_t>& rightPoints,
+                     const size_t maxLeafSize,
+                     const double tau,
+                     const double rho);
+
+  /**
+   * Keep the given indexes as the points of this leaf.  They are taken over if
+   * they are owned, kept as a view if they belong to an overlapping parent, and
+   * copied otherwise.
+   *
+   * @param points Vector of indexes of points held in this leaf.
+   */
+  void StorePoints(arma::Col<size_t>& points);
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -483,6 +544,12 @@ class SpillTree
    */
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t version);
+
+ private:
+  #ifdef MLPACK_TRACK_MEMORY
+  //! Counts this node in MemoryTracker for as long as it exists.
+  MemoryTracker::NodeCounter nodeCounter { sizeof(SpillTree) };
+  #endif
 };
 
 } // namespace mlpack
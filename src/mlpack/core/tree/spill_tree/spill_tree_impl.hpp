@@ -13,6 +13,7 @@
 
 // In case it wasn't included already for some reason.
 #include "spill_tree.hpp"
+#include <mlpack/core/util/executor.hpp>
 
 #include <queue>
 
@@ -731,8 +732,7 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   // Now, check if we need to split at all.
   if (points.n_elem <= maxLeafSize)
   {
-    pointsIndex = new arma::Col<size_t>();
-    pointsIndex->swap(points);
+    StorePoints(points);
     return; // We can't split this.
   }
 
@@ -742,32 +742,70 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   // same, we can't split them.
   if (!split)
   {
-    pointsIndex = new arma::Col<size_t>();
-    pointsIndex->swap(points);
+    StorePoints(points);
     return; // We can't split this.
   }
 
-  arma::Col<size_t> leftPoints, rightPoints;
-  // Split the node.
-  overlappingNode = SplitPoints(tau, rho, points, leftPoints, rightPoints);
+  // Split the node.  The children get views of the arranged points, so the
+  // points of the overlapping buffer are not copied.
+  arma::Col<size_t>* splitPoints = new arma::Col<size_t>();
+  size_t leftCount, rightBegin;
+  overlappingNode = SplitPoints(tau, rho, points, *splitPoints, leftCount,
+      rightBegin);
 
+  // We don't need the information in points anymore, so let's clean it (if it
+  // is not a view of the points of the parent).
+  if (points.mem_state == 0)
+    arma::Col<size_t>().swap(points);
+
+  // Now we will recursively split the children by calling their constructors
+  // (which perform this splitting process).
+  arma::Col<size_t> leftPoints(splitPoints->memptr(), leftCount, false, true);
+  arma::Col<size_t> rightPoints(splitPoints->memptr() + rightBegin,
+      splitPoints->n_elem - rightBegin, false, true);
+  SplitChildren(leftPoints, rightPoints, maxLeafSize, tau, rho);
+
+  // If the node is overlapping, we have to keep track of which points are held
+  // in the node; its leaves keep using the same memory.  Otherwise every child
+  // has made its own copy of the points it needs.
   if (overlappingNode)
+    pointsIndex = splitPoints;
+  else
+    delete splitPoints;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    SplitChildren(arma::Col<size_t>& leftPoints,
+                  arma::Col<size_t>& rightPoints,
+                  const size_t maxLeafSize,
+                  const double tau,
+                  const double rho)
+{
+  #ifdef MLPACK_USE_OPENMP
+  // Only the outermost call needs to create the threads that the tasks for
+  // each child run on; recursive calls are already inside of that region.
+  if (leftPoints.n_elem + rightPoints.n_elem >= ParallelBuildCutoff &&
+      !omp_in_parallel() && NumThreads() > 1)
   {
-    // If the node is overlapping, we have to keep track of which points are
-    // held in the node.
-    pointsIndex = new arma::Col<size_t>();
-    pointsIndex->swap(points);
+    #pragma omp parallel num_threads((int) NumThreads())
+    {
+      #pragma omp single
+      BuildChildren(leftPoints, rightPoints, maxLeafSize, tau, rho);
+    }
   }
   else
   {
-    // Otherwise, we don't need the information in points, so let's clean it.
-    arma::Col<size_t>().swap(points);
+    BuildChildren(leftPoints, rightPoints, maxLeafSize, tau, rho);
   }
-
-  // Now we will recursively split the children by calling their constructors
-  // (which perform this splitting process).
-  left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
-  right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+  #else
+  BuildChildren(leftPoints, rightPoints, maxLeafSize, tau, rho);
+  #endif
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -783,6 +821,57 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    BuildChildren(arma::Col<size_t>& leftPoints,
+                  arma::Col<size_t>& rightPoints,
+                  const size_t maxLeafSize,
+                  const double tau,
+                  const double rho)
+{
+  // The children only read the points given to them (and the points of the
+  // overlapping buffer are only read by both), so they can be built at the
+  // same time.  Small children are not worth the overhead of a task.
+  #pragma omp task if (leftPoints.n_elem >= ParallelBuildCutoff) \
+      default(shared)
+  left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
+
+  right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+
+  #pragma omp taskwait
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    StorePoints(arma::Col<size_t>& points)
+{
+  if (points.mem_state == 0)
+  {
+    pointsIndex = new arma::Col<size_t>();
+    pointsIndex->swap(points);
+  }
+  else if (parent != NULL && parent->overlappingNode)
+  {
+    // The parent keeps the memory of the view for as long as this node lives.
+    pointsIndex = new arma::Col<size_t>(points.memptr(), points.n_elem, false,
+        true);
+  }
+  else
+  {
+    pointsIndex = new arma::Col<size_t>(points);
+  }
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -793,8 +882,9 @@ bool SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     SplitPoints(const double tau,
                 const double rho,
                 const arma::Col<size_t>& points,
-                arma::Col<size_t>& leftPoints,
-                arma::Col<size_t>& rightPoints)
+                arma::Col<size_t>& splitPoints,
+                size_t& leftCount,
+                size_t& rightBegin)
 {
   arma::vec projections(points.n_elem);
   size_t left = 0, right = 0, leftFrontier = 0, rightFrontier = 0;
@@ -821,49 +911,49 @@ bool SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   const double p1 = (double) (left + rightFrontier) / points.n_elem;
   const double p2 = (double) (right + leftFrontier) / points.n_elem;
 
+  splitPoints.set_size(points.n_elem);
   if ((p1 <= rho || rightFrontier == 0) &&
       (p2 <= rho || leftFrontier == 0))
   {
     // Perform the actual splitting considering the overlapping buffer.  Points
     // with projection value in the range (-tau, tau) are included in both,
-    // leftPoints and rightPoints.
-    const size_t leftUnique = points.n_elem - right - leftFrontier;
+    // the left and the right child, so we put them between the points that are
+    // only included in the left child and the points that are only included in
+    // the right child.
+    const size_t leftUnique = left - leftFrontier;
     const size_t overlap = leftFrontier + rightFrontier;
 
-    leftPoints.resize(left + rightFrontier);
-    rightPoints.resize(right + leftFrontier);
-    for (size_t i = 0, rc = overlap, lc = 0, rf = 0, lf = leftUnique;
+    for (size_t i = 0, lc = 0, oc = leftUnique, rc = leftUnique + overlap;
          i < points.n_elem; ++i)
     {
-      // We put any points in the frontier should come last in the left node,
-      // and first in the right node.  (This ordering is not required.)
-      if (projections[i] < -tau)
-        leftPoints[lc++] = points[i];
+      if (projections[i] <= -tau)
+        splitPoints[lc++] = points[i];
       else if (projections[i] < tau)
-        leftPoints[lf++] = points[i];
-
-      if (projections[i] > tau)
-        rightPoints[rc++] = points[i];
-      else if (projections[i] > -tau)
-        rightPoints[rf++] = points[i];
+        splitPoints[oc++] = points[i];
+      else
+        splitPoints[rc++] = points[i];
     }
+
+    leftCount = left + rightFrontier;
+    rightBegin = leftUnique;
     // Return true, because it is a overlapping node.
     return true;
   }
 
   // Perform the actual splitting ignoring the overlapping buffer.  Points
-  // with projection value less than or equal to zero are included in leftPoints
-  // and points with projection value greater than zero are included in
-  // rightPoints.
-  leftPoints.resize(left);
-  rightPoints.resize(right);
-  for (size_t i = 0, rc = 0, lc = 0; i < points.n_elem; ++i)
+  // with projection value less than or equal to zero are included in the left
+  // child and points with projection value greater than zero are included in
+  // the right child.
+  for (size_t i = 0, lc = 0, rc = left; i < points.n_elem; ++i)
   {
     if (projections[i] <= 0)
-      leftPoints[lc++] = points[i];
+      splitPoints[lc++] = points[i];
     else
-      rightPoints[rc++] = points[i];
+      splitPoints[rc++] = points[i];
   }
+
+  leftCount = left;
+  rightBegin = left;
   // Return false, because it isn't a overlapping node.
   return false;
 }
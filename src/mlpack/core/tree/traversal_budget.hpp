@@ -0,0 +1,188 @@
+/**
+ * @file core/tree/traversal_budget.hpp
+ *
+ * The TraversalBudget class limits the amount of work that a tree traversal may
+ * do, so that tree-based algorithms can return approximate results within a
+ * given number of base cases, node combinations, or a wall-clock deadline.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TRAVERSAL_BUDGET_HPP
+#define MLPACK_CORE_TREE_TRAVERSAL_BUDGET_HPP
+
+#include <atomic>
+#include <chrono>
+
+namespace mlpack {
+
+/**
+ * The TraversalBudget class holds limits on the work done by a (single-tree or
+ * dual-tree) traversal: a maximum number of base cases, a maximum number of
+ * node combinations scored, and a maximum wall-clock time.  A limit of 0 means
+ * that there is no limit.  Because every traverser asks the rules for a score
+ * before it recurses into a node combination, a RuleType class enforces the
+ * budget by reporting its work with Add() in Score(), and by pruning every
+ * node combination once Prune() returns true.  The traversal then finishes
+ * quickly and the rules hold the best results found so far.
+ *
+ * After the traversal, Truncated() reports whether any node combination was
+ * pruned because of the budget; if not, the results are exact (up to the
+ * approximation already requested from the algorithm, e.g. epsilon).
+ *
+ * The counters are atomic, so one budget can be shared by rules that run in
+ * parallel.  The limits are then enforced on the total work of all threads.
+ * The budget is checked between node combinations, so the actual work can
+ * exceed the limits by the base cases of about one leaf combination per
+ * thread.
+ */
+class TraversalBudget
+{
+ public:
+  /**
+   * Create the budget with the given limits.  A limit of 0 means no limit.
+   *
+   * @param maxBaseCases Maximum number of base cases.
+   * @param maxScores Maximum number of node combinations to score.
+   * @param maxTime Maximum wall-clock time, in seconds.
+   */
+  TraversalBudget(const size_t maxBaseCases = 0,
+                  const size_t maxScores = 0,
+                  const double maxTime = 0.0) :
+      maxBaseCases(maxBaseCases),
+      maxScores(maxScores),
+      maxTime(maxTime)
+  {
+    Start();
+  }
+
+  //! Copy the limits of the given budget; the counters are reset.
+  TraversalBudget(const TraversalBudget& other) :
+      TraversalBudget(other.maxBaseCases, other.maxScores, other.maxTime)
+  {
+    // Nothing to do.
+  }
+
+  //! Copy the limits of the given budget; the counters are reset.
+  TraversalBudget& operator=(const TraversalBudget& other)
+  {
+    if (this != &other)
+    {
+      maxBaseCases = other.maxBaseCases;
+      maxScores = other.maxScores;
+      maxTime = other.maxTime;
+      Start();
+    }
+
+    return *this;
+  }
+
+  /**
+   * Reset the counters and start the clock.  This should be called before each
+   * traversal (or set of parallel traversals) that shares the budget.
+   */
+  void Start()
+  {
+    baseCases = 0;
+    scores = 0;
+    calls = 0;
+    exhausted = false;
+    truncated = false;
+    deadline = std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(maxTime));
+  }
+
+  /**
+   * Record the given amount of work.  If this exceeds one of the limits, the
+   * budget is exhausted.  The clock is only checked every 16 calls.
+   *
+   * @param newBaseCases Number of base cases done since the last call.
+   * @param newScores Number of node combinations scored since the last call.
+   */
+  void Add(const size_t newBaseCases, const size_t newScores)
+  {
+    if (!Limited() || exhausted.load(std::memory_order_relaxed))
+      return;
+
+    const size_t totalBaseCases = (baseCases += newBaseCases);
+    const size_t totalScores = (scores += newScores);
+    if ((maxBaseCases > 0 && totalBaseCases >= maxBaseCases) ||
+        (maxScores > 0 && totalScores >= maxScores) ||
+        (maxTime > 0.0 && (calls++ % 16) == 0 &&
+         std::chrono::steady_clock::now() >= deadline))
+    {
+      exhausted = true;
+    }
+  }
+
+  /**
+   * Return whether the traversal should prune the current node combination
+   * because the budget is exhausted.  If so, the results are marked as
+   * truncated.
+   */
+  bool Prune()
+  {
+    if (!exhausted.load(std::memory_order_relaxed))
+      return false;
+
+    truncated = true;
+    return true;
+  }
+
+  //! Return whether any limit is set.
+  bool Limited() const
+  { return maxBaseCases > 0 || maxScores > 0 || maxTime > 0.0; }
+  //! Return whether the budget has run out.
+  bool Exhausted() const { return exhausted; }
+  //! Return whether any work was skipped because the budget ran out.
+  bool Truncated() const { return truncated; }
+
+  //! Get the number of base cases recorded since Start().
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of node combinations scored since Start().
+  size_t Scores() const { return scores; }
+
+  //! Get the maximum number of base cases (0 means no limit).
+  size_t MaxBaseCases() const { return maxBaseCases; }
+  //! Modify the maximum number of base cases (0 means no limit).
+  size_t& MaxBaseCases() { return maxBaseCases; }
+
+  //! Get the maximum number of node combinations to score (0 means no limit).
+  size_t MaxScores() const { return maxScores; }
+  //! Modify the maximum number of node combinations to score (0 means no
+  //! limit).
+  size_t& MaxScores() { return maxScores; }
+
+  //! Get the maximum wall-clock time in seconds (0 means no limit).
+  double MaxTime() const { return maxTime; }
+  //! Modify the maximum wall-clock time in seconds (0 means no limit).
+  double& MaxTime() { return maxTime; }
+
+ private:
+  //! The maximum number of base cases.
+  size_t maxBaseCases;
+  //! The maximum number of node combinations to score.
+  size_t maxScores;
+  //! The maximum wall-clock time, in seconds.
+  double maxTime;
+
+  //! The number of base cases recorded.
+  std::atomic<size_t> baseCases;
+  //! The number of node combinations scored.
+  std::atomic<size_t> scores;
+  //! The number of calls to Add(), used to check the clock only sometimes.
+  std::atomic<size_t> calls;
+  //! Whether the budget has run out.
+  std::atomic<bool> exhausted;
+  //! Whether any node combination was pruned because of the budget.
+  std::atomic<bool> truncated;
+  //! The time at which the budget runs out, if maxTime is set.
+  std::chrono::steady_clock::time_point deadline;
+};
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,254 @@
+/**
+ * @file core/tree/traversal_statistics.hpp
+ *
+ * The TraversalStatistics class collects statistics of the node combinations
+ * that a tree traversal visits, prunes and recurses into, so that the cause of
+ * a slow search (overlapping bounds, a poor leaf size, or a poor metric) can be
+ * diagnosed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+#define MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <chrono>
+
+namespace mlpack {
+
+/**
+ * The TraversalStatistics class holds counters of the work done by tree
+ * traversals, for each level of the reference tree (the root is level 0):
+ *
+ *  - the number of node combinations scored (i.e. visited),
+ *  - the number of those that were pruned by Score(),
+ *  - the number of those that were rescored, and how many of those were pruned
+ *    by Rescore() because the bound had tightened since they were scored,
+ *  - the number of leaf combinations that were recursed into, and the number
+ *    of base cases done at that level,
+ *
+ * along with the total time spent in Score() and BaseCase().  The number of
+ * node combinations recursed into at a level is the number scored minus the
+ * number pruned by either Score() or Rescore().
+ *
+ * Statistics are only collected when Enabled() is true; the InstrumentedRules
+ * class records them for any RuleType class.  One TraversalStatistics object
+ * must not be shared by traversals that run in parallel: each should collect
+ * its own, and the results can then be combined with Merge().
+ */
+class TraversalStatistics
+{
+ public:
+  //! The statistics of one level of the reference tree.
+  struct Level
+  {
+    //! The number of node combinations scored.
+    size_t scores = 0;
+    //! The number of node combinations pruned by Score().
+    size_t prunes = 0;
+    //! The number of node combinations rescored.
+    size_t rescores = 0;
+    //! The number of node combinations pruned by Rescore().
+    size_t rescorePrunes = 0;
+    //! The number of leaf combinations that were not pruned by Score().
+    size_t leafPairs = 0;
+    //! The number of base cases.
+    size_t baseCases = 0;
+  };
+
+  /**
+   * Create an empty set of statistics.
+   *
+   * @param enabled Whether statistics should be collected.
+   */
+  TraversalStatistics(const bool enabled = false) :
+      enabled(enabled),
+      scoreTime(0.0),
+      baseCaseTime(0.0)
+  {
+    // Nothing to do.
+  }
+
+  //! Remove all collected statistics.
+  void Reset()
+  {
+    levels.clear();
+    scoreTime = 0.0;
+    baseCaseTime = 0.0;
+  }
+
+  /**
+   * Record a call to Score().
+   *
+   * @param level Level of the reference node.
+   * @param pruned Whether the node combination was pruned.
+   * @param leafPair Whether the node combination was a combination of leaves.
+   * @param seconds Time spent in Score().
+   */
+  void AddScore(const size_t level,
+                const bool pruned,
+                const bool leafPair,
+                const double seconds)
+  {
+    Level& l = GetLevel(level);
+    ++l.scores;
+    if (pruned)
+      ++l.prunes;
+    else if (leafPair)
+      ++l.leafPairs;
+    scoreTime += seconds;
+  }
+
+  /**
+   * Record a call to Rescore() of a node combination that was not pruned yet.
+   *
+   * @param level Level of the reference node.
+   * @param pruned Whether the node combination was pruned.
+   * @param seconds Time spent in Rescore().
+   */
+  void AddRescore(const size_t level, const bool pruned, const double seconds)
+  {
+    Level& l = GetLevel(level);
+    ++l.rescores;
+    if (pruned)
+      ++l.rescorePrunes;
+    scoreTime += seconds;
+  }
+
+  /**
+   * Record a call to BaseCase(), or a batch of base cases computed at once.
+   *
+   * @param level Level of the last reference node that was scored.
+   * @param seconds Time spent in BaseCase().
+   * @param count Number of base cases.
+   */
+  void AddBaseCase(const size_t level,
+                   const double seconds,
+                   const size_t count = 1)
+  {
+    GetLevel(level).baseCases += count;
+    baseCaseTime += seconds;
+  }
+
+  //! Add the statistics collected by another object to these ones.
+  void Merge(const TraversalStatistics& other)
+  {
+    if (other.levels.size() > levels.size())
+      levels.resize(other.levels.size());
+
+    for (size_t i = 0; i < other.levels.size(); ++i)
+    {
+      levels[i].scores += other.levels[i].scores;
+      levels[i].prunes += other.levels[i].prunes;
+      levels[i].rescores += other.levels[i].rescores;
+      levels[i].rescorePrunes += other.levels[i].rescorePrunes;
+      levels[i].leafPairs += other.levels[i].leafPairs;
+      levels[i].baseCases += other.levels[i].baseCases;
+    }
+
+    scoreTime += other.scoreTime;
+    baseCaseTime += other.baseCaseTime;
+  }
+
+  /**
+   * Return the statistics as a JSON object, with the totals over all levels
+   * and an array `levels` holding the statistics of each level.
+   */
+  std::string ToJSON() const
+  {
+    Level total;
+    for (const Level& l : levels)
+    {
+      total.scores += l.scores;
+      total.prunes += l.prunes;
+      total.rescores += l.rescores;
+      total.rescorePrunes += l.rescorePrunes;
+      total.leafPairs += l.leafPairs;
+      total.baseCases += l.baseCases;
+    }
+
+    std::ostringstream oss;
+    oss << "{\"scores\": " << total.scores
+        << ", \"prunes\": " << total.prunes
+        << ", \"rescores\": " << total.rescores
+        << ", \"rescore_prunes\": " << total.rescorePrunes
+        << ", \"leaf_pairs\": " << total.leafPairs
+        << ", \"base_cases\": " << total.baseCases
+        << ", \"score_time\": " << scoreTime
+        << ", \"base_case_time\": " << baseCaseTime
+        << ", \"levels\": [";
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+      const Level& l = levels[i];
+      oss << ((i == 0) ? "" : ", ") << "{\"level\": " << i
+          << ", \"scores\": " << l.scores
+          << ", \"prunes\": " << l.prunes
+          << ", \"rescores\": " << l.rescores
+          << ", \"rescore_prunes\": " << l.rescorePrunes
+          << ", \"recursions\": " << (l.scores - l.prunes - l.rescorePrunes)
+          << ", \"leaf_pairs\": " << l.leafPairs
+          << ", \"base_cases\": " << l.baseCases << "}";
+    }
+    oss << "]}";
+
+    return oss.str();
+  }
+
+  /**
+   * Return the level of the given node in its tree; the root is level 0.
+   *
+   * @param node Node to find the level of.
+   */
+  template<typename TreeType>
+  static size_t Depth(const TreeType& node)
+  {
+    size_t depth = 0;
+    for (const TreeType* n = node.Parent(); n != NULL; n = n->Parent())
+      ++depth;
+    return depth;
+  }
+
+  //! Return the number of seconds elapsed since the given time.
+  static double Seconds(const std::chrono::steady_clock::time_point& start)
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+        start).count();
+  }
+
+  //! Get whether statistics are collected.
+  bool Enabled() const { return enabled; }
+  //! Modify whether statistics are collected.
+  bool& Enabled() { return enabled; }
+
+  //! Get the statistics of each level of the reference tree.
+  const std::vector<Level>& Levels() const { return levels; }
+  //! Get the total time spent in Score() and Rescore(), in seconds.
+  double ScoreTime() const { return scoreTime; }
+  //! Get the total time spent in BaseCase(), in seconds.
+  double BaseCaseTime() const { return baseCaseTime; }
+
+ private:
+  //! Get the statistics of the given level, adding levels as needed.
+  Level& GetLevel(const size_t level)
+  {
+    if (level >= levels.size())
+      levels.resize(level + 1);
+    return levels[level];
+  }
+
+  //! Whether statistics are collected.
+  bool enabled;
+  //! The statistics of each level of the reference tree.
+  std::vector<Level> levels;
+  //! The total time spent in Score() and Rescore().
+  double scoreTime;
+  //! The total time spent in BaseCase().
+  double baseCaseTime;
+};
+
+} // namespace mlpack
+
+#endif
@@ -27,6 +27,10 @@
 
 #include "statistic.hpp"
 #include "traversal_info.hpp"
+#include "traversal_budget.hpp"
+#include "traversal_statistics.hpp"
+#include "instrumented_rules.hpp"
+#include "parallel_dual_tree_traversal.hpp"
 #include "greedy_single_tree_traverser.hpp"
 
 #endif
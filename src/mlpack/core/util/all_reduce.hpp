@@ -0,0 +1,117 @@
+/**
+ * @file core/util/all_reduce.hpp
+ *
+ * The single-process all-reduce policy, and collective operations built on top
+ * of the Sum() of any all-reduce policy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_ALL_REDUCE_HPP
+#define MLPACK_CORE_UTIL_ALL_REDUCE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * LocalAllReduce is the all-reduce policy used when the whole dataset is on one
+ * machine: there is a single process, and summing a matrix over all processes
+ * leaves it unchanged.
+ *
+ * An all-reduce policy lets an algorithm run on a dataset whose points are
+ * sharded across several processes (for instance, XGBoostRegressor and
+ * DistributedKMeans).  Each process runs the algorithm on its own shard, and
+ * the policy must provide the following functions, which every process calls in
+ * the same order:
+ *
+ * @code
+ * // Get the index of this process, in [0, Size()).
+ * size_t Rank() const;
+ * // Get the number of processes.
+ * size_t Size() const;
+ * // Replace the given matrix with the elementwise sum of the matrices given by
+ * // all processes, which all have the same size.
+ * void Sum(arma::mat& values) const;
+ * @endcode
+ *
+ * See MPIAllReduce for an implementation on top of MPI.
+ */
+class LocalAllReduce
+{
+ public:
+  //! Get the index of this process.
+  size_t Rank() const { return 0; }
+
+  //! Get the number of processes.
+  size_t Size() const { return 1; }
+
+  //! Sum the given matrix over all processes; there is nothing to do.
+  void Sum(arma::mat& /* values */) const { }
+};
+
+/**
+ * Give every process the matrix of the given root process.  Every process must
+ * pass a matrix of the same size.
+ *
+ * @param allReduce All-reduce policy over the processes.
+ * @param values Matrix to broadcast (on the root), or to overwrite with the
+ *     matrix of the root (on the other processes).
+ * @param root Index of the process whose matrix is broadcast.
+ */
+template<typename AllReduceType>
+void AllReduceBroadcast(const AllReduceType& allReduce,
+                        arma::mat& values,
+                        const size_t root = 0)
+{
+  if (allReduce.Size() == 1)
+    return;
+
+  if (allReduce.Rank() != root)
+    values.zeros();
+  allReduce.Sum(values);
+}
+
+/**
+ * Concatenate the columns given by every process, in the order of the ranks of
+ * the processes.  Every process must give the same number of rows, but may give
+ * any number of columns.
+ *
+ * @param allReduce All-reduce policy over the processes.
+ * @param local Columns of this process.
+ * @param gathered Will be set to the columns of all processes.
+ * @param offsets If given, will be set to the index of the first column of each
+ *     process in gathered, followed by the total number of columns.
+ */
+template<typename AllReduceType>
+void AllReduceGather(const AllReduceType& allReduce,
+                     const arma::mat& local,
+                     arma::mat& gathered,
+                     arma::Col<size_t>* offsets = nullptr)
+{
+  const size_t size = allReduce.Size();
+  const size_t rank = allReduce.Rank();
+
+  arma::mat numCols(size, 1, arma::fill::zeros);
+  numCols[rank] = local.n_cols;
+  allReduce.Sum(numCols);
+
+  arma::Col<size_t> firstCols(size + 1);
+  firstCols[0] = 0;
+  for (size_t p = 0; p < size; ++p)
+    firstCols[p + 1] = firstCols[p] + (size_t) numCols[p];
+
+  gathered.zeros(local.n_rows, firstCols[size]);
+  if (local.n_cols > 0)
+    gathered.cols(firstCols[rank], firstCols[rank + 1] - 1) = local;
+  allReduce.Sum(gathered);
+
+  if (offsets != nullptr)
+    *offsets = std::move(firstCols);
+}
+
+} // namespace mlpack
+
+#endif
@@ -254,4 +254,55 @@ struct GetSparseMatType<arma::SpMat<eT>>
   typedef arma::SpMat<eT> type;
 };
 
+// Detect whether a type is a Bandicoot (GPU) type, whose memory cannot be
+// accessed through host pointers.
+
+template<typename MatType>
+struct IsCootType
+{
+  static const bool value = false;
+};
+
+#ifdef MLPACK_HAS_COOT
+
+template<typename eT>
+struct IsCootType<coot::Mat<eT>>
+{
+  static const bool value = true;
+};
+
+template<typename eT>
+struct IsCootType<coot::Col<eT>>
+{
+  static const bool value = true;
+};
+
+template<typename eT>
+struct IsCootType<coot::Row<eT>>
+{
+  static const bool value = true;
+};
+
+// The vector and dense matrix types of Bandicoot matrices are Bandicoot types.
+
+template<typename eT>
+struct GetRowType<coot::Mat<eT>>
+{
+  typedef coot::Row<eT> type;
+};
+
+template<typename eT>
+struct GetColType<coot::Mat<eT>>
+{
+  typedef coot::Col<eT> type;
+};
+
+template<typename eT>
+struct GetDenseMatType<coot::Mat<eT>>
+{
+  typedef coot::Mat<eT> type;
+};
+
+#endif
+
 #endif
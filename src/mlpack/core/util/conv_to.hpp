@@ -60,6 +60,33 @@ class ConvTo
    }
 };
 
+/**
+ * Convert the given matrix to OutputType, like ConvTo<OutputType>::From().  If
+ * the input already has type OutputType, it is not converted; if it is also an
+ * rvalue, its memory is taken instead of being copied.  This is useful for
+ * code that takes ownership of a dataset that may or may not have to be
+ * converted first, such as the models held by the bindings.
+ *
+ * @param input The input that is converted.
+ */
+template<typename OutputType, typename InputType>
+inline OutputType ConvertOrMove(InputType&& input,
+                                const typename std::enable_if_t<std::is_same<
+                                    OutputType, std::decay_t<InputType>
+                                >::value>* = 0)
+{
+  return std::forward<InputType>(input);
+}
+
+template<typename OutputType, typename InputType>
+inline OutputType ConvertOrMove(InputType&& input,
+                                const typename std::enable_if_t<!std::is_same<
+                                    OutputType, std::decay_t<InputType>
+                                >::value>* = 0)
+{
+  return ConvTo<OutputType>::From(input);
+}
+
 } // namespace mlpack
 
 #endif
@@ -0,0 +1,595 @@
+/**
+ * @file core/util/executor.hpp
+ *
+ * Executors run the iterations of the parallel loops of mlpack.  The default
+ * executor uses OpenMP; a work-stealing thread pool is also available, and
+ * programs that embed mlpack can supply their own executor, so that mlpack
+ * shares their threads instead of creating more.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_EXECUTOR_HPP
+#define MLPACK_CORE_UTIL_EXECUTOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#ifdef MLPACK_USE_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+
+/**
+ * An Executor runs a set of independent tasks, possibly in parallel, and
+ * returns when all of them have finished.  mlpack's parallel algorithms run
+ * their loops with ParallelFor() and ParallelForRanges(), which split the loop
+ * into tasks and give them to the executor set with SetExecutor().
+ *
+ * To run mlpack on the threads of another framework, derive from Executor and
+ * implement Run() and MaxThreads():
+ *
+ * @code
+ * class MyExecutor : public mlpack::Executor
+ * {
+ *  public:
+ *   void Run(const size_t numTasks,
+ *            const std::function<void(size_t)>& task,
+ *            const size_t numThreads)
+ *   {
+ *     // Submit task(0), ..., task(numTasks - 1) to at most numThreads
+ *     // workers, and wait for them to finish.
+ *   }
+ *
+ *   size_t MaxThreads() const { return 16; }
+ * };
+ *
+ * mlpack::SetExecutor(std::make_shared<MyExecutor>());
+ * @endcode
+ *
+ * The tasks given to Run() never throw; ParallelFor() catches the exceptions
+ * of the loop body and rethrows the first one after Run() returns.
+ */
+class Executor
+{
+ public:
+  //! Destroy the executor.
+  virtual ~Executor() { }
+
+  /**
+   * Run task(0), ..., task(numTasks - 1), using at most numThreads threads
+   * (including the calling thread), and return when all tasks have finished.
+   *
+   * @param numTasks Number of tasks to run.
+   * @param task Function that runs the given task.
+   * @param numThreads Maximum number of threads to use; at least 1.
+   */
+  virtual void Run(const size_t numTasks,
+                   const std::function<void(size_t)>& task,
+                   const size_t numThreads) = 0;
+
+  //! Get the maximum number of threads that the executor can use.
+  virtual size_t MaxThreads() const = 0;
+};
+
+/**
+ * The default executor, which runs the tasks in an OpenMP parallel loop with
+ * dynamic scheduling (or serially, if mlpack is compiled without OpenMP).
+ * Like the OpenMP regions of mlpack, it uses the number of threads set with
+ * omp_set_num_threads() or the OMP_NUM_THREADS environment variable.
+ */
+class OpenMPExecutor : public Executor
+{
+ public:
+  //! Run the tasks in an OpenMP parallel loop.
+  void Run(const size_t numTasks,
+           const std::function<void(size_t)>& task,
+           const size_t numThreads)
+  {
+    #pragma omp parallel for schedule(dynamic) num_threads((int) numThreads) \
+        if (numThreads > 1)
+    for (size_t i = 0; i < numTasks; ++i)
+      task(i);
+  }
+
+  //! Get the maximum number of OpenMP threads.
+  size_t MaxThreads() const
+  {
+  #ifdef MLPACK_USE_OPENMP
+    return (size_t) omp_get_max_threads();
+  #else
+    return 1;
+  #endif
+  }
+};
+
+/**
+ * An executor that runs all the tasks on the calling thread.
+ */
+class SerialExecutor : public Executor
+{
+ public:
+  //! Run the tasks one after another.
+  void Run(const size_t numTasks,
+           const std::function<void(size_t)>& task,
+           const size_t /* numThreads */)
+  {
+    for (size_t i = 0; i < numTasks; ++i)
+      task(i);
+  }
+
+  //! Only the calling thread is used.
+  size_t MaxThreads() const { return 1; }
+};
+
+/**
+ * A pool of threads that run the tasks given to Run() with work stealing: each
+ * participating thread (the calling thread and some of the workers) starts
+ * with a contiguous range of the tasks, and a thread that finishes its range
+ * steals half of the range of another thread.  The threads are created once,
+ * when the pool is created, and wait for work between calls.
+ *
+ * Calls to Run() from several threads are run one after another.  A call to
+ * Run() from one of the tasks of the pool runs its tasks on the calling
+ * thread, so that nested parallel loops do not deadlock or oversubscribe the
+ * machine.
+ */
+class ThreadPoolExecutor : public Executor
+{
+ public:
+  /**
+   * Create a pool that runs the tasks on the given number of threads,
+   * including the thread that calls Run(); numThreads - 1 workers are
+   * created.
+   *
+   * @param numThreads Number of threads; 0 uses one per hardware thread.
+   */
+  explicit ThreadPoolExecutor(const size_t numThreads = 0) :
+      numThreads(std::max((size_t) 1, (numThreads == 0) ?
+          (size_t) std::thread::hardware_concurrency() : numThreads)),
+      generation(0),
+      stop(false)
+  {
+    for (size_t i = 1; i < this->numThreads; ++i)
+      workers.emplace_back([this, i]() { WorkerLoop(i); });
+  }
+
+  //! Stop and join the workers.
+  ~ThreadPoolExecutor()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    workAvailable.notify_all();
+    for (std::thread& worker : workers)
+      worker.join();
+  }
+
+  // The workers refer to the pool, so it cannot be copied or moved.
+  ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+  ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+  //! Run the tasks on the threads of the pool.
+  void Run(const size_t numTasks,
+           const std::function<void(size_t)>& task,
+           const size_t maxThreads)
+  {
+    const size_t participants = std::min(std::min(maxThreads, numThreads),
+        numTasks);
+    if (participants <= 1 || InsidePool())
+    {
+      for (size_t i = 0; i < numTasks; ++i)
+        task(i);
+      return;
+    }
+
+    std::lock_guard<std::mutex> runLock(runMutex);
+
+    Job job(task, numTasks, participants);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      currentJob = &job;
+      ++generation;
+    }
+    workAvailable.notify_all();
+
+    // The calling thread is participant 0.
+    InsidePool() = true;
+    Work(job, 0);
+    InsidePool() = false;
+
+    // Wait for the workers to finish their tasks, so that the job is not used
+    // after it is destroyed.
+    std::unique_lock<std::mutex> lock(mutex);
+    jobDone.wait(lock, [&job]() { return job.finished == job.participants; });
+    currentJob = nullptr;
+  }
+
+  //! Get the number of threads of the pool.
+  size_t MaxThreads() const { return numThreads; }
+
+ private:
+  //! A range of tasks that a thread runs, from which other threads steal.
+  struct TaskRange
+  {
+    std::mutex mutex;
+    size_t begin;
+    size_t end;
+  };
+
+  //! The tasks of a call to Run().
+  struct Job
+  {
+    Job(const std::function<void(size_t)>& task,
+        const size_t numTasks,
+        const size_t participants) :
+        task(task),
+        ranges(participants),
+        participants(participants),
+        finished(1) // The calling thread finishes with Run().
+    {
+      for (size_t p = 0; p < participants; ++p)
+      {
+        ranges[p].begin = p * numTasks / participants;
+        ranges[p].end = (p + 1) * numTasks / participants;
+      }
+    }
+
+    const std::function<void(size_t)>& task;
+    std::vector<TaskRange> ranges;
+    size_t participants;
+    //! Number of participants that have finished; protected by the mutex of
+    //! the pool.
+    size_t finished;
+  };
+
+  //! Whether the current thread is running tasks of a pool.
+  static bool& InsidePool()
+  {
+    static thread_local bool insidePool = false;
+    return insidePool;
+  }
+
+  //! Take the next task of the given participant's range.
+  static bool TakeTask(TaskRange& range, size_t& task)
+  {
+    std::lock_guard<std::mutex> lock(range.mutex);
+    if (range.begin >= range.end)
+      return false;
+
+    task = range.begin++;
+    return true;
+  }
+
+  //! Steal half of the tasks of another participant; return false if no
+  //! participant has tasks left.
+  static bool Steal(Job& job, const size_t participant)
+  {
+    for (size_t offset = 1; offset < job.participants; ++offset)
+    {
+      TaskRange& victim = job.ranges[(participant + offset) %
+          job.participants];
+      size_t begin, end;
+      {
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.begin >= victim.end)
+          continue;
+
+        // Take the second half (or the last task).
+        end = victim.end;
+        begin = victim.begin + (victim.end - victim.begin) / 2;
+        victim.end = begin;
+      }
+
+      TaskRange& own = job.ranges[participant];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      own.begin = begin;
+      own.end = end;
+      return true;
+    }
+
+    return false;
+  }
+
+  //! Run tasks of the job until no participant has tasks left.
+  static void Work(Job& job, const size_t participant)
+  {
+    size_t task;
+    do
+    {
+      while (TakeTask(job.ranges[participant], task))
+        job.task(task);
+    } while (Steal(job, participant));
+  }
+
+  //! The loop of worker i, which waits for jobs.
+  void WorkerLoop(const size_t i)
+  {
+    InsidePool() = true;
+    size_t seenGeneration = 0;
+    while (true)
+    {
+      Job* job;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        workAvailable.wait(lock, [this, &seenGeneration]()
+            { return stop || generation != seenGeneration; });
+        if (stop)
+          return;
+
+        seenGeneration = generation;
+        job = currentJob;
+      }
+
+      // Only the first participants of the job take part in it.
+      if (job == nullptr || i >= job->participants)
+        continue;
+
+      Work(*job, i);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++job->finished;
+      }
+      jobDone.notify_all();
+    }
+  }
+
+  //! Number of threads, including the calling thread.
+  size_t numThreads;
+  //! The workers.
+  std::vector<std::thread> workers;
+  //! Serializes calls to Run().
+  std::mutex runMutex;
+  //! Protects currentJob, generation, stop and the finished count of jobs.
+  std::mutex mutex;
+  //! Signals the workers that a job is available or that the pool stops.
+  std::condition_variable workAvailable;
+  //! Signals the calling thread that a worker finished a job.
+  std::condition_variable jobDone;
+  //! The job being run, if any.
+  Job* currentJob = nullptr;
+  //! Incremented for each job.
+  size_t generation;
+  //! Whether the workers should stop.
+  bool stop;
+};
+
+/**
+ * Get the pointer to the executor used by ParallelFor().  By default this is
+ * an OpenMPExecutor.
+ */
+inline std::shared_ptr<Executor>& ExecutorPointer()
+{
+  static std::shared_ptr<Executor> executor(new OpenMPExecutor());
+  return executor;
+}
+
+/**
+ * Set the executor used by the parallel loops of mlpack; a null pointer
+ * restores the default OpenMPExecutor.  This should be done before (and not
+ * while) mlpack algorithms run.
+ *
+ * @param executor Executor to use.
+ */
+inline void SetExecutor(std::shared_ptr<Executor> executor)
+{
+  ExecutorPointer() = executor ? std::move(executor) :
+      std::shared_ptr<Executor>(new OpenMPExecutor());
+}
+
+//! Get the executor used by the parallel loops of mlpack.
+inline Executor& GetExecutor() { return *ExecutorPointer(); }
+
+/**
+ * Get the thread limit of the calling thread set by ThreadLimit; 0 if there
+ * is no limit.
+ */
+inline size_t& ThreadLimitValue()
+{
+  static thread_local size_t limit = 0;
+  return limit;
+}
+
+/**
+ * Whether the calling thread is running a task of ParallelFor(), in which
+ * case nested parallel loops are run serially.
+ */
+inline bool& InsideParallelFor()
+{
+  static thread_local bool inside = false;
+  return inside;
+}
+
+/**
+ * A ThreadLimit caps the number of threads used by the parallel loops that
+ * the calling thread runs while the ThreadLimit exists, so that a call to an
+ * algorithm can use fewer threads than the executor has:
+ *
+ * @code
+ * {
+ *   mlpack::ThreadLimit limit(2);
+ *   rf.Train(data, labels, numClasses); // Uses at most 2 threads.
+ * }
+ * @endcode
+ *
+ * The OpenMP regions that the calling thread starts are capped too (with
+ * omp_set_num_threads()), so the limit also holds for the parts of mlpack that
+ * do not use ParallelFor().  The previous limits are restored when the
+ * ThreadLimit is destroyed.
+ */
+class ThreadLimit
+{
+ public:
+  /**
+   * Cap the number of threads of parallel loops.
+   *
+   * @param numThreads Maximum number of threads; 0 removes the limit.
+   */
+  explicit ThreadLimit(const size_t numThreads) :
+      previous(ThreadLimitValue())
+  {
+    ThreadLimitValue() = numThreads;
+  #ifdef MLPACK_USE_OPENMP
+    previousOpenMP = omp_get_max_threads();
+    if (numThreads > 0 && (int) numThreads < previousOpenMP)
+      omp_set_num_threads((int) numThreads);
+  #endif
+  }
+
+  //! Restore the previous limit.
+  ~ThreadLimit()
+  {
+    ThreadLimitValue() = previous;
+  #ifdef MLPACK_USE_OPENMP
+    omp_set_num_threads(previousOpenMP);
+  #endif
+  }
+
+  ThreadLimit(const ThreadLimit&) = delete;
+  ThreadLimit& operator=(const ThreadLimit&) = delete;
+
+ private:
+  //! The limit before this one.
+  size_t previous;
+#ifdef MLPACK_USE_OPENMP
+  //! The number of OpenMP threads before this limit.
+  int previousOpenMP;
+#endif
+};
+
+/**
+ * Return the number of threads that a parallel loop started by the calling
+ * thread would use: the maximum of the executor, capped by ThreadLimit, or 1
+ * inside a parallel loop (of ParallelFor() or of OpenMP).
+ */
+inline size_t NumThreads()
+{
+  if (InsideParallelFor())
+    return 1;
+#ifdef MLPACK_USE_OPENMP
+  if (omp_in_parallel())
+    return 1;
+#endif
+
+  const size_t maxThreads = std::max((size_t) 1, GetExecutor().MaxThreads());
+  const size_t limit = ThreadLimitValue();
+  return (limit == 0) ? maxThreads : std::min(limit, maxThreads);
+}
+
+/**
+ * Call function(begin, end) for contiguous ranges [begin, end) that cover
+ * [first, last), in parallel with the executor.  This is useful for loops that
+ * keep state per range, such as accumulators that are merged at the end of
+ * each range.  A std::exception thrown by the function is rethrown (the first
+ * one, if several ranges throw) after all ranges have finished.
+ *
+ * @param first First index of the loop.
+ * @param last One past the last index of the loop.
+ * @param function Function called on each range.
+ * @param numRanges Number of ranges; 0 uses one per thread.  More ranges than
+ *     threads balance uneven work better.
+ */
+template<typename FunctionType>
+void ParallelForRanges(const size_t first,
+                       const size_t last,
+                       FunctionType&& function,
+                       size_t numRanges = 0)
+{
+  if (last <= first)
+    return;
+
+  const size_t numThreads = NumThreads();
+  if (numRanges == 0)
+    numRanges = numThreads;
+  numRanges = std::min(numRanges, last - first);
+  if (numThreads <= 1 || numRanges <= 1)
+  {
+    function(first, last);
+    return;
+  }
+
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  const size_t limit = ThreadLimitValue();
+  GetExecutor().Run(numRanges, [&](const size_t range)
+  {
+    // Loops started by the function run serially, with the same limit.
+    const bool wasInside = InsideParallelFor();
+    const size_t oldLimit = ThreadLimitValue();
+    InsideParallelFor() = true;
+    ThreadLimitValue() = limit;
+    try
+    {
+      const size_t count = last - first;
+      function(first + range * count / numRanges,
+          first + (range + 1) * count / numRanges);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (!error)
+        error = std::current_exception();
+    }
+    InsideParallelFor() = wasInside;
+    ThreadLimitValue() = oldLimit;
+  }, numThreads);
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+/**
+ * Call function(i) for each i in [first, last), in parallel with the
+ * executor.  The indices are given to the executor in tasks of grainSize
+ * consecutive indices.  A std::exception thrown by the function is rethrown
+ * (the first one, if several iterations throw) after all tasks have finished.
+ *
+ * @code
+ * mlpack::ParallelFor(0, data.n_cols, [&](const size_t i)
+ * {
+ *   results[i] = Process(data.col(i));
+ * });
+ * @endcode
+ *
+ * @param first First index of the loop.
+ * @param last One past the last index of the loop.
+ * @param function Function called on each index.
+ * @param grainSize Number of consecutive indices of each task.
+ */
+template<typename FunctionType>
+void ParallelFor(const size_t first,
+                 const size_t last,
+                 FunctionType&& function,
+                 const size_t grainSize = 1)
+{
+  if (last <= first)
+    return;
+
+  const size_t grain = std::max((size_t) 1, grainSize);
+  const size_t numTasks = (last - first + grain - 1) / grain;
+  ParallelForRanges(0, numTasks, [&](const size_t begin, const size_t end)
+  {
+    for (size_t t = begin; t < end; ++t)
+    {
+      const size_t taskEnd = std::min(last, first + (t + 1) * grain);
+      for (size_t i = first + t * grain; i < taskEnd; ++i)
+        function(i);
+    }
+  }, numTasks);
+}
+
+} // namespace mlpack
+
+#endif
@@ -192,8 +192,10 @@ inline util::Timers& IO::GetTimers()
  */
 inline util::Params IO::Parameters(const std::string& bindingName)
 {
-  // We don't need a mutex here, because we are only randomly accessing elements
-  // of the maps.
+  // The maps may be accessed by several bindings running in different threads,
+  // and operator[] inserts missing elements, so the maps must be locked.
+  std::lock_guard<std::mutex> lock(GetSingleton().mapMutex);
+  std::lock_guard<std::mutex> docLock(GetSingleton().docMutex);
   std::map<char, std::string> resultAliases =
       GetSingleton().aliases[bindingName];
   // Merge in any persistent parameters (e.g. parameters in the "" binding map).
@@ -0,0 +1,302 @@
+/**
+ * @file core/util/memory_tracker.hpp
+ *
+ * Optional counters of the memory allocated by Armadillo and by tree nodes,
+ * and of the peak memory of each phase timed with Timer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_MEMORY_TRACKER_HPP
+#define MLPACK_CORE_UTIL_MEMORY_TRACKER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <string>
+
+#if defined(_WIN32)
+  #include <malloc.h>
+#endif
+
+namespace mlpack {
+
+/**
+ * The MemoryTracker counts the bytes that are currently allocated, and the
+ * peak, for each category of allocation.  It is only fed when mlpack is
+ * configured with the TRACK_MEMORY CMake option (which defines
+ * MLPACK_TRACK_MEMORY): then Armadillo allocates its matrices through
+ * ArmaAllocate() and ArmaFree(), and tree nodes hold a NodeCounter.  Otherwise
+ * every counter stays at zero and nothing is added to the hot paths.
+ *
+ * The peak of a phase is found with BeginPhase() and EndPhase(), which Timer
+ * calls when a timer is started and stopped; the results are reported with
+ * the timers (see util::Timers::GetAllMemory(), and the --print_memory option
+ * of command-line programs).  Phases must nest on each thread; the peak of
+ * phases that overlap on different threads includes the allocations of both.
+ */
+class MemoryTracker
+{
+ public:
+  //! The categories of tracked allocations.
+  enum Category
+  {
+    Armadillo = 0,
+    TreeNodes = 1,
+    NumCategories = 2
+  };
+
+  //! Whether allocations are tracked in this build.
+  static constexpr bool Enabled()
+  {
+    #ifdef MLPACK_TRACK_MEMORY
+    return true;
+    #else
+    return false;
+    #endif
+  }
+
+  //! Count an allocation of the given number of bytes.
+  static void Allocate(const Category category, const size_t bytes)
+  {
+    Counters& c = GetCounters(category);
+    c.current.fetch_add(bytes, std::memory_order_relaxed);
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    c.live.fetch_add(1, std::memory_order_relaxed);
+    UpdatePeak(c.peak, c.current.load(std::memory_order_relaxed));
+
+    const size_t total = Total().fetch_add(bytes, std::memory_order_relaxed) +
+        bytes;
+    UpdatePeak(TotalPeak(), total);
+  }
+
+  //! Count the release of an allocation of the given number of bytes.
+  static void Deallocate(const Category category, const size_t bytes)
+  {
+    Counters& c = GetCounters(category);
+    c.current.fetch_sub(bytes, std::memory_order_relaxed);
+    c.live.fetch_sub(1, std::memory_order_relaxed);
+    Total().fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  //! Get the number of bytes currently allocated, over all categories.
+  static size_t CurrentBytes() { return Total().load(); }
+  //! Get the peak number of bytes allocated, over all categories.
+  static size_t PeakBytes() { return TotalPeak().load(); }
+
+  //! Get the number of bytes currently allocated in the given category.
+  static size_t CurrentBytes(const Category category)
+  {
+    return GetCounters(category).current.load();
+  }
+
+  //! Get the peak number of bytes allocated in the given category.
+  static size_t PeakBytes(const Category category)
+  {
+    return GetCounters(category).peak.load();
+  }
+
+  //! Get the number of allocations made in the given category.
+  static size_t Allocations(const Category category)
+  {
+    return GetCounters(category).allocations.load();
+  }
+
+  //! Get the number of allocations of the given category not yet released.
+  static size_t LiveAllocations(const Category category)
+  {
+    return GetCounters(category).live.load();
+  }
+
+  /**
+   * Get every counter, with names like "armadillo_current_bytes",
+   * "tree_nodes_allocations" and "peak_bytes".
+   */
+  static std::map<std::string, size_t> Statistics()
+  {
+    std::map<std::string, size_t> result;
+    const char* names[NumCategories] = { "armadillo", "tree_nodes" };
+    for (size_t i = 0; i < NumCategories; ++i)
+    {
+      const std::string name(names[i]);
+      const Category c = (Category) i;
+      result[name + "_current_bytes"] = CurrentBytes(c);
+      result[name + "_peak_bytes"] = PeakBytes(c);
+      result[name + "_allocations"] = Allocations(c);
+      result[name + "_live_allocations"] = LiveAllocations(c);
+    }
+    result["current_bytes"] = CurrentBytes();
+    result["peak_bytes"] = PeakBytes();
+    return result;
+  }
+
+  /**
+   * Get a printable representation of a number of bytes, such as "12.34 MiB".
+   */
+  static std::string PrintBytes(const int64_t bytes)
+  {
+    const char* units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+    double value = (double) (bytes < 0 ? -bytes : bytes);
+    size_t unit = 0;
+    while (value >= 1024.0 && unit < 4)
+    {
+      value /= 1024.0;
+      ++unit;
+    }
+
+    std::ostringstream oss;
+    if (bytes < 0)
+      oss << "-";
+    if (unit == 0)
+      oss << (int64_t) value << " " << units[unit];
+    else
+      oss << std::fixed << std::setprecision(2) << value << " " << units[unit];
+    return oss.str();
+  }
+
+  /**
+   * Start a phase: the peak is reset to the current number of bytes, and the
+   * previous peak is returned, to be given to EndPhase().
+   */
+  static size_t BeginPhase()
+  {
+    return TotalPeak().exchange(Total().load());
+  }
+
+  /**
+   * End a phase started with BeginPhase(), and return its peak.  The peak is
+   * restored to the larger of the peak before the phase and the peak of the
+   * phase, so that enclosing phases see the allocations of the phase.
+   */
+  static size_t EndPhase(const size_t previousPeak)
+  {
+    const size_t phasePeak = TotalPeak().load();
+    UpdatePeak(TotalPeak(), previousPeak);
+    return phasePeak;
+  }
+
+  /**
+   * Allocate memory for Armadillo, counting it; this is used as
+   * ARMA_ALIEN_MEM_ALLOC_FUNCTION.  The size of the allocation is stored in a
+   * header before the returned memory, which keeps the alignment Armadillo
+   * prefers.
+   */
+  static void* ArmaAllocate(const size_t bytes)
+  {
+    void* memory = NULL;
+    #if defined(_WIN32)
+    memory = _aligned_malloc(bytes + HeaderSize, HeaderSize);
+    #else
+    if (posix_memalign(&memory, HeaderSize, bytes + HeaderSize) != 0)
+      memory = NULL;
+    #endif
+    if (memory == NULL)
+      return NULL;
+
+    *((size_t*) memory) = bytes;
+    Allocate(Armadillo, bytes);
+    return (void*) ((char*) memory + HeaderSize);
+  }
+
+  //! Release memory allocated by ArmaAllocate(); used as
+  //! ARMA_ALIEN_MEM_FREE_FUNCTION.
+  static void ArmaFree(void* pointer)
+  {
+    if (pointer == NULL)
+      return;
+
+    void* memory = (void*) ((char*) pointer - HeaderSize);
+    Deallocate(Armadillo, *((size_t*) memory));
+    #if defined(_WIN32)
+    _aligned_free(memory);
+    #else
+    free(memory);
+    #endif
+  }
+
+  /**
+   * A NodeCounter counts the node that holds it for as long as it lives.
+   * Trees hold one when MLPACK_TRACK_MEMORY is defined, initialized with the
+   * size of the node.
+   */
+  class NodeCounter
+  {
+   public:
+    //! Count a node of the given size.
+    NodeCounter(const size_t bytes) : bytes(bytes)
+    {
+      Allocate(TreeNodes, bytes);
+    }
+
+    //! Count a copy of a node.
+    NodeCounter(const NodeCounter& other) : bytes(other.bytes)
+    {
+      Allocate(TreeNodes, bytes);
+    }
+
+    //! The node still counts once, so assignment changes nothing.
+    NodeCounter& operator=(const NodeCounter& /* other */) { return *this; }
+
+    //! Stop counting the node.
+    ~NodeCounter() { Deallocate(TreeNodes, bytes); }
+
+   private:
+    //! Size of the node.
+    size_t bytes;
+  };
+
+ private:
+  //! The counters of one category.
+  struct Counters
+  {
+    Counters() : current(0), peak(0), allocations(0), live(0) { }
+
+    std::atomic<size_t> current;
+    std::atomic<size_t> peak;
+    std::atomic<size_t> allocations;
+    std::atomic<size_t> live;
+  };
+
+  //! Size of the header of Armadillo allocations; also their alignment.
+  static constexpr size_t HeaderSize = 32;
+
+  //! Get the counters of a category.
+  static Counters& GetCounters(const Category category)
+  {
+    static Counters counters[NumCategories];
+    return counters[category];
+  }
+
+  //! Get the number of bytes allocated over all categories.
+  static std::atomic<size_t>& Total()
+  {
+    static std::atomic<size_t> total(0);
+    return total;
+  }
+
+  //! Get the peak of the number of bytes allocated over all categories.
+  static std::atomic<size_t>& TotalPeak()
+  {
+    static std::atomic<size_t> peak(0);
+    return peak;
+  }
+
+  //! Raise the given peak to the given value, if it is larger.
+  static void UpdatePeak(std::atomic<size_t>& peak, const size_t value)
+  {
+    size_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value,
+        std::memory_order_relaxed)) { }
+  }
+};
+
+} // namespace mlpack
+
+#endif
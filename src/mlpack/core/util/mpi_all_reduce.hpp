@@ -0,0 +1,89 @@
+/**
+ * @file core/util/mpi_all_reduce.hpp
+ *
+ * The all-reduce policy for algorithms sharded across MPI processes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_MPI_ALL_REDUCE_HPP
+#define MLPACK_CORE_UTIL_MPI_ALL_REDUCE_HPP
+
+#include <mlpack/core/util/all_reduce.hpp>
+#include <mpi.h>
+
+namespace mlpack {
+
+/**
+ * MPIAllReduce is an all-reduce policy (see LocalAllReduce) that sums matrices
+ * over the processes of an MPI communicator with MPI_Allreduce().  This file is
+ * not included by mlpack.hpp; include it explicitly, and compile and link the
+ * program with MPI.  MPI must be initialized before the policy is used.
+ *
+ * @code
+ * MPI_Init(&argc, &argv);
+ *
+ * // Each process loads its own shard of the points.
+ * arma::mat data;
+ * arma::rowvec responses;
+ * // ...
+ *
+ * XGBoostRegressor<> xgb(200, 0.1);
+ * xgb.Train(data, responses, MPIAllReduce());
+ * // Every process now holds the same model.
+ *
+ * MPI_Finalize();
+ * @endcode
+ */
+class MPIAllReduce
+{
+ public:
+  /**
+   * Create the policy for the given communicator.
+   *
+   * @param comm Communicator of the processes to train across.
+   */
+  MPIAllReduce(MPI_Comm comm = MPI_COMM_WORLD) : comm(comm) { }
+
+  //! Get the index of this process in the communicator.
+  size_t Rank() const
+  {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    return (size_t) rank;
+  }
+
+  //! Get the number of processes in the communicator.
+  size_t Size() const
+  {
+    int size;
+    MPI_Comm_size(comm, &size);
+    return (size_t) size;
+  }
+
+  //! Sum the given matrix over all processes of the communicator, in place.
+  void Sum(arma::mat& values) const
+  {
+    if (values.n_elem > (size_t) std::numeric_limits<int>::max())
+    {
+      throw std::invalid_argument("MPIAllReduce::Sum(): matrix has too many "
+          "elements!");
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, values.memptr(), (int) values.n_elem,
+        MPI_DOUBLE, MPI_SUM, comm);
+  }
+
+  //! Get the communicator.
+  MPI_Comm Comm() const { return comm; }
+
+ private:
+  //! The communicator of the processes.
+  MPI_Comm comm;
+};
+
+} // namespace mlpack
+
+#endif
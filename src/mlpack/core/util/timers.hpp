@@ -23,6 +23,8 @@
 #include <string>
 #include <thread> // std::thread is used for thread safety.
 
+#include "memory_tracker.hpp"
+
 #if defined(_WIN32)
   // uint64_t isn't defined on every windows.
   #if !defined(HAVE_UINT64_T)
@@ -35,6 +37,23 @@
 #endif
 
 namespace mlpack {
+namespace util {
+
+/**
+ * The memory used during the runs of a timer, when memory tracking is enabled
+ * (see MemoryTracker).
+ */
+struct PhaseMemory
+{
+  PhaseMemory() : peakBytes(0), netBytes(0) { }
+
+  //! The largest number of bytes allocated during any run of the timer.
+  size_t peakBytes;
+  //! The bytes allocated minus the bytes released during the runs.
+  int64_t netBytes;
+};
+
+} // namespace util
 
 /**
  * The timer class provides a way for mlpack methods to be timed.  The three
@@ -98,6 +117,12 @@ class Timer
    * Returns a copy of all the timers used via this interface.
    */
   static std::map<std::string, std::chrono::microseconds> GetAllTimers();
+
+  /**
+   * Returns the memory used during each timer of this interface.  This is only
+   * filled when mlpack is built with memory tracking (see MemoryTracker).
+   */
+  static std::map<std::string, util::PhaseMemory> GetAllMemory();
 };
 
 namespace util {
@@ -113,6 +138,12 @@ class Timers
    */
   std::map<std::string, std::chrono::microseconds> GetAllTimers();
 
+  /**
+   * Returns a copy of the memory used during each timer, if memory tracking is
+   * enabled.  The peak of a timer is the largest peak of its runs.
+   */
+  std::map<std::string, PhaseMemory> GetAllMemory();
+
   /**
    * Reset the timers.  This stops all running timers and removes them.  Whether
    * or not timing is enabled will not be changed.
@@ -174,6 +205,12 @@ class Timers
   //! A map for the starting values of the timers.
   std::map<std::thread::id, std::map<std::string,
       std::chrono::high_resolution_clock::time_point>> timerStartTime;
+  //! The memory used during each timer.
+  std::map<std::string, PhaseMemory> memory;
+  //! The peak before each running timer and the bytes allocated when it was
+  //! started, if memory tracking is enabled.
+  std::map<std::thread::id, std::map<std::string, std::pair<size_t, size_t>>>
+      timerStartMemory;
 
   //! Whether or not timing is enabled.
   std::atomic<bool> enabled;
@@ -16,6 +16,7 @@
 #include "forward.hpp"
 #include "io.hpp"
 #include "log.hpp"
+#include "trace.hpp"
 
 #include <map>
 #include <string>
@@ -69,6 +70,11 @@ inline std::map<std::string, std::chrono::microseconds> Timer::GetAllTimers()
   return IO::GetSingleton().timer.GetAllTimers();
 }
 
+inline std::map<std::string, util::PhaseMemory> Timer::GetAllMemory()
+{
+  return IO::GetSingleton().timer.GetAllMemory();
+}
+
 namespace util {
 
 // Reset a Timers object.
@@ -77,6 +83,8 @@ inline void Timers::Reset()
   std::lock_guard<std::mutex> lock(timersMutex);
   timers.clear();
   timerStartTime.clear();
+  memory.clear();
+  timerStartMemory.clear();
 }
 
 inline std::map<std::string, std::chrono::microseconds> Timers::GetAllTimers()
@@ -86,6 +94,12 @@ inline std::map<std::string, std::chrono::microseconds> Timers::GetAllTimers()
   return timers;
 }
 
+inline std::map<std::string, PhaseMemory> Timers::GetAllMemory()
+{
+  std::lock_guard<std::mutex> lock(timersMutex);
+  return memory;
+}
+
 inline std::chrono::microseconds Timers::Get(const std::string& timerName)
 {
   if (!enabled)
@@ -180,8 +194,22 @@ inline void Timers::StopAllTimers()
     }
   }
 
+  // The memory phases of the running timers end now too.  Only the peak since
+  // the innermost running phase started is known, so that is used for each.
+  for (auto it : timerStartMemory)
+  {
+    for (auto it2 : it.second)
+    {
+      PhaseMemory& m = memory[it2.first];
+      m.peakBytes = std::max(m.peakBytes, MemoryTracker::PeakBytes());
+      m.netBytes += (int64_t) MemoryTracker::CurrentBytes() -
+          (int64_t) it2.second.second;
+    }
+  }
+
   // If all timers are stopped, we can clear the maps.
   timerStartTime.clear();
+  timerStartMemory.clear();
 }
 
 inline void Timers::Start(const std::string& timerName,
@@ -212,6 +240,13 @@ inline void Timers::Start(const std::string& timerName,
   }
 
   timerStartTime[threadId][timerName] = currTime;
+
+  // Start a memory phase, if allocations are tracked.
+  if (MemoryTracker::Enabled())
+  {
+    timerStartMemory[threadId][timerName] = std::make_pair(
+        MemoryTracker::BeginPhase(), MemoryTracker::CurrentBytes());
+  }
 }
 
 inline void Timers::Stop(const std::string& timerName,
@@ -239,6 +274,26 @@ inline void Timers::Stop(const std::string& timerName,
   timers[timerName] += std::chrono::duration_cast<std::chrono::microseconds>(
       currTime - timerStartTime[threadId][timerName]);
 
+  // Also show the interval in the trace, if there is one.
+  if (Trace::Enabled())
+    Trace::Record(timerName, timerStartTime[threadId][timerName], currTime);
+
+  // End the memory phase, if allocations are tracked.
+  if (MemoryTracker::Enabled())
+  {
+    const std::pair<size_t, size_t>& start =
+        timerStartMemory[threadId][timerName];
+    PhaseMemory& m = memory[timerName];
+    m.peakBytes = std::max(m.peakBytes,
+        MemoryTracker::EndPhase(start.first));
+    m.netBytes += (int64_t) MemoryTracker::CurrentBytes() -
+        (int64_t) start.second;
+
+    timerStartMemory[threadId].erase(timerName);
+    if (timerStartMemory[threadId].empty())
+      timerStartMemory.erase(threadId);
+  }
+
   // Remove the entries.
   timerStartTime[threadId].erase(timerName);
   if (timerStartTime[threadId].empty())
@@ -0,0 +1,439 @@
+/**
+ * @file core/util/trace.hpp
+ *
+ * Scoped timers that record nested intervals into per-thread buffers without
+ * taking locks, and export of the recorded intervals as a Chrome trace (which
+ * can also be opened with Perfetto) or as a flat CSV table.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_TRACE_HPP
+#define MLPACK_CORE_UTIL_TRACE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mlpack {
+
+/**
+ * An interval recorded by a ScopedTimer (or by a Timer that was stopped while
+ * tracing was enabled).
+ */
+struct TraceEvent
+{
+  //! Clock that the intervals are measured with (the same as Timer's).
+  typedef std::chrono::high_resolution_clock Clock;
+
+  //! Name of the timer.
+  std::string name;
+  //! Names of the enclosing scopes on the same thread and the name, joined by
+  //! '/'.  This is only filled in by Trace::Events().
+  std::string path;
+  //! Index of the thread that recorded the interval, in order of first use.
+  size_t thread;
+  //! Number of enclosing scopes on the same thread.
+  size_t depth;
+  //! Index of the enclosing event in the buffer of the thread, or SIZE_MAX.
+  size_t parent;
+  //! Start of the interval.
+  Clock::time_point start;
+  //! End of the interval.
+  Clock::time_point end;
+  //! Whether the interval has ended.
+  bool finished;
+};
+
+/**
+ * The events recorded by one thread.  Only that thread writes to it.
+ */
+struct TraceBuffer
+{
+  //! Recorded events, in the order they were opened or recorded.
+  std::vector<TraceEvent> events;
+  //! Indices of the events that have not ended yet, innermost last.
+  std::vector<size_t> open;
+  //! Index of the thread.
+  size_t thread;
+};
+
+/**
+ * Trace keeps the intervals recorded by ScopedTimer objects.  Each thread
+ * appends to its own buffer, so no lock is taken while recording; a lock is
+ * only taken the first time a thread records an interval, to register its
+ * buffer.  Scopes nest: an interval that starts while another one is open on
+ * the same thread is its child.  Tracing is disabled by default, and a
+ * disabled ScopedTimer costs a single atomic load.
+ *
+ * The recorded intervals can be saved with SaveChromeTrace() (a JSON file for
+ * chrome://tracing or https://ui.perfetto.dev), SaveCSV() (the number of calls
+ * and the total and self time of each path of nested scopes), or Save(), which
+ * picks the format from the extension of the file.  The command-line bindings
+ * do this for the --trace_file option.
+ *
+ * Events(), Save*() and Reset() read every buffer, so they must not be called
+ * while other threads are recording.
+ */
+class Trace
+{
+ public:
+  //! Start recording intervals.
+  static void Enable()
+  {
+    Origin();
+    EnabledFlag() = true;
+  }
+
+  //! Stop recording intervals.  Scopes that are open still record their end.
+  static void Disable() { EnabledFlag() = false; }
+
+  //! Get whether intervals are recorded.
+  static bool Enabled()
+  {
+    return EnabledFlag().load(std::memory_order_relaxed);
+  }
+
+  //! Remove every recorded interval.
+  static void Reset()
+  {
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    for (const std::shared_ptr<TraceBuffer>& buffer : Buffers())
+    {
+      buffer->events.clear();
+      buffer->open.clear();
+    }
+  }
+
+  /**
+   * Open a scope with the given name on the calling thread.  Prefer
+   * ScopedTimer, which closes the scope when it is destroyed.
+   */
+  static void Begin(const std::string& name)
+  {
+    TraceBuffer& buffer = LocalBuffer();
+    TraceEvent event;
+    event.name = name;
+    event.thread = buffer.thread;
+    event.depth = buffer.open.size();
+    event.parent = buffer.open.empty() ? size_t(-1) : buffer.open.back();
+    event.finished = false;
+    buffer.open.push_back(buffer.events.size());
+    buffer.events.push_back(std::move(event));
+    // Take the time last, so that the bookkeeping is not timed.
+    buffer.events.back().start = TraceEvent::Clock::now();
+  }
+
+  //! Close the innermost scope of the calling thread.
+  static void End()
+  {
+    const TraceEvent::Clock::time_point now = TraceEvent::Clock::now();
+    TraceBuffer& buffer = LocalBuffer();
+    // The scope may have been removed by Reset().
+    if (buffer.open.empty())
+      return;
+
+    const size_t index = buffer.open.back();
+    buffer.open.pop_back();
+    if (index < buffer.events.size())
+    {
+      buffer.events[index].end = now;
+      buffer.events[index].finished = true;
+    }
+  }
+
+  /**
+   * Record a whole interval on the calling thread, as a child of the
+   * innermost open scope that started before it.  This is used by Timer.
+   */
+  static void Record(const std::string& name,
+                     const TraceEvent::Clock::time_point& start,
+                     const TraceEvent::Clock::time_point& end)
+  {
+    TraceBuffer& buffer = LocalBuffer();
+    size_t depth = buffer.open.size();
+    while (depth > 0 && buffer.events[buffer.open[depth - 1]].start > start)
+      --depth;
+
+    TraceEvent event;
+    event.name = name;
+    event.thread = buffer.thread;
+    event.depth = depth;
+    event.parent = (depth == 0) ? size_t(-1) : buffer.open[depth - 1];
+    event.start = start;
+    event.end = end;
+    event.finished = true;
+    buffer.events.push_back(std::move(event));
+  }
+
+  /**
+   * Get a copy of every finished interval, with its path filled in, grouped by
+   * thread.
+   */
+  static std::vector<TraceEvent> Events()
+  {
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    std::vector<TraceEvent> result;
+    for (const std::shared_ptr<TraceBuffer>& buffer : Buffers())
+    {
+      const std::vector<TraceEvent>& events = buffer->events;
+      for (size_t i = 0; i < events.size(); ++i)
+      {
+        if (!events[i].finished)
+          continue;
+
+        result.push_back(events[i]);
+        std::string& path = result.back().path;
+        path = events[i].name;
+        for (size_t p = events[i].parent; p < events.size();
+            p = events[p].parent)
+        {
+          path = events[p].name + "/" + path;
+        }
+      }
+    }
+
+    return result;
+  }
+
+  /**
+   * Save the finished intervals in the Chrome trace event format, as complete
+   * ("X") events with microsecond timestamps relative to the first call to
+   * Enable().  A std::runtime_error is thrown if the file cannot be written.
+   */
+  static void SaveChromeTrace(const std::string& filename)
+  {
+    std::ofstream stream(filename);
+    if (!stream.is_open())
+    {
+      throw std::runtime_error("Trace::SaveChromeTrace(): cannot open '" +
+          filename + "' for writing!");
+    }
+
+    const std::vector<TraceEvent> events = Events();
+    stream << "{\"traceEvents\":[";
+    stream << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+      const TraceEvent& e = events[i];
+      stream << (i == 0 ? "\n" : ",\n") << "{\"name\":\"" << Escape(e.name)
+          << "\",\"cat\":\"mlpack\",\"ph\":\"X\",\"ts\":"
+          << Microseconds(e.start - Origin()) << ",\"dur\":"
+          << Microseconds(e.end - e.start) << ",\"pid\":1,\"tid\":"
+          << e.thread << ",\"args\":{\"path\":\"" << Escape(e.path)
+          << "\"}}";
+    }
+    stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  }
+
+  /**
+   * Save one row per path of nested scopes, summed over every thread: the
+   * path, the number of calls, the total time and the time not spent in child
+   * scopes, in microseconds.  A std::runtime_error is thrown if the file
+   * cannot be written.
+   */
+  static void SaveCSV(const std::string& filename)
+  {
+    std::ofstream stream(filename);
+    if (!stream.is_open())
+    {
+      throw std::runtime_error("Trace::SaveCSV(): cannot open '" + filename +
+          "' for writing!");
+    }
+
+    struct PathStatistics
+    {
+      size_t calls = 0;
+      double total = 0.0;
+      double children = 0.0;
+    };
+
+    const std::vector<TraceEvent> events = Events();
+    std::map<std::string, PathStatistics> statistics;
+    for (const TraceEvent& e : events)
+    {
+      const double duration = Microseconds(e.end - e.start);
+      PathStatistics& s = statistics[e.path];
+      ++s.calls;
+      s.total += duration;
+      if (e.depth > 0)
+      {
+        const std::string parentPath = e.path.substr(0,
+            e.path.size() - e.name.size() - 1);
+        statistics[parentPath].children += duration;
+      }
+    }
+
+    stream << "path,calls,total_us,self_us\n";
+    stream << std::fixed << std::setprecision(3);
+    for (const std::pair<const std::string, PathStatistics>& it : statistics)
+    {
+      // Skip parents whose own interval has not ended.
+      if (it.second.calls == 0)
+        continue;
+
+      stream << QuoteCSV(it.first) << "," << it.second.calls << ","
+          << it.second.total << ","
+          << std::max(0.0, it.second.total - it.second.children) << "\n";
+    }
+  }
+
+  /**
+   * Save the finished intervals to the given file: as a CSV table if its
+   * extension is ".csv", and as a Chrome trace otherwise.
+   */
+  static void Save(const std::string& filename)
+  {
+    const std::string::size_type dot = filename.rfind('.');
+    std::string extension = (dot == std::string::npos) ? "" :
+        filename.substr(dot + 1);
+    for (char& c : extension)
+      c = (char) std::tolower((unsigned char) c);
+
+    if (extension == "csv")
+      SaveCSV(filename);
+    else
+      SaveChromeTrace(filename);
+  }
+
+ private:
+  //! Get the buffer of the calling thread, registering it the first time.
+  static TraceBuffer& LocalBuffer()
+  {
+    thread_local std::shared_ptr<TraceBuffer> buffer;
+    if (!buffer)
+    {
+      // The registry keeps the buffer alive after the thread exits.
+      buffer = std::make_shared<TraceBuffer>();
+      std::lock_guard<std::mutex> lock(RegistryMutex());
+      buffer->thread = Buffers().size();
+      Buffers().push_back(buffer);
+    }
+
+    return *buffer;
+  }
+
+  //! Get the buffers of every thread that recorded an interval.
+  static std::vector<std::shared_ptr<TraceBuffer>>& Buffers()
+  {
+    static std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    return buffers;
+  }
+
+  //! Get the mutex that guards the list of buffers.
+  static std::mutex& RegistryMutex()
+  {
+    static std::mutex registryMutex;
+    return registryMutex;
+  }
+
+  //! Get the flag that tells whether tracing is enabled.
+  static std::atomic<bool>& EnabledFlag()
+  {
+    static std::atomic<bool> enabled(false);
+    return enabled;
+  }
+
+  //! Get the time that the timestamps of Chrome traces are relative to.
+  static const TraceEvent::Clock::time_point& Origin()
+  {
+    static const TraceEvent::Clock::time_point origin =
+        TraceEvent::Clock::now();
+    return origin;
+  }
+
+  //! Convert a duration to microseconds.
+  static double Microseconds(const TraceEvent::Clock::duration& d)
+  {
+    return std::chrono::duration<double, std::micro>(d).count();
+  }
+
+  //! Escape a string for a JSON string literal.
+  static std::string Escape(const std::string& str)
+  {
+    std::ostringstream oss;
+    for (const char c : str)
+    {
+      if (c == '"' || c == '\\')
+        oss << '\\' << c;
+      else if ((unsigned char) c < 0x20)
+        oss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+            << (int) c << std::dec;
+      else
+        oss << c;
+    }
+    return oss.str();
+  }
+
+  //! Quote a CSV field if it contains a separator or a quote.
+  static std::string QuoteCSV(const std::string& str)
+  {
+    if (str.find_first_of(",\"\n") == std::string::npos)
+      return str;
+
+    std::string quoted = "\"";
+    for (const char c : str)
+    {
+      if (c == '"')
+        quoted += '"';
+      quoted += c;
+    }
+    return quoted + "\"";
+  }
+};
+
+/**
+ * A ScopedTimer records the interval between its construction and its
+ * destruction in the trace of the calling thread, if tracing is enabled (see
+ * Trace).  ScopedTimers that are created while another one is alive on the
+ * same thread are its children.  They take no lock, so they can be used in
+ * the body of parallel loops.
+ *
+ * @code
+ * {
+ *   ScopedTimer t("tree_building");
+ *   ...
+ * } // The interval ends here.
+ * @endcode
+ */
+class ScopedTimer
+{
+ public:
+  //! Open a scope with the given name.
+  ScopedTimer(const std::string& name) : active(Trace::Enabled())
+  {
+    if (active)
+      Trace::Begin(name);
+  }
+
+  //! Close the scope.
+  ~ScopedTimer()
+  {
+    if (active)
+      Trace::End();
+  }
+
+  // A scope cannot be copied.
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  //! Whether the scope was opened.
+  bool active;
+};
+
+} // namespace mlpack
+
+#endif
@@ -281,7 +281,8 @@ class AdaBoost
                 arma::Row<size_t>& predictedLabels) const;
 
   /**
-   * Classify the given test points.
+   * Classify the given test points.  Blocks of points are classified in
+   * parallel, and each weak learner classifies a whole block at once.
    *
    * @param test Testing data.
    * @param predictedLabels Vector in which the predicted labels of the test
@@ -312,6 +313,24 @@ class AdaBoost
                          const WeakLearnerType& wl,
                          WeakLearnerArgs&&... weakLearnerArgs);
 
+  /**
+   * Classify the points test.cols(begin, end - 1) with every weak learner, and
+   * store their predictions and normalized class probabilities in the
+   * corresponding elements of predictedLabels and columns of probabilities
+   * (which must already have the right size).  blockPredictions is used as
+   * scratch space.
+   */
+  void ClassifyBlock(const MatType& test,
+                     const size_t begin,
+                     const size_t end,
+                     arma::Row<size_t>& blockPredictions,
+                     arma::Row<size_t>& predictedLabels,
+                     arma::Mat<ElemType>& probabilities) const;
+
+  //! The number of points classified together by the batch Classify()
+  //! overloads.
+  static constexpr size_t ClassifyBlockSize = 256;
+
   //! The number of classes in the model.
   size_t numClasses;
   //! The maximum number of weak learners allowed in the model.
@@ -237,22 +237,58 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
 {
   probabilities.zeros(numClasses, test.n_cols);
   predictedLabels.set_size(test.n_cols);
+  if (test.n_cols == 0)
+    return;
+
+  // The first block is classified before any threads are started, so that an
+  // error from a weak learner (such as a dimensionality mismatch) is thrown
+  // normally.
+  arma::Row<size_t> blockPredictions;
+  const size_t numBlocks = (test.n_cols + ClassifyBlockSize - 1) /
+      ClassifyBlockSize;
+  ClassifyBlock(test, 0, std::min((size_t) test.n_cols,
+      (size_t) ClassifyBlockSize), blockPredictions, predictedLabels,
+      probabilities);
+
+  #pragma omp parallel for schedule(static) firstprivate(blockPredictions) \
+      num_threads((int) NumThreads())
+  for (size_t b = 1; b < numBlocks; ++b)
+  {
+    const size_t begin = b * ClassifyBlockSize;
+    const size_t end = std::min((size_t) test.n_cols,
+        begin + ClassifyBlockSize);
+    ClassifyBlock(test, begin, end, blockPredictions, predictedLabels,
+        probabilities);
+  }
+}
 
+// Classify a block of test points.
+template<typename WeakLearnerType, typename MatType>
+void AdaBoost<WeakLearnerType, MatType>::ClassifyBlock(
+    const MatType& test,
+    const size_t begin,
+    const size_t end,
+    arma::Row<size_t>& blockPredictions,
+    arma::Row<size_t>& predictedLabels,
+    arma::Mat<typename MatType::elem_type>& probabilities) const
+{
+  // Each weak learner classifies the whole block at once, and its vote is
+  // added to the probabilities of the block.
+  const MatType block = test.cols(begin, end - 1);
   for (size_t i = 0; i < wl.size(); ++i)
   {
-    wl[i].Classify(test, predictedLabels);
+    wl[i].Classify(block, blockPredictions);
 
-    for (size_t j = 0; j < predictedLabels.n_cols; ++j)
-      probabilities(predictedLabels(j), j) += alpha[i];
+    for (size_t j = 0; j < blockPredictions.n_elem; ++j)
+      probabilities(blockPredictions[j], begin + j) += alpha[i];
   }
 
   arma::uword maxIndex = 0;
-
-  for (size_t i = 0; i < predictedLabels.n_cols; ++i)
+  for (size_t j = begin; j < end; ++j)
   {
-    probabilities.col(i) /= accu(probabilities.col(i));
-    probabilities.col(i).max(maxIndex);
-    predictedLabels(i) = maxIndex;
+    probabilities.col(j) /= accu(probabilities.col(j));
+    probabilities.col(j).max(maxIndex);
+    predictedLabels(j) = maxIndex;
   }
 }
 
@@ -437,13 +473,15 @@ typename MatType::elem_type AdaBoost<WeakLearnerType, MatType>::TrainInternal(
 
     w.Classify(tempData, predictedLabels);
 
-    // Now, calculate alpha(t) using ht.
+    // Now, calculate alpha(t) using ht.  The weight of each point is the sum
+    // of its column of D.
+    #pragma omp parallel for reduction(+:rt) num_threads((int) NumThreads())
     for (size_t j = 0; j < D.n_cols; ++j) // instead of D, ht
     {
       if (predictedLabels(j) == labels(j))
-        rt += accu(D.col(j));
+        rt += weights[j];
       else
-        rt -= accu(D.col(j));
+        rt -= weights[j];
     }
 
     if ((i > 0) && (std::abs(rt - crt) < tolerance))
@@ -467,10 +505,12 @@ typename MatType::elem_type AdaBoost<WeakLearnerType, MatType>::TrainInternal(
     alpha.push_back(alphat);
     wl.push_back(w);
 
-    // Now start modifying the weights.
+    // Now start modifying the weights.  Each point's weights and hypothesis
+    // are independent of the others.
+    const ElemType expo = std::exp(alphat);
+    #pragma omp parallel for reduction(+:zt) num_threads((int) NumThreads())
     for (size_t j = 0; j < D.n_cols; ++j)
     {
-      const ElemType expo = std::exp(alphat);
       if (predictedLabels(j) == labels(j))
       {
         for (size_t k = 0; k < D.n_rows; ++k)
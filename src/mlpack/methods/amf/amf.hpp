@@ -97,11 +97,11 @@ class AMF
    * @param H Encoding matrix to output.
    * @param r Rank r of the factorization.
    */
-  template<typename MatType>
+  template<typename MatType, typename FactorMatType = arma::mat>
   double Apply(const MatType& V,
                const size_t r,
-               arma::mat& W,
-               arma::mat& H);
+               FactorMatType& W,
+               FactorMatType& H);
 
   //! Access the termination policy.
   const TerminationPolicyType& TerminationPolicy() const
@@ -133,6 +133,17 @@ typedef AMF<SimpleResidueTermination,
             RandomAcolInitialization<>,
             NMFALSUpdate> NMFALSFactorizer;
 
+/**
+ * ALSFactorizer factorizes a given matrix V, whose nonzero entries are the
+ * observed entries, into two matrices W and H by regularized alternating least
+ * squares.  The rows of W and columns of H are solved in parallel.
+ *
+ * @see ALSUpdate
+ */
+typedef AMF<SimpleResidueTermination,
+            RandomAMFInitialization,
+            ALSUpdate> ALSFactorizer;
+
 //! Convenience typedefs.
 
 /**
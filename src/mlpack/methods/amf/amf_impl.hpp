@@ -39,12 +39,12 @@ AMF<TerminationPolicyType, InitializationRuleType, UpdateRuleType>::AMF(
 template<typename TerminationPolicyType,
          typename InitializationRuleType,
          typename UpdateRuleType>
-template<typename MatType>
+template<typename MatType, typename FactorMatType>
 double AMF<TerminationPolicyType, InitializationRuleType, UpdateRuleType>::
 Apply(const MatType& V,
       const size_t r,
-      arma::mat& W,
-      arma::mat& H)
+      FactorMatType& W,
+      FactorMatType& H)
 {
   // Initialize W and H.
   initializationRule.Initialize(V, r, W, H);
@@ -47,11 +47,11 @@ class RandomAcolInitialization
   RandomAcolInitialization()
   { }
 
-  template<typename MatType>
+  template<typename MatType, typename FactorMatType>
   inline static void Initialize(const MatType& V,
                                 const size_t r,
-                                arma::mat& W,
-                                arma::mat& H)
+                                FactorMatType& W,
+                                FactorMatType& H)
   {
     const size_t n = V.n_rows;
     const size_t m = V.n_cols;
@@ -48,7 +48,8 @@ class MaxIterationTermination
   /**
    * Check if convergence has occurred.
    */
-  bool IsConverged(const arma::mat& /* H */, const arma::mat& /* W */)
+  template<typename FactorMatType>
+  bool IsConverged(const FactorMatType& /* H */, const FactorMatType& /* W */)
   {
     // Return true if we have performed the correct number of iterations.
     return (++iteration >= maxIterations);
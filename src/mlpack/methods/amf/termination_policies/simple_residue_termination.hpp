@@ -72,7 +72,8 @@ class SimpleResidueTermination
    * @param W Basis matrix of output.
    * @param H Encoding matrix of output.
    */
-  bool IsConverged(arma::mat& W, arma::mat& H)
+  template<typename FactorMatType>
+  bool IsConverged(FactorMatType& W, FactorMatType& H)
   {
     // Calculate the norm and compute the residue, but do it by hand, so as to
     // avoid calculating (W*H), which may be very large.
@@ -0,0 +1,270 @@
+/**
+ * @file methods/amf/update_rules/als_update.hpp
+ *
+ * Sparse-aware, parallel alternating least squares update rule for AMF, with
+ * an implicit feedback variant.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_UPDATE_RULES_ALS_UPDATE_HPP
+#define MLPACK_METHODS_AMF_UPDATE_RULES_ALS_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
+
+namespace mlpack {
+
+/**
+ * This class implements regularized alternating least squares for matrices
+ * with missing entries, as used for collaborative filtering.  Only the
+ * nonzero entries of V are treated as observed.  Each update solves, for
+ * every row of W (or column of H), the k x k normal equations built from the
+ * observed entries of that row (or column) only, with a Cholesky
+ * decomposition.  The rows (or columns) are independent, so they are solved
+ * in parallel when OpenMP is available.
+ *
+ * In the default (explicit) mode, the weighted-lambda regularization of the
+ * following paper is used: the regularization of each row of W and column of
+ * H is scaled by its number of observed entries.
+ *
+ * @code
+ * @inproceedings{zhou2008large,
+ *   title={Large-Scale Parallel Collaborative Filtering for the Netflix
+ *       Prize},
+ *   author={Zhou, Y. and Wilkinson, D. and Schreiber, R. and Pan, R.},
+ *   booktitle={Algorithmic Aspects in Information and Management},
+ *   pages={337--348},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * In the implicit mode, each nonzero entry v of V is an observed interaction
+ * with confidence 1 + alpha * v, and every entry of V (including the zeros)
+ * is fitted to a preference of 1 (nonzero) or 0 (zero), as in the following
+ * paper.  The part of the normal equations that comes from the zero entries
+ * is shared by all rows (or columns) and is only computed once per update, so
+ * that each update still only costs time linear in the number of nonzeros.
+ *
+ * @code
+ * @inproceedings{hu2008collaborative,
+ *   title={Collaborative Filtering for Implicit Feedback Datasets},
+ *   author={Hu, Y. and Koren, Y. and Volinsky, C.},
+ *   booktitle={2008 Eighth IEEE International Conference on Data Mining},
+ *   pages={263--272},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Dense matrices are converted to sparse matrices before an update, so zero
+ * entries of a dense matrix are treated as missing too.
+ */
+class ALSUpdate
+{
+ public:
+  /**
+   * Create the ALS update rule with the given parameters.
+   *
+   * @param lambda Regularization parameter.
+   * @param implicit Whether to treat the entries of V as implicit feedback.
+   * @param alpha Confidence scale of the implicit feedback.
+   */
+  ALSUpdate(const double lambda = 0.01,
+            const bool implicit = false,
+            const double alpha = 40.0) :
+      lambda(lambda),
+      implicit(implicit),
+      alpha(alpha)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Set initial values for the factorization.  In this case, we don't need to
+   * set anything.
+   */
+  template<typename MatType>
+  void Initialize(const MatType& /* dataset */, const size_t /* rank */)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * The update rule for the basis matrix W.  Each row of W is set to the
+   * solution of the regularized least squares problem over the observed
+   * entries of the same row of V, with H fixed.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  void WUpdate(const arma::sp_mat& V,
+               arma::mat& W,
+               const arma::mat& H) const
+  {
+    // Transposing V only takes time linear in the number of nonzeros; then the
+    // observed entries of each row of V can be walked as a column.
+    const arma::sp_mat vt = V.t();
+    arma::mat wt;
+    Solve(vt, H, wt);
+    W = wt.t();
+  }
+
+  /**
+   * The update rule for the basis matrix W, for dense matrices.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  void WUpdate(const MatType& V,
+               arma::mat& W,
+               const arma::mat& H) const
+  {
+    WUpdate(arma::sp_mat(V), W, H);
+  }
+
+  /**
+   * The update rule for the encoding matrix H.  Each column of H is set to the
+   * solution of the regularized least squares problem over the observed
+   * entries of the same column of V, with W fixed.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  void HUpdate(const arma::sp_mat& V,
+               const arma::mat& W,
+               arma::mat& H) const
+  {
+    Solve(V, W.t(), H);
+  }
+
+  /**
+   * The update rule for the encoding matrix H, for dense matrices.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  void HUpdate(const MatType& V,
+               const arma::mat& W,
+               arma::mat& H) const
+  {
+    HUpdate(arma::sp_mat(V), W, H);
+  }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get whether the entries are treated as implicit feedback.
+  bool Implicit() const { return implicit; }
+  //! Modify whether the entries are treated as implicit feedback.
+  bool& Implicit() { return implicit; }
+
+  //! Get the confidence scale of the implicit feedback.
+  double Alpha() const { return alpha; }
+  //! Modify the confidence scale of the implicit feedback.
+  double& Alpha() { return alpha; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(lambda));
+    ar(CEREAL_NVP(implicit));
+    ar(CEREAL_NVP(alpha));
+  }
+
+ private:
+  /**
+   * Solve the least squares problem of each column of V: column j of X is set
+   * to the factors that best fit the observed entries of column j of V, given
+   * the fixed factors of each row of V in the columns of Y.
+   *
+   * @param V Matrix whose columns are fitted.
+   * @param Y Fixed factors, one column per row of V.
+   * @param X Set to the fitted factors, one column per column of V.
+   */
+  void Solve(const arma::sp_mat& V, const arma::mat& Y, arma::mat& X) const
+  {
+    const size_t rank = Y.n_rows;
+    X.set_size(rank, V.n_cols);
+
+    // In the implicit mode, all entries contribute Y Y^T to the normal
+    // equations, with a confidence of 1.
+    arma::mat gram;
+    if (implicit)
+      gram = Y * Y.t();
+
+    // The observed entries of each column are read directly from the
+    // compressed columns of V.
+    V.sync();
+
+    #pragma omp parallel for schedule(dynamic, 64) \
+        num_threads((int) NumThreads())
+    for (size_t j = 0; j < V.n_cols; ++j)
+    {
+      const size_t nnz = V.col_ptrs[j + 1] - V.col_ptrs[j];
+      arma::uvec rows(nnz);
+      arma::vec values(nnz);
+      for (size_t i = 0; i < nnz; ++i)
+      {
+        rows[i] = V.row_indices[V.col_ptrs[j] + i];
+        values[i] = V.values[V.col_ptrs[j] + i];
+      }
+
+      // The factors of the observed entries of this column.
+      arma::mat observed = Y.cols(rows);
+      arma::mat a;
+      arma::vec b;
+      if (implicit)
+      {
+        // Solve (Y Y^T + Y_o (C - I) Y_o^T + lambda I) x = Y_o c, where c holds
+        // the confidences of the observed entries.
+        const arma::vec confidence = 1.0 + alpha * values;
+        b = observed * confidence;
+        observed.each_row() %= arma::sqrt(alpha * values).t();
+        a = gram + observed * observed.t();
+        a.diag() += lambda;
+      }
+      else
+      {
+        // Solve (Y_o Y_o^T + lambda n_o I) x = Y_o v.
+        b = observed * values;
+        a = observed * observed.t();
+        a.diag() += lambda * std::max(nnz, (size_t) 1);
+      }
+
+      arma::mat l;
+      if (arma::chol(l, a, "lower"))
+      {
+        X.col(j) = arma::solve(arma::trimatu(l.t()),
+            arma::solve(arma::trimatl(l), b));
+      }
+      else
+      {
+        // Without regularization, a may be singular (for instance, when the
+        // column has fewer observed entries than the rank).
+        X.col(j) = arma::pinv(a) * b;
+      }
+    }
+  }
+
+  //! Regularization parameter.
+  double lambda;
+  //! Whether the entries are treated as implicit feedback.
+  bool implicit;
+  //! Confidence scale of the implicit feedback.
+  double alpha;
+}; // class ALSUpdate
+
+} // namespace mlpack
+
+#endif
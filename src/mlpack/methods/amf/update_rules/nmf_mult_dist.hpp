@@ -34,6 +34,11 @@ namespace mlpack {
  * This is a multiplicative rule that ensures that the Frobenius norm
  * \f$ \sqrt{\sum_i \sum_j(V-WH)^2} \f$ is non-increasing between subsequent
  * iterations. Both of the update rules for W and H are defined in this file.
+ *
+ * The factor matrices W and H may hold single- or double-precision values.
+ * With a sparse V, the zero entries of V are taken as zero values; to only fit
+ * the nonzero (observed) entries of V, as for a rating matrix, use
+ * NMFObservedDistanceUpdate instead.
  */
 class NMFMultiplicativeDistanceUpdate
 {
@@ -52,7 +57,7 @@ class NMFMultiplicativeDistanceUpdate
   }
 
   /**
-   * The update rule for the basis matrix W. The formula used isa
+   * The update rule for the basis matrix W. The formula used is
    *
    * \f[
    * W_{ia} \leftarrow W_{ia} \frac{(VH^T)_{ia}}{(WHH^T)_{ia}}
@@ -65,12 +70,13 @@ class NMFMultiplicativeDistanceUpdate
    * @param W Basis matrix to be updated.
    * @param H Encoding matrix.
    */
-  template<typename MatType>
+  template<typename MatType, typename FactorMatType>
   inline static void WUpdate(const MatType& V,
-                             arma::mat& W,
-                             const arma::mat& H)
+                             FactorMatType& W,
+                             const FactorMatType& H)
   {
-    W = (W % (V * H.t())) / (W * H * H.t());
+    // Computing H H^T first only takes r x r products per row of W.
+    W = (W % (V * H.t())) / (W * (H * H.t()));
   }
 
   /**
@@ -87,12 +93,13 @@ class NMFMultiplicativeDistanceUpdate
    * @param W Basis matrix.
    * @param H Encoding matrix to be updated.
    */
-  template<typename MatType>
+  template<typename MatType, typename FactorMatType>
   inline static void HUpdate(const MatType& V,
-                             const arma::mat& W,
-                             arma::mat& H)
+                             const FactorMatType& W,
+                             FactorMatType& H)
   {
-    H = (H % (W.t() * V)) / (W.t() * W * H);
+    // Computing W^T W first only takes r x r products per column of H.
+    H = (H % (W.t() * V)) / ((W.t() * W) * H);
   }
 
   //! Serialize the object (in this case, there is nothing to serialize).
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_LMF_UPDATE_RULES_NMF_MULT_DIV_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "observed_products.hpp"
 
 namespace mlpack {
 
@@ -40,9 +41,11 @@ namespace mlpack {
  * is non-increasing between subsequent iterations. Both of the update rules
  * for W and H are defined in this file.
  *
- * This set of update rules is not meant to work with sparse matrices.  Using
- * sparse matrices often causes NaNs in the output, so other choices of update
- * rules are better in that situation.
+ * The factor matrices W and H may hold single- or double-precision values.
+ * With a sparse V, the zero entries of V are taken as zero values, and only the
+ * nonzero entries are visited; but zero rows or columns of V often cause NaNs
+ * in the output.  To only fit the nonzero (observed) entries of V, as for a
+ * rating matrix, use NMFObservedDivergenceUpdate instead.
  */
 class NMFMultiplicativeDivergenceUpdate
 {
@@ -69,39 +72,20 @@ class NMFMultiplicativeDivergenceUpdate
    * \f]
    *
    * The function takes in all the matrices and only changes the value of the W
-   * matrix.
+   * matrix.  If V is sparse, (W H)_{i\mu} is only computed where V_{i\mu} is
+   * nonzero, since the other terms of the numerator are zero.
    *
    * @param V Input matrix to be factorized.
    * @param W Basis matrix to be updated.
    * @param H Encoding matrix.
    */
-  template<typename MatType>
+  template<typename MatType, typename FactorMatType>
   inline static void WUpdate(const MatType& V,
-                             arma::mat& W,
-                             const arma::mat& H)
+                             FactorMatType& W,
+                             const FactorMatType& H)
   {
-    // Simple implementation left in the header file.
-    arma::mat t1;
-    arma::rowvec t2;
-
-    t1 = W * H;
-    for (size_t i = 0; i < W.n_rows; ++i)
-    {
-      for (size_t j = 0; j < W.n_cols; ++j)
-      {
-        // Writing this as a single expression does not work as of Armadillo
-        // 3.920.  This should be fixed in a future release, and then the code
-        // below can be fixed.
-        // t2 = H.row(j) % V.row(i) / t1.row(i);
-        t2.set_size(H.n_cols);
-        for (size_t k = 0; k < t2.n_elem; ++k)
-        {
-          t2(k) = H(j, k) * V(i, k) / t1(i, k);
-        }
-
-        W(i, j) = W(i, j) * sum(t2) / sum(H.row(j));
-      }
-    }
+    W %= Quotient(V, W, H) * H.t();
+    W.each_row() /= arma::sum(H, 1).t();
   }
 
   /**
@@ -109,48 +93,48 @@ class NMFMultiplicativeDivergenceUpdate
    *
    * \f[
    * H_{a\mu} \leftarrow H_{a\mu} \frac{\sum_{i} W_{ia} V_{i\mu}/(WH)_{i\mu}}
-   * {\sum_{k} H_{ka}}
+   * {\sum_{k} W_{ka}}
    * \f]
    *
    * The function takes in all the matrices and only changes the value of the H
-   * matrix.
+   * matrix.  If V is sparse, (W H)_{i\mu} is only computed where V_{i\mu} is
+   * nonzero, since the other terms of the numerator are zero.
    *
    * @param V Input matrix to be factorized.
    * @param W Basis matrix.
    * @param H Encoding matrix to updated.
    */
-  template<typename MatType>
+  template<typename MatType, typename FactorMatType>
   inline static void HUpdate(const MatType& V,
-                            const arma::mat& W,
-                            arma::mat& H)
+                             const FactorMatType& W,
+                             FactorMatType& H)
   {
-    // Simple implementation left in the header file.
-    arma::mat t1;
-    arma::colvec t2;
-
-    t1 = W * H;
-    for (size_t i = 0; i < H.n_rows; ++i)
-    {
-      for (size_t j = 0; j < H.n_cols; ++j)
-      {
-        // Writing this as a single expression does not work as of Armadillo
-        // 3.920.  This should be fixed in a future release, and then the code
-        // below can be fixed.
-        // t2 = W.col(i) % V.col(j) / t1.col(j);
-        t2.set_size(W.n_rows);
-        for (size_t k = 0; k < t2.n_elem; ++k)
-        {
-          t2(k) = W(k, i) * V(k, j) / t1(k, j);
-        }
-
-        H(i, j) = H(i, j) * sum(t2) / sum(W.col(i));
-      }
-    }
+    H %= W.t() * Quotient(V, W, H);
+    H.each_col() /= arma::sum(W, 0).t();
   }
 
   //! Serialize the object (in this case, there is nothing to serialize).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
+
+ private:
+  //! Compute V / (W H) elementwise, for a dense V.
+  template<typename eT, typename FactorMatType>
+  static arma::Mat<eT> Quotient(const arma::Mat<eT>& V,
+                                const FactorMatType& W,
+                                const FactorMatType& H)
+  {
+    return V / (W * H);
+  }
+
+  //! Compute V / (W H) at the nonzero entries of a sparse V.
+  template<typename eT, typename FactorMatType>
+  static arma::SpMat<eT> Quotient(const arma::SpMat<eT>& V,
+                                  const FactorMatType& W,
+                                  const FactorMatType& H)
+  {
+    return ObservedProducts(V, W, H, true);
+  }
 };
 
 } // namespace mlpack
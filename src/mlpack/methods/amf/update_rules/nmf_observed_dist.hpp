@@ -0,0 +1,119 @@
+/**
+ * @file methods/amf/update_rules/nmf_observed_dist.hpp
+ *
+ * Multiplicative distance update rules for the Non-negative Matrix
+ * Factorization of the observed entries of a sparse matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_UPDATE_RULES_NMF_OBSERVED_DIST_HPP
+#define MLPACK_METHODS_AMF_UPDATE_RULES_NMF_OBSERVED_DIST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "observed_products.hpp"
+
+namespace mlpack {
+
+/**
+ * The multiplicative distance update rules for matrices W and H, restricted to
+ * the nonzero (observed) entries of a sparse matrix V.  This is the weighted
+ * version of the rules of NMFMultiplicativeDistanceUpdate (Lee and Seung,
+ * 2001), with weight 1 for the observed entries and 0 for the others, so that
+ * the squared error
+ *
+ * \f[
+ * \sum_{(i, j) : V_{ij} \ne 0} (V_{ij} - (W H)_{ij})^2
+ * \f]
+ *
+ * is non-increasing between subsequent iterations.  The zero entries of V are
+ * taken as missing values, and not as zeros, so this is suited to rating
+ * matrices, as in collaborative filtering.
+ *
+ * (W H)_{ij} is only computed at the nonzero entries of V, in parallel over the
+ * columns of V with OpenMP, so each iteration takes O(nnz(V) r + (n + m) r^2)
+ * time instead of the O(n m r) time of the dense rules.  The factor matrices W
+ * and H may hold single- or double-precision values, of the same type as V.
+ * The entries of W and H for rows or columns of V with no nonzero entries are
+ * left unchanged.
+ */
+class NMFObservedDistanceUpdate
+{
+ public:
+  // Empty constructor required for the UpdateRule template.
+  NMFObservedDistanceUpdate() { }
+
+  /**
+   * Initialize the factorization.  These update rules hold no information, so
+   * the input parameters are ignored.
+   */
+  template<typename MatType>
+  void Initialize(const MatType& /* dataset */, const size_t /* rank */)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * The update rule for the basis matrix W.  With P the matrix that holds
+   * (W H)_{ij} at the nonzero entries of V and zeros elsewhere, the formula
+   * used is
+   *
+   * \f[
+   * W_{ia} \leftarrow W_{ia} \frac{(V H^T)_{ia}}{(P H^T)_{ia}}
+   * \f]
+   *
+   * The function takes in all the matrices and only changes the value of the W
+   * matrix.
+   *
+   * @param V Sparse input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename eT, typename FactorMatType>
+  inline static void WUpdate(const arma::SpMat<eT>& V,
+                             FactorMatType& W,
+                             const FactorMatType& H)
+  {
+    const arma::SpMat<eT> products = ObservedProducts(V, W, H);
+    const FactorMatType numerator = V * H.t();
+    const FactorMatType denominator = products * H.t();
+    ObservedMultiplicativeStep(W, numerator, denominator);
+  }
+
+  /**
+   * The update rule for the encoding matrix H.  With P the matrix that holds
+   * (W H)_{ij} at the nonzero entries of V and zeros elsewhere, the formula
+   * used is
+   *
+   * \f[
+   * H_{a\mu} \leftarrow H_{a\mu} \frac{(W^T V)_{a\mu}}{(W^T P)_{a\mu}}
+   * \f]
+   *
+   * The function takes in all the matrices and only changes the value of the H
+   * matrix.
+   *
+   * @param V Sparse input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename eT, typename FactorMatType>
+  inline static void HUpdate(const arma::SpMat<eT>& V,
+                             const FactorMatType& W,
+                             FactorMatType& H)
+  {
+    const arma::SpMat<eT> products = ObservedProducts(V, W, H);
+    const FactorMatType numerator = W.t() * V;
+    const FactorMatType denominator = W.t() * products;
+    ObservedMultiplicativeStep(H, numerator, denominator);
+  }
+
+  //! Serialize the object (in this case, there is nothing to serialize).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const uint32_t /* version */) { }
+};
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,83 @@
+/**
+ * @file methods/amf/update_rules/observed_products.hpp
+ *
+ * Computation of the entries of W * H at the nonzero entries of a sparse
+ * matrix, and other utilities for the multiplicative update rules.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_UPDATE_RULES_OBSERVED_PRODUCTS_HPP
+#define MLPACK_METHODS_AMF_UPDATE_RULES_OBSERVED_PRODUCTS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
+
+namespace mlpack {
+
+/**
+ * Compute (W H)_ij at each nonzero entry (i, j) of the sparse matrix V, and
+ * return the sparse matrix with the same nonzero pattern as V that holds these
+ * values, or, if quotient is true, the values V_ij / (W H)_ij.  Only the
+ * nonzero entries are computed, in parallel over the columns of V, so this
+ * takes O(nnz(V) r) time instead of the O(n m r) time of the dense product.
+ *
+ * @param V Sparse input matrix.
+ * @param W Basis matrix.
+ * @param H Encoding matrix.
+ * @param quotient If true, divide the entries of V by the products.
+ */
+template<typename eT, typename FactorMatType>
+arma::SpMat<eT> ObservedProducts(const arma::SpMat<eT>& V,
+                                 const FactorMatType& W,
+                                 const FactorMatType& H,
+                                 const bool quotient = false)
+{
+  V.sync();
+
+  // The rows of W are accessed contiguously as the columns of its transpose.
+  const FactorMatType wt = W.t();
+
+  arma::Col<eT> values(V.n_nonzero);
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t j = 0; j < (size_t) V.n_cols; ++j)
+  {
+    for (size_t k = V.col_ptrs[j]; k < V.col_ptrs[j + 1]; ++k)
+    {
+      const eT product = (eT) arma::dot(wt.col(V.row_indices[k]), H.col(j));
+      values[k] = quotient ? V.values[k] / product : product;
+    }
+  }
+
+  const arma::uvec rowIndices(V.row_indices, V.n_nonzero);
+  const arma::uvec colPtrs(V.col_ptrs, V.n_cols + 1);
+  return arma::SpMat<eT>(rowIndices, colPtrs, values, V.n_rows, V.n_cols);
+}
+
+/**
+ * Multiply each entry of X by the ratio of the corresponding entries of the
+ * numerator and denominator, leaving the entries with a zero denominator
+ * unchanged (these belong to rows or columns of V with no nonzero entries).
+ *
+ * @param X Factor matrix to be updated.
+ * @param numerator Numerator of the multiplicative update.
+ * @param denominator Denominator of the multiplicative update.
+ */
+template<typename FactorMatType>
+void ObservedMultiplicativeStep(FactorMatType& X,
+                                const FactorMatType& numerator,
+                                const FactorMatType& denominator)
+{
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t i = 0; i < (size_t) X.n_elem; ++i)
+  {
+    if (denominator[i] > 0)
+      X[i] *= numerator[i] / denominator[i];
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -14,7 +14,10 @@
 
 #include "nmf_mult_dist.hpp"
 #include "nmf_mult_div.hpp"
+#include "nmf_observed_dist.hpp"
+#include "nmf_observed_div.hpp"
 #include "nmf_als.hpp"
+#include "als_update.hpp"
 #include "svd_batch_learning.hpp"
 #include "svd_incomplete_incremental_learning.hpp"
 #include "svd_complete_incremental_learning.hpp"
@@ -74,7 +74,7 @@ class IdentityFunction
   template<typename InputVecType, typename OutputVecType, typename DerivVecType>
   static void Deriv(const InputVecType& x, const OutputVecType& /* y */, DerivVecType& dy)
   {
-    dy.ones(arma::size(x));
+    dy.ones(size(x));
   }
 
   /**
@@ -105,7 +105,7 @@ class LogisticFunction
   template<typename InputVecType, typename OutputVecType>
   static void Inv(const InputVecType& y, OutputVecType& x)
   {
-    x = arma::trunc_log(y / (1 - y));
+    x = trunc_log(y / (1 - y));
   }
 }; // class LogisticFunction
 
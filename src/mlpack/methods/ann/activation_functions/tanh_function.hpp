@@ -48,7 +48,7 @@ class TanhFunction
   template<typename InputVecType, typename OutputVecType>
   static void Fn(const InputVecType& x, OutputVecType& y)
   {
-    y = arma::tanh(x);
+    y = tanh(x);
   }
 
   /**
@@ -98,7 +98,7 @@ class TanhFunction
   template<typename InputVecType, typename OutputVecType>
   static void Inv(const InputVecType& y, OutputVecType& x)
   {
-    x = arma::atanh(y);
+    x = atanh(y);
   }
 }; // class TanhFunction
 
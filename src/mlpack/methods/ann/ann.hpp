@@ -29,6 +29,9 @@
 #include "regularizer/regularizer.hpp"
 
 #include "ffn.hpp"
+#include "static_ffn.hpp"
 #include "rnn.hpp"
+#include "brnn.hpp"
+#include "rbm/rbm.hpp"
 
 #endif
@@ -0,0 +1,558 @@
+/**
+ * @file methods/ann/brnn.hpp
+ *
+ * Definition of the BRNN class, which implements bidirectional recurrent
+ * neural networks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_BRNN_HPP
+#define MLPACK_METHODS_ANN_BRNN_HPP
+
+#include <mlpack/core.hpp>
+
+#include "init_rules/init_rules.hpp"
+#include "layer/layer.hpp"
+#include "loss_functions/loss_functions.hpp"
+#include "packed_sequences.hpp"
+
+#include <ensmallen.hpp>
+
+namespace mlpack {
+
+/**
+ * Definition of a bidirectional recurrent neural network container.  A
+ * bidirectional network holds two stacks of layers with the same structure
+ * (but different weights): the forward stack is passed the steps of each
+ * sequence in order, and the backward stack is passed them in reverse order.
+ * At each step, the outputs of the two stacks are merged (concatenated or
+ * summed), and passed through the merge layers, which are not recurrent.  So,
+ * the output at each step depends on the whole sequence.
+ *
+ * As for `RNN`, the data is given as cubes where each column is a sequence and
+ * each slice is a time step; if the responses have only one slice, the
+ * response of each sequence is used for each of its steps.  Sequences of
+ * different lengths can be given with their lengths to `Train()` and
+ * `Predict()`; the sequences of each batch are then packed (see
+ * `PackedSequences`), the backward stack is passed each sequence from its own
+ * last step, and the slices after the end of a sequence are ignored (the
+ * predictions for them are zero).  The merge layers are applied to all the
+ * steps of a batch at once.
+ *
+ * Layers added with `Add()` are added to both stacks, so several recurrent
+ * layers (e.g. `LSTM`) can be stacked in each direction; layers added with
+ * `AddMerge()` are applied to the merged outputs.  An example of a
+ * bidirectional LSTM classifier is shown below:
+ *
+ * @code
+ * // Two stacked LSTM layers of 10 units in each direction, whose outputs are
+ * // concatenated and passed to a linear layer and a softmax.
+ * BRNN<> model;
+ * model.Add<LSTM>(10);
+ * model.Add<LSTM>(10);
+ * model.AddMerge<Linear>(numClasses);
+ * model.AddMerge<LogSoftMax>();
+ *
+ * model.Train(predictors, responses, sequenceLengths);
+ * @endcode
+ *
+ * Backpropagation through time is done over the whole sequences.
+ *
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ * @tparam InitializationRuleType Rule used to initialize the weight matrix.
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<
+    typename OutputLayerType = NegativeLogLikelihood,
+    typename InitializationRuleType = RandomInitialization,
+    typename MatType = arma::mat>
+class BRNN
+{
+ public:
+  /**
+   * Create the BRNN object.
+   *
+   * If you want to pass in a parameter and discard the original parameter
+   * object, be sure to use std::move to avoid unnecessary copy.
+   *
+   * @param sumMerge If true, the outputs of the two directions are summed;
+   *      otherwise, they are concatenated.
+   * @param outputLayer Output layer used to evaluate the network.
+   * @param initializeRule Optional instantiated InitializationRule object
+   *        for initializing the network parameter.
+   */
+  BRNN(const bool sumMerge = false,
+       OutputLayerType outputLayer = OutputLayerType(),
+       InitializationRuleType initializeRule = InitializationRuleType());
+
+  //! Copy constructor.
+  BRNN(const BRNN&);
+  //! Move constructor.
+  BRNN(BRNN&&);
+  //! Copy operator.
+  BRNN& operator=(const BRNN&);
+  //! Move assignment operator.
+  BRNN& operator=(BRNN&&);
+
+  /**
+   * Add a new layer to both directions of the model.
+   *
+   * @param args The layer parameter.
+   */
+  template <typename LayerType, typename... Args>
+  void Add(Args... args)
+  {
+    forwardNetwork.template Add<LayerType>(args...);
+    backwardNetwork.template Add<LayerType>(args...);
+    inputDimensionsAreSet = false;
+  }
+
+  /**
+   * Add a new layer to both directions of the model; the backward direction
+   * gets a copy of the layer.
+   *
+   * @param layer The Layer to be added to the model.
+   */
+  void Add(Layer<MatType>* layer)
+  {
+    backwardNetwork.Add(layer->Clone());
+    forwardNetwork.Add(layer);
+    inputDimensionsAreSet = false;
+  }
+
+  /**
+   * Add a new layer after the merge of the two directions.
+   *
+   * @param args The layer parameter.
+   */
+  template <typename LayerType, typename... Args>
+  void AddMerge(Args... args)
+  {
+    mergeNetwork.template Add<LayerType>(args...);
+    inputDimensionsAreSet = false;
+  }
+
+  /**
+   * Add a new layer after the merge of the two directions.
+   *
+   * @param layer The Layer to be added to the model.
+   */
+  void AddMerge(Layer<MatType>* layer)
+  {
+    mergeNetwork.Add(layer);
+    inputDimensionsAreSet = false;
+  }
+
+  //! Get the layers of the forward direction.
+  const std::vector<Layer<MatType>*>& ForwardNetwork() const
+  {
+    return forwardNetwork.Network();
+  }
+  //! Get the layers of the backward direction.
+  const std::vector<Layer<MatType>*>& BackwardNetwork() const
+  {
+    return backwardNetwork.Network();
+  }
+  //! Get the layers applied after the merge.
+  const std::vector<Layer<MatType>*>& MergeNetwork() const
+  {
+    return mergeNetwork.Network();
+  }
+
+  /**
+   * Train the bidirectional network on the given input data using the given
+   * optimizer.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization. If this is not what you want, then you should access the
+   * parameters vector directly with Parameters() and modify it as desired.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  typename MatType::elem_type Train(
+      arma::Cube<typename MatType::elem_type> predictors,
+      arma::Cube<typename MatType::elem_type> responses,
+      OptimizerType& optimizer,
+      CallbackTypes&&... callbacks);
+
+  /**
+   * Train the bidirectional network on the given input data.  By default, the
+   * RMSProp optimization algorithm is used, but others can be specified (such
+   * as ens::SGD).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::RMSProp, typename... CallbackTypes>
+  typename MatType::elem_type Train(
+      arma::Cube<typename MatType::elem_type> predictors,
+      arma::Cube<typename MatType::elem_type> responses,
+      CallbackTypes&&... callbacks);
+
+  /**
+   * Train the bidirectional network on sequences of different lengths using
+   * the given optimizer.  Sequence `i` has `sequenceLengths[i]` steps, and the
+   * slices of `predictors` and `responses` after its end are ignored.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param sequenceLengths Length of each sequence (between 1 and
+   *      `predictors.n_slices`).
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  typename MatType::elem_type Train(
+      arma::Cube<typename MatType::elem_type> predictors,
+      arma::Cube<typename MatType::elem_type> responses,
+      arma::urowvec sequenceLengths,
+      OptimizerType& optimizer,
+      CallbackTypes&&... callbacks);
+
+  /**
+   * Train the bidirectional network on sequences of different lengths.  By
+   * default, the RMSProp optimization algorithm is used.  Sequence `i` has
+   * `sequenceLengths[i]` steps, and the slices of `predictors` and `responses`
+   * after its end are ignored.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param sequenceLengths Length of each sequence (between 1 and
+   *      `predictors.n_slices`).
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::RMSProp, typename... CallbackTypes>
+  typename MatType::elem_type Train(
+      arma::Cube<typename MatType::elem_type> predictors,
+      arma::Cube<typename MatType::elem_type> responses,
+      arma::urowvec sequenceLengths,
+      CallbackTypes&&... callbacks);
+
+  /**
+   * Predict the responses to a given set of predictors.
+   *
+   * @param predictors Input predictors.
+   * @param results Cube to put output predictions of responses into.
+   * @param batchSize Batch size to use for prediction.
+   */
+  void Predict(const arma::Cube<typename MatType::elem_type>& predictors,
+               arma::Cube<typename MatType::elem_type>& results,
+               const size_t batchSize = 128);
+
+  /**
+   * Predict the responses to sequences of different lengths.  Sequence `i`
+   * has `sequenceLengths[i]` steps; the predictions for the slices after its
+   * end are zero.
+   *
+   * @param predictors Input predictors.
+   * @param results Cube to put output predictions of responses into.
+   * @param sequenceLengths Length of each sequence (between 1 and
+   *      `predictors.n_slices`).
+   * @param batchSize Batch size to use for prediction.
+   */
+  void Predict(const arma::Cube<typename MatType::elem_type>& predictors,
+               arma::Cube<typename MatType::elem_type>& results,
+               const arma::urowvec& sequenceLengths,
+               const size_t batchSize = 128);
+
+  //! Return the number of weights in the model.
+  size_t WeightSize() const
+  {
+    return forwardNetwork.WeightSize() + backwardNetwork.WeightSize() +
+        mergeNetwork.WeightSize();
+  }
+
+  //! Get the logical dimensions of the input.
+  const std::vector<size_t>& InputDimensions() const { return inputDimensions; }
+  //! Modify the logical dimensions of the input (see `FFN::InputDimensions()`).
+  std::vector<size_t>& InputDimensions()
+  {
+    inputDimensionsAreSet = false;
+    return inputDimensions;
+  }
+
+  //! Return the initial point for the optimization.
+  const MatType& Parameters() const { return parameters; }
+  //! Modify the initial point for the optimization.
+  MatType& Parameters() { return parameters; }
+
+  /**
+   * Reset the stored data of the network entirely.  This reset all weights of
+   * each layer using `InitializationRuleType`, and prepares the network to
+   * accept a (flat 1-d) input size of `inputDimensionality` (if passed), or
+   * whatever input size has been set with `InputDimensions()`.
+   */
+  void Reset(const size_t inputDimensionality = 0);
+
+  /**
+   * Set all the layers in the network to training mode, if `training` is
+   * `true`, or set all the layers in the network to testing mode, if `training`
+   * is `false`.
+   */
+  void SetNetworkMode(const bool training);
+
+  /**
+   * Evaluate the bidirectional network with the given predictors and
+   * responses.
+   *
+   * @param predictors Input variables.
+   * @param responses Target outputs for input variables.
+   */
+  typename MatType::elem_type Evaluate(
+      const arma::Cube<typename MatType::elem_type>& predictors,
+      const arma::Cube<typename MatType::elem_type>& responses);
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+  //
+  // Only ensmallen utility functions for training are found below here.
+  // They generally aren't useful otherwise.
+  //
+
+  /**
+   * Evaluate the bidirectional network with the given parameters, but using
+   * only a number of data points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  typename MatType::elem_type Evaluate(const MatType& parameters,
+                                       const size_t begin,
+                                       const size_t batchSize);
+
+  /**
+   * Evaluate the bidirectional network and its gradient with the given
+   * parameters, using all the data points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param gradient Matrix to output gradient into.
+   */
+  template<typename GradType>
+  typename MatType::elem_type EvaluateWithGradient(const MatType& parameters,
+                                                   GradType& gradient);
+
+  /**
+   * Evaluate the bidirectional network and its gradient with the given
+   * parameters, but using only a number of data points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  template<typename GradType>
+  typename MatType::elem_type EvaluateWithGradient(const MatType& parameters,
+                                                   const size_t begin,
+                                                   GradType& gradient,
+                                                   const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the bidirectional network with the given
+   * parameters, and with respect to only a number of points in the dataset.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  template<typename GradType>
+  void Gradient(const MatType& parameters,
+                const size_t begin,
+                GradType& gradient,
+                const size_t batchSize);
+
+  //! Return the number of separable functions (the number of predictor points).
+  size_t NumFunctions() const { return predictors.n_cols; }
+
+  //! Shuffle the order of function visitation.  (This is equivalent to
+  //! shuffling the dataset during training.)
+  void Shuffle();
+
+  /**
+   * Prepare the network for the given data.
+   * This function won't actually trigger training process.
+   *
+   * @param predictors Input data variables.
+   * @param responses Outputs results from input data variables.
+   * @param sequenceLengths Length of each sequence, or an empty vector if each
+   *     sequence has `predictors.n_slices` steps.
+   */
+  void ResetData(arma::Cube<typename MatType::elem_type> predictors,
+                 arma::Cube<typename MatType::elem_type> responses,
+                 arma::urowvec sequenceLengths = arma::urowvec());
+
+ private:
+  // Helper functions.
+
+  /**
+   * Ensure that the dimensions and the parameters of the network are valid,
+   * and that each layer points at the right memory.
+   */
+  void CheckNetwork(const std::string& functionName,
+                    const size_t inputDimensionality,
+                    const bool setMode = false,
+                    const bool training = false);
+
+  //! Use the InitializationPolicy to initialize all the weights in the network.
+  void InitializeWeights();
+
+  /**
+   * Pass the given batch through both directions and the merge layers, and
+   * store the outputs of each step in `networkOutputs` (packed as for
+   * `batch`).  If `keepSteps` is true, the recurrent layers keep the state of
+   * every step for a backward pass.
+   */
+  void Forward(const arma::Cube<typename MatType::elem_type>& predictors,
+               const PackedSequences<MatType>& batch,
+               const bool keepSteps);
+
+  /**
+   * Compute the loss of the outputs in `networkOutputs` for the given batch of
+   * responses, summed over the steps.  If `errors` is not NULL, the errors of
+   * the outputs are stored in it.
+   */
+  typename MatType::elem_type Loss(
+      const arma::Cube<typename MatType::elem_type>& responses,
+      const PackedSequences<MatType>& batch,
+      MatType* errors);
+
+  /**
+   * Pass the given packed inputs through the layers of one direction, step by
+   * step, and store the output of each step in `outputs`.
+   */
+  void SequenceForward(MultiLayer<MatType>& network,
+                       const PackedSequences<MatType>& batch,
+                       const MatType& inputs,
+                       MatType& outputs,
+                       const bool keepSteps);
+
+  /**
+   * Backpropagate the given errors of the outputs of one direction through
+   * the steps, and store the gradient of the parameters of the direction in
+   * `gradient`.  The states of every step must have been kept by
+   * `SequenceForward()`.
+   */
+  void SequenceBackward(MultiLayer<MatType>& network,
+                        const PackedSequences<MatType>& batch,
+                        const MatType& inputs,
+                        const MatType& outputs,
+                        const MatType& errors,
+                        MatType& gradient);
+
+  //! Reset the recurrent state of the recurrent layers of `network`.
+  static void ResetMemoryState(MultiLayer<MatType>& network,
+                               const size_t memorySize,
+                               const size_t batchSize);
+  //! Set the previous and current step indices and the offset of the current
+  //! step of the recurrent layers of `network`.
+  static void SetSteps(MultiLayer<MatType>& network,
+                       const size_t previousStep,
+                       const size_t currentStep,
+                       const size_t offset);
+
+  /**
+   * Check if the optimizer has MaxIterations() parameter, if it does then check
+   * if its value is less than the number of datapoints in the dataset.
+   */
+  template<typename OptimizerType>
+  typename std::enable_if<
+      ens::traits::HasMaxIterationsSignature<OptimizerType>::value, void
+  >::type
+  WarnMessageMaxIterations(OptimizerType& optimizer, size_t samples) const;
+
+  //! Check if the optimizer has MaxIterations() parameter; if it doesn't then
+  //! simply return from the function.
+  template<typename OptimizerType>
+  typename std::enable_if<
+      !ens::traits::HasMaxIterationsSignature<OptimizerType>::value, void
+  >::type
+  WarnMessageMaxIterations(OptimizerType& optimizer, size_t samples) const;
+
+  //! Whether the outputs of the two directions are summed (or concatenated).
+  bool sumMerge;
+
+  //! Instantiated output layer used to evaluate the network.
+  OutputLayerType outputLayer;
+  //! Instantiated InitializationRule object for initializing the network
+  //! parameter.
+  InitializationRuleType initializeRule;
+
+  //! The layers of the forward direction.
+  MultiLayer<MatType> forwardNetwork;
+  //! The layers of the backward direction.
+  MultiLayer<MatType> backwardNetwork;
+  //! The layers applied to the merged outputs of the two directions.
+  MultiLayer<MatType> mergeNetwork;
+
+  //! Parameters of the forward direction, the backward direction, and the
+  //! merge layers (in that order); the layers alias this matrix.
+  MatType parameters;
+
+  //! Dimensions of input data.
+  std::vector<size_t> inputDimensions;
+
+  //! The training sequences.  This member is empty, except during training.
+  arma::Cube<typename MatType::elem_type> predictors;
+  //! The responses to the training sequences.  This member is empty, except
+  //! during training.
+  arma::Cube<typename MatType::elem_type> responses;
+  //! The length of each training sequence, or an empty vector if each sequence
+  //! has `predictors.n_slices` steps.
+  arma::urowvec sequenceLengths;
+
+  //! Locally-stored packed inputs of the forward and backward directions.
+  MatType forwardInputs, backwardInputs;
+  //! Locally-stored packed outputs of the forward and backward directions.
+  MatType forwardOutputs, backwardOutputs;
+  //! Locally-stored packed merged outputs of the two directions.
+  MatType mergedOutputs;
+  //! Locally-stored packed outputs of the network.
+  MatType networkOutputs;
+
+  //! If true, each layer has its memory properly set for a forward/backward
+  //! pass.
+  bool layerMemoryIsSet;
+  //! If true, each layer has its inputDimensions properly set.
+  bool inputDimensionsAreSet;
+}; // class BRNN
+
+} // namespace mlpack
+
+// Include implementation.
+#include "brnn_impl.hpp"
+
+#endif
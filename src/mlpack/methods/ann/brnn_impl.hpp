@@ -0,0 +1,854 @@
+/**
+ * @file methods/ann/brnn_impl.hpp
+ *
+ * Implementation of the BRNN class, which implements bidirectional recurrent
+ * neural networks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_BRNN_IMPL_HPP
+#define MLPACK_METHODS_ANN_BRNN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "brnn.hpp"
+#include "layer/recurrent_layer.hpp"
+
+namespace mlpack {
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+BRNN<OutputLayerType, InitializationRuleType, MatType>::BRNN(
+    const bool sumMerge,
+    OutputLayerType outputLayer,
+    InitializationRuleType initializeRule) :
+    sumMerge(sumMerge),
+    outputLayer(std::move(outputLayer)),
+    initializeRule(std::move(initializeRule)),
+    layerMemoryIsSet(false),
+    inputDimensionsAreSet(false)
+{
+  // Nothing to do here.
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+BRNN<OutputLayerType, InitializationRuleType, MatType>::BRNN(
+    const BRNN& other) :
+    sumMerge(other.sumMerge),
+    outputLayer(other.outputLayer),
+    initializeRule(other.initializeRule),
+    forwardNetwork(other.forwardNetwork),
+    backwardNetwork(other.backwardNetwork),
+    mergeNetwork(other.mergeNetwork),
+    parameters(other.parameters),
+    inputDimensions(other.inputDimensions),
+    // These will be set correctly in the first Forward() call.
+    layerMemoryIsSet(false),
+    inputDimensionsAreSet(false)
+{
+  // Nothing else to do.
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+BRNN<OutputLayerType, InitializationRuleType, MatType>::BRNN(BRNN&& other) :
+    sumMerge(other.sumMerge),
+    outputLayer(std::move(other.outputLayer)),
+    initializeRule(std::move(other.initializeRule)),
+    forwardNetwork(std::move(other.forwardNetwork)),
+    backwardNetwork(std::move(other.backwardNetwork)),
+    mergeNetwork(std::move(other.mergeNetwork)),
+    parameters(std::move(other.parameters)),
+    inputDimensions(std::move(other.inputDimensions)),
+    // Aliases will not be correct after a std::move(), so we will manually
+    // reset them.
+    layerMemoryIsSet(false),
+    inputDimensionsAreSet(other.inputDimensionsAreSet)
+{
+  // Nothing else to do.
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+BRNN<OutputLayerType, InitializationRuleType, MatType>&
+BRNN<OutputLayerType, InitializationRuleType, MatType>::operator=(
+    const BRNN& other)
+{
+  if (this != &other)
+  {
+    sumMerge = other.sumMerge;
+    outputLayer = other.outputLayer;
+    initializeRule = other.initializeRule;
+    forwardNetwork = other.forwardNetwork;
+    backwardNetwork = other.backwardNetwork;
+    mergeNetwork = other.mergeNetwork;
+    parameters = other.parameters;
+    inputDimensions = other.inputDimensions;
+    predictors.clear();
+    responses.clear();
+    sequenceLengths.clear();
+    layerMemoryIsSet = false;
+    inputDimensionsAreSet = false;
+  }
+
+  return *this;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+BRNN<OutputLayerType, InitializationRuleType, MatType>&
+BRNN<OutputLayerType, InitializationRuleType, MatType>::operator=(
+    BRNN&& other)
+{
+  if (this != &other)
+  {
+    sumMerge = other.sumMerge;
+    outputLayer = std::move(other.outputLayer);
+    initializeRule = std::move(other.initializeRule);
+    forwardNetwork = std::move(other.forwardNetwork);
+    backwardNetwork = std::move(other.backwardNetwork);
+    mergeNetwork = std::move(other.mergeNetwork);
+    parameters = std::move(other.parameters);
+    inputDimensions = std::move(other.inputDimensions);
+    predictors.clear();
+    responses.clear();
+    sequenceLengths.clear();
+    layerMemoryIsSet = false;
+    inputDimensionsAreSet = other.inputDimensionsAreSet;
+  }
+
+  return *this;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type
+BRNN<OutputLayerType, InitializationRuleType, MatType>::Train(
+    arma::Cube<typename MatType::elem_type> predictors,
+    arma::Cube<typename MatType::elem_type> responses,
+    OptimizerType& optimizer,
+    CallbackTypes&&... callbacks)
+{
+  return Train(std::move(predictors), std::move(responses), arma::urowvec(),
+      optimizer, callbacks...);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type
+BRNN<OutputLayerType, InitializationRuleType, MatType>::Train(
+    arma::Cube<typename MatType::elem_type> predictors,
+    arma::Cube<typename MatType::elem_type> responses,
+    CallbackTypes&&... callbacks)
+{
+  OptimizerType optimizer;
+  return Train(std::move(predictors), std::move(responses), arma::urowvec(),
+      optimizer, callbacks...);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type
+BRNN<OutputLayerType, InitializationRuleType, MatType>::Train(
+    arma::Cube<typename MatType::elem_type> predictors,
+    arma::Cube<typename MatType::elem_type> responses,
+    arma::urowvec sequenceLengths,
+    OptimizerType& optimizer,
+    CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses),
+      std::move(sequenceLengths));
+
+  WarnMessageMaxIterations(optimizer, this->predictors.n_cols);
+
+  // Ensure that the network can be used.
+  CheckNetwork("BRNN::Train()", this->predictors.n_rows, true, true);
+
+  // Train the model.
+  Timer::Start("brnn_optimization");
+  const typename MatType::elem_type out =
+      optimizer.Optimize(*this, parameters, callbacks...);
+  Timer::Stop("brnn_optimization");
+
+  Log::Info << "BRNN::Train(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type
+BRNN<OutputLayerType, InitializationRuleType, MatType>::Train(
+    arma::Cube<typename MatType::elem_type> predictors,
+    arma::Cube<typename MatType::elem_type> responses,
+    arma::urowvec sequenceLengths,
+    CallbackTypes&&... callbacks)
+{
+  OptimizerType optimizer;
+  return Train(std::move(predictors), std::move(responses),
+      std::move(sequenceLengths), optimizer, callbacks...);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::Predict(
+    const arma::Cube<typename MatType::elem_type>& predictors,
+    arma::Cube<typename MatType::elem_type>& results,
+    const size_t batchSize)
+{
+  Predict(predictors, results, arma::urowvec(), batchSize);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::Predict(
+    const arma::Cube<typename MatType::elem_type>& predictors,
+    arma::Cube<typename MatType::elem_type>& results,
+    const arma::urowvec& sequenceLengths,
+    const size_t batchSize)
+{
+  // Ensure that the network is configured correctly.
+  CheckNetwork("BRNN::Predict()", predictors.n_rows, true, false);
+  PackedSequences<MatType>::CheckLengths(sequenceLengths, predictors.n_cols,
+      predictors.n_slices, "BRNN::Predict()");
+
+  const size_t outputSize = (mergeNetwork.Network().size() > 0) ?
+      mergeNetwork.OutputSize() :
+      (sumMerge ? 1 : 2) * forwardNetwork.OutputSize();
+  results.set_size(outputSize, predictors.n_cols, predictors.n_slices);
+
+  PackedSequences<MatType> batch;
+  for (size_t i = 0; i < predictors.n_cols; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols) - i);
+
+    batch.Reset(sequenceLengths, predictors.n_slices, i, effectiveBatchSize);
+    Forward(predictors, batch, false);
+    batch.Unpack(networkOutputs, results);
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::Reset(
+    const size_t inputDimensionality)
+{
+  parameters.clear();
+  inputDimensionsAreSet = false;
+  CheckNetwork("BRNN::Reset()", inputDimensionality, true, false);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::SetNetworkMode(
+    const bool training)
+{
+  forwardNetwork.Training() = training;
+  backwardNetwork.Training() = training;
+  mergeNetwork.Training() = training;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type
+BRNN<OutputLayerType, InitializationRuleType, MatType>::Evaluate(
+    const arma::Cube<typename MatType::elem_type>& predictors,
+    const arma::Cube<typename MatType::elem_type>& responses)
+{
+  CheckNetwork("BRNN::Evaluate()", predictors.n_rows, true, false);
+
+  PackedSequences<MatType> batch;
+  batch.Reset(arma::urowvec(), predictors.n_slices, 0, predictors.n_cols);
+  Forward(predictors, batch, false);
+
+  return Loss(responses, batch, NULL) + forwardNetwork.Loss() +
+      backwardNetwork.Loss() + mergeNetwork.Loss();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename Archive>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  #ifndef MLPACK_ENABLE_ANN_SERIALIZATION
+    // Note: if you define MLPACK_IGNORE_ANN_SERIALIZATION_WARNING, you had
+    // better ensure that every layer you are serializing has had
+    // CEREAL_REGISTER_TYPE() called somewhere.  See layer/serialization.hpp for
+    // more information.
+    #ifndef MLPACK_IGNORE_ANN_SERIALIZATION_WARNING
+      throw std::runtime_error("Cannot serialize a neural network unless "
+          "MLPACK_ENABLE_ANN_SERIALIZATION is defined!  See the \"Additional "
+          "build options\" section of the README for more information.");
+    #endif
+  #else
+    ar(CEREAL_NVP(sumMerge));
+    ar(CEREAL_NVP(outputLayer));
+    ar(CEREAL_NVP(initializeRule));
+
+    ar(CEREAL_NVP(forwardNetwork));
+    ar(CEREAL_NVP(backwardNetwork));
+    ar(CEREAL_NVP(mergeNetwork));
+    ar(CEREAL_NVP(parameters));
+    ar(CEREAL_NVP(inputDimensions));
+
+    if (cereal::is_loading<Archive>())
+    {
+      // We can clear these members, since it's not possible to serialize in the
+      // middle of training and resume.
+      predictors.clear();
+      responses.clear();
+      sequenceLengths.clear();
+
+      // The weights in `parameters` will be correctly set for each layer in the
+      // first call to Forward().
+      layerMemoryIsSet = false;
+      inputDimensionsAreSet = false;
+    }
+  #endif
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type
+BRNN<OutputLayerType, InitializationRuleType, MatType>::Evaluate(
+    const MatType& /* parameters */,
+    const size_t begin,
+    const size_t batchSize)
+{
+  CheckNetwork("BRNN::Evaluate()", predictors.n_rows);
+
+  PackedSequences<MatType> batch;
+  batch.Reset(sequenceLengths, predictors.n_slices, begin, batchSize);
+  Forward(predictors, batch, false);
+
+  return Loss(responses, batch, NULL) + forwardNetwork.Loss() +
+      backwardNetwork.Loss() + mergeNetwork.Loss();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename GradType>
+typename MatType::elem_type
+BRNN<OutputLayerType, InitializationRuleType, MatType>::EvaluateWithGradient(
+    const MatType& parameters,
+    GradType& gradient)
+{
+  return EvaluateWithGradient(parameters, 0, gradient, predictors.n_cols);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename GradType>
+typename MatType::elem_type
+BRNN<OutputLayerType, InitializationRuleType, MatType>::EvaluateWithGradient(
+    const MatType& /* parameters */,
+    const size_t begin,
+    GradType& gradient,
+    const size_t batchSize)
+{
+  CheckNetwork("BRNN::EvaluateWithGradient()", predictors.n_rows);
+
+  // Pass the batch through the network, keeping the states of every step.
+  PackedSequences<MatType> batch;
+  batch.Reset(sequenceLengths, predictors.n_slices, begin, batchSize);
+  Forward(predictors, batch, true);
+
+  MatType errors;
+  const typename MatType::elem_type loss = Loss(responses, batch, &errors) +
+      forwardNetwork.Loss() + backwardNetwork.Loss() + mergeNetwork.Loss();
+
+  gradient.zeros(parameters.n_rows, parameters.n_cols);
+  const size_t forwardWeights = forwardNetwork.WeightSize();
+  const size_t backwardWeights = backwardNetwork.WeightSize();
+  const size_t mergeWeights = mergeNetwork.WeightSize();
+
+  // Backpropagate through the merge layers, for all the steps at once.
+  MatType mergedErrors, gradientAlias;
+  if (mergeNetwork.Network().size() > 0)
+  {
+    mergedErrors.set_size(mergedOutputs.n_rows, mergedOutputs.n_cols);
+    mergeNetwork.Backward(mergedOutputs, networkOutputs, errors, mergedErrors);
+    if (mergeWeights > 0)
+    {
+      MakeAlias(gradientAlias, MemPtr(gradient) + forwardWeights +
+          backwardWeights, mergeWeights, 1);
+      mergeNetwork.Gradient(mergedOutputs, errors, gradientAlias);
+    }
+  }
+  else
+  {
+    mergedErrors = std::move(errors);
+  }
+
+  // Split the errors of the merged outputs between the two directions.
+  const size_t outputSize = forwardOutputs.n_rows;
+  MatType forwardErrors(outputSize, batch.Columns());
+  MatType backwardErrors(outputSize, batch.Columns());
+  for (size_t t = 0; t < batch.Steps(); ++t)
+  {
+    for (size_t j = 0; j < batch.StepSize(t); ++j)
+    {
+      const size_t col = batch.StepOffset(t) + j;
+      const size_t reversedCol = batch.ReversedColumn(t, j);
+      if (sumMerge)
+      {
+        forwardErrors.col(col) = mergedErrors.col(col);
+        backwardErrors.col(reversedCol) = mergedErrors.col(col);
+      }
+      else
+      {
+        forwardErrors.col(col) = mergedErrors.submat(0, col, outputSize - 1,
+            col);
+        backwardErrors.col(reversedCol) = mergedErrors.submat(outputSize, col,
+            2 * outputSize - 1, col);
+      }
+    }
+  }
+
+  // Now backpropagate through the steps of each direction.
+  MakeAlias(gradientAlias, MemPtr(gradient), forwardWeights, 1);
+  SequenceBackward(forwardNetwork, batch, forwardInputs, forwardOutputs,
+      forwardErrors, gradientAlias);
+  MakeAlias(gradientAlias, MemPtr(gradient) + forwardWeights, backwardWeights,
+      1);
+  SequenceBackward(backwardNetwork, batch, backwardInputs, backwardOutputs,
+      backwardErrors, gradientAlias);
+
+  return loss;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename GradType>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::Gradient(
+    const MatType& parameters,
+    const size_t begin,
+    GradType& gradient,
+    const size_t batchSize)
+{
+  this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::Shuffle()
+{
+  PackedSequences<MatType>::Shuffle(predictors, responses, sequenceLengths);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::ResetData(
+    arma::Cube<typename MatType::elem_type> predictors,
+    arma::Cube<typename MatType::elem_type> responses,
+    arma::urowvec sequenceLengths)
+{
+  PackedSequences<MatType>::CheckLengths(sequenceLengths, predictors.n_cols,
+      predictors.n_slices, "BRNN::ResetData()");
+
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+  this->sequenceLengths = std::move(sequenceLengths);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::CheckNetwork(
+    const std::string& functionName,
+    const size_t inputDimensionality,
+    const bool setMode,
+    const bool training)
+{
+  // If the network is empty, we can't do anything.
+  if (forwardNetwork.Network().size() == 0)
+  {
+    throw std::invalid_argument(functionName + ": cannot use network with no "
+        "layers!");
+  }
+
+  if (!inputDimensionsAreSet)
+  {
+    // If the input dimensions are completely unset, then assume our input is
+    // flat.
+    if (inputDimensions.size() == 0)
+      inputDimensions = { inputDimensionality };
+
+    size_t totalInputSize = 1;
+    for (size_t i = 0; i < inputDimensions.size(); ++i)
+      totalInputSize *= inputDimensions[i];
+
+    if (totalInputSize != inputDimensionality && inputDimensionality != 0)
+    {
+      throw std::logic_error(functionName + ": input size does not match "
+          "expected size set with InputDimensions()!");
+    }
+
+    forwardNetwork.InputDimensions() = inputDimensions;
+    forwardNetwork.ComputeOutputDimensions();
+    backwardNetwork.InputDimensions() = inputDimensions;
+    backwardNetwork.ComputeOutputDimensions();
+
+    // The merge layers take the merged outputs of the two directions.
+    if (mergeNetwork.Network().size() > 0)
+    {
+      if (sumMerge)
+      {
+        mergeNetwork.InputDimensions() = forwardNetwork.OutputDimensions();
+      }
+      else
+      {
+        mergeNetwork.InputDimensions() =
+            std::vector<size_t>({ 2 * forwardNetwork.OutputSize() });
+      }
+      mergeNetwork.ComputeOutputDimensions();
+    }
+
+    inputDimensionsAreSet = true;
+  }
+
+  // We may need to initialize the `parameters` matrix if it is empty or the
+  // wrong size.
+  if (parameters.n_elem != WeightSize() || parameters.is_empty())
+  {
+    InitializeWeights();
+    layerMemoryIsSet = false;
+  }
+
+  // Make sure each layer is pointing at the right memory.
+  if (!layerMemoryIsSet)
+  {
+    size_t offset = 0;
+    for (MultiLayer<MatType>* network :
+         { &forwardNetwork, &backwardNetwork, &mergeNetwork })
+    {
+      if (network->WeightSize() > 0)
+        network->SetWeights(MemPtr(parameters) + offset);
+      offset += network->WeightSize();
+    }
+
+    layerMemoryIsSet = true;
+  }
+
+  // Finally, set the layers of the network to the right mode if the user
+  // requested it.
+  if (setMode)
+    SetNetworkMode(training);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::InitializeWeights()
+{
+  // Each of the networks is initialized separately in its part of the
+  // parameters.
+  NetworkInitialization<InitializationRuleType> networkInit(initializeRule);
+  parameters.set_size(WeightSize(), 1);
+  size_t offset = 0;
+  for (MultiLayer<MatType>* network :
+       { &forwardNetwork, &backwardNetwork, &mergeNetwork })
+  {
+    const size_t weights = network->WeightSize();
+    if (weights == 0)
+      continue;
+
+    MatType networkParameters;
+    MakeAlias(networkParameters, MemPtr(parameters) + offset, weights, 1);
+    networkInit.Initialize(network->Network(), networkParameters);
+    // Override the weight matrix if necessary.
+    network->CustomInitialize(networkParameters, weights);
+    offset += weights;
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::Forward(
+    const arma::Cube<typename MatType::elem_type>& predictors,
+    const PackedSequences<MatType>& batch,
+    const bool keepSteps)
+{
+  batch.Pack(predictors, forwardInputs);
+  batch.Pack(predictors, backwardInputs, true);
+  SequenceForward(forwardNetwork, batch, forwardInputs, forwardOutputs,
+      keepSteps);
+  SequenceForward(backwardNetwork, batch, backwardInputs, backwardOutputs,
+      keepSteps);
+
+  // Merge the outputs of the two directions for each step.  The output of the
+  // backward direction for a step is at the reversed step.
+  const size_t outputSize = forwardOutputs.n_rows;
+  mergedOutputs.set_size(sumMerge ? outputSize : 2 * outputSize,
+      batch.Columns());
+  for (size_t t = 0; t < batch.Steps(); ++t)
+  {
+    for (size_t j = 0; j < batch.StepSize(t); ++j)
+    {
+      const size_t col = batch.StepOffset(t) + j;
+      const size_t reversedCol = batch.ReversedColumn(t, j);
+      if (sumMerge)
+      {
+        mergedOutputs.col(col) = forwardOutputs.col(col) +
+            backwardOutputs.col(reversedCol);
+      }
+      else
+      {
+        mergedOutputs.submat(0, col, outputSize - 1, col) =
+            forwardOutputs.col(col);
+        mergedOutputs.submat(outputSize, col, 2 * outputSize - 1, col) =
+            backwardOutputs.col(reversedCol);
+      }
+    }
+  }
+
+  // The merge layers are not recurrent, so all the steps are passed through
+  // them at once.
+  if (mergeNetwork.Network().size() > 0)
+  {
+    networkOutputs.set_size(mergeNetwork.OutputSize(), batch.Columns());
+    mergeNetwork.KeepOutputs() = keepSteps;
+    mergeNetwork.Forward(mergedOutputs, networkOutputs);
+  }
+  else
+  {
+    networkOutputs = mergedOutputs;
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type
+BRNN<OutputLayerType, InitializationRuleType, MatType>::Loss(
+    const arma::Cube<typename MatType::elem_type>& responses,
+    const PackedSequences<MatType>& batch,
+    MatType* errors)
+{
+  MatType packedResponses;
+  batch.Pack(responses, packedResponses);
+  if (errors != NULL)
+    errors->set_size(networkOutputs.n_rows, networkOutputs.n_cols);
+
+  // As for RNN, the loss is computed for each step and summed.
+  typename MatType::elem_type loss = 0;
+  MatType outputData, responseData, errorData;
+  for (size_t t = 0; t < batch.Steps(); ++t)
+  {
+    const size_t offset = batch.StepOffset(t);
+    MakeAlias(outputData, networkOutputs.colptr(offset), networkOutputs.n_rows,
+        batch.StepSize(t));
+    MakeAlias(responseData, packedResponses.colptr(offset),
+        packedResponses.n_rows, batch.StepSize(t));
+    loss += outputLayer.Forward(outputData, responseData);
+
+    if (errors != NULL)
+    {
+      MakeAlias(errorData, errors->colptr(offset), errors->n_rows,
+          batch.StepSize(t));
+      outputLayer.Backward(outputData, responseData, errorData);
+    }
+  }
+
+  return loss;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::SequenceForward(
+    MultiLayer<MatType>& network,
+    const PackedSequences<MatType>& batch,
+    const MatType& inputs,
+    MatType& outputs,
+    const bool keepSteps)
+{
+  outputs.set_size(network.OutputSize(), batch.Columns());
+  if (batch.Steps() == 0)
+    return;
+
+  // Without a backward pass, the state of one step is enough.  All the
+  // sequences are running at the first step.
+  network.KeepOutputs() = keepSteps;
+  ResetMemoryState(network, keepSteps ? batch.Steps() : 1, batch.StepSize(0));
+
+  // Only the inputs of the first layer are known before the first step.
+  RecurrentLayer<MatType>* r =
+      dynamic_cast<RecurrentLayer<MatType>*>(network.Network().front());
+  if (r != nullptr)
+    r->PrepareSequence(inputs);
+
+  MatType stepData, outputData;
+  for (size_t t = 0; t < batch.Steps(); ++t)
+  {
+    const size_t offset = batch.StepOffset(t);
+    if (keepSteps)
+      SetSteps(network, (t == 0) ? size_t(-1) : t - 1, t, offset);
+    else
+      SetSteps(network, (t == 0) ? size_t(-1) : 0, 0, offset);
+
+    MakeAlias(stepData, (typename MatType::elem_type*) inputs.colptr(offset),
+        inputs.n_rows, batch.StepSize(t));
+    MakeAlias(outputData, outputs.colptr(offset), outputs.n_rows,
+        batch.StepSize(t));
+    network.Forward(stepData, outputData);
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::SequenceBackward(
+    MultiLayer<MatType>& network,
+    const PackedSequences<MatType>& batch,
+    const MatType& inputs,
+    const MatType& outputs,
+    const MatType& errors,
+    MatType& gradient)
+{
+  gradient.zeros();
+  MatType currentGradient(gradient.n_rows, gradient.n_cols);
+
+  // The network only keeps the outputs of its layers for the last step, so the
+  // forward pass of each earlier step is computed again before its backward
+  // pass.  (The recurrent layers compute the same state into the same slot.)
+  const bool recompute = (network.Network().size() > 1);
+  const size_t steps = batch.Steps();
+  MatType stepData, outputData, errorData, recomputedOutput, delta;
+  for (size_t t = steps; t > 0; --t)
+  {
+    const size_t offset = batch.StepOffset(t - 1);
+    const size_t stepSize = batch.StepSize(t - 1);
+    MakeAlias(stepData, (typename MatType::elem_type*) inputs.colptr(offset),
+        inputs.n_rows, stepSize);
+    MakeAlias(outputData, (typename MatType::elem_type*) outputs.colptr(offset),
+        outputs.n_rows, stepSize);
+    MakeAlias(errorData, (typename MatType::elem_type*) errors.colptr(offset),
+        errors.n_rows, stepSize);
+
+    if (recompute && t < steps)
+    {
+      SetSteps(network, (t == 1) ? size_t(-1) : t - 2, t - 1, offset);
+      recomputedOutput.set_size(outputs.n_rows, stepSize);
+      network.Forward(stepData, recomputedOutput);
+    }
+
+    // During the backward pass, the previous step is the one after this one.
+    SetSteps(network, (t == steps) ? size_t(-1) : t, t - 1, offset);
+
+    delta.set_size(inputs.n_rows, stepSize);
+    network.Backward(stepData, outputData, errorData, delta);
+
+    currentGradient.zeros();
+    network.Gradient(stepData, errorData, currentGradient);
+    gradient += currentGradient;
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::ResetMemoryState(
+    MultiLayer<MatType>& network,
+    const size_t memorySize,
+    const size_t batchSize)
+{
+  for (Layer<MatType>* l : network.Network())
+  {
+    // We can only call ClearRecurrentState() on RecurrentLayers.
+    RecurrentLayer<MatType>* r = dynamic_cast<RecurrentLayer<MatType>*>(l);
+    if (r != nullptr)
+      r->ClearRecurrentState(memorySize, batchSize);
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void BRNN<OutputLayerType, InitializationRuleType, MatType>::SetSteps(
+    MultiLayer<MatType>& network,
+    const size_t previousStep,
+    const size_t currentStep,
+    const size_t offset)
+{
+  for (Layer<MatType>* l : network.Network())
+  {
+    RecurrentLayer<MatType>* r = dynamic_cast<RecurrentLayer<MatType>*>(l);
+    if (r != nullptr)
+    {
+      r->PreviousStep() = previousStep;
+      r->CurrentStep() = currentStep;
+      r->SequenceOffset() = offset;
+    }
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType>
+typename std::enable_if<
+    ens::traits::HasMaxIterationsSignature<OptimizerType>::value, void
+>::type
+BRNN<OutputLayerType, InitializationRuleType, MatType>::
+WarnMessageMaxIterations(OptimizerType& optimizer, size_t samples) const
+{
+  if (optimizer.MaxIterations() < samples &&
+      optimizer.MaxIterations() != 0)
+  {
+    Log::Warn << "The optimizer's maximum number of iterations is less than the"
+        << " size of the dataset; the optimizer will not pass over the entire "
+        << "dataset. To fix this, modify the maximum number of iterations to be"
+        << " at least equal to the number of points of your dataset ("
+        << samples << ")." << std::endl;
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType>
+typename std::enable_if<
+    !ens::traits::HasMaxIterationsSignature<OptimizerType>::value, void
+>::type
+BRNN<OutputLayerType, InitializationRuleType, MatType>::
+WarnMessageMaxIterations(OptimizerType& /* optimizer */,
+                         size_t /* samples */) const
+{
+  // Nothing to do here.
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,214 @@
+/**
+ * @file methods/ann/convolution_rules/depthwise_convolution.hpp
+ *
+ * Implementation of the depthwise convolution, where each input map is
+ * convolved only with its own filters.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_DEPTHWISE_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_DEPTHWISE_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
+
+namespace mlpack {
+
+/**
+ * Computes the (valid) depthwise convolution of a batch of points: each input
+ * map of a point is convolved with `multiplier` filters of its own, giving
+ * `multiplier` output maps, and no sum is taken over the input maps.  This is
+ * the convolution of a grouped convolution with as many groups as input maps,
+ * which is what depthwise-separable networks like MobileNet are made of.
+ *
+ * Lowering such a convolution to a matrix multiplication (like
+ * Im2ColConvolution does) gives one tiny product for each map, so instead the
+ * filters are applied directly: each filter element is multiplied with a whole
+ * column of the input map at once, a loop that the compiler vectorizes.
+ *
+ * The maps of each point are stored one after another in the slices of the
+ * input and output cubes, and output map `o` of a point is computed from input
+ * map `o / multiplier` with the filter in slice `o` of `filters`.
+ */
+class DepthwiseConvolution
+{
+ public:
+  /**
+   * Compute the depthwise convolution of all points of `input`.  `output` must
+   * already have the size of the result; it is overwritten.
+   *
+   * @param input Input maps of all points.
+   * @param inMapsPerPoint Number of maps of each point in `input`.
+   * @param filters Filters, one slice for each output map of a point.
+   * @param output Output maps of all points.
+   * @param strideRows Stride of filter application along the rows.
+   * @param strideCols Stride of filter application along the columns.
+   */
+  template<typename CubeType>
+  static void Forward(const CubeType& input,
+                      const size_t inMapsPerPoint,
+                      const CubeType& filters,
+                      CubeType& output,
+                      const size_t strideRows = 1,
+                      const size_t strideCols = 1)
+  {
+    typedef typename CubeType::elem_type eT;
+    const size_t outMapsPerPoint = filters.n_slices;
+    const size_t multiplier = outMapsPerPoint / inMapsPerPoint;
+
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t s = 0; s < output.n_slices; ++s)
+    {
+      const size_t map = s % outMapsPerPoint;
+      const size_t inSlice = (s / outMapsPerPoint) * inMapsPerPoint +
+          map / multiplier;
+
+      output.slice(s).zeros();
+      for (size_t kj = 0; kj < filters.n_cols; ++kj)
+      {
+        for (size_t ki = 0; ki < filters.n_rows; ++ki)
+        {
+          const eT w = filters(ki, kj, map);
+          for (size_t j = 0; j < output.n_cols; ++j)
+          {
+            const eT* inputPtr = input.slice_colptr(inSlice,
+                j * strideCols + kj) + ki;
+            eT* outputPtr = output.slice_colptr(s, j);
+            if (strideRows == 1)
+            {
+              for (size_t i = 0; i < output.n_rows; ++i)
+                outputPtr[i] += w * inputPtr[i];
+            }
+            else
+            {
+              for (size_t i = 0; i < output.n_rows; ++i)
+                outputPtr[i] += w * inputPtr[i * strideRows];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Compute the gradient of Forward() with respect to its input: given the
+   * error of the output maps of all points, add the error of the input maps to
+   * `inputError`, which must already have the size of the input.
+   *
+   * @param error Error of the output maps of all points.
+   * @param filters Filters, one slice for each output map of a point.
+   * @param inputError Error of the input maps of all points.
+   * @param inMapsPerPoint Number of maps of each point in `inputError`.
+   * @param strideRows Stride of filter application along the rows.
+   * @param strideCols Stride of filter application along the columns.
+   */
+  template<typename CubeType>
+  static void Backward(const CubeType& error,
+                       const CubeType& filters,
+                       CubeType& inputError,
+                       const size_t inMapsPerPoint,
+                       const size_t strideRows = 1,
+                       const size_t strideCols = 1)
+  {
+    typedef typename CubeType::elem_type eT;
+    const size_t outMapsPerPoint = filters.n_slices;
+    const size_t multiplier = outMapsPerPoint / inMapsPerPoint;
+
+    // Each input map is only written by the output maps computed from it, so
+    // the input maps can be handled in parallel.
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t t = 0; t < inputError.n_slices; ++t)
+    {
+      const size_t point = t / inMapsPerPoint;
+      const size_t inMap = t % inMapsPerPoint;
+      for (size_t r = 0; r < multiplier; ++r)
+      {
+        const size_t map = inMap * multiplier + r;
+        const size_t s = point * outMapsPerPoint + map;
+        for (size_t kj = 0; kj < filters.n_cols; ++kj)
+        {
+          for (size_t ki = 0; ki < filters.n_rows; ++ki)
+          {
+            const eT w = filters(ki, kj, map);
+            for (size_t j = 0; j < error.n_cols; ++j)
+            {
+              eT* inputPtr = inputError.slice_colptr(t, j * strideCols + kj) +
+                  ki;
+              const eT* errorPtr = error.slice_colptr(s, j);
+              if (strideRows == 1)
+              {
+                for (size_t i = 0; i < error.n_rows; ++i)
+                  inputPtr[i] += w * errorPtr[i];
+              }
+              else
+              {
+                for (size_t i = 0; i < error.n_rows; ++i)
+                  inputPtr[i * strideRows] += w * errorPtr[i];
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Compute the gradient of Forward() with respect to the filters, given the
+   * input and the error of the output, summed over all points.  `gradient`
+   * must already have the size of the filters; it is overwritten.
+   *
+   * @param input Input maps of all points.
+   * @param inMapsPerPoint Number of maps of each point in `input`.
+   * @param error Error of the output maps of all points.
+   * @param gradient Gradient of the filters.
+   * @param strideRows Stride of filter application along the rows.
+   * @param strideCols Stride of filter application along the columns.
+   */
+  template<typename CubeType>
+  static void Gradient(const CubeType& input,
+                       const size_t inMapsPerPoint,
+                       const CubeType& error,
+                       CubeType& gradient,
+                       const size_t strideRows = 1,
+                       const size_t strideCols = 1)
+  {
+    typedef typename CubeType::elem_type eT;
+    const size_t outMapsPerPoint = gradient.n_slices;
+    const size_t multiplier = outMapsPerPoint / inMapsPerPoint;
+    const size_t points = error.n_slices / outMapsPerPoint;
+
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t map = 0; map < outMapsPerPoint; ++map)
+    {
+      for (size_t kj = 0; kj < gradient.n_cols; ++kj)
+      {
+        for (size_t ki = 0; ki < gradient.n_rows; ++ki)
+        {
+          eT sum = 0;
+          for (size_t p = 0; p < points; ++p)
+          {
+            const size_t s = p * outMapsPerPoint + map;
+            const size_t inSlice = p * inMapsPerPoint + map / multiplier;
+            for (size_t j = 0; j < error.n_cols; ++j)
+            {
+              const eT* inputPtr = input.slice_colptr(inSlice,
+                  j * strideCols + kj) + ki;
+              const eT* errorPtr = error.slice_colptr(s, j);
+              for (size_t i = 0; i < error.n_rows; ++i)
+                sum += errorPtr[i] * inputPtr[i * strideRows];
+            }
+          }
+
+          gradient(ki, kj, map) = sum;
+        }
+      }
+    }
+  }
+};  // class DepthwiseConvolution
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,584 @@
+/**
+ * @file methods/ann/convolution_rules/im2col_convolution.hpp
+ *
+ * Implementation of the convolution through im2col lowering and matrix
+ * multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+
+/**
+ * Computes the two-dimensional convolution by lowering it to a matrix
+ * multiplication: each patch of the input that the filter is applied to is
+ * copied into a column of a matrix ("im2col"), so that the convolution becomes
+ * a product of that matrix with the vectorized filter, which BLAS computes
+ * much faster than the loops of NaiveConvolution.  The border mode can be
+ * specified like for the other convolution rules.
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * Like the other rules, this class provides Convolution() for a single input
+ * and filter.  The Convolution and GroupedConvolution layers instead use
+ * ForwardBatch(), BackwardBatch() and GradientBatch(), which handle all the
+ * input maps, output maps and points of a batch with a single matrix
+ * multiplication.  These take the workspace matrices used for the lowered
+ * input as parameters, so that a layer can keep them and only allocate them
+ * once, instead of once per batch.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /**
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename InMatType, typename FilMatType, typename OutMatType,
+      typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const InMatType& input,
+              const FilMatType& filter,
+              OutMatType& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1,
+              const bool appending = false,
+              const typename std::enable_if_t<IsMatrix<InMatType>::value>* = 0)
+  {
+    typedef typename InMatType::elem_type eT;
+    // See NaiveConvolution for the computation of the output size.
+    if (!appending)
+    {
+      const size_t filterRows = filter.n_rows * dilationH - (dilationH - 1);
+      const size_t filterCols = filter.n_cols * dilationW - (dilationW - 1);
+      const size_t outputRows = (input.n_rows - filterRows + dH) / dH;
+      const size_t outputCols = (input.n_cols - filterCols + dW) / dW;
+      output.zeros(outputRows, outputCols);
+    }
+
+    // Column i + j * output.n_rows holds the part of the input that output(i,
+    // j) is computed from, in the same order as the elements of the filter.
+    arma::Mat<eT> columns(filter.n_elem, output.n_elem);
+    for (size_t j = 0; j < output.n_cols; ++j)
+    {
+      for (size_t i = 0; i < output.n_rows; ++i)
+      {
+        eT* columnPtr = columns.colptr(i + j * output.n_rows);
+        for (size_t kj = 0; kj < filter.n_cols; ++kj)
+        {
+          const eT* inputPtr = input.colptr(kj * dilationW + j * dW) + i * dH;
+          for (size_t ki = 0; ki < filter.n_rows; ++ki, inputPtr += dilationH)
+            *(columnPtr++) = *inputPtr;
+        }
+      }
+    }
+
+    const arma::Col<eT> result = columns.t() *
+        arma::Col<eT>(const_cast<eT*>(filter.memptr()), filter.n_elem, false,
+        true);
+    eT* outputPtr = output.memptr();
+    for (size_t i = 0; i < output.n_elem; ++i)
+      outputPtr[i] += result[i];
+  }
+
+  /**
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename InMatType, typename FilMatType, typename OutMatType,
+      typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const InMatType& input,
+              const FilMatType& filter,
+              OutMatType& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1,
+              const bool appending = false,
+              const typename std::enable_if_t<IsMatrix<InMatType>::value>* = 0)
+  {
+    // Pad the input, so that the full convolution is the valid convolution of
+    // the padded input.  Note that these variables only hold the padding on
+    // one side of the input.
+    const size_t filterRows = filter.n_rows * dilationH - (dilationH - 1);
+    const size_t filterCols = filter.n_cols * dilationW - (dilationW - 1);
+    const size_t paddingRows = filterRows - 1;
+    const size_t paddingCols = filterCols - 1;
+
+    InMatType inputPadded(input.n_rows + 2 * paddingRows,
+        input.n_cols + 2 * paddingCols, arma::fill::zeros);
+    inputPadded.submat(paddingRows, paddingCols, paddingRows + input.n_rows - 1,
+        paddingCols + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, dW, dH, dilationW, dilationH, appending);
+  }
+
+  /**
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename CubeType>
+  static void Convolution(const CubeType& input,
+                          const CubeType& filter,
+                          CubeType& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1,
+                          const bool appending = false,
+                          const typename std::enable_if_t<
+                              IsCube<CubeType>::value>* = 0)
+  {
+    typedef typename GetDenseMatType<CubeType>::type MatType;
+    MatType convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH, appending);
+
+    if (!appending)
+      output = CubeType(convOutput.n_rows, convOutput.n_cols, input.n_slices);
+
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH,
+          appending);
+    }
+  }
+
+  /**
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename MatType, typename CubeType>
+  static void Convolution(const MatType& input,
+                          const CubeType& filter,
+                          CubeType& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1,
+                          const bool appending = false,
+                          const typename std::enable_if_t<
+                              IsMatrix<MatType>::value>* = 0,
+                          const typename std::enable_if_t<
+                              IsCube<CubeType>::value>* = 0)
+  {
+    MatType convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH, appending);
+
+    if (!appending)
+      output = CubeType(convOutput.n_rows, convOutput.n_cols, filter.n_slices);
+
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH, appending);
+    }
+  }
+
+  /**
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename MatType, typename CubeType>
+  static void Convolution(const CubeType& input,
+                          const MatType& filter,
+                          CubeType& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1,
+                          const bool appending = false,
+                          const typename std::enable_if_t<
+                              IsMatrix<MatType>::value>* = 0,
+                          const typename std::enable_if_t<
+                              IsCube<CubeType>::value>* = 0)
+  {
+    MatType convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH, appending);
+
+    if (!appending)
+      output = CubeType(convOutput.n_rows, convOutput.n_cols, input.n_slices);
+
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH, appending);
+    }
+  }
+
+  /**
+   * Compute the (valid) convolution of a whole batch with a set of filters.
+   * `input` holds `inMapsPerPoint` maps for each point, one point after
+   * another, and the maps `firstInMap` to `firstInMap + numInMaps - 1` of each
+   * point are convolved; likewise, the result is stored in the maps
+   * `firstOutMap` onwards of each point of `output`, which must already have
+   * the right size.  Each column of `weights` holds the filters of one output
+   * map (a `kernelRows` x `kernelCols` filter for each of the `numInMaps` input
+   * maps, one after another), so `numInMaps` is `weights.n_rows / (kernelRows
+   * * kernelCols)`.
+   *
+   * @param input Input maps of all points.
+   * @param inMapsPerPoint Number of maps of each point in `input`.
+   * @param firstInMap First map of each point to convolve.
+   * @param weights Filters, one column for each output map.
+   * @param output Output maps of all points.
+   * @param outMapsPerPoint Number of maps of each point in `output`.
+   * @param firstOutMap First map of each point to store the result in.
+   * @param kernelRows Number of rows of each filter.
+   * @param kernelCols Number of columns of each filter.
+   * @param strideRows Stride of filter application along the rows.
+   * @param strideCols Stride of filter application along the columns.
+   * @param columns Workspace for the lowered input.
+   * @param product Workspace for the result of the multiplication.
+   */
+  template<typename CubeType, typename MatType>
+  static void ForwardBatch(const CubeType& input,
+                           const size_t inMapsPerPoint,
+                           const size_t firstInMap,
+                           const MatType& weights,
+                           CubeType& output,
+                           const size_t outMapsPerPoint,
+                           const size_t firstOutMap,
+                           const size_t kernelRows,
+                           const size_t kernelCols,
+                           const size_t strideRows,
+                           const size_t strideCols,
+                           MatType& columns,
+                           MatType& product)
+  {
+    Im2Col(input, inMapsPerPoint, firstInMap, weights.n_rows /
+        (kernelRows * kernelCols), kernelRows, kernelCols, output.n_rows,
+        output.n_cols, strideRows, strideCols, columns);
+
+    // Each row of the product holds one element of all the output maps.
+    product = columns.t() * weights;
+    ScatterMaps(product, outMapsPerPoint, firstOutMap, output);
+  }
+
+  /**
+   * Compute the gradient of ForwardBatch() with respect to its input: given
+   * the error of the maps `firstOutMap` onwards of each point of `error`, add
+   * the error of the maps `firstInMap` to `firstInMap + numInMaps - 1` of each
+   * point to `inputError`, which must already have the size of the input of
+   * ForwardBatch().  The parameters are like those of ForwardBatch().
+   *
+   * @param error Error of the output maps of all points.
+   * @param outMapsPerPoint Number of maps of each point in `error`.
+   * @param firstOutMap First map of each point to use.
+   * @param weights Filters, one column for each output map.
+   * @param inputError Error of the input maps of all points.
+   * @param inMapsPerPoint Number of maps of each point in `inputError`.
+   * @param firstInMap First map of each point to add the result to.
+   * @param kernelRows Number of rows of each filter.
+   * @param kernelCols Number of columns of each filter.
+   * @param strideRows Stride of filter application along the rows.
+   * @param strideCols Stride of filter application along the columns.
+   * @param columns Workspace for the lowered error.
+   * @param product Workspace for the gathered error.
+   */
+  template<typename CubeType, typename MatType>
+  static void BackwardBatch(const CubeType& error,
+                            const size_t outMapsPerPoint,
+                            const size_t firstOutMap,
+                            const MatType& weights,
+                            CubeType& inputError,
+                            const size_t inMapsPerPoint,
+                            const size_t firstInMap,
+                            const size_t kernelRows,
+                            const size_t kernelCols,
+                            const size_t strideRows,
+                            const size_t strideCols,
+                            MatType& columns,
+                            MatType& product)
+  {
+    GatherMaps(error, outMapsPerPoint, firstOutMap, weights.n_cols, product);
+    columns = weights * product.t();
+    Col2Im(columns, inMapsPerPoint, firstInMap, weights.n_rows /
+        (kernelRows * kernelCols), kernelRows, kernelCols, error.n_rows,
+        error.n_cols, strideRows, strideCols, inputError);
+  }
+
+  /**
+   * Compute the gradient of ForwardBatch() with respect to the filters, given
+   * the input and the error of the output.  `gradient` must already have the
+   * size of the weights; it is overwritten.  The parameters are like those of
+   * ForwardBatch().
+   *
+   * @param input Input maps of all points.
+   * @param inMapsPerPoint Number of maps of each point in `input`.
+   * @param firstInMap First map of each point that was convolved.
+   * @param error Error of the output maps of all points.
+   * @param outMapsPerPoint Number of maps of each point in `error`.
+   * @param firstOutMap First map of each point to use.
+   * @param gradient Gradient of the filters, one column for each output map.
+   * @param kernelRows Number of rows of each filter.
+   * @param kernelCols Number of columns of each filter.
+   * @param strideRows Stride of filter application along the rows.
+   * @param strideCols Stride of filter application along the columns.
+   * @param columns Workspace for the lowered input.
+   * @param product Workspace for the gathered error.
+   */
+  template<typename CubeType, typename MatType>
+  static void GradientBatch(const CubeType& input,
+                            const size_t inMapsPerPoint,
+                            const size_t firstInMap,
+                            const CubeType& error,
+                            const size_t outMapsPerPoint,
+                            const size_t firstOutMap,
+                            MatType& gradient,
+                            const size_t kernelRows,
+                            const size_t kernelCols,
+                            const size_t strideRows,
+                            const size_t strideCols,
+                            MatType& columns,
+                            MatType& product)
+  {
+    Im2Col(input, inMapsPerPoint, firstInMap, gradient.n_rows /
+        (kernelRows * kernelCols), kernelRows, kernelCols, error.n_rows,
+        error.n_cols, strideRows, strideCols, columns);
+    GatherMaps(error, outMapsPerPoint, firstOutMap, gradient.n_cols, product);
+    gradient = columns * product;
+  }
+
+  /**
+   * Lower the maps `firstMap` to `firstMap + numMaps - 1` of each point of
+   * `input` into `columns`: column `i + j * outputRows + p * outputRows *
+   * outputCols` holds the part of the input of point `p` that output element
+   * `(i, j)` is computed from, with the `kernelRows` x `kernelCols` elements of
+   * each map one after another.
+   */
+  template<typename CubeType, typename MatType>
+  static void Im2Col(const CubeType& input,
+                     const size_t mapsPerPoint,
+                     const size_t firstMap,
+                     const size_t numMaps,
+                     const size_t kernelRows,
+                     const size_t kernelCols,
+                     const size_t outputRows,
+                     const size_t outputCols,
+                     const size_t strideRows,
+                     const size_t strideCols,
+                     MatType& columns)
+  {
+    typedef typename MatType::elem_type eT;
+    const size_t points = input.n_slices / mapsPerPoint;
+    const size_t outputSize = outputRows * outputCols;
+    columns.set_size(kernelRows * kernelCols * numMaps, outputSize * points);
+
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t p = 0; p < points; ++p)
+    {
+      for (size_t j = 0; j < outputCols; ++j)
+      {
+        for (size_t i = 0; i < outputRows; ++i)
+        {
+          eT* columnPtr = columns.colptr(i + j * outputRows + p * outputSize);
+          for (size_t m = 0; m < numMaps; ++m)
+          {
+            const size_t slice = p * mapsPerPoint + firstMap + m;
+            for (size_t kj = 0; kj < kernelCols; ++kj)
+            {
+              const eT* inputPtr = input.slice_colptr(slice,
+                  j * strideCols + kj) + i * strideRows;
+              std::copy(inputPtr, inputPtr + kernelRows, columnPtr);
+              columnPtr += kernelRows;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * The adjoint of Im2Col(): add each element of `columns` to the element of
+   * `output` that Im2Col() would have copied it from.
+   */
+  template<typename MatType, typename CubeType>
+  static void Col2Im(const MatType& columns,
+                     const size_t mapsPerPoint,
+                     const size_t firstMap,
+                     const size_t numMaps,
+                     const size_t kernelRows,
+                     const size_t kernelCols,
+                     const size_t outputRows,
+                     const size_t outputCols,
+                     const size_t strideRows,
+                     const size_t strideCols,
+                     CubeType& output)
+  {
+    typedef typename MatType::elem_type eT;
+    const size_t points = output.n_slices / mapsPerPoint;
+    const size_t outputSize = outputRows * outputCols;
+
+    // Overlapping patches write to the same elements, so each point is handled
+    // by one thread.
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t p = 0; p < points; ++p)
+    {
+      for (size_t j = 0; j < outputCols; ++j)
+      {
+        for (size_t i = 0; i < outputRows; ++i)
+        {
+          const eT* columnPtr = columns.colptr(i + j * outputRows +
+              p * outputSize);
+          for (size_t m = 0; m < numMaps; ++m)
+          {
+            const size_t slice = p * mapsPerPoint + firstMap + m;
+            for (size_t kj = 0; kj < kernelCols; ++kj)
+            {
+              eT* outputPtr = output.slice_colptr(slice, j * strideCols + kj) +
+                  i * strideRows;
+              for (size_t ki = 0; ki < kernelRows; ++ki)
+                outputPtr[ki] += *(columnPtr++);
+            }
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  //! Copy `numMaps` maps of each point, starting at `firstMap`, into the
+  //! columns of `product`, one point after another.
+  template<typename CubeType, typename MatType>
+  static void GatherMaps(const CubeType& maps,
+                         const size_t mapsPerPoint,
+                         const size_t firstMap,
+                         const size_t numMaps,
+                         MatType& product)
+  {
+    const size_t points = maps.n_slices / mapsPerPoint;
+    const size_t mapSize = maps.n_rows * maps.n_cols;
+    product.set_size(mapSize * points, numMaps);
+
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t p = 0; p < points; ++p)
+    {
+      for (size_t m = 0; m < numMaps; ++m)
+      {
+        const auto* mapPtr = maps.slice_memptr(p * mapsPerPoint + firstMap + m);
+        std::copy(mapPtr, mapPtr + mapSize, product.colptr(m) + p * mapSize);
+      }
+    }
+  }
+
+  //! The inverse of GatherMaps(): copy the columns of `product` into the maps
+  //! of each point, starting at `firstMap`.
+  template<typename MatType, typename CubeType>
+  static void ScatterMaps(const MatType& product,
+                          const size_t mapsPerPoint,
+                          const size_t firstMap,
+                          CubeType& maps)
+  {
+    const size_t points = maps.n_slices / mapsPerPoint;
+    const size_t mapSize = maps.n_rows * maps.n_cols;
+
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t p = 0; p < points; ++p)
+    {
+      for (size_t m = 0; m < product.n_cols; ++m)
+      {
+        const auto* productPtr = product.colptr(m) + p * mapSize;
+        std::copy(productPtr, productPtr + mapSize,
+            maps.slice_memptr(p * mapsPerPoint + firstMap + m));
+      }
+    }
+  }
+};  // class Im2ColConvolution
+
+/**
+ * Whether a convolution rule is Im2ColConvolution, so that the convolution
+ * layers can convolve whole batches at once with it.
+ */
+template<typename ConvolutionRule>
+struct IsIm2ColConvolution
+{
+  static const bool value = false;
+};
+
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode>>
+{
+  static const bool value = true;
+};
+
+} // namespace mlpack
+
+#endif
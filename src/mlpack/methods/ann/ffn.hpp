@@ -18,6 +18,7 @@
 #include "forward_decls.hpp"
 #include "init_rules/init_rules.hpp"
 #include "loss_functions/loss_functions.hpp"
+#include "mixed_precision_function.hpp"
 
 #include <ensmallen.hpp>
 
@@ -190,11 +191,112 @@ class FFN
                                     MatType responses,
                                     CallbackTypes&&... callbacks);
 
+  /**
+   * Train the feedforward network on a dataset that is read shard by shard
+   * by the given loader, so that the whole dataset never has to be held in
+   * memory.
+   * In each pass, the optimizer is run on each shard in turn, starting from
+   * the parameters left by the previous shard, while the worker threads of the
+   * loader read (and transform) the next shards.
+   *
+   * The optimizer is run once for each shard, so its maximum number of
+   * iterations applies to each shard (e.g. set it to the number of points in
+   * a shard for one epoch over each shard).  Optimizers that keep state
+   * between runs (e.g. the SGD-based optimizers with `ResetPolicy()` set to
+   * false) keep it across shards.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param loader Loader that gives the shards of the dataset.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param passes Number of passes over the shards of the dataset.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The sum of the final objectives on each shard in the last pass.
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  typename MatType::elem_type Train(data::PrefetchingLoader<MatType>& loader,
+                                    OptimizerType& optimizer,
+                                    const size_t passes,
+                                    CallbackTypes&&... callbacks);
+
+  /**
+   * Train the feedforward network with sparse gradients: the optimizer is
+   * given the gradient of each batch as a sparse vector (see
+   * `Layer::SparseGradient()`), so that layers whose gradient only involves
+   * a few weights, like `Lookup`, let an update touch only those weights.
+   * Otherwise, this is the same as `Train()`, except that data-parallel
+   * training is not used.
+   *
+   * The optimizer must support sparse gradient types; an update only touches
+   * the nonzero elements of the gradient with `ens::StandardSGD`, but not with
+   * optimizers that keep a dense state for each weight (e.g. momentum).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  typename MatType::elem_type TrainSparse(MatType predictors,
+                                          MatType responses,
+                                          OptimizerType& optimizer,
+                                          CallbackTypes&&... callbacks);
+
+  /**
+   * Train the feedforward network with mixed precision: the forward and
+   * backward passes are done in the precision of `MatType` (e.g. with
+   * `arma::fmat`), while the optimizer updates a master copy of the parameters
+   * in the higher precision of `MasterMatType` (by default `arma::mat`).  This
+   * roughly halves the memory of the activations and doubles the throughput
+   * of the matrix multiplications, compared to training in `MasterMatType`,
+   * without losing the small updates that would vanish when added to
+   * lower-precision parameters.
+   *
+   * Dynamic loss scaling keeps small gradients from underflowing; the initial
+   * loss scale and the number of steps after which it grows are given by
+   * `LossScale()` and `LossScaleInterval()` (see `MixedPrecisionFunction` for
+   * details).  At the end of training, the master parameters are rounded into
+   * `Parameters()`.  Otherwise, this is the same as `Train()`.
+   *
+   * @tparam MasterMatType Matrix type of the master parameters.
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename MasterMatType = arma::mat,
+           typename OptimizerType,
+           typename... CallbackTypes>
+  typename MatType::elem_type TrainMixedPrecision(MatType predictors,
+                                                  MatType responses,
+                                                  OptimizerType& optimizer,
+                                                  CallbackTypes&&... callbacks);
+
   /**
    * Predict the responses to a given set of predictors. The responses will be
    * the output of the output layer when `predictors` is passed through the
    * whole network (`OutputLayerType`).
    *
+   * Prediction only does inference passes through the network: the outputs of
+   * the layers are not kept, layers that do nothing when testing (such as
+   * `Dropout`) are skipped, and `BatchNorm` layers are folded into the
+   * `Linear` or `Convolution` layer before them.  The folded layers are built
+   * at the first call and kept until the parameters change.
+   *
+   * If `Threads()` is more than one, the batches are passed through replicas
+   * of the network concurrently, one replica for each thread; the replicas
+   * share the parameters of the network but each keeps its own outputs.  The
+   * results are the same as with one thread.
+   *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
    * @param batchSize Batch size to use for prediction.
@@ -203,6 +305,23 @@ class FFN
                MatType& results,
                const size_t batchSize = 128);
 
+  /**
+   * Replace each layer of the network that has a quantized version (`Linear`,
+   * `LinearNoBias` and `Convolution` layers) with a layer that holds its
+   * weights as 8-bit integers (`QuantizedLinear` or `QuantizedConvolution`).
+   * This makes the weights of these layers take 8 times less memory and lets
+   * `Predict()` compute their outputs with integer arithmetic, at the cost of a
+   * small loss of accuracy.  The weights of the other layers are kept as they
+   * are.
+   *
+   * The quantized layers cannot be trained, so the network can only be used
+   * for prediction afterwards: `Train()` will throw an exception.  Layers nested
+   * in other layers (e.g. in a `Concat` layer) are not quantized.  The network
+   * must have been trained (or its parameters set) before calling
+   * `Quantize()`, and `InputDimensions()` must be set.
+   */
+  void Quantize();
+
   // Return the number of weights in the model.
   size_t WeightSize();
 
@@ -230,14 +349,73 @@ class FFN
   //! Get the logical dimensions of the input.
   const std::vector<size_t>& InputDimensions() const { return inputDimensions; }
 
+  /**
+   * Get the number of threads that `Train()` uses for data-parallel training,
+   * and that `Predict()` uses to pass several batches through the network at
+   * once.  If more than one, `Train()` makes a replica of the network for each
+   * thread but the first; each batch of the optimizer is then split into one
+   * shard for each thread, the shards are passed forward and backward through
+   * the replicas in parallel, and the gradients of the shards are summed.  The
+   * replicas share the parameters of the network, and the output layer
+   * evaluates the whole batch, so the objective and gradient are the same as
+   * with one thread, and any ensmallen optimizer and callback can be used.
+   *
+   * Layers that keep state other than their parameters (like the running
+   * statistics of `BatchNorm`) only update it with the first shard of each
+   * batch.  Defaults to 1 (no data parallelism).
+   */
+  size_t Threads() const { return threads; }
+  //! Modify the number of threads that `Train()` uses for data-parallel
+  //! training, and that `Predict()` uses for concurrent batches.
+  size_t& Threads() { return threads; }
+
+  //! Get the initial loss scale of `TrainMixedPrecision()`.  Defaults to
+  //! 65536.
+  double LossScale() const { return lossScale; }
+  //! Modify the initial loss scale of `TrainMixedPrecision()`.
+  double& LossScale() { return lossScale; }
+
+  //! Get the number of steps without overflow after which
+  //! `TrainMixedPrecision()` doubles the loss scale (0 means never).  Defaults
+  //! to 2000.
+  size_t LossScaleInterval() const { return lossScaleInterval; }
+  //! Modify the number of steps without overflow after which
+  //! `TrainMixedPrecision()` doubles the loss scale (0 means never).
+  size_t& LossScaleInterval() { return lossScaleInterval; }
+
+  //! Get the indices of the layers whose outputs are kept during training, if
+  //! activation checkpointing is used (see `MultiLayer::Checkpoints()`).
+  const std::vector<size_t>& Checkpoints() const
+  {
+    return network.Checkpoints();
+  }
+  //! Modify the indices of the layers whose outputs are kept during training;
+  //! the outputs of the other layers are computed again during the backward
+  //! pass, which uses less memory (see `MultiLayer::Checkpoints()`).
+  std::vector<size_t>& Checkpoints() { return network.Checkpoints(); }
+
+  //! Get the profiler that records the passes of each layer (NULL if none).
+  LayerProfiler* Profiler() const { return network.Profiler(); }
+  //! Modify the profiler that records the passes of each layer (NULL by
+  //! default); see `LayerProfiler`.  The profiler is not copied by copies of
+  //! the network, and the replicas used for data-parallel training (see
+  //! `Threads()`) are not profiled.
+  LayerProfiler*& Profiler() { return network.Profiler(); }
+
   //! Return the current set of weights.  These are linearized: this contains
   //! the weights of every layer.
   const MatType& Parameters() const { return parameters; }
   //! Modify the current set of weights.  These are linearized: this contains
   //! the weights of every layer.  Be careful!  If you change the shape of
   //! `parameters` to something incorrect, it may be re-initialized the next
-  //! time a forward pass is done.
-  MatType& Parameters() { return parameters; }
+  //! time a forward pass is done.  (If you keep the reference and change the
+  //! weights after a call to `Predict()`, call `Parameters()` again before the
+  //! next call to `Predict()`, which caches layers built from the weights.)
+  MatType& Parameters()
+  {
+    network.ResetInferenceNetwork();
+    return parameters;
+  }
 
   /**
    * Reset the stored data of the network entirely.  This resets all weights of
@@ -318,7 +496,13 @@ class FFN
   typename MatType::elem_type Evaluate(const MatType& predictors,
                                        const MatType& responses);
 
-  //! Serialize the model.
+  /**
+   * Serialize the model.  The parameters of the network are one contiguous
+   * matrix, so when the model is saved with `data::SaveMapped()` they are
+   * stored as one page-aligned block; a model loaded with `data::LoadMapped()`
+   * then uses the mapped block directly as the weights of its layers, without
+   * copying it, and several processes can share it.
+   */
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
 
@@ -412,6 +596,46 @@ class FFN
                 MatType& gradient,
                 const size_t batchSize);
 
+  /**
+   * Note: this function is implemented so that it can be used by ensmallen's
+   * optimizers.  It's not generally meant to be used otherwise.
+   *
+   * Evaluate the feedforward network with the given parameters on a number of
+   * data points, and compute the gradient as a sparse vector (see
+   * `TrainSparse()`).
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Sparse vector to output gradient into.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  typename MatType::elem_type EvaluateWithGradient(
+      const MatType& parameters,
+      const size_t begin,
+      arma::SpMat<typename MatType::elem_type>& gradient,
+      const size_t batchSize);
+
+  /**
+   * Note: this function is implemented so that it can be used by ensmallen's
+   * optimizers.  It's not generally meant to be used otherwise.
+   *
+   * Evaluate the gradient of the feedforward network as a sparse vector, with
+   * respect to only a number of points in the dataset (see `TrainSparse()`).
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Sparse vector to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const MatType& parameters,
+                const size_t begin,
+                arma::SpMat<typename MatType::elem_type>& gradient,
+                const size_t batchSize);
+
   /**
    * Note: this function is implemented so that it can be used by ensmallen's
    * optimizers.  It's not generally meant to be used otherwise.
@@ -539,6 +763,17 @@ class FFN
   //! except during training.
   MatType responses;
 
+  //! The number of threads used for data-parallel training.
+  size_t threads;
+
+  //! The initial loss scale of mixed-precision training.
+  double lossScale;
+  //! The number of steps without overflow after which the loss scale grows.
+  size_t lossScaleInterval;
+  //! The scale applied to the error of the output layer before the backward
+  //! pass; this is only different from 1 during mixed-precision training.
+  typename MatType::elem_type errorScale;
+
   //! Locally-stored output of the network from a forward pass; used by the
   //! backward pass.
   MatType networkOutput;
@@ -547,6 +782,12 @@ class FFN
   //! Locally-stored error of the backward pass; used by the gradient pass.
   MatType error;
 
+  //! Replicas of `network` used for data-parallel training, one for each
+  //! thread but the first.  This member is empty, except during training.
+  std::vector<MultiLayer<MatType>> replicas;
+  //! Locally-stored gradients of the replicas.
+  std::vector<MatType> replicaGradients;
+
   //! If true, each layer has its memory properly set for a forward/backward
   //! pass.
   bool layerMemoryIsSet;
@@ -557,6 +798,11 @@ class FFN
 
   // RNN will call `CheckNetwork()`, which is private.
   friend class RNN<OutputLayerType, InitializationRuleType, MatType>;
+
+  // MixedPrecisionFunction sets `errorScale`.
+  template<typename NetworkType, typename NetworkMatType,
+           typename MasterMatType>
+  friend class MixedPrecisionFunction;
 }; // class FFN
 
 } // namespace mlpack
@@ -564,4 +810,17 @@ class FFN
 // Include implementation.
 #include "ffn_impl.hpp"
 
+// If MLPACK_USE_PREBUILT is defined, the common instantiations below are
+// compiled into libmlpack (see BUILD_PREBUILT_LIBRARY), and are not
+// instantiated again here.
+#ifdef MLPACK_USE_PREBUILT
+namespace mlpack {
+
+extern template class FFN<NegativeLogLikelihood, RandomInitialization,
+    arma::mat>;
+extern template class FFN<MeanSquaredError, RandomInitialization, arma::mat>;
+
+} // namespace mlpack
+#endif
+
 #endif
@@ -29,6 +29,10 @@ FFN<
 >::FFN(OutputLayerType outputLayer, InitializationRuleType initializeRule) :
     outputLayer(std::move(outputLayer)),
     initializeRule(std::move(initializeRule)),
+    threads(1),
+    lossScale(65536.0),
+    lossScaleInterval(2000),
+    errorScale(1),
     layerMemoryIsSet(false),
     inputDimensionsAreSet(false)
 {
@@ -50,6 +54,10 @@ FFN<
     inputDimensions(network.inputDimensions),
     predictors(network.predictors),
     responses(network.responses),
+    threads(network.threads),
+    lossScale(network.lossScale),
+    lossScaleInterval(network.lossScaleInterval),
+    errorScale(1),
     // These will be set correctly in the first Forward() call.
     layerMemoryIsSet(false),
     inputDimensionsAreSet(false)
@@ -72,6 +80,10 @@ FFN<
     inputDimensions(std::move(network.inputDimensions)),
     predictors(std::move(network.predictors)),
     responses(std::move(network.responses)),
+    threads(network.threads),
+    lossScale(network.lossScale),
+    lossScaleInterval(network.lossScaleInterval),
+    errorScale(1),
     // Aliases will not be correct after a std::move(), so we will manually
     // reset them.
     layerMemoryIsSet(false),
@@ -98,6 +110,9 @@ FFN<OutputLayerType, InitializationRuleType, MatType>& FFN<
     inputDimensions = other.inputDimensions;
     predictors = other.predictors;
     responses = other.responses;
+    threads = other.threads;
+    lossScale = other.lossScale;
+    lossScaleInterval = other.lossScaleInterval;
     networkOutput = other.networkOutput;
     networkDelta = other.networkDelta;
     error = other.error;
@@ -129,6 +144,9 @@ FFN<OutputLayerType, InitializationRuleType, MatType>& FFN<
     inputDimensions = std::move(other.inputDimensions);
     predictors = std::move(other.predictors);
     responses = std::move(other.responses);
+    threads = other.threads;
+    lossScale = other.lossScale;
+    lossScaleInterval = other.lossScaleInterval;
     networkOutput = std::move(other.networkOutput);
     networkDelta = std::move(other.networkDelta);
     error = std::move(other.error);
@@ -159,12 +177,24 @@ typename MatType::elem_type FFN<
   // Ensure that the network can be used.
   CheckNetwork("FFN::Train()", this->predictors.n_rows, true, true);
 
+  // For data-parallel training, make a replica of the network for each extra
+  // thread; EvaluateWithGradient() passes one shard of each batch through
+  // each of them.
+  replicas.assign((threads > 1) ? threads - 1 : 0, network);
+
   // Train the model.
   Timer::Start("ffn_optimization");
   const typename MatType::elem_type out =
       optimizer.Optimize(*this, parameters, callbacks...);
   Timer::Stop("ffn_optimization");
 
+  replicas.clear();
+  replicaGradients.clear();
+
+  // The parameters have changed, so the layers used by Predict() must be built
+  // again.
+  network.ResetInferenceNetwork();
+
   Log::Info << "FFN::Train(): final objective of trained model is " << out
       << "." << std::endl;
   return out;
@@ -187,6 +217,126 @@ typename MatType::elem_type FFN<
       callbacks...);
 }
 
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::TrainSparse(MatType predictors,
+               MatType responses,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
+
+  // Ensure that the network can be used.
+  CheckNetwork("FFN::TrainSparse()", this->predictors.n_rows, true, true);
+
+  // Train the model, with sparse gradients.
+  Timer::Start("ffn_optimization");
+  const typename MatType::elem_type out = optimizer.template Optimize<FFN,
+      MatType, arma::SpMat<typename MatType::elem_type>>(*this, parameters,
+      callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  // The parameters have changed, so the layers used by Predict() must be built
+  // again.
+  network.ResetInferenceNetwork();
+
+  Log::Info << "FFN::TrainSparse(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename MasterMatType,
+         typename OptimizerType,
+         typename... CallbackTypes>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::TrainMixedPrecision(MatType predictors,
+                       MatType responses,
+                       OptimizerType& optimizer,
+                       CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
+
+  // Ensure that the network can be used.
+  CheckNetwork("FFN::TrainMixedPrecision()", this->predictors.n_rows, true,
+      true);
+
+  replicas.assign((threads > 1) ? threads - 1 : 0, network);
+
+  // The optimizer updates the master parameters, which are rounded into
+  // `parameters` for each evaluation of the network.
+  MixedPrecisionFunction<FFN, MatType, MasterMatType> function(*this,
+      lossScale, lossScaleInterval);
+  MasterMatType masterParameters =
+      arma::conv_to<MasterMatType>::from(parameters);
+
+  Timer::Start("ffn_optimization");
+  const typename MasterMatType::elem_type out =
+      optimizer.Optimize(function, masterParameters, callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  function.SetParameters(masterParameters);
+
+  replicas.clear();
+  replicaGradients.clear();
+
+  // The parameters have changed, so the layers used by Predict() must be built
+  // again.
+  network.ResetInferenceNetwork();
+
+  Log::Info << "FFN::TrainMixedPrecision(): final objective of trained model "
+      << "is " << out << "; " << function.SkippedSteps() << " steps were "
+      << "skipped because of overflow, and the final loss scale is "
+      << function.Scale() << "." << std::endl;
+  return static_cast<typename MatType::elem_type>(out);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Train(data::PrefetchingLoader<MatType>& loader,
+         OptimizerType& optimizer,
+         const size_t passes,
+         CallbackTypes&&... callbacks)
+{
+  typename MatType::elem_type objective = 0;
+  MatType shardPredictors, shardResponses;
+  for (size_t pass = 0; pass < passes; ++pass)
+  {
+    loader.Reset();
+    objective = 0;
+
+    // The loader reads the next shards while the model is trained on this one.
+    while (loader.Next(shardPredictors, shardResponses))
+    {
+      objective += Train(std::move(shardPredictors), std::move(shardResponses),
+          optimizer, callbacks...);
+    }
+  }
+
+  return objective;
+}
+
 template<typename OutputLayerType,
          typename InitializationRuleType,
          typename MatType>
@@ -201,21 +351,99 @@ void FFN<
 
   results.set_size(network.OutputSize(), predictors.n_cols);
 
-  for (size_t i = 0; i < predictors.n_cols; i += batchSize)
+  // There is no backward pass, so the outputs of the layers do not need to be
+  // kept, and layers that do nothing when testing can be skipped or folded
+  // into other layers.
+  network.KeepOutputs() = false;
+  network.Inference() = true;
+
+  // With several threads, each one passes every `workers`-th batch through its
+  // own replica of the network (the first thread uses `network` itself), so
+  // that each has its own layer outputs; the replicas share the parameters.
+  const size_t batches = (predictors.n_cols + batchSize - 1) / batchSize;
+  const size_t workers = std::max(std::min(threads, batches), size_t(1));
+  std::vector<MultiLayer<MatType>> predictReplicas(workers - 1, network);
+  for (size_t w = 1; w < workers; ++w)
+    predictReplicas[w - 1].SetWeights(MemPtr(parameters));
+
+  #pragma omp parallel for num_threads(workers) if (workers > 1)
+  for (size_t w = 0; w < workers; ++w)
   {
-    const size_t effectiveBatchSize = std::min(batchSize,
-        size_t(predictors.n_cols) - i);
+    MultiLayer<MatType>& workerNetwork = (w == 0) ? network :
+        predictReplicas[w - 1];
+    for (size_t b = w; b < batches; b += workers)
+    {
+      const size_t i = b * batchSize;
+      const size_t effectiveBatchSize = std::min(batchSize,
+          size_t(predictors.n_cols) - i);
 
-    const MatType predictorAlias(
-        const_cast<typename MatType::elem_type*>(predictors.colptr(i)),
-        predictors.n_rows, effectiveBatchSize, false, true);
-    MatType resultAlias(results.colptr(i), results.n_rows,
-        effectiveBatchSize, false, true);
+      MatType predictorAlias, resultAlias;
+      MakeAlias(predictorAlias, ColPtr(predictors, i), predictors.n_rows,
+          effectiveBatchSize);
+      MakeAlias(resultAlias, ColPtr(results, i), results.n_rows,
+          effectiveBatchSize);
 
-    network.Forward(predictorAlias, resultAlias);
+      workerNetwork.Forward(predictorAlias, resultAlias);
+    }
   }
+
+  network.Inference() = false;
 }
 
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Quantize()
+{
+  if (inputDimensions.empty())
+  {
+    throw std::invalid_argument("FFN::Quantize(): the input dimensions must be "
+        "set with InputDimensions() before quantizing the network!");
+  }
+
+  size_t inputDimensionality = inputDimensions[0];
+  for (size_t i = 1; i < inputDimensions.size(); ++i)
+    inputDimensionality *= inputDimensions[i];
+
+  // Make sure that the layers point at the current parameters.
+  CheckNetwork("FFN::Quantize()", inputDimensionality);
+
+  // Replace the layers that can be quantized, and collect the weights of the
+  // other layers, in order, into the new parameters.
+  std::vector<Layer<MatType>*>& layers = network.Network();
+  MatType newParameters(network.WeightSize(), 1);
+  size_t offset = 0, newOffset = 0;
+  for (size_t i = 0; i < layers.size(); ++i)
+  {
+    const size_t weightSize = layers[i]->WeightSize();
+    Layer<MatType>* quantizedLayer = layers[i]->QuantizedCopy();
+    if (quantizedLayer != NULL)
+    {
+      delete layers[i];
+      layers[i] = quantizedLayer;
+    }
+    else if (weightSize > 0)
+    {
+      newParameters.rows(newOffset, newOffset + weightSize - 1) =
+          parameters.rows(offset, offset + weightSize - 1);
+      newOffset += weightSize;
+    }
+
+    offset += weightSize;
+  }
+
+  newParameters.resize(newOffset, 1);
+  parameters = std::move(newParameters);
+
+  // The new layers have to compute their output dimensions and be given their
+  // memory.
+  network.ComputeOutputDimensions();
+  SetLayerMemory();
+}
 template<typename OutputLayerType,
          typename InitializationRuleType,
          typename MatType>
@@ -308,9 +536,10 @@ void FFN<
   // Ensure the network is valid.
   CheckNetwork("FFN::Forward()", inputs.n_rows);
 
-  // We must always store a copy of the forward pass in `networkOutputs` in case
-  // we do a backward pass.
+  // We must always store a copy of the forward pass in `networkOutputs` (and
+  // keep the outputs of each layer) in case we do a backward pass.
   networkOutput.set_size(network.OutputSize(), inputs.n_cols);
+  network.KeepOutputs() = true;
   network.Forward(inputs, networkOutput, begin, end);
 
   // It's possible the user passed `networkOutput` as `results`; in this case,
@@ -360,7 +589,9 @@ typename MatType::elem_type FFN<
   CheckNetwork("FFN::Evaluate()", predictors.n_rows);
 
   // Set networkOutput to the right size if needed, then perform the forward
-  // pass.
+  // pass.  There is no backward pass, so the outputs of the layers do not need
+  // to be kept.
+  network.KeepOutputs() = false;
   network.Forward(predictors, networkOutput);
 
   return outputLayer.Forward(networkOutput, responses) + network.Loss();
@@ -413,7 +644,8 @@ void FFN<
       inputDimensionsAreSet = false;
 
       // The weights in `parameters` will be correctly set for each layer in the
-      // first call to Forward().
+      // first call to Forward().  Since the layers only alias `parameters`, a
+      // model loaded from a mapped file uses the mapped memory directly.
     }
   #endif
 }
@@ -451,8 +683,11 @@ typename MatType::elem_type FFN<
   // pass.
   networkOutput.set_size(network.OutputSize(), batchSize);
   MatType predictorsBatch, responsesBatch;
-  MakeAlias(predictorsBatch, predictors.colptr(begin), predictors.n_rows, batchSize);
-  MakeAlias(responsesBatch, responses.colptr(begin), responses.n_rows, batchSize);
+  MakeAlias(predictorsBatch, ColPtr(predictors, begin), predictors.n_rows,
+      batchSize);
+  MakeAlias(responsesBatch, ColPtr(responses, begin), responses.n_rows,
+      batchSize);
+  network.KeepOutputs() = false;
   network.Forward(predictorsBatch, networkOutput);
 
   return outputLayer.Forward(networkOutput, responsesBatch) + network.Loss();
@@ -469,7 +704,8 @@ typename MatType::elem_type FFN<
 {
   typename MatType::elem_type res = 0;
   res += EvaluateWithGradient(parameters, 0, gradient, 1);
-  MatType tmpGradient(gradient.n_rows, gradient.n_cols, arma::fill::none);
+  MatType tmpGradient;
+  tmpGradient.set_size(gradient.n_rows, gradient.n_cols);
   for (size_t i = 1; i < predictors.n_cols; ++i)
   {
     res += EvaluateWithGradient(parameters, i, tmpGradient, 1);
@@ -499,27 +735,87 @@ typename MatType::elem_type FFN<
 
   // Alias the batches so we don't copy memory.
   MatType predictorsBatch, responsesBatch;
-  MakeAlias(predictorsBatch, predictors.colptr(begin), predictors.n_rows,
+  MakeAlias(predictorsBatch, ColPtr(predictors, begin), predictors.n_rows,
       batchSize);
-  MakeAlias(responsesBatch, responses.colptr(begin), responses.n_rows,
+  MakeAlias(responsesBatch, ColPtr(responses, begin), responses.n_rows,
       batchSize);
 
-  network.Forward(predictorsBatch, networkOutput);
+  // During data-parallel training, the batch is split into one shard for each
+  // replica of the network; the first shard is passed through `network`
+  // itself.  The replicas share the parameters of `network`.
+  const size_t shards = std::min(replicas.size() + 1, batchSize);
+  for (size_t s = 1; s < shards; ++s)
+    replicas[s - 1].SetWeights(MemPtr(this->parameters));
 
+  #pragma omp parallel for num_threads(shards) if (shards > 1)
+  for (size_t s = 0; s < shards; ++s)
+  {
+    MultiLayer<MatType>& shardNetwork = (s == 0) ? network : replicas[s - 1];
+    const size_t first = s * batchSize / shards;
+    const size_t shardSize = (s + 1) * batchSize / shards - first;
+
+    MatType shardPredictors, shardOutput;
+    MakeAlias(shardPredictors, ColPtr(predictorsBatch, first),
+        predictorsBatch.n_rows, shardSize);
+    MakeAlias(shardOutput, ColPtr(networkOutput, first), networkOutput.n_rows,
+        shardSize);
+
+    shardNetwork.KeepOutputs() = true;
+    shardNetwork.Forward(shardPredictors, shardOutput);
+  }
+
+  // The output layer sees the whole batch, so that the objective and the error
+  // are the same as without shards, whatever the reduction of the loss.
   const typename MatType::elem_type obj = outputLayer.Forward(networkOutput,
       responsesBatch) + network.Loss();
 
-  // Now perform the backward pass.
+  // Now perform the backward pass.  During mixed-precision training, the error
+  // is scaled so that small gradients do not underflow.
   outputLayer.Backward(networkOutput, responsesBatch, error);
+  if (errorScale != 1)
+    error *= errorScale;
 
-  // The delta should have the same size as the input.
+  // The delta should have the same size as the input, and the gradient should
+  // have the same size as the parameters.
   networkDelta.set_size(predictors.n_rows, batchSize);
-  network.Backward(predictorsBatch, networkOutput, error, networkDelta);
-
-  // Now compute the gradients.
-  // The gradient should have the same size as the parameters.
   gradient.set_size(parameters.n_rows, parameters.n_cols);
-  network.Gradient(predictorsBatch, error, gradient);
+  replicaGradients.resize(replicas.size());
+
+  #pragma omp parallel for num_threads(shards) if (shards > 1)
+  for (size_t s = 0; s < shards; ++s)
+  {
+    MultiLayer<MatType>& shardNetwork = (s == 0) ? network : replicas[s - 1];
+    const size_t first = s * batchSize / shards;
+    const size_t shardSize = (s + 1) * batchSize / shards - first;
+
+    MatType shardPredictors, shardOutput, shardError, shardDelta;
+    MakeAlias(shardPredictors, ColPtr(predictorsBatch, first),
+        predictorsBatch.n_rows, shardSize);
+    MakeAlias(shardOutput, ColPtr(networkOutput, first), networkOutput.n_rows,
+        shardSize);
+    MakeAlias(shardError, ColPtr(error, first), error.n_rows, shardSize);
+    MakeAlias(shardDelta, ColPtr(networkDelta, first), networkDelta.n_rows,
+        shardSize);
+
+    shardNetwork.Backward(shardPredictors, shardOutput, shardError,
+        shardDelta);
+
+    // Now compute the gradients.
+    MatType& shardGradient = (s == 0) ? gradient : replicaGradients[s - 1];
+    shardGradient.set_size(parameters.n_rows, parameters.n_cols);
+    shardNetwork.Gradient(shardPredictors, shardError, shardGradient);
+  }
+
+  // Reduce the gradients of the shards.
+  if (shards > 1)
+  {
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t i = 0; i < (size_t) gradient.n_elem; ++i)
+    {
+      for (size_t s = 1; s < shards; ++s)
+        gradient[i] += replicaGradients[s - 1][i];
+    }
+  }
 
   return obj;
 }
@@ -539,6 +835,59 @@ void FFN<
   this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
 }
 
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::EvaluateWithGradient(const MatType& /* parameters */,
+                        const size_t begin,
+                        arma::SpMat<typename MatType::elem_type>& gradient,
+                        const size_t batchSize)
+{
+  CheckNetwork("FFN::EvaluateWithGradient()", predictors.n_rows);
+
+  // Alias the batches so we don't copy memory.
+  MatType predictorsBatch, responsesBatch;
+  MakeAlias(predictorsBatch, ColPtr(predictors, begin), predictors.n_rows,
+      batchSize);
+  MakeAlias(responsesBatch, ColPtr(responses, begin), responses.n_rows,
+      batchSize);
+
+  networkOutput.set_size(network.OutputSize(), batchSize);
+  network.KeepOutputs() = true;
+  network.Forward(predictorsBatch, networkOutput);
+
+  const typename MatType::elem_type obj = outputLayer.Forward(networkOutput,
+      responsesBatch) + network.Loss();
+
+  // Now perform the backward pass, and let each layer compute its part of the
+  // sparse gradient.
+  outputLayer.Backward(networkOutput, responsesBatch, error);
+  networkDelta.set_size(predictors.n_rows, batchSize);
+  network.Backward(predictorsBatch, networkOutput, error, networkDelta);
+  network.SparseGradient(predictorsBatch, error, gradient);
+
+  return obj;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Gradient(const MatType& parameters,
+            const size_t begin,
+            arma::SpMat<typename MatType::elem_type>& gradient,
+            const size_t batchSize)
+{
+  this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
 template<typename OutputLayerType,
          typename InitializationRuleType,
          typename MatType>
@@ -598,7 +947,7 @@ void FFN<
       "FFN::SetLayerMemory(): total layer weight size does not match parameter "
       "size!");
 
-  network.SetWeights(parameters.memptr());
+  network.SetWeights(MemPtr(parameters));
   layerMemoryIsSet = true;
 }
 
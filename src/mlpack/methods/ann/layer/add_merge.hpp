@@ -88,6 +88,15 @@ class AddMergeType : public MultiLayer<MatType>
                 const MatType& error,
                 MatType& gradient);
 
+  //! Compute the sparse gradient from the dense gradient given by `Gradient()`
+  //! (the layers are not run the same way as in `MultiLayer`).
+  void SparseGradient(const MatType& input,
+                      const MatType& error,
+                      arma::SpMat<typename MatType::elem_type>& gradient)
+  {
+    Layer<MatType>::SparseGradient(input, error, gradient);
+  }
+
   //! Compute the size of the output given `InputDimensions()`.
   void ComputeOutputDimensions();
 
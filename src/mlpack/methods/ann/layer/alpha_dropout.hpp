@@ -18,6 +18,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "layer.hpp"
+#include "dropout_mask.hpp"
 
 namespace mlpack {
 
@@ -94,6 +95,9 @@ class AlphaDropoutType : public Layer<MatType>
                 const MatType& gy,
                 MatType& g);
 
+  //! The alpha dropout layer does nothing when it is not in training mode.
+  bool IsIdentityWhenTesting() const { return true; }
+
   //! The probability of setting a value to alphaDash.
   double Ratio() const { return ratio; }
 
@@ -106,8 +110,14 @@ class AlphaDropoutType : public Layer<MatType>
   //! Value of alphaDash.
   double AlphaDash() const { return alphaDash; }
 
-  //! Get the mask.
-  const MatType& Mask() const { return mask; }
+  //! Get the mask, with a 1 for each kept element and a 0 for each element set
+  //! to alphaDash.
+  MatType Mask() const
+  {
+    MatType m;
+    mask.ToMatrix(m);
+    return m;
+  }
 
   //! Modify the probability of setting a value to alphaDash. As
   //! 'a' and 'b' depend on 'ratio', modify them as well.
@@ -126,7 +136,7 @@ class AlphaDropoutType : public Layer<MatType>
 
  private:
   //! Locally-stored mask object.
-  MatType mask;
+  DropoutMask mask;
 
   //! The probability of setting a value to aplhaDash.
   double ratio;
@@ -115,6 +115,18 @@ class BaseLayer : public Layer<MatType>
     g = gy % derivative;
   }
 
+  /**
+   * Apply the activation in place to each element of `x`.
+   *
+   * @param x Elements to apply the activation to.
+   * @return Always true.
+   */
+  bool TestingActivation(MatType& x) const
+  {
+    return TestingActivation(x,
+        std::integral_constant<bool, IsCootType<MatType>::value>());
+  }
+
   /**
    * Serialize the layer.
    */
@@ -124,6 +136,26 @@ class BaseLayer : public Layer<MatType>
     ar(cereal::base_class<Layer<MatType>>(this));
     // Nothing to serialize.
   }
+
+ private:
+  //! Apply the activation to each element through a host pointer.
+  bool TestingActivation(MatType& x, const std::false_type /* coot */) const
+  {
+    typedef typename MatType::elem_type ElemType;
+    ElemType* elements = x.memptr();
+    for (size_t i = 0; i < (size_t) x.n_elem; ++i)
+      elements[i] = (ElemType) ActivationFunction::Fn(elements[i]);
+
+    return true;
+  }
+
+  //! The elements of Bandicoot matrices are not accessible on the host, so the
+  //! activation cannot be fused into other layers.
+  bool TestingActivation(MatType& /* x */, const std::true_type /* coot */)
+      const
+  {
+    return false;
+  }
 }; // class BaseLayer
 
 // Convenience typedefs.
@@ -164,6 +164,18 @@ class BatchNormType : public Layer<MatType>
                 const MatType& error,
                 MatType& gradient);
 
+  /**
+   * When not in training mode, batch normalization scales and shifts each
+   * channel with the running mean and variance; store the scale and shift of
+   * each output element in `scale` and `shift`, so that the layer can be folded
+   * into the layer before it.
+   *
+   * @param scale Vector to store the scale of each output element in.
+   * @param shift Vector to store the shift of each output element in.
+   * @return Always true.
+   */
+  bool TestingAffine(MatType& scale, MatType& shift);
+
   //! Get the parameters.
   const MatType& Parameters() const { return weights; }
   //! Modify the parameters.
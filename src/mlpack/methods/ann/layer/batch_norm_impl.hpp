@@ -327,6 +327,27 @@ void BatchNormType<MatType>::Gradient(
   gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) = temp.t();
 }
 
+template<typename MatType>
+bool BatchNormType<MatType>::TestingAffine(MatType& scale, MatType& shift)
+{
+  // In testing mode, the output is
+  //   (input - runningMean) / sqrt(runningVariance + eps) * gamma + beta
+  // for each channel.
+  const MatType channelScale = gamma / sqrt(runningVariance + eps);
+  const MatType channelShift = beta - runningMean % channelScale;
+
+  scale.set_size(inputDimension * size * higherDimension, 1);
+  shift.set_size(inputDimension * size * higherDimension, 1);
+  arma::Cube<typename MatType::elem_type> scaleTemp(scale.memptr(),
+      inputDimension, size, higherDimension, false, true);
+  arma::Cube<typename MatType::elem_type> shiftTemp(shift.memptr(),
+      inputDimension, size, higherDimension, false, true);
+  scaleTemp.each_slice() = repmat(channelScale.t(), inputDimension, 1);
+  shiftTemp.each_slice() = repmat(channelShift.t(), inputDimension, 1);
+
+  return true;
+}
+
 template<typename MatType>
 void BatchNormType<MatType>::ComputeOutputDimensions()
 {
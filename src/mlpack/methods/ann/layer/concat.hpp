@@ -24,6 +24,13 @@ namespace mlpack {
  * feed-forward fully connected network container which plugs various layers
  * together.
  *
+ * The outputs and deltas of the held layers are stored in the memory planned
+ * by `MultiLayer`.  When the outputs of the layers are contiguous parts of the
+ * concatenated output (for a single point, concatenated along the last axis),
+ * the layers write their outputs directly into it, and take their parts of
+ * the backpropagated error as aliases; otherwise, the parts are copied.  The
+ * first layer writes its delta directly into the delta of the concatenation.
+ *
  * NOTE: this class is not intended to exist for long!  It will be replaced with
  * a more flexible DAG network type.
  *
@@ -130,6 +137,15 @@ class ConcatType : public MultiLayer<MatType>
                 MatType& gradient,
                 const size_t index);
 
+  //! Compute the sparse gradient from the dense gradient given by `Gradient()`
+  //! (the layers are not run the same way as in `MultiLayer`).
+  void SparseGradient(const MatType& input,
+                      const MatType& error,
+                      arma::SpMat<typename MatType::elem_type>& gradient)
+  {
+    Layer<MatType>::SparseGradient(input, error, gradient);
+  }
+
   //! Get the axis of concatenation.
   size_t Axis() const { return axis; }
 
@@ -211,6 +227,9 @@ class ConcatType : public MultiLayer<MatType>
     this->totalInputSize *= this->network.size();
     for (size_t i = 0; i < this->outputDimensions.size(); ++i)
       this->totalOutputSize *= this->outputDimensions[i];
+
+    // The memory for the passes must be planned again.
+    this->trainingMemoryBatchSize = 0;
   }
 
   /**
@@ -220,11 +239,38 @@ class ConcatType : public MultiLayer<MatType>
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
+  /**
+   * Compute the size of the cube view of a batch of outputs (see `Forward()`):
+   * `rows` is the product of the output dimensions before the axis, and
+   * `slices` is the batch size times the product of the dimensions after it.
+   */
+  void CubeDimensions(const size_t batchSize,
+                      size_t& rows,
+                      size_t& slices) const;
+
+  /**
+   * Set `layerErrors` to the part of `error` that belongs to each layer.  The
+   * parts are aliases of `error` if they are contiguous in it (that is, if
+   * `CubeDimensions()` gives only one slice); otherwise they are copied into
+   * `errorMemory`.  If `force` is false and `error` is the matrix that was
+   * last split (e.g. `Gradient()` after `Backward()`), nothing is done.
+   */
+  void SplitError(const MatType& error, const bool force);
+
   //! Parameter which indicates the axis of concatenation.
   size_t axis;
 
   //! Parameter which indicates whether to use the axis of concatenation.
   bool useAxis;
+
+  //! The part of the last error given to `Backward()` or `Gradient()` that
+  //! belongs to each layer.
+  std::vector<MatType> layerErrors;
+  //! Memory for `layerErrors`, when they are not aliases of the error.
+  MatType errorMemory;
+  //! The memory and the number of columns of the error that was last split.
+  const typename MatType::elem_type* lastErrorPtr;
+  size_t lastErrorCols;
 }; // class ConcatType.
 
 // Standard Concat layer.
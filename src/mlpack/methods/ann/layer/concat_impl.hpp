@@ -23,7 +23,9 @@ ConcatType<MatType>::ConcatType(
     const size_t axis) :
     MultiLayer<MatType>(),
     axis(axis),
-    useAxis(true)
+    useAxis(true),
+    lastErrorPtr(NULL),
+    lastErrorCols(0)
 {
   // Nothing to do.
 }
@@ -32,7 +34,9 @@ template<typename MatType>
 ConcatType<MatType>::ConcatType() :
     MultiLayer<MatType>(),
     axis(0),
-    useAxis(false)
+    useAxis(false),
+    lastErrorPtr(NULL),
+    lastErrorCols(0)
 {
   // Nothing to do.
 }
@@ -47,7 +51,9 @@ template<typename MatType>
 ConcatType<MatType>::ConcatType(const ConcatType& other) :
     MultiLayer<MatType>(other),
     axis(other.axis),
-    useAxis(other.useAxis)
+    useAxis(other.useAxis),
+    lastErrorPtr(NULL),
+    lastErrorCols(0)
 {
   // Nothing else to do.
 }
@@ -56,7 +62,9 @@ template<typename MatType>
 ConcatType<MatType>::ConcatType(ConcatType&& other) :
     MultiLayer<MatType>(std::move(other)),
     axis(std::move(other.axis)),
-    useAxis(std::move(other.useAxis))
+    useAxis(std::move(other.useAxis)),
+    lastErrorPtr(NULL),
+    lastErrorCols(0)
 {
   // Nothing else to do.
 }
@@ -69,6 +77,10 @@ ConcatType<MatType>& ConcatType<MatType>::operator=(const ConcatType& other)
     MultiLayer<MatType>::operator=(other);
     axis = other.axis;
     useAxis = other.useAxis;
+    layerErrors.clear();
+    errorMemory.clear();
+    lastErrorPtr = NULL;
+    lastErrorCols = 0;
   }
 
   return *this;
@@ -82,6 +94,10 @@ ConcatType<MatType>& ConcatType<MatType>::operator=(ConcatType&& other)
     MultiLayer<MatType>::operator=(std::move(other));
     axis = std::move(other.axis);
     useAxis = std::move(other.useAxis);
+    layerErrors.clear();
+    errorMemory.clear();
+    lastErrorPtr = NULL;
+    lastErrorCols = 0;
   }
 
   return *this;
@@ -91,58 +107,54 @@ template<typename MatType>
 void ConcatType<MatType>::Forward(const MatType& input, MatType& output)
 {
   // The implementation of MultiLayer is fine: this will allocate a matrix that
-  // is able to hold each child layer's output.
-  this->InitializeForwardPassMemory(input.n_cols);
-
-  // Pass the input through all the layers in the network.
-  for (size_t i = 0; i < this->network.size(); ++i)
-  {
-    this->network[i]->Forward(input, this->layerOutputs[i]);
-  }
-
-  // Now concatenate the outputs along the correct axis.
-  // We can actually use Armadillo to do this for us---we will treat the axis of
-  // interest as "columns", any axes that come before the axis of interest as
-  // 'flattened slices', and any axes that come after the axis of interest as
-  // 'flattened rows'.  As a result, we will only have to do join_cols() to
-  // produce the right result.
+  // is able to hold each child layer's output (and delta).
+  this->InitializeParallelPassMemory(input.n_cols);
+
+  // We can actually use Armadillo to concatenate the outputs for us---we will
+  // treat the axis of interest as "columns", any axes that come before the axis
+  // of interest as 'flattened rows', and any axes that come after the axis of
+  // interest as 'flattened slices'.  As a result, we will only have to copy
+  // blocks of columns to produce the right result.
   //
   // Note that we will have one "extra" axis in addition to
   // this->outputDimensions.size(); that is the batch size (represented as the
   // number of columns in `input`).
+  size_t rows, slices;
+  CubeDimensions(input.n_cols, rows, slices);
 
-  size_t rows = 1;
-  for (size_t i = 0; i < axis; ++i)
-    rows *= this->outputDimensions[i];
-
-  size_t slices = input.n_cols;
-  for (size_t i = axis + 1; i < this->outputDimensions.size(); ++i)
-    slices *= this->outputDimensions[i];
-
-  std::vector<arma::Cube<typename MatType::elem_type>> layerOutputAliases(
-      this->layerOutputs.size());
-  for (size_t i = 0; i < this->layerOutputs.size(); ++i)
+  if (slices == 1)
   {
-    MakeAlias(layerOutputAliases[i],
-              (typename MatType::elem_type*) this->layerOutputs[i].memptr(),
-              rows,
-              this->network[i]->OutputDimensions()[axis],
-              slices);
+    // The output of each layer is a contiguous part of `output`, so the layers
+    // can write into it directly.  The aliases stay valid for Backward(),
+    // which is called with the same output.
+    size_t start = 0;
+    for (size_t i = 0; i < this->network.size(); ++i)
+    {
+      MakeAlias(this->layerOutputs[i], MemPtr(output) + start,
+          this->network[i]->OutputSize(), input.n_cols);
+      this->network[i]->Forward(input, this->layerOutputs[i]);
+      start += this->network[i]->OutputSize() * input.n_cols;
+    }
+
+    return;
   }
 
-  arma::Cube<typename MatType::elem_type> outputAlias;
-  MakeAlias(outputAlias,
-            (typename MatType::elem_type*) output.memptr(),
-            rows,
-            this->outputDimensions[axis],
-            slices);
+  // Pass the input through all the layers in the network.
+  for (size_t i = 0; i < this->network.size(); ++i)
+    this->network[i]->Forward(input, this->layerOutputs[i]);
+
+  arma::Cube<typename MatType::elem_type> outputAlias, layerOutputAlias;
+  MakeAlias(outputAlias, MemPtr(output), rows, this->outputDimensions[axis],
+      slices);
 
   // Now get the columns from each output.
   size_t startCol = 0;
-  for (size_t i = 0; i < layerOutputAliases.size(); ++i)
+  for (size_t i = 0; i < this->network.size(); ++i)
   {
-    const size_t cols = layerOutputAliases[i].n_cols;
-    outputAlias.cols(startCol, startCol + cols - 1) = layerOutputAliases[i];
+    const size_t cols = this->network[i]->OutputDimensions()[axis];
+    MakeAlias(layerOutputAlias, MemPtr(this->layerOutputs[i]), rows, cols,
+        slices);
+    outputAlias.cols(startCol, startCol + cols - 1) = layerOutputAlias;
     startCol += cols;
   }
 }
@@ -156,46 +168,17 @@ void ConcatType<MatType>::Backward(
 {
   // The implementation of MultiLayer is fine: this will allocate a matrix that
   // is able to hold each child layer's delta (which has the same size as the
-  // input).
-  this->InitializeBackwardPassMemory(gy.n_cols);
-
-  // Just like the forward pass, we can treat our inputs as a cube, but here we
-  // have to distribute the correct parts of `gy` to the layers.
-
-  size_t rows = 1;
-  for (size_t i = 0; i < axis; ++i)
-    rows *= this->outputDimensions[i];
+  // input).  Normally, Forward() has done this already.
+  this->InitializeParallelPassMemory(gy.n_cols);
 
-  size_t slices = gy.n_cols;
-  for (size_t i = axis + 1; i < this->outputDimensions.size(); ++i)
-    slices *= this->outputDimensions[i];
-
-  arma::Cube<typename MatType::elem_type> gyTmp;
-  MakeAlias(gyTmp,
-            (typename MatType::elem_type*) gy.memptr(),
-            rows,
-            this->outputDimensions[axis],
-            slices);
-
-  size_t startCol = 0;
-  for (size_t i = 0; i < this->network.size(); ++i)
-  {
-    const size_t cols = this->network[i]->OutputDimensions()[axis];
-    MatType delta = gyTmp.cols(startCol, startCol + cols - 1);
-    // Reshape so that the batch size is the number of columns.
-    delta.reshape(delta.n_elem / gy.n_cols, gy.n_cols);
-    this->network[i]->Backward(
-        input,
-        this->layerOutputs[i],
-        delta,
-        this->layerDeltas[i]);
-
-    startCol += cols;
-  }
-
-  g = this->layerDeltas[0];
+  // Distribute the correct parts of `gy` to the layers; the first layer writes
+  // its delta directly into `g`, and the deltas of the others are added to it.
+  SplitError(gy, true);
+  this->network[0]->Backward(input, this->layerOutputs[0], layerErrors[0], g);
   for (size_t i = 1; i < this->network.size(); ++i)
   {
+    this->network[i]->Backward(input, this->layerOutputs[i], layerErrors[i],
+        this->layerDeltas[i]);
     g += this->layerDeltas[i];
   }
 }
@@ -208,41 +191,12 @@ void ConcatType<MatType>::Backward(
     MatType& g,
     const size_t index)
 {
-  // We only intend to perform a backward pass on one layer.
-  // Thus, we need to extract the parts of gy that correspond to the desired
-  // layer (specified by `index`).
-
-  size_t rows = 1;
-  for (size_t i = 0; i < axis; ++i)
-    rows *= this->outputDimensions[i];
-
-  size_t slices = gy.n_cols;
-  for (size_t i = axis + 1; i < this->outputDimensions.size(); ++i)
-    slices *= this->outputDimensions[i];
-
-  arma::Cube<typename MatType::elem_type> gyTmp;
-  MakeAlias(gyTmp,
-            (typename MatType::elem_type*) gy.memptr(),
-            rows,
-            this->outputDimensions[axis],
-            slices);
-
-  size_t startCol = 0;
-  for (size_t i = 0; i < index; ++i)
-  {
-    startCol += this->network[i]->OutputDimensions()[axis];
-  }
-
-  const size_t cols = this->network[index]->OutputDimensions()[axis];
-  MatType delta = gyTmp.cols(startCol, startCol + cols - 1);
-  // Reshape so that the batch size is the number of columns.
-  delta.reshape(delta.n_elem / gy.n_cols, gy.n_cols);
-
-  this->network[index]->Backward(
-          input,
-          this->layerOutputs[index],
-          delta,
-          g);
+  // We only intend to perform a backward pass on one layer.  Thus, we need to
+  // extract the parts of gy that correspond to the desired layer (specified by
+  // `index`).
+  SplitError(gy, true);
+  this->network[index]->Backward(input, this->layerOutputs[index],
+      layerErrors[index], g);
 }
 
 template<typename MatType>
@@ -251,41 +205,17 @@ void ConcatType<MatType>::Gradient(
     const MatType& error,
     MatType& gradient)
 {
-  // Just like the forward pass, we can treat our inputs as a cube, but here we
-  // have to distribute the correct parts of `error` to the layers.
-
-  size_t rows = 1;
-  for (size_t i = 0; i < axis; ++i)
-    rows *= this->outputDimensions[i];
-
-  size_t slices = input.n_cols;
-  for (size_t i = axis + 1; i < this->outputDimensions.size(); ++i)
-    slices *= this->outputDimensions[i];
-
-  arma::Cube<typename MatType::elem_type> errorTmp;
-  MakeAlias(errorTmp,
-            (typename MatType::elem_type*) error.memptr(),
-            rows,
-            this->outputDimensions[axis],
-            slices);
+  // Distribute the correct parts of `error` to the layers; Backward() has
+  // usually split the same error already.
+  SplitError(error, false);
 
-  size_t startCol = 0;
   size_t startParam = 0;
+  MatType gradientAlias;
   for (size_t i = 0; i < this->network.size(); ++i)
   {
-    const size_t cols = this->network[i]->OutputDimensions()[axis];
     const size_t params = this->network[i]->WeightSize();
-
-    MatType err = errorTmp.cols(startCol, startCol + cols - 1);
-    err.reshape(err.n_elem / input.n_cols, input.n_cols);
-    MatType gradientAlias;
-    MakeAlias(gradientAlias,
-              (typename MatType::elem_type*) gradient.memptr() + startParam,
-              params,
-              1);
-    this->network[i]->Gradient(input, err, gradientAlias);
-
-    startCol += cols;
+    MakeAlias(gradientAlias, MemPtr(gradient) + startParam, params, 1);
+    this->network[i]->Gradient(input, layerErrors[i], gradientAlias);
     startParam += params;
   }
 }
@@ -297,43 +227,81 @@ void ConcatType<MatType>::Gradient(
     MatType& gradient,
     const size_t index)
 {
-  // Just like the forward pass, we can treat our inputs as a cube, but here we
-  // have to distribute the correct parts of `error` to the layers.
+  SplitError(error, false);
+
+  size_t startParam = 0;
+  for (size_t i = 0; i < index; ++i)
+    startParam += this->network[i]->WeightSize();
+
+  MatType gradientAlias;
+  MakeAlias(gradientAlias, MemPtr(gradient) + startParam,
+      this->network[index]->WeightSize(), 1);
+  this->network[index]->Gradient(input, layerErrors[index], gradientAlias);
+}
 
-  size_t rows = 1;
+template<typename MatType>
+void ConcatType<MatType>::CubeDimensions(const size_t batchSize,
+                                         size_t& rows,
+                                         size_t& slices) const
+{
+  rows = 1;
   for (size_t i = 0; i < axis; ++i)
     rows *= this->outputDimensions[i];
 
-  size_t slices = input.n_cols;
+  slices = batchSize;
   for (size_t i = axis + 1; i < this->outputDimensions.size(); ++i)
     slices *= this->outputDimensions[i];
+}
+
+template<typename MatType>
+void ConcatType<MatType>::SplitError(const MatType& error, const bool force)
+{
+  if (!force && MemPtr(error) == lastErrorPtr && error.n_cols == lastErrorCols)
+    return;
 
-  arma::Cube<typename MatType::elem_type> errorTmp;
-  MakeAlias(errorTmp,
-            (typename MatType::elem_type*) error.memptr(),
-            rows,
-            this->outputDimensions[axis],
-            slices);
+  lastErrorPtr = MemPtr(error);
+  lastErrorCols = error.n_cols;
+  layerErrors.resize(this->network.size());
 
-  size_t startCol = 0;
-  size_t startParam = 0;
-  for (size_t i = 0; i < index; ++i)
+  size_t rows, slices;
+  CubeDimensions(error.n_cols, rows, slices);
+
+  if (slices == 1)
   {
-    startCol += this->network[i]->OutputDimensions()[axis];
-    startParam += this->network[i]->WeightSize();
+    // The part of each layer is contiguous in `error`.
+    size_t start = 0;
+    for (size_t i = 0; i < this->network.size(); ++i)
+    {
+      MakeAlias(layerErrors[i], MemPtr(error) + start,
+          this->network[i]->OutputSize(), error.n_cols);
+      start += this->network[i]->OutputSize() * error.n_cols;
+    }
+
+    return;
   }
 
-  const size_t cols = this->network[index]->OutputDimensions()[axis];
-  const size_t params = this->network[index]->WeightSize();
+  if (errorMemory.n_elem != error.n_elem)
+    errorMemory.set_size(error.n_elem, 1);
 
-  MatType err = errorTmp.cols(startCol, startCol + cols - 1);
-  err.reshape(err.n_elem / input.n_cols, input.n_cols);
-  MatType gradientAlias;
-  MakeAlias(gradientAlias,
-            (typename MatType::elem_type*) gradient.memptr() + startParam,
-            params,
-            1);
-  this->network[index]->Gradient(input, err, gradientAlias);
+  arma::Cube<typename MatType::elem_type> errorAlias, layerErrorAlias;
+  MakeAlias(errorAlias, MemPtr(error), rows, this->outputDimensions[axis],
+      slices);
+
+  size_t start = 0;
+  size_t startCol = 0;
+  for (size_t i = 0; i < this->network.size(); ++i)
+  {
+    const size_t cols = this->network[i]->OutputDimensions()[axis];
+    MakeAlias(layerErrorAlias, MemPtr(errorMemory) + start, rows, cols,
+        slices);
+    layerErrorAlias = errorAlias.cols(startCol, startCol + cols - 1);
+
+    // The batch size is the number of columns of each part.
+    MakeAlias(layerErrors[i], MemPtr(errorMemory) + start,
+        this->network[i]->OutputSize(), error.n_cols);
+    start += this->network[i]->OutputSize() * error.n_cols;
+    startCol += cols;
+  }
 }
 
 template<typename MatType>
@@ -345,6 +313,14 @@ void ConcatType<MatType>::serialize(
 
   ar(CEREAL_NVP(axis));
   ar(CEREAL_NVP(useAxis));
+
+  if (Archive::is_loading::value)
+  {
+    layerErrors.clear();
+    errorMemory.clear();
+    lastErrorPtr = NULL;
+    lastErrorCols = 0;
+  }
 }
 
 } // namespace mlpack
@@ -80,9 +80,11 @@ void ConcatenateType<MatType>::Forward(const MatType& input, MatType& output)
         << "not provided." << std::endl;
   }
 
+  // The concatenated part is written into each column directly, without
+  // building the repeated matrix first.
   output.submat(0, 0, input.n_rows - 1, input.n_cols - 1) = input;
-  output.submat(input.n_rows, 0, output.n_rows - 1, input.n_cols - 1) =
-      repmat(vectorise(concat), 1, input.n_cols);
+  output.submat(input.n_rows, 0, output.n_rows - 1, input.n_cols - 1).each_col()
+      = vectorise(concat);
 }
 
 template<typename MatType>
@@ -17,11 +17,13 @@
 #include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
 
 #include "layer.hpp"
 #include "padding.hpp"
+#include "quantized_convolution.hpp"
 
 namespace mlpack {
 
@@ -65,9 +67,9 @@ namespace mlpack {
  *    computation.
  */
 template <
-    typename ForwardConvolutionRule = NaiveConvolution<ValidConvolution>,
-    typename BackwardConvolutionRule = NaiveConvolution<FullConvolution>,
-    typename GradientConvolutionRule = NaiveConvolution<ValidConvolution>,
+    typename ForwardConvolutionRule = Im2ColConvolution<ValidConvolution>,
+    typename BackwardConvolutionRule = Im2ColConvolution<FullConvolution>,
+    typename GradientConvolutionRule = Im2ColConvolution<ValidConvolution>,
     typename MatType = arma::mat
 >
 class ConvolutionType : public Layer<MatType>
@@ -192,6 +194,40 @@ class ConvolutionType : public Layer<MatType>
                 const MatType& error,
                 MatType& gradient);
 
+  /**
+   * Scale and shift each output map of the layer, so that its output becomes
+   * `scale % output + shift`.  This is only possible if the layer uses a bias
+   * and all the elements of each output map have the same scale and shift.
+   *
+   * @param scale Scale of each output element.
+   * @param shift Shift of each output element.
+   * @return false if the transformation could not be folded into the layer.
+   */
+  bool FoldAffine(const MatType& scale, const MatType& shift);
+
+  /**
+   * Apply the given activation layer to each output map right after the bias
+   * is added.
+   *
+   * @param activation Activation layer to fuse into this layer.
+   * @return True if the activation layer supports `TestingActivation()`.
+   */
+  bool FuseActivation(const Layer<MatType>* activation);
+
+  /**
+   * Create a QuantizedConvolution layer with the quantized filters of this
+   * layer, with the same strides and padding.
+   */
+  QuantizedConvolutionType<MatType>* QuantizedCopy() const;
+
+  //! Get an estimate of the number of floating-point operations of a forward
+  //! pass for each point: every weight is applied at every output position.
+  size_t ForwardFlops()
+  {
+    const std::vector<size_t>& dims = this->OutputDimensions();
+    return 2 * WeightSize() * dims[0] * dims[1] + this->OutputSize();
+  }
+
   //! Get the parameters.
   MatType const& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -375,6 +411,14 @@ class ConvolutionType : public Layer<MatType>
   //! Locally-stored transformed gradient parameter.
   CubeType gradientTemp;
 
+  //! Workspace for the lowered input of Im2ColConvolution (not copied or
+  //! serialized).
+  MatType im2colColumns;
+  //! Workspace for the maps gathered by Im2ColConvolution.
+  MatType im2colProduct;
+  //! Workspace for the padded error of Im2ColConvolution in Backward().
+  CubeType im2colPadded;
+
   //! Locally-stored padding layer.
   PaddingType<MatType> padding;
 
@@ -394,13 +438,17 @@ class ConvolutionType : public Layer<MatType>
 
   //! Locally-stored apparent height.
   size_t apparentHeight;
+
+  //! The activation layer applied to the output, if any (see
+  //! `FuseActivation()`).  This is not owned by the layer.
+  const Layer<MatType>* activation;
 }; // class Convolution
 
 // Standard Convolution layer.
 typedef ConvolutionType<
-    NaiveConvolution<ValidConvolution>,
-    NaiveConvolution<FullConvolution>,
-    NaiveConvolution<ValidConvolution>,
+    Im2ColConvolution<ValidConvolution>,
+    Im2ColConvolution<FullConvolution>,
+    Im2ColConvolution<ValidConvolution>,
     arma::mat
 > Convolution;
 
@@ -28,7 +28,9 @@ ConvolutionType<
     BackwardConvolutionRule,
     GradientConvolutionRule,
     MatType
->::ConvolutionType() : Layer<MatType>()
+>::ConvolutionType() :
+    Layer<MatType>(),
+    activation(NULL)
 {
   // Nothing to do here.
 }
@@ -99,7 +101,8 @@ ConvolutionType<
     padWRight(std::get<1>(padW)),
     padHBottom(std::get<1>(padH)),
     padHTop(std::get<0>(padH)),
-    useBias(useBias)
+    useBias(useBias),
+    activation(NULL)
 {
   // Transform paddingType to lowercase.
   this->paddingType = util::ToLower(paddingTypeIn);
@@ -134,7 +137,8 @@ ConvolutionType<
     inMaps(other.inMaps),
     higherInDimensions(other.higherInDimensions),
     apparentWidth(other.apparentWidth),
-    apparentHeight(other.apparentHeight)
+    apparentHeight(other.apparentHeight),
+    activation(other.activation)
 {
   // Nothing to do.
 }
@@ -168,7 +172,8 @@ ConvolutionType<
     inMaps(std::move(other.inMaps)),
     higherInDimensions(std::move(other.higherInDimensions)),
     apparentWidth(std::move(other.apparentWidth)),
-    apparentHeight(std::move(other.apparentHeight))
+    apparentHeight(std::move(other.apparentHeight)),
+    activation(other.activation)
 {
   // Nothing to do.
 }
@@ -212,6 +217,7 @@ ConvolutionType<
     higherInDimensions = other.higherInDimensions;
     apparentWidth = other.apparentWidth;
     apparentHeight = other.apparentHeight;
+    activation = other.activation;
   }
 
   return *this;
@@ -256,6 +262,7 @@ ConvolutionType<
     higherInDimensions = std::move(other.higherInDimensions);
     apparentWidth = std::move(other.apparentWidth);
     apparentHeight = std::move(other.apparentHeight);
+    activation = other.activation;
   }
 
   return *this;
@@ -320,6 +327,34 @@ void ConvolutionType<
 
   MakeAlias(outputTemp, output.memptr(), this->outputDimensions[0],
       this->outputDimensions[1], maps * higherInDimensions * batchSize);
+
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    // Convolve all the maps of all the points with one matrix multiplication.
+    // The filters of each output map are one column of the weights.
+    MatType weightMat;
+    MakeAlias(weightMat, weight.memptr(), weight.n_rows * weight.n_cols *
+        inMaps, maps);
+    Im2ColConvolution<ValidConvolution>::ForwardBatch(inputTemp, inMaps, 0,
+        weightMat, outputTemp, maps, 0, kernelWidth, kernelHeight, strideWidth,
+        strideHeight, im2colColumns, im2colProduct);
+
+    if (useBias || activation != NULL)
+    {
+      // Apply the activation to each map while it is still in cache.
+      #pragma omp parallel for num_threads((int) NumThreads())
+      for (size_t i = 0; i < outputTemp.n_slices; ++i)
+      {
+        if (useBias)
+          outputTemp.slice(i) += bias(i % maps);
+        if (activation != NULL)
+          activation->TestingActivation(outputTemp.slice(i));
+      }
+    }
+
+    return;
+  }
+
   outputTemp.zeros();
 
   // We "ignore" dimensions higher than the third---that means that we just pass
@@ -354,6 +389,8 @@ void ConvolutionType<
       // Make sure to add the bias.
       if (useBias)
         convOutput += bias(outMap);
+      if (activation != NULL)
+        activation->TestingActivation(convOutput);
     }
   }
 }
@@ -386,6 +423,36 @@ void ConvolutionType<
   const bool usingPadding =
       (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0);
 
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    // Multiply the error of all the output maps with the filters, and add the
+    // products back to the elements of the (padded) input they came from.
+    MatType weightMat;
+    MakeAlias(weightMat, weight.memptr(), weight.n_rows * weight.n_cols *
+        inMaps, maps);
+    if (!usingPadding)
+    {
+      Im2ColConvolution<ValidConvolution>::BackwardBatch(mappedError, maps, 0,
+          weightMat, gTemp, inMaps, 0, kernelWidth, kernelHeight, strideWidth,
+          strideHeight, im2colColumns, im2colProduct);
+    }
+    else
+    {
+      im2colPadded.zeros(padding.OutputDimensions()[0],
+          padding.OutputDimensions()[1], gTemp.n_slices);
+      Im2ColConvolution<ValidConvolution>::BackwardBatch(mappedError, maps, 0,
+          weightMat, im2colPadded, inMaps, 0, kernelWidth, kernelHeight,
+          strideWidth, strideHeight, im2colColumns, im2colProduct);
+      gTemp = im2colPadded.tube(
+          padWLeft,
+          padHTop,
+          padWLeft + gTemp.n_rows - 1,
+          padHTop + gTemp.n_cols - 1);
+    }
+
+    return;
+  }
+
   // To perform the backward pass, we need to rotate all the filters.
   CubeType rotatedFilters(weight.n_rows,
       weight.n_cols, weight.n_slices);
@@ -502,6 +569,32 @@ void ConvolutionType<
   const size_t paddedRows = this->inputDimensions[0] + padWLeft + padWRight;
   const size_t paddedCols = this->inputDimensions[1] + padHTop + padHBottom;
 
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    CubeType inputTemp;
+    MakeAlias(inputTemp,
+        const_cast<MatType&>(usingPadding ? inputPadded : input).memptr(),
+        paddedRows, paddedCols, inMaps * higherInDimensions * batchSize);
+
+    // The gradient of the filters of all the output maps is the product of the
+    // lowered input with the error.
+    MatType gradientMat;
+    MakeAlias(gradientMat, gradient.memptr(), weight.n_rows * weight.n_cols *
+        inMaps, maps);
+    Im2ColConvolution<ValidConvolution>::GradientBatch(inputTemp, inMaps, 0,
+        mappedError, maps, 0, gradientMat, kernelWidth, kernelHeight,
+        strideWidth, strideHeight, im2colColumns, im2colProduct);
+
+    if (useBias)
+    {
+      gradient.rows(weight.n_elem, weight.n_elem + maps - 1).zeros();
+      for (size_t i = 0; i < mappedError.n_slices; ++i)
+        gradient[weight.n_elem + (i % maps)] += accu(mappedError.slice(i));
+    }
+
+    return;
+  }
+
   CubeType inputTemp(
       const_cast<MatType&>(usingPadding ? inputPadded : input).memptr(),
       paddedRows, paddedCols, inMaps * batchSize, false, false);
@@ -549,6 +642,85 @@ void ConvolutionType<
   }
 }
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+bool ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::FoldAffine(const MatType& scale, const MatType& shift)
+{
+  if (!useBias)
+    return false;
+
+  // The output is stored map by map, so every element of an output map must
+  // have the same scale and shift.
+  const size_t mapSize = this->outputDimensions[0] * this->outputDimensions[1];
+  for (size_t i = 0; i < scale.n_elem; ++i)
+  {
+    const size_t first = ((i / mapSize) % maps) * mapSize;
+    if (scale[i] != scale[first] || shift[i] != shift[first])
+      return false;
+  }
+
+  // The filters of each output map are stored next to each other.
+  for (size_t outMap = 0; outMap < maps; ++outMap)
+  {
+    weight.slices(outMap * inMaps, (outMap + 1) * inMaps - 1) *=
+        scale[outMap * mapSize];
+    bias(outMap) = scale[outMap * mapSize] * bias(outMap) +
+        shift[outMap * mapSize];
+  }
+
+  return true;
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+bool ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::FuseActivation(const Layer<MatType>* activation)
+{
+  MatType empty;
+  if (!activation->TestingActivation(empty))
+    return false;
+
+  this->activation = activation;
+  return true;
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+QuantizedConvolutionType<MatType>* ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::QuantizedCopy() const
+{
+  // The padding sizes are up to date, since the output dimensions have been
+  // computed.
+  return new QuantizedConvolutionType<MatType>(weight,
+      useBias ? MatType(bias) : MatType(), maps, strideWidth, strideHeight,
+      padWLeft, padWRight, padHTop, padHBottom);
+}
+
 template<
     typename ForwardConvolutionRule,
     typename BackwardConvolutionRule,
@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include "layer.hpp"
+#include "dropout_mask.hpp"
 
 namespace mlpack {
 
@@ -140,7 +141,7 @@ class DropConnectType : public Layer<MatType>
   double scale;
 
   //! Locally-stored mask object.
-  MatType mask;
+  DropoutMask mask;
 
   //! Denoise mask for the weights.
   MatType denoise;
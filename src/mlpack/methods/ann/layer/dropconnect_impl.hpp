@@ -114,10 +114,8 @@ void DropConnectType<MatType>::Forward(const MatType& input, MatType& output)
 
     // Scale with input / (1 - ratio) and set values to zero with
     // probability ratio.
-    mask.randu(denoise.n_rows, denoise.n_cols);
-    mask.transform([&](double val) { return (val > ratio); });
-
-    baseLayer->Parameters() = denoise % mask;
+    mask.Generate(denoise.n_rows, denoise.n_cols, ratio);
+    mask.Apply(denoise, baseLayer->Parameters(), 1.0);
     baseLayer->Forward(input, output);
 
     output = output * scale;
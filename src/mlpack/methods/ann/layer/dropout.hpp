@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include "layer.hpp"
+#include "dropout_mask.hpp"
 
 namespace mlpack {
 
@@ -25,6 +26,9 @@ namespace mlpack {
  * (1 - ratio) rather than during test time so as to keep the expected sum same.
  * When the layer is in testing mode, there is no change in the input.
  *
+ * The mask is stored with one bit per element (see DropoutMask), and is
+ * applied together with the scaling in a single pass.
+ *
  * For more information, see the following.
  *
  * @code
@@ -90,6 +94,9 @@ class DropoutType : public Layer<MatType>
                 const MatType& gy,
                 MatType& g);
 
+  //! The dropout layer does nothing when it is not in training mode.
+  bool IsIdentityWhenTesting() const { return true; }
+
   //! The probability of setting a value to zero.
   double Ratio() const { return ratio; }
 
@@ -108,7 +115,7 @@ class DropoutType : public Layer<MatType>
 
  private:
   //! Locally-stored mask object.
-  MatType mask;
+  DropoutMask mask;
 
   //! The probability of setting a value to zero.
   double ratio;
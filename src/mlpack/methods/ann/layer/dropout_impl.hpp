@@ -86,9 +86,8 @@ void DropoutType<MatType>::Forward(const MatType& input, MatType& output)
   {
     // Scale with input / (1 - ratio) and set values to zero with probability
     // 'ratio'.
-    mask.randu(input.n_rows, input.n_cols);
-    mask.transform([&](double val) { return (val > ratio); });
-    output = input % mask * scale;
+    mask.Generate(input.n_rows, input.n_cols, ratio);
+    mask.Apply(input, output, scale);
   }
 }
 
@@ -99,7 +98,7 @@ void DropoutType<MatType>::Backward(
     const MatType& gy,
     MatType& g)
 {
-  g = gy % mask * scale;
+  mask.Apply(gy, g, scale);
 }
 
 template<typename MatType>
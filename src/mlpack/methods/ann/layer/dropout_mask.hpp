@@ -0,0 +1,185 @@
+/**
+ * @file methods/ann/layer/dropout_mask.hpp
+ *
+ * Definition of the DropoutMask class, a bit-packed random mask for the
+ * dropout layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_DROPOUT_MASK_HPP
+#define MLPACK_METHODS_ANN_LAYER_DROPOUT_MASK_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+
+/**
+ * A random mask that keeps each element of a matrix with a given probability,
+ * stored with one bit per element.  The bits are generated directly from a
+ * counter-based RandomStream, in parallel: each 64-bit word of the mask is
+ * computed from its own 16 blocks of the stream, so the mask only depends on
+ * the seed and not on the number of threads.  The mask is then applied in a
+ * single pass that also scales the kept elements, so that no mask matrix of
+ * the size of the input is ever formed.
+ */
+class DropoutMask
+{
+ public:
+  //! Create an empty mask.
+  DropoutMask() : rows(0), cols(0) { }
+
+  /**
+   * Generate a new mask of the given size, where each element is dropped with
+   * probability ratio, from a seed given by RandGen().
+   *
+   * @param nRows Number of rows of the mask.
+   * @param nCols Number of columns of the mask.
+   * @param ratio Probability of dropping each element.
+   */
+  void Generate(const size_t nRows, const size_t nCols, const double ratio)
+  {
+    Generate(nRows, nCols, ratio, RandomStreamSeed());
+  }
+
+  /**
+   * Generate a new mask of the given size, where each element is dropped with
+   * probability ratio, from the given seed.
+   *
+   * @param nRows Number of rows of the mask.
+   * @param nCols Number of columns of the mask.
+   * @param ratio Probability of dropping each element.
+   * @param seed Seed of the random numbers.
+   */
+  void Generate(const size_t nRows,
+                const size_t nCols,
+                const double ratio,
+                const uint64_t seed)
+  {
+    rows = nRows;
+    cols = nCols;
+    words.resize((nRows * nCols + 63) / 64);
+
+    // An element is kept if its random 32-bit integer is at least the
+    // threshold, which happens with probability 1 - ratio.
+    const uint64_t threshold = (uint64_t) std::ceil(
+        std::min(std::max(ratio, 0.0), 1.0) * 4294967296.0);
+
+    uint64_t* mem = words.data();
+    #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+    for (size_t w = 0; w < words.size(); ++w)
+    {
+      uint64_t word = 0;
+      uint32_t block[4];
+      for (size_t b = 0; b < 16; ++b)
+      {
+        RandomStream::Block(seed, 0, 16 * w + b, block);
+        for (size_t j = 0; j < 4; ++j)
+        {
+          if ((uint64_t) block[j] >= threshold)
+            word |= ((uint64_t) 1) << (4 * b + j);
+        }
+      }
+      mem[w] = word;
+    }
+  }
+
+  /**
+   * Compute output = input * multiplier + offset for the kept elements and
+   * output = droppedValue for the dropped elements, in one pass.  The input
+   * must have the size of the mask, and may be the output itself.
+   *
+   * @param input Matrix to apply the mask to.
+   * @param output Matrix to store the result in.
+   * @param multiplier Scale of the kept elements.
+   * @param offset Offset of the kept elements.
+   * @param droppedValue Value of the dropped elements.
+   */
+  template<typename MatType>
+  void Apply(const MatType& input,
+             MatType& output,
+             const double multiplier,
+             const double offset = 0.0,
+             const double droppedValue = 0.0) const
+  {
+    typedef typename MatType::elem_type ElemType;
+
+    if (input.n_rows != rows || input.n_cols != cols)
+    {
+      std::ostringstream oss;
+      oss << "DropoutMask::Apply(): the matrix has size " << input.n_rows
+          << " x " << input.n_cols << ", but the mask has size " << rows
+          << " x " << cols << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    output.set_size(rows, cols);
+    const ElemType* in = input.memptr();
+    ElemType* out = output.memptr();
+    const ElemType m = (ElemType) multiplier;
+    const ElemType o = (ElemType) offset;
+    const ElemType d = (ElemType) droppedValue;
+    const size_t numElem = rows * cols;
+    const uint64_t* mem = words.data();
+
+    #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+    for (size_t w = 0; w < words.size(); ++w)
+    {
+      const uint64_t word = mem[w];
+      const size_t end = std::min(64 * w + 64, numElem);
+      for (size_t i = 64 * w; i < end; ++i)
+        out[i] = ((word >> (i - 64 * w)) & 1) ? in[i] * m + o : d;
+    }
+  }
+
+  //! Return whether the element with the given linear index is kept.
+  bool operator[](const size_t i) const
+  {
+    return (words[i / 64] >> (i % 64)) & 1;
+  }
+
+  /**
+   * Store the mask in the given matrix, with a 1 for each kept element and a 0
+   * for each dropped element.
+   *
+   * @param m Matrix to store the mask in.
+   */
+  template<typename MatType>
+  void ToMatrix(MatType& m) const
+  {
+    m.set_size(rows, cols);
+    for (size_t i = 0; i < rows * cols; ++i)
+      m[i] = (*this)[i] ? 1 : 0;
+  }
+
+  //! Forget the mask.
+  void Clear()
+  {
+    rows = 0;
+    cols = 0;
+    words.clear();
+  }
+
+  //! Get the number of rows of the mask.
+  size_t Rows() const { return rows; }
+  //! Get the number of columns of the mask.
+  size_t Cols() const { return cols; }
+  //! Get the bits of the mask, 64 elements per word.
+  const std::vector<uint64_t>& Words() const { return words; }
+
+ private:
+  //! Number of rows of the mask.
+  size_t rows;
+  //! Number of columns of the mask.
+  size_t cols;
+  //! The bits of the mask; bit i % 64 of word i / 64 is element i.
+  std::vector<uint64_t> words;
+};
+
+} // namespace mlpack
+
+#endif
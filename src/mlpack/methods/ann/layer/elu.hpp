@@ -166,6 +166,14 @@ class ELUType : public Layer<MatType>
                 const MatType& gy,
                 MatType& g);
 
+  /**
+   * Apply the activation in place to each element of `x`.
+   *
+   * @param x Elements to apply the activation to.
+   * @return Always true.
+   */
+  bool TestingActivation(MatType& x) const;
+
   //! Get the non zero gradient.
   double const& Alpha() const { return alpha; }
   //! Modify the non zero gradient.
@@ -123,6 +123,18 @@ void ELUType<MatType>::Backward(
   g = gy % derivative;
 }
 
+template<typename MatType>
+bool ELUType<MatType>::TestingActivation(MatType& x) const
+{
+  for (size_t i = 0; i < x.n_elem; ++i)
+  {
+    if (x(i) < DBL_MAX)
+      x(i) = (x(i) > 0) ? lambda * x(i) : lambda * alpha * (std::exp(x(i)) - 1);
+  }
+
+  return true;
+}
+
 template<typename MatType>
 template<typename Archive>
 void ELUType<MatType>::serialize(
@@ -16,8 +16,10 @@
 #include <mlpack/prereqs.hpp>
 
 #include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
+#include <mlpack/methods/ann/convolution_rules/depthwise_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
 
@@ -62,6 +64,14 @@ namespace mlpack {
  * }
  * @endcode
  *
+ * Like the Convolution layer, the convolutions are computed with
+ * Im2ColConvolution by default; each group is then handled with one matrix
+ * multiplication for the whole batch.  When there are as many groups as input
+ * maps (a depthwise convolution), the default rules use DepthwiseConvolution
+ * instead, which applies the filters directly.  See also
+ * SeparableConvolution, which follows a depthwise convolution with a 1x1
+ * convolution in a single layer.
+ *
  * @tparam ForwardConvolutionRule Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Convolution to perform backward process.
  * @tparam GradientConvolutionRule Convolution to calculate gradient.
@@ -69,9 +79,9 @@ namespace mlpack {
  *    computation.
  */
 template <
-    typename ForwardConvolutionRule = NaiveConvolution<ValidConvolution>,
-    typename BackwardConvolutionRule = NaiveConvolution<FullConvolution>,
-    typename GradientConvolutionRule = NaiveConvolution<ValidConvolution>,
+    typename ForwardConvolutionRule = Im2ColConvolution<ValidConvolution>,
+    typename BackwardConvolutionRule = Im2ColConvolution<FullConvolution>,
+    typename GradientConvolutionRule = Im2ColConvolution<ValidConvolution>,
     typename MatType = arma::mat
 >
 class GroupedConvolutionType : public Layer<MatType>
@@ -391,6 +401,14 @@ class GroupedConvolutionType : public Layer<MatType>
   //! Locally-stored transformed gradient parameter.
   CubeType gradientTemp;
 
+  //! Workspace for the lowered input of Im2ColConvolution (not copied or
+  //! serialized).
+  MatType im2colColumns;
+  //! Workspace for the maps gathered by Im2ColConvolution.
+  MatType im2colProduct;
+  //! Workspace for the padded error of Im2ColConvolution in Backward().
+  CubeType im2colPadded;
+
   //! Locally-stored padding layer.
   PaddingType<MatType> padding;
 
@@ -414,9 +432,9 @@ class GroupedConvolutionType : public Layer<MatType>
 
 // Standard Convolution layer.
 typedef GroupedConvolutionType<
-    NaiveConvolution<ValidConvolution>,
-    NaiveConvolution<FullConvolution>,
-    NaiveConvolution<ValidConvolution>,
+    Im2ColConvolution<ValidConvolution>,
+    Im2ColConvolution<FullConvolution>,
+    Im2ColConvolution<ValidConvolution>,
     arma::mat
 > GroupedConvolution;
 
@@ -330,11 +330,56 @@ void GroupedConvolutionType<
 
   MakeAlias(outputTemp, output.memptr(), this->outputDimensions[0],
       this->outputDimensions[1], maps * higherInDimensions * batchSize);
-  outputTemp.zeros();
 
   size_t inGroupSize = inMaps / groups;
   size_t outGroupSize = maps / groups;
 
+  if (inGroupSize == 1 && IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    // Each group has only one input map, so the filters are applied directly
+    // instead of with one tiny matrix multiplication per group.
+    DepthwiseConvolution::Forward(inputTemp, inMaps, weight, outputTemp,
+        strideWidth, strideHeight);
+
+    if (useBias)
+    {
+      #pragma omp parallel for num_threads((int) NumThreads())
+      for (size_t i = 0; i < outputTemp.n_slices; ++i)
+        outputTemp.slice(i) += bias(i % maps);
+    }
+
+    return;
+  }
+
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    // Convolve all the maps of a group, for all the points, with one matrix
+    // multiplication.  The filters of each output map are one column of the
+    // weights of the group.
+    const size_t groupWeightRows = weight.n_rows * weight.n_cols * inGroupSize;
+    for (size_t group = 0; group < groups; ++group)
+    {
+      MatType weightMat;
+      MakeAlias(weightMat, weight.memptr() + group * groupWeightRows *
+          outGroupSize, groupWeightRows, outGroupSize);
+      Im2ColConvolution<ValidConvolution>::ForwardBatch(inputTemp, inMaps,
+          group * inGroupSize, weightMat, outputTemp, maps,
+          group * outGroupSize, kernelWidth, kernelHeight, strideWidth,
+          strideHeight, im2colColumns, im2colProduct);
+    }
+
+    if (useBias)
+    {
+      #pragma omp parallel for num_threads((int) NumThreads())
+      for (size_t i = 0; i < outputTemp.n_slices; ++i)
+        outputTemp.slice(i) += bias(i % maps);
+    }
+
+    return;
+  }
+
+  outputTemp.zeros();
+
   // We "ignore" dimensions higher than the third---that means that we just 
   // pass them through and treat them like different input points.
   //
@@ -404,6 +449,68 @@ void GroupedConvolutionType<
   const bool usingPadding =
       (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0);
 
+  if (inMaps == groups && IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    // See Forward().
+    if (usingPadding)
+    {
+      im2colPadded.zeros(padding.OutputDimensions()[0],
+          padding.OutputDimensions()[1], gTemp.n_slices);
+    }
+
+    DepthwiseConvolution::Backward(mappedError, weight,
+        usingPadding ? im2colPadded : gTemp, inMaps, strideWidth,
+        strideHeight);
+
+    if (usingPadding)
+    {
+      gTemp = im2colPadded.tube(
+          padWLeft,
+          padHTop,
+          padWLeft + gTemp.n_rows - 1,
+          padHTop + gTemp.n_cols - 1);
+    }
+
+    return;
+  }
+
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    // Multiply the error of the output maps of each group with the filters of
+    // the group, and add the products back to the elements of the (padded)
+    // input they came from.
+    const size_t inGroupSize = inMaps / groups;
+    const size_t outGroupSize = maps / groups;
+    const size_t groupWeightRows = weight.n_rows * weight.n_cols * inGroupSize;
+    if (usingPadding)
+    {
+      im2colPadded.zeros(padding.OutputDimensions()[0],
+          padding.OutputDimensions()[1], gTemp.n_slices);
+    }
+
+    for (size_t group = 0; group < groups; ++group)
+    {
+      MatType weightMat;
+      MakeAlias(weightMat, weight.memptr() + group * groupWeightRows *
+          outGroupSize, groupWeightRows, outGroupSize);
+      Im2ColConvolution<ValidConvolution>::BackwardBatch(mappedError, maps,
+          group * outGroupSize, weightMat, usingPadding ? im2colPadded : gTemp,
+          inMaps, group * inGroupSize, kernelWidth, kernelHeight, strideWidth,
+          strideHeight, im2colColumns, im2colProduct);
+    }
+
+    if (usingPadding)
+    {
+      gTemp = im2colPadded.tube(
+          padWLeft,
+          padHTop,
+          padWLeft + gTemp.n_rows - 1,
+          padHTop + gTemp.n_cols - 1);
+    }
+
+    return;
+  }
+
   // To perform the backward pass, we need to rotate all the filters.
   CubeType rotatedFilters(weight.n_rows,
       weight.n_cols, weight.n_slices);
@@ -529,6 +636,52 @@ void GroupedConvolutionType<
   const size_t paddedRows = this->inputDimensions[0] + padWLeft + padWRight;
   const size_t paddedCols = this->inputDimensions[1] + padHTop + padHBottom;
 
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    CubeType inputTemp;
+    MakeAlias(inputTemp,
+        const_cast<MatType&>(usingPadding ? inputPadded : input).memptr(),
+        paddedRows, paddedCols, inMaps * higherInDimensions * batchSize);
+
+    if (inMaps == groups)
+    {
+      // See Forward().
+      MakeAlias(gradientTemp, gradient.memptr(), weight.n_rows, weight.n_cols,
+          weight.n_slices);
+      DepthwiseConvolution::Gradient(inputTemp, inMaps, mappedError,
+          gradientTemp, strideWidth, strideHeight);
+    }
+    else
+    {
+
+      // The gradient of the filters of each group is the product of the
+      // lowered input of the group with the error of the group.
+      const size_t inGroupSize = inMaps / groups;
+      const size_t outGroupSize = maps / groups;
+      const size_t groupWeightRows = weight.n_rows * weight.n_cols *
+          inGroupSize;
+      for (size_t group = 0; group < groups; ++group)
+      {
+        MatType gradientMat;
+        MakeAlias(gradientMat, gradient.memptr() + group * groupWeightRows *
+            outGroupSize, groupWeightRows, outGroupSize);
+        Im2ColConvolution<ValidConvolution>::GradientBatch(inputTemp, inMaps,
+            group * inGroupSize, mappedError, maps, group * outGroupSize,
+            gradientMat, kernelWidth, kernelHeight, strideWidth, strideHeight,
+            im2colColumns, im2colProduct);
+      }
+    }
+
+    if (useBias)
+    {
+      gradient.rows(weight.n_elem, weight.n_elem + maps - 1).zeros();
+      for (size_t i = 0; i < mappedError.n_slices; ++i)
+        gradient[weight.n_elem + (i % maps)] += accu(mappedError.slice(i));
+    }
+
+    return;
+  }
+
   CubeType inputTemp(
       const_cast<MatType&>(usingPadding ? inputPadded : input).memptr(),
       paddedRows, paddedCols, inMaps * batchSize, false, false);
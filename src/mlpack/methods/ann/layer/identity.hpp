@@ -80,6 +80,9 @@ class IdentityType : public Layer<MatType>
                 const MatType& gy,
                 MatType& g);
 
+  //! The identity layer never changes its input.
+  bool IsIdentityWhenTesting() const { return true; }
+
   /**
    * Serialize the layer.
    */
@@ -179,6 +179,29 @@ class Layer
                         MatType& /* gradient */)
   { /* Nothing to do here */ }
 
+  /**
+   * Compute the gradient of the layer with respect to its weights as a sparse
+   * column vector with `WeightSize()` rows; this is used when the network is
+   * trained with sparse gradients (see `FFN::TrainSparse()`).  Layers whose
+   * gradient only involves a few of their weights (like `Lookup`) should
+   * override this; by default, the dense gradient computed by `Gradient()` is
+   * converted.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient Sparse vector to store the gradient in.
+   */
+  virtual void SparseGradient(
+      const MatType& input,
+      const MatType& error,
+      arma::SpMat<typename MatType::elem_type>& gradient)
+  {
+    MatType denseGradient(WeightSize(), 1);
+    Gradient(input, error, denseGradient);
+    ToSparse(denseGradient, gradient,
+        std::integral_constant<bool, IsCootType<MatType>::value>());
+  }
+
   /**
    * Reset the layer parameter. The method is called to assigned the allocated
    * memory to the internal layer parameters like weights and biases. The method
@@ -271,6 +294,88 @@ class Layer
       const size_t /* elements */)
   { /* Nothing to do here */ }
 
+  /**
+   * Return true if the output of the layer is the same as its input when the
+   * layer is not in training mode (e.g. for dropout layers).  Inference passes
+   * skip such layers.
+   */
+  virtual bool IsIdentityWhenTesting() const { return false; }
+
+  /**
+   * If, when the layer is not in training mode, the layer computes the
+   * element-wise affine function `output = scale % input + shift` (e.g. batch
+   * normalization), set `scale` and `shift` to column vectors with
+   * `OutputSize()` elements and return true.  Otherwise, return false.
+   * Inference passes fold such layers into the layer before them with
+   * `FoldAffine()`.
+   *
+   * @param * (scale) Vector to store the scale of each output element in.
+   * @param * (shift) Vector to store the shift of each output element in.
+   */
+  virtual bool TestingAffine(MatType& /* scale */,
+                             MatType& /* shift */)
+  {
+    return false;
+  }
+
+  /**
+   * Change the parameters of the layer so that its output becomes
+   * `scale % output + shift`, where `scale` and `shift` are column vectors with
+   * `OutputSize()` elements.  If the layer cannot represent that, return false
+   * and leave the parameters unchanged.  This is used by inference passes, on
+   * copies of the layers that hold their own parameters.
+   *
+   * @param * (scale) Scale of each output element.
+   * @param * (shift) Shift of each output element.
+   */
+  virtual bool FoldAffine(const MatType& /* scale */,
+                          const MatType& /* shift */)
+  {
+    return false;
+  }
+
+  /**
+   * If, when the layer is not in training mode, the layer applies the same
+   * function to each element of its input independently (e.g. activation
+   * layers), apply that function in place to every element of `x` and return
+   * true.  Otherwise, return false and leave `x` unchanged.  Since an empty `x`
+   * is left unchanged either way, this can be called with an empty matrix to
+   * check whether the layer supports it.  Inference passes fuse such layers
+   * into the layer before them with `FuseActivation()`.
+   *
+   * @param * (x) Elements to apply the function of the layer to.
+   */
+  virtual bool TestingActivation(MatType& /* x */) const { return false; }
+
+  /**
+   * Make the layer apply `activation->TestingActivation()` to its output as
+   * part of `Forward()`, right after the output of each point (or map) is
+   * computed, so that the activation is applied while the output is still in
+   * cache and needs no buffer of its own.  If the layer cannot do that, return
+   * false.  This is used by inference passes, on copies of the layers; the
+   * activation layer must outlive the layer.
+   *
+   * @param * (activation) Activation layer to fuse into this layer.
+   */
+  virtual bool FuseActivation(const Layer* /* activation */) { return false; }
+
+  /**
+   * Return a new, inference-only layer that computes the same function as this
+   * layer with 8-bit quantized weights (e.g. a QuantizedLinear layer for a
+   * Linear layer), or NULL if the layer has no quantized version.  The caller
+   * owns the returned layer.  This is used by `FFN::Quantize()`.
+   */
+  virtual Layer* QuantizedCopy() const { return NULL; }
+
+  /**
+   * Get an estimate of the number of floating-point operations done by
+   * `Forward()` for each point.  By default this is two for each parameter
+   * (one multiply-add) plus one for each element of the output; layers that
+   * apply their parameters at many positions, like convolutions, override
+   * this.  This is used by `LayerProfiler`.
+   */
+  virtual size_t ForwardFlops() { return 2 * WeightSize() + OutputSize(); }
+
   //! Compute the output dimensions.  This should be overloaded if the layer is
   //! meant to work on higher-dimensional objects.  When this is called, it is a
   //! safe assumption that InputDimensions() is correct.
@@ -310,6 +415,23 @@ class Layer
   }
 
  protected:
+  //! Convert the given dense gradient to a sparse gradient.
+  void ToSparse(const MatType& dense,
+                arma::SpMat<typename MatType::elem_type>& sparse,
+                const std::false_type /* coot */) const
+  {
+    sparse = arma::SpMat<typename MatType::elem_type>(dense);
+  }
+
+  //! Sparse gradients are not available for Bandicoot matrices.
+  void ToSparse(const MatType& /* dense */,
+                arma::SpMat<typename MatType::elem_type>& /* sparse */,
+                const std::true_type /* coot */) const
+  {
+    throw std::logic_error("Layer::SparseGradient(): sparse gradients are "
+        "not available for Bandicoot matrices!");
+  }
+
   /**
    * Logical input dimensions of each point.  Although each point given to !
    * `Forward()` will be represented as a column in a matrix, logically
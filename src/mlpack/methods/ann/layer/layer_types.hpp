@@ -42,6 +42,7 @@
 #include <mlpack/methods/ann/layer/linear_no_bias.hpp>
 #include <mlpack/methods/ann/layer/linear3d.hpp>
 #include <mlpack/methods/ann/layer/log_softmax.hpp>
+#include <mlpack/methods/ann/layer/lookup.hpp>
 #include <mlpack/methods/ann/layer/lstm.hpp>
 #include <mlpack/methods/ann/layer/max_pooling.hpp>
 #include <mlpack/methods/ann/layer/mean_pooling.hpp>
@@ -49,16 +50,21 @@
 #include <mlpack/methods/ann/layer/noisylinear.hpp>
 #include <mlpack/methods/ann/layer/padding.hpp>
 #include <mlpack/methods/ann/layer/parametric_relu.hpp>
+#include <mlpack/methods/ann/layer/quantized_convolution.hpp>
+#include <mlpack/methods/ann/layer/quantized_linear.hpp>
 #include <mlpack/methods/ann/layer/radial_basis_function.hpp>
 #include <mlpack/methods/ann/layer/relu6.hpp>
 #include <mlpack/methods/ann/layer/repeat.hpp>
+#include <mlpack/methods/ann/layer/separable_convolution.hpp>
 #include <mlpack/methods/ann/layer/softmax.hpp>
 #include <mlpack/methods/ann/layer/softmin.hpp>
 #include <mlpack/methods/ann/layer/ftswish.hpp>
 
 // Convolution modes.
 #include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
+#include <mlpack/methods/ann/convolution_rules/depthwise_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 
 // Regularizers.
@@ -74,4 +80,34 @@
 #include <mlpack/methods/ann/layer/serialization.hpp>
 #endif
 
+// If MLPACK_USE_PREBUILT is defined, the common layer types below are compiled
+// into libmlpack (see BUILD_PREBUILT_LIBRARY), and are not instantiated again
+// here.
+#ifdef MLPACK_USE_PREBUILT
+namespace mlpack {
+
+extern template class Layer<arma::mat>;
+extern template class MultiLayer<arma::mat>;
+extern template class LinearType<arma::mat, NoRegularizer>;
+extern template class LinearNoBiasType<arma::mat, NoRegularizer>;
+extern template class BaseLayer<LogisticFunction, arma::mat>;
+extern template class BaseLayer<RectifierFunction, arma::mat>;
+extern template class BaseLayer<TanhFunction, arma::mat>;
+extern template class LeakyReLUType<arma::mat>;
+extern template class IdentityType<arma::mat>;
+extern template class DropoutType<arma::mat>;
+extern template class BatchNormType<arma::mat>;
+extern template class SoftmaxType<arma::mat>;
+extern template class LogSoftMaxType<arma::mat>;
+extern template class ConvolutionType<
+    Im2ColConvolution<ValidConvolution>,
+    Im2ColConvolution<FullConvolution>,
+    Im2ColConvolution<ValidConvolution>,
+    arma::mat>;
+extern template class MaxPoolingType<arma::mat>;
+extern template class MeanPoolingType<arma::mat>;
+
+} // namespace mlpack
+#endif
+
 #endif
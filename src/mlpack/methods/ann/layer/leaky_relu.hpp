@@ -88,6 +88,14 @@ class LeakyReLUType : public Layer<MatType>
                 const MatType& gy,
                 MatType& g);
 
+  /**
+   * Apply the leaky rectifier in place to each element of `x`.
+   *
+   * @param x Elements to apply the leaky rectifier to.
+   * @return Always true.
+   */
+  bool TestingActivation(MatType& x) const;
+
   //! Get the non zero gradient.
   typename MatType::elem_type const& Alpha() const { return alpha; }
   //! Modify the non zero gradient.
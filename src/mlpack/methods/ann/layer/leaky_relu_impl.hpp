@@ -91,6 +91,15 @@ void LeakyReLUType<MatType>::Backward(
     g(i) = gy(i) * ((input(i) >= 0) ? 1 : alpha);
 }
 
+template<typename MatType>
+bool LeakyReLUType<MatType>::TestingActivation(MatType& x) const
+{
+  for (size_t i = 0; i < (size_t) x.n_elem; ++i)
+    x(i) = std::max(x(i), (typename MatType::elem_type) alpha * x(i));
+
+  return true;
+}
+
 template<typename MatType>
 template<typename Archive>
 void LeakyReLUType<MatType>::serialize(
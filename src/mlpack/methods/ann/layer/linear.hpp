@@ -17,6 +17,7 @@
 #include <mlpack/methods/ann/regularizer/no_regularizer.hpp>
 
 #include "layer.hpp"
+#include "quantized_linear.hpp"
 
 namespace mlpack {
 
@@ -118,6 +119,28 @@ class LinearType : public Layer<MatType>
                 const MatType& error,
                 MatType& gradient);
 
+  /**
+   * Scale and shift each output unit of the layer, so that its output becomes
+   * `scale % output + shift`.
+   *
+   * @param scale Scale of each output unit.
+   * @param shift Shift of each output unit.
+   * @return Always true.
+   */
+  bool FoldAffine(const MatType& scale, const MatType& shift);
+
+  /**
+   * Apply the given activation layer to the output of each point right after
+   * the bias is added.
+   *
+   * @param activation Activation layer to fuse into this layer.
+   * @return True if the activation layer supports `TestingActivation()`.
+   */
+  bool FuseActivation(const Layer<MatType>* activation);
+
+  //! Create a QuantizedLinear layer with the quantized weights of this layer.
+  QuantizedLinearType<MatType>* QuantizedCopy() const;
+
   //! Get the parameters.
   const MatType& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -144,6 +167,18 @@ class LinearType : public Layer<MatType>
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
+  /**
+   * Add the bias to each column of `output` and apply the fused activation, if
+   * any, one point at a time through host pointers.
+   */
+  void AddBias(MatType& output, const std::false_type /* coot */) const;
+
+  /**
+   * Add the bias to all columns of the Bandicoot matrix `output` at once;
+   * activations are never fused into layers of Bandicoot matrices.
+   */
+  void AddBias(MatType& output, const std::true_type /* coot */) const;
+
   //! Locally-stored number of input units.
   size_t inSize;
 
@@ -162,6 +197,10 @@ class LinearType : public Layer<MatType>
 
   //! Locally-stored regularizer object.
   RegularizerType regularizer;
+
+  //! The activation layer applied to the output, if any (see
+  //! `FuseActivation()`).  This is not owned by the layer.
+  const Layer<MatType>* activation;
 }; // class LinearType
 
 // Convenience typedefs.
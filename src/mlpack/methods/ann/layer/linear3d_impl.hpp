@@ -106,14 +106,19 @@ void Linear3DType<MatType, RegularizerType>::Forward(
   const CubeType inputTemp(const_cast<MatType&>(input).memptr(),
       this->inputDimensions[0], nPoints, batchSize, false, false);
 
-  for (size_t i = 0; i < batchSize; ++i)
-  {
-    // Shape of weight : (outSize, inSize).
-    // Shape of inputTemp : (inSize, nPoints, batchSize).
-    MatType z = weight * inputTemp.slice(i);
-    z.each_col() += bias;
-    output.col(i) = vectorise(z);
-  }
+  const CubeType weightTemp(weight.memptr(), outSize,
+      this->inputDimensions[0], 1, false, true);
+  CubeType outputTemp(output.memptr(), outSize, nPoints, batchSize, false,
+      true);
+
+  // Shape of weight : (outSize, inSize).
+  // Shape of inputTemp : (inSize, nPoints, batchSize).
+  // The weight is shared by all the points of the batch.
+  BatchedGemm(outputTemp, weightTemp, inputTemp);
+
+  MatType outputPoints(output.memptr(), outSize, nPoints * batchSize, false,
+      true);
+  outputPoints.each_col() += bias;
 }
 
 template<typename MatType, typename RegularizerType>
@@ -137,12 +142,14 @@ void Linear3DType<MatType, RegularizerType>::Backward(
   const CubeType gyTemp(const_cast<MatType&>(gy).memptr(), outSize,
       nPoints, batchSize, false, false);
 
-  for (size_t i = 0; i < gyTemp.n_slices; ++i)
-  {
-    // Shape of weight : (outSize, inSize).
-    // Shape of gyTemp : (outSize, nPoints, batchSize).
-    g.col(i) = vectorise(weight.t() * gyTemp.slice(i));
-  }
+  const CubeType weightTemp(weight.memptr(), outSize,
+      this->inputDimensions[0], 1, false, true);
+  CubeType gTemp(g.memptr(), this->inputDimensions[0], nPoints, batchSize,
+      false, true);
+
+  // Shape of weight : (outSize, inSize).
+  // Shape of gyTemp : (outSize, nPoints, batchSize).
+  BatchedGemm(gTemp, weightTemp, gyTemp, true, false);
 }
 
 template<typename MatType, typename RegularizerType>
@@ -151,31 +158,27 @@ void Linear3DType<MatType, RegularizerType>::Gradient(
     const MatType& error,
     MatType& gradient)
 {
-  typedef typename arma::Cube<typename MatType::elem_type> CubeType;
-
   if (error.n_rows % outSize != 0)
     Log::Fatal << "Propagated error matrix has invalid dimension!" << std::endl;
 
   const size_t nPoints = input.n_rows / this->inputDimensions[0];
   const size_t batchSize = input.n_cols;
 
-  const CubeType inputTemp(const_cast<MatType&>(input).memptr(),
-      this->inputDimensions[0], nPoints, batchSize, false, false);
-  const CubeType errorTemp(const_cast<MatType&>(error).memptr(), outSize,
-      nPoints, batchSize, false, false);
-
-  CubeType dW(outSize, this->inputDimensions[0], batchSize);
-  for (size_t i = 0; i < batchSize; ++i)
-  {
-    // Shape of errorTemp : (outSize, nPoints, batchSize).
-    // Shape of inputTemp : (inSize, nPoints, batchSize).
-    dW.slice(i) = errorTemp.slice(i) * inputTemp.slice(i).t();
-  }
-
-  gradient.submat(0, 0, weight.n_elem - 1, 0) = vectorise(sum(dW, 2));
-
-  gradient.submat(weight.n_elem, 0, weights.n_elem - 1, 0)
-      = vectorise(sum(sum(errorTemp, 2), 1));
+  // Summing the gradients of all the points of the batch is the same as one
+  // product of all the points at once.
+  // Shape of inputPoints : (inSize, nPoints * batchSize).
+  // Shape of errorPoints : (outSize, nPoints * batchSize).
+  const MatType inputPoints(const_cast<MatType&>(input).memptr(),
+      this->inputDimensions[0], nPoints * batchSize, false, true);
+  const MatType errorPoints(const_cast<MatType&>(error).memptr(), outSize,
+      nPoints * batchSize, false, true);
+
+  MatType dW(gradient.memptr(), outSize, this->inputDimensions[0], false,
+      true);
+  dW = errorPoints * inputPoints.t();
+
+  gradient.submat(weight.n_elem, 0, weights.n_elem - 1, 0) =
+      sum(errorPoints, 1);
 
   regularizer.Evaluate(weights, gradient);
 }
@@ -22,7 +22,8 @@ template<typename MatType, typename RegularizerType>
 LinearType<MatType, RegularizerType>::LinearType() :
     Layer<MatType>(),
     inSize(0),
-    outSize(0)
+    outSize(0),
+    activation(NULL)
 {
   // Nothing to do here.
 }
@@ -34,7 +35,8 @@ LinearType<MatType, RegularizerType>::LinearType(
     Layer<MatType>(),
     inSize(0), // This will be computed in ComputeOutputDimensions().
     outSize(outSize),
-    regularizer(regularizer)
+    regularizer(regularizer),
+    activation(NULL)
 {
   weights.set_size(WeightSize(), 1);
 }
@@ -45,7 +47,8 @@ LinearType<MatType, RegularizerType>::LinearType(const LinearType& layer) :
     Layer<MatType>(layer),
     inSize(layer.inSize),
     outSize(layer.outSize),
-    regularizer(layer.regularizer)
+    regularizer(layer.regularizer),
+    activation(layer.activation)
 {
   // Nothing else to do.
 }
@@ -56,7 +59,8 @@ LinearType<MatType, RegularizerType>::LinearType(LinearType&& layer) :
     Layer<MatType>(std::move(layer)),
     inSize(std::move(layer.inSize)),
     outSize(std::move(layer.outSize)),
-    regularizer(std::move(layer.regularizer))
+    regularizer(std::move(layer.regularizer)),
+    activation(layer.activation)
 {
   // Nothing else to do.
 }
@@ -71,6 +75,7 @@ LinearType<MatType, RegularizerType>::operator=(const LinearType& layer)
     inSize = layer.inSize;
     outSize = layer.outSize;
     regularizer = layer.regularizer;
+    activation = layer.activation;
   }
 
   return *this;
@@ -87,6 +92,7 @@ LinearType<MatType, RegularizerType>::operator=(
     inSize = std::move(layer.inSize);
     outSize = std::move(layer.outSize);
     regularizer = std::move(layer.regularizer);
+    activation = layer.activation;
   }
 
   return *this;
@@ -106,10 +112,41 @@ void LinearType<MatType, RegularizerType>::Forward(
     const MatType& input, MatType& output)
 {
   output = weight * input;
+  AddBias(output, std::integral_constant<bool, IsCootType<MatType>::value>());
+}
+
+template<typename MatType, typename RegularizerType>
+void LinearType<MatType, RegularizerType>::AddBias(
+    MatType& output,
+    const std::false_type /* coot */) const
+{
+  if (activation == NULL)
+  {
+    #pragma omp for
+    for (size_t c = 0; c < (size_t) output.n_cols; ++c)
+      output.col(c) += bias;
+  }
+  else
+  {
+    // Apply the activation to each point while its output is still in cache.
+    #pragma omp for
+    for (size_t c = 0; c < (size_t) output.n_cols; ++c)
+    {
+      MatType outputPoint;
+      MakeAlias(outputPoint, output.colptr(c), output.n_rows, 1);
+      outputPoint += bias;
+      activation->TestingActivation(outputPoint);
+    }
+  }
+}
 
-  #pragma omp for
-  for (size_t c = 0; c < (size_t) output.n_cols; ++c)
-    output.col(c) += bias;
+template<typename MatType, typename RegularizerType>
+void LinearType<MatType, RegularizerType>::AddBias(
+    MatType& output,
+    const std::true_type /* coot */) const
+{
+  // A loop over the columns would launch one kernel per point.
+  output += repmat(bias, 1, output.n_cols);
 }
 
 template<typename MatType, typename RegularizerType>
@@ -133,6 +170,35 @@ void LinearType<MatType, RegularizerType>::Gradient(
   regularizer.Evaluate(weights, gradient);
 }
 
+template<typename MatType, typename RegularizerType>
+bool LinearType<MatType, RegularizerType>::FoldAffine(
+    const MatType& scale,
+    const MatType& shift)
+{
+  weight %= repmat(scale, 1, weight.n_cols);
+  bias = bias % scale + shift;
+  return true;
+}
+
+template<typename MatType, typename RegularizerType>
+bool LinearType<MatType, RegularizerType>::FuseActivation(
+    const Layer<MatType>* activation)
+{
+  MatType empty;
+  if (!activation->TestingActivation(empty))
+    return false;
+
+  this->activation = activation;
+  return true;
+}
+
+template<typename MatType, typename RegularizerType>
+QuantizedLinearType<MatType>*
+LinearType<MatType, RegularizerType>::QuantizedCopy() const
+{
+  return new QuantizedLinearType<MatType>(weight, bias);
+}
+
 template<typename MatType, typename RegularizerType>
 void LinearType<MatType, RegularizerType>::ComputeOutputDimensions()
 {
@@ -17,6 +17,7 @@
 #include <mlpack/methods/ann/regularizer/no_regularizer.hpp>
 
 #include "layer.hpp"
+#include "quantized_linear.hpp"
 
 namespace mlpack {
 
@@ -104,6 +105,10 @@ class LinearNoBiasType : public Layer<MatType>
                 const MatType& error,
                 MatType& gradient);
 
+  //! Create a QuantizedLinear layer (without bias) with the quantized weights
+  //! of this layer.
+  QuantizedLinearType<MatType>* QuantizedCopy() const;
+
   //! Get the parameters.
   const MatType& Parameters() const { return weight; }
   //! Modify the parameters.
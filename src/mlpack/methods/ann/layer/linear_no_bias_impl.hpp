@@ -127,6 +127,13 @@ void LinearNoBiasType<MatType, RegularizerType>::Gradient(
   regularizer.Evaluate(weight, gradient);
 }
 
+template<typename MatType, typename RegularizerType>
+QuantizedLinearType<MatType>*
+LinearNoBiasType<MatType, RegularizerType>::QuantizedCopy() const
+{
+  return new QuantizedLinearType<MatType>(weight, MatType());
+}
+
 template<typename MatType, typename RegularizerType>
 void LinearNoBiasType<MatType, RegularizerType>::ComputeOutputDimensions()
 {
@@ -0,0 +1,165 @@
+/**
+ * @file methods/ann/layer/lookup.hpp
+ * @author Marcus Edel
+ *
+ * Definition of the Lookup class, which stores embeddings and retrieves them
+ * using tokens.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_LOOKUP_HPP
+#define MLPACK_METHODS_ANN_LAYER_LOOKUP_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "layer.hpp"
+
+namespace mlpack {
+
+/**
+ * The Lookup class stores word embeddings and retrieves them using tokens.  The
+ * Lookup layer must be the first layer of the network.  Each column of the
+ * input holds a sequence of `seqLength` tokens, which are integers between 0
+ * and `vocabSize - 1` (stored as elements of the input matrix); the embeddings
+ * of the tokens (columns of the weight matrix) are stacked in the output
+ * column.
+ *
+ * The input shape : (seqLength, batchSize).
+ * The output shape : (embeddingSize * seqLength, batchSize); the output
+ * dimensions are (embeddingSize, inputDimensions...).
+ *
+ * The gradient of the layer only involves the embeddings of the tokens of the
+ * batch.  When the network is trained with sparse gradients (see
+ * `FFN::TrainSparse()`), `SparseGradient()` gives only those embeddings, so
+ * that an update only touches the rows of the table that the batch used, even
+ * for very large vocabularies.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class LookupType : public Layer<MatType>
+{
+ public:
+  /**
+   * Create the Lookup object using the specified vocabulary and embedding size.
+   *
+   * @param vocabSize The size of the vocabulary.
+   * @param embeddingSize The length of each embedding vector.
+   */
+  LookupType(const size_t vocabSize = 0, const size_t embeddingSize = 0);
+
+  //! Clone the LookupType object. This handles polymorphism correctly.
+  LookupType* Clone() const { return new LookupType(*this); }
+
+  //! Virtual destructor.
+  virtual ~LookupType() { }
+
+  //! Copy the given LookupType.
+  LookupType(const LookupType& other);
+  //! Take ownership of the given LookupType.
+  LookupType(LookupType&& other);
+  //! Copy the given LookupType.
+  LookupType& operator=(const LookupType& other);
+  //! Take ownership of the given LookupType.
+  LookupType& operator=(LookupType&& other);
+
+  //! Reset the layer parameter.
+  void SetWeights(typename MatType::elem_type* weightsPtr);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.  A
+   * std::invalid_argument is thrown if a token is not in [0, VocabSize()).
+   *
+   * @param input Input tokens used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * The tokens are not differentiable, so the backpropagated error is zero.
+   *
+   * @param * (input) The propagated input activation.
+   * @param * (output) The propagated data (f(x)) resulting from Forward().
+   * @param * (gy) The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& /* gy */,
+                MatType& g);
+
+  /**
+   * Calculate the gradient using the output delta and the input tokens.
+   *
+   * @param input The input tokens used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  void Gradient(const MatType& input,
+                const MatType& error,
+                MatType& gradient);
+
+  /**
+   * Calculate the gradient as a sparse vector, which only holds the
+   * embeddings of the tokens of `input`.
+   *
+   * @param input The input tokens used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient Sparse vector to store the gradient in.
+   */
+  void SparseGradient(const MatType& input,
+                      const MatType& error,
+                      arma::SpMat<typename MatType::elem_type>& gradient);
+
+  //! Get the parameters.
+  const MatType& Parameters() const { return weights; }
+  //! Modify the parameters.
+  MatType& Parameters() { return weights; }
+
+  //! Get the size of the vocabulary.
+  size_t VocabSize() const { return vocabSize; }
+
+  //! Get the length of each embedding vector.
+  size_t EmbeddingSize() const { return embeddingSize; }
+
+  //! Get the number of trainable parameters.
+  size_t WeightSize() const { return embeddingSize * vocabSize; }
+
+  //! A forward pass copies the embeddings, and does no arithmetic.
+  size_t ForwardFlops() { return this->OutputSize(); }
+
+  //! Compute the output dimensions of the layer using `InputDimensions()`.
+  //! This layer adds an extra dimension for the embedding.
+  void ComputeOutputDimensions();
+
+  //! Serialize the layer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored size of the vocabulary.
+  size_t vocabSize;
+
+  //! Locally-stored length of each embedding vector.
+  size_t embeddingSize;
+
+  //! Locally-stored weight object (one embedding in each column).
+  MatType weights;
+}; // class LookupType
+
+// Standard Lookup layer.
+typedef LookupType<arma::mat> Lookup;
+// Alias for using as embedding layer.
+typedef LookupType<arma::mat> Embedding;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "lookup_impl.hpp"
+
+#endif
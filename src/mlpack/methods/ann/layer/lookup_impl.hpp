@@ -0,0 +1,198 @@
+/**
+ * @file methods/ann/layer/lookup_impl.hpp
+ * @author Marcus Edel
+ *
+ * Implementation of the Lookup class, which stores embeddings and retrieves
+ * them using tokens.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_LOOKUP_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_LOOKUP_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "lookup.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+LookupType<MatType>::LookupType(
+    const size_t vocabSize,
+    const size_t embeddingSize) :
+    Layer<MatType>(),
+    vocabSize(vocabSize),
+    embeddingSize(embeddingSize)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+LookupType<MatType>::LookupType(const LookupType& other) :
+    Layer<MatType>(other),
+    vocabSize(other.vocabSize),
+    embeddingSize(other.embeddingSize)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+LookupType<MatType>::LookupType(LookupType&& other) :
+    Layer<MatType>(std::move(other)),
+    vocabSize(std::move(other.vocabSize)),
+    embeddingSize(std::move(other.embeddingSize))
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+LookupType<MatType>&
+LookupType<MatType>::operator=(const LookupType& other)
+{
+  if (&other != this)
+  {
+    Layer<MatType>::operator=(other);
+    vocabSize = other.vocabSize;
+    embeddingSize = other.embeddingSize;
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+LookupType<MatType>&
+LookupType<MatType>::operator=(LookupType&& other)
+{
+  if (&other != this)
+  {
+    Layer<MatType>::operator=(std::move(other));
+    vocabSize = std::move(other.vocabSize);
+    embeddingSize = std::move(other.embeddingSize);
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+void LookupType<MatType>::SetWeights(typename MatType::elem_type* weightsPtr)
+{
+  MakeAlias(weights, weightsPtr, embeddingSize, vocabSize);
+}
+
+template<typename MatType>
+void LookupType<MatType>::Forward(const MatType& input, MatType& output)
+{
+  const size_t seqLength = input.n_rows;
+
+  // An exception can't leave the parallel loop, so the tokens are checked
+  // first.
+  for (size_t i = 0; i < (size_t) input.n_elem; ++i)
+  {
+    if (!(input[i] >= 0 && input[i] < vocabSize))
+    {
+      std::ostringstream oss;
+      oss << "Lookup::Forward(): token " << input[i] << " (element " << i
+          << " of the input) is not in the vocabulary of size " << vocabSize
+          << "!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t i = 0; i < (size_t) input.n_cols; ++i)
+  {
+    // The ith column of the output holds the embeddings of the tokens of the
+    // ith column of the input, one after the other.
+    for (size_t s = 0; s < seqLength; ++s)
+    {
+      const size_t token = (size_t) input(s, i);
+      output.submat(s * embeddingSize, i, (s + 1) * embeddingSize - 1, i) =
+          weights.col(token);
+    }
+  }
+}
+
+template<typename MatType>
+void LookupType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& /* output */,
+    const MatType& /* gy */,
+    MatType& g)
+{
+  g.zeros();
+}
+
+template<typename MatType>
+void LookupType<MatType>::Gradient(
+    const MatType& input,
+    const MatType& error,
+    MatType& gradient)
+{
+  const size_t seqLength = input.n_rows;
+
+  MatType gradientTemp;
+  MakeAlias(gradientTemp, MemPtr(gradient), embeddingSize, vocabSize);
+  gradientTemp.zeros();
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    for (size_t s = 0; s < seqLength; ++s)
+    {
+      const size_t token = (size_t) input(s, i);
+      gradientTemp.col(token) += error.submat(s * embeddingSize, i,
+          (s + 1) * embeddingSize - 1, i);
+    }
+  }
+}
+
+template<typename MatType>
+void LookupType<MatType>::SparseGradient(
+    const MatType& input,
+    const MatType& error,
+    arma::SpMat<typename MatType::elem_type>& gradient)
+{
+  typedef typename MatType::elem_type ElemType;
+  const size_t seqLength = input.n_rows;
+
+  // Each element of the error belongs to one element of the embedding of one
+  // token; repeated tokens are summed when the sparse vector is built.
+  arma::umat locations(2, error.n_elem, arma::fill::zeros);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    for (size_t s = 0; s < seqLength; ++s)
+    {
+      const size_t token = (size_t) input(s, i);
+      const size_t start = (i * seqLength + s) * embeddingSize;
+      for (size_t k = 0; k < embeddingSize; ++k)
+        locations(0, start + k) = token * embeddingSize + k;
+    }
+  }
+
+  gradient = arma::SpMat<ElemType>(true, locations,
+      arma::Col<ElemType>(vectorise(error)), WeightSize(), 1);
+}
+
+template<typename MatType>
+void LookupType<MatType>::ComputeOutputDimensions()
+{
+  this->outputDimensions = std::vector<size_t>(
+      this->inputDimensions.size() + 1, embeddingSize);
+  for (size_t i = 0; i < this->inputDimensions.size(); ++i)
+    this->outputDimensions[i + 1] = this->inputDimensions[i];
+}
+
+template<typename MatType>
+template<typename Archive>
+void LookupType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(vocabSize));
+  ar(CEREAL_NVP(embeddingSize));
+}
+
+} // namespace mlpack
+
+#endif
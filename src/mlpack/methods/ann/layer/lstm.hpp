@@ -32,6 +32,16 @@ namespace mlpack {
  * h &=& o \odot tanh(c)
  * @f}
  *
+ * The pre-activations of the four gates are computed with one matrix product
+ * for the input and one for the previous output, and the gates, the cell, and
+ * the output are then computed in a single pass over the pre-activations.
+ * When the LSTM is the first layer of an `RNN`, the input pre-activations of
+ * all the steps are computed with one matrix product before the first step.
+ *
+ * The number of columns of the input may decrease from one step to the next,
+ * when sequences of different lengths are packed (see `PackedSequences`); the
+ * sequences of a step are then the first sequences of the previous step.
+ *
  * Note that if an LSTM layer is desired as the first layer of a neural network,
  * an IdentityLayer should be added to the network as the first layer, and then
  * the LSTM layer should be added.
@@ -48,9 +58,6 @@ namespace mlpack {
  * }
  * @endcode
  *
- * \see FastLSTM for a faster LSTM version which combines the calculation of the
- * input, forget, output gates and hidden state in a single step.
- *
  * @tparam MatType Matrix representation to accept as input and use for
  *    computation.
  */
@@ -133,6 +140,15 @@ class LSTMType : public RecurrentLayer<MatType>
    */
   void ClearRecurrentState(const size_t bpttSteps, const size_t batchSize);
 
+  /**
+   * Compute the input pre-activations of the gates for all the steps of the
+   * sequence with one matrix product; each forward pass then only has to
+   * apply the recurrent weights.
+   *
+   * @param inputs Packed inputs of every step (see `PackedSequences`).
+   */
+  void PrepareSequence(const MatType& inputs);
+
   //! Get the parameters.
   const MatType& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -208,20 +224,6 @@ class LSTMType : public RecurrentLayer<MatType>
   //! Weights between cell and output gate.
   MatType cell2GateOutputWeight;
 
-  // Below here are recurrent state matrices.
-
-  //! Locally-stored input gate parameter.
-  MatType inputGate;
-
-  //! Locally-stored forget gate parameter.
-  MatType forgetGate;
-
-  //! Locally-stored hidden layer parameter.
-  MatType hiddenLayer;
-
-  //! Locally-stored output gate parameter.
-  MatType outputGate;
-
   //! Locally-stored input to hidden weight.
   MatType input2HiddenWeight;
 
@@ -231,6 +233,31 @@ class LSTMType : public RecurrentLayer<MatType>
   //! Locally-stored output to hidden weight.
   MatType output2HiddenWeight;
 
+  //! The input weights of the output gate, forget gate, input gate, and hidden
+  //! layer, stacked (in that order) so that they are applied with one product.
+  //! This is copied from the parameters by ClearRecurrentState().
+  MatType stackedInputWeight;
+
+  //! The stacked biases of the gates and hidden layer.
+  MatType stackedBias;
+
+  //! The stacked recurrent weights of the gates and hidden layer.
+  MatType stackedRecurrentWeight;
+
+  // Below here are recurrent state matrices.
+
+  //! Locally-stored pre-activations of the gates and hidden layer, stacked in
+  //! the same order as the weights.
+  MatType gates;
+
+  //! The input pre-activations (including the biases) of every step given to
+  //! PrepareSequence(), or an empty matrix.
+  MatType projectedInputs;
+
+  //! The step used as the previous step by the forward pass of each step, or
+  //! size_t(-1) if there was none.
+  std::vector<size_t> pastSteps;
+
   //! Locally-stored cell parameter.
   arma::Cube<typename MatType::elem_type> cell;
 
@@ -251,23 +278,19 @@ class LSTMType : public RecurrentLayer<MatType>
   //! Locally-stored cell activation error.
   arma::Cube<typename MatType::elem_type> cellActivation;
 
-  //! Locally-stored forget gate error.
-  MatType forgetGateError;
-
-  //! Locally-stored output gate error.
-  MatType outputGateError;
-
   //! Locally-stored output parameters.
   arma::Cube<typename MatType::elem_type> outParameter;
 
-  //! Locally-stored input cell error parameter.
-  MatType inputCellError;
+  //! Locally-stored errors of the gates and hidden layer, stacked in the same
+  //! order as the weights.
+  MatType gateError;
 
-  //! Locally-stored input gate error.
-  MatType inputGateError;
+  //! Locally-stored error of the output, including the error backpropagated
+  //! from the next step.
+  MatType outputError;
 
-  //! Locally-stored hidden layer error.
-  MatType hiddenError;
+  //! Locally-stored input cell error parameter.
+  MatType inputCellError;
 }; // class LSTMType
 
 // Convenience typedefs.
@@ -35,14 +35,18 @@ LSTMType<MatType>::LSTMType(const size_t outSize) :
 
 template<typename MatType>
 LSTMType<MatType>::LSTMType(const LSTMType& layer) :
-    RecurrentLayer<MatType>(layer)
+    RecurrentLayer<MatType>(layer),
+    inSize(layer.inSize),
+    outSize(layer.outSize)
 {
   // Nothing to do here.
 }
 
 template<typename MatType>
 LSTMType<MatType>::LSTMType(LSTMType&& layer) :
-    RecurrentLayer<MatType>(std::move(layer))
+    RecurrentLayer<MatType>(std::move(layer)),
+    inSize(layer.inSize),
+    outSize(layer.outSize)
 {
   // Nothing to do here.
 }
@@ -53,6 +57,8 @@ LSTMType<MatType>& LSTMType<MatType>::operator=(const LSTMType& layer)
   if (this != &layer)
   {
     RecurrentLayer<MatType>::operator=(layer);
+    inSize = layer.inSize;
+    outSize = layer.outSize;
   }
 
   return *this;
@@ -64,6 +70,8 @@ LSTMType<MatType>& LSTMType<MatType>::operator=(LSTMType&& layer)
   if (this != &layer)
   {
     RecurrentLayer<MatType>::operator=(std::move(layer));
+    inSize = layer.inSize;
+    outSize = layer.outSize;
   }
 
   return *this;
@@ -75,10 +83,10 @@ void LSTMType<MatType>::ClearRecurrentState(
 {
   // Make sure all of the different matrices we will use to hold parameters are
   // at least as large as we need.
-  inputGate.set_size(outSize, batchSize);
-  forgetGate.set_size(outSize, batchSize);
-  hiddenLayer.set_size(outSize, batchSize);
-  outputGate.set_size(outSize, batchSize);
+  gates.set_size(4 * outSize, batchSize);
+  gateError.set_size(4 * outSize, batchSize);
+  outputError.set_size(outSize, batchSize);
+  inputCellError.set_size(outSize, batchSize);
 
   inputGateActivation.set_size(outSize, batchSize, bpttSteps);
   forgetGateActivation.set_size(outSize, batchSize, bpttSteps);
@@ -90,6 +98,26 @@ void LSTMType<MatType>::ClearRecurrentState(
 
   // Now reset recurrent values to 0.
   cell.zeros(outSize, batchSize, bpttSteps);
+  pastSteps.assign(bpttSteps, size_t(-1));
+  projectedInputs.clear();
+
+  // The weights of each gate are stored separately in the parameters, so they
+  // are stacked here; the parameters do not change during a sequence.
+  stackedInputWeight = join_cols(
+      join_cols(input2GateOutputWeight, input2GateForgetWeight),
+      join_cols(input2GateInputWeight, input2HiddenWeight));
+  stackedBias = join_cols(join_cols(input2GateOutputBias, input2GateForgetBias),
+      join_cols(input2GateInputBias, input2HiddenBias));
+  stackedRecurrentWeight = join_cols(
+      join_cols(output2GateOutputWeight, output2GateForgetWeight),
+      join_cols(output2GateInputWeight, output2HiddenWeight));
+}
+
+template<typename MatType>
+void LSTMType<MatType>::PrepareSequence(const MatType& inputs)
+{
+  projectedInputs = stackedInputWeight * inputs;
+  projectedInputs.each_col() += stackedBias;
 }
 
 template<typename MatType>
@@ -148,92 +176,84 @@ void LSTMType<MatType>::SetWeights(
   MakeAlias(cell2GateInputWeight, weightsPtr + offset, outSize, 1);
 }
 
-// Forward when cellState is not needed.
 template<typename MatType>
 void LSTMType<MatType>::Forward(const MatType& input, MatType& output)
 {
+  typedef typename MatType::elem_type ElemType;
+
   // Convenience alias.
   const size_t batchSize = input.n_cols;
-
-  inputGate = input2GateInputWeight * input;
-  if (this->HasPreviousStep())
+  const size_t step = this->CurrentStep();
+  const bool hasPrevious = this->HasPreviousStep();
+  pastSteps[step] = this->PreviousStep();
+
+  // Compute the pre-activations of all the gates at once, unless the input
+  // part was computed for the whole sequence by PrepareSequence().
+  const size_t offset = this->SequenceOffset();
+  if (offset != size_t(-1) && offset + batchSize <= projectedInputs.n_cols)
   {
-    inputGate +=
-        output2GateInputWeight * outParameter.slice(this->PreviousStep());
-  }
-  inputGate.each_col() += input2GateInputBias;
-
-  forgetGate = input2GateForgetWeight * input;
-  if (this->HasPreviousStep())
-  {
-    forgetGate += output2GateForgetWeight * outParameter.slice(
-        this->PreviousStep());
-  }
-  forgetGate.each_col() += input2GateForgetBias;
-
-  if (this->HasPreviousStep())
-  {
-    inputGate += repmat(cell2GateInputWeight, 1, batchSize) %
-        cell.slice(this->PreviousStep());
-
-    forgetGate += repmat(cell2GateForgetWeight, 1, batchSize) %
-        cell.slice(this->PreviousStep());
+    gates = projectedInputs.cols(offset, offset + batchSize - 1);
   }
-
-  inputGateActivation.slice(this->CurrentStep()) =
-      1.0 / (1.0 + exp(-inputGate));
-  forgetGateActivation.slice(this->CurrentStep()) =
-      1.0 / (1.0 + exp(-forgetGate));
-
-  hiddenLayer = input2HiddenWeight * input;
-  if (this->HasPreviousStep())
+  else
   {
-    hiddenLayer += output2HiddenWeight *
-        outParameter.slice(this->PreviousStep());
+    gates = stackedInputWeight * input;
+    gates.each_col() += stackedBias;
   }
-  hiddenLayer.each_col() += input2HiddenBias;
-
-  hiddenLayerActivation.slice(this->CurrentStep()) = arma::tanh(hiddenLayer);
 
-  if (!this->HasPreviousStep())
-  {
-    cell.slice(this->CurrentStep()) =
-        inputGateActivation.slice(this->CurrentStep()) %
-        hiddenLayerActivation.slice(this->CurrentStep());
-  }
-  else
+  // If the batch shrinks, only the first sequences of the previous step are
+  // still running.
+  if (hasPrevious)
   {
-    cell.slice(this->CurrentStep()) =
-        forgetGateActivation.slice(this->CurrentStep()) %
-        cell.slice(this->PreviousStep()) +
-        inputGateActivation.slice(this->CurrentStep()) %
-        hiddenLayerActivation.slice(this->CurrentStep());
+    gates += stackedRecurrentWeight *
+        outParameter.slice(this->PreviousStep()).head_cols(batchSize);
   }
 
-  outputGate = input2GateOutputWeight * input +
-      cell.slice(this->CurrentStep()).each_col() % cell2GateOutputWeight;
-  if (this->HasPreviousStep())
+  const ElemType* prevCell = hasPrevious ?
+      cell.slice_memptr(this->PreviousStep()) : NULL;
+  ElemType* currentCell = cell.slice_memptr(step);
+  ElemType* inputGate = inputGateActivation.slice_memptr(step);
+  ElemType* forgetGate = forgetGateActivation.slice_memptr(step);
+  ElemType* outputGate = outputGateActivation.slice_memptr(step);
+  ElemType* hidden = hiddenLayerActivation.slice_memptr(step);
+  ElemType* cellAct = cellActivation.slice_memptr(step);
+  ElemType* out = outParameter.slice_memptr(step);
+
+  // Now apply the activations and update the cell and the output in a single
+  // pass.  (The previous step may be the current step, when only one step is
+  // kept, so each element of the previous cell is read before it is written.)
+  for (size_t j = 0; j < batchSize; ++j)
   {
-    outputGate +=
-        output2GateOutputWeight * outParameter.slice(this->PreviousStep());
+    const ElemType* z = gates.colptr(j);
+    for (size_t k = 0; k < outSize; ++k)
+    {
+      const size_t i = j * outSize + k;
+      const ElemType c = hasPrevious ? prevCell[i] : ElemType(0);
+
+      const ElemType ig = 1 / (1 + std::exp(-(z[2 * outSize + k] +
+          cell2GateInputWeight[k] * c)));
+      const ElemType fg = 1 / (1 + std::exp(-(z[outSize + k] +
+          cell2GateForgetWeight[k] * c)));
+      const ElemType h = std::tanh(z[3 * outSize + k]);
+      const ElemType newCell = fg * c + ig * h;
+      const ElemType og = 1 / (1 + std::exp(-(z[k] +
+          cell2GateOutputWeight[k] * newCell)));
+      const ElemType newCellAct = std::tanh(newCell);
+
+      inputGate[i] = ig;
+      forgetGate[i] = fg;
+      hidden[i] = h;
+      currentCell[i] = newCell;
+      outputGate[i] = og;
+      cellAct[i] = newCellAct;
+      out[i] = og * newCellAct;
+    }
   }
-  outputGate.each_col() += input2GateOutputBias;
-
-  outputGateActivation.slice(this->CurrentStep()) =
-      1.0 / (1.0 + exp(-outputGate));
-
-  cellActivation.slice(this->CurrentStep()) =
-      arma::tanh(cell.slice(this->CurrentStep()));
 
   // There's a bit of an issue here: we need to preserve the output for the next
   // time step, but we also need to set `output` to that.  Unfortunately for now
   // we make a copy, but it's possible that we could instead use an alias here,
   // or have `outParameter` hold a collection of aliases.
-  outParameter.slice(this->CurrentStep()) =
-      cellActivation.slice(this->CurrentStep()) %
-      outputGateActivation.slice(this->CurrentStep());
-
-  output = outParameter.slice(this->CurrentStep());
+  output = outParameter.slice(step).head_cols(batchSize);
 }
 
 template<typename MatType>
@@ -243,62 +263,71 @@ void LSTMType<MatType>::Backward(
     const MatType& gy,
     MatType& g)
 {
-  MatType gyLocal;
-  if (this->HasPreviousStep())
-  {
-    gyLocal = gy + output2GateOutputWeight.t() * outputGateError +
-      output2GateForgetWeight.t() * forgetGateError +
-      output2GateInputWeight.t() * inputGateError +
-      output2HiddenWeight.t() * hiddenError;
-  }
-  else
-  {
-    // Make an alias.
-    gyLocal = MatType(((MatType&) gy).memptr(), gy.n_rows, gy.n_cols,
-        false, false);
-  }
+  typedef typename MatType::elem_type ElemType;
 
-  outputGateError = gyLocal % cellActivation.slice(this->CurrentStep()) %
-      (outputGateActivation.slice(this->CurrentStep()) %
-      (1.0 - outputGateActivation.slice(this->CurrentStep())));
+  // During the backward pass, the previous step is the step after this one,
+  // and `gateError` and `inputCellError` still hold its errors.
+  const size_t step = this->CurrentStep();
+  const bool hasNext = this->HasPreviousStep();
+  const bool hasPast = (pastSteps[step] != size_t(-1));
+  const size_t batchSize = gy.n_cols;
 
-  MatType cellError = gyLocal %
-      outputGateActivation.slice(this->CurrentStep()) %
-      (1 - pow(cellActivation.slice(this->CurrentStep()), 2)) +
-      outputGateError.each_col() % cell2GateOutputWeight;
+  // The next step may have fewer sequences than this one; the others have
+  // ended at this step.
+  const size_t nextBatchSize = hasNext ? gateError.n_cols : 0;
 
-  if (this->HasPreviousStep())
+  outputError = gy;
+  if (hasNext)
   {
-    cellError += inputCellError;
+    outputError.head_cols(nextBatchSize) +=
+        stackedRecurrentWeight.t() * gateError;
   }
 
-  if (this->HasPreviousStep())
-  {
-    forgetGateError = cell.slice(this->PreviousStep()) % cellError %
-        (forgetGateActivation.slice(this->CurrentStep()) %
-        (1.0 - forgetGateActivation.slice(this->CurrentStep())));
-  }
-  else
+  const ElemType* pastCell = hasPast ? cell.slice_memptr(pastSteps[step]) :
+      NULL;
+  const ElemType* inputGate = inputGateActivation.slice_memptr(step);
+  const ElemType* forgetGate = forgetGateActivation.slice_memptr(step);
+  const ElemType* outputGate = outputGateActivation.slice_memptr(step);
+  const ElemType* hidden = hiddenLayerActivation.slice_memptr(step);
+  const ElemType* cellAct = cellActivation.slice_memptr(step);
+
+  gateError.set_size(4 * outSize, batchSize);
+  for (size_t j = 0; j < batchSize; ++j)
   {
-    forgetGateError.zeros(forgetGateActivation.n_rows,
-        forgetGateActivation.n_cols);
+    ElemType* e = gateError.colptr(j);
+    for (size_t k = 0; k < outSize; ++k)
+    {
+      const size_t i = j * outSize + k;
+      const ElemType dy = outputError[i];
+
+      const ElemType outputGateError = dy * cellAct[i] *
+          outputGate[i] * (1 - outputGate[i]);
+      ElemType cellError = dy * outputGate[i] *
+          (1 - cellAct[i] * cellAct[i]) +
+          outputGateError * cell2GateOutputWeight[k];
+      if (j < nextBatchSize)
+        cellError += inputCellError[i];
+
+      const ElemType forgetGateError = hasPast ? (pastCell[i] * cellError *
+          forgetGate[i] * (1 - forgetGate[i])) : ElemType(0);
+      const ElemType inputGateError = hidden[i] * cellError *
+          inputGate[i] * (1 - inputGate[i]);
+      const ElemType hiddenError = inputGate[i] * cellError *
+          (1 - hidden[i] * hidden[i]);
+
+      // The error of the cell of the past step.
+      inputCellError[i] = forgetGate[i] * cellError +
+          forgetGateError * cell2GateForgetWeight[k] +
+          inputGateError * cell2GateInputWeight[k];
+
+      e[k] = outputGateError;
+      e[outSize + k] = forgetGateError;
+      e[2 * outSize + k] = inputGateError;
+      e[3 * outSize + k] = hiddenError;
+    }
   }
 
-  inputGateError = hiddenLayerActivation.slice(this->CurrentStep()) %
-      cellError % (inputGateActivation.slice(this->CurrentStep()) %
-      (1.0 - inputGateActivation.slice(this->CurrentStep())));
-
-  hiddenError = inputGateActivation.slice(this->CurrentStep()) % cellError %
-      (1 - pow(hiddenLayerActivation.slice(this->CurrentStep()), 2));
-
-  inputCellError = forgetGateActivation.slice(this->CurrentStep()) % cellError +
-      forgetGateError.each_col() % cell2GateForgetWeight +
-      inputGateError.each_col() % cell2GateInputWeight;
-
-  g = input2GateInputWeight.t() * inputGateError +
-      input2HiddenWeight.t() * hiddenError +
-      input2GateForgetWeight.t() * forgetGateError +
-      input2GateOutputWeight.t() * outputGateError;
+  g = stackedInputWeight.t() * gateError;
 }
 
 template<typename MatType>
@@ -309,80 +338,63 @@ void LSTMType<MatType>::Gradient(
 {
   // This implementation depends on Gradient() being called just after
   // Backward(), which is something we can safely assume.
+  const size_t step = this->CurrentStep();
+  const bool hasPast = (pastSteps[step] != size_t(-1));
+  const size_t batchSize = gateError.n_cols;
+
+  // The gradients of the stacked weights are computed with one product each,
+  // and then copied to the parameters of each gate.
+  const MatType inputWeightGradient = gateError * input.t();
+  const MatType biasGradient = sum(gateError, 1);
+  MatType recurrentWeightGradient;
+  if (hasPast)
+  {
+    recurrentWeightGradient = gateError *
+        outParameter.slice(pastSteps[step]).head_cols(batchSize).t();
+  }
+  else
+  {
+    recurrentWeightGradient.zeros(4 * outSize, outSize);
+  }
 
-  // Input2GateOutputWeight and input2GateOutputBias gradients.
-  gradient.submat(0, 0, input2GateOutputWeight.n_elem - 1, 0) =
-      vectorise(outputGateError * input.t());
-  gradient.submat(input2GateOutputWeight.n_elem, 0,
-      input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem - 1, 0) =
-      sum(outputGateError, 1);
-  size_t offset = input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem;
-
-  // input2GateForgetWeight and input2GateForgetBias gradients.
-  gradient.submat(offset, 0, offset + input2GateForgetWeight.n_elem - 1, 0) =
-      vectorise(forgetGateError * input.t());
-  gradient.submat(offset + input2GateForgetWeight.n_elem, 0,
-      offset + input2GateForgetWeight.n_elem +
-      input2GateForgetBias.n_elem - 1, 0) = sum(forgetGateError, 1);
-  offset += input2GateForgetWeight.n_elem + input2GateForgetBias.n_elem;
-
-  // input2GateInputWeight and input2GateInputBias gradients.
-  gradient.submat(offset, 0, offset + input2GateInputWeight.n_elem - 1, 0) =
-      vectorise(inputGateError * input.t());
-  gradient.submat(offset + input2GateInputWeight.n_elem, 0,
-      offset + input2GateInputWeight.n_elem +
-      input2GateInputBias.n_elem - 1, 0) = sum(inputGateError, 1);
-  offset += input2GateInputWeight.n_elem + input2GateInputBias.n_elem;
-
-  // input2HiddenWeight and input2HiddenBias gradients.
-  gradient.submat(offset, 0, offset + input2HiddenWeight.n_elem - 1, 0) =
-      vectorise(hiddenError * input.t());
-  gradient.submat(offset + input2HiddenWeight.n_elem, 0,
-      offset + input2HiddenWeight.n_elem + input2HiddenBias.n_elem - 1, 0) =
-      sum(hiddenError, 1);
-  offset += input2HiddenWeight.n_elem + input2HiddenBias.n_elem;
-
-  // output2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateOutputWeight.n_elem - 1, 0) =
-      vectorise(outputGateError * outParameter.slice(this->CurrentStep()).t());
-  offset += output2GateOutputWeight.n_elem;
-
-  // output2GateForgetWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateForgetWeight.n_elem - 1, 0) =
-      vectorise(forgetGateError * outParameter.slice(this->CurrentStep()).t());
-  offset += output2GateForgetWeight.n_elem;
-
-  // output2GateInputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateInputWeight.n_elem - 1, 0) =
-      vectorise(inputGateError * outParameter.slice(this->CurrentStep()).t());
-  offset += output2GateInputWeight.n_elem;
+  size_t offset = 0;
+  for (size_t gate = 0; gate < 4; ++gate)
+  {
+    gradient.submat(offset, 0, offset + outSize * inSize - 1, 0) = vectorise(
+        inputWeightGradient.rows(gate * outSize, (gate + 1) * outSize - 1));
+    offset += outSize * inSize;
+    gradient.submat(offset, 0, offset + outSize - 1, 0) =
+        biasGradient.rows(gate * outSize, (gate + 1) * outSize - 1);
+    offset += outSize;
+  }
 
-  // output2HiddenWeight gradients.
-  gradient.submat(offset, 0, offset + output2HiddenWeight.n_elem - 1, 0) =
-      vectorise(hiddenError * outParameter.slice(this->CurrentStep()).t());
-  offset += output2HiddenWeight.n_elem;
+  for (size_t gate = 0; gate < 4; ++gate)
+  {
+    gradient.submat(offset, 0, offset + outSize * outSize - 1, 0) =
+        vectorise(recurrentWeightGradient.rows(gate * outSize,
+        (gate + 1) * outSize - 1));
+    offset += outSize * outSize;
+  }
 
   // cell2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + cell2GateOutputWeight.n_elem - 1, 0) =
-      sum(outputGateError % cell.slice(this->CurrentStep()), 1);
-  offset += cell2GateOutputWeight.n_elem;
+  gradient.submat(offset, 0, offset + outSize - 1, 0) =
+      sum(gateError.rows(0, outSize - 1) %
+      cell.slice(step).head_cols(batchSize), 1);
+  offset += outSize;
 
   // cell2GateForgetWeight and cell2GateInputWeight gradients.
-  if (this->HasPreviousStep())
+  if (hasPast)
   {
-    gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
-        sum(forgetGateError % cell.slice(this->PreviousStep()), 1);
-    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
-        cell2GateForgetWeight.n_elem + cell2GateInputWeight.n_elem - 1, 0) =
-        sum(inputGateError % cell.slice(this->PreviousStep()), 1);
+    gradient.submat(offset, 0, offset + outSize - 1, 0) =
+        sum(gateError.rows(outSize, 2 * outSize - 1) %
+        cell.slice(pastSteps[step]).head_cols(batchSize), 1);
+    gradient.submat(offset + outSize, 0, offset + 2 * outSize - 1, 0) =
+        sum(gateError.rows(2 * outSize, 3 * outSize - 1) %
+        cell.slice(pastSteps[step]).head_cols(batchSize), 1);
   }
   else
   {
-    gradient.submat(offset, 0, offset +
-        cell2GateForgetWeight.n_elem - 1, 0).zeros();
-    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
-        cell2GateForgetWeight.n_elem +
-        cell2GateInputWeight.n_elem - 1, 0).zeros();
+    gradient.submat(offset, 0, offset + 2 * outSize - 1, 0).zeros();
   }
 }
 
@@ -403,12 +415,16 @@ void LSTMType<MatType>::serialize(Archive& ar, const uint32_t /* version */)
     outputGateActivation.clear();
     hiddenLayerActivation.clear();
     cellActivation.clear();
-    forgetGateError.clear();
-    outputGateError.clear();
     outParameter.clear();
+    gates.clear();
+    gateError.clear();
+    outputError.clear();
     inputCellError.clear();
-    inputGateError.clear();
-    hiddenError.clear();
+    pastSteps.clear();
+    stackedInputWeight.clear();
+    stackedBias.clear();
+    stackedRecurrentWeight.clear();
+    projectedInputs.clear();
   }
 }
 
@@ -152,135 +152,52 @@ class MaxPoolingType : public Layer<MatType>
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
+  typedef arma::Cube<typename MatType::elem_type> CubeType;
+
   /**
-   * Apply pooling to the input and store the results.
+   * Apply pooling to all slices of the input and store the results.  If
+   * `offsets` is not NULL, the position of the maximum of each window is
+   * stored in it, as an offset in the (column-major) window; `IndexType` must
+   * be able to hold `kernelWidth * kernelHeight - 1`.
    *
-   * @param input The input to be apply the pooling rule.
+   * @param input The input to apply the pooling rule to.
    * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
+   * @param offsets The offsets of the maxima (or NULL).
    */
-  void PoolingOperation(
-      const arma::Cube<typename MatType::elem_type>& input,
-      arma::Cube<typename MatType::elem_type>& output,
-      arma::Cube<size_t>& poolingIndices)
-  {
-    // Iterate over all slices individually.
-    #pragma omp parallel for
-    for (size_t s = 0; s < (size_t) input.n_slices; ++s)
-    {
-      for (size_t j = 0, colidx = 0; j < output.n_cols;
-          ++j, colidx += strideHeight)
-      {
-        size_t colEnd = colidx + kernelHeight - 1;
-        // Check if the kernel along column is out of bounds.
-        if (colEnd > input.n_cols - 1)
-        {
-          // If so, we need to reduce the kernel height or terminate.
-          if (floor)
-            continue;
-          colEnd = input.n_cols - 1;
-        }
-        for (size_t i = 0, rowidx = 0; i < output.n_rows;
-            ++i, rowidx += strideWidth)
-        {
-          size_t rowEnd = rowidx + kernelWidth - 1;
-          // Check if the kernel along row is out of bounds.
-          if (rowEnd > input.n_rows - 1)
-          {
-            // If so, we need to reduce the kernel width or terminate.
-            if (floor)
-              continue;
-            rowEnd = input.n_rows - 1;
-          }
-          const std::tuple<size_t, typename MatType::elem_type> poolResult =
-              pooling.PoolingWithIndex(input.slice(s).submat(
-                  rowidx,
-                  colidx,
-                  rowEnd,
-                  colEnd));
-
-          // Now map the returned pooling index, which corresponds to the
-          // submatrix we gave, back to its position in the (linearized) input.
-          const size_t poolIndex = std::get<0>(poolResult);
-          const size_t poolingCol = poolIndex / (kernelWidth);
-          const size_t poolingRow = poolIndex % (kernelWidth);
-          const size_t unmappedPoolingIndex = (rowidx + poolingRow) +
-              input.n_rows * (colidx + poolingCol);
-
-          poolingIndices(i, j, s) = unmappedPoolingIndex;
-          output(i, j, s) = std::get<1>(poolResult);
-        }
-      }
-    }
-  }
+  template<typename IndexType>
+  void PoolingOperation(const CubeType& input,
+                        CubeType& output,
+                        arma::Cube<IndexType>* offsets);
 
   /**
-   * Apply pooling to all slices of the input and store the results, but not the
-   * indices used.
-   *
-   * @param input The input to apply the pooling rule to.
-   * @param output The pooled result.
+   * Apply pooling like PoolingOperation(), with a kernel of `KW` x `KH`
+   * elements; if `KW` and `KH` are 0, the kernel size of the layer is used.
+   * The windows that fit in the input are handled one output column at a
+   * time, with one vectorizable loop over the output rows for each element of
+   * the kernel.
    */
-  void PoolingOperation(
-      const arma::Cube<typename MatType::elem_type>& input,
-      arma::Cube<typename MatType::elem_type>& output)
-  {
-    // Iterate over all slices individually.
-    #pragma omp parallel for
-    for (size_t s = 0; s < (size_t) input.n_slices; ++s)
-    {
-      for (size_t j = 0, colidx = 0; j < output.n_cols;
-          ++j, colidx += strideHeight)
-      {
-        size_t colEnd = colidx + kernelHeight - 1;
-        // Check if the kernel along column is out of bounds.
-        if (colEnd > input.n_cols - 1)
-        {
-          // If so, we need to reduce the kernel height or terminate.
-          if (floor)
-            continue;
-          colEnd = input.n_cols - 1;
-        }
-        for (size_t i = 0, rowidx = 0; i < output.n_rows;
-            ++i, rowidx += strideWidth)
-        {
-          size_t rowEnd = rowidx + kernelWidth - 1;
-          // Check if the kernel along row is out of bounds.
-          if (rowEnd > input.n_rows - 1)
-          {
-            // If so, we need to reduce the kernel width or terminate.
-            if (floor)
-              continue;
-            rowEnd = input.n_rows - 1;
-          }
-
-          output(i, j, s) = pooling.Pooling(input.slice(s).submat(
-              rowidx,
-              colidx,
-              rowEnd,
-              colEnd));
-        }
-      }
-    }
-  }
+  template<size_t KW, size_t KH, typename IndexType>
+  void PoolSlices(const CubeType& input,
+                  CubeType& output,
+                  arma::Cube<IndexType>* offsets);
 
   /**
-   * Apply unpooling to all slices of the input and store the results.
+   * Apply unpooling to all slices of the error and store the results: each
+   * element of the error is added to the position of the maximum of its
+   * window.
    *
    * @param error The backward error.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices (from `PoolingOperation()`).
+   * @param output The unpooled result (it must be zero-initialized).
+   * @param offsets The offsets of the maxima (from `PoolingOperation()`).
    */
-  void UnpoolingOperation(
-      const MatType& error,
-      MatType& output,
-      const arma::Mat<size_t>& poolingIndices)
-  {
-    for (size_t i = 0; i < poolingIndices.n_elem; ++i)
-    {
-      output(poolingIndices(i)) += error(i);
-    }
-  }
+  template<typename IndexType>
+  void UnpoolingOperation(const CubeType& error,
+                          CubeType& output,
+                          const arma::Cube<IndexType>& offsets);
+
+  //! Return whether the offsets of the maxima are stored in
+  //! `poolingOffsets` (one byte each), rather than `widePoolingOffsets`.
+  bool CompactOffsets() const { return kernelWidth * kernelHeight <= 256; }
 
   //! Locally-stored width of the pooling window.
   size_t kernelWidth;
@@ -303,8 +220,13 @@ class MaxPoolingType : public Layer<MatType>
   //! Locally-stored pooling strategy.
   MaxPoolingRule pooling;
 
-  //! Locally-stored pooling indices.
-  arma::Cube<size_t> poolingIndices;
+  //! Locally-stored offsets of the maxima in their windows, if the windows
+  //! have at most 256 elements.
+  arma::Cube<uint8_t> poolingOffsets;
+
+  //! Locally-stored offsets of the maxima in their windows, for larger
+  //! windows.
+  arma::Cube<size_t> widePoolingOffsets;
 }; // class MaxPoolingType
 
 // Standard MaxPooling layer.
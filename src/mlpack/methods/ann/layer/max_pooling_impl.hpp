@@ -114,26 +114,33 @@ MaxPoolingType<MatType>::operator=(MaxPoolingType&& other)
 template<typename MatType>
 void MaxPoolingType<MatType>::Forward(const MatType& input, MatType& output)
 {
-  arma::Cube<typename MatType::elem_type> inputTemp(
-      const_cast<MatType&>(input).memptr(), this->inputDimensions[0],
-      this->inputDimensions[1], input.n_cols * channels, false, false);
+  CubeType inputTemp(const_cast<MatType&>(input).memptr(),
+      this->inputDimensions[0], this->inputDimensions[1],
+      input.n_cols * channels, false, false);
 
-  arma::Cube<typename MatType::elem_type> outputTemp(output.memptr(),
-      this->outputDimensions[0], this->outputDimensions[1],
-      input.n_cols * channels, false, true);
+  CubeType outputTemp(output.memptr(), this->outputDimensions[0],
+      this->outputDimensions[1], input.n_cols * channels, false, true);
 
   if (this->training)
   {
     // If we are training, we'll do a backwards pass, so we need to ensure that
-    // we know what indices we used.
-    poolingIndices.set_size(this->outputDimensions[0],
-        this->outputDimensions[1], input.n_cols * channels);
-
-    PoolingOperation(inputTemp, outputTemp, poolingIndices);
+    // we know where the maxima were.
+    if (CompactOffsets())
+    {
+      poolingOffsets.set_size(this->outputDimensions[0],
+          this->outputDimensions[1], input.n_cols * channels);
+      PoolingOperation(inputTemp, outputTemp, &poolingOffsets);
+    }
+    else
+    {
+      widePoolingOffsets.set_size(this->outputDimensions[0],
+          this->outputDimensions[1], input.n_cols * channels);
+      PoolingOperation(inputTemp, outputTemp, &widePoolingOffsets);
+    }
   }
   else
   {
-    PoolingOperation(inputTemp, outputTemp);
+    PoolingOperation<uint8_t>(inputTemp, outputTemp, NULL);
   }
 }
 
@@ -144,24 +151,20 @@ void MaxPoolingType<MatType>::Backward(
     const MatType& gy,
     MatType& g)
 {
-  arma::Cube<typename MatType::elem_type> mappedError =
-      arma::Cube<typename MatType::elem_type>(((MatType&) gy).memptr(),
-      this->outputDimensions[0], this->outputDimensions[1],
-      channels * input.n_cols, false, false);
+  CubeType mappedError(((MatType&) gy).memptr(), this->outputDimensions[0],
+      this->outputDimensions[1], channels * input.n_cols, false, false);
 
-  arma::Cube<typename MatType::elem_type> gTemp(g.memptr(),
-      this->inputDimensions[0], this->inputDimensions[1],
-      channels * input.n_cols, false, true);
+  CubeType gTemp(g.memptr(), this->inputDimensions[0],
+      this->inputDimensions[1], channels * input.n_cols, false, true);
 
   gTemp.zeros();
 
-  // There's no version of UnpoolingOperation without pooling indices, because
+  // There's no version of UnpoolingOperation without pooling offsets, because
   // if we call `Backward()`, we know for sure we are training.
-  #pragma omp parallel for
-  for (size_t s = 0; s < (size_t) mappedError.n_slices; s++)
-  {
-    UnpoolingOperation(mappedError.slice(s), gTemp.slice(s), poolingIndices.slice(s));
-  }
+  if (CompactOffsets())
+    UnpoolingOperation(mappedError, gTemp, poolingOffsets);
+  else
+    UnpoolingOperation(mappedError, gTemp, widePoolingOffsets);
 }
 
 template<typename MatType>
@@ -211,8 +214,149 @@ void MaxPoolingType<MatType>::serialize(
 
   if (Archive::is_loading::value)
   {
-    // Clear any memory used by `poolingIndices`.
-    poolingIndices.clear();
+    // Clear any memory used by the pooling offsets.
+    poolingOffsets.clear();
+    widePoolingOffsets.clear();
+  }
+}
+
+template<typename MatType>
+template<typename IndexType>
+void MaxPoolingType<MatType>::PoolingOperation(
+    const CubeType& input,
+    CubeType& output,
+    arma::Cube<IndexType>* offsets)
+{
+  // The most common kernel sizes get their own unrolled loops.
+  if (kernelWidth == 2 && kernelHeight == 2)
+    PoolSlices<2, 2>(input, output, offsets);
+  else if (kernelWidth == 3 && kernelHeight == 3)
+    PoolSlices<3, 3>(input, output, offsets);
+  else
+    PoolSlices<0, 0>(input, output, offsets);
+}
+
+template<typename MatType>
+template<size_t KW, size_t KH, typename IndexType>
+void MaxPoolingType<MatType>::PoolSlices(
+    const CubeType& input,
+    CubeType& output,
+    arma::Cube<IndexType>* offsets)
+{
+  typedef typename MatType::elem_type eT;
+  const size_t kw = (KW == 0) ? kernelWidth : KW;
+  const size_t kh = (KH == 0) ? kernelHeight : KH;
+
+  // The number of output rows and columns whose windows fit in the input; the
+  // others (if `floor` is false) are cut by the border of the input.
+  const size_t fullRows = (input.n_rows < kw) ? 0 :
+      std::min((size_t) output.n_rows, (input.n_rows - kw) / strideWidth + 1);
+  const size_t fullCols = (input.n_cols < kh) ? 0 :
+      std::min((size_t) output.n_cols, (input.n_cols - kh) / strideHeight + 1);
+
+  // Iterate over all slices individually.
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t s = 0; s < (size_t) input.n_slices; ++s)
+  {
+    for (size_t j = 0; j < output.n_cols; ++j)
+    {
+      const size_t colStart = j * strideHeight;
+      eT* outputPtr = output.slice_colptr(s, j);
+      IndexType* offsetPtr = (offsets == NULL) ? NULL :
+          offsets->slice_colptr(s, j);
+
+      size_t firstCutRow = 0;
+      if (j < fullCols)
+      {
+        // Start with the first element of each window, then compare with each
+        // other element of the kernel in turn.  Taking only strictly greater
+        // values keeps the first maximum in column-major order.
+        const eT* inputPtr = input.slice_colptr(s, colStart);
+        for (size_t i = 0; i < fullRows; ++i)
+          outputPtr[i] = inputPtr[i * strideWidth];
+        if (offsetPtr != NULL)
+          std::fill(offsetPtr, offsetPtr + fullRows, IndexType(0));
+
+        for (size_t kj = 0; kj < kh; ++kj)
+        {
+          for (size_t ki = (kj == 0) ? 1 : 0; ki < kw; ++ki)
+          {
+            const eT* elemPtr = inputPtr + kj * input.n_rows + ki;
+            if (offsetPtr != NULL)
+            {
+              const IndexType offset = IndexType(ki + kj * kernelWidth);
+              for (size_t i = 0; i < fullRows; ++i)
+              {
+                const eT value = elemPtr[i * strideWidth];
+                const bool greater = (value > outputPtr[i]);
+                outputPtr[i] = greater ? value : outputPtr[i];
+                offsetPtr[i] = greater ? offset : offsetPtr[i];
+              }
+            }
+            else
+            {
+              for (size_t i = 0; i < fullRows; ++i)
+              {
+                const eT value = elemPtr[i * strideWidth];
+                outputPtr[i] = (value > outputPtr[i]) ? value : outputPtr[i];
+              }
+            }
+          }
+        }
+
+        firstCutRow = fullRows;
+      }
+
+      // Handle the windows that are cut by the border of the input.
+      const size_t colEnd = std::min(colStart + kh, (size_t) input.n_cols);
+      for (size_t i = firstCutRow; i < output.n_rows; ++i)
+      {
+        const size_t rowStart = i * strideWidth;
+        const size_t rowEnd = std::min(rowStart + kw, (size_t) input.n_rows);
+        eT maxValue = input(rowStart, colStart, s);
+        size_t maxOffset = 0;
+        for (size_t c = colStart; c < colEnd; ++c)
+        {
+          for (size_t r = rowStart; r < rowEnd; ++r)
+          {
+            if (input(r, c, s) > maxValue)
+            {
+              maxValue = input(r, c, s);
+              maxOffset = (r - rowStart) + (c - colStart) * kernelWidth;
+            }
+          }
+        }
+
+        outputPtr[i] = maxValue;
+        if (offsetPtr != NULL)
+          offsetPtr[i] = IndexType(maxOffset);
+      }
+    }
+  }
+}
+
+template<typename MatType>
+template<typename IndexType>
+void MaxPoolingType<MatType>::UnpoolingOperation(
+    const CubeType& error,
+    CubeType& output,
+    const arma::Cube<IndexType>& offsets)
+{
+  // Each slice is only written by its own windows.
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t s = 0; s < (size_t) error.n_slices; ++s)
+  {
+    for (size_t j = 0; j < error.n_cols; ++j)
+    {
+      const typename MatType::elem_type* errorPtr = error.slice_colptr(s, j);
+      const IndexType* offsetPtr = offsets.slice_colptr(s, j);
+      for (size_t i = 0; i < error.n_rows; ++i)
+      {
+        const size_t offset = offsetPtr[i];
+        output(i * strideWidth + offset % kernelWidth,
+            j * strideHeight + offset / kernelWidth, s) += errorPtr[i];
+      }
+    }
   }
 }
 
@@ -132,6 +132,18 @@ class MeanPoolingType : public Layer<MatType>
       const arma::Cube<typename MatType::elem_type>& input,
       arma::Cube<typename MatType::elem_type>& output);
 
+  /**
+   * Apply pooling like PoolingOperation(), with a kernel of `KW` x `KH`
+   * elements; if `KW` and `KH` are 0, the kernel size of the layer is used.
+   * The windows that fit in the input are handled one output column at a
+   * time, with one vectorizable loop over the output rows for each element of
+   * the kernel.
+   */
+  template<size_t KW, size_t KH>
+  void PoolSlices(
+      const arma::Cube<typename MatType::elem_type>& input,
+      arma::Cube<typename MatType::elem_type>& output);
+
   /**
    * Apply unpooling to the input and store the results.
    *
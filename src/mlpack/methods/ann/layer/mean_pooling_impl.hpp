@@ -204,39 +204,76 @@ void MeanPoolingType<MatType>::PoolingOperation(
     const arma::Cube<typename MatType::elem_type>& input,
     arma::Cube<typename MatType::elem_type>& output)
 {
+  // The most common kernel sizes get their own unrolled loops.
+  if (kernelWidth == 2 && kernelHeight == 2)
+    PoolSlices<2, 2>(input, output);
+  else if (kernelWidth == 3 && kernelHeight == 3)
+    PoolSlices<3, 3>(input, output);
+  else
+    PoolSlices<0, 0>(input, output);
+}
+
+template<typename MatType>
+template<size_t KW, size_t KH>
+void MeanPoolingType<MatType>::PoolSlices(
+    const arma::Cube<typename MatType::elem_type>& input,
+    arma::Cube<typename MatType::elem_type>& output)
+{
+  typedef typename MatType::elem_type eT;
+  const size_t kw = (KW == 0) ? kernelWidth : KW;
+  const size_t kh = (KH == 0) ? kernelHeight : KH;
+  const eT scale = eT(1) / eT(kw * kh);
+
+  // The number of output rows and columns whose windows fit in the input; the
+  // others (if `floor` is false) are cut by the border of the input, and are
+  // the mean of the part of the window inside the input.
+  const size_t fullRows = (input.n_rows < kw) ? 0 :
+      std::min((size_t) output.n_rows, (input.n_rows - kw) / strideWidth + 1);
+  const size_t fullCols = (input.n_cols < kh) ? 0 :
+      std::min((size_t) output.n_cols, (input.n_cols - kh) / strideHeight + 1);
+
   // Iterate over all slices individually.
   #pragma omp parallel for
   for (size_t s = 0; s < (size_t) input.n_slices; ++s)
   {
-    for (size_t j = 0, colidx = 0; j < output.n_cols;
-        ++j, colidx += strideHeight)
+    for (size_t j = 0; j < output.n_cols; ++j)
     {
-      size_t colEnd = colidx + kernelHeight - 1;
-      // Check if the kernel along column is out of bounds.
-      if (colEnd > input.n_cols - 1)
-      {
-        // If so, we need to reduce the kernel height or terminate.
-        if (floor)
-          continue;
-        colEnd = input.n_cols - 1;
-      }
-      for (size_t i = 0, rowidx = 0; i < output.n_rows;
-          ++i, rowidx += strideWidth)
+      const size_t colStart = j * strideHeight;
+      eT* outputPtr = output.slice_colptr(s, j);
+
+      size_t firstCutRow = 0;
+      if (j < fullCols)
       {
-        size_t rowEnd = rowidx + kernelWidth - 1;
-        // Check if the kernel along row is out of bounds.
-        if (rowEnd > input.n_rows - 1)
+        const eT* inputPtr = input.slice_colptr(s, colStart);
+        std::fill(outputPtr, outputPtr + fullRows, eT(0));
+        for (size_t kj = 0; kj < kh; ++kj)
         {
-          // If so, we need to reduce the kernel width or terminate.
-          if (floor)
-            continue;
-          rowEnd = input.n_rows - 1;
+          for (size_t ki = 0; ki < kw; ++ki)
+          {
+            const eT* elemPtr = inputPtr + kj * input.n_rows + ki;
+            for (size_t i = 0; i < fullRows; ++i)
+              outputPtr[i] += elemPtr[i * strideWidth];
+          }
         }
-        output(i, j, s) = Pooling(input.slice(s).submat(
-            rowidx,
-            colidx,
-            rowEnd,
-            colEnd));
+
+        for (size_t i = 0; i < fullRows; ++i)
+          outputPtr[i] *= scale;
+
+        firstCutRow = fullRows;
+      }
+
+      // Handle the windows that are cut by the border of the input.
+      const size_t colEnd = std::min(colStart + kh, (size_t) input.n_cols);
+      for (size_t i = firstCutRow; i < output.n_rows; ++i)
+      {
+        const size_t rowStart = i * strideWidth;
+        const size_t rowEnd = std::min(rowStart + kw, (size_t) input.n_rows);
+        eT sum = 0;
+        for (size_t c = colStart; c < colEnd; ++c)
+          for (size_t r = rowStart; r < rowEnd; ++r)
+            sum += input(r, c, s);
+
+        outputPtr[i] = sum / eT((rowEnd - rowStart) * (colEnd - colStart));
       }
     }
   }
@@ -293,7 +330,8 @@ void MeanPoolingType<MatType>::Unpooling(
     // method will require `kernalArea * k` operations.
     // The prefix method will require `4 * k + Prefix operation`.
 
-    for (size_t j = 0, colidx = 0; j < output.n_cols; j += strideHeight, ++colidx)
+    for (size_t j = 0, colidx = 0; j < output.n_cols && colidx < error.n_cols;
+        j += strideHeight, ++colidx)
     {
       size_t colEnd = j + kernelHeight - 1;
       // Check if the kernel along column is out of bounds.
@@ -304,7 +342,8 @@ void MeanPoolingType<MatType>::Unpooling(
           continue;
         colEnd = output.n_cols - 1;
       }
-      for (size_t i = 0, rowidx = 0; i < output.n_rows; i += strideWidth, ++rowidx)
+      for (size_t i = 0, rowidx = 0; i < output.n_rows &&
+          rowidx < error.n_rows; i += strideWidth, ++rowidx)
       {
         // We have to add error(i, j) to output(span(rowidx, rowEnd),
         // span(colidx, colEnd)).
@@ -353,8 +392,12 @@ void MeanPoolingType<MatType>::Unpooling(
   }
   else
   {
-    arma::Mat<typename MatType::elem_type> unpooledError;
-    for (size_t j = 0, colidx = 0; j < output.n_cols; j += strideHeight, ++colidx)
+    // Add the error of each window, divided by the size of the part of the
+    // window inside the input, to every element of the window.  The iteration
+    // is the same as in the prefix sum method above.
+    typedef typename MatType::elem_type eT;
+    for (size_t j = 0, colidx = 0; j < output.n_cols && colidx < error.n_cols;
+        j += strideHeight, ++colidx)
     {
       size_t colEnd = j + kernelHeight - 1;
       // Check if the kernel along column is out of bounds.
@@ -365,7 +408,8 @@ void MeanPoolingType<MatType>::Unpooling(
           continue;
         colEnd = output.n_cols - 1;
       }
-      for (size_t i = 0, rowidx = 0; i < output.n_rows; i += strideWidth, ++rowidx)
+      for (size_t i = 0, rowidx = 0; i < output.n_rows &&
+          rowidx < error.n_rows; i += strideWidth, ++rowidx)
       {
         size_t rowEnd = i + kernelWidth - 1;
         // Check if the kernel along row is out of bounds.
@@ -377,13 +421,14 @@ void MeanPoolingType<MatType>::Unpooling(
           rowEnd = output.n_rows - 1;
         }
 
-        MatType OutputArea = output(arma::span(i, rowEnd), arma::span(j, colEnd));
-
-        unpooledError = arma::Mat<typename MatType::elem_type>(OutputArea.n_rows, OutputArea.n_cols);
-        unpooledError.fill(error(rowidx, colidx) / OutputArea.n_elem);
-
-        output(arma::span(i, i + OutputArea.n_rows - 1),
-            arma::span(j, j + OutputArea.n_cols - 1)) += unpooledError;
+        const eT value = error(rowidx, colidx) /
+            eT((rowEnd - i + 1) * (colEnd - j + 1));
+        for (size_t c = j; c <= colEnd; ++c)
+        {
+          eT* outputPtr = output.colptr(c);
+          for (size_t r = i; r <= rowEnd; ++r)
+            outputPtr[r] += value;
+        }
       }
     }
   }
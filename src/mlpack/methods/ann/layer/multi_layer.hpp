@@ -12,6 +12,7 @@
 #ifndef MLPACK_METHODS_ANN_LAYER_MULTI_LAYER_HPP
 #define MLPACK_METHODS_ANN_LAYER_MULTI_LAYER_HPP
 
+#include "../layer_profiler.hpp"
 #include "../make_alias.hpp"
 #include "layer.hpp"
 
@@ -51,6 +52,7 @@ class MultiLayer : public Layer<MatType>
   //! Virtual destructor: delete all held layers.
   virtual ~MultiLayer()
   {
+    ResetInferenceNetwork();
     for (size_t i = 0; i < network.size(); ++i)
       delete network[i];
   }
@@ -126,6 +128,21 @@ class MultiLayer : public Layer<MatType>
                         const MatType& error,
                         MatType& gradient);
 
+  /**
+   * Compute the gradients of the layers as a sparse column vector with
+   * `WeightSize()` rows, under the same conditions as `Gradient()`.  Each layer
+   * computes its part with its own `SparseGradient()`, so layers with sparse
+   * gradients (like `Lookup`) never touch most of their weights.
+   *
+   * @param input Original input data provided to Forward().
+   * @param error Error as computed by `Backward()`.
+   * @param gradient Sparse vector to store the gradients in.
+   */
+  virtual void SparseGradient(
+      const MatType& input,
+      const MatType& error,
+      arma::SpMat<typename MatType::elem_type>& gradient);
+
   /**
    * Set the weights of the layer to use the memory given as `weightsPtr`.
    */
@@ -167,6 +184,7 @@ class MultiLayer : public Layer<MatType>
   template <typename LayerType, typename... Args>
   void Add(Args... args)
   {
+    ResetInferenceNetwork();
     network.push_back(new LayerType(args...));
     layerOutputs.push_back(MatType());
     layerDeltas.push_back(MatType());
@@ -180,6 +198,7 @@ class MultiLayer : public Layer<MatType>
    */
   void Add(Layer<MatType>* layer)
   {
+    ResetInferenceNetwork();
     network.push_back(layer);
     layerOutputs.push_back(MatType());
     layerDeltas.push_back(MatType());
@@ -195,29 +214,174 @@ class MultiLayer : public Layer<MatType>
   //! careful!
   std::vector<Layer<MatType>*>& Network() { return network; }
 
+  //! Get whether Forward() keeps the output of every layer for Backward() and
+  //! Gradient().
+  bool KeepOutputs() const { return keepOutputs; }
+  //! Modify whether Forward() keeps the output of every layer (true by
+  //! default).  If false, the memory of each output is reused as soon as the
+  //! next layer has been computed, so that much less memory is needed; but
+  //! then, Backward() and Gradient() must not be called after Forward().  This
+  //! is meant for inference.
+  bool& KeepOutputs() { return keepOutputs; }
+
+  //! Get whether passes through the whole network that do not keep the outputs
+  //! are inference passes.
+  bool Inference() const { return inference; }
+  /**
+   * Modify whether passes through the whole network are inference passes when
+   * `KeepOutputs()` is false and the MultiLayer is not in training mode (false
+   * by default).  An inference pass skips the layers that do nothing when
+   * testing (e.g. dropout), folds layers that only scale and shift their
+   * input (e.g. batch normalization) into the layer before them (e.g. a linear
+   * or convolution layer), and fuses activation layers (e.g. `ReLU`) into the
+   * layer before them, which then applies the activation to its output as it
+   * computes it.  So `Convolution` -> `BatchNorm` -> `ReLU` -> `Dropout` is
+   * computed as one layer, and fewer layers and outputs need to be computed.
+   *
+   * The folded layers are copies with their own parameters (or, when only an
+   * activation is fused, with the parameters of the network); they are
+   * computed at the first inference pass, and kept until the parameters or the
+   * structure of the network change through the MultiLayer (e.g. with
+   * `SetWeights()` or `Add()`), or until a forward pass in training mode is
+   * done.  If the parameters of the layers are modified directly, call
+   * `ResetInferenceNetwork()` before the next inference pass.
+   */
+  bool& Inference() { return inference; }
+
+  /**
+   * Discard the layers computed by inference passes, so that they are built
+   * again from the current layers and parameters at the next inference pass.
+   */
+  void ResetInferenceNetwork();
+
+  //! Get the indices of the layers whose outputs are kept by training passes
+  //! when checkpointing.
+  const std::vector<size_t>& Checkpoints() const { return checkpoints; }
+  /**
+   * Modify the indices of the layers whose outputs are kept by training passes
+   * (empty by default).  If this is not empty, the forward pass of a training
+   * pass through the whole network (with `KeepOutputs()` true) only keeps the
+   * outputs of the given layers, which split the network into segments; the
+   * outputs of the other layers share memory with those of the same layers in
+   * the other segments.  `Backward()` then goes through the segments from the
+   * last one, computing the outputs inside each segment again, and computes
+   * the gradient of each layer of the segment at the same time (`Gradient()`
+   * only copies it).
+   *
+   * This trades one more forward pass through most layers for memory: with a
+   * checkpoint every `k` layers, only `1/k` of the outputs of the layers are
+   * kept, plus the outputs of one segment.  The layers inside a segment are
+   * computed twice, so layers whose training-mode forward pass is random
+   * (e.g. `Dropout`) or updates statistics (e.g. `BatchNorm`) should be
+   * checkpoints themselves: the last layer of each segment is not computed
+   * again.
+   */
+  std::vector<size_t>& Checkpoints() { return checkpoints; }
+
+  //! Get the profiler that records the passes of each layer (NULL if none).
+  LayerProfiler* Profiler() const { return profiler; }
+  /**
+   * Modify the profiler that records the passes of each layer (NULL by
+   * default, for no profiling).  The profiler is not owned by the MultiLayer,
+   * and is not copied by copies of the MultiLayer.  Layers held by layers of
+   * the network (e.g. by a `Concat` layer) are not recorded separately.
+   */
+  LayerProfiler*& Profiler() { return profiler; }
+
+  //! Get an estimate of the number of floating-point operations of a forward
+  //! pass for each point: the sum of those of the layers.
+  size_t ForwardFlops();
+
   //! Serialize the MultiLayer.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
 
  protected:
   /**
-   * Initialize memory that will be used by each layer for the forward pass,
-   * assuming that the input will have the given `batchSize`.  When `Forward()`
-   * is called, each internally-held layer will output its results into the
-   * memory allocated by this function (this is the internal member
-   * `layerOutputMatrix` and its aliases `layerOutputs`).
+   * Initialize memory that will be used by each layer for the forward pass of
+   * layers `start` to `end`, assuming that the input will have the given
+   * `batchSize`.  When `Forward()` is called, each internally-held layer will
+   * output its results into the memory planned by this function (this is the
+   * internal member `layerMemory` and its aliases `layerOutputs`).
+   *
+   * The plan depends on how long the outputs are needed: if `KeepOutputs()` is
+   * true, each output gets its own part of `layerMemory`, and so does each
+   * delta of the backward pass; otherwise, the outputs alternate between two
+   * parts of `layerMemory`.  `layerMemory` is kept between calls, and only
+   * reallocated when it is too small or much too large.
+   */
+  void InitializeForwardPassMemory(const size_t batchSize,
+                                   const size_t start,
+                                   const size_t end);
+
+  /**
+   * Set the aliases `layerOutputs` so that the outputs of the given layers
+   * `start` to `end - 1` alternate between two parts of `layerMemory`, for the
+   * given `batchSize`.  The output of layer `end` is not stored.
    */
-  void InitializeForwardPassMemory(const size_t batchSize);
+  void InitializeAlternatingMemory(const std::vector<Layer<MatType>*>& layers,
+                                   const size_t batchSize,
+                                   const size_t start,
+                                   const size_t end);
+
+  /**
+   * Build the layers that are computed by an inference pass (see
+   * `Inference()`) into `inferenceNetwork`.
+   */
+  void InitializeInferenceNetwork();
 
   /**
    * Initialize memory that will be used by each layer for the backwards pass,
    * assuming that the input will have the given `batchSize`.  When `Backward()`
    * is called, each internally-held layer will output the results of its
-   * backwards pass into the memory allocated by this function (this is the
-   * internal member `layerDeltaMatrix` and its aliases `layerDeltas`).
+   * backwards pass into the memory planned by this function (this is the
+   * internal member `layerMemory` and its aliases `layerDeltas`).  Normally,
+   * `InitializeForwardPassMemory()` has already planned this memory.
    */
   void InitializeBackwardPassMemory(const size_t batchSize);
 
+  /**
+   * Plan `layerMemory` so that the outputs of all layers and the deltas of the
+   * backward pass can all be held at once, for the given `batchSize`, and set
+   * the aliases `layerOutputs`.
+   */
+  void InitializeTrainingMemory(const size_t batchSize);
+
+  /**
+   * Plan `layerMemory` for a checkpointed training pass (see `Checkpoints()`)
+   * with the given `batchSize`: find the segments of the network, give the
+   * output of each checkpoint its own part of the memory, and let the outputs
+   * inside the segments share another part.  Space for two deltas is kept
+   * after that, so that `Backward()` can alternate between them.
+   */
+  void InitializeCheckpointMemory(const size_t batchSize);
+
+  /**
+   * Perform the backward pass of a checkpointed training pass, computing the
+   * outputs inside each segment again and the gradients of the layers into
+   * `checkpointGradient`.  Arguments are the same as for `Backward()`.
+   */
+  void CheckpointedBackward(const MatType& input,
+                            const MatType& output,
+                            const MatType& gy,
+                            MatType& g);
+
+  /**
+   * Initialize memory for the forward and backward passes of layers that all
+   * take the same input, instead of passing the input through the layers
+   * sequentially (e.g. Concat).  The output and the delta of every layer are
+   * then needed at once, so each of them gets its own part of `layerMemory`;
+   * this sets both `layerOutputs` and `layerDeltas`.  Nothing is done if the
+   * memory is already planned for the given `batchSize`.
+   */
+  void InitializeParallelPassMemory(const size_t batchSize);
+
+  /**
+   * Make sure `layerMemory` holds `elements` elements.  It is only reallocated
+   * if it is too small, or if we only need 10% or less of it.
+   */
+  void ResizeLayerMemory(const size_t elements);
+
   /**
    * Initialize memory for the gradient pass.  This sets the internal aliases
    * `layerGradients` appropriately using the memory from the given `gradient`,
@@ -226,6 +390,28 @@ class MultiLayer : public Layer<MatType>
    */
   void InitializeGradientPassMemory(MatType& gradient);
 
+  //! Call `Forward()` of the given layer, which has the given index, and
+  //! record it if there is a profiler.
+  void LayerForward(Layer<MatType>* layer,
+                    const size_t index,
+                    const MatType& input,
+                    MatType& output);
+
+  //! Call `Backward()` of the layer with the given index, and record it if
+  //! there is a profiler.
+  void LayerBackward(const size_t index,
+                     const MatType& input,
+                     const MatType& output,
+                     const MatType& gy,
+                     MatType& g);
+
+  //! Call `Gradient()` of the layer with the given index, and record it if
+  //! there is a profiler.
+  void LayerGradient(const size_t index,
+                     const MatType& input,
+                     const MatType& error,
+                     MatType& gradient);
+
   //! The internally-held network.
   std::vector<Layer<MatType>*> network;
 
@@ -236,18 +422,53 @@ class MultiLayer : public Layer<MatType>
   // Total number of output elements for *every* layer.
   size_t totalOutputSize;
 
-  //! This matrix stores all of the outputs of each layer when Forward() is
-  //! called.  See `InitializeForwardPassMemory()`.
-  MatType layerOutputMatrix;
-  //! These are aliases of `layerOutputMatrix` for each layer.
-  std::vector<MatType> layerOutputs;
+  //! Whether Forward() keeps the output of every layer.
+  bool keepOutputs;
+  //! Whether passes through the whole network may be inference passes.
+  bool inference;
+  //! The layers whose outputs are kept when checkpointing.
+  std::vector<size_t> checkpoints;
+  //! Whether the last forward pass was a checkpointed training pass.
+  bool checkpointedPass;
+  //! The profiler that records the passes of each layer (NULL if none).
+  LayerProfiler* profiler;
 
-  //! This matrix stores all of the backwards pass results of each layer when
-  //! Backward() is called.  See `InitializeBackwardPassMemory()`.
-  MatType layerDeltaMatrix;
-  //! These are aliases of `layerDeltaMatrix` for each layer.
+  //! If true, `inferenceNetwork` holds the layers of an inference pass.
+  bool inferenceNetworkIsSet;
+  //! The layers computed by an inference pass, in order; these are either
+  //! layers of `network` or layers of `foldedLayers`.
+  std::vector<Layer<MatType>*> inferenceNetwork;
+  //! Copies of layers of `network`, with the layers after them folded or fused
+  //! in.
+  std::vector<Layer<MatType>*> foldedLayers;
+  //! The parameters of each layer in `foldedLayers`.
+  std::vector<MatType> foldedWeights;
+  //! The memory given to the last call of `SetWeights()` (NULL if none).
+  typename MatType::elem_type* weightsPtr;
+
+  //! This matrix stores the outputs of each layer when Forward() is called,
+  //! and the backwards pass results of each layer when Backward() is called.
+  //! See `InitializeForwardPassMemory()`.
+  MatType layerMemory;
+  //! The batch size for which `layerMemory` currently holds all outputs and
+  //! deltas (0 if it does not).
+  size_t trainingMemoryBatchSize;
+  //! These are aliases of `layerMemory` for the output of each layer (the
+  //! output of the last layer is never stored here).
+  std::vector<MatType> layerOutputs;
+  //! These are aliases of `layerMemory` for the delta of each layer (the delta
+  //! of the first layer is never stored here).
   std::vector<MatType> layerDeltas;
 
+  //! The index of the last layer of each segment of a checkpointed pass.
+  std::vector<size_t> segmentEnds;
+  //! The offset in `layerMemory` of the deltas of a checkpointed pass.
+  size_t checkpointDeltaOffset;
+  //! The size of each of the two deltas of a checkpointed pass.
+  size_t checkpointDeltaSize;
+  //! The gradient computed by the backward pass of a checkpointed pass.
+  MatType checkpointGradient;
+
   //! Gradient aliases for each layer.  Note that this is *only* valid in the
   //! context of `Gradient()`!  We have it as a class member to avoid
   //! reallocating the `MatType`s each call to `Gradient()`.
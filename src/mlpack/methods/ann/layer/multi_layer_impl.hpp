@@ -22,7 +22,14 @@ MultiLayer<MatType>::MultiLayer() :
     Layer<MatType>(),
     inSize(0),
     totalInputSize(0),
-    totalOutputSize(0)
+    totalOutputSize(0),
+    keepOutputs(true),
+    inference(false),
+    checkpointedPass(false),
+    profiler(NULL),
+    inferenceNetworkIsSet(false),
+    weightsPtr(NULL),
+    trainingMemoryBatchSize(0)
 {
   // Nothing to do.
 }
@@ -33,8 +40,14 @@ MultiLayer<MatType>::MultiLayer(const MultiLayer& other) :
     inSize(other.inSize),
     totalInputSize(other.totalInputSize),
     totalOutputSize(other.totalOutputSize),
-    layerOutputMatrix(other.layerOutputMatrix),
-    layerDeltaMatrix(other.layerDeltaMatrix)
+    keepOutputs(other.keepOutputs),
+    inference(other.inference),
+    checkpoints(other.checkpoints),
+    checkpointedPass(false),
+    profiler(NULL),
+    inferenceNetworkIsSet(false),
+    weightsPtr(NULL),
+    trainingMemoryBatchSize(0)
 {
   // Copy each layer.
   for (size_t i = 0; i < other.network.size(); ++i)
@@ -56,8 +69,15 @@ MultiLayer<MatType>::MultiLayer(MultiLayer&& other) :
     inSize(std::move(other.inSize)),
     totalInputSize(std::move(other.totalInputSize)),
     totalOutputSize(std::move(other.totalOutputSize)),
-    layerOutputMatrix(std::move(other.layerOutputMatrix)),
-    layerDeltaMatrix(std::move(other.layerDeltaMatrix))
+    keepOutputs(std::move(other.keepOutputs)),
+    inference(std::move(other.inference)),
+    checkpoints(std::move(other.checkpoints)),
+    checkpointedPass(false),
+    profiler(other.profiler),
+    inferenceNetworkIsSet(false),
+    weightsPtr(other.weightsPtr),
+    layerMemory(std::move(other.layerMemory)),
+    trainingMemoryBatchSize(0)
 {
   // Ensure that the aliases for layers during passes have the right size.
   layerOutputs.resize(network.size(), MatType());
@@ -70,6 +90,7 @@ MultiLayer<MatType>::MultiLayer(MultiLayer&& other) :
   other.layerOutputs.clear();
   other.layerDeltas.clear();
   other.layerGradients.clear();
+  other.ResetInferenceNetwork();
 }
 
 template<typename MatType>
@@ -79,6 +100,7 @@ MultiLayer<MatType>& MultiLayer<MatType>::operator=(const MultiLayer& other)
   {
     Layer<MatType>::operator=(other);
 
+    ResetInferenceNetwork();
     network.clear();
     layerOutputs.clear();
     layerDeltas.clear();
@@ -87,9 +109,16 @@ MultiLayer<MatType>& MultiLayer<MatType>::operator=(const MultiLayer& other)
     inSize = other.inSize;
     totalInputSize = other.totalInputSize;
     totalOutputSize = other.totalOutputSize;
+    keepOutputs = other.keepOutputs;
+    inference = other.inference;
+    checkpoints = other.checkpoints;
+    checkpointedPass = false;
+    weightsPtr = NULL;
 
-    layerOutputMatrix = other.layerOutputMatrix;
-    layerDeltaMatrix = other.layerDeltaMatrix;
+    // The memory for the passes is not copied; it will be planned the next
+    // time Forward() is called.
+    layerMemory.clear();
+    trainingMemoryBatchSize = 0;
 
     for (size_t i = 0; i < other.network.size(); ++i)
       network.push_back(other.network[i]->Clone());
@@ -110,6 +139,8 @@ MultiLayer<MatType>& MultiLayer<MatType>::operator=(MultiLayer&& other)
   {
     Layer<MatType>::operator=(other);
 
+    ResetInferenceNetwork();
+    other.ResetInferenceNetwork();
     layerOutputs.clear();
     layerDeltas.clear();
     layerGradients.clear();
@@ -117,6 +148,14 @@ MultiLayer<MatType>& MultiLayer<MatType>::operator=(MultiLayer&& other)
     inSize = std::move(other.inSize);
     totalInputSize = std::move(other.totalInputSize);
     totalOutputSize = std::move(other.totalOutputSize);
+    keepOutputs = std::move(other.keepOutputs);
+    inference = std::move(other.inference);
+    checkpoints = std::move(other.checkpoints);
+    checkpointedPass = false;
+    profiler = other.profiler;
+    weightsPtr = other.weightsPtr;
+    layerMemory = std::move(other.layerMemory);
+    trainingMemoryBatchSize = 0;
 
     network = std::move(other.network);
 
@@ -150,21 +189,63 @@ void MultiLayer<MatType>::Forward(
   for (size_t i = 0; i < network.size(); ++i)
     network[i]->Training() = this->training;
 
+  // Only training passes through the whole network can be checkpointed.
+  checkpointedPass = (this->training && keepOutputs && !checkpoints.empty() &&
+      start == 0 && end == network.size() - 1 && network.size() > 1);
+
+  if (this->training)
+  {
+    // The parameters are likely to change after a training pass.
+    ResetInferenceNetwork();
+  }
+  else if (inference && !keepOutputs && start == 0 &&
+      end == network.size() - 1)
+  {
+    if (!inferenceNetworkIsSet)
+      InitializeInferenceNetwork();
+
+    if (inferenceNetwork.size() > 1)
+    {
+      const size_t last = inferenceNetwork.size() - 1;
+      InitializeAlternatingMemory(inferenceNetwork, input.n_cols, 0, last);
+
+      LayerForward(inferenceNetwork[0], 0, input, layerOutputs[0]);
+      for (size_t i = 1; i < last; ++i)
+      {
+        LayerForward(inferenceNetwork[i], i, layerOutputs[i - 1],
+            layerOutputs[i]);
+      }
+      LayerForward(inferenceNetwork[last], last, layerOutputs[last - 1],
+          output);
+    }
+    else if (inferenceNetwork.size() == 1)
+    {
+      LayerForward(inferenceNetwork[0], 0, input, output);
+    }
+    else
+    {
+      // Every layer was skipped.
+      output = input;
+    }
+
+    return;
+  }
+
   // Note that we use `output` for the last layer; layerOutputs is only used for
   // intermediate values between layers.
   if ((end - start) > 0)
   {
     // Initialize memory for the forward pass (if needed).
-    InitializeForwardPassMemory(input.n_cols);
+    InitializeForwardPassMemory(input.n_cols, start, end);
 
-    network[start]->Forward(input, layerOutputs[start]);
+    LayerForward(network[start], start, input, layerOutputs[start]);
     for (size_t i = start + 1; i < end; ++i)
-      network[i]->Forward(layerOutputs[i - 1], layerOutputs[i]);
-    network[end]->Forward(layerOutputs[end - 1], output);
+      LayerForward(network[i], i, layerOutputs[i - 1], layerOutputs[i]);
+    LayerForward(network[end], end, layerOutputs[end - 1], output);
   }
   else if ((end - start) == 0 && network.size() > 0)
   {
-    network[start]->Forward(input, output);
+    LayerForward(network[start], start, input, output);
   }
   else
   {
@@ -180,21 +261,25 @@ void MultiLayer<MatType>::Backward(
     const MatType& gy,
     MatType& g)
 {
-  if (network.size() > 1)
+  if (checkpointedPass)
+  {
+    CheckpointedBackward(input, output, gy, g);
+  }
+  else if (network.size() > 1)
   {
     // Initialize memory for the backward pass (if needed).
     InitializeBackwardPassMemory(input.n_cols);
 
-    network.back()->Backward(layerOutputs[network.size() - 2], output, gy,
-        layerDeltas.back());
+    LayerBackward(network.size() - 1, layerOutputs[network.size() - 2], output,
+        gy, layerDeltas.back());
     for (size_t i = network.size() - 2; i > 0; --i)
-      network[i]->Backward(layerOutputs[i - 1], layerOutputs[i],
+      LayerBackward(i, layerOutputs[i - 1], layerOutputs[i],
           layerDeltas[i + 1], layerDeltas[i]);
-    network[0]->Backward(input, layerOutputs[0], layerDeltas[1], g);
+    LayerBackward(0, input, layerOutputs[0], layerDeltas[1], g);
   }
   else if (network.size() == 1)
   {
-    network[0]->Backward(input, output, gy, g);
+    LayerBackward(0, input, output, gy, g);
   }
   else
   {
@@ -210,23 +295,28 @@ void MultiLayer<MatType>::Gradient(
   // We assume gradient has the right size already.
 
   // Pass gradients through each layer.
-  if (network.size() > 1)
+  if (checkpointedPass)
+  {
+    // The gradients were computed by the backward pass.
+    gradient = checkpointGradient;
+  }
+  else if (network.size() > 1)
   {
     // Initialize memory for the gradient pass (if needed).
     InitializeGradientPassMemory(gradient);
 
-    network.front()->Gradient(input, layerDeltas[1], layerGradients.front());
+    LayerGradient(0, input, layerDeltas[1], layerGradients.front());
     for (size_t i = 1; i < network.size() - 1; ++i)
     {
-      network[i]->Gradient(layerOutputs[i - 1], layerDeltas[i + 1],
+      LayerGradient(i, layerOutputs[i - 1], layerDeltas[i + 1],
           layerGradients[i]);
     }
-    network.back()->Gradient(layerOutputs[network.size() - 2], error,
+    LayerGradient(network.size() - 1, layerOutputs[network.size() - 2], error,
         layerGradients.back());
   }
   else if (network.size() == 1)
   {
-    network[0]->Gradient(input, error, gradient);
+    LayerGradient(0, input, error, gradient);
   }
   else
   {
@@ -234,9 +324,67 @@ void MultiLayer<MatType>::Gradient(
   }
 }
 
+template<typename MatType>
+void MultiLayer<MatType>::SparseGradient(
+    const MatType& input,
+    const MatType& error,
+    arma::SpMat<typename MatType::elem_type>& gradient)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // A checkpointed backward pass has computed the dense gradient already.
+  if (checkpointedPass || network.size() == 0)
+  {
+    Layer<MatType>::SparseGradient(input, error, gradient);
+    return;
+  }
+  else if (network.size() == 1)
+  {
+    network[0]->SparseGradient(input, error, gradient);
+    return;
+  }
+
+  std::vector<arma::SpMat<ElemType>> sparseGradients(network.size());
+  network[0]->SparseGradient(input, layerDeltas[1], sparseGradients[0]);
+  for (size_t i = 1; i < network.size() - 1; ++i)
+  {
+    network[i]->SparseGradient(layerOutputs[i - 1], layerDeltas[i + 1],
+        sparseGradients[i]);
+  }
+  network.back()->SparseGradient(layerOutputs[network.size() - 2], error,
+      sparseGradients.back());
+
+  // Now collect the nonzero elements of each layer at the offset of its
+  // weights.
+  size_t nonZeros = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+    nonZeros += sparseGradients[i].n_nonzero;
+
+  arma::umat locations(2, nonZeros, arma::fill::zeros);
+  arma::Col<ElemType> values(nonZeros);
+  size_t offset = 0, k = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    typename arma::SpMat<ElemType>::const_iterator it =
+        sparseGradients[i].begin();
+    for ( ; it != sparseGradients[i].end(); ++it, ++k)
+    {
+      locations(0, k) = offset + it.row();
+      values[k] = (*it);
+    }
+
+    offset += network[i]->WeightSize();
+  }
+
+  gradient = arma::SpMat<ElemType>(locations, values, offset, 1);
+}
+
 template<typename MatType>
 void MultiLayer<MatType>::SetWeights(typename MatType::elem_type* weightsPtr)
 {
+  ResetInferenceNetwork();
+  this->weightsPtr = weightsPtr;
+
   size_t start = 0;
   const size_t totalWeightSize = WeightSize();
   for (size_t i = 0; i < network.size(); ++i)
@@ -265,6 +413,8 @@ void MultiLayer<MatType>::CustomInitialize(
     MatType& W,
     const size_t elements)
 {
+  ResetInferenceNetwork();
+
   size_t start = 0;
   const size_t totalWeightSize = elements;
   for (size_t i = 0; i < network.size(); ++i)
@@ -278,7 +428,7 @@ void MultiLayer<MatType>::CustomInitialize(
         "weight size!");
     
     MatType WTemp;
-    MakeAlias(WTemp, W.memptr() + start, weightSize, 1);
+    MakeAlias(WTemp, MemPtr(W) + start, weightSize, 1);
     network[i]->CustomInitialize(WTemp, weightSize);
     
     start += weightSize;
@@ -332,6 +482,11 @@ void MultiLayer<MatType>::ComputeOutputDimensions()
 
   totalOutputSize += lastLayerSize;
   this->outputDimensions = network.back()->OutputDimensions();
+
+  // The sizes of the outputs may have changed, so the memory for the passes
+  // must be planned again, and so must the inference network.
+  trainingMemoryBatchSize = 0;
+  ResetInferenceNetwork();
 }
 
 template<typename MatType>
@@ -358,8 +513,11 @@ void MultiLayer<MatType>::serialize(
 
   if (Archive::is_loading::value)
   {
-    layerOutputMatrix.clear();
-    layerDeltaMatrix.clear();
+    ResetInferenceNetwork();
+    layerMemory.clear();
+    trainingMemoryBatchSize = 0;
+    layerOutputs.clear();
+    layerDeltas.clear();
     layerGradients.clear();
     layerOutputs.resize(network.size(), MatType());
     layerDeltas.resize(network.size(), MatType());
@@ -368,61 +526,450 @@ void MultiLayer<MatType>::serialize(
 }
 
 template<typename MatType>
-void MultiLayer<MatType>::InitializeForwardPassMemory(const size_t batchSize)
+void MultiLayer<MatType>::InitializeForwardPassMemory(const size_t batchSize,
+                                                      const size_t start,
+                                                      const size_t end)
 {
   // We need to initialize memory to store the output of each layer's Forward()
-  // call.  We'll do this all in one matrix, but, the size of this matrix
-  // depends on the batch size we are using for computation.  We avoid resizing
-  // layerOutputMatrix down, unless we only need 10% or less of it.
-  if (batchSize * totalOutputSize > layerOutputMatrix.n_elem ||
-      batchSize * totalOutputSize <
-          std::floor(0.1 * layerOutputMatrix.n_elem))
+  // call, except for the last layer, which outputs into the caller's matrix.
+  // All outputs will be represented by one big block of memory, but how much
+  // of it we need depends on how long each output must be kept.
+  if (checkpointedPass)
+  {
+    // Only the outputs of the checkpoints are kept.
+    InitializeCheckpointMemory(batchSize);
+    return;
+  }
+  else if (keepOutputs)
   {
-    // All outputs will be represented by one big block of memory.
-    layerOutputMatrix = MatType(1, batchSize * totalOutputSize);
+    // Backward() and Gradient() will need all the outputs at once.
+    if (trainingMemoryBatchSize != batchSize)
+      InitializeTrainingMemory(batchSize);
+    return;
   }
 
+  // The output of each layer is only needed until the next layer has been
+  // computed.
+  InitializeAlternatingMemory(network, batchSize, start, end);
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::InitializeAlternatingMemory(
+    const std::vector<Layer<MatType>*>& layers,
+    const size_t batchSize,
+    const size_t start,
+    const size_t end)
+{
+  // We alternate between two parts of the memory, each large enough for any of
+  // the outputs that are stored in it.
+  size_t partSizes[2] = { 0, 0 };
+  for (size_t i = start; i < end; ++i)
+  {
+    partSizes[(i - start) % 2] = std::max(partSizes[(i - start) % 2],
+        layers[i]->OutputSize());
+  }
+
+  // If the memory is larger (e.g. because it was last used for training), we
+  // keep it, so that alternating between training and evaluation does not
+  // reallocate it every time.
+  if (batchSize * (partSizes[0] + partSizes[1]) > layerMemory.n_elem)
+    layerMemory = MatType(1, batchSize * (partSizes[0] + partSizes[1]));
+  trainingMemoryBatchSize = 0;
+
+  for (size_t i = start; i < end; ++i)
+  {
+    const size_t offset = ((i - start) % 2 == 0) ? 0 : batchSize * partSizes[0];
+    MakeAlias(layerOutputs[i], MemPtr(layerMemory) + offset,
+        layers[i]->OutputSize(), batchSize);
+  }
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::ResetInferenceNetwork()
+{
+  for (size_t i = 0; i < foldedLayers.size(); ++i)
+    delete foldedLayers[i];
+
+  foldedLayers.clear();
+  foldedWeights.clear();
+  inferenceNetwork.clear();
+  inferenceNetworkIsSet = false;
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::InitializeInferenceNetwork()
+{
+  ResetInferenceNetwork();
+
+  // The layers in foldedLayers may use the memory of foldedWeights, so that
+  // memory must never move.
+  foldedWeights.reserve(network.size());
+
+  MatType scale, shift, empty;
+  size_t offset = 0; // The offset of the weights of network[i].
+  size_t previousOffset = 0; // The offset of the weights of the last layer.
+  bool previousIsFused = false; // Whether an activation is fused into it.
+  for (size_t i = 0; i < network.size(); offset += network[i]->WeightSize(),
+      ++i)
+  {
+    // Layers that do nothing are skipped.
+    if (network[i]->IsIdentityWhenTesting())
+      continue;
+
+    // A layer that only scales and shifts its input is folded into the layer
+    // before it, if that layer can represent the transformation (and does not
+    // apply an activation after it).
+    if (!inferenceNetwork.empty() && !previousIsFused &&
+        network[i]->TestingAffine(scale, shift))
+    {
+      Layer<MatType>* previous = inferenceNetwork.back();
+      if (!foldedLayers.empty() && foldedLayers.back() == previous)
+      {
+        // The previous layer is already a copy.
+        if (previous->FoldAffine(scale, shift))
+          continue;
+      }
+      else if (weightsPtr != NULL && previous->WeightSize() > 0)
+      {
+        // Fold into a copy of the layer, with a copy of its weights.
+        Layer<MatType>* copy = previous->Clone();
+        MatType previousWeights;
+        MakeAlias(previousWeights, weightsPtr + previousOffset,
+            previous->WeightSize(), 1);
+        foldedWeights.push_back(MatType(previousWeights));
+        copy->SetWeights(MemPtr(foldedWeights.back()));
+
+        if (copy->FoldAffine(scale, shift))
+        {
+          foldedLayers.push_back(copy);
+          inferenceNetwork.back() = copy;
+          continue;
+        }
+
+        delete copy;
+        foldedWeights.pop_back();
+      }
+    }
+
+    // A layer that applies a function to each element of its input is fused
+    // into the layer before it, if that layer can apply it to its output as it
+    // computes it; this saves a pass over the output and its memory.
+    if (!inferenceNetwork.empty() && !previousIsFused &&
+        network[i]->TestingActivation(empty))
+    {
+      Layer<MatType>* previous = inferenceNetwork.back();
+      if (!foldedLayers.empty() && foldedLayers.back() == previous)
+      {
+        // The previous layer is already a copy.
+        if (previous->FuseActivation(network[i]))
+        {
+          previousIsFused = true;
+          continue;
+        }
+      }
+      else if (weightsPtr != NULL && previous->WeightSize() > 0)
+      {
+        // Fuse into a copy of the layer, which uses the weights of the layer.
+        Layer<MatType>* copy = previous->Clone();
+        copy->SetWeights(weightsPtr + previousOffset);
+
+        if (copy->FuseActivation(network[i]))
+        {
+          foldedLayers.push_back(copy);
+          inferenceNetwork.back() = copy;
+          previousIsFused = true;
+          continue;
+        }
+
+        delete copy;
+      }
+    }
+
+    inferenceNetwork.push_back(network[i]);
+    previousOffset = offset;
+    previousIsFused = false;
+  }
+
+  inferenceNetworkIsSet = true;
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::InitializeBackwardPassMemory(
+    const size_t batchSize)
+{
+  // Normally, Forward() has planned the memory for the deltas already.  (If it
+  // has not, then the outputs of the layers are not available anyway.)
+  if (trainingMemoryBatchSize != batchSize)
+    InitializeTrainingMemory(batchSize);
+
   // Now, create an alias to the right place for each layer.  We assume that
-  // layerOutputs is already sized correctly (this should be done by Add()).
+  // layerDeltas is already sized correctly (this should be done by Add()).  The
+  // first layer outputs its delta directly into the caller's matrix.
+  size_t start = batchSize * (totalOutputSize - network.back()->OutputSize());
+  for (size_t i = 1; i < layerDeltas.size(); ++i)
+  {
+    size_t layerInputSize = 1;
+    for (size_t j = 0; j < this->network[i]->InputDimensions().size(); ++j)
+      layerInputSize *= this->network[i]->InputDimensions()[j];
+
+    MakeAlias(layerDeltas[i], MemPtr(layerMemory) + start, layerInputSize,
+        batchSize);
+    start += batchSize * layerInputSize;
+  }
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::InitializeTrainingMemory(const size_t batchSize)
+{
+  // The outputs of all layers but the last are needed by the backward pass,
+  // and the deltas of all layers but the first are needed by the gradient
+  // pass, so none of them can share memory.  The output of layer i has the
+  // same size as the delta of layer i + 1, so the deltas take as much memory
+  // as the outputs; they are placed after the outputs.
+  const size_t outputsSize = totalOutputSize - network.back()->OutputSize();
+  ResizeLayerMemory(2 * batchSize * outputsSize);
+  trainingMemoryBatchSize = batchSize;
+
   size_t start = 0;
-  for (size_t i = 0; i < layerOutputs.size(); ++i)
+  for (size_t i = 0; i < network.size() - 1; ++i)
   {
     const size_t layerOutputSize = network[i]->OutputSize();
-    MakeAlias(layerOutputs[i], layerOutputMatrix.colptr(start),
-        layerOutputSize, batchSize);
+    MakeAlias(layerOutputs[i], MemPtr(layerMemory) + start, layerOutputSize,
+        batchSize);
     start += batchSize * layerOutputSize;
   }
 }
 
 template<typename MatType>
-void MultiLayer<MatType>::InitializeBackwardPassMemory(
-    const size_t batchSize)
+void MultiLayer<MatType>::InitializeCheckpointMemory(const size_t batchSize)
 {
-  // We need to initialize memory to store the output of each layer's Backward()
-  // call.  We do this similarly to InitializeForwardPassMemory(), but we must
-  // store a matrix to use as the delta for each layer.
-  if (batchSize * totalInputSize > layerDeltaMatrix.n_elem ||
-      batchSize * totalInputSize < std::floor(0.1 * layerDeltaMatrix.n_elem))
+  // Each segment ends with a checkpoint, except the last one, which ends with
+  // the last layer.
+  std::vector<size_t> sortedCheckpoints(checkpoints);
+  std::sort(sortedCheckpoints.begin(), sortedCheckpoints.end());
+  segmentEnds.clear();
+  for (size_t i = 0; i < sortedCheckpoints.size(); ++i)
   {
-    // All deltas will be represented by one big block of memory.
-    layerDeltaMatrix = MatType(1, batchSize * totalInputSize);
+    if (sortedCheckpoints[i] < network.size() - 1 && (segmentEnds.empty() ||
+        sortedCheckpoints[i] != segmentEnds.back()))
+      segmentEnds.push_back(sortedCheckpoints[i]);
   }
+  segmentEnds.push_back(network.size() - 1);
+
+  // The outputs of the checkpoints are placed first, then the space shared by
+  // the outputs inside each segment, then the two deltas.
+  size_t checkpointsSize = 0, segmentSize = 0;
+  size_t first = 0;
+  for (size_t s = 0; s < segmentEnds.size(); ++s)
+  {
+    size_t size = 0;
+    for (size_t i = first; i < segmentEnds[s]; ++i)
+      size += network[i]->OutputSize();
+    segmentSize = std::max(segmentSize, size);
+
+    if (s < segmentEnds.size() - 1)
+      checkpointsSize += network[segmentEnds[s]]->OutputSize();
+    first = segmentEnds[s] + 1;
+  }
+
+  // The delta of each layer has the size of the output of the layer before it.
+  checkpointDeltaSize = 0;
+  for (size_t i = 0; i < network.size() - 1; ++i)
+    checkpointDeltaSize = std::max(checkpointDeltaSize,
+        network[i]->OutputSize());
+
+  ResizeLayerMemory(batchSize * (checkpointsSize + segmentSize +
+      2 * checkpointDeltaSize));
+  trainingMemoryBatchSize = 0;
+  checkpointDeltaOffset = batchSize * (checkpointsSize + segmentSize);
+
+  size_t checkpointStart = 0;
+  first = 0;
+  for (size_t s = 0; s < segmentEnds.size(); ++s)
+  {
+    size_t start = batchSize * checkpointsSize;
+    for (size_t i = first; i < segmentEnds[s]; ++i)
+    {
+      MakeAlias(layerOutputs[i], MemPtr(layerMemory) + start,
+          network[i]->OutputSize(), batchSize);
+      start += batchSize * network[i]->OutputSize();
+    }
+
+    if (s < segmentEnds.size() - 1)
+    {
+      MakeAlias(layerOutputs[segmentEnds[s]], MemPtr(layerMemory) +
+          checkpointStart, network[segmentEnds[s]]->OutputSize(), batchSize);
+      checkpointStart += batchSize * network[segmentEnds[s]]->OutputSize();
+    }
+
+    first = segmentEnds[s] + 1;
+  }
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::CheckpointedBackward(const MatType& input,
+                                               const MatType& output,
+                                               const MatType& gy,
+                                               MatType& g)
+{
+  const size_t batchSize = input.n_cols;
+  const size_t last = network.size() - 1;
+
+  // The gradient of each layer is computed as soon as its delta is known.
+  checkpointGradient.set_size(WeightSize(), 1);
+  InitializeGradientPassMemory(checkpointGradient);
+
+  size_t s = segmentEnds.size();
+  while (s-- > 0)
+  {
+    const size_t first = (s == 0) ? 0 : segmentEnds[s - 1] + 1;
+
+    // Compute the outputs inside the segment again; the output of its last
+    // layer was kept.
+    for (size_t i = first; i < segmentEnds[s]; ++i)
+    {
+      LayerForward(network[i], i, (i == 0) ? input : layerOutputs[i - 1],
+          layerOutputs[i]);
+    }
+
+    // The deltas alternate between the two parts of the memory after the
+    // outputs.
+    for (size_t i = segmentEnds[s] + 1; i-- > first; )
+    {
+      const MatType& layerInput = (i == 0) ? input : layerOutputs[i - 1];
+      const MatType& layerOutput = (i == last) ? output : layerOutputs[i];
+      const MatType& layerError = (i == last) ? gy : layerDeltas[i + 1];
+
+      if (i == 0)
+      {
+        LayerBackward(0, layerInput, layerOutput, layerError, g);
+      }
+      else
+      {
+        MakeAlias(layerDeltas[i], MemPtr(layerMemory) +
+            checkpointDeltaOffset + (i % 2) * batchSize * checkpointDeltaSize,
+            network[i - 1]->OutputSize(), batchSize);
+        LayerBackward(i, layerInput, layerOutput, layerError, layerDeltas[i]);
+      }
+
+      LayerGradient(i, layerInput, layerError, layerGradients[i]);
+    }
+  }
+}
+
+template<typename MatType>
+size_t MultiLayer<MatType>::ForwardFlops()
+{
+  size_t flops = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+    flops += network[i]->ForwardFlops();
+
+  return flops;
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::LayerForward(Layer<MatType>* layer,
+                                       const size_t index,
+                                       const MatType& input,
+                                       MatType& output)
+{
+  if (profiler == NULL)
+  {
+    layer->Forward(input, output);
+    return;
+  }
+
+  const LayerProfiler::Clock::time_point start = LayerProfiler::Clock::now();
+  layer->Forward(input, output);
+  profiler->Record(layer, index, LayerProfiler::FORWARD, start,
+      LayerProfiler::Clock::now(), double(layer->ForwardFlops()) * input.n_cols,
+      output.n_elem * sizeof(typename MatType::elem_type));
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::LayerBackward(const size_t index,
+                                        const MatType& input,
+                                        const MatType& output,
+                                        const MatType& gy,
+                                        MatType& g)
+{
+  if (profiler == NULL)
+  {
+    network[index]->Backward(input, output, gy, g);
+    return;
+  }
+
+  const LayerProfiler::Clock::time_point start = LayerProfiler::Clock::now();
+  network[index]->Backward(input, output, gy, g);
+  profiler->Record(network[index], index, LayerProfiler::BACKWARD, start,
+      LayerProfiler::Clock::now(),
+      double(network[index]->ForwardFlops()) * input.n_cols,
+      g.n_elem * sizeof(typename MatType::elem_type));
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::LayerGradient(const size_t index,
+                                        const MatType& input,
+                                        const MatType& error,
+                                        MatType& gradient)
+{
+  if (profiler == NULL)
+  {
+    network[index]->Gradient(input, error, gradient);
+    return;
+  }
+
+  const LayerProfiler::Clock::time_point start = LayerProfiler::Clock::now();
+  network[index]->Gradient(input, error, gradient);
+  profiler->Record(network[index], index, LayerProfiler::GRADIENT, start,
+      LayerProfiler::Clock::now(),
+      double(network[index]->ForwardFlops()) * input.n_cols,
+      gradient.n_elem * sizeof(typename MatType::elem_type));
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::InitializeParallelPassMemory(const size_t batchSize)
+{
+  if (trainingMemoryBatchSize == batchSize)
+    return;
+
+  // Each layer gets its own part of the memory for its output, and then for
+  // its delta (which has the size of the input).
+  ResizeLayerMemory(batchSize * (totalOutputSize + totalInputSize));
+  trainingMemoryBatchSize = batchSize;
 
-  // Now, create an alias to the right place for each layer.  We assume that
-  // layerDeltas is already sized correctly (this should be done by Add()).
   size_t start = 0;
-  for (size_t i = 0; i < layerDeltas.size(); ++i)
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t layerOutputSize = network[i]->OutputSize();
+    MakeAlias(layerOutputs[i], MemPtr(layerMemory) + start, layerOutputSize,
+        batchSize);
+    start += batchSize * layerOutputSize;
+  }
+
+  for (size_t i = 0; i < network.size(); ++i)
   {
     size_t layerInputSize = 1;
-    for (size_t j = 0; j < this->network[i]->InputDimensions().size(); ++j)
-      layerInputSize *= this->network[i]->InputDimensions()[j];
+    for (size_t j = 0; j < network[i]->InputDimensions().size(); ++j)
+      layerInputSize *= network[i]->InputDimensions()[j];
 
-    MakeAlias(layerDeltas[i], layerDeltaMatrix.colptr(start), layerInputSize,
+    MakeAlias(layerDeltas[i], MemPtr(layerMemory) + start, layerInputSize,
         batchSize);
     start += batchSize * layerInputSize;
   }
 }
 
+template<typename MatType>
+void MultiLayer<MatType>::ResizeLayerMemory(const size_t elements)
+{
+  // We avoid resizing layerMemory down, unless we only need 10% or less of it.
+  if (elements > layerMemory.n_elem ||
+      elements < std::floor(0.1 * layerMemory.n_elem))
+  {
+    layerMemory = MatType(1, elements);
+  }
+}
+
 template<typename MatType>
 void MultiLayer<MatType>::InitializeGradientPassMemory(MatType& gradient)
 {
@@ -432,7 +979,7 @@ void MultiLayer<MatType>::InitializeGradientPassMemory(MatType& gradient)
   for (size_t i = 0; i < network.size(); ++i)
   {
     const size_t weightSize = network[i]->WeightSize();
-    MakeAlias(layerGradients[i], gradient.memptr() + gradientStart,
+    MakeAlias(layerGradients[i], MemPtr(gradient) + gradientStart,
         weightSize, 1);
     gradientStart += weightSize;
   }
@@ -58,6 +58,15 @@ namespace mlpack {
  * [embedDim * (2 * srcSeqLen + tgtSeqLen), batchSize].  The
  * output data will always be of size (embedDim * tgtSeqLen, batchSize)
  *
+ * By default, the attention scores of every head are stored as matrices of
+ * size (tgtSeqLen, srcSeqLen) for the backward pass, so memory grows with the
+ * product of the sequence lengths.  If a tile size is given, the scores are
+ * instead computed one tile of (tileSize, tileSize) at a time, with an online
+ * softmax that keeps only the running maximum and sum of each query; the
+ * tiles are computed again during the backward pass, so the memory used is
+ * linear in the sequence lengths.  With self-attention, the query, key, and
+ * value are then also projected with a single matrix product.
+ *
  * @tparam MatType Type of the input/output data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam RegularizerType Type of the regularizer to be used.
@@ -85,12 +94,15 @@ class MultiheadAttentionType : public Layer<MatType>
    * @param keyPaddingMask Key Padding Mask.  Takes the values [-Inf, 0]
    * @param selfAttention Use self-attention; source key, query, and value all
    *     come from the same inputs
+   * @param tileSize If greater than 0, compute the attention in tiles of this
+   *     many queries and keys, without storing the attention scores.
    */
   MultiheadAttentionType(const size_t tgtSeqLen,
                          const size_t numHeads,
                          const MatType& attnMask = MatType(),
                          const MatType& keyPaddingMask = MatType(),
-                         const bool selfAttention = false);
+                         const bool selfAttention = false,
+                         const size_t tileSize = 0);
 
   //! Clone the MultiheadAttentionType object. This handles polymorphism
   //! correctly.
@@ -146,7 +158,7 @@ class MultiheadAttentionType : public Layer<MatType>
    * Serialize the layer.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
   //! Get the parameters.
   MatType const& Parameters() const override { return weights; }
@@ -190,6 +202,13 @@ class MultiheadAttentionType : public Layer<MatType>
   //! all come from the same input).
   bool& SelfAttention() { return selfAttention; }
 
+  //! Get the tile size used to compute the attention (0 if the attention
+  //! scores are stored).
+  size_t TileSize() const { return tileSize; }
+  //! Modify the tile size used to compute the attention (0 to store the
+  //! attention scores).
+  size_t& TileSize() { return tileSize; }
+
   void ComputeOutputDimensions() override
   {
     if (this->inputDimensions.size() < 2)
@@ -267,6 +286,42 @@ class MultiheadAttentionType : public Layer<MatType>
   //! Element Type of the output.
   typedef typename MatType::elem_type ElemType;
 
+  /**
+   * Get the query, key, and value of the given input as matrices with one
+   * column for each element of the sequences of each point.  With
+   * self-attention, these are aliases of the input.
+   */
+  void SplitInput(const MatType& input,
+                  MatType& query,
+                  MatType& key,
+                  MatType& value) const;
+
+  /**
+   * Compute the masked attention scores of keys `j0` to `j1` for queries `i0`
+   * to `i1` (inclusive), for the head and point given by `slice`, from the
+   * projections stored by TiledForward().  Element (j, i) of `tileScores` is
+   * the score of key `j0 + j` for query `i0 + i`.
+   */
+  void TileScores(const size_t slice,
+                  const size_t i0,
+                  const size_t i1,
+                  const size_t j0,
+                  const size_t j1,
+                  MatType& tileScores) const;
+
+  //! Forward pass that computes the attention in tiles.
+  void TiledForward(const MatType& input, MatType& output);
+
+  /**
+   * Compute the deltas of the projected query, key, and value for the given
+   * backpropagated error, by computing the tiles of attention probabilities
+   * again from the log-sum-exps stored by TiledForward().
+   */
+  void TiledDeltas(const MatType& gy,
+                   MatType& queryDelta,
+                   MatType& keyDelta,
+                   MatType& valueDelta) const;
+
   //! Target sequence length.
   size_t tgtSeqLen;
 
@@ -293,6 +348,10 @@ class MultiheadAttentionType : public Layer<MatType>
   //! come from the same input).
   bool selfAttention;
 
+  //! The number of queries and keys in each tile of the attention, or 0 if the
+  //! attention scores are stored.
+  size_t tileSize;
+
   //! Locally-stored weight matrix associated with query.
   MatType queryWt;
 
@@ -335,6 +394,23 @@ class MultiheadAttentionType : public Layer<MatType>
   //! Locally-stored attention output weight to be fed to last linear layer.
   arma::Cube<ElemType> attnOut;
 
+  //! Projected query of the tiled attention, with one column for each element
+  //! of the target sequence of each point.
+  MatType tiledQProj;
+
+  //! Projected key of the tiled attention.
+  MatType tiledKProj;
+
+  //! Projected value of the tiled attention.
+  MatType tiledVProj;
+
+  //! Output of the tiled attention, before the output projection.
+  MatType tiledAttnOut;
+
+  //! Log of the softmax normalization of each query of the tiled attention,
+  //! of shape (tgtSeqLen, numHeads * batchSize).
+  MatType logSumExp;
+
   //! Softmax layer to represent the probabilities of next sequence.
   SoftmaxType<MatType> softmax;
 
@@ -347,6 +423,9 @@ typedef MultiheadAttentionType<arma::mat, NoRegularizer> MultiheadAttention;
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename MatType, typename RegularizerType),
+    (mlpack::MultiheadAttentionType<MatType, RegularizerType>), (1));
+
 // Include implementation.
 #include "multihead_attention_impl.hpp"
 
@@ -29,7 +29,8 @@ MultiheadAttentionType() :
     embedDim(0),
     numHeads(0),
     headDim(0),
-    selfAttention(false)
+    selfAttention(false),
+    tileSize(0)
 {
   // Nothing to do here.
 }
@@ -41,14 +42,16 @@ MultiheadAttentionType(
     const size_t numHeads,
     const MatType& attnmask,
     const MatType& keypaddingmask,
-    const bool selfAttention) :
+    const bool selfAttention,
+    const size_t tileSize) :
     tgtSeqLen(tgtSeqLen),
     srcSeqLen(0),
     embedDim(0),
     numHeads(numHeads),
     attnMask(attnmask),
     keyPaddingMask(keypaddingmask),
-    selfAttention(selfAttention)
+    selfAttention(selfAttention),
+    tileSize(tileSize)
 {
 }
 
@@ -88,6 +91,12 @@ Forward(const MatType& input, MatType& output)
         << "self-attention!" << std::endl;
   }
 
+  if (tileSize > 0)
+  {
+    TiledForward(input, output);
+    return;
+  }
+
   const size_t batchSize = input.n_cols;
 
   // shape of output : (embedDim * tgtSeqLen, batchSize).
@@ -97,30 +106,28 @@ Forward(const MatType& input, MatType& output)
   // The shape of q : (embedDim, tgtSeqLen, batchSize).
   // The shape of k : (embedDim, srcSeqLen, batchSize).
   // The shape of v : (embedDim, srcSeqLen, batchSize).
-  const CubeType q(const_cast<MatType&>(input).memptr(),
-      embedDim, tgtSeqLen, batchSize, false, false);
-  const CubeType k(const_cast<MatType&>(input).memptr() +
-      (selfAttention ? 0 : embedDim * tgtSeqLen * batchSize),
-      embedDim, srcSeqLen, batchSize, false, false);
-  const CubeType v(const_cast<MatType&>(input).memptr() +
-      (selfAttention ? 0 : embedDim * (tgtSeqLen + srcSeqLen) * batchSize),
-      embedDim, srcSeqLen, batchSize, false, false);
+  MatType qIn, kIn, vIn;
+  SplitInput(input, qIn, kIn, vIn);
+  const CubeType q(qIn.memptr(), embedDim, tgtSeqLen, batchSize, false, false);
+  const CubeType k(kIn.memptr(), embedDim, srcSeqLen, batchSize, false, false);
+  const CubeType v(vIn.memptr(), embedDim, srcSeqLen, batchSize, false, false);
 
   // qProj, kProj, and vProj are the linearly projected query, key and value
-  // respectively.
-  qProj.set_size(tgtSeqLen, embedDim, batchSize);
-  kProj.set_size(srcSeqLen, embedDim, batchSize);
-  vProj.set_size(srcSeqLen, embedDim, batchSize);
-
-  for (size_t i = 0; i < batchSize; ++i)
-  {
-    qProj.slice(i) = trans(
-        queryWt * q.slice(i) + repmat(qBias, 1, tgtSeqLen));
-    kProj.slice(i) = trans(
-        keyWt * k.slice(i) + repmat(kBias, 1, srcSeqLen));
-    vProj.slice(i) = trans(
-        valueWt * v.slice(i) + repmat(vBias, 1, srcSeqLen));
-  }
+  // respectively, i.e. qProj.slice(i) = trans(queryWt * q.slice(i) + qBias).
+  // The weights are shared by the whole batch, so each projection is a single
+  // GEMM.
+  const CubeType queryWtCube(queryWt.memptr(), embedDim, embedDim, 1, false,
+      true);
+  const CubeType keyWtCube(keyWt.memptr(), embedDim, embedDim, 1, false,
+      true);
+  const CubeType valueWtCube(valueWt.memptr(), embedDim, embedDim, 1, false,
+      true);
+  BatchedGemm(qProj, q, queryWtCube, true, true);
+  BatchedGemm(kProj, k, keyWtCube, true, true);
+  BatchedGemm(vProj, v, valueWtCube, true, true);
+  qProj.each_slice() += repmat(trans(qBias), tgtSeqLen, 1);
+  kProj.each_slice() += repmat(trans(kBias), srcSeqLen, 1);
+  vProj.each_slice() += repmat(trans(vBias), srcSeqLen, 1);
 
   // The scaling factor sqrt(headDim) is used to prevent exploding values
   // after dot product i.e. when qProj is multiplied with kProj.
@@ -134,7 +141,7 @@ Forward(const MatType& input, MatType& output)
 
   // Calculate the scores i.e. perform the matrix multiplication operation
   // on qProj and kProj. Here score = qProj . kProj'
-  scores = MultiplyCube2Cube(qProj, kProj, false, true);
+  BatchedGemm(scores, qProj, kProj, false, true);
 
   // Apply the attention mask if provided. The attention mask is used to black-
   // out future sequences and generally used in Encoder-Decoder attention.
@@ -166,18 +173,23 @@ Forward(const MatType& input, MatType& output)
   // Calculate the attention output i.e. matrix multiplication of softmax
   // output and vProj.
   // The shape of attnOutput : (tgtSeqLen, headDim, numHeads * batchSize).
-  attnOut = MultiplyCube2Cube(scores, vProj, false, false);
+  BatchedGemm(attnOut, scores, vProj);
 
   // Now we will concatenate output of all the heads i.e. we will reshape
   // attnOut to (tgtSeqLen, embedDim, batchSize).
   attnOut.reshape(tgtSeqLen, embedDim, batchSize);
 
-  // The final output is the linear projection of attention output.
-  for (size_t i = 0; i < batchSize; ++i)
-  {
-    output.col(i) = vectorise(trans(attnOut.slice(i) * outWt
-        + repmat(outBias, tgtSeqLen, 1)));
-  }
+  // The final output is the linear projection of attention output, i.e.
+  // output.col(i) = vectorise(trans(attnOut.slice(i) * outWt + outBias)).
+  const CubeType outWtCube(outWt.memptr(), embedDim, embedDim, 1, false,
+      true);
+  CubeType outputCube(output.memptr(), embedDim, tgtSeqLen, batchSize, false,
+      true);
+  BatchedGemm(outputCube, outWtCube, attnOut, true, true);
+
+  MatType outputTokens;
+  MakeAlias(outputTokens, output.memptr(), embedDim, tgtSeqLen * batchSize);
+  outputTokens.each_col() += trans(outBias);
 }
 
 template <typename MatType, typename RegularizerType>
@@ -198,17 +210,47 @@ Backward(const MatType& /* input */,
   g.set_size(selfAttention ? (embedDim * srcSeqLen) :
       embedDim * (tgtSeqLen + 2 * srcSeqLen), batchSize);
 
+  if (tileSize > 0)
+  {
+    MatType qDelta, kDelta, vDelta;
+    TiledDeltas(gy, qDelta, kDelta, vDelta);
+
+    if (selfAttention)
+    {
+      // The query, key, and value are all the input, so their deltas are
+      // summed.
+      MatType gTokens;
+      MakeAlias(gTokens, g.memptr(), embedDim, srcSeqLen * batchSize);
+      gTokens = trans(queryWt) * qDelta + trans(keyWt) * kDelta +
+          trans(valueWt) * vDelta;
+    }
+    else
+    {
+      g.rows(0, tgtSeqLen * embedDim - 1) = reshape(trans(queryWt) * qDelta,
+          tgtSeqLen * embedDim, batchSize);
+      g.rows(tgtSeqLen * embedDim, (tgtSeqLen + srcSeqLen) * embedDim - 1) =
+          reshape(trans(keyWt) * kDelta, srcSeqLen * embedDim, batchSize);
+      g.rows((tgtSeqLen + srcSeqLen) * embedDim, g.n_rows - 1) =
+          reshape(trans(valueWt) * vDelta, srcSeqLen * embedDim, batchSize);
+    }
+
+    return;
+  }
+
   // Reshape the propagated gradient into a cube.
   // The shape of gyTemp : (tgtSeqLen, embedDim, batchSize).
   // We need not split it into n heads now because this is the part when
   // output were concatenated from n heads.
-  CubeType gyTemp(const_cast<MatType&>(gy).memptr(), embedDim,
-      tgtSeqLen, batchSize, true, false);
+  const CubeType gyCube(const_cast<MatType&>(gy).memptr(), embedDim,
+      tgtSeqLen, batchSize, false, true);
+  const CubeType outWtCube(outWt.memptr(), embedDim, embedDim, 1, false,
+      true);
 
-  // The shape of gyTemp : (embedDim, tgtSeqLen, batchSize).
+  // The shape of gyCube : (embedDim, tgtSeqLen, batchSize).
   // The shape of outWt : (embedDim, embedDim).
   // The shape of the result : (tgtSeqLen, embedDim, batchSize).
-  gyTemp = MultiplyCube2Mat(gyTemp, outWt, true, true);
+  CubeType gyTemp;
+  BatchedGemm(gyTemp, gyCube, outWtCube, true, true);
 
   // Now since the shape of gyTemp is (tgtSeqLen, embedDim, batchSize). We will
   // split it into n heads.
@@ -219,29 +261,40 @@ Backward(const MatType& /* input */,
   // Shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
   // Shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
   // The shape of tmp : (srcSeqLen, headDim, numHeads * batchSize).
-  CubeType tmp = MultiplyCube2Cube(scores, gyTemp, true, false);
+  CubeType tmp;
+  BatchedGemm(tmp, scores, gyTemp, true, false);
 
   // Concatenate results of all the attention heads.
   tmp.reshape(srcSeqLen, embedDim, batchSize);
 
-  for (size_t i = 0; i < batchSize; ++i)
+  // The delta of each input is trans(tmp.slice(i) * weight) for each point
+  // of the batch.  With self-attention, the deltas of the query, key, and
+  // value are summed directly into g; otherwise each one fills its own block
+  // of rows of g.
+  const CubeType queryWtCube(queryWt.memptr(), embedDim, embedDim, 1, false,
+      true);
+  const CubeType keyWtCube(keyWt.memptr(), embedDim, embedDim, 1, false,
+      true);
+  const CubeType valueWtCube(valueWt.memptr(), embedDim, embedDim, 1, false,
+      true);
+  CubeType gCube, delta;
+  if (selfAttention)
   {
-    if (selfAttention)
-    {
-      g.submat(0, i, g.n_rows - 1, i) =
-          vectorise(trans(tmp.slice(i) * valueWt));
-    }
-    else
-    {
-      g.submat((tgtSeqLen + srcSeqLen) * embedDim, i, g.n_rows - 1, i) =
-          vectorise(trans(tmp.slice(i) * valueWt));
-    }
+    MakeAlias(gCube, g.memptr(), embedDim, srcSeqLen, batchSize);
+    BatchedGemm(gCube, valueWtCube, tmp, true, true);
+  }
+  else
+  {
+    BatchedGemm(delta, valueWtCube, tmp, true, true);
+    g.rows((tgtSeqLen + srcSeqLen) * embedDim, g.n_rows - 1) = MatType(
+        delta.memptr(), srcSeqLen * embedDim, batchSize, false, true);
   }
 
   // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
   // The shape of vProj : (srcSeqLen, headDim, numHeads * batchSize).
   // So the new shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  gyTemp = MultiplyCube2Cube(gyTemp, vProj, false, true);
+  BatchedGemm(tmp, gyTemp, vProj, false, true);
+  gyTemp.swap(tmp);
 
   for (size_t i = 0; i < numHeads * batchSize; ++i)
   {
@@ -253,49 +306,42 @@ Backward(const MatType& /* input */,
   // The shape of qProj : (tgtSeqLen, headDim, numHeads * batchSize).
   // The shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
   // The new shape of tmp : (srcSeqLen, headDim, numHeads * batchSize).
-  tmp = MultiplyCube2Cube(gyTemp, qProj, true, false);
+  BatchedGemm(tmp, gyTemp, qProj, true, false);
 
   // Concatenate results of all the attention heads.
   tmp.reshape(srcSeqLen, embedDim, batchSize);
 
-  for (size_t i = 0; i < batchSize; ++i)
+  if (selfAttention)
   {
-    if (selfAttention)
-    {
-      // Sum the query, key, and value deltas.
-      g.submat(0, i, g.n_rows - 1, i) +=
-          vectorise(trans(tmp.slice(i) * keyWt));
-    }
-    else
-    {
-      g.submat(tgtSeqLen * embedDim, i,
-               (tgtSeqLen + srcSeqLen) * embedDim - 1, i) =
-          vectorise(trans(tmp.slice(i) * keyWt));
-    }
+    // Sum the query, key, and value deltas.
+    BatchedGemm(gCube, keyWtCube, tmp, true, true, 1, 1);
+  }
+  else
+  {
+    BatchedGemm(delta, keyWtCube, tmp, true, true);
+    g.rows(tgtSeqLen * embedDim, (tgtSeqLen + srcSeqLen) * embedDim - 1) =
+        MatType(delta.memptr(), srcSeqLen * embedDim, batchSize, false, true);
   }
 
   // Obtain backpropagated error of the query.
   // The shape of kProj : (srcSeqLen, headDim, numHeads * batchSize).
   // The shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
   // The new shape of tmp : (tgtSeqLen, headDim, numHeads * batchSize).
-  tmp = MultiplyCube2Cube(gyTemp, kProj) / std::sqrt(headDim);
+  BatchedGemm(tmp, gyTemp, kProj, false, false, 1 / std::sqrt(headDim));
 
   // Concatenate results of all the attention heads.
   tmp.reshape(tgtSeqLen, embedDim, batchSize);
 
-  for (size_t i = 0; i < batchSize; ++i)
+  if (selfAttention)
   {
-    if (selfAttention)
-    {
-      // Sum the query, key, and value deltas.
-      g.submat(0, i, g.n_rows - 1, i) +=
-          vectorise(trans(tmp.slice(i) * queryWt));
-    }
-    else
-    {
-      g.submat(0, i, tgtSeqLen * embedDim - 1, i) =
-          vectorise(trans(tmp.slice(i) * queryWt));
-    }
+    // Sum the query, key, and value deltas.
+    BatchedGemm(gCube, queryWtCube, tmp, true, true, 1, 1);
+  }
+  else
+  {
+    BatchedGemm(delta, queryWtCube, tmp, true, true);
+    g.rows(0, tgtSeqLen * embedDim - 1) = MatType(delta.memptr(),
+        tgtSeqLen * embedDim, batchSize, false, true);
   }
 }
 
@@ -331,14 +377,40 @@ Gradient(const MatType& input,
   // The shape of gradient : (4 * embedDim * embedDim + 4 * embedDim, 1).
   gradient.set_size(arma::size(weights));
 
-  const CubeType q(const_cast<MatType&>(input).memptr(),
-      embedDim, tgtSeqLen, batchSize, false, false);
-  const CubeType k(const_cast<MatType&>(input).memptr() +
-      (selfAttention ? 0 : q.n_elem), embedDim, srcSeqLen, batchSize, false,
-      false);
-  const CubeType v(const_cast<MatType&>(input).memptr() +
-      (selfAttention ? 0 : (q.n_elem + k.n_elem)), embedDim, srcSeqLen,
-      batchSize, false, false);
+  MatType qIn, kIn, vIn;
+  SplitInput(input, qIn, kIn, vIn);
+
+  if (tileSize > 0)
+  {
+    MatType qDelta, kDelta, vDelta;
+    TiledDeltas(error, qDelta, kDelta, vDelta);
+
+    MatType errorTokens;
+    MakeAlias(errorTokens, const_cast<MatType&>(error).memptr(), embedDim,
+        tgtSeqLen * batchSize);
+
+    gradient.rows(0, wtSize - 1) = vectorise(qDelta * trans(qIn));
+    gradient.rows(wtSize, 2 * wtSize - 1) = vectorise(kDelta * trans(kIn));
+    gradient.rows(2 * wtSize, 3 * wtSize - 1) =
+        vectorise(vDelta * trans(vIn));
+    gradient.rows(3 * wtSize, 4 * wtSize - 1) =
+        vectorise(tiledAttnOut * trans(errorTokens));
+
+    gradient.rows(4 * wtSize, 4 * wtSize + embedDim - 1) = sum(qDelta, 1);
+    gradient.rows(4 * wtSize + embedDim, 4 * wtSize + 2 * embedDim - 1) =
+        sum(kDelta, 1);
+    gradient.rows(4 * wtSize + 2 * embedDim, 4 * wtSize + 3 * embedDim - 1) =
+        sum(vDelta, 1);
+    gradient.rows(4 * wtSize + 3 * embedDim, 4 * wtSize + 4 * embedDim - 1) =
+        sum(errorTokens, 1);
+
+    regularizer.Evaluate(weights, gradient);
+    return;
+  }
+
+  const CubeType q(qIn.memptr(), embedDim, tgtSeqLen, batchSize, false, false);
+  const CubeType k(kIn.memptr(), embedDim, srcSeqLen, batchSize, false, false);
+  const CubeType v(vIn.memptr(), embedDim, srcSeqLen, batchSize, false, false);
 
   // Reshape the propagated error into a cube.
   // The shape of errorTemp : (embedDim, tgtSeqLen, batchSize).
@@ -455,10 +527,271 @@ Gradient(const MatType& input,
   regularizer.Evaluate(weights, gradient);
 }
 
+template <typename MatType, typename RegularizerType>
+void MultiheadAttentionType<MatType, RegularizerType>::
+SplitInput(const MatType& input,
+           MatType& query,
+           MatType& key,
+           MatType& value) const
+{
+  const size_t batchSize = input.n_cols;
+  if (selfAttention)
+  {
+    MakeAlias(query, const_cast<MatType&>(input).memptr(), embedDim,
+        srcSeqLen * batchSize);
+    MakeAlias(key, const_cast<MatType&>(input).memptr(), embedDim,
+        srcSeqLen * batchSize);
+    MakeAlias(value, const_cast<MatType&>(input).memptr(), embedDim,
+        srcSeqLen * batchSize);
+  }
+  else
+  {
+    // Each column of the input holds the query, key, and value of one point.
+    query = reshape(input.rows(0, tgtSeqLen * embedDim - 1), embedDim,
+        tgtSeqLen * batchSize);
+    key = reshape(input.rows(tgtSeqLen * embedDim,
+        (tgtSeqLen + srcSeqLen) * embedDim - 1), embedDim,
+        srcSeqLen * batchSize);
+    value = reshape(input.rows((tgtSeqLen + srcSeqLen) * embedDim,
+        input.n_rows - 1), embedDim, srcSeqLen * batchSize);
+  }
+}
+
+template <typename MatType, typename RegularizerType>
+void MultiheadAttentionType<MatType, RegularizerType>::
+TileScores(const size_t slice,
+           const size_t i0,
+           const size_t i1,
+           const size_t j0,
+           const size_t j1,
+           MatType& tileScores) const
+{
+  const size_t point = slice / numHeads;
+  const size_t row = (slice % numHeads) * headDim;
+  const size_t qCol = point * tgtSeqLen;
+  const size_t kCol = point * srcSeqLen;
+
+  // The scaling factor sqrt(headDim) is used to prevent exploding values
+  // after the dot product of the query and the key.
+  tileScores = trans(tiledKProj.submat(row, kCol + j0, row + headDim - 1,
+      kCol + j1)) * tiledQProj.submat(row, qCol + i0, row + headDim - 1,
+      qCol + i1) / std::sqrt(ElemType(headDim));
+
+  if (!attnMask.is_empty())
+    tileScores += trans(attnMask.submat(i0, j0, i1, j1));
+
+  if (!keyPaddingMask.is_empty())
+    tileScores.each_col() += trans(keyPaddingMask.cols(j0, j1));
+}
+
+template <typename MatType, typename RegularizerType>
+void MultiheadAttentionType<MatType, RegularizerType>::
+TiledForward(const MatType& input, MatType& output)
+{
+  if (!attnMask.is_empty() &&
+      (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen))
+  {
+    Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
+  }
+
+  if (!keyPaddingMask.is_empty() &&
+      (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen))
+  {
+    Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
+  }
+
+  const size_t batchSize = input.n_cols;
+  MatType q, k, v;
+  SplitInput(input, q, k, v);
+
+  // Project the query, key, and value; each column of the projections is the
+  // embedding of one element of a sequence, and head h uses rows
+  // [h * headDim, (h + 1) * headDim).
+  if (selfAttention)
+  {
+    // The query, key, and value are the same, so they can be projected with a
+    // single product.
+    MatType qkvProj = join_cols(join_cols(queryWt, keyWt), valueWt) * q;
+    qkvProj.each_col() += join_cols(join_cols(qBias, kBias), vBias);
+
+    tiledQProj = qkvProj.rows(0, embedDim - 1);
+    tiledKProj = qkvProj.rows(embedDim, 2 * embedDim - 1);
+    tiledVProj = qkvProj.rows(2 * embedDim, 3 * embedDim - 1);
+  }
+  else
+  {
+    tiledQProj = queryWt * q;
+    tiledQProj.each_col() += qBias;
+    tiledKProj = keyWt * k;
+    tiledKProj.each_col() += kBias;
+    tiledVProj = valueWt * v;
+    tiledVProj.each_col() += vBias;
+  }
+
+  tiledAttnOut.set_size(embedDim, tgtSeqLen * batchSize);
+  logSumExp.set_size(tgtSeqLen, numHeads * batchSize);
+
+  // Each head of each point is computed independently.  For each tile of
+  // queries, the tiles of keys are visited in turn, keeping the running
+  // maximum score and softmax sum of each query, and the weighted sum of the
+  // values scaled accordingly (the online softmax).
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t slice = 0; slice < numHeads * batchSize; ++slice)
+  {
+    const size_t point = slice / numHeads;
+    const size_t row = (slice % numHeads) * headDim;
+    const size_t qCol = point * tgtSeqLen;
+    const size_t kCol = point * srcSeqLen;
+
+    MatType tileScores;
+    for (size_t i0 = 0; i0 < tgtSeqLen; i0 += tileSize)
+    {
+      const size_t i1 = std::min(i0 + tileSize, tgtSeqLen) - 1;
+      const size_t n = i1 - i0 + 1;
+
+      MatType maxScores(n, 1);
+      maxScores.fill(-std::numeric_limits<ElemType>::infinity());
+      MatType sums(n, 1, arma::fill::zeros);
+      MatType out(headDim, n, arma::fill::zeros);
+
+      for (size_t j0 = 0; j0 < srcSeqLen; j0 += tileSize)
+      {
+        const size_t j1 = std::min(j0 + tileSize, srcSeqLen) - 1;
+        TileScores(slice, i0, i1, j0, j1, tileScores);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+          const ElemType newMax = std::max(maxScores[i],
+              ElemType(tileScores.col(i).max()));
+          if (newMax == -std::numeric_limits<ElemType>::infinity())
+          {
+            // Every key seen so far is masked for this query.
+            tileScores.col(i).zeros();
+            continue;
+          }
+
+          const ElemType correction = std::exp(maxScores[i] - newMax);
+          tileScores.col(i) = exp(tileScores.col(i) - newMax);
+          sums[i] = correction * sums[i] + accu(tileScores.col(i));
+          out.col(i) *= correction;
+          maxScores[i] = newMax;
+        }
+
+        out += tiledVProj.submat(row, kCol + j0, row + headDim - 1,
+            kCol + j1) * tileScores;
+      }
+
+      for (size_t i = 0; i < n; ++i)
+      {
+        if (sums[i] > 0)
+        {
+          out.col(i) /= sums[i];
+          logSumExp(i0 + i, slice) = maxScores[i] + std::log(sums[i]);
+        }
+        else
+        {
+          // All keys are masked; the attention probabilities are all zero.
+          logSumExp(i0 + i, slice) = std::numeric_limits<ElemType>::infinity();
+        }
+      }
+
+      tiledAttnOut.submat(row, qCol + i0, row + headDim - 1, qCol + i1) = out;
+    }
+  }
+
+  // The final output is the linear projection of attention output.
+  output.set_size(embedDim * tgtSeqLen, batchSize);
+  MatType outputTokens;
+  MakeAlias(outputTokens, output.memptr(), embedDim, tgtSeqLen * batchSize);
+  outputTokens = trans(outWt) * tiledAttnOut;
+  outputTokens.each_col() += trans(outBias);
+}
+
+template <typename MatType, typename RegularizerType>
+void MultiheadAttentionType<MatType, RegularizerType>::
+TiledDeltas(const MatType& gy,
+            MatType& queryDelta,
+            MatType& keyDelta,
+            MatType& valueDelta) const
+{
+  const size_t batchSize = gy.n_cols;
+  const ElemType scale = 1 / std::sqrt(ElemType(headDim));
+
+  // The error with respect to the output of the attention, before the output
+  // projection.
+  MatType gyTokens;
+  MakeAlias(gyTokens, const_cast<MatType&>(gy).memptr(), embedDim,
+      tgtSeqLen * batchSize);
+  const MatType attnDelta = outWt * gyTokens;
+
+  queryDelta.zeros(embedDim, tgtSeqLen * batchSize);
+  keyDelta.zeros(embedDim, srcSeqLen * batchSize);
+  valueDelta.zeros(embedDim, srcSeqLen * batchSize);
+
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t slice = 0; slice < numHeads * batchSize; ++slice)
+  {
+    const size_t point = slice / numHeads;
+    const size_t row = (slice % numHeads) * headDim;
+    const size_t qCol = point * tgtSeqLen;
+    const size_t kCol = point * srcSeqLen;
+
+    // The derivative of the softmax of each query needs the dot product of its
+    // output and its error.
+    const MatType outputSums = sum(attnDelta.submat(row, qCol,
+        row + headDim - 1, qCol + tgtSeqLen - 1) % tiledAttnOut.submat(row,
+        qCol, row + headDim - 1, qCol + tgtSeqLen - 1), 0);
+
+    MatType tileScores, tileDelta;
+    for (size_t j0 = 0; j0 < srcSeqLen; j0 += tileSize)
+    {
+      const size_t j1 = std::min(j0 + tileSize, srcSeqLen) - 1;
+      const MatType kTile = tiledKProj.submat(row, kCol + j0,
+          row + headDim - 1, kCol + j1);
+      const MatType vTile = tiledVProj.submat(row, kCol + j0,
+          row + headDim - 1, kCol + j1);
+      MatType kTileDelta(headDim, j1 - j0 + 1, arma::fill::zeros);
+      MatType vTileDelta(headDim, j1 - j0 + 1, arma::fill::zeros);
+
+      for (size_t i0 = 0; i0 < tgtSeqLen; i0 += tileSize)
+      {
+        const size_t i1 = std::min(i0 + tileSize, tgtSeqLen) - 1;
+
+        // Compute the attention probabilities of the tile again.
+        TileScores(slice, i0, i1, j0, j1, tileScores);
+        for (size_t i = 0; i < tileScores.n_cols; ++i)
+        {
+          tileScores.col(i) = exp(tileScores.col(i) -
+              logSumExp(i0 + i, slice));
+        }
+
+        const MatType outTileDelta = attnDelta.submat(row, qCol + i0,
+            row + headDim - 1, qCol + i1);
+        vTileDelta += outTileDelta * trans(tileScores);
+
+        // Backpropagate through the softmax.
+        tileDelta = trans(vTile) * outTileDelta;
+        tileDelta.each_row() -= outputSums.cols(i0, i1);
+        tileDelta %= tileScores;
+
+        queryDelta.submat(row, qCol + i0, row + headDim - 1, qCol + i1) +=
+            scale * kTile * tileDelta;
+        kTileDelta += scale * tiledQProj.submat(row, qCol + i0,
+            row + headDim - 1, qCol + i1) * trans(tileDelta);
+      }
+
+      keyDelta.submat(row, kCol + j0, row + headDim - 1, kCol + j1) =
+          kTileDelta;
+      valueDelta.submat(row, kCol + j0, row + headDim - 1, kCol + j1) =
+          vTileDelta;
+    }
+  }
+}
+
 template <typename MatType, typename RegularizerType>
 template <typename Archive>
 void MultiheadAttentionType<MatType, RegularizerType>::
-serialize(Archive& ar, const uint32_t /* version */)
+serialize(Archive& ar, const uint32_t version)
 {
   ar(cereal::base_class<Layer<MatType>>(this));
 
@@ -473,6 +806,12 @@ serialize(Archive& ar, const uint32_t /* version */)
   ar(CEREAL_NVP(attnMask));
   ar(CEREAL_NVP(keyPaddingMask));
 
+  // Older versions did not support tiled attention.
+  if (version > 0)
+    ar(CEREAL_NVP(tileSize));
+  else if (Archive::is_loading::value)
+    tileSize = 0;
+
   if (Archive::is_loading::value)
   {
     queryWt.clear();
@@ -489,6 +828,11 @@ serialize(Archive& ar, const uint32_t /* version */)
     vProj.clear();
     scores.clear();
     attnOut.clear();
+    tiledQProj.clear();
+    tiledKProj.clear();
+    tiledVProj.clear();
+    tiledAttnOut.clear();
+    logSumExp.clear();
   }
 }
 
@@ -0,0 +1,182 @@
+/**
+ * @file methods/ann/layer/quantized_convolution.hpp
+ *
+ * Definition of the QuantizedConvolution layer, an inference-only convolution
+ * layer with 8-bit quantized weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+#include <mlpack/methods/ann/quantization.hpp>
+
+#include "layer.hpp"
+#include "padding.hpp"
+
+namespace mlpack {
+
+/**
+ * The QuantizedConvolution layer computes the same function as a Convolution
+ * layer, but holds the filters as signed 8-bit integers, with one scale for
+ * each output map.  In the forward pass, the (padded) input is quantized to
+ * unsigned 8-bit integers with one scale and zero point for the whole batch,
+ * lowered into columns like Im2ColConvolution does, and multiplied with the
+ * filters with 32-bit integer accumulation; the bias is kept in full
+ * precision.
+ *
+ * The layer is only meant for inference: it has no trainable weights, and
+ * Backward() throws an exception.  It is normally created from a trained
+ * network with `FFN::Quantize()`.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class QuantizedConvolutionType : public Layer<MatType>
+{
+ public:
+  typedef typename GetCubeType<MatType>::type CubeType;
+
+  //! Create an empty QuantizedConvolution layer.
+  QuantizedConvolutionType();
+
+  /**
+   * Create the QuantizedConvolution layer by quantizing the given filters.
+   * The filter of output map `o` and input map `i` is `weight.slice(o *
+   * inMaps + i)`, like in the Convolution layer.
+   *
+   * @param weight Filters of the convolution layer.
+   * @param bias Bias of each output map, or an empty matrix for no bias.
+   * @param maps Number of output maps.
+   * @param strideWidth Stride of filter application in the x direction.
+   * @param strideHeight Stride of filter application in the y direction.
+   * @param padWLeft Left padding width of the input.
+   * @param padWRight Right padding width of the input.
+   * @param padHTop Top padding height of the input.
+   * @param padHBottom Bottom padding height of the input.
+   */
+  QuantizedConvolutionType(const CubeType& weight,
+                           const MatType& bias,
+                           const size_t maps,
+                           const size_t strideWidth,
+                           const size_t strideHeight,
+                           const size_t padWLeft,
+                           const size_t padWRight,
+                           const size_t padHTop,
+                           const size_t padHBottom);
+
+  virtual ~QuantizedConvolutionType() { }
+
+  //! Clone the QuantizedConvolutionType object. This handles polymorphism
+  //! correctly.
+  QuantizedConvolutionType* Clone() const
+  {
+    return new QuantizedConvolutionType(*this);
+  }
+
+  //! Copy the other QuantizedConvolution layer.
+  QuantizedConvolutionType(const QuantizedConvolutionType& layer);
+  //! Take ownership of the members of the other QuantizedConvolution layer.
+  QuantizedConvolutionType(QuantizedConvolutionType&& layer);
+  //! Copy the other QuantizedConvolution layer.
+  QuantizedConvolutionType& operator=(const QuantizedConvolutionType& layer);
+  //! Take ownership of the members of the other QuantizedConvolution layer.
+  QuantizedConvolutionType& operator=(QuantizedConvolutionType&& layer);
+
+  /**
+   * Forward pass: convolve the input with the quantized filters.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * The QuantizedConvolution layer cannot be trained; this throws a
+   * std::logic_error.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& /* gy */,
+                MatType& /* g */);
+
+  //! Get the quantized filters (one column for each output map).
+  const arma::Mat<int8_t>& Weight() const { return weight; }
+  //! Get the scale of the filters of each output map.
+  const MatType& Scales() const { return scales; }
+  //! Get the bias (empty if the layer has no bias).
+  const MatType& Bias() const { return bias; }
+
+  //! Get the number of output maps.
+  size_t Maps() const { return maps; }
+
+  //! Compute the output dimensions of the layer given `InputDimensions()`.
+  void ComputeOutputDimensions();
+
+  //! Serialize the layer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of output maps.
+  size_t maps;
+  //! Locally-stored number of input maps.
+  size_t inMaps;
+  //! Locally-stored filter width.
+  size_t kernelWidth;
+  //! Locally-stored filter height.
+  size_t kernelHeight;
+  //! Locally-stored stride of the filter in the x direction.
+  size_t strideWidth;
+  //! Locally-stored stride of the filter in the y direction.
+  size_t strideHeight;
+  //! Locally-stored left padding width.
+  size_t padWLeft;
+  //! Locally-stored right padding width.
+  size_t padWRight;
+  //! Locally-stored top padding height.
+  size_t padHTop;
+  //! Locally-stored bottom padding height.
+  size_t padHBottom;
+  //! Product of the input dimensions above the third.
+  size_t higherInDimensions;
+
+  //! The quantized filters, one column for each output map.
+  arma::Mat<int8_t> weight;
+  //! The scale of the filters of each output map.
+  MatType scales;
+  //! The sum of the quantized filters of each output map.
+  arma::Col<int32_t> sums;
+  //! The bias of each output map (empty if there is no bias).
+  MatType bias;
+
+  //! Locally-stored padding layer.
+  PaddingType<MatType> padding;
+
+  //! Workspace for the padded input.
+  MatType inputPadded;
+  //! Workspace for the quantized input.
+  arma::Cube<uint8_t> quantizedInput;
+  //! Workspace for the lowered quantized input.
+  arma::Mat<uint8_t> columns;
+  //! Workspace for the output, one column for each output map.
+  MatType product;
+}; // class QuantizedConvolutionType
+
+// Convenience typedefs.
+
+// Standard quantized convolution layer.
+typedef QuantizedConvolutionType<arma::mat> QuantizedConvolution;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_convolution_impl.hpp"
+
+#endif
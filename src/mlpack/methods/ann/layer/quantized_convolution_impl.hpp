@@ -0,0 +1,301 @@
+/**
+ * @file methods/ann/layer/quantized_convolution_impl.hpp
+ *
+ * Implementation of the QuantizedConvolution layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_convolution.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+QuantizedConvolutionType<MatType>::QuantizedConvolutionType() :
+    Layer<MatType>(),
+    maps(0),
+    inMaps(0),
+    kernelWidth(0),
+    kernelHeight(0),
+    strideWidth(1),
+    strideHeight(1),
+    padWLeft(0),
+    padWRight(0),
+    padHTop(0),
+    padHBottom(0),
+    higherInDimensions(1)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+QuantizedConvolutionType<MatType>::QuantizedConvolutionType(
+    const CubeType& weight,
+    const MatType& bias,
+    const size_t maps,
+    const size_t strideWidth,
+    const size_t strideHeight,
+    const size_t padWLeft,
+    const size_t padWRight,
+    const size_t padHTop,
+    const size_t padHBottom) :
+    Layer<MatType>(),
+    maps(maps),
+    inMaps(weight.n_slices / maps),
+    kernelWidth(weight.n_rows),
+    kernelHeight(weight.n_cols),
+    strideWidth(strideWidth),
+    strideHeight(strideHeight),
+    padWLeft(padWLeft),
+    padWRight(padWRight),
+    padHTop(padHTop),
+    padHBottom(padHBottom),
+    higherInDimensions(1),
+    bias(bias)
+{
+  // The filters of each output map are stored one after another, so each
+  // column of this matrix holds the filters of one output map, in the order
+  // that Im2ColConvolution::Im2Col() lowers the input in.
+  const MatType filters(const_cast<CubeType&>(weight).memptr(),
+      kernelWidth * kernelHeight * inMaps, maps, false, true);
+  QuantizeWeights(filters, this->weight, scales, sums);
+}
+
+template<typename MatType>
+QuantizedConvolutionType<MatType>::QuantizedConvolutionType(
+    const QuantizedConvolutionType& layer) :
+    Layer<MatType>(layer),
+    maps(layer.maps),
+    inMaps(layer.inMaps),
+    kernelWidth(layer.kernelWidth),
+    kernelHeight(layer.kernelHeight),
+    strideWidth(layer.strideWidth),
+    strideHeight(layer.strideHeight),
+    padWLeft(layer.padWLeft),
+    padWRight(layer.padWRight),
+    padHTop(layer.padHTop),
+    padHBottom(layer.padHBottom),
+    higherInDimensions(layer.higherInDimensions),
+    weight(layer.weight),
+    scales(layer.scales),
+    sums(layer.sums),
+    bias(layer.bias),
+    padding(layer.padding)
+{
+  // Nothing else to do.
+}
+
+template<typename MatType>
+QuantizedConvolutionType<MatType>::QuantizedConvolutionType(
+    QuantizedConvolutionType&& layer) :
+    Layer<MatType>(std::move(layer)),
+    maps(std::move(layer.maps)),
+    inMaps(std::move(layer.inMaps)),
+    kernelWidth(std::move(layer.kernelWidth)),
+    kernelHeight(std::move(layer.kernelHeight)),
+    strideWidth(std::move(layer.strideWidth)),
+    strideHeight(std::move(layer.strideHeight)),
+    padWLeft(std::move(layer.padWLeft)),
+    padWRight(std::move(layer.padWRight)),
+    padHTop(std::move(layer.padHTop)),
+    padHBottom(std::move(layer.padHBottom)),
+    higherInDimensions(std::move(layer.higherInDimensions)),
+    weight(std::move(layer.weight)),
+    scales(std::move(layer.scales)),
+    sums(std::move(layer.sums)),
+    bias(std::move(layer.bias)),
+    padding(std::move(layer.padding))
+{
+  // Nothing else to do.
+}
+
+template<typename MatType>
+QuantizedConvolutionType<MatType>&
+QuantizedConvolutionType<MatType>::operator=(
+    const QuantizedConvolutionType& layer)
+{
+  if (&layer != this)
+  {
+    Layer<MatType>::operator=(layer);
+    maps = layer.maps;
+    inMaps = layer.inMaps;
+    kernelWidth = layer.kernelWidth;
+    kernelHeight = layer.kernelHeight;
+    strideWidth = layer.strideWidth;
+    strideHeight = layer.strideHeight;
+    padWLeft = layer.padWLeft;
+    padWRight = layer.padWRight;
+    padHTop = layer.padHTop;
+    padHBottom = layer.padHBottom;
+    higherInDimensions = layer.higherInDimensions;
+    weight = layer.weight;
+    scales = layer.scales;
+    sums = layer.sums;
+    bias = layer.bias;
+    padding = layer.padding;
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+QuantizedConvolutionType<MatType>&
+QuantizedConvolutionType<MatType>::operator=(QuantizedConvolutionType&& layer)
+{
+  if (&layer != this)
+  {
+    Layer<MatType>::operator=(std::move(layer));
+    maps = std::move(layer.maps);
+    inMaps = std::move(layer.inMaps);
+    kernelWidth = std::move(layer.kernelWidth);
+    kernelHeight = std::move(layer.kernelHeight);
+    strideWidth = std::move(layer.strideWidth);
+    strideHeight = std::move(layer.strideHeight);
+    padWLeft = std::move(layer.padWLeft);
+    padWRight = std::move(layer.padWRight);
+    padHTop = std::move(layer.padHTop);
+    padHBottom = std::move(layer.padHBottom);
+    higherInDimensions = std::move(layer.higherInDimensions);
+    weight = std::move(layer.weight);
+    scales = std::move(layer.scales);
+    sums = std::move(layer.sums);
+    bias = std::move(layer.bias);
+    padding = std::move(layer.padding);
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+void QuantizedConvolutionType<MatType>::Forward(const MatType& input,
+                                                MatType& output)
+{
+  const size_t batchSize = input.n_cols;
+
+  // First, perform any padding if necessary.  Zero is represented exactly by
+  // the quantized input, so the input can be padded before it is quantized.
+  const bool usingPadding =
+      (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0);
+  const size_t paddedRows = this->inputDimensions[0] + padWLeft + padWRight;
+  const size_t paddedCols = this->inputDimensions[1] + padHTop + padHBottom;
+  if (usingPadding)
+  {
+    inputPadded.set_size(paddedRows * paddedCols * inMaps * higherInDimensions,
+        batchSize);
+    padding.Forward(input, inputPadded);
+  }
+
+  typename MatType::elem_type inputScale;
+  int32_t zeroPoint;
+  quantizedInput.set_size(paddedRows, paddedCols,
+      inMaps * higherInDimensions * batchSize);
+  QuantizeActivations(usingPadding ? inputPadded : input,
+      quantizedInput.memptr(), inputScale, zeroPoint);
+
+  const size_t outputRows = this->outputDimensions[0];
+  const size_t outputCols = this->outputDimensions[1];
+  Im2ColConvolution<ValidConvolution>::Im2Col(quantizedInput, inMaps, 0,
+      inMaps, kernelWidth, kernelHeight, outputRows, outputCols, strideWidth,
+      strideHeight, columns);
+
+  // Each row of the product holds one output element of all the maps.
+  product.set_size(columns.n_cols, maps);
+  QuantizedMultiply(weight, scales, sums, bias, columns, inputScale, zeroPoint,
+      product.memptr(), product.n_rows, 1);
+
+  // Copy each output map of each point to the output.
+  const size_t mapSize = outputRows * outputCols;
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t p = 0; p < higherInDimensions * batchSize; ++p)
+  {
+    for (size_t outMap = 0; outMap < maps; ++outMap)
+    {
+      const typename MatType::elem_type* productPtr =
+          product.colptr(outMap) + p * mapSize;
+      std::copy(productPtr, productPtr + mapSize,
+          output.memptr() + (p * maps + outMap) * mapSize);
+    }
+  }
+}
+
+template<typename MatType>
+void QuantizedConvolutionType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& /* output */,
+    const MatType& /* gy */,
+    MatType& /* g */)
+{
+  throw std::logic_error("QuantizedConvolution::Backward(): quantized layers "
+      "can only be used for inference!");
+}
+
+template<typename MatType>
+void QuantizedConvolutionType<MatType>::ComputeOutputDimensions()
+{
+  const size_t inputMaps = (this->inputDimensions.size() >= 3) ?
+      this->inputDimensions[2] : 1;
+  if (inputMaps != inMaps)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedConvolution::ComputeOutputDimensions(): input has "
+        << inputMaps << " maps, but the layer was quantized for " << inMaps
+        << " input maps!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  padding = PaddingType<MatType>(padWLeft, padWRight, padHTop, padHBottom);
+  padding.InputDimensions() = this->inputDimensions;
+  padding.ComputeOutputDimensions();
+
+  // The output has the same dimensions as that of the Convolution layer.
+  this->outputDimensions = std::vector<size_t>(
+      std::max(this->inputDimensions.size(), size_t(3)), 1);
+  this->outputDimensions[0] = (this->inputDimensions[0] + padWLeft +
+      padWRight - kernelWidth) / strideWidth + 1;
+  this->outputDimensions[1] = (this->inputDimensions[1] + padHTop +
+      padHBottom - kernelHeight) / strideHeight + 1;
+
+  higherInDimensions = 1;
+  for (size_t i = 3; i < this->inputDimensions.size(); ++i)
+  {
+    higherInDimensions *= this->inputDimensions[i];
+    this->outputDimensions[i] = this->inputDimensions[i];
+  }
+
+  this->outputDimensions[2] = maps;
+}
+
+template<typename MatType>
+template<typename Archive>
+void QuantizedConvolutionType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(maps));
+  ar(CEREAL_NVP(inMaps));
+  ar(CEREAL_NVP(kernelWidth));
+  ar(CEREAL_NVP(kernelHeight));
+  ar(CEREAL_NVP(strideWidth));
+  ar(CEREAL_NVP(strideHeight));
+  ar(CEREAL_NVP(padWLeft));
+  ar(CEREAL_NVP(padWRight));
+  ar(CEREAL_NVP(padHTop));
+  ar(CEREAL_NVP(padHBottom));
+  ar(CEREAL_NVP(higherInDimensions));
+  ar(CEREAL_NVP(padding));
+  ar(CEREAL_NVP(weight));
+  ar(CEREAL_NVP(scales));
+  ar(CEREAL_NVP(sums));
+  ar(CEREAL_NVP(bias));
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @file methods/ann/layer/quantized_linear.hpp
+ *
+ * Definition of the QuantizedLinear layer, an inference-only linear layer with
+ * 8-bit quantized weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/quantization.hpp>
+
+#include "layer.hpp"
+
+namespace mlpack {
+
+/**
+ * The QuantizedLinear layer computes the same function as a Linear (or
+ * LinearNoBias) layer, y = Ax + b, but holds the weights A as signed 8-bit
+ * integers, with one scale for each output unit.  In the forward pass, the
+ * input is quantized to unsigned 8-bit integers (with one scale and zero point
+ * for the whole batch), the product is computed with 32-bit integer
+ * accumulation, and the result is scaled back; the bias is kept in full
+ * precision.  The weights take 8 times less memory than with `arma::mat`.
+ *
+ * The layer is only meant for inference: it has no trainable weights, and
+ * Backward() throws an exception.  It is normally created from a trained
+ * network with `FFN::Quantize()`.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class QuantizedLinearType : public Layer<MatType>
+{
+ public:
+  //! Create an empty QuantizedLinear layer.
+  QuantizedLinearType();
+
+  /**
+   * Create the QuantizedLinear layer by quantizing the given weights.
+   *
+   * @param weight Weights of the linear layer (output units x input units).
+   * @param bias Bias of each output unit, or an empty matrix for no bias.
+   */
+  QuantizedLinearType(const MatType& weight, const MatType& bias);
+
+  virtual ~QuantizedLinearType() { }
+
+  //! Clone the QuantizedLinearType object. This handles polymorphism correctly.
+  QuantizedLinearType* Clone() const { return new QuantizedLinearType(*this); }
+
+  //! Copy the other QuantizedLinear layer.
+  QuantizedLinearType(const QuantizedLinearType& layer);
+  //! Take ownership of the members of the other QuantizedLinear layer.
+  QuantizedLinearType(QuantizedLinearType&& layer);
+  //! Copy the other QuantizedLinear layer.
+  QuantizedLinearType& operator=(const QuantizedLinearType& layer);
+  //! Take ownership of the members of the other QuantizedLinear layer.
+  QuantizedLinearType& operator=(QuantizedLinearType&& layer);
+
+  /**
+   * Forward pass: compute Ax + b with the quantized weights.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * The QuantizedLinear layer cannot be trained; this throws a
+   * std::logic_error.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& /* gy */,
+                MatType& /* g */);
+
+  //! Get the quantized weights (one column for each output unit).
+  const arma::Mat<int8_t>& Weight() const { return weight; }
+  //! Get the scale of the weights of each output unit.
+  const MatType& Scales() const { return scales; }
+  //! Get the bias (empty if the layer has no bias).
+  const MatType& Bias() const { return bias; }
+
+  //! Compute the output dimensions of the layer given `InputDimensions()`.
+  void ComputeOutputDimensions();
+
+  //! Serialize the layer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! The quantized weights, one column for each output unit.
+  arma::Mat<int8_t> weight;
+
+  //! The scale of the weights of each output unit.
+  MatType scales;
+
+  //! The sum of the quantized weights of each output unit.
+  arma::Col<int32_t> sums;
+
+  //! The bias of each output unit (empty if there is no bias).
+  MatType bias;
+
+  //! Workspace for the quantized input.
+  arma::Mat<uint8_t> quantizedInput;
+}; // class QuantizedLinearType
+
+// Convenience typedefs.
+
+// Standard quantized linear layer.
+typedef QuantizedLinearType<arma::mat> QuantizedLinear;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_linear_impl.hpp"
+
+#endif
@@ -0,0 +1,170 @@
+/**
+ * @file methods/ann/layer/quantized_linear_impl.hpp
+ *
+ * Implementation of the QuantizedLinear layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_linear.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+QuantizedLinearType<MatType>::QuantizedLinearType() :
+    Layer<MatType>(),
+    inSize(0),
+    outSize(0)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+QuantizedLinearType<MatType>::QuantizedLinearType(const MatType& weight,
+                                                  const MatType& bias) :
+    Layer<MatType>(),
+    inSize(weight.n_cols),
+    outSize(weight.n_rows),
+    bias(bias)
+{
+  // Each column of the quantized weights holds the weights of one output unit,
+  // so that they are contiguous for the dot products of the forward pass.
+  QuantizeWeights(MatType(weight.t()), this->weight, scales, sums);
+}
+
+template<typename MatType>
+QuantizedLinearType<MatType>::QuantizedLinearType(
+    const QuantizedLinearType& layer) :
+    Layer<MatType>(layer),
+    inSize(layer.inSize),
+    outSize(layer.outSize),
+    weight(layer.weight),
+    scales(layer.scales),
+    sums(layer.sums),
+    bias(layer.bias)
+{
+  // Nothing else to do.
+}
+
+template<typename MatType>
+QuantizedLinearType<MatType>::QuantizedLinearType(
+    QuantizedLinearType&& layer) :
+    Layer<MatType>(std::move(layer)),
+    inSize(std::move(layer.inSize)),
+    outSize(std::move(layer.outSize)),
+    weight(std::move(layer.weight)),
+    scales(std::move(layer.scales)),
+    sums(std::move(layer.sums)),
+    bias(std::move(layer.bias))
+{
+  // Nothing else to do.
+}
+
+template<typename MatType>
+QuantizedLinearType<MatType>&
+QuantizedLinearType<MatType>::operator=(const QuantizedLinearType& layer)
+{
+  if (&layer != this)
+  {
+    Layer<MatType>::operator=(layer);
+    inSize = layer.inSize;
+    outSize = layer.outSize;
+    weight = layer.weight;
+    scales = layer.scales;
+    sums = layer.sums;
+    bias = layer.bias;
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+QuantizedLinearType<MatType>&
+QuantizedLinearType<MatType>::operator=(QuantizedLinearType&& layer)
+{
+  if (&layer != this)
+  {
+    Layer<MatType>::operator=(std::move(layer));
+    inSize = std::move(layer.inSize);
+    outSize = std::move(layer.outSize);
+    weight = std::move(layer.weight);
+    scales = std::move(layer.scales);
+    sums = std::move(layer.sums);
+    bias = std::move(layer.bias);
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+void QuantizedLinearType<MatType>::Forward(const MatType& input,
+                                           MatType& output)
+{
+  typename MatType::elem_type inputScale;
+  int32_t zeroPoint;
+  quantizedInput.set_size(input.n_rows, input.n_cols);
+  QuantizeActivations(input, quantizedInput.memptr(), inputScale, zeroPoint);
+
+  // The output of each point is stored in one column.
+  QuantizedMultiply(weight, scales, sums, bias, quantizedInput, inputScale,
+      zeroPoint, output.memptr(), 1, outSize);
+}
+
+template<typename MatType>
+void QuantizedLinearType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& /* output */,
+    const MatType& /* gy */,
+    MatType& /* g */)
+{
+  throw std::logic_error("QuantizedLinear::Backward(): quantized layers can "
+      "only be used for inference!");
+}
+
+template<typename MatType>
+void QuantizedLinearType<MatType>::ComputeOutputDimensions()
+{
+  size_t totalInputSize = this->inputDimensions[0];
+  for (size_t i = 1; i < this->inputDimensions.size(); ++i)
+    totalInputSize *= this->inputDimensions[i];
+
+  if (totalInputSize != inSize)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedLinear::ComputeOutputDimensions(): input has "
+        << totalInputSize << " elements, but the layer was quantized for "
+        << inSize << " inputs!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  this->outputDimensions = std::vector<size_t>(this->inputDimensions.size(),
+      1);
+
+  // The QuantizedLinear layer flattens its input, like the Linear layer.
+  this->outputDimensions[0] = outSize;
+}
+
+template<typename MatType>
+template<typename Archive>
+void QuantizedLinearType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+  ar(CEREAL_NVP(weight));
+  ar(CEREAL_NVP(scales));
+  ar(CEREAL_NVP(sums));
+  ar(CEREAL_NVP(bias));
+}
+
+} // namespace mlpack
+
+#endif
@@ -80,6 +80,25 @@ class RecurrentLayer : public Layer<MatType>
   //! enclosing network.)
   size_t& PreviousStep() { return previousStep; }
 
+  /**
+   * PrepareSequence() is called after ClearRecurrentState() when the layer is
+   * the first layer of a recurrent network, whose inputs for every step are
+   * known before the first step.  `inputs` holds the inputs of all the steps,
+   * packed as in `PackedSequences`: the input of each step is the block of
+   * columns starting at the `SequenceOffset()` that the network sets before
+   * each forward pass.  A layer can use this to apply its input weights to all
+   * the steps with one matrix product, instead of one product for each step.
+   * By default, nothing is done.
+   */
+  virtual void PrepareSequence(const MatType& /* inputs */) { }
+
+  //! Get the first column of the current step in the inputs given to
+  //! PrepareSequence(), or size_t(-1) if PrepareSequence() was not called.
+  size_t SequenceOffset() const { return sequenceOffset; }
+  //! Modify the first column of the current step in the inputs given to
+  //! PrepareSequence().  (This is meant to be done by the enclosing network.)
+  size_t& SequenceOffset() { return sequenceOffset; }
+
   //! If Forward() or Backward() has been called since ClearRecurrentState(),
   //! this will return true.  This should be used to determine if recurrent
   //! state should be considered in computations.
@@ -96,6 +115,9 @@ class RecurrentLayer : public Layer<MatType>
   //! The previous index of the step.  This is set by the enclosing network
   //! during forward and backward passes.
   size_t previousStep;
+  //! The first column of the current step in the inputs given to
+  //! PrepareSequence().  This is set by the enclosing network.
+  size_t sequenceOffset;
 };
 
 } // namespace mlpack
@@ -21,21 +21,24 @@ template<typename MatType>
 RecurrentLayer<MatType>::RecurrentLayer() :
     Layer<MatType>(),
     currentStep(0),
-    previousStep(0)
+    previousStep(0),
+    sequenceOffset(size_t(-1))
 { /* Nothing to do. */ }
 
 template<typename MatType>
 RecurrentLayer<MatType>::RecurrentLayer(const RecurrentLayer& other) :
     Layer<MatType>(other),
     currentStep(other.currentStep),
-    previousStep(other.previousStep)
+    previousStep(other.previousStep),
+    sequenceOffset(other.sequenceOffset)
 { /* Nothing else to do. */ }
 
 template<typename MatType>
 RecurrentLayer<MatType>::RecurrentLayer(RecurrentLayer&& other) :
     Layer<MatType>(std::move(other)),
     currentStep(std::move(other.currentStep)),
-    previousStep(std::move(other.previousStep))
+    previousStep(std::move(other.previousStep)),
+    sequenceOffset(std::move(other.sequenceOffset))
 { /* Nothing else to do. */ }
 
 template<typename MatType>
@@ -47,6 +50,7 @@ RecurrentLayer<MatType>::operator=(const RecurrentLayer& other)
     Layer<MatType>::operator=(other);
     currentStep = other.currentStep;
     previousStep = other.previousStep;
+    sequenceOffset = other.sequenceOffset;
   }
 
   return *this;
@@ -61,6 +65,7 @@ RecurrentLayer<MatType>::operator=(RecurrentLayer&& other)
     Layer<MatType>::operator=(std::move(other));
     currentStep = std::move(other.currentStep);
     previousStep = std::move(other.previousStep);
+    sequenceOffset = std::move(other.sequenceOffset);
   }
 
   return *this;
@@ -75,6 +80,10 @@ void RecurrentLayer<MatType>::serialize(
 
   ar(CEREAL_NVP(currentStep));
   ar(CEREAL_NVP(previousStep));
+
+  // The offset is only meaningful during a pass over a sequence.
+  if (cereal::is_loading<Archive>())
+    sequenceOffset = size_t(-1);
 }
 
 } // namespace mlpack
@@ -0,0 +1,399 @@
+/**
+ * @file methods/ann/layer/separable_convolution.hpp
+ *
+ * Definition of the SeparableConvolution layer, a depthwise convolution
+ * followed by a pointwise (1x1) convolution.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_SEPARABLE_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_LAYER_SEPARABLE_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/methods/ann/convolution_rules/depthwise_convolution.hpp>
+#include <mlpack/core/util/to_lower.hpp>
+
+#include "layer.hpp"
+#include "padding.hpp"
+
+namespace mlpack {
+
+/**
+ * Implementation of the depthwise-separable convolution layer, the building
+ * block of MobileNet-style networks.  Each input map is first convolved with
+ * `multiplier` filters of its own (a depthwise convolution, like a
+ * GroupedConvolution with as many groups as input maps, but without a bias);
+ * then each output map is a weighted sum of all the maps given by the
+ * depthwise convolution, plus a bias (a pointwise, or 1x1, convolution).  This
+ * needs far fewer weights and operations than a Convolution with the same
+ * number of output maps.
+ *
+ * Both convolutions are computed point by point, so that the maps given by
+ * the depthwise convolution of a point are still in the cache when they are
+ * multiplied with the pointwise weights.  The depthwise convolution is
+ * computed with DepthwiseConvolution.
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @article{howard2017mobilenets,
+ *   title = {MobileNets: Efficient Convolutional Neural Networks for Mobile
+ *       Vision Applications},
+ *   author = {Howard, Andrew G. and Zhu, Menglong and Chen, Bo and
+ *       Kalenichenko, Dmitry and Wang, Weijun and Weyand, Tobias and
+ *       Andreetto, Marco and Adam, Hartwig},
+ *   journal = {arXiv preprint arXiv:1704.04861},
+ *   year = {2017}
+ * }
+ * @endcode
+ *
+ * The weights are stored as the depthwise filters (`kernelWidth` x
+ * `kernelHeight` for each of the `inMaps * multiplier` depthwise maps), then
+ * the pointwise weights (an `(inMaps * multiplier)` x `maps` matrix), then the
+ * bias.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class SeparableConvolutionType : public Layer<MatType>
+{
+ public:
+  typedef typename GetCubeType<MatType>::type CubeType;
+
+  //! Create the SeparableConvolutionType object.
+  SeparableConvolutionType();
+
+  /**
+   * Create the SeparableConvolutionType object using the specified number of
+   * output maps, filter size, depth multiplier, stride and padding parameter.
+   *
+   * @param maps The number of output maps.
+   * @param kernelWidth Width of the depthwise filters.
+   * @param kernelHeight Height of the depthwise filters.
+   * @param multiplier Number of depthwise filters for each input map.
+   * @param strideWidth Stride of filter application in the x direction.
+   * @param strideHeight Stride of filter application in the y direction.
+   * @param padW Padding width of the input.
+   * @param padH Padding height of the input.
+   * @param paddingType The type of padding ("valid" or "same"). Defaults to
+   *    "none".  If not specified or "none", the values for `padW` and `padH`
+   *    will be used.
+   * @param useBias Whether or not to use a bias with the convolution.
+   */
+  SeparableConvolutionType(const size_t maps,
+                           const size_t kernelWidth,
+                           const size_t kernelHeight,
+                           const size_t multiplier = 1,
+                           const size_t strideWidth = 1,
+                           const size_t strideHeight = 1,
+                           const size_t padW = 0,
+                           const size_t padH = 0,
+                           const std::string& paddingType = "none",
+                           const bool useBias = true);
+
+  /**
+   * Create the SeparableConvolutionType object using the specified number of
+   * output maps, filter size, depth multiplier, stride and padding parameter.
+   *
+   * @param maps The number of output maps.
+   * @param kernelWidth Width of the depthwise filters.
+   * @param kernelHeight Height of the depthwise filters.
+   * @param multiplier Number of depthwise filters for each input map.
+   * @param strideWidth Stride of filter application in the x direction.
+   * @param strideHeight Stride of filter application in the y direction.
+   * @param padW A two-value tuple indicating padding widths of the input.  The
+   *      first value is the padding for the left side; the second value is the
+   *      padding on the right side.
+   * @param padH A two-value tuple indicating padding heights of the input.  The
+   *      first value is the padding for the top; the second value is the
+   *      padding on the bottom.
+   * @param paddingType The type of padding ("valid" or "same"). Defaults to
+   *      "none".  If not specified or "none", the values for `padW` and `padH`
+   *      will be used.
+   * @param useBias Whether or not to use a bias with the convolution.
+   */
+  SeparableConvolutionType(const size_t maps,
+                           const size_t kernelWidth,
+                           const size_t kernelHeight,
+                           const size_t multiplier,
+                           const size_t strideWidth,
+                           const size_t strideHeight,
+                           const std::tuple<size_t, size_t>& padW,
+                           const std::tuple<size_t, size_t>& padH,
+                           const std::string& paddingType = "none",
+                           const bool useBias = true);
+
+  //! Clone the SeparableConvolutionType object. This handles polymorphism
+  //! correctly.
+  SeparableConvolutionType* Clone() const
+  {
+    return new SeparableConvolutionType(*this);
+  }
+
+  //! Copy the given SeparableConvolutionType (but not weights).
+  SeparableConvolutionType(const SeparableConvolutionType& layer);
+
+  //! Take ownership of the given SeparableConvolutionType (but not weights).
+  SeparableConvolutionType(SeparableConvolutionType&&);
+
+  //! Copy the given SeparableConvolutionType (but not weights).
+  SeparableConvolutionType& operator=(const SeparableConvolutionType& layer);
+
+  //! Take ownership of the given SeparableConvolutionType (but not weights).
+  SeparableConvolutionType& operator=(SeparableConvolutionType&& layer);
+
+  // Virtual destructor.
+  virtual ~SeparableConvolutionType() { }
+
+  /*
+   * Set the weight and bias term.
+   */
+  void SetWeights(typename MatType::elem_type* weightsPtr);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards through f. Using the results from the feed
+   * forward pass.
+   *
+   * @param input The input data (x) given to the forward pass.
+   * @param output The propagated data (f(x)) resulting from Forward()
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& gy,
+                MatType& g);
+
+  /**
+   * Calculate the gradient using the output delta and the input activation.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  void Gradient(const MatType& input,
+                const MatType& error,
+                MatType& gradient);
+
+  //! Get an estimate of the number of floating-point operations of a forward
+  //! pass for each point.
+  size_t ForwardFlops()
+  {
+    const std::vector<size_t>& dims = this->OutputDimensions();
+    return 2 * (kernelWidth * kernelHeight + maps) * inMaps * multiplier *
+        dims[0] * dims[1] * higherInDimensions + this->OutputSize();
+  }
+
+  //! Get the parameters.
+  MatType const& Parameters() const { return weights; }
+  //! Modify the parameters.
+  MatType& Parameters() { return weights; }
+
+  //! Get the depthwise filters of the layer, one slice for each depthwise
+  //! map.
+  CubeType const& DepthwiseWeight() const { return depthwiseWeight; }
+  //! Modify the depthwise filters of the layer.
+  CubeType& DepthwiseWeight() { return depthwiseWeight; }
+
+  //! Get the pointwise weights of the layer, one column for each output map.
+  MatType const& PointwiseWeight() const { return pointwiseWeight; }
+  //! Modify the pointwise weights of the layer.
+  MatType& PointwiseWeight() { return pointwiseWeight; }
+
+  //! Get the bias of the layer.
+  MatType const& Bias() const { return bias; }
+  //! Modify the bias of the layer.
+  MatType& Bias() { return bias; }
+
+  //! Get the number of output maps.
+  size_t const& Maps() const { return maps; }
+
+  //! Get the kernel width.
+  size_t const& KernelWidth() const { return kernelWidth; }
+  //! Modify the kernel width.
+  size_t& KernelWidth() { return kernelWidth; }
+
+  //! Get the kernel height.
+  size_t const& KernelHeight() const { return kernelHeight; }
+  //! Modify the kernel height.
+  size_t& KernelHeight() { return kernelHeight; }
+
+  //! Get the number of depthwise filters for each input map.
+  size_t const& Multiplier() const { return multiplier; }
+  //! Modify the number of depthwise filters for each input map.
+  size_t& Multiplier() { return multiplier; }
+
+  //! Get the stride width.
+  size_t const& StrideWidth() const { return strideWidth; }
+  //! Modify the stride width.
+  size_t& StrideWidth() { return strideWidth; }
+
+  //! Get the stride height.
+  size_t const& StrideHeight() const { return strideHeight; }
+  //! Modify the stride height.
+  size_t& StrideHeight() { return strideHeight; }
+
+  //! Get the top padding height.
+  size_t const& PadHTop() const { return padHTop; }
+  //! Modify the top padding height.
+  size_t& PadHTop() { return padHTop; }
+
+  //! Get the bottom padding height.
+  size_t const& PadHBottom() const { return padHBottom; }
+  //! Modify the bottom padding height.
+  size_t& PadHBottom() { return padHBottom; }
+
+  //! Get the left padding width.
+  size_t const& PadWLeft() const { return padWLeft; }
+  //! Modify the left padding width.
+  size_t& PadWLeft() { return padWLeft; }
+
+  //! Get the right padding width.
+  size_t const& PadWRight() const { return padWRight; }
+  //! Modify the right padding width.
+  size_t& PadWRight() { return padWRight; }
+
+  //! Get size of weights for the layer.
+  size_t WeightSize() const
+  {
+    return inMaps * multiplier * (kernelWidth * kernelHeight + maps) +
+        (useBias ? maps : 0);
+  }
+
+  //! Compute the output dimensions of the layer based on `InputDimensions()`.
+  void ComputeOutputDimensions();
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Return the convolution output size.
+   *
+   * @param size The size of the input (row or column).
+   * @param k The size of the filter (width or height).
+   * @param s The stride size (x or y direction).
+   * @param pSideOne The size of the padding (width or height) on one side.
+   * @param pSideTwo The size of the padding (width or height) on another side.
+   * @return The convolution output size.
+   */
+  size_t ConvOutSize(const size_t size,
+                     const size_t k,
+                     const size_t s,
+                     const size_t pSideOne,
+                     const size_t pSideTwo)
+  {
+    return std::floor(size + pSideOne + pSideTwo - k) / s + 1;
+  }
+
+  /**
+   * Function to assign padding such that output size is same as input size.
+   */
+  void InitializeSamePadding();
+
+  /**
+   * Compute the error of the depthwise maps from the error of the output
+   * maps, for all points.
+   *
+   * @param error The error of the output maps.
+   * @param depthwiseError The error of the depthwise maps.
+   */
+  void DepthwiseError(const MatType& error, MatType& depthwiseError);
+
+  //! Locally-stored number of output channels.
+  size_t maps;
+
+  //! Locally-stored number of input units.
+  size_t batchSize;
+
+  //! Locally-stored filter/kernel width.
+  size_t kernelWidth;
+
+  //! Locally-stored filter/kernel height.
+  size_t kernelHeight;
+
+  //! Locally-stored number of depthwise filters for each input map.
+  size_t multiplier;
+
+  //! Locally-stored stride of the filter in x-direction.
+  size_t strideWidth;
+
+  //! Locally-stored stride of the filter in y-direction.
+  size_t strideHeight;
+
+  //! Locally-stored left-side padding width.
+  size_t padWLeft;
+
+  //! Locally-stored right-side padding width.
+  size_t padWRight;
+
+  //! Locally-stored bottom padding height.
+  size_t padHBottom;
+
+  //! Locally-stored top padding height.
+  size_t padHTop;
+
+  //! Locally-stored variable to indicate whether biases should be added.
+  bool useBias;
+
+  //! Locally-stored weight object.
+  MatType weights;
+
+  //! Locally-stored depthwise filters.
+  CubeType depthwiseWeight;
+
+  //! Locally-stored pointwise weights.
+  MatType pointwiseWeight;
+
+  //! Locally-stored bias term object.
+  MatType bias;
+
+  //! Locally-stored transformed padded input parameter.
+  MatType inputPadded;
+
+  //! The maps given by the depthwise convolution in Forward(), one column for
+  //! each point (not copied or serialized).
+  MatType depthwiseOutput;
+
+  //! Workspace for the padded error in Backward().
+  CubeType paddedError;
+
+  //! Locally-stored padding layer.
+  PaddingType<MatType> padding;
+
+  //! Type of padding.
+  std::string paddingType;
+
+  //! Locally-cached number of input maps.
+  size_t inMaps;
+  //! Locally-cached higher-order input dimensions.
+  size_t higherInDimensions;
+}; // class SeparableConvolutionType
+
+// Standard SeparableConvolution layer.
+typedef SeparableConvolutionType<arma::mat> SeparableConvolution;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "separable_convolution_impl.hpp"
+
+#endif
@@ -0,0 +1,459 @@
+/**
+ * @file methods/ann/layer/separable_convolution_impl.hpp
+ *
+ * Implementation of the SeparableConvolution layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_SEPARABLE_CONVOLUTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_SEPARABLE_CONVOLUTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "separable_convolution.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+SeparableConvolutionType<MatType>::SeparableConvolutionType() :
+    Layer<MatType>()
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+SeparableConvolutionType<MatType>::SeparableConvolutionType(
+    const size_t maps,
+    const size_t kernelWidth,
+    const size_t kernelHeight,
+    const size_t multiplier,
+    const size_t strideWidth,
+    const size_t strideHeight,
+    const size_t padW,
+    const size_t padH,
+    const std::string& paddingType,
+    const bool useBias) :
+    SeparableConvolutionType(
+      maps,
+      kernelWidth,
+      kernelHeight,
+      multiplier,
+      strideWidth,
+      strideHeight,
+      std::tuple<size_t, size_t>(padW, padW),
+      std::tuple<size_t, size_t>(padH, padH),
+      paddingType,
+      useBias)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+SeparableConvolutionType<MatType>::SeparableConvolutionType(
+    const size_t maps,
+    const size_t kernelWidth,
+    const size_t kernelHeight,
+    const size_t multiplier,
+    const size_t strideWidth,
+    const size_t strideHeight,
+    const std::tuple<size_t, size_t>& padW,
+    const std::tuple<size_t, size_t>& padH,
+    const std::string& paddingTypeIn,
+    const bool useBias) :
+    Layer<MatType>(),
+    maps(maps),
+    kernelWidth(kernelWidth),
+    kernelHeight(kernelHeight),
+    multiplier(multiplier),
+    strideWidth(strideWidth),
+    strideHeight(strideHeight),
+    padWLeft(std::get<0>(padW)),
+    padWRight(std::get<1>(padW)),
+    padHBottom(std::get<1>(padH)),
+    padHTop(std::get<0>(padH)),
+    useBias(useBias)
+{
+  // Transform paddingType to lowercase.
+  this->paddingType = util::ToLower(paddingTypeIn);
+}
+
+template<typename MatType>
+SeparableConvolutionType<MatType>::SeparableConvolutionType(
+    const SeparableConvolutionType& other) :
+    Layer<MatType>(other),
+    maps(other.maps),
+    kernelWidth(other.kernelWidth),
+    kernelHeight(other.kernelHeight),
+    multiplier(other.multiplier),
+    strideWidth(other.strideWidth),
+    strideHeight(other.strideHeight),
+    padWLeft(other.padWLeft),
+    padWRight(other.padWRight),
+    padHBottom(other.padHBottom),
+    padHTop(other.padHTop),
+    useBias(other.useBias),
+    padding(other.padding),
+    paddingType(other.paddingType),
+    inMaps(other.inMaps),
+    higherInDimensions(other.higherInDimensions)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+SeparableConvolutionType<MatType>::SeparableConvolutionType(
+    SeparableConvolutionType&& other) :
+    Layer<MatType>(std::move(other)),
+    maps(std::move(other.maps)),
+    kernelWidth(std::move(other.kernelWidth)),
+    kernelHeight(std::move(other.kernelHeight)),
+    multiplier(std::move(other.multiplier)),
+    strideWidth(std::move(other.strideWidth)),
+    strideHeight(std::move(other.strideHeight)),
+    padWLeft(std::move(other.padWLeft)),
+    padWRight(std::move(other.padWRight)),
+    padHBottom(std::move(other.padHBottom)),
+    padHTop(std::move(other.padHTop)),
+    useBias(std::move(other.useBias)),
+    padding(std::move(other.padding)),
+    paddingType(std::move(other.paddingType)),
+    inMaps(std::move(other.inMaps)),
+    higherInDimensions(std::move(other.higherInDimensions))
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+SeparableConvolutionType<MatType>&
+SeparableConvolutionType<MatType>::operator=(
+    const SeparableConvolutionType& other)
+{
+  if (&other != this)
+  {
+    Layer<MatType>::operator=(other);
+    maps = other.maps;
+    kernelWidth = other.kernelWidth;
+    kernelHeight = other.kernelHeight;
+    multiplier = other.multiplier;
+    strideWidth = other.strideWidth;
+    strideHeight = other.strideHeight;
+    padWLeft = other.padWLeft;
+    padWRight = other.padWRight;
+    padHBottom = other.padHBottom;
+    padHTop = other.padHTop;
+    useBias = other.useBias;
+    padding = other.padding;
+    paddingType = other.paddingType;
+    inMaps = other.inMaps;
+    higherInDimensions = other.higherInDimensions;
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+SeparableConvolutionType<MatType>&
+SeparableConvolutionType<MatType>::operator=(
+    SeparableConvolutionType&& other)
+{
+  if (&other != this)
+  {
+    Layer<MatType>::operator=(std::move(other));
+    maps = std::move(other.maps);
+    kernelWidth = std::move(other.kernelWidth);
+    kernelHeight = std::move(other.kernelHeight);
+    multiplier = std::move(other.multiplier);
+    strideWidth = std::move(other.strideWidth);
+    strideHeight = std::move(other.strideHeight);
+    padWLeft = std::move(other.padWLeft);
+    padWRight = std::move(other.padWRight);
+    padHBottom = std::move(other.padHBottom);
+    padHTop = std::move(other.padHTop);
+    useBias = std::move(other.useBias);
+    padding = std::move(other.padding);
+    paddingType = std::move(other.paddingType);
+    inMaps = std::move(other.inMaps);
+    higherInDimensions = std::move(other.higherInDimensions);
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+void SeparableConvolutionType<MatType>::SetWeights(
+    typename MatType::elem_type* weightPtr)
+{
+  const size_t depthwiseMaps = inMaps * multiplier;
+  MakeAlias(weights, weightPtr, WeightSize(), 1);
+  MakeAlias(depthwiseWeight, weightPtr, kernelWidth, kernelHeight,
+      depthwiseMaps);
+  MakeAlias(pointwiseWeight, weightPtr + depthwiseWeight.n_elem, depthwiseMaps,
+      maps);
+  if (useBias)
+  {
+    MakeAlias(bias, weightPtr + depthwiseWeight.n_elem + pointwiseWeight.n_elem,
+        maps, 1);
+  }
+}
+
+template<typename MatType>
+void SeparableConvolutionType<MatType>::Forward(
+    const MatType& input, MatType& output)
+{
+  batchSize = input.n_cols;
+
+  // First, perform any padding if necessary.
+  const bool usingPadding =
+      (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0);
+  const size_t paddedRows = this->inputDimensions[0] + padWLeft + padWRight;
+  const size_t paddedCols = this->inputDimensions[1] + padHTop + padHBottom;
+  if (usingPadding)
+  {
+    inputPadded.set_size(paddedRows * paddedCols * inMaps * higherInDimensions,
+        input.n_cols);
+    padding.Forward(input, inputPadded);
+  }
+
+  // We "ignore" dimensions higher than the third, and treat them like
+  // different input points.
+  typename MatType::elem_type* inputPtr =
+      const_cast<MatType&>(usingPadding ? inputPadded : input).memptr();
+  const size_t points = higherInDimensions * batchSize;
+  const size_t depthwiseMaps = inMaps * multiplier;
+  const size_t mapSize = this->outputDimensions[0] * this->outputDimensions[1];
+  depthwiseOutput.set_size(mapSize * depthwiseMaps, points);
+
+  // The depthwise convolution of each point is followed right away by the
+  // pointwise convolution, while the depthwise maps are still in the cache.
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t p = 0; p < points; ++p)
+  {
+    CubeType pointInput, pointDepthwise;
+    MakeAlias(pointInput, inputPtr + p * paddedRows * paddedCols * inMaps,
+        paddedRows, paddedCols, inMaps);
+    MakeAlias(pointDepthwise, depthwiseOutput.colptr(p),
+        this->outputDimensions[0], this->outputDimensions[1], depthwiseMaps);
+    DepthwiseConvolution::Forward(pointInput, inMaps, depthwiseWeight,
+        pointDepthwise, strideWidth, strideHeight);
+
+    // Each row of the depthwise maps of the point holds the value of every map
+    // at one position, so the pointwise convolution is a matrix product.
+    MatType depthwiseMat, outputMat;
+    MakeAlias(depthwiseMat, depthwiseOutput.colptr(p), mapSize, depthwiseMaps);
+    MakeAlias(outputMat, output.memptr() + p * mapSize * maps, mapSize, maps);
+    outputMat = depthwiseMat * pointwiseWeight;
+    if (useBias)
+      outputMat.each_row() += bias.t();
+  }
+}
+
+template<typename MatType>
+void SeparableConvolutionType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& /* output */,
+    const MatType& gy,
+    MatType& g)
+{
+  MatType depthwiseError;
+  DepthwiseError(gy, depthwiseError);
+
+  const size_t points = higherInDimensions * batchSize;
+  CubeType mappedError, gTemp;
+  MakeAlias(mappedError, depthwiseError.memptr(), this->outputDimensions[0],
+      this->outputDimensions[1], inMaps * multiplier * points);
+  MakeAlias(gTemp, g.memptr(), this->inputDimensions[0],
+      this->inputDimensions[1], inMaps * points);
+
+  const bool usingPadding =
+      (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0);
+  if (usingPadding)
+  {
+    paddedError.zeros(padding.OutputDimensions()[0],
+        padding.OutputDimensions()[1], gTemp.n_slices);
+    DepthwiseConvolution::Backward(mappedError, depthwiseWeight, paddedError,
+        inMaps, strideWidth, strideHeight);
+    gTemp = paddedError.tube(
+        padWLeft,
+        padHTop,
+        padWLeft + gTemp.n_rows - 1,
+        padHTop + gTemp.n_cols - 1);
+  }
+  else
+  {
+    gTemp.zeros();
+    DepthwiseConvolution::Backward(mappedError, depthwiseWeight, gTemp, inMaps,
+        strideWidth, strideHeight);
+  }
+}
+
+template<typename MatType>
+void SeparableConvolutionType<MatType>::Gradient(
+    const MatType& input,
+    const MatType& error,
+    MatType& gradient)
+{
+  // We are depending here on `inputPadded` and `depthwiseOutput` being
+  // properly set from a call to Forward().
+  const bool usingPadding =
+      (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0);
+  const size_t paddedRows = this->inputDimensions[0] + padWLeft + padWRight;
+  const size_t paddedCols = this->inputDimensions[1] + padHTop + padHBottom;
+  const size_t points = higherInDimensions * batchSize;
+  const size_t depthwiseMaps = inMaps * multiplier;
+  const size_t mapSize = this->outputDimensions[0] * this->outputDimensions[1];
+
+  MatType depthwiseError;
+  DepthwiseError(error, depthwiseError);
+
+  CubeType inputTemp, mappedError, depthwiseGradient;
+  MakeAlias(inputTemp,
+      const_cast<MatType&>(usingPadding ? inputPadded : input).memptr(),
+      paddedRows, paddedCols, inMaps * points);
+  MakeAlias(mappedError, depthwiseError.memptr(), this->outputDimensions[0],
+      this->outputDimensions[1], depthwiseMaps * points);
+  MakeAlias(depthwiseGradient, gradient.memptr(), kernelWidth, kernelHeight,
+      depthwiseMaps);
+  DepthwiseConvolution::Gradient(inputTemp, inMaps, mappedError,
+      depthwiseGradient, strideWidth, strideHeight);
+
+  // The gradient of the pointwise weights (and the bias) is summed over the
+  // points.
+  MatType pointwiseGradient, biasGradient;
+  MakeAlias(pointwiseGradient, gradient.memptr() + depthwiseGradient.n_elem,
+      depthwiseMaps, maps);
+  pointwiseGradient.zeros();
+  if (useBias)
+  {
+    MakeAlias(biasGradient, gradient.memptr() + depthwiseGradient.n_elem +
+        pointwiseGradient.n_elem, maps, 1);
+    biasGradient.zeros();
+  }
+
+  for (size_t p = 0; p < points; ++p)
+  {
+    MatType depthwiseMat, errorMat;
+    MakeAlias(depthwiseMat, depthwiseOutput.colptr(p), mapSize, depthwiseMaps);
+    MakeAlias(errorMat, const_cast<MatType&>(error).memptr() +
+        p * mapSize * maps, mapSize, maps);
+    pointwiseGradient += depthwiseMat.t() * errorMat;
+    if (useBias)
+      biasGradient += sum(errorMat, 0).t();
+  }
+}
+
+template<typename MatType>
+void SeparableConvolutionType<MatType>::DepthwiseError(
+    const MatType& error, MatType& depthwiseError)
+{
+  const size_t points = higherInDimensions * batchSize;
+  const size_t depthwiseMaps = inMaps * multiplier;
+  const size_t mapSize = this->outputDimensions[0] * this->outputDimensions[1];
+  depthwiseError.set_size(mapSize * depthwiseMaps, points);
+
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t p = 0; p < points; ++p)
+  {
+    MatType errorMat, depthwiseMat;
+    MakeAlias(errorMat, const_cast<MatType&>(error).memptr() +
+        p * mapSize * maps, mapSize, maps);
+    MakeAlias(depthwiseMat, depthwiseError.colptr(p), mapSize, depthwiseMaps);
+    depthwiseMat = errorMat * pointwiseWeight.t();
+  }
+}
+
+template<typename MatType>
+void SeparableConvolutionType<MatType>::ComputeOutputDimensions()
+{
+  // First, we must make sure the padding sizes are up to date, which we can
+  // now do since inputDimensions is set correctly.
+  if (paddingType == "valid")
+  {
+    padWLeft = 0;
+    padWRight = 0;
+    padHTop = 0;
+    padHBottom = 0;
+  }
+  else if (paddingType == "same")
+  {
+    InitializeSamePadding();
+  }
+
+  if (multiplier == 0)
+  {
+    Log::Fatal << "SeparableConvolution::ComputeOutputDimensions(): multiplier "
+        << "must be greater than 0." << std::endl;
+  }
+
+  padding = PaddingType<MatType>(padWLeft, padWRight, padHTop, padHBottom);
+  padding.InputDimensions() = this->inputDimensions;
+  padding.ComputeOutputDimensions();
+
+  // We must ensure that the output has at least 3 dimensions, since we will
+  // be adding some number of maps to the output.
+  this->outputDimensions = std::vector<size_t>(
+      std::max(this->inputDimensions.size(), size_t(3)), 1);
+  this->outputDimensions[0] = ConvOutSize(this->inputDimensions[0],
+      kernelWidth, strideWidth, padWLeft, padWRight);
+  this->outputDimensions[1] = ConvOutSize(this->inputDimensions[1],
+      kernelHeight, strideHeight, padHTop, padHBottom);
+
+  inMaps = (this->inputDimensions.size() >= 3) ? this->inputDimensions[2] : 1;
+
+  // Compute and cache the total number of input maps.
+  higherInDimensions = 1;
+  for (size_t i = 3; i < this->inputDimensions.size(); ++i)
+  {
+    higherInDimensions *= this->inputDimensions[i];
+    this->outputDimensions[i] = this->inputDimensions[i];
+  }
+
+  this->outputDimensions[2] = maps;
+}
+
+template<typename MatType>
+template<typename Archive>
+void SeparableConvolutionType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version*/)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(maps));
+  ar(CEREAL_NVP(batchSize));
+  ar(CEREAL_NVP(kernelWidth));
+  ar(CEREAL_NVP(kernelHeight));
+  ar(CEREAL_NVP(multiplier));
+  ar(CEREAL_NVP(strideWidth));
+  ar(CEREAL_NVP(strideHeight));
+  ar(CEREAL_NVP(padWLeft));
+  ar(CEREAL_NVP(padWRight));
+  ar(CEREAL_NVP(padHBottom));
+  ar(CEREAL_NVP(padHTop));
+  ar(CEREAL_NVP(useBias));
+  ar(CEREAL_NVP(padding));
+  ar(CEREAL_NVP(paddingType));
+  ar(CEREAL_NVP(inMaps));
+  ar(CEREAL_NVP(higherInDimensions));
+}
+
+template<typename MatType>
+void SeparableConvolutionType<MatType>::InitializeSamePadding()
+{
+  /*
+   * Using O = (W - F + 2P) / s + 1;
+   */
+  size_t totalVerticalPadding = (strideWidth - 1) * this->inputDimensions[0] +
+      kernelWidth - strideWidth;
+  size_t totalHorizontalPadding = (strideHeight - 1) * this->inputDimensions[1]
+      + kernelHeight - strideHeight;
+
+  padWLeft = totalVerticalPadding / 2;
+  padWRight = totalVerticalPadding - totalVerticalPadding / 2;
+  padHTop = totalHorizontalPadding / 2;
+  padHBottom = totalHorizontalPadding - totalHorizontalPadding / 2;
+}
+
+} // namespace mlpack
+
+#endif
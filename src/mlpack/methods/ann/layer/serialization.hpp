@@ -45,6 +45,11 @@
         mlpack::NaiveConvolution<mlpack::FullConvolution>, \
         mlpack::NaiveConvolution<mlpack::ValidConvolution>, \
         __VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::ConvolutionType< \
+        mlpack::Im2ColConvolution<mlpack::ValidConvolution>, \
+        mlpack::Im2ColConvolution<mlpack::FullConvolution>, \
+        mlpack::Im2ColConvolution<mlpack::ValidConvolution>, \
+        __VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::CELUType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::CReLUType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::DropConnectType<__VA_ARGS__>); \
@@ -56,6 +61,11 @@
         mlpack::NaiveConvolution<mlpack::FullConvolution>, \
         mlpack::NaiveConvolution<mlpack::ValidConvolution>, \
         __VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::GroupedConvolutionType< \
+        mlpack::Im2ColConvolution<mlpack::ValidConvolution>, \
+        mlpack::Im2ColConvolution<mlpack::FullConvolution>, \
+        mlpack::Im2ColConvolution<mlpack::ValidConvolution>, \
+        __VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::IdentityType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::LeakyReLUType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::LayerNormType<__VA_ARGS__>); \
@@ -63,6 +73,7 @@
     CEREAL_REGISTER_TYPE(mlpack::LinearType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::LinearNoBiasType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::LogSoftMaxType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::LookupType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::LSTMType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::MaxPoolingType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::MeanPoolingType<__VA_ARGS__>); \
@@ -70,9 +81,12 @@
     CEREAL_REGISTER_TYPE(mlpack::NoisyLinearType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::PaddingType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::PReLUType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::QuantizedConvolutionType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::QuantizedLinearType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::RBFType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::ReLU6Type<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::RepeatType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::SeparableConvolutionType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::SoftmaxType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::SoftminType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::HardTanHType<__VA_ARGS__>); \
@@ -0,0 +1,346 @@
+/**
+ * @file methods/ann/layer_profiler.hpp
+ *
+ * Definition of the LayerProfiler class, which records the time spent in the
+ * forward, backward, and gradient passes of each layer of a network.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_PROFILER_HPP
+#define MLPACK_METHODS_ANN_LAYER_PROFILER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <typeinfo>
+
+#ifdef __GNUG__
+  #include <cxxabi.h>
+#endif
+
+namespace mlpack {
+
+/**
+ * A LayerProfiler records, for each layer of a network, the number of calls
+ * and the wall time of its `Forward()`, `Backward()`, and `Gradient()` passes,
+ * an estimate of the floating-point operations of each pass, and the size of
+ * its largest output.  It is attached to a network with `FFN::Profiler()`,
+ * `RNN::Profiler()`, or `MultiLayer::Profiler()`; when no profiler is
+ * attached, the only cost is one pointer check per layer and pass.
+ *
+ * @code
+ * FFN<> model;
+ * // Add layers...
+ *
+ * LayerProfiler profiler;
+ * model.Profiler() = &profiler;
+ * model.Train(data, labels, optimizer);
+ * model.Profiler() = NULL;
+ *
+ * std::cout << profiler.Summary();
+ * profiler.ExportChromeTrace("trace.json");
+ * @endcode
+ *
+ * The trace can be viewed in `chrome://tracing` or in Perfetto.  The
+ * floating-point operation estimates come from `Layer::ForwardFlops()`; the
+ * backward and gradient passes are each counted as costing as much as the
+ * forward pass.
+ *
+ * The layers are told apart by their addresses, so the layers used by
+ * inference passes (see `MultiLayer::Inference()`) are recorded separately
+ * from those used by training passes.
+ */
+class LayerProfiler
+{
+ public:
+  //! The passes that are recorded.
+  enum Pass
+  {
+    FORWARD = 0,
+    BACKWARD = 1,
+    GRADIENT = 2
+  };
+
+  //! The type of the clock used to time the passes.
+  typedef std::chrono::steady_clock Clock;
+
+  //! The statistics recorded for one layer.
+  struct LayerStatistics
+  {
+    //! The type of the layer (e.g. "Linear").
+    std::string name;
+    //! The index of the layer in its network.
+    size_t index;
+    //! The number of calls of each pass.
+    size_t calls[3];
+    //! The total wall time of each pass, in seconds.
+    double time[3];
+    //! The estimated number of floating-point operations of each pass.
+    double flops[3];
+    //! The size of the largest output of the forward pass of the layer, in
+    //! bytes.
+    size_t outputBytes;
+  };
+
+  /**
+   * Create the profiler.
+   *
+   * @param keepTrace If true, every call is kept so that it can be exported
+   *     with ExportChromeTrace(); otherwise only the totals are kept.
+   */
+  LayerProfiler(const bool keepTrace = true) :
+      keepTrace(keepTrace),
+      origin(Clock::now())
+  {
+    // Nothing to do here.
+  }
+
+  /**
+   * Record a call of the given pass of a layer; this is called by the
+   * networks that the profiler is attached to.
+   *
+   * @param layer The layer that was called.
+   * @param index The index of the layer in its network.
+   * @param pass The pass that was called.
+   * @param start The time at which the pass started.
+   * @param end The time at which the pass ended.
+   * @param flops The estimated number of floating-point operations.
+   * @param outputBytes The size of the output of the pass (the output of the
+   *     layer, its delta, or its gradient), in bytes.
+   */
+  template<typename LayerType>
+  void Record(const LayerType* layer,
+              const size_t index,
+              const Pass pass,
+              const Clock::time_point& start,
+              const Clock::time_point& end,
+              const double flops,
+              const size_t outputBytes)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::map<const void*, size_t>::const_iterator it = ids.find(layer);
+    size_t id;
+    if (it == ids.end())
+    {
+      id = statistics.size();
+      ids[layer] = id;
+
+      LayerStatistics layerStatistics;
+      layerStatistics.name = LayerName(*layer);
+      layerStatistics.index = index;
+      for (size_t p = 0; p < 3; ++p)
+      {
+        layerStatistics.calls[p] = 0;
+        layerStatistics.time[p] = 0.0;
+        layerStatistics.flops[p] = 0.0;
+      }
+      layerStatistics.outputBytes = 0;
+      statistics.push_back(layerStatistics);
+    }
+    else
+    {
+      id = it->second;
+    }
+
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    LayerStatistics& layerStatistics = statistics[id];
+    layerStatistics.calls[pass]++;
+    layerStatistics.time[pass] += seconds;
+    layerStatistics.flops[pass] += flops;
+    if (pass == FORWARD)
+    {
+      layerStatistics.outputBytes = std::max(layerStatistics.outputBytes,
+          outputBytes);
+    }
+
+    if (keepTrace)
+    {
+      TraceEvent event;
+      event.id = id;
+      event.pass = pass;
+      event.start = std::chrono::duration<double, std::micro>(start -
+          origin).count();
+      event.duration = 1e6 * seconds;
+      event.flops = flops;
+      event.outputBytes = outputBytes;
+      events.push_back(event);
+    }
+  }
+
+  //! Get the statistics of each layer, in the order in which the layers were
+  //! first called.
+  const std::vector<LayerStatistics>& Statistics() const
+  {
+    return statistics;
+  }
+
+  //! Get the total time spent in the given pass of all layers, in seconds.
+  double TotalTime(const Pass pass) const
+  {
+    double total = 0.0;
+    for (size_t i = 0; i < statistics.size(); ++i)
+      total += statistics[i].time[pass];
+    return total;
+  }
+
+  /**
+   * Get a table of the statistics of each layer: calls, total time in
+   * milliseconds and share of the total time of each pass, estimated GFLOP/s,
+   * and largest output size.
+   */
+  std::string Summary() const
+  {
+    const char* passNames[3] = { "forward", "backward", "gradient" };
+    double totalTime = 0.0;
+    for (size_t p = 0; p < 3; ++p)
+      totalTime += TotalTime(Pass(p));
+
+    std::ostringstream stream;
+    stream << std::left << std::setw(6) << "index" << std::setw(22) << "layer"
+        << std::setw(10) << "pass" << std::right << std::setw(10) << "calls"
+        << std::setw(14) << "time (ms)" << std::setw(9) << "share"
+        << std::setw(12) << "GFLOP/s" << std::setw(14) << "output (KB)"
+        << std::endl;
+    stream << std::fixed;
+    for (size_t i = 0; i < statistics.size(); ++i)
+    {
+      const LayerStatistics& s = statistics[i];
+      for (size_t p = 0; p < 3; ++p)
+      {
+        if (s.calls[p] == 0)
+          continue;
+
+        const double share = (totalTime > 0) ? s.time[p] / totalTime : 0.0;
+        const double gflops = (s.time[p] > 0) ? 1e-9 * s.flops[p] / s.time[p] :
+            0.0;
+        stream << std::left << std::setw(6) << s.index << std::setw(22)
+            << s.name << std::setw(10) << passNames[p] << std::right
+            << std::setw(10) << s.calls[p] << std::setw(14)
+            << std::setprecision(3) << 1e3 * s.time[p] << std::setw(8)
+            << std::setprecision(1) << 100.0 * share << "%" << std::setw(12)
+            << std::setprecision(2) << gflops << std::setw(14)
+            << std::setprecision(1) << s.outputBytes / 1024.0 << std::endl;
+      }
+    }
+
+    return stream.str();
+  }
+
+  /**
+   * Write every recorded call to the given file in the Chrome trace event JSON
+   * format.  This requires the profiler to have been created with `keepTrace`
+   * set to true.  A std::runtime_error is thrown if the file cannot be
+   * written.
+   *
+   * @param filename Name of the file to write.
+   */
+  void ExportChromeTrace(const std::string& filename) const
+  {
+    std::ofstream stream(filename);
+    if (!stream.is_open())
+    {
+      throw std::runtime_error("LayerProfiler::ExportChromeTrace(): cannot "
+          "open '" + filename + "' for writing!");
+    }
+
+    const char* passNames[3] = { "Forward", "Backward", "Gradient" };
+    stream << "{\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+      const TraceEvent& event = events[i];
+      const LayerStatistics& s = statistics[event.id];
+      stream << ((i == 0) ? "\n" : ",\n") << "{\"name\":\"" << s.name << " ("
+          << s.index << ")\",\"cat\":\"" << passNames[event.pass]
+          << "\",\"ph\":\"X\",\"ts\":" << event.start << ",\"dur\":"
+          << event.duration << ",\"pid\":0,\"tid\":" << event.pass
+          << ",\"args\":{\"flops\":" << event.flops << ",\"outputBytes\":"
+          << event.outputBytes << "}}";
+    }
+    stream << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+
+    if (!stream.good())
+    {
+      throw std::runtime_error("LayerProfiler::ExportChromeTrace(): error "
+          "while writing '" + filename + "'!");
+    }
+  }
+
+  //! Forget everything that has been recorded.
+  void Clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ids.clear();
+    statistics.clear();
+    events.clear();
+    origin = Clock::now();
+  }
+
+ private:
+  //! One recorded call.
+  struct TraceEvent
+  {
+    size_t id;
+    Pass pass;
+    //! Start time, in microseconds since the profiler was created or cleared.
+    double start;
+    //! Duration, in microseconds.
+    double duration;
+    double flops;
+    size_t outputBytes;
+  };
+
+  //! Get a short name for the type of the given layer, like "Linear" for
+  //! `mlpack::LinearType<arma::mat>`.
+  template<typename LayerType>
+  static std::string LayerName(const LayerType& layer)
+  {
+    std::string name = typeid(layer).name();
+    #ifdef __GNUG__
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name.c_str(), NULL, NULL, &status);
+    if (status == 0 && demangled != NULL)
+      name = demangled;
+    free(demangled);
+    #endif
+
+    // Remove the namespace, the template parameters, and the "Type" suffix.
+    const size_t templateStart = name.find('<');
+    if (templateStart != std::string::npos)
+      name = name.substr(0, templateStart);
+    const size_t namespaceEnd = name.rfind("::");
+    if (namespaceEnd != std::string::npos)
+      name = name.substr(namespaceEnd + 2);
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, "Type") == 0)
+      name = name.substr(0, name.size() - 4);
+
+    return name;
+  }
+
+  //! Whether every call is kept.
+  bool keepTrace;
+  //! The time that trace events are relative to.
+  Clock::time_point origin;
+  //! The index in `statistics` of each layer.
+  std::map<const void*, size_t> ids;
+  //! The statistics of each layer.
+  std::vector<LayerStatistics> statistics;
+  //! Every recorded call, if `keepTrace` is true.
+  std::vector<TraceEvent> events;
+  //! Protects the members above, since layers may be called from several
+  //! threads.
+  std::mutex mutex;
+};
+
+} // namespace mlpack
+
+#endif
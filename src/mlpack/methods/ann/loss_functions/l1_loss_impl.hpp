@@ -29,7 +29,7 @@ typename MatType::elem_type L1LossType<MatType>::Forward(
     const MatType& prediction,
     const MatType& target)
 {
-  MatType loss = arma::abs(prediction - target);
+  MatType loss = abs(prediction - target);
   typename MatType::elem_type lossSum = accu(loss);
 
   if (reduction)
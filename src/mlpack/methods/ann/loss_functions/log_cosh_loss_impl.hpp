@@ -34,7 +34,7 @@ typename MatType::elem_type LogCoshLossType<MatType>::Forward(
     const MatType& target)
 {
   typename MatType::elem_type lossSum =
-      accu(log(arma::cosh(a * (target - prediction)))) / a;
+      accu(log(cosh(a * (target - prediction)))) / a;
 
   if (reduction)
     return lossSum;
@@ -48,7 +48,7 @@ void LogCoshLossType<MatType>::Backward(
     const MatType& target,
     MatType& loss)
 {
-  loss = arma::tanh(a * (target - prediction));
+  loss = tanh(a * (target - prediction));
 
   if (!reduction)
     loss = loss / target.n_elem;
@@ -28,7 +28,7 @@ typename MatType::elem_type MeanAbsolutePercentageErrorType<MatType>::Forward(
     const MatType& prediction,
     const MatType& target)
 {
-  MatType loss = arma::abs((prediction - target) / target);
+  MatType loss = abs((prediction - target) / target);
   return accu(loss) * (100 / target.n_cols);
 }
 
@@ -39,7 +39,7 @@ void MeanAbsolutePercentageErrorType<MatType>::Backward(
     MatType& loss)
 
 {
-  loss = (((ConvTo<arma::mat>::From(prediction < target) * -2) + 1) /
+  loss = (((ConvTo<MatType>::From(prediction < target) * -2) + 1) /
       target) * (100 / target.n_cols);
 }
 
@@ -45,7 +45,7 @@ void MeanBiasErrorType<MatType>::Backward(
     const MatType& /* target */,
     MatType& loss)
 {
-  loss.set_size(arma::size(prediction));
+  loss.set_size(prediction.n_rows, prediction.n_cols);
   loss.fill(-1.0);
 
   if (!reduction)
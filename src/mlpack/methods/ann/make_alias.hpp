@@ -4,7 +4,8 @@
  *
  * Implementation of `MakeAlias()`, a utility function.  This is meant to be
  * used in `SetWeights()` calls in various layers, to wrap internal weight
- * objects as aliases around the given memory pointers.
+ * objects as aliases around the given memory pointers, and of `MemPtr()` and
+ * `ColPtr()`, which give those pointers for Armadillo and Bandicoot matrices.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -53,6 +54,61 @@ void MakeAlias(CubeType& c,
   new (&c) CubeType(newMem, numRows, numCols, numSlices, false, true);
 }
 
+/**
+ * Return a pointer to the memory of `m`, which can be given to `MakeAlias()`
+ * and to the `SetWeights()` functions of layers.
+ */
+template<typename MatType>
+typename MatType::elem_type* MemPtr(const MatType& m)
+{
+  return const_cast<typename MatType::elem_type*>(m.memptr());
+}
+
+#ifdef MLPACK_HAS_COOT
+
+/**
+ * Reconstruct the Bandicoot matrix `m` as an alias around the device memory
+ * `newMem`, with size `numRows` x `numCols`.  Raw device pointers are only
+ * available with the CUDA backend of Bandicoot.
+ */
+template<typename eT>
+void MakeAlias(coot::Mat<eT>& m,
+               eT* newMem,
+               const size_t numRows,
+               const size_t numCols)
+{
+  typedef coot::Mat<eT> CootMatType;
+
+  coot::dev_mem_t<eT> mem;
+  mem.cuda_mem_ptr = newMem;
+  m.~CootMatType();
+  new (&m) CootMatType(mem, numRows, numCols);
+}
+
+/**
+ * Return a pointer to the device memory of the Bandicoot matrix `m`; pointer
+ * arithmetic on it is done on the host like for Armadillo matrices.
+ */
+template<typename eT>
+eT* MemPtr(const coot::Mat<eT>& m)
+{
+  return const_cast<coot::Mat<eT>&>(m).get_dev_mem(false).cuda_mem_ptr;
+}
+
+#endif
+
+/**
+ * Return a pointer to the memory of column `col` of `m`, which can be given to
+ * `MakeAlias()`.  All the overloads of `MemPtr()` must be declared before this
+ * function, since argument-dependent lookup would not find the Bandicoot
+ * overload (it only searches namespace `coot`).
+ */
+template<typename MatType>
+typename MatType::elem_type* ColPtr(const MatType& m, const size_t col)
+{
+  return MemPtr(m) + col * m.n_rows;
+}
+
 } // namespace mlpack
 
 #endif
@@ -0,0 +1,128 @@
+/**
+ * @file methods/ann/mixed_precision_function.hpp
+ *
+ * Definition of the MixedPrecisionFunction class, which lets an ensmallen
+ * optimizer update a high-precision copy of the parameters of a network that
+ * computes in lower precision.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_MIXED_PRECISION_FUNCTION_HPP
+#define MLPACK_METHODS_ANN_MIXED_PRECISION_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * A wrapper around a network for mixed-precision training; this is what
+ * `FFN::TrainMixedPrecision()` hands to the optimizer.  The optimizer works on
+ * master parameters of type `MasterMatType` (e.g. `arma::mat`), while the
+ * network does its forward and backward passes in its own, lower, precision
+ * (e.g. `arma::fmat`).  Before each evaluation, the master parameters are
+ * rounded into the parameters of the network, and the gradient of the network
+ * is converted back to the master precision.
+ *
+ * Dynamic loss scaling keeps small gradients from underflowing in the lower
+ * precision: the error of the output layer is multiplied by a scale before
+ * the backward pass, and the gradient is divided by that scale afterwards.
+ * When the scaled gradient overflows, the step is skipped (the optimizer is
+ * given a zero gradient) and the scale is halved; after `growthInterval`
+ * steps without overflow, the scale is doubled.  The objective is never
+ * scaled.
+ *
+ * Note that layer regularizers (e.g. the `RegularizerType` of `Linear`) are
+ * applied to the scaled gradient, so their strength is divided by the loss
+ * scale.  Use a loss scale of 1 and a growth interval of 0 to disable loss
+ * scaling for networks with such layers.
+ *
+ * @tparam NetworkType Type of the network (e.g. `FFN<>`).
+ * @tparam MatType Matrix type of the network.
+ * @tparam MasterMatType Matrix type of the master parameters.
+ */
+template<typename NetworkType,
+         typename MatType,
+         typename MasterMatType = arma::mat>
+class MixedPrecisionFunction
+{
+ public:
+  //! Element type of the master parameters.
+  using ElemType = typename MasterMatType::elem_type;
+
+  /**
+   * Wrap the given network, which must already be prepared for training
+   * (i.e. its parameters are initialized and its data is set).
+   *
+   * @param network Network to wrap.
+   * @param initialScale Initial loss scale.
+   * @param growthInterval Number of steps without overflow after which the
+   *     loss scale is doubled; 0 means the scale is never increased.
+   */
+  MixedPrecisionFunction(NetworkType& network,
+                         const double initialScale = 65536.0,
+                         const size_t growthInterval = 2000);
+
+  //! Return the number of separable functions (the number of data points).
+  size_t NumFunctions() const { return network.NumFunctions(); }
+
+  //! Shuffle the data of the network.
+  void Shuffle() { network.Shuffle(); }
+
+  //! Evaluate the network with the given master parameters on all the data.
+  ElemType Evaluate(const MasterMatType& parameters);
+
+  //! Evaluate the network with the given master parameters on the points
+  //! `begin` to `begin + batchSize - 1`.
+  ElemType Evaluate(const MasterMatType& parameters,
+                    const size_t begin,
+                    const size_t batchSize);
+
+  /**
+   * Evaluate the network with the given master parameters on the points
+   * `begin` to `begin + batchSize - 1`, and store the unscaled gradient in
+   * the master precision in `gradient`.  If the scaled gradient overflowed,
+   * `gradient` is zero.
+   */
+  ElemType EvaluateWithGradient(const MasterMatType& parameters,
+                                const size_t begin,
+                                MasterMatType& gradient,
+                                const size_t batchSize);
+
+  //! Compute the gradient only; see `EvaluateWithGradient()`.
+  void Gradient(const MasterMatType& parameters,
+                const size_t begin,
+                MasterMatType& gradient,
+                const size_t batchSize);
+
+  //! Round the given master parameters into the parameters of the network.
+  void SetParameters(const MasterMatType& parameters);
+
+  //! Get the current loss scale.
+  double Scale() const { return scale; }
+  //! Get the number of steps that were skipped because of an overflow.
+  size_t SkippedSteps() const { return skippedSteps; }
+
+ private:
+  //! The wrapped network.
+  NetworkType& network;
+  //! The gradient of the network, in its own precision.
+  MatType networkGradient;
+  //! The current loss scale.
+  double scale;
+  //! Number of steps without overflow after which the scale is doubled.
+  size_t growthInterval;
+  //! Number of steps without overflow since the scale last changed.
+  size_t goodSteps;
+  //! Number of skipped steps.
+  size_t skippedSteps;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "mixed_precision_function_impl.hpp"
+
+#endif
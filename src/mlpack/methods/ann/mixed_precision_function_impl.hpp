@@ -0,0 +1,122 @@
+/**
+ * @file methods/ann/mixed_precision_function_impl.hpp
+ *
+ * Implementation of the MixedPrecisionFunction class, which lets an ensmallen
+ * optimizer update a high-precision copy of the parameters of a network that
+ * computes in lower precision.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_MIXED_PRECISION_FUNCTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_MIXED_PRECISION_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mixed_precision_function.hpp"
+
+namespace mlpack {
+
+template<typename NetworkType, typename MatType, typename MasterMatType>
+MixedPrecisionFunction<NetworkType, MatType, MasterMatType>::
+MixedPrecisionFunction(NetworkType& network,
+                       const double initialScale,
+                       const size_t growthInterval) :
+    network(network),
+    scale(initialScale),
+    growthInterval(growthInterval),
+    goodSteps(0),
+    skippedSteps(0)
+{
+  // Nothing to do here.
+}
+
+template<typename NetworkType, typename MatType, typename MasterMatType>
+typename MasterMatType::elem_type
+MixedPrecisionFunction<NetworkType, MatType, MasterMatType>::Evaluate(
+    const MasterMatType& parameters)
+{
+  SetParameters(parameters);
+  return ElemType(network.Evaluate(network.Parameters()));
+}
+
+template<typename NetworkType, typename MatType, typename MasterMatType>
+typename MasterMatType::elem_type
+MixedPrecisionFunction<NetworkType, MatType, MasterMatType>::Evaluate(
+    const MasterMatType& parameters,
+    const size_t begin,
+    const size_t batchSize)
+{
+  SetParameters(parameters);
+  return ElemType(network.Evaluate(network.Parameters(), begin, batchSize));
+}
+
+template<typename NetworkType, typename MatType, typename MasterMatType>
+typename MasterMatType::elem_type
+MixedPrecisionFunction<NetworkType, MatType, MasterMatType>::
+EvaluateWithGradient(const MasterMatType& parameters,
+                     const size_t begin,
+                     MasterMatType& gradient,
+                     const size_t batchSize)
+{
+  typedef typename MatType::elem_type NetworkElemType;
+
+  SetParameters(parameters);
+
+  network.errorScale = NetworkElemType(scale);
+  const ElemType objective = ElemType(network.EvaluateWithGradient(
+      network.Parameters(), begin, networkGradient, batchSize));
+  network.errorScale = 1;
+
+  gradient.set_size(parameters.n_rows, parameters.n_cols);
+  if (!networkGradient.is_finite())
+  {
+    // The scaled gradient overflowed, so skip this step and try again with a
+    // smaller scale.
+    gradient.zeros();
+    scale /= 2;
+    goodSteps = 0;
+    ++skippedSteps;
+    return objective;
+  }
+
+  const ElemType inverseScale = ElemType(1.0 / scale);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    gradient[i] = ElemType(networkGradient[i]) * inverseScale;
+
+  if (growthInterval > 0 && ++goodSteps == growthInterval)
+  {
+    scale *= 2;
+    goodSteps = 0;
+  }
+
+  return objective;
+}
+
+template<typename NetworkType, typename MatType, typename MasterMatType>
+void MixedPrecisionFunction<NetworkType, MatType, MasterMatType>::Gradient(
+    const MasterMatType& parameters,
+    const size_t begin,
+    MasterMatType& gradient,
+    const size_t batchSize)
+{
+  EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename NetworkType, typename MatType, typename MasterMatType>
+void MixedPrecisionFunction<NetworkType, MatType, MasterMatType>::
+SetParameters(const MasterMatType& parameters)
+{
+  typedef typename MatType::elem_type NetworkElemType;
+
+  // The layers of the network alias its parameters, so the values have to be
+  // written into the existing memory.
+  MatType& networkParameters = network.Parameters();
+  for (size_t i = 0; i < parameters.n_elem; ++i)
+    networkParameters[i] = NetworkElemType(parameters[i]);
+}
+
+} // namespace mlpack
+
+#endif
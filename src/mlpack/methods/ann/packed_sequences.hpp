@@ -0,0 +1,144 @@
+/**
+ * @file methods/ann/packed_sequences.hpp
+ *
+ * Definition of the PackedSequences class, which packs a batch of sequences of
+ * different lengths into one matrix for recurrent networks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_PACKED_SEQUENCES_HPP
+#define MLPACK_METHODS_ANN_PACKED_SEQUENCES_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+
+/**
+ * The layout of a batch of sequences of different lengths, packed so that no
+ * work is done for the steps after the end of a sequence.  The sequences of
+ * the batch are sorted by decreasing length, so that the sequences that are
+ * still running at step `t` are the first `StepSize(t)` sequences; the packed
+ * matrix holds the columns of the first step, then those of the second step,
+ * and so on (the columns of step `t` start at `StepOffset(t)`).  Each step of a
+ * recurrent network can then work on a contiguous block of columns, and a
+ * layer that only depends on the current step can be applied to all the steps
+ * at once.
+ *
+ * The sequences are stored in cubes, as for `RNN`: each column is a sequence
+ * and each slice is a step.  The steps after the end of a sequence are ignored
+ * when packing, and set to zero when unpacking.
+ *
+ * @tparam MatType Matrix type of the packed sequences.
+ */
+template<typename MatType = arma::mat>
+class PackedSequences
+{
+ public:
+  //! The type of the cubes holding the sequences.
+  using CubeType = arma::Cube<typename MatType::elem_type>;
+
+  //! Create an empty layout.
+  PackedSequences();
+
+  /**
+   * Compute the layout of the sequences `begin` to `begin + batchSize - 1`.
+   *
+   * @param sequenceLengths Length of each sequence of the dataset, or an empty
+   *     vector if every sequence has `steps` steps.
+   * @param steps Number of steps of the longest sequence (`n_slices` of the
+   *     data).
+   * @param begin Index of the first sequence of the batch.
+   * @param batchSize Number of sequences in the batch.
+   */
+  void Reset(const arma::urowvec& sequenceLengths,
+             const size_t steps,
+             const size_t begin,
+             const size_t batchSize);
+
+  /**
+   * Pack the sequences of the batch into `packed`.  If `reverse` is true, the
+   * steps of each sequence are packed in reverse order (so the first step of
+   * the packed sequence is the last step of the original sequence).  If
+   * `sequences` has only one slice (e.g. the responses of an `RNN` with only
+   * one response per sequence), that slice is used for every step.
+   *
+   * @param sequences Sequences to pack.
+   * @param packed Matrix to store the packed sequences in.
+   * @param reverse Whether to reverse the steps of each sequence.
+   */
+  void Pack(const CubeType& sequences,
+            MatType& packed,
+            const bool reverse = false) const;
+
+  /**
+   * Store the packed steps of the batch in the right columns and slices of
+   * `sequences`, which must already have the right size.  The steps after the
+   * end of each sequence are set to zero.
+   *
+   * @param packed Packed sequences (not reversed).
+   * @param sequences Cube to store the sequences in.
+   */
+  void Unpack(const MatType& packed, CubeType& sequences) const;
+
+  //! Get the number of steps of the longest sequence of the batch.
+  size_t Steps() const { return stepSizes.size(); }
+  //! Get the number of sequences that are still running at step `t`.
+  size_t StepSize(const size_t t) const { return stepSizes[t]; }
+  //! Get the index of the first packed column of step `t`.
+  size_t StepOffset(const size_t t) const { return stepOffsets[t]; }
+  //! Get the total number of packed columns.
+  size_t Columns() const { return columns; }
+
+  //! Get the length of the `j`th sequence of the packed batch.
+  size_t Length(const size_t j) const { return lengths[j]; }
+
+  //! Get the column of the packed reversed sequences that holds step `t` of
+  //! the `j`th sequence (this is its step `Length(j) - 1 - t` in reverse).
+  size_t ReversedColumn(const size_t t, const size_t j) const
+  {
+    return stepOffsets[lengths[j] - 1 - t] + j;
+  }
+
+  /**
+   * Ensure that the given sequence lengths are valid for a dataset of
+   * `sequences` sequences with `steps` steps; an empty vector of lengths is
+   * valid.  A `std::invalid_argument` is thrown otherwise.
+   */
+  static void CheckLengths(const arma::urowvec& sequenceLengths,
+                           const size_t sequences,
+                           const size_t steps,
+                           const std::string& functionName);
+
+  /**
+   * Shuffle the sequences of a dataset and their responses and lengths in
+   * place.  If `sequenceLengths` is empty, only the predictors and responses
+   * are shuffled.
+   */
+  static void Shuffle(CubeType& predictors,
+                      CubeType& responses,
+                      arma::urowvec& sequenceLengths);
+
+ private:
+  //! Index of the first sequence of the batch.
+  size_t begin;
+  //! Index in the batch of each packed sequence.
+  arma::uvec order;
+  //! Length of each packed sequence (in decreasing order).
+  arma::uvec lengths;
+  //! Number of sequences running at each step.
+  std::vector<size_t> stepSizes;
+  //! First packed column of each step.
+  std::vector<size_t> stepOffsets;
+  //! Total number of packed columns.
+  size_t columns;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "packed_sequences_impl.hpp"
+
+#endif
@@ -0,0 +1,166 @@
+/**
+ * @file methods/ann/packed_sequences_impl.hpp
+ *
+ * Implementation of the PackedSequences class, which packs a batch of
+ * sequences of different lengths into one matrix for recurrent networks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_PACKED_SEQUENCES_IMPL_HPP
+#define MLPACK_METHODS_ANN_PACKED_SEQUENCES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "packed_sequences.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+PackedSequences<MatType>::PackedSequences() :
+    begin(0),
+    columns(0)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+void PackedSequences<MatType>::Reset(const arma::urowvec& sequenceLengths,
+                                     const size_t steps,
+                                     const size_t begin,
+                                     const size_t batchSize)
+{
+  this->begin = begin;
+  if (batchSize == 0)
+  {
+    order.clear();
+    lengths.clear();
+  }
+  else if (sequenceLengths.n_elem == 0)
+  {
+    order = arma::regspace<arma::uvec>(0, batchSize - 1);
+    lengths.set_size(batchSize);
+    lengths.fill(steps);
+  }
+  else
+  {
+    // A stable sort keeps sequences of the same length in their order.
+    const arma::urowvec batchLengths =
+        sequenceLengths.cols(begin, begin + batchSize - 1);
+    order = arma::stable_sort_index(batchLengths, "descend");
+    lengths = batchLengths.elem(order);
+  }
+
+  // Since the lengths decrease, the sequences that are still running at a step
+  // are the first sequences of the batch.
+  const size_t maxLength = (batchSize == 0) ? 0 : lengths[0];
+  stepSizes.resize(maxLength);
+  stepOffsets.resize(maxLength);
+  columns = 0;
+  size_t running = batchSize;
+  for (size_t t = 0; t < maxLength; ++t)
+  {
+    while (running > 0 && lengths[running - 1] <= t)
+      --running;
+
+    stepSizes[t] = running;
+    stepOffsets[t] = columns;
+    columns += running;
+  }
+}
+
+template<typename MatType>
+void PackedSequences<MatType>::Pack(const CubeType& sequences,
+                                    MatType& packed,
+                                    const bool reverse) const
+{
+  packed.set_size(sequences.n_rows, columns);
+  for (size_t t = 0; t < stepSizes.size(); ++t)
+  {
+    for (size_t j = 0; j < stepSizes[t]; ++j)
+    {
+      const size_t slice = (sequences.n_slices == 1) ? 0 :
+          (reverse ? lengths[j] - 1 - t : t);
+      packed.col(stepOffsets[t] + j) =
+          sequences.slice(slice).col(begin + order[j]);
+    }
+  }
+}
+
+template<typename MatType>
+void PackedSequences<MatType>::Unpack(const MatType& packed,
+                                      CubeType& sequences) const
+{
+  for (size_t t = 0; t < sequences.n_slices; ++t)
+  {
+    for (size_t j = 0; j < order.n_elem; ++j)
+    {
+      if (t < lengths[j])
+      {
+        sequences.slice(t).col(begin + order[j]) =
+            packed.col(stepOffsets[t] + j);
+      }
+      else
+      {
+        sequences.slice(t).col(begin + order[j]).zeros();
+      }
+    }
+  }
+}
+
+template<typename MatType>
+void PackedSequences<MatType>::CheckLengths(
+    const arma::urowvec& sequenceLengths,
+    const size_t sequences,
+    const size_t steps,
+    const std::string& functionName)
+{
+  if (sequenceLengths.n_elem == 0)
+    return;
+
+  if (sequenceLengths.n_elem != sequences)
+  {
+    std::ostringstream oss;
+    oss << functionName << ": number of sequence lengths ("
+        << sequenceLengths.n_elem << ") does not match number of sequences ("
+        << sequences << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  for (size_t i = 0; i < sequenceLengths.n_elem; ++i)
+  {
+    if (sequenceLengths[i] == 0 || sequenceLengths[i] > steps)
+    {
+      std::ostringstream oss;
+      oss << functionName << ": length of sequence " << i << " ("
+          << sequenceLengths[i] << ") must be between 1 and the number of "
+          << "steps (" << steps << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+}
+
+template<typename MatType>
+void PackedSequences<MatType>::Shuffle(CubeType& predictors,
+                                       CubeType& responses,
+                                       arma::urowvec& sequenceLengths)
+{
+  if (sequenceLengths.n_elem == 0)
+  {
+    ShuffleData(predictors, responses, predictors, responses);
+    return;
+  }
+
+  const arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+      predictors.n_cols - 1, predictors.n_cols));
+
+  ScatterCubeColumns(predictors, predictors, ordering);
+  ScatterCubeColumns(responses, responses, ordering);
+  const arma::urowvec lengths = sequenceLengths;
+  sequenceLengths.elem(ordering) = lengths;
+}
+
+} // namespace mlpack
+
+#endif
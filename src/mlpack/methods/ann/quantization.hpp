@@ -0,0 +1,162 @@
+/**
+ * @file methods/ann/quantization.hpp
+ *
+ * Utility functions for the 8-bit quantized layers, which are used for
+ * inference with quantized weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZATION_HPP
+#define MLPACK_METHODS_ANN_QUANTIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
+
+namespace mlpack {
+
+/**
+ * Quantize each column of `weights` (the weights of one output channel) to
+ * signed 8-bit integers in [-127, 127].  Each column gets its own scale, so
+ * that the largest weight of the column (in absolute value) becomes 127; the
+ * zero point of the weights is always 0.  The sum of the quantized weights of
+ * each column is stored in `sums`, so that the zero point of the quantized
+ * input can be accounted for by QuantizedMultiply().
+ *
+ * @param weights Weights to quantize, one column for each output channel.
+ * @param quantized Matrix to store the quantized weights in.
+ * @param scales Vector to store the scale of each column in.
+ * @param sums Vector to store the sum of each column of `quantized` in.
+ */
+template<typename MatType>
+void QuantizeWeights(const MatType& weights,
+                     arma::Mat<int8_t>& quantized,
+                     MatType& scales,
+                     arma::Col<int32_t>& sums)
+{
+  typedef typename MatType::elem_type eT;
+
+  quantized.set_size(weights.n_rows, weights.n_cols);
+  scales.set_size(weights.n_cols, 1);
+  sums.zeros(weights.n_cols);
+  for (size_t i = 0; i < weights.n_cols; ++i)
+  {
+    const eT maxWeight = arma::max(arma::abs(weights.col(i)));
+    scales[i] = (maxWeight > 0) ? maxWeight / eT(127) : eT(1);
+    for (size_t k = 0; k < weights.n_rows; ++k)
+    {
+      const eT value = std::round(weights(k, i) / scales[i]);
+      quantized(k, i) = (int8_t) std::min(std::max(value, eT(-127)), eT(127));
+      sums[i] += quantized(k, i);
+    }
+  }
+}
+
+/**
+ * Quantize the elements of `input` to unsigned 8-bit integers, with one scale
+ * and zero point for all of them: element `x` becomes `round(x / scale) +
+ * zeroPoint`.  The quantized range always contains zero, so 0 is exactly
+ * represented by `zeroPoint` (this is what zero padding must be quantized to).
+ *
+ * @param input Values to quantize.
+ * @param quantized Memory to store the `input.n_elem` quantized values in.
+ * @param scale Set to the scale of the quantized values.
+ * @param zeroPoint Set to the quantized value of 0.
+ */
+template<typename MatType>
+void QuantizeActivations(const MatType& input,
+                         uint8_t* quantized,
+                         typename MatType::elem_type& scale,
+                         int32_t& zeroPoint)
+{
+  typedef typename MatType::elem_type eT;
+
+  const eT minValue = std::min(input.min(), eT(0));
+  const eT maxValue = std::max(input.max(), eT(0));
+  scale = (maxValue > minValue) ? (maxValue - minValue) / eT(255) : eT(1);
+  zeroPoint = (int32_t) std::min(std::max(std::round(-minValue / scale),
+      eT(0)), eT(255));
+
+  const eT* inputPtr = input.memptr();
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t i = 0; i < (size_t) input.n_elem; ++i)
+  {
+    const eT value = std::round(inputPtr[i] / scale) + zeroPoint;
+    quantized[i] = (uint8_t) std::min(std::max(value, eT(0)), eT(255));
+  }
+}
+
+/**
+ * Compute the dot product of `n` signed and unsigned 8-bit integers with 32-bit
+ * accumulation.  The loop is written so that compilers can vectorize it with
+ * the 8-bit multiply-add instructions of the target (e.g. AVX2 or AVX-512
+ * VNNI) when they are enabled.
+ */
+inline int32_t QuantizedDot(const int8_t* a, const uint8_t* b, const size_t n)
+{
+  int32_t sum = 0;
+  for (size_t k = 0; k < n; ++k)
+    sum += int32_t(a[k]) * int32_t(b[k]);
+
+  return sum;
+}
+
+/**
+ * Multiply quantized weights with a quantized input: for each column `j` of
+ * `input` and each column `i` of `weights`, compute
+ *
+ *   output[i * strideI + j * strideJ] = weightScales[i] * inputScale *
+ *       (dot(weights.col(i), input.col(j)) - zeroPoint * weightSums[i]) +
+ *       bias[i],
+ *
+ * where the bias is only added if `bias` is not empty.  The strides allow the
+ * result to be stored either by column (`strideI = 1`) or by row (`strideJ =
+ * 1`).
+ *
+ * @param weights Quantized weights, one column for each output channel.
+ * @param weightScales Scale of each column of `weights`.
+ * @param weightSums Sum of each column of `weights`.
+ * @param bias Bias of each output channel, or an empty matrix.
+ * @param input Quantized input, one column for each set of inputs.
+ * @param inputScale Scale of the quantized input.
+ * @param zeroPoint Zero point of the quantized input.
+ * @param output Memory to store the result in.
+ * @param strideI Distance between the results of consecutive channels.
+ * @param strideJ Distance between the results of consecutive columns.
+ */
+template<typename MatType>
+void QuantizedMultiply(const arma::Mat<int8_t>& weights,
+                       const MatType& weightScales,
+                       const arma::Col<int32_t>& weightSums,
+                       const MatType& bias,
+                       const arma::Mat<uint8_t>& input,
+                       const typename MatType::elem_type inputScale,
+                       const int32_t zeroPoint,
+                       typename MatType::elem_type* output,
+                       const size_t strideI,
+                       const size_t strideJ)
+{
+  typedef typename MatType::elem_type eT;
+
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t j = 0; j < (size_t) input.n_cols; ++j)
+  {
+    const uint8_t* inputPtr = input.colptr(j);
+    for (size_t i = 0; i < weights.n_cols; ++i)
+    {
+      const int32_t dot = QuantizedDot(weights.colptr(i), inputPtr,
+          weights.n_rows) - zeroPoint * weightSums[i];
+      eT value = weightScales[i] * inputScale * eT(dot);
+      if (!bias.is_empty())
+        value += bias[i];
+
+      output[i * strideI + j * strideJ] = value;
+    }
+  }
+}
+
+} // namespace mlpack
+
+#endif
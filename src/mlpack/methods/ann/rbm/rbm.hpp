@@ -12,7 +12,9 @@
 #define MLPACK_METHODS_ANN_RBM_RBM_HPP
 
 #include <mlpack/core.hpp>
-#include <mlpack/methods/ann/rbm/rbm_policies.hpp>
+#include <mlpack/methods/ann/make_alias.hpp>
+
+#include "rbm_policies.hpp"
 
 namespace mlpack {
 
@@ -25,6 +27,14 @@ namespace mlpack {
  * unsupervised ways, depending on the task. They are a variant of Boltzmann
  * machines, with the restriction that the neurons must form a bipartite graph.
  *
+ * For the BinaryRBM, each Gibbs step works on a whole batch of points with two
+ * matrix products, and the hidden and visible samples are drawn in bulk with
+ * `RandBernoulliFill()`.  With persistent contrastive divergence, the chains
+ * (one per point of a batch) are kept in a buffer between calls, and the
+ * buffers used by the Gibbs chains and the gradient are reused for each batch.
+ * The samples only depend on the random seed that was set when the RBM was
+ * created (see `RandomSeed()`), and not on the number of threads.
+ *
  * @tparam InitializationRuleType Rule used to initialize the network.
  * @tparam DataType The type of matrix to be used.
  * @tparam PolicyType The RBM variant to be used (BinaryRBM or SpikeSlabRBM).
@@ -96,6 +106,21 @@ class RBM
   template<typename OptimizerType, typename... CallbackType>
   double Train(OptimizerType& optimizer, CallbackType&&... callbacks);
 
+  /**
+   * Evaluate the RBM on the given batch and compute its gradient, with only
+   * one run of the Gibbs chains (calling Evaluate() and then Gradient() runs
+   * them twice).
+   *
+   * @param parameters Matrix model parameters.
+   * @param i Index of the first data point of the batch.
+   * @param gradient Variable to store the present gradient.
+   * @param batchSize Number of points in the batch.
+   */
+  double EvaluateWithGradient(const arma::Mat<ElemType>& parameters,
+                              const size_t i,
+                              arma::Mat<ElemType>& gradient,
+                              const size_t batchSize);
+
   /**
    * Evaluate the RBM network with the given parameters.
    * The function is needed for monitoring the progress of the network.
@@ -299,7 +324,9 @@ class RBM
   SampleSlab(InputType& slabMean, DataType& slab);
 
   /**
-   * This function does the k-step Gibbs Sampling.
+   * This function does the k-step Gibbs Sampling.  With persistent CD, the
+   * chains start from the last samples of the previous call instead of from
+   * `input`, as long as there are enough of them.
    *
    * @param input Input to the Gibbs function.
    * @param output Used for storing the negative sample.
@@ -379,13 +406,23 @@ class RBM
   void serialize(Archive& ar, const uint32_t version);
 
  private:
+  //! Make the weights and biases alias the parameters of the BinaryRBM.
+  template<typename Policy = PolicyType>
+  typename std::enable_if<std::is_same<Policy, BinaryRBM>::value, void>::type
+  SetAliases();
+
+  //! Make the weights and biases alias the parameters of the SpikeSlabRBM.
+  template<typename Policy = PolicyType>
+  typename std::enable_if<std::is_same<Policy, SpikeSlabRBM>::value, void>::type
+  SetAliases();
+
   //! Locally stored parameters of the network.
   arma::Mat<ElemType> parameter;
   //! The matrix of data points (predictors).
   arma::Mat<ElemType> predictors;
   // Initializer for initializing the weights of the network.
   InitializationRuleType initializeRule;
-  //! Locally-stored state of the persistent CD-k.
+  //! Locally-stored state of the persistent CD-k chains.
   arma::Mat<ElemType> state;
   //! Locally-stored number of data points.
   size_t numFunctions;
@@ -441,6 +478,14 @@ class RBM
   arma::Mat<ElemType> positiveGradient;
   //! Locally-stored temporary output of Gibbs chain.
   arma::Mat<ElemType> gibbsTemporary;
+  //! Locally-stored hidden activations of the gradient phases.
+  DataType phaseMean;
+  //! Locally-stored normal noise for the SpikeSlabRBM samples.
+  DataType noise;
+  //! Seed of the random numbers used for sampling.
+  uint64_t randomSeed;
+  //! Stream ID of the next bulk sampling.
+  uint64_t randomStream;
   //! Locally-stored persistent CD-k boolean flag.
   bool persistence;
   //! Locally-stored reset variable.
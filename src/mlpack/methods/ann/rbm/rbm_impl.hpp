@@ -46,6 +46,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::RBM(
     steps(0),
     slabPenalty(slabPenalty),
     radius(2 * radius),
+    randomSeed(RandomStreamSeed()),
+    randomStream(0),
     persistence(persistence),
     reset(false)
 {
@@ -68,13 +70,10 @@ RBM<InitializationRuleType, DataType, PolicyType>::Reset()
   negativeGradient.set_size(shape, 1);
   tempNegativeGradient.set_size(shape, 1);
   negativeSamples.set_size(visibleSize, batchSize);
-
-  weight = arma::Cube<ElemType>(parameter.memptr(), hiddenSize, visibleSize, 1,
-      false, false);
-  hiddenBias = DataType(parameter.memptr() + weight.n_elem,
-      hiddenSize, 1, false, false);
-  visibleBias = DataType(parameter.memptr() + weight.n_elem +
-      hiddenBias.n_elem, visibleSize, 1, false, false);
+  gibbsTemporary.set_size(hiddenSize, batchSize);
+  phaseMean.set_size(hiddenSize, batchSize);
+  state.clear();
+  SetAliases();
 
   parameter.zeros();
   positiveGradient.zeros();
@@ -85,6 +84,21 @@ RBM<InitializationRuleType, DataType, PolicyType>::Reset()
   reset = true;
 }
 
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+template<typename Policy>
+typename std::enable_if<std::is_same<Policy, BinaryRBM>::value, void>::type
+RBM<InitializationRuleType, DataType, PolicyType>::SetAliases()
+{
+  MakeAlias(weight, parameter.memptr(), hiddenSize, visibleSize, 1);
+  MakeAlias(hiddenBias, parameter.memptr() + weight.n_elem, hiddenSize, 1);
+  MakeAlias(visibleBias, parameter.memptr() + weight.n_elem +
+      hiddenBias.n_elem, visibleSize, 1);
+}
+
 template<
   typename InitializationRuleType,
   typename DataType,
@@ -115,7 +129,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::FreeEnergy(
   preActivation = (weight.slice(0) * input);
   preActivation.each_col() += hiddenBias;
   return -(accu(log(1 + arma::trunc_exp(preActivation))) +
-      dot(input, repmat(visibleBias, 1, input.n_cols)));
+      dot(visibleBias, sum(input, 1)));
 }
 
 template<
@@ -129,14 +143,19 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
     const InputType& input,
     DataType& gradient)
 {
-  arma::Cube<ElemType> weightGrad = arma::Cube<ElemType>(gradient.memptr(),
-      hiddenSize, visibleSize, 1, false, false);
-
-  DataType hiddenBiasGrad = DataType(gradient.memptr() + weightGrad.n_elem,
-      hiddenSize, 1, false, false);
-
-  HiddenMean(input, hiddenBiasGrad);
-  weightGrad.slice(0) = hiddenBiasGrad * input.t();
+  arma::Cube<ElemType> weightGrad;
+  MakeAlias(weightGrad, gradient.memptr(), hiddenSize, visibleSize, 1);
+  DataType hiddenBiasGrad, visibleBiasGrad;
+  MakeAlias(hiddenBiasGrad, gradient.memptr() + weightGrad.n_elem, hiddenSize,
+      1);
+  MakeAlias(visibleBiasGrad, gradient.memptr() + weightGrad.n_elem +
+      hiddenSize, visibleSize, 1);
+
+  // The gradient of the whole batch is computed at once.
+  HiddenMean(input, phaseMean);
+  weightGrad.slice(0) = phaseMean * input.t();
+  hiddenBiasGrad = sum(phaseMean, 1);
+  visibleBiasGrad = sum(input, 1);
 }
 
 template<
@@ -149,10 +168,44 @@ double RBM<InitializationRuleType, DataType, PolicyType>::Evaluate(
     const size_t i,
     const size_t batchSize)
 {
-  Gibbs(predictors.cols(i, i + batchSize - 1),
-      negativeSamples);
-  return std::fabs(FreeEnergy(predictors.cols(i,
-      i + batchSize - 1)) - FreeEnergy(negativeSamples));
+  arma::Mat<ElemType> batch;
+  MakeAlias(batch, ColPtr(predictors, i), predictors.n_rows, batchSize);
+
+  Gibbs(batch, negativeSamples);
+  return std::fabs(FreeEnergy(batch) - FreeEnergy(negativeSamples));
+}
+
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+double RBM<InitializationRuleType, DataType, PolicyType>::EvaluateWithGradient(
+    const arma::Mat<ElemType>& /* parameters */,
+    const size_t i,
+    arma::Mat<ElemType>& gradient,
+    const size_t batchSize)
+{
+  arma::Mat<ElemType> batch;
+  MakeAlias(batch, ColPtr(predictors, i), predictors.n_rows, batchSize);
+
+  positiveGradient.zeros();
+  negativeGradient.zeros();
+
+  Phase(batch, positiveGradient);
+
+  for (size_t s = 0; s < negSteps; ++s)
+  {
+    Gibbs(batch, negativeSamples);
+    Phase(negativeSamples, tempNegativeGradient);
+
+    negativeGradient += tempNegativeGradient;
+  }
+
+  gradient = ((negativeGradient / negSteps) - positiveGradient);
+
+  // The objective uses the samples of the last chain.
+  return std::fabs(FreeEnergy(batch) - FreeEnergy(negativeSamples));
 }
 
 template<
@@ -167,11 +220,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleHidden(
     arma::Mat<ElemType>& output)
 {
   HiddenMean(input, output);
-
-  for (size_t i = 0; i < output.n_elem; ++i)
-  {
-    output(i) = RandBernoulli(output(i));
-  }
+  RandBernoulliFill(output, output, randomSeed, randomStream++);
 }
 
 template<
@@ -186,11 +235,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
     arma::Mat<ElemType>& output)
 {
   VisibleMean(input, output);
-
-  for (size_t i = 0; i < output.n_elem; ++i)
-  {
-    output(i) = RandBernoulli(output(i));
-  }
+  RandBernoulliFill(output, output, randomSeed, randomStream++);
 }
 
 template<
@@ -237,25 +282,38 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gibbs(
 {
   this->steps = (steps == SIZE_MAX) ? this->numSteps : steps;
 
-  if (persistence && !state.is_empty())
+  // The BinaryRBM runs one chain per point of the batch; the SpikeSlabRBM
+  // samples a single chain from the whole batch.
+  const size_t chains = std::is_same<PolicyType, SpikeSlabRBM>::value ? 1 :
+      input.n_cols;
+
+  // Persistent chains continue from the previous call, as long as there are
+  // enough of them (the last batch of an epoch may be smaller).
+  if (persistence && state.n_rows == visibleSize && state.n_cols >= chains)
   {
-    SampleHidden(state, gibbsTemporary);
-    SampleVisible(gibbsTemporary, output);
+    arma::Mat<ElemType> chain;
+    MakeAlias(chain, state.memptr(), visibleSize, chains);
+    SampleHidden(chain, gibbsTemporary);
   }
   else
   {
     SampleHidden(input, gibbsTemporary);
-    SampleVisible(gibbsTemporary, output);
   }
+  SampleVisible(gibbsTemporary, output);
 
   for (size_t j = 1; j < this->steps; ++j)
   {
     SampleHidden(output, gibbsTemporary);
     SampleVisible(gibbsTemporary, output);
   }
+
   if (persistence)
   {
-    state = output;
+    // The chains are only allocated the first time (or for a larger batch).
+    if (state.n_rows != visibleSize || state.n_cols < chains)
+      state.set_size(visibleSize, chains);
+
+    state.head_cols(chains) = output;
   }
 }
 
@@ -265,27 +323,12 @@ template<
   typename PolicyType
 >
 void RBM<InitializationRuleType, DataType, PolicyType>::Gradient(
-    const arma::Mat<ElemType>& /*parameters*/,
+    const arma::Mat<ElemType>& parameters,
     const size_t i,
     arma::Mat<ElemType>& gradient,
     const size_t batchSize)
 {
-  positiveGradient.zeros();
-  negativeGradient.zeros();
-
-  Phase(predictors.cols(i, i + batchSize - 1),
-      positiveGradient);
-
-  for (size_t i = 0; i < negSteps; ++i)
-  {
-    Gibbs(predictors.cols(i, i + batchSize - 1),
-        negativeSamples);
-    Phase(negativeSamples, tempNegativeGradient);
-
-    negativeGradient += tempNegativeGradient;
-  }
-
-  gradient = ((negativeGradient / negSteps) - positiveGradient);
+  EvaluateWithGradient(parameters, i, gradient, batchSize);
 }
 
 template<
@@ -339,6 +382,12 @@ void RBM<InitializationRuleType, DataType, PolicyType>::serialize(
     positiveGradient.zeros();
     negativeGradient.zeros();
     tempNegativeGradient.zeros();
+
+    // The weights and biases were loaded as copies, so they have to alias the
+    // parameters again.
+    if (parameter.n_elem > 0)
+      SetAliases();
+
     reset = true;
   }
 }
@@ -39,16 +39,9 @@ RBM<InitializationRuleType, DataType, PolicyType>::Reset()
   spikeMean.set_size(hiddenSize, 1);
   spikeSamples.set_size(hiddenSize, 1);
   slabMean.set_size(poolSize, hiddenSize);
-
-  // Weight shape D * K * N
-  weight = arma::Cube<ElemType>(parameter.memptr(), visibleSize, poolSize,
-      hiddenSize, false, false);
-  // Spike bias shape N * 1
-  spikeBias = DataType(parameter.memptr() + weight.n_elem, hiddenSize, 1,
-      false, false);
-  // Visible penalty 1 * 1 => D * D(when used)
-  visiblePenalty = DataType(parameter.memptr() + weight.n_elem +
-      spikeBias.n_elem, 1, 1, false, false);
+  noise.set_size(poolSize, hiddenSize);
+  state.clear();
+  SetAliases();
 
   parameter.zeros();
   positiveGradient.zeros();
@@ -59,6 +52,24 @@ RBM<InitializationRuleType, DataType, PolicyType>::Reset()
   reset = true;
 }
 
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+template<typename Policy>
+typename std::enable_if<std::is_same<Policy, SpikeSlabRBM>::value, void>::type
+RBM<InitializationRuleType, DataType, PolicyType>::SetAliases()
+{
+  // Weight shape D * K * N
+  MakeAlias(weight, parameter.memptr(), visibleSize, poolSize, hiddenSize);
+  // Spike bias shape N * 1
+  MakeAlias(spikeBias, parameter.memptr() + weight.n_elem, hiddenSize, 1);
+  // Visible penalty 1 * 1 => D * D(when used)
+  MakeAlias(visiblePenalty, parameter.memptr() + weight.n_elem +
+      spikeBias.n_elem, 1, 1);
+}
+
 template<
   typename InitializationRuleType,
   typename DataType,
@@ -95,11 +106,12 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
     const InputType& input,
     DataType& gradient)
 {
-  arma::Cube<ElemType> weightGrad = arma::Cube<ElemType>
-      (gradient.memptr(), visibleSize, poolSize, hiddenSize, false, false);
+  arma::Cube<ElemType> weightGrad;
+  MakeAlias(weightGrad, gradient.memptr(), visibleSize, poolSize, hiddenSize);
 
-  DataType spikeBiasGrad = DataType(gradient.memptr() + weightGrad.n_elem,
-      hiddenSize, 1, false, false);
+  DataType spikeBiasGrad;
+  MakeAlias(spikeBiasGrad, gradient.memptr() + weightGrad.n_elem, hiddenSize,
+      1);
 
   SpikeMean(input, spikeMean);
   SampleSpike(spikeMean, spikeSamples);
@@ -130,9 +142,9 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleHidden(
 {
   output.set_size(hiddenSize + poolSize * hiddenSize, 1);
 
-  DataType spike(output.memptr(), hiddenSize, 1, false, false);
-  DataType slab(output.memptr() + hiddenSize, poolSize, hiddenSize, false,
-      false);
+  DataType spike, slab;
+  MakeAlias(spike, output.memptr(), hiddenSize, 1);
+  MakeAlias(slab, output.memptr() + hiddenSize, poolSize, hiddenSize);
 
   SpikeMean(input, spike);
   SampleSpike(spike, spike);
@@ -159,10 +171,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
 
   for (k = 0; k < numMaxTrials; ++k)
   {
-    for (size_t i = 0; i < visibleSize; ++i)
-    {
-      output(i) = RandNormal(visibleMean(i), 1.0 / visiblePenalty(0));
-    }
+    RandNormalFill(output, randomSeed, randomStream++);
+    output = visibleMean + output / visiblePenalty(0);
     if (norm(output, 2) < radius)
     {
       break;
@@ -191,9 +201,9 @@ RBM<InitializationRuleType, DataType, PolicyType>::VisibleMean(
 {
   output.zeros(visibleSize, 1);
 
-  DataType spike(input.memptr(), hiddenSize, 1, false, false);
-  DataType slab(input.memptr() + hiddenSize, poolSize, hiddenSize, false,
-      false);
+  DataType spike, slab;
+  MakeAlias(spike, input.memptr(), hiddenSize, 1);
+  MakeAlias(slab, input.memptr() + hiddenSize, poolSize, hiddenSize);
 
   for (size_t i = 0; i < hiddenSize; ++i)
   {
@@ -216,9 +226,9 @@ RBM<InitializationRuleType, DataType, PolicyType>::HiddenMean(
 {
   output.set_size(hiddenSize + poolSize * hiddenSize, 1);
 
-  DataType spike(output.memptr(), hiddenSize, 1, false, false);
-  DataType slab(output.memptr() + hiddenSize, poolSize, hiddenSize, false,
-      false);
+  DataType spike, slab;
+  MakeAlias(spike, output.memptr(), hiddenSize, 1);
+  MakeAlias(slab, output.memptr() + hiddenSize, poolSize, hiddenSize);
 
   SpikeMean(input, spike);
   SampleSpike(spike, spikeSamples);
@@ -255,10 +265,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSpike(
     InputType& spikeMean,
     DataType& spike)
 {
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    spike(i) = RandBernoulli(spikeMean(i));
-  }
+  RandBernoulliFill(spike, spikeMean, randomSeed, randomStream++);
 }
 
 template<
@@ -291,13 +298,10 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSlab(
     InputType& slabMean,
     DataType& slab)
 {
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    for (size_t j = 0; j < poolSize; ++j)
-    {
-      slab(j, i) = RandNormal(slabMean(j, i), 1.0 / slabPenalty);
-    }
-  }
+  // `slab` may be `slabMean` itself.
+  noise.set_size(poolSize, hiddenSize);
+  RandNormalFill(noise, randomSeed, randomStream++);
+  slab = slabMean + noise / slabPenalty;
 }
 
 } // namespace mlpack
@@ -15,6 +15,7 @@
 #include <mlpack/core.hpp>
 
 #include "ffn.hpp"
+#include "packed_sequences.hpp"
 
 namespace mlpack {
 
@@ -27,6 +28,15 @@ namespace mlpack {
  * each column is a data point, the `RNN` takes a cube format where each column
  * is a data point and each slice is a time step.
  *
+ * Sequences of different lengths can be given with their lengths to `Train()`
+ * and `Predict()`.  The sequences of each batch are then packed (see
+ * `PackedSequences`), so that the steps after the end of a sequence are not
+ * computed, and the slices after the end of a sequence are ignored (the
+ * predictions for them are zero).  Several recurrent layers can be stacked;
+ * if the first layer is a recurrent layer, it can prepare the whole sequence
+ * of inputs before the first step (e.g. `LSTM` computes the products of its
+ * input weights with the inputs of every step with one matrix product).
+ *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  */
@@ -160,6 +170,87 @@ class RNN
       arma::Cube<typename MatType::elem_type> responses,
       CallbackTypes&&... callbacks);
 
+  /**
+   * Train the recurrent network on sequences of different lengths using the
+   * given optimizer.  Sequence `i` has `sequenceLengths[i]` steps, and the
+   * slices of `predictors` and `responses` after its end are ignored.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization. If this is not what you want, then you should access the
+   * parameters vector directly with Parameters() and modify it as desired.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param sequenceLengths Length of each sequence (between 1 and
+   *      `predictors.n_slices`).
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  typename MatType::elem_type Train(
+      arma::Cube<typename MatType::elem_type> predictors,
+      arma::Cube<typename MatType::elem_type> responses,
+      arma::urowvec sequenceLengths,
+      OptimizerType& optimizer,
+      CallbackTypes&&... callbacks);
+
+  /**
+   * Train the recurrent network on sequences of different lengths.  By
+   * default, the RMSProp optimization algorithm is used, but others can be
+   * specified (such as ens::SGD).  Sequence `i` has `sequenceLengths[i]` steps,
+   * and the slices of `predictors` and `responses` after its end are ignored.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param sequenceLengths Length of each sequence (between 1 and
+   *      `predictors.n_slices`).
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::RMSProp, typename... CallbackTypes>
+  typename MatType::elem_type Train(
+      arma::Cube<typename MatType::elem_type> predictors,
+      arma::Cube<typename MatType::elem_type> responses,
+      arma::urowvec sequenceLengths,
+      CallbackTypes&&... callbacks);
+
+  /**
+   * Train the recurrent network on a dataset that is read shard by shard
+   * by the given loader, so that the whole dataset never has to be held in
+   * memory.
+   * In each pass, the optimizer is run on each shard in turn, starting from
+   * the parameters left by the previous shard, while the worker threads of the
+   * loader read (and transform) the next shards.
+   *
+   * The optimizer is run once for each shard, so its maximum number of
+   * iterations applies to each shard (e.g. set it to the number of points in
+   * a shard for one epoch over each shard).  Optimizers that keep state
+   * between runs (e.g. the SGD-based optimizers with `ResetPolicy()` set to
+   * false) keep it across shards.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param loader Loader that gives the shards of the dataset.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param passes Number of passes over the shards of the dataset.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The sum of the final objectives on each shard in the last pass.
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  typename MatType::elem_type Train(
+      data::PrefetchingLoader<arma::Cube<typename MatType::elem_type>>& loader,
+      OptimizerType& optimizer,
+      const size_t passes,
+      CallbackTypes&&... callbacks);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
@@ -173,6 +264,22 @@ class RNN
                arma::Cube<typename MatType::elem_type>& results,
                const size_t batchSize = 128);
 
+  /**
+   * Predict the responses to sequences of different lengths.  Sequence `i`
+   * has `sequenceLengths[i]` steps; the predictions for the slices after its
+   * end are zero.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param sequenceLengths Length of each sequence (between 1 and
+   *      `predictors.n_slices`).
+   * @param batchSize Batch size to use for prediction.
+   */
+  void Predict(const arma::Cube<typename MatType::elem_type>& predictors,
+               arma::Cube<typename MatType::elem_type>& results,
+               const arma::urowvec& sequenceLengths,
+               const size_t batchSize = 128);
+
   // Return the nujmber of weights in the model.
   size_t WeightSize() { return network.WeightSize(); }
 
@@ -207,6 +314,12 @@ class RNN
   //! Modify the number of steps allowed for BPTT.
   size_t& BPTTSteps() { return bpttSteps; }
 
+  //! Get the profiler that records the passes of each layer (NULL if none).
+  LayerProfiler* Profiler() const { return network.Profiler(); }
+  //! Modify the profiler that records the passes of each layer of every time
+  //! step (NULL by default); see `LayerProfiler`.
+  LayerProfiler*& Profiler() { return network.Profiler(); }
+
   /**
    * Reset the stored data of the network entirely.  This reset all weights of
    * each layer using `InitializationRuleType`, and prepares the network to
@@ -341,6 +454,18 @@ class RNN
   void ResetData(arma::Cube<typename MatType::elem_type> predictors,
                  arma::Cube<typename MatType::elem_type> responses);
 
+  /**
+   * Prepare the network for the given sequences of different lengths.
+   * This function won't actually trigger training process.
+   *
+   * @param predictors Input data variables.
+   * @param responses Outputs results from input data variables.
+   * @param sequenceLengths Length of each sequence.
+   */
+  void ResetData(arma::Cube<typename MatType::elem_type> predictors,
+                 arma::Cube<typename MatType::elem_type> responses,
+                 arma::urowvec sequenceLengths);
+
  private:
   // Helper functions.
 
@@ -355,6 +480,12 @@ class RNN
   void SetPreviousStep(const size_t step);
   //! Set the current step index of all recurrent layers to `step`.
   void SetCurrentStep(const size_t step);
+  //! Set the offset of the current step in the packed inputs of all recurrent
+  //! layers to `offset`.
+  void SetSequenceOffset(const size_t offset);
+  //! If the first layer is a recurrent layer, give it the packed inputs of the
+  //! sequences before the first step.
+  void PrepareSequence(const MatType& inputs);
 
   //! Number of timesteps to consider for backpropagation through time (BPTT).
   size_t bpttSteps;
@@ -375,6 +506,11 @@ class RNN
   //! The matrix of responses to the input data points.  This member is empty,
   //! except during training.
   arma::Cube<typename MatType::elem_type> responses;
+
+  //! The length of each training sequence, or an empty vector if each sequence
+  //! has `predictors.n_slices` steps.  This member is empty, except during
+  //! training.
+  arma::urowvec sequenceLengths;
 }; // class RNNType
 
 } // namespace mlpack
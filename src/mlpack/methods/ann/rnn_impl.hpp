@@ -98,6 +98,7 @@ RNN<
     network = other.network;
     predictors.clear();
     responses.clear();
+    sequenceLengths.clear();
   }
 
   return *this;
@@ -126,6 +127,7 @@ RNN<
     network = std::move(other.network);
     predictors.clear();
     responses.clear();
+    sequenceLengths.clear();
   }
 
   return *this;
@@ -199,6 +201,97 @@ typename MatType::elem_type RNN<
       callbacks...);
 }
 
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Train(
+    arma::Cube<typename MatType::elem_type> predictors,
+    arma::Cube<typename MatType::elem_type> responses,
+    arma::urowvec sequenceLengths,
+    OptimizerType& optimizer,
+    CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses),
+      std::move(sequenceLengths));
+
+  network.WarnMessageMaxIterations(optimizer, this->predictors.n_cols);
+
+  // Ensure that the network can be used.
+  network.CheckNetwork("RNN::Train()", this->predictors.n_rows, true, true);
+
+  // Train the model.
+  Timer::Start("rnn_optimization");
+  const typename MatType::elem_type out =
+      optimizer.Optimize(*this, network.Parameters(), callbacks...);
+  Timer::Stop("rnn_optimization");
+
+  Log::Info << "RNN::Train(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Train(
+    arma::Cube<typename MatType::elem_type> predictors,
+    arma::Cube<typename MatType::elem_type> responses,
+    arma::urowvec sequenceLengths,
+    CallbackTypes&&... callbacks)
+{
+  OptimizerType optimizer;
+  return Train(std::move(predictors), std::move(responses),
+      std::move(sequenceLengths), optimizer, callbacks...);
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Train(
+    data::PrefetchingLoader<arma::Cube<typename MatType::elem_type>>& loader,
+    OptimizerType& optimizer,
+    const size_t passes,
+    CallbackTypes&&... callbacks)
+{
+  typename MatType::elem_type objective = 0;
+  arma::Cube<typename MatType::elem_type> shardPredictors, shardResponses;
+  for (size_t pass = 0; pass < passes; ++pass)
+  {
+    loader.Reset();
+    objective = 0;
+
+    // The loader reads the next shards while the model is trained on this one.
+    while (loader.Next(shardPredictors, shardResponses))
+    {
+      objective += Train(std::move(shardPredictors), std::move(shardResponses),
+          optimizer, callbacks...);
+    }
+  }
+
+  return objective;
+}
+
 template<
     typename OutputLayerType,
     typename InitializationRuleType,
@@ -212,41 +305,70 @@ void RNN<
     const arma::Cube<typename MatType::elem_type>& predictors,
     arma::Cube<typename MatType::elem_type>& results,
     const size_t batchSize)
+{
+  Predict(predictors, results, arma::urowvec(), batchSize);
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Predict(
+    const arma::Cube<typename MatType::elem_type>& predictors,
+    arma::Cube<typename MatType::elem_type>& results,
+    const arma::urowvec& sequenceLengths,
+    const size_t batchSize)
 {
   // Ensure that the network is configured correctly.
   network.CheckNetwork("RNN::Predict()", predictors.n_rows, true, false);
+  PackedSequences<MatType>::CheckLengths(sequenceLengths, predictors.n_cols,
+      predictors.n_slices, "RNN::Predict()");
 
   results.set_size(network.network.OutputSize(), predictors.n_cols,
       predictors.n_slices);
 
-  MatType inputAlias, outputAlias;
+  PackedSequences<MatType> batch;
+  MatType packedPredictors, packedResults, inputAlias, outputAlias;
   for (size_t i = 0; i < predictors.n_cols; i += batchSize)
   {
     const size_t effectiveBatchSize = std::min(batchSize,
         size_t(predictors.n_cols) - i);
 
+    batch.Reset(sequenceLengths, predictors.n_slices, i, effectiveBatchSize);
+    batch.Pack(predictors, packedPredictors);
+    packedResults.set_size(results.n_rows, batch.Columns());
+
     // Since we aren't doing a backward pass, we don't actually need to store
     // the state for each time step---we can fit it all in one buffer.
     ResetMemoryState(1, effectiveBatchSize);
+    PrepareSequence(packedPredictors);
     SetPreviousStep(size_t(-1));
     SetCurrentStep(size_t(0));
 
     // Iterate over all time steps.
-    for (size_t t = 0; t < predictors.n_slices; ++t)
+    for (size_t t = 0; t < batch.Steps(); ++t)
     {
       // If it is after the first step, we have a previous state.
       if (t == 1)
         SetPreviousStep(size_t(0));
 
-      // Create aliases for the input and output.
-      MakeAlias(inputAlias,
-          (typename MatType::elem_type*) predictors.slice(t).colptr(i),
-          predictors.n_rows, effectiveBatchSize);
-      MakeAlias(outputAlias, results.slice(t).colptr(i), results.n_rows,
-          effectiveBatchSize);
+      // Create aliases for the input and output of the sequences that are
+      // still running.
+      SetSequenceOffset(batch.StepOffset(t));
+      MakeAlias(inputAlias, packedPredictors.colptr(batch.StepOffset(t)),
+          packedPredictors.n_rows, batch.StepSize(t));
+      MakeAlias(outputAlias, packedResults.colptr(batch.StepOffset(t)),
+          packedResults.n_rows, batch.StepSize(t));
 
       network.Forward(inputAlias, outputAlias);
     }
+
+    batch.Unpack(packedResults, results);
   }
 }
 
@@ -311,6 +433,7 @@ void RNN<
       // middle of training and resume.
       predictors.clear();
       responses.clear();
+      sequenceLengths.clear();
     }
   #endif
 }
@@ -331,33 +454,48 @@ typename MatType::elem_type RNN<
 {
   // Ensure the network is valid.
   network.CheckNetwork("RNN::Evaluate()", predictors.n_rows);
+  network.network.KeepOutputs() = false;
+
+  PackedSequences<MatType> batch;
+  MatType packedPredictors, packedResponses;
+  batch.Reset(sequenceLengths, predictors.n_slices, begin, batchSize);
+  batch.Pack(predictors, packedPredictors);
+  batch.Pack(responses, packedResponses);
 
   // The core of the computation here is to pass through each step.  Since we
   // are not computing the gradient, we can be "clever" and use only one memory
   // cell---we don't need to know about the past.
   ResetMemoryState(1, batchSize);
+  PrepareSequence(packedPredictors);
   SetCurrentStep(0);
   SetPreviousStep(size_t(-1));
   MatType output(network.network.OutputSize(), batchSize);
 
   typename MatType::elem_type loss = 0.0;
-  MatType stepData, responseData;
-  for (size_t t = 0; t < predictors.n_slices; ++t)
+  MatType stepData, outputData, responseData;
+  for (size_t t = 0; t < batch.Steps(); ++t)
   {
     if (t == 1)
       SetPreviousStep(0);
 
-    // Manually reset the data of the network to be an alias of the current time
-    // step.
-    MakeAlias(network.predictors, predictors.slice(t).colptr(begin),
-        predictors.n_rows, batchSize);
-    const size_t responseStep = (single) ? 0 : t;
-    MakeAlias(network.responses, responses.slice(responseStep).colptr(begin),
-        responses.n_rows, batchSize);
+    // Only the sequences that are still running are passed through the
+    // network.
+    const size_t offset = batch.StepOffset(t);
+    SetSequenceOffset(offset);
+    MakeAlias(stepData, packedPredictors.colptr(offset),
+        packedPredictors.n_rows, batch.StepSize(t));
+    MakeAlias(outputData, output.memptr(), output.n_rows, batch.StepSize(t));
+    MakeAlias(responseData, packedResponses.colptr(offset),
+        packedResponses.n_rows, batch.StepSize(t));
 
-    loss += network.Evaluate(output, begin, batchSize);
+    network.network.Forward(stepData, outputData);
+    loss += network.outputLayer.Forward(outputData, responseData);
   }
 
+  // Add loss (this is not dependent on time steps, and should only be added
+  // once).
+  loss += network.network.Loss();
+
   return loss;
 }
 
@@ -396,63 +534,62 @@ typename MatType::elem_type RNN<
 {
   network.CheckNetwork("RNN::EvaluateWithGradient()", predictors.n_rows);
 
+  // The backward passes need the outputs of the layers.
+  network.network.KeepOutputs() = true;
+
   typename MatType::elem_type loss = 0;
 
-  // We must save anywhere between 1 and `bpttSteps` states, but we are limited
-  // by `predictors.n_slices`.
+  // Pack the sequences of the batch, so that each step only computes the
+  // sequences that are still running.
+  PackedSequences<MatType> batch;
+  MatType packedPredictors, packedResponses;
+  batch.Reset(sequenceLengths, predictors.n_slices, begin, batchSize);
+  batch.Pack(predictors, packedPredictors);
+  batch.Pack(responses, packedResponses);
+
+  // We must backpropagate through anywhere between 1 and `bpttSteps` steps,
+  // but we are limited by the length of the longest sequence.
+  const size_t steps = batch.Steps();
   const size_t effectiveBPTTSteps = std::max(size_t(1),
-      std::min(bpttSteps, size_t(predictors.n_slices)));
+      std::min(bpttSteps, steps));
+
+  // Only the states of the last `effectiveBPTTSteps` steps, and of the step
+  // before them, have to be kept; the earlier steps alternate between two
+  // memory slots.  So the memory does not depend on the length of the
+  // sequences.
+  const size_t slots = std::min(steps, effectiveBPTTSteps + 1);
+  const size_t firstKeptStep = steps - slots;
+  auto slot = [firstKeptStep](const size_t t)
+  {
+    return (t >= firstKeptStep) ? t - firstKeptStep : (firstKeptStep - t) % 2;
+  };
 
-  ResetMemoryState(effectiveBPTTSteps, batchSize);
+  ResetMemoryState(slots, batchSize);
+  PrepareSequence(packedPredictors);
   SetPreviousStep(size_t(-1));
   arma::Cube<typename MatType::elem_type> outputs(
-      network.network.OutputSize(), batchSize, effectiveBPTTSteps);
+      network.network.OutputSize(), batchSize, slots);
 
-  // If `bpttSteps` is less than the number of time steps in the data, then for
-  // the first few steps, we won't actually need to hold onto any historical
-  // information, since BPTT will never go back that far.
-  const size_t extraSteps = (predictors.n_slices - effectiveBPTTSteps + 1);
   MatType stepData, outputData, responseData;
-  for (size_t t = 0; t < std::min(size_t(predictors.n_slices), extraSteps); ++t)
+  for (size_t t = 0; t < steps; ++t)
   {
-    SetCurrentStep(0);
+    const size_t offset = batch.StepOffset(t);
+    SetCurrentStep(slot(t));
+    SetSequenceOffset(offset);
 
     // Make an alias of the step's data.
-    MakeAlias(stepData, predictors.slice(t).colptr(begin), predictors.n_rows,
-        batchSize);
-    MakeAlias(outputData, outputs.slice(t).memptr(), outputs.n_rows,
-        outputs.n_cols);
+    MakeAlias(stepData, packedPredictors.colptr(offset),
+        packedPredictors.n_rows, batch.StepSize(t));
+    MakeAlias(outputData, outputs.slice(slot(t)).memptr(), outputs.n_rows,
+        batch.StepSize(t));
     network.network.Forward(stepData, outputData);
 
-    const size_t responseStep = (single) ? 0 : t;
-    MakeAlias(responseData, responses.slice(responseStep).colptr(begin),
-        responses.n_rows, batchSize);
+    MakeAlias(responseData, packedResponses.colptr(offset),
+        packedResponses.n_rows, batch.StepSize(t));
 
     loss += network.outputLayer.Forward(outputData, responseData);
 
-    SetPreviousStep(0);
-  }
-
-  // Next, we reach the time steps that will be used for BPTT, for which we must
-  // preserve step data.
-  for (size_t t = extraSteps; t < predictors.n_slices; ++t)
-  {
-    SetCurrentStep(t - extraSteps + 1);
-
-    // Wrap a matrix around our data to avoid a copy.
-    MakeAlias(stepData, predictors.slice(t).colptr(begin), predictors.n_rows,
-        batchSize);
-    MakeAlias(outputData, outputs.slice(t).memptr(), outputs.n_rows,
-        outputs.n_cols);
-    network.network.Forward(stepData, outputData);
-
-    const size_t responseStep = (single) ? 0 : t;
-    MakeAlias(responseData, responses.slice(responseStep).colptr(begin),
-        responses.n_rows, batchSize);
-
-    loss += network.outputLayer.Forward(outputData, responseData);
-
-    SetPreviousStep(t - extraSteps + 1);
+    SetPreviousStep(slot(t));
   }
 
   // Add loss (this is not dependent on time steps, and should only be added
@@ -465,14 +602,36 @@ typename MatType::elem_type RNN<
   currentGradient.zeros(network.Parameters().n_rows,
       network.Parameters().n_cols);
 
-  SetPreviousStep(size_t(-1));
-  const size_t minStep = predictors.n_slices - effectiveBPTTSteps + 1;
-  for (size_t t = predictors.n_slices; t >= minStep; --t)
+  // The network only keeps the outputs of its layers for the last step, so the
+  // forward pass of each earlier step is computed again before its backward
+  // pass.  (The recurrent layers compute the same state into the same slot.)
+  const bool recompute = (network.network.Network().size() > 1);
+  MatType recomputedOutput;
+
+  const size_t minStep = steps - effectiveBPTTSteps + 1;
+  for (size_t t = steps; t >= minStep; --t)
   {
-    SetCurrentStep(t - 1);
+    const size_t offset = batch.StepOffset(t - 1);
+    const size_t stepSize = batch.StepSize(t - 1);
+    MakeAlias(stepData, packedPredictors.colptr(offset),
+        packedPredictors.n_rows, stepSize);
+    MakeAlias(outputData, outputs.slice(slot(t - 1)).colptr(0),
+        outputs.n_rows, stepSize);
+
+    SetCurrentStep(slot(t - 1));
+    SetSequenceOffset(offset);
+    if (recompute && t < steps)
+    {
+      SetPreviousStep((t == 1) ? size_t(-1) : slot(t - 2));
+      recomputedOutput.set_size(outputs.n_rows, stepSize);
+      network.network.Forward(stepData, recomputedOutput);
+    }
+
+    // During the backward pass, the previous step is the one after this one.
+    SetPreviousStep((t == steps) ? size_t(-1) : slot(t));
 
     currentGradient.zeros();
-    MatType error(outputs.n_rows, outputs.n_cols);
+    MatType error(outputs.n_rows, stepSize);
 
     // Set up the response by backpropagating through the output layer.  Note
     // that if we are in 'single' mode, we don't care what the network outputs
@@ -484,27 +643,17 @@ typename MatType::elem_type RNN<
     }
     else
     {
-      MakeAlias(outputData, outputs.slice(t - 1).colptr(0), outputs.n_rows,
-          outputs.n_cols);
-      const size_t respStep = (single) ? 0 : t - 1;
-      MakeAlias(responseData, responses.slice(respStep).colptr(begin),
-          responses.n_rows, batchSize);
+      MakeAlias(responseData, packedResponses.colptr(offset),
+          packedResponses.n_rows, stepSize);
       network.outputLayer.Backward(outputData, responseData, error);
     }
 
     // Now pass that error backwards through the network.
-    MakeAlias(stepData, predictors.slice(t - 1).colptr(begin),
-        predictors.n_rows, batchSize);
-    MakeAlias(outputData, outputs.slice(t - 1).colptr(0), outputs.n_rows,
-        outputs.n_cols);
-
     MatType networkDelta;
     network.network.Backward(stepData, outputData, error, networkDelta);
 
     network.network.Gradient(stepData, error, currentGradient);
     gradient += currentGradient;
-
-    SetPreviousStep(t - 1);
   }
 
   return loss;
@@ -540,7 +689,7 @@ void RNN<
     MatType
 >::Shuffle()
 {
-  ShuffleData(predictors, responses, predictors, responses);
+  PackedSequences<MatType>::Shuffle(predictors, responses, sequenceLengths);
 }
 
 template<
@@ -558,6 +707,29 @@ void RNN<
 {
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  this->sequenceLengths.clear();
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ResetData(
+    arma::Cube<typename MatType::elem_type> predictors,
+    arma::Cube<typename MatType::elem_type> responses,
+    arma::urowvec sequenceLengths)
+{
+  PackedSequences<MatType>::CheckLengths(sequenceLengths, predictors.n_cols,
+      predictors.n_slices, "RNN::ResetData()");
+
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+  this->sequenceLengths = std::move(sequenceLengths);
 }
 
 template<
@@ -626,6 +798,45 @@ void RNN<
   }
 }
 
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::SetSequenceOffset(const size_t offset)
+{
+  for (Layer<MatType>* l : network.Network())
+  {
+    // We can only call SequenceOffset() on RecurrentLayers.
+    RecurrentLayer<MatType>* r =
+        dynamic_cast<RecurrentLayer<MatType>*>(l);
+    if (r != nullptr)
+      r->SequenceOffset() = offset;
+  }
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::PrepareSequence(const MatType& inputs)
+{
+  // Only the inputs of the first layer are known before the first step.
+  RecurrentLayer<MatType>* r =
+      dynamic_cast<RecurrentLayer<MatType>*>(network.Network().front());
+  if (r != nullptr)
+    r->PrepareSequence(inputs);
+}
+
 } // namespace mlpack
 
 #endif
@@ -0,0 +1,351 @@
+/**
+ * @file methods/ann/static_ffn.hpp
+ *
+ * Definition of the StaticFFN class, a feed forward network whose layers are
+ * fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_HPP
+
+#include <mlpack/core.hpp>
+
+#include "init_rules/init_rules.hpp"
+#include "loss_functions/loss_functions.hpp"
+#include "make_alias.hpp"
+
+#include <ensmallen.hpp>
+
+namespace mlpack {
+
+/**
+ * A feed forward network whose layers are given as template parameters, for
+ * small networks (e.g. the Q-networks of reinforcement learning agents, or
+ * small MLPs on tabular data) where the overhead of `FFN` matters.  The layers
+ * are held by value, every call to a layer is resolved at compile time (so
+ * the whole pipeline can be inlined), and the shapes of the layers are
+ * computed once, at construction.
+ *
+ * The layers are the same classes as for `FFN`, and the parameters are laid
+ * out in the same order, so a `StaticFFN` with the same layers as an `FFN` can
+ * use its weights:
+ *
+ * @code
+ * FFN<MeanSquaredError> model;
+ * model.Add<Linear>(16);
+ * model.Add<ReLU>();
+ * model.Add<Linear>(2);
+ * model.Train(data, responses);
+ *
+ * StaticFFN<MeanSquaredError, RandomInitialization, arma::mat,
+ *     Linear, ReLU, Linear> staticModel({ data.n_rows }, Linear(16), ReLU(),
+ *     Linear(2));
+ * staticModel.Parameters() = model.Parameters();
+ * staticModel.Predict(data, predictions);
+ * @endcode
+ *
+ * Unlike `FFN`, layers cannot be added or removed, and no inference-time
+ * folding of the layers, data parallelism, or activation checkpointing is
+ * done.
+ *
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ * @tparam InitializationRuleType Rule used to initialize the weight matrix.
+ * @tparam MatType Type of matrix given as input to the network.
+ * @tparam LayerTypes Types of the layers of the network, in order.
+ */
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+class StaticFFN
+{
+ public:
+  //! The number of layers of the network.
+  static constexpr size_t NumLayers = sizeof...(LayerTypes);
+  static_assert(NumLayers > 0, "StaticFFN must have at least one layer!");
+
+  //! The type of the `I`th layer.
+  template<size_t I>
+  using LayerType =
+      typename std::tuple_element<I, std::tuple<LayerTypes...>>::type;
+
+  /**
+   * Create an empty network with default-constructed layers.  This is only
+   * useful for loading a network with `serialize()`.
+   */
+  StaticFFN();
+
+  /**
+   * Create the network from the given layers, and initialize its weights with
+   * `InitializationRuleType`.
+   *
+   * @param inputDimensions Dimensions of each input point.
+   * @param layers Layers of the network, in order.
+   */
+  StaticFFN(const std::vector<size_t>& inputDimensions, LayerTypes... layers);
+
+  //! Copy the given network.
+  StaticFFN(const StaticFFN& other);
+  //! Take ownership of the given network.
+  StaticFFN(StaticFFN&& other);
+  //! Copy the given network.
+  StaticFFN& operator=(const StaticFFN& other);
+  //! Take ownership of the given network.
+  StaticFFN& operator=(StaticFFN&& other);
+
+  //! Get the `I`th layer.
+  template<size_t I>
+  const LayerType<I>& Get() const { return std::get<I>(layers); }
+  //! Modify the `I`th layer.
+  template<size_t I>
+  LayerType<I>& Get() { return std::get<I>(layers); }
+
+  //! Get the output layer.
+  const OutputLayerType& OutputLayer() const { return outputLayer; }
+  //! Modify the output layer.
+  OutputLayerType& OutputLayer() { return outputLayer; }
+
+  //! Get the dimensions of each input point.
+  const std::vector<size_t>& InputDimensions() const
+  {
+    return inputDimensions;
+  }
+
+  //! Get the size of each output point.
+  size_t OutputSize() const { return outputSizes[NumLayers - 1]; }
+
+  //! Return the weights of the network.  These are linearized, in the same
+  //! order as for an `FFN` with the same layers.
+  const MatType& Parameters() const { return parameters; }
+  //! Modify the weights of the network.  The size must not be changed.
+  MatType& Parameters() { return parameters; }
+
+  //! Initialize the weights of the network again with
+  //! `InitializationRuleType`.  This also sets the network to testing mode.
+  void Reset();
+
+  //! Set all the layers to training mode if `training` is `true`, or to
+  //! testing mode otherwise.
+  void SetNetworkMode(const bool training);
+
+  /**
+   * Train the network on the given data with the given optimizer.  The
+   * current weights are used as a starting point.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  typename MatType::elem_type Train(MatType predictors,
+                                    MatType responses,
+                                    OptimizerType& optimizer,
+                                    CallbackTypes&&... callbacks);
+
+  /**
+   * Train the network on the given data with a default-constructed optimizer
+   * (by default, RMSProp).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::RMSProp, typename... CallbackTypes>
+  typename MatType::elem_type Train(MatType predictors,
+                                    MatType responses,
+                                    CallbackTypes&&... callbacks);
+
+  /**
+   * Predict the responses to the given predictors, in testing mode.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to predict at once.
+   */
+  void Predict(const MatType& predictors,
+               MatType& results,
+               const size_t batchSize = 128);
+
+  /**
+   * Perform a manual forward pass of the data, in the current mode of the
+   * network.  The outputs of the layers are kept for `Backward()`.
+   *
+   * @param inputs The input data.
+   * @param results The predicted results.
+   */
+  void Forward(const MatType& inputs, MatType& results);
+
+  /**
+   * Perform a manual backward pass after a call to `Forward()`.
+   *
+   * @param inputs Inputs of the preceding call to `Forward()`.
+   * @param targets The training target.
+   * @param gradients Computed gradients.
+   * @return Training error of the current pass.
+   */
+  typename MatType::elem_type Backward(const MatType& inputs,
+                                       const MatType& targets,
+                                       MatType& gradients);
+
+  /**
+   * Evaluate the network with the given predictors and responses, in the
+   * current mode of the network.
+   *
+   * @param predictors Input variables.
+   * @param responses Target outputs for input variables.
+   */
+  typename MatType::elem_type Evaluate(const MatType& predictors,
+                                       const MatType& responses);
+
+  //! Serialize the network.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+  //
+  // Only ensmallen utility functions for training are found below here.
+  // They aren't generally useful otherwise.
+  //
+
+  //! Evaluate the network on all the training data.
+  typename MatType::elem_type Evaluate(const MatType& parameters);
+
+  //! Evaluate the network on the training points `begin` to
+  //! `begin + batchSize - 1`.
+  typename MatType::elem_type Evaluate(const MatType& parameters,
+                                       const size_t begin,
+                                       const size_t batchSize);
+
+  //! Evaluate the network and its gradient on the training points `begin` to
+  //! `begin + batchSize - 1`.
+  typename MatType::elem_type EvaluateWithGradient(const MatType& parameters,
+                                                   const size_t begin,
+                                                   MatType& gradient,
+                                                   const size_t batchSize);
+
+  //! Compute the gradient of the network on the training points `begin` to
+  //! `begin + batchSize - 1`.
+  void Gradient(const MatType& parameters,
+                const size_t begin,
+                MatType& gradient,
+                const size_t batchSize);
+
+  //! Return the number of separable functions (the number of training points).
+  size_t NumFunctions() const { return responses.n_cols; }
+
+  //! Shuffle the training data.
+  void Shuffle();
+
+  //! Prepare the network for training on the given data.
+  void ResetData(MatType predictors, MatType responses);
+
+ private:
+  //! Tag for the `I`th step of a pass through the layers.
+  template<size_t I>
+  using Step = std::integral_constant<size_t, I>;
+
+  //! Apply `f` to each layer, in order.
+  template<typename FunctionType, size_t... I>
+  void ForEachLayer(FunctionType&& f, std::index_sequence<I...>);
+
+  //! Compute the dimensions and weight offsets of the layers.
+  void ComputeDimensions();
+
+  //! Ensure that the input and the parameters match the layers, and make the
+  //! weights of the layers alias `parameters` if they don't already.
+  void CheckNetwork(const std::string& functionName, const size_t inputRows);
+
+  //! Pass `input` through the layers from the `I`th layer on; the output of
+  //! the last layer is stored in `results`.
+  template<size_t I>
+  void ForwardLayers(const MatType& input, MatType& results, Step<I>);
+  //! End of the forward pass.
+  void ForwardLayers(const MatType& /* input */,
+                     MatType& /* results */,
+                     Step<NumLayers>) { }
+
+  //! Step `J` of the backward pass, which handles the layer
+  //! `NumLayers - 1 - J`: pass `gy` backward through it, compute its gradient,
+  //! and go on with the previous layer.
+  template<size_t J>
+  void BackwardLayers(const MatType& input,
+                      const MatType& output,
+                      const MatType& gy,
+                      MatType& gradient,
+                      Step<J>);
+  //! End of the backward pass.
+  void BackwardLayers(const MatType& /* input */,
+                      const MatType& /* output */,
+                      const MatType& /* gy */,
+                      MatType& /* gradient */,
+                      Step<NumLayers>) { }
+
+  //! Get the input of the `I`th layer.
+  template<size_t I>
+  const MatType& LayerInput(const MatType& /* input */, Step<I>) const
+  {
+    return layerOutputs[I - 1];
+  }
+  //! Get the input of the first layer.
+  const MatType& LayerInput(const MatType& input, Step<0>) const
+  {
+    return input;
+  }
+
+  //! Sum the extra losses of the layers.
+  typename MatType::elem_type LayerLoss();
+
+  //! The output layer used to evaluate the network.
+  OutputLayerType outputLayer;
+  //! Rule used to initialize the weights.
+  InitializationRuleType initializeRule;
+  //! The layers of the network.
+  std::tuple<LayerTypes...> layers;
+
+  //! The weights of all the layers.
+  MatType parameters;
+  //! The memory that the weights of the layers alias (NULL if not set).
+  const typename MatType::elem_type* layerMemory;
+
+  //! Dimensions of each input point.
+  std::vector<size_t> inputDimensions;
+  //! Size of the output of each layer.
+  std::array<size_t, NumLayers> outputSizes;
+  //! Number of weights of each layer.
+  std::array<size_t, NumLayers> weightSizes;
+  //! Offset of the weights of each layer in `parameters`.
+  std::array<size_t, NumLayers> weightOffsets;
+
+  //! Outputs of each layer but the last, kept for the backward pass.
+  std::array<MatType, NumLayers> layerOutputs;
+  //! Deltas of each layer.
+  std::array<MatType, NumLayers> layerDeltas;
+  //! Output of the network during training.
+  MatType networkOutput;
+  //! Error of the output layer.
+  MatType error;
+
+  //! The training data; only set during training.
+  MatType predictors;
+  //! The training responses; only set during training.
+  MatType responses;
+}; // class StaticFFN
+
+} // namespace mlpack
+
+// Include implementation.
+#include "static_ffn_impl.hpp"
+
+#endif
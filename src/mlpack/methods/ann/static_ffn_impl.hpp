@@ -0,0 +1,733 @@
+/**
+ * @file methods/ann/static_ffn_impl.hpp
+ *
+ * Implementation of the StaticFFN class, a feed forward network whose layers
+ * are fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "static_ffn.hpp"
+
+namespace mlpack {
+
+// The layers are called with qualified names (e.g. `layer.L::Forward()`), so
+// that the calls are not virtual and can be inlined.
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+constexpr size_t StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::NumLayers;
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::StaticFFN() :
+    layerMemory(NULL)
+{
+  outputSizes.fill(0);
+  weightSizes.fill(0);
+  weightOffsets.fill(0);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::StaticFFN(const std::vector<size_t>& inputDimensions,
+             LayerTypes... layers) :
+    layers(std::move(layers)...),
+    layerMemory(NULL),
+    inputDimensions(inputDimensions)
+{
+  if (inputDimensions.empty())
+  {
+    throw std::invalid_argument("StaticFFN::StaticFFN(): the input dimensions "
+        "must not be empty!");
+  }
+
+  ComputeDimensions();
+  Reset();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::StaticFFN(const StaticFFN& other) :
+    outputLayer(other.outputLayer),
+    initializeRule(other.initializeRule),
+    layers(other.layers),
+    parameters(other.parameters),
+    // The copied layers have to be pointed at the copied parameters.
+    layerMemory(NULL),
+    inputDimensions(other.inputDimensions),
+    outputSizes(other.outputSizes),
+    weightSizes(other.weightSizes),
+    weightOffsets(other.weightOffsets),
+    predictors(other.predictors),
+    responses(other.responses)
+{
+  // Nothing to do.
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::StaticFFN(StaticFFN&& other) :
+    outputLayer(std::move(other.outputLayer)),
+    initializeRule(std::move(other.initializeRule)),
+    layers(std::move(other.layers)),
+    parameters(std::move(other.parameters)),
+    // Aliases will not be correct after a std::move(), so we will manually
+    // reset them.
+    layerMemory(NULL),
+    inputDimensions(std::move(other.inputDimensions)),
+    outputSizes(other.outputSizes),
+    weightSizes(other.weightSizes),
+    weightOffsets(other.weightOffsets),
+    predictors(std::move(other.predictors)),
+    responses(std::move(other.responses))
+{
+  other.layerMemory = NULL;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+StaticFFN<OutputLayerType, InitializationRuleType, MatType, LayerTypes...>&
+StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::operator=(const StaticFFN& other)
+{
+  if (this != &other)
+  {
+    outputLayer = other.outputLayer;
+    initializeRule = other.initializeRule;
+    layers = other.layers;
+    parameters = other.parameters;
+    layerMemory = NULL;
+    inputDimensions = other.inputDimensions;
+    outputSizes = other.outputSizes;
+    weightSizes = other.weightSizes;
+    weightOffsets = other.weightOffsets;
+    predictors = other.predictors;
+    responses = other.responses;
+  }
+
+  return *this;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+StaticFFN<OutputLayerType, InitializationRuleType, MatType, LayerTypes...>&
+StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::operator=(StaticFFN&& other)
+{
+  if (this != &other)
+  {
+    outputLayer = std::move(other.outputLayer);
+    initializeRule = std::move(other.initializeRule);
+    layers = std::move(other.layers);
+    parameters = std::move(other.parameters);
+    layerMemory = NULL;
+    other.layerMemory = NULL;
+    inputDimensions = std::move(other.inputDimensions);
+    outputSizes = other.outputSizes;
+    weightSizes = other.weightSizes;
+    weightOffsets = other.weightOffsets;
+    predictors = std::move(other.predictors);
+    responses = std::move(other.responses);
+  }
+
+  return *this;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+void StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::Reset()
+{
+  // The layers are initialized in the same way as the layers of an FFN.
+  std::vector<mlpack::Layer<MatType>*> network;
+  ForEachLayer([&](mlpack::Layer<MatType>& layer)
+  {
+    network.push_back(&layer);
+  }, std::index_sequence_for<LayerTypes...>());
+
+  parameters.clear();
+  NetworkInitialization<InitializationRuleType> networkInit(initializeRule);
+  networkInit.Initialize(network, parameters);
+
+  for (size_t i = 0; i < NumLayers; ++i)
+  {
+    if (weightSizes[i] == 0)
+      continue;
+
+    MatType layerWeights;
+    MakeAlias(layerWeights, MemPtr(parameters) + weightOffsets[i],
+        weightSizes[i], 1);
+    network[i]->CustomInitialize(layerWeights, weightSizes[i]);
+  }
+
+  layerMemory = NULL;
+  CheckNetwork("StaticFFN::Reset()", std::accumulate(inputDimensions.begin(),
+      inputDimensions.end(), size_t(1), std::multiplies<size_t>()));
+  SetNetworkMode(false);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+void StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::SetNetworkMode(const bool training)
+{
+  ForEachLayer([&](auto& layer)
+  {
+    typedef typename std::remove_reference<decltype(layer)>::type L;
+    layer.L::Training() = training;
+  }, std::index_sequence_for<LayerTypes...>());
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::Train(MatType predictors,
+         MatType responses,
+         OptimizerType& optimizer,
+         CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses));
+  CheckNetwork("StaticFFN::Train()", this->predictors.n_rows);
+
+  Timer::Start("static_ffn_optimization");
+  const typename MatType::elem_type out =
+      optimizer.Optimize(*this, parameters, callbacks...);
+  Timer::Stop("static_ffn_optimization");
+
+  Log::Info << "StaticFFN::Train(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::Train(MatType predictors,
+         MatType responses,
+         CallbackTypes&&... callbacks)
+{
+  OptimizerType optimizer;
+  return Train(std::move(predictors), std::move(responses), optimizer,
+      callbacks...);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+void StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::Predict(const MatType& predictors,
+           MatType& results,
+           const size_t batchSize)
+{
+  CheckNetwork("StaticFFN::Predict()", predictors.n_rows);
+  SetNetworkMode(false);
+
+  results.set_size(OutputSize(), predictors.n_cols);
+  for (size_t i = 0; i < predictors.n_cols; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols) - i);
+
+    MatType predictorsBatch, resultsBatch;
+    MakeAlias(predictorsBatch, ColPtr(predictors, i), predictors.n_rows,
+        effectiveBatchSize);
+    MakeAlias(resultsBatch, ColPtr(results, i), results.n_rows,
+        effectiveBatchSize);
+
+    ForwardLayers(predictorsBatch, resultsBatch, Step<0>());
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+void StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::Forward(const MatType& inputs, MatType& results)
+{
+  CheckNetwork("StaticFFN::Forward()", inputs.n_rows);
+
+  // The output is kept in case Backward() is called.
+  ForwardLayers(inputs, networkOutput, Step<0>());
+  results = networkOutput;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+typename MatType::elem_type StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::Backward(const MatType& inputs,
+            const MatType& targets,
+            MatType& gradients)
+{
+  const typename MatType::elem_type res =
+      outputLayer.Forward(networkOutput, targets) + LayerLoss();
+
+  outputLayer.Backward(networkOutput, targets, error);
+
+  gradients.set_size(parameters.n_rows, parameters.n_cols);
+  BackwardLayers(inputs, networkOutput, error, gradients, Step<0>());
+
+  return res;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+typename MatType::elem_type StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::Evaluate(const MatType& predictors, const MatType& responses)
+{
+  CheckNetwork("StaticFFN::Evaluate()", predictors.n_rows);
+
+  ForwardLayers(predictors, networkOutput, Step<0>());
+  return outputLayer.Forward(networkOutput, responses) + LayerLoss();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+template<typename Archive>
+void StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(outputLayer));
+  ar(CEREAL_NVP(initializeRule));
+
+  // The types of the layers are known, so they are serialized directly (no
+  // polymorphic registration is needed).
+  size_t i = 0;
+  ForEachLayer([&](auto& layer)
+  {
+    const std::string name = "layer" + std::to_string(i++);
+    ar(cereal::make_nvp(name.c_str(), layer));
+  }, std::index_sequence_for<LayerTypes...>());
+
+  ar(CEREAL_NVP(parameters));
+  ar(CEREAL_NVP(inputDimensions));
+
+  if (cereal::is_loading<Archive>())
+  {
+    predictors.clear();
+    responses.clear();
+
+    if (!inputDimensions.empty())
+      ComputeDimensions();
+
+    // The layers will be pointed at `parameters` in the next pass.
+    layerMemory = NULL;
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+typename MatType::elem_type StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::Evaluate(const MatType& parameters)
+{
+  typename MatType::elem_type res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += Evaluate(parameters, i, 1);
+
+  return res;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+typename MatType::elem_type StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::Evaluate(const MatType& /* parameters */,
+            const size_t begin,
+            const size_t batchSize)
+{
+  CheckNetwork("StaticFFN::Evaluate()", predictors.n_rows);
+
+  MatType predictorsBatch, responsesBatch;
+  MakeAlias(predictorsBatch, ColPtr(predictors, begin), predictors.n_rows,
+      batchSize);
+  MakeAlias(responsesBatch, ColPtr(responses, begin), responses.n_rows,
+      batchSize);
+
+  ForwardLayers(predictorsBatch, networkOutput, Step<0>());
+  return outputLayer.Forward(networkOutput, responsesBatch) + LayerLoss();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+typename MatType::elem_type StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::EvaluateWithGradient(const MatType& /* parameters */,
+                        const size_t begin,
+                        MatType& gradient,
+                        const size_t batchSize)
+{
+  CheckNetwork("StaticFFN::EvaluateWithGradient()", predictors.n_rows);
+
+  // Alias the batches so we don't copy memory.
+  MatType predictorsBatch, responsesBatch;
+  MakeAlias(predictorsBatch, ColPtr(predictors, begin), predictors.n_rows,
+      batchSize);
+  MakeAlias(responsesBatch, ColPtr(responses, begin), responses.n_rows,
+      batchSize);
+
+  ForwardLayers(predictorsBatch, networkOutput, Step<0>());
+  const typename MatType::elem_type obj = outputLayer.Forward(networkOutput,
+      responsesBatch) + LayerLoss();
+
+  outputLayer.Backward(networkOutput, responsesBatch, error);
+
+  gradient.set_size(parameters.n_rows, parameters.n_cols);
+  BackwardLayers(predictorsBatch, networkOutput, error, gradient, Step<0>());
+
+  return obj;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+void StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::Gradient(const MatType& parameters,
+            const size_t begin,
+            MatType& gradient,
+            const size_t batchSize)
+{
+  EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+void StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::Shuffle()
+{
+  ShuffleData(predictors, responses, predictors, responses);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+void StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::ResetData(MatType predictors, MatType responses)
+{
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+
+  // Set the network to training mode.
+  SetNetworkMode(true);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+template<typename FunctionType, size_t... I>
+void StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::ForEachLayer(FunctionType&& f, std::index_sequence<I...>)
+{
+  // The elements of a braced list are evaluated in order.
+  const int order[] = { 0, (f(std::get<I>(layers)), 0)... };
+  (void) order;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+void StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::ComputeDimensions()
+{
+  std::vector<size_t> dimensions = inputDimensions;
+  size_t i = 0, offset = 0;
+  ForEachLayer([&](auto& layer)
+  {
+    typedef typename std::remove_reference<decltype(layer)>::type L;
+    layer.InputDimensions() = dimensions;
+    dimensions = layer.OutputDimensions();
+
+    outputSizes[i] = layer.OutputSize();
+    weightSizes[i] = layer.L::WeightSize();
+    weightOffsets[i] = offset;
+    offset += weightSizes[i];
+    ++i;
+  }, std::index_sequence_for<LayerTypes...>());
+
+  layerMemory = NULL;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+void StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::CheckNetwork(const std::string& functionName, const size_t inputRows)
+{
+  if (inputDimensions.empty())
+  {
+    throw std::invalid_argument(functionName + ": the network has no input "
+        "dimensions!");
+  }
+
+  const size_t inputSize = std::accumulate(inputDimensions.begin(),
+      inputDimensions.end(), size_t(1), std::multiplies<size_t>());
+  if (inputRows != inputSize)
+  {
+    std::ostringstream oss;
+    oss << functionName << ": input has " << inputRows << " rows, but the "
+        << "network expects " << inputSize << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t weights = weightOffsets[NumLayers - 1] +
+      weightSizes[NumLayers - 1];
+  if (parameters.n_elem != weights)
+  {
+    std::ostringstream oss;
+    oss << functionName << ": the network has " << parameters.n_elem
+        << " parameters, but its layers have " << weights << " weights!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Point the layers at `parameters`, unless they already are (the memory of
+  // `parameters` may have changed, e.g. if it was assigned by move).
+  if (layerMemory == parameters.memptr() && layerMemory != NULL)
+    return;
+
+  size_t i = 0;
+  ForEachLayer([&](auto& layer)
+  {
+    typedef typename std::remove_reference<decltype(layer)>::type L;
+    layer.L::SetWeights(MemPtr(parameters) + weightOffsets[i++]);
+  }, std::index_sequence_for<LayerTypes...>());
+
+  layerMemory = parameters.memptr();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+template<size_t I>
+void StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::ForwardLayers(const MatType& input, MatType& results, Step<I>)
+{
+  typedef LayerType<I> L;
+  L& layer = std::get<I>(layers);
+
+  // The last layer writes directly into the results.
+  MatType& output = (I + 1 == NumLayers) ? results : layerOutputs[I];
+  output.set_size(outputSizes[I], input.n_cols);
+  layer.L::Forward(input, output);
+
+  ForwardLayers(output, results, Step<I + 1>());
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+template<size_t J>
+void StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::BackwardLayers(const MatType& input,
+                  const MatType& output,
+                  const MatType& gy,
+                  MatType& gradient,
+                  Step<J>)
+{
+  constexpr size_t I = NumLayers - 1 - J;
+  typedef LayerType<I> L;
+  L& layer = std::get<I>(layers);
+
+  const MatType& layerInput = LayerInput(input, Step<I>());
+  const MatType& layerOutput = (J == 0) ? output : layerOutputs[I];
+
+  layerDeltas[I].set_size(layerInput.n_rows, layerInput.n_cols);
+  layer.L::Backward(layerInput, layerOutput, gy, layerDeltas[I]);
+
+  if (weightSizes[I] > 0)
+  {
+    MatType layerGradient;
+    MakeAlias(layerGradient, MemPtr(gradient) + weightOffsets[I],
+        weightSizes[I], 1);
+    layer.L::Gradient(layerInput, gy, layerGradient);
+  }
+
+  BackwardLayers(input, output, layerDeltas[I], gradient, Step<J + 1>());
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename... LayerTypes>
+typename MatType::elem_type StaticFFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType,
+    LayerTypes...
+>::LayerLoss()
+{
+  typename MatType::elem_type loss = 0;
+  ForEachLayer([&](auto& layer)
+  {
+    typedef typename std::remove_reference<decltype(layer)>::type L;
+    loss += layer.L::Loss();
+  }, std::index_sequence_for<LayerTypes...>());
+
+  return loss;
+}
+
+} // namespace mlpack
+
+#endif
@@ -19,6 +19,7 @@
 #include <mlpack/methods/neighbor_search/neighbor_search_rules.hpp>
 #include <mlpack/methods/neighbor_search/sort_policies/furthest_neighbor_sort.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traversal.hpp>
 #include <algorithm>
 
 namespace mlpack {
@@ -83,14 +84,20 @@ void DrusillaSelect<MatType>::Train(
   arma::vec dataMean(arma::mean(referenceSet, 1));
   arma::vec norms(referenceSet.n_cols);
 
+  // Columns of sparse matrices can't be set from several threads.
   MatType refCopy(referenceSet.n_rows, referenceSet.n_cols);
+  #pragma omp parallel for if (!arma::is_SpMat<MatType>::value) \
+      num_threads((int) NumThreads())
   for (size_t i = 0; i < refCopy.n_cols; ++i)
   {
     refCopy.col(i) = referenceSet.col(i) - dataMean;
     norms[i] = norm(refCopy.col(i));
   }
 
-  // Find the top m points for each of the l projections...
+  // Find the top m points for each of the l projections...  Each projection
+  // depends on the points taken by the previous ones, so the projections are
+  // found one after the other, but the scores of the points are computed in
+  // parallel.
   for (size_t i = 0; i < l; ++i)
   {
     // Pick best index.
@@ -99,9 +106,11 @@ void DrusillaSelect<MatType>::Train(
 
     arma::vec line(refCopy.col(maxIndex) / norm(refCopy.col(maxIndex)));
 
-    // Calculate distortion and offset and make scores.
-    std::vector<bool> closeAngle(referenceSet.n_cols, false);
+    // Calculate distortion and offset and make scores.  (closeAngle holds chars
+    // and not bools, so that it can be written from several threads.)
+    std::vector<char> closeAngle(referenceSet.n_cols, false);
     arma::vec sums(referenceSet.n_cols);
+    #pragma omp parallel for num_threads((int) NumThreads())
     for (size_t j = 0; j < referenceSet.n_cols; ++j)
     {
       if (norms[j] > 0.0)
@@ -178,19 +187,43 @@ void DrusillaSelect<MatType>::Search(const MatType& querySet,
     throw std::invalid_argument("DrusillaSelect::Search(): requested k is "
         "greater than number of points in candidate set!  Increase l or m.");
 
-  // We'll use the NeighborSearchRules class to perform our brute-force search.
-  // Note that we aren't using trees for our search, so we can use 'int' as a
-  // TreeType.
+  // We'll use the NeighborSearchRules class to perform our brute-force search,
+  // with one rules object for each block of query points so that the blocks
+  // can be searched in parallel.  Note that we aren't using trees for our
+  // search, so the TreeType is only needed for the types.
+  typedef NeighborSearchRules<FurthestNeighborSort, EuclideanDistance,
+      KDTree<EuclideanDistance, EmptyStatistic, MatType>> RuleType;
+
   EuclideanDistance metric;
-  NeighborSearchRules<FurthestNeighborSort, EuclideanDistance,
-      KDTree<EuclideanDistance, EmptyStatistic, MatType>>
-      rules(candidateSet, querySet, k, metric, 0, false);
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
 
-  for (size_t q = 0; q < querySet.n_cols; ++q)
-    for (size_t r = 0; r < candidateSet.n_cols; ++r)
-      rules.BaseCase(q, r);
+  const size_t numBlocks = NumParallelTasks(querySet.n_cols);
 
-  rules.GetResults(neighbors, distances);
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = (b * querySet.n_cols) / numBlocks;
+    const size_t end = ((b + 1) * querySet.n_cols) / numBlocks;
+    if (begin == end)
+      continue;
+
+    RuleType rules(candidateSet, querySet, begin, end - begin, k, metric, 0,
+        false);
+
+    // The candidates of all tables are stored contiguously, so they are
+    // scanned in memory order.
+    for (size_t q = begin; q < end; ++q)
+      for (size_t r = 0; r < candidateSet.n_cols; ++r)
+        rules.BaseCase(q, r);
+
+    // Each block writes its own columns of the results.
+    arma::Mat<size_t> blockNeighbors(neighbors.colptr(begin), k, end - begin,
+        false, true);
+    arma::mat blockDistances(distances.colptr(begin), k, end - begin, false,
+        true);
+    rules.GetResults(blockNeighbors, blockDistances);
+  }
 
   // Map the neighbors back to their original indices in the reference set.
   for (size_t i = 0; i < neighbors.n_elem; ++i)
@@ -82,12 +82,19 @@ class QDAFN
   void serialize(Archive& ar, const uint32_t /* version */);
 
   //! Get the number of projections.
-  size_t NumProjections() const { return candidateSet.size(); }
+  size_t NumProjections() const { return candidateSet.n_cols / m; }
 
-  //! Get the candidate set for the given projection table.
-  const MatType& CandidateSet(const size_t t) const { return candidateSet[t]; }
+  //! Get the candidate set for the given projection table (as a view of its
+  //! columns of the candidate sets of all tables).
+  decltype(auto) CandidateSet(const size_t t) const
+  {
+    return candidateSet.cols(t * m, (t + 1) * m - 1);
+  }
   //! Modify the candidate set for the given projection table.  Careful!
-  MatType& CandidateSet(const size_t t) { return candidateSet[t]; }
+  decltype(auto) CandidateSet(const size_t t)
+  {
+    return candidateSet.cols(t * m, (t + 1) * m - 1);
+  }
 
  private:
   //! The number of projections.
@@ -104,12 +111,17 @@ class QDAFN
   //! Values of a_i * x for each point in S.
   arma::mat sValues;
 
-  // Candidate sets; one element in the vector for each table.
-  std::vector<MatType> candidateSet;
+  //! Candidate sets of all of the tables, one after the other: the candidates
+  //! of table t are columns [t * m, (t + 1) * m), so that a query scans them
+  //! in memory order.
+  MatType candidateSet;
 };
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename MatType), (mlpack::QDAFN<MatType>),
+    (1));
+
 // Include implementation.
 #include "qdafn_impl.hpp"
 
@@ -69,13 +69,14 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
   // top m elements.
   projections = referenceSet.t() * lines;
 
-  // Loop over each projection and find the top m elements.
+  // Loop over each projection and find the top m elements.  The tables are
+  // independent, so they are sorted in parallel.
   sIndices.set_size(m, l);
   sValues.set_size(m, l);
-  candidateSet.resize(l);
+
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
   for (size_t i = 0; i < l; ++i)
   {
-    candidateSet[i].set_size(referenceSet.n_rows, m);
     arma::uvec sortedIndices = arma::sort_index(projections.col(i), "descend");
 
     // Grab the top m elements.
@@ -83,9 +84,16 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
     {
       sIndices(j, i) = sortedIndices[j];
       sValues(j, i) = projections(sortedIndices[j], i);
-      candidateSet[i].col(j) = referenceSet.col(sortedIndices[j]);
     }
   }
+
+  // Now copy the candidates of every table into the contiguous candidate set.
+  // This is done serially, because columns of sparse matrices can't be set
+  // from several threads.
+  candidateSet.set_size(referenceSet.n_rows, l * m);
+  for (size_t i = 0; i < l; ++i)
+    for (size_t j = 0; j < m; ++j)
+      candidateSet.col(i * m + j) = referenceSet.col(sIndices(j, i));
 }
 
 // Search.
@@ -103,7 +111,11 @@ void QDAFN<MatType>::Search(const MatType& querySet,
   neighbors.fill(size_t() - 1);
   distances.zeros(k, querySet.n_cols);
 
-  // Search for each point.
+  // Project all of the query points onto the lines at once.
+  const arma::mat queryProjections = lines.t() * querySet;
+
+  // Search for each point; the queries are independent.
+  #pragma omp parallel for schedule(dynamic, 16) num_threads((int) NumThreads())
   for (size_t q = 0; q < querySet.n_cols; ++q)
   {
     // Initialize a priority queue.
@@ -112,8 +124,7 @@ void QDAFN<MatType>::Search(const MatType& querySet,
     std::priority_queue<std::pair<double, size_t>> queue;
     for (size_t i = 0; i < l; ++i)
     {
-      const double val = sValues(0, i) - dot(querySet.col(q),
-          lines.col(i));
+      const double val = sValues(0, i) - queryProjections(i, q);
       queue.push(std::make_pair(val, i));
     }
 
@@ -128,15 +139,15 @@ void QDAFN<MatType>::Search(const MatType& querySet,
         resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
     for (size_t i = 0; i < m; ++i)
     {
-      std::pair<size_t, double> p = queue.top();
+      std::pair<double, size_t> p = queue.top();
       queue.pop();
 
       // Get index of reference point to look at.
       const size_t tableIndex = tableLocations[p.second];
 
       // Calculate distance from query point.
-      const double dist = EuclideanDistance::Evaluate( querySet.col(q),
-          candidateSet[p.second].col(tableIndex));
+      const double dist = EuclideanDistance::Evaluate(querySet.col(q),
+          candidateSet.col(p.second * m + tableIndex));
 
       resultsQueue.push(std::make_pair(dist, sIndices(tableIndex, p.second)));
 
@@ -170,8 +181,8 @@ void QDAFN<MatType>::Search(const MatType& querySet,
       // Avoid inserting any duplicates.
       if (neighbors(extracted - 1, q) != result.second)
       {
-        neighbors(extracted, q) = resultsQueue.top().second;
-        distances(extracted, q) = resultsQueue.top().first;
+        neighbors(extracted, q) = result.second;
+        distances(extracted, q) = result.first;
         ++extracted;
       }
     }
@@ -180,7 +191,7 @@ void QDAFN<MatType>::Search(const MatType& querySet,
 
 template<typename MatType>
 template<typename Archive>
-void QDAFN<MatType>::serialize(Archive& ar, const uint32_t /* version */)
+void QDAFN<MatType>::serialize(Archive& ar, const uint32_t version)
 {
   ar(CEREAL_NVP(l));
   ar(CEREAL_NVP(m));
@@ -188,9 +199,22 @@ void QDAFN<MatType>::serialize(Archive& ar, const uint32_t /* version */)
   ar(CEREAL_NVP(projections));
   ar(CEREAL_NVP(sIndices));
   ar(CEREAL_NVP(sValues));
-  if (cereal::is_loading<Archive>())
-    candidateSet.clear();
-  ar(CEREAL_NVP(candidateSet));
+
+  // Before version 1, the candidate set of each table was stored in its own
+  // matrix, so we convert older models to the contiguous layout.
+  if (cereal::is_loading<Archive>() && version == 0)
+  {
+    std::vector<MatType> candidateSets;
+    ar(cereal::make_nvp("candidateSet", candidateSets));
+
+    candidateSet.set_size(lines.n_rows, candidateSets.size() * m);
+    for (size_t i = 0; i < candidateSets.size(); ++i)
+      candidateSet.cols(i * m, (i + 1) * m - 1) = candidateSets[i];
+  }
+  else
+  {
+    ar(CEREAL_NVP(candidateSet));
+  }
 }
 
 } // namespace mlpack
@@ -45,6 +45,14 @@ namespace mlpack {
  * function described in the section 3.5.2 of the C.Bishop book, Pattern
  * Recognition and Machine Learning.
  *
+ * The model only depends on the data through its sufficient statistics (the
+ * means and the second moments of the points and responses), which Train()
+ * accumulates in chunks of points and keeps.  Update() adds a new batch of
+ * points to these statistics and updates the posterior distribution of
+ * \f$ \omega \f$, so that the model can be recalibrated without retraining
+ * on all the data seen so far; when the batch is small, this is a low-rank
+ * (Woodbury) update of the posterior covariance.
+ *
  * @code
  * @article{MacKay91bayesianinterpolation,
  *   author = {David J.C. MacKay},
@@ -93,6 +101,11 @@ namespace mlpack {
  * // Compute the standard deviations of the predictions.
  * arma::rowvec stds;
  * estimator.Predict(xTest, responses, stds)
+ *
+ * // Update the model with a new batch of points.
+ * arma::mat xNew;
+ * arma::rowvec yNew;
+ * estimator.Update(xNew, yNew);
  * @endcode
  */
 template<typename ModelMatType = arma::mat>
@@ -230,6 +243,37 @@ class BayesianLinearRegression
                  const size_t maxIterations,
                  const double tolerance);
 
+  /**
+   * Update the model with a new batch of points: the batch is added to the
+   * sufficient statistics accumulated by Train() and the previous calls to
+   * Update(), and the posterior distribution of the parameters is updated, as
+   * if the model had been trained on all these points.
+   *
+   * If updateHyperparameters is false, the precisions alpha and beta are kept
+   * and only the posterior mean and covariance are updated; if the data is not
+   * scaled and the batch has fewer points than dimensions, this is a low-rank
+   * update of the covariance that costs O(P^2 N) for P dimensions and N points
+   * in the batch.  Otherwise, the evidence maximization is run again from the
+   * statistics (starting from the current alpha and beta), which costs O(P^3)
+   * but does not depend on the number of points seen so far.
+   *
+   * If the model has no statistics (it was not trained, or it was loaded from
+   * an older version), this is the same as Train().
+   *
+   * @param data Column-major input data of the batch, dim(P, N).
+   * @param responses A vector of targets of the batch, dim(N).
+   * @param updateHyperparameters Whether to also update alpha and beta.
+   * @return Root mean squared error on the batch.
+   */
+  template<typename MatType,
+           typename ResponsesType,
+           typename = typename std::enable_if<
+               std::is_same<typename ResponsesType::elem_type, ElemType>::value
+           >::type>
+  ElemType Update(const MatType& data,
+                  const ResponsesType& responses,
+                  const bool updateHyperparameters = false);
+
   /**
    * Predict \f$y\f$ for a single data point \f$x\f$ using the currently-trained
    * Bayesian ridge regression model.
@@ -357,6 +401,9 @@ class BayesianLinearRegression
    */
   ElemType ResponsesOffset() const { return responsesOffset; }
 
+  //! Get the number of points the model was trained (and updated) on.
+  size_t NumTrainingPoints() const { return numPoints; }
+
   //! Get whether the data will be centered during training.
   bool CenterData() const { return centerData; }
   //! Modify whether the data will be centered during training.
@@ -422,21 +469,63 @@ class BayesianLinearRegression
   //! Covariance matrix of the solution vector omega.
   ModelMatType matCovariance;
 
+  //! Number of points in the sufficient statistics.
+  size_t numPoints;
+
+  //! Mean of the points.
+  DenseVecType dataMean;
+
+  //! Mean of the responses.
+  ElemType responsesMean;
+
+  //! Sum of the outer products of the centered points.
+  ModelMatType dataM2;
+
+  //! Sum of the centered points times the centered responses.
+  DenseVecType crossM2;
+
+  //! Sum of the squares of the centered responses.
+  ElemType responsesM2;
+
+  //! Number of points whose statistics are computed at once.
+  static constexpr size_t ChunkSize = 1024;
+
   /**
-   * Center and scale the data accordind to centerData and scaleData.
-   * Allows future modifications of new points.
+   * Add the statistics of the given points to the sufficient statistics.  The
+   * points are centered in chunks, so no copy of the data is made.
    *
    * @param data Design matrix in column-major format, dim(P, N).
    * @param responses A vector of targets.
-   * @param dataProc Data processed, dim(P, N).
-   * @param responsesProc Responses processed, dim(N).
-   * @return reponsesOffset Mean of responses.
    */
   template<typename MatType, typename ResponsesType>
-  double CenterScaleData(const MatType& data,
-                         const ResponsesType& responses,
-                         MatType& dataProc,
-                         ResponsesType& responsesProc);
+  void AddStatistics(const MatType& data, const ResponsesType& responses);
+
+  /**
+   * Compute, from the sufficient statistics, the Gram matrix phi * phi^T of
+   * the centered and scaled data phi, phi * t^T and t * t^T for the processed
+   * responses t, and set the offsets and scales of the data and responses
+   * accordingly.
+   *
+   * @param gram Will hold phi * phi^T.
+   * @param cross Will hold phi * t^T.
+   * @param responsesSquares Will hold t * t^T.
+   */
+  void ProcessedStatistics(ModelMatType& gram,
+                           DenseVecType& cross,
+                           ElemType& responsesSquares);
+
+  /**
+   * Maximize the evidence with the given statistics of the processed data,
+   * starting from the current alpha and beta, and compute the posterior
+   * distribution of omega.
+   *
+   * @param gram phi * phi^T.
+   * @param cross phi * t^T.
+   * @param responsesSquares t * t^T.
+   */
+  void MaximizeEvidence(const ModelMatType& gram,
+                        const DenseVecType& cross,
+                        const ElemType responsesSquares);
 
   /**
    * Center and scale the points before prediction.  This should only be called
@@ -454,7 +543,7 @@ class BayesianLinearRegression
 } // namespace mlpack
 
 CEREAL_TEMPLATE_CLASS_VERSION((typename ModelMatType),
-    (mlpack::BayesianLinearRegression<ModelMatType>), (1));
+    (mlpack::BayesianLinearRegression<ModelMatType>), (2));
 
 // Include implementation of serialize.
 #include "bayesian_linear_regression_impl.hpp"
@@ -29,7 +29,10 @@ inline BayesianLinearRegression<ModelMatType>::BayesianLinearRegression(
     responsesOffset(0.0),
     alpha(0.0),
     beta(0.0),
-    gamma(0.0)
+    gamma(0.0),
+    numPoints(0),
+    responsesMean(0.0),
+    responsesM2(0.0)
 { /* Nothing to do */ }
 
 template<typename ModelMatType>
@@ -48,7 +51,10 @@ inline BayesianLinearRegression<ModelMatType>::BayesianLinearRegression(
     responsesOffset(0.0),
     alpha(0.0),
     beta(0.0),
-    gamma(0.0)
+    gamma(0.0),
+    numPoints(0),
+    responsesMean(0.0),
+    responsesM2(0.0)
 {
   // Train the model.
   Train(data, responses);
@@ -137,56 +143,102 @@ BayesianLinearRegression<ModelMatType>::Train(
   this->maxIterations = maxIterations;
   this->tolerance = tolerance;
 
-  ModelMatType phi;
-  DenseRowType t;
-  DenseVecType eigVal;
-  ModelMatType eigVec;
+  // Compute the sufficient statistics of the data, and preprocess them
+  // according to centerData and scaleData.
+  numPoints = 0;
+  AddStatistics(data, responses);
 
-  // Preprocess the data. Center and scale.
-  responsesOffset = CenterScaleData(data, responses, phi, t);
-
-  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(phi * phi.t())))
-  {
-    Log::Fatal << "BayesianLinearRegression::Train(): Eigendecomposition "
-               << "of covariance failed!" << std::endl;
-  }
-
-  // Compute this quantities once and for all.
-  const ModelMatType eigVecInv = inv(eigVec);
-  const DenseVecType eigVecInvPhitT = eigVecInv * phi * t.t();
+  ModelMatType gram;
+  DenseVecType cross;
+  ElemType responsesSquares;
+  ProcessedStatistics(gram, cross, responsesSquares);
 
   // Initialize the hyperparameters and begin with an infinitely broad prior.
   alpha = ((ElemType) 1e-6);
-  beta =  ((ElemType) 1 / (var(t, 1) * 0.1));
+  beta = ((ElemType) 1 / (responsesM2 / numPoints * 0.1));
 
-  unsigned short i = 0;
-  ElemType crit = ((ElemType) 1.0);
+  MaximizeEvidence(gram, cross, responsesSquares);
 
-  while (((double) crit > tolerance) && (i < maxIterations))
+  return RMSE(data, responses);
+}
+
+template<typename ModelMatType>
+template<typename MatType, typename ResponsesType, typename>
+inline
+typename BayesianLinearRegression<ModelMatType>::ElemType
+BayesianLinearRegression<ModelMatType>::Update(
+    const MatType& data,
+    const ResponsesType& responses,
+    const bool updateHyperparameters)
+{
+  util::CheckSameSizes(data, responses, "BayesianLinearRegression::Update()",
+      "responses");
+  if (numPoints == 0)
+    return Train(data, responses);
+
+  util::CheckSameDimensionality(data, dataMean.n_elem,
+      "BayesianLinearRegression::Update()");
+
+  // Unless the data is scaled (then the scales change), the Gram matrix of the
+  // processed data changes by u * u^T, where u holds the centered points of
+  // the batch and, if the data is centered, the change of the mean.  If u has
+  // fewer columns than dimensions, the covariance can be updated with the
+  // Woodbury identity instead of being recomputed.
+  const size_t rank = data.n_cols + (centerData ? 1 : 0);
+  const bool lowRank = !updateHyperparameters && !scaleData &&
+      (rank < dataMean.n_elem) && (matCovariance.n_rows == dataMean.n_elem);
+
+  ModelMatType u;
+  if (lowRank && centerData)
   {
-    ElemType deltaAlpha = -alpha;
-    ElemType deltaBeta = -beta;
+    const DenseVecType batchMean = mean(data, 1);
+    const ElemType scale = std::sqrt((ElemType) numPoints * data.n_cols /
+        (numPoints + data.n_cols));
 
-    // Update the solution.
-    omega = eigVec * diagmat(1 / (eigVal + (alpha / beta))) * eigVecInvPhitT;
+    u.set_size(data.n_rows, rank);
+    u.cols(0, data.n_cols - 1) = data.each_col() - batchMean;
+    u.col(data.n_cols) = scale * (batchMean - dataMean);
+  }
+  else if (lowRank)
+  {
+    u = data;
+  }
 
-    // Update alpha.
-    gamma = sum(eigVal / (alpha / beta + eigVal));
-    alpha = gamma / dot(omega, omega);
+  AddStatistics(data, responses);
 
-    // Update beta.
-    const DenseRowType temp = t - omega.t() * phi;
-    beta = (data.n_cols - gamma) / dot(temp, temp);
+  ModelMatType gram;
+  DenseVecType cross;
+  ElemType responsesSquares;
+  ProcessedStatistics(gram, cross, responsesSquares);
 
-    // Compute the stopping criterion.
-    deltaAlpha += alpha;
-    deltaBeta += beta;
-    crit = std::abs(deltaAlpha / alpha + deltaBeta / beta);
-    i++;
+  if (updateHyperparameters)
+  {
+    MaximizeEvidence(gram, cross, responsesSquares);
+  }
+  else if (lowRank)
+  {
+    // The posterior precision is alpha * I + beta * gram, so with
+    // S = matCovariance,
+    //   S' = S - S u (I / beta + u^T S u)^{-1} u^T S.
+    const ModelMatType su = matCovariance * u;
+    ModelMatType inner = u.t() * su;
+    inner.diag() += ((ElemType) 1) / beta;
+
+    matCovariance -= su * arma::solve(inner, ModelMatType(su.t()));
+    omega = beta * (matCovariance * cross);
+  }
+  else
+  {
+    ModelMatType precision = beta * gram;
+    precision.diag() += alpha;
+    if (!arma::inv_sympd(matCovariance, precision))
+    {
+      Log::Fatal << "BayesianLinearRegression::Update(): inversion of the "
+                 << "posterior precision failed!" << std::endl;
+    }
+
+    omega = beta * (matCovariance * cross);
   }
-  // Compute the covariance matrix for the uncertainties later.
-  matCovariance = eigVec * diagmat(((ElemType) 1) / (beta * eigVal + alpha)) *
-      eigVecInv;
 
   return RMSE(data, responses);
 }
@@ -301,45 +353,152 @@ BayesianLinearRegression<ModelMatType>::RMSE(
 
 template<typename ModelMatType>
 template<typename MatType, typename ResponsesType>
-inline double BayesianLinearRegression<ModelMatType>::CenterScaleData(
+inline void BayesianLinearRegression<ModelMatType>::AddStatistics(
     const MatType& data,
-    const ResponsesType& responses,
-    MatType& dataProc,
-    ResponsesType& responsesProc)
+    const ResponsesType& responses)
 {
-  if (!centerData && !scaleData)
+  const size_t batchPoints = data.n_cols;
+  const DenseVecType batchMean = mean(data, 1);
+  const ElemType batchResponsesMean = mean(responses);
+
+  // Compute the second moments of the batch around its means, one chunk of
+  // centered points at a time.
+  ModelMatType batchM2(data.n_rows, data.n_rows, arma::fill::zeros);
+  DenseVecType batchCrossM2(data.n_rows, arma::fill::zeros);
+  ElemType batchResponsesM2 = 0;
+  for (size_t begin = 0; begin < batchPoints; begin += ChunkSize)
   {
-    dataProc = MatType(const_cast<ElemType*>(data.memptr()), data.n_rows,
-                                             data.n_cols, false, true);
-    responsesProc = ResponsesType(const_cast<ElemType*>(responses.memptr()),
-                                                        responses.n_elem, false,
-                                                        true);
+    const size_t end = std::min(begin + ChunkSize, batchPoints);
+    const ModelMatType centered = data.cols(begin, end - 1).each_col() -
+        batchMean;
+    const DenseRowType centeredResponses = responses.cols(begin, end - 1) -
+        batchResponsesMean;
+
+    batchM2 += centered * centered.t();
+    batchCrossM2 += centered * centeredResponses.t();
+    batchResponsesM2 += dot(centeredResponses, centeredResponses);
   }
-  else if (centerData && !scaleData)
+
+  if (numPoints == 0)
   {
-    dataOffset = mean(data, 1);
-    responsesOffset = mean(responses);
-    dataProc = data.each_col() - dataOffset;
-    responsesProc = responses - responsesOffset;
+    dataMean = batchMean;
+    responsesMean = batchResponsesMean;
+    dataM2 = std::move(batchM2);
+    crossM2 = std::move(batchCrossM2);
+    responsesM2 = batchResponsesM2;
   }
-  else if (!centerData && scaleData)
+  else
   {
-    dataScale = stddev(data, 0, 1);
-    dataProc = data.each_col() / dataScale;
-    responsesProc = ResponsesType(const_cast<ElemType*>(responses.memptr()),
-                                                        responses.n_elem, false,
-                                                        true);
+    // Merge the moments of the batch with the accumulated ones (Chan et al.).
+    const ElemType totalPoints = (ElemType) (numPoints + batchPoints);
+    const ElemType weight = ((ElemType) numPoints) * batchPoints / totalPoints;
+    const DenseVecType delta = batchMean - dataMean;
+    const ElemType responsesDelta = batchResponsesMean - responsesMean;
+
+    dataM2 += batchM2 + weight * (delta * delta.t());
+    crossM2 += batchCrossM2 + (weight * responsesDelta) * delta;
+    responsesM2 += batchResponsesM2 + weight * responsesDelta * responsesDelta;
+    dataMean += (batchPoints / totalPoints) * delta;
+    responsesMean += (batchPoints / totalPoints) * responsesDelta;
+  }
+
+  numPoints += batchPoints;
+}
+
+template<typename ModelMatType>
+inline void BayesianLinearRegression<ModelMatType>::ProcessedStatistics(
+    ModelMatType& gram,
+    DenseVecType& cross,
+    ElemType& responsesSquares)
+{
+  gram = dataM2;
+  cross = crossM2;
+  responsesSquares = responsesM2;
+
+  if (centerData)
+  {
+    dataOffset = dataMean;
+    responsesOffset = responsesMean;
   }
   else
   {
-    dataOffset = mean(data, 1);
-    dataScale = stddev(data, 0, 1);
-    responsesOffset = mean(responses);
-    dataProc = (data.each_col() - dataOffset).each_col() / dataScale;
-    responsesProc = responses - responsesOffset;
+    // Go back to the moments around zero.
+    const ElemType n = (ElemType) numPoints;
+    gram += n * (dataMean * dataMean.t());
+    cross += (n * responsesMean) * dataMean;
+    responsesSquares += n * responsesMean * responsesMean;
+
+    dataOffset.reset();
+    responsesOffset = 0;
+  }
+
+  if (scaleData)
+  {
+    // These are the standard deviations of the features, like stddev(data, 0,
+    // 1) would compute.
+    dataScale = sqrt(dataM2.diag() /
+        ((ElemType) ((numPoints > 1) ? (numPoints - 1) : 1)));
+    gram.each_col() /= dataScale;
+    gram.each_row() /= dataScale.t();
+    cross /= dataScale;
+  }
+  else
+  {
+    dataScale.reset();
+  }
+}
+
+template<typename ModelMatType>
+inline void BayesianLinearRegression<ModelMatType>::MaximizeEvidence(
+    const ModelMatType& gram,
+    const DenseVecType& cross,
+    const ElemType responsesSquares)
+{
+  DenseVecType eigVal;
+  ModelMatType eigVec;
+  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(gram)))
+  {
+    Log::Fatal << "BayesianLinearRegression::Train(): Eigendecomposition "
+               << "of covariance failed!" << std::endl;
+  }
+
+  // Compute this quantity once and for all; since eigVec is orthonormal, its
+  // inverse is its transpose.
+  const DenseVecType eigVecInvPhitT = eigVec.t() * cross;
+
+  size_t i = 0;
+  ElemType crit = ((ElemType) 1.0);
+
+  while (((double) crit > tolerance) && (i < maxIterations))
+  {
+    ElemType deltaAlpha = -alpha;
+    ElemType deltaBeta = -beta;
+
+    // Update the solution.  z holds the solution in the basis of eigVec.
+    const DenseVecType z = eigVecInvPhitT / (eigVal + (alpha / beta));
+    omega = eigVec * z;
+
+    // Update alpha.
+    gamma = sum(eigVal / (alpha / beta + eigVal));
+    alpha = gamma / dot(omega, omega);
+
+    // Update beta.  The squared norm of the residuals t - omega^T phi is
+    // computed from the statistics; it is bounded below because of rounding.
+    const ElemType residual = responsesSquares - 2 * dot(z, eigVecInvPhitT) +
+        dot(eigVal, z % z);
+    beta = (numPoints - gamma) / std::max(residual,
+        std::numeric_limits<ElemType>::epsilon() * responsesSquares);
+
+    // Compute the stopping criterion.
+    deltaAlpha += alpha;
+    deltaBeta += beta;
+    crit = std::abs(deltaAlpha / alpha + deltaBeta / beta);
+    i++;
   }
 
-  return responsesOffset;
+  // Compute the covariance matrix for the uncertainties later.
+  matCovariance = eigVec * diagmat(((ElemType) 1) / (beta * eigVal + alpha)) *
+      eigVec.t();
 }
 
 template<typename ModelMatType>
@@ -422,6 +581,27 @@ void BayesianLinearRegression<ModelMatType>::serialize(Archive& ar,
     ar(CEREAL_NVP(omega));
     ar(CEREAL_NVP(matCovariance));
   }
+
+  // The sufficient statistics were added in version 2; models of older
+  // versions cannot be updated, so Update() retrains them.
+  if (cereal::is_loading<Archive>() && version < 2)
+  {
+    numPoints = 0;
+    dataMean.reset();
+    responsesMean = 0;
+    dataM2.reset();
+    crossM2.reset();
+    responsesM2 = 0;
+  }
+  else
+  {
+    ar(CEREAL_NVP(numPoints));
+    ar(CEREAL_NVP(dataMean));
+    ar(CEREAL_NVP(responsesMean));
+    ar(CEREAL_NVP(dataM2));
+    ar(CEREAL_NVP(crossM2));
+    ar(CEREAL_NVP(responsesM2));
+  }
 }
 
 } // namespace mlpack
@@ -53,6 +53,12 @@ namespace mlpack {
  * // Use the Apply() method to get a factorization.
  * bSVD.Apply(data, u, s, v, rank);
  * @endcode
+ *
+ * The decomposition can be computed in single precision by passing matrices
+ * of type arma::fmat and arma::fvec.  Datasets that do not fit in memory can be
+ * decomposed with ApplyChunks(), which reads the data from a chunked source
+ * (such as a data::ChunkedLoader or a data::MatrixChunkLoader) a fixed number
+ * of times.
  */
 class RandomizedBlockKrylovSVD
 {
@@ -69,10 +75,11 @@ class RandomizedBlockKrylovSVD
    * @param rank Rank of the approximation (Default: number of rows.)
    * @param blockSize The block size, must be >= rank (Default: rank + 10).
    */
-  RandomizedBlockKrylovSVD(const arma::mat& data,
-                           arma::mat& u,
-                           arma::vec& s,
-                           arma::mat& v,
+  template<typename eT>
+  RandomizedBlockKrylovSVD(const arma::Mat<eT>& data,
+                           arma::Mat<eT>& u,
+                           arma::Col<eT>& s,
+                           arma::Mat<eT>& v,
                            const size_t maxIterations = 2,
                            const size_t rank = 0,
                            const size_t blockSize = 0);
@@ -97,12 +104,35 @@ class RandomizedBlockKrylovSVD
    * @param s Diagonal matrix of singular values.
    * @param rank Rank of the approximation.
    */
-  void Apply(const arma::mat& data,
-             arma::mat& u,
-             arma::vec& s,
-             arma::mat& v,
+  template<typename eT>
+  void Apply(const arma::Mat<eT>& data,
+             arma::Mat<eT>& u,
+             arma::Col<eT>& s,
+             arma::Mat<eT>& v,
              const size_t rank);
 
+  /**
+   * Compute the left singular vectors and the singular values of the data
+   * with the randomized block Krylov SVD, reading the data from the given
+   * chunked source, one chunk of points (columns) at a time.  The data is read
+   * maxIterations + 2 times: once for each block of the Krylov subspace, then
+   * once more for the Rayleigh-Ritz approximation of the singular values.  As
+   * with Apply(), all the Ritz values are returned (up to blockSize *
+   * (maxIterations + 1)); the right singular vectors (one per point) are not
+   * computed.
+   *
+   * @param loader Chunked source of the data, with Reset(), Next() and
+   *     Dimensionality() methods (such as a data::ChunkedLoader).
+   * @param u Matrix to store the left singular vectors in.
+   * @param s Vector to store the singular values in.
+   * @param rank Rank of the approximation.
+   */
+  template<typename LoaderType, typename eT>
+  void ApplyChunks(LoaderType& loader,
+                   arma::Mat<eT>& u,
+                   arma::Col<eT>& s,
+                   const size_t rank);
+
   //! Get the number of iterations for the power method.
   size_t MaxIterations() const { return maxIterations; }
   //! Modify the number of iterations for the power method.
@@ -16,11 +16,12 @@
 
 namespace mlpack {
 
+template<typename eT>
 inline RandomizedBlockKrylovSVD::RandomizedBlockKrylovSVD(
-    const arma::mat& data,
-    arma::mat& u,
-    arma::vec& s,
-    arma::mat& v,
+    const arma::Mat<eT>& data,
+    arma::Mat<eT>& u,
+    arma::Col<eT>& s,
+    arma::Mat<eT>& v,
     const size_t maxIterations,
     const size_t rank,
     const size_t blockSize) :
@@ -46,13 +47,14 @@ inline RandomizedBlockKrylovSVD::RandomizedBlockKrylovSVD(
   /* Nothing to do here */
 }
 
-inline void RandomizedBlockKrylovSVD::Apply(const arma::mat& data,
-                                            arma::mat& u,
-                                            arma::vec& s,
-                                            arma::mat& v,
+template<typename eT>
+inline void RandomizedBlockKrylovSVD::Apply(const arma::Mat<eT>& data,
+                                            arma::Mat<eT>& u,
+                                            arma::Col<eT>& s,
+                                            arma::Mat<eT>& v,
                                             const size_t rank)
 {
-  arma::mat Q, R, block, blockIteration;
+  arma::Mat<eT> Q, R, block, blockIteration;
 
   if (blockSize == 0)
   {
@@ -60,28 +62,28 @@ inline void RandomizedBlockKrylovSVD::Apply(const arma::mat& data,
   }
 
   // Random block initialization.
-  arma::mat G = arma::randn(data.n_cols, blockSize);
+  arma::Mat<eT> G = arma::randn<arma::Mat<eT>>(data.n_cols, blockSize);
 
   // Construct and orthonormalize Krylov subspace.
-  arma::mat K(data.n_rows, blockSize * (maxIterations + 1));
+  arma::Mat<eT> K(data.n_rows, blockSize * (maxIterations + 1));
 
   // Create a working matrix using data from writable auxiliary memory
   // (K matrix). Doing so avoids an uncessary copy in upcoming step.
-  block = arma::mat(K.memptr(), data.n_rows, blockSize, false, false);
+  block = arma::Mat<eT>(K.memptr(), data.n_rows, blockSize, false, false);
   arma::qr_econ(block, R, data * G);
 
   for (size_t blockOffset = block.n_elem; blockOffset < K.n_elem;
       blockOffset += block.n_elem)
   {
     // Temporary working matrix to store the result in the correct place.
-    blockIteration = arma::mat(K.memptr() + blockOffset, block.n_rows,
+    blockIteration = arma::Mat<eT>(K.memptr() + blockOffset, block.n_rows,
         block.n_cols, false, false);
 
     arma::qr_econ(blockIteration, R, data * (data.t() * block));
 
     // Update working matrix for the next iteration.
-    block = arma::mat(K.memptr() + blockOffset, block.n_rows, block.n_cols,
-        false, false);
+    block = arma::Mat<eT>(K.memptr() + blockOffset, block.n_rows,
+        block.n_cols, false, false);
   }
 
   arma::qr_econ(Q, R, K);
@@ -95,6 +97,77 @@ inline void RandomizedBlockKrylovSVD::Apply(const arma::mat& data,
   u = Q * u;
 }
 
+template<typename LoaderType, typename eT>
+inline void RandomizedBlockKrylovSVD::ApplyChunks(LoaderType& loader,
+                                                  arma::Mat<eT>& u,
+                                                  arma::Col<eT>& s,
+                                                  const size_t rank)
+{
+  const size_t dimensionality = loader.Dimensionality();
+  const size_t size = (blockSize == 0) ? rank + 10 : blockSize;
+
+  // First pass: apply the data to a random block.  The random block has one
+  // row per point, so it is drawn one chunk at a time.
+  arma::Mat<eT> chunk, R, Q;
+  arma::Mat<eT> block(dimensionality, size, arma::fill::zeros);
+  size_t numPoints = 0;
+
+  loader.Reset();
+  while (loader.Next(chunk))
+  {
+    block += chunk * arma::randn<arma::Mat<eT>>(chunk.n_cols, size);
+    numPoints += chunk.n_cols;
+  }
+
+  if (numPoints == 0)
+  {
+    throw std::invalid_argument("RandomizedBlockKrylovSVD::ApplyChunks(): "
+        "the data source is empty!");
+  }
+
+  arma::qr_econ(block, R, block);
+  arma::Mat<eT> K = block;
+
+  // Each following pass gives the next block of the Krylov subspace.
+  arma::Mat<eT> product(dimensionality, block.n_cols);
+  for (size_t i = 0; i < maxIterations; ++i)
+  {
+    product.zeros();
+    loader.Reset();
+    while (loader.Next(chunk))
+      product += chunk * (chunk.t() * block);
+
+    arma::qr_econ(block, R, product);
+    K = arma::join_rows(K, block);
+  }
+
+  arma::qr_econ(Q, R, K);
+
+  // Last pass: Rayleigh-Ritz approximation, from Q^T A A^T Q =
+  // W diag(s^2) W^T.
+  arma::Mat<eT> projected(Q.n_cols, Q.n_cols, arma::fill::zeros);
+  loader.Reset();
+  while (loader.Next(chunk))
+  {
+    const arma::Mat<eT> projectedChunk = Q.t() * chunk;
+    projected += projectedChunk * projectedChunk.t();
+  }
+  projected = 0.5 * (projected + projected.t());
+
+  arma::Col<eT> eigval;
+  arma::Mat<eT> eigvec;
+  if (!arma::eig_sym(eigval, eigvec, projected))
+  {
+    throw std::runtime_error("RandomizedBlockKrylovSVD::ApplyChunks(): the "
+        "eigendecomposition failed!");
+  }
+
+  // The eigenvalues are in ascending order.
+  s = arma::flipud(eigval);
+  s.transform([](const eT x) { return (x > 0) ? std::sqrt(x) : eT(0); });
+  u = Q * arma::fliplr(eigvec);
+}
+
 } // namespace mlpack
 
 #endif
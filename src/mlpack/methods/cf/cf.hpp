@@ -198,6 +198,13 @@ class CFType
   /**
    * Generates the given number of recommendations for the specified users.
    *
+   * If the decomposition policy provides `GetUserFactors()` and
+   * `GetItemFactors()` (as all the decomposition policies of mlpack do), the
+   * ratings are computed in blocks of users and items with matrix products of
+   * their factors, in parallel over blocks of users, without ever holding the
+   * full rating vector of a user; otherwise, the rating vector of each user is
+   * reconstructed from the ratings of its neighbors.
+   *
    * @tparam NeighborSearchPolicy The policy used to search neighbors of
    *     query set in referece set.
    * @tparam InterpolationPolicy The policy used to calculate interpolation
@@ -253,6 +260,38 @@ class CFType
   void Predict(const arma::Mat<size_t>& combinations,
                arma::vec& predictions) const;
 
+  /**
+   * Fold new users into the trained model, without retraining it.  The factors
+   * of each new user are computed from its given ratings with one regularized
+   * least squares solve against the fixed item factors; the factors of the
+   * other users and of the items are not changed.  The new users can then be
+   * queried with GetRecommendations() and Predict() like the others, and take
+   * part in the neighborhood searches.
+   *
+   * The data is in the same coordinate list form as for Train(); the users
+   * must be new (at least the number of users of the model), and the items
+   * must already be in the model.
+   *
+   * @param data Ratings of the new users, as a coordinate list.
+   * @param lambda Regularization parameter of the least squares problems.
+   */
+  void FoldInUsers(const arma::mat& data, const double lambda = 0.1);
+
+  /**
+   * Fold new items into the trained model, without retraining it.  The
+   * factors of each new item are computed from its given ratings with one
+   * regularized least squares solve against the fixed user factors; the factors
+   * of the other items and of the users are not changed.
+   *
+   * The data is in the same coordinate list form as for Train(); the items
+   * must be new (at least the number of items of the model), and the users
+   * must already be in the model.
+   *
+   * @param data Ratings of the new items, as a coordinate list.
+   * @param lambda Regularization parameter of the least squares problems.
+   */
+  void FoldInItems(const arma::mat& data, const double lambda = 0.1);
+
   /**
    * Serialize the CFType model to the given archive.
    */
@@ -281,6 +320,71 @@ class CFType
       return c1.first > c2.first;
     };
   };
+
+  //! List of the best candidates found so far; the worst one is on top.
+  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
+      CandidateList;
+
+  //! Number of users whose ratings are computed together.
+  static const size_t userBlockSize = 64;
+  //! Number of items whose ratings are computed together.
+  static const size_t itemBlockSize = 2048;
+
+  /**
+   * Generate recommendations from the full rating vector of each user, which
+   * is the weighted sum of the rating vectors of its neighbors.
+   */
+  void ComputeRecommendations(const size_t numRecs,
+                              arma::Mat<size_t>& recommendations,
+                              const arma::Col<size_t>& users,
+                              const arma::Mat<size_t>& neighborhood,
+                              const arma::mat& weights,
+                              const std::false_type& /* hasFactors */);
+
+  /**
+   * Generate recommendations from blocks of ratings, computed as the products
+   * of the factors of blocks of items with the factors of blocks of users
+   * (the weighted sums of the factors of their neighbors).
+   */
+  void ComputeRecommendations(const size_t numRecs,
+                              arma::Mat<size_t>& recommendations,
+                              const arma::Col<size_t>& users,
+                              const arma::Mat<size_t>& neighborhood,
+                              const arma::mat& weights,
+                              const std::true_type& /* hasFactors */);
+
+  /**
+   * Consider the given rating of an item by a user as a recommendation.
+   */
+  void AddCandidate(CandidateList& candidates,
+                    const size_t user,
+                    const size_t item,
+                    const double rating) const
+  {
+    // Denormalize rating before comparison.
+    const double realRating = normalization.Denormalize(user, item, rating);
+    if (realRating > candidates.top().first)
+    {
+      candidates.pop();
+      candidates.push(std::make_pair(realRating, item));
+    }
+  }
+
+  /**
+   * Move the candidates of the i'th queried user to its column of
+   * `recommendations`, best first.
+   */
+  void SaveCandidates(CandidateList& candidates,
+                      const size_t numRecs,
+                      arma::Mat<size_t>& recommendations,
+                      const size_t i) const
+  {
+    for (size_t p = 1; p <= numRecs; p++)
+    {
+      recommendations(numRecs - p, i) = candidates.top().second;
+      candidates.pop();
+    }
+  }
 }; // class CFType
 
 typedef CFType<> CF;
@@ -21,6 +21,23 @@
 
 namespace mlpack {
 
+/**
+ * This gives us a HasGetItemFactors object that we can use to tell whether or
+ * not a DecompositionPolicy gives the factors of users and items.
+ */
+HAS_MEM_FUNC(GetItemFactors, HasGetItemFactorsCheck);
+
+/**
+ * 'value' is true if the DecompositionPolicy class has a member
+ * GetItemFactors(arma::mat& factors) const (and so GetUserFactors() too).
+ */
+template<typename DecompositionPolicy>
+struct HasGetItemFactors
+{
+  static const bool value = HasGetItemFactorsCheck<DecompositionPolicy,
+      void(DecompositionPolicy::*)(arma::mat&) const>::value;
+};
+
 // Default CF constructor.
 template<typename DecompositionPolicy,
          typename NormalizationType>
@@ -193,42 +210,68 @@ GetRecommendations(const size_t numRecs,
   decomposition.template GetNeighborhood<NeighborSearchPolicy>(
       users, numUsersForSimilarity, neighborhood, similarities);
 
+  // Initialization of an InterpolationPolicy object should be put ahead of the
+  // following loop, because the initialization may takes a relatively long
+  // time and we don't want to repeat the initialization process in each loop.
+  InterpolationPolicy interpolation(cleanedData);
+
+  // Calculate the interpolation weights of the neighbors of each user.
+  arma::mat weights(numUsersForSimilarity, users.n_elem);
+  arma::vec userWeights(numUsersForSimilarity);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    interpolation.GetWeights(userWeights, decomposition, users(i),
+        neighborhood.col(i), similarities.col(i), cleanedData);
+    weights.col(i) = userWeights;
+  }
+
   // Generate recommendations for each query user by finding the maximum numRecs
   // elements in the ratings vector.
   recommendations.set_size(numRecs, users.n_elem);
-  arma::mat values(numRecs, users.n_elem);
   recommendations.fill(SIZE_MAX);
-  values.fill(DBL_MAX);
+  ComputeRecommendations(numRecs, recommendations, users, neighborhood,
+      weights, std::integral_constant<bool,
+          HasGetItemFactors<DecompositionPolicy>::value>());
 
-  // Initialization of an InterpolationPolicy object should be put ahead of the
-  // following loop, because the initialization may takes a relatively long
-  // time and we don't want to repeat the initialization process in each loop.
-  InterpolationPolicy interpolation(cleanedData);
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    if (recommendations(numRecs - 1, i) == cleanedData.n_rows)
+      Log::Warn << "Could not provide " << numRecs << " recommendations "
+          << "for user " << users(i) << " (not enough un-rated items)!"
+          << std::endl;
+  }
+}
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+ComputeRecommendations(const size_t numRecs,
+                       arma::Mat<size_t>& recommendations,
+                       const arma::Col<size_t>& users,
+                       const arma::Mat<size_t>& neighborhood,
+                       const arma::mat& weights,
+                       const std::false_type& /* hasFactors */)
+{
   for (size_t i = 0; i < users.n_elem; ++i)
   {
     // First, calculate the weighted sum of neighborhood values.
     arma::vec ratings;
     ratings.zeros(cleanedData.n_rows);
 
-    // Calculate interpolation weights.
-    arma::vec weights(numUsersForSimilarity);
-    interpolation.GetWeights(weights, decomposition, users(i),
-        neighborhood.col(i), similarities.col(i), cleanedData);
-
     for (size_t j = 0; j < neighborhood.n_rows; ++j)
     {
       arma::vec neighborRatings;
       decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
-      ratings += weights(j) * neighborRatings;
+      ratings += weights(j, i) * neighborRatings;
     }
 
     // Let's build the list of candidate recomendations for the given user.
     // Default candidate: the smallest possible value and invalid item number.
     const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
     std::vector<Candidate> vect(numRecs, def);
-    typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-        CandidateList;
     CandidateList pqueue(CandidateCmp(), std::move(vect));
 
     // Look through the ratings column corresponding to the current user.
@@ -241,30 +284,101 @@ GetRecommendations(const size_t numRecs,
       if (cleanedData(j, users(i)) != 0.0)
         continue; // The user already rated the item.
 
-      // Is the estimated value better than the worst candidate?
-      // Denormalize rating before comparison.
-      double realRating = normalization.Denormalize(users(i), j, ratings[j]);
-      if (realRating > pqueue.top().first)
-      {
-        Candidate c = std::make_pair(realRating, j);
-        pqueue.pop();
-        pqueue.push(c);
-      }
+      AddCandidate(pqueue, users(i), j, ratings[j]);
+    }
+
+    SaveCandidates(pqueue, numRecs, recommendations, i);
+  }
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+ComputeRecommendations(const size_t numRecs,
+                       arma::Mat<size_t>& recommendations,
+                       const arma::Col<size_t>& users,
+                       const arma::Mat<size_t>& neighborhood,
+                       const arma::mat& weights,
+                       const std::true_type& /* hasFactors */)
+{
+  // The ratings are linear in the factors of a user, so the ratings of a user
+  // are the products of the item factors with the weighted sum of the factors
+  // of its neighbors.
+  arma::mat userFactors;
+  arma::vec neighborFactors;
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+    {
+      decomposition.GetUserFactors(neighborhood(j, i), neighborFactors);
+      if (userFactors.n_rows != neighborFactors.n_elem)
+        userFactors.zeros(neighborFactors.n_elem, users.n_elem);
+      userFactors.col(i) += weights(j, i) * neighborFactors;
     }
+  }
+
+  arma::mat itemFactors;
+  decomposition.GetItemFactors(itemFactors);
 
-    for (size_t p = 1; p <= numRecs; p++)
+  // The rated items of each user are found directly in the compressed columns
+  // of the data.
+  cleanedData.sync();
+  const arma::uword* colPtrs = cleanedData.col_ptrs;
+  const arma::uword* rowIndices = cleanedData.row_indices;
+
+  const size_t numItems = cleanedData.n_rows;
+  const size_t userBlocks = (users.n_elem + userBlockSize - 1) / userBlockSize;
+  const Candidate def = std::make_pair(-DBL_MAX, numItems);
+
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t b = 0; b < userBlocks; ++b)
+  {
+    const size_t begin = b * userBlockSize;
+    const size_t end = std::min(begin + userBlockSize, (size_t) users.n_elem);
+
+    // Each user of the block has its own list of candidates, and the position
+    // of its next rated item.
+    std::vector<CandidateList> candidates;
+    std::vector<size_t> nextRated(end - begin);
+    for (size_t i = begin; i < end; ++i)
     {
-      recommendations(numRecs - p, i) = pqueue.top().second;
-      values(numRecs - p, i) = pqueue.top().first;
-      pqueue.pop();
+      candidates.push_back(CandidateList(CandidateCmp(),
+          std::vector<Candidate>(numRecs, def)));
+      nextRated[i - begin] = colPtrs[users(i)];
     }
 
-    // If we were not able to come up with enough recommendations, issue a
-    // warning.
-    if (recommendations(numRecs - 1, i) == def.second)
-      Log::Warn << "Could not provide " << numRecs << " recommendations "
-          << "for user " << users(i) << " (not enough un-rated items)!"
-          << std::endl;
+    arma::mat ratings;
+    for (size_t itemBegin = 0; itemBegin < numItems; itemBegin +=
+        itemBlockSize)
+    {
+      const size_t itemEnd = std::min(itemBegin + itemBlockSize, numItems);
+      ratings = itemFactors.cols(itemBegin, itemEnd - 1).t() *
+          userFactors.cols(begin, end - 1);
+
+      for (size_t i = begin; i < end; ++i)
+      {
+        const size_t user = users(i);
+        size_t& rated = nextRated[i - begin];
+        const size_t ratedEnd = colPtrs[user + 1];
+        const double* userRatings = ratings.colptr(i - begin);
+        for (size_t item = itemBegin; item < itemEnd; ++item)
+        {
+          // Skip the items that the user has already rated.
+          if (rated < ratedEnd && rowIndices[rated] == item)
+          {
+            ++rated;
+            continue;
+          }
+
+          AddCandidate(candidates[i - begin], user, item,
+              userRatings[item - itemBegin]);
+        }
+      }
+    }
+
+    for (size_t i = begin; i < end; ++i)
+      SaveCandidates(candidates[i - begin], numRecs, recommendations, i);
   }
 }
 
@@ -383,6 +497,96 @@ Predict(const arma::Mat<size_t>& combinations,
   normalization.Denormalize(combinations, predictions);
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldInUsers(const arma::mat& data, const double lambda)
+{
+  if (data.n_rows != 3)
+  {
+    std::ostringstream oss;
+    oss << "CFType::FoldInUsers(): the data must have 3 rows (user, item, "
+        << "rating), but it has " << data.n_rows << " rows!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (data.n_cols == 0)
+    return;
+
+  const size_t numUsers = cleanedData.n_cols;
+  const size_t minUser = (size_t) min(data.row(0));
+  const size_t maxItem = (size_t) max(data.row(1));
+  if (minUser < numUsers || maxItem >= cleanedData.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "CFType::FoldInUsers(): the users must be new (at least "
+        << numUsers << ") and the items must be in the model (less than "
+        << cleanedData.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::mat normalizedData(data);
+  normalization.FoldIn(normalizedData);
+
+  // The ratings of the new users, with the items as rows.
+  const size_t numNewUsers = (size_t) max(data.row(0)) + 1 - numUsers;
+  arma::umat locations(2, data.n_cols);
+  locations.row(0) = arma::conv_to<arma::urowvec>::from(normalizedData.row(1));
+  locations.row(1) = arma::conv_to<arma::urowvec>::from(normalizedData.row(0) -
+      numUsers);
+  arma::sp_mat ratings(locations, normalizedData.row(2).t(),
+      cleanedData.n_rows, numNewUsers);
+
+  decomposition.FoldInUsers(ratings, lambda);
+  cleanedData = arma::join_rows(cleanedData, ratings);
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldInItems(const arma::mat& data, const double lambda)
+{
+  if (data.n_rows != 3)
+  {
+    std::ostringstream oss;
+    oss << "CFType::FoldInItems(): the data must have 3 rows (user, item, "
+        << "rating), but it has " << data.n_rows << " rows!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (data.n_cols == 0)
+    return;
+
+  const size_t numItems = cleanedData.n_rows;
+  const size_t maxUser = (size_t) max(data.row(0));
+  const size_t minItem = (size_t) min(data.row(1));
+  if (minItem < numItems || maxUser >= cleanedData.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "CFType::FoldInItems(): the items must be new (at least "
+        << numItems << ") and the users must be in the model (less than "
+        << cleanedData.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::mat normalizedData(data);
+  normalization.FoldIn(normalizedData);
+
+  // The ratings of the new items, with the new items as rows.
+  const size_t numNewItems = (size_t) max(data.row(1)) + 1 - numItems;
+  arma::umat locations(2, data.n_cols);
+  locations.row(0) = arma::conv_to<arma::urowvec>::from(normalizedData.row(1) -
+      numItems);
+  locations.row(1) = arma::conv_to<arma::urowvec>::from(normalizedData.row(0));
+  arma::sp_mat ratings(locations, normalizedData.row(2).t(), numNewItems,
+      cleanedData.n_cols);
+
+  decomposition.FoldInItems(ratings, lambda);
+  cleanedData = arma::join_cols(cleanedData, ratings);
+}
+
 template<typename DecompositionPolicy,
          typename NormalizationType>
 void CFType<DecompositionPolicy,
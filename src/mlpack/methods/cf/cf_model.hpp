@@ -77,6 +77,12 @@ class CFWrapperBase
       const size_t numRecs,
       arma::Mat<size_t>& recommendations,
       const arma::Col<size_t>& users) = 0;
+
+  //! Fold new users into the model.
+  virtual void FoldInUsers(const arma::mat& data, const double lambda) = 0;
+
+  //! Fold new items into the model.
+  virtual void FoldInItems(const arma::mat& data, const double lambda) = 0;
 };
 
 /**
@@ -143,6 +149,18 @@ class CFWrapper : public CFWrapperBase
       arma::Mat<size_t>& recommendations,
       const arma::Col<size_t>& users);
 
+  //! Fold new users into the model.
+  virtual void FoldInUsers(const arma::mat& data, const double lambda)
+  {
+    cf.FoldInUsers(data, lambda);
+  }
+
+  //! Fold new items into the model.
+  virtual void FoldInItems(const arma::mat& data, const double lambda)
+  {
+    cf.FoldInItems(data, lambda);
+  }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -268,6 +286,12 @@ class CFModel
                           const size_t numRecs,
                           arma::Mat<size_t>& recommendations);
 
+  //! Fold new users into the model; see CFType::FoldInUsers().
+  void FoldInUsers(const arma::mat& data, const double lambda = 0.1);
+
+  //! Fold new items into the model; see CFType::FoldInItems().
+  void FoldInItems(const arma::mat& data, const double lambda = 0.1);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
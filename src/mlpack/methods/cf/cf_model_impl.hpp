@@ -501,6 +501,18 @@ inline void CFModel::GetRecommendations(
   cf->GetRecommendations(nsType, interpolationType, numRecs, recommendations);
 }
 
+//! Fold new users into the model.
+inline void CFModel::FoldInUsers(const arma::mat& data, const double lambda)
+{
+  cf->FoldInUsers(data, lambda);
+}
+
+//! Fold new items into the model.
+inline void CFModel::FoldInItems(const arma::mat& data, const double lambda)
+{
+  cf->FoldInItems(data, lambda);
+}
+
 template<typename Archive>
 void CFModel::serialize(Archive& ar, const uint32_t /* version */)
 {
@@ -0,0 +1,273 @@
+/**
+ * @file methods/cf/decomposition_policies/als_method.hpp
+ *
+ * Implementation of the alternating least squares method for use in
+ * Collaborative Filtering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_ALS_METHOD_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_ALS_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/amf/amf.hpp>
+#include <mlpack/methods/amf/update_rules/als_update.hpp>
+#include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
+#include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
+#include "fold_in_factors.hpp"
+#include "neighbor_search_cache.hpp"
+
+namespace mlpack {
+
+/**
+ * Implementation of the ALS policy to act as a wrapper when accessing
+ * alternating least squares (see ALSUpdate) from within CFType.  Only the
+ * observed ratings are fitted, and the factors of all users (and then of all
+ * items) are solved in parallel.  With implicit feedback, the ratings are
+ * treated as confidences of observed interactions, and the predicted ratings
+ * are preferences between 0 and 1.
+ *
+ * An example of how to use ALSPolicy in CF is shown below:
+ *
+ * @code
+ * extern arma::mat data; // data is a (user, item, rating) table.
+ * // Users for whom recommendations are generated.
+ * extern arma::Col<size_t> users;
+ * arma::Mat<size_t> recommendations; // Resulting recommendations.
+ *
+ * CFType<ALSPolicy> cf(data);
+ *
+ * // Generate 10 recommendations for all users.
+ * cf.GetRecommendations(10, recommendations);
+ * @endcode
+ */
+class ALSPolicy
+{
+ public:
+  /**
+   * Use alternating least squares to perform collaborative filtering.
+   *
+   * @param lambda Regularization parameter.
+   * @param implicit Whether to treat the ratings as implicit feedback.
+   * @param alpha Confidence scale of the implicit feedback.
+   */
+  ALSPolicy(const double lambda = 0.05,
+            const bool implicit = false,
+            const double alpha = 40.0) :
+      lambda(lambda),
+      implicit(implicit),
+      alpha(alpha)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Collaborative Filtering to the provided dataset using alternating
+   * least squares.
+   *
+   * @param * (data) Data matrix: dense matrix (coordinate lists)
+   *    or sparse matrix (cleaned).
+   * @param cleanedData item user table in form of sparse matrix.
+   * @param rank Rank parameter for matrix factorization.
+   * @param maxIterations Maximum number of iterations.
+   * @param minResidue Residue required to terminate.
+   * @param mit Whether to terminate only when maxIterations is reached.
+   */
+  template<typename MatType>
+  void Apply(const MatType& /* data */,
+             const arma::sp_mat& cleanedData,
+             const size_t rank,
+             const size_t maxIterations,
+             const double minResidue,
+             const bool mit)
+  {
+    searchCache.Clear();
+    ALSUpdate update(lambda, implicit, alpha);
+    if (mit)
+    {
+      MaxIterationTermination iter(maxIterations);
+      AMF<MaxIterationTermination, RandomAMFInitialization, ALSUpdate>
+          als(iter, RandomAMFInitialization(), update);
+      als.Apply(cleanedData, rank, w, h);
+    }
+    else
+    {
+      SimpleResidueTermination srt(minResidue, maxIterations);
+      ALSFactorizer als(srt, RandomAMFInitialization(), update);
+      als.Apply(cleanedData, rank, w, h);
+    }
+  }
+
+  /**
+   * Return predicted rating given user ID and item ID.
+   *
+   * @param user User ID.
+   * @param item Item ID.
+   */
+  double GetRating(const size_t user, const size_t item) const
+  {
+    double rating = arma::as_scalar(w.row(item) * h.col(user));
+    return rating;
+  }
+
+  /**
+   * Get predicted ratings for a user.
+   *
+   * @param user User ID.
+   * @param rating Resulting rating vector.
+   */
+  void GetRatingOfUser(const size_t user, arma::vec& rating) const
+  {
+    rating = w * h.col(user);
+  }
+
+  /**
+   * Get the factors of a user, such that the rating of each item by the user
+   * is the dot product of these factors with the column of the item in the
+   * matrix given by GetItemFactors().
+   *
+   * @param user User ID.
+   * @param factors Resulting factors of the user.
+   */
+  void GetUserFactors(const size_t user, arma::vec& factors) const
+  {
+    factors = h.col(user);
+  }
+
+  /**
+   * Get the factors of all items, one column per item (see GetUserFactors()).
+   *
+   * @param factors Resulting factors of the items.
+   */
+  void GetItemFactors(arma::mat& factors) const
+  {
+    factors = w.t();
+  }
+
+  /**
+   * Fold new users into the model: compute the factors of each new user from
+   * its ratings with the item matrix fixed, with one least squares solve per
+   * user (see FoldInFactors()).  The new users get the next user IDs.
+   *
+   * @param ratings Ratings of the new users, as an item-user table with one
+   *     column per new user.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& ratings, const double lambda)
+  {
+    searchCache.Clear();
+    arma::mat factors;
+    FoldInFactors(ratings, w.t(), arma::vec(), lambda, factors);
+    h = arma::join_rows(h, factors);
+  }
+
+  /**
+   * Fold new items into the model: compute the factors of each new item from
+   * its ratings with the user matrix fixed, with one least squares solve per
+   * item (see FoldInFactors()).  The new items get the next item IDs.
+   *
+   * @param ratings Ratings of the new items, as an item-user table with one
+   *     row per new item.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& ratings, const double lambda)
+  {
+    searchCache.Clear();
+    arma::mat factors;
+    FoldInFactors(ratings.t(), h, arma::vec(), lambda, factors);
+    w = arma::join_cols(w, factors.t());
+  }
+
+  /**
+   * Get the neighborhood and corresponding similarities for a set of users.
+   *
+   * @tparam NeighborSearchPolicy The policy to perform neighbor search.
+   *
+   * @param users Users whose neighborhood is to be computed.
+   * @param numUsersForSimilarity The number of neighbors returned for
+   *     each user.
+   * @param neighborhood Neighbors represented by user IDs.
+   * @param similarities Similarity between each user and each of its
+   *     neighbors.
+   */
+  template<typename NeighborSearchPolicy>
+  void GetNeighborhood(const arma::Col<size_t>& users,
+                       const size_t numUsersForSimilarity,
+                       arma::Mat<size_t>& neighborhood,
+                       arma::mat& similarities) const
+  {
+    // We want to avoid calculating the full rating matrix, so we will do
+    // nearest neighbor search only on the H matrix, using the observation that
+    // if the rating matrix X = W*H, then d(X.col(i), X.col(j)) = d(W H.col(i),
+    // W H.col(j)).  This can be seen as nearest neighbor search on the H
+    // matrix with the Mahalanobis distance where M^{-1} = W^T W.  So, we'll
+    // decompose M^{-1} = L L^T (the Cholesky decomposition), and then multiply
+    // H by L^T. Then we can perform nearest neighbor search.  The search
+    // structure over the stretched H is built once, and reused until the
+    // factors change.
+    searchCache.template Search<NeighborSearchPolicy>(users,
+        numUsersForSimilarity, neighborhood, similarities, [this]()
+        {
+          arma::mat l = arma::chol(w.t() * w);
+          return arma::mat(l * h); // Due to the Armadillo API, l is L^T.
+        });
+  }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get whether the ratings are treated as implicit feedback.
+  bool Implicit() const { return implicit; }
+  //! Modify whether the ratings are treated as implicit feedback.
+  bool& Implicit() { return implicit; }
+
+  //! Get the confidence scale of the implicit feedback.
+  double Alpha() const { return alpha; }
+  //! Modify the confidence scale of the implicit feedback.
+  double& Alpha() { return alpha; }
+
+  //! Get the Item Matrix.
+  const arma::mat& W() const { return w; }
+  //! Get the User Matrix.
+  const arma::mat& H() const { return h; }
+
+  /**
+   * Serialization.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    // The neighbor search is built again from the loaded factors.
+    if (cereal::is_loading<Archive>())
+      searchCache.Clear();
+
+    ar(CEREAL_NVP(lambda));
+    ar(CEREAL_NVP(implicit));
+    ar(CEREAL_NVP(alpha));
+    ar(CEREAL_NVP(w));
+    ar(CEREAL_NVP(h));
+  }
+
+ private:
+  //! Regularization parameter.
+  double lambda;
+  //! Whether the ratings are treated as implicit feedback.
+  bool implicit;
+  //! Confidence scale of the implicit feedback.
+  double alpha;
+  //! Item matrix.
+  arma::mat w;
+  //! User matrix.
+  arma::mat h;
+  //! Cached neighbor search over the user features.
+  mutable NeighborSearchCache searchCache;
+};
+
+} // namespace mlpack
+
+#endif
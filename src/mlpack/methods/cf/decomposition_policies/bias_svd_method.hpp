@@ -16,6 +16,8 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/bias_svd/bias_svd.hpp>
+#include "fold_in_factors.hpp"
+#include "neighbor_search_cache.hpp"
 
 namespace mlpack {
 
@@ -76,6 +78,8 @@ class BiasSVDPolicy
              const double /* minResidue */,
              const bool /* mit */)
   {
+    searchCache.Clear();
+
     // Perform decomposition using the bias SVD algorithm.
     BiasSVD<> biassvd(maxIterations, alpha, lambda);
     biassvd.Apply(data, rank, w, h, p, q);
@@ -105,6 +109,76 @@ class BiasSVDPolicy
     rating = w * h.col(user) + p + q(user);
   }
 
+  /**
+   * Get the factors of a user, such that the rating of each item by the user
+   * is the dot product of these factors with the column of the item in the
+   * matrix given by GetItemFactors().
+   *
+   * @param user User ID.
+   * @param factors Resulting factors of the user.
+   */
+  void GetUserFactors(const size_t user, arma::vec& factors) const
+  {
+    factors = arma::join_cols(h.col(user), arma::vec({ 1.0, q(user) }));
+  }
+
+  /**
+   * Get the factors of all items, one column per item (see GetUserFactors()).
+   * The last two rows hold the item bias and a constant one, which multiply
+   * the constant one and the user bias in the factors of a user.
+   *
+   * @param factors Resulting factors of the items.
+   */
+  void GetItemFactors(arma::mat& factors) const
+  {
+    factors = arma::join_cols(w.t(), p.t(), arma::ones<arma::rowvec>(w.n_rows));
+  }
+
+  /**
+   * Fold new users into the model: compute the factors and the bias of each
+   * new user from its ratings with the item matrix and biases fixed, with one
+   * least squares solve per user (see FoldInFactors()).  The new users get the
+   * next user IDs.
+   *
+   * @param ratings Ratings of the new users, as an item-user table with one
+   *     column per new user.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& ratings, const double lambda)
+  {
+    searchCache.Clear();
+
+    // The last factor of each user is its bias, which multiplies a constant
+    // one.
+    const size_t rank = h.n_rows;
+    arma::mat factors;
+    FoldInFactors(ratings, arma::join_cols(w.t(),
+        arma::ones<arma::rowvec>(w.n_rows)), p, lambda, factors);
+    h = arma::join_rows(h, factors.rows(0, rank - 1));
+    q = arma::join_cols(q, factors.row(rank).t());
+  }
+
+  /**
+   * Fold new items into the model: compute the factors and the bias of each
+   * new item from its ratings with the user matrix and biases fixed, with one
+   * least squares solve per item (see FoldInFactors()).  The new items get the
+   * next item IDs.
+   *
+   * @param ratings Ratings of the new items, as an item-user table with one
+   *     row per new item.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& ratings, const double lambda)
+  {
+    searchCache.Clear();
+    const size_t rank = h.n_rows;
+    arma::mat factors;
+    FoldInFactors(ratings.t(), arma::join_cols(h,
+        arma::ones<arma::rowvec>(h.n_cols)), q, lambda, factors);
+    w = arma::join_cols(w, factors.rows(0, rank - 1).t());
+    p = arma::join_cols(p, factors.row(rank).t());
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -123,16 +197,11 @@ class BiasSVDPolicy
                        arma::Mat<size_t>& neighborhood,
                        arma::mat& similarities) const
   {
-    // User latent vectors (matrix H) are used for neighbor search.
-    // Temporarily store feature vector of queried users.
-    arma::mat query(h.n_rows, users.n_elem);
-    // Select feature vectors of queried users.
-    for (size_t i = 0; i < users.n_elem; ++i)
-      query.col(i) = h.col(users(i));
-
-    NeighborSearchPolicy neighborSearch(h);
-    neighborSearch.Search(
-        query, numUsersForSimilarity, neighborhood, similarities);
+    // User latent vectors (matrix H) are used for neighbor search.  The search
+    // structure is built once, and reused until the factors change.
+    searchCache.template Search<NeighborSearchPolicy>(users,
+        numUsersForSimilarity, neighborhood, similarities,
+        [this]() { return h; });
   }
 
   //! Get the Item Matrix.
@@ -165,6 +234,10 @@ class BiasSVDPolicy
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
   {
+    // The neighbor search is built again from the loaded factors.
+    if (cereal::is_loading<Archive>())
+      searchCache.Clear();
+
     ar(CEREAL_NVP(maxIterations));
     ar(CEREAL_NVP(alpha));
     ar(CEREAL_NVP(lambda));
@@ -189,6 +262,8 @@ class BiasSVDPolicy
   arma::vec p;
   //! User bias.
   arma::vec q;
+  //! Cached neighbor search over the user features.
+  mutable NeighborSearchCache searchCache;
 };
 
 } // namespace mlpack
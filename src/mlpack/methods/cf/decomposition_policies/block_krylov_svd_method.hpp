@@ -16,6 +16,8 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/block_krylov_svd/block_krylov_svd.hpp>
+#include "fold_in_factors.hpp"
+#include "neighbor_search_cache.hpp"
 
 namespace mlpack {
 
@@ -42,8 +44,13 @@ class BlockKrylovSVDPolicy
  public:
   /**
    * Create block krylov SVD object to use for collaborative filtering.
+   *
+   * @param chunkSize If nonzero, the rating matrix is decomposed with
+   *        RandomizedBlockKrylovSVD::ApplyChunks(), reading chunkSize users at
+   *        a time, instead of being converted to a dense matrix (Default: 0).
    */
-  BlockKrylovSVDPolicy()
+  BlockKrylovSVDPolicy(const size_t chunkSize = 0) :
+      chunkSize(chunkSize)
   {
     /* Nothing to do here */
   }
@@ -68,14 +75,28 @@ class BlockKrylovSVDPolicy
              const double /* minResidue */,
              const bool /* mit */)
   {
+    searchCache.Clear();
     arma::vec sigma;
 
-    // Preprocessed data converted to mat format
-    arma::mat data(cleanedData);
-
     // Do singular value decomposition using the block krylov SVD algorithm.
     RandomizedBlockKrylovSVD blockkrylovsvd;
-    blockkrylovsvd.Apply(data, w, sigma, h, rank);
+    if (chunkSize == 0)
+    {
+      // Preprocessed data converted to mat format
+      arma::mat data(cleanedData);
+      blockkrylovsvd.Apply(data, w, sigma, h, rank);
+    }
+    else
+    {
+      // Only chunkSize users are converted to a dense matrix at a time.  The
+      // user factors are then recovered from the ratings as V = A^T U S^-1.
+      data::MatrixChunkLoader<arma::sp_mat> loader(cleanedData, chunkSize);
+      blockkrylovsvd.ApplyChunks(loader, w, sigma, rank);
+
+      arma::vec invSigma = sigma;
+      invSigma.transform([](const double x) { return (x > 0) ? 1 / x : 0; });
+      h = trans(arma::diagmat(invSigma) * (w.t() * cleanedData));
+    }
 
     // Sigma matrix is multiplied to w.
     w = w * arma::diagmat(sigma);
@@ -107,6 +128,63 @@ class BlockKrylovSVDPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Get the factors of a user, such that the rating of each item by the user
+   * is the dot product of these factors with the column of the item in the
+   * matrix given by GetItemFactors().
+   *
+   * @param user User ID.
+   * @param factors Resulting factors of the user.
+   */
+  void GetUserFactors(const size_t user, arma::vec& factors) const
+  {
+    factors = h.col(user);
+  }
+
+  /**
+   * Get the factors of all items, one column per item (see GetUserFactors()).
+   *
+   * @param factors Resulting factors of the items.
+   */
+  void GetItemFactors(arma::mat& factors) const
+  {
+    factors = w.t();
+  }
+
+  /**
+   * Fold new users into the model: compute the factors of each new user from
+   * its ratings with the item matrix fixed, with one least squares solve per
+   * user (see FoldInFactors()).  The new users get the next user IDs.
+   *
+   * @param ratings Ratings of the new users, as an item-user table with one
+   *     column per new user.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& ratings, const double lambda)
+  {
+    searchCache.Clear();
+    arma::mat factors;
+    FoldInFactors(ratings, w.t(), arma::vec(), lambda, factors);
+    h = arma::join_rows(h, factors);
+  }
+
+  /**
+   * Fold new items into the model: compute the factors of each new item from
+   * its ratings with the user matrix fixed, with one least squares solve per
+   * item (see FoldInFactors()).  The new items get the next item IDs.
+   *
+   * @param ratings Ratings of the new items, as an item-user table with one
+   *     row per new item.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& ratings, const double lambda)
+  {
+    searchCache.Clear();
+    arma::mat factors;
+    FoldInFactors(ratings.t(), h, arma::vec(), lambda, factors);
+    w = arma::join_cols(w, factors.t());
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -131,19 +209,15 @@ class BlockKrylovSVDPolicy
     // W H.col(j)).  This can be seen as nearest neighbor search on the H
     // matrix with the Mahalanobis distance where M^{-1} = W^T W.  So, we'll
     // decompose M^{-1} = L L^T (the Cholesky decomposition), and then multiply
-    // H by L^T. Then we can perform nearest neighbor search.
-    arma::mat l = arma::chol(w.t() * w);
-    arma::mat stretchedH = l * h; // Due to the Armadillo API, l is L^T.
-
-    // Temporarily store feature vector of queried users.
-    arma::mat query(stretchedH.n_rows, users.n_elem);
-    // Select feature vectors of queried users.
-    for (size_t i = 0; i < users.n_elem; ++i)
-      query.col(i) = stretchedH.col(users(i));
-
-    NeighborSearchPolicy neighborSearch(stretchedH);
-    neighborSearch.Search(
-        query, numUsersForSimilarity, neighborhood, similarities);
+    // H by L^T. Then we can perform nearest neighbor search.  The search
+    // structure over the stretched H is built once, and reused until the
+    // factors change.
+    searchCache.template Search<NeighborSearchPolicy>(users,
+        numUsersForSimilarity, neighborhood, similarities, [this]()
+        {
+          arma::mat l = arma::chol(w.t() * w);
+          return arma::mat(l * h); // Due to the Armadillo API, l is L^T.
+        });
   }
 
   //! Get the Item Matrix.
@@ -151,21 +225,34 @@ class BlockKrylovSVDPolicy
   //! Get the User Matrix.
   const arma::mat& H() const { return h; }
 
+  //! Get the number of users read at a time (0 reads all of them at once).
+  size_t ChunkSize() const { return chunkSize; }
+  //! Modify the number of users read at a time (0 reads all of them at once).
+  size_t& ChunkSize() { return chunkSize; }
+
   /**
    * Serialization.
    */
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
   {
+    // The neighbor search is built again from the loaded factors.
+    if (cereal::is_loading<Archive>())
+      searchCache.Clear();
+
     ar(CEREAL_NVP(w));
     ar(CEREAL_NVP(h));
   }
 
  private:
+  //! Number of users read at a time, or 0.
+  size_t chunkSize;
   //! Item matrix.
   arma::mat w;
   //! User matrix.
   arma::mat h;
+  //! Cached neighbor search over the user features.
+  mutable NeighborSearchCache searchCache;
 };
 
 } // namespace mlpack
@@ -0,0 +1,103 @@
+/**
+ * @file methods/cf/decomposition_policies/fold_in_factors.hpp
+ *
+ * Least squares computation of the factors of new users or items of a
+ * factorization, used by the decomposition policies to fold in new users and
+ * items.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_FOLD_IN_FACTORS_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_FOLD_IN_FACTORS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
+
+namespace mlpack {
+
+/**
+ * Compute the factors that best fit each column of the given ratings, with the
+ * other factors of the factorization fixed: column j of `factors` is set to
+ * the solution x of the regularized least squares problem
+ *
+ *   min_x sum_i (ratings(i, j) - offsets(i) - fixed.col(i)^T x)^2 +
+ *       lambda ||x||^2
+ *
+ * where the sum is over the nonzero (observed) ratings of column j only.  Each
+ * problem only takes one Cholesky decomposition of a k x k matrix, where k is
+ * the number of factors; the columns are solved in parallel.  A column
+ * without any rating gets zero factors.
+ *
+ * @param ratings Ratings to fit, one column per set of factors to compute.
+ * @param fixed Fixed factors, one column per row of `ratings`.
+ * @param offsets Part of each row of the ratings that is not explained by
+ *     the factors (such as item biases), or an empty vector.
+ * @param lambda Regularization parameter.
+ * @param factors Set to the computed factors, one column per column of
+ *     `ratings`.
+ */
+inline void FoldInFactors(const arma::sp_mat& ratings,
+                          const arma::mat& fixed,
+                          const arma::vec& offsets,
+                          const double lambda,
+                          arma::mat& factors)
+{
+  if (ratings.n_rows != fixed.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "FoldInFactors(): the ratings have " << ratings.n_rows << " rows "
+        << "but there are " << fixed.n_cols << " fixed factors!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t rank = fixed.n_rows;
+  factors.zeros(rank, ratings.n_cols);
+
+  // The observed ratings of each column are read directly from the compressed
+  // columns of the ratings.
+  ratings.sync();
+
+  #pragma omp parallel for schedule(dynamic, 16) num_threads((int) NumThreads())
+  for (size_t j = 0; j < ratings.n_cols; ++j)
+  {
+    const size_t begin = ratings.col_ptrs[j];
+    const size_t nnz = ratings.col_ptrs[j + 1] - begin;
+    if (nnz == 0)
+      continue;
+
+    arma::uvec rows(nnz);
+    arma::vec values(nnz);
+    for (size_t i = 0; i < nnz; ++i)
+    {
+      rows[i] = ratings.row_indices[begin + i];
+      values[i] = ratings.values[begin + i];
+      if (offsets.n_elem > 0)
+        values[i] -= offsets[rows[i]];
+    }
+
+    const arma::mat observed = fixed.cols(rows);
+    arma::mat a = observed * observed.t();
+    a.diag() += lambda;
+    const arma::vec b = observed * values;
+
+    arma::mat l;
+    if (arma::chol(l, a, "lower"))
+    {
+      factors.col(j) = arma::solve(arma::trimatu(l.t()),
+          arma::solve(arma::trimatl(l), b));
+    }
+    else
+    {
+      // Without regularization, a is singular when there are fewer ratings
+      // than factors.
+      factors.col(j) = arma::pinv(a) * b;
+    }
+  }
+}
+
+} // namespace mlpack
+
+#endif
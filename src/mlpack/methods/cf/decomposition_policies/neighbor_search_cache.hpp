@@ -0,0 +1,138 @@
+/**
+ * @file methods/cf/decomposition_policies/neighbor_search_cache.hpp
+ *
+ * Cache of the user neighbor search structure of a decomposition policy, so
+ * that the search tree over the user factors is not built again for each query.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_NEIGHBOR_SEARCH_CACHE_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_NEIGHBOR_SEARCH_CACHE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mutex>
+
+namespace mlpack {
+
+/**
+ * NeighborSearchCache holds the neighbor search object (such as
+ * EuclideanSearch or CosineSearch, with its normalized reference set and its
+ * tree) built over the user features of a decomposition policy, and reuses it
+ * for all the searches with the same type of neighbor search, until it is
+ * cleared.  Decomposition policies must call Clear() whenever their factors
+ * change.
+ *
+ * The queried users are searched for all at once, so the default dual-tree
+ * search of the neighbor search object is used for the whole batch.
+ *
+ * The cache is not copied or serialized: a copy starts empty, and builds its
+ * own search object on its first search.  Searches are serialized with a
+ * mutex, so that a model can be queried from several threads.
+ */
+class NeighborSearchCache
+{
+ public:
+  //! Create an empty cache.
+  NeighborSearchCache() : search(NULL) { }
+
+  //! Create an empty cache; the search object of the other cache is not
+  //! copied.
+  NeighborSearchCache(const NeighborSearchCache& /* other */) : search(NULL) { }
+
+  //! Clear the cache; the search object of the other cache is not copied.
+  NeighborSearchCache& operator=(const NeighborSearchCache& /* other */)
+  {
+    Clear();
+    return *this;
+  }
+
+  //! Destroy the cache.
+  ~NeighborSearchCache() { delete search; }
+
+  //! Delete the cached search object, if any.
+  void Clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    delete search;
+    search = NULL;
+  }
+
+  //! Get whether a search object is cached.
+  bool Empty() const { return search == NULL; }
+
+  /**
+   * Search for the neighbors of the given users, building the search object
+   * first if no search object of the given type is cached.
+   *
+   * @tparam NeighborSearchPolicy The policy to perform neighbor search.
+   * @tparam FeatureFunctionType Type of the function that computes the user
+   *     features.
+   * @param users Users whose neighborhood is to be computed.
+   * @param k The number of neighbors returned for each user.
+   * @param neighborhood Neighbors represented by user IDs.
+   * @param similarities Similarity between each user and each of its
+   *     neighbors.
+   * @param features Called as `features()` to get the matrix of the features
+   *     of all users, one column per user, when the search object is built.
+   */
+  template<typename NeighborSearchPolicy, typename FeatureFunctionType>
+  void Search(const arma::Col<size_t>& users,
+              const size_t k,
+              arma::Mat<size_t>& neighborhood,
+              arma::mat& similarities,
+              FeatureFunctionType features)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    CachedSearch<NeighborSearchPolicy>* cached =
+        dynamic_cast<CachedSearch<NeighborSearchPolicy>*>(search);
+    if (cached == NULL)
+    {
+      delete search;
+      search = NULL;
+      cached = new CachedSearch<NeighborSearchPolicy>(features());
+      search = cached;
+    }
+
+    // Select feature vectors of queried users.
+    arma::mat query(cached->features.n_rows, users.n_elem);
+    for (size_t i = 0; i < users.n_elem; ++i)
+      query.col(i) = cached->features.col(users(i));
+
+    cached->search.Search(query, k, neighborhood, similarities);
+  }
+
+ private:
+  //! Base class of the cached search objects, of any type.
+  struct CachedSearchBase
+  {
+    virtual ~CachedSearchBase() { }
+  };
+
+  //! A cached search object, with the features of the users.
+  template<typename NeighborSearchPolicy>
+  struct CachedSearch : public CachedSearchBase
+  {
+    CachedSearch(arma::mat&& features) :
+        features(std::move(features)),
+        search(this->features)
+    { }
+
+    //! The features of all users.
+    arma::mat features;
+    //! The search object built over the features.
+    NeighborSearchPolicy search;
+  };
+
+  //! The cached search object, or NULL.
+  CachedSearchBase* search;
+  //! Lock for the cached search object.
+  std::mutex mutex;
+};
+
+} // namespace mlpack
+
+#endif
@@ -18,6 +18,8 @@
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
+#include "fold_in_factors.hpp"
+#include "neighbor_search_cache.hpp"
 
 namespace mlpack {
 
@@ -61,6 +63,7 @@ class NMFPolicy
              const double minResidue,
              const bool mit)
   {
+    searchCache.Clear();
     if (mit)
     {
       MaxIterationTermination iter(maxIterations);
@@ -103,6 +106,63 @@ class NMFPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Get the factors of a user, such that the rating of each item by the user
+   * is the dot product of these factors with the column of the item in the
+   * matrix given by GetItemFactors().
+   *
+   * @param user User ID.
+   * @param factors Resulting factors of the user.
+   */
+  void GetUserFactors(const size_t user, arma::vec& factors) const
+  {
+    factors = h.col(user);
+  }
+
+  /**
+   * Get the factors of all items, one column per item (see GetUserFactors()).
+   *
+   * @param factors Resulting factors of the items.
+   */
+  void GetItemFactors(arma::mat& factors) const
+  {
+    factors = w.t();
+  }
+
+  /**
+   * Fold new users into the model: compute the factors of each new user from
+   * its ratings with the item matrix fixed, with one least squares solve per
+   * user (see FoldInFactors()).  The new users get the next user IDs.
+   *
+   * @param ratings Ratings of the new users, as an item-user table with one
+   *     column per new user.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& ratings, const double lambda)
+  {
+    searchCache.Clear();
+    arma::mat factors;
+    FoldInFactors(ratings, w.t(), arma::vec(), lambda, factors);
+    h = arma::join_rows(h, factors);
+  }
+
+  /**
+   * Fold new items into the model: compute the factors of each new item from
+   * its ratings with the user matrix fixed, with one least squares solve per
+   * item (see FoldInFactors()).  The new items get the next item IDs.
+   *
+   * @param ratings Ratings of the new items, as an item-user table with one
+   *     row per new item.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& ratings, const double lambda)
+  {
+    searchCache.Clear();
+    arma::mat factors;
+    FoldInFactors(ratings.t(), h, arma::vec(), lambda, factors);
+    w = arma::join_cols(w, factors.t());
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -127,19 +187,15 @@ class NMFPolicy
     // W H.col(j)).  This can be seen as nearest neighbor search on the H
     // matrix with the Mahalanobis distance where M^{-1} = W^T W.  So, we'll
     // decompose M^{-1} = L L^T (the Cholesky decomposition), and then multiply
-    // H by L^T. Then we can perform nearest neighbor search.
-    arma::mat l = arma::chol(w.t() * w);
-    arma::mat stretchedH = l * h; // Due to the Armadillo API, l is L^T.
-
-    // Temporarily store feature vector of queried users.
-    arma::mat query(stretchedH.n_rows, users.n_elem);
-    // Select feature vectors of queried users.
-    for (size_t i = 0; i < users.n_elem; ++i)
-      query.col(i) = stretchedH.col(users(i));
-
-    NeighborSearchPolicy neighborSearch(stretchedH);
-    neighborSearch.Search(
-        query, numUsersForSimilarity, neighborhood, similarities);
+    // H by L^T. Then we can perform nearest neighbor search.  The search
+    // structure over the stretched H is built once, and reused until the
+    // factors change.
+    searchCache.template Search<NeighborSearchPolicy>(users,
+        numUsersForSimilarity, neighborhood, similarities, [this]()
+        {
+          arma::mat l = arma::chol(w.t() * w);
+          return arma::mat(l * h); // Due to the Armadillo API, l is L^T.
+        });
   }
 
   //! Get the Item Matrix.
@@ -153,6 +209,10 @@ class NMFPolicy
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
   {
+    // The neighbor search is built again from the loaded factors.
+    if (cereal::is_loading<Archive>())
+      searchCache.Clear();
+
     ar(CEREAL_NVP(w));
     ar(CEREAL_NVP(h));
   }
@@ -162,6 +222,8 @@ class NMFPolicy
   arma::mat w;
   //! User matrix.
   arma::mat h;
+  //! Cached neighbor search over the user features.
+  mutable NeighborSearchCache searchCache;
 };
 
 } // namespace mlpack
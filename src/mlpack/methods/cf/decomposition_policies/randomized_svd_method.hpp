@@ -16,6 +16,8 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/randomized_svd/randomized_svd.hpp>
+#include "fold_in_factors.hpp"
+#include "neighbor_search_cache.hpp"
 
 namespace mlpack {
 
@@ -47,11 +49,16 @@ class RandomizedSVDPolicy
    *        (Default: rank + 2).
    * @param maxIterations Number of iterations for the power method
    *        (Default: 2).
+   * @param chunkSize If nonzero, the rating matrix is decomposed with
+   *        RandomizedSVD::ApplyChunks(), reading chunkSize users at a time,
+   *        instead of all at once (Default: 0).
    */
   RandomizedSVDPolicy(const size_t iteratedPower = 0,
-                      const size_t maxIterations = 2) :
+                      const size_t maxIterations = 2,
+                      const size_t chunkSize = 0) :
       iteratedPower(iteratedPower),
-      maxIterations(maxIterations)
+      maxIterations(maxIterations),
+      chunkSize(chunkSize)
   {
     /* Nothing to do here */
   }
@@ -76,11 +83,29 @@ class RandomizedSVDPolicy
              const double /* minResidue */,
              const bool /* mit */)
   {
+    searchCache.Clear();
     arma::vec sigma;
 
     // Do singular value decomposition using the randomized SVD algorithm.
     RandomizedSVD rsvd(iteratedPower, maxIterations);
-    rsvd.Apply(cleanedData, w, sigma, h, rank);
+    if (chunkSize == 0)
+    {
+      rsvd.Apply(cleanedData, w, sigma, h, rank);
+    }
+    else
+    {
+      // Only the item factors are computed chunk by chunk; the user factors
+      // are then recovered from the centered ratings as V = C^T U S^-1.
+      data::MatrixChunkLoader<arma::sp_mat> loader(cleanedData, chunkSize);
+      rsvd.ApplyChunks(loader, w, sigma, rank);
+
+      const arma::vec mean = arma::vec(arma::sum(cleanedData, 1)) /
+          cleanedData.n_cols;
+      arma::vec invSigma = sigma;
+      invSigma.transform([](const double x) { return (x > 0) ? 1 / x : 0; });
+      h = trans(arma::diagmat(invSigma) * (w.t() * cleanedData -
+          (w.t() * mean) * arma::ones<arma::rowvec>(cleanedData.n_cols)));
+    }
 
     // Sigma matrix is multiplied to w.
     w = w * arma::diagmat(sigma);
@@ -112,6 +137,63 @@ class RandomizedSVDPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Get the factors of a user, such that the rating of each item by the user
+   * is the dot product of these factors with the column of the item in the
+   * matrix given by GetItemFactors().
+   *
+   * @param user User ID.
+   * @param factors Resulting factors of the user.
+   */
+  void GetUserFactors(const size_t user, arma::vec& factors) const
+  {
+    factors = h.col(user);
+  }
+
+  /**
+   * Get the factors of all items, one column per item (see GetUserFactors()).
+   *
+   * @param factors Resulting factors of the items.
+   */
+  void GetItemFactors(arma::mat& factors) const
+  {
+    factors = w.t();
+  }
+
+  /**
+   * Fold new users into the model: compute the factors of each new user from
+   * its ratings with the item matrix fixed, with one least squares solve per
+   * user (see FoldInFactors()).  The new users get the next user IDs.
+   *
+   * @param ratings Ratings of the new users, as an item-user table with one
+   *     column per new user.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& ratings, const double lambda)
+  {
+    searchCache.Clear();
+    arma::mat factors;
+    FoldInFactors(ratings, w.t(), arma::vec(), lambda, factors);
+    h = arma::join_rows(h, factors);
+  }
+
+  /**
+   * Fold new items into the model: compute the factors of each new item from
+   * its ratings with the user matrix fixed, with one least squares solve per
+   * item (see FoldInFactors()).  The new items get the next item IDs.
+   *
+   * @param ratings Ratings of the new items, as an item-user table with one
+   *     row per new item.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& ratings, const double lambda)
+  {
+    searchCache.Clear();
+    arma::mat factors;
+    FoldInFactors(ratings.t(), h, arma::vec(), lambda, factors);
+    w = arma::join_cols(w, factors.t());
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -136,19 +218,15 @@ class RandomizedSVDPolicy
     // W H.col(j)).  This can be seen as nearest neighbor search on the H
     // matrix with the Mahalanobis distance where M^{-1} = W^T W.  So, we'll
     // decompose M^{-1} = L L^T (the Cholesky decomposition), and then multiply
-    // H by L^T. Then we can perform nearest neighbor search.
-    arma::mat l = arma::chol(w.t() * w);
-    arma::mat stretchedH = l * h; // Due to the Armadillo API, l is L^T.
-
-    // Temporarily store feature vector of queried users.
-    arma::mat query(stretchedH.n_rows, users.n_elem);
-    // Select feature vectors of queried users.
-    for (size_t i = 0; i < users.n_elem; ++i)
-      query.col(i) = stretchedH.col(users(i));
-
-    NeighborSearchPolicy neighborSearch(stretchedH);
-    neighborSearch.Search(
-        query, numUsersForSimilarity, neighborhood, similarities);
+    // H by L^T. Then we can perform nearest neighbor search.  The search
+    // structure over the stretched H is built once, and reused until the
+    // factors change.
+    searchCache.template Search<NeighborSearchPolicy>(users,
+        numUsersForSimilarity, neighborhood, similarities, [this]()
+        {
+          arma::mat l = arma::chol(w.t() * w);
+          return arma::mat(l * h); // Due to the Armadillo API, l is L^T.
+        });
   }
 
   //! Get the Item Matrix.
@@ -166,12 +244,21 @@ class RandomizedSVDPolicy
   //! Modify the number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the number of users read at a time (0 reads all of them at once).
+  size_t ChunkSize() const { return chunkSize; }
+  //! Modify the number of users read at a time (0 reads all of them at once).
+  size_t& ChunkSize() { return chunkSize; }
+
   /**
    * Serialization.
    */
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
   {
+    // The neighbor search is built again from the loaded factors.
+    if (cereal::is_loading<Archive>())
+      searchCache.Clear();
+
     ar(CEREAL_NVP(w));
     ar(CEREAL_NVP(h));
   }
@@ -181,10 +268,14 @@ class RandomizedSVDPolicy
   size_t iteratedPower;
   //! Locally stored number of iterations.
   size_t maxIterations;
+  //! Number of users read at a time, or 0.
+  size_t chunkSize;
   //! Item matrix.
   arma::mat w;
   //! User matrix.
   arma::mat h;
+  //! Cached neighbor search over the user features.
+  mutable NeighborSearchCache searchCache;
 };
 
 } // namespace mlpack
@@ -16,6 +16,8 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/svdplusplus/svdplusplus.hpp>
+#include "fold_in_factors.hpp"
+#include "neighbor_search_cache.hpp"
 
 namespace mlpack {
 
@@ -76,6 +78,7 @@ class SVDPlusPlusPolicy
              const double /* minResidue */,
              const bool /* mit */)
   {
+    searchCache.Clear();
     SVDPlusPlus<> svdpp(maxIterations, alpha, lambda);
 
     // Save implicit data in the form of sparse matrix.
@@ -140,6 +143,129 @@ class SVDPlusPlusPolicy
     rating = w * userVec + p + q(user);
   }
 
+  /**
+   * Get the factors of a user, such that the rating of each item by the user
+   * is the dot product of these factors with the column of the item in the
+   * matrix given by GetItemFactors().
+   *
+   * @param user User ID.
+   * @param factors Resulting factors of the user.
+   */
+  void GetUserFactors(const size_t user, arma::vec& factors) const
+  {
+    // Iterate through each item which the user interacted with to calculate
+    // user vector.
+    arma::vec userVec(h.n_rows, arma::fill::zeros);
+    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+    size_t implicitCount = 0;
+    for (; it != it_end; ++it)
+    {
+      userVec += y.col(it.row());
+      implicitCount += 1;
+    }
+    if (implicitCount != 0)
+      userVec /= std::sqrt(implicitCount);
+    userVec += h.col(user);
+
+    factors = arma::join_cols(userVec, arma::vec({ 1.0, q(user) }));
+  }
+
+  /**
+   * Get the factors of all items, one column per item (see GetUserFactors()).
+   * The last two rows hold the item bias and a constant one, which multiply
+   * the constant one and the user bias in the factors of a user.
+   *
+   * @param factors Resulting factors of the items.
+   */
+  void GetItemFactors(arma::mat& factors) const
+  {
+    factors = arma::join_cols(w.t(), p.t(), arma::ones<arma::rowvec>(w.n_rows));
+  }
+
+  /**
+   * Fold new users into the model: compute the factors and the bias of each
+   * new user from its ratings with all the item parameters fixed, with one
+   * least squares solve per user (see FoldInFactors()).  The rated items are
+   * the implicit feedback of a new user, and the regularization applies to
+   * the whole user vector (including the implicit part).  The new users get
+   * the next user IDs.
+   *
+   * @param ratings Ratings of the new users, as an item-user table with one
+   *     column per new user.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& ratings, const double lambda)
+  {
+    searchCache.Clear();
+
+    // The last factor of each user is its bias, which multiplies a constant
+    // one.
+    const size_t rank = h.n_rows;
+    arma::mat factors;
+    FoldInFactors(ratings, arma::join_cols(w.t(),
+        arma::ones<arma::rowvec>(w.n_rows)), p, lambda, factors);
+
+    // Remove the implicit part of each user vector.
+    const arma::sp_mat newImplicitData = arma::spones(ratings);
+    arma::mat userVecs = factors.rows(0, rank - 1);
+    for (size_t j = 0; j < newImplicitData.n_cols; ++j)
+    {
+      arma::sp_mat::const_iterator it = newImplicitData.begin_col(j);
+      arma::sp_mat::const_iterator it_end = newImplicitData.end_col(j);
+      arma::vec implicitVec(rank, arma::fill::zeros);
+      size_t implicitCount = 0;
+      for (; it != it_end; ++it)
+      {
+        implicitVec += y.col(it.row());
+        implicitCount += 1;
+      }
+      if (implicitCount != 0)
+        userVecs.col(j) -= implicitVec / std::sqrt(implicitCount);
+    }
+
+    h = arma::join_rows(h, userVecs);
+    q = arma::join_cols(q, factors.row(rank).t());
+    implicitData = arma::join_rows(implicitData, newImplicitData);
+  }
+
+  /**
+   * Fold new items into the model: compute the factors and the bias of each
+   * new item from its ratings with all the user parameters fixed, with one
+   * least squares solve per item (see FoldInFactors()).  The implicit vectors
+   * of the new items are zero, and the new items are not added to the implicit
+   * feedback of the users, so the predictions for other items do not change.
+   * The new items get the next item IDs.
+   *
+   * @param ratings Ratings of the new items, as an item-user table with one
+   *     row per new item.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& ratings, const double lambda)
+  {
+    searchCache.Clear();
+    const size_t rank = h.n_rows;
+
+    // Compute the full vector of each user, with its implicit part.
+    arma::mat userVecs = y * implicitData;
+    for (size_t user = 0; user < implicitData.n_cols; ++user)
+    {
+      const size_t implicitCount = implicitData.col(user).n_nonzero;
+      if (implicitCount != 0)
+        userVecs.col(user) /= std::sqrt(implicitCount);
+    }
+    userVecs += h;
+
+    arma::mat factors;
+    FoldInFactors(ratings.t(), arma::join_cols(userVecs,
+        arma::ones<arma::rowvec>(h.n_cols)), q, lambda, factors);
+    w = arma::join_cols(w, factors.rows(0, rank - 1).t());
+    p = arma::join_cols(p, factors.row(rank).t());
+    y = arma::join_rows(y, arma::zeros<arma::mat>(rank, ratings.n_rows));
+    implicitData.resize(implicitData.n_rows + ratings.n_rows,
+        implicitData.n_cols);
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -158,16 +284,11 @@ class SVDPlusPlusPolicy
                        arma::Mat<size_t>& neighborhood,
                        arma::mat& similarities) const
   {
-    // User latent vectors (matrix H) are used for neighbor search.
-    // Temporarily store feature vector of queried users.
-    arma::mat query(h.n_rows, users.n_elem);
-    // Select feature vectors of queried users.
-    for (size_t i = 0; i < users.n_elem; ++i)
-      query.col(i) = h.col(users(i));
-
-    NeighborSearchPolicy neighborSearch(h);
-    neighborSearch.Search(
-        query, numUsersForSimilarity, neighborhood, similarities);
+    // User latent vectors (matrix H) are used for neighbor search.  The search
+    // structure is built once, and reused until the factors change.
+    searchCache.template Search<NeighborSearchPolicy>(users,
+        numUsersForSimilarity, neighborhood, similarities,
+        [this]() { return h; });
   }
 
   //! Get the Item Matrix.
@@ -204,6 +325,10 @@ class SVDPlusPlusPolicy
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
   {
+    // The neighbor search is built again from the loaded factors.
+    if (cereal::is_loading<Archive>())
+      searchCache.Clear();
+
     ar(CEREAL_NVP(maxIterations));
     ar(CEREAL_NVP(alpha));
     ar(CEREAL_NVP(lambda));
@@ -234,6 +359,8 @@ class SVDPlusPlusPolicy
   arma::mat y;
   //! Implicit Data.
   arma::sp_mat implicitData;
+  //! Cached neighbor search over the user features.
+  mutable NeighborSearchCache searchCache;
 };
 
 } // namespace mlpack
@@ -119,6 +119,50 @@ class ItemMeanNormalization
     }
   }
 
+  /**
+   * Normalize the ratings of users or items that are folded into a trained
+   * model.  The mean of each new item is computed from its given ratings; the
+   * means of the other items are not changed.
+   *
+   * @param data Ratings of new users or items, in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data)
+  {
+    const size_t oldItemNum = itemMean.n_elem;
+    const size_t itemNum = std::max((size_t) max(data.row(1)) + 1, oldItemNum);
+    itemMean.resize(itemNum);
+    itemMean.tail(itemNum - oldItemNum).zeros();
+    // Number of ratings for each new item.
+    arma::Row<size_t> ratingNum(itemNum - oldItemNum, arma::fill::zeros);
+
+    // Sum ratings for each new item.
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t item = (size_t) datapoint(1);
+      if (item >= oldItemNum)
+      {
+        itemMean(item) += datapoint(2);
+        ratingNum(item - oldItemNum) += 1;
+      }
+    });
+
+    for (size_t i = oldItemNum; i < itemNum; ++i)
+    {
+      if (ratingNum(i - oldItemNum) != 0)
+        itemMean(i) /= ratingNum(i - oldItemNum);
+    }
+
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t item = (size_t) datapoint(1);
+      datapoint(2) -= itemMean(item);
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive float value.
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<float>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding item mean.
    *
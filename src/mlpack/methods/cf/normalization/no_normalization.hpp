@@ -35,6 +35,14 @@ class NoNormalization
   template<typename MatType>
   inline void Normalize(const MatType& /* data */) const { }
 
+  /**
+   * Do nothing.
+   *
+   * @param * (data) Ratings of new users or items.
+   */
+  template<typename MatType>
+  inline void FoldIn(const MatType& /* data */) const { }
+
   /**
    * Do nothing.
    *
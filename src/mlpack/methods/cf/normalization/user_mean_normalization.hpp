@@ -119,6 +119,50 @@ class UserMeanNormalization
     }
   }
 
+  /**
+   * Normalize the ratings of users or items that are folded into a trained
+   * model.  The mean of each new user is computed from its given ratings; the
+   * means of the other users are not changed.
+   *
+   * @param data Ratings of new users or items, in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data)
+  {
+    const size_t oldUserNum = userMean.n_elem;
+    const size_t userNum = std::max((size_t) max(data.row(0)) + 1, oldUserNum);
+    userMean.resize(userNum);
+    userMean.tail(userNum - oldUserNum).zeros();
+    // Number of ratings for each new user.
+    arma::Row<size_t> ratingNum(userNum - oldUserNum, arma::fill::zeros);
+
+    // Sum ratings for each new user.
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t user = (size_t) datapoint(0);
+      if (user >= oldUserNum)
+      {
+        userMean(user) += datapoint(2);
+        ratingNum(user - oldUserNum) += 1;
+      }
+    });
+
+    for (size_t i = oldUserNum; i < userNum; ++i)
+    {
+      if (ratingNum(i - oldUserNum) != 0)
+        userMean(i) /= ratingNum(i - oldUserNum);
+    }
+
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t user = (size_t) datapoint(0);
+      datapoint(2) -= userMean(user);
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive double value.
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<double>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding user mean.
    *
@@ -104,6 +104,25 @@ class ZScoreNormalization
     }
   }
 
+  /**
+   * Normalize the ratings of new users or items that are folded into a trained
+   * model, with the mean and standard deviation of the ratings the model was
+   * trained on.
+   *
+   * @param data Ratings of new users or items, in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data) const
+  {
+    data.row(2) = (data.row(2) - mean) / stddev;
+    // The algorithm omits rating of zero. If normalized rating equals zero,
+    // it is set to the smallest positive float value.
+    data.row(2).for_each([](double& x)
+    {
+      if (x == 0)
+        x = std::numeric_limits<float>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding mean and multiplying stddev.
    *
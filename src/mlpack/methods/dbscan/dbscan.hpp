@@ -62,17 +62,28 @@ class DBSCAN
    * When batchMode is false, each point will be searched iteratively, which
    * could be slower but will use less memory.
    *
+   * If parallelMode is true, batchMode and the point selection policy are
+   * ignored: the range searches run in parallel, and only the number of
+   * neighbors of each point is stored, so memory use is linear in the number
+   * of points even for large epsilon.  Clusters are the same as in the other
+   * modes, except that a point that is in the neighborhood of core points of
+   * several clusters (a border point) may be assigned to any of them.  The
+   * RangeSearchType must provide ParallelSearch(), as RangeSearch does.
+   *
    * @param epsilon Size of range query.
    * @param minPoints Minimum number of points for each cluster.
    * @param batchMode If true, all points are searched in batch.
    * @param rangeSearch Optional instantiated RangeSearch object.
    * @param pointSelector OptionL instantiated PointSelectionPolicy object.
+   * @param parallelMode If true, core points are found and merged in
+   *     parallel.
    */
   DBSCAN(const ElemType epsilon,
          const size_t minPoints,
          const bool batchMode = true,
          RangeSearchType rangeSearch = RangeSearchType(),
-         PointSelectionPolicy pointSelector = PointSelectionPolicy());
+         PointSelectionPolicy pointSelector = PointSelectionPolicy(),
+         const bool parallelMode = false);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -122,6 +133,9 @@ class DBSCAN
   //! Whether or not to perform the search in batch mode.  If false, single
   bool batchMode;
 
+  //! Whether or not to find and merge core points in parallel.
+  bool parallelMode;
+
   //! Instantiated range search policy.
   RangeSearchType rangeSearch;
 
@@ -150,6 +164,17 @@ class DBSCAN
    * @param uf UnionFind structure that will be modified.
    */
   void BatchCluster(const MatType& data, UnionFind& uf);
+
+  /**
+   * Performs DBSCAN clustering on the data with parallel range searches.  The
+   * core points are found by counting the neighbors of each point, and then
+   * a second search merges each core point with its neighbors; the
+   * neighborhoods are never stored.
+   *
+   * @param data Dataset to cluster.
+   * @param uf UnionFind structure that will be modified.
+   */
+  void ParallelCluster(const MatType& data, UnionFind& uf);
 };
 
 } // namespace mlpack
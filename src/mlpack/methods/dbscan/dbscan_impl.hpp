@@ -25,10 +25,12 @@ DBSCAN<RangeSearchType, PointSelectionPolicy>::DBSCAN(
     const size_t minPoints,
     const bool batchMode,
     RangeSearchType rangeSearch,
-    PointSelectionPolicy pointSelector) :
+    PointSelectionPolicy pointSelector,
+    const bool parallelMode) :
     epsilon(epsilon),
     minPoints(minPoints),
     batchMode(batchMode),
+    parallelMode(parallelMode),
     rangeSearch(rangeSearch),
     pointSelector(pointSelector)
 {
@@ -100,7 +102,9 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
   UnionFind uf(data.n_cols);
   rangeSearch.Train(data);
 
-  if (batchMode)
+  if (parallelMode)
+    ParallelCluster(data, uf);
+  else if (batchMode)
     BatchCluster(data, uf);
   else
     PointwiseCluster(data, uf);
@@ -147,8 +151,8 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     const MatType& data,
     UnionFind& uf)
 {
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<ElemType>> distances;
+  // The neighbors of the current point; this is reused for every point.
+  std::vector<size_t> neighbors;
 
   // Note that the strategy here is somewhat different from the original DBSCAN
   // paper.  The original DBSCAN paper grows each cluster individually to its
@@ -176,34 +180,38 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     const size_t index = pointSelector.Select(i, data);
     visited[index] = true;
 
-    // Do the range search for only this point.
-    rangeSearch.Search(data.col(index), RangeType<ElemType>(ElemType(0.0), epsilon),
-        neighbors, distances);
+    // Do the range search for only this point.  The distances are not
+    // needed, so only the neighbors are stored.
+    neighbors.clear();
+    rangeSearch.Search(data.col(index),
+        RangeType<ElemType>(ElemType(0.0), epsilon),
+        [&neighbors](const size_t, const size_t neighbor, const ElemType)
+        { neighbors.push_back(neighbor); });
 
     // Union to all neighbors if the point is not noise.
     //
     // If the point is noise, we leave its label as undefined (i.e. we do no
     // unioning).
-    if (neighbors[0].size() >= minPoints)
+    if (neighbors.size() >= minPoints)
     {
-      for (size_t j = 0; j < neighbors[0].size(); ++j)
+      for (size_t j = 0; j < neighbors.size(); ++j)
       {
         // Union to all neighbors that either do not have a label, or are core
         // points of other clusters.  (When we union to another core point, we
         // are merging clusters.)
-        if (uf.Find(neighbors[0][j]) == neighbors[0][j])
+        if (uf.Find(neighbors[j]) == neighbors[j])
         {
           // This unions unlabeled points.
-          uf.Union(index, neighbors[0][j]);
+          uf.Union(index, neighbors[j]);
         }
-        else if (!nonCorePoints[neighbors[0][j]] && visited[neighbors[0][j]])
+        else if (!nonCorePoints[neighbors[j]] && visited[neighbors[j]])
         {
           // This unions core points of other clusters.  Note that we only union
           // with other clusters that have already been visited---this is
           // because we do not know whether unvisited points are core or
           // non-core points.  (If an unvisited point is a core point, it'll
           // merge with us later.)
-          uf.Union(index, neighbors[0][j]);
+          uf.Union(index, neighbors[j]);
         }
       }
     }
@@ -226,12 +234,14 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
     UnionFind& uf)
 {
   // For each point, find the points in epsilon-neighborhood and their distances.
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<ElemType>> distances;
+  // The results are stored in compressed sparse row form: the neighbors of
+  // point i are neighbors[offsets[i]] to neighbors[offsets[i + 1] - 1].
+  arma::Col<size_t> offsets, neighbors;
+  arma::Col<ElemType> distances;
   Log::Info << "Performing range search." << std::endl;
   rangeSearch.Train(data);
-  rangeSearch.Search(RangeType<ElemType>(ElemType(0.0), epsilon), neighbors,
-      distances);
+  rangeSearch.Search(RangeType<ElemType>(ElemType(0.0), epsilon), offsets,
+      neighbors, distances);
   Log::Info << "Range search complete." << std::endl;
 
   // See the description of the algorithm in `PointwiseCluster()`.  The strategy
@@ -247,25 +257,75 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
     const size_t index = pointSelector.Select(i, data);
     // Monochromatic dual-tree range search does not return the point as its own
     // neighbor, so we are looking for `minPoints - 1` instead.
-    if (neighbors[index].size() >= minPoints - 1)
+    if (offsets[index + 1] - offsets[index] >= minPoints - 1)
     {
-      for (size_t j = 0; j < neighbors[index].size(); ++j)
+      for (size_t j = offsets[index]; j < offsets[index + 1]; ++j)
       {
-        if (uf.Find(neighbors[index][j]) == neighbors[index][j])
+        const size_t neighbor = neighbors[j];
+        if (uf.Find(neighbor) == neighbor)
         {
           // This unions unlabeled points.
-          uf.Union(index, neighbors[index][j]);
+          uf.Union(index, neighbor);
         }
-        else if (neighbors[neighbors[index][j]].size() >= (minPoints - 1))
+        else if (offsets[neighbor + 1] - offsets[neighbor] >= (minPoints - 1))
         {
           // This unions core points of other clusters.
-          uf.Union(index, neighbors[index][j]);
+          uf.Union(index, neighbor);
         }
       }
     }
   }
 }
 
+/**
+ * Performs DBSCAN clustering on the data with parallel range searches, storing
+ * only the number of neighbors of each point.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::ParallelCluster(
+    const MatType& data,
+    UnionFind& uf)
+{
+  const RangeType<ElemType> range(ElemType(0.0), epsilon);
+
+  // Count the neighbors of each point to find the core points.  All the
+  // neighbors of a point are passed from the same thread, so the counts need no
+  // synchronization.  Monochromatic range search does not return the point as
+  // its own neighbor, so we are looking for `minPoints - 1` neighbors.
+  Log::Info << "Counting neighbors." << std::endl;
+  arma::Col<size_t> counts(data.n_cols, arma::fill::zeros);
+  rangeSearch.ParallelSearch(range,
+      [&counts](const size_t queryIndex, const size_t, const ElemType)
+      { ++counts[queryIndex]; });
+
+  // Search again, and merge each core point with its neighbors.  Core points
+  // find each other, so each pair of core points is merged once, from the
+  // point with the larger index.  A non-core point is merged with the first
+  // core point that claims it, so that it can't join two clusters.  See
+  // `PointwiseCluster()` for the logic.
+  Log::Info << "Merging core points." << std::endl;
+  std::vector<std::atomic<bool>> claimed(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    claimed[i].store(false, std::memory_order_relaxed);
+
+  rangeSearch.ParallelSearch(range,
+      [&](const size_t queryIndex, const size_t neighbor, const ElemType)
+      {
+        if (counts[queryIndex] < minPoints - 1)
+          return;
+
+        if (counts[neighbor] >= minPoints - 1)
+        {
+          if (neighbor < queryIndex)
+            uf.ConcurrentUnion(queryIndex, neighbor);
+        }
+        else if (!claimed[neighbor].exchange(true))
+        {
+          uf.ConcurrentUnion(queryIndex, neighbor);
+        }
+      });
+}
+
 } // namespace mlpack
 
 #endif
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_DECISION_TREE_ALL_CATEGORICAL_SPLIT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "split_traits.hpp"
 
 namespace mlpack {
 
@@ -130,6 +131,15 @@ class AllCategoricalSplit
       const AuxiliarySplitInfo& /* aux */);
 };
 
+//! AllCategoricalSplit does not use random numbers.
+template<typename FitnessFunction>
+class SplitTraits<AllCategoricalSplit<FitnessFunction>>
+{
+ public:
+  static const bool IsDeterministic = true;
+  static const bool UsesPresortedData = false;
+};
+
 } // namespace mlpack
 
 // Include implementation.
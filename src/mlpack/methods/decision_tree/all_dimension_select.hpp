@@ -12,6 +12,8 @@
 #ifndef MLPACK_METHODS_DECISION_TREE_ALL_DIMENSION_SELECT_HPP
 #define MLPACK_METHODS_DECISION_TREE_ALL_DIMENSION_SELECT_HPP
 
+#include "split_traits.hpp"
+
 namespace mlpack {
 
 /**
@@ -57,6 +59,14 @@ class AllDimensionSelect
   size_t dimensions;
 };
 
+//! AllDimensionSelect always selects all the dimensions.
+template<>
+class DimensionSelectionTraits<AllDimensionSelect>
+{
+ public:
+  static const bool IsDeterministic = true;
+};
+
 } // namespace mlpack
 
 #endif
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "mse_gain.hpp"
+#include "split_traits.hpp"
 
 #include <mlpack/core/util/sfinae_utility.hpp>
 
@@ -84,6 +85,35 @@ class BestBinaryNumericSplit
       arma::vec& splitInfo,
       AuxiliarySplitInfo& aux);
 
+  /**
+   * Check if we can split a node, when the points of the node are already
+   * sorted in ascending order along the dimension.  This is the same as the
+   * classification overload of SplitIfBetter(), without sorting; labels and
+   * weights must be in the same order as data.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param sortedData The dimension of data points to check for a split in,
+   *      sorted in ascending order.
+   * @param sortedLabels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param sortedWeights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetterSorted(
+      const double bestGain,
+      const VecType& sortedData,
+      const arma::Row<size_t>& sortedLabels,
+      const size_t numClasses,
+      const WeightVecType& sortedWeights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::vec& splitInfo);
+
   /**
    * Check if we can split a node.  If we can split a node in a way that
    * improves on 'bestGain', then we return the improved gain.  Otherwise we
@@ -182,6 +212,15 @@ class BestBinaryNumericSplit
       const AuxiliarySplitInfo& /* aux */);
 };
 
+//! BestBinaryNumericSplit does not use random numbers.
+template<typename FitnessFunction>
+class SplitTraits<BestBinaryNumericSplit<FitnessFunction>>
+{
+ public:
+  static const bool IsDeterministic = true;
+  static const bool UsesPresortedData = false;
+};
+
 } // namespace mlpack
 
 // Include implementation.
@@ -35,16 +35,16 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     return DBL_MAX; // It can't be outperformed.
 
   // Next, sort the data.
+  typedef typename VecType::elem_type ElemType;
   arma::uvec sortedIndices = arma::sort_index(data);
+  arma::Row<ElemType> sortedData(data.n_elem);
   arma::Row<size_t> sortedLabels(labels.n_elem);
   arma::rowvec sortedWeights;
   for (size_t i = 0; i < sortedLabels.n_elem; ++i)
+  {
+    sortedData[i] = data[sortedIndices[i]];
     sortedLabels[i] = labels[sortedIndices[i]];
-
-  // Sanity check: if the first element is the same as the last, we can't split
-  // in this dimension.
-  if (data[sortedIndices[0]] == data[sortedIndices[sortedIndices.n_elem - 1]])
-    return DBL_MAX;
+  }
 
   // Only initialize if we are using weights.
   if (UseWeights)
@@ -55,6 +55,34 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       sortedWeights[i] = weights[sortedIndices[i]];
   }
 
+  return SplitIfBetterSorted<UseWeights>(bestGain, sortedData, sortedLabels,
+      numClasses, sortedWeights, minimumLeafSize, minimumGainSplit, splitInfo);
+}
+
+// Overload used for classification on sorted data.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetterSorted(
+    const double bestGain,
+    const VecType& sortedData,
+    const arma::Row<size_t>& sortedLabels,
+    const size_t numClasses,
+    const WeightVecType& sortedWeights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo)
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  if (sortedData.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Sanity check: if the first element is the same as the last, we can't split
+  // in this dimension.
+  if (sortedData[0] == sortedData[sortedData.n_elem - 1])
+    return DBL_MAX;
+
   // Loop through all possible split points, choosing the best one.  Also, force
   // a minimum leaf size of 1 (empty children don't make sense).
   double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
@@ -82,7 +110,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     }
 
     // These points have to be on the right.
-    for (size_t i = minimum - 1; i < data.n_elem; ++i)
+    for (size_t i = minimum - 1; i < sortedData.n_elem; ++i)
     {
       classWeightSums(sortedLabels[i], 1) += sortedWeights[i];
       totalRightWeight += sortedWeights[i];
@@ -91,7 +119,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   else
   {
     classCounts.zeros(numClasses, 2);
-    bestFoundGain *= data.n_elem;
+    bestFoundGain *= sortedData.n_elem;
 
     // Initialize the counts.
     // These points have to be on the left.
@@ -99,11 +127,11 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       ++classCounts(sortedLabels[i], 0);
 
     // These points have to be on the right.
-    for (size_t i = minimum - 1; i < data.n_elem; ++i)
+    for (size_t i = minimum - 1; i < sortedData.n_elem; ++i)
       ++classCounts(sortedLabels[i], 1);
   }
 
-  for (size_t index = minimum; index < data.n_elem - minimum; ++index)
+  for (size_t index = minimum; index < sortedData.n_elem - minimum; ++index)
   {
     // Update class weight sums or counts.
     if (UseWeights)
@@ -120,7 +148,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     }
 
     // Make sure that the value has changed.
-    if (data[sortedIndices[index]] == data[sortedIndices[index - 1]])
+    if (sortedData[index] == sortedData[index - 1])
       continue;
 
     // Calculate the gain for the left and right child.  Only use weights if
@@ -155,17 +183,15 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       // take this one. The actual split value will be halfway between the
       // value at index - 1 and index.
       splitInfo.set_size(1);
-      splitInfo[0] = (data[sortedIndices[index - 1]] +
-          data[sortedIndices[index]]) / 2.0;
+      splitInfo[0] = (sortedData[index - 1] + sortedData[index]) / 2.0;
 
       // In some very extreme cases, floating-point inaccuracies can lead to the
       // split result being the upper bound, which is problematic for later as
       // all the child points will be sent to the left child.  If this happens,
       // bump it down incrementally.
-      if (splitInfo[0] == data[sortedIndices[index]])
+      if (splitInfo[0] == sortedData[index])
       {
-        splitInfo[0] = std::nexttoward(splitInfo[0],
-            data[sortedIndices[index - 1]]);
+        splitInfo[0] = std::nexttoward(splitInfo[0], sortedData[index - 1]);
       }
 
       return gain;
@@ -175,18 +201,16 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       // We still have a better split.
       bestFoundGain = gain;
       splitInfo.set_size(1);
-      splitInfo[0] = (data[sortedIndices[index - 1]] +
-          data[sortedIndices[index]]) / 2.0;
+      splitInfo[0] = (sortedData[index - 1] + sortedData[index]) / 2.0;
       improved = true;
 
       // In some very extreme cases, floating-point inaccuracies can lead to the
       // split result being the upper bound, which is problematic for later as
       // all the child points will be sent to the left child.  If this happens,
       // bump it down incrementally.
-      if (splitInfo[0] == data[sortedIndices[index]])
+      if (splitInfo[0] == sortedData[index])
       {
-        splitInfo[0] = std::nexttoward(splitInfo[0],
-            data[sortedIndices[index - 1]]);
+        splitInfo[0] = std::nexttoward(splitInfo[0], sortedData[index - 1]);
       }
     }
   }
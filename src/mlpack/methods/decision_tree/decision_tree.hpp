@@ -22,6 +22,8 @@
 
 #include "best_binary_numeric_split.hpp"
 #include "random_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
+#include "presorted_binary_numeric_split.hpp"
 
 #include "all_categorical_split.hpp"
 
@@ -29,6 +31,8 @@
 #include "random_dimension_select.hpp"
 #include "multiple_random_dimension_select.hpp"
 
+#include "flat_decision_tree.hpp"
+
 namespace mlpack {
 
 /**
@@ -37,6 +41,13 @@ namespace mlpack {
  *
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
+ *
+ * When OpenMP is available, nodes with at least ParallelTrainCutoff points are
+ * trained in parallel: the candidate split dimensions of the node are
+ * evaluated at the same time, and its children are trained in separate tasks.
+ * This is only done when the split types and the dimension selection type are
+ * deterministic (see SplitTraits and DimensionSelectionTraits), so the trained
+ * tree is the same as with serial training.
  */
 template<typename FitnessFunction = GiniGain,
          template<typename> class NumericSplitType = BestBinaryNumericSplit,
@@ -55,6 +66,15 @@ class DecisionTree :
   //! Allow access to the dimension selection type.
   typedef DimensionSelectionType DimensionSelection;
 
+  //! Nodes with at least this many points are trained in parallel, if
+  //! ParallelTrain is true.
+  static constexpr size_t ParallelTrainCutoff = 4096;
+  //! Whether training can be parallelized without changing the trained tree.
+  static constexpr bool ParallelTrain =
+      SplitTraits<NumericSplit>::IsDeterministic &&
+      SplitTraits<CategoricalSplit>::IsDeterministic &&
+      DimensionSelectionTraits<DimensionSelectionType>::IsDeterministic;
+
   /**
    * Construct the decision tree on the given data and labels, where the data
    * can be both numeric and categorical. Setting minimumLeafSize and
@@ -471,6 +491,17 @@ class DecisionTree :
   //! trained tree).
   size_t SplitDimension() const { return splitDimension; }
 
+  //! Get the type of the split dimension (only meaningful if this is a
+  //! non-leaf in a trained tree).
+  data::Datatype SplitDimensionType() const
+  {
+    return (data::Datatype) dimensionType;
+  }
+
+  //! Get the majority class (only meaningful if this is a leaf in a trained
+  //! tree).
+  size_t MajorityClass() const { return majorityClass; }
+
   //! Get the class probabilities, if this is a leaf node in the trained tree.
   //! Note that if this is not a leaf, then this may contain arbitrary
   //! information used by the split in the tree!
@@ -545,6 +576,9 @@ class DecisionTree :
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
+   * @param sortedIndices If the numeric split uses presorted data, the sorted
+   *      order of the points of each numeric dimension (one column per
+   *      dimension).  If NULL, it is computed for the points of this node.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType, typename WeightsType>
@@ -558,7 +592,8 @@ class DecisionTree :
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
-               DimensionSelectionType& dimensionSelector);
+               DimensionSelectionType& dimensionSelector,
+               arma::Mat<size_t>* sortedIndices = NULL);
 
   /**
    * Corresponding to the public Train() method, this method is designed for
@@ -574,6 +609,9 @@ class DecisionTree :
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
+   * @param sortedIndices If the numeric split uses presorted data, the sorted
+   *      order of the points of each numeric dimension (one column per
+   *      dimension).  If NULL, it is computed for the points of this node.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType, typename WeightsType>
@@ -586,7 +624,117 @@ class DecisionTree :
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
-               DimensionSelectionType& dimensionSelector);
+               DimensionSelectionType& dimensionSelector,
+               arma::Mat<size_t>* sortedIndices = NULL);
+
+  /**
+   * Return true if a node with the given number of points should create the
+   * threads to train it in parallel: ParallelTrain is true, the node is large
+   * enough, and we are not already in a parallel region.
+   */
+  static bool TrainInParallel(const size_t count);
+
+  /**
+   * Call the SplitIfBetter() function of the numeric or categorical split type
+   * for the given dimension of the points of the node.  If datasetInfo is
+   * NULL, all the dimensions are numeric.  If sortedIndices is not NULL, the
+   * points are given to the numeric split in sorted order.
+   */
+  template<bool UseWeights, typename MatType, typename WeightsType>
+  double SplitIfBetter(const size_t dimension,
+                       const double bestGain,
+                       MatType& data,
+                       const size_t begin,
+                       const size_t count,
+                       const data::DatasetInfo* datasetInfo,
+                       arma::Row<size_t>& labels,
+                       const size_t numClasses,
+                       WeightsType& weights,
+                       const size_t minimumLeafSize,
+                       const double minimumGainSplit,
+                       const arma::Mat<size_t>* sortedIndices,
+                       arma::vec& splitInfo,
+                       NumericAuxiliarySplitInfo& numericAux,
+                       CategoricalAuxiliarySplitInfo& categoricalAux);
+
+  /**
+   * Find the best split of the points of the node among the dimensions given
+   * by the dimension selector.  If a split better than bestGain is found,
+   * bestGain and bestDim are set to its gain and dimension, and the split
+   * information is stored in this node.  If datasetInfo is NULL, all the
+   * dimensions are numeric.
+   */
+  template<bool UseWeights, typename MatType, typename WeightsType>
+  void FindBestSplit(MatType& data,
+                     const size_t begin,
+                     const size_t count,
+                     const data::DatasetInfo* datasetInfo,
+                     arma::Row<size_t>& labels,
+                     const size_t numClasses,
+                     WeightsType& weights,
+                     const size_t minimumLeafSize,
+                     const double minimumGainSplit,
+                     DimensionSelectionType& dimensionSelector,
+                     const arma::Mat<size_t>* sortedIndices,
+                     double& bestGain,
+                     size_t& bestDim);
+
+  /**
+   * Train each child of the node on its range of points (childBegins[i] to
+   * childBegins[i] + childCounts[i] - 1), and store the gain returned by each
+   * child in childGains.  Large children are trained in separate tasks.  If
+   * datasetInfo is NULL, all the dimensions are numeric.
+   */
+  template<bool UseWeights, typename MatType, typename WeightsType>
+  void TrainChildren(MatType& data,
+                     const arma::Row<size_t>& childBegins,
+                     const arma::Row<size_t>& childCounts,
+                     const data::DatasetInfo* datasetInfo,
+                     arma::Row<size_t>& labels,
+                     const size_t numClasses,
+                     WeightsType& weights,
+                     const size_t minimumLeafSize,
+                     const double minimumGainSplit,
+                     const size_t maximumDepth,
+                     DimensionSelectionType& dimensionSelector,
+                     arma::Mat<size_t>* sortedIndices,
+                     arma::vec& childGains);
+
+  /**
+   * Compute the sorted order of the points of the node (begin to begin + count
+   * - 1) in each numeric dimension, for a numeric split that uses presorted
+   * data.  Column i of sortedIndices will hold the indices of the points sorted
+   * by dimension i, in rows begin to begin + count - 1.  If datasetInfo is
+   * NULL, all the dimensions are numeric.
+   */
+  template<typename MatType>
+  static void SortDimensions(const MatType& data,
+                             const size_t begin,
+                             const size_t count,
+                             const data::DatasetInfo* datasetInfo,
+                             arma::Mat<size_t>& sortedIndices);
+
+  /**
+   * After the points of the node have been moved to the ranges of its
+   * children, update the sorted orders of the node so that the points of each
+   * child are in their child's range of rows, still in sorted order, and refer
+   * to the new positions of the points.  oldFromNew holds the old position of
+   * each point of the node, and childAssignments the child of each point, in
+   * their new order.  If datasetInfo is NULL, all the dimensions are numeric.
+   */
+  static void PartitionSortedIndices(const size_t begin,
+                                     const size_t count,
+                                     const data::DatasetInfo* datasetInfo,
+                                     const arma::Row<size_t>& oldFromNew,
+                                     const arma::Row<size_t>& childAssignments,
+                                     const arma::Row<size_t>& childBegins,
+                                     arma::Mat<size_t>& sortedIndices);
+
+ private:
+  #ifdef MLPACK_TRACK_MEMORY
+  //! Counts this node in MemoryTracker for as long as it exists.
+  MemoryTracker::NodeCounter nodeCounter { sizeof(DecisionTree) };
+  #endif
 };
 
 /**
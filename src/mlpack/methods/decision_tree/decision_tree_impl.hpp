@@ -630,13 +630,24 @@ double DecisionTree<FitnessFunction,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType& dimensionSelector)
+    DimensionSelectionType& dimensionSelector,
+    arma::Mat<size_t>* sortedIndices)
 {
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
   children.clear();
 
+  // If the numeric split needs the points in sorted order, sort each dimension
+  // once here; the sorted orders are then kept up to date as the nodes are
+  // split.
+  arma::Mat<size_t> nodeSortedIndices;
+  if (SplitTraits<NumericSplit>::UsesPresortedData && !sortedIndices)
+  {
+    SortDimensions(data, begin, count, &datasetInfo, nodeSortedIndices);
+    sortedIndices = &nodeSortedIndices;
+  }
+
   // Look through the list of dimensions and obtain the gain of the best split.
   // We'll cache the best numeric and categorical split auxiliary information in
   // numericAux and categoricalAux (and clear them later if we make no split),
@@ -647,53 +658,12 @@ double DecisionTree<FitnessFunction,
       numClasses,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
-  const size_t end = dimensionSelector.End();
 
   if (maximumDepth != 1)
   {
-    for (size_t i = dimensionSelector.Begin(); i != end;
-         i = dimensionSelector.Next())
-    {
-      double dimGain = -DBL_MAX;
-      if (datasetInfo.Type(i) == data::Datatype::categorical)
-      {
-        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            datasetInfo.NumMappings(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
-      }
-      else if (datasetInfo.Type(i) == data::Datatype::numeric)
-      {
-        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
-      }
-
-      // If the splitter reported that it did not split, move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
-
-      // Was there an improvement?  If so mark that it's the new best dimension.
-      bestDim = i;
-      bestGain = dimGain;
-
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
-    }
+    FindBestSplit<UseWeights>(data, begin, count, &datasetInfo, labels,
+        numClasses, weights, minimumLeafSize, minimumGainSplit,
+        dimensionSelector, sortedIndices, bestGain, bestDim);
   }
 
   // Did we split or not?  If so, then split the data and create the children.
@@ -731,18 +701,18 @@ double DecisionTree<FitnessFunction,
     for (size_t i = begin; i < begin + count; ++i)
       childCounts[childAssignments[i - begin]]++;
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
+    // Split into children: the points of each child are moved to a contiguous
+    // range of the dataset.
+    arma::Row<size_t> childBegins(numChildren);
+    arma::Row<size_t> oldFromNew;
+    if (sortedIndices)
+      oldFromNew = arma::regspace<arma::Row<size_t>>(begin, begin + count - 1);
 
-    // Split into children.
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = childBegins[i]; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -751,29 +721,47 @@ double DecisionTree<FitnessFunction,
           labels.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
+          if (sortedIndices)
+            oldFromNew.swap_cols(currentCol - begin, j - begin);
           ++currentCol;
         }
       }
+    }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit,
-            maximumDepth - 1, dimensionSelector);
-      }
-      else
+    if (sortedIndices)
+    {
+      PartitionSortedIndices(begin, count, &datasetInfo, oldFromNew,
+          childAssignments, childBegins, *sortedIndices);
+    }
+
+    // Now build the children recursively.  Only the outermost node that is
+    // trained in parallel needs to create the threads that the tasks for its
+    // descendants run on.
+    arma::vec childGains;
+    if (TrainInParallel(count))
+    {
+      #pragma omp parallel num_threads((int) NumThreads())
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        #pragma omp single
+        TrainChildren<UseWeights>(data, childBegins, childCounts, &datasetInfo,
+            labels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+            maximumDepth, dimensionSelector, sortedIndices, childGains);
       }
-      children.push_back(child);
+    }
+    else
+    {
+      TrainChildren<UseWeights>(data, childBegins, childCounts, &datasetInfo,
+          labels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+          maximumDepth, dimensionSelector, sortedIndices, childGains);
+    }
+
+    // Compute bestGain if recursive split is allowed.
+    if (!NoRecursion)
+    {
+      // During recursion entropy of child node may change.
+      bestGain = 0.0;
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -813,13 +801,24 @@ double DecisionTree<FitnessFunction,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType& dimensionSelector)
+    DimensionSelectionType& dimensionSelector,
+    arma::Mat<size_t>* sortedIndices)
 {
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
   children.clear();
 
+  // If the numeric split needs the points in sorted order, sort each dimension
+  // once here; the sorted orders are then kept up to date as the nodes are
+  // split.
+  arma::Mat<size_t> nodeSortedIndices;
+  if (SplitTraits<NumericSplit>::UsesPresortedData && !sortedIndices)
+  {
+    SortDimensions(data, begin, count, NULL, nodeSortedIndices);
+    sortedIndices = &nodeSortedIndices;
+  }
+
   // We won't be using these members, so reset them.
   CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
 
@@ -836,34 +835,9 @@ double DecisionTree<FitnessFunction,
 
   if (maximumDepth != 1)
   {
-    for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
-         i = dimensionSelector.Next())
-    {
-      const double dimGain = NumericSplitType<FitnessFunction>::template
-          SplitIfBetter<UseWeights>(bestGain,
-                                    data.cols(begin, begin + count - 1).row(i),
-                                    labels.cols(begin, begin + count - 1),
-                                    numClasses,
-                                    UseWeights ?
-                                        weights.cols(begin, begin + count - 1) :
-                                        weights,
-                                    minimumLeafSize,
-                                    minimumGainSplit,
-                                    classProbabilities,
-                                    *this);
-
-      // If the splitter did not report that it improved, then move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
-
-      bestDim = i;
-      bestGain = dimGain;
-
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
-    }
+    FindBestSplit<UseWeights>(data, begin, count, NULL, labels, numClasses,
+        weights, minimumLeafSize, minimumGainSplit, dimensionSelector,
+        sortedIndices, bestGain, bestDim);
   }
 
   // Did we split or not?  If so, then split the data and create the children.
@@ -890,17 +864,17 @@ double DecisionTree<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
       childCounts[childAssignments[j - begin]]++;
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
+    // Move the points of each child to a contiguous range of the dataset.
+    arma::Row<size_t> childBegins(numChildren);
+    arma::Row<size_t> oldFromNew;
+    if (sortedIndices)
+      oldFromNew = arma::regspace<arma::Row<size_t>>(begin, begin + count - 1);
 
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = childBegins[i]; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -909,29 +883,47 @@ double DecisionTree<FitnessFunction,
           labels.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
+          if (sortedIndices)
+            oldFromNew.swap_cols(currentCol - begin, j - begin);
           ++currentCol;
         }
       }
+    }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-      }
-      else
+    if (sortedIndices)
+    {
+      PartitionSortedIndices(begin, count, NULL, oldFromNew, childAssignments,
+          childBegins, *sortedIndices);
+    }
+
+    // Now build the children recursively.  Only the outermost node that is
+    // trained in parallel needs to create the threads that the tasks for its
+    // descendants run on.
+    arma::vec childGains;
+    if (TrainInParallel(count))
+    {
+      #pragma omp parallel num_threads((int) NumThreads())
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        #pragma omp single
+        TrainChildren<UseWeights>(data, childBegins, childCounts, NULL, labels,
+            numClasses, weights, minimumLeafSize, minimumGainSplit,
+            maximumDepth, dimensionSelector, sortedIndices, childGains);
       }
-      children.push_back(child);
+    }
+    else
+    {
+      TrainChildren<UseWeights>(data, childBegins, childCounts, NULL, labels,
+          numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+          dimensionSelector, sortedIndices, childGains);
+    }
+
+    // Compute bestGain if recursive split is allowed.
+    if (!NoRecursion)
+    {
+      // During recursion entropy of child node may change.
+      bestGain = 0.0;
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -949,6 +941,365 @@ double DecisionTree<FitnessFunction,
   return -bestGain;
 }
 
+//! Decide whether to create the threads to train a node in parallel.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+bool DecisionTree<FitnessFunction,
+             NumericSplitType,
+             CategoricalSplitType,
+             DimensionSelectionType,
+             NoRecursion>::TrainInParallel(
+    const size_t count)
+{
+  #ifdef MLPACK_USE_OPENMP
+  // NumThreads() is 1 inside parallel loops (e.g. while a RandomForest trains
+  // its trees), so that nested training is serial.
+  return ParallelTrain && count >= ParallelTrainCutoff && NumThreads() > 1;
+  #else
+  (void) count;
+  return false;
+  #endif
+}
+
+//! Check for a better split in the given dimension.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType, typename WeightsType>
+double DecisionTree<FitnessFunction,
+             NumericSplitType,
+             CategoricalSplitType,
+             DimensionSelectionType,
+             NoRecursion>::SplitIfBetter(
+    const size_t dimension,
+    const double bestGain,
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    WeightsType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const arma::Mat<size_t>* sortedIndices,
+    arma::vec& splitInfo,
+    NumericAuxiliarySplitInfo& numericAux,
+    CategoricalAuxiliarySplitInfo& categoricalAux)
+{
+  if (datasetInfo &&
+      datasetInfo->Type(dimension) == data::Datatype::categorical)
+  {
+    return CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
+        data.cols(begin, begin + count - 1).row(dimension),
+        datasetInfo->NumMappings(dimension),
+        labels.subvec(begin, begin + count - 1),
+        numClasses,
+        UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+        minimumLeafSize,
+        minimumGainSplit,
+        splitInfo,
+        categoricalAux);
+  }
+  else if (sortedIndices)
+  {
+    // Gather the points of the node in sorted order.
+    typedef typename MatType::elem_type ElemType;
+    const size_t* order = sortedIndices->colptr(dimension) + begin;
+    arma::Row<ElemType> sortedData(count);
+    arma::Row<size_t> sortedLabels(count);
+    arma::rowvec sortedWeights(UseWeights ? count : 0);
+    for (size_t i = 0; i < count; ++i)
+    {
+      sortedData[i] = data(dimension, order[i]);
+      sortedLabels[i] = labels[order[i]];
+      if (UseWeights)
+        sortedWeights[i] = weights[order[i]];
+    }
+
+    return NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+        sortedData, sortedLabels, numClasses, sortedWeights, minimumLeafSize,
+        minimumGainSplit, splitInfo, numericAux);
+  }
+  else
+  {
+    return NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+        data.cols(begin, begin + count - 1).row(dimension),
+        labels.subvec(begin, begin + count - 1),
+        numClasses,
+        UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+        minimumLeafSize,
+        minimumGainSplit,
+        splitInfo,
+        numericAux);
+  }
+}
+
+//! Find the best split of the node.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType, typename WeightsType>
+void DecisionTree<FitnessFunction,
+             NumericSplitType,
+             CategoricalSplitType,
+             DimensionSelectionType,
+             NoRecursion>::FindBestSplit(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    WeightsType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    DimensionSelectionType& dimensionSelector,
+    const arma::Mat<size_t>* sortedIndices,
+    double& bestGain,
+    size_t& bestDim)
+{
+  // We'll cache the best split auxiliary information in this node, and use
+  // classProbabilities as auxiliary information.
+  const size_t end = dimensionSelector.End();
+  if (!TrainInParallel(count))
+  {
+    for (size_t i = dimensionSelector.Begin(); i != end;
+         i = dimensionSelector.Next())
+    {
+      const double dimGain = SplitIfBetter<UseWeights>(i, bestGain, data,
+          begin, count, datasetInfo, labels, numClasses, weights,
+          minimumLeafSize, minimumGainSplit, sortedIndices, classProbabilities,
+          *this, *this);
+
+      // If the splitter reported that it did not split, move to the next
+      // dimension.
+      if (dimGain == DBL_MAX)
+        continue;
+
+      // Was there an improvement?  If so mark that it's the new best dimension.
+      bestDim = i;
+      bestGain = dimGain;
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+
+    return;
+  }
+
+  // For a large node, first find the best split of every dimension in
+  // parallel, against the gain of the node itself.
+  std::vector<size_t> dimensions;
+  for (size_t i = dimensionSelector.Begin(); i != end;
+       i = dimensionSelector.Next())
+    dimensions.push_back(i);
+
+  const size_t numDimensions = dimensions.size();
+  arma::vec gains(numDimensions);
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t d = 0; d < numDimensions; ++d)
+  {
+    arma::vec splitInfo;
+    NumericAuxiliarySplitInfo numericAux;
+    CategoricalAuxiliarySplitInfo categoricalAux;
+    gains[d] = SplitIfBetter<UseWeights>(dimensions[d], bestGain, data, begin,
+        count, datasetInfo, labels, numClasses, weights, minimumLeafSize,
+        minimumGainSplit, sortedIndices, splitInfo, numericAux,
+        categoricalAux);
+  }
+
+  // Now go through the dimensions in order, like the serial search.  Since the
+  // splits are deterministic, a dimension that could not beat the node cannot
+  // beat the best split found so far, and neither can a dimension whose gain is
+  // below that of the best split so far (up to floating-point error).  Any
+  // other dimension is evaluated again against the best split so far, so that
+  // the chosen split is exactly the one the serial search would choose.
+  for (size_t d = 0; d < numDimensions; ++d)
+  {
+    const double threshold = std::min(bestGain, bestGain + minimumGainSplit);
+    if (gains[d] == DBL_MAX ||
+        gains[d] < threshold - 1e-10 * std::abs(threshold))
+      continue;
+
+    const double dimGain = SplitIfBetter<UseWeights>(dimensions[d], bestGain,
+        data, begin, count, datasetInfo, labels, numClasses, weights,
+        minimumLeafSize, minimumGainSplit, sortedIndices, classProbabilities,
+        *this, *this);
+    if (dimGain == DBL_MAX)
+      continue;
+
+    bestDim = dimensions[d];
+    bestGain = dimGain;
+
+    // If the gain is the best possible, no need to keep looking.
+    if (bestGain >= 0.0)
+      break;
+  }
+}
+
+//! Train the children of the node.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType, typename WeightsType>
+void DecisionTree<FitnessFunction,
+             NumericSplitType,
+             CategoricalSplitType,
+             DimensionSelectionType,
+             NoRecursion>::TrainChildren(
+    MatType& data,
+    const arma::Row<size_t>& childBegins,
+    const arma::Row<size_t>& childCounts,
+    const data::DatasetInfo* datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    WeightsType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector,
+    arma::Mat<size_t>* sortedIndices,
+    arma::vec& childGains)
+{
+  const size_t numChildren = childBegins.n_elem;
+  for (size_t i = 0; i < numChildren; ++i)
+    children.push_back(new DecisionTree());
+  childGains.set_size(numChildren);
+
+  auto trainChild = [&](const size_t i, DimensionSelectionType& selector)
+  {
+    // A child of a decision stump is always a leaf.
+    const size_t leafSize = NoRecursion ? childCounts[i] : minimumLeafSize;
+    if (datasetInfo)
+    {
+      childGains[i] = children[i]->Train<UseWeights>(data,
+          childBegins[i], childCounts[i], *datasetInfo, labels, numClasses,
+          weights, leafSize, minimumGainSplit, maximumDepth - 1, selector,
+          sortedIndices);
+    }
+    else
+    {
+      childGains[i] = children[i]->Train<UseWeights>(data,
+          childBegins[i], childCounts[i], labels, numClasses, weights,
+          leafSize, minimumGainSplit, maximumDepth - 1, selector,
+          sortedIndices);
+    }
+  };
+
+  // The children hold disjoint ranges of the dataset, so they can be trained
+  // at the same time; small children are not worth the overhead of a task.  A
+  // child trained in a task gets its own copy of the dimension selector, made
+  // before the task starts.
+  for (size_t i = 0; i < numChildren; ++i)
+  {
+    if (ParallelTrain && childCounts[i] >= ParallelTrainCutoff)
+    {
+      DimensionSelectionType selector(dimensionSelector);
+      #pragma omp task default(shared) firstprivate(i, selector)
+      trainChild(i, selector);
+    }
+    else
+    {
+      trainChild(i, dimensionSelector);
+    }
+  }
+
+  #pragma omp taskwait
+}
+
+//! Sort each numeric dimension of the points of the node.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<typename MatType>
+void DecisionTree<FitnessFunction,
+             NumericSplitType,
+             CategoricalSplitType,
+             DimensionSelectionType,
+             NoRecursion>::SortDimensions(
+    const MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    arma::Mat<size_t>& sortedIndices)
+{
+  sortedIndices.set_size(data.n_cols, data.n_rows);
+  if (count == 0)
+    return;
+
+  #pragma omp parallel for if(TrainInParallel(count)) \
+      num_threads((int) NumThreads())
+  for (size_t d = 0; d < (size_t) data.n_rows; ++d)
+  {
+    if (datasetInfo && datasetInfo->Type(d) == data::Datatype::categorical)
+      continue;
+
+    // A stable sort keeps tied points in the order of the dataset.
+    const arma::uvec order = arma::stable_sort_index(
+        data.row(d).cols(begin, begin + count - 1));
+    for (size_t i = 0; i < count; ++i)
+      sortedIndices(begin + i, d) = begin + order[i];
+  }
+}
+
+//! Update the sorted orders after the node has been split.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+void DecisionTree<FitnessFunction,
+             NumericSplitType,
+             CategoricalSplitType,
+             DimensionSelectionType,
+             NoRecursion>::PartitionSortedIndices(
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    const arma::Row<size_t>& oldFromNew,
+    const arma::Row<size_t>& childAssignments,
+    const arma::Row<size_t>& childBegins,
+    arma::Mat<size_t>& sortedIndices)
+{
+  arma::Row<size_t> newFromOld(count);
+  for (size_t i = 0; i < count; ++i)
+    newFromOld[oldFromNew[i] - begin] = begin + i;
+
+  // Walking through the sorted order of the node and appending each point to
+  // the range of its child keeps the points of each child sorted.
+  #pragma omp parallel for if(TrainInParallel(count)) \
+      num_threads((int) NumThreads())
+  for (size_t d = 0; d < (size_t) sortedIndices.n_cols; ++d)
+  {
+    if (datasetInfo && datasetInfo->Type(d) == data::Datatype::categorical)
+      continue;
+
+    size_t* order = sortedIndices.colptr(d) + begin;
+    arma::Row<size_t> cursors(childBegins);
+    arma::Row<size_t> partitioned(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      const size_t point = newFromOld[order[i] - begin];
+      partitioned[cursors[childAssignments[point - begin]]++ - begin] = point;
+    }
+
+    std::copy(partitioned.memptr(), partitioned.memptr() + count, order);
+  }
+}
+
 //! Return the class.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
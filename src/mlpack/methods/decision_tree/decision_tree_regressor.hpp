@@ -20,6 +20,7 @@
 #include "best_binary_numeric_split.hpp"
 #include "all_categorical_split.hpp"
 #include "random_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
 #include "all_dimension_select.hpp"
 
 namespace mlpack {
@@ -30,6 +31,13 @@ namespace mlpack {
  *
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
+ *
+ * When OpenMP is available, nodes with at least ParallelTrainCutoff points are
+ * trained in parallel: the candidate split dimensions of the node are
+ * evaluated at the same time, and its children are trained in separate tasks.
+ * This is only done when the split types and the dimension selection type are
+ * deterministic (see SplitTraits and DimensionSelectionTraits), so the trained
+ * tree is the same as with serial training.
  */
 template<typename FitnessFunction = MSEGain,
          template<typename> class NumericSplitType = BestBinaryNumericSplit,
@@ -48,6 +56,15 @@ class DecisionTreeRegressor :
   //! Allow access to the dimension selection type.
   typedef DimensionSelectionType DimensionSelection;
 
+  //! Nodes with at least this many points are trained in parallel, if
+  //! ParallelTrain is true.
+  static constexpr size_t ParallelTrainCutoff = 4096;
+  //! Whether training can be parallelized without changing the trained tree.
+  static constexpr bool ParallelTrain =
+      SplitTraits<NumericSplit>::IsDeterministic &&
+      SplitTraits<CategoricalSplit>::IsDeterministic &&
+      DimensionSelectionTraits<DimensionSelectionType>::IsDeterministic;
+
   /**
    * Construct a decision tree without training it.  It will be a leaf node.
    */
@@ -524,6 +541,80 @@ class DecisionTreeRegressor :
                const size_t maximumDepth,
                DimensionSelectionType& dimensionSelector,
                FitnessFunction fitnessFunction = FitnessFunction());
+
+  /**
+   * Return true if a node with the given number of points should create the
+   * threads to train it in parallel: ParallelTrain is true, the node is large
+   * enough, and we are not already in a parallel region.
+   */
+  static bool TrainInParallel(const size_t count);
+
+  /**
+   * Call the SplitIfBetter() function of the numeric or categorical split type
+   * for the given dimension of the points of the node.  If datasetInfo is
+   * NULL, all the dimensions are numeric.
+   */
+  template<bool UseWeights, typename MatType, typename ResponsesType>
+  double SplitIfBetter(const size_t dimension,
+                       const double bestGain,
+                       MatType& data,
+                       const size_t begin,
+                       const size_t count,
+                       const data::DatasetInfo* datasetInfo,
+                       ResponsesType& responses,
+                       arma::rowvec& weights,
+                       const size_t minimumLeafSize,
+                       const double minimumGainSplit,
+                       double& splitInfo,
+                       NumericAuxiliarySplitInfo& numericAux,
+                       CategoricalAuxiliarySplitInfo& categoricalAux,
+                       FitnessFunction& fitnessFunction);
+
+  /**
+   * Find the best split of the points of the node among the dimensions given
+   * by the dimension selector.  If a split better than bestGain is found,
+   * bestGain and bestDim are set to its gain and dimension, and the split
+   * information is stored in this node.  If datasetInfo is NULL, all the
+   * dimensions are numeric.
+   */
+  template<bool UseWeights, typename MatType, typename ResponsesType>
+  void FindBestSplit(MatType& data,
+                     const size_t begin,
+                     const size_t count,
+                     const data::DatasetInfo* datasetInfo,
+                     ResponsesType& responses,
+                     arma::rowvec& weights,
+                     const size_t minimumLeafSize,
+                     const double minimumGainSplit,
+                     DimensionSelectionType& dimensionSelector,
+                     FitnessFunction& fitnessFunction,
+                     double& bestGain,
+                     size_t& bestDim);
+
+  /**
+   * Train each child of the node on its range of points (childBegins[i] to
+   * childBegins[i] + childCounts[i] - 1), and store the gain returned by each
+   * child in childGains.  Large children are trained in separate tasks.  If
+   * datasetInfo is NULL, all the dimensions are numeric.
+   */
+  template<bool UseWeights, typename MatType, typename ResponsesType>
+  void TrainChildren(MatType& data,
+                     const arma::Row<size_t>& childBegins,
+                     const arma::Row<size_t>& childCounts,
+                     const data::DatasetInfo* datasetInfo,
+                     ResponsesType& responses,
+                     arma::rowvec& weights,
+                     const size_t minimumLeafSize,
+                     const double minimumGainSplit,
+                     const size_t maximumDepth,
+                     DimensionSelectionType& dimensionSelector,
+                     arma::vec& childGains);
+
+ private:
+  #ifdef MLPACK_TRACK_MEMORY
+  //! Counts this node in MemoryTracker for as long as it exists.
+  MemoryTracker::NodeCounter nodeCounter { sizeof(DecisionTreeRegressor) };
+  #endif
 };
 
 
@@ -639,53 +639,12 @@ double DecisionTreeRegressor<FitnessFunction,
       responses.cols(begin, begin + count - 1),
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
-  const size_t end = dimensionSelector.End();
 
   if (maximumDepth != 1)
   {
-    for (size_t i = dimensionSelector.Begin(); i != end;
-         i = dimensionSelector.Next())
-    {
-      double dimGain = -DBL_MAX;
-      if (datasetInfo.Type(i) == data::Datatype::categorical)
-      {
-        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            datasetInfo.NumMappings(i),
-            responses.cols(begin, begin + count - 1),
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            splitPoint,
-            *this,
-            fitnessFunction);
-      }
-      else if (datasetInfo.Type(i) == data::Datatype::numeric)
-      {
-        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            responses.cols(begin, begin + count - 1),
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            splitPoint,
-            *this,
-            fitnessFunction);
-      }
-
-      // If the splitter reported that it did not split, move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
-
-      // Was there an improvement?  If so mark that it's the new best dimension.
-      bestDim = i;
-      bestGain = dimGain;
-
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
-    }
+    FindBestSplit<UseWeights>(data, begin, count, &datasetInfo, responses,
+        weights, minimumLeafSize, minimumGainSplit, dimensionSelector,
+        fitnessFunction, bestGain, bestDim);
   }
 
   // Did we split or not?  If so, then split the data and create the children.
@@ -723,18 +682,14 @@ double DecisionTreeRegressor<FitnessFunction,
     for (size_t i = begin; i < begin + count; ++i)
       childCounts[childAssignments[i - begin]]++;
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
-
-    // Split into children.
+    // Split into children: the points of each child are moved to a contiguous
+    // range of the dataset.
+    arma::Row<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = childBegins[i]; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -746,26 +701,36 @@ double DecisionTreeRegressor<FitnessFunction,
           ++currentCol;
         }
       }
+    }
 
-      // Now build the child recursively.
-      DecisionTreeRegressor* child = new DecisionTreeRegressor();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, responses,
-            weights, currentCol - currentChildBegin, minimumGainSplit,
-            maximumDepth - 1, dimensionSelector);
-      }
-      else
+    // Now build the children recursively.  Only the outermost node that is
+    // trained in parallel needs to create the threads that the tasks for its
+    // descendants run on.
+    arma::vec childGains;
+    if (TrainInParallel(count))
+    {
+      #pragma omp parallel num_threads((int) NumThreads())
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, responses,
-            weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        #pragma omp single
+        TrainChildren<UseWeights>(data, childBegins, childCounts, &datasetInfo,
+            responses, weights, minimumLeafSize, minimumGainSplit,
+            maximumDepth, dimensionSelector, childGains);
       }
-      children.push_back(child);
+    }
+    else
+    {
+      TrainChildren<UseWeights>(data, childBegins, childCounts, &datasetInfo,
+          responses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+          dimensionSelector, childGains);
+    }
+
+    // Compute bestGain if recursive split is allowed.
+    if (!NoRecursion)
+    {
+      // During recursion entropy of child node may change.
+      bestGain = 0.0;
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -825,34 +790,9 @@ double DecisionTreeRegressor<FitnessFunction,
 
   if (maximumDepth != 1)
   {
-    for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
-         i = dimensionSelector.Next())
-    {
-      const double dimGain = NumericSplitType<FitnessFunction>::template
-          SplitIfBetter<UseWeights>(bestGain,
-                                    data.cols(begin, begin + count - 1).row(i),
-                                    responses.cols(begin, begin + count - 1),
-                                    UseWeights ?
-                                        weights.cols(begin, begin + count - 1) :
-                                        weights,
-                                    minimumLeafSize,
-                                    minimumGainSplit,
-                                    splitPoint,
-                                    *this,
-                                    fitnessFunction);
-
-      // If the splitter did not report that it improved, then move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
-
-      bestDim = i;
-      bestGain = dimGain;
-
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
-    }
+    FindBestSplit<UseWeights>(data, begin, count, NULL, responses, weights,
+        minimumLeafSize, minimumGainSplit, dimensionSelector, fitnessFunction,
+        bestGain, bestDim);
   }
 
   // Did we split or not?  If so, then split the data and create the children.
@@ -878,17 +818,13 @@ double DecisionTreeRegressor<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
       childCounts[childAssignments[j - begin]]++;
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
-
+    // Move the points of each child to a contiguous range of the dataset.
+    arma::Row<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = childBegins[i]; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -900,26 +836,36 @@ double DecisionTreeRegressor<FitnessFunction,
           ++currentCol;
         }
       }
+    }
 
-      // Now build the child recursively.
-      DecisionTreeRegressor* child = new DecisionTreeRegressor();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, responses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-      }
-      else
+    // Now build the children recursively.  Only the outermost node that is
+    // trained in parallel needs to create the threads that the tasks for its
+    // descendants run on.
+    arma::vec childGains;
+    if (TrainInParallel(count))
+    {
+      #pragma omp parallel num_threads((int) NumThreads())
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, responses, weights,
-            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        #pragma omp single
+        TrainChildren<UseWeights>(data, childBegins, childCounts, NULL,
+            responses, weights, minimumLeafSize, minimumGainSplit,
+            maximumDepth, dimensionSelector, childGains);
       }
-      children.push_back(child);
+    }
+    else
+    {
+      TrainChildren<UseWeights>(data, childBegins, childCounts, NULL,
+          responses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+          dimensionSelector, childGains);
+    }
+
+    // Compute bestGain if recursive split is allowed.
+    if (!NoRecursion)
+    {
+      // During recursion entropy of child node may change.
+      bestGain = 0.0;
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -936,6 +882,256 @@ double DecisionTreeRegressor<FitnessFunction,
   return -bestGain;
 }
 
+//! Decide whether to create the threads to train a node in parallel.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+bool DecisionTreeRegressor<FitnessFunction,
+                      NumericSplitType,
+                      CategoricalSplitType,
+                      DimensionSelectionType,
+                      NoRecursion>::TrainInParallel(
+    const size_t count)
+{
+  #ifdef MLPACK_USE_OPENMP
+  // NumThreads() is 1 inside parallel loops (e.g. while a RandomForest trains
+  // its trees), so that nested training is serial.
+  return ParallelTrain && count >= ParallelTrainCutoff && NumThreads() > 1;
+  #else
+  (void) count;
+  return false;
+  #endif
+}
+
+//! Check for a better split in the given dimension.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType, typename ResponsesType>
+double DecisionTreeRegressor<FitnessFunction,
+                      NumericSplitType,
+                      CategoricalSplitType,
+                      DimensionSelectionType,
+                      NoRecursion>::SplitIfBetter(
+    const size_t dimension,
+    const double bestGain,
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    ResponsesType& responses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    double& splitInfo,
+    NumericAuxiliarySplitInfo& numericAux,
+    CategoricalAuxiliarySplitInfo& categoricalAux,
+    FitnessFunction& fitnessFunction)
+{
+  if (datasetInfo &&
+      datasetInfo->Type(dimension) == data::Datatype::categorical)
+  {
+    return CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
+        data.cols(begin, begin + count - 1).row(dimension),
+        datasetInfo->NumMappings(dimension),
+        responses.cols(begin, begin + count - 1),
+        UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+        minimumLeafSize,
+        minimumGainSplit,
+        splitInfo,
+        categoricalAux,
+        fitnessFunction);
+  }
+  else
+  {
+    return NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+        data.cols(begin, begin + count - 1).row(dimension),
+        responses.cols(begin, begin + count - 1),
+        UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+        minimumLeafSize,
+        minimumGainSplit,
+        splitInfo,
+        numericAux,
+        fitnessFunction);
+  }
+}
+
+//! Find the best split of the node.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType, typename ResponsesType>
+void DecisionTreeRegressor<FitnessFunction,
+                      NumericSplitType,
+                      CategoricalSplitType,
+                      DimensionSelectionType,
+                      NoRecursion>::FindBestSplit(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    ResponsesType& responses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    DimensionSelectionType& dimensionSelector,
+    FitnessFunction& fitnessFunction,
+    double& bestGain,
+    size_t& bestDim)
+{
+  // We'll cache the best split auxiliary information in this node, and the
+  // split point in splitPoint.
+  const size_t end = dimensionSelector.End();
+  if (!TrainInParallel(count))
+  {
+    for (size_t i = dimensionSelector.Begin(); i != end;
+         i = dimensionSelector.Next())
+    {
+      const double dimGain = SplitIfBetter<UseWeights>(i, bestGain, data,
+          begin, count, datasetInfo, responses, weights, minimumLeafSize,
+          minimumGainSplit, splitPoint, *this, *this, fitnessFunction);
+
+      // If the splitter reported that it did not split, move to the next
+      // dimension.
+      if (dimGain == DBL_MAX)
+        continue;
+
+      // Was there an improvement?  If so mark that it's the new best dimension.
+      bestDim = i;
+      bestGain = dimGain;
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+
+    return;
+  }
+
+  // For a large node, first find the best split of every dimension in
+  // parallel, against the gain of the node itself.
+  std::vector<size_t> dimensions;
+  for (size_t i = dimensionSelector.Begin(); i != end;
+       i = dimensionSelector.Next())
+    dimensions.push_back(i);
+
+  const size_t numDimensions = dimensions.size();
+  arma::vec gains(numDimensions);
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t d = 0; d < numDimensions; ++d)
+  {
+    double splitInfo;
+    NumericAuxiliarySplitInfo numericAux;
+    CategoricalAuxiliarySplitInfo categoricalAux;
+    FitnessFunction threadFitnessFunction(fitnessFunction);
+    gains[d] = SplitIfBetter<UseWeights>(dimensions[d], bestGain, data, begin,
+        count, datasetInfo, responses, weights, minimumLeafSize,
+        minimumGainSplit, splitInfo, numericAux, categoricalAux,
+        threadFitnessFunction);
+  }
+
+  // Now go through the dimensions in order, like the serial search.  Since the
+  // splits are deterministic, a dimension that could not beat the node cannot
+  // beat the best split found so far, and neither can a dimension whose gain is
+  // below that of the best split so far (up to floating-point error).  Any
+  // other dimension is evaluated again against the best split so far, so that
+  // the chosen split is exactly the one the serial search would choose.
+  for (size_t d = 0; d < numDimensions; ++d)
+  {
+    const double threshold = std::min(bestGain, bestGain + minimumGainSplit);
+    if (gains[d] == DBL_MAX ||
+        gains[d] < threshold - 1e-10 * std::abs(threshold))
+      continue;
+
+    const double dimGain = SplitIfBetter<UseWeights>(dimensions[d], bestGain,
+        data, begin, count, datasetInfo, responses, weights, minimumLeafSize,
+        minimumGainSplit, splitPoint, *this, *this, fitnessFunction);
+    if (dimGain == DBL_MAX)
+      continue;
+
+    bestDim = dimensions[d];
+    bestGain = dimGain;
+
+    // If the gain is the best possible, no need to keep looking.
+    if (bestGain >= 0.0)
+      break;
+  }
+}
+
+//! Train the children of the node.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType, typename ResponsesType>
+void DecisionTreeRegressor<FitnessFunction,
+                      NumericSplitType,
+                      CategoricalSplitType,
+                      DimensionSelectionType,
+                      NoRecursion>::TrainChildren(
+    MatType& data,
+    const arma::Row<size_t>& childBegins,
+    const arma::Row<size_t>& childCounts,
+    const data::DatasetInfo* datasetInfo,
+    ResponsesType& responses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector,
+    arma::vec& childGains)
+{
+  const size_t numChildren = childBegins.n_elem;
+  for (size_t i = 0; i < numChildren; ++i)
+    children.push_back(new DecisionTreeRegressor());
+  childGains.set_size(numChildren);
+
+  auto trainChild = [&](const size_t i, DimensionSelectionType& selector)
+  {
+    // A child of a decision stump is always a leaf.
+    const size_t leafSize = NoRecursion ? childCounts[i] : minimumLeafSize;
+    if (datasetInfo)
+    {
+      childGains[i] = children[i]->Train<UseWeights>(data, childBegins[i],
+          childCounts[i], *datasetInfo, responses, weights, leafSize,
+          minimumGainSplit, maximumDepth - 1, selector);
+    }
+    else
+    {
+      childGains[i] = children[i]->Train<UseWeights>(data, childBegins[i],
+          childCounts[i], responses, weights, leafSize, minimumGainSplit,
+          maximumDepth - 1, selector);
+    }
+  };
+
+  // The children hold disjoint ranges of the dataset, so they can be trained
+  // at the same time; small children are not worth the overhead of a task.  A
+  // child trained in a task gets its own copy of the dimension selector, made
+  // before the task starts.
+  for (size_t i = 0; i < numChildren; ++i)
+  {
+    if (ParallelTrain && childCounts[i] >= ParallelTrainCutoff)
+    {
+      DimensionSelectionType selector(dimensionSelector);
+      #pragma omp task default(shared) firstprivate(i, selector)
+      trainChild(i, selector);
+    }
+    else
+    {
+      trainChild(i, dimensionSelector);
+    }
+  }
+
+  #pragma omp taskwait
+}
+
 //! Return the prediction.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
@@ -0,0 +1,209 @@
+/**
+ * @file methods/decision_tree/flat_decision_tree.hpp
+ *
+ * A compiled, read-only representation of a trained decision tree, stored as
+ * a flat array of nodes for fast batch classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_TREE_HPP
+#define MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_TREE_HPP
+
+#include <mlpack/core.hpp>
+#include <queue>
+
+namespace mlpack {
+
+/**
+ * A FlatDecisionTree is an inference-only copy of a trained DecisionTree.
+ * Instead of a tree of heap-allocated nodes, the nodes are stored in breadth
+ * first order in one array, and each node is packed into 16 bytes: the split
+ * threshold, the split dimension, and the index of the first child (the
+ * children of a node are stored next to each other).  The class probabilities
+ * of the leaves are stored separately, so that the nodes visited while
+ * traversing the tree stay small and close in memory.
+ *
+ * When classifying a set of points, blocks of BlockSize points go down the tree
+ * together, one level at a time, so that the memory accesses for the different
+ * points of a block are independent and can overlap; the blocks are classified
+ * in parallel with OpenMP.  The predictions are the same as those of the
+ * original tree.
+ *
+ * @code
+ * DecisionTree<> tree(data, labels, numClasses);
+ * FlatDecisionTree flatTree(tree);
+ * arma::Row<size_t> predictions;
+ * flatTree.Classify(testData, predictions);
+ * @endcode
+ *
+ * Numeric splits must be binary splits that send the points whose value is at
+ * most the split information of the node to the first child (as with all the
+ * numeric split types in mlpack), and categorical splits must send each point
+ * to the child of its category (as AllCategoricalSplit does).
+ */
+class FlatDecisionTree
+{
+ public:
+  //! The number of points that go down the tree together in batch
+  //! classification.
+  static constexpr size_t BlockSize = 64;
+
+  /**
+   * Create an empty flat tree.  It must be assigned or loaded before it can be
+   * used.
+   */
+  FlatDecisionTree() { }
+
+  /**
+   * Compile the given trained decision tree into a flat tree.  A
+   * std::invalid_argument is thrown if the tree has a split that cannot be
+   * represented (a numeric split with other than two children, or more than
+   * 2^31 dimensions or 2^32 nodes).
+   *
+   * @param tree Trained decision tree to compile.
+   */
+  template<typename TreeType>
+  explicit FlatDecisionTree(const TreeType& tree);
+
+  /**
+   * Classify the given point.  The predicted label is returned.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given point and also return the probability of each class.
+   *
+   * @param point Point to classify.
+   * @param prediction This will be set to the predicted class of the point.
+   * @param probabilities This will be filled with class probabilities for the
+   *      point.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Classify the given points.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points and also return the probability of each class
+   * for each point.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   * @param probabilities This will be filled with class probabilities for each
+   *      point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  /**
+   * Find the leaf that each of the points data.cols(begin, end - 1) falls in;
+   * the index of the leaf of point i is stored in leaves[i - begin].  The
+   * points go down the tree together, one level at a time.  This is the
+   * building block of batch classification, also used by FlatRandomForest.
+   *
+   * @param data Set of points.
+   * @param begin Index of the first point.
+   * @param end One past the index of the last point.
+   * @param leaves Will hold the index of the leaf of each point; it must have
+   *      at least end - begin elements.
+   */
+  template<typename MatType>
+  void Leaves(const MatType& data,
+              const size_t begin,
+              const size_t end,
+              arma::Row<size_t>& leaves) const;
+
+  //! Get the predicted class of the given leaf.
+  size_t LeafClass(const size_t leaf) const { return leafClasses[leaf]; }
+  //! Get the class probabilities of the given leaf.
+  const arma::mat& LeafProbabilities() const { return leafProbabilities; }
+
+  //! Get the number of nodes in the tree.
+  size_t NumNodes() const { return nodes.size(); }
+  //! Get the number of leaves in the tree.
+  size_t NumLeaves() const { return leafClasses.n_elem; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return leafProbabilities.n_rows; }
+
+  //! Serialize the tree.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! The dimension of a leaf node.
+  static constexpr uint32_t LeafDimension = 0xFFFFFFFF;
+  //! The bit of the dimension that marks a categorical split.
+  static constexpr uint32_t CategoricalBit = 0x80000000;
+
+  // A node of the tree, packed into 16 bytes.
+  struct Node
+  {
+    //! The split threshold (for numeric splits).
+    double threshold;
+    //! The split dimension, CategoricalBit | the split dimension for
+    //! categorical splits, or LeafDimension for leaves.
+    uint32_t dimension;
+    //! The index of the first child, or of the leaf for leaves.
+    uint32_t child;
+
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      ar(CEREAL_NVP(threshold));
+      ar(CEREAL_NVP(dimension));
+      ar(CEREAL_NVP(child));
+    }
+  };
+
+  static_assert(sizeof(Node) == 16, "FlatDecisionTree::Node must be 16 "
+      "bytes.");
+
+  //! Return the index of the child of the given (non-leaf) node that the given
+  //! value goes to.
+  template<typename ElemType>
+  static size_t Next(const Node& node, const ElemType value)
+  {
+    if (node.dimension & CategoricalBit)
+      return node.child + (size_t) value;
+    else
+      return node.child + ((value <= node.threshold) ? 0 : 1);
+  }
+
+  //! Return the index of the leaf the given point falls in.
+  template<typename VecType>
+  size_t Leaf(const VecType& point) const;
+
+  //! Throw a std::invalid_argument if the tree is empty.
+  void CheckTrained() const;
+
+  //! The nodes, in breadth first order; the root is the first node.
+  std::vector<Node> nodes;
+  //! The predicted class of each leaf.
+  arma::Row<size_t> leafClasses;
+  //! The class probabilities of each leaf, one leaf per column.
+  arma::mat leafProbabilities;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_decision_tree_impl.hpp"
+
+#endif
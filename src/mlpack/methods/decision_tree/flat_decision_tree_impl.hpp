@@ -0,0 +1,217 @@
+/**
+ * @file methods/decision_tree/flat_decision_tree_impl.hpp
+ *
+ * Implementation of the flat representation of a trained decision tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_TREE_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_decision_tree.hpp"
+
+namespace mlpack {
+
+template<typename TreeType>
+FlatDecisionTree::FlatDecisionTree(const TreeType& tree)
+{
+  // Lay the nodes out in breadth first order, so that the children of each
+  // node are next to each other.
+  std::queue<std::pair<const TreeType*, size_t>> queue;
+  std::vector<size_t> classes;
+  std::vector<const arma::vec*> probabilities;
+  nodes.resize(1);
+  queue.push(std::make_pair(&tree, 0));
+  while (!queue.empty())
+  {
+    const TreeType* node = queue.front().first;
+    const size_t index = queue.front().second;
+    queue.pop();
+
+    const size_t numChildren = node->NumChildren();
+    if (numChildren == 0)
+    {
+      nodes[index].threshold = 0.0;
+      nodes[index].dimension = LeafDimension;
+      nodes[index].child = (uint32_t) classes.size();
+      classes.push_back(node->MajorityClass());
+      probabilities.push_back(&node->ClassProbabilities());
+      continue;
+    }
+
+    const bool categorical = (node->SplitDimensionType() ==
+        data::Datatype::categorical);
+    if (!categorical && numChildren != 2)
+    {
+      throw std::invalid_argument("FlatDecisionTree::FlatDecisionTree(): "
+          "numeric splits must have two children!");
+    }
+
+    if (node->SplitDimension() >= (size_t) CategoricalBit ||
+        nodes.size() + numChildren > (size_t) LeafDimension)
+    {
+      throw std::invalid_argument("FlatDecisionTree::FlatDecisionTree(): tree "
+          "is too large to be flattened!");
+    }
+
+    const size_t firstChild = nodes.size();
+    nodes.resize(firstChild + numChildren);
+    nodes[index].threshold = categorical ? 0.0 :
+        node->ClassProbabilities()[0];
+    nodes[index].dimension = (uint32_t) node->SplitDimension() |
+        (categorical ? (uint32_t) CategoricalBit : 0u);
+    nodes[index].child = (uint32_t) firstChild;
+
+    for (size_t i = 0; i < numChildren; ++i)
+      queue.push(std::make_pair(&node->Child(i), firstChild + i));
+  }
+
+  leafClasses.set_size(classes.size());
+  leafProbabilities.set_size(probabilities[0]->n_elem, probabilities.size());
+  for (size_t i = 0; i < classes.size(); ++i)
+  {
+    leafClasses[i] = classes[i];
+    leafProbabilities.col(i) = *probabilities[i];
+  }
+}
+
+template<typename VecType>
+size_t FlatDecisionTree::Classify(const VecType& point) const
+{
+  return leafClasses[Leaf(point)];
+}
+
+template<typename VecType>
+void FlatDecisionTree::Classify(const VecType& point,
+                                size_t& prediction,
+                                arma::vec& probabilities) const
+{
+  const size_t leaf = Leaf(point);
+  prediction = leafClasses[leaf];
+  probabilities = leafProbabilities.col(leaf);
+}
+
+template<typename MatType>
+void FlatDecisionTree::Classify(const MatType& data,
+                                arma::Row<size_t>& predictions) const
+{
+  CheckTrained();
+
+  predictions.set_size(data.n_cols);
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    arma::Row<size_t> leaves(BlockSize);
+
+    #pragma omp for schedule(static)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * BlockSize;
+      const size_t end = std::min((size_t) data.n_cols, begin + BlockSize);
+      Leaves(data, begin, end, leaves);
+      for (size_t i = begin; i < end; ++i)
+        predictions[i] = leafClasses[leaves[i - begin]];
+    }
+  }
+}
+
+template<typename MatType>
+void FlatDecisionTree::Classify(const MatType& data,
+                                arma::Row<size_t>& predictions,
+                                arma::mat& probabilities) const
+{
+  CheckTrained();
+
+  predictions.set_size(data.n_cols);
+  probabilities.set_size(leafProbabilities.n_rows, data.n_cols);
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    arma::Row<size_t> leaves(BlockSize);
+
+    #pragma omp for schedule(static)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * BlockSize;
+      const size_t end = std::min((size_t) data.n_cols, begin + BlockSize);
+      Leaves(data, begin, end, leaves);
+      for (size_t i = begin; i < end; ++i)
+      {
+        predictions[i] = leafClasses[leaves[i - begin]];
+        probabilities.col(i) = leafProbabilities.col(leaves[i - begin]);
+      }
+    }
+  }
+}
+
+template<typename MatType>
+void FlatDecisionTree::Leaves(const MatType& data,
+                              const size_t begin,
+                              const size_t end,
+                              arma::Row<size_t>& leaves) const
+{
+  for (size_t i = begin; i < end; ++i)
+    leaves[i - begin] = 0;
+
+  // Move every point of the block that is not at a leaf yet down one level,
+  // until all of them are at leaves.
+  bool active = true;
+  while (active)
+  {
+    active = false;
+    for (size_t i = begin; i < end; ++i)
+    {
+      const Node& node = nodes[leaves[i - begin]];
+      if (node.dimension == LeafDimension)
+        continue;
+
+      leaves[i - begin] = Next(node, data(node.dimension & ~CategoricalBit, i));
+      active = true;
+    }
+  }
+
+  for (size_t i = begin; i < end; ++i)
+    leaves[i - begin] = nodes[leaves[i - begin]].child;
+}
+
+template<typename VecType>
+size_t FlatDecisionTree::Leaf(const VecType& point) const
+{
+  CheckTrained();
+
+  size_t index = 0;
+  while (nodes[index].dimension != LeafDimension)
+  {
+    index = Next(nodes[index],
+        point[nodes[index].dimension & ~CategoricalBit]);
+  }
+
+  return nodes[index].child;
+}
+
+inline void FlatDecisionTree::CheckTrained() const
+{
+  if (nodes.empty())
+  {
+    throw std::invalid_argument("FlatDecisionTree::Classify(): no tree "
+        "compiled!");
+  }
+}
+
+template<typename Archive>
+void FlatDecisionTree::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(nodes));
+  ar(CEREAL_NVP(leafClasses));
+  ar(CEREAL_NVP(leafProbabilities));
+}
+
+} // namespace mlpack
+
+#endif
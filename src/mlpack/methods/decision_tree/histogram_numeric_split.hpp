@@ -0,0 +1,242 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split.hpp
+ *
+ * A tree splitter that finds the best binary numeric split between the bins of
+ * a histogram of the data, without sorting it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "best_binary_numeric_split.hpp"
+#include "split_traits.hpp"
+
+namespace mlpack {
+
+/**
+ * The HistogramNumericSplit is a splitting function for decision trees that
+ * finds the best binary split of a numeric dimension among the boundaries of
+ * at most MaxBins bins, instead of among all the values of the dimension.  The
+ * bin edges are quantiles of a fixed-size strided subsample of the values of
+ * the node, so that the full set of values is never sorted: each point is
+ * assigned an 8-bit bin index with a binary search over the edges, and then
+ * the class counts (for classification) are accumulated into a histogram with
+ * one column per bin, whose prefix sums give the class counts of each child
+ * for every candidate split.  For regression, the points are ordered by bin
+ * with a counting sort, and the fitness function is evaluated at the bin
+ * boundaries only.  So, finding a split of a node with n points takes
+ * O(n log(MaxBins)) time instead of O(n log n).
+ *
+ * When a node has no more than MaxBins distinct values in a dimension (and at
+ * most 4 * MaxBins points, so that the subsample is the whole node), the split
+ * is the same as the split found by BestBinaryNumericSplit.  Otherwise, the
+ * split is one of the best splits between quantiles, which is typically as
+ * good for prediction; this is the approach taken by histogram-based gradient
+ * boosting libraries such as LightGBM.
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class HistogramNumericSplit
+{
+ public:
+  //! The maximum number of bins each dimension of a node is divided into.
+  static constexpr size_t MaxBins = 256;
+
+  // No extra info needed for split.
+  class AuxiliarySplitInfo { };
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then splitInfo and aux
+   * may be modified.
+   *
+   * This overload is used only for classification tasks.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::vec& splitInfo,
+      AuxiliarySplitInfo& aux);
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then splitInfo and aux
+   * may be modified.
+   *
+   * This overload is used only for regression tasks, with fitness functions
+   * that do not implement BinaryScanInitialize(), BinaryStep() and
+   * BinaryGains().
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param responses Responses for each point.
+   * @param weights Weights associated with responses.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   * @param fitnessFunction The FitnessFunction object instance. It is used to
+   *      evaluate the gain for the split.
+   */
+  template<bool UseWeights, typename VecType, typename ResponsesType,
+           typename WeightVecType>
+  static typename std::enable_if<
+      !HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+      double>::type
+  SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const ResponsesType& responses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      double& splitInfo,
+      AuxiliarySplitInfo& aux,
+      FitnessFunction& fitnessFunction);
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then splitInfo and aux
+   * may be modified.
+   *
+   * This overload is specialized for any fitness function that implements
+   * BinaryScanInitialize(), BinaryStep() and BinaryGains() functions.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param responses Responses for each point.
+   * @param weights Weights associated with responses.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename ResponsesType,
+           typename WeightVecType>
+  static typename std::enable_if<
+      HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+      double>::type
+  SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const ResponsesType& responses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      double& splitInfo,
+      AuxiliarySplitInfo& /* aux */,
+      FitnessFunction& fitnessFunction);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  static size_t NumChildren(const double& /* splitInfo */,
+                            const AuxiliarySplitInfo& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param splitInfo Auxiliary information for the split.
+   * @param * (aux) Auxiliary information for the split (Unused).
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const double& splitInfo,
+      const AuxiliarySplitInfo& /* aux */);
+
+ private:
+  /**
+   * Assign each of the given values to a bin.  The bin edges are quantiles of
+   * a strided subsample of at most 4 * MaxBins values; empty bins are removed,
+   * so every returned bin holds at least one value, and the bins are in
+   * increasing order of values.
+   *
+   * @param data Values to assign to bins.
+   * @param bins Will be set to the bin of each value.
+   * @param binMin Will be set to the smallest value in each bin.
+   * @param binMax Will be set to the largest value in each bin.
+   * @param binCounts Will be set to the number of values in each bin.
+   * @return The number of bins.
+   */
+  template<typename VecType>
+  static size_t Bin(const VecType& data,
+                    arma::Row<uint8_t>& bins,
+                    arma::vec& binMin,
+                    arma::vec& binMax,
+                    arma::Col<size_t>& binCounts);
+
+  /**
+   * Order the responses (and weights) by bin, with a counting sort.
+   */
+  template<bool UseWeights, typename ResponsesType, typename WeightVecType>
+  static void SortByBin(
+      const arma::Row<uint8_t>& bins,
+      const arma::Col<size_t>& binCounts,
+      const ResponsesType& responses,
+      const WeightVecType& weights,
+      arma::Row<typename ResponsesType::elem_type>& sortedResponses,
+      arma::Row<typename WeightVecType::elem_type>& sortedWeights,
+      arma::Row<uint8_t>& sortedBins);
+
+  /**
+   * Compute the split point between a bin whose largest value is leftMax and
+   * the next bin, whose smallest value is rightMin.  The split point is
+   * halfway between them, and always smaller than rightMin.
+   */
+  static double SplitPoint(const double leftMax, const double rightMin);
+};
+
+//! HistogramNumericSplit does not use random numbers.
+template<typename FitnessFunction>
+class SplitTraits<HistogramNumericSplit<FitnessFunction>>
+{
+ public:
+  static const bool IsDeterministic = true;
+  static const bool UsesPresortedData = false;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "histogram_numeric_split_impl.hpp"
+
+#endif
@@ -0,0 +1,566 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split_impl.hpp
+ *
+ * Implementation of the HistogramNumericSplit class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "histogram_numeric_split.hpp"
+
+namespace mlpack {
+
+template<typename FitnessFunction>
+constexpr size_t HistogramNumericSplit<FitnessFunction>::MaxBins;
+
+// Overload used for classification.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo,
+    AuxiliarySplitInfo& /* aux */)
+{
+  // The histograms hold class counts, or class weight sums if we are using
+  // weights.
+  typedef typename std::conditional<UseWeights, double, size_t>::type
+      CountType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  arma::Row<uint8_t> bins;
+  arma::vec binMin, binMax;
+  arma::Col<size_t> binCounts;
+  const size_t numBins = Bin(data, bins, binMin, binMax, binCounts);
+
+  // If all the points are in the same bin, we can't split in this dimension.
+  if (numBins < 2)
+    return DBL_MAX;
+
+  // Build the class histogram of each bin, and the total of each class.
+  arma::Mat<CountType> histogram(numClasses, numBins, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    if (UseWeights)
+      histogram(labels[i], bins[i]) += (CountType) weights[i];
+    else
+      ++histogram(labels[i], bins[i]);
+  }
+
+  arma::Col<CountType> leftCounts(numClasses, arma::fill::zeros);
+  arma::Col<CountType> rightCounts = arma::sum(histogram, 1);
+  CountType totalLeft = 0;
+  CountType totalRight = arma::accu(rightCounts);
+  const CountType total = totalRight;
+
+  // Loop through all the boundaries between bins, choosing the best one.  Also,
+  // force a minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0) * total;
+  bool improved = false;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  size_t leftPoints = 0;
+  for (size_t b = 0; b < numBins - 1; ++b)
+  {
+    // Move the points of bin b to the left child.
+    const CountType* binCountsPtr = histogram.colptr(b);
+    for (size_t c = 0; c < numClasses; ++c)
+    {
+      leftCounts[c] += binCountsPtr[c];
+      rightCounts[c] -= binCountsPtr[c];
+      totalLeft += binCountsPtr[c];
+      totalRight -= binCountsPtr[c];
+    }
+    leftPoints += binCounts[b];
+
+    if (leftPoints < minimum)
+      continue;
+    if (data.n_elem - leftPoints <= minimum)
+      break;
+
+    // Calculate the gain for the left and right child.
+    const double leftGain = FitnessFunction::template EvaluatePtr<UseWeights>(
+        leftCounts.memptr(), numClasses, totalLeft);
+    const double rightGain = FitnessFunction::template EvaluatePtr<UseWeights>(
+        rightCounts.memptr(), numClasses, totalRight);
+    const double gain = double(totalLeft) * leftGain +
+        double(totalRight) * rightGain;
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just
+      // take this one.
+      splitInfo.set_size(1);
+      splitInfo[0] = SplitPoint(binMax[b], binMin[b + 1]);
+      return gain;
+    }
+    else if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      splitInfo.set_size(1);
+      splitInfo[0] = SplitPoint(binMax[b], binMin[b + 1]);
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  return bestFoundGain / total;
+}
+
+// Overload used for regression.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename ResponsesType,
+         typename WeightVecType>
+typename std::enable_if<
+    !HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+    double>::type
+HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const ResponsesType& responses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    double& splitInfo,
+    AuxiliarySplitInfo& /* aux */,
+    FitnessFunction& fitnessFunction)
+{
+  typedef typename ResponsesType::elem_type RType;
+  typedef typename WeightVecType::elem_type WType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  arma::Row<uint8_t> bins;
+  arma::vec binMin, binMax;
+  arma::Col<size_t> binCounts;
+  const size_t numBins = Bin(data, bins, binMin, binMax, binCounts);
+
+  // If all the points are in the same bin, we can't split in this dimension.
+  if (numBins < 2)
+    return DBL_MAX;
+
+  arma::Row<RType> sortedResponses;
+  arma::Row<WType> sortedWeights;
+  arma::Row<uint8_t> sortedBins;
+  SortByBin<UseWeights>(bins, binCounts, responses, weights, sortedResponses,
+      sortedWeights, sortedBins);
+
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  WType totalWeight = 0.0;
+  WType totalLeftWeight = 0.0;
+  WType totalRightWeight = 0.0;
+  if (UseWeights)
+  {
+    totalWeight = accu(sortedWeights);
+    totalRightWeight = totalWeight;
+    bestFoundGain *= totalWeight;
+  }
+  else
+  {
+    bestFoundGain *= data.n_elem;
+  }
+
+  // Loop through the boundaries between bins, choosing the best one.  The
+  // boundary after bin b is at the index of the first point of bin b + 1.
+  size_t index = 0;
+  for (size_t b = 0; b < numBins - 1; ++b)
+  {
+    const size_t nextIndex = index + binCounts[b];
+    if (UseWeights)
+    {
+      for (size_t i = index; i < nextIndex; ++i)
+      {
+        totalLeftWeight += sortedWeights[i];
+        totalRightWeight -= sortedWeights[i];
+      }
+    }
+    index = nextIndex;
+
+    if (index < minimum)
+      continue;
+    if (index > data.n_elem - minimum)
+      break;
+
+    // Calculate the gain for the left and right child.
+    const double leftGain = fitnessFunction.template
+        Evaluate<UseWeights>(sortedResponses, sortedWeights, 0, index);
+    const double rightGain = fitnessFunction.template
+        Evaluate<UseWeights>(sortedResponses, sortedWeights, index,
+            responses.n_elem);
+
+    double gain;
+    if (UseWeights)
+    {
+      gain = totalLeftWeight * leftGain + totalRightWeight * rightGain;
+    }
+    else
+    {
+      // Calculate the gain at this split point.
+      gain = double(index) * leftGain +
+          double(sortedResponses.n_elem - index) * rightGain;
+    }
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      splitInfo = SplitPoint(binMax[b], binMin[b + 1]);
+      return gain;
+    }
+    else if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      splitInfo = SplitPoint(binMax[b], binMin[b + 1]);
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= data.n_elem;
+
+  return bestFoundGain;
+}
+
+// Optimized version for any fitness function that implements
+// BinaryScanInitialize(), BinaryStep() and BinaryGains() functions.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename ResponsesType,
+         typename WeightVecType>
+typename std::enable_if<
+    HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+    double>::type
+HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const ResponsesType& responses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    double& splitInfo,
+    AuxiliarySplitInfo& /* aux */,
+    FitnessFunction& fitnessFunction)
+{
+  typedef typename ResponsesType::elem_type RType;
+  typedef typename WeightVecType::elem_type WType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  arma::Row<uint8_t> bins;
+  arma::vec binMin, binMax;
+  arma::Col<size_t> binCounts;
+  const size_t numBins = Bin(data, bins, binMin, binMax, binCounts);
+
+  // If all the points are in the same bin, we can't split in this dimension.
+  if (numBins < 2)
+    return DBL_MAX;
+
+  arma::Row<RType> sortedResponses;
+  arma::Row<WType> sortedWeights;
+  arma::Row<uint8_t> sortedBins;
+  SortByBin<UseWeights>(bins, binCounts, responses, weights, sortedResponses,
+      sortedWeights, sortedBins);
+
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  WType totalWeight = 0.0;
+  WType leftChildWeight = 0.0;
+  WType rightChildWeight = 0.0;
+
+  if (UseWeights)
+  {
+    totalWeight = accu(sortedWeights);
+    bestFoundGain *= totalWeight;
+
+    for (size_t i = 0; i < minimum - 1; ++i)
+      leftChildWeight += sortedWeights[i];
+
+    for (size_t i = minimum - 1; i < data.n_elem; ++i)
+      rightChildWeight += sortedWeights[i];
+  }
+  else
+  {
+    bestFoundGain *= data.n_elem;
+  }
+
+  // Initialize and precompute various statistics to efficiently compute gain
+  // values for all possible splits.  The points are stepped through one at a
+  // time, but the gain is only computed at the boundaries between bins.
+  fitnessFunction.template BinaryScanInitialize<UseWeights>(sortedResponses,
+      sortedWeights, minimum);
+
+  for (size_t index = minimum; index < data.n_elem - minimum + 1; ++index)
+  {
+    if (UseWeights)
+    {
+      leftChildWeight += sortedWeights[index - 1];
+      rightChildWeight -= sortedWeights[index - 1];
+    }
+
+    // Steps through the current index and updates the cached data.
+    fitnessFunction.template BinaryStep<UseWeights>(sortedResponses,
+        sortedWeights, index - 1);
+
+    // Make sure that this is the boundary between two bins.
+    if (sortedBins[index] == sortedBins[index - 1])
+      continue;
+
+    // Calculate the gain for the left and right child.
+    std::tuple<double, double> binaryGains = fitnessFunction.BinaryGains();
+    const double leftGain = std::get<0>(binaryGains);
+    const double rightGain = std::get<1>(binaryGains);
+
+    double gain;
+    if (UseWeights)
+    {
+      gain = leftChildWeight * leftGain + rightChildWeight * rightGain;
+    }
+    else
+    {
+      // Calculate the gain at this split point.
+      gain = double(index) * leftGain +
+          double(sortedResponses.n_elem - index) * rightGain;
+    }
+
+    // Corner case: is this the best possible split?
+    const size_t b = sortedBins[index - 1];
+    if (gain >= 0.0)
+    {
+      splitInfo = SplitPoint(binMax[b], binMin[b + 1]);
+      return gain;
+    }
+    if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      splitInfo = SplitPoint(binMax[b], binMin[b + 1]);
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= data.n_elem;
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t HistogramNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const double& splitInfo,
+    const AuxiliarySplitInfo& /* aux */)
+{
+  if (point <= splitInfo)
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+size_t HistogramNumericSplit<FitnessFunction>::Bin(
+    const VecType& data,
+    arma::Row<uint8_t>& bins,
+    arma::vec& binMin,
+    arma::vec& binMax,
+    arma::Col<size_t>& binCounts)
+{
+  const size_t n = data.n_elem;
+  if (n == 0)
+  {
+    bins.reset();
+    binMin.reset();
+    binMax.reset();
+    binCounts.reset();
+    return 0;
+  }
+
+  // Take a strided subsample of the values and sort it; this costs O(MaxBins
+  // log MaxBins) time no matter how many points there are.
+  const size_t sampleSize = std::min(n, 4 * MaxBins);
+  arma::vec sample(sampleSize);
+  for (size_t i = 0; i < sampleSize; ++i)
+    sample[i] = data[(i * n) / sampleSize];
+  std::sort(sample.begin(), sample.end());
+
+  // Count the distinct values of the subsample.
+  size_t distinct = 1;
+  for (size_t i = 1; i < sampleSize; ++i)
+    if (sample[i] != sample[i - 1])
+      ++distinct;
+
+  // A value v goes to the bin whose index is the number of edges smaller than
+  // v.  If there are few enough distinct values, each gets its own bin;
+  // otherwise, the edges are quantiles of the subsample.  The largest value of
+  // the subsample is never an edge, so that the last bin is not empty.
+  arma::vec edges(MaxBins - 1);
+  size_t numEdges = 0;
+  if (distinct <= MaxBins)
+  {
+    for (size_t i = 0; i < sampleSize - 1; ++i)
+      if (sample[i] != sample[i + 1])
+        edges[numEdges++] = sample[i];
+  }
+  else
+  {
+    for (size_t b = 1; b < MaxBins; ++b)
+    {
+      const double edge = sample[(b * sampleSize) / MaxBins];
+      if (edge < sample[sampleSize - 1] &&
+          (numEdges == 0 || edge > edges[numEdges - 1]))
+        edges[numEdges++] = edge;
+    }
+  }
+
+  bins.set_size(n);
+  binMin.set_size(numEdges + 1);
+  binMin.fill(DBL_MAX);
+  binMax.set_size(numEdges + 1);
+  binMax.fill(-DBL_MAX);
+  binCounts.zeros(numEdges + 1);
+  const double* edgesEnd = edges.memptr() + numEdges;
+  for (size_t i = 0; i < n; ++i)
+  {
+    const double value = data[i];
+    const size_t bin = std::lower_bound(edges.memptr(), edgesEnd, value) -
+        edges.memptr();
+    bins[i] = (uint8_t) bin;
+    binMin[bin] = std::min(binMin[bin], value);
+    binMax[bin] = std::max(binMax[bin], value);
+    ++binCounts[bin];
+  }
+
+  // Since the edges were chosen from a subsample, some bins may be empty;
+  // remove them.
+  arma::Col<uint8_t> newBins(numEdges + 1);
+  size_t numBins = 0;
+  for (size_t b = 0; b < numEdges + 1; ++b)
+  {
+    newBins[b] = (uint8_t) numBins;
+    if (binCounts[b] > 0)
+    {
+      binMin[numBins] = binMin[b];
+      binMax[numBins] = binMax[b];
+      binCounts[numBins] = binCounts[b];
+      ++numBins;
+    }
+  }
+
+  if (numBins < numEdges + 1)
+  {
+    for (size_t i = 0; i < n; ++i)
+      bins[i] = newBins[bins[i]];
+
+    binMin.resize(numBins);
+    binMax.resize(numBins);
+    binCounts.resize(numBins);
+  }
+
+  return numBins;
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename ResponsesType, typename WeightVecType>
+void HistogramNumericSplit<FitnessFunction>::SortByBin(
+    const arma::Row<uint8_t>& bins,
+    const arma::Col<size_t>& binCounts,
+    const ResponsesType& responses,
+    const WeightVecType& weights,
+    arma::Row<typename ResponsesType::elem_type>& sortedResponses,
+    arma::Row<typename WeightVecType::elem_type>& sortedWeights,
+    arma::Row<uint8_t>& sortedBins)
+{
+  // The first position of each bin in the sorted order.
+  arma::Col<size_t> positions(binCounts.n_elem);
+  size_t position = 0;
+  for (size_t b = 0; b < binCounts.n_elem; ++b)
+  {
+    positions[b] = position;
+    position += binCounts[b];
+  }
+
+  sortedResponses.set_size(bins.n_elem);
+  sortedBins.set_size(bins.n_elem);
+  if (UseWeights)
+    sortedWeights.set_size(bins.n_elem);
+
+  for (size_t i = 0; i < bins.n_elem; ++i)
+  {
+    const size_t j = positions[bins[i]]++;
+    sortedResponses[j] = responses[i];
+    sortedBins[j] = bins[i];
+    if (UseWeights)
+      sortedWeights[j] = weights[i];
+  }
+}
+
+template<typename FitnessFunction>
+double HistogramNumericSplit<FitnessFunction>::SplitPoint(
+    const double leftMax,
+    const double rightMin)
+{
+  double splitPoint = (leftMax + rightMin) / 2.0;
+
+  // In some very extreme cases, floating-point inaccuracies can lead to the
+  // split result being the upper bound, which is problematic for later as all
+  // the child points will be sent to the left child.  If this happens, bump it
+  // down incrementally.
+  if (splitPoint == rightMin)
+    splitPoint = std::nexttoward(splitPoint, leftMax);
+
+  return splitPoint;
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * @file methods/decision_tree/presorted_binary_numeric_split.hpp
+ *
+ * A tree splitter that finds the best binary numeric split, like
+ * BestBinaryNumericSplit, using sort orders of the dimensions that are computed
+ * once before training.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_PRESORTED_BINARY_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_PRESORTED_BINARY_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "best_binary_numeric_split.hpp"
+#include "split_traits.hpp"
+
+namespace mlpack {
+
+/**
+ * The PresortedBinaryNumericSplit is a splitting function for classification
+ * decision trees that exhaustively searches a numeric dimension for the best
+ * binary split, exactly like BestBinaryNumericSplit.  The difference is that
+ * the points are not sorted at every node: DecisionTree sorts each numeric
+ * dimension once before training, and then keeps the points of each node in
+ * sorted order while the nodes are split (see
+ * SplitTraits::UsesPresortedData).  This replaces the O(n log n) sort of each
+ * dimension at each node with an O(n) pass, at the cost of storing one index
+ * for each element of the dataset during training.
+ *
+ * This split can only be used for classification (with DecisionTree).
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class PresortedBinaryNumericSplit
+{
+ public:
+  // No extra info needed for split.
+  class AuxiliarySplitInfo { };
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return DBL_MAX.  The points must be sorted in ascending order along the
+   * dimension, with the labels and weights in the same order.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in, sorted
+   *      in ascending order.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information (unused).
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::vec& splitInfo,
+      AuxiliarySplitInfo& /* aux */)
+  {
+    return BestBinaryNumericSplit<FitnessFunction>::template
+        SplitIfBetterSorted<UseWeights>(bestGain, data, labels, numClasses,
+        weights, minimumLeafSize, minimumGainSplit, splitInfo);
+  }
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  static size_t NumChildren(const double& /* splitInfo */,
+                            const AuxiliarySplitInfo& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param splitInfo Auxiliary information for the split.
+   * @param * (aux) Auxiliary information for the split (Unused).
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const double& splitInfo,
+      const AuxiliarySplitInfo& /* aux */)
+  {
+    if (point <= splitInfo)
+      return 0; // Go left.
+    else
+      return 1; // Go right.
+  }
+};
+
+//! PresortedBinaryNumericSplit does not use random numbers, and needs the
+//! points of each node in sorted order.
+template<typename FitnessFunction>
+class SplitTraits<PresortedBinaryNumericSplit<FitnessFunction>>
+{
+ public:
+  static const bool IsDeterministic = true;
+  static const bool UsesPresortedData = true;
+};
+
+} // namespace mlpack
+
+#endif
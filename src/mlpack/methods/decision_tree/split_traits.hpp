@@ -0,0 +1,78 @@
+/**
+ * @file methods/decision_tree/split_traits.hpp
+ *
+ * Traits classes that give compile-time information about the split types and
+ * dimension selection types used by decision trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_METHODS_DECISION_TREE_SPLIT_TRAITS_HPP
+
+namespace mlpack {
+
+/**
+ * The SplitTraits class provides compile-time information about a numeric or
+ * categorical split type.  DecisionTree and DecisionTreeRegressor use it to
+ * decide whether they can be trained in parallel without changing the trained
+ * tree.  By default nothing is assumed about the split type; a split type that
+ * satisfies a trait can specialize this class, as the split types in mlpack
+ * do.
+ *
+ * @code
+ * template<typename FitnessFunction>
+ * class SplitTraits<MySplit<FitnessFunction>>
+ * {
+ *  public:
+ *   static const bool IsDeterministic = true;
+ *   static const bool UsesPresortedData = false;
+ * };
+ * @endcode
+ */
+template<typename SplitType>
+class SplitTraits
+{
+ public:
+  /**
+   * This is true if SplitIfBetter() does not use the random number generator,
+   * so that it gives the same result every time it is called on the same
+   * points, and if the bestGain argument only decides whether or not a split is
+   * returned (the returned gain and split are the same as for any smaller
+   * bestGain).
+   */
+  static const bool IsDeterministic = false;
+
+  /**
+   * This is true if SplitIfBetter() must be given the points of the node
+   * already sorted in ascending order along the dimension (with the labels and
+   * weights in the same order).  DecisionTree then sorts each numeric dimension
+   * once before training, and keeps the sorted orders of the points of each
+   * node while the nodes are split, instead of sorting the points at every
+   * node.
+   */
+  static const bool UsesPresortedData = false;
+};
+
+/**
+ * The DimensionSelectionTraits class provides compile-time information about a
+ * dimension selection type, in the same way as SplitTraits.
+ */
+template<typename DimensionSelectionType>
+class DimensionSelectionTraits
+{
+ public:
+  /**
+   * This is true if Begin() and Next() do not use the random number generator,
+   * so that every node sees the same dimensions whether or not other nodes were
+   * trained first, and copies of the dimension selector can be used at the
+   * same time.
+   */
+  static const bool IsDeterministic = false;
+};
+
+} // namespace mlpack
+
+#endif
@@ -180,9 +180,11 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   regularizationConstants.fill(0.0);
 
   timers.Start("cross_validation");
-  // Go through each fold.
-  #pragma omp parallel for shared(prunedSequence, regularizationConstants)
-  for (size_t fold = 0; fold < (size_t) folds; fold++)
+  // Go through each fold, in parallel with the executor.  The regularization
+  // constants of each fold are summed after all folds are done, in order, so
+  // that the result does not depend on the threads.
+  arma::mat foldConstants(prunedSequence.size(), folds, arma::fill::zeros);
+  ParallelFor(0, (size_t) folds, [&](const size_t fold)
   {
     // Break up data into train and test sets.
     const size_t start = fold * testSize;
@@ -257,9 +259,9 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
         / (double) cvData.n_cols;
     }
 
-    #pragma omp critical(DTreeCVUpdate)
-    regularizationConstants += cvRegularizationConstants;
-  }
+    foldConstants.col(fold) = cvRegularizationConstants;
+  });
+  regularizationConstants = arma::sum(foldConstants, 1);
   timers.Stop("cross_validation");
 
   double optimalAlpha = -1.0;
@@ -39,6 +39,11 @@ namespace mlpack {
  *   pages = {627--635}
  * }
  * @endcode
+ *
+ * When OpenMP is available and the data is dense, Grow() grows the two
+ * children of each node with at least ParallelGrowCutoff points in separate
+ * tasks.  The children hold disjoint ranges of the dataset (which is
+ * partitioned in place), so the grown tree is the same as with serial growth.
  */
 template<typename MatType = arma::mat,
          typename TagType = int>
@@ -52,6 +57,13 @@ class DTree
   //! The statistic type we are holding.
   typedef typename arma::Col<ElemType> StatType;
 
+  //! Nodes with at least this many points are grown in parallel, if
+  //! ParallelGrow is true.
+  static constexpr size_t ParallelGrowCutoff = 4096;
+  //! Whether the children of a node can be grown at the same time.  Columns of
+  //! a sparse matrix cannot be swapped from different threads.
+  static constexpr bool ParallelGrow = !arma::is_SpMat<MatType>::value;
+
   /**
    * Create an empty density estimation tree.
    */
@@ -352,6 +364,26 @@ class DTree
                    const ElemType splitValue,
                    arma::Col<size_t>& oldFromNew) const;
 
+  /**
+   * Grow the left and right children of the node, storing their alpha values
+   * in leftG and rightG.  A child with at least ParallelGrowCutoff points is
+   * grown in a separate task if ParallelGrow is true.
+   */
+  void GrowChildren(MatType& data,
+                    arma::Col<size_t>& oldFromNew,
+                    const bool useVolReg,
+                    const size_t maxLeafSize,
+                    const size_t minLeafSize,
+                    double& leftG,
+                    double& rightG);
+
+  /**
+   * Return true if a node with the given number of points should create the
+   * threads to grow it in parallel: ParallelGrow is true, the node is large
+   * enough, and we are not already in a parallel region.
+   */
+  static bool GrowInParallel(const size_t count);
+
   void  FillMinMax(const StatType& mins,
                    const StatType& maxs);
 };
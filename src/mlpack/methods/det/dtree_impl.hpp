@@ -579,6 +579,47 @@ size_t DTree<MatType, TagType>::SplitData(
   return left;
 }
 
+// Grow both children of the node.
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::GrowChildren(MatType& data,
+                                           arma::Col<size_t>& oldFromNew,
+                                           const bool useVolReg,
+                                           const size_t maxLeafSize,
+                                           const size_t minLeafSize,
+                                           double& leftG,
+                                           double& rightG)
+{
+  // The children hold disjoint ranges of the dataset, so they can be grown at
+  // the same time; small children are not worth the overhead of a task.
+  if (ParallelGrow && left->End() - left->Start() >= ParallelGrowCutoff)
+  {
+    #pragma omp task default(shared)
+    leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize);
+  }
+  else
+  {
+    leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize);
+  }
+
+  rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize);
+
+  #pragma omp taskwait
+}
+
+// Decide whether to create the threads to grow a node in parallel.
+template<typename MatType, typename TagType>
+bool DTree<MatType, TagType>::GrowInParallel(const size_t count)
+{
+  #ifdef MLPACK_USE_OPENMP
+  // NumThreads() is 1 inside parallel loops, so that nested growth (e.g. of
+  // the trees of cross-validation folds) is serial.
+  return ParallelGrow && count >= ParallelGrowCutoff && NumThreads() > 1;
+  #else
+  (void) count;
+  return false;
+  #endif
+}
+
 // Greedily expand the tree.
 template<typename MatType, typename TagType>
 double DTree<MatType, TagType>::Grow(MatType& data,
@@ -631,10 +672,22 @@ double DTree<MatType, TagType>::Grow(MatType& data,
       left = new DTree(maxValsL, minValsL, start, splitIndex, leftError);
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
-      leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                         minLeafSize);
-      rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                           minLeafSize);
+      // Only the outermost node that is grown in parallel needs to create the
+      // threads that the tasks for its descendants run on.
+      if (GrowInParallel(end - start))
+      {
+        #pragma omp parallel num_threads((int) NumThreads())
+        {
+          #pragma omp single
+          GrowChildren(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+              leftG, rightG);
+        }
+      }
+      else
+      {
+        GrowChildren(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+            leftG, rightG);
+      }
 
       // Store values of R(T~) and |T~|.
       subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
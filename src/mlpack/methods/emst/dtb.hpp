@@ -101,6 +101,10 @@ class DualTreeBoruvka
   //! Connections.
   UnionFind connections;
 
+  //! Disjoint query subtrees that the dual-tree search of each iteration is
+  //! split into, so that they can be traversed in parallel.
+  std::vector<Tree*> subtrees;
+
   //! List of edge nodes.
   arma::Col<size_t> neighborsInComponent;
   //! List of edge nodes.
@@ -189,9 +193,10 @@ class DualTreeBoruvka
 
   /**
    * This function resets the values in the nodes of the tree nearest neighbor
-   * distance, and checks for fully connected nodes.
+   * distance, and checks for fully connected nodes.  If aboveSubtrees is true,
+   * the query subtrees are skipped, because they have already been cleaned.
    */
-  void CleanupHelper(Tree* tree);
+  void CleanupHelper(Tree* tree, const bool aboveSubtrees = false);
 
   /**
    * The values stored in the tree must be reset on each iteration.
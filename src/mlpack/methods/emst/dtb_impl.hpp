@@ -101,6 +101,21 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
   typedef DTBRules<MetricType, Tree> RuleType;
   RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
                  neighborsOutComponent, metric);
+
+  // The dual-tree search of each iteration is split into traversals of
+  // disjoint query subtrees, which run in parallel.  They share the candidate
+  // neighbor of each component, so the candidates are updated under a set of
+  // locks.
+  subtrees.clear();
+  if (!naive)
+  {
+    subtrees = SplitQueryTree(*tree,
+        NumParallelTasks(tree->NumDescendants()));
+  }
+  std::vector<std::mutex> candidateLocks((subtrees.size() > 1) ? 1024 : 0);
+
+  size_t baseCases = 0;
+  size_t scores = 0;
   while (edges.size() < (data.n_cols - 1))
   {
     if (naive)
@@ -112,8 +127,23 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     }
     else
     {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
+      ParallelDualTreeTraversal(subtrees,
+          [&](Tree& queryNode)
+          {
+            MetricType subtreeMetric(metric);
+            RuleType subtreeRules(data, connections, neighborsDistances,
+                neighborsInComponent, neighborsOutComponent, subtreeMetric,
+                candidateLocks.empty() ? NULL : &candidateLocks);
+            typename Tree::template DualTreeTraverser<RuleType>
+                traverser(subtreeRules);
+            traverser.Traverse(queryNode, *tree);
+
+            #pragma omp critical
+            {
+              baseCases += subtreeRules.BaseCases();
+              scores += subtreeRules.Scores();
+            }
+          });
     }
 
     AddAllEdges();
@@ -123,8 +153,8 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     Log::Info << edges.size() << " edges found so far." << std::endl;
     if (!naive)
     {
-      Log::Info << rules.BaseCases() << " cumulative base cases." << std::endl;
-      Log::Info << rules.Scores() << " cumulative node combinations scored."
+      Log::Info << baseCases << " cumulative base cases." << std::endl;
+      Log::Info << scores << " cumulative node combinations scored."
           << std::endl;
     }
   }
@@ -249,8 +279,14 @@ template<
     template<typename TreeMetricType,
              typename TreeStatType,
              typename TreeMatType> class TreeType>
-void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
+void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(
+    Tree* tree,
+    const bool aboveSubtrees)
 {
+  if (aboveSubtrees &&
+      std::find(subtrees.begin(), subtrees.end(), tree) != subtrees.end())
+    return;
+
   // Reset the statistic information.
   tree->Stat().MaxNeighborDistance() = DBL_MAX;
   tree->Stat().MinNeighborDistance() = DBL_MAX;
@@ -258,7 +294,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
 
   // Recurse into all children.
   for (size_t i = 0; i < tree->NumChildren(); ++i)
-    CleanupHelper(&tree->Child(i));
+    CleanupHelper(&tree->Child(i), aboveSubtrees);
 
   // Get the component of the first child or point.  Then we will check to see
   // if all other components of children and points are the same.
@@ -294,8 +330,18 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::Cleanup()
   for (size_t i = 0; i < data.n_cols; ++i)
     neighborsDistances[i] = DBL_MAX;
 
-  if (!naive)
-    CleanupHelper(tree);
+  if (naive)
+    return;
+
+  // The query subtrees are cleaned in parallel, and then the nodes above them,
+  // whose components depend on the components of the subtrees.
+  #pragma omp parallel for schedule(dynamic) if (subtrees.size() > 1) \
+      num_threads((int) NumThreads())
+  for (size_t i = 0; i < subtrees.size(); ++i)
+    CleanupHelper(subtrees[i]);
+
+  if (subtrees.size() > 1)
+    CleanupHelper(tree, true);
 }
 
 } // namespace mlpack
@@ -16,18 +16,40 @@
 
 #include <mlpack/core/tree/traversal_info.hpp>
 
+#include <mutex>
+
 namespace mlpack {
 
 template<typename MetricType, typename TreeType>
 class DTBRules
 {
  public:
+  /**
+   * Construct the rules.  If several traversals of disjoint query subtrees use
+   * the same candidate neighbors at the same time (one DTBRules object for
+   * each), they must all be given the same candidate locks: each candidate is
+   * then updated while holding the lock of its component, and read
+   * atomically.
+   *
+   * @param dataSet The data points.
+   * @param connections The components found so far.
+   * @param neighborsDistances Distance to the candidate neighbor of each
+   *     component.
+   * @param neighborsInComponent Endpoint in the component of the candidate
+   *     edge of each component.
+   * @param neighborsOutComponent Endpoint outside of the component of the
+   *     candidate edge of each component.
+   * @param metric The instantiated metric.
+   * @param candidateLocks Locks of the candidates, or NULL if no other
+   *     traversal runs at the same time.
+   */
   DTBRules(const arma::mat& dataSet,
            UnionFind& connections,
            arma::vec& neighborsDistances,
            arma::Col<size_t>& neighborsInComponent,
            arma::Col<size_t>& neighborsOutComponent,
-           MetricType& metric);
+           MetricType& metric,
+           std::vector<std::mutex>* candidateLocks = NULL);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
@@ -117,11 +139,26 @@ class DTBRules
   //! The instantiated metric.
   MetricType& metric;
 
+  //! Locks of the candidates, if other traversals update them concurrently.
+  std::vector<std::mutex>* candidateLocks;
+
   /**
    * Update the bound for the given query node.
    */
   inline double CalculateBound(TreeType& queryNode) const;
 
+  //! Get the distance to the candidate neighbor of the given component.
+  inline double NeighborDistance(const size_t component) const;
+
+  /**
+   * Make the given edge the candidate of the given component, if it is still
+   * shorter than the current candidate.
+   */
+  inline void UpdateNeighbor(const size_t component,
+                             const size_t queryIndex,
+                             const size_t referenceIndex,
+                             const double distance);
+
   TraversalInfoType traversalInfo;
 
   //! The number of base cases calculated.
@@ -21,7 +21,8 @@ DTBRules(const arma::mat& dataSet,
          arma::vec& neighborsDistances,
          arma::Col<size_t>& neighborsInComponent,
          arma::Col<size_t>& neighborsOutComponent,
-         MetricType& metric)
+         MetricType& metric,
+         std::vector<std::mutex>* candidateLocks)
 :
   dataSet(dataSet),
   connections(connections),
@@ -29,6 +30,7 @@ DTBRules(const arma::mat& dataSet,
   neighborsInComponent(neighborsInComponent),
   neighborsOutComponent(neighborsOutComponent),
   metric(metric),
+  candidateLocks(candidateLocks),
   baseCases(0),
   scores(0)
 {
@@ -56,18 +58,18 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
     double distance = metric.Evaluate(dataSet.col(queryIndex),
                                       dataSet.col(referenceIndex));
 
-    if (distance < neighborsDistances[queryComponentIndex])
+    if (distance < NeighborDistance(queryComponentIndex))
     {
       Log::Assert(queryIndex != referenceIndex);
 
-      neighborsDistances[queryComponentIndex] = distance;
-      neighborsInComponent[queryComponentIndex] = queryIndex;
-      neighborsOutComponent[queryComponentIndex] = referenceIndex;
+      UpdateNeighbor(queryComponentIndex, queryIndex, referenceIndex,
+          distance);
     }
   }
 
-  if (newUpperBound < neighborsDistances[queryComponentIndex])
-    newUpperBound = neighborsDistances[queryComponentIndex];
+  const double neighborDistance = NeighborDistance(queryComponentIndex);
+  if (newUpperBound < neighborDistance)
+    newUpperBound = neighborDistance;
 
   Log::Assert(newUpperBound >= 0.0);
 
@@ -92,7 +94,7 @@ double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for the query's component, we prune.
-  return neighborsDistances[queryComponentIndex] < distance
+  return NeighborDistance(queryComponentIndex) < distance
       ? DBL_MAX : distance;
 }
 
@@ -103,7 +105,7 @@ double DTBRules<MetricType, TreeType>::Rescore(const size_t queryIndex,
 {
   // We don't need to check component membership again, because it can't
   // change inside a single iteration.
-  return (oldScore > neighborsDistances[connections.Find(queryIndex)])
+  return (oldScore > NeighborDistance(connections.Find(queryIndex)))
       ? DBL_MAX : oldScore;
 }
 
@@ -152,7 +154,7 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
     const size_t pointComponent = connections.Find(queryNode.Point(i));
-    const double bound = neighborsDistances[pointComponent];
+    const double bound = NeighborDistance(pointComponent);
 
     if (bound > worstPointBound)
       worstPointBound = bound;
@@ -187,6 +189,45 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   return queryNode.Stat().Bound();
 }
 
+template<typename MetricType, typename TreeType>
+inline double DTBRules<MetricType, TreeType>::NeighborDistance(
+    const size_t component) const
+{
+  // Other traversals may be writing the distance at the same time.
+  double distance;
+  #pragma omp atomic read
+  distance = neighborsDistances[component];
+  return distance;
+}
+
+template<typename MetricType, typename TreeType>
+inline void DTBRules<MetricType, TreeType>::UpdateNeighbor(
+    const size_t component,
+    const size_t queryIndex,
+    const size_t referenceIndex,
+    const double distance)
+{
+  if (candidateLocks == NULL)
+  {
+    neighborsDistances[component] = distance;
+    neighborsInComponent[component] = queryIndex;
+    neighborsOutComponent[component] = referenceIndex;
+    return;
+  }
+
+  // Another traversal may have found a closer neighbor for the component since
+  // the distance was checked.
+  std::lock_guard<std::mutex> lock(
+      (*candidateLocks)[component % candidateLocks->size()]);
+  if (distance < neighborsDistances[component])
+  {
+    #pragma omp atomic write
+    neighborsDistances[component] = distance;
+    neighborsInComponent[component] = queryIndex;
+    neighborsOutComponent[component] = referenceIndex;
+  }
+}
+
 } // namespace mlpack
 
 #endif
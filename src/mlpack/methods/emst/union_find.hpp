@@ -17,6 +17,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <atomic>
+
 namespace mlpack {
 
 /**
@@ -25,11 +27,15 @@ namespace mlpack {
  * initially in its own component.  Calling Union(x, y) unites the components
  * indexed by x and y.  Find(x) returns the index of the component containing
  * point x.
+ *
+ * Find() and ConcurrentUnion() may be called by several threads at once; the
+ * parents are atomic, so that paths can be compressed and components united
+ * without locks.  Union() must not run at the same time as any other call.
  */
 class UnionFind
 {
  private:
-  arma::Col<size_t> parent;
+  std::vector<std::atomic<size_t>> parent;
   arma::ivec rank;
 
  public:
@@ -38,7 +44,7 @@ class UnionFind
   {
     for (size_t i = 0; i < size; ++i)
     {
-      parent[i] = i;
+      parent[i].store(i, std::memory_order_relaxed);
       rank[i] = 0;
     }
   }
@@ -47,23 +53,25 @@ class UnionFind
   ~UnionFind() { }
 
   /**
-   * Returns the component containing an element.
+   * Returns the component containing an element.  The path compression only
+   * ever points an element closer to its root, so this may be called by
+   * several threads at once, and while other threads call ConcurrentUnion().
    *
    * @param x the component to be found
    * @return The index of the component containing x
    */
   size_t Find(const size_t x)
   {
-    if (parent[x] == x)
-    {
+    const size_t xParent = parent[x].load(std::memory_order_relaxed);
+    if (xParent == x)
       return x;
-    }
-    else
-    {
-      // This ensures that the tree has a small depth.
-      parent[x] = Find(parent[x]);
-      return parent[x];
-    }
+
+    // This ensures that the tree has a small depth.
+    const size_t root = Find(xParent);
+    if (root != xParent)
+      parent[x].store(root, std::memory_order_relaxed);
+
+    return root;
   }
 
   /**
@@ -83,16 +91,46 @@ class UnionFind
     }
     else if (rank[xRoot] == rank[yRoot])
     {
-      parent[yRoot] = parent[xRoot];
+      parent[yRoot].store(xRoot, std::memory_order_relaxed);
       rank[xRoot] = rank[xRoot] + 1;
     }
     else if (rank[xRoot] > rank[yRoot])
     {
-      parent[yRoot] = xRoot;
+      parent[yRoot].store(xRoot, std::memory_order_relaxed);
     }
     else
     {
-      parent[xRoot] = yRoot;
+      parent[xRoot].store(yRoot, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * Union the components containing x and y, while other threads may call
+   * Find() and ConcurrentUnion().  The root with the larger index is linked
+   * below the root with the smaller index with a compare-and-swap, which fails
+   * if another thread has linked it first; then the roots are found again.
+   * Because roots are always linked towards smaller indices, concurrent calls
+   * can't create a cycle.  Ranks are not used, so the trees may be deeper than
+   * with Union(), but the path compression of Find() keeps them shallow.
+   *
+   * @param x one component
+   * @param y the other component
+   */
+  void ConcurrentUnion(const size_t x, const size_t y)
+  {
+    while (true)
+    {
+      size_t xRoot = Find(x);
+      size_t yRoot = Find(y);
+      if (xRoot == yRoot)
+        return;
+
+      if (xRoot < yRoot)
+        std::swap(xRoot, yRoot);
+
+      size_t expected = xRoot;
+      if (parent[xRoot].compare_exchange_weak(expected, yRoot))
+        return;
     }
   }
 }; // class UnionFind
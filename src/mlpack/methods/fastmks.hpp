@@ -12,5 +12,6 @@
 #define MLPACK_FASTMKS_HPP
 
 #include "fastmks/fastmks.hpp"
+#include "fastmks/cone_search.hpp"
 
 #endif
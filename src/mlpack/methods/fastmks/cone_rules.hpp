@@ -0,0 +1,190 @@
+/**
+ * @file methods/fastmks/cone_rules.hpp
+ *
+ * Rules for maximum inner product and maximum cosine similarity search with
+ * cone bounds, for trees whose statistic is ConeStat.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_FASTMKS_CONE_RULES_HPP
+#define MLPACK_METHODS_FASTMKS_CONE_RULES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/traversal_info.hpp>
+
+#include "cone_stat.hpp"
+
+namespace mlpack {
+
+/**
+ * The ConeRules class is a template helper class used by the ConeSearch class
+ * when searching for the reference points with the largest similarity to each
+ * query point.  For each query point, it keeps track of the k best candidates.
+ * Nodes are bounded with the cones held in their ConeStat: no point of a
+ * reference node makes an angle with a query point smaller than the angle
+ * between the query point and the direction of the node, minus the radius of
+ * the node (and likewise between two nodes).
+ *
+ * @tparam SimilarityType Similarity to maximize (InnerProductSimilarity or
+ *     CosineSimilarity).
+ * @tparam TreeType Type of tree to search with; its statistic must be
+ *     ConeStat.
+ */
+template<typename SimilarityType, typename TreeType>
+class ConeRules
+{
+ public:
+  //! The type of the data.
+  typedef typename TreeType::Mat MatType;
+
+  /**
+   * Construct the ConeRules object.  This is usually done from within the
+   * ConeSearch class at search time.  If the query set and the reference set
+   * are the same object, a point is never returned as its own candidate.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param k Number of candidates to search for.
+   */
+  ConeRules(const MatType& referenceSet,
+            const MatType& querySet,
+            const size_t k);
+
+  /**
+   * Store the list of candidates for each query point in the given matrices,
+   * best first.
+   *
+   * @param indices Matrix storing lists of candidate for each query point.
+   * @param similarities Matrix storing the similarity of each candidate.
+   */
+  void GetResults(arma::Mat<size_t>& indices, arma::mat& similarities);
+
+  //! Compute the base case (similarity) between two points.
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  /**
+   * Get the score for recursion order.  A low score indicates priority for
+   * recursion, while DBL_MAX indicates that the node should not be recursed
+   * into at all (it should be pruned).
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate to be recursed into.
+   */
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  /**
+   * Get the score for recursion order.  A low score indicates priority for
+   * recursion, while DBL_MAX indicates that the node should not be recursed
+   * into at all (it should be pruned).
+   *
+   * @param queryNode Candidate query node to be recursed into.
+   * @param referenceNode Candidate reference node to be recursed into.
+   */
+  double Score(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order, against the candidates that may
+   * have been found since the score was computed.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  /**
+   * Re-evaluate the score for recursion order, against the candidates that may
+   * have been found since the score was computed.
+   *
+   * @param queryNode Candidate query node to be recursed into.
+   * @param referenceNode Candidate reference node to be recursed into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  //! Get the number of times BaseCase() was called.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of times Score() was called.
+  size_t Scores() const { return scores; }
+
+  typedef typename mlpack::TraversalInfo<TreeType> TraversalInfoType;
+
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the minimum number of base cases we need to perform to have acceptable
+  //! results.
+  size_t MinimumBaseCases() const { return k; }
+
+ private:
+  //! The reference dataset.
+  const MatType& referenceSet;
+  //! The query dataset.
+  const MatType& querySet;
+
+  //! Candidate represents a possible candidate point (value, index).
+  typedef std::pair<double, size_t> Candidate;
+
+  //! Compare two candidates based on the value.
+  struct CandidateCmp {
+    bool operator()(const Candidate& c1, const Candidate& c2) const
+    {
+      return c1.first > c2.first;
+    };
+  };
+
+  //! Set of candidates for each point.  We use a min-heap built on a
+  //! std::vector to represent the list of candidate points for each query
+  //! point.
+  std::vector<std::vector<Candidate>> candidates;
+
+  //! Number of points to search for.
+  const size_t k;
+
+  //! The norm of each query point.
+  arma::vec queryNorms;
+  //! The norm of each reference point.
+  arma::vec referenceNorms;
+  //! The direction of each query point (zero for a zero point).
+  arma::mat queryDirections;
+
+  //! The number of times BaseCase() was called.
+  size_t baseCases;
+  //! The number of times Score() was called.
+  size_t scores;
+
+  TraversalInfoType traversalInfo;
+
+  //! Return the cosine of the smallest angle between the given query point and
+  //! any point of the given node.
+  double MaxCosine(const size_t queryIndex, const TreeType& referenceNode)
+      const;
+
+  //! Return the cosine of the smallest angle between any two points of the
+  //! given nodes.
+  double MaxCosine(const TreeType& queryNode, const TreeType& referenceNode)
+      const;
+
+  //! Calculate the bound of the given query node: the smallest similarity that
+  //! could improve the candidates of one of its points.
+  double CalculateBound(TreeType& queryNode) const;
+
+  //! Insert a candidate into the list of candidate points of a query point.
+  void InsertNeighbor(const size_t queryIndex,
+                      const size_t index,
+                      const double similarity);
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "cone_rules_impl.hpp"
+
+#endif
@@ -0,0 +1,243 @@
+/**
+ * @file methods/fastmks/cone_rules_impl.hpp
+ *
+ * Implementation of ConeRules, for search with cone bounds.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_FASTMKS_CONE_RULES_IMPL_HPP
+#define MLPACK_METHODS_FASTMKS_CONE_RULES_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "cone_rules.hpp"
+
+namespace mlpack {
+
+template<typename SimilarityType, typename TreeType>
+ConeRules<SimilarityType, TreeType>::ConeRules(
+    const MatType& referenceSet,
+    const MatType& querySet,
+    const size_t k) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    k(k),
+    baseCases(0),
+    scores(0)
+{
+  // Precompute the norms, and the directions of the query points.
+  referenceNorms.set_size(referenceSet.n_cols);
+  for (size_t i = 0; i < referenceSet.n_cols; ++i)
+    referenceNorms[i] = arma::norm(referenceSet.col(i), 2);
+
+  queryNorms.set_size(querySet.n_cols);
+  queryDirections.zeros(querySet.n_rows, querySet.n_cols);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    queryNorms[i] = arma::norm(querySet.col(i), 2);
+    if (queryNorms[i] > 0.0)
+    {
+      queryDirections.col(i) = arma::conv_to<arma::vec>::from(
+          querySet.col(i)) / queryNorms[i];
+    }
+  }
+
+  // Each list of candidates starts with k invalid candidates, which are
+  // replaced as points are visited in BaseCase().
+  const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+
+  std::vector<Candidate> pqueue(k, def);
+  std::make_heap(pqueue.begin(), pqueue.end(), CandidateCmp());
+  candidates = std::vector<std::vector<Candidate>>(querySet.n_cols, pqueue);
+}
+
+template<typename SimilarityType, typename TreeType>
+void ConeRules<SimilarityType, TreeType>::GetResults(
+    arma::Mat<size_t>& indices,
+    arma::mat& similarities)
+{
+  indices.set_size(k, querySet.n_cols);
+  similarities.set_size(k, querySet.n_cols);
+
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    std::vector<Candidate>& pqueue = candidates[i];
+    std::sort_heap(pqueue.begin(), pqueue.end(), CandidateCmp());
+    for (size_t j = 0; j < k; ++j)
+    {
+      indices(j, i) = pqueue[j].second;
+      similarities(j, i) = pqueue[j].first;
+    }
+  }
+}
+
+template<typename SimilarityType, typename TreeType>
+inline mlpack_force_inline
+double ConeRules<SimilarityType, TreeType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  // A point is not its own candidate in monochromatic search.
+  if ((&querySet == &referenceSet) && (queryIndex == referenceIndex))
+    return 0.0;
+
+  ++baseCases;
+  const double similarity = SimilarityType::Evaluate(
+      querySet.col(queryIndex), referenceSet.col(referenceIndex),
+      queryNorms[queryIndex], referenceNorms[referenceIndex]);
+
+  InsertNeighbor(queryIndex, referenceIndex, similarity);
+
+  return similarity;
+}
+
+template<typename SimilarityType, typename TreeType>
+double ConeRules<SimilarityType, TreeType>::Score(const size_t queryIndex,
+                                                  TreeType& referenceNode)
+{
+  ++scores;
+  const double bestSimilarity = candidates[queryIndex].front().first;
+  const ConeStat& stat = referenceNode.Stat();
+  const double maxSimilarity = SimilarityType::Bound(
+      MaxCosine(queryIndex, referenceNode), queryNorms[queryIndex],
+      queryNorms[queryIndex], stat.MinNorm(), stat.MaxNorm());
+
+  // We return the negated bound so that nodes with larger bounds are recursed
+  // into first.
+  return (maxSimilarity >= bestSimilarity) ? -maxSimilarity : DBL_MAX;
+}
+
+template<typename SimilarityType, typename TreeType>
+double ConeRules<SimilarityType, TreeType>::Score(TreeType& queryNode,
+                                                  TreeType& referenceNode)
+{
+  // Update and get the query node's bound.
+  queryNode.Stat().Bound() = CalculateBound(queryNode);
+  const double bestSimilarity = queryNode.Stat().Bound();
+
+  ++scores;
+  const ConeStat& queryStat = queryNode.Stat();
+  const ConeStat& referenceStat = referenceNode.Stat();
+  const double maxSimilarity = SimilarityType::Bound(
+      MaxCosine(queryNode, referenceNode), queryStat.MinNorm(),
+      queryStat.MaxNorm(), referenceStat.MinNorm(), referenceStat.MaxNorm());
+
+  return (maxSimilarity >= bestSimilarity) ? -maxSimilarity : DBL_MAX;
+}
+
+template<typename SimilarityType, typename TreeType>
+double ConeRules<SimilarityType, TreeType>::Rescore(
+    const size_t queryIndex,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  if (oldScore == DBL_MAX)
+    return oldScore;
+
+  const double bestSimilarity = candidates[queryIndex].front().first;
+  return (-oldScore >= bestSimilarity) ? oldScore : DBL_MAX;
+}
+
+template<typename SimilarityType, typename TreeType>
+double ConeRules<SimilarityType, TreeType>::Rescore(
+    TreeType& queryNode,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  if (oldScore == DBL_MAX)
+    return oldScore;
+
+  queryNode.Stat().Bound() = CalculateBound(queryNode);
+  const double bestSimilarity = queryNode.Stat().Bound();
+  return (-oldScore >= bestSimilarity) ? oldScore : DBL_MAX;
+}
+
+template<typename SimilarityType, typename TreeType>
+double ConeRules<SimilarityType, TreeType>::MaxCosine(
+    const size_t queryIndex,
+    const TreeType& referenceNode) const
+{
+  const ConeStat& stat = referenceNode.Stat();
+
+  // A zero query point, or a cone that may hold any direction, can make any
+  // angle with the points of the node.
+  if (queryNorms[queryIndex] == 0.0 || stat.Radius() >= M_PI)
+    return 1.0;
+
+  const double angle = ConeStat::Angle(stat.Direction(),
+      queryDirections.col(queryIndex)) - stat.Radius();
+  return (angle <= 0.0) ? 1.0 : std::cos(angle);
+}
+
+template<typename SimilarityType, typename TreeType>
+double ConeRules<SimilarityType, TreeType>::MaxCosine(
+    const TreeType& queryNode,
+    const TreeType& referenceNode) const
+{
+  const ConeStat& queryStat = queryNode.Stat();
+  const ConeStat& referenceStat = referenceNode.Stat();
+  if (queryStat.Radius() + referenceStat.Radius() >= M_PI)
+    return 1.0;
+
+  const double angle = ConeStat::Angle(queryStat.Direction(),
+      referenceStat.Direction()) - queryStat.Radius() - referenceStat.Radius();
+  return (angle <= 0.0) ? 1.0 : std::cos(angle);
+}
+
+/**
+ * Calculate the bound for the given query node.  This bound represents the
+ * minimum similarity which a node combination must achieve to guarantee an
+ * improvement in the results: the worst kth candidate of the points of the
+ * node and the bounds of its children (which can only be lower than their
+ * current values), or the bound of its parent if that is larger.
+ */
+template<typename SimilarityType, typename TreeType>
+double ConeRules<SimilarityType, TreeType>::CalculateBound(
+    TreeType& queryNode) const
+{
+  double worstSimilarity = DBL_MAX;
+  for (size_t i = 0; i < queryNode.NumPoints(); ++i)
+  {
+    worstSimilarity = std::min(worstSimilarity,
+        candidates[queryNode.Point(i)].front().first);
+  }
+
+  for (size_t i = 0; i < queryNode.NumChildren(); ++i)
+    worstSimilarity = std::min(worstSimilarity,
+        queryNode.Child(i).Stat().Bound());
+
+  const double parentBound = (queryNode.Parent() == NULL) ? -DBL_MAX :
+      queryNode.Parent()->Stat().Bound();
+
+  return std::max(worstSimilarity, parentBound);
+}
+
+/**
+ * Helper function to insert a point into the list of candidate points.
+ *
+ * @param queryIndex Index of point whose neighbors we are inserting into.
+ * @param index Index of reference point which is being inserted.
+ * @param similarity Similarity of the given candidate.
+ */
+template<typename SimilarityType, typename TreeType>
+inline void ConeRules<SimilarityType, TreeType>::InsertNeighbor(
+    const size_t queryIndex,
+    const size_t index,
+    const double similarity)
+{
+  std::vector<Candidate>& pqueue = candidates[queryIndex];
+  if (similarity > pqueue.front().first)
+  {
+    Candidate c = std::make_pair(similarity, index);
+    std::pop_heap(pqueue.begin(), pqueue.end(), CandidateCmp());
+    pqueue.pop_back();
+    pqueue.push_back(c);
+    std::push_heap(pqueue.begin(), pqueue.end(), CandidateCmp());
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,185 @@
+/**
+ * @file methods/fastmks/cone_search.hpp
+ *
+ * Definition of the ConeSearch class, which implements exact maximum inner
+ * product and maximum cosine similarity search with cone trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_FASTMKS_CONE_SEARCH_HPP
+#define MLPACK_METHODS_FASTMKS_CONE_SEARCH_HPP
+
+#include <mlpack/core.hpp>
+
+#include "cone_similarity.hpp"
+#include "cone_stat.hpp"
+#include "cone_rules.hpp"
+
+namespace mlpack {
+
+/**
+ * An implementation of exact maximum inner product search (MIPS) and maximum
+ * cosine similarity search with cone trees.  For each query point, this finds
+ * the k reference points with the largest inner product (or cosine
+ * similarity).  The tree is a BinarySpaceTree whose nodes hold a ConeStat, the
+ * cone that contains their points; the cones give much tighter bounds on inner
+ * products than the distance bounds of the tree, and unlike FastMKS with the
+ * linear kernel, the data does not need to be normalized for the cosine
+ * similarity.
+ *
+ * For more information on cone trees, see the following paper.
+ *
+ * @code
+ * @inproceedings{ram2012maximum,
+ *   title={Maximum Inner-Product Search Using Cone Trees},
+ *   author={Ram, Parikshit and Gray, Alexander G.},
+ *   booktitle={Proceedings of the 18th ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining (KDD '12)},
+ *   pages={931--939},
+ *   year={2012}
+ * }
+ * @endcode
+ *
+ * @tparam SimilarityType Similarity to maximize (InnerProductSimilarity or
+ *     CosineSimilarity).
+ * @tparam MatType Type of data to use.
+ * @tparam TreeType Type of tree to use; a BinarySpaceTree type such as KDTree
+ *     or BallTree.
+ */
+template<typename SimilarityType = InnerProductSimilarity,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = KDTree>
+class ConeSearch
+{
+ public:
+  //! Convenience typedef.
+  typedef TreeType<EuclideanDistance, ConeStat, MatType> Tree;
+
+  /**
+   * Create the ConeSearch object without a reference set.  Train() must be
+   * called before Search().
+   *
+   * @param singleMode Whether single-tree search should be used (as opposed to
+   *     dual-tree search).
+   * @param naive Whether brute-force search should be used.
+   */
+  ConeSearch(const bool singleMode = false, const bool naive = false);
+
+  /**
+   * Create the ConeSearch object with the given reference set, and build the
+   * tree on it (unless naive search is used).
+   *
+   * @param referenceSet Set of reference data.
+   * @param singleMode Whether single-tree search should be used (as opposed to
+   *     dual-tree search).
+   * @param naive Whether brute-force search should be used.
+   */
+  ConeSearch(MatType referenceSet,
+             const bool singleMode = false,
+             const bool naive = false);
+
+  //! ConeSearch objects cannot be copied.
+  ConeSearch(const ConeSearch& other) = delete;
+
+  //! Take ownership of the given model.
+  ConeSearch(ConeSearch&& other);
+
+  //! ConeSearch objects cannot be copied.
+  ConeSearch& operator=(const ConeSearch& other) = delete;
+
+  //! Take ownership of the given model.
+  ConeSearch& operator=(ConeSearch&& other);
+
+  //! Destroy the ConeSearch object and its tree.
+  ~ConeSearch();
+
+  /**
+   * Set the reference set, and build the tree on it (unless naive search is
+   * used).
+   *
+   * @param referenceSet Set of reference data.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Search for the k reference points with the largest similarity to each
+   * point of the query set.  The results are sorted by decreasing similarity.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of points to search for.
+   * @param indices Matrix to store the indices of the results in (k x number
+   *     of query points).
+   * @param similarities Matrix to store the similarities of the results in.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& indices,
+              arma::mat& similarities);
+
+  /**
+   * Search for the k other reference points with the largest similarity to
+   * each reference point.  A point is never returned in its own results.
+   *
+   * @param k Number of points to search for.
+   * @param indices Matrix to store the indices of the results in (k x number
+   *     of reference points).
+   * @param similarities Matrix to store the similarities of the results in.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& indices,
+              arma::mat& similarities);
+
+  //! Get the reference set (in the order of the tree, if there is one).
+  const MatType& ReferenceSet() const;
+  //! Get the reference tree (or NULL in naive mode).
+  Tree* ReferenceTree() { return referenceTree; }
+
+  //! Get whether single-tree search is used.
+  bool SingleMode() const { return singleMode; }
+  //! Modify whether single-tree search is used.
+  bool& SingleMode() { return singleMode; }
+
+  //! Get whether brute-force search is used.  This must be set before
+  //! Train().
+  bool Naive() const { return naive; }
+  //! Modify whether brute-force search is used.
+  bool& Naive() { return naive; }
+
+  //! Get the number of base cases of the last search.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of scores of the last search.
+  size_t Scores() const { return scores; }
+
+ private:
+  //! The reference set, in naive mode.
+  MatType naiveReferenceSet;
+  //! The reference tree, unless in naive mode.
+  Tree* referenceTree;
+  //! Mappings to the original indices of the reference points.
+  std::vector<size_t> oldFromNewReferences;
+
+  //! Whether single-tree search is used.
+  bool singleMode;
+  //! Whether brute-force search is used.
+  bool naive;
+
+  //! The number of base cases of the last search.
+  size_t baseCases;
+  //! The number of scores of the last search.
+  size_t scores;
+
+  //! Reset the dual-tree bounds of the given node and its descendants.
+  static void ResetBounds(Tree& node);
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "cone_search_impl.hpp"
+
+#endif
@@ -0,0 +1,321 @@
+/**
+ * @file methods/fastmks/cone_search_impl.hpp
+ *
+ * Implementation of the ConeSearch class, for exact maximum inner product and
+ * maximum cosine similarity search with cone trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_FASTMKS_CONE_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_FASTMKS_CONE_SEARCH_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "cone_search.hpp"
+
+namespace mlpack {
+
+template<typename SimilarityType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ConeSearch<SimilarityType, MatType, TreeType>::ConeSearch(
+    const bool singleMode,
+    const bool naive) :
+    referenceTree(NULL),
+    singleMode(singleMode),
+    naive(naive),
+    baseCases(0),
+    scores(0)
+{
+  // Nothing to do.
+}
+
+template<typename SimilarityType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ConeSearch<SimilarityType, MatType, TreeType>::ConeSearch(
+    MatType referenceSet,
+    const bool singleMode,
+    const bool naive) :
+    referenceTree(NULL),
+    singleMode(singleMode),
+    naive(naive),
+    baseCases(0),
+    scores(0)
+{
+  Train(std::move(referenceSet));
+}
+
+template<typename SimilarityType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ConeSearch<SimilarityType, MatType, TreeType>::ConeSearch(ConeSearch&& other) :
+    naiveReferenceSet(std::move(other.naiveReferenceSet)),
+    referenceTree(other.referenceTree),
+    oldFromNewReferences(std::move(other.oldFromNewReferences)),
+    singleMode(other.singleMode),
+    naive(other.naive),
+    baseCases(other.baseCases),
+    scores(other.scores)
+{
+  other.referenceTree = NULL;
+  other.oldFromNewReferences.clear();
+  other.baseCases = 0;
+  other.scores = 0;
+}
+
+template<typename SimilarityType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ConeSearch<SimilarityType, MatType, TreeType>&
+ConeSearch<SimilarityType, MatType, TreeType>::operator=(ConeSearch&& other)
+{
+  if (this != &other)
+  {
+    delete referenceTree;
+
+    naiveReferenceSet = std::move(other.naiveReferenceSet);
+    referenceTree = other.referenceTree;
+    oldFromNewReferences = std::move(other.oldFromNewReferences);
+    singleMode = other.singleMode;
+    naive = other.naive;
+    baseCases = other.baseCases;
+    scores = other.scores;
+
+    other.referenceTree = NULL;
+    other.oldFromNewReferences.clear();
+    other.baseCases = 0;
+    other.scores = 0;
+  }
+
+  return *this;
+}
+
+template<typename SimilarityType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ConeSearch<SimilarityType, MatType, TreeType>::~ConeSearch()
+{
+  delete referenceTree;
+}
+
+template<typename SimilarityType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ConeSearch<SimilarityType, MatType, TreeType>::Train(
+    MatType referenceSet)
+{
+  delete referenceTree;
+  referenceTree = NULL;
+  oldFromNewReferences.clear();
+  naiveReferenceSet.reset();
+
+  if (naive)
+  {
+    naiveReferenceSet = std::move(referenceSet);
+  }
+  else
+  {
+    referenceTree = BuildTree<Tree>(std::move(referenceSet),
+        oldFromNewReferences);
+  }
+}
+
+template<typename SimilarityType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+const MatType& ConeSearch<SimilarityType, MatType, TreeType>::ReferenceSet()
+    const
+{
+  return (referenceTree == NULL) ? naiveReferenceSet :
+      referenceTree->Dataset();
+}
+
+template<typename SimilarityType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ConeSearch<SimilarityType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& similarities)
+{
+  const MatType& referenceSet = ReferenceSet();
+  util::CheckSameDimensionality(querySet, referenceSet,
+      "ConeSearch::Search()", "query set");
+
+  if (k > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "ConeSearch::Search(): requested " << k << " results, but there "
+        << "are only " << referenceSet.n_cols << " reference points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  typedef ConeRules<SimilarityType, Tree> RuleType;
+  if (referenceTree == NULL)
+  {
+    // The brute-force solution.
+    RuleType rules(referenceSet, querySet, k);
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      for (size_t j = 0; j < referenceSet.n_cols; ++j)
+        rules.BaseCase(i, j);
+
+    rules.GetResults(indices, similarities);
+    baseCases = rules.BaseCases();
+    scores = 0;
+    return;
+  }
+
+  arma::Mat<size_t> treeIndices;
+  if (singleMode)
+  {
+    RuleType rules(referenceSet, querySet, k);
+    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    rules.GetResults(treeIndices, similarities);
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+
+    indices.set_size(treeIndices.n_rows, treeIndices.n_cols);
+    for (size_t i = 0; i < treeIndices.n_elem; ++i)
+      indices[i] = oldFromNewReferences[treeIndices[i]];
+  }
+  else
+  {
+    // Build the query tree; its points must be mapped back too.
+    std::vector<size_t> oldFromNewQueries;
+    Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+
+    RuleType rules(referenceSet, queryTree->Dataset(), k);
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(*queryTree, *referenceTree);
+
+    arma::mat treeSimilarities;
+    rules.GetResults(treeIndices, treeSimilarities);
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+
+    indices.set_size(treeIndices.n_rows, treeIndices.n_cols);
+    similarities.set_size(treeIndices.n_rows, treeIndices.n_cols);
+    for (size_t i = 0; i < treeIndices.n_cols; ++i)
+    {
+      const size_t queryIndex = oldFromNewQueries[i];
+      for (size_t j = 0; j < treeIndices.n_rows; ++j)
+      {
+        indices(j, queryIndex) = oldFromNewReferences[treeIndices(j, i)];
+        similarities(j, queryIndex) = treeSimilarities(j, i);
+      }
+    }
+
+    delete queryTree;
+  }
+}
+
+template<typename SimilarityType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ConeSearch<SimilarityType, MatType, TreeType>::Search(
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& similarities)
+{
+  const MatType& referenceSet = ReferenceSet();
+  if (k >= referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "ConeSearch::Search(): requested " << k << " results, but there "
+        << "are only " << referenceSet.n_cols << " reference points (including "
+        << "the query point)!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The rules do not return a point as its own result, since the query set and
+  // the reference set are the same object.
+  typedef ConeRules<SimilarityType, Tree> RuleType;
+  RuleType rules(referenceSet, referenceSet, k);
+  if (referenceTree == NULL)
+  {
+    // The brute-force solution.
+    for (size_t i = 0; i < referenceSet.n_cols; ++i)
+      for (size_t j = 0; j < referenceSet.n_cols; ++j)
+        rules.BaseCase(i, j);
+
+    rules.GetResults(indices, similarities);
+    baseCases = rules.BaseCases();
+    scores = 0;
+    return;
+  }
+
+  if (singleMode)
+  {
+    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    for (size_t i = 0; i < referenceSet.n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+  }
+  else
+  {
+    // The reference tree is the query tree, so the bounds of its nodes may be
+    // left from an earlier search.
+    ResetBounds(*referenceTree);
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(*referenceTree, *referenceTree);
+  }
+
+  arma::Mat<size_t> treeIndices;
+  arma::mat treeSimilarities;
+  rules.GetResults(treeIndices, treeSimilarities);
+  baseCases = rules.BaseCases();
+  scores = rules.Scores();
+
+  // Map the query and reference indices back.
+  indices.set_size(treeIndices.n_rows, treeIndices.n_cols);
+  similarities.set_size(treeIndices.n_rows, treeIndices.n_cols);
+  for (size_t i = 0; i < treeIndices.n_cols; ++i)
+  {
+    const size_t queryIndex = oldFromNewReferences[i];
+    for (size_t j = 0; j < treeIndices.n_rows; ++j)
+    {
+      indices(j, queryIndex) = oldFromNewReferences[treeIndices(j, i)];
+      similarities(j, queryIndex) = treeSimilarities(j, i);
+    }
+  }
+}
+
+template<typename SimilarityType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ConeSearch<SimilarityType, MatType, TreeType>::ResetBounds(Tree& node)
+{
+  node.Stat().Bound() = -DBL_MAX;
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    ResetBounds(node.Child(i));
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * @file methods/fastmks/cone_similarity.hpp
+ *
+ * The similarities that ConeSearch can search for: the inner product and the
+ * cosine similarity.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_FASTMKS_CONE_SIMILARITY_HPP
+#define MLPACK_METHODS_FASTMKS_CONE_SIMILARITY_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * The inner product, for maximum inner product search.  A similarity for
+ * ConeSearch provides Evaluate(), given the two vectors and their norms, and
+ * Bound(), an upper bound on the similarity of two vectors given the cosine
+ * of the smallest angle they can make and the ranges of their norms.
+ */
+class InnerProductSimilarity
+{
+ public:
+  //! Return the inner product of the two given vectors.
+  template<typename VecTypeA, typename VecTypeB>
+  static double Evaluate(const VecTypeA& a,
+                         const VecTypeB& b,
+                         const double /* aNorm */,
+                         const double /* bNorm */)
+  {
+    return arma::dot(a, b);
+  }
+
+  /**
+   * Return an upper bound on the inner product of two vectors whose angle is
+   * at least the angle with the given cosine, and whose norms are in the given
+   * ranges.
+   */
+  static double Bound(const double cosAngle,
+                      const double minNormA,
+                      const double maxNormA,
+                      const double minNormB,
+                      const double maxNormB)
+  {
+    // A negative inner product is largest for the shortest vectors.
+    return (cosAngle >= 0.0) ? maxNormA * maxNormB * cosAngle :
+        minNormA * minNormB * cosAngle;
+  }
+};
+
+/**
+ * The cosine similarity, for maximum cosine similarity (or smallest angle)
+ * search.  The cosine similarity of a vector with a norm of zero is taken to
+ * be zero.
+ */
+class CosineSimilarity
+{
+ public:
+  //! Return the cosine similarity of the two given vectors.
+  template<typename VecTypeA, typename VecTypeB>
+  static double Evaluate(const VecTypeA& a,
+                         const VecTypeB& b,
+                         const double aNorm,
+                         const double bNorm)
+  {
+    if (aNorm == 0.0 || bNorm == 0.0)
+      return 0.0;
+
+    return arma::dot(a, b) / (aNorm * bNorm);
+  }
+
+  /**
+   * Return an upper bound on the cosine similarity of two vectors whose angle
+   * is at least the angle with the given cosine, and whose norms are in the
+   * given ranges.
+   */
+  static double Bound(const double cosAngle,
+                      const double minNormA,
+                      const double /* maxNormA */,
+                      const double minNormB,
+                      const double /* maxNormB */)
+  {
+    // Vectors with a norm of zero have a similarity of zero.
+    return (minNormA == 0.0 || minNormB == 0.0) ? std::max(cosAngle, 0.0) :
+        cosAngle;
+  }
+};
+
+} // namespace mlpack
+
+#endif
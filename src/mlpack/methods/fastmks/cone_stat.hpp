@@ -0,0 +1,147 @@
+/**
+ * @file methods/fastmks/cone_stat.hpp
+ *
+ * The statistic used in trees with ConeSearch, which holds the cone that
+ * contains the points of a node.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_FASTMKS_CONE_STAT_HPP
+#define MLPACK_METHODS_FASTMKS_CONE_STAT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * The statistic used in trees with ConeSearch.  This holds the cone bound of
+ * the points of a node: their mean direction, the range of their norms, and
+ * the largest angle between the direction and a point (the angular radius of
+ * the cone).  The angle between a vector and any point of the node
+ * is then at least the angle between the vector and the direction, minus the
+ * radius, which bounds the inner products and cosine similarities with the
+ * points of the node.  The statistic also holds the pruning bound of the node
+ * in dual-tree search.
+ *
+ * The cone is computed from the descendants of the node, so this can be used
+ * with any tree type that provides Descendant().
+ */
+class ConeStat
+{
+ public:
+  //! Default initialization.
+  ConeStat() :
+      minNorm(0.0),
+      maxNorm(0.0),
+      radius(M_PI),
+      bound(-DBL_MAX)
+  { }
+
+  /**
+   * Compute the cone of the points of the given node.
+   *
+   * @param node Node that this statistic is built for.
+   */
+  template<typename TreeType>
+  ConeStat(const TreeType& node) :
+      minNorm(DBL_MAX),
+      maxNorm(0.0),
+      radius(0.0),
+      bound(-DBL_MAX)
+  {
+    // The direction is that of the mean of the normalized points, so that
+    // points with large norms do not pull the cone towards them.  Points with
+    // a norm of zero have no direction; they have a zero inner product with
+    // any vector, which the norm range accounts for.
+    direction.zeros(node.Dataset().n_rows);
+    for (size_t i = 0; i < node.NumDescendants(); ++i)
+    {
+      const arma::vec point = arma::conv_to<arma::vec>::from(
+          node.Dataset().col(node.Descendant(i)));
+      const double norm = arma::norm(point, 2);
+      minNorm = std::min(minNorm, norm);
+      maxNorm = std::max(maxNorm, norm);
+      if (norm > 0.0)
+        direction += point / norm;
+    }
+
+    if (node.NumDescendants() == 0)
+      minNorm = 0.0;
+
+    const double directionNorm = arma::norm(direction, 2);
+    if (directionNorm == 0.0)
+    {
+      // The points cancel out (or are all zero), so they may be in any
+      // direction.
+      radius = M_PI;
+      return;
+    }
+
+    direction /= directionNorm;
+    for (size_t i = 0; i < node.NumDescendants(); ++i)
+    {
+      const arma::vec point = arma::conv_to<arma::vec>::from(
+          node.Dataset().col(node.Descendant(i)));
+      const double norm = arma::norm(point, 2);
+      if (norm > 0.0)
+        radius = std::max(radius, Angle(direction, point / norm));
+    }
+  }
+
+  /**
+   * Return the angle between the two given unit vectors.  This is more
+   * accurate than the arc cosine of their dot product when the angle is small.
+   */
+  template<typename VecTypeA, typename VecTypeB>
+  static double Angle(const VecTypeA& a, const VecTypeB& b)
+  {
+    return 2.0 * std::atan2(arma::norm(a - b, 2), arma::norm(a + b, 2));
+  }
+
+  //! Get the unit direction of the cone (zero if it has none).
+  const arma::vec& Direction() const { return direction; }
+  //! Get the smallest norm of a point of the node.
+  double MinNorm() const { return minNorm; }
+  //! Get the largest norm of a point of the node.
+  double MaxNorm() const { return maxNorm; }
+  //! Get the largest angle between the direction and a point of the node.
+  double Radius() const { return radius; }
+
+  //! Get the pruning bound of the node in dual-tree search.
+  double Bound() const { return bound; }
+  //! Modify the pruning bound of the node in dual-tree search.
+  double& Bound() { return bound; }
+
+  //! Serialize the statistic.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(direction));
+    ar(CEREAL_NVP(minNorm));
+    ar(CEREAL_NVP(maxNorm));
+    ar(CEREAL_NVP(radius));
+
+    // The bound is only meaningful during a search.
+    if (cereal::is_loading<Archive>())
+      bound = -DBL_MAX;
+  }
+
+ private:
+  //! The unit direction of the cone.
+  arma::vec direction;
+  //! The smallest norm of a point of the node.
+  double minNorm;
+  //! The largest norm of a point of the node.
+  double maxNorm;
+  //! The angular radius of the cone, in radians.
+  double radius;
+  //! The pruning bound of the node in dual-tree search.
+  double bound;
+};
+
+} // namespace mlpack
+
+#endif
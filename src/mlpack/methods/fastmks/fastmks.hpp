@@ -336,6 +336,41 @@ class FastMKS
   //! Use a priority queue to represent the list of candidate points.
   typedef std::priority_queue<Candidate, std::vector<Candidate>,
       CandidateCmp> CandidateList;
+
+  /**
+   * Brute-force search: find the k points of the reference set with maximum
+   * kernel value for each point of the query set.  The kernel values are
+   * computed for blocks of query and reference points at once, with the batch
+   * Evaluate() method of the kernel if it has one (see HasBatchEvaluate).
+   *
+   * @param querySet Set of query points.
+   * @param k The number of maximum kernels to find.
+   * @param indices Matrix to store resulting indices of max-kernel search in.
+   * @param kernels Matrix to store resulting max-kernel values in.
+   * @param sameSet If true, the query set is the reference set, and a point is
+   *     not returned as its own candidate.
+   */
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels,
+                   const bool sameSet);
+
+  /**
+   * Single-tree search: traverse the reference tree for each point of the
+   * query set.  The query points are split into blocks, which are searched in
+   * parallel when OpenMP is available; each block keeps the kernels it caches
+   * for reference nodes to itself, so the reference tree is not modified.
+   *
+   * @param querySet Set of query points.
+   * @param k The number of maximum kernels to find.
+   * @param indices Matrix to store resulting indices of max-kernel search in.
+   * @param kernels Matrix to store resulting max-kernel values in.
+   */
+  void SingleTreeSearch(const MatType& querySet,
+                        const size_t k,
+                        arma::Mat<size_t>& indices,
+                        arma::mat& kernels);
 };
 
 } // namespace mlpack
@@ -436,55 +436,14 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; ++j)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
-
+    NaiveSearch(querySet, k, indices, kernels, false);
     return;
   }
 
   // Single-tree implementation.
   if (singleMode)
   {
-    // Create rules object (this will store the results).  This constructor
-    // precalculates each self-kernel value.
-    typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, querySet, k, metric.Kernel());
-
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
-
-    rules.GetResults(indices, kernels);
-
+    SingleTreeSearch(querySet, k, indices, kernels);
     return;
   }
 
@@ -533,15 +492,47 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   indices.set_size(k, queryTree->Dataset().n_cols);
   kernels.set_size(k, queryTree->Dataset().n_cols);
 
+  // These rules hold the results of every query point; the rules of each
+  // query subtree share them.
   typedef FastMKSRules<KernelType, Tree> RuleType;
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel());
 
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  // Disjoint query subtrees are searched in parallel.  The dual-tree rules only
+  // write the bounds of query nodes and only read the self-kernels of reference
+  // nodes, so this is correct even when the query tree is the reference tree.
+  // The ancestors of the subtrees are not visited, so their bounds (which may
+  // be left from an earlier search) are reset.
+  const std::vector<Tree*> subtrees = SplitQueryTree(*queryTree,
+      NumParallelTasks(queryTree->NumDescendants()));
+  for (size_t i = 0; i < subtrees.size(); ++i)
+  {
+    for (Tree* node = subtrees[i]; node != queryTree; )
+    {
+      node = node->Parent();
+      node->Stat().Bound() = -DBL_MAX;
+    }
+  }
 
-  traverser.Traverse(*queryTree, *referenceTree);
+  size_t baseCases = 0;
+  size_t scores = 0;
+  ParallelDualTreeTraversal(subtrees,
+      [&](Tree& queryNode)
+      {
+        KernelType kernel(metric.Kernel());
+        RuleType subtreeRules(rules, kernel);
+        typename Tree::template DualTreeTraverser<RuleType>
+            traverser(subtreeRules);
+        traverser.Traverse(queryNode, *referenceTree);
+
+        #pragma omp critical
+        {
+          baseCases += subtreeRules.BaseCases();
+          scores += subtreeRules.Scores();
+        }
+      });
 
-  Log::Info << rules.BaseCases() << " base cases." << std::endl;
-  Log::Info << rules.Scores() << " scores." << std::endl;
+  Log::Info << baseCases << " base cases." << std::endl;
+  Log::Info << scores << " scores." << std::endl;
 
   rules.GetResults(indices, kernels);
 }
@@ -563,29 +554,86 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
+    NaiveSearch(*referenceSet, k, indices, kernels, true);
+    return;
+  }
 
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
+  // Single-tree implementation.
+  if (singleMode)
+  {
+    SingleTreeSearch(*referenceSet, k, indices, kernels);
+    return;
+  }
+
+  // Dual-tree implementation.
+  Search(referenceTree, k, indices, kernels);
+}
+
+//! Serialize the model.
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const bool sameSet)
+{
+  // Blocks of this many query and reference points are evaluated at once; a
+  // block of kernel values takes 512 kB.
+  const size_t blockSize = 256;
+
+  // Blocks of query points are searched in parallel, each with its own copy of
+  // the kernel.
+  const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+  const size_t numQueryBlocks = (querySet.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t qb = 0; qb < numQueryBlocks; ++qb)
+  {
+    const size_t qBegin = qb * blockSize;
+    const size_t qEnd = std::min(qBegin + blockSize, (size_t) querySet.n_cols);
+    KernelType kernel(metric.Kernel());
+    arma::mat block;
+    std::vector<CandidateList> pqueues;
+    for (size_t q = qBegin; q < qEnd; ++q)
+      pqueues.push_back(CandidateList(CandidateCmp(),
+          std::vector<Candidate>(k, def)));
+
+    for (size_t rBegin = 0; rBegin < referenceSet->n_cols; rBegin += blockSize)
+    {
+      const size_t rEnd = std::min(rBegin + blockSize,
+          (size_t) referenceSet->n_cols);
 
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
+      // block(r, q) is the kernel value between reference point rBegin + r
+      // and query point qBegin + q.
+      KernelMatrixTile(kernel, *referenceSet, querySet, rBegin, rEnd, qBegin,
+          qEnd, block, HasBatchEvaluate<KernelType>());
 
-        if (eval > pqueue.top().first)
+      for (size_t q = qBegin; q < qEnd; ++q)
+      {
+        CandidateList& pqueue = pqueues[q - qBegin];
+        for (size_t r = rBegin; r < rEnd; ++r)
         {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
+          if (sameSet && q == r)
+            continue; // Don't return the point as its own candidate.
+
+          const double eval = block(r - rBegin, q - qBegin);
+          if (eval > pqueue.top().first)
+          {
+            Candidate c = std::make_pair(eval, r);
+            pqueue.pop();
+            pqueue.push(c);
+          }
         }
       }
+    }
 
+    for (size_t q = qBegin; q < qEnd; ++q)
+    {
+      CandidateList& pqueue = pqueues[q - qBegin];
       for (size_t j = 1; j <= k; ++j)
       {
         indices(k - j, q) = pqueue.top().second;
@@ -593,41 +641,70 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
         pqueue.pop();
       }
     }
-
-    return;
   }
+}
 
-  // Single-tree implementation.
-  if (singleMode)
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::SingleTreeSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels)
+{
+  // Create rules object (this will store the results).  This constructor
+  // precalculates each self-kernel value.
+  typedef FastMKSRules<KernelType, Tree> RuleType;
+  typedef typename Tree::template SingleTreeTraverser<RuleType> TraverserType;
+  RuleType rules(*referenceSet, querySet, k, metric.Kernel());
+
+  size_t numPrunes = 0;
+  size_t baseCases = 0;
+  size_t scores = 0;
+  const size_t numBlocks = NumParallelTasks(querySet.n_cols);
+  if (numBlocks == 1)
   {
-    // Create rules object (this will store the results).  This constructor
-    // precalculates each self-kernel value.
-    typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel());
-
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+    TraverserType traverser(rules);
+    for (size_t i = 0; i < querySet.n_cols; ++i)
       traverser.Traverse(i, *referenceTree);
 
-    // Save the number of pruned nodes.
-    const size_t numPrunes = traverser.NumPrunes();
-
-    Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
-
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
-
-    rules.GetResults(indices, kernels);
-
-    return;
+    numPrunes = traverser.NumPrunes();
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+  }
+  else
+  {
+    #pragma omp parallel for schedule(dynamic) \
+        reduction(+:numPrunes, baseCases, scores) \
+        num_threads((int) NumThreads())
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = (b * querySet.n_cols) / numBlocks;
+      const size_t end = ((b + 1) * querySet.n_cols) / numBlocks;
+
+      // The rules of each block share the results of the rules above.
+      KernelType kernel(metric.Kernel());
+      RuleType blockRules(rules, kernel);
+      TraverserType traverser(blockRules);
+      for (size_t i = begin; i < end; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      numPrunes += traverser.NumPrunes();
+      baseCases += blockRules.BaseCases();
+      scores += blockRules.Scores();
+    }
   }
 
-  // Dual-tree implementation.
-  Search(referenceTree, k, indices, kernels);
+  Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
+  Log::Info << baseCases << " base cases." << std::endl;
+  Log::Info << scores << " scores." << std::endl;
+
+  rules.GetResults(indices, kernels);
 }
 
-//! Serialize the model.
 template<typename KernelType,
          typename MatType,
          template<typename TreeMetricType,
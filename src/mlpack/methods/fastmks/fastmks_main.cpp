@@ -81,6 +81,9 @@ PARAM_STRING_IN("kernel", "Kernel type to use: 'linear', 'polynomial', "
     "linear");
 PARAM_DOUBLE_IN("base", "Base to use during cover tree construction.", "b",
     2.0);
+PARAM_FLAG("single_precision", "Hold the reference set and the tree in single "
+    "precision, which halves their memory usage; kernel values are then only "
+    "accurate to about seven significant digits.", "");
 
 // Kernel parameters.
 PARAM_DOUBLE_IN("degree", "Degree of polynomial kernel.", "d", 2.0);
@@ -113,6 +116,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   ReportIgnoredParam(params, {{ "input_model", true }}, "bandwidth");
   ReportIgnoredParam(params, {{ "input_model", true }}, "degree");
   ReportIgnoredParam(params, {{ "input_model", true }}, "offset");
+  ReportIgnoredParam(params, {{ "input_model", true }}, "single_precision");
 
   ReportIgnoredParam(params, {{ "k", false }}, "indices");
   ReportIgnoredParam(params, {{ "k", false }}, "kernels");
@@ -150,6 +154,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   if (params.Has("reference"))
   {
     model = new FastMKSModel();
+    model->SinglePrecision() = params.Has("single_precision");
     referenceData = std::move(params.Get<arma::mat>("reference"));
 
     Log::Info << "Loaded reference data (" << referenceData.n_rows << " x "
@@ -46,9 +46,14 @@ class FastMKSModel
   };
 
   /**
-   * Create the FastMKSModel with the given kernel type.
+   * Create the FastMKSModel with the given kernel type.  If singlePrecision is
+   * true, the reference set and the tree are held in single precision (as an
+   * arma::fmat) once the model is built; query sets are then converted to
+   * single precision too, but kernel values are still returned as an
+   * arma::mat.
    */
-  FastMKSModel(const int kernelType = LINEAR_KERNEL);
+  FastMKSModel(const int kernelType = LINEAR_KERNEL,
+               const bool singlePrecision = false);
 
   //! Copy constructor.
   FastMKSModel(const FastMKSModel& other);
@@ -94,6 +99,12 @@ class FastMKSModel
   //! Modify the kernel type.
   int& KernelType() { return kernelType; }
 
+  //! Get whether the reference set and the tree are held in single precision.
+  bool SinglePrecision() const { return singlePrecision; }
+  //! Modify whether the reference set and the tree are held in single
+  //! precision.  This takes effect the next time the model is built.
+  bool& SinglePrecision() { return singlePrecision; }
+
   /**
    * Search with a different query set.
    *
@@ -131,11 +142,13 @@ class FastMKSModel
    * Serialize the model.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
  private:
   //! The type of kernel we are using.
   int kernelType;
+  //! Whether the reference set and the tree are held in single precision.
+  bool singlePrecision;
 
   //! This will only be non-NULL if this is the type of kernel we are using.
   FastMKS<LinearKernel>* linear;
@@ -152,11 +165,28 @@ class FastMKSModel
   //! This will only be non-NULL if this is the type of kernel we are using.
   FastMKS<HyperbolicTangentKernel>* hyptan;
 
+  //! The single-precision models; as above, only the one for the type of
+  //! kernel we are using will be non-NULL, and only if singlePrecision is
+  //! true.
+  FastMKS<LinearKernel, arma::fmat>* fLinear;
+  FastMKS<PolynomialKernel, arma::fmat>* fPolynomial;
+  FastMKS<CosineDistance, arma::fmat>* fCosine;
+  FastMKS<GaussianKernel, arma::fmat>* fGaussian;
+  FastMKS<EpanechnikovKernel, arma::fmat>* fEpan;
+  FastMKS<TriangularKernel, arma::fmat>* fTriangular;
+  FastMKS<HyperbolicTangentKernel, arma::fmat>* fHyptan;
+
+  //! Delete all of the models and set their pointers to NULL.
+  void Clear();
+
+  //! Copy all of the models held by the given model.
+  void Copy(const FastMKSModel& other);
+
   //! Build a query tree and execute the search.
-  template<typename FastMKSType>
+  template<typename FastMKSType, typename MatType>
   void Search(util::Timers& timers,
               FastMKSType& f,
-              const arma::mat& querySet,
+              const MatType& querySet,
               const size_t k,
               arma::Mat<size_t>& indices,
               arma::mat& kernels,
@@ -165,6 +195,8 @@ class FastMKSModel
 
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::FastMKSModel, 1);
+
 #include "fastmks_model_impl.hpp"
 
 #endif
@@ -16,51 +16,70 @@
 
 namespace mlpack {
 
-inline FastMKSModel::FastMKSModel(const int kernelType) :
+inline FastMKSModel::FastMKSModel(const int kernelType,
+                                  const bool singlePrecision) :
     kernelType(kernelType),
+    singlePrecision(singlePrecision),
     linear(NULL),
     polynomial(NULL),
     cosine(NULL),
     gaussian(NULL),
     epan(NULL),
     triangular(NULL),
-    hyptan(NULL)
+    hyptan(NULL),
+    fLinear(NULL),
+    fPolynomial(NULL),
+    fCosine(NULL),
+    fGaussian(NULL),
+    fEpan(NULL),
+    fTriangular(NULL),
+    fHyptan(NULL)
 {
   // Nothing to do.
 }
 
 inline FastMKSModel::FastMKSModel(const FastMKSModel& other) :
     kernelType(other.kernelType),
-    linear(other.linear == NULL ? NULL :
-        new FastMKS<LinearKernel>(*other.linear)),
-    polynomial(other.polynomial == NULL ? NULL :
-        new FastMKS<PolynomialKernel>(*other.polynomial)),
-    cosine(other.cosine == NULL ? NULL :
-        new FastMKS<CosineDistance>(*other.cosine)),
-    gaussian(other.gaussian == NULL ? NULL :
-        new FastMKS<GaussianKernel>(*other.gaussian)),
-    epan(other.epan == NULL ? NULL :
-        new FastMKS<EpanechnikovKernel>(*other.epan)),
-    triangular(other.triangular == NULL ? NULL :
-        new FastMKS<TriangularKernel>(*other.triangular)),
-    hyptan(other.hyptan == NULL ? NULL :
-        new FastMKS<HyperbolicTangentKernel>(*other.hyptan))
+    singlePrecision(other.singlePrecision),
+    linear(NULL),
+    polynomial(NULL),
+    cosine(NULL),
+    gaussian(NULL),
+    epan(NULL),
+    triangular(NULL),
+    hyptan(NULL),
+    fLinear(NULL),
+    fPolynomial(NULL),
+    fCosine(NULL),
+    fGaussian(NULL),
+    fEpan(NULL),
+    fTriangular(NULL),
+    fHyptan(NULL)
 {
-  // Nothing to do.
+  Copy(other);
 }
 
 inline FastMKSModel::FastMKSModel(FastMKSModel&& other) :
     kernelType(other.kernelType),
+    singlePrecision(other.singlePrecision),
     linear(other.linear),
     polynomial(other.polynomial),
     cosine(other.cosine),
     gaussian(other.gaussian),
     epan(other.epan),
     triangular(other.triangular),
-    hyptan(other.hyptan)
+    hyptan(other.hyptan),
+    fLinear(other.fLinear),
+    fPolynomial(other.fPolynomial),
+    fCosine(other.fCosine),
+    fGaussian(other.fGaussian),
+    fEpan(other.fEpan),
+    fTriangular(other.fTriangular),
+    fHyptan(other.fHyptan)
 {
   // Clear other object.
   other.kernelType = KernelTypes::LINEAR_KERNEL;
+  other.singlePrecision = false;
   other.linear = NULL;
   other.polynomial = NULL;
   other.cosine = NULL;
@@ -68,6 +87,13 @@ inline FastMKSModel::FastMKSModel(FastMKSModel&& other) :
   other.epan = NULL;
   other.triangular = NULL;
   other.hyptan = NULL;
+  other.fLinear = NULL;
+  other.fPolynomial = NULL;
+  other.fCosine = NULL;
+  other.fGaussian = NULL;
+  other.fEpan = NULL;
+  other.fTriangular = NULL;
+  other.fHyptan = NULL;
 }
 
 inline FastMKSModel& FastMKSModel::operator=(const FastMKSModel& other)
@@ -75,38 +101,11 @@ inline FastMKSModel& FastMKSModel::operator=(const FastMKSModel& other)
   if (this != &other)
   {
     // Clear memory.
-    delete linear;
-    delete polynomial;
-    delete cosine;
-    delete gaussian;
-    delete epan;
-    delete triangular;
-    delete hyptan;
-
-    // Set pointers to null.
-    linear = NULL;
-    polynomial = NULL;
-    cosine = NULL;
-    gaussian = NULL;
-    epan = NULL;
-    triangular = NULL;
-    hyptan = NULL;
+    Clear();
 
     kernelType = other.kernelType;
-    if (other.linear)
-      linear = new FastMKS<LinearKernel>(*other.linear);
-    if (other.polynomial)
-      polynomial = new FastMKS<PolynomialKernel>(*other.polynomial);
-    if (other.cosine)
-      cosine = new FastMKS<CosineDistance>(*other.cosine);
-    if (other.gaussian)
-      gaussian = new FastMKS<GaussianKernel>(*other.gaussian);
-    if (other.epan)
-      epan = new FastMKS<EpanechnikovKernel>(*other.epan);
-    if (other.triangular)
-      triangular = new FastMKS<TriangularKernel>(*other.triangular);
-    if (other.hyptan)
-      hyptan = new FastMKS<HyperbolicTangentKernel>(*other.hyptan);
+    singlePrecision = other.singlePrecision;
+    Copy(other);
   }
   return *this;
 }
@@ -115,7 +114,11 @@ inline FastMKSModel& FastMKSModel::operator=(FastMKSModel&& other)
 {
   if (this != &other)
   {
+    // Clear memory.
+    Clear();
+
     kernelType = other.kernelType;
+    singlePrecision = other.singlePrecision;
     linear = other.linear;
     polynomial = other.polynomial;
     cosine = other.cosine;
@@ -123,9 +126,17 @@ inline FastMKSModel& FastMKSModel::operator=(FastMKSModel&& other)
     epan = other.epan;
     triangular = other.triangular;
     hyptan = other.hyptan;
+    fLinear = other.fLinear;
+    fPolynomial = other.fPolynomial;
+    fCosine = other.fCosine;
+    fGaussian = other.fGaussian;
+    fEpan = other.fEpan;
+    fTriangular = other.fTriangular;
+    fHyptan = other.fHyptan;
 
     // Clear other object.
     other.kernelType = KernelTypes::LINEAR_KERNEL;
+    other.singlePrecision = false;
     other.linear = nullptr;
     other.polynomial = nullptr;
     other.cosine = nullptr;
@@ -133,6 +144,13 @@ inline FastMKSModel& FastMKSModel::operator=(FastMKSModel&& other)
     other.epan = nullptr;
     other.triangular = nullptr;
     other.hyptan = nullptr;
+    other.fLinear = nullptr;
+    other.fPolynomial = nullptr;
+    other.fCosine = nullptr;
+    other.fGaussian = nullptr;
+    other.fEpan = nullptr;
+    other.fTriangular = nullptr;
+    other.fHyptan = nullptr;
   }
   return *this;
 }
@@ -140,20 +158,75 @@ inline FastMKSModel& FastMKSModel::operator=(FastMKSModel&& other)
 inline FastMKSModel::~FastMKSModel()
 {
   // Clean memory.
-  if (linear)
-    delete linear;
-  if (polynomial)
-    delete polynomial;
-  if (cosine)
-    delete cosine;
-  if (gaussian)
-    delete gaussian;
-  if (epan)
-    delete epan;
-  if (triangular)
-    delete triangular;
-  if (hyptan)
-    delete hyptan;
+  Clear();
+}
+
+inline void FastMKSModel::Clear()
+{
+  delete linear;
+  delete polynomial;
+  delete cosine;
+  delete gaussian;
+  delete epan;
+  delete triangular;
+  delete hyptan;
+  delete fLinear;
+  delete fPolynomial;
+  delete fCosine;
+  delete fGaussian;
+  delete fEpan;
+  delete fTriangular;
+  delete fHyptan;
+
+  linear = NULL;
+  polynomial = NULL;
+  cosine = NULL;
+  gaussian = NULL;
+  epan = NULL;
+  triangular = NULL;
+  hyptan = NULL;
+  fLinear = NULL;
+  fPolynomial = NULL;
+  fCosine = NULL;
+  fGaussian = NULL;
+  fEpan = NULL;
+  fTriangular = NULL;
+  fHyptan = NULL;
+}
+
+inline void FastMKSModel::Copy(const FastMKSModel& other)
+{
+  if (other.linear)
+    linear = new FastMKS<LinearKernel>(*other.linear);
+  if (other.polynomial)
+    polynomial = new FastMKS<PolynomialKernel>(*other.polynomial);
+  if (other.cosine)
+    cosine = new FastMKS<CosineDistance>(*other.cosine);
+  if (other.gaussian)
+    gaussian = new FastMKS<GaussianKernel>(*other.gaussian);
+  if (other.epan)
+    epan = new FastMKS<EpanechnikovKernel>(*other.epan);
+  if (other.triangular)
+    triangular = new FastMKS<TriangularKernel>(*other.triangular);
+  if (other.hyptan)
+    hyptan = new FastMKS<HyperbolicTangentKernel>(*other.hyptan);
+  if (other.fLinear)
+    fLinear = new FastMKS<LinearKernel, arma::fmat>(*other.fLinear);
+  if (other.fPolynomial)
+    fPolynomial = new FastMKS<PolynomialKernel, arma::fmat>(*other.fPolynomial);
+  if (other.fCosine)
+    fCosine = new FastMKS<CosineDistance, arma::fmat>(*other.fCosine);
+  if (other.fGaussian)
+    fGaussian = new FastMKS<GaussianKernel, arma::fmat>(*other.fGaussian);
+  if (other.fEpan)
+    fEpan = new FastMKS<EpanechnikovKernel, arma::fmat>(*other.fEpan);
+  if (other.fTriangular)
+    fTriangular = new FastMKS<TriangularKernel, arma::fmat>(*other.fTriangular);
+  if (other.fHyptan)
+  {
+    fHyptan = new FastMKS<HyperbolicTangentKernel, arma::fmat>(
+        *other.fHyptan);
+  }
 }
 
 inline bool FastMKSModel::Naive() const
@@ -161,19 +234,19 @@ inline bool FastMKSModel::Naive() const
   switch (kernelType)
   {
     case LINEAR_KERNEL:
-      return linear->Naive();
+      return singlePrecision ? fLinear->Naive() : linear->Naive();
     case POLYNOMIAL_KERNEL:
-      return polynomial->Naive();
+      return singlePrecision ? fPolynomial->Naive() : polynomial->Naive();
     case COSINE_DISTANCE:
-      return cosine->Naive();
+      return singlePrecision ? fCosine->Naive() : cosine->Naive();
     case GAUSSIAN_KERNEL:
-      return gaussian->Naive();
+      return singlePrecision ? fGaussian->Naive() : gaussian->Naive();
     case EPANECHNIKOV_KERNEL:
-      return epan->Naive();
+      return singlePrecision ? fEpan->Naive() : epan->Naive();
     case TRIANGULAR_KERNEL:
-      return triangular->Naive();
+      return singlePrecision ? fTriangular->Naive() : triangular->Naive();
     case HYPTAN_KERNEL:
-      return hyptan->Naive();
+      return singlePrecision ? fHyptan->Naive() : hyptan->Naive();
   }
 
   throw std::runtime_error("invalid model type");
@@ -184,19 +257,19 @@ inline bool& FastMKSModel::Naive()
   switch (kernelType)
   {
     case LINEAR_KERNEL:
-      return linear->Naive();
+      return singlePrecision ? fLinear->Naive() : linear->Naive();
     case POLYNOMIAL_KERNEL:
-      return polynomial->Naive();
+      return singlePrecision ? fPolynomial->Naive() : polynomial->Naive();
     case COSINE_DISTANCE:
-      return cosine->Naive();
+      return singlePrecision ? fCosine->Naive() : cosine->Naive();
     case GAUSSIAN_KERNEL:
-      return gaussian->Naive();
+      return singlePrecision ? fGaussian->Naive() : gaussian->Naive();
     case EPANECHNIKOV_KERNEL:
-      return epan->Naive();
+      return singlePrecision ? fEpan->Naive() : epan->Naive();
     case TRIANGULAR_KERNEL:
-      return triangular->Naive();
+      return singlePrecision ? fTriangular->Naive() : triangular->Naive();
     case HYPTAN_KERNEL:
-      return hyptan->Naive();
+      return singlePrecision ? fHyptan->Naive() : hyptan->Naive();
   }
 
   throw std::runtime_error("invalid model type");
@@ -207,19 +280,21 @@ inline bool FastMKSModel::SingleMode() const
   switch (kernelType)
   {
     case LINEAR_KERNEL:
-      return linear->SingleMode();
+      return singlePrecision ? fLinear->SingleMode() : linear->SingleMode();
     case POLYNOMIAL_KERNEL:
-      return polynomial->SingleMode();
+      return singlePrecision ? fPolynomial->SingleMode() :
+          polynomial->SingleMode();
     case COSINE_DISTANCE:
-      return cosine->SingleMode();
+      return singlePrecision ? fCosine->SingleMode() : cosine->SingleMode();
     case GAUSSIAN_KERNEL:
-      return gaussian->SingleMode();
+      return singlePrecision ? fGaussian->SingleMode() : gaussian->SingleMode();
     case EPANECHNIKOV_KERNEL:
-      return epan->SingleMode();
+      return singlePrecision ? fEpan->SingleMode() : epan->SingleMode();
     case TRIANGULAR_KERNEL:
-      return triangular->SingleMode();
+      return singlePrecision ? fTriangular->SingleMode() :
+          triangular->SingleMode();
     case HYPTAN_KERNEL:
-      return hyptan->SingleMode();
+      return singlePrecision ? fHyptan->SingleMode() : hyptan->SingleMode();
   }
 
   throw std::runtime_error("invalid model type");
@@ -230,28 +305,30 @@ inline bool& FastMKSModel::SingleMode()
   switch (kernelType)
   {
     case LINEAR_KERNEL:
-      return linear->SingleMode();
+      return singlePrecision ? fLinear->SingleMode() : linear->SingleMode();
     case POLYNOMIAL_KERNEL:
-      return polynomial->SingleMode();
+      return singlePrecision ? fPolynomial->SingleMode() :
+          polynomial->SingleMode();
     case COSINE_DISTANCE:
-      return cosine->SingleMode();
+      return singlePrecision ? fCosine->SingleMode() : cosine->SingleMode();
     case GAUSSIAN_KERNEL:
-      return gaussian->SingleMode();
+      return singlePrecision ? fGaussian->SingleMode() : gaussian->SingleMode();
     case EPANECHNIKOV_KERNEL:
-      return epan->SingleMode();
+      return singlePrecision ? fEpan->SingleMode() : epan->SingleMode();
     case TRIANGULAR_KERNEL:
-      return triangular->SingleMode();
+      return singlePrecision ? fTriangular->SingleMode() :
+          triangular->SingleMode();
     case HYPTAN_KERNEL:
-      return hyptan->SingleMode();
+      return singlePrecision ? fHyptan->SingleMode() : hyptan->SingleMode();
   }
 
   throw std::runtime_error("invalid model type");
 }
 
 //! This is called when the KernelType is the same as the model.
-template<typename KernelType>
+template<typename KernelType, typename MatType>
 void BuildFastMKSModel(util::Timers& timers,
-                       FastMKS<KernelType>& f,
+                       FastMKS<KernelType, MatType>& f,
                        KernelType& k,
                        arma::mat&& referenceData,
                        const double base)
@@ -264,16 +341,16 @@ void BuildFastMKSModel(util::Timers& timers,
 
   if (f.Naive())
   {
-    f.Train(std::move(referenceData), k);
+    f.Train(ConvertOrMove<MatType>(std::move(referenceData)), k);
   }
   else
   {
     // Create the tree with the specified base.
     timers.Start("tree_building");
     IPMetric<KernelType> metric(k);
-    typename FastMKS<KernelType>::Tree* tree =
-        new typename FastMKS<KernelType>::Tree(std::move(referenceData),
-                                                metric, base);
+    typename FastMKS<KernelType, MatType>::Tree* tree =
+        new typename FastMKS<KernelType, MatType>::Tree(
+            ConvertOrMove<MatType>(std::move(referenceData)), metric, base);
     timers.Stop("tree_building");
 
     f.Train(tree);
@@ -302,141 +379,197 @@ void FastMKSModel::BuildModel(util::Timers& timers,
                               const double base)
 {
   // Clean memory if necessary.
-  if (linear)
-    delete linear;
-  if (polynomial)
-    delete polynomial;
-  if (cosine)
-    delete cosine;
-  if (gaussian)
-    delete gaussian;
-  if (epan)
-    delete epan;
-  if (triangular)
-    delete triangular;
-  if (hyptan)
-    delete hyptan;
-
-  linear = NULL;
-  polynomial = NULL;
-  cosine = NULL;
-  gaussian = NULL;
-  epan = NULL;
-  triangular = NULL;
-  hyptan = NULL;
+  Clear();
 
   // Instantiate the right model.
   switch (kernelType)
   {
     case LINEAR_KERNEL:
-      linear = new FastMKS<LinearKernel>(singleMode, naive);
-      BuildFastMKSModel(timers, *linear, kernel, std::move(referenceData), base);
+      if (singlePrecision)
+      {
+        fLinear = new FastMKS<LinearKernel, arma::fmat>(singleMode, naive);
+        BuildFastMKSModel(timers, *fLinear, kernel, std::move(referenceData),
+            base);
+      }
+      else
+      {
+        linear = new FastMKS<LinearKernel>(singleMode, naive);
+        BuildFastMKSModel(timers, *linear, kernel, std::move(referenceData),
+            base);
+      }
       break;
 
     case POLYNOMIAL_KERNEL:
-      polynomial = new FastMKS<PolynomialKernel>(singleMode, naive);
-      BuildFastMKSModel(timers, *polynomial, kernel, std::move(referenceData),
-          base);
+      if (singlePrecision)
+      {
+        fPolynomial = new FastMKS<PolynomialKernel, arma::fmat>(singleMode,
+            naive);
+        BuildFastMKSModel(timers, *fPolynomial, kernel,
+            std::move(referenceData), base);
+      }
+      else
+      {
+        polynomial = new FastMKS<PolynomialKernel>(singleMode, naive);
+        BuildFastMKSModel(timers, *polynomial, kernel, std::move(referenceData),
+            base);
+      }
       break;
 
     case COSINE_DISTANCE:
-      cosine = new FastMKS<CosineDistance>(singleMode, naive);
-      BuildFastMKSModel(timers, *cosine, kernel, std::move(referenceData), base);
+      if (singlePrecision)
+      {
+        fCosine = new FastMKS<CosineDistance, arma::fmat>(singleMode, naive);
+        BuildFastMKSModel(timers, *fCosine, kernel, std::move(referenceData),
+            base);
+      }
+      else
+      {
+        cosine = new FastMKS<CosineDistance>(singleMode, naive);
+        BuildFastMKSModel(timers, *cosine, kernel, std::move(referenceData),
+            base);
+      }
       break;
 
     case GAUSSIAN_KERNEL:
-      gaussian = new FastMKS<GaussianKernel>(singleMode, naive);
-      BuildFastMKSModel(timers, *gaussian, kernel, std::move(referenceData),
-          base);
+      if (singlePrecision)
+      {
+        fGaussian = new FastMKS<GaussianKernel, arma::fmat>(singleMode, naive);
+        BuildFastMKSModel(timers, *fGaussian, kernel, std::move(referenceData),
+            base);
+      }
+      else
+      {
+        gaussian = new FastMKS<GaussianKernel>(singleMode, naive);
+        BuildFastMKSModel(timers, *gaussian, kernel, std::move(referenceData),
+            base);
+      }
       break;
 
     case EPANECHNIKOV_KERNEL:
-      epan = new FastMKS<EpanechnikovKernel>(singleMode, naive);
-      BuildFastMKSModel(timers, *epan, kernel, std::move(referenceData), base);
+      if (singlePrecision)
+      {
+        fEpan = new FastMKS<EpanechnikovKernel, arma::fmat>(singleMode, naive);
+        BuildFastMKSModel(timers, *fEpan, kernel, std::move(referenceData),
+            base);
+      }
+      else
+      {
+        epan = new FastMKS<EpanechnikovKernel>(singleMode, naive);
+        BuildFastMKSModel(timers, *epan, kernel, std::move(referenceData),
+            base);
+      }
       break;
 
     case TRIANGULAR_KERNEL:
-      triangular = new FastMKS<TriangularKernel>(singleMode, naive);
-      BuildFastMKSModel(timers, *triangular, kernel, std::move(referenceData),
-          base);
+      if (singlePrecision)
+      {
+        fTriangular = new FastMKS<TriangularKernel, arma::fmat>(singleMode,
+            naive);
+        BuildFastMKSModel(timers, *fTriangular, kernel,
+            std::move(referenceData), base);
+      }
+      else
+      {
+        triangular = new FastMKS<TriangularKernel>(singleMode, naive);
+        BuildFastMKSModel(timers, *triangular, kernel, std::move(referenceData),
+            base);
+      }
       break;
 
     case HYPTAN_KERNEL:
-      hyptan = new FastMKS<HyperbolicTangentKernel>(singleMode, naive);
-      BuildFastMKSModel(timers, *hyptan, kernel, std::move(referenceData), base);
+      if (singlePrecision)
+      {
+        fHyptan = new FastMKS<HyperbolicTangentKernel, arma::fmat>(singleMode,
+            naive);
+        BuildFastMKSModel(timers, *fHyptan, kernel, std::move(referenceData),
+            base);
+      }
+      else
+      {
+        hyptan = new FastMKS<HyperbolicTangentKernel>(singleMode, naive);
+        BuildFastMKSModel(timers, *hyptan, kernel, std::move(referenceData),
+            base);
+      }
       break;
   }
 }
 
 template<typename Archive>
-void FastMKSModel::serialize(Archive& ar, const uint32_t /* version */)
+void FastMKSModel::serialize(Archive& ar, const uint32_t version)
 {
   ar(CEREAL_NVP(kernelType));
 
+  // Models saved before single-precision models were supported are always
+  // double-precision.
+  if (cereal::is_loading<Archive>() && version == 0)
+    singlePrecision = false;
+  else
+    ar(CEREAL_NVP(singlePrecision));
+
   if (cereal::is_loading<Archive>())
   {
     // Clean memory.
-    if (linear)
-      delete linear;
-    if (polynomial)
-      delete polynomial;
-    if (cosine)
-      delete cosine;
-    if (gaussian)
-      delete gaussian;
-    if (epan)
-      delete epan;
-    if (triangular)
-      delete triangular;
-    if (hyptan)
-      delete hyptan;
-
-    linear = NULL;
-    polynomial = NULL;
-    cosine = NULL;
-    gaussian = NULL;
-    epan = NULL;
-    triangular = NULL;
-    hyptan = NULL;
+    Clear();
   }
 
   // Serialize the correct model.
   switch (kernelType)
   {
     case LINEAR_KERNEL:
-      ar(CEREAL_POINTER(linear));
+      if (singlePrecision)
+        ar(CEREAL_POINTER(fLinear));
+      else
+        ar(CEREAL_POINTER(linear));
       break;
 
     case POLYNOMIAL_KERNEL:
-      ar(CEREAL_POINTER(polynomial));
+      if (singlePrecision)
+        ar(CEREAL_POINTER(fPolynomial));
+      else
+        ar(CEREAL_POINTER(polynomial));
       break;
 
     case COSINE_DISTANCE:
-      ar(CEREAL_POINTER(cosine));
+      if (singlePrecision)
+        ar(CEREAL_POINTER(fCosine));
+      else
+        ar(CEREAL_POINTER(cosine));
       break;
 
     case GAUSSIAN_KERNEL:
-      ar(CEREAL_POINTER(gaussian));
+      if (singlePrecision)
+        ar(CEREAL_POINTER(fGaussian));
+      else
+        ar(CEREAL_POINTER(gaussian));
       break;
 
     case EPANECHNIKOV_KERNEL:
-      ar(CEREAL_POINTER(epan));
+      if (singlePrecision)
+        ar(CEREAL_POINTER(fEpan));
+      else
+        ar(CEREAL_POINTER(epan));
       break;
 
     case TRIANGULAR_KERNEL:
-      ar(CEREAL_POINTER(triangular));
+      if (singlePrecision)
+        ar(CEREAL_POINTER(fTriangular));
+      else
+        ar(CEREAL_POINTER(triangular));
       break;
 
     case HYPTAN_KERNEL:
-      ar(CEREAL_POINTER(hyptan));
+      if (singlePrecision)
+        ar(CEREAL_POINTER(fHyptan));
+      else
+        ar(CEREAL_POINTER(hyptan));
       break;
   }
 }
 
-template<typename FastMKSType>
+template<typename FastMKSType, typename MatType>
 void FastMKSModel::Search(util::Timers& timers,
                           FastMKSType& f,
-                          const arma::mat& querySet,
+                          const MatType& querySet,
                           const size_t k,
                           arma::Mat<size_t>& indices,
                           arma::mat& kernels,
@@ -468,6 +601,39 @@ inline void FastMKSModel::Search(
     arma::mat& kernels,
     const double base)
 {
+  if (singlePrecision)
+  {
+    const arma::fmat fQuerySet = ConvTo<arma::fmat>::From(querySet);
+    switch (kernelType)
+    {
+      case LINEAR_KERNEL:
+        Search(timers, *fLinear, fQuerySet, k, indices, kernels, base);
+        break;
+      case POLYNOMIAL_KERNEL:
+        Search(timers, *fPolynomial, fQuerySet, k, indices, kernels, base);
+        break;
+      case COSINE_DISTANCE:
+        Search(timers, *fCosine, fQuerySet, k, indices, kernels, base);
+        break;
+      case GAUSSIAN_KERNEL:
+        Search(timers, *fGaussian, fQuerySet, k, indices, kernels, base);
+        break;
+      case EPANECHNIKOV_KERNEL:
+        Search(timers, *fEpan, fQuerySet, k, indices, kernels, base);
+        break;
+      case TRIANGULAR_KERNEL:
+        Search(timers, *fTriangular, fQuerySet, k, indices, kernels, base);
+        break;
+      case HYPTAN_KERNEL:
+        Search(timers, *fHyptan, fQuerySet, k, indices, kernels, base);
+        break;
+      default:
+        throw std::runtime_error("invalid model type");
+    }
+
+    return;
+  }
+
   switch (kernelType)
   {
     case LINEAR_KERNEL:
@@ -506,25 +672,46 @@ inline void FastMKSModel::Search(
   switch (kernelType)
   {
     case LINEAR_KERNEL:
-      linear->Search(k, indices, kernels);
+      if (singlePrecision)
+        fLinear->Search(k, indices, kernels);
+      else
+        linear->Search(k, indices, kernels);
       break;
     case POLYNOMIAL_KERNEL:
-      polynomial->Search(k, indices, kernels);
+      if (singlePrecision)
+        fPolynomial->Search(k, indices, kernels);
+      else
+        polynomial->Search(k, indices, kernels);
       break;
     case COSINE_DISTANCE:
-      cosine->Search(k, indices, kernels);
+      if (singlePrecision)
+        fCosine->Search(k, indices, kernels);
+      else
+        cosine->Search(k, indices, kernels);
       break;
     case GAUSSIAN_KERNEL:
-      gaussian->Search(k, indices, kernels);
+      if (singlePrecision)
+        fGaussian->Search(k, indices, kernels);
+      else
+        gaussian->Search(k, indices, kernels);
       break;
     case EPANECHNIKOV_KERNEL:
-      epan->Search(k, indices, kernels);
+      if (singlePrecision)
+        fEpan->Search(k, indices, kernels);
+      else
+        epan->Search(k, indices, kernels);
       break;
     case TRIANGULAR_KERNEL:
-      triangular->Search(k, indices, kernels);
+      if (singlePrecision)
+        fTriangular->Search(k, indices, kernels);
+      else
+        triangular->Search(k, indices, kernels);
       break;
     case HYPTAN_KERNEL:
-      hyptan->Search(k, indices, kernels);
+      if (singlePrecision)
+        fHyptan->Search(k, indices, kernels);
+      else
+        hyptan->Search(k, indices, kernels);
       break;
     default:
       throw std::invalid_argument("invalid model type");
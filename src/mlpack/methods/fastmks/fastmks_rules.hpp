@@ -17,6 +17,7 @@
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/traversal_info.hpp>
 #include <algorithm>
+#include <unordered_map>
 
 namespace mlpack {
 
@@ -47,6 +48,21 @@ class FastMKSRules
                const size_t k,
                KernelType& kernel);
 
+  /**
+   * Construct a FastMKSRules object that searches for some of the query points
+   * of `other` from another thread.  The candidate lists and the cached
+   * self-kernels of `other` are shared, so GetResults() of either object gives
+   * the results of both; the traversal state is not shared.  The kernels of
+   * reference nodes that single-tree search caches are held in this object
+   * instead of in the statistics of the reference tree, so several of these
+   * objects can traverse the same reference tree at once.  Each query point
+   * must only be searched for by one of the objects sharing the candidates.
+   *
+   * @param other Rules to share the candidate lists with.
+   * @param kernel Kernel to evaluate from this thread.
+   */
+  FastMKSRules(FastMKSRules& other, KernelType& kernel);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -144,18 +160,24 @@ class FastMKSRules
     };
   };
 
+  //! The candidates of each point, unless they are shared with other rules.
+  std::vector<std::vector<Candidate>> ownCandidates;
   //! Set of candidates for each point.  We use a min-heap built on a
   //! std::vector to represent the list of candidate points for each query
   //! point.
-  std::vector<std::vector<Candidate>> candidates;
+  std::vector<std::vector<Candidate>>& candidates;
 
   //! Number of points to search for.
   const size_t k;
 
+  //! The query set self-kernels, unless they are shared with other rules.
+  arma::vec ownQueryKernels;
+  //! The reference set self-kernels, unless they are shared with other rules.
+  arma::vec ownReferenceKernels;
   //! Cached query set self-kernels (|| q || for each q).
-  arma::vec queryKernels;
+  const arma::vec& queryKernels;
   //! Cached reference set self-kernels (|| r || for each r).
-  arma::vec referenceKernels;
+  const arma::vec& referenceKernels;
 
   //! The instantiated kernel.
   KernelType& kernel;
@@ -167,6 +189,20 @@ class FastMKSRules
   //! The last kernel evaluation resulting from BaseCase().
   double lastKernel;
 
+  //! Whether the last kernels of reference nodes are held in nodeKernels
+  //! instead of in the statistics of the nodes.
+  bool ownNodeKernels;
+  //! The last kernel evaluation with each reference node, if ownNodeKernels
+  //! is true.
+  std::unordered_map<const TreeType*, double> nodeKernels;
+
+  //! Get the last kernel evaluation with the given reference node.
+  double& LastKernel(TreeType& referenceNode)
+  {
+    return ownNodeKernels ? nodeKernels[&referenceNode] :
+        referenceNode.Stat().LastKernel();
+  }
+
   //! Calculate the bound for a given query node.
   double CalculateBound(TreeType& queryNode) const;
 
@@ -25,24 +25,28 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     KernelType& kernel) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(ownCandidates),
     k(k),
+    queryKernels(ownQueryKernels),
+    referenceKernels(ownReferenceKernels),
     kernel(kernel),
     lastQueryIndex(-1),
     lastReferenceIndex(-1),
     lastKernel(0.0),
+    ownNodeKernels(false),
     baseCases(0),
     scores(0)
 {
   // Precompute each self-kernel.
-  queryKernels.set_size(querySet.n_cols);
+  ownQueryKernels.set_size(querySet.n_cols);
   for (size_t i = 0; i < querySet.n_cols; ++i)
-    queryKernels[i] = std::sqrt(kernel.Evaluate(querySet.col(i),
-                                                querySet.col(i)));
+    ownQueryKernels[i] = std::sqrt(kernel.Evaluate(querySet.col(i),
+                                                   querySet.col(i)));
 
-  referenceKernels.set_size(referenceSet.n_cols);
+  ownReferenceKernels.set_size(referenceSet.n_cols);
   for (size_t i = 0; i < referenceSet.n_cols; ++i)
-    referenceKernels[i] = std::sqrt(kernel.Evaluate(referenceSet.col(i),
-                                                    referenceSet.col(i)));
+    ownReferenceKernels[i] = std::sqrt(kernel.Evaluate(referenceSet.col(i),
+                                                       referenceSet.col(i)));
 
   // Set to invalid memory, so that the first node combination does not try to
   // dereference null pointers.
@@ -57,7 +61,30 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
 
   std::vector<Candidate> pqueue(k, def);
   std::make_heap(pqueue.begin(), pqueue.end(), CandidateCmp());
-  candidates = std::vector<std::vector<Candidate>>(querySet.n_cols, pqueue);
+  ownCandidates = std::vector<std::vector<Candidate>>(querySet.n_cols,
+      pqueue);
+}
+
+template<typename KernelType, typename TreeType>
+FastMKSRules<KernelType, TreeType>::FastMKSRules(FastMKSRules& other,
+                                                 KernelType& kernel) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    queryKernels(other.queryKernels),
+    referenceKernels(other.referenceKernels),
+    kernel(kernel),
+    lastQueryIndex(-1),
+    lastReferenceIndex(-1),
+    lastKernel(0.0),
+    ownNodeKernels(true),
+    baseCases(0),
+    scores(0)
+{
+  // As above, the first node combination must not dereference null pointers.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
 }
 
 template<typename KernelType, typename TreeType>
@@ -134,7 +161,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     double maxKernelBound;
     const double parentDist = referenceNode.ParentDistance();
     const double combinedDistBound = parentDist + furthestDist;
-    const double lastKernel = referenceNode.Parent()->Stat().LastKernel();
+    const double lastKernel = LastKernel(*referenceNode.Parent());
     if (KernelTraits<KernelType>::IsNormalized)
     {
       const double squaredDist = std::pow(combinedDistBound, 2.0);
@@ -172,7 +199,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
         referenceNode.Parent() != NULL &&
         referenceNode.Point(0) == referenceNode.Parent()->Point(0))
     {
-      kernelEval = referenceNode.Parent()->Stat().LastKernel();
+      kernelEval = LastKernel(*referenceNode.Parent());
     }
     else
     {
@@ -181,13 +208,13 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
   }
   else
   {
-    arma::vec refCenter;
+    arma::Col<typename TreeType::ElemType> refCenter;
     referenceNode.Center(refCenter);
 
     kernelEval = kernel.Evaluate(querySet.col(queryIndex), refCenter);
   }
 
-  referenceNode.Stat().LastKernel() = kernelEval;
+  LastKernel(referenceNode) = kernelEval;
 
   double maxKernel;
   if (KernelTraits<KernelType>::IsNormalized)
@@ -349,8 +376,8 @@ double FastMKSRules<KernelType, TreeType>::Score(TreeType& queryNode,
   else
   {
     // Calculate the maximum possible kernel value.
-    arma::vec queryCenter;
-    arma::vec refCenter;
+    arma::Col<typename TreeType::ElemType> queryCenter;
+    arma::Col<typename TreeType::ElemType> refCenter;
     queryNode.Center(queryCenter);
     referenceNode.Center(refCenter);
 
@@ -69,7 +69,7 @@ class FastMKSStat
     else
     {
       // Calculate the centroid.
-      arma::vec center;
+      arma::Col<typename TreeType::ElemType> center;
       node.Center(center);
 
       selfKernel = std::sqrt(node.Metric().Kernel().Evaluate(center, center));
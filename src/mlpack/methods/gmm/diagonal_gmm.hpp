@@ -20,6 +20,7 @@
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
+#include "mixture_scores.hpp"
 
 // This is the default covariance matrix constraint.
 #include "diagonal_constraint.hpp"
@@ -190,6 +191,43 @@ class DiagonalGMM
    */
   void LogProbability(const arma::mat& observation, arma::vec& logProbs) const;
 
+  /**
+   * Return the log-probability of each of the given observations, computing
+   * in single precision.  This is faster than the double-precision overload,
+   * but less accurate.
+   *
+   * @param observation Observation matrix.
+   * @param logProbs Vector to store log-probability value of observation.
+   */
+  void LogProbability(const arma::fmat& observation,
+                      arma::fvec& logProbs) const;
+
+  /**
+   * Compute the weighted log-probability log(w_k) + log(p_k(x)) of each of the
+   * given observations x under each component k of this DiagonalGMM, where w_k
+   * is the prior weight of the component.  Each row of the result corresponds
+   * to an observation, and each column to a component.  The observations are
+   * processed in blocks, in parallel, and the quadratic forms of all
+   * components are computed for each block with a single matrix
+   * multiplication, using the cached inverse covariances.
+   *
+   * @param observations Observation matrix.
+   * @param logProbs Matrix to store the log-probabilities in.
+   */
+  void ComponentLogProbability(const arma::mat& observations,
+                               arma::mat& logProbs) const;
+
+  /**
+   * Compute the weighted log-probability of each of the given observations
+   * under each component of this DiagonalGMM, computing in single precision.
+   * See the double-precision overload for details.
+   *
+   * @param observations Observation matrix.
+   * @param logProbs Matrix to store the log-probabilities in.
+   */
+  void ComponentLogProbability(const arma::fmat& observations,
+                               arma::fmat& logProbs) const;
+
   /**
    * Return the probability that the given observation came from the given
    * Gaussian component in this distribution.
@@ -299,6 +337,16 @@ class DiagonalGMM
   void Classify(const arma::mat& observations,
                 arma::Row<size_t>& labels) const;
 
+  /**
+   * Classify the given observations as being from an individual component in
+   * this DiagonalGMM, computing in single precision.
+   *
+   * @param observations List of observations to classify.
+   * @param labels Object which will be filled with labels.
+   */
+  void Classify(const arma::fmat& observations,
+                arma::Row<size_t>& labels) const;
+
   /**
    * Serialize the DiagonalGMM.
    */
@@ -306,6 +354,25 @@ class DiagonalGMM
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
+  /**
+   * Compute the weighted log-probabilities of the given observations under
+   * each component with MixtureScores(), and any of the component
+   * log-probabilities, the log-probabilities under the mixture, and the most
+   * likely component of each observation.  Outputs that are NULL are not
+   * computed.
+   *
+   * @param observations Observation matrix.
+   * @param componentLogProbs Matrix to store the component log-probabilities
+   *     in, or NULL.
+   * @param logProbs Vector to store the log-probabilities in, or NULL.
+   * @param labels Row to store the most likely components in, or NULL.
+   */
+  template<typename eT>
+  void BatchLogProbability(const arma::Mat<eT>& observations,
+                           arma::Mat<eT>* componentLogProbs,
+                           arma::Col<eT>* logProbs,
+                           arma::Row<size_t>* labels) const;
+
   /**
    * This function computes the log-likelihood of the given model and is used
    * by DiagonalGMM::Train().
@@ -162,26 +162,51 @@ inline double DiagonalGMM::LogProbability(const arma::vec& observation) const
 inline void DiagonalGMM::LogProbability(const arma::mat& observation,
                                         arma::vec& logProbs) const
 {
-  // Sum the probability for each Gaussian in our mixture (and we have to
-  // multiply by the prior for each Gaussian too).
-  logProbs.set_size(observation.n_cols);
-
-  // Store log-probability value in a matrix.
-  arma::mat logProb(observation.n_cols, gaussians);
+  BatchLogProbability(observation, (arma::mat*) NULL, &logProbs,
+      (arma::Row<size_t>*) NULL);
+}
 
-  // Assign value to the matrix.
-  for (size_t i = 0; i < gaussians; i++)
-  {
-    arma::vec temp(logProb.colptr(i), observation.n_cols, false, true);
-    dists[i].LogProbability(observation, temp);
-  }
+/**
+ * Return the log probability of the given observation GMM matrix, in single
+ * precision.
+ *
+ * @param observation Observation matrix to compute log-probabilty.
+ * @param logProbs Stores the value of log-probability for input.
+ */
+inline void DiagonalGMM::LogProbability(const arma::fmat& observation,
+                                        arma::fvec& logProbs) const
+{
+  BatchLogProbability(observation, (arma::fmat*) NULL, &logProbs,
+      (arma::Row<size_t>*) NULL);
+}
 
-  // Save log(weights) as a vector.
-  arma::vec logWeights = log(weights);
+/**
+ * Compute the weighted log-probability of each observation under each
+ * component.
+ *
+ * @param observations Observation matrix to compute log-probabilities of.
+ * @param logProbs Stores the log-probabilities.
+ */
+inline void DiagonalGMM::ComponentLogProbability(const arma::mat& observations,
+                                                 arma::mat& logProbs) const
+{
+  BatchLogProbability(observations, &logProbs, (arma::vec*) NULL,
+      (arma::Row<size_t>*) NULL);
+}
 
-  // Compute log-probability.
-  logProb += repmat(logWeights.t(), logProb.n_rows, 1);
-  LogSumExp(logProb, logProbs);
+/**
+ * Compute the weighted log-probability of each observation under each
+ * component, in single precision.
+ *
+ * @param observations Observation matrix to compute log-probabilities of.
+ * @param logProbs Stores the log-probabilities.
+ */
+inline void DiagonalGMM::ComponentLogProbability(
+    const arma::fmat& observations,
+    arma::fmat& logProbs) const
+{
+  BatchLogProbability(observations, &logProbs, (arma::fvec*) NULL,
+      (arma::Row<size_t>*) NULL);
 }
 
 /**
@@ -261,25 +286,78 @@ inline arma::vec DiagonalGMM::Random() const
 inline void DiagonalGMM::Classify(const arma::mat& observations,
                                   arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
+  BatchLogProbability(observations, (arma::mat*) NULL, (arma::vec*) NULL,
+      &labels);
+}
+
+/**
+ * Classify the given observations as being from an individual component in
+ * this GMM, in single precision.
+ */
+inline void DiagonalGMM::Classify(const arma::fmat& observations,
+                                  arma::Row<size_t>& labels) const
+{
+  BatchLogProbability(observations, (arma::fmat*) NULL, (arma::fvec*) NULL,
+      &labels);
+}
 
-  // We should not have to fill this with values, because each one should be
-  // overwritten.
-  labels.set_size(observations.n_cols);
-  for (size_t i = 0; i < observations.n_cols; ++i)
+/**
+ * Compute the weighted log-probabilities of the given observations under each
+ * component, block by block.
+ */
+template<typename eT>
+void DiagonalGMM::BatchLogProbability(const arma::Mat<eT>& observations,
+                                      arma::Mat<eT>* componentLogProbs,
+                                      arma::Col<eT>* logProbs,
+                                      arma::Row<size_t>* labels) const
+{
+  // The observations are centered on the mean of the mixture, to lose less
+  // precision when computing in single precision.
+  arma::vec center(dimensionality, arma::fill::zeros);
+  for (size_t i = 0; i < gaussians; ++i)
+    center += weights[i] * dists[i].Mean();
+
+  // The quadratic form of component i is
+  //   sum_d (x_d^2 a_id - 2 x_d mu_id a_id + mu_id^2 a_id),
+  // where a_i is the inverse of the diagonal covariance.  So, if the
+  // coefficients [a_i; -2 mu_i % a_i] of all components are the columns of one
+  // matrix, the quadratic forms of all components are computed with one matrix
+  // multiplication with [x % x; x].
+  const double log2pi = std::log(2.0 * M_PI);
+  arma::Mat<eT> coefficients(2 * dimensionality, gaussians);
+  arma::Col<eT> constants(gaussians);
+  for (size_t i = 0; i < gaussians; ++i)
   {
-    // Find maximum probability component.
-    double probability = 0;
-    for (size_t j = 0; j < gaussians; ++j)
-    {
-      double newProb = Probability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
-      {
-        probability = newProb;
-        labels[i] = j;
-      }
-    }
+    const arma::vec& invCov = dists[i].InvCov();
+    const arma::vec mean = dists[i].Mean() - center;
+    coefficients.submat(0, i, dimensionality - 1, i) =
+        arma::conv_to<arma::Col<eT>>::from(invCov);
+    coefficients.submat(dimensionality, i, 2 * dimensionality - 1, i) =
+        arma::conv_to<arma::Col<eT>>::from(-2 * mean % invCov);
+    constants[i] = eT(std::log(weights[i]) - 0.5 * dimensionality * log2pi -
+        0.5 * dists[i].LogDetCov() - 0.5 * arma::dot(mean % mean, invCov));
   }
+  const arma::Col<eT> eTCenter = arma::conv_to<arma::Col<eT>>::from(center);
+
+  auto blockScores = [&](const size_t begin,
+                         const size_t end,
+                         arma::Mat<eT>& scores)
+  {
+    arma::Mat<eT> features(2 * dimensionality, end - begin);
+    features.rows(dimensionality, 2 * dimensionality - 1) =
+        observations.cols(begin, end - 1);
+    features.rows(dimensionality, 2 * dimensionality - 1).each_col() -=
+        eTCenter;
+    features.rows(0, dimensionality - 1) =
+        arma::square(features.rows(dimensionality, 2 * dimensionality - 1));
+
+    scores = coefficients.t() * features;
+    scores *= eT(-0.5);
+    scores.each_col() += constants;
+  };
+
+  MixtureScores(observations, gaussians, blockScores, componentLogProbs,
+      logProbs, labels);
 }
 
 /**
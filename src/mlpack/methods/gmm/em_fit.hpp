@@ -146,19 +146,44 @@ class EMFit
       arma::vec& weights);
 
   /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
-   * to determine if the EM algorithm has converged.
+   * Perform the E-step: compute the conditional log-probability of each
+   * Gaussian given each observation under the given model, and return the
+   * log-likelihood of the model, which is found along the way.  Yes, the
+   * log-likelihood is reimplemented in the GMM code.  Intuition suggests that
+   * the log-likelihood is not the best way to determine if the EM algorithm has
+   * converged.
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param dists Distributions to store model in.
+   * The observations are processed in blocks, in parallel.
+   *
+   * @param observations List of observations.
+   * @param dists Distributions of the model.
    * @param weights Vector of a priori weights.
+   * @param condLogProb Matrix to store the conditional log-probabilities in
+   *      (one row per observation, one column per Gaussian).
    */
-  double LogLikelihood(
-      const arma::mat& data,
+  double Expectation(
+      const arma::mat& observations,
       const std::vector<Distribution>& dists,
-      const arma::vec& weights) const;
+      const arma::vec& weights,
+      arma::mat& condLogProb) const;
+
+  /**
+   * Perform the M-step: update the mean and covariance of each Gaussian given
+   * the normalized weight of each observation for each Gaussian.  Gaussians
+   * whose total log-probability is -inf are not updated.  The covariances are
+   * accumulated over blocks of observations in parallel, then reduced.
+   *
+   * @param observations List of observations.
+   * @param responsibilities Weight of each observation (row) for each Gaussian
+   *      (column); each column sums to one.
+   * @param probRowSums Total log-probability of each Gaussian.
+   * @param dists Distributions to update.
+   */
+  void Maximization(
+      const arma::mat& observations,
+      const arma::mat& responsibilities,
+      const arma::vec& probRowSums,
+      std::vector<Distribution>& dists);
 
   /**
    * Use the Armadillo gmm_diag clusterer to train a GMM with diagonal
@@ -69,13 +69,13 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  arma::mat condLogProb;
+  double l = Expectation(observations, dists, weights, condLogProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -84,80 +84,33 @@ Estimate(const arma::mat& observations,
     Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
         << "log-likelihood " << l << "." << std::endl;
 
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += std::log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
-
-    // Store the sum of the probability of each state over all the observations.
+    // condLogProb holds the conditional log-probabilities of choosing each
+    // Gaussian given the observations and the present theta value.  Store the
+    // sum of the probability of each state over all the observations, and turn
+    // condLogProb into the normalized weights of the observations for each
+    // Gaussian.
     arma::vec probRowSums(dists.size());
+    #pragma omp parallel for num_threads((int) NumThreads())
     for (size_t i = 0; i < dists.size(); ++i)
     {
-      probRowSums(i) = AccuLog(condLogProb.col(i));
-    }
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
+      probRowSums[i] = AccuLog(condLogProb.col(i));
       if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-        dists[i].Mean() = observations * exp(condLogProb.col(i) -
-                                                   probRowSums[i]);
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution, DiagonalGaussianDistribution>::value)
-      {
-        arma::vec covariance = sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(exp(condLogProb.col(i) - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
+        condLogProb.col(i) = exp(condLogProb.col(i) - probRowSums[i]);
       else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(exp(condLogProb.col(i) -
-                                                          probRowSums[i]));
-        arma::mat covariance = tmp * trans(tmpB);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
+        condLogProb.col(i).zeros();
     }
 
+    // Calculate the new values of the means and covariances.
+    Maximization(observations, condLogProb, probRowSums, dists);
+
     // Calculate the new values for omega using the updated conditional
     // probabilities.
     weights = exp(probRowSums - std::log(observations.n_cols));
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood and the conditional
+    // probabilities for the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = Expectation(observations, dists, weights, condLogProb);
 
     iteration++;
   }
@@ -176,100 +129,49 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  arma::mat condLogProb;
+  double l = Expectation(observations, dists, weights, condLogProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
+  const arma::vec logProbabilities = log(probabilities);
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += std::log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
-
-    // This will store the sum of probabilities of each state over all the
-    // observations.
+    // condLogProb holds the conditional log-probabilities of choosing each
+    // Gaussian given the observations and the present theta value.  Calculate
+    // the sum of probabilities of points for each Gaussian, which is the
+    // conditional probability of each point being from Gaussian i multiplied
+    // by the probability of the point being from this mixture model, and turn
+    // condLogProb into the normalized weights of the observations for each
+    // Gaussian.
     arma::vec probRowSums(dists.size());
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    arma::vec logProbabilities = log(probabilities);
+    #pragma omp parallel for num_threads((int) NumThreads())
     for (size_t i = 0; i < dists.size(); ++i)
     {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      arma::vec tmpProb = condLogProb.col(i) + logProbabilities;
-      probRowSums[i] = AccuLog(tmpProb);
-
-      // Don't update if there's no probability of the Gaussian having points.
+      condLogProb.col(i) += logProbabilities;
+      probRowSums[i] = AccuLog(condLogProb.col(i));
       if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-      {
-        dists[i].Mean() = observations *
-              exp(condLogProb.col(i) + logProbabilities - probRowSums[i]);
-      }
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution, DiagonalGaussianDistribution>::value)
-      {
-        arma::vec cov = sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(exp(condLogProb.col(i) +
-                            logProbabilities - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
+        condLogProb.col(i) = exp(condLogProb.col(i) - probRowSums[i]);
       else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(exp(condLogProb.col(i) +
-            logProbabilities - probRowSums[i]));
-        arma::mat cov = (tmp * trans(tmpB));
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
+        condLogProb.col(i).zeros();
     }
 
+    // Calculate the new values of the means and covariances.
+    Maximization(observations, condLogProb, probRowSums, dists);
+
     // Calculate the new values for omega using the updated conditional
     // probabilities.
     weights = exp(probRowSums - AccuLog(logProbabilities));
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood and the conditional
+    // probabilities for the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = Expectation(observations, dists, weights, condLogProb);
 
     iteration++;
   }
@@ -373,34 +275,157 @@ template<typename InitialClusteringType,
          typename CovarianceConstraintPolicy,
          typename Distribution>
 double EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
-LogLikelihood(const arma::mat& observations,
-              const std::vector<Distribution>& dists,
-              const arma::vec& weights) const
+Expectation(const arma::mat& observations,
+            const std::vector<Distribution>& dists,
+            const arma::vec& weights,
+            arma::mat& condLogProb) const
 {
+  condLogProb.set_size(observations.n_cols, dists.size());
+  const arma::vec logWeights = log(weights);
+
+  // The observations are split into blocks, so that each thread only needs
+  // temporary memory for one block.
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+
   double logLikelihood = 0;
+  #pragma omp parallel for schedule(dynamic) reduction(+:logLikelihood) \
+      num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min((size_t) observations.n_cols,
+        begin + blockSize);
+    const arma::mat block = observations.cols(begin, end - 1);
+
+    // It has to be LogProbability() otherwise Probability() would overflow
+    // easily.
+    arma::vec logPhis;
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      dists[i].LogProbability(block, logPhis);
+      condLogProb.submat(begin, i, end - 1, i) = logPhis + logWeights[i];
+    }
+
+    // Normalize row-wise, and sum the log-likelihood over every point.
+    for (size_t j = begin; j < end; ++j)
+    {
+      // Avoid dividing by zero; if the probability for everything is 0, we
+      // don't want to make it NaN.
+      const double probSum = AccuLog(condLogProb.row(j));
+      if (probSum != -std::numeric_limits<double>::infinity())
+      {
+        condLogProb.row(j) -= probSum;
+      }
+      else
+      {
+        #pragma omp critical
+        {
+          Log::Info << "Likelihood of point " << j << " is 0!  It is probably "
+              << "an outlier." << std::endl;
+        }
+      }
+
+      logLikelihood += probSum;
+    }
+  }
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+Maximization(const arma::mat& observations,
+             const arma::mat& responsibilities,
+             const arma::vec& probRowSums,
+             std::vector<Distribution>& dists)
+{
+  // If the distribution is DiagonalGaussianDistribution, calculate the
+  // covariance only with diagonal components.
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      DiagonalGaussianDistribution>::value;
 
-  arma::vec logPhis;
-  arma::mat logLikelihoods(dists.size(), observations.n_cols);
+  // Calculate the new value of the means using the updated conditional
+  // probabilities, all at once.
+  const arma::mat means = observations * responsibilities;
 
-  // It has to be LogProbability() otherwise Probability() would overflow easily
+  // Calculate the new value of the covariances using the updated conditional
+  // probabilities and the updated means.  Each thread accumulates the
+  // covariances of its blocks of observations, and the results are summed.
+  std::vector<arma::mat> covs(dists.size());
   for (size_t i = 0; i < dists.size(); ++i)
   {
-    dists[i].LogProbability(observations, logPhis);
-    logLikelihoods.row(i) = std::log(weights(i)) + trans(logPhis);
+    covs[i].zeros(observations.n_rows, isDiagGaussDist ? 1 :
+        observations.n_rows);
   }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel num_threads((int) NumThreads())
   {
-    if (AccuLog(logLikelihoods.col(j)) ==
-        -std::numeric_limits<double>::infinity())
+    std::vector<arma::mat> localCovs(dists.size());
+    for (size_t i = 0; i < dists.size(); ++i)
+      localCovs[i].zeros(covs[i].n_rows, covs[i].n_cols);
+
+    #pragma omp for schedule(dynamic)
+    for (size_t b = 0; b < numBlocks; ++b)
     {
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
+      const size_t begin = b * blockSize;
+      const size_t end = std::min((size_t) observations.n_cols,
+          begin + blockSize);
+      for (size_t i = 0; i < dists.size(); ++i)
+      {
+        // Don't update if there's no probability of the Gaussian having
+        // points.
+        if (probRowSums[i] == -std::numeric_limits<double>::infinity())
+          continue;
+
+        arma::mat tmp = observations.cols(begin, end - 1);
+        tmp.each_col() -= means.col(i);
+        const arma::rowvec r =
+            responsibilities.submat(begin, i, end - 1, i).t();
+
+        if (isDiagGaussDist)
+          localCovs[i] += (tmp % tmp) * r.t();
+        else
+          localCovs[i] += (tmp.each_row() % r) * tmp.t();
+      }
+    }
+
+    #pragma omp critical
+    {
+      for (size_t i = 0; i < dists.size(); ++i)
+        covs[i] += localCovs[i];
     }
-    logLikelihood += AccuLog(logLikelihoods.col(j));
   }
 
-  return logLikelihood;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (probRowSums[i] == -std::numeric_limits<double>::infinity())
+      continue;
+
+    dists[i].Mean() = means.col(i);
+    if (isDiagGaussDist)
+    {
+      arma::vec covariance = covs[i];
+
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariance);
+      dists[i].Covariance(std::move(covariance));
+    }
+    else
+    {
+      arma::mat covariance = std::move(covs[i]);
+
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariance);
+      dists[i].Covariance(std::move(covariance));
+    }
+  }
 }
 
 template<typename InitialClusteringType,
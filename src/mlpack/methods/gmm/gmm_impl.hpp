@@ -79,26 +79,50 @@ inline double GMM::LogProbability(const arma::vec& observation) const
 inline void GMM::LogProbability(const arma::mat& observation,
                                 arma::vec& logProbs) const
 {
-  // Sum the probability for each Gaussian in our mixture (and we have to
-  // multiply by the prior for each Gaussian too).
-  logProbs.set_size(observation.n_cols);
-
-  // Store log-probability value in a matrix.
-  arma::mat logProb(observation.n_cols, gaussians);
+  BatchLogProbability(observation, (arma::mat*) NULL, &logProbs,
+      (arma::Row<size_t>*) NULL);
+}
 
-  // Assign value to the matrix.
-  for (size_t i = 0; i < gaussians; i++)
-  {
-    arma::vec temp(logProb.colptr(i), observation.n_cols, false, true);
-    dists[i].LogProbability(observation, temp);
-  }
+/**
+ * Return the log probability of the given observation GMM matrix, in single
+ * precision.
+ *
+ * @param observation Observation matrix to compute log-probabilty.
+ * @param logProbs Stores the value of log-probability for Observation.
+ */
+inline void GMM::LogProbability(const arma::fmat& observation,
+                                arma::fvec& logProbs) const
+{
+  BatchLogProbability(observation, (arma::fmat*) NULL, &logProbs,
+      (arma::Row<size_t>*) NULL);
+}
 
-  // Save log(weights) as a vector.
-  arma::vec logWeights = log(weights);
+/**
+ * Compute the weighted log-probability of each observation under each
+ * component.
+ *
+ * @param observations Observation matrix to compute log-probabilities of.
+ * @param logProbs Stores the log-probabilities.
+ */
+inline void GMM::ComponentLogProbability(const arma::mat& observations,
+                                         arma::mat& logProbs) const
+{
+  BatchLogProbability(observations, &logProbs, (arma::vec*) NULL,
+      (arma::Row<size_t>*) NULL);
+}
 
-  // Compute log-probability.
-  logProb += repmat(logWeights.t(), logProb.n_rows, 1);
-  LogSumExp(logProb, logProbs);
+/**
+ * Compute the weighted log-probability of each observation under each
+ * component, in single precision.
+ *
+ * @param observations Observation matrix to compute log-probabilities of.
+ * @param logProbs Stores the log-probabilities.
+ */
+inline void GMM::ComponentLogProbability(const arma::fmat& observations,
+                                         arma::fmat& logProbs) const
+{
+  BatchLogProbability(observations, &logProbs, (arma::fvec*) NULL,
+      (arma::Row<size_t>*) NULL);
 }
 
 /**
@@ -194,27 +218,89 @@ inline arma::vec GMM::Random() const
 inline void GMM::Classify(const arma::mat& observations,
                           arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
+  BatchLogProbability(observations, (arma::mat*) NULL, (arma::vec*) NULL,
+      &labels);
+}
+
+/**
+ * Classify the given observations as being from an individual component in this
+ * GMM, in single precision.
+ *
+ * @param observation Observation matrix for classification.
+ * @param labels Save the labels for the given observation matrix.
+ */
+inline void GMM::Classify(const arma::fmat& observations,
+                          arma::Row<size_t>& labels) const
+{
+  BatchLogProbability(observations, (arma::fmat*) NULL, (arma::fvec*) NULL,
+      &labels);
+}
 
-  // We should not have to fill this with values, because each one should be
-  // overwritten.
-  labels.set_size(observations.n_cols);
-  for (size_t i = 0; i < observations.n_cols; ++i)
+/**
+ * Compute the weighted log-probabilities of the given observations under each
+ * component, block by block.
+ */
+template<typename eT>
+void GMM::BatchLogProbability(const arma::Mat<eT>& observations,
+                              arma::Mat<eT>* componentLogProbs,
+                              arma::Col<eT>* logProbs,
+                              arma::Row<size_t>* labels) const
+{
+  // The observations are centered on the mean of the mixture, to lose less
+  // precision when computing in single precision.
+  arma::vec center(dimensionality, arma::fill::zeros);
+  for (size_t i = 0; i < gaussians; ++i)
+    center += weights[i] * dists[i].Mean();
+
+  // If invCov_i = R_i^T R_i, then the quadratic form of component i is
+  // ||R_i (x - mu_i)||^2; R_i is the inverse of the Cholesky factor of the
+  // covariance, which each component caches.  The factors of all components
+  // are stacked, so that R_i x is computed for all components with one matrix
+  // multiplication.
+  const double log2pi = std::log(2.0 * M_PI);
+  arma::Mat<eT> factors(gaussians * dimensionality, dimensionality);
+  arma::Col<eT> offsets(gaussians * dimensionality);
+  arma::Col<eT> constants(gaussians);
+  for (size_t i = 0; i < gaussians; ++i)
   {
-    // Find maximum probability component.
-    double probability = -std::numeric_limits<double>::infinity();
-    for (size_t j = 0; j < gaussians; ++j)
+    const arma::mat& factor = dists[i].InvCovLower();
+
+    const size_t first = i * dimensionality;
+    const size_t last = (i + 1) * dimensionality - 1;
+    factors.rows(first, last) = arma::conv_to<arma::Mat<eT>>::from(factor);
+    offsets.subvec(first, last) = arma::conv_to<arma::Col<eT>>::from(
+        factor * (dists[i].Mean() - center));
+    constants[i] = eT(std::log(weights[i]) - 0.5 * dimensionality * log2pi -
+        0.5 * dists[i].LogDetCov());
+  }
+  const arma::Col<eT> eTCenter = arma::conv_to<arma::Col<eT>>::from(center);
+
+  auto blockScores = [&](const size_t begin,
+                         const size_t end,
+                         arma::Mat<eT>& scores)
+  {
+    arma::Mat<eT> block = observations.cols(begin, end - 1);
+    block.each_col() -= eTCenter;
+    arma::Mat<eT> projections = factors * block;
+    projections.each_col() -= offsets;
+
+    scores.set_size(gaussians, end - begin);
+    for (size_t j = 0; j < scores.n_cols; ++j)
     {
-      // We have to use LogProbability() otherwise Probability() would overflow
-      // easily.
-      double newProb = LogProbability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
+      const eT* projection = projections.colptr(j);
+      for (size_t i = 0; i < gaussians; ++i)
       {
-        probability = newProb;
-        labels[i] = j;
+        const eT* z = projection + i * dimensionality;
+        eT quadratic = 0;
+        for (size_t d = 0; d < dimensionality; ++d)
+          quadratic += z[d] * z[d];
+        scores(i, j) = constants[i] - quadratic / 2;
       }
     }
-  }
+  };
+
+  MixtureScores(observations, gaussians, blockScores, componentLogProbs,
+      logProbs, labels);
 }
 
 /**
@@ -37,7 +37,15 @@ BINDING_LONG_DESC(
     PRINT_PARAM_STRING("input_model") + " parameter, and the points are "
     "specified with the " + PRINT_PARAM_STRING("input") + " parameter.  The "
     "output probabilities may be saved via the " +
-    PRINT_PARAM_STRING("output") + " output parameter.");
+    PRINT_PARAM_STRING("output") + " output parameter."
+    "\n\n"
+    "The log-probability of each point under each weighted component of the "
+    "GMM (that is, log(w_k) + log(P(X | component k))) may be saved via the " +
+    PRINT_PARAM_STRING("component_output") + " output parameter; each row of "
+    "that matrix corresponds to a point, and each column to a component.  If "
+    "the " + PRINT_PARAM_STRING("single_precision") + " flag is given, the "
+    "probabilities are computed in single precision, which is faster but less "
+    "accurate.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -61,10 +69,14 @@ PARAM_MATRIX_IN_REQ("input", "Input matrix to calculate probabilities of.",
     "i");
 
 PARAM_MATRIX_OUT("output", "Matrix to store calculated probabilities in.", "o");
+PARAM_MATRIX_OUT("component_output", "Matrix to store the log-probability "
+    "of each point under each weighted component in.", "c");
+PARAM_FLAG("single_precision", "If set, compute the probabilities in single "
+    "precision.", "s");
 
 void BINDING_FUNCTION(util::Params& params, util::Timers& /* timers */)
 {
-  RequireAtLeastOnePassed(params, { "output" }, false,
+  RequireAtLeastOnePassed(params, { "output", "component_output" }, false,
       "no results will be saved");
 
   // Get the GMM and the points.
@@ -72,11 +84,32 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& /* timers */)
 
   arma::mat dataset = std::move(params.Get<arma::mat>("input"));
 
-  // Now calculate the probabilities.
-  arma::rowvec probabilities(dataset.n_cols);
-  for (size_t i = 0; i < dataset.n_cols; ++i)
-    probabilities[i] = gmm->Probability(dataset.unsafe_col(i));
+  // Now calculate the log-probabilities of all points at once.
+  arma::mat componentLogProbs;
+  arma::vec logProbs;
+  if (params.Has("single_precision"))
+  {
+    const arma::fmat fDataset = arma::conv_to<arma::fmat>::from(dataset);
+    arma::fvec fLogProbs;
+    gmm->LogProbability(fDataset, fLogProbs);
+    logProbs = arma::conv_to<arma::vec>::from(fLogProbs);
 
-  // And save the result.
-  params.Get<arma::mat>("output") = std::move(probabilities);
+    if (params.Has("component_output"))
+    {
+      arma::fmat fComponentLogProbs;
+      gmm->ComponentLogProbability(fDataset, fComponentLogProbs);
+      componentLogProbs = arma::conv_to<arma::mat>::from(fComponentLogProbs);
+    }
+  }
+  else
+  {
+    gmm->LogProbability(dataset, logProbs);
+    if (params.Has("component_output"))
+      gmm->ComponentLogProbability(dataset, componentLogProbs);
+  }
+
+  // And save the results.
+  params.Get<arma::mat>("output") = arma::exp(logProbs).t();
+  if (params.Has("component_output"))
+    params.Get<arma::mat>("component_output") = componentLogProbs.t();
 }
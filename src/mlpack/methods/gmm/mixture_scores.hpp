@@ -0,0 +1,119 @@
+/**
+ * @file methods/gmm/mixture_scores.hpp
+ *
+ * Blocked computation of the log-probabilities of a matrix of observations
+ * under each component of a mixture model, shared by GMM and DiagonalGMM.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_MIXTURE_SCORES_HPP
+#define MLPACK_METHODS_GMM_MIXTURE_SCORES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
+
+namespace mlpack {
+
+//! The number of observations whose scores are computed at once by
+//! MixtureScores().
+static constexpr size_t MixtureScoresBlockSize = 1024;
+
+/**
+ * Compute the weighted log-probabilities of the given observations under each
+ * component of a mixture, block by block, and reduce them while each block is
+ * still in cache.  For each block of observations, blockScores(begin, end,
+ * scores) must fill `scores` with one row per component and one column per
+ * observation of observations.cols(begin, end - 1), where each element is
+ * log(w_k) + log(p_k(x)).  Then, for each observation, the log-sum-exp over the
+ * components (the log-probability of the observation under the mixture) and
+ * the component with the largest score are found.  Blocks are processed in
+ * parallel.
+ *
+ * Any of the outputs may be NULL, in which case it is not computed.
+ *
+ * @param observations Observations to score (one per column).
+ * @param components Number of components in the mixture.
+ * @param blockScores Function that computes the scores of a block.
+ * @param componentLogProbs If not NULL, set to the weighted log-probability of
+ *     each observation (row) under each component (column).
+ * @param logProbs If not NULL, set to the log-probability of each observation
+ *     under the mixture.
+ * @param labels If not NULL, set to the index of the most likely component of
+ *     each observation.
+ */
+template<typename eT, typename BlockScoresType>
+inline void MixtureScores(const arma::Mat<eT>& observations,
+                          const size_t components,
+                          const BlockScoresType& blockScores,
+                          arma::Mat<eT>* componentLogProbs,
+                          arma::Col<eT>* logProbs,
+                          arma::Row<size_t>* labels)
+{
+  const size_t n = observations.n_cols;
+  if (componentLogProbs)
+    componentLogProbs->set_size(n, components);
+  if (logProbs)
+    logProbs->set_size(n);
+  if (labels)
+    labels->set_size(n);
+
+  const size_t numBlocks = (n + MixtureScoresBlockSize - 1) /
+      MixtureScoresBlockSize;
+
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    arma::Mat<eT> scores;
+
+    #pragma omp for schedule(dynamic)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * MixtureScoresBlockSize;
+      const size_t end = std::min(n, begin + MixtureScoresBlockSize);
+      blockScores(begin, end, scores);
+
+      if (componentLogProbs)
+        componentLogProbs->rows(begin, end - 1) = scores.t();
+
+      for (size_t j = 0; j < scores.n_cols; ++j)
+      {
+        // The scores of one observation are contiguous.
+        const eT* s = scores.colptr(j);
+        eT maxScore = -std::numeric_limits<eT>::infinity();
+        size_t maxIndex = 0;
+        for (size_t k = 0; k < components; ++k)
+        {
+          if (s[k] >= maxScore)
+          {
+            maxScore = s[k];
+            maxIndex = k;
+          }
+        }
+
+        if (labels)
+          (*labels)[begin + j] = maxIndex;
+
+        if (logProbs)
+        {
+          // Avoid computing -inf - -inf if every score is -inf.
+          if (maxScore == -std::numeric_limits<eT>::infinity())
+          {
+            (*logProbs)[begin + j] = maxScore;
+            continue;
+          }
+
+          eT sum = 0;
+          for (size_t k = 0; k < components; ++k)
+            sum += std::exp(s[k] - maxScore);
+          (*logProbs)[begin + j] = maxScore + std::log(sum);
+        }
+      }
+    }
+  }
+}
+
+} // namespace mlpack
+
+#endif
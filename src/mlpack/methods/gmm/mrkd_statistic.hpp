@@ -0,0 +1,150 @@
+/**
+ * @file methods/gmm/mrkd_statistic.hpp
+ *
+ * The statistic used in mrkd-trees by TreeEMFit, which caches the sufficient
+ * statistics of the points of a node.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_MRKD_STATISTIC_HPP
+#define MLPACK_METHODS_GMM_MRKD_STATISTIC_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * A statistic for trees which holds the sufficient statistics of the points of
+ * a node for fitting Gaussians: their (weighted) count, their mean, and their
+ * scatter matrix (the sum of the outer products of their deviations from the
+ * mean).  If every point of a node has nearly the same responsibility for each
+ * Gaussian, the statistics of the node can be used in the EM algorithm instead
+ * of its points.
+ *
+ * The statistics are centered, and statistics of several sets of points are
+ * merged with Chan et al.'s formula, so that the covariance is not computed as
+ * the difference of two large numbers when the points are far from the origin.
+ */
+class MRKDStatistic
+{
+ public:
+  //! Initialize the statistic without a node (this does nothing).
+  MRKDStatistic() : count(0.0) { }
+
+  //! Initialize the statistic for a node; this computes the unweighted
+  //! statistics of its points from those of its children.
+  template<typename TreeType>
+  MRKDStatistic(TreeType& node) : count(0.0)
+  {
+    mean.zeros(node.Dataset().n_rows);
+    scatter.zeros(node.Dataset().n_rows, node.Dataset().n_rows);
+
+    // The children must already have been built.
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      Merge(count, mean, scatter, node.Child(i).Stat().Count(),
+          node.Child(i).Stat().Mean(), node.Child(i).Stat().Scatter());
+    }
+
+    for (size_t i = 0; i < node.NumPoints(); ++i)
+      Merge(count, mean, scatter, 1.0, node.Dataset().col(node.Point(i)));
+  }
+
+  /**
+   * Merge the (weighted) count, mean and scatter matrix of a set of points
+   * with those of another set of points, so that they become those of both
+   * sets.
+   *
+   * @param count Count of the first set; set to the total count.
+   * @param mean Mean of the first set; set to the merged mean.
+   * @param scatter Scatter matrix of the first set; set to the merged scatter
+   *     matrix.
+   * @param otherCount Count of the second set.
+   * @param otherMean Mean of the second set.
+   * @param otherScatter Scatter matrix of the second set.
+   */
+  static void Merge(double& count,
+                    arma::vec& mean,
+                    arma::mat& scatter,
+                    const double otherCount,
+                    const arma::vec& otherMean,
+                    const arma::mat& otherScatter)
+  {
+    if (otherCount == 0.0)
+      return;
+
+    if (count == 0.0)
+    {
+      count = otherCount;
+      mean = otherMean;
+      scatter = otherScatter;
+      return;
+    }
+
+    const double total = count + otherCount;
+    const arma::vec delta = otherMean - mean;
+    mean += (otherCount / total) * delta;
+    scatter += otherScatter + (count * (otherCount / total)) *
+        (delta * delta.t());
+    count = total;
+  }
+
+  /**
+   * Add a single point with the given weight to the (weighted) count, mean
+   * and scatter matrix of a set of points.  mean and scatter must have the
+   * right size, even if count is 0.
+   *
+   * @param count Count of the set; set to the total count.
+   * @param mean Mean of the set; set to the new mean.
+   * @param scatter Scatter matrix of the set; set to the new scatter matrix.
+   * @param weight Weight of the point.
+   * @param point Point to add.
+   */
+  template<typename VecType>
+  static void Merge(double& count,
+                    arma::vec& mean,
+                    arma::mat& scatter,
+                    const double weight,
+                    const VecType& point)
+  {
+    if (weight == 0.0)
+      return;
+
+    const double total = count + weight;
+    const arma::vec delta = point - mean;
+    mean += (weight / total) * delta;
+    scatter += (count * (weight / total)) * (delta * delta.t());
+    count = total;
+  }
+
+  //! Get the (weighted) number of points of the node.
+  double Count() const { return count; }
+  //! Modify the (weighted) number of points of the node.
+  double& Count() { return count; }
+
+  //! Get the (weighted) mean of the points of the node.
+  const arma::vec& Mean() const { return mean; }
+  //! Modify the (weighted) mean of the points of the node.
+  arma::vec& Mean() { return mean; }
+
+  //! Get the (weighted) scatter matrix of the points of the node.
+  const arma::mat& Scatter() const { return scatter; }
+  //! Modify the (weighted) scatter matrix of the points of the node.
+  arma::mat& Scatter() { return scatter; }
+
+ private:
+  //! The (weighted) number of points.
+  double count;
+  //! The (weighted) mean of the points.
+  arma::vec mean;
+  //! The (weighted) sum of the outer products of the deviations of the points
+  //! from their mean.
+  arma::mat scatter;
+};
+
+} // namespace mlpack
+
+#endif
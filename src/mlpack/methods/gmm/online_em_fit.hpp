@@ -0,0 +1,274 @@
+/**
+ * @file methods/gmm/online_em_fit.hpp
+ *
+ * Utility class to fit a GMM with online (stepwise) EM on mini-batches.  Used
+ * by GMM::Train<>(), or directly on streamed chunks of data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/dists.hpp>
+
+// Default clustering mechanism.
+#include <mlpack/methods/kmeans/kmeans.hpp>
+// Default covariance matrix constraint.
+#include "positive_definite_constraint.hpp"
+
+namespace mlpack {
+
+/**
+ * This class fits a GMM to observations with online EM (also known as
+ * stepwise EM): instead of computing the responsibilities of all points before
+ * each M-step, the responsibilities are computed for one mini-batch at a time,
+ * and the running sufficient statistics of the model (the weight, and the
+ * weighted mean and second moment of each Gaussian) are moved towards the
+ * statistics of the mini-batch with step size
+ *
+ *   gamma_t = (t + stepSizeOffset)^(-stepSizeExponent),
+ *
+ * after which the model is recomputed from them.  The running statistics are
+ * the (normalized) parameters of the model itself, so the only state kept
+ * between steps is the step count t; the cost of a step and the memory used
+ * only depend on the size of the mini-batch.  For convergence, the exponent
+ * should be in (0.5, 1].
+ *
+ * Estimate() makes a number of passes over the observations in random
+ * mini-batches (there is no convergence test), and can be used with
+ * GMM::Train().  Update() takes a single step with the given mini-batch, so
+ * that a model can be refit from streamed chunks of data without holding
+ * them all in memory:
+ *
+ * @code
+ * OnlineEMFit<> fitter;
+ * std::vector<GaussianDistribution> dists(gmm.Gaussians());
+ * for (size_t i = 0; i < gmm.Gaussians(); ++i)
+ *   dists[i] = gmm.Component(i);
+ * arma::vec weights = gmm.Weights();
+ *
+ * arma::mat chunk;
+ * while (loader.Next(chunk))
+ *   fitter.Update(chunk, dists, weights);
+ *
+ * gmm = GMM(dists, weights);
+ * @endcode
+ *
+ * For more information, see the following papers.
+ *
+ * @code
+ * @article{cappe2009online,
+ *   title={On-line Expectation-Maximization Algorithm for Latent Data
+ *       Models},
+ *   author={Capp{\'e}, Olivier and Moulines, Eric},
+ *   journal={Journal of the Royal Statistical Society: Series B},
+ *   volume={71},
+ *   number={3},
+ *   pages={593--613},
+ *   year={2009}
+ * }
+ *
+ * @inproceedings{liang2009online,
+ *   title={Online {EM} for Unsupervised Models},
+ *   author={Liang, Percy and Klein, Dan},
+ *   booktitle={Proceedings of Human Language Technologies: The 2009 Annual
+ *       Conference of the North American Chapter of the ACL},
+ *   pages={611--619},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * The clustering mechanism must implement the same Cluster() method as for
+ * EMFit; it is run on the first mini-batch only.
+ */
+template<typename InitialClusteringType = KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint>
+class OnlineEMFit
+{
+ public:
+  /**
+   * Construct the OnlineEMFit object, optionally passing an
+   * InitialClusteringType object (just in case it needs to store state).
+   *
+   * @param batchSize Number of points in each mini-batch.
+   * @param maxEpochs Number of passes over the observations in Estimate().
+   * @param stepSizeExponent Exponent of the step size schedule.
+   * @param stepSizeOffset Offset of the step count in the step size schedule.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   */
+  OnlineEMFit(const size_t batchSize = 1000,
+              const size_t maxEpochs = 5,
+              const double stepSizeExponent = 0.6,
+              const double stepSizeOffset = 2.0,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) with online EM.
+   * The size of the vectors (indicating the number of components) must
+   * already be set.  If useInitialModel is set to true, then the model given
+   * in the dists and weights parameters is used as the initial model, and the
+   * step count continues from StepCount(); otherwise, the step count is reset
+   * and the initial model comes from the InitialClusteringType::Cluster() on
+   * the first mini-batch.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) with online EM,
+   * taking into account the probabilities of each point being from this
+   * mixture.  See the other overload of Estimate() for details.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Take one step of online EM with the given mini-batch, updating the given
+   * model, which must already be initialized.
+   *
+   * @param observations Mini-batch of observations.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   * @return The log-likelihood of the mini-batch under the model before the
+   *      step.
+   */
+  double Update(const arma::mat& observations,
+                std::vector<GaussianDistribution>& dists,
+                arma::vec& weights);
+
+  /**
+   * Take one step of online EM with the given mini-batch and the probability
+   * of each of its points being from this mixture, updating the given model,
+   * which must already be initialized.
+   *
+   * @param observations Mini-batch of observations.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   * @return The log-likelihood of the mini-batch under the model before the
+   *      step.
+   */
+  double Update(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<GaussianDistribution>& dists,
+                arma::vec& weights);
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the number of points in each mini-batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each mini-batch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of passes over the observations in Estimate().
+  size_t MaxEpochs() const { return maxEpochs; }
+  //! Modify the number of passes over the observations in Estimate().
+  size_t& MaxEpochs() { return maxEpochs; }
+
+  //! Get the exponent of the step size schedule.
+  double StepSizeExponent() const { return stepSizeExponent; }
+  //! Modify the exponent of the step size schedule.
+  double& StepSizeExponent() { return stepSizeExponent; }
+
+  //! Get the offset of the step size schedule.
+  double StepSizeOffset() const { return stepSizeOffset; }
+  //! Modify the offset of the step size schedule.
+  double& StepSizeOffset() { return stepSizeOffset; }
+
+  //! Get the number of steps taken so far.
+  size_t StepCount() const { return stepCount; }
+  //! Modify the number of steps taken so far (0 restarts the schedule).
+  size_t& StepCount() { return stepCount; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t version);
+
+ private:
+  /**
+   * Run the clusterer on the given observations, and then turn the cluster
+   * assignments into Gaussians.
+   *
+   * @param observations List of observations.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   */
+  void InitialClustering(const arma::mat& observations,
+                         std::vector<GaussianDistribution>& dists,
+                         arma::vec& weights);
+
+  /**
+   * Take one step of online EM with the given mini-batch, whose points have
+   * the given weights.
+   */
+  double Step(const arma::mat& observations,
+              const arma::vec& pointWeights,
+              std::vector<GaussianDistribution>& dists,
+              arma::vec& weights);
+
+  /**
+   * Make passes over the observations in random mini-batches.  This is a
+   * helper function for both overloads of Estimate().
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec* probabilities,
+                std::vector<GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel);
+
+  //! Number of points in each mini-batch.
+  size_t batchSize;
+  //! Number of passes over the observations in Estimate().
+  size_t maxEpochs;
+  //! Exponent of the step size schedule.
+  double stepSizeExponent;
+  //! Offset of the step size schedule.
+  double stepSizeOffset;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+
+  //! The number of steps taken so far.
+  size_t stepCount;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "online_em_fit_impl.hpp"
+
+#endif
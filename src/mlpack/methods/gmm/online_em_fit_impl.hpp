@@ -0,0 +1,277 @@
+/**
+ * @file methods/gmm/online_em_fit_impl.hpp
+ *
+ * Implementation of online EM for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_em_fit.hpp"
+#include <mlpack/core/math/log_add.hpp>
+
+namespace mlpack {
+
+//! Constructor.
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::OnlineEMFit(
+    const size_t batchSize,
+    const size_t maxEpochs,
+    const double stepSizeExponent,
+    const double stepSizeOffset,
+    InitialClusteringType clusterer,
+    CovarianceConstraintPolicy constraint) :
+    batchSize(batchSize),
+    maxEpochs(maxEpochs),
+    stepSizeExponent(stepSizeExponent),
+    stepSizeOffset(stepSizeOffset),
+    clusterer(clusterer),
+    constraint(constraint),
+    stepCount(0)
+{ /* Nothing to do. */ }
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+    const arma::mat& observations,
+    std::vector<GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  Estimate(observations, NULL, dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+    const arma::mat& observations,
+    const arma::vec& probabilities,
+    std::vector<GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  Estimate(observations, &probabilities, dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+    const arma::mat& observations,
+    const arma::vec* probabilities,
+    std::vector<GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("OnlineEMFit::Estimate(): the batch size must "
+        "be positive!");
+  }
+
+  const size_t batches = (observations.n_cols + batchSize - 1) / batchSize;
+  for (size_t epoch = 0; epoch < maxEpochs; ++epoch)
+  {
+    // Each epoch visits the points in a different random order.
+    const arma::uvec order = arma::randperm<arma::uvec>(observations.n_cols);
+
+    double logLikelihood = 0.0;
+    for (size_t b = 0; b < batches; ++b)
+    {
+      const size_t begin = b * batchSize;
+      const size_t end = std::min((size_t) observations.n_cols,
+          begin + batchSize);
+      const arma::uvec batchOrder = order.subvec(begin, end - 1);
+      const arma::mat batch = observations.cols(batchOrder);
+
+      // Only perform initial clustering if the user wanted it.
+      if (epoch == 0 && b == 0 && !useInitialModel)
+      {
+        stepCount = 0;
+        InitialClustering(batch, dists, weights);
+      }
+
+      const arma::vec pointWeights = (probabilities == NULL) ?
+          arma::vec(batch.n_cols, arma::fill::ones) :
+          arma::vec(probabilities->elem(batchOrder));
+      logLikelihood += Step(batch, pointWeights, dists, weights);
+    }
+
+    Log::Info << "OnlineEMFit::Estimate(): epoch " << epoch << ", "
+        << "log-likelihood " << logLikelihood << "." << std::endl;
+  }
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+double OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Update(
+    const arma::mat& observations,
+    std::vector<GaussianDistribution>& dists,
+    arma::vec& weights)
+{
+  return Step(observations, arma::vec(observations.n_cols, arma::fill::ones),
+      dists, weights);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+double OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Update(
+    const arma::mat& observations,
+    const arma::vec& probabilities,
+    std::vector<GaussianDistribution>& dists,
+    arma::vec& weights)
+{
+  util::CheckSameSizes(observations, (size_t) probabilities.n_elem,
+      "OnlineEMFit::Update()", "probabilities");
+  return Step(observations, probabilities, dists, weights);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+InitialClustering(const arma::mat& observations,
+                  std::vector<GaussianDistribution>& dists,
+                  arma::vec& weights)
+{
+  // Assignments from clustering.
+  arma::Row<size_t> assignments;
+
+  // Run clustering algorithm.
+  clusterer.Cluster(observations, dists.size(), assignments);
+
+  // From the assignments, generate our means, covariances, and weights.
+  std::vector<arma::vec> means(dists.size(),
+      arma::vec(observations.n_rows, arma::fill::zeros));
+  std::vector<arma::mat> covs(dists.size(),
+      arma::mat(observations.n_rows, observations.n_rows, arma::fill::zeros));
+  weights.zeros(dists.size());
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    means[assignments[i]] += observations.col(i);
+    weights[assignments[i]]++;
+  }
+
+  for (size_t i = 0; i < dists.size(); ++i)
+    means[i] /= (weights[i] > 1) ? weights[i] : 1;
+
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    const arma::vec normObs = observations.col(i) - means[assignments[i]];
+    covs[assignments[i]] += normObs * normObs.t();
+  }
+
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    covs[i] /= (weights[i] > 1) ? weights[i] : 1;
+
+    // Apply constraints to covariance matrix.
+    constraint.ApplyConstraint(covs[i]);
+
+    std::swap(dists[i].Mean(), means[i]);
+    dists[i].Covariance(std::move(covs[i]));
+  }
+
+  // Finally, normalize weights.
+  weights /= accu(weights);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+double OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Step(
+    const arma::mat& observations,
+    const arma::vec& pointWeights,
+    std::vector<GaussianDistribution>& dists,
+    arma::vec& weights)
+{
+  if (observations.n_cols == 0)
+    return 0.0;
+
+  if (weights.n_elem != dists.size() || dists.empty() ||
+      dists[0].Mean().n_elem != observations.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "OnlineEMFit::Update(): the model must have been initialized with "
+        << "Gaussians of dimensionality " << observations.n_rows << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The E-step: compute the responsibility of each Gaussian for each point of
+  // the mini-batch.
+  const double negInf = -std::numeric_limits<double>::infinity();
+  arma::mat responsibilities(observations.n_cols, dists.size());
+  arma::vec logPhis;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    dists[i].LogProbability(observations, logPhis);
+    responsibilities.col(i) = logPhis + std::log(weights[i]);
+  }
+
+  double logLikelihood = 0.0;
+  for (size_t j = 0; j < observations.n_cols; ++j)
+  {
+    // If the probability is 0 for every Gaussian, the point is not used.
+    const double probSum = AccuLog(responsibilities.row(j));
+    logLikelihood += probSum;
+    if (probSum != negInf)
+      responsibilities.row(j) = exp(responsibilities.row(j) - probSum);
+    else
+      responsibilities.row(j).zeros();
+  }
+
+  // Average the statistics over the (weighted) points of the mini-batch.
+  const double totalWeight = accu(pointWeights);
+  if (totalWeight == 0.0)
+    return logLikelihood;
+  responsibilities.each_col() %= pointWeights / totalWeight;
+
+  const double stepSize = std::pow(stepCount + stepSizeOffset,
+      -stepSizeExponent);
+  ++stepCount;
+
+  // The running statistics are recovered from the model, moved towards those
+  // of the mini-batch, and turned back into the model (the M-step).
+  const arma::vec batchCounts = arma::sum(responsibilities, 0).t();
+  const arma::mat batchSums = observations * responsibilities;
+  arma::vec counts = (1.0 - stepSize) * weights + stepSize * batchCounts;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (counts[i] == 0.0)
+      continue;
+
+    const arma::vec& mean = dists[i].Mean();
+    const arma::vec sum = (1.0 - stepSize) * weights[i] * mean +
+        stepSize * batchSums.col(i);
+    const arma::mat batchSumOuter = (observations.each_row() %
+        responsibilities.col(i).t()) * observations.t();
+    const arma::mat sumOuter = (1.0 - stepSize) * weights[i] *
+        (dists[i].Covariance() + mean * mean.t()) + stepSize * batchSumOuter;
+
+    arma::vec newMean = sum / counts[i];
+    arma::mat covariance = sumOuter / counts[i] - newMean * newMean.t();
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dists[i].Mean() = std::move(newMean);
+    dists[i].Covariance(std::move(covariance));
+  }
+
+  weights = counts / accu(counts);
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename Archive>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(batchSize));
+  ar(CEREAL_NVP(maxEpochs));
+  ar(CEREAL_NVP(stepSizeExponent));
+  ar(CEREAL_NVP(stepSizeOffset));
+  ar(CEREAL_NVP(clusterer));
+  ar(CEREAL_NVP(constraint));
+  ar(CEREAL_NVP(stepCount));
+}
+
+} // namespace mlpack
+
+#endif
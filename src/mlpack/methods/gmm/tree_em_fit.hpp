@@ -0,0 +1,293 @@
+/**
+ * @file methods/gmm/tree_em_fit.hpp
+ *
+ * Utility class to fit a GMM using the EM algorithm, accelerated with an
+ * mrkd-tree.  Used by GMM::Train<>().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_TREE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_TREE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/dists.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+
+// Default clustering mechanism.
+#include <mlpack/methods/kmeans/kmeans.hpp>
+// Default covariance matrix constraint.
+#include "positive_definite_constraint.hpp"
+#include "mrkd_statistic.hpp"
+
+namespace mlpack {
+
+/**
+ * This class fits a GMM to observations with the EM algorithm, like EMFit, but
+ * with the E-step accelerated by an mrkd-tree: a kd-tree whose nodes cache the
+ * sufficient statistics of their points (see MRKDStatistic).  In each
+ * iteration, the tree is traversed from the root, and the responsibility of
+ * each Gaussian for the points of a node is bounded with the distances from
+ * its mean to the bounding box of the node and the extreme eigenvalues of its
+ * inverse covariance.  If the bounds of all Gaussians differ by at most
+ * the responsibility tolerance, the responsibilities at the centroid of the
+ * node are used for all of its points, with the cached statistics; otherwise
+ * the children are visited, and at the leaves, each point is evaluated
+ * exactly.  This gives large speedups when the Gaussians are well separated,
+ * since most nodes are then owned by a single Gaussian.  With a responsibility
+ * tolerance of 0, every E-step is exact.
+ *
+ * The log-likelihood used for the convergence test is approximated in the
+ * same way.  This fitter only supports GaussianDistribution.  For more
+ * information, see the following paper.
+ *
+ * @code
+ * @inproceedings{moore1999very,
+ *   title={Very Fast {EM}-Based Mixture Model Clustering Using
+ *       Multiresolution kd-Trees},
+ *   author={Moore, Andrew W.},
+ *   booktitle={Advances in Neural Information Processing Systems 11 (NIPS
+ *       1998)},
+ *   pages={543--549},
+ *   year={1999}
+ * }
+ * @endcode
+ *
+ * The clustering mechanism must implement the same Cluster() method as for
+ * EMFit.
+ */
+template<typename InitialClusteringType = KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint>
+class TreeEMFit
+{
+ public:
+  //! The type of tree used for the E-step.
+  typedef KDTree<EuclideanDistance, MRKDStatistic, arma::mat> Tree;
+
+  /**
+   * Construct the TreeEMFit object, optionally passing an
+   * InitialClusteringType object (just in case it needs to store state).
+   * Setting the maximum number of iterations to 0 means that the EM algorithm
+   * will iterate until convergence (with the given tolerance).
+   *
+   * @param maxIterations Maximum number of iterations for EM.
+   * @param tolerance Log-likelihood tolerance required for convergence.
+   * @param responsibilityTolerance Largest difference between the bounds on
+   *      the responsibilities of a node for which the node is not split.
+   * @param leafSize Maximum number of points in a leaf of the tree.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   */
+  TreeEMFit(const size_t maxIterations = 300,
+            const double tolerance = 1e-10,
+            const double responsibilityTolerance = 1e-3,
+            const size_t leafSize = 20,
+            InitialClusteringType clusterer = InitialClusteringType(),
+            CovarianceConstraintPolicy constraint =
+                CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) using the EM
+   * algorithm.  The size of the vectors (indicating the number of components)
+   * must already be set.  Optionally, if useInitialModel is set to true, then
+   * the model given in the means, covariances, and weights parameters is used
+   * as the initial model, instead of using the InitialClusteringType::Cluster()
+   * option.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) using the EM
+   * algorithm, taking into account the probabilities of each point being from
+   * this mixture.  The size of the vectors (indicating the number of
+   * components) must already be set.  Optionally, if useInitialModel is set to
+   * true, then the model given in the means, covariances, and weights
+   * parameters is used as the initial model, instead of using the
+   * InitialClusteringType::Cluster() option.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the maximum number of iterations of the EM algorithm.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations of the EM algorithm.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for the convergence of the EM algorithm.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for the convergence of the EM algorithm.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the tolerance on the responsibility bounds of a node.
+  double ResponsibilityTolerance() const { return responsibilityTolerance; }
+  //! Modify the tolerance on the responsibility bounds of a node.
+  double& ResponsibilityTolerance() { return responsibilityTolerance; }
+
+  //! Get the maximum number of points in a leaf of the tree.
+  size_t LeafSize() const { return leafSize; }
+  //! Modify the maximum number of points in a leaf of the tree.
+  size_t& LeafSize() { return leafSize; }
+
+  //! Get the number of nodes whose statistics were used instead of their
+  //! points in the last E-step.
+  size_t NodesPruned() const { return nodesPruned; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t version);
+
+ private:
+  //! The weighted sufficient statistics of the points for each Gaussian,
+  //! accumulated during the E-step.
+  struct Statistics
+  {
+    //! The total responsibility of each Gaussian.
+    arma::vec counts;
+    //! The responsibility-weighted mean of the points for each Gaussian.
+    std::vector<arma::vec> means;
+    //! The responsibility-weighted scatter matrix of the points for each
+    //! Gaussian (see MRKDStatistic).
+    std::vector<arma::mat> scatters;
+
+    //! Reset the statistics for the given number of Gaussians.
+    void Reset(const size_t gaussians, const size_t dimensionality);
+  };
+
+  /**
+   * Fit the model with the points in the given tree, whose statistics hold
+   * the weights of the points.  This is a helper function for both overloads
+   * of Estimate().
+   *
+   * @param tree Tree built on the observations.
+   * @param pointWeights Weight of each point of the tree, in tree order.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(Tree& tree,
+                const arma::vec& pointWeights,
+                std::vector<GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel);
+
+  /**
+   * Run the clusterer, and then turn the cluster assignments into Gaussians.
+   *
+   * @param tree Tree built on the observations.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   */
+  void InitialClustering(const Tree& tree,
+                         std::vector<GaussianDistribution>& dists,
+                         arma::vec& weights);
+
+  /**
+   * Perform the E-step with the tree: accumulate the sufficient statistics of
+   * the points for each Gaussian, weighted by their responsibilities, and
+   * return the (approximate) log-likelihood of the model.
+   *
+   * @param tree Tree built on the observations.
+   * @param pointWeights Weight of each point of the tree, in tree order.
+   * @param dists Distributions of the model.
+   * @param weights Vector of a priori weights.
+   * @param stats Statistics to accumulate.
+   */
+  double Expectation(const Tree& tree,
+                     const arma::vec& pointWeights,
+                     const std::vector<GaussianDistribution>& dists,
+                     const arma::vec& weights,
+                     Statistics& stats);
+
+  /**
+   * Recurse into the given node for the E-step.
+   *
+   * @param node Node to visit.
+   * @param pointWeights Weight of each point of the tree, in tree order.
+   * @param dists Distributions of the model.
+   * @param logWeights Logarithm of each a priori weight.
+   * @param logNorms Logarithm of the normalizing constant of each Gaussian.
+   * @param minEigvals Smallest eigenvalue of each inverse covariance.
+   * @param maxEigvals Largest eigenvalue of each inverse covariance.
+   * @param stats Statistics to accumulate.
+   */
+  double Expectation(const Tree& node,
+                     const arma::vec& pointWeights,
+                     const std::vector<GaussianDistribution>& dists,
+                     const arma::vec& logWeights,
+                     const arma::vec& logNorms,
+                     const arma::vec& minEigvals,
+                     const arma::vec& maxEigvals,
+                     Statistics& stats);
+
+  /**
+   * Perform the M-step: update the weight, mean and covariance of each
+   * Gaussian from the accumulated statistics.  Gaussians that are not
+   * responsible for any point are not updated.
+   *
+   * @param stats Accumulated statistics.
+   * @param dists Distributions to update.
+   * @param weights Vector of a priori weights to update.
+   */
+  void Maximization(const Statistics& stats,
+                    std::vector<GaussianDistribution>& dists,
+                    arma::vec& weights);
+
+  //! Set the statistics of the given node and its descendants to the weighted
+  //! statistics of their points.
+  static void ReweightStatistics(Tree& node, const arma::vec& pointWeights);
+
+  //! Maximum iterations of EM algorithm.
+  size_t maxIterations;
+  //! Tolerance for convergence of EM.
+  double tolerance;
+  //! Tolerance on the responsibility bounds of a node.
+  double responsibilityTolerance;
+  //! Maximum number of points in a leaf of the tree.
+  size_t leafSize;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+
+  //! The number of nodes pruned in the last E-step.
+  size_t nodesPruned;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "tree_em_fit_impl.hpp"
+
+#endif
@@ -0,0 +1,377 @@
+/**
+ * @file methods/gmm/tree_em_fit_impl.hpp
+ *
+ * Implementation of the EM algorithm for fitting GMMs with an mrkd-tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_TREE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_TREE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "tree_em_fit.hpp"
+#include <mlpack/core/math/log_add.hpp>
+
+namespace mlpack {
+
+//! Constructor.
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::TreeEMFit(
+    const size_t maxIterations,
+    const double tolerance,
+    const double responsibilityTolerance,
+    const size_t leafSize,
+    InitialClusteringType clusterer,
+    CovarianceConstraintPolicy constraint) :
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    responsibilityTolerance(responsibilityTolerance),
+    leafSize(leafSize),
+    clusterer(clusterer),
+    constraint(constraint),
+    nodesPruned(0)
+{ /* Nothing to do. */ }
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+    const arma::mat& observations,
+    std::vector<GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  // The statistics of the tree are built with a weight of 1 for every point.
+  Tree tree(observations, leafSize);
+  const arma::vec pointWeights(observations.n_cols, arma::fill::ones);
+  Estimate(tree, pointWeights, dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+    const arma::mat& observations,
+    const arma::vec& probabilities,
+    std::vector<GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  std::vector<size_t> oldFromNew;
+  Tree tree(observations, oldFromNew, leafSize);
+
+  arma::vec pointWeights(observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    pointWeights[i] = probabilities[oldFromNew[i]];
+  ReweightStatistics(tree, pointWeights);
+
+  Estimate(tree, pointWeights, dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+    Tree& tree,
+    const arma::vec& pointWeights,
+    std::vector<GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  // Only perform initial clustering if the user wanted it.
+  if (!useInitialModel)
+    InitialClustering(tree, dists, weights);
+
+  Statistics stats;
+  double l = Expectation(tree, pointWeights, dists, weights, stats);
+
+  Log::Debug << "TreeEMFit::Estimate(): initial clustering log-likelihood: "
+      << l << std::endl;
+
+  double lOld = -DBL_MAX;
+
+  // Iterate to update the model until no more improvement is found.  Each
+  // E-step also accumulates the statistics for the next M-step.
+  size_t iteration = 1;
+  while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
+  {
+    Log::Info << "TreeEMFit::Estimate(): iteration " << iteration << ", "
+        << "log-likelihood " << l << ", " << nodesPruned << " nodes pruned."
+        << std::endl;
+
+    // Calculate the new values of the weights, means and covariances.
+    Maximization(stats, dists, weights);
+
+    // Update values of l; calculate the new log-likelihood and the statistics
+    // for the next iteration.
+    lOld = l;
+    l = Expectation(tree, pointWeights, dists, weights, stats);
+
+    iteration++;
+  }
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+InitialClustering(const Tree& tree,
+                  std::vector<GaussianDistribution>& dists,
+                  arma::vec& weights)
+{
+  // Assignments from clustering.
+  arma::Row<size_t> assignments;
+
+  // Run clustering algorithm.
+  const arma::mat& observations = tree.Dataset();
+  clusterer.Cluster(observations, dists.size(), assignments);
+
+  // Each point belongs to its cluster only, and has the same weight (as with
+  // EMFit, the weights of the points are not used for the initial model).
+  Statistics stats;
+  stats.Reset(dists.size(), observations.n_rows);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    const size_t cluster = assignments[i];
+    MRKDStatistic::Merge(stats.counts[cluster], stats.means[cluster],
+        stats.scatters[cluster], 1.0, observations.col(i));
+  }
+
+  Maximization(stats, dists, weights);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+double TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+Expectation(const Tree& tree,
+            const arma::vec& pointWeights,
+            const std::vector<GaussianDistribution>& dists,
+            const arma::vec& weights,
+            Statistics& stats)
+{
+  stats.Reset(dists.size(), tree.Dataset().n_rows);
+  nodesPruned = 0;
+
+  // The squared Mahalanobis distance of a point to the mean of a Gaussian is
+  // ||L (x - mu)||^2, where L is the lower Cholesky factor of the inverse
+  // covariance; so it is bounded by the squared extreme singular values of L
+  // times the squared Euclidean distance.
+  const arma::vec logWeights = log(weights);
+  arma::vec logNorms(dists.size());
+  arma::vec minEigvals(dists.size());
+  arma::vec maxEigvals(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    logNorms[i] = -0.5 * dists[i].Dimensionality() * std::log(2.0 * M_PI) -
+        0.5 * dists[i].LogDetCov();
+
+    const arma::vec s = arma::svd(dists[i].InvCovLower());
+    minEigvals[i] = std::pow(s.min(), 2.0);
+    maxEigvals[i] = std::pow(s.max(), 2.0);
+  }
+
+  return Expectation(tree, pointWeights, dists, logWeights, logNorms,
+      minEigvals, maxEigvals, stats);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+double TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+Expectation(const Tree& node,
+            const arma::vec& pointWeights,
+            const std::vector<GaussianDistribution>& dists,
+            const arma::vec& logWeights,
+            const arma::vec& logNorms,
+            const arma::vec& minEigvals,
+            const arma::vec& maxEigvals,
+            Statistics& stats)
+{
+  const MRKDStatistic& stat = node.Stat();
+  if (stat.Count() == 0.0)
+    return 0.0;
+
+  const size_t gaussians = dists.size();
+  if (responsibilityTolerance > 0.0)
+  {
+    // Bound the log-probability of each Gaussian (with its weight) for any
+    // point in the bounding box of the node.
+    arma::vec logMax(gaussians), logMin(gaussians);
+    for (size_t j = 0; j < gaussians; ++j)
+    {
+      const double minDistance = node.Bound().MinDistance(dists[j].Mean());
+      const double maxDistance = node.Bound().MaxDistance(dists[j].Mean());
+      logMax[j] = logWeights[j] + logNorms[j] -
+          0.5 * minEigvals[j] * minDistance * minDistance;
+      logMin[j] = logWeights[j] + logNorms[j] -
+          0.5 * maxEigvals[j] * maxDistance * maxDistance;
+    }
+
+    // Now bound the responsibility of each Gaussian: it is largest when the
+    // Gaussian has its largest probability and the others their smallest.
+    const double negInf = -std::numeric_limits<double>::infinity();
+    bool tight = true;
+    for (size_t j = 0; j < gaussians && tight; ++j)
+    {
+      double othersMin = negInf;
+      double othersMax = negInf;
+      for (size_t l = 0; l < gaussians; ++l)
+      {
+        if (l == j)
+          continue;
+
+        othersMin = LogAdd(othersMin, logMin[l]);
+        othersMax = LogAdd(othersMax, logMax[l]);
+      }
+
+      const double maxResponsibility = (logMax[j] == negInf) ? 0.0 :
+          std::exp(logMax[j] - LogAdd(logMax[j], othersMin));
+      const double minResponsibility = (logMin[j] == negInf) ? 0.0 :
+          std::exp(logMin[j] - LogAdd(logMin[j], othersMax));
+      if (maxResponsibility - minResponsibility > responsibilityTolerance)
+        tight = false;
+    }
+
+    if (tight)
+    {
+      // All points of the node have nearly the same responsibilities, so use
+      // those of the centroid for the statistics of the node.
+      const arma::vec& centroid = stat.Mean();
+      arma::vec logProbs(gaussians);
+      for (size_t j = 0; j < gaussians; ++j)
+        logProbs[j] = logWeights[j] + dists[j].LogProbability(centroid);
+
+      const double probSum = AccuLog(logProbs);
+      if (probSum != negInf)
+      {
+        ++nodesPruned;
+        const arma::vec responsibilities = exp(logProbs - probSum);
+        for (size_t j = 0; j < gaussians; ++j)
+        {
+          MRKDStatistic::Merge(stats.counts[j], stats.means[j],
+              stats.scatters[j], responsibilities[j] * stat.Count(),
+              stat.Mean(), arma::mat(responsibilities[j] * stat.Scatter()));
+        }
+
+        return stat.Count() * probSum;
+      }
+    }
+  }
+
+  if (node.NumChildren() > 0)
+  {
+    double logLikelihood = 0.0;
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      logLikelihood += Expectation(node.Child(i), pointWeights, dists,
+          logWeights, logNorms, minEigvals, maxEigvals, stats);
+    }
+
+    return logLikelihood;
+  }
+
+  // This is a leaf whose bounds are not tight enough, so evaluate each point.
+  double logLikelihood = 0.0;
+  arma::vec logProbs(gaussians);
+  for (size_t i = 0; i < node.NumPoints(); ++i)
+  {
+    const size_t point = node.Point(i);
+    if (pointWeights[point] == 0.0)
+      continue;
+
+    const arma::vec x = node.Dataset().col(point);
+    for (size_t j = 0; j < gaussians; ++j)
+      logProbs[j] = logWeights[j] + dists[j].LogProbability(x);
+
+    // Avoid dividing by zero; if the probability for everything is 0, the
+    // point is not used for any Gaussian.
+    const double probSum = AccuLog(logProbs);
+    logLikelihood += pointWeights[point] * probSum;
+    if (probSum == -std::numeric_limits<double>::infinity())
+    {
+      Log::Info << "Likelihood of point " << point << " is 0!  It is probably "
+          << "an outlier." << std::endl;
+      continue;
+    }
+
+    const arma::vec responsibilities = pointWeights[point] *
+        exp(logProbs - probSum);
+    for (size_t j = 0; j < gaussians; ++j)
+    {
+      MRKDStatistic::Merge(stats.counts[j], stats.means[j], stats.scatters[j],
+          responsibilities[j], x);
+    }
+  }
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+Maximization(const Statistics& stats,
+             std::vector<GaussianDistribution>& dists,
+             arma::vec& weights)
+{
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (stats.counts[i] == 0.0)
+      continue;
+
+    // The statistics are centered, so the covariance is not computed as the
+    // difference of the second moment and the squared mean, which would lose
+    // precision when the points are far from the origin.
+    dists[i].Mean() = stats.means[i];
+    arma::mat covariance = stats.scatters[i] / stats.counts[i];
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dists[i].Covariance(std::move(covariance));
+  }
+
+  weights = stats.counts / accu(stats.counts);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+ReweightStatistics(Tree& node, const arma::vec& pointWeights)
+{
+  MRKDStatistic& stat = node.Stat();
+  stat.Count() = 0.0;
+  stat.Mean().zeros(node.Dataset().n_rows);
+  stat.Scatter().zeros(node.Dataset().n_rows, node.Dataset().n_rows);
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    ReweightStatistics(node.Child(i), pointWeights);
+    const MRKDStatistic& childStat = node.Child(i).Stat();
+    MRKDStatistic::Merge(stat.Count(), stat.Mean(), stat.Scatter(),
+        childStat.Count(), childStat.Mean(), childStat.Scatter());
+  }
+
+  for (size_t i = 0; i < node.NumPoints(); ++i)
+  {
+    const size_t point = node.Point(i);
+    MRKDStatistic::Merge(stat.Count(), stat.Mean(), stat.Scatter(),
+        pointWeights[point], node.Dataset().col(point));
+  }
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+Statistics::Reset(const size_t gaussians, const size_t dimensionality)
+{
+  counts.zeros(gaussians);
+  means.assign(gaussians, arma::vec(dimensionality, arma::fill::zeros));
+  scatters.assign(gaussians, arma::mat(dimensionality, dimensionality,
+      arma::fill::zeros));
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename Archive>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(maxIterations));
+  ar(CEREAL_NVP(tolerance));
+  ar(CEREAL_NVP(responsibilityTolerance));
+  ar(CEREAL_NVP(leafSize));
+  ar(CEREAL_NVP(clusterer));
+  ar(CEREAL_NVP(constraint));
+}
+
+} // namespace mlpack
+
+#endif
@@ -18,6 +18,10 @@
 
 namespace mlpack {
 
+// Whether a distribution provides log-probability tables (see
+// DiscreteDistribution::LogProbabilityTables()).
+HAS_MEM_FUNC(LogProbabilityTables, HasLogProbabilityTables);
+
 /**
  * A class that represents a Hidden Markov Model with an arbitrary type of
  * emission distribution.  This HMM class supports training (supervised and
@@ -159,6 +163,9 @@ class HMM
    * log-likelihood of the model between iterations is less than the tolerance,
    * the Baum-Welch algorithm terminates.
    *
+   * The E-step (the Forward-Backward algorithm) is run on the sequences in
+   * parallel, so training on many independent sequences uses all cores.
+   *
    * @note
    * Train() can be called multiple times with different sequences; each time it
    * is called, it uses the current parameters of the HMM as a starting point
@@ -283,6 +290,20 @@ class HMM
   double Predict(const arma::mat& dataSeq,
                  arma::Row<size_t>& stateSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence for each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences are decoded in
+   * parallel.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @param stateSeq Vector in which the most probable state sequence of each
+   *    data sequence will be stored.
+   * @return Log-likelihood of the most probable state sequence of each data
+   *    sequence.
+   */
+  arma::vec Predict(const std::vector<arma::mat>& dataSeq,
+                    std::vector<arma::Row<size_t>>& stateSeq) const;
+
   /**
    * Compute the log-likelihood of the given data sequence.
    *
@@ -291,6 +312,15 @@ class HMM
    */
   double LogLikelihood(const arma::mat& dataSeq) const;
 
+  /**
+   * Compute the log-likelihood of each of the given data sequences.  The
+   * sequences are evaluated in parallel.
+   *
+   * @param dataSeq Vector of data sequences to evaluate the likelihood of.
+   * @return Log-likelihood of each of the given sequences.
+   */
+  arma::vec LogLikelihood(const std::vector<arma::mat>& dataSeq) const;
+
   /**
    * Compute the log of the scaling factor of the given emission probability
    * at time t. To calculate the log-likelihood for the whole sequence,
@@ -427,6 +457,21 @@ class HMM
   //! Modify the tolerance of the Baum-Welch algorithm.
   double& Tolerance() { return tolerance; }
 
+  /**
+   * Get whether the Forward-Backward algorithm is run with scaled
+   * probabilities instead of log-probabilities.  In scaled mode, the forward
+   * and backward recursions are done in linear space, with renormalization at
+   * each time step, so they need only multiply-adds instead of exponentials;
+   * this is several times faster, especially for discrete emissions, where the
+   * recursions dominate the cost.  The results match those of the log-space
+   * recursions, except that probabilities that are too small to be
+   * represented relative to the most likely state are rounded to zero.  This
+   * is false by default, and is not serialized.
+   */
+  bool ScaledProbabilities() const { return scaledProbabilities; }
+  //! Modify whether the Forward-Backward algorithm uses scaled probabilities.
+  bool& ScaledProbabilities() { return scaledProbabilities; }
+
   /**
    * Load the object.
    */
@@ -494,6 +539,67 @@ class HMM
                 arma::mat& backwardLogProb,
                 arma::mat& logProbs) const;
 
+  /**
+   * Compute the log-probability of each observation in the given data sequence
+   * under the emission distribution of each hidden state.  The returned matrix
+   * has rows equal to the number of observations and columns equal to the
+   * number of hidden states.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param logProbs Matrix in which the log-probabilities will be saved.
+   */
+  void EmissionLogProbabilities(const arma::mat& dataSeq,
+                                arma::mat& logProbs) const;
+
+  /**
+   * Compute the log-probability tables of the emission distribution of each
+   * hidden state, for distributions that provide them (such as
+   * DiscreteDistribution).  The tables stay valid until the emission
+   * distributions change.
+   *
+   * @param logTables Tables of each hidden state.
+   */
+  template<typename D = Distribution>
+  void EmissionLogTables(std::vector<std::vector<arma::vec>>& logTables,
+                         const std::enable_if_t<HasLogProbabilityTables<D,
+                             void(D::*)(std::vector<arma::vec>&) const>::value>*
+                             = 0) const;
+
+  //! For distributions without log-probability tables, there is nothing to
+  //! compute.
+  template<typename D = Distribution>
+  void EmissionLogTables(std::vector<std::vector<arma::vec>>& logTables,
+                         const std::enable_if_t<!HasLogProbabilityTables<D,
+                             void(D::*)(std::vector<arma::vec>&) const>::value>*
+                             = 0) const;
+
+  /**
+   * Compute the log-probability of each observation in the given data sequence
+   * under the emission distribution of each hidden state, by gathering them
+   * from the given log-probability tables (see EmissionLogTables()).
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param logTables Log-probability tables of each hidden state.
+   * @param logProbs Matrix in which the log-probabilities will be saved.
+   */
+  template<typename D = Distribution>
+  void EmissionLogProbabilities(
+      const arma::mat& dataSeq,
+      const std::vector<std::vector<arma::vec>>& logTables,
+      arma::mat& logProbs,
+      const std::enable_if_t<HasLogProbabilityTables<D,
+          void(D::*)(std::vector<arma::vec>&) const>::value>* = 0) const;
+
+  //! For distributions without log-probability tables, compute the
+  //! log-probabilities directly.
+  template<typename D = Distribution>
+  void EmissionLogProbabilities(
+      const arma::mat& dataSeq,
+      const std::vector<std::vector<arma::vec>>& logTables,
+      arma::mat& logProbs,
+      const std::enable_if_t<!HasLogProbabilityTables<D,
+          void(D::*)(std::vector<arma::vec>&) const>::value>* = 0) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
@@ -514,6 +620,34 @@ class HMM
    */
   void ConvertToLogSpace() const;
 
+  /**
+   * The Forward algorithm of Forward(), computed with scaled probabilities
+   * instead of log-probabilities; see ScaledProbabilities().
+   *
+   * @param emissionLogProbs Emission log-probabilities of each state (rows)
+   *     at each time step (columns).
+   * @param logScales Vector in which the log of scaling factors will be saved.
+   * @param forwardLogProb Matrix in which forward probabilities will be saved;
+   *     it must already have the right size.
+   */
+  void ScaledForward(const arma::mat& emissionLogProbs,
+                     arma::vec& logScales,
+                     arma::mat& forwardLogProb) const;
+
+  /**
+   * The Backward algorithm of Backward(), computed with scaled probabilities
+   * instead of log-probabilities; see ScaledProbabilities().
+   *
+   * @param emissionLogProbs Emission log-probabilities of each state (rows)
+   *     at each time step (columns).
+   * @param logScales Vector of log of scaling factors.
+   * @param backwardLogProb Matrix in which backward probabilities will be
+   *     saved; it must already have the right size.
+   */
+  void ScaledBackward(const arma::mat& emissionLogProbs,
+                      const arma::vec& logScales,
+                      arma::mat& backwardLogProb) const;
+
   /**
    * A proxy vriable in linear space for logInitial.
    * Should be removed in mlpack 4.0.
@@ -529,6 +663,9 @@ class HMM
   //! Tolerance of Baum-Welch algorithm.
   double tolerance;
 
+  //! Whether to run the Forward-Backward algorithm with scaled probabilities.
+  bool scaledProbabilities;
+
   /**
    * Whether or not we need to update the logInitial from initialProxy.
    * Should be removed in mlpack 4.0.
@@ -33,6 +33,7 @@ HMM<Distribution>::HMM(const size_t states,
     initialProxy(randu<arma::vec>(states) / (double) states),
     dimensionality(emissions.Dimensionality()),
     tolerance(tolerance),
+    scaledProbabilities(false),
     recalculateInitial(false),
     recalculateTransition(false)
 {
@@ -60,6 +61,7 @@ HMM<Distribution>::HMM(const arma::vec& initial,
     initialProxy(initial),
     logInitial(log(initial)),
     tolerance(tolerance),
+    scaledProbabilities(false),
     recalculateInitial(false),
     recalculateTransition(false)
 {
@@ -112,17 +114,42 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
           << dimensionality << " dimensions)." << std::endl;
   }
 
+  // Make sure the log-space parameters are up to date before the threads
+  // start reading them.
+  ConvertToLogSpace();
+
+  // The observations of each sequence start at this offset in the list of all
+  // observations.
+  std::vector<size_t> offsets(dataSeq.size());
+  for (size_t seq = 1; seq < dataSeq.size(); seq++)
+    offsets[seq] = offsets[seq - 1] + dataSeq[seq - 1].n_cols;
+
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The list of
+  // emissions doesn't change between iterations, so it is filled once.
   std::vector<arma::vec> emissionProb(logTransition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    if (dataSeq[seq].n_cols > 0)
+    {
+      emissionList.cols(offsets[seq], offsets[seq] + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    }
+  }
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
   // Markov Models: Estimation and Control", pp. 36-40.
+  std::vector<std::vector<arma::vec>> logTables;
   for (size_t iter = 0; iter < iterations; iter++)
   {
+    // The log-probability tables of the emissions (if the distribution has
+    // them) only change with the M-step, so they are computed once for all the
+    // sequences of this iteration.
+    EmissionLogTables(logTables);
+
     // Clear new transition matrix and emission probabilities.
     arma::vec newLogInitial(logTransition.n_rows);
     newLogInitial.fill(-std::numeric_limits<double>::infinity());
@@ -132,70 +159,87 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // The sequences are independent, so the E-step is run on them in parallel.
+    // Each thread accumulates its own estimates of the initial and transition
+    // probabilities, and these are summed (in log-space) at the end.
+    #pragma omp parallel num_threads((int) NumThreads())
     {
-      arma::mat stateLogProb;
-      arma::mat forwardLog;
-      arma::mat backwardLog;
-      arma::vec logScales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
-
-      // Add to estimate of initial probability for state j.
-      LogSumExp<arma::vec, true>(stateLogProb.unsafe_col(0),
-          newLogInitial);
-
-      // Define a variable to store the value of log-probability for data.
-      arma::mat logProbs(dataSeq[seq].n_cols, logTransition.n_rows);
-      // Save the values of log-probability to logProbs.
-      for (size_t i = 0; i < logTransition.n_rows; i++)
+      arma::vec localLogInitial(logTransition.n_rows);
+      localLogInitial.fill(-std::numeric_limits<double>::infinity());
+      arma::mat localLogTransition(logTransition.n_rows,
+          logTransition.n_cols);
+      localLogTransition.fill(-std::numeric_limits<double>::infinity());
+
+      // Loop over each sequence.
+      #pragma omp for schedule(dynamic) reduction(+:loglik)
+      for (size_t seq = 0; seq < dataSeq.size(); seq++)
       {
-        // Define alias of desired column.
-        arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-        // Use advanced constructor for using logProbs directly.
-        emission[i].LogProbability(dataSeq[seq], alias);
-      }
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
-      {
-        // Assemble temporary vector that's used in log-sum computation.
-        if (t < dataSeq[seq].n_cols - 1)
+        arma::mat stateLogProb;
+        arma::mat forwardLog;
+        arma::mat backwardLog;
+        arma::vec logScales;
+
+        // Define a variable to store the value of log-probability for data.
+        arma::mat logProbs;
+        EmissionLogProbabilities(dataSeq[seq], logTables, logProbs);
+
+        // Run the forward-backward algorithm, and add the log-likelihood of
+        // this sequence.  This is the E-step.
+        Forward(dataSeq[seq], logScales, forwardLog, logProbs);
+        Backward(dataSeq[seq], logScales, backwardLog, logProbs);
+        stateLogProb = forwardLog + backwardLog;
+        loglik += accu(logScales);
+
+        // Add to estimate of initial probability for state j.
+        LogSumExp<arma::vec, true>(stateLogProb.unsafe_col(0),
+            localLogInitial);
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.
+        for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
         {
-          // This term is the same across all states, so compute it once and
-          // cache it.
-          const arma::vec tmp = backwardLog.col(t + 1) +
-              logProbs.row(t + 1).t() - logScales[t + 1];
-          arma::vec output;
-          LogSumExp(tmp, output);
-
-          for (size_t j = 0; j < logTransition.n_cols; ++j)
+          // Assemble temporary vector that's used in log-sum computation.
+          if (t < dataSeq[seq].n_cols - 1)
           {
-            // Compute the estimate of T_ij (probability of transition from
-            // state j to state i).  We postpone multiplication of the old T_ij
-            // until later.
-            arma::vec tmp2 = output + forwardLog(j, t);
-            arma::vec alias = newLogTransition.unsafe_col(j);
-            LogSumExp<arma::vec, true>(tmp2, alias);
+            // This term is the same across all states, so compute it once and
+            // cache it.
+            const arma::vec tmp = backwardLog.col(t + 1) +
+                logProbs.row(t + 1).t() - logScales[t + 1];
+            arma::vec output;
+            LogSumExp(tmp, output);
+
+            for (size_t j = 0; j < logTransition.n_cols; ++j)
+            {
+              // Compute the estimate of T_ij (probability of transition from
+              // state j to state i).  We postpone multiplication of the old
+              // T_ij until later.
+              arma::vec tmp2 = output + forwardLog(j, t);
+              arma::vec alias = localLogTransition.unsafe_col(j);
+              LogSumExp<arma::vec, true>(tmp2, alias);
+            }
           }
+
+          // Add to list of emission probabilities, for Distribution::Train().
+          // Each sequence has its own part of each vector.
+          for (size_t j = 0; j < logTransition.n_cols; ++j)
+            emissionProb[j][offsets[seq] + t] = std::exp(stateLogProb(j, t));
         }
+      }
 
-        // Add to list of emission observations, for Distribution::Train().
-        for (size_t j = 0; j < logTransition.n_cols; ++j)
-          emissionProb[j][sumTime] = std::exp(stateLogProb(j, t));
-        emissionList.col(sumTime) = dataSeq[seq].col(t);
-        sumTime++;
+      #pragma omp critical
+      {
+        for (size_t i = 0; i < newLogInitial.n_elem; ++i)
+          newLogInitial[i] = LogAdd(newLogInitial[i], localLogInitial[i]);
+        for (size_t i = 0; i < newLogTransition.n_elem; ++i)
+        {
+          newLogTransition[i] = LogAdd(newLogTransition[i],
+              localLogTransition[i]);
+        }
       }
     }
 
@@ -353,16 +397,8 @@ double HMM<Distribution>::LogEstimate(const arma::mat& dataSeq,
                                       arma::mat& backwardLogProb,
                                       arma::vec& logScales) const
 {
-  arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
-
-  // Save the values of log-probability to logProbs.
-  for (size_t i = 0; i < logTransition.n_rows; i++)
-  {
-    // Define alias of desired column.
-    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-    // Use advanced constructor for using logProbs directly.
-    emission[i].LogProbability(dataSeq, alias);
-  }
+  arma::mat logProbs;
+  EmissionLogProbabilities(dataSeq, logProbs);
 
   // First run the forward-backward algorithm.
   Forward(dataSeq, logScales, forwardLogProb, logProbs);
@@ -495,32 +531,22 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
 
   ConvertToLogSpace();
 
+  arma::mat logProbs;
+  EmissionLogProbabilities(dataSeq, logProbs);
+
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
   logStateProb.col(0).zeros();
   for (size_t state = 0; state < logTransition.n_rows; state++)
   {
-    logStateProb(state, 0) = logInitial[state] +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
+    logStateProb(state, 0) = logInitial[state] + logProbs(0, state);
     stateSeqBack(state, 0) = state;
   }
 
   // Store the best first state.
   arma::uword index;
 
-  // Define a variable to store the value of log-probability for dataSeq.
-  arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
-
-  // Save the values of log-probability to logProbs.
-  for (size_t i = 0; i < logTransition.n_rows; i++)
-  {
-    // Define alias of desired column.
-    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-    // Use advanced constructor for using logProbs directly.
-    emission[i].LogProbability(dataSeq, alias);
-  }
-
   for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
     // Assemble the state probability for this element.
@@ -546,6 +572,29 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
   return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
 }
 
+/**
+ * Compute the most probable hidden state sequence for each of the given
+ * observation sequences, in parallel.
+ */
+template<typename Distribution>
+arma::vec HMM<Distribution>::Predict(
+    const std::vector<arma::mat>& dataSeq,
+    std::vector<arma::Row<size_t>>& stateSeq) const
+{
+  // This must be done before the threads start, since it may modify the
+  // log-space parameters.
+  ConvertToLogSpace();
+
+  stateSeq.resize(dataSeq.size());
+  arma::vec logLikelihoods(dataSeq.size());
+
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t i = 0; i < dataSeq.size(); ++i)
+    logLikelihoods[i] = Predict(dataSeq[i], stateSeq[i]);
+
+  return logLikelihoods;
+}
+
 /**
  * Compute the log-likelihood of the given data sequence.
  */
@@ -555,17 +604,8 @@ double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
   arma::mat forwardLog;
   arma::vec logScales;
 
-  // This is needed here.
-  arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
-
-  // Save the values of log-probability to logProbs.
-  for (size_t i = 0; i < logTransition.n_rows; i++)
-  {
-    // Define alias of desired column.
-    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-    // Use advanced constructor for using logProbs directly.
-    emission[i].LogProbability(dataSeq, alias);
-  }
+  arma::mat logProbs;
+  EmissionLogProbabilities(dataSeq, logProbs);
 
   Forward(dataSeq, logScales, forwardLog, logProbs);
 
@@ -573,6 +613,26 @@ double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
   return accu(logScales);
 }
 
+/**
+ * Compute the log-likelihood of each of the given data sequences, in parallel.
+ */
+template<typename Distribution>
+arma::vec HMM<Distribution>::LogLikelihood(
+    const std::vector<arma::mat>& dataSeq) const
+{
+  // This must be done before the threads start, since it may modify the
+  // log-space parameters.
+  ConvertToLogSpace();
+
+  arma::vec logLikelihoods(dataSeq.size());
+
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t i = 0; i < dataSeq.size(); ++i)
+    logLikelihoods[i] = LogLikelihood(dataSeq[i]);
+
+  return logLikelihoods;
+}
+
 /**
  * Compute the log of the scaling factor of the given emission probability
  * at time t. To calculate the log-likelihood for the whole sequence,
@@ -657,17 +717,8 @@ void HMM<Distribution>::Filter(const arma::mat& dataSeq,
   // First run the forward algorithm.
   arma::mat forwardLogProb;
   arma::vec logScales;
-  // This is needed here.
-  arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
-
-  // Save the values of log-probability to logProbs.
-  for (size_t i = 0; i < logTransition.n_rows; i++)
-  {
-    // Define alias of desired column.
-    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-    // Use advanced constructor for using logProbs directly.
-    emission[i].LogProbability(dataSeq, alias);
-  }
+  arma::mat logProbs;
+  EmissionLogProbabilities(dataSeq, logProbs);
 
   Forward(dataSeq, logScales, forwardLogProb, logProbs);
 
@@ -744,15 +795,30 @@ arma::vec HMM<Distribution>::ForwardAtTn(const arma::vec& emissionLogProb,
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
 
-  // The forward probability of state j at time t is the sum over all states of
-  // the probability of the previous state transitioning to the current state
-  // and emitting the given observation.  To do this computation in log-space,
-  // we can use LogSumExp().
-  arma::vec forwardLogProb;
-  arma::mat tmp = logTransition + repmat(prevForwardLogProb.t(),
-      logTransition.n_rows, 1);
-  LogSumExp(tmp, forwardLogProb);
-  forwardLogProb += emissionLogProb;
+  // The forward probability of state i at time t is the sum over all states j
+  // of the probability of the previous state j transitioning to state i and
+  // emitting the given observation.  This is computed in log-space for each
+  // state, without forming the matrix of all the terms of the sums.
+  const size_t states = logTransition.n_rows;
+  arma::vec forwardLogProb(states);
+  for (size_t i = 0; i < states; ++i)
+  {
+    double maxVal = -std::numeric_limits<double>::infinity();
+    for (size_t j = 0; j < states; ++j)
+      maxVal = std::max(maxVal, logTransition(i, j) + prevForwardLogProb[j]);
+
+    if (maxVal == -std::numeric_limits<double>::infinity())
+    {
+      forwardLogProb[i] = maxVal;
+      continue;
+    }
+
+    double sum = 0.0;
+    for (size_t j = 0; j < states; ++j)
+      sum += std::exp(logTransition(i, j) + prevForwardLogProb[j] - maxVal);
+
+    forwardLogProb[i] = maxVal + std::log(sum) + emissionLogProb[i];
+  }
 
   // Normalize probability.
   logScales = AccuLog(forwardLogProb);
@@ -773,24 +839,58 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardLogProb.resize(logTransition.n_rows, dataSeq.n_cols);
-  forwardLogProb.fill(-std::numeric_limits<double>::infinity());
-  logScales.resize(dataSeq.n_cols);
-  logScales.fill(-std::numeric_limits<double>::infinity());
+  ConvertToLogSpace();
+
+  const size_t states = logTransition.n_rows;
+  forwardLogProb.set_size(states, dataSeq.n_cols);
+  logScales.set_size(dataSeq.n_cols);
+  if (dataSeq.n_cols == 0)
+    return;
+
+  // The emission log-probabilities of each time step are a column, so that
+  // every step of the recursion only reads contiguous memory.
+  const arma::mat emissionLogProbs = logProbs.t();
+  if (scaledProbabilities)
+  {
+    ScaledForward(emissionLogProbs, logScales, forwardLogProb);
+    return;
+  }
+
+  // Normalize the forward probabilities of time t.
+  auto normalize = [&](const size_t t)
+  {
+    arma::vec column = forwardLogProb.unsafe_col(t);
+    logScales[t] = AccuLog(column);
+    if (std::isfinite(logScales[t]))
+      column -= logScales[t];
+  };
 
   // The first entry in the forward algorithm uses the initial state
   // probabilities.  Note that MATLAB assumes that the starting state (at
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-
-  forwardLogProb.col(0) = ForwardAtT0(logProbs.row(0).t(), logScales(0));
-
-  // Now compute the probabilities for each successive observation.
+  forwardLogProb.col(0) = logInitial + emissionLogProbs.col(0);
+  normalize(0);
+
+  // Now compute the probabilities for each successive observation.  The
+  // forward probability of state i at time t is the log-sum over all states j
+  // of logTransition(i, j) + forwardLogProb(j, t - 1), so each row of the
+  // transition matrix is stored as a column.  No memory is allocated in the
+  // loop.
+  const arma::mat logTransitionT = logTransition.t();
   for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
-    forwardLogProb.col(t) = ForwardAtTn(logProbs.row(t).t(), logScales(t),
-        forwardLogProb.col(t - 1));
+    const double* prevForwardLogProb = forwardLogProb.colptr(t - 1);
+    const double* emissionLogProb = emissionLogProbs.colptr(t);
+    double* forward = forwardLogProb.colptr(t);
+    for (size_t i = 0; i < states; ++i)
+    {
+      forward[i] = AccuLogSum(logTransitionT.colptr(i), prevForwardLogProb,
+          states) + emissionLogProb[i];
+    }
+
+    normalize(t);
   }
 }
 
@@ -802,30 +902,221 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardLogProb.resize(logTransition.n_rows, dataSeq.n_cols);
-  backwardLogProb.fill(-std::numeric_limits<double>::infinity());
+  const size_t states = logTransition.n_rows;
+  backwardLogProb.set_size(states, dataSeq.n_cols);
+  if (dataSeq.n_cols == 0)
+    return;
+
+  const arma::mat emissionLogProbs = logProbs.t();
+  if (scaledProbabilities)
+  {
+    ScaledBackward(emissionLogProbs, logScales, backwardLogProb);
+    return;
+  }
 
   // The last element probability is 1.
-  backwardLogProb.col(dataSeq.n_cols - 1).fill(0);
+  backwardLogProb.col(dataSeq.n_cols - 1).zeros();
 
   // Now step backwards through all other observations.
+  arma::vec nextLogProb(states);
   for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
   {
-    // The backward probability of state j at time t is the sum over all
-    // states of the probability of the next state having been a transition
-    // from the current state multiplied by the probability of each of those
-    // states emitting the given observation.  To compute this in log-space, we
-    // can use LogSumExpT().
-    const arma::mat tmp = logTransition +
-        repmat(backwardLogProb.col(t + 1), 1, logTransition.n_cols) +
-        repmat(logProbs.row(t + 1).t(), 1, logTransition.n_cols);
-    arma::vec alias = backwardLogProb.unsafe_col(t);
-    LogSumExpT<arma::mat, true>(tmp, alias);
+    // The backward probability of state i at time t is the sum over all
+    // states j of the probability of state i transitioning to state j,
+    // multiplied by the backward probability of state j at time t + 1 and the
+    // probability of state j emitting the next observation.  The column i of
+    // the transition matrix holds the transitions from state i, so this is a
+    // log-sum of column i and the same vector for every i.
+    const double* nextBackwardLogProb = backwardLogProb.colptr(t + 1);
+    const double* emissionLogProb = emissionLogProbs.colptr(t + 1);
+    for (size_t j = 0; j < states; ++j)
+      nextLogProb[j] = nextBackwardLogProb[j] + emissionLogProb[j];
 
     // Normalize by the weights from the forward algorithm.
-    if (std::isfinite(logScales[t + 1]))
-      backwardLogProb.col(t) -= logScales[t + 1];
+    const double logScale = std::isfinite(logScales[t + 1]) ?
+        logScales[t + 1] : 0.0;
+    double* backward = backwardLogProb.colptr(t);
+    for (size_t i = 0; i < states; ++i)
+    {
+      backward[i] = AccuLogSum(logTransition.colptr(i), nextLogProb.memptr(),
+          states) - logScale;
+    }
+  }
+}
+
+/**
+ * The Forward procedure, with scaled probabilities instead of
+ * log-probabilities.
+ */
+template<typename Distribution>
+void HMM<Distribution>::ScaledForward(const arma::mat& emissionLogProbs,
+                                      arma::vec& logScales,
+                                      arma::mat& forwardLogProb) const
+{
+  // In linear space, the unnormalized forward probabilities of time t are
+  // (T * f_{t - 1}) % p_t, where f_{t - 1} are the (normalized) forward
+  // probabilities of the previous time step and p_t are the emission
+  // probabilities of time t.  So that p_t can be represented, it is divided by
+  // its maximum, which is added back to the log scaling factor.  The forward
+  // probabilities are held in forwardLogProb in linear space until the end.
+  const arma::mat transition = exp(logTransition);
+  const arma::vec initial = exp(logInitial);
+  arma::vec emissionProb(logTransition.n_rows);
+  for (size_t t = 0; t < emissionLogProbs.n_cols; ++t)
+  {
+    arma::vec forward = forwardLogProb.unsafe_col(t);
+    const double maxLogProb = emissionLogProbs.col(t).max();
+    if (maxLogProb == -std::numeric_limits<double>::infinity())
+    {
+      forward.zeros();
+      logScales[t] = maxLogProb;
+      continue;
+    }
+
+    emissionProb = exp(emissionLogProbs.col(t) - maxLogProb);
+    if (t == 0)
+    {
+      forward = initial % emissionProb;
+    }
+    else
+    {
+      forward = transition * forwardLogProb.col(t - 1);
+      forward %= emissionProb;
+    }
+
+    // Normalize probability.
+    const double scale = accu(forward);
+    if (scale > 0.0)
+    {
+      forward /= scale;
+      logScales[t] = maxLogProb + std::log(scale);
+    }
+    else
+    {
+      logScales[t] = -std::numeric_limits<double>::infinity();
+    }
+  }
+
+  forwardLogProb = log(forwardLogProb);
+}
+
+/**
+ * The Backward procedure, with scaled probabilities instead of
+ * log-probabilities.
+ */
+template<typename Distribution>
+void HMM<Distribution>::ScaledBackward(const arma::mat& emissionLogProbs,
+                                       const arma::vec& logScales,
+                                       arma::mat& backwardLogProb) const
+{
+  // In linear space, the backward probabilities of time t are
+  // T^T * (b_{t + 1} % p_{t + 1}), divided by the scaling factor of time t + 1
+  // from the forward algorithm.  As in ScaledForward(), p_{t + 1} is divided
+  // by its maximum, so the scaling factor is divided by it too.
+  const arma::mat transition = exp(logTransition);
+  const size_t n = emissionLogProbs.n_cols;
+  arma::vec nextProb(logTransition.n_rows);
+
+  // The last element probability is 1.
+  backwardLogProb.col(n - 1).ones();
+  for (size_t t = n - 2; t + 1 > 0; t--)
+  {
+    arma::vec backward = backwardLogProb.unsafe_col(t);
+    const double maxLogProb = emissionLogProbs.col(t + 1).max();
+    if (maxLogProb == -std::numeric_limits<double>::infinity())
+    {
+      backward.zeros();
+      continue;
+    }
+
+    nextProb = backwardLogProb.col(t + 1) %
+        exp(emissionLogProbs.col(t + 1) - maxLogProb);
+    backward = transition.t() * nextProb;
+
+    const double logScale = std::isfinite(logScales[t + 1]) ?
+        logScales[t + 1] : 0.0;
+    backward *= std::exp(maxLogProb - logScale);
   }
+
+  backwardLogProb = log(backwardLogProb);
+}
+
+/**
+ * Compute the log-probability of each observation under the emission
+ * distribution of each hidden state.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionLogProbabilities(const arma::mat& dataSeq,
+                                                 arma::mat& logProbs) const
+{
+  logProbs.set_size(dataSeq.n_cols, logTransition.n_rows);
+
+  // Save the values of log-probability to logProbs.
+  for (size_t i = 0; i < logTransition.n_rows; i++)
+  {
+    // Define alias of desired column.
+    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
+    // Use advanced constructor for using logProbs directly.
+    emission[i].LogProbability(dataSeq, alias);
+  }
+}
+
+/**
+ * Compute the log-probability tables of the emission distributions.
+ */
+template<typename Distribution>
+template<typename D>
+void HMM<Distribution>::EmissionLogTables(
+    std::vector<std::vector<arma::vec>>& logTables,
+    const std::enable_if_t<HasLogProbabilityTables<D,
+        void(D::*)(std::vector<arma::vec>&) const>::value>*) const
+{
+  logTables.resize(emission.size());
+  for (size_t i = 0; i < emission.size(); ++i)
+    emission[i].LogProbabilityTables(logTables[i]);
+}
+
+template<typename Distribution>
+template<typename D>
+void HMM<Distribution>::EmissionLogTables(
+    std::vector<std::vector<arma::vec>>& logTables,
+    const std::enable_if_t<!HasLogProbabilityTables<D,
+        void(D::*)(std::vector<arma::vec>&) const>::value>*) const
+{
+  logTables.clear();
+}
+
+/**
+ * Gather the log-probability of each observation under the emission
+ * distribution of each hidden state from the log-probability tables.
+ */
+template<typename Distribution>
+template<typename D>
+void HMM<Distribution>::EmissionLogProbabilities(
+    const arma::mat& dataSeq,
+    const std::vector<std::vector<arma::vec>>& logTables,
+    arma::mat& logProbs,
+    const std::enable_if_t<HasLogProbabilityTables<D,
+        void(D::*)(std::vector<arma::vec>&) const>::value>*) const
+{
+  logProbs.set_size(dataSeq.n_cols, logTransition.n_rows);
+  for (size_t i = 0; i < logTransition.n_rows; i++)
+  {
+    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
+    D::LogProbability(logTables[i], dataSeq, alias);
+  }
+}
+
+template<typename Distribution>
+template<typename D>
+void HMM<Distribution>::EmissionLogProbabilities(
+    const arma::mat& dataSeq,
+    const std::vector<std::vector<arma::vec>>& /* logTables */,
+    arma::mat& logProbs,
+    const std::enable_if_t<!HasLogProbabilityTables<D,
+        void(D::*)(std::vector<arma::vec>&) const>::value>*) const
+{
+  EmissionLogProbabilities(dataSeq, logProbs);
 }
 
 /**
@@ -0,0 +1,17 @@
+/**
+ * @file methods/hnsw/hnsw.hpp
+ *
+ * Convenience include for HNSW.  This exists for the include convention of
+ * `module_name/module_name.hpp`.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_HPP
+#define MLPACK_METHODS_HNSW_HNSW_HPP
+
+#include "hnsw_search.hpp"
+
+#endif
@@ -0,0 +1,301 @@
+/**
+ * @file methods/hnsw/hnsw_search.hpp
+ *
+ * Defines the HNSWSearch class, which performs approximate nearest neighbor
+ * search with a hierarchical navigable small world graph.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @code
+ * @article{malkov2018efficient,
+ *   title={Efficient and robust approximate nearest neighbor search using
+ *       hierarchical navigable small world graphs},
+ *   author={Malkov, Yu A. and Yashunin, Dmitry A.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={42},
+ *   number={4},
+ *   pages={824--836},
+ *   year={2018},
+ *   publisher={IEEE}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+
+#include <mlpack/core.hpp>
+
+#include <mutex>
+#include <queue>
+#include <unordered_set>
+
+namespace mlpack {
+
+/**
+ * The HNSWSearch class builds a hierarchical navigable small world graph on the
+ * reference set, and uses it to compute approximate nearest neighbors of the
+ * given queries.  Each point is inserted into a random number of layers; a
+ * query descends greedily through the sparse upper layers and then performs a
+ * best-first search with a candidate list of size `ef` in the bottom layer.
+ *
+ * Larger values of `ef` give better recall at the cost of slower queries, and
+ * `ef` can be changed at any time without rebuilding the graph.  When OpenMP is
+ * available, points are inserted into the graph in parallel, and queries are
+ * answered in parallel.
+ *
+ * @tparam MetricType The metric to use for distance computations.
+ * @tparam MatType Type of matrix to use to store the data.
+ */
+template<typename MetricType = EuclideanDistance,
+         typename MatType = arma::mat>
+class HNSWSearch
+{
+ public:
+  /**
+   * Build the graph on the given reference set.  In order to avoid copying the
+   * reference set, consider passing it with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param maxNeighbors Maximum number of neighbors of each point in each layer
+   *     above the bottom layer (the bottom layer uses twice this).  Values
+   *     between 8 and 48 are typical.
+   * @param efConstruction Size of the candidate list used while building the
+   *     graph.
+   * @param ef Size of the candidate list used while searching.
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(MatType referenceSet,
+             const size_t maxNeighbors = 16,
+             const size_t efConstruction = 200,
+             const size_t ef = 50,
+             MetricType metric = MetricType());
+
+  /**
+   * Create an untrained HNSW model.  Be sure to call Train() before calling
+   * Search(); otherwise, an exception will be thrown when Search() is called.
+   *
+   * @param ef Size of the candidate list used while searching.
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(const size_t ef = 50, MetricType metric = MetricType());
+
+  /**
+   * Build the graph on the given reference set, replacing any existing graph.
+   * In order to avoid copying the reference set, consider passing it with
+   * std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param maxNeighbors Maximum number of neighbors of each point in each layer
+   *     above the bottom layer (the bottom layer uses twice this).
+   * @param efConstruction Size of the candidate list used while building the
+   *     graph.
+   */
+  void Train(MatType referenceSet,
+             const size_t maxNeighbors = 16,
+             const size_t efConstruction = 200);
+
+  /**
+   * Compute the approximate nearest neighbors of the points in the given query
+   * set and store the output in the given matrices.  The matrices will be set
+   * to the size of n columns by k rows, where n is the number of points in the
+   * query set.  If fewer than k neighbors are found for a point, the remaining
+   * neighbors are set to the number of reference points and the remaining
+   * distances are set to DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Compute the approximate nearest neighbors of every point in the reference
+   * set (not counting the point itself) and store the output in the given
+   * matrices.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param distances Matrix storing distances of neighbors for each point.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Serialize the HNSW model.
+   *
+   * @param ar Archive to serialize to.
+   * @param version serialize class version to provide backward compatibility
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t version);
+
+  //! Get the size of the candidate list used while searching.
+  size_t Ef() const { return ef; }
+  //! Modify the size of the candidate list used while searching.
+  size_t& Ef() { return ef; }
+
+  //! Get the maximum number of neighbors of a point in an upper layer.
+  size_t MaxNeighbors() const { return maxNeighbors; }
+  //! Get the size of the candidate list used while building the graph.
+  size_t EfConstruction() const { return efConstruction; }
+
+  //! Get the number of layers in the graph.
+  size_t NumLayers() const { return graph.empty() ? 0 : maxLevel + 1; }
+  //! Get the neighbors of the given point in the given layer.
+  const std::vector<size_t>& Neighbors(const size_t point,
+                                       const size_t layer) const
+  { return graph[point][layer]; }
+
+  //! Return the number of distance evaluations performed.
+  size_t DistanceEvaluations() const { return distanceEvaluations; }
+  //! Modify the number of distance evaluations performed.
+  size_t& DistanceEvaluations() { return distanceEvaluations; }
+
+  //! Return the reference dataset.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  //! Candidate represents a possible candidate neighbor (distance, index).
+  typedef std::pair<double, size_t> Candidate;
+
+  //! Return the maximum number of neighbors of a point in the given layer.
+  size_t MaxConnections(const size_t layer) const
+  { return (layer == 0) ? 2 * maxNeighbors : maxNeighbors; }
+
+  /**
+   * Insert the given reference point into the graph.  Every point in the layers
+   * of the new point must already have been allocated.
+   *
+   * @param point Index of the point to insert.
+   * @param nodeLocks Locks protecting the neighbor lists of each point.
+   * @param entryLock Lock protecting the entry point of the graph.
+   * @return Number of distance evaluations performed.
+   */
+  size_t Insert(const size_t point,
+                std::vector<std::mutex>& nodeLocks,
+                std::mutex& entryLock);
+
+  /**
+   * Search the graph for the approximate nearest neighbors of a single point,
+   * and store the results in the given column of the output matrices.
+   *
+   * @param query Point to search for.
+   * @param k Number of neighbors to search for.
+   * @param skip Index of a reference point to leave out of the results (or the
+   *     number of reference points to not skip anything).
+   * @param col Column of the output matrices to store the results in.
+   * @param neighbors Matrix storing lists of neighbors.
+   * @param distances Matrix storing distances of neighbors.
+   * @param evaluations Number of distance evaluations; incremented.
+   */
+  template<typename VecType>
+  void SearchPoint(const VecType& query,
+                   const size_t k,
+                   const size_t skip,
+                   const size_t col,
+                   arma::Mat<size_t>& neighbors,
+                   arma::mat& distances,
+                   size_t& evaluations);
+
+  /**
+   * Move greedily to the neighbor closest to the query in the given layer,
+   * until no neighbor is closer.
+   *
+   * @param query Point to search for.
+   * @param layer Layer to search in.
+   * @param current Starting point; set to the closest point found.
+   * @param currentDistance Distance to the starting point; updated.
+   * @param evaluations Number of distance evaluations; incremented.
+   * @param nodeLocks Locks to take before reading neighbor lists (or NULL).
+   */
+  template<typename VecType>
+  void GreedyClosest(const VecType& query,
+                     const size_t layer,
+                     size_t& current,
+                     double& currentDistance,
+                     size_t& evaluations,
+                     std::vector<std::mutex>* nodeLocks);
+
+  /**
+   * Perform a best-first search for the ef nearest points to the query in the
+   * given layer, starting at the given point.
+   *
+   * @param query Point to search for.
+   * @param entry Starting point.
+   * @param entryDistance Distance to the starting point.
+   * @param searchEf Size of the candidate list.
+   * @param layer Layer to search in.
+   * @param results Points found, sorted by increasing distance.
+   * @param evaluations Number of distance evaluations; incremented.
+   * @param nodeLocks Locks to take before reading neighbor lists (or NULL).
+   */
+  template<typename VecType>
+  void SearchLayer(const VecType& query,
+                   const size_t entry,
+                   const double entryDistance,
+                   const size_t searchEf,
+                   const size_t layer,
+                   std::vector<Candidate>& results,
+                   size_t& evaluations,
+                   std::vector<std::mutex>* nodeLocks);
+
+  /**
+   * Select at most maxConnections neighbors from the given candidates (sorted
+   * by increasing distance), keeping a candidate only if it is closer to the
+   * base point than to every neighbor selected so far.  This keeps the graph
+   * connected across clusters.
+   *
+   * @param candidates Candidates, sorted by increasing distance.
+   * @param maxConnections Maximum number of neighbors to select.
+   * @param selected Indices of the selected neighbors.
+   * @param evaluations Number of distance evaluations; incremented.
+   */
+  void SelectNeighbors(const std::vector<Candidate>& candidates,
+                       const size_t maxConnections,
+                       std::vector<size_t>& selected,
+                       size_t& evaluations);
+
+  //! Reference dataset.
+  MatType referenceSet;
+  //! Maximum number of neighbors of a point in an upper layer.
+  size_t maxNeighbors;
+  //! Size of the candidate list used while building the graph.
+  size_t efConstruction;
+  //! Size of the candidate list used while searching.
+  size_t ef;
+  //! Instantiated metric.
+  MetricType metric;
+
+  //! The neighbors of each point (outer index) in each of its layers.
+  std::vector<std::vector<std::vector<size_t>>> graph;
+  //! The point that every search starts from; it is in the top layer.
+  size_t entryPoint;
+  //! The index of the top layer.
+  size_t maxLevel;
+
+  //! The number of distance evaluations.
+  size_t distanceEvaluations;
+}; // class HNSWSearch
+
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_search_impl.hpp"
+
+#endif
@@ -0,0 +1,461 @@
+/**
+ * @file methods/hnsw/hnsw_search_impl.hpp
+ *
+ * Implementation of the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw_search.hpp"
+
+namespace mlpack {
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(MatType referenceSetIn,
+                                            const size_t maxNeighbors,
+                                            const size_t efConstruction,
+                                            const size_t ef,
+                                            MetricType metric) :
+    ef(ef),
+    metric(std::move(metric)),
+    entryPoint(0),
+    maxLevel(0),
+    distanceEvaluations(0)
+{
+  Train(std::move(referenceSetIn), maxNeighbors, efConstruction);
+}
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(const size_t ef,
+                                            MetricType metric) :
+    maxNeighbors(16),
+    efConstruction(200),
+    ef(ef),
+    metric(std::move(metric)),
+    entryPoint(0),
+    maxLevel(0),
+    distanceEvaluations(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Train(MatType referenceSetIn,
+                                            const size_t maxNeighborsIn,
+                                            const size_t efConstructionIn)
+{
+  if (maxNeighborsIn < 2)
+  {
+    throw std::invalid_argument("HNSWSearch::Train(): maxNeighbors must be at "
+        "least 2");
+  }
+
+  referenceSet = std::move(referenceSetIn);
+  maxNeighbors = maxNeighborsIn;
+  efConstruction = std::max(efConstructionIn, maxNeighbors);
+  distanceEvaluations = 0;
+  entryPoint = 0;
+  maxLevel = 0;
+
+  // Draw the top layer of each point from an exponentially decaying
+  // distribution.  This is done serially so that the levels do not depend on
+  // the number of threads.
+  const double levelMultiplier = 1.0 / std::log((double) maxNeighbors);
+  graph.clear();
+  graph.resize(referenceSet.n_cols);
+  for (size_t i = 0; i < referenceSet.n_cols; ++i)
+  {
+    const size_t level = (size_t) (-std::log(1.0 - Random()) *
+        levelMultiplier);
+    graph[i].resize(level + 1);
+  }
+
+  if (referenceSet.n_cols == 0)
+    return;
+
+  // The first point is the initial entry point; every other point is inserted
+  // in parallel.
+  maxLevel = graph[0].size() - 1;
+  std::vector<std::mutex> nodeLocks(referenceSet.n_cols);
+  std::mutex entryLock;
+  size_t evaluations = 0;
+
+  #pragma omp parallel for schedule(dynamic) reduction(+:evaluations) \
+      num_threads((int) NumThreads())
+  for (size_t i = 1; i < (size_t) referenceSet.n_cols; ++i)
+    evaluations += Insert(i, nodeLocks, entryLock);
+
+  distanceEvaluations = evaluations;
+  Log::Info << "Built HNSW graph with " << NumLayers() << " layers on "
+      << referenceSet.n_cols << " points." << std::endl;
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const MatType& querySet,
+                                             const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  if (k > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested value of k (" << k << ") is "
+        << "greater than the number of points in the reference set ("
+        << referenceSet.n_cols << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << referenceSet.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // If the user asked for 0 nearest neighbors... we're done.
+  if (k == 0)
+    return;
+
+  size_t evaluations = 0;
+
+  #pragma omp parallel for schedule(dynamic) reduction(+:evaluations) \
+      num_threads((int) NumThreads())
+  for (size_t i = 0; i < (size_t) querySet.n_cols; ++i)
+  {
+    SearchPoint(querySet.col(i), k, referenceSet.n_cols, i, neighbors,
+        distances, evaluations);
+  }
+
+  distanceEvaluations += evaluations;
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  if (k >= referenceSet.n_cols && k > 0)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested value of k (" << k << ") must be "
+        << "less than the number of points in the reference set ("
+        << referenceSet.n_cols << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // This is monochromatic search; the query set is the reference set.
+  neighbors.set_size(k, referenceSet.n_cols);
+  distances.set_size(k, referenceSet.n_cols);
+
+  // If the user asked for 0 nearest neighbors... we're done.
+  if (k == 0)
+    return;
+
+  size_t evaluations = 0;
+
+  #pragma omp parallel for schedule(dynamic) reduction(+:evaluations) \
+      num_threads((int) NumThreads())
+  for (size_t i = 0; i < (size_t) referenceSet.n_cols; ++i)
+  {
+    // Don't return the point itself as its own neighbor.
+    SearchPoint(referenceSet.col(i), k, i, i, neighbors, distances,
+        evaluations);
+  }
+
+  distanceEvaluations += evaluations;
+}
+
+template<typename MetricType, typename MatType>
+template<typename Archive>
+void HNSWSearch<MetricType, MatType>::serialize(Archive& ar,
+                                                const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(referenceSet));
+  ar(CEREAL_NVP(maxNeighbors));
+  ar(CEREAL_NVP(efConstruction));
+  ar(CEREAL_NVP(ef));
+  ar(CEREAL_NVP(metric));
+  ar(CEREAL_NVP(graph));
+  ar(CEREAL_NVP(entryPoint));
+  ar(CEREAL_NVP(maxLevel));
+  ar(CEREAL_NVP(distanceEvaluations));
+}
+
+template<typename MetricType, typename MatType>
+size_t HNSWSearch<MetricType, MatType>::Insert(
+    const size_t point,
+    std::vector<std::mutex>& nodeLocks,
+    std::mutex& entryLock)
+{
+  size_t evaluations = 0;
+  const size_t level = graph[point].size() - 1;
+
+  // If the new point will become the entry point, hold the entry lock until it
+  // has been linked into every layer; otherwise only read the entry point.
+  std::unique_lock<std::mutex> entryGuard(entryLock);
+  size_t current = entryPoint;
+  const size_t topLevel = maxLevel;
+  if (level <= topLevel)
+    entryGuard.unlock();
+
+  double currentDistance = metric.Evaluate(referenceSet.col(point),
+      referenceSet.col(current));
+  ++evaluations;
+
+  // Descend through the layers above the top layer of the new point.
+  for (size_t layer = topLevel; layer > level; --layer)
+  {
+    GreedyClosest(referenceSet.col(point), layer, current, currentDistance,
+        evaluations, &nodeLocks);
+  }
+
+  std::vector<Candidate> candidates;
+  std::vector<Candidate> linkCandidates;
+  std::vector<size_t> selected;
+  for (size_t layer = std::min(level, topLevel) + 1; layer-- > 0; )
+  {
+    SearchLayer(referenceSet.col(point), current, currentDistance,
+        efConstruction, layer, candidates, evaluations, &nodeLocks);
+    SelectNeighbors(candidates, MaxConnections(layer), selected, evaluations);
+
+    {
+      std::lock_guard<std::mutex> guard(nodeLocks[point]);
+      graph[point][layer] = selected;
+    }
+
+    // Add the reverse links, pruning any neighbor list that grows too large.
+    for (size_t i = 0; i < selected.size(); ++i)
+    {
+      const size_t neighbor = selected[i];
+      std::lock_guard<std::mutex> guard(nodeLocks[neighbor]);
+      std::vector<size_t>& links = graph[neighbor][layer];
+      links.push_back(point);
+      if (links.size() <= MaxConnections(layer))
+        continue;
+
+      linkCandidates.resize(links.size());
+      for (size_t j = 0; j < links.size(); ++j)
+      {
+        linkCandidates[j] = Candidate(metric.Evaluate(
+            referenceSet.col(neighbor), referenceSet.col(links[j])), links[j]);
+      }
+      evaluations += links.size();
+
+      std::sort(linkCandidates.begin(), linkCandidates.end());
+      SelectNeighbors(linkCandidates, MaxConnections(layer), links,
+          evaluations);
+    }
+
+    // The closest point found is the starting point in the next layer.
+    current = candidates[0].second;
+    currentDistance = candidates[0].first;
+  }
+
+  if (level > topLevel)
+  {
+    // We still hold the entry lock.
+    entryPoint = point;
+    maxLevel = level;
+  }
+
+  return evaluations;
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchPoint(const VecType& query,
+                                                  const size_t k,
+                                                  const size_t skip,
+                                                  const size_t col,
+                                                  arma::Mat<size_t>& neighbors,
+                                                  arma::mat& distances,
+                                                  size_t& evaluations)
+{
+  size_t current = entryPoint;
+  double currentDistance = metric.Evaluate(query, referenceSet.col(current));
+  ++evaluations;
+
+  for (size_t layer = maxLevel; layer > 0; --layer)
+  {
+    GreedyClosest(query, layer, current, currentDistance, evaluations,
+        NULL);
+  }
+
+  // If a point is skipped, we need one more candidate.
+  const size_t searchK = (skip < referenceSet.n_cols) ? k + 1 : k;
+  std::vector<Candidate> candidates;
+  SearchLayer(query, current, currentDistance, std::max(ef, searchK), 0,
+      candidates, evaluations, NULL);
+
+  size_t found = 0;
+  for (size_t i = 0; i < candidates.size() && found < k; ++i)
+  {
+    if (candidates[i].second == skip)
+      continue;
+
+    neighbors(found, col) = candidates[i].second;
+    distances(found, col) = candidates[i].first;
+    ++found;
+  }
+
+  for (; found < k; ++found)
+  {
+    neighbors(found, col) = referenceSet.n_cols;
+    distances(found, col) = DBL_MAX;
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::GreedyClosest(
+    const VecType& query,
+    const size_t layer,
+    size_t& current,
+    double& currentDistance,
+    size_t& evaluations,
+    std::vector<std::mutex>* nodeLocks)
+{
+  std::vector<size_t> linksCopy;
+  bool changed = true;
+  while (changed)
+  {
+    changed = false;
+
+    // During construction, other threads may modify the neighbor list.
+    const std::vector<size_t>* links = &graph[current][layer];
+    if (nodeLocks)
+    {
+      std::lock_guard<std::mutex> guard((*nodeLocks)[current]);
+      linksCopy = graph[current][layer];
+      links = &linksCopy;
+    }
+
+    for (size_t i = 0; i < links->size(); ++i)
+    {
+      const size_t neighbor = (*links)[i];
+      const double distance = metric.Evaluate(query,
+          referenceSet.col(neighbor));
+      ++evaluations;
+      if (distance < currentDistance)
+      {
+        currentDistance = distance;
+        current = neighbor;
+        changed = true;
+      }
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchLayer(
+    const VecType& query,
+    const size_t entry,
+    const double entryDistance,
+    const size_t searchEf,
+    const size_t layer,
+    std::vector<Candidate>& results,
+    size_t& evaluations,
+    std::vector<std::mutex>* nodeLocks)
+{
+  std::unordered_set<size_t> visited;
+  visited.insert(entry);
+
+  // The closest candidate that has not been expanded yet is on top.
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> toVisit;
+  // The furthest of the best points found so far is on top.
+  std::priority_queue<Candidate> found;
+
+  toVisit.push(Candidate(entryDistance, entry));
+  found.push(Candidate(entryDistance, entry));
+
+  std::vector<size_t> linksCopy;
+  while (!toVisit.empty())
+  {
+    const Candidate closest = toVisit.top();
+    if (closest.first > found.top().first)
+      break; // No remaining candidate can improve the results.
+    toVisit.pop();
+
+    // During construction, other threads may modify the neighbor list.
+    const std::vector<size_t>* links = &graph[closest.second][layer];
+    if (nodeLocks)
+    {
+      std::lock_guard<std::mutex> guard((*nodeLocks)[closest.second]);
+      linksCopy = graph[closest.second][layer];
+      links = &linksCopy;
+    }
+
+    for (size_t i = 0; i < links->size(); ++i)
+    {
+      const size_t neighbor = (*links)[i];
+      if (!visited.insert(neighbor).second)
+        continue;
+
+      const double distance = metric.Evaluate(query,
+          referenceSet.col(neighbor));
+      ++evaluations;
+      if (found.size() < searchEf || distance < found.top().first)
+      {
+        toVisit.push(Candidate(distance, neighbor));
+        found.push(Candidate(distance, neighbor));
+        if (found.size() > searchEf)
+          found.pop();
+      }
+    }
+  }
+
+  // Extract the results in increasing order of distance.
+  results.resize(found.size());
+  for (size_t i = results.size(); i > 0; --i)
+  {
+    results[i - 1] = found.top();
+    found.pop();
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SelectNeighbors(
+    const std::vector<Candidate>& candidates,
+    const size_t maxConnections,
+    std::vector<size_t>& selected,
+    size_t& evaluations)
+{
+  selected.clear();
+  for (size_t i = 0; i < candidates.size(); ++i)
+  {
+    if (selected.size() == maxConnections)
+      break;
+
+    bool keep = true;
+    for (size_t j = 0; j < selected.size(); ++j)
+    {
+      ++evaluations;
+      if (metric.Evaluate(referenceSet.col(candidates[i].second),
+          referenceSet.col(selected[j])) < candidates[i].first)
+      {
+        keep = false;
+        break;
+      }
+    }
+
+    if (keep)
+      selected.push_back(candidates[i].second);
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -31,6 +31,9 @@ class BinaryNumericSplitInfo
     return (value < splitPoint) ? 0 : 1;
   }
 
+  //! Get the split point; values smaller than it go to the first child.
+  ObservationType SplitPoint() const { return splitPoint; }
+
   //! Serialize the split (save/load the split points).
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
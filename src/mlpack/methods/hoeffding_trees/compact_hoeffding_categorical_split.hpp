@@ -0,0 +1,131 @@
+/**
+ * @file methods/hoeffding_trees/compact_hoeffding_categorical_split.hpp
+ *
+ * A categorical feature split for Hoeffding trees that makes the same splits
+ * as HoeffdingCategoricalSplit, but only stores counts for the categories that
+ * have been seen.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_COMPACT_CATEGORICAL_SPLIT_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_COMPACT_CATEGORICAL_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "categorical_split_info.hpp"
+
+namespace mlpack {
+
+/**
+ * The CompactHoeffdingCategoricalSplit tracks the same sufficient statistics
+ * as HoeffdingCategoricalSplit and makes the same splits, but instead of a
+ * dense categories-by-classes matrix, it only stores the class counts of the
+ * categories that the node has actually seen, as 32-bit integers.  For
+ * high-cardinality features, where each leaf only sees a few of the
+ * categories, this takes much less memory; a leaf that has seen no points
+ * holds no counts at all.  It also keeps the total count of each class, so
+ * that the majority class is found without going through every category.
+ *
+ * Each leaf and dimension may see at most 2^32 - 1 points.
+ *
+ * @tparam FitnessFunction Fitness function to use for calculating gain.
+ */
+template<typename FitnessFunction>
+class CompactHoeffdingCategoricalSplit
+{
+ public:
+  //! The type of split information required by the
+  //! CompactHoeffdingCategoricalSplit.
+  typedef CategoricalSplitInfo SplitInfo;
+
+  /**
+   * Create the CompactHoeffdingCategoricalSplit given a number of categories
+   * for this dimension and a number of classes.
+   *
+   * @param numCategories Number of categories in this dimension.
+   * @param numClasses Number of classes in this dimension.
+   */
+  CompactHoeffdingCategoricalSplit(const size_t numCategories = 0,
+                                   const size_t numClasses = 0);
+
+  /**
+   * Create the CompactHoeffdingCategoricalSplit given a number of categories
+   * for this dimension and a number of classes and another split to take
+   * parameters from.  There are no parameters to take, but this constructor is
+   * required by the HoeffdingTree class.
+   */
+  CompactHoeffdingCategoricalSplit(
+      const size_t numCategories,
+      const size_t numClasses,
+      const CompactHoeffdingCategoricalSplit& other);
+
+  /**
+   * Train on the given value with the given label.
+   *
+   * @param value Value to train on.
+   * @param label Label to train on.
+   */
+  template<typename eT>
+  void Train(eT value, const size_t label);
+
+  /**
+   * Given the points seen so far, evaluate the fitness function, returning the
+   * gain for the best possible split and the second best possible split.  In
+   * this splitting technique, we only split one possible way, so
+   * secondBestFitness will always be 0.
+   *
+   * @param bestFitness The fitness function result for this split.
+   * @param secondBestFitness This is always set to 0 (this split only splits
+   *      one way).
+   */
+  void EvaluateFitnessFunction(double& bestFitness, double& secondBestFitness)
+      const;
+
+  //! Return the number of children, if the node were to split.
+  size_t NumChildren() const { return numCategories; }
+
+  /**
+   * Gather the information for a split: get the labels of the child majorities,
+   * and initialize the SplitInfo object.
+   *
+   * @param childMajorities Majorities of child nodes to be created.
+   * @param splitInfo Information for splitting.
+   */
+  void Split(arma::Col<size_t>& childMajorities, SplitInfo& splitInfo);
+
+  //! Get the majority class seen so far.
+  size_t MajorityClass() const;
+  //! Get the probability of the majority class given the points seen so far.
+  double MajorityProbability() const;
+
+  //! Get the number of categories that have been seen.
+  size_t NumSeenCategories() const { return categories.size(); }
+
+  //! Serialize the categorical split.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! The number of categories in this dimension.
+  size_t numCategories;
+  //! The number of classes.
+  size_t numClasses;
+  //! The categories that have been seen, in the order they were first seen.
+  std::vector<size_t> categories;
+  //! The class counts of each seen category: numClasses counts for each
+  //! element of categories, one after another.
+  std::vector<uint32_t> counts;
+  //! The total count of each class.
+  std::vector<uint32_t> classCounts;
+  //! The index in categories of each seen category.
+  std::unordered_map<size_t, size_t> categoryIndices;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "compact_hoeffding_categorical_split_impl.hpp"
+
+#endif
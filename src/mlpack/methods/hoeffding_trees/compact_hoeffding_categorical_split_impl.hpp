@@ -0,0 +1,145 @@
+/**
+ * @file methods/hoeffding_trees/compact_hoeffding_categorical_split_impl.hpp
+ *
+ * Implementation of the CompactHoeffdingCategoricalSplit class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_COMPACT_CATEGORICAL_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_COMPACT_CATEGORICAL_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "compact_hoeffding_categorical_split.hpp"
+
+namespace mlpack {
+
+template<typename FitnessFunction>
+CompactHoeffdingCategoricalSplit<FitnessFunction>::
+    CompactHoeffdingCategoricalSplit(const size_t numCategories,
+                                     const size_t numClasses) :
+    numCategories(numCategories),
+    numClasses(numClasses),
+    classCounts(numClasses, 0)
+{
+  // Nothing to do.
+}
+
+template<typename FitnessFunction>
+CompactHoeffdingCategoricalSplit<FitnessFunction>::
+    CompactHoeffdingCategoricalSplit(
+        const size_t numCategories,
+        const size_t numClasses,
+        const CompactHoeffdingCategoricalSplit& /* other */) :
+    numCategories(numCategories),
+    numClasses(numClasses),
+    classCounts(numClasses, 0)
+{
+  // Nothing to do.
+}
+
+template<typename FitnessFunction>
+template<typename eT>
+void CompactHoeffdingCategoricalSplit<FitnessFunction>::Train(
+    eT value,
+    const size_t label)
+{
+  // 'value' should be categorical, so we should be able to cast to size_t...
+  const size_t category = size_t(value);
+  auto it = categoryIndices.find(category);
+  if (it == categoryIndices.end())
+  {
+    // This is the first point in this category.
+    it = categoryIndices.insert(std::make_pair(category,
+        categories.size())).first;
+    categories.push_back(category);
+    counts.resize(counts.size() + numClasses, 0);
+  }
+
+  counts[it->second * numClasses + label]++;
+  classCounts[label]++;
+}
+
+template<typename FitnessFunction>
+void CompactHoeffdingCategoricalSplit<FitnessFunction>::
+    EvaluateFitnessFunction(double& bestFitness,
+                            double& secondBestFitness) const
+{
+  secondBestFitness = 0.0; // We only split one possible way.
+  if (categories.empty())
+  {
+    bestFitness = 0.0;
+    return;
+  }
+
+  // The categories that have not been seen would only add empty columns, which
+  // do not change the fitness function.
+  const arma::Mat<uint32_t> seenCounts(const_cast<uint32_t*>(counts.data()),
+      numClasses, categories.size(), false, true);
+  bestFitness = FitnessFunction::Evaluate(seenCounts);
+}
+
+template<typename FitnessFunction>
+void CompactHoeffdingCategoricalSplit<FitnessFunction>::Split(
+    arma::Col<size_t>& childMajorities,
+    SplitInfo& splitInfo)
+{
+  // We'll make one child for each category; a category that has not been seen
+  // gets the first class, like an empty column of counts would.
+  childMajorities.zeros(numCategories);
+  for (size_t i = 0; i < categories.size(); ++i)
+  {
+    const uint32_t* categoryCounts = counts.data() + i * numClasses;
+    childMajorities[categories[i]] = std::max_element(categoryCounts,
+        categoryCounts + numClasses) - categoryCounts;
+  }
+
+  // Create the according SplitInfo object.
+  splitInfo = SplitInfo(numCategories);
+}
+
+template<typename FitnessFunction>
+size_t CompactHoeffdingCategoricalSplit<FitnessFunction>::MajorityClass() const
+{
+  return std::max_element(classCounts.begin(), classCounts.end()) -
+      classCounts.begin();
+}
+
+template<typename FitnessFunction>
+double CompactHoeffdingCategoricalSplit<FitnessFunction>::MajorityProbability()
+    const
+{
+  size_t total = 0;
+  for (size_t i = 0; i < classCounts.size(); ++i)
+    total += classCounts[i];
+
+  return double(*std::max_element(classCounts.begin(), classCounts.end())) /
+      double(total);
+}
+
+template<typename FitnessFunction>
+template<typename Archive>
+void CompactHoeffdingCategoricalSplit<FitnessFunction>::serialize(
+    Archive& ar,
+    const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(numCategories));
+  ar(CEREAL_NVP(numClasses));
+  ar(CEREAL_NVP(categories));
+  ar(CEREAL_NVP(counts));
+  ar(CEREAL_NVP(classCounts));
+
+  if (cereal::is_loading<Archive>())
+  {
+    // Rebuild the index of the seen categories.
+    categoryIndices.clear();
+    for (size_t i = 0; i < categories.size(); ++i)
+      categoryIndices[categories[i]] = i;
+  }
+}
+
+} // namespace mlpack
+
+#endif
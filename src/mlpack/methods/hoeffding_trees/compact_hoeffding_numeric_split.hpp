@@ -0,0 +1,149 @@
+/**
+ * @file methods/hoeffding_trees/compact_hoeffding_numeric_split.hpp
+ *
+ * A numeric feature split for Hoeffding trees that makes the same splits as
+ * HoeffdingNumericSplit, but stores its sufficient statistics compactly.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_COMPACT_HOEFFDING_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_COMPACT_HOEFFDING_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "numeric_split_info.hpp"
+
+namespace mlpack {
+
+/**
+ * The CompactHoeffdingNumericSplit class implements the same binning strategy
+ * as HoeffdingNumericSplit, and makes the same splits, but it needs much less
+ * memory, so that larger trees (or trees on many more features) can be built
+ * with a fixed memory budget:
+ *
+ *  - the counts are stored as 32-bit integers;
+ *  - the buffer of observations seen before binning grows as points are seen,
+ *    instead of being allocated for observationsBeforeBinning points up front,
+ *    and it is freed once the bins are computed;
+ *  - the bin-by-class counts are only allocated once the bins are computed.
+ *
+ * So, a leaf that has only seen a few points holds almost nothing for each
+ * dimension.  Each leaf and dimension may see at most 2^32 - 1 points.
+ *
+ * @tparam FitnessFunction Fitness function to use for calculating gain.
+ * @tparam ObservationType Type of observations in this dimension.
+ */
+template<typename FitnessFunction,
+         typename ObservationType = double>
+class CompactHoeffdingNumericSplit
+{
+ public:
+  //! The splitting information type required by the
+  //! CompactHoeffdingNumericSplit.
+  typedef NumericSplitInfo<ObservationType> SplitInfo;
+
+  /**
+   * Create the CompactHoeffdingNumericSplit class, and specify some basic
+   * parameters about how the binning should take place.
+   *
+   * @param numClasses Number of classes.
+   * @param bins Number of bins.
+   * @param observationsBeforeBinning Number of points to see before binning is
+   *      performed.
+   */
+  CompactHoeffdingNumericSplit(const size_t numClasses = 0,
+                               const size_t bins = 10,
+                               const size_t observationsBeforeBinning = 100);
+
+  /**
+   * Create the CompactHoeffdingNumericSplit class, using the parameters from
+   * the given other split object.
+   */
+  CompactHoeffdingNumericSplit(const size_t numClasses,
+                               const CompactHoeffdingNumericSplit& other);
+
+  /**
+   * Train the CompactHoeffdingNumericSplit on the given observed value.
+   *
+   * @param value Value in the dimension that this split refers to.
+   * @param label Label of the given point.
+   */
+  void Train(ObservationType value, const size_t label);
+
+  /**
+   * Evaluate the fitness function given what has been calculated so far.  If
+   * binning has not yet been performed, 0 will be returned (i.e., no gain).
+   * Because this split can only split one possible way, secondBestFitness will
+   * be set to 0.
+   *
+   * @param bestFitness Value of the fitness function for the best possible
+   *      split.
+   * @param secondBestFitness Value of the fitness function for the second best
+   *      possible split (always 0 for this split).
+   */
+  void EvaluateFitnessFunction(double& bestFitness, double& secondBestFitness)
+      const;
+
+  //! Return the number of children if this node splits on this feature.
+  size_t NumChildren() const { return bins; }
+
+  /**
+   * Return the majority class of each child to be created, if a split on this
+   * dimension was performed.  Also create the split object.
+   */
+  void Split(arma::Col<size_t>& childMajorities, SplitInfo& splitInfo) const;
+
+  //! Return the majority class.
+  size_t MajorityClass() const;
+  //! Return the probability of the majority class.
+  double MajorityProbability() const;
+
+  //! Return the number of bins.
+  size_t Bins() const { return bins; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Count the points of each class seen so far.
+  arma::Col<uint32_t> ClassCounts() const;
+
+  //! Before binning, this holds the points we have seen so far (it may be
+  //! longer than the number of points seen).
+  arma::Col<ObservationType> observations;
+  //! This holds the labels of the points before binning.
+  arma::Col<uint32_t> labels;
+
+  //! The split points for the binning (length bins - 1).
+  arma::Col<ObservationType> splitPoints;
+  //! The number of classes.
+  size_t numClasses;
+  //! The number of bins.
+  size_t bins;
+  //! The number of observations we must see before binning.
+  size_t observationsBeforeBinning;
+  //! The number of samples we have seen so far.
+  size_t samplesSeen;
+
+  //! After binning, this contains the sufficient statistics.
+  arma::Mat<uint32_t> sufficientStatistics;
+};
+
+//! Convenience typedef.
+template<typename FitnessFunction>
+using CompactHoeffdingDoubleNumericSplit =
+    CompactHoeffdingNumericSplit<FitnessFunction, double>;
+
+template<typename FitnessFunction>
+using CompactHoeffdingFloatNumericSplit =
+    CompactHoeffdingNumericSplit<FitnessFunction, float>;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "compact_hoeffding_numeric_split_impl.hpp"
+
+#endif
@@ -0,0 +1,214 @@
+/**
+ * @file methods/hoeffding_trees/compact_hoeffding_numeric_split_impl.hpp
+ *
+ * Implementation of the CompactHoeffdingNumericSplit class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_COMPACT_HOEFFDING_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_COMPACT_HOEFFDING_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "compact_hoeffding_numeric_split.hpp"
+
+namespace mlpack {
+
+template<typename FitnessFunction, typename ObservationType>
+CompactHoeffdingNumericSplit<FitnessFunction, ObservationType>::
+    CompactHoeffdingNumericSplit(const size_t numClasses,
+                                 const size_t bins,
+                                 const size_t observationsBeforeBinning) :
+    numClasses(numClasses),
+    bins(bins),
+    observationsBeforeBinning(observationsBeforeBinning),
+    samplesSeen(0)
+{
+  // Nothing is allocated until points are seen.
+}
+
+template<typename FitnessFunction, typename ObservationType>
+CompactHoeffdingNumericSplit<FitnessFunction, ObservationType>::
+    CompactHoeffdingNumericSplit(const size_t numClasses,
+                                 const CompactHoeffdingNumericSplit& other) :
+    numClasses(numClasses),
+    bins(other.bins),
+    observationsBeforeBinning(other.observationsBeforeBinning),
+    samplesSeen(0)
+{
+  // Nothing is allocated until points are seen.
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void CompactHoeffdingNumericSplit<FitnessFunction, ObservationType>::Train(
+    ObservationType value,
+    const size_t label)
+{
+  if (samplesSeen < observationsBeforeBinning - 1)
+  {
+    // Grow the buffers geometrically, but never past the number of points we
+    // will hold before binning.
+    if (samplesSeen == observations.n_elem)
+    {
+      const size_t newSize = std::min(std::max(2 * (size_t) observations.n_elem,
+          (size_t) 8), observationsBeforeBinning - 1);
+      observations.resize(newSize);
+      labels.resize(newSize);
+    }
+
+    // Add this to the samples we have seen.
+    observations[samplesSeen] = value;
+    labels[samplesSeen] = (uint32_t) label;
+    ++samplesSeen;
+    return;
+  }
+  else if (samplesSeen == observationsBeforeBinning - 1)
+  {
+    // Now we need to make the bins.
+    ObservationType min = value;
+    ObservationType max = value;
+    for (size_t i = 0; i < samplesSeen; ++i)
+    {
+      if (observations[i] < min)
+        min = observations[i];
+      else if (observations[i] > max)
+        max = observations[i];
+    }
+
+    // Now split these.  We can't use linspace, because we don't want to include
+    // the endpoints.
+    splitPoints.set_size(bins - 1);
+    const ObservationType binWidth = (max - min) / bins;
+    for (size_t i = 0; i < bins - 1; ++i)
+      splitPoints[i] = min + (i + 1) * binWidth;
+
+    // Now, add all of the points we've seen to the sufficient statistics, and
+    // release the buffers.
+    sufficientStatistics.zeros(numClasses, bins);
+    for (size_t i = 0; i < samplesSeen; ++i)
+    {
+      const size_t bin = std::lower_bound(splitPoints.begin(),
+          splitPoints.end(), observations[i]) - splitPoints.begin();
+      sufficientStatistics(labels[i], bin)++;
+    }
+
+    observations.reset();
+    labels.reset();
+    ++samplesSeen;
+  }
+  else
+  {
+    ++samplesSeen;
+  }
+
+  // If we've gotten to here, then we need to add the point to the sufficient
+  // statistics.  The bin of the point is the number of split points below it.
+  const size_t bin = std::lower_bound(splitPoints.begin(), splitPoints.end(),
+      value) - splitPoints.begin();
+  sufficientStatistics(label, bin)++;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void CompactHoeffdingNumericSplit<FitnessFunction, ObservationType>::
+    EvaluateFitnessFunction(double& bestFitness,
+                            double& secondBestFitness) const
+{
+  secondBestFitness = 0.0; // We can only split one way.
+  if (samplesSeen < observationsBeforeBinning)
+    bestFitness = 0.0;
+  else
+    bestFitness = FitnessFunction::Evaluate(sufficientStatistics);
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void CompactHoeffdingNumericSplit<FitnessFunction, ObservationType>::Split(
+    arma::Col<size_t>& childMajorities,
+    SplitInfo& splitInfo) const
+{
+  childMajorities.set_size(sufficientStatistics.n_cols);
+  for (size_t i = 0; i < sufficientStatistics.n_cols; ++i)
+    childMajorities[i] = (size_t) sufficientStatistics.col(i).index_max();
+
+  // Create the SplitInfo object.
+  splitInfo = SplitInfo(splitPoints);
+}
+
+template<typename FitnessFunction, typename ObservationType>
+size_t CompactHoeffdingNumericSplit<FitnessFunction, ObservationType>::
+    MajorityClass() const
+{
+  return (size_t) ClassCounts().index_max();
+}
+
+template<typename FitnessFunction, typename ObservationType>
+double CompactHoeffdingNumericSplit<FitnessFunction, ObservationType>::
+    MajorityProbability() const
+{
+  const arma::Col<uint32_t> classCounts = ClassCounts();
+  return double(classCounts.max()) / double(samplesSeen);
+}
+
+template<typename FitnessFunction, typename ObservationType>
+arma::Col<uint32_t> CompactHoeffdingNumericSplit<FitnessFunction,
+    ObservationType>::ClassCounts() const
+{
+  // If we haven't yet determined the bins, we must calculate this by hand.
+  if (samplesSeen < observationsBeforeBinning)
+  {
+    arma::Col<uint32_t> classCounts(numClasses, arma::fill::zeros);
+    for (size_t i = 0; i < samplesSeen; ++i)
+      classCounts[labels[i]]++;
+
+    return classCounts;
+  }
+  else
+  {
+    return arma::sum(sufficientStatistics, 1);
+  }
+}
+
+template<typename FitnessFunction, typename ObservationType>
+template<typename Archive>
+void CompactHoeffdingNumericSplit<FitnessFunction, ObservationType>::serialize(
+    Archive& ar,
+    const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(samplesSeen));
+  ar(CEREAL_NVP(observationsBeforeBinning));
+  ar(CEREAL_NVP(bins));
+  ar(CEREAL_NVP(numClasses));
+
+  if (samplesSeen >= observationsBeforeBinning)
+  {
+    // The binning has happened, so we only need to save the resulting bins.
+    ar(CEREAL_NVP(splitPoints));
+    ar(CEREAL_NVP(sufficientStatistics));
+
+    if (cereal::is_loading<Archive>())
+    {
+      // Clean other objects.
+      observations.reset();
+      labels.reset();
+    }
+  }
+  else
+  {
+    // The binning has not happened yet, so we only need to save the points
+    // seen so far.
+    ar(CEREAL_NVP(observations));
+    ar(CEREAL_NVP(labels));
+
+    if (cereal::is_loading<Archive>())
+    {
+      // Clean other objects.
+      splitPoints.reset();
+      sufficientStatistics.reset();
+    }
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,264 @@
+/**
+ * @file methods/hoeffding_trees/flat_hoeffding_tree.hpp
+ *
+ * A compiled, read-only representation of a trained Hoeffding tree, stored as
+ * a flat array of packed nodes for fast batch classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_FLAT_HOEFFDING_TREE_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_FLAT_HOEFFDING_TREE_HPP
+
+#include <mlpack/core.hpp>
+#include <queue>
+
+#include "numeric_split_info.hpp"
+#include "binary_numeric_split_info.hpp"
+
+namespace mlpack {
+
+/**
+ * A FlatHoeffdingTree is an inference-only copy of a HoeffdingTree, taken at
+ * some point of its training (the copy does not change when the tree is
+ * trained further).  The nodes are stored in breadth first order in one array,
+ * and each node is packed into 16 bytes: the split dimension and the type of
+ * the split, the index of the first child (the children of a node are stored
+ * next to each other), and the range of the split points of the node in a
+ * separate array.  The predicted class and the majority probability of the
+ * leaves are stored separately too, so that the nodes visited while traversing
+ * the tree stay small and close in memory, and the type of each split is read
+ * from its node instead of from the DatasetInfo.
+ *
+ * When classifying a set of points, blocks of BlockSize points go down the tree
+ * together, one level at a time, and the blocks are classified in parallel with
+ * OpenMP.  The predictions and probabilities are the same as those of the
+ * original tree.
+ *
+ * @code
+ * HoeffdingTree<> tree(data, info, labels, numClasses);
+ * FlatHoeffdingTree flatTree(tree);
+ * arma::Row<size_t> predictions;
+ * arma::rowvec probabilities;
+ * flatTree.Classify(testData, predictions, probabilities);
+ * @endcode
+ *
+ * The numeric splits must use NumericSplitInfo (as HoeffdingNumericSplit and
+ * HoeffdingDoubleNumericSplit do) or BinaryNumericSplitInfo (as
+ * BinaryNumericSplit does), and the categorical splits must send each point
+ * to the child of its category (as CategoricalSplitInfo does).
+ */
+class FlatHoeffdingTree
+{
+ public:
+  //! The number of points that go down the tree together in batch
+  //! classification.
+  static constexpr size_t BlockSize = 64;
+
+  /**
+   * Create an empty flat tree.  It must be assigned or loaded before it can be
+   * used.
+   */
+  FlatHoeffdingTree() { }
+
+  /**
+   * Compile the given Hoeffding tree into a flat tree.  A
+   * std::invalid_argument is thrown if the tree has a split that cannot be
+   * represented (a numeric split with an unknown type of split information, or
+   * a tree with more than 2^30 dimensions or 2^32 nodes or split points).
+   *
+   * @param tree Hoeffding tree to compile.
+   */
+  template<typename TreeType>
+  explicit FlatHoeffdingTree(const TreeType& tree);
+
+  /**
+   * Classify the given point.  The predicted label is returned.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given point and also return an estimate of the probability
+   * that the prediction is correct (the majority probability of its leaf).
+   *
+   * @param point Point to classify.
+   * @param prediction Predicted label of the point.
+   * @param probability An estimate of the probability that the prediction is
+   *      correct.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                double& probability) const;
+
+  /**
+   * Classify the given points.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points and also return an estimate of the probability
+   * that the prediction is correct for each point.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   * @param probabilities This will be filled with probability estimates for
+   *      each predicted label.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::rowvec& probabilities) const;
+
+  /**
+   * Find the leaf that each of the points data.cols(begin, end - 1) falls in;
+   * the index of the leaf of point i is stored in leaves[i - begin].  The
+   * points go down the tree together, one level at a time.
+   *
+   * @param data Set of points.
+   * @param begin Index of the first point.
+   * @param end One past the index of the last point.
+   * @param leaves Will hold the index of the leaf of each point; it must have
+   *      at least end - begin elements.
+   */
+  template<typename MatType>
+  void Leaves(const MatType& data,
+              const size_t begin,
+              const size_t end,
+              arma::Row<size_t>& leaves) const;
+
+  //! Get the predicted class of the given leaf.
+  size_t LeafClass(const size_t leaf) const { return leafClasses[leaf]; }
+  //! Get the majority probability of the given leaf.
+  double LeafProbability(const size_t leaf) const
+  {
+    return leafProbabilities[leaf];
+  }
+
+  //! Get the number of nodes in the tree.
+  size_t NumNodes() const { return nodes.size(); }
+  //! Get the number of leaves in the tree.
+  size_t NumLeaves() const { return leafClasses.n_elem; }
+  //! Get the number of split points of all the numeric splits.
+  size_t NumSplitPoints() const { return splitPoints.size(); }
+
+  //! Serialize the tree.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! The dimension of a leaf node.
+  static constexpr uint32_t LeafDimension = 0xFFFFFFFF;
+  //! The bit of the dimension that marks a categorical split.
+  static constexpr uint32_t CategoricalBit = 0x80000000;
+  //! The bit of the dimension that marks a binary numeric split.
+  static constexpr uint32_t BinaryBit = 0x40000000;
+  //! The bits of the dimension that hold the split dimension.
+  static constexpr uint32_t DimensionMask = 0x3FFFFFFF;
+
+  // A node of the tree, packed into 16 bytes.
+  struct Node
+  {
+    //! The split dimension, with CategoricalBit set for categorical splits and
+    //! BinaryBit set for binary numeric splits, or LeafDimension for leaves.
+    uint32_t dimension;
+    //! The index of the first child, or of the leaf for leaves.
+    uint32_t child;
+    //! The index of the first split point of the node (for numeric splits).
+    uint32_t splitBegin;
+    //! One past the index of the last split point of the node.
+    uint32_t splitEnd;
+
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      ar(CEREAL_NVP(dimension));
+      ar(CEREAL_NVP(child));
+      ar(CEREAL_NVP(splitBegin));
+      ar(CEREAL_NVP(splitEnd));
+    }
+  };
+
+  static_assert(sizeof(Node) == 16, "FlatHoeffdingTree::Node must be 16 "
+      "bytes.");
+
+  //! Return the index of the child of the given (non-leaf) node that the given
+  //! value goes to.
+  template<typename ElemType>
+  size_t Next(const Node& node, const ElemType value) const
+  {
+    if (node.dimension & CategoricalBit)
+      return node.child + (size_t) value;
+    if (node.dimension & BinaryBit)
+      return node.child + ((value < splitPoints[node.splitBegin]) ? 0 : 1);
+
+    // A value goes to the first bin whose split point is at least the value.
+    size_t j = node.splitBegin;
+    while (j < node.splitEnd && value > splitPoints[j])
+      ++j;
+
+    return node.child + (j - node.splitBegin);
+  }
+
+  //! Append the split points of a multiway numeric split; false is returned,
+  //! since the split is not binary.
+  template<typename ObservationType>
+  static bool AddSplitPoints(const NumericSplitInfo<ObservationType>& info,
+                             std::vector<double>& points)
+  {
+    for (size_t i = 0; i < info.SplitPoints().n_elem; ++i)
+      points.push_back((double) info.SplitPoints()[i]);
+    return false;
+  }
+
+  //! Append the split point of a binary numeric split; true is returned.
+  template<typename ObservationType>
+  static bool AddSplitPoints(
+      const BinaryNumericSplitInfo<ObservationType>& info,
+      std::vector<double>& points)
+  {
+    points.push_back((double) info.SplitPoint());
+    return true;
+  }
+
+  //! Numeric split information of other types cannot be represented.
+  template<typename SplitInfoType>
+  static bool AddSplitPoints(const SplitInfoType& /* info */,
+                             std::vector<double>& /* points */)
+  {
+    throw std::invalid_argument("FlatHoeffdingTree::FlatHoeffdingTree(): "
+        "unknown type of numeric split information!");
+  }
+
+  //! Return the index of the leaf the given point falls in.
+  template<typename VecType>
+  size_t Leaf(const VecType& point) const;
+
+  //! Throw a std::invalid_argument if the tree is empty.
+  void CheckTrained() const;
+
+  //! The nodes, in breadth first order; the root is the first node.
+  std::vector<Node> nodes;
+  //! The split points of the numeric splits, node after node.
+  std::vector<double> splitPoints;
+  //! The predicted class of each leaf.
+  arma::Row<size_t> leafClasses;
+  //! The majority probability of each leaf.
+  arma::rowvec leafProbabilities;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_hoeffding_tree_impl.hpp"
+
+#endif
@@ -20,7 +20,8 @@ namespace mlpack {
 class GiniImpurity
 {
  public:
-  static double Evaluate(const arma::Mat<size_t>& counts)
+  template<typename eT>
+  static double Evaluate(const arma::Mat<eT>& counts)
   {
     // We need to sum over the difference between the un-split node and the
     // split nodes.  First we'll calculate the number of elements in each split
@@ -37,7 +38,7 @@ class GiniImpurity
     if (numElem == 0)
       return 0.0;
 
-    arma::Col<size_t> classCounts = sum(counts, 1);
+    arma::Col<eT> classCounts = sum(counts, 1);
 
     // Calculate the Gini impurity of the un-split node.
     double impurity = 0.0;
@@ -22,9 +22,11 @@
 #include "information_gain.hpp"
 
 #include "hoeffding_numeric_split.hpp"
+#include "compact_hoeffding_numeric_split.hpp"
 #include "binary_numeric_split.hpp"
 
 #include "hoeffding_categorical_split.hpp"
+#include "compact_hoeffding_categorical_split.hpp"
 
 namespace mlpack {
 
@@ -406,6 +408,39 @@ class HoeffdingTree
   template<typename VecType>
   void Train(const VecType& point, const size_t label);
 
+  /**
+   * Train on a mini-batch of points in streaming mode, with the given labels.
+   * The tree will not be reset before training.  The points are first routed
+   * to the leaves they fall in, in parallel; then the split statistics of each
+   * leaf are updated with all of its points (each dimension of each leaf in
+   * parallel, with the points in order), and each leaf that has seen another
+   * multiple of CheckInterval() points checks the Hoeffding bound once.  So,
+   * unlike training on each point with Train(), no leaf is split in the middle
+   * of a mini-batch.
+   *
+   * @param data Mini-batch of points to train on.
+   * @param labels Labels of the points.
+   */
+  template<typename MatType>
+  void TrainMiniBatch(const MatType& data, const arma::Row<size_t>& labels);
+
+  /**
+   * Train in streaming mode on all the points read by the given loader (such
+   * as a data::ChunkedReader), one mini-batch per chunk (see
+   * TrainMiniBatch()).  The loader is reset first.  The tree is not reset, so
+   * it must have been created with the DatasetInfo of the points read by the
+   * loader (such as the Info() of a data::ChunkedReader); labels holds the
+   * label of each point, in the order they are read.  Only one chunk of points
+   * is held in memory at a time.
+   *
+   * @param loader Loader of the points, with Reset(), Next() and
+   *     Dimensionality() methods.
+   * @param labels Labels of the points.
+   * @return The number of points that were read.
+   */
+  template<typename LoaderType>
+  size_t TrainChunks(LoaderType& loader, const arma::Row<size_t>& labels);
+
   /**
    * Check if a split would satisfy the conditions of the Hoeffding bound with
    * the node's specified success probability.  If so, the number of children
@@ -415,6 +450,16 @@ class HoeffdingTree
 
   //! Get the splitting dimension (size_t(-1) if no split).
   size_t SplitDimension() const { return splitDimension; }
+  //! Get the type of the splitting dimension (only valid if there is a split).
+  data::Datatype SplitDimensionType() const
+  {
+    return datasetInfo->Type(splitDimension);
+  }
+  //! Get the information of the split, if the split is numeric.
+  const typename NumericSplit::SplitInfo& NumericInfo() const
+  {
+    return numericSplit;
+  }
 
   //! Get the majority class.
   size_t MajorityClass() const { return majorityClass; }
@@ -500,7 +545,9 @@ class HoeffdingTree
 
   /**
    * Classify the given points, using this node and the entire (sub)tree beneath
-   * it.  The predicted labels for each point are returned.
+   * it.  The predicted labels for each point are returned.  Blocks of points
+   * are classified in parallel with OpenMP; for a faster batch classification
+   * of a tree that will not be trained any more, see FlatHoeffdingTree.
    *
    * @param data Points to classify.
    * @param predictions Predicted labels for each point.
@@ -513,7 +560,7 @@ class HoeffdingTree
    * it.  The predicted labels for each point are returned, as well as an
    * estimate of the probability that the prediction is correct for each point.
    * This estimate is simply the MajorityProbability() for the leaf that each
-   * point bins to.
+   * point bins to.  Blocks of points are classified in parallel with OpenMP.
    *
    * @param data Points to classify.
    * @param predictions Predicted labels for each point.
@@ -605,6 +652,14 @@ class HoeffdingTree
                      const arma::Row<size_t>& labels,
                      const bool batchTraining);
 
+  /**
+   * Once the split statistics of this leaf have been updated with new points
+   * (and numSamples has been increased from oldNumSamples), update the
+   * majority class, and check for a split if the leaf has seen another
+   * multiple of checkInterval points.
+   */
+  void UpdateLeaf(const size_t oldNumSamples);
+
   /**
    * Reset the tree.  This assumes datasetInfo is set correctly.
    */
@@ -705,36 +705,169 @@ void HoeffdingTree<
         numericSplits[numericIndex++].Train(point[i], label);
     }
 
-    // Grab majority class from splits.
-    if (categoricalSplits.size() > 0)
+    UpdateLeaf(numSamples - 1);
+  }
+  else
+  {
+    // Already split.  Pass the training point to the relevant child.
+    size_t direction = CalculateDirection(point);
+    children[direction]->Train(point, label);
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainMiniBatch(const MatType& data, const arma::Row<size_t>& labels)
+{
+  util::CheckSameSizes(data, labels, "HoeffdingTree::TrainMiniBatch()");
+
+  // Find the leaf that each point falls in.  The tree is not modified here.
+  std::vector<HoeffdingTree*> pointLeaves(data.n_cols);
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+  {
+    HoeffdingTree* node = this;
+    while (node->splitDimension != size_t(-1))
+      node = node->children[node->CalculateDirection(data.col(i))];
+    pointLeaves[i] = node;
+  }
+
+  // Collect the points of each leaf, in order.
+  std::vector<HoeffdingTree*> leaves;
+  std::vector<std::vector<size_t>> leafPoints;
+  std::unordered_map<HoeffdingTree*, size_t> leafIndices;
+  for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+  {
+    auto it = leafIndices.find(pointLeaves[i]);
+    if (it == leafIndices.end())
     {
-      majorityClass = categoricalSplits[0].MajorityClass();
-      majorityProbability = categoricalSplits[0].MajorityProbability();
+      it = leafIndices.insert(std::make_pair(pointLeaves[i],
+          leaves.size())).first;
+      leaves.push_back(pointLeaves[i]);
+      leafPoints.push_back(std::vector<size_t>());
     }
-    else
+
+    leafPoints[it->second].push_back(i);
+  }
+
+  // Each split object only holds the statistics of one dimension of one leaf,
+  // so they can all be updated at the same time.  Each one sees the points of
+  // its leaf in the same order as with point-by-point training.
+  const size_t dimensionality = datasetInfo->Dimensionality();
+  const size_t numUpdates = leaves.size() * dimensionality;
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t u = 0; u < numUpdates; ++u)
+  {
+    HoeffdingTree& leaf = *leaves[u / dimensionality];
+    const std::vector<size_t>& points = leafPoints[u / dimensionality];
+    const size_t d = u % dimensionality;
+    const std::pair<size_t, size_t>& mapping = leaf.dimensionMappings->at(d);
+    if (mapping.first == data::Datatype::categorical)
     {
-      majorityClass = numericSplits[0].MajorityClass();
-      majorityProbability = numericSplits[0].MajorityProbability();
+      for (size_t i = 0; i < points.size(); ++i)
+      {
+        leaf.categoricalSplits[mapping.second].Train(data(d, points[i]),
+            labels[points[i]]);
+      }
     }
-
-    // Check for a split, if we should.
-    if (numSamples % checkInterval == 0)
+    else if (mapping.first == data::Datatype::numeric)
     {
-      const size_t numChildren = SplitCheck();
-      if (numChildren > 0)
+      for (size_t i = 0; i < points.size(); ++i)
       {
-        // We need to add a bunch of children.
-        // Delete children, if we have them.
-        children.clear();
-        CreateChildren();
+        leaf.numericSplits[mapping.second].Train(data(d, points[i]),
+            labels[points[i]]);
       }
     }
   }
+
+  // Now check each leaf for a split, once for the whole mini-batch.
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t l = 0; l < leaves.size(); ++l)
+  {
+    const size_t oldNumSamples = leaves[l]->numSamples;
+    leaves[l]->numSamples += leafPoints[l].size();
+    leaves[l]->UpdateLeaf(oldNumSamples);
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename LoaderType>
+size_t HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainChunks(LoaderType& loader, const arma::Row<size_t>& labels)
+{
+  if (loader.Dimensionality() != datasetInfo->Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "HoeffdingTree::TrainChunks(): the points have "
+        << loader.Dimensionality() << " dimensions, but the tree has "
+        << datasetInfo->Dimensionality() << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  loader.Reset();
+  size_t points = 0;
+  arma::mat chunk;
+  while (loader.Next(chunk))
+  {
+    if (points + chunk.n_cols > labels.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "HoeffdingTree::TrainChunks(): the loader has more than "
+          << labels.n_elem << " points, but only " << labels.n_elem
+          << " labels were given!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    TrainMiniBatch(chunk, labels.cols(points, points + chunk.n_cols - 1));
+    points += chunk.n_cols;
+  }
+
+  return points;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::UpdateLeaf(const size_t oldNumSamples)
+{
+  // Grab majority class from splits.
+  if (categoricalSplits.size() > 0)
+  {
+    majorityClass = categoricalSplits[0].MajorityClass();
+    majorityProbability = categoricalSplits[0].MajorityProbability();
+  }
   else
   {
-    // Already split.  Pass the training point to the relevant child.
-    size_t direction = CalculateDirection(point);
-    children[direction]->Train(point, label);
+    majorityClass = numericSplits[0].MajorityClass();
+    majorityProbability = numericSplits[0].MajorityProbability();
+  }
+
+  // Check for a split, if we should.
+  if (numSamples / checkInterval != oldNumSamples / checkInterval)
+  {
+    const size_t numChildren = SplitCheck();
+    if (numChildren > 0)
+    {
+      // We need to add a bunch of children.
+      // Delete children, if we have them.
+      children.clear();
+      CreateChildren();
+    }
   }
 }
 
@@ -1002,8 +1135,17 @@ void HoeffdingTree<
 >::Classify(const MatType& data, arma::Row<size_t>& predictions) const
 {
   predictions.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-    predictions[i] = Classify(data.col(i));
+
+  // Each thread classifies contiguous blocks of points.
+  const size_t blockSize = 64;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t end = std::min((size_t) data.n_cols, (b + 1) * blockSize);
+    for (size_t i = b * blockSize; i < end; ++i)
+      predictions[i] = Classify(data.col(i));
+  }
 }
 
 //! Batch classification with probabilities.
@@ -1023,8 +1165,17 @@ void HoeffdingTree<
 {
   predictions.set_size(data.n_cols);
   probabilities.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-    Classify(data.col(i), predictions[i], probabilities[i]);
+
+  // Each thread classifies contiguous blocks of points.
+  const size_t blockSize = 64;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t end = std::min((size_t) data.n_cols, (b + 1) * blockSize);
+    for (size_t i = b * blockSize; i < end; ++i)
+      Classify(data.col(i), predictions[i], probabilities[i]);
+  }
 }
 
 template<
@@ -54,7 +54,12 @@ BINDING_LONG_DESC(
     "The training may be performed in batch mode "
     "(like a typical decision tree algorithm) by specifying the " +
     PRINT_PARAM_STRING("batch_mode") + " option, but this may not be the best "
-    "option for large datasets."
+    "option for large datasets.  For large streams, the " +
+    PRINT_PARAM_STRING("mini_batch_size") + " option can be used to train on "
+    "mini-batches of points instead of one point at a time: the points of each "
+    "mini-batch are routed to the leaves of the tree and the statistics of the "
+    "leaves are updated in parallel, and each leaf checks for a split once per "
+    "mini-batch."
     "\n\n"
     "When a model is trained, it may be saved via the " +
     PRINT_PARAM_STRING("output_model") + " output parameter.  A model may be "
@@ -125,6 +130,8 @@ PARAM_FLAG("batch_mode", "If true, samples will be considered in batch instead "
 PARAM_FLAG("info_gain", "If set, information gain is used instead of Gini "
     "impurity for calculating Hoeffding bounds.", "i");
 PARAM_INT_IN("passes", "Number of passes to take over the dataset.", "s", 1);
+PARAM_INT_IN("mini_batch_size", "If greater than 1, streaming training is "
+    "done on mini-batches of this many points.", "", 1);
 
 PARAM_INT_IN("bins", "If the 'domingos' split strategy is used, this specifies "
     "the number of bins for each numeric split.", "B", 10);
@@ -151,6 +158,11 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   ReportIgnoredParam(params, {{ "training", false }}, "batch_mode");
   ReportIgnoredParam(params, {{ "training", false }}, "passes");
+  ReportIgnoredParam(params, {{ "training", false }}, "mini_batch_size");
+  ReportIgnoredParam(params, {{ "batch_mode", true }}, "mini_batch_size");
+
+  RequireParamValue<int>(params, "mini_batch_size", [](int x) { return x > 0; },
+      true, "mini-batch size must be positive");
 
   if (params.Has("test"))
   {
@@ -197,6 +209,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     size_t passes = (size_t) params.Get<int>("passes");
     if (passes > 1)
       batchTraining = false; // We already warned about this earlier.
+    const size_t miniBatchSize = params.Has("batch_mode") ? 1 :
+        (size_t) params.Get<int>("mini_batch_size");
 
     // We need to train the model.  First, load the data.
     datasetInfo = std::move(std::get<0>(params.Get<TupleType>("training")));
@@ -226,7 +240,14 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     timers.Start("tree_training");
 
     // Do we need to initialize a model?
-    if (!params.Has("input_model"))
+    if (!params.Has("input_model") && miniBatchSize > 1)
+    {
+      // Build an empty model; all the passes are done in mini-batches below.
+      model->BuildModel(arma::mat(trainingSet.n_rows, 0), datasetInfo,
+          arma::Row<size_t>(), max(labels) + 1, false, confidence, maxSamples,
+          100, minSamples, bins, observationsBeforeBinning);
+    }
+    else if (!params.Has("input_model"))
     {
       // Build the model.
       model->BuildModel(trainingSet, datasetInfo, labels,
@@ -243,6 +264,11 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       if (params.Has("input_model"))
         model->Train(trainingSet, labels, true);
     }
+    else if (miniBatchSize > 1)
+    {
+      for (size_t p = 0; p < passes; ++p)
+        model->TrainMiniBatches(trainingSet, labels, miniBatchSize);
+    }
     else
     {
       for (size_t p = 0; p < passes; ++p)
@@ -135,6 +135,19 @@ class HoeffdingTreeModel
              const arma::Row<size_t>& labels,
              const bool batchTraining);
 
+  /**
+   * Train in streaming mode on the given dataset, in mini-batches of the given
+   * size (see HoeffdingTree::TrainMiniBatch()).  This takes one pass.  Be sure
+   * that BuildModel() has been called first!
+   *
+   * @param dataset Dataset to train on.
+   * @param labels Labels for training set.
+   * @param miniBatchSize Number of points in each mini-batch.
+   */
+  void TrainMiniBatches(const arma::mat& dataset,
+                        const arma::Row<size_t>& labels,
+                        const size_t miniBatchSize);
+
   /**
    * Using the model, classify the given test points.  Be sure that BuildModel()
    * has been called first!
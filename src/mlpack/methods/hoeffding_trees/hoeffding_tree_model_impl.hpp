@@ -219,6 +219,48 @@ inline void HoeffdingTreeModel::Train(const arma::mat& dataset,
   }
 }
 
+// Train the model on one pass of the dataset, in mini-batches.
+inline void HoeffdingTreeModel::TrainMiniBatches(
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    const size_t miniBatchSize)
+{
+  if (miniBatchSize == 0)
+  {
+    throw std::invalid_argument("HoeffdingTreeModel::TrainMiniBatches(): "
+        "mini-batch size must be positive!");
+  }
+
+  for (size_t begin = 0; begin < dataset.n_cols; begin += miniBatchSize)
+  {
+    const size_t end = std::min(begin + miniBatchSize,
+        (size_t) dataset.n_cols) - 1;
+    const arma::Row<size_t> batchLabels = labels.subvec(begin, end);
+
+    // Depending on the type, train on the mini-batch.
+    switch (type)
+    {
+      case GINI_HOEFFDING:
+        giniHoeffdingTree->TrainMiniBatch(dataset.cols(begin, end),
+            batchLabels);
+        break;
+
+      case GINI_BINARY:
+        giniBinaryTree->TrainMiniBatch(dataset.cols(begin, end), batchLabels);
+        break;
+
+      case INFO_HOEFFDING:
+        infoHoeffdingTree->TrainMiniBatch(dataset.cols(begin, end),
+            batchLabels);
+        break;
+
+      case INFO_BINARY:
+        infoBinaryTree->TrainMiniBatch(dataset.cols(begin, end), batchLabels);
+        break;
+    }
+  }
+}
+
 // Classify the given points.
 inline void HoeffdingTreeModel::Classify(const arma::mat& dataset,
                                          arma::Row<size_t>& predictions)
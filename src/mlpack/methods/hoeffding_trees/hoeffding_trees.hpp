@@ -14,5 +14,6 @@
 #define MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_TREES_HPP
 
 #include "hoeffding_tree.hpp"
+#include "flat_hoeffding_tree.hpp"
 
 #endif
@@ -27,7 +27,8 @@ class HoeffdingInformationGain
    *
    * @param counts Matrix of sufficient statistics.
    */
-  static double Evaluate(const arma::Mat<size_t>& counts)
+  template<typename eT>
+  static double Evaluate(const arma::Mat<eT>& counts)
   {
     // Calculate the number of elements in the unsplit node and also in each
     // proposed child.
@@ -43,7 +44,7 @@ class HoeffdingInformationGain
     if (numElem == 0)
       return 0.0;
 
-    arma::Col<size_t> classCounts = sum(counts, 1);
+    arma::Col<eT> classCounts = sum(counts, 1);
 
     // Calculate the gain of the unsplit node.
     double gain = 0.0;
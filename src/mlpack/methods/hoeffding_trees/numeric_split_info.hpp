@@ -35,6 +35,10 @@ class NumericSplitInfo
     return bin;
   }
 
+  //! Get the split points; a value goes to the first bin whose split point is
+  //! at least the value, or to the last bin.
+  const arma::Col<ObservationType>& SplitPoints() const { return splitPoints; }
+
   //! Serialize the split (save/load the split points).
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -0,0 +1,16 @@
+/**
+ * @file ivf_pq.hpp
+ *
+ * Convenience include for mlpack/methods/ivf_pq/ivf_pq.hpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_IVF_PQ_HPP
+#define MLPACK_IVF_PQ_HPP
+
+#include "ivf_pq/ivf_pq.hpp"
+
+#endif
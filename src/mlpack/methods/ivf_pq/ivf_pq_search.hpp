@@ -0,0 +1,232 @@
+/**
+ * @file methods/ivf_pq/ivf_pq_search.hpp
+ *
+ * Defines the IVFPQSearch class, which performs approximate nearest neighbor
+ * search with an inverted file index of product-quantized points.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @code
+ * @article{jegou2011product,
+ *   title={Product quantization for nearest neighbor search},
+ *   author={J{\'e}gou, Herv{\'e} and Douze, Matthijs and Schmid, Cordelia},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={33},
+ *   number={1},
+ *   pages={117--128},
+ *   year={2011},
+ *   publisher={IEEE}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_HPP
+#define MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+namespace mlpack {
+
+/**
+ * The IVFPQSearch class builds an inverted file index with product quantization
+ * (IVF-PQ) on a reference set, and uses it to compute approximate nearest
+ * neighbors with the Euclidean distance.  The reference set itself is not
+ * kept, so the index uses much less memory than the other search methods.
+ *
+ * The reference set is first clustered with k-means into `numLists` lists (the
+ * coarse quantizer).  The residual of each point (its difference from the
+ * centroid of its list) is split into `numSubspaces` contiguous subvectors,
+ * and each subvector is replaced by the index of its nearest codeword in the
+ * codebook of that subspace.  Since every codebook has at most 256 codewords,
+ * each point is stored as `numSubspaces` bytes plus a 32-bit index.
+ *
+ * To search, the `nProbe` lists whose centroids are closest to the query are
+ * scanned.  For each list, a lookup table of the squared distances between the
+ * query residual and every codeword of every subspace is computed once, and the
+ * approximate squared distance to each point of the list is then the sum of
+ * `numSubspaces` table entries.  Larger values of `nProbe` give better recall
+ * at the cost of slower queries.  When OpenMP is available, queries are
+ * answered in parallel.
+ *
+ * @code
+ * // Compress a 128-dimensional dataset to 16 bytes per point, and find the 10
+ * // approximate nearest neighbors of each query.
+ * IVFPQSearch<> ivfpq(dataset, 1024, 16);
+ * ivfpq.NProbe() = 16;
+ * ivfpq.Search(queries, 10, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MatType Type of matrix that the reference and query sets are given
+ *     as.
+ */
+template<typename MatType = arma::mat>
+class IVFPQSearch
+{
+ public:
+  /**
+   * Build the index on the given reference set.  The reference set is not
+   * stored.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numLists Number of lists of the coarse quantizer.
+   * @param numSubspaces Number of subspaces (and bytes per point); must divide
+   *     the dimensionality of the reference set.
+   * @param codebookSize Number of codewords in each subspace (at most 256).
+   * @param nProbe Number of lists to scan for each query.
+   * @param maxIterations Maximum number of k-means iterations used to train the
+   *     coarse quantizer and the codebooks.
+   */
+  IVFPQSearch(const MatType& referenceSet,
+              const size_t numLists = 256,
+              const size_t numSubspaces = 8,
+              const size_t codebookSize = 256,
+              const size_t nProbe = 8,
+              const size_t maxIterations = 25);
+
+  /**
+   * Create an untrained index.  Be sure to call Train() before calling
+   * Search(); otherwise, an exception will be thrown when Search() is called.
+   *
+   * @param nProbe Number of lists to scan for each query.
+   */
+  IVFPQSearch(const size_t nProbe = 8);
+
+  /**
+   * Build the index on the given reference set, replacing any existing index.
+   * The reference set is not stored.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numLists Number of lists of the coarse quantizer.
+   * @param numSubspaces Number of subspaces (and bytes per point); must divide
+   *     the dimensionality of the reference set.
+   * @param codebookSize Number of codewords in each subspace (at most 256).
+   * @param maxIterations Maximum number of k-means iterations used to train the
+   *     coarse quantizer and the codebooks.
+   */
+  void Train(const MatType& referenceSet,
+             const size_t numLists = 256,
+             const size_t numSubspaces = 8,
+             const size_t codebookSize = 256,
+             const size_t maxIterations = 25);
+
+  /**
+   * Compute the approximate nearest neighbors of the points in the given query
+   * set and store the output in the given matrices, in the same format as
+   * NeighborSearch::Search().  The matrices will be set to the size of n
+   * columns by k rows, where n is the number of points in the query set.  The
+   * distances are approximate Euclidean distances.  If fewer than k points are
+   * found in the scanned lists, the remaining neighbors are set to the number
+   * of reference points and the remaining distances are set to DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Serialize the IVF-PQ index.
+   *
+   * @param ar Archive to serialize to.
+   * @param version serialize class version to provide backward compatibility
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t version);
+
+  //! Get the number of lists to scan for each query.
+  size_t NProbe() const { return nProbe; }
+  //! Modify the number of lists to scan for each query.
+  size_t& NProbe() { return nProbe; }
+
+  //! Get the number of lists of the coarse quantizer.
+  size_t NumLists() const { return coarseCentroids.n_cols; }
+  //! Get the number of subspaces (the number of bytes used for each point).
+  size_t NumSubspaces() const { return codebooks.n_slices; }
+  //! Get the number of codewords in each subspace.
+  size_t CodebookSize() const { return codebooks.n_cols; }
+  //! Get the number of points in the index.
+  size_t NumPoints() const { return codes.n_cols; }
+  //! Get the dimensionality of the points in the index.
+  size_t Dimensionality() const { return coarseCentroids.n_rows; }
+
+  //! Get the centroids of the coarse quantizer (one per column).
+  const arma::mat& CoarseCentroids() const { return coarseCentroids; }
+  //! Get the codebooks; slice m holds the codewords of subspace m.
+  const arma::cube& Codebooks() const { return codebooks; }
+  //! Get the offset of each list in ListIndices() and Codes().  List i holds
+  //! the points in the range [ListOffsets()[i], ListOffsets()[i + 1]).
+  const arma::Col<size_t>& ListOffsets() const { return listOffsets; }
+  //! Get the index of each point in the lists.
+  const arma::Col<arma::u32>& ListIndices() const { return listIndices; }
+  //! Get the code of each point in the lists (one column per point).
+  const arma::Mat<arma::u8>& Codes() const { return codes; }
+
+  //! Get the number of codes scanned by searches.
+  size_t DistanceEvaluations() const { return distanceEvaluations; }
+  //! Modify the number of codes scanned by searches.
+  size_t& DistanceEvaluations() { return distanceEvaluations; }
+
+ private:
+  //! Candidate represents a possible candidate neighbor (distance, index).
+  typedef std::pair<float, size_t> Candidate;
+  //! A max-heap of candidates, with the worst candidate on top.
+  typedef std::priority_queue<Candidate> CandidateList;
+
+  /**
+   * Compute the lookup table of squared distances between the given residual
+   * and every codeword of every subspace.  Entry (j, m) holds the distance for
+   * codeword j of subspace m.
+   *
+   * @param residual Residual of the query with respect to a list centroid.
+   * @param table Matrix to store the lookup table in.
+   */
+  void ComputeTable(const arma::vec& residual, arma::fmat& table) const;
+
+  /**
+   * Scan the codes in the given list with the given lookup table, and add any
+   * point that is closer than the worst candidate to the candidate list.
+   *
+   * @param list Index of the list to scan.
+   * @param table Lookup table for the query and this list.
+   * @param candidates List of the best candidates found so far.
+   */
+  void ScanList(const size_t list,
+                const arma::fmat& table,
+                CandidateList& candidates) const;
+
+  //! Number of lists to scan for each query.
+  size_t nProbe;
+
+  //! The centroids of the coarse quantizer.
+  arma::mat coarseCentroids;
+  //! The codebooks of each subspace (subspace dimension x codebookSize x
+  //! numSubspaces).
+  arma::cube codebooks;
+
+  //! The offset of each list in listIndices and codes; length numLists + 1.
+  arma::Col<size_t> listOffsets;
+  //! The index of each point, ordered by list.
+  arma::Col<arma::u32> listIndices;
+  //! The code of each point, ordered by list.
+  arma::Mat<arma::u8> codes;
+
+  //! The number of codes scanned.
+  size_t distanceEvaluations;
+}; // class IVFPQSearch
+
+} // namespace mlpack
+
+// Include implementation.
+#include "ivf_pq_search_impl.hpp"
+
+#endif
@@ -0,0 +1,341 @@
+/**
+ * @file methods/ivf_pq/ivf_pq_search_impl.hpp
+ *
+ * Implementation of the IVFPQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ivf_pq_search.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+IVFPQSearch<MatType>::IVFPQSearch(const MatType& referenceSet,
+                                  const size_t numLists,
+                                  const size_t numSubspaces,
+                                  const size_t codebookSize,
+                                  const size_t nProbe,
+                                  const size_t maxIterations) :
+    nProbe(nProbe),
+    distanceEvaluations(0)
+{
+  Train(referenceSet, numLists, numSubspaces, codebookSize, maxIterations);
+}
+
+template<typename MatType>
+IVFPQSearch<MatType>::IVFPQSearch(const size_t nProbe) :
+    nProbe(nProbe),
+    distanceEvaluations(0)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+void IVFPQSearch<MatType>::Train(const MatType& referenceSet,
+                                 const size_t numLists,
+                                 const size_t numSubspaces,
+                                 const size_t codebookSize,
+                                 const size_t maxIterations)
+{
+  const size_t numPoints = referenceSet.n_cols;
+  if (numSubspaces == 0 || referenceSet.n_rows % numSubspaces != 0)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Train(): number of subspaces (" << numSubspaces
+        << ") must divide the dimensionality of the reference set ("
+        << referenceSet.n_rows << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (codebookSize == 0 || codebookSize > 256)
+  {
+    throw std::invalid_argument("IVFPQSearch::Train(): codebook size must be "
+        "between 1 and 256");
+  }
+
+  if (numLists == 0 || numLists > numPoints || codebookSize > numPoints)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Train(): number of lists (" << numLists << ") and "
+        << "codebook size (" << codebookSize << ") must be between 1 and the "
+        << "number of points in the reference set (" << numPoints << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Point indices are stored as 32-bit integers.
+  if (numPoints > std::numeric_limits<arma::u32>::max())
+  {
+    throw std::invalid_argument("IVFPQSearch::Train(): reference set must "
+        "have fewer than 2^32 points");
+  }
+
+  // Train the coarse quantizer.
+  arma::mat data = ConvTo<arma::mat>::From(referenceSet);
+  KMeans<> kmeans(maxIterations);
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(data, numLists, assignments, coarseCentroids);
+
+  // Lay out the lists contiguously; points keep their order inside each list.
+  arma::Col<size_t> counts(numLists, arma::fill::zeros);
+  for (size_t i = 0; i < numPoints; ++i)
+    counts[assignments[i]]++;
+
+  listOffsets.set_size(numLists + 1);
+  listOffsets[0] = 0;
+  for (size_t i = 0; i < numLists; ++i)
+    listOffsets[i + 1] = listOffsets[i] + counts[i];
+
+  listIndices.set_size(numPoints);
+  arma::Col<size_t> nextInList = listOffsets.head(numLists);
+  for (size_t i = 0; i < numPoints; ++i)
+    listIndices[nextInList[assignments[i]]++] = (arma::u32) i;
+
+  // Replace each point by its residual, and train the codebook of each
+  // subspace on the residuals.
+  for (size_t i = 0; i < numPoints; ++i)
+    data.col(i) -= coarseCentroids.col(assignments[i]);
+
+  const size_t subspaceDim = data.n_rows / numSubspaces;
+  codebooks.set_size(subspaceDim, codebookSize, numSubspaces);
+  for (size_t m = 0; m < numSubspaces; ++m)
+  {
+    arma::mat subspaceData = data.rows(m * subspaceDim,
+        (m + 1) * subspaceDim - 1);
+    arma::mat centroids;
+    kmeans.Cluster(subspaceData, codebookSize, centroids);
+    codebooks.slice(m) = centroids;
+  }
+
+  // Encode each residual with the nearest codeword of each subspace.
+  codes.set_size(numSubspaces, numPoints);
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t pos = 0; pos < numPoints; ++pos)
+  {
+    const double* residual = data.colptr(listIndices[pos]);
+    for (size_t m = 0; m < numSubspaces; ++m)
+    {
+      const double* subResidual = residual + m * subspaceDim;
+      double bestDistance = DBL_MAX;
+      size_t best = 0;
+      for (size_t j = 0; j < codebookSize; ++j)
+      {
+        const double* codeword = codebooks.slice_colptr(m, j);
+        double distance = 0.0;
+        for (size_t d = 0; d < subspaceDim; ++d)
+        {
+          const double diff = subResidual[d] - codeword[d];
+          distance += diff * diff;
+        }
+
+        if (distance < bestDistance)
+        {
+          bestDistance = distance;
+          best = j;
+        }
+      }
+
+      codes(m, pos) = (arma::u8) best;
+    }
+  }
+
+  distanceEvaluations = 0;
+  Log::Info << "Built IVF-PQ index with " << numLists << " lists and "
+      << numSubspaces << " bytes per point on " << numPoints << " points."
+      << std::endl;
+}
+
+template<typename MatType>
+void IVFPQSearch<MatType>::Search(const MatType& querySet,
+                                  const size_t k,
+                                  arma::Mat<size_t>& neighbors,
+                                  arma::mat& distances)
+{
+  const size_t numPoints = NumPoints();
+  if (k > numPoints)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Search(): requested value of k (" << k << ") is "
+        << "greater than the number of points in the index (" << numPoints
+        << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (querySet.n_rows != Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << Dimensionality() << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // If the user asked for 0 nearest neighbors... we're done.
+  if (k == 0)
+    return;
+
+  const size_t numLists = NumLists();
+  const size_t probes = std::max(std::min(nProbe, numLists), (size_t) 1);
+  size_t evaluations = 0;
+
+  #pragma omp parallel reduction(+:evaluations) num_threads((int) NumThreads())
+  {
+    // Each thread has its own buffers.
+    arma::fmat table(CodebookSize(), NumSubspaces());
+    arma::vec query, residual;
+    std::vector<std::pair<double, size_t>> listDistances(numLists);
+
+    #pragma omp for schedule(dynamic)
+    for (size_t i = 0; i < (size_t) querySet.n_cols; ++i)
+    {
+      query = ConvTo<arma::vec>::From(querySet.col(i));
+
+      // Find the lists whose centroids are closest to the query.
+      for (size_t l = 0; l < numLists; ++l)
+      {
+        listDistances[l] = std::make_pair(arma::accu(arma::square(query -
+            coarseCentroids.col(l))), l);
+      }
+      std::partial_sort(listDistances.begin(), listDistances.begin() + probes,
+          listDistances.end());
+
+      const Candidate def = std::make_pair(std::numeric_limits<float>::max(),
+          numPoints);
+      std::vector<Candidate> vect(k, def);
+      CandidateList candidates(std::less<Candidate>(), std::move(vect));
+
+      for (size_t p = 0; p < probes; ++p)
+      {
+        const size_t list = listDistances[p].second;
+        if (listOffsets[list + 1] == listOffsets[list])
+          continue;
+
+        residual = query - coarseCentroids.col(list);
+        ComputeTable(residual, table);
+        ScanList(list, table, candidates);
+        evaluations += listOffsets[list + 1] - listOffsets[list];
+      }
+
+      for (size_t j = k; j > 0; --j)
+      {
+        const Candidate& c = candidates.top();
+        neighbors(j - 1, i) = c.second;
+        distances(j - 1, i) = (c.second == numPoints) ? DBL_MAX :
+            std::sqrt((double) c.first);
+        candidates.pop();
+      }
+    }
+  }
+
+  distanceEvaluations += evaluations;
+}
+
+template<typename MatType>
+void IVFPQSearch<MatType>::ComputeTable(const arma::vec& residual,
+                                        arma::fmat& table) const
+{
+  const size_t subspaceDim = codebooks.n_rows;
+  for (size_t m = 0; m < codebooks.n_slices; ++m)
+  {
+    const double* subResidual = residual.memptr() + m * subspaceDim;
+    for (size_t j = 0; j < codebooks.n_cols; ++j)
+    {
+      const double* codeword = codebooks.slice_colptr(m, j);
+      double distance = 0.0;
+      for (size_t d = 0; d < subspaceDim; ++d)
+      {
+        const double diff = subResidual[d] - codeword[d];
+        distance += diff * diff;
+      }
+
+      table(j, m) = (float) distance;
+    }
+  }
+}
+
+template<typename MatType>
+void IVFPQSearch<MatType>::ScanList(const size_t list,
+                                    const arma::fmat& table,
+                                    CandidateList& candidates) const
+{
+  const size_t numSubspaces = codes.n_rows;
+  const size_t tableRows = table.n_rows;
+  const float* tableMem = table.memptr();
+  const size_t begin = listOffsets[list];
+  const size_t end = listOffsets[list + 1];
+
+  // Codes of consecutive points are contiguous, so four points are scanned at
+  // once with independent sums; this lets the table lookups of different
+  // points proceed at the same time.
+  size_t i = begin;
+  for (; i + 4 <= end; i += 4)
+  {
+    const arma::u8* code0 = codes.colptr(i);
+    const arma::u8* code1 = code0 + numSubspaces;
+    const arma::u8* code2 = code1 + numSubspaces;
+    const arma::u8* code3 = code2 + numSubspaces;
+
+    float d0 = 0.0f, d1 = 0.0f, d2 = 0.0f, d3 = 0.0f;
+    const float* subTable = tableMem;
+    for (size_t m = 0; m < numSubspaces; ++m, subTable += tableRows)
+    {
+      d0 += subTable[code0[m]];
+      d1 += subTable[code1[m]];
+      d2 += subTable[code2[m]];
+      d3 += subTable[code3[m]];
+    }
+
+    const float d[4] = { d0, d1, d2, d3 };
+    for (size_t j = 0; j < 4; ++j)
+    {
+      if (d[j] < candidates.top().first)
+      {
+        candidates.pop();
+        candidates.push(std::make_pair(d[j], (size_t) listIndices[i + j]));
+      }
+    }
+  }
+
+  // Scan the remaining points one at a time.
+  for (; i < end; ++i)
+  {
+    const arma::u8* code = codes.colptr(i);
+    float distance = 0.0f;
+    const float* subTable = tableMem;
+    for (size_t m = 0; m < numSubspaces; ++m, subTable += tableRows)
+      distance += subTable[code[m]];
+
+    if (distance < candidates.top().first)
+    {
+      candidates.pop();
+      candidates.push(std::make_pair(distance, (size_t) listIndices[i]));
+    }
+  }
+}
+
+template<typename MatType>
+template<typename Archive>
+void IVFPQSearch<MatType>::serialize(Archive& ar,
+                                     const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(nProbe));
+  ar(CEREAL_NVP(coarseCentroids));
+  ar(CEREAL_NVP(codebooks));
+  ar(CEREAL_NVP(listOffsets));
+  ar(CEREAL_NVP(listIndices));
+  ar(CEREAL_NVP(codes));
+  ar(CEREAL_NVP(distanceEvaluations));
+}
+
+} // namespace mlpack
+
+#endif
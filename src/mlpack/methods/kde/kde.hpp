@@ -19,6 +19,10 @@
 
 namespace mlpack {
 
+// Whether a tree supports the insertion of points (see
+// BinarySpaceTree::InsertPoints()).
+HAS_MEM_FUNC(InsertPoints, HasInsertPointsCheck);
+
 //! KDEMode represents the ways in which KDE algorithm can be executed.
 enum KDEMode
 {
@@ -173,6 +177,25 @@ class KDE
    */
   void Train(Tree* referenceTree, std::vector<size_t>* oldFromNewReferences);
 
+  /**
+   * Add the given points to the reference set, without training the model
+   * again.  For trees that support insertion (such as the kd-tree and ball
+   * tree; see BinarySpaceTree::InsertPoints()), the points are inserted into
+   * the reference tree, whose bounds and statistics are updated along the way;
+   * for other trees, the tree is built again.  If the model is not trained, it
+   * is trained on the points.
+   *
+   * If WindowSize() is not 0, only the WindowSize() most recently added points
+   * are kept, and the oldest points (the points of the original reference set
+   * first) are deleted from the tree.  If the reference tree was given to
+   * Train(), it is modified in place with insertion, and otherwise replaced by
+   * a tree owned by the model.
+   *
+   * @param points Points to add to the reference set.
+   * @param leafSize Maximum number of points held in a leaf of the tree.
+   */
+  void AddReferences(const MatType& points, const size_t leafSize = 20);
+
   /**
    * Estimate density of each point in the query set given the data of the
    * reference set. The result is stored in an estimations vector.
@@ -253,6 +276,13 @@ class KDE
   //! Check whether KDE model is trained or not.
   bool IsTrained() const { return trained; }
 
+  //! Get the maximum number of reference points kept by AddReferences() (0
+  //! means no limit).
+  size_t WindowSize() const { return windowSize; }
+  //! Modify the maximum number of reference points kept by AddReferences() (0
+  //! means no limit).  This takes effect on the next call to AddReferences().
+  size_t& WindowSize() { return windowSize; }
+
   //! Get the mode of KDE.
   KDEMode Mode() const { return mode; }
 
@@ -290,6 +320,15 @@ class KDE
   //! Modify Monte Carlo break coefficient. (0 < newCoef <= 1).
   void MCBreakCoef(const double newCoef);
 
+  /**
+   * Get the statistics of the tree traversals of the last evaluation.  These
+   * are only collected when Statistics().Enabled() is true; see
+   * TraversalStatistics.
+   */
+  const TraversalStatistics& Statistics() const { return statistics; }
+  //! Modify the statistics of the tree traversals.
+  TraversalStatistics& Statistics() { return statistics; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t version);
@@ -341,17 +380,84 @@ class KDE
   //! is the limit before Monte Carlo estimation recurses.
   double mcBreakCoef;
 
+  //! The statistics of the tree traversals of the last evaluation.
+  TraversalStatistics statistics;
+
+  //! Maximum number of reference points kept by AddReferences(), or 0.
+  size_t windowSize;
+
   //! Check whether absolute and relative error values are compatible.
   static void CheckErrorValues(const double relError, const double absError);
 
   //! Rearrange estimations vector if required.
   static void RearrangeEstimations(const std::vector<size_t>& oldFromNew,
                                    arma::vec& estimations);
+
+  /**
+   * Add the kernel values of the points in the given query tree to the given
+   * (already allocated and zeroed) estimations with a dual-tree traversal.  For
+   * binary trees that rearrange the dataset, disjoint query subtrees are
+   * evaluated in parallel when Monte Carlo estimations are not used.
+   */
+  template<typename T = Tree>
+  void DualTreeEvaluate(Tree& queryTree,
+                        arma::vec& estimations,
+                        const bool sameSet,
+                        const std::enable_if_t<TreeTraits<T>::BinaryTree &&
+                            TreeTraits<T>::RearrangesDataset>* = 0);
+
+  //! Perform the dual-tree evaluation with the given query tree, serially.
+  template<typename T = Tree>
+  void DualTreeEvaluate(Tree& queryTree,
+                        arma::vec& estimations,
+                        const bool sameSet,
+                        const std::enable_if_t<!(TreeTraits<T>::BinaryTree &&
+                            TreeTraits<T>::RearrangesDataset)>* = 0);
+
+  /**
+   * Insert the given points into the reference tree and delete the numExpired
+   * oldest points from it, for trees that support insertion.
+   */
+  template<typename T = Tree>
+  void UpdateReferences(const MatType& points,
+                        const size_t numExpired,
+                        const size_t leafSize,
+                        const std::enable_if_t<HasInsertPointsCheck<T,
+                            void(T::*)(const MatType&, std::vector<size_t>&,
+                            const size_t)>::value>* = 0);
+
+  //! Build the reference tree again without the numExpired oldest points and
+  //! with the given points, for trees that do not support insertion.
+  template<typename T = Tree>
+  void UpdateReferences(const MatType& points,
+                        const size_t numExpired,
+                        const size_t leafSize,
+                        const std::enable_if_t<!HasInsertPointsCheck<T,
+                            void(T::*)(const MatType&, std::vector<size_t>&,
+                            const size_t)>::value>* = 0);
 };
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename KernelType, typename MetricType,
+    typename MatType, template<typename, typename, typename> class TreeType,
+    template<typename> class DualTreeTraversalType,
+    template<typename> class SingleTreeTraversalType),
+    (mlpack::KDE<KernelType, MetricType, MatType, TreeType,
+    DualTreeTraversalType, SingleTreeTraversalType>), (1));
+
 // Include implementation.
 #include "kde_impl.hpp"
 
+// If MLPACK_USE_PREBUILT is defined, the common instantiations below are
+// compiled into libmlpack (see BUILD_PREBUILT_LIBRARY), and are not
+// instantiated again here.
+#ifdef MLPACK_USE_PREBUILT
+namespace mlpack {
+
+extern template class KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree>;
+
+} // namespace mlpack
+#endif
+
 #endif // MLPACK_METHODS_KDE_KDE_HPP
@@ -49,7 +49,8 @@ KDE(const double relError,
     trained(false),
     mode(mode),
     monteCarlo(monteCarlo),
-    initialSampleSize(initialSampleSize)
+    initialSampleSize(initialSampleSize),
+    windowSize(0)
 {
   CheckErrorValues(relError, absError);
   MCProb(mcProb);
@@ -83,7 +84,9 @@ KDE(const KDE& other) :
     mcProb(other.mcProb),
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
-    mcBreakCoef(other.mcBreakCoef)
+    mcBreakCoef(other.mcBreakCoef),
+    statistics(other.statistics),
+    windowSize(other.windowSize)
 {
   if (trained)
   {
@@ -129,7 +132,9 @@ KDE(KDE&& other) :
     mcProb(other.mcProb),
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
-    mcBreakCoef(other.mcBreakCoef)
+    mcBreakCoef(other.mcBreakCoef),
+    statistics(other.statistics),
+    windowSize(other.windowSize)
 {
   other.kernel = std::move(KernelType());
   other.metric = std::move(MetricType());
@@ -145,6 +150,7 @@ KDE(KDE&& other) :
   other.initialSampleSize = KDEDefaultParams::initialSampleSize;
   other.mcEntryCoef = KDEDefaultParams::mcEntryCoef;
   other.mcBreakCoef = KDEDefaultParams::mcBreakCoef;
+  other.windowSize = 0;
 }
 
 template<typename KernelType,
@@ -189,6 +195,8 @@ operator=(const KDE& other)
     initialSampleSize = other.initialSampleSize;
     mcEntryCoef = other.mcEntryCoef;
     mcBreakCoef = other.mcBreakCoef;
+    statistics = other.statistics;
+    windowSize = other.windowSize;
     if (trained)
     {
       if (ownsReferenceTree)
@@ -253,6 +261,8 @@ operator=(KDE&& other)
     this->initialSampleSize = other.initialSampleSize;
     this->mcEntryCoef = other.mcEntryCoef;
     this->mcBreakCoef = other.mcBreakCoef;
+    this->statistics = other.statistics;
+    this->windowSize = other.windowSize;
   }
   return *this;
 }
@@ -351,6 +361,152 @@ Train(Tree* referenceTree, std::vector<size_t>* oldFromNewReferences)
   this->trained = true;
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+AddReferences(const MatType& points, const size_t leafSize)
+{
+  if (points.n_cols == 0)
+    return;
+
+  // If the model is not trained yet, the points are the whole reference set.
+  if (!trained)
+  {
+    if (windowSize > 0 && points.n_cols > windowSize)
+      Train(points.tail_cols(windowSize));
+    else
+      Train(points);
+    return;
+  }
+
+  if (points.n_rows != referenceTree->Dataset().n_rows)
+  {
+    std::ostringstream oss;
+    oss << "KDE::AddReferences(): dimensionality of points (" << points.n_rows
+        << ") does not match dimensionality of the reference set ("
+        << referenceTree->Dataset().n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // With a sliding window, the oldest points beyond the window expire.
+  const size_t numPoints = referenceTree->Dataset().n_cols;
+  const size_t numExpired = (windowSize > 0 &&
+      numPoints + points.n_cols > windowSize) ?
+      numPoints + points.n_cols - windowSize : 0;
+  if (numExpired >= numPoints)
+  {
+    Train(points.tail_cols(windowSize));
+    return;
+  }
+
+  UpdateReferences(points, numExpired, leafSize);
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename T>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+UpdateReferences(
+    const MatType& points,
+    const size_t numExpired,
+    const size_t leafSize,
+    const std::enable_if_t<HasInsertPointsCheck<T, void(T::*)(const MatType&,
+        std::vector<size_t>&, const size_t)>::value>*)
+{
+  // A tree that does not rearrange the dataset may have been given without a
+  // mapping; then the positions of the points are their original indices.
+  std::vector<size_t>& oldFromNew = *oldFromNewReferences;
+  if (oldFromNew.empty())
+  {
+    oldFromNew.resize(referenceTree->Dataset().n_cols);
+    for (size_t i = 0; i < oldFromNew.size(); ++i)
+      oldFromNew[i] = i;
+  }
+
+  // The new points get the original indices after the existing ones, and
+  // deleting points renumbers the others in order, so the original indices are
+  // always in order of insertion and the oldest points are 0, ..., numExpired
+  // - 1.
+  referenceTree->InsertPoints(points, oldFromNew, leafSize);
+  if (numExpired > 0)
+  {
+    std::vector<size_t> positions;
+    positions.reserve(numExpired);
+    for (size_t i = 0; i < oldFromNew.size(); ++i)
+      if (oldFromNew[i] < numExpired)
+        positions.push_back(i);
+
+    referenceTree->DeletePoints(positions, oldFromNew, leafSize);
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename T>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+UpdateReferences(
+    const MatType& points,
+    const size_t numExpired,
+    const size_t /* leafSize */,
+    const std::enable_if_t<!HasInsertPointsCheck<T, void(T::*)(const MatType&,
+        std::vector<size_t>&, const size_t)>::value>*)
+{
+  // Gather the points that are kept in their original order, followed by the
+  // new points, and build a new tree on them.
+  const MatType& dataset = referenceTree->Dataset();
+  const size_t numKept = dataset.n_cols - numExpired;
+  MatType referenceSet(dataset.n_rows, numKept + points.n_cols);
+  if (TreeTraits<Tree>::RearrangesDataset && !oldFromNewReferences->empty())
+  {
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      const size_t index = (*oldFromNewReferences)[i];
+      if (index >= numExpired)
+        referenceSet.col(index - numExpired) = dataset.col(i);
+    }
+  }
+  else
+  {
+    referenceSet.head_cols(numKept) = dataset.tail_cols(numKept);
+  }
+  referenceSet.tail_cols(points.n_cols) = points;
+
+  Train(std::move(referenceSet));
+}
+
 template<typename KernelType,
          typename MetricType,
          typename MatType,
@@ -413,8 +569,12 @@ Evaluate(MatType querySet, arma::vec& estimations)
     }
 
     // Evaluate.
-    typedef KDERules<MetricType, KernelType, Tree> RuleType;
-    RuleType rules = RuleType(referenceTree->Dataset(),
+    statistics.Reset();
+
+    typedef InstrumentedRules<KDERules<MetricType, KernelType, Tree>>
+        RuleType;
+    RuleType rules = RuleType(statistics.Enabled() ? &statistics : NULL,
+                              referenceTree->Dataset(),
                               querySet,
                               estimations,
                               relError,
@@ -506,31 +666,11 @@ Evaluate(Tree* queryTree,
   }
 
   // Evaluate.
-  typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            queryTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            mcProb,
-                            initialSampleSize,
-                            mcEntryCoef,
-                            mcBreakCoef,
-                            metric,
-                            kernel,
-                            monteCarlo,
-                            false);
-
-  // Create traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeEvaluate(*queryTree, estimations, false);
   estimations /= referenceTree->Dataset().n_cols;
 
   // Rearrange if necessary.
   RearrangeEstimations(oldFromNewQueries, estimations);
-
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
 }
 
 template<typename KernelType,
@@ -570,40 +710,44 @@ Evaluate(arma::vec& estimations)
   }
 
   // Evaluate.
-  typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            referenceTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            mcProb,
-                            initialSampleSize,
-                            mcEntryCoef,
-                            mcBreakCoef,
-                            metric,
-                            kernel,
-                            monteCarlo,
-                            true);
-
   if (mode == KDE_DUAL_TREE_MODE)
   {
-    // Create traverser.
-    DualTreeTraversalType<RuleType> traverser(rules);
-    traverser.Traverse(*referenceTree, *referenceTree);
+    DualTreeEvaluate(*referenceTree, estimations, true);
   }
   else if (mode == KDE_SINGLE_TREE_MODE)
   {
+    statistics.Reset();
+
+    typedef InstrumentedRules<KDERules<MetricType, KernelType, Tree>>
+        RuleType;
+    RuleType rules = RuleType(statistics.Enabled() ? &statistics : NULL,
+                              referenceTree->Dataset(),
+                              referenceTree->Dataset(),
+                              estimations,
+                              relError,
+                              absError,
+                              mcProb,
+                              initialSampleSize,
+                              mcEntryCoef,
+                              mcBreakCoef,
+                              metric,
+                              kernel,
+                              monteCarlo,
+                              true);
+
     SingleTreeTraversalType<RuleType> traverser(rules);
     for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
       traverser.Traverse(i, *referenceTree);
+
+    Log::Info << rules.Scores() << " node combinations were scored."
+              << std::endl;
+    Log::Info << rules.BaseCases() << " base cases were calculated."
+              << std::endl;
   }
 
   estimations /= referenceTree->Dataset().n_cols;
   // Rearrange if necessary.
   RearrangeEstimations(*oldFromNewReferences, estimations);
-
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
 }
 
 template<typename KernelType,
@@ -734,7 +878,7 @@ void KDE<KernelType,
          TreeType,
          DualTreeTraversalType,
          SingleTreeTraversalType>::
-serialize(Archive& ar, const uint32_t /* version */)
+serialize(Archive& ar, const uint32_t version)
 {
   // Serialize preferences.
   ar(CEREAL_NVP(relError));
@@ -747,6 +891,12 @@ serialize(Archive& ar, const uint32_t /* version */)
   ar(CEREAL_NVP(mcEntryCoef));
   ar(CEREAL_NVP(mcBreakCoef));
 
+  // Older models have no sliding window.
+  if (cereal::is_loading<Archive>() && version == 0)
+    windowSize = 0;
+  else
+    ar(CEREAL_NVP(windowSize));
+
   // If we are loading, clean up memory if necessary.
   if (cereal::is_loading<Archive>())
   {
@@ -824,4 +974,118 @@ RearrangeEstimations(const std::vector<size_t>& oldFromNew,
   }
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename T>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+DualTreeEvaluate(Tree& queryTree,
+                 arma::vec& estimations,
+                 const bool sameSet,
+                 const std::enable_if_t<TreeTraits<T>::BinaryTree &&
+                                        TreeTraits<T>::RearrangesDataset>*)
+{
+  statistics.Reset();
+
+  typedef InstrumentedRules<KDERules<MetricType, KernelType, Tree>>
+      RuleType;
+
+  // Monte Carlo estimations use the alpha of each reference node; computing
+  // them all first means that the traversals only read the statistics of
+  // reference nodes, so the reference tree can be shared between threads.
+  // Each query node has its own error budget, and the traversal of a query
+  // subtree only uses the budgets of its own nodes.
+  if (monteCarlo && std::is_same<KernelType, GaussianKernel>::value)
+  {
+    KDERules<MetricType, KernelType, Tree>::CalculateAlphas(*referenceTree,
+        mcProb);
+  }
+
+  const size_t numSubtrees = NumParallelTasks(queryTree.Count());
+  size_t scores = 0;
+  size_t baseCases = 0;
+
+  // Disjoint query subtrees, each of which holds a contiguous range of query
+  // points, are evaluated in parallel.
+  ParallelDualTreeTraversal(queryTree, numSubtrees, [&](Tree& queryNode)
+      {
+        TraversalStatistics taskStatistics;
+        RuleType rules(statistics.Enabled() ? &taskStatistics : NULL,
+            referenceTree->Dataset(), queryTree.Dataset(), queryNode.Begin(),
+            queryNode.Count(), estimations, relError, absError, mcProb,
+            initialSampleSize, mcEntryCoef, mcBreakCoef, metric, kernel,
+            monteCarlo, sameSet);
+        DualTreeTraversalType<RuleType> traverser(rules);
+        traverser.Traverse(queryNode, *referenceTree);
+
+        #pragma omp critical
+        {
+          scores += rules.Scores();
+          baseCases += rules.BaseCases();
+          statistics.Merge(taskStatistics);
+        }
+      });
+
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename T>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+DualTreeEvaluate(Tree& queryTree,
+                 arma::vec& estimations,
+                 const bool sameSet,
+                 const std::enable_if_t<!(TreeTraits<T>::BinaryTree &&
+                                          TreeTraits<T>::RearrangesDataset)>*)
+{
+  statistics.Reset();
+
+  typedef InstrumentedRules<KDERules<MetricType, KernelType, Tree>>
+      RuleType;
+  RuleType rules = RuleType(statistics.Enabled() ? &statistics : NULL,
+                            referenceTree->Dataset(),
+                            queryTree.Dataset(),
+                            estimations,
+                            relError,
+                            absError,
+                            mcProb,
+                            initialSampleSize,
+                            mcEntryCoef,
+                            mcBreakCoef,
+                            metric,
+                            kernel,
+                            monteCarlo,
+                            sameSet);
+
+  // Create traverser.
+  DualTreeTraversalType<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+
+  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
+  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+}
+
 } // namespace mlpack
@@ -165,6 +165,11 @@ PARAM_DOUBLE_IN("abs_error",
 PARAM_FLAG("monte_carlo",
            "Whether to use Monte Carlo estimations when possible.",
            "S");
+PARAM_FLAG("single_precision",
+           "Hold the reference set and the tree in single precision, which "
+           "halves their memory usage; distances are then only accurate to "
+           "about seven significant digits.",
+           "");
 PARAM_DOUBLE_IN("mc_probability",
                 "Probability of the estimation being bounded by relative error "
                 "when using Monte Carlo estimations.",
@@ -189,6 +194,10 @@ PARAM_DOUBLE_IN("mc_break_coef",
 // Output predictions options.
 PARAM_COL_OUT("predictions", "Vector to store density predictions.",
     "p");
+PARAM_STRING_OUT("traversal_report_file", "If specified, statistics of the "
+    "tree traversals of the evaluation (node combinations scored, pruned, and "
+    "recursed into at each level of the reference tree, base cases, and time "
+    "spent scoring and in base cases) are saved to this file as JSON.", "");
 
 // Maybe, in the future, it could be interesting to implement different metrics.
 
@@ -214,6 +223,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   RequireOnlyOnePassed(params, { "reference", "input_model" }, true);
   ReportIgnoredParam(params, {{ "input_model", true }}, "tree");
   ReportIgnoredParam(params, {{ "input_model", true }}, "kernel");
+  ReportIgnoredParam(params, {{ "input_model", true }}, "single_precision");
 
   // Monte Carlo parameters only make sense if it is activated.
   ReportIgnoredParam(params, {{ "monte_carlo", false }}, "mc_probability");
@@ -260,6 +270,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     arma::mat reference = std::move(params.Get<arma::mat>("reference"));
 
     kde = new KDEModel();
+    kde->SinglePrecision() = params.Has("single_precision");
 
     // Set KernelType.
     if (kernelStr == "gaussian")
@@ -311,6 +322,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   kde->MCBreakCoefficient(mcBreakCoef);
 
   // Evaluation.
+  kde->Statistics().Enabled() = params.Has("traversal_report_file");
   if (params.Has("query"))
   {
     arma::mat query = std::move(params.Get<arma::mat>("query"));
@@ -321,6 +333,21 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     kde->Evaluate(timers, estimations);
   }
 
+  if (params.Has("traversal_report_file"))
+  {
+    const string reportFile = params.Get<string>("traversal_report_file");
+    fstream reportStr(reportFile.c_str(), fstream::out);
+    if (!reportStr.is_open())
+    {
+      Log::Warn << "Cannot open file '" << reportFile << "' to save the "
+          << "traversal report to!" << endl;
+    }
+    else
+    {
+      reportStr << kde->Statistics().ToJSON() << endl;
+    }
+  }
+
   // Output predictions if needed.
   if (params.Has("predictions"))
     params.Get<arma::vec>("predictions") = std::move(estimations);
@@ -114,9 +114,22 @@ class KDEWrapperBase
   //! Modify the search mode.
   virtual KDEMode& Mode() = 0;
 
+  //! Get the statistics of the tree traversals of the last evaluation.
+  virtual const TraversalStatistics& Statistics() const = 0;
+  //! Modify the statistics of the tree traversals.
+  virtual TraversalStatistics& Statistics() = 0;
+
   //! Train the model (build the tree).
   virtual void Train(util::Timers& timers, arma::mat&& referenceSet) = 0;
 
+  //! Add points to the reference set of the model.
+  virtual void AddReferences(util::Timers& timers, arma::mat&& points) = 0;
+
+  //! Get the maximum number of reference points kept by AddReferences().
+  virtual size_t WindowSize() const = 0;
+  //! Modify the maximum number of reference points kept by AddReferences().
+  virtual size_t& WindowSize() = 0;
+
   //! Perform bichromatic KDE (i.e. KDE with a separate query set).
   virtual void Evaluate(util::Timers& timers,
                         arma::mat&& querySet,
@@ -129,12 +142,15 @@ class KDEWrapperBase
 /**
  * KDEWrapper is a wrapper class for all KDE types supported by KDEModel.  It
  * can be extended with new child classes if new functionality for certain types
- * is needed.
+ * is needed.  The datasets given to Train() and Evaluate() are converted to
+ * MatType, so that the KDE object (and its trees) can hold them in single
+ * precision.
  */
 template<typename KernelType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
+                  typename TreeMatType> class TreeType,
+         typename MatType = arma::mat>
 class KDEWrapper : public KDEWrapperBase
 {
  public:
@@ -193,9 +209,23 @@ class KDEWrapper : public KDEWrapperBase
   //! Modify the search mode.
   virtual KDEMode& Mode() { return kde.Mode(); }
 
+  //! Get the statistics of the tree traversals of the last evaluation.
+  virtual const TraversalStatistics& Statistics() const
+  { return kde.Statistics(); }
+  //! Modify the statistics of the tree traversals.
+  virtual TraversalStatistics& Statistics() { return kde.Statistics(); }
+
   //! Train the model (build the tree).
   virtual void Train(util::Timers& timers, arma::mat&& referenceSet);
 
+  //! Add points to the reference set of the model.
+  virtual void AddReferences(util::Timers& timers, arma::mat&& points);
+
+  //! Get the maximum number of reference points kept by AddReferences().
+  virtual size_t WindowSize() const { return kde.WindowSize(); }
+  //! Modify the maximum number of reference points kept by AddReferences().
+  virtual size_t& WindowSize() { return kde.WindowSize(); }
+
   //! Perform bichromatic KDE (i.e. KDE with a separate query set).
   virtual void Evaluate(util::Timers& timers,
                         arma::mat&& querySet,
@@ -212,7 +242,7 @@ class KDEWrapper : public KDEWrapperBase
   }
 
  protected:
-  typedef KDE<KernelType, EuclideanDistance, arma::mat, TreeType> KDEType;
+  typedef KDE<KernelType, EuclideanDistance, MatType, TreeType> KDEType;
 
   //! The instantiated KDE object that we are wrapping.
   KDEType kde;
@@ -277,6 +307,9 @@ class KDEModel
   //! Break coefficient for Monte Carlo estimations.
   double mcBreakCoef;
 
+  //! If true, the dataset and the trees are held in single precision.
+  bool singlePrecision;
+
   /**
    * kdeModel holds whatever KDE type we are using.  It is initialized using the
    * `BuildModel()` method.
@@ -307,6 +340,9 @@ class KDEModel
    * @param mcBreakCoef Coefficient to control what fraction of the node's
    *                    descendants evaluated is the limit before Monte Carlo
    *                    estimation recurses.
+   * @param singlePrecision Whether to hold the dataset and the trees in single
+   *                        precision (arma::fmat), which halves their memory
+   *                        usage.
    */
   KDEModel(const double bandwidth = 1.0,
            const double relError = KDEDefaultParams::relError,
@@ -317,7 +353,8 @@ class KDEModel
            const double mcProb = KDEDefaultParams::mcProb,
            const size_t initialSampleSize = KDEDefaultParams::initialSampleSize,
            const double mcEntryCoef = KDEDefaultParams::mcEntryCoef,
-           const double mcBreakCoef = KDEDefaultParams::mcBreakCoef);
+           const double mcBreakCoef = KDEDefaultParams::mcBreakCoef,
+           const bool singlePrecision = false);
 
   //! Copy constructor of the given model.
   KDEModel(const KDEModel& other);
@@ -406,12 +443,28 @@ class KDEModel
   //! Modify Monte Carlo break coefficient.
   void MCBreakCoefficient(const double newBreakCoef);
 
+  //! Get whether the dataset and the trees are held in single precision.
+  bool SinglePrecision() const { return singlePrecision; }
+
+  //! Modify whether the dataset and the trees are held in single precision.
+  //! This takes effect the next time the model is built.
+  bool& SinglePrecision() { return singlePrecision; }
+
   //! Get the mode of the model.
   KDEMode Mode() const { return kdeModel->Mode(); }
 
   //! Modify the mode of the model.
   KDEMode& Mode() { return kdeModel->Mode(); }
 
+  //! Get the statistics of the tree traversals of the last evaluation.  These
+  //! are not serialized, and they are reset by BuildModel() and
+  //! InitializeModel().
+  const TraversalStatistics& Statistics() const
+  { return kdeModel->Statistics(); }
+
+  //! Modify the statistics of the tree traversals.
+  TraversalStatistics& Statistics() { return kdeModel->Statistics(); }
+
   /**
    * Initialize the KDE model.
    */
@@ -428,6 +481,27 @@ class KDEModel
    */
   void BuildModel(util::Timers& timers, arma::mat&& referenceSet);
 
+  /**
+   * Add the given points to the reference set of the model, updating the
+   * reference tree in place for kd-trees and ball trees, and building it again
+   * for the other tree types (see KDE::AddReferences()).  If WindowSize() is
+   * not 0, only that many of the most recent reference points are kept.
+   * Takes possession of the points to avoid a copy.
+   *
+   * @pre The model has to be previously created with BuildModel.
+   * @param timers Object to hold timing information in.
+   * @param points Points to add to the reference set.
+   */
+  void AddReferences(util::Timers& timers, arma::mat&& points);
+
+  //! Get the maximum number of reference points kept by AddReferences() (0
+  //! means no limit).
+  size_t WindowSize() const { return kdeModel->WindowSize(); }
+
+  //! Modify the maximum number of reference points kept by AddReferences() (0
+  //! means no limit).  Like Mode(), this is reset by BuildModel().
+  size_t& WindowSize() { return kdeModel->WindowSize(); }
+
   /**
    * Perform kernel density estimation on the given query set.
    * Takes possession of the query set to avoid a copy, so the query set
@@ -459,10 +533,88 @@ class KDEModel
  private:
   //! Clean memory.
   void CleanMemory();
+
+  //! Initialize kdeModel to hold a KDE object of the current kernel and tree
+  //! types with datasets of type MatType.
+  template<typename MatType>
+  void InitializeTypedModel();
+
+  //! Serialize kdeModel, which holds datasets of type MatType.
+  template<typename MatType, typename Archive>
+  void SerializeModel(Archive& ar);
 };
 
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::KDEModel, 1);
+
 #include "kde_model_impl.hpp"
 
+// If MLPACK_USE_PREBUILT is defined, the wrappers that KDEModel holds are
+// compiled into libmlpack (see BUILD_PREBUILT_LIBRARY), and are not
+// instantiated again here.
+#ifdef MLPACK_USE_PREBUILT
+namespace mlpack {
+
+extern template class KDEWrapper<GaussianKernel, KDTree, arma::mat>;
+extern template class KDEWrapper<EpanechnikovKernel, KDTree, arma::mat>;
+extern template class KDEWrapper<LaplacianKernel, KDTree, arma::mat>;
+extern template class KDEWrapper<SphericalKernel, KDTree, arma::mat>;
+extern template class KDEWrapper<TriangularKernel, KDTree, arma::mat>;
+extern template class KDEWrapper<GaussianKernel, BallTree, arma::mat>;
+extern template class KDEWrapper<EpanechnikovKernel, BallTree, arma::mat>;
+extern template class KDEWrapper<LaplacianKernel, BallTree, arma::mat>;
+extern template class KDEWrapper<SphericalKernel, BallTree, arma::mat>;
+extern template class KDEWrapper<TriangularKernel, BallTree, arma::mat>;
+extern template class KDEWrapper<GaussianKernel, StandardCoverTree, arma::mat>;
+extern template class KDEWrapper<EpanechnikovKernel, StandardCoverTree,
+    arma::mat>;
+extern template class KDEWrapper<LaplacianKernel, StandardCoverTree, arma::mat>;
+extern template class KDEWrapper<SphericalKernel, StandardCoverTree, arma::mat>;
+extern template class KDEWrapper<TriangularKernel, StandardCoverTree,
+    arma::mat>;
+extern template class KDEWrapper<GaussianKernel, Octree, arma::mat>;
+extern template class KDEWrapper<EpanechnikovKernel, Octree, arma::mat>;
+extern template class KDEWrapper<LaplacianKernel, Octree, arma::mat>;
+extern template class KDEWrapper<SphericalKernel, Octree, arma::mat>;
+extern template class KDEWrapper<TriangularKernel, Octree, arma::mat>;
+extern template class KDEWrapper<GaussianKernel, RTree, arma::mat>;
+extern template class KDEWrapper<EpanechnikovKernel, RTree, arma::mat>;
+extern template class KDEWrapper<LaplacianKernel, RTree, arma::mat>;
+extern template class KDEWrapper<SphericalKernel, RTree, arma::mat>;
+extern template class KDEWrapper<TriangularKernel, RTree, arma::mat>;
+
+extern template class KDEWrapper<GaussianKernel, KDTree, arma::fmat>;
+extern template class KDEWrapper<EpanechnikovKernel, KDTree, arma::fmat>;
+extern template class KDEWrapper<LaplacianKernel, KDTree, arma::fmat>;
+extern template class KDEWrapper<SphericalKernel, KDTree, arma::fmat>;
+extern template class KDEWrapper<TriangularKernel, KDTree, arma::fmat>;
+extern template class KDEWrapper<GaussianKernel, BallTree, arma::fmat>;
+extern template class KDEWrapper<EpanechnikovKernel, BallTree, arma::fmat>;
+extern template class KDEWrapper<LaplacianKernel, BallTree, arma::fmat>;
+extern template class KDEWrapper<SphericalKernel, BallTree, arma::fmat>;
+extern template class KDEWrapper<TriangularKernel, BallTree, arma::fmat>;
+extern template class KDEWrapper<GaussianKernel, StandardCoverTree, arma::fmat>;
+extern template class KDEWrapper<EpanechnikovKernel, StandardCoverTree,
+    arma::fmat>;
+extern template class KDEWrapper<LaplacianKernel, StandardCoverTree,
+    arma::fmat>;
+extern template class KDEWrapper<SphericalKernel, StandardCoverTree,
+    arma::fmat>;
+extern template class KDEWrapper<TriangularKernel, StandardCoverTree,
+    arma::fmat>;
+extern template class KDEWrapper<GaussianKernel, Octree, arma::fmat>;
+extern template class KDEWrapper<EpanechnikovKernel, Octree, arma::fmat>;
+extern template class KDEWrapper<LaplacianKernel, Octree, arma::fmat>;
+extern template class KDEWrapper<SphericalKernel, Octree, arma::fmat>;
+extern template class KDEWrapper<TriangularKernel, Octree, arma::fmat>;
+extern template class KDEWrapper<GaussianKernel, RTree, arma::fmat>;
+extern template class KDEWrapper<EpanechnikovKernel, RTree, arma::fmat>;
+extern template class KDEWrapper<LaplacianKernel, RTree, arma::fmat>;
+extern template class KDEWrapper<SphericalKernel, RTree, arma::fmat>;
+extern template class KDEWrapper<TriangularKernel, RTree, arma::fmat>;
+
+} // namespace mlpack
+#endif
+
 #endif
@@ -28,7 +28,8 @@ inline KDEModel::KDEModel(
     const double mcProb,
     const size_t initialSampleSize,
     const double mcEntryCoef,
-    const double mcBreakCoef) :
+    const double mcBreakCoef,
+    const bool singlePrecision) :
     bandwidth(bandwidth),
     relError(relError),
     absError(absError),
@@ -39,6 +40,7 @@ inline KDEModel::KDEModel(
     initialSampleSize(initialSampleSize),
     mcEntryCoef(mcEntryCoef),
     mcBreakCoef(mcBreakCoef),
+    singlePrecision(singlePrecision),
     kdeModel(NULL)
 {
   // Nothing to do.
@@ -56,6 +58,7 @@ inline KDEModel::KDEModel(const KDEModel& other) :
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
     mcBreakCoef(other.mcBreakCoef),
+    singlePrecision(other.singlePrecision),
     kdeModel(other.kdeModel->Clone())
 {
   // Nothing to do.
@@ -73,6 +76,7 @@ inline KDEModel::KDEModel(KDEModel&& other) :
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
     mcBreakCoef(other.mcBreakCoef),
+    singlePrecision(other.singlePrecision),
     kdeModel(std::move(other.kdeModel))
 {
   // Reset other model.
@@ -86,6 +90,7 @@ inline KDEModel::KDEModel(KDEModel&& other) :
   other.initialSampleSize = KDEDefaultParams::initialSampleSize;
   other.mcEntryCoef = KDEDefaultParams::mcEntryCoef;
   other.mcBreakCoef = KDEDefaultParams::mcBreakCoef;
+  other.singlePrecision = false;
 }
 
 inline KDEModel& KDEModel::operator=(const KDEModel& other)
@@ -104,6 +109,7 @@ inline KDEModel& KDEModel::operator=(const KDEModel& other)
     initialSampleSize = other.initialSampleSize;
     mcEntryCoef = other.mcEntryCoef;
     mcBreakCoef = other.mcBreakCoef;
+    singlePrecision = other.singlePrecision;
     kdeModel = other.kdeModel->Clone();
   }
 
@@ -126,6 +132,7 @@ inline KDEModel& KDEModel::operator=(KDEModel&& other)
     initialSampleSize = other.initialSampleSize;
     mcEntryCoef = other.mcEntryCoef;
     mcBreakCoef = other.mcBreakCoef;
+    singlePrecision = other.singlePrecision;
     kdeModel = std::move(other.kdeModel);
 
     // Reset other model.
@@ -139,6 +146,7 @@ inline KDEModel& KDEModel::operator=(KDEModel&& other)
     other.initialSampleSize = KDEDefaultParams::initialSampleSize;
     other.mcEntryCoef = KDEDefaultParams::mcEntryCoef;
     other.mcBreakCoef = KDEDefaultParams::mcBreakCoef;
+    other.singlePrecision = false;
   }
 
   return *this;
@@ -152,7 +160,8 @@ inline KDEModel::~KDEModel()
 
 template<template<typename TreeMetricType,
                   typename TreeMatType,
-                  typename TreeStatType> class TreeType>
+                  typename TreeStatType> class TreeType,
+         typename MatType>
 KDEWrapperBase* InitializeModelHelper(const KDEModel::KernelTypes kernelType,
                                       const double relError,
                                       const double absError,
@@ -161,24 +170,24 @@ KDEWrapperBase* InitializeModelHelper(const KDEModel::KernelTypes kernelType,
   switch (kernelType)
   {
     case KDEModel::GAUSSIAN_KERNEL:
-      return new KDEWrapper<GaussianKernel, TreeType>(relError, absError,
-          GaussianKernel(bandwidth));
+      return new KDEWrapper<GaussianKernel, TreeType, MatType>(relError,
+          absError, GaussianKernel(bandwidth));
 
     case KDEModel::EPANECHNIKOV_KERNEL:
-      return new KDEWrapper<EpanechnikovKernel, TreeType>(relError, absError,
-          EpanechnikovKernel(bandwidth));
+      return new KDEWrapper<EpanechnikovKernel, TreeType, MatType>(relError,
+          absError, EpanechnikovKernel(bandwidth));
 
     case KDEModel::LAPLACIAN_KERNEL:
-      return new KDEWrapper<LaplacianKernel, TreeType>(relError, absError,
-          LaplacianKernel(bandwidth));
+      return new KDEWrapper<LaplacianKernel, TreeType, MatType>(relError,
+          absError, LaplacianKernel(bandwidth));
 
     case KDEModel::SPHERICAL_KERNEL:
-      return new KDEWrapper<SphericalKernel, TreeType>(relError, absError,
-          SphericalKernel(bandwidth));
+      return new KDEWrapper<SphericalKernel, TreeType, MatType>(relError,
+          absError, SphericalKernel(bandwidth));
 
     case KDEModel::TRIANGULAR_KERNEL:
-      return new KDEWrapper<TriangularKernel, TreeType>(relError, absError,
-          TriangularKernel(bandwidth));
+      return new KDEWrapper<TriangularKernel, TreeType, MatType>(relError,
+          absError, TriangularKernel(bandwidth));
   }
 
   // This should never happen.
@@ -191,31 +200,42 @@ inline void KDEModel::InitializeModel()
   delete kdeModel;
 
   // Build the actual model.
+  if (singlePrecision)
+    InitializeTypedModel<arma::fmat>();
+  else
+    InitializeTypedModel<arma::mat>();
+}
+
+// Build the wrapper of the KDE object for the current kernel and tree types,
+// with datasets of type MatType.
+template<typename MatType>
+void KDEModel::InitializeTypedModel()
+{
   switch (treeType)
   {
     case KD_TREE:
-      kdeModel = InitializeModelHelper<KDTree>(kernelType, relError, absError,
-          bandwidth);
+      kdeModel = InitializeModelHelper<KDTree, MatType>(kernelType,
+          relError, absError, bandwidth);
       break;
 
     case BALL_TREE:
-      kdeModel = InitializeModelHelper<BallTree>(kernelType, relError, absError,
-          bandwidth);
+      kdeModel = InitializeModelHelper<BallTree, MatType>(kernelType,
+          relError, absError, bandwidth);
       break;
 
     case COVER_TREE:
-      kdeModel = InitializeModelHelper<StandardCoverTree>(kernelType, relError,
-          absError, bandwidth);
+      kdeModel = InitializeModelHelper<StandardCoverTree, MatType>(kernelType,
+          relError, absError, bandwidth);
       break;
 
     case OCTREE:
-      kdeModel = InitializeModelHelper<Octree>(kernelType, relError, absError,
-          bandwidth);
+      kdeModel = InitializeModelHelper<Octree, MatType>(kernelType,
+          relError, absError, bandwidth);
       break;
 
     case R_TREE:
-      kdeModel = InitializeModelHelper<RTree>(kernelType, relError, absError,
-          bandwidth);
+      kdeModel = InitializeModelHelper<RTree, MatType>(kernelType,
+          relError, absError, bandwidth);
       break;
   }
 }
@@ -244,6 +264,12 @@ inline void KDEModel::BuildModel(util::Timers& timers,
   kdeModel->Train(timers, std::move(referenceSet));
 }
 
+// Add points to the reference set.
+inline void KDEModel::AddReferences(util::Timers& timers, arma::mat&& points)
+{
+  kdeModel->AddReferences(timers, std::move(points));
+}
+
 // Perform bichromatic evaluation.
 inline void KDEModel::Evaluate(util::Timers& timers,
                                arma::mat&& querySet,
@@ -325,12 +351,29 @@ inline void KDEModel::MCBreakCoefficient(const double newBreakCoef)
 template<typename KernelType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void KDEWrapper<KernelType, TreeType>::Train(util::Timers& timers,
-                                             arma::mat&& referenceSet)
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void KDEWrapper<KernelType, TreeType, MatType>::Train(
+    util::Timers& timers,
+    arma::mat&& referenceSet)
 {
   timers.Start("tree_building");
-  kde.Train(std::move(referenceSet));
+  kde.Train(ConvertOrMove<MatType>(std::move(referenceSet)));
+  timers.Stop("tree_building");
+}
+
+//! Add points to the reference set of the model.
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void KDEWrapper<KernelType, TreeType, MatType>::AddReferences(
+    util::Timers& timers,
+    arma::mat&& points)
+{
+  timers.Start("tree_building");
+  kde.AddReferences(ConvertOrMove<MatType>(std::move(points)));
   timers.Stop("tree_building");
 }
 
@@ -338,10 +381,12 @@ void KDEWrapper<KernelType, TreeType>::Train(util::Timers& timers,
 template<typename KernelType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void KDEWrapper<KernelType, TreeType>::Evaluate(util::Timers& timers,
-                                                arma::mat&& querySet,
-                                                arma::vec& estimates)
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void KDEWrapper<KernelType, TreeType, MatType>::Evaluate(
+    util::Timers& timers,
+    arma::mat&& querySet,
+    arma::vec& estimates)
 {
   const size_t dimension = querySet.n_rows;
   if (kde.Mode() == KDE_DUAL_TREE_MODE)
@@ -350,7 +395,8 @@ void KDEWrapper<KernelType, TreeType>::Evaluate(util::Timers& timers,
     timers.Start("tree_building");
     std::vector<size_t> oldFromNewQueries;
     typename decltype(kde)::Tree* queryTree = BuildTree<
-        typename decltype(kde)::Tree>(std::move(querySet), oldFromNewQueries);
+        typename decltype(kde)::Tree>(
+        ConvertOrMove<MatType>(std::move(querySet)), oldFromNewQueries);
     timers.Stop("tree_building");
 
     timers.Start("computing_kde");
@@ -362,7 +408,7 @@ void KDEWrapper<KernelType, TreeType>::Evaluate(util::Timers& timers,
   else
   {
     timers.Start("computing_kde");
-    kde.Evaluate(std::move(querySet), estimates);
+    kde.Evaluate(ConvertOrMove<MatType>(std::move(querySet)), estimates);
     timers.Stop("computing_kde");
   }
 
@@ -377,9 +423,11 @@ void KDEWrapper<KernelType, TreeType>::Evaluate(util::Timers& timers,
 template<typename KernelType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void KDEWrapper<KernelType, TreeType>::Evaluate(util::Timers& timers,
-                                                arma::vec& estimates)
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void KDEWrapper<KernelType, TreeType, MatType>::Evaluate(
+    util::Timers& timers,
+    arma::vec& estimates)
 {
   timers.Start("computing_kde");
   kde.Evaluate(estimates);
@@ -396,6 +444,7 @@ void KDEWrapper<KernelType, TreeType>::Evaluate(util::Timers& timers,
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          typename Archive>
 void SerializationHelper(Archive& ar,
                          KDEWrapperBase* kdeModel,
@@ -405,36 +454,41 @@ void SerializationHelper(Archive& ar,
   {
     case KDEModel::GAUSSIAN_KERNEL:
       {
-        KDEWrapper<GaussianKernel, TreeType>& typedModel =
-            dynamic_cast<KDEWrapper<GaussianKernel, TreeType>&>(*kdeModel);
+        KDEWrapper<GaussianKernel, TreeType, MatType>& typedModel =
+            dynamic_cast<KDEWrapper<GaussianKernel, TreeType, MatType>&>(
+            *kdeModel);
         ar(CEREAL_NVP(typedModel));
         break;
       }
     case KDEModel::EPANECHNIKOV_KERNEL:
       {
-        KDEWrapper<EpanechnikovKernel, TreeType>& typedModel =
-            dynamic_cast<KDEWrapper<EpanechnikovKernel, TreeType>&>(*kdeModel);
+        KDEWrapper<EpanechnikovKernel, TreeType, MatType>& typedModel =
+            dynamic_cast<KDEWrapper<EpanechnikovKernel, TreeType, MatType>&>(
+            *kdeModel);
         ar(CEREAL_NVP(typedModel));
         break;
       }
     case KDEModel::LAPLACIAN_KERNEL:
       {
-        KDEWrapper<LaplacianKernel, TreeType>& typedModel =
-            dynamic_cast<KDEWrapper<LaplacianKernel, TreeType>&>(*kdeModel);
+        KDEWrapper<LaplacianKernel, TreeType, MatType>& typedModel =
+            dynamic_cast<KDEWrapper<LaplacianKernel, TreeType, MatType>&>(
+            *kdeModel);
         ar(CEREAL_NVP(typedModel));
         break;
       }
     case KDEModel::SPHERICAL_KERNEL:
       {
-        KDEWrapper<SphericalKernel, TreeType>& typedModel =
-            dynamic_cast<KDEWrapper<SphericalKernel, TreeType>&>(*kdeModel);
+        KDEWrapper<SphericalKernel, TreeType, MatType>& typedModel =
+            dynamic_cast<KDEWrapper<SphericalKernel, TreeType, MatType>&>(
+            *kdeModel);
         ar(CEREAL_NVP(typedModel));
         break;
       }
     case KDEModel::TRIANGULAR_KERNEL:
       {
-        KDEWrapper<TriangularKernel, TreeType>& typedModel =
-            dynamic_cast<KDEWrapper<TriangularKernel, TreeType>&>(*kdeModel);
+        KDEWrapper<TriangularKernel, TreeType, MatType>& typedModel =
+            dynamic_cast<KDEWrapper<TriangularKernel, TreeType, MatType>&>(
+            *kdeModel);
         ar(CEREAL_NVP(typedModel));
         break;
       }
@@ -443,7 +497,7 @@ void SerializationHelper(Archive& ar,
 
 // Serialize the model.
 template<typename Archive>
-void KDEModel::serialize(Archive& ar, const uint32_t /* version */)
+void KDEModel::serialize(Archive& ar, const uint32_t version)
 {
   ar(CEREAL_NVP(bandwidth));
   ar(CEREAL_NVP(relError));
@@ -465,30 +519,46 @@ void KDEModel::serialize(Archive& ar, const uint32_t /* version */)
     mcBreakCoef = KDEDefaultParams::mcBreakCoef;
   }
 
+  // Models before version 1 were always held in double precision.
+  if (cereal::is_loading<Archive>() && version == 0)
+    singlePrecision = false;
+  else
+    ar(CEREAL_NVP(singlePrecision));
+
   if (cereal::is_loading<Archive>())
     InitializeModel(); // Values will be overwritten.
 
   // Avoid polymorphism in serialization by serializing directly by the type.
+  if (singlePrecision)
+    SerializeModel<arma::fmat>(ar);
+  else
+    SerializeModel<arma::mat>(ar);
+}
+
+// Serialize the KDE object held by the model.
+template<typename MatType, typename Archive>
+void KDEModel::SerializeModel(Archive& ar)
+{
   switch (treeType)
   {
     case KD_TREE:
-      SerializationHelper<KDTree>(ar, kdeModel, kernelType);
+      SerializationHelper<KDTree, MatType>(ar, kdeModel, kernelType);
       break;
 
     case BALL_TREE:
-      SerializationHelper<BallTree>(ar, kdeModel, kernelType);
+      SerializationHelper<BallTree, MatType>(ar, kdeModel, kernelType);
       break;
 
     case COVER_TREE:
-      SerializationHelper<StandardCoverTree>(ar, kdeModel, kernelType);
+      SerializationHelper<StandardCoverTree, MatType>(ar, kdeModel, kernelType);
       break;
 
     case OCTREE:
-      SerializationHelper<Octree>(ar, kdeModel, kernelType);
+      SerializationHelper<Octree, MatType>(ar, kdeModel, kernelType);
       break;
 
     case R_TREE:
-      SerializationHelper<RTree>(ar, kdeModel, kernelType);
+      SerializationHelper<RTree, MatType>(ar, kdeModel, kernelType);
       break;
   }
 }
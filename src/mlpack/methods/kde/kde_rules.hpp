@@ -14,9 +14,31 @@
 #define MLPACK_METHODS_KDE_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 
 namespace mlpack {
 
+/**
+ * Whether KDERules can compute the kernel values between blocks of points with
+ * the batch Evaluate() method of the kernel (see HasBatchEvaluate), which uses
+ * a matrix multiplication.  The kernels used with KDE are functions of the
+ * Euclidean distance, so this is the case when the metric is the Euclidean
+ * distance, the data is dense and the kernel has a batch Evaluate().
+ */
+template<typename MetricType, typename KernelType, typename MatType>
+struct UseBatchKernelValues
+{
+  static const bool value = false;
+};
+
+//! The Euclidean distance on dense data can use the batch kernel values.
+template<typename KernelType, typename eT>
+struct UseBatchKernelValues<EuclideanDistance, KernelType, arma::Mat<eT>>
+{
+  static const bool value = HasBatchEvaluate<KernelType>::value;
+};
+
 /**
  * A dual-tree traversal Rules class for kernel density estimation.  This
  * contains the Score() and BaseCase() implementations.
@@ -25,6 +47,11 @@ template<typename MetricType, typename KernelType, typename TreeType>
 class KDERules
 {
  public:
+  //! The type of the data held by the trees.
+  typedef typename TreeType::Mat MatType;
+  //! The type of the elements of the data.
+  typedef typename MatType::elem_type ElemType;
+
   /**
    * Construct KDERules.
    *
@@ -45,8 +72,49 @@ class KDERules
    * @param sameSet True if query and reference sets are the same
    *                (monochromatic evaluation).
    */
-  KDERules(const arma::mat& referenceSet,
-           const arma::mat& querySet,
+  KDERules(const MatType& referenceSet,
+           const MatType& querySet,
+           arma::vec& densities,
+           const double relError,
+           const double absError,
+           const double mcProb,
+           const size_t initialSampleSize,
+           const double mcAccessCoef,
+           const double mcBreakCoef,
+           MetricType& metric,
+           KernelType& kernel,
+           const bool monteCarlo,
+           const bool sameSet);
+
+  /**
+   * Construct KDERules that only hold the accumulated errors of the query
+   * points in the range [queryBegin, queryBegin + queryCount).  Only those
+   * query points may be passed to BaseCase() and Score().  This is used to
+   * evaluate disjoint query subtrees with separate rules in parallel.
+   *
+   * @param referenceSet Reference set data.
+   * @param querySet Query set data.
+   * @param queryBegin Index of the first query point to estimate.
+   * @param queryCount Number of query points to estimate.
+   * @param densities Vector where estimations will be written.
+   * @param relError Relative error tolerance.
+   * @param absError Absolute error tolerance.
+   * @param mcProb Probability of relative error compliance for Monte Carlo
+   *               estimations.
+   * @param initialSampleSize Initial size of the Monte Carlo samples.
+   * @param mcAccessCoef Access coefficient for Monte Carlo estimations.
+   * @param mcBreakCoef Break coefficient for Monte Carlo estimations.
+   * @param metric Instantiated metric.
+   * @param kernel Instantiated kernel.
+   * @param monteCarlo If true Monte Carlo estimations will be applied when
+   *                   possible.
+   * @param sameSet True if query and reference sets are the same
+   *                (monochromatic evaluation).
+   */
+  KDERules(const MatType& referenceSet,
+           const MatType& querySet,
+           const size_t queryBegin,
+           const size_t queryCount,
            arma::vec& densities,
            const double relError,
            const double absError,
@@ -62,6 +130,20 @@ class KDERules
   //! Base Case.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between each of the given query points and every
+   * point in the given reference leaf.  This is used by the BinarySpaceTree
+   * traversers when two leaves are compared, and is equivalent to calling
+   * BaseCase() for each pair of points; the kernel values of the whole block
+   * are computed at once (see UseBatchKernelValues) and summed for each query
+   * point.
+   *
+   * @param queryIndices Indices of query points.
+   * @param referenceNode Reference leaf; its points must be contiguous.
+   */
+  void LeafBaseCases(const std::vector<size_t>& queryIndices,
+                     TreeType& referenceNode);
+
   //! SingleTree Rescore.
   double Score(const size_t queryIndex, TreeType& referenceNode);
 
@@ -96,23 +178,75 @@ class KDERules
   //! results.
   size_t MinimumBaseCases() const { return 0; }
 
+  /**
+   * Compute the Monte Carlo alpha of every node of the given reference tree,
+   * as Score() does when it first visits each node.  Once this is done, Score()
+   * only reads the statistics of reference nodes, so the rules of disjoint
+   * query subtrees can traverse the reference tree at the same time.
+   *
+   * @param referenceNode Root of the reference tree.
+   * @param mcProb Probability of relative error compliance for Monte Carlo
+   *               estimations.
+   */
+  static void CalculateAlphas(TreeType& referenceNode, const double mcProb);
+
  private:
-  //! Evaluate kernel value of 2 points given their indexes.
-  double EvaluateKernel(const size_t queryIndex,
-                        const size_t referenceIndex) const;
+  /**
+   * Compute the kernel values between every point of the given references and
+   * every point of the given queries, so that values(i, j) is the kernel value
+   * of references.col(i) and queries.col(j).  This uses the batch Evaluate() of
+   * the kernel.
+   */
+  template<typename MatTypeA, typename MatTypeB, typename MetricT = MetricType>
+  void KernelValues(
+      const MatTypeA& references,
+      const MatTypeB& queries,
+      arma::Mat<ElemType>& values,
+      const std::enable_if_t<UseBatchKernelValues<MetricT, KernelType,
+          MatType>::value>* = 0) const;
 
-  //! Evaluate kernel value of 2 points.
-  double EvaluateKernel(const arma::vec& query,
-                        const arma::vec& reference) const;
+  /**
+   * Compute the kernel values between every point of the given references and
+   * every point of the given queries one pair at a time, with the metric and
+   * the kernel.
+   */
+  template<typename MatTypeA, typename MatTypeB, typename MetricT = MetricType>
+  void KernelValues(
+      const MatTypeA& references,
+      const MatTypeB& queries,
+      arma::Mat<ElemType>& values,
+      const std::enable_if_t<!UseBatchKernelValues<MetricT, KernelType,
+          MatType>::value>* = 0) const;
 
-  //! Calculate depth alpha for some node.
-  double CalculateAlpha(TreeType* node);
+  /**
+   * Draw a batch of random descendants of the reference node, and store their
+   * kernel values with the query point in the Monte Carlo sample.
+   *
+   * @param queryIndex Index of the query point.
+   * @param referenceNode Node to draw reference points from.
+   * @param firstDescendant Index of the first descendant that may be drawn.
+   * @param count Number of points to draw.
+   * @param sample Sample to store the kernel values in.
+   * @param offset Position in the sample of the first kernel value.
+   */
+  void DrawSample(const size_t queryIndex,
+                  TreeType& referenceNode,
+                  const size_t firstDescendant,
+                  const size_t count,
+                  arma::vec& sample,
+                  const size_t offset) const;
+
+  /**
+   * Calculate depth alpha for some node, for the given value of beta (that is,
+   * 1 - mcProb).
+   */
+  static double CalculateAlpha(TreeType* node, const double beta);
 
   //! The reference set.
-  const arma::mat& referenceSet;
+  const MatType& referenceSet;
 
   //! The query set.
-  const arma::mat& querySet;
+  const MatType& querySet;
 
   //! Density values.
   arma::vec& densities;
@@ -148,6 +282,10 @@ class KDERules
   //! Whether Monte Carlo estimations are going to be applied.
   const bool monteCarlo;
 
+  //! The index of the first query point that the accumulated values are held
+  //! for.
+  const size_t queryBegin;
+
   //! Accumulated not used MC alpha values for each query point.
   arma::vec accumMCAlpha;
 
@@ -23,8 +23,32 @@ namespace mlpack {
 
 template<typename MetricType, typename KernelType, typename TreeType>
 KDERules<MetricType, KernelType, TreeType>::KDERules(
-    const arma::mat& referenceSet,
-    const arma::mat& querySet,
+    const MatType& referenceSet,
+    const MatType& querySet,
+    arma::vec& densities,
+    const double relError,
+    const double absError,
+    const double mcProb,
+    const size_t initialSampleSize,
+    const double mcAccessCoef,
+    const double mcBreakCoef,
+    MetricType& metric,
+    KernelType& kernel,
+    const bool monteCarlo,
+    const bool sameSet) :
+    KDERules(referenceSet, querySet, 0, querySet.n_cols, densities, relError,
+             absError, mcProb, initialSampleSize, mcAccessCoef, mcBreakCoef,
+             metric, kernel, monteCarlo, sameSet)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+KDERules<MetricType, KernelType, TreeType>::KDERules(
+    const MatType& referenceSet,
+    const MatType& querySet,
+    const size_t queryBegin,
+    const size_t queryCount,
     arma::vec& densities,
     const double relError,
     const double absError,
@@ -48,6 +72,7 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     metric(metric),
     kernel(kernel),
     monteCarlo(monteCarlo),
+    queryBegin(queryBegin),
     sameSet(sameSet),
     absErrorTol(absError / referenceSet.n_cols),
     lastQueryIndex(querySet.n_cols),
@@ -56,11 +81,11 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     scores(0)
 {
   // Initialize accumError.
-  accumError = arma::vec(querySet.n_cols, arma::fill::zeros);
+  accumError = arma::vec(queryCount, arma::fill::zeros);
 
   // Initialize accumMCAlpha only if Monte Carlo estimations are available.
   if (monteCarlo && kernelIsGaussian)
-    accumMCAlpha = arma::vec(querySet.n_cols, arma::fill::zeros);
+    accumMCAlpha = arma::vec(queryCount, arma::fill::zeros);
 }
 
 //! The base case.
@@ -86,7 +111,7 @@ double KDERules<MetricType, KernelType, TreeType>::BaseCase(
   densities(queryIndex) += kernelValue;
 
   // Update accumulated relative error tolerance for single-tree pruning.
-  accumError(queryIndex) += 2 * relError * kernelValue;
+  accumError(queryIndex - queryBegin) += 2 * relError * kernelValue;
 
   ++baseCases;
   lastQueryIndex = queryIndex;
@@ -95,21 +120,67 @@ double KDERules<MetricType, KernelType, TreeType>::BaseCase(
   return distance;
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::LeafBaseCases(
+    const std::vector<size_t>& queryIndices,
+    TreeType& referenceNode)
+{
+  const size_t refBegin = referenceNode.Begin();
+  const size_t refCount = referenceNode.Count();
+  if (refCount == 0 || queryIndices.empty())
+    return;
+
+  // Gather the query points; the reference points are already contiguous.
+  MatType queries(querySet.n_rows, queryIndices.size());
+  for (size_t i = 0; i < queryIndices.size(); ++i)
+    queries.col(i) = querySet.col(queryIndices[i]);
+
+  arma::Mat<ElemType> values;
+  KernelValues(referenceSet.cols(refBegin, refBegin + refCount - 1), queries,
+      values);
+
+  // The pairs of a leaf combination are never the pair of the last base case
+  // (no other leaf combination has the same query and reference points), so
+  // only the pairs of a point with itself are skipped.
+  for (size_t i = 0; i < queryIndices.size(); ++i)
+  {
+    const size_t queryIndex = queryIndices[i];
+    double kernelSum = 0.0;
+    for (size_t j = 0; j < refCount; ++j)
+    {
+      if (sameSet && (queryIndex == refBegin + j))
+        continue;
+
+      kernelSum += values(j, i);
+      ++baseCases;
+    }
+
+    densities(queryIndex) += kernelSum;
+
+    // Update accumulated relative error tolerance for single-tree pruning.
+    accumError(queryIndex - queryBegin) += 2 * relError * kernelSum;
+  }
+
+  lastQueryIndex = queryIndices.back();
+  lastReferenceIndex = refBegin + refCount - 1;
+}
+
 //! Single-tree scoring function.
 template<typename MetricType, typename KernelType, typename TreeType>
 inline double KDERules<MetricType, KernelType, TreeType>::
 Score(const size_t queryIndex, TreeType& referenceNode)
 {
   // Auxiliary variables.
-  const arma::vec& queryPoint = querySet.unsafe_col(queryIndex);
+  const arma::Col<ElemType>& queryPoint = querySet.unsafe_col(queryIndex);
   const size_t refNumDesc = referenceNode.NumDescendants();
+  const size_t accumIndex = queryIndex - queryBegin;
   double score, minDistance, maxDistance, depthAlpha;
   // Calculations are not duplicated.
   bool alreadyDidRefPoint0 = false;
 
   // Calculate alpha if Monte Carlo is available.
   if (monteCarlo && kernelIsGaussian)
-    depthAlpha = CalculateAlpha(&referenceNode);
+    depthAlpha = CalculateAlpha(&referenceNode, mcBeta);
   else
     depthAlpha = -1;
 
@@ -155,9 +226,9 @@ Score(const size_t queryIndex, TreeType& referenceNode)
   // it here to prune more.
   double pointAccumErrorTol;
   if (alreadyDidRefPoint0)
-    pointAccumErrorTol = accumError(queryIndex) / (refNumDesc - 1);
+    pointAccumErrorTol = accumError(accumIndex) / (refNumDesc - 1);
   else
-    pointAccumErrorTol = accumError(queryIndex) / refNumDesc;
+    pointAccumErrorTol = accumError(accumIndex) / refNumDesc;
 
   if (bound <= 2 * errorTolerance + pointAccumErrorTol)
   {
@@ -175,13 +246,13 @@ Score(const size_t queryIndex, TreeType& referenceNode)
     // Subtract used error tolerance or add extra available tolerace from this
     // prune.
     if (alreadyDidRefPoint0)
-      accumError(queryIndex) -= (refNumDesc - 1) * (bound - 2 * errorTolerance);
+      accumError(accumIndex) -= (refNumDesc - 1) * (bound - 2 * errorTolerance);
     else
-      accumError(queryIndex) -= refNumDesc * (bound - 2 * errorTolerance);
+      accumError(accumIndex) -= refNumDesc * (bound - 2 * errorTolerance);
 
     // Store not used alpha for Monte Carlo.
     if (kernelIsGaussian && monteCarlo)
-      accumMCAlpha(queryIndex) += depthAlpha;
+      accumMCAlpha(accumIndex) += depthAlpha;
   }
   else if (monteCarlo &&
            refNumDesc >= mcAccessCoef * initialSampleSize &&
@@ -189,7 +260,7 @@ Score(const size_t queryIndex, TreeType& referenceNode)
   {
     // Monte Carlo probabilistic estimation.
     // Calculate z using accumulated alpha if possible.
-    const double alpha = depthAlpha + accumMCAlpha(queryIndex);
+    const double alpha = depthAlpha + accumMCAlpha(accumIndex);
     const double z = std::abs(Quantile(alpha / 2.0));
 
     // Auxiliary variables.
@@ -212,20 +283,11 @@ Score(const size_t queryIndex, TreeType& referenceNode)
         break;
       }
 
-      // Increase the sample size.
+      // Increase the sample size, and sample and evaluate random points from
+      // the reference node.
       sample.resize(newSize);
-      for (size_t i = 0; i < m; ++i)
-      {
-        // Sample and evaluate random points from the reference node.
-        size_t randomPoint;
-        if (alreadyDidRefPoint0)
-          randomPoint = RandInt(1, refNumDesc);
-        else
-          randomPoint = RandInt(0, refNumDesc);
-
-        sample(oldSize + i) =
-            EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
-      }
+      DrawSample(queryIndex, referenceNode, alreadyDidRefPoint0 ? 1 : 0, m,
+          sample, oldSize);
       meanSample = arma::mean(sample);
       const double stddev = arma::stddev(sample);
       const double mThreshBase =
@@ -250,7 +312,7 @@ Score(const size_t queryIndex, TreeType& referenceNode)
       score = DBL_MAX;
 
       // Accumulated alpha has been used.
-      accumMCAlpha(queryIndex) = 0;
+      accumMCAlpha(accumIndex) = 0;
     }
     else
     {
@@ -260,7 +322,7 @@ Score(const size_t queryIndex, TreeType& referenceNode)
       if (referenceNode.IsLeaf())
       {
         // Reclaim not used alpha since the node will be exactly computed.
-        accumMCAlpha(queryIndex) += depthAlpha;
+        accumMCAlpha(accumIndex) += depthAlpha;
       }
     }
   }
@@ -273,15 +335,15 @@ Score(const size_t queryIndex, TreeType& referenceNode)
     if (referenceNode.IsLeaf())
     {
       if (alreadyDidRefPoint0)
-        accumError(queryIndex) += (refNumDesc - 1) * 2 * absErrorTol;
+        accumError(accumIndex) += (refNumDesc - 1) * 2 * absErrorTol;
       else
-        accumError(queryIndex) += refNumDesc * 2 * absErrorTol;
+        accumError(accumIndex) += refNumDesc * 2 * absErrorTol;
     }
 
     // If node is going to be exactly computed, reclaim not used alpha for
     // Monte Carlo estimations.
     if (kernelIsGaussian && monteCarlo && referenceNode.IsLeaf())
-      accumMCAlpha(queryIndex) += depthAlpha;
+      accumMCAlpha(accumIndex) += depthAlpha;
   }
 
   ++scores;
@@ -313,7 +375,7 @@ Score(TreeType& queryNode, TreeType& referenceNode)
 
   // Calculate alpha if Monte Carlo is available.
   if (monteCarlo && kernelIsGaussian)
-    depthAlpha = CalculateAlpha(&referenceNode);
+    depthAlpha = CalculateAlpha(&referenceNode, mcBeta);
   else
     depthAlpha = -1;
 
@@ -427,20 +489,11 @@ Score(TreeType& queryNode, TreeType& referenceNode)
           break;
         }
 
-        // Increase the sample size.
+        // Increase the sample size, and sample and evaluate random points from
+        // the reference node.
         sample.resize(newSize);
-        for (size_t i = 0; i < m; ++i)
-        {
-          // Sample and evaluate random points from the reference node.
-          size_t randomPoint;
-          if (alreadyDidRefPoint0)
-            randomPoint = RandInt(1, refNumDesc);
-          else
-            randomPoint = RandInt(0, refNumDesc);
-
-          sample(oldSize + i) =
-              EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
-        }
+        DrawSample(queryIndex, referenceNode, alreadyDidRefPoint0 ? 1 : 0, m,
+            sample, oldSize);
         meanSample = arma::mean(sample);
         const double stddev = arma::stddev(sample);
         const double mThreshBase =
@@ -524,36 +577,87 @@ Rescore(TreeType& /*queryNode*/,
 }
 
 template<typename MetricType, typename KernelType, typename TreeType>
-inline mlpack_force_inline double KDERules<MetricType, KernelType, TreeType>::
-EvaluateKernel(const size_t queryIndex,
-               const size_t referenceIndex) const
+template<typename MatTypeA, typename MatTypeB, typename MetricT>
+void KDERules<MetricType, KernelType, TreeType>::KernelValues(
+    const MatTypeA& references,
+    const MatTypeB& queries,
+    arma::Mat<ElemType>& values,
+    const std::enable_if_t<UseBatchKernelValues<MetricT, KernelType,
+        MatType>::value>*) const
 {
-  return EvaluateKernel(querySet.unsafe_col(queryIndex),
-                        referenceSet.unsafe_col(referenceIndex));
+  kernel.Evaluate(references, queries, values);
 }
 
 template<typename MetricType, typename KernelType, typename TreeType>
-inline mlpack_force_inline double KDERules<MetricType, KernelType, TreeType>::
-EvaluateKernel(const arma::vec& query, const arma::vec& reference) const
+template<typename MatTypeA, typename MatTypeB, typename MetricT>
+void KDERules<MetricType, KernelType, TreeType>::KernelValues(
+    const MatTypeA& references,
+    const MatTypeB& queries,
+    arma::Mat<ElemType>& values,
+    const std::enable_if_t<!UseBatchKernelValues<MetricT, KernelType,
+        MatType>::value>*) const
+{
+  values.set_size(references.n_cols, queries.n_cols);
+  for (size_t j = 0; j < queries.n_cols; ++j)
+  {
+    for (size_t i = 0; i < references.n_cols; ++i)
+    {
+      values(i, j) = kernel.Evaluate(metric.Evaluate(queries.col(j),
+          references.col(i)));
+    }
+  }
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::DrawSample(
+    const size_t queryIndex,
+    TreeType& referenceNode,
+    const size_t firstDescendant,
+    const size_t count,
+    arma::vec& sample,
+    const size_t offset) const
+{
+  // The points are drawn first, so that the kernel values of the whole batch
+  // can be computed at once.
+  const size_t refNumDesc = referenceNode.NumDescendants();
+  MatType references(referenceSet.n_rows, count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const size_t randomPoint = RandInt(firstDescendant, refNumDesc);
+    references.col(i) = referenceSet.col(referenceNode.Descendant(randomPoint));
+  }
+
+  arma::Mat<ElemType> values;
+  KernelValues(references, querySet.cols(queryIndex, queryIndex), values);
+  for (size_t i = 0; i < count; ++i)
+    sample(offset + i) = values(i, 0);
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::CalculateAlphas(
+    TreeType& referenceNode,
+    const double mcProb)
 {
-  return kernel.Evaluate(metric.Evaluate(query, reference));
+  CalculateAlpha(&referenceNode, 1 - mcProb);
+  for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
+    CalculateAlphas(referenceNode.Child(i), mcProb);
 }
 
 template<typename MetricType, typename KernelType, typename TreeType>
 inline mlpack_force_inline double KDERules<MetricType, KernelType, TreeType>::
-CalculateAlpha(TreeType* node)
+CalculateAlpha(TreeType* node, const double beta)
 {
   KDEStat& stat = node->Stat();
 
   // If new mcBeta is different from previously computed mcBeta, then alpha for
   // the node is recomputed.
-  if (std::abs(stat.MCBeta() - mcBeta) > DBL_EPSILON)
+  if (std::abs(stat.MCBeta() - beta) > DBL_EPSILON)
   {
     TreeType* parent = node->Parent();
     if (parent == NULL)
     {
       // If it's the root node then assign mcBeta.
-      stat.MCAlpha() = mcBeta;
+      stat.MCAlpha() = beta;
     }
     else
     {
@@ -562,7 +666,7 @@ CalculateAlpha(TreeType* node)
     }
 
     // Set beta value for which this alpha is valid.
-    stat.MCBeta() = mcBeta;
+    stat.MCBeta() = beta;
   }
 
   return stat.MCAlpha();
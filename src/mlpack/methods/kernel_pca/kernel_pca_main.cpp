@@ -82,7 +82,9 @@ BINDING_LONG_DESC(
     "the kernel matrix; to specify the sampling scheme, the " +
     PRINT_PARAM_STRING("sampling") + " parameter is used.  The "
     "sampling scheme for the Nystroem method can be chosen from the "
-    "following list: 'kmeans', 'random', 'ordered'.");
+    "following list: 'kmeans', 'minibatch-kmeans', 'random', 'ordered'.  "
+    "The 'minibatch-kmeans' scheme uses the centroids of mini-batch k-means, "
+    "which is much faster than 'kmeans' on large datasets.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -116,7 +118,7 @@ PARAM_FLAG("center", "If set, the transformed data will be centered about the "
 PARAM_FLAG("nystroem_method", "If set, the Nystroem method will be used.", "n");
 
 PARAM_STRING_IN("sampling", "Sampling scheme to use for the Nystroem method: "
-    "'kmeans', 'random', 'ordered'", "s", "kmeans");
+    "'kmeans', 'minibatch-kmeans', 'random', 'ordered'", "s", "kmeans");
 
 PARAM_DOUBLE_IN("kernel_scale", "Scale, for 'hyptan' kernel.", "S", 1.0);
 PARAM_DOUBLE_IN("offset", "Offset, for 'hyptan' and 'polynomial' kernels.", "O",
@@ -144,6 +146,12 @@ void RunKPCA(arma::mat& dataset,
           KMeansSelection<> > > kpca(kernel, centerTransformedData);
       kpca.Apply(dataset, newDim);
     }
+    else if (sampling == "minibatch-kmeans")
+    {
+      KernelPCA<KernelType, NystroemKernelRule<KernelType,
+          MiniBatchKMeansSelection<> > > kpca(kernel, centerTransformedData);
+      kpca.Apply(dataset, newDim);
+    }
     else if (sampling == "random")
     {
       KernelPCA<KernelType, NystroemKernelRule<KernelType,
@@ -160,7 +168,8 @@ void RunKPCA(arma::mat& dataset,
     {
       // Invalid sampling scheme.
       Log::Fatal << "Invalid sampling scheme ('" << sampling << "'); valid "
-        << "choices are 'kmeans', 'random' and 'ordered'" << endl;
+        << "choices are 'kmeans', 'minibatch-kmeans', 'random' and 'ordered'"
+        << endl;
     }
   }
   else
@@ -0,0 +1,103 @@
+/**
+ * @file methods/kmeans/blocked_assignment.hpp
+ *
+ * Utilities to find the nearest centroid of a block of points with a single
+ * matrix multiplication, for the Euclidean and squared Euclidean distances.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_BLOCKED_ASSIGNMENT_HPP
+#define MLPACK_METHODS_KMEANS_BLOCKED_ASSIGNMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+
+/**
+ * Whether the nearest centroids of points in a matrix of type MatType under
+ * the metric MetricType can be found with BlockedAssignment().  This is true
+ * for dense matrices with the Euclidean or squared Euclidean distance.
+ */
+template<typename MetricType, typename MatType>
+struct UseBlockedAssignment
+{
+  static const bool value = false;
+};
+
+template<bool TakeRoot>
+struct UseBlockedAssignment<LMetric<2, TakeRoot>, arma::mat>
+{
+  static const bool value = true;
+};
+
+//! The number of points handled by each call to BlockedAssignment() in the
+//! k-means steps that use it.
+static constexpr size_t BlockedAssignmentSize = 256;
+
+/**
+ * Find the nearest centroid of each of the points data.cols(begin, end - 1),
+ * and the squared Euclidean distance to it.  The distances between the block
+ * of points and all centroids are computed at once with the expansion
+ * ||x - c||^2 = ||x||^2 - 2 x^T c + ||c||^2, so that the inner products are a
+ * single (BLAS) matrix multiplication instead of one function call per
+ * point/centroid pair.  Since this expansion may lose some precision when
+ * points are far from the origin compared to their distances, squared
+ * distances are clamped to be non-negative.
+ *
+ * @param data Dataset.
+ * @param begin Index of the first point of the block.
+ * @param end One past the index of the last point of the block.
+ * @param centroids Centroids.
+ * @param centroidNorms Squared norm of each centroid, as given by
+ *     arma::sum(arma::square(centroids), 0).
+ * @param assignments Will be set to the index of the nearest centroid of each
+ *     point of the block.
+ * @param distances Will be set to the squared Euclidean distance between each
+ *     point of the block and its nearest centroid.
+ */
+template<typename eT>
+inline void BlockedAssignment(const arma::Mat<eT>& data,
+                              const size_t begin,
+                              const size_t end,
+                              const arma::Mat<eT>& centroids,
+                              const arma::Row<eT>& centroidNorms,
+                              arma::Row<size_t>& assignments,
+                              arma::Row<eT>& distances)
+{
+  assignments.set_size(end - begin);
+  distances.set_size(end - begin);
+  if (end == begin)
+    return;
+
+  // Each column of the tile holds the inner products of one point with every
+  // centroid, so that the minimum is taken over contiguous memory.
+  const arma::Mat<eT> products = centroids.t() * data.cols(begin, end - 1);
+
+  for (size_t p = 0; p < products.n_cols; ++p)
+  {
+    const eT* column = products.colptr(p);
+    eT minDistance = std::numeric_limits<eT>::infinity();
+    size_t closest = 0;
+    for (size_t j = 0; j < products.n_rows; ++j)
+    {
+      const eT distance = centroidNorms[j] - 2 * column[j];
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closest = j;
+      }
+    }
+
+    const eT pointNorm = arma::dot(data.col(begin + p), data.col(begin + p));
+    assignments[p] = closest;
+    distances[p] = std::max(pointNorm + minDistance, eT(0));
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * @file methods/kmeans/distributed_kmeans.hpp
+ *
+ * A driver for k-means clustering of a dataset whose points are sharded across
+ * several processes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+
+#include <mlpack/core.hpp>
+
+#include "kmeans_parallel_initialization.hpp"
+#include "naive_kmeans.hpp"
+#include "elkan_kmeans.hpp"
+
+namespace mlpack {
+
+/**
+ * DistributedKMeans runs data-parallel k-means clustering on a dataset whose
+ * points are sharded across several processes, given an all-reduce policy (see
+ * LocalAllReduce and MPIAllReduce).  Every process calls Cluster() with its own
+ * shard, and every process gets the same centroids.
+ *
+ * The centroids are initialized with the distributed version of k-means||
+ * (KMeansParallelInitialization).  Then in each iteration, every process runs
+ * one Lloyd step of the given type on its shard, and the sums and counts of
+ * the points of each cluster are summed over the processes to give the new
+ * centroids.  Only the centroids, their sums and counts, and the k-means||
+ * candidates are communicated; the points never are.  A cluster with no points
+ * on any process keeps its centroid.
+ *
+ * The Lloyd step type must compute the means of the points assigned to each
+ * centroid from the given centroids only, or, like ElkanKMeans, update the
+ * state it keeps between iterations from the centroids it is given, since
+ * these are the global means and not the ones it computed; NaiveKMeans and
+ * ElkanKMeans can be used.
+ *
+ * @code
+ * MPI_Init(&argc, &argv);
+ *
+ * // Each process loads its own shard of the points.
+ * arma::mat data;
+ * // ...
+ *
+ * DistributedKMeans<MPIAllReduce> k(100);
+ * arma::mat centroids;
+ * arma::Row<size_t> assignments;
+ * k.Cluster(data, 10, assignments, centroids);
+ * // The centroids are the same on every process; the assignments are those of
+ * // the points of the shard.
+ *
+ * MPI_Finalize();
+ * @endcode
+ *
+ * @tparam AllReduceType All-reduce policy over the processes.
+ * @tparam MetricType The distance metric to use.
+ * @tparam LloydStepType Implementation of a single Lloyd step of each process.
+ * @tparam MatType Type of the data matrix.
+ */
+template<typename AllReduceType = LocalAllReduce,
+         typename MetricType = EuclideanDistance,
+         template<class, class> class LloydStepType = NaiveKMeans,
+         typename MatType = arma::mat>
+class DistributedKMeans
+{
+ public:
+  /**
+   * Create the DistributedKMeans object.
+   *
+   * @param maxIterations Maximum number of iterations allowed before giving up
+   *     (0 is valid, but the algorithm may never terminate).
+   * @param allReduce All-reduce policy over the processes.
+   * @param metric Instantiated distance metric.
+   * @param initialization Instantiated k-means|| initialization.
+   */
+  DistributedKMeans(const size_t maxIterations = 1000,
+                    const AllReduceType& allReduce = AllReduceType(),
+                    const MetricType metric = MetricType(),
+                    const KMeansParallelInitialization initialization =
+                        KMeansParallelInitialization());
+
+  /**
+   * Cluster the dataset sharded across the processes, returning the centroids
+   * of each cluster.  Optionally, the initial centroids can be given by filling
+   * the centroids matrix with them (identically on every process) and setting
+   * initialGuess to true.
+   *
+   * @param data Shard of the dataset of this process, which must not be empty.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains the
+   *      initial cluster centroids.
+   */
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  /**
+   * Cluster the dataset sharded across the processes, returning the centroids
+   * of each cluster and the cluster of each point of the shard of this process.
+   *
+   * @param data Shard of the dataset of this process, which must not be empty.
+   * @param clusters Number of clusters to compute.
+   * @param assignments Vector to store the cluster of each point of the shard
+   *      in.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains the
+   *      initial cluster centroids.
+   */
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::Row<size_t>& assignments,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the all-reduce policy.
+  const AllReduceType& AllReduce() const { return allReduce; }
+  //! Modify the all-reduce policy.
+  AllReduceType& AllReduce() { return allReduce; }
+
+  //! Get the distance metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the distance metric.
+  MetricType& Metric() { return metric; }
+
+  //! Get the k-means|| initialization.
+  const KMeansParallelInitialization& Initialization() const
+  { return initialization; }
+  //! Modify the k-means|| initialization.
+  KMeansParallelInitialization& Initialization() { return initialization; }
+
+ private:
+  //! Maximum number of iterations before giving up.
+  size_t maxIterations;
+  //! All-reduce policy over the processes.
+  AllReduceType allReduce;
+  //! Instantiated distance metric.
+  MetricType metric;
+  //! Instantiated k-means|| initialization.
+  KMeansParallelInitialization initialization;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_kmeans_impl.hpp"
+
+#endif
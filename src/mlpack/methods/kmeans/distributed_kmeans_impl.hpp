@@ -0,0 +1,177 @@
+/**
+ * @file methods/kmeans/distributed_kmeans_impl.hpp
+ *
+ * Implementation of distributed data-parallel k-means clustering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_kmeans.hpp"
+
+namespace mlpack {
+
+template<typename AllReduceType,
+         typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+DistributedKMeans<AllReduceType, MetricType, LloydStepType, MatType>::
+DistributedKMeans(const size_t maxIterations,
+                  const AllReduceType& allReduce,
+                  const MetricType metric,
+                  const KMeansParallelInitialization initialization) :
+    maxIterations(maxIterations),
+    allReduce(allReduce),
+    metric(metric),
+    initialization(initialization)
+{
+  // Nothing to do.
+}
+
+template<typename AllReduceType,
+         typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<AllReduceType, MetricType, LloydStepType, MatType>::
+Cluster(const MatType& data,
+        const size_t clusters,
+        arma::mat& centroids,
+        const bool initialGuess)
+{
+  if (data.n_cols == 0)
+  {
+    throw std::invalid_argument("DistributedKMeans::Cluster(): the shard of "
+        "the dataset is empty!");
+  }
+
+  if (clusters == 0)
+  {
+    throw std::invalid_argument("DistributedKMeans::Cluster(): the number of "
+        "clusters must be positive!");
+  }
+
+  if (initialGuess)
+  {
+    util::CheckSameSizes(centroids, clusters, "DistributedKMeans::Cluster()",
+        "clusters");
+    util::CheckSameDimensionality(data, centroids,
+        "DistributedKMeans::Cluster()");
+  }
+  else
+  {
+    initialization.Cluster(data, clusters, centroids, allReduce);
+  }
+
+  LloydStepType<MetricType, MatType> lloydStep(data, metric);
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+
+  // The last row holds the counts of the clusters.
+  arma::mat sums(data.n_rows + 1, clusters);
+
+  size_t iteration = 0;
+  double cNorm;
+  do
+  {
+    lloydStep.Iterate(centroids, newCentroids, counts);
+
+    // The step gives the means of the clusters over this shard, which are
+    // turned back into sums so that they can be added over the shards.
+    for (size_t c = 0; c < clusters; ++c)
+    {
+      if (counts[c] > 0)
+        sums.col(c).head(data.n_rows) = newCentroids.col(c) * counts[c];
+      else
+        sums.col(c).head(data.n_rows).zeros();
+      sums(data.n_rows, c) = counts[c];
+    }
+    allReduce.Sum(sums);
+
+    cNorm = 0.0;
+    for (size_t c = 0; c < clusters; ++c)
+    {
+      if (sums(data.n_rows, c) > 0.0)
+      {
+        newCentroids.col(c) = sums.col(c).head(data.n_rows) /
+            sums(data.n_rows, c);
+      }
+      else
+      {
+        Log::Info << "Cluster " << c << " is empty.\n";
+        newCentroids.col(c) = centroids.col(c);
+      }
+
+      cNorm += std::pow(metric.Evaluate(centroids.col(c), newCentroids.col(c)),
+          2.0);
+    }
+    cNorm = std::sqrt(cNorm);
+    centroids.swap(newCentroids);
+
+    iteration++;
+    Log::Info << "DistributedKMeans::Cluster(): iteration " << iteration
+        << ", residual " << cNorm << ".\n";
+    if (std::isnan(cNorm) || std::isinf(cNorm))
+      cNorm = 1e-4; // Keep iterating.
+  } while (cNorm > 1e-5 && iteration != maxIterations);
+
+  if (iteration != maxIterations)
+  {
+    Log::Info << "DistributedKMeans::Cluster(): converged after " << iteration
+        << " iterations." << std::endl;
+  }
+  else
+  {
+    Log::Info << "DistributedKMeans::Cluster(): terminated after limit of "
+        << iteration << " iterations." << std::endl;
+  }
+  Log::Info << lloydStep.DistanceCalculations() << " distance calculations on "
+      << "this shard." << std::endl;
+}
+
+template<typename AllReduceType,
+         typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<AllReduceType, MetricType, LloydStepType, MatType>::
+Cluster(const MatType& data,
+        const size_t clusters,
+        arma::Row<size_t>& assignments,
+        arma::mat& centroids,
+        const bool initialGuess)
+{
+  Cluster(data, clusters, centroids, initialGuess);
+
+  // Calculate final assignments in parallel over the shard.
+  assignments.set_size(data.n_cols);
+
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+  {
+    // Find the closest centroid to this point.
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(data.col(i), centroids.col(j));
+
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    assignments[i] = closestCluster;
+  }
+}
+
+} // namespace mlpack
+
+#endif
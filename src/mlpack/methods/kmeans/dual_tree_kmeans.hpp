@@ -18,6 +18,7 @@
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traversal.hpp>
 
 #include "dual_tree_kmeans_statistic.hpp"
 
@@ -29,6 +30,14 @@ namespace mlpack {
  * dataset.  The conditions under which this will perform best are probably
  * limited to the case where k is close to the number of points in the dataset,
  * and the number of iterations of the k-means algorithm will be few.
+ *
+ * If mlpack is compiled with OpenMP, each iteration runs in parallel: the
+ * tree of centroids is built in parallel (for trees that support it), the tree
+ * of points is split into disjoint subtrees that are traversed against the
+ * centroid tree in separate tasks (see ParallelDualTreeTraversal()), and the
+ * bounds of large subtrees are updated in separate tasks.  Since no randomness
+ * is involved and the result is the exact Lloyd iteration, the result does not
+ * depend on the number of threads.
  */
 template<
     typename MetricType,
@@ -96,12 +105,14 @@ class DualTreeKMeans
   arma::vec upperBounds;
   //! Lower bounds on second closest cluster distance for each point.
   arma::vec lowerBounds;
-  //! Indicator of whether or not the point is pruned.
-  std::vector<bool> prunedPoints;
+  //! Indicator of whether or not the point is pruned.  (This is not a
+  //! std::vector<bool>, so that different threads can write different
+  //! points.)
+  std::vector<char> prunedPoints;
 
   arma::Row<size_t> assignments;
 
-  std::vector<bool> visited; // Was the point visited this iteration?
+  std::vector<char> visited; // Was the point visited this iteration?
 
   arma::mat lastIterationCentroids; // For sanity checks.
 
@@ -124,6 +135,10 @@ class DualTreeKMeans
                         arma::Col<size_t>& newCounts,
                         const arma::mat& centroids);
 
+  //! Subtrees with fewer descendants than this are updated in the same task
+  //! as their parent by UpdateTree() and DecoalesceTree().
+  static constexpr size_t TaskCutoff = 1024;
+
   void CoalesceTree(Tree& node, const size_t child = 0);
   void DecoalesceTree(Tree& node);
 };
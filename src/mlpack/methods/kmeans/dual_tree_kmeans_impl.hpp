@@ -131,10 +131,14 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
       delete interclusterDistancesTemp;
     }
 
-    UpdateTree(*tree, centroids);
+    // Large subtrees are updated in separate tasks.
+    #pragma omp parallel num_threads((int) NumThreads())
+    {
+      #pragma omp single
+      UpdateTree(*tree, centroids);
+    }
 
-    for (size_t i = 0; i < dataset.n_cols; ++i)
-      visited[i] = false;
+    std::fill(visited.begin(), visited.end(), false);
   }
   else
   {
@@ -146,21 +150,49 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   // We won't use the KNN class here because we have our own set of rules.
   lastIterationCentroids = centroids;
   typedef DualTreeKMeansRules<MetricType, Tree> RuleType;
-  RuleType rules(nns.ReferenceTree().Dataset(), dataset, assignments,
-      upperBounds, lowerBounds, metric, prunedPoints, oldFromNewCentroids,
-      visited);
-
-  typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
-      traverser(rules);
 
   CoalesceTree(*tree);
 
   // Set the number of pruned centroids in the root to 0.
   tree->Stat().Pruned() = 0;
-  traverser.Traverse(*tree, nns.ReferenceTree());
-  distanceCalculations += rules.BaseCases() + rules.Scores();
 
-  DecoalesceTree(*tree);
+  // Split the tree into disjoint subtrees that are traversed in parallel.  The
+  // nodes above the subtrees are not traversed, so they must look like the
+  // root to the rules: nothing is pruned for them.  Each subtree only touches
+  // the statistics of its own nodes and the bounds of its own points.
+  const std::vector<Tree*> subtrees = tree->Stat().StaticPruned() ?
+      std::vector<Tree*>(1, tree) :
+      SplitQueryTree(*tree, NumParallelTasks(tree->NumDescendants()));
+  for (size_t i = 0; i < subtrees.size(); ++i)
+  {
+    for (Tree* node = subtrees[i]->Parent(); node != NULL;
+        node = node->Parent())
+    {
+      if (node->Stat().Pruned() == size_t(-1))
+        node->Stat().Pruned() = 0;
+    }
+  }
+
+  ParallelDualTreeTraversal(subtrees, [&](Tree& queryNode)
+      {
+        RuleType rules(nns.ReferenceTree().Dataset(), dataset, assignments,
+            upperBounds, lowerBounds, metric, prunedPoints,
+            oldFromNewCentroids, visited);
+
+        typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
+            traverser(rules);
+        traverser.Traverse(queryNode, nns.ReferenceTree());
+
+        #pragma omp critical
+        distanceCalculations += rules.BaseCases() + rules.Scores();
+      });
+
+  // Subtrees are decoalesced in separate tasks.
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    #pragma omp single
+    DecoalesceTree(*tree);
+  }
 
   // Now we need to extract the clusters.
   newCentroids.zeros(centroids.n_rows, centroids.n_cols);
@@ -319,6 +351,7 @@ visited[node.Descendant(i)] << ".\n";
                    node.MaxDistance(centroids.col(node.Stat().Owner())));
       adjustedUpperBound = node.Stat().UpperBound();
 
+      #pragma omp atomic
       ++distanceCalculations;
       if (node.Stat().UpperBound() < node.Stat().LowerBound())
         node.Stat().StaticPruned() = true;
@@ -330,15 +363,22 @@ visited[node.Descendant(i)] << ".\n";
   }
 
   // Recurse into children, and if all the children (and all the points) are
-  // pruned, then we can mark this as statically pruned.
-  bool allChildrenPruned = true;
+  // pruned, then we can mark this as statically pruned.  The children only
+  // touch their own subtrees and points, so large children are updated in
+  // separate tasks.
   for (size_t i = 0; i < node.NumChildren(); ++i)
   {
+    #pragma omp task if (node.Child(i).NumDescendants() >= TaskCutoff) \
+        default(shared) firstprivate(i)
     UpdateTree(node.Child(i), centroids, unadjustedUpperBound,
         adjustedUpperBound, unadjustedLowerBound, adjustedLowerBound);
+  }
+  #pragma omp taskwait
+
+  bool allChildrenPruned = true;
+  for (size_t i = 0; i < node.NumChildren(); ++i)
     if (!node.Child(i).Stat().StaticPruned())
       allChildrenPruned = false;
-  }
 
   bool allPointsPruned = true;
   if (TreeTraits<Tree>::HasSelfChildren && node.NumChildren() > 0)
@@ -391,6 +431,7 @@ visited[node.Descendant(i)] << ".\n";
         // Attempt to tighten the bound.
         upperBounds[index] = metric.Evaluate(dataset.col(index),
                                              centroids.col(owner));
+        #pragma omp atomic
         ++distanceCalculations;
         if (upperBounds[index] < pruningLowerBound)
         {
@@ -615,7 +656,12 @@ void DualTreeKMeans<MetricType, MatType, TreeType>::DecoalesceTree(Tree& node)
   RestoreChildren(node);
 
   for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    #pragma omp task if (node.Child(i).NumDescendants() >= TaskCutoff) \
+        default(shared) firstprivate(i)
     DecoalesceTree(node.Child(i));
+  }
+  #pragma omp taskwait
 }
 
 //! Utility function for hiding children in a non-binary tree.
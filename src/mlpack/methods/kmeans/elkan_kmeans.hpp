@@ -20,8 +20,20 @@ class ElkanKMeans
  public:
   /**
    * Construct the ElkanKMeans object, which must store several sets of bounds.
+   * The lower bounds take k * N floats; if maxBoundMemory is given, only as
+   * many points as fit in that many bytes get lower bounds, and the other
+   * points are pruned with the upper bounds and the distances between
+   * centroids only.  To use a memory limit with KMeans, derive a step type
+   * whose constructor passes it here.
+   *
+   * @param dataset Dataset to cluster.
+   * @param metric Instantiated metric.
+   * @param maxBoundMemory Maximum memory used for lower bounds, in bytes (0
+   *     means no limit).
    */
-  ElkanKMeans(const MatType& dataset, MetricType& metric);
+  ElkanKMeans(const MatType& dataset,
+              MetricType& metric,
+              const size_t maxBoundMemory = 0);
 
   /**
    * Run a single iteration of Elkan's algorithm, updating the given centroids
@@ -37,7 +49,14 @@ class ElkanKMeans
 
   size_t DistanceCalculations() const { return distanceCalculations; }
 
+  //! Get the maximum memory used for lower bounds, in bytes (0 is no limit).
+  size_t MaxBoundMemory() const { return maxBoundMemory; }
+
  private:
+  //! Round the given lower bound down to the nearest float, so that it is
+  //! still a valid bound.
+  static float LowerBound(const double bound);
+
   //! The dataset.
   const MatType& dataset;
   //! The instantiated metric.
@@ -53,8 +72,16 @@ class ElkanKMeans
 
   //! Upper bounds on the distance between each point and its closest cluster.
   arma::vec upperBounds;
-  //! Lower bounds on the distance between each point and each cluster.
-  arma::mat lowerBounds;
+  //! Lower bounds on the distance between each point and each cluster, for
+  //! the first boundedPoints points.  These are stored as floats to halve their
+  //! memory.
+  arma::fmat lowerBounds;
+  //! The maximum memory used for lower bounds, in bytes (0 is no limit).
+  size_t maxBoundMemory;
+  //! The number of points that have lower bounds.
+  size_t boundedPoints;
+  //! The centroids of the last iteration, which the bounds are relative to.
+  arma::mat lastCentroids;
 
   //! Track distance calculations.
   size_t distanceCalculations;
@@ -19,14 +19,30 @@ namespace mlpack {
 
 template<typename MetricType, typename MatType>
 ElkanKMeans<MetricType, MatType>::ElkanKMeans(const MatType& dataset,
-                                              MetricType& metric) :
+                                              MetricType& metric,
+                                              const size_t maxBoundMemory) :
     dataset(dataset),
     metric(metric),
+    maxBoundMemory(maxBoundMemory),
+    boundedPoints(0),
     distanceCalculations(0)
 {
   // Nothing to do here.
 }
 
+template<typename MetricType, typename MatType>
+inline float ElkanKMeans<MetricType, MatType>::LowerBound(const double bound)
+{
+  // The conversion may round up, which would make the bound invalid.
+  if (bound >= (double) std::numeric_limits<float>::max())
+    return std::numeric_limits<float>::max();
+
+  float result = (float) bound;
+  if ((double) result > bound)
+    result = std::nextafter(result, -std::numeric_limits<float>::infinity());
+  return result;
+}
+
 // Run a single iteration of Elkan's algorithm for Lloyd iterations.
 template<typename MetricType, typename MatType>
 double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
@@ -45,60 +61,111 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // being the closest cluster centroid.
   clusterDistances.diag().fill(DBL_MAX);
 
-  // Initially set r(x) to true.
-  std::vector<bool> mustRecalculate(dataset.n_cols, true);
-
-  // If this is the first iteration, we must reset all the bounds.
-  if (lowerBounds.n_rows != centroids.n_cols)
+  // If this is the first iteration, we must reset all the bounds.  If the
+  // lower bounds of all points do not fit in maxBoundMemory, only the first
+  // points get lower bounds; the lower bounds of the others are taken to be 0.
+  if (upperBounds.n_elem != dataset.n_cols ||
+      lowerBounds.n_rows != centroids.n_cols)
   {
-    lowerBounds.set_size(centroids.n_cols, dataset.n_cols);
-    assignments.set_size(dataset.n_cols);
-    upperBounds.set_size(dataset.n_cols);
+    boundedPoints = dataset.n_cols;
+    if (maxBoundMemory > 0 && centroids.n_cols > 0)
+    {
+      boundedPoints = std::min(boundedPoints,
+          (size_t) (maxBoundMemory / (centroids.n_cols * sizeof(float))));
+    }
 
-    lowerBounds.fill(0);
+    lowerBounds.zeros(centroids.n_cols, boundedPoints);
+    assignments.zeros(dataset.n_cols);
+    upperBounds.set_size(dataset.n_cols);
     upperBounds.fill(DBL_MAX);
-    assignments.fill(0);
   }
+  else
+  {
+    // The bounds are relative to the centroids of the last iteration, which
+    // may have been changed after it (for instance, by an empty cluster policy,
+    // or by DistributedKMeans), so update them with how far the given
+    // centroids actually are from those.
+    arma::vec moveDistances(centroids.n_cols);
+    for (size_t c = 0; c < centroids.n_cols; ++c)
+      moveDistances(c) = metric.Evaluate(centroids.col(c),
+          lastCentroids.col(c));
+    distanceCalculations += centroids.n_cols;
+
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t i = 0; i < (size_t) dataset.n_cols; ++i)
+    {
+      // Step 5: for each point x and center c, assign
+      //   l(x, c) = max { l(x, c) - d(c, m(c)), 0 }.
+      // But it doesn't actually matter if l(x, c) is positive.
+      if (i < boundedPoints)
+      {
+        for (size_t c = 0; c < centroids.n_cols; ++c)
+        {
+          lowerBounds(c, i) = LowerBound((double) lowerBounds(c, i) -
+              moveDistances(c));
+        }
+      }
+
+      // Step 6: for each point x, assign
+      //   u(x) = u(x) + d(m(c(x)), c(x))
+      //   r(x) = true (we are setting that at the start of every iteration).
+      upperBounds(i) += moveDistances(assignments[i]);
+    }
+  }
+  lastCentroids = centroids;
 
   // Step 1: for all centers, compute between-cluster distances.  For all
   // centers, compute s(c) = 1/2 min d(c, c').
-  for (size_t i = 0; i < centroids.n_cols; ++i)
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t i = 0; i < (size_t) centroids.n_cols; ++i)
   {
     for (size_t j = i + 1; j < centroids.n_cols; ++j)
     {
       const double distance = metric.Evaluate(centroids.col(i),
                                               centroids.col(j));
-      distanceCalculations++;
       clusterDistances(i, j) = distance;
       clusterDistances(j, i) = distance;
     }
   }
+  distanceCalculations += centroids.n_cols * (centroids.n_cols - 1) / 2;
 
   // Now find the closest cluster to each other cluster.  We multiply by 0.5 so
   // that this is equivalent to s(c) for each cluster c.
   minClusterDistances = 0.5 * min(clusterDistances).t();
 
-  // Now loop over all points, and see which ones need to be updated.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Now loop over all points, and see which ones need to be updated.  Each
+  // thread only modifies the bounds of its own points, and accumulates its own
+  // centroids.
+  #pragma omp parallel num_threads((int) NumThreads())
   {
-    // Step 2: identify all points such that u(x) <= s(c(x)).
-    if (upperBounds(i) <= minClusterDistances(assignments[i]))
-    {
-      // No change needed.  This point must still belong to that cluster.
-      counts(assignments[i])++;
-      newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-      continue;
-    }
-    else
+    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+    size_t localDistanceCalculations = 0;
+
+    #pragma omp for schedule(dynamic, 256)
+    for (size_t i = 0; i < (size_t) dataset.n_cols; ++i)
     {
+      // Step 2: identify all points such that u(x) <= s(c(x)).
+      if (upperBounds(i) <= minClusterDistances(assignments[i]))
+      {
+        // No change needed.  This point must still belong to that cluster.
+        localCounts(assignments[i])++;
+        localCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+        continue;
+      }
+
+      const bool bounded = (i < boundedPoints);
+      bool mustRecalculate = true;
       for (size_t c = 0; c < centroids.n_cols; ++c)
       {
-        // Step 3: for all remaining points x and centers c such that c != c(x),
-        // u(x) > l(x, c) and u(x) > 0.5 d(c(x), c)...
+        // Step 3: for all remaining points x and centers c such that
+        // c != c(x), u(x) > l(x, c) and u(x) > 0.5 d(c(x), c)...
         if (assignments[i] == c)
           continue; // Pruned because this cluster is already the assignment.
 
-        if (upperBounds(i) <= lowerBounds(c, i))
+        const double lowerBound = bounded ? lowerBounds(c, i) : 0.0;
+        if (upperBounds(i) <= lowerBound)
           continue; // Pruned by triangle inequality on lower bound.
 
         if (upperBounds(i) <= 0.5 * clusterDistances(assignments[i], c))
@@ -107,16 +174,18 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
         // Step 3a: if r(x) then compute d(x, c(x)) and assign r(x) = false.
         // Otherwise, d(x, c(x)) = u(x).
         double dist;
-        if (mustRecalculate[i])
+        if (mustRecalculate)
         {
-          mustRecalculate[i] = false;
-          dist = metric.Evaluate(dataset.col(i), centroids.col(assignments[i]));
-          lowerBounds(assignments[i], i) = dist;
+          mustRecalculate = false;
+          dist = metric.Evaluate(dataset.col(i),
+              centroids.col(assignments[i]));
+          if (bounded)
+            lowerBounds(assignments[i], i) = LowerBound(dist);
           upperBounds(i) = dist;
-          distanceCalculations++;
+          localDistanceCalculations++;
 
           // Check if we can prune again.
-          if (upperBounds(i) <= lowerBounds(c, i))
+          if (upperBounds(i) <= lowerBound)
             continue; // Pruned by triangle inequality on lower bound.
 
           if (upperBounds(i) <= 0.5 * clusterDistances(assignments[i], c))
@@ -128,14 +197,15 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
         }
 
         // Step 3b: if d(x, c(x)) > l(x, c) or d(x, c(x)) > 0.5 d(c(x), c)...
-        if (dist > lowerBounds(c, i) ||
+        if (dist > lowerBound ||
             dist > 0.5 * clusterDistances(assignments[i], c))
         {
           // Compute d(x, c).  If d(x, c) < d(x, c(x)) then assign c(x) = c.
           const double pointDist = metric.Evaluate(dataset.col(i),
                                                    centroids.col(c));
-          lowerBounds(c, i) = pointDist;
-          distanceCalculations++;
+          if (bounded)
+            lowerBounds(c, i) = LowerBound(pointDist);
+          localDistanceCalculations++;
           if (pointDist < dist)
           {
             upperBounds(i) = pointDist;
@@ -143,42 +213,35 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
           }
         }
       }
+
+      // At this point, we know the new cluster assignment.
+      // Step 4: for each center c, let m(c) be the mean of the points assigned
+      // to c.
+      localCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+      localCounts[assignments[i]]++;
     }
 
-    // At this point, we know the new cluster assignment.
-    // Step 4: for each center c, let m(c) be the mean of the points assigned to
-    // c.
-    newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-    counts[assignments[i]]++;
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+      distanceCalculations += localDistanceCalculations;
+    }
   }
 
-  // Now, normalize and calculate the distance each cluster has moved.
-  arma::vec moveDistances(centroids.n_cols);
+  // Now, normalize and calculate the distance each cluster has moved.  The
+  // bounds are only updated at the start of the next iteration.
   double cNorm = 0.0; // Cluster movement for residual.
   for (size_t c = 0; c < centroids.n_cols; ++c)
   {
     if (counts[c] > 0)
       newCentroids.col(c) /= counts[c];
 
-    moveDistances(c) = metric.Evaluate(newCentroids.col(c), centroids.col(c));
-    cNorm += std::pow(moveDistances(c), 2.0);
+    cNorm += std::pow(metric.Evaluate(newCentroids.col(c), centroids.col(c)),
+        2.0);
     distanceCalculations++;
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
-  {
-    // Step 5: for each point x and center c, assign
-    //   l(x, c) = max { l(x, c) - d(c, m(c)), 0 }.
-    // But it doesn't actually matter if l(x, c) is positive.
-    for (size_t c = 0; c < centroids.n_cols; ++c)
-      lowerBounds(c, i) -= moveDistances(c);
-
-    // Step 6: for each point x, assign
-    //   u(x) = u(x) + d(m(c(x)), c(x))
-    //   r(x) = true (we are setting that at the start of every iteration).
-    upperBounds(i) += moveDistances(assignments[i]);
-  }
-
   return std::sqrt(cNorm);
 }
 
@@ -17,6 +17,7 @@
 // Include initialization strategies.
 #include "sample_initialization.hpp"
 #include "kmeans_plus_plus_initialization.hpp"
+#include "kmeans_parallel_initialization.hpp"
 #include "random_partition.hpp"
 
 // Include empty cluster policies.
@@ -29,7 +30,9 @@
 #include "dual_tree_kmeans.hpp"
 #include "elkan_kmeans.hpp"
 #include "hamerly_kmeans.hpp"
+#include "yinyang_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
+#include "minibatch_kmeans.hpp"
 
 namespace mlpack {
 
@@ -209,4 +212,7 @@ class KMeans
 // afterwards.
 #include "refined_start.hpp"
 
+// Streaming k-means uses the initialization utilities of KMeans.
+#include "streaming_kmeans.hpp"
+
 #endif // MLPACK_METHODS_KMEANS_KMEANS_HPP
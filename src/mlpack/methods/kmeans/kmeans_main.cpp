@@ -21,10 +21,14 @@
 #include "kill_empty_clusters.hpp"
 #include "refined_start.hpp"
 #include "kmeans_plus_plus_initialization.hpp"
+#include "kmeans_parallel_initialization.hpp"
 #include "elkan_kmeans.hpp"
 #include "hamerly_kmeans.hpp"
+#include "yinyang_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
 #include "dual_tree_kmeans.hpp"
+#include "minibatch_kmeans.hpp"
+#include "streaming_kmeans.hpp"
 
 using namespace mlpack;
 using namespace mlpack::util;
@@ -49,7 +53,13 @@ BINDING_LONG_DESC(
     "\n\n"
     "Optionally, the strategy to choose initial centroids can be specified.  "
     "The k-means++ algorithm can be used to choose initial centroids with "
-    "the " + PRINT_PARAM_STRING("kmeans_plus_plus") + " parameter.  The "
+    "the " + PRINT_PARAM_STRING("kmeans_plus_plus") + " parameter, and its "
+    "scalable variant k-means|| (which makes only a few passes over the data, "
+    "and is much faster for large k) with the " +
+    PRINT_PARAM_STRING("kmeans_parallel") + " parameter; the number of passes "
+    "and the number of candidates chosen in each pass can be controlled with "
+    "the " + PRINT_PARAM_STRING("kmeans_parallel_rounds") + " and " +
+    PRINT_PARAM_STRING("oversampling") + " parameters.  The "
     "Bradley and Fayyad approach (\"Refining initial points for k-means "
     "clustering\", 1998) can be used to select initial points by specifying "
     "the " + PRINT_PARAM_STRING("refined_start") + " parameter.  This approach "
@@ -64,9 +74,14 @@ BINDING_LONG_DESC(
     " option.  The standard O(kN) approach can be used ('naive').  Other "
     "options include the Pelleg-Moore tree-based algorithm ('pelleg-moore'), "
     "Elkan's triangle-inequality based algorithm ('elkan'), Hamerly's "
-    "modification to Elkan's algorithm ('hamerly'), the dual-tree k-means "
-    "algorithm ('dualtree'), and the dual-tree k-means algorithm using the "
-    "cover tree ('dualtree-covertree')."
+    "modification to Elkan's algorithm ('hamerly'), Yinyang k-means, which "
+    "keeps a lower bound for each group of about 10 centroids ('yinyang'), "
+    "the dual-tree k-means algorithm ('dualtree'), the dual-tree k-means "
+    "algorithm using the cover tree ('dualtree-covertree'), and mini-batch "
+    "k-means ('minibatch'). "
+    "Mini-batch k-means updates the centroids with a random sample of 1024 "
+    "points in each iteration instead of the whole dataset, so each iteration "
+    "is much cheaper for large datasets, but the result is only approximate."
     "\n\n"
     "The behavior for when an empty cluster is encountered can be modified with"
     " the " + PRINT_PARAM_STRING("allow_empty_clusters") + " option.  When "
@@ -81,6 +96,17 @@ BINDING_LONG_DESC(
     "calculate; therefore, specifying either of these parameters will often "
     "accelerate runtime."
     "\n\n"
+    "Datasets that do not fit in memory can be clustered in streaming mode, "
+    "by giving the name of a CSV, TSV or ASCII file with the " +
+    PRINT_PARAM_STRING("input_file") + " parameter instead of " +
+    PRINT_PARAM_STRING("input") + ".  The file is then read in chunks of " +
+    PRINT_PARAM_STRING("chunk_size") + " points, and each iteration is a pass "
+    "over the file; the initial centroids are chosen from the first chunk.  "
+    "In this mode, the assignment of each point is written to the file given "
+    "with the " + PRINT_PARAM_STRING("assignments_file") + " parameter (one "
+    "per line), empty clusters keep their centroid, and the " +
+    PRINT_PARAM_STRING("algorithm") + " parameter is ignored."
+    "\n\n"
     "Initial clustering assignments may be specified using the " +
     PRINT_PARAM_STRING("initial_centroids") + " parameter, and the maximum "
     "number of iterations may be specified with the " +
@@ -122,8 +148,15 @@ BINDING_SEE_ALSO("A dual-tree algorithm for fast k-means clustering with large "
 BINDING_SEE_ALSO("KMeans class documentation",
     "@src/mlpack/methods/kmeans/kmeans.hpp");
 
+// Input options.
+PARAM_MATRIX_IN("input", "Input dataset to perform clustering on.", "i");
+PARAM_STRING_IN("input_file", "File containing the input dataset to cluster in "
+    "streaming mode, without loading it into memory (instead of --input).",
+    "", "");
+PARAM_INT_IN("chunk_size", "Number of points to load at once in streaming "
+    "mode (use when --input_file is specified).", "", 100000);
+
 // Required options.
-PARAM_MATRIX_IN_REQ("input", "Input dataset to perform clustering on.", "i");
 PARAM_INT_IN_REQ("clusters", "Number of clusters to find (0 autodetects from "
     "initial centroids).", "c");
 
@@ -135,6 +168,9 @@ PARAM_MATRIX_OUT("output", "Matrix to store output labels or labeled data to.",
     "o");
 PARAM_MATRIX_OUT("centroid", "If specified, the centroids of each cluster will "
     " be written to the given file.", "C");
+PARAM_STRING_IN("assignments_file", "File to write the cluster assignment of "
+    "each point to, one per line, in streaming mode (use when --input_file is "
+    "specified).", "", "");
 
 // k-means configuration options.
 PARAM_FLAG("allow_empty_clusters", "Allow empty clusters to be persist.", "e");
@@ -157,9 +193,18 @@ PARAM_DOUBLE_IN("percentage", "Percentage of dataset to use for each refined "
 PARAM_FLAG("kmeans_plus_plus", "Use the k-means++ initialization strategy to "
     "choose initial points.", "K");
 
+// Parameters for k-means||.
+PARAM_FLAG("kmeans_parallel", "Use the k-means|| (scalable k-means++) "
+    "initialization strategy to choose initial points.", "");
+PARAM_INT_IN("kmeans_parallel_rounds", "Number of sampling rounds for "
+    "k-means|| (use when --kmeans_parallel is specified).", "", 5);
+PARAM_DOUBLE_IN("oversampling", "Expected number of candidates sampled in each "
+    "k-means|| round, as a multiple of the number of clusters (use when "
+    "--kmeans_parallel is specified).", "", 2.0);
+
 PARAM_STRING_IN("algorithm", "Algorithm to use for the Lloyd iteration "
-    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', or "
-    "'dualtree-covertree').", "a", "naive");
+    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'yinyang', 'dualtree', "
+    "'dualtree-covertree', or 'minibatch').", "a", "naive");
 
 // Given the type of initial partition policy, figure out the empty cluster
 // policy and run k-means.
@@ -168,6 +213,13 @@ void FindEmptyClusterPolicy(util::Params& params,
                             util::Timers& timers,
                             const InitialPartitionPolicy& ipp);
 
+// Given the type of initial partition policy, run k-means over chunks of the
+// input file.
+template<typename InitialPartitionPolicy>
+void RunStreamingKMeans(util::Params& params,
+                        util::Timers& timers,
+                        const InitialPartitionPolicy& ipp);
+
 // Given the initial partitionining policy and empty cluster policy, figure out
 // the Lloyd iteration step type and run k-means.
 template<typename InitialPartitionPolicy, typename EmptyClusterPolicy>
@@ -191,7 +243,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   else
     RandomSeed((size_t) std::time(NULL));
 
-  RequireOnlyOnePassed(params, { "refined_start", "kmeans_plus_plus" }, true,
+  RequireOnlyOnePassed(params, { "input", "input_file" }, true);
+
+  RequireOnlyOnePassed(params, { "refined_start", "kmeans_plus_plus",
+      "kmeans_parallel" }, true,
       "Only one initialization strategy can be specified!", true);
 
   // Now, start building the KMeans type that we'll be using.  Start with the
@@ -215,6 +270,19 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     FindEmptyClusterPolicy<KMeansPlusPlusInitialization>(params, timers,
         KMeansPlusPlusInitialization());
   }
+  else if (params.Has("kmeans_parallel"))
+  {
+    RequireParamValue<int>(params, "kmeans_parallel_rounds",
+        [](int x) { return x > 0; }, true, "number of k-means|| rounds must be "
+        "positive");
+    RequireParamValue<double>(params, "oversampling",
+        [](double x) { return x > 0.0; }, true, "oversampling factor must be "
+        "positive");
+
+    FindEmptyClusterPolicy<KMeansParallelInitialization>(params, timers,
+        KMeansParallelInitialization(params.Get<double>("oversampling"),
+        (size_t) params.Get<int>("kmeans_parallel_rounds")));
+  }
   else
   {
     FindEmptyClusterPolicy<SampleInitialization>(params, timers,
@@ -229,6 +297,12 @@ void FindEmptyClusterPolicy(util::Params& params,
                             util::Timers& timers,
                             const InitialPartitionPolicy& ipp)
 {
+  if (params.Has("input_file"))
+  {
+    RunStreamingKMeans(params, timers, ipp);
+    return;
+  }
+
   if (params.Has("allow_empty_clusters") ||
       params.Has("kill_empty_clusters"))
   {
@@ -261,8 +335,9 @@ void FindLloydStepType(util::Params& params,
                        const InitialPartitionPolicy& ipp)
 {
   RequireParamInSet<string>(params, "algorithm", { "elkan", "hamerly",
-      "pelleg-moore", "dualtree", "dualtree-covertree", "naive" }, true,
-      "unknown k-means algorithm");
+      "yinyang", "pelleg-moore", "dualtree", "dualtree-covertree", "naive",
+      "minibatch" },
+      true, "unknown k-means algorithm");
 
   const string algorithm = params.Get<string>("algorithm");
   if (algorithm == "elkan")
@@ -275,6 +350,11 @@ void FindLloydStepType(util::Params& params,
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, HamerlyKMeans>(
         params, timers, ipp);
   }
+  else if (algorithm == "yinyang")
+  {
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, YinyangKMeans>(
+        params, timers, ipp);
+  }
   else if (algorithm == "pelleg-moore")
   {
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
@@ -295,6 +375,11 @@ void FindLloydStepType(util::Params& params,
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, NaiveKMeans>(params,
         timers, ipp);
   }
+  else if (algorithm == "minibatch")
+  {
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, MiniBatchKMeans>(
+        params, timers, ipp);
+  }
 }
 
 // Given the template parameters, sanitize/load input and run k-means.
@@ -412,3 +497,68 @@ void RunKMeans(util::Params& params,
   if (params.Has("centroid"))
     params.Get<arma::mat>("centroid") = std::move(centroids);
 }
+
+// Given the type of initial partition policy, run k-means over chunks of the
+// input file.
+template<typename InitialPartitionPolicy>
+void RunStreamingKMeans(util::Params& params,
+                        util::Timers& timers,
+                        const InitialPartitionPolicy& ipp)
+{
+  if (!params.Has("initial_centroids"))
+  {
+    RequireParamValue<int>(params, "clusters", [](int x) { return x > 0; },
+        true, "number of clusters must be positive");
+  }
+  else
+  {
+    ReportIgnoredParam(params, {{ "initial_centroids", true }}, "clusters");
+  }
+
+  RequireParamValue<int>(params, "chunk_size", [](int x) { return x > 0; },
+      true, "chunk size must be positive");
+  RequireParamValue<int>(params, "max_iterations", [](int x) { return x >= 0; },
+      true, "maximum iterations must be positive or 0 (for no limit)");
+
+  // These options need the whole dataset in memory.
+  ReportIgnoredParam(params, {{ "input_file", true }}, "in_place");
+  ReportIgnoredParam(params, {{ "input_file", true }}, "output");
+  ReportIgnoredParam(params, {{ "input_file", true }}, "labels_only");
+  ReportIgnoredParam(params, {{ "input_file", true }}, "algorithm");
+  ReportIgnoredParam(params, {{ "input_file", true }}, "allow_empty_clusters");
+  ReportIgnoredParam(params, {{ "input_file", true }}, "kill_empty_clusters");
+
+  RequireOnlyOnePassed(params, { "assignments_file", "centroid" }, false,
+      "no results will be saved");
+
+  data::ChunkedLoader loader(params.Get<string>("input_file"),
+      (size_t) params.Get<int>("chunk_size"));
+
+  int clusters = params.Get<int>("clusters");
+  arma::mat centroids;
+  const bool initialCentroidGuess = params.Has("initial_centroids");
+  if (initialCentroidGuess)
+  {
+    centroids = std::move(params.Get<arma::mat>("initial_centroids"));
+    if (clusters == 0)
+      clusters = centroids.n_cols;
+
+    ReportIgnoredParam(params, {{ "refined_start", true }},
+        "initial_centroids");
+  }
+
+  timers.Start("clustering");
+  StreamingKMeans<EuclideanDistance, InitialPartitionPolicy> kmeans(
+      (size_t) params.Get<int>("max_iterations"), EuclideanDistance(), ipp);
+  kmeans.Cluster(loader, (size_t) clusters, centroids, initialCentroidGuess);
+
+  if (params.Has("assignments_file"))
+  {
+    kmeans.Assign(loader, centroids,
+        params.Get<string>("assignments_file"));
+  }
+  timers.Stop("clustering");
+
+  if (params.Has("centroid"))
+    params.Get<arma::mat>("centroid") = std::move(centroids);
+}
@@ -0,0 +1,131 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization.hpp
+ *
+ * This file implements the k-means|| ("scalable k-means++") initialization
+ * strategy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+
+/**
+ * This class implements the k-means|| initialization, as described in the
+ * following paper:
+ *
+ * @code
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, Bahman and Moseley, Benjamin and Vattani, Andrea and
+ *       Kumar, Ravi and Vassilvitskii, Sergei},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ * @endcode
+ *
+ * Instead of the k sequential passes over the data of k-means++, a small number
+ * of rounds is made.  In each round, every point is sampled independently (and
+ * in parallel) with probability proportional to its squared distance to the
+ * nearest candidate so far, so that about oversampling * k new candidates are
+ * chosen per round.  Each candidate is then weighted by the number of points
+ * closest to it, and the candidates are reclustered into k centroids with
+ * weighted k-means++.  Only the reclustering depends on k sequentially, and it
+ * works on the much smaller set of candidates.
+ *
+ * In accordance with mlpack's InitialPartitionPolicy template type, we only
+ * need to implement a constructor and a method to compute the initial
+ * centroids.
+ */
+class KMeansParallelInitialization
+{
+ public:
+  /**
+   * Create the KMeansParallelInitialization object.  The paper finds that five
+   * rounds with an oversampling factor of 2 work well in practice; in theory
+   * O(log n) rounds are needed.
+   *
+   * @param oversampling Expected number of candidates chosen in each round, as
+   *     a multiple of the number of clusters.
+   * @param rounds Number of sampling rounds (passes over the data).
+   */
+  KMeansParallelInitialization(const double oversampling = 2.0,
+                               const size_t rounds = 5) :
+      oversampling(oversampling), rounds(rounds) { }
+
+  /**
+   * Initialize the centroids matrix with the k-means|| strategy.
+   *
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids);
+
+  /**
+   * Initialize the centroids matrix with the k-means|| strategy, for a dataset
+   * whose points are sharded across several processes.  Every process calls
+   * Cluster() with its own shard, which must not be empty; the cost of each
+   * round and the weights of the candidates are summed over the processes, and
+   * the candidates sampled by each process are given to all the others, so
+   * that every process gets the same centroids.
+   *
+   * @param data Shard of the dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   * @param allReduce All-reduce policy over the processes.
+   */
+  template<typename MatType, typename AllReduceType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids,
+               const AllReduceType& allReduce);
+
+  //! Get the oversampling factor.
+  double Oversampling() const { return oversampling; }
+  //! Modify the oversampling factor.
+  double& Oversampling() { return oversampling; }
+
+  //! Get the number of sampling rounds.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of sampling rounds.
+  size_t& Rounds() { return rounds; }
+
+ private:
+  /**
+   * Choose the given number of centroids from the given weighted candidates
+   * with k-means++.
+   */
+  static void Recluster(const arma::mat& candidates,
+                        const arma::vec& weights,
+                        const size_t clusters,
+                        arma::mat& centroids);
+
+  //! Return the sum of the given value over all processes.
+  template<typename AllReduceType>
+  static double GlobalSum(const double value, const AllReduceType& allReduce);
+
+  //! The expected number of candidates chosen per round, divided by k.
+  double oversampling;
+  //! The number of sampling rounds.
+  size_t rounds;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "kmeans_parallel_initialization_impl.hpp"
+
+#endif
@@ -0,0 +1,249 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization_impl.hpp
+ *
+ * Implementation of the k-means|| initialization strategy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_parallel_initialization.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+void KMeansParallelInitialization::Cluster(const MatType& data,
+                                           const size_t clusters,
+                                           arma::mat& centroids)
+{
+  Cluster(data, clusters, centroids, LocalAllReduce());
+}
+
+template<typename MatType, typename AllReduceType>
+void KMeansParallelInitialization::Cluster(const MatType& data,
+                                           const size_t clusters,
+                                           arma::mat& centroids,
+                                           const AllReduceType& allReduce)
+{
+  if (oversampling <= 0.0)
+  {
+    throw std::invalid_argument("KMeansParallelInitialization::Cluster(): "
+        "oversampling factor must be positive!");
+  }
+
+  const size_t n = data.n_cols;
+  const bool distributed = (allReduce.Size() > 1);
+
+  // Points are sampled in fixed blocks, each with its own generator seeded
+  // from mlpack's generator, so that the candidates only depend on the random
+  // seed and not on the number of threads.  When the points are sharded, the
+  // blocks of each process are numbered after those of the previous processes.
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (n + blockSize - 1) / blockSize;
+  size_t firstBlock = 0;
+
+  // The first candidate is sampled fully randomly.
+  arma::mat candidates(data.n_rows, 1);
+  if (!distributed)
+  {
+    candidates.col(0) = arma::vec(data.col(RandInt(0, n)));
+  }
+  else
+  {
+    arma::mat localSize(1, 1), sizes;
+    localSize[0] = n;
+    AllReduceGather(allReduce, localSize, sizes);
+    for (size_t p = 0; p < allReduce.Rank(); ++p)
+      firstBlock += ((size_t) sizes[p] + blockSize - 1) / blockSize;
+
+    // The first process chooses the index of the candidate among all points,
+    // and the process that holds it gives it to the others.
+    const double totalSize = arma::accu(sizes);
+    arma::mat index(1, 1);
+    index[0] = std::min(std::floor(Random() * totalSize), totalSize - 1);
+    AllReduceBroadcast(allReduce, index);
+    size_t owner = 0;
+    while (index[0] >= sizes[owner])
+      index[0] -= sizes[owner++];
+
+    if (allReduce.Rank() == owner)
+      candidates.col(0) = arma::vec(data.col((size_t) index[0]));
+    AllReduceBroadcast(allReduce, candidates, owner);
+  }
+
+  // The squared distance from each point to its closest candidate, and the
+  // index of that candidate.
+  arma::vec minDistances(n);
+  arma::Col<size_t> closest(n, arma::fill::zeros);
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t p = 0; p < n; ++p)
+  {
+    minDistances[p] = SquaredEuclideanDistance::Evaluate(data.col(p),
+        candidates.col(0));
+  }
+  double cost = GlobalSum(arma::accu(minDistances), allReduce);
+
+  const double expected = oversampling * clusters;
+  for (size_t r = 0; r < rounds && cost > 0.0; ++r)
+  {
+    arma::mat roundSeed(1, 1);
+    roundSeed[0] = RandGen()();
+    AllReduceBroadcast(allReduce, roundSeed);
+    std::vector<std::vector<size_t>> sampled(numBlocks);
+
+    #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      std::mt19937 generator((size_t) roundSeed[0] + firstBlock + b);
+      std::uniform_real_distribution<> uniform;
+      const size_t end = std::min(n, (b + 1) * blockSize);
+      for (size_t p = b * blockSize; p < end; ++p)
+      {
+        // Points with probability of at least 1 are always chosen.
+        if (uniform(generator) < expected * minDistances[p] / cost)
+          sampled[b].push_back(p);
+      }
+    }
+
+    std::vector<size_t> localSampled;
+    for (size_t b = 0; b < numBlocks; ++b)
+      localSampled.insert(localSampled.end(), sampled[b].begin(),
+          sampled[b].end());
+
+    arma::mat newCandidates(data.n_rows, localSampled.size());
+    for (size_t j = 0; j < localSampled.size(); ++j)
+      newCandidates.col(j) = arma::vec(data.col(localSampled[j]));
+    if (distributed)
+    {
+      arma::mat localCandidates = std::move(newCandidates);
+      AllReduceGather(allReduce, localCandidates, newCandidates);
+    }
+
+    if (newCandidates.n_cols == 0)
+      continue;
+
+    // Update the closest candidate of every point with the new candidates.
+    const size_t firstIndex = candidates.n_cols;
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t p = 0; p < n; ++p)
+    {
+      for (size_t j = 0; j < newCandidates.n_cols; ++j)
+      {
+        const double distance = SquaredEuclideanDistance::Evaluate(
+            data.col(p), newCandidates.col(j));
+        if (distance < minDistances[p])
+        {
+          minDistances[p] = distance;
+          closest[p] = firstIndex + j;
+        }
+      }
+    }
+
+    candidates = arma::join_rows(candidates, newCandidates);
+    cost = GlobalSum(arma::accu(minDistances), allReduce);
+  }
+
+  Log::Info << "KMeansParallelInitialization::Cluster(): chose "
+      << candidates.n_cols << " candidates." << std::endl;
+
+  // Weight each candidate by the number of points closest to it.
+  arma::vec weights(candidates.n_cols, arma::fill::zeros);
+  for (size_t p = 0; p < n; ++p)
+    weights[closest[p]] += 1.0;
+  allReduce.Sum(weights);
+
+  // The candidates are reclustered by the first process only, so that every
+  // process gets the same centroids.
+  if (allReduce.Rank() == 0)
+  {
+    if (candidates.n_cols > clusters)
+    {
+      Recluster(candidates, weights, clusters, centroids);
+    }
+    else
+    {
+      // There are too few candidates (for instance, because the dataset has
+      // fewer distinct points than clusters), so the remaining centroids are
+      // random points.
+      centroids.set_size(data.n_rows, clusters);
+      centroids.cols(0, candidates.n_cols - 1) = candidates;
+      for (size_t i = candidates.n_cols; i < clusters; ++i)
+        centroids.col(i) = arma::vec(data.col(RandInt(0, n)));
+    }
+  }
+  else
+  {
+    centroids.set_size(data.n_rows, clusters);
+  }
+  AllReduceBroadcast(allReduce, centroids);
+}
+
+template<typename AllReduceType>
+double KMeansParallelInitialization::GlobalSum(const double value,
+                                               const AllReduceType& allReduce)
+{
+  if (allReduce.Size() == 1)
+    return value;
+
+  arma::mat sum(1, 1);
+  sum[0] = value;
+  allReduce.Sum(sum);
+  return sum[0];
+}
+
+inline void KMeansParallelInitialization::Recluster(
+    const arma::mat& candidates,
+    const arma::vec& weights,
+    const size_t clusters,
+    arma::mat& centroids)
+{
+  centroids.set_size(candidates.n_rows, clusters);
+
+  // Sample a candidate from the given (unnormalized) distribution.
+  arma::vec cdf(candidates.n_cols);
+  auto sample = [&cdf](const arma::vec& probabilities)
+  {
+    cdf = arma::cumsum(probabilities);
+    const double value = Random() * cdf[cdf.n_elem - 1];
+    const double* elem = std::lower_bound(cdf.begin(), cdf.end(), value);
+    return std::min((size_t) (elem - cdf.begin()), (size_t) cdf.n_elem - 1);
+  };
+
+  // The first centroid is sampled by weight only.
+  size_t chosen = sample(weights);
+  centroids.col(0) = candidates.col(chosen);
+
+  arma::vec minDistances(candidates.n_cols);
+  for (size_t j = 0; j < candidates.n_cols; ++j)
+  {
+    minDistances[j] = SquaredEuclideanDistance::Evaluate(candidates.col(j),
+        centroids.col(0));
+  }
+
+  for (size_t i = 1; i < clusters; ++i)
+  {
+    const arma::vec probabilities = weights % minDistances;
+    if (arma::accu(probabilities) > 0.0)
+      chosen = sample(probabilities);
+    else
+      chosen = RandInt(0, candidates.n_cols);
+    centroids.col(i) = candidates.col(chosen);
+
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t j = 0; j < (size_t) candidates.n_cols; ++j)
+    {
+      const double distance = SquaredEuclideanDistance::Evaluate(
+          candidates.col(j), centroids.col(i));
+      minDistances[j] = std::min(minDistances[j], distance);
+    }
+  }
+}
+
+} // namespace mlpack
+
+#endif
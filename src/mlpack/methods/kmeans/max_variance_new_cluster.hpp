@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_KMEANS_MAX_VARIANCE_NEW_CLUSTER_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "blocked_assignment.hpp"
 
 namespace mlpack {
 
@@ -71,6 +72,22 @@ class MaxVarianceNewCluster
                     const arma::mat& oldCentroids,
                     arma::Col<size_t>& clusterCounts,
                     MetricType& metric);
+
+  //! Compute the assignments of each point, evaluating the metric for each
+  //! point/centroid pair.
+  template<typename MetricType, typename MatType>
+  void Assign(const MatType& data,
+              const arma::mat& oldCentroids,
+              MetricType& metric,
+              const std::false_type& /* blocked */);
+
+  //! Compute the assignments of each point with blocked matrix
+  //! multiplications.
+  template<typename MetricType, typename MatType>
+  void Assign(const MatType& data,
+              const arma::mat& oldCentroids,
+              MetricType& metric,
+              const std::true_type& /* blocked */);
 };
 
 } // namespace mlpack
@@ -124,6 +124,25 @@ void MaxVarianceNewCluster::Precalculate(const MatType& data,
 
   // Add the variance of each point's distance away from the cluster.  I think
   // this is the sensible thing to do.
+  Assign(data, oldCentroids, metric, std::integral_constant<bool,
+      UseBlockedAssignment<MetricType, MatType>::value>());
+
+  // Divide by the number of points in the cluster to produce the variance,
+  // unless the cluster is empty or contains only one point, in which case we
+  // set the variance to 0.
+  for (size_t i = 0; i < clusterCounts.n_elem; ++i)
+    if (clusterCounts[i] <= 1)
+      variances[i] = 0;
+    else
+      variances[i] /= clusterCounts[i];
+}
+
+template<typename MetricType, typename MatType>
+void MaxVarianceNewCluster::Assign(const MatType& data,
+                                   const arma::mat& oldCentroids,
+                                   MetricType& metric,
+                                   const std::false_type&)
+{
   for (size_t i = 0; i < data.n_cols; ++i)
   {
     // Find the closest centroid to this point.
@@ -145,15 +164,34 @@ void MaxVarianceNewCluster::Precalculate(const MatType& data,
     variances[closestCluster] += std::pow(metric.Evaluate(data.col(i),
         oldCentroids.col(closestCluster)), 2.0);
   }
+}
 
-  // Divide by the number of points in the cluster to produce the variance,
-  // unless the cluster is empty or contains only one point, in which case we
-  // set the variance to 0.
-  for (size_t i = 0; i < clusterCounts.n_elem; ++i)
-    if (clusterCounts[i] <= 1)
-      variances[i] = 0;
-    else
-      variances[i] /= clusterCounts[i];
+template<typename MetricType, typename MatType>
+void MaxVarianceNewCluster::Assign(const MatType& data,
+                                   const arma::mat& oldCentroids,
+                                   MetricType& /* metric */,
+                                   const std::true_type&)
+{
+  const arma::rowvec centroidNorms = arma::sum(arma::square(oldCentroids), 0);
+  arma::Row<size_t> blockAssignments;
+  arma::rowvec distances;
+  for (size_t begin = 0; begin < data.n_cols; begin += BlockedAssignmentSize)
+  {
+    const size_t end = std::min((size_t) data.n_cols,
+        begin + BlockedAssignmentSize);
+    BlockedAssignment(data, begin, end, oldCentroids, centroidNorms,
+        blockAssignments, distances);
+
+    assignments.cols(begin, end - 1) = blockAssignments;
+    for (size_t i = begin; i < end; ++i)
+    {
+      // The distances are squared Euclidean distances; the variance is of the
+      // metric's values.
+      const double distance = distances[i - begin];
+      variances[blockAssignments[i - begin]] += MetricType::TakeRoot ?
+          distance : distance * distance;
+    }
+  }
 }
 
 } // namespace mlpack
@@ -0,0 +1,131 @@
+/**
+ * @file methods/kmeans/minibatch_kmeans.hpp
+ *
+ * An implementation of mini-batch k-means, which updates the centroids with a
+ * small random sample of the dataset in each iteration instead of the whole
+ * dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINIBATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINIBATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * An implementation of mini-batch k-means (Sculley, 2010), for use as the
+ * LloydStepType of KMeans.  Each iteration samples a mini-batch of points from
+ * the dataset, assigns each of them to its nearest centroid (in parallel, when
+ * OpenMP is available), and moves each centroid towards the points assigned to
+ * it with a per-centroid learning rate of 1 / (number of points assigned to the
+ * centroid so far).  The centroids are thus the running means of all points
+ * that were assigned to them.  Each iteration costs O(kb) distance calculations
+ * for a batch size of b, independent of the size of the dataset, so many more
+ * iterations can be run for the same cost, but the result only approximates
+ * that of the exact Lloyd iteration.
+ *
+ * Since a cluster may receive no points from a single mini-batch, the counts
+ * returned by Iterate() are the numbers of points assigned to each cluster
+ * over all iterations so far.
+ *
+ * Batches that do not come from a single in-memory dataset (for instance, when
+ * streaming from disk) can be given to Update() directly.
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web (WWW '10)},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * @param MetricType Type of metric used with this implementation.
+ * @param MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  //! The batch size used when none is given.
+  static constexpr size_t DefaultBatchSize = 1024;
+
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset to sample mini-batches from.
+   * @param metric Instantiated metric.
+   * @param batchSize Number of points in each mini-batch.
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const size_t batchSize = DefaultBatchSize);
+
+  /**
+   * Run a single iteration of mini-batch k-means: sample a mini-batch from the
+   * dataset and update the given centroids with it into the newCentroids
+   * matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points assigned to each cluster so far.
+   * @return The norm of the change of the centroids.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  /**
+   * Update the given centroids in place with the given mini-batch.  This can
+   * be called repeatedly with batches from any source.  The number of points
+   * assigned to each centroid so far is kept in this object; call Reset() to
+   * start over with new centroids.
+   *
+   * @param batch Mini-batch of points.
+   * @param centroids Centroids to update.
+   * @return The norm of the change of the centroids.
+   */
+  template<typename BatchType>
+  double Update(const BatchType& batch, arma::mat& centroids);
+
+  //! Forget the number of points assigned to each centroid so far.
+  void Reset() { clusterCounts.reset(); }
+
+  //! Get the number of points assigned to each cluster so far.
+  const arma::Col<size_t>& ClusterCounts() const { return clusterCounts; }
+
+  //! Get the number of points in each mini-batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each mini-batch.
+  size_t& BatchSize() { return batchSize; }
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The number of points in each mini-batch.
+  size_t batchSize;
+
+  //! The number of points assigned to each cluster so far.
+  arma::Col<size_t> clusterCounts;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "minibatch_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file methods/kmeans/minibatch_kmeans_impl.hpp
+ *
+ * Implementation of mini-batch k-means.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINIBATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINIBATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "minibatch_kmeans.hpp"
+
+namespace mlpack {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(const MatType& dataset,
+                                                      MetricType& metric,
+                                                      const size_t batchSize) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(batchSize),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single iteration.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("MiniBatchKMeans::Iterate(): batch size must "
+        "be positive!");
+  }
+
+  newCentroids = centroids;
+  double cNorm;
+  if (batchSize >= dataset.n_cols)
+  {
+    cNorm = Update(dataset, newCentroids);
+  }
+  else
+  {
+    // Points are sampled with replacement, so that sampling does not depend on
+    // the size of the dataset.
+    std::uniform_int_distribution<size_t> dist(0, dataset.n_cols - 1);
+    arma::uvec indices(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+      indices[i] = dist(RandGen());
+
+    cNorm = Update(MatType(dataset.cols(indices)), newCentroids);
+  }
+
+  counts = clusterCounts;
+  return cNorm;
+}
+
+// Update the centroids with a single mini-batch.
+template<typename MetricType, typename MatType>
+template<typename BatchType>
+double MiniBatchKMeans<MetricType, MatType>::Update(const BatchType& batch,
+                                                    arma::mat& centroids)
+{
+  if (clusterCounts.n_elem != centroids.n_cols)
+    clusterCounts.zeros(centroids.n_cols);
+
+  arma::mat sums(centroids.n_rows, centroids.n_cols, arma::fill::zeros);
+  arma::Col<size_t> batchCounts(centroids.n_cols, arma::fill::zeros);
+
+  // Find the closest centroid to each point of the batch, in parallel.
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    arma::mat localSums(centroids.n_rows, centroids.n_cols, arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+
+    #pragma omp for
+    for (size_t i = 0; i < (size_t) batch.n_cols; ++i)
+    {
+      double minDistance = std::numeric_limits<double>::infinity();
+      size_t closestCluster = centroids.n_cols; // Invalid value.
+
+      for (size_t j = 0; j < centroids.n_cols; ++j)
+      {
+        const double distance = metric.Evaluate(batch.col(i),
+            centroids.unsafe_col(j));
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = j;
+        }
+      }
+
+      Log::Assert(closestCluster != centroids.n_cols);
+
+      localSums.unsafe_col(closestCluster) += batch.col(i);
+      localCounts(closestCluster)++;
+    }
+
+    #pragma omp critical
+    {
+      sums += localSums;
+      batchCounts += localCounts;
+    }
+  }
+
+  distanceCalculations += centroids.n_cols * batch.n_cols;
+
+  // Applying the update c <- (1 - 1 / v) c + (1 / v) x for each point x of the
+  // batch in turn (where v is the number of points assigned to c so far) makes
+  // each centroid the mean of every point assigned to it; this is the same
+  // update, applied to all points of the batch at once.
+  double cNorm = 0.0;
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+  {
+    if (batchCounts[j] == 0)
+      continue;
+
+    const size_t total = clusterCounts[j] + batchCounts[j];
+    const arma::vec newCentroid = ((double) clusterCounts[j] *
+        centroids.col(j) + sums.col(j)) / total;
+    cNorm += std::pow(metric.Evaluate(centroids.col(j), newCentroid), 2.0);
+    ++distanceCalculations;
+
+    centroids.col(j) = newCentroid;
+    clusterCounts[j] = total;
+  }
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace mlpack
+
+#endif
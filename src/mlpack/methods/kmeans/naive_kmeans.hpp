@@ -16,6 +16,7 @@
 #define MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "blocked_assignment.hpp"
 
 namespace mlpack {
 
@@ -25,6 +26,12 @@ namespace mlpack {
  * looking for the KMeans class instead of this one.  This class is used by
  * KMeans as the actual implementation of the Lloyd iteration.
  *
+ * When the metric is the Euclidean or squared Euclidean distance and the
+ * dataset is dense, the distances between blocks of points and all centroids
+ * are computed with a single matrix multiplication (see BlockedAssignment()),
+ * which is much faster than evaluating the metric for each pair when there are
+ * many clusters.
+ *
  * @param MetricType Type of metric used with this implementation.
  * @param MatType Matrix type (arma::mat or arma::sp_mat).
  */
@@ -57,6 +64,26 @@ class NaiveKMeans
   size_t DistanceCalculations() const { return distanceCalculations; }
 
  private:
+  /**
+   * Assign each point to its nearest centroid, evaluating the metric for each
+   * point/centroid pair, and accumulate the sums and counts of the points
+   * assigned to each centroid.
+   */
+  void Assign(const arma::mat& centroids,
+              arma::mat& newCentroids,
+              arma::Col<size_t>& counts,
+              const std::false_type& /* blocked */);
+
+  /**
+   * Assign each point to its nearest centroid with blocked matrix
+   * multiplications, and accumulate the sums and counts of the points assigned
+   * to each centroid.
+   */
+  void Assign(const arma::mat& centroids,
+              arma::mat& newCentroids,
+              arma::Col<size_t>& counts,
+              const std::true_type& /* blocked */);
+
   //! The dataset.
   const MatType& dataset;
   //! The instantiated metric.
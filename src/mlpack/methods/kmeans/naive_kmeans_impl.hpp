@@ -38,17 +38,46 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   newCentroids.zeros(centroids.n_rows, centroids.n_cols);
   counts.zeros(centroids.n_cols);
 
+  Assign(centroids, newCentroids, counts, std::integral_constant<bool,
+      UseBlockedAssignment<MetricType, MatType>::value>());
+
+  // Now normalize the centroid.
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+    if (counts(i) != 0)
+      newCentroids.col(i) /= counts(i);
+
+  distanceCalculations += centroids.n_cols * dataset.n_cols;
+
+  // Calculate cluster distortion for this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+template<typename MetricType, typename MatType>
+void NaiveKMeans<MetricType, MatType>::Assign(const arma::mat& centroids,
+                                              arma::mat& newCentroids,
+                                              arma::Col<size_t>& counts,
+                                              const std::false_type&)
+{
   // Find the closest centroid to each point and update the new centroids.
   // Computed in parallel over the complete dataset
-  #pragma omp parallel
+  std::mutex mergeMutex;
+  ParallelForRanges(0, dataset.n_cols, [&](const size_t begin,
+                                           const size_t end)
   {
-    // The current state of the K-means is private for each thread
+    // The current state of the K-means is private for each range of points.
     arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
         arma::fill::zeros);
     arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
 
-    #pragma omp for
-    for (size_t i = 0; i < (size_t) dataset.n_cols; ++i)
+    for (size_t i = begin; i < end; ++i)
     {
       // Find the closest centroid to this point.
       double minDistance = std::numeric_limits<double>::infinity();
@@ -71,31 +100,51 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
       localCentroids.unsafe_col(closestCluster) += dataset.col(i);
       localCounts(closestCluster)++;
     }
-    // Combine calculated state from each thread
-    #pragma omp critical
-    {
-      newCentroids += localCentroids;
-      counts += localCounts;
-    }
-  }
-
-  // Now normalize the centroid.
-  for (size_t i = 0; i < centroids.n_cols; ++i)
-    if (counts(i) != 0)
-      newCentroids.col(i) /= counts(i);
+    // Combine calculated state from each range.
+    std::lock_guard<std::mutex> lock(mergeMutex);
+    newCentroids += localCentroids;
+    counts += localCounts;
+  });
+}
 
-  distanceCalculations += centroids.n_cols * dataset.n_cols;
+template<typename MetricType, typename MatType>
+void NaiveKMeans<MetricType, MatType>::Assign(const arma::mat& centroids,
+                                              arma::mat& newCentroids,
+                                              arma::Col<size_t>& counts,
+                                              const std::true_type&)
+{
+  const arma::rowvec centroidNorms = arma::sum(arma::square(centroids), 0);
+  const size_t numBlocks = (dataset.n_cols + BlockedAssignmentSize - 1) /
+      BlockedAssignmentSize;
 
-  // Calculate cluster distortion for this iteration.
-  double cNorm = 0.0;
-  for (size_t i = 0; i < centroids.n_cols; ++i)
+  std::mutex mergeMutex;
+  ParallelForRanges(0, numBlocks, [&](const size_t first, const size_t last)
   {
-    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
-        2.0);
-  }
-  distanceCalculations += centroids.n_cols;
+    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+    arma::Row<size_t> assignments;
+    arma::rowvec distances;
 
-  return std::sqrt(cNorm);
+    for (size_t b = first; b < last; ++b)
+    {
+      const size_t begin = b * BlockedAssignmentSize;
+      const size_t end = std::min((size_t) dataset.n_cols,
+          begin + BlockedAssignmentSize);
+      BlockedAssignment(dataset, begin, end, centroids, centroidNorms,
+          assignments, distances);
+
+      for (size_t i = begin; i < end; ++i)
+      {
+        localCentroids.unsafe_col(assignments[i - begin]) += dataset.col(i);
+        localCounts(assignments[i - begin])++;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(mergeMutex);
+    newCentroids += localCentroids;
+    counts += localCounts;
+  });
 }
 
 } // namespace mlpack
@@ -0,0 +1,166 @@
+/**
+ * @file methods/kmeans/streaming_kmeans.hpp
+ *
+ * An implementation of k-means clustering for datasets that do not fit in
+ * memory, which are read from disk in chunks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_STREAMING_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_STREAMING_KMEANS_HPP
+
+#include <mlpack/core.hpp>
+
+#include "kmeans.hpp"
+#include "blocked_assignment.hpp"
+
+namespace mlpack {
+
+/**
+ * This class runs exact Lloyd iterations of k-means on a dataset that is read
+ * from disk in chunks with a data::ChunkedLoader or a data::ChunkedReader (or
+ * any loader with the same Next(), Reset(), Dimensionality() and PointsRead()
+ * methods), so that only one chunk (and the centroids) must be held in memory
+ * at any time.  Each iteration is one pass over the file: each point of each
+ * chunk is assigned to its nearest centroid, and the sum and count of the
+ * points assigned to each centroid are accumulated, so that the new centroids
+ * are the same as those of an in-memory Lloyd iteration.  The assignments are
+ * never held in memory; once the centroids are found, Assign() makes a last
+ * pass over the file and writes the assignment of each point out, one chunk at
+ * a time.
+ *
+ * The initial centroids are chosen by the InitialPartitionPolicy from the
+ * first chunk of the file (so the chunk size must be at least the number of
+ * clusters), unless an initial guess is given.  A cluster that receives no
+ * points keeps its centroid from the previous iteration, as with the
+ * AllowEmptyClusters policy of KMeans.
+ *
+ * @code
+ * data::ChunkedLoader loader("huge_dataset.csv", 100000);
+ * StreamingKMeans<> kmeans;
+ * arma::mat centroids;
+ * kmeans.Cluster(loader, 10, centroids);
+ * kmeans.Assign(loader, centroids, "assignments.csv");
+ * @endcode
+ *
+ * @tparam MetricType The distance metric to use for this KMeans; see
+ *     metric.hpp.
+ * @tparam InitialPartitionPolicy Initial partitioning policy, used on the first
+ *     chunk; see KMeans.
+ */
+template<typename MetricType = EuclideanDistance,
+         typename InitialPartitionPolicy = SampleInitialization>
+class StreamingKMeans
+{
+ public:
+  /**
+   * Create a StreamingKMeans object, with the given parameters.
+   *
+   * @param maxIterations Maximum number of iterations (passes over the data)
+   *     allowed before giving up (0 is valid, but the algorithm may never
+   *     terminate).
+   * @param metric Optional MetricType object; for when the metric has state it
+   *     needs to store.
+   * @param partitioner Optional InitialPartitionPolicy object; for when a
+   *     specially initialized partitioning policy is required.
+   */
+  StreamingKMeans(const size_t maxIterations = 1000,
+                  const MetricType metric = MetricType(),
+                  const InitialPartitionPolicy partitioner =
+                      InitialPartitionPolicy());
+
+  /**
+   * Find the centroids of the given number of clusters of the dataset read
+   * by the given loader.  The loader is reset before each pass over the file.
+   *
+   * @param loader Loader of the dataset to cluster.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains
+   *     the initial cluster centroids.
+   * @return The number of iterations that were performed.
+   */
+  template<typename LoaderType>
+  size_t Cluster(LoaderType& loader,
+                 const size_t clusters,
+                 arma::mat& centroids,
+                 const bool initialGuess = false);
+
+  /**
+   * Assign each point of the dataset read by the given loader to its nearest
+   * centroid, and write the assignments to the given stream, one per line.
+   * The loader is reset first.
+   *
+   * @param loader Loader of the dataset to assign points of.
+   * @param centroids Centroids of the clusters.
+   * @param assignments Stream to write the assignments to.
+   * @return The number of points that were assigned.
+   */
+  template<typename LoaderType>
+  size_t Assign(LoaderType& loader,
+                const arma::mat& centroids,
+                std::ostream& assignments);
+
+  /**
+   * Assign each point of the dataset read by the given loader to its nearest
+   * centroid, and write the assignments to the given file, one per line.  The
+   * file can be loaded as an arma::Row<size_t> with data::Load().  A
+   * std::runtime_error is thrown if the file cannot be opened.
+   *
+   * @param loader Loader of the dataset to assign points of.
+   * @param centroids Centroids of the clusters.
+   * @param filename File to write the assignments to.
+   * @return The number of points that were assigned.
+   */
+  template<typename LoaderType>
+  size_t Assign(LoaderType& loader,
+                const arma::mat& centroids,
+                const std::string& filename);
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Set the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the distance metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the distance metric.
+  MetricType& Metric() { return metric; }
+
+  //! Get the initial partitioning policy.
+  const InitialPartitionPolicy& Partitioner() const { return partitioner; }
+  //! Modify the initial partitioning policy.
+  InitialPartitionPolicy& Partitioner() { return partitioner; }
+
+ private:
+  //! Find the nearest centroid of each point in the chunk, evaluating the
+  //! metric for each point/centroid pair.
+  void AssignChunk(const arma::mat& chunk,
+                   const arma::mat& centroids,
+                   arma::Row<size_t>& assignments,
+                   const std::false_type& /* blocked */);
+
+  //! Find the nearest centroid of each point in the chunk with blocked matrix
+  //! multiplications.
+  void AssignChunk(const arma::mat& chunk,
+                   const arma::mat& centroids,
+                   arma::Row<size_t>& assignments,
+                   const std::true_type& /* blocked */);
+
+  //! Maximum number of iterations before giving up.
+  size_t maxIterations;
+  //! Instantiated distance metric.
+  MetricType metric;
+  //! Instantiated initial partitioning policy.
+  InitialPartitionPolicy partitioner;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "streaming_kmeans_impl.hpp"
+
+#endif
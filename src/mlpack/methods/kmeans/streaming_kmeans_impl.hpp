@@ -0,0 +1,259 @@
+/**
+ * @file methods/kmeans/streaming_kmeans_impl.hpp
+ *
+ * Implementation of k-means clustering over chunks of a dataset on disk.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_STREAMING_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_STREAMING_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "streaming_kmeans.hpp"
+
+namespace mlpack {
+
+template<typename MetricType, typename InitialPartitionPolicy>
+StreamingKMeans<MetricType, InitialPartitionPolicy>::StreamingKMeans(
+    const size_t maxIterations,
+    const MetricType metric,
+    const InitialPartitionPolicy partitioner) :
+    maxIterations(maxIterations),
+    metric(metric),
+    partitioner(partitioner)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename InitialPartitionPolicy>
+template<typename LoaderType>
+size_t StreamingKMeans<MetricType, InitialPartitionPolicy>::Cluster(
+    LoaderType& loader,
+    const size_t clusters,
+    arma::mat& centroids,
+    const bool initialGuess)
+{
+  if (clusters == 0)
+  {
+    throw std::invalid_argument("StreamingKMeans::Cluster(): number of "
+        "clusters must be positive!");
+  }
+
+  arma::mat chunk;
+  if (initialGuess)
+  {
+    if (centroids.n_cols != clusters || centroids.n_rows !=
+        loader.Dimensionality())
+    {
+      std::ostringstream oss;
+      oss << "StreamingKMeans::Cluster(): wrong size of initial cluster "
+          << "centroids (" << centroids.n_rows << "x" << centroids.n_cols
+          << "; should be " << loader.Dimensionality() << "x" << clusters
+          << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+  else
+  {
+    // Choose the initial centroids from the first chunk.
+    loader.Reset();
+    loader.Next(chunk);
+    if (chunk.n_cols < clusters)
+    {
+      std::ostringstream oss;
+      oss << "StreamingKMeans::Cluster(): the first chunk has only "
+          << chunk.n_cols << " points, but " << clusters << " clusters were "
+          << "requested; increase the chunk size!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    arma::Row<size_t> assignments;
+    if (GetInitialAssignmentsOrCentroids(partitioner, chunk, clusters,
+        assignments, centroids))
+    {
+      // The partitioner gave assignments, so use the means of the points of
+      // the first chunk assigned to each cluster.
+      centroids.zeros(chunk.n_rows, clusters);
+      arma::Col<size_t> counts(clusters, arma::fill::zeros);
+      for (size_t i = 0; i < chunk.n_cols; ++i)
+      {
+        centroids.col(assignments[i]) += chunk.col(i);
+        ++counts[assignments[i]];
+      }
+
+      for (size_t c = 0; c < clusters; ++c)
+        if (counts[c] != 0)
+          centroids.col(c) /= counts[c];
+    }
+  }
+
+  arma::mat sums;
+  arma::Col<size_t> counts;
+  arma::Row<size_t> assignments;
+  size_t iteration = 0;
+  double cNorm;
+  do
+  {
+    sums.zeros(centroids.n_rows, centroids.n_cols);
+    counts.zeros(centroids.n_cols);
+
+    loader.Reset();
+    while (loader.Next(chunk))
+    {
+      AssignChunk(chunk, centroids, assignments, std::integral_constant<bool,
+          UseBlockedAssignment<MetricType, arma::mat>::value>());
+
+      for (size_t i = 0; i < chunk.n_cols; ++i)
+      {
+        sums.col(assignments[i]) += chunk.col(i);
+        ++counts[assignments[i]];
+      }
+    }
+
+    // Compute the new centroids, and how far they moved.  Empty clusters keep
+    // their centroid.
+    cNorm = 0.0;
+    for (size_t c = 0; c < centroids.n_cols; ++c)
+    {
+      if (counts[c] == 0)
+        continue;
+
+      const arma::vec newCentroid = sums.col(c) / counts[c];
+      cNorm += std::pow(metric.Evaluate(centroids.col(c), newCentroid), 2.0);
+      centroids.col(c) = newCentroid;
+    }
+    cNorm = std::sqrt(cNorm);
+
+    ++iteration;
+    Log::Info << "StreamingKMeans::Cluster(): iteration " << iteration
+        << " over " << loader.PointsRead() << " points, residual " << cNorm
+        << ".\n";
+    if (std::isnan(cNorm) || std::isinf(cNorm))
+      cNorm = 1e-4; // Keep iterating.
+  } while (cNorm > 1e-5 && iteration != maxIterations);
+
+  if (iteration != maxIterations)
+  {
+    Log::Info << "StreamingKMeans::Cluster(): converged after " << iteration
+        << " iterations." << std::endl;
+  }
+  else
+  {
+    Log::Info << "StreamingKMeans::Cluster(): terminated after limit of "
+        << iteration << " iterations." << std::endl;
+  }
+
+  return iteration;
+}
+
+template<typename MetricType, typename InitialPartitionPolicy>
+template<typename LoaderType>
+size_t StreamingKMeans<MetricType, InitialPartitionPolicy>::Assign(
+    LoaderType& loader,
+    const arma::mat& centroids,
+    std::ostream& assignments)
+{
+  arma::mat chunk;
+  arma::Row<size_t> chunkAssignments;
+  loader.Reset();
+  while (loader.Next(chunk))
+  {
+    AssignChunk(chunk, centroids, chunkAssignments, std::integral_constant<
+        bool, UseBlockedAssignment<MetricType, arma::mat>::value>());
+
+    for (size_t i = 0; i < chunkAssignments.n_elem; ++i)
+      assignments << chunkAssignments[i] << '\n';
+  }
+
+  return loader.PointsRead();
+}
+
+template<typename MetricType, typename InitialPartitionPolicy>
+template<typename LoaderType>
+size_t StreamingKMeans<MetricType, InitialPartitionPolicy>::Assign(
+    LoaderType& loader,
+    const arma::mat& centroids,
+    const std::string& filename)
+{
+  std::ofstream stream(filename);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("StreamingKMeans::Assign(): cannot open '" +
+        filename + "' for writing.");
+  }
+
+  const size_t points = Assign(loader, centroids, stream);
+  if (!stream.good())
+  {
+    throw std::runtime_error("StreamingKMeans::Assign(): error while writing "
+        "to '" + filename + "'.");
+  }
+
+  return points;
+}
+
+template<typename MetricType, typename InitialPartitionPolicy>
+void StreamingKMeans<MetricType, InitialPartitionPolicy>::AssignChunk(
+    const arma::mat& chunk,
+    const arma::mat& centroids,
+    arma::Row<size_t>& assignments,
+    const std::false_type&)
+{
+  assignments.set_size(chunk.n_cols);
+
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t i = 0; i < (size_t) chunk.n_cols; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(chunk.col(i), centroids.col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    assignments[i] = closestCluster;
+  }
+}
+
+template<typename MetricType, typename InitialPartitionPolicy>
+void StreamingKMeans<MetricType, InitialPartitionPolicy>::AssignChunk(
+    const arma::mat& chunk,
+    const arma::mat& centroids,
+    arma::Row<size_t>& assignments,
+    const std::true_type&)
+{
+  assignments.set_size(chunk.n_cols);
+  const arma::rowvec centroidNorms = arma::sum(arma::square(centroids), 0);
+  const size_t numBlocks = (chunk.n_cols + BlockedAssignmentSize - 1) /
+      BlockedAssignmentSize;
+
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    arma::Row<size_t> blockAssignments;
+    arma::rowvec distances;
+
+    #pragma omp for
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * BlockedAssignmentSize;
+      const size_t end = std::min((size_t) chunk.n_cols,
+          begin + BlockedAssignmentSize);
+      BlockedAssignment(chunk, begin, end, centroids, centroidNorms,
+          blockAssignments, distances);
+      assignments.cols(begin, end - 1) = blockAssignments;
+    }
+  }
+}
+
+} // namespace mlpack
+
+#endif
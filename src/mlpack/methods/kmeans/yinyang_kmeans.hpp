@@ -0,0 +1,113 @@
+/**
+ * @file methods/kmeans/yinyang_kmeans.hpp
+ *
+ * An implementation of the Yinyang algorithm for k-means clustering, which
+ * keeps a lower bound for each group of centroids.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_YINYANG_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_YINYANG_KMEANS_HPP
+
+namespace mlpack {
+
+/**
+ * An implementation of Yinyang k-means for exact Lloyd iterations.  The
+ * centroids are clustered into t groups in the first iteration, and each point
+ * keeps an upper bound on the distance to its centroid and a lower bound on
+ * the distance to the closest other centroid of each group.  This takes
+ * O(t * N) memory for the bounds, between Hamerly's algorithm (one lower
+ * bound per point) and Elkan's algorithm (k lower bounds per point).  In each
+ * iteration, a point is skipped if its upper bound is below all of its lower
+ * bounds (the global filter); otherwise only the groups whose lower bound is
+ * below the upper bound are searched (the group filter), and within a group,
+ * centroids that moved too little to become closer are skipped (the local
+ * filter).  For more information, see the following paper.
+ *
+ * @code
+ * @inproceedings{ding2015yinyang,
+ *   title={Yinyang {K}-Means: A Drop-In Replacement of the Classic {K}-Means
+ *       with Consistent Speedup},
+ *   author={Ding, Yufei and Zhao, Yue and Shen, Xipeng and Musuvathi, Madanlal
+ *       and Mytkowicz, Todd},
+ *   booktitle={Proceedings of the 32nd International Conference on Machine
+ *       Learning (ICML '15)},
+ *   pages={579--587},
+ *   year={2015}
+ * }
+ * @endcode
+ */
+template<typename MetricType, typename MatType>
+class YinyangKMeans
+{
+ public:
+  /**
+   * Construct the YinyangKMeans object, which must store several sets of
+   * bounds.  If numGroups is 0, the centroids are clustered into k / 10
+   * groups (at least one).  To use a different number of groups with KMeans,
+   * derive a step type whose constructor passes it here.
+   *
+   * @param dataset Dataset to cluster.
+   * @param metric Instantiated metric.
+   * @param numGroups Number of groups of centroids (0 means k / 10).
+   */
+  YinyangKMeans(const MatType& dataset,
+                MetricType& metric,
+                const size_t numGroups = 0);
+
+  /**
+   * Run a single iteration of the Yinyang algorithm, updating the given
+   * centroids into the newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Current counts, to be overwritten with new counts.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the number of groups of centroids (0 means k / 10).
+  size_t NumGroups() const { return numGroups; }
+
+ private:
+  //! Cluster the given centroids into groups, and reset the bounds of all
+  //! points by computing their distances to all centroids.
+  void Initialize(const arma::mat& centroids);
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The number of groups requested (0 means k / 10).
+  size_t numGroups;
+
+  //! The centroids of each group.
+  std::vector<std::vector<size_t>> groups;
+  //! The group of each centroid.
+  arma::Col<size_t> centroidGroups;
+  //! The centroids that the bounds are relative to.
+  arma::mat lastCentroids;
+
+  //! Upper bounds for each point.
+  arma::vec upperBounds;
+  //! Lower bounds for each group (rows) and each point (columns).
+  arma::mat lowerBounds;
+  //! Assignments for each point.
+  arma::Col<size_t> assignments;
+
+  //! Track distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "yinyang_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,298 @@
+/**
+ * @file methods/kmeans/yinyang_kmeans_impl.hpp
+ *
+ * An implementation of the Yinyang algorithm for k-means clustering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_YINYANG_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_YINYANG_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "yinyang_kmeans.hpp"
+
+namespace mlpack {
+
+template<typename MetricType, typename MatType>
+YinyangKMeans<MetricType, MatType>::YinyangKMeans(const MatType& dataset,
+                                                  MetricType& metric,
+                                                  const size_t numGroups) :
+    dataset(dataset),
+    metric(metric),
+    numGroups(numGroups),
+    distanceCalculations(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename MatType>
+void YinyangKMeans<MetricType, MatType>::Initialize(const arma::mat& centroids)
+{
+  const size_t k = centroids.n_cols;
+  const size_t t = (numGroups == 0) ? std::max((size_t) 1, k / 10) :
+      std::min(numGroups, std::max((size_t) 1, k));
+
+  // Group the centroids with a few Lloyd iterations on the centroids
+  // themselves, starting from evenly spaced centroids.
+  arma::mat groupCentroids(centroids.n_rows, t);
+  for (size_t g = 0; g < t; ++g)
+    groupCentroids.col(g) = centroids.col(std::min(g * k / t, k - 1));
+
+  centroidGroups.zeros(k);
+  for (size_t iteration = 0; iteration < 5; ++iteration)
+  {
+    for (size_t c = 0; c < k; ++c)
+    {
+      double bestDistance = DBL_MAX;
+      for (size_t g = 0; g < t; ++g)
+      {
+        const double dist = metric.Evaluate(centroids.col(c),
+                                            groupCentroids.col(g));
+        if (dist < bestDistance)
+        {
+          bestDistance = dist;
+          centroidGroups[c] = g;
+        }
+      }
+    }
+    distanceCalculations += k * t;
+
+    // Groups that lost all their centroids keep their old centroid.
+    arma::mat sums(centroids.n_rows, t, arma::fill::zeros);
+    arma::Col<size_t> groupCounts(t, arma::fill::zeros);
+    for (size_t c = 0; c < k; ++c)
+    {
+      sums.col(centroidGroups[c]) += centroids.col(c);
+      ++groupCounts[centroidGroups[c]];
+    }
+
+    for (size_t g = 0; g < t; ++g)
+      if (groupCounts[g] > 0)
+        groupCentroids.col(g) = sums.col(g) / groupCounts[g];
+  }
+
+  groups.clear();
+  groups.resize(t);
+  for (size_t c = 0; c < k; ++c)
+    groups[centroidGroups[c]].push_back(c);
+
+  upperBounds.set_size(dataset.n_cols);
+  upperBounds.fill(DBL_MAX);
+  lowerBounds.set_size(t, dataset.n_cols);
+  lowerBounds.fill(DBL_MAX);
+  assignments.zeros(dataset.n_cols);
+}
+
+template<typename MetricType, typename MatType>
+double YinyangKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
+                                                   arma::mat& newCentroids,
+                                                   arma::Col<size_t>& counts)
+{
+  size_t yinyangPruned = 0;
+
+  // If this is the first iteration, we need to group the centroids and set all
+  // the bounds.
+  const bool firstIteration = (centroidGroups.n_elem != centroids.n_cols ||
+      upperBounds.n_elem != dataset.n_cols);
+  if (firstIteration)
+    Initialize(centroids);
+
+  // The bounds are relative to the centroids of the last iteration.  The drift
+  // of each centroid is computed here, and not at the end of the last
+  // iteration, because the empty cluster policy may have moved the centroids
+  // since.
+  arma::vec drifts(centroids.n_cols, arma::fill::zeros);
+  arma::vec maxDrifts(groups.size(), arma::fill::zeros);
+  if (!firstIteration)
+  {
+    for (size_t c = 0; c < centroids.n_cols; ++c)
+    {
+      drifts[c] = metric.Evaluate(lastCentroids.col(c), centroids.col(c));
+      maxDrifts[centroidGroups[c]] = std::max(maxDrifts[centroidGroups[c]],
+          drifts[c]);
+    }
+    distanceCalculations += centroids.n_cols;
+  }
+
+  // Reset new centroids.
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+
+  // Each thread only modifies the bounds of its own points, and accumulates
+  // its own centroids.
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+    arma::vec oldLowerBounds(groups.size());
+    size_t localPruned = 0;
+    size_t localDistanceCalculations = 0;
+
+    #pragma omp for schedule(dynamic, 256)
+    for (size_t i = 0; i < (size_t) dataset.n_cols; ++i)
+    {
+      if (firstIteration)
+      {
+        // Compute the distances to all centroids.
+        double upperBound = DBL_MAX;
+        for (size_t c = 0; c < centroids.n_cols; ++c)
+        {
+          const double dist = metric.Evaluate(dataset.col(i),
+                                              centroids.col(c));
+          if (dist < upperBound)
+          {
+            if (upperBound != DBL_MAX)
+            {
+              const size_t g = centroidGroups[assignments[i]];
+              lowerBounds(g, i) = std::min(lowerBounds(g, i), upperBound);
+            }
+
+            upperBound = dist;
+            assignments[i] = c;
+          }
+          else
+          {
+            const size_t g = centroidGroups[c];
+            lowerBounds(g, i) = std::min(lowerBounds(g, i), dist);
+          }
+        }
+        localDistanceCalculations += centroids.n_cols;
+        upperBounds(i) = upperBound;
+
+        localCentroids.col(assignments[i]) += dataset.col(i);
+        ++localCounts(assignments[i]);
+        continue;
+      }
+
+      // Update the bounds for the drift of the centroids.
+      const size_t oldAssignment = assignments[i];
+      upperBounds(i) += drifts[oldAssignment];
+      double globalLowerBound = DBL_MAX;
+      for (size_t g = 0; g < groups.size(); ++g)
+      {
+        oldLowerBounds[g] = lowerBounds(g, i);
+        lowerBounds(g, i) -= maxDrifts[g];
+        globalLowerBound = std::min(globalLowerBound, lowerBounds(g, i));
+      }
+
+      // The global filter.
+      if (upperBounds(i) <= globalLowerBound)
+      {
+        ++localPruned;
+        localCentroids.col(oldAssignment) += dataset.col(i);
+        ++localCounts(oldAssignment);
+        continue;
+      }
+
+      // Tighten the upper bound, and try the global filter again.
+      upperBounds(i) = metric.Evaluate(dataset.col(i),
+                                       centroids.col(oldAssignment));
+      ++localDistanceCalculations;
+      const double oldDistance = upperBounds(i);
+      if (upperBounds(i) <= globalLowerBound)
+      {
+        localCentroids.col(oldAssignment) += dataset.col(i);
+        ++localCounts(oldAssignment);
+        continue;
+      }
+
+      // Search the groups whose lower bound is below the upper bound (the
+      // group filter), and recompute their lower bounds.
+      for (size_t g = 0; g < groups.size(); ++g)
+      {
+        if (lowerBounds(g, i) >= upperBounds(i))
+          continue;
+
+        double newLowerBound = DBL_MAX;
+        for (size_t j = 0; j < groups[g].size(); ++j)
+        {
+          const size_t c = groups[g][j];
+          if (c == assignments[i])
+            continue;
+
+          double dist;
+          if (c == oldAssignment)
+          {
+            // We already know this distance.
+            dist = oldDistance;
+          }
+          else
+          {
+            // The local filter: the last lower bound of the group is a lower
+            // bound of the distance to each of its centroids before they
+            // moved.
+            const double bound = oldLowerBounds[g] - drifts[c];
+            if (bound >= upperBounds(i))
+            {
+              newLowerBound = std::min(newLowerBound, bound);
+              continue;
+            }
+
+            dist = metric.Evaluate(dataset.col(i), centroids.col(c));
+            ++localDistanceCalculations;
+          }
+
+          if (dist < upperBounds(i))
+          {
+            // The old closest centroid is now a candidate for the lower bound
+            // of its group.
+            const size_t oldGroup = centroidGroups[assignments[i]];
+            if (oldGroup == g)
+              newLowerBound = std::min(newLowerBound, upperBounds(i));
+            else
+              lowerBounds(oldGroup, i) = std::min(lowerBounds(oldGroup, i),
+                  upperBounds(i));
+
+            upperBounds(i) = dist;
+            assignments[i] = c;
+          }
+          else
+          {
+            newLowerBound = std::min(newLowerBound, dist);
+          }
+        }
+
+        lowerBounds(g, i) = newLowerBound;
+      }
+
+      // Update new centroids.
+      localCentroids.col(assignments[i]) += dataset.col(i);
+      ++localCounts(assignments[i]);
+    }
+
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+      yinyangPruned += localPruned;
+      distanceCalculations += localDistanceCalculations;
+    }
+  }
+
+  // Normalize centroids and calculate cluster movement.
+  double centroidMovement = 0.0;
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    if (counts(c) > 0)
+      newCentroids.col(c) /= counts(c);
+
+    // Calculate movement.
+    const double movement = metric.Evaluate(centroids.col(c),
+                                            newCentroids.col(c));
+    centroidMovement += std::pow(movement, 2.0);
+    ++distanceCalculations;
+  }
+  lastCentroids = centroids;
+
+  Log::Info << "Yinyang prunes: " << yinyangPruned << ".\n";
+
+  return std::sqrt(centroidMovement);
+}
+
+} // namespace mlpack
+
+#endif
@@ -94,7 +94,9 @@ class LARS
    * Set the parameters to LARS.  Both lambda1 and lambda2 default to 0.
    *
    * @param useCholesky Whether or not to use Cholesky decomposition when
-   *    solving linear system (as opposed to using the full Gram matrix).
+   *    solving linear system (as opposed to using the full Gram matrix).  The
+   *    Cholesky factor is updated with a rank-one insertion or deletion each
+   *    time the active set changes.
    * @param lambda1 Regularization parameter for l1-norm penalty.
    * @param lambda2 Regularization parameter for l2-norm penalty.
    * @param tolerance Run until the maximum correlation of elements in (X^T y)
@@ -106,7 +108,7 @@ class LARS
    * @param normalizeData If true, normalize all features to have unit variance
    * for training.
    */
-  LARS(const bool useCholesky = false,
+  LARS(const bool useCholesky = true,
        const ElemType lambda1 = 0.0,
        const ElemType lambda2 = 0.0,
        const ElemType tolerance = 1e-16,
@@ -171,7 +173,7 @@ class LARS
   LARS(const MatType& data,
        const ResponsesType& responses,
        bool colMajor = true,
-       const bool useCholesky = false,
+       const bool useCholesky = true,
        const ElemType lambda1 = 0.0,
        const ElemType lambda2 = 0.0,
        const ElemType tolerance = 1e-16,
@@ -491,6 +493,54 @@ class LARS
                  const bool fitIntercept,
                  const bool normalizeData);
 
+  /**
+   * Run LARS on many sets of responses for the same data, with the current
+   * settings (lambda1, lambda2, tolerance, whether to use the Cholesky
+   * decomposition, fit an intercept, and normalize the data).  The data is
+   * preprocessed and its Gram matrix is computed only once (or the Gram matrix
+   * given to the constructor or to Train() is used, if it has the right size),
+   * and the problems are solved in parallel.  The model itself is not
+   * modified.
+   *
+   * This is useful when the same "dictionary" is used to encode many points,
+   * as in SparseCoding: the dictionary is the data (in row-major form, with
+   * `colMajor = false`), and each column of `responses` is a point.
+   *
+   * @param data Input data.
+   * @param responses Sets of targets; each column holds the targets of one
+   *     problem, for each point in `data`.
+   * @param betas Will be set to the solution of each problem, one column per
+   *     column of `responses`.
+   * @param colMajor Should be true if the input data is column-major.  Passing
+   *     row-major data can avoid a transpose operation.
+   */
+  template<typename MatType, typename ResponsesMatType>
+  void TrainBatch(const MatType& data,
+                  const ResponsesMatType& responses,
+                  DenseMatType& betas,
+                  const bool colMajor = true) const;
+
+  /**
+   * Run LARS on many sets of responses for the same data, with the current
+   * settings, and also return the intercept of each solution (0 if no
+   * intercept is fitted).  See the other overload of TrainBatch() for details.
+   *
+   * @param data Input data.
+   * @param responses Sets of targets; each column holds the targets of one
+   *     problem, for each point in `data`.
+   * @param betas Will be set to the solution of each problem, one column per
+   *     column of `responses`.
+   * @param intercepts Will be set to the intercept of each solution.
+   * @param colMajor Should be true if the input data is column-major.  Passing
+   *     row-major data can avoid a transpose operation.
+   */
+  template<typename MatType, typename ResponsesMatType>
+  void TrainBatch(const MatType& data,
+                  const ResponsesMatType& responses,
+                  DenseMatType& betas,
+                  arma::Row<ElemType>& intercepts,
+                  const bool colMajor = true) const;
+
   /**
    * Predict y_i for the given data point.
    *
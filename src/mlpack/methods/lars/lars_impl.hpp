@@ -603,11 +603,17 @@ LARS<ModelMatType>::Train(const MatType& matX,
   {
     lambdaPath[0] = lambda1;
 
+    interceptPath.clear();
     if (fitIntercept)
       interceptPath.push_back(this->offsetY - dot(offsetX, betaPath[0]));
     else
       interceptPath.push_back(0.0);
 
+    // The model is the (zero) first element of the path, also when this object
+    // was trained before.
+    selectedLambda1 = lambda1;
+    selectedIndex = 0;
+
     return maxCorr;
   }
 
@@ -954,6 +960,104 @@ LARS<ModelMatType>::Train(const MatType& matX,
   return ComputeError(matX, y, colMajor);
 }
 
+template<typename ModelMatType>
+template<typename MatType, typename ResponsesMatType>
+inline void LARS<ModelMatType>::TrainBatch(
+    const MatType& data,
+    const ResponsesMatType& responses,
+    typename LARS<ModelMatType>::DenseMatType& betas,
+    const bool colMajor) const
+{
+  arma::Row<ElemType> intercepts;
+  TrainBatch(data, responses, betas, intercepts, colMajor);
+}
+
+template<typename ModelMatType>
+template<typename MatType, typename ResponsesMatType>
+inline void LARS<ModelMatType>::TrainBatch(
+    const MatType& data,
+    const ResponsesMatType& responses,
+    typename LARS<ModelMatType>::DenseMatType& betas,
+    arma::Row<ElemType>& intercepts,
+    const bool colMajor) const
+{
+  // Preprocess the data only once: make it row-major, center it, and normalize
+  // it, as in Train().
+  DenseMatType dataTrans = colMajor ? ConvTo<DenseMatType>::From(data.t()) :
+      ConvTo<DenseMatType>::From(data);
+  const size_t numPoints = dataTrans.n_rows;
+  if (responses.n_rows != numPoints)
+  {
+    std::ostringstream oss;
+    oss << "LARS::TrainBatch(): the responses have " << responses.n_rows
+        << " rows, but there are " << numPoints << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::Col<ElemType> offsetX; // used only if fitting an intercept
+  arma::Col<ElemType> stdX; // used only if normalizing
+  if (fitIntercept)
+  {
+    offsetX = arma::mean(dataTrans, 0).t();
+    dataTrans.each_row() -= offsetX.t();
+  }
+
+  if (normalizeData)
+  {
+    stdX = arma::stddev(dataTrans, 0, 0).t();
+    stdX.replace(0.0, 1.0); // Make sure we don't divide by 0!
+    dataTrans.each_row() /= stdX.t();
+  }
+
+  // Compute the Gram matrix once, for all the problems, unless we were given
+  // one that matches the data.  As in Train(), lambda2 is only added to the
+  // diagonal when the Cholesky decomposition is not used.
+  DenseMatType gramInternal;
+  const DenseMatType* gram = matGram;
+  if (matGram == &matGramInternal ||
+      matGram->n_elem != dataTrans.n_cols * dataTrans.n_cols)
+  {
+    gramInternal = dataTrans.t() * dataTrans;
+    if (lambda1 != 0 && lambda2 != 0 && !useCholesky)
+      gramInternal.diag() += lambda2;
+    gram = &gramInternal;
+  }
+
+  betas.set_size(dataTrans.n_cols, responses.n_cols);
+  intercepts.set_size(responses.n_cols);
+
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    // Each thread solves its problems with its own LARS object, whose
+    // workspace (path, active set, Cholesky factor) is reused from one problem
+    // to the next.  The data is already preprocessed, so each problem is
+    // solved on the row-major data directly, without any copy.
+    LARS<ModelMatType> lars(useCholesky, lambda1, lambda2, tolerance, false,
+        false);
+
+    #pragma omp for schedule(dynamic)
+    for (size_t i = 0; i < (size_t) responses.n_cols; ++i)
+    {
+      arma::Row<ElemType> y = ConvTo<arma::Row<ElemType>>::From(
+          responses.col(i).t());
+      ElemType offsetY = 0;
+      if (fitIntercept)
+      {
+        offsetY = arma::mean(y);
+        y -= offsetY;
+      }
+
+      lars.Train(dataTrans, y, false, useCholesky, *gram);
+
+      betas.col(i) = lars.Beta();
+      if (normalizeData)
+        betas.col(i) /= stdX;
+
+      intercepts[i] = fitIntercept ? offsetY - dot(offsetX, betas.col(i)) : 0;
+    }
+  }
+}
+
 template<typename ModelMatType>
 template<typename VecType>
 inline typename LARS<ModelMatType>::ElemType LARS<ModelMatType>::Predict(
@@ -1231,21 +1335,19 @@ inline void LARS<ModelMatType>::CholeskyInsert(
   }
   else
   {
-    DenseMatType matNewR(n + 1, n + 1);
-
     if (elasticNet)
       sqNormNewX += lambda2;
 
     arma::Col<ElemType> matUtriCholFactork =
         solve(trimatl(trans(matUtriCholFactor)), newGramCol);
 
-    matNewR(arma::span(0, n - 1), arma::span(0, n - 1)) = matUtriCholFactor;
-    matNewR(arma::span(0, n - 1), n) = matUtriCholFactork;
-    matNewR(n, arma::span(0, n - 1)).fill(0.0);
-    matNewR(n, n) = std::sqrt(sqNormNewX - dot(matUtriCholFactork,
-                                               matUtriCholFactork));
-
-    matUtriCholFactor = std::move(matNewR);
+    // Grow the factor in place: the existing elements are kept, and the new
+    // last row is zero, except for the new diagonal element.
+    matUtriCholFactor.resize(n + 1, n + 1);
+    matUtriCholFactor(arma::span(0, n - 1), n) = matUtriCholFactork;
+    matUtriCholFactor(n, arma::span(0, n - 1)).fill(0.0);
+    matUtriCholFactor(n, n) = std::sqrt(sqNormNewX - dot(matUtriCholFactork,
+        matUtriCholFactork));
   }
 }
 
@@ -18,6 +18,7 @@
 // RegressionDistribution.  Therefore we have to include the prereqs first, and
 // include the core later.
 #include <mlpack/prereqs.hpp>
+#include "linear_regression_statistics.hpp"
 
 namespace mlpack {
 
@@ -299,6 +300,32 @@ class LinearRegression
                  const double lambda,
                  const bool intercept);
 
+  /**
+   * Train the LinearRegression model from the sufficient statistics of a
+   * dataset, accumulated (possibly one chunk at a time, or by several threads
+   * or processes) with LinearRegressionStatistics.  Careful!  This will
+   * completely ignore and overwrite the existing model.  The current value of
+   * lambda is used, and the intercept setting of the statistics is used.
+   *
+   * @param statistics Sufficient statistics of the dataset to train on.
+   * @return The (weighted) least squares error after training.
+   */
+  ElemType Train(const LinearRegressionStatistics<ModelMatType>& statistics);
+
+  /**
+   * Train the LinearRegression model from the sufficient statistics of a
+   * dataset, accumulated (possibly one chunk at a time, or by several threads
+   * or processes) with LinearRegressionStatistics.  Careful!  This will
+   * completely ignore and overwrite the existing model.  The intercept setting
+   * of the statistics is used.
+   *
+   * @param statistics Sufficient statistics of the dataset to train on.
+   * @param lambda L2 regularization penalty parameter to use.
+   * @return The (weighted) least squares error after training.
+   */
+  ElemType Train(const LinearRegressionStatistics<ModelMatType>& statistics,
+                 const double lambda);
+
   /**
    * Calculate y_i for a single data point.
    *
@@ -215,6 +215,48 @@ LinearRegression<ModelMatType>::Train(const MatType& predictors,
   return ComputeError(predictors, responses);
 }
 
+template<typename ModelMatType>
+inline
+typename LinearRegression<ModelMatType>::ElemType
+LinearRegression<ModelMatType>::Train(
+    const LinearRegressionStatistics<ModelMatType>& statistics)
+{
+  return Train(statistics, this->lambda);
+}
+
+template<typename ModelMatType>
+inline
+typename LinearRegression<ModelMatType>::ElemType
+LinearRegression<ModelMatType>::Train(
+    const LinearRegressionStatistics<ModelMatType>& statistics,
+    const double lambda)
+{
+  if (statistics.NumPoints() == 0)
+  {
+    throw std::invalid_argument("LinearRegression::Train(): the statistics "
+        "have no points!");
+  }
+
+  this->lambda = lambda;
+  this->intercept = statistics.Intercept();
+
+  // The statistics hold X X^T and X y^T, so we only have to solve
+  // a * (X X^T + lambda I) = y X^T, as in the other Train() overloads.  This is
+  // O(d^3), whatever the number of points.
+  const arma::Mat<ElemType>& gram = statistics.Gram();
+  arma::Mat<ElemType> cov = gram +
+      ((ElemType) lambda) * arma::eye<arma::Mat<ElemType>>(gram.n_rows,
+      gram.n_cols);
+
+  parameters = arma::solve(cov, statistics.Cross());
+
+  // The (weighted) squared error is y y^T - 2 a^T X y^T + a^T X X^T a.
+  const ElemType error = statistics.SquaredResponses() -
+      2 * dot(parameters, statistics.Cross()) +
+      as_scalar(parameters.t() * gram * parameters);
+  return std::max(error, ElemType(0)) / statistics.TotalWeight();
+}
+
 template<typename ModelMatType>
 template<typename VecType>
 inline
@@ -0,0 +1,160 @@
+/**
+ * @file methods/linear_regression/linear_regression_statistics.hpp
+ *
+ * Sufficient statistics of a (ridge) least squares problem, which can be
+ * accumulated over chunks of a dataset and merged, so that LinearRegression
+ * can be trained on datasets that do not fit in memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_STATISTICS_HPP
+#define MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * LinearRegressionStatistics holds the sufficient statistics of the least
+ * squares problem solved by LinearRegression: the matrix X X^T, the vector
+ * X y^T, the sum of the squared responses and the total weight of the points,
+ * where X is the matrix of predictors (with a row of ones on top, if an
+ * intercept is fitted) and y the responses, both scaled by the square root of
+ * the instance weights, if any.
+ *
+ * The statistics of a dataset are the sums of the statistics of its chunks, so
+ * they can be accumulated one chunk at a time with Accumulate(), and the
+ * statistics accumulated separately (by several threads, or processes, after
+ * serialization) can be combined with Merge().  LinearRegression::Train() then
+ * solves the problem once, from the statistics only.  Only O(d^2) memory is
+ * needed, whatever the number of points.
+ *
+ * @code
+ * data::ChunkedLoader loader("huge_dataset.csv", 100000);
+ * // The responses are the last dimension of each point.
+ * LinearRegressionStatistics<> statistics;
+ * statistics.AccumulateChunks(loader);
+ *
+ * LinearRegression<> lr;
+ * lr.Train(statistics, 0.1);
+ * @endcode
+ *
+ * @tparam ModelMatType Matrix type of the LinearRegression model.
+ */
+template<typename ModelMatType = arma::mat>
+class LinearRegressionStatistics
+{
+ public:
+  typedef typename ModelMatType::elem_type ElemType;
+
+  /**
+   * Create empty statistics.  If the dimensionality is 0, it is set by the
+   * first call to Accumulate().
+   *
+   * @param dimensionality Dimensionality of the predictors.
+   * @param intercept Whether or not to include an intercept term.
+   */
+  LinearRegressionStatistics(const size_t dimensionality = 0,
+                             const bool intercept = true);
+
+  /**
+   * Add the statistics of the given points.
+   *
+   * @param predictors X, matrix of data points.
+   * @param responses y, the measured data for each point in X.
+   */
+  template<typename MatType, typename ResponsesType>
+  void Accumulate(const MatType& predictors, const ResponsesType& responses);
+
+  /**
+   * Add the statistics of the given points, with the given instance weights.
+   *
+   * @param predictors X, matrix of data points.
+   * @param responses y, the measured data for each point in X.
+   * @param weights Instance weights.
+   */
+  template<typename MatType, typename ResponsesType, typename WeightsType>
+  void Accumulate(const MatType& predictors,
+                  const ResponsesType& responses,
+                  const WeightsType& weights);
+
+  /**
+   * Add the statistics of all the points read by the given loader (such as a
+   * data::ChunkedLoader), one chunk at a time.  The last dimension of each
+   * point is its response; the other dimensions are its predictors.  The
+   * loader is reset first.
+   *
+   * @param loader Loader of the dataset, with a Reset() and a Next() method.
+   * @return The number of points that were read.
+   */
+  template<typename LoaderType>
+  size_t AccumulateChunks(LoaderType& loader);
+
+  /**
+   * Add the given statistics, accumulated separately, to these statistics.
+   * A std::invalid_argument is thrown if the statistics do not have the same
+   * dimensionality and intercept setting.
+   *
+   * @param other Statistics to add.
+   */
+  void Merge(const LinearRegressionStatistics& other);
+
+  /**
+   * Reset the statistics, as if no point had been accumulated.
+   */
+  void Reset();
+
+  //! Get the dimensionality of the predictors.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Get whether or not an intercept term is included.
+  bool Intercept() const { return intercept; }
+  //! Get the number of points accumulated.
+  size_t NumPoints() const { return numPoints; }
+  //! Get the total weight of the points accumulated.
+  ElemType TotalWeight() const { return totalWeight; }
+
+  //! Get the matrix X X^T.
+  const arma::Mat<ElemType>& Gram() const { return gram; }
+  //! Get the vector X y^T.
+  const arma::Col<ElemType>& Cross() const { return cross; }
+  //! Get the sum of the squared responses, y y^T.
+  ElemType SquaredResponses() const { return squaredResponses; }
+
+  /**
+   * Serialize the statistics.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Number of points of each block of the parallel accumulation.
+  static const size_t blockSize = 4096;
+
+  //! Allocate the statistics for the given dimensionality.
+  void Allocate(const size_t newDimensionality);
+
+  //! Dimensionality of the predictors.
+  size_t dimensionality;
+  //! Whether or not an intercept term is included.
+  bool intercept;
+  //! Number of points accumulated.
+  size_t numPoints;
+  //! Total weight of the points accumulated.
+  ElemType totalWeight;
+  //! The matrix X X^T.
+  arma::Mat<ElemType> gram;
+  //! The vector X y^T.
+  arma::Col<ElemType> cross;
+  //! The sum of the squared responses.
+  ElemType squaredResponses;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "linear_regression_statistics_impl.hpp"
+
+#endif
@@ -0,0 +1,230 @@
+/**
+ * @file methods/linear_regression/linear_regression_statistics_impl.hpp
+ *
+ * Implementation of the sufficient statistics of LinearRegression.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_STATISTICS_IMPL_HPP
+#define MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_STATISTICS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "linear_regression_statistics.hpp"
+
+namespace mlpack {
+
+template<typename ModelMatType>
+LinearRegressionStatistics<ModelMatType>::LinearRegressionStatistics(
+    const size_t dimensionality,
+    const bool intercept) :
+    dimensionality(0),
+    intercept(intercept),
+    numPoints(0),
+    totalWeight(0),
+    squaredResponses(0)
+{
+  if (dimensionality > 0)
+    Allocate(dimensionality);
+}
+
+template<typename ModelMatType>
+template<typename MatType, typename ResponsesType>
+void LinearRegressionStatistics<ModelMatType>::Accumulate(
+    const MatType& predictors,
+    const ResponsesType& responses)
+{
+  Accumulate(predictors, responses, arma::Row<ElemType>());
+}
+
+template<typename ModelMatType>
+template<typename MatType, typename ResponsesType, typename WeightsType>
+void LinearRegressionStatistics<ModelMatType>::Accumulate(
+    const MatType& predictors,
+    const ResponsesType& responses,
+    const WeightsType& weights)
+{
+  util::CheckSameSizes(predictors, responses,
+      "LinearRegressionStatistics::Accumulate()");
+  if (weights.n_elem > 0)
+  {
+    util::CheckSameSizes(predictors, weights,
+        "LinearRegressionStatistics::Accumulate()", "weights");
+  }
+
+  if (predictors.n_cols == 0)
+    return;
+
+  if (dimensionality == 0)
+  {
+    Allocate(predictors.n_rows);
+  }
+  else if (predictors.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "LinearRegressionStatistics::Accumulate(): the predictors have "
+        << predictors.n_rows << " dimensions, but the statistics have "
+        << dimensionality << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t offset = intercept ? 1 : 0;
+  const size_t numBlocks = (predictors.n_cols + (size_t) blockSize - 1) /
+      (size_t) blockSize;
+
+  // Each thread accumulates the statistics of its blocks of points, and they
+  // are summed at the end.  Only one block of points is converted to a dense
+  // matrix at a time.
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    arma::Mat<ElemType> threadGram(gram.n_rows, gram.n_cols,
+        arma::fill::zeros);
+    arma::Col<ElemType> threadCross(cross.n_elem, arma::fill::zeros);
+    ElemType threadSquaredResponses = 0;
+    ElemType threadWeight = 0;
+
+    #pragma omp for schedule(dynamic)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * (size_t) blockSize;
+      const size_t end = std::min(begin + (size_t) blockSize,
+          (size_t) predictors.n_cols);
+
+      arma::Mat<ElemType> p(gram.n_rows, end - begin);
+      if (intercept)
+        p.row(0).ones();
+      p.rows(offset, p.n_rows - 1) = ConvTo<arma::Mat<ElemType>>::From(
+          predictors.cols(begin, end - 1));
+      arma::Row<ElemType> r = ConvTo<arma::Row<ElemType>>::From(
+          responses.cols(begin, end - 1));
+
+      if (weights.n_elem > 0)
+      {
+        const arma::Row<ElemType> w = ConvTo<arma::Row<ElemType>>::From(
+            weights.cols(begin, end - 1));
+        p.each_row() %= sqrt(w);
+        r %= sqrt(w);
+        threadWeight += accu(w);
+      }
+      else
+      {
+        threadWeight += (ElemType) (end - begin);
+      }
+
+      threadGram += p * p.t();
+      threadCross += p * r.t();
+      threadSquaredResponses += dot(r, r);
+    }
+
+    #pragma omp critical
+    {
+      gram += threadGram;
+      cross += threadCross;
+      squaredResponses += threadSquaredResponses;
+      totalWeight += threadWeight;
+    }
+  }
+
+  numPoints += predictors.n_cols;
+}
+
+template<typename ModelMatType>
+template<typename LoaderType>
+size_t LinearRegressionStatistics<ModelMatType>::AccumulateChunks(
+    LoaderType& loader)
+{
+  loader.Reset();
+  if (loader.Dimensionality() < 2)
+  {
+    std::ostringstream oss;
+    oss << "LinearRegressionStatistics::AccumulateChunks(): the points have "
+        << loader.Dimensionality() << " dimensions, but at least 2 are needed "
+        << "(the predictors, then the response)!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  size_t points = 0;
+  arma::Mat<ElemType> chunk;
+  while (loader.Next(chunk))
+  {
+    Accumulate(chunk.rows(0, chunk.n_rows - 2),
+        chunk.row(chunk.n_rows - 1));
+    points += chunk.n_cols;
+  }
+
+  return points;
+}
+
+template<typename ModelMatType>
+void LinearRegressionStatistics<ModelMatType>::Merge(
+    const LinearRegressionStatistics& other)
+{
+  if (other.intercept != intercept)
+  {
+    throw std::invalid_argument("LinearRegressionStatistics::Merge(): cannot "
+        "merge statistics with and without an intercept term!");
+  }
+
+  if (other.dimensionality == 0)
+    return;
+
+  if (dimensionality == 0)
+  {
+    Allocate(other.dimensionality);
+  }
+  else if (other.dimensionality != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "LinearRegressionStatistics::Merge(): the statistics have "
+        << dimensionality << " dimensions, but the other statistics have "
+        << other.dimensionality << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  gram += other.gram;
+  cross += other.cross;
+  squaredResponses += other.squaredResponses;
+  totalWeight += other.totalWeight;
+  numPoints += other.numPoints;
+}
+
+template<typename ModelMatType>
+void LinearRegressionStatistics<ModelMatType>::Reset()
+{
+  numPoints = 0;
+  totalWeight = 0;
+  squaredResponses = 0;
+  gram.zeros();
+  cross.zeros();
+}
+
+template<typename ModelMatType>
+void LinearRegressionStatistics<ModelMatType>::Allocate(
+    const size_t newDimensionality)
+{
+  dimensionality = newDimensionality;
+  const size_t size = dimensionality + (intercept ? 1 : 0);
+  gram.zeros(size, size);
+  cross.zeros(size);
+}
+
+template<typename ModelMatType>
+template<typename Archive>
+void LinearRegressionStatistics<ModelMatType>::serialize(
+    Archive& ar,
+    const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(dimensionality));
+  ar(CEREAL_NVP(intercept));
+  ar(CEREAL_NVP(numPoints));
+  ar(CEREAL_NVP(totalWeight));
+  ar(CEREAL_NVP(gram));
+  ar(CEREAL_NVP(cross));
+  ar(CEREAL_NVP(squaredResponses));
+}
+
+} // namespace mlpack
+
+#endif
@@ -395,7 +395,7 @@ class LinearSVM
    * class label for each point.
    * The function calculates the scores for every class, given a data
    * point. It then chooses the class which has the highest probability among
-   * all.
+   * all.  The points are classified in parallel, in blocks of points.
    *
    * @param data Matrix of data points to be classified.
    * @param labels Predicted labels for each point.
@@ -489,6 +489,9 @@ class LinearSVM
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
+  //! Number of points of each block of points classified in parallel.
+  static const size_t blockSize = 1024;
+
   //! Parameters after optimization.
   ModelMatType parameters;
   //! Number of classes.
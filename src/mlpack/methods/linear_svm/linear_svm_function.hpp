@@ -115,6 +115,12 @@ class LinearSVMFunction
    * Evaluate the gradient of the hinge loss function, following
    * the LinearFunctionType requirements on the Gradient function.
    *
+   * If GradType is a sparse matrix type (as used by ens::ParallelSGD), the
+   * gradient only holds the weights of the nonzero features of the points in
+   * the batch (and the intercepts), for the classes whose margin is violated;
+   * the regularization is only applied to these weights.  So, Hogwild-style
+   * optimizers only update the weights that the batch actually depends on.
+   *
    * @tparam GradType Type of the gradient matrix.
    * @param parameters The parameters of the SVM.
    * @param firstId Index of the datapoint to use for the gradient evaluation.
@@ -168,9 +174,9 @@ class LinearSVMFunction
   ParametersType& InitialPoint() { return initialPoint; }
 
   //! Get the dataset.
-  const SparseMatType& Dataset() const { return dataset; }
+  const MatType& Dataset() const { return dataset; }
   //! Modify the dataset.
-  SparseMatType& Dataset() { return dataset; }
+  MatType& Dataset() { return dataset; }
 
   //! Sets the regularization parameter.
   double& Lambda() { return lambda; }
@@ -184,6 +190,28 @@ class LinearSVMFunction
   size_t NumFunctions() const;
 
  private:
+  /**
+   * Compute the dense gradient of the hinge loss function on the specified
+   * datapoints.
+   */
+  template<typename GradType>
+  void Gradient(const ParametersType& parameters,
+                const size_t firstId,
+                GradType& gradient,
+                const size_t batchSize,
+                const std::false_type& /* sparse */) const;
+
+  /**
+   * Compute the sparse gradient of the hinge loss function on the specified
+   * datapoints, holding only the weights that the datapoints depend on.
+   */
+  template<typename GradType>
+  void Gradient(const ParametersType& parameters,
+                const size_t firstId,
+                GradType& gradient,
+                const size_t batchSize,
+                const std::true_type& /* sparse */) const;
+
   //! The initial point, from which to start the optimization.
   ParametersType initialPoint;
 
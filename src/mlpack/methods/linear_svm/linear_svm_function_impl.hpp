@@ -110,36 +110,25 @@ void LinearSVMFunction<MatType, ParametersType>::GetGroundTruthMatrix(
 template<typename MatType, typename ParametersType>
 void LinearSVMFunction<MatType, ParametersType>::Shuffle()
 {
-  // Determine new ordering.
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      dataset.n_cols - 1, dataset.n_cols));
-
-  // Re-sort data.
-  MatType newData = dataset.cols(ordering);
-  ClearAlias(dataset);
-  dataset = std::move(newData);
-
-  // Assemble data for batch constructor.  We need reverse orderings though...
-  arma::uvec reverseOrdering(ordering.n_elem);
-  for (size_t i = 0; i < ordering.n_elem; ++i)
-    reverseOrdering[ordering[i]] = i;
-
-  arma::umat newLocations(2, groundTruth.n_nonzero);
-  DenseColType values(groundTruth.n_nonzero);
+  // Recover the labels from the ground truth matrix, so that the points and
+  // their labels can be shuffled together (for dense and sparse data).
+  arma::Row<size_t> labels(groundTruth.n_cols);
   typename SparseMatType::const_iterator it = groundTruth.begin();
-  size_t loc = 0;
   while (it != groundTruth.end())
   {
-    newLocations(0, loc) = it.row();
-    newLocations(1, loc) = reverseOrdering(it.col());
-    values(loc) = (*it);
-
+    labels[it.col()] = it.row();
     ++it;
-    ++loc;
   }
 
-  groundTruth = SparseMatType(newLocations, values, groundTruth.n_rows,
-                              groundTruth.n_cols);
+  MatType newData;
+  arma::Row<size_t> newLabels;
+  ShuffleData(dataset, labels, newData, newLabels);
+
+  // If we are an alias, make sure we don't write to the original data.
+  ClearAlias(dataset);
+  dataset = std::move(newData);
+
+  GetGroundTruthMatrix(newLabels, groundTruth);
 }
 
 template<typename MatType, typename ParametersType>
@@ -217,8 +206,7 @@ LinearSVMFunction<MatType, ParametersType>::Evaluate(
   {
     scores = parameters.rows(0, dataset.n_rows - 1).t()
         * dataset.cols(firstId, lastId)
-        + repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
+        + repmat(parameters.row(dataset.n_rows).t(), 1, batchSize);
   }
 
   DenseMatType margin = scores - (repmat(arma::ones(numClasses).t()
@@ -307,6 +295,19 @@ void LinearSVMFunction<MatType, ParametersType>::Gradient(
     const size_t firstId,
     GradType& gradient,
     const size_t batchSize) const
+{
+  Gradient(parameters, firstId, gradient, batchSize,
+      std::integral_constant<bool, arma::is_SpMat<GradType>::value>());
+}
+
+template<typename MatType, typename ParametersType>
+template<typename GradType>
+void LinearSVMFunction<MatType, ParametersType>::Gradient(
+    const ParametersType& parameters,
+    const size_t firstId,
+    GradType& gradient,
+    const size_t batchSize,
+    const std::false_type& /* sparse */) const
 {
   const size_t lastId = firstId + batchSize - 1;
 
@@ -357,6 +358,110 @@ void LinearSVMFunction<MatType, ParametersType>::Gradient(
   gradient += lambda * parameters;
 }
 
+template<typename MatType, typename ParametersType>
+template<typename GradType>
+void LinearSVMFunction<MatType, ParametersType>::Gradient(
+    const ParametersType& parameters,
+    const size_t firstId,
+    GradType& gradient,
+    const size_t batchSize,
+    const std::true_type& /* sparse */) const
+{
+  typedef typename MatType::elem_type DataElemType;
+
+  const size_t lastId = firstId + batchSize - 1;
+
+  // Scores for each class are evaluated.
+  DenseMatType scores;
+
+  // Check intercept condition.
+  if (!fitIntercept)
+  {
+    scores = parameters.t() * dataset.cols(firstId, lastId);
+  }
+  else
+  {
+    scores = parameters.rows(0, dataset.n_rows - 1).t()
+        * dataset.cols(firstId, lastId)
+        + repmat(parameters.row(dataset.n_rows).t(), 1, batchSize);
+  }
+
+  DenseMatType margin = scores - (repmat(arma::ones(numClasses).t()
+      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
+      + delta - (delta * groundTruth.cols(firstId, lastId));
+
+  // For each sample, find the total number of classes where
+  // ( margin > 0 ).
+  DenseMatType mask = margin.for_each([](ElemType& val)
+      { val = (val > 0) ? 1: 0; });
+
+  DenseMatType difference = groundTruth.cols(firstId, lastId)
+      % (-repmat(sum(mask), numClasses, 1)) + mask;
+
+  // The weights of class m only get a gradient from the points whose margin
+  // is violated for class m, or whose label is m, and only for the nonzero
+  // features of these points.  Collect these entries; duplicates are summed
+  // when the gradient is assembled.
+  std::vector<arma::uword> rows, cols;
+  std::vector<ElemType> values;
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const arma::SpCol<DataElemType> point(dataset.col(firstId + i));
+    for (size_t m = 0; m < numClasses; ++m)
+    {
+      const ElemType d = difference(m, i) / batchSize;
+      if (d == 0)
+        continue;
+
+      typename arma::SpCol<DataElemType>::const_iterator it = point.begin();
+      while (it != point.end())
+      {
+        rows.push_back(it.row());
+        cols.push_back(m);
+        values.push_back(d * ElemType(*it));
+        ++it;
+      }
+
+      if (fitIntercept)
+      {
+        rows.push_back(dataset.n_rows);
+        cols.push_back(m);
+        values.push_back(d);
+      }
+    }
+  }
+
+  arma::umat locations(2, values.size());
+  DenseColType gradientValues(values.size());
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    locations(0, i) = rows[i];
+    locations(1, i) = cols[i];
+    gradientValues[i] = values[i];
+  }
+
+  gradient = GradType(true /* add duplicates */, locations, gradientValues,
+      parameters.n_rows, parameters.n_cols);
+
+  // Adding the regularization contribution to the weights in the gradient.
+  arma::umat regLocations(2, gradient.n_nonzero);
+  DenseColType regValues(gradient.n_nonzero);
+  typename GradType::const_iterator git = gradient.begin();
+  size_t loc = 0;
+  while (git != gradient.end())
+  {
+    regLocations(0, loc) = git.row();
+    regLocations(1, loc) = git.col();
+    regValues(loc) = lambda * parameters(git.row(), git.col());
+
+    ++git;
+    ++loc;
+  }
+
+  gradient += GradType(regLocations, regValues, parameters.n_rows,
+      parameters.n_cols);
+}
+
 template<typename MatType, typename ParametersType>
 template<typename GradType>
 typename LinearSVMFunction<MatType, ParametersType>::ElemType
@@ -285,21 +285,37 @@ void LinearSVM<ModelMatType>::Classify(
 {
   util::CheckSameDimensionality(data, FeatureSize(), "LinearSVM::Classify()");
 
-  if (fitIntercept)
-  {
-    scores = parameters.rows(0, parameters.n_rows - 2).t() * data
-        + repmat(parameters.row(parameters.n_rows - 1).t(), 1, data.n_cols);
-  }
-  else
-  {
-    scores = parameters.t() * data;
-  }
-
   // Prepare necessary data.
-  labels.zeros(data.n_cols);
+  scores.set_size(parameters.n_cols, data.n_cols);
+  labels.set_size(data.n_cols);
 
-  labels = ConvTo<arma::Row<size_t>>::From(
-      arma::index_max(scores));
+  // The points are classified in parallel, one block of points at a time, so
+  // that the scores of each block are computed with a single matrix product.
+  const size_t numBlocks = (data.n_cols + (size_t) blockSize - 1) /
+      (size_t) blockSize;
+
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * (size_t) blockSize;
+    const size_t end = std::min(begin + (size_t) blockSize,
+        (size_t) data.n_cols) - 1;
+
+    if (fitIntercept)
+    {
+      scores.cols(begin, end) = parameters.rows(0, parameters.n_rows - 2).t() *
+          data.cols(begin, end);
+      scores.cols(begin, end).each_col() +=
+          parameters.row(parameters.n_rows - 1).t();
+    }
+    else
+    {
+      scores.cols(begin, end) = parameters.t() * data.cols(begin, end);
+    }
+
+    labels.cols(begin, end) = ConvTo<arma::Row<size_t>>::From(
+        arma::index_max(scores.cols(begin, end)));
+  }
 }
 
 template<typename ModelMatType>
@@ -399,17 +399,20 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
           << trainingDimensionality << ")!" << endl;
     }
 
-    // Save class probabilities, if desired.
+    // Save class probabilities, if desired.  The points are classified only
+    // once, in parallel.
     if (params.Has("probabilities"))
     {
       Log::Info << "Calculating class probabilities of points in " << testOutput
           << "." << endl;
       arma::mat probabilities;
-      model->svm.Classify(testSet, predictions, probabilities);
+      model->svm.Classify(testSet, predictedLabels, probabilities);
       params.Get<arma::mat>("probabilities") = std::move(probabilities);
     }
-
-    model->svm.Classify(testSet, predictedLabels);
+    else
+    {
+      model->svm.Classify(testSet, predictedLabels);
+    }
     data::RevertLabels(predictedLabels, model->mappings, predictions);
 
     // Calculate accuracy, if desired.
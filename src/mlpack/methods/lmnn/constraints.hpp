@@ -40,10 +40,14 @@ class Constraints
    * @param dataset Input dataset.
    * @param labels Input dataset labels.
    * @param k Number of target neighbors, impostors & triplets.
+   * @param rebuildInterval Number of impostor searches after which the trees
+   *     over the impostor candidates are built again; in between, the trees
+   *     are only refitted to the new points (0 builds them for each search).
    */
   Constraints(const arma::mat& dataset,
               const arma::Row<size_t>& labels,
-              const size_t k);
+              const size_t k,
+              const size_t rebuildInterval = 10);
 
   /**
    * Calculates k similar labeled nearest neighbors and stores them into the
@@ -185,6 +189,13 @@ class Constraints
   //! Modify the number of target neighbors (k).
   size_t& K() { return k; }
 
+  //! Get the number of impostor searches after which the trees over the
+  //! impostor candidates are built again.
+  size_t RebuildInterval() const { return rebuildInterval; }
+  //! Modify the number of impostor searches after which the trees over the
+  //! impostor candidates are built again.
+  size_t& RebuildInterval() { return rebuildInterval; }
+
   //! Access the boolean value of precalculated.
   const bool& PreCalulated() const { return precalculated; }
   //! Modify the value of precalculated.
@@ -203,6 +214,19 @@ class Constraints
   //! Store indices of data points having different label.
   std::vector<arma::uvec> indexDiff;
 
+  //! Searchers over the differently labeled points of each class, whose trees
+  //! are reused by successive impostor searches.
+  std::vector<KNN> impostorSearchers;
+
+  //! Positions in indexDiff of the points of each impostor search tree.
+  std::vector<arma::uvec> impostorOldFromNew;
+
+  //! Number of impostor searches after which the trees are built again.
+  size_t rebuildInterval;
+
+  //! Number of times the trees were refitted since they were built.
+  size_t treeRefits;
+
   //! False if nothing has ever been precalculated.
   bool precalculated;
 
@@ -212,6 +236,23 @@ class Constraints
   */
   inline void Precalculate(const arma::Row<size_t>& labels);
 
+  /**
+  * Build the trees over the differently labeled points of each class on the
+  * given dataset, or, if they were built on the same points before a common
+  * transformation, refit their bounds to the new positions of the points.
+  */
+  inline void UpdateImpostorTrees(const arma::mat& dataset);
+
+  /**
+  * Search the k nearest differently labeled points of the given query points
+  * of the given class, with the tree built by UpdateImpostorTrees().  The
+  * neighbors are positions in indexDiff[label].
+  */
+  inline void SearchImpostors(const size_t label,
+                              const arma::mat& querySet,
+                              arma::Mat<size_t>& neighbors,
+                              arma::mat& distances);
+
   /**
   * Re-order neighbors on the basis of increasing norm in case
   * of ties among distances.
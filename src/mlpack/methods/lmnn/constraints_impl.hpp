@@ -21,8 +21,11 @@ template<typename MetricType>
 Constraints<MetricType>::Constraints(
     const arma::mat& /* dataset */,
     const arma::Row<size_t>& labels,
-    const size_t k) :
+    const size_t k,
+    const size_t rebuildInterval) :
     k(k),
+    rebuildInterval(rebuildInterval),
+    treeRefits(0),
     precalculated(false)
 {
   // Ensure a valid k is passed.
@@ -170,8 +173,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
+  // Build the trees over the impostor candidates, or refit them.
+  UpdateImpostorTrees(dataset);
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -180,8 +183,7 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   {
     // Perform KNN search with differently labeled points as reference
     // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
+    SearchImpostors(i, dataset.cols(indexSame[i]), neighbors, distances);
 
     // Re-order neighbors on the basis of increasing norm in case
     // of ties among distances.
@@ -208,8 +210,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
+  // Build the trees over the impostor candidates, or refit them.
+  UpdateImpostorTrees(dataset);
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -218,8 +220,7 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   {
     // Perform KNN search with differently labeled points as reference
     // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
+    SearchImpostors(i, dataset.cols(indexSame[i]), neighbors, distances);
 
     // Re-order neighbors on the basis of increasing norm in case
     // of ties among distances.
@@ -251,8 +252,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
-  // KNN instance.
-  KNN knn;
+  // Build the trees over the impostor candidates, or refit them.
+  UpdateImpostorTrees(dataset);
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -264,11 +265,12 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   {
     // Calculate impostors.
     subIndexSame = arma::find(sublabels == uniqueLabels[i]);
+    if (subIndexSame.n_elem == 0)
+      continue;
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
+    SearchImpostors(i, subDataset.cols(subIndexSame), neighbors, distances);
 
     // Re-order neighbors on the basis of increasing norm in case
     // of ties among distances.
@@ -300,8 +302,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
-  // KNN instance.
-  KNN knn;
+  // Build the trees over the impostor candidates, or refit them.
+  UpdateImpostorTrees(dataset);
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -313,11 +315,12 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   {
     // Calculate impostors.
     subIndexSame = arma::find(sublabels == uniqueLabels[i]);
+    if (subIndexSame.n_elem == 0)
+      continue;
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
+    SearchImpostors(i, subDataset.cols(subIndexSame), neighbors, distances);
 
     // Re-order neighbors on the basis of increasing norm in case
     // of ties among distances.
@@ -347,8 +350,11 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
+  if (numPoints == 0)
+    return;
+
+  // Build the trees over the impostor candidates, or refit them.
+  UpdateImpostorTrees(dataset);
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -361,12 +367,13 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
     // Calculate impostors.
     subIndexSame = arma::find(labels.cols(points.head(numPoints)) ==
         uniqueLabels[i]);
+    if (subIndexSame.n_elem == 0)
+      continue;
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(points.elem(subIndexSame)),
-        k, neighbors, distances);
+    SearchImpostors(i, dataset.cols(points.elem(subIndexSame)), neighbors,
+        distances);
 
     // Re-order neighbors on the basis of increasing norm in case
     // of ties among distances.
@@ -418,6 +425,62 @@ void Constraints<MetricType>::Triplets(arma::Mat<size_t>& outputMatrix,
   }
 }
 
+template<typename MetricType>
+inline void Constraints<MetricType>::UpdateImpostorTrees(
+    const arma::mat& dataset)
+{
+  bool rebuild = (impostorSearchers.size() != uniqueLabels.n_elem) ||
+      (treeRefits >= rebuildInterval);
+  for (size_t i = 0; i < impostorSearchers.size() && !rebuild; ++i)
+  {
+    if (impostorSearchers[i].ReferenceSet().n_rows != dataset.n_rows)
+      rebuild = true;
+  }
+
+  if (rebuild)
+  {
+    impostorSearchers.resize(uniqueLabels.n_elem);
+    impostorOldFromNew.resize(uniqueLabels.n_elem);
+    for (size_t i = 0; i < uniqueLabels.n_elem; ++i)
+    {
+      std::vector<size_t> oldFromNew;
+      typename KNN::Tree tree(arma::mat(dataset.cols(indexDiff[i])),
+          oldFromNew);
+      impostorOldFromNew[i] = ConvTo<arma::uvec>::From(oldFromNew);
+      impostorSearchers[i].Train(std::move(tree));
+    }
+
+    treeRefits = 0;
+    return;
+  }
+
+  // The points were all mapped by the same transformation, so the structure of
+  // each tree is still valid for them; only the bounds have to be recomputed.
+  for (size_t i = 0; i < uniqueLabels.n_elem; ++i)
+  {
+    typename KNN::Tree& tree = impostorSearchers[i].ReferenceTree();
+    tree.Dataset() = dataset.cols(indexDiff[i].elem(impostorOldFromNew[i]));
+    tree.RefitBounds();
+  }
+
+  ++treeRefits;
+}
+
+template<typename MetricType>
+inline void Constraints<MetricType>::SearchImpostors(
+    const size_t label,
+    const arma::mat& querySet,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  impostorSearchers[label].Search(querySet, k, neighbors, distances);
+
+  // The results refer to the points in the order of the tree; map them back
+  // to their positions in indexDiff[label].
+  for (size_t j = 0; j < neighbors.n_elem; ++j)
+    neighbors(j) = impostorOldFromNew[label][neighbors(j)];
+}
+
 template<typename MetricType>
 inline void Constraints<MetricType>::Precalculate(
                                          const arma::Row<size_t>& labels)
@@ -426,6 +489,10 @@ inline void Constraints<MetricType>::Precalculate(
   if (precalculated)
     return;
 
+  // The trees over the impostor candidates of each class must be built again.
+  impostorSearchers.clear();
+  impostorOldFromNew.clear();
+
   uniqueLabels = arma::unique(labels);
 
   indexSame.resize(uniqueLabels.n_elem);
@@ -245,6 +245,17 @@ class LMNNFunction
   inline void UpdateCache(const arma::mat& transformation,
                           const size_t begin,
                           const size_t batchSize);
+  /**
+  * Add the part of the gradient due to impostors of the given point to cil:
+  * the outer product of the difference between the point and each of its
+  * target neighbors (or impostors), weighted by the number of active triplets
+  * it is in.
+  */
+  inline void AccumulateImpostorGradient(
+      const size_t i,
+      const arma::Col<size_t>& targetCounts,
+      const arma::Col<size_t>& impostorCounts,
+      arma::mat& cil) const;
   //! Calculate norm of change in transformation.
   inline void TransDiff(std::map<size_t, double>& transformationDiffs,
                         const arma::mat& transformation,
@@ -207,6 +207,30 @@ inline void LMNNFunction<MetricType>::TransDiff(
   }
 }
 
+// Add the gradient due to impostors of one point.
+template<typename MetricType>
+inline void LMNNFunction<MetricType>::AccumulateImpostorGradient(
+    const size_t i,
+    const arma::Col<size_t>& targetCounts,
+    const arma::Col<size_t>& impostorCounts,
+    arma::mat& cil) const
+{
+  for (size_t j = 0; j < k; ++j)
+  {
+    if (targetCounts[j] > 0)
+    {
+      arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
+      cil += (double) targetCounts[j] * (diff * trans(diff));
+    }
+
+    if (impostorCounts[j] > 0)
+    {
+      arma::vec diff = dataset.col(i) - dataset.col(impostors(j, i));
+      cil -= (double) impostorCounts[j] * (diff * trans(diff));
+    }
+  }
+}
+
 //! Evaluate cost over whole dataset.
 template<typename MetricType>
 double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation)
@@ -256,6 +280,7 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation)
     constraint.Impostors(impostors, distance, transformedDataset, labels, norm);
   }
 
+  #pragma omp parallel for reduction(+:cost) num_threads((int) NumThreads())
   for (size_t i = 0; i < dataset.n_cols; ++i)
   {
     for (size_t j = 0; j < k ; ++j)
@@ -359,7 +384,7 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation,
     {
       if (lastTransformationIndices(i))
       {
-        if (transformationDiffs[lastTransformationIndices[i]] *
+        if (transformationDiffs.at(lastTransformationIndices[i]) *
             (2 * norm(i) + norm(impostors(k - 1, i)) +
             norm(impostors(k, i))) > distance(k, i) - distance(k - 1, i))
         {
@@ -383,6 +408,7 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation,
         norm, begin, batchSize);
   }
 
+  #pragma omp parallel for reduction(+:cost) num_threads((int) NumThreads())
   for (size_t i = begin; i < begin + batchSize; ++i)
   {
     for (size_t j = 0; j < k ; ++j)
@@ -410,7 +436,7 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation,
           maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
 
           eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
+              transformationDiffs.at(lastTransformationIndices[i]) *
               (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
         }
 
@@ -451,6 +477,7 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation,
           // update bound.
           evalOld(l, j, i) = 0;
           maxImpNorm(l, i) = 0;
+          #pragma omp atomic
           --oldTransformationCounts[lastTransformationIndices(i)];
           lastTransformationIndices(i) = 0;
         }
@@ -519,72 +546,93 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
   // Calculate gradient due to impostors.
   arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Each thread accumulates the gradient of its points, and they are summed at
+  // the end.  The number of active triplets of each target neighbor and each
+  // impostor of a point are counted, so that only one outer product is needed
+  // for each of them.
+  #pragma omp parallel num_threads((int) NumThreads())
   {
-    for (int j = k - 1; j >= 0; j--)
+    arma::mat threadCil(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+    arma::Col<size_t> targetCounts(k), impostorCounts(k);
+
+    #pragma omp for
+    for (size_t i = 0; i < dataset.n_cols; ++i)
     {
-      // Bound constraints to avoid uneccesary computation.
-      for (size_t l = 0, bp = k; l < bp ; l++)
-      {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        double eval = 0;
+      targetCounts.zeros();
+      impostorCounts.zeros();
 
-        // Bounds for eval.
-        if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
+      for (int j = k - 1; j >= 0; j--)
+      {
+        // Bound constraints to avoid uneccesary computation.
+        for (size_t l = 0, bp = k; l < bp ; l++)
         {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
-
-          eval = evalOld(l, j, i) + transformationDiff *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
-              2 * norm(i));
-        }
+          // Calculate cost due to {data point, target neighbors, impostors}
+          // triplets.
+          double eval = 0;
 
-        // Calculate exact eval value.
-        if (eval > -1)
-        {
-          if (iteration - 1 % range == 0)
+          // Bounds for eval.
+          if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distance(l, i);
+            // Update cache max impostor norm.
+            maxImpNorm(l, i) = std::max(maxImpNorm(l, i),
+                norm(impostors(l, i)));
+
+            eval = evalOld(l, j, i) + transformationDiff *
+                (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
+                2 * norm(i));
           }
-          else
+
+          // Calculate exact eval value.
+          if (eval > -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   metric.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
+            if (iteration - 1 % range == 0)
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                   distance(l, i);
+            }
+            else
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                     metric.Evaluate(transformedDataset.col(i),
+                         transformedDataset.col(impostors(l, i)));
+            }
           }
-        }
 
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
+          // Update cache eval value.
+          evalOld(l, j, i) = eval;
 
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
-        }
+          // Check bounding condition.
+          if (eval <= -1)
+          {
+            // update bound.
+            bp = l;
+            break;
+          }
 
-        // Reset cache.
-        if (eval > -1)
-        {
-          // update bound.
-          evalOld(l, j, i) = 0;
-          maxImpNorm(l, i) = 0;
+          // Reset cache.
+          if (eval > -1)
+          {
+            // update bound.
+            evalOld(l, j, i) = 0;
+            maxImpNorm(l, i) = 0;
+          }
+
+          // Count the triplet for the gradient due to impostors.
+          ++targetCounts[j];
+          ++impostorCounts[l];
         }
+      }
 
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * trans(diff);
+      // Calculate gradient due to impostors.
+      AccumulateImpostorGradient(i, targetCounts, impostorCounts,
+          threadCil);
+    }
 
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * trans(diff);
-      }
+    #pragma omp critical
+    {
+      cil += threadCil;
     }
   }
 
@@ -619,7 +667,7 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
     {
       if (lastTransformationIndices(i))
       {
-        if (transformationDiffs[lastTransformationIndices[i]] *
+        if (transformationDiffs.at(lastTransformationIndices[i]) *
             (2 * norm(i) + norm(impostors(k - 1, i)) +
             norm(impostors(k, i))) > distance(k, i) - distance(k - 1, i))
         {
@@ -648,81 +696,105 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
   arma::mat cij = arma::zeros(dataset.n_rows, dataset.n_rows);
   arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
 
-  for (size_t i = begin; i < begin + batchSize; ++i)
+  // Each thread accumulates the gradient of its points, and they are summed at
+  // the end.  The number of active triplets of each target neighbor and each
+  // impostor of a point are counted, so that only one outer product is needed
+  // for each of them.
+  #pragma omp parallel num_threads((int) NumThreads())
   {
-    for (size_t j = 0; j < k ; ++j)
-    {
-      // Calculate gradient due to target neighbors.
-      arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-      cij += diff * trans(diff);
-    }
+    arma::mat threadCil(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+    arma::mat threadCij(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+    arma::Col<size_t> targetCounts(k), impostorCounts(k);
 
-    for (int j = k - 1; j >= 0; j--)
+    #pragma omp for
+    for (size_t i = begin; i < begin + batchSize; ++i)
     {
-      // Bound constraints to avoid uneccesary computation.
-      for (size_t l = 0, bp = k; l < bp ; l++)
+      targetCounts.zeros();
+      impostorCounts.zeros();
+
+      for (size_t j = 0; j < k ; ++j)
       {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        double eval = 0;
+        // Calculate gradient due to target neighbors.
+        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
+        threadCij += diff * trans(diff);
+      }
 
-        // Bounds for eval.
-        if (lastTransformationIndices(i) && evalOld(l, j, i) < -1)
+      for (int j = k - 1; j >= 0; j--)
+      {
+        // Bound constraints to avoid uneccesary computation.
+        for (size_t l = 0, bp = k; l < bp ; l++)
         {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
-
-          eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
-        }
+          // Calculate cost due to {data point, target neighbors, impostors}
+          // triplets.
+          double eval = 0;
 
-        // Calculate exact eval value.
-        if (eval > -1)
-        {
-          if (iteration - 1 % range == 0)
+          // Bounds for eval.
+          if (lastTransformationIndices(i) && evalOld(l, j, i) < -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distance(l, i);
+            // Update cache max impostor norm.
+            maxImpNorm(l, i) = std::max(maxImpNorm(l, i),
+                norm(impostors(l, i)));
+
+            eval = evalOld(l, j, i) +
+                transformationDiffs.at(lastTransformationIndices[i]) *
+                (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
           }
-          else
+
+          // Calculate exact eval value.
+          if (eval > -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   metric.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
+            if (iteration - 1 % range == 0)
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                   distance(l, i);
+            }
+            else
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                     metric.Evaluate(transformedDataset.col(i),
+                         transformedDataset.col(impostors(l, i)));
+            }
           }
-        }
 
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
+          // Update cache eval value.
+          evalOld(l, j, i) = eval;
 
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
-        }
+          // Check bounding condition.
+          if (eval <= -1)
+          {
+            // update bound.
+            bp = l;
+            break;
+          }
 
-        // Reset cache.
-        if (eval > -1 && lastTransformationIndices(i))
-        {
-          // update bound.
-          evalOld(l, j, i) = 0;
-          maxImpNorm(l, i) = 0;
-          --oldTransformationCounts[lastTransformationIndices(i)];
-          lastTransformationIndices(i) = 0;
+          // Reset cache.
+          if (eval > -1 && lastTransformationIndices(i))
+          {
+            // update bound.
+            evalOld(l, j, i) = 0;
+            maxImpNorm(l, i) = 0;
+            #pragma omp atomic
+            --oldTransformationCounts[lastTransformationIndices(i)];
+            lastTransformationIndices(i) = 0;
+          }
+
+          // Count the triplet for the gradient due to impostors.
+          ++targetCounts[j];
+          ++impostorCounts[l];
         }
+      }
 
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * trans(diff);
+      // Calculate gradient due to impostors.
+      AccumulateImpostorGradient(i, targetCounts, impostorCounts,
+          threadCil);
+    }
 
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * trans(diff);
-      }
+    #pragma omp critical
+    {
+      cij += threadCij;
+      cil += threadCil;
     }
   }
 
@@ -794,74 +866,97 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
   // Calculate gradient due to impostors.
   arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Each thread accumulates the cost and the gradient of its points, and
+  // they are summed at the end.  The number of active triplets of each
+  // target neighbor and each impostor of a point are counted, so that only
+  // one outer product is needed for each of them.
+  #pragma omp parallel num_threads((int) NumThreads())
   {
-    for (size_t j = 0; j < k ; ++j)
-    {
-      // Calculate cost due to distance between target neighbors & data point.
-      double eval = metric.Evaluate(transformedDataset.col(i),
-                        transformedDataset.col(targetNeighbors(j, i)));
-      cost += (1 - regularization) * eval;
-    }
+    arma::mat threadCil(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+    double threadCost = 0;
+    arma::Col<size_t> targetCounts(k), impostorCounts(k);
 
-    for (int j = k - 1; j >= 0; j--)
+    #pragma omp for
+    for (size_t i = 0; i < dataset.n_cols; ++i)
     {
-      // Bound constraints to avoid uneccesary computation.
-      for (size_t l = 0, bp = k; l < bp ; l++)
+      targetCounts.zeros();
+      impostorCounts.zeros();
+
+      for (size_t j = 0; j < k ; ++j)
       {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        double eval = 0;
+        // Calculate cost due to distance between target neighbors & data point.
+        double eval = metric.Evaluate(transformedDataset.col(i),
+                          transformedDataset.col(targetNeighbors(j, i)));
+        threadCost += (1 - regularization) * eval;
+      }
 
-        // Bounds for eval.
-        if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
+      for (int j = k - 1; j >= 0; j--)
+      {
+        // Bound constraints to avoid uneccesary computation.
+        for (size_t l = 0, bp = k; l < bp ; l++)
         {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
+          // Calculate cost due to {data point, target neighbors, impostors}
+          // triplets.
+          double eval = 0;
 
-          eval = evalOld(l, j, i) + transformationDiff *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
-              2 * norm(i));
-        }
+          // Bounds for eval.
+          if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
+          {
+            // Update cache max impostor norm.
+            maxImpNorm(l, i) = std::max(maxImpNorm(l, i),
+                norm(impostors(l, i)));
 
-        // Calculate exact eval value.
-        if (eval > -1)
-        {
-          if (iteration - 1 % range == 0)
+            eval = evalOld(l, j, i) + transformationDiff *
+                (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
+                2 * norm(i));
+          }
+
+          // Calculate exact eval value.
+          if (eval > -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distance(l, i);
+            if (iteration - 1 % range == 0)
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                   distance(l, i);
+            }
+            else
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                     metric.Evaluate(transformedDataset.col(i),
+                         transformedDataset.col(impostors(l, i)));
+            }
           }
-          else
+
+          // Update cache eval value.
+          evalOld(l, j, i) = eval;
+
+          // Check bounding condition.
+          if (eval <= -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   metric.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
+            // update bound.
+            bp = l;
+            break;
           }
-        }
 
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
+          threadCost += regularization * (1 + eval);
 
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
+          // Count the triplet for the gradient due to impostors.
+          ++targetCounts[j];
+          ++impostorCounts[l];
         }
+      }
 
-        cost += regularization * (1 + eval);
-
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * trans(diff);
+      // Calculate gradient due to impostors.
+      AccumulateImpostorGradient(i, targetCounts, impostorCounts,
+          threadCil);
+    }
 
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * trans(diff);
-      }
+    #pragma omp critical
+    {
+      cil += threadCil;
+      cost += threadCost;
     }
   }
 
@@ -901,7 +996,7 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
     {
       if (lastTransformationIndices(i))
       {
-        if (transformationDiffs[lastTransformationIndices[i]] *
+        if (transformationDiffs.at(lastTransformationIndices[i]) *
             (2 * norm(i) + norm(impostors(k - 1, i)) +
             norm(impostors(k, i))) > distance(k, i) - distance(k - 1, i))
         {
@@ -930,78 +1025,103 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
   arma::mat cij = arma::zeros(dataset.n_rows, dataset.n_rows);
   arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
 
-  for (size_t i = begin; i < begin + batchSize; ++i)
+  // Each thread accumulates the cost and the gradient of its points, and
+  // they are summed at the end.  The number of active triplets of each
+  // target neighbor and each impostor of a point are counted, so that only
+  // one outer product is needed for each of them.
+  #pragma omp parallel num_threads((int) NumThreads())
   {
-    for (size_t j = 0; j < k ; ++j)
-    {
-      // Calculate cost due to distance between target neighbors & data point.
-      double eval = metric.Evaluate(transformedDataset.col(i),
-                        transformedDataset.col(targetNeighbors(j, i)));
-      cost += (1 - regularization) * eval;
-
-      // Calculate gradient due to target neighbors.
-      arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-      cij += diff * trans(diff);
-    }
+    arma::mat threadCil(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+    arma::mat threadCij(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+    double threadCost = 0;
+    arma::Col<size_t> targetCounts(k), impostorCounts(k);
 
-    for (int j = k - 1; j >= 0; j--)
+    #pragma omp for
+    for (size_t i = begin; i < begin + batchSize; ++i)
     {
-      // Bound constraints to avoid uneccesary computation.
-      for (size_t l = 0, bp = k; l < bp ; l++)
+      targetCounts.zeros();
+      impostorCounts.zeros();
+
+      for (size_t j = 0; j < k ; ++j)
       {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        double eval = 0;
+        // Calculate cost due to distance between target neighbors & data point.
+        double eval = metric.Evaluate(transformedDataset.col(i),
+                          transformedDataset.col(targetNeighbors(j, i)));
+        threadCost += (1 - regularization) * eval;
 
-        // Bounds for eval.
-        if (lastTransformationIndices(i) && evalOld(l, j, i) < -1)
+        // Calculate gradient due to target neighbors.
+        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
+        threadCij += diff * trans(diff);
+      }
+
+      for (int j = k - 1; j >= 0; j--)
+      {
+        // Bound constraints to avoid uneccesary computation.
+        for (size_t l = 0, bp = k; l < bp ; l++)
         {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
+          // Calculate cost due to {data point, target neighbors, impostors}
+          // triplets.
+          double eval = 0;
 
-          eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
-        }
+          // Bounds for eval.
+          if (lastTransformationIndices(i) && evalOld(l, j, i) < -1)
+          {
+            // Update cache max impostor norm.
+            maxImpNorm(l, i) = std::max(maxImpNorm(l, i),
+                norm(impostors(l, i)));
 
-        // Calculate exact eval value.
-        if (eval > -1)
-        {
-          if (iteration - 1 % range == 0)
+            eval = evalOld(l, j, i) +
+                transformationDiffs.at(lastTransformationIndices[i]) *
+                (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
+          }
+
+          // Calculate exact eval value.
+          if (eval > -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distance(l, i);
+            if (iteration - 1 % range == 0)
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                   distance(l, i);
+            }
+            else
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                     metric.Evaluate(transformedDataset.col(i),
+                         transformedDataset.col(impostors(l, i)));
+            }
           }
-          else
+
+          // Update cache eval value.
+          evalOld(l, j, i) = eval;
+
+          // Check bounding condition.
+          if (eval <= -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   metric.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
+            // update bound.
+            bp = l;
+            break;
           }
-        }
 
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
+          threadCost += regularization * (1 + eval);
 
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
+          // Count the triplet for the gradient due to impostors.
+          ++targetCounts[j];
+          ++impostorCounts[l];
         }
+      }
 
-        cost += regularization * (1 + eval);
-
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * trans(diff);
+      // Calculate gradient due to impostors.
+      AccumulateImpostorGradient(i, targetCounts, impostorCounts,
+          threadCil);
+    }
 
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * trans(diff);
-      }
+    #pragma omp critical
+    {
+      cij += threadCij;
+      cil += threadCil;
+      cost += threadCost;
     }
   }
 
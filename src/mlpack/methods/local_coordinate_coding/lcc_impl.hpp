@@ -122,35 +122,39 @@ inline void LocalCoordinateCoding::Encode(const arma::mat& data,
       data.n_cols) + repmat(sum(square(data)), atoms, 1) - 2 * trans(dictionary)
       * data);
 
-  arma::mat dictGram = trans(dictionary) * dictionary;
-  arma::mat dictGramTD(dictGram.n_rows, dictGram.n_cols);
+  // The Gram matrix of the dictionary is computed only once; the Gram matrix
+  // of the weighted dictionary of each point is obtained by scaling it.
+  const arma::mat dictGram = trans(dictionary) * dictionary;
 
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    // Report progress.
-    if ((i % 100) == 0)
-    {
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-    }
-
-    arma::vec invW = invSqDists.unsafe_col(i);
-    arma::mat dictPrime = dictionary * diagmat(invW);
-
-    arma::mat dictGramTD = diagmat(invW) * dictGram * diagmat(invW);
 
-    bool useCholesky = false;
+  // The points are coded independently, in parallel.
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    // Each thread reuses its LARS object and its weighted dictionary for all
+    // of its points.
+    bool useCholesky = true;
     // Normalization and fitting and intercept are disabled.
     LARS<> lars(useCholesky, 0.5 * lambda, 0, 1e-16 /* default tolerance */,
         false, false);
+    arma::mat dictPrime(arma::size(dictionary));
+    arma::mat dictGramTD(arma::size(dictGram));
 
-    // Run LARS for this point, by making an alias of the point and passing
-    // that.
-    arma::vec beta = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictPrime, responses, false, useCholesky, dictGramTD);
-    beta = lars.Beta();
-    beta %= invW; // Remember, beta is an alias of codes.col(i).
+    #pragma omp for schedule(dynamic)
+    for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+    {
+      arma::vec invW = invSqDists.unsafe_col(i);
+      dictPrime = dictionary * diagmat(invW);
+      dictGramTD = dictGram % (invW * invW.t());
+
+      // Run LARS for this point, by making an alias of the point and passing
+      // that.
+      arma::vec beta = codes.unsafe_col(i);
+      arma::rowvec responses = data.unsafe_col(i).t();
+      lars.Train(dictPrime, responses, false, useCholesky, dictGramTD);
+      beta = lars.Beta();
+      beta %= invW; // Remember, beta is an alias of codes.col(i).
+    }
   }
 }
 
@@ -159,47 +163,6 @@ inline void LocalCoordinateCoding::OptimizeDictionary(
     const arma::mat& codes,
     const arma::uvec& adjacencies)
 {
-  // Count number of atomic neighbors for each point x^i.
-  arma::uvec neighborCounts = arma::zeros<arma::uvec>(data.n_cols, 1);
-  if (adjacencies.n_elem > 0)
-  {
-    // This gets the column index.  Intentional integer division.
-    size_t curPointInd = (size_t) (adjacencies(0) / atoms);
-    ++neighborCounts(curPointInd);
-
-    size_t nextColIndex = (curPointInd + 1) * atoms;
-    for (size_t l = 1; l < adjacencies.n_elem; l++)
-    {
-      // If l no longer refers to an element in this column, advance the column
-      // number accordingly.
-      if (adjacencies(l) >= nextColIndex)
-      {
-        curPointInd = (size_t) (adjacencies(l) / atoms);
-        nextColIndex = (curPointInd + 1) * atoms;
-      }
-
-      ++neighborCounts(curPointInd);
-    }
-  }
-
-  // Build dataPrime := [X x^1 ... x^1 ... x^n ... x^n]
-  // where each x^i is repeated for the number of neighbors x^i has.
-  arma::mat dataPrime = arma::zeros(data.n_rows,
-      data.n_cols + adjacencies.n_elem);
-
-  dataPrime(arma::span::all, arma::span(0, data.n_cols - 1)) = data;
-
-  size_t curCol = data.n_cols;
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    if (neighborCounts(i) > 0)
-    {
-      dataPrime(arma::span::all, arma::span(curCol, curCol + neighborCounts(i)
-          - 1)) = repmat(data.col(i), 1, neighborCounts(i));
-    }
-    curCol += neighborCounts(i);
-  }
-
   // Handle the case of inactive atoms (atoms not used in the given coding).
   std::vector<arma::uword> activeAtoms;
   for (size_t j = 0; j < atoms; ++j)
@@ -209,80 +172,82 @@ inline void LocalCoordinateCoding::OptimizeDictionary(
   const size_t nActiveAtoms = activeAtoms.size();
   const size_t nInactiveAtoms = atoms - nActiveAtoms;
 
-  // Efficient construction of codes restricted to active atoms.
-  arma::mat codesPrime = arma::zeros(nActiveAtoms, data.n_cols +
-      adjacencies.n_elem);
-  arma::vec wSquared = arma::ones(data.n_cols + adjacencies.n_elem, 1);
-
   if (nInactiveAtoms > 0)
   {
     Log::Warn << "There are " << nInactiveAtoms
         << " inactive atoms.  They will be re-initialized randomly.\n";
+  }
 
-    // Create matrix holding only active codes.
-    arma::mat activeCodes = codes.rows(arma::uvec(activeAtoms));
+  const arma::uvec activeAtomIndices(activeAtoms);
+
+  // Create reverse atom lookup for active atoms.
+  arma::uvec atomReverseLookup(atoms, arma::fill::zeros);
+  for (size_t i = 0; i < activeAtoms.size(); ++i)
+    atomReverseLookup[activeAtoms[i]] = i;
+
+  // The dictionary solves A D^T = B, with A = Z' W Z'^T and B = Z' W X'^T,
+  // where X' := [X x^1 ... x^1 ... x^n ... x^n] holds each point x^i once,
+  // and once more for each of its neighbors, and Z' holds the codes of the
+  // points restricted to the active atoms, then the indicator of the atom of
+  // each neighbor.  The weight of each point is 1, and the weight of each
+  // neighbor is lambda times the absolute value of its code.  A and B are
+  // accumulated in parallel over blocks of points and over the neighbors,
+  // without forming X' and Z'.
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  arma::mat A(nActiveAtoms, nActiveAtoms, arma::fill::zeros);
+  arma::mat B(nActiveAtoms, data.n_rows, arma::fill::zeros);
+
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    arma::mat threadA(nActiveAtoms, nActiveAtoms, arma::fill::zeros);
+    arma::mat threadB(nActiveAtoms, data.n_rows, arma::fill::zeros);
 
-    // Create reverse atom lookup for active atoms.
-    arma::uvec atomReverseLookup(atoms);
-    for (size_t i = 0; i < activeAtoms.size(); ++i)
+    #pragma omp for schedule(static) nowait
+    for (size_t b = 0; b < numBlocks; ++b)
     {
-      atomReverseLookup[i] = activeAtoms[i];
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) data.n_cols) - 1;
+
+      const arma::mat blockCodes = (nInactiveAtoms == 0) ?
+          arma::mat(codes.cols(begin, end)) :
+          arma::mat(codes.submat(activeAtomIndices, arma::regspace<arma::uvec>(
+              begin, end)));
+      threadA += blockCodes * trans(blockCodes);
+      threadB += blockCodes * trans(data.cols(begin, end));
     }
 
-    codesPrime(arma::span::all, arma::span(0, data.n_cols - 1)) = activeCodes;
-
-    // Fill the rest of codesPrime.
-    for (size_t l = 0; l < adjacencies.n_elem; ++l)
+    #pragma omp for schedule(static)
+    for (size_t l = 0; l < (size_t) adjacencies.n_elem; ++l)
     {
       // Recover the location in the codes matrix that this adjacency refers to.
-      size_t atomInd = adjacencies(l) % atoms;
-      size_t pointInd = (size_t) (adjacencies(l) / atoms);
+      const size_t atomInd = adjacencies(l) % atoms;
+      const size_t pointInd = (size_t) (adjacencies(l) / atoms);
+      const size_t row = atomReverseLookup[atomInd];
+      const double weight = lambda * std::abs(codes(atomInd, pointInd));
 
-      // Fill matrix.
-      codesPrime(atomReverseLookup(atomInd), data.n_cols + l) = 1.0;
-      wSquared(data.n_cols + l) = codes(atomInd, pointInd);
+      threadA(row, row) += weight;
+      threadB.row(row) += weight * trans(data.col(pointInd));
     }
-  }
-  else
-  {
-    // All atoms are active.
-    codesPrime(arma::span::all, arma::span(0, data.n_cols - 1)) = codes;
 
-    for (size_t l = 0; l < adjacencies.n_elem; ++l)
+    #pragma omp critical
     {
-      // Recover the location in the codes matrix that this adjacency refers to.
-      size_t atomInd = adjacencies(l) % atoms;
-      size_t pointInd = (size_t) (adjacencies(l) / atoms);
-
-      // Fill matrix.
-      codesPrime(atomInd, data.n_cols + l) = 1.0;
-      wSquared(data.n_cols + l) = codes(atomInd, pointInd);
+      A += threadA;
+      B += threadB;
     }
   }
 
-  wSquared.subvec(data.n_cols, wSquared.n_elem - 1) = lambda *
-      abs(wSquared.subvec(data.n_cols, wSquared.n_elem - 1));
-
   // Solve system.
   if (nInactiveAtoms == 0)
   {
     // No inactive atoms.  We can solve directly.
-    arma::mat A = codesPrime * diagmat(wSquared) * trans(codesPrime);
-    arma::mat B = codesPrime * diagmat(wSquared) * trans(dataPrime);
-
     dictionary = trans(solve(A, B));
-    /*
-    dictionary = trans(solve(codesPrime * diagmat(wSquared) * trans(codesPrime),
-        codesPrime * diagmat(wSquared) * trans(dataPrime)));
-    */
   }
   else
   {
     // Inactive atoms must be reinitialized randomly, so we cannot solve
     // directly for the entire dictionary estimate.
-    arma::mat dictionaryActive =
-        trans(solve(codesPrime * diagmat(wSquared) * trans(codesPrime),
-                    codesPrime * diagmat(wSquared) * trans(dataPrime)));
+    arma::mat dictionaryActive = trans(solve(A, B));
 
     // Update all atoms.
     size_t currentActiveIndex = 0;
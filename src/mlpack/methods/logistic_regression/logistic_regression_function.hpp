@@ -175,6 +175,52 @@ class LogisticRegressionFunction
   arma::Row<size_t> responses;
   //! The regularization parameter for L2-regularization.
   double lambda;
+
+  //! Number of points of each block of the parallel full-batch computations.
+  static const size_t blockSize = 1024;
+
+  /**
+   * Compute the log-likelihood of all the points (without the regularization)
+   * and, if `gradient` is not NULL, the gradient of its opposite (also without
+   * the regularization), in parallel over blocks of points.  Each thread sums
+   * the gradient of its blocks, and the sums of the threads are added at the
+   * end; the data is never converted to a dense matrix.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param gradient Pointer to the vector to output the gradient into, or NULL.
+   * @param computeObjective Whether to compute the log-likelihood (otherwise,
+   *     0 is returned).
+   */
+  template<typename CoordinatesType, typename GradType>
+  typename CoordinatesType::elem_type ParallelLogLikelihood(
+      const CoordinatesType& parameters,
+      GradType* gradient,
+      const bool computeObjective) const;
+
+  /**
+   * Add the gradient of the points in [begin, end], given the differences
+   * between their sigmoids and their responses, to the given gradient (without
+   * the intercept term).  This overload is for dense data.
+   */
+  template<typename DiffsType, typename GradType>
+  void AddBlockGradient(const DiffsType& diffs,
+                        const size_t begin,
+                        const size_t end,
+                        GradType& gradient,
+                        const std::false_type& /* isSparse */) const;
+
+  /**
+   * Add the gradient of the points in [begin, end], given the differences
+   * between their sigmoids and their responses, to the given gradient (without
+   * the intercept term).  This overload is for sparse data, and only visits
+   * the nonzero elements of the points.
+   */
+  template<typename DiffsType, typename GradType>
+  void AddBlockGradient(const DiffsType& diffs,
+                        const size_t begin,
+                        const size_t end,
+                        GradType& gradient,
+                        const std::true_type& /* isSparse */) const;
 };
 
 } // namespace mlpack
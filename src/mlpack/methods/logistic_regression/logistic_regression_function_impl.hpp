@@ -82,8 +82,6 @@ LogisticRegressionFunction<MatType>::Evaluate(
   // accidentally casting an entire expression to `double`, e.g., by the use of
   // `1.0` or similar.
   constexpr ElemType half = ((ElemType) 0.5);
-  constexpr ElemType one = ((ElemType) 1);
-  constexpr ElemType two = ((ElemType) 2);
 
   // For the regularization, we ignore the first term, which is the intercept
   // term and take every term except the last one in the decision variable.
@@ -91,20 +89,13 @@ LogisticRegressionFunction<MatType>::Evaluate(
       dot(parameters.tail_cols(parameters.n_elem - 1),
       parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate vectors of sigmoids.  The intercept term is parameters(0, 0) and
-  // does not need to be multiplied by any of the predictors.
-  const CoordinatesType sigmoid = one / (one + exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
   // Assemble full objective function.  Often the objective function and the
   // regularization as given are divided by the number of features, but this
   // doesn't actually affect the optimization result, so we'll just ignore those
-  // terms for computational efficiency.  Note that the conversion causes some
-  // copy and slowdown, but this is so negligible compared to the rest of the
-  // calculation it is not worth optimizing for.
-  const ElemType result = accu(log(one -
-      ConvTo<CoordinatesType>::From(responses) + sigmoid %
-      (two * ConvTo<CoordinatesType>::From(responses) - one)));
+  // terms for computational efficiency.  The log-likelihood is computed in
+  // parallel over blocks of points.
+  const ElemType result = ParallelLogLikelihood<CoordinatesType,
+      CoordinatesType>(parameters, NULL, true);
 
   // Invert the result, because it's a minimization.
   return regularization - result;
@@ -158,24 +149,11 @@ void LogisticRegressionFunction<MatType>::Gradient(
     const CoordinatesType& parameters,
     GradType& gradient) const
 {
-  typedef typename CoordinatesType::elem_type ElemType;
-
-  // Regularization term.
-  GradType regularization;
-  regularization = lambda * parameters.tail_cols(parameters.n_elem - 1);
-
-  // Specifying this here makes the code below a little bit cleaner, and avoids
-  // accidentally casting an entire expression to `double`, e.g., by the use of
-  // `1.0` or similar.
-  constexpr ElemType one = ((ElemType) 1);
-
-  const CoordinatesType sigmoids = (one / (one + exp(-parameters(0, 0)
-      - parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
-  gradient.set_size(size(parameters));
-  gradient[0] = -accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
+  // Compute the gradient of the log-likelihood in parallel over blocks of
+  // points, then add the regularization term.
+  ParallelLogLikelihood(parameters, &gradient, false);
+  gradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1);
 }
 
 //! Evaluate the gradient of the logistic regression objective function for a
@@ -257,33 +235,20 @@ LogisticRegressionFunction<MatType>::EvaluateWithGradient(
 {
   typedef typename CoordinatesType::elem_type ElemType;
 
-  // Specifying these here makes the code below a little bit cleaner, and avoids
+  // Specifying this here makes the code below a little bit cleaner, and avoids
   // accidentally casting an entire expression to `double`, e.g., by the use of
   // `1.0` or similar.
-  constexpr ElemType one = ((ElemType) 1);
   constexpr ElemType two = ((ElemType) 2);
 
-  // Regularization term.
-  GradType regularization = lambda *
-      parameters.tail_cols(parameters.n_elem - 1);
-
   const ElemType objectiveRegularization = lambda / two *
       dot(parameters.tail_cols(parameters.n_elem - 1),
           parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const CoordinatesType sigmoids = one / (one + exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
-  gradient.set_size(size(parameters));
-  gradient[0] = -accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
-
-  // Now compute the objective function using the sigmoids.
-  ElemType result = accu(log(one -
-      ConvTo<CoordinatesType>::From(responses) + sigmoids %
-      (two * ConvTo<CoordinatesType>::From(responses) - one)));
+  // Compute the log-likelihood and its gradient in parallel over blocks of
+  // points, from the same sigmoids, then add the regularization term.
+  const ElemType result = ParallelLogLikelihood(parameters, &gradient, true);
+  gradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1);
 
   // Invert the result, because it's a minimization.
   return objectiveRegularization - result;
@@ -338,6 +303,106 @@ LogisticRegressionFunction<MatType>::EvaluateWithGradient(
   return objectiveRegularization - result;
 }
 
+template<typename MatType>
+template<typename CoordinatesType, typename GradType>
+typename CoordinatesType::elem_type
+LogisticRegressionFunction<MatType>::ParallelLogLikelihood(
+    const CoordinatesType& parameters,
+    GradType* gradient,
+    const bool computeObjective) const
+{
+  typedef typename CoordinatesType::elem_type ElemType;
+
+  // Specifying these here makes the code below a little bit cleaner, and avoids
+  // accidentally casting an entire expression to `double`, e.g., by the use of
+  // `1.0` or similar.
+  constexpr ElemType one = ((ElemType) 1);
+  constexpr ElemType two = ((ElemType) 2);
+
+  const size_t numBlocks = (predictors.n_cols + (size_t) blockSize - 1) /
+      (size_t) blockSize;
+
+  if (gradient != NULL)
+    gradient->zeros(parameters.n_rows, parameters.n_cols);
+
+  ElemType result = 0;
+  #pragma omp parallel reduction(+:result) num_threads((int) NumThreads())
+  {
+    // The gradient of the blocks of each thread is summed separately.
+    GradType localGradient;
+    if (gradient != NULL)
+      localGradient.zeros(parameters.n_rows, parameters.n_cols);
+
+    #pragma omp for schedule(static)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * (size_t) blockSize;
+      const size_t end = std::min(begin + (size_t) blockSize,
+          (size_t) predictors.n_cols) - 1;
+
+      // Calculate the sigmoid function values.  The intercept term is
+      // parameters(0, 0) and does not need to be multiplied by any of the
+      // predictors.
+      const CoordinatesType sigmoids = one / (one + exp(-(parameters(0, 0) +
+          parameters.tail_cols(parameters.n_elem - 1) *
+          predictors.cols(begin, end))));
+      const CoordinatesType respD = ConvTo<CoordinatesType>::From(
+          responses.subvec(begin, end));
+
+      if (computeObjective)
+        result += accu(log(one - respD + sigmoids % (two * respD - one)));
+
+      if (gradient != NULL)
+      {
+        const CoordinatesType diffs = sigmoids - respD;
+        localGradient[0] += accu(diffs);
+        AddBlockGradient(diffs, begin, end, localGradient,
+            std::integral_constant<bool, arma::is_SpMat<MatType>::value>());
+      }
+    }
+
+    if (gradient != NULL)
+    {
+      #pragma omp critical
+      *gradient += localGradient;
+    }
+  }
+
+  return result;
+}
+
+template<typename MatType>
+template<typename DiffsType, typename GradType>
+void LogisticRegressionFunction<MatType>::AddBlockGradient(
+    const DiffsType& diffs,
+    const size_t begin,
+    const size_t end,
+    GradType& gradient,
+    const std::false_type& /* isSparse */) const
+{
+  gradient.tail_cols(gradient.n_elem - 1) += diffs *
+      predictors.cols(begin, end).t();
+}
+
+template<typename MatType>
+template<typename DiffsType, typename GradType>
+void LogisticRegressionFunction<MatType>::AddBlockGradient(
+    const DiffsType& diffs,
+    const size_t begin,
+    const size_t end,
+    GradType& gradient,
+    const std::true_type& /* isSparse */) const
+{
+  // Only the nonzero features of each point contribute, so we avoid the dense
+  // temporary of the size of the gradient that the product would need.
+  for (size_t i = begin; i <= end; ++i)
+  {
+    typename MatType::const_iterator it = predictors.begin_col(i);
+    for (; it != predictors.end_col(i); ++it)
+      gradient[it.row() + 1] += diffs[i - begin] * (*it);
+  }
+}
+
 } // namespace mlpack
 
 #endif
@@ -58,16 +58,36 @@ namespace mlpack {
  * this hash to compute the distance-approximate nearest-neighbors of the given
  * queries.
  *
+ * The hash family depends on the metric.  For the EuclideanDistance, each
+ * table projects the points on random directions drawn from a 2-stable
+ * distribution.  For the HammingDistance, the points are binary codes packed
+ * with data::PackBinary(), and each table samples random bits of the codes
+ * (bit-sampling LSH); the "projections" are then the indices of the sampled
+ * bits, stored in a cube of size 1 x numProj x numTables, and the hash width
+ * is always 1.
+ *
  * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
  * @tparam MatType Type of matrix to use to store the data.
+ * @tparam MetricType Metric to search with: EuclideanDistance or
+ *     HammingDistance.
  */
 template<
     typename SortPolicy = NearestNeighborSort,
-    typename MatType = arma::mat
+    typename MatType = arma::mat,
+    typename MetricType = EuclideanDistance
 >
 class LSHSearch
 {
+  static_assert(std::is_same<MetricType, EuclideanDistance>::value ||
+      std::is_same<MetricType, HammingDistance>::value,
+      "LSHSearch only supports the EuclideanDistance and the HammingDistance.");
+
  public:
+  //! Whether the tables sample bits of binary codes instead of projecting the
+  //! points.
+  static constexpr bool BitSampling =
+      std::is_same<MetricType, HammingDistance>::value;
+
   /**
    * This function initializes the LSH class. It builds the hash on the
    * reference set with 2-stable distributions. See the individual functions
@@ -163,7 +183,9 @@ class LSHSearch
    * Train the LSH model on the given dataset.  If a correctly-sized projection
    * cube is not provided, this means building new hash tables. Otherwise, we
    * use the projections provided by the user.  In order to avoid copying the
-   * reference set, consider passing that parameter with std::move().
+   * reference set, consider passing that parameter with std::move().  With bit
+   * sampling (for the HammingDistance), the hash width is ignored, and the
+   * given projection cube must hold the indices of the sampled bits.
    *
    * @param referenceSet Set of reference points and the set of queries.
    * @param numProj Number of projections in each hash table (anything between
@@ -192,6 +214,37 @@ class LSHSearch
              const size_t bucketSize = 500,
              const arma::cube& projection = arma::cube());
 
+  /**
+   * Add the given points to the reference set, and hash them into the existing
+   * tables without rehashing the rest of the reference set.  The new points
+   * are given the indices ReferenceSet().n_cols through ReferenceSet().n_cols +
+   * newPoints.n_cols - 1.  When a bucket of the second hash table runs out of
+   * space, its capacity is doubled (up to the bucket size) and the table is
+   * laid out again, so the cost of insertion is amortized.
+   *
+   * @param newPoints Points to add to the reference set.
+   */
+  void Insert(const MatType& newPoints);
+
+  /**
+   * Remove the given points from the hash tables, so that they are no longer
+   * returned as neighbors.  The points stay in the reference set (marked as
+   * removed) so that the indices of the other points do not change; call
+   * Compact() to drop them from the reference set.  Indices of points that
+   * have already been removed are ignored.
+   *
+   * @param indices Indices of the reference points to remove.
+   */
+  void Remove(const arma::uvec& indices);
+
+  /**
+   * Drop all removed points from the reference set, and release the unused
+   * space in the second hash table.  The remaining points keep their relative
+   * order, so the new index of a point is its old index minus the number of
+   * removed points that came before it.
+   */
+  void Compact();
+
   /**
    * Compute the nearest neighbors of the points in the given query set and
    * store the output in the given matrices.  The matrices will be set to the
@@ -224,7 +277,9 @@ class LSHSearch
    * Compute the nearest neighbors and store the output in the given matrices.
    * The matrices will be set to the size of n columns by k rows, where n is
    * the number of points in the query dataset and k is the number of neighbors
-   * being searched for.
+   * being searched for.  The columns of points that have been removed with
+   * Remove() are filled with the number of reference points and the worst
+   * possible distance.
    *
    * @param k Number of neighbors to search for.
    * @param resultingNeighbors Matrix storing lists of neighbors for each query
@@ -286,9 +341,24 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  //! Get the offsets of each bucket of the second hash table in
+  //! BucketContents().  This has length secondHashSize + 1, and bucket i has
+  //! room for the elements in the range
+  //! [BucketOffsets()[i], BucketOffsets()[i + 1]).
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
+
+  //! Get the number of elements in each bucket of the second hash table.
+  //! Bucket i holds the elements in the range
+  //! [BucketOffsets()[i], BucketOffsets()[i] + BucketSizes()[i]).
+  const arma::Col<size_t>& BucketSizes() const { return bucketSizes; }
+
+  //! Get the contents of every bucket of the second hash table, stored
+  //! contiguously.
+  const arma::Col<arma::u32>& BucketContents() const { return bucketContents; }
+
+  //! Get the number of reference points that have been removed with Remove()
+  //! but not yet dropped with Compact().
+  size_t NumRemoved() const { return arma::accu(removedPoints != 0); }
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -296,31 +366,148 @@ class LSHSearch
   //! Change the projection tables (this retrains the LSH model).
   void Projections(const arma::cube& projTables)
   {
-    // Simply call Train() with the given projection tables.
+    // Simply call Train() with the given projection tables, and then remove
+    // the points that were removed before.
+    const arma::uvec removed = arma::find(removedPoints);
     Train(referenceSet, numProj, numTables, hashWidth, secondHashSize,
         bucketSize, projTables);
+    Remove(removed);
   }
 
  private:
   /**
-   * This function takes a query and hashes it into each of the hash tables to
-   * get keys for the query and then the key is hashed to a bucket of the second
-   * hash table and all the points (if any) in those buckets are collected as
-   * the potential neighbor candidates.
+   * Compute the bucket of the second hash table that each of the given points
+   * falls into, for each table.
+   *
+   * @param points Points to hash.
+   * @param secondHashVectors Matrix to store the buckets in; the bucket of
+   *     point j in table i is stored in secondHashVectors(i, j).
+   */
+  template<typename PointsType>
+  void SecondHashCodes(const PointsType& points,
+                       arma::Mat<size_t>& secondHashVectors) const;
+
+  /**
+   * Compute the projections of the given points in the tables firstTable to
+   * firstTable + tables - 1, without the offsets; the projection p of table
+   * firstTable + t is stored in row t * numProj + p.  With bit sampling, the
+   * projection of a point is the value (0 or 1) of the sampled bit.
+   *
+   * @param points Points to project.
+   * @param firstTable First table to project the points in.
+   * @param tables Number of tables to project the points in.
+   * @param projected Matrix to store the projections in.
+   */
+  template<typename PointsType>
+  void Project(const PointsType& points,
+               const size_t firstTable,
+               const size_t tables,
+               arma::mat& projected) const;
+
+  /**
+   * Draw the indices of the sampled bits of each table for bit sampling.  Only
+   * bits that are not the same for every reference point are sampled, so that
+   * for instance the unused bits at the end of each packed code are never
+   * used.
+   */
+  void SampleBits();
+
+  /**
+   * Lay out the second hash table again so that each bucket has the given
+   * capacity, keeping the contents of each bucket.
+   *
+   * @param capacities Capacity of each bucket; must not be less than the size
+   *     of the bucket.
+   */
+  void LayoutBuckets(const arma::Col<size_t>& capacities);
+
+  /**
+   * Buffers used to collect the candidates of a single query.  Each thread has
+   * its own workspace, which is reused for every query it processes, so that
+   * no memory has to be allocated for each query.
+   */
+  struct QueryWorkspace
+  {
+    //! The projection of the query in each table (numProj x tables).
+    arma::mat queryCodesNotFloored;
+    //! The code of the query in each table (numProj x tables).
+    arma::mat queryCodes;
+    //! The bucket of each probing bin in each table ((T + 1) x tables).
+    arma::Mat<size_t> hashMat;
+    //! The codes of the additional probing bins of a single table.
+    arma::mat additionalProbingBins;
+
+    //! The score, action and dimension of each perturbation.
+    arma::vec scores;
+    arma::Col<short int> actions;
+    arma::Col<size_t> positions;
+    //! The perturbations, sorted by increasing score.
+    std::vector<size_t> sortedIndices;
+    arma::vec sortedScores;
+    arma::Col<short int> sortedActions;
+    arma::Col<size_t> sortedPositions;
+
+    //! All perturbation sets generated so far, each stored as 2 * numProj
+    //! flags.
+    std::vector<bool> perturbationSets;
+    //! The current, shifted and expanded perturbation sets.
+    std::vector<bool> Ai, As, Ae;
+    //! Min-heap of (score, perturbation set index) pairs.
+    std::vector<std::pair<double, size_t>> minHeap;
+
+    //! Marks for the reference points that are candidates.
+    std::vector<char> marks;
+    //! The candidates of the query.
+    std::vector<arma::uword> candidates;
+  };
+
+  /**
+   * Compute the neighbors of every point in the given query set.  The query
+   * set is projected onto all of the tables with one matrix multiplication per
+   * block of queries, and then the queries are processed in parallel.
    *
-   * @param queryPoint The query point currently being processed.
-   * @param referenceIndices The list of neighbor candidates obtained from
-   *    hashing the query into all the hash tables and eventually into
-   *    multiple buckets of the second hash table.
+   * @param querySet Set of query points.
+   * @param sameSet Whether the query set is the reference set.
+   * @param k Number of neighbors to search for.
+   * @param resultingNeighbors Matrix storing lists of neighbors for each query
+   *     point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
    * @param numTablesToSearch The number of tables to perform the search in. If
    *    0, all tables are searched.
+   * @param T The number of additional probing bins for multiprobe LSH.
+   */
+  void SearchInternal(const MatType& querySet,
+                      const bool sameSet,
+                      const size_t k,
+                      arma::Mat<size_t>& resultingNeighbors,
+                      arma::mat& distances,
+                      size_t numTablesToSearch,
+                      const size_t T);
+
+  /**
+   * Return the bucket of the second hash table that the given
+   * numProj-dimensional code falls into.
+   *
+   * @param code The code to hash.
+   */
+  size_t SecondHashBucket(const double* code) const;
+
+  /**
+   * This function takes the projections of a query in each of the hash tables
+   * (held in workspace.queryCodesNotFloored) to get keys for the query, and
+   * then the key is hashed to a bucket of the second hash table and all the
+   * points (if any) in those buckets are collected as the potential neighbor
+   * candidates.  The candidates are stored, sorted, in workspace.candidates.
+   *
+   * @param workspace Buffers holding the projections of the query, and used to
+   *    collect the candidates.
+   * @param numTablesToSearch The number of tables to perform the search in.
    * @param T The number of additional probing bins for multiprobe LSH. If 0,
    *    single-probe is used.
    */
-  template<typename VecType>
-  void ReturnIndicesFromTable(const VecType& queryPoint,
-                              arma::uvec& referenceIndices,
-                              size_t numTablesToSearch,
+  void ReturnIndicesFromTable(QueryWorkspace& workspace,
+                              const size_t numTablesToSearch,
                               const size_t T) const;
 
   /**
@@ -337,7 +524,7 @@ class LSHSearch
    * @param distances Matrix holding output distances.
    */
   void BaseCase(const size_t queryIndex,
-                const arma::uvec& referenceIndices,
+                const std::vector<arma::uword>& referenceIndices,
                 const size_t k,
                 arma::Mat<size_t>& neighbors,
                 arma::mat& distances) const;
@@ -357,7 +544,7 @@ class LSHSearch
    * @param distances Matrix holding output distances.
    */
   void BaseCase(const size_t queryIndex,
-                const arma::uvec& referenceIndices,
+                const std::vector<arma::uword>& referenceIndices,
                 const size_t k,
                 const MatType& querySet,
                 arma::Mat<size_t>& neighbors,
@@ -370,17 +557,17 @@ class LSHSearch
    * likely alternative bin codes (other than queryCode) where a query's
    * neighbors might be found in.
    *
-   * @param queryCode vector containing the numProj-dimensional query code.
-   * @param queryCodeNotFloored vector containing the projection location of the
-   *    query.
+   * The query's code and projection location in the given table are taken
+   * from workspace.queryCodes and workspace.queryCodesNotFloored, and each
+   * column of workspace.additionalProbingBins will hold one additional bin.
+   *
+   * @param table The table to compute additional probing bins for.
    * @param T number of additional probing bins.
-   * @param additionalProbingBins matrix. Each column will hold one additional
-   *    bin.
+   * @param workspace Buffers used for the computation.
   */
-  void GetAdditionalProbingBins(const arma::vec& queryCode,
-                                const arma::vec& queryCodeNotFloored,
+  void GetAdditionalProbingBins(const size_t table,
                                 const size_t T,
-                                arma::mat& additionalProbingBins) const;
+                                QueryWorkspace& workspace) const;
 
   /**
    * Returns the score of a perturbation vector generated by perturbation set A.
@@ -446,17 +633,21 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
+  //! The final hash table, in compressed sparse row format: the indices of
+  //! the points in bucket i are bucketContents[bucketOffsets[i]] through
+  //! bucketContents[bucketOffsets[i] + bucketSizes[i] - 1].  Each bucket holds
+  //! at most bucketSize points.  After Insert() or Remove(), a bucket may have
+  //! unused space up to bucketOffsets[i + 1].
+  arma::Col<arma::u32> bucketContents;
+
+  //! The offset of each bucket in bucketContents.  Length secondHashSize + 1.
+  arma::Col<size_t> bucketOffsets;
 
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
+  //! The number of points in each bucket.  Length secondHashSize.
+  arma::Col<size_t> bucketSizes;
 
-  //! For a particular hash value, points to the row in secondHashTable
-  //! corresponding to this value. Length secondHashSize.
-  arma::Col<size_t> bucketRowInHashTable;
+  //! Whether or not each reference point has been removed.
+  arma::Col<arma::u8> removedPoints;
 
   //! The number of distance evaluations.
   size_t distanceEvaluations;
@@ -479,6 +670,10 @@ class LSHSearch
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename SortPolicy, typename MatType,
+    typename MetricType), (mlpack::LSHSearch<SortPolicy, MatType, MetricType>),
+    (2));
+
 // Include implementation.
 #include "lsh_search_impl.hpp"
 
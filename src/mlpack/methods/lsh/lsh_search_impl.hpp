@@ -18,8 +18,8 @@
 namespace mlpack {
 
 // Construct the object with random tables
-template<typename SortPolicy, typename MatType>
-LSHSearch<SortPolicy, MatType>::
+template<typename SortPolicy, typename MatType, typename MetricType>
+LSHSearch<SortPolicy, MatType, MetricType>::
 LSHSearch(MatType referenceSet,
           const size_t numProj,
           const size_t numTables,
@@ -39,8 +39,8 @@ LSHSearch(MatType referenceSet,
 }
 
 // Construct the object with given tables
-template<typename SortPolicy, typename MatType>
-LSHSearch<SortPolicy, MatType>::
+template<typename SortPolicy, typename MatType, typename MetricType>
+LSHSearch<SortPolicy, MatType, MetricType>::
 LSHSearch(MatType referenceSet,
           const arma::cube& projections,
           const double hashWidthIn,
@@ -59,8 +59,8 @@ LSHSearch(MatType referenceSet,
 }
 
 // Empty constructor.
-template<typename SortPolicy, typename MatType>
-LSHSearch<SortPolicy, MatType>::LSHSearch() :
+template<typename SortPolicy, typename MatType, typename MetricType>
+LSHSearch<SortPolicy, MatType, MetricType>::LSHSearch() :
     numProj(0),
     numTables(0),
     hashWidth(0),
@@ -71,8 +71,8 @@ LSHSearch<SortPolicy, MatType>::LSHSearch() :
 }
 
 // Copy constructor.
-template<typename SortPolicy, typename MatType>
-LSHSearch<SortPolicy, MatType>::LSHSearch(const LSHSearch& other) :
+template<typename SortPolicy, typename MatType, typename MetricType>
+LSHSearch<SortPolicy, MatType, MetricType>::LSHSearch(const LSHSearch& other) :
     referenceSet(other.referenceSet), // Copy the other set.
     numProj(other.numProj),
     numTables(other.numTables),
@@ -82,17 +82,18 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(const LSHSearch& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
-    secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
-    bucketRowInHashTable(other.bucketRowInHashTable),
+    bucketContents(other.bucketContents),
+    bucketOffsets(other.bucketOffsets),
+    bucketSizes(other.bucketSizes),
+    removedPoints(other.removedPoints),
     distanceEvaluations(other.distanceEvaluations)
 {
   // Nothing to do.
 }
 
 // Move constructor.
-template<typename SortPolicy, typename MatType>
-LSHSearch<SortPolicy, MatType>::LSHSearch(LSHSearch&& other) :
+template<typename SortPolicy, typename MatType, typename MetricType>
+LSHSearch<SortPolicy, MatType, MetricType>::LSHSearch(LSHSearch&& other) :
     referenceSet(std::move(other.referenceSet)),
     numProj(other.numProj),
     numTables(other.numTables),
@@ -102,9 +103,10 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(LSHSearch&& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
-    secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
-    bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
+    bucketContents(std::move(other.bucketContents)),
+    bucketOffsets(std::move(other.bucketOffsets)),
+    bucketSizes(std::move(other.bucketSizes)),
+    removedPoints(std::move(other.removedPoints)),
     distanceEvaluations(other.distanceEvaluations)
 {
   // Reset other model to defaults.
@@ -117,8 +119,9 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(LSHSearch&& other) :
 }
 
 // Copy operator.
-template<typename SortPolicy, typename MatType>
-LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
+template<typename SortPolicy, typename MatType, typename MetricType>
+LSHSearch<SortPolicy, MatType, MetricType>&
+LSHSearch<SortPolicy, MatType, MetricType>::operator=(
     const LSHSearch& other)
 {
   referenceSet = other.referenceSet;
@@ -130,17 +133,19 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
-  secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
-  bucketRowInHashTable = other.bucketRowInHashTable;
+  bucketContents = other.bucketContents;
+  bucketOffsets = other.bucketOffsets;
+  bucketSizes = other.bucketSizes;
+  removedPoints = other.removedPoints;
   distanceEvaluations = other.distanceEvaluations;
 
   return *this;
 }
 
 // Move operator.
-template<typename SortPolicy, typename MatType>
-LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
+template<typename SortPolicy, typename MatType, typename MetricType>
+LSHSearch<SortPolicy, MatType, MetricType>&
+LSHSearch<SortPolicy, MatType, MetricType>::operator=(
     LSHSearch&& other)
 {
   referenceSet = std::move(other.referenceSet);
@@ -152,9 +157,10 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
-  secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
-  bucketRowInHashTable = std::move(other.bucketRowInHashTable);
+  bucketContents = std::move(other.bucketContents);
+  bucketOffsets = std::move(other.bucketOffsets);
+  bucketSizes = std::move(other.bucketSizes);
+  removedPoints = std::move(other.removedPoints);
   distanceEvaluations = other.distanceEvaluations;
 
   // Reset other model to defaults.
@@ -169,15 +175,23 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
 }
 
 // Train on a new reference set.
-template<typename SortPolicy, typename MatType>
-void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
-                                           const size_t numProj,
-                                           const size_t numTables,
-                                           const double hashWidthIn,
-                                           const size_t secondHashSize,
-                                           const size_t bucketSize,
-                                           const arma::cube& projection)
+template<typename SortPolicy, typename MatType, typename MetricType>
+void LSHSearch<SortPolicy, MatType, MetricType>::Train(
+    MatType referenceSet,
+    const size_t numProj,
+    const size_t numTables,
+    const double hashWidthIn,
+    const size_t secondHashSize,
+    const size_t bucketSize,
+    const arma::cube& projection)
 {
+  // Point indices are stored as 32-bit integers in the second hash table.
+  if (referenceSet.n_cols > std::numeric_limits<arma::u32>::max())
+  {
+    throw std::invalid_argument("LSHSearch::Train(): reference set must have "
+        "fewer than 2^32 points");
+  }
+
   // Set new reference set.
   this->referenceSet = std::move(referenceSet);
 
@@ -188,7 +202,12 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
   this->secondHashSize = secondHashSize;
   this->bucketSize = bucketSize;
 
-  if (hashWidth == 0.0) // The user has not provided any value.
+  // A sampled bit is 0 or 1, so the code of each bit is the bit itself.
+  if (BitSampling)
+  {
+    hashWidth = 1.0;
+  }
+  else if (hashWidth == 0.0) // The user has not provided any value.
   {
     const size_t numSamples = 25;
     // Compute a heuristic hash width from the data.
@@ -218,23 +237,29 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
   secondHashWeights = arma::floor(arma::randu(numProj) *
                                   (double) secondHashSize);
 
-  // Instead of putting the points in the row corresponding to the bucket, we
-  // chose the next empty row and keep track of the row in which the bucket
-  // lies. This allows us to stack together and slice out the empty buckets at
-  // the end of the hashing.
-  bucketRowInHashTable.set_size(secondHashSize);
-  bucketRowInHashTable.fill(secondHashSize);
-
   // Step II: The offsets for all projections in all tables.
   // Since the 'offsets' are in [0, hashWidth], we obtain the 'offsets'
-  // as randu(numProj, numTables) * hashWidth.
-  offsets.randu(numProj, numTables);
-  offsets *= hashWidth;
+  // as randu(numProj, numTables) * hashWidth.  A sampled bit is always offset
+  // to the middle of its bin, so that a query is as close to both limits.
+  if (BitSampling)
+  {
+    offsets.set_size(numProj, numTables);
+    offsets.fill(0.5);
+  }
+  else
+  {
+    offsets.randu(numProj, numTables);
+    offsets *= hashWidth;
+  }
 
   // Step III: Obtain the 'numProj' projections for each table.
   projections.clear(); // Reset projections vector.
 
-  if (projection.n_slices == 0) // Randomly generate the tables.
+  if (projection.n_slices == 0 && BitSampling)
+  {
+    SampleBits();
+  }
+  else if (projection.n_slices == 0) // Randomly generate the tables.
   {
     // For L2 metric, 2-stable distributions are used, and the normal Z ~ N(0,
     // 1) is a 2-stable distribution.
@@ -244,6 +269,18 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
   }
   else if (projection.n_slices == numTables) // Take user-defined tables.
   {
+    const size_t numBits = this->referenceSet.n_rows *
+        data::BitsPerPackedElement<typename MatType::elem_type>();
+    if (BitSampling && (projection.n_rows != 1 || projection.n_cols != numProj
+        || (projection.n_elem > 0 && projection.max() >= numBits)))
+    {
+      std::ostringstream oss;
+      oss << "LSHSearch::Train(): with bit sampling, the projection tables "
+          << "must be a 1 x " << numProj << " x " << numTables << " cube of "
+          << "bit indices less than " << numBits << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
     projections = projection;
   }
   else // The user gave something wrong.
@@ -252,10 +289,68 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
         "tables provided must be equal to numProj");
   }
 
+  // Hash every point into a bucket of the second hash table, for each table.
+  // The bucket of point j in table i is held in secondHashVectors(i, j).
+  arma::Mat<size_t> secondHashVectors;
+  SecondHashCodes(this->referenceSet, secondHashVectors);
+
+  // Now, using the hash vectors for each table, count the number of rows we
+  // have in the second hash table.
+  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
+  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
+    secondHashBinCounts[secondHashVectors[i]]++;
+
+  // Enforce the maximum bucket size.
+  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
+  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
+      { return std::min(val, effectiveBucketSize); });
+
+  // Now lay out the buckets contiguously.  Bucket i starts at
+  // bucketOffsets[i]; empty buckets take no space.
+  bucketOffsets.set_size(secondHashSize + 1);
+  bucketOffsets[0] = 0;
+  for (size_t i = 0; i < secondHashSize; ++i)
+    bucketOffsets[i + 1] = bucketOffsets[i] + secondHashBinCounts[i];
+  bucketContents.set_size(bucketOffsets[secondHashSize]);
+
+  // Next we must assign each point in each table to the right bucket.  Points
+  // beyond the maximum bucket size are dropped.
+  bucketSizes.zeros(secondHashSize);
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    {
+      // This is the bucket number.  The point ID is 'j'.
+      const size_t hashInd = (size_t) secondHashVectors(i, j);
+      if (bucketSizes[hashInd] < secondHashBinCounts[hashInd])
+      {
+        bucketContents[bucketOffsets[hashInd] + bucketSizes[hashInd]] =
+            (arma::u32) j;
+        ++bucketSizes[hashInd];
+      }
+    } // Loop over all points in the reference set.
+  } // Loop over tables.
+
+  // No points have been removed yet.
+  removedPoints.zeros(this->referenceSet.n_cols);
+
+  const size_t numRowsInTable = accu(secondHashBinCounts > 0);
+  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
+            << "maximum length of " << max(secondHashBinCounts) << ", "
+            << "totaling " << accu(secondHashBinCounts) << " elements."
+            << std::endl;
+}
+
+// Compute the second-level hash codes of a set of points.
+template<typename SortPolicy, typename MatType, typename MetricType>
+template<typename PointsType>
+void LSHSearch<SortPolicy, MatType, MetricType>::SecondHashCodes(
+    const PointsType& points,
+    arma::Mat<size_t>& secondHashVectors) const
+{
   // We will store the second hash vectors in this matrix; the second hash
-  // vector for table i will be held in row i.  We have to use int and not
-  // size_t, otherwise negative numbers are cast to 0.
-  arma::Mat<size_t> secondHashVectors(numTables, this->referenceSet.n_cols);
+  // vector for table i will be held in row i.
+  secondHashVectors.set_size(numTables, points.n_cols);
 
   for (size_t i = 0; i < numTables; ++i)
   {
@@ -264,19 +359,19 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
 
     // The following code performs the task of hashing each point to a
     // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
-    // 'referenceSet.n_cols') key matrix.
+    // 'points.n_cols') key matrix.
     //
     // For a single table, let the 'numProj' projections be denoted by 'proj_i'
     // and the corresponding offset be 'offset_i'.  Then the key of a single
     // point is obtained as:
     // key = { floor((<proj_i, point> + offset_i) / 'hashWidth') forall i }
-    arma::mat offsetMat = repmat(offsets.unsafe_col(i), 1,
-                                 this->referenceSet.n_cols);
-    arma::mat hashMat = projections.slice(i).t() * (this->referenceSet);
+    arma::mat offsetMat = repmat(offsets.unsafe_col(i), 1, points.n_cols);
+    arma::mat hashMat;
+    Project(points, i, 1, hashMat);
     hashMat += offsetMat;
     hashMat /= hashWidth;
 
-    // Step V: Putting the points in the 'secondHashTable' by hashing the key.
+    // Step V: Putting the points in the second hash table by hashing the key.
     // Now we hash every key, point ID to its corresponding bucket.  We must
     // also normalize the hashes to the range [0, secondHashSize).
     arma::rowvec unmodVector = secondHashWeights.t() * arma::floor(hashMat);
@@ -296,65 +391,293 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
       }
     }
   }
+}
 
-  // Now, using the hash vectors for each table, count the number of rows we
-  // have in the second hash table.
-  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
-  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
-    secondHashBinCounts[secondHashVectors[i]]++;
+// Compute the projections of a set of points in consecutive tables.
+template<typename SortPolicy, typename MatType, typename MetricType>
+template<typename PointsType>
+void LSHSearch<SortPolicy, MatType, MetricType>::Project(
+    const PointsType& points,
+    const size_t firstTable,
+    const size_t tables,
+    arma::mat& projected) const
+{
+  // The projections of consecutive tables are held contiguously in the cube,
+  // so we can view them as a single matrix.
+  const arma::mat tableProjections(
+      const_cast<double*>(projections.slice(firstTable).memptr()),
+      projections.n_rows, numProj * tables, false, true);
 
-  // Enforce the maximum bucket size.
+  if (!BitSampling)
+  {
+    projected = tableProjections.t() * points;
+    return;
+  }
+
+  // Each projection is the index of a sampled bit, which is read from the
+  // element of the packed code that holds it.
+  const size_t bits = data::BitsPerPackedElement<
+      typename MatType::elem_type>();
+  projected.set_size(tableProjections.n_cols, points.n_cols);
+  for (size_t j = 0; j < points.n_cols; ++j)
+  {
+    for (size_t c = 0; c < tableProjections.n_cols; ++c)
+    {
+      const size_t bit = (size_t) tableProjections[c];
+      const uint64_t word = (uint64_t) points(bit / bits, j);
+      projected(c, j) = (double) ((word >> (bit % bits)) & 1);
+    }
+  }
+}
+
+// Sample the bits used by each table for bit sampling.
+template<typename SortPolicy, typename MatType, typename MetricType>
+void LSHSearch<SortPolicy, MatType, MetricType>::SampleBits()
+{
+  // A bit is worth sampling if it differs between two reference points.
+  const size_t bits = data::BitsPerPackedElement<
+      typename MatType::elem_type>();
+  std::vector<double> candidates;
+  for (size_t e = 0; e < referenceSet.n_rows; ++e)
+  {
+    uint64_t anySet = 0;
+    uint64_t allSet = ~uint64_t(0);
+    for (size_t j = 0; j < referenceSet.n_cols; ++j)
+    {
+      const uint64_t word = (uint64_t) referenceSet(e, j);
+      anySet |= word;
+      allSet &= word;
+    }
+
+    for (size_t b = 0; b < bits; ++b)
+      if (((anySet ^ allSet) >> b) & 1)
+        candidates.push_back((double) (e * bits + b));
+  }
+
+  // If every point is the same, any bit gives the same buckets.
+  if (candidates.empty())
+    candidates.push_back(0.0);
+
+  // Within a table, the bits are different if there are enough of them.
+  projections.set_size(1, numProj, numTables);
+  for (size_t t = 0; t < numTables; ++t)
+  {
+    if (numProj <= candidates.size())
+    {
+      const arma::uvec order = arma::randperm(candidates.size(), numProj);
+      for (size_t p = 0; p < numProj; ++p)
+        projections(0, p, t) = candidates[order[p]];
+    }
+    else
+    {
+      for (size_t p = 0; p < numProj; ++p)
+        projections(0, p, t) = candidates[RandInt(candidates.size())];
+    }
+  }
+}
+
+// Lay out the second hash table with new bucket capacities.
+template<typename SortPolicy, typename MatType, typename MetricType>
+void LSHSearch<SortPolicy, MatType, MetricType>::LayoutBuckets(
+    const arma::Col<size_t>& capacities)
+{
+  arma::Col<size_t> newOffsets(secondHashSize + 1);
+  newOffsets[0] = 0;
+  for (size_t i = 0; i < secondHashSize; ++i)
+    newOffsets[i + 1] = newOffsets[i] + capacities[i];
+
+  arma::Col<arma::u32> newContents(newOffsets[secondHashSize],
+      arma::fill::zeros);
+  for (size_t i = 0; i < secondHashSize; ++i)
+  {
+    std::copy(bucketContents.begin() + bucketOffsets[i],
+              bucketContents.begin() + bucketOffsets[i] + bucketSizes[i],
+              newContents.begin() + newOffsets[i]);
+  }
+
+  bucketOffsets = std::move(newOffsets);
+  bucketContents = std::move(newContents);
+}
+
+// Add new points to the model.
+template<typename SortPolicy, typename MatType, typename MetricType>
+void LSHSearch<SortPolicy, MatType, MetricType>::Insert(
+    const MatType& newPoints)
+{
+  if (projections.n_slices == 0)
+  {
+    throw std::invalid_argument("LSHSearch::Insert(): model must be trained "
+        "before points can be inserted");
+  }
+
+  util::CheckSameDimensionality(newPoints, referenceSet, "LSHSearch::Insert()",
+      "new points");
+
+  // Point indices are stored as 32-bit integers in the second hash table.
+  if (referenceSet.n_cols + newPoints.n_cols >
+      std::numeric_limits<arma::u32>::max())
+  {
+    throw std::invalid_argument("LSHSearch::Insert(): reference set must have "
+        "fewer than 2^32 points");
+  }
+
+  if (newPoints.n_cols == 0)
+    return;
+
+  const size_t oldNumPoints = referenceSet.n_cols;
+  MatType newReferenceSet = arma::join_rows(referenceSet, newPoints);
+  referenceSet = std::move(newReferenceSet);
+  removedPoints.resize(referenceSet.n_cols);
+  removedPoints.tail(newPoints.n_cols).zeros();
+
+  arma::Mat<size_t> secondHashVectors;
+  SecondHashCodes(newPoints, secondHashVectors);
+
+  // Find the buckets that don't have enough space for the new points.  Their
+  // capacity is at least doubled, so that the table does not have to be laid
+  // out again for every insertion.
   const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
-  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
-      { return std::min(val, effectiveBucketSize); });
+  arma::Col<size_t> requested(secondHashSize, arma::fill::zeros);
+  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
+    requested[secondHashVectors[i]]++;
 
-  const size_t numRowsInTable = accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
+  arma::Col<size_t> capacities(secondHashSize);
+  bool grow = false;
+  for (size_t i = 0; i < secondHashSize; ++i)
+  {
+    capacities[i] = bucketOffsets[i + 1] - bucketOffsets[i];
+    const size_t needed = std::min(bucketSizes[i] + requested[i],
+        effectiveBucketSize);
+    if (needed > capacities[i])
+    {
+      capacities[i] = std::min(std::max(needed, 2 * capacities[i]),
+          effectiveBucketSize);
+      grow = true;
+    }
+  }
+
+  if (grow)
+    LayoutBuckets(capacities);
 
-  // Next we must assign each point in each table to the right second hash
-  // table.
-  size_t currentRow = 0;
+  // Now add the new points to their buckets, in the same order that Train()
+  // uses.  Points beyond the maximum bucket size are dropped.
   for (size_t i = 0; i < numTables; ++i)
   {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
     for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
     {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
-      if (bucketRowInHashTable[hashInd] == secondHashSize)
+      const size_t hashInd = secondHashVectors(i, j);
+      if (bucketSizes[hashInd] < effectiveBucketSize)
       {
-        bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
-        currentRow++;
+        bucketContents[bucketOffsets[hashInd] + bucketSizes[hashInd]] =
+            (arma::u32) (oldNumPoints + j);
+        ++bucketSizes[hashInd];
       }
+    }
+  }
+}
 
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
-    } // Loop over all points in the reference set.
-  } // Loop over tables.
+// Remove points from the model.
+template<typename SortPolicy, typename MatType, typename MetricType>
+void LSHSearch<SortPolicy, MatType, MetricType>::Remove(
+    const arma::uvec& indices)
+{
+  // Check all indices before modifying anything.
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    if (indices[i] >= referenceSet.n_cols)
+    {
+      std::ostringstream oss;
+      oss << "LSHSearch::Remove(): index " << indices[i] << " is invalid; "
+          << "reference set has " << referenceSet.n_cols << " points!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
 
-  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
-            << "maximum length of " << max(secondHashBinCounts) << ", "
-            << "totaling " << accu(secondHashBinCounts) << " elements."
-            << std::endl;
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    const size_t index = indices[i];
+    if (removedPoints[index])
+      continue;
+    removedPoints[index] = 1;
+
+    // The point is in at most one bucket for each table; this is the same
+    // bucket it was hashed into when it was added.
+    arma::Mat<size_t> secondHashVectors;
+    SecondHashCodes(referenceSet.col(index), secondHashVectors);
+    for (size_t t = 0; t < numTables; ++t)
+    {
+      const size_t hashInd = secondHashVectors[t];
+      arma::u32* bucketBegin = bucketContents.memptr() +
+          bucketOffsets[hashInd];
+      arma::u32* bucketEnd = bucketBegin + bucketSizes[hashInd];
+      arma::u32* pos = std::find(bucketBegin, bucketEnd, (arma::u32) index);
+      if (pos != bucketEnd)
+      {
+        // Keep the order of the other points in the bucket.
+        std::copy(pos + 1, bucketEnd, pos);
+        --bucketSizes[hashInd];
+      }
+    }
+  }
+
+  // If most of the second hash table is unused, release the space.
+  const size_t used = arma::accu(bucketSizes);
+  if (bucketContents.n_elem > 2 * used)
+    LayoutBuckets(bucketSizes);
+}
+
+// Drop removed points from the reference set.
+template<typename SortPolicy, typename MatType, typename MetricType>
+void LSHSearch<SortPolicy, MatType, MetricType>::Compact()
+{
+  // Compute the new index of every point.
+  arma::Col<size_t> newIndices(referenceSet.n_cols);
+  size_t numRemoved = 0;
+  for (size_t i = 0; i < referenceSet.n_cols; ++i)
+  {
+    newIndices[i] = i - numRemoved;
+    if (removedPoints[i])
+      ++numRemoved;
+  }
+
+  // Removed points are not in any bucket, so we only need to renumber the
+  // remaining ones.
+  for (size_t i = 0; i < secondHashSize; ++i)
+  {
+    for (size_t j = bucketOffsets[i]; j < bucketOffsets[i] + bucketSizes[i];
+        ++j)
+      bucketContents[j] = (arma::u32) newIndices[bucketContents[j]];
+  }
+  LayoutBuckets(bucketSizes);
+
+  // Shed each run of removed points, starting from the end so that the
+  // indices of the runs that are left do not change.
+  size_t end = referenceSet.n_cols;
+  while (end > 0)
+  {
+    if (!removedPoints[end - 1])
+    {
+      --end;
+      continue;
+    }
+
+    size_t begin = end - 1;
+    while (begin > 0 && removedPoints[begin - 1])
+      --begin;
+    referenceSet.shed_cols(begin, end - 1);
+    end = begin;
+  }
+
+  removedPoints.zeros(referenceSet.n_cols);
 }
 
 // Base case where the query set is the reference set.  (So, we can't return
 // ourselves as the nearest neighbor.)
-template<typename SortPolicy, typename MatType>
+template<typename SortPolicy, typename MatType, typename MetricType>
 inline mlpack_force_inline
-void LSHSearch<SortPolicy, MatType>::BaseCase(
+void LSHSearch<SortPolicy, MatType, MetricType>::BaseCase(
     const size_t queryIndex,
-    const arma::uvec& referenceIndices,
+    const std::vector<arma::uword>& referenceIndices,
     const size_t k,
     arma::Mat<size_t>& neighbors,
     arma::mat& distances) const
@@ -367,14 +690,14 @@ void LSHSearch<SortPolicy, MatType>::BaseCase(
   std::vector<Candidate> vect(k, def);
   CandidateList pqueue(CandidateCmp(), std::move(vect));
 
-  for (size_t j = 0; j < referenceIndices.n_elem; ++j)
+  for (size_t j = 0; j < referenceIndices.size(); ++j)
   {
     const size_t referenceIndex = referenceIndices[j];
     // If the points are the same, skip this point.
     if (queryIndex == referenceIndex)
       continue;
 
-    const double distance = EuclideanDistance::Evaluate(
+    const double distance = MetricType::Evaluate(
         referenceSet.col(queryIndex),
         referenceSet.col(referenceIndex));
 
@@ -396,11 +719,11 @@ void LSHSearch<SortPolicy, MatType>::BaseCase(
 }
 
 // Base case for bichromatic search.
-template<typename SortPolicy, typename MatType>
+template<typename SortPolicy, typename MatType, typename MetricType>
 inline mlpack_force_inline
-void LSHSearch<SortPolicy, MatType>::BaseCase(
+void LSHSearch<SortPolicy, MatType, MetricType>::BaseCase(
     const size_t queryIndex,
-    const arma::uvec& referenceIndices,
+    const std::vector<arma::uword>& referenceIndices,
     const size_t k,
     const MatType& querySet,
     arma::Mat<size_t>& neighbors,
@@ -414,10 +737,10 @@ void LSHSearch<SortPolicy, MatType>::BaseCase(
   std::vector<Candidate> vect(k, def);
   CandidateList pqueue(CandidateCmp(), std::move(vect));
 
-  for (size_t j = 0; j < referenceIndices.n_elem; ++j)
+  for (size_t j = 0; j < referenceIndices.size(); ++j)
   {
     const size_t referenceIndex = referenceIndices[j];
-    const double distance = EuclideanDistance::Evaluate(
+    const double distance = MetricType::Evaluate(
         querySet.col(queryIndex),
         referenceSet.col(referenceIndex));
 
@@ -438,9 +761,9 @@ void LSHSearch<SortPolicy, MatType>::BaseCase(
   }
 }
 
-template<typename SortPolicy, typename MatType>
+template<typename SortPolicy, typename MatType, typename MetricType>
 inline mlpack_force_inline
-double LSHSearch<SortPolicy, MatType>::PerturbationScore(
+double LSHSearch<SortPolicy, MatType, MetricType>::PerturbationScore(
     const std::vector<bool>& A,
     const arma::vec& scores) const
 {
@@ -451,9 +774,9 @@ double LSHSearch<SortPolicy, MatType>::PerturbationScore(
   return score;
 }
 
-template<typename SortPolicy, typename MatType>
+template<typename SortPolicy, typename MatType, typename MetricType>
 inline mlpack_force_inline
-bool LSHSearch<SortPolicy, MatType>::PerturbationShift(
+bool LSHSearch<SortPolicy, MatType, MetricType>::PerturbationShift(
     std::vector<bool>& A) const
 {
   size_t maxPos = 0;
@@ -470,9 +793,9 @@ bool LSHSearch<SortPolicy, MatType>::PerturbationShift(
   return false; // invalid
 }
 
-template<typename SortPolicy, typename MatType>
+template<typename SortPolicy, typename MatType, typename MetricType>
 inline mlpack_force_inline
-bool LSHSearch<SortPolicy, MatType>::PerturbationExpand(
+bool LSHSearch<SortPolicy, MatType, MetricType>::PerturbationExpand(
     std::vector<bool>& A) const
 {
   // Find the last '1' in A.
@@ -489,9 +812,9 @@ bool LSHSearch<SortPolicy, MatType>::PerturbationExpand(
   return false;
 }
 
-template<typename SortPolicy, typename MatType>
+template<typename SortPolicy, typename MatType, typename MetricType>
 inline mlpack_force_inline
-bool LSHSearch<SortPolicy, MatType>::PerturbationValid(
+bool LSHSearch<SortPolicy, MatType, MetricType>::PerturbationValid(
     const std::vector<bool>& A) const
 {
   // Use check to mark dimensions we have seen before in A. If a dimension is
@@ -519,53 +842,61 @@ bool LSHSearch<SortPolicy, MatType>::PerturbationValid(
 }
 
 // Compute additional probing bins for a query
-template<typename SortPolicy, typename MatType>
-void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
-    const arma::vec& queryCode,
-    const arma::vec& queryCodeNotFloored,
+template<typename SortPolicy, typename MatType, typename MetricType>
+void LSHSearch<SortPolicy, MatType, MetricType>::GetAdditionalProbingBins(
+    const size_t table,
     const size_t T,
-    arma::mat& additionalProbingBins) const
+    QueryWorkspace& workspace) const
 {
   // No additional bins requested. Our work is done.
   if (T == 0)
     return;
 
-  // Each column of additionalProbingBins is the code of a bin.
-  additionalProbingBins.set_size(numProj, T);
+  const double* queryCode = workspace.queryCodes.colptr(table);
+  const double* projection = workspace.queryCodesNotFloored.colptr(table);
 
-  // Copy the query's code, then in the end we will  add/subtract according
-  // to perturbations we calculated.
+  // Each column of additionalProbingBins is the code of a bin.  Copy the
+  // query's code, then in the end we will add/subtract according to
+  // perturbations we calculated.
+  arma::mat& additionalProbingBins = workspace.additionalProbingBins;
+  additionalProbingBins.set_size(numProj, T);
   for (size_t c = 0; c < T; ++c)
-    additionalProbingBins.col(c) = queryCode;
-
-
-  // Calculate query point's projection position.
-  arma::mat projection = queryCodeNotFloored;
-
-  // Use projection to calculate query's distance from hash limits.
-  arma::vec limLow = projection - queryCode * hashWidth;
-  arma::vec limHigh = hashWidth - limLow;
-
-  // Calculate scores. score = distance^2.
-  arma::vec scores(2 * numProj);
-  scores.rows(0, numProj - 1) = pow(limLow, 2);
-  scores.rows(numProj, (2 * numProj) - 1) = pow(limHigh, 2);
-
-  // Actions vector describes what perturbation (-1/+1) corresponds to a score.
-  arma::Col<short int> actions(2 * numProj); // will be [-1 ... 1 ...]
-  actions.rows(0, numProj - 1) = // First numProj rows.
-    -1 * arma::ones< arma::Col<short int> > (numProj); // -1s
-  actions.rows(numProj, (2 * numProj) - 1) = // Last numProj rows.
-    arma::ones< arma::Col<short int> > (numProj); // 1s
+    std::copy(queryCode, queryCode + numProj, additionalProbingBins.colptr(c));
+
+  // Use the query's projection position to calculate the query's distance
+  // from the hash limits, and calculate scores (score = distance^2).  The
+  // actions (-1/+1) show how each score perturbs the code, and the positions
+  // show which coordinate of the code is perturbed.  Scores are laid out as
+  // [low limits ... high limits ...], so actions are [-1 ... 1 ...] and
+  // positions are [0 1 2 ... 0 1 2 ...].
+  arma::vec& scores = workspace.scores;
+  arma::Col<short int>& actions = workspace.actions;
+  arma::Col<size_t>& positions = workspace.positions;
+  scores.set_size(2 * numProj);
+  actions.set_size(2 * numProj);
+  positions.set_size(2 * numProj);
+  for (size_t p = 0; p < numProj; ++p)
+  {
+    const double limLow = projection[p] - queryCode[p] * hashWidth;
+    const double limHigh = hashWidth - limLow;
 
+    scores[p] = limLow * limLow;
+    scores[numProj + p] = limHigh * limHigh;
 
-  // Acting dimension vector shows which coordinate to transform according to
-  // actions (actions are described by actions vector above).
-  arma::Col<size_t> positions(2 * numProj); // Will be [0 1 2 ... 0 1 2 ...].
-  positions.rows(0, numProj - 1) =
-    arma::linspace< arma::Col<size_t> >(0, numProj - 1, numProj);
-  positions.rows(numProj, 2 * numProj - 1) =
-    arma::linspace< arma::Col<size_t> >(0, numProj - 1, numProj);
+    // A sampled bit can only be flipped, and all flips are equally likely; the
+    // code of a 1 bit can only decrease, and the code of a 0 bit can only
+    // increase, so the other perturbation is never chosen.
+    if (BitSampling)
+    {
+      const double never = std::numeric_limits<double>::infinity();
+      scores[p] = (queryCode[p] == 1.0) ? 1.0 : never;
+      scores[numProj + p] = (queryCode[p] == 1.0) ? never : 1.0;
+    }
+    actions[p] = -1;
+    actions[numProj + p] = 1;
+    positions[p] = p;
+    positions[numProj + p] = p;
+  }
 
   // Special case: No need to create heap for 1 or 2 codes.
   if (T <= 2)
@@ -617,10 +948,26 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
 
   // General case: more than 2 perturbation vectors require use of minheap.
   // Sort everything in increasing order.
-  arma::uvec sortidx = arma::sort_index(scores);
-  scores = scores(sortidx);
-  actions = actions(sortidx);
-  positions = positions(sortidx);
+  std::vector<size_t>& sortedIndices = workspace.sortedIndices;
+  sortedIndices.resize(2 * numProj);
+  for (size_t s = 0; s < sortedIndices.size(); ++s)
+    sortedIndices[s] = s;
+  std::stable_sort(sortedIndices.begin(), sortedIndices.end(),
+      [&scores](const size_t a, const size_t b)
+      { return scores[a] < scores[b]; });
+
+  arma::vec& sortedScores = workspace.sortedScores;
+  arma::Col<short int>& sortedActions = workspace.sortedActions;
+  arma::Col<size_t>& sortedPositions = workspace.sortedPositions;
+  sortedScores.set_size(2 * numProj);
+  sortedActions.set_size(2 * numProj);
+  sortedPositions.set_size(2 * numProj);
+  for (size_t s = 0; s < sortedIndices.size(); ++s)
+  {
+    sortedScores[s] = scores[sortedIndices[s]];
+    sortedActions[s] = actions[sortedIndices[s]];
+    sortedPositions[s] = positions[sortedIndices[s]];
+  }
 
   // Theory:
   // A probing sequence is a sequence of T probing bins where a query's
@@ -629,66 +976,71 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
   // need to calculate the T smallest sums of scores that are not conflicting.
   //
   // Method:
-  // Store each perturbation set (pair of (dimension, action)) in a
-  // std::vector. Create a minheap of scores, with each node pointing to its
+  // Store each perturbation set (pair of (dimension, action)) as 2 * numProj
+  // flags. Create a minheap of scores, with each node pointing to its
   // relevant perturbation set. Each perturbation set popped from the minheap
   // is the next most likely perturbation set.
   // Transform perturbation set to perturbation vector by setting the
   // dimensions specified by the set to queryCode+action (action is {-1, 1}).
 
   // Perturbation sets (A) mark with 1 the (score, action, dimension) positions
-  // included in a given perturbation vector. Other spaces are 0.
-  std::vector<bool> Ao(2 * numProj);
-  Ao[0] = 1; // Smallest vector includes only smallest score.
-
-  std::vector< std::vector<bool> > perturbationSets;
-  perturbationSets.push_back(Ao); // Storage of perturbation sets.
-
-  std::priority_queue<
-    std::pair<double, size_t>,        // contents: pairs of (score, index)
-    std::vector<                      // container: vector of pairs
-      std::pair<double, size_t>
-      >,
-    std::greater< std::pair<double, size_t> > // comparator of pairs
-  > minHeap; // our minheap
+  // included in a given perturbation vector. Other spaces are 0.  All sets are
+  // stored one after another in perturbationSets.
+  const size_t setSize = 2 * numProj;
+  std::vector<bool>& perturbationSets = workspace.perturbationSets;
+  perturbationSets.assign(setSize, false);
+  perturbationSets[0] = true; // Smallest vector includes only smallest score.
+
+  // Our minheap of (score, index) pairs.
+  std::vector<std::pair<double, size_t>>& minHeap = workspace.minHeap;
+  std::greater<std::pair<double, size_t>> heapCmp;
+  minHeap.clear();
 
   // Start by adding the lowest scoring set to the minheap.
-  minHeap.push(std::make_pair(PerturbationScore(Ao, scores), 0));
+  std::vector<bool>& Ai = workspace.Ai;
+  std::vector<bool>& As = workspace.As;
+  std::vector<bool>& Ae = workspace.Ae;
+  Ai.assign(perturbationSets.begin(), perturbationSets.end());
+  minHeap.push_back(std::make_pair(PerturbationScore(Ai, sortedScores), 0));
 
   // Loop invariable: after pvec iterations, additionalProbingBins contains pvec
   // valid codes of the lowest-scoring bins (bins most likely to contain
   // neighbors of the query).
   for (size_t pvec = 0; pvec < T; ++pvec)
   {
-    std::vector<bool> Ai;
     do
     {
       // Get the perturbation set corresponding to the minimum score.
-      Ai = perturbationSets[ minHeap.top().second ];
-      minHeap.pop(); // .top() returns, .pop() removes
+      const size_t index = minHeap.front().second;
+      std::pop_heap(minHeap.begin(), minHeap.end(), heapCmp);
+      minHeap.pop_back();
+      Ai.assign(perturbationSets.begin() + index * setSize,
+                perturbationSets.begin() + (index + 1) * setSize);
 
       // Shift operation on Ai (replace max with max+1).
-      std::vector<bool> As = Ai;
+      As = Ai;
 
       // Don't add invalid sets.
       if (PerturbationShift(As) && PerturbationValid(As))
       {
-        perturbationSets.push_back(As); // add shifted set to sets
-        minHeap.push(
-            std::make_pair(PerturbationScore(As, scores),
-            perturbationSets.size() - 1));
+        // Add shifted set to sets.
+        perturbationSets.insert(perturbationSets.end(), As.begin(), As.end());
+        minHeap.push_back(std::make_pair(PerturbationScore(As, sortedScores),
+            perturbationSets.size() / setSize - 1));
+        std::push_heap(minHeap.begin(), minHeap.end(), heapCmp);
       }
 
       // Expand operation on Ai (add max+1 to set).
-      std::vector<bool> Ae = Ai;
+      Ae = Ai;
 
       // Don't add invalid sets.
       if (PerturbationExpand(Ae) && PerturbationValid(Ae))
       {
-        perturbationSets.push_back(Ae); // add expanded set to sets
-        minHeap.push(
-            std::make_pair(PerturbationScore(Ae, scores),
-            perturbationSets.size() - 1));
+        // Add expanded set to sets.
+        perturbationSets.insert(perturbationSets.end(), Ae.begin(), Ae.end());
+        minHeap.push_back(std::make_pair(PerturbationScore(Ae, sortedScores),
+            perturbationSets.size() / setSize - 1));
+        std::push_heap(minHeap.begin(), minHeap.end(), heapCmp);
       }
     } while (!PerturbationValid(Ai)); // Discard invalid perturbations
 
@@ -696,54 +1048,49 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
     for (size_t pos = 0; pos < Ai.size(); ++pos)
     {
       // If Ai[pos] is marked, add action to probing vector.
-      additionalProbingBins(positions(pos), pvec) += Ai[pos] ? actions(pos) : 0;
+      if (Ai[pos])
+        additionalProbingBins(sortedPositions[pos], pvec) += sortedActions[pos];
     }
   }
 }
 
-template<typename SortPolicy, typename MatType>
-template<typename VecType>
-void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
-    const VecType& queryPoint,
-    arma::uvec& referenceIndices,
-    size_t numTablesToSearch,
-    const size_t T) const
+// Compute the second-level bucket of a query code.
+template<typename SortPolicy, typename MatType, typename MetricType>
+inline mlpack_force_inline
+size_t LSHSearch<SortPolicy, MatType, MetricType>::SecondHashBucket(
+    const double* code) const
 {
-  // Decide on the number of tables to look into.
-  if (numTablesToSearch == 0) // If no user input is given, search all.
-    numTablesToSearch = numTables;
-
-  // Sanity check to make sure that the existing number of tables is not
-  // exceeded.
-  if (numTablesToSearch > numTables)
-    numTablesToSearch = numTables;
-
-  // Hash the query in each of the 'numTablesToSearch' hash tables using the
-  // 'numProj' projections for each table. This gives us 'numTablesToSearch'
-  // keys for the query where each key is a 'numProj' dimensional integer
-  // vector.
-
-  // Compute the projection of the query in each table.
-  arma::mat allProjInTables(numProj, numTablesToSearch);
-  arma::mat queryCodesNotFloored(numProj, numTablesToSearch);
-  for (size_t i = 0; i < numTablesToSearch; ++i)
-    queryCodesNotFloored.unsafe_col(i) = projections.slice(i).t() * queryPoint;
+  // The weights and the code are integers, so this sum is exact.
+  double hash = 0.0;
+  for (size_t j = 0; j < numProj; ++j)
+    hash += secondHashWeights[j] * code[j];
+
+  // Floor by typecasting; negative values are clamped to 0.
+  const size_t bucket = (hash < 0.0) ? 0 : (size_t) hash;
+  return bucket % secondHashSize;
+}
 
-  queryCodesNotFloored += offsets.cols(0, numTablesToSearch - 1);
-  allProjInTables = arma::floor(queryCodesNotFloored / hashWidth);
+template<typename SortPolicy, typename MatType, typename MetricType>
+void LSHSearch<SortPolicy, MatType, MetricType>::ReturnIndicesFromTable(
+    QueryWorkspace& workspace,
+    const size_t numTablesToSearch,
+    const size_t T) const
+{
+  // The projections of the query in each table are already computed, so the
+  // query's key in each table (a numProj-dimensional integer vector) is
+  // obtained by flooring.
+  workspace.queryCodes = arma::floor(workspace.queryCodesNotFloored /
+      hashWidth);
 
   // Use hashMat to store the primary probing codes and any additional codes
   // from multiprobe LSH.
-  arma::Mat<size_t> hashMat;
+  arma::Mat<size_t>& hashMat = workspace.hashMat;
   hashMat.set_size(T + 1, numTablesToSearch);
 
   // Compute the primary hash value of each key of the query into a bucket of
-  // the secondHashTable using the secondHashWeights.
-  hashMat.row(0) = ConvTo<arma::Row<size_t>> // Floor by typecasting
-      ::From(secondHashWeights.t() * allProjInTables);
-  // Mod to compute 2nd-level codes.
+  // the second hash table using the secondHashWeights.
   for (size_t i = 0; i < numTablesToSearch; ++i)
-    hashMat(0, i) = (hashMat(0, i) % secondHashSize);
+    hashMat(0, i) = SecondHashBucket(workspace.queryCodes.colptr(i));
 
   // Compute hash codes of additional probing bins.
   if (T > 0)
@@ -751,111 +1098,187 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
     for (size_t i = 0; i < numTablesToSearch; ++i)
     {
       // Construct this table's probing sequence of length T.
-      arma::mat additionalProbingBins;
-      GetAdditionalProbingBins(allProjInTables.unsafe_col(i),
-                                queryCodesNotFloored.unsafe_col(i),
-                                T,
-                                additionalProbingBins);
-
-      // Map each probing bin to a bin in secondHashTable (just like we did for
-      // the primary hash table).
-      hashMat(arma::span(1, T), i) = // Compute code of rows 1:end of column i
-        ConvTo<arma::Col<size_t>>:: // floor by typecasting to size_t
-        From(secondHashWeights.t() * additionalProbingBins);
+      GetAdditionalProbingBins(i, T, workspace);
+
+      // Map each probing bin to a bin in the second hash table (just like we
+      // did for the primary hash table).
       for (size_t p = 1; p < T + 1; ++p)
-        hashMat(p, i) = (hashMat(p, i) % secondHashSize);
+      {
+        hashMat(p, i) = SecondHashBucket(
+            workspace.additionalProbingBins.colptr(p - 1));
+      }
     }
   }
 
   // Count number of points hashed in the same bucket as the query.
   size_t maxNumPoints = 0;
-  for (size_t i = 0; i < numTablesToSearch; ++i)
-  {
-    for (size_t p = 0; p < T + 1; ++p)
-    {
-      const size_t hashInd = hashMat(p, i); // find query's bucket
-      const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
-    }
-  }
+  for (size_t i = 0; i < hashMat.n_elem; ++i)
+    maxNumPoints += bucketSizes[hashMat[i]];
 
   // There are two ways to proceed here:
-  // Either allocate a maxNumPoints-size vector, place all candidates, and run
-  // unique on the vector to discard duplicates.
-  // Or allocate a referenceSet.n_cols size vector (i.e. number of reference
-  // points) of zeros, and mark found indices as 1.
+  // Either place all candidates in a maxNumPoints-size vector, and sort it to
+  // discard duplicates.
+  // Or mark found indices in a referenceSet.n_cols size vector (i.e. number of
+  // reference points), and collect the marked indices.
   // Option 1 runs faster for small maxNumPoints but worse for larger values, so
   // we choose based on a heuristic.
   const float cutoff = 0.1;
   const float selectivity = static_cast<float>(maxNumPoints) /
       static_cast<float>(referenceSet.n_cols);
 
+  std::vector<arma::uword>& candidates = workspace.candidates;
+  candidates.clear();
   if (selectivity > cutoff)
   {
-    // Heuristic: larger maxNumPoints means we should use find() because it
+    // Heuristic: larger maxNumPoints means we should mark points because it
     // should be faster.
-    // Reference points hashed in the same bucket as the query are set to >0.
-    arma::Col<size_t> refPointsConsidered;
-    refPointsConsidered.zeros(referenceSet.n_cols);
+    std::vector<char>& marks = workspace.marks;
+    if (marks.size() != referenceSet.n_cols)
+      marks.assign(referenceSet.n_cols, 0);
 
-    for (size_t i = 0; i < numTablesToSearch; ++i) // for all tables
+    for (size_t i = 0; i < hashMat.n_elem; ++i)
     {
-      for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
-      {
-        // get the sequence code
-        size_t hashInd = hashMat(p, i);
-        size_t tableRow = bucketRowInHashTable[hashInd];
+      // Mark the indices in the bucket corresponding to the sequence code.
+      const size_t hashInd = hashMat[i];
+      const size_t bucketEnd = bucketOffsets[hashInd] + bucketSizes[hashInd];
+      for (size_t j = bucketOffsets[hashInd]; j < bucketEnd; ++j)
+        marks[bucketContents[j]] = 1;
+    }
 
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
-        {
-          // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
-        }
+    // Only keep reference points found in at least one bucket, and clear the
+    // marks for the next query.
+    for (size_t i = 0; i < marks.size(); ++i)
+    {
+      if (marks[i])
+      {
+        candidates.push_back(i);
+        marks[i] = 0;
       }
     }
-
-    // Only keep reference points found in at least one bucket.
-    referenceIndices = arma::find(refPointsConsidered > 0);
-    return;
   }
   else
   {
-    // Heuristic: smaller maxNumPoints means we should use unique() because it
-    // should be faster.
-    // Allocate space for the query's potential neighbors.
-    arma::uvec refPointsConsideredSmall;
-    refPointsConsideredSmall.zeros(maxNumPoints);
+    // Heuristic: smaller maxNumPoints means we should sort the candidates
+    // because it should be faster.
+    for (size_t i = 0; i < hashMat.n_elem; ++i)
+    {
+      // Store all points in the bucket in the candidates set.
+      const size_t hashInd = hashMat[i];
+      const size_t bucketEnd = bucketOffsets[hashInd] + bucketSizes[hashInd];
+      for (size_t j = bucketOffsets[hashInd]; j < bucketEnd; ++j)
+        candidates.push_back(bucketContents[j]);
+    }
+
+    // Keep only one copy of each candidate.
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+        candidates.end());
+  }
+}
+
+// Search for the neighbors of every point in a query set.
+template<typename SortPolicy, typename MatType, typename MetricType>
+void LSHSearch<SortPolicy, MatType, MetricType>::SearchInternal(
+    const MatType& querySet,
+    const bool sameSet,
+    const size_t k,
+    arma::Mat<size_t>& resultingNeighbors,
+    arma::mat& distances,
+    size_t numTablesToSearch,
+    const size_t T)
+{
+  // Decide on the number of tables to look into.
+  if (numTablesToSearch == 0) // If no user input is given, search all.
+    numTablesToSearch = numTables;
 
-    // Retrieve candidates.
-    size_t start = 0;
+  // Sanity check to make sure that the existing number of tables is not
+  // exceeded.
+  if (numTablesToSearch > numTables)
+    numTablesToSearch = numTables;
 
-    for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables
+  // The codes of table i are rows i * numProj through (i + 1) * numProj - 1 of
+  // the projections of the queries.
+  const size_t numCodes = numProj * numTablesToSearch;
+  const arma::vec allOffsets = arma::vectorise(
+      offsets.head_cols(numTablesToSearch));
+
+  // The number of candidates returned for all queries.  Each range of queries
+  // keeps its own count, and the counts are summed at the end of the range.
+  size_t candidatesReturned = 0;
+  std::mutex candidatesMutex;
+
+  // Process the queries in blocks, so that the projections of a block fit in
+  // memory.
+  const size_t blockSize = 1024;
+  for (size_t blockBegin = 0; blockBegin < querySet.n_cols;
+      blockBegin += blockSize)
+  {
+    const size_t blockEnd = std::min((size_t) querySet.n_cols,
+        blockBegin + blockSize);
+
+    // Project every query in the block into every table at once.
+    arma::mat queryCodes;
+    Project(querySet.cols(blockBegin, blockEnd - 1), 0, numTablesToSearch,
+        queryCodes);
+    queryCodes.each_col() += allOffsets;
+
+    // Parallelization to process more than one query at a time.  The work for
+    // each query varies, so the block is split into several ranges per
+    // thread.
+    ParallelForRanges(blockBegin, blockEnd, [&](const size_t begin,
+                                                const size_t end)
     {
-      for (size_t p = 0; p < T + 1; ++p)
+      QueryWorkspace workspace;
+      workspace.queryCodesNotFloored.set_size(numProj, numTablesToSearch);
+      size_t rangeCandidates = 0;
+
+      for (size_t i = begin; i < end; ++i)
       {
-        const size_t hashInd =  hashMat(p, i); // Find the query's bucket.
-        const size_t tableRow = bucketRowInHashTable[hashInd];
+        // Removed points have no neighbors.
+        if (sameSet && removedPoints[i])
+        {
+          resultingNeighbors.col(i).fill(referenceSet.n_cols);
+          distances.col(i).fill(SortPolicy::WorstDistance());
+          continue;
+        }
 
-        if (tableRow < secondHashSize)
+        // Hash the query into every hash table and eventually into the
+        // second hash table to obtain the neighbor candidates.
+        const double* codes = queryCodes.colptr(i - blockBegin);
+        std::copy(codes, codes + numCodes,
+            workspace.queryCodesNotFloored.memptr());
+        ReturnIndicesFromTable(workspace, numTablesToSearch, T);
+        rangeCandidates += workspace.candidates.size();
+
+        // Sequentially go through all the candidates and save the best 'k'
+        // candidates.
+        if (sameSet)
+        {
+          BaseCase(i, workspace.candidates, k, resultingNeighbors, distances);
+        }
+        else
         {
-          // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
-       }
+          BaseCase(i, workspace.candidates, k, querySet, resultingNeighbors,
+              distances);
+        }
       }
-    }
 
-    // Keep only one copy of each candidate.
-    referenceIndices = arma::unique(refPointsConsideredSmall);
-    return;
+      std::lock_guard<std::mutex> lock(candidatesMutex);
+      candidatesReturned += rangeCandidates;
+    }, 4 * NumThreads());
+  }
+
+  distanceEvaluations += candidatesReturned;
+  if (querySet.n_cols > 0)
+  {
+    Log::Info << (candidatesReturned / querySet.n_cols) << " distinct indices "
+        << "returned on average." << std::endl;
   }
 }
 
 // Search for nearest neighbors in a given query set.
-template<typename SortPolicy, typename MatType>
-void LSHSearch<SortPolicy, MatType>::Search(
+template<typename SortPolicy, typename MatType, typename MetricType>
+void LSHSearch<SortPolicy, MatType, MetricType>::Search(
     const MatType& querySet,
     const size_t k,
     arma::Mat<size_t>& resultingNeighbors,
@@ -900,42 +1323,13 @@ void LSHSearch<SortPolicy, MatType>::Search(
     Log::Info << "Running multiprobe LSH with " << Teffective
         <<" additional probing bins per table per query." << std::endl;
 
-  size_t avgIndicesReturned = 0;
-
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (size_t i = 0; i < (size_t) querySet.n_cols; ++i)
-  {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running
-    // #pragma omp atomic
-    avgIndicesReturned = avgIndicesReturned + refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
-  }
-
-  distanceEvaluations += avgIndicesReturned;
-  avgIndicesReturned /= querySet.n_cols;
-  Log::Info << avgIndicesReturned << " distinct indices returned on average." <<
-      std::endl;
+  SearchInternal(querySet, false, k, resultingNeighbors, distances,
+      numTablesToSearch, Teffective);
 }
 
 // Search for approximate neighbors of the reference set.
-template<typename SortPolicy, typename MatType>
-void LSHSearch<SortPolicy, MatType>::
+template<typename SortPolicy, typename MatType, typename MetricType>
+void LSHSearch<SortPolicy, MatType, MetricType>::
 Search(const size_t k,
        arma::Mat<size_t>& resultingNeighbors,
        arma::mat& distances,
@@ -962,41 +1356,12 @@ Search(const size_t k,
     Log::Info << "Running multiprobe LSH with " << Teffective <<
       " additional probing bins per table per query."<< std::endl;
 
-  size_t avgIndicesReturned = 0;
-
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (size_t i = 0; i < (size_t) referenceSet.n_cols; ++i)
-  {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(referenceSet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running.
-    // #pragma omp atomic
-    avgIndicesReturned += refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, resultingNeighbors, distances);
-  }
-
-  distanceEvaluations += avgIndicesReturned;
-  avgIndicesReturned /= referenceSet.n_cols;
-  Log::Info << avgIndicesReturned << " distinct indices returned on average." <<
-      std::endl;
+  SearchInternal(referenceSet, true, k, resultingNeighbors, distances,
+      numTablesToSearch, Teffective);
 }
 
-template<typename SortPolicy, typename MatType>
-double LSHSearch<SortPolicy, MatType>::ComputeRecall(
+template<typename SortPolicy, typename MatType, typename MetricType>
+double LSHSearch<SortPolicy, MatType, MetricType>::ComputeRecall(
     const arma::Mat<size_t>& foundNeighbors,
     const arma::Mat<size_t>& realNeighbors)
 {
@@ -1022,10 +1387,11 @@ double LSHSearch<SortPolicy, MatType>::ComputeRecall(
   return ((double) found) / realNeighbors.n_elem;
 }
 
-template<typename SortPolicy, typename MatType>
+template<typename SortPolicy, typename MatType, typename MetricType>
 template<typename Archive>
-void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
-                                               const uint32_t /* version */)
+void LSHSearch<SortPolicy, MatType, MetricType>::serialize(
+    Archive& ar,
+    const uint32_t version)
 {
   ar(CEREAL_NVP(referenceSet));
   ar(CEREAL_NVP(numProj));
@@ -1041,9 +1407,56 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
   ar(CEREAL_NVP(secondHashSize));
   ar(CEREAL_NVP(secondHashWeights));
   ar(CEREAL_NVP(bucketSize));
-  ar(CEREAL_NVP(secondHashTable));
-  ar(CEREAL_NVP(bucketContentSize));
-  ar(CEREAL_NVP(bucketRowInHashTable));
+
+  // Before version 1, each bucket of the second hash table was stored in its
+  // own vector, so we convert older models to the contiguous layout.  Before
+  // version 2, buckets had no unused space and points could not be removed.
+  if (cereal::is_loading<Archive>() && version == 0)
+  {
+    std::vector<arma::Col<size_t>> secondHashTable;
+    arma::Col<size_t> bucketContentSize;
+    arma::Col<size_t> bucketRowInHashTable;
+    ar(CEREAL_NVP(secondHashTable));
+    ar(CEREAL_NVP(bucketContentSize));
+    ar(CEREAL_NVP(bucketRowInHashTable));
+
+    bucketOffsets.set_size(secondHashSize + 1);
+    bucketOffsets[0] = 0;
+    for (size_t i = 0; i < secondHashSize; ++i)
+    {
+      const size_t row = bucketRowInHashTable[i];
+      bucketOffsets[i + 1] = bucketOffsets[i] +
+          ((row < secondHashSize) ? bucketContentSize[row] : 0);
+    }
+
+    bucketContents.set_size(bucketOffsets[secondHashSize]);
+    for (size_t i = 0; i < secondHashSize; ++i)
+    {
+      const size_t row = bucketRowInHashTable[i];
+      for (size_t j = bucketOffsets[i]; j < bucketOffsets[i + 1]; ++j)
+      {
+        bucketContents[j] =
+            (arma::u32) secondHashTable[row][j - bucketOffsets[i]];
+      }
+    }
+  }
+  else
+  {
+    ar(CEREAL_NVP(bucketContents));
+    ar(CEREAL_NVP(bucketOffsets));
+  }
+
+  if (cereal::is_loading<Archive>() && version < 2)
+  {
+    bucketSizes = arma::diff(bucketOffsets);
+    removedPoints.zeros(referenceSet.n_cols);
+  }
+  else
+  {
+    ar(CEREAL_NVP(bucketSizes));
+    ar(CEREAL_NVP(removedPoints));
+  }
+
   ar(CEREAL_NVP(distanceEvaluations));
 }
 
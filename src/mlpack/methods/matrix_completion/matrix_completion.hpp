@@ -46,7 +46,10 @@ namespace mlpack {
  * mc.Recover(recovered);
  * @endcode
  *
- * @see LRSDP
+ * For large problems, SoftImpute solves a regularized version of the problem
+ * without forming the SDP.
+ *
+ * @see LRSDP, SoftImpute
  */
 class MatrixCompletion
 {
@@ -0,0 +1,213 @@
+/**
+ * @file methods/matrix_completion/soft_impute.hpp
+ *
+ * Soft-impute solver for large matrix completion problems, which only stores
+ * the known entries and a low-rank factorization of the solution.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_MATRIX_COMPLETION_SOFT_IMPUTE_HPP
+#define MLPACK_METHODS_MATRIX_COMPLETION_SOFT_IMPUTE_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+
+/**
+ * SoftImpute solves the nuclear norm regularized matrix completion problem
+ *
+ *   min 1/2 sum_{(i, j) known} (X_ij - M_ij)^2 + lambda ||X||_*
+ *
+ * by singular value thresholding: at each iteration, the known entries of the
+ * current solution X are replaced by M_ij, and X is replaced by the SVD of the
+ * result with its singular values shrunk by lambda.  The matrix of each
+ * iteration is the sum of a sparse matrix (the residuals of the known entries)
+ * and of the low-rank X, so its SVD is computed with a randomized range finder
+ * that only multiplies it with thin matrices; neither the SDP of
+ * MatrixCompletion nor any dense m x n matrix is ever formed, and the memory
+ * used is O(p + (m + n) r) for p known entries and maximum rank r.
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @article{mazumder2010spectral,
+ *   title = {Spectral Regularization Algorithms for Learning Large Incomplete
+ *       Matrices},
+ *   author = {Mazumder, Rahul and Hastie, Trevor and Tibshirani, Robert},
+ *   journal = {Journal of Machine Learning Research},
+ *   volume = {11},
+ *   pages = {2287--2322},
+ *   year = {2010}
+ * }
+ * @endcode
+ *
+ * An example of how to use this class is shown below:
+ *
+ * @code
+ * size_t m, n;         // size of unknown matrix
+ * arma::umat indices;  // contains the known indices [2 x n_entries]
+ * arma::vec values;    // contains the known values [n_entries]
+ *
+ * // The completed matrix is u * diagmat(s) * v.t().
+ * arma::mat u, v;
+ * arma::vec s;
+ * SoftImpute si(0.01, 20);
+ * si.Apply(m, n, indices, values, u, s, v);
+ * @endcode
+ *
+ * @see MatrixCompletion
+ */
+class SoftImpute
+{
+ public:
+  /**
+   * Create the solver.
+   *
+   * @param lambda Regularization parameter, relative to the largest singular
+   *     value of the matrix of known entries (so it is usually much smaller
+   *     than 1).
+   * @param maxRank Maximum rank of the solution.
+   * @param maxIterations Maximum number of iterations.
+   * @param tolerance The iterations stop when the squared Frobenius norm of
+   *     the change of the solution, relative to the squared norm of the
+   *     solution, is below this tolerance.
+   * @param powerIterations Number of power iterations of the randomized SVD of
+   *     each iteration.
+   */
+  SoftImpute(const double lambda = 0.01,
+             const size_t maxRank = 20,
+             const size_t maxIterations = 100,
+             const double tolerance = 1e-5,
+             const size_t powerIterations = 1);
+
+  /**
+   * Complete the m x n matrix with the given known entries, and store the
+   * solution as u * diagmat(s) * v.t().  The rank of the solution (the length
+   * of s) is at most maxRank; it is smaller if lambda shrinks some singular
+   * values to zero.
+   *
+   * @param m Number of rows of original matrix.
+   * @param n Number of columns of original matrix.
+   * @param indices Matrix containing the indices of the known entries (must be
+   *    [2 x p]).
+   * @param values Vector containing the values of the known entries (must be
+   *    length p).
+   * @param u Will contain the left singular vectors of the solution.
+   * @param s Will contain the singular values of the solution.
+   * @param v Will contain the right singular vectors of the solution.
+   * @return The number of iterations that were run.
+   */
+  size_t Apply(const size_t m,
+               const size_t n,
+               const arma::umat& indices,
+               const arma::vec& values,
+               arma::mat& u,
+               arma::vec& s,
+               arma::mat& v);
+
+  /**
+   * Complete the m x n matrix with the given known entries, and store the
+   * full completed matrix.  This needs O(mn) memory; use the overload that
+   * gives the factorization of the solution for large matrices.
+   *
+   * @param m Number of rows of original matrix.
+   * @param n Number of columns of original matrix.
+   * @param indices Matrix containing the indices of the known entries (must be
+   *    [2 x p]).
+   * @param values Vector containing the values of the known entries (must be
+   *    length p).
+   * @param recovered Will contain the completed matrix.
+   * @return The number of iterations that were run.
+   */
+  size_t Apply(const size_t m,
+               const size_t n,
+               const arma::umat& indices,
+               const arma::vec& values,
+               arma::mat& recovered);
+
+  //! Get the relative regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the relative regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get the maximum rank of the solution.
+  size_t MaxRank() const { return maxRank; }
+  //! Modify the maximum rank of the solution.
+  size_t& MaxRank() { return maxRank; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance of the stopping criterion.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance of the stopping criterion.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the number of power iterations of each randomized SVD.
+  size_t PowerIterations() const { return powerIterations; }
+  //! Modify the number of power iterations of each randomized SVD.
+  size_t& PowerIterations() { return powerIterations; }
+
+ private:
+  /**
+   * The known entries, stored by columns (like a CSC sparse matrix) and by
+   * rows (like a CSR sparse matrix); the residuals of the known entries are
+   * stored in the order of the columns.
+   */
+  struct SparseEntries
+  {
+    //! Index of the first entry of each column.
+    std::vector<size_t> colBegins;
+    //! Row of each entry, in column order.
+    std::vector<size_t> rows;
+    //! Known value of each entry, in column order.
+    arma::vec values;
+    //! Index of the first entry of each row.
+    std::vector<size_t> rowBegins;
+    //! Column of each entry, in row order.
+    std::vector<size_t> cols;
+    //! Position in column order of each entry, in row order.
+    std::vector<size_t> positions;
+  };
+
+  /**
+   * Compute (R^T X)^T = X^T R, where R is the sparse matrix of residuals, given
+   * xt = X^T (k x m); the result is k x n.
+   */
+  static void SparseTransposeTimes(const SparseEntries& entries,
+                                   const arma::vec& residuals,
+                                   const arma::mat& xt,
+                                   arma::mat& result);
+
+  /**
+   * Compute (R X)^T = X^T R^T, where R is the sparse matrix of residuals, given
+   * xt = X^T (k x n); the result is k x m.
+   */
+  static void SparseTimes(const SparseEntries& entries,
+                          const arma::vec& residuals,
+                          const arma::mat& xt,
+                          arma::mat& result);
+
+  //! Relative regularization parameter.
+  double lambda;
+  //! Maximum rank of the solution.
+  size_t maxRank;
+  //! Maximum number of iterations.
+  size_t maxIterations;
+  //! Tolerance of the stopping criterion.
+  double tolerance;
+  //! Number of power iterations of each randomized SVD.
+  size_t powerIterations;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "soft_impute_impl.hpp"
+
+#endif
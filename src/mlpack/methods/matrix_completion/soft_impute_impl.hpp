@@ -0,0 +1,266 @@
+/**
+ * @file methods/matrix_completion/soft_impute_impl.hpp
+ *
+ * Implementation of the SoftImpute matrix completion solver.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_MATRIX_COMPLETION_SOFT_IMPUTE_IMPL_HPP
+#define MLPACK_METHODS_MATRIX_COMPLETION_SOFT_IMPUTE_IMPL_HPP
+
+#include "soft_impute.hpp"
+#include <mlpack/core/util/size_checks.hpp>
+
+namespace mlpack {
+
+inline SoftImpute::SoftImpute(const double lambda,
+                              const size_t maxRank,
+                              const size_t maxIterations,
+                              const double tolerance,
+                              const size_t powerIterations) :
+    lambda(lambda),
+    maxRank(maxRank),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    powerIterations(powerIterations)
+{
+  // Nothing to do.
+}
+
+inline size_t SoftImpute::Apply(const size_t m,
+                                const size_t n,
+                                const arma::umat& indices,
+                                const arma::vec& values,
+                                arma::mat& u,
+                                arma::vec& s,
+                                arma::mat& v)
+{
+  if (indices.n_rows != 2)
+  {
+    throw std::invalid_argument("SoftImpute::Apply(): matrix of constraint "
+        "indices does not have 2 rows!");
+  }
+
+  util::CheckSameSizes(indices, values, "SoftImpute::Apply()", "values",
+      false, true);
+
+  for (size_t i = 0; i < indices.n_cols; ++i)
+  {
+    if (indices(0, i) >= m || indices(1, i) >= n)
+    {
+      std::ostringstream oss;
+      oss << "SoftImpute::Apply(): indices (" << indices(0, i) << ", "
+          << indices(1, i) << ") are out of bounds for matrix of size " << m
+          << " x " << n << "!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  // Sort the known entries by column, and then by row, with counting sorts.
+  const size_t p = indices.n_cols;
+  SparseEntries entries;
+  entries.colBegins.assign(n + 1, 0);
+  for (size_t i = 0; i < p; ++i)
+    ++entries.colBegins[indices(1, i) + 1];
+  for (size_t j = 0; j < n; ++j)
+    entries.colBegins[j + 1] += entries.colBegins[j];
+
+  entries.rows.resize(p);
+  entries.values.set_size(p);
+  std::vector<size_t> next(entries.colBegins.begin(),
+      entries.colBegins.end() - 1);
+  for (size_t i = 0; i < p; ++i)
+  {
+    const size_t pos = next[indices(1, i)]++;
+    entries.rows[pos] = indices(0, i);
+    entries.values[pos] = values[i];
+  }
+
+  entries.rowBegins.assign(m + 1, 0);
+  for (size_t pos = 0; pos < p; ++pos)
+    ++entries.rowBegins[entries.rows[pos] + 1];
+  for (size_t i = 0; i < m; ++i)
+    entries.rowBegins[i + 1] += entries.rowBegins[i];
+
+  entries.cols.resize(p);
+  entries.positions.resize(p);
+  next.assign(entries.rowBegins.begin(), entries.rowBegins.end() - 1);
+  for (size_t j = 0; j < n; ++j)
+  {
+    for (size_t pos = entries.colBegins[j]; pos < entries.colBegins[j + 1];
+         ++pos)
+    {
+      const size_t t = next[entries.rows[pos]]++;
+      entries.cols[t] = j;
+      entries.positions[t] = pos;
+    }
+  }
+
+  // The randomized SVD finds a few more singular vectors than needed, so that
+  // the ones that are kept are accurate.
+  const size_t rank = std::min(maxRank, std::min(m, n));
+  const size_t sketchSize = std::min(rank + 10, std::min(m, n));
+
+  u.set_size(m, 0);
+  s.set_size(0);
+  v.set_size(n, 0);
+  if (rank == 0)
+    return 0;
+
+  // The matrix of each iteration is A = R + u * diagmat(s) * v.t(), where R
+  // holds the residuals of the known entries; these compute A * X and A^T * Y.
+  arma::vec residuals(p);
+  arma::mat sparseProduct;
+  auto times = [&](const arma::mat& x)
+  {
+    SparseTimes(entries, residuals, arma::mat(x.t()), sparseProduct);
+    return arma::mat(sparseProduct.t() + u * arma::diagmat(s) * (v.t() * x));
+  };
+  auto transposeTimes = [&](const arma::mat& y)
+  {
+    SparseTransposeTimes(entries, residuals, arma::mat(y.t()), sparseProduct);
+    return arma::mat(sparseProduct.t() + v * arma::diagmat(s) * (u.t() * y));
+  };
+
+  double threshold = 0.0;
+  for (size_t iteration = 0; iteration < maxIterations; ++iteration)
+  {
+    // Compute the residuals M_ij - X_ij of the known entries.
+    const arma::mat us = (u * arma::diagmat(s)).t();
+    const arma::mat vt = v.t();
+    #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+    for (size_t j = 0; j < n; ++j)
+    {
+      for (size_t pos = entries.colBegins[j]; pos < entries.colBegins[j + 1];
+           ++pos)
+      {
+        residuals[pos] = entries.values[pos] -
+            arma::dot(us.col(entries.rows[pos]), vt.col(j));
+      }
+    }
+
+    // Find an orthonormal basis q of the range of A with a randomized range
+    // finder, starting from the right singular vectors of the last iteration.
+    arma::mat omega(n, sketchSize);
+    if (v.n_cols > 0)
+      omega.cols(0, v.n_cols - 1) = v;
+    if (v.n_cols < sketchSize)
+      omega.cols(v.n_cols, sketchSize - 1).randn();
+
+    arma::mat q, r, z;
+    arma::qr_econ(q, r, times(omega));
+    for (size_t i = 0; i < powerIterations; ++i)
+    {
+      arma::qr_econ(z, r, transposeTimes(q));
+      arma::qr_econ(q, r, times(z));
+    }
+
+    // Now A ~= q * q.t() * A, and the SVD of the small matrix A.t() * q gives
+    // the SVD of A.
+    arma::mat w, x;
+    arma::vec sigma;
+    arma::svd_econ(w, sigma, x, transposeTimes(q));
+
+    // In the first iteration, A holds only the known entries.
+    if (iteration == 0)
+      threshold = lambda * (sigma.n_elem > 0 ? sigma[0] : 0.0);
+
+    // Shrink the singular values.
+    size_t newRank = 0;
+    while (newRank < std::min(rank, (size_t) sigma.n_elem) &&
+           sigma[newRank] > threshold)
+      ++newRank;
+
+    arma::mat newU(m, 0), newV(n, 0);
+    arma::vec newS;
+    if (newRank > 0)
+    {
+      newU = q * x.cols(0, newRank - 1);
+      newS = sigma.head(newRank) - threshold;
+      newV = w.cols(0, newRank - 1);
+    }
+
+    // The squared norm of the change is computed from the factorizations:
+    // ||X' - X||^2 = ||X'||^2 + ||X||^2 - 2 <X', X>.
+    const double oldNorm = arma::accu(arma::square(s));
+    const double newNorm = arma::accu(arma::square(newS));
+    const double cross = (newRank > 0 && s.n_elem > 0) ?
+        arma::accu((newU.t() * u) % (newV.t() * v) % (newS * s.t())) : 0.0;
+    const double change = std::max(newNorm + oldNorm - 2 * cross, 0.0);
+
+    u = std::move(newU);
+    s = std::move(newS);
+    v = std::move(newV);
+
+    if (newNorm == 0.0 || (oldNorm > 0.0 && change / oldNorm < tolerance))
+    {
+      Log::Info << "SoftImpute::Apply(): converged after " << (iteration + 1)
+          << " iterations with rank " << s.n_elem << "." << std::endl;
+      return iteration + 1;
+    }
+  }
+
+  Log::Info << "SoftImpute::Apply(): reached the maximum number of iterations ("
+      << maxIterations << ") with rank " << s.n_elem << "." << std::endl;
+  return maxIterations;
+}
+
+inline size_t SoftImpute::Apply(const size_t m,
+                                const size_t n,
+                                const arma::umat& indices,
+                                const arma::vec& values,
+                                arma::mat& recovered)
+{
+  arma::mat u, v;
+  arma::vec s;
+  const size_t iterations = Apply(m, n, indices, values, u, s, v);
+  recovered = u * arma::diagmat(s) * v.t();
+  return iterations;
+}
+
+inline void SoftImpute::SparseTransposeTimes(const SparseEntries& entries,
+                                             const arma::vec& residuals,
+                                             const arma::mat& xt,
+                                             arma::mat& result)
+{
+  const size_t n = entries.colBegins.size() - 1;
+  result.zeros(xt.n_rows, n);
+
+  // Each column of the result only depends on one column of R.
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t j = 0; j < n; ++j)
+  {
+    for (size_t pos = entries.colBegins[j]; pos < entries.colBegins[j + 1];
+         ++pos)
+    {
+      result.col(j) += residuals[pos] * xt.col(entries.rows[pos]);
+    }
+  }
+}
+
+inline void SoftImpute::SparseTimes(const SparseEntries& entries,
+                                    const arma::vec& residuals,
+                                    const arma::mat& xt,
+                                    arma::mat& result)
+{
+  const size_t m = entries.rowBegins.size() - 1;
+  result.zeros(xt.n_rows, m);
+
+  // Each column of the result only depends on one row of R.
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t i = 0; i < m; ++i)
+  {
+    for (size_t t = entries.rowBegins[i]; t < entries.rowBegins[i + 1]; ++t)
+    {
+      result.col(i) += residuals[entries.positions[t]] *
+          xt.col(entries.cols[t]);
+    }
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -122,34 +122,22 @@ class MeanShift
                 MatType& seeds);
 
   /**
-   * Use kernel to calculate new centroid given dataset and valid neighbors.
+   * Get the weight of a neighbor at the given distance from a centroid, given
+   * by the kernel.  The new centroid is the weighted mean of the neighbors.
    *
-   * @param data The whole dataset
-   * @param neighbors Valid neighbors
-   * @param distances Distances to neighbors
-   # @param centroid Store calculated centroid
+   * @param distance Distance between the neighbor and the centroid.
    */
   template<bool ApplyKernel = UseKernel>
-  typename std::enable_if<ApplyKernel, bool>::type
-  CalculateCentroid(const MatType& data,
-                    const std::vector<size_t>& neighbors,
-                    const std::vector<double>& distances,
-                    arma::colvec& centroid);
+  typename std::enable_if<ApplyKernel, double>::type
+  NeighborWeight(const double distance);
 
   /**
-   * Use mean to calculate new centroid given dataset and valid neighbors.
-   *
-   * @param data The whole dataset
-   * @param neighbors Valid neighbors
-   * @param distances Distances to neighbors
-   # @param centroid Store calculated centroid
+   * Get the weight of a neighbor of a centroid, when the new centroid is the
+   * mean of the neighbors: this is always 1.
    */
   template<bool ApplyKernel = UseKernel>
-  typename std::enable_if<!ApplyKernel, bool>::type
-  CalculateCentroid(const MatType& data,
-                    const std::vector<size_t>& neighbors,
-                    const std::vector<double>&, /*unused*/
-                    arma::colvec& centroid);
+  typename std::enable_if<!ApplyKernel, double>::type
+  NeighborWeight(const double /* distance */) { return 1.0; }
 
   /**
    * If distance of two centroids is less than radius, one will be removed.
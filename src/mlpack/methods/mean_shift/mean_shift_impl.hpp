@@ -18,7 +18,8 @@
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
 
-#include "map"
+#include <map>
+#include <set>
 
 // In case it hasn't been included yet.
 #include "mean_shift.hpp"
@@ -128,51 +129,19 @@ void MeanShift<UseKernel, KernelType, MatType>::GenSeeds(
   seeds *= binSize;
 }
 
-// Calculate new centroid with given kernel.
+// Get the weight of a neighbor with the given kernel.
 template<bool UseKernel, typename KernelType, typename MatType>
 template<bool ApplyKernel>
-typename std::enable_if<ApplyKernel, bool>::type
-MeanShift<UseKernel, KernelType, MatType>::
-CalculateCentroid(const MatType& data,
-                  const std::vector<size_t>& neighbors,
-                  const std::vector<double>& distances,
-                  arma::colvec& centroid)
+typename std::enable_if<ApplyKernel, double>::type
+MeanShift<UseKernel, KernelType, MatType>::NeighborWeight(
+    const double distance)
 {
-  double sumWeight = 0;
-  for (size_t i = 0; i < neighbors.size(); ++i)
-  {
-    if (distances[i] > 0)
-    {
-      double dist = distances[i] / radius;
-      double weight = kernel.Gradient(dist) / dist;
-      sumWeight += weight;
-      centroid += weight * data.unsafe_col(neighbors[i]);
-    }
-  }
+  // The gradient is not defined at the centroid itself.
+  if (distance <= 0)
+    return 0.0;
 
-  if (sumWeight != 0)
-  {
-    centroid /= sumWeight;
-    return true;
-  }
-  return false;
-}
-
-// Calculate new centroid by mean.
-template<bool UseKernel, typename KernelType, typename MatType>
-template<bool ApplyKernel>
-typename std::enable_if<!ApplyKernel, bool>::type
-MeanShift<UseKernel, KernelType, MatType>::
-CalculateCentroid(const MatType& data,
-                  const std::vector<size_t>& neighbors,
-                  const std::vector<double>&, /*unused*/
-                  arma::colvec& centroid)
-{
-  for (size_t i = 0; i < neighbors.size(); ++i)
-    centroid += data.unsafe_col(neighbors[i]);
-
-  centroid /= neighbors.size();
-  return true;
+  const double dist = distance / radius;
+  return kernel.Gradient(dist) / dist;
 }
 
 /**
@@ -202,38 +171,63 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
   }
 
   // Holds all centroids before removing duplicate ones.
-  arma::mat allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  arma::mat allCentroids(*pSeeds);
 
   assignments.set_size(data.n_cols);
 
+  // The tree of the range search is built once.  At each iteration, all the
+  // centroids that have not converged yet are shifted together, with one
+  // parallel range search; only the weighted sum of the neighbors of each
+  // centroid is kept.
   RangeSearch<> rangeSearcher(data);
   Range validRadius(0, radius);
-  std::vector<std::vector<size_t> > neighbors;
-  std::vector<std::vector<double> > distances;
+  const double tolerance = 1e-3 * radius;
+
+  std::vector<size_t> active(pSeeds->n_cols);
+  for (size_t i = 0; i < active.size(); ++i)
+    active[i] = i;
 
-  // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  for (size_t completedIterations = 0; !active.empty() &&
+      (completedIterations < maxIterations || forceConvergence);
+      completedIterations++)
   {
-    // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
-    for (size_t completedIterations = 0; completedIterations < maxIterations
-        || forceConvergence; completedIterations++)
-    {
-      // Store new centroid in this.
-      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
+    const arma::mat activeCentroids =
+        allCentroids.cols(arma::conv_to<arma::uvec>::from(active));
+    arma::mat sums(activeCentroids.n_rows, activeCentroids.n_cols,
+        arma::fill::zeros);
+    arma::vec weights(activeCentroids.n_cols, arma::fill::zeros);
+    arma::Col<size_t> counts(activeCentroids.n_cols, arma::fill::zeros);
+
+    // All the neighbors of a centroid are passed from the same thread, so
+    // each thread only writes the sums of its own centroids.
+    rangeSearcher.ParallelSearch(activeCentroids, validRadius,
+        [&](const size_t j, const size_t neighbor, const double distance)
+        {
+          ++counts[j];
+          const double weight = NeighborWeight(distance);
+          if (weight != 0.0)
+          {
+            sums.col(j) += weight * data.col(neighbor);
+            weights[j] += weight;
+          }
+        });
 
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
-      if (neighbors[0].size() == 0) // There are no points in the cluster.
-        break;
+    std::vector<size_t> shifted;
+    for (size_t j = 0; j < active.size(); ++j)
+    {
+      const size_t i = active[j];
+      if (counts[j] == 0) // There are no points in the cluster.
+        continue;
 
-      // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
-        newCentroid = allCentroids.unsafe_col(i);
+      // Calculate the new centroid; it stays in place if the weights of its
+      // neighbors sum to zero.
+      arma::colvec newCentroid = allCentroids.col(i);
+      if (weights[j] != 0.0)
+        newCentroid = sums.col(j) / weights[j];
 
       // If the mean shift vector is small enough, it has converged.
       if (EuclideanDistance::Evaluate(newCentroid,
-          allCentroids.unsafe_col(i)) < 1e-3 * radius)
+          allCentroids.unsafe_col(i)) < tolerance)
       {
         // Determine if the new centroid is duplicate with old ones.
         bool isDuplicated = false;
@@ -251,12 +245,37 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
         if (!isDuplicated)
           centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
 
-        // Get out of the loop.
-        break;
+        continue;
       }
 
       // Update the centroid.
       allCentroids.col(i) = newCentroid;
+      shifted.push_back(i);
+    }
+
+    // A centroid that has come within the tolerance of a mode that has already
+    // converged, or of another centroid, would follow the same path from now
+    // on, so it is dropped.  Nearby centroids are found by binning them into
+    // cells as wide as the tolerance.
+    active.clear();
+    std::set<arma::colvec, less<arma::colvec>> cells;
+    for (size_t j = 0; j < shifted.size(); ++j)
+    {
+      const size_t i = shifted[j];
+      bool isDuplicated = false;
+      for (size_t k = 0; k < centroids.n_cols; ++k)
+      {
+        if (EuclideanDistance::Evaluate(allCentroids.unsafe_col(i),
+            centroids.unsafe_col(k)) < tolerance)
+        {
+          isDuplicated = true;
+          break;
+        }
+      }
+
+      if (!isDuplicated && cells.insert(arma::colvec(
+          arma::floor(allCentroids.unsafe_col(i) / tolerance))).second)
+        active.push_back(i);
     }
   }
 
@@ -274,10 +274,16 @@ class NaiveBayesClassifier
   //! Small value to prevent log of zero.
   double epsilon;
 
+  //! Maximum number of chunks that incremental training is split into.
+  static constexpr size_t MaxTrainChunks = 64;
+  //! Minimum number of points in each chunk of incremental training.
+  static constexpr size_t MinTrainChunkSize = 256;
+
   /**
    * Compute the unnormalized posterior log probability of given points (log
    * likelihood). Results are returned as arma::mat, and each column represents
-   * a point, each row represents log likelihood of a class.
+   * a point, each row represents log likelihood of a class.  The log
+   * likelihoods of all classes are computed together with matrix products.
    *
    * @param data Set of points to compute posterior log probability for.
    * @param logLikelihoods Matrix to store log likelihoods in.
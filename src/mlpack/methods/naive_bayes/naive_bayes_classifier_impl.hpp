@@ -18,6 +18,7 @@
 #define MLPACK_METHODS_NAIVE_BAYES_NAIVE_BAYES_CLASSIFIER_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
 
 // In case it hasn't been included already.
 #include "naive_bayes_classifier.hpp"
@@ -94,24 +95,69 @@ void NaiveBayesClassifier<ModelMatType>::Train(
     if (probabilities.n_elem != numClasses || data.n_rows != means.n_rows)
       Reset(data.n_rows, numClasses);
 
-    // Use incremental algorithm.
-    // Fist, de-normalize probabilities.
-    probabilities *= trainingPoints;
+    // Use incremental algorithm.  The statistics of the new points are
+    // computed in chunks in parallel, and then merged with the current model.
+    size_t numChunks = (data.n_cols + MinTrainChunkSize - 1) /
+        MinTrainChunkSize;
+    if (numChunks > MaxTrainChunks)
+      numChunks = MaxTrainChunks;
+    const size_t chunkSize = (numChunks == 0) ? 0 :
+        (data.n_cols + numChunks - 1) / numChunks;
 
-    for (size_t j = 0; j < data.n_cols; ++j)
+    std::vector<arma::Col<ElemType>> chunkCounts(numChunks);
+    std::vector<ModelMatType> chunkMeans(numChunks), chunkM2s(numChunks);
+
+    #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+    for (size_t c = 0; c < numChunks; ++c)
     {
-      const size_t label = labels[j];
-      ++probabilities[label];
+      chunkCounts[c].zeros(numClasses);
+      chunkMeans[c].zeros(data.n_rows, numClasses);
+      chunkM2s[c].zeros(data.n_rows, numClasses);
+
+      const size_t end = std::min((c + 1) * chunkSize, (size_t) data.n_cols);
+      for (size_t j = c * chunkSize; j < end; ++j)
+      {
+        const size_t label = labels[j];
+        ++chunkCounts[c][label];
+
+        arma::Col<ElemType> delta = data.col(j) - chunkMeans[c].col(label);
+        chunkMeans[c].col(label) += delta / chunkCounts[c][label];
+        chunkM2s[c].col(label) += delta %
+            (data.col(j) - chunkMeans[c].col(label));
+      }
+    }
+
+    // Recover the counts and the sums of squared differences of the current
+    // model, and merge the statistics of each chunk into them.
+    arma::Col<ElemType> counts = arma::round(probabilities *
+        (ElemType) trainingPoints);
+    ModelMatType m2s = variances;
+    m2s -= epsilon;
+    for (size_t i = 0; i < numClasses; ++i)
+      m2s.col(i) *= (counts[i] > 1) ? (counts[i] - 1) : 0;
 
-      arma::Col<ElemType> delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      for (size_t i = 0; i < numClasses; ++i)
+      {
+        if (chunkCounts[c][i] == 0)
+          continue;
+
+        const ElemType total = counts[i] + chunkCounts[c][i];
+        const arma::Col<ElemType> delta = chunkMeans[c].col(i) - means.col(i);
+        means.col(i) += delta * (chunkCounts[c][i] / total);
+        m2s.col(i) += chunkM2s[c].col(i) +
+            square(delta) * (counts[i] * chunkCounts[c][i] / total);
+        counts[i] = total;
+      }
     }
 
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
+    probabilities = counts;
+    variances = m2s;
+    for (size_t i = 0; i < numClasses; ++i)
     {
-      if (probabilities[i] > 2)
-        variances.col(i) /= (probabilities[i] - 1);
+      if (counts[i] > 1)
+        variances.col(i) /= (counts[i] - 1);
     }
   }
   else
@@ -156,7 +202,11 @@ void NaiveBayesClassifier<ModelMatType>::Train(
   // Add epsilon to prevent log of zero.
   variances += epsilon;
 
-  probabilities /= data.n_cols;
+  // The incremental algorithm holds the counts of all the points seen so far.
+  const size_t totalPoints = incremental ? trainingPoints + data.n_cols :
+      data.n_cols;
+  if (totalPoints > 0)
+    probabilities /= totalPoints;
   trainingPoints += data.n_cols;
 }
 
@@ -217,24 +267,38 @@ void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
       "NaiveBayesClassifier: element type of given data must match the element "
       "type of the model!");
 
-  logLikelihoods = log(repmat(probabilities, 1, data.n_cols));
-  ModelMatType invVar = 1.0 / variances;
-
-  // Calculate the joint log likelihood of point for each of the
-  // means.n_cols.
-
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; ++i)
+  // For each class, the log likelihood of x is
+  //   log(p) - d/2 log(2 pi) - 1/2 sum(log(var)) - 1/2 sum((x - mu)^2 / var),
+  // and expanding the square gives the log likelihoods of all classes for all
+  // points with two matrix products.  Dense data is first centered on the mean
+  // of the class means, so that the expansion does not lose precision for
+  // features with tiny variances; sparse data is used as is, because centering
+  // would make it dense.
+  arma::Col<ElemType> reference(data.n_rows, arma::fill::zeros);
+  if (!arma::is_SpMat<MatType>::value && means.n_cols > 0)
+    reference = arma::mean(means, 1);
+
+  const ModelMatType shiftedMeans = means - repmat(reference, 1, means.n_cols);
+  const ModelMatType invVar = 1.0 / variances;
+  const ModelMatType scaledMeans = shiftedMeans % invVar;
+  const arma::Col<ElemType> constants = arma::vectorise(log(probabilities) -
+      data.n_rows / 2.0 * std::log(2 * M_PI) -
+      0.5 * sum(log(variances), 0).t() -
+      0.5 * sum(shiftedMeans % scaledMeans, 0).t());
+
+  if (arma::is_SpMat<MatType>::value)
+  {
+    logLikelihoods = scaledMeans.t() * data -
+        0.5 * (invVar.t() * square(data));
+  }
+  else
   {
-    // This is an adaptation of phi() for the case where the covariance is a
-    // diagonal matrix.
-    ModelMatType diffs = data - repmat(means.col(i), 1, data.n_cols);
-    ModelMatType rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::Mat<ElemType> exponents = sum(diffs % rhs, 0);
-
-    logLikelihoods.row(i) += (data.n_rows / -2.0 * std::log(2 * M_PI) - 0.5 *
-        accu(log(variances.col(i))) + exponents);
+    const arma::Mat<ElemType> centered = data - repmat(reference, 1,
+        data.n_cols);
+    logLikelihoods = scaledMeans.t() * centered -
+        0.5 * (invVar.t() * square(centered));
   }
+  logLikelihoods.each_col() += constants;
 }
 
 template<typename ModelMatType>
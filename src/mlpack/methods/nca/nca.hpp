@@ -54,10 +54,17 @@ class NCA
    * @param dataset Input dataset.
    * @param labels Input dataset labels.
    * @param metric Instantiated metric to use.
+   * @param numNeighbors Number of nearest neighbors of each point the softmax
+   *     is truncated to; 0 considers all the points (see
+   *     SoftmaxErrorFunction).
+   * @param refreshInterval Number of passes over the dataset after which the
+   *     nearest neighbors are searched again, if numNeighbors is nonzero.
    */
   NCA(const arma::mat& dataset,
       const arma::Row<size_t>& labels,
-      MetricType metric = MetricType());
+      MetricType metric = MetricType(),
+      const size_t numNeighbors = 0,
+      const size_t refreshInterval = 10);
 
   /**
    * Perform Neighborhood Components Analysis.  The output distance learning
@@ -21,11 +21,13 @@ namespace mlpack {
 template<typename MetricType, typename OptimizerType>
 NCA<MetricType, OptimizerType>::NCA(const arma::mat& dataset,
                                     const arma::Row<size_t>& labels,
-                                    MetricType metric) :
+                                    MetricType metric,
+                                    const size_t numNeighbors,
+                                    const size_t refreshInterval) :
     dataset(dataset),
     labels(labels),
     metric(metric),
-    errorFunction(dataset, labels, metric)
+    errorFunction(dataset, labels, metric, numNeighbors, refreshInterval)
 { /* Nothing to do. */ }
 
 template<typename MetricType, typename OptimizerType>
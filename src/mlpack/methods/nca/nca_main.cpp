@@ -132,6 +132,11 @@ PARAM_DOUBLE_IN("min_step", "Minimum step of line search for L-BFGS.", "m",
 PARAM_DOUBLE_IN("max_step", "Maximum step of line search for L-BFGS.", "M",
     1e20);
 
+PARAM_INT_IN("num_neighbors", "If nonzero, the stochastic neighbor assignment "
+    "of each point only considers its k nearest neighbors in the projected "
+    "space (which is faster on large datasets); 0 considers all points.", "k",
+    0);
+
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
@@ -151,6 +156,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   const string optimizerType = params.Get<string>("optimizer");
   RequireParamInSet<string>(params, "optimizer", { "sgd", "lbfgs" },
       true, "unknown optimizer type");
+  RequireParamValue<int>(params, "num_neighbors", [](int x) { return x >= 0; },
+      true, "number of neighbors must be non-negative");
 
   // Warn on unused parameters.
   if (optimizerType == "sgd")
@@ -188,6 +195,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   const double minStep = params.Get<double>("min_step");
   const double maxStep = params.Get<double>("max_step");
   const size_t batchSize = (size_t) params.Get<int>("batch_size");
+  const size_t numNeighbors = (size_t) params.Get<int>("num_neighbors");
 
   // Load data.
   arma::mat data = std::move(params.Get<arma::mat>("input"));
@@ -218,6 +226,12 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   arma::Row<size_t> labels;
   data::NormalizeLabels(rawLabels, labels, mappings);
 
+  if (numNeighbors >= data.n_cols)
+  {
+    Log::Fatal << "The number of neighbors (" << numNeighbors << ") must be "
+        << "less than the number of points (" << data.n_cols << ")!" << endl;
+  }
+
   arma::mat distance;
 
   // Normalize the data, if necessary.
@@ -242,7 +256,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   timers.Start("nca_optimization");
   if (optimizerType == "sgd")
   {
-    NCA<LMetric<2> > nca(data, labels);
+    NCA<LMetric<2> > nca(data, labels, LMetric<2>(), numNeighbors);
     nca.Optimizer().StepSize() = stepSize;
     nca.Optimizer().MaxIterations() = maxIterations;
     nca.Optimizer().Tolerance() = tolerance;
@@ -253,7 +267,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   }
   else if (optimizerType == "lbfgs")
   {
-    NCA<LMetric<2>, ens::L_BFGS> nca(data, labels);
+    NCA<LMetric<2>, ens::L_BFGS> nca(data, labels, LMetric<2>(),
+        numNeighbors);
     nca.Optimizer().NumBasis() = numBasis;
     nca.Optimizer().MaxIterations() = maxIterations;
     nca.Optimizer().ArmijoConstant() = armijoConstant;
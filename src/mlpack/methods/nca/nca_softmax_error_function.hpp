@@ -17,6 +17,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/math/make_alias.hpp>
 #include <mlpack/core/math/shuffle_data.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 namespace mlpack {
 
@@ -39,6 +40,20 @@ namespace mlpack {
  * optimizers use, overloads of Evaluate() and Gradient() are given which only
  * operate on one point in the dataset.  This is useful for optimizers like
  * stochastic gradient descent (see mlpack::optimization::SGD).
+ *
+ * Computing p_i exactly takes O(n) time per point, so the non-separable
+ * Evaluate() and Gradient() take O(n^2) time.  If numNeighbors is nonzero, the
+ * softmax of each point is instead truncated to its numNeighbors nearest
+ * neighbors in the projected space A x (found with a NeighborSearch under the
+ * Euclidean distance), so that
+ *
+ * p_ij = (exp(-|| A x_i - A x_j || ^ 2)) /
+ *     (sum_{k in N(i)} (exp(-|| A x_i - A x_k || ^ 2)))
+ *
+ * for j in N(i), and p_ij = 0 otherwise.  Since the projection changes during
+ * the optimization, the neighbors are searched again each time refreshInterval
+ * passes over the dataset have been evaluated.  When numNeighbors is at least
+ * n - 1, the truncated softmax is the exact softmax.
  */
 template<typename MetricType = SquaredEuclideanDistance>
 class SoftmaxErrorFunction
@@ -53,10 +68,17 @@ class SoftmaxErrorFunction
    * @param dataset Matrix containing the dataset.
    * @param labels Vector of class labels for each point in the dataset.
    * @param metric Instantiated metric (optional).
+   * @param numNeighbors Number of nearest neighbors of each point the softmax
+   *     is truncated to; 0 considers all the points.
+   * @param refreshInterval Number of passes over the dataset after which the
+   *     nearest neighbors are searched again, if numNeighbors is nonzero; 0
+   *     searches them at every evaluation.
    */
   SoftmaxErrorFunction(const arma::mat& dataset,
                        const arma::Row<size_t>& labels,
-                       MetricType metric = MetricType());
+                       MetricType metric = MetricType(),
+                       const size_t numNeighbors = 0,
+                       const size_t refreshInterval = 10);
 
   /**
    * Shuffle the dataset.
@@ -130,6 +152,13 @@ class SoftmaxErrorFunction
    */
   size_t NumFunctions() const { return dataset.n_cols; }
 
+  //! Get the number of nearest neighbors the softmax is truncated to.
+  size_t NumNeighbors() const { return numNeighbors; }
+  //! Get the number of passes over the dataset between neighbor searches.
+  size_t RefreshInterval() const { return refreshInterval; }
+  //! Modify the number of passes over the dataset between neighbor searches.
+  size_t& RefreshInterval() { return refreshInterval; }
+
  private:
   //! The dataset.  This is an alias until Shuffle() is called.
   arma::mat dataset;
@@ -153,6 +182,19 @@ class SoftmaxErrorFunction
   //! False if nothing has ever been precalculated (only at construction time).
   bool precalculated;
 
+  //! Number of nearest neighbors the softmax is truncated to (0 for all).
+  size_t numNeighbors;
+  //! Number of passes over the dataset between neighbor searches.
+  size_t refreshInterval;
+  //! Nearest neighbors of each point in the projected space, one column per
+  //! point, if the softmax is truncated.
+  arma::Mat<size_t> neighbors;
+  //! Number of points evaluated since the last neighbor search.
+  size_t pointsSinceSearch;
+  //! Holds the p_ik of the neighbors of each point, for the non-separable
+  //! Evaluate() and Gradient(), if the softmax is truncated.
+  arma::mat neighborProbabilities;
+
   /**
    * Precalculate the denominators and numerators that will make up the p_ij,
    * but only if the coordinates matrix is different than the last coordinates
@@ -167,6 +209,35 @@ class SoftmaxErrorFunction
    * @param coordinates Coordinates matrix to use for precalculation.
    */
   void Precalculate(const arma::mat& coordinates);
+
+  /**
+   * Return whether the nearest neighbors of the points must be searched again
+   * before evaluating the truncated softmax.
+   */
+  bool NeighborsStale() const;
+
+  /**
+   * Search the nearest neighbors of each point in stretchedDataset, which must
+   * hold the projection of the whole dataset.
+   */
+  void SearchNeighbors();
+
+  /**
+   * Compute the truncated softmax p_ik of the nearest neighbors of point i,
+   * and return p_i.
+   *
+   * @param i Index of the point.
+   * @param stretchedPoint Projection of point i.
+   * @param stretchedNeighbors Projections of the neighbors of point i.
+   * @param probabilities Vector to store the p_ik in.
+   */
+  double NeighborProbabilities(const size_t i,
+                               const arma::vec& stretchedPoint,
+                               const arma::mat& stretchedNeighbors,
+                               arma::vec& probabilities);
+
+  //! Get the (unprojected) nearest neighbors of point i, one per column.
+  arma::mat NeighborPoints(const size_t i) const;
 };
 
 } // namespace mlpack
@@ -24,12 +24,26 @@ template<typename MetricType>
 SoftmaxErrorFunction<MetricType>::SoftmaxErrorFunction(
     const arma::mat& dataset,
     const arma::Row<size_t>& labels,
-    MetricType metric) :
+    MetricType metric,
+    const size_t numNeighbors,
+    const size_t refreshInterval) :
     dataset(MakeAlias(const_cast<arma::mat&>(dataset), false)),
     labels(MakeAlias(const_cast<arma::Row<size_t>&>(labels), false)),
     metric(metric),
-    precalculated(false)
-{ /* nothing to do */ }
+    precalculated(false),
+    numNeighbors(numNeighbors),
+    refreshInterval(refreshInterval),
+    pointsSinceSearch(0)
+{
+  if (numNeighbors > 0 && numNeighbors >= dataset.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "SoftmaxErrorFunction::SoftmaxErrorFunction(): the number of "
+        << "neighbors (" << numNeighbors << ") must be less than the number of "
+        << "points (" << dataset.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+}
 
 //! Shuffle the dataset.
 template<typename MetricType>
@@ -45,6 +59,10 @@ void SoftmaxErrorFunction<MetricType>::Shuffle()
 
   dataset = std::move(newDataset);
   labels = std::move(newLabels);
+
+  // The precalculated values and the neighbors refer to the old order.
+  precalculated = false;
+  neighbors.reset();
 }
 
 //! The non-separable implementation, which uses Precalculate() to save time.
@@ -65,6 +83,30 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
                                                   const size_t begin,
                                                   const size_t batchSize)
 {
+  if (numNeighbors > 0)
+  {
+    if (NeighborsStale())
+    {
+      stretchedDataset = coordinates * dataset;
+      SearchNeighbors();
+    }
+    pointsSinceSearch += batchSize;
+
+    // Only the neighbors of the points of the batch need to be projected.
+    double result = 0;
+    #pragma omp parallel for reduction(+:result) num_threads((int) NumThreads())
+    for (size_t i = begin; i < begin + batchSize; ++i)
+    {
+      const arma::vec stretchedPoint = coordinates * dataset.col(i);
+      const arma::mat stretchedNeighbors = coordinates * NeighborPoints(i);
+      arma::vec probabilities;
+      result -= NeighborProbabilities(i, stretchedPoint, stretchedNeighbors,
+          probabilities);
+    }
+
+    return result;
+  }
+
   // Unfortunately each evaluation will take O(N) time because it requires a
   // scan over all points in the dataset.  Our objective is to compute p_i.
   double denominator = 0;
@@ -126,28 +168,57 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
   //     (((p_i - (1 / p_i)) p_ik) + ((p_k - (1 / p_k)) p_ki)) x_ik x_ik^T
   //   otherwise, add
   //     (p_i p_ik + p_k p_ki) x_ik x_ik^T
+  //
+  // If the softmax is truncated, p_ik and p_ki are not symmetric, so instead we
+  // add (p_i - 1) p_ik x_ik x_ik^T or p_i p_ik x_ik x_ik^T for each neighbor k
+  // of each point i.  Each thread sums the terms of its points, and the sums
+  // are added at the end.
   arma::mat sum;
-  sum.zeros(stretchedDataset.n_rows, stretchedDataset.n_rows);
-  for (size_t i = 0; i < stretchedDataset.n_cols; ++i)
+  sum.zeros(dataset.n_rows, dataset.n_rows);
+  #pragma omp parallel num_threads((int) NumThreads())
   {
-    for (size_t k = (i + 1); k < stretchedDataset.n_cols; ++k)
+    arma::mat threadSum(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+
+    #pragma omp for schedule(dynamic)
+    for (size_t i = 0; i < stretchedDataset.n_cols; ++i)
     {
-      // Calculate p_ik and p_ki first.
-      double eval = std::exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
-      double p_ik = 0, p_ki = 0;
-      p_ik = eval / denominators(i);
-      p_ki = eval / denominators(k);
+      if (numNeighbors > 0)
+      {
+        // Subtract x_i from its neighbors.  The sign does not matter.
+        arma::mat x = NeighborPoints(i);
+        x.each_col() -= dataset.col(i);
 
-      // Subtract x_i from x_k.  We are not using stretched points here.
-      arma::vec x_ik = dataset.col(i) - dataset.col(k);
-      arma::mat secondTerm = (x_ik * trans(x_ik));
+        arma::rowvec weights = p[i] * neighborProbabilities.col(i).t();
+        for (size_t k = 0; k < numNeighbors; ++k)
+          if (labels[i] == labels[neighbors(k, i)])
+            weights[k] -= neighborProbabilities(k, i);
 
-      if (labels[i] == labels[k])
-        sum += ((p[i] - 1) * p_ik + (p[k] - 1) * p_ki) * secondTerm;
-      else
-        sum += (p[i] * p_ik + p[k] * p_ki) * secondTerm;
+        threadSum += (x.each_row() % weights) * x.t();
+        continue;
+      }
+
+      for (size_t k = (i + 1); k < stretchedDataset.n_cols; ++k)
+      {
+        // Calculate p_ik and p_ki first.
+        double eval = std::exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
+                                           stretchedDataset.unsafe_col(k)));
+        double p_ik = 0, p_ki = 0;
+        p_ik = eval / denominators(i);
+        p_ki = eval / denominators(k);
+
+        // Subtract x_i from x_k.  We are not using stretched points here.
+        arma::vec x_ik = dataset.col(i) - dataset.col(k);
+        arma::mat secondTerm = (x_ik * trans(x_ik));
+
+        if (labels[i] == labels[k])
+          threadSum += ((p[i] - 1) * p_ik + (p[k] - 1) * p_ki) * secondTerm;
+        else
+          threadSum += (p[i] * p_ik + p[k] * p_ki) * secondTerm;
+      }
     }
+
+    #pragma omp critical
+    sum += threadSum;
   }
 
   // Assemble the final gradient.
@@ -162,6 +233,49 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
                                                 GradType& gradient,
                                                 const size_t batchSize)
 {
+  if (numNeighbors > 0)
+  {
+    if (NeighborsStale())
+    {
+      stretchedDataset = coordinates * dataset;
+      SearchNeighbors();
+    }
+    pointsSinceSearch += batchSize;
+
+    // Sum (p_i - 1) p_ik x_ik x_ik^T or p_i p_ik x_ik x_ik^T over the neighbors
+    // k of each point i of the batch, as in the non-separable Gradient().
+    arma::mat sum(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+    #pragma omp parallel num_threads((int) NumThreads())
+    {
+      arma::mat threadSum(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+
+      #pragma omp for
+      for (size_t i = begin; i < begin + batchSize; ++i)
+      {
+        arma::mat x = NeighborPoints(i);
+        const arma::vec stretchedPoint = coordinates * dataset.col(i);
+        const arma::mat stretchedNeighbors = coordinates * x;
+        arma::vec probabilities;
+        const double p = NeighborProbabilities(i, stretchedPoint,
+            stretchedNeighbors, probabilities);
+
+        arma::rowvec weights = p * probabilities.t();
+        for (size_t k = 0; k < numNeighbors; ++k)
+          if (labels[i] == labels[neighbors(k, i)])
+            weights[k] -= probabilities[k];
+
+        x.each_col() -= dataset.col(i);
+        threadSum += (x.each_row() % weights) * x.t();
+      }
+
+      #pragma omp critical
+      sum += threadSum;
+    }
+
+    gradient = -2 * coordinates * sum;
+    return;
+  }
+
   // The gradient involves two matrix terms which are eventually combined into
   // one.
   GradType firstTerm, secondTerm;
@@ -256,6 +370,33 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   lastCoordinates = coordinates;
   stretchedDataset = coordinates * dataset;
 
+  if (numNeighbors > 0)
+  {
+    if (NeighborsStale())
+      SearchNeighbors();
+    pointsSinceSearch += dataset.n_cols;
+
+    // Each point only depends on its own neighbors, so the truncated softmax
+    // of the points can be computed in parallel.
+    p.set_size(stretchedDataset.n_cols);
+    neighborProbabilities.set_size(numNeighbors, stretchedDataset.n_cols);
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t i = 0; i < stretchedDataset.n_cols; ++i)
+    {
+      arma::mat stretchedNeighbors(stretchedDataset.n_rows, numNeighbors);
+      for (size_t k = 0; k < numNeighbors; ++k)
+        stretchedNeighbors.col(k) = stretchedDataset.col(neighbors(k, i));
+
+      arma::vec probabilities;
+      p[i] = NeighborProbabilities(i, stretchedDataset.col(i),
+          stretchedNeighbors, probabilities);
+      neighborProbabilities.col(i) = probabilities;
+    }
+
+    precalculated = true;
+    return;
+  }
+
   // For each point i, we must evaluate the softmax function:
   //   p_ij = exp( -K(x_i, x_j) ) / ( sum_{k != i} ( exp( -K(x_i, x_k) )))
   //   p_i = sum_{j in class of i} p_ij
@@ -305,6 +446,58 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   precalculated = true;
 }
 
+template<typename MetricType>
+bool SoftmaxErrorFunction<MetricType>::NeighborsStale() const
+{
+  return (neighbors.n_cols != dataset.n_cols) ||
+      (pointsSinceSearch >= refreshInterval * dataset.n_cols);
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::SearchNeighbors()
+{
+  // The nearest neighbors under the Euclidean distance are also the nearest
+  // neighbors under the squared Euclidean distance.
+  KNN knn(stretchedDataset);
+  arma::mat distances;
+  knn.Search(numNeighbors, neighbors, distances);
+  pointsSinceSearch = 0;
+}
+
+template<typename MetricType>
+double SoftmaxErrorFunction<MetricType>::NeighborProbabilities(
+    const size_t i,
+    const arma::vec& stretchedPoint,
+    const arma::mat& stretchedNeighbors,
+    arma::vec& probabilities)
+{
+  arma::vec distances(numNeighbors);
+  for (size_t k = 0; k < numNeighbors; ++k)
+    distances[k] = metric.Evaluate(stretchedPoint, stretchedNeighbors.col(k));
+
+  // Shift the distances by the smallest one before taking the exponential;
+  // this does not change the p_ik, but the denominator can't underflow to 0.
+  probabilities = arma::exp(distances.min() - distances);
+  probabilities /= accu(probabilities);
+
+  double p = 0;
+  for (size_t k = 0; k < numNeighbors; ++k)
+    if (labels[i] == labels[neighbors(k, i)])
+      p += probabilities[k];
+
+  return p;
+}
+
+template<typename MetricType>
+arma::mat SoftmaxErrorFunction<MetricType>::NeighborPoints(const size_t i) const
+{
+  arma::mat points(dataset.n_rows, numNeighbors);
+  for (size_t k = 0; k < numNeighbors; ++k)
+    points.col(k) = dataset.col(neighbors(k, i));
+
+  return points;
+}
+
 } // namespace mlpack
 
 #endif
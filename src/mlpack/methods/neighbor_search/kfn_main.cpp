@@ -99,6 +99,9 @@ PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, "
     "Hilbert R trees, R+ trees, R++ trees, and octrees).", "l", 20);
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "Hold the reference set and the trees in "
+    "single precision, which halves their memory usage; distances are then "
+    "only accurate to about seven significant digits.", "");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
@@ -123,6 +126,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   ReportIgnoredParam(params, {{ "input_model", true }}, "tree_type");
   ReportIgnoredParam(params, {{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam(params, {{ "input_model", true }}, "single_precision");
 
   // Notify the user of parameters that will be only be considered for query
   // tree.
@@ -233,6 +237,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     kfn->TreeType() = tree;
     kfn->RandomBasis() = randomBasis;
+    kfn->SinglePrecision() = params.Has("single_precision");
     kfn->LeafSize() = size_t(lsInt);
 
     Log::Info << "Using reference data from "
@@ -259,7 +264,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     Log::Info << "Using kFN model from '"
         << params.GetPrintable<KFNModel*>("input_model") << "' (trained on "
-        << kfn->Dataset().n_rows << "x" << kfn->Dataset().n_cols
+        << kfn->Dimensionality() << "x" << kfn->NumPoints()
         << " dataset)." << endl;
   }
 
@@ -274,10 +279,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       Log::Info << "Using query data from "
           << params.GetPrintable<arma::mat>("query") << "." << endl;
       queryData = std::move(params.Get<arma::mat>("query"));
-      if (queryData.n_rows != kfn->Dataset().n_rows)
+      if (queryData.n_rows != kfn->Dimensionality())
       {
         // Clean memory if needed.
-        const size_t dimensions = kfn->Dataset().n_rows;
+        const size_t dimensions = kfn->Dimensionality();
         if (params.Has("reference"))
           delete kfn;
         Log::Fatal << "Query has invalid dimensions (" << queryData.n_rows <<
@@ -288,10 +293,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     // Sanity check on k value: must be greater than 0, must be less than or
     // equal to the number of reference points.  Since it is unsigned,
     // we only test the upper bound.
-    if (k > kfn->Dataset().n_cols)
+    if (k > kfn->NumPoints())
     {
       // Clean memory if needed.
-      const size_t referencePoints = kfn->Dataset().n_cols;
+      const size_t referencePoints = kfn->NumPoints();
       if (params.Has("reference"))
         delete kfn;
       Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
@@ -301,10 +306,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     // Sanity check on k value: must not be equal to the number of reference
     // points when query data has not been provided.
-    if (!params.Has("query") && k == kfn->Dataset().n_cols)
+    if (!params.Has("query") && k == kfn->NumPoints())
     {
       // Clean memory if needed.
-      const size_t referencePoints = kfn->Dataset().n_cols;
+      const size_t referencePoints = kfn->NumPoints();
       if (params.Has("reference"))
         delete kfn;
       Log::Fatal << "Invalid k: " << k << "; must be less than the number of "
@@ -109,6 +109,9 @@ PARAM_DOUBLE_IN("rho", "Balance threshold (only valid for spill trees).", "b",
 
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "Hold the reference set and the trees in "
+    "single precision, which halves their memory usage; distances are then "
+    "only accurate to about seven significant digits.", "");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
@@ -116,6 +119,18 @@ PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
     "'dual_tree', 'greedy'.", "a", "dual_tree");
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate nearest neighbor "
     "search with given relative error.", "e", 0);
+PARAM_INT_IN("max_base_cases", "If nonzero, stop the search after roughly "
+    "this many distance computations and return the best neighbors found so "
+    "far.", "", 0);
+PARAM_INT_IN("max_scores", "If nonzero, stop the search after roughly this "
+    "many tree nodes have been visited and return the best neighbors found so "
+    "far.", "", 0);
+PARAM_DOUBLE_IN("max_time", "If nonzero, stop the search after roughly this "
+    "many seconds and return the best neighbors found so far.", "", 0.0);
+PARAM_STRING_OUT("traversal_report_file", "If specified, statistics of the "
+    "tree traversals of the search (node combinations scored, pruned, and "
+    "recursed into at each level of the reference tree, base cases, and time "
+    "spent scoring and in base cases) are saved to this file as JSON.", "");
 
 void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 {
@@ -129,6 +144,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   ReportIgnoredParam(params, {{ "input_model", true }}, "tree_type");
   ReportIgnoredParam(params, {{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam(params, {{ "input_model", true }}, "single_precision");
   ReportIgnoredParam(params, {{ "input_model", true }}, "tau");
   ReportIgnoredParam(params, {{ "input_model", true }}, "rho");
   if (params.Has("input_model") && params.Has("leaf_size"))
@@ -183,6 +199,16 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   RequireParamValue<double>(params, "epsilon",
       [](double x) { return x >= 0.0; }, true, "epsilon must be positive");
 
+  // Sanity check on the search budget.
+  RequireParamValue<int>(params, "max_base_cases",
+      [](int x) { return x >= 0; }, true,
+      "maximum number of base cases must be non-negative");
+  RequireParamValue<int>(params, "max_scores", [](int x) { return x >= 0; },
+      true, "maximum number of visited nodes must be non-negative");
+  RequireParamValue<double>(params, "max_time",
+      [](double x) { return x >= 0.0; }, true,
+      "maximum search time must be non-negative");
+
   // We either have to load the reference data, or we have to load the model.
   KNNModel* knn;
 
@@ -246,6 +272,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     knn->TreeType() = tree;
     knn->RandomBasis() = randomBasis;
+    knn->SinglePrecision() = params.Has("single_precision");
     knn->LeafSize() = size_t(lsInt);
     knn->Tau() = tau;
     knn->Rho() = rho;
@@ -274,7 +301,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     Log::Info << "Loaded kNN model from '"
         << params.GetPrintable<KNNModel*>("input_model") << "' (trained on "
-        << knn->Dataset().n_rows << "x" << knn->Dataset().n_cols
+        << knn->Dimensionality() << "x" << knn->NumPoints()
         << " dataset)." << endl;
   }
 
@@ -289,10 +316,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       Log::Info << "Using query data from "
           << params.GetPrintable<arma::mat>("query") << "." << endl;
       queryData = std::move(params.Get<arma::mat>("query"));
-      if (queryData.n_rows != knn->Dataset().n_rows)
+      if (queryData.n_rows != knn->Dimensionality())
       {
         // Clean memory if needed before crashing.
-        const size_t dimensions = knn->Dataset().n_rows;
+        const size_t dimensions = knn->Dimensionality();
         if (params.Has("reference"))
           delete knn;
         Log::Fatal << "Query has invalid dimensions(" << queryData.n_rows <<
@@ -303,10 +330,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     // Sanity check on k value: must be greater than 0, must be less than or
     // equal to the number of reference points.  Since it is unsigned,
     // we only test the upper bound.
-    if (k > knn->Dataset().n_cols)
+    if (k > knn->NumPoints())
     {
       // Clean memory if needed before crashing.
-      const size_t referencePoints = knn->Dataset().n_cols;
+      const size_t referencePoints = knn->NumPoints();
       if (params.Has("reference"))
         delete knn;
       Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
@@ -316,10 +343,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     // Sanity check on k value: must not be equal to the number of reference
     // points when query data has not been provided.
-    if (!params.Has("query") && k == knn->Dataset().n_cols)
+    if (!params.Has("query") && k == knn->NumPoints())
     {
       // Clean memory if needed before crashing.
-      const size_t referencePoints = knn->Dataset().n_cols;
+      const size_t referencePoints = knn->NumPoints();
       if (params.Has("reference"))
         delete knn;
       Log::Fatal << "Invalid k: " << k << "; must be less than the number of "
@@ -327,6 +354,12 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
           << "not been provided." << endl;
     }
 
+    // Set the budget of the search.
+    knn->Budget().MaxBaseCases() = (size_t) params.Get<int>("max_base_cases");
+    knn->Budget().MaxScores() = (size_t) params.Get<int>("max_scores");
+    knn->Budget().MaxTime() = params.Get<double>("max_time");
+    knn->Statistics().Enabled() = params.Has("traversal_report_file");
+
     // Now run the search.
     arma::Mat<size_t> neighbors;
     arma::mat distances;
@@ -337,6 +370,26 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       knn->Search(timers, k, neighbors, distances);
 
     Log::Info << "Search complete." << endl;
+    if (!knn->Exact())
+    {
+      Log::Info << "The search budget ran out; the results are approximate."
+          << endl;
+    }
+
+    if (params.Has("traversal_report_file"))
+    {
+      const string reportFile = params.Get<string>("traversal_report_file");
+      fstream reportStr(reportFile.c_str(), fstream::out);
+      if (!reportStr.is_open())
+      {
+        Log::Warn << "Cannot open file '" << reportFile << "' to save the "
+            << "traversal report to!" << endl;
+      }
+      else
+      {
+        reportStr << knn->Statistics().ToJSON() << endl;
+      }
+    }
 
     // Calculate the effective error, if desired.
     if (params.Has("true_distances"))
@@ -28,6 +28,7 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 class LeafSizeNSWrapper;
@@ -205,6 +206,35 @@ class NeighborSearch
    */
   void Train(Tree referenceTree);
 
+  /**
+   * Add the given points to the reference set, without rebuilding the
+   * reference tree from scratch (see BinarySpaceTree::InsertPoints()).  The
+   * new points get the indices N, ..., N + m - 1 in the results of later
+   * searches, where N is the number of reference points before the insertion
+   * and m is the number of new points.  In tree modes this is only available
+   * for trees that support InsertPoints(), such as the kd-tree and ball tree.
+   *
+   * If the model was trained with Train(Tree), the results of searches refer to
+   * positions in the dataset of the tree, and those positions may change.
+   *
+   * @param points New reference points.
+   * @param leafSize Maximum number of points held in a leaf of the tree.
+   */
+  void Insert(const MatType& points, const size_t leafSize = 20);
+
+  /**
+   * Remove the reference points with the given indices from the reference set,
+   * without rebuilding the reference tree from scratch (see
+   * BinarySpaceTree::DeletePoints()).  The remaining reference points are
+   * renumbered to be contiguous again, keeping their order, as with
+   * arma::Mat::shed_cols().  In tree modes this is only available for trees
+   * that support DeletePoints(), such as the kd-tree and ball tree.
+   *
+   * @param indices Indices of the reference points to remove.
+   * @param leafSize Maximum number of points held in a leaf of the tree.
+   */
+  void Delete(const std::vector<size_t>& indices, const size_t leafSize = 20);
+
   /**
    * For each point in the query set, compute the nearest neighbors and store
    * the output in the given matrices.  The matrices will be set to the size of
@@ -310,6 +340,31 @@ class NeighborSearch
   //! Return the number of node combination scores during the last search.
   size_t Scores() const { return scores; }
 
+  /**
+   * Get the budget of the search.  If a limit is set, Search() stops
+   * recursing once the budget runs out (for naive search, the remaining query
+   * points are skipped), and returns the best neighbors found so far.  Query
+   * points for which fewer than k neighbors were found have their remaining
+   * neighbors set to SIZE_MAX and their distances set to
+   * SortPolicy::WorstDistance().
+   */
+  const TraversalBudget& Budget() const { return budget; }
+  //! Modify the budget of the search.
+  TraversalBudget& Budget() { return budget; }
+
+  //! Return whether the results of the last search are exact (up to epsilon),
+  //! i.e., whether the budget did not run out.
+  bool Exact() const { return !budget.Truncated(); }
+
+  /**
+   * Get the statistics of the tree traversals of the last search.  These are
+   * only collected when Statistics().Enabled() is true; see
+   * TraversalStatistics.  Naive search does not collect statistics.
+   */
+  const TraversalStatistics& Statistics() const { return statistics; }
+  //! Modify the statistics of the tree traversals.
+  TraversalStatistics& Statistics() { return statistics; }
+
   //! Access the search mode.
   NeighborSearchMode SearchMode() const { return searchMode; }
   //! Modify the search mode.
@@ -357,9 +412,82 @@ class NeighborSearch
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  //! The budget of each search; the limits persist between searches.
+  TraversalBudget budget;
+
+  //! The statistics of the tree traversals of the last search.
+  TraversalStatistics statistics;
+
+  //! Map the given index of a reference point in the tree back to its index in
+  //! the original dataset.  Invalid indices (for neighbors that were not found)
+  //! are kept as they are.
+  size_t MapReference(const size_t index) const
+  {
+    return (index < oldFromNewReferences.size()) ?
+        oldFromNewReferences[index] : index;
+  }
+
+  /**
+   * Return the number of blocks that the given number of query points should
+   * be split into so that they can be searched in parallel.  This is 1 when
+   * OpenMP is not available, or when the reference tree can't be shared
+   * between threads.
+   *
+   * @param numQueries Number of query points.
+   * @param usesTree Whether or not the search will traverse the reference tree.
+   */
+  size_t NumQueryBlocks(const size_t numQueries, const bool usesTree) const;
+
+  /**
+   * Perform brute-force search for each point in the query set, storing the
+   * results in the given (already allocated) matrices.
+   */
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& neighbors,
+                   arma::Mat<ElemType>& distances,
+                   const bool sameSet);
+
+  /**
+   * Perform a single-tree search with the given traverser type for each point
+   * in the query set, storing the results in the given (already allocated)
+   * matrices.  Blocks of query points are searched in parallel.
+   */
+  template<typename TraverserType>
+  void SingleTreeSearch(const MatType& querySet,
+                        const size_t k,
+                        arma::Mat<size_t>& neighbors,
+                        arma::Mat<ElemType>& distances,
+                        const double searchEpsilon,
+                        const bool sameSet);
+
+  /**
+   * Perform a dual-tree search with the given query tree, storing the results
+   * in the given (already allocated) matrices.  For binary trees that
+   * rearrange the dataset, disjoint query subtrees are searched in parallel.
+   */
+  template<typename T = Tree>
+  void DualTreeSearch(Tree& queryTree,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::Mat<ElemType>& distances,
+                      const bool sameSet,
+                      const std::enable_if_t<TreeTraits<T>::BinaryTree &&
+                          TreeTraits<T>::RearrangesDataset>* = 0);
+
+  //! Perform a dual-tree search with the given query tree, serially.
+  template<typename T = Tree>
+  void DualTreeSearch(Tree& queryTree,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::Mat<ElemType>& distances,
+                      const bool sameSet,
+                      const std::enable_if_t<!(TreeTraits<T>::BinaryTree &&
+                          TreeTraits<T>::RearrangesDataset)>* = 0);
+
   //! The NSModel class should have access to internal members.
-  friend class LeafSizeNSWrapper<SortPolicy, TreeType, DualTreeTraversalType,
-      SingleTreeTraversalType>;
+  friend class LeafSizeNSWrapper<SortPolicy, TreeType, MatType,
+      DualTreeTraversalType, SingleTreeTraversalType>;
 }; // class NeighborSearch
 
 } // namespace mlpack
@@ -370,4 +498,18 @@ class NeighborSearch
 // Include convenience typedefs.
 #include "typedef.hpp"
 
+// If MLPACK_USE_PREBUILT is defined, the common instantiations below are
+// compiled into libmlpack (see BUILD_PREBUILT_LIBRARY), and are not
+// instantiated again here.
+#ifdef MLPACK_USE_PREBUILT
+namespace mlpack {
+
+extern template class NeighborSearch<NearestNeighborSort, EuclideanDistance,
+    arma::mat, KDTree>;
+extern template class NeighborSearch<FurthestNeighborSort, EuclideanDistance,
+    arma::mat, KDTree>;
+
+} // namespace mlpack
+#endif
+
 #endif
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
@@ -130,7 +131,9 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    budget(other.budget),
+    statistics(other.statistics)
 {
   // Nothing else to do.
 }
@@ -154,7 +157,9 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(other.treeNeedsReset)
+    treeNeedsReset(other.treeNeedsReset),
+    budget(other.budget),
+    statistics(other.statistics)
 {
   // Clear the other model.
   other.referenceTree = BuildTree<Tree>(std::move(MatType()),
@@ -208,6 +213,8 @@ NeighborSearch<SortPolicy,
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = false;
+  budget = other.budget;
+  statistics = other.statistics;
 }
 
 // Move operator.
@@ -250,6 +257,8 @@ NeighborSearch<SortPolicy,
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = other.treeNeedsReset;
+  budget = other.budget;
+  statistics = other.statistics;
 
   // Reset the other object.  Clean memory if needed.
   if (!other.referenceTree)
@@ -348,6 +357,118 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree referenceTree)
   this->referenceSet = &this->referenceTree->Dataset();
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Insert(
+    const MatType& points,
+    const size_t leafSize)
+{
+  if (points.n_cols == 0)
+    return;
+
+  if (referenceSet->n_cols > 0 && points.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "NeighborSearch::Insert(): dimensionality of points ("
+        << points.n_rows << ") does not match dimensionality of the reference "
+        << "set (" << referenceSet->n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (searchMode == NAIVE_MODE)
+  {
+    // In naive mode we own the reference set.
+    MatType* set = const_cast<MatType*>(referenceSet);
+    if (set->n_cols == 0)
+      *set = points;
+    else
+      set->insert_cols(set->n_cols, points);
+    return;
+  }
+
+  // If the tree was given to Train(), there is no mapping to maintain.
+  if (oldFromNewReferences.empty())
+    referenceTree->InsertPoints(points, leafSize);
+  else
+    referenceTree->InsertPoints(points, oldFromNewReferences, leafSize);
+  referenceSet = &referenceTree->Dataset();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Delete(
+    const std::vector<size_t>& indices,
+    const size_t leafSize)
+{
+  const size_t numPoints = referenceSet->n_cols;
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    if (indices[i] >= numPoints)
+    {
+      std::ostringstream oss;
+      oss << "NeighborSearch::Delete(): index " << indices[i] << " is out of "
+          << "bounds (the reference set holds " << numPoints << " points)!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  if (searchMode == NAIVE_MODE)
+  {
+    std::vector<bool> isDeleted(numPoints, false);
+    size_t numDeleted = 0;
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      if (!isDeleted[indices[i]])
+      {
+        isDeleted[indices[i]] = true;
+        ++numDeleted;
+      }
+    }
+
+    MatType* set = const_cast<MatType*>(referenceSet);
+    MatType kept(set->n_rows, numPoints - numDeleted);
+    size_t next = 0;
+    for (size_t i = 0; i < numPoints; ++i)
+      if (!isDeleted[i])
+        kept.col(next++) = set->col(i);
+    *set = std::move(kept);
+    return;
+  }
+
+  if (oldFromNewReferences.empty())
+  {
+    // The indices are positions in the dataset of the tree already.
+    referenceTree->DeletePoints(indices, leafSize);
+  }
+  else
+  {
+    std::vector<size_t> newFromOld(numPoints);
+    for (size_t i = 0; i < numPoints; ++i)
+      newFromOld[oldFromNewReferences[i]] = i;
+
+    std::vector<size_t> positions(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+      positions[i] = newFromOld[indices[i]];
+
+    referenceTree->DeletePoints(positions, oldFromNewReferences, leafSize);
+  }
+  referenceSet = &referenceTree->Dataset();
+}
+
 /**
  * Computes the best neighbors and stores them in resultingNeighbors and
  * distances.
@@ -377,6 +498,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   baseCases = 0;
   scores = 0;
+  budget.Start();
+  statistics.Reset();
 
   // This will hold mappings for query points, if necessary.
   std::vector<size_t> oldFromNewQueries;
@@ -404,97 +527,32 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   neighborPtr->set_size(k, querySet.n_cols);
   distancePtr->set_size(k, querySet.n_cols);
 
-  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+  typedef InstrumentedRules<NeighborSearchRules<SortPolicy, MetricType, Tree>>
+      RuleType;
 
   switch (searchMode)
   {
     case NAIVE_MODE:
-    {
-      // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, querySet, k, metric, epsilon);
-
-      // The naive brute-force traversal.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        for (size_t j = 0; j < referenceSet->n_cols; ++j)
-          rules.BaseCase(i, j);
-
-      baseCases += querySet.n_cols * referenceSet->n_cols;
-
-      rules.GetResults(*neighborPtr, *distancePtr);
+      NaiveSearch(querySet, k, *neighborPtr, *distancePtr, false);
       break;
-    }
     case SINGLE_TREE_MODE:
-    {
-      // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, querySet, k, metric, epsilon);
-
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-
-      rules.GetResults(*neighborPtr, *distancePtr);
+      SingleTreeSearch<SingleTreeTraversalType<RuleType>>(querySet, k,
+          *neighborPtr, *distancePtr, epsilon, false);
       break;
-    }
     case DUAL_TREE_MODE:
     {
       // Build the query tree.
       Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
 
-      // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
-
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
-      traverser.Traverse(*queryTree, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-
-      rules.GetResults(*neighborPtr, *distancePtr);
+      DualTreeSearch(*queryTree, k, *neighborPtr, *distancePtr, false);
 
       delete queryTree;
       break;
     }
     case GREEDY_SINGLE_TREE_MODE:
-    {
-      // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, querySet, k, metric);
-
-      // Create the traverser.
-      GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-
-      rules.GetResults(*neighborPtr, *distancePtr);
+      SingleTreeSearch<GreedySingleTreeTraverser<Tree, RuleType>>(querySet, k,
+          *neighborPtr, *distancePtr, 0.0, false);
       break;
-    }
   }
 
   // Map points back to original indices, if necessary.
@@ -515,7 +573,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         for (size_t j = 0; j < distances.n_rows; ++j)
         {
           neighbors(j, oldFromNewQueries[i]) =
-              oldFromNewReferences[(*neighborPtr)(j, i)];
+              MapReference((*neighborPtr)(j, i));
         }
       }
 
@@ -549,7 +607,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Map indices of neighbors.
       for (size_t i = 0; i < neighbors.n_cols; ++i)
         for (size_t j = 0; j < neighbors.n_rows; ++j)
-          neighbors(j, i) = oldFromNewReferences[(*neighborPtr)(j, i)];
+          neighbors(j, i) = MapReference((*neighborPtr)(j, i));
 
       // Finished with temporary matrix.
       delete neighborPtr;
@@ -588,6 +646,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   baseCases = 0;
   scores = 0;
+  budget.Start();
+  statistics.Reset();
 
   // Get a reference to the query set.
   const MatType& querySet = queryTree.Dataset();
@@ -601,24 +661,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   neighborPtr->set_size(k, querySet.n_cols);
   distances.set_size(k, querySet.n_cols);
 
-  // Create the helper object for the traversal.
-  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, querySet, k, metric, epsilon, sameSet);
-
-  // Create the traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(queryTree, *referenceTree);
-
-  scores += rules.Scores();
-  baseCases += rules.BaseCases();
-
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
-
-  rules.GetResults(*neighborPtr, distances);
-
-  Log::Info << rules.Scores() << " node combinations were scored.\n";
-  Log::Info << rules.BaseCases() << " base cases were calculated.\n";
+  DualTreeSearch(queryTree, k, *neighborPtr, distances, sameSet);
 
   // Do we need to map indices?
   if (!oldFromNewReferences.empty() && TreeTraits<Tree>::RearrangesDataset)
@@ -629,7 +672,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     // Map indices of neighbors.
     for (size_t i = 0; i < neighbors.n_cols; ++i)
       for (size_t j = 0; j < neighbors.n_rows; ++j)
-        neighbors(j, i) = oldFromNewReferences[(*neighborPtr)(j, i)];
+        neighbors(j, i) = MapReference((*neighborPtr)(j, i));
 
     // Finished with temporary matrix.
     delete neighborPtr;
@@ -668,6 +711,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   baseCases = 0;
   scores = 0;
+  budget.Start();
+  statistics.Reset();
 
   arma::Mat<size_t>* neighborPtr = &neighbors;
   arma::Mat<ElemType>* distancePtr = &distances;
@@ -683,41 +728,19 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   neighborPtr->set_size(k, referenceSet->n_cols);
   distancePtr->set_size(k, referenceSet->n_cols);
 
-  // Create the helper object for the traversal.
-  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
-      true /* don't return the same point as nearest neighbor */);
+  typedef InstrumentedRules<NeighborSearchRules<SortPolicy, MetricType, Tree>>
+      RuleType;
 
+  // In each case, the same point is not returned as its own nearest neighbor.
   switch (searchMode)
   {
     case NAIVE_MODE:
-    {
-      // The naive brute-force solution.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        for (size_t j = 0; j < referenceSet->n_cols; ++j)
-          rules.BaseCase(i, j);
-
-      baseCases += referenceSet->n_cols * referenceSet->n_cols;
+      NaiveSearch(*referenceSet, k, *neighborPtr, *distancePtr, true);
       break;
-    }
     case SINGLE_TREE_MODE:
-    {
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
+      SingleTreeSearch<SingleTreeTraversalType<RuleType>>(*referenceSet, k,
+          *neighborPtr, *distancePtr, epsilon, true);
       break;
-    }
     case DUAL_TREE_MODE:
     {
       // The dual-tree monochromatic search case may require resetting the
@@ -740,57 +763,28 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         }
       }
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
       if (IsSpillTree<Tree>::value)
       {
         // For Dual Tree Search on SpillTree, the queryTree must be built with
         // non overlapping (tau = 0).
         Tree queryTree(*referenceSet);
-        traverser.Traverse(queryTree, *referenceTree);
+        DualTreeSearch(queryTree, k, *neighborPtr, *distancePtr, true);
       }
       else
       {
-        traverser.Traverse(*referenceTree, *referenceTree);
-        // Next time we perform this search, we'll need to reset the tree.
-        treeNeedsReset = true;
+        DualTreeSearch(*referenceTree, k, *neighborPtr, *distancePtr, true);
       }
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-
       // Next time we perform this search, we'll need to reset the tree.
       treeNeedsReset = true;
       break;
     }
     case GREEDY_SINGLE_TREE_MODE:
-    {
-      // Create the traverser.
-      GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
+      SingleTreeSearch<GreedySingleTreeTraverser<Tree, RuleType>>(
+          *referenceSet, k, *neighborPtr, *distancePtr, epsilon, true);
       break;
-    }
   }
 
-  rules.GetResults(*neighborPtr, *distancePtr);
-
   // Do we need to map the reference indices?
   if (!oldFromNewReferences.empty() && TreeTraits<Tree>::RearrangesDataset)
   {
@@ -805,7 +799,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
       // Map each neighbor's index.
       for (size_t j = 0; j < distances.n_rows; ++j)
-        neighbors(j, refMapping) = oldFromNewReferences[(*neighborPtr)(j, i)];
+        neighbors(j, refMapping) = MapReference((*neighborPtr)(j, i));
     }
 
     // Finished with temporary matrices.
@@ -814,6 +808,255 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::NumQueryBlocks(
+    const size_t numQueries,
+    const bool usesTree) const
+{
+  // Trees whose nodes hold their own points (i.e. the cover tree) cache
+  // distances in the statistics of the reference nodes during the search, so
+  // their reference tree can't be shared between threads.
+  if (usesTree && TreeTraits<Tree>::HasSelfChildren)
+    return 1;
+
+  return NumParallelTasks(numQueries);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::Mat<ElemType>& distances,
+    const bool sameSet)
+{
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  const size_t numBlocks = NumQueryBlocks(querySet.n_cols, false);
+  size_t searchedQueries = 0;
+
+  #pragma omp parallel for schedule(dynamic) reduction(+:searchedQueries) \
+      num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = (b * querySet.n_cols) / numBlocks;
+    const size_t end = ((b + 1) * querySet.n_cols) / numBlocks;
+    if (begin == end)
+      continue;
+
+    // Create the helper object for this block of queries.
+    RuleType rules(*referenceSet, querySet, begin, end - begin, k, metric,
+        epsilon, sameSet);
+
+    // The naive brute-force traversal.  If the budget runs out, the remaining
+    // query points are left without results.
+    for (size_t i = begin; i < end; ++i)
+    {
+      if (budget.Prune())
+        break;
+
+      for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        rules.BaseCase(i, j);
+      budget.Add(referenceSet->n_cols, 0);
+      ++searchedQueries;
+    }
+
+    // Each block writes its own columns of the results.
+    arma::Mat<size_t> blockNeighbors(neighbors.colptr(begin), k, end - begin,
+        false, true);
+    arma::Mat<ElemType> blockDistances(distances.colptr(begin), k,
+        end - begin, false, true);
+    rules.GetResults(blockNeighbors, blockDistances);
+  }
+
+  baseCases += searchedQueries * referenceSet->n_cols;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TraverserType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SingleTreeSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::Mat<ElemType>& distances,
+    const double searchEpsilon,
+    const bool sameSet)
+{
+  typedef InstrumentedRules<NeighborSearchRules<SortPolicy, MetricType, Tree>>
+      RuleType;
+
+  const size_t numBlocks = NumQueryBlocks(querySet.n_cols, true);
+  size_t blockScores = 0;
+  size_t blockBaseCases = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:blockScores, blockBaseCases) num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = (b * querySet.n_cols) / numBlocks;
+    const size_t end = ((b + 1) * querySet.n_cols) / numBlocks;
+    if (begin == end)
+      continue;
+
+    // Create the helper object and the traverser for this block of queries.
+    TraversalStatistics blockStatistics;
+    RuleType rules(statistics.Enabled() ? &blockStatistics : NULL,
+        *referenceSet, querySet, begin, end - begin, k, metric, searchEpsilon,
+        sameSet, &budget);
+    TraverserType traverser(rules);
+
+    // Now have it traverse for each point.
+    for (size_t i = begin; i < end; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    blockScores += rules.Scores();
+    blockBaseCases += rules.BaseCases();
+    if (statistics.Enabled())
+    {
+      #pragma omp critical
+      statistics.Merge(blockStatistics);
+    }
+
+    // Each block writes its own columns of the results.
+    arma::Mat<size_t> blockNeighbors(neighbors.colptr(begin), k, end - begin,
+        false, true);
+    arma::Mat<ElemType> blockDistances(distances.colptr(begin), k,
+        end - begin, false, true);
+    rules.GetResults(blockNeighbors, blockDistances);
+  }
+
+  scores += blockScores;
+  baseCases += blockBaseCases;
+
+  Log::Info << blockScores << " node combinations were scored." << std::endl;
+  Log::Info << blockBaseCases << " base cases were calculated." << std::endl;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename T>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DualTreeSearch(
+    Tree& queryTree,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::Mat<ElemType>& distances,
+    const bool sameSet,
+    const std::enable_if_t<TreeTraits<T>::BinaryTree &&
+                           TreeTraits<T>::RearrangesDataset>*)
+{
+  typedef InstrumentedRules<NeighborSearchRules<SortPolicy, MetricType, Tree>>
+      RuleType;
+
+  size_t blockScores = 0;
+  size_t blockBaseCases = 0;
+
+  // Disjoint query subtrees, each of which holds a contiguous range of query
+  // points, are searched in parallel.
+  ParallelDualTreeTraversal(queryTree, NumQueryBlocks(queryTree.Count(), true),
+      [&](Tree& queryNode)
+      {
+        const size_t begin = queryNode.Begin();
+        const size_t count = queryNode.Count();
+
+        // Create the helper object and the traverser for this query subtree.
+        TraversalStatistics blockStatistics;
+        RuleType rules(statistics.Enabled() ? &blockStatistics : NULL,
+            *referenceSet, queryTree.Dataset(), begin, count, k, metric,
+            epsilon, sameSet, &budget);
+        DualTreeTraversalType<RuleType> traverser(rules);
+        traverser.Traverse(queryNode, *referenceTree);
+
+        // Each subtree writes its own columns of the results.
+        arma::Mat<size_t> blockNeighbors(neighbors.colptr(begin), k, count,
+            false, true);
+        arma::Mat<ElemType> blockDistances(distances.colptr(begin), k, count,
+            false, true);
+        rules.GetResults(blockNeighbors, blockDistances);
+
+        #pragma omp critical
+        {
+          blockScores += rules.Scores();
+          blockBaseCases += rules.BaseCases();
+          statistics.Merge(blockStatistics);
+        }
+      });
+
+  scores += blockScores;
+  baseCases += blockBaseCases;
+
+  Log::Info << blockScores << " node combinations were scored." << std::endl;
+  Log::Info << blockBaseCases << " base cases were calculated." << std::endl;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename T>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DualTreeSearch(
+    Tree& queryTree,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::Mat<ElemType>& distances,
+    const bool sameSet,
+    const std::enable_if_t<!(TreeTraits<T>::BinaryTree &&
+                             TreeTraits<T>::RearrangesDataset)>*)
+{
+  // Create the helper object for the traversal.
+  typedef InstrumentedRules<NeighborSearchRules<SortPolicy, MetricType, Tree>>
+      RuleType;
+  RuleType rules(statistics.Enabled() ? &statistics : NULL, *referenceSet,
+      queryTree.Dataset(), k, metric, epsilon, sameSet, &budget);
+
+  // Create the traverser.
+  DualTreeTraversalType<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+
+  scores += rules.Scores();
+  baseCases += rules.BaseCases();
+
+  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
+  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+
+  rules.GetResults(neighbors, distances);
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename MetricType,
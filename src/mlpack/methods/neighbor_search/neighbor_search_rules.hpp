@@ -14,11 +14,32 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/traversal_budget.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 
 #include <queue>
 
 namespace mlpack {
 
+/**
+ * Whether the distances between all points of two leaves can be computed with
+ * a single matrix multiplication, using the expansion
+ * ||q - r||^2 = ||q||^2 + ||r||^2 - 2 q^T r.  This is the case for the
+ * Euclidean and squared Euclidean distances on dense matrices.
+ */
+template<typename MetricType, typename MatType>
+struct UseExpandedDistances
+{
+  static const bool value = false;
+};
+
+//! The Euclidean and squared Euclidean distances on dense data can be expanded.
+template<bool TakeRoot, typename eT>
+struct UseExpandedDistances<LMetric<2, TakeRoot>, arma::Mat<eT>>
+{
+  static const bool value = true;
+};
+
 /**
  * The NeighborSearchRules class is a template helper class used by
  * NeighborSearch class when performing distance-based neighbor searches.  For
@@ -48,16 +69,50 @@ class NeighborSearchRules
    * @param epsilon Relative approximate error.
    * @param sameSet If true, the query and reference set are taken to be the
    *      same, and a query point will not return itself in the results.
+   * @param budget If not NULL, the traversal stops recursing once this budget
+   *      is exhausted.
+   */
+  NeighborSearchRules(const typename TreeType::Mat& referenceSet,
+                      const typename TreeType::Mat& querySet,
+                      const size_t k,
+                      MetricType& metric,
+                      const double epsilon = 0,
+                      const bool sameSet = false,
+                      TraversalBudget* budget = NULL);
+
+  /**
+   * Construct the NeighborSearchRules object to search only for the neighbors
+   * of the query points with indices in [queryBegin, queryBegin + queryCount).
+   * Only those query points may be passed to BaseCase() and Score().  This is
+   * used to search for different subsets of query points in parallel.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param queryBegin Index of the first query point to search for.
+   * @param queryCount Number of query points to search for.
+   * @param k Number of neighbors to search for.
+   * @param metric Instantiated metric.
+   * @param epsilon Relative approximate error.
+   * @param sameSet If true, the query and reference set are taken to be the
+   *      same, and a query point will not return itself in the results.
+   * @param budget If not NULL, the traversal stops recursing once this budget
+   *      is exhausted.  The budget may be shared between rules used in
+   *      parallel.
    */
   NeighborSearchRules(const typename TreeType::Mat& referenceSet,
                       const typename TreeType::Mat& querySet,
+                      const size_t queryBegin,
+                      const size_t queryCount,
                       const size_t k,
                       MetricType& metric,
                       const double epsilon = 0,
-                      const bool sameSet = false);
+                      const bool sameSet = false,
+                      TraversalBudget* budget = NULL);
 
   /**
    * Store the list of candidates for each query point in the given matrices.
+   * If the rules were constructed for a subset of the query points, column i
+   * holds the results for query point (queryBegin + i).
    *
    * @param neighbors Matrix storing lists of neighbors for each query point.
    * @param distances Matrix storing distances of neighbors for each query
@@ -65,6 +120,24 @@ class NeighborSearchRules
    */
   void GetResults(arma::Mat<size_t>& neighbors, arma::Mat<ElemType>& distances);
 
+  /**
+   * Add a candidate neighbor of the given query point that was found outside of
+   * the traversal (for instance, by a search of another shard of the reference
+   * set).  Since the pruning bounds are computed from the candidates, adding
+   * good candidates before the traversal makes it prune more.
+   *
+   * @param queryIndex Index of the query point.
+   * @param neighbor Index to store for the candidate; it should not be the
+   *     index of a point of the reference set.
+   * @param distance Distance from the query point to the candidate.
+   */
+  void AddCandidate(const size_t queryIndex,
+                    const size_t neighbor,
+                    const double distance)
+  {
+    InsertNeighbor(queryIndex, neighbor, distance);
+  }
+
   /**
    * Get the distance from the query point to the reference point.
    * This will update the list of candidates with the new point if appropriate
@@ -75,6 +148,23 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between each of the given query points and every
+   * point in the given reference leaf, updating the candidate lists of the
+   * query points.  This is used by the BinarySpaceTree traversers when two
+   * leaves are compared, and is equivalent to calling BaseCase() for each pair
+   * of points.
+   *
+   * For the Euclidean distance on dense data, the distances of the whole block
+   * are computed at once with a matrix multiplication, and only the pairs that
+   * may enter a candidate list have their distance computed exactly.
+   *
+   * @param queryIndices Indices of query points.
+   * @param referenceNode Reference leaf; its points must be contiguous.
+   */
+  void LeafBaseCases(const std::vector<size_t>& queryIndices,
+                     TreeType& referenceNode);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -188,6 +278,9 @@ class NeighborSearchRules
   //! Set of candidate neighbors for each point.
   std::vector<CandidateList> candidates;
 
+  //! The index of the first query point that we hold candidates for.
+  size_t queryBegin;
+
   //! Number of neighbors to search for.
   const size_t k;
 
@@ -216,11 +309,45 @@ class NeighborSearchRules
   //! traversal before each call to Score().
   TraversalInfoType traversalInfo;
 
+  //! The budget of the traversal, or NULL if there is no budget.
+  TraversalBudget* budget;
+  //! The number of base cases already reported to the budget.
+  size_t budgetBaseCases;
+
+  /**
+   * Report the work done since the last call to the budget (if any), and
+   * return whether the current node combination should be pruned because the
+   * budget is exhausted.
+   */
+  bool OverBudget();
+
   /**
    * Recalculate the bound for a given query node.
    */
   double CalculateBound(TreeType& queryNode) const;
 
+  /**
+   * Compute the distances between a block of query points and a reference leaf
+   * with a matrix multiplication; see LeafBaseCases().
+   */
+  template<typename DistanceType = MetricType>
+  void LeafBaseCasesImpl(
+      const std::vector<size_t>& queryIndices,
+      TreeType& referenceNode,
+      const std::enable_if_t<UseExpandedDistances<DistanceType,
+          typename TreeType::Mat>::value>* = 0);
+
+  /**
+   * Compute the distances between a block of query points and a reference leaf
+   * with the metric, one pair at a time; see LeafBaseCases().
+   */
+  template<typename DistanceType = MetricType>
+  void LeafBaseCasesImpl(
+      const std::vector<size_t>& queryIndices,
+      TreeType& referenceNode,
+      const std::enable_if_t<!UseExpandedDistances<DistanceType,
+          typename TreeType::Mat>::value>* = 0);
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
@@ -25,9 +25,28 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     const size_t k,
     MetricType& metric,
     const double epsilon,
-    const bool sameSet) :
+    const bool sameSet,
+    TraversalBudget* budget) :
+    NeighborSearchRules(referenceSet, querySet, 0, querySet.n_cols, k, metric,
+        epsilon, sameSet, budget)
+{
+  // Nothing to do.
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    const size_t queryBegin,
+    const size_t queryCount,
+    const size_t k,
+    MetricType& metric,
+    const double epsilon,
+    const bool sameSet,
+    TraversalBudget* budget) :
     referenceSet(referenceSet),
     querySet(querySet),
+    queryBegin(queryBegin),
     k(k),
     metric(metric),
     sameSet(sameSet),
@@ -35,7 +54,9 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
-    scores(0)
+    scores(0),
+    budget(budget),
+    budgetBaseCases(0)
 {
   // We must set the traversal info last query and reference node pointers to
   // something that is both invalid (i.e. not a tree node) and not NULL.  We'll
@@ -53,8 +74,8 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
   std::vector<Candidate> vect(k, def);
   CandidateList pqueue(CandidateCmp(), std::move(vect));
 
-  candidates.reserve(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; ++i)
+  candidates.reserve(queryCount);
+  for (size_t i = 0; i < queryCount; ++i)
     candidates.push_back(pqueue);
 }
 
@@ -63,10 +84,10 @@ void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
     arma::Mat<ElemType>& distances)
 {
-  neighbors.set_size(k, querySet.n_cols);
-  distances.set_size(k, querySet.n_cols);
+  neighbors.set_size(k, candidates.size());
+  distances.set_size(k, candidates.size());
 
-  for (size_t i = 0; i < querySet.n_cols; ++i)
+  for (size_t i = 0; i < candidates.size(); ++i)
   {
     CandidateList& pqueue = candidates[i];
     for (size_t j = 1; j <= k; ++j)
@@ -106,12 +127,121 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::LeafBaseCases(
+    const std::vector<size_t>& queryIndices,
+    TreeType& referenceNode)
+{
+  LeafBaseCasesImpl(queryIndices, referenceNode);
+  baseCases += queryIndices.size() * referenceNode.Count();
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<typename DistanceType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::LeafBaseCasesImpl(
+    const std::vector<size_t>& queryIndices,
+    TreeType& referenceNode,
+    const std::enable_if_t<UseExpandedDistances<DistanceType,
+        typename TreeType::Mat>::value>*)
+{
+  typedef typename TreeType::Mat MatType;
+
+  const size_t refBegin = referenceNode.Begin();
+  const size_t refCount = referenceNode.Count();
+  if (refCount == 0)
+    return;
+
+  // Gather the query points; the reference points are already contiguous, so
+  // they are used in place.
+  MatType queries(querySet.n_rows, queryIndices.size());
+  for (size_t i = 0; i < queryIndices.size(); ++i)
+    queries.col(i) = querySet.col(queryIndices[i]);
+
+  const arma::subview<ElemType> references = referenceSet.cols(refBegin,
+      refBegin + refCount - 1);
+  const arma::Row<ElemType> queryNorms = arma::sum(arma::square(queries), 0);
+  const arma::Row<ElemType> referenceNorms =
+      arma::sum(arma::square(references), 0);
+
+  // Each column holds the inner products of one query point with all of the
+  // reference points.
+  const MatType products = references.t() * queries;
+
+  // The expansion loses precision when the points are far from the origin
+  // compared to their distance, so the computed squared distance is only
+  // accurate up to a multiple (depending on the dimensionality) of the squared
+  // norms of the points.  We use the expanded distance as a filter, and compute
+  // the exact distance for any pair that may enter the candidate list.
+  const double precision = 4.0 * (querySet.n_rows + 2) *
+      std::numeric_limits<ElemType>::epsilon();
+  const bool takeRoot = DistanceType::TakeRoot;
+  for (size_t i = 0; i < queryIndices.size(); ++i)
+  {
+    const size_t queryIndex = queryIndices[i];
+    const CandidateList& pqueue = candidates[queryIndex - queryBegin];
+    for (size_t j = 0; j < refCount; ++j)
+    {
+      const size_t referenceIndex = refBegin + j;
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      const double sqDist = std::max((double) queryNorms[i] +
+          (double) referenceNorms[j] - 2.0 * (double) products(j, i), 0.0);
+      const double error = precision *
+          ((double) queryNorms[i] + (double) referenceNorms[j]);
+
+      // |sqrt(a) - sqrt(b)| <= sqrt(|a - b|), so this bounds the error of the
+      // distance itself.
+      const double distance = takeRoot ? std::sqrt(sqDist) : sqDist;
+      const double bestDistance = SortPolicy::CombineBest(distance,
+          takeRoot ? std::sqrt(error) : error);
+
+      // The best possible distance goes through the same comparison as in
+      // InsertNeighbor(); if even that distance would not be inserted, the
+      // exact distance would not be either.
+      if (!CandidateCmp()(std::make_pair(bestDistance, referenceIndex),
+          pqueue.top()))
+        continue; // This point can't be a neighbor.
+
+      const double exactDistance = metric.Evaluate(querySet.col(queryIndex),
+          referenceSet.col(referenceIndex));
+      InsertNeighbor(queryIndex, referenceIndex, exactDistance);
+    }
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<typename DistanceType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::LeafBaseCasesImpl(
+    const std::vector<size_t>& queryIndices,
+    TreeType& referenceNode,
+    const std::enable_if_t<!UseExpandedDistances<DistanceType,
+        typename TreeType::Mat>::value>*)
+{
+  const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
+  for (size_t i = 0; i < queryIndices.size(); ++i)
+  {
+    const size_t queryIndex = queryIndices[i];
+    for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
+    {
+      if (sameSet && (queryIndex == ref))
+        continue;
+
+      const double distance = metric.Evaluate(querySet.col(queryIndex),
+          referenceSet.col(ref));
+      InsertNeighbor(queryIndex, ref, distance);
+    }
+  }
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
     TreeType& referenceNode)
 {
   ++scores; // Count number of Score() calls.
+  if (OverBudget())
+    return DBL_MAX;
   double distance;
   if (TreeTraits<TreeType>::FirstPointIsCentroid)
   {
@@ -142,7 +272,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
   }
 
   // Compare against the best k'th distance for this query point so far.
-  double bestDistance = candidates[queryIndex].top().first;
+  double bestDistance = candidates[queryIndex - queryBegin].top().first;
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
   return (SortPolicy::IsBetter(distance, bestDistance)) ?
@@ -174,11 +304,13 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
   // If we are already pruning, still prune.
   if (oldScore == DBL_MAX)
     return oldScore;
+  if (budget && budget->Prune())
+    return DBL_MAX;
 
   const double distance = SortPolicy::ConvertToDistance(oldScore);
 
   // Just check the score again against the distances.
-  double bestDistance = candidates[queryIndex].top().first;
+  double bestDistance = candidates[queryIndex - queryBegin].top().first;
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
   return (SortPolicy::IsBetter(distance, bestDistance)) ? oldScore : DBL_MAX;
@@ -190,6 +322,8 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     TreeType& referenceNode)
 {
   ++scores; // Count number of Score() calls.
+  if (OverBudget())
+    return DBL_MAX;
 
   // Update our bound.
   const double bestDistance = CalculateBound(queryNode);
@@ -351,7 +485,11 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
     TreeType& /* referenceNode */,
     const double oldScore) const
 {
-  if (oldScore == DBL_MAX || oldScore == 0.0)
+  if (oldScore == DBL_MAX)
+    return oldScore;
+  if (budget && budget->Prune())
+    return DBL_MAX;
+  if (oldScore == 0.0)
     return oldScore;
 
   const double distance = SortPolicy::ConvertToDistance(oldScore);
@@ -401,7 +539,8 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
   // Loop over points held in the node.
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
-    const double distance = candidates[queryNode.Point(i)].top().first;
+    const double distance =
+        candidates[queryNode.Point(i) - queryBegin].top().first;
     if (SortPolicy::IsBetter(worstDistance, distance))
       worstDistance = distance;
     if (SortPolicy::IsBetter(distance, bestPointDistance))
@@ -482,6 +621,20 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
     return bestDistance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline bool NeighborSearchRules<SortPolicy, MetricType, TreeType>::OverBudget()
+{
+  if (!budget)
+    return false;
+
+  // Only report the work once per Score() call, so that the shared counters
+  // are not touched in every base case.
+  const bool prune = budget->Prune();
+  budget->Add(baseCases - budgetBaseCases, 1);
+  budgetBaseCases = baseCases;
+  return prune;
+}
+
 /**
  * Helper function to insert a point into the list of candidate points.
  *
@@ -496,7 +649,7 @@ InsertNeighbor(
     const size_t neighbor,
     const double distance)
 {
-  CandidateList& pqueue = candidates[queryIndex];
+  CandidateList& pqueue = candidates[queryIndex - queryBegin];
   Candidate c = std::make_pair(distance, neighbor);
 
   if (CandidateCmp()(c, pqueue.top()))
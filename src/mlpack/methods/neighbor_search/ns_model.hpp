@@ -45,9 +45,16 @@ class NSWrapperBase
   //! Destruct the NSWrapperBase (nothing to do).
   virtual ~NSWrapperBase() { }
 
-  //! Return a reference to the dataset.
+  //! Return a reference to the dataset.  This throws std::invalid_argument if
+  //! the dataset is not held as an arma::mat (i.e. for single-precision
+  //! models).
   virtual const arma::mat& Dataset() const = 0;
 
+  //! Get the dimensionality of the dataset.
+  virtual size_t Dimensionality() const = 0;
+  //! Get the number of points in the dataset.
+  virtual size_t NumPoints() const = 0;
+
   //! Get the search mode.
   virtual NeighborSearchMode SearchMode() const = 0;
   //! Modify the search modem
@@ -58,6 +65,16 @@ class NSWrapperBase
   //! Modify the approximation parameter epsilon.
   virtual double& Epsilon() = 0;
 
+  //! Get the budget of each search.
+  virtual const TraversalBudget& Budget() const = 0;
+  //! Modify the budget of each search.
+  virtual TraversalBudget& Budget() = 0;
+
+  //! Get the statistics of the tree traversals of the last search.
+  virtual const TraversalStatistics& Statistics() const = 0;
+  //! Modify the statistics of the tree traversals.
+  virtual TraversalStatistics& Statistics() = 0;
+
   //! Train the NeighborSearch model with the given parameters.
   virtual void Train(util::Timers& timers,
                      arma::mat&& referenceSet,
@@ -81,23 +98,42 @@ class NSWrapperBase
                       const size_t k,
                       arma::Mat<size_t>& neighbors,
                       arma::mat& distances) = 0;
+
+ protected:
+  //! Return the given dataset, which has type arma::mat.
+  static const arma::mat& DatasetAsMat(const arma::mat& dataset)
+  {
+    return dataset;
+  }
+
+  //! Throw an exception, since the given dataset does not have type arma::mat.
+  template<typename MatType>
+  static const arma::mat& DatasetAsMat(const MatType& /* dataset */)
+  {
+    throw std::invalid_argument("Dataset(): the dataset of a single-precision "
+        "model is not held as an arma::mat");
+  }
 };
 
 /**
- * NSWrapper is a wrapper class for most NeighborSearch types.
+ * NSWrapper is a wrapper class for most NeighborSearch types.  The datasets
+ * given to Train() and Search() are converted to MatType, so that the
+ * NeighborSearch object (and its trees) can hold them in single precision;
+ * the distances that Search() returns are converted back to arma::mat.
  */
 template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType = arma::mat,
          template<typename RuleType> class DualTreeTraversalType =
              TreeType<EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template DualTreeTraverser,
+                      MatType>::template DualTreeTraverser,
          template<typename RuleType> class SingleTreeTraversalType =
              TreeType<EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template SingleTreeTraverser>
+                      MatType>::template SingleTreeTraverser>
 class NSWrapper : public NSWrapperBase
 {
  public:
@@ -118,7 +154,12 @@ class NSWrapper : public NSWrapperBase
   virtual NSWrapper* Clone() const { return new NSWrapper(*this); }
 
   //! Get a reference to the reference set.
-  const arma::mat& Dataset() const { return ns.ReferenceSet(); }
+  const arma::mat& Dataset() const { return DatasetAsMat(ns.ReferenceSet()); }
+
+  //! Get the dimensionality of the reference set.
+  size_t Dimensionality() const { return ns.ReferenceSet().n_rows; }
+  //! Get the number of points in the reference set.
+  size_t NumPoints() const { return ns.ReferenceSet().n_cols; }
 
   //! Get the search mode.
   NeighborSearchMode SearchMode() const { return ns.SearchMode(); }
@@ -130,6 +171,16 @@ class NSWrapper : public NSWrapperBase
   //! Modify epsilon, the approximation parameter.
   double& Epsilon() { return ns.Epsilon(); }
 
+  //! Get the budget of each search.
+  const TraversalBudget& Budget() const { return ns.Budget(); }
+  //! Modify the budget of each search.
+  TraversalBudget& Budget() { return ns.Budget(); }
+
+  //! Get the statistics of the tree traversals of the last search.
+  const TraversalStatistics& Statistics() const { return ns.Statistics(); }
+  //! Modify the statistics of the tree traversals.
+  TraversalStatistics& Statistics() { return ns.Statistics(); }
+
   //! Train the model with the given options.  For NSWrapper, we ignore the
   //! extra parameters.
   virtual void Train(util::Timers& timers,
@@ -166,7 +217,7 @@ class NSWrapper : public NSWrapperBase
   // Convenience typedef for the neighbor search type held by this class.
   typedef NeighborSearch<SortPolicy,
                          EuclideanDistance,
-                         arma::mat,
+                         MatType,
                          TreeType,
                          DualTreeTraversalType,
                          SingleTreeTraversalType> NSType;
@@ -184,17 +235,19 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType = arma::mat,
          template<typename RuleType> class DualTreeTraversalType =
              TreeType<EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template DualTreeTraverser,
+                      MatType>::template DualTreeTraverser,
          template<typename RuleType> class SingleTreeTraversalType =
              TreeType<EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template SingleTreeTraverser>
+                      MatType>::template SingleTreeTraverser>
 class LeafSizeNSWrapper :
     public NSWrapper<SortPolicy,
                      TreeType,
+                     MatType,
                      DualTreeTraversalType,
                      SingleTreeTraversalType>
 {
@@ -205,6 +258,7 @@ class LeafSizeNSWrapper :
                     const double epsilon) :
       NSWrapper<SortPolicy,
                 TreeType,
+                MatType,
                 DualTreeTraversalType,
                 SingleTreeTraversalType>(searchMode, epsilon)
   {
@@ -248,6 +302,7 @@ class LeafSizeNSWrapper :
  protected:
   using NSWrapper<SortPolicy,
                   TreeType,
+                  MatType,
                   DualTreeTraversalType,
                   SingleTreeTraversalType>::ns;
 };
@@ -256,17 +311,18 @@ class LeafSizeNSWrapper :
  * The SpillNSWrapper class wraps the NeighborSearch class when the spill tree
  * is used.
  */
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType = arma::mat>
 class SpillNSWrapper :
     public NSWrapper<
         SortPolicy,
         SPTree,
+        MatType,
         SPTree<EuclideanDistance,
                NeighborSearchStat<SortPolicy>,
-               arma::mat>::template DefeatistDualTreeTraverser,
+               MatType>::template DefeatistDualTreeTraverser,
         SPTree<EuclideanDistance,
                NeighborSearchStat<SortPolicy>,
-               arma::mat>::template DefeatistSingleTreeTraverser>
+               MatType>::template DefeatistSingleTreeTraverser>
 {
  public:
   //! Construct the SpillNSWrapper.
@@ -275,12 +331,13 @@ class SpillNSWrapper :
       NSWrapper<
           SortPolicy,
           SPTree,
+          MatType,
           SPTree<EuclideanDistance,
                  NeighborSearchStat<SortPolicy>,
-                 arma::mat>::template DefeatistDualTreeTraverser,
+                 MatType>::template DefeatistDualTreeTraverser,
           SPTree<EuclideanDistance,
                  NeighborSearchStat<SortPolicy>,
-                 arma::mat>::template DefeatistSingleTreeTraverser>(
+                 MatType>::template DefeatistSingleTreeTraverser>(
           searchMode, epsilon)
   {
     // Nothing to do.
@@ -320,12 +377,13 @@ class SpillNSWrapper :
   using NSWrapper<
       SortPolicy,
       SPTree,
+      MatType,
       SPTree<EuclideanDistance,
              NeighborSearchStat<SortPolicy>,
-             arma::mat>::template DefeatistDualTreeTraverser,
+             MatType>::template DefeatistDualTreeTraverser,
       SPTree<EuclideanDistance,
              NeighborSearchStat<SortPolicy>,
-             arma::mat>::template DefeatistSingleTreeTraverser>::ns;
+             MatType>::template DefeatistSingleTreeTraverser>::ns;
 };
 
 /**
@@ -371,6 +429,9 @@ class NSModel
   //! This is the random projection matrix; only used if randomBasis is true.
   arma::mat q;
 
+  //! If true, the dataset and the trees are held in single precision.
+  bool singlePrecision;
+
   size_t leafSize;
   double tau;
   double rho;
@@ -389,8 +450,12 @@ class NSModel
    * @param treeType Type of tree to use.
    * @param randomBasis Whether or not to project the points onto a random basis
    *      before searching.
+   * @param singlePrecision Whether or not to hold the dataset and the trees in
+   *      single precision (arma::fmat), which halves their memory usage.
    */
-  NSModel(TreeTypes treeType = TreeTypes::KD_TREE, bool randomBasis = false);
+  NSModel(TreeTypes treeType = TreeTypes::KD_TREE,
+          bool randomBasis = false,
+          bool singlePrecision = false);
 
   /**
    * Copy the given NSModel.
@@ -425,11 +490,17 @@ class NSModel
 
   //! Serialize the neighbor search model.
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
-  //! Expose the dataset.
+  //! Expose the dataset.  This throws std::invalid_argument for
+  //! single-precision models; use Dimensionality() and NumPoints() instead.
   const arma::mat& Dataset() const;
 
+  //! Get the dimensionality of the dataset.
+  size_t Dimensionality() const { return nSearch->Dimensionality(); }
+  //! Get the number of points in the dataset.
+  size_t NumPoints() const { return nSearch->NumPoints(); }
+
   //! Expose SearchMode.
   NeighborSearchMode SearchMode() const;
   NeighborSearchMode& SearchMode();
@@ -450,6 +521,22 @@ class NSModel
   double Epsilon() const;
   double& Epsilon();
 
+  //! Expose the budget of each search.  The budget is not serialized, and it
+  //! is reset by BuildModel() and InitializeModel().
+  const TraversalBudget& Budget() const { return nSearch->Budget(); }
+  TraversalBudget& Budget() { return nSearch->Budget(); }
+
+  //! Return whether the results of the last search are exact (up to epsilon),
+  //! i.e., whether the budget did not run out.
+  bool Exact() const { return !Budget().Truncated(); }
+
+  //! Expose the statistics of the tree traversals of the last search.  These
+  //! are not serialized, and they are reset by BuildModel() and
+  //! InitializeModel().
+  const TraversalStatistics& Statistics() const
+  { return nSearch->Statistics(); }
+  TraversalStatistics& Statistics() { return nSearch->Statistics(); }
+
   //! Expose treeType.
   TreeTypes TreeType() const { return treeType; }
   TreeTypes& TreeType() { return treeType; }
@@ -458,6 +545,11 @@ class NSModel
   bool RandomBasis() const { return randomBasis; }
   bool& RandomBasis() { return randomBasis; }
 
+  //! Expose singlePrecision.  This takes effect the next time the model is
+  //! built.
+  bool SinglePrecision() const { return singlePrecision; }
+  bool& SinglePrecision() { return singlePrecision; }
+
   //! Initialize the model type.  (This does not perform any training.)
   void InitializeModel(const NeighborSearchMode searchMode,
                        const double epsilon);
@@ -483,11 +575,37 @@ class NSModel
 
   //! Return a string representation of the current tree type.
   std::string TreeName() const;
+
+ private:
+  //! Initialize nSearch to hold a NeighborSearch object of the current tree
+  //! type with datasets of type MatType.
+  template<typename MatType>
+  void InitializeSearch(const NeighborSearchMode searchMode,
+                        const double epsilon);
+
+  //! Serialize nSearch, which holds datasets of type MatType.
+  template<typename MatType, typename Archive>
+  void SerializeSearch(Archive& ar);
 };
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename SortPolicy),
+    (mlpack::NSModel<SortPolicy>), (1));
+
 // Include implementation.
 #include "ns_model_impl.hpp"
 
+// If MLPACK_USE_PREBUILT is defined, the common instantiations below are
+// compiled into libmlpack (see BUILD_PREBUILT_LIBRARY), and are not
+// instantiated again here.
+#ifdef MLPACK_USE_PREBUILT
+namespace mlpack {
+
+extern template class NSModel<NearestNeighborSort>;
+extern template class NSModel<FurthestNeighborSort>;
+
+} // namespace mlpack
+#endif
+
 #endif
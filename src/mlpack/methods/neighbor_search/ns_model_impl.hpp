@@ -26,10 +26,12 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void NSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Train(util::Timers& timers,
          arma::mat&& referenceSet,
          const size_t /* leafSize */,
@@ -39,7 +41,7 @@ void NSWrapper<
   if (ns.SearchMode() != NAIVE_MODE)
     timers.Start("tree_building");
 
-  ns.Train(std::move(referenceSet));
+  ns.Train(ConvertOrMove<MatType>(std::move(referenceSet)));
 
   if (ns.SearchMode() != NAIVE_MODE)
     timers.Stop("tree_building");
@@ -51,10 +53,12 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void NSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Search(util::Timers& timers,
           arma::mat&& querySet,
           const size_t k,
@@ -63,23 +67,28 @@ void NSWrapper<
           const size_t /* leafSize */,
           const double /* rho */)
 {
+  arma::Mat<typename MatType::elem_type> distancesOut;
   if (ns.SearchMode() == DUAL_TREE_MODE)
   {
     // We build the query tree manually, so that we can time how long it takes.
     timers.Start("tree_building");
-    typename decltype(ns)::Tree queryTree(std::move(querySet));
+    typename decltype(ns)::Tree queryTree(
+        ConvertOrMove<MatType>(std::move(querySet)));
     timers.Stop("tree_building");
 
     timers.Start("computing_neighbors");
-    ns.Search(queryTree, k, neighbors, distances);
+    ns.Search(queryTree, k, neighbors, distancesOut);
     timers.Stop("computing_neighbors");
   }
   else
   {
     timers.Start("computing_neighbors");
-    ns.Search(std::move(querySet), k, neighbors, distances);
+    ns.Search(ConvertOrMove<MatType>(std::move(querySet)), k, neighbors,
+        distancesOut);
     timers.Stop("computing_neighbors");
   }
+
+  distances = ConvertOrMove<arma::mat>(std::move(distancesOut));
 }
 
 //! Perform monochromatic neighbor search (i.e. use the reference set as the
@@ -88,18 +97,23 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void NSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Search(util::Timers& timers,
           const size_t k,
           arma::Mat<size_t>& neighbors,
           arma::mat& distances)
 {
+  arma::Mat<typename MatType::elem_type> distancesOut;
   timers.Start("computing_neighbors");
-  ns.Search(k, neighbors, distances);
+  ns.Search(k, neighbors, distancesOut);
   timers.Stop("computing_neighbors");
+
+  distances = ConvertOrMove<arma::mat>(std::move(distancesOut));
 }
 
 //! Train a model with the given parameters.  This overload uses leafSize but
@@ -108,10 +122,12 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void LeafSizeNSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Train(util::Timers& timers,
          arma::mat&& referenceSet,
          const size_t leafSize,
@@ -120,15 +136,16 @@ void LeafSizeNSWrapper<
 {
   if (ns.SearchMode() == NAIVE_MODE)
   {
-    ns.Train(std::move(referenceSet));
+    ns.Train(ConvertOrMove<MatType>(std::move(referenceSet)));
   }
   else
   {
     // Build the tree with the specified leaf size.
     timers.Start("tree_building");
     std::vector<size_t> oldFromNewReferences;
-    typename decltype(ns)::Tree referenceTree(std::move(referenceSet),
-        oldFromNewReferences, leafSize);
+    typename decltype(ns)::Tree referenceTree(
+        ConvertOrMove<MatType>(std::move(referenceSet)), oldFromNewReferences,
+        leafSize);
     ns.Train(std::move(referenceTree));
     ns.oldFromNewReferences = std::move(oldFromNewReferences);
     timers.Stop("tree_building");
@@ -141,10 +158,12 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void LeafSizeNSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Search(util::Timers& timers,
           arma::mat&& querySet,
           const size_t k,
@@ -161,12 +180,13 @@ void LeafSizeNSWrapper<
     // query tree manually.)
     timers.Start("tree_building");
     std::vector<size_t> oldFromNewQueries;
-    typename decltype(ns)::Tree queryTree(std::move(querySet),
-        oldFromNewQueries, leafSize);
+    typename decltype(ns)::Tree queryTree(
+        ConvertOrMove<MatType>(std::move(querySet)), oldFromNewQueries,
+        leafSize);
     timers.Stop("tree_building");
 
     arma::Mat<size_t> neighborsOut;
-    arma::mat distancesOut;
+    arma::Mat<typename MatType::elem_type> distancesOut;
     timers.Start("computing_neighbors");
     ns.Search(queryTree, k, neighborsOut, distancesOut);
     timers.Stop("computing_neighbors");
@@ -177,28 +197,33 @@ void LeafSizeNSWrapper<
     for (size_t i = 0; i < neighborsOut.n_cols; ++i)
     {
       neighbors.col(oldFromNewQueries[i]) = neighborsOut.col(i);
-      distances.col(oldFromNewQueries[i]) = distancesOut.col(i);
+      distances.col(oldFromNewQueries[i]) =
+          ConvTo<arma::vec>::From(distancesOut.col(i));
     }
   }
   else
   {
+    arma::Mat<typename MatType::elem_type> distancesOut;
     timers.Start("computing_neighbors");
-    ns.Search(querySet, k, neighbors, distances);
+    ns.Search(ConvertOrMove<MatType>(std::move(querySet)), k, neighbors,
+        distancesOut);
     timers.Stop("computing_neighbors");
+
+    distances = ConvertOrMove<arma::mat>(std::move(distancesOut));
   }
 }
 
 //! Train the model using the given parameters.
-template<typename SortPolicy>
-void SpillNSWrapper<SortPolicy>::Train(util::Timers& timers,
-                                       arma::mat&& referenceSet,
-                                       const size_t leafSize,
-                                       const double tau,
-                                       const double rho)
+template<typename SortPolicy, typename MatType>
+void SpillNSWrapper<SortPolicy, MatType>::Train(util::Timers& timers,
+                                                arma::mat&& referenceSet,
+                                                const size_t leafSize,
+                                                const double tau,
+                                                const double rho)
 {
   timers.Start("tree_building");
-  typename decltype(ns)::Tree tree(std::move(referenceSet), tau, leafSize,
-      rho);
+  typename decltype(ns)::Tree tree(
+      ConvertOrMove<MatType>(std::move(referenceSet)), tau, leafSize, rho);
   timers.Stop("tree_building");
 
   ns.Train(std::move(tree));
@@ -206,34 +231,39 @@ void SpillNSWrapper<SortPolicy>::Train(util::Timers& timers,
 
 //! Perform bichromatic search (i.e. search with a different query set) using
 //! the given parameters.
-template<typename SortPolicy>
-void SpillNSWrapper<SortPolicy>::Search(util::Timers& timers,
-                                        arma::mat&& querySet,
-                                        const size_t k,
-                                        arma::Mat<size_t>& neighbors,
-                                        arma::mat& distances,
-                                        const size_t leafSize,
-                                        const double rho)
+template<typename SortPolicy, typename MatType>
+void SpillNSWrapper<SortPolicy, MatType>::Search(util::Timers& timers,
+                                                 arma::mat&& querySet,
+                                                 const size_t k,
+                                                 arma::Mat<size_t>& neighbors,
+                                                 arma::mat& distances,
+                                                 const size_t leafSize,
+                                                 const double rho)
 {
+  arma::Mat<typename MatType::elem_type> distancesOut;
   if (ns.SearchMode() == DUAL_TREE_MODE)
   {
     // For Dual Tree Search on SpillTrees, the queryTree must be built with
     // non overlapping (tau = 0).
     timers.Start("tree_building");
-    typename decltype(ns)::Tree queryTree(std::move(querySet), 0 /* tau */,
-        leafSize, rho);
+    typename decltype(ns)::Tree queryTree(
+        ConvertOrMove<MatType>(std::move(querySet)), 0 /* tau */, leafSize,
+        rho);
     timers.Stop("tree_building");
 
     timers.Start("computing_neighbors");
-    ns.Search(queryTree, k, neighbors, distances);
+    ns.Search(queryTree, k, neighbors, distancesOut);
     timers.Stop("computing_neighbors");
   }
   else
   {
     timers.Start("computing_neighbors");
-    ns.Search(querySet, k, neighbors, distances);
+    ns.Search(ConvertOrMove<MatType>(std::move(querySet)), k, neighbors,
+        distancesOut);
     timers.Stop("computing_neighbors");
   }
+
+  distances = ConvertOrMove<arma::mat>(std::move(distancesOut));
 }
 
 /**
@@ -241,9 +271,12 @@ void SpillNSWrapper<SortPolicy>::Search(util::Timers& timers,
  * basis should be used.
  */
 template<typename SortPolicy>
-NSModel<SortPolicy>::NSModel(TreeTypes treeType, bool randomBasis) :
+NSModel<SortPolicy>::NSModel(TreeTypes treeType,
+                             bool randomBasis,
+                             bool singlePrecision) :
     treeType(treeType),
     randomBasis(randomBasis),
+    singlePrecision(singlePrecision),
     leafSize(20),
     tau(0.0),
     rho(0.7),
@@ -257,6 +290,7 @@ NSModel<SortPolicy>::NSModel(const NSModel& other) :
     treeType(other.treeType),
     randomBasis(other.randomBasis),
     q(other.q),
+    singlePrecision(other.singlePrecision),
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
@@ -270,6 +304,7 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
     treeType(other.treeType),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
+    singlePrecision(other.singlePrecision),
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
@@ -278,6 +313,7 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
   other.randomBasis = false;
+  other.singlePrecision = false;
   other.leafSize = 20;
   other.tau = 0.0;
   other.rho = 0.7;
@@ -294,6 +330,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
     treeType = other.treeType;
     randomBasis = other.randomBasis;
     q = other.q;
+    singlePrecision = other.singlePrecision;
     leafSize = other.leafSize;
     tau = other.tau;
     rho = other.rho;
@@ -313,6 +350,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
     treeType = other.treeType;
     randomBasis = other.randomBasis;
     q = std::move(other.q);
+    singlePrecision = other.singlePrecision;
     leafSize = other.leafSize;
     tau = other.tau;
     rho = other.rho;
@@ -321,6 +359,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
     // Reset parameters of the other model.
     other.treeType = TreeTypes::KD_TREE;
     other.randomBasis = false;
+    other.singlePrecision = false;
     other.leafSize = 20;
     other.tau = 0.0;
     other.rho = 0.7;
@@ -340,7 +379,7 @@ NSModel<SortPolicy>::~NSModel()
 //! Serialize the kNN model.
 template<typename SortPolicy>
 template<typename Archive>
-void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
+void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t version)
 {
   ar(CEREAL_NVP(treeType));
   ar(CEREAL_NVP(randomBasis));
@@ -349,115 +388,142 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
   ar(CEREAL_NVP(tau));
   ar(CEREAL_NVP(rho));
 
+  // Models before version 1 were always held in double precision.
+  if (cereal::is_loading<Archive>() && version == 0)
+    singlePrecision = false;
+  else
+    ar(CEREAL_NVP(singlePrecision));
+
   // This should never happen, but just in case, be clean with memory.
   if (cereal::is_loading<Archive>())
     InitializeModel(DUAL_TREE_MODE, 0.0); // Values will be overwritten.
 
   // Avoid polymorphic serialization by explicitly serializing the correct type.
+  if (singlePrecision)
+    SerializeSearch<arma::fmat>(ar);
+  else
+    SerializeSearch<arma::mat>(ar);
+}
+
+//! Serialize nSearch, which holds datasets of type MatType.
+template<typename SortPolicy>
+template<typename MatType, typename Archive>
+void NSModel<SortPolicy>::SerializeSearch(Archive& ar)
+{
   switch (treeType)
   {
     case KD_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, KDTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, KDTree>&>(*nSearch);
+        LeafSizeNSWrapper<SortPolicy, KDTree, MatType>& typedSearch =
+            dynamic_cast<LeafSizeNSWrapper<SortPolicy, KDTree, MatType>&>(
+            *nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case COVER_TREE:
       {
-        NSWrapper<SortPolicy, StandardCoverTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, StandardCoverTree>&>(*nSearch);
+        NSWrapper<SortPolicy, StandardCoverTree, MatType>& typedSearch =
+            dynamic_cast<NSWrapper<SortPolicy, StandardCoverTree, MatType>&>(
+            *nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case R_TREE:
       {
-        NSWrapper<SortPolicy, RTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, RTree>&>(*nSearch);
+        NSWrapper<SortPolicy, RTree, MatType>& typedSearch =
+            dynamic_cast<NSWrapper<SortPolicy, RTree, MatType>&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case R_STAR_TREE:
       {
-        NSWrapper<SortPolicy, RStarTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, RStarTree>&>(*nSearch);
+        NSWrapper<SortPolicy, RStarTree, MatType>& typedSearch =
+            dynamic_cast<NSWrapper<SortPolicy, RStarTree, MatType>&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case BALL_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, BallTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, BallTree>&>(*nSearch);
+        LeafSizeNSWrapper<SortPolicy, BallTree, MatType>& typedSearch =
+            dynamic_cast<LeafSizeNSWrapper<SortPolicy, BallTree, MatType>&>(
+            *nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case X_TREE:
       {
-        NSWrapper<SortPolicy, XTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, XTree>&>(*nSearch);
+        NSWrapper<SortPolicy, XTree, MatType>& typedSearch =
+            dynamic_cast<NSWrapper<SortPolicy, XTree, MatType>&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case HILBERT_R_TREE:
       {
-        NSWrapper<SortPolicy, HilbertRTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, HilbertRTree>&>(*nSearch);
+        NSWrapper<SortPolicy, HilbertRTree, MatType>& typedSearch =
+            dynamic_cast<NSWrapper<SortPolicy, HilbertRTree, MatType>&>(
+            *nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case R_PLUS_TREE:
       {
-        NSWrapper<SortPolicy, RPlusTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, RPlusTree>&>(*nSearch);
+        NSWrapper<SortPolicy, RPlusTree, MatType>& typedSearch =
+            dynamic_cast<NSWrapper<SortPolicy, RPlusTree, MatType>&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case R_PLUS_PLUS_TREE:
       {
-        NSWrapper<SortPolicy, RPlusPlusTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, RPlusPlusTree>&>(*nSearch);
+        NSWrapper<SortPolicy, RPlusPlusTree, MatType>& typedSearch =
+            dynamic_cast<NSWrapper<SortPolicy, RPlusPlusTree, MatType>&>(
+            *nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case SPILL_TREE:
       {
-        SpillNSWrapper<SortPolicy>& typedSearch =
-            dynamic_cast<SpillNSWrapper<SortPolicy>&>(*nSearch);
+        SpillNSWrapper<SortPolicy, MatType>& typedSearch =
+            dynamic_cast<SpillNSWrapper<SortPolicy, MatType>&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case VP_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, VPTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, VPTree>&>(*nSearch);
+        LeafSizeNSWrapper<SortPolicy, VPTree, MatType>& typedSearch =
+            dynamic_cast<LeafSizeNSWrapper<SortPolicy, VPTree, MatType>&>(
+            *nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case RP_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, RPTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, RPTree>&>(*nSearch);
+        LeafSizeNSWrapper<SortPolicy, RPTree, MatType>& typedSearch =
+            dynamic_cast<LeafSizeNSWrapper<SortPolicy, RPTree, MatType>&>(
+            *nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case MAX_RP_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, MaxRPTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, MaxRPTree>&>(*nSearch);
+        LeafSizeNSWrapper<SortPolicy, MaxRPTree, MatType>& typedSearch =
+            dynamic_cast<LeafSizeNSWrapper<SortPolicy, MaxRPTree, MatType>&>(
+            *nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case UB_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, UBTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, UBTree>&>(*nSearch);
+        LeafSizeNSWrapper<SortPolicy, UBTree, MatType>& typedSearch =
+            dynamic_cast<LeafSizeNSWrapper<SortPolicy, UBTree, MatType>&>(
+            *nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case OCTREE:
       {
-        LeafSizeNSWrapper<SortPolicy, Octree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, Octree>&>(*nSearch);
+        LeafSizeNSWrapper<SortPolicy, Octree, MatType>& typedSearch =
+            dynamic_cast<LeafSizeNSWrapper<SortPolicy, Octree, MatType>&>(
+            *nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
@@ -506,55 +572,76 @@ void NSModel<SortPolicy>::InitializeModel(const NeighborSearchMode searchMode,
   if (nSearch)
     delete nSearch;
 
+  if (singlePrecision)
+    InitializeSearch<arma::fmat>(searchMode, epsilon);
+  else
+    InitializeSearch<arma::mat>(searchMode, epsilon);
+}
+
+//! Initialize nSearch with datasets of type MatType.
+template<typename SortPolicy>
+template<typename MatType>
+void NSModel<SortPolicy>::InitializeSearch(const NeighborSearchMode searchMode,
+                                           const double epsilon)
+{
   switch (treeType)
   {
     case KD_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, KDTree>(searchMode, epsilon);
+      nSearch = new LeafSizeNSWrapper<SortPolicy, KDTree, MatType>(
+          searchMode, epsilon);
       break;
     case COVER_TREE:
-      nSearch = new NSWrapper<SortPolicy, StandardCoverTree>(searchMode,
-          epsilon);
+      nSearch = new NSWrapper<SortPolicy, StandardCoverTree, MatType>(
+          searchMode, epsilon);
       break;
     case R_TREE:
-      nSearch = new NSWrapper<SortPolicy, RTree>(searchMode, epsilon);
+      nSearch = new NSWrapper<SortPolicy, RTree, MatType>(searchMode, epsilon);
       break;
     case R_STAR_TREE:
-      nSearch = new NSWrapper<SortPolicy, RStarTree>(searchMode, epsilon);
+      nSearch = new NSWrapper<SortPolicy, RStarTree, MatType>(
+          searchMode, epsilon);
       break;
     case BALL_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, BallTree>(searchMode,
-          epsilon);
+      nSearch = new LeafSizeNSWrapper<SortPolicy, BallTree, MatType>(
+          searchMode, epsilon);
       break;
     case X_TREE:
-      nSearch = new NSWrapper<SortPolicy, XTree>(searchMode, epsilon);
+      nSearch = new NSWrapper<SortPolicy, XTree, MatType>(searchMode, epsilon);
       break;
     case HILBERT_R_TREE:
-      nSearch = new NSWrapper<SortPolicy, HilbertRTree>(searchMode, epsilon);
+      nSearch = new NSWrapper<SortPolicy, HilbertRTree, MatType>(
+          searchMode, epsilon);
       break;
     case R_PLUS_TREE:
-      nSearch = new NSWrapper<SortPolicy, RPlusTree>(searchMode, epsilon);
+      nSearch = new NSWrapper<SortPolicy, RPlusTree, MatType>(
+          searchMode, epsilon);
       break;
     case R_PLUS_PLUS_TREE:
-      nSearch = new NSWrapper<SortPolicy, RPlusPlusTree>(searchMode, epsilon);
+      nSearch = new NSWrapper<SortPolicy, RPlusPlusTree, MatType>(
+          searchMode, epsilon);
       break;
     case VP_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, VPTree>(searchMode, epsilon);
+      nSearch = new LeafSizeNSWrapper<SortPolicy, VPTree, MatType>(
+          searchMode, epsilon);
       break;
     case RP_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, RPTree>(searchMode, epsilon);
+      nSearch = new LeafSizeNSWrapper<SortPolicy, RPTree, MatType>(
+          searchMode, epsilon);
       break;
     case MAX_RP_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, MaxRPTree>(searchMode,
-          epsilon);
+      nSearch = new LeafSizeNSWrapper<SortPolicy, MaxRPTree, MatType>(
+          searchMode, epsilon);
       break;
     case SPILL_TREE:
-      nSearch = new SpillNSWrapper<SortPolicy>(searchMode, epsilon);
+      nSearch = new SpillNSWrapper<SortPolicy, MatType>(searchMode, epsilon);
       break;
     case UB_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, UBTree>(searchMode, epsilon);
+      nSearch = new LeafSizeNSWrapper<SortPolicy, UBTree, MatType>(
+          searchMode, epsilon);
       break;
     case OCTREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, Octree>(searchMode, epsilon);
+      nSearch = new LeafSizeNSWrapper<SortPolicy, Octree, MatType>(
+          searchMode, epsilon);
       break;
   }
 }
@@ -0,0 +1,175 @@
+/**
+ * @file methods/neighbor_search/ns_query_server.hpp
+ *
+ * A long-lived query server around NSModel.  The model is loaded once, and
+ * then batches of query points are read from an input stream (such as a pipe or
+ * a socket stream) and the neighbors and distances are written to an output
+ * stream in a simple binary format.  Requests that are already waiting on the
+ * input stream are coalesced into a single search.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NS_QUERY_SERVER_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NS_QUERY_SERVER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "ns_model.hpp"
+
+namespace mlpack {
+
+/**
+ * The NSQueryServer answers neighbor search requests for an already-trained
+ * NSModel, so that the model only has to be deserialized once.  All values in
+ * the binary protocol are stored in the native byte order, and every integer is
+ * stored as a 64-bit unsigned integer.
+ *
+ * A request is made of the header `[k, rows, cols]`, followed by the
+ * `rows * cols` query points as doubles, in column-major order.
+ *
+ * A response is made of the header `[status, k, cols]`.  If `status` is 0, the
+ * header is followed by the `k * cols` neighbor indices and then the `k * cols`
+ * distances as doubles, both in column-major order.  Otherwise, the header is
+ * followed by the length of an error message and its characters.
+ *
+ * A request whose header asks for more than MaxElements query values gets an
+ * error response, and then the server stops reading, since the rest of the
+ * stream can't be trusted.
+ *
+ * Responses are written in the same order as the requests.  Whenever more
+ * requests are already buffered on the input stream, they are read too (up to
+ * the given maximum number of points), and all of them are answered with one
+ * search, which amortizes the cost of building the query tree.
+ *
+ * @code
+ * NSModel<NearestNeighborSort> model;
+ * data::Load("model.bin", "knn_model", model, true);
+ *
+ * NSQueryServer<NearestNeighborSort> server(model);
+ * server.Serve(std::cin, std::cout);
+ * @endcode
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ */
+template<typename SortPolicy>
+class NSQueryServer
+{
+ public:
+  //! The maximum number of values that a request or a response may hold.
+  static constexpr size_t MaxElements = ((size_t) 1) << 28;
+  //! The maximum length of an error message in a response.
+  static constexpr size_t MaxMessageLength = ((size_t) 1) << 20;
+
+  /**
+   * Create the server for the given model.  The model is not copied, and must
+   * stay valid while the server is used.
+   *
+   * @param model Trained model to answer queries with.
+   * @param maxBatchSize Maximum number of query points to coalesce into a
+   *     single search.
+   */
+  NSQueryServer(NSModel<SortPolicy>& model,
+                const size_t maxBatchSize = 4096);
+
+  /**
+   * Answer requests from the given input stream until it ends, writing the
+   * responses to the given output stream.
+   *
+   * @param in Stream to read requests from.
+   * @param out Stream to write responses to.
+   * @return Number of requests that were answered.
+   */
+  size_t Serve(std::istream& in, std::ostream& out);
+
+  /**
+   * Write a request for the k neighbors of each point in the given query set.
+   *
+   * @param out Stream to write the request to.
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   */
+  static void WriteRequest(std::ostream& out,
+                           const arma::mat& querySet,
+                           const size_t k);
+
+  /**
+   * Read a response from the given stream.  If the server reported an error,
+   * std::invalid_argument is thrown with the error message.  A
+   * std::invalid_argument is also thrown if the header of the response asks
+   * for more than MaxElements values or MaxMessageLength characters.
+   *
+   * @param in Stream to read the response from.
+   * @param neighbors Matrix to store the neighbor indices in.
+   * @param distances Matrix to store the neighbor distances in.
+   * @return false if the stream ended before a full response could be read.
+   */
+  static bool ReadResponse(std::istream& in,
+                           arma::Mat<size_t>& neighbors,
+                           arma::mat& distances);
+
+  //! Get the maximum number of query points in a single search.
+  size_t MaxBatchSize() const { return maxBatchSize; }
+  //! Modify the maximum number of query points in a single search.
+  size_t& MaxBatchSize() { return maxBatchSize; }
+
+  //! Get the number of searches performed by the last call to Serve().
+  size_t Batches() const { return batches; }
+
+ private:
+  //! A single request read from the input stream.
+  struct Request
+  {
+    //! Number of neighbors requested.
+    size_t k;
+    //! The query points.
+    arma::mat querySet;
+    //! If the header of the request is invalid, the reason; otherwise empty.
+    std::string error;
+  };
+
+  /**
+   * Read a single request from the given stream.  Returns false if the stream
+   * ended before a full request could be read.  If the header asks for too
+   * many values, nothing more is read and the error of the request is set.
+   */
+  static bool ReadRequest(std::istream& in, Request& request);
+
+  //! Return whether a matrix of the given size holds at most MaxElements
+  //! values.
+  static bool ValidSize(const uint64_t rows, const uint64_t cols);
+
+  //! Answer all the given requests with one search.
+  void AnswerBatch(const std::vector<Request>& batch, std::ostream& out);
+
+  //! Write an error response.
+  static void WriteError(std::ostream& out,
+                         const size_t k,
+                         const size_t cols,
+                         const std::string& message);
+
+  //! Write the given values to the stream in binary.
+  template<typename T>
+  static void WriteValues(std::ostream& out, const T* values, const size_t n);
+
+  //! Read the given number of values from the stream; false on failure.
+  template<typename T>
+  static bool ReadValues(std::istream& in, T* values, const size_t n);
+
+  //! The model used to answer requests.
+  NSModel<SortPolicy>& model;
+  //! The maximum number of query points in a single search.
+  size_t maxBatchSize;
+  //! The number of searches performed during the last call to Serve().
+  size_t batches;
+  //! Timers for the model (these are not enabled).
+  util::Timers timers;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "ns_query_server_impl.hpp"
+
+#endif
@@ -0,0 +1,307 @@
+/**
+ * @file methods/neighbor_search/ns_query_server_impl.hpp
+ *
+ * Implementation of the NSQueryServer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NS_QUERY_SERVER_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NS_QUERY_SERVER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ns_query_server.hpp"
+
+namespace mlpack {
+
+template<typename SortPolicy>
+NSQueryServer<SortPolicy>::NSQueryServer(NSModel<SortPolicy>& model,
+                                         const size_t maxBatchSize) :
+    model(model),
+    maxBatchSize(maxBatchSize),
+    batches(0)
+{
+  // Nothing to do.
+}
+
+template<typename SortPolicy>
+size_t NSQueryServer<SortPolicy>::Serve(std::istream& in, std::ostream& out)
+{
+  batches = 0;
+  size_t requests = 0;
+  bool done = false;
+  std::vector<Request> batch;
+  while (!done)
+  {
+    // Wait for the next request.
+    batch.resize(1);
+    if (!ReadRequest(in, batch[0]))
+      break;
+
+    // After a malformed request, the position of the next request is unknown,
+    // so it is answered and the server stops.
+    done = !batch[0].error.empty();
+
+    // Coalesce every other request that has already arrived, as long as the
+    // batch is not too large.
+    size_t batchSize = batch[0].querySet.n_cols;
+    while (!done && batchSize < maxBatchSize && in.rdbuf()->in_avail() > 0)
+    {
+      Request request;
+      if (!ReadRequest(in, request))
+      {
+        done = true;
+        break;
+      }
+
+      done = !request.error.empty();
+      batchSize += request.querySet.n_cols;
+      batch.push_back(std::move(request));
+    }
+
+    AnswerBatch(batch, out);
+    out.flush();
+    requests += batch.size();
+  }
+
+  return requests;
+}
+
+template<typename SortPolicy>
+void NSQueryServer<SortPolicy>::WriteRequest(std::ostream& out,
+                                             const arma::mat& querySet,
+                                             const size_t k)
+{
+  const uint64_t header[3] = { (uint64_t) k, (uint64_t) querySet.n_rows,
+      (uint64_t) querySet.n_cols };
+  WriteValues(out, header, 3);
+  WriteValues(out, querySet.memptr(), querySet.n_elem);
+  out.flush();
+}
+
+template<typename SortPolicy>
+bool NSQueryServer<SortPolicy>::ReadResponse(std::istream& in,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  uint64_t header[3];
+  if (!ReadValues(in, header, 3))
+    return false;
+
+  if (header[0] != 0)
+  {
+    uint64_t length;
+    if (!ReadValues(in, &length, 1))
+      return false;
+
+    if (length > MaxMessageLength)
+    {
+      throw std::invalid_argument("NSQueryServer::ReadResponse(): error "
+          "message of the response is too long!");
+    }
+
+    std::string message(length, ' ');
+    if (!ReadValues(in, &message[0], length))
+      return false;
+
+    throw std::invalid_argument(message);
+  }
+
+  if (!ValidSize(header[1], header[2]))
+  {
+    throw std::invalid_argument("NSQueryServer::ReadResponse(): response "
+        "holds too many values!");
+  }
+
+  const size_t k = header[1];
+  const size_t cols = header[2];
+  arma::Mat<arma::u64> neighbors64(k, cols);
+  distances.set_size(k, cols);
+  if (!ReadValues(in, neighbors64.memptr(), neighbors64.n_elem) ||
+      !ReadValues(in, distances.memptr(), distances.n_elem))
+    return false;
+
+  neighbors = arma::conv_to<arma::Mat<size_t>>::from(neighbors64);
+  return true;
+}
+
+template<typename SortPolicy>
+bool NSQueryServer<SortPolicy>::ReadRequest(std::istream& in, Request& request)
+{
+  uint64_t header[3];
+  if (!ReadValues(in, header, 3))
+    return false;
+
+  request.k = header[0];
+  if (!ValidSize(header[1], header[2]))
+  {
+    std::ostringstream oss;
+    oss << "query set of size " << header[1] << " x " << header[2] << " holds "
+        << "more than " << MaxElements << " values";
+    request.querySet.reset();
+    request.error = oss.str();
+    return true;
+  }
+
+  request.querySet.set_size(header[1], header[2]);
+  return ReadValues(in, request.querySet.memptr(), request.querySet.n_elem);
+}
+
+template<typename SortPolicy>
+bool NSQueryServer<SortPolicy>::ValidSize(const uint64_t rows,
+                                          const uint64_t cols)
+{
+  // The product is only computed once it can't overflow.
+  return rows <= MaxElements && cols <= MaxElements &&
+      (rows == 0 || cols <= MaxElements / rows);
+}
+
+template<typename SortPolicy>
+void NSQueryServer<SortPolicy>::AnswerBatch(const std::vector<Request>& batch,
+                                            std::ostream& out)
+{
+  // Malformed requests keep their error.  If the model can't be used, every
+  // other request gets the same error.
+  std::vector<std::string> errors(batch.size());
+  for (size_t i = 0; i < batch.size(); ++i)
+    errors[i] = batch[i].error;
+
+  size_t dimensionality = 0;
+  size_t numReferences = 0;
+  try
+  {
+    dimensionality = model.Dimensionality();
+    numReferences = model.NumPoints();
+  }
+  catch (std::exception& e)
+  {
+    for (size_t i = 0; i < batch.size(); ++i)
+      if (errors[i].empty())
+        errors[i] = e.what();
+  }
+
+  // Check each request, and collect all the valid query points.
+  size_t numQueries = 0;
+  size_t maxK = 0;
+  for (size_t i = 0; i < batch.size(); ++i)
+  {
+    if (!errors[i].empty())
+      continue;
+
+    std::ostringstream oss;
+    if (batch[i].querySet.n_rows != dimensionality)
+    {
+      oss << "query set dimensionality (" << batch[i].querySet.n_rows << ") is "
+          << "not equal to reference set dimensionality (" << dimensionality
+          << ")";
+    }
+    else if (batch[i].k == 0 || batch[i].k > numReferences)
+    {
+      oss << "requested value of k (" << batch[i].k << ") must be between 1 "
+          << "and the number of points in the reference set (" << numReferences
+          << ")";
+    }
+    else
+    {
+      numQueries += batch[i].querySet.n_cols;
+      maxK = std::max(maxK, batch[i].k);
+    }
+
+    errors[i] = oss.str();
+  }
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  if (numQueries > 0)
+  {
+    arma::mat querySet(dimensionality, numQueries);
+    size_t col = 0;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+      if (!errors[i].empty() || batch[i].querySet.n_cols == 0)
+        continue;
+
+      querySet.cols(col, col + batch[i].querySet.n_cols - 1) =
+          batch[i].querySet;
+      col += batch[i].querySet.n_cols;
+    }
+
+    // The neighbors are sorted, so searching for the largest k in the batch
+    // also gives the results for every smaller k.
+    try
+    {
+      model.Search(timers, std::move(querySet), maxK, neighbors, distances);
+      ++batches;
+    }
+    catch (std::exception& e)
+    {
+      for (size_t i = 0; i < batch.size(); ++i)
+        if (errors[i].empty())
+          errors[i] = e.what();
+    }
+  }
+
+  size_t col = 0;
+  for (size_t i = 0; i < batch.size(); ++i)
+  {
+    const size_t k = batch[i].k;
+    const size_t cols = batch[i].querySet.n_cols;
+    if (!errors[i].empty())
+    {
+      WriteError(out, k, cols, errors[i]);
+      continue;
+    }
+
+    const uint64_t header[3] = { 0, (uint64_t) k, (uint64_t) cols };
+    WriteValues(out, header, 3);
+    if (cols > 0)
+    {
+      const arma::Mat<arma::u64> neighbors64 = arma::conv_to<
+          arma::Mat<arma::u64>>::from(neighbors.submat(0, col, k - 1,
+          col + cols - 1));
+      const arma::mat requestDistances = distances.submat(0, col, k - 1,
+          col + cols - 1);
+      WriteValues(out, neighbors64.memptr(), neighbors64.n_elem);
+      WriteValues(out, requestDistances.memptr(), requestDistances.n_elem);
+    }
+
+    col += cols;
+  }
+}
+
+template<typename SortPolicy>
+void NSQueryServer<SortPolicy>::WriteError(std::ostream& out,
+                                           const size_t k,
+                                           const size_t cols,
+                                           const std::string& message)
+{
+  const uint64_t header[4] = { 1, (uint64_t) k, (uint64_t) cols,
+      (uint64_t) message.size() };
+  WriteValues(out, header, 4);
+  WriteValues(out, message.data(), message.size());
+}
+
+template<typename SortPolicy>
+template<typename T>
+void NSQueryServer<SortPolicy>::WriteValues(std::ostream& out,
+                                            const T* values,
+                                            const size_t n)
+{
+  out.write(reinterpret_cast<const char*>(values), n * sizeof(T));
+}
+
+template<typename SortPolicy>
+template<typename T>
+bool NSQueryServer<SortPolicy>::ReadValues(std::istream& in,
+                                           T* values,
+                                           const size_t n)
+{
+  in.read(reinterpret_cast<char*>(values), n * sizeof(T));
+  return (size_t) in.gcount() == n * sizeof(T);
+}
+
+} // namespace mlpack
+
+#endif
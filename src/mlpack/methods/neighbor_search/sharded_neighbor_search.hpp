@@ -0,0 +1,191 @@
+/**
+ * @file methods/neighbor_search/sharded_neighbor_search.hpp
+ *
+ * Exact k-nearest-neighbor search on a reference set that is sharded across
+ * several processes, each of which holds a tree on its own shard.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_HPP
+
+#include <mlpack/core.hpp>
+#include "neighbor_search_stat.hpp"
+#include "sort_policies/nearest_neighbor_sort.hpp"
+#include "neighbor_search_rules.hpp"
+
+namespace mlpack {
+
+/**
+ * ShardedNeighborSearch answers exact neighbor search queries on a reference
+ * set that is partitioned across several processes (see Partition()), given an
+ * all-reduce policy (see LocalAllReduce and MPIAllReduce).  Each process builds
+ * a tree on its own shard, and every process calls Search() together.
+ *
+ * The query points of the first process are broadcast to all processes and
+ * split into one batch per process.  The search is made in as many rounds as
+ * there are processes: in each round, every process searches its shard for a
+ * different batch, and the results of all batches are then shared.  Each batch
+ * thus visits every shard once, and the search of each shard starts from the
+ * k best neighbors found on the previous shards, so that later shards prune
+ * with the k-th distance found so far and only look for better neighbors.  All
+ * processes are busy in every round, and only query points and results are
+ * communicated.  The neighbor indices of the results are indices in the
+ * original dataset.
+ *
+ * @code
+ * MPI_Init(&argc, &argv);
+ * MPIAllReduce allReduce;
+ *
+ * // The first process loads the dataset and partitions it; then each process
+ * // gets (or loads) its own shard and the original indices of its points.
+ * arma::mat shard;
+ * arma::uvec shardIndices;
+ * // ...
+ *
+ * ShardedNeighborSearch<NearestNeighborSort, MPIAllReduce> knn(
+ *     std::move(shard), std::move(shardIndices), allReduce);
+ *
+ * // Only the query points of the first process are used.
+ * arma::mat queries;
+ * // ...
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * knn.Search(queries, 5, neighbors, distances);
+ *
+ * MPI_Finalize();
+ * @endcode
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam AllReduceType All-reduce policy over the processes.
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ * @tparam TreeType The tree type to build on each shard.
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         typename AllReduceType = LocalAllReduce,
+         typename MetricType = EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = KDTree>
+class ShardedNeighborSearch
+{
+ public:
+  //! Convenience typedef.
+  typedef TreeType<MetricType, NeighborSearchStat<SortPolicy>, MatType> Tree;
+
+  /**
+   * Build the tree on the shard of the reference set of this process.
+   *
+   * @param referenceShard Points of the shard of this process.
+   * @param shardIndices Index of each point of the shard in the original
+   *     dataset.
+   * @param allReduce All-reduce policy over the processes.
+   * @param metric Instantiated metric.
+   */
+  ShardedNeighborSearch(MatType referenceShard,
+                        arma::uvec shardIndices,
+                        const AllReduceType& allReduce = AllReduceType(),
+                        const MetricType metric = MetricType());
+
+  //! Copying is not supported.
+  ShardedNeighborSearch(const ShardedNeighborSearch& other) = delete;
+  //! Copying is not supported.
+  ShardedNeighborSearch& operator=(const ShardedNeighborSearch& other) =
+      delete;
+
+  //! Free the tree.
+  ~ShardedNeighborSearch();
+
+  /**
+   * Find the k neighbors in the whole reference set of each query point of the
+   * first process.  Every process must call Search() with the same k, and gets
+   * the same results.
+   *
+   * @param querySet Set of query points (only used on the first process).
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the original indices of the neighbors in.
+   * @param distances Matrix to store the distances of the neighbors in.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Partition the given dataset into the given number of shards, either at
+   * random, or by the top splits of a random projection tree, so that each
+   * shard holds a region of the space and most queries find their neighbors on
+   * a few shards.  The shards have sizes within one of each other.
+   *
+   * @param data Dataset to partition.
+   * @param numShards Number of shards.
+   * @param shards Will be set to the sorted indices of the points of each
+   *     shard.
+   * @param randomProjection If true, split the dataset with random
+   *     projections; otherwise, assign the points to shards at random.
+   */
+  static void Partition(const MatType& data,
+                        const size_t numShards,
+                        std::vector<arma::uvec>& shards,
+                        const bool randomProjection = false);
+
+  //! Get the reference points of the shard of this process.
+  const MatType& ReferenceShard() const { return tree->Dataset(); }
+  //! Get the original index of each point of the shard of this process.
+  const arma::uvec& ShardIndices() const { return shardIndices; }
+
+  //! Get the number of base cases of this process during the last search.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of scores of this process during the last search.
+  size_t Scores() const { return scores; }
+
+ private:
+  /**
+   * Search the shard for the query points [begin, end), starting from the
+   * neighbors in the given results, and store the new neighbors there.  The
+   * first k rows of the results hold the distances, and the last k rows the
+   * original indices of the neighbors plus one (0 means no neighbor).
+   */
+  void SearchShard(const MatType& querySet,
+                   const size_t k,
+                   const size_t begin,
+                   const size_t end,
+                   arma::mat& results);
+
+  /**
+   * Split the points with the given indices into the given number of shards
+   * along random projections, recursively.
+   */
+  static void SplitShards(const MatType& data,
+                          const arma::uvec& indices,
+                          const size_t numShards,
+                          std::vector<arma::uvec>& shards);
+
+  //! The tree built on the shard of this process.
+  Tree* tree;
+  //! Mappings from the indices of the points in the tree to the shard.
+  std::vector<size_t> oldFromNewReferences;
+  //! Original index of each point of the shard.
+  arma::uvec shardIndices;
+  //! All-reduce policy over the processes.
+  AllReduceType allReduce;
+  //! Instantiated metric.
+  MetricType metric;
+
+  //! Number of base cases during the last search.
+  size_t baseCases;
+  //! Number of scores during the last search.
+  size_t scores;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "sharded_neighbor_search_impl.hpp"
+
+#endif
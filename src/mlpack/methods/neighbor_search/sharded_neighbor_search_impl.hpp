@@ -0,0 +1,301 @@
+/**
+ * @file methods/neighbor_search/sharded_neighbor_search_impl.hpp
+ *
+ * Implementation of neighbor search on a sharded reference set.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sharded_neighbor_search.hpp"
+
+namespace mlpack {
+
+template<typename SortPolicy,
+         typename AllReduceType,
+         typename MetricType,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+ShardedNeighborSearch<SortPolicy, AllReduceType, MetricType, MatType,
+    TreeType>::ShardedNeighborSearch(MatType referenceShard,
+                                     arma::uvec shardIndicesIn,
+                                     const AllReduceType& allReduce,
+                                     const MetricType metric) :
+    tree(NULL),
+    shardIndices(std::move(shardIndicesIn)),
+    allReduce(allReduce),
+    metric(metric),
+    baseCases(0),
+    scores(0)
+{
+  util::CheckSameSizes(referenceShard, shardIndices,
+      "ShardedNeighborSearch::ShardedNeighborSearch()", "shard indices");
+
+  tree = BuildTree<Tree>(std::move(referenceShard), oldFromNewReferences);
+}
+
+template<typename SortPolicy,
+         typename AllReduceType,
+         typename MetricType,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+ShardedNeighborSearch<SortPolicy, AllReduceType, MetricType, MatType,
+    TreeType>::~ShardedNeighborSearch()
+{
+  delete tree;
+}
+
+template<typename SortPolicy,
+         typename AllReduceType,
+         typename MetricType,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+void ShardedNeighborSearch<SortPolicy, AllReduceType, MetricType, MatType,
+    TreeType>::Search(const MatType& querySet,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances)
+{
+  const size_t numProcesses = allReduce.Size();
+  const size_t rank = allReduce.Rank();
+
+  if (k == 0)
+  {
+    throw std::invalid_argument("ShardedNeighborSearch::Search(): k must be "
+        "positive!");
+  }
+
+  // The total size of the reference set must allow for k neighbors.
+  arma::mat totalSize(1, 1);
+  totalSize[0] = tree->Dataset().n_cols;
+  allReduce.Sum(totalSize);
+  if (k > (size_t) totalSize[0])
+  {
+    std::ostringstream oss;
+    oss << "ShardedNeighborSearch::Search(): requested value of k (" << k
+        << ") is greater than the number of points in the reference set ("
+        << (size_t) totalSize[0] << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Broadcast the query points of the first process.
+  MatType queries;
+  if (numProcesses == 1)
+  {
+    queries = querySet;
+  }
+  else
+  {
+    arma::mat shape(2, 1);
+    shape[0] = querySet.n_rows;
+    shape[1] = querySet.n_cols;
+    AllReduceBroadcast(allReduce, shape);
+
+    arma::mat broadcastQueries((size_t) shape[0], (size_t) shape[1]);
+    if (rank == 0)
+      broadcastQueries = arma::conv_to<arma::mat>::from(querySet);
+    AllReduceBroadcast(allReduce, broadcastQueries);
+    queries = arma::conv_to<MatType>::from(broadcastQueries);
+  }
+  util::CheckSameDimensionality(queries, tree->Dataset(),
+      "ShardedNeighborSearch::Search()", "query set");
+
+  arma::mat results(2 * k, queries.n_cols);
+  results.rows(0, k - 1).fill(SortPolicy::WorstDistance());
+  results.rows(k, 2 * k - 1).zeros();
+
+  // In round r, process p searches batch (p + r) of its shard, so every batch
+  // visits every shard, on a different process in each round.
+  baseCases = 0;
+  scores = 0;
+  arma::mat roundResults;
+  for (size_t r = 0; r < numProcesses; ++r)
+  {
+    const size_t b = (rank + r) % numProcesses;
+    const size_t begin = (b * queries.n_cols) / numProcesses;
+    const size_t end = ((b + 1) * queries.n_cols) / numProcesses;
+    SearchShard(queries, k, begin, end, results);
+
+    if (numProcesses > 1)
+    {
+      // Each batch was searched by one process only, so summing the results
+      // of that batch with zeros from the other processes shares them.
+      roundResults.zeros(2 * k, queries.n_cols);
+      if (begin != end)
+        roundResults.cols(begin, end - 1) = results.cols(begin, end - 1);
+      allReduce.Sum(roundResults);
+      results.swap(roundResults);
+    }
+  }
+
+  neighbors.set_size(k, queries.n_cols);
+  distances = results.rows(0, k - 1);
+  for (size_t i = 0; i < queries.n_cols; ++i)
+    for (size_t j = 0; j < k; ++j)
+      neighbors(j, i) = (size_t) results(k + j, i) - 1;
+
+  Log::Info << baseCases << " base cases were calculated on this shard."
+      << std::endl;
+}
+
+template<typename SortPolicy,
+         typename AllReduceType,
+         typename MetricType,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+void ShardedNeighborSearch<SortPolicy, AllReduceType, MetricType, MatType,
+    TreeType>::SearchShard(const MatType& querySet,
+                           const size_t k,
+                           const size_t begin,
+                           const size_t end,
+                           arma::mat& results)
+{
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+  typedef typename Tree::template SingleTreeTraverser<RuleType> TraverserType;
+
+  // The candidates found on other shards are stored with an index past the
+  // points of this shard, so that they can be told apart afterwards.
+  const size_t numPoints = tree->Dataset().n_cols;
+  const size_t blockSize = 256;
+  const size_t numBlocks = (end - begin + blockSize - 1) / blockSize;
+  size_t blockBaseCases = 0, blockScores = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:blockBaseCases, blockScores) num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t blockBegin = begin + b * blockSize;
+    const size_t blockEnd = std::min(end, blockBegin + blockSize);
+
+    RuleType rules(tree->Dataset(), querySet, blockBegin,
+        blockEnd - blockBegin, k, metric);
+    for (size_t i = blockBegin; i < blockEnd; ++i)
+    {
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (results(k + j, i) != 0.0)
+        {
+          rules.AddCandidate(i, numPoints + (size_t) results(k + j, i) - 1,
+              results(j, i));
+        }
+      }
+    }
+
+    TraverserType traverser(rules);
+    for (size_t i = blockBegin; i < blockEnd; ++i)
+      traverser.Traverse(i, *tree);
+
+    blockBaseCases += rules.BaseCases();
+    blockScores += rules.Scores();
+
+    arma::Mat<size_t> blockNeighbors;
+    arma::mat blockDistances;
+    rules.GetResults(blockNeighbors, blockDistances);
+
+    // Map the neighbors found on this shard to their original indices.
+    for (size_t i = 0; i < blockNeighbors.n_cols; ++i)
+    {
+      for (size_t j = 0; j < k; ++j)
+      {
+        const size_t neighbor = blockNeighbors(j, i);
+        double index;
+        if (neighbor == size_t() - 1)
+          index = 0.0;
+        else if (neighbor >= numPoints)
+          index = (double) (neighbor - numPoints + 1);
+        else if (oldFromNewReferences.empty())
+          index = (double) (shardIndices[neighbor] + 1);
+        else
+          index = (double) (shardIndices[oldFromNewReferences[neighbor]] + 1);
+
+        results(j, blockBegin + i) = blockDistances(j, i);
+        results(k + j, blockBegin + i) = index;
+      }
+    }
+  }
+
+  baseCases += blockBaseCases;
+  scores += blockScores;
+}
+
+template<typename SortPolicy,
+         typename AllReduceType,
+         typename MetricType,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+void ShardedNeighborSearch<SortPolicy, AllReduceType, MetricType, MatType,
+    TreeType>::Partition(const MatType& data,
+                         const size_t numShards,
+                         std::vector<arma::uvec>& shards,
+                         const bool randomProjection)
+{
+  if (numShards == 0)
+  {
+    throw std::invalid_argument("ShardedNeighborSearch::Partition(): the "
+        "number of shards must be positive!");
+  }
+
+  shards.clear();
+  if (randomProjection)
+  {
+    SplitShards(data, arma::regspace<arma::uvec>(0, data.n_cols - 1),
+        numShards, shards);
+  }
+  else
+  {
+    const arma::uvec order = arma::randperm(data.n_cols);
+    for (size_t s = 0; s < numShards; ++s)
+    {
+      const size_t begin = (s * data.n_cols) / numShards;
+      const size_t end = ((s + 1) * data.n_cols) / numShards;
+      shards.push_back(begin == end ? arma::uvec() :
+          arma::sort(order.subvec(begin, end - 1)));
+    }
+  }
+}
+
+template<typename SortPolicy,
+         typename AllReduceType,
+         typename MetricType,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+void ShardedNeighborSearch<SortPolicy, AllReduceType, MetricType, MatType,
+    TreeType>::SplitShards(const MatType& data,
+                           const arma::uvec& indices,
+                           const size_t numShards,
+                           std::vector<arma::uvec>& shards)
+{
+  if (numShards == 1)
+  {
+    shards.push_back(arma::sort(indices));
+    return;
+  }
+
+  // Split at the quantile of the projections that gives each side a number of
+  // points proportional to its number of shards.
+  const size_t leftShards = numShards / 2;
+  const size_t leftCount = (indices.n_elem * leftShards) / numShards;
+
+  arma::vec direction(data.n_rows, arma::fill::randn);
+  direction /= arma::norm(direction);
+  arma::vec projections(indices.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    projections[i] = arma::dot(direction, data.col(indices[i]));
+
+  const arma::uvec order = arma::sort_index(projections);
+  const arma::uvec sorted = indices.elem(order);
+  SplitShards(data, leftCount == 0 ? arma::uvec() :
+      arma::uvec(sorted.head(leftCount)), leftShards, shards);
+  SplitShards(data, leftCount == indices.n_elem ? arma::uvec() :
+      arma::uvec(sorted.tail(indices.n_elem - leftCount)),
+      numShards - leftShards, shards);
+}
+
+} // namespace mlpack
+
+#endif
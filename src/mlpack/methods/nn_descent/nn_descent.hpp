@@ -0,0 +1,212 @@
+/**
+ * @file methods/nn_descent/nn_descent.hpp
+ *
+ * Definition of the NNDescent class, which builds an approximate k-nearest
+ * neighbor graph of a dataset with the NN-Descent algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NN_DESCENT_NN_DESCENT_HPP
+#define MLPACK_METHODS_NN_DESCENT_NN_DESCENT_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traversal.hpp>
+
+namespace mlpack {
+
+/**
+ * NNDescent computes an approximation of the all-points k-nearest neighbor
+ * graph of a dataset (the result of a monochromatic `NeighborSearch`), for
+ * high-dimensional data where tree-based searches are slow.  Each point starts
+ * with k neighbors, either random or taken from the leaves of a random
+ * projection tree built with `RPTreeMaxSplit`; then, in each iteration, the
+ * neighbors of the neighbors of each point are tried as its new neighbors
+ * ("local joins"), until almost no neighbor lists change.
+ *
+ * The local joins are run in parallel with OpenMP; the random numbers come
+ * from `RandomStream`s with one stream per point, so the result only depends
+ * on the random seed, and not on the number of threads.
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{dong2011efficient,
+ *   title = {Efficient K-Nearest Neighbor Graph Construction for Generic
+ *       Similarity Measures},
+ *   author = {Dong, Wei and Moses, Charikar and Li, Kai},
+ *   booktitle = {Proceedings of the 20th International Conference on World
+ *       Wide Web (WWW '11)},
+ *   pages = {577--586},
+ *   year = {2011}
+ * }
+ * @endcode
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ */
+template<typename MetricType = EuclideanDistance,
+         typename MatType = arma::mat>
+class NNDescent
+{
+ public:
+  /**
+   * Create the NNDescent object without a reference set; Train() must be
+   * called before Search().
+   *
+   * @param maxIterations Maximum number of iterations of local joins.
+   * @param sampleRate Fraction of the k neighbors of each point that are used
+   *     as new candidates in each iteration (rho in the paper).
+   * @param tolerance The search stops when fewer than `tolerance * N * k`
+   *     neighbors are updated in an iteration (delta in the paper).
+   * @param treeInit If true, the first neighbors come from the leaves of a
+   *     random projection tree; otherwise they are random.
+   * @param metric An optional instance of the MetricType class.
+   */
+  NNDescent(const size_t maxIterations = 10,
+            const double sampleRate = 1.0,
+            const double tolerance = 0.001,
+            const bool treeInit = true,
+            const MetricType metric = MetricType());
+
+  /**
+   * Create the NNDescent object on the given reference set.  To avoid a copy,
+   * pass the reference set with std::move().
+   *
+   * @param referenceSet Set of points to build the graph of.
+   * @param maxIterations Maximum number of iterations of local joins.
+   * @param sampleRate Fraction of the k neighbors of each point that are used
+   *     as new candidates in each iteration (rho in the paper).
+   * @param tolerance The search stops when fewer than `tolerance * N * k`
+   *     neighbors are updated in an iteration (delta in the paper).
+   * @param treeInit If true, the first neighbors come from the leaves of a
+   *     random projection tree; otherwise they are random.
+   * @param metric An optional instance of the MetricType class.
+   */
+  NNDescent(MatType referenceSet,
+            const size_t maxIterations = 10,
+            const double sampleRate = 1.0,
+            const double tolerance = 0.001,
+            const bool treeInit = true,
+            const MetricType metric = MetricType());
+
+  /**
+   * Set the reference set.  To avoid a copy, pass it with std::move().
+   *
+   * @param referenceSet Set of points to build the graph of.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Compute the approximate k nearest neighbors of each point of the reference
+   * set (not counting the point itself).  As for `NeighborSearch`, column i of
+   * `neighbors` and `distances` holds the neighbors of point i and their
+   * distances, from nearest to furthest.
+   *
+   * @param k Number of neighbors to find.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Get the reference set.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the fraction of neighbors sampled in each iteration.
+  double SampleRate() const { return sampleRate; }
+  //! Modify the fraction of neighbors sampled in each iteration.
+  double& SampleRate() { return sampleRate; }
+
+  //! Get the tolerance of the stopping criterion.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance of the stopping criterion.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether the first neighbors come from a random projection tree.
+  bool TreeInit() const { return treeInit; }
+  //! Modify whether the first neighbors come from a random projection tree.
+  bool& TreeInit() { return treeInit; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+  //! Get the number of iterations done by the last search.
+  size_t Iterations() const { return iterations; }
+  //! Get the number of distance evaluations done by the last search.
+  size_t DistanceEvaluations() const { return distanceEvaluations; }
+
+ private:
+  //! A candidate neighbor found by a local join.
+  struct Update
+  {
+    size_t first;
+    size_t second;
+    double distance;
+  };
+
+  //! Try `candidate` at the given distance as a neighbor of `point`; return
+  //! whether the neighbors of `point` changed.
+  bool Push(const size_t point,
+            const size_t candidate,
+            const double distance,
+            const bool isNew);
+
+  //! Take the first neighbors of each point from the leaves of a random
+  //! projection tree.
+  void TreeInitialize(const size_t k);
+
+  //! Fill the missing neighbors of each point with random points.
+  void RandomInitialize(const size_t k, const uint64_t seed);
+
+  //! Compute the new and old candidates of each point for one iteration.
+  void Candidates(const size_t k,
+                  const size_t sampleSize,
+                  const uint64_t seed,
+                  const size_t iteration,
+                  std::vector<std::vector<size_t>>& newCandidates,
+                  std::vector<std::vector<size_t>>& oldCandidates);
+
+  //! The reference set.
+  MatType referenceSet;
+  //! Maximum number of iterations.
+  size_t maxIterations;
+  //! Fraction of neighbors sampled in each iteration.
+  double sampleRate;
+  //! Tolerance of the stopping criterion.
+  double tolerance;
+  //! Whether the first neighbors come from a random projection tree.
+  bool treeInit;
+  //! The metric.
+  MetricType metric;
+
+  //! Number of iterations done by the last search.
+  size_t iterations;
+  //! Number of distance evaluations done by the last search.
+  size_t distanceEvaluations;
+
+  //! The neighbors of each point, as max-heaps (one per column).
+  arma::Mat<size_t> heapIndices;
+  //! The distances to the neighbors of each point.
+  arma::mat heapDistances;
+  //! Whether each neighbor has not been used in a local join yet.
+  arma::Mat<unsigned char> heapNew;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "nn_descent_impl.hpp"
+
+#endif
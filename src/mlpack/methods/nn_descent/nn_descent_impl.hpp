@@ -0,0 +1,413 @@
+/**
+ * @file methods/nn_descent/nn_descent_impl.hpp
+ *
+ * Implementation of the NNDescent class, which builds an approximate k-nearest
+ * neighbor graph of a dataset with the NN-Descent algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NN_DESCENT_NN_DESCENT_IMPL_HPP
+#define MLPACK_METHODS_NN_DESCENT_NN_DESCENT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "nn_descent.hpp"
+
+namespace mlpack {
+
+template<typename MetricType, typename MatType>
+NNDescent<MetricType, MatType>::NNDescent(const size_t maxIterations,
+                                          const double sampleRate,
+                                          const double tolerance,
+                                          const bool treeInit,
+                                          const MetricType metric) :
+    maxIterations(maxIterations),
+    sampleRate(sampleRate),
+    tolerance(tolerance),
+    treeInit(treeInit),
+    metric(metric),
+    iterations(0),
+    distanceEvaluations(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename MatType>
+NNDescent<MetricType, MatType>::NNDescent(MatType referenceSet,
+                                          const size_t maxIterations,
+                                          const double sampleRate,
+                                          const double tolerance,
+                                          const bool treeInit,
+                                          const MetricType metric) :
+    referenceSet(std::move(referenceSet)),
+    maxIterations(maxIterations),
+    sampleRate(sampleRate),
+    tolerance(tolerance),
+    treeInit(treeInit),
+    metric(metric),
+    iterations(0),
+    distanceEvaluations(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::Train(MatType referenceSet)
+{
+  this->referenceSet = std::move(referenceSet);
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::Search(const size_t k,
+                                            arma::Mat<size_t>& neighbors,
+                                            arma::mat& distances)
+{
+  const size_t n = referenceSet.n_cols;
+  if (k >= n && k > 0)
+  {
+    std::ostringstream oss;
+    oss << "NNDescent::Search(): requested value of k (" << k << ") must be "
+        << "less than the number of points in the reference set (" << n
+        << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (sampleRate <= 0.0)
+  {
+    throw std::invalid_argument("NNDescent::Search(): the sample rate must be "
+        "positive!");
+  }
+
+  neighbors.set_size(k, n);
+  distances.set_size(k, n);
+  iterations = 0;
+  distanceEvaluations = 0;
+
+  // If the user asked for 0 nearest neighbors... we're done.
+  if (k == 0)
+    return;
+
+  // An invalid neighbor (index n) is further away than any point.
+  heapIndices.set_size(k, n);
+  heapIndices.fill(n);
+  heapDistances.set_size(k, n);
+  heapDistances.fill(DBL_MAX);
+  heapNew.ones(k, n);
+
+  const uint64_t seed = RandomStreamSeed();
+  if (treeInit)
+    TreeInitialize(k);
+  RandomInitialize(k, seed);
+
+  const size_t sampleSize = std::max((size_t) std::ceil(sampleRate * k),
+      (size_t) 1);
+  std::vector<std::vector<size_t>> newCandidates(n), oldCandidates(n);
+
+  // The local joins are split into contiguous blocks of points, and the
+  // updates of each block are applied in order, so that the result does not
+  // depend on the number of threads.
+  const size_t numTasks = NumParallelTasks(n);
+  std::vector<std::vector<Update>> updates(numTasks);
+  while (iterations < maxIterations)
+  {
+    Candidates(k, sampleSize, seed, iterations, newCandidates, oldCandidates);
+    ++iterations;
+
+    size_t evaluations = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:evaluations) \
+        num_threads((int) NumThreads())
+    for (size_t t = 0; t < numTasks; ++t)
+    {
+      updates[t].clear();
+      const size_t begin = t * n / numTasks;
+      const size_t end = (t + 1) * n / numTasks;
+      for (size_t q = begin; q < end; ++q)
+      {
+        const std::vector<size_t>& fresh = newCandidates[q];
+        const std::vector<size_t>& old = oldCandidates[q];
+        for (size_t i = 0; i < fresh.size(); ++i)
+        {
+          // New candidates are joined with each other and with the old ones;
+          // old candidates were already joined with each other.
+          for (size_t j = i + 1; j < fresh.size() + old.size(); ++j)
+          {
+            const size_t a = fresh[i];
+            const size_t b = (j < fresh.size()) ? fresh[j] :
+                old[j - fresh.size()];
+            if (a == b)
+              continue;
+
+            const double d = metric.Evaluate(referenceSet.col(a),
+                referenceSet.col(b));
+            ++evaluations;
+
+            // The heaps are not modified during the joins, so this only skips
+            // updates that cannot succeed.
+            if (d < heapDistances(0, a) || d < heapDistances(0, b))
+              updates[t].push_back({ a, b, d });
+          }
+        }
+      }
+    }
+    distanceEvaluations += evaluations;
+
+    size_t changes = 0;
+    for (size_t t = 0; t < numTasks; ++t)
+    {
+      for (const Update& u : updates[t])
+      {
+        changes += Push(u.first, u.second, u.distance, true);
+        changes += Push(u.second, u.first, u.distance, true);
+      }
+    }
+
+    Log::Debug << "NNDescent::Search(): iteration " << iterations << ": "
+        << changes << " neighbors updated." << std::endl;
+    if (changes <= tolerance * n * k)
+      break;
+  }
+
+  // Sort the neighbors of each point by distance.
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t q = 0; q < n; ++q)
+  {
+    std::vector<std::pair<double, size_t>> sorted(k);
+    for (size_t i = 0; i < k; ++i)
+      sorted[i] = std::make_pair(heapDistances(i, q), heapIndices(i, q));
+    std::sort(sorted.begin(), sorted.end());
+
+    for (size_t i = 0; i < k; ++i)
+    {
+      distances(i, q) = sorted[i].first;
+      neighbors(i, q) = sorted[i].second;
+    }
+  }
+
+  Log::Info << "NNDescent::Search(): built the " << k << "-nearest neighbor "
+      << "graph of " << n << " points in " << iterations << " iterations ("
+      << distanceEvaluations << " distance evaluations)." << std::endl;
+}
+
+template<typename MetricType, typename MatType>
+bool NNDescent<MetricType, MatType>::Push(const size_t point,
+                                          const size_t candidate,
+                                          const double distance,
+                                          const bool isNew)
+{
+  const size_t k = heapIndices.n_rows;
+  size_t* indices = heapIndices.colptr(point);
+  double* dists = heapDistances.colptr(point);
+  unsigned char* flags = heapNew.colptr(point);
+
+  // The root of the heap is the furthest neighbor.
+  if (distance >= dists[0])
+    return false;
+
+  for (size_t i = 0; i < k; ++i)
+  {
+    if (indices[i] == candidate)
+      return false;
+  }
+
+  // Replace the furthest neighbor, and sift the new one down.
+  size_t i = 0;
+  while (2 * i + 1 < k)
+  {
+    const size_t left = 2 * i + 1;
+    const size_t right = left + 1;
+    const size_t largest = (right < k && dists[right] > dists[left]) ? right :
+        left;
+    if (dists[largest] <= distance)
+      break;
+
+    indices[i] = indices[largest];
+    dists[i] = dists[largest];
+    flags[i] = flags[largest];
+    i = largest;
+  }
+
+  indices[i] = candidate;
+  dists[i] = distance;
+  flags[i] = isNew ? 1 : 0;
+  return true;
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::TreeInitialize(const size_t k)
+{
+  typedef MaxRPTree<MetricType, EmptyStatistic, MatType> TreeType;
+
+  // The tree copies (and reorders) the dataset; each leaf holds a few more
+  // points than the number of neighbors.
+  std::vector<size_t> oldFromNew;
+  TreeType tree(referenceSet, oldFromNew, std::max(k + 1, (size_t) 20));
+
+  std::vector<const TreeType*> leaves;
+  std::vector<const TreeType*> stack(1, &tree);
+  while (!stack.empty())
+  {
+    const TreeType* node = stack.back();
+    stack.pop_back();
+    if (node->IsLeaf())
+    {
+      leaves.push_back(node);
+      continue;
+    }
+
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      stack.push_back(&node->Child(i));
+  }
+
+  // Every point is in exactly one leaf, so the leaves can be processed in
+  // parallel.
+  const MatType& dataset = tree.Dataset();
+  size_t evaluations = 0;
+  #pragma omp parallel for schedule(dynamic) reduction(+:evaluations) \
+      num_threads((int) NumThreads())
+  for (size_t l = 0; l < leaves.size(); ++l)
+  {
+    const size_t begin = leaves[l]->Begin();
+    const size_t end = begin + leaves[l]->Count();
+    for (size_t i = begin; i < end; ++i)
+    {
+      for (size_t j = i + 1; j < end; ++j)
+      {
+        const double d = metric.Evaluate(dataset.col(i), dataset.col(j));
+        ++evaluations;
+        Push(oldFromNew[i], oldFromNew[j], d, true);
+        Push(oldFromNew[j], oldFromNew[i], d, true);
+      }
+    }
+  }
+
+  distanceEvaluations += evaluations;
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::RandomInitialize(const size_t k,
+                                                      const uint64_t seed)
+{
+  const size_t n = referenceSet.n_cols;
+  size_t evaluations = 0;
+
+  #pragma omp parallel for schedule(static) reduction(+:evaluations) \
+      num_threads((int) NumThreads())
+  for (size_t q = 0; q < n; ++q)
+  {
+    size_t filled = 0;
+    for (size_t i = 0; i < k; ++i)
+      filled += (heapIndices(i, q) != n);
+
+    RandomStream stream(seed, q);
+    for (size_t trial = 0; trial < 4 * k && filled < k; ++trial)
+    {
+      const size_t candidate = stream.RandInt(n);
+      if (candidate == q)
+        continue;
+
+      ++evaluations;
+      filled += Push(q, candidate, metric.Evaluate(referenceSet.col(q),
+          referenceSet.col(candidate)), true);
+    }
+
+    // Small datasets may need every point.
+    for (size_t candidate = 0; candidate < n && filled < k; ++candidate)
+    {
+      if (candidate == q)
+        continue;
+
+      ++evaluations;
+      filled += Push(q, candidate, metric.Evaluate(referenceSet.col(q),
+          referenceSet.col(candidate)), true);
+    }
+  }
+
+  distanceEvaluations += evaluations;
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::Candidates(
+    const size_t k,
+    const size_t sampleSize,
+    const uint64_t seed,
+    const size_t iteration,
+    std::vector<std::vector<size_t>>& newCandidates,
+    std::vector<std::vector<size_t>>& oldCandidates)
+{
+  const size_t n = referenceSet.n_cols;
+
+  // Move up to `sampleSize` random elements of `pool` to the end of `out`.
+  auto sample = [sampleSize](std::vector<size_t>& pool,
+                             RandomStream& stream,
+                             std::vector<size_t>& out)
+  {
+    const size_t count = std::min(sampleSize, pool.size());
+    for (size_t i = 0; i < count; ++i)
+    {
+      std::swap(pool[i], pool[i + stream.RandInt(pool.size() - i)]);
+      out.push_back(pool[i]);
+    }
+  };
+
+  // The neighbors that were not used in a local join yet are new candidates
+  // (if sampled), and the others are old candidates.  Streams 0 to n - 1 were
+  // used by the random initialization.
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t q = 0; q < n; ++q)
+  {
+    newCandidates[q].clear();
+    oldCandidates[q].clear();
+
+    std::vector<size_t> fresh;
+    for (size_t i = 0; i < k; ++i)
+    {
+      if (heapIndices(i, q) == n)
+        continue;
+      else if (heapNew(i, q))
+        fresh.push_back(i);
+      else
+        oldCandidates[q].push_back(heapIndices(i, q));
+    }
+
+    RandomStream stream(seed, (2 * iteration + 1) * n + q);
+    std::vector<size_t> sampled;
+    sample(fresh, stream, sampled);
+    for (const size_t i : sampled)
+    {
+      newCandidates[q].push_back(heapIndices(i, q));
+      heapNew(i, q) = 0;
+    }
+  }
+
+  // The reverse neighbors are collected serially, so that their order does not
+  // depend on the number of threads.
+  std::vector<std::vector<size_t>> reverseNew(n), reverseOld(n);
+  for (size_t q = 0; q < n; ++q)
+  {
+    for (const size_t c : newCandidates[q])
+      reverseNew[c].push_back(q);
+    for (const size_t c : oldCandidates[q])
+      reverseOld[c].push_back(q);
+  }
+
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t q = 0; q < n; ++q)
+  {
+    RandomStream stream(seed, (2 * iteration + 2) * n + q);
+    sample(reverseNew[q], stream, newCandidates[q]);
+    sample(reverseOld[q], stream, oldCandidates[q]);
+
+    std::sort(newCandidates[q].begin(), newCandidates[q].end());
+    newCandidates[q].erase(std::unique(newCandidates[q].begin(),
+        newCandidates[q].end()), newCandidates[q].end());
+    std::sort(oldCandidates[q].begin(), oldCandidates[q].end());
+    oldCandidates[q].erase(std::unique(oldCandidates[q].begin(),
+        oldCandidates[q].end()), oldCandidates[q].end());
+  }
+}
+
+} // namespace mlpack
+
+#endif
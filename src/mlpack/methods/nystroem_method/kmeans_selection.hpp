@@ -19,7 +19,11 @@
 namespace mlpack {
 
 /**
- * Implementation of the kmeans sampling scheme.
+ * Implementation of the kmeans sampling scheme.  Any KMeans type can be used
+ * for the clustering; its MatType must be the type of the dataset.  Only the
+ * centroids are computed, so no final assignment pass over the dataset is
+ * made.  On large datasets, MiniBatchKMeansSelection is much cheaper, since
+ * each of its iterations only visits a mini-batch of the points.
  *
  * @tparam ClusteringType Type of clustering.
  * @tparam maxIterations Maximum number of iterations allowed before giving up.
@@ -36,19 +40,31 @@ class KMeansSelection
    * @param m Number of points to select.
    * @return Matrix pointer in which centroids are stored.
    */
-  const static arma::mat* Select(const arma::mat& data, const size_t m)
+  template<typename MatType>
+  const static MatType* Select(const MatType& data, const size_t m)
   {
-    arma::Row<size_t> assignments;
-    arma::mat* centroids = new arma::mat;
+    arma::mat centroids;
 
     // Perform the K-Means clustering method.
     ClusteringType kmeans(maxIterations);
-    kmeans.Cluster(data, m, assignments, *centroids);
+    kmeans.Cluster(data, m, centroids);
 
-    return centroids;
+    return new MatType(arma::conv_to<MatType>::from(centroids));
   }
 };
 
+/**
+ * Select the points with mini-batch k-means (see MiniBatchKMeans), whose cost
+ * per iteration does not depend on the size of the dataset.
+ *
+ * @tparam MatType Type of the dataset.
+ * @tparam maxIterations Maximum number of mini-batch iterations.
+ */
+template<typename MatType = arma::mat, size_t maxIterations = 100>
+using MiniBatchKMeansSelection = KMeansSelection<KMeans<EuclideanDistance,
+    SampleInitialization, AllowEmptyClusters, MiniBatchKMeans, MatType>,
+    maxIterations>;
+
 } // namespace mlpack
 
 #endif
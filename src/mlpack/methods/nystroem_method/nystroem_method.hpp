@@ -23,9 +23,24 @@
 
 namespace mlpack {
 
+/**
+ * The Nystroem method approximates the kernel matrix K of a dataset with
+ * G * G^T, where G is computed from the kernel values between all points and a
+ * small set of selected points (or centroids), given by the point selection
+ * policy.  The kernel matrices are computed in parallel tiles, with the batch
+ * Evaluate() method of the kernel if it has one (see KernelMatrix()).
+ *
+ * @tparam KernelType Type of kernel to use.
+ * @tparam PointSelectionPolicy Policy to select the points; see
+ *     OrderedSelection, RandomSelection, KMeansSelection and
+ *     MiniBatchKMeansSelection.
+ * @tparam MatType Type of the dataset and of the output (arma::mat or
+ *     arma::fmat).
+ */
 template<
   typename KernelType,
-  typename PointSelectionPolicy = KMeansSelection<>
+  typename PointSelectionPolicy = KMeansSelection<>,
+  typename MatType = arma::mat
 >
 class NystroemMethod
 {
@@ -38,7 +53,7 @@ class NystroemMethod
    * @param kernel Kernel to be used for computation.
    * @param rank Rank to be used for matrix approximation.
    */
-  NystroemMethod(const arma::mat& data, KernelType& kernel, const size_t rank);
+  NystroemMethod(const MatType& data, KernelType& kernel, const size_t rank);
 
   /**
    * Apply the low-rank factorization to obtain an output matrix G such that
@@ -46,7 +61,7 @@ class NystroemMethod
    *
    * @param output Matrix to store kernel approximation into.
    */
-  void Apply(arma::mat& output);
+  void Apply(MatType& output);
 
   /**
    * Construct the kernel matrix with matrix that contains the selected points.
@@ -55,9 +70,9 @@ class NystroemMethod
    * @param miniKernel to store the constructed mini-kernel matrix in.
    * @param semiKernel to store the constructed semi-kernel matrix in.
    */
-  void GetKernelMatrix(const arma::mat* data,
-                       arma::mat& miniKernel,
-                       arma::mat& semiKernel);
+  void GetKernelMatrix(const MatType* data,
+                       MatType& miniKernel,
+                       MatType& semiKernel);
 
   /**
    * Construct the kernel matrix with the selected points.
@@ -67,12 +82,12 @@ class NystroemMethod
    * @param semiKernel to store the constructed semi-kernel matrix in.
    */
   void GetKernelMatrix(const arma::Col<size_t>& selectedPoints,
-                       arma::mat& miniKernel,
-                       arma::mat& semiKernel);
+                       MatType& miniKernel,
+                       MatType& semiKernel);
 
  private:
   //! The reference dataset.
-  const arma::mat& data;
+  const MatType& data;
   //! The locally stored kernel, if it is necessary.
   KernelType& kernel;
   //! Rank used for matrix approximation.
@@ -18,9 +18,11 @@
 
 namespace mlpack {
 
-template<typename KernelType, typename PointSelectionPolicy>
-NystroemMethod<KernelType, PointSelectionPolicy>::NystroemMethod(
-    const arma::mat& data,
+template<typename KernelType,
+         typename PointSelectionPolicy,
+         typename MatType>
+NystroemMethod<KernelType, PointSelectionPolicy, MatType>::NystroemMethod(
+    const MatType& data,
     KernelType& kernel,
     const size_t rank) :
     data(data),
@@ -28,74 +30,74 @@ NystroemMethod<KernelType, PointSelectionPolicy>::NystroemMethod(
     rank(rank)
 { }
 
-template<typename KernelType, typename PointSelectionPolicy>
-void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
-    const arma::mat* selectedData,
-    arma::mat& miniKernel,
-    arma::mat& semiKernel)
+template<typename KernelType,
+         typename PointSelectionPolicy,
+         typename MatType>
+void NystroemMethod<KernelType, PointSelectionPolicy, MatType>::
+GetKernelMatrix(const MatType* selectedData,
+                MatType& miniKernel,
+                MatType& semiKernel)
 {
   // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      miniKernel(i, j) = kernel.Evaluate(selectedData->col(i),
-                                         selectedData->col(j));
+  SymmetricKernelMatrix(kernel, *selectedData, miniKernel);
 
   // Construct semi-kernel matrix with interactions between selected data and
-  // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         selectedData->col(j));
+  // all points.  Both matrices are computed in tiles, in parallel.
+  KernelMatrix(kernel, data, *selectedData, semiKernel);
+
   // Clean the memory.
   delete selectedData;
 }
 
-template<typename KernelType, typename PointSelectionPolicy>
-void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
-    const arma::Col<size_t>& selectedPoints,
-    arma::mat& miniKernel,
-    arma::mat& semiKernel)
+template<typename KernelType,
+         typename PointSelectionPolicy,
+         typename MatType>
+void NystroemMethod<KernelType, PointSelectionPolicy, MatType>::
+GetKernelMatrix(const arma::Col<size_t>& selectedPoints,
+                MatType& miniKernel,
+                MatType& semiKernel)
 {
+  // Gather the selected points, so that the kernel matrices can be computed
+  // in tiles.
+  const MatType selectedData = data.cols(selectedPoints);
+
   // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-  {
-    for (size_t j = 0; j < rank; ++j)
-    {
-      miniKernel(i, j) = kernel.Evaluate(data.col(selectedPoints(i)),
-                                         data.col(selectedPoints(j)));
-    }
-  }
+  SymmetricKernelMatrix(kernel, selectedData, miniKernel);
 
   // Construct semi-kernel matrix with interactions between selected points and
   // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         data.col(selectedPoints(j)));
+  KernelMatrix(kernel, data, selectedData, semiKernel);
 }
 
-template<typename KernelType, typename PointSelectionPolicy>
-void NystroemMethod<KernelType, PointSelectionPolicy>::Apply(arma::mat& output)
+template<typename KernelType,
+         typename PointSelectionPolicy,
+         typename MatType>
+void NystroemMethod<KernelType, PointSelectionPolicy, MatType>::Apply(
+    MatType& output)
 {
-  arma::mat miniKernel(rank, rank);
-  arma::mat semiKernel(data.n_cols, rank);
+  typedef typename MatType::elem_type ElemType;
+
+  MatType miniKernel(rank, rank);
+  MatType semiKernel(data.n_cols, rank);
 
   GetKernelMatrix(PointSelectionPolicy::Select(data, rank), miniKernel,
                   semiKernel);
 
   // Singular value decomposition mini-kernel matrix.
-  arma::mat U, V;
-  arma::vec s;
+  MatType U, V;
+  arma::Col<ElemType> s;
   arma::svd(U, s, V, miniKernel);
 
   // Construct the output matrix.  We need to have special handling when
-  // miniKernel ended up being low-rank.
-  arma::mat normalization = arma::diagmat(1.0 / sqrt(s));
+  // miniKernel ended up being low-rank.  The normalization is applied to the
+  // columns of U, to avoid the multiplication with a diagonal matrix.
+  arma::Col<ElemType> normalization = ElemType(1) / arma::sqrt(s);
   for (size_t i = 0; i < s.n_elem; ++i)
     if (std::abs(s[i]) <= 1e-20)
-      normalization(i, i) = 0.0;
+      normalization[i] = 0;
 
-  output = semiKernel * U * normalization * V;
+  U.each_row() %= normalization.t();
+  output = semiKernel * (U * V);
 }
 
 } // namespace mlpack
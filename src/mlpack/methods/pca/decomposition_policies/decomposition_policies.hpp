@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_DECOMPOSITION_POLICIES_HPP
 
 #include "exact_svd_method.hpp"
+#include "incremental_svd_method.hpp"
 #include "quic_svd_method.hpp"
 #include "randomized_block_krylov_method.hpp"
 #include "randomized_svd_method.hpp"
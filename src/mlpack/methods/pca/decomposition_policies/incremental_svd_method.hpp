@@ -0,0 +1,294 @@
+/**
+ * @file methods/pca/decomposition_policies/incremental_svd_method.hpp
+ *
+ * Implementation of the incremental SVD method for use in the Principal
+ * Components Analysis method, which can also be updated one chunk of a dataset
+ * at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_SVD_METHOD_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_SVD_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * Implementation of the incremental SVD policy, which computes the principal
+ * components of a dataset one chunk of points at a time, with the sequential
+ * Karhunen-Loeve update of Ross et al. (with the correction for the change of
+ * the mean).  The mean, the principal components and the singular values of
+ * the centered data seen so far are kept; each call to Update() computes the
+ * thin SVD of a d x (k + m + 1) matrix, where k is the number of components
+ * kept and m the number of points of the chunk.  Only O(d (k + m)) memory is
+ * needed, whatever the number of points.
+ *
+ * If all components are kept (the default), the result is the same as the
+ * exact SVD; otherwise, it is an approximation that is exact when the data has
+ * rank at most k.
+ *
+ * When used as the decomposition policy of PCA, the centered data is processed
+ * in chunks of blockSize points.  To reduce datasets that do not fit in
+ * memory, the policy can also be used directly:
+ *
+ * @code
+ * data::ChunkedLoader loader("huge_dataset.csv", 100000);
+ * IncrementalSVDPolicy pca(10);
+ * pca.Train(loader);
+ *
+ * // Then project each chunk.
+ * arma::mat chunk, transformedChunk;
+ * loader.Reset();
+ * while (loader.Next(chunk))
+ *   pca.Transform(chunk, transformedChunk);
+ * @endcode
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @article{ross2008incremental,
+ *   title   = {Incremental Learning for Robust Visual Tracking},
+ *   author  = {Ross, David A. and Lim, Jongwoo and Lin, Ruei-Sung and
+ *              Yang, Ming-Hsuan},
+ *   journal = {International Journal of Computer Vision},
+ *   volume  = {77},
+ *   number  = {1--3},
+ *   pages   = {125--141},
+ *   year    = {2008}
+ * }
+ * @endcode
+ */
+class IncrementalSVDPolicy
+{
+ public:
+  /**
+   * Create the incremental SVD policy.
+   *
+   * @param rank Number of principal components to keep; 0 keeps all of them.
+   * @param blockSize Number of points of each chunk processed by Apply().
+   */
+  IncrementalSVDPolicy(const size_t rank = 0,
+                       const size_t blockSize = 1000) :
+      rank(rank),
+      blockSize(blockSize),
+      numPoints(0)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Principal Component Analysis to the provided data set using the
+   * incremental SVD.  Any previous state is discarded.
+   *
+   * @param * (data) Data matrix.
+   * @param centeredData Centered data matrix.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param * (rank) Rank of the decomposition.
+   */
+  void Apply(const arma::mat& /* data */,
+             const arma::mat& centeredData,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t /* rank */)
+  {
+    if (blockSize == 0)
+    {
+      throw std::invalid_argument("IncrementalSVDPolicy::Apply(): the block "
+          "size must be positive!");
+    }
+
+    Reset();
+    for (size_t begin = 0; begin < centeredData.n_cols; begin += blockSize)
+    {
+      const size_t end = std::min(begin + blockSize,
+          (size_t) centeredData.n_cols) - 1;
+      Update(centeredData.cols(begin, end));
+    }
+
+    eigVal = EigenValues();
+    eigvec = components;
+
+    // Project the samples to the principals.
+    transformedData = trans(eigvec) * centeredData;
+  }
+
+  /**
+   * Update the mean, the principal components and the singular values with
+   * the given chunk of points.
+   *
+   * @param chunk Points to add, one column per point.
+   */
+  void Update(const arma::mat& chunk)
+  {
+    if (chunk.n_cols == 0)
+      return;
+
+    if (numPoints > 0 && chunk.n_rows != mean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "IncrementalSVDPolicy::Update(): the chunk has " << chunk.n_rows
+          << " dimensions, but the previous points have " << mean.n_elem
+          << " dimensions!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    const size_t k = singularValues.n_elem;
+    const size_t m = chunk.n_cols;
+    const double n = (double) numPoints;
+    const arma::vec chunkMean = arma::mean(chunk, 1);
+
+    // The scatter of all the points is the scatter of [U S, C, c], where U S
+    // are the current components scaled by their singular values, C the
+    // centered chunk, and c accounts for the difference between the means.
+    arma::mat stacked(chunk.n_rows, k + m + (numPoints > 0 ? 1 : 0));
+    if (k > 0)
+      stacked.cols(0, k - 1) = components * arma::diagmat(singularValues);
+    stacked.cols(k, k + m - 1) = chunk.each_col() - chunkMean;
+    if (numPoints > 0)
+    {
+      stacked.col(k + m) = std::sqrt(n * m / (n + m)) * (chunkMean - mean);
+      mean = (n * mean + m * chunkMean) / (n + m);
+    }
+    else
+    {
+      mean = chunkMean;
+    }
+    numPoints += m;
+
+    arma::mat u, v;
+    arma::vec s;
+    if (!arma::svd_econ(u, s, v, stacked, 'l'))
+    {
+      throw std::runtime_error("IncrementalSVDPolicy::Update(): the singular "
+          "value decomposition failed!");
+    }
+
+    // Keep only the requested number of components.
+    const size_t maxRank = (rank == 0) ? (size_t) chunk.n_rows :
+        std::min(rank, (size_t) chunk.n_rows);
+    const size_t keep = std::min(maxRank, (size_t) s.n_elem);
+    components = u.cols(0, keep - 1);
+    singularValues = s.subvec(0, keep - 1);
+  }
+
+  /**
+   * Reset the policy and update it with all the points read by the given
+   * loader (such as a data::ChunkedLoader), one chunk at a time.  The loader
+   * is reset first.
+   *
+   * @param loader Loader of the dataset, with a Reset() and a Next() method.
+   * @return The number of points that were read.
+   */
+  template<typename LoaderType>
+  size_t Train(LoaderType& loader)
+  {
+    Reset();
+    loader.Reset();
+
+    arma::mat chunk;
+    while (loader.Next(chunk))
+      Update(chunk);
+
+    return numPoints;
+  }
+
+  /**
+   * Project the given points on the principal components.
+   *
+   * @param data Points to project, one column per point.
+   * @param transformedData Matrix to put the projected points into.
+   */
+  void Transform(const arma::mat& data, arma::mat& transformedData) const
+  {
+    if (data.n_rows != mean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "IncrementalSVDPolicy::Transform(): the points have "
+          << data.n_rows << " dimensions, but the model has " << mean.n_elem
+          << " dimensions!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    transformedData = trans(components) * (data.each_col() - mean);
+  }
+
+  //! Forget all the points seen so far.
+  void Reset()
+  {
+    numPoints = 0;
+    mean.clear();
+    components.clear();
+    singularValues.clear();
+  }
+
+  /**
+   * Get the eigenvalues of the covariance matrix of the points seen so far,
+   * for each principal component.
+   */
+  arma::vec EigenValues() const
+  {
+    // The covariance matrix is X * X' / (N - 1).
+    if (numPoints < 2)
+      return arma::vec(singularValues.n_elem, arma::fill::zeros);
+    return arma::square(singularValues) / (double) (numPoints - 1);
+  }
+
+  //! Get the number of principal components to keep (0 keeps all of them).
+  size_t Rank() const { return rank; }
+  //! Modify the number of principal components to keep (0 keeps all of them).
+  size_t& Rank() { return rank; }
+
+  //! Get the number of points of each chunk processed by Apply().
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of points of each chunk processed by Apply().
+  size_t& BlockSize() { return blockSize; }
+
+  //! Get the number of points seen so far.
+  size_t NumPoints() const { return numPoints; }
+  //! Get the mean of the points seen so far.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the principal components (one column per component).
+  const arma::mat& Components() const { return components; }
+  //! Get the singular values of the centered points seen so far.
+  const arma::vec& SingularValues() const { return singularValues; }
+
+  /**
+   * Serialize the policy, with the state of the decomposition.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(rank));
+    ar(CEREAL_NVP(blockSize));
+    ar(CEREAL_NVP(numPoints));
+    ar(CEREAL_NVP(mean));
+    ar(CEREAL_NVP(components));
+    ar(CEREAL_NVP(singularValues));
+  }
+
+ private:
+  //! Number of principal components to keep.
+  size_t rank;
+  //! Number of points of each chunk processed by Apply().
+  size_t blockSize;
+
+  //! Number of points seen so far.
+  size_t numPoints;
+  //! Mean of the points seen so far.
+  arma::vec mean;
+  //! Principal components.
+  arma::mat components;
+  //! Singular values of the centered points seen so far.
+  arma::vec singularValues;
+};
+
+} // namespace mlpack
+
+#endif
@@ -32,11 +32,16 @@ class RandomizedBlockKrylovSVDPolicy
    * @param maxIterations Number of iterations for the power method
    *        (Default: 2).
    * @param blockSize The block size, must be >= rank (Default: rank + 10).
+   * @param chunkSize If nonzero, the data is decomposed with
+   *        RandomizedBlockKrylovSVD::ApplyChunks(), reading chunkSize points at
+   *        a time (Default: 0).
    */
   RandomizedBlockKrylovSVDPolicy(const size_t maxIterations = 2,
-                                 const size_t blockSize = 0) :
+                                 const size_t blockSize = 0,
+                                 const size_t chunkSize = 0) :
       maxIterations(maxIterations),
-      blockSize(blockSize)
+      blockSize(blockSize),
+      chunkSize(chunkSize)
   {
     /* Nothing to do here */
   }
@@ -65,7 +70,15 @@ class RandomizedBlockKrylovSVDPolicy
     // Do singular value decomposition using the randomized block krylov SVD
     // algorithm.
     RandomizedBlockKrylovSVD rsvd(maxIterations, blockSize);
-    rsvd.Apply(centeredData, eigvec, eigVal, v, rank);
+    if (chunkSize == 0)
+    {
+      rsvd.Apply(centeredData, eigvec, eigVal, v, rank);
+    }
+    else
+    {
+      data::MatrixChunkLoader<arma::mat> loader(centeredData, chunkSize);
+      rsvd.ApplyChunks(loader, eigvec, eigVal, rank);
+    }
 
     // Now we must square the singular values to get the eigenvalues.
     // In addition we must divide by the number of points, because the
@@ -86,12 +99,20 @@ class RandomizedBlockKrylovSVDPolicy
   //! Modify the block size.
   size_t& BlockSize() { return blockSize; }
 
+  //! Get the number of points read at a time (0 reads all of them at once).
+  size_t ChunkSize() const { return chunkSize; }
+  //! Modify the number of points read at a time (0 reads all of them at once).
+  size_t& ChunkSize() { return chunkSize; }
+
  private:
   //! Locally stored number of iterations for the power method.
   size_t maxIterations;
 
   //! Locally stored block size value.
   size_t blockSize;
+
+  //! Number of points read at a time, or 0.
+  size_t chunkSize;
 };
 
 } // namespace mlpack
@@ -33,11 +33,16 @@ class RandomizedSVDPCAPolicy
    *        (Default: rank + 2).
    * @param maxIterations Number of iterations for the power method
    *        (Default: 2).
+   * @param chunkSize If nonzero, the data is decomposed with
+   *        RandomizedSVD::ApplyChunks(), reading chunkSize points at a time
+   *        (Default: 0).
    */
   RandomizedSVDPCAPolicy(const size_t iteratedPower = 0,
-                         const size_t maxIterations = 2) :
+                         const size_t maxIterations = 2,
+                         const size_t chunkSize = 0) :
       iteratedPower(iteratedPower),
-      maxIterations(maxIterations)
+      maxIterations(maxIterations),
+      chunkSize(chunkSize)
   {
     /* Nothing to do here */
   }
@@ -65,7 +70,15 @@ class RandomizedSVDPCAPolicy
 
     // Do singular value decomposition using the randomized SVD algorithm.
     RandomizedSVD rsvd(iteratedPower, maxIterations);
-    rsvd.Apply(data, eigvec, eigVal, v, rank);
+    if (chunkSize == 0)
+    {
+      rsvd.Apply(data, eigvec, eigVal, v, rank);
+    }
+    else
+    {
+      data::MatrixChunkLoader<arma::mat> loader(data, chunkSize);
+      rsvd.ApplyChunks(loader, eigvec, eigVal, rank);
+    }
 
     // Now we must square the singular values to get the eigenvalues.
     // In addition we must divide by the number of points, because the
@@ -86,12 +99,20 @@ class RandomizedSVDPCAPolicy
   //! Modify the number of iterations for the power method.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the number of points read at a time (0 reads all of them at once).
+  size_t ChunkSize() const { return chunkSize; }
+  //! Modify the number of points read at a time (0 reads all of them at once).
+  size_t& ChunkSize() { return chunkSize; }
+
  private:
   //! Locally stored size of the normalized power iterations.
   size_t iteratedPower;
 
   //! Locally stored number of iterations for the power method.
   size_t maxIterations;
+
+  //! Number of points read at a time, or 0.
+  size_t chunkSize;
 };
 
 } // namespace mlpack
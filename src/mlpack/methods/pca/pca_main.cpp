@@ -36,7 +36,8 @@ BINDING_SHORT_DESC(
 // Long description.
 BINDING_LONG_DESC(
     "This program performs principal components analysis on the given dataset "
-    "using the exact, randomized, randomized block Krylov, or QUIC SVD method. "
+    "using the exact, randomized, randomized block Krylov, QUIC, or incremental "
+    "SVD method. "
     "It will transform the data onto its principal components, optionally "
     "performing dimensionality reduction by ignoring the principal components "
     "with the smallest eigenvalues."
@@ -52,7 +53,9 @@ BINDING_LONG_DESC(
     "Multiple different decomposition techniques can be used.  The method to "
     "use can be specified with the " +
     PRINT_PARAM_STRING("decomposition_method") + " parameter, and it may take "
-    "the values 'exact', 'randomized', or 'quic'.");
+    "the values 'exact', 'randomized', 'randomized-block-krylov', 'quic', or "
+    "'incremental'.  The 'incremental' method processes the data one chunk of "
+    "points at a time.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -83,7 +86,7 @@ PARAM_FLAG("scale", "If set, the data will be scaled before running PCA, such "
 
 PARAM_STRING_IN("decomposition_method", "Method used for the principal "
     "components analysis: 'exact', 'randomized', 'randomized-block-krylov', "
-    "'quic'.", "c", "exact");
+    "'quic', 'incremental'.", "c", "exact");
 
 
 //! Run RunPCA on the specified dataset with the given decomposition method.
@@ -130,7 +133,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   // Check decomposition method validity.
   RequireParamInSet<string>(params, "decomposition_method",
-      { "exact", "randomized", "randomized-block-krylov", "quic" }, true,
+      { "exact", "randomized", "randomized-block-krylov", "quic",
+        "incremental" }, true,
       "unknown decomposition method");
 
   // Find out what dimension we want.
@@ -177,6 +181,11 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     RunPCA<QUICSVDPolicy>(params, timers, dataset, newDimension, scale,
         varToRetain);
   }
+  else if (decompositionMethod == "incremental")
+  {
+    RunPCA<IncrementalSVDPolicy>(params, timers, dataset, newDimension, scale,
+        varToRetain);
+  }
 
   // Now save the results.
   if (params.Has("output"))
@@ -59,6 +59,43 @@ class SimpleWeightUpdate
     weights.col(correctClass) += instanceWeight * trainingPoint;
     biases(correctClass) += instanceWeight;
   }
+
+  /**
+   * Update the weightVectors matrix for a batch of points at once: the update
+   * is the sum of the updates of each point, computed with one matrix
+   * multiplication.  Points whose incorrect class is their correct class
+   * (that is, points that were correctly classified) do not change the
+   * weights.
+   *
+   * @tparam MatType Type of matrix (should be an Armadillo matrix like
+   *      arma::mat or arma::sp_mat or something similar).
+   * @param trainingPoints Points of the batch.
+   * @param weights Matrix of weights.
+   * @param biases Vector of biases.
+   * @param incorrectClasses Class that each point was classified as.
+   * @param correctClasses True class of each point.
+   * @param instanceWeights Weight to be given to each point during training.
+   */
+  template<typename MatType, typename eT>
+  void UpdateWeights(const MatType& trainingPoints,
+                     arma::Mat<eT>& weights,
+                     arma::Col<eT>& biases,
+                     const arma::Row<size_t>& incorrectClasses,
+                     const arma::Row<size_t>& correctClasses,
+                     const arma::Row<eT>& instanceWeights)
+  {
+    // Each row holds the signed weights of one point for each class.
+    arma::Mat<eT> coefficients(trainingPoints.n_cols, weights.n_cols,
+        arma::fill::zeros);
+    for (size_t i = 0; i < trainingPoints.n_cols; ++i)
+    {
+      coefficients(i, incorrectClasses[i]) -= instanceWeights[i];
+      coefficients(i, correctClasses[i]) += instanceWeights[i];
+    }
+
+    weights += trainingPoints * coefficients;
+    biases += sum(coefficients, 0).t();
+  }
 };
 
 } // namespace mlpack
@@ -19,11 +19,39 @@
 
 namespace mlpack {
 
+/**
+ * HasBatchUpdateWeights<LearnPolicy, ElemType>::value is true if the learning
+ * policy has a batch `UpdateWeights(points, weights, biases, incorrectClasses,
+ * correctClasses, instanceWeights)` method that applies the updates of a batch
+ * of points at once (as SimpleWeightUpdate does).
+ */
+template<typename LearnPolicy, typename ElemType, typename = void>
+struct HasBatchUpdateWeights : std::false_type { };
+
+template<typename LearnPolicy, typename ElemType>
+struct HasBatchUpdateWeights<LearnPolicy, ElemType, decltype(
+    std::declval<LearnPolicy&>().UpdateWeights(
+        std::declval<const arma::Mat<ElemType>&>(),
+        std::declval<arma::Mat<ElemType>&>(),
+        std::declval<arma::Col<ElemType>&>(),
+        std::declval<const arma::Row<size_t>&>(),
+        std::declval<const arma::Row<size_t>&>(),
+        std::declval<const arma::Row<ElemType>&>()), void())> :
+    std::true_type { };
+
 /**
  * This class implements a simple perceptron (i.e., a single layer neural
  * network).  It converges if the supplied training dataset is linearly
  * separable.
  *
+ * By default, the weights are updated after each misclassified point.  If a
+ * batch size larger than 1 is given, the points are instead processed in
+ * mini-batches: the class scores of a batch are computed with one matrix
+ * multiplication, and the updates of all the misclassified points of the batch
+ * are applied at once through the learning policy (with one matrix
+ * multiplication if the policy has a batch UpdateWeights(); see
+ * HasBatchUpdateWeights).
+ *
  * @tparam LearnPolicy Options of SimpleWeightUpdate and GradientDescent.
  * @tparam WeightInitializationPolicy Option of ZeroInitialization and
  *      RandomPerceptronInitialization.
@@ -63,11 +91,14 @@ class Perceptron
    * @param numClasses Number of classes in the dataset.
    * @param maxIterations Maximum number of iterations for the perceptron
    *      learning algorithm.
+   * @param batchSize Number of points of each mini-batch, or 0 to update the
+   *      weights after each point.
    */
   Perceptron(const MatType& data,
              const arma::Row<size_t>& labels,
              const size_t numClasses,
-             const size_t maxIterations = 1000);
+             const size_t maxIterations = 1000,
+             const size_t batchSize = 0);
 
   /**
    * Constructor: construct the perceptron by building the weights matrix, which
@@ -85,6 +116,8 @@ class Perceptron
    *     training.
    * @param maxIterations Maximum number of iterations for the perceptron
    *     learning algorithm.
+   * @param batchSize Number of points of each mini-batch, or 0 to update the
+   *     weights after each point.
    */
   template<typename WeightsType>
   Perceptron(const MatType& data,
@@ -92,6 +125,7 @@ class Perceptron
              const size_t numClasses,
              const WeightsType& instanceWeights,
              const size_t maxIterations = 1000,
+             const size_t batchSize = 0,
              const typename std::enable_if<
                  arma::is_arma_type<WeightsType>::value>::type* = 0);
 
@@ -212,7 +246,8 @@ class Perceptron
 
   /**
    * Classification function. After training, use the weights matrix to
-   * classify test, and put the predicted classes in predictedLabels.
+   * classify test, and put the predicted classes in predictedLabels.  The
+   * points are classified in blocks, in parallel if OpenMP is enabled.
    *
    * @param test Testing data or data to classify.
    * @param predictedLabels Vector to store the predicted classes after
@@ -230,13 +265,19 @@ class Perceptron
    * Serialize the perceptron.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
   //! Get the maximum number of iterations.
   size_t MaxIterations() const { return maxIterations; }
   //! Modify the maximum number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the mini-batch size (0 or 1 to update the weights after each point).
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the mini-batch size (0 or 1 to update the weights after each
+  //! point).
+  size_t& BatchSize() { return batchSize; }
+
   //! Get the number of classes this perceptron has been trained for.
   size_t NumClasses() const { return weights.n_cols; }
 
@@ -263,9 +304,39 @@ class Perceptron
                      const size_t numClasses,
                      const WeightsType& instanceWeights = WeightsType());
 
+  /**
+   * Apply the updates of the points of a mini-batch, with the batch
+   * UpdateWeights() of the learning policy.
+   */
+  template<typename BatchType>
+  void UpdateBatch(LearnPolicy& lp,
+                   const BatchType& batch,
+                   const arma::Row<size_t>& predictions,
+                   const arma::Row<size_t>& batchLabels,
+                   const arma::Row<ElemType>& batchWeights,
+                   const std::true_type& /* hasBatchUpdateWeights */);
+
+  /**
+   * Apply the updates of the misclassified points of a mini-batch one at a
+   * time, for learning policies without a batch UpdateWeights().
+   */
+  template<typename BatchType>
+  void UpdateBatch(LearnPolicy& lp,
+                   const BatchType& batch,
+                   const arma::Row<size_t>& predictions,
+                   const arma::Row<size_t>& batchLabels,
+                   const arma::Row<ElemType>& batchWeights,
+                   const std::false_type& /* hasBatchUpdateWeights */);
+
+  //! Number of points that are classified at once by Classify().
+  static constexpr size_t ClassifyBlockSize = 1024;
+
   //! The maximum number of iterations during training.
   size_t maxIterations;
 
+  //! The number of points of each mini-batch during training.
+  size_t batchSize;
+
   /**
    * Stores the weights for each of the input class labels.  Each column
    * corresponds to the weights for one class label, and each row corresponds to
@@ -280,6 +351,11 @@ class Perceptron
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename LearnPolicy,
+    typename WeightInitializationPolicy, typename MatType),
+    (mlpack::Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>),
+    (1));
+
 #include "perceptron_impl.hpp"
 
 #endif
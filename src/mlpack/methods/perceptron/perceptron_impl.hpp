@@ -29,7 +29,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const size_t numClasses,
     const size_t dimensionality,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    batchSize(0)
 {
   WeightInitializationPolicy wip;
   wip.Initialize(weights, biases, dimensionality, numClasses);
@@ -44,6 +45,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
  * @param labels Labels of dataset.
  * @param maxIterations Maximum number of iterations for the perceptron learning
  *      algorithm.
+ * @param batchSize Number of points of each mini-batch, or 0 to update the
+ *      weights after each point.
  */
 template<
     typename LearnPolicy,
@@ -54,8 +57,10 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const MatType& data,
     const arma::Row<size_t>& labels,
     const size_t numClasses,
-    const size_t maxIterations) :
-    maxIterations(maxIterations)
+    const size_t maxIterations,
+    const size_t batchSize) :
+    maxIterations(maxIterations),
+    batchSize(batchSize)
 {
   // Start training.
   TrainInternal<false, arma::Row<typename MatType::elem_type>>(data, labels,
@@ -83,9 +88,11 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const size_t numClasses,
     const WeightsType& instanceWeights,
     const size_t maxIterations,
+    const size_t batchSize,
     const typename std::enable_if<
         arma::is_arma_type<WeightsType>::value>::type*) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    batchSize(batchSize)
 {
   // Start training.
   TrainInternal<true>(data, labels, numClasses, instanceWeights);
@@ -117,7 +124,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const WeightsType& instanceWeights,
     const typename std::enable_if<
         arma::is_arma_type<WeightsType>::value>::type*) :
-    maxIterations(other.maxIterations)
+    maxIterations(other.maxIterations),
+    batchSize(other.batchSize)
 {
   TrainInternal<true>(data, labels, numClasses, instanceWeights);
 }
@@ -279,6 +287,52 @@ void Perceptron<
 
   LearnPolicy LP;
 
+  if (batchSize > 1)
+  {
+    arma::Mat<ElemType> scores;
+    arma::Row<size_t> predictions;
+    arma::Row<ElemType> batchWeights;
+
+    while ((i < maxIterations) && (!converged))
+    {
+      ++i;
+      converged = true;
+
+      for (size_t begin = 0; begin < data.n_cols; begin += batchSize)
+      {
+        const size_t end = std::min(begin + batchSize, (size_t) data.n_cols);
+
+        // Compute the scores of the whole batch with one matrix
+        // multiplication.
+        scores = weights.t() * data.cols(begin, end - 1);
+        scores.each_col() += biases;
+        predictions = arma::conv_to<arma::Row<size_t>>::from(
+            arma::index_max(scores, 0));
+
+        const arma::Row<size_t> batchLabels = labels.cols(begin, end - 1);
+        if (arma::all(predictions == batchLabels))
+          continue;
+
+        // Due to incorrect predictions, convergence set to false.
+        converged = false;
+        if (HasWeights)
+        {
+          batchWeights = arma::conv_to<arma::Row<ElemType>>::from(
+              instanceWeights.cols(begin, end - 1));
+        }
+        else
+        {
+          batchWeights.ones(end - begin);
+        }
+
+        UpdateBatch(LP, data.cols(begin, end - 1), predictions, batchLabels,
+            batchWeights, HasBatchUpdateWeights<LearnPolicy, ElemType>());
+      }
+    }
+
+    return;
+  }
+
   while ((i < maxIterations) && (!converged))
   {
     // This outer loop is for each iteration, and we use the 'converged'
@@ -316,6 +370,52 @@ void Perceptron<
   }
 }
 
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+template<typename BatchType>
+void Perceptron<
+    LearnPolicy, WeightInitializationPolicy, MatType
+>::UpdateBatch(LearnPolicy& lp,
+               const BatchType& batch,
+               const arma::Row<size_t>& predictions,
+               const arma::Row<size_t>& batchLabels,
+               const arma::Row<ElemType>& batchWeights,
+               const std::true_type& /* hasBatchUpdateWeights */)
+{
+  // The correctly classified points have the same predicted and true class, so
+  // they do not change the weights.
+  lp.UpdateWeights(batch, weights, biases, predictions, batchLabels,
+      batchWeights);
+}
+
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+template<typename BatchType>
+void Perceptron<
+    LearnPolicy, WeightInitializationPolicy, MatType
+>::UpdateBatch(LearnPolicy& lp,
+               const BatchType& batch,
+               const arma::Row<size_t>& predictions,
+               const arma::Row<size_t>& batchLabels,
+               const arma::Row<ElemType>& batchWeights,
+               const std::false_type& /* hasBatchUpdateWeights */)
+{
+  for (size_t k = 0; k < batch.n_cols; ++k)
+  {
+    if (predictions[k] != batchLabels[k])
+    {
+      lp.UpdateWeights(batch.col(k), weights, biases, predictions[k],
+          batchLabels[k], batchWeights[k]);
+    }
+  }
+}
+
 /**
  * After training, use the weights matrix to classify `point`, and return the
  * predicted class.
@@ -363,16 +463,23 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
   util::CheckSameDimensionality(test, weights.n_rows, "Perceptron::Classify()",
       "points");
 
-  arma::Col<ElemType> tempLabelMat;
-  arma::uword maxIndex = 0;
   predictedLabels.set_size(test.n_cols);
 
-  // Could probably be faster if done in batch.
-  for (size_t i = 0; i < test.n_cols; ++i)
+  // Compute the scores of each block of points for all classes with one matrix
+  // multiplication.
+  const size_t numBlocks = (test.n_cols + ClassifyBlockSize - 1) /
+      ClassifyBlockSize;
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
   {
-    tempLabelMat = weights.t() * test.col(i) + biases;
-    tempLabelMat.max(maxIndex);
-    predictedLabels(i) = maxIndex;
+    const size_t begin = b * ClassifyBlockSize;
+    const size_t end = std::min((size_t) test.n_cols,
+        begin + ClassifyBlockSize);
+
+    arma::Mat<ElemType> scores = weights.t() * test.cols(begin, end - 1);
+    scores.each_col() += biases;
+    predictedLabels.cols(begin, end - 1) =
+        arma::conv_to<arma::Row<size_t>>::from(arma::index_max(scores, 0));
   }
 }
 
@@ -396,13 +503,18 @@ template<typename LearnPolicy,
 template<typename Archive>
 void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::serialize(
     Archive& ar,
-    const uint32_t /* version */)
+    const uint32_t version)
 {
   // We just need to serialize the maximum number of iterations, the weights,
-  // and the biases.
+  // and the biases.  The batch size was added in version 1.
   ar(CEREAL_NVP(maxIterations));
   ar(CEREAL_NVP(weights));
   ar(CEREAL_NVP(biases));
+
+  if (cereal::is_loading<Archive>() && version == 0)
+    batchSize = 0;
+  else
+    ar(CEREAL_NVP(batchSize));
 }
 
 } // namespace mlpack
@@ -181,14 +181,12 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       if (strategy == "mean")
       {
         Imputer<double, MapperType, MeanImputation<double>> imputer(info);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
+        imputer.Impute(input, missingValue, dirtyDimensions);
       }
       else if (strategy == "median")
       {
         Imputer<double, MapperType, MedianImputation<double>> imputer(info);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
+        imputer.Impute(input, missingValue, dirtyDimensions);
       }
       else if (strategy == "listwise_deletion")
       {
@@ -201,8 +199,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
         CustomImputation<double> strat(customValue);
         Imputer<double, MapperType, CustomImputation<double>> imputer(
             info, strat);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
+        imputer.Impute(input, missingValue, dirtyDimensions);
       }
       else
       {
@@ -80,6 +80,11 @@ class ScalingModel
   template<typename MatType>
   void Transform(const MatType& input, MatType& output);
 
+  //! Transform to scale features in place.  The whitening scalers use a
+  //! temporary matrix.
+  template<typename MatType>
+  void Transform(MatType& input);
+
   // Fit to intialize the scaling parameter.
   template<typename MatType>
   void Fit(const MatType& input);
@@ -88,6 +93,11 @@ class ScalingModel
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output);
 
+  // Scale back the dataset to their original values in place.  The whitening
+  // scalers use a temporary matrix.
+  template<typename MatType>
+  void InverseTransform(MatType& input);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -233,6 +233,36 @@ void ScalingModel::Transform(const MatType& input, MatType& output)
   }
 }
 
+template<typename MatType>
+void ScalingModel::Transform(MatType& input)
+{
+  if (scalerType == ScalerTypes::STANDARD_SCALER)
+  {
+    standardscale->Transform(input);
+  }
+  else if (scalerType == ScalerTypes::MIN_MAX_SCALER)
+  {
+    minmaxscale->Transform(input);
+  }
+  else if (scalerType == ScalerTypes::MEAN_NORMALIZATION)
+  {
+    meanscale->Transform(input);
+  }
+  else if (scalerType == ScalerTypes::MAX_ABS_SCALER)
+  {
+    maxabsscale->Transform(input);
+  }
+  else if (scalerType == ScalerTypes::PCA_WHITENING ||
+           scalerType == ScalerTypes::ZCA_WHITENING)
+  {
+    // The whitening scalers multiply by a matrix, so they cannot work in
+    // place.
+    MatType output;
+    Transform(input, output);
+    input = std::move(output);
+  }
+}
+
 template<typename MatType>
 void ScalingModel::InverseTransform(const MatType& input, MatType& output)
 {
@@ -262,6 +292,36 @@ void ScalingModel::InverseTransform(const MatType& input, MatType& output)
   }
 }
 
+template<typename MatType>
+void ScalingModel::InverseTransform(MatType& input)
+{
+  if (scalerType == ScalerTypes::STANDARD_SCALER)
+  {
+    standardscale->InverseTransform(input);
+  }
+  else if (scalerType == ScalerTypes::MIN_MAX_SCALER)
+  {
+    minmaxscale->InverseTransform(input);
+  }
+  else if (scalerType == ScalerTypes::MEAN_NORMALIZATION)
+  {
+    meanscale->InverseTransform(input);
+  }
+  else if (scalerType == ScalerTypes::MAX_ABS_SCALER)
+  {
+    maxabsscale->InverseTransform(input);
+  }
+  else if (scalerType == ScalerTypes::PCA_WHITENING ||
+           scalerType == ScalerTypes::ZCA_WHITENING)
+  {
+    // The whitening scalers multiply by a matrix, so they cannot work in
+    // place.
+    MatType output;
+    InverseTransform(input, output);
+    input = std::move(output);
+  }
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -23,9 +23,10 @@ inline QUIC_SVD::QUIC_SVD(
     arma::mat& v,
     arma::mat& sigma,
     const double epsilon,
-    const double delta)
+    const double delta,
+    const size_t splitsPerRound)
 {
-  Apply(dataset, u, v, sigma, epsilon, delta);
+  Apply(dataset, u, v, sigma, epsilon, delta, splitsPerRound);
 }
 
 inline QUIC_SVD::QUIC_SVD(
@@ -41,15 +42,16 @@ inline void QUIC_SVD::Apply(
     arma::mat& v,
     arma::mat& sigma,
     const double epsilon,
-    const double delta)
+    const double delta,
+    const size_t splitsPerRound)
 {
   // Since columns are sample in the implementation, the matrix is transposed if
   // necessary for maximum speedup.
   CosineTree* ctree;
   if (dataset.n_cols > dataset.n_rows)
-    ctree = new CosineTree(dataset, epsilon, delta);
+    ctree = new CosineTree(dataset, epsilon, delta, splitsPerRound);
   else
-    ctree = new CosineTree(dataset.t(), epsilon, delta);
+    ctree = new CosineTree(dataset.t(), epsilon, delta, splitsPerRound);
 
   // Get subspace basis by creating the cosine tree.
   ctree->GetFinalBasis(basis);
@@ -91,7 +91,11 @@ class Radical
    */
   void CopyAndPerturb(arma::mat& xNew, const arma::mat& x) const;
 
-  //! Two-dimensional version of RADICAL.
+  /**
+   * Two-dimensional version of RADICAL: return the rotation angle that
+   * minimizes the sum of the entropy estimates of the two coordinates.  The
+   * angles are evaluated in parallel.
+   */
   double DoRadical2D(const arma::mat& matX,
                      util::Timers& timers = IO::GetTimers());
 
@@ -135,8 +139,13 @@ class Radical
 
   //! Internal matrix, held as member variable to prevent memory reallocations.
   arma::mat perturbed;
-  //! Internal matrix, held as member variable to prevent memory reallocations.
-  arma::mat candidate;
+
+  /**
+   * Compute the sum of the entropy estimates of the two coordinates of the
+   * given (perturbed) two-dimensional points, rotated by the given angle.
+   * This does not modify the object, so it can be called from several threads.
+   */
+  double RotatedEntropy(const arma::mat& perturbed, const double theta) const;
 };
 
 void WhitenFeatureMajorMatrix(const arma::mat& matX,
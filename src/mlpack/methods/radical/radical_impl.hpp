@@ -42,7 +42,9 @@ inline void Radical::CopyAndPerturb(arma::mat& xNew,
 
 inline double Radical::Vasicek(arma::vec& z) const
 {
-  z = sort(z);
+  // Every m-spacing z_(i + m) - z_(i) is needed, so the sample must be fully
+  // ordered; sort it in place to avoid a copy.
+  std::sort(z.begin(), z.end());
 
   // Apparently slower.
   /*
@@ -70,33 +72,36 @@ inline double Radical::DoRadical2D(const arma::mat& matX,
   CopyAndPerturb(perturbed, matX);
   timers.Stop("radical_copy_and_perturb");
 
-  arma::mat::fixed<2, 2> matJacobi;
-
+  // The angles are independent, so they are evaluated in parallel.
   arma::vec values(angles);
-
+  #pragma omp parallel for num_threads((int) NumThreads())
   for (size_t i = 0; i < angles; ++i)
-  {
-    const double theta = (i / (double) angles) * M_PI / 2.0;
-    const double cosTheta = cos(theta);
-    const double sinTheta = sin(theta);
-
-    matJacobi(0, 0) = cosTheta;
-    matJacobi(1, 0) = -sinTheta;
-    matJacobi(0, 1) = sinTheta;
-    matJacobi(1, 1) = cosTheta;
-
-    candidate = perturbed * matJacobi;
-    arma::vec candidateY1 = candidate.unsafe_col(0);
-    arma::vec candidateY2 = candidate.unsafe_col(1);
-
-    values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
-  }
+    values(i) = RotatedEntropy(perturbed, (i / (double) angles) * M_PI / 2.0);
 
   arma::uword indOpt = 0;
   values.min(indOpt); // we ignore the return value; we don't care about it
   return (indOpt / (double) angles) * M_PI / 2.0;
 }
 
+inline double Radical::RotatedEntropy(const arma::mat& perturbed,
+                                      const double theta) const
+{
+  const double cosTheta = cos(theta);
+  const double sinTheta = sin(theta);
+
+  arma::mat::fixed<2, 2> matJacobi;
+  matJacobi(0, 0) = cosTheta;
+  matJacobi(1, 0) = -sinTheta;
+  matJacobi(0, 1) = sinTheta;
+  matJacobi(1, 1) = cosTheta;
+
+  const arma::mat candidate = perturbed * matJacobi;
+  arma::vec candidateY1 = candidate.col(0);
+  arma::vec candidateY2 = candidate.col(1);
+
+  return Vasicek(candidateY1) + Vasicek(candidateY2);
+}
+
 
 inline void Radical::DoRadical(const arma::mat& matXT,
                                arma::mat& matY,
@@ -137,40 +142,70 @@ inline void Radical::DoRadical(const arma::mat& matXT,
 
   arma::mat matYSubspace(nPoints, 2);
 
-  arma::mat matJ = arma::eye(nDims, nDims);
+  // Each sweep visits every pair of dimensions once, in rounds of disjoint
+  // pairs given by a round-robin schedule: the rotations of disjoint pairs
+  // commute, so the pairs of a round can be optimized at the same time.  With
+  // an odd number of dimensions, one dimension sits out each round.
+  const size_t nSlots = nDims + (nDims % 2);
+  std::vector<std::pair<size_t, size_t>> pairs;
+  std::vector<arma::mat> perturbedPairs;
 
   for (size_t sweepNum = 0; sweepNum < sweeps; sweepNum++)
   {
     Log::Info << "RADICAL: sweep " << sweepNum << "." << std::endl;
 
-    for (size_t i = 0; i < nDims - 1; ++i)
+    for (size_t round = 0; round + 1 < nSlots; ++round)
     {
-      for (size_t j = i + 1; j < nDims; ++j)
+      pairs.clear();
+      for (size_t k = 0; k < nSlots / 2; ++k)
       {
-        Log::Debug << "RADICAL 2D on dimensions " << i << " and " << j << "."
-            << std::endl;
+        // Slot 0 is fixed, and the other slots rotate with each round.
+        const size_t a = (k == 0) ? 0 : ((k - 1 + round) % (nSlots - 1)) + 1;
+        const size_t b = ((nSlots - 2 - k + round) % (nSlots - 1)) + 1;
+        if (a < nDims && b < nDims)
+          pairs.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+      }
 
-        matYSubspace.col(0) = matY.col(i);
-        matYSubspace.col(1) = matY.col(j);
+      // The random perturbations are drawn serially, so the results do not
+      // depend on the number of threads.
+      timers.Start("radical_copy_and_perturb");
+      perturbedPairs.resize(pairs.size());
+      for (size_t p = 0; p < pairs.size(); ++p)
+      {
+        Log::Debug << "RADICAL 2D on dimensions " << pairs[p].first << " and "
+            << pairs[p].second << "." << std::endl;
 
-        const double thetaOpt = DoRadical2D(matYSubspace, timers);
+        matYSubspace.col(0) = matY.col(pairs[p].first);
+        matYSubspace.col(1) = matY.col(pairs[p].second);
+        CopyAndPerturb(perturbedPairs[p], matYSubspace);
+      }
+      timers.Stop("radical_copy_and_perturb");
 
-        const double cosThetaOpt = cos(thetaOpt);
-        const double sinThetaOpt = sin(thetaOpt);
+      // Search the angles of all the pairs of the round in parallel.
+      arma::mat values(angles, pairs.size());
+      #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+      for (size_t t = 0; t < angles * pairs.size(); ++t)
+      {
+        const size_t a = t % angles;
+        values(a, t / angles) = RotatedEntropy(perturbedPairs[t / angles],
+            (a / (double) angles) * M_PI / 2.0);
+      }
 
-        // Set elements of transformation matrix.
-        matJ(i, i) = cosThetaOpt;
-        matJ(j, i) = -sinThetaOpt;
-        matJ(i, j) = sinThetaOpt;
-        matJ(j, j) = cosThetaOpt;
+      // Rotate each pair of dimensions by its optimal angle.
+      for (size_t p = 0; p < pairs.size(); ++p)
+      {
+        arma::uword indOpt = 0;
+        values.col(p).min(indOpt);
+        const double thetaOpt = (indOpt / (double) angles) * M_PI / 2.0;
 
-        matY *= matJ;
+        const double cosThetaOpt = cos(thetaOpt);
+        const double sinThetaOpt = sin(thetaOpt);
 
-        // Unset elements of transformation matrix, so matJ = eye() again.
-        matJ(i, i) = 1;
-        matJ(j, i) = 0;
-        matJ(i, j) = 0;
-        matJ(j, j) = 1;
+        const arma::vec yI = matY.col(pairs[p].first);
+        matY.col(pairs[p].first) = cosThetaOpt * yI -
+            sinThetaOpt * matY.col(pairs[p].second);
+        matY.col(pairs[p].second) = sinThetaOpt * yI +
+            cosThetaOpt * matY.col(pairs[p].second);
       }
     }
   }
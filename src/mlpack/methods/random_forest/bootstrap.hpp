@@ -16,7 +16,51 @@
 namespace mlpack {
 
 /**
- * Given a dataset, create another dataset via bootstrap sampling, with labels.
+ * Sample the indices of a bootstrap dataset: numPoints indices in [0,
+ * numPoints), with replacement.  The indices are sorted, so that gathering the
+ * bootstrap dataset from them reads the original dataset in order.  This lets
+ * a bootstrap dataset be built only when (and where) it is needed, instead of
+ * holding copies.
+ *
+ * @param numPoints Number of points of the original dataset.
+ * @param indices Will contain the sorted sampled indices.
+ */
+inline void BootstrapIndices(const size_t numPoints, arma::uvec& indices)
+{
+  if (numPoints == 0)
+  {
+    indices.reset();
+    return;
+  }
+
+  // Random sampling with replacement.
+  indices = arma::sort(randi<arma::uvec>(numPoints,
+      arma::distr_param(0, (int) numPoints - 1)));
+}
+
+/**
+ * Sample a bootstrap dataset as counts: counts[i] is the number of times that
+ * point i is in the bootstrap sample.  This takes O(numPoints) memory and no
+ * copy of the data; the counts can be used as weights of the original points.
+ *
+ * @param numPoints Number of points of the original dataset.
+ * @param counts Will contain the number of times each point is sampled.
+ */
+inline void BootstrapCounts(const size_t numPoints, arma::urowvec& counts)
+{
+  counts.zeros(numPoints);
+  if (numPoints == 0)
+    return;
+
+  const arma::uvec indices = randi<arma::uvec>(numPoints,
+      arma::distr_param(0, (int) numPoints - 1));
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    ++counts[indices[i]];
+}
+
+/**
+ * Given a dataset, create another dataset via bootstrap sampling, with labels,
+ * and return the sorted indices of the sampled points.
  */
 template<bool UseWeights,
          typename MatType,
@@ -27,22 +71,37 @@ void Bootstrap(const MatType& dataset,
                const WeightsType& weights,
                MatType& bootstrapDataset,
                LabelsType& bootstrapLabels,
-               WeightsType& bootstrapWeights)
+               WeightsType& bootstrapWeights,
+               arma::uvec& indices)
 {
-  bootstrapDataset.set_size(dataset.n_rows, dataset.n_cols);
-  bootstrapLabels.set_size(labels.n_elem);
-  if (UseWeights)
-    bootstrapWeights.set_size(weights.n_elem);
+  BootstrapIndices(dataset.n_cols, indices);
 
-  // Random sampling with replacement.
-  arma::uvec indices = randi<arma::uvec>(dataset.n_cols,
-      arma::distr_param(0, dataset.n_cols - 1));
+  // Each output is allocated once, directly with the sampled columns.
   bootstrapDataset = dataset.cols(indices);
   bootstrapLabels = labels.cols(indices);
   if (UseWeights)
     bootstrapWeights = weights.cols(indices);
 }
 
+/**
+ * Given a dataset, create another dataset via bootstrap sampling, with labels.
+ */
+template<bool UseWeights,
+         typename MatType,
+         typename LabelsType,
+         typename WeightsType>
+void Bootstrap(const MatType& dataset,
+               const LabelsType& labels,
+               const WeightsType& weights,
+               MatType& bootstrapDataset,
+               LabelsType& bootstrapLabels,
+               WeightsType& bootstrapWeights)
+{
+  arma::uvec indices;
+  Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
+      bootstrapLabels, bootstrapWeights, indices);
+}
+
 } // namespace mlpack
 
 #endif
@@ -0,0 +1,142 @@
+/**
+ * @file methods/random_forest/flat_random_forest.hpp
+ *
+ * A compiled, read-only representation of a trained random forest, made of
+ * flat decision trees, for fast batch classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_RANDOM_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_RANDOM_FOREST_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/decision_tree/flat_decision_tree.hpp>
+
+namespace mlpack {
+
+/**
+ * A FlatRandomForest is an inference-only copy of a trained RandomForest, where
+ * each tree is compiled into a FlatDecisionTree.  When classifying a set of
+ * points, each block of FlatDecisionTree::BlockSize points goes through every
+ * tree in turn, so that the block stays in cache while the trees are
+ * traversed, and the points of the block go down each tree together; the
+ * blocks are classified in parallel with OpenMP.  The predictions and
+ * probabilities are the same as those of the original forest.
+ *
+ * @code
+ * RandomForest<> rf(data, labels, numClasses);
+ * FlatRandomForest flatForest(rf);
+ * arma::Row<size_t> predictions;
+ * flatForest.Classify(testData, predictions);
+ * @endcode
+ */
+class FlatRandomForest
+{
+ public:
+  /**
+   * Create an empty flat forest.  It must be assigned or loaded before it can
+   * be used.
+   */
+  FlatRandomForest() { }
+
+  /**
+   * Compile the given trained random forest into a flat forest.  A
+   * std::invalid_argument is thrown if any of its trees cannot be flattened
+   * (see FlatDecisionTree).
+   *
+   * @param forest Trained random forest to compile.
+   */
+  template<typename ForestType>
+  explicit FlatRandomForest(const ForestType& forest);
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to be classified.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point and return the predicted class
+   * probabilities for each class.
+   *
+   * @param point Point to be classified.
+   * @param prediction size_t to store predicted class in.
+   * @param probabilities Output vector of class probabilities.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of each point in the given dataset.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * predicted class probabilities for each point.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Access a tree in the forest.
+  const FlatDecisionTree& Tree(const size_t i) const { return trees[i]; }
+
+  //! Get the number of trees in the forest.
+  size_t NumTrees() const { return trees.size(); }
+
+  //! Get the number of classes.
+  size_t NumClasses() const
+  {
+    return trees.empty() ? 0 : trees[0].NumClasses();
+  }
+
+  //! Serialize the forest.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(trees));
+  }
+
+ private:
+  /**
+   * Compute the class probabilities of the points data.cols(begin, end - 1),
+   * averaged over the trees, in the first end - begin columns of
+   * probabilities.
+   */
+  template<typename MatType>
+  void BlockProbabilities(const MatType& data,
+                          const size_t begin,
+                          const size_t end,
+                          arma::Row<size_t>& leaves,
+                          arma::mat& probabilities) const;
+
+  //! Throw a std::invalid_argument if the forest is empty.
+  void CheckTrained() const;
+
+  //! The trees of the forest.
+  std::vector<FlatDecisionTree> trees;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_random_forest_impl.hpp"
+
+#endif
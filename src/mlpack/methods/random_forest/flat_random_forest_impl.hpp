@@ -0,0 +1,148 @@
+/**
+ * @file methods/random_forest/flat_random_forest_impl.hpp
+ *
+ * Implementation of the flat representation of a trained random forest.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_RANDOM_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_RANDOM_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_random_forest.hpp"
+
+namespace mlpack {
+
+template<typename ForestType>
+FlatRandomForest::FlatRandomForest(const ForestType& forest)
+{
+  trees.reserve(forest.NumTrees());
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    trees.push_back(FlatDecisionTree(forest.Tree(i)));
+}
+
+template<typename VecType>
+size_t FlatRandomForest::Classify(const VecType& point) const
+{
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+
+  return prediction;
+}
+
+template<typename VecType>
+void FlatRandomForest::Classify(const VecType& point,
+                                size_t& prediction,
+                                arma::vec& probabilities) const
+{
+  CheckTrained();
+
+  probabilities.zeros(NumClasses());
+  arma::vec treeProbabilities;
+  for (size_t i = 0; i < trees.size(); ++i)
+  {
+    size_t treePrediction; // Ignored.
+    trees[i].Classify(point, treePrediction, treeProbabilities);
+    probabilities += treeProbabilities;
+  }
+
+  probabilities /= trees.size();
+  prediction = (size_t) probabilities.index_max();
+}
+
+template<typename MatType>
+void FlatRandomForest::Classify(const MatType& data,
+                                arma::Row<size_t>& predictions) const
+{
+  CheckTrained();
+
+  predictions.set_size(data.n_cols);
+  const size_t blockSize = FlatDecisionTree::BlockSize;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    arma::Row<size_t> leaves(blockSize);
+    arma::mat probabilities(NumClasses(), blockSize);
+
+    #pragma omp for schedule(static)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min((size_t) data.n_cols, begin + blockSize);
+      BlockProbabilities(data, begin, end, leaves, probabilities);
+      for (size_t i = begin; i < end; ++i)
+        predictions[i] = (size_t) probabilities.col(i - begin).index_max();
+    }
+  }
+}
+
+template<typename MatType>
+void FlatRandomForest::Classify(const MatType& data,
+                                arma::Row<size_t>& predictions,
+                                arma::mat& probabilities) const
+{
+  CheckTrained();
+
+  predictions.set_size(data.n_cols);
+  probabilities.set_size(NumClasses(), data.n_cols);
+  const size_t blockSize = FlatDecisionTree::BlockSize;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel num_threads((int) NumThreads())
+  {
+    arma::Row<size_t> leaves(blockSize);
+    arma::mat blockProbabilities(NumClasses(), blockSize);
+
+    #pragma omp for schedule(static)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min((size_t) data.n_cols, begin + blockSize);
+      BlockProbabilities(data, begin, end, leaves, blockProbabilities);
+      probabilities.cols(begin, end - 1) =
+          blockProbabilities.cols(0, end - begin - 1);
+      for (size_t i = begin; i < end; ++i)
+      {
+        predictions[i] =
+            (size_t) blockProbabilities.col(i - begin).index_max();
+      }
+    }
+  }
+}
+
+template<typename MatType>
+void FlatRandomForest::BlockProbabilities(const MatType& data,
+                                          const size_t begin,
+                                          const size_t end,
+                                          arma::Row<size_t>& leaves,
+                                          arma::mat& probabilities) const
+{
+  probabilities.zeros();
+  for (size_t t = 0; t < trees.size(); ++t)
+  {
+    trees[t].Leaves(data, begin, end, leaves);
+    const arma::mat& leafProbabilities = trees[t].LeafProbabilities();
+    for (size_t i = begin; i < end; ++i)
+      probabilities.col(i - begin) += leafProbabilities.col(leaves[i - begin]);
+  }
+
+  probabilities /= trees.size();
+}
+
+inline void FlatRandomForest::CheckTrained() const
+{
+  if (trees.empty())
+  {
+    throw std::invalid_argument("FlatRandomForest::Classify(): no random "
+        "forest compiled!");
+  }
+}
+
+} // namespace mlpack
+
+#endif
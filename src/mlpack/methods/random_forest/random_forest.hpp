@@ -14,6 +14,7 @@
 
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
 #include "bootstrap.hpp"
+#include "flat_random_forest.hpp"
 
 namespace mlpack {
 
@@ -340,16 +341,18 @@ class RandomForest
   /**
    * Predict the classes of each point in the given dataset, also returning the
    * predicted class probabilities for each point.  If the random forest has not
-   * been trained, this will throw an exception.
+   * been trained, this will throw an exception.  The probabilities can be
+   * returned in an arma::fmat to halve the size of the output; they are still
+   * accumulated in double precision, so the predictions do not change.
    *
    * @param data Dataset to be classified.
    * @param predictions Output predictions for each point in the dataset.
    * @param probabilities Output matrix of class probabilities for each point.
    */
-  template<typename MatType>
+  template<typename MatType, typename ElemType>
   void Classify(const MatType& data,
                 arma::Row<size_t>& predictions,
-                arma::mat& probabilities) const;
+                arma::Mat<ElemType>& probabilities) const;
 
   //! Access a tree in the forest.
   const DecisionTreeType& Tree(const size_t i) const { return trees[i]; }
@@ -359,6 +362,51 @@ class RandomForest
   //! Get the number of trees in the forest.
   size_t NumTrees() const { return trees.size(); }
 
+  //! Get whether Train() computes the out-of-bag error.
+  bool ComputeOOBError() const { return computeOOBError; }
+  //! Modify whether Train() computes the out-of-bag error.  This has no
+  //! effect unless UseBootstrap is true.
+  bool& ComputeOOBError() { return computeOOBError; }
+
+  /**
+   * Get the out-of-bag error of the last call to Train(), if ComputeOOBError()
+   * was set: the (weighted) fraction of the training points that are
+   * misclassified by the majority vote of the trees that did not see them
+   * during training.  The points that are in the bootstrap sample of every tree
+   * are ignored.  With a warm start, only the trees trained by that call vote.
+   * This is NaN if the error was not computed.
+   */
+  double OOBError() const { return oobError; }
+
+  /**
+   * Save the random forest into sections of the given writer: the number of
+   * trees and the average gain go into the "num_trees" and "avg_gain"
+   * sections, and each tree into its own "tree/<i>" section, so that the
+   * trees can be loaded independently with LoadSections().  The names of the
+   * sections are prefixed with the given prefix, so that several models can be
+   * saved in the same file.
+   *
+   * @param writer Writer to add the sections to.
+   * @param compress Whether to compress the sections of the trees.
+   * @param prefix Prefix of the names of the sections.
+   */
+  void SaveSections(data::SectionedModelWriter& writer,
+                    const bool compress = false,
+                    const std::string& prefix = "") const;
+
+  /**
+   * Load the random forest from sections saved by SaveSections().  Only the
+   * sections of the first numTrees trees are read and deserialized, so a
+   * smaller forest can be loaded quickly from a large one.
+   *
+   * @param reader Reader of the file that holds the sections.
+   * @param numTrees Number of trees to load; 0 loads all the trees.
+   * @param prefix Prefix of the names of the sections.
+   */
+  void LoadSections(const data::SectionedModelReader& reader,
+                    const size_t numTrees = 0,
+                    const std::string& prefix = "");
+
   /**
    * Serialize the random forest.
    */
@@ -401,11 +449,33 @@ class RandomForest
                DimensionSelectionType& dimensionSelector,
                const bool warmStart = false);
 
+  /**
+   * Compute the class probabilities of the points data.cols(begin, end - 1),
+   * averaged over the trees, in the first end - begin columns of
+   * probabilities, which must have ClassifyBlockSize columns.  The trees are
+   * traversed one at a time for all the points of the block, and nothing is
+   * allocated.
+   */
+  template<typename MatType>
+  void ClassifyBlock(const MatType& data,
+                     const size_t begin,
+                     const size_t end,
+                     arma::mat& probabilities) const;
+
+  //! The number of points classified together by the batch Classify()
+  //! overloads.
+  static constexpr size_t ClassifyBlockSize = 64;
+
   //! The trees in the forest.
   std::vector<DecisionTreeType> trees;
 
   //! The average gain of the forest.
   double avgGain;
+
+  //! Whether Train() computes the out-of-bag error.
+  bool computeOOBError;
+  //! The out-of-bag error of the last call to Train().
+  double oobError;
 };
 
 /**
@@ -31,7 +31,9 @@ RandomForest<
     CategoricalSplitType,
     UseBootstrap
 >::RandomForest() :
-    avgGain(0.0)
+    avgGain(0.0),
+    computeOOBError(false),
+    oobError(std::numeric_limits<double>::quiet_NaN())
 {
   // Nothing to do here.
 }
@@ -58,7 +60,9 @@ RandomForest<
                 const double minimumGainSplit,
                 const size_t maximumDepth,
                 DimensionSelectionType dimensionSelector) :
-    avgGain(0.0)
+    avgGain(0.0),
+    computeOOBError(false),
+    oobError(std::numeric_limits<double>::quiet_NaN())
 {
   // Pass off work to the Train() method.
   data::DatasetInfo info; // Ignored.
@@ -91,7 +95,9 @@ RandomForest<
                 const double minimumGainSplit,
                 const size_t maximumDepth,
                 DimensionSelectionType dimensionSelector):
-                    avgGain(0.0)
+                    avgGain(0.0),
+                    computeOOBError(false),
+                    oobError(std::numeric_limits<double>::quiet_NaN())
 {
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
@@ -123,7 +129,9 @@ RandomForest<
                 const double minimumGainSplit,
                 const size_t maximumDepth,
                 DimensionSelectionType dimensionSelector) :
-    avgGain(0.0)
+    avgGain(0.0),
+    computeOOBError(false),
+    oobError(std::numeric_limits<double>::quiet_NaN())
 {
   // Pass off work to the Train() method.
   data::DatasetInfo info; // Ignored by Train().
@@ -156,7 +164,9 @@ RandomForest<
                 const double minimumGainSplit,
                 const size_t maximumDepth,
                 DimensionSelectionType dimensionSelector) :
-    avgGain(0.0)
+    avgGain(0.0),
+    computeOOBError(false),
+    oobError(std::numeric_limits<double>::quiet_NaN())
 {
   // Pass off work to the Train() method.
   Train<true, true>(dataset, datasetInfo, labels, numClasses, weights,
@@ -390,12 +400,26 @@ void RandomForest<
   }
 
   predictions.set_size(data.n_cols);
+  const size_t numBlocks = (data.n_cols + ClassifyBlockSize - 1) /
+      ClassifyBlockSize;
 
-  #pragma omp parallel for
-  for (size_t i = 0; i < data.n_cols; ++i)
+  ParallelForRanges(0, numBlocks, [&](const size_t first, const size_t last)
   {
-    predictions[i] = Classify(data.col(i));
-  }
+    arma::mat blockProbabilities(trees[0].NumClasses(), ClassifyBlockSize);
+
+    for (size_t b = first; b < last; ++b)
+    {
+      const size_t begin = b * ClassifyBlockSize;
+      const size_t end = std::min((size_t) data.n_cols,
+          begin + ClassifyBlockSize);
+      ClassifyBlock(data, begin, end, blockProbabilities);
+      for (size_t i = begin; i < end; ++i)
+      {
+        predictions[i] =
+            (size_t) blockProbabilities.col(i - begin).index_max();
+      }
+    }
+  });
 }
 
 template<
@@ -405,7 +429,7 @@ template<
     template<typename> class CategoricalSplitType,
     bool UseBootstrap
 >
-template<typename MatType>
+template<typename MatType, typename ElemType>
 void RandomForest<
     FitnessFunction,
     DimensionSelectionType,
@@ -414,7 +438,7 @@ void RandomForest<
     UseBootstrap
 >::Classify(const MatType& data,
             arma::Row<size_t>& predictions,
-            arma::mat& probabilities) const
+            arma::Mat<ElemType>& probabilities) const
 {
   // Check edge case.
   if (trees.size() == 0)
@@ -428,12 +452,67 @@ void RandomForest<
 
   probabilities.set_size(trees[0].NumClasses(), data.n_cols);
   predictions.set_size(data.n_cols);
-  #pragma omp parallel for
-  for (size_t i = 0; i < data.n_cols; ++i)
+  const size_t numBlocks = (data.n_cols + ClassifyBlockSize - 1) /
+      ClassifyBlockSize;
+
+  // Each range of blocks accumulates the probabilities of a block of points at
+  // a time in its own buffer, so that no memory is allocated per point or per
+  // tree.
+  ParallelForRanges(0, numBlocks, [&](const size_t first, const size_t last)
+  {
+    arma::mat blockProbabilities(trees[0].NumClasses(), ClassifyBlockSize);
+
+    for (size_t b = first; b < last; ++b)
+    {
+      const size_t begin = b * ClassifyBlockSize;
+      const size_t end = std::min((size_t) data.n_cols,
+          begin + ClassifyBlockSize);
+      ClassifyBlock(data, begin, end, blockProbabilities);
+      for (size_t i = begin; i < end; ++i)
+      {
+        predictions[i] =
+            (size_t) blockProbabilities.col(i - begin).index_max();
+        for (size_t c = 0; c < probabilities.n_rows; ++c)
+          probabilities(c, i) = (ElemType) blockProbabilities(c, i - begin);
+      }
+    }
+  });
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::ClassifyBlock(const MatType& data,
+                 const size_t begin,
+                 const size_t end,
+                 arma::mat& probabilities) const
+{
+  probabilities.zeros();
+  for (size_t t = 0; t < trees.size(); ++t)
   {
-    arma::vec probs = probabilities.unsafe_col(i);
-    Classify(data.col(i), predictions[i], probs);
+    for (size_t i = begin; i < end; ++i)
+    {
+      // Find the leaf of the point; it holds the class probabilities.
+      const DecisionTreeType* node = &trees[t];
+      while (node->NumChildren() > 0)
+        node = &node->Child(node->CalculateDirection(data.col(i)));
+
+      probabilities.col(i - begin) += node->ClassProbabilities();
+    }
   }
+
+  probabilities /= trees.size();
 }
 
 template<
@@ -468,6 +547,70 @@ void RandomForest<
   ar(CEREAL_NVP(avgGain));
 }
 
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::SaveSections(data::SectionedModelWriter& writer,
+                const bool compress,
+                const std::string& prefix) const
+{
+  const size_t numTrees = trees.size();
+  writer.Add(prefix + "num_trees", numTrees);
+  writer.Add(prefix + "avg_gain", avgGain);
+  for (size_t i = 0; i < trees.size(); ++i)
+    writer.Add(prefix + "tree/" + std::to_string(i), trees[i], compress);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::LoadSections(const data::SectionedModelReader& reader,
+                const size_t numTrees,
+                const std::string& prefix)
+{
+  size_t storedTrees;
+  reader.Load(prefix + "num_trees", storedTrees);
+  if (numTrees > storedTrees)
+  {
+    std::ostringstream oss;
+    oss << "RandomForest::LoadSections(): cannot load " << numTrees
+        << " trees; '" << reader.Filename() << "' only holds " << storedTrees
+        << " trees!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The trees are deserialized in parallel; each one reads its own section.
+  std::vector<DecisionTreeType> loadedTrees((numTrees == 0) ? storedTrees :
+      numTrees);
+  ParallelFor(0, loadedTrees.size(), [&](const size_t i)
+  {
+    reader.Load(prefix + "tree/" + std::to_string(i), loadedTrees[i]);
+  });
+
+  reader.Load(prefix + "avg_gain", avgGain);
+  trees = std::move(loadedTrees);
+}
+
 template<
     typename FitnessFunction,
     typename DimensionSelectionType,
@@ -503,9 +646,19 @@ double RandomForest<
   // Convert avgGain to total gain.
   double totalGain = avgGain * oldNumTrees;
 
-  // Train each tree individually.
-  #pragma omp parallel for reduction( + : totalGain)
-  for (size_t i = 0; i < numTrees; ++i)
+  // Train each tree individually, in parallel with the executor.  The gain of
+  // each tree is kept separately, so the total does not depend on the threads.
+  arma::vec gains(numTrees, arma::fill::zeros);
+
+  // If the out-of-bag error is computed, each tree votes for the class of each
+  // of its out-of-bag points as soon as it is trained.  The votes are counted
+  // with atomic integers, so the tallies do not depend on the threads either.
+  const bool oob = UseBootstrap && computeOOBError;
+  std::vector<std::atomic<size_t>> votes(oob ? numClasses * dataset.n_cols :
+      0);
+  for (size_t j = 0; j < votes.size(); ++j)
+    votes[j].store(0, std::memory_order_relaxed);
+  ParallelFor(0, numTrees, [&](const size_t i)
   {
     // NOTE: this is a hacky workaround for older versions of Armadillo that did
     // not (by default) set a different seed for each RNG.  We simply manually
@@ -525,22 +678,29 @@ double RandomForest<
       #endif
     #endif
 
+    // Scoped timers do not lock, so each tree can be timed in the trace.  The
+    // bootstrap dataset is moved into the tree, which reorders it while it is
+    // trained, so only one copy of it exists for each tree being trained.
+    ScopedTimer treeTimer("random_forest_tree");
     MatType bootstrapDataset;
     arma::Row<size_t> bootstrapLabels;
     arma::rowvec bootstrapWeights;
+    arma::uvec bootstrapIndices;
     if (UseBootstrap)
     {
+      ScopedTimer bootstrapTimer("bootstrap");
       Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
-          bootstrapLabels, bootstrapWeights);
+          bootstrapLabels, bootstrapWeights, bootstrapIndices);
     }
 
     if (UseWeights)
     {
       if (UseDatasetInfo)
       {
-        totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, datasetInfo,
-                bootstrapLabels, numClasses, bootstrapWeights, minimumLeafSize,
+        gains[i] = UseBootstrap ?
+            trees[oldNumTrees + i].Train(std::move(bootstrapDataset),
+                datasetInfo, std::move(bootstrapLabels), numClasses,
+                std::move(bootstrapWeights), minimumLeafSize,
                 minimumGainSplit, maximumDepth, dimensionSelector) :
             trees[oldNumTrees + i].Train(dataset, datasetInfo, labels,
                 numClasses, weights, minimumLeafSize, minimumGainSplit,
@@ -548,9 +708,10 @@ double RandomForest<
       }
       else
       {
-        totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, bootstrapLabels,
-                numClasses, bootstrapWeights, minimumLeafSize,
+        gains[i] = UseBootstrap ?
+            trees[oldNumTrees + i].Train(std::move(bootstrapDataset),
+                std::move(bootstrapLabels), numClasses,
+                std::move(bootstrapWeights), minimumLeafSize,
                 minimumGainSplit, maximumDepth, dimensionSelector) :
             trees[oldNumTrees + i].Train(dataset, labels, numClasses,
                 weights, minimumLeafSize, minimumGainSplit, maximumDepth,
@@ -561,28 +722,91 @@ double RandomForest<
     {
       if (UseDatasetInfo)
       {
-        totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, datasetInfo,
-                bootstrapLabels, numClasses, minimumLeafSize, minimumGainSplit,
-                maximumDepth, dimensionSelector) :
+        gains[i] = UseBootstrap ?
+            trees[oldNumTrees + i].Train(std::move(bootstrapDataset),
+                datasetInfo, std::move(bootstrapLabels), numClasses,
+                minimumLeafSize, minimumGainSplit, maximumDepth,
+                dimensionSelector) :
             trees[oldNumTrees + i].Train(dataset, datasetInfo, labels,
                 numClasses, minimumLeafSize, minimumGainSplit, maximumDepth,
                 dimensionSelector);
       }
       else
       {
-        totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, bootstrapLabels,
-                numClasses, minimumLeafSize, minimumGainSplit, maximumDepth,
-                dimensionSelector) :
+        gains[i] = UseBootstrap ?
+            trees[oldNumTrees + i].Train(std::move(bootstrapDataset),
+                std::move(bootstrapLabels), numClasses, minimumLeafSize,
+                minimumGainSplit, maximumDepth, dimensionSelector) :
             trees[oldNumTrees + i].Train(dataset, labels, numClasses,
                 minimumLeafSize, minimumGainSplit, maximumDepth,
                 dimensionSelector);
       }
     }
-  }
 
+    if (oob)
+    {
+      // The bootstrap indices are sorted, so the points that are not in them
+      // are found in one pass.
+      ScopedTimer oobTimer("random_forest_oob");
+      size_t k = 0;
+      for (size_t j = 0; j < dataset.n_cols; ++j)
+      {
+        if (k < bootstrapIndices.n_elem && bootstrapIndices[k] == j)
+        {
+          while (k < bootstrapIndices.n_elem && bootstrapIndices[k] == j)
+            ++k;
+          continue;
+        }
+
+        const size_t prediction =
+            trees[oldNumTrees + i].Classify(dataset.col(j));
+        votes[j * numClasses + prediction].fetch_add(1,
+            std::memory_order_relaxed);
+      }
+    }
+  });
+
+  totalGain += arma::accu(gains);
   avgGain = totalGain / trees.size();
+
+  if (oob)
+  {
+    // Each point that is out of bag for at least one tree is predicted as the
+    // class with the most votes; the error is the (weighted) fraction of these
+    // points that are misclassified.
+    double errors = 0.0, total = 0.0;
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+    {
+      size_t best = 0, bestVotes = 0, numVotes = 0;
+      for (size_t c = 0; c < numClasses; ++c)
+      {
+        const size_t v = votes[j * numClasses + c].load(
+            std::memory_order_relaxed);
+        numVotes += v;
+        if (v > bestVotes)
+        {
+          best = c;
+          bestVotes = v;
+        }
+      }
+
+      if (numVotes == 0)
+        continue;
+
+      const double weight = UseWeights ? weights[j] : 1.0;
+      total += weight;
+      if (best != labels[j])
+        errors += weight;
+    }
+
+    oobError = (total > 0.0) ? errors / total :
+        std::numeric_limits<double>::quiet_NaN();
+  }
+  else
+  {
+    oobError = std::numeric_limits<double>::quiet_NaN();
+  }
+
   return avgGain;
 }
 
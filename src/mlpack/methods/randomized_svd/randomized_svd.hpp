@@ -13,7 +13,7 @@
 #ifndef MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_HPP
 #define MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_HPP
 
-#include <mlpack/core.hpp>
+#include <mlpack/prereqs.hpp>
 
 namespace mlpack {
 
@@ -61,6 +61,23 @@ namespace mlpack {
  * // Use the Apply() method to get a factorization.
  * rSVD.Apply(data, u, s, v, rank);
  * @endcode
+ *
+ * The decomposition can be computed in single precision by passing matrices
+ * of type arma::fmat (or arma::sp_fmat) and arma::fvec, which halves the
+ * memory traffic of the power iterations.
+ *
+ * Datasets that do not fit in memory can be decomposed with ApplyChunks(),
+ * which reads the data from a chunked source (such as a data::ChunkedLoader
+ * or a data::MatrixChunkLoader) a fixed number of times, and only holds
+ * matrices of the size of a chunk or of the size of the data dimensionality
+ * times the rank:
+ *
+ * @code
+ * data::ChunkedLoader loader("huge_dataset.csv", 100000);
+ * arma::fmat u;
+ * arma::fvec s;
+ * rSVD.ApplyChunks(loader, u, s, rank);
+ * @endcode
  */
 class RandomizedSVD
 {
@@ -80,10 +97,11 @@ class RandomizedSVD
    * @param eps The eps coefficient to avoid division by zero (numerical
    *        stability).
    */
-  RandomizedSVD(const arma::mat& data,
-                arma::mat& u,
-                arma::vec& s,
-                arma::mat& v,
+  template<typename eT>
+  RandomizedSVD(const arma::Mat<eT>& data,
+                arma::Mat<eT>& u,
+                arma::Col<eT>& s,
+                arma::Mat<eT>& v,
                 const size_t iteratedPower = 0,
                 const size_t maxIterations = 2,
                 const size_t rank = 0,
@@ -113,10 +131,11 @@ class RandomizedSVD
    * @param s Diagonal "Sigma" matrix of singular values.
    * @param rank Rank of the approximation.
    */
-  void Apply(const arma::sp_mat& data,
-             arma::mat& u,
-             arma::vec& s,
-             arma::mat& v,
+  template<typename eT>
+  void Apply(const arma::SpMat<eT>& data,
+             arma::Mat<eT>& u,
+             arma::Col<eT>& s,
+             arma::Mat<eT>& v,
              const size_t rank);
 
 /**
@@ -129,10 +148,11 @@ class RandomizedSVD
    * @param s Diagonal "Sigma" matrix of singular values.
    * @param rank Rank of the approximation.
    */
-  void Apply(const arma::mat& data,
-             arma::mat& u,
-             arma::vec& s,
-             arma::mat& v,
+  template<typename eT>
+  void Apply(const arma::Mat<eT>& data,
+             arma::Mat<eT>& u,
+             arma::Col<eT>& s,
+             arma::Mat<eT>& v,
              const size_t rank);
 
   /**
@@ -148,12 +168,34 @@ class RandomizedSVD
    */
   template<typename MatType>
   void Apply(const MatType& data,
-             arma::mat& u,
-             arma::vec& s,
-             arma::mat& v,
+             arma::Mat<typename MatType::elem_type>& u,
+             arma::Col<typename MatType::elem_type>& s,
+             arma::Mat<typename MatType::elem_type>& v,
              const size_t rank,
              MatType rowMean);
 
+  /**
+   * Center the data and compute its left singular vectors and singular values
+   * with the randomized SVD, reading the data from the given chunked source,
+   * one chunk of points (columns) at a time.  The data is read 1 +
+   * max(maxIterations, 1) times: once to compute the mean and a random sketch
+   * of the range, then once per power iteration, the last of which also
+   * computes the Rayleigh-Ritz approximation of the singular values.  The
+   * right singular vectors (one per point) are not computed; they can be
+   * recovered in one more pass as v = (data - mean)^T u diag(1 / s).
+   *
+   * @param loader Chunked source of the data, with Reset(), Next() and
+   *     Dimensionality() methods (such as a data::ChunkedLoader).
+   * @param u Matrix to store the left singular vectors in.
+   * @param s Vector to store the rank largest singular values in.
+   * @param rank Rank of the approximation.
+   */
+  template<typename LoaderType, typename eT>
+  void ApplyChunks(LoaderType& loader,
+                   arma::Mat<eT>& u,
+                   arma::Col<eT>& s,
+                   const size_t rank);
+
   //! Get the size of the normalized power iterations.
   size_t IteratedPower() const { return iteratedPower; }
   //! Modify the size of the normalized power iterations.
@@ -17,11 +17,12 @@
 
 namespace mlpack {
 
+template<typename eT>
 inline RandomizedSVD::RandomizedSVD(
-    const arma::mat& data,
-    arma::mat& u,
-    arma::vec& s,
-    arma::mat& v,
+    const arma::Mat<eT>& data,
+    arma::Mat<eT>& u,
+    arma::Col<eT>& s,
+    arma::Mat<eT>& v,
     const size_t iteratedPower,
     const size_t maxIterations,
     const size_t rank,
@@ -51,42 +52,47 @@ inline RandomizedSVD::RandomizedSVD(
   /* Nothing to do here */
 }
 
-inline void RandomizedSVD::Apply(const arma::sp_mat& data,
-                                 arma::mat& u,
-                                 arma::vec& s,
-                                 arma::mat& v,
+template<typename eT>
+inline void RandomizedSVD::Apply(const arma::SpMat<eT>& data,
+                                 arma::Mat<eT>& u,
+                                 arma::Col<eT>& s,
+                                 arma::Mat<eT>& v,
                                  const size_t rank)
 {
   // Center the data into a temporary matrix for sparse matrix.
-  arma::sp_mat rowMean = sum(data, 1) / data.n_cols;
+  arma::SpMat<eT> rowMean = sum(data, 1) / (eT) data.n_cols;
 
   Apply(data, u, s, v, rank, rowMean);
 }
 
-inline void RandomizedSVD::Apply(const arma::mat& data,
-                                 arma::mat& u,
-                                 arma::vec& s,
-                                 arma::mat& v,
+template<typename eT>
+inline void RandomizedSVD::Apply(const arma::Mat<eT>& data,
+                                 arma::Mat<eT>& u,
+                                 arma::Col<eT>& s,
+                                 arma::Mat<eT>& v,
                                  const size_t rank)
 {
   // Center the data into a temporary matrix.
-  arma::mat rowMean = sum(data, 1) / data.n_cols + eps;
+  arma::Mat<eT> rowMean = sum(data, 1) / (eT) data.n_cols + (eT) eps;
 
   Apply(data, u, s, v, rank, rowMean);
 }
 
 template<typename MatType>
-inline void RandomizedSVD::Apply(const MatType& data,
-                                 arma::mat& u,
-                                 arma::vec& s,
-                                 arma::mat& v,
-                                 const size_t rank,
-                                 MatType rowMean)
+inline void RandomizedSVD::Apply(
+    const MatType& data,
+    arma::Mat<typename MatType::elem_type>& u,
+    arma::Col<typename MatType::elem_type>& s,
+    arma::Mat<typename MatType::elem_type>& v,
+    const size_t rank,
+    MatType rowMean)
 {
+  typedef typename MatType::elem_type ElemType;
+
   if (iteratedPower == 0)
       iteratedPower = rank + 2;
 
-  arma::mat R, Q, Qdata;
+  arma::Mat<ElemType> R, Q, Qdata;
 
   // Apply the centered data matrix to a random matrix, obtaining Q.
   if (data.n_cols >= data.n_rows)
@@ -97,7 +103,7 @@ inline void RandomizedSVD::Apply(const MatType& data,
   else
   {
     R.randn(data.n_cols, iteratedPower);
-    Q = (data * R) - (rowMean * (arma::ones(1, data.n_cols) * R));
+    Q = (data * R) - (rowMean * arma::sum(R, 0));
   }
 
   // Form a matrix Q whose columns constitute a
@@ -116,7 +122,7 @@ inline void RandomizedSVD::Apply(const MatType& data,
   {
     if (data.n_cols >= data.n_rows)
     {
-      Q = (data * Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
+      Q = (data * Q) - rowMean * arma::sum(Q, 0);
       arma::lu(Q, v, Q);
       Q = (data.t() * Q) - repmat(rowMean.t() * Q, data.n_cols, 1);
     }
@@ -124,7 +130,7 @@ inline void RandomizedSVD::Apply(const MatType& data,
     {
       Q = (data.t() * Q) - repmat(rowMean.t() * Q, data.n_cols, 1);
       arma::lu(Q, v, Q);
-      Q = (data * Q) - (rowMean * (arma::ones(1, data.n_cols) * Q));
+      Q = (data * Q) - (rowMean * arma::sum(Q, 0));
     }
 
     // Computing the LU decomposition is more efficient than computing the QR
@@ -146,7 +152,7 @@ inline void RandomizedSVD::Apply(const MatType& data,
   // applied to Q.
   if (data.n_cols >= data.n_rows)
   {
-    Qdata = (data * Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
+    Qdata = (data * Q) - rowMean * arma::sum(Q, 0);
     arma::svd_econ(u, s, v, Qdata);
     v = Q * v;
   }
@@ -158,6 +164,82 @@ inline void RandomizedSVD::Apply(const MatType& data,
   }
 }
 
+template<typename LoaderType, typename eT>
+inline void RandomizedSVD::ApplyChunks(LoaderType& loader,
+                                       arma::Mat<eT>& u,
+                                       arma::Col<eT>& s,
+                                       const size_t rank)
+{
+  const size_t dimensionality = loader.Dimensionality();
+  const size_t sketchSize = std::min((iteratedPower == 0) ? rank + 2 :
+      iteratedPower, dimensionality);
+
+  // First pass: compute the mean, and apply the data to a random matrix.  The
+  // random matrix has one row per point, so it is drawn one chunk at a time,
+  // and its column sums are kept to center the product afterwards.
+  arma::Mat<eT> chunk, Q(dimensionality, sketchSize, arma::fill::zeros), R;
+  arma::Col<eT> mean(dimensionality, arma::fill::zeros);
+  arma::Row<eT> randomSum(sketchSize, arma::fill::zeros);
+  size_t numPoints = 0;
+
+  loader.Reset();
+  while (loader.Next(chunk))
+  {
+    const arma::Mat<eT> random = arma::randn<arma::Mat<eT>>(chunk.n_cols,
+        sketchSize);
+    Q += chunk * random;
+    randomSum += arma::sum(random, 0);
+    mean += arma::sum(chunk, 1);
+    numPoints += chunk.n_cols;
+  }
+
+  if (numPoints == 0)
+  {
+    throw std::invalid_argument("RandomizedSVD::ApplyChunks(): the data "
+        "source is empty!");
+  }
+
+  mean /= (eT) numPoints;
+  Q -= mean * randomSum;
+  arma::qr_econ(Q, R, Q);
+
+  // Each following pass applies the centered data and its transpose to Q,
+  // chunk by chunk.  The last pass also gives the projection of the
+  // covariance on Q, whose eigendecomposition gives the singular vectors.
+  const size_t passes = std::max(maxIterations, (size_t) 1);
+  arma::Mat<eT> product(dimensionality, Q.n_cols);
+  for (size_t pass = 0; pass < passes; ++pass)
+  {
+    product.zeros();
+    loader.Reset();
+    while (loader.Next(chunk))
+    {
+      chunk.each_col() -= mean;
+      product += chunk * (chunk.t() * Q);
+    }
+
+    if (pass < passes - 1)
+      arma::qr_econ(Q, R, product);
+  }
+
+  // Rayleigh-Ritz approximation: Q^T C C^T Q = W diag(s^2) W^T.
+  arma::Mat<eT> projected = Q.t() * product;
+  projected = 0.5 * (projected + projected.t());
+  arma::Col<eT> eigval;
+  arma::Mat<eT> eigvec;
+  if (!arma::eig_sym(eigval, eigvec, projected))
+  {
+    throw std::runtime_error("RandomizedSVD::ApplyChunks(): the "
+        "eigendecomposition failed!");
+  }
+
+  // The eigenvalues are in ascending order.
+  const size_t keep = std::min(rank, (size_t) eigval.n_elem);
+  s = arma::flipud(eigval.tail(keep));
+  s.transform([](const eT x) { return (x > 0) ? std::sqrt(x) : eT(0); });
+  u = Q * arma::fliplr(eigvec.tail_cols(keep));
+}
+
 } // namespace mlpack
 
 #endif
@@ -0,0 +1,178 @@
+/**
+ * @file methods/range_search/range_count_rules.hpp
+ *
+ * Rules for counting the points in range, so that it can be done with arbitrary
+ * tree types without enumerating every result.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_COUNT_RULES_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_COUNT_RULES_HPP
+
+#include <mlpack/core/tree/traversal_info.hpp>
+
+namespace mlpack {
+
+/**
+ * The RangeCountRules class is a template helper class used by the
+ * RangeSearch class to count the reference points in range of each query
+ * point.  When the bound of a reference node lies entirely in the range of a
+ * query point (or of every point of a query node), the descendants of the
+ * reference node are counted at once, without recursing into it or computing
+ * their distances.
+ *
+ * Optionally, the search for a query point stops once its count reaches a
+ * threshold; then the count is exact if it is below the threshold, and at
+ * least the threshold otherwise.
+ *
+ * The rules do not know whether the query and reference sets are the same, so
+ * every pair is counted, including a point with itself.
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ */
+template<typename MetricType, typename TreeType>
+class RangeCountRules
+{
+ public:
+  //! Easy access to MatType.
+  typedef typename TreeType::Mat MatType;
+  //! The type of element held in MatType.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Construct the RangeCountRules object.  This is usually done from within
+   * the RangeSearch class at count time.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param range Range to search for.
+   * @param counts Counts of each query point, which must already be set to
+   *      the right size (usually filled with zeros); the counts are added to.
+   * @param metric Instantiated metric.
+   * @param threshold Count after which the search of a query point stops.
+   */
+  RangeCountRules(const MatType& referenceSet,
+                  const MatType& querySet,
+                  const RangeType<ElemType>& range,
+                  arma::Col<size_t>& counts,
+                  MetricType& metric,
+                  const size_t threshold = SIZE_MAX);
+
+  /**
+   * Compute the base case between the given query point and reference point.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceIndex Index of reference point.
+   */
+  ElemType BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  /**
+   * Get the score for recursion order.  A low score indicates priority for
+   * recursion, while DBL_MAX indicates that the node should not be recursed
+   * into at all (it should be pruned).
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   */
+  ElemType Score(const size_t queryIndex, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  The node is pruned if the
+   * count of the query point has reached the threshold since it was scored.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  ElemType Rescore(const size_t queryIndex,
+                   TreeType& referenceNode,
+                   const ElemType oldScore) const;
+
+  /**
+   * Get the score for recursion order.  A low score indicates priority for
+   * recursion, while DBL_MAX indicates that the node should not be recursed
+   * into at all (it should be pruned).
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   */
+  ElemType Score(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  The nodes are pruned if the
+   * count of every point of the query node has reached the threshold since
+   * they were scored.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  ElemType Rescore(TreeType& queryNode,
+                   TreeType& referenceNode,
+                   const ElemType oldScore) const;
+
+  typedef typename mlpack::TraversalInfo<TreeType> TraversalInfoType;
+
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of scores (that is, calls to RangeDistance()).
+  size_t Scores() const { return scores; }
+
+  //! Get the minimum number of base cases we need to perform to have acceptable
+  //! results.
+  size_t MinimumBaseCases() const { return 0; }
+
+ private:
+  //! The reference set.
+  const MatType& referenceSet;
+
+  //! The query set.
+  const MatType& querySet;
+
+  //! The range of distances for which we are searching.
+  const RangeType<ElemType>& range;
+
+  //! The counts of each query point.
+  arma::Col<size_t>& counts;
+
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! The count after which the search of a query point stops.
+  size_t threshold;
+
+  //! The last query index.
+  size_t lastQueryIndex;
+  //! The last reference index.
+  size_t lastReferenceIndex;
+
+  //! Add the number of points in the given node to the count of the given
+  //! query point.  If the base case has already been calculated, we make sure
+  //! to not count that point twice.
+  void AddNode(const size_t queryIndex, TreeType& referenceNode);
+
+  //! Return whether the count of every point of the query node has reached
+  //! the threshold.
+  bool Saturated(TreeType& queryNode) const;
+
+  TraversalInfoType traversalInfo;
+
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of scores.
+  size_t scores;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "range_count_rules_impl.hpp"
+
+#endif
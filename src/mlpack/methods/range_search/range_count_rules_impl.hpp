@@ -0,0 +1,259 @@
+/**
+ * @file methods/range_search/range_count_rules_impl.hpp
+ *
+ * Implementation of rules for counting the points in range with generic trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_COUNT_RULES_IMPL_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_COUNT_RULES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "range_count_rules.hpp"
+
+namespace mlpack {
+
+template<typename MetricType, typename TreeType>
+RangeCountRules<MetricType, TreeType>::RangeCountRules(
+    const MatType& referenceSet,
+    const MatType& querySet,
+    const RangeType<ElemType>& range,
+    arma::Col<size_t>& counts,
+    MetricType& metric,
+    const size_t threshold) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    range(range),
+    counts(counts),
+    metric(metric),
+    threshold(threshold),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0)
+{
+  // Nothing to do.
+}
+
+//! The base case.  Evaluate the distance between the two points and count the
+//! reference point if it is in range.
+template<typename MetricType, typename TreeType>
+inline mlpack_force_inline
+typename RangeCountRules<MetricType, TreeType>::ElemType
+RangeCountRules<MetricType, TreeType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  // If we have just performed this base case, don't do it again.
+  if ((lastQueryIndex == queryIndex) && (lastReferenceIndex == referenceIndex))
+    return 0.0; // No value to return... this shouldn't do anything bad.
+
+  const ElemType distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
+      referenceSet.unsafe_col(referenceIndex));
+  ++baseCases;
+
+  // Update last indices, so we don't accidentally perform a base case twice.
+  lastQueryIndex = queryIndex;
+  lastReferenceIndex = referenceIndex;
+
+  if (range.Contains(distance))
+    ++counts[queryIndex];
+
+  return distance;
+}
+
+//! Single-tree scoring function.
+template<typename MetricType, typename TreeType>
+typename RangeCountRules<MetricType, TreeType>::ElemType
+RangeCountRules<MetricType, TreeType>::Score(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  // There is nothing left to do for a query point that reached the threshold.
+  if (counts[queryIndex] >= threshold)
+    return DBL_MAX;
+
+  RangeType<ElemType> distances;
+  if (TreeTraits<TreeType>::FirstPointIsCentroid)
+  {
+    // In this situation, we calculate the base case.  So we should check to be
+    // sure we haven't already done that.
+    ElemType baseCase;
+    if (TreeTraits<TreeType>::HasSelfChildren &&
+        (referenceNode.Parent() != NULL) &&
+        (referenceNode.Point(0) == referenceNode.Parent()->Point(0)))
+    {
+      // If the tree has self-children and this is a self-child, the base case
+      // was already calculated.
+      baseCase = referenceNode.Parent()->Stat().LastDistance();
+      lastQueryIndex = queryIndex;
+      lastReferenceIndex = referenceNode.Point(0);
+    }
+    else
+    {
+      // We must calculate the base case by hand.
+      baseCase = BaseCase(queryIndex, referenceNode.Point(0));
+    }
+
+    // This may be possibly loose for non-ball bound trees.
+    distances.Lo() = baseCase - referenceNode.FurthestDescendantDistance();
+    distances.Hi() = baseCase + referenceNode.FurthestDescendantDistance();
+
+    // Update last distance calculation.
+    referenceNode.Stat().LastDistance() = baseCase;
+  }
+  else
+  {
+    distances = referenceNode.RangeDistance(querySet.unsafe_col(queryIndex));
+    ++scores;
+  }
+
+  // If the ranges do not overlap, prune this node.
+  if (!distances.Contains(range))
+    return DBL_MAX;
+
+  // In this case, all of the points in the reference node are in range, so we
+  // can count them without going any deeper.
+  if ((distances.Lo() >= range.Lo()) && (distances.Hi() <= range.Hi()))
+  {
+    AddNode(queryIndex, referenceNode);
+    return DBL_MAX;
+  }
+
+  // Otherwise the score doesn't matter.  Recursion order is irrelevant in
+  // range search.
+  return 0.0;
+}
+
+//! Single-tree rescoring function.
+template<typename MetricType, typename TreeType>
+typename RangeCountRules<MetricType, TreeType>::ElemType
+RangeCountRules<MetricType, TreeType>::Rescore(
+    const size_t queryIndex,
+    TreeType& /* referenceNode */,
+    const ElemType oldScore) const
+{
+  return (counts[queryIndex] >= threshold) ? DBL_MAX : oldScore;
+}
+
+//! Dual-tree scoring function.
+template<typename MetricType, typename TreeType>
+typename RangeCountRules<MetricType, TreeType>::ElemType
+RangeCountRules<MetricType, TreeType>::Score(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  if (Saturated(queryNode))
+    return DBL_MAX;
+
+  RangeType<ElemType> distances;
+  if (TreeTraits<TreeType>::FirstPointIsCentroid)
+  {
+    // It is possible that the base case has already been calculated.
+    ElemType baseCase = 0.0;
+    if ((traversalInfo.LastQueryNode() != NULL) &&
+        (traversalInfo.LastReferenceNode() != NULL) &&
+        (traversalInfo.LastQueryNode()->Point(0) == queryNode.Point(0)) &&
+        (traversalInfo.LastReferenceNode()->Point(0) == referenceNode.Point(0)))
+    {
+      baseCase = traversalInfo.LastBaseCase();
+
+      // Make sure that if BaseCase() is called, we don't count twice.
+      lastQueryIndex = queryNode.Point(0);
+      lastReferenceIndex = referenceNode.Point(0);
+    }
+    else
+    {
+      // We must calculate the base case.
+      baseCase = BaseCase(queryNode.Point(0), referenceNode.Point(0));
+    }
+
+    distances.Lo() = baseCase - queryNode.FurthestDescendantDistance()
+        - referenceNode.FurthestDescendantDistance();
+    distances.Hi() = baseCase + queryNode.FurthestDescendantDistance()
+        + referenceNode.FurthestDescendantDistance();
+
+    // Update the last distances performed for the query and reference node.
+    traversalInfo.LastBaseCase() = baseCase;
+  }
+  else
+  {
+    // Just perform the calculation.
+    distances = referenceNode.RangeDistance(queryNode);
+    ++scores;
+  }
+
+  // If the ranges do not overlap, prune this node.
+  if (!distances.Contains(range))
+    return DBL_MAX;
+
+  // In this case, all of the points in the reference node are in range of
+  // each point in the query node.
+  if ((distances.Lo() >= range.Lo()) && (distances.Hi() <= range.Hi()))
+  {
+    for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+      AddNode(queryNode.Descendant(i), referenceNode);
+    return DBL_MAX; // We don't need to go any deeper.
+  }
+
+  // Otherwise the score doesn't matter.  Recursion order is irrelevant in range
+  // search.
+  traversalInfo.LastQueryNode() = &queryNode;
+  traversalInfo.LastReferenceNode() = &referenceNode;
+  return 0.0;
+}
+
+//! Dual-tree rescoring function.
+template<typename MetricType, typename TreeType>
+typename RangeCountRules<MetricType, TreeType>::ElemType
+RangeCountRules<MetricType, TreeType>::Rescore(
+    TreeType& queryNode,
+    TreeType& /* referenceNode */,
+    const ElemType oldScore) const
+{
+  return Saturated(queryNode) ? DBL_MAX : oldScore;
+}
+
+//! Count all the points in the given node for the given query point.
+template<typename MetricType, typename TreeType>
+void RangeCountRules<MetricType, TreeType>::AddNode(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  // Some types of trees calculate the base case evaluation before Score() is
+  // called, so if the base case has already been calculated, then that point
+  // has already been counted.
+  size_t baseCaseMod = 0;
+  if (TreeTraits<TreeType>::FirstPointIsCentroid &&
+      (queryIndex == lastQueryIndex) &&
+      (referenceNode.Point(0) == lastReferenceIndex))
+  {
+    baseCaseMod = 1;
+  }
+
+  counts[queryIndex] += referenceNode.NumDescendants() - baseCaseMod;
+}
+
+//! Return whether every point of the query node reached the threshold.
+template<typename MetricType, typename TreeType>
+bool RangeCountRules<MetricType, TreeType>::Saturated(
+    TreeType& queryNode) const
+{
+  if (threshold == SIZE_MAX)
+    return false;
+
+  // This usually stops at the first point, until most of the points of the
+  // node have reached the threshold.
+  for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+    if (counts[queryNode.Descendant(i)] < threshold)
+      return false;
+
+  return true;
+}
+
+} // namespace mlpack
+
+#endif
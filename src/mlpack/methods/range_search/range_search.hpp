@@ -16,14 +16,17 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traversal.hpp>
 #include "range_search_stat.hpp"
+#include "range_search_callbacks.hpp"
 
 namespace mlpack {
 
 //! Forward declaration.
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
+                  typename TreeMatType> class TreeType,
+         typename MatType>
 class LeafSizeRSWrapper;
 
 /**
@@ -197,6 +200,75 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<ElemType>>& distances);
 
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, returning the results in compressed sparse row (CSR) form.
+   * This uses far fewer allocations than the vector-of-vectors overload when
+   * there are many results.  The results for query point i are
+   * neighbors[offsets[i]] to neighbors[offsets[i + 1] - 1], with the
+   * corresponding distances in the same positions of distances; they are not
+   * sorted in any particular order.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param offsets Offset of the results of each query point; this will have
+   *      one more element than the number of query points.
+   * @param neighbors Indices of the reference points in range of each query
+   *      point.
+   * @param distances Distances of the reference points in range of each query
+   *      point.
+   */
+  void Search(const MatType& querySet,
+              const RangeType<ElemType>& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::Col<ElemType>& distances);
+
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, passing each result to the given callback as soon as it is
+   * found instead of storing it.  The callback is called as
+   *
+   * @code
+   * callback(queryIndex, referenceIndex, distance);
+   * @endcode
+   *
+   * where the indices refer to the original query and reference sets.  Results
+   * are passed in no particular order.  For example, to count the reference
+   * points in range of each query point:
+   *
+   * @code
+   * arma::Col<size_t> counts(querySet.n_cols, arma::fill::zeros);
+   * rs.Search(querySet, range, [&](size_t q, size_t, double) { ++counts[q]; });
+   * @endcode
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param callback Callback to pass each result to.
+   */
+  template<typename CallbackType>
+  void Search(const MatType& querySet,
+              const RangeType<ElemType>& range,
+              CallbackType&& callback);
+
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, like the overload of Search() above, but split the search into
+   * tasks that run in parallel (see NumParallelTasks()).  The callback may then
+   * be called from several threads at once; but all the results of a query
+   * point are passed from the same thread, so a callback that only modifies
+   * the state of its query point (a sum over its neighbors, for instance) needs
+   * no synchronization.  Traversal statistics are not collected.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param callback Callback to pass each result to.
+   */
+  template<typename CallbackType>
+  void ParallelSearch(const MatType& querySet,
+                      const RangeType<ElemType>& range,
+                      CallbackType&& callback);
+
   /**
    * Given a pre-built query tree, search for all reference points in the given
    * range for each point in the query set, returning the results in the
@@ -238,6 +310,22 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<ElemType>>& distances);
 
+  /**
+   * Given a pre-built query tree, search for all reference points in the given
+   * range for each point in the query set, passing each result to the given
+   * callback as `callback(queryIndex, referenceIndex, distance)`.  Query
+   * indices refer to the dataset of the query tree.  See the overload that
+   * takes a query set for details.
+   *
+   * @param queryTree Tree built on query points.
+   * @param range Range of distances in which to search.
+   * @param callback Callback to pass each result to.
+   */
+  template<typename CallbackType>
+  void Search(Tree* queryTree,
+              const RangeType<ElemType>& range,
+              CallbackType&& callback);
+
   /**
    * Search for all points in the given range for each point in the reference
    * set (which was passed to the constructor), returning the results in the
@@ -271,6 +359,88 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<ElemType>>& distances);
 
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, returning the results in compressed sparse row (CSR) form.  See the
+   * overload that takes a query set for details.  A point is never returned
+   * in its own results.
+   *
+   * @param range Range of distances in which to search.
+   * @param offsets Offset of the results of each point; this will have one more
+   *      element than the number of reference points.
+   * @param neighbors Indices of the points in range of each point.
+   * @param distances Distances of the points in range of each point.
+   */
+  void Search(const RangeType<ElemType>& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::Col<ElemType>& distances);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, passing each result to the given callback as
+   * `callback(queryIndex, referenceIndex, distance)`.  See the overload that
+   * takes a query set for details.  A point is never returned in its own
+   * results.
+   *
+   * @param range Range of distances in which to search.
+   * @param callback Callback to pass each result to.
+   */
+  template<typename CallbackType>
+  void Search(const RangeType<ElemType>& range, CallbackType&& callback);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set in parallel, passing each result to the given callback.  See the
+   * overload of ParallelSearch() that takes a query set for details.  A point
+   * is never returned in its own results.
+   *
+   * @param range Range of distances in which to search.
+   * @param callback Callback to pass each result to.
+   */
+  template<typename CallbackType>
+  void ParallelSearch(const RangeType<ElemType>& range,
+                      CallbackType&& callback);
+
+  /**
+   * Count the reference points in the given range of each point in the query
+   * set, without storing them.  When a reference node lies entirely in the
+   * range of a query point (or of every point of a query node), its points are
+   * counted at once, without visiting them; so this is much faster than
+   * counting the results of Search() when the ranges hold many points, and it
+   * only needs one count per query point.
+   *
+   * If a threshold is given, the search of a query point stops as soon as its
+   * count reaches the threshold: then counts[i] is exact if it is less than the
+   * threshold, and at least the threshold otherwise.  This is enough to find
+   * the points with at least a given number of neighbors (like the core points
+   * of DBSCAN), and is faster still.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param counts Number of reference points in range of each query point.
+   * @param threshold Count after which the search of a query point stops, or 0
+   *      to count every point.
+   */
+  void Count(const MatType& querySet,
+             const RangeType<ElemType>& range,
+             arma::Col<size_t>& counts,
+             const size_t threshold = 0);
+
+  /**
+   * Count the points in the given range of each point in the reference set.
+   * See the overload that takes a query set for details.  A point is never
+   * counted in its own range.
+   *
+   * @param range Range of distances in which to search.
+   * @param counts Number of points in range of each point.
+   * @param threshold Count after which the search of a point stops, or 0 to
+   *      count every point.
+   */
+  void Count(const RangeType<ElemType>& range,
+             arma::Col<size_t>& counts,
+             const size_t threshold = 0);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -286,6 +456,15 @@ class RangeSearch
   //! Get the number of scores during the last search.
   size_t Scores() const { return scores; }
 
+  /**
+   * Get the statistics of the tree traversals of the last search.  These are
+   * only collected when Statistics().Enabled() is true; see
+   * TraversalStatistics.  Naive search does not collect statistics.
+   */
+  const TraversalStatistics& Statistics() const { return statistics; }
+  //! Modify the statistics of the tree traversals.
+  TraversalStatistics& Statistics() { return statistics; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t version);
@@ -320,9 +499,25 @@ class RangeSearch
   size_t baseCases;
   //! The total number of scores during the last search.
   size_t scores;
+  //! The statistics of the tree traversals of the last search.
+  TraversalStatistics statistics;
+
+  /**
+   * Search the given query points (or query tree, unless it is NULL) in
+   * parallel, and pass each result to the callback after mapping its indices
+   * with the given mappings (unless they are NULL).
+   */
+  template<typename CallbackType>
+  void ParallelSearchImpl(const MatType& querySet,
+                          Tree* queryTree,
+                          const RangeType<ElemType>& range,
+                          CallbackType& callback,
+                          const std::vector<size_t>* oldFromNewQueries,
+                          const std::vector<size_t>* oldFromNewReferences,
+                          const bool sameSet);
 
   //! For access to mappings when building models.
-  friend class LeafSizeRSWrapper<TreeType>;
+  friend class LeafSizeRSWrapper<TreeType, MatType>;
 };
 
 } // namespace mlpack
@@ -330,4 +525,15 @@ class RangeSearch
 // Include implementation.
 #include "range_search_impl.hpp"
 
+// If MLPACK_USE_PREBUILT is defined, the common instantiations below are
+// compiled into libmlpack (see BUILD_PREBUILT_LIBRARY), and are not
+// instantiated again here.
+#ifdef MLPACK_USE_PREBUILT
+namespace mlpack {
+
+extern template class RangeSearch<EuclideanDistance, arma::mat, KDTree>;
+
+} // namespace mlpack
+#endif
+
 #endif
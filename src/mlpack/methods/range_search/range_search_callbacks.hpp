@@ -0,0 +1,183 @@
+/**
+ * @file methods/range_search/range_search_callbacks.hpp
+ *
+ * Callbacks that receive the results of a range search one hit at a time.
+ * The RangeSearchRules class hands each (query, reference, distance) triple
+ * that falls in the search range to a callback of this form.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_CALLBACKS_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_CALLBACKS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * A callback that stores each range search result in a vector of neighbors and
+ * a vector of distances per query point.  This is the output format of
+ * RangeSearch::Search() with std::vector<std::vector<>> results.
+ *
+ * @tparam ElemType Type of the distances.
+ */
+template<typename ElemType>
+class RangeSearchVectorCallback
+{
+ public:
+  /**
+   * Create the callback.  The outer vectors must already have one entry for
+   * each query point.
+   *
+   * @param neighbors Vector of neighbors of each query point.
+   * @param distances Vector of distances of each query point.
+   */
+  RangeSearchVectorCallback(std::vector<std::vector<size_t>>& neighbors,
+                            std::vector<std::vector<ElemType>>& distances) :
+      neighbors(&neighbors),
+      distances(&distances)
+  {
+    // Nothing to do.
+  }
+
+  //! Store the given result.
+  void operator()(const size_t queryIndex,
+                  const size_t referenceIndex,
+                  const ElemType distance)
+  {
+    (*neighbors)[queryIndex].push_back(referenceIndex);
+    (*distances)[queryIndex].push_back(distance);
+  }
+
+ private:
+  //! The vector of neighbors of each query point.
+  std::vector<std::vector<size_t>>* neighbors;
+  //! The vector of distances of each query point.
+  std::vector<std::vector<ElemType>>* distances;
+};
+
+/**
+ * A callback that stores every range search result as a flat (query,
+ * reference, distance) triple, in the order the results are found.  This is
+ * used to build the compressed sparse row output of RangeSearch::Search()
+ * without allocating a vector for each query point.
+ *
+ * @tparam ElemType Type of the distances.
+ */
+template<typename ElemType>
+class RangeSearchFlatCallback
+{
+ public:
+  //! Store the given result.
+  void operator()(const size_t queryIndex,
+                  const size_t referenceIndex,
+                  const ElemType distance)
+  {
+    queries.push_back(queryIndex);
+    neighbors.push_back(referenceIndex);
+    distances.push_back(distance);
+  }
+
+  /**
+   * Move the stored results into compressed sparse row form: the results of
+   * query point i are neighbors[offsets[i]] to neighbors[offsets[i + 1] - 1]
+   * (and likewise for distances), in the order they were found.
+   *
+   * @param numQueries Number of query points.
+   * @param offsets Offset of the results of each query point; this will have
+   *     numQueries + 1 elements.
+   * @param neighborsOut Indices of the neighbors of all query points.
+   * @param distancesOut Distances of the neighbors of all query points.
+   */
+  void ToCSR(const size_t numQueries,
+             arma::Col<size_t>& offsets,
+             arma::Col<size_t>& neighborsOut,
+             arma::Col<ElemType>& distancesOut)
+  {
+    offsets.zeros(numQueries + 1);
+    for (size_t i = 0; i < queries.size(); ++i)
+      ++offsets[queries[i] + 1];
+    for (size_t i = 0; i < numQueries; ++i)
+      offsets[i + 1] += offsets[i];
+
+    // A stable counting sort keeps the order in which results were found.
+    neighborsOut.set_size(queries.size());
+    distancesOut.set_size(queries.size());
+    arma::Col<size_t> next = offsets.head(numQueries);
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+      const size_t pos = next[queries[i]]++;
+      neighborsOut[pos] = neighbors[i];
+      distancesOut[pos] = distances[i];
+    }
+
+    queries.clear();
+    neighbors.clear();
+    distances.clear();
+  }
+
+ private:
+  //! The query point of each result.
+  std::vector<size_t> queries;
+  //! The reference point of each result.
+  std::vector<size_t> neighbors;
+  //! The distance of each result.
+  std::vector<ElemType> distances;
+};
+
+/**
+ * A callback that maps the query and reference indices of each result back to
+ * their indices in the original datasets (when trees have rearranged the
+ * points) before passing it to another callback.
+ *
+ * @tparam CallbackType Type of the callback to pass the results to.
+ */
+template<typename CallbackType>
+class RangeSearchMappedCallback
+{
+ public:
+  /**
+   * Create the callback.
+   *
+   * @param callback Callback to pass the mapped results to.
+   * @param oldFromNewQueries Mappings of query indices, or NULL if the query
+   *     indices do not need to be mapped.
+   * @param oldFromNewReferences Mappings of reference indices, or NULL if the
+   *     reference indices do not need to be mapped.
+   */
+  RangeSearchMappedCallback(CallbackType& callback,
+                            const std::vector<size_t>* oldFromNewQueries,
+                            const std::vector<size_t>* oldFromNewReferences) :
+      callback(&callback),
+      oldFromNewQueries(oldFromNewQueries),
+      oldFromNewReferences(oldFromNewReferences)
+  {
+    // Nothing to do.
+  }
+
+  //! Map the given result and pass it to the callback.
+  template<typename ElemType>
+  void operator()(const size_t queryIndex,
+                  const size_t referenceIndex,
+                  const ElemType distance)
+  {
+    (*callback)(oldFromNewQueries ? (*oldFromNewQueries)[queryIndex] :
+        queryIndex, oldFromNewReferences ?
+        (*oldFromNewReferences)[referenceIndex] : referenceIndex, distance);
+  }
+
+ private:
+  //! The callback to pass the mapped results to.
+  CallbackType* callback;
+  //! Mappings of query indices (or NULL).
+  const std::vector<size_t>* oldFromNewQueries;
+  //! Mappings of reference indices (or NULL).
+  const std::vector<size_t>* oldFromNewReferences;
+};
+
+} // namespace mlpack
+
+#endif
@@ -17,6 +17,7 @@
 
 // The rules for traversal.
 #include "range_search_rules.hpp"
+#include "range_count_rules.hpp"
 
 namespace mlpack {
 
@@ -109,7 +110,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(other.singleMode),
     metric(other.metric),
     baseCases(other.baseCases),
-    scores(other.scores)
+    scores(other.scores),
+    statistics(other.statistics)
 {
   // Nothing to do.
 }
@@ -128,7 +130,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
     singleMode(other.singleMode),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
-    scores(other.scores)
+    scores(other.scores),
+    statistics(other.statistics)
 {
   // Clear other object.
   other.referenceTree =
@@ -162,6 +165,7 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(const RangeSearch& other)
     metric = other.metric;
     baseCases = other.baseCases;
     scores = other.scores;
+    statistics = other.statistics;
   }
   return *this;
 }
@@ -192,6 +196,7 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(RangeSearch&& other)
     metric = std::move(other.metric);
     baseCases = other.baseCases;
     scores = other.scores;
+    statistics = other.statistics;
 
     // Clear other object.
     other.referenceTree = nullptr;
@@ -297,50 +302,70 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   if (referenceSet->n_cols == 0)
     return;
 
-  // This will hold mappings for query points, if necessary.
-  std::vector<size_t> oldFromNewQueries;
+  neighbors.clear(); // Just in case there was anything in it.
+  neighbors.resize(querySet.n_cols);
+  distances.clear();
+  distances.resize(querySet.n_cols);
 
-  // If we have built the trees ourselves, then we will have to map all the
-  // indices back to their original indices when this computation is finished.
-  // To avoid extra copies, we will store the unmapped neighbors and distances
-  // in a separate object.
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-  std::vector<std::vector<ElemType>>* distancePtr = &distances;
+  RangeSearchVectorCallback<ElemType> callback(neighbors, distances);
+  Search(querySet, range, callback);
+}
 
-  // Mapping is only necessary if the tree rearranges points.
-  if (TreeTraits<Tree>::RearrangesDataset)
-  {
-    // Query indices only need to be mapped if we are building the query tree
-    // ourselves.
-    if (!singleMode && !naive)
-    {
-      distancePtr = new std::vector<std::vector<ElemType>>;
-      neighborPtr = new std::vector<std::vector<size_t>>;
-    }
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const RangeType<ElemType>& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::Col<ElemType>& distances)
+{
+  RangeSearchFlatCallback<ElemType> callback;
+  Search(querySet, range, callback);
+  callback.ToCSR(querySet.n_cols, offsets, neighbors, distances);
+}
 
-    // Reference indices only need to be mapped if we built the reference tree
-    // ourselves.
-    else if (treeOwner)
-      neighborPtr = new std::vector<std::vector<size_t>>;
-  }
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const RangeType<ElemType>& range,
+    CallbackType&& callback)
+{
+  util::CheckSameDimensionality(querySet, *referenceSet,
+      "RangeSearch::Search()", "query set");
 
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(querySet.n_cols);
-  distancePtr->clear();
-  distancePtr->resize(querySet.n_cols);
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
 
-  // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
+  // Reference indices only need to be mapped if we built the reference tree
+  // ourselves.
+  const std::vector<size_t>* referenceMapping =
+      (TreeTraits<Tree>::RearrangesDataset && treeOwner && !naive) ?
+      &oldFromNewReferences : NULL;
 
   // Reset counts.
   baseCases = 0;
   scores = 0;
+  statistics.Reset();
+
+  typedef typename std::remove_reference<CallbackType>::type UserCallbackType;
+  typedef RangeSearchMappedCallback<UserCallbackType> MappedCallbackType;
+  typedef InstrumentedRules<RangeSearchRules<MetricType, Tree,
+      MappedCallbackType>> RuleType;
 
   if (naive)
   {
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
+    RuleType rules(NULL, *referenceSet, querySet, range,
+        MappedCallbackType(callback, NULL, NULL), metric);
 
     // The naive brute-force solution.
     for (size_t i = 0; i < querySet.n_cols; ++i)
@@ -352,7 +377,8 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   else if (singleMode)
   {
     // Create the traverser.
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
+    RuleType rules(statistics.Enabled() ? &statistics : NULL, *referenceSet,
+        querySet, range, MappedCallbackType(callback, NULL, referenceMapping),
         metric);
     typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
@@ -365,12 +391,16 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
   else // Dual-tree recursion.
   {
-    // Build the query tree.
+    // Build the query tree.  If it rearranges the query points, their indices
+    // must be mapped back too.
+    std::vector<size_t> oldFromNewQueries;
     Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
 
     // Create the traverser.
-    RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-        *distancePtr, metric);
+    RuleType rules(statistics.Enabled() ? &statistics : NULL, *referenceSet,
+        queryTree->Dataset(), range, MappedCallbackType(callback,
+        TreeTraits<Tree>::RearrangesDataset ? &oldFromNewQueries : NULL,
+        referenceMapping), metric);
     typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
     traverser.Traverse(*queryTree, *referenceTree);
@@ -381,72 +411,6 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     // Clean up tree memory.
     delete queryTree;
   }
-
-  // Map points back to original indices, if necessary.
-  if (TreeTraits<Tree>::RearrangesDataset)
-  {
-    if (!singleMode && !naive && treeOwner)
-    {
-      // We must map both query and reference indices.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-      distances.clear();
-      distances.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < distances.size(); ++i)
-      {
-        // Map distances (copy a column).
-        const size_t queryMapping = oldFromNewQueries[i];
-        distances[queryMapping] = (*distancePtr)[i];
-
-        // Copy each neighbor individually, because we need to map it.
-        neighbors[queryMapping].resize(distances[queryMapping].size());
-        for (size_t j = 0; j < distances[queryMapping].size(); ++j)
-          neighbors[queryMapping][j] =
-              oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
-
-      // Finished with temporary objects.
-      delete neighborPtr;
-      delete distancePtr;
-    }
-    else if (!singleMode && !naive)
-    {
-      // We must map query indices only.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-      distances.clear();
-      distances.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < distances.size(); ++i)
-      {
-        // Map distances and neighbors (copy a column).
-        const size_t queryMapping = oldFromNewQueries[i];
-        distances[queryMapping] = (*distancePtr)[i];
-        neighbors[queryMapping] = (*neighborPtr)[i];
-      }
-
-      // Finished with temporary objects.
-      delete neighborPtr;
-      delete distancePtr;
-    }
-    else if (treeOwner)
-    {
-      // We must map reference indices only.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < neighbors.size(); ++i)
-      {
-        neighbors[i].resize((*neighborPtr)[i].size());
-        for (size_t j = 0; j < neighbors[i].size(); ++j)
-          neighbors[i][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
-
-      // Finished with temporary object.
-      delete neighborPtr;
-    }
-  }
 }
 
 template<typename MetricType,
@@ -464,30 +428,55 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   if (referenceSet->n_cols == 0)
     return;
 
-  // Get a reference to the query set.
-  const MatType& querySet = queryTree->Dataset();
-
   // Make sure we are in dual-tree mode.
   if (singleMode || naive)
     throw std::invalid_argument("cannot call RangeSearch::Search() with a "
         "query tree when naive or singleMode are set to true");
 
-  // We won't need to map query indices, but will we need to map distances?
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
+  neighbors.clear(); // Just in case there was anything in it.
+  neighbors.resize(queryTree->Dataset().n_cols);
+  distances.clear();
+  distances.resize(queryTree->Dataset().n_cols);
 
-  if (treeOwner && TreeTraits<Tree>::RearrangesDataset)
-    neighborPtr = new std::vector<std::vector<size_t>>;
+  RangeSearchVectorCallback<ElemType> callback(neighbors, distances);
+  Search(queryTree, range, callback);
+}
 
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(querySet.n_cols);
-  distances.clear();
-  distances.resize(querySet.n_cols);
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    Tree* queryTree,
+    const RangeType<ElemType>& range,
+    CallbackType&& callback)
+{
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  // Make sure we are in dual-tree mode.
+  if (singleMode || naive)
+    throw std::invalid_argument("cannot call RangeSearch::Search() with a "
+        "query tree when naive or singleMode are set to true");
+
+  // We won't need to map query indices, but we may need to map reference
+  // indices.
+  const std::vector<size_t>* referenceMapping =
+      (TreeTraits<Tree>::RearrangesDataset && treeOwner) ?
+      &oldFromNewReferences : NULL;
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-      distances, metric);
+  statistics.Reset();
+  typedef typename std::remove_reference<CallbackType>::type UserCallbackType;
+  typedef RangeSearchMappedCallback<UserCallbackType> MappedCallbackType;
+  typedef InstrumentedRules<RangeSearchRules<MetricType, Tree,
+      MappedCallbackType>> RuleType;
+  RuleType rules(statistics.Enabled() ? &statistics : NULL, *referenceSet,
+      queryTree->Dataset(), range, MappedCallbackType(callback, NULL,
+      referenceMapping), metric);
 
   // Create the traverser.
   typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
@@ -496,23 +485,109 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   baseCases = rules.BaseCases();
   scores = rules.Scores();
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const RangeType<ElemType>& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<ElemType>>& distances)
+{
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  neighbors.clear(); // Just in case there was anything in it.
+  neighbors.resize(referenceSet->n_cols);
+  distances.clear();
+  distances.resize(referenceSet->n_cols);
+
+  RangeSearchVectorCallback<ElemType> callback(neighbors, distances);
+  Search(range, callback);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const RangeType<ElemType>& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::Col<ElemType>& distances)
+{
+  RangeSearchFlatCallback<ElemType> callback;
+  Search(range, callback);
+  callback.ToCSR(referenceSet->n_cols, offsets, neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const RangeType<ElemType>& range,
+    CallbackType&& callback)
+{
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  // Here, we will use the query set as the reference set, so both the query
+  // and reference indices must be mapped if we built the tree.
+  const std::vector<size_t>* mapping =
+      (TreeTraits<Tree>::RearrangesDataset && treeOwner) ?
+      &oldFromNewReferences : NULL;
 
-  // Do we need to map indices?
-  if (treeOwner && TreeTraits<Tree>::RearrangesDataset)
+  // Create the helper object for the traversal.
+  statistics.Reset();
+  typedef typename std::remove_reference<CallbackType>::type UserCallbackType;
+  typedef RangeSearchMappedCallback<UserCallbackType> MappedCallbackType;
+  typedef InstrumentedRules<RangeSearchRules<MetricType, Tree,
+      MappedCallbackType>> RuleType;
+  RuleType rules((statistics.Enabled() && !naive) ? &statistics : NULL,
+      *referenceSet, *referenceSet, range, MappedCallbackType(callback,
+      mapping, mapping), metric,
+      true /* don't return the query in the results */);
+
+  if (naive)
   {
-    // We must map reference indices only.
-    neighbors.clear();
-    neighbors.resize(querySet.n_cols);
+    // The naive brute-force solution.
+    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+      for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        rules.BaseCase(i, j);
 
-    for (size_t i = 0; i < neighbors.size(); ++i)
-    {
-      neighbors[i].resize((*neighborPtr)[i].size());
-      for (size_t j = 0; j < neighbors[i].size(); ++j)
-        neighbors[i][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-    }
+    baseCases = (referenceSet->n_cols * referenceSet->n_cols);
+    scores = 0;
+  }
+  else if (singleMode)
+  {
+    // Create the traverser.
+    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+    // Now have it traverse for each point.
+    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+  }
+  else // Dual-tree recursion.
+  {
+    // Create the traverser.
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+
+    traverser.Traverse(*referenceTree, *referenceTree);
 
-    // Finished with temporary object.
-    delete neighborPtr;
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
   }
 }
 
@@ -521,45 +596,205 @@ template<typename MetricType,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void RangeSearch<MetricType, MatType, TreeType>::Search(
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType>::ParallelSearch(
+    const MatType& querySet,
     const RangeType<ElemType>& range,
-    std::vector<std::vector<size_t>>& neighbors,
-    std::vector<std::vector<ElemType>>& distances)
+    CallbackType&& callback)
 {
+  util::CheckSameDimensionality(querySet, *referenceSet,
+      "RangeSearch::ParallelSearch()", "query set");
+
   // If there are no points, there is no search to be done.
   if (referenceSet->n_cols == 0)
     return;
 
-  // Here, we will use the query set as the reference set.
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-  std::vector<std::vector<ElemType>>* distancePtr = &distances;
+  // Reference indices only need to be mapped if we built the reference tree
+  // ourselves.
+  const std::vector<size_t>* referenceMapping =
+      (TreeTraits<Tree>::RearrangesDataset && treeOwner && !naive) ?
+      &oldFromNewReferences : NULL;
 
-  if (TreeTraits<Tree>::RearrangesDataset && treeOwner)
+  if (naive || singleMode)
+  {
+    ParallelSearchImpl(querySet, NULL, range, callback, NULL, referenceMapping,
+        false);
+  }
+  else
   {
-    // We will always need to rearrange in this case.
-    distancePtr = new std::vector<std::vector<ElemType>>;
-    neighborPtr = new std::vector<std::vector<size_t>>;
+    // Build the query tree.  If it rearranges the query points, their indices
+    // must be mapped back too.
+    std::vector<size_t> oldFromNewQueries;
+    Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+    ParallelSearchImpl(queryTree->Dataset(), queryTree, range, callback,
+        TreeTraits<Tree>::RearrangesDataset ? &oldFromNewQueries : NULL,
+        referenceMapping, false);
+
+    delete queryTree;
   }
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType>::ParallelSearch(
+    const RangeType<ElemType>& range,
+    CallbackType&& callback)
+{
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
 
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(referenceSet->n_cols);
-  distancePtr->clear();
-  distancePtr->resize(referenceSet->n_cols);
+  // Here, we will use the query set as the reference set, so both the query
+  // and reference indices must be mapped if we built the tree.  The reference
+  // tree is also the query tree; the rules only write the statistics of
+  // reference nodes in single-tree search, so its subtrees can be traversed in
+  // parallel.
+  const std::vector<size_t>* mapping =
+      (TreeTraits<Tree>::RearrangesDataset && treeOwner) ?
+      &oldFromNewReferences : NULL;
+  ParallelSearchImpl(*referenceSet, (naive || singleMode) ? NULL :
+      referenceTree, range, callback, mapping, mapping,
+      true /* don't return the query in the results */);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const MatType& querySet,
+    const RangeType<ElemType>& range,
+    arma::Col<size_t>& counts,
+    const size_t threshold)
+{
+  util::CheckSameDimensionality(querySet, *referenceSet,
+      "RangeSearch::Count()", "query set");
+
+  counts.zeros(querySet.n_cols);
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  // Reset counts.
+  baseCases = 0;
+  scores = 0;
+  statistics.Reset();
+
+  // The counts do not depend on the order of the reference points, so only the
+  // query indices may need to be mapped.
+  const size_t limit = (threshold == 0) ? SIZE_MAX : threshold;
+  typedef InstrumentedRules<RangeCountRules<MetricType, Tree>> RuleType;
+
+  if (naive)
+  {
+    RuleType rules(NULL, *referenceSet, querySet, range, counts, metric,
+        limit);
+
+    // The naive brute-force solution.
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+    {
+      for (size_t j = 0; j < referenceSet->n_cols && counts[i] < limit; ++j)
+        rules.BaseCase(i, j);
+    }
+
+    baseCases = rules.BaseCases();
+  }
+  else if (singleMode)
+  {
+    // Create the traverser.
+    RuleType rules(statistics.Enabled() ? &statistics : NULL, *referenceSet,
+        querySet, range, counts, metric, limit);
+    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+    // Now have it traverse for each point.
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+  }
+  else // Dual-tree recursion.
+  {
+    // Build the query tree.  If it rearranges the query points, their counts
+    // must be mapped back.
+    std::vector<size_t> oldFromNewQueries;
+    Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+
+    arma::Col<size_t> treeCounts(querySet.n_cols, arma::fill::zeros);
+    RuleType rules(statistics.Enabled() ? &statistics : NULL, *referenceSet,
+        queryTree->Dataset(), range, treeCounts, metric, limit);
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+
+    traverser.Traverse(*queryTree, *referenceTree);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+
+    if (TreeTraits<Tree>::RearrangesDataset)
+    {
+      for (size_t i = 0; i < treeCounts.n_elem; ++i)
+        counts[oldFromNewQueries[i]] = treeCounts[i];
+    }
+    else
+    {
+      counts = std::move(treeCounts);
+    }
+
+    // Clean up tree memory.
+    delete queryTree;
+  }
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const RangeType<ElemType>& range,
+    arma::Col<size_t>& counts,
+    const size_t threshold)
+{
+  counts.zeros(referenceSet->n_cols);
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  // The rules count each point in its own range (if the range holds 0), so
+  // that whole nodes can be counted; it is subtracted at the end.
+  const size_t self = range.Contains(ElemType(0)) ? 1 : 0;
+  const size_t limit = (threshold == 0) ? SIZE_MAX : threshold + self;
+
+  // Here, the query set is the reference set, so the counts are in the order of
+  // the reference tree and must be mapped if we built it.
+  const bool mapped = (TreeTraits<Tree>::RearrangesDataset && treeOwner &&
+      !naive);
+  arma::Col<size_t> treeCounts(referenceSet->n_cols, arma::fill::zeros);
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
-      *distancePtr, metric, true /* don't return the query in the results */);
+  statistics.Reset();
+  typedef InstrumentedRules<RangeCountRules<MetricType, Tree>> RuleType;
+  RuleType rules((statistics.Enabled() && !naive) ? &statistics : NULL,
+      *referenceSet, *referenceSet, range, treeCounts, metric, limit);
 
   if (naive)
   {
     // The naive brute-force solution.
     for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
+    {
+      for (size_t j = 0; j < referenceSet->n_cols && treeCounts[i] < limit;
+           ++j)
         rules.BaseCase(i, j);
+    }
 
-    baseCases = (referenceSet->n_cols * referenceSet->n_cols);
+    baseCases = rules.BaseCases();
     scores = 0;
   }
   else if (singleMode)
@@ -585,32 +820,101 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     scores = rules.Scores();
   }
 
-  // Do we need to map the reference indices?
-  if (treeOwner && TreeTraits<Tree>::RearrangesDataset)
-  {
-    neighbors.clear();
-    neighbors.resize(referenceSet->n_cols);
-    distances.clear();
-    distances.resize(referenceSet->n_cols);
+  // Remove the point itself from its count.  It was counted, unless the search
+  // of the point stopped at the threshold; then the count is still at least
+  // the threshold.
+  for (size_t i = 0; i < treeCounts.n_elem; ++i)
+    counts[mapped ? oldFromNewReferences[i] : i] = treeCounts[i] - self;
+}
 
-    for (size_t i = 0; i < distances.size(); ++i)
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType>::ParallelSearchImpl(
+    const MatType& querySet,
+    Tree* queryTree,
+    const RangeType<ElemType>& range,
+    CallbackType& callback,
+    const std::vector<size_t>* oldFromNewQueries,
+    const std::vector<size_t>* oldFromNewReferences,
+    const bool sameSet)
+{
+  statistics.Reset();
+  typedef typename std::remove_reference<CallbackType>::type UserCallbackType;
+  typedef RangeSearchMappedCallback<UserCallbackType> MappedCallbackType;
+  typedef RangeSearchRules<MetricType, Tree, MappedCallbackType> RuleType;
+
+  size_t totalBaseCases = 0;
+  size_t totalScores = 0;
+  if (queryTree == NULL)
+  {
+    // Each task searches a block of query points with its own rules.  The
+    // single-tree rules of trees whose first point is the centroid write the
+    // statistics of the reference nodes, so that search can't be split.
+    const size_t numQueries = querySet.n_cols;
+    const size_t numBlocks = (!naive &&
+        TreeTraits<Tree>::FirstPointIsCentroid) ? 1 :
+        NumParallelTasks(numQueries);
+    const size_t blockSize = (numQueries + numBlocks - 1) / numBlocks;
+
+    #pragma omp parallel for schedule(dynamic) \
+        reduction(+:totalBaseCases, totalScores) num_threads((int) NumThreads())
+    for (size_t b = 0; b < numBlocks; ++b)
     {
-      // Map distances (copy a column).
-      const size_t refMapping = oldFromNewReferences[i];
-      distances[refMapping] = (*distancePtr)[i];
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, numQueries);
 
-      // Copy each neighbor individually, because we need to map it.
-      neighbors[refMapping].resize(distances[refMapping].size());
-      for (size_t j = 0; j < distances[refMapping].size(); ++j)
+      MetricType blockMetric(metric);
+      RuleType rules(*referenceSet, querySet, range,
+          MappedCallbackType(callback, oldFromNewQueries,
+          oldFromNewReferences), blockMetric, sameSet);
+
+      if (naive)
       {
-        neighbors[refMapping][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
+        for (size_t i = begin; i < end; ++i)
+          for (size_t j = 0; j < referenceSet->n_cols; ++j)
+            rules.BaseCase(i, j);
+
+        totalBaseCases += (end - begin) * referenceSet->n_cols;
       }
-    }
+      else
+      {
+        typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+        for (size_t i = begin; i < end; ++i)
+          traverser.Traverse(i, *referenceTree);
 
-    // Finished with temporary objects.
-    delete neighborPtr;
-    delete distancePtr;
+        totalBaseCases += rules.BaseCases();
+        totalScores += rules.Scores();
+      }
+    }
   }
+  else // Dual-tree recursion.
+  {
+    ParallelDualTreeTraversal(*queryTree,
+        NumParallelTasks(queryTree->NumDescendants()),
+        [&](Tree& queryNode)
+        {
+          MetricType subtreeMetric(metric);
+          RuleType rules(*referenceSet, querySet, range,
+              MappedCallbackType(callback, oldFromNewQueries,
+              oldFromNewReferences), subtreeMetric, sameSet);
+          typename Tree::template DualTreeTraverser<RuleType>
+              traverser(rules);
+          traverser.Traverse(queryNode, *referenceTree);
+
+          #pragma omp critical
+          {
+            totalBaseCases += rules.BaseCases();
+            totalScores += rules.Scores();
+          }
+        });
+  }
+
+  baseCases = totalBaseCases;
+  scores = totalScores;
 }
 
 template<typename MetricType,
@@ -106,12 +106,19 @@ PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, "
     "Hilbert R trees, R+ trees, R++ trees, and octrees).", "l", 20);
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "Hold the reference set and the trees in "
+    "single precision, which halves their memory usage; distances are then "
+    "only accurate to about seven significant digits.", "");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
 PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
 PARAM_FLAG("single_mode", "If true, single-tree search is used (as opposed to "
     "dual-tree search).", "S");
+PARAM_STRING_OUT("traversal_report_file", "If specified, statistics of the "
+    "tree traversals of the search (node combinations scored, pruned, and "
+    "recursed into at each level of the reference tree, base cases, and time "
+    "spent scoring and in base cases) are saved to this file as JSON.", "");
 
 void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 {
@@ -125,6 +132,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   ReportIgnoredParam(params, {{ "input_model", true }}, "tree_type");
   ReportIgnoredParam(params, {{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam(params, {{ "input_model", true }}, "single_precision");
   ReportIgnoredParam(params, {{ "input_model", true }}, "leaf_size");
   ReportIgnoredParam(params, {{ "input_model", true }}, "naive");
 
@@ -205,6 +213,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     rs->TreeType() = tree;
     rs->RandomBasis() = randomBasis;
+    rs->SinglePrecision() = params.Has("single_precision");
 
     Log::Info << "Using reference data from "
         << params.GetPrintable<arma::mat>("reference") << "." << endl;
@@ -222,7 +231,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     Log::Info << "Using range search model from '"
         << params.GetPrintable<RSModel*>("input_model") << "' ("
-        << "trained on " << rs->Dataset().n_rows << "x" << rs->Dataset().n_cols
+        << "trained on " << rs->Dimensionality() << "x" << rs->NumPoints()
         << " dataset)." << endl;
 
     // Adjust singleMode and naive if necessary.
@@ -257,6 +266,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     vector<vector<size_t>> neighbors;
     vector<vector<double>> distances;
 
+    rs->Statistics().Enabled() = params.Has("traversal_report_file");
     if (params.Has("query"))
       rs->Search(timers, std::move(queryData), r, neighbors, distances);
     else
@@ -264,6 +274,21 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     Log::Info << "Search complete." << endl;
 
+    if (params.Has("traversal_report_file"))
+    {
+      const string reportFile = params.Get<string>("traversal_report_file");
+      fstream reportStr(reportFile.c_str(), fstream::out);
+      if (!reportStr.is_open())
+      {
+        Log::Warn << "Cannot open file '" << reportFile << "' to save the "
+            << "traversal report to!" << endl;
+      }
+      else
+      {
+        reportStr << rs->Statistics().ToJSON() << endl;
+      }
+    }
+
     // Save output, if desired.  We have to do this by hand.
     if (params.Has("distances_file"))
     {
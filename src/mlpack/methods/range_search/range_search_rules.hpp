@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include "range_search_callbacks.hpp"
 
 namespace mlpack {
 
@@ -20,10 +21,18 @@ namespace mlpack {
  * The RangeSearchRules class is a template helper class used by RangeSearch
  * class when performing range searches.
  *
+ * Each result is passed to a callback as soon as it is found, as
+ * `callback(queryIndex, referenceIndex, distance)`; by default the results are
+ * stored in a vector of neighbors and distances for each query point.
+ *
  * @tparam MetricType The metric to use for computation.
  * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ * @tparam CallbackType The type of the callback that receives each result.
  */
-template<typename MetricType, typename TreeType>
+template<typename MetricType,
+         typename TreeType,
+         typename CallbackType =
+             RangeSearchVectorCallback<typename TreeType::Mat::elem_type>>
 class RangeSearchRules
 {
  public:
@@ -53,6 +62,26 @@ class RangeSearchRules
                    MetricType& metric,
                    const bool sameSet = false);
 
+  /**
+   * Construct the RangeSearchRules object to pass each result to the given
+   * callback instead of storing it.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param range Range to search for.
+   * @param callback Callback to pass each result to; it is copied, so it should
+   *      refer to any state it modifies.
+   * @param metric Instantiated metric.
+   * @param sameSet If true, the query and reference set are taken to be the
+   *      same, and a query point will not return itself in the results.
+   */
+  RangeSearchRules(const MatType& referenceSet,
+                   const MatType& querySet,
+                   const RangeType<ElemType>& range,
+                   CallbackType callback,
+                   MetricType& metric,
+                   const bool sameSet = false);
+
   /**
    * Compute the base case between the given query point and reference point.
    *
@@ -135,11 +164,8 @@ class RangeSearchRules
   //! The range of distances for which we are searching.
   const RangeType<ElemType>& range;
 
-  //! The vector the resultant neighbor indices should be stored in.
-  std::vector<std::vector<size_t> >& neighbors;
-
-  //! The vector the resultant neighbor distances should be stored in.
-  std::vector<std::vector<ElemType> >& distances;
+  //! The callback that each result is passed to.
+  CallbackType callback;
 
   //! The instantiated metric.
   MetricType& metric;
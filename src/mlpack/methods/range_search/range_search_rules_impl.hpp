@@ -17,8 +17,8 @@
 
 namespace mlpack {
 
-template<typename MetricType, typename TreeType>
-RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
+template<typename MetricType, typename TreeType, typename CallbackType>
+RangeSearchRules<MetricType, TreeType, CallbackType>::RangeSearchRules(
     const MatType& referenceSet,
     const MatType& querySet,
     const RangeType<ElemType>& range,
@@ -26,11 +26,24 @@ RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
     std::vector<std::vector<ElemType> >& distances,
     MetricType& metric,
     const bool sameSet) :
+    RangeSearchRules(referenceSet, querySet, range,
+        CallbackType(neighbors, distances), metric, sameSet)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename TreeType, typename CallbackType>
+RangeSearchRules<MetricType, TreeType, CallbackType>::RangeSearchRules(
+    const MatType& referenceSet,
+    const MatType& querySet,
+    const RangeType<ElemType>& range,
+    CallbackType callback,
+    MetricType& metric,
+    const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
     range(range),
-    neighbors(neighbors),
-    distances(distances),
+    callback(std::move(callback)),
     metric(metric),
     sameSet(sameSet),
     lastQueryIndex(querySet.n_cols),
@@ -43,10 +56,10 @@ RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
 
 //! The base case.  Evaluate the distance between the two points and add to the
 //! results if necessary.
-template<typename MetricType, typename TreeType>
+template<typename MetricType, typename TreeType, typename CallbackType>
 inline mlpack_force_inline
-typename RangeSearchRules<MetricType, TreeType>::ElemType
-RangeSearchRules<MetricType, TreeType>::BaseCase(
+typename RangeSearchRules<MetricType, TreeType, CallbackType>::ElemType
+RangeSearchRules<MetricType, TreeType, CallbackType>::BaseCase(
     const size_t queryIndex,
     const size_t referenceIndex)
 {
@@ -67,19 +80,17 @@ RangeSearchRules<MetricType, TreeType>::BaseCase(
   lastReferenceIndex = referenceIndex;
 
   if (range.Contains(distance))
-  {
-    neighbors[queryIndex].push_back(referenceIndex);
-    distances[queryIndex].push_back(distance);
-  }
+    callback(queryIndex, referenceIndex, distance);
 
   return distance;
 }
 
 //! Single-tree scoring function.
-template<typename MetricType, typename TreeType>
-typename RangeSearchRules<MetricType, TreeType>::ElemType
-RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
-                                              TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename CallbackType>
+typename RangeSearchRules<MetricType, TreeType, CallbackType>::ElemType
+RangeSearchRules<MetricType, TreeType, CallbackType>::Score(
+    const size_t queryIndex,
+    TreeType& referenceNode)
 {
   // We must get the minimum and maximum distances and store them in this
   // object.
@@ -137,9 +148,9 @@ RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
 }
 
 //! Single-tree rescoring function.
-template<typename MetricType, typename TreeType>
-typename RangeSearchRules<MetricType, TreeType>::ElemType
-RangeSearchRules<MetricType, TreeType>::Rescore(
+template<typename MetricType, typename TreeType, typename CallbackType>
+typename RangeSearchRules<MetricType, TreeType, CallbackType>::ElemType
+RangeSearchRules<MetricType, TreeType, CallbackType>::Rescore(
     const size_t /* queryIndex */,
     TreeType& /* referenceNode */,
     const ElemType oldScore) const
@@ -149,10 +160,11 @@ RangeSearchRules<MetricType, TreeType>::Rescore(
 }
 
 //! Dual-tree scoring function.
-template<typename MetricType, typename TreeType>
-typename RangeSearchRules<MetricType, TreeType>::ElemType
-RangeSearchRules<MetricType, TreeType>::Score(TreeType& queryNode,
-                                              TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename CallbackType>
+typename RangeSearchRules<MetricType, TreeType, CallbackType>::ElemType
+RangeSearchRules<MetricType, TreeType, CallbackType>::Score(
+    TreeType& queryNode,
+    TreeType& referenceNode)
 {
   RangeType<ElemType> distances;
   if (TreeTraits<TreeType>::FirstPointIsCentroid)
@@ -212,9 +224,9 @@ RangeSearchRules<MetricType, TreeType>::Score(TreeType& queryNode,
 }
 
 //! Dual-tree rescoring function.
-template<typename MetricType, typename TreeType>
-typename RangeSearchRules<MetricType, TreeType>::ElemType
-RangeSearchRules<MetricType, TreeType>::Rescore(
+template<typename MetricType, typename TreeType, typename CallbackType>
+typename RangeSearchRules<MetricType, TreeType, CallbackType>::ElemType
+RangeSearchRules<MetricType, TreeType, CallbackType>::Rescore(
     TreeType& /* queryNode */,
     TreeType& /* referenceNode */,
     const ElemType oldScore) const
@@ -225,9 +237,10 @@ RangeSearchRules<MetricType, TreeType>::Rescore(
 
 //! Add all the points in the given node to the results for the given query
 //! point.
-template<typename MetricType, typename TreeType>
-void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
-                                                       TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename CallbackType>
+void RangeSearchRules<MetricType, TreeType, CallbackType>::AddResult(
+    const size_t queryIndex,
+    TreeType& referenceNode)
 {
   // Some types of trees calculate the base case evaluation before Score() is
   // called, so if the base case has already been calculated, then we must avoid
@@ -240,15 +253,6 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
     baseCaseMod = 1;
   }
 
-  // Resize distances and neighbors vectors appropriately.  We have to use
-  // reserve() and not resize(), because we don't know if we will encounter the
-  // case where the datasets and points are the same (and we skip in that case).
-  const size_t oldSize = neighbors[queryIndex].size();
-  neighbors[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
-  distances[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
-
   for (size_t i = baseCaseMod; i < referenceNode.NumDescendants(); ++i)
   {
     if ((&referenceSet == &querySet) &&
@@ -258,8 +262,7 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
     const ElemType distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
         referenceNode.Dataset().unsafe_col(referenceNode.Descendant(i)));
 
-    neighbors[queryIndex].push_back(referenceNode.Descendant(i));
-    distances[queryIndex].push_back(distance);
+    callback(queryIndex, referenceNode.Descendant(i), distance);
   }
 }
 
@@ -44,9 +44,15 @@ class RSWrapperBase
   //! Destruct the RSWrapperBase (nothing to do).
   virtual ~RSWrapperBase() { }
 
-  //! Get the dataset.
+  //! Get the dataset.  This throws std::invalid_argument if the dataset is not
+  //! held as an arma::mat (i.e. for single-precision models).
   virtual const arma::mat& Dataset() const = 0;
 
+  //! Get the dimensionality of the dataset.
+  virtual size_t Dimensionality() const = 0;
+  //! Get the number of points in the dataset.
+  virtual size_t NumPoints() const = 0;
+
   //! Get whether single-tree search is being used.
   virtual bool SingleMode() const = 0;
   //! Modify whether single-tree search is being used.
@@ -57,6 +63,11 @@ class RSWrapperBase
   //! Modify whether naive search is being used.
   virtual bool& Naive() = 0;
 
+  //! Get the statistics of the tree traversals of the last search.
+  virtual const TraversalStatistics& Statistics() const = 0;
+  //! Modify the statistics of the tree traversals.
+  virtual TraversalStatistics& Statistics() = 0;
+
   //! Train the model (build the reference tree if needed).
   virtual void Train(util::Timers& timers,
                      arma::mat&& referenceSet,
@@ -77,14 +88,65 @@ class RSWrapperBase
                       const Range& range,
                       std::vector<std::vector<size_t>>& neighbors,
                       std::vector<std::vector<double>>& distances) = 0;
+
+ protected:
+  //! Return the given dataset, which has type arma::mat.
+  static const arma::mat& DatasetAsMat(const arma::mat& dataset)
+  {
+    return dataset;
+  }
+
+  //! Throw an exception, since the given dataset does not have type arma::mat.
+  template<typename MatType>
+  static const arma::mat& DatasetAsMat(const MatType& /* dataset */)
+  {
+    throw std::invalid_argument("Dataset(): the dataset of a single-precision "
+        "model is not held as an arma::mat");
+  }
+
+  //! Convert the given range to a range of the given element type, clamping
+  //! its bounds to the largest values that the element type can hold.
+  template<typename ElemType>
+  static RangeType<ElemType> ConvertRange(const Range& range)
+  {
+    const double maxValue = (double) std::numeric_limits<ElemType>::max();
+    return RangeType<ElemType>(
+        (ElemType) std::min(std::max(range.Lo(), -maxValue), maxValue),
+        (ElemType) std::min(std::max(range.Hi(), -maxValue), maxValue));
+  }
+
+  //! Return the distances found by a search in double precision; they already
+  //! are, so they are just moved.
+  static void ConvertDistances(std::vector<std::vector<double>>&& found,
+                               std::vector<std::vector<double>>& distances)
+  {
+    distances = std::move(found);
+  }
+
+  //! Return the distances found by a search in double precision.
+  template<typename ElemType>
+  static void ConvertDistances(std::vector<std::vector<ElemType>>&& found,
+                               std::vector<std::vector<double>>& distances)
+  {
+    distances.resize(found.size());
+    for (size_t i = 0; i < found.size(); ++i)
+    {
+      distances[i].assign(found[i].begin(), found[i].end());
+      std::vector<ElemType>().swap(found[i]);
+    }
+  }
 };
 
 /**
- * RSWrapper is a wrapper class for most RangeSearch types.
+ * RSWrapper is a wrapper class for most RangeSearch types.  The datasets given
+ * to Train() and Search() are converted to MatType, so that the RangeSearch
+ * object (and its trees) can hold them in single precision; the distances that
+ * Search() returns are converted back to double.
  */
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
+                  typename TreeMatType> class TreeType,
+         typename MatType = arma::mat>
 class RSWrapper : public RSWrapperBase
 {
  public:
@@ -103,7 +165,12 @@ class RSWrapper : public RSWrapperBase
   virtual ~RSWrapper() { }
 
   //! Get the dataset.
-  const arma::mat& Dataset() const { return rs.ReferenceSet(); }
+  const arma::mat& Dataset() const { return DatasetAsMat(rs.ReferenceSet()); }
+
+  //! Get the dimensionality of the dataset.
+  size_t Dimensionality() const { return rs.ReferenceSet().n_rows; }
+  //! Get the number of points in the dataset.
+  size_t NumPoints() const { return rs.ReferenceSet().n_cols; }
 
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return rs.SingleMode(); }
@@ -115,6 +182,11 @@ class RSWrapper : public RSWrapperBase
   //! Modify whether naive search is being used.
   bool& Naive() { return rs.Naive(); }
 
+  //! Get the statistics of the tree traversals of the last search.
+  const TraversalStatistics& Statistics() const { return rs.Statistics(); }
+  //! Modify the statistics of the tree traversals.
+  TraversalStatistics& Statistics() { return rs.Statistics(); }
+
   //! Train the model (build the reference tree if needed).  This ignores the
   //! leaf size.
   virtual void Train(util::Timers& timers,
@@ -145,7 +217,8 @@ class RSWrapper : public RSWrapperBase
   }
 
  protected:
-  typedef RangeSearch<EuclideanDistance, arma::mat, TreeType> RSType;
+  typedef RangeSearch<EuclideanDistance, MatType, TreeType> RSType;
+  typedef typename MatType::elem_type ElemType;
 
   //! The instantiated RangeSearch object that we are wrapping.
   RSType rs;
@@ -158,14 +231,15 @@ class RSWrapper : public RSWrapperBase
  */
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-class LeafSizeRSWrapper : public RSWrapper<TreeType>
+                  typename TreeMatType> class TreeType,
+         typename MatType = arma::mat>
+class LeafSizeRSWrapper : public RSWrapper<TreeType, MatType>
 {
  public:
   //! Construct the LeafSizeRSWrapper by delegating to the RSWrapper
   //! constructor.
   LeafSizeRSWrapper(const bool singleMode, const bool naive) :
-      RSWrapper<TreeType>(singleMode, naive)
+      RSWrapper<TreeType, MatType>(singleMode, naive)
   {
     // Nothing else to do.
   }
@@ -201,7 +275,8 @@ class LeafSizeRSWrapper : public RSWrapper<TreeType>
   }
 
  protected:
-  using RSWrapper<TreeType>::rs;
+  using RSWrapper<TreeType, MatType>::rs;
+  using typename RSWrapper<TreeType, MatType>::ElemType;
 };
 
 /**
@@ -237,9 +312,12 @@ class RSModel
    *
    * @param treeType Type of tree to use.
    * @param randomBasis Whether or not to use a random basis.
+   * @param singlePrecision Whether or not to hold the dataset and the trees in
+   *      single precision (arma::fmat), which halves their memory usage.
    */
   RSModel(const TreeTypes treeType = TreeTypes::KD_TREE,
-          const bool randomBasis = false);
+          const bool randomBasis = false,
+          const bool singlePrecision = false);
 
   /**
    * Copy the given RSModel.
@@ -276,11 +354,17 @@ class RSModel
 
   //! Serialize the range search model.
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
-  //! Expose the dataset.
+  //! Expose the dataset.  This throws std::invalid_argument for
+  //! single-precision models; use Dimensionality() and NumPoints() instead.
   const arma::mat& Dataset() const { return rSearch->Dataset(); }
 
+  //! Get the dimensionality of the dataset.
+  size_t Dimensionality() const { return rSearch->Dimensionality(); }
+  //! Get the number of points in the dataset.
+  size_t NumPoints() const { return rSearch->NumPoints(); }
+
   //! Get whether the model is in single-tree search mode.
   bool SingleMode() const { return rSearch->SingleMode(); }
   //! Modify whether the model is in single-tree search mode.
@@ -291,6 +375,13 @@ class RSModel
   //! Modify whether the model is in naive search mode.
   bool& Naive() { return rSearch->Naive(); }
 
+  //! Get the statistics of the tree traversals of the last search.  These are
+  //! not serialized, and they are reset by BuildModel() and InitializeModel().
+  const TraversalStatistics& Statistics() const
+  { return rSearch->Statistics(); }
+  //! Modify the statistics of the tree traversals.
+  TraversalStatistics& Statistics() { return rSearch->Statistics(); }
+
   //! Get the leaf size (applicable to everything but the cover tree).
   size_t LeafSize() const { return leafSize; }
   //! Modify the leaf size (applicable to everything but the cover tree).
@@ -307,6 +398,12 @@ class RSModel
   //! been built).
   bool& RandomBasis() { return randomBasis; }
 
+  //! Get whether the dataset and the trees are held in single precision.
+  bool SinglePrecision() const { return singlePrecision; }
+  //! Modify whether the dataset and the trees are held in single precision
+  //! (don't do this after the model has been built).
+  bool& SinglePrecision() { return singlePrecision; }
+
   /**
    * Allocate the memory for the range search model.
    */
@@ -369,6 +466,9 @@ class RSModel
   //! Random projection matrix.
   arma::mat q;
 
+  //! If true, the dataset and the trees are held in single precision.
+  bool singlePrecision;
+
   /**
    * rSearch holds an instance of the RangeSearch class for the current
    * treeType. It is initialized every time BuildModel is executed.
@@ -385,11 +485,75 @@ class RSModel
    * Clean up memory.
    */
   void CleanMemory();
+
+  //! Initialize rSearch to hold a RangeSearch object of the current tree type
+  //! with datasets of type MatType.
+  template<typename MatType>
+  void InitializeSearch(const bool naive, const bool singleMode);
+
+  //! Serialize rSearch, which holds datasets of type MatType.
+  template<typename MatType, typename Archive>
+  void SerializeSearch(Archive& ar);
 };
 
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::RSModel, 1);
+
 // Include implementation (of serialize() and templated wrapper classes).
 #include "rs_model_impl.hpp"
 
+// If MLPACK_USE_PREBUILT is defined, the wrappers that RSModel holds are
+// compiled into libmlpack (see BUILD_PREBUILT_LIBRARY), and are not
+// instantiated again here.
+#ifdef MLPACK_USE_PREBUILT
+namespace mlpack {
+
+extern template class RSWrapper<KDTree, arma::mat>;
+extern template class RSWrapper<StandardCoverTree, arma::mat>;
+extern template class RSWrapper<RTree, arma::mat>;
+extern template class RSWrapper<RStarTree, arma::mat>;
+extern template class RSWrapper<BallTree, arma::mat>;
+extern template class RSWrapper<XTree, arma::mat>;
+extern template class RSWrapper<HilbertRTree, arma::mat>;
+extern template class RSWrapper<RPlusTree, arma::mat>;
+extern template class RSWrapper<RPlusPlusTree, arma::mat>;
+extern template class RSWrapper<VPTree, arma::mat>;
+extern template class RSWrapper<RPTree, arma::mat>;
+extern template class RSWrapper<MaxRPTree, arma::mat>;
+extern template class RSWrapper<UBTree, arma::mat>;
+extern template class RSWrapper<Octree, arma::mat>;
+extern template class LeafSizeRSWrapper<KDTree, arma::mat>;
+extern template class LeafSizeRSWrapper<BallTree, arma::mat>;
+extern template class LeafSizeRSWrapper<VPTree, arma::mat>;
+extern template class LeafSizeRSWrapper<RPTree, arma::mat>;
+extern template class LeafSizeRSWrapper<MaxRPTree, arma::mat>;
+extern template class LeafSizeRSWrapper<UBTree, arma::mat>;
+extern template class LeafSizeRSWrapper<Octree, arma::mat>;
+
+extern template class RSWrapper<KDTree, arma::fmat>;
+extern template class RSWrapper<StandardCoverTree, arma::fmat>;
+extern template class RSWrapper<RTree, arma::fmat>;
+extern template class RSWrapper<RStarTree, arma::fmat>;
+extern template class RSWrapper<BallTree, arma::fmat>;
+extern template class RSWrapper<XTree, arma::fmat>;
+extern template class RSWrapper<HilbertRTree, arma::fmat>;
+extern template class RSWrapper<RPlusTree, arma::fmat>;
+extern template class RSWrapper<RPlusPlusTree, arma::fmat>;
+extern template class RSWrapper<VPTree, arma::fmat>;
+extern template class RSWrapper<RPTree, arma::fmat>;
+extern template class RSWrapper<MaxRPTree, arma::fmat>;
+extern template class RSWrapper<UBTree, arma::fmat>;
+extern template class RSWrapper<Octree, arma::fmat>;
+extern template class LeafSizeRSWrapper<KDTree, arma::fmat>;
+extern template class LeafSizeRSWrapper<BallTree, arma::fmat>;
+extern template class LeafSizeRSWrapper<VPTree, arma::fmat>;
+extern template class LeafSizeRSWrapper<RPTree, arma::fmat>;
+extern template class LeafSizeRSWrapper<MaxRPTree, arma::fmat>;
+extern template class LeafSizeRSWrapper<UBTree, arma::fmat>;
+extern template class LeafSizeRSWrapper<Octree, arma::fmat>;
+
+} // namespace mlpack
+#endif
+
 #endif
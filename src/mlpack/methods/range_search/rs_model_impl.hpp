@@ -23,10 +23,13 @@ namespace mlpack {
  * Initialize the RSModel with the given tree type and whether or not a random
  * basis should be used.
  */
-inline RSModel::RSModel(TreeTypes treeType, bool randomBasis) :
+inline RSModel::RSModel(TreeTypes treeType,
+                        bool randomBasis,
+                        bool singlePrecision) :
     treeType(treeType),
     leafSize(0),
     randomBasis(randomBasis),
+    singlePrecision(singlePrecision),
     rSearch(NULL)
 {
   // Nothing to do.
@@ -38,6 +41,7 @@ inline RSModel::RSModel(const RSModel& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(other.q),
+    singlePrecision(other.singlePrecision),
     rSearch(other.rSearch->Clone())
 {
   // Nothing to do.
@@ -49,12 +53,14 @@ inline RSModel::RSModel(RSModel&& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
+    singlePrecision(other.singlePrecision),
     rSearch(std::move(other.rSearch))
 {
   // Reset other model.
   other.treeType = TreeTypes::KD_TREE;
   other.leafSize = 0;
   other.randomBasis = false;
+  other.singlePrecision = false;
 }
 
 // Copy operator.
@@ -68,6 +74,7 @@ inline RSModel& RSModel::operator=(const RSModel& other)
     leafSize = other.leafSize;
     randomBasis = other.randomBasis;
     q = other.q;
+    singlePrecision = other.singlePrecision;
     rSearch = other.rSearch->Clone();
   }
 
@@ -85,11 +92,13 @@ inline RSModel& RSModel::operator=(RSModel&& other)
     leafSize = other.leafSize;
     randomBasis = other.randomBasis;
     q = std::move(other.q);
+    singlePrecision = other.singlePrecision;
     rSearch = std::move(other.rSearch);
 
     other.treeType = TreeTypes::KD_TREE;
     other.leafSize = 0;
     other.randomBasis = false;
+    other.singlePrecision = false;
   }
 
   return *this;
@@ -107,62 +116,71 @@ inline void RSModel::InitializeModel(const bool naive,
   // Clean memory, if necessary.
   delete rSearch;
 
+  if (singlePrecision)
+    InitializeSearch<arma::fmat>(naive, singleMode);
+  else
+    InitializeSearch<arma::mat>(naive, singleMode);
+}
+
+template<typename MatType>
+void RSModel::InitializeSearch(const bool naive, const bool singleMode)
+{
   switch (treeType)
   {
     case KD_TREE:
-      rSearch = new LeafSizeRSWrapper<KDTree>(naive, singleMode);
+      rSearch = new LeafSizeRSWrapper<KDTree, MatType>(naive, singleMode);
       break;
 
     case COVER_TREE:
-      rSearch = new RSWrapper<StandardCoverTree>(naive, singleMode);
+      rSearch = new RSWrapper<StandardCoverTree, MatType>(naive, singleMode);
       break;
 
     case R_TREE:
-      rSearch = new RSWrapper<RTree>(naive, singleMode);
+      rSearch = new RSWrapper<RTree, MatType>(naive, singleMode);
       break;
 
     case R_STAR_TREE:
-      rSearch = new RSWrapper<RStarTree>(naive, singleMode);
+      rSearch = new RSWrapper<RStarTree, MatType>(naive, singleMode);
       break;
 
     case BALL_TREE:
-      rSearch = new LeafSizeRSWrapper<BallTree>(naive, singleMode);
+      rSearch = new LeafSizeRSWrapper<BallTree, MatType>(naive, singleMode);
       break;
 
     case X_TREE:
-      rSearch = new RSWrapper<XTree>(naive, singleMode);
+      rSearch = new RSWrapper<XTree, MatType>(naive, singleMode);
       break;
 
     case HILBERT_R_TREE:
-      rSearch = new RSWrapper<HilbertRTree>(naive, singleMode);
+      rSearch = new RSWrapper<HilbertRTree, MatType>(naive, singleMode);
       break;
 
     case R_PLUS_TREE:
-      rSearch = new RSWrapper<RPlusTree>(naive, singleMode);
+      rSearch = new RSWrapper<RPlusTree, MatType>(naive, singleMode);
       break;
 
     case R_PLUS_PLUS_TREE:
-      rSearch = new RSWrapper<RPlusPlusTree>(naive, singleMode);
+      rSearch = new RSWrapper<RPlusPlusTree, MatType>(naive, singleMode);
       break;
 
     case VP_TREE:
-      rSearch = new LeafSizeRSWrapper<VPTree>(naive, singleMode);
+      rSearch = new LeafSizeRSWrapper<VPTree, MatType>(naive, singleMode);
       break;
 
     case RP_TREE:
-      rSearch = new LeafSizeRSWrapper<RPTree>(naive, singleMode);
+      rSearch = new LeafSizeRSWrapper<RPTree, MatType>(naive, singleMode);
       break;
 
     case MAX_RP_TREE:
-      rSearch = new LeafSizeRSWrapper<MaxRPTree>(naive, singleMode);
+      rSearch = new LeafSizeRSWrapper<MaxRPTree, MatType>(naive, singleMode);
       break;
 
     case UB_TREE:
-      rSearch = new LeafSizeRSWrapper<UBTree>(naive, singleMode);
+      rSearch = new LeafSizeRSWrapper<UBTree, MatType>(naive, singleMode);
       break;
 
     case OCTREE:
-      rSearch = new LeafSizeRSWrapper<Octree>(naive, singleMode);
+      rSearch = new LeafSizeRSWrapper<Octree, MatType>(naive, singleMode);
       break;
   }
 }
@@ -291,80 +309,94 @@ inline void RSModel::CleanMemory()
 
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void RSWrapper<TreeType>::Train(util::Timers& timers,
-                                arma::mat&& referenceSet,
-                                const size_t /* leafSize */)
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void RSWrapper<TreeType, MatType>::Train(util::Timers& timers,
+                                         arma::mat&& referenceSet,
+                                         const size_t /* leafSize */)
 {
   if (!Naive())
     timers.Start("tree_building");
 
-  rs.Train(std::move(referenceSet));
+  rs.Train(ConvertOrMove<MatType>(std::move(referenceSet)));
   if (!Naive())
     timers.Stop("tree_building");
 }
 
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void RSWrapper<TreeType>::Search(util::Timers& timers,
-                                 arma::mat&& querySet,
-                                 const Range& range,
-                                 std::vector<std::vector<size_t>>& neighbors,
-                                 std::vector<std::vector<double>>& distances,
-                                 const size_t /* leafSize */)
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void RSWrapper<TreeType, MatType>::Search(
+    util::Timers& timers,
+    arma::mat&& querySet,
+    const Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances,
+    const size_t /* leafSize */)
 {
+  std::vector<std::vector<ElemType>> distancesOut;
   if (!Naive() && !SingleMode())
   {
     // We build the query tree manually, so that we can time how long it takes.
     timers.Start("tree_building");
-    typename decltype(rs)::Tree queryTree(std::move(querySet));
+    typename decltype(rs)::Tree queryTree(
+        ConvertOrMove<MatType>(std::move(querySet)));
     timers.Stop("tree_building");
 
     timers.Start("computing_neighbors");
-    rs.Search(&queryTree, range, neighbors, distances);
+    rs.Search(&queryTree, ConvertRange<ElemType>(range), neighbors,
+        distancesOut);
     timers.Stop("computing_neighbors");
   }
   else
   {
     timers.Start("computing_neighbors");
-    rs.Search(std::move(querySet), range, neighbors, distances);
+    rs.Search(ConvertOrMove<MatType>(std::move(querySet)),
+        ConvertRange<ElemType>(range), neighbors, distancesOut);
     timers.Stop("computing_neighbors");
   }
+
+  ConvertDistances(std::move(distancesOut), distances);
 }
 
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void RSWrapper<TreeType>::Search(util::Timers& timers,
-                                 const Range& range,
-                                 std::vector<std::vector<size_t>>& neighbors,
-                                 std::vector<std::vector<double>>& distances)
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void RSWrapper<TreeType, MatType>::Search(
+    util::Timers& timers,
+    const Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances)
 {
+  std::vector<std::vector<ElemType>> distancesOut;
   timers.Start("computing_neighbors");
-  rs.Search(range, neighbors, distances);
+  rs.Search(ConvertRange<ElemType>(range), neighbors, distancesOut);
   timers.Stop("computing_neighbors");
+
+  ConvertDistances(std::move(distancesOut), distances);
 }
 
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void LeafSizeRSWrapper<TreeType>::Train(util::Timers& timers,
-                                        arma::mat&& referenceSet,
-                                        const size_t leafSize)
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void LeafSizeRSWrapper<TreeType, MatType>::Train(util::Timers& timers,
+                                                 arma::mat&& referenceSet,
+                                                 const size_t leafSize)
 {
   if (rs.Naive())
   {
-    rs.Train(std::move(referenceSet));
+    rs.Train(ConvertOrMove<MatType>(std::move(referenceSet)));
   }
   else
   {
     timers.Start("tree_building");
     std::vector<size_t> oldFromNewReferences;
-    typename decltype(rs)::Tree* tree =
-        new typename decltype(rs)::Tree(std::move(referenceSet),
-                                        oldFromNewReferences,
-                                        leafSize);
+    typename decltype(rs)::Tree* tree = new typename decltype(rs)::Tree(
+        ConvertOrMove<MatType>(std::move(referenceSet)), oldFromNewReferences,
+        leafSize);
     rs.Train(tree);
 
     // Give the model ownership of the tree and the mappings.
@@ -376,8 +408,9 @@ void LeafSizeRSWrapper<TreeType>::Train(util::Timers& timers,
 
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void LeafSizeRSWrapper<TreeType>::Search(
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void LeafSizeRSWrapper<TreeType, MatType>::Search(
     util::Timers& timers,
     arma::mat&& querySet,
     const Range& range,
@@ -391,16 +424,17 @@ void LeafSizeRSWrapper<TreeType>::Search(
     timers.Start("tree_building");
     Log::Info << "Building query tree..." << std::endl;
     std::vector<size_t> oldFromNewQueries;
-    typename decltype(rs)::Tree queryTree(std::move(querySet),
-                                          oldFromNewQueries,
-                                          leafSize);
+    typename decltype(rs)::Tree queryTree(
+        ConvertOrMove<MatType>(std::move(querySet)), oldFromNewQueries,
+        leafSize);
     Log::Info << "Tree built." << std::endl;
     timers.Stop("tree_building");
 
     std::vector<std::vector<size_t>> neighborsOut;
-    std::vector<std::vector<double>> distancesOut;
+    std::vector<std::vector<ElemType>> distancesOut;
     timers.Start("computing_neighbors");
-    rs.Search(&queryTree, range, neighborsOut, distancesOut);
+    rs.Search(&queryTree, RSWrapperBase::ConvertRange<ElemType>(range),
+        neighborsOut, distancesOut);
     timers.Stop("computing_neighbors");
 
     // Remap the query points.
@@ -408,137 +442,158 @@ void LeafSizeRSWrapper<TreeType>::Search(
     distances.resize(queryTree.Dataset().n_cols);
     for (size_t i = 0; i < queryTree.Dataset().n_cols; ++i)
     {
-      neighbors[oldFromNewQueries[i]] = neighborsOut[i];
-      distances[oldFromNewQueries[i]] = distancesOut[i];
+      neighbors[oldFromNewQueries[i]] = std::move(neighborsOut[i]);
+      distances[oldFromNewQueries[i]].assign(distancesOut[i].begin(),
+          distancesOut[i].end());
     }
   }
   else
   {
+    std::vector<std::vector<ElemType>> distancesOut;
     timers.Start("computing_neighbors");
-    rs.Search(std::move(querySet), range, neighbors, distances);
+    rs.Search(ConvertOrMove<MatType>(std::move(querySet)),
+        RSWrapperBase::ConvertRange<ElemType>(range), neighbors, distancesOut);
     timers.Stop("computing_neighbors");
+
+    RSWrapperBase::ConvertDistances(std::move(distancesOut), distances);
   }
 }
 
 // Serialize the model.
 template<typename Archive>
-void RSModel::serialize(Archive& ar, const uint32_t /* version */)
+void RSModel::serialize(Archive& ar, const uint32_t version)
 {
   ar(CEREAL_NVP(treeType));
   ar(CEREAL_NVP(randomBasis));
   ar(CEREAL_NVP(q));
 
+  // Models before version 1 were always held in double precision.
+  if (cereal::is_loading<Archive>() && version == 0)
+    singlePrecision = false;
+  else
+    ar(CEREAL_NVP(singlePrecision));
+
   // This should never happen, but just in case...
   if (cereal::is_loading<Archive>())
     InitializeModel(false, false); // Values will be overwritten.
 
   // Avoid polymorphic serialization by explicitly serializing the correct type.
+  if (singlePrecision)
+    SerializeSearch<arma::fmat>(ar);
+  else
+    SerializeSearch<arma::mat>(ar);
+}
+
+// Serialize the RangeSearch object held by the model.
+template<typename MatType, typename Archive>
+void RSModel::SerializeSearch(Archive& ar)
+{
   switch (treeType)
   {
     case KD_TREE:
       {
-        LeafSizeRSWrapper<KDTree>& typedSearch =
-            dynamic_cast<LeafSizeRSWrapper<KDTree>&>(*rSearch);
+        LeafSizeRSWrapper<KDTree, MatType>& typedSearch =
+            dynamic_cast<LeafSizeRSWrapper<KDTree, MatType>&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case COVER_TREE:
       {
-        RSWrapper<StandardCoverTree>& typedSearch =
-            dynamic_cast<RSWrapper<StandardCoverTree>&>(*rSearch);
+        RSWrapper<StandardCoverTree, MatType>& typedSearch =
+            dynamic_cast<RSWrapper<StandardCoverTree, MatType>&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case R_TREE:
       {
-        RSWrapper<RTree>& typedSearch =
-            dynamic_cast<RSWrapper<RTree>&>(*rSearch);
+        RSWrapper<RTree, MatType>& typedSearch =
+            dynamic_cast<RSWrapper<RTree, MatType>&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case R_STAR_TREE:
       {
-        RSWrapper<RStarTree>& typedSearch =
-            dynamic_cast<RSWrapper<RStarTree>&>(*rSearch);
+        RSWrapper<RStarTree, MatType>& typedSearch =
+            dynamic_cast<RSWrapper<RStarTree, MatType>&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case BALL_TREE:
       {
-        LeafSizeRSWrapper<BallTree>& typedSearch =
-            dynamic_cast<LeafSizeRSWrapper<BallTree>&>(*rSearch);
+        LeafSizeRSWrapper<BallTree, MatType>& typedSearch =
+            dynamic_cast<LeafSizeRSWrapper<BallTree, MatType>&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case X_TREE:
       {
-        RSWrapper<XTree>& typedSearch =
-            dynamic_cast<RSWrapper<XTree>&>(*rSearch);
+        RSWrapper<XTree, MatType>& typedSearch =
+            dynamic_cast<RSWrapper<XTree, MatType>&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case HILBERT_R_TREE:
       {
-        RSWrapper<HilbertRTree>& typedSearch =
-            dynamic_cast<RSWrapper<HilbertRTree>&>(*rSearch);
+        RSWrapper<HilbertRTree, MatType>& typedSearch =
+            dynamic_cast<RSWrapper<HilbertRTree, MatType>&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case R_PLUS_TREE:
       {
-        RSWrapper<RPlusTree>& typedSearch =
-            dynamic_cast<RSWrapper<RPlusTree>&>(*rSearch);
+        RSWrapper<RPlusTree, MatType>& typedSearch =
+            dynamic_cast<RSWrapper<RPlusTree, MatType>&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case R_PLUS_PLUS_TREE:
       {
-        RSWrapper<RPlusPlusTree>& typedSearch =
-            dynamic_cast<RSWrapper<RPlusPlusTree>&>(*rSearch);
+        RSWrapper<RPlusPlusTree, MatType>& typedSearch =
+            dynamic_cast<RSWrapper<RPlusPlusTree, MatType>&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case VP_TREE:
       {
-        LeafSizeRSWrapper<VPTree>& typedSearch =
-            dynamic_cast<LeafSizeRSWrapper<VPTree>&>(*rSearch);
+        LeafSizeRSWrapper<VPTree, MatType>& typedSearch =
+            dynamic_cast<LeafSizeRSWrapper<VPTree, MatType>&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case RP_TREE:
       {
-        LeafSizeRSWrapper<RPTree>& typedSearch =
-            dynamic_cast<LeafSizeRSWrapper<RPTree>&>(*rSearch);
+        LeafSizeRSWrapper<RPTree, MatType>& typedSearch =
+            dynamic_cast<LeafSizeRSWrapper<RPTree, MatType>&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case MAX_RP_TREE:
       {
-        LeafSizeRSWrapper<MaxRPTree>& typedSearch =
-            dynamic_cast<LeafSizeRSWrapper<MaxRPTree>&>(*rSearch);
+        LeafSizeRSWrapper<MaxRPTree, MatType>& typedSearch =
+            dynamic_cast<LeafSizeRSWrapper<MaxRPTree, MatType>&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case UB_TREE:
       {
-        LeafSizeRSWrapper<UBTree>& typedSearch =
-            dynamic_cast<LeafSizeRSWrapper<UBTree>&>(*rSearch);
+        LeafSizeRSWrapper<UBTree, MatType>& typedSearch =
+            dynamic_cast<LeafSizeRSWrapper<UBTree, MatType>&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case OCTREE:
       {
-        LeafSizeRSWrapper<Octree>& typedSearch =
-            dynamic_cast<LeafSizeRSWrapper<Octree>&>(*rSearch);
+        LeafSizeRSWrapper<Octree, MatType>& typedSearch =
+            dynamic_cast<LeafSizeRSWrapper<Octree, MatType>&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
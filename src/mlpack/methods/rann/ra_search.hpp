@@ -26,6 +26,7 @@
 #define MLPACK_METHODS_RANN_RA_SEARCH_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traversal.hpp>
 
 #include <mlpack/methods/neighbor_search/sort_policies/nearest_neighbor_sort.hpp>
 
@@ -247,6 +248,13 @@ class RASearch
    * single-tree search; single-tree search can be set with the SingleMode()
    * function or in the constructor.
    *
+   * When OpenMP is enabled, the query points are searched in parallel.  Every
+   * query point samples the reference set from its own random stream, seeded
+   * from mlpack's random number generator, so with a fixed seed (see
+   * RandomSeed()) the results of naive and single-tree search don't depend on
+   * the number of threads; those of dual-tree search are reproducible for a
+   * given number of threads.
+   *
    * @param querySet Set of query points (can be a single point).
    * @param k Number of neighbors to search for.
    * @param neighbors Matrix storing lists of neighbors for each query point.
@@ -391,6 +399,27 @@ class RASearch
   //! Instantiation of kernel.
   MetricType metric;
 
+  /**
+   * Search for the neighbors of the given query points with a single-tree
+   * traversal for each point, in parallel over blocks of query points.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the neighbors in; it must already have
+   *     the right size.
+   * @param distances Matrix to store the distances in; it must already have
+   *     the right size.
+   * @param sameSet Whether the query set is the reference set.
+   * @param seed Seed of the samples of the query points.
+   * @return Number of distance computations.
+   */
+  size_t SingleTreeSearch(const MatType& querySet,
+                          const size_t k,
+                          arma::Mat<size_t>& neighbors,
+                          arma::mat& distances,
+                          const bool sameSet,
+                          const size_t seed);
+
   //! For access to mappings when building models.
   friend class LeafSizeRAWrapper<TreeType>;
 }; // class RASearch
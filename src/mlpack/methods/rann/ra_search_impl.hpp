@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_RANN_RA_SEARCH_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
 
 #include "ra_search_rules.hpp"
 
@@ -262,11 +263,12 @@ Search(const MatType& querySet,
 
   typedef RASearchRules<SortPolicy, MetricType, Tree> RuleType;
 
+  // The samples of every query point are drawn from streams seeded from this,
+  // so that the results don't depend on how the search is split into tasks.
+  const size_t seed = RandomStreamSeed();
+
   if (naive)
   {
-    RuleType rules(*referenceSet, querySet, k, metric, tau, alpha, naive,
-        sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
-
     // Find how many samples from the reference set we need and sample uniformly
     // from the reference set without replacement.
     const size_t numSamples = RAUtil::MinimumSamplesReqd(referenceSet->n_cols,
@@ -274,39 +276,44 @@ Search(const MatType& querySet,
     arma::uvec distinctSamples = arma::randperm(referenceSet->n_cols,
         numSamples);
 
-    // Run the base case on each combination of query point and sampled
-    // reference point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-        rules.BaseCase(i, (size_t) distinctSamples[j]);
+    const size_t numBlocks = NumParallelTasks(querySet.n_cols);
 
-    rules.GetResults(*neighborPtr, *distancePtr);
+    #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = (b * querySet.n_cols) / numBlocks;
+      const size_t end = ((b + 1) * querySet.n_cols) / numBlocks;
+      if (begin == end)
+        continue;
+
+      RuleType rules(*referenceSet, querySet, begin, end - begin, k, metric,
+          tau, alpha, naive, sampleAtLeaves, firstLeafExact, singleSampleLimit,
+          false, seed);
+
+      // Run the base case on each combination of query point and sampled
+      // reference point.
+      for (size_t i = begin; i < end; ++i)
+        for (size_t j = 0; j < distinctSamples.n_elem; ++j)
+          rules.BaseCase(i, (size_t) distinctSamples[j]);
+
+      // Each block writes its own columns of the results.
+      arma::Mat<size_t> blockNeighbors(neighborPtr->colptr(begin), k,
+          end - begin, false, true);
+      arma::mat blockDistances(distancePtr->colptr(begin), k, end - begin,
+          false, true);
+      rules.GetResults(blockNeighbors, blockDistances);
+    }
   }
   else if (singleMode)
   {
-    RuleType rules(*referenceSet, querySet, k, metric, tau, alpha, naive,
-        sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
-
-    // If the reference root node is a leaf, then the sampling has already been
-    // done in the RASearchRules constructor.  This happens when naive = true.
-    if (!referenceTree->IsLeaf())
-    {
-      Log::Info << "Performing single-tree traversal..." << std::endl;
-
-      // Create the traverser.
-      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    Log::Info << "Performing single-tree traversal..." << std::endl;
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+    const size_t numDistComputations = SingleTreeSearch(querySet, k,
+        *neighborPtr, *distancePtr, false, seed);
 
-      Log::Info << "Single-tree traversal complete." << std::endl;
-      Log::Info << "Average number of distance calculations per query point: "
-          << (rules.NumDistComputations() / querySet.n_cols) << "."
-          << std::endl;
-    }
-
-    rules.GetResults(*neighborPtr, *distancePtr);
+    Log::Info << "Single-tree traversal complete." << std::endl;
+    Log::Info << "Average number of distance calculations per query point: "
+        << (numDistComputations / querySet.n_cols) << "." << std::endl;
   }
   else // Dual-tree recursion.
   {
@@ -316,20 +323,43 @@ Search(const MatType& querySet,
     Tree* queryTree = BuildTree<Tree>(const_cast<MatType&>(querySet),
         oldFromNewQueries);
 
-    RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
-        naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
     Log::Info << "Query statistic pre-search: "
         << queryTree->Stat().NumSamplesMade() << std::endl;
 
-    traverser.Traverse(*queryTree, *referenceTree);
+    // Disjoint query subtrees are searched in parallel; this needs each of them
+    // to hold a contiguous range of query points.
+    const size_t numSubtrees = TreeTraits<Tree>::RearrangesDataset ?
+        NumParallelTasks(querySet.n_cols) : 1;
+    size_t numDistComputations = 0;
+
+    ParallelDualTreeTraversal(*queryTree, numSubtrees,
+        [&](Tree& queryNode)
+        {
+          const size_t begin = (numSubtrees == 1) ? 0 :
+              queryNode.Descendant(0);
+          const size_t count = (numSubtrees == 1) ? querySet.n_cols :
+              queryNode.NumDescendants();
+
+          RuleType rules(*referenceSet, queryTree->Dataset(), begin, count, k,
+              metric, tau, alpha, naive, sampleAtLeaves, firstLeafExact,
+              singleSampleLimit, false, seed);
+          typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+          traverser.Traverse(queryNode, *referenceTree);
+
+          // Each subtree writes its own columns of the results.
+          arma::Mat<size_t> blockNeighbors(neighborPtr->colptr(begin), k,
+              count, false, true);
+          arma::mat blockDistances(distancePtr->colptr(begin), k, count, false,
+              true);
+          rules.GetResults(blockNeighbors, blockDistances);
+
+          #pragma omp critical
+          numDistComputations += rules.NumDistComputations();
+        });
 
     Log::Info << "Dual-tree traversal complete." << std::endl;
     Log::Info << "Average number of distance calculations per query point: "
-        << (rules.NumDistComputations() / querySet.n_cols) << "." << std::endl;
-
-    rules.GetResults(*neighborPtr, *distancePtr);
+        << (numDistComputations / querySet.n_cols) << "." << std::endl;
 
     delete queryTree;
   }
@@ -475,43 +505,58 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   neighborPtr->set_size(k, referenceSet->n_cols);
   distancePtr->set_size(k, referenceSet->n_cols);
 
-  // Create the helper object for the tree traversal.
   typedef RASearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, k, metric, tau, alpha, naive,
-      sampleAtLeaves, firstLeafExact, singleSampleLimit, true /* same sets */);
+  const size_t seed = RandomStreamSeed();
 
   if (naive)
   {
-    // Find how many samples from the reference set we need and sample uniformly
-    // from the reference set without replacement.
-    const size_t numSamples = RAUtil::MinimumSamplesReqd(referenceSet->n_cols,
-        k, tau, alpha);
-    arma::uvec distinctSamples = arma::randperm(referenceSet->n_cols,
-        numSamples);
+    const size_t numBlocks = NumParallelTasks(referenceSet->n_cols);
 
-    // The naive brute-force solution.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+    #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = (b * referenceSet->n_cols) / numBlocks;
+      const size_t end = ((b + 1) * referenceSet->n_cols) / numBlocks;
+      if (begin == end)
+        continue;
+
+      RuleType rules(*referenceSet, *referenceSet, begin, end - begin, k,
+          metric, tau, alpha, naive, sampleAtLeaves, firstLeafExact,
+          singleSampleLimit, true /* same sets */, seed);
+
+      // The naive brute-force solution.
+      for (size_t i = begin; i < end; ++i)
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          rules.BaseCase(i, j);
+
+      // Each block writes its own columns of the results.
+      arma::Mat<size_t> blockNeighbors(neighborPtr->colptr(begin), k,
+          end - begin, false, true);
+      arma::mat blockDistances(distancePtr->colptr(begin), k, end - begin,
+          false, true);
+      rules.GetResults(blockNeighbors, blockDistances);
+    }
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    SingleTreeSearch(*referenceSet, k, *neighborPtr, *distancePtr,
+        true /* same sets */, seed);
   }
   else
   {
+    // The query tree is the reference tree here, so the traversal can't be
+    // split between query subtrees.
+    RuleType rules(*referenceSet, *referenceSet, k, metric, tau, alpha, naive,
+        sampleAtLeaves, firstLeafExact, singleSampleLimit,
+        true /* same sets */);
+
     // Create the traverser.
     typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
     traverser.Traverse(*referenceTree, *referenceTree);
-  }
 
-  rules.GetResults(*neighborPtr, *distancePtr);
+    rules.GetResults(*neighborPtr, *distancePtr);
+  }
 
   // Do we need to map the reference indices?
   if (treeOwner && TreeTraits<Tree>::RearrangesDataset)
@@ -536,6 +581,60 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t RASearch<SortPolicy, MetricType, MatType, TreeType>::SingleTreeSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const bool sameSet,
+    const size_t seed)
+{
+  typedef RASearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  const size_t numBlocks = NumParallelTasks(querySet.n_cols);
+  size_t numDistComputations = 0;
+
+  #pragma omp parallel for schedule(dynamic) reduction(+:numDistComputations) \
+      num_threads((int) NumThreads())
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = (b * querySet.n_cols) / numBlocks;
+    const size_t end = ((b + 1) * querySet.n_cols) / numBlocks;
+    if (begin == end)
+      continue;
+
+    // Create the helper object and the traverser for this block of queries.
+    RuleType rules(*referenceSet, querySet, begin, end - begin, k, metric, tau,
+        alpha, naive, sampleAtLeaves, firstLeafExact, singleSampleLimit,
+        sameSet, seed);
+    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+    // Now have it traverse for each point, each with its own samples.
+    for (size_t i = begin; i < end; ++i)
+    {
+      rules.SeedQuery(i);
+      traverser.Traverse(i, *referenceTree);
+    }
+
+    numDistComputations += rules.NumDistComputations();
+
+    // Each block writes its own columns of the results.
+    arma::Mat<size_t> blockNeighbors(neighbors.colptr(begin), k, end - begin,
+        false, true);
+    arma::mat blockDistances(distances.colptr(begin), k, end - begin, false,
+        true);
+    rules.GetResults(blockNeighbors, blockDistances);
+  }
+
+  return numDistComputations;
+}
+
 template<typename SortPolicy,
          typename MetricType,
          typename MatType,
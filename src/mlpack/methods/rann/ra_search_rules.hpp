@@ -17,6 +17,7 @@
 #include <mlpack/core/tree/traversal_info.hpp>
 
 #include <queue>
+#include <random>
 
 namespace mlpack {
 
@@ -65,8 +66,59 @@ class RASearchRules
                 const size_t singleSampleLimit = 20,
                 const bool sameSet = false);
 
+  /**
+   * Construct the RASearchRules object to search only for the neighbors of
+   * the query points with indices in [queryBegin, queryBegin + queryCount).
+   * Only those query points may be passed to BaseCase() and Score().  This is
+   * used to search for different subsets of query points in parallel.
+   *
+   * The reference points are sampled with a counter-based RandomStream that
+   * belongs to the rules and is keyed by the given seed, so that the
+   * results don't depend on how the query points are split between threads.
+   * In naive mode and in single-tree mode (where SeedQuery() must be called
+   * before each query point is traversed), every query point gets its own
+   * stream of samples; in dual-tree mode, all query points of the rules share
+   * one stream.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param queryBegin Index of the first query point to search for.
+   * @param queryCount Number of query points to search for.
+   * @param k Number of neighbors to search for.
+   * @param metric Instantiated metric.
+   * @param tau The rank-approximation in percentile of the data.
+   * @param alpha The desired success probability.
+   * @param naive If true, the rank-approximate search will be performed by
+   *      directly sampling the whole set instead of using the stratified
+   *      sampling on the tree.
+   * @param sampleAtLeaves Sample at leaves for faster but less accurate
+   *      computation.
+   * @param firstLeafExact Traverse to the first leaf without approximation.
+   * @param singleSampleLimit The limit on the largest node that can be
+   *     approximated by sampling.
+   * @param sameSet If true, the query and reference set are taken to be the
+   *      same, and a query point will not return itself in the results.
+   * @param seed Seed of the samples.
+   */
+  RASearchRules(const arma::mat& referenceSet,
+                const arma::mat& querySet,
+                const size_t queryBegin,
+                const size_t queryCount,
+                const size_t k,
+                MetricType& metric,
+                const double tau,
+                const double alpha,
+                const bool naive,
+                const bool sampleAtLeaves,
+                const bool firstLeafExact,
+                const size_t singleSampleLimit,
+                const bool sameSet,
+                const size_t seed);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
+   * If the rules were constructed for a subset of the query points, column i
+   * holds the results for query point (queryBegin + i).
    *
    * @param neighbors Matrix storing lists of neighbors for each query point.
    * @param distances Matrix storing distances of neighbors for each query
@@ -83,6 +135,15 @@ class RASearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Start the stream of samples of the given query point.  In single-tree
+   * mode, this is called before the query point is traversed, so that its
+   * samples are the same whichever rules search it.
+   *
+   * @param queryIndex Index of query point.
+   */
+  void SeedQuery(const size_t queryIndex);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -252,6 +313,9 @@ class RASearchRules
   //! The query set.
   const arma::mat& querySet;
 
+  //! Index of the first query point the rules search for.
+  size_t queryBegin;
+
   //! Candidate represents a possible candidate neighbor (distance, index).
   typedef std::pair<double, size_t> Candidate;
 
@@ -302,6 +366,21 @@ class RASearchRules
 
   TraversalInfoType traversalInfo;
 
+  //! The seed of the samples.
+  size_t seed;
+
+  //! The random number generator used to sample reference points.
+  RandomStream rng;
+
+  //! The sampled reference points of the last call to SampleBaseCases().
+  std::vector<size_t> samples;
+
+  //! The distances to the sampled reference points.
+  arma::vec sampleDistances;
+
+  //! Buffer holding the permutation of the points of a large node to sample.
+  std::vector<size_t> permutation;
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
@@ -313,6 +392,27 @@ class RASearchRules
                       const size_t neighbor,
                       const double distance);
 
+  /**
+   * Sample the given number of distinct points among the descendants of the
+   * given reference node (or among all reference points, if it is NULL), and
+   * compute the base cases between the query point and every sampled point.
+   * The sampled points are gathered first, so that all of the distances are
+   * computed in one pass before any candidate is inserted.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Node to sample from, or NULL for the whole set.
+   * @param numSamples Number of points to sample.
+   */
+  void SampleBaseCases(const size_t queryIndex,
+                       TreeType* referenceNode,
+                       const size_t numSamples);
+
+  /**
+   * Sample the given number of distinct indices in [0, numPoints) into
+   * `samples`; if there are fewer points than that, all of them are taken.
+   */
+  void Sample(const size_t numPoints, const size_t numSamples);
+
   /**
    * Perform actual scoring for single-tree case.
    */
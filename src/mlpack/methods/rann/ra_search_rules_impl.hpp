@@ -30,14 +30,39 @@ RASearchRules(const arma::mat& referenceSet,
               const bool firstLeafExact,
               const size_t singleSampleLimit,
               const bool sameSet) :
+    RASearchRules(referenceSet, querySet, 0, querySet.n_cols, k, metric, tau,
+        alpha, naive, sampleAtLeaves, firstLeafExact, singleSampleLimit,
+        sameSet, RandomStreamSeed())
+{
+  // Nothing to do.
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+RASearchRules<SortPolicy, MetricType, TreeType>::
+RASearchRules(const arma::mat& referenceSet,
+              const arma::mat& querySet,
+              const size_t queryBegin,
+              const size_t queryCount,
+              const size_t k,
+              MetricType& metric,
+              const double tau,
+              const double alpha,
+              const bool naive,
+              const bool sampleAtLeaves,
+              const bool firstLeafExact,
+              const size_t singleSampleLimit,
+              const bool sameSet,
+              const size_t seed) :
     referenceSet(referenceSet),
     querySet(querySet),
+    queryBegin(queryBegin),
     k(k),
     metric(metric),
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
-    sameSet(sameSet)
+    sameSet(sameSet),
+    seed(seed)
 {
   // Validate tau to make sure that the rank approximation is greater than the
   // number of neighbors requested.
@@ -60,12 +85,17 @@ RASearchRules(const arma::mat& referenceSet,
   numSamplesReqd = RAUtil::MinimumSamplesReqd(n, k, tau, alpha);
 
   // Initialize some statistics to be collected during the search.
-  numSamplesMade = arma::zeros<arma::Col<size_t> >(querySet.n_cols);
+  numSamplesMade = arma::zeros<arma::Col<size_t> >(queryCount);
   numDistComputations = 0;
   samplingRatio = (double) numSamplesReqd / (double) n;
 
-  Log::Info << "Minimum samples required per query: " << numSamplesReqd <<
-    ", sampling ratio: " << samplingRatio << std::endl;
+  // When several rules search different query points in parallel, only the
+  // first one reports the sampling parameters.
+  if (queryBegin == 0)
+  {
+    Log::Info << "Minimum samples required per query: " << numSamplesReqd <<
+      ", sampling ratio: " << samplingRatio << std::endl;
+  }
 
   // Let's build the list of candidate neighbors for each query point.
   // It will be initialized with k candidates: (WorstDistance, size_t() - 1)
@@ -77,19 +107,21 @@ RASearchRules(const arma::mat& referenceSet,
   std::vector<Candidate> vect(k, def);
   CandidateList pqueue(CandidateCmp(), std::move(vect));
 
-  candidates.reserve(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; ++i)
+  candidates.reserve(queryCount);
+  for (size_t i = 0; i < queryCount; ++i)
     candidates.push_back(pqueue);
 
+  // The samples of a dual-tree traversal are drawn from one stream for all the
+  // query points of the rules.
+  SeedQuery(queryBegin);
+
   if (naive) // No tree traversal; just do naive sampling here.
   {
-    // Sample enough points.
-    arma::uvec distinctSamples;
-    for (size_t i = 0; i < querySet.n_cols; ++i)
+    // Sample enough points, with the stream of each query point.
+    for (size_t i = queryBegin; i < queryBegin + queryCount; ++i)
     {
-      distinctSamples = arma::randperm(n, numSamplesReqd);
-      for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-        BaseCase(i, (size_t) distinctSamples[j]);
+      SeedQuery(i);
+      SampleBaseCases(i, NULL, numSamplesReqd);
     }
   }
 }
@@ -99,10 +131,10 @@ void RASearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
-  neighbors.set_size(k, querySet.n_cols);
-  distances.set_size(k, querySet.n_cols);
+  neighbors.set_size(k, candidates.size());
+  distances.set_size(k, candidates.size());
 
-  for (size_t i = 0; i < querySet.n_cols; ++i)
+  for (size_t i = 0; i < candidates.size(); ++i)
   {
     CandidateList& pqueue = candidates[i];
     for (size_t j = 1; j <= k; ++j)
@@ -130,7 +162,7 @@ double RASearchRules<SortPolicy, MetricType, TreeType>::BaseCase(
 
   InsertNeighbor(queryIndex, referenceIndex, distance);
 
-  numSamplesMade[queryIndex]++;
+  numSamplesMade[queryIndex - queryBegin]++;
 
   numDistComputations++;
 
@@ -145,7 +177,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
   const arma::vec queryPoint = querySet.unsafe_col(queryIndex);
   const double distance = SortPolicy::BestPointToNodeDistance(queryPoint,
       &referenceNode);
-  const double bestDistance = candidates[queryIndex].top().first;
+  const double bestDistance = candidates[queryIndex - queryBegin].top().first;
 
   return Score(queryIndex, referenceNode, distance, bestDistance);
 }
@@ -159,7 +191,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
   const arma::vec queryPoint = querySet.unsafe_col(queryIndex);
   const double distance = SortPolicy::BestPointToNodeDistance(queryPoint,
       &referenceNode, baseCaseResult);
-  const double bestDistance = candidates[queryIndex].top().first;
+  const double bestDistance = candidates[queryIndex - queryBegin].top().first;
 
   return Score(queryIndex, referenceNode, distance, bestDistance);
 }
@@ -175,19 +207,19 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
   // will be something down this node.  Also check if enough samples are already
   // made for this query.
   if (SortPolicy::IsBetter(distance, bestDistance)
-      && numSamplesMade[queryIndex] < numSamplesReqd)
+      && numSamplesMade[queryIndex - queryBegin] < numSamplesReqd)
   {
     // We cannot prune this node; try approximating it by sampling.
 
     // If we are required to visit the first leaf (to find possible duplicates),
     // make sure we do not approximate.
-    if (numSamplesMade[queryIndex] > 0 || !firstLeafExact)
+    if (numSamplesMade[queryIndex - queryBegin] > 0 || !firstLeafExact)
     {
       // Check if this node can be approximated by sampling.
       size_t samplesReqd = (size_t) std::ceil(samplingRatio *
           (double) referenceNode.NumDescendants());
       samplesReqd = std::min(samplesReqd,
-          numSamplesReqd - numSamplesMade[queryIndex]);
+          numSamplesReqd - numSamplesMade[queryIndex - queryBegin]);
 
       if (samplesReqd > singleSampleLimit && !referenceNode.IsLeaf())
       {
@@ -200,12 +232,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
         {
           // Then samplesReqd <= singleSampleLimit.
           // Hence, approximate the node by sampling enough number of points.
-          arma::uvec distinctSamples =
-              arma::randperm(referenceNode.NumDescendants(), samplesReqd);
-          for (size_t i = 0; i < distinctSamples.n_elem; ++i)
-            // The counting of the samples are done in the 'BaseCase' function
-            // so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+          SampleBaseCases(queryIndex, &referenceNode, samplesReqd);
 
           // Node approximated, so we can prune it.
           return DBL_MAX;
@@ -215,13 +242,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           if (sampleAtLeaves) // If allowed to sample at leaves.
           {
             // Approximate node by sampling enough number of points.
-            arma::uvec distinctSamples =
-                arma::randperm(referenceNode.NumDescendants(), samplesReqd);
-            for (size_t i = 0; i < distinctSamples.n_elem; ++i)
-              // The counting of the samples are done in the 'BaseCase' function
-              // so no book-keeping is required here.
-              BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[i]));
+            SampleBaseCases(queryIndex, &referenceNode, samplesReqd);
 
             // (Leaf) node approximated, so we can prune it.
             return DBL_MAX;
@@ -251,7 +272,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
 
     // If enough samples are already made, this step does not change the result
     // of the search.
-    numSamplesMade[queryIndex] += (size_t) std::floor(
+    numSamplesMade[queryIndex - queryBegin] += (size_t) std::floor(
         samplingRatio * (double) referenceNode.NumDescendants());
 
     return DBL_MAX;
@@ -269,13 +290,13 @@ Rescore(const size_t queryIndex,
     return oldScore;
 
   // Just check the score again against the distances.
-  const double bestDistance = candidates[queryIndex].top().first;
+  const double bestDistance = candidates[queryIndex - queryBegin].top().first;
 
   // If this is better than the best distance we've seen so far,
   // maybe there will be something down this node.
   // Also check if enough samples are already made for this query.
   if (SortPolicy::IsBetter(oldScore, bestDistance)
-      && numSamplesMade[queryIndex] < numSamplesReqd)
+      && numSamplesMade[queryIndex - queryBegin] < numSamplesReqd)
   {
     // We cannot prune this node; thus, we try approximating this node by
     // sampling.
@@ -288,7 +309,7 @@ Rescore(const size_t queryIndex,
     size_t samplesReqd = (size_t) std::ceil(samplingRatio *
         (double) referenceNode.NumDescendants());
     samplesReqd = std::min(samplesReqd, numSamplesReqd -
-        numSamplesMade[queryIndex]);
+        numSamplesMade[queryIndex - queryBegin]);
 
     if (samplesReqd > singleSampleLimit && !referenceNode.IsLeaf())
     {
@@ -302,12 +323,7 @@ Rescore(const size_t queryIndex,
       {
         // Then, samplesReqd <= singleSampleLimit.  Hence, approximate the node
         // by sampling enough number of points.
-        arma::uvec distinctSamples =
-            arma::randperm(referenceNode.NumDescendants(), samplesReqd);
-        for (size_t i = 0; i < distinctSamples.n_elem; ++i)
-          // The counting of the samples are done in the 'BaseCase' function so
-          // no book-keeping is required here.
-          BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+        SampleBaseCases(queryIndex, &referenceNode, samplesReqd);
 
         // Node approximated, so we can prune it.
         return DBL_MAX;
@@ -317,12 +333,7 @@ Rescore(const size_t queryIndex,
         if (sampleAtLeaves)
         {
           // Approximate node by sampling enough points.
-          arma::uvec distinctSamples =
-              arma::randperm(referenceNode.NumDescendants(), samplesReqd);
-          for (size_t i = 0; i < distinctSamples.n_elem; ++i)
-            // The counting of the samples are done in the 'BaseCase' function
-            // so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+          SampleBaseCases(queryIndex, &referenceNode, samplesReqd);
 
           // (Leaf) node approximated, so we can prune it.
           return DBL_MAX;
@@ -343,8 +354,8 @@ Rescore(const size_t queryIndex,
     // Add 'fake' samples from this node; they are fake because the distances to
     // these samples need not be computed.  If enough samples are already made,
     // this step does not change the result of the search.
-    numSamplesMade[queryIndex] += (size_t) std::floor(samplingRatio *
-        (double) referenceNode.NumDescendants());
+    numSamplesMade[queryIndex - queryBegin] += (size_t) std::floor(
+        samplingRatio * (double) referenceNode.NumDescendants());
 
     return DBL_MAX;
   }
@@ -367,7 +378,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
 
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
-    const double bound = candidates[queryNode.Point(i)].top().first
+    const double bound = candidates[queryNode.Point(i) - queryBegin].top().first
         + maxDescendantDistance;
     if (bound < pointBound)
       pointBound = bound;
@@ -406,7 +417,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
 
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
-    const double bound = candidates[queryNode.Point(i)].top().first
+    const double bound = candidates[queryNode.Point(i) - queryBegin].top().first
         + maxDescendantDistance;
     if (bound < pointBound)
       pointBound = bound;
@@ -500,17 +511,10 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
         {
           // Then samplesReqd <= singleSampleLimit.  Hence, approximate node by
           // sampling enough number of points for every query in the query node.
-          arma::uvec distinctSamples;
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
           {
-            const size_t queryIndex = queryNode.Descendant(i);
-            distinctSamples = arma::randperm(referenceNode.NumDescendants(),
+            SampleBaseCases(queryNode.Descendant(i), &referenceNode,
                 samplesReqd);
-            for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-              // The counting of the samples are done in the 'BaseCase' function
-              // so no book-keeping is required here.
-              BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[j]));
           }
 
           // Update the number of samples made for the queryNode and also update
@@ -530,17 +534,10 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           {
             // Approximate node by sampling enough number of points for every
             // query in the query node.
-            arma::uvec distinctSamples;
             for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
             {
-              const size_t queryIndex = queryNode.Descendant(i);
-              distinctSamples = arma::randperm(referenceNode.NumDescendants(),
+              SampleBaseCases(queryNode.Descendant(i), &referenceNode,
                   samplesReqd);
-              for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-                // The counting of the samples are done in the 'BaseCase'
-                // function so no book-keeping is required here.
-                BaseCase(queryIndex,
-                    referenceNode.Descendant(distinctSamples[j]));
             }
 
             // Update the number of samples made for the queryNode and also
@@ -620,7 +617,7 @@ Rescore(TreeType& queryNode,
 
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
-    const double bound = candidates[queryNode.Point(i)].top().first
+    const double bound = candidates[queryNode.Point(i) - queryBegin].top().first
         + maxDescendantDistance;
     if (bound < pointBound)
       pointBound = bound;
@@ -705,17 +702,8 @@ Rescore(TreeType& queryNode,
       {
         // then samplesReqd <= singleSampleLimit.  Hence, approximate the node
         // by sampling enough points for every query in the query node.
-        arma::uvec distinctSamples;
         for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
-        {
-          const size_t queryIndex = queryNode.Descendant(i);
-          distinctSamples = arma::randperm(referenceNode.NumDescendants(),
-              samplesReqd);
-          for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-            // The counting of the samples are done in the 'BaseCase'
-            // function so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[j]));
-        }
+          SampleBaseCases(queryNode.Descendant(i), &referenceNode, samplesReqd);
 
         // Update the number of samples made for the query node and also update
         // the number of samples made for the child nodes.
@@ -734,17 +722,10 @@ Rescore(TreeType& queryNode,
         {
           // Approximate node by sampling enough points for every query in the
           // query node.
-          arma::uvec distinctSamples;
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
           {
-            const size_t queryIndex = queryNode.Descendant(i);
-            distinctSamples = arma::randperm(referenceNode.NumDescendants(),
+            SampleBaseCases(queryNode.Descendant(i), &referenceNode,
                 samplesReqd);
-            for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-              // The counting of the samples are done in BaseCase() so no
-              // book-keeping is required here.
-              BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[j]));
           }
 
           // Update the number of samples made for the query node and also
@@ -791,6 +772,89 @@ Rescore(TreeType& queryNode,
   }
 } // Rescore(node, node, oldScore)
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline void RASearchRules<SortPolicy, MetricType, TreeType>::SeedQuery(
+    const size_t queryIndex)
+{
+  // Each query point has its own stream; starting it is cheap.
+  rng = RandomStream(seed, queryIndex);
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline void RASearchRules<SortPolicy, MetricType, TreeType>::SampleBaseCases(
+    const size_t queryIndex,
+    TreeType* referenceNode,
+    const size_t numSamples)
+{
+  const size_t numPoints = (referenceNode == NULL) ? referenceSet.n_cols :
+      referenceNode->NumDescendants();
+  Sample(numPoints, numSamples);
+
+  // Map the samples to reference points, skipping the query point itself, so
+  // that all of the distances can be computed in one pass.
+  size_t numBaseCases = 0;
+  for (size_t i = 0; i < samples.size(); ++i)
+  {
+    const size_t referenceIndex = (referenceNode == NULL) ? samples[i] :
+        referenceNode->Descendant(samples[i]);
+    if (!sameSet || referenceIndex != queryIndex)
+      samples[numBaseCases++] = referenceIndex;
+  }
+
+  sampleDistances.set_size(numBaseCases);
+  const arma::vec queryPoint = querySet.unsafe_col(queryIndex);
+  for (size_t i = 0; i < numBaseCases; ++i)
+  {
+    sampleDistances[i] = metric.Evaluate(queryPoint,
+        referenceSet.unsafe_col(samples[i]));
+  }
+
+  for (size_t i = 0; i < numBaseCases; ++i)
+    InsertNeighbor(queryIndex, samples[i], sampleDistances[i]);
+
+  numSamplesMade[queryIndex - queryBegin] += numBaseCases;
+  numDistComputations += numBaseCases;
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline void RASearchRules<SortPolicy, MetricType, TreeType>::Sample(
+    const size_t numPoints,
+    const size_t numSamples)
+{
+  samples.clear();
+  if (numSamples >= numPoints)
+  {
+    for (size_t i = 0; i < numPoints; ++i)
+      samples.push_back(i);
+  }
+  else if (numSamples <= 32)
+  {
+    // Floyd's algorithm: few samples are checked for duplicates quickly.
+    for (size_t j = numPoints - numSamples; j < numPoints; ++j)
+    {
+      const size_t t = std::uniform_int_distribution<size_t>(0, j)(rng);
+      if (std::find(samples.begin(), samples.end(), t) == samples.end())
+        samples.push_back(t);
+      else
+        samples.push_back(j);
+    }
+  }
+  else
+  {
+    // Take the first elements of a partial random permutation.
+    permutation.resize(numPoints);
+    for (size_t i = 0; i < numPoints; ++i)
+      permutation[i] = i;
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+      const size_t j = std::uniform_int_distribution<size_t>(i,
+          numPoints - 1)(rng);
+      std::swap(permutation[i], permutation[j]);
+    }
+    samples.assign(permutation.begin(), permutation.begin() + numSamples);
+  }
+}
+
 /**
  * Helper function to insert a point into the list of candidate points.
  *
@@ -805,7 +869,7 @@ InsertNeighbor(
     const size_t neighbor,
     const double distance)
 {
-  CandidateList& pqueue = candidates[queryIndex];
+  CandidateList& pqueue = candidates[queryIndex - queryBegin];
   Candidate c = std::make_pair(distance, neighbor);
 
   if (CandidateCmp()(c, pqueue.top()))
@@ -137,7 +137,9 @@ namespace ens {
    * Template specialization for the SGD and parallel SGD optimizer. Used
    * because the gradient affects only a small number of parameters per example,
    * and thus the normal abstraction does not work as fast as we might like it
-   * to.
+   * to.  The parallel SGD specialization visits the ratings in blocks that
+   * never share a user or an item (see mlpack::StratifiedParallelSGD()), so
+   * that threads update the parameters without atomic operations.
    */
   template <>
   template <>
@@ -14,6 +14,7 @@
 
 #include "regularized_svd_function.hpp"
 #include <mlpack/core/math/make_alias.hpp>
+#include "stratified_sgd.hpp"
 
 namespace mlpack {
 
@@ -222,103 +223,38 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
     mlpack::RegularizedSVDFunction<arma::mat>& function,
     arma::mat& iterate)
 {
-  double overallObjective = DBL_MAX;
-  double lastObjective;
+  const arma::mat& data = function.Dataset();
+  const size_t numUsers = function.NumUsers();
+  const double lambda = function.Lambda();
 
-  // The order in which the functions will be visited.
-  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
-      (function.NumFunctions() - 1), function.NumFunctions());
-
-  const arma::mat data = function.Dataset();
-
-  // Iterate till the objective is within tolerance or the maximum number of
-  // allowed iterations is reached. If maxIterations is 0, this will iterate
-  // till convergence.
-  for (size_t i = 1; i != maxIterations; ++i)
+  // The ratings are visited in blocks that never share a user or an item, so
+  // the parameters are updated in place without atomic operations.
+  auto update = [&](const size_t j, const double stepSize)
   {
-    // Calculate the overall objective.
-    lastObjective = overallObjective;
-    overallObjective = 0;
-
-    #pragma omp parallel for reduction(+:overallObjective)
-    for (size_t j = 0; j < (size_t) function.NumFunctions(); ++j)
-    {
-      overallObjective += function.Evaluate(iterate, j);
-    }
-
-    // Output current objective function.
-    mlpack::Log::Info << "Parallel SGD: iteration " << i << ", objective "
-        << overallObjective << "." << std::endl;
-
-    if (std::isnan(overallObjective) || std::isinf(overallObjective))
-    {
-      mlpack::Log::Warn << "Parallel SGD: converged to " << overallObjective
-          << "; terminating with failure. Try a smaller step size?"
-          << std::endl;
-      return overallObjective;
-    }
-
-    if (std::abs(lastObjective - overallObjective) < tolerance)
-    {
-      mlpack::Log::Info << "SGD: minimized within tolerance " << tolerance
-          << "; terminating optimization." << std::endl;
-      return overallObjective;
-    }
-
-    // Get the stepsize for this iteration
-    double stepSize = decayPolicy.StepSize(i);
+    // Indices for accessing the the correct parameter columns.
+    const size_t user = data(0, j);
+    const size_t item = data(1, j) + numUsers;
 
-    if (shuffle) // Determine order of visitation.
-      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
-          mlpack::RandGen());
+    // Prediction error for the example.
+    const double rating = data(2, j);
+    const double ratingError = rating - dot(iterate.col(user),
+        iterate.col(item));
 
-    #pragma omp parallel
+    // Gradient is non-zero only for the parameter columns corresponding to the
+    // example.
+    double* userVec = iterate.colptr(user);
+    double* itemVec = iterate.colptr(item);
+    for (size_t i = 0; i < iterate.n_rows; ++i)
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef MLPACK_USE_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
-      {
-        const size_t numUsers = function.NumUsers();
-
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        double ratingError = rating - dot(iterate.col(user),
-            iterate.col(item));
-
-        double lambda = function.Lambda();
-
-        arma::mat userUpdate = stepSize * (lambda * iterate.col(user) -
-            ratingError * iterate.col(item));
-        arma::mat itemUpdate = stepSize * (lambda * iterate.col(item) -
-            ratingError * iterate.col(user));
-
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < iterate.n_rows; ++i)
-        {
-          #pragma omp atomic
-          iterate(i, user) -= userUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemUpdate(i);
-        }
-      }
+      const double userValue = userVec[i];
+      userVec[i] -= stepSize * (lambda * userValue - ratingError * itemVec[i]);
+      itemVec[i] -= stepSize * (lambda * itemVec[i] - ratingError * userValue);
     }
-  }
-  mlpack::Log::Info << "\n Parallel SGD terminated with objective : "
-      << overallObjective << std::endl;
+  };
+  auto endStratum = [](const double /* stepSize */) { };
 
-  return overallObjective;
+  return mlpack::StratifiedParallelSGD(*this, function, iterate, update,
+      endStratum);
 }
 
 } // namespace ens
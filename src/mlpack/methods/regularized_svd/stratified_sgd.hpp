@@ -0,0 +1,276 @@
+/**
+ * @file methods/regularized_svd/stratified_sgd.hpp
+ *
+ * Conflict-free parallel SGD for matrix factorization of a list of ratings,
+ * by stratification of the rating matrix into blocks of users and items.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_REGULARIZED_SVD_STRATIFIED_SGD_HPP
+#define MLPACK_METHODS_REGULARIZED_SVD_STRATIFIED_SGD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/executor.hpp>
+#include <ensmallen.hpp>
+
+#ifdef MLPACK_USE_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+
+/**
+ * RatingStrata partitions a list of (user, item, rating) triples into
+ * b x b blocks, given by a partition of the users into b groups and of the
+ * items into b groups.  Stratum s is made of the b blocks (g, (g + s) mod b),
+ * for each user group g; two blocks of the same stratum never share a user or
+ * an item, so they can be processed in parallel without any conflict on the
+ * factors of the users and items.
+ *
+ * The users and items are assigned to their groups at random, so that the
+ * blocks have about the same number of ratings.  This is the stratification of
+ * the following paper:
+ *
+ * @code
+ * @inproceedings{gemulla2011large,
+ *   title={Large-Scale Matrix Factorization with Distributed Stochastic
+ *       Gradient Descent},
+ *   author={Gemulla, R. and Nijkamp, E. and Haas, P.J. and Sismanis, Y.},
+ *   booktitle={Proceedings of the 17th ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining},
+ *   pages={69--77},
+ *   year={2011}
+ * }
+ * @endcode
+ */
+class RatingStrata
+{
+ public:
+  /**
+   * Partition the given ratings into blocks.
+   *
+   * @param data Ratings, one (user, item, rating) triple per column.
+   * @param numUsers Number of users.
+   * @param numItems Number of items.
+   * @param numBlocks Number of groups of users (and of items).
+   */
+  RatingStrata(const arma::mat& data,
+               const size_t numUsers,
+               const size_t numItems,
+               const size_t numBlocks) :
+      numBlocks(std::max(numBlocks, (size_t) 1)),
+      offsets(this->numBlocks * this->numBlocks + 1, 0),
+      indices(data.n_cols),
+      strata(this->numBlocks)
+  {
+    const arma::uvec userOrder = arma::randperm(numUsers);
+    const arma::uvec itemOrder = arma::randperm(numItems);
+    userGroups.set_size(numUsers);
+    itemGroups.set_size(numItems);
+    for (size_t i = 0; i < numUsers; ++i)
+      userGroups[userOrder[i]] = i * this->numBlocks / numUsers;
+    for (size_t i = 0; i < numItems; ++i)
+      itemGroups[itemOrder[i]] = i * this->numBlocks / numItems;
+
+    // Sort the ratings by block, with a counting sort.
+    for (size_t i = 0; i < data.n_cols; ++i)
+      ++offsets[BlockIndex(data(0, i), data(1, i)) + 1];
+    for (size_t i = 1; i < offsets.size(); ++i)
+      offsets[i] += offsets[i - 1];
+
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < data.n_cols; ++i)
+      indices[next[BlockIndex(data(0, i), data(1, i))]++] = i;
+
+    for (size_t s = 0; s < this->numBlocks; ++s)
+      strata[s] = s;
+  }
+
+  /**
+   * Shuffle the order of the ratings of each block, and the order in which the
+   * strata are visited.
+   */
+  void Shuffle()
+  {
+    for (size_t i = 0; i + 1 < offsets.size(); ++i)
+    {
+      std::shuffle(indices.begin() + offsets[i],
+          indices.begin() + offsets[i + 1], RandGen());
+    }
+    std::shuffle(strata.begin(), strata.end(), RandGen());
+  }
+
+  //! Get the number of groups of users (and of items).
+  size_t NumBlocks() const { return numBlocks; }
+
+  //! Get the s-th stratum to visit.
+  size_t Stratum(const size_t s) const { return strata[s]; }
+
+  /**
+   * Get the range of the ratings of the block of the given user group in the
+   * given stratum, as positions in Indices().
+   *
+   * @param stratum Stratum of the block.
+   * @param userGroup Group of users of the block.
+   * @param begin Set to the position of the first rating of the block.
+   * @param end Set to the position after the last rating of the block.
+   */
+  void Block(const size_t stratum,
+             const size_t userGroup,
+             size_t& begin,
+             size_t& end) const
+  {
+    const size_t block = userGroup * numBlocks +
+        (userGroup + stratum) % numBlocks;
+    begin = offsets[block];
+    end = offsets[block + 1];
+  }
+
+  //! Get the indices of the ratings, sorted by block.
+  const std::vector<size_t>& Indices() const { return indices; }
+
+ private:
+  //! Get the index of the block of the given user and item.
+  size_t BlockIndex(const size_t user, const size_t item) const
+  {
+    return userGroups[user] * numBlocks + itemGroups[item];
+  }
+
+  //! The number of groups of users (and of items).
+  size_t numBlocks;
+
+  //! The group of each user.
+  arma::uvec userGroups;
+
+  //! The group of each item.
+  arma::uvec itemGroups;
+
+  //! The position in indices of the first rating of each block.
+  std::vector<size_t> offsets;
+
+  //! The indices of the ratings, sorted by block.
+  std::vector<size_t> indices;
+
+  //! The order in which the strata are visited.
+  std::vector<size_t> strata;
+};
+
+/**
+ * Run parallel SGD on a matrix factorization function of a list of ratings
+ * (such as RegularizedSVDFunction), with the settings of the given
+ * ParallelSGD optimizer, visiting the ratings stratum by stratum (see
+ * RatingStrata).  The blocks of each stratum are processed by different
+ * threads at the same time; since they never share a user or an item, the
+ * updates need no atomic operation.
+ *
+ * Each iteration visits each stratum once.  Each thread visits at most about
+ * `optimizer.ThreadShareSize()` ratings per iteration, split between its
+ * blocks in proportion to their size; so, with a thread share size of at least
+ * the number of ratings divided by the number of threads, each iteration is an
+ * epoch over all the ratings.
+ *
+ * @param optimizer ParallelSGD optimizer giving the settings of the
+ *     optimization.
+ * @param function Function to optimize.
+ * @param iterate Starting point; set to the optimized parameters.
+ * @param update Called as `update(rating, stepSize)` to update the parameters
+ *     with the rating of the given index in the dataset of the function.
+ * @param endStratum Called as `endStratum(stepSize)` after each stratum.
+ * @return The objective at the last iteration.
+ */
+template<typename DecayPolicyType,
+         typename FunctionType,
+         typename UpdateType,
+         typename StratumEndType>
+double StratifiedParallelSGD(ens::ParallelSGD<DecayPolicyType>& optimizer,
+                             FunctionType& function,
+                             arma::mat& iterate,
+                             UpdateType& update,
+                             StratumEndType& endStratum)
+{
+  double overallObjective = DBL_MAX;
+  double lastObjective;
+
+  const size_t numThreads = NumThreads();
+
+  RatingStrata strata(function.Dataset(), function.NumUsers(),
+      function.NumItems(), numThreads);
+  const std::vector<size_t>& indices = strata.Indices();
+  const size_t numBlocks = strata.NumBlocks();
+
+  // The fraction of the ratings of each block that are visited at each
+  // iteration.
+  const double visitFraction = std::min(1.0, (double) numBlocks *
+      optimizer.ThreadShareSize() / function.NumFunctions());
+
+  // Iterate till the objective is within tolerance or the maximum number of
+  // allowed iterations is reached. If maxIterations is 0, this will iterate
+  // till convergence.
+  for (size_t i = 1; i != optimizer.MaxIterations(); ++i)
+  {
+    // Calculate the overall objective.
+    lastObjective = overallObjective;
+    overallObjective = 0;
+
+    #pragma omp parallel for reduction(+:overallObjective) \
+        num_threads((int) NumThreads())
+    for (size_t j = 0; j < (size_t) function.NumFunctions(); ++j)
+    {
+      overallObjective += function.Evaluate(iterate, j);
+    }
+
+    // Output current objective function.
+    Log::Info << "Parallel SGD: iteration " << i << ", objective "
+        << overallObjective << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "Parallel SGD: converged to " << overallObjective
+          << "; terminating with failure. Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < optimizer.Tolerance())
+    {
+      Log::Info << "SGD: minimized within tolerance " << optimizer.Tolerance()
+          << "; terminating optimization." << std::endl;
+      return overallObjective;
+    }
+
+    // Get the stepsize for this iteration
+    const double stepSize = optimizer.DecayPolicy().StepSize(i);
+
+    if (optimizer.Shuffle()) // Determine order of visitation.
+      strata.Shuffle();
+
+    for (size_t s = 0; s < numBlocks; ++s)
+    {
+      const size_t stratum = strata.Stratum(s);
+
+      #pragma omp parallel for schedule(static, 1) \
+          num_threads((int) NumThreads())
+      for (size_t g = 0; g < numBlocks; ++g)
+      {
+        size_t begin, end;
+        strata.Block(stratum, g, begin, end);
+        end = begin + (size_t) std::ceil(visitFraction * (end - begin));
+        for (size_t j = begin; j < end; ++j)
+          update(indices[j], stepSize);
+      }
+
+      endStratum(stepSize);
+    }
+  }
+  Log::Info << "\n Parallel SGD terminated with objective : "
+      << overallObjective << std::endl;
+
+  return overallObjective;
+}
+
+} // namespace mlpack
+
+#endif
@@ -67,10 +67,12 @@ void AsyncLearning<
   NetworkType learningNetwork = std::move(this->learningNetwork);
   if (learningNetwork.Parameters().n_elem != environment.InitialSample().Encode().n_elem)
     learningNetwork.Reset(environment.InitialSample().Encode().n_elem);
-  NetworkType targetNetwork = learningNetwork;
-  size_t totalSteps = 0;
+  // The workers share the parameters of the target network and the total
+  // number of steps without any lock; see TargetParameters.
+  TargetParameters<arma::mat> targetParameters(learningNetwork.Parameters());
+  std::atomic<size_t> totalSteps(0);
   PolicyType policy = this->policy;
-  bool stop = false;
+  std::atomic<bool> stop(false);
 
   // Set up worker pool, worker 0 will be deterministic for evaluation.
   std::vector<WorkerType> workers;
@@ -95,7 +97,7 @@ void AsyncLearning<
   Log::Debug << numThreads << " threads will be used in total." << std::endl;
 
   #pragma omp parallel for shared(stop, workers, tasks, learningNetwork, \
-      targetNetwork, totalSteps, policy)
+      targetParameters, totalSteps, policy)
   for (size_t i = 0; i < numThreads; ++i)
   {
     #pragma omp critical
@@ -106,20 +108,29 @@ void AsyncLearning<
       #endif
     }
     size_t task = std::numeric_limits<size_t>::max();
+    size_t taskSteps = 0;
     while (!stop)
     {
-      // Assign task to current thread from queue.
-      #pragma omp critical
+      // Assign task to current thread from queue.  A thread keeps its worker
+      // until the episode ends or until the worker has made an update, so
+      // that the threads rarely wait for each other on the queue.
+      if (task == std::numeric_limits<size_t>::max() ||
+          taskSteps >= config.UpdateInterval())
       {
-        if (task != std::numeric_limits<size_t>::max())
-          tasks.push(task);
-
-        if (!tasks.empty())
+        #pragma omp critical
         {
-          task = tasks.front();
-          tasks.pop();
-        }
-      };
+          if (task != std::numeric_limits<size_t>::max())
+            tasks.push(task);
+
+          task = std::numeric_limits<size_t>::max();
+          if (!tasks.empty())
+          {
+            task = tasks.front();
+            tasks.pop();
+          }
+        };
+        taskSteps = 0;
+      }
 
       // This may happen when threads are more than workers.
       if (task == std::numeric_limits<size_t>::max())
@@ -128,10 +139,13 @@ void AsyncLearning<
       // Get corresponding worker.
       WorkerType& worker = workers[task];
       double episodeReturn;
-      if (worker.Step(learningNetwork, targetNetwork, totalSteps,
-          policy, episodeReturn) && !task)
+      ++taskSteps;
+      if (worker.Step(learningNetwork, targetParameters, totalSteps,
+          policy, episodeReturn))
       {
-        stop = measure(episodeReturn);
+        if (!task)
+          stop = measure(episodeReturn);
+        taskSteps = config.UpdateInterval();
       }
     }
   }
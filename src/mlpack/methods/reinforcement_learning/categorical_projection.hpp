@@ -0,0 +1,129 @@
+/**
+ * @file methods/reinforcement_learning/categorical_projection.hpp
+ *
+ * Projection of the target return distributions of a batch onto the fixed
+ * support of categorical (distributional) Q-Learning.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_CATEGORICAL_PROJECTION_HPP
+#define MLPACK_METHODS_RL_CATEGORICAL_PROJECTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * CategoricalProjection computes the categorical projection of the C51
+ * algorithm (Bellemare et al., 2017) for a whole batch at once.  Given the
+ * probabilities of the next-state return distributions over the atoms z_j of
+ * the fixed support [vMin, vMax], each atom is moved to r + discount * z_j
+ * (or r, for terminal transitions), clamped to the support, and its mass is
+ * split between the two neighboring atoms in proportion to the distance.
+ *
+ * The positions of the moved atoms and the indices of their neighbors are
+ * computed for the whole batch with matrix operations, and the masses are
+ * then scattered onto the output in a single pass over the batch.  The
+ * workspaces are kept in the object and reused between batches.  When a moved
+ * atom falls exactly on an atom of the support, all of its mass goes to that
+ * atom.
+ *
+ * @code
+ * @inproceedings{bellemare2017distributional,
+ *   title={A distributional perspective on reinforcement learning},
+ *   author={Bellemare, M.G. and Dabney, W. and Munos, R.},
+ *   booktitle={Proceedings of the 34th International Conference on Machine
+ *       Learning (ICML 2017)},
+ *   pages={449--458},
+ *   year={2017}
+ * }
+ * @endcode
+ */
+class CategoricalProjection
+{
+ public:
+  /**
+   * Project the given next-state distributions onto the support.
+   *
+   * @param nextDist Probabilities of the next-state return distributions, one
+   *     column of atomSize atoms per transition.
+   * @param rewards Reward of each transition.
+   * @param isTerminal Whether each transition ended the episode.
+   * @param discount Discount factor.
+   * @param vMin Minimum value of the support.
+   * @param vMax Maximum value of the support.
+   * @param projDist Matrix to store the projected distributions in.
+   */
+  void Project(const arma::mat& nextDist,
+               const arma::rowvec& rewards,
+               const arma::irowvec& isTerminal,
+               const double discount,
+               const double vMin,
+               const double vMax,
+               arma::mat& projDist)
+  {
+    const size_t atomSize = nextDist.n_rows;
+    const size_t batchSize = nextDist.n_cols;
+
+    if (support.n_elem != atomSize || support[0] != vMin ||
+        support[atomSize - 1] != vMax)
+    {
+      support = arma::linspace<arma::vec>(vMin, vMax, atomSize);
+    }
+
+    // Positions of the moved atoms, in units of atoms of the support.
+    notTerminal = discount * arma::conv_to<arma::rowvec>::from(1 - isTerminal);
+    position = support * notTerminal;
+    position.each_row() += rewards;
+    position = (arma::clamp(position, vMin, vMax) - vMin) *
+        ((atomSize - 1) / (vMax - vMin));
+
+    // Each moved atom gives 1 - fraction of its mass to the atom below it and
+    // fraction to the atom above it.
+    lower = arma::conv_to<arma::umat>::from(arma::floor(position));
+    lower = arma::clamp(lower, 0, atomSize - 1);
+    fraction = position - arma::conv_to<arma::mat>::from(lower);
+    lower.each_row() += atomSize * arma::regspace<arma::urowvec>(0,
+        batchSize - 1);
+
+    projDist.zeros(atomSize, batchSize);
+    const double* dist = nextDist.memptr();
+    const double* frac = fraction.memptr();
+    const arma::uword* index = lower.memptr();
+    const size_t topAtom = atomSize - 1;
+    double* out = projDist.memptr();
+    for (size_t k = 0; k < nextDist.n_elem; ++k)
+    {
+      // A moved atom at the top of the support has no atom above it.
+      if ((index[k] % atomSize) == topAtom)
+      {
+        out[index[k]] += dist[k];
+      }
+      else
+      {
+        const double mass = dist[k] * frac[k];
+        out[index[k]] += dist[k] - mass;
+        out[index[k] + 1] += mass;
+      }
+    }
+  }
+
+ private:
+  //! The atoms of the support.
+  arma::vec support;
+  //! Discount of each transition (zero for terminal transitions).
+  arma::rowvec notTerminal;
+  //! Positions of the moved atoms.
+  arma::mat position;
+  //! Fraction of the mass of each moved atom that goes to the atom above.
+  arma::mat fraction;
+  //! Linear index in the output of the atom below each moved atom.
+  arma::umat lower;
+};
+
+} // namespace mlpack
+
+#endif
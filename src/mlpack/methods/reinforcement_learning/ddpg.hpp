@@ -17,6 +17,7 @@
 #include <ensmallen.hpp>
 #include <mlpack/methods/ann/ann.hpp>
 
+#include "environment/vector_environment.hpp"
 #include "replay/replay.hpp"
 #include "training_config.hpp"
 
@@ -122,6 +123,18 @@ class DDPG
    */
   double Episode();
 
+  /**
+   * Take one step in every copy of the environment held by `environments`.
+   * The actions of all copies are computed with one pass of all their states
+   * through the policy network, and the transitions are stored together; then
+   * the agent is updated as often as `Episode()` would have updated it for the
+   * same number of steps.  The returns of the episodes that ended in this step
+   * are then available in `environments.EpisodeReturns()`.
+   *
+   * @param environments The copies of the environment to step.
+   */
+  void Step(VectorEnvironment<EnvironmentType>& environments);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
@@ -350,5 +350,64 @@ double DDPG<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename QNetworkType,
+  typename PolicyNetworkType,
+  typename NoiseType,
+  typename UpdaterType,
+  typename ReplayType
+>
+void DDPG<
+  EnvironmentType,
+  QNetworkType,
+  PolicyNetworkType,
+  NoiseType,
+  UpdaterType,
+  ReplayType
+>::Step(VectorEnvironment<EnvironmentType>& environments)
+{
+  // Get the actions of all the copies with one pass.
+  arma::mat encodedStates, outputActions;
+  environments.EncodedStates(encodedStates);
+  policyNetwork.Predict(encodedStates, outputActions);
+
+  // Explore with clipped noise, as SelectAction() does.
+  if (!deterministic)
+  {
+    for (size_t i = 0; i < outputActions.n_cols; ++i)
+    {
+      arma::colvec sample = noise.sample() * 0.1;
+      outputActions.col(i) += arma::clamp(sample, -0.25, 0.25);
+    }
+  }
+
+  std::vector<ActionType> actions(environments.Copies());
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    actions[i].action = ConvTo<std::vector<double>>::From(
+        arma::colvec(outputActions.col(i)));
+  }
+
+  // Interact with all the environments, and store all the transitions.
+  const std::vector<StateType> states = environments.States();
+  std::vector<StateType> nextStates;
+  arma::rowvec rewards;
+  arma::irowvec isTerminal;
+  environments.Step(actions, nextStates, rewards, isTerminal);
+  replayMethod.StoreBatch(states, actions, rewards, nextStates, isTerminal,
+      config.Discount());
+
+  // Update as often as Episode() does for the same number of steps.
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    totalSteps++;
+    if (deterministic || totalSteps < config.ExplorationSteps())
+      continue;
+    for (size_t j = 0; j < config.UpdateInterval(); j++)
+      Update();
+  }
+}
+
 } // namespace mlpack
 #endif
@@ -0,0 +1,186 @@
+/**
+ * @file methods/reinforcement_learning/environment/vector_environment.hpp
+ *
+ * Wrapper that steps several copies of an RL environment together.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * A VectorEnvironment holds several copies of an environment, each with its
+ * own current state, and steps all of them at once.  The states of all copies
+ * are available as the columns of one matrix, so that an agent can select the
+ * actions of all copies with one batched pass through its network instead of
+ * one pass for each step; see for instance `QLearning::Step()`.
+ *
+ * When the episode of a copy ends (because its next state is terminal, or
+ * because the episode has reached the step limit), the episode return is
+ * recorded in `EpisodeReturns()` and the copy starts a new episode right away,
+ * so that every copy has a current state after each step.
+ *
+ * @code
+ * VectorEnvironment<CartPole> environments(16);
+ * for (size_t i = 0; i < 1000; ++i)
+ * {
+ *   agent.Step(environments);
+ *   for (double episodeReturn : environments.EpisodeReturns())
+ *     std::cout << "Episode return: " << episodeReturn << std::endl;
+ * }
+ * @endcode
+ *
+ * @tparam EnvironmentType The environment of which copies are stepped.
+ */
+template<typename EnvironmentType>
+class VectorEnvironment
+{
+ public:
+  //! Convenient typedef for state.
+  using State = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using Action = typename EnvironmentType::Action;
+
+  /**
+   * Create the given number of copies of the given environment, and start an
+   * episode in each of them.
+   *
+   * @param copies Number of copies of the environment to step together.
+   * @param environment The environment to copy.
+   * @param stepLimit Maximum number of steps of each episode (0 means no
+   *     limit).
+   */
+  VectorEnvironment(const size_t copies,
+                    const EnvironmentType& environment = EnvironmentType(),
+                    const size_t stepLimit = 0) :
+      environments(copies, environment),
+      states(copies),
+      returns(copies, 0.0),
+      steps(copies, 0),
+      stepLimit(stepLimit)
+  {
+    if (copies == 0)
+    {
+      throw std::invalid_argument("VectorEnvironment::VectorEnvironment(): "
+          "the number of copies must be positive!");
+    }
+
+    for (size_t i = 0; i < copies; ++i)
+      states[i] = environments[i].InitialSample();
+  }
+
+  /**
+   * Take one step in every copy, with the given action for each copy, from the
+   * states in `States()`.  Afterwards, `States()` holds the states that the
+   * next step starts from, so copies whose episode has ended are already in
+   * the initial state of a new episode; `nextStates` holds the states that
+   * were actually reached.
+   *
+   * @param actions The action of each copy.
+   * @param nextStates Set to the state reached by each copy.
+   * @param rewards Set to the reward of each copy.
+   * @param isTerminal Set to whether the state reached by each copy is
+   *     terminal.
+   */
+  void Step(const std::vector<Action>& actions,
+            std::vector<State>& nextStates,
+            arma::rowvec& rewards,
+            arma::irowvec& isTerminal)
+  {
+    if (actions.size() != environments.size())
+    {
+      throw std::invalid_argument("VectorEnvironment::Step(): the number of "
+          "actions does not match the number of copies!");
+    }
+
+    nextStates.resize(environments.size());
+    rewards.set_size(environments.size());
+    isTerminal.set_size(environments.size());
+    episodeReturns.clear();
+
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      rewards[i] = environments[i].Sample(states[i], actions[i], nextStates[i]);
+      isTerminal[i] = environments[i].IsTerminal(nextStates[i]);
+      returns[i] += rewards[i];
+      ++steps[i];
+
+      if (isTerminal[i] || (stepLimit != 0 && steps[i] >= stepLimit))
+      {
+        episodeReturns.push_back(returns[i]);
+        returns[i] = 0.0;
+        steps[i] = 0;
+        states[i] = environments[i].InitialSample();
+      }
+      else
+      {
+        states[i] = nextStates[i];
+      }
+    }
+  }
+
+  /**
+   * Get the current states of all copies as the columns of a matrix.
+   *
+   * @param encodedStates Set to the encoded state of each copy.
+   */
+  void EncodedStates(arma::mat& encodedStates) const
+  {
+    encodedStates.set_size(states[0].Encode().n_elem, states.size());
+    for (size_t i = 0; i < states.size(); ++i)
+      encodedStates.col(i) = states[i].Encode();
+  }
+
+  //! Get the number of copies.
+  size_t Copies() const { return environments.size(); }
+
+  //! Get the current state of each copy.
+  const std::vector<State>& States() const { return states; }
+
+  //! Get the returns of the episodes that ended in the last step.
+  const std::vector<double>& EpisodeReturns() const { return episodeReturns; }
+
+  //! Get the copies of the environment.
+  const std::vector<EnvironmentType>& Environments() const
+  {
+    return environments;
+  }
+  //! Modify the copies of the environment.
+  std::vector<EnvironmentType>& Environments() { return environments; }
+
+  //! Get the maximum number of steps of each episode (0 means no limit).
+  size_t StepLimit() const { return stepLimit; }
+  //! Modify the maximum number of steps of each episode (0 means no limit).
+  size_t& StepLimit() { return stepLimit; }
+
+ private:
+  //! The copies of the environment.
+  std::vector<EnvironmentType> environments;
+
+  //! The current state of each copy.
+  std::vector<State> states;
+
+  //! The return of the current episode of each copy, so far.
+  std::vector<double> returns;
+
+  //! The number of steps of the current episode of each copy, so far.
+  std::vector<size_t> steps;
+
+  //! The returns of the episodes that ended in the last step.
+  std::vector<double> episodeReturns;
+
+  //! Maximum number of steps of each episode (0 means no limit).
+  size_t stepLimit;
+};
+
+} // namespace mlpack
+
+#endif
@@ -16,8 +16,10 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/ann/ann.hpp>
 
+#include "environment/vector_environment.hpp"
 #include "replay/replay.hpp"
 #include "training_config.hpp"
+#include "categorical_projection.hpp"
 
 namespace mlpack {
 
@@ -109,6 +111,18 @@ class QLearning
    */
   double Episode();
 
+  /**
+   * Take one step in every copy of the environment held by `environments`.
+   * The actions of all copies are selected with one pass of all their states
+   * through the network, and the transitions are stored together; then the
+   * agent is trained as often as `Episode()` would have trained it for the
+   * same number of steps.  The returns of the episodes that ended in this step
+   * are then available in `environments.EpisodeReturns()`.
+   *
+   * @param environments The copies of the environment to step.
+   */
+  void Step(VectorEnvironment<EnvironmentType>& environments);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
@@ -180,6 +194,9 @@ class QLearning
 
   //! Locally-stored flag indicating training mode or test mode.
   bool deterministic;
+
+  //! Projection of the target distributions of categorical Q-Learning.
+  CategoricalProjection projection;
 };
 
 } // namespace mlpack
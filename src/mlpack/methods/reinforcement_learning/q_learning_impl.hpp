@@ -230,8 +230,6 @@ void QLearning<
       sampledNextStates, isTerminal);
 
   size_t atomSize = config.AtomSize();
-  arma::colvec support = arma::linspace<arma::colvec>(config.VMin(),
-      config.VMax(), atomSize);
 
   size_t batchSize = sampledNextStates.n_cols;
 
@@ -260,26 +258,10 @@ void QLearning<
         arma::size(atomSize, 1));
   }
 
-  arma::mat tZ = (ConvTo<arma::mat>::From(config.Discount() *
-      (support * (1 - isTerminal))).each_row() + sampledRewards);
-  tZ = arma::clamp(tZ, config.VMin(), config.VMax());
-  arma::mat b = (tZ - config.VMin()) / (config.VMax() - config.VMin()) *
-      (atomSize - 1);
-  arma::mat l = arma::floor(b);
-  arma::mat u = arma::ceil(b);
+  arma::mat projDist;
+  projection.Project(nextDist, sampledRewards, isTerminal, config.Discount(),
+      config.VMin(), config.VMax(), projDist);
 
-  arma::mat projDistUpper = nextDist % (u - b);
-  arma::mat projDistLower = nextDist % (b - l);
-
-  arma::mat projDist = arma::zeros<arma::mat>(arma::size(nextDist));
-  for (size_t batchNo = 0; batchNo < batchSize; batchNo++)
-  {
-    for (size_t j = 0; j < atomSize; j++)
-    {
-      projDist(l(j, batchNo), batchNo) += projDistUpper(j, batchNo);
-      projDist(u(j, batchNo), batchNo) += projDistLower(j, batchNo);
-    }
-  }
   arma::mat dists;
   learningNetwork.Forward(sampledStates, dists);
   arma::mat lossGradients = arma::zeros<arma::mat>(arma::size(dists));
@@ -385,6 +367,56 @@ double QLearning<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Step(VectorEnvironment<EnvironmentType>& environments)
+{
+  // Get the action values of all the copies with one pass.
+  arma::mat encodedStates, actionValues;
+  environments.EncodedStates(encodedStates);
+  learningNetwork.Predict(encodedStates, actionValues);
+
+  // Select an action for each copy according to the behavior policy.
+  std::vector<ActionType> actions(environments.Copies());
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    actions[i] = policy.Sample(actionValues.col(i), deterministic,
+        config.NoisyQLearning());
+  }
+
+  // Interact with all the environments, and store all the transitions.
+  const std::vector<StateType> states = environments.States();
+  std::vector<StateType> nextStates;
+  arma::rowvec rewards;
+  arma::irowvec isTerminal;
+  environments.Step(actions, nextStates, rewards, isTerminal);
+  replayMethod.StoreBatch(states, actions, rewards, nextStates, isTerminal,
+      config.Discount());
+
+  // Train once for each step, as Episode() does.
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    totalSteps++;
+    if (deterministic || totalSteps < config.ExplorationSteps())
+      continue;
+    if (config.IsCategorical())
+      TrainCategoricalAgent();
+    else
+      TrainAgent();
+  }
+}
+
 } // namespace mlpack
 
 #endif
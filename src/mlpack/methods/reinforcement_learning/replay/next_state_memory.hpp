@@ -0,0 +1,196 @@
+/**
+ * @file methods/reinforcement_learning/replay/next_state_memory.hpp
+ *
+ * Storage of the next states of the transitions of an experience replay.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_NEXT_STATE_MEMORY_HPP
+#define MLPACK_METHODS_RL_REPLAY_NEXT_STATE_MEMORY_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * NextStateMemory holds the encoded next states of the transitions of an
+ * experience replay, whose encoded states are stored in the columns of a
+ * matrix held by the replay itself (one column per transition, used as a ring
+ * buffer).
+ *
+ * The next state of a transition is usually the state of a transition that is
+ * stored shortly after it: the next transition of the same episode.  So,
+ * instead of keeping a second copy of each state, the next state of a
+ * transition is only kept here until a transition with the same state is
+ * stored; from then on, the next state is referred to by the index of that
+ * transition.  Next states that are never the state of another transition
+ * (such as terminal states) stay here until their transition is overwritten.
+ *
+ * Since the ring buffer overwrites transitions in the order they are stored, a
+ * transition is always overwritten before the transition holding its next
+ * state.
+ */
+class NextStateMemory
+{
+ public:
+  /**
+   * Create an empty memory, to be used with a replay of the given capacity.
+   *
+   * @param dimension The dimension of an encoded state.
+   * @param capacity The number of transitions of the replay.
+   * @param window The number of most recent transitions whose next state may
+   *     be the state of the next stored transition; for instance, the number
+   *     of steps of n-step transitions.
+   */
+  NextStateMemory(const size_t dimension = 0,
+                  const size_t capacity = 0,
+                  const size_t window = 1) :
+      dimension(dimension),
+      window(window),
+      stateIndices(capacity, (size_t) npos),
+      poolIndices(capacity, (size_t) npos)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Store the next state of the transition at the given position, whose state
+   * has just been stored in `states.col(position)`.
+   *
+   * @param states The encoded states of the transitions of the replay.
+   * @param position The position of the transition.
+   * @param nextState The encoded next state of the transition.
+   * @param isEnd Whether the next state is terminal.
+   */
+  void Store(const arma::mat& states,
+             const size_t position,
+             const arma::colvec& nextState,
+             const bool isEnd)
+  {
+    // The transition that was at this position before is overwritten.
+    Release(position);
+    stateIndices[position] = npos;
+
+    // The new state may be the next state of one of the recent transitions.
+    const double* state = states.colptr(position);
+    for (std::deque<size_t>::iterator it = pending.begin();
+        it != pending.end(); ++it)
+    {
+      const double* pendingState = pool.colptr(poolIndices[*it]);
+      if (std::equal(pendingState, pendingState + dimension, state))
+      {
+        stateIndices[*it] = position;
+        freeSlots.push_back(poolIndices[*it]);
+        poolIndices[*it] = npos;
+        pending.erase(it);
+        break;
+      }
+    }
+
+    if (freeSlots.empty())
+      Grow();
+
+    poolIndices[position] = freeSlots.back();
+    freeSlots.pop_back();
+    pool.col(poolIndices[position]) = nextState;
+
+    // A terminal state is never the state of another transition.
+    if (!isEnd)
+    {
+      pending.push_back(position);
+      if (pending.size() > window)
+        pending.pop_front();
+    }
+  }
+
+  /**
+   * Copy the next states of the given transitions into the columns of
+   * `sampledNextStates`, which is only reallocated if it does not already have
+   * the right size.
+   *
+   * @param states The encoded states of the transitions of the replay.
+   * @param indices The positions of the transitions.
+   * @param sampledNextStates Set to the encoded next states.
+   */
+  void Gather(const arma::mat& states,
+              const arma::uvec& indices,
+              arma::mat& sampledNextStates) const
+  {
+    sampledNextStates.set_size(dimension, indices.n_elem);
+    for (size_t i = 0; i < indices.n_elem; ++i)
+    {
+      const double* nextState = (stateIndices[indices[i]] != npos) ?
+          states.colptr(stateIndices[indices[i]]) :
+          pool.colptr(poolIndices[indices[i]]);
+      std::copy(nextState, nextState + dimension,
+          sampledNextStates.colptr(i));
+    }
+  }
+
+  //! Get the number of next states that are stored as copies.
+  size_t StoredNextStates() const
+  {
+    return pool.n_cols - freeSlots.size();
+  }
+
+  //! Get the number of recent transitions that may be linked to a new state.
+  size_t Window() const { return window; }
+  //! Modify the number of recent transitions that may be linked to a new
+  //! state.
+  size_t& Window() { return window; }
+
+ private:
+  //! Forget the next state of the transition at the given position.
+  void Release(const size_t position)
+  {
+    if (poolIndices[position] == npos)
+      return;
+
+    freeSlots.push_back(poolIndices[position]);
+    poolIndices[position] = npos;
+
+    std::deque<size_t>::iterator it = std::find(pending.begin(),
+        pending.end(), position);
+    if (it != pending.end())
+      pending.erase(it);
+  }
+
+  //! Make room for more next states in the pool.
+  void Grow()
+  {
+    const size_t oldSize = pool.n_cols;
+    const size_t newSize = std::max((size_t) 16, 2 * oldSize);
+    pool.resize(dimension, newSize);
+    for (size_t i = newSize; i > oldSize; --i)
+      freeSlots.push_back(i - 1);
+  }
+
+  //! Marks a transition without a linked state or a pool slot.
+  static constexpr size_t npos = (size_t) -1;
+
+  //! The dimension of an encoded state.
+  size_t dimension;
+
+  //! The number of recent transitions that may be linked to a new state.
+  size_t window;
+
+  //! For each transition, the transition whose state is its next state.
+  std::vector<size_t> stateIndices;
+
+  //! For each transition, the column of the pool holding its next state.
+  std::vector<size_t> poolIndices;
+
+  //! Encoded next states that are not linked to a state.
+  arma::mat pool;
+
+  //! Unused columns of the pool.
+  std::vector<size_t> freeSlots;
+
+  //! The recent non-terminal transitions that are not linked to a state yet.
+  std::deque<size_t> pending;
+};
+
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "sumtree.hpp"
+#include "next_state_memory.hpp"
 
 namespace mlpack {
 
@@ -22,6 +23,9 @@ namespace mlpack {
  * replay can replay important transitions more frequently by prioritizing
  * transitions, and make agent learn more efficiently.
  *
+ * As for RandomReplay, the next state of a transition is not stored again when
+ * it is the state of a later transition (see NextStateMemory).
+ *
  * @code
  * @article{schaul2015prioritized,
  *  title   = {Prioritized experience replay},
@@ -95,7 +99,7 @@ class PrioritizedReplay
       states(dimension, capacity),
       actions(capacity),
       rewards(capacity),
-      nextStates(dimension, capacity),
+      nextStates(dimension, capacity, nSteps),
       isTerminal(capacity)
   {
     size_t size = 1;
@@ -141,12 +145,10 @@ class PrioritizedReplay
     // Make a n-step transition.
     GetNStepInfo(reward, nextState, isEnd, discount);
 
-    state = nStepBuffer.front().state;
-    action = nStepBuffer.front().action;
-    states.col(position) = state.Encode();
-    actions[position] = action;
+    states.col(position) = nStepBuffer.front().state.Encode();
+    actions[position] = nStepBuffer.front().action;
     rewards(position) = reward;
-    nextStates.col(position) = nextState.Encode();
+    nextStates.Store(states, position, nextState.Encode(), isEnd);
     isTerminal(position) = isEnd;
 
     idxSum.Set(position, maxPriority * alpha);
@@ -159,6 +161,43 @@ class PrioritizedReplay
     }
   }
 
+  /**
+   * Store one experience of each of several environments that are stepped
+   * together (see VectorEnvironment).  The n-step transitions of each
+   * environment are only made from its own experiences.
+   *
+   * @param states The state of each environment.
+   * @param actions The action of each environment.
+   * @param rewards The reward of each environment.
+   * @param nextStates The next state of each environment.
+   * @param isEnd Whether the next state of each environment is terminal.
+   * @param discount The discount parameter.
+   */
+  void StoreBatch(const std::vector<StateType>& states,
+                  const std::vector<ActionType>& actions,
+                  const arma::rowvec& rewards,
+                  const std::vector<StateType>& nextStates,
+                  const arma::irowvec& isEnd,
+                  const double& discount)
+  {
+    // The next state of a transition of an environment is the state of a
+    // transition of the same environment stored nSteps batches later.
+    this->nextStates.Window() = std::max(this->nextStates.Window(),
+        nSteps * states.size());
+
+    // Each environment has its own n-step buffer.
+    if (batchNStepBuffers.size() < states.size())
+      batchNStepBuffers.resize(states.size());
+
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+      std::swap(nStepBuffer, batchNStepBuffers[i]);
+      Store(states[i], actions[i], rewards[i], nextStates[i], isEnd[i],
+          discount);
+      std::swap(nStepBuffer, batchNStepBuffers[i]);
+    }
+  }
+
   /**
    * Get the reward, next state and terminal boolean for nth step.
    *
@@ -196,19 +235,39 @@ class PrioritizedReplay
    */
   arma::ucolvec SampleProportional()
   {
-    arma::ucolvec idxes(batchSize);
-    double totalSum = idxSum.Sum(0, (full ? capacity : position));
-    double sumPerRange = totalSum / batchSize;
-    for (size_t bt = 0; bt < batchSize; bt++)
-    {
-      const double mass = arma::randu() * sumPerRange + bt * sumPerRange;
-      idxes(bt) = idxSum.FindPrefixSum(mass);
-    }
+    arma::ucolvec idxes;
+    SampleProportional(idxes);
     return idxes;
   }
 
   /**
-   * Sample some experience according to their priorities.
+   * Sample some experience according to their priorities, with one stratified
+   * query of the sum tree for the whole batch.
+   *
+   * @param idxes Set to the indices to be chosen.  It is only reallocated if
+   *     it does not already have `batchSize` elements.
+   */
+  void SampleProportional(arma::ucolvec& idxes)
+  {
+    const size_t upperBound = full ? capacity : position;
+    const double totalSum = idxSum.Sum(0, upperBound);
+    const double sumPerRange = totalSum / batchSize;
+    sampledMasses.set_size(batchSize);
+    for (size_t bt = 0; bt < batchSize; bt++)
+      sampledMasses[bt] = arma::randu() * sumPerRange + bt * sumPerRange;
+
+    idxSum.FindPrefixSums(sampledMasses, idxes);
+
+    // Rounding may push the last masses past the stored transitions.
+    for (size_t bt = 0; bt < batchSize; bt++)
+      idxes[bt] = std::min((size_t) idxes[bt], upperBound - 1);
+  }
+
+  /**
+   * Sample some experience according to their priorities.  The given objects
+   * are filled in place, and are only reallocated if they do not already have
+   * the size of a sample, so passing the same objects to each call does not
+   * allocate any memory.
    *
    * @param sampledStates Sampled encoded states.
    * @param sampledActions Sampled actions.
@@ -223,24 +282,31 @@ class PrioritizedReplay
               arma::mat& sampledNextStates,
               arma::irowvec& isTerminal)
   {
-    sampledIndices = SampleProportional();
+    SampleProportional(sampledIndices);
     BetaAnneal();
 
-    sampledStates = states.cols(sampledIndices);
-    for (size_t t = 0; t < sampledIndices.n_rows; t ++)
-      sampledActions.push_back(actions[sampledIndices[t]]);
-    sampledRewards = rewards.elem(sampledIndices).t();
-    sampledNextStates = nextStates.cols(sampledIndices);
-    isTerminal = this->isTerminal.elem(sampledIndices).t();
+    sampledStates.set_size(states.n_rows, batchSize);
+    sampledActions.resize(batchSize);
+    sampledRewards.set_size(batchSize);
+    isTerminal.set_size(batchSize);
+    for (size_t t = 0; t < batchSize; ++t)
+    {
+      const size_t index = sampledIndices[t];
+      std::copy(states.colptr(index), states.colptr(index) + states.n_rows,
+          sampledStates.colptr(t));
+      sampledActions[t] = actions[index];
+      sampledRewards[t] = rewards[index];
+      isTerminal[t] = this->isTerminal[index];
+    }
+    nextStates.Gather(states, sampledIndices, sampledNextStates);
 
     // Calculate the weights of sampled transitions.
-
-    size_t numSample = full ? capacity : position;
-    weights = arma::rowvec(sampledIndices.n_rows);
-
-    for (size_t i = 0; i < sampledIndices.n_rows; ++i)
+    const size_t numSample = full ? capacity : position;
+    const double totalSum = idxSum.Sum();
+    weights.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
     {
-      double p_sample = idxSum.Get(sampledIndices(i)) / idxSum.Sum();
+      double p_sample = idxSum.Get(sampledIndices(i)) / totalSum;
       weights(i) = std::pow(numSample * p_sample, -beta);
     }
     weights /= weights.max();
@@ -285,9 +351,9 @@ class PrioritizedReplay
    * @param nextActionValues Agent's next action.
    * @param gradients The model's gradients.
    */
-  void Update(arma::mat target,
-              std::vector<ActionType> sampledActions,
-              arma::mat nextActionValues,
+  void Update(const arma::mat& target,
+              const std::vector<ActionType>& sampledActions,
+              const arma::mat& nextActionValues,
               arma::mat& gradients)
   {
     arma::colvec tdError(target.n_cols);
@@ -306,6 +372,9 @@ class PrioritizedReplay
   //! Get the number of steps for n-step agent.
   const size_t& NSteps() const { return nSteps; }
 
+  //! Get the memory holding the next states of the stored transitions.
+  const NextStateMemory& NextStates() const { return nextStates; }
+
  private:
   //! Locally-stored number of examples of each sample.
   size_t batchSize;
@@ -341,6 +410,9 @@ class PrioritizedReplay
   //! Locally-stored the indices of sampled transitions.
   arma::ucolvec sampledIndices;
 
+  //! Locally-stored the masses of the last sample.
+  arma::vec sampledMasses;
+
   //! Locally-stored the weights of sampled transitions.
   arma::rowvec weights;
 
@@ -350,6 +422,9 @@ class PrioritizedReplay
   //! Locally-stored buffer containing n consecutive steps.
   std::deque<Transition> nStepBuffer;
 
+  //! Locally-stored n-step buffers of each environment, for StoreBatch().
+  std::vector<std::deque<Transition>> batchNStepBuffers;
+
   //! Locally-stored encoded previous states.
   arma::mat states;
 
@@ -360,7 +435,7 @@ class PrioritizedReplay
   arma::rowvec rewards;
 
   //! Locally-stored encoded previous next states.
-  arma::mat nextStates;
+  NextStateMemory nextStates;
 
   //! Locally-stored termination information of previous experience.
   arma::irowvec isTerminal;
@@ -15,6 +15,8 @@
 #include <mlpack/prereqs.hpp>
 #include <cassert>
 
+#include "next_state_memory.hpp"
+
 namespace mlpack {
 
 /**
@@ -26,6 +28,10 @@ namespace mlpack {
  * train the agent. Typically this would be a random sample and
  * the memory will be a First-In-First-Out buffer.
  *
+ * The next state of a transition is not stored again when it is the state of
+ * a later transition (see NextStateMemory), so that a memory of consecutive
+ * transitions takes about half the space.
+ *
  * For more information, see the following.
  *
  * @code
@@ -86,7 +92,7 @@ class RandomReplay
       states(dimension, capacity),
       actions(capacity),
       rewards(capacity),
-      nextStates(dimension, capacity),
+      nextStates(dimension, capacity, nSteps),
       isTerminal(capacity)
   { /* Nothing to do here. */ }
 
@@ -123,19 +129,54 @@ class RandomReplay
     // Make a n-step transition.
     GetNStepInfo(reward, nextState, isEnd, discount);
 
-    state = nStepBuffer.front().state;
-    action = nStepBuffer.front().action;
+    Insert(nStepBuffer.front().state, nStepBuffer.front().action, reward,
+        nextState, isEnd);
+  }
 
-    states.col(position) = state.Encode();
-    actions[position] = action;
-    rewards(position) = reward;
-    nextStates.col(position) = nextState.Encode();
-    isTerminal(position) = isEnd;
-    position++;
-    if (position == capacity)
+  /**
+   * Store one experience of each of several environments that are stepped
+   * together (see VectorEnvironment).  The n-step transitions of each
+   * environment are only made from its own experiences.
+   *
+   * @param states The state of each environment.
+   * @param actions The action of each environment.
+   * @param rewards The reward of each environment.
+   * @param nextStates The next state of each environment.
+   * @param isEnd Whether the next state of each environment is terminal.
+   * @param discount The discount parameter.
+   */
+  void StoreBatch(const std::vector<StateType>& states,
+                  const std::vector<ActionType>& actions,
+                  const arma::rowvec& rewards,
+                  const std::vector<StateType>& nextStates,
+                  const arma::irowvec& isEnd,
+                  const double& discount)
+  {
+    // The next state of a transition of an environment is the state of a
+    // transition of the same environment stored nSteps batches later.
+    this->nextStates.Window() = std::max(this->nextStates.Window(),
+        nSteps * states.size());
+
+    if (nSteps == 1)
     {
-      full = true;
-      position = 0;
+      // No n-step transitions are made, so the experiences can be written to
+      // the memory directly.
+      for (size_t i = 0; i < states.size(); ++i)
+        Insert(states[i], actions[i], rewards[i], nextStates[i], isEnd[i]);
+
+      return;
+    }
+
+    // Each environment has its own n-step buffer.
+    if (batchNStepBuffers.size() < states.size())
+      batchNStepBuffers.resize(states.size());
+
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+      std::swap(nStepBuffer, batchNStepBuffers[i]);
+      Store(states[i], actions[i], rewards[i], nextStates[i], isEnd[i],
+          discount);
+      std::swap(nStepBuffer, batchNStepBuffers[i]);
     }
   }
 
@@ -170,7 +211,9 @@ class RandomReplay
   }
 
   /**
-   * Sample some experiences.
+   * Sample some experiences.  The given objects are filled in place, and are
+   * only reallocated if they do not already have the size of a sample, so
+   * passing the same objects to each call does not allocate any memory.
    *
    * @param sampledStates Sampled encoded states.
    * @param sampledActions Sampled actions.
@@ -185,16 +228,25 @@ class RandomReplay
               arma::mat& sampledNextStates,
               arma::irowvec& isTerminal)
   {
-    size_t upperBound = full ? capacity : position;
-    arma::uvec sampledIndices = randi<arma::uvec>(
-        batchSize, arma::distr_param(0, upperBound - 1));
-
-    sampledStates = states.cols(sampledIndices);
-    for (size_t t = 0; t < sampledIndices.n_rows; t ++)
-      sampledActions.push_back(actions[sampledIndices[t]]);
-    sampledRewards = rewards.elem(sampledIndices).t();
-    sampledNextStates = nextStates.cols(sampledIndices);
-    isTerminal = this->isTerminal.elem(sampledIndices).t();
+    const size_t upperBound = full ? capacity : position;
+    sampledIndices.set_size(batchSize);
+    for (size_t t = 0; t < batchSize; ++t)
+      sampledIndices[t] = RandInt(upperBound);
+
+    sampledStates.set_size(states.n_rows, batchSize);
+    sampledActions.resize(batchSize);
+    sampledRewards.set_size(batchSize);
+    isTerminal.set_size(batchSize);
+    for (size_t t = 0; t < batchSize; ++t)
+    {
+      const size_t index = sampledIndices[t];
+      std::copy(states.colptr(index), states.colptr(index) + states.n_rows,
+          sampledStates.colptr(t));
+      sampledActions[t] = actions[index];
+      sampledRewards[t] = rewards[index];
+      isTerminal[t] = this->isTerminal[index];
+    }
+    nextStates.Gather(states, sampledIndices, sampledNextStates);
   }
 
   /**
@@ -215,9 +267,9 @@ class RandomReplay
    * @param * (nextActionValues) Agent's next action
    * @param * (gradients) The model's gradients
    */
-  void Update(arma::mat /* target */,
-              std::vector<ActionType> /* sampledActions */,
-              arma::mat /* nextActionValues */,
+  void Update(const arma::mat& /* target */,
+              const std::vector<ActionType>& /* sampledActions */,
+              const arma::mat& /* nextActionValues */,
               arma::mat& /* gradients */)
   {
     /* Do nothing for random replay. */
@@ -226,7 +278,32 @@ class RandomReplay
   //! Get the number of steps for n-step agent.
   const size_t& NSteps() const { return nSteps; }
 
+  //! Get the memory holding the next states of the stored transitions.
+  const NextStateMemory& NextStates() const { return nextStates; }
+
  private:
+  /**
+   * Write a transition to the memory, at the current position.
+   */
+  void Insert(const StateType& state,
+              const ActionType& action,
+              const double reward,
+              const StateType& nextState,
+              const bool isEnd)
+  {
+    states.col(position) = state.Encode();
+    actions[position] = action;
+    rewards(position) = reward;
+    nextStates.Store(states, position, nextState.Encode(), isEnd);
+    isTerminal(position) = isEnd;
+    position++;
+    if (position == capacity)
+    {
+      full = true;
+      position = 0;
+    }
+  }
+
   //! Locally-stored number of examples of each sample.
   size_t batchSize;
 
@@ -245,6 +322,9 @@ class RandomReplay
   //! Locally-stored buffer containing n consecutive steps.
   std::deque<Transition> nStepBuffer;
 
+  //! Locally-stored n-step buffers of each environment, for StoreBatch().
+  std::vector<std::deque<Transition>> batchNStepBuffers;
+
   //! Locally-stored encoded previous states.
   arma::mat states;
 
@@ -255,10 +335,13 @@ class RandomReplay
   arma::rowvec rewards;
 
   //! Locally-stored encoded previous next states.
-  arma::mat nextStates;
+  NextStateMemory nextStates;
 
   //! Locally-stored termination information of previous experience.
   arma::irowvec isTerminal;
+
+  //! Locally-stored indices of the last sample.
+  arma::uvec sampledIndices;
 };
 
 } // namespace mlpack
@@ -177,6 +177,42 @@ class SumTree
     return idx - capacity;
   }
 
+  /**
+   * Find the index of each of the given masses, as FindPrefixSum() does, but
+   * descend the tree one level at a time for all masses together.  When the
+   * masses are sorted (as for stratified sampling), neighbouring masses walk
+   * down neighbouring paths, so each level of the tree is read nearly
+   * sequentially.
+   *
+   * @param masses The masses to find; they are modified during the search.
+   * @param indices Set to the array index of each mass.  It is only
+   *     reallocated if it does not already have one element per mass.
+   */
+  void FindPrefixSums(arma::Col<T>& masses, arma::ucolvec& indices)
+  {
+    indices.ones(masses.n_elem);
+    for (size_t width = 1; width < capacity; width *= 2)
+    {
+      for (size_t i = 0; i < masses.n_elem; ++i)
+      {
+        const size_t idx = indices[i];
+        if (idx >= capacity)
+          continue;
+
+        if (element[2 * idx] > masses[i])
+        {
+          indices[i] = 2 * idx;
+        }
+        else
+        {
+          masses[i] -= element[2 * idx];
+          indices[i] = 2 * idx + 1;
+        }
+      }
+    }
+    indices -= capacity;
+  }
+
  private:
   //! The capacity of the data array.
   size_t capacity;
@@ -364,5 +364,219 @@ double SAC<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename QNetworkType,
+  typename PolicyNetworkType,
+  typename UpdaterType,
+  typename ReplayType
+>
+void SAC<
+  EnvironmentType,
+  QNetworkType,
+  PolicyNetworkType,
+  UpdaterType,
+  ReplayType
+>::Step(VectorEnvironment<EnvironmentType>& environments)
+{
+  // Get the actions of all the copies with one pass.
+  arma::mat encodedStates, outputActions;
+  environments.EncodedStates(encodedStates);
+  policyNetwork.Predict(encodedStates, outputActions);
+
+  // Explore with clipped Gaussian noise, as SelectAction() does.
+  if (!deterministic)
+  {
+    arma::mat noise;
+    noise.randn(outputActions.n_rows, outputActions.n_cols);
+    outputActions += arma::clamp(noise, -0.25, 0.25);
+  }
+
+  std::vector<ActionType> actions(environments.Copies());
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    actions[i].action = ConvTo<std::vector<double>>::From(
+        arma::colvec(outputActions.col(i)));
+  }
+
+  // Interact with all the environments, and store all the transitions.
+  const std::vector<StateType> states = environments.States();
+  std::vector<StateType> nextStates;
+  arma::rowvec rewards;
+  arma::irowvec isTerminal;
+  environments.Step(actions, nextStates, rewards, isTerminal);
+  replayMethod.StoreBatch(states, actions, rewards, nextStates, isTerminal,
+      config.Discount());
+
+  // Update as often as Episode() does for the same number of steps.
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    totalSteps++;
+    if (deterministic || totalSteps < config.ExplorationSteps())
+      continue;
+    for (size_t j = 0; j < config.UpdateInterval(); j++)
+      Update();
+  }
+}
+
+template <
+  typename EnvironmentType,
+  typename QNetworkType,
+  typename PolicyNetworkType,
+  typename UpdaterType,
+  typename ReplayType
+>
+double SAC<
+  EnvironmentType,
+  QNetworkType,
+  PolicyNetworkType,
+  UpdaterType,
+  ReplayType
+>::ParallelTrain(const size_t actors,
+                 const size_t steps,
+                 const size_t policyRefreshInterval)
+{
+  if (actors == 0 || policyRefreshInterval == 0)
+  {
+    throw std::invalid_argument("SAC::ParallelTrain(): the number of actors "
+        "and the policy refresh interval must be positive!");
+  }
+
+  if (replayMethod.NSteps() != 1)
+  {
+    throw std::invalid_argument("SAC::ParallelTrain(): only single-step "
+        "replay methods are supported!");
+  }
+
+  using TransitionType = typename ReplayType::Transition;
+
+  // Each actor has its own environment and policy network; the learner
+  // publishes its policy to them without any lock.
+  std::vector<EnvironmentType> actorEnvironments(actors, environment);
+  std::vector<PolicyNetworkType> actorPolicies(actors, policyNetwork);
+  TargetParameters<arma::mat> policyParameters(policyNetwork.Parameters());
+
+  // Transitions collected by each actor, not yet stored by the learner.
+  std::vector<std::vector<TransitionType>> collected(actors);
+  std::atomic<size_t> takenSteps(0);
+  std::atomic<size_t> finishedActors(0);
+  double totalReturn = 0.0;
+  size_t episodes = 0;
+
+  // The last iteration is the learner.  Since the actors never wait for the
+  // learner, this is also correct when fewer threads are available, and
+  // without OpenMP.
+  #pragma omp parallel for num_threads(actors + 1) schedule(static, 1)
+  for (size_t a = 0; a <= actors; ++a)
+  {
+    if (a < actors)
+    {
+      EnvironmentType& actorEnvironment = actorEnvironments[a];
+      PolicyNetworkType& actorPolicy = actorPolicies[a];
+      size_t policyVersion = 0;
+      StateType actorState = actorEnvironment.InitialSample();
+      size_t actorSteps = 0, episodeSteps = 0;
+      double episodeReturn = 0.0;
+
+      while (takenSteps++ < steps)
+      {
+        if (actorSteps++ % policyRefreshInterval == 0 &&
+            policyParameters.Version() != policyVersion)
+        {
+          policyVersion = policyParameters.Read(actorPolicy.Parameters());
+        }
+
+        // Explore with clipped Gaussian noise, as SelectAction() does.
+        arma::colvec outputAction, noise;
+        actorPolicy.Predict(actorState.Encode(), outputAction);
+        noise.randn(outputAction.n_rows);
+        outputAction += arma::clamp(noise, -0.25, 0.25);
+        ActionType actorAction;
+        actorAction.action = ConvTo<std::vector<double>>::From(outputAction);
+
+        StateType nextState;
+        const double reward = actorEnvironment.Sample(actorState, actorAction,
+            nextState);
+        const bool isEnd = actorEnvironment.IsTerminal(nextState);
+        episodeReturn += reward;
+        ++episodeSteps;
+
+        #pragma omp critical(rlActorLearnerTransitions)
+        {
+          collected[a].push_back(
+              { actorState, actorAction, reward, nextState, isEnd });
+        }
+
+        if (isEnd || (config.StepLimit() && episodeSteps >= config.StepLimit()))
+        {
+          #pragma omp critical(rlActorLearnerReturns)
+          {
+            totalReturn += episodeReturn;
+            ++episodes;
+          }
+
+          actorState = actorEnvironment.InitialSample();
+          episodeSteps = 0;
+          episodeReturn = 0.0;
+        }
+        else
+        {
+          actorState = nextState;
+        }
+      }
+
+      ++finishedActors;
+    }
+    else
+    {
+      // Episode() updates the agent config.UpdateInterval() times after each
+      // step once totalSteps reaches config.ExplorationSteps().
+      const size_t firstUpdateStep = std::max(totalSteps + 1,
+          config.ExplorationSteps());
+      size_t updates = 0;
+      std::vector<TransitionType> transitions;
+      while (true)
+      {
+        // Check this before taking the transitions, so that none is missed.
+        const bool actorsFinished = (finishedActors == actors);
+
+        #pragma omp critical(rlActorLearnerTransitions)
+        {
+          for (size_t i = 0; i < actors; ++i)
+          {
+            transitions.insert(transitions.end(), collected[i].begin(),
+                collected[i].end());
+            collected[i].clear();
+          }
+        }
+
+        for (size_t i = 0; i < transitions.size(); ++i)
+        {
+          replayMethod.Store(transitions[i].state, transitions[i].action,
+              transitions[i].reward, transitions[i].nextState,
+              transitions[i].isEnd, config.Discount());
+          ++totalSteps;
+        }
+        transitions.clear();
+
+        const size_t allowedUpdates = (totalSteps < firstUpdateStep) ? 0 :
+            config.UpdateInterval() * (totalSteps - firstUpdateStep + 1);
+        if (updates < allowedUpdates)
+        {
+          Update();
+          if (++updates % config.UpdateInterval() == 0)
+            policyParameters.Publish(policyNetwork.Parameters());
+        }
+        else if (actorsFinished)
+        {
+          break;
+        }
+      }
+    }
+  }
+
+  return (episodes == 0) ? 0.0 : totalReturn / episodes;
+}
+
 } // namespace mlpack
 #endif
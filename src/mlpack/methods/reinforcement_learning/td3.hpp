@@ -17,6 +17,8 @@
 #include <ensmallen.hpp>
 #include <mlpack/methods/ann/ann.hpp>
 
+#include "environment/vector_environment.hpp"
+#include "worker/target_parameters.hpp"
 #include "replay/replay.hpp"
 #include "training_config.hpp"
 
@@ -114,6 +116,42 @@ class TD3
    */
   double Episode();
 
+  /**
+   * Take one step in every copy of the environment held by `environments`.
+   * The actions of all copies are computed with one pass of all their states
+   * through the policy network, and the transitions are stored together; then
+   * the agent is updated as often as `Episode()` would have updated it for the
+   * same number of steps.  The returns of the episodes that ended in this step
+   * are then available in `environments.EpisodeReturns()`.
+   *
+   * @param environments The copies of the environment to step.
+   */
+  void Step(VectorEnvironment<EnvironmentType>& environments);
+
+  /**
+   * Train with an actor-learner split.  Each of `actors` threads steps its own
+   * copy of the environment with its own copy of the policy network, which it
+   * refreshes every `policyRefreshInterval` steps from the latest policy
+   * published by the learner; meanwhile, the calling thread stores the
+   * collected transitions in the replay method and keeps updating the
+   * networks.  In total, `steps` steps are taken, and the agent is updated as
+   * often as `Episode()` would have updated it for the same number of steps.
+   *
+   * The actors always explore, regardless of `Deterministic()`.  Only
+   * single-step replay methods are supported, since the transitions of the
+   * actors are interleaved.
+   *
+   * @param actors Number of actor threads.
+   * @param steps Number of steps to take in total.
+   * @param policyRefreshInterval Number of steps of an actor between two
+   *     refreshes of its policy network.
+   * @return The mean return of the episodes that the actors completed (0 if
+   *     none was completed).
+   */
+  double ParallelTrain(const size_t actors,
+                       const size_t steps,
+                       const size_t policyRefreshInterval = 100);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
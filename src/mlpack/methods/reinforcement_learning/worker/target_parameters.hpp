@@ -0,0 +1,93 @@
+/**
+ * @file methods/reinforcement_learning/worker/target_parameters.hpp
+ *
+ * Double-buffered parameters of the target network shared by async workers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_WORKER_TARGET_PARAMETERS_HPP
+#define MLPACK_METHODS_RL_WORKER_TARGET_PARAMETERS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+
+/**
+ * TargetParameters holds the parameters of the target network that the
+ * workers of asynchronous learning share, without any lock.
+ *
+ * The parameters are kept in two buffers: a new target network is written to
+ * the buffer that is not in use and then published by incrementing a version
+ * counter, so that the workers reading the previous version are not
+ * disturbed.  Each worker keeps its own copy of the target network and only
+ * reads the parameters again when the version changes.  Like the lock-free
+ * updates of the shared learning network, a worker may read a mix of two
+ * versions if two new versions are published while it is reading; with a
+ * reasonable target network sync interval this does not happen in practice,
+ * and it does not harm training.
+ *
+ * @tparam MatType The type of the parameters.
+ */
+template<typename MatType = arma::mat>
+class TargetParameters
+{
+ public:
+  /**
+   * Create the target parameters as a copy of the given parameters.
+   *
+   * @param parameters The initial parameters of the target network.
+   */
+  TargetParameters(const MatType& parameters = MatType()) : version(0)
+  {
+    buffers[0] = parameters;
+    buffers[1] = parameters;
+  }
+
+  /**
+   * Publish new parameters of the target network.  Only one thread should
+   * publish at any time; the workers make sure of that by publishing only
+   * when their increment of the shared step counter reaches a multiple of the
+   * sync interval.
+   *
+   * @param parameters The new parameters of the target network.
+   */
+  void Publish(const MatType& parameters)
+  {
+    const size_t next = version.load(std::memory_order_relaxed) + 1;
+    buffers[next % 2] = parameters;
+    version.store(next, std::memory_order_release);
+  }
+
+  //! Get the version of the latest published parameters.
+  size_t Version() const { return version.load(std::memory_order_acquire); }
+
+  /**
+   * Copy the latest published parameters.  If `parameters` already has the
+   * right size, it is overwritten in place, so that a network whose
+   * parameters are given keeps its layer aliases.
+   *
+   * @param parameters Set to the latest published parameters.
+   * @return The version of the copied parameters.
+   */
+  size_t Read(MatType& parameters) const
+  {
+    const size_t current = Version();
+    parameters = buffers[current % 2];
+    return current;
+  }
+
+ private:
+  //! The two buffers of parameters.
+  MatType buffers[2];
+
+  //! The number of times that new parameters were published.
+  std::atomic<size_t> version;
+};
+
+} // namespace mlpack
+
+#endif
@@ -15,5 +15,6 @@
 #include "one_step_q_learning_worker.hpp"
 #include "one_step_sarsa_worker.hpp"
 #include "n_step_q_learning_worker.hpp"
+#include "target_parameters.hpp"
 
 #endif
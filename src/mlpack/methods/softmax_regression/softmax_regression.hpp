@@ -294,6 +294,25 @@ class SoftmaxRegression
   void Classify(const MatType& dataset,
                 DenseMatType& probabilities) const;
 
+  /**
+   * Classify the given points, returning the k most probable classes of each
+   * point and their probabilities, in decreasing order of probability.  The
+   * points are classified in blocks, in parallel, so only the probabilities of
+   * a block of points are ever held; this is much faster and uses much less
+   * memory than computing all class probabilities when there are many classes.
+   *
+   * @param dataset Matrix of data points to be classified.
+   * @param k Number of classes to return for each point.
+   * @param topClasses Will hold the k most probable classes of each point
+   *     (k x n).
+   * @param topProbabilities Will hold the probabilities of these classes
+   *     (k x n).
+   */
+  void Classify(const MatType& dataset,
+                const size_t k,
+                arma::Mat<size_t>& topClasses,
+                DenseMatType& topProbabilities) const;
+
   /**
    * Computes accuracy of the learned model given the feature data and the
    * labels associated with each data point. Predictions are made using the
@@ -319,9 +338,9 @@ class SoftmaxRegression
   bool FitIntercept() const { return fitIntercept; }
 
   //! Get the model parameters.
-  MatType& Parameters() { return parameters; }
+  DenseMatType& Parameters() { return parameters; }
   //! Get the model parameters.
-  const MatType& Parameters() const { return parameters; }
+  const DenseMatType& Parameters() const { return parameters; }
 
   /**
    * Reset the weights in the model to small random values.  This function can
@@ -342,6 +361,18 @@ class SoftmaxRegression
   void serialize(Archive& ar, const uint32_t version);
 
  private:
+  /**
+   * Compute the class scores parameters * [1; x] (the log of the unnormalized
+   * class probabilities) of the points in [begin, end) of the dataset.
+   */
+  void Scores(const MatType& dataset,
+              const size_t begin,
+              const size_t end,
+              DenseMatType& scores) const;
+
+  //! Number of points that are classified at once.
+  static constexpr size_t BlockSize = 256;
+
   //! Parameters after optimization.
   DenseMatType parameters;
   //! Number of classes.
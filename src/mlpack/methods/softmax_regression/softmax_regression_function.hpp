@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/shuffle_data.hpp>
 
 namespace mlpack {
 
@@ -140,6 +141,18 @@ class SoftmaxRegressionFunction
   template<typename GradType>
   void Gradient(const DenseMatType& parameters, GradType& gradient) const;
 
+  /**
+   * Evaluate the objective function and its gradient with the given
+   * parameters, computing the class probabilities only once.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   * @return The value of the objective function.
+   */
+  template<typename GradType>
+  ElemType EvaluateWithGradient(const DenseMatType& parameters,
+                                GradType& gradient) const;
+
   /**
    * Evaluate the gradient of the objective function given the current set of
    * parameters, on a subset of the data. The function calculates the
@@ -157,6 +170,22 @@ class SoftmaxRegressionFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the objective function and its gradient on a subset of the data,
+   * computing the class probabilities only once.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param gradient Matrix to store gradient into.
+   * @param batchSize Number of data points to use.
+   * @return The value of the objective function on the given points.
+   */
+  template<typename GradType>
+  ElemType EvaluateWithGradient(const DenseMatType& parameters,
+                                const size_t start,
+                                GradType& gradient,
+                                const size_t batchSize = 1) const;
+
   /**
    * Evaluates the gradient values of the objective function given the current
    * set of parameters for a single feature indexed by j.
@@ -196,6 +225,38 @@ class SoftmaxRegressionFunction
   bool FitIntercept() const { return fitIntercept; }
 
  private:
+  /**
+   * Compute the log-probabilities of the classes of the given points, in a
+   * numerically stable way.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param logProbabilities Will hold the log-probabilities of each point.
+   * @param start Index of point to start at.
+   * @param batchSize Number of points to calculate log-probabilities for.
+   */
+  void GetLogProbabilitiesMatrix(const DenseMatType& parameters,
+                                 DenseMatType& logProbabilities,
+                                 const size_t start,
+                                 const size_t batchSize) const;
+
+  /**
+   * Compute the log-likelihood of the given points, and, if gradient is not
+   * NULL, the gradient of the negative log-likelihood (without normalization
+   * or regularization).  The points are split into chunks that are processed
+   * in parallel, and the sums of the chunks are added in order, so the result
+   * does not depend on the number of threads.  Only BlockSize points of class
+   * probabilities are held at a time by each chunk.
+   */
+  ElemType LogLikelihood(const DenseMatType& parameters,
+                         const size_t start,
+                         const size_t batchSize,
+                         DenseMatType* gradient) const;
+
+  //! Maximum number of chunks (each holds a gradient) of LogLikelihood().
+  static constexpr size_t MaxChunks = 16;
+  //! Number of points whose class probabilities are computed at once.
+  static constexpr size_t BlockSize = 256;
+
   //! Training data matrix.  This is an alias until the data is shuffled.
   MatType data;
   //! Label matrix for the provided data.
@@ -41,36 +41,21 @@ inline SoftmaxRegressionFunction<MatType>::SoftmaxRegressionFunction(
 template<typename MatType>
 inline void SoftmaxRegressionFunction<MatType>::Shuffle()
 {
-  // Determine new ordering.
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      data.n_cols - 1, data.n_cols));
-
-  // Re-sort data.
-  MatType newData = data.cols(ordering);
+  // Recover the labels from the ground truth matrix, so that the points and
+  // their labels can be shuffled together; this works for dense and sparse
+  // data.
+  arma::Row<size_t> labels(data.n_cols);
+  for (typename SpMatType::const_iterator it = groundTruth.begin();
+       it != groundTruth.end(); ++it)
+    labels[it.col()] = it.row();
+
+  MatType newData;
+  arma::Row<size_t> newLabels;
+  ShuffleData(data, labels, newData, newLabels);
   ClearAlias(data);
   data = std::move(newData);
 
-  // Assemble data for batch constructor.  We need reverse orderings though...
-  arma::uvec reverseOrdering(ordering.n_elem);
-  for (size_t i = 0; i < ordering.n_elem; ++i)
-    reverseOrdering[ordering[i]] = i;
-
-  arma::umat newLocations(2, groundTruth.n_nonzero);
-  arma::Col<ElemType> values(groundTruth.n_nonzero);
-  typename SpMatType::const_iterator it = groundTruth.begin();
-  size_t loc = 0;
-  while (it != groundTruth.end())
-  {
-    newLocations(0, loc) = it.row();
-    newLocations(1, loc) = reverseOrdering(it.col());
-    values(loc) = (*it);
-
-    ++it;
-    ++loc;
-  }
-
-  groundTruth = SpMatType(newLocations, values, groundTruth.n_rows,
-      groundTruth.n_cols);
+  GetGroundTruthMatrix(newLabels, groundTruth);
 }
 
 /**
@@ -164,27 +149,115 @@ inline void SoftmaxRegressionFunction<MatType>::GetProbabilitiesMatrix(
     const size_t start,
     const size_t batchSize) const
 {
-  DenseMatType hypothesis;
+  GetLogProbabilitiesMatrix(parameters, probabilities, start, batchSize);
+  probabilities = exp(probabilities);
+}
 
+template<typename MatType>
+inline void SoftmaxRegressionFunction<MatType>::GetLogProbabilitiesMatrix(
+    const typename SoftmaxRegressionFunction<MatType>::DenseMatType& parameters,
+    typename SoftmaxRegressionFunction<MatType>::DenseMatType&
+        logProbabilities,
+    const size_t start,
+    const size_t batchSize) const
+{
   if (fitIntercept)
   {
     // In order to add the intercept term, we should compute following matrix:
     //     [1; data] = join_cols(ones(1, data.n_cols), data)
-    //     hypothesis = exp(parameters * [1; data]).
+    //     hypothesis = parameters * [1; data].
     //
     // Since the cost of join may be high due to the copy of original data,
     // split the hypothesis computation to two components.
-    hypothesis = exp(
-        repmat(parameters.col(0), 1, batchSize) +
-        parameters.cols(1, parameters.n_cols - 1) *
-        data.cols(start, start + batchSize - 1));
+    logProbabilities = parameters.cols(1, parameters.n_cols - 1) *
+        data.cols(start, start + batchSize - 1);
+    logProbabilities.each_col() += parameters.col(0);
   }
   else
   {
-    hypothesis = exp(parameters * data.cols(start, start + batchSize - 1));
+    logProbabilities = parameters * data.cols(start, start + batchSize - 1);
+  }
+
+  // Subtract the log of the normalizer of each point; the largest score is
+  // subtracted first so that exp() cannot overflow.
+  for (size_t i = 0; i < logProbabilities.n_cols; ++i)
+  {
+    const ElemType maxScore = logProbabilities.col(i).max();
+    logProbabilities.col(i) -= maxScore +
+        std::log(arma::accu(exp(logProbabilities.col(i) - maxScore)));
+  }
+}
+
+template<typename MatType>
+inline
+typename SoftmaxRegressionFunction<MatType>::ElemType
+SoftmaxRegressionFunction<MatType>::LogLikelihood(
+    const typename SoftmaxRegressionFunction<MatType>::DenseMatType& parameters,
+    const size_t start,
+    const size_t batchSize,
+    typename SoftmaxRegressionFunction<MatType>::DenseMatType* gradient) const
+{
+  // Each chunk has at least BlockSize points.
+  size_t numChunks = (batchSize + BlockSize - 1) / BlockSize;
+  if (numChunks > MaxChunks)
+    numChunks = MaxChunks;
+  if (numChunks == 0)
+    numChunks = 1;
+  const size_t chunkSize = (batchSize + numChunks - 1) / numChunks;
+
+  arma::Col<ElemType> chunkLogLikelihoods(numChunks, arma::fill::zeros);
+  std::vector<DenseMatType> chunkGradients((gradient != NULL) ? numChunks : 0);
+
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    const size_t chunkBegin = start + std::min(c * chunkSize, batchSize);
+    const size_t chunkEnd = start + std::min((c + 1) * chunkSize, batchSize);
+    if (gradient != NULL)
+      chunkGradients[c].zeros(parameters.n_rows, parameters.n_cols);
+
+    DenseMatType logProbabilities, inner;
+    for (size_t b = chunkBegin; b < chunkEnd; b += BlockSize)
+    {
+      const size_t blockEnd = std::min(b + BlockSize, chunkEnd);
+
+      GetLogProbabilitiesMatrix(parameters, logProbabilities, b, blockEnd - b);
+      chunkLogLikelihoods[c] += arma::accu(groundTruth.cols(b, blockEnd - 1) %
+          logProbabilities);
+
+      if (gradient == NULL)
+        continue;
+
+      // The gradient of the negative log-likelihood of each point is
+      // (probabilities - groundTruth) * [1; x]^T.  Treat the intercept term
+      // parameters.col(0) seperately to avoid the cost of building [1; data].
+      inner = exp(logProbabilities) - groundTruth.cols(b, blockEnd - 1);
+      if (fitIntercept)
+      {
+        chunkGradients[c].col(0) += sum(inner, 1);
+        chunkGradients[c].cols(1, parameters.n_cols - 1) +=
+            inner * data.cols(b, blockEnd - 1).t();
+      }
+      else
+      {
+        chunkGradients[c] += inner * data.cols(b, blockEnd - 1).t();
+      }
+    }
+  }
+
+  // Merge the chunks in order.
+  ElemType logLikelihood = 0;
+  for (size_t c = 0; c < numChunks; ++c)
+    logLikelihood += chunkLogLikelihoods[c];
+
+  if (gradient != NULL)
+  {
+    *gradient = std::move(chunkGradients[0]);
+    for (size_t c = 1; c < numChunks; ++c)
+      *gradient += chunkGradients[c];
   }
 
-  probabilities = hypothesis / repmat(sum(hypothesis, 0), numClasses, 1);
+  return logLikelihood;
 }
 
 /**
@@ -206,29 +279,20 @@ SoftmaxRegressionFunction<MatType>::Evaluate(
   // 'm' is the number of training examples.
   // The cost also takes into account the regularization to control the
   // parameter weights.
-
-  // Calculate the class probabilities for each training example. The
-  // probabilities for each of the classes are given by:
+  //
+  // The class probabilities for each training example are given by:
   // p_j = exp(theta_j' * x_i) / sum(exp(theta_k' * x_i))
   // The sum is calculated over all the classes.
   // x_i is the input vector for a particular training example.
   // theta_j is the parameter vector associated with a particular class.
-  DenseMatType probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, 0, data.n_cols);
-
-  // Calculate the log likelihood and regularization terms.
-  ElemType logLikelihood, weightDecay, cost;
-
-  logLikelihood = arma::accu(groundTruth % log(probabilities)) /
-                  data.n_cols;
-  weightDecay = ((typename MatType::elem_type) 0.5) * lambda *
+  const ElemType logLikelihood = LogLikelihood(parameters, 0, data.n_cols,
+      NULL) / data.n_cols;
+  const ElemType weightDecay = ((ElemType) 0.5) * lambda *
       arma::accu(parameters % parameters);
 
   // The cost is the sum of the negative log likelihood and the regularization
   // terms.
-  cost = -logLikelihood + weightDecay;
-
-  return cost;
+  return -logLikelihood + weightDecay;
 }
 
 /**
@@ -242,15 +306,9 @@ SoftmaxRegressionFunction<MatType>::Evaluate(
     const size_t start,
     const size_t batchSize) const
 {
-  MatType probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, start, batchSize);
-
-  // Calculate the log likelihood and regularization terms.
-  ElemType logLikelihood, weightDecay;
-
-  logLikelihood = arma::accu(groundTruth.cols(start, start + batchSize - 1) %
-      log(probabilities)) / batchSize;
-  weightDecay = ((typename MatType::elem_type) 0.5) * lambda *
+  const ElemType logLikelihood = LogLikelihood(parameters, start, batchSize,
+      NULL) / batchSize;
+  const ElemType weightDecay = ((ElemType) 0.5) * lambda *
       norm(vectorise(parameters), 2);
 
   return -logLikelihood + weightDecay;
@@ -265,34 +323,7 @@ inline void SoftmaxRegressionFunction<MatType>::Gradient(
     const typename SoftmaxRegressionFunction<MatType>::DenseMatType& parameters,
     GradType& gradient) const
 {
-  // Calculate the class probabilities for each training example. The
-  // probabilities for each of the classes are given by:
-  // p_j = exp(theta_j' * x_i) / sum(exp(theta_k' * x_i))
-  // The sum is calculated over all the classes.
-  // x_i is the input vector for a particular training example.
-  // theta_j is the parameter vector associated with a particular class.
-  DenseMatType probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, 0, data.n_cols);
-
-  // Calculate the parameter gradients.
-  gradient.set_size(parameters.n_rows, parameters.n_cols);
-  if (fitIntercept)
-  {
-    // Treating the intercept term parameters.col(0) seperately to avoid
-    // the cost of building matrix [1; data].
-    DenseMatType inner = probabilities - groundTruth;
-    gradient.col(0) =
-        inner * arma::ones<DenseMatType>(data.n_cols, 1) / data.n_cols +
-        lambda * parameters.col(0);
-    gradient.cols(1, parameters.n_cols - 1) =
-        inner * data.t() / data.n_cols +
-        lambda * parameters.cols(1, parameters.n_cols - 1);
-  }
-  else
-  {
-    gradient = (probabilities - groundTruth) * data.t() / data.n_cols +
-               lambda * parameters;
-  }
+  EvaluateWithGradient(parameters, gradient);
 }
 
 template<typename MatType>
@@ -303,28 +334,43 @@ inline void SoftmaxRegressionFunction<MatType>::Gradient(
     GradType& gradient,
     const size_t batchSize) const
 {
-  DenseMatType probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, start, batchSize);
+  EvaluateWithGradient(parameters, start, gradient, batchSize);
+}
 
-  // Calculate the parameter gradients.
-  gradient.set_size(parameters.n_rows, parameters.n_cols);
-  if (fitIntercept)
-  {
-    DenseMatType inner = probabilities - groundTruth.cols(start, start +
-        batchSize - 1);
-    gradient.col(0) =
-        inner * arma::ones<DenseMatType>(batchSize, 1) / batchSize +
-        lambda * parameters.col(0);
-    gradient.cols(1, parameters.n_cols - 1) =
-        inner * data.cols(start, start + batchSize - 1).t() / batchSize +
-        lambda * parameters.cols(1, parameters.n_cols - 1);
-  }
-  else
-  {
-    gradient = (probabilities - groundTruth.cols(start, start + batchSize - 1))
-        * data.cols(start, start + batchSize - 1).t() / batchSize
-        + lambda * parameters;
-  }
+template<typename MatType>
+template<typename GradType>
+inline
+typename SoftmaxRegressionFunction<MatType>::ElemType
+SoftmaxRegressionFunction<MatType>::EvaluateWithGradient(
+    const typename SoftmaxRegressionFunction<MatType>::DenseMatType& parameters,
+    GradType& gradient) const
+{
+  DenseMatType logLikelihoodGradient;
+  const ElemType logLikelihood = LogLikelihood(parameters, 0, data.n_cols,
+      &logLikelihoodGradient) / data.n_cols;
+
+  gradient = logLikelihoodGradient / data.n_cols + lambda * parameters;
+  return -logLikelihood + ((ElemType) 0.5) * lambda *
+      arma::accu(parameters % parameters);
+}
+
+template<typename MatType>
+template<typename GradType>
+inline
+typename SoftmaxRegressionFunction<MatType>::ElemType
+SoftmaxRegressionFunction<MatType>::EvaluateWithGradient(
+    const typename SoftmaxRegressionFunction<MatType>::DenseMatType& parameters,
+    const size_t start,
+    GradType& gradient,
+    const size_t batchSize) const
+{
+  DenseMatType logLikelihoodGradient;
+  const ElemType logLikelihood = LogLikelihood(parameters, start, batchSize,
+      &logLikelihoodGradient) / batchSize;
+
+  gradient = logLikelihoodGradient / batchSize + lambda * parameters;
+  return -logLikelihood + ((ElemType) 0.5) * lambda *
+      norm(vectorise(parameters), 2);
 }
 
 template<typename MatType>
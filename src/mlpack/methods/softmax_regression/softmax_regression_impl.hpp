@@ -145,8 +145,10 @@ inline void SoftmaxRegression<MatType>::Classify(const MatType& dataset,
                                                  arma::Row<size_t>& labels)
     const
 {
-  MatType probabilities;
-  Classify(dataset, labels, probabilities);
+  arma::Mat<size_t> topClasses;
+  DenseMatType topProbabilities;
+  Classify(dataset, 1, topClasses, topProbabilities);
+  labels = topClasses;
 }
 
 template<typename MatType>
@@ -179,47 +181,88 @@ inline void SoftmaxRegression<MatType>::Classify(
   util::CheckSameDimensionality(dataset, FeatureSize(),
       "SoftmaxRegression::Classify()");
 
-  // Calculate the probabilities for each test input.
-  DenseMatType hypothesis;
-  if (fitIntercept)
+  labels.set_size(dataset.n_cols);
+  probabilities.set_size(numClasses, dataset.n_cols);
+
+  const size_t numBlocks = (dataset.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t block = 0; block < numBlocks; ++block)
   {
-    // In order to add the intercept term, we should compute following matrix:
-    //     [1; data] = join_cols(ones(1, data.n_cols), data)
-    //     hypothesis = exp(parameters * [1; data]).
-    //
-    // Since the cost of join maybe high due to the copy of original data,
-    // split the hypothesis computation to two components.
-    hypothesis = exp(
-      repmat(parameters.col(0), 1, dataset.n_cols) +
-      parameters.cols(1, parameters.n_cols - 1) * dataset);
+    const size_t begin = block * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) dataset.n_cols);
+
+    DenseMatType scores;
+    Scores(dataset, begin, end, scores);
+    for (size_t i = 0; i < scores.n_cols; ++i)
+    {
+      // The most probable class has the highest score; the highest score is
+      // subtracted before exp() so that it cannot overflow.
+      labels[begin + i] = scores.col(i).index_max();
+      scores.col(i) = exp(scores.col(i) - scores(labels[begin + i], i));
+      scores.col(i) /= arma::accu(scores.col(i));
+    }
+
+    probabilities.cols(begin, end - 1) = scores;
   }
-  else
+}
+
+template<typename MatType>
+inline void SoftmaxRegression<MatType>::Classify(
+    const MatType& dataset,
+    const size_t k,
+    arma::Mat<size_t>& topClasses,
+    typename SoftmaxRegression<MatType>::DenseMatType& topProbabilities) const
+{
+  util::CheckSameDimensionality(dataset, FeatureSize(),
+      "SoftmaxRegression::Classify()");
+
+  if (k == 0 || k > numClasses)
   {
-    hypothesis = exp(parameters * dataset);
+    std::ostringstream oss;
+    oss << "SoftmaxRegression::Classify(): k must be between 1 and the number "
+        << "of classes (" << numClasses << "), but " << k << " was given!";
+    throw std::invalid_argument(oss.str());
   }
 
-  probabilities = hypothesis / repmat(sum(hypothesis, 0), numClasses, 1);
-
-  // Prepare necessary data.
-  labels.zeros(dataset.n_cols);
-  double maxProbability = 0;
+  topClasses.set_size(k, dataset.n_cols);
+  topProbabilities.set_size(k, dataset.n_cols);
 
-  // For each test input.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  const size_t numBlocks = (dataset.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t block = 0; block < numBlocks; ++block)
   {
-    // For each class.
-    for (size_t j = 0; j < numClasses; ++j)
+    const size_t begin = block * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) dataset.n_cols);
+
+    DenseMatType scores;
+    Scores(dataset, begin, end, scores);
+
+    std::vector<size_t> order(numClasses);
+    for (size_t i = 0; i < scores.n_cols; ++i)
     {
-      // If a higher class probability is encountered, change prediction.
-      if (probabilities(j, i) > maxProbability)
+      // Only the k highest scores are sorted; ties go to the lowest class.
+      const ElemType* s = scores.colptr(i);
+      std::iota(order.begin(), order.end(), 0);
+      std::partial_sort(order.begin(), order.begin() + k, order.end(),
+          [s](const size_t a, const size_t b)
+          {
+            return (s[a] > s[b]) || (s[a] == s[b] && a < b);
+          });
+
+      // The normalizer of the softmax is computed relative to the highest
+      // score, so that exp() cannot overflow.
+      const ElemType maxScore = s[order[0]];
+      ElemType normalizer = 0;
+      for (size_t j = 0; j < numClasses; ++j)
+        normalizer += std::exp(s[j] - maxScore);
+
+      for (size_t j = 0; j < k; ++j)
       {
-        maxProbability = probabilities(j, i);
-        labels(i) = j;
+        topClasses(j, begin + i) = order[j];
+        topProbabilities(j, begin + i) = std::exp(s[order[j]] - maxScore) /
+            normalizer;
       }
     }
-
-    // Set maximum probability to zero for the next input.
-    maxProbability = 0;
   }
 }
 
@@ -252,6 +295,31 @@ inline double SoftmaxRegression<MatType>::ComputeAccuracy(
   return (count * 100.0) / predictions.n_elem;
 }
 
+template<typename MatType>
+inline void SoftmaxRegression<MatType>::Scores(
+    const MatType& dataset,
+    const size_t begin,
+    const size_t end,
+    typename SoftmaxRegression<MatType>::DenseMatType& scores) const
+{
+  if (fitIntercept)
+  {
+    // In order to add the intercept term, we should compute following matrix:
+    //     [1; data] = join_cols(ones(1, data.n_cols), data)
+    //     scores = parameters * [1; data].
+    //
+    // Since the cost of join maybe high due to the copy of original data,
+    // split the computation to two components.
+    scores = parameters.cols(1, parameters.n_cols - 1) *
+        dataset.cols(begin, end - 1);
+    scores.each_col() += parameters.col(0);
+  }
+  else
+  {
+    scores = parameters * dataset.cols(begin, end - 1);
+  }
+}
+
 template<typename MatType>
 void SoftmaxRegression<MatType>::Reset()
 {
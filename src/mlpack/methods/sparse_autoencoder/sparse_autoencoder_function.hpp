@@ -14,6 +14,8 @@
 #define MLPACK_METHODS_SPARSE_AUTOENCODER_SPARSE_AUTOENCODER_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/shuffle_data.hpp>
 
 namespace mlpack {
 
@@ -21,10 +23,23 @@ namespace mlpack {
  * This is a class for the sparse autoencoder objective function. It can be used
  * to create learning models like self-taught learning, stacked autoencoders,
  * conditional random fields (CRFs), and so forth.
+ *
+ * The data can be dense or sparse (e.g. `arma::sp_mat`), and single or double
+ * precision; the parameters are stored in a dense matrix of the same element
+ * type.  The function is separable, so it can be used with the SGD-family
+ * optimizers of ensmallen as well as with L-BFGS; the KL divergence term of a
+ * mini-batch is computed from the average activations of the points of the
+ * mini-batch.
+ *
+ * @tparam MatType Type of the data matrix.
  */
-class SparseAutoencoderFunction
+template<typename MatType = arma::mat>
+class SparseAutoencoderFunctionType
 {
  public:
+  typedef typename MatType::elem_type ElemType;
+  typedef typename GetDenseMatType<MatType>::type DenseMatType;
+
   /**
    * Construct the sparse autoencoder objective function with the given
    * parameters.
@@ -36,15 +51,21 @@ class SparseAutoencoderFunction
    * @param beta KL divergence parameter.
    * @param rho Sparsity parameter.
    */
-  SparseAutoencoderFunction(const arma::mat& data,
-                            const size_t visibleSize,
-                            const size_t hiddenSize,
-                            const double lambda = 0.0001,
-                            const double beta = 3,
-                            const double rho = 0.01);
+  SparseAutoencoderFunctionType(const MatType& data,
+                                const size_t visibleSize,
+                                const size_t hiddenSize,
+                                const double lambda = 0.0001,
+                                const double beta = 3,
+                                const double rho = 0.01);
 
   //! Initializes the parameters of the model to suitable values.
-  const arma::mat InitializeWeights();
+  const DenseMatType InitializeWeights();
+
+  //! Shuffle the points of the dataset.
+  void Shuffle();
+
+  //! Return the number of points in the dataset.
+  size_t NumFunctions() const { return data.n_cols; }
 
   /**
    * Evaluates the objective function of the sparse autoencoder model using the
@@ -56,7 +77,21 @@ class SparseAutoencoderFunction
    *
    * @param parameters Current values of the model parameters.
    */
-  double Evaluate(const arma::mat& parameters) const;
+  ElemType Evaluate(const DenseMatType& parameters) const;
+
+  /**
+   * Evaluate the objective function on the mini-batch of points
+   * [begin, begin + batchSize).  The reconstruction error is averaged over the
+   * points of the mini-batch, and the KL divergence term uses their average
+   * hidden layer activations.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the mini-batch.
+   * @param batchSize Number of points in the mini-batch.
+   */
+  ElemType Evaluate(const DenseMatType& parameters,
+                    const size_t begin,
+                    const size_t batchSize) const;
 
   /**
    * Evaluates the gradient values of the objective function given the current
@@ -67,7 +102,47 @@ class SparseAutoencoderFunction
    * @param parameters Current values of the model parameters.
    * @param gradient Matrix where gradient values will be stored.
    */
-  void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
+  void Gradient(const DenseMatType& parameters, DenseMatType& gradient) const;
+
+  /**
+   * Evaluate the gradient of the objective function on the mini-batch of
+   * points [begin, begin + batchSize).
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the mini-batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the mini-batch.
+   */
+  void Gradient(const DenseMatType& parameters,
+                const size_t begin,
+                DenseMatType& gradient,
+                const size_t batchSize) const;
+
+  /**
+   * Evaluate the objective function and its gradient with a single feedforward
+   * pass, which costs about half as much as calling Evaluate() and Gradient().
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   * @return The objective function.
+   */
+  ElemType EvaluateWithGradient(const DenseMatType& parameters,
+                                DenseMatType& gradient) const;
+
+  /**
+   * Evaluate the objective function and its gradient on the mini-batch of
+   * points [begin, begin + batchSize), with a single feedforward pass.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the mini-batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the mini-batch.
+   * @return The objective function on the mini-batch.
+   */
+  ElemType EvaluateWithGradient(const DenseMatType& parameters,
+                                const size_t begin,
+                                DenseMatType& gradient,
+                                const size_t batchSize) const;
 
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
@@ -76,13 +151,13 @@ class SparseAutoencoderFunction
    * @param x Matrix of real values for which we require the sigmoid activation.
    * @param output Output matrix.
    */
-  void Sigmoid(const arma::mat& x, arma::mat& output) const
+  void Sigmoid(const DenseMatType& x, DenseMatType& output) const
   {
     output = (1.0 / (1 + exp(-x)));
   }
 
   //! Return the initial point for the optimization.
-  const arma::mat& GetInitialPoint() const { return initialPoint; }
+  const DenseMatType& GetInitialPoint() const { return initialPoint; }
 
   //! Sets size of the visible layer.
   void VisibleSize(const size_t visible)
@@ -145,10 +220,27 @@ class SparseAutoencoderFunction
   }
 
  private:
-  //! The matrix of data points.
-  const arma::mat& data;
+  /**
+   * Compute the objective function on the points [begin, begin + batchSize),
+   * and its gradient if `gradient` is not NULL, with one feedforward pass.  The
+   * points are split into at most MaxChunks chunks that are processed in
+   * parallel, and whose results are summed in order, so the result does not
+   * depend on the number of threads.
+   */
+  ElemType Objective(const DenseMatType& parameters,
+                     const size_t begin,
+                     const size_t batchSize,
+                     DenseMatType* gradient) const;
+
+  //! Minimum number of points of each chunk of Objective().
+  static constexpr size_t BlockSize = 256;
+  //! Maximum number of chunks of Objective().
+  static constexpr size_t MaxChunks = 16;
+
+  //! The matrix of data points (an alias of the given data if possible).
+  MatType data;
   //! Initial parameter vector.
-  arma::mat initialPoint;
+  DenseMatType initialPoint;
   //! Size of the visible layer.
   size_t visibleSize;
   //! Size of the hidden layer.
@@ -161,6 +253,9 @@ class SparseAutoencoderFunction
   double rho;
 };
 
+// Convenience typedef for double-precision dense data.
+using SparseAutoencoderFunction = SparseAutoencoderFunctionType<arma::mat>;
+
 } // namespace mlpack
 
 // Include implementation.
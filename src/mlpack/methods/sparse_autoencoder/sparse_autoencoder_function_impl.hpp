@@ -16,14 +16,15 @@
 
 namespace mlpack {
 
-inline SparseAutoencoderFunction::SparseAutoencoderFunction(
-    const arma::mat& data,
+template<typename MatType>
+inline SparseAutoencoderFunctionType<MatType>::SparseAutoencoderFunctionType(
+    const MatType& data,
     const size_t visibleSize,
     const size_t hiddenSize,
     const double lambda,
     const double beta,
     const double rho) :
-    data(data),
+    data(MakeAlias(const_cast<MatType&>(data), false)),
     visibleSize(visibleSize),
     hiddenSize(hiddenSize),
     lambda(lambda),
@@ -39,7 +40,9 @@ inline SparseAutoencoderFunction::SparseAutoencoderFunction(
   * [-r, r] where 'r' is decided using the sizes of the visible and hidden
   * layers. The biases b1, b2 are initialized to 0.
   */
-inline const arma::mat SparseAutoencoderFunction::InitializeWeights()
+template<typename MatType>
+inline const typename SparseAutoencoderFunctionType<MatType>::DenseMatType
+SparseAutoencoderFunctionType<MatType>::InitializeWeights()
 {
   // The module uses a matrix to store the parameters, its structure looks like:
   //          vSize   1
@@ -57,14 +60,15 @@ inline const arma::mat SparseAutoencoderFunction::InitializeWeights()
 
   // Initialize w1 and w2 to random values in the range [0, 1], then set b1 and
   // b2 to 0.
-  arma::mat parameters;
+  DenseMatType parameters;
   parameters.randu(2 * hiddenSize + 1, visibleSize + 1);
   parameters.row(2 * hiddenSize).zeros();
   parameters.col(visibleSize).zeros();
 
   // Decide the parameter 'r' depending on the size of the visible and hidden
   // layers. The formula used is r = sqrt(6) / sqrt(vSize + hSize + 1).
-  const double range = std::sqrt(6) / std::sqrt(visibleSize + hiddenSize + 1);
+  const ElemType range = std::sqrt(6) /
+      std::sqrt(visibleSize + hiddenSize + 1);
 
   // Shift range of w1 and w2 values from [0, 1] to [-r, r].
   parameters.submat(0, 0, 2 * hiddenSize - 1, visibleSize - 1) = 2 * range *
@@ -73,10 +77,87 @@ inline const arma::mat SparseAutoencoderFunction::InitializeWeights()
   return parameters;
 }
 
+/**
+ * Shuffle the points of the dataset.
+ */
+template<typename MatType>
+inline void SparseAutoencoderFunctionType<MatType>::Shuffle()
+{
+  // The points have no labels; ShuffleData() handles dense and sparse data.
+  const arma::Row<size_t> labels(data.n_cols, arma::fill::zeros);
+  MatType newData;
+  arma::Row<size_t> newLabels;
+  ShuffleData(data, labels, newData, newLabels);
+  ClearAlias(data);
+  data = std::move(newData);
+}
+
 /** Evaluates the objective function given the parameters.
   */
-inline double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters)
-    const
+template<typename MatType>
+inline typename MatType::elem_type
+SparseAutoencoderFunctionType<MatType>::Evaluate(
+    const DenseMatType& parameters) const
+{
+  return Objective(parameters, 0, data.n_cols, NULL);
+}
+
+template<typename MatType>
+inline typename MatType::elem_type
+SparseAutoencoderFunctionType<MatType>::Evaluate(
+    const DenseMatType& parameters,
+    const size_t begin,
+    const size_t batchSize) const
+{
+  return Objective(parameters, begin, batchSize, NULL);
+}
+
+/** Calculates and stores the gradient values given a set of parameters.
+  */
+template<typename MatType>
+inline void SparseAutoencoderFunctionType<MatType>::Gradient(
+    const DenseMatType& parameters,
+    DenseMatType& gradient) const
+{
+  Objective(parameters, 0, data.n_cols, &gradient);
+}
+
+template<typename MatType>
+inline void SparseAutoencoderFunctionType<MatType>::Gradient(
+    const DenseMatType& parameters,
+    const size_t begin,
+    DenseMatType& gradient,
+    const size_t batchSize) const
+{
+  Objective(parameters, begin, batchSize, &gradient);
+}
+
+template<typename MatType>
+inline typename MatType::elem_type
+SparseAutoencoderFunctionType<MatType>::EvaluateWithGradient(
+    const DenseMatType& parameters,
+    DenseMatType& gradient) const
+{
+  return Objective(parameters, 0, data.n_cols, &gradient);
+}
+
+template<typename MatType>
+inline typename MatType::elem_type
+SparseAutoencoderFunctionType<MatType>::EvaluateWithGradient(
+    const DenseMatType& parameters,
+    const size_t begin,
+    DenseMatType& gradient,
+    const size_t batchSize) const
+{
+  return Objective(parameters, begin, batchSize, &gradient);
+}
+
+template<typename MatType>
+typename MatType::elem_type SparseAutoencoderFunctionType<MatType>::Objective(
+    const DenseMatType& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    DenseMatType* gradient) const
 {
   // The objective function is the average squared reconstruction error of the
   // network. w1 and b1 are the weights and biases associated with the hidden
@@ -91,39 +172,69 @@ inline double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters)
   const size_t l2 = visibleSize;
   const size_t l3 = 2 * hiddenSize;
 
-  // w1, w2, b1 and b2 are not extracted separately, 'parameters' is directly
-  // used in their place to avoid copying data. The following representations
-  // are used:
-  // w1 <- parameters.submat(0, 0, l1-1, l2-1)
-  // w2 <- parameters.submat(l1, 0, l3-1, l2-1).t()
-  // b1 <- parameters.submat(0, l2, l1-1, l2)
-  // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
-
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
-
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
+  // The weights are extracted once, so that the chunks below do not have to
+  // extract them again. w2 is stored transposed, like in 'parameters'.
+  const DenseMatType w1 = parameters.submat(0, 0, l1 - 1, l2 - 1);
+  const DenseMatType w2t = parameters.submat(l1, 0, l3 - 1, l2 - 1);
+  const DenseMatType b1 = parameters.submat(0, l2, l1 - 1, l2);
+  const DenseMatType b2 = parameters.submat(l3, 0, l3, l2 - 1).t();
+
+  size_t numChunks = (batchSize + BlockSize - 1) / BlockSize;
+  if (numChunks > MaxChunks)
+    numChunks = MaxChunks;
+  if (numChunks == 0)
+    numChunks = 1;
+  const size_t chunkSize = (batchSize + numChunks - 1) / numChunks;
+
+  // Compute the activations of the hidden and output layers of each chunk, its
+  // squared reconstruction error and the sums of its hidden layer activations.
+  // The hidden layer activations and the output layer deltas are kept for the
+  // backpropagation.
+  DenseMatType hiddenLayer(l1, batchSize), delOut;
+  if (gradient)
+    delOut.set_size(l2, batchSize);
+  DenseMatType hiddenSums(l1, numChunks);
+  arma::Col<ElemType> chunkErrors(numChunks);
+
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    const size_t chunkBegin = std::min(c * chunkSize, batchSize);
+    const size_t chunkEnd = std::min((c + 1) * chunkSize, batchSize);
+    if (chunkBegin == chunkEnd)
+    {
+      hiddenSums.col(c).zeros();
+      chunkErrors[c] = 0;
+      continue;
+    }
+
+    const MatType points = data.cols(begin + chunkBegin, begin + chunkEnd - 1);
+
+    DenseMatType hidden = w1 * points;
+    hidden.each_col() += b1;
+    Sigmoid(hidden, hidden);
+
+    DenseMatType output = w2t.t() * hidden;
+    output.each_col() += b2;
+    Sigmoid(output, output);
+
+    // Difference between the reconstructed data and the original data.
+    const DenseMatType diff = output - points;
+
+    chunkErrors[c] = accu(diff % diff);
+    hiddenSums.col(c) = sum(hidden, 1);
+    hiddenLayer.cols(chunkBegin, chunkEnd - 1) = hidden;
+
+    // The delta vector for the output layer is given by diff * f'(z), where z
+    // is the preactivation and f is the activation function. The derivative of
+    // the sigmoid function turns out to be f(z) * (1 - f(z)).
+    if (gradient)
+      delOut.cols(chunkBegin, chunkEnd - 1) = diff % output % (1 - output);
+  }
 
   // Average activations of the hidden layer.
-  rhoCap = sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  double wL2SquaredNorm;
-
-  // Calculate squared L2-norms of w1 and w2.
-  wL2SquaredNorm = accu(parameters.submat(0, 0, l3 - 1, l2 - 1) %
-      parameters.submat(0, 0, l3 - 1, l2 - 1));
-
-  double sumOfSquaresError, weightDecay, klDivergence, cost;
+  const DenseMatType rhoCap = sum(hiddenSums, 1) / batchSize;
+  const ElemType r = (ElemType) rho;
 
   // Calculate the reconstruction error, the regularization cost and the KL
   // divergence cost terms. 'sumOfSquaresError' is the average squared l2-norm
@@ -131,85 +242,73 @@ inline double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters)
   // of the weights w1 and w2. 'klDivergence' is the cost of the hidden layer
   // activations not being low. It is given by the following formula:
   // KL = sum_over_hSize(rho*log(rho/rhoCaq) + (1-rho)*log((1-rho)/(1-rhoCap)))
-  sumOfSquaresError = 0.5 * accu(diff % diff) / data.n_cols;
-  weightDecay = 0.5 * lambda * wL2SquaredNorm;
-  klDivergence = beta * accu(rho * log(rho / rhoCap) + (1 - rho) *
-      log((1 - rho) / (1 - rhoCap)));
+  const ElemType sumOfSquaresError = 0.5 * accu(chunkErrors) / batchSize;
+  const ElemType weightDecay = 0.5 * lambda * (accu(w1 % w1) +
+      accu(w2t % w2t));
+  const ElemType klDivergence = beta * accu(r * log(r / rhoCap) + (1 - r) *
+      log((1 - r) / (1 - rhoCap)));
+
+  if (gradient)
+  {
+    // For every layer in the neural network which comes before the output
+    // layer, the delta values are given del_n = w_n' * del_(n+1) * f'(z_n).
+    // Since our cost function also includes the KL divergence term, we adjust
+    // for that in the formula below.
+    const DenseMatType klDivGrad = beta * (-(r / rhoCap) + (1 - r) /
+        (1 - rhoCap));
+
+    // The gradient of each chunk is computed separately and summed in order.
+    std::vector<DenseMatType> w1Gradients(numChunks), w2Gradients(numChunks);
+    DenseMatType b1Gradients(l1, numChunks), b2Gradients(l2, numChunks);
+
+    #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      const size_t chunkBegin = std::min(c * chunkSize, batchSize);
+      const size_t chunkEnd = std::min((c + 1) * chunkSize, batchSize);
+      w1Gradients[c].zeros(l1, l2);
+      w2Gradients[c].zeros(l1, l2);
+      b1Gradients.col(c).zeros();
+      b2Gradients.col(c).zeros();
+      if (chunkBegin == chunkEnd)
+        continue;
+
+      const MatType points = data.cols(begin + chunkBegin,
+          begin + chunkEnd - 1);
+      const DenseMatType hidden = hiddenLayer.cols(chunkBegin, chunkEnd - 1);
+      const DenseMatType out = delOut.cols(chunkBegin, chunkEnd - 1);
+
+      DenseMatType delHid = w2t * out;
+      delHid.each_col() += klDivGrad;
+      delHid %= hidden % (1 - hidden);
+
+      w1Gradients[c] = delHid * points.t();
+      w2Gradients[c] = hidden * out.t();
+      b1Gradients.col(c) = sum(delHid, 1);
+      b2Gradients.col(c) = sum(out, 1);
+    }
+
+    DenseMatType& g = *gradient;
+    g.zeros(2 * hiddenSize + 1, visibleSize + 1);
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      g.submat(0, 0, l1 - 1, l2 - 1) += w1Gradients[c];
+      g.submat(l1, 0, l3 - 1, l2 - 1) += w2Gradients[c];
+    }
+
+    // Compute the gradient values using the activations and the delta values.
+    // The formula also accounts for the regularization terms in the objective
+    // function.
+    g.submat(0, 0, l1 - 1, l2 - 1) = g.submat(0, 0, l1 - 1, l2 - 1) /
+        batchSize + lambda * w1;
+    g.submat(l1, 0, l3 - 1, l2 - 1) = g.submat(l1, 0, l3 - 1, l2 - 1) /
+        batchSize + lambda * w2t;
+    g.submat(0, l2, l1 - 1, l2) = sum(b1Gradients, 1) / batchSize;
+    g.submat(l3, 0, l3, l2 - 1) = (sum(b2Gradients, 1) / batchSize).t();
+  }
 
   // The cost is the sum of the terms calculated above.
-  cost = sumOfSquaresError + weightDecay + klDivergence;
-
-  return cost;
-}
-
-/** Calculates and stores the gradient values given a set of parameters.
-  */
-inline void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
-                                                arma::mat& gradient) const
-{
-  // Performs a feedforward pass of the neural network, and computes the
-  // activations of the output layer as in the Evaluate() method. It uses the
-  // Backpropagation algorithm to calculate the delta values at each layer,
-  // except for the input layer. The delta values are then used with input layer
-  // and hidden layer activations to get the parameter gradients.
-
-  // Compute the limits for the parameters w1, w2, b1 and b2.
-  const size_t l1 = hiddenSize;
-  const size_t l2 = visibleSize;
-  const size_t l3 = 2 * hiddenSize;
-
-  // w1, w2, b1 and b2 are not extracted separately, 'parameters' is directly
-  // used in their place to avoid copying data. The following representations
-  // are used:
-  // w1 <- parameters.submat(0, 0, l1-1, l2-1)
-  // w2 <- parameters.submat(l1, 0, l3-1, l2-1).t()
-  // b1 <- parameters.submat(0, l2, l1-1, l2)
-  // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
-
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
-
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
-
-  // Average activations of the hidden layer.
-  rhoCap = sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  arma::mat klDivGrad, delOut, delHid;
-
-  // The delta vector for the output layer is given by diff * f'(z), where z is
-  // the preactivation and f is the activation function. The derivative of the
-  // sigmoid function turns out to be f(z) * (1 - f(z)). For every other layer
-  // in the neural network which comes before the output layer, the delta values
-  // are given del_n = w_n' * del_(n+1) * f'(z_n). Since our cost function also
-  // includes the KL divergence term, we adjust for that in the formula below.
-  klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) / (1 - rhoCap));
-  delOut = diff % outputLayer % (1 - outputLayer);
-  delHid = (parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut +
-      repmat(klDivGrad, 1, data.n_cols)) % hiddenLayer %
-      (1 - hiddenLayer);
-
-  gradient.zeros(2 * hiddenSize + 1, visibleSize + 1);
-
-  // Compute the gradient values using the activations and the delta values. The
-  // formula also accounts for the regularization terms in the objective.
-  // function.
-  gradient.submat(0, 0, l1 - 1, l2 - 1) = delHid * data.t() / data.n_cols +
-      lambda * parameters.submat(0, 0, l1 - 1, l2 - 1);
-  gradient.submat(l1, 0, l3 - 1, l2 - 1) =
-      (delOut * hiddenLayer.t() / data.n_cols +
-      lambda * parameters.submat(l1, 0, l3 - 1, l2 - 1).t()).t();
-  gradient.submat(0, l2, l1 - 1, l2) = sum(delHid, 1) / data.n_cols;
-  gradient.submat(l3, 0, l3, l2 - 1) = (sum(delOut, 1) / data.n_cols).t();
+  return sumOfSquaresError + weightDecay + klDivergence;
 }
 
 } // namespace mlpack
@@ -58,60 +58,21 @@ inline SparseCoding::SparseCoding(
 inline void SparseCoding::Encode(const arma::mat& data,
                                  arma::mat& codes)
 {
+  // Each point is coded with the same dictionary, so LARS computes the Gram
+  // matrix of the dictionary only once, and codes the points in parallel.
   // When using the Cholesky version of LARS, this is correct even if
-  // lambda2 > 0.
-  arma::mat matGram = trans(dictionary) * dictionary;
-
-  codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    // Report progress.
-    if ((i % 100) == 0)
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-
-    bool useCholesky = true;
-    // Intercept fitting and data normalization is disabled.
-    LARS<> lars(useCholesky, lambda1, lambda2, 1e-16 /* default tolerance */,
-        false, false);
-
-    // Create an alias of the code (using the same memory), and then LARS will
-    // place the result directly into that; then we will not need to have an
-    // extra copy.
-    arma::vec code = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictionary, responses, false, useCholesky, matGram);
-    code = lars.Beta();
-  }
+  // lambda2 > 0.  Intercept fitting and data normalization is disabled.
+  LARS<> lars(true /* use Cholesky */, lambda1, lambda2,
+      1e-16 /* default tolerance */, false, false);
+  lars.TrainBatch(dictionary, data, codes, false);
 }
 
 // Dictionary step for optimization.
-inline double SparseCoding::OptimizeDictionary(const arma::mat& data,
-                                               const arma::mat& codes,
-                                               const arma::uvec& adjacencies)
+inline double SparseCoding::OptimizeDictionary(
+    const arma::mat& data,
+    const arma::mat& codes,
+    const arma::uvec& /* adjacencies */)
 {
-  // Count the number of atomic neighbors for each point x^i.
-  arma::uvec neighborCounts = arma::zeros<arma::uvec>(data.n_cols, 1);
-
-  if (adjacencies.n_elem > 0)
-  {
-    // This gets the column index.  Intentional integer division.
-    size_t curPointInd = (size_t) (adjacencies(0) / atoms);
-
-    size_t nextColIndex = (curPointInd + 1) * atoms;
-    for (size_t l = 1; l < adjacencies.n_elem; ++l)
-    {
-      // If l no longer refers to an element in this column, advance the column
-      // number accordingly.
-      if (adjacencies(l) >= nextColIndex)
-      {
-        curPointInd = (size_t) (adjacencies(l) / atoms);
-        nextColIndex = (curPointInd + 1) * atoms;
-      }
-
-      ++neighborCounts(curPointInd);
-    }
-  }
-
   // Handle the case of inactive atoms (atoms not used in the given coding).
   std::vector<arma::uword> activeAtoms;
   for (arma::uword j = 0; j < atoms; ++j)
@@ -123,13 +84,6 @@ inline double SparseCoding::OptimizeDictionary(const arma::mat& data,
   const size_t nActiveAtoms = activeAtoms.size();
   const size_t nInactiveAtoms = atoms - nActiveAtoms;
 
-  // Efficient construction of Z restricted to active atoms.
-  arma::mat matActiveZ;
-  if (nInactiveAtoms > 0)
-  {
-    matActiveZ = codes.rows(arma::uvec(activeAtoms));
-  }
-
   if (nInactiveAtoms > 0)
   {
     Log::Warn << "There are " << nInactiveAtoms
@@ -158,19 +112,40 @@ inline double SparseCoding::OptimizeDictionary(const arma::mat& data,
 
   bool converged = false;
 
-  // If we have any inactive atoms, we must construct these differently.
-  arma::mat codesXT;
-  arma::mat codesZT;
+  // Compute Z X^T and Z Z^T, with Z restricted to the active atoms, in
+  // parallel over blocks of points.  Only one block of the codes of the active
+  // atoms is copied at a time.
+  const arma::uvec activeAtomIndices(activeAtoms);
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  arma::mat codesXT(nActiveAtoms, data.n_rows, arma::fill::zeros);
+  arma::mat codesZT(nActiveAtoms, nActiveAtoms, arma::fill::zeros);
 
-  if (nInactiveAtoms == 0)
-  {
-    codesXT = codes * trans(data);
-    codesZT = codes * trans(codes);
-  }
-  else
+  #pragma omp parallel num_threads((int) NumThreads())
   {
-    codesXT = matActiveZ * trans(data);
-    codesZT = matActiveZ * trans(matActiveZ);
+    arma::mat threadCodesXT(nActiveAtoms, data.n_rows, arma::fill::zeros);
+    arma::mat threadCodesZT(nActiveAtoms, nActiveAtoms, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) data.n_cols) - 1;
+
+      // If we have any inactive atoms, we must construct these differently.
+      const arma::mat blockCodes = (nInactiveAtoms == 0) ?
+          arma::mat(codes.cols(begin, end)) :
+          arma::mat(codes.submat(activeAtomIndices, arma::regspace<arma::uvec>(
+              begin, end)));
+      threadCodesXT += blockCodes * trans(data.cols(begin, end));
+      threadCodesZT += blockCodes * trans(blockCodes);
+    }
+
+    #pragma omp critical
+    {
+      codesXT += threadCodesXT;
+      codesZT += threadCodesZT;
+    }
   }
 
   double normGradient = 0;
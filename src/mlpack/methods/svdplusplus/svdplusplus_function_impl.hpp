@@ -15,6 +15,7 @@
 
 #include "svdplusplus_function.hpp"
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/methods/regularized_svd/stratified_sgd.hpp>
 
 namespace mlpack {
 
@@ -397,159 +398,107 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
     mlpack::SVDPlusPlusFunction<arma::mat>& function,
     arma::mat& iterate)
 {
-  double overallObjective = DBL_MAX;
-  double lastObjective;
-
-  // The order in which the functions will be visited.
-  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
-      (function.NumFunctions() - 1), function.NumFunctions());
-
-  const arma::mat data = function.Dataset();
-  const arma::sp_mat implicitData = function.ImplicitDataset();
+  const arma::mat& data = function.Dataset();
+  const arma::sp_mat& implicitData = function.ImplicitDataset();
   const size_t numUsers = function.NumUsers();
   const size_t numItems = function.NumItems();
+  const size_t implicitStart = numUsers + numItems;
   const double lambda = function.Lambda();
 
   // Rank of decomposition.
   const size_t rank = function.Rank();
 
-  // Iterate till the objective is within tolerance or the maximum number of
-  // allowed iterations is reached. If maxIterations is 0, this will iterate
-  // till convergence.
-  for (size_t i = 1; i != maxIterations; ++i)
+  // The ratings are visited in blocks that never share a user or an item, so
+  // the user and item parameters are updated in place without atomic
+  // operations.  The implicit vectors of the items that a user interacted with
+  // may belong to any block, so their updates are gathered for each user (the
+  // users of a block are only visited by one thread) and applied after each
+  // stratum, item by item.
+  arma::mat implicitUpdates(rank, numUsers, arma::fill::zeros);
+  arma::vec implicitDecay(numUsers, arma::fill::zeros);
+  implicitData.sync();
+  const arma::sp_mat implicitUsers = implicitData.t();
+
+  auto update = [&](const size_t j, const double stepSize)
   {
-    // Calculate the overall objective.
-    lastObjective = overallObjective;
-    overallObjective = 0;
+    // Indices for accessing the the correct parameter columns.
+    const size_t user = data(0, j);
+    const size_t item = data(1, j) + numUsers;
 
-    #pragma omp parallel for reduction(+:overallObjective)
-    for (size_t j = 0; j < (size_t) function.NumFunctions(); ++j)
+    // Prediction error for the example.
+    const double rating = data(2, j);
+    const double userBias = iterate(rank, user);
+    const double itemBias = iterate(rank, item);
+    // Iterate through each item which the user interacted with to calculate
+    // user vector.
+    arma::vec userVec(rank, arma::fill::zeros);
+    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+    size_t implicitCount = 0;
+    for (; it != it_end; ++it)
     {
-      overallObjective += function.Evaluate(iterate, j);
+      userVec += iterate.col(implicitStart + it.row()).subvec(0, rank - 1);
+      implicitCount += 1;
     }
+    if (implicitCount != 0)
+      userVec /= std::sqrt(implicitCount);
+    userVec += iterate.col(user).subvec(0, rank - 1);
 
-    // Output current objective function.
-    mlpack::Log::Info << "Parallel SGD: iteration " << i << ", objective "
-        << overallObjective << "." << std::endl;
+    const double ratingError = rating - userBias - itemBias -
+        dot(userVec, iterate.col(item).subvec(0, rank - 1));
 
-    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    // Gather the update of the implicit vectors, with the item vector before
+    // its update.
+    if (implicitCount != 0)
     {
-      mlpack::Log::Warn << "Parallel SGD: converged to " << overallObjective
-          << "; terminating with failure. Try a smaller step size?"
-          << std::endl;
-      return overallObjective;
+      implicitUpdates.col(user) += stepSize * 2.0 * ratingError /
+          std::sqrt(implicitCount) * iterate.col(item).subvec(0, rank - 1);
+      implicitDecay[user] += stepSize * 2.0 * lambda / implicitCount;
     }
 
-    if (std::abs(lastObjective - overallObjective) < tolerance)
+    // Gradient is non-zero only for the parameter columns corresponding to the
+    // example.
+    double* userFactors = iterate.colptr(user);
+    double* itemFactors = iterate.colptr(item);
+    for (size_t i = 0; i < rank; ++i)
     {
-      mlpack::Log::Info << "SGD: minimized within tolerance " << tolerance
-          << "; terminating optimization." << std::endl;
-      return overallObjective;
+      const double userValue = userFactors[i];
+      userFactors[i] -= stepSize * 2 * (lambda * userValue -
+          ratingError * itemFactors[i]);
+      itemFactors[i] -= stepSize * 2 * (lambda * itemFactors[i] -
+          ratingError * userVec[i]);
     }
+    iterate(rank, user) -= stepSize * 2 * (lambda * userBias - ratingError);
+    iterate(rank, item) -= stepSize * 2 * (lambda * itemBias - ratingError);
+  };
 
-    // Get the stepsize for this iteration
-    double stepSize = decayPolicy.StepSize(i);
-
-    if (shuffle) // Determine order of visitation.
-      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
-          mlpack::RandGen());
-
-    #pragma omp parallel
+  auto endStratum = [&](const double /* stepSize */)
+  {
+    #pragma omp parallel for schedule(dynamic, 64) \
+        num_threads((int) NumThreads())
+    for (size_t item = 0; item < implicitUsers.n_cols; ++item)
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef MLPACK_USE_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
+      arma::sp_mat::const_iterator it = implicitUsers.begin_col(item);
+      arma::sp_mat::const_iterator it_end = implicitUsers.end_col(item);
+      for (; it != it_end; ++it)
       {
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-        const size_t implicitStart = numUsers + numItems;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        const double userBias = iterate(rank, user);
-        const double itemBias = iterate(rank, item);
-        // Iterate through each item which the user interacted with to calculate
-        // user vector.
-        arma::vec userVec(rank, arma::fill::zeros);
-        arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-        arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-        size_t implicitCount = 0;
-        for (; it != it_end; ++it)
-        {
-          userVec += iterate.col(implicitStart + it.row()).subvec(0, rank - 1);
-          implicitCount += 1;
-        }
-        if (implicitCount != 0)
-          userVec /= std::sqrt(implicitCount);
-        userVec += iterate.col(user).subvec(0, rank - 1);
-
-        double ratingError = rating - userBias - itemBias -
-        dot(userVec, iterate.col(item).subvec(0, rank - 1));
-
-        arma::mat userVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(user).subvec(0, rank - 1) -
-            ratingError * iterate.col(item).subvec(0, rank - 1));
-        arma::mat itemVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(item).subvec(0, rank - 1) -
-            ratingError * userVec);
-        double userBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, user) - ratingError);
-        double itemBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, item) - ratingError);
-
-        // Update of item implicit vectors.
-        arma::mat itemImplicitUpdate(rank, implicitCount);
-        arma::Col<size_t> implicitItems(implicitCount);
-        it = implicitData.begin_col(user);
-        it_end = implicitData.end_col(user);
-        size_t implicitIndex = 0;
-        for (; it != it_end; ++it, ++implicitIndex)
-        {
-          itemImplicitUpdate.col(implicitIndex) =
-              stepSize * 2.0 * (lambda / implicitCount *
-              iterate.col(implicitStart + it.row()).subvec(0, rank - 1) -
-              ratingError / std::sqrt(implicitCount) *
-              iterate.col(item).subvec(0, rank - 1));
-          implicitItems(implicitIndex) = it.row();
-        }
-
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < rank; ++i)
-        {
-          #pragma omp atomic
-          iterate(i, user) -= userVecUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemVecUpdate(i);
-        }
-        #pragma omp atomic
-        iterate(rank, user) -= userBiasUpdate;
-        #pragma omp atomic
-        iterate(rank, item) -= itemBiasUpdate;
-        for (size_t k = 0; k < implicitCount; ++k)
-        {
-          for (size_t i = 0; i < rank; ++i)
-          {
-            #pragma omp atomic
-            iterate(i, implicitStart + implicitItems(k)) -=
-                itemImplicitUpdate(i, k);
-          }
-        }
+        const size_t user = it.row();
+        if (implicitDecay[user] == 0.0)
+          continue;
+
+        iterate.col(implicitStart + item).subvec(0, rank - 1) *=
+            (1.0 - implicitDecay[user]);
+        iterate.col(implicitStart + item).subvec(0, rank - 1) +=
+            implicitUpdates.col(user);
       }
     }
-  }
-  mlpack::Log::Info << "\n Parallel SGD terminated with objective : "
-      << overallObjective << std::endl;
 
-  return overallObjective;
+    implicitUpdates.zeros();
+    implicitDecay.zeros();
+  };
+
+  return mlpack::StratifiedParallelSGD(*this, function, iterate, update,
+      endStratum);
 }
 
 } // namespace ens
@@ -91,18 +91,91 @@ class SSELoss
 
     return std::pow(ApplyL1(accu(gradients)), 2) / (accu(hessians) + lambda);
   }
+
+  /**
+   * Compute the first and second order gradients of the loss with respect to
+   * the prediction of each point, for gradient boosting.
+   *
+   * @param responses The true observed values.
+   * @param predictions The predictions at the current step of boosting.
+   * @param gradients Will be set to the first order gradient of each point.
+   * @param hessians Will be set to the second order gradient of each point.
+   */
+  template<typename ResponsesType, typename PredictionsType>
+  void Gradients(const ResponsesType& responses,
+                 const PredictionsType& predictions,
+                 arma::vec& gradients,
+                 arma::vec& hessians) const
+  {
+    gradients = arma::vectorise(predictions - responses);
+    hessians.ones(responses.n_elem);
+  }
+
+  /**
+   * Returns the output value of a leaf, given the sums of the gradients and
+   * hessians of the points in it.
+   */
+  double LeafValue(const double sumGradients, const double sumHessians) const
+  {
+    return -ApplyL1(sumGradients) / (sumHessians + lambda);
+  }
+
+  /**
+   * Returns the gain (the structure score) of a node, given the sums of the
+   * gradients and hessians of the points in it.
+   */
+  double Gain(const double sumGradients, const double sumHessians) const
+  {
+    return std::pow(ApplyL1(sumGradients), 2) / (sumHessians + lambda);
+  }
+
+  /**
+   * Returns the mean loss of the given predictions.
+   *
+   * @param responses The true observed values.
+   * @param predictions The predictions to compute the loss of.
+   */
+  template<typename ResponsesType, typename PredictionsType>
+  double Loss(const ResponsesType& responses,
+              const PredictionsType& predictions) const
+  {
+    if (responses.n_elem == 0)
+      return 0.0;
+
+    return 0.5 * accu(arma::square(responses - predictions)) /
+        responses.n_elem;
+  }
+
+  //! Get the L1 regularization parameter.
+  double Alpha() const { return alpha; }
+  //! Modify the L1 regularization parameter.
+  double& Alpha() { return alpha; }
+
+  //! Get the L2 regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the L2 regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Serialize the loss function.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(alpha));
+    ar(CEREAL_NVP(lambda));
+  }
+
  private:
   //! The L1 regularization parameter.
-  const double alpha;
+  double alpha;
   //! The L2 regularization parameter.
-  const double lambda;
+  double lambda;
   //! First order gradients.
   arma::vec gradients;
   //! Second order gradients (hessians).
   arma::vec hessians;
 
   //! Applies the L1 regularization.
-  double ApplyL1(const double sumGradients)
+  double ApplyL1(const double sumGradients) const
   {
     if (sumGradients > alpha)
     {
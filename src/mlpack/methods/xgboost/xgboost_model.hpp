@@ -0,0 +1,42 @@
+/**
+ * @file methods/xgboost/xgboost_model.hpp
+ *
+ * A serializable gradient boosted tree model, used by the xgboost_train and
+ * xgboost_predict bindings.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_MODEL_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_MODEL_HPP
+
+#include "xgboost_regressor.hpp"
+
+namespace mlpack {
+
+/**
+ * A serializable wrapper around XGBoostRegressor<>, so that the trained model
+ * can be shared between the xgboost_train and xgboost_predict bindings.
+ */
+class XGBoostModel
+{
+ public:
+  //! The ensemble itself, left public for direct access by the bindings.
+  XGBoostRegressor<> xgb;
+
+  //! Create the model.
+  XGBoostModel() { /* Nothing to do. */ }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(xgb));
+  }
+};
+
+} // namespace mlpack
+
+#endif
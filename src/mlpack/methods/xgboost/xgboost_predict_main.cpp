@@ -0,0 +1,86 @@
+/**
+ * @file methods/xgboost/xgboost_predict_main.cpp
+ *
+ * A program to predict responses with pre-trained gradient boosted trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#undef BINDING_NAME
+#define BINDING_NAME xgboost_predict
+
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "xgboost_model.hpp"
+
+using namespace mlpack;
+using namespace mlpack::util;
+using namespace std;
+
+// Program Name.
+BINDING_USER_NAME("Gradient Boosted Trees Prediction");
+
+// Short description.
+BINDING_SHORT_DESC(
+    "A prediction program for gradient boosted regression trees.  Given a model"
+    " trained with the xgboost_train binding and a set of points, this predicts"
+    " the response of each point.");
+
+// Long description.
+BINDING_LONG_DESC(
+    "This program predicts the responses of the points given with the " +
+    PRINT_PARAM_STRING("test") + " parameter with the gradient boosted trees "
+    "model given with the " + PRINT_PARAM_STRING("input_model") + " parameter,"
+    " which can be trained with the xgboost_train binding.  The predictions "
+    "may be saved via the " + PRINT_PARAM_STRING("predictions") + " output "
+    "parameter.");
+
+// Example.
+BINDING_EXAMPLE(
+    "For example, to predict the responses of the points in " +
+    PRINT_DATASET("test_data") + " with the pre-trained model " +
+    PRINT_MODEL("xgb_model") + ", saving the predictions to " +
+    PRINT_DATASET("predictions") + ", one could call"
+    "\n\n" +
+    PRINT_CALL("xgboost_predict", "input_model", "xgb_model", "test",
+        "test_data", "predictions", "predictions"));
+
+// See also...
+BINDING_SEE_ALSO("@xgboost_train", "#xgboost_train");
+BINDING_SEE_ALSO("Gradient boosting on Wikipedia",
+    "https://en.wikipedia.org/wiki/Gradient_boosting");
+BINDING_SEE_ALSO("XGBoostRegressor C++ class documentation",
+    "@src/mlpack/methods/xgboost/xgboost_regressor.hpp");
+
+PARAM_MODEL_IN_REQ(XGBoostModel, "input_model", "Pre-trained gradient boosted "
+    "trees model.", "m");
+PARAM_MATRIX_IN_REQ("test", "Test dataset to predict the responses of.", "T");
+
+PARAM_ROW_OUT("predictions", "Predicted responses for each point in the test "
+    "set.", "p");
+
+void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
+{
+  RequireAtLeastOnePassed(params, { "predictions" }, false, "no predictions "
+      "will be saved");
+
+  XGBoostModel* model = params.Get<XGBoostModel*>("input_model");
+  arma::mat& data = params.Get<arma::mat>("test");
+
+  if (data.n_rows != model->xgb.Dimensionality())
+  {
+    Log::Fatal << "Dimensionality of test data (" << data.n_rows << ") does "
+        << "not match the dimensionality of the model ("
+        << model->xgb.Dimensionality() << ")!" << endl;
+  }
+
+  timers.Start("xgboost_prediction");
+  arma::rowvec predictions;
+  model->xgb.Predict(data, predictions);
+  timers.Stop("xgboost_prediction");
+
+  params.Get<arma::rowvec>("predictions") = std::move(predictions);
+}
@@ -0,0 +1,356 @@
+/**
+ * @file methods/xgboost/xgboost_regressor.hpp
+ *
+ * A gradient boosted tree ensemble for regression, trained with second order
+ * leaf values and histogram-based tree growth.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_REGRESSOR_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_REGRESSOR_HPP
+
+#include <mlpack/core.hpp>
+
+#include "loss_functions/sse_loss.hpp"
+#include "xgboost_tree.hpp"
+
+namespace mlpack {
+
+/**
+ * The XGBoostRegressor is a gradient boosted ensemble of regression trees, in
+ * the style of XGBoost and LightGBM.  Starting from the initial prediction of
+ * the loss function (the mean of the responses, for SSELoss), each tree is
+ * trained on the gradients and hessians of the loss of the predictions of the
+ * previous trees, and its leaves hold the second order (Newton) step for the
+ * points in them, scaled by the learning rate.  The loss function also
+ * provides the L1 and L2 regularization of the leaf values.
+ *
+ * Before training, each dimension of the data is discretized into at most
+ * MaxBins quantile bins, and the trees are grown from histograms over these
+ * bins (see XGBoostTree).  Each tree can be trained on a random subsample of
+ * the points and of the dimensions.  If a validation set is given to Train(),
+ * training stops when the loss on the validation set has not improved for a
+ * given number of trees, and the ensemble is truncated to the trees that gave
+ * the best validation loss.
+ *
+ * Train() can also be given an all-reduce policy (see LocalAllReduce and
+ * MPIAllReduce), for datasets whose points are sharded across several
+ * processes.  Every process calls Train() with its own shard (and its own
+ * shard of the validation set), and the processes build the same ensemble:
+ * the bin edges are merged from the quantiles of each shard, the histograms of
+ * each node and the losses are summed over the processes, and the dimensions
+ * each tree can split are chosen by the first process.  No points are ever
+ * communicated.
+ *
+ * @code
+ * arma::mat data;
+ * arma::rowvec responses;
+ * // Load data and responses...
+ *
+ * // Train 200 trees with a learning rate of 0.1.
+ * XGBoostRegressor<> xgb(data, responses, 200, 0.1);
+ * arma::rowvec predictions;
+ * xgb.Predict(testData, predictions);
+ * @endcode
+ *
+ * @tparam LossFunction Loss function to minimize; it must provide
+ *     InitialPrediction(), Gradients(), LeafValue(), Gain(), and Loss().
+ */
+template<typename LossFunction = SSELoss>
+class XGBoostRegressor
+{
+ public:
+  //! The maximum number of bins each dimension is discretized into.
+  static constexpr size_t MaxBins = 256;
+
+  /**
+   * Create the regressor with the given parameters, without training it.
+   *
+   * @param numTrees Number of trees to train.
+   * @param learningRate Factor the values of the leaves are scaled by.
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumChildWeight Minimum sum of hessians in each leaf.
+   * @param minimumGain Minimum gain of each split.
+   * @param rowSubsample Fraction of the points each tree is trained on.
+   * @param featureSubsample Fraction of the dimensions each tree can split.
+   * @param loss Instantiated loss function.
+   */
+  XGBoostRegressor(const size_t numTrees = 100,
+                   const double learningRate = 0.3,
+                   const size_t maximumDepth = 6,
+                   const double minimumChildWeight = 1.0,
+                   const double minimumGain = 0.0,
+                   const double rowSubsample = 1.0,
+                   const double featureSubsample = 1.0,
+                   const LossFunction& loss = LossFunction());
+
+  /**
+   * Create the regressor with the given parameters and train it on the given
+   * data and responses.
+   *
+   * @param data Dataset to train on, with one point per column.
+   * @param responses Responses of each point.
+   * @param numTrees Number of trees to train.
+   * @param learningRate Factor the values of the leaves are scaled by.
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumChildWeight Minimum sum of hessians in each leaf.
+   * @param minimumGain Minimum gain of each split.
+   * @param rowSubsample Fraction of the points each tree is trained on.
+   * @param featureSubsample Fraction of the dimensions each tree can split.
+   * @param loss Instantiated loss function.
+   */
+  template<typename MatType, typename ResponsesType>
+  XGBoostRegressor(const MatType& data,
+                   const ResponsesType& responses,
+                   const size_t numTrees = 100,
+                   const double learningRate = 0.3,
+                   const size_t maximumDepth = 6,
+                   const double minimumChildWeight = 1.0,
+                   const double minimumGain = 0.0,
+                   const double rowSubsample = 1.0,
+                   const double featureSubsample = 1.0,
+                   const LossFunction& loss = LossFunction(),
+                   const std::enable_if_t<arma::is_arma_type<
+                       MatType>::value>* = 0);
+
+  /**
+   * Train the ensemble on the given data and responses, with the parameters of
+   * the regressor.  Any previous trees are discarded.
+   *
+   * @param data Dataset to train on, with one point per column.
+   * @param responses Responses of each point.
+   * @return The loss of the final predictions on the training set.
+   */
+  template<typename MatType, typename ResponsesType>
+  double Train(const MatType& data, const ResponsesType& responses);
+
+  /**
+   * Train the ensemble on this process's shard of a dataset whose points are
+   * sharded across several processes, with the parameters of the regressor.
+   * Every process must call Train() with the same parameters, and every shard
+   * must have the same dimensionality and at least one point.  Any previous
+   * trees are discarded.
+   *
+   * @param data Shard of the dataset to train on, with one point per column.
+   * @param responses Responses of each point of the shard.
+   * @param allReduce All-reduce policy over the processes.
+   * @return The loss of the final predictions on the whole training set.
+   */
+  template<typename MatType, typename ResponsesType, typename AllReduceType>
+  double Train(const MatType& data,
+               const ResponsesType& responses,
+               const AllReduceType& allReduce);
+
+  /**
+   * Train the ensemble on the given data and responses, with early stopping on
+   * the given validation set: training stops when the validation loss has not
+   * improved for earlyStoppingRounds trees, and the trees after the best
+   * validation loss are removed.  Any previous trees are discarded.
+   *
+   * @param data Dataset to train on, with one point per column.
+   * @param responses Responses of each point.
+   * @param validationData Validation dataset, with one point per column.
+   * @param validationResponses Responses of each validation point.
+   * @param earlyStoppingRounds Number of trees without improvement of the
+   *     validation loss before training stops.
+   * @return The best loss on the validation set.
+   */
+  template<typename MatType, typename ResponsesType>
+  double Train(const MatType& data,
+               const ResponsesType& responses,
+               const MatType& validationData,
+               const ResponsesType& validationResponses,
+               const size_t earlyStoppingRounds = 10);
+
+  /**
+   * Train the ensemble on this process's shard of a dataset whose points are
+   * sharded across several processes, with early stopping on the loss over
+   * the validation shards of all processes.  Every process must call Train()
+   * with the same parameters, and every shard must have the same
+   * dimensionality and at least one point.  Any previous trees are discarded.
+   *
+   * @param data Shard of the dataset to train on, with one point per column.
+   * @param responses Responses of each point of the shard.
+   * @param validationData Shard of the validation dataset.
+   * @param validationResponses Responses of each validation point of the
+   *     shard.
+   * @param earlyStoppingRounds Number of trees without improvement of the
+   *     validation loss before training stops.
+   * @param allReduce All-reduce policy over the processes.
+   * @return The best loss on the whole validation set.
+   */
+  template<typename MatType, typename ResponsesType, typename AllReduceType>
+  double Train(const MatType& data,
+               const ResponsesType& responses,
+               const MatType& validationData,
+               const ResponsesType& validationResponses,
+               const size_t earlyStoppingRounds,
+               const AllReduceType& allReduce);
+
+  /**
+   * Predict the response of the given point.
+   *
+   * @param point Point to predict the response of.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const;
+
+  /**
+   * Predict the responses of the given points.
+   *
+   * @param data Points to predict the responses of, one per column.
+   * @param predictions Will be set to the prediction of each point.
+   */
+  template<typename MatType>
+  void Predict(const MatType& data, arma::rowvec& predictions) const;
+
+  //! Get the number of trees in the trained ensemble.
+  size_t NumTreesTrained() const { return trees.size(); }
+  //! Get a tree of the ensemble.
+  const XGBoostTree& Tree(const size_t i) const { return trees[i]; }
+
+  //! Get the initial prediction, before the first tree.
+  double InitialPrediction() const { return initialPrediction; }
+  //! Get the dimensionality of the model.
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Get the number of trees to train.
+  size_t NumTrees() const { return numTrees; }
+  //! Modify the number of trees to train.
+  size_t& NumTrees() { return numTrees; }
+
+  //! Get the learning rate.
+  double LearningRate() const { return learningRate; }
+  //! Modify the learning rate.
+  double& LearningRate() { return learningRate; }
+
+  //! Get the maximum depth of each tree.
+  size_t MaximumDepth() const { return maximumDepth; }
+  //! Modify the maximum depth of each tree.
+  size_t& MaximumDepth() { return maximumDepth; }
+
+  //! Get the minimum sum of hessians in each leaf.
+  double MinimumChildWeight() const { return minimumChildWeight; }
+  //! Modify the minimum sum of hessians in each leaf.
+  double& MinimumChildWeight() { return minimumChildWeight; }
+
+  //! Get the minimum gain of each split.
+  double MinimumGain() const { return minimumGain; }
+  //! Modify the minimum gain of each split.
+  double& MinimumGain() { return minimumGain; }
+
+  //! Get the fraction of the points each tree is trained on.
+  double RowSubsample() const { return rowSubsample; }
+  //! Modify the fraction of the points each tree is trained on.
+  double& RowSubsample() { return rowSubsample; }
+
+  //! Get the fraction of the dimensions each tree can split.
+  double FeatureSubsample() const { return featureSubsample; }
+  //! Modify the fraction of the dimensions each tree can split.
+  double& FeatureSubsample() { return featureSubsample; }
+
+  //! Get the loss function.
+  const LossFunction& Loss() const { return loss; }
+  //! Modify the loss function.
+  LossFunction& Loss() { return loss; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Train the ensemble, with early stopping if a validation set is given.
+   * Returns the final training loss, or the best validation loss.
+   */
+  template<bool UseValidation,
+           typename MatType,
+           typename ResponsesType,
+           typename AllReduceType>
+  double Train(const MatType& data,
+               const ResponsesType& responses,
+               const MatType& validationData,
+               const ResponsesType& validationResponses,
+               const size_t earlyStoppingRounds,
+               const AllReduceType& allReduce);
+
+  /**
+   * Discretize every dimension of the data into at most MaxBins bins, whose
+   * upper edges are quantiles of a subsample of the values of the dimension.
+   * If the points are sharded, the edges are merged from the quantiles of the
+   * shards, so that every process has the same edges.
+   *
+   * @param data Dataset to discretize.
+   * @param bins Will be set to the bin of each value, with one row per point
+   *     and one column per dimension.
+   * @param binEdges Will be set to the upper edge of each bin of each
+   *     dimension.
+   * @param allReduce All-reduce policy over the processes.
+   */
+  template<typename MatType, typename AllReduceType>
+  static void Bin(const MatType& data,
+                  arma::Mat<uint8_t>& bins,
+                  std::vector<arma::vec>& binEdges,
+                  const AllReduceType& allReduce);
+
+  /**
+   * Merge the bin edges of the shards of all processes into at most MaxBins
+   * edges per dimension.  The edges of each shard are weighted by the number of
+   * points of the shard, and the merged edges are the weighted quantiles of
+   * all of them.
+   */
+  template<typename AllReduceType>
+  static void MergeBinEdges(const size_t numPoints,
+                            std::vector<arma::vec>& binEdges,
+                            const AllReduceType& allReduce);
+
+  /**
+   * Return the mean over all processes of a quantity whose mean over the
+   * numPoints points of this process is localMean.
+   */
+  template<typename AllReduceType>
+  static double GlobalMean(const double localMean,
+                           const size_t numPoints,
+                           const AllReduceType& allReduce);
+
+  //! Validate the parameters, throwing std::invalid_argument if they are
+  //! invalid.
+  void CheckParameters() const;
+
+  //! Number of trees to train.
+  size_t numTrees;
+  //! Factor the values of the leaves are scaled by.
+  double learningRate;
+  //! Maximum depth of each tree.
+  size_t maximumDepth;
+  //! Minimum sum of hessians in each leaf.
+  double minimumChildWeight;
+  //! Minimum gain of each split.
+  double minimumGain;
+  //! Fraction of the points each tree is trained on.
+  double rowSubsample;
+  //! Fraction of the dimensions each tree can split.
+  double featureSubsample;
+  //! Instantiated loss function.
+  LossFunction loss;
+
+  //! Prediction before the first tree.
+  double initialPrediction;
+  //! Dimensionality of the training data.
+  size_t dimensionality;
+  //! The trained trees.
+  std::vector<XGBoostTree> trees;
+};
+
+template<typename LossFunction>
+constexpr size_t XGBoostRegressor<LossFunction>::MaxBins;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "xgboost_regressor_impl.hpp"
+
+#endif
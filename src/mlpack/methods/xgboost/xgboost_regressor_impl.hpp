@@ -0,0 +1,478 @@
+/**
+ * @file methods/xgboost/xgboost_regressor_impl.hpp
+ *
+ * Implementation of the gradient boosted tree ensemble for regression.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_REGRESSOR_IMPL_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_REGRESSOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "xgboost_regressor.hpp"
+
+namespace mlpack {
+
+template<typename LossFunction>
+XGBoostRegressor<LossFunction>::XGBoostRegressor(
+    const size_t numTrees,
+    const double learningRate,
+    const size_t maximumDepth,
+    const double minimumChildWeight,
+    const double minimumGain,
+    const double rowSubsample,
+    const double featureSubsample,
+    const LossFunction& loss) :
+    numTrees(numTrees),
+    learningRate(learningRate),
+    maximumDepth(maximumDepth),
+    minimumChildWeight(minimumChildWeight),
+    minimumGain(minimumGain),
+    rowSubsample(rowSubsample),
+    featureSubsample(featureSubsample),
+    loss(loss),
+    initialPrediction(0.0),
+    dimensionality(0)
+{
+  CheckParameters();
+}
+
+template<typename LossFunction>
+template<typename MatType, typename ResponsesType>
+XGBoostRegressor<LossFunction>::XGBoostRegressor(
+    const MatType& data,
+    const ResponsesType& responses,
+    const size_t numTrees,
+    const double learningRate,
+    const size_t maximumDepth,
+    const double minimumChildWeight,
+    const double minimumGain,
+    const double rowSubsample,
+    const double featureSubsample,
+    const LossFunction& loss,
+    const std::enable_if_t<arma::is_arma_type<MatType>::value>*) :
+    XGBoostRegressor(numTrees, learningRate, maximumDepth, minimumChildWeight,
+        minimumGain, rowSubsample, featureSubsample, loss)
+{
+  Train(data, responses);
+}
+
+template<typename LossFunction>
+template<typename MatType, typename ResponsesType>
+double XGBoostRegressor<LossFunction>::Train(const MatType& data,
+                                             const ResponsesType& responses)
+{
+  return Train(data, responses, LocalAllReduce());
+}
+
+template<typename LossFunction>
+template<typename MatType, typename ResponsesType, typename AllReduceType>
+double XGBoostRegressor<LossFunction>::Train(const MatType& data,
+                                             const ResponsesType& responses,
+                                             const AllReduceType& allReduce)
+{
+  return Train<false>(data, responses, data, responses, 0, allReduce);
+}
+
+template<typename LossFunction>
+template<typename MatType, typename ResponsesType>
+double XGBoostRegressor<LossFunction>::Train(
+    const MatType& data,
+    const ResponsesType& responses,
+    const MatType& validationData,
+    const ResponsesType& validationResponses,
+    const size_t earlyStoppingRounds)
+{
+  return Train(data, responses, validationData, validationResponses,
+      earlyStoppingRounds, LocalAllReduce());
+}
+
+template<typename LossFunction>
+template<typename MatType, typename ResponsesType, typename AllReduceType>
+double XGBoostRegressor<LossFunction>::Train(
+    const MatType& data,
+    const ResponsesType& responses,
+    const MatType& validationData,
+    const ResponsesType& validationResponses,
+    const size_t earlyStoppingRounds,
+    const AllReduceType& allReduce)
+{
+  if (earlyStoppingRounds == 0)
+  {
+    throw std::invalid_argument("XGBoostRegressor::Train(): "
+        "earlyStoppingRounds must be positive!");
+  }
+
+  util::CheckSameSizes(validationData, validationResponses,
+      "XGBoostRegressor::Train()", "validation responses");
+  util::CheckSameDimensionality(validationData, (size_t) data.n_rows,
+      "XGBoostRegressor::Train()", "validation dataset");
+
+  return Train<true>(data, responses, validationData, validationResponses,
+      earlyStoppingRounds, allReduce);
+}
+
+template<typename LossFunction>
+template<typename VecType>
+double XGBoostRegressor<LossFunction>::Predict(const VecType& point) const
+{
+  double prediction = initialPrediction;
+  for (size_t t = 0; t < trees.size(); ++t)
+    prediction += trees[t].Predict(point);
+
+  return prediction;
+}
+
+template<typename LossFunction>
+template<typename MatType>
+void XGBoostRegressor<LossFunction>::Predict(const MatType& data,
+                                             arma::rowvec& predictions) const
+{
+  util::CheckSameDimensionality(data, dimensionality,
+      "XGBoostRegressor::Predict()");
+
+  predictions.set_size(data.n_cols);
+
+  #pragma omp parallel for num_threads((int) NumThreads())
+  for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+    predictions[i] = Predict(data.col(i));
+}
+
+template<typename LossFunction>
+template<typename Archive>
+void XGBoostRegressor<LossFunction>::serialize(Archive& ar,
+                                               const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(numTrees));
+  ar(CEREAL_NVP(learningRate));
+  ar(CEREAL_NVP(maximumDepth));
+  ar(CEREAL_NVP(minimumChildWeight));
+  ar(CEREAL_NVP(minimumGain));
+  ar(CEREAL_NVP(rowSubsample));
+  ar(CEREAL_NVP(featureSubsample));
+  ar(CEREAL_NVP(loss));
+  ar(CEREAL_NVP(initialPrediction));
+  ar(CEREAL_NVP(dimensionality));
+  ar(CEREAL_NVP(trees));
+}
+
+template<typename LossFunction>
+template<bool UseValidation,
+         typename MatType,
+         typename ResponsesType,
+         typename AllReduceType>
+double XGBoostRegressor<LossFunction>::Train(
+    const MatType& data,
+    const ResponsesType& responses,
+    const MatType& validationData,
+    const ResponsesType& validationResponses,
+    const size_t earlyStoppingRounds,
+    const AllReduceType& allReduce)
+{
+  util::CheckSameSizes(data, responses, "XGBoostRegressor::Train()",
+      "responses");
+  if (data.n_cols == 0)
+  {
+    throw std::invalid_argument("XGBoostRegressor::Train(): cannot train on "
+        "an empty dataset!");
+  }
+  CheckParameters();
+
+  // Every shard must have the same dimensionality; this holds if and only if
+  // the mean of the squared dimensionalities is the squared mean.
+  if (allReduce.Size() > 1)
+  {
+    arma::mat dims(2, 1);
+    dims[0] = data.n_rows;
+    dims[1] = data.n_rows * data.n_rows;
+    allReduce.Sum(dims);
+    if (dims[0] * dims[0] != allReduce.Size() * dims[1])
+    {
+      throw std::invalid_argument("XGBoostRegressor::Train(): the shards of "
+          "the dataset do not have the same dimensionality!");
+    }
+  }
+
+  dimensionality = data.n_rows;
+  trees.clear();
+
+  arma::Mat<uint8_t> bins;
+  std::vector<arma::vec> binEdges;
+  Bin(data, bins, binEdges, allReduce);
+
+  // The initial prediction of SSELoss is a mean, so the initial prediction over
+  // all shards is the mean of the initial predictions of the shards.
+  const arma::rowvec y = arma::conv_to<arma::rowvec>::from(responses);
+  initialPrediction = GlobalMean(loss.InitialPrediction(y), data.n_cols,
+      allReduce);
+  arma::rowvec predictions(data.n_cols);
+  predictions.fill(initialPrediction);
+
+  arma::rowvec validationY, validationPredictions;
+  double bestLoss = 0.0;
+  size_t bestNumTrees = 0, roundsWithoutImprovement = 0;
+  if (UseValidation)
+  {
+    validationY = arma::conv_to<arma::rowvec>::from(validationResponses);
+    validationPredictions.set_size(validationData.n_cols);
+    validationPredictions.fill(initialPrediction);
+    bestLoss = GlobalMean(loss.Loss(validationY, validationPredictions),
+        validationData.n_cols, allReduce);
+  }
+
+  const size_t numRows = std::max((size_t) 1,
+      (size_t) std::round(rowSubsample * data.n_cols));
+  const size_t numDimensions = std::max((size_t) 1,
+      (size_t) std::round(featureSubsample * data.n_rows));
+
+  arma::vec gradients, hessians;
+  arma::uvec rows, dimensions;
+  for (size_t t = 0; t < numTrees; ++t)
+  {
+    loss.Gradients(y, predictions, gradients, hessians);
+
+    if (numRows < data.n_cols)
+      rows = arma::randperm(data.n_cols, numRows);
+    else
+      rows = arma::regspace<arma::uvec>(0, data.n_cols - 1);
+
+    if (numDimensions < data.n_rows)
+      dimensions = arma::sort(arma::randperm(data.n_rows, numDimensions));
+    else
+      dimensions = arma::regspace<arma::uvec>(0, data.n_rows - 1);
+
+    // All processes must split the same dimensions: use those of the first.
+    if (allReduce.Size() > 1 && numDimensions < data.n_rows)
+    {
+      arma::mat chosen = arma::conv_to<arma::mat>::from(dimensions);
+      AllReduceBroadcast(allReduce, chosen);
+      dimensions = arma::conv_to<arma::uvec>::from(chosen);
+    }
+
+    trees.push_back(XGBoostTree());
+    XGBoostTree& tree = trees.back();
+    tree.Train(bins, binEdges, gradients, hessians, rows, dimensions,
+        maximumDepth, minimumChildWeight, minimumGain, learningRate, loss,
+        allReduce);
+
+    #pragma omp parallel for num_threads((int) NumThreads())
+    for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+      predictions[i] += tree.Predict(data.col(i));
+
+    if (UseValidation)
+    {
+      #pragma omp parallel for num_threads((int) NumThreads())
+      for (size_t i = 0; i < (size_t) validationData.n_cols; ++i)
+        validationPredictions[i] += tree.Predict(validationData.col(i));
+
+      const double validationLoss = GlobalMean(loss.Loss(validationY,
+          validationPredictions), validationData.n_cols, allReduce);
+      Log::Debug << "XGBoostRegressor::Train(): validation loss after " << t + 1
+          << " trees: " << validationLoss << "." << std::endl;
+      if (validationLoss < bestLoss)
+      {
+        bestLoss = validationLoss;
+        bestNumTrees = trees.size();
+        roundsWithoutImprovement = 0;
+      }
+      else if (++roundsWithoutImprovement == earlyStoppingRounds)
+      {
+        Log::Info << "XGBoostRegressor::Train(): validation loss has not "
+            << "improved for " << earlyStoppingRounds << " trees; stopping "
+            << "after " << bestNumTrees << " trees." << std::endl;
+        break;
+      }
+    }
+  }
+
+  if (UseValidation)
+  {
+    trees.resize(bestNumTrees);
+    return bestLoss;
+  }
+
+  return GlobalMean(loss.Loss(y, predictions), data.n_cols, allReduce);
+}
+
+template<typename LossFunction>
+template<typename MatType, typename AllReduceType>
+void XGBoostRegressor<LossFunction>::Bin(const MatType& data,
+                                         arma::Mat<uint8_t>& bins,
+                                         std::vector<arma::vec>& binEdges,
+                                         const AllReduceType& allReduce)
+{
+  // The quantiles are those of a strided subsample of each dimension, so the
+  // full dimension is never sorted.
+  const size_t maxSampleSize = 64 * MaxBins;
+  const size_t stride = std::max((size_t) 1,
+      (size_t) (data.n_cols + maxSampleSize - 1) / maxSampleSize);
+
+  binEdges.resize(data.n_rows);
+
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t d = 0; d < (size_t) data.n_rows; ++d)
+  {
+    arma::vec sample((data.n_cols + stride - 1) / stride);
+    for (size_t i = 0, j = 0; i < data.n_cols; i += stride, ++j)
+      sample[j] = data(d, i);
+
+    arma::vec& edges = binEdges[d];
+    edges = arma::unique(sample);
+    if (edges.n_elem > MaxBins)
+    {
+      // Take the upper edge of each quantile bin of the sorted sample.
+      sample = arma::sort(sample);
+      arma::vec quantiles(MaxBins);
+      for (size_t q = 0; q < MaxBins; ++q)
+        quantiles[q] = sample[((q + 1) * sample.n_elem - 1) / MaxBins];
+      edges = arma::unique(quantiles);
+    }
+  }
+
+  if (allReduce.Size() > 1)
+    MergeBinEdges(data.n_cols, binEdges, allReduce);
+
+  bins.set_size(data.n_cols, data.n_rows);
+
+  #pragma omp parallel for schedule(static) num_threads((int) NumThreads())
+  for (size_t d = 0; d < (size_t) data.n_rows; ++d)
+  {
+    // Values larger than the largest edge of the subsample go in the last bin.
+    const arma::vec& edges = binEdges[d];
+    uint8_t* binCol = bins.colptr(d);
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      const size_t b = std::lower_bound(edges.begin(), edges.end(),
+          (double) data(d, i)) - edges.begin();
+      binCol[i] = (uint8_t) std::min(b, (size_t) edges.n_elem - 1);
+    }
+  }
+}
+
+template<typename LossFunction>
+template<typename AllReduceType>
+void XGBoostRegressor<LossFunction>::MergeBinEdges(
+    const size_t numPoints,
+    std::vector<arma::vec>& binEdges,
+    const AllReduceType& allReduce)
+{
+  // Gather the edges of every process by summing a matrix in which each
+  // process only fills its own columns.  The first two rows of each column hold
+  // the number of points and the number of edges of the shard.
+  const size_t numProcesses = allReduce.Size();
+  const size_t rank = allReduce.Rank();
+  arma::mat gathered(MaxBins + 2, binEdges.size() * numProcesses,
+      arma::fill::zeros);
+  for (size_t d = 0; d < binEdges.size(); ++d)
+  {
+    const size_t col = d * numProcesses + rank;
+    gathered(0, col) = numPoints;
+    gathered(1, col) = binEdges[d].n_elem;
+    gathered.submat(2, col, binEdges[d].n_elem + 1, col) = binEdges[d];
+  }
+  allReduce.Sum(gathered);
+
+  // Every process merges the same gathered edges, so they all get the same
+  // merged edges.
+  #pragma omp parallel for schedule(dynamic) num_threads((int) NumThreads())
+  for (size_t d = 0; d < binEdges.size(); ++d)
+  {
+    // Each edge of a shard stands for an equal share of its points.
+    std::vector<std::pair<double, double>> weightedEdges;
+    double totalWeight = 0.0;
+    for (size_t p = 0; p < numProcesses; ++p)
+    {
+      const size_t col = d * numProcesses + p;
+      const size_t numEdges = (size_t) gathered(1, col);
+      const double weight = gathered(0, col) / numEdges;
+      for (size_t e = 0; e < numEdges; ++e)
+        weightedEdges.push_back(std::make_pair(gathered(e + 2, col), weight));
+      totalWeight += gathered(0, col);
+    }
+    std::sort(weightedEdges.begin(), weightedEdges.end());
+
+    arma::vec unique(weightedEdges.size());
+    size_t numUnique = 0;
+    for (size_t e = 0; e < weightedEdges.size(); ++e)
+      if (numUnique == 0 || weightedEdges[e].first != unique[numUnique - 1])
+        unique[numUnique++] = weightedEdges[e].first;
+
+    if (numUnique <= MaxBins)
+    {
+      binEdges[d] = unique.head(numUnique);
+      continue;
+    }
+
+    // Take the upper edge of each weighted quantile bin; the largest edge is
+    // always kept.
+    arma::vec quantiles(MaxBins);
+    double cumulativeWeight = 0.0;
+    size_t e = 0;
+    for (size_t q = 0; q < MaxBins; ++q)
+    {
+      const double threshold = (q + 1) * totalWeight / MaxBins;
+      while (e + 1 < weightedEdges.size() &&
+          cumulativeWeight + weightedEdges[e].second < threshold)
+      {
+        cumulativeWeight += weightedEdges[e].second;
+        ++e;
+      }
+      quantiles[q] = weightedEdges[e].first;
+    }
+    quantiles[MaxBins - 1] = weightedEdges.back().first;
+    binEdges[d] = arma::unique(quantiles);
+  }
+}
+
+template<typename LossFunction>
+template<typename AllReduceType>
+double XGBoostRegressor<LossFunction>::GlobalMean(
+    const double localMean,
+    const size_t numPoints,
+    const AllReduceType& allReduce)
+{
+  if (allReduce.Size() == 1)
+    return localMean;
+
+  arma::mat sums(2, 1);
+  sums[0] = localMean * numPoints;
+  sums[1] = numPoints;
+  allReduce.Sum(sums);
+
+  return (sums[1] == 0.0) ? 0.0 : sums[0] / sums[1];
+}
+
+template<typename LossFunction>
+void XGBoostRegressor<LossFunction>::CheckParameters() const
+{
+  if (learningRate <= 0.0)
+  {
+    throw std::invalid_argument("XGBoostRegressor: learningRate must be "
+        "positive!");
+  }
+
+  if (minimumChildWeight < 0.0)
+  {
+    throw std::invalid_argument("XGBoostRegressor: minimumChildWeight must be "
+        "nonnegative!");
+  }
+
+  if (rowSubsample <= 0.0 || rowSubsample > 1.0)
+  {
+    throw std::invalid_argument("XGBoostRegressor: rowSubsample must be in "
+        "(0, 1]!");
+  }
+
+  if (featureSubsample <= 0.0 || featureSubsample > 1.0)
+  {
+    throw std::invalid_argument("XGBoostRegressor: featureSubsample must be in "
+        "(0, 1]!");
+  }
+}
+
+} // namespace mlpack
+
+#endif
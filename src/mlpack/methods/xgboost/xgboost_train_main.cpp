@@ -0,0 +1,195 @@
+/**
+ * @file methods/xgboost/xgboost_train_main.cpp
+ *
+ * A program to train gradient boosted trees for regression.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#undef BINDING_NAME
+#define BINDING_NAME xgboost_train
+
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "xgboost_model.hpp"
+
+using namespace mlpack;
+using namespace mlpack::util;
+using namespace std;
+
+// Program Name.
+BINDING_USER_NAME("Gradient Boosted Trees Training");
+
+// Short description.
+BINDING_SHORT_DESC(
+    "An implementation of gradient boosted regression trees, in the style of "
+    "XGBoost.  Given a dataset and responses, this trains an ensemble of "
+    "regression trees that can be saved and used for prediction with the "
+    "xgboost_predict binding.");
+
+// Long description.
+BINDING_LONG_DESC(
+    "This program trains an ensemble of gradient boosted regression trees on "
+    "the dataset given with the " + PRINT_PARAM_STRING("training") +
+    " parameter and the responses given with the " +
+    PRINT_PARAM_STRING("responses") + " parameter, minimizing the squared "
+    "error.  Each tree is fit to the gradients and hessians of the loss of the "
+    "predictions of the previous trees, and each leaf holds the second order "
+    "step for its points, scaled by the " + PRINT_PARAM_STRING("learning_rate")
+    + ".  The trees are grown from histograms of each dimension divided into at"
+    " most 256 quantile bins.  The trained model can be saved with the " +
+    PRINT_PARAM_STRING("output_model") + " output parameter."
+    "\n\n"
+    "The " + PRINT_PARAM_STRING("num_trees") + " parameter gives the number of "
+    "trees to train, the " + PRINT_PARAM_STRING("maximum_depth") + " parameter "
+    "the maximum depth of each tree, the " +
+    PRINT_PARAM_STRING("minimum_child_weight") + " parameter the minimum sum of"
+    " hessians (for the squared error, the number of points) in each leaf, and "
+    "the " + PRINT_PARAM_STRING("minimum_gain") + " parameter the minimum gain "
+    "of each split.  The values of the leaves are regularized with the L1 and "
+    "L2 penalties given by the " + PRINT_PARAM_STRING("alpha") + " and " +
+    PRINT_PARAM_STRING("lambda") + " parameters.  Each tree can be trained on "
+    "a random fraction of the points, given by " +
+    PRINT_PARAM_STRING("row_subsample") + ", and a random fraction of the "
+    "dimensions, given by " + PRINT_PARAM_STRING("feature_subsample") + "."
+    "\n\n"
+    "If a validation set is given with the " +
+    PRINT_PARAM_STRING("validation") + " and " +
+    PRINT_PARAM_STRING("validation_responses") + " parameters, training stops "
+    "when the squared error on the validation set has not improved for " +
+    PRINT_PARAM_STRING("early_stopping_rounds") + " trees, and only the trees "
+    "that gave the best validation error are kept.");
+
+// Example.
+BINDING_EXAMPLE(
+    "For example, to train 200 trees with a learning rate of 0.1 on the dataset"
+    " " + PRINT_DATASET("data") + " with responses " +
+    PRINT_DATASET("responses") + ", stopping early on the validation set " +
+    PRINT_DATASET("val") + " with responses " + PRINT_DATASET("val_responses") +
+    ", and saving the model to " + PRINT_MODEL("xgb_model") + ", one could "
+    "call"
+    "\n\n" +
+    PRINT_CALL("xgboost_train", "training", "data", "responses", "responses",
+        "validation", "val", "validation_responses", "val_responses",
+        "num_trees", 200, "learning_rate", 0.1, "output_model", "xgb_model"));
+
+// See also...
+BINDING_SEE_ALSO("@xgboost_predict", "#xgboost_predict");
+BINDING_SEE_ALSO("@random_forest", "#random_forest");
+BINDING_SEE_ALSO("Gradient boosting on Wikipedia",
+    "https://en.wikipedia.org/wiki/Gradient_boosting");
+BINDING_SEE_ALSO("XGBoost: A Scalable Tree Boosting System (pdf)",
+    "https://arxiv.org/pdf/1603.02754.pdf");
+BINDING_SEE_ALSO("XGBoostRegressor C++ class documentation",
+    "@src/mlpack/methods/xgboost/xgboost_regressor.hpp");
+
+PARAM_MATRIX_IN_REQ("training", "Training dataset.", "t");
+PARAM_ROW_IN("responses", "Responses for the training dataset.", "r");
+PARAM_MATRIX_IN("validation", "Validation dataset, for early stopping.", "v");
+PARAM_ROW_IN("validation_responses", "Responses for the validation dataset.",
+    "V");
+
+PARAM_INT_IN("num_trees", "Number of trees to train.", "N", 100);
+PARAM_DOUBLE_IN("learning_rate", "Factor the values of the leaves are scaled "
+    "by.", "e", 0.3);
+PARAM_INT_IN("maximum_depth", "Maximum depth of each tree (0 means no limit).",
+    "D", 6);
+PARAM_DOUBLE_IN("minimum_child_weight", "Minimum sum of hessians in each "
+    "leaf.", "w", 1.0);
+PARAM_DOUBLE_IN("minimum_gain", "Minimum gain of each split.", "g", 0.0);
+PARAM_DOUBLE_IN("row_subsample", "Fraction of the points each tree is trained "
+    "on.", "R", 1.0);
+PARAM_DOUBLE_IN("feature_subsample", "Fraction of the dimensions each tree can"
+    " split.", "F", 1.0);
+PARAM_DOUBLE_IN("alpha", "L1 regularization of the leaf values.", "a", 0.0);
+PARAM_DOUBLE_IN("lambda", "L2 regularization of the leaf values.", "l", 1.0);
+PARAM_INT_IN("early_stopping_rounds", "Number of trees without improvement of "
+    "the validation error before training stops.", "E", 10);
+
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+PARAM_MODEL_OUT(XGBoostModel, "output_model", "Output for trained gradient "
+    "boosted trees model.", "M");
+
+void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
+{
+  // Initialize random seed if needed.
+  if (params.Get<int>("seed") != 0)
+    RandomSeed((size_t) params.Get<int>("seed"));
+  else
+    RandomSeed((size_t) std::time(NULL));
+
+  RequireAtLeastOnePassed(params, { "responses" }, true, "must pass "
+      "responses for the training set");
+  RequireAtLeastOnePassed(params, { "output_model" }, false, "no model will "
+      "be saved");
+  RequireNoneOrAllPassed(params, { "validation", "validation_responses" },
+      true);
+  ReportIgnoredParam(params, {{ "validation", false }},
+      "early_stopping_rounds");
+
+  RequireParamValue<int>(params, "num_trees", [](int x) { return x > 0; },
+      true, "number of trees must be positive");
+  RequireParamValue<double>(params, "learning_rate",
+      [](double x) { return x > 0.0; }, true, "learning rate must be "
+      "positive");
+  RequireParamValue<int>(params, "maximum_depth", [](int x) { return x >= 0; },
+      true, "maximum depth must be non-negative");
+  RequireParamValue<double>(params, "minimum_child_weight",
+      [](double x) { return x >= 0.0; }, true, "minimum child weight must be "
+      "non-negative");
+  RequireParamValue<double>(params, "row_subsample",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true, "row subsample must "
+      "be in (0, 1]");
+  RequireParamValue<double>(params, "feature_subsample",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true, "feature subsample "
+      "must be in (0, 1]");
+  RequireParamValue<double>(params, "alpha", [](double x) { return x >= 0.0; },
+      true, "alpha must be non-negative");
+  RequireParamValue<double>(params, "lambda", [](double x) { return x >= 0.0; },
+      true, "lambda must be non-negative");
+  if (params.Has("validation"))
+  {
+    RequireParamValue<int>(params, "early_stopping_rounds",
+        [](int x) { return x > 0; }, true, "number of early stopping rounds "
+        "must be positive");
+  }
+
+  arma::mat& data = params.Get<arma::mat>("training");
+  arma::rowvec& responses = params.Get<arma::rowvec>("responses");
+
+  XGBoostModel* model = new XGBoostModel();
+  model->xgb = XGBoostRegressor<>((size_t) params.Get<int>("num_trees"),
+      params.Get<double>("learning_rate"),
+      (size_t) params.Get<int>("maximum_depth"),
+      params.Get<double>("minimum_child_weight"),
+      params.Get<double>("minimum_gain"),
+      params.Get<double>("row_subsample"),
+      params.Get<double>("feature_subsample"),
+      SSELoss(params.Get<double>("alpha"), params.Get<double>("lambda")));
+
+  timers.Start("xgboost_training");
+  if (params.Has("validation"))
+  {
+    arma::mat& validation = params.Get<arma::mat>("validation");
+    arma::rowvec& validationResponses =
+        params.Get<arma::rowvec>("validation_responses");
+    const double loss = model->xgb.Train(data, responses, validation,
+        validationResponses,
+        (size_t) params.Get<int>("early_stopping_rounds"));
+    Log::Info << "Kept " << model->xgb.NumTreesTrained() << " trees, with a "
+        << "validation loss of " << loss << "." << endl;
+  }
+  else
+  {
+    const double loss = model->xgb.Train(data, responses);
+    Log::Info << "Trained " << model->xgb.NumTreesTrained() << " trees, with "
+        << "a training loss of " << loss << "." << endl;
+  }
+  timers.Stop("xgboost_training");
+
+  params.Get<XGBoostModel*>("output_model") = model;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file methods/xgboost/xgboost_tree.hpp
+ *
+ * A regression tree for gradient boosting, grown from histograms of the
+ * gradients and hessians of a loss function over binned data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_TREE_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/core/util/all_reduce.hpp>
+
+namespace mlpack {
+
+/**
+ * The XGBoostTree is one tree of a gradient boosted ensemble, as in the XGBoost
+ * and LightGBM algorithms.  The tree is not trained on the data itself, but on
+ * the first and second order gradients (the gradients and hessians) of the loss
+ * of the current predictions of the ensemble, and on a binned version of the
+ * data, where each value is replaced by the index of the quantile bin it falls
+ * in.  The tree is grown depth-first; for each node, the sums of the gradients
+ * and hessians of its points are accumulated into one histogram per dimension,
+ * whose prefix sums give the gain of every candidate split.  Only the
+ * histograms of the smaller child of each split are built from the data; those
+ * of the other child are the difference between the histograms of the parent
+ * and of the smaller child.  The histograms of the dimensions are built in
+ * parallel with OpenMP.
+ *
+ * The points can also be sharded across several processes, given an all-reduce
+ * policy (see LocalAllReduce).  Each process then builds the histograms of its
+ * own points, which are summed over all processes before the split of each
+ * node is chosen; so every process grows the same tree, and only histograms are
+ * communicated.
+ *
+ * The output value of each leaf is the leaf value of the loss function (the
+ * second order Newton step, for the sums of the gradients and hessians of the
+ * points in the leaf), scaled by the learning rate.
+ */
+class XGBoostTree
+{
+ public:
+  /**
+   * Create an empty tree, whose prediction is 0 for every point.
+   */
+  XGBoostTree() { }
+
+  /**
+   * Train the tree on the given binned data, gradients, and hessians.  Bin b of
+   * dimension d holds the values that are not greater than binEdges[d][b] (and
+   * greater than binEdges[d][b - 1]), so a split after bin b sends the points
+   * whose value in dimension d is at most binEdges[d][b] to the left child.
+   *
+   * @param bins Bin of each value of the data, with one row per point and one
+   *     column per dimension.
+   * @param binEdges Upper edge of each bin of each dimension.
+   * @param gradients Gradient of the loss for each point.
+   * @param hessians Hessian of the loss for each point.
+   * @param rows Indices of the points to train the tree on (will be
+   *     reordered).
+   * @param dimensions Dimensions that splits can be made in.
+   * @param maximumDepth Maximum depth of the tree (0 means no limit).
+   * @param minimumChildWeight Minimum sum of hessians in each child of a split.
+   * @param minimumGain Minimum gain of a split.
+   * @param learningRate Factor the value of each leaf is scaled by.
+   * @param loss Loss function, which gives the gain and value of the leaves.
+   * @param allReduce All-reduce policy, to sum the histograms over processes.
+   */
+  template<typename LossFunction, typename AllReduceType = LocalAllReduce>
+  void Train(const arma::Mat<uint8_t>& bins,
+             const std::vector<arma::vec>& binEdges,
+             const arma::vec& gradients,
+             const arma::vec& hessians,
+             arma::uvec& rows,
+             const arma::uvec& dimensions,
+             const size_t maximumDepth,
+             const double minimumChildWeight,
+             const double minimumGain,
+             const double learningRate,
+             const LossFunction& loss,
+             const AllReduceType& allReduce = AllReduceType());
+
+  /**
+   * Predict the response of the given point.
+   *
+   * @param point Point to predict the response of.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const;
+
+  //! Get the number of nodes in the tree.
+  size_t NumNodes() const { return nodes.size(); }
+
+  //! Get the number of leaves in the tree.
+  size_t NumLeaves() const;
+
+  //! Serialize the tree.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  // A node of the tree.  The root is the first node; a node is a leaf if its
+  // left child is 0.
+  struct Node
+  {
+    Node() : splitDimension(0), splitValue(0.0), left(0), right(0), value(0.0)
+    { }
+
+    //! The dimension of the split (for an internal node).
+    size_t splitDimension;
+    //! Points not greater than this value go to the left child.
+    double splitValue;
+    //! Index of the left child.
+    size_t left;
+    //! Index of the right child.
+    size_t right;
+    //! Output value (for a leaf).
+    double value;
+
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      ar(CEREAL_NVP(splitDimension));
+      ar(CEREAL_NVP(splitValue));
+      ar(CEREAL_NVP(left));
+      ar(CEREAL_NVP(right));
+      ar(CEREAL_NVP(value));
+    }
+  };
+
+  /**
+   * Grow the subtree for the points rows[begin, end), whose histograms are
+   * given, and return the index of its root.  The histograms are modified.
+   */
+  template<typename LossFunction, typename AllReduceType>
+  size_t Grow(const arma::Mat<uint8_t>& bins,
+              const std::vector<arma::vec>& binEdges,
+              const arma::vec& gradients,
+              const arma::vec& hessians,
+              arma::uvec& rows,
+              const size_t begin,
+              const size_t end,
+              const arma::uvec& dimensions,
+              arma::mat& gradientHist,
+              arma::mat& hessianHist,
+              const double sumGradients,
+              const double sumHessians,
+              const size_t depth,
+              const size_t maximumDepth,
+              const double minimumChildWeight,
+              const double minimumGain,
+              const double learningRate,
+              const LossFunction& loss,
+              const AllReduceType& allReduce);
+
+  /**
+   * Build the histograms of the gradients and hessians of the points
+   * rows[begin, end), with one column per dimension in the given list.
+   */
+  static void BuildHistograms(const arma::Mat<uint8_t>& bins,
+                              const arma::vec& gradients,
+                              const arma::vec& hessians,
+                              const arma::uvec& rows,
+                              const size_t begin,
+                              const size_t end,
+                              const arma::uvec& dimensions,
+                              const size_t numBins,
+                              arma::mat& gradientHist,
+                              arma::mat& hessianHist);
+
+  /**
+   * Sum the given histograms over all processes, with a single call to the
+   * all-reduce policy.
+   */
+  template<typename AllReduceType>
+  static void SumHistograms(arma::mat& gradientHist,
+                            arma::mat& hessianHist,
+                            const AllReduceType& allReduce);
+
+  //! The nodes of the tree.
+  std::vector<Node> nodes;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "xgboost_tree_impl.hpp"
+
+#endif
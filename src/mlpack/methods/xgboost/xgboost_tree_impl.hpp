@@ -0,0 +1,259 @@
+/**
+ * @file methods/xgboost/xgboost_tree_impl.hpp
+ *
+ * Implementation of the histogram-based regression tree for gradient boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_TREE_IMPL_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "xgboost_tree.hpp"
+
+namespace mlpack {
+
+template<typename LossFunction, typename AllReduceType>
+void XGBoostTree::Train(const arma::Mat<uint8_t>& bins,
+                        const std::vector<arma::vec>& binEdges,
+                        const arma::vec& gradients,
+                        const arma::vec& hessians,
+                        arma::uvec& rows,
+                        const arma::uvec& dimensions,
+                        const size_t maximumDepth,
+                        const double minimumChildWeight,
+                        const double minimumGain,
+                        const double learningRate,
+                        const LossFunction& loss,
+                        const AllReduceType& allReduce)
+{
+  nodes.clear();
+
+  size_t numBins = 1;
+  for (size_t k = 0; k < dimensions.n_elem; ++k)
+    numBins = std::max(numBins, (size_t) binEdges[dimensions[k]].n_elem);
+
+  arma::mat gradientHist, hessianHist;
+  BuildHistograms(bins, gradients, hessians, rows, 0, rows.n_elem, dimensions,
+      numBins, gradientHist, hessianHist);
+  SumHistograms(gradientHist, hessianHist, allReduce);
+
+  arma::mat sums(2, 1, arma::fill::zeros);
+  for (size_t i = 0; i < rows.n_elem; ++i)
+  {
+    sums[0] += gradients[rows[i]];
+    sums[1] += hessians[rows[i]];
+  }
+  allReduce.Sum(sums);
+
+  Grow(bins, binEdges, gradients, hessians, rows, 0, rows.n_elem, dimensions,
+      gradientHist, hessianHist, sums[0], sums[1], 0, maximumDepth,
+      minimumChildWeight, minimumGain, learningRate, loss, allReduce);
+}
+
+template<typename VecType>
+double XGBoostTree::Predict(const VecType& point) const
+{
+  if (nodes.empty())
+    return 0.0;
+
+  size_t i = 0;
+  while (nodes[i].left != 0)
+  {
+    i = (point[nodes[i].splitDimension] <= nodes[i].splitValue) ?
+        nodes[i].left : nodes[i].right;
+  }
+
+  return nodes[i].value;
+}
+
+inline size_t XGBoostTree::NumLeaves() const
+{
+  size_t leaves = 0;
+  for (size_t i = 0; i < nodes.size(); ++i)
+    if (nodes[i].left == 0)
+      ++leaves;
+
+  return leaves;
+}
+
+template<typename Archive>
+void XGBoostTree::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(nodes));
+}
+
+template<typename LossFunction, typename AllReduceType>
+size_t XGBoostTree::Grow(const arma::Mat<uint8_t>& bins,
+                         const std::vector<arma::vec>& binEdges,
+                         const arma::vec& gradients,
+                         const arma::vec& hessians,
+                         arma::uvec& rows,
+                         const size_t begin,
+                         const size_t end,
+                         const arma::uvec& dimensions,
+                         arma::mat& gradientHist,
+                         arma::mat& hessianHist,
+                         const double sumGradients,
+                         const double sumHessians,
+                         const size_t depth,
+                         const size_t maximumDepth,
+                         const double minimumChildWeight,
+                         const double minimumGain,
+                         const double learningRate,
+                         const LossFunction& loss,
+                         const AllReduceType& allReduce)
+{
+  const size_t index = nodes.size();
+  nodes.push_back(Node());
+
+  // Find the best split among the boundaries of the bins of every dimension.
+  // When the points are sharded, the decision only depends on the summed
+  // histograms, so that every process makes the same one.
+  const bool distributed = (allReduce.Size() > 1);
+  double bestGain = minimumGain;
+  size_t bestDimension = dimensions.n_elem; // Invalid value.
+  size_t bestBin = 0;
+  double bestLeftGradients = 0.0, bestLeftHessians = 0.0;
+  if ((maximumDepth == 0 || depth < maximumDepth) &&
+      (distributed || end - begin > 1))
+  {
+    const double parentGain = loss.Gain(sumGradients, sumHessians);
+    for (size_t k = 0; k < dimensions.n_elem; ++k)
+    {
+      const size_t numBins = binEdges[dimensions[k]].n_elem;
+      double leftGradients = 0.0, leftHessians = 0.0;
+      for (size_t b = 0; b + 1 < numBins; ++b)
+      {
+        leftGradients += gradientHist(b, k);
+        leftHessians += hessianHist(b, k);
+
+        const double rightGradients = sumGradients - leftGradients;
+        const double rightHessians = sumHessians - leftHessians;
+        if (leftHessians < minimumChildWeight || leftHessians <= 0.0)
+          continue;
+        if (rightHessians < minimumChildWeight || rightHessians <= 0.0)
+          break;
+
+        const double gain = 0.5 * (loss.Gain(leftGradients, leftHessians) +
+            loss.Gain(rightGradients, rightHessians) - parentGain);
+        if (gain > bestGain)
+        {
+          bestGain = gain;
+          bestDimension = k;
+          bestBin = b;
+          bestLeftGradients = leftGradients;
+          bestLeftHessians = leftHessians;
+        }
+      }
+    }
+  }
+
+  if (bestDimension == dimensions.n_elem)
+  {
+    nodes[index].value = learningRate * loss.LeafValue(sumGradients,
+        sumHessians);
+    return index;
+  }
+
+  // Partition the points between the children.
+  const size_t dimension = dimensions[bestDimension];
+  const uint8_t* binCol = bins.colptr(dimension);
+  const size_t mid = std::partition(rows.begin() + begin, rows.begin() + end,
+      [&](const arma::uword r) { return binCol[r] <= bestBin; }) -
+      rows.begin();
+
+  nodes[index].splitDimension = dimension;
+  nodes[index].splitValue = binEdges[dimension][bestBin];
+
+  // Only build the histograms of the smaller child; those of the larger child
+  // are what is left of the histograms of this node.  When the points are
+  // sharded, the local sizes of the children may differ between processes, so
+  // the smaller child is the one with the smaller global sum of hessians (for
+  // SSELoss, the one with fewer points).
+  const bool leftSmaller = distributed ?
+      (bestLeftHessians <= sumHessians - bestLeftHessians) :
+      (mid - begin <= end - mid);
+  arma::mat smallGradientHist, smallHessianHist;
+  BuildHistograms(bins, gradients, hessians, rows, leftSmaller ? begin : mid,
+      leftSmaller ? mid : end, dimensions, gradientHist.n_rows,
+      smallGradientHist, smallHessianHist);
+  SumHistograms(smallGradientHist, smallHessianHist, allReduce);
+  gradientHist -= smallGradientHist;
+  hessianHist -= smallHessianHist;
+
+  arma::mat& leftGradientHist = leftSmaller ? smallGradientHist : gradientHist;
+  arma::mat& leftHessianHist = leftSmaller ? smallHessianHist : hessianHist;
+  arma::mat& rightGradientHist = leftSmaller ? gradientHist : smallGradientHist;
+  arma::mat& rightHessianHist = leftSmaller ? hessianHist : smallHessianHist;
+
+  // The nodes may be reallocated while the children are grown, so the indices
+  // of the children are only stored afterwards.
+  const size_t left = Grow(bins, binEdges, gradients, hessians, rows, begin,
+      mid, dimensions, leftGradientHist, leftHessianHist, bestLeftGradients,
+      bestLeftHessians, depth + 1, maximumDepth, minimumChildWeight,
+      minimumGain, learningRate, loss, allReduce);
+  const size_t right = Grow(bins, binEdges, gradients, hessians, rows, mid,
+      end, dimensions, rightGradientHist, rightHessianHist,
+      sumGradients - bestLeftGradients, sumHessians - bestLeftHessians,
+      depth + 1, maximumDepth, minimumChildWeight, minimumGain, learningRate,
+      loss, allReduce);
+  nodes[index].left = left;
+  nodes[index].right = right;
+
+  return index;
+}
+
+inline void XGBoostTree::BuildHistograms(const arma::Mat<uint8_t>& bins,
+                                         const arma::vec& gradients,
+                                         const arma::vec& hessians,
+                                         const arma::uvec& rows,
+                                         const size_t begin,
+                                         const size_t end,
+                                         const arma::uvec& dimensions,
+                                         const size_t numBins,
+                                         arma::mat& gradientHist,
+                                         arma::mat& hessianHist)
+{
+  gradientHist.zeros(numBins, dimensions.n_elem);
+  hessianHist.zeros(numBins, dimensions.n_elem);
+
+  // Each thread fills the histograms of different dimensions, so no
+  // synchronization is needed.  Parallelism does not pay off for small nodes.
+  #pragma omp parallel for schedule(static) \
+      if ((end - begin) * dimensions.n_elem >= 16384) \
+      num_threads((int) NumThreads())
+  for (size_t k = 0; k < (size_t) dimensions.n_elem; ++k)
+  {
+    const uint8_t* binCol = bins.colptr(dimensions[k]);
+    double* gradientCol = gradientHist.colptr(k);
+    double* hessianCol = hessianHist.colptr(k);
+    for (size_t i = begin; i < end; ++i)
+    {
+      const arma::uword r = rows[i];
+      gradientCol[binCol[r]] += gradients[r];
+      hessianCol[binCol[r]] += hessians[r];
+    }
+  }
+}
+
+template<typename AllReduceType>
+void XGBoostTree::SumHistograms(arma::mat& gradientHist,
+                                arma::mat& hessianHist,
+                                const AllReduceType& allReduce)
+{
+  if (allReduce.Size() == 1)
+    return;
+
+  arma::mat hist = arma::join_rows(gradientHist, hessianHist);
+  allReduce.Sum(hist);
+  gradientHist = hist.cols(0, gradientHist.n_cols - 1);
+  hessianHist = hist.cols(gradientHist.n_cols, hist.n_cols - 1);
+}
+
+} // namespace mlpack
+
+#endif
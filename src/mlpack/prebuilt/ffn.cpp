@@ -0,0 +1,45 @@
+/**
+ * @file prebuilt/ffn.cpp
+ *
+ * Explicit instantiations of the default FFN types and of the common layer
+ * types.
+ *
+ * These are compiled into libmlpack when the BUILD_PREBUILT_LIBRARY CMake
+ * option is set; programs that define MLPACK_USE_PREBUILT declare them extern
+ * and link against libmlpack instead of instantiating them again.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/methods/ann.hpp>
+
+namespace mlpack {
+
+template class Layer<arma::mat>;
+template class MultiLayer<arma::mat>;
+template class LinearType<arma::mat, NoRegularizer>;
+template class LinearNoBiasType<arma::mat, NoRegularizer>;
+template class BaseLayer<LogisticFunction, arma::mat>;
+template class BaseLayer<RectifierFunction, arma::mat>;
+template class BaseLayer<TanhFunction, arma::mat>;
+template class LeakyReLUType<arma::mat>;
+template class IdentityType<arma::mat>;
+template class DropoutType<arma::mat>;
+template class BatchNormType<arma::mat>;
+template class SoftmaxType<arma::mat>;
+template class LogSoftMaxType<arma::mat>;
+template class ConvolutionType<
+    Im2ColConvolution<ValidConvolution>,
+    Im2ColConvolution<FullConvolution>,
+    Im2ColConvolution<ValidConvolution>,
+    arma::mat>;
+template class MaxPoolingType<arma::mat>;
+template class MeanPoolingType<arma::mat>;
+
+template class FFN<NegativeLogLikelihood, RandomInitialization,
+    arma::mat>;
+template class FFN<MeanSquaredError, RandomInitialization, arma::mat>;
+
+} // namespace mlpack
@@ -0,0 +1,81 @@
+/**
+ * @file prebuilt/kde.cpp
+ *
+ * Explicit instantiations of the KDE types held by KDEModel, and of the default
+ * KDE type.
+ *
+ * These are compiled into libmlpack when the BUILD_PREBUILT_LIBRARY CMake
+ * option is set; programs that define MLPACK_USE_PREBUILT declare them extern
+ * and link against libmlpack instead of instantiating them again.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/methods/kde/kde.hpp>
+#include <mlpack/methods/kde/kde_model.hpp>
+
+namespace mlpack {
+
+template class KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree>;
+
+template class KDEWrapper<GaussianKernel, KDTree, arma::mat>;
+template class KDEWrapper<EpanechnikovKernel, KDTree, arma::mat>;
+template class KDEWrapper<LaplacianKernel, KDTree, arma::mat>;
+template class KDEWrapper<SphericalKernel, KDTree, arma::mat>;
+template class KDEWrapper<TriangularKernel, KDTree, arma::mat>;
+template class KDEWrapper<GaussianKernel, BallTree, arma::mat>;
+template class KDEWrapper<EpanechnikovKernel, BallTree, arma::mat>;
+template class KDEWrapper<LaplacianKernel, BallTree, arma::mat>;
+template class KDEWrapper<SphericalKernel, BallTree, arma::mat>;
+template class KDEWrapper<TriangularKernel, BallTree, arma::mat>;
+template class KDEWrapper<GaussianKernel, StandardCoverTree, arma::mat>;
+template class KDEWrapper<EpanechnikovKernel, StandardCoverTree,
+    arma::mat>;
+template class KDEWrapper<LaplacianKernel, StandardCoverTree, arma::mat>;
+template class KDEWrapper<SphericalKernel, StandardCoverTree, arma::mat>;
+template class KDEWrapper<TriangularKernel, StandardCoverTree,
+    arma::mat>;
+template class KDEWrapper<GaussianKernel, Octree, arma::mat>;
+template class KDEWrapper<EpanechnikovKernel, Octree, arma::mat>;
+template class KDEWrapper<LaplacianKernel, Octree, arma::mat>;
+template class KDEWrapper<SphericalKernel, Octree, arma::mat>;
+template class KDEWrapper<TriangularKernel, Octree, arma::mat>;
+template class KDEWrapper<GaussianKernel, RTree, arma::mat>;
+template class KDEWrapper<EpanechnikovKernel, RTree, arma::mat>;
+template class KDEWrapper<LaplacianKernel, RTree, arma::mat>;
+template class KDEWrapper<SphericalKernel, RTree, arma::mat>;
+template class KDEWrapper<TriangularKernel, RTree, arma::mat>;
+
+template class KDEWrapper<GaussianKernel, KDTree, arma::fmat>;
+template class KDEWrapper<EpanechnikovKernel, KDTree, arma::fmat>;
+template class KDEWrapper<LaplacianKernel, KDTree, arma::fmat>;
+template class KDEWrapper<SphericalKernel, KDTree, arma::fmat>;
+template class KDEWrapper<TriangularKernel, KDTree, arma::fmat>;
+template class KDEWrapper<GaussianKernel, BallTree, arma::fmat>;
+template class KDEWrapper<EpanechnikovKernel, BallTree, arma::fmat>;
+template class KDEWrapper<LaplacianKernel, BallTree, arma::fmat>;
+template class KDEWrapper<SphericalKernel, BallTree, arma::fmat>;
+template class KDEWrapper<TriangularKernel, BallTree, arma::fmat>;
+template class KDEWrapper<GaussianKernel, StandardCoverTree, arma::fmat>;
+template class KDEWrapper<EpanechnikovKernel, StandardCoverTree,
+    arma::fmat>;
+template class KDEWrapper<LaplacianKernel, StandardCoverTree,
+    arma::fmat>;
+template class KDEWrapper<SphericalKernel, StandardCoverTree,
+    arma::fmat>;
+template class KDEWrapper<TriangularKernel, StandardCoverTree,
+    arma::fmat>;
+template class KDEWrapper<GaussianKernel, Octree, arma::fmat>;
+template class KDEWrapper<EpanechnikovKernel, Octree, arma::fmat>;
+template class KDEWrapper<LaplacianKernel, Octree, arma::fmat>;
+template class KDEWrapper<SphericalKernel, Octree, arma::fmat>;
+template class KDEWrapper<TriangularKernel, Octree, arma::fmat>;
+template class KDEWrapper<GaussianKernel, RTree, arma::fmat>;
+template class KDEWrapper<EpanechnikovKernel, RTree, arma::fmat>;
+template class KDEWrapper<LaplacianKernel, RTree, arma::fmat>;
+template class KDEWrapper<SphericalKernel, RTree, arma::fmat>;
+template class KDEWrapper<TriangularKernel, RTree, arma::fmat>;
+
+} // namespace mlpack
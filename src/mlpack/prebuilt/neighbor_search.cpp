@@ -0,0 +1,29 @@
+/**
+ * @file prebuilt/neighbor_search.cpp
+ *
+ * Explicit instantiations of the neighbor search types held by NSModel, and of
+ * the KNN and KFN types.
+ *
+ * These are compiled into libmlpack when the BUILD_PREBUILT_LIBRARY CMake
+ * option is set; programs that define MLPACK_USE_PREBUILT declare them extern
+ * and link against libmlpack instead of instantiating them again.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/neighbor_search/ns_model.hpp>
+
+namespace mlpack {
+
+template class NeighborSearch<NearestNeighborSort, EuclideanDistance,
+    arma::mat, KDTree>;
+template class NeighborSearch<FurthestNeighborSort, EuclideanDistance,
+    arma::mat, KDTree>;
+
+template class NSModel<NearestNeighborSort>;
+template class NSModel<FurthestNeighborSort>;
+
+} // namespace mlpack
@@ -0,0 +1,67 @@
+/**
+ * @file prebuilt/range_search.cpp
+ *
+ * Explicit instantiations of the range search types held by RSModel, and of
+ * the default RangeSearch type.
+ *
+ * These are compiled into libmlpack when the BUILD_PREBUILT_LIBRARY CMake
+ * option is set; programs that define MLPACK_USE_PREBUILT declare them extern
+ * and link against libmlpack instead of instantiating them again.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/methods/range_search/range_search.hpp>
+#include <mlpack/methods/range_search/rs_model.hpp>
+
+namespace mlpack {
+
+template class RangeSearch<EuclideanDistance, arma::mat, KDTree>;
+
+template class RSWrapper<KDTree, arma::mat>;
+template class RSWrapper<StandardCoverTree, arma::mat>;
+template class RSWrapper<RTree, arma::mat>;
+template class RSWrapper<RStarTree, arma::mat>;
+template class RSWrapper<BallTree, arma::mat>;
+template class RSWrapper<XTree, arma::mat>;
+template class RSWrapper<HilbertRTree, arma::mat>;
+template class RSWrapper<RPlusTree, arma::mat>;
+template class RSWrapper<RPlusPlusTree, arma::mat>;
+template class RSWrapper<VPTree, arma::mat>;
+template class RSWrapper<RPTree, arma::mat>;
+template class RSWrapper<MaxRPTree, arma::mat>;
+template class RSWrapper<UBTree, arma::mat>;
+template class RSWrapper<Octree, arma::mat>;
+template class LeafSizeRSWrapper<KDTree, arma::mat>;
+template class LeafSizeRSWrapper<BallTree, arma::mat>;
+template class LeafSizeRSWrapper<VPTree, arma::mat>;
+template class LeafSizeRSWrapper<RPTree, arma::mat>;
+template class LeafSizeRSWrapper<MaxRPTree, arma::mat>;
+template class LeafSizeRSWrapper<UBTree, arma::mat>;
+template class LeafSizeRSWrapper<Octree, arma::mat>;
+
+template class RSWrapper<KDTree, arma::fmat>;
+template class RSWrapper<StandardCoverTree, arma::fmat>;
+template class RSWrapper<RTree, arma::fmat>;
+template class RSWrapper<RStarTree, arma::fmat>;
+template class RSWrapper<BallTree, arma::fmat>;
+template class RSWrapper<XTree, arma::fmat>;
+template class RSWrapper<HilbertRTree, arma::fmat>;
+template class RSWrapper<RPlusTree, arma::fmat>;
+template class RSWrapper<RPlusPlusTree, arma::fmat>;
+template class RSWrapper<VPTree, arma::fmat>;
+template class RSWrapper<RPTree, arma::fmat>;
+template class RSWrapper<MaxRPTree, arma::fmat>;
+template class RSWrapper<UBTree, arma::fmat>;
+template class RSWrapper<Octree, arma::fmat>;
+template class LeafSizeRSWrapper<KDTree, arma::fmat>;
+template class LeafSizeRSWrapper<BallTree, arma::fmat>;
+template class LeafSizeRSWrapper<VPTree, arma::fmat>;
+template class LeafSizeRSWrapper<RPTree, arma::fmat>;
+template class LeafSizeRSWrapper<MaxRPTree, arma::fmat>;
+template class LeafSizeRSWrapper<UBTree, arma::fmat>;
+template class LeafSizeRSWrapper<Octree, arma::fmat>;
+
+} // namespace mlpack
@@ -1019,6 +1019,61 @@ TEMPLATE_TEST_CASE("AdaBoostSinglePointClassifyWithProbs", "[AdaBoostTest]",
   }
 }
 
+// Make sure that batch classification, which classifies blocks of points in
+// parallel, gives the same results as single-point classification.
+TEMPLATE_TEST_CASE("AdaBoostBatchClassifyTest", "[AdaBoostTest]", mat, fmat)
+{
+  typedef TestType MatType;
+  typedef typename MatType::elem_type eT;
+
+  // Use enough points that there are several blocks, the last one partial.
+  MatType data = randu<MatType>(10, 1000);
+  Row<size_t> labels = randi<Row<size_t>>(1000, distr_param(0, 3));
+
+  typedef Perceptron<SimpleWeightUpdate, ZeroInitialization, MatType>
+      PerceptronType;
+  AdaBoost<PerceptronType, MatType> ab(data, labels, 4);
+  AdaBoost<ID3DecisionStump, MatType> abStump(data, labels, 4, 50);
+
+  Row<size_t> predictions, stumpPredictions;
+  Mat<eT> probabilities, stumpProbabilities;
+  ab.Classify(data, predictions, probabilities);
+  abStump.Classify(data, stumpPredictions, stumpProbabilities);
+
+  REQUIRE(predictions.n_elem == 1000);
+  REQUIRE(probabilities.n_rows == 4);
+  REQUIRE(probabilities.n_cols == 1000);
+  REQUIRE(stumpPredictions.n_elem == 1000);
+  REQUIRE(stumpProbabilities.n_rows == 4);
+  REQUIRE(stumpProbabilities.n_cols == 1000);
+
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    size_t prediction;
+    Row<eT> pointProbabilities;
+    ab.Classify(data.col(i), prediction, pointProbabilities);
+    REQUIRE(predictions[i] == prediction);
+    for (size_t c = 0; c < 4; ++c)
+    {
+      REQUIRE(probabilities(c, i) ==
+          Approx(pointProbabilities[c]).epsilon(1e-4).margin(1e-5));
+    }
+
+    abStump.Classify(data.col(i), prediction, pointProbabilities);
+    REQUIRE(stumpPredictions[i] == prediction);
+    for (size_t c = 0; c < 4; ++c)
+    {
+      REQUIRE(stumpProbabilities(c, i) ==
+          Approx(pointProbabilities[c]).epsilon(1e-4).margin(1e-5));
+    }
+  }
+
+  // The overload without probabilities must give the same predictions.
+  Row<size_t> predictionsOnly;
+  ab.Classify(data, predictionsOnly);
+  REQUIRE(all(predictionsOnly == predictions));
+}
+
 // Make sure that everything works when we use the constructor that takes extra
 // hyperparameters.
 TEMPLATE_TEST_CASE("AdaBoostParamsConstructor", "[AdaBoostTest]", fmat, mat)
@@ -1104,3 +1159,35 @@ TEMPLATE_TEST_CASE("AdaBoostTrainOverloads", "[AdaBoostTest]", fmat, mat)
   REQUIRE(a3.WeakLearner(0).MaxIterations() == 1000);
   REQUIRE(a4.WeakLearner(0).MaxIterations() == 100);
 }
+
+/**
+ * Run AdaBoost with perceptrons trained on mini-batches on the UCI Iris
+ * dataset, and check that the hamming loss does not breach the upper bound.
+ */
+TEST_CASE("HammingLossBoundIrisMiniBatchPerceptron", "[AdaBoostTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    FAIL("Cannot load test dataset iris.csv!");
+
+  arma::Mat<size_t> labels;
+  if (!data::Load("iris_labels.txt", labels))
+    FAIL("Cannot load labels for iris iris_labels.txt");
+
+  const size_t numClasses = max(labels.row(0)) + 1;
+
+  // The weak learners are trained with batches of 16 points.
+  AdaBoost<Perceptron<>> a;
+  const double ztProduct = a.Train(inputData, labels.row(0), numClasses, 100,
+      2e-10, 400, 16);
+  REQUIRE(a.WeakLearners() > 0);
+  REQUIRE(a.WeakLearner(0).BatchSize() == 16);
+
+  arma::Row<size_t> predictedLabels;
+  a.Classify(inputData, predictedLabels);
+
+  const size_t countError = accu(labels != predictedLabels);
+  const double hammingLoss = (double) countError / labels.n_cols;
+  REQUIRE(std::isfinite(ztProduct));
+  REQUIRE(hammingLoss <= ztProduct);
+}
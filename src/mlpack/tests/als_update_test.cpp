@@ -0,0 +1,162 @@
+/**
+ * @file tests/als_update_test.cpp
+ *
+ * Test the ALSUpdate class for AMF.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/amf.hpp>
+
+#include "catch.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace arma;
+
+/**
+ * Make sure that each column of H after HUpdate() solves the normal equations
+ * of its observed entries, with the weighted-lambda regularization.
+ */
+TEST_CASE("ALSUpdateExplicitNormalEquationsTest", "[ALSUpdateTest]")
+{
+  sp_mat v;
+  v.sprandu(40, 30, 0.2);
+  mat w = randu<mat>(40, 5);
+  mat h;
+
+  ALSUpdate update(0.1);
+  update.HUpdate(v, w, h);
+
+  REQUIRE(h.n_rows == 5);
+  REQUIRE(h.n_cols == 30);
+  for (size_t j = 0; j < v.n_cols; ++j)
+  {
+    mat a(5, 5, fill::zeros);
+    vec b(5, fill::zeros);
+    size_t nnz = 0;
+    for (sp_mat::const_iterator it = v.begin_col(j); it != v.end_col(j); ++it)
+    {
+      a += w.row(it.row()).t() * w.row(it.row());
+      b += (*it) * w.row(it.row()).t();
+      ++nnz;
+    }
+    a.diag() += 0.1 * std::max(nnz, (size_t) 1);
+
+    REQUIRE(approx_equal(a * h.col(j), b, "absdiff", 1e-8));
+  }
+}
+
+/**
+ * Make sure that each column of H after HUpdate() solves the implicit
+ * feedback normal equations, computed densely.
+ */
+TEST_CASE("ALSUpdateImplicitNormalEquationsTest", "[ALSUpdateTest]")
+{
+  sp_mat v;
+  v.sprandu(40, 30, 0.2);
+  mat w = randu<mat>(40, 5);
+  mat h;
+
+  ALSUpdate update(0.1, true, 10.0);
+  update.HUpdate(v, w, h);
+
+  const mat dv(v);
+  for (size_t j = 0; j < v.n_cols; ++j)
+  {
+    // The confidence of each entry, and the preference of each entry.
+    const vec c = 1.0 + 10.0 * dv.col(j);
+    const vec p = conv_to<vec>::from(dv.col(j) > 0.0);
+
+    mat a = w.t() * diagmat(c) * w;
+    a.diag() += 0.1;
+    const vec b = w.t() * (c % p);
+
+    REQUIRE(approx_equal(a * h.col(j), b, "absdiff", 1e-8));
+  }
+}
+
+/**
+ * Make sure that WUpdate() on V is the same as HUpdate() on the transpose of
+ * V.
+ */
+TEST_CASE("ALSUpdateWUpdateTransposeTest", "[ALSUpdateTest]")
+{
+  sp_mat v;
+  v.sprandu(40, 30, 0.2);
+  mat h = randu<mat>(4, 30);
+  mat w, ht;
+
+  ALSUpdate update(0.05);
+  update.WUpdate(v, w, h);
+  update.HUpdate(sp_mat(v.t()), mat(h.t()), ht);
+
+  REQUIRE(w.n_rows == 40);
+  REQUIRE(w.n_cols == 4);
+  REQUIRE(approx_equal(w, ht.t(), "absdiff", 1e-10));
+}
+
+/**
+ * Make sure that the ALS factorizer reconstructs a dense low-rank matrix (so
+ * that all entries are observed).
+ */
+TEST_CASE("ALSFactorizerDenseTest", "[ALSUpdateTest]")
+{
+  mat w = randu<mat>(30, 4) + 0.1;
+  mat h = randu<mat>(4, 25) + 0.1;
+  mat v = w * h;
+
+  SimpleResidueTermination srt(1e-10, 200);
+  AMF<SimpleResidueTermination, RandomAMFInitialization, ALSUpdate> als(srt,
+      RandomAMFInitialization(), ALSUpdate(1e-6));
+  als.Apply(v, 4, w, h);
+
+  REQUIRE(arma::norm(v - w * h, "fro") / arma::norm(v, "fro") ==
+      Approx(0.0).margin(0.01));
+}
+
+/**
+ * Make sure that the ALS factorizer fits the observed entries of a sparse
+ * low-rank matrix, and that the sparse and dense fits agree.
+ */
+TEST_CASE("ALSFactorizerSparseTest", "[ALSUpdateTest]")
+{
+  const mat trueW = randu<mat>(50, 3) + 0.1;
+  const mat trueH = randu<mat>(3, 40) + 0.1;
+  const mat full = trueW * trueH;
+
+  // Observe about half of the entries.
+  sp_mat v(50, 40);
+  const mat mask = randu<mat>(50, 40);
+  for (size_t j = 0; j < full.n_cols; ++j)
+    for (size_t i = 0; i < full.n_rows; ++i)
+      if (mask(i, j) < 0.5)
+        v(i, j) = full(i, j);
+
+  mat iw, ih;
+  RandomAMFInitialization::Initialize(v, 3, iw, ih);
+
+  mat w, h;
+  MaxIterationTermination mit(50);
+  AMF<MaxIterationTermination, GivenInitialization, ALSUpdate> als(mit,
+      GivenInitialization(iw, ih), ALSUpdate(1e-6));
+  als.Apply(v, 3, w, h);
+
+  mat dw, dh;
+  als.Apply(mat(v), 3, dw, dh);
+
+  // Check the error over the observed entries.
+  const mat wh = w * h;
+  double error = 0.0, norm = 0.0;
+  for (sp_mat::const_iterator it = v.begin(); it != v.end(); ++it)
+  {
+    error += std::pow(wh(it.row(), it.col()) - (*it), 2.0);
+    norm += std::pow(*it, 2.0);
+  }
+  REQUIRE(std::sqrt(error / norm) == Approx(0.0).margin(0.05));
+
+  REQUIRE(approx_equal(wh, dw * dh, "reldiff", 1e-6));
+}
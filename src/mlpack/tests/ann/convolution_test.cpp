@@ -175,6 +175,10 @@ TEST_CASE("ValidConvolution2DTest", "[ConvolutionTest]")
   Convolution2DMethodTest<NaiveConvolution<ValidConvolution> >(input, filter,
       output);
 
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<ValidConvolution> >(input, filter,
+      output);
+
   // Perform the convolution trough fft.
   Convolution2DMethodTest<FFTConvolution<ValidConvolution> >(input, filter,
       output);
@@ -212,6 +216,10 @@ TEST_CASE("FullConvolution2DTest", "[ConvolutionTest]")
   Convolution2DMethodTest<NaiveConvolution<FullConvolution> >(input, filter,
       output);
 
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output);
+
   // Perform the convolution trough fft.
   Convolution2DMethodTest<FFTConvolution<FullConvolution> >(input, filter,
       output);
@@ -257,6 +265,10 @@ TEST_CASE("ValidConvolution3DTest", "[ConvolutionTest]")
   Convolution3DMethodTest<NaiveConvolution<ValidConvolution> >(inputCube,
       filterCube, outputCube);
 
+  // Perform the convolution through im2col and a matrix product.
+  Convolution3DMethodTest<Im2ColConvolution<ValidConvolution> >(inputCube,
+      filterCube, outputCube);
+
   // Perform the convolution trough fft.
   Convolution3DMethodTest<FFTConvolution<ValidConvolution> >(inputCube,
       filterCube, outputCube);
@@ -306,6 +318,10 @@ TEST_CASE("FullConvolution3DTest", "[ConvolutionTest]")
   Convolution3DMethodTest<NaiveConvolution<FullConvolution> >(inputCube,
       filterCube, outputCube);
 
+  // Perform the convolution through im2col and a matrix product.
+  Convolution3DMethodTest<Im2ColConvolution<FullConvolution> >(inputCube,
+      filterCube, outputCube);
+
   // Perform the convolution trough fft.
   Convolution3DMethodTest<FFTConvolution<FullConvolution> >(inputCube,
       filterCube, outputCube);
@@ -348,6 +364,10 @@ TEST_CASE("ValidConvolutionBatchTest", "[ConvolutionTest]")
   ConvolutionMethodBatchTest<NaiveConvolution<ValidConvolution> >(input,
       filterCube, outputCube);
 
+  // Perform the convolution through im2col and a matrix product.
+  ConvolutionMethodBatchTest<Im2ColConvolution<ValidConvolution> >(input,
+      filterCube, outputCube);
+
   // Perform the convolution trough fft.
   ConvolutionMethodBatchTest<FFTConvolution<ValidConvolution> >(input,
       filterCube, outputCube);
@@ -394,6 +414,10 @@ TEST_CASE("FullConvolutionBatchTest", "[ConvolutionTest]")
   ConvolutionMethodBatchTest<NaiveConvolution<FullConvolution> >(input,
       filterCube, outputCube);
 
+  // Perform the convolution through im2col and a matrix product.
+  ConvolutionMethodBatchTest<Im2ColConvolution<FullConvolution> >(input,
+      filterCube, outputCube);
+
   // Perform the convolution trough fft.
   ConvolutionMethodBatchTest<FFTConvolution<FullConvolution> >(input,
       filterCube, outputCube);
@@ -427,6 +451,10 @@ TEST_CASE("Stride2ConvolutionTest", "[ConvolutionTest]")
   // Perform the naive convolution approach.
   Convolution2DMethodTest<NaiveConvolution<FullConvolution> >(input, filter,
       output, 2, 2, 1, 1);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output, 2, 2, 1, 1);
 }
 
 TEST_CASE("Stride3ConvolutionTest", "[ConvolutionTest]")
@@ -447,6 +475,10 @@ TEST_CASE("Stride3ConvolutionTest", "[ConvolutionTest]")
   // Perform the naive convolution approach.
   Convolution2DMethodTest<NaiveConvolution<FullConvolution> >(input, filter,
       output, 3, 3, 1, 1);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output, 3, 3, 1, 1);
 }
 
 TEST_CASE("UnequalStrideConvolutionTest", "[ConvolutionTest]")
@@ -468,6 +500,10 @@ TEST_CASE("UnequalStrideConvolutionTest", "[ConvolutionTest]")
   // Perform the naive convolution approach.
   Convolution2DMethodTest<NaiveConvolution<FullConvolution> >(input, filter,
       output, 3, 2, 1, 1);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output, 3, 2, 1, 1);
 }
 
 TEST_CASE("Dilation2ConvolutionTest", "[ConvolutionTest]")
@@ -492,6 +528,10 @@ TEST_CASE("Dilation2ConvolutionTest", "[ConvolutionTest]")
   // Perform the naive convolution approach.
   Convolution2DMethodTest<NaiveConvolution<FullConvolution> >(input, filter,
       output, 1, 1, 2, 2);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output, 1, 1, 2, 2);
 }
 
 TEST_CASE("Dilation3ConvolutionTest", "[ConvolutionTest]")
@@ -517,6 +557,10 @@ TEST_CASE("Dilation3ConvolutionTest", "[ConvolutionTest]")
   // Perform the naive convolution approach.
   Convolution2DMethodTest<NaiveConvolution<FullConvolution> >(input, filter,
       output, 1, 1, 3, 3);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output, 1, 1, 3, 3);
 }
 
 TEST_CASE("UnequalDilationConvolutionTest", "[ConvolutionTest]")
@@ -541,6 +585,10 @@ TEST_CASE("UnequalDilationConvolutionTest", "[ConvolutionTest]")
   // Perform the naive convolution approach.
   Convolution2DMethodTest<NaiveConvolution<FullConvolution> >(input, filter,
       output, 1, 1, 3, 2);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output, 1, 1, 3, 2);
 }
 
 TEST_CASE("DilationAndStrideConvolutionTest", "[ConvolutionTest]")
@@ -562,4 +610,8 @@ TEST_CASE("DilationAndStrideConvolutionTest", "[ConvolutionTest]")
   // Perform the naive convolution approach.
   Convolution2DMethodTest<NaiveConvolution<FullConvolution> >(input, filter,
       output, 2, 2, 2, 2);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output, 2, 2, 2, 2);
 }
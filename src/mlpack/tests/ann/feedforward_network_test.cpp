@@ -714,6 +714,40 @@ TEST_CASE("FFSerializationTest", "[FeedForwardNetworkTest]")
       binaryPredictions);
 }
 
+/**
+ * Make sure that a network loaded with data::LoadMapped() uses the page-aligned
+ * parameters of the mapped file directly, and predicts like the saved network.
+ */
+TEST_CASE("FFNLoadMappedTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat trainData = arma::randu<arma::mat>(10, 100);
+
+  FFN<MeanSquaredError> model;
+  model.Add<Linear>(64);
+  model.Add<ReLU>();
+  model.Add<Linear>(3);
+  model.Reset(10);
+
+  REQUIRE(data::SaveMapped("ffn.mmap", "model", model, false));
+
+  FFN<MeanSquaredError> mappedModel;
+  data::MappedFile file;
+  REQUIRE(data::LoadMapped("ffn.mmap", "model", mappedModel, file, false));
+
+  arma::mat predictions, mappedPredictions;
+  model.Predict(trainData, predictions);
+  mappedModel.Predict(trainData, mappedPredictions);
+  CheckMatrices(predictions, mappedPredictions);
+
+  // The layers must still use the mapped parameters after Predict().
+  const char* parameters = (const char*) mappedModel.Parameters().memptr();
+  REQUIRE(file.Contains(parameters));
+  REQUIRE((parameters - file.Data()) %
+      cereal::MappedOutputArchive::pageSize == 0);
+
+  remove("ffn.mmap");
+}
+
 /**
  * Test the overload of Forward function which allows partial forward pass.
  */
@@ -763,6 +797,478 @@ TEST_CASE("PartialForwardTest", "[FeedForwardNetworkTest]")
   CheckMatrices(output, arma::ones(10, 1) * 20);
 }
 
+/**
+ * Make sure that reusing the memory of the layer outputs during inference does
+ * not change the results of Predict(), or the gradients computed by a later
+ * Forward() and Backward() pass.
+ */
+TEST_CASE("FFNLayerMemoryReuseTest", "[FeedForwardNetworkTest]")
+{
+  FFN<MeanSquaredError, RandomInitialization> model;
+  model.Add<Linear>(12);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(7);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(15);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(3);
+
+  arma::mat input(10, 25, arma::fill::randu);
+  arma::mat responses(3, 25, arma::fill::randu);
+  model.Reset(10);
+
+  // Forward() keeps the output of every layer.
+  arma::mat forwardOutput, forwardGradient;
+  model.Forward(input, forwardOutput);
+  model.Backward(input, responses, forwardGradient);
+
+  // Predict() reuses the memory of the outputs; use a batch size that does not
+  // divide the number of points, so that the last batch is smaller.
+  arma::mat predictions;
+  model.Predict(input, predictions, 10);
+  CheckMatrices(forwardOutput, predictions);
+
+  // The gradient must be the same after the memory has been reused.
+  arma::mat output, gradient;
+  model.Forward(input, output);
+  model.Backward(input, responses, gradient);
+  CheckMatrices(forwardOutput, output);
+  CheckMatrices(forwardGradient, gradient);
+
+  // The objective computed by Evaluate() must also match.
+  const double loss = model.Evaluate(input, responses);
+  REQUIRE(loss == Approx(MeanSquaredError().Forward(forwardOutput, responses))
+      .epsilon(1e-7));
+}
+
+/**
+ * Make sure that Predict(), which skips dropout layers and folds batch
+ * normalization layers into the layers before them, gives the same results as
+ * a forward pass through all the layers in testing mode.
+ */
+TEST_CASE("FFNInferenceFoldingTest", "[FeedForwardNetworkTest]")
+{
+  FFN<MeanSquaredError, RandomInitialization> model;
+  model.Add<Convolution>(4, 3, 3, 1, 1, 1, 1);
+  BatchNorm* convBatchNorm = new BatchNorm();
+  model.Add(convBatchNorm);
+  model.Add<ReLU>();
+  model.Add<Dropout>(0.3);
+  model.Add<Linear>(10);
+  BatchNorm* linearBatchNorm = new BatchNorm(0, 0);
+  model.Add(linearBatchNorm);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(3);
+
+  model.InputDimensions() = std::vector<size_t>({ 6, 5, 2 });
+  model.Reset();
+
+  // Use some statistics that do not make batch normalization the identity.
+  model.Parameters().randu();
+  convBatchNorm->TrainingMean().randu(4, 1);
+  convBatchNorm->TrainingVariance().randu(4, 1);
+  convBatchNorm->TrainingVariance() += 0.5;
+  linearBatchNorm->TrainingMean().randu(10, 1);
+  linearBatchNorm->TrainingVariance().randu(10, 1);
+  linearBatchNorm->TrainingVariance() += 0.5;
+
+  arma::mat input(60, 15, arma::fill::randu);
+  arma::mat output, predictions;
+  model.SetNetworkMode(false);
+  model.Forward(input, output);
+  model.Predict(input, predictions, 4);
+  CheckMatrices(output, predictions, 1e-5);
+
+  // The folded layers must follow changes of the parameters.
+  model.Parameters() *= 0.8;
+  model.Forward(input, output);
+  model.Predict(input, predictions, 4);
+  CheckMatrices(output, predictions, 1e-5);
+}
+
+/**
+ * Make sure that Predict(), which fuses activation layers into the linear and
+ * convolution layers before them, gives the same results as a forward pass
+ * through all the layers in testing mode.
+ */
+TEST_CASE("FFNInferenceFusionTest", "[FeedForwardNetworkTest]")
+{
+  FFN<MeanSquaredError, RandomInitialization> model;
+  model.Add<Convolution>(4, 3, 3, 1, 1, 1, 1);
+  model.Add<ReLU>();
+  model.Add<Convolution>(3, 3, 3, 1, 1, 0, 0, "none", false);
+  model.Add<TanH>();
+  model.Add<Linear>(10);
+  model.Add<LeakyReLU>(0.1);
+  model.Add<Dropout>(0.3);
+  model.Add<Linear>(8);
+  model.Add<BatchNorm>();
+  model.Add<ELU>(0.5);
+  // An activation that follows a fused activation is computed on its own.
+  model.Add<Sigmoid>();
+  model.Add<Linear>(3);
+
+  model.InputDimensions() = std::vector<size_t>({ 6, 5, 2 });
+  model.Reset();
+  model.Parameters().randn();
+
+  arma::mat input(60, 15, arma::fill::randn);
+  arma::mat output, predictions;
+  model.SetNetworkMode(false);
+  model.Forward(input, output);
+  model.Predict(input, predictions, 4);
+  CheckMatrices(output, predictions, 1e-5);
+
+  // The fused layers use the parameters of the network.
+  model.Parameters() *= 0.8;
+  model.Forward(input, output);
+  model.Predict(input, predictions, 4);
+  CheckMatrices(output, predictions, 1e-5);
+}
+
+/**
+ * Make sure that FFN::Quantize() replaces the Linear and Convolution layers
+ * with quantized layers that give nearly the same predictions, and that the
+ * quantized network can be serialized.
+ */
+TEST_CASE("FFNQuantizeTest", "[FeedForwardNetworkTest]")
+{
+  FFN<MeanSquaredError, RandomInitialization> model;
+  model.Add<Convolution>(4, 3, 3, 1, 1, 1, 1);
+  model.Add<BatchNorm>();
+  model.Add<ReLU>();
+  model.Add<Linear>(10);
+  model.Add<Sigmoid>();
+  model.Add<LinearNoBias>(3);
+
+  model.InputDimensions() = std::vector<size_t>({ 6, 5, 2 });
+  model.Reset();
+  model.Parameters().randn();
+
+  arma::mat input(60, 15, arma::fill::randu);
+  arma::mat predictions, quantizedPredictions;
+  model.Predict(input, predictions);
+
+  // Only the parameters of the BatchNorm layer are left.
+  model.Quantize();
+  REQUIRE(model.Parameters().n_elem == 2 * 4);
+  REQUIRE(dynamic_cast<QuantizedConvolution*>(model.Network()[0]) != NULL);
+  REQUIRE(dynamic_cast<QuantizedLinear*>(model.Network()[3]) != NULL);
+  REQUIRE(dynamic_cast<QuantizedLinear*>(model.Network()[5]) != NULL);
+
+  model.Predict(input, quantizedPredictions);
+  REQUIRE(arma::norm(predictions - quantizedPredictions) /
+      arma::norm(predictions) < 0.05);
+
+  FFN<MeanSquaredError, RandomInitialization> xmlModel, jsonModel,
+      binaryModel;
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::mat xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlModel.Predict(input, xmlPredictions);
+  jsonModel.Predict(input, jsonPredictions);
+  binaryModel.Predict(input, binaryPredictions);
+
+  CheckMatrices(quantizedPredictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Make sure that data-parallel training gives the same model as training with
+ * one thread.
+ */
+TEST_CASE("FFNDataParallelTrainingTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 200, arma::fill::randu);
+  arma::mat responses = arma::sum(data % data) / 10.0;
+
+  FFN<MeanSquaredError, RandomInitialization> model;
+  model.Add<Linear>(8);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(1);
+  model.Reset(10);
+
+  FFN<MeanSquaredError, RandomInitialization> parallelModel(model);
+  parallelModel.Threads() = 4;
+  REQUIRE(parallelModel.Threads() == 4);
+
+  // Use batches whose size is not a multiple of the number of threads.
+  ens::StandardSGD opt(0.01, 15, 2000, -1.0, false);
+  const double objective = model.Train(data, responses, opt);
+  const double parallelObjective = parallelModel.Train(data, responses, opt);
+
+  REQUIRE(parallelObjective == Approx(objective).epsilon(1e-5));
+  CheckMatrices(model.Parameters(), parallelModel.Parameters(), 1e-5);
+}
+
+/**
+ * Make sure that passing several batches through replicas of the network at
+ * once in Predict() gives the same predictions as one thread.
+ */
+TEST_CASE("FFNParallelPredictTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 203, arma::fill::randu);
+  arma::mat responses = arma::sum(data % data) / 10.0;
+
+  FFN<MeanSquaredError, RandomInitialization> model;
+  model.Add<Linear>(8);
+  model.Add<Sigmoid>();
+  model.Add<Dropout>(0.3);
+  model.Add<Linear>(1);
+
+  ens::StandardSGD opt(0.01, 16, 1000, -1.0, false);
+  model.Train(data, responses, opt);
+
+  arma::mat predictions, parallelPredictions;
+  model.Predict(data, predictions, 16);
+
+  // Use more threads than there are batches too.
+  const size_t threads[2] = { 3, 20 };
+  for (size_t t = 0; t < 2; ++t)
+  {
+    model.Threads() = threads[t];
+    model.Predict(data, parallelPredictions, 16);
+    CheckMatrices(predictions, parallelPredictions);
+  }
+}
+
+/**
+ * Make sure that training on the shards of a PrefetchingLoader gives the same
+ * model as training on each shard in turn.
+ */
+TEST_CASE("FFNPrefetchingLoaderTrainTest", "[FeedForwardNetworkTest]")
+{
+  std::vector<arma::mat> shardData, shardResponses;
+  for (size_t i = 0; i < 5; ++i)
+  {
+    shardData.push_back(arma::randu<arma::mat>(4, 30));
+    shardResponses.push_back(arma::sum(shardData[i]) / 4.0);
+  }
+
+  auto reader = [&](const size_t i, arma::mat& predictors,
+                    arma::mat& responses)
+  {
+    predictors = shardData[i];
+    responses = shardResponses[i];
+  };
+  data::PrefetchingLoader<arma::mat> loader(5, reader);
+
+  FFN<MeanSquaredError, RandomInitialization> model;
+  model.Add<Linear>(5);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(1);
+  model.Reset(4);
+  FFN<MeanSquaredError, RandomInitialization> shardModel(model);
+
+  ens::StandardSGD opt(0.01, 10, 30, -1.0, false);
+  const double objective = model.Train(loader, opt, 2);
+
+  double shardObjective = 0.0;
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    shardObjective = 0.0;
+    for (size_t i = 0; i < 5; ++i)
+      shardObjective += shardModel.Train(shardData[i], shardResponses[i], opt);
+  }
+
+  REQUIRE(objective == Approx(shardObjective).epsilon(1e-7));
+  CheckMatrices(model.Parameters(), shardModel.Parameters(), 1e-7);
+}
+
+/**
+ * Make sure that training with activation checkpointing gives the same model
+ * as training without it.
+ */
+TEST_CASE("FFNCheckpointingTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 100, arma::fill::randu);
+  arma::mat responses = arma::sum(data % data) / 10.0;
+
+  FFN<MeanSquaredError, RandomInitialization> model;
+  model.Add<Linear>(8);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(6);
+  model.Add<ReLU>();
+  model.Add<Linear>(4);
+  model.Add<TanH>();
+  model.Add<Linear>(1);
+  model.Reset(10);
+
+  FFN<MeanSquaredError, RandomInitialization> checkpointedModel(model);
+  checkpointedModel.Checkpoints() = { 1, 4 };
+  REQUIRE(checkpointedModel.Checkpoints().size() == 2);
+
+  // The gradient of a single batch should be the same.
+  model.ResetData(data, responses);
+  checkpointedModel.ResetData(data, responses);
+  arma::mat gradient, checkpointedGradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 20);
+  const double checkpointedObjective = checkpointedModel.EvaluateWithGradient(
+      checkpointedModel.Parameters(), 0, checkpointedGradient, 20);
+
+  REQUIRE(checkpointedObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(gradient, checkpointedGradient, 1e-7);
+
+  // And so should the trained model.
+  ens::StandardSGD opt(0.01, 10, 500, -1.0, false);
+  model.Train(data, responses, opt);
+  checkpointedModel.Train(data, responses, opt);
+  CheckMatrices(model.Parameters(), checkpointedModel.Parameters(), 1e-5);
+}
+
+/**
+ * Make sure that mixed-precision training of a float network gives nearly the
+ * same model as training the same network in double precision, even when the
+ * initial loss scale is so large that the first steps overflow.
+ */
+TEST_CASE("FFNMixedPrecisionTrainingTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 200, arma::fill::randu);
+  arma::mat responses = arma::sum(data % data) / 10.0;
+  const arma::fmat floatData = arma::conv_to<arma::fmat>::from(data);
+  const arma::fmat floatResponses = arma::conv_to<arma::fmat>::from(responses);
+
+  FFN<MeanSquaredError, RandomInitialization> model;
+  model.Add<Linear>(8);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(1);
+  model.Reset(10);
+  const arma::mat initialParameters = model.Parameters();
+
+  ens::StandardSGD opt(0.01, 10, 2000, -1.0, false);
+  const double objective = model.Train(data, responses, opt);
+
+  // A scale of 1e45 does not even fit in a float.
+  const double initialScales[2] = { 65536.0, 1e45 };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    FFN<MeanSquaredErrorType<arma::fmat>, RandomInitialization, arma::fmat>
+        mixedModel;
+    mixedModel.Add<LinearType<arma::fmat>>(8);
+    mixedModel.Add<SigmoidType<arma::fmat>>();
+    mixedModel.Add<LinearType<arma::fmat>>(1);
+    mixedModel.LossScale() = initialScales[i];
+    mixedModel.LossScaleInterval() = 50;
+
+    // Start from the same weights as the double-precision model.
+    mixedModel.Parameters() =
+        arma::conv_to<arma::fmat>::from(initialParameters);
+
+    const float mixedObjective = mixedModel.TrainMixedPrecision(floatData,
+        floatResponses, opt);
+
+    REQUIRE(std::isfinite(mixedObjective));
+    REQUIRE(mixedObjective == Approx(objective).epsilon(0.1));
+  }
+}
+
+/**
+ * Test that a StaticFFN with the same layers and weights as an FFN makes the
+ * same predictions and trains the same way.
+ */
+TEST_CASE("StaticFFNMatchesFFNTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 200, arma::fill::randu);
+  arma::mat responses = arma::sum(data % data) / 10.0;
+
+  FFN<MeanSquaredError, RandomInitialization> model;
+  model.Add<Linear>(8);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(1);
+  model.Reset(10);
+
+  StaticFFN<MeanSquaredError, RandomInitialization, arma::mat,
+      Linear, Sigmoid, Linear> staticModel({ 10 }, Linear(8), Sigmoid(),
+      Linear(1));
+  REQUIRE(staticModel.Parameters().n_elem == model.Parameters().n_elem);
+  REQUIRE(staticModel.OutputSize() == 1);
+  staticModel.Parameters() = model.Parameters();
+
+  arma::mat predictions, staticPredictions;
+  model.Predict(data, predictions);
+  staticModel.Predict(data, staticPredictions, 64);
+  REQUIRE(approx_equal(predictions, staticPredictions, "absdiff", 1e-10));
+
+  // Without shuffling, both networks must follow the same path.
+  ens::StandardSGD opt(0.01, 10, 1000, -1.0, false);
+  const double objective = model.Train(data, responses, opt);
+  const double staticObjective = staticModel.Train(data, responses, opt);
+
+  REQUIRE(staticObjective == Approx(objective).epsilon(1e-6));
+  REQUIRE(approx_equal(model.Parameters(), staticModel.Parameters(),
+      "absdiff", 1e-6));
+
+  // A copy must use its own weights.
+  StaticFFN<MeanSquaredError, RandomInitialization, arma::mat,
+      Linear, Sigmoid, Linear> copy(staticModel);
+  staticModel.Parameters().zeros();
+  model.Predict(data, predictions);
+  copy.Predict(data, staticPredictions);
+  REQUIRE(approx_equal(predictions, staticPredictions, "absdiff", 1e-6));
+
+  // Wrong input sizes must be caught.
+  arma::mat badData(5, 10, arma::fill::randu);
+  REQUIRE_THROWS_AS(copy.Predict(badData, staticPredictions),
+      std::invalid_argument);
+}
+
+/**
+ * Test that a LayerProfiler attached to an FFN records every layer, and that
+ * its trace can be exported.
+ */
+TEST_CASE("FFNProfilerTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 100, arma::fill::randu);
+  arma::mat responses = arma::sum(data % data) / 10.0;
+
+  FFN<MeanSquaredError, RandomInitialization> model;
+  model.Add<Linear>(8);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(1);
+
+  LayerProfiler profiler;
+  model.Profiler() = &profiler;
+  ens::StandardSGD opt(0.01, 10, 50, -1.0, false);
+  model.Train(data, responses, opt);
+  model.Profiler() = NULL;
+
+  const std::vector<LayerProfiler::LayerStatistics>& statistics =
+      profiler.Statistics();
+  REQUIRE(statistics.size() == 3);
+  for (size_t i = 0; i < statistics.size(); ++i)
+  {
+    REQUIRE(statistics[i].index == i);
+    REQUIRE(statistics[i].calls[LayerProfiler::FORWARD] > 0);
+    REQUIRE(statistics[i].calls[LayerProfiler::BACKWARD] > 0);
+    REQUIRE(statistics[i].outputBytes > 0);
+  }
+  REQUIRE(statistics[0].name == "Linear");
+  REQUIRE(statistics[1].name == "Sigmoid");
+  REQUIRE(statistics[0].flops[LayerProfiler::FORWARD] > 0.0);
+  REQUIRE(statistics[0].calls[LayerProfiler::GRADIENT] > 0);
+  REQUIRE(profiler.TotalTime(LayerProfiler::FORWARD) > 0.0);
+  REQUIRE(profiler.Summary().find("Linear") != std::string::npos);
+
+  // Nothing more is recorded once the profiler is detached.
+  const size_t calls = statistics[0].calls[LayerProfiler::FORWARD];
+  arma::mat predictions;
+  model.Predict(data, predictions);
+  REQUIRE(statistics[0].calls[LayerProfiler::FORWARD] == calls);
+
+  profiler.ExportChromeTrace("ffn_profiler_trace.json");
+  std::ifstream trace("ffn_profiler_trace.json");
+  std::string contents((std::istreambuf_iterator<char>(trace)),
+      std::istreambuf_iterator<char>());
+  trace.close();
+  remove("ffn_profiler_trace.json");
+  REQUIRE(contents.find("{\"traceEvents\":[") == 0);
+  REQUIRE(contents.find("\"name\":\"Linear (0)\"") != std::string::npos);
+
+  profiler.Clear();
+  REQUIRE(profiler.Statistics().empty());
+}
+
 /**
  * Test that FFN::Train() returns finite objective value.
  */
@@ -225,3 +225,46 @@ TEST_CASE("GradientConcatLayerTest", "[ANNLayerTest]")
 
   REQUIRE(CheckGradient(function) <= 1e-4);
 }
+
+/**
+ * Make sure that the passes of the Concat layer give the same results for a
+ * single point, where the held layers write directly into the concatenated
+ * output, as for a batch, where the outputs are copied.
+ */
+TEST_CASE("ConcatSinglePointTest", "[ANNLayerTest]")
+{
+  Concat module;
+  module.Add<Linear>(3);
+  module.Add<Linear>(4);
+  module.InputDimensions() = std::vector<size_t>({ 6 });
+  module.ComputeOutputDimensions();
+  arma::mat weights(module.WeightSize(), 1, arma::fill::randu);
+  module.SetWeights(weights.memptr());
+
+  arma::mat input(6, 5, arma::fill::randu);
+  arma::mat error(7, 5, arma::fill::randu);
+
+  arma::mat output(7, 5), delta(6, 5), gradient(module.WeightSize(), 1);
+  module.Forward(input, output);
+  module.Backward(input, output, error, delta);
+  module.Gradient(input, error, gradient);
+
+  arma::mat sumGradient(module.WeightSize(), 1, arma::fill::zeros);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    arma::mat pointInput = input.col(i);
+    arma::mat pointError = error.col(i);
+    arma::mat pointOutput(7, 1), pointDelta(6, 1);
+    arma::mat pointGradient(module.WeightSize(), 1);
+
+    module.Forward(pointInput, pointOutput);
+    module.Backward(pointInput, pointOutput, pointError, pointDelta);
+    module.Gradient(pointInput, pointError, pointGradient);
+
+    CheckMatrices(pointOutput, output.col(i));
+    CheckMatrices(pointDelta, delta.col(i));
+    sumGradient += pointGradient;
+  }
+
+  CheckMatrices(sumGradient, gradient);
+}
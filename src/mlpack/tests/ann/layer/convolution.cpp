@@ -461,3 +461,83 @@ TEST_CASE("NonSquareConvolutionTest", "[ANNLayerTest]")
   arma::mat gradientResult(module1.WeightSize(), 1);
   REQUIRE_NOTHROW(module1.Gradient(data, backwardResult, gradientResult));
 }
+
+/**
+ * Check that a layer using the default Im2ColConvolution rule gives the same
+ * results as the same layer using NaiveConvolution, for two batches of
+ * different sizes.
+ */
+template<typename LayerType, typename NaiveLayerType>
+void CheckIm2ColConvolutionLayer(LayerType& layer,
+                                 NaiveLayerType& naiveLayer,
+                                 const std::vector<size_t>& inputDimensions)
+{
+  layer.InputDimensions() = inputDimensions;
+  layer.ComputeOutputDimensions();
+  naiveLayer.InputDimensions() = inputDimensions;
+  naiveLayer.ComputeOutputDimensions();
+  REQUIRE(layer.OutputSize() == naiveLayer.OutputSize());
+  REQUIRE(layer.WeightSize() == naiveLayer.WeightSize());
+
+  arma::mat weights(layer.WeightSize(), 1, arma::fill::randn);
+  arma::mat naiveWeights(weights);
+  layer.SetWeights(weights.memptr());
+  naiveLayer.SetWeights(naiveWeights.memptr());
+
+  size_t inputSize = 1;
+  for (size_t i = 0; i < inputDimensions.size(); ++i)
+    inputSize *= inputDimensions[i];
+
+  for (const size_t batchSize : { 5, 2 })
+  {
+    arma::mat input(inputSize, batchSize, arma::fill::randu);
+    arma::mat output(layer.OutputSize(), batchSize);
+    arma::mat naiveOutput(layer.OutputSize(), batchSize);
+    layer.Forward(input, output);
+    naiveLayer.Forward(input, naiveOutput);
+    CheckMatrices(output, naiveOutput);
+
+    arma::mat error(layer.OutputSize(), batchSize, arma::fill::randu);
+    arma::mat delta(inputSize, batchSize), naiveDelta(inputSize, batchSize);
+    layer.Backward(input, output, error, delta);
+    naiveLayer.Backward(input, naiveOutput, error, naiveDelta);
+    CheckMatrices(delta, naiveDelta);
+
+    arma::mat gradient(layer.WeightSize(), 1);
+    arma::mat naiveGradient(layer.WeightSize(), 1);
+    layer.Gradient(input, error, gradient);
+    naiveLayer.Gradient(input, error, naiveGradient);
+    CheckMatrices(gradient, naiveGradient);
+  }
+}
+
+/**
+ * Make sure that the im2col convolution used by default gives the same
+ * results as the naive convolution, with and without padding and strides.
+ */
+TEST_CASE("Im2ColConvolutionLayerTest", "[ANNLayerTest]")
+{
+  typedef ConvolutionType<
+      NaiveConvolution<ValidConvolution>,
+      NaiveConvolution<FullConvolution>,
+      NaiveConvolution<ValidConvolution>,
+      arma::mat
+  > NaiveConvolutionLayer;
+
+  Convolution layer1(4, 3, 3);
+  NaiveConvolutionLayer naiveLayer1(4, 3, 3);
+  CheckIm2ColConvolutionLayer(layer1, naiveLayer1, { 9, 8, 3 });
+
+  // Non-square filters, strides, and padding.
+  Convolution layer2(3, 3, 2, 2, 2, std::tuple<size_t, size_t>(1, 2),
+      std::tuple<size_t, size_t>(0, 1), "none");
+  NaiveConvolutionLayer naiveLayer2(3, 3, 2, 2, 2,
+      std::tuple<size_t, size_t>(1, 2), std::tuple<size_t, size_t>(0, 1),
+      "none");
+  CheckIm2ColConvolutionLayer(layer2, naiveLayer2, { 9, 8, 2 });
+
+  // "Same" padding, no bias, and a higher-order input.
+  Convolution layer3(2, 3, 3, 1, 1, 0, 0, "same", false);
+  NaiveConvolutionLayer naiveLayer3(2, 3, 3, 1, 1, 0, 0, "same", false);
+  CheckIm2ColConvolutionLayer(layer3, naiveLayer3, { 6, 7, 2, 3 });
+}
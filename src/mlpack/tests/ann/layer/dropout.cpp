@@ -100,3 +100,55 @@ TEST_CASE("NoDropoutTest", "[ANNLayerTest]")
   REQUIRE(accu(output) == accu(input));
 }
 
+
+/**
+ * Check that DropoutMask keeps the right fraction of elements, gives the same
+ * mask for the same seed, and applies the mask and the scaling correctly.
+ */
+TEST_CASE("DropoutMaskTest", "[ANNLayerTest]")
+{
+  const double p = 0.3;
+
+  // The number of elements is not a multiple of 64.
+  DropoutMask mask;
+  mask.Generate(101, 99, p, 42);
+  REQUIRE(mask.Rows() == 101);
+  REQUIRE(mask.Cols() == 99);
+  REQUIRE(mask.Words().size() == (101 * 99 + 63) / 64);
+
+  arma::mat m;
+  mask.ToMatrix(m);
+  REQUIRE(std::abs(arma::accu(m) / m.n_elem - (1 - p)) <= 0.02);
+
+  DropoutMask mask2;
+  mask2.Generate(101, 99, p, 42);
+  REQUIRE(mask2.Words() == mask.Words());
+
+  arma::mat input(101, 99, arma::fill::randu);
+  arma::mat output;
+  mask.Apply(input, output, 2.0, 0.5, -1.0);
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    if (mask[i])
+      REQUIRE(output[i] == Approx(2.0 * input[i] + 0.5));
+    else
+      REQUIRE(output[i] == -1.0);
+  }
+
+  // Apply in place, with a different element type.
+  arma::fmat finput = arma::conv_to<arma::fmat>::from(input);
+  mask.Apply(finput, finput, 2.0);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    REQUIRE(finput[i] == (mask[i] ? 2.0f * (float) input[i] : 0.0f));
+
+  // Ratios of 0 and 1 keep and drop everything.
+  mask.Generate(10, 10, 0.0);
+  mask.ToMatrix(m);
+  REQUIRE(arma::accu(m) == 100);
+  mask.Generate(10, 10, 1.0);
+  mask.ToMatrix(m);
+  REQUIRE(arma::accu(m) == 0);
+
+  // Applying to a matrix of the wrong size is an error.
+  REQUIRE_THROWS_AS(mask.Apply(input, output, 1.0), std::invalid_argument);
+}
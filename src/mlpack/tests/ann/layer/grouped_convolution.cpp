@@ -222,3 +222,91 @@ TEST_CASE("NonSquareGroupedConvolutionTest", "[ANNLayerTest]")
   arma::mat gradientResult(module1.WeightSize(), 1);
   REQUIRE_NOTHROW(module1.Gradient(data, backwardResult, gradientResult));
 }
+
+/**
+ * Make sure that the im2col convolution used by default gives the same
+ * results as the naive convolution for grouped convolutions.
+ */
+TEST_CASE("Im2ColGroupedConvolutionLayerTest", "[ANNLayerTest]")
+{
+  GroupedConvolution layer(6, 3, 2, 3, 2, 2, 1, 1);
+  GroupedConvolutionType<
+      NaiveConvolution<ValidConvolution>,
+      NaiveConvolution<FullConvolution>,
+      NaiveConvolution<ValidConvolution>,
+      arma::mat
+  > naiveLayer(6, 3, 2, 3, 2, 2, 1, 1);
+
+  const std::vector<size_t> inputDimensions({ 9, 8, 3 });
+  layer.InputDimensions() = inputDimensions;
+  layer.ComputeOutputDimensions();
+  naiveLayer.InputDimensions() = inputDimensions;
+  naiveLayer.ComputeOutputDimensions();
+
+  arma::mat weights(layer.WeightSize(), 1, arma::fill::randn);
+  arma::mat naiveWeights(weights);
+  layer.SetWeights(weights.memptr());
+  naiveLayer.SetWeights(naiveWeights.memptr());
+
+  arma::mat input(9 * 8 * 3, 4, arma::fill::randu);
+  arma::mat output(layer.OutputSize(), 4), naiveOutput(layer.OutputSize(), 4);
+  layer.Forward(input, output);
+  naiveLayer.Forward(input, naiveOutput);
+  CheckMatrices(output, naiveOutput);
+
+  arma::mat error(layer.OutputSize(), 4, arma::fill::randu);
+  arma::mat delta(input.n_rows, 4), naiveDelta(input.n_rows, 4);
+  layer.Backward(input, output, error, delta);
+  naiveLayer.Backward(input, naiveOutput, error, naiveDelta);
+  CheckMatrices(delta, naiveDelta);
+
+  arma::mat gradient(layer.WeightSize(), 1);
+  arma::mat naiveGradient(layer.WeightSize(), 1);
+  layer.Gradient(input, error, gradient);
+  naiveLayer.Gradient(input, error, naiveGradient);
+  CheckMatrices(gradient, naiveGradient);
+}
+
+/**
+ * Make sure that the depthwise convolution used by default when there are as
+ * many groups as input maps gives the same results as the naive convolution.
+ */
+TEST_CASE("DepthwiseGroupedConvolutionLayerTest", "[ANNLayerTest]")
+{
+  GroupedConvolution layer(6, 3, 2, 3, 2, 1, 1, 1);
+  GroupedConvolutionType<
+      NaiveConvolution<ValidConvolution>,
+      NaiveConvolution<FullConvolution>,
+      NaiveConvolution<ValidConvolution>,
+      arma::mat
+  > naiveLayer(6, 3, 2, 3, 2, 1, 1, 1);
+
+  const std::vector<size_t> inputDimensions({ 9, 8, 3 });
+  layer.InputDimensions() = inputDimensions;
+  layer.ComputeOutputDimensions();
+  naiveLayer.InputDimensions() = inputDimensions;
+  naiveLayer.ComputeOutputDimensions();
+
+  arma::mat weights(layer.WeightSize(), 1, arma::fill::randn);
+  arma::mat naiveWeights(weights);
+  layer.SetWeights(weights.memptr());
+  naiveLayer.SetWeights(naiveWeights.memptr());
+
+  arma::mat input(9 * 8 * 3, 4, arma::fill::randu);
+  arma::mat output(layer.OutputSize(), 4), naiveOutput(layer.OutputSize(), 4);
+  layer.Forward(input, output);
+  naiveLayer.Forward(input, naiveOutput);
+  CheckMatrices(output, naiveOutput);
+
+  arma::mat error(layer.OutputSize(), 4, arma::fill::randu);
+  arma::mat delta(input.n_rows, 4), naiveDelta(input.n_rows, 4);
+  layer.Backward(input, output, error, delta);
+  naiveLayer.Backward(input, naiveOutput, error, naiveDelta);
+  CheckMatrices(delta, naiveDelta);
+
+  arma::mat gradient(layer.WeightSize(), 1);
+  arma::mat naiveGradient(layer.WeightSize(), 1);
+  layer.Gradient(input, error, gradient);
+  naiveLayer.Gradient(input, error, naiveGradient);
+  CheckMatrices(gradient, naiveGradient);
+}
@@ -0,0 +1,62 @@
+/**
+ * @file tests/ann/layer/linear.cpp
+ *
+ * Tests the Linear layer on Bandicoot matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann.hpp>
+
+#include "../../test_catch_tools.hpp"
+#include "../../catch.hpp"
+
+using namespace mlpack;
+
+#ifdef MLPACK_HAS_COOT
+
+/**
+ * Make sure that the Forward(), Backward() and Gradient() functions of a
+ * Linear layer of Bandicoot matrices give the same results as those of a
+ * Linear layer of Armadillo matrices with the same weights.
+ */
+TEST_CASE("LinearLayerCootTest", "[ANNLayerTest]")
+{
+  LinearType<arma::fmat> module(7);
+  LinearType<coot::fmat> cootModule(7);
+  module.InputDimensions() = std::vector<size_t>({ 5 });
+  cootModule.InputDimensions() = std::vector<size_t>({ 5 });
+  module.ComputeOutputDimensions();
+  cootModule.ComputeOutputDimensions();
+
+  arma::fmat weights(module.WeightSize(), 1, arma::fill::randn);
+  coot::fmat cootWeights(weights);
+  module.SetWeights(weights.memptr());
+  cootModule.SetWeights(MemPtr(cootWeights));
+
+  const arma::fmat input(5, 13, arma::fill::randn);
+  const arma::fmat gy(7, 13, arma::fill::randn);
+  const coot::fmat cootInput(input);
+  const coot::fmat cootGy(gy);
+
+  arma::fmat output, delta, gradient(module.WeightSize(), 1);
+  coot::fmat cootOutput, cootDelta, cootGradient(module.WeightSize(), 1);
+
+  module.Forward(input, output);
+  cootModule.Forward(cootInput, cootOutput);
+  CheckMatrices(output, coot::conv_to<arma::fmat>::from(cootOutput), 1e-3);
+
+  module.Backward(input, output, gy, delta);
+  cootModule.Backward(cootInput, cootOutput, cootGy, cootDelta);
+  CheckMatrices(delta, coot::conv_to<arma::fmat>::from(cootDelta), 1e-3);
+
+  module.Gradient(input, gy, gradient);
+  cootModule.Gradient(cootInput, cootGy, cootGradient);
+  CheckMatrices(gradient, coot::conv_to<arma::fmat>::from(cootGradient),
+      1e-3);
+}
+
+#endif
@@ -0,0 +1,264 @@
+/**
+ * @file tests/ann/layer/lookup.cpp
+ * @author Marcus Edel
+ *
+ * Tests the Lookup layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann.hpp>
+
+#include "../../test_catch_tools.hpp"
+#include "../../catch.hpp"
+#include "../../serialization.hpp"
+#include "../ann_test_tools.hpp"
+
+using namespace mlpack;
+
+/**
+ * Simple lookup module test.
+ */
+TEST_CASE("SimpleLookupLayerTest", "[ANNLayerTest]")
+{
+  const size_t vocabSize = 10;
+  const size_t embeddingSize = 2;
+  const size_t seqLength = 3;
+  const size_t batchSize = 4;
+
+  arma::mat output, input, delta;
+
+  Lookup module(vocabSize, embeddingSize);
+  arma::mat weights(vocabSize * embeddingSize, 1);
+  module.InputDimensions() = std::vector<size_t>({ seqLength });
+  module.ComputeOutputDimensions();
+  module.SetWeights(weights.memptr());
+  module.Parameters().randu();
+
+  REQUIRE(module.OutputDimensions().size() == 2);
+  REQUIRE(module.OutputDimensions()[0] == embeddingSize);
+  REQUIRE(module.OutputDimensions()[1] == seqLength);
+
+  // Test the Forward function.
+  input = arma::zeros(seqLength, batchSize);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    input(i) = RandInt(0, vocabSize);
+
+  output.set_size(embeddingSize * seqLength, batchSize);
+  module.Forward(input, output);
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    for (size_t s = 0; s < seqLength; ++s)
+    {
+      CheckMatrices(output.submat(s * embeddingSize, i,
+          (s + 1) * embeddingSize - 1, i),
+          module.Parameters().col((size_t) input(s, i)));
+    }
+  }
+
+  // The tokens are not differentiable.
+  delta.set_size(seqLength, batchSize);
+  module.Backward(input, output, output, delta);
+  REQUIRE(arma::accu(arma::abs(delta)) == 0.0);
+
+  // Test the Gradient function: each element of the error is added to the
+  // embedding of its token, and the sparse gradient is the same.
+  arma::mat error = 0.01 * arma::randu(embeddingSize * seqLength, batchSize);
+  arma::mat gradient(module.WeightSize(), 1);
+  module.Gradient(input, error, gradient);
+  REQUIRE(arma::accu(error) == Approx(arma::accu(gradient)).epsilon(1e-7));
+
+  arma::sp_mat sparseGradient;
+  module.SparseGradient(input, error, sparseGradient);
+  REQUIRE(sparseGradient.n_rows == module.WeightSize());
+  REQUIRE(sparseGradient.n_cols == 1);
+  CheckMatrices(arma::mat(sparseGradient), gradient);
+}
+
+/**
+ * Lookup layer numerical gradient test.
+ */
+TEST_CASE("GradientLookupLayerTest", "[ANNLayerTest]")
+{
+  // Lookup function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input.set_size(seqLength, batchSize);
+      for (size_t i = 0; i < input.n_elem; ++i)
+        input(i) = RandInt(0, vocabSize);
+
+      target.set_size(1, batchSize);
+      for (size_t i = 0; i < batchSize; ++i)
+        target(i) = RandInt(0, vocabSize);
+
+      model = new FFN<NegativeLogLikelihood, GlorotInitialization>();
+      model->ResetData(input, target);
+      model->Add<Lookup>(vocabSize, embeddingSize);
+      model->Add<Linear>(vocabSize);
+      model->Add<LogSoftMax>();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, batchSize);
+      model->Gradient(model->Parameters(), 0, gradient, batchSize);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood, GlorotInitialization>* model;
+    arma::mat input, target;
+
+    const size_t seqLength = 10;
+    const size_t embeddingSize = 8;
+    const size_t vocabSize = 20;
+    const size_t batchSize = 4;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-6);
+}
+
+/**
+ * Make sure that the sparse gradient of a network with a Lookup layer is the
+ * same as the dense gradient, and that an optimizer step with the sparse
+ * gradient only changes the embeddings of the tokens of its batch, while a
+ * dense optimizer step with momentum also changes the others.
+ */
+TEST_CASE("LookupLayerSparseGradientTest", "[ANNLayerTest]")
+{
+  const size_t vocabSize = 1000;
+  const size_t embeddingSize = 4;
+  const size_t seqLength = 3;
+
+  // The first batch only uses the first 25 tokens, and the second batch only
+  // uses the next 25 tokens.
+  arma::mat input(seqLength, 40);
+  arma::mat target(1, 40);
+  for (size_t i = 0; i < 20; ++i)
+  {
+    for (size_t s = 0; s < seqLength; ++s)
+    {
+      input(s, i) = RandInt(0, 25);
+      input(s, i + 20) = RandInt(25, 50);
+    }
+  }
+  for (size_t i = 0; i < target.n_elem; ++i)
+    target(i) = RandInt(0, 3);
+
+  FFN<NegativeLogLikelihood> model;
+  model.Add<Lookup>(vocabSize, embeddingSize);
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.ResetData(input, target);
+  model.Reset(seqLength);
+
+  arma::mat gradient;
+  arma::sp_mat sparseGradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 20);
+  const double sparseObjective = model.EvaluateWithGradient(
+      model.Parameters(), 0, sparseGradient, 20);
+  REQUIRE(objective == Approx(sparseObjective).epsilon(1e-10));
+  CheckMatrices(arma::mat(sparseGradient), gradient, 1e-8);
+
+  // The embeddings of the tokens that are not in the batch get no gradient.
+  REQUIRE(sparseGradient.n_nonzero <= 25 * embeddingSize +
+      (model.Parameters().n_elem - vocabSize * embeddingSize));
+
+  // Take one step on the first batch, and two steps on both batches, with the
+  // same starting parameters, without and with sparse gradients.
+  const arma::mat startingParameters = model.Parameters();
+  const arma::mat firstInput = input.cols(0, 19);
+  const arma::mat firstTarget = target.cols(0, 19);
+
+  ens::StandardSGD oneStep(0.01, 20, 20, -1.0, false);
+  ens::StandardSGD twoSteps(0.01, 20, 40, -1.0, false);
+  model.TrainSparse(firstInput, firstTarget, oneStep);
+  const arma::mat sparseOneStep = model.Parameters();
+  model.Parameters() = startingParameters;
+  model.TrainSparse(input, target, twoSteps);
+  const arma::mat sparseTwoSteps = model.Parameters();
+
+  ens::MomentumSGD momentumOneStep(0.01, 20, 20, -1.0, false,
+      ens::MomentumUpdate(0.9));
+  ens::MomentumSGD momentumTwoSteps(0.01, 20, 40, -1.0, false,
+      ens::MomentumUpdate(0.9));
+  model.Parameters() = startingParameters;
+  model.Train(firstInput, firstTarget, momentumOneStep);
+  const arma::mat denseOneStep = model.Parameters();
+  model.Parameters() = startingParameters;
+  model.Train(input, target, momentumTwoSteps);
+  const arma::mat denseTwoSteps = model.Parameters();
+
+  const size_t firstEnd = 25 * embeddingSize - 1;
+  const size_t secondEnd = 50 * embeddingSize - 1;
+  const size_t tableEnd = vocabSize * embeddingSize - 1;
+
+  // The first step changes the embeddings of the first batch only.
+  REQUIRE(arma::any(arma::vectorise(sparseOneStep.rows(0, firstEnd) !=
+      startingParameters.rows(0, firstEnd))));
+  REQUIRE(arma::all(arma::vectorise(sparseOneStep.rows(firstEnd + 1,
+      tableEnd) == startingParameters.rows(firstEnd + 1, tableEnd))));
+
+  // With sparse gradients, the second step changes the embeddings of the
+  // second batch only; the embeddings of the first batch stay exactly the same.
+  REQUIRE(arma::all(arma::vectorise(sparseTwoSteps.rows(0, firstEnd) ==
+      sparseOneStep.rows(0, firstEnd))));
+  REQUIRE(arma::any(arma::vectorise(sparseTwoSteps.rows(firstEnd + 1,
+      secondEnd) != startingParameters.rows(firstEnd + 1, secondEnd))));
+  REQUIRE(arma::all(arma::vectorise(sparseTwoSteps.rows(secondEnd + 1,
+      tableEnd) == startingParameters.rows(secondEnd + 1, tableEnd))));
+
+  // With momentum, the second dense step also moves the embeddings of the
+  // first batch, which are not in the second batch.
+  REQUIRE(arma::any(arma::vectorise(denseTwoSteps.rows(0, firstEnd) !=
+      denseOneStep.rows(0, firstEnd))));
+}
+
+/**
+ * Make sure that a token outside of the vocabulary is reported with an
+ * exception.
+ */
+TEST_CASE("LookupLayerInvalidTokenTest", "[ANNLayerTest]")
+{
+  Lookup module(10, 2);
+  arma::mat weights(module.WeightSize(), 1, arma::fill::randu);
+  module.InputDimensions() = std::vector<size_t>({ 3 });
+  module.ComputeOutputDimensions();
+  module.SetWeights(weights.memptr());
+
+  arma::mat input("0 1 2; 3 4 5; 6 7 8");
+  arma::mat output(6, 3);
+  module.Forward(input, output);
+
+  input(1, 2) = 10;
+  REQUIRE_THROWS_AS(module.Forward(input, output), std::invalid_argument);
+  input(1, 2) = -1;
+  REQUIRE_THROWS_AS(module.Forward(input, output), std::invalid_argument);
+}
+
+/**
+ * Test that the functions that can access the parameters of the
+ * Lookup layer work.
+ */
+TEST_CASE("LookupLayerParametersTest", "[ANNLayerTest]")
+{
+  // Parameter order : vocabSize, embeddingSize.
+  Lookup layer(100, 8);
+
+  // Make sure we can get the parameters successfully.
+  REQUIRE(layer.VocabSize() == 100);
+  REQUIRE(layer.EmbeddingSize() == 8);
+  REQUIRE(layer.WeightSize() == 800);
+}
@@ -112,3 +112,72 @@ TEST_CASE("MaxPoolingTestCase", "[ANNLayerTest]")
   REQUIRE(output.n_elem == 4);
   REQUIRE(output.n_cols == 1);
 }
+
+/**
+ * Compare the forward and backward passes of MaxPooling with a direct
+ * computation, for the specialized kernel sizes, a generic one, windows cut by
+ * the border of the input, and a window too large for compact offsets.
+ */
+TEST_CASE("MaxPoolingReferenceTest", "[ANNLayerTest]")
+{
+  // Kernel width, kernel height, stride width, stride height, floor.
+  const size_t configs[5][5] = { { 2, 2, 2, 2, 1 }, { 3, 3, 2, 2, 0 },
+      { 3, 2, 1, 2, 1 }, { 2, 3, 3, 1, 0 }, { 17, 17, 1, 1, 1 } };
+  const size_t rows = 19, cols = 18, channels = 3, points = 2;
+
+  for (size_t c = 0; c < 5; ++c)
+  {
+    const size_t kw = configs[c][0], kh = configs[c][1];
+    const size_t sw = configs[c][2], sh = configs[c][3];
+    MaxPooling module(kw, kh, sw, sh, configs[c][4] == 1);
+    module.Training() = true;
+    module.InputDimensions() = std::vector<size_t>({ rows, cols, channels });
+    module.ComputeOutputDimensions();
+    const size_t outRows = module.OutputDimensions()[0];
+    const size_t outCols = module.OutputDimensions()[1];
+
+    arma::mat input(rows * cols * channels, points, arma::fill::randn);
+    arma::mat output(module.OutputSize(), points);
+    module.Forward(input, output);
+
+    arma::mat gy(module.OutputSize(), points, arma::fill::randn);
+    arma::mat g(input.n_rows, points);
+    module.Backward(input, output, gy, g);
+
+    // Compute the maximum of each window, cut by the border of the input if
+    // necessary, and its gradient.
+    arma::cube inputCube(input.memptr(), rows, cols, channels * points, false,
+        true);
+    arma::cube gyCube(gy.memptr(), outRows, outCols, channels * points, false,
+        true);
+    arma::cube expectedOutput(outRows, outCols, channels * points);
+    arma::cube expectedG(rows, cols, channels * points, arma::fill::zeros);
+    for (size_t s = 0; s < inputCube.n_slices; ++s)
+    {
+      for (size_t j = 0; j < outCols; ++j)
+      {
+        for (size_t i = 0; i < outRows; ++i)
+        {
+          const size_t rowEnd = std::min(i * sw + kw, rows) - 1;
+          const size_t colEnd = std::min(j * sh + kh, cols) - 1;
+          arma::mat window = inputCube.slice(s).submat(i * sw, j * sh, rowEnd,
+              colEnd);
+          const size_t index = window.index_max();
+          expectedOutput(i, j, s) = window[index];
+          expectedG(i * sw + index % window.n_rows,
+              j * sh + index / window.n_rows, s) += gyCube(i, j, s);
+        }
+      }
+    }
+
+    CheckMatrices(output, arma::mat(expectedOutput.memptr(), output.n_rows,
+        points));
+    CheckMatrices(g, arma::mat(expectedG.memptr(), g.n_rows, points));
+
+    // The result should not change when the offsets are not stored.
+    module.Training() = false;
+    arma::mat testOutput(module.OutputSize(), points);
+    module.Forward(input, testOutput);
+    CheckMatrices(output, testOutput);
+  }
+}
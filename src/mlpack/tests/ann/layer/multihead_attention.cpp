@@ -231,3 +231,64 @@ TEST_CASE("GradientMultiheadAttentionTest", "[ANNLayerTest]")
 
   REQUIRE(CheckGradient(function) <= 3e-06);
 }
+
+/**
+ * Make sure that the tiled attention gives the same results as the attention
+ * that stores its scores, for tiles that do not divide the sequence lengths.
+ */
+TEST_CASE("TiledMultiheadAttentionTest", "[ANNLayerTest]")
+{
+  const size_t tgtSeqLen = 5;
+  const size_t embedDim = 4;
+  const size_t numHeads = 2;
+  const size_t batchSize = 3;
+
+  for (const bool selfAttention : { true, false })
+  {
+    const size_t srcSeqLen = selfAttention ? tgtSeqLen : 7;
+
+    arma::mat attnMask = arma::zeros(tgtSeqLen, srcSeqLen);
+    for (size_t i = 0; i < tgtSeqLen; ++i)
+    {
+      for (size_t j = i + 1; j < srcSeqLen; ++j)
+        attnMask(i, j) = std::numeric_limits<double>::lowest();
+    }
+
+    arma::mat keyPaddingMask = arma::zeros(1, srcSeqLen);
+    keyPaddingMask(srcSeqLen - 1) = std::numeric_limits<double>::lowest();
+
+    MultiheadAttention module(tgtSeqLen, numHeads, attnMask, keyPaddingMask,
+        selfAttention);
+    MultiheadAttention tiledModule(tgtSeqLen, numHeads, attnMask,
+        keyPaddingMask, selfAttention, 2);
+    REQUIRE(tiledModule.TileSize() == 2);
+
+    const size_t inputSeqLen = selfAttention ? srcSeqLen :
+        (tgtSeqLen + 2 * srcSeqLen);
+    module.InputDimensions() = { embedDim, inputSeqLen };
+    module.ComputeOutputDimensions();
+    tiledModule.InputDimensions() = { embedDim, inputSeqLen };
+    tiledModule.ComputeOutputDimensions();
+
+    arma::mat weights(module.WeightSize(), 1, arma::fill::randu);
+    module.SetWeights(weights.memptr());
+    tiledModule.SetWeights(weights.memptr());
+
+    arma::mat input(embedDim * inputSeqLen, batchSize, arma::fill::randu);
+    arma::mat output, tiledOutput;
+    module.Forward(input, output);
+    tiledModule.Forward(input, tiledOutput);
+    CheckMatrices(output, tiledOutput, 1e-8);
+
+    arma::mat gy(output.n_rows, batchSize, arma::fill::randu);
+    arma::mat g, tiledG;
+    module.Backward(input, output, gy, g);
+    tiledModule.Backward(input, tiledOutput, gy, tiledG);
+    CheckMatrices(g, tiledG, 1e-8);
+
+    arma::mat gradient, tiledGradient;
+    module.Gradient(input, gy, gradient);
+    tiledModule.Gradient(input, gy, tiledGradient);
+    CheckMatrices(gradient, tiledGradient, 1e-8);
+  }
+}
@@ -0,0 +1,62 @@
+/**
+ * @file tests/ann/layer/quantized_convolution.cpp
+ *
+ * Tests the QuantizedConvolution layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann.hpp>
+
+#include "../../test_catch_tools.hpp"
+#include "../../catch.hpp"
+#include "../../serialization.hpp"
+#include "../ann_test_tools.hpp"
+
+using namespace mlpack;
+
+/**
+ * Make sure that the quantized copy of a Convolution layer gives nearly the
+ * same output as the Convolution layer, with strides and uneven padding.
+ */
+TEST_CASE("QuantizedConvolutionLayerTest", "[ANNLayerTest]")
+{
+  for (const bool useBias : { true, false })
+  {
+    Convolution module(4, 3, 2, 2, 1, std::tuple<size_t, size_t>(1, 2),
+        std::tuple<size_t, size_t>(0, 1), "none", useBias);
+    module.InputDimensions() = std::vector<size_t>({ 9, 8, 3 });
+    module.ComputeOutputDimensions();
+    arma::mat weights(module.WeightSize(), 1, arma::fill::randn);
+    module.SetWeights(weights.memptr());
+
+    QuantizedConvolution* quantized = module.QuantizedCopy();
+    REQUIRE(quantized->Maps() == 4);
+    REQUIRE(quantized->Bias().is_empty() == !useBias);
+    quantized->InputDimensions() = std::vector<size_t>({ 9, 8, 3 });
+    REQUIRE(quantized->OutputDimensions() == module.OutputDimensions());
+
+    arma::mat input(9 * 8 * 3, 5, arma::fill::randn);
+    arma::mat output(module.OutputSize(), 5);
+    arma::mat quantizedOutput(module.OutputSize(), 5);
+    module.Forward(input, output);
+    quantized->Forward(input, quantizedOutput);
+
+    REQUIRE(arma::norm(output - quantizedOutput) / arma::norm(output) < 0.02);
+
+    // The quantized layer cannot be trained.
+    arma::mat delta(arma::size(input));
+    REQUIRE_THROWS_AS(quantized->Backward(input, quantizedOutput,
+        quantizedOutput, delta), std::logic_error);
+
+    // The number of input maps must match.
+    quantized->InputDimensions() = std::vector<size_t>({ 9, 8, 2 });
+    REQUIRE_THROWS_AS(quantized->ComputeOutputDimensions(),
+        std::invalid_argument);
+
+    delete quantized;
+  }
+}
@@ -0,0 +1,87 @@
+/**
+ * @file tests/ann/layer/quantized_linear.cpp
+ *
+ * Tests the QuantizedLinear layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann.hpp>
+
+#include "../../test_catch_tools.hpp"
+#include "../../catch.hpp"
+#include "../../serialization.hpp"
+#include "../ann_test_tools.hpp"
+
+using namespace mlpack;
+
+/**
+ * Make sure that the quantized copy of a Linear layer gives nearly the same
+ * output as the Linear layer.
+ */
+TEST_CASE("QuantizedLinearLayerTest", "[ANNLayerTest]")
+{
+  Linear module(20);
+  module.InputDimensions() = std::vector<size_t>({ 5, 6 });
+  module.ComputeOutputDimensions();
+  arma::mat weights(module.WeightSize(), 1, arma::fill::randn);
+  module.SetWeights(weights.memptr());
+
+  Layer<arma::mat>* quantized = module.QuantizedCopy();
+  REQUIRE(quantized != NULL);
+  quantized->InputDimensions() = std::vector<size_t>({ 5, 6 });
+  REQUIRE(quantized->OutputSize() == 20);
+  REQUIRE(quantized->WeightSize() == 0);
+
+  arma::mat input(30, 16, arma::fill::randn);
+  arma::mat output(20, 16), quantizedOutput(20, 16);
+  module.Forward(input, output);
+  quantized->Forward(input, quantizedOutput);
+
+  REQUIRE(arma::norm(output - quantizedOutput) / arma::norm(output) < 0.02);
+
+  // The quantized layer cannot be trained.
+  arma::mat delta(30, 16);
+  REQUIRE_THROWS_AS(quantized->Backward(input, quantizedOutput,
+      quantizedOutput, delta), std::logic_error);
+
+  // The quantized layer can only be used with the input size it was made for.
+  QuantizedLinear* copy = (QuantizedLinear*) quantized->Clone();
+  copy->InputDimensions() = std::vector<size_t>({ 29 });
+  REQUIRE_THROWS_AS(copy->ComputeOutputDimensions(), std::invalid_argument);
+
+  delete copy;
+  delete quantized;
+}
+
+/**
+ * Make sure that the quantized copy of a LinearNoBias layer gives nearly the
+ * same output as the LinearNoBias layer.
+ */
+TEST_CASE("QuantizedLinearNoBiasLayerTest", "[ANNLayerTest]")
+{
+  LinearNoBias module(7);
+  module.InputDimensions() = std::vector<size_t>({ 40 });
+  module.ComputeOutputDimensions();
+  arma::mat weights(module.WeightSize(), 1, arma::fill::randu);
+  module.SetWeights(weights.memptr());
+
+  QuantizedLinear* quantized = module.QuantizedCopy();
+  REQUIRE(quantized->Bias().is_empty());
+  quantized->InputDimensions() = std::vector<size_t>({ 40 });
+  quantized->ComputeOutputDimensions();
+
+  // Use only non-negative inputs, so that the zero point of the quantized
+  // input is 0.
+  arma::mat input(40, 9, arma::fill::randu);
+  arma::mat output(7, 9), quantizedOutput(7, 9);
+  module.Forward(input, output);
+  quantized->Forward(input, quantizedOutput);
+
+  REQUIRE(arma::norm(output - quantizedOutput) / arma::norm(output) < 0.02);
+
+  delete quantized;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file tests/ann/layer/separable_convolution.cpp
+ *
+ * Tests the SeparableConvolution layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann.hpp>
+
+#include "../../test_catch_tools.hpp"
+#include "../../catch.hpp"
+#include "../../serialization.hpp"
+#include "../ann_test_tools.hpp"
+
+using namespace mlpack;
+
+/**
+ * Make sure that the separable convolution gives the same results as a
+ * depthwise grouped convolution followed by a 1x1 convolution.
+ */
+TEST_CASE("SeparableConvolutionEquivalenceTest", "[ANNLayerTest]")
+{
+  // Three input maps, two depthwise filters for each input map, and five
+  // output maps.
+  SeparableConvolution layer(5, 3, 2, 2, 2, 1, 1, 1);
+  GroupedConvolution depthwise(6, 3, 2, 3, 2, 1, 1, 1, "none", false);
+  Convolution pointwise(5, 1, 1);
+
+  layer.InputDimensions() = std::vector<size_t>({ 9, 8, 3 });
+  layer.ComputeOutputDimensions();
+  depthwise.InputDimensions() = layer.InputDimensions();
+  depthwise.ComputeOutputDimensions();
+  pointwise.InputDimensions() = depthwise.OutputDimensions();
+  pointwise.ComputeOutputDimensions();
+  REQUIRE(layer.OutputDimensions() == pointwise.OutputDimensions());
+  REQUIRE(layer.WeightSize() ==
+      depthwise.WeightSize() + pointwise.WeightSize());
+
+  arma::mat weights(layer.WeightSize(), 1, arma::fill::randn);
+  arma::mat depthwiseWeights = weights.rows(0, depthwise.WeightSize() - 1);
+  arma::mat pointwiseWeights = weights.rows(depthwise.WeightSize(),
+      weights.n_elem - 1);
+  layer.SetWeights(weights.memptr());
+  depthwise.SetWeights(depthwiseWeights.memptr());
+  pointwise.SetWeights(pointwiseWeights.memptr());
+
+  arma::mat input(9 * 8 * 3, 4, arma::fill::randu);
+  arma::mat output(layer.OutputSize(), 4);
+  arma::mat depthwiseOutput(depthwise.OutputSize(), 4);
+  arma::mat pointwiseOutput(pointwise.OutputSize(), 4);
+  layer.Forward(input, output);
+  depthwise.Forward(input, depthwiseOutput);
+  pointwise.Forward(depthwiseOutput, pointwiseOutput);
+  CheckMatrices(output, pointwiseOutput);
+
+  arma::mat error(layer.OutputSize(), 4, arma::fill::randu);
+  arma::mat delta(input.n_rows, 4), depthwiseDelta(input.n_rows, 4);
+  arma::mat pointwiseDelta(depthwise.OutputSize(), 4);
+  layer.Backward(input, output, error, delta);
+  pointwise.Backward(depthwiseOutput, pointwiseOutput, error, pointwiseDelta);
+  depthwise.Backward(input, depthwiseOutput, pointwiseDelta, depthwiseDelta);
+  CheckMatrices(delta, depthwiseDelta);
+
+  arma::mat gradient(layer.WeightSize(), 1);
+  arma::mat depthwiseGradient(depthwise.WeightSize(), 1);
+  arma::mat pointwiseGradient(pointwise.WeightSize(), 1);
+  layer.Gradient(input, error, gradient);
+  depthwise.Gradient(input, pointwiseDelta, depthwiseGradient);
+  pointwise.Gradient(depthwiseOutput, error, pointwiseGradient);
+  CheckMatrices(gradient, arma::join_cols(depthwiseGradient,
+      pointwiseGradient));
+}
+
+/**
+ * Separable convolution layer numerical gradient test.
+ */
+TEST_CASE("GradientSeparableConvolutionLayerTest", "[ANNLayerTest]")
+{
+  struct GradientFunction
+  {
+    GradientFunction() :
+        input(arma::randn(72, 256)),
+        target(arma::zeros(1, 256))
+    {
+      model = new FFN<NegativeLogLikelihood, RandomInitialization>();
+      model->ResetData(input, target);
+      model->Add<SeparableConvolution>(4, 3, 3, 2, 1, 1, 0, 0, "same");
+      model->Add<LogSoftMax>();
+
+      model->InputDimensions() = std::vector<size_t>({ 6, 6, 2 });
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 256);
+      model->Gradient(model->Parameters(), 0, gradient, 256);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood, RandomInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  REQUIRE(CheckGradient(function) < 1e-1);
+}
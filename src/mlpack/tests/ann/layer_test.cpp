@@ -30,15 +30,20 @@
 #include "layer/grouped_convolution.cpp"
 #include "layer/hard_tanh.cpp"
 #include "layer/identity.cpp"
+#include "layer/linear.cpp"
 #include "layer/linear3d.cpp"
 #include "layer/linear_no_bias.cpp"
 #include "layer/log_softmax.cpp"
+#include "layer/lookup.cpp"
 #include "layer/max_pooling.cpp"
 #include "layer/mean_pooling.cpp"
 #include "layer/padding.cpp"
 #include "layer/parametric_relu.cpp"
+#include "layer/quantized_convolution.cpp"
+#include "layer/quantized_linear.cpp"
 #include "layer/relu6.cpp"
 #include "layer/repeat.cpp"
+#include "layer/separable_convolution.cpp"
 #include "layer/softmax.cpp"
 #include "layer/softmin.cpp"
 #include "layer/ftswish.cpp"
@@ -1763,118 +1763,6 @@ TEST_CASE("SimpleJoinLayerTest", "[ANNLayerTest]")
 //   boost::apply_visitor(DeleteVisitor(), layer);
 // }
 
-/**
- * Simple lookup module test.
- *
-TEST_CASE("SimpleLookupLayerTest", "[ANNLayerTest]")
-{
-  const size_t vocabSize = 10;
-  const size_t embeddingSize = 2;
-  const size_t seqLength = 3;
-  const size_t batchSize = 4;
-
-  arma::mat output, input, gy, g, gradient;
-
-  Lookup module(vocabSize, embeddingSize);
-  module.Parameters().randu();
-
-  // Test the Forward function.
-  input = arma::zeros(seqLength, batchSize);
-  for (size_t i = 0; i < input.n_elem; ++i)
-  {
-    int token = RandInt(1, vocabSize);
-    input(i) = token;
-  }
-
-  module.Forward(input, output);
-  for (size_t i = 0; i < batchSize; ++i)
-  {
-    // The Lookup module uses index - 1 for the cols.
-    const double outputSum = accu(module.Parameters().cols(
-        ConvTo<arma::uvec>::From(input.col(i)) - 1));
-
-    REQUIRE(std::fabs(outputSum - accu(output.col(i))) <= 1e-5);
-  }
-
-  // Test the Gradient function.
-  arma::mat error = 0.01 * arma::randu(embeddingSize * seqLength, batchSize);
-  module.Gradient(input, error, gradient);
-
-  REQUIRE(std::fabs(accu(error) - accu(gradient)) <= 1e-07);
-}
-*/
-
-/**
- * Lookup layer numerical gradient test.
- *
-TEST_CASE("GradientLookupLayerTest", "[ANNLayerTest]")
-{
-  // Lookup function gradient instantiation.
-  struct GradientFunction
-  {
-    GradientFunction()
-    {
-      input.set_size(seqLength, batchSize);
-      for (size_t i = 0; i < input.n_elem; ++i)
-      {
-        input(i) = RandInt(1, vocabSize);
-      }
-      target = arma::zeros(vocabSize, batchSize);
-      for (size_t i = 0; i < batchSize; ++i)
-      {
-        const size_t targetWord = RandInt(1, vocabSize);
-        target(targetWord, i) = 1;
-      }
-
-      model = new FFN<BCELoss<>, GlorotInitialization>(BCELoss<>(1e-10, false));
-      model->ResetData(input, target);
-      model->Add<Lookup>(vocabSize, embeddingSize);
-      model->Add<Linear>(embeddingSize * seqLength, vocabSize);
-      model->Add<Softmax>();
-    }
-
-    ~GradientFunction()
-    {
-      delete model;
-    }
-
-    double Gradient(arma::mat& gradient) const
-    {
-      double error = model->Evaluate(model->Parameters(), 0, batchSize);
-      model->Gradient(model->Parameters(), 0, gradient, batchSize);
-      return error;
-    }
-
-    arma::mat& Parameters() { return model->Parameters(); }
-
-    FFN<BCELoss<>, GlorotInitialization>* model;
-    arma::mat input, target;
-
-    const size_t seqLength = 10;
-    const size_t embeddingSize = 8;
-    const size_t vocabSize = 20;
-    const size_t batchSize = 4;
-  } function;
-
-  REQUIRE(CheckGradient(function) <= 1e-6);
-}
-*/
-
-/**
- * Test that the functions that can access the parameters of the
- * Lookup layer work.
- *
-TEST_CASE("LookupLayerParametersTest", "[ANNLayerTest]")
-{
-  // Parameter order : vocabSize, embedingSize.
-  Lookup layer(100, 8);
-
-  // Make sure we can get the parameters successfully.
-  REQUIRE(layer.VocabSize() == 100);
-  REQUIRE(layer.EmbeddingSize() == 8);
-}
-*/
-
 /**
  * Simple test for the NearestInterpolation layer
  *
@@ -1,5 +1,5 @@
 /**
- * @file tests/rbm_network_test.cpp
+ * @file tests/ann/rbm_network_test.cpp
  * @author Kris Singh
  * @author Shikhar Jaiswal
  *
@@ -26,7 +26,8 @@
 #include <mlpack/methods/softmax_regression/softmax_regression.hpp>
 #include <ensmallen.hpp>
 
-#include "catch.hpp"
+#include "../catch.hpp"
+#include "../serialization.hpp"
 
 using namespace mlpack;
 using namespace ens;
@@ -249,3 +250,71 @@ TEST_CASE("MiscTest", "[RBMNetworkTest]")
   X = X.t();
   BuildVanillaNetwork<arma::Mat<float>>(X, 2);
 }
+
+/*
+ * Make sure that the gradient of a batch is the sum of the gradients of its
+ * points.
+ */
+TEST_CASE("BinaryRBMBatchPhaseTest", "[RBMNetworkTest]")
+{
+  arma::mat data(6, 20, arma::fill::randu);
+  GaussianInitialization gaussian(0, 0.1);
+  RBM<GaussianInitialization> model(data, gaussian, data.n_rows, 4, 20);
+  model.Reset();
+
+  arma::mat batchGradient(model.Parameters().n_elem, 1), pointGradient,
+      sumGradient;
+  model.Phase(data, batchGradient);
+
+  sumGradient.zeros(model.Parameters().n_elem, 1);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    pointGradient.set_size(model.Parameters().n_elem, 1);
+    model.Phase(arma::mat(data.col(i)), pointGradient);
+    sumGradient += pointGradient;
+  }
+
+  REQUIRE(arma::approx_equal(batchGradient, sumGradient, "absdiff", 1e-10));
+}
+
+/*
+ * Make sure that the samples of an RBM only depend on the random seed, and
+ * that persistent chains are kept across batches of different sizes.
+ */
+TEST_CASE("BinaryRBMPersistentGibbsTest", "[RBMNetworkTest]")
+{
+  arma::mat data(8, 30, arma::fill::randu);
+  data = arma::round(data);
+  GaussianInitialization gaussian(0, 0.1);
+
+  RandomSeed(12);
+  RBM<GaussianInitialization> model(data, gaussian, data.n_rows, 5, 10, 2, 1,
+      2, 8, 1, true);
+  model.Reset();
+  RandomSeed(12);
+  RBM<GaussianInitialization> model2(data, gaussian, data.n_rows, 5, 10, 2, 1,
+      2, 8, 1, true);
+  model2.Reset();
+  model2.Parameters() = model.Parameters();
+
+  arma::mat samples, samples2;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    model.Gibbs(data.cols(10 * i, 10 * i + 9), samples);
+    model2.Gibbs(data.cols(10 * i, 10 * i + 9), samples2);
+
+    REQUIRE(samples.n_rows == data.n_rows);
+    REQUIRE(samples.n_cols == 10);
+    REQUIRE(arma::all(arma::vectorise((samples == 0) || (samples == 1))));
+    CheckMatrices(samples, samples2);
+  }
+
+  // A smaller batch continues the first chains.
+  model.Gibbs(data.cols(0, 3), samples);
+  REQUIRE(samples.n_cols == 4);
+
+  // Training with ensmallen goes through EvaluateWithGradient().
+  ens::StandardSGD msgd(0.03, 10, 60, 0, true);
+  const double objVal = model.Train(msgd);
+  REQUIRE(std::isfinite(objVal));
+}
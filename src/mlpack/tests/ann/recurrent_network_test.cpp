@@ -15,6 +15,7 @@
 
 #include "../catch.hpp"
 #include "../serialization.hpp"
+#include "ann_test_tools.hpp"
 
 using namespace mlpack;
 using namespace ens;
@@ -203,6 +204,39 @@ TEST_CASE("LSTMBatchSizeTest", "[RecurrentNetworkTest]")
   BatchSizeTest<Linear>();
 }
 
+/**
+ * Check the gradient of an RNN with an LSTM layer numerically, with a batch of
+ * more than one sequence.
+ */
+TEST_CASE("GradientLSTMLayerTest", "[RecurrentNetworkTest]")
+{
+  struct GradientFunction
+  {
+    GradientFunction() :
+        model(5),
+        input(arma::randu(3, 2, 5)),
+        target(arma::randu(2, 2, 5))
+    {
+      model.ResetData(input, target);
+      model.Add<Linear>(4);
+      model.Add<LSTM>(3);
+      model.Add<Linear>(2);
+    }
+
+    double Gradient(arma::mat& gradient)
+    {
+      return model.EvaluateWithGradient(model.Parameters(), 0, gradient, 2);
+    }
+
+    arma::mat& Parameters() { return model.Parameters(); }
+
+    RNN<MeanSquaredError> model;
+    arma::cube input, target;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-4);
+}
+
 /**
  * @brief Generates noisy sine wave and outputs the data and the labels that
  *        can be used directly for training and testing with RNN.
@@ -430,3 +464,143 @@ TEST_CASE("RNNFFNTest", "[RecurrentNetworkTest]")
   // Now, the weights should be the same!
   CheckMatrices(ffn.Parameters(), rnn.Parameters());
 }
+
+/**
+ * Check the gradient of an RNN whose first layer is an LSTM numerically, with
+ * a batch of sequences of different lengths.
+ */
+TEST_CASE("GradientLSTMVariableLengthTest", "[RecurrentNetworkTest]")
+{
+  struct GradientFunction
+  {
+    GradientFunction() :
+        model(5),
+        input(arma::randu(3, 3, 5)),
+        target(arma::randu(2, 3, 5))
+    {
+      model.ResetData(input, target, arma::urowvec({ 2, 5, 4 }));
+      model.Add<LSTM>(4);
+      model.Add<Linear>(2);
+    }
+
+    double Gradient(arma::mat& gradient)
+    {
+      return model.EvaluateWithGradient(model.Parameters(), 0, gradient, 3);
+    }
+
+    arma::mat& Parameters() { return model.Parameters(); }
+
+    RNN<MeanSquaredError> model;
+    arma::cube input, target;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-4);
+}
+
+/**
+ * Make sure that predicting a batch of sequences of different lengths gives
+ * the same results as predicting each sequence on its own, and that the steps
+ * after the end of each sequence are zero.
+ */
+TEST_CASE("RNNVariableLengthPredictTest", "[RecurrentNetworkTest]")
+{
+  RNN<MeanSquaredError> model;
+  model.Add<LSTM>(4);
+  model.Add<Linear>(2);
+
+  arma::cube input(3, 4, 6, arma::fill::randu);
+  const arma::urowvec lengths = { 3, 6, 1, 4 };
+
+  arma::cube output;
+  model.Predict(input, output, lengths, 3);
+  REQUIRE(output.n_rows == 2);
+  REQUIRE(output.n_cols == 4);
+  REQUIRE(output.n_slices == 6);
+
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    arma::cube sequence = input.tube(0, i, input.n_rows - 1, i);
+    sequence.resize(input.n_rows, 1, lengths[i]);
+
+    arma::cube sequenceOutput;
+    model.Predict(sequence, sequenceOutput);
+    for (size_t t = 0; t < input.n_slices; ++t)
+    {
+      if (t < lengths[i])
+      {
+        REQUIRE(arma::approx_equal(output.slice(t).col(i),
+            sequenceOutput.slice(t).col(0), "absdiff", 1e-8));
+      }
+      else
+      {
+        REQUIRE(arma::all(output.slice(t).col(i) == 0.0));
+      }
+    }
+  }
+}
+
+/**
+ * Check the gradient of a BRNN numerically, with merge layers and a batch of
+ * sequences of different lengths.
+ */
+TEST_CASE("GradientBRNNTest", "[RecurrentNetworkTest]")
+{
+  struct GradientFunction
+  {
+    GradientFunction(const bool sumMerge) :
+        model(sumMerge),
+        input(arma::randu(3, 3, 5)),
+        target(arma::randu(2, 3, 5))
+    {
+      model.ResetData(input, target, arma::urowvec({ 4, 2, 5 }));
+      model.Add<LSTM>(3);
+      model.Add<Linear>(3);
+      model.AddMerge<Sigmoid>();
+      model.AddMerge<Linear>(2);
+    }
+
+    double Gradient(arma::mat& gradient)
+    {
+      return model.EvaluateWithGradient(model.Parameters(), 0, gradient, 3);
+    }
+
+    arma::mat& Parameters() { return model.Parameters(); }
+
+    BRNN<MeanSquaredError> model;
+    arma::cube input, target;
+  };
+
+  GradientFunction concatFunction(false);
+  REQUIRE(CheckGradient(concatFunction) <= 1e-4);
+
+  GradientFunction sumFunction(true);
+  REQUIRE(CheckGradient(sumFunction) <= 1e-4);
+}
+
+/**
+ * Make sure that a BRNN uses the later steps of a sequence: the response of
+ * each step is the input of the next step, which only the backward direction
+ * can see.
+ */
+TEST_CASE("BRNNNextStepTest", "[RecurrentNetworkTest]")
+{
+  arma::cube input(1, 200, 5);
+  input.randn();
+  arma::cube responses(1, 200, 5);
+  responses.slice(input.n_slices - 1).zeros();
+  for (size_t t = 0; t + 1 < input.n_slices; ++t)
+    responses.slice(t) = input.slice(t + 1);
+
+  BRNN<MeanSquaredError> model;
+  model.Add<LSTM>(8);
+  model.AddMerge<Linear>(1);
+
+  ens::Adam optimizer(0.01, 32, 0.9, 0.999, 1e-8, 200 * 100);
+  model.Train(input, responses, optimizer);
+
+  arma::cube predictions;
+  model.Predict(input, predictions);
+  const double error = arma::accu(arma::square(predictions - responses)) /
+      responses.n_elem;
+  REQUIRE(error < 0.1);
+}
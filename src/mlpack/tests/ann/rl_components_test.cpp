@@ -262,6 +262,232 @@ TEST_CASE("RandomReplayTest", "[RLComponentsTest]")
   }
 }
 
+/**
+ * Make sure that StoreBatch() makes the n-step transitions of each environment
+ * from its own experiences only.
+ */
+TEST_CASE("RandomReplayStoreBatchTest", "[RLComponentsTest]")
+{
+  RandomReplay<MountainCar> replay(1, 10, 2);
+  MountainCar env;
+  std::vector<MountainCar::State> states(2, env.InitialSample());
+  std::vector<MountainCar::Action> actions(2);
+  arma::irowvec isEnd(2, arma::fill::zeros);
+
+  // With a discount of 0.5, the two-step reward of the first environment is
+  // 1 + 0.5 * 2 = 2, and the one of the second environment is 20.
+  replay.StoreBatch(states, actions, arma::rowvec("1 10"), states, isEnd, 0.5);
+  REQUIRE(replay.Size() == 0);
+  replay.StoreBatch(states, actions, arma::rowvec("2 20"), states, isEnd, 0.5);
+  REQUIRE(replay.Size() == 2);
+
+  arma::mat sampledState, sampledNextState;
+  std::vector<MountainCar::Action> sampledAction;
+  arma::rowvec sampledReward;
+  arma::irowvec sampledTerminal;
+  for (size_t i = 0; i < 20; ++i)
+  {
+    replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+        sampledTerminal);
+    const double reward = arma::as_scalar(sampledReward);
+    REQUIRE(((reward == Approx(2.0)) || (reward == Approx(20.0))));
+  }
+
+  // Without n-step transitions, the experiences are stored directly.
+  RandomReplay<MountainCar> directReplay(1, 3);
+  directReplay.StoreBatch(states, actions, arma::rowvec("1 2"), states, isEnd,
+      0.5);
+  directReplay.StoreBatch(states, actions, arma::rowvec("3 4"), states, isEnd,
+      0.5);
+  REQUIRE(directReplay.Size() == 3);
+}
+
+/**
+ * Make sure that the next states that are the state of a later transition are
+ * not stored again, and that they are still sampled correctly.
+ */
+TEST_CASE("RandomReplayNextStateMemoryTest", "[RLComponentsTest]")
+{
+  RandomReplay<CartPole> replay(32, 100);
+  CartPole env;
+  std::vector<arma::colvec> storedStates, storedNextStates;
+
+  // Store 150 transitions, so that the memory wraps around.
+  CartPole::State state = env.InitialSample();
+  for (size_t i = 0; i < 150; ++i)
+  {
+    CartPole::Action action;
+    action.action = (i % 2 == 0) ? CartPole::Action::actions::backward :
+        CartPole::Action::actions::forward;
+    CartPole::State nextState;
+    const double reward = env.Sample(state, action, nextState);
+    const bool isEnd = env.IsTerminal(nextState);
+    replay.Store(state, action, reward, nextState, isEnd, 0.9);
+    storedStates.push_back(state.Encode());
+    storedNextStates.push_back(nextState.Encode());
+
+    state = isEnd ? env.InitialSample() : nextState;
+  }
+
+  // Only the next states of the last transition of each episode are stored as
+  // copies.
+  REQUIRE(replay.NextStates().StoredNextStates() < 50);
+
+  arma::mat sampledState, sampledNextState;
+  std::vector<CartPole::Action> sampledAction;
+  arma::rowvec sampledReward;
+  arma::irowvec sampledTerminal;
+  for (size_t t = 0; t < 10; ++t)
+  {
+    replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+        sampledTerminal);
+    REQUIRE(sampledAction.size() == 32);
+    REQUIRE(sampledNextState.n_cols == 32);
+
+    // Find each sampled transition among the last 100 stored transitions.
+    for (size_t i = 0; i < 32; ++i)
+    {
+      bool found = false;
+      for (size_t j = 50; j < 150 && !found; ++j)
+      {
+        if (arma::approx_equal(sampledState.col(i), storedStates[j], "absdiff",
+            0.0))
+        {
+          CheckMatrices(sampledNextState.col(i), storedNextStates[j]);
+          found = true;
+        }
+      }
+      REQUIRE(found);
+    }
+  }
+}
+
+/**
+ * Make sure that the prioritized replay samples the stored transitions, with
+ * their own next states.
+ */
+TEST_CASE("PrioritizedReplaySampleTest", "[RLComponentsTest]")
+{
+  PrioritizedReplay<MountainCar> replay(16, 10, 0.6);
+  MountainCar env;
+  MountainCar::State state = env.InitialSample();
+  MountainCar::Action action;
+  action.action = MountainCar::Action::actions::forward;
+  for (size_t i = 0; i < 10; ++i)
+  {
+    MountainCar::State nextState;
+    env.Sample(state, action, nextState);
+    // The reward identifies the transition.
+    replay.Store(state, action, (double) i, nextState, false, 0.9);
+    state = nextState;
+  }
+
+  arma::mat sampledState, sampledNextState;
+  std::vector<MountainCar::Action> sampledAction;
+  arma::rowvec sampledReward;
+  arma::irowvec sampledTerminal;
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+
+  REQUIRE(sampledState.n_cols == 16);
+  REQUIRE(sampledAction.size() == 16);
+  REQUIRE(sampledReward.n_elem == 16);
+  for (size_t i = 0; i < 16; ++i)
+  {
+    REQUIRE(sampledReward[i] >= 0.0);
+    REQUIRE(sampledReward[i] <= 9.0);
+
+    // Every transition but the last has its next state stored by index, as
+    // the state of the following transition.
+    const size_t j = (size_t) sampledReward[i];
+    if (j + 1 < 10)
+    {
+      for (size_t k = 0; k < 16; ++k)
+      {
+        if (sampledReward[k] == j + 1)
+          CheckMatrices(sampledNextState.col(i), sampledState.col(k));
+      }
+    }
+  }
+  REQUIRE(replay.NextStates().StoredNextStates() == 1);
+}
+
+/**
+ * Make sure that published target parameters are read back in order.
+ */
+TEST_CASE("TargetParametersTest", "[RLComponentsTest]")
+{
+  arma::mat parameters(10, 1, arma::fill::randu);
+  TargetParameters<arma::mat> targetParameters(parameters);
+  REQUIRE(targetParameters.Version() == 0);
+
+  arma::mat read;
+  REQUIRE(targetParameters.Read(read) == 0);
+  CheckMatrices(read, parameters);
+
+  // Reading into a matrix of the right size must not reallocate it.
+  const double* readMemory = read.memptr();
+  for (size_t i = 1; i <= 3; ++i)
+  {
+    parameters += 1.0;
+    targetParameters.Publish(parameters);
+    REQUIRE(targetParameters.Version() == i);
+    REQUIRE(targetParameters.Read(read) == i);
+    CheckMatrices(read, parameters);
+    REQUIRE(read.memptr() == readMemory);
+  }
+}
+
+/**
+ * Step several copies of an environment together, and make sure that the
+ * copies whose episode ends are reset.
+ */
+TEST_CASE("VectorEnvironmentTest", "[RLComponentsTest]")
+{
+  VectorEnvironment<CartPole> environments(4, CartPole(), 10);
+  REQUIRE(environments.Copies() == 4);
+
+  size_t episodes = 0;
+  for (size_t step = 0; step < 25; ++step)
+  {
+    std::vector<CartPole::Action> actions(4);
+    for (size_t i = 0; i < actions.size(); ++i)
+    {
+      actions[i].action = static_cast<CartPole::Action::actions>(
+          RandInt(CartPole::Action::size));
+    }
+
+    std::vector<CartPole::State> nextStates;
+    arma::rowvec rewards;
+    arma::irowvec isTerminal;
+    environments.Step(actions, nextStates, rewards, isTerminal);
+    REQUIRE(nextStates.size() == 4);
+    REQUIRE(rewards.n_elem == 4);
+    REQUIRE(isTerminal.n_elem == 4);
+
+    // CartPole gives a reward of 1 for each step, and an episode has at most
+    // 10 steps.
+    for (double episodeReturn : environments.EpisodeReturns())
+      REQUIRE(episodeReturn <= 10.0);
+    episodes += environments.EpisodeReturns().size();
+
+    // Every copy must be in a state that is not terminal.
+    for (size_t i = 0; i < 4; ++i)
+      REQUIRE(!environments.Environments()[i].IsTerminal(
+          environments.States()[i]));
+  }
+
+  // Each copy must have ended at least two episodes.
+  REQUIRE(episodes >= 8);
+
+  arma::mat encodedStates;
+  environments.EncodedStates(encodedStates);
+  REQUIRE(encodedStates.n_rows == CartPole::State::dimension);
+  REQUIRE(encodedStates.n_cols == 4);
+  for (size_t i = 0; i < 4; ++i)
+    CheckMatrices(encodedStates.col(i), environments.States()[i].Encode());
+}
+
 /**
  * Construct a greedy policy instance and check if it works as
  * it should be.
@@ -15,6 +15,7 @@
 #include <mlpack/methods/linear_regression.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::data;
@@ -313,3 +314,87 @@ TEMPLATE_TEST_CASE("BayesianLinearRegressionTrainVariantTest",
   REQUIRE(blr5.MaxIterations() == 110);
   REQUIRE(blr5.Tolerance() == 1e-3);
 }
+
+// Check that updating the model with new batches gives the posterior of the
+// model trained on all the points, for fixed hyperparameters.
+TEST_CASE("BayesianLinearRegressionUpdateTest",
+          "[BayesianLinearRegressionTest]")
+{
+  arma::mat matX;
+  arma::rowvec y;
+  GenerateProblem(matX, y, 400, 10, 0.5);
+  // Shift the data so that centering matters.
+  matX += 3.0;
+
+  for (const bool center : { false, true })
+  {
+    for (const bool scale : { false, true })
+    {
+      BayesianLinearRegression<> blr(center, scale);
+      blr.Train(arma::mat(matX.cols(0, 299)), arma::rowvec(y.cols(0, 299)));
+
+      // The first batch is small enough for a low-rank update when the data is
+      // not scaled.
+      blr.Update(arma::mat(matX.cols(300, 302)),
+          arma::rowvec(y.cols(300, 302)));
+      blr.Update(arma::mat(matX.cols(303, 399)),
+          arma::rowvec(y.cols(303, 399)));
+      REQUIRE(blr.NumTrainingPoints() == 400);
+
+      // Compute the posterior on all the points with the same alpha and beta.
+      arma::mat phi = matX;
+      arma::rowvec t = y;
+      if (center)
+      {
+        CheckMatrices(blr.DataOffset(), arma::vec(mean(matX, 1)));
+        REQUIRE(blr.ResponsesOffset() == Approx(mean(y)).epsilon(1e-10));
+        phi.each_col() -= mean(matX, 1);
+        t -= mean(y);
+      }
+      if (scale)
+      {
+        CheckMatrices(blr.DataScale(), arma::vec(stddev(matX, 0, 1)));
+        phi.each_col() /= stddev(matX, 0, 1);
+      }
+
+      const arma::mat covariance = inv_sympd(blr.Alpha() *
+          arma::eye<arma::mat>(10, 10) + blr.Beta() * phi * phi.t());
+      const arma::vec omega = blr.Beta() * covariance * phi * t.t();
+      CheckMatrices(blr.Omega(), omega, 1e-4);
+
+      // The predictive uncertainties use the posterior covariance.
+      arma::rowvec predictions, stds;
+      blr.Predict(matX, predictions, stds);
+      const arma::rowvec expectedStds = sqrt(1.0 / blr.Beta() +
+          sum(phi % (covariance * phi), 0));
+      CheckMatrices(stds, expectedStds, 1e-4);
+    }
+  }
+}
+
+// Check that updating the hyperparameters from the statistics gives the same
+// model as training on all the points.
+TEST_CASE("BayesianLinearRegressionUpdateHyperparametersTest",
+          "[BayesianLinearRegressionTest]")
+{
+  arma::mat matX;
+  arma::rowvec y;
+  GenerateProblem(matX, y, 500, 8, 0.5);
+
+  BayesianLinearRegression<> blr(true, false, 1000, 1e-12);
+  blr.Train(matX, y);
+
+  BayesianLinearRegression<> blrUpdated(true, false, 1000, 1e-12);
+  blrUpdated.Train(arma::mat(matX.cols(0, 199)), arma::rowvec(y.cols(0, 199)));
+  blrUpdated.Update(arma::mat(matX.cols(200, 499)),
+      arma::rowvec(y.cols(200, 499)), true);
+
+  REQUIRE(blrUpdated.Alpha() == Approx(blr.Alpha()).epsilon(1e-6));
+  REQUIRE(blrUpdated.Beta() == Approx(blr.Beta()).epsilon(1e-6));
+  CheckMatrices(blrUpdated.Omega(), blr.Omega(), 1e-4);
+
+  // A model without statistics is trained by Update().
+  BayesianLinearRegression<> blrEmpty(true, false, 1000, 1e-12);
+  blrEmpty.Update(matX, y);
+  CheckMatrices(blrEmpty.Omega(), blr.Omega(), 1e-4);
+}
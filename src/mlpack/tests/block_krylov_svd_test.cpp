@@ -104,3 +104,59 @@ TEST_CASE("RandomizedBlockKrylovSVDNoisyLowRankTest", "[BlockKrylovSVDTest]")
   double error = arma::max(arma::abs(s1.subvec(0, rank) - s2.subvec(0, rank)));
   REQUIRE(error == Approx(0.0).margin(1e-4));
 }
+
+/**
+ * The randomized block Krylov SVD should also work in single precision.
+ */
+TEST_CASE("RandomizedBlockKrylovSVDFloatNoisyLowRankTest",
+          "[BlockKrylovSVDTest]")
+{
+  arma::mat data;
+  CreateNoisyLowRankMatrix(data, 200, 1000, 5, 0.5);
+  const arma::fmat fdata = arma::conv_to<arma::fmat>::from(data);
+
+  const size_t rank = 5;
+
+  arma::mat U1, V1;
+  arma::vec s1;
+  arma::svd_econ(U1, s1, V1, data);
+
+  arma::fmat U2, V2;
+  arma::fvec s2;
+  RandomizedBlockKrylovSVD rSVDB(fdata, U2, s2, V2, 10, rank, 20);
+
+  double error = arma::max(arma::abs(s1.subvec(0, rank) -
+      arma::conv_to<arma::vec>::from(s2.subvec(0, rank))));
+  REQUIRE(error == Approx(0.0).margin(1e-3));
+}
+
+/**
+ * The randomized block Krylov SVD computed from chunks of the data should
+ * give the same singular values as the exact SVD.
+ */
+TEST_CASE("RandomizedBlockKrylovSVDChunksTest", "[BlockKrylovSVDTest]")
+{
+  arma::mat data;
+  CreateNoisyLowRankMatrix(data, 200, 1000, 5, 0.5);
+
+  const size_t rank = 5;
+
+  arma::mat U1, V1, U2;
+  arma::vec s1, s2;
+  arma::svd_econ(U1, s1, V1, data);
+
+  RandomizedBlockKrylovSVD rSVDB(10, 20);
+  data::MatrixChunkLoader<arma::mat> loader(data, 128);
+  rSVDB.ApplyChunks(loader, U2, s2, rank);
+
+  REQUIRE(U2.n_rows == 200);
+  REQUIRE(U2.n_cols == s2.n_elem);
+
+  double error = arma::max(arma::abs(s1.subvec(0, rank) - s2.subvec(0, rank)));
+  REQUIRE(error == Approx(0.0).margin(1e-4));
+
+  // The left singular vectors should be orthonormal.
+  const arma::mat gram = U2.cols(0, rank).t() * U2.cols(0, rank);
+  REQUIRE(arma::norm(gram - arma::eye<arma::mat>(rank + 1, rank + 1), "frob") ==
+      Approx(0.0).margin(1e-6));
+}
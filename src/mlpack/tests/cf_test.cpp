@@ -501,7 +501,7 @@ void Serialization()
 TEMPLATE_TEST_CASE("CFGetRecommendationsAllUsersTest", "[CFTest]",
     RandomizedSVDPolicy, RegSVDPolicy, BatchSVDPolicy, NMFPolicy,
     SVDCompletePolicy, SVDIncompletePolicy, BiasSVDPolicy, SVDPlusPlusPolicy,
-    QUIC_SVDPolicy, BlockKrylovSVDPolicy)
+    QUIC_SVDPolicy, BlockKrylovSVDPolicy, ALSPolicy)
 {
   GetRecommendationsAllUsers<TestType>();
 }
@@ -513,7 +513,7 @@ TEMPLATE_TEST_CASE("CFGetRecommendationsAllUsersTest", "[CFTest]",
 TEMPLATE_TEST_CASE("CFGetRecommendationsQueriedUsersTest", "[CFTest]",
   RandomizedSVDPolicy, RegSVDPolicy, BatchSVDPolicy, NMFPolicy,
   SVDCompletePolicy, SVDIncompletePolicy, BiasSVDPolicy, SVDPlusPlusPolicy,
-  QUIC_SVDPolicy, BlockKrylovSVDPolicy)
+  QUIC_SVDPolicy, BlockKrylovSVDPolicy, ALSPolicy)
 {
   GetRecommendationsQueriedUser<TestType>();
 }
@@ -547,7 +547,7 @@ TEMPLATE_TEST_CASE("RecommendationAccuracyTest", "[CFTest]",
 TEMPLATE_TEST_CASE("CFPredictTest", "[CFTest]",
     RandomizedSVDPolicy, RegSVDPolicy, BatchSVDPolicy, NMFPolicy,
     SVDCompletePolicy, SVDIncompletePolicy, BiasSVDPolicy, SVDPlusPlusPolicy,
-    QUIC_SVDPolicy, BlockKrylovSVDPolicy)
+    QUIC_SVDPolicy, BlockKrylovSVDPolicy, ALSPolicy)
 {
   CFPredict<TestType>();
 }
@@ -558,7 +558,7 @@ TEMPLATE_TEST_CASE("CFPredictTest", "[CFTest]",
 TEMPLATE_TEST_CASE("CFBatchPredictTest", "[CFTest]",
     RandomizedSVDPolicy, RegSVDPolicy, BatchSVDPolicy, NMFPolicy,
     SVDCompletePolicy, SVDIncompletePolicy, BiasSVDPolicy, SVDPlusPlusPolicy,
-    QUIC_SVDPolicy, BlockKrylovSVDPolicy)
+    QUIC_SVDPolicy, BlockKrylovSVDPolicy, ALSPolicy)
 {
   BatchPredict<TestType>();
 }
@@ -569,7 +569,7 @@ TEMPLATE_TEST_CASE("CFBatchPredictTest", "[CFTest]",
  */
 TEMPLATE_TEST_CASE("TrainTest_1", "[CFTest]",
     RandomizedSVDPolicy, BatchSVDPolicy, NMFPolicy, SVDCompletePolicy,
-    SVDIncompletePolicy, QUIC_SVDPolicy, BlockKrylovSVDPolicy)
+    SVDIncompletePolicy, QUIC_SVDPolicy, BlockKrylovSVDPolicy, ALSPolicy)
 {
   TestType decomposition;
   Train(decomposition);
@@ -593,7 +593,7 @@ TEMPLATE_TEST_CASE("TrainTest_2", "[CFTest]",
 TEMPLATE_TEST_CASE("EmptyConstructorTrainTest", "[CFTest]",
   RandomizedSVDPolicy, RegSVDPolicy, BatchSVDPolicy, NMFPolicy,
   SVDCompletePolicy, SVDIncompletePolicy, BiasSVDPolicy, QUIC_SVDPolicy,
-  BlockKrylovSVDPolicy)
+  BlockKrylovSVDPolicy, ALSPolicy)
 {
   EmptyConstructorTrain<TestType>();
 }
@@ -603,7 +603,7 @@ TEMPLATE_TEST_CASE("EmptyConstructorTrainTest", "[CFTest]",
  */
 TEMPLATE_TEST_CASE("SerializationTest", "[CFTest]",
     RandomizedSVDPolicy, BatchSVDPolicy, NMFPolicy, SVDCompletePolicy,
-    SVDIncompletePolicy, QUIC_SVDPolicy, BlockKrylovSVDPolicy)
+    SVDIncompletePolicy, QUIC_SVDPolicy, BlockKrylovSVDPolicy, ALSPolicy)
 {
   Serialization<TestType>();
 }
@@ -721,3 +721,397 @@ TEST_CASE("CFPredictRegressionInterpolation", "[CFTest]")
             EuclideanSearch,
             RegressionInterpolation>(2.2);
 }
+
+/**
+ * Make sure that the user and item factors of each decomposition policy give
+ * the same ratings as GetRatingOfUser().
+ */
+TEMPLATE_TEST_CASE("CFUserItemFactorsTest", "[CFTest]",
+    RandomizedSVDPolicy, RegSVDPolicy, BatchSVDPolicy, NMFPolicy,
+    SVDCompletePolicy, SVDIncompletePolicy, BiasSVDPolicy, SVDPlusPlusPolicy,
+    QUIC_SVDPolicy, BlockKrylovSVDPolicy, ALSPolicy)
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  TestType decomposition;
+  CFType<TestType> c(dataset, decomposition, 5, 5, 30);
+
+  arma::mat itemFactors;
+  c.Decomposition().GetItemFactors(itemFactors);
+  REQUIRE(itemFactors.n_cols == c.CleanedData().n_rows);
+
+  for (size_t user = 0; user < 10; ++user)
+  {
+    arma::vec userFactors, ratings;
+    c.Decomposition().GetUserFactors(user, userFactors);
+    c.Decomposition().GetRatingOfUser(user, ratings);
+
+    arma::vec factorRatings = itemFactors.t() * userFactors;
+    REQUIRE(arma::approx_equal(factorRatings, ratings, "absdiff", 1e-5));
+  }
+}
+
+/**
+ * Make sure that the blocked computation of recommendations never recommends
+ * an item that the user has already rated, and that it recommends the best
+ * un-rated items.
+ */
+TEST_CASE("CFBlockedRecommendationsTest", "[CFTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  // With only one user for similarity, the ratings of a user are its own
+  // predicted ratings.
+  NMFPolicy decomposition;
+  CFType<NMFPolicy> c(dataset, decomposition, 1, 5, 30);
+
+  // More users than fit in one block.
+  arma::Col<size_t> users = arma::regspace<arma::Col<size_t>>(0, 99);
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(10, recommendations, users);
+  REQUIRE(recommendations.n_rows == 10);
+  REQUIRE(recommendations.n_cols == 100);
+
+  const arma::sp_mat& cleanedData = c.CleanedData();
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    arma::vec ratings;
+    c.Decomposition().GetRatingOfUser(users(i), ratings);
+
+    // Find the worst recommended rating.
+    double worstRating = DBL_MAX;
+    for (size_t r = 0; r < 10; ++r)
+    {
+      REQUIRE(cleanedData(recommendations(r, i), users(i)) == 0.0);
+      worstRating = std::min(worstRating, ratings(recommendations(r, i)));
+    }
+
+    // No un-rated item that was not recommended may be better.
+    for (size_t item = 0; item < ratings.n_elem; ++item)
+    {
+      if (cleanedData(item, users(i)) != 0.0 ||
+          arma::any(recommendations.col(i) == item))
+        continue;
+
+      REQUIRE(ratings(item) <= worstRating + 1e-8);
+    }
+  }
+}
+
+// Hold out the ratings of the last ten users, train on the other ratings, and
+// make sure that the held out users are folded into the model correctly.
+template<typename DecompositionPolicy,
+         typename NormalizationType = NoNormalization>
+void FoldInUsers()
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  const size_t numUsers = (size_t) arma::max(dataset.row(0)) + 1;
+  const arma::mat trainData =
+      dataset.cols(arma::find(dataset.row(0) < numUsers - 10));
+
+  DecompositionPolicy decomposition;
+  CFType<DecompositionPolicy, NormalizationType> c(trainData, decomposition,
+      5, 5, 30);
+
+  // Only the items of the model can be rated by the new users.
+  const size_t numItems = c.CleanedData().n_rows;
+  const arma::mat newData = dataset.cols(arma::find(
+      (dataset.row(0) >= numUsers - 10) % (dataset.row(1) < numItems)));
+
+  c.FoldInUsers(newData);
+  REQUIRE(c.CleanedData().n_rows == numItems);
+  REQUIRE(c.CleanedData().n_cols == numUsers);
+
+  // The new users must fit their own ratings.
+  double totalError = 0.0;
+  for (size_t i = 0; i < newData.n_cols; ++i)
+  {
+    const size_t user = (size_t) newData(0, i);
+    const size_t item = (size_t) newData(1, i);
+    const double rating = c.Normalization().Denormalize(user, item,
+        c.Decomposition().GetRating(user, item));
+    REQUIRE(std::isfinite(rating));
+    totalError += std::pow(rating - newData(2, i), 2.0);
+  }
+  REQUIRE(std::sqrt(totalError / newData.n_cols) < 1.5);
+
+  // The new users must take part in the neighborhood search.
+  arma::Col<size_t> users = arma::regspace<arma::Col<size_t>>(numUsers - 10,
+      numUsers - 1);
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(5, recommendations, users);
+  REQUIRE(recommendations.n_rows == 5);
+  REQUIRE(recommendations.n_cols == 10);
+  REQUIRE(arma::all(arma::vectorise(recommendations) < numItems));
+}
+
+// Hold out the ratings of the last ten items, train on the other ratings, and
+// make sure that the held out items are folded into the model correctly.
+template<typename DecompositionPolicy,
+         typename NormalizationType = NoNormalization>
+void FoldInItems()
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  const size_t numItems = (size_t) arma::max(dataset.row(1)) + 1;
+  const arma::mat trainData =
+      dataset.cols(arma::find(dataset.row(1) < numItems - 10));
+
+  DecompositionPolicy decomposition;
+  CFType<DecompositionPolicy, NormalizationType> c(trainData, decomposition,
+      5, 5, 30);
+
+  // Only the users of the model can rate the new items.
+  const size_t numUsers = c.CleanedData().n_cols;
+  const arma::mat newData = dataset.cols(arma::find(
+      (dataset.row(1) >= numItems - 10) % (dataset.row(0) < numUsers)));
+
+  c.FoldInItems(newData);
+  REQUIRE(c.CleanedData().n_rows == numItems);
+  REQUIRE(c.CleanedData().n_cols == numUsers);
+
+  // The new items must fit their own ratings.
+  double totalError = 0.0;
+  for (size_t i = 0; i < newData.n_cols; ++i)
+  {
+    const size_t user = (size_t) newData(0, i);
+    const size_t item = (size_t) newData(1, i);
+    const double rating = c.Normalization().Denormalize(user, item,
+        c.Decomposition().GetRating(user, item));
+    REQUIRE(std::isfinite(rating));
+    totalError += std::pow(rating - newData(2, i), 2.0);
+  }
+  REQUIRE(std::sqrt(totalError / newData.n_cols) < 1.5);
+
+  // The new items can be predicted like the others.
+  arma::Mat<size_t> combinations(2, newData.n_cols);
+  combinations.row(0) = arma::conv_to<arma::Row<size_t>>::from(newData.row(0));
+  combinations.row(1) = arma::conv_to<arma::Row<size_t>>::from(newData.row(1));
+  arma::vec predictions;
+  c.Predict(combinations, predictions);
+  REQUIRE(predictions.n_elem == newData.n_cols);
+  REQUIRE(predictions.is_finite());
+}
+
+/**
+ * Make sure that new users can be folded into a model trained with any of the
+ * decomposition policies.
+ */
+TEMPLATE_TEST_CASE("CFFoldInUsersTest", "[CFTest]",
+    RandomizedSVDPolicy, RegSVDPolicy, BatchSVDPolicy, NMFPolicy,
+    SVDCompletePolicy, SVDIncompletePolicy, BiasSVDPolicy, SVDPlusPlusPolicy,
+    QUIC_SVDPolicy, BlockKrylovSVDPolicy, ALSPolicy)
+{
+  FoldInUsers<TestType>();
+}
+
+/**
+ * Make sure that new items can be folded into a model trained with any of the
+ * decomposition policies.
+ */
+TEMPLATE_TEST_CASE("CFFoldInItemsTest", "[CFTest]",
+    RandomizedSVDPolicy, RegSVDPolicy, BatchSVDPolicy, NMFPolicy,
+    SVDCompletePolicy, SVDIncompletePolicy, BiasSVDPolicy, SVDPlusPlusPolicy,
+    QUIC_SVDPolicy, BlockKrylovSVDPolicy, ALSPolicy)
+{
+  FoldInItems<TestType>();
+}
+
+/**
+ * Make sure that new users and items can be folded into a model trained with
+ * any type of normalization.
+ */
+TEMPLATE_TEST_CASE("CFFoldInNormalizationTest", "[CFTest]",
+    OverallMeanNormalization, UserMeanNormalization, ItemMeanNormalization,
+    ZScoreNormalization)
+{
+  FoldInUsers<RegSVDPolicy, TestType>();
+  FoldInItems<RegSVDPolicy, TestType>();
+}
+
+/**
+ * Make sure that a model with folded in users can be saved and loaded.
+ */
+TEST_CASE("CFFoldInSerializationTest", "[CFTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  const size_t numUsers = (size_t) arma::max(dataset.row(0)) + 1;
+  NMFPolicy decomposition;
+  CFType<NMFPolicy, UserMeanNormalization> c(
+      dataset.cols(arma::find(dataset.row(0) < numUsers - 10)),
+      decomposition, 5, 5, 30);
+  c.FoldInUsers(dataset.cols(arma::find((dataset.row(0) >= numUsers - 10) %
+      (dataset.row(1) < c.CleanedData().n_rows))));
+
+  CFType<NMFPolicy, UserMeanNormalization> cXml, cText, cBinary;
+  SerializeObjectAll(c, cXml, cText, cBinary);
+
+  CheckMatrices(c.Decomposition().H(), cXml.Decomposition().H(),
+      cBinary.Decomposition().H(), cText.Decomposition().H());
+  CheckMatrices(c.Normalization().Mean(), cXml.Normalization().Mean(),
+      cBinary.Normalization().Mean(), cText.Normalization().Mean());
+  REQUIRE(cXml.CleanedData().n_cols == numUsers);
+  REQUIRE(cText.CleanedData().n_cols == numUsers);
+  REQUIRE(cBinary.CleanedData().n_cols == numUsers);
+}
+
+/**
+ * Make sure that invalid ratings to fold in are rejected.
+ */
+TEST_CASE("CFFoldInInvalidTest", "[CFTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  NMFPolicy decomposition;
+  CFType<NMFPolicy> c(dataset, decomposition, 5, 5, 30);
+  const size_t numUsers = c.CleanedData().n_cols;
+  const size_t numItems = c.CleanedData().n_rows;
+
+  // The data must be a coordinate list.
+  REQUIRE_THROWS_AS(c.FoldInUsers(arma::mat(2, 5, arma::fill::ones)),
+      std::invalid_argument);
+
+  // The users to fold in must be new.
+  arma::mat data(3, 1);
+  data(0, 0) = 0;
+  data(1, 0) = 0;
+  data(2, 0) = 5;
+  REQUIRE_THROWS_AS(c.FoldInUsers(data), std::invalid_argument);
+
+  // The items of new users must be in the model.
+  data(0, 0) = numUsers;
+  data(1, 0) = numItems;
+  REQUIRE_THROWS_AS(c.FoldInUsers(data), std::invalid_argument);
+  REQUIRE_THROWS_AS(c.FoldInItems(data), std::invalid_argument);
+
+  REQUIRE(c.CleanedData().n_cols == numUsers);
+  REQUIRE(c.CleanedData().n_rows == numItems);
+}
+
+/**
+ * Make sure that NeighborSearchCache builds its search object only when needed,
+ * and that it gives the same neighbors as the search object built directly.
+ */
+TEST_CASE("CFNeighborSearchCacheTest", "[CFTest]")
+{
+  arma::mat features = arma::randu<arma::mat>(5, 200);
+  arma::Col<size_t> users = { 3, 17, 50, 199 };
+  size_t builds = 0;
+  auto featureFunction = [&]() { ++builds; return features; };
+
+  NeighborSearchCache cache;
+  REQUIRE(cache.Empty());
+
+  arma::Mat<size_t> neighborhood, cachedNeighborhood;
+  arma::mat similarities, cachedSimilarities;
+  cache.Search<EuclideanSearch>(users, 5, neighborhood, similarities,
+      featureFunction);
+  cache.Search<EuclideanSearch>(users, 5, cachedNeighborhood,
+      cachedSimilarities, featureFunction);
+  REQUIRE(builds == 1);
+  REQUIRE(!cache.Empty());
+  CheckMatrices(neighborhood, cachedNeighborhood);
+  CheckMatrices(similarities, cachedSimilarities);
+
+  arma::mat query(5, users.n_elem);
+  for (size_t i = 0; i < users.n_elem; ++i)
+    query.col(i) = features.col(users[i]);
+  arma::Mat<size_t> directNeighborhood;
+  arma::mat directSimilarities;
+  EuclideanSearch search(features);
+  search.Search(query, 5, directNeighborhood, directSimilarities);
+  CheckMatrices(neighborhood, directNeighborhood);
+  CheckMatrices(similarities, directSimilarities);
+
+  // Another type of search needs its own search object.
+  cache.Search<CosineSearch>(users, 5, neighborhood, similarities,
+      featureFunction);
+  REQUIRE(builds == 2);
+
+  // A copy or a cleared cache starts empty.
+  NeighborSearchCache copy(cache);
+  REQUIRE(copy.Empty());
+  cache.Clear();
+  REQUIRE(cache.Empty());
+  cache.Search<CosineSearch>(users, 5, neighborhood, similarities,
+      featureFunction);
+  REQUIRE(builds == 3);
+}
+
+/**
+ * Make sure that repeated recommendations with a cached neighbor search are
+ * the same as the recommendations of a model that has just been trained, and
+ * that retraining the model rebuilds the neighbor search.
+ */
+TEMPLATE_TEST_CASE("CFCachedNeighborSearchTest", "[CFTest]", EuclideanSearch,
+    CosineSearch, PearsonSearch)
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  NMFPolicy decomposition;
+  CFType<NMFPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  arma::Col<size_t> users = arma::regspace<arma::Col<size_t>>(0, 19);
+  arma::Mat<size_t> recommendations, cachedRecommendations;
+  c.template GetRecommendations<TestType>(10, recommendations, users);
+  c.template GetRecommendations<TestType>(10, cachedRecommendations, users);
+  CheckMatrices(recommendations, cachedRecommendations);
+
+  // A copy of the model builds its own search.
+  CFType<NMFPolicy> copy(c);
+  copy.template GetRecommendations<TestType>(10, cachedRecommendations, users);
+  CheckMatrices(recommendations, cachedRecommendations);
+
+  // After retraining, the search is built from the new factors.
+  c.Train(dataset, decomposition, 30);
+  CFType<NMFPolicy> trained(c);
+  c.template GetRecommendations<TestType>(10, cachedRecommendations, users);
+  trained.template GetRecommendations<TestType>(10, recommendations, users);
+  CheckMatrices(recommendations, cachedRecommendations);
+}
+
+/**
+ * Make sure that the SVD policies that read the ratings in chunks of users
+ * give reasonable predictions.
+ */
+TEST_CASE("CFChunkedSVDPolicyTest", "[CFTest]")
+{
+  arma::mat dataset, savedCols;
+  GetDatasets(dataset, savedCols);
+
+  RandomizedSVDPolicy randomizedSVD(0, 2, 100);
+  CFType<RandomizedSVDPolicy> c1(dataset, randomizedSVD, 5, 5, 30);
+  REQUIRE(c1.Decomposition().ChunkSize() == 100);
+
+  BlockKrylovSVDPolicy blockKrylovSVD(100);
+  CFType<BlockKrylovSVDPolicy> c2(dataset, blockKrylovSVD, 5, 5, 30);
+  REQUIRE(c2.Decomposition().ChunkSize() == 100);
+
+  double totalError1 = 0.0, totalError2 = 0.0;
+  for (size_t i = 0; i < savedCols.n_cols; ++i)
+  {
+    totalError1 += std::pow(c1.Predict(savedCols(0, i), savedCols(1, i)) -
+        savedCols(2, i), 2.0);
+    totalError2 += std::pow(c2.Predict(savedCols(0, i), savedCols(1, i)) -
+        savedCols(2, i), 2.0);
+  }
+
+  REQUIRE(std::sqrt(totalError1 / savedCols.n_cols) < 1.5);
+  REQUIRE(std::sqrt(totalError2 / savedCols.n_cols) < 1.5);
+}
@@ -432,3 +432,58 @@ TEST_CASE("MoveConstructorAndOperatorCosineTreeTest", "[CosineTreeTest]")
     REQUIRE(v1.at(i) == v3.at(i));
   }
 }
+
+/**
+ * Make sure that the basis built with several threads is the same as the basis
+ * built with one thread, and that the basis is still orthonormal when several
+ * nodes are split in each round.
+ */
+TEST_CASE("CosineTreeParallelTest", "[CosineTreeTest]")
+{
+  arma::mat data = arma::randu(300, 2000);
+
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  RandomSeed(7);
+  CosineTree serialTree(data, 0.1, 0.1);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(4);
+#endif
+
+  RandomSeed(7);
+  CosineTree parallelTree(data, 0.1, 0.1);
+
+  arma::mat smallData = arma::randu(50, 1000);
+  CosineTree roundTree(smallData, 0.1, 0.1, 8);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+
+  arma::mat serialBasis, parallelBasis, roundBasis;
+  serialTree.GetFinalBasis(serialBasis);
+  parallelTree.GetFinalBasis(parallelBasis);
+  roundTree.GetFinalBasis(roundBasis);
+
+  REQUIRE(serialBasis.n_cols == parallelBasis.n_cols);
+  REQUIRE(arma::approx_equal(serialBasis, parallelBasis, "absdiff", 1e-12));
+
+  // Zero vectors may be added when the span is already full, so only check
+  // the nonzero columns.
+  for (size_t i = 0; i < roundBasis.n_cols; ++i)
+  {
+    for (size_t j = i; j < roundBasis.n_cols; ++j)
+    {
+      if (arma::norm(roundBasis.col(i)) == 0.0 ||
+          arma::norm(roundBasis.col(j)) == 0.0)
+        continue;
+
+      REQUIRE(arma::dot(roundBasis.col(i), roundBasis.col(j)) ==
+          Approx((i == j) ? 1.0 : 0.0).margin(1e-5));
+    }
+  }
+}
@@ -128,6 +128,37 @@ TEST_CASE("BinaryClassificationMetricsTest", "[CVTest]")
                     std::invalid_argument);
 }
 
+/**
+ * Make sure that the binned ROC-AUC score matches the exact score.
+ */
+TEST_CASE("BinnedROCAUCScoreTest", "[CVTest]")
+{
+  // When each bin holds one distinct score, the estimate is exact.
+  arma::Row<size_t> labels("1 0 1 0 1  0 1 0 1 0");
+  arma::rowvec scores("0.8 0.3 0.5 0.4 0.9  0.2 0.7 0.6 0 0.1");
+  REQUIRE(ROCAUCScore<1>::Evaluate(labels, scores, 1000) ==
+      Approx(0.76).epsilon(1e-7));
+  REQUIRE(ROCAUCScore<0>::Evaluate(labels, scores, 1000) ==
+      Approx(0.24).epsilon(1e-7));
+
+  // With many points, the estimate is close.
+  labels = arma::randi<arma::Row<size_t>>(200000, arma::distr_param(0, 1));
+  scores = 0.3 * arma::conv_to<arma::rowvec>::from(labels) +
+      arma::randu<arma::rowvec>(200000);
+  const double exact = ROCAUCScore<1>::Evaluate(labels, scores);
+  REQUIRE(ROCAUCScore<1>::Evaluate(labels, scores, 10000) ==
+      Approx(exact).margin(1e-4));
+
+  // All the scores are the same.
+  arma::rowvec sameScores(200000);
+  sameScores.fill(0.5);
+  REQUIRE(ROCAUCScore<1>::Evaluate(labels, sameScores, 100) ==
+      Approx(0.5).epsilon(1e-7));
+
+  REQUIRE_THROWS_AS(ROCAUCScore<1>::Evaluate(labels, scores, 0),
+      std::invalid_argument);
+}
+
 /**
  * Test for confusion matrix.
  */
@@ -556,6 +587,71 @@ TEST_CASE("KFoldCVMSETest", "[CVTest]")
   REQUIRE_NOTHROW(cv.Model());
 }
 
+/**
+ * Test that k-fold cross-validation with uneven bins uses the expected folds,
+ * and gives the same result when it is run again.
+ */
+TEST_CASE("KFoldCVUnevenBinsFoldsTest", "[CVTest]")
+{
+  arma::mat data(3, 23, arma::fill::randu);
+  arma::rowvec responses = 2 * data.row(0) - data.row(1) +
+      0.1 * arma::randn<arma::rowvec>(23);
+
+  const size_t k = 4;
+  KFoldCV<LinearRegression<>, MSE> cv(k, data, responses, false);
+
+  // The validation subset of fold 0 is the last bin, and that of fold i is bin
+  // i - 1; each of the first k - 1 bins has 23 / k points.
+  const size_t binSize = 23 / k;
+  double expectedMSE = 0.0;
+  for (size_t i = 0; i < k; ++i)
+  {
+    const size_t first = (i == 0) ? (k - 1) * binSize : (i - 1) * binSize;
+    const size_t last = (i == 0) ? 22 : first + binSize - 1;
+
+    arma::uvec train(23 - (last - first + 1));
+    for (size_t j = 0, t = 0; j < 23; ++j)
+      if (j < first || j > last)
+        train[t++] = j;
+
+    arma::mat trainData = data.cols(train);
+    arma::rowvec trainResponses = responses.cols(train);
+    LinearRegression<> lr(trainData, trainResponses);
+    arma::mat validData = data.cols(first, last);
+    arma::rowvec validResponses = responses.cols(first, last);
+    expectedMSE += MSE::Evaluate(lr, validData, validResponses) / k;
+  }
+
+  REQUIRE(cv.Evaluate() == Approx(expectedMSE).epsilon(1e-7));
+  REQUIRE(cv.Evaluate() == Approx(expectedMSE).epsilon(1e-7));
+}
+
+/**
+ * Test that k-fold cross-validation gives the same result when the folds are
+ * evaluated in parallel, and with EvaluateModel().
+ */
+TEST_CASE("KFoldCVParallelTest", "[CVTest]")
+{
+  arma::mat data(4, 47, arma::fill::randu);
+  arma::rowvec responses = arma::randu<arma::rowvec>(4) * data +
+      0.1 * arma::randn<arma::rowvec>(47);
+
+  KFoldCV<LinearRegression<>, MSE> cv(5, data, responses, false);
+  const double expectedMSE = cv.Evaluate(0.1);
+  const arma::vec expectedParameters = cv.Model().Parameters();
+
+  cv.Parallel() = true;
+  REQUIRE(cv.Evaluate(0.1) == Approx(expectedMSE).epsilon(1e-7));
+  REQUIRE(arma::approx_equal(cv.Model().Parameters(), expectedParameters,
+      "absdiff", 1e-7));
+
+  std::unique_ptr<LinearRegression<>> model;
+  REQUIRE(cv.EvaluateModel(model, 0.1) == Approx(expectedMSE).epsilon(1e-7));
+  REQUIRE(model != nullptr);
+  REQUIRE(arma::approx_equal(model->Parameters(), expectedParameters,
+      "absdiff", 1e-7));
+}
+
 /**
  * Test k-fold cross-validation with the Accuracy metric.
  */
@@ -858,3 +954,35 @@ TEST_CASE("SilhouetteScoreTest", "[CVTest]")
   double silhouetteScore = SilhouetteScore::Overall(X, labels, metric);
   REQUIRE(silhouetteScore == Approx(0.1121684822489150).epsilon(1e-7));
 }
+
+/**
+ * Make sure that the blocked silhouette score matches the score computed from
+ * the full distance matrix, and that the sampled score is close to it.
+ */
+TEST_CASE("BlockedSilhouetteScoreTest", "[CVTest]")
+{
+  // Four clusters of 150 points; more points than the size of a block.
+  arma::mat X(3, 600, arma::fill::randn);
+  arma::Row<size_t> labels(600);
+  for (size_t i = 0; i < 600; ++i)
+  {
+    labels[i] = 2 * (i % 4) + 1;
+    X.col(i) += 3.0 * labels[i];
+  }
+
+  EuclideanDistance metric;
+  const arma::mat distances = PairwiseDistances(X, metric);
+  const arma::rowvec expected = SilhouetteScore::SamplesScore(distances,
+      labels);
+  const arma::rowvec blocked = SilhouetteScore::SamplesScore(X, labels,
+      metric);
+  REQUIRE(arma::approx_equal(blocked, expected, "absdiff", 1e-6));
+
+  // Samples as large as the clusters give the exact score.
+  REQUIRE(SilhouetteScore::Overall(X, labels, metric, 150) ==
+      Approx(arma::mean(expected)).epsilon(1e-6));
+
+  // Smaller samples give an estimate.
+  REQUIRE(SilhouetteScore::Overall(X, labels, metric, 40) ==
+      Approx(arma::mean(expected)).margin(0.05));
+}
@@ -17,18 +17,6 @@
 
 using namespace mlpack;
 
-/**
- * A couple of handful declarations for float32 testing.
- * These will be removed when we refactor the Bounds to accept MatType.
- * For now, we will keep the following declarations.
- */
-template<typename MetricType>
-using FloatHRectBound = HRectBound<MetricType, float>;
-
-template<typename MetricType, typename StatisticType, typename MatType>
-using FloatKDTree = BinarySpaceTree<MetricType, StatisticType, MatType,
-                                    FloatHRectBound, MidpointSplit>;
-
 TEST_CASE("OneClusterTest", "[DBSCANTest]")
 {
   // Make sure that if we have points in the unit box, and if we set epsilon
@@ -229,7 +217,7 @@ TEST_CASE("Float32OutlierSingleModeTest", "[DBSCANTest]")
   DBSCAN<RangeSearch<
          EuclideanDistance,
          arma::Mat<float>,
-         FloatKDTree>,
+         KDTree>,
          OrderedPointSelection> d(0.1, 3, false);
 
   arma::Row<size_t> assignments;
@@ -376,3 +364,83 @@ TEST_CASE("NoiseConnectionTest", "[DBSCANTest]")
 
   REQUIRE(numClusters == 2);
 }
+
+/**
+ * Make sure that parallel mode finds the same clusters as batch mode, with
+ * dual-tree, single-tree and naive range search.
+ */
+TEST_CASE("ParallelModeTest", "[DBSCANTest]")
+{
+  arma::mat points(3, 600);
+
+  GaussianDistribution g1(3), g2(3), g3(3);
+  g1.Mean() = arma::vec("0.0 0.0 0.0");
+  g2.Mean() = arma::vec("6.0 6.0 8.0");
+  g3.Mean() = arma::vec("-6.0 1.0 -7.0");
+  for (size_t i = 0; i < 200; ++i)
+    points.col(i) = g1.Random();
+  for (size_t i = 200; i < 400; ++i)
+    points.col(i) = g2.Random();
+  for (size_t i = 400; i < 600; ++i)
+    points.col(i) = g3.Random();
+
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+#endif
+
+  DBSCAN<> batch(1.0, 5);
+  arma::Row<size_t> batchAssignments;
+  const size_t batchClusters = batch.Cluster(points, batchAssignments);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(mode == 2 /* naive */, mode == 1 /* single mode */);
+    DBSCAN<> d(1.0, 5, true, rs, OrderedPointSelection(), true);
+
+    arma::Row<size_t> assignments;
+    const size_t clusters = d.Cluster(points, assignments);
+    REQUIRE(clusters == batchClusters);
+
+    // The clusters must be the same, up to their labels.
+    arma::Col<size_t> labels(clusters);
+    labels.fill(SIZE_MAX);
+    for (size_t i = 0; i < points.n_cols; ++i)
+    {
+      if (batchAssignments[i] == SIZE_MAX)
+      {
+        REQUIRE(assignments[i] == SIZE_MAX);
+        continue;
+      }
+
+      REQUIRE(assignments[i] != SIZE_MAX);
+      if (labels[batchAssignments[i]] == SIZE_MAX)
+        labels[batchAssignments[i]] = assignments[i];
+      REQUIRE(labels[batchAssignments[i]] == assignments[i]);
+    }
+  }
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+}
+
+/**
+ * A noise point between two clusters must not connect them in parallel mode
+ * either.
+ */
+TEST_CASE("ParallelModeNoiseConnectionTest", "[DBSCANTest]")
+{
+  arma::mat dataset({
+      // cluster 1           cluster 2            noise
+      { 0.0, 0.5,  0.5, 1.0, 3.0, 3.5,  3.5, 4.0, 2.0 },
+      { 0.0, 0.5, -0.5, 0.0, 0.0, 0.5, -0.5, 0.0, 0.0 }});
+
+  DBSCAN<> dbscan(1.1, 4, true, RangeSearch<>(), OrderedPointSelection(),
+      true);
+
+  arma::Row<size_t> labels;
+  REQUIRE(dbscan.Cluster(dataset, labels) == 2);
+  REQUIRE(labels[0] != labels[4]);
+  REQUIRE((labels[8] == labels[0] || labels[8] == labels[4]));
+}
@@ -462,6 +462,88 @@ TEST_CASE("RandomBinaryNumericSplitNoGainTest_", "[DecisionTreeRegressorTest]")
   REQUIRE(gain == DBL_MAX);
 }
 
+/**
+ * Check that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit when there are fewer distinct values than bins, for a
+ * fitness function with and without the optimized binary split forms.
+ */
+TEMPLATE_TEST_CASE("HistogramNumericSplitSameSplitTest_",
+    "[DecisionTreeRegressorTest]", MSEGain, MADGain)
+{
+  typedef TestType FitnessFunction;
+
+  arma::rowvec values(1000);
+  arma::rowvec responses(1000);
+  arma::rowvec weights(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    values[i] = RandInt(100) / 10.0;
+    responses[i] = std::sin(values[i]) + Random(-0.2, 0.2);
+    weights[i] = Random(0.5, 1.0);
+  }
+
+  FitnessFunction f;
+  double splitInfo, histogramSplitInfo;
+  typename BestBinaryNumericSplit<FitnessFunction>::AuxiliarySplitInfo aux;
+  typename HistogramNumericSplit<FitnessFunction>::AuxiliarySplitInfo
+      histogramAux;
+
+  const double bestGain = f.template Evaluate<false>(responses, weights);
+  const double gain =
+      BestBinaryNumericSplit<FitnessFunction>::template SplitIfBetter<false>(
+      bestGain, values, responses, weights, 3, 1e-7, splitInfo, aux, f);
+  const double histogramGain =
+      HistogramNumericSplit<FitnessFunction>::template SplitIfBetter<false>(
+      bestGain, values, responses, weights, 3, 1e-7, histogramSplitInfo,
+      histogramAux, f);
+
+  REQUIRE(gain != DBL_MAX);
+  REQUIRE(histogramGain == Approx(gain).epsilon(1e-7));
+  REQUIRE(histogramSplitInfo == splitInfo);
+
+  // Now with weights.
+  const double weightedBestGain = f.template Evaluate<true>(responses,
+      weights);
+  const double weightedGain =
+      BestBinaryNumericSplit<FitnessFunction>::template SplitIfBetter<true>(
+      weightedBestGain, values, responses, weights, 3, 1e-7, splitInfo, aux,
+      f);
+  const double weightedHistogramGain =
+      HistogramNumericSplit<FitnessFunction>::template SplitIfBetter<true>(
+      weightedBestGain, values, responses, weights, 3, 1e-7,
+      histogramSplitInfo, histogramAux, f);
+
+  REQUIRE(weightedGain != DBL_MAX);
+  REQUIRE(weightedHistogramGain == Approx(weightedGain).epsilon(1e-7));
+}
+
+/**
+ * Check that the HistogramNumericSplit won't split if not enough points are
+ * given.
+ */
+TEST_CASE("HistogramNumericSplitMinSamplesTest_",
+    "[DecisionTreeRegressorTest]")
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::rowvec responses("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(responses.n_elem, arma::fill::ones);
+
+  double splitInfo;
+  HistogramNumericSplit<MSEGain>::AuxiliarySplitInfo aux;
+
+  MSEGain f;
+  const double bestGain = f.Evaluate<false>(responses, weights);
+  const double gain = HistogramNumericSplit<MSEGain>::SplitIfBetter<false>(
+      bestGain, values, responses, weights, 8, 1e-7, splitInfo, aux, f);
+  const double weightedGain =
+      HistogramNumericSplit<MSEGain>::SplitIfBetter<true>(bestGain, values,
+      responses, weights, 8, 1e-7, splitInfo, aux, f);
+
+  // Make sure that no split was made.
+  REQUIRE(gain == DBL_MAX);
+  REQUIRE(gain == weightedGain);
+}
+
 /**
  * A basic construction of the decision tree---ensure that we can create the
  * tree and that it split at least once.
@@ -979,6 +1061,48 @@ TEMPLATE_TEST_CASE("SimpleGeneralizationTest_",
   REQUIRE(success == true);
 }
 
+/**
+ * Test that the decision tree regressor generalizes reasonably when built with
+ * the HistogramNumericSplit.
+ */
+TEST_CASE("HistogramSplitGeneralizationTest_", "[DecisionTreeRegressorTest]")
+{
+  // Allow three trials.
+  bool success = false;
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    data::DatasetInfo info;
+    arma::mat trainData, testData;
+    arma::rowvec trainResponses, testResponses;
+    LoadBostonHousingDataset(trainData, testData, trainResponses, testResponses,
+        info);
+
+    arma::rowvec weights(trainResponses.n_cols, arma::fill::ones);
+
+    DecisionTreeRegressor<MSEGain, HistogramNumericSplit> d(trainData,
+        trainResponses);
+    DecisionTreeRegressor<MSEGain, HistogramNumericSplit> wd(trainData,
+        trainResponses, weights);
+
+    arma::rowvec predictions;
+    d.Predict(testData, predictions);
+    REQUIRE(predictions.n_elem == testData.n_cols);
+    const double rmse = RMSE(predictions, testResponses);
+
+    wd.Predict(testData, predictions);
+    REQUIRE(predictions.n_elem == testData.n_cols);
+    const double wdrmse = RMSE(predictions, testResponses);
+
+    if (rmse <= 6.2 && wdrmse <= 6.2)
+    {
+      success = true;
+      break;
+    }
+  }
+
+  REQUIRE(success == true);
+}
+
 /**
  * Test that we can build a decision tree using weighted data (where the
  * low-weighted data is random noise), and that the tree still builds correctly
@@ -1089,3 +1213,83 @@ TEST_CASE("WeightedDecisionTreeMADGainTest", "[DecisionTreeRegressorTest]")
 
   REQUIRE(success == true);
 }
+
+/**
+ * Make sure that two regression trees have the same structure and splits.
+ */
+template<typename TreeType>
+void CheckSameRegressionTree(const TreeType& tree, const TreeType& otherTree)
+{
+  REQUIRE(tree.NumChildren() == otherTree.NumChildren());
+  if (tree.NumChildren() == 0)
+    return;
+
+  REQUIRE(tree.SplitDimension() == otherTree.SplitDimension());
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    CheckSameRegressionTree(tree.Child(i), otherTree.Child(i));
+}
+
+/**
+ * Make sure that training a regression tree in parallel gives exactly the same
+ * tree as training it with one thread, for numeric, weighted, and categorical
+ * data.
+ */
+TEST_CASE("DecisionTreeRegressorParallelTrainTest",
+          "[DecisionTreeRegressorTest]")
+{
+  static_assert(DecisionTreeRegressor<>::ParallelTrain,
+      "DecisionTreeRegressor<> should be trained in parallel!");
+  static_assert(!DecisionTreeRegressor<MSEGain,
+      RandomBinaryNumericSplit>::ParallelTrain,
+      "random splits should not be trained in parallel!");
+
+  arma::mat data(8, 20000, arma::fill::randu);
+  arma::rowvec responses = data.row(0) % data.row(1) + 2.0 * data.row(2) +
+      0.1 * arma::randn<arma::rowvec>(data.n_cols);
+  arma::rowvec weights(data.n_cols, arma::fill::randu);
+
+  arma::mat categoricalData, d;
+  arma::rowvec categoricalResponses, r;
+  data::DatasetInfo di;
+  MockCategoricalData(d, r, di);
+  categoricalData = arma::join_rows(d, d);
+  categoricalResponses = arma::join_rows(r, r);
+
+  DecisionTreeRegressor<> tree(data, responses, 5);
+  DecisionTreeRegressor<> weightedTree(data, responses, weights, 5);
+  DecisionTreeRegressor<> categoricalTree(categoricalData, di,
+      categoricalResponses, 5);
+
+#ifdef MLPACK_USE_OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  DecisionTreeRegressor<> serialTree(data, responses, 5);
+  DecisionTreeRegressor<> serialWeightedTree(data, responses, weights, 5);
+  DecisionTreeRegressor<> serialCategoricalTree(categoricalData, di,
+      categoricalResponses, 5);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(threads);
+#endif
+
+  REQUIRE(tree.NumChildren() > 0);
+  CheckSameRegressionTree(tree, serialTree);
+  CheckSameRegressionTree(weightedTree, serialWeightedTree);
+  CheckSameRegressionTree(categoricalTree, serialCategoricalTree);
+
+  // The leaves must give exactly the same predictions.
+  arma::rowvec predictions, serialPredictions;
+  tree.Predict(data, predictions);
+  serialTree.Predict(data, serialPredictions);
+  REQUIRE(arma::all(predictions == serialPredictions));
+
+  weightedTree.Predict(data, predictions);
+  serialWeightedTree.Predict(data, serialPredictions);
+  REQUIRE(arma::all(predictions == serialPredictions));
+
+  categoricalTree.Predict(categoricalData, predictions);
+  serialCategoricalTree.Predict(categoricalData, serialPredictions);
+  REQUIRE(arma::all(predictions == serialPredictions));
+}
@@ -468,6 +468,104 @@ TEST_CASE("RandomBinaryNumericSplitDiffSplitTest", "[DecisionTreeTest]")
   REQUIRE(classProbabilities[0] != classProbabilities1[0]);
 }
 
+/**
+ * Check that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit when there are fewer distinct values than bins.
+ */
+TEST_CASE("HistogramNumericSplitSameSplitTest", "[DecisionTreeTest]")
+{
+  arma::vec values(1000);
+  arma::Row<size_t> labels(1000);
+  arma::rowvec weights(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    values[i] = RandInt(100) / 10.0;
+    labels[i] = (values[i] + Random(-2.0, 2.0) > 5.0) ? 1 : 0;
+    weights[i] = Random(0.5, 1.0);
+  }
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  arma::vec splitInfo, histogramSplitInfo;
+  BestBinaryNumericSplit<GiniGain>::AuxiliarySplitInfo aux;
+  HistogramNumericSplit<GiniGain>::AuxiliarySplitInfo histogramAux;
+
+  const double gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, splitInfo, aux);
+  const double histogramGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, histogramSplitInfo, histogramAux);
+
+  REQUIRE(gain != DBL_MAX);
+  REQUIRE(histogramGain == Approx(gain).epsilon(1e-7));
+  REQUIRE(histogramSplitInfo.n_elem == 1);
+  REQUIRE(histogramSplitInfo[0] == splitInfo[0]);
+
+  // Now with weights.
+  const double weightedBestGain = GiniGain::Evaluate<true>(labels, 2, weights);
+  const double weightedGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetter<true>(weightedBestGain,
+      values, labels, 2, weights, 3, 1e-7, splitInfo, aux);
+  const double weightedHistogramGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(weightedBestGain,
+      values, labels, 2, weights, 3, 1e-7, histogramSplitInfo, histogramAux);
+
+  REQUIRE(weightedGain != DBL_MAX);
+  REQUIRE(weightedHistogramGain == Approx(weightedGain).epsilon(1e-7));
+}
+
+/**
+ * Check that the HistogramNumericSplit finds a good split on a dimension with
+ * many more distinct values than bins.
+ */
+TEST_CASE("HistogramNumericSplitManyValuesTest", "[DecisionTreeTest]")
+{
+  arma::vec values(50000, arma::fill::randu);
+  values *= 5.0;
+  // Add a few outliers, which should not affect the bins much.
+  values[0] = -1e6;
+  values[1] = 1e6;
+  arma::Row<size_t> labels(values.n_elem);
+  for (size_t i = 0; i < values.n_elem; ++i)
+    labels[i] = (values[i] > 2.5) ? 1 : 0;
+  arma::rowvec weights;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  arma::vec splitInfo;
+  HistogramNumericSplit<GiniGain>::AuxiliarySplitInfo aux;
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, splitInfo, aux);
+
+  // The bins are about 0.02 wide, so the split should be close to 2.5, and
+  // nearly perfect.
+  REQUIRE(gain > bestGain);
+  REQUIRE(gain > -0.02);
+  REQUIRE(splitInfo.n_elem == 1);
+  REQUIRE(splitInfo[0] > 2.4);
+  REQUIRE(splitInfo[0] < 2.6);
+}
+
+/**
+ * Check that the HistogramNumericSplit doesn't split a dimension with only one
+ * value.
+ */
+TEST_CASE("HistogramNumericSplitNoGainTest", "[DecisionTreeTest]")
+{
+  arma::vec values(100, arma::fill::ones);
+  arma::Row<size_t> labels(100);
+  for (size_t i = 0; i < 100; ++i)
+    labels[i] = i % 2;
+  arma::rowvec weights;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  arma::vec splitInfo;
+  HistogramNumericSplit<GiniGain>::AuxiliarySplitInfo aux;
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, splitInfo, aux);
+
+  REQUIRE(gain == DBL_MAX);
+  REQUIRE(splitInfo.n_elem == 0);
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -793,6 +891,49 @@ TEST_CASE("SimpleGeneralizationTest", "[DecisionTreeTest]")
   REQUIRE(wdcorrect > 0.75);
 }
 
+/**
+ * Test that the decision tree generalizes reasonably when built with the
+ * HistogramNumericSplit.
+ */
+TEST_CASE("HistogramSplitGeneralizationTest", "[DecisionTreeTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::rowvec weights(labels.n_cols, arma::fill::ones);
+
+  // Build decision trees.
+  DecisionTree<GiniGain, HistogramNumericSplit> d(inputData, labels, 3, 10);
+  DecisionTree<GiniGain, HistogramNumericSplit> wd(inputData, labels, 3,
+      weights, 10);
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Row<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  arma::Row<size_t> predictions;
+  d.Classify(testData, predictions);
+  REQUIRE(predictions.n_elem == testData.n_cols);
+  double correct = accu(predictions == trueTestLabels);
+  correct /= predictions.n_elem;
+  REQUIRE(correct > 0.75);
+
+  wd.Classify(testData, predictions);
+  REQUIRE(predictions.n_elem == testData.n_cols);
+  double wdcorrect = accu(predictions == trueTestLabels);
+  wdcorrect /= predictions.n_elem;
+  REQUIRE(wdcorrect > 0.75);
+}
+
 /**
  * Test that the decision tree generalizes reasonably when built on float data.
  */
@@ -1393,3 +1534,271 @@ TEST_CASE("DifferentMaximumDepthTest", "[DecisionTreeTest]")
   REQUIRE(d2.Child(0).NumChildren() == 2);
   REQUIRE(d2.Child(1).NumChildren() == 2);
 }
+
+/**
+ * Make sure that a flattened tree gives the same predictions and probabilities
+ * as the original tree on numeric data, for single points and for batches that
+ * are not a multiple of the block size.
+ */
+TEST_CASE("FlatDecisionTreeNumericTest", "[DecisionTreeTest]")
+{
+  arma::mat data(5, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    if (data(0, i) + data(1, i) > 1.0)
+      labels[i] = 1;
+    else
+      labels[i] = (data(2, i) > 0.7) ? 2 : 0;
+  }
+
+  DecisionTree<> tree(data, labels, 3, 5);
+  FlatDecisionTree flatTree(tree);
+
+  REQUIRE(flatTree.NumClasses() == 3);
+  REQUIRE(flatTree.NumLeaves() > 1);
+
+  arma::mat testData(5, 777, arma::fill::randu);
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  tree.Classify(testData, predictions, probabilities);
+  flatTree.Classify(testData, flatPredictions, flatProbabilities);
+
+  REQUIRE(arma::all(predictions == flatPredictions));
+  CheckMatrices(probabilities, flatProbabilities);
+
+  flatTree.Classify(testData, flatPredictions);
+  REQUIRE(arma::all(predictions == flatPredictions));
+
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    flatTree.Classify(testData.col(i), prediction, pointProbabilities);
+    REQUIRE(prediction == predictions[i]);
+    REQUIRE(flatTree.Classify(testData.col(i)) == predictions[i]);
+    REQUIRE(arma::approx_equal(pointProbabilities, probabilities.col(i),
+        "absdiff", 1e-12));
+  }
+}
+
+/**
+ * Make sure that a flattened tree gives the same predictions as the original
+ * tree on categorical data.
+ */
+TEST_CASE("FlatDecisionTreeCategoricalTest", "[DecisionTreeTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+
+  DecisionTree<> tree(trainingData, di, trainingLabels, 5, 10);
+  FlatDecisionTree flatTree(tree);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  tree.Classify(testData, predictions);
+  flatTree.Classify(testData, flatPredictions);
+
+  REQUIRE(arma::all(predictions == flatPredictions));
+}
+
+/**
+ * Make sure that a flattened tree can be serialized on its own, and that an
+ * empty flattened tree cannot be used.
+ */
+TEST_CASE("FlatDecisionTreeSerializationTest", "[DecisionTreeTest]")
+{
+  arma::mat data(3, 500, arma::fill::randu);
+  arma::Row<size_t> labels = arma::conv_to<arma::Row<size_t>>::from(
+      data.row(0) > data.row(1));
+
+  DecisionTree<> tree(data, labels, 2, 5);
+  FlatDecisionTree flatTree(tree);
+
+  FlatDecisionTree xmlTree, jsonTree, binaryTree;
+  REQUIRE_THROWS_AS(xmlTree.Classify(data.col(0)), std::invalid_argument);
+
+  SerializeObjectAll(flatTree, xmlTree, jsonTree, binaryTree);
+
+  REQUIRE(xmlTree.NumNodes() == flatTree.NumNodes());
+  REQUIRE(jsonTree.NumLeaves() == flatTree.NumLeaves());
+
+  arma::Row<size_t> predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions;
+  flatTree.Classify(data, predictions);
+  xmlTree.Classify(data, xmlPredictions);
+  jsonTree.Classify(data, jsonPredictions);
+  binaryTree.Classify(data, binaryPredictions);
+
+  REQUIRE(arma::all(predictions == xmlPredictions));
+  REQUIRE(arma::all(predictions == jsonPredictions));
+  REQUIRE(arma::all(predictions == binaryPredictions));
+}
+
+/**
+ * Make sure that two classification trees have the same structure, splits, and
+ * class probabilities.
+ */
+template<typename TreeType, typename OtherTreeType>
+void CheckSameTree(const TreeType& tree, const OtherTreeType& otherTree)
+{
+  REQUIRE(tree.NumChildren() == otherTree.NumChildren());
+  REQUIRE(arma::all(tree.ClassProbabilities() ==
+      otherTree.ClassProbabilities()));
+  if (tree.NumChildren() == 0)
+    return;
+
+  REQUIRE(tree.SplitDimension() == otherTree.SplitDimension());
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    CheckSameTree(tree.Child(i), otherTree.Child(i));
+}
+
+/**
+ * Make sure that training a tree in parallel gives exactly the same tree as
+ * training it with one thread, for numeric, weighted, and categorical data.
+ */
+TEST_CASE("DecisionTreeParallelTrainTest", "[DecisionTreeTest]")
+{
+  static_assert(DecisionTree<>::ParallelTrain,
+      "DecisionTree<> should be trained in parallel!");
+  static_assert(!DecisionTree<GiniGain,
+      RandomBinaryNumericSplit>::ParallelTrain,
+      "random splits should not be trained in parallel!");
+  static_assert(!DecisionTree<GiniGain, BestBinaryNumericSplit,
+      AllCategoricalSplit, RandomDimensionSelect>::ParallelTrain,
+      "random dimensions should not be trained in parallel!");
+
+  arma::mat data(8, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    if (data(0, i) + data(1, i) > 1.0)
+      labels[i] = (data(2, i) > 0.3) ? 1 : 2;
+    else
+      labels[i] = (data(3, i) * data(4, i) > 0.2) ? 2 : 0;
+  }
+  arma::rowvec weights(data.n_cols, arma::fill::randu);
+
+  arma::mat categoricalData, d;
+  arma::Row<size_t> categoricalLabels, l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+  categoricalData = arma::join_rows(d, d);
+  categoricalLabels = arma::join_rows(l, l);
+
+  DecisionTree<> tree(data, labels, 3, 5);
+  DecisionTree<> weightedTree(data, labels, 3, weights, 5);
+  DecisionTree<> categoricalTree(categoricalData, di, categoricalLabels, 5, 5);
+
+#ifdef MLPACK_USE_OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  DecisionTree<> serialTree(data, labels, 3, 5);
+  DecisionTree<> serialWeightedTree(data, labels, 3, weights, 5);
+  DecisionTree<> serialCategoricalTree(categoricalData, di, categoricalLabels,
+      5, 5);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(threads);
+#endif
+
+  REQUIRE(tree.NumChildren() > 0);
+  CheckSameTree(tree, serialTree);
+  CheckSameTree(weightedTree, serialWeightedTree);
+  CheckSameTree(categoricalTree, serialCategoricalTree);
+}
+
+/**
+ * Make sure that SplitIfBetterSorted() on sorted points gives the same split as
+ * SplitIfBetter() on the unsorted points.
+ */
+TEST_CASE("BestBinaryNumericSplitSortedTest", "[DecisionTreeTest]")
+{
+  arma::rowvec values(200, arma::fill::randu);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < values.n_elem; ++i)
+    labels[i] = (values[i] > 0.4) ? 1 : ((values[i] > 0.2) ? 2 : 0);
+  arma::rowvec weights(200, arma::fill::randu);
+
+  const arma::uvec order = arma::stable_sort_index(values);
+  const arma::rowvec sortedValues = values.cols(order);
+  const arma::Row<size_t> sortedLabels = labels.cols(order);
+  const arma::rowvec sortedWeights = weights.cols(order);
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 3, weights);
+  BestBinaryNumericSplit<GiniGain>::AuxiliarySplitInfo aux;
+  arma::vec splitInfo, sortedSplitInfo;
+  const double gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 3, weights, 3, 1e-7, splitInfo, aux);
+  const double sortedGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetterSorted<false>(bestGain,
+      sortedValues, sortedLabels, 3, sortedWeights, 3, 1e-7, sortedSplitInfo);
+
+  REQUIRE(gain != DBL_MAX);
+  REQUIRE(sortedGain == gain);
+  REQUIRE(sortedSplitInfo[0] == splitInfo[0]);
+
+  const double weightedGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 3, weights, 3, 1e-7, splitInfo, aux);
+  const double sortedWeightedGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetterSorted<true>(bestGain,
+      sortedValues, sortedLabels, 3, sortedWeights, 3, 1e-7, sortedSplitInfo);
+
+  REQUIRE(weightedGain != DBL_MAX);
+  REQUIRE(sortedWeightedGain == Approx(weightedGain).epsilon(1e-10));
+  REQUIRE(sortedSplitInfo[0] == splitInfo[0]);
+}
+
+/**
+ * Make sure that a tree trained with PresortedBinaryNumericSplit is the same as
+ * a tree trained with BestBinaryNumericSplit, for numeric, weighted, and
+ * categorical data.
+ */
+TEST_CASE("PresortedBinaryNumericSplitTreeTest", "[DecisionTreeTest]")
+{
+  arma::mat data(6, 5000, arma::fill::randu);
+  arma::Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    if (data(0, i) + data(1, i) > 1.0)
+      labels[i] = (data(2, i) > 0.3) ? 1 : 2;
+    else
+      labels[i] = (data(3, i) * data(4, i) > 0.2) ? 2 : 0;
+  }
+  arma::rowvec weights(data.n_cols, arma::fill::randu);
+
+  arma::mat categoricalData;
+  arma::Row<size_t> categoricalLabels;
+  data::DatasetInfo di;
+  MockCategoricalData(categoricalData, categoricalLabels, di);
+
+  typedef DecisionTree<GiniGain, PresortedBinaryNumericSplit> PresortedTree;
+  static_assert(PresortedTree::ParallelTrain,
+      "PresortedBinaryNumericSplit should be trained in parallel!");
+
+  DecisionTree<> tree(data, labels, 3, 5);
+  PresortedTree presortedTree(data, labels, 3, 5);
+  CheckSameTree(presortedTree, tree);
+
+  DecisionTree<> weightedTree(data, labels, 3, weights, 5);
+  PresortedTree presortedWeightedTree(data, labels, 3, weights, 5);
+  CheckSameTree(presortedWeightedTree, weightedTree);
+
+  DecisionTree<> categoricalTree(categoricalData, di, categoricalLabels, 5, 5);
+  PresortedTree presortedCategoricalTree(categoricalData, di,
+      categoricalLabels, 5, 5);
+  CheckSameTree(presortedCategoricalTree, categoricalTree);
+
+  arma::Row<size_t> predictions, presortedPredictions;
+  categoricalTree.Classify(categoricalData, predictions);
+  presortedCategoricalTree.Classify(categoricalData, presortedPredictions);
+  REQUIRE(arma::all(predictions == presortedPredictions));
+}
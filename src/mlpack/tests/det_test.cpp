@@ -283,6 +283,61 @@ TEST_CASE("TestGrow", "[DETTest]")
   REQUIRE(alpha == Approx(min(rootAlpha, rAlpha)).epsilon(1e-12));
 }
 
+// Check that two density estimation trees have the same structure, and that
+// the points of each leaf of the first tree lie within the leaf.
+void CheckSameDTree(const DTree<arma::mat>& tree,
+                    const DTree<arma::mat>& other,
+                    const arma::mat& data)
+{
+  REQUIRE(tree.Start() == other.Start());
+  REQUIRE(tree.End() == other.End());
+  REQUIRE(tree.SubtreeLeaves() == other.SubtreeLeaves());
+  REQUIRE(tree.Ratio() == other.Ratio());
+  REQUIRE((tree.Left() == NULL) == (other.Left() == NULL));
+
+  if (tree.Left() == NULL)
+  {
+    for (size_t i = tree.Start(); i < tree.End(); ++i)
+      REQUIRE(tree.WithinRange(data.col(i)));
+    return;
+  }
+
+  REQUIRE(tree.SplitDim() == other.SplitDim());
+  REQUIRE(tree.SplitValue() == other.SplitValue());
+  REQUIRE(tree.Left()->End() == tree.Right()->Start());
+  CheckSameDTree(*tree.Left(), *other.Left(), data);
+  CheckSameDTree(*tree.Right(), *other.Right(), data);
+}
+
+// Grow a tree large enough that its children are grown in parallel, and make
+// sure that the result is consistent and the same every time.
+TEST_CASE("TestParallelGrow", "[DETTest]")
+{
+  arma::mat dataset(3, 20000, arma::fill::randu);
+  dataset.cols(0, 9999) *= 0.5;
+
+  arma::mat data1(dataset), data2(dataset);
+  arma::Col<size_t> oldFromNew1 = arma::linspace<arma::Col<size_t>>(0,
+      dataset.n_cols - 1, dataset.n_cols);
+  arma::Col<size_t> oldFromNew2(oldFromNew1);
+
+  DTree<arma::mat> tree1(data1), tree2(data2);
+  const double alpha1 = tree1.Grow(data1, oldFromNew1, false, 10, 5);
+  const double alpha2 = tree2.Grow(data2, oldFromNew2, false, 10, 5);
+
+  REQUIRE(tree1.SubtreeLeaves() > 1);
+  REQUIRE(alpha1 == alpha2);
+  REQUIRE(arma::all(oldFromNew1 == oldFromNew2));
+  CheckSameDTree(tree1, tree2, data1);
+
+  // The data must have been permuted in place according to oldFromNew.
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(arma::approx_equal(data1.col(i), dataset.col(oldFromNew1[i]),
+        "absdiff", 0.0));
+  }
+}
+
 TEST_CASE("TestPruneAndUpdate", "[DETTest]")
 {
   arma::mat testData(3, 5);
@@ -230,6 +230,54 @@ TEST_CASE("DiscreteProbabilityTest", "[DistributionTest]")
   REQUIRE(prob(1) == Approx(0.0400000000000).epsilon(1e-5));
 }
 
+/**
+ * Make sure that the log-probabilities gathered from the log-probability tables
+ * are the logarithms of the probabilities, in the multivariate case.
+ */
+TEST_CASE("DiscreteLogProbabilityTablesTest", "[DistributionTest]")
+{
+  std::vector<arma::vec> probabilities;
+  probabilities.push_back(arma::randu<arma::vec>(4));
+  probabilities.push_back(arma::randu<arma::vec>(7));
+  probabilities.push_back(arma::vec("0.5 0.5 0.0"));
+  DiscreteDistribution d(probabilities);
+
+  std::vector<arma::vec> logTables;
+  d.LogProbabilityTables(logTables);
+  REQUIRE(logTables.size() == 3);
+  REQUIRE(logTables[0].n_elem == 4);
+  REQUIRE(logTables[1].n_elem == 7);
+  REQUIRE(logTables[2].n_elem == 3);
+
+  arma::mat obs(3, 200);
+  for (size_t i = 0; i < obs.n_cols; ++i)
+  {
+    obs(0, i) = RandInt(4);
+    obs(1, i) = RandInt(7);
+    obs(2, i) = RandInt(3);
+  }
+
+  arma::vec logProb, tableLogProb;
+  d.LogProbability(obs, logProb);
+  DiscreteDistribution::LogProbability(logTables, obs, tableLogProb);
+  REQUIRE(logProb.n_elem == 200);
+  REQUIRE(tableLogProb.n_elem == 200);
+  for (size_t i = 0; i < obs.n_cols; ++i)
+  {
+    const double expected = std::log(d.Probability(obs.unsafe_col(i)));
+    if (std::isinf(expected))
+    {
+      REQUIRE(std::isinf(logProb[i]));
+      REQUIRE(std::isinf(tableLogProb[i]));
+    }
+    else
+    {
+      REQUIRE(logProb[i] == Approx(expected).epsilon(1e-10));
+      REQUIRE(tableLogProb[i] == Approx(expected).epsilon(1e-10));
+    }
+  }
+}
+
 /*********************************/
 /** Gaussian Distribution Tests **/
 /*********************************/
@@ -447,6 +495,45 @@ TEST_CASE("GaussianMultipointMultivariateProbabilityTest", "[DistributionTest]")
   REQUIRE(phis(5) == Approx(-14.900192463287908).epsilon(1e-7));
 }
 
+/**
+ * Make sure the batch log-probabilities (which are computed in blocks) match
+ * the log-probabilities of each point, in double and single precision, and
+ * that they can be written into caller-owned memory.
+ */
+TEST_CASE("GaussianBatchLogProbabilityTest", "[DistributionTest]")
+{
+  arma::vec mean(6, arma::fill::randu);
+  arma::mat cov(6, 6, arma::fill::randu);
+  cov = cov * cov.t() + 0.5 * arma::eye<arma::mat>(6, 6);
+  GaussianDistribution g(mean, cov);
+
+  // Use several blocks, the last of which is not full.
+  arma::mat points(6, 1000, arma::fill::randu);
+  arma::vec logProbs;
+  g.LogProbability(points, logProbs);
+  REQUIRE(logProbs.n_elem == points.n_cols);
+
+  arma::mat storage(points.n_cols, 2, arma::fill::zeros);
+  arma::vec alias(storage.colptr(1), storage.n_rows, false, true);
+  g.LogProbability(points, alias);
+
+  arma::fvec floatLogProbs;
+  g.LogProbability(arma::conv_to<arma::fmat>::from(points), floatLogProbs);
+  REQUIRE(floatLogProbs.n_elem == points.n_cols);
+
+  arma::vec probs;
+  g.Probability(points, probs);
+
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    const double logProb = g.LogProbability(points.unsafe_col(i));
+    REQUIRE(logProbs[i] == Approx(logProb).epsilon(1e-10));
+    REQUIRE(storage(i, 1) == Approx(logProb).epsilon(1e-10));
+    REQUIRE(floatLogProbs[i] == Approx(logProb).epsilon(1e-4));
+    REQUIRE(probs[i] == Approx(std::exp(logProb)).epsilon(1e-10));
+  }
+}
+
 /**
  * Make sure random observations follow the probability distribution correctly.
  */
@@ -1208,6 +1295,15 @@ TEST_CASE("MahalanobisDistanceTest", "[DistributionTest]")
                 xmlD.Covariance(),
                 jsonD.Covariance(),
                 binaryD.Covariance());
+
+  // The factor of the covariance matrix is saved too.
+  d.Covariance() = d.Covariance() * d.Covariance().t();
+  d.Factorize();
+  SerializeObjectAll(d, xmlD, jsonD, binaryD);
+  REQUIRE(xmlD.Factorized());
+  REQUIRE(jsonD.Factorized());
+  REQUIRE(binaryD.Factorized());
+  CheckMatrices(d.Factor(), xmlD.Factor(), jsonD.Factor(), binaryD.Factor());
 }
 
 /**
@@ -1538,3 +1634,33 @@ TEST_CASE("DiagonalGaussianWeightedParametersReductionTest",
     REQUIRE(d1.Covariance()(i) == Approx(d2.Covariance()(i)).epsilon(1e-7));
   }
 }
+
+/**
+ * Make sure the batch log-probabilities of a diagonal Gaussian match the
+ * log-probabilities of each point, in double and single precision.
+ */
+TEST_CASE("DiagonalGaussianBatchLogProbabilityTest", "[DistributionTest]")
+{
+  arma::vec mean(7, arma::fill::randu);
+  arma::vec cov = arma::randu<arma::vec>(7) + 0.5;
+  DiagonalGaussianDistribution d(mean, cov);
+
+  arma::mat points(7, 300, arma::fill::randu);
+  arma::vec logProbs;
+  d.LogProbability(points, logProbs);
+  REQUIRE(logProbs.n_elem == points.n_cols);
+
+  arma::fvec floatLogProbs, floatProbs;
+  const arma::fmat floatPoints = arma::conv_to<arma::fmat>::from(points);
+  d.LogProbability(floatPoints, floatLogProbs);
+  d.Probability(floatPoints, floatProbs);
+  REQUIRE(floatLogProbs.n_elem == points.n_cols);
+
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    const double logProb = d.LogProbability(points.unsafe_col(i));
+    REQUIRE(logProbs[i] == Approx(logProb).epsilon(1e-10));
+    REQUIRE(floatLogProbs[i] == Approx(logProb).epsilon(1e-4));
+    REQUIRE(floatProbs[i] == Approx(std::exp(logProb)).epsilon(1e-4));
+  }
+}
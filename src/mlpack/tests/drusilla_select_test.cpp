@@ -162,3 +162,40 @@ TEST_CASE("SparseTest", "[DrusillaSelectTest]")
   REQUIRE(distances.n_cols == 1000);
   REQUIRE(distances.n_rows == 3);
 }
+
+// Make sure that training and searching in parallel gives the same results as
+// doing it with one thread.
+TEST_CASE("DrusillaSelectParallelTest", "[DrusillaSelectTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 3000);
+  arma::mat querySet = arma::randu<arma::mat>(5, 700);
+
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  DrusillaSelect<> serial(dataset, 10, 8);
+  arma::Mat<size_t> serialNeighbors;
+  arma::mat serialDistances;
+  serial.Search(querySet, 4, serialNeighbors, serialDistances);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(4);
+#endif
+
+  DrusillaSelect<> parallel(dataset, 10, 8);
+  arma::Mat<size_t> parallelNeighbors;
+  arma::mat parallelDistances;
+  parallel.Search(querySet, 4, parallelNeighbors, parallelDistances);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+
+  REQUIRE(arma::all(serial.CandidateIndices() ==
+      parallel.CandidateIndices()));
+  REQUIRE(arma::all(arma::vectorise(serialNeighbors == parallelNeighbors)));
+  REQUIRE(arma::approx_equal(serialDistances, parallelDistances, "absdiff",
+      1e-12));
+}
@@ -269,3 +269,47 @@ TEST_CASE("EMSTBallTreeTest", "[EMSTTest]")
     REQUIRE(bstResults(2, i) == Approx(ballResults(2, i)).epsilon(1e-7));
   }
 }
+
+/**
+ * Make sure that the dual-tree search gives the same tree as the naive method
+ * when its iterations are split into traversals of several query subtrees that
+ * run in parallel.
+ */
+TEST_CASE("EMSTParallelDualTreeVsNaive", "[EMSTTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("test_data_3_1000.csv", inputData))
+    FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+#endif
+
+  DualTreeBoruvka<> dtb(inputData);
+  DualTreeBoruvka<EuclideanDistance, arma::mat, StandardCoverTree>
+      ct(inputData);
+  DualTreeBoruvka<> dtbNaive(inputData, true);
+
+  arma::mat dualResults, coverResults, naiveResults;
+  dtb.ComputeMST(dualResults);
+  ct.ComputeMST(coverResults);
+  dtbNaive.ComputeMST(naiveResults);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+
+  REQUIRE(dualResults.n_cols == naiveResults.n_cols);
+  REQUIRE(coverResults.n_cols == naiveResults.n_cols);
+  for (size_t i = 0; i < naiveResults.n_cols; ++i)
+  {
+    REQUIRE(dualResults(0, i) == naiveResults(0, i));
+    REQUIRE(dualResults(1, i) == naiveResults(1, i));
+    REQUIRE(dualResults(2, i) == Approx(naiveResults(2, i)).epsilon(1e-7));
+
+    REQUIRE(coverResults(0, i) == naiveResults(0, i));
+    REQUIRE(coverResults(1, i) == naiveResults(1, i));
+    REQUIRE(coverResults(2, i) == Approx(naiveResults(2, i)).epsilon(1e-7));
+  }
+}
@@ -0,0 +1,168 @@
+/**
+ * @file tests/executor_test.cpp
+ *
+ * Tests for the executors that run the parallel loops of mlpack.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kmeans.hpp>
+#include <mlpack/methods/random_forest.hpp>
+
+#include "catch.hpp"
+#include "test_catch_tools.hpp"
+
+using namespace mlpack;
+
+/**
+ * An executor that counts the tasks it is given, and runs them serially.
+ */
+class CountingExecutor : public Executor
+{
+ public:
+  CountingExecutor() : calls(0), tasks(0) { }
+
+  void Run(const size_t numTasks,
+           const std::function<void(size_t)>& task,
+           const size_t /* numThreads */)
+  {
+    ++calls;
+    tasks += numTasks;
+    for (size_t i = 0; i < numTasks; ++i)
+      task(i);
+  }
+
+  size_t MaxThreads() const { return 4; }
+
+  size_t calls;
+  size_t tasks;
+};
+
+/**
+ * Make sure that ParallelFor() visits every index exactly once with each
+ * executor, and that exceptions of the loop body are rethrown.
+ */
+TEST_CASE("ParallelForExecutorsTest", "[ExecutorTest]")
+{
+  std::vector<std::shared_ptr<Executor>> executors;
+  executors.push_back(std::make_shared<OpenMPExecutor>());
+  executors.push_back(std::make_shared<SerialExecutor>());
+  executors.push_back(std::make_shared<ThreadPoolExecutor>(4));
+
+  for (const std::shared_ptr<Executor>& executor : executors)
+  {
+    SetExecutor(executor);
+
+    std::vector<size_t> visits(10007, 0);
+    ParallelFor(0, visits.size(), [&](const size_t i) { ++visits[i]; }, 13);
+    for (size_t i = 0; i < visits.size(); ++i)
+      REQUIRE(visits[i] == 1);
+
+    // Ranges cover the loop without overlapping.
+    std::vector<size_t> rangeVisits(1000, 0);
+    ParallelForRanges(0, rangeVisits.size(),
+        [&](const size_t begin, const size_t end)
+        {
+          for (size_t i = begin; i < end; ++i)
+            ++rangeVisits[i];
+        }, 7);
+    for (size_t i = 0; i < rangeVisits.size(); ++i)
+      REQUIRE(rangeVisits[i] == 1);
+
+    REQUIRE_THROWS_AS(ParallelFor(0, 100, [](const size_t i)
+        {
+          if (i == 57)
+            throw std::invalid_argument("57");
+        }), std::invalid_argument);
+  }
+
+  SetExecutor(nullptr);
+}
+
+/**
+ * Make sure ThreadLimit caps the number of threads, and that parallel loops
+ * inside parallel loops are serial.
+ */
+TEST_CASE("ThreadLimitTest", "[ExecutorTest]")
+{
+  SetExecutor(std::make_shared<ThreadPoolExecutor>(4));
+  REQUIRE(NumThreads() == 4);
+
+  {
+    ThreadLimit limit(2);
+    REQUIRE(NumThreads() == 2);
+    {
+      ThreadLimit serial(1);
+      REQUIRE(NumThreads() == 1);
+    }
+    REQUIRE(NumThreads() == 2);
+  }
+  REQUIRE(NumThreads() == 4);
+
+  // Catch assertions are not thread-safe, so the results are checked after
+  // the loop.
+  std::vector<size_t> innerThreads(8, 0), innerSums(8, 0);
+  ParallelFor(0, innerThreads.size(), [&](const size_t i)
+  {
+    innerThreads[i] = NumThreads();
+    ParallelFor(0, 100, [&](const size_t j) { innerSums[i] += j; });
+  });
+  for (size_t i = 0; i < innerThreads.size(); ++i)
+  {
+    REQUIRE(innerThreads[i] == 1);
+    REQUIRE(innerSums[i] == 4950);
+  }
+
+  SetExecutor(nullptr);
+
+  // OpenMP regions are capped too, and the previous number of threads is
+  // restored.
+#ifdef MLPACK_USE_OPENMP
+  const int ompThreads = omp_get_max_threads();
+  {
+    ThreadLimit limit(1);
+    REQUIRE(omp_get_max_threads() == 1);
+  }
+  REQUIRE(omp_get_max_threads() == ompThreads);
+#endif
+}
+
+/**
+ * Make sure that algorithms run their loops with the executor that is set, and
+ * give the same results as with the default executor.
+ */
+TEST_CASE("AlgorithmsUseExecutorTest", "[ExecutorTest]")
+{
+  arma::mat data(5, 1000, arma::fill::randu);
+  data.cols(500, 999) += 3.0;
+  arma::Row<size_t> labels(1000);
+  labels.head(500).zeros();
+  labels.tail(500).ones();
+
+  arma::mat initialCentroids = data.cols(0, 1);
+  arma::Row<size_t> assignments, poolAssignments;
+  arma::mat centroids(initialCentroids), poolCentroids(initialCentroids);
+  KMeans<> kmeans;
+  kmeans.Cluster(data, 2, assignments, centroids, false, true);
+
+  std::shared_ptr<CountingExecutor> counting =
+      std::make_shared<CountingExecutor>();
+  SetExecutor(counting);
+  kmeans.Cluster(data, 2, poolAssignments, poolCentroids, false, true);
+  REQUIRE(counting->calls > 0);
+  REQUIRE(arma::all(assignments == poolAssignments));
+  CheckMatrices(centroids, poolCentroids);
+
+  // Train a forest on the threads of a pool.
+  SetExecutor(std::make_shared<ThreadPoolExecutor>(3));
+  RandomForest<> rf(data, labels, 2, 10);
+  arma::Row<size_t> predictions;
+  rf.Classify(data, predictions);
+  REQUIRE(rf.NumTrees() == 10);
+  REQUIRE(arma::accu(predictions == labels) > 990);
+
+  SetExecutor(nullptr);
+}
@@ -122,6 +122,46 @@ TEST_CASE("DualTreeVsSingleTree", "[FastMKSTest]")
   }
 }
 
+/**
+ * Make sure that single-tree and dual-tree search give the same results with
+ * one thread and with every thread, for both a separate query set and the
+ * reference set, and when the same model searches twice.
+ */
+TEST_CASE("FastMKSParallelSearchTest", "[FastMKSTest]")
+{
+  arma::mat referenceData(6, 1500, arma::fill::randn);
+  arma::mat queryData(6, 700, arma::fill::randn);
+  PolynomialKernel pk(2.0, 1.0);
+
+  FastMKS<PolynomialKernel> naive(referenceData, pk, false, true);
+  arma::Mat<size_t> naiveIndices, naiveMonoIndices;
+  arma::mat naiveKernels, naiveMonoKernels;
+  naive.Search(queryData, 5, naiveIndices, naiveKernels);
+  naive.Search(5, naiveMonoIndices, naiveMonoKernels);
+
+  for (size_t threads = 0; threads <= 1; ++threads)
+  {
+    ThreadLimit limit(threads);
+    for (size_t single = 0; single <= 1; ++single)
+    {
+      FastMKS<PolynomialKernel> f(referenceData, pk, (single == 1));
+      for (size_t trial = 0; trial < 2; ++trial)
+      {
+        arma::Mat<size_t> indices, monoIndices;
+        arma::mat kernels, monoKernels;
+        f.Search(queryData, 5, indices, kernels);
+        f.Search(5, monoIndices, monoKernels);
+
+        REQUIRE(arma::all(arma::vectorise(indices == naiveIndices)));
+        REQUIRE(arma::approx_equal(kernels, naiveKernels, "reldiff", 1e-7));
+        REQUIRE(arma::all(arma::vectorise(monoIndices == naiveMonoIndices)));
+        REQUIRE(arma::approx_equal(monoKernels, naiveMonoKernels, "reldiff",
+            1e-7));
+      }
+    }
+  }
+}
+
 /**
  * Test sparse FastMKS (how useful is this, I'm not sure).
  */
@@ -471,6 +511,65 @@ TEST_CASE("FastMKSModelLinearTest", "[FastMKSTest]")
   }
 }
 
+/**
+ * Make sure that a single-precision FastMKSModel gives the same results as a
+ * double-precision FastMKS, up to the precision of float.
+ */
+TEST_CASE("FastMKSModelSinglePrecisionTest", "[FastMKSTest]")
+{
+  LinearKernel lk;
+  arma::mat referenceData = arma::randu<arma::mat>(10, 100);
+  arma::mat querySet = arma::randu<arma::mat>(10, 50);
+
+  FastMKS<LinearKernel> f(referenceData, lk);
+  arma::Mat<size_t> indices;
+  arma::mat kernels;
+  f.Search(querySet, 3, indices, kernels);
+
+  util::Timers timers;
+  for (size_t j = 0; j < 3; ++j)
+  {
+    FastMKSModel m(FastMKSModel::LINEAR_KERNEL, true);
+    REQUIRE(m.SinglePrecision() == true);
+
+    arma::mat referenceCopy(referenceData);
+    m.BuildModel(timers, std::move(referenceCopy), lk, (j == 1), (j == 2),
+        2.0);
+
+    arma::Mat<size_t> mIndices;
+    arma::mat mKernels;
+    m.Search(timers, querySet, 3, mIndices, mKernels, 2.0);
+
+    REQUIRE(mIndices.n_rows == indices.n_rows);
+    REQUIRE(mIndices.n_cols == indices.n_cols);
+    REQUIRE(mKernels.n_rows == kernels.n_rows);
+    REQUIRE(mKernels.n_cols == kernels.n_cols);
+
+    for (size_t i = 0; i < indices.n_elem; ++i)
+    {
+      // Near-ties may be broken differently in single precision, so check the
+      // kernel value of each returned point instead of its index.
+      const double trueKernel = arma::dot(querySet.col(i / 3),
+          referenceData.col(mIndices[i]));
+      REQUIRE(trueKernel == Approx(kernels[i]).epsilon(1e-5));
+      REQUIRE(mKernels[i] == Approx(kernels[i]).epsilon(1e-5));
+    }
+
+    // The model should still be single-precision after serialization.
+    FastMKSModel xmlModel, jsonModel, binaryModel;
+    SerializeObjectAll(m, xmlModel, jsonModel, binaryModel);
+    REQUIRE(xmlModel.SinglePrecision() == true);
+    REQUIRE(jsonModel.SinglePrecision() == true);
+    REQUIRE(binaryModel.SinglePrecision() == true);
+
+    arma::Mat<size_t> xmlIndices;
+    arma::mat xmlKernels;
+    xmlModel.Search(timers, querySet, 3, xmlIndices, xmlKernels, 2.0);
+    CheckMatrices(mIndices, xmlIndices);
+    CheckMatrices(mKernels, xmlKernels);
+  }
+}
+
 // Test the polynomial kernel mode of the FastMKSModel.
 TEST_CASE("FastMKSModelPolynomialTest", "[FastMKSTest]")
 {
@@ -1137,3 +1236,103 @@ TEST_CASE("CopyAssignmentTest", "[FastMKSTest]")
       REQUIRE(newKernels[i] == Approx(0.0).margin(1e-5));
   }
 }
+
+/**
+ * Check single-tree and dual-tree ConeSearch against brute-force search, with
+ * the given similarity and tree type, for bichromatic and monochromatic search.
+ */
+template<typename SimilarityType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckConeSearch(const arma::mat& referenceData,
+                     const arma::mat& queryData)
+{
+  ConeSearch<SimilarityType, arma::mat, TreeType> naive(referenceData, false,
+      true);
+  ConeSearch<SimilarityType, arma::mat, TreeType> single(referenceData, true);
+  ConeSearch<SimilarityType, arma::mat, TreeType> dual(referenceData);
+
+  for (size_t mono = 0; mono < 2; ++mono)
+  {
+    arma::Mat<size_t> naiveIndices, singleIndices, dualIndices;
+    arma::mat naiveSimilarities, singleSimilarities, dualSimilarities;
+    if (mono)
+    {
+      naive.Search(5, naiveIndices, naiveSimilarities);
+      single.Search(5, singleIndices, singleSimilarities);
+      dual.Search(5, dualIndices, dualSimilarities);
+    }
+    else
+    {
+      naive.Search(queryData, 5, naiveIndices, naiveSimilarities);
+      single.Search(queryData, 5, singleIndices, singleSimilarities);
+      dual.Search(queryData, 5, dualIndices, dualSimilarities);
+    }
+
+    REQUIRE(singleIndices.n_rows == 5);
+    REQUIRE(singleIndices.n_cols == naiveIndices.n_cols);
+    REQUIRE(dualIndices.n_cols == naiveIndices.n_cols);
+    for (size_t i = 0; i < naiveIndices.n_elem; ++i)
+    {
+      // The similarities of the zero point are all zero, so its results are
+      // ties in any order.
+      if (naiveSimilarities[i] != 0.0)
+      {
+        REQUIRE(singleIndices[i] == naiveIndices[i]);
+        REQUIRE(dualIndices[i] == naiveIndices[i]);
+      }
+      REQUIRE(singleSimilarities[i] ==
+          Approx(naiveSimilarities[i]).epsilon(1e-7).margin(1e-10));
+      REQUIRE(dualSimilarities[i] ==
+          Approx(naiveSimilarities[i]).epsilon(1e-7).margin(1e-10));
+    }
+  }
+}
+
+/**
+ * Make sure that cone tree search finds the same maximum inner products as
+ * FastMKS with the linear kernel, and the same results as brute-force search
+ * for the inner product and the cosine similarity.
+ */
+TEST_CASE("ConeSearchTest", "[FastMKSTest]")
+{
+  // The data is not centered, so that the cones of the nodes are narrow.
+  arma::mat referenceData = arma::randn<arma::mat>(5, 1000) + 1.0;
+  arma::mat queryData = arma::randn<arma::mat>(5, 200) + 1.0;
+  // A point with a norm of zero has a similarity of zero with any point.
+  referenceData.col(17).zeros();
+
+  FastMKS<LinearKernel> fastmks(referenceData, false, true);
+  arma::Mat<size_t> fastmksIndices;
+  arma::mat fastmksKernels;
+  fastmks.Search(queryData, 5, fastmksIndices, fastmksKernels);
+
+  ConeSearch<> cone(referenceData);
+  arma::Mat<size_t> indices;
+  arma::mat similarities;
+  cone.Search(queryData, 5, indices, similarities);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    REQUIRE(indices[i] == fastmksIndices[i]);
+    REQUIRE(similarities[i] == Approx(fastmksKernels[i]).epsilon(1e-7));
+  }
+
+  // Check the cosine similarities of the brute-force search.
+  ConeSearch<CosineSimilarity> naiveCosine(referenceData, false, true);
+  naiveCosine.Search(queryData, 5, indices, similarities);
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 5; ++j)
+    {
+      const arma::vec r = referenceData.col(indices(j, i));
+      REQUIRE(similarities(j, i) == Approx(arma::dot(queryData.col(i), r) /
+          (arma::norm(queryData.col(i)) * arma::norm(r))).epsilon(1e-7));
+    }
+  }
+
+  CheckConeSearch<InnerProductSimilarity, KDTree>(referenceData, queryData);
+  CheckConeSearch<CosineSimilarity, KDTree>(referenceData, queryData);
+  CheckConeSearch<InnerProductSimilarity, BallTree>(referenceData, queryData);
+  CheckConeSearch<CosineSimilarity, BallTree>(referenceData, queryData);
+}
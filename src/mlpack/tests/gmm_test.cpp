@@ -74,6 +74,72 @@ TEST_CASE("GMMProbabilityComponentTest", "[GMMTest]")
   REQUIRE(gmm.Probability("1.4 0", 1) == Approx(0.0067568972024).epsilon(1e-7));
 }
 
+/**
+ * Make sure the batched log-probabilities of a GMM match the log-probabilities
+ * of each observation and component, in double and single precision, for a
+ * dataset that spans several blocks.
+ */
+TEST_CASE("GMMComponentLogProbabilityTest", "[GMMTest]")
+{
+  GMM gmm(3, 3);
+  gmm.Component(0) = GaussianDistribution("0 0 0",
+      "1 0.2 0; 0.2 1 0.1; 0 0.1 0.5");
+  gmm.Component(1) = GaussianDistribution("3 3 -1",
+      "2 1 0; 1 2 0.3; 0 0.3 1");
+  gmm.Component(2) = GaussianDistribution("-2 4 1",
+      "0.5 0 0; 0 0.7 0.2; 0 0.2 1.5");
+  gmm.Weights() = "0.3 0.5 0.2";
+
+  arma::mat observations(3, 2500, arma::fill::randn);
+  observations *= 3.0;
+
+  arma::mat componentLogProbs;
+  arma::vec logProbs;
+  arma::Row<size_t> labels;
+  gmm.ComponentLogProbability(observations, componentLogProbs);
+  gmm.LogProbability(observations, logProbs);
+  gmm.Classify(observations, labels);
+
+  arma::fmat fComponentLogProbs;
+  arma::fvec fLogProbs;
+  arma::Row<size_t> fLabels;
+  const arma::fmat fObservations = arma::conv_to<arma::fmat>::from(
+      observations);
+  gmm.ComponentLogProbability(fObservations, fComponentLogProbs);
+  gmm.LogProbability(fObservations, fLogProbs);
+  gmm.Classify(fObservations, fLabels);
+
+  REQUIRE(componentLogProbs.n_rows == 2500);
+  REQUIRE(componentLogProbs.n_cols == 3);
+  REQUIRE(logProbs.n_elem == 2500);
+  REQUIRE(labels.n_elem == 2500);
+
+  size_t sameLabels = 0;
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    REQUIRE(logProbs[i] ==
+        Approx(gmm.LogProbability(observations.col(i))).epsilon(1e-7));
+    REQUIRE(fLogProbs[i] == Approx(logProbs[i]).epsilon(1e-4));
+
+    size_t maxComponent = 0;
+    for (size_t j = 0; j < 3; ++j)
+    {
+      const double logProb = gmm.LogProbability(observations.col(i), j);
+      REQUIRE(componentLogProbs(i, j) == Approx(logProb).epsilon(1e-7));
+      REQUIRE(fComponentLogProbs(i, j) == Approx(logProb).epsilon(1e-4));
+      if (logProb >= gmm.LogProbability(observations.col(i), maxComponent))
+        maxComponent = j;
+    }
+
+    REQUIRE(labels[i] == maxComponent);
+    if (fLabels[i] == labels[i])
+      ++sameLabels;
+  }
+
+  // Single precision may only change the label of points near a boundary.
+  REQUIRE(sameLabels >= 2490);
+}
+
 /**
  * Test training a model on only one Gaussian (randomly generated) in two
  * dimensions.  We will vary the dataset size from small to large.  The EM
@@ -244,6 +310,86 @@ TEST_CASE("GMMTrainEMMultipleGaussians", "[GMMTest]")
   REQUIRE(success == true);
 }
 
+/**
+ * Make sure that training a GMM with several threads gives the same model as
+ * training it with one thread, when the dataset spans several blocks of the
+ * parallel E-step and M-step.
+ */
+TEST_CASE("GMMTrainEMParallelTest", "[GMMTest]")
+{
+  GaussianDistribution d1("0.0 1.0 0.0", "1.0 0.0 0.5;"
+                                         "0.0 0.8 0.1;"
+                                         "0.5 0.1 1.0");
+  GaussianDistribution d2("4.0 -1.0 2.0", "1.5 0.2 0.0;"
+                                          "0.2 1.0 0.3;"
+                                          "0.0 0.3 0.7");
+  GaussianDistribution d3("-3.0 3.0 -2.0", "0.6 0.1 0.2;"
+                                           "0.1 1.2 0.0;"
+                                           "0.2 0.0 0.9");
+
+  arma::mat observations(3, 15000);
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    observations.col(i) = d1.Random();
+    observations.col(5000 + i) = d2.Random();
+    observations.col(10000 + i) = d3.Random();
+  }
+  arma::vec probabilities;
+  probabilities.randu(15000);
+
+  // Start from the same model, with identity covariances.
+  GMM initial(3, 3);
+  initial.Component(0).Mean() = "0.5 0.5 0.5";
+  initial.Component(1).Mean() = "3.0 0.0 1.0";
+  initial.Component(2).Mean() = "-2.0 2.0 -1.0";
+  initial.Weights().fill(1.0 / 3.0);
+
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  GMM serial(initial), serialProb(initial);
+  const double serialLikelihood = serial.Train(observations, 1, true,
+      EMFit<>(30));
+  const double serialProbLikelihood = serialProb.Train(observations,
+      probabilities, 1, true, EMFit<>(30));
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(4);
+#endif
+
+  GMM parallel(initial), parallelProb(initial);
+  const double parallelLikelihood = parallel.Train(observations, 1, true,
+      EMFit<>(30));
+  const double parallelProbLikelihood = parallelProb.Train(observations,
+      probabilities, 1, true, EMFit<>(30));
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+
+  REQUIRE(parallelLikelihood == Approx(serialLikelihood).epsilon(1e-5));
+  REQUIRE(parallelProbLikelihood ==
+      Approx(serialProbLikelihood).epsilon(1e-5));
+  for (size_t i = 0; i < 3; ++i)
+  {
+    REQUIRE(parallel.Weights()[i] ==
+        Approx(serial.Weights()[i]).epsilon(1e-5));
+    CheckMatrices(parallel.Component(i).Mean(), serial.Component(i).Mean(),
+        1e-3);
+    CheckMatrices(parallel.Component(i).Covariance(),
+        serial.Component(i).Covariance(), 1e-3);
+
+    REQUIRE(parallelProb.Weights()[i] ==
+        Approx(serialProb.Weights()[i]).epsilon(1e-5));
+    CheckMatrices(parallelProb.Component(i).Mean(),
+        serialProb.Component(i).Mean(), 1e-3);
+    CheckMatrices(parallelProb.Component(i).Covariance(),
+        serialProb.Component(i).Covariance(), 1e-3);
+  }
+}
+
 /**
  * Train a single-gaussian mixture, but using the overload of Train() where
  * probabilities of the observation are given.
@@ -838,6 +984,246 @@ TEST_CASE("UseExistingModelTest", "[GMMTest]")
   }
 }
 
+/**
+ * Make sure that TreeEMFit with a responsibility tolerance of 0 takes the same
+ * EM steps as EMFit, with and without probabilities.
+ */
+TEST_CASE("TreeEMFitExactTest", "[GMMTest]")
+{
+  arma::mat data(4, 600);
+  data.randn();
+  data.cols(200, 399) += 3.0;
+  data.cols(400, 599) *= 2.0;
+  data.cols(400, 599) -= 3.0;
+
+  const arma::vec probabilities = 0.5 + 0.5 * arma::randu<arma::vec>(600);
+
+  // Start both fitters from the same model.  The log-likelihoods they use for
+  // convergence differ with probabilities, so a negative tolerance makes both
+  // take exactly 10 steps.
+  GMM initial(3, 4);
+  initial.Train(data, 1, false, EMFit<>(3));
+
+  for (size_t weighted = 0; weighted < 2; ++weighted)
+  {
+    GMM gmm(initial);
+    GMM treeGmm(initial);
+    if (weighted == 1)
+    {
+      gmm.Train(data, probabilities, 1, true, EMFit<>(10, -1.0));
+      treeGmm.Train(data, probabilities, 1, true, TreeEMFit<>(10, -1.0, 0.0));
+    }
+    else
+    {
+      gmm.Train(data, 1, true, EMFit<>(10, -1.0));
+      treeGmm.Train(data, 1, true, TreeEMFit<>(10, -1.0, 0.0));
+    }
+
+    for (size_t i = 0; i < gmm.Gaussians(); ++i)
+    {
+      REQUIRE(treeGmm.Weights()[i] == Approx(gmm.Weights()[i]).epsilon(1e-5));
+
+      for (size_t j = 0; j < gmm.Dimensionality(); ++j)
+      {
+        REQUIRE(treeGmm.Component(i).Mean()[j] ==
+            Approx(gmm.Component(i).Mean()[j]).epsilon(1e-5).margin(1e-8));
+
+        for (size_t k = 0; k < gmm.Dimensionality(); ++k)
+        {
+          REQUIRE(treeGmm.Component(i).Covariance()(j, k) ==
+              Approx(gmm.Component(i).Covariance()(j, k)).epsilon(1e-5)
+              .margin(1e-8));
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that TreeEMFit uses the statistics of whole nodes for
+ * well-separated Gaussians, and still recovers them.
+ */
+TEST_CASE("TreeEMFitSeparatedTest", "[GMMTest]")
+{
+  const size_t dims = 3;
+  const size_t gaussians = 3;
+  arma::mat data(dims, 3000);
+  data.randn();
+  data.cols(1000, 1999) += 50.0;
+  data.cols(2000, 2999) += 100.0;
+
+  TreeEMFit<> fitter;
+  std::vector<GaussianDistribution> dists(gaussians,
+      GaussianDistribution(dims));
+  arma::vec weights(gaussians);
+  fitter.Estimate(data, dists, weights);
+
+  REQUIRE(fitter.NodesPruned() > 0);
+
+  // Sort the Gaussians by their means.
+  arma::vec firstCoordinates(gaussians);
+  for (size_t i = 0; i < gaussians; ++i)
+    firstCoordinates[i] = dists[i].Mean()[0];
+  const arma::uvec order = arma::sort_index(firstCoordinates);
+
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    const GaussianDistribution& d = dists[order[i]];
+    REQUIRE(weights[order[i]] == Approx(1.0 / 3.0).epsilon(0.01));
+    for (size_t j = 0; j < dims; ++j)
+    {
+      REQUIRE(d.Mean()[j] == Approx(50.0 * i).margin(0.2));
+      for (size_t k = 0; k < dims; ++k)
+      {
+        REQUIRE(d.Covariance()(j, k) ==
+            Approx((j == k) ? 1.0 : 0.0).margin(0.2));
+      }
+    }
+  }
+
+  // The fitter can also be used by GMM::Train().
+  GMM gmm(gaussians, dims);
+  const double logLikelihood = gmm.Train(data, 1, false, fitter);
+  REQUIRE(std::isfinite(logLikelihood));
+}
+
+/**
+ * Make sure that TreeEMFit computes the covariance accurately for points that
+ * are far from the origin compared to their spread.
+ */
+TEST_CASE("TreeEMFitOffsetTest", "[GMMTest]")
+{
+  const size_t dims = 3;
+  arma::mat data(dims, 2000);
+  data.randn();
+  data += 1e7;
+
+  TreeEMFit<> fitter(5);
+  std::vector<GaussianDistribution> dists(1, GaussianDistribution(dims));
+  arma::vec weights(1);
+  fitter.Estimate(data, dists, weights);
+
+  const arma::mat expected = arma::cov(data.t(), 1);
+  for (size_t j = 0; j < dims; ++j)
+  {
+    REQUIRE(dists[0].Mean()[j] ==
+        Approx(arma::mean(data.row(j))).epsilon(1e-10));
+    for (size_t k = 0; k < dims; ++k)
+    {
+      REQUIRE(dists[0].Covariance()(j, k) ==
+          Approx(expected(j, k)).epsilon(1e-6).margin(1e-6));
+    }
+  }
+}
+
+/**
+ * Make sure that a step of OnlineEMFit with a step size of 1 over the whole
+ * dataset is an EM iteration, with and without probabilities.
+ */
+TEST_CASE("OnlineEMFitFullStepTest", "[GMMTest]")
+{
+  arma::mat data(4, 600);
+  data.randn();
+  data.cols(200, 399) += 3.0;
+  data.cols(400, 599) -= 3.0;
+
+  const arma::vec probabilities = 0.5 + 0.5 * arma::randu<arma::vec>(600);
+
+  GMM initial(3, 4);
+  initial.Train(data, 1, false, EMFit<>(3));
+
+  for (size_t weighted = 0; weighted < 2; ++weighted)
+  {
+    // EMFit with two iterations takes exactly one M-step.
+    GMM gmm(initial);
+    GMM onlineGmm(initial);
+    OnlineEMFit<> fitter(600, 1, 0.0);
+    if (weighted == 1)
+    {
+      gmm.Train(data, probabilities, 1, true, EMFit<>(2));
+      onlineGmm.Train(data, probabilities, 1, true, fitter);
+    }
+    else
+    {
+      gmm.Train(data, 1, true, EMFit<>(2));
+      onlineGmm.Train(data, 1, true, fitter);
+    }
+
+    for (size_t i = 0; i < gmm.Gaussians(); ++i)
+    {
+      REQUIRE(onlineGmm.Weights()[i] ==
+          Approx(gmm.Weights()[i]).epsilon(1e-5));
+
+      for (size_t j = 0; j < gmm.Dimensionality(); ++j)
+      {
+        REQUIRE(onlineGmm.Component(i).Mean()[j] ==
+            Approx(gmm.Component(i).Mean()[j]).epsilon(1e-5).margin(1e-8));
+
+        for (size_t k = 0; k < gmm.Dimensionality(); ++k)
+        {
+          REQUIRE(onlineGmm.Component(i).Covariance()(j, k) ==
+              Approx(gmm.Component(i).Covariance()(j, k)).epsilon(1e-5)
+              .margin(1e-8));
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that OnlineEMFit recovers well-separated Gaussians from
+ * mini-batches, and that a model can be updated from streamed chunks.
+ */
+TEST_CASE("OnlineEMFitStreamingTest", "[GMMTest]")
+{
+  const size_t dims = 3;
+  const size_t gaussians = 3;
+  arma::mat data(dims, 6000);
+  data.randn();
+  data.cols(2000, 3999) += 10.0;
+  data.cols(4000, 5999) -= 10.0;
+  data = data.cols(arma::randperm<arma::uvec>(data.n_cols));
+
+  // Fit the first half in mini-batches.
+  OnlineEMFit<> fitter(200, 3);
+  std::vector<GaussianDistribution> dists(gaussians,
+      GaussianDistribution(dims));
+  arma::vec weights(gaussians);
+  fitter.Estimate(data.cols(0, 2999), dists, weights);
+  REQUIRE(fitter.StepCount() == 45);
+
+  // Now stream the second half through the model.
+  for (size_t begin = 3000; begin < data.n_cols; begin += 500)
+    fitter.Update(data.cols(begin, begin + 499), dists, weights);
+  REQUIRE(fitter.StepCount() == 51);
+
+  // Sort the Gaussians by their means.
+  arma::vec firstCoordinates(gaussians);
+  for (size_t i = 0; i < gaussians; ++i)
+    firstCoordinates[i] = dists[i].Mean()[0];
+  const arma::uvec order = arma::sort_index(firstCoordinates);
+
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    const GaussianDistribution& d = dists[order[i]];
+    REQUIRE(weights[order[i]] == Approx(1.0 / 3.0).epsilon(0.05));
+    for (size_t j = 0; j < dims; ++j)
+    {
+      REQUIRE(d.Mean()[j] == Approx(10.0 * i - 10.0).margin(0.2));
+      for (size_t k = 0; k < dims; ++k)
+      {
+        REQUIRE(d.Covariance()(j, k) ==
+            Approx((j == k) ? 1.0 : 0.0).margin(0.2));
+      }
+    }
+  }
+
+  // A model of the wrong dimensionality cannot be updated.
+  arma::mat other(dims + 1, 10, arma::fill::randu);
+  REQUIRE_THROWS_AS(fitter.Update(other, dists, weights),
+      std::invalid_argument);
+}
+
 /********************************************************/
 /** Diagonal Gaussian Mixture Model(DiagonalGMM) Tests **/
 /********************************************************/
@@ -876,6 +1262,69 @@ TEST_CASE("DiagonalGMMProbabilityComponentTest", "[GMMTest]")
       Approx(8.60082772711e-05).epsilon(1e-7));
 }
 
+/**
+ * Make sure the batched log-probabilities of a DiagonalGMM match the
+ * log-probabilities of each observation and component, in double and single
+ * precision, for a dataset that spans several blocks.
+ */
+TEST_CASE("DiagonalGMMComponentLogProbabilityTest", "[GMMTest]")
+{
+  DiagonalGMM gmm(3, 3);
+  gmm.Component(0) = DiagonalGaussianDistribution("0 0 0", "1 1 0.5");
+  gmm.Component(1) = DiagonalGaussianDistribution("3 3 -1", "2 2 1");
+  gmm.Component(2) = DiagonalGaussianDistribution("-2 4 1", "0.5 0.7 1.5");
+  gmm.Weights() = "0.3 0.5 0.2";
+
+  arma::mat observations(3, 2500, arma::fill::randn);
+  observations *= 3.0;
+
+  arma::mat componentLogProbs;
+  arma::vec logProbs;
+  arma::Row<size_t> labels;
+  gmm.ComponentLogProbability(observations, componentLogProbs);
+  gmm.LogProbability(observations, logProbs);
+  gmm.Classify(observations, labels);
+
+  arma::fmat fComponentLogProbs;
+  arma::fvec fLogProbs;
+  arma::Row<size_t> fLabels;
+  const arma::fmat fObservations = arma::conv_to<arma::fmat>::from(
+      observations);
+  gmm.ComponentLogProbability(fObservations, fComponentLogProbs);
+  gmm.LogProbability(fObservations, fLogProbs);
+  gmm.Classify(fObservations, fLabels);
+
+  REQUIRE(componentLogProbs.n_rows == 2500);
+  REQUIRE(componentLogProbs.n_cols == 3);
+  REQUIRE(logProbs.n_elem == 2500);
+  REQUIRE(labels.n_elem == 2500);
+
+  size_t sameLabels = 0;
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    REQUIRE(logProbs[i] ==
+        Approx(gmm.LogProbability(observations.col(i))).epsilon(1e-7));
+    REQUIRE(fLogProbs[i] == Approx(logProbs[i]).epsilon(1e-4));
+
+    size_t maxComponent = 0;
+    for (size_t j = 0; j < 3; ++j)
+    {
+      const double logProb = gmm.LogProbability(observations.col(i), j);
+      REQUIRE(componentLogProbs(i, j) == Approx(logProb).epsilon(1e-7));
+      REQUIRE(fComponentLogProbs(i, j) == Approx(logProb).epsilon(1e-4));
+      if (logProb >= gmm.LogProbability(observations.col(i), maxComponent))
+        maxComponent = j;
+    }
+
+    REQUIRE(labels[i] == maxComponent);
+    if (fLabels[i] == labels[i])
+      ++sameLabels;
+  }
+
+  // Single precision may only change the label of points near a boundary.
+  REQUIRE(sameLabels >= 2490);
+}
+
 /**
  * Make sure we can train a model on only one Gaussian (randomly generated)
  * in two dimensions.  We will vary the dataset size from small to large.
@@ -1506,6 +1506,171 @@ TEST_CASE("HMMTrainReturnLogLikelihood", "[HMMTest]")
   REQUIRE(std::isfinite(loglik) == true);
 }
 
+/**
+ * Make sure that Baum-Welch training on many sequences gives the same model
+ * with several threads as with one thread.
+ */
+TEST_CASE("HMMParallelTrainTest", "[HMMTest]")
+{
+  arma::mat transition("0.7 0.2; 0.3 0.8");
+  std::vector<DiscreteDistribution> emissions(2);
+  emissions[0] = DiscreteDistribution(
+      std::vector<arma::vec>{"0.6 0.3 0.1"});
+  emissions[1] = DiscreteDistribution(
+      std::vector<arma::vec>{"0.1 0.2 0.7"});
+  HMM<DiscreteDistribution> trueHmm(arma::vec("0.5 0.5"), transition,
+      emissions);
+
+  std::vector<arma::mat> observations(300);
+  arma::Row<size_t> states;
+  for (size_t i = 0; i < observations.size(); ++i)
+    trueHmm.Generate(20 + RandInt(30), observations[i], states);
+
+  // Both models start from the same (perturbed) parameters.
+  arma::mat initialTransition("0.6 0.3; 0.4 0.7");
+  std::vector<DiscreteDistribution> initialEmissions(2);
+  initialEmissions[0] = DiscreteDistribution(
+      std::vector<arma::vec>{"0.5 0.3 0.2"});
+  initialEmissions[1] = DiscreteDistribution(
+      std::vector<arma::vec>{"0.2 0.3 0.5"});
+  HMM<DiscreteDistribution> serialHmm(arma::vec("0.4 0.6"),
+      initialTransition, initialEmissions);
+  HMM<DiscreteDistribution> parallelHmm(serialHmm);
+
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  const double serialLoglik = serialHmm.Train(observations);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(4);
+#endif
+
+  const double parallelLoglik = parallelHmm.Train(observations);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+
+  REQUIRE(parallelLoglik == Approx(serialLoglik).epsilon(1e-6));
+  CheckMatrices(parallelHmm.Transition(), serialHmm.Transition(), 1e-3);
+  CheckMatrices(parallelHmm.Initial(), serialHmm.Initial(), 1e-3);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    CheckMatrices(parallelHmm.Emission()[i].Probabilities(),
+        serialHmm.Emission()[i].Probabilities(), 1e-3);
+  }
+}
+
+/**
+ * Make sure that the batch Predict() and LogLikelihood() overloads give the
+ * same results as calling them on each sequence.
+ */
+TEST_CASE("HMMBatchPredictLogLikelihoodTest", "[HMMTest]")
+{
+  HMM<GaussianDistribution> hmm(3, GaussianDistribution(2));
+  hmm.Transition() = arma::mat("0.8 0.1 0.1; 0.1 0.8 0.1; 0.1 0.1 0.8");
+  hmm.Emission()[0] = GaussianDistribution("0 0", "1 0; 0 1");
+  hmm.Emission()[1] = GaussianDistribution("4 0", "1 0.3; 0.3 1");
+  hmm.Emission()[2] = GaussianDistribution("0 4", "0.5 0; 0 2");
+
+  std::vector<arma::mat> observations(100);
+  arma::Row<size_t> states;
+  for (size_t i = 0; i < observations.size(); ++i)
+    hmm.Generate(10 + RandInt(40), observations[i], states, RandInt(3));
+
+  std::vector<arma::Row<size_t>> predictions;
+  const arma::vec pathLogLikelihoods = hmm.Predict(observations, predictions);
+  const arma::vec logLikelihoods = hmm.LogLikelihood(observations);
+
+  REQUIRE(predictions.size() == observations.size());
+  REQUIRE(pathLogLikelihoods.n_elem == observations.size());
+  REQUIRE(logLikelihoods.n_elem == observations.size());
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> prediction;
+    const double pathLogLikelihood = hmm.Predict(observations[i], prediction);
+    REQUIRE(pathLogLikelihoods[i] == Approx(pathLogLikelihood).epsilon(1e-7));
+    CheckMatrices(predictions[i], prediction);
+    REQUIRE(logLikelihoods[i] ==
+        Approx(hmm.LogLikelihood(observations[i])).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure that the Forward-Backward algorithm gives the same results with
+ * scaled probabilities as with log-probabilities, for discrete and Gaussian
+ * emissions.
+ */
+TEST_CASE("HMMScaledProbabilitiesTest", "[HMMTest]")
+{
+  HMM<DiscreteDistribution> hmm(3, DiscreteDistribution(3));
+  hmm.Transition() = arma::mat("0.7 0.2 0.1; 0.2 0.6 0.3; 0.1 0.2 0.6");
+  hmm.Emission()[0] = DiscreteDistribution(
+      std::vector<arma::vec>{"0.6 0.3 0.1"});
+  hmm.Emission()[1] = DiscreteDistribution(
+      std::vector<arma::vec>{"0.1 0.8 0.1"});
+  hmm.Emission()[2] = DiscreteDistribution(
+      std::vector<arma::vec>{"0.2 0.2 0.6"});
+
+  HMM<GaussianDistribution> gaussianHMM(2, GaussianDistribution(2));
+  gaussianHMM.Transition() = arma::mat("0.9 0.2; 0.1 0.8");
+  gaussianHMM.Emission()[0] = GaussianDistribution("0 0", "1 0; 0 1");
+  gaussianHMM.Emission()[1] = GaussianDistribution("3 -2", "2 0.5; 0.5 1");
+
+  arma::mat observations, gaussianObservations;
+  arma::Row<size_t> states;
+  hmm.Generate(500, observations, states);
+  gaussianHMM.Generate(500, gaussianObservations, states);
+
+  // A very unlikely observation makes the emission probabilities of one time
+  // step far smaller than those of the others.
+  gaussianObservations.col(250) = arma::vec("40 40");
+
+  auto check = [](auto& model, const arma::mat& data)
+  {
+    arma::mat stateProb, forwardProb, backwardProb;
+    arma::vec scales;
+    model.ScaledProbabilities() = false;
+    const double logLikelihood = model.Estimate(data, stateProb, forwardProb,
+        backwardProb, scales);
+
+    arma::mat scaledStateProb, scaledForwardProb, scaledBackwardProb;
+    arma::vec scaledScales;
+    model.ScaledProbabilities() = true;
+    const double scaledLogLikelihood = model.Estimate(data, scaledStateProb,
+        scaledForwardProb, scaledBackwardProb, scaledScales);
+
+    REQUIRE(scaledLogLikelihood == Approx(logLikelihood).epsilon(1e-7));
+    REQUIRE(model.LogLikelihood(data) == Approx(logLikelihood).epsilon(1e-7));
+    CheckMatrices(scaledStateProb, stateProb, 1e-5);
+    CheckMatrices(scaledForwardProb, forwardProb, 1e-5);
+    CheckMatrices(scaledBackwardProb, backwardProb, 1e-5);
+    CheckMatrices(scaledScales, scales, 1e-5);
+  };
+
+  check(hmm, observations);
+  check(gaussianHMM, gaussianObservations);
+
+  // Training with scaled probabilities should give the same model.
+  HMM<DiscreteDistribution> scaledHMM(hmm);
+  hmm.ScaledProbabilities() = false;
+  scaledHMM.ScaledProbabilities() = true;
+  const std::vector<arma::mat> sequences = { observations };
+  const double logLikelihood = hmm.Train(sequences);
+  const double scaledLogLikelihood = scaledHMM.Train(sequences);
+
+  REQUIRE(scaledLogLikelihood == Approx(logLikelihood).epsilon(1e-5));
+  CheckMatrices(scaledHMM.Transition(), hmm.Transition(), 1e-3);
+  for (size_t i = 0; i < hmm.Emission().size(); ++i)
+  {
+    CheckMatrices(scaledHMM.Emission()[i].Probabilities(),
+        hmm.Emission()[i].Probabilities(), 1e-3);
+  }
+}
+
 /********************************************/
 /** DiagonalGMM Hidden Markov Models Tests **/
 /********************************************/
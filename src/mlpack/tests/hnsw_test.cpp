@@ -0,0 +1,162 @@
+/**
+ * @file tests/hnsw_test.cpp
+ *
+ * Unit tests for the 'HNSWSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include "catch.hpp"
+#include "test_catch_tools.hpp"
+#include "serialization.hpp"
+
+#include <mlpack/methods/hnsw.hpp>
+#include <mlpack/methods/neighbor_search.hpp>
+
+using namespace std;
+using namespace mlpack;
+
+/**
+ * Make sure that the recall of HNSW search is high, compared to exact search.
+ */
+TEST_CASE("HNSWRecallTest", "[HNSWTest]")
+{
+  arma::mat referenceData(10, 3000, arma::fill::randu);
+  arma::mat queryData(10, 200, arma::fill::randu);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 10, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData, 16, 200, 100);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, 10, neighbors, distances);
+
+  REQUIRE(neighbors.n_rows == 10);
+  REQUIRE(neighbors.n_cols == 200);
+  REQUIRE(distances.n_rows == 10);
+  REQUIRE(distances.n_cols == 200);
+  REQUIRE(KNN::Recall(neighbors, trueNeighbors) >= 0.95);
+
+  // The distances should be correct and sorted.
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      REQUIRE(distances(j, i) == Approx(EuclideanDistance::Evaluate(
+          queryData.col(i), referenceData.col(neighbors(j, i)))));
+      if (j > 0)
+        REQUIRE(distances(j, i) >= distances(j - 1, i));
+    }
+  }
+}
+
+/**
+ * Make sure that monochromatic search does not return a point as its own
+ * neighbor, and still has high recall.
+ */
+TEST_CASE("HNSWMonochromaticTest", "[HNSWTest]")
+{
+  arma::mat referenceData(5, 2000, arma::fill::randu);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(5, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(5, neighbors, distances);
+
+  REQUIRE(neighbors.n_rows == 5);
+  REQUIRE(neighbors.n_cols == 2000);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+      REQUIRE(neighbors(j, i) != i);
+
+  REQUIRE(KNN::Recall(neighbors, trueNeighbors) >= 0.95);
+}
+
+/**
+ * When ef is at least the number of points, a small dataset should give exact
+ * results.
+ */
+TEST_CASE("HNSWSmallDatasetExactTest", "[HNSWTest]")
+{
+  arma::mat referenceData(3, 40, arma::fill::randu);
+  arma::mat queryData(3, 20, arma::fill::randu);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 4, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData, 8, 40, 40);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, 4, neighbors, distances);
+
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+}
+
+/**
+ * Make sure that invalid parameters are reported.
+ */
+TEST_CASE("HNSWInvalidParametersTest", "[HNSWTest]")
+{
+  arma::mat referenceData(3, 20, arma::fill::randu);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  REQUIRE_THROWS_AS(HNSWSearch<>(referenceData, 1), std::invalid_argument);
+
+  HNSWSearch<> hnsw(referenceData);
+  arma::mat queryData(3, 5, arma::fill::randu);
+  arma::mat wrongDimQueryData(4, 5, arma::fill::randu);
+  REQUIRE_THROWS_AS(hnsw.Search(queryData, 21, neighbors, distances),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(hnsw.Search(20, neighbors, distances),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(hnsw.Search(wrongDimQueryData, 3, neighbors, distances),
+      std::invalid_argument);
+
+  // An untrained model can't be searched.
+  HNSWSearch<> untrained;
+  REQUIRE_THROWS_AS(untrained.Search(queryData, 1, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that a serialized model gives the same results as the original.
+ */
+TEST_CASE("HNSWSerializationTest", "[HNSWTest]")
+{
+  arma::mat referenceData(4, 500, arma::fill::randu);
+  arma::mat queryData(4, 50, arma::fill::randu);
+
+  HNSWSearch<> hnsw(referenceData, 8, 100, 30);
+
+  HNSWSearch<> xmlHnsw, jsonHnsw, binaryHnsw;
+  SerializeObjectAll(hnsw, xmlHnsw, jsonHnsw, binaryHnsw);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, jsonDistances, binaryDistances;
+  hnsw.Search(queryData, 5, neighbors, distances);
+  xmlHnsw.Search(queryData, 5, xmlNeighbors, xmlDistances);
+  jsonHnsw.Search(queryData, 5, jsonNeighbors, jsonDistances);
+  binaryHnsw.Search(queryData, 5, binaryNeighbors, binaryDistances);
+
+  REQUIRE(xmlHnsw.Ef() == 30);
+  REQUIRE(xmlHnsw.NumLayers() == hnsw.NumLayers());
+  CheckMatrices(neighbors, xmlNeighbors);
+  CheckMatrices(neighbors, jsonNeighbors);
+  CheckMatrices(neighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, jsonDistances, binaryDistances);
+}
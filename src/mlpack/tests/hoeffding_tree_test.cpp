@@ -1117,6 +1117,274 @@ TEST_CASE("ConfidenceChangeTest", "[HoeffdingTreeTest]")
     REQUIRE(tree.Child(c).NumChildren() == 0);
 }
 
+/**
+ * Make sure that training on mini-batches of one point gives the same tree as
+ * training on each point, and that training on larger mini-batches builds a
+ * good tree.
+ */
+TEST_CASE("HoeffdingTreeMiniBatchTest", "[HoeffdingTreeTest]")
+{
+  // Generate data.
+  arma::mat dataset(4, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(4); // All features are numeric, except the fourth.
+  info.MapString<double>("0", 3);
+  info.MapString<double>("1", 3);
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = Random();
+    dataset(1, i) = Random();
+    dataset(2, i) = Random();
+    dataset(3, i) = 0.0;
+    labels[i] = 0;
+
+    dataset(0, i + 1) = Random();
+    dataset(1, i + 1) = Random() - 1.0;
+    dataset(2, i + 1) = Random() + 0.5;
+    dataset(3, i + 1) = 1.0;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = Random();
+    dataset(1, i + 2) = Random() + 1.0;
+    dataset(2, i + 2) = Random() + 0.8;
+    dataset(3, i + 2) = 0.0;
+    labels[i + 2] = 1;
+  }
+
+  HoeffdingTree<> tree(info, 3, 0.9);
+  HoeffdingTree<> singlePointTree(info, 3, 0.9);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    tree.Train(dataset.col(i), labels[i]);
+    singlePointTree.TrainMiniBatch(dataset.cols(i, i), labels.cols(i, i));
+  }
+
+  REQUIRE(tree.NumChildren() > 0);
+  REQUIRE(singlePointTree.NumDescendants() == tree.NumDescendants());
+
+  arma::Row<size_t> predictions, singlePointPredictions;
+  tree.Classify(dataset, predictions);
+  singlePointTree.Classify(dataset, singlePointPredictions);
+  REQUIRE(arma::all(predictions == singlePointPredictions));
+
+  // Now train on mini-batches of 500 points.
+  HoeffdingTree<> miniBatchTree(info, 3, 0.9);
+  for (size_t i = 0; i < dataset.n_cols; i += 500)
+  {
+    miniBatchTree.TrainMiniBatch(dataset.cols(i, i + 499),
+        labels.cols(i, i + 499));
+  }
+
+  REQUIRE(miniBatchTree.NumChildren() > 0);
+
+  arma::Row<size_t> miniBatchPredictions;
+  miniBatchTree.Classify(dataset, miniBatchPredictions);
+  const double accuracy = (double) arma::accu(miniBatchPredictions == labels) /
+      labels.n_elem;
+  REQUIRE(accuracy > 0.8);
+
+  REQUIRE_THROWS_AS(miniBatchTree.TrainMiniBatch(dataset.cols(0, 9),
+      labels.cols(0, 8)), std::invalid_argument);
+}
+
+/**
+ * Make sure that training on the chunks of a ChunkedReader, with categorical
+ * features, gives the same tree as training on the same mini-batches held in
+ * memory.
+ */
+TEST_CASE("HoeffdingTreeTrainChunksTest", "[HoeffdingTreeTest]")
+{
+  const char* colors[] = { "red", "green", "blue" };
+  arma::Row<size_t> labels(3000);
+  fstream f;
+  f.open("hoeffding_chunks_test.csv", fstream::out);
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    const size_t color = RandInt(3);
+    const double x = Random();
+    labels[i] = (color == 2) ? 2 : (x < 0.5 ? 0 : 1);
+    f << colors[color] << "," << x << "," << Random() << endl;
+  }
+  f.close();
+
+  data::ChunkedReader<> reader("hoeffding_chunks_test.csv", 500, true, true);
+  REQUIRE(reader.Info().Type(0) == data::Datatype::categorical);
+  REQUIRE(reader.Info().NumMappings(0) == 3);
+  REQUIRE(reader.Info().Type(1) == data::Datatype::numeric);
+
+  HoeffdingTree<> tree(reader.Info(), 3, 0.9);
+  REQUIRE(tree.TrainChunks(reader, labels) == 3000);
+
+  arma::mat dataset;
+  data::DatasetInfo info;
+  REQUIRE(data::Load("hoeffding_chunks_test.csv", dataset, info, true));
+  HoeffdingTree<> miniBatchTree(info, 3, 0.9);
+  for (size_t i = 0; i < dataset.n_cols; i += 500)
+  {
+    miniBatchTree.TrainMiniBatch(dataset.cols(i, i + 499),
+        labels.cols(i, i + 499));
+  }
+
+  REQUIRE(tree.NumDescendants() == miniBatchTree.NumDescendants());
+  arma::Row<size_t> predictions, miniBatchPredictions;
+  tree.Classify(dataset, predictions);
+  miniBatchTree.Classify(dataset, miniBatchPredictions);
+  REQUIRE(arma::all(predictions == miniBatchPredictions));
+
+  // Too few labels.
+  REQUIRE_THROWS_AS(tree.TrainChunks(reader, labels.cols(0, 999)),
+      std::invalid_argument);
+
+  remove("hoeffding_chunks_test.csv");
+}
+
+/**
+ * Make sure that the compact splits track the same statistics as the regular
+ * splits.
+ */
+TEST_CASE("CompactHoeffdingSplitTest", "[HoeffdingTreeTest]")
+{
+  HoeffdingNumericSplit<GiniImpurity> numericSplit(3, 10, 100);
+  CompactHoeffdingNumericSplit<GiniImpurity> compactNumericSplit(3, 10, 100);
+  HoeffdingCategoricalSplit<GiniImpurity> categoricalSplit(50, 3);
+  CompactHoeffdingCategoricalSplit<GiniImpurity> compactCategoricalSplit(50,
+      3);
+
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const size_t label = RandInt(3);
+    const double value = Random() + label;
+    const size_t category = RandInt(10) + 5 * label;
+
+    numericSplit.Train(value, label);
+    compactNumericSplit.Train(value, label);
+    categoricalSplit.Train(category, label);
+    compactCategoricalSplit.Train(category, label);
+
+    REQUIRE(compactNumericSplit.MajorityClass() ==
+        numericSplit.MajorityClass());
+    REQUIRE(compactNumericSplit.MajorityProbability() ==
+        Approx(numericSplit.MajorityProbability()).epsilon(1e-7));
+    REQUIRE(compactCategoricalSplit.MajorityClass() ==
+        categoricalSplit.MajorityClass());
+    REQUIRE(compactCategoricalSplit.MajorityProbability() ==
+        Approx(categoricalSplit.MajorityProbability()).epsilon(1e-7));
+  }
+
+  // Only 20 of the 50 categories can have been seen.
+  REQUIRE(compactCategoricalSplit.NumSeenCategories() <= 20);
+
+  double bestFitness, secondBestFitness;
+  double compactBestFitness, compactSecondBestFitness;
+  numericSplit.EvaluateFitnessFunction(bestFitness, secondBestFitness);
+  compactNumericSplit.EvaluateFitnessFunction(compactBestFitness,
+      compactSecondBestFitness);
+  REQUIRE(bestFitness > 0.0);
+  REQUIRE(compactBestFitness == Approx(bestFitness).epsilon(1e-7));
+  REQUIRE(compactSecondBestFitness == 0.0);
+
+  categoricalSplit.EvaluateFitnessFunction(bestFitness, secondBestFitness);
+  compactCategoricalSplit.EvaluateFitnessFunction(compactBestFitness,
+      compactSecondBestFitness);
+  REQUIRE(bestFitness > 0.0);
+  REQUIRE(compactBestFitness == Approx(bestFitness).epsilon(1e-7));
+  REQUIRE(compactSecondBestFitness == 0.0);
+
+  arma::Col<size_t> childMajorities, compactChildMajorities;
+  NumericSplitInfo<double> numericSplitInfo, compactNumericSplitInfo;
+  numericSplit.Split(childMajorities, numericSplitInfo);
+  compactNumericSplit.Split(compactChildMajorities, compactNumericSplitInfo);
+  REQUIRE(arma::all(compactChildMajorities == childMajorities));
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const double value = 4.0 * Random() - 0.5;
+    REQUIRE(compactNumericSplitInfo.CalculateDirection(value) ==
+        numericSplitInfo.CalculateDirection(value));
+  }
+
+  CategoricalSplitInfo categoricalSplitInfo(1), compactCategoricalSplitInfo(1);
+  categoricalSplit.Split(childMajorities, categoricalSplitInfo);
+  compactCategoricalSplit.Split(compactChildMajorities,
+      compactCategoricalSplitInfo);
+  REQUIRE(compactChildMajorities.n_elem == 50);
+  REQUIRE(arma::all(compactChildMajorities == childMajorities));
+}
+
+/**
+ * Make sure that a Hoeffding tree built with the compact splits is the same as
+ * a tree built with the regular splits, and that it can be serialized.
+ */
+TEST_CASE("CompactHoeffdingTreeTest", "[HoeffdingTreeTest]")
+{
+  // Generate data.  The fourth dimension is categorical with many categories,
+  // and each class only takes a few of them.
+  arma::mat dataset(4, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(4);
+  for (size_t c = 0; c < 100; ++c)
+    info.MapString<double>(std::to_string(c), 3);
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = Random();
+    dataset(1, i) = Random();
+    dataset(2, i) = Random();
+    dataset(3, i) = RandInt(10);
+    labels[i] = 0;
+
+    dataset(0, i + 1) = Random();
+    dataset(1, i + 1) = Random() - 1.0;
+    dataset(2, i + 1) = Random() + 0.5;
+    dataset(3, i + 1) = RandInt(10) + 10;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = Random();
+    dataset(1, i + 2) = Random() + 1.0;
+    dataset(2, i + 2) = Random() + 0.8;
+    dataset(3, i + 2) = RandInt(15);
+    labels[i + 2] = 1;
+  }
+
+  typedef HoeffdingTree<GiniImpurity, CompactHoeffdingDoubleNumericSplit,
+      CompactHoeffdingCategoricalSplit> CompactTreeType;
+
+  HoeffdingTree<> tree(dataset, info, labels, 3, false);
+  CompactTreeType compactTree(dataset, info, labels, 3, false);
+
+  REQUIRE(tree.NumChildren() > 0);
+  REQUIRE(compactTree.NumDescendants() == tree.NumDescendants());
+
+  arma::Row<size_t> predictions, compactPredictions;
+  arma::rowvec probabilities, compactProbabilities;
+  tree.Classify(dataset, predictions, probabilities);
+  compactTree.Classify(dataset, compactPredictions, compactProbabilities);
+  REQUIRE(arma::all(compactPredictions == predictions));
+  REQUIRE(arma::approx_equal(compactProbabilities, probabilities, "absdiff",
+      1e-7));
+
+  CompactTreeType xmlTree, jsonTree, binaryTree;
+  SerializeObjectAll(compactTree, xmlTree, jsonTree, binaryTree);
+
+  arma::Row<size_t> xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlTree.Classify(dataset, xmlPredictions);
+  jsonTree.Classify(dataset, jsonPredictions);
+  binaryTree.Classify(dataset, binaryPredictions);
+  REQUIRE(arma::all(xmlPredictions == predictions));
+  REQUIRE(arma::all(jsonPredictions == predictions));
+  REQUIRE(arma::all(binaryPredictions == predictions));
+
+  // Training must continue the same way after serialization.
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    compactTree.Train(dataset.col(i), labels[i]);
+    binaryTree.Train(dataset.col(i), labels[i]);
+  }
+
+  REQUIRE(binaryTree.NumDescendants() == compactTree.NumDescendants());
+  compactTree.Classify(dataset, compactPredictions);
+  binaryTree.Classify(dataset, binaryPredictions);
+  REQUIRE(arma::all(binaryPredictions == compactPredictions));
+}
+
 //! Make sure parameter changes are propagated to children.
 TEST_CASE("ParameterChangeTest", "[HoeffdingTreeTest]")
 {
@@ -1835,3 +2103,113 @@ TEST_CASE("HoeffdingTreeCategoricalFloatDataTest", "[HoeffdingTreeTest]")
   REQUIRE(accu(batchPredictions == labels) > (labels.n_elem / 2));
   REQUIRE(accu(streamPredictions == labels) > (labels.n_elem / 2));
 }
+
+/**
+ * Make sure that the flattened copy of the given type of Hoeffding tree gives
+ * the same predictions and probabilities as the tree, on data with numeric and
+ * categorical features.
+ */
+template<typename TreeType>
+void CheckFlatHoeffdingTree()
+{
+  arma::mat dataset(4, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(4); // All features are numeric, except the fourth.
+  info.MapString<double>("0", 3);
+  info.MapString<double>("1", 3);
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = Random();
+    dataset(1, i) = Random();
+    dataset(2, i) = Random();
+    dataset(3, i) = 0.0;
+    labels[i] = 0;
+
+    dataset(0, i + 1) = Random();
+    dataset(1, i + 1) = Random() - 1.0;
+    dataset(2, i + 1) = Random() + 0.5;
+    dataset(3, i + 1) = 1.0;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = Random();
+    dataset(1, i + 2) = Random() + 1.0;
+    dataset(2, i + 2) = Random() + 0.8;
+    dataset(3, i + 2) = (Random() < 0.5) ? 0.0 : 1.0;
+    labels[i + 2] = 1;
+  }
+
+  TreeType tree(info, 3, 0.9);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    tree.Train(dataset.col(i), labels[i]);
+
+  REQUIRE(tree.NumChildren() > 0);
+
+  FlatHoeffdingTree flatTree(tree);
+  REQUIRE(flatTree.NumNodes() == tree.NumDescendants() + 1);
+  REQUIRE(flatTree.NumLeaves() > 1);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::rowvec probabilities, flatProbabilities;
+  tree.Classify(dataset, predictions, probabilities);
+  flatTree.Classify(dataset, flatPredictions, flatProbabilities);
+
+  REQUIRE(arma::all(predictions == flatPredictions));
+  REQUIRE(arma::all(probabilities == flatProbabilities));
+
+  flatTree.Classify(dataset, flatPredictions);
+  REQUIRE(arma::all(predictions == flatPredictions));
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    size_t prediction;
+    double probability;
+    flatTree.Classify(dataset.col(i), prediction, probability);
+    REQUIRE(prediction == predictions[i]);
+    REQUIRE(probability == probabilities[i]);
+    REQUIRE(flatTree.Classify(dataset.col(i)) == tree.Classify(dataset.col(i)));
+  }
+}
+
+/**
+ * Make sure that a flattened Hoeffding tree gives the same predictions as the
+ * tree, with multiway and binary numeric splits.
+ */
+TEST_CASE("FlatHoeffdingTreeTest", "[HoeffdingTreeTest]")
+{
+  CheckFlatHoeffdingTree<HoeffdingTree<>>();
+  CheckFlatHoeffdingTree<HoeffdingTree<GiniImpurity, BinaryDoubleNumericSplit,
+      HoeffdingCategoricalSplit>>();
+}
+
+/**
+ * Make sure that a flattened Hoeffding tree can be serialized on its own, and
+ * that an empty flattened tree cannot be used.
+ */
+TEST_CASE("FlatHoeffdingTreeSerializationTest", "[HoeffdingTreeTest]")
+{
+  arma::mat dataset(2, 3000, arma::fill::randu);
+  arma::Row<size_t> labels = arma::conv_to<arma::Row<size_t>>::from(
+      dataset.row(0) > 0.5);
+
+  HoeffdingTree<> tree(dataset, labels, 2);
+  FlatHoeffdingTree flatTree(tree);
+
+  FlatHoeffdingTree xmlTree, jsonTree, binaryTree;
+  REQUIRE_THROWS_AS(xmlTree.Classify(dataset.col(0)), std::invalid_argument);
+
+  SerializeObjectAll(flatTree, xmlTree, jsonTree, binaryTree);
+
+  REQUIRE(xmlTree.NumNodes() == flatTree.NumNodes());
+  REQUIRE(jsonTree.NumSplitPoints() == flatTree.NumSplitPoints());
+
+  arma::Row<size_t> predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions;
+  flatTree.Classify(dataset, predictions);
+  xmlTree.Classify(dataset, xmlPredictions);
+  jsonTree.Classify(dataset, jsonPredictions);
+  binaryTree.Classify(dataset, binaryPredictions);
+
+  REQUIRE(arma::all(predictions == xmlPredictions));
+  REQUIRE(arma::all(predictions == jsonPredictions));
+  REQUIRE(arma::all(predictions == binaryPredictions));
+}
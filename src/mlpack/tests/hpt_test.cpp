@@ -315,6 +315,89 @@ TEST_CASE("HPTTest", "[HPTTest]")
   REQUIRE(expectedObjective == Approx(objective).epsilon(1e-7));
 }
 
+/**
+ * Test CVFunction::EvaluatePoints() gives the same objectives as Evaluate().
+ */
+TEST_CASE("CVFunctionEvaluatePointsTest", "[HPTTest]")
+{
+  arma::mat xs = arma::randn(5, 100);
+  arma::vec beta = arma::randn(5, 1);
+  arma::rowvec ys = beta.t() * xs + 0.1 * arma::randn(1, 100);
+
+  KFoldCV<LARS<>, MSE> cv(4, xs, ys);
+
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 2);
+  FixedArg<bool, 0> fixedTransposeData{true};
+  FixedArg<bool, 1> fixedUseCholesky{false};
+  CVFunction<decltype(cv), LARS<>, 4, FixedArg<bool, 0>, FixedArg<bool, 1>>
+      cvFun(cv, datasetInfo, 0.0, 0.0, fixedTransposeData, fixedUseCholesky);
+
+  std::vector<arma::mat> points;
+  arma::vec expected;
+  for (double lambda1 : { 0.0, 0.01, 0.1, 1.0 })
+  {
+    for (double lambda2 : { 0.0, 0.5 })
+    {
+      points.push_back(arma::mat({ lambda1, lambda2 }).t());
+      expected.resize(expected.n_elem + 1);
+      expected[expected.n_elem - 1] = cv.Evaluate(true, false, lambda1,
+          lambda2);
+    }
+  }
+  // Duplicates are evaluated only once.
+  points.push_back(points[0]);
+  expected.resize(expected.n_elem + 1);
+  expected[expected.n_elem - 1] = expected[0];
+
+  const arma::vec objectives = cvFun.EvaluatePoints(points);
+  REQUIRE(objectives.n_elem == points.size());
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    REQUIRE(objectives[i] == Approx(expected[i]).epsilon(1e-7));
+    REQUIRE(cvFun.Evaluate(points[i]) == Approx(expected[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Test HyperParameterTuner finds the same hyper-parameters when the
+ * combinations of values are cross-validated in parallel.
+ */
+TEST_CASE("HPTParallelTest", "[HPTTest]")
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2, expectedObjective;
+  FindLARSBestLambdas(xs, ys, validationSize, transposeData, useCholesky,
+      lambda1Set, lambda2Set, expectedLambda1, expectedLambda2,
+      expectedObjective);
+
+  double actualLambda1, actualLambda2;
+  HyperParameterTuner<LARS<>, MSE, SimpleCV, GridSearch>
+      hpt(validationSize, xs, ys);
+  hpt.Parallel() = true;
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  REQUIRE(expectedObjective == Approx(hpt.BestObjective()).epsilon(1e-7));
+  REQUIRE(expectedLambda1 == Approx(actualLambda1).epsilon(1e-7));
+  REQUIRE(expectedLambda2 == Approx(actualLambda2).epsilon(1e-7));
+
+  size_t validationFirstColumn = round(xs.n_cols * (1.0 - validationSize));
+  arma::mat validationXs = xs.cols(validationFirstColumn, xs.n_cols - 1);
+  arma::rowvec validationYs = ys.cols(validationFirstColumn, ys.n_cols - 1);
+  double objective = MSE::Evaluate(hpt.BestModel(), validationXs, validationYs);
+  REQUIRE(expectedObjective == Approx(objective).epsilon(1e-7));
+}
+
 /**
  * Test HyperParamterTuner maximizes Accuracy rather than minimizes it.
  */
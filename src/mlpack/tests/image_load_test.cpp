@@ -128,6 +128,100 @@ TEST_CASE("SaveImageMatAPITest", "[ImageLoadTest]")
   remove("APITest.bmp");
 }
 
+/**
+ * Make sure that many images loaded at once are the same as the images loaded
+ * one at a time, and that images of different sizes cannot be loaded
+ * together.
+ */
+TEST_CASE("LoadManyImagesTest", "[ImageLoadTest]")
+{
+  data::ImageInfo info(5, 5, 3);
+  const size_t dimension = info.Width() * info.Height() * info.Channels();
+  const arma::mat images = ConvTo<arma::mat>::From(
+      arma::randi<arma::Mat<unsigned char>>(dimension, 20));
+
+  std::vector<std::string> files;
+  for (size_t i = 0; i < images.n_cols; ++i)
+  {
+    files.push_back("many_images_" + std::to_string(i) + ".bmp");
+    REQUIRE(Save(files.back(), arma::mat(images.col(i)), info, false) == true);
+  }
+
+  arma::mat output;
+  data::ImageInfo loadInfo;
+  REQUIRE(Load(files, output, loadInfo, false) == true);
+  REQUIRE(loadInfo.Width() == 5);
+  REQUIRE(loadInfo.Height() == 5);
+  REQUIRE(output.n_rows == dimension);
+  REQUIRE(output.n_cols == images.n_cols);
+  for (size_t i = 0; i < images.n_cols; ++i)
+  {
+    arma::mat image;
+    data::ImageInfo imageInfo;
+    REQUIRE(Load(files[i], image, imageInfo, false) == true);
+    CheckMatrices(arma::mat(output.col(i)), image);
+  }
+  CheckMatrices(output, images);
+
+  // An image of another size makes the whole load fail.
+  data::ImageInfo smallInfo(4, 4, 3);
+  REQUIRE(Save("many_images_small.bmp", arma::mat(48, 1, arma::fill::ones),
+      smallInfo, false) == true);
+  std::vector<std::string> mixedFiles = files;
+  mixedFiles[10] = "many_images_small.bmp";
+  REQUIRE(Load(mixedFiles, output, loadInfo, false) == false);
+  REQUIRE_THROWS_AS(Load(mixedFiles, output, loadInfo, true),
+      std::runtime_error);
+
+  for (size_t i = 0; i < files.size(); ++i)
+    remove(files[i].c_str());
+  remove("many_images_small.bmp");
+}
+
+/**
+ * Make sure that an ImageChunkLoader gives all the images in chunks, and that
+ * they can be read again after Reset().
+ */
+TEST_CASE("ImageChunkLoaderTest", "[ImageLoadTest]")
+{
+  data::ImageInfo info(5, 5, 3);
+  const size_t dimension = info.Width() * info.Height() * info.Channels();
+  const arma::mat images = ConvTo<arma::mat>::From(
+      arma::randi<arma::Mat<unsigned char>>(dimension, 20));
+
+  std::vector<std::string> files;
+  for (size_t i = 0; i < images.n_cols; ++i)
+  {
+    files.push_back("chunk_images_" + std::to_string(i) + ".bmp");
+    REQUIRE(Save(files.back(), arma::mat(images.col(i)), info, false) == true);
+  }
+
+  data::ImageChunkLoader loader(files, 6);
+  REQUIRE(loader.Dimensionality() == dimension);
+
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    loader.Reset();
+    arma::fmat chunk;
+    size_t read = 0;
+    while (loader.Next(chunk))
+    {
+      REQUIRE(chunk.n_rows == dimension);
+      REQUIRE(chunk.n_cols == std::min((size_t) 6, images.n_cols - read));
+      CheckMatrices(ConvTo<arma::mat>::From(chunk),
+          arma::mat(images.cols(read, read + chunk.n_cols - 1)));
+      read += chunk.n_cols;
+      REQUIRE(loader.PointsRead() == read);
+    }
+    REQUIRE(read == images.n_cols);
+  }
+
+  for (size_t i = 0; i < files.size(); ++i)
+    remove(files[i].c_str());
+
+  REQUIRE_THROWS_AS(data::ImageChunkLoader(files, 6), std::runtime_error);
+}
+
 /**
  * Serialization test for the ImageInfo class.
  */
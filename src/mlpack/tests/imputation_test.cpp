@@ -304,3 +304,63 @@ TEST_CASE("DatasetMapperPointerMapping", "[ImputationTest]")
   REQUIRE(dm.UnmapString(1, 0) == &b);
   REQUIRE(dm.UnmapString(2, 0) == &c);
 }
+
+/**
+ * Make sure that imputing several dimensions at once (in parallel) gives the
+ * same result as imputing them one at a time, and that the median of an even
+ * number of elements is the average of the two middle elements.
+ */
+TEST_CASE("ImputeDimensionsTest", "[ImputationTest]")
+{
+  arma::mat input(8, 201, arma::fill::randu);
+  for (size_t i = 0; i < input.n_elem; i += 7)
+    input[i] = std::numeric_limits<double>::quiet_NaN();
+
+  DatasetMapper<MissingPolicy> info(MissingPolicy({"a"}), input.n_rows);
+  std::vector<size_t> dimensions;
+  for (size_t d = 0; d < input.n_rows; ++d)
+  {
+    info.MapString<double>("a", d);
+    dimensions.push_back(d);
+  }
+
+  arma::mat meanInput(input), meanExpected(input);
+  Imputer<double, DatasetMapper<MissingPolicy>, MeanImputation<double>>
+      meanImputer(info);
+  meanImputer.Impute(meanInput, "a", dimensions);
+  for (size_t d = 0; d < input.n_rows; ++d)
+    meanImputer.Impute(meanExpected, "a", d);
+  CheckMatrices(meanInput, meanExpected);
+
+  arma::mat medianInput(input), medianExpected(input);
+  Imputer<double, DatasetMapper<MissingPolicy>, MedianImputation<double>>
+      medianImputer(info);
+  medianImputer.Impute(medianInput, "a", dimensions);
+  for (size_t d = 0; d < input.n_rows; ++d)
+    medianImputer.Impute(medianExpected, "a", d);
+  CheckMatrices(medianInput, medianExpected);
+  REQUIRE(!medianInput.has_nan());
+
+  // Compare with arma::median() of the elements that were not missing.
+  for (size_t d = 0; d < input.n_rows; ++d)
+  {
+    const arma::rowvec row = input.row(d);
+    const arma::vec good = row.elem(arma::find_finite(row));
+    const double median = arma::median(good);
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      if (std::isnan(input(d, i)))
+        REQUIRE(medianInput(d, i) == Approx(median).epsilon(1e-12));
+      else
+        REQUIRE(medianInput(d, i) == input(d, i));
+    }
+  }
+
+  // Row-major data: each dimension is a column.
+  arma::mat rowMajor("1.0 0.0; 4.0 5.0; 0.0 7.0; 3.0 9.0; 6.0 2.0");
+  MedianImputation<double> median;
+  median.Impute(rowMajor, 0.0, 0, false);
+  median.Impute(rowMajor, 0.0, 1, false);
+  REQUIRE(rowMajor(2, 0) == Approx(3.5).epsilon(1e-12));
+  REQUIRE(rowMajor(0, 1) == Approx(6.0).epsilon(1e-12));
+}
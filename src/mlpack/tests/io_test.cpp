@@ -26,6 +26,7 @@ using Option = mlpack::bindings::cli::CLIOption<T>;
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
 
 #include "catch.hpp"
 
@@ -52,6 +53,14 @@ void AddRequiredCLIOptions(const std::string& testName)
       "bool", false, true, false, testName);
   CLIOption<bool> version(false, "version", "Display the version of mlpack.",
       "V", "bool", false, true, false, testName);
+  CLIOption<string> traceFile("", "trace_file", "Save a trace of the timers.",
+      "", "string", false, true, false, testName);
+  CLIOption<bool> printMemory(false, "print_memory", "Print the memory.", "",
+      "bool", false, true, false, testName);
+  CLIOption<bool> serve(false, "serve", "Serve requests from stdin.", "",
+      "bool", false, true, false, testName);
+  CLIOption<string> serveSocket("", "serve_socket", "Serve requests from a "
+      "socket.", "", "string", false, true, false, testName);
 }
 
 /**
@@ -1252,3 +1261,71 @@ TEST_CASE("CppNameTest", "[IOTest]")
   REQUIRE(p.Parameters().at("help").cppType == "bool");
   REQUIRE(p.Parameters().at("double").cppType == "double");
 }
+
+/**
+ * The binding served in ServeStreamTest: multiply the matrix by the factor.
+ */
+static void ServeStreamTestBinding(util::Params& params, util::Timers& /* t */)
+{
+  params.Get<arma::mat>("output") = params.Get<int>("factor") *
+      params.Get<arma::mat>("matrix");
+}
+
+/**
+ * Make sure that requests are served one after another, and that a bad request
+ * gets an error but does not stop the others.
+ */
+TEST_CASE("ServeStreamTest", "[IOTest]")
+{
+  AddRequiredCLIOptions("ServeStreamTest");
+
+  #define BINDING_NAME ServeStreamTest
+  PARAM_MATRIX_IN("matrix", "Test matrix", "m");
+  PARAM_INT_IN("factor", "Test factor", "f", 1);
+  PARAM_MATRIX_OUT("output", "Test output", "o");
+  #undef BINDING_NAME
+
+  const char* argv[1];
+  argv[0] = "./test";
+  int argc = 1;
+
+  util::Params p = ParseCommandLine(argc, const_cast<char**>(argv),
+      "ServeStreamTest");
+  util::Timers t;
+
+  std::istringstream input("--matrix\n1,2\n3,4\n--factor 2\n\n"
+      "--matrix_file\n5,6\n\n"
+      "--unknown 1\n\n");
+  std::ostringstream output;
+  REQUIRE(ServeStream(p, t, &ServeStreamTestBinding, input, output) == 3);
+
+  // Split the responses, each of which ends with an empty line.
+  std::vector<std::string> responses;
+  std::string text = output.str();
+  size_t end;
+  while ((end = text.find("\n\n")) != std::string::npos)
+  {
+    responses.push_back(text.substr(0, end + 1));
+    text = text.substr(end + 2);
+  }
+  REQUIRE(responses.size() == 3);
+
+  // The first two responses hold the output matrix, one point per line.
+  const double factors[2] = { 2.0, 1.0 };
+  const arma::mat matrices[2] = { { { 1, 3 }, { 2, 4 } }, { { 5 }, { 6 } } };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    REQUIRE(responses[i].compare(0, 8, "output:\n") == 0);
+    arma::mat result;
+    std::istringstream stream(responses[i].substr(8));
+    REQUIRE(result.load(stream, arma::csv_ascii));
+    result = result.t();
+
+    REQUIRE(result.n_rows == matrices[i].n_rows);
+    REQUIRE(result.n_cols == matrices[i].n_cols);
+    for (size_t j = 0; j < result.n_elem; ++j)
+      REQUIRE(result[j] == Approx(factors[i] * matrices[i][j]));
+  }
+
+  REQUIRE(responses[2] == "error: unknown parameter 'unknown'\n");
+}
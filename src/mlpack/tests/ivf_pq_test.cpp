@@ -0,0 +1,161 @@
+/**
+ * @file tests/ivf_pq_test.cpp
+ *
+ * Unit tests for the 'IVFPQSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include "catch.hpp"
+#include "test_catch_tools.hpp"
+#include "serialization.hpp"
+
+#include <mlpack/methods/ivf_pq.hpp>
+#include <mlpack/methods/neighbor_search.hpp>
+
+using namespace std;
+using namespace mlpack;
+
+/**
+ * Make sure that the true nearest neighbor is almost always among the
+ * approximate neighbors when every list is scanned.
+ */
+TEST_CASE("IVFPQRecallTest", "[IVFPQTest]")
+{
+  arma::mat referenceData(8, 4000, arma::fill::randu);
+  arma::mat queryData(8, 200, arma::fill::randu);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 1, trueNeighbors, trueDistances);
+
+  IVFPQSearch<> ivfpq(referenceData, 16, 4, 256, 16);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivfpq.Search(queryData, 10, neighbors, distances);
+
+  REQUIRE(neighbors.n_rows == 10);
+  REQUIRE(neighbors.n_cols == 200);
+  REQUIRE(distances.n_rows == 10);
+  REQUIRE(distances.n_cols == 200);
+
+  size_t found = 0;
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    if (arma::any(neighbors.col(i) == trueNeighbors(0, i)))
+      ++found;
+
+    // The distances should be sorted.
+    for (size_t j = 1; j < neighbors.n_rows; ++j)
+      REQUIRE(distances(j, i) >= distances(j - 1, i));
+  }
+
+  REQUIRE(found >= 180);
+  REQUIRE(ivfpq.DistanceEvaluations() == 200 * 4000);
+}
+
+/**
+ * Make sure that the lists and codes have the expected layout.
+ */
+TEST_CASE("IVFPQLayoutTest", "[IVFPQTest]")
+{
+  arma::mat referenceData(6, 1000, arma::fill::randu);
+
+  IVFPQSearch<> ivfpq(referenceData, 10, 3, 16);
+
+  REQUIRE(ivfpq.NumLists() == 10);
+  REQUIRE(ivfpq.NumSubspaces() == 3);
+  REQUIRE(ivfpq.CodebookSize() == 16);
+  REQUIRE(ivfpq.NumPoints() == 1000);
+  REQUIRE(ivfpq.Dimensionality() == 6);
+  REQUIRE(ivfpq.Codebooks().n_rows == 2);
+
+  const arma::Col<size_t>& offsets = ivfpq.ListOffsets();
+  REQUIRE(offsets.n_elem == 11);
+  REQUIRE(offsets[0] == 0);
+  REQUIRE(offsets[10] == 1000);
+
+  // Every point must be in exactly one list.
+  arma::Col<size_t> counts(1000, arma::fill::zeros);
+  for (size_t i = 0; i < ivfpq.ListIndices().n_elem; ++i)
+    counts[ivfpq.ListIndices()[i]]++;
+  REQUIRE(arma::all(counts == 1));
+
+  REQUIRE(ivfpq.Codes().n_rows == 3);
+  REQUIRE(ivfpq.Codes().n_cols == 1000);
+  REQUIRE(ivfpq.Codes().max() < 16);
+
+  // Scanning a single list returns only points of the closest lists.
+  ivfpq.NProbe() = 1;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivfpq.Search(referenceData.cols(0, 9), 3, neighbors, distances);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+    REQUIRE((neighbors[i] < 1000 || distances[i] == DBL_MAX));
+}
+
+/**
+ * Make sure that invalid parameters are reported.
+ */
+TEST_CASE("IVFPQInvalidParametersTest", "[IVFPQTest]")
+{
+  arma::mat referenceData(4, 100, arma::fill::randu);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  // The number of subspaces must divide the dimensionality.
+  REQUIRE_THROWS_AS(IVFPQSearch<>(referenceData, 4, 3, 16),
+      std::invalid_argument);
+  // Codebooks can have at most 256 codewords.
+  REQUIRE_THROWS_AS(IVFPQSearch<>(referenceData, 4, 2, 257),
+      std::invalid_argument);
+  // There can't be more lists than points.
+  REQUIRE_THROWS_AS(IVFPQSearch<>(referenceData, 101, 2, 16),
+      std::invalid_argument);
+
+  IVFPQSearch<> ivfpq(referenceData, 4, 2, 16);
+  arma::mat queryData(4, 5, arma::fill::randu);
+  arma::mat wrongDimQueryData(3, 5, arma::fill::randu);
+  REQUIRE_THROWS_AS(ivfpq.Search(queryData, 101, neighbors, distances),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(ivfpq.Search(wrongDimQueryData, 3, neighbors, distances),
+      std::invalid_argument);
+
+  // An untrained model can't be searched.
+  IVFPQSearch<> untrained;
+  REQUIRE_THROWS_AS(untrained.Search(queryData, 1, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that a serialized index gives the same results as the original.
+ */
+TEST_CASE("IVFPQSerializationTest", "[IVFPQTest]")
+{
+  arma::mat referenceData(4, 500, arma::fill::randu);
+  arma::mat queryData(4, 50, arma::fill::randu);
+
+  IVFPQSearch<> ivfpq(referenceData, 8, 2, 32, 3);
+
+  IVFPQSearch<> xmlIvfpq, jsonIvfpq, binaryIvfpq;
+  SerializeObjectAll(ivfpq, xmlIvfpq, jsonIvfpq, binaryIvfpq);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, jsonDistances, binaryDistances;
+  ivfpq.Search(queryData, 5, neighbors, distances);
+  xmlIvfpq.Search(queryData, 5, xmlNeighbors, xmlDistances);
+  jsonIvfpq.Search(queryData, 5, jsonNeighbors, jsonDistances);
+  binaryIvfpq.Search(queryData, 5, binaryNeighbors, binaryDistances);
+
+  REQUIRE(xmlIvfpq.NProbe() == 3);
+  REQUIRE(jsonIvfpq.NumLists() == 8);
+  REQUIRE(binaryIvfpq.NumPoints() == 500);
+  CheckMatrices(neighbors, xmlNeighbors);
+  CheckMatrices(neighbors, jsonNeighbors);
+  CheckMatrices(neighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, jsonDistances, binaryDistances);
+}
@@ -9,6 +9,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/kde.hpp>
+#include <mlpack/methods/kde/kde_model.hpp>
 
 #include "catch.hpp"
 #include "serialization.hpp"
@@ -521,6 +522,170 @@ TEST_CASE("DuplicatedQuerySampleKDETest", "[KDETest]")
   delete referenceTree;
 }
 
+/**
+ * Make sure that dual-tree evaluation with several threads gives the same
+ * results as brute force, both with and without a query set.
+ */
+TEST_CASE("ParallelDualTreeKDETest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(2, 2000);
+  arma::mat query = arma::randu(2, 500);
+  const double kernelBandwidth = 0.2;
+  const double relError = 0.05;
+
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+#endif
+
+  GaussianKernel kernel(kernelBandwidth);
+  arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  // Brute force monochromatic KDE, which skips each point itself.
+  arma::vec bfMonoEstimations(reference.n_cols, arma::fill::zeros);
+  EuclideanDistance metric;
+  for (size_t i = 0; i < reference.n_cols; ++i)
+  {
+    for (size_t j = 0; j < reference.n_cols; ++j)
+    {
+      if (i != j)
+      {
+        bfMonoEstimations(i) += kernel.Evaluate(metric.Evaluate(
+            reference.col(i), reference.col(j)));
+      }
+    }
+  }
+  bfMonoEstimations /= reference.n_cols;
+
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree> kde(
+      relError, 0.0, kernel, KDEMode::KDE_DUAL_TREE_MODE, metric);
+  kde.Train(reference);
+
+  arma::vec treeEstimations;
+  kde.Evaluate(query, treeEstimations);
+  REQUIRE(treeEstimations.n_elem == query.n_cols);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    REQUIRE(bfEstimations[i] == Approx(treeEstimations[i]).epsilon(relError));
+
+  kde.Evaluate(treeEstimations);
+  REQUIRE(treeEstimations.n_elem == reference.n_cols);
+  for (size_t i = 0; i < reference.n_cols; ++i)
+  {
+    REQUIRE(bfMonoEstimations[i] ==
+        Approx(treeEstimations[i]).epsilon(relError));
+  }
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+}
+
+/**
+ * Make sure that dual-tree evaluation with Monte Carlo estimations gives
+ * reasonable results with several threads, both with and without a query set.
+ */
+TEST_CASE("ParallelDualTreeMonteCarloKDETest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(2, 3000);
+  arma::mat query = arma::randu(2, 200);
+  const double kernelBandwidth = 0.4;
+  const double relError = 0.05;
+
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+#endif
+
+  GaussianKernel kernel(kernelBandwidth);
+  arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  EuclideanDistance metric;
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree> kde(relError, 0.0,
+      kernel, KDEMode::KDE_DUAL_TREE_MODE, metric, true, 0.95, 100, 3, 0.8);
+  kde.Train(reference);
+
+  // The Monte Carlo estimation has a random component so it can fail.
+  // Therefore we require a reasonable amount of results to be right.
+  arma::vec treeEstimations;
+  kde.Evaluate(query, treeEstimations);
+  size_t correctResults = 0;
+  for (size_t i = 0; i < query.n_cols; ++i)
+  {
+    if (std::abs((bfEstimations[i] - treeEstimations[i]) / bfEstimations[i]) <
+        relError)
+      ++correctResults;
+  }
+  REQUIRE(correctResults > 70);
+
+  // Every point gets an estimation in the monochromatic case too.
+  kde.Evaluate(treeEstimations);
+  REQUIRE(treeEstimations.n_elem == reference.n_cols);
+  REQUIRE(arma::all(treeEstimations > 0.0));
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+}
+
+/**
+ * Compute the base cases between some query points and a reference leaf with
+ * KDERules::LeafBaseCases() and with BaseCase(), and make sure that the
+ * densities are the same.
+ */
+template<typename MetricType>
+void CheckKDELeafBaseCases(const bool sameSet)
+{
+  typedef KDTree<MetricType, KDEStat, arma::mat> Tree;
+  typedef KDERules<MetricType, GaussianKernel, Tree> RuleType;
+
+  arma::mat reference = arma::randu(3, 50);
+  arma::mat query = sameSet ? arma::mat() : arma::mat(arma::randu(3, 30));
+
+  // The root of the tree is a leaf that holds every reference point.
+  Tree referenceTree(reference, 100);
+  const arma::mat& referenceSet = referenceTree.Dataset();
+  const arma::mat& querySet = sameSet ? referenceSet : query;
+
+  GaussianKernel kernel(0.3);
+  MetricType metric;
+  arma::vec leafDensities(querySet.n_cols, arma::fill::zeros);
+  arma::vec pairDensities(querySet.n_cols, arma::fill::zeros);
+  RuleType leafRules(referenceSet, querySet, leafDensities, 0.05, 0.0, 0.95,
+      100, 3, 0.8, metric, kernel, false, sameSet);
+  RuleType pairRules(referenceSet, querySet, pairDensities, 0.05, 0.0, 0.95,
+      100, 3, 0.8, metric, kernel, false, sameSet);
+
+  const std::vector<size_t> queries = { 0, 3, 7, 29 };
+  leafRules.LeafBaseCases(queries, referenceTree);
+  for (size_t i = 0; i < queries.size(); ++i)
+    for (size_t j = 0; j < referenceSet.n_cols; ++j)
+      pairRules.BaseCase(queries[i], j);
+
+  REQUIRE(leafRules.BaseCases() == pairRules.BaseCases());
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    REQUIRE(leafDensities[i] == Approx(pairDensities[i]).epsilon(1e-10));
+}
+
+/**
+ * Make sure that batched leaf base cases give the same densities as base cases
+ * computed one pair at a time, both when the kernel values are computed with
+ * a matrix multiplication (the Euclidean distance) and when they are not, and
+ * that the traversers see them through InstrumentedRules.
+ */
+TEST_CASE("KDELeafBaseCasesTest", "[KDETest]")
+{
+  CheckKDELeafBaseCases<EuclideanDistance>(false);
+  CheckKDELeafBaseCases<EuclideanDistance>(true);
+  CheckKDELeafBaseCases<ManhattanDistance>(false);
+  CheckKDELeafBaseCases<ManhattanDistance>(true);
+
+  typedef KDTree<EuclideanDistance, KDEStat, arma::mat> Tree;
+  REQUIRE(UseLeafBaseCases<InstrumentedRules<KDERules<EuclideanDistance,
+      GaussianKernel, Tree>>, Tree>::value);
+}
+
 /**
  * Test dual-tree breadth-first implementation results against brute force
  * results.
@@ -791,6 +956,67 @@ TEST_CASE("KDESerializationTest", "[KDETest]")
   }
 }
 
+/**
+ * Make sure that a single-precision KDEModel gives the same estimations as a
+ * double-precision one, and that it stays single-precision when serialized.
+ */
+TEST_CASE("KDEModelSinglePrecisionTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(3, 500);
+  arma::mat query = arma::randu(3, 100);
+  const double relError = 0.01;
+  util::Timers timers;
+
+  const KDEModel::TreeTypes treeTypes[] = { KDEModel::KD_TREE,
+      KDEModel::BALL_TREE, KDEModel::COVER_TREE, KDEModel::OCTREE,
+      KDEModel::R_TREE };
+  for (size_t t = 0; t < 5; ++t)
+  {
+    KDEModel model(0.5, relError, 0.0, KDEModel::GAUSSIAN_KERNEL,
+        treeTypes[t]);
+    KDEModel fModel(0.5, relError, 0.0, KDEModel::GAUSSIAN_KERNEL,
+        treeTypes[t], KDEDefaultParams::mode, KDEDefaultParams::mcProb,
+        KDEDefaultParams::initialSampleSize, KDEDefaultParams::mcEntryCoef,
+        KDEDefaultParams::mcBreakCoef, true);
+    REQUIRE(fModel.SinglePrecision() == true);
+
+    arma::mat referenceCopy(reference), fReferenceCopy(reference);
+    model.BuildModel(timers, std::move(referenceCopy));
+    fModel.BuildModel(timers, std::move(fReferenceCopy));
+
+    arma::vec estimations, fEstimations;
+    arma::mat queryCopy(query), fQueryCopy(query);
+    model.Evaluate(timers, std::move(queryCopy), estimations);
+    fModel.Evaluate(timers, std::move(fQueryCopy), fEstimations);
+
+    REQUIRE(fEstimations.n_elem == estimations.n_elem);
+    for (size_t i = 0; i < estimations.n_elem; ++i)
+    {
+      // Both estimations are within relError of the true value.
+      REQUIRE(fEstimations[i] ==
+          Approx(estimations[i]).epsilon(2 * relError + 1e-5));
+    }
+
+    KDEModel xmlModel, jsonModel, binaryModel;
+    SerializeObjectAll(fModel, xmlModel, jsonModel, binaryModel);
+
+    KDEModel* models[] = { &xmlModel, &jsonModel, &binaryModel };
+    for (size_t m = 0; m < 3; ++m)
+    {
+      REQUIRE(models[m]->SinglePrecision() == true);
+
+      arma::vec otherEstimations;
+      arma::mat otherQueryCopy(query);
+      models[m]->Evaluate(timers, std::move(otherQueryCopy),
+          otherEstimations);
+
+      REQUIRE(otherEstimations.n_elem == fEstimations.n_elem);
+      for (size_t i = 0; i < fEstimations.n_elem; ++i)
+        REQUIRE(otherEstimations[i] == Approx(fEstimations[i]).epsilon(1e-5));
+    }
+  }
+}
+
 /**
  * Test if the copy constructor and copy operator works properly.
  */
@@ -1229,3 +1455,110 @@ TEST_CASE("GaussianBreadthDualKDTreeMonteCarloKDE", "[KDETest]")
 
   REQUIRE(correctResults > 70);
 }
+
+/**
+ * Make sure that adding reference points to a trained model gives the same
+ * estimations as a model trained on all the points, with and without a sliding
+ * window, both for a tree that supports insertion and for one that does not.
+ */
+template<template<typename, typename, typename> class TreeType>
+void CheckAddReferences()
+{
+  arma::mat reference = arma::randu(2, 300);
+  arma::mat newReference = arma::randu(2, 150);
+  arma::mat query = arma::randu(2, 60);
+  const double relError = 0.05;
+  GaussianKernel kernel(0.15);
+
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, TreeType> kde(relError, 0.0,
+      kernel);
+  kde.Train(reference);
+  kde.AddReferences(newReference.cols(0, 99), 10);
+  kde.AddReferences(newReference.cols(100, 149), 10);
+  REQUIRE(kde.ReferenceTree()->Dataset().n_cols == 450);
+
+  arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+  arma::vec treeEstimations;
+  BruteForceKDE<GaussianKernel>(arma::join_rows(reference, newReference),
+      query, bfEstimations, kernel);
+  kde.Evaluate(query, treeEstimations);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    REQUIRE(bfEstimations[i] == Approx(treeEstimations[i]).epsilon(relError));
+
+  // The monochromatic estimations are in the order of insertion, and do not
+  // count each point itself.
+  arma::vec monoEstimations;
+  bfEstimations.zeros(450);
+  BruteForceKDE<GaussianKernel>(arma::join_rows(reference, newReference),
+      arma::join_rows(reference, newReference), bfEstimations, kernel);
+  bfEstimations -= kernel.Evaluate(0.0) / 450;
+  kde.Evaluate(monoEstimations);
+  for (size_t i = 0; i < 450; ++i)
+    REQUIRE(bfEstimations[i] == Approx(monoEstimations[i]).epsilon(relError));
+
+  // With a window of 200 points, only the last 50 points of the original
+  // reference set are kept.
+  kde.Train(reference);
+  kde.WindowSize() = 200;
+  kde.AddReferences(newReference, 10);
+  REQUIRE(kde.ReferenceTree()->Dataset().n_cols == 200);
+
+  bfEstimations.zeros(query.n_cols);
+  BruteForceKDE<GaussianKernel>(arma::join_rows(reference.tail_cols(50),
+      newReference), query, bfEstimations, kernel);
+  kde.Evaluate(query, treeEstimations);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    REQUIRE(bfEstimations[i] == Approx(treeEstimations[i]).epsilon(relError));
+
+  // A window smaller than the new points keeps only the last new points.
+  kde.WindowSize() = 100;
+  kde.AddReferences(newReference, 10);
+  bfEstimations.zeros(query.n_cols);
+  BruteForceKDE<GaussianKernel>(newReference.tail_cols(100), query,
+      bfEstimations, kernel);
+  kde.Evaluate(query, treeEstimations);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    REQUIRE(bfEstimations[i] == Approx(treeEstimations[i]).epsilon(relError));
+
+  // Points of the wrong dimensionality are rejected.
+  REQUIRE_THROWS_AS(kde.AddReferences(arma::randu(3, 10)),
+      std::invalid_argument);
+}
+
+TEST_CASE("KDEAddReferencesTest", "[KDETest]")
+{
+  CheckAddReferences<KDTree>();
+  CheckAddReferences<StandardCoverTree>();
+}
+
+/**
+ * Make sure that KDEModel::AddReferences() adds points to the model.
+ */
+TEST_CASE("KDEModelAddReferencesTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(2, 200);
+  arma::mat newReference = arma::randu(2, 100);
+  arma::mat query = arma::randu(2, 50);
+
+  util::Timers timers;
+  KDEModel model(0.2, 0.0, 0.0, KDEModel::GAUSSIAN_KERNEL, KDEModel::BALL_TREE);
+  arma::mat referenceCopy(reference);
+  model.BuildModel(timers, std::move(referenceCopy));
+  model.WindowSize() = 250;
+  arma::mat newReferenceCopy(newReference);
+  model.AddReferences(timers, std::move(newReferenceCopy));
+
+  KDEModel fullModel(0.2, 0.0, 0.0, KDEModel::GAUSSIAN_KERNEL,
+      KDEModel::BALL_TREE);
+  arma::mat fullReference = arma::join_rows(reference.tail_cols(150),
+      newReference);
+  fullModel.BuildModel(timers, std::move(fullReference));
+
+  arma::vec estimations, fullEstimations;
+  arma::mat queryCopy(query);
+  model.Evaluate(timers, std::move(queryCopy), estimations);
+  fullModel.Evaluate(timers, std::move(query), fullEstimations);
+  REQUIRE(estimations.n_elem == fullEstimations.n_elem);
+  for (size_t i = 0; i < estimations.n_elem; ++i)
+    REQUIRE(estimations[i] == Approx(fullEstimations[i]).epsilon(1e-5));
+}
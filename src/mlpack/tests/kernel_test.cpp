@@ -200,6 +200,60 @@ TEST_CASE("MDFullCovarianceTest", "[KernelTest]")
   REQUIRE(md.Evaluate(b, a) == Approx(15.7).epsilon(1e-7));
 }
 
+/**
+ * Make sure that the factorized Mahalanobis distance, and the Euclidean
+ * distance between the stretched points, give the same distances, for positive
+ * definite and semidefinite covariance matrices.
+ */
+TEST_CASE("MDFactorizeTest", "[KernelTest]")
+{
+  arma::mat a(4, 20, arma::fill::randu);
+  arma::mat b(4, 10, arma::fill::randu);
+
+  arma::mat l(4, 4, arma::fill::randu);
+  arma::mat lowRank(4, 2, arma::fill::randu);
+  const arma::mat covariances[2] = { l * l.t() + 0.1 * arma::eye(4, 4),
+      lowRank * lowRank.t() };
+  for (size_t c = 0; c < 2; ++c)
+  {
+    MahalanobisDistance<true> md(covariances[c]);
+    arma::mat expected(a.n_cols, b.n_cols);
+    for (size_t i = 0; i < a.n_cols; ++i)
+      for (size_t j = 0; j < b.n_cols; ++j)
+        expected(i, j) = md.Evaluate(a.col(i), b.col(j));
+
+    REQUIRE(!md.Factorized());
+    md.Factorize();
+    REQUIRE(md.Factorized());
+    // The Cholesky factor is only found for the positive definite matrix.
+    if (c == 0)
+      REQUIRE(arma::norm(md.Factor() - arma::trimatu(md.Factor())) == 0.0);
+
+    arma::mat batch;
+    md.Evaluate(a, b, batch);
+    const arma::mat aStretched = md.Transform(a);
+    const arma::mat bStretched = md.Transform(b);
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      for (size_t j = 0; j < b.n_cols; ++j)
+      {
+        REQUIRE(md.Evaluate(a.col(i), b.col(j)) ==
+            Approx(expected(i, j)).epsilon(1e-7).margin(1e-6));
+        REQUIRE(batch(i, j) ==
+            Approx(expected(i, j)).epsilon(1e-7).margin(1e-5));
+        REQUIRE(EuclideanDistance::Evaluate(aStretched.col(i),
+            bStretched.col(j)) ==
+            Approx(expected(i, j)).epsilon(1e-7).margin(1e-6));
+      }
+    }
+  }
+
+  // A covariance matrix with a negative eigenvalue cannot be factorized.
+  MahalanobisDistance<false> md(arma::mat("1.0 0.0; 0.0 -1.0"));
+  REQUIRE_THROWS_AS(md.Factorize(), std::invalid_argument);
+  REQUIRE(!md.Factorized());
+}
+
 /**
  * Simple test case for the cosine distance.
  */
@@ -602,3 +656,176 @@ TEST_CASE("CauchyKernelTest", "[KernelTest]")
   REQUIRE(ck.Evaluate(a, b) == Approx(0.92592588).epsilon(1e-7));
   REQUIRE(ck.Evaluate(b, a) == Approx(0.92592588).epsilon(1e-7));
 }
+
+/**
+ * Make sure that the batch Evaluate() of the L-metrics gives the same distances
+ * as evaluating each pair of points.
+ */
+TEST_CASE("LMetricBatchEvaluateTest", "[KernelTest]")
+{
+  arma::mat a(6, 30, arma::fill::randn);
+  arma::mat b(6, 20, arma::fill::randn);
+  // Include identical points, whose distance must be exactly 0 or positive.
+  b.col(3) = a.col(5);
+
+  arma::mat squared, euclidean, manhattan;
+  SquaredEuclideanDistance::Evaluate(a, b, squared);
+  EuclideanDistance::Evaluate(a, b, euclidean);
+  ManhattanDistance::Evaluate(a, b, manhattan);
+
+  REQUIRE(squared.n_rows == 30);
+  REQUIRE(squared.n_cols == 20);
+  REQUIRE(squared.min() >= 0.0);
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      REQUIRE(squared(i, j) == Approx(SquaredEuclideanDistance::Evaluate(
+          a.col(i), b.col(j))).margin(1e-10));
+      REQUIRE(euclidean(i, j) == Approx(EuclideanDistance::Evaluate(
+          a.col(i), b.col(j))).margin(1e-5));
+      REQUIRE(manhattan(i, j) == Approx(ManhattanDistance::Evaluate(
+          a.col(i), b.col(j))).epsilon(1e-10));
+    }
+  }
+
+  arma::mat c(5, 3);
+  REQUIRE_THROWS_AS(EuclideanDistance::Evaluate(a, c, euclidean),
+      std::invalid_argument);
+}
+
+/**
+ * A kernel without a batch Evaluate(), to test the pairwise path of
+ * KernelMatrix().
+ */
+class PairwiseCauchyKernel
+{
+ public:
+  PairwiseCauchyKernel(const double bandwidth) : kernel(bandwidth) { }
+
+  template<typename VecTypeA, typename VecTypeB>
+  double Evaluate(const VecTypeA& a, const VecTypeB& b) const
+  {
+    return kernel.Evaluate(a, b);
+  }
+
+ private:
+  CauchyKernel kernel;
+};
+
+/**
+ * Check that the batch Evaluate() of a kernel matches its pairwise
+ * Evaluate().
+ */
+template<typename KernelType>
+void CheckBatchEvaluate(const KernelType& kernel,
+                        const arma::mat& a,
+                        const arma::mat& b)
+{
+  arma::mat output;
+  kernel.Evaluate(a, b, output);
+
+  REQUIRE(output.n_rows == a.n_cols);
+  REQUIRE(output.n_cols == b.n_cols);
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      REQUIRE(output(i, j) == Approx(kernel.Evaluate(a.col(i), b.col(j)))
+          .epsilon(1e-7).margin(1e-6));
+    }
+  }
+}
+
+/**
+ * Make sure that the batch Evaluate() of each kernel that has one gives the
+ * same values as the pairwise Evaluate(), and that it is detected.
+ */
+TEST_CASE("KernelBatchEvaluateTest", "[KernelTest]")
+{
+  arma::mat a(4, 25, arma::fill::randu);
+  arma::mat b(4, 15, arma::fill::randu);
+  b.col(0) = a.col(0);
+
+  CheckBatchEvaluate(GaussianKernel(0.7), a, b);
+  CheckBatchEvaluate(LinearKernel(), a, b);
+  CheckBatchEvaluate(PolynomialKernel(3.0, 1.5), a, b);
+  CheckBatchEvaluate(LaplacianKernel(1.3), a, b);
+  CheckBatchEvaluate(EpanechnikovKernel(0.8), a, b);
+  CheckBatchEvaluate(CauchyKernel(0.6), a, b);
+  CheckBatchEvaluate(HyperbolicTangentKernel(0.4, -0.3), a, b);
+  CheckBatchEvaluate(TriangularKernel(1.1), a, b);
+  CheckBatchEvaluate(SphericalKernel(0.9), a, b);
+  CheckBatchEvaluate(CosineDistance(), a, b);
+
+  // The cosine distance to a point with zero norm is 0.
+  arma::mat c(a);
+  c.col(1).zeros();
+  CheckBatchEvaluate(CosineDistance(), c, b);
+
+  REQUIRE(HasBatchEvaluate<GaussianKernel>::value);
+  REQUIRE(HasBatchEvaluate<LinearKernel>::value);
+  REQUIRE(HasBatchEvaluate<PolynomialKernel>::value);
+  REQUIRE(HasBatchEvaluate<LaplacianKernel>::value);
+  REQUIRE(HasBatchEvaluate<EpanechnikovKernel>::value);
+  REQUIRE(HasBatchEvaluate<CauchyKernel>::value);
+  REQUIRE(HasBatchEvaluate<HyperbolicTangentKernel>::value);
+  REQUIRE(HasBatchEvaluate<TriangularKernel>::value);
+  REQUIRE(HasBatchEvaluate<SphericalKernel>::value);
+  REQUIRE(HasBatchEvaluate<CosineDistance>::value);
+  REQUIRE(!HasBatchEvaluate<PairwiseCauchyKernel>::value);
+}
+
+/**
+ * Make sure that the tiled kernel matrices are correct, with and without a
+ * batch Evaluate(), and for tiles that do not divide the number of points.
+ */
+TEST_CASE("KernelMatrixTest", "[KernelTest]")
+{
+  arma::mat a(3, 53, arma::fill::randu);
+  arma::mat b(3, 31, arma::fill::randu);
+
+  GaussianKernel gk(0.5);
+  PairwiseCauchyKernel ck(2.0);
+
+  for (const size_t tileSize : { 1, 7, 16, 1000 })
+  {
+    arma::mat gkMatrix, ckMatrix, gkSymmetric, ckSymmetric;
+    KernelMatrix(gk, a, b, gkMatrix, tileSize);
+    KernelMatrix(ck, a, b, ckMatrix, tileSize);
+    SymmetricKernelMatrix(gk, a, gkSymmetric, tileSize);
+    SymmetricKernelMatrix(ck, a, ckSymmetric, tileSize);
+
+    REQUIRE(gkMatrix.n_rows == 53);
+    REQUIRE(gkMatrix.n_cols == 31);
+    REQUIRE(ckMatrix.n_rows == 53);
+    REQUIRE(ckMatrix.n_cols == 31);
+    REQUIRE(gkSymmetric.n_rows == 53);
+    REQUIRE(gkSymmetric.n_cols == 53);
+    REQUIRE(ckSymmetric.n_rows == 53);
+    REQUIRE(ckSymmetric.n_cols == 53);
+
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      for (size_t j = 0; j < b.n_cols; ++j)
+      {
+        REQUIRE(gkMatrix(i, j) == Approx(gk.Evaluate(a.col(i), b.col(j)))
+            .epsilon(1e-7).margin(1e-10));
+        REQUIRE(ckMatrix(i, j) == Approx(ck.Evaluate(a.col(i), b.col(j)))
+            .epsilon(1e-10));
+      }
+
+      for (size_t j = 0; j < a.n_cols; ++j)
+      {
+        REQUIRE(gkSymmetric(i, j) == Approx(gk.Evaluate(a.col(i), a.col(j)))
+            .epsilon(1e-7).margin(1e-10));
+        REQUIRE(ckSymmetric(i, j) == Approx(ck.Evaluate(a.col(i), a.col(j)))
+            .epsilon(1e-10));
+        REQUIRE(gkSymmetric(i, j) == gkSymmetric(j, i));
+      }
+    }
+  }
+
+  arma::mat output;
+  REQUIRE_THROWS_AS(KernelMatrix(gk, a, b, output, 0), std::invalid_argument);
+}
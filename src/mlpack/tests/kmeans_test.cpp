@@ -536,6 +536,212 @@ TEST_CASE("KMeansPlusPlusTest", "[KMeansTest]")
   REQUIRE(distortion < 14500.0);
 }
 
+/**
+ * Make sure that the k-means|| initialization gives initial centroids about as
+ * good as k-means++ on the same dataset, and works inside of KMeans.
+ */
+TEST_CASE("KMeansParallelTest", "[KMeansTest]")
+{
+  arma::mat data(3, 3000);
+  data.randn();
+
+  arma::mat centroids(" 0  5 -2 -6  1;"
+                      " 0  0 -2  8  6;"
+                      " 0 -2 -2  8  1");
+
+  for (size_t i = 1000; i < 1200; ++i)
+    data.col(i) += centroids.col(1);
+  for (size_t i = 1200; i < 1700; ++i)
+    data.col(i) += centroids.col(2);
+  for (size_t i = 1700; i < 1800; ++i)
+    data.col(i) += centroids.col(3);
+  for (size_t i = 1800; i < 3000; ++i)
+    data.col(i) += centroids.col(4);
+
+  KMeansParallelInitialization k;
+  REQUIRE(k.Oversampling() == 2.0);
+  REQUIRE(k.Rounds() == 5);
+  arma::mat resultingCentroids;
+  k.Cluster(data, 5, resultingCentroids);
+  REQUIRE(resultingCentroids.n_rows == 3);
+  REQUIRE(resultingCentroids.n_cols == 5);
+
+  double distortion = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    double bestDist = DBL_MAX;
+    for (size_t j = 0; j < 5; ++j)
+    {
+      bestDist = std::min(bestDist, EuclideanDistance::Evaluate(data.col(i),
+          resultingCentroids.col(j)));
+    }
+    distortion += bestDist;
+  }
+
+  // This is the same bound as for k-means++ above.
+  REQUIRE(distortion < 14500.0);
+
+  // The same seed should give the same centroids.
+  RandomSeed(15);
+  arma::mat centroids1, centroids2;
+  k.Cluster(data, 5, centroids1);
+  RandomSeed(15);
+  k.Cluster(data, 5, centroids2);
+  REQUIRE(arma::approx_equal(centroids1, centroids2, "absdiff", 1e-12));
+
+  // Run the whole k-means with it.
+  KMeans<EuclideanDistance, KMeansParallelInitialization> km;
+  arma::Row<size_t> assignments;
+  arma::mat finalCentroids;
+  km.Cluster(data, 5, assignments, finalCentroids);
+  REQUIRE(finalCentroids.n_cols == 5);
+  REQUIRE(assignments.n_elem == data.n_cols);
+  REQUIRE(arma::max(assignments) < 5);
+}
+
+/**
+ * If there are fewer candidates than clusters, k-means|| should still return
+ * the right number of centroids.
+ */
+TEST_CASE("KMeansParallelFewPointsTest", "[KMeansTest]")
+{
+  arma::mat data(2, 30);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    data.col(i).fill((double) (i % 3));
+
+  KMeansParallelInitialization k(1.0, 2);
+  arma::mat centroids;
+  k.Cluster(data, 5, centroids);
+
+  REQUIRE(centroids.n_rows == 2);
+  REQUIRE(centroids.n_cols == 5);
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    REQUIRE(centroids(0, i) == centroids(1, i));
+    REQUIRE((centroids(0, i) == 0.0 || centroids(0, i) == 1.0 ||
+        centroids(0, i) == 2.0));
+  }
+}
+
+/**
+ * Run DistributedKMeans with the given Lloyd step type on three shards of the
+ * dataset in three threads, and return the centroids of each shard and the
+ * assignments of all points.
+ */
+template<template<class, class> class LloydStepType>
+void ShardedKMeans(const arma::mat& data,
+                   const size_t clusters,
+                   const arma::mat& initialCentroids,
+                   std::vector<arma::mat>& centroids,
+                   arma::Row<size_t>& assignments)
+{
+  const size_t bounds[4] = { 0, 300, 750, data.n_cols };
+  ThreadAllReduce::State state(3);
+  std::vector<arma::Row<size_t>> shardAssignments(3);
+  centroids.assign(3, initialCentroids);
+
+  std::vector<std::thread> threads;
+  for (size_t p = 0; p < 3; ++p)
+  {
+    threads.push_back(std::thread([&, p]()
+    {
+      const arma::mat shard = data.cols(bounds[p], bounds[p + 1] - 1);
+      DistributedKMeans<ThreadAllReduce, EuclideanDistance, LloydStepType> km(
+          1000, ThreadAllReduce(state, p));
+      km.Cluster(shard, clusters, shardAssignments[p], centroids[p],
+          !initialCentroids.is_empty());
+    }));
+  }
+  for (size_t p = 0; p < 3; ++p)
+    threads[p].join();
+
+  assignments = arma::join_rows(arma::join_rows(shardAssignments[0],
+      shardAssignments[1]), shardAssignments[2]);
+}
+
+/**
+ * Make sure that DistributedKMeans on shards of a dataset gives the same
+ * clusters as KMeans on the whole dataset, with the naive and Elkan steps.
+ */
+TEST_CASE("DistributedKMeansTest", "[KMeansTest]")
+{
+  arma::mat dataset(10, 1000, arma::fill::randu);
+  const size_t k = 8;
+  arma::mat initialCentroids(10, k, arma::fill::randu);
+
+  arma::mat centroids(initialCentroids);
+  KMeans<EuclideanDistance, SampleInitialization, AllowEmptyClusters> km;
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, k, assignments, centroids, false, true);
+
+  std::vector<arma::mat> naiveCentroids, elkanCentroids;
+  arma::Row<size_t> naiveAssignments, elkanAssignments;
+  ShardedKMeans<NaiveKMeans>(dataset, k, initialCentroids, naiveCentroids,
+      naiveAssignments);
+  ShardedKMeans<ElkanKMeans>(dataset, k, initialCentroids, elkanCentroids,
+      elkanAssignments);
+
+  for (size_t p = 0; p < 3; ++p)
+  {
+    REQUIRE(arma::approx_equal(naiveCentroids[p], centroids, "absdiff", 1e-7));
+    REQUIRE(arma::approx_equal(elkanCentroids[p], centroids, "absdiff", 1e-7));
+  }
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(naiveAssignments[i] == assignments[i]);
+    REQUIRE(elkanAssignments[i] == assignments[i]);
+  }
+}
+
+/**
+ * Make sure that the distributed k-means|| initialization gives the same good
+ * centroids on every shard.
+ */
+TEST_CASE("DistributedKMeansParallelTest", "[KMeansTest]")
+{
+  arma::mat data(3, 3000);
+  data.randn();
+
+  arma::mat centroids(" 0  5 -2 -6  1;"
+                      " 0  0 -2  8  6;"
+                      " 0 -2 -2  8  1");
+
+  for (size_t i = 1000; i < 1200; ++i)
+    data.col(i) += centroids.col(1);
+  for (size_t i = 1200; i < 1700; ++i)
+    data.col(i) += centroids.col(2);
+  for (size_t i = 1700; i < 1800; ++i)
+    data.col(i) += centroids.col(3);
+  for (size_t i = 1800; i < 3000; ++i)
+    data.col(i) += centroids.col(4);
+
+  std::vector<arma::mat> shardCentroids;
+  arma::Row<size_t> assignments;
+  ShardedKMeans<NaiveKMeans>(data, 5, arma::mat(), shardCentroids,
+      assignments);
+
+  REQUIRE(shardCentroids[0].n_rows == 3);
+  REQUIRE(shardCentroids[0].n_cols == 5);
+  REQUIRE(assignments.n_elem == data.n_cols);
+  REQUIRE(arma::max(assignments) < 5);
+  for (size_t p = 1; p < 3; ++p)
+  {
+    REQUIRE(arma::approx_equal(shardCentroids[p], shardCentroids[0],
+        "absdiff", 1e-12));
+  }
+
+  double distortion = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    distortion += EuclideanDistance::Evaluate(data.col(i),
+        shardCentroids[0].col(assignments[i]));
+  }
+
+  // This is the same bound as for k-means++ above.
+  REQUIRE(distortion < 14500.0);
+}
+
 #ifdef ARMA_HAS_SPMAT
 /**
  * Make sure sparse k-means works okay.
@@ -583,6 +789,87 @@ TEST_CASE("SparseKMeansTest", "[KMeansTest]")
 
 #endif // ARMA_HAS_SPMAT
 
+/**
+ * Make sure that the blocked assignment used by NaiveKMeans for the Euclidean
+ * distance gives the same result as evaluating the distance for every pair.
+ */
+TEST_CASE("NaiveKMeansBlockedTest", "[KMeansTest]")
+{
+  // Use a number of points that is not a multiple of the block size, and many
+  // clusters.
+  arma::mat dataset(10, 1000);
+  dataset.randu();
+  arma::mat centroids(10, 100);
+  centroids.randu();
+
+  arma::Row<size_t> assignments;
+  arma::rowvec distances;
+  const arma::rowvec centroidNorms = arma::sum(arma::square(centroids), 0);
+  BlockedAssignment(dataset, 300, 1000, centroids, centroidNorms, assignments,
+      distances);
+  REQUIRE(assignments.n_elem == 700);
+  REQUIRE(distances.n_elem == 700);
+
+  arma::mat expectedCentroids(10, 100, arma::fill::zeros);
+  arma::Col<size_t> expectedCounts(100, arma::fill::zeros);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    double minDistance = DBL_MAX;
+    size_t closest = 100;
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = SquaredEuclideanDistance::Evaluate(
+          dataset.col(i), centroids.col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closest = j;
+      }
+    }
+
+    if (i >= 300)
+    {
+      REQUIRE(assignments[i - 300] == closest);
+      REQUIRE(distances[i - 300] == Approx(minDistance).epsilon(1e-7));
+    }
+
+    expectedCentroids.col(closest) += dataset.col(i);
+    ++expectedCounts[closest];
+  }
+
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+    if (expectedCounts[j] > 0)
+      expectedCentroids.col(j) /= expectedCounts[j];
+
+  // Now check a full iteration with both metrics that use it.
+  EuclideanDistance ed;
+  NaiveKMeans<EuclideanDistance, arma::mat> naive(dataset, ed);
+  SquaredEuclideanDistance sed;
+  NaiveKMeans<SquaredEuclideanDistance, arma::mat> squaredNaive(dataset, sed);
+
+  arma::mat newCentroids, squaredNewCentroids;
+  arma::Col<size_t> counts, squaredCounts;
+  naive.Iterate(centroids, newCentroids, counts);
+  squaredNaive.Iterate(centroids, squaredNewCentroids, squaredCounts);
+
+  REQUIRE(naive.DistanceCalculations() == 100 * 1000 + 100);
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+  {
+    REQUIRE(counts[j] == expectedCounts[j]);
+    REQUIRE(squaredCounts[j] == expectedCounts[j]);
+    if (expectedCounts[j] == 0)
+      continue;
+
+    for (size_t d = 0; d < centroids.n_rows; ++d)
+    {
+      REQUIRE(newCentroids(d, j) ==
+          Approx(expectedCentroids(d, j)).epsilon(1e-7));
+      REQUIRE(squaredNewCentroids(d, j) ==
+          Approx(expectedCentroids(d, j)).epsilon(1e-7));
+    }
+  }
+}
+
 TEST_CASE("ElkanTest", "[KMeansTest]")
 {
   const size_t trials = 5;
@@ -617,6 +904,48 @@ TEST_CASE("ElkanTest", "[KMeansTest]")
   }
 }
 
+// An Elkan step type that only keeps lower bounds for 300 points of a dataset
+// with 5 clusters.
+template<typename MetricType, typename MatType>
+class CappedElkanKMeans : public ElkanKMeans<MetricType, MatType>
+{
+ public:
+  CappedElkanKMeans(const MatType& dataset, MetricType& metric) :
+      ElkanKMeans<MetricType, MatType>(dataset, metric,
+          300 * 5 * sizeof(float)) { }
+};
+
+/**
+ * Make sure that Elkan's algorithm gives the same clusters when only some of
+ * the points fit in the memory for lower bounds.
+ */
+TEST_CASE("ElkanBoundMemoryTest", "[KMeansTest]")
+{
+  arma::mat dataset(10, 1000);
+  dataset.randu();
+
+  const size_t k = 5;
+  arma::mat centroids(10, k);
+  centroids.randu();
+
+  arma::mat naiveCentroids(centroids);
+  KMeans<> km;
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      CappedElkanKMeans> elkan;
+  arma::Row<size_t> elkanAssignments;
+  arma::mat elkanCentroids(centroids);
+  elkan.Cluster(dataset, k, elkanAssignments, elkanCentroids, false, true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    REQUIRE(assignments[i] == elkanAssignments[i]);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    REQUIRE(naiveCentroids[i] == Approx(elkanCentroids[i]).epsilon(1e-7));
+}
+
 TEST_CASE("HamerlyTest", "[KMeansTest]")
 {
   const size_t trials = 5;
@@ -652,6 +981,86 @@ TEST_CASE("HamerlyTest", "[KMeansTest]")
   }
 }
 
+TEST_CASE("YinyangTest", "[KMeansTest]")
+{
+  const size_t trials = 5;
+
+  for (size_t t = 0; t < trials; ++t)
+  {
+    arma::mat dataset(10, 1000);
+    dataset.randu();
+
+    // Use enough clusters that there is more than one group of centroids.
+    const size_t k = 10 * (t + 1);
+    arma::mat centroids(10, k);
+    centroids.randu();
+
+    // Make sure the Yinyang algorithm and the naive method return the same
+    // clusters.
+    arma::mat naiveCentroids(centroids);
+    KMeans<> km;
+    arma::Row<size_t> assignments;
+    km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+    KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        YinyangKMeans> yinyang;
+    arma::Row<size_t> yinyangAssignments;
+    arma::mat yinyangCentroids(centroids);
+    yinyang.Cluster(dataset, k, yinyangAssignments, yinyangCentroids, false,
+        true);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      REQUIRE(assignments[i] == yinyangAssignments[i]);
+
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+      REQUIRE(naiveCentroids[i] == Approx(yinyangCentroids[i]).epsilon(1e-7));
+  }
+}
+
+// A Yinyang step type that puts every centroid in its own group, so that the
+// group filter and the local filter are both used for every centroid.
+template<typename MetricType, typename MatType>
+class UngroupedYinyangKMeans : public YinyangKMeans<MetricType, MatType>
+{
+ public:
+  UngroupedYinyangKMeans(const MatType& dataset, MetricType& metric) :
+      YinyangKMeans<MetricType, MatType>(dataset, metric, 1000) { }
+};
+
+/**
+ * Make sure that the Yinyang algorithm gives the same clusters as the naive
+ * method with one group per centroid, and with empty clusters.
+ */
+TEST_CASE("YinyangGroupsTest", "[KMeansTest]")
+{
+  arma::mat dataset(5, 800);
+  dataset.randu();
+
+  // Some centroids are far from the data, so that their clusters are empty.
+  const size_t k = 12;
+  arma::mat centroids(5, k);
+  centroids.randu();
+  centroids.cols(0, 1) += 10.0;
+
+  arma::mat naiveCentroids(centroids);
+  KMeans<EuclideanDistance, RandomPartition, AllowEmptyClusters> km;
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+  KMeans<EuclideanDistance, RandomPartition, AllowEmptyClusters,
+      UngroupedYinyangKMeans> yinyang;
+  arma::Row<size_t> yinyangAssignments;
+  arma::mat yinyangCentroids(centroids);
+  yinyang.Cluster(dataset, k, yinyangAssignments, yinyangCentroids, false,
+      true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    REQUIRE(assignments[i] == yinyangAssignments[i]);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    REQUIRE(naiveCentroids[i] == Approx(yinyangCentroids[i]).epsilon(1e-7));
+}
+
 TEST_CASE("PellegMooreTest", "[KMeansTest]")
 {
   const size_t trials = 5;
@@ -750,6 +1159,181 @@ TEST_CASE("DTNNCoverTreeTest", "[KMeansTest]")
   }
 }
 
+/**
+ * Make sure that the parallel dual-tree k-means iterations give the same
+ * result as naive k-means, for both tree types, on a dataset large enough to
+ * be split into many subtrees.
+ */
+TEST_CASE("DTNNParallelTest", "[KMeansTest]")
+{
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+#endif
+
+  arma::mat dataset(3, 5000);
+  dataset.randu();
+
+  const size_t k = 40;
+  arma::mat centroids(3, k);
+  centroids.randu();
+
+  arma::mat naiveCentroids(centroids);
+  KMeans<> km;
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      DefaultDualTreeKMeans> dtnn;
+  arma::Row<size_t> dtnnAssignments;
+  arma::mat dtnnCentroids(centroids);
+  dtnn.Cluster(dataset, k, dtnnAssignments, dtnnCentroids, false, true);
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      CoverTreeDualTreeKMeans> dtnnCover;
+  arma::Row<size_t> dtnnCoverAssignments;
+  arma::mat dtnnCoverCentroids(centroids);
+  dtnnCover.Cluster(dataset, k, dtnnCoverAssignments, dtnnCoverCentroids,
+      false, true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(assignments[i] == dtnnAssignments[i]);
+    REQUIRE(assignments[i] == dtnnCoverAssignments[i]);
+  }
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+  {
+    REQUIRE(naiveCentroids[i] == Approx(dtnnCentroids[i]).epsilon(1e-7));
+    REQUIRE(naiveCentroids[i] == Approx(dtnnCoverCentroids[i]).epsilon(1e-7));
+  }
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+}
+
+/**
+ * Make sure that mini-batch k-means finds well-separated clusters.
+ */
+TEST_CASE("MiniBatchKMeansTest", "[KMeansTest]")
+{
+  arma::mat means("0.0 10.0 -10.0; 0.0 10.0 5.0");
+  arma::mat dataset(2, 15000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) = means.col(i % 3) + 0.5 * arma::randn<arma::vec>(2);
+
+  arma::mat centroids = means + 0.5;
+  arma::Row<size_t> assignments;
+  KMeans<EuclideanDistance, SampleInitialization, AllowEmptyClusters,
+      MiniBatchKMeans> km(200);
+  km.Cluster(dataset, 3, assignments, centroids, false, true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    REQUIRE(assignments[i] == i % 3);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    REQUIRE(centroids[i] == Approx(means[i]).margin(0.1));
+}
+
+/**
+ * Make sure that batches given to MiniBatchKMeans::Update() make each centroid
+ * the mean of the points assigned to it.
+ */
+TEST_CASE("MiniBatchKMeansUpdateTest", "[KMeansTest]")
+{
+  arma::mat dataset(3, 1000, arma::fill::randu);
+  dataset.cols(500, 999) += 10.0;
+
+  EuclideanDistance metric;
+  MiniBatchKMeans<EuclideanDistance, arma::mat> step(dataset, metric, 100);
+  REQUIRE(step.BatchSize() == 100);
+
+  arma::mat centroids("0.0 10.0; 0.0 10.0; 0.0 10.0");
+  // Stream the batches in an interleaved order.
+  for (size_t b = 0; b < 5; ++b)
+  {
+    step.Update(dataset.cols(100 * b, 100 * b + 99), centroids);
+    step.Update(dataset.cols(500 + 100 * b, 599 + 100 * b), centroids);
+  }
+
+  REQUIRE(step.ClusterCounts()[0] == 500);
+  REQUIRE(step.ClusterCounts()[1] == 500);
+  REQUIRE(step.DistanceCalculations() >= 2000);
+
+  const arma::vec mean0 = arma::mean(dataset.cols(0, 499), 1);
+  const arma::vec mean1 = arma::mean(dataset.cols(500, 999), 1);
+  for (size_t d = 0; d < 3; ++d)
+  {
+    REQUIRE(centroids(d, 0) == Approx(mean0[d]).epsilon(1e-10));
+    REQUIRE(centroids(d, 1) == Approx(mean1[d]).epsilon(1e-10));
+  }
+
+  // After a reset the counts start over.
+  step.Reset();
+  step.Update(dataset.cols(0, 9), centroids);
+  REQUIRE(step.ClusterCounts()[0] == 10);
+  REQUIRE(step.ClusterCounts()[1] == 0);
+}
+
+/**
+ * Make sure that streaming k-means over chunks of a file gives the same
+ * clustering as in-memory k-means with the same initial centroids.
+ */
+TEST_CASE("StreamingKMeansTest", "[KMeansTest]")
+{
+  arma::mat dataset(4, 1050);
+  dataset.randu();
+  for (size_t i = 0; i < dataset.n_cols; i += 3)
+    dataset.col(i) += 3.0;
+  REQUIRE(data::Save("streaming_kmeans_test.csv", dataset));
+
+  arma::mat centroids(4, 6);
+  centroids.randu();
+  centroids *= 4.0;
+
+  KMeans<EuclideanDistance, SampleInitialization, AllowEmptyClusters> km;
+  arma::Row<size_t> assignments;
+  arma::mat naiveCentroids(centroids);
+  km.Cluster(dataset, 6, assignments, naiveCentroids, false, true);
+
+  // Use a chunk size that does not divide the number of points.
+  data::ChunkedLoader loader("streaming_kmeans_test.csv", 100);
+  StreamingKMeans<> skm;
+  arma::mat streamingCentroids(centroids);
+  skm.Cluster(loader, 6, streamingCentroids, true);
+
+  // The sums are accumulated in a different order, so the two runs may stop
+  // one iteration apart, when the centroids move by less than 1e-5.
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+  {
+    REQUIRE(streamingCentroids[i] ==
+        Approx(naiveCentroids[i]).epsilon(1e-4));
+  }
+
+  REQUIRE(skm.Assign(loader, streamingCentroids,
+      "streaming_kmeans_assignments.csv") == dataset.n_cols);
+  arma::Row<size_t> streamingAssignments;
+  REQUIRE(data::Load("streaming_kmeans_assignments.csv",
+      streamingAssignments));
+  REQUIRE(streamingAssignments.n_elem == dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    REQUIRE(streamingAssignments[i] == assignments[i]);
+
+  // Without an initial guess, the centroids are chosen from the first chunk.
+  arma::mat initialCentroids;
+  skm.Cluster(loader, 6, initialCentroids);
+  REQUIRE(initialCentroids.n_rows == 4);
+  REQUIRE(initialCentroids.n_cols == 6);
+
+  // There are not enough points in the first chunk for that many clusters.
+  REQUIRE_THROWS_AS(skm.Cluster(loader, 101, initialCentroids),
+      std::invalid_argument);
+
+  remove("streaming_kmeans_test.csv");
+  remove("streaming_kmeans_assignments.csv");
+}
+
 /**
  * Make sure that the sample initialization strategy successfully samples points
  * from the dataset.
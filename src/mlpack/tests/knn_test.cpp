@@ -11,23 +11,18 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/neighbor_search.hpp>
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/neighbor_search/ns_query_server.hpp>
+#include <mlpack/methods/neighbor_search/sharded_neighbor_search.hpp>
+
+#include <thread>
+
+#include "serialization.hpp"
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
+#include "thread_all_reduce.hpp"
 
 using namespace mlpack;
 
-/**
- * A couple of handful declarations for float32 testing.
- * These will be removed when we refactor the Bounds to accept MatType.
- * For now, we will keep the following declarations.
- */
-template<typename MetricType>
-using FloatHRectBound = HRectBound<MetricType, float>;
-
-template<typename MetricType, typename StatisticType, typename MatType>
-using FloatKDTree = BinarySpaceTree<MetricType, StatisticType, MatType,
-                                    FloatHRectBound, MidpointSplit>;
-
 /**
  * Test that Unmap() works in the dual-tree case (see unmap.hpp).
  */
@@ -274,6 +269,47 @@ TEST_CASE("KNNTrainTreeTest", "[KNNTest]")
   }
 }
 
+/**
+ * Make sure that searching with a compacted tree gives the same results as
+ * searching with a regular tree.
+ */
+TEST_CASE("KNNCompactTreeTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  KNN baseline(dataset);
+
+  std::vector<size_t> oldFromNew;
+  KNN::Tree tree(dataset, oldFromNew);
+  tree.Compact();
+  REQUIRE(tree.IsCompact());
+
+  // Compacting twice should also work.
+  tree.Compact();
+  REQUIRE(tree.IsCompact());
+
+  KNN knn;
+  knn.Train(std::move(tree));
+  REQUIRE(knn.ReferenceTree().IsCompact());
+
+  arma::Mat<size_t> neighbors, baselineNeighbors;
+  arma::mat distances, baselineDistances;
+  for (const NeighborSearchMode mode : { DUAL_TREE_MODE, SINGLE_TREE_MODE })
+  {
+    knn.SearchMode() = mode;
+    baseline.SearchMode() = mode;
+
+    // Search with a query set so that both searches return unmapped results.
+    knn.Search(dataset, 5, neighbors, distances);
+    baseline.Search(dataset, 5, baselineNeighbors, baselineDistances);
+
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      REQUIRE(oldFromNew[neighbors[i]] == baselineNeighbors[i]);
+      REQUIRE(distances[i] == Approx(baselineDistances[i]).epsilon(1e-7));
+    }
+  }
+}
+
 /**
  * Test that training with a tree throws an exception when in naive mode.
  */
@@ -723,6 +759,120 @@ TEST_CASE("KNNDualTreeVsNaive2", "[KNNTest]")
   }
 }
 
+/**
+ * Test the dual-tree nearest-neighbors method with the naive method on
+ * high-dimensional data that is far from the origin, where the batched leaf
+ * base cases have to be careful about precision.
+ */
+TEST_CASE("KNNDualTreeVsNaiveHighDimensional", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(64, 2000) + 1000.0;
+  arma::mat querySet = arma::randu<arma::mat>(64, 300) + 1000.0;
+
+  KNN knn(dataset);
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+
+  // Test both with a separate query set and in monochromatic mode.
+  knn.Search(querySet, 10, neighborsTree, distancesTree);
+  naive.Search(querySet, 10, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+    REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+  }
+
+  knn.Search(10, neighborsTree, distancesTree);
+  naive.Search(10, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+    REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure that searching with several threads gives the same results as
+ * naive search, for every search mode and both with and without a query set.
+ */
+TEST_CASE("KNNParallelSearchTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 3000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 1000);
+
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+#endif
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> neighborsNaive, neighborsMonoNaive;
+  arma::mat distancesNaive, distancesMonoNaive;
+  naive.Search(querySet, 5, neighborsNaive, distancesNaive);
+  naive.Search(5, neighborsMonoNaive, distancesMonoNaive);
+
+  const NeighborSearchMode modes[] = { SINGLE_TREE_MODE, DUAL_TREE_MODE };
+  for (const NeighborSearchMode mode : modes)
+  {
+    KNN knn(dataset, mode);
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+
+    knn.Search(querySet, 5, neighbors, distances);
+    REQUIRE(neighbors.n_cols == querySet.n_cols);
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      REQUIRE(neighbors[i] == neighborsNaive[i]);
+      REQUIRE(distances[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+    }
+
+    // Search twice in monochromatic mode, so that the tree has to be reset.
+    for (size_t trial = 0; trial < 2; ++trial)
+    {
+      knn.Search(5, neighbors, distances);
+      REQUIRE(neighbors.n_cols == dataset.n_cols);
+      for (size_t i = 0; i < neighbors.n_elem; ++i)
+      {
+        REQUIRE(neighbors[i] == neighborsMonoNaive[i]);
+        REQUIRE(distances[i] == Approx(distancesMonoNaive[i]).epsilon(1e-7));
+      }
+    }
+  }
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+}
+
+/**
+ * Test the dual-tree nearest-neighbors method with the naive method on points
+ * of an integer grid, each repeated several times, so that many of the
+ * distances that the batched leaf base cases see are exact ties.  The
+ * neighbors that are chosen among ties may differ, so only the distances are
+ * compared.
+ */
+TEST_CASE("KNNDualTreeVsNaiveTies", "[KNNTest]")
+{
+  arma::mat dataset = arma::floor(5.0 * arma::randu<arma::mat>(3, 500));
+  dataset = arma::join_rows(dataset, dataset, dataset);
+
+  KNN knn(dataset);
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+
+  knn.Search(15, neighborsTree, distancesTree);
+  naive.Search(15, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < distancesTree.n_elem; ++i)
+    REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-12));
+}
+
 /**
  * Test the single-tree nearest-neighbors method with the naive method.  This
  * uses only a reference dataset.
@@ -778,13 +928,13 @@ TEST_CASE("KNNSingleTreeVsNaiveF32", "[KNNTest]")
   NeighborSearch<NearestNeighborSort,
                  EuclideanDistance,
                  arma::fmat,
-                 FloatKDTree> knn(dataset, SINGLE_TREE_MODE);
+                 KDTree> knn(dataset, SINGLE_TREE_MODE);
 
   // Set up computation for naive mode.
   NeighborSearch<NearestNeighborSort,
                  EuclideanDistance,
                  arma::fmat,
-                 FloatKDTree> naive(dataset, NAIVE_MODE);
+                 KDTree> naive(dataset, NAIVE_MODE);
 
   arma::Mat<size_t> neighborsTree;
   arma::fmat distancesTree;
@@ -1290,6 +1440,264 @@ TEST_CASE("KNNModelMonochromaticTest", "[KNNTest]")
   }
 }
 
+/**
+ * Make sure that single-precision NSModels give the same results as a
+ * double-precision search, up to the precision of float, for every exact tree
+ * type and search mode.
+ */
+TEST_CASE("KNNModelSinglePrecisionTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+  util::Timers timers;
+
+  arma::mat queryData = arma::randu<arma::mat>(10, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(10, 200);
+
+  // Get a baseline.
+  KNN knn(referenceData);
+  arma::Mat<size_t> baselineNeighbors;
+  arma::mat baselineDistances;
+  knn.Search(queryData, 3, baselineNeighbors, baselineDistances);
+
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, SINGLE_TREE_MODE,
+      NAIVE_MODE };
+  for (int t = KNNModel::KD_TREE; t <= KNNModel::OCTREE; ++t)
+  {
+    // Spill trees do not give exact results.
+    if (t == KNNModel::SPILL_TREE)
+      continue;
+
+    for (size_t j = 0; j < 3; ++j)
+    {
+      KNNModel model((KNNModel::TreeTypes) t, false, true);
+      model.LeafSize() = 20;
+
+      arma::mat referenceCopy(referenceData);
+      model.BuildModel(timers, std::move(referenceCopy), modes[j]);
+
+      REQUIRE(model.SinglePrecision() == true);
+      REQUIRE(model.Dimensionality() == 10);
+      REQUIRE(model.NumPoints() == 200);
+      REQUIRE_THROWS_AS(model.Dataset(), std::invalid_argument);
+
+      arma::mat queryCopy(queryData);
+      arma::Mat<size_t> neighbors;
+      arma::mat distances;
+      model.Search(timers, std::move(queryCopy), 3, neighbors, distances);
+
+      REQUIRE(neighbors.n_rows == baselineNeighbors.n_rows);
+      REQUIRE(neighbors.n_cols == baselineNeighbors.n_cols);
+      REQUIRE(distances.n_rows == baselineDistances.n_rows);
+      REQUIRE(distances.n_cols == baselineDistances.n_cols);
+      for (size_t k = 0; k < distances.n_elem; ++k)
+      {
+        // Near-ties may be broken differently in single precision, so check
+        // the distance to each returned neighbor instead of its index.
+        const double trueDistance = EuclideanDistance::Evaluate(
+            queryData.col(k / 3), referenceData.col(neighbors[k]));
+        REQUIRE(trueDistance ==
+            Approx(baselineDistances[k]).epsilon(1e-5));
+        REQUIRE(distances[k] == Approx(baselineDistances[k]).epsilon(1e-5));
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that a single-precision NSModel is still single-precision after
+ * serialization, and gives the same results.
+ */
+TEST_CASE("KNNModelSinglePrecisionSerializationTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+  util::Timers timers;
+
+  arma::mat queryData = arma::randu<arma::mat>(5, 30);
+  arma::mat referenceData = arma::randu<arma::mat>(5, 300);
+
+  KNNModel model(KNNModel::KD_TREE, false, true);
+  model.BuildModel(timers, std::move(referenceData), DUAL_TREE_MODE);
+
+  KNNModel xmlModel, jsonModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  arma::mat queryCopy(queryData);
+  model.Search(timers, std::move(queryCopy), 4, neighbors, distances);
+
+  KNNModel* models[] = { &xmlModel, &jsonModel, &binaryModel };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    REQUIRE(models[i]->SinglePrecision() == true);
+    REQUIRE(models[i]->NumPoints() == 300);
+
+    arma::Mat<size_t> otherNeighbors;
+    arma::mat otherDistances;
+    arma::mat otherQueryCopy(queryData);
+    models[i]->Search(timers, std::move(otherQueryCopy), 4, otherNeighbors,
+        otherDistances);
+
+    CheckMatrices(neighbors, otherNeighbors);
+    CheckMatrices(distances, otherDistances);
+  }
+}
+
+/**
+ * Make sure that NSModels can be saved in the mapped format, and that the
+ * loaded models search the same way while their datasets use the mapped file.
+ */
+TEST_CASE("KNNModelMappedTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+  util::Timers timers;
+
+  arma::mat queryData = arma::randu<arma::mat>(4, 40);
+  arma::mat referenceData = arma::randu<arma::mat>(4, 500);
+
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::KD_TREE,
+      KNNModel::COVER_TREE, KNNModel::R_TREE, KNNModel::BALL_TREE };
+  for (size_t t = 0; t < 4; ++t)
+  {
+    KNNModel model(treeTypes[t]);
+    arma::mat referenceCopy(referenceData);
+    model.BuildModel(timers, std::move(referenceCopy), DUAL_TREE_MODE);
+
+    REQUIRE(data::SaveMapped("knn_model.mmap", "model", model, false));
+
+    KNNModel mappedModel;
+    data::MappedFile file;
+    REQUIRE(data::LoadMapped("knn_model.mmap", "model", mappedModel, file,
+        false));
+    REQUIRE(mappedModel.TreeType() == treeTypes[t]);
+    REQUIRE(file.Contains(mappedModel.Dataset().memptr()));
+
+    arma::Mat<size_t> neighbors, mappedNeighbors;
+    arma::mat distances, mappedDistances;
+    arma::mat queryCopy(queryData), mappedQueryCopy(queryData);
+    model.Search(timers, std::move(queryCopy), 5, neighbors, distances);
+    mappedModel.Search(timers, std::move(mappedQueryCopy), 5,
+        mappedNeighbors, mappedDistances);
+
+    CheckMatrices(neighbors, mappedNeighbors);
+    CheckMatrices(distances, mappedDistances);
+  }
+
+  remove("knn_model.mmap");
+}
+
+/**
+ * Make sure that NSQueryServer answers every request in order, coalescing the
+ * requests that are already available into a single search.
+ */
+TEST_CASE("KNNQueryServerTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+  util::Timers timers;
+
+  arma::mat referenceData = arma::randu<arma::mat>(4, 500);
+  arma::mat querySet1 = arma::randu<arma::mat>(4, 50);
+  arma::mat querySet2 = arma::randu<arma::mat>(4, 20);
+  arma::mat badQuerySet = arma::randu<arma::mat>(3, 10);
+
+  KNNModel model(KNNModel::TreeTypes::KD_TREE);
+  arma::mat referenceCopy(referenceData);
+  model.BuildModel(timers, std::move(referenceCopy), DUAL_TREE_MODE);
+
+  std::stringstream requests, responses;
+  NSQueryServer<NearestNeighborSort>::WriteRequest(requests, querySet1, 3);
+  NSQueryServer<NearestNeighborSort>::WriteRequest(requests, badQuerySet, 3);
+  NSQueryServer<NearestNeighborSort>::WriteRequest(requests, querySet2, 5);
+
+  NSQueryServer<NearestNeighborSort> server(model);
+  REQUIRE(server.Serve(requests, responses) == 3);
+  REQUIRE(server.Batches() == 1);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> neighbors, baselineNeighbors;
+  arma::mat distances, baselineDistances;
+
+  REQUIRE(NSQueryServer<NearestNeighborSort>::ReadResponse(responses,
+      neighbors, distances));
+  knn.Search(querySet1, 3, baselineNeighbors, baselineDistances);
+  CheckMatrices(neighbors, baselineNeighbors);
+  CheckMatrices(distances, baselineDistances);
+
+  REQUIRE_THROWS_AS(NSQueryServer<NearestNeighborSort>::ReadResponse(
+      responses, neighbors, distances), std::invalid_argument);
+
+  REQUIRE(NSQueryServer<NearestNeighborSort>::ReadResponse(responses,
+      neighbors, distances));
+  knn.Search(querySet2, 5, baselineNeighbors, baselineDistances);
+  CheckMatrices(neighbors, baselineNeighbors);
+  CheckMatrices(distances, baselineDistances);
+
+  // There should be nothing left.
+  REQUIRE(!NSQueryServer<NearestNeighborSort>::ReadResponse(responses,
+      neighbors, distances));
+
+  // A single-precision model can be served too.
+  KNNModel floatModel(KNNModel::TreeTypes::KD_TREE, false, true);
+  referenceCopy = referenceData;
+  floatModel.BuildModel(timers, std::move(referenceCopy), DUAL_TREE_MODE);
+
+  std::stringstream floatRequests, floatResponses;
+  NSQueryServer<NearestNeighborSort>::WriteRequest(floatRequests, querySet1,
+      3);
+  NSQueryServer<NearestNeighborSort> floatServer(floatModel);
+  REQUIRE(floatServer.Serve(floatRequests, floatResponses) == 1);
+  REQUIRE(floatServer.Batches() == 1);
+
+  REQUIRE(NSQueryServer<NearestNeighborSort>::ReadResponse(floatResponses,
+      neighbors, distances));
+  knn.Search(querySet1, 3, baselineNeighbors, baselineDistances);
+  CheckMatrices(distances, baselineDistances, 1e-3);
+}
+
+/**
+ * Make sure that NSQueryServer answers a request whose header asks for too many
+ * values with an error instead of allocating it, and that ReadResponse() checks
+ * the sizes of the response header too.
+ */
+TEST_CASE("KNNQueryServerMalformedRequestTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+  typedef NSQueryServer<NearestNeighborSort> ServerType;
+  util::Timers timers;
+
+  KNNModel model(KNNModel::TreeTypes::KD_TREE);
+  model.BuildModel(timers, arma::randu<arma::mat>(4, 100), DUAL_TREE_MODE);
+
+  // The requests after the malformed one are not read.
+  std::stringstream requests, responses;
+  const uint64_t header[3] = { 3, 1 << 20, 1 << 20 };
+  requests.write(reinterpret_cast<const char*>(header), sizeof(header));
+  ServerType::WriteRequest(requests, arma::randu<arma::mat>(4, 10), 3);
+
+  ServerType server(model);
+  REQUIRE(server.Serve(requests, responses) == 1);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  REQUIRE_THROWS_AS(ServerType::ReadResponse(responses, neighbors, distances),
+      std::invalid_argument);
+  REQUIRE(!ServerType::ReadResponse(responses, neighbors, distances));
+
+  // Neither a huge error message nor a huge result is allocated.
+  std::stringstream badMessage, badResult;
+  const uint64_t messageHeader[4] = { 1, 3, 10, ((uint64_t) 1) << 40 };
+  badMessage.write(reinterpret_cast<const char*>(messageHeader),
+      sizeof(messageHeader));
+  REQUIRE_THROWS_AS(ServerType::ReadResponse(badMessage, neighbors,
+      distances), std::invalid_argument);
+
+  const uint64_t resultHeader[3] = { 0, ((uint64_t) 1) << 40, 10 };
+  badResult.write(reinterpret_cast<const char*>(resultHeader),
+      sizeof(resultHeader));
+  REQUIRE_THROWS_AS(ServerType::ReadResponse(badResult, neighbors, distances),
+      std::invalid_argument);
+}
+
 /**
  * If we search twice with the same reference tree, the bounds need to be reset
  * before the second search.  This test ensures that that happens, by making
@@ -1879,3 +2287,348 @@ TEST_CASE("KNNSpillTreeSearchEnoughResults", "[KNNTest]")
   REQUIRE(accu(distancesGreedy < 0.0 || distancesGreedy > std::sqrt(3.0))
       == 0);
 }
+
+/**
+ * Make sure that a search with a budget of base cases stops early, reports
+ * that its results are not exact, and still returns valid results; and that a
+ * budget that is large enough gives exact results.
+ */
+TEST_CASE("KNNBudgetTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+
+  KNN exact(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  exact.Search(5, trueNeighbors, trueDistances);
+  REQUIRE(exact.Exact());
+  const size_t exactBaseCases = exact.BaseCases();
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    KNN knn(dataset, (mode == 0) ? DUAL_TREE_MODE : (mode == 1) ?
+        SINGLE_TREE_MODE : NAIVE_MODE);
+    knn.Budget().MaxBaseCases() = exactBaseCases / 10;
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(5, neighbors, distances);
+
+    REQUIRE(!knn.Exact());
+    REQUIRE(knn.BaseCases() < (mode == 2 ? 2000 * 2000 : exactBaseCases));
+
+    // Every neighbor is either a valid point with the right distance, or
+    // marked as not found.
+    for (size_t i = 0; i < neighbors.n_cols; ++i)
+    {
+      for (size_t j = 0; j < neighbors.n_rows; ++j)
+      {
+        if (neighbors(j, i) == size_t() - 1)
+        {
+          REQUIRE(distances(j, i) == DBL_MAX);
+          continue;
+        }
+
+        REQUIRE(neighbors(j, i) < 2000);
+        REQUIRE(neighbors(j, i) != i);
+        REQUIRE(distances(j, i) == Approx(EuclideanDistance::Evaluate(
+            dataset.col(i), dataset.col(neighbors(j, i)))));
+      }
+    }
+
+    // With a budget that does not run out, the results are exact.
+    knn.Budget().MaxBaseCases() = 2000 * 2000;
+    knn.Search(5, neighbors, distances);
+
+    REQUIRE(knn.Exact());
+    CheckMatrices(neighbors, trueNeighbors);
+    CheckMatrices(distances, trueDistances);
+  }
+}
+
+/**
+ * Make sure that a search with a budget of visited nodes or time also stops
+ * early, and that the budget is kept by copies of the model.
+ */
+TEST_CASE("KNNBudgetScoresAndTimeTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+
+  KNN exact(dataset);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  exact.Search(5, neighbors, distances);
+
+  KNN knn(dataset);
+  knn.Budget().MaxScores() = 50;
+  knn.Search(5, neighbors, distances);
+  REQUIRE(!knn.Exact());
+  REQUIRE(knn.Scores() < exact.Scores());
+  REQUIRE(knn.BaseCases() < exact.BaseCases());
+
+  KNN copy(knn);
+  REQUIRE(copy.Budget().MaxScores() == 50);
+
+  // A time limit that runs out immediately prunes almost everything.
+  KNN timed(dataset);
+  timed.Budget().MaxTime() = 1e-9;
+  timed.Search(5, neighbors, distances);
+  REQUIRE(!timed.Exact());
+  REQUIRE(timed.BaseCases() < exact.BaseCases());
+}
+
+/**
+ * Make sure that traversal statistics are collected only when enabled, that
+ * they agree with the counts of the search, and that collecting them does not
+ * change the results.
+ */
+TEST_CASE("KNNTraversalStatisticsTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 500);
+
+  const NeighborSearchMode modes[] = { SINGLE_TREE_MODE, DUAL_TREE_MODE };
+  for (const NeighborSearchMode mode : modes)
+  {
+    KNN knn(dataset, mode);
+    arma::Mat<size_t> neighbors, statNeighbors;
+    arma::mat distances, statDistances;
+
+    knn.Search(querySet, 3, neighbors, distances);
+    REQUIRE(knn.Statistics().Levels().size() == 0);
+
+    knn.Statistics().Enabled() = true;
+    knn.Search(querySet, 3, statNeighbors, statDistances);
+    CheckMatrices(neighbors, statNeighbors);
+    CheckMatrices(distances, statDistances);
+
+    const std::vector<TraversalStatistics::Level>& levels =
+        knn.Statistics().Levels();
+    REQUIRE(levels.size() > 1);
+
+    size_t scores = 0, baseCases = 0, leafPairs = 0;
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+      REQUIRE(levels[i].prunes + levels[i].rescorePrunes <= levels[i].scores);
+      REQUIRE(levels[i].rescorePrunes <= levels[i].rescores);
+      scores += levels[i].scores;
+      baseCases += levels[i].baseCases;
+      leafPairs += levels[i].leafPairs;
+    }
+
+    REQUIRE(scores == knn.Scores());
+    REQUIRE(baseCases >= knn.BaseCases());
+    REQUIRE(leafPairs > 0);
+
+    const std::string json = knn.Statistics().ToJSON();
+    REQUIRE(json.find("\"levels\": [{\"level\": 0") != std::string::npos);
+
+    // The statistics of the next search replace these ones.
+    knn.Search(querySet, 3, statNeighbors, statDistances);
+    size_t newScores = 0;
+    for (size_t i = 0; i < knn.Statistics().Levels().size(); ++i)
+      newScores += knn.Statistics().Levels()[i].scores;
+    REQUIRE(newScores == knn.Scores());
+  }
+}
+
+/**
+ * Make sure that points can be inserted into and deleted from the reference set
+ * of a trained model, and that the results then match a brute-force search on
+ * the modified reference set.
+ */
+TEMPLATE_TEST_CASE("KNNInsertDeleteTest", "[KNNTest]",
+    (NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+        KDTree>),
+    (NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+        BallTree>))
+{
+  typedef TestType KNNType;
+
+  arma::mat referenceSet(3, 800, arma::fill::randu);
+  arma::mat querySet(3, 100, arma::fill::randu);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    const NeighborSearchMode searchMode = (mode == 0) ? NAIVE_MODE :
+        ((mode == 1) ? SINGLE_TREE_MODE : DUAL_TREE_MODE);
+    KNNType knn(referenceSet, searchMode);
+
+    // Run a search first, so that the tree statistics hold results.
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(querySet, 5, neighbors, distances);
+
+    arma::mat newPoints(3, 200, arma::fill::randu);
+    newPoints.cols(0, 99) *= 0.1;
+    knn.Insert(newPoints);
+    arma::mat modified = arma::join_rows(referenceSet, newPoints);
+
+    std::vector<size_t> indices;
+    std::vector<arma::uword> keptIndices;
+    for (size_t i = 0; i < modified.n_cols; ++i)
+    {
+      if (i % 4 == 1)
+        indices.push_back(i);
+      else
+        keptIndices.push_back(i);
+    }
+    knn.Delete(indices);
+    modified = arma::mat(modified.cols(
+        arma::conv_to<arma::uvec>::from(keptIndices)));
+    REQUIRE(knn.ReferenceSet().n_cols == modified.n_cols);
+
+    KNNType naive(modified, NAIVE_MODE);
+    arma::Mat<size_t> naiveNeighbors;
+    arma::mat naiveDistances;
+    naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+    // Both monochromatic and bichromatic searches should be correct.
+    knn.Search(querySet, 5, neighbors, distances);
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+
+    knn.Search(5, neighbors, distances);
+    naive.Search(5, naiveNeighbors, naiveDistances);
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+
+    REQUIRE_THROWS_AS(knn.Delete(std::vector<size_t>(1, modified.n_cols)),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(knn.Insert(arma::mat(2, 3, arma::fill::randu)),
+        std::invalid_argument);
+  }
+}
+
+/**
+ * Make sure that searches are still exact after the reference tree is refitted
+ * to transformed points.
+ */
+TEST_CASE("KNNRefittedTreeTest", "[KNNTest]")
+{
+  arma::mat dataset(3, 500, arma::fill::randu);
+  arma::mat query(3, 50, arma::fill::randu);
+
+  std::vector<size_t> oldFromNew;
+  KNN::Tree tree(dataset, oldFromNew, 10);
+  KNN knn(std::move(tree));
+
+  // Map every point by the same transformation, and refit the tree.
+  arma::mat transformation(3, 3, arma::fill::randn);
+  knn.ReferenceTree().Dataset() = transformation *
+      knn.ReferenceTree().Dataset();
+  knn.ReferenceTree().RefitBounds();
+
+  // The results refer to the order of the tree's dataset.
+  KNN naive(knn.ReferenceSet(), NAIVE_MODE);
+  const arma::mat transformedQuery = transformation * query;
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  knn.Search(transformedQuery, 3, neighbors, distances);
+  naive.Search(transformedQuery, 3, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Make sure that a vantage point tree search on packed binary codes with the
+ * Hamming distance finds the same distances as a naive search.  There are
+ * many ties between integer distances, so only the distances are compared.
+ */
+TEST_CASE("KNNVPTreeHammingTest", "[KNNTest]")
+{
+  // Make codes that are clustered, so that the tree can prune.
+  arma::mat centers = arma::round(arma::randu<arma::mat>(256, 10));
+  arma::mat codes(256, 2000);
+  for (size_t i = 0; i < codes.n_cols; ++i)
+  {
+    codes.col(i) = centers.col(i % centers.n_cols);
+    for (size_t j = 0; j < 20; ++j)
+    {
+      const size_t bit = RandInt(codes.n_rows);
+      codes(bit, i) = 1 - codes(bit, i);
+    }
+  }
+
+  arma::mat packed;
+  data::PackBinary(codes, packed);
+  arma::mat packedQueries = packed.cols(0, 99);
+
+  typedef NeighborSearch<NearestNeighborSort, HammingDistance, arma::mat,
+      VPTree> HammingKNN;
+  HammingKNN knn(packed);
+  HammingKNN naive(packed, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  knn.Search(5, neighbors, distances);
+  naive.Search(5, naiveNeighbors, naiveDistances);
+  CheckMatrices(distances, naiveDistances);
+
+  knn.Search(packedQueries, 5, neighbors, distances);
+  naive.Search(packedQueries, 5, naiveNeighbors, naiveDistances);
+  CheckMatrices(distances, naiveDistances);
+
+  // The distances are those of the unpacked codes.
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      REQUIRE(distances(j, i) == arma::accu(codes.col(i) !=
+          codes.col(neighbors(j, i))));
+    }
+  }
+}
+
+/**
+ * Make sure that ShardedNeighborSearch over shards in four threads finds the
+ * same neighbors, with their original indices, as a search on the whole
+ * dataset, for random and random projection partitions.
+ */
+TEST_CASE("KNNShardedSearchTest", "[KNNTest]")
+{
+  arma::mat dataset(3, 2000, arma::fill::randu);
+  arma::mat querySet(3, 300, arma::fill::randu);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(querySet, 5, trueNeighbors, trueDistances);
+
+  typedef ShardedNeighborSearch<NearestNeighborSort, ThreadAllReduce>
+      ShardedKNN;
+  for (const bool randomProjection : { false, true })
+  {
+    std::vector<arma::uvec> shards;
+    ShardedKNN::Partition(dataset, 4, shards, randomProjection);
+    REQUIRE(shards.size() == 4);
+    REQUIRE(arma::accu(arma::sort(arma::join_cols(arma::join_cols(shards[0],
+        shards[1]), arma::join_cols(shards[2], shards[3]))) !=
+        arma::regspace<arma::uvec>(0, 1999)) == 0);
+
+    ThreadAllReduce::State state(4);
+    std::vector<arma::Mat<size_t>> neighbors(4);
+    std::vector<arma::mat> distances(4);
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < 4; ++p)
+    {
+      threads.push_back(std::thread([&, p]()
+      {
+        ShardedKNN sharded(dataset.cols(shards[p]), shards[p],
+            ThreadAllReduce(state, p));
+        // Only the query points of the first process are used.
+        sharded.Search(p == 0 ? querySet : arma::mat(), 5, neighbors[p],
+            distances[p]);
+      }));
+    }
+    for (size_t p = 0; p < 4; ++p)
+      threads[p].join();
+
+    for (size_t p = 0; p < 4; ++p)
+    {
+      CheckMatrices(neighbors[p], trueNeighbors);
+      CheckMatrices(distances[p], trueDistances);
+    }
+  }
+}
@@ -730,3 +730,47 @@ TEST_CASE("RAModelTest", "[KRANNTest]")
     }
   }
 }
+
+/**
+ * Make sure that naive and single-tree rank-approximate search give the same
+ * results with a fixed seed whatever the number of threads, since every query
+ * point samples from its own stream.
+ */
+TEST_CASE("KRANNParallelReproducibleTest", "[KRANNTest]")
+{
+  arma::mat refData(3, 2000, arma::fill::randu);
+  arma::mat queryData(3, 500, arma::fill::randu);
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    const bool naive = (mode == 0);
+    RASearch<> rann(refData, naive, !naive, 5.0, 0.95, false, true);
+
+    arma::Mat<size_t> serialNeighbors, parallelNeighbors;
+    arma::mat serialDistances, parallelDistances;
+
+#ifdef MLPACK_USE_OPENMP
+    const int oldThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+#endif
+
+    RandomSeed(42);
+    rann.Search(queryData, 3, serialNeighbors, serialDistances);
+
+#ifdef MLPACK_USE_OPENMP
+    omp_set_num_threads(4);
+#endif
+
+    RandomSeed(42);
+    rann.Search(queryData, 3, parallelNeighbors, parallelDistances);
+
+#ifdef MLPACK_USE_OPENMP
+    omp_set_num_threads(oldThreads);
+#endif
+
+    REQUIRE(arma::all(arma::vectorise(serialNeighbors ==
+        parallelNeighbors)));
+    REQUIRE(arma::approx_equal(serialDistances, parallelDistances, "both",
+        1e-10, 1e-10));
+  }
+}
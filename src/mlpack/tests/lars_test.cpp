@@ -849,6 +849,7 @@ TEMPLATE_TEST_CASE("LARSConstructorVariantTest", "[LARSTest]", arma::fmat,
       false, false);
 
   REQUIRE(l1.BetaPath().size() == 0);
+  REQUIRE(l1.UseCholesky() == true);
 
   REQUIRE(l2.BetaPath().size() == 0);
   REQUIRE(l2.UseCholesky() == false);
@@ -1215,3 +1216,70 @@ TEMPLATE_TEST_CASE("LARSSparseModelDenseData", "[LARSTest]", float, double)
   REQUIRE(lars2.ActiveSet().size() < 1000);
   REQUIRE(lars2.ActiveSet().size() > 0);
 }
+
+/**
+ * Make sure that TrainBatch() gives the same solutions as training on each set
+ * of responses separately.
+ */
+TEST_CASE("LARSTrainBatchTest", "[LARSTest]")
+{
+  arma::mat X;
+  arma::rowvec y;
+  GenerateProblem(X, y, 200, 15);
+
+  // Each column holds a set of responses.
+  arma::mat responses(200, 12);
+  for (size_t i = 0; i < responses.n_cols; ++i)
+  {
+    const arma::vec beta = arma::randn<arma::vec>(15);
+    responses.col(i) = (beta.t() * X + 0.1 * arma::randn<arma::rowvec>(200) +
+        (double) i).t();
+  }
+  const arma::mat Xt = X.t();
+
+  for (const bool useCholesky : { true, false })
+  {
+    for (const bool fitIntercept : { true, false })
+    {
+      for (const bool normalizeData : { true, false })
+      {
+        LARS<> lars(useCholesky, 0.05, 0.01, 1e-16, fitIntercept,
+            normalizeData);
+
+        arma::mat betas, rowMajorBetas;
+        arma::rowvec intercepts;
+        lars.TrainBatch(X, responses, betas, intercepts);
+        lars.TrainBatch(Xt, responses, rowMajorBetas, false);
+
+        // The model is not changed.
+        REQUIRE(lars.BetaPath().size() == 0);
+
+        REQUIRE(betas.n_rows == 15);
+        REQUIRE(betas.n_cols == responses.n_cols);
+        REQUIRE(intercepts.n_elem == responses.n_cols);
+        for (size_t i = 0; i < responses.n_cols; ++i)
+        {
+          LARS<> single(useCholesky, 0.05, 0.01, 1e-16, fitIntercept,
+              normalizeData);
+          single.Train(X, arma::rowvec(responses.col(i).t()));
+
+          for (size_t j = 0; j < betas.n_rows; ++j)
+          {
+            REQUIRE(betas(j, i) ==
+                Approx(single.Beta()[j]).epsilon(1e-5).margin(1e-8));
+            REQUIRE(rowMajorBetas(j, i) ==
+                Approx(single.Beta()[j]).epsilon(1e-5).margin(1e-8));
+          }
+          REQUIRE(intercepts[i] ==
+              Approx(single.Intercept()).epsilon(1e-5).margin(1e-8));
+        }
+      }
+    }
+  }
+
+  // The number of responses must match the number of points.
+  LARS<> lars;
+  arma::mat betas;
+  REQUIRE_THROWS_AS(lars.TrainBatch(X, responses.rows(0, 99), betas),
+      std::invalid_argument);
+}
@@ -423,3 +423,142 @@ TEST_CASE("LinearRegressionSparseTrainingTest", "[LinearRegressionTest]")
 
   REQUIRE(predictions.n_elem == 5000);
 }
+
+// Make sure that training from statistics accumulated one chunk at a time
+// gives the same model as training on the whole dataset.
+TEST_CASE("LinearRegressionStatisticsTrainingTest", "[LinearRegressionTest]")
+{
+  arma::mat predictors(5, 1000, arma::fill::randu);
+  arma::rowvec responses = arma::rowvec("1 2 -3 0.5 4") * predictors + 0.7 +
+      0.01 * arma::randn<arma::rowvec>(1000);
+
+  for (const bool intercept : { true, false })
+  {
+    for (const double lambda : { 0.0, 0.5 })
+    {
+      LinearRegression<> lr;
+      const double error = lr.Train(predictors, responses, lambda, intercept);
+
+      LinearRegressionStatistics<> statistics(0, intercept);
+      // Use chunks that do not divide the number of points.
+      for (size_t i = 0; i < predictors.n_cols; i += 300)
+      {
+        const size_t end = std::min(i + 300, (size_t) predictors.n_cols) - 1;
+        statistics.Accumulate(predictors.cols(i, end), responses.cols(i, end));
+      }
+
+      REQUIRE(statistics.NumPoints() == 1000);
+      REQUIRE(statistics.Dimensionality() == 5);
+      REQUIRE(statistics.TotalWeight() == Approx(1000.0));
+
+      LinearRegression<> streamingLr;
+      const double streamingError = streamingLr.Train(statistics, lambda);
+
+      REQUIRE(streamingLr.Intercept() == intercept);
+      REQUIRE(streamingLr.Lambda() == lambda);
+      REQUIRE(streamingLr.Parameters().n_elem == lr.Parameters().n_elem);
+      for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+      {
+        REQUIRE(streamingLr.Parameters()[i] ==
+            Approx(lr.Parameters()[i]).epsilon(1e-6).margin(1e-8));
+      }
+      REQUIRE(streamingError == Approx(error).epsilon(1e-4).margin(1e-8));
+    }
+  }
+}
+
+// Make sure that weighted statistics give the same model as weighted training,
+// and that statistics can be merged.
+TEST_CASE("LinearRegressionStatisticsWeightedMergeTest",
+    "[LinearRegressionTest]")
+{
+  arma::mat predictors(4, 900, arma::fill::randu);
+  arma::rowvec responses = arma::rowvec("-1 3 2 0.5") * predictors - 1.5 +
+      0.05 * arma::randn<arma::rowvec>(900);
+  arma::rowvec weights(900, arma::fill::randu);
+
+  LinearRegression<> lr;
+  lr.Train(predictors, responses, weights, 0.1);
+
+  LinearRegressionStatistics<> statistics1, statistics2, statistics3;
+  statistics1.Accumulate(predictors.cols(0, 399), responses.cols(0, 399),
+      weights.cols(0, 399));
+  statistics2.Accumulate(predictors.cols(400, 699), responses.cols(400, 699),
+      weights.cols(400, 699));
+  statistics3.Accumulate(predictors.cols(700, 899), responses.cols(700, 899),
+      weights.cols(700, 899));
+
+  LinearRegressionStatistics<> statistics;
+  statistics.Merge(statistics1);
+  statistics.Merge(statistics2);
+  statistics.Merge(statistics3);
+
+  REQUIRE(statistics.NumPoints() == 900);
+  REQUIRE(statistics.TotalWeight() == Approx(accu(weights)));
+
+  LinearRegression<> streamingLr;
+  streamingLr.Train(statistics, 0.1);
+
+  REQUIRE(streamingLr.Parameters().n_elem == 5);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+  {
+    REQUIRE(streamingLr.Parameters()[i] ==
+        Approx(lr.Parameters()[i]).epsilon(1e-6).margin(1e-8));
+  }
+
+  // The statistics can be saved and loaded, to be merged by another process.
+  LinearRegressionStatistics<> xmlStatistics, jsonStatistics, binaryStatistics;
+  SerializeObjectAll(statistics, xmlStatistics, jsonStatistics,
+      binaryStatistics);
+  REQUIRE(binaryStatistics.NumPoints() == 900);
+  CheckMatrices(statistics.Gram(), xmlStatistics.Gram(), jsonStatistics.Gram(),
+      binaryStatistics.Gram());
+  CheckMatrices(statistics.Cross(), xmlStatistics.Cross(),
+      jsonStatistics.Cross(), binaryStatistics.Cross());
+
+  // Statistics of different dimensionality or intercept setting cannot be
+  // merged.
+  LinearRegressionStatistics<> otherStatistics(3);
+  REQUIRE_THROWS_AS(statistics.Merge(otherStatistics), std::invalid_argument);
+  LinearRegressionStatistics<> noInterceptStatistics(4, false);
+  REQUIRE_THROWS_AS(statistics.Merge(noInterceptStatistics),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(statistics.Accumulate(predictors.rows(0, 2), responses),
+      std::invalid_argument);
+
+  // Empty statistics cannot be trained on.
+  statistics.Reset();
+  REQUIRE(statistics.NumPoints() == 0);
+  REQUIRE_THROWS_AS(streamingLr.Train(statistics), std::invalid_argument);
+}
+
+// Make sure that statistics can be accumulated from a file with a chunked
+// loader.
+TEST_CASE("LinearRegressionStatisticsChunkedLoaderTest",
+    "[LinearRegressionTest]")
+{
+  arma::mat dataset(4, 1000, arma::fill::randu);
+  dataset.row(3) = arma::rowvec("2 -1 0.5") * dataset.rows(0, 2) + 3 +
+      0.01 * arma::randn<arma::rowvec>(1000);
+  REQUIRE(data::Save("linear_regression_chunked_test.csv", dataset));
+
+  LinearRegression<> lr;
+  lr.Train(dataset.rows(0, 2), arma::rowvec(dataset.row(3)), 0.01);
+
+  data::ChunkedLoader loader("linear_regression_chunked_test.csv", 128);
+  LinearRegressionStatistics<> statistics;
+  REQUIRE(statistics.AccumulateChunks(loader) == 1000);
+  REQUIRE(statistics.Dimensionality() == 3);
+
+  LinearRegression<> streamingLr;
+  streamingLr.Train(statistics, 0.01);
+
+  REQUIRE(streamingLr.Parameters().n_elem == 4);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+  {
+    REQUIRE(streamingLr.Parameters()[i] ==
+        Approx(lr.Parameters()[i]).epsilon(1e-5).margin(1e-8));
+  }
+
+  remove("linear_regression_chunked_test.csv");
+}
@@ -462,6 +462,114 @@ TEST_CASE("LinearSVMFunctionSeparableGradient", "[LinearSVMTest]")
   }
 }
 
+/**
+ * Test that the sparse Gradient() of the LinearSVMFunction, used by
+ * ParallelSGD, holds the entries of the dense gradient that the points depend
+ * on, and nothing else.
+ */
+TEST_CASE("LinearSVMFunctionSparseGradient", "[LinearSVMTest]")
+{
+  const size_t numClasses = 4;
+  const double lambda = 0.1;
+
+  arma::sp_mat data;
+  data.sprandu(20, 200, 0.1);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = RandInt(0, numClasses);
+
+  for (const bool fitIntercept : { false, true })
+  {
+    LinearSVMFunction<arma::sp_mat> svmf(data, labels, numClasses, lambda,
+        1.0, fitIntercept);
+
+    arma::mat parameters;
+    parameters.randu(fitIntercept ? 21 : 20, numClasses);
+
+    for (const size_t batchSize : { 1, 7 })
+    {
+      for (size_t firstId = 0; firstId + batchSize <= 200; firstId += 37)
+      {
+        arma::mat gradient;
+        svmf.Gradient(parameters, firstId, gradient, batchSize);
+        arma::sp_mat sparseGradient;
+        svmf.Gradient(parameters, firstId, sparseGradient, batchSize);
+
+        REQUIRE(sparseGradient.n_rows == gradient.n_rows);
+        REQUIRE(sparseGradient.n_cols == gradient.n_cols);
+        for (size_t c = 0; c < gradient.n_cols; ++c)
+        {
+          for (size_t r = 0; r < gradient.n_rows; ++r)
+          {
+            if (sparseGradient(r, c) != 0)
+            {
+              REQUIRE(sparseGradient(r, c) ==
+                  Approx(gradient(r, c)).epsilon(1e-7));
+            }
+            else
+            {
+              // The weight does not depend on the points, so only the
+              // regularization is in the dense gradient.
+              REQUIRE(gradient(r, c) - lambda * parameters(r, c) ==
+                  Approx(0.0).margin(1e-10));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Test that shuffling the LinearSVMFunction keeps the points with their labels,
+ * for dense and sparse data.
+ */
+TEST_CASE("LinearSVMFunctionShuffleTest", "[LinearSVMTest]")
+{
+  arma::sp_mat data;
+  data.sprandu(10, 100, 0.2);
+  // Store the label of each point in its first dimension.
+  arma::Row<size_t> labels(100);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    labels[i] = RandInt(0, 3);
+    data(0, i) = labels[i] + 1;
+  }
+
+  arma::mat parameters(10, 3, arma::fill::randu);
+
+  const arma::mat denseData(data);
+  LinearSVMFunction<arma::sp_mat> sparseSvmf(data, labels, 3);
+  LinearSVMFunction<arma::mat> svmf(denseData, labels, 3);
+  const double objective = svmf.Evaluate(parameters);
+  const double sparseObjective = sparseSvmf.Evaluate(parameters);
+
+  svmf.Shuffle();
+  sparseSvmf.Shuffle();
+
+  REQUIRE(svmf.Dataset().n_cols == 100);
+  REQUIRE(sparseSvmf.Dataset().n_cols == 100);
+  REQUIRE(accu(svmf.Dataset()) == Approx(accu(data)));
+  REQUIRE(accu(sparseSvmf.Dataset()) == Approx(accu(data)));
+
+  // The objective doesn't depend on the order of the points.
+  REQUIRE(svmf.Evaluate(parameters) == Approx(objective));
+  REQUIRE(sparseSvmf.Evaluate(parameters) == Approx(sparseObjective));
+  REQUIRE(sparseObjective == Approx(objective));
+
+  // Each point still has its label.
+  arma::mat singleParameters(10, 3, arma::fill::zeros);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const size_t label = (size_t) sparseSvmf.Dataset()(0, i) - 1;
+    arma::mat gradient;
+    sparseSvmf.Gradient(singleParameters, i, gradient, 1);
+    // With zero parameters, the margin of every other class is violated, so
+    // the gradient of the weights of the correct class is negative.
+    REQUIRE(gradient(0, label) < 0);
+  }
+}
+
 /**
  * Test training of linear svm on a simple dataset using
  * L-BFGS optimizer
@@ -859,6 +967,37 @@ TEST_CASE("LinearSVMParallelSGDTwoClasses", "[LinearSVMTest]")
   REQUIRE(success == true);
 }
 
+/**
+ * Test training of linear svm on sparse data with the Parallel SGD optimizer,
+ * which uses the sparse gradient of the LinearSVMFunction.
+ */
+TEST_CASE("LinearSVMSparseParallelSGDTest", "[LinearSVMTest]")
+{
+  const size_t points = 1000;
+  const size_t numClasses = 3;
+
+  // Each class has its own set of (sparse) features.
+  arma::sp_mat data(30, points);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = i % numClasses;
+    for (size_t j = 0; j < 3; ++j)
+      data(10 * labels[i] + RandInt(0, 10), i) = Random(0.5, 1.5);
+  }
+
+  ens::ConstantStep decayPolicy(0.02);
+  ens::ParallelSGD<ens::ConstantStep> optimizer(20 * points,
+      std::ceil((float) points / omp_get_max_threads()), 1e-5, true,
+      decayPolicy);
+
+  LinearSVM<> lsvm;
+  lsvm.Train(data, labels, numClasses, optimizer, 0.0001, 1.0, true);
+
+  REQUIRE(lsvm.ComputeAccuracy(data, labels) >= 95.0);
+  REQUIRE(lsvm.ComputeAccuracy(arma::mat(data), labels) >= 95.0);
+}
+
 #endif
 
 /**
@@ -1467,3 +1606,46 @@ TEMPLATE_TEST_CASE("LinearSVMTrainVariantTest", "[LinearSVMTest]", arma::fmat,
   REQUIRE(lsvm16.FeatureSize() == 10);
   REQUIRE(lsvm16.NumClasses() == 2);
 }
+
+/**
+ * Make sure that the batched classification of many points gives the same
+ * results as the classification of each point.
+ */
+TEST_CASE("LinearSVMBatchClassifyTest", "[LinearSVMTest]")
+{
+  // Use more points than a block of points classified in parallel.
+  arma::mat data(5, 2500, arma::fill::randu);
+  arma::Row<size_t> trainLabels(2500);
+  for (size_t i = 0; i < trainLabels.n_elem; ++i)
+    trainLabels[i] = RandInt(0, 3);
+
+  for (const bool fitIntercept : { false, true })
+  {
+    LinearSVM<> lsvm(data, trainLabels, 3, 0.0001, 1.0, fitIntercept);
+
+    arma::Row<size_t> labels;
+    arma::mat scores;
+    lsvm.Classify(data, labels, scores);
+
+    REQUIRE(labels.n_elem == data.n_cols);
+    REQUIRE(scores.n_rows == 3);
+    REQUIRE(scores.n_cols == data.n_cols);
+
+    arma::sp_mat sparseData(data);
+    arma::Row<size_t> sparseLabels;
+    lsvm.Classify(sparseData, sparseLabels);
+    REQUIRE(sparseLabels.n_elem == data.n_cols);
+
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      size_t label;
+      arma::vec pointScores;
+      lsvm.Classify(data.col(i), label, pointScores);
+
+      REQUIRE(labels[i] == label);
+      REQUIRE(sparseLabels[i] == label);
+      for (size_t c = 0; c < 3; ++c)
+        REQUIRE(scores(c, i) == Approx(pointScores[c]).epsilon(1e-7));
+    }
+  }
+}
@@ -93,6 +93,54 @@ TEST_CASE("LMNNImpostorsTest", "[LMNNTest]")
   REQUIRE(impostors(0, 5) == 2);
 }
 
+/**
+ * The impostors found with the refitted trees should be the same as those
+ * found with trees built for each search.
+ */
+TEST_CASE("LMNNImpostorsTreeReuseTest", "[LMNNTest]")
+{
+  arma::mat dataset(4, 300, arma::fill::randu);
+  arma::Row<size_t> labels(300);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = i % 3;
+
+  arma::vec norm(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    norm(i) = arma::norm(dataset.col(i));
+
+  // The first constraints refit their trees, the second ones never do.
+  Constraints<> reused(dataset, labels, 3, 100);
+  Constraints<> rebuilt(dataset, labels, 3, 0);
+
+  arma::Mat<size_t> impostors(3, dataset.n_cols), impostors2(3, dataset.n_cols);
+  arma::mat distances(3, dataset.n_cols), distances2(3, dataset.n_cols);
+  arma::mat transformation(4, 4, arma::fill::eye);
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    const arma::mat transformed = transformation * dataset;
+    reused.Impostors(impostors, distances, transformed, labels, norm);
+    rebuilt.Impostors(impostors2, distances2, transformed, labels, norm);
+
+    CheckMatrices(impostors, impostors2);
+    CheckMatrices(distances, distances2);
+
+    // Only some points, then a batch.
+    arma::uvec points = arma::regspace<arma::uvec>(0, 7, 299);
+    reused.Impostors(impostors, distances, transformed, labels, norm, points,
+        points.n_elem);
+    rebuilt.Impostors(impostors2, distances2, transformed, labels, norm, points,
+        points.n_elem);
+    reused.Impostors(impostors, distances, transformed, labels, norm, 100, 50);
+    rebuilt.Impostors(impostors2, distances2, transformed, labels, norm, 100,
+        50);
+
+    CheckMatrices(impostors, impostors2);
+    CheckMatrices(distances, distances2);
+
+    transformation += 0.3 * arma::randn<arma::mat>(4, 4);
+  }
+}
+
 //
 // Tests for the LMNNFunction
 //
@@ -15,6 +15,10 @@
 #include "catch.hpp"
 #include "test_catch_tools.hpp"
 
+#ifdef MLPACK_HAS_ARROW
+  #include <parquet/arrow/writer.h>
+#endif
+
 using namespace mlpack;
 using namespace mlpack::data;
 using namespace std;
@@ -1185,6 +1189,150 @@ TEST_CASE("SaveHDF5Test", "[LoadSaveTest]")
 
 #endif
 
+#ifdef MLPACK_HAS_ARROW
+/**
+ * Write a table with a floating-point column, an integer column with a null
+ * value, and a dictionary-encoded string column, as an Arrow IPC file and as a
+ * Parquet file.
+ */
+void WriteArrowTestTable()
+{
+  std::shared_ptr<arrow::Array> x, y, z;
+  arrow::DoubleBuilder xBuilder;
+  REQUIRE(xBuilder.AppendValues({ 1.5, 2.5, 3.5, 4.5 }).ok());
+  REQUIRE(xBuilder.Finish(&x).ok());
+
+  arrow::Int32Builder yBuilder;
+  REQUIRE(yBuilder.Append(1).ok());
+  REQUIRE(yBuilder.AppendNull().ok());
+  REQUIRE(yBuilder.Append(3).ok());
+  REQUIRE(yBuilder.Append(4).ok());
+  REQUIRE(yBuilder.Finish(&y).ok());
+
+  arrow::StringDictionaryBuilder zBuilder;
+  REQUIRE(zBuilder.Append("red").ok());
+  REQUIRE(zBuilder.Append("blue").ok());
+  REQUIRE(zBuilder.Append("red").ok());
+  REQUIRE(zBuilder.Append("green").ok());
+  REQUIRE(zBuilder.Finish(&z).ok());
+
+  std::shared_ptr<arrow::Schema> schema = arrow::schema({
+      arrow::field("x", x->type()), arrow::field("y", y->type()),
+      arrow::field("z", z->type()) });
+  std::shared_ptr<arrow::Table> table = arrow::Table::Make(schema,
+      { x, y, z });
+
+  auto file = arrow::io::FileOutputStream::Open("test_file.arrow");
+  REQUIRE(file.ok());
+  auto writer = arrow::ipc::MakeFileWriter(*file, schema);
+  REQUIRE(writer.ok());
+  REQUIRE((*writer)->WriteTable(*table).ok());
+  REQUIRE((*writer)->Close().ok());
+  REQUIRE((*file)->Close().ok());
+
+  auto parquetFile = arrow::io::FileOutputStream::Open("test_file.parquet");
+  REQUIRE(parquetFile.ok());
+  REQUIRE(parquet::arrow::WriteTable(*table, arrow::default_memory_pool(),
+      *parquetFile, 2).ok());
+  REQUIRE((*parquetFile)->Close().ok());
+
+  // A table with only the numeric columns.
+  std::shared_ptr<arrow::Table> numericTable = arrow::Table::Make(
+      arrow::schema({ arrow::field("x", x->type()),
+      arrow::field("y", y->type()) }), { x, y });
+  auto numericFile = arrow::io::FileOutputStream::Open("test_file.feather");
+  REQUIRE(numericFile.ok());
+  auto numericWriter = arrow::ipc::MakeFileWriter(*numericFile,
+      numericTable->schema());
+  REQUIRE(numericWriter.ok());
+  REQUIRE((*numericWriter)->WriteTable(*numericTable).ok());
+  REQUIRE((*numericWriter)->Close().ok());
+  REQUIRE((*numericFile)->Close().ok());
+}
+
+/**
+ * Make sure Arrow IPC and Parquet files are loaded with their numeric columns
+ * and their categorical string columns.
+ */
+TEST_CASE("LoadArrowTest", "[LoadSaveTest]")
+{
+  WriteArrowTestTable();
+
+  for (const std::string filename : { "test_file.arrow", "test_file.parquet" })
+  {
+    arma::mat m;
+    data::DatasetInfo info;
+    REQUIRE(data::Load(filename, m, info, true) == true);
+    REQUIRE(m.n_rows == 3);
+    REQUIRE(m.n_cols == 4);
+    REQUIRE(info.Type(0) == data::Datatype::numeric);
+    REQUIRE(info.Type(1) == data::Datatype::numeric);
+    REQUIRE(info.Type(2) == data::Datatype::categorical);
+    REQUIRE(info.NumMappings(2) == 3);
+
+    for (size_t i = 0; i < 4; ++i)
+      REQUIRE(m(0, i) == Approx(1.5 + i).epsilon(1e-7));
+    REQUIRE(m(1, 0) == Approx(1.0).epsilon(1e-7));
+    REQUIRE(std::isnan(m(1, 1)));
+    REQUIRE(m(1, 3) == Approx(4.0).epsilon(1e-7));
+    REQUIRE(m(2, 0) == 0);
+    REQUIRE(m(2, 1) == 1);
+    REQUIRE(m(2, 2) == 0);
+    REQUIRE(m(2, 3) == 2);
+    REQUIRE(info.UnmapString(2, 2) == "green");
+
+    // Loading without transposing gives one point per row, and the same
+    // mappings are used again.
+    arma::mat n;
+    REQUIRE(data::Load(filename, n, info, true, false) == true);
+    REQUIRE(n.n_rows == 4);
+    REQUIRE(n.n_cols == 3);
+    REQUIRE(n(2, 0) == Approx(3.5).epsilon(1e-7));
+    REQUIRE(std::isnan(n(1, 1)));
+    REQUIRE(n(3, 2) == 2);
+    REQUIRE(info.NumMappings(2) == 3);
+
+    // String columns cannot be loaded without a DatasetInfo.
+    REQUIRE(data::Load(filename, n) == false);
+  }
+
+  arma::fmat f;
+  REQUIRE(data::Load("test_file.feather", f) == true);
+  REQUIRE(f.n_rows == 2);
+  REQUIRE(f.n_cols == 4);
+  REQUIRE(f(0, 2) == Approx(3.5f).epsilon(1e-5));
+  REQUIRE(std::isnan(f(1, 1)));
+
+  // Null values cannot be loaded into an integer matrix.
+  arma::Mat<size_t> u;
+  REQUIRE(data::Load("test_file.feather", u) == false);
+
+  remove("test_file.arrow");
+  remove("test_file.parquet");
+  remove("test_file.feather");
+}
+#else
+/**
+ * Make sure that Arrow files cannot be loaded without Arrow support.
+ */
+TEST_CASE("LoadArrowUnsupportedTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_file.parquet", fstream::out);
+  f << "PAR1" << endl;
+  f.close();
+
+  arma::mat m;
+  data::DatasetInfo info;
+  REQUIRE(data::Load("test_file.parquet", m) == false);
+  REQUIRE(data::Load("test_file.parquet", m, info) == false);
+  REQUIRE_THROWS_AS(data::Load("test_file.parquet", m, true),
+      std::runtime_error);
+
+  remove("test_file.parquet");
+}
+#endif
+
 /**
  * Test normalization of labels.
  */
@@ -1344,6 +1492,704 @@ TEST_CASE("LoadJsonTest", "[LoadSaveTest]")
   REQUIRE(y.inb.s == x.inb.s);
 }
 
+/**
+ * Make sure that objects saved with SaveMapped() can be loaded with
+ * LoadMapped(), and that their matrices then use the mapped memory.
+ */
+TEST_CASE("LoadMappedTest", "[LoadSaveTest]")
+{
+  Test x(10, 12);
+  arma::mat m = arma::randu<arma::mat>(7, 300);
+  arma::vec v = arma::randu<arma::vec>(5);
+  arma::Mat<size_t> e;
+  std::tuple<Test, arma::mat, arma::vec, arma::Mat<size_t>> t(x, m, v, e);
+
+  REQUIRE(data::SaveMapped("test.mmap", "t", t, false) == true);
+
+  std::tuple<Test, arma::mat, arma::vec, arma::Mat<size_t>> u(Test(11, 14),
+      arma::mat(), arma::vec(), arma::Mat<size_t>(3, 3));
+  MappedFile file;
+  REQUIRE(data::LoadMapped("test.mmap", "t", u, file, false) == true);
+  REQUIRE(file.IsOpen());
+
+  const Test& y = std::get<0>(u);
+  REQUIRE(y.x == x.x);
+  REQUIRE(y.y == x.y);
+  REQUIRE(y.ina.c == x.ina.c);
+  REQUIRE(y.ina.s == x.ina.s);
+  REQUIRE(y.inb.c == x.inb.c);
+  REQUIRE(y.inb.s == x.inb.s);
+
+  CheckMatrices(std::get<1>(u), m);
+  CheckMatrices(std::get<2>(u), v);
+  REQUIRE(std::get<3>(u).n_elem == 0);
+  REQUIRE(file.Contains(std::get<1>(u).memptr()));
+  REQUIRE(file.Contains(std::get<2>(u).memptr()));
+
+  // Writing to a loaded matrix must not change the file.
+  std::get<1>(u).zeros();
+  MappedFile otherFile;
+  std::tuple<Test, arma::mat, arma::vec, arma::Mat<size_t>> w(Test(1, 2),
+      arma::mat(), arma::vec(), arma::Mat<size_t>());
+  REQUIRE(data::LoadMapped("test.mmap", "t", w, otherFile, false) == true);
+  CheckMatrices(std::get<1>(w), m);
+
+  // Resizing a loaded matrix gives it its own memory.
+  std::get<1>(w).resize(8, 300);
+  REQUIRE(!otherFile.Contains(std::get<1>(w).memptr()));
+
+  remove("test.mmap");
+}
+
+/**
+ * Make sure that LoadMapped() fails on files that were not saved with
+ * SaveMapped(), and on files that do not exist.
+ */
+TEST_CASE("LoadMappedWrongFileTest", "[LoadSaveTest]")
+{
+  Test x(10, 12);
+  REQUIRE(data::Save("test.bin", "x", x, false) == true);
+
+  Test y(11, 14);
+  MappedFile file;
+  REQUIRE(data::LoadMapped("test.bin", "x", y, file, false) == false);
+  REQUIRE(data::LoadMapped("nonexistent.mmap", "x", y, file, false) ==
+      false);
+  REQUIRE_THROWS_AS(data::LoadMapped("test.bin", "x", y, file, true),
+      std::runtime_error);
+
+  remove("test.bin");
+}
+
+/**
+ * Make sure a matrix saved with SaveMapped() is loaded without copying, with
+ * the right element type, in copy-on-write and read-only mode.
+ */
+TEMPLATE_TEST_CASE("LoadMappedMatrixTest", "[LoadSaveTest]", arma::mat,
+    arma::fmat, arma::Mat<size_t>)
+{
+  typedef TestType MatType;
+
+  MatType m = arma::randi<MatType>(13, 250, arma::distr_param(0, 1000));
+  REQUIRE(data::SaveMapped("test.mmat", m) == true);
+
+  MatType n(3, 3);
+  MappedFile file;
+  REQUIRE(data::LoadMapped("test.mmat", n, file) == true);
+  REQUIRE(!file.ReadOnly());
+  REQUIRE(file.Contains(n.memptr()));
+  CheckMatrices(n, m);
+
+  // Writing to the matrix must not change the file.
+  n.zeros();
+  MatType o;
+  MappedFile readOnlyFile;
+  REQUIRE(data::LoadMapped("test.mmat", o, readOnlyFile, false, true) ==
+      true);
+  REQUIRE(readOnlyFile.ReadOnly());
+  REQUIRE(readOnlyFile.Contains(o.memptr()));
+  CheckMatrices(o, m);
+
+  // Resizing the matrix gives it its own memory.
+  n.resize(14, 250);
+  REQUIRE(!file.Contains(n.memptr()));
+
+  remove("test.mmat");
+}
+
+/**
+ * Make sure LoadMapped() fails on matrices saved with another element type,
+ * and on files that were not saved with SaveMapped().
+ */
+TEST_CASE("LoadMappedMatrixWrongFileTest", "[LoadSaveTest]")
+{
+  arma::mat m = arma::randu<arma::mat>(5, 10);
+  REQUIRE(data::SaveMapped("test.mmat", m) == true);
+  REQUIRE(data::Save("test.bin", m) == true);
+
+  arma::fmat f;
+  arma::Mat<size_t> u;
+  arma::mat n;
+  MappedFile file;
+  REQUIRE(data::LoadMapped("test.mmat", f, file) == false);
+  REQUIRE(data::LoadMapped("test.mmat", u, file) == false);
+  REQUIRE(data::LoadMapped("test.bin", n, file) == false);
+  REQUIRE(data::LoadMapped("nonexistent.mmat", n, file) == false);
+  REQUIRE(!file.IsOpen());
+  REQUIRE_THROWS_AS(data::LoadMapped("test.mmat", f, file, true),
+      std::runtime_error);
+
+  remove("test.mmat");
+  remove("test.bin");
+}
+
+/**
+ * Make sure the fast conversion of tokens gives the same results as the
+ * conversion of token strings.
+ */
+TEST_CASE("ConvertTokenRangeTest", "[LoadSaveTest]")
+{
+  const std::vector<std::string> tokens = { "", "0", "-0", "7", "-12", "+3",
+      "0.5", "-0.125", ".5", "5.", "1e3", "1.5E-7", "2.5e+300", "1e-320",
+      "123456789012345678", "12345678901234567890", "0.1", "3.14159265358979",
+      "9007199254740993", "inf", "-Inf", "nan", " 4", "1.5abc", "1e", "-",
+      "abc" };
+
+  LoadCSV parser;
+  for (size_t i = 0; i < tokens.size(); ++i)
+  {
+    const char* begin = tokens[i].data();
+    const char* end = begin + tokens[i].size();
+
+    double d1 = 1.0, d2 = 1.0;
+    REQUIRE(parser.ConvertToken(d1, begin, end) ==
+        parser.ConvertToken(d2, tokens[i]));
+    REQUIRE(((d1 == d2) || (std::isnan(d1) && std::isnan(d2))));
+
+    float f1 = 1.0f, f2 = 1.0f;
+    REQUIRE(parser.ConvertToken(f1, begin, end) ==
+        parser.ConvertToken(f2, tokens[i]));
+    REQUIRE(((f1 == f2) || (std::isnan(f1) && std::isnan(f2))));
+
+    int i1 = 1, i2 = 1;
+    REQUIRE(parser.ConvertToken(i1, begin, end) ==
+        parser.ConvertToken(i2, tokens[i]));
+    REQUIRE(i1 == i2);
+
+    size_t s1 = 1, s2 = 1;
+    REQUIRE(parser.ConvertToken(s1, begin, end) ==
+        parser.ConvertToken(s2, tokens[i]));
+    REQUIRE(s1 == s2);
+  }
+}
+
+/**
+ * Make sure that a numeric CSV large enough to be parsed in several chunks is
+ * loaded correctly, transposed or not.
+ */
+TEST_CASE("ParallelNumericCSVLoadTest", "[LoadSaveTest]")
+{
+  // About 4MB of data, with numbers written in several ways.
+  arma::mat expected(5, 80000);
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+  for (size_t i = 0; i < expected.n_cols; ++i)
+  {
+    std::ostringstream oss;
+    oss.precision(17);
+    oss << i << "," << (0.001 * i) << "," << -((double) i / 7) << ","
+        << (i % 13) << "e-3," << ((i % 2 == 0) ? "inf" : "-2.5");
+    f << oss.str() << "\r" << endl;
+
+    std::istringstream iss(oss.str());
+    std::string token;
+    for (size_t j = 0; j < expected.n_rows; ++j)
+    {
+      std::getline(iss, token, ',');
+      expected(j, i) = (token == "inf") ?
+          std::numeric_limits<double>::infinity() :
+          std::strtod(token.c_str(), NULL);
+    }
+  }
+  f.close();
+
+  arma::mat dataset;
+  REQUIRE(data::Load("test_file.csv", dataset) == true);
+  REQUIRE(dataset.n_rows == expected.n_rows);
+  REQUIRE(dataset.n_cols == expected.n_cols);
+  REQUIRE(arma::all(arma::vectorise(dataset == expected)));
+
+  REQUIRE(data::Load("test_file.csv", dataset, false, false) == true);
+  REQUIRE(dataset.n_rows == expected.n_cols);
+  REQUIRE(dataset.n_cols == expected.n_rows);
+  REQUIRE(arma::all(arma::vectorise(dataset == expected.t())));
+
+  remove("test_file.csv");
+}
+
+/**
+ * Make sure that the categories of a CSV large enough to be parsed in several
+ * chunks are mapped in order of first appearance.
+ */
+TEST_CASE("ParallelCategoricalCSVLoadTest", "[LoadSaveTest]")
+{
+  const std::vector<std::string> names = { "red", "green", "blue", "cyan",
+      "magenta", "yellow", "black" };
+
+  // About 3MB of data; the last categories first appear at the end.
+  const size_t points = 120000;
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+  for (size_t i = 0; i < points; ++i)
+  {
+    const size_t category = (i < points - 2) ? (i * 3) % 5 : 5 + (i % 2);
+    f << i << ", " << names[category] << ", " << (i % 10) << endl;
+  }
+  f.close();
+
+  arma::mat dataset;
+  data::DatasetInfo info;
+  REQUIRE(data::Load("test_file.csv", dataset, info, true) == true);
+
+  REQUIRE(dataset.n_rows == 3);
+  REQUIRE(dataset.n_cols == points);
+  REQUIRE(info.Type(0) == Datatype::numeric);
+  REQUIRE(info.Type(1) == Datatype::categorical);
+  REQUIRE(info.Type(2) == Datatype::numeric);
+  REQUIRE(info.NumMappings(1) == 7);
+
+  // The first appearances are in the order 0, 3, 1, 4, 2, then 5 and 6.
+  const size_t order[] = { 0, 3, 1, 4, 2, 5, 6 };
+  for (size_t i = 0; i < 7; ++i)
+    REQUIRE(info.UnmapString(i, 1) == names[order[i]]);
+
+  for (size_t i = 0; i < points; ++i)
+  {
+    const size_t category = (i < points - 2) ? (i * 3) % 5 : 5 + (i % 2);
+    REQUIRE(dataset(0, i) == (double) i);
+    REQUIRE(info.UnmapString(dataset(1, i), 1) == names[category]);
+    REQUIRE(dataset(2, i) == (double) (i % 10));
+  }
+
+  remove("test_file.csv");
+}
+
+/**
+ * Make sure that numeric dimensions stay numeric when a categorical CSV is
+ * loaded in parallel, and that a dimension with a single non-numeric token
+ * becomes categorical, with its numbers mapped in order of first appearance.
+ */
+TEST_CASE("ParallelCategoricalCSVNumbersTest", "[LoadSaveTest]")
+{
+  // About 3MB of data; the only non-numeric token of dimension 2 is at the
+  // end.
+  const size_t points = 100000;
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+  for (size_t i = 0; i < points; ++i)
+  {
+    f << (i % 8) * 0.125 << ", " << ((i % 2) ? "+" : "-") << (i % 100)
+        << "e-2, ";
+    if (i < points - 1)
+      f << (i % 3);
+    else
+      f << "n/a";
+    f << ", " << ((i % 2) ? "a" : "b") << endl;
+  }
+  f.close();
+
+  arma::mat dataset;
+  data::DatasetInfo info;
+  REQUIRE(data::Load("test_file.csv", dataset, info, true) == true);
+
+  REQUIRE(dataset.n_rows == 4);
+  REQUIRE(dataset.n_cols == points);
+  REQUIRE(info.Type(0) == Datatype::numeric);
+  REQUIRE(info.Type(1) == Datatype::numeric);
+  REQUIRE(info.Type(2) == Datatype::categorical);
+  REQUIRE(info.Type(3) == Datatype::categorical);
+  REQUIRE(info.NumMappings(0) == 0);
+  REQUIRE(info.NumMappings(1) == 0);
+  REQUIRE(info.NumMappings(2) == 4);
+  REQUIRE(info.NumMappings(3) == 2);
+
+  REQUIRE(info.UnmapString(0, 2) == "0");
+  REQUIRE(info.UnmapString(1, 2) == "1");
+  REQUIRE(info.UnmapString(2, 2) == "2");
+  REQUIRE(info.UnmapString(3, 2) == "n/a");
+
+  for (size_t i = 0; i < points; ++i)
+  {
+    const double sign = (i % 2) ? 1.0 : -1.0;
+    REQUIRE(dataset(0, i) == (i % 8) * 0.125);
+    REQUIRE(dataset(1, i) == sign * (double) (i % 100) / 100.0);
+    REQUIRE(dataset(2, i) == ((i < points - 1) ? (double) (i % 3) : 3.0));
+    REQUIRE(dataset(3, i) == (double) (i % 2));
+  }
+
+  remove("test_file.csv");
+}
+
+/**
+ * Make sure that a wide categorical CSV loaded without transposing (so that
+ * each line is a dimension) gives the same mappings as mapping every token in
+ * order.
+ */
+TEST_CASE("ParallelCategoricalCSVNonTransposedTest", "[LoadSaveTest]")
+{
+  const size_t lines = 3000;
+  const size_t tokens = 200;
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+  for (size_t l = 0; l < lines; ++l)
+  {
+    for (size_t t = 0; t < tokens; ++t)
+    {
+      // Every third line is numeric.
+      if (l % 3 == 0)
+        f << (l + t);
+      else
+        f << "c" << ((l + 7 * t) % 11);
+      f << ((t < tokens - 1) ? "," : "\n");
+    }
+  }
+  f.close();
+
+  arma::mat dataset;
+  data::DatasetInfo info;
+  REQUIRE(data::Load("test_file.csv", dataset, info, true, false) == true);
+
+  REQUIRE(dataset.n_rows == lines);
+  REQUIRE(dataset.n_cols == tokens);
+  REQUIRE(info.Dimensionality() == lines);
+
+  data::DatasetInfo expected(lines);
+  for (size_t l = 0; l < lines; ++l)
+  {
+    if (l % 3 == 0)
+    {
+      REQUIRE(info.Type(l) == Datatype::numeric);
+      for (size_t t = 0; t < tokens; ++t)
+        REQUIRE(dataset(l, t) == (double) (l + t));
+      continue;
+    }
+
+    REQUIRE(info.Type(l) == Datatype::categorical);
+    for (size_t t = 0; t < tokens; ++t)
+    {
+      const std::string token = "c" + std::to_string((l + 7 * t) % 11);
+      REQUIRE(dataset(l, t) == expected.MapString<double>(token, l));
+    }
+    REQUIRE(info.NumMappings(l) == expected.NumMappings(l));
+  }
+
+  remove("test_file.csv");
+}
+
+/**
+ * Make sure that DatasetMapper::MapDimensions() maps each dimension as mapping
+ * them one at a time would, and only creates mappings for categorical
+ * dimensions.
+ */
+TEST_CASE("DatasetMapperMapDimensionsTest", "[LoadSaveTest]")
+{
+  const size_t dimensionality = 100;
+  data::DatasetInfo info(dimensionality);
+  arma::mat values(dimensionality, 20);
+
+  info.MapDimensions([&](const size_t d)
+  {
+    for (size_t i = 0; i < values.n_cols; ++i)
+    {
+      // Odd dimensions are categorical.
+      const std::string token = (d % 2) ? "s" + std::to_string((i * d) % 7) :
+          std::to_string(i);
+      info.MapFirstPass<double>(token, d);
+      values(d, i) = info.MapString<double>(token, d);
+    }
+  });
+
+  data::DatasetInfo expected(dimensionality);
+  for (size_t d = 0; d < dimensionality; ++d)
+  {
+    REQUIRE(info.Type(d) == ((d % 2) ? Datatype::categorical :
+        Datatype::numeric));
+    for (size_t i = 0; i < values.n_cols; ++i)
+    {
+      const std::string token = (d % 2) ? "s" + std::to_string((i * d) % 7) :
+          std::to_string(i);
+      expected.MapFirstPass<double>(token, d);
+      REQUIRE(values(d, i) == expected.MapString<double>(token, d));
+    }
+    REQUIRE(info.NumMappings(d) == expected.NumMappings(d));
+  }
+
+  // Exceptions are thrown after all the dimensions are mapped.
+  REQUIRE_THROWS_AS(info.MapDimensions([](const size_t d)
+  {
+    if (d == 10)
+      throw std::invalid_argument("dimension 10");
+  }), std::invalid_argument);
+}
+
+/**
+ * Make sure that a CSV with a header is loaded correctly in chunks, and that
+ * it can be loaded again after Reset().
+ */
+TEST_CASE("ChunkedLoaderCSVTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+
+  f << "a, b, c" << endl;
+  for (size_t i = 0; i < 10; ++i)
+  {
+    f << 3 * i << ", " << 3 * i + 1 << ", " << 3 * i + 2 << endl;
+    if (i == 4)
+      f << endl; // Empty lines are skipped.
+  }
+
+  f.close();
+
+  data::ChunkedLoader loader("test_file.csv", 4);
+  REQUIRE(loader.Dimensionality() == 3);
+  REQUIRE(loader.ChunkSize() == 4);
+
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    loader.Reset();
+    arma::mat chunk;
+    std::vector<size_t> chunkSizes;
+    size_t value = 0;
+    while (loader.Next(chunk))
+    {
+      REQUIRE(chunk.n_rows == 3);
+      chunkSizes.push_back(chunk.n_cols);
+      for (size_t i = 0; i < chunk.n_elem; ++i, ++value)
+        REQUIRE(chunk[i] == Approx((double) value).epsilon(1e-7));
+    }
+
+    REQUIRE(chunk.n_elem == 0);
+    REQUIRE(loader.PointsRead() == 10);
+    REQUIRE(chunkSizes.size() == 3);
+    REQUIRE(chunkSizes[0] == 4);
+    REQUIRE(chunkSizes[1] == 4);
+    REQUIRE(chunkSizes[2] == 2);
+  }
+
+  remove("test_file.csv");
+}
+
+/**
+ * Make sure that whitespace-separated files are loaded in chunks, and that
+ * malformed files are rejected.
+ */
+TEST_CASE("ChunkedLoaderTXTTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_file.txt", fstream::out);
+  f << "1 2\t 3" << endl;
+  f << "  4 5 6  " << endl;
+  f.close();
+
+  data::ChunkedLoader loader("test_file.txt", 100);
+  arma::fmat chunk;
+  REQUIRE(loader.Next(chunk));
+  REQUIRE(chunk.n_rows == 3);
+  REQUIRE(chunk.n_cols == 2);
+  for (size_t i = 0; i < 6; ++i)
+    REQUIRE(chunk[i] == Approx((float) (i + 1)).epsilon(1e-5));
+  REQUIRE(!loader.Next(chunk));
+
+  // A point with the wrong number of dimensions.
+  f.open("test_file.txt", fstream::out);
+  f << "1 2 3" << endl;
+  f << "4 5" << endl;
+  f.close();
+
+  data::ChunkedLoader badLoader("test_file.txt", 100);
+  REQUIRE_THROWS_AS(badLoader.Next(chunk), std::runtime_error);
+
+  // Headers are only allowed in CSVs.
+  f.open("test_file.txt", fstream::out);
+  f << "a b c" << endl;
+  f << "1 2 3" << endl;
+  f.close();
+
+  REQUIRE_THROWS_AS(data::ChunkedLoader("test_file.txt", 100),
+      std::runtime_error);
+  REQUIRE_THROWS_AS(data::ChunkedLoader("nonexistent.csv", 100),
+      std::runtime_error);
+  REQUIRE_THROWS_AS(data::ChunkedLoader("test_file.bin", 100),
+      std::runtime_error);
+
+  remove("test_file.txt");
+}
+
+/**
+ * Make sure ChunkedLoader maps the tokens of categorical dimensions in the same
+ * way in every chunk.
+ */
+TEST_CASE("ChunkedLoaderCategoricalTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+  f << "b, 1, 2" << endl;
+  f << "a, 3, x" << endl;
+  f << "b, 5, 6" << endl;
+  f << "c, 7, 2" << endl;
+  f.close();
+
+  data::DatasetInfo info;
+  data::ChunkedLoader loader("test_file.csv", 2, info);
+  REQUIRE(loader.Dimensionality() == 3);
+  REQUIRE(info.Dimensionality() == 3);
+  REQUIRE(info.Type(0) == data::Datatype::categorical);
+  REQUIRE(info.Type(1) == data::Datatype::numeric);
+  REQUIRE(info.Type(2) == data::Datatype::categorical);
+  REQUIRE(info.NumMappings(0) == 3);
+  REQUIRE(info.NumMappings(2) == 3);
+
+  // The dataset is read twice, to make sure the mappings do not change.
+  arma::mat m(3, 4), chunk;
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    loader.Reset();
+    REQUIRE(loader.Next(chunk));
+    REQUIRE(chunk.n_cols == 2);
+    m.cols(0, 1) = chunk;
+    REQUIRE(loader.Next(chunk));
+    REQUIRE(chunk.n_cols == 2);
+    m.cols(2, 3) = chunk;
+    REQUIRE(!loader.Next(chunk));
+
+    REQUIRE(m(0, 0) == 0);
+    REQUIRE(m(0, 1) == 1);
+    REQUIRE(m(0, 2) == 0);
+    REQUIRE(m(0, 3) == 2);
+    for (size_t i = 0; i < 4; ++i)
+      REQUIRE(m(1, i) == Approx(2 * i + 1).epsilon(1e-7));
+    REQUIRE(m(2, 0) == 0);
+    REQUIRE(m(2, 1) == 1);
+    REQUIRE(m(2, 2) == 2);
+    REQUIRE(m(2, 3) == 0);
+  }
+
+  remove("test_file.csv");
+}
+
+/**
+ * Make sure ChunkedReader reads the same points from text, Armadillo binary,
+ * and mapped files, with and without prefetching.
+ */
+TEST_CASE("ChunkedReaderTest", "[LoadSaveTest]")
+{
+  arma::mat m = arma::randi<arma::mat>(5, 103, arma::distr_param(-50, 50));
+  arma::Mat<size_t> u = arma::randi<arma::Mat<size_t>>(4, 57,
+      arma::distr_param(0, 100));
+  REQUIRE(data::Save("test_file.csv", m) == true);
+  REQUIRE(data::Save("test_file.bin", m) == true);
+  REQUIRE(data::SaveMapped("test_file.mmat", m) == true);
+  REQUIRE(data::Save("test_file_u.bin", u) == true);
+
+  const std::vector<std::string> files = { "test_file.csv", "test_file.bin",
+      "test_file.mmat" };
+  for (size_t f = 0; f < files.size(); ++f)
+  {
+    for (const bool prefetch : { false, true })
+    {
+      data::ChunkedReader<> reader(files[f], 10, prefetch);
+      REQUIRE(reader.Dimensionality() == 5);
+      REQUIRE(reader.Info().Dimensionality() == 5);
+      REQUIRE(reader.Info().Type(0) == data::Datatype::numeric);
+
+      for (size_t pass = 0; pass < 2; ++pass)
+      {
+        reader.Reset();
+        arma::mat points, chunk;
+        while (reader.Next(chunk))
+        {
+          REQUIRE(chunk.n_cols <= 10);
+          points = arma::join_rows(points, chunk);
+        }
+
+        REQUIRE(reader.PointsRead() == 103);
+        CheckMatrices(points, m);
+      }
+
+      // Stop in the middle of a pass; the next pass starts from the first
+      // point.
+      arma::mat chunk;
+      reader.Reset();
+      REQUIRE(reader.Next(chunk));
+      reader.Reset();
+      REQUIRE(reader.Next(chunk));
+      CheckMatrices(chunk, m.cols(0, 9));
+    }
+  }
+
+  // Elements are converted to the element type of the chunks.
+  data::ChunkedReader<arma::fmat> reader("test_file_u.bin", 20, true);
+  arma::Mat<size_t> points, chunk;
+  while (reader.Next(chunk))
+    points = arma::join_rows(points, chunk);
+  CheckMatrices(points, u);
+
+  REQUIRE_THROWS_AS(data::ChunkedReader<>("test_file.csv", 0),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(data::ChunkedReader<>("nonexistent.bin", 10),
+      std::runtime_error);
+
+  // Files of other types cannot be read in chunks.
+  fstream f;
+  f.open("test_file.dat", fstream::out);
+  f << "not a matrix" << endl;
+  f.close();
+  REQUIRE_THROWS_AS(data::ChunkedReader<>("test_file.dat", 10),
+      std::runtime_error);
+
+  remove("test_file.csv");
+  remove("test_file.bin");
+  remove("test_file.mmat");
+  remove("test_file_u.bin");
+  remove("test_file.dat");
+}
+
+/**
+ * Make sure that the PrefetchingLoader gives every shard in order, passes
+ * them through the transform, and gives the errors of the reader.
+ */
+TEST_CASE("PrefetchingLoaderTest", "[LoadSaveTest]")
+{
+  auto reader = [](const size_t i, arma::mat& predictors, arma::mat& responses)
+  {
+    if (i == 100)
+      throw std::runtime_error("cannot read shard");
+
+    predictors.set_size(2, i + 1);
+    predictors.fill(i);
+    responses.zeros(1, i + 1);
+  };
+  auto transform = [](arma::mat& /* predictors */, arma::mat& responses)
+  {
+    responses += 1;
+  };
+
+  data::PrefetchingLoader<arma::mat> loader(7, reader, 3, 3, transform);
+  REQUIRE(loader.NumShards() == 7);
+
+  arma::mat predictors, responses;
+  for (size_t pass = 0; pass < 3; ++pass)
+  {
+    loader.Reset();
+    // Stop the second pass early.
+    const size_t shards = (pass == 1) ? 2 : 7;
+    for (size_t i = 0; i < shards; ++i)
+    {
+      REQUIRE(loader.Next(predictors, responses));
+      REQUIRE(predictors.n_cols == i + 1);
+      REQUIRE(arma::all(arma::vectorise(predictors) == double(i)));
+      REQUIRE(arma::all(arma::vectorise(responses) == 1.0));
+    }
+
+    if (pass != 1)
+      REQUIRE(!loader.Next(predictors, responses));
+  }
+
+  // The error of a reader is given by Next().
+  data::PrefetchingLoader<arma::mat> badLoader(101, reader, 2, 4);
+  for (size_t i = 0; i < 100; ++i)
+    REQUIRE(badLoader.Next(predictors, responses));
+  REQUIRE_THROWS_AS(badLoader.Next(predictors, responses), std::runtime_error);
+  REQUIRE(!badLoader.Next(predictors, responses));
+
+  REQUIRE_THROWS_AS(data::PrefetchingLoader<arma::mat>(7, reader, 3, 2),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(data::PrefetchingLoader<arma::mat>::FileReader(
+      std::vector<std::string>(2), std::vector<std::string>(1)),
+      std::invalid_argument);
+}
+
 /**
  * Test DatasetInfo by making a map for a dimension.
  */
@@ -118,6 +118,54 @@ TEST_CASE("LocalCoordinateCodingTestDictionaryStep",
   REQUIRE(norm(grad, "fro") == Approx(0.0).margin(tol));
 }
 
+/**
+ * Make sure that the dictionary step is correct for the active atoms when some
+ * atoms are not used by the codes.
+ */
+TEST_CASE("LocalCoordinateCodingTestDictionaryStepInactiveAtoms",
+          "[LocalCoordinateCodingTest]")
+{
+  const double tol = 0.1;
+
+  double lambda = 0.1;
+  uword nAtoms = 10;
+
+  mat X;
+  X.load("mnist_first250_training_4s_and_9s.arm");
+  uword nPoints = X.n_cols;
+
+  // normalize each point since these are images
+  for (uword i = 0; i < nPoints; ++i)
+  {
+    X.col(i) /= norm(X.col(i), 2);
+  }
+
+  mat Z;
+  LocalCoordinateCoding lcc(X, nAtoms, lambda, 10);
+  lcc.Encode(X, Z);
+
+  // Make the first two atoms inactive.
+  Z.rows(0, 1).zeros();
+  uvec adjacencies = find(Z);
+  lcc.OptimizeDictionary(X, Z, adjacencies);
+
+  mat D = lcc.Dictionary();
+
+  mat grad = zeros(D.n_rows, D.n_cols);
+  for (uword i = 0; i < nPoints; ++i)
+  {
+    grad += (D - repmat(X.unsafe_col(i), 1, nAtoms)) *
+        diagmat(abs(Z.unsafe_col(i)));
+  }
+  grad = lambda * grad + (D * Z - X) * trans(Z);
+
+  // The inactive atoms are reinitialized; the gradient of the active atoms
+  // must vanish.
+  REQUIRE(norm(grad.cols(2, nAtoms - 1), "fro") == Approx(0.0).margin(tol));
+  for (uword j = 0; j < 2; ++j)
+    REQUIRE(norm(D.col(j), 2) == Approx(1.0).epsilon(1e-5));
+}
+
 TEST_CASE("LocalCoordinateCodingSerializationTest",
           "[LocalCoordinateCodingTest]")
 {
@@ -832,6 +832,85 @@ TEST_CASE("LogisticRegressionSparseSGDTest", "[LogisticRegressionTest]")
         Approx(lrSparse.Parameters()[i]).epsilon(1e-5));
 }
 
+/**
+ * Make sure that the full-batch objective and gradient, which are computed in
+ * parallel over blocks of points, are the same for sparse and dense data, and
+ * are the sum of the separable objectives and gradients.
+ */
+TEST_CASE("LogisticRegressionFunctionSparseParallelTest",
+          "[LogisticRegressionTest]")
+{
+  // Enough points for several blocks.
+  arma::sp_mat dataset;
+  dataset.sprandu(50, 2500, 0.05);
+  arma::mat denseDataset(dataset);
+  arma::Row<size_t> labels(2500);
+  for (size_t i = 0; i < 2500; ++i)
+    labels[i] = RandInt(0, 2);
+
+  LogisticRegressionFunction<arma::sp_mat> lrf(dataset, labels, 0.5);
+  LogisticRegressionFunction<> denseLrf(denseDataset, labels, 0.5);
+
+  const arma::rowvec parameters = arma::randn<arma::rowvec>(51);
+
+  const double objective = lrf.Evaluate(parameters);
+  REQUIRE(objective == Approx(denseLrf.Evaluate(parameters)).epsilon(1e-8));
+
+  double separableObjective = 0.0;
+  arma::rowvec separableGradient(51, arma::fill::zeros), batchGradient;
+  for (size_t i = 0; i < 2500; i += 100)
+  {
+    separableObjective += denseLrf.Evaluate(parameters, i, 100);
+    denseLrf.Gradient(parameters, i, batchGradient, 100);
+    separableGradient += batchGradient;
+  }
+  REQUIRE(objective == Approx(separableObjective).epsilon(1e-8));
+
+  arma::rowvec gradient, denseGradient, evaluateGradient;
+  lrf.Gradient(parameters, gradient);
+  denseLrf.Gradient(parameters, denseGradient);
+  const double evaluateObjective = lrf.EvaluateWithGradient(parameters,
+      evaluateGradient);
+
+  REQUIRE(evaluateObjective == Approx(objective).epsilon(1e-8));
+  REQUIRE(gradient.n_elem == 51);
+  REQUIRE(arma::approx_equal(gradient, denseGradient, "absdiff", 1e-8));
+  REQUIRE(arma::approx_equal(gradient, evaluateGradient, "absdiff", 1e-8));
+  REQUIRE(arma::approx_equal(gradient, separableGradient, "absdiff", 1e-8));
+}
+
+/**
+ * Make sure that a model trained on sparse data can compute its error and
+ * accuracy and class probabilities like a model trained on dense data.
+ */
+TEST_CASE("LogisticRegressionSparseClassifyTest", "[LogisticRegressionTest]")
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(10, 800, 0.3);
+  arma::mat denseDataset(dataset);
+  arma::Row<size_t> labels(800);
+  for (size_t i = 0; i < 800; ++i)
+    labels[i] = RandInt(0, 2);
+
+  LogisticRegression<> lr(denseDataset, labels, 0.3);
+  LogisticRegression<arma::sp_mat> lrSparse(10, 0.3);
+  lrSparse.Parameters() = lr.Parameters();
+
+  REQUIRE(lrSparse.ComputeError(dataset, labels) ==
+      Approx(lr.ComputeError(denseDataset, labels)).epsilon(1e-8));
+  REQUIRE(lrSparse.ComputeAccuracy(dataset, labels) ==
+      Approx(lr.ComputeAccuracy(denseDataset, labels)));
+
+  arma::Row<size_t> predictions, sparsePredictions;
+  arma::mat probabilities, sparseProbabilities;
+  lr.Classify(denseDataset, predictions, probabilities);
+  lrSparse.Classify(dataset, sparsePredictions, sparseProbabilities);
+
+  REQUIRE(arma::all(predictions == sparsePredictions));
+  REQUIRE(arma::approx_equal(probabilities, sparseProbabilities, "absdiff",
+      1e-10));
+}
+
 /**
  * Test multi-point classification (Classify()).
  */
@@ -848,6 +848,38 @@ TEST_CASE("ParallelMonochromatic", "[LSHTest]")
       sequentialNeighbors, parallelNeighbors);
   REQUIRE(recall == 1);
 }
+
+/**
+ * Test: parallel multiprobe search over several blocks of queries must return
+ * the same neighbors and count the same number of candidates as sequential
+ * search.
+ */
+TEST_CASE("ParallelMultiprobeCandidateCount", "[LSHTest]")
+{
+  arma::mat rdata(4, 2000, arma::fill::randu);
+  arma::mat qdata(4, 2500, arma::fill::randu);
+
+  LSHSearch<> lshTest(rdata, 5, 8, 0.3);
+
+  arma::Mat<size_t> sequentialNeighbors, parallelNeighbors;
+  arma::mat sequentialDistances, parallelDistances;
+
+  lshTest.DistanceEvaluations() = 0;
+  lshTest.Search(qdata, 3, parallelNeighbors, parallelDistances, 0, 6);
+  const size_t parallelEvaluations = lshTest.DistanceEvaluations();
+
+  size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  lshTest.DistanceEvaluations() = 0;
+  lshTest.Search(qdata, 3, sequentialNeighbors, sequentialDistances, 0, 6);
+  const size_t sequentialEvaluations = lshTest.DistanceEvaluations();
+  omp_set_num_threads(prevNumThreads);
+
+  REQUIRE(parallelEvaluations > 0);
+  REQUIRE(parallelEvaluations == sequentialEvaluations);
+  CheckMatrices(parallelNeighbors, sequentialNeighbors);
+  CheckMatrices(parallelDistances, sequentialDistances);
+}
 #endif
 
 // Test the copy constructor and the copy operator.
@@ -989,3 +1021,214 @@ TEST_CASE("SparseLSHTest", "[LSHTest]")
     REQUIRE(!std::isnan(sparseDistances[i]));
   }
 }
+
+/**
+ * Make sure that the second hash table is laid out contiguously, that every
+ * bucket respects the maximum bucket size, and that every point is stored at
+ * most once per table.
+ */
+TEST_CASE("LSHBucketLayoutTest", "[LSHTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 1000);
+  const size_t numTables = 5;
+  const size_t secondHashSize = 101;
+  const size_t bucketSize = 40;
+
+  LSHSearch<> lsh(referenceData, 3, numTables, 0.5, secondHashSize,
+      bucketSize);
+
+  const arma::Col<size_t>& offsets = lsh.BucketOffsets();
+  const arma::Col<arma::u32>& contents = lsh.BucketContents();
+
+  REQUIRE(offsets.n_elem == secondHashSize + 1);
+  REQUIRE(offsets[0] == 0);
+  REQUIRE(offsets[secondHashSize] == contents.n_elem);
+  for (size_t i = 0; i < secondHashSize; ++i)
+  {
+    REQUIRE(offsets[i + 1] >= offsets[i]);
+    REQUIRE(offsets[i + 1] - offsets[i] <= bucketSize);
+  }
+
+  arma::Col<size_t> counts(referenceData.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < contents.n_elem; ++i)
+  {
+    REQUIRE(contents[i] < referenceData.n_cols);
+    counts[contents[i]]++;
+  }
+
+  REQUIRE(counts.max() <= numTables);
+}
+
+/**
+ * Make sure that inserting points into a trained model gives the same results
+ * as training on all of the points at once.
+ */
+TEST_CASE("LSHInsertTest", "[LSHTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 600);
+  arma::mat newData = arma::randu<arma::mat>(4, 150);
+  arma::mat queryData = arma::randu<arma::mat>(4, 50);
+  arma::cube projections = arma::randn<arma::cube>(4, 3, 6);
+
+  RandomSeed(42);
+  LSHSearch<> lsh(referenceData, projections, 0.5, 997, 0);
+  lsh.Insert(newData.cols(0, 49));
+  lsh.Insert(newData.cols(50, 149));
+
+  RandomSeed(42);
+  LSHSearch<> fullLsh(arma::join_rows(referenceData, newData), projections,
+      0.5, 997, 0);
+
+  REQUIRE(lsh.ReferenceSet().n_cols == 750);
+  REQUIRE(arma::accu(lsh.BucketSizes()) ==
+      arma::accu(fullLsh.BucketSizes()));
+
+  arma::Mat<size_t> neighbors, fullNeighbors;
+  arma::mat distances, fullDistances;
+  lsh.Search(queryData, 5, neighbors, distances);
+  fullLsh.Search(queryData, 5, fullNeighbors, fullDistances);
+
+  CheckMatrices(neighbors, fullNeighbors);
+  CheckMatrices(distances, fullDistances);
+
+  // Every bucket must still respect the maximum bucket size.
+  LSHSearch<> smallLsh(referenceData, 3, 4, 0.5, 101, 20);
+  smallLsh.Insert(newData);
+  REQUIRE(smallLsh.BucketSizes().max() <= 20);
+  for (size_t i = 0; i < 101; ++i)
+  {
+    REQUIRE(smallLsh.BucketSizes()[i] <=
+        smallLsh.BucketOffsets()[i + 1] - smallLsh.BucketOffsets()[i]);
+  }
+
+  // Points with the wrong dimensionality can't be inserted.
+  arma::mat wrongData = arma::randu<arma::mat>(5, 10);
+  REQUIRE_THROWS_AS(lsh.Insert(wrongData), std::invalid_argument);
+}
+
+/**
+ * Make sure that removed points are never returned, and that compacting the
+ * model gives the same results as training on the remaining points.
+ */
+TEST_CASE("LSHRemoveTest", "[LSHTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 600);
+  arma::mat queryData = arma::randu<arma::mat>(4, 50);
+  arma::cube projections = arma::randn<arma::cube>(4, 3, 6);
+
+  // Remove every third point.
+  arma::uvec removed = arma::regspace<arma::uvec>(0, 3, 599);
+  arma::uvec kept(400);
+  for (size_t i = 0, j = 0; i < 600; ++i)
+    if (i % 3 != 0)
+      kept[j++] = i;
+
+  RandomSeed(42);
+  LSHSearch<> lsh(referenceData, projections, 0.5, 997, 0);
+  lsh.Remove(removed);
+  REQUIRE(lsh.NumRemoved() == 200);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  lsh.Search(queryData, 5, neighbors, distances);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+    REQUIRE((neighbors[i] == 600 || neighbors[i] % 3 != 0));
+
+  // Monochromatic search does not return results for removed points.
+  lsh.Search(3, neighbors, distances);
+  for (size_t i = 0; i < 600; i += 3)
+    REQUIRE(neighbors(0, i) == 600);
+
+  RandomSeed(42);
+  LSHSearch<> keptLsh(referenceData.cols(kept), projections, 0.5, 997, 0);
+
+  lsh.Compact();
+  REQUIRE(lsh.NumRemoved() == 0);
+  REQUIRE(lsh.ReferenceSet().n_cols == 400);
+  CheckMatrices(lsh.ReferenceSet(), keptLsh.ReferenceSet());
+  CheckMatrices(lsh.BucketOffsets(), keptLsh.BucketOffsets());
+
+  arma::Mat<size_t> keptNeighbors;
+  arma::mat keptDistances;
+  lsh.Search(queryData, 5, neighbors, distances);
+  keptLsh.Search(queryData, 5, keptNeighbors, keptDistances);
+  CheckMatrices(neighbors, keptNeighbors);
+  CheckMatrices(distances, keptDistances);
+
+  // Invalid indices can't be removed.
+  REQUIRE_THROWS_AS(lsh.Remove(arma::uvec({ 400 })), std::invalid_argument);
+}
+
+/**
+ * Make sure that bit-sampling LSH on packed binary codes finds the nearest
+ * neighbors of most queries, that multiprobe only improves the results, and
+ * that user-defined bit indices are checked.
+ */
+TEST_CASE("BitSamplingLSHTest", "[LSHTest]")
+{
+  // Clustered 256-bit codes; each query is a noisy copy of a cluster center.
+  arma::mat centers = arma::round(arma::randu<arma::mat>(256, 10));
+  arma::mat codes(256, 2000), queryCodes(256, 100);
+  for (size_t i = 0; i < codes.n_cols + queryCodes.n_cols; ++i)
+  {
+    arma::subview_col<double> code = (i < codes.n_cols) ? codes.col(i) :
+        queryCodes.col(i - codes.n_cols);
+    code = centers.col(i % centers.n_cols);
+    for (size_t j = 0; j < 20; ++j)
+    {
+      const size_t bit = RandInt(code.n_rows);
+      code[bit] = 1 - code[bit];
+    }
+  }
+
+  arma::mat packed, packedQueries;
+  data::PackBinary(codes, packed);
+  data::PackBinary(queryCodes, packedQueries);
+
+  NeighborSearch<NearestNeighborSort, HammingDistance> naive(packed,
+      NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  naive.Search(packedQueries, 1, trueNeighbors, trueDistances);
+
+  typedef LSHSearch<NearestNeighborSort, arma::mat, HammingDistance>
+      HammingLSH;
+  HammingLSH lsh(packed, 10, 20);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  lsh.Search(packedQueries, 1, neighbors, distances);
+
+  // Ties are likely, so compare the distances.
+  size_t found = 0;
+  for (size_t i = 0; i < packedQueries.n_cols; ++i)
+  {
+    if (distances(0, i) == trueDistances(0, i))
+      ++found;
+    if (neighbors(0, i) < packed.n_cols)
+    {
+      REQUIRE(distances(0, i) == arma::accu(queryCodes.col(i) !=
+          codes.col(neighbors(0, i))));
+    }
+  }
+  REQUIRE(found >= 90);
+
+  // With one table, additional probes can only find closer neighbors.
+  HammingLSH singleTable(packed, 10, 1);
+  arma::mat probedDistances;
+  singleTable.Search(packedQueries, 1, neighbors, distances);
+  singleTable.Search(packedQueries, 1, neighbors, probedDistances, 0, 10);
+  for (size_t i = 0; i < packedQueries.n_cols; ++i)
+    REQUIRE(probedDistances(0, i) <= distances(0, i));
+
+  // Bit indices given by the user.
+  arma::cube bits(1, 10, 4);
+  for (size_t i = 0; i < bits.n_elem; ++i)
+    bits[i] = (double) (i * 5);
+  HammingLSH userBits(packed, bits);
+  REQUIRE(arma::approx_equal(userBits.Projections(), bits, "absdiff", 0.0));
+
+  arma::cube badBits(1, 10, 4);
+  badBits.fill(1000);
+  REQUIRE_THROWS_AS(HammingLSH(packed, badBits), std::invalid_argument);
+}
@@ -44,3 +44,52 @@ TEST_CASE_METHOD(GmmProbabilityTestFixture, "GmmProbabilityDimensionality",
   // Avoid double free (the fixture will try to delete the input model).
   params.Get<GMM*>("input_model") = NULL;
 }
+
+// Make sure the component log-probabilities are consistent with the
+// probabilities, and that single precision gives nearly the same results.
+TEST_CASE_METHOD(GmmProbabilityTestFixture, "GmmProbabilityComponentOutput",
+                 "[GmmProbabilityMainTest][BindingTests]")
+{
+  arma::mat inputData(3, 200, arma::fill::randu);
+
+  GMM gmm(2, 3);
+  gmm.Train(inputData, 1);
+
+  arma::mat inputPoints(3, 50, arma::fill::randu);
+
+  SetInputParam("input", inputPoints);
+  SetInputParam("input_model", &gmm);
+
+  RUN_BINDING();
+
+  const arma::mat probabilities = params.Get<arma::mat>("output");
+  const arma::mat componentLogProbs = params.Get<arma::mat>("component_output");
+  REQUIRE(componentLogProbs.n_rows == 2);
+  REQUIRE(componentLogProbs.n_cols == 50);
+  for (size_t i = 0; i < 50; ++i)
+  {
+    REQUIRE(probabilities(0, i) == Approx(accu(exp(componentLogProbs.col(i))))
+        .epsilon(1e-7));
+    REQUIRE(probabilities(0, i) ==
+        Approx(gmm.Probability(inputPoints.col(i))).epsilon(1e-7));
+  }
+
+  // Avoid double free (the fixture will try to delete the input model).
+  params.Get<GMM*>("input_model") = NULL;
+
+  CleanMemory();
+  ResetSettings();
+
+  SetInputParam("input", inputPoints);
+  SetInputParam("input_model", &gmm);
+  SetInputParam("single_precision", true);
+
+  RUN_BINDING();
+
+  const arma::mat fProbabilities = params.Get<arma::mat>("output");
+  REQUIRE(fProbabilities.n_cols == 50);
+  for (size_t i = 0; i < 50; ++i)
+    REQUIRE(fProbabilities(0, i) == Approx(probabilities(0, i)).epsilon(1e-3));
+
+  params.Get<GMM*>("input_model") = NULL;
+}
@@ -722,3 +722,52 @@ TEST_CASE_METHOD(HoeffdingTreeTestFixture, "HoeffdingBinningTest",
   REQUIRE((params.Get<HoeffdingTreeModel*>("output_model"))->NumNodes()
       == 1);
 }
+
+/**
+ * Make sure that training in mini-batches builds a tree, and that an invalid
+ * mini-batch size is rejected.
+ */
+TEST_CASE_METHOD(HoeffdingTreeTestFixture, "HoeffdingMiniBatchSizeTest",
+                 "[HoeffdingTreeMainTest][BindingTests]")
+{
+  arma::mat inputData;
+  DatasetInfo info;
+  if (!data::Load("vc2.csv", inputData, info))
+    FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData, info))
+    FAIL("Cannot load test dataset vc2.csv!");
+
+  // Input training data.
+  SetInputParam("training", std::make_tuple(info, inputData));
+  SetInputParam("labels", labels);
+
+  // Input test data.
+  SetInputParam("test", std::make_tuple(info, testData));
+
+  SetInputParam("mini_batch_size", 50);
+  SetInputParam("passes", 10);
+  SetInputParam("min_samples", 10);
+  SetInputParam("confidence", 0.25);
+
+  RUN_BINDING();
+
+  REQUIRE((params.Get<HoeffdingTreeModel*>("output_model"))->NumNodes() > 1);
+  REQUIRE(params.Get<arma::Row<size_t>>("predictions").n_elem ==
+      testData.n_cols);
+
+  // Reset passed parameters.
+  ResetSettings();
+  CleanMemory();
+
+  SetInputParam("training", std::make_tuple(info, inputData));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("mini_batch_size", 0);
+
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+}
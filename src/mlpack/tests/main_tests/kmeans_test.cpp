@@ -330,6 +330,24 @@ TEST_CASE_METHOD(KmTestFixture, "AlgorithmsSimilarTest",
   CleanMemory();
   ResetSettings();
 
+  algo = "yinyang";
+
+  SetInputParam("input", inputData);
+  SetInputParam("clusters", c);
+  SetInputParam("algorithm", std::move(algo));
+  SetInputParam("labels_only", true);
+  SetInputParam("initial_centroids", initCentroid);
+
+  RUN_BINDING();
+
+  arma::mat yinyangOutput;
+  arma::mat yinyangCentroid;
+  yinyangOutput = std::move(params.Get<arma::mat>("output"));
+  yinyangCentroid = std::move(params.Get<arma::mat>("centroid"));
+
+  CleanMemory();
+  ResetSettings();
+
   algo = "dualtree";
 
   SetInputParam("input", inputData);
@@ -366,12 +384,125 @@ TEST_CASE_METHOD(KmTestFixture, "AlgorithmsSimilarTest",
   // Checking all the algorithms return same assignments
   CheckMatrices(naiveOutput, hamerlyOutput);
   CheckMatrices(naiveOutput, elkanOutput);
+  CheckMatrices(naiveOutput, yinyangOutput);
   CheckMatrices(naiveOutput, dualTreeOutput);
   CheckMatrices(naiveOutput, dualCoverTreeOutput);
 
   // Checking all the algorithms return almost same centroid
   CheckMatrices(naiveCentroid, hamerlyCentroid);
   CheckMatrices(naiveCentroid, elkanCentroid);
+  CheckMatrices(naiveCentroid, yinyangCentroid);
   CheckMatrices(naiveCentroid, dualTreeCentroid);
   CheckMatrices(naiveCentroid, dualCoverTreeCentroid);
 }
+
+/**
+ * Make sure that mini-batch k-means can be used from the binding, and that it
+ * gives a clustering of the right size.
+ */
+TEST_CASE_METHOD(KmTestFixture, "KmMiniBatchTest",
+                 "[KmeansMainTest][BindingTests]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Unable to load train dataset vc2.csv!");
+
+  const size_t col = inputData.n_cols;
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("clusters", (int) 3);
+  SetInputParam("algorithm", std::string("minibatch"));
+  SetInputParam("max_iterations", (int) 50);
+  SetInputParam("labels_only", true);
+
+  RUN_BINDING();
+
+  REQUIRE(params.Get<arma::mat>("output").n_cols == col);
+  REQUIRE(params.Get<arma::mat>("output").n_rows == 1);
+  REQUIRE(params.Get<arma::mat>("centroid").n_cols == 3);
+  REQUIRE(arma::max(params.Get<arma::mat>("output").row(0)) < 3);
+}
+
+/**
+ * Make sure that k-means|| initialization can be used from the binding, and
+ * that invalid parameters for it are rejected.
+ */
+TEST_CASE_METHOD(KmTestFixture, "KmParallelInitializationTest",
+                 "[KmeansMainTest][BindingTests]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Unable to load train dataset vc2.csv!");
+
+  const size_t col = inputData.n_cols;
+
+  SetInputParam("input", inputData);
+  SetInputParam("clusters", (int) 3);
+  SetInputParam("kmeans_parallel", true);
+  SetInputParam("kmeans_parallel_rounds", (int) 3);
+  SetInputParam("oversampling", 1.5);
+  SetInputParam("labels_only", true);
+
+  RUN_BINDING();
+
+  REQUIRE(params.Get<arma::mat>("output").n_cols == col);
+  REQUIRE(params.Get<arma::mat>("centroid").n_cols == 3);
+
+  CleanMemory();
+  ResetSettings();
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("clusters", (int) 3);
+  SetInputParam("kmeans_parallel", true);
+  SetInputParam("oversampling", 0.0);
+
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+}
+
+/**
+ * Make sure that the binding can cluster a file in streaming mode, and write
+ * the assignments to a file.
+ */
+TEST_CASE_METHOD(KmTestFixture, "KmStreamingTest",
+                 "[KmeansMainTest][BindingTests]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Unable to load train dataset vc2.csv!");
+
+  SetInputParam("input_file", std::string("vc2.csv"));
+  SetInputParam("chunk_size", (int) 50);
+  SetInputParam("clusters", (int) 3);
+  SetInputParam("assignments_file",
+      std::string("kmeans_streaming_assignments.csv"));
+
+  RUN_BINDING();
+
+  REQUIRE(params.Get<arma::mat>("centroid").n_rows == inputData.n_rows);
+  REQUIRE(params.Get<arma::mat>("centroid").n_cols == 3);
+
+  arma::Row<size_t> assignments;
+  REQUIRE(data::Load("kmeans_streaming_assignments.csv", assignments));
+  REQUIRE(assignments.n_elem == inputData.n_cols);
+  REQUIRE(arma::max(assignments) < 3);
+
+  remove("kmeans_streaming_assignments.csv");
+}
+
+/**
+ * Make sure that exactly one of the in-memory and streaming inputs must be
+ * given.
+ */
+TEST_CASE_METHOD(KmTestFixture, "KmStreamingBothInputsTest",
+                 "[KmeansMainTest][BindingTests]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Unable to load train dataset vc2.csv!");
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("input_file", std::string("vc2.csv"));
+  SetInputParam("clusters", (int) 3);
+
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+}
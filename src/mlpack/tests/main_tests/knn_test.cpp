@@ -647,3 +647,40 @@ TEST_CASE_METHOD(KNNTestFixture, "KNNDifferentLeafSizes",
   REQUIRE(params.Get<KNNModel*>("output_model")->LeafSize() == (int) 10);
   delete output_model;
 }
+
+/**
+ * Make sure that a search budget can be given, and that invalid budgets are
+ * rejected.
+ */
+TEST_CASE_METHOD(KNNTestFixture, "KNNBudgetTest",
+                 "[KNNMainTest][BindingTests]")
+{
+  arma::mat referenceData;
+  referenceData.randu(3, 1000); // 1000 points in 3 dimensions.
+
+  SetInputParam("reference", referenceData);
+  SetInputParam("k", (int) 5);
+  SetInputParam("max_base_cases", (int) 1000);
+
+  RUN_BINDING();
+
+  REQUIRE(params.Get<arma::Mat<size_t>>("neighbors").n_cols == 1000);
+  REQUIRE(!params.Get<KNNModel*>("output_model")->Exact());
+
+  const std::vector<std::string> budgetParams = { "max_base_cases",
+      "max_scores", "max_time" };
+  for (size_t i = 0; i < budgetParams.size(); ++i)
+  {
+    CleanMemory();
+    ResetSettings();
+
+    SetInputParam("reference", referenceData);
+    SetInputParam("k", (int) 5);
+    if (budgetParams[i] == "max_time")
+      SetInputParam(budgetParams[i], (double) -1.0);
+    else
+      SetInputParam(budgetParams[i], (int) -1);
+
+    REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+  }
+}
@@ -0,0 +1,69 @@
+/**
+ * @file tests/main_tests/xgboost_predict_test.cpp
+ *
+ * Test RUN_BINDING() of xgboost_predict_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#define BINDING_TYPE BINDING_TYPE_TEST
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/xgboost/xgboost_predict_main.cpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "main_test_fixture.hpp"
+
+#include "../catch.hpp"
+
+using namespace mlpack;
+
+BINDING_TEST_FIXTURE(XGBoostPredictTestFixture);
+
+// Make sure the predictions of the binding are those of the model.
+TEST_CASE_METHOD(XGBoostPredictTestFixture, "XGBoostPredictOutputTest",
+                 "[XGBoostPredictMainTest][BindingTests]")
+{
+  arma::mat data(3, 200, arma::fill::randu);
+  arma::rowvec responses = data.row(0) - data.row(2);
+
+  XGBoostModel model;
+  model.xgb.NumTrees() = 20;
+  model.xgb.Train(data, responses);
+
+  arma::mat testData(3, 40, arma::fill::randu);
+
+  SetInputParam("input_model", &model);
+  SetInputParam("test", testData);
+
+  RUN_BINDING();
+
+  const arma::rowvec& predictions = params.Get<arma::rowvec>("predictions");
+  REQUIRE(predictions.n_elem == 40);
+  for (size_t i = 0; i < 40; ++i)
+    REQUIRE(predictions[i] == Approx(model.xgb.Predict(testData.col(i))));
+
+  // Avoid double free (the fixture will try to delete the input model).
+  params.Get<XGBoostModel*>("input_model") = NULL;
+}
+
+// Make sure test data of the wrong dimensionality is rejected.
+TEST_CASE_METHOD(XGBoostPredictTestFixture, "XGBoostPredictDimensionalityTest",
+                 "[XGBoostPredictMainTest][BindingTests]")
+{
+  arma::mat data(3, 100, arma::fill::randu);
+  arma::rowvec responses(100, arma::fill::randu);
+
+  XGBoostModel model;
+  model.xgb.NumTrees() = 5;
+  model.xgb.Train(data, responses);
+
+  SetInputParam("input_model", &model);
+  SetInputParam("test", arma::mat(4, 10, arma::fill::randu));
+
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+
+  // Avoid double free (the fixture will try to delete the input model).
+  params.Get<XGBoostModel*>("input_model") = NULL;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file tests/main_tests/xgboost_train_test.cpp
+ *
+ * Test RUN_BINDING() of xgboost_train_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#define BINDING_TYPE BINDING_TYPE_TEST
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/xgboost/xgboost_train_main.cpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "main_test_fixture.hpp"
+
+#include "../catch.hpp"
+
+using namespace mlpack;
+
+BINDING_TEST_FIXTURE(XGBoostTrainTestFixture);
+
+// Make sure the trained model has the right number of trees and
+// dimensionality, and fits the training data.
+TEST_CASE_METHOD(XGBoostTrainTestFixture, "XGBoostTrainModelTest",
+                 "[XGBoostTrainMainTest][BindingTests]")
+{
+  arma::mat data(3, 500, arma::fill::randu);
+  arma::rowvec responses = 2.0 * data.row(0) + arma::square(data.row(1));
+
+  SetInputParam("training", data);
+  SetInputParam("responses", responses);
+  SetInputParam("num_trees", (int) 30);
+  SetInputParam("seed", (int) 1);
+
+  RUN_BINDING();
+
+  XGBoostModel* model = params.Get<XGBoostModel*>("output_model");
+  REQUIRE(model->xgb.NumTreesTrained() == 30);
+  REQUIRE(model->xgb.Dimensionality() == 3);
+
+  arma::rowvec predictions;
+  model->xgb.Predict(data, predictions);
+  REQUIRE(arma::mean(arma::square(predictions - responses)) <
+      0.1 * arma::var(responses));
+}
+
+// Make sure that training with a validation set keeps at most the requested
+// number of trees.
+TEST_CASE_METHOD(XGBoostTrainTestFixture, "XGBoostTrainValidationTest",
+                 "[XGBoostTrainMainTest][BindingTests]")
+{
+  arma::mat data(2, 300, arma::fill::randu);
+  arma::rowvec responses = data.row(0) + data.row(1);
+  arma::mat validation(2, 100, arma::fill::randu);
+  arma::rowvec validationResponses = validation.row(0) + validation.row(1);
+
+  SetInputParam("training", data);
+  SetInputParam("responses", responses);
+  SetInputParam("validation", validation);
+  SetInputParam("validation_responses", validationResponses);
+  SetInputParam("num_trees", (int) 50);
+  SetInputParam("early_stopping_rounds", (int) 5);
+  SetInputParam("seed", (int) 1);
+
+  RUN_BINDING();
+
+  XGBoostModel* model = params.Get<XGBoostModel*>("output_model");
+  REQUIRE(model->xgb.NumTreesTrained() > 0);
+  REQUIRE(model->xgb.NumTreesTrained() <= 50);
+}
+
+// Make sure that invalid parameters are rejected.
+TEST_CASE_METHOD(XGBoostTrainTestFixture, "XGBoostTrainInvalidParamsTest",
+                 "[XGBoostTrainMainTest][BindingTests]")
+{
+  arma::mat data(2, 50, arma::fill::randu);
+  arma::rowvec responses(50, arma::fill::randu);
+
+  SetInputParam("training", data);
+  SetInputParam("responses", responses);
+  SetInputParam("row_subsample", 1.5); // Invalid.
+
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+  CleanMemory();
+  ResetSettings();
+
+  SetInputParam("training", std::move(data));
+  SetInputParam("responses", std::move(responses));
+  SetInputParam("num_trees", (int) 0); // Invalid.
+
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+}
@@ -827,6 +827,50 @@ TEST_CASE("InplaceShuffleTest", "[MathTest]")
     REQUIRE(counts[i] == 1);
 }
 
+/**
+ * Make sure that shuffling in place gives the same result as shuffling into
+ * new matrices, for dense data with and without weights.
+ */
+TEST_CASE("InPlaceShuffleMatchesCopyTest", "[MathTest]")
+{
+  arma::mat data(4, 1000, arma::fill::randu);
+  arma::Row<size_t> labels = arma::regspace<arma::Row<size_t>>(0, 999);
+  arma::rowvec weights(1000, arma::fill::randu);
+
+  arma::mat outputData;
+  arma::Row<size_t> outputLabels;
+  arma::rowvec outputWeights;
+  RandomSeed(17);
+  ShuffleData(data, labels, weights, outputData, outputLabels, outputWeights);
+
+  arma::mat inPlaceData(data);
+  arma::Row<size_t> inPlaceLabels(labels);
+  arma::rowvec inPlaceWeights(weights);
+  RandomSeed(17);
+  ShuffleData(inPlaceData, inPlaceLabels, inPlaceWeights);
+
+  REQUIRE(arma::approx_equal(inPlaceData, outputData, "absdiff", 0.0));
+  REQUIRE(arma::all(inPlaceLabels == outputLabels));
+  REQUIRE(arma::approx_equal(inPlaceWeights, outputWeights, "absdiff", 0.0));
+
+  // The points still match their labels.
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    REQUIRE(arma::approx_equal(inPlaceData.col(i),
+        data.col(inPlaceLabels[i]), "absdiff", 0.0));
+  }
+
+  inPlaceData = data;
+  inPlaceLabels = labels;
+  RandomSeed(17);
+  ShuffleData(data, labels, outputData, outputLabels);
+  RandomSeed(17);
+  ShuffleData(inPlaceData, inPlaceLabels);
+
+  REQUIRE(arma::approx_equal(inPlaceData, outputData, "absdiff", 0.0));
+  REQUIRE(arma::all(inPlaceLabels == outputLabels));
+}
+
 /**
  * Make sure shuffling sparse data works when the input and output matrices are
  * the same.
@@ -1003,3 +1047,75 @@ TEST_CASE("InplaceSparseShuffleWeightsTest", "[MathTest]")
     REQUIRE(weightCounts[i] == 1);
   }
 }
+
+/**
+ * Make sure that BatchedGemm() matches a product per slice, for every
+ * combination of transposes and shared operands.
+ */
+TEST_CASE("BatchedGemmTest", "[MathTest]")
+{
+  const size_t m = 4, k = 3, n = 5, s = 6;
+
+  for (size_t t = 0; t < 4; ++t)
+  {
+    const bool aTranspose = (t & 1);
+    const bool bTranspose = (t & 2);
+
+    // Try shared operands too, since they are handled by a single GEMM.
+    for (size_t shared = 0; shared < 3; ++shared)
+    {
+      arma::cube a(aTranspose ? k : m, aTranspose ? m : k,
+          (shared == 1) ? 1 : s, arma::fill::randu);
+      arma::cube b(bTranspose ? n : k, bTranspose ? k : n,
+          (shared == 2) ? 1 : s, arma::fill::randu);
+
+      arma::cube c;
+      BatchedGemm(c, a, b, aTranspose, bTranspose);
+
+      arma::cube d(m, n, s, arma::fill::randu);
+      const arma::cube dOld(d);
+      BatchedGemm(d, a, b, aTranspose, bTranspose, 2.0, 0.5);
+
+      REQUIRE(c.n_rows == m);
+      REQUIRE(c.n_cols == n);
+      REQUIRE(c.n_slices == s);
+      for (size_t i = 0; i < s; ++i)
+      {
+        arma::mat aSlice = a.slice((shared == 1) ? 0 : i);
+        arma::mat bSlice = b.slice((shared == 2) ? 0 : i);
+        if (aTranspose)
+          aSlice = aSlice.t();
+        if (bTranspose)
+          bSlice = bSlice.t();
+
+        const arma::mat expected = aSlice * bSlice;
+        const arma::mat expectedScaled = 2.0 * expected + 0.5 * dOld.slice(i);
+        CheckMatrices(c.slice(i), expected, 1e-5);
+        CheckMatrices(d.slice(i), expectedScaled, 1e-5);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that BatchedGemm() throws on operands of the wrong size.
+ */
+TEST_CASE("BatchedGemmInvalidSizeTest", "[MathTest]")
+{
+  arma::cube a(4, 3, 5, arma::fill::randu);
+  arma::cube b(3, 2, 4, arma::fill::randu);
+  arma::cube c;
+
+  // The numbers of slices don't match.
+  REQUIRE_THROWS_AS(BatchedGemm(c, a, b), std::invalid_argument);
+
+  // The inner dimensions don't match.
+  b.randu(4, 2, 5);
+  REQUIRE_THROWS_AS(BatchedGemm(c, a, b), std::invalid_argument);
+
+  // The result has the wrong size and beta is not zero.
+  b.randu(3, 2, 5);
+  c.zeros(4, 3, 5);
+  REQUIRE_THROWS_AS(BatchedGemm(c, a, b, false, false, 1.0, 1.0),
+      std::invalid_argument);
+}
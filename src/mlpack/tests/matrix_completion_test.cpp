@@ -59,3 +59,47 @@ TEST_CASE("UniformMatrixCompletionSDP", "[MatrixCompletionTest]")
        Approx(Xorig(indices(0, i), indices(1, i))).epsilon(1e-7));
   }
 }
+
+/**
+ * Make sure that SoftImpute recovers a random low-rank matrix from a subset of
+ * its entries.
+ */
+TEST_CASE("SoftImputeLowRankTest", "[MatrixCompletionTest]")
+{
+  const size_t m = 200;
+  const size_t n = 150;
+  const arma::mat x = arma::randn<arma::mat>(m, 2) *
+      arma::randn<arma::mat>(2, n);
+
+  // Observe 40% of the entries.
+  const arma::uvec observed = arma::find(arma::randu<arma::vec>(m * n) < 0.4);
+  arma::umat indices(2, observed.n_elem);
+  arma::vec values(observed.n_elem);
+  for (size_t i = 0; i < observed.n_elem; ++i)
+  {
+    indices(0, i) = observed[i] % m;
+    indices(1, i) = observed[i] / m;
+    values[i] = x(indices(0, i), indices(1, i));
+  }
+
+  arma::mat u, v;
+  arma::vec s;
+  SoftImpute si(0.005, 10, 500, 1e-6);
+  si.Apply(m, n, indices, values, u, s, v);
+
+  REQUIRE(u.n_rows == m);
+  REQUIRE(v.n_rows == n);
+  REQUIRE(u.n_cols == s.n_elem);
+  REQUIRE(v.n_cols == s.n_elem);
+  REQUIRE(s.n_elem <= 10);
+
+  const arma::mat recovered = u * arma::diagmat(s) * v.t();
+  REQUIRE(arma::norm(x - recovered, "fro") / arma::norm(x, "fro") < 0.05);
+
+  // The other overload gives the same matrix.
+  arma::mat full;
+  si.Apply(m, n, indices, values, full);
+  REQUIRE(full.n_rows == m);
+  REQUIRE(full.n_cols == n);
+  REQUIRE(arma::norm(x - full, "fro") / arma::norm(x, "fro") < 0.05);
+}
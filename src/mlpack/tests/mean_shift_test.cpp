@@ -86,6 +86,42 @@ TEST_CASE("MeanShiftSimpleTest", "[MeanShiftTest]")
     REQUIRE(assignments(i) == thirdClass);
 }
 
+/**
+ * Make sure that the 30-point 3-class test case still works when every point
+ * is a seed, so that many centroids are shifted (and merged) together, and
+ * when the range searches run on several threads.
+ */
+TEST_CASE("MeanShiftParallelNoSeedsTest", "[MeanShiftTest]")
+{
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+#endif
+
+  MeanShift<> meanShift;
+
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  meanShift.Cluster((arma::mat) trans(meanShiftData), assignments, centroids,
+      true, false);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+
+  REQUIRE(centroids.n_cols == 3);
+  for (size_t i = 1; i < 13; ++i)
+    REQUIRE(assignments(i) == assignments(0));
+  for (size_t i = 14; i < 20; ++i)
+    REQUIRE(assignments(i) == assignments(13));
+  for (size_t i = 21; i < 30; ++i)
+    REQUIRE(assignments(i) == assignments(20));
+
+  REQUIRE(assignments(0) != assignments(13));
+  REQUIRE(assignments(0) != assignments(20));
+  REQUIRE(assignments(13) != assignments(20));
+}
+
 // Generate samples from four Gaussians, and make sure mean shift nearly
 // recovers those four centers.
 TEST_CASE("GaussianClustering", "[MeanShiftTest]")
@@ -93,6 +93,108 @@ TEST_CASE("LINFMetricTest", "[MetricTest]")
       Approx(lMetric.Evaluate(a2, b2)).epsilon(1e-7));
 }
 
+/**
+ * Make sure that the fixed-dimension code paths of LMetric, which are used for
+ * 2 to 8 dimensions, give the same results as the generic ones.
+ */
+TEST_CASE("LMetricFixedDimensionTest", "[MetricTest]")
+{
+  for (size_t d = 1; d <= 10; ++d)
+  {
+    arma::vec a(d, arma::fill::randn);
+    arma::vec b(d, arma::fill::randn);
+    arma::mat m = arma::join_rows(a, b);
+
+    REQUIRE(ManhattanDistance::Evaluate(a, b) ==
+        Approx(accu(arma::abs(a - b))).epsilon(1e-7));
+    REQUIRE(SquaredEuclideanDistance::Evaluate(a, b) ==
+        Approx(accu(arma::square(a - b))).epsilon(1e-7));
+    REQUIRE(EuclideanDistance::Evaluate(a, b) ==
+        Approx(arma::norm(a - b, 2)).epsilon(1e-7));
+    REQUIRE(ChebyshevDistance::Evaluate(a, b) ==
+        Approx(arma::max(arma::abs(a - b))).epsilon(1e-7));
+    REQUIRE(LMetric<3, true>::Evaluate(a, b) ==
+        Approx(std::pow(accu(arma::pow(arma::abs(a - b), 3.0)), 1.0 / 3.0))
+        .epsilon(1e-7));
+    REQUIRE(LMetric<3, false>::Evaluate(a, b) ==
+        Approx(accu(arma::pow(arma::abs(a - b), 3.0))).epsilon(1e-7));
+
+    // Columns of a matrix and rows should take the same path.
+    REQUIRE(EuclideanDistance::Evaluate(m.col(0), m.col(1)) ==
+        Approx(arma::norm(a - b, 2)).epsilon(1e-7));
+    arma::rowvec ar = a.t();
+    arma::rowvec br = b.t();
+    REQUIRE(ManhattanDistance::Evaluate(ar, br) ==
+        Approx(accu(arma::abs(a - b))).epsilon(1e-7));
+  }
+
+  // The fixed-dimension kernel can also be called directly.
+  arma::vec a = { 1.0, 2.0, 3.0 };
+  arma::vec b = { 4.0, 6.0, 3.0 };
+  REQUIRE(EuclideanDistance::EvaluateFixed<3>(a, b) ==
+      Approx(5.0).epsilon(1e-7));
+  REQUIRE(ChebyshevDistance::EvaluateFixed<3>(a, b) ==
+      Approx(4.0).epsilon(1e-7));
+}
+
+/**
+ * Check that the batch Evaluate() of a metric matches its pairwise
+ * Evaluate().
+ */
+template<typename MetricType>
+void CheckBatchEvaluate(MetricType& metric,
+                        const arma::mat& a,
+                        const arma::mat& b)
+{
+  arma::mat output;
+  metric.Evaluate(a, b, output);
+
+  REQUIRE(output.n_rows == a.n_cols);
+  REQUIRE(output.n_cols == b.n_cols);
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      REQUIRE(output(i, j) == Approx(metric.Evaluate(a.col(i), b.col(j)))
+          .epsilon(1e-7).margin(1e-5));
+    }
+  }
+}
+
+/**
+ * Make sure that the batch Evaluate() of IPMetric and MahalanobisDistance gives
+ * the same distances as the pairwise Evaluate().
+ */
+TEST_CASE("MetricBatchEvaluateTest", "[MetricTest]")
+{
+  arma::mat a(4, 20, arma::fill::randu);
+  arma::mat b(4, 13, arma::fill::randu);
+  b.col(0) = a.col(0);
+
+  // A normalized kernel, a kernel that is not normalized, and the linear
+  // kernel, for which the pairwise metric is the Euclidean distance.
+  GaussianKernel gk(0.8);
+  IPMetric<GaussianKernel> gkMetric(gk);
+  CheckBatchEvaluate(gkMetric, a, b);
+
+  PolynomialKernel pk(2.0, 1.0);
+  IPMetric<PolynomialKernel> pkMetric(pk);
+  CheckBatchEvaluate(pkMetric, a, b);
+
+  IPMetric<LinearKernel> lkMetric;
+  CheckBatchEvaluate(lkMetric, a, b);
+
+  arma::mat l(4, 4, arma::fill::randu);
+  MahalanobisDistance<true> md(l * l.t() + arma::eye<arma::mat>(4, 4));
+  CheckBatchEvaluate(md, a, b);
+  MahalanobisDistance<false> mdSquared(md.Covariance());
+  CheckBatchEvaluate(mdSquared, a, b);
+
+  arma::mat output;
+  arma::mat c(5, 3, arma::fill::randu);
+  REQUIRE_THROWS_AS(md.Evaluate(a, c, output), std::invalid_argument);
+}
+
 /**
  * Simple test for IoU metric.
  */
@@ -297,6 +399,90 @@ TEST_CASE("NMSMetricTest", "[MetricTest]")
   CheckMatrices(desiredBoundingBox, selectedBoundingBox);
 }
 
+/**
+ * Make sure that the grid-indexed NMS selects the same boxes as the standard
+ * NMS, whatever the size of the cells of the grid.
+ */
+TEST_CASE("NMSIndexedTest", "[MetricTest]")
+{
+  // Random boxes with integer coordinates, in the {x0, y0, h, w} format.
+  arma::mat bbox(4, 500);
+  bbox.rows(0, 1) = arma::floor(200 * arma::randu<arma::mat>(2, 500));
+  bbox.rows(2, 3) = arma::floor(5 + 40 * arma::randu<arma::mat>(2, 500));
+  const arma::vec confidenceScores =
+      arma::shuffle(arma::linspace<arma::vec>(0.0, 1.0, 500));
+
+  arma::mat coordinates(bbox);
+  coordinates.rows(2, 3) += coordinates.rows(0, 1);
+
+  for (const double threshold : { 0.1, 0.5, 0.9 })
+  {
+    arma::uvec desiredIndices, desiredCoordinateIndices;
+    NMS<>::Evaluate(bbox, confidenceScores, desiredIndices, threshold);
+    NMS<true>::Evaluate(coordinates, confidenceScores,
+        desiredCoordinateIndices, threshold);
+    REQUIRE(desiredIndices.n_elem > 1);
+
+    for (const double cellSize : { 0.0, 0.5, 7.0, 1000.0 })
+    {
+      arma::uvec selectedIndices, selectedCoordinateIndices;
+      NMS<>::EvaluateIndexed(bbox, confidenceScores, selectedIndices,
+          threshold, cellSize);
+      NMS<true>::EvaluateIndexed(coordinates, confidenceScores,
+          selectedCoordinateIndices, threshold, cellSize);
+
+      REQUIRE(selectedIndices.n_elem == desiredIndices.n_elem);
+      REQUIRE(selectedCoordinateIndices.n_elem ==
+          desiredCoordinateIndices.n_elem);
+      for (size_t i = 0; i < desiredIndices.n_elem; ++i)
+        REQUIRE(selectedIndices[i] == desiredIndices[i]);
+      for (size_t i = 0; i < desiredCoordinateIndices.n_elem; ++i)
+        REQUIRE(selectedCoordinateIndices[i] == desiredCoordinateIndices[i]);
+    }
+  }
+
+  // The boxes must match the scores.
+  arma::uvec selectedIndices;
+  REQUIRE_THROWS_AS(NMS<>::EvaluateIndexed(bbox, confidenceScores.head(10),
+      selectedIndices), std::invalid_argument);
+}
+
+/**
+ * Make sure that batched NMS suppresses boxes only within each image.
+ */
+TEST_CASE("NMSBatchTest", "[MetricTest]")
+{
+  arma::mat bbox(4, 100);
+  bbox.rows(0, 1) = arma::floor(50 * arma::randu<arma::mat>(2, 100));
+  bbox.rows(2, 3) = arma::floor(5 + 20 * arma::randu<arma::mat>(2, 100));
+  const arma::vec confidenceScores =
+      arma::shuffle(arma::linspace<arma::vec>(0.0, 1.0, 100));
+
+  arma::uvec singleIndices;
+  NMS<>::EvaluateIndexed(bbox, confidenceScores, singleIndices);
+
+  // The same boxes, in three images given in a different order; image 1 has
+  // no boxes.
+  arma::mat batchBox = arma::join_rows(bbox, bbox);
+  arma::vec batchScores = arma::join_cols(confidenceScores, confidenceScores);
+  arma::uvec imageIndices(200);
+  imageIndices.head(100).fill(2);
+  imageIndices.tail(100).fill(0);
+
+  arma::uvec batchIndices;
+  NMS<>::EvaluateBatch(batchBox, batchScores, imageIndices, batchIndices);
+
+  REQUIRE(batchIndices.n_elem == 2 * singleIndices.n_elem);
+  for (size_t i = 0; i < singleIndices.n_elem; ++i)
+  {
+    REQUIRE(batchIndices[i] == singleIndices[i] + 100);
+    REQUIRE(batchIndices[i + singleIndices.n_elem] == singleIndices[i]);
+  }
+
+  REQUIRE_THROWS_AS(NMS<>::EvaluateBatch(batchBox, batchScores,
+      imageIndices.head(10), batchIndices), std::invalid_argument);
+}
+
 /**
  *
  */
@@ -354,3 +540,65 @@ TEST_CASE("BLEUScoreTest", "[MetricTest]")
         Approx(expectedPrecision[i]).epsilon(1e-4));
   }
 }
+
+/**
+ * Make sure that the Hamming distance between packed codes is the number of
+ * bits that differ, for several element types, and that it is the same on the
+ * unpacked codes.
+ */
+TEST_CASE("HammingDistanceTest", "[MetricTest]")
+{
+  arma::mat codes = arma::round(arma::randu<arma::mat>(256, 20));
+
+  arma::mat packed;
+  arma::fmat packedFloat;
+  arma::Mat<arma::u64> packedWords;
+  data::PackBinary(codes, packed);
+  data::PackBinary(codes, packedFloat);
+  data::PackBinary(codes, packedWords);
+  REQUIRE(packed.n_rows == 5);
+  REQUIRE(packedFloat.n_rows == 11);
+  REQUIRE(packedWords.n_rows == 4);
+
+  for (size_t i = 0; i < codes.n_cols; ++i)
+  {
+    for (size_t j = 0; j < codes.n_cols; ++j)
+    {
+      const double expected = arma::accu(codes.col(i) != codes.col(j));
+      REQUIRE(HammingDistance::Evaluate(packed.col(i), packed.col(j)) ==
+          expected);
+      REQUIRE(HammingDistance::Evaluate(packedFloat.col(i),
+          packedFloat.col(j)) == (float) expected);
+      REQUIRE(HammingDistance::Evaluate(packedWords.col(i),
+          packedWords.col(j)) == (arma::u64) expected);
+      REQUIRE(HammingDistance::Evaluate(codes.col(i), codes.col(j)) ==
+          expected);
+    }
+  }
+
+  REQUIRE(HammingDistance::PopCount(0) == 0);
+  REQUIRE(HammingDistance::PopCount(0xF0F0ULL) == 8);
+  REQUIRE(HammingDistance::PopCount(~uint64_t(0)) == 64);
+}
+
+/**
+ * Make sure that unpacking packed codes gives the original codes back.
+ */
+TEST_CASE("PackBinaryRoundTripTest", "[MetricTest]")
+{
+  arma::mat codes = arma::round(arma::randu<arma::mat>(100, 30));
+
+  arma::mat packed, unpacked;
+  data::PackBinary(codes, packed);
+  data::UnpackBinary(packed, unpacked, codes.n_rows);
+  REQUIRE(arma::approx_equal(codes, unpacked, "absdiff", 0.0));
+
+  arma::Mat<arma::u64> packedWords;
+  data::PackBinary(codes, packedWords);
+  data::UnpackBinary(packedWords, unpacked, codes.n_rows);
+  REQUIRE(arma::approx_equal(codes, unpacked, "absdiff", 0.0));
+
+  // There are not enough bits for this.
+  REQUIRE_THROWS_AS(data::UnpackBinary(packedWords, unpacked, 130),
+      std::invalid_argument);
+}
@@ -498,3 +498,63 @@ TEMPLATE_TEST_CASE("NBCModelMatTypeTest", "[NBCTest]", float, double)
   REQUIRE(nbc.Variances().n_rows == data.n_rows);
   REQUIRE(nbc.Variances().n_cols == 4);
 }
+
+/**
+ * Make sure that training incrementally on several batches gives the same model
+ * as training on all the points at once.
+ */
+TEST_CASE("NBCBatchIncrementalTest", "[NBCTest]")
+{
+  arma::mat data = arma::randn<arma::mat>(10, 3000);
+  arma::Row<size_t> labels =
+      arma::randi<arma::Row<size_t>>(3000, arma::distr_param(0, 2));
+  data.each_row() += 2.0 * arma::conv_to<arma::rowvec>::from(labels);
+
+  NaiveBayesClassifier<> nbc(data, labels, 3, false);
+  NaiveBayesClassifier<> nbcBatches(data.n_rows, 3);
+  nbcBatches.Train(data.cols(0, 999), labels.subvec(0, 999), 3, true);
+  nbcBatches.Train(data.cols(1000, 2999), labels.subvec(1000, 2999), 3, true);
+
+  REQUIRE(nbcBatches.TrainingPoints() == 3000);
+  REQUIRE(arma::approx_equal(nbc.Probabilities(), nbcBatches.Probabilities(),
+      "absdiff", 1e-10));
+  REQUIRE(arma::approx_equal(nbc.Means(), nbcBatches.Means(), "absdiff",
+      1e-8));
+  REQUIRE(arma::approx_equal(nbc.Variances(), nbcBatches.Variances(),
+      "absdiff", 1e-8));
+}
+
+/**
+ * Make sure that sparse and dense data are classified the same way, with float
+ * and double models.
+ */
+TEMPLATE_TEST_CASE("NBCSparseClassifyTest", "[NBCTest]", float, double)
+{
+  typedef TestType ElemType;
+
+  arma::SpMat<ElemType> data;
+  data.sprandu(50, 2000, 0.2);
+  arma::Row<size_t> labels =
+      arma::randi<arma::Row<size_t>>(2000, arma::distr_param(0, 3));
+  const arma::Mat<ElemType> denseData(data);
+
+  NaiveBayesClassifier<arma::Mat<ElemType>> nbc(data, labels, 4);
+
+  arma::Row<size_t> sparsePredictions, densePredictions;
+  arma::Mat<ElemType> sparseProbs, denseProbs;
+  nbc.Classify(data, sparsePredictions, sparseProbs);
+  nbc.Classify(denseData, densePredictions, denseProbs);
+
+  REQUIRE(sparseProbs.n_rows == 4);
+  REQUIRE(sparseProbs.n_cols == 2000);
+  REQUIRE(arma::approx_equal(sparseProbs, denseProbs, "absdiff", 1e-3));
+
+  // Each point is also classified the same way on its own.
+  for (size_t i = 0; i < 2000; i += 100)
+  {
+    size_t prediction;
+    arma::Col<ElemType> probs;
+    nbc.Classify(denseData.col(i), prediction, probs);
+    REQUIRE(arma::approx_equal(probs, denseProbs.col(i), "absdiff", 1e-3));
+  }
+}
@@ -242,6 +242,95 @@ TEST_CASE("SoftmaxSeparableGradient", "[NCATesT]")
   REQUIRE(gradient(1, 1) == Approx(-2.0 * -0.1435886).epsilon(0.0001));
 }
 
+/**
+ * When the softmax is truncated to all the other points, the objective and the
+ * gradients should be the same as those of the exact softmax.
+ */
+TEST_CASE("SoftmaxTruncatedAllNeighbors", "[NCATesT]")
+{
+  arma::mat data(3, 20, arma::fill::randu);
+  arma::Row<size_t> labels =
+      arma::randi<arma::Row<size_t>>(20, arma::distr_param(0, 2));
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> exact(data, labels);
+  SoftmaxErrorFunction<SquaredEuclideanDistance> truncated(data, labels,
+      SquaredEuclideanDistance(), 19);
+
+  const arma::mat coordinates = arma::eye<arma::mat>(3, 3) +
+      0.5 * arma::randu<arma::mat>(3, 3);
+
+  REQUIRE(truncated.Evaluate(coordinates) ==
+      Approx(exact.Evaluate(coordinates)).epsilon(1e-7));
+
+  arma::mat exactGradient, truncatedGradient;
+  exact.Gradient(coordinates, exactGradient);
+  truncated.Gradient(coordinates, truncatedGradient);
+  REQUIRE(arma::approx_equal(truncatedGradient, exactGradient, "both", 1e-7,
+      1e-7));
+
+  for (size_t i = 0; i < 20; i += 5)
+  {
+    REQUIRE(truncated.Evaluate(coordinates, i, 5) ==
+        Approx(exact.Evaluate(coordinates, i, 5)).epsilon(1e-7));
+
+    exact.Gradient(coordinates, i, exactGradient, 5);
+    truncated.Gradient(coordinates, i, truncatedGradient, 5);
+    REQUIRE(arma::approx_equal(truncatedGradient, exactGradient, "both", 1e-7,
+        1e-7));
+  }
+}
+
+/**
+ * Ensure the gradients of the truncated softmax match a finite-difference
+ * approximation of the objective, and the separable gradients sum to the
+ * non-separable gradient.
+ */
+TEST_CASE("SoftmaxTruncatedGradient", "[NCATesT]")
+{
+  arma::mat data(2, 100, arma::fill::randu);
+  arma::Row<size_t> labels =
+      arma::randi<arma::Row<size_t>>(100, arma::distr_param(0, 1));
+
+  // Never search the neighbors again, so that the objective is smooth.
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels,
+      SquaredEuclideanDistance(), 10, 1000);
+
+  const arma::mat coordinates = 3 * arma::eye<arma::mat>(2, 2);
+  arma::mat gradient;
+  sef.Gradient(coordinates, gradient);
+
+  const double h = 1e-6;
+  for (size_t i = 0; i < coordinates.n_elem; ++i)
+  {
+    arma::mat plus(coordinates), minus(coordinates);
+    plus[i] += h;
+    minus[i] -= h;
+    const double estimate = (sef.Evaluate(plus) - sef.Evaluate(minus)) /
+        (2 * h);
+    REQUIRE(gradient[i] == Approx(estimate).epsilon(1e-4).margin(1e-6));
+  }
+
+  arma::mat batchGradient, sum(2, 2, arma::fill::zeros);
+  for (size_t i = 0; i < 100; i += 10)
+  {
+    sef.Gradient(coordinates, i, batchGradient, 10);
+    sum += batchGradient;
+  }
+  REQUIRE(arma::approx_equal(sum, gradient, "both", 1e-7, 1e-7));
+}
+
+/**
+ * The softmax can't be truncated to as many neighbors as there are points.
+ */
+TEST_CASE("SoftmaxTruncatedTooManyNeighbors", "[NCATesT]")
+{
+  arma::mat data(2, 10, arma::fill::randu);
+  arma::Row<size_t> labels(10, arma::fill::zeros);
+
+  REQUIRE_THROWS_AS(SoftmaxErrorFunction<SquaredEuclideanDistance>(data,
+      labels, SquaredEuclideanDistance(), 10), std::invalid_argument);
+}
+
 //
 // Tests for the NCA algorithm.
 //
@@ -314,3 +403,25 @@ TEST_CASE("NCALBFGSSimpleDataset", "[NCATesT]")
   // norm is close to 0.
   REQUIRE(arma::norm(finalGradient, 2) < 1e-6);
 }
+
+/**
+ * NCA with a truncated softmax should still separate the simple dataset.
+ */
+TEST_CASE("NCALBFGSTruncatedSimpleDataset", "[NCATesT]")
+{
+  // Useful but simple dataset with six points and two classes.
+  arma::mat data           = "-0.1 -0.1 -0.1  0.1  0.1  0.1;"
+                             " 1.0  0.0 -1.0  1.0  0.0 -1.0 ";
+  arma::Row<size_t> labels = " 0    0    0    1    1    1   ";
+
+  NCA<SquaredEuclideanDistance, L_BFGS> nca(data, labels,
+      SquaredEuclideanDistance(), 3);
+  nca.Optimizer().NumBasis() = 5;
+
+  arma::mat outputMatrix;
+  nca.LearnDistance(outputMatrix);
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  REQUIRE(sef.Evaluate(outputMatrix) < sef.Evaluate(arma::eye<arma::mat>(2,
+      2)));
+}
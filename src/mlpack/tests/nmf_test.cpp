@@ -240,6 +240,125 @@ TEST_CASE("SparseNMFALSTest", "[NMFTest]")
   REQUIRE(success == true);
 }
 
+/**
+ * Check that the factorization is not too different from the input matrix when
+ * the factors are single-precision.  Random Acol initialization, distance
+ * minimization update.
+ */
+TEST_CASE("NMFFloatAcolDistTest", "[NMFTest]")
+{
+  fmat w = randu<fmat>(20, 12);
+  fmat h = randu<fmat>(12, 20);
+  fmat v = w * h;
+  const size_t r = 12;
+
+  SimpleResidueTermination srt(1e-5, 10000);
+  AMF<SimpleResidueTermination, RandomAcolInitialization<> > nmf(srt);
+  nmf.Apply(v, r, w, h);
+
+  fmat wh = w * h;
+
+  REQUIRE(arma::norm(v - wh, "fro") / arma::norm(v, "fro") ==
+      Approx(0.0).margin(0.15));
+}
+
+/**
+ * Check that the sparse divergence update gives the same results as the dense
+ * divergence update, given the same initialization.
+ */
+TEST_CASE("SparseNMFRandomDivTest", "[NMFTest]")
+{
+  sp_mat v;
+  v.sprandu(20, 20, 0.3);
+  // Ensure there is at least one nonzero element in every row and column.
+  for (size_t i = 0; i < 20; ++i)
+    v(i, i) += 0.01;
+  mat dv(v); // Make a dense copy.
+  const size_t r = 10;
+
+  // Get an initialization.
+  arma::mat iw, ih;
+  RandomAMFInitialization::Initialize(v, r, iw, ih);
+  GivenInitialization g(std::move(iw), std::move(ih));
+
+  // The GivenInitialization will force the same initialization for both
+  // Apply() calls.
+  MaxIterationTermination mit(200);
+  AMF<MaxIterationTermination,
+      GivenInitialization,
+      NMFMultiplicativeDivergenceUpdate> nmf(mit, g);
+  mat w, h, dw, dh;
+  nmf.Apply(v, r, w, h);
+  nmf.Apply(dv, r, dw, dh);
+
+  const mat vp = w * h;
+  const mat dvp = dw * dh;
+
+  REQUIRE(arma::norm(vp - dvp, "fro") / arma::norm(vp, "fro") ==
+      Approx(0.0).margin(1e-5));
+}
+
+/**
+ * Check that the observed-only update rules fit the nonzero entries of a sparse
+ * low-rank matrix, and leave the factors of empty rows unchanged.
+ */
+TEMPLATE_TEST_CASE("SparseNMFObservedTest", "[NMFTest]",
+    NMFObservedDistanceUpdate, NMFObservedDivergenceUpdate)
+{
+  typedef TestType UpdateRuleType;
+
+  // Take half of the entries of a positive rank-3 matrix as observed.
+  const mat lw = randu<mat>(30, 3) + 0.1;
+  const mat lh = randu<mat>(3, 30) + 0.1;
+  const mat l = lw * lh;
+  mat observed = l;
+  observed.elem(find(randu<mat>(30, 30) < 0.5)).zeros();
+  // Ensure there is at least one nonzero element in the other rows, and make
+  // the last row empty.
+  for (size_t i = 0; i < 29; ++i)
+    observed(i, i) = l(i, i);
+  observed.row(29).zeros();
+  const sp_mat v(observed);
+  const size_t r = 3;
+
+  bool success = false;
+  const size_t trials = 3;
+  for (size_t trial = 0; trial < trials; ++trial)
+  {
+    arma::mat iw, ih;
+    RandomAMFInitialization::Initialize(v, r, iw, ih);
+    iw += 0.1;
+    ih += 0.1;
+    const arma::rowvec emptyRow = iw.row(29);
+    GivenInitialization g(std::move(iw), std::move(ih));
+
+    SimpleResidueTermination srt(1e-10, 20000);
+    AMF<SimpleResidueTermination, GivenInitialization, UpdateRuleType>
+        nmf(srt, g);
+    mat w, h;
+    nmf.Apply(v, r, w, h);
+
+    REQUIRE(arma::approx_equal(w.row(29), emptyRow, "absdiff", 1e-10));
+
+    // Compute the relative error on the observed entries only.
+    double error = 0.0, norm = 0.0;
+    for (sp_mat::const_iterator it = v.begin(); it != v.end(); ++it)
+    {
+      const double product = arma::dot(w.row(it.row()), h.col(it.col()));
+      error += std::pow((*it) - product, 2.0);
+      norm += std::pow((*it), 2.0);
+    }
+
+    if (std::sqrt(error / norm) < 0.05)
+    {
+      success = true;
+      break;
+    }
+  }
+
+  REQUIRE(success == true);
+}
+
 /**
  * Check if all elements in W and H are non-negative.
  * Default Case.
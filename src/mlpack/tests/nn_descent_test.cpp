@@ -0,0 +1,127 @@
+/**
+ * @file tests/nn_descent_test.cpp
+ *
+ * Unit tests for the 'NNDescent' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include "catch.hpp"
+#include "test_catch_tools.hpp"
+
+#include <mlpack/methods/nn_descent.hpp>
+#include <mlpack/methods/neighbor_search.hpp>
+
+using namespace mlpack;
+
+/**
+ * Return the fraction of the true neighbors that were found.
+ */
+inline double Recall(const arma::Mat<size_t>& neighbors,
+                     const arma::Mat<size_t>& trueNeighbors)
+{
+  size_t found = 0;
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      if (arma::any(trueNeighbors.col(i) == neighbors(j, i)))
+        ++found;
+    }
+  }
+
+  return double(found) / neighbors.n_elem;
+}
+
+/**
+ * Make sure that the graph built by NN-Descent is close to the exact graph in
+ * high dimensions, with both initializations.
+ */
+TEST_CASE("NNDescentRecallTest", "[NNDescentTest]")
+{
+  arma::mat data(40, 1500, arma::fill::randu);
+
+  KNN knn(data);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(10, trueNeighbors, trueDistances);
+
+  for (size_t treeInit = 0; treeInit < 2; ++treeInit)
+  {
+    NNDescent<> nnd(data, 15, 1.0, 0.001, (treeInit == 1));
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    nnd.Search(10, neighbors, distances);
+
+    REQUIRE(neighbors.n_rows == 10);
+    REQUIRE(neighbors.n_cols == 1500);
+    REQUIRE(distances.n_rows == 10);
+    REQUIRE(distances.n_cols == 1500);
+    REQUIRE(Recall(neighbors, trueNeighbors) >= 0.9);
+
+    // Far fewer distances than a brute-force search must be computed.
+    REQUIRE(nnd.DistanceEvaluations() < 1500 * 1499 / 2);
+
+    // The neighbors are sorted, exclude the point itself, and the distances
+    // are correct.
+    for (size_t i = 0; i < neighbors.n_cols; ++i)
+    {
+      for (size_t j = 0; j < neighbors.n_rows; ++j)
+      {
+        REQUIRE(neighbors(j, i) != i);
+        REQUIRE(distances(j, i) == Approx(EuclideanDistance::Evaluate(
+            data.col(i), data.col(neighbors(j, i)))).epsilon(1e-10));
+        if (j > 0)
+          REQUIRE(distances(j, i) >= distances(j - 1, i));
+      }
+    }
+  }
+}
+
+/**
+ * On a small dataset, NN-Descent finds (almost) the exact graph, and its
+ * result only depends on the random seed.
+ */
+TEST_CASE("NNDescentExactSmallTest", "[NNDescentTest]")
+{
+  arma::mat data(5, 60, arma::fill::randu);
+
+  KNN knn(data);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(4, trueNeighbors, trueDistances);
+
+  RandomSeed(42);
+  NNDescent<> nnd(data, 20, 1.0, 0.0);
+  arma::Mat<size_t> neighbors, neighbors2;
+  arma::mat distances, distances2;
+  nnd.Search(4, neighbors, distances);
+
+  REQUIRE(Recall(neighbors, trueNeighbors) >= 0.95);
+
+  RandomSeed(42);
+  nnd.Search(4, neighbors2, distances2);
+  CheckMatrices(neighbors, neighbors2);
+  CheckMatrices(distances, distances2);
+}
+
+/**
+ * Make sure invalid values of k are rejected.
+ */
+TEST_CASE("NNDescentInvalidKTest", "[NNDescentTest]")
+{
+  arma::mat data(3, 10, arma::fill::randu);
+  NNDescent<> nnd(data);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  REQUIRE_THROWS_AS(nnd.Search(10, neighbors, distances),
+      std::invalid_argument);
+
+  nnd.Search(0, neighbors, distances);
+  REQUIRE(neighbors.n_rows == 0);
+  REQUIRE(neighbors.n_cols == 10);
+}
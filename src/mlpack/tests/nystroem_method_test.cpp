@@ -193,3 +193,52 @@ TEST_CASE("GermanTest", "[NystroemMethodTest]")
     REQUIRE(avgError == Approx(0.0).margin(results[trial]));
   }
 }
+
+/**
+ * Make sure that the single-precision approximation is close to the
+ * double-precision one.
+ */
+TEST_CASE("FloatOrderedSelectionTest", "[NystroemMethodTest]")
+{
+  arma::mat data(5, 300, arma::fill::randu);
+  arma::fmat fdata = arma::conv_to<arma::fmat>::from(data);
+
+  GaussianKernel gk;
+  NystroemMethod<GaussianKernel, OrderedSelection> nm(data, gk, 30);
+  NystroemMethod<GaussianKernel, OrderedSelection, arma::fmat> fnm(fdata, gk,
+      30);
+
+  arma::mat g;
+  arma::fmat fg;
+  nm.Apply(g);
+  fnm.Apply(fg);
+
+  const arma::mat approximation = g * g.t();
+  const arma::mat fapproximation = arma::conv_to<arma::mat>::from(fg * fg.t());
+
+  REQUIRE(arma::norm(approximation - fapproximation, "fro") /
+      arma::norm(approximation, "fro") == Approx(0.0).margin(1e-3));
+}
+
+/**
+ * Make sure that the centroids of mini-batch k-means give a good approximation
+ * of the kernel matrix, with single-precision data.
+ */
+TEST_CASE("MiniBatchKMeansSelectionTest", "[NystroemMethodTest]")
+{
+  arma::fmat data(5, 1000, arma::fill::randu);
+
+  GaussianKernel gk;
+  arma::fmat kernel;
+  KernelMatrix(gk, data, data, kernel);
+
+  NystroemMethod<GaussianKernel, MiniBatchKMeansSelection<arma::fmat>,
+      arma::fmat> nm(data, gk, 50);
+  arma::fmat g;
+  nm.Apply(g);
+
+  REQUIRE(g.n_rows == 1000);
+  REQUIRE(g.n_cols == 50);
+  REQUIRE(arma::norm(kernel - g * g.t(), "fro") / arma::norm(kernel, "fro") ==
+      Approx(0.0).margin(0.1));
+}
@@ -341,3 +341,79 @@ TEST_CASE("OctreeSerializationTest", "[OctreeTest]")
   delete binaryTree;
   delete jsonTree;
 }
+
+/**
+ * Make sure that an octree built with several threads is the same as an octree
+ * built with one thread, and that the dataset is laid out in the same order.
+ */
+TEST_CASE("OctreeParallelBuildTest", "[OctreeTest]")
+{
+  arma::mat dataset(3, 20000, arma::fill::randu);
+  std::vector<size_t> serialOldFromNew, parallelOldFromNew;
+
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  Octree<> serialTree(dataset, serialOldFromNew, 5);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(4);
+#endif
+
+  Octree<> parallelTree(dataset, parallelOldFromNew, 5);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+
+  CheckSameNode(serialTree, parallelTree);
+  CheckOverlap(parallelTree);
+  REQUIRE(serialOldFromNew == parallelOldFromNew);
+  REQUIRE(arma::approx_equal(serialTree.Dataset(), parallelTree.Dataset(),
+      "absdiff", 0.0));
+  for (size_t i = 0; i < parallelOldFromNew.size(); ++i)
+  {
+    REQUIRE(arma::approx_equal(dataset.col(parallelOldFromNew[i]),
+        parallelTree.Dataset().col(i), "absdiff", 0.0));
+  }
+}
+
+/**
+ * Build an octree on a cluster of points that is much smaller than the extent
+ * of the data, so that the Morton codes run out of levels before the leaves
+ * are reached, and make sure the tree is still valid.
+ */
+TEST_CASE("OctreeDeepClusterTest", "[OctreeTest]")
+{
+  arma::mat dataset(3, 202);
+  dataset.col(0).zeros();
+  dataset.col(1).ones();
+  dataset.cols(2, 201) = 0.5 + 1e-10 * arma::randu<arma::mat>(3, 200);
+  std::vector<size_t> oldFromNew;
+
+  Octree<> t(dataset, oldFromNew, 4);
+
+  REQUIRE(t.NumDescendants() == 202);
+  CheckOverlap(t);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+  {
+    REQUIRE(arma::approx_equal(dataset.col(oldFromNew[i]), t.Dataset().col(i),
+        "absdiff", 0.0));
+  }
+
+  // Every leaf holds at most four points.
+  std::stack<const Octree<>*> nodes;
+  nodes.push(&t);
+  while (!nodes.empty())
+  {
+    const Octree<>* node = nodes.top();
+    nodes.pop();
+
+    if (node->NumChildren() == 0)
+      REQUIRE(node->NumPoints() <= 4);
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      nodes.push(&node->Child(i));
+  }
+}
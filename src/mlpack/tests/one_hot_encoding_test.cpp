@@ -229,3 +229,93 @@ TEST_CASE("OneHotEncodingDatasetinfoTest", "[OneHotEncodingTest]")
 
   remove("test.csv");
 }
+
+/**
+ * Make sure the sparse one-hot encoding of a matrix matches the dense one.
+ */
+TEST_CASE("OneHotEncodingSparseOutputTest", "[OneHotEncodingTest]")
+{
+  arma::mat input = arma::floor(5.0 * arma::randu<arma::mat>(6, 100));
+  // Some numeric values are not zero.
+  input.row(2) += 0.5 * arma::randu<arma::rowvec>(100);
+  arma::Col<size_t> indices("0 3 5");
+
+  arma::mat dense;
+  arma::sp_mat sparse;
+  data::OneHotEncoding(input, indices, dense);
+  data::OneHotEncoding(input, indices, sparse);
+
+  REQUIRE(sparse.n_rows == dense.n_rows);
+  REQUIRE(sparse.n_cols == dense.n_cols);
+  CheckMatrices(arma::mat(sparse), dense);
+
+  // The labels version.
+  arma::Row<size_t> labels("3 1 3 7 1 0");
+  arma::mat denseLabels;
+  arma::sp_mat sparseLabels;
+  data::OneHotEncoding(labels, denseLabels);
+  data::OneHotEncoding(labels, sparseLabels);
+  REQUIRE(sparseLabels.n_nonzero == 6);
+  CheckMatrices(arma::mat(sparseLabels), denseLabels);
+}
+
+/**
+ * Make sure that chunks encoded with a fixed DatasetInfo use the same
+ * dimensions for the same categories, whatever categories each chunk holds.
+ */
+TEST_CASE("OneHotEncodeChunkTest", "[OneHotEncodingTest]")
+{
+  fstream f;
+  f.open("test.csv", fstream::out);
+  f << "1, 2, hello" << endl;
+  f << "3, 4, goodbye" << endl;
+  f << "5, 0, coffee" << endl;
+  f << "7, 8, confusion" << endl;
+  f << "9, 10, hello" << endl;
+  f << "11, 12, confusion" << endl;
+  f << "13, 14, confusion" << endl;
+  f.close();
+
+  arma::mat matrix;
+  DatasetInfo info;
+  if (!data::Load("test.csv", matrix, info))
+    FAIL("Cannot load dataset test.csv");
+  remove("test.csv");
+
+  REQUIRE(data::OneHotEncodedDimensionality(info) == 6);
+
+  arma::mat full;
+  data::OneHotEncodeChunk(matrix, full, info);
+  REQUIRE(full.n_rows == 6);
+  REQUIRE(full.n_cols == 7);
+  for (size_t i = 0; i < matrix.n_cols; ++i)
+  {
+    REQUIRE(full(0, i) == matrix(0, i));
+    REQUIRE(full(1, i) == matrix(1, i));
+    REQUIRE(arma::accu(full.col(i).subvec(2, 5)) == 1.0);
+    REQUIRE(full(2 + size_t(matrix(2, i)), i) == 1.0);
+  }
+
+  // Encode the dataset in chunks of two points.
+  for (size_t begin = 0; begin < matrix.n_cols; begin += 2)
+  {
+    const size_t end = std::min(begin + 2, (size_t) matrix.n_cols) - 1;
+    const arma::mat chunk = matrix.cols(begin, end);
+
+    arma::mat dense;
+    arma::sp_mat sparse;
+    data::OneHotEncodeChunk(chunk, dense, info);
+    data::OneHotEncodeChunk(chunk, sparse, info);
+    CheckMatrices(dense, arma::mat(full.cols(begin, end)));
+    CheckMatrices(arma::mat(sparse), dense);
+  }
+
+  // Values that are not mappings of the DatasetInfo are rejected.
+  arma::mat invalid(matrix.col(0));
+  invalid(2) = 4;
+  arma::mat output;
+  REQUIRE_THROWS_AS(data::OneHotEncodeChunk(invalid, output, info),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(data::OneHotEncodeChunk(arma::mat(2, 3), output, info),
+      std::invalid_argument);
+}
@@ -198,6 +198,19 @@ TEST_CASE("ArmaComparisonRandomizedPCATest", "[PCATest]")
   ArmaComparisonPCA<RandomizedSVDPCAPolicy>();
 }
 
+/**
+ * Compare the output of our randomized-SVD and randomized block krylov PCA
+ * implementations with Armadillo's, when the data is read in chunks.
+ */
+TEST_CASE("ArmaComparisonChunkedRandomizedPCATest", "[PCATest]")
+{
+  RandomizedSVDPCAPolicy randomizedSVD(0, 2, 100);
+  ArmaComparisonPCA<RandomizedSVDPCAPolicy>(false, randomizedSVD);
+
+  RandomizedBlockKrylovSVDPolicy blockKrylovSVD(5, 0, 100);
+  ArmaComparisonPCA<RandomizedBlockKrylovSVDPolicy>(false, blockKrylovSVD);
+}
+
 /**
  * Test that dimensionality reduction with exact-svd PCA works the same way
  * MATLAB does (which should be correct!).
@@ -330,3 +343,88 @@ TEST_CASE("PCAScalingTest", "[PCATest]")
   // The eigenvalues should sum to three.
   REQUIRE(accu(eigval) == Approx(3.0).epsilon(0.001));
 }
+
+/**
+ * Compare the output of our incremental PCA implementation with Armadillo's,
+ * when the data is processed in several chunks.
+ */
+TEST_CASE("ArmaComparisonIncrementalPCATest", "[PCATest]")
+{
+  IncrementalSVDPolicy decomposition(0, 37);
+  ArmaComparisonPCA<IncrementalSVDPolicy>(false, decomposition);
+}
+
+/**
+ * Test that dimensionality reduction with incremental PCA works the same way
+ * MATLAB does, when the points are processed two at a time.
+ */
+TEST_CASE("IncrementalPCADimensionalityReductionTest", "[PCATest]")
+{
+  IncrementalSVDPolicy decomposition(0, 2);
+  PCADimensionalityReduction<IncrementalSVDPolicy>(false, decomposition);
+}
+
+/**
+ * Test that setting the variance retained parameter to perform dimensionality
+ * reduction works using the incremental PCA method.
+ */
+TEST_CASE("IncrementalPCAVarianceRetainedTest", "[PCATest]")
+{
+  PCAVarianceRetained<IncrementalSVDPolicy>();
+}
+
+/**
+ * Test that updating the incremental PCA chunk by chunk, keeping only a few
+ * components, recovers the principal components of low-rank data.
+ */
+TEST_CASE("IncrementalPCAUpdateTest", "[PCATest]")
+{
+  // The data lies in a 3-dimensional subspace of a 10-dimensional space, with
+  // a nonzero mean.
+  arma::mat basis = arma::randn<arma::mat>(10, 3);
+  arma::mat data = basis * arma::randn<arma::mat>(3, 1000);
+  data.each_col() += arma::linspace<arma::vec>(1.0, 10.0, 10);
+
+  IncrementalSVDPolicy pca(3);
+  for (size_t i = 0; i < data.n_cols; i += 50)
+    pca.Update(data.cols(i, i + 49));
+
+  REQUIRE(pca.NumPoints() == 1000);
+  REQUIRE(pca.Components().n_rows == 10);
+  REQUIRE(pca.Components().n_cols == 3);
+
+  const arma::vec mean = arma::mean(data, 1);
+  for (size_t i = 0; i < mean.n_elem; ++i)
+    REQUIRE(pca.Mean()[i] == Approx(mean[i]).epsilon(1e-8));
+
+  // Compare with the exact decomposition.
+  arma::mat exactTransformed, exactEigvec;
+  arma::vec exactEigval;
+  PCA<ExactSVDPolicy> exact;
+  exact.Apply(data, exactTransformed, exactEigval, exactEigvec);
+
+  const arma::vec eigval = pca.EigenValues();
+  for (size_t i = 0; i < 3; ++i)
+    REQUIRE(eigval[i] == Approx(exactEigval[i]).epsilon(1e-6));
+
+  arma::mat transformed;
+  pca.Transform(data, transformed);
+  REQUIRE(transformed.n_rows == 3);
+  REQUIRE(transformed.n_cols == 1000);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    // The components may point in the opposite direction.
+    if (arma::dot(transformed.row(i), exactTransformed.row(i)) < 0)
+      transformed.row(i) *= -1;
+
+    for (size_t j = 0; j < transformed.n_cols; ++j)
+    {
+      REQUIRE(transformed(i, j) ==
+          Approx(exactTransformed(i, j)).epsilon(1e-5).margin(1e-6));
+    }
+  }
+
+  // Points of another dimensionality are rejected.
+  REQUIRE_THROWS_AS(pca.Update(arma::randu<arma::mat>(5, 10)),
+      std::invalid_argument);
+}
@@ -13,6 +13,7 @@
 #include <mlpack/methods/perceptron.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace mlpack;
 using namespace arma;
@@ -363,3 +364,118 @@ TEST_CASE("TrainFormTest", "[PerceptronTest]")
   REQUIRE(all(predictions5 == trueLabels));
   REQUIRE(all(predictions6 == trueLabels));
 }
+
+/**
+ * The batch update of SimpleWeightUpdate should be the sum of the updates of
+ * each point, and correctly classified points should not change the weights.
+ */
+TEST_CASE("SimpleWeightUpdateBatch", "[PerceptronTest]")
+{
+  mat points(4, 20, fill::randu);
+  Row<size_t> incorrectClasses(20), correctClasses(20);
+  rowvec instanceWeights(20, fill::randu);
+  for (size_t i = 0; i < 20; ++i)
+  {
+    incorrectClasses[i] = RandInt(0, 3);
+    // A quarter of the points are correctly classified.
+    correctClasses[i] = (i % 4 == 0) ? incorrectClasses[i] : RandInt(0, 3);
+  }
+
+  mat weights(4, 3, fill::randu);
+  vec biases(3, fill::randu);
+  mat expectedWeights = weights;
+  vec expectedBiases = biases;
+
+  SimpleWeightUpdate wip;
+  for (size_t i = 0; i < 20; ++i)
+  {
+    if (incorrectClasses[i] != correctClasses[i])
+    {
+      wip.UpdateWeights(points.col(i), expectedWeights, expectedBiases,
+          incorrectClasses[i], correctClasses[i], instanceWeights[i]);
+    }
+  }
+
+  wip.UpdateWeights(points, weights, biases, incorrectClasses, correctClasses,
+      instanceWeights);
+
+  CheckMatrices(weights, expectedWeights);
+  CheckMatrices(biases, expectedBiases);
+}
+
+/**
+ * A learning policy without a batch UpdateWeights(), to test the fallback of
+ * mini-batch training.
+ */
+class PointWeightUpdate
+{
+ public:
+  template<typename VecType, typename eT>
+  void UpdateWeights(const VecType& trainingPoint,
+                     arma::Mat<eT>& weights,
+                     arma::Col<eT>& biases,
+                     const size_t incorrectClass,
+                     const size_t correctClass,
+                     const eT instanceWeight = 1.0)
+  {
+    SimpleWeightUpdate().UpdateWeights(trainingPoint, weights, biases,
+        incorrectClass, correctClass, instanceWeight);
+  }
+};
+
+/**
+ * Mini-batch training should converge on a linearly separable dataset, and
+ * give the same model with and without a batch UpdateWeights().
+ */
+TEST_CASE("MiniBatchTraining", "[PerceptronTest]")
+{
+  // Three well-separated Gaussians.
+  mat trainData(2, 600);
+  Row<size_t> labels(600);
+  const mat centers = { { 0.0, 10.0, 0.0 }, { 0.0, 0.0, 10.0 } };
+  for (size_t i = 0; i < 600; ++i)
+  {
+    labels[i] = i % 3;
+    trainData.col(i) = centers.col(i % 3) + randn<vec>(2);
+  }
+
+  REQUIRE(!HasBatchUpdateWeights<PointWeightUpdate, double>::value);
+  REQUIRE(HasBatchUpdateWeights<SimpleWeightUpdate, double>::value);
+
+  Perceptron<> p(trainData, labels, 3, 1000, 32);
+  REQUIRE(p.BatchSize() == 32);
+
+  Row<size_t> predictedLabels;
+  p.Classify(trainData, predictedLabels);
+  REQUIRE(accu(predictedLabels != labels) == 0);
+
+  Perceptron<PointWeightUpdate> p2(trainData, labels, 3, 1000, 32);
+  CheckMatrices(p2.Weights(), p.Weights());
+  CheckMatrices(p2.Biases(), p.Biases());
+
+  // The instance weights are used in mini-batches too.
+  const rowvec instanceWeights(600, fill::ones);
+  Perceptron<> p3(trainData, labels, 3, instanceWeights, 1000, 32);
+  CheckMatrices(p3.Weights(), p.Weights());
+  CheckMatrices(p3.Biases(), p.Biases());
+}
+
+/**
+ * Classification of many points, in blocks, should agree with the
+ * classification of each point.
+ */
+TEST_CASE("BlockClassify", "[PerceptronTest]")
+{
+  mat trainData(5, 3000, fill::randu);
+  Row<size_t> labels(3000);
+  for (size_t i = 0; i < 3000; ++i)
+    labels[i] = (trainData(0, i) > 0.5) ? 1 : 0;
+
+  Perceptron<> p(trainData, labels, 2, 10);
+
+  Row<size_t> predictedLabels;
+  p.Classify(trainData, predictedLabels);
+  REQUIRE(predictedLabels.n_elem == 3000);
+  for (size_t i = 0; i < 3000; ++i)
+    REQUIRE(predictedLabels[i] == p.Classify(trainData.col(i)));
+}
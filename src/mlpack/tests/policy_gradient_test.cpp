@@ -269,6 +269,42 @@ TEST_CASE("PendulumWithTD3", "[PolicyGradientTest]")
   REQUIRE(converged);
 }
 
+//! Make sure that TD3::ParallelTrain() takes the given number of steps.
+TEST_CASE("PendulumWithParallelTD3", "[PolicyGradientTest]")
+{
+  RandomReplay<Pendulum> replayMethod(32, 10000);
+
+  TrainingConfig config;
+  config.StepSize() = 0.001;
+  config.TargetNetworkSyncInterval() = 2;
+  config.UpdateInterval() = 3;
+  config.ExplorationSteps() = 100;
+
+  FFN<EmptyLoss, GaussianInitialization>
+      policyNetwork(EmptyLoss(), GaussianInitialization(0, 0.1));
+  policyNetwork.Add(new Linear(32));
+  policyNetwork.Add(new ReLU());
+  policyNetwork.Add(new Linear(1));
+  policyNetwork.Add(new TanH());
+
+  FFN<EmptyLoss, GaussianInitialization>
+      qNetwork(EmptyLoss(), GaussianInitialization(0, 0.1));
+  qNetwork.Add(new Linear(32));
+  qNetwork.Add(new ReLU());
+  qNetwork.Add(new Linear(1));
+
+  TD3<Pendulum, decltype(qNetwork), decltype(policyNetwork), AdamUpdate>
+      agent(config, qNetwork, policyNetwork, replayMethod);
+
+  // Pendulum rewards are never positive.
+  const double meanReturn = agent.ParallelTrain(3, 600, 50);
+  REQUIRE(meanReturn <= 0.0);
+  REQUIRE(agent.TotalSteps() == 600);
+  REQUIRE(replayMethod.Size() == 600);
+
+  REQUIRE_THROWS_AS(agent.ParallelTrain(0, 10), std::invalid_argument);
+}
+
 //! A test to ensure TD3 works with multiple actions in action space.
 TEST_CASE("TD3ForMultipleActions", "[PolicyGradientTest]")
 {
@@ -395,3 +431,39 @@ TEST_CASE("SACForMultipleActions", "[PolicyGradientTest]")
   // If the agent is able to reach till this point of the test, it is assured
   // that the agent can handle multiple actions in continuous space.
 }
+
+//! Make sure that SAC::ParallelTrain() takes the given number of steps.
+TEST_CASE("PendulumWithParallelSAC", "[PolicyGradientTest]")
+{
+  RandomReplay<Pendulum> replayMethod(32, 10000);
+
+  TrainingConfig config;
+  config.StepSize() = 0.001;
+  config.TargetNetworkSyncInterval() = 2;
+  config.UpdateInterval() = 3;
+  config.ExplorationSteps() = 100;
+
+  FFN<EmptyLoss, GaussianInitialization>
+      policyNetwork(EmptyLoss(), GaussianInitialization(0, 0.1));
+  policyNetwork.Add(new Linear(32));
+  policyNetwork.Add(new ReLU());
+  policyNetwork.Add(new Linear(1));
+  policyNetwork.Add(new TanH());
+
+  FFN<EmptyLoss, GaussianInitialization>
+      qNetwork(EmptyLoss(), GaussianInitialization(0, 0.1));
+  qNetwork.Add(new Linear(32));
+  qNetwork.Add(new ReLU());
+  qNetwork.Add(new Linear(1));
+
+  SAC<Pendulum, decltype(qNetwork), decltype(policyNetwork), AdamUpdate>
+      agent(config, qNetwork, policyNetwork, replayMethod);
+
+  // Pendulum rewards are never positive.
+  const double meanReturn = agent.ParallelTrain(3, 600, 50);
+  REQUIRE(meanReturn <= 0.0);
+  REQUIRE(agent.TotalSteps() == 600);
+  REQUIRE(replayMethod.Size() == 600);
+
+  REQUIRE_THROWS_AS(agent.ParallelTrain(0, 10), std::invalid_argument);
+}
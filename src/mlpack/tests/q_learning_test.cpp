@@ -51,6 +51,53 @@ TEST_CASE("CartPoleWithDQN", "[QLearningTest]")
   REQUIRE(converged);
 }
 
+//! Test DQN in Cart Pole task, stepping several copies of the task at once.
+TEST_CASE("CartPoleWithDQNVectorEnvironment", "[QLearningTest]")
+{
+  // Set up the network.
+  SimpleDQN<> network(128, 128, 2);
+
+  // Set up the policy and replay method.
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+  RandomReplay<CartPole> replayMethod(10, 10000);
+
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.9;
+  config.TargetNetworkSyncInterval() = 100;
+  config.ExplorationSteps() = 100;
+  config.DoubleQLearning() = false;
+
+  // Set up DQN agent.
+  QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      agent(config, network, policy, replayMethod);
+
+  // Step four copies of the task, until the average return of the last 50
+  // episodes is high enough.
+  VectorEnvironment<CartPole> environments(4, CartPole(), 200);
+  std::vector<double> returnList;
+  size_t episodes = 0;
+  bool converged = false;
+  while (!converged && episodes <= 1000)
+  {
+    agent.Step(environments);
+    for (double episodeReturn : environments.EpisodeReturns())
+    {
+      returnList.push_back(episodeReturn);
+      if (returnList.size() > 50)
+        returnList.erase(returnList.begin());
+      ++episodes;
+    }
+
+    const double averageReturn = std::accumulate(returnList.begin(),
+        returnList.end(), 0.0) / std::max(returnList.size(), (size_t) 1);
+    converged = (returnList.size() >= 50 && averageReturn > 40);
+  }
+
+  REQUIRE(agent.TotalSteps() > 0);
+  REQUIRE(converged);
+}
+
 //! Test DQN in Cart Pole task with Prioritized Replay.
 TEST_CASE("CartPoleWithDQNPrioritizedReplay", "[QLearningTest]")
 {
@@ -431,3 +478,37 @@ TEST_CASE("CartPoleWithCategoricalDQN", "[QLearningTest]")
   }
   REQUIRE(converged);
 }
+
+/**
+ * Check the categorical projection against hand-computed distributions,
+ * including a terminal transition clamped to the top of the support.
+ */
+TEST_CASE("CategoricalProjectionTest", "[QLearningTest]")
+{
+  // The support is {0, 1, 2, 3, 4}.
+  arma::mat nextDist(5, 3);
+  nextDist.col(0).fill(0.2);
+  nextDist.col(1) = arma::vec("0.1 0.2 0.3 0.2 0.2");
+  nextDist.col(2) = arma::vec("0.5 0.0 0.0 0.0 0.5");
+  const arma::rowvec rewards("1.0 10.0 -0.25");
+  const arma::irowvec isTerminal("0 1 0");
+
+  CategoricalProjection projection;
+  arma::mat projDist;
+  projection.Project(nextDist, rewards, isTerminal, 0.5, 0.0, 4.0, projDist);
+
+  // The atoms of the first transition move to {1, 1.5, 2, 2.5, 3}.  The second
+  // transition is terminal, so all of its mass goes to the clamped reward.  The
+  // atoms of the third transition move to -0.25 (clamped to 0) and 1.75.
+  const arma::mat expected("0.0 0.0 0.5;"
+                           "0.3 0.0 0.125;"
+                           "0.4 0.0 0.375;"
+                           "0.3 0.0 0.0;"
+                           "0.0 1.0 0.0");
+  REQUIRE(arma::approx_equal(projDist, expected, "absdiff", 1e-10));
+
+  // Projecting again with the same workspaces gives the same result.
+  arma::mat projDist2;
+  projection.Project(nextDist, rewards, isTerminal, 0.5, 0.0, 4.0, projDist2);
+  REQUIRE(arma::approx_equal(projDist, projDist2, "absdiff", 1e-10));
+}
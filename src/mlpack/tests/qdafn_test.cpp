@@ -240,3 +240,51 @@ TEST_CASE("QDAFNSparseTest", "[QDAFNTest]")
   REQUIRE(distances.n_rows == 3);
   REQUIRE(distances.n_cols == 1000);
 }
+
+/**
+ * Make sure that building the tables and searching in parallel gives the same
+ * model and results as doing it with one thread.
+ */
+TEST_CASE("QDAFNParallelTest", "[QDAFNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(10, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(10, 500);
+
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  RandomSeed(7);
+  QDAFN<> serial(dataset, 12, 40);
+  arma::Mat<size_t> serialNeighbors;
+  arma::mat serialDistances;
+  serial.Search(querySet, 3, serialNeighbors, serialDistances);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(4);
+#endif
+
+  RandomSeed(7);
+  QDAFN<> parallel(dataset, 12, 40);
+  arma::Mat<size_t> parallelNeighbors;
+  arma::mat parallelDistances;
+  parallel.Search(querySet, 3, parallelNeighbors, parallelDistances);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+
+  REQUIRE(parallel.NumProjections() == 12);
+  for (size_t t = 0; t < parallel.NumProjections(); ++t)
+  {
+    REQUIRE(parallel.CandidateSet(t).n_rows == 10);
+    REQUIRE(parallel.CandidateSet(t).n_cols == 40);
+    REQUIRE(arma::approx_equal(arma::mat(parallel.CandidateSet(t)),
+        arma::mat(serial.CandidateSet(t)), "absdiff", 1e-12));
+  }
+
+  REQUIRE(arma::all(arma::vectorise(serialNeighbors == parallelNeighbors)));
+  REQUIRE(arma::approx_equal(serialDistances, parallelDistances, "absdiff",
+      1e-12));
+}
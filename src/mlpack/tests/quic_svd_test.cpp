@@ -89,3 +89,30 @@ TEST_CASE("QUICSVDSameDimensionTest", "[QUICSVDTest]")
   arma::mat u, v, sigma;
   QUIC_SVD quicsvd(dataset, u, v, sigma);
 }
+
+/**
+ * The reconstruction error should still be small when several cosine tree
+ * nodes are split in each round.
+ */
+TEST_CASE("QUICSVDSplitsPerRoundTest", "[QUICSVDTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    FAIL("Cannot load dataset test_data_3_1000.csv");
+
+  // The Monte Carlo error calculation is random, so we require at least one
+  // success.
+  size_t successes = 0;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    arma::mat u, v, sigma;
+    QUIC_SVD quicsvd(dataset, u, v, sigma, 0.03, 0.1, 4);
+
+    const double relativeError = arma::norm(dataset - u * sigma * v.t(),
+        "frob") / arma::norm(dataset, "frob");
+    if (relativeError < 1e-5)
+      ++successes;
+  }
+
+  REQUIRE(successes > 0);
+}
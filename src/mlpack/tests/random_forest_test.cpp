@@ -92,6 +92,32 @@ TEST_CASE("BootstrapWeightsTest", "[RandomForestTest]")
   }
 }
 
+/**
+ * Make sure that the bootstrap indices and counts are valid samples.
+ */
+TEST_CASE("BootstrapIndicesCountsTest", "[RandomForestTest]")
+{
+  arma::uvec indices;
+  BootstrapIndices(1000, indices);
+  REQUIRE(indices.n_elem == 1000);
+  REQUIRE(indices.is_sorted());
+  REQUIRE(indices.max() < 1000);
+  // About 63% of the points are in a bootstrap sample.
+  const size_t unique = arma::uvec(arma::unique(indices)).n_elem;
+  REQUIRE(unique > 550);
+  REQUIRE(unique < 720);
+
+  arma::urowvec counts;
+  BootstrapCounts(1000, counts);
+  REQUIRE(counts.n_elem == 1000);
+  REQUIRE(arma::accu(counts) == 1000);
+  REQUIRE(arma::accu(counts > 0) > 550);
+  REQUIRE(arma::accu(counts > 0) < 720);
+
+  BootstrapIndices(0, indices);
+  REQUIRE(indices.n_elem == 0);
+}
+
 /**
  * Make sure an empty forest cannot predict.
  */
@@ -152,6 +178,44 @@ TEST_CASE("UnweightedNumericLearningTest", "[RandomForestTest]")
   REQUIRE(rfCorrect >= size_t(0.7 * testDataset.n_cols));
 }
 
+/**
+ * Test that a random forest built with the HistogramNumericSplit performs about
+ * as well as one built with the default BestBinaryNumericSplit.
+ */
+TEST_CASE("HistogramSplitNumericLearningTest", "[RandomForestTest]")
+{
+  // Load the vc2 dataset.
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2.csv");
+
+  RandomForest<GiniGain, MultipleRandomDimensionSelect,
+      HistogramNumericSplit> rf(dataset, labels, 3, 20 /* 20 trees */, 1,
+      1e-7);
+  RandomForest<> bestRF(dataset, labels, 3, 20 /* 20 trees */, 1, 1e-7);
+
+  // Get performance statistics on test data.
+  arma::mat testDataset;
+  if (!data::Load("vc2_test.csv", testDataset))
+    FAIL("Cannot load dataset vc2_test.csv");
+  arma::Row<size_t> testLabels;
+  if (!data::Load("vc2_test_labels.txt", testLabels))
+    FAIL("Cannot load dataset vc2_test_labels.txt");
+
+  arma::Row<size_t> predictions, bestPredictions;
+  rf.Classify(testDataset, predictions);
+  bestRF.Classify(testDataset, bestPredictions);
+
+  const size_t correct = accu(predictions == testLabels);
+  const size_t bestCorrect = accu(bestPredictions == testLabels);
+
+  REQUIRE(correct >= bestCorrect * 0.9);
+  REQUIRE(correct >= size_t(0.7 * testDataset.n_cols));
+}
+
 /**
  * Test weighted numeric learning, making sure that we get better performance
  * than a single decision tree.
@@ -376,6 +440,52 @@ TEST_CASE("RandomForestSerializationTest", "[RandomForestTest]")
       binaryProbabilities);
 }
 
+// Make sure a random forest can be saved into sections, and that a subset of
+// its trees can be loaded from them.
+TEST_CASE("RandomForestSectionsTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2.csv");
+
+  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 1);
+
+  data::SectionedModelWriter writer;
+  rf.SaveSections(writer, false, "rf/");
+  writer.Save("random_forest_sections.bin");
+
+  data::SectionedModelReader reader("random_forest_sections.bin");
+  REQUIRE(reader.HasSection("rf/tree/9"));
+
+  RandomForest<> loaded;
+  loaded.LoadSections(reader, 0, "rf/");
+  REQUIRE(loaded.NumTrees() == 10);
+
+  arma::Row<size_t> predictions, loadedPredictions;
+  arma::mat probabilities, loadedProbabilities;
+  rf.Classify(dataset, predictions, probabilities);
+  loaded.Classify(dataset, loadedPredictions, loadedProbabilities);
+  CheckMatrices(predictions, loadedPredictions);
+  CheckMatrices(probabilities, loadedProbabilities);
+
+  // Load only the first three trees.
+  RandomForest<> subset;
+  subset.LoadSections(reader, 3, "rf/");
+  REQUIRE(subset.NumTrees() == 3);
+  for (size_t t = 0; t < 3; ++t)
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      REQUIRE(subset.Tree(t).Classify(dataset.col(i)) ==
+          rf.Tree(t).Classify(dataset.col(i)));
+
+  REQUIRE_THROWS_AS(subset.LoadSections(reader, 11, "rf/"),
+      std::invalid_argument);
+
+  remove("random_forest_sections.bin");
+}
+
 /**
  * Test that RandomForest::Train() returns finite average entropy on numeric
  * dataset.
@@ -607,3 +717,175 @@ TEST_CASE("ExtraTreesAccuracyTest", "[RandomForestTest]")
 
   REQUIRE(accuracy >= 0.85);
 }
+
+/**
+ * Make sure that batch classification gives the same predictions and
+ * probabilities as classifying each point on its own, also when the
+ * probabilities are returned as floats.
+ */
+TEST_CASE("BatchClassifyTest", "[RandomForestTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 2300); // Not a multiple of the block size.
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+
+  RandomForest<> rf(trainingData, di, trainingLabels, 5, 10, 1, 1e-7, 0,
+      MultipleRandomDimensionSelect(4));
+
+  arma::Row<size_t> predictions, onlyPredictions, floatPredictions;
+  arma::mat probabilities;
+  arma::fmat floatProbabilities;
+  rf.Classify(testData, predictions, probabilities);
+  rf.Classify(testData, onlyPredictions);
+  rf.Classify(testData, floatPredictions, floatProbabilities);
+
+  REQUIRE(probabilities.n_rows == 5);
+  REQUIRE(probabilities.n_cols == testData.n_cols);
+  REQUIRE(floatProbabilities.n_rows == 5);
+  REQUIRE(floatProbabilities.n_cols == testData.n_cols);
+  REQUIRE(arma::all(predictions == onlyPredictions));
+  REQUIRE(arma::all(predictions == floatPredictions));
+  CheckMatrices(probabilities, arma::conv_to<arma::mat>::from(
+      floatProbabilities), 1e-5);
+
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    rf.Classify(testData.col(i), prediction, pointProbabilities);
+
+    REQUIRE(prediction == predictions[i]);
+    REQUIRE(arma::all(pointProbabilities == probabilities.col(i)));
+  }
+}
+
+/**
+ * Make sure that a flattened random forest gives the same predictions and
+ * probabilities as the original forest, on numeric and categorical data.
+ */
+TEST_CASE("FlatRandomForestTest", "[RandomForestTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+
+  RandomForest<> rf(trainingData, di, trainingLabels, 5, 10, 1, 1e-7, 0,
+      MultipleRandomDimensionSelect(4));
+  FlatRandomForest flatForest(rf);
+  REQUIRE(flatForest.NumTrees() == 10);
+  REQUIRE(flatForest.NumClasses() == 5);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  rf.Classify(testData, predictions, probabilities);
+  flatForest.Classify(testData, flatPredictions, flatProbabilities);
+
+  REQUIRE(arma::all(predictions == flatPredictions));
+  CheckMatrices(probabilities, flatProbabilities);
+
+  flatForest.Classify(testData, flatPredictions);
+  REQUIRE(arma::all(predictions == flatPredictions));
+
+  for (size_t i = 0; i < 100; ++i)
+    REQUIRE(flatForest.Classify(testData.col(i)) == predictions[i]);
+
+  // Now a numeric forest, on a batch that is not a multiple of the block size.
+  arma::mat data(4, 1000, arma::fill::randu);
+  arma::Row<size_t> labels = arma::conv_to<arma::Row<size_t>>::from(
+      data.row(0) + data.row(3) > 1.0);
+  RandomForest<> numericForest(data, labels, 2, 15);
+  FlatRandomForest flatNumericForest(numericForest);
+
+  arma::mat numericTestData(4, 301, arma::fill::randu);
+  numericForest.Classify(numericTestData, predictions, probabilities);
+  flatNumericForest.Classify(numericTestData, flatPredictions,
+      flatProbabilities);
+
+  REQUIRE(arma::all(predictions == flatPredictions));
+  CheckMatrices(probabilities, flatProbabilities);
+}
+
+/**
+ * Make sure that a flattened random forest can be serialized on its own.
+ */
+TEST_CASE("FlatRandomForestSerializationTest", "[RandomForestTest]")
+{
+  arma::mat data(4, 500, arma::fill::randu);
+  arma::Row<size_t> labels = arma::conv_to<arma::Row<size_t>>::from(
+      data.row(1) > 0.5);
+  RandomForest<> rf(data, labels, 2, 10);
+  FlatRandomForest flatForest(rf);
+
+  FlatRandomForest xmlForest, jsonForest, binaryForest;
+  REQUIRE_THROWS_AS(xmlForest.Classify(data.col(0)), std::invalid_argument);
+
+  SerializeObjectAll(flatForest, xmlForest, jsonForest, binaryForest);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities, xmlProbabilities, jsonProbabilities,
+      binaryProbabilities;
+  flatForest.Classify(data, predictions, probabilities);
+  xmlForest.Classify(data, predictions, xmlProbabilities);
+  jsonForest.Classify(data, predictions, jsonProbabilities);
+  binaryForest.Classify(data, predictions, binaryProbabilities);
+
+  CheckMatrices(probabilities, xmlProbabilities, jsonProbabilities,
+      binaryProbabilities);
+}
+
+/**
+ * Make sure that the out-of-bag error is only computed when requested, and that
+ * it is a good estimate of the error on held-out data.
+ */
+TEST_CASE("OOBErrorTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2_labels.txt");
+  arma::mat testDataset;
+  if (!data::Load("vc2_test.csv", testDataset))
+    FAIL("Cannot load dataset vc2_test.csv");
+  arma::Row<size_t> testLabels;
+  if (!data::Load("vc2_test_labels.txt", testLabels))
+    FAIL("Cannot load dataset vc2_test_labels.txt");
+
+  RandomForest<> rf;
+  rf.Train(dataset, labels, 3, 10);
+  REQUIRE(std::isnan(rf.OOBError()));
+
+  rf.ComputeOOBError() = true;
+  rf.Train(dataset, labels, 3, 50);
+  REQUIRE(rf.OOBError() >= 0.0);
+  REQUIRE(rf.OOBError() <= 1.0);
+
+  arma::Row<size_t> predictions;
+  rf.Classify(testDataset, predictions);
+  const double testError = 1.0 - (double) arma::accu(predictions == testLabels)
+      / testDataset.n_cols;
+  REQUIRE(rf.OOBError() == Approx(testError).margin(0.1));
+
+  // With unit weights, the weighted error is the same.
+  arma::rowvec weights(dataset.n_cols, arma::fill::ones);
+  rf.Train(dataset, labels, 3, weights, 50);
+  REQUIRE(rf.OOBError() == Approx(testError).margin(0.1));
+
+  // Extra trees do not use bootstrap samples, so there are no out-of-bag
+  // points.
+  ExtraTrees<> et;
+  et.ComputeOOBError() = true;
+  et.Train(dataset, labels, 3, 10);
+  REQUIRE(std::isnan(et.OOBError()));
+}
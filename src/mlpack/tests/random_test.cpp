@@ -91,3 +91,118 @@ TEST_CASE("WeightedRandomTest", "[RandomTest]")
     }
   }
 }
+
+// Make sure that RandomStream gives the known answers of Philox4x32-10.
+TEST_CASE("RandomStreamKnownAnswerTest", "[RandomTest]")
+{
+  uint32_t words[4];
+  RandomStream::Block(0, 0, 0, words);
+  REQUIRE(words[0] == 0x6627e8d5);
+  REQUIRE(words[1] == 0xe169c58d);
+  REQUIRE(words[2] == 0xbc57ac4c);
+  REQUIRE(words[3] == 0x9b00dbd8);
+
+  // The stream generates its blocks in order.
+  RandomStream stream(0, 0);
+  for (size_t i = 0; i < 4; ++i)
+    REQUIRE(stream() == words[i]);
+}
+
+// Make sure that streams are reproducible, and that different streams are
+// different.
+TEST_CASE("RandomStreamReproducibleTest", "[RandomTest]")
+{
+  RandomStream a(12345, 7), b(12345, 7), c(12345, 8), d(12346, 7);
+  size_t sameC = 0, sameD = 0;
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const uint32_t x = a();
+    REQUIRE(b() == x);
+    sameC += (c() == x);
+    sameD += (d() == x);
+  }
+  REQUIRE(sameC < 5);
+  REQUIRE(sameD < 5);
+
+  // Check the moments of the generated numbers.
+  RandomStream e(42, 3);
+  arma::vec uniform(20000), normal(20000);
+  for (size_t i = 0; i < uniform.n_elem; ++i)
+  {
+    uniform[i] = e.Random();
+    normal[i] = e.RandNormal();
+    REQUIRE(uniform[i] >= 0.0);
+    REQUIRE(uniform[i] < 1.0);
+  }
+  REQUIRE(arma::mean(uniform) == Approx(0.5).margin(0.02));
+  REQUIRE(arma::mean(normal) == Approx(0.0).margin(0.05));
+  REQUIRE(arma::stddev(normal) == Approx(1.0).margin(0.05));
+}
+
+// Make sure that the bulk fills do not depend on the number of threads.
+TEST_CASE("RandomFillThreadsTest", "[RandomTest]")
+{
+  arma::mat uniform(31, 57), normal(31, 57);
+  RandUniformFill(uniform, 2024, 5);
+  RandNormalFill(normal, 2024, 5);
+
+  REQUIRE(uniform.min() >= 0.0);
+  REQUIRE(uniform.max() < 1.0);
+  REQUIRE(arma::mean(arma::vectorise(uniform)) == Approx(0.5).margin(0.05));
+  REQUIRE(arma::mean(arma::vectorise(normal)) == Approx(0.0).margin(0.1));
+  REQUIRE(arma::stddev(arma::vectorise(normal)) == Approx(1.0).margin(0.1));
+
+  // Element i of the uniform fill comes from block i / 2 of the stream.
+  RandomStream stream(2024, 5);
+  for (size_t i = 0; i < 10; ++i)
+    REQUIRE(uniform[i] == stream.Random());
+
+  // Float matrices are filled with the same numbers.
+  arma::fmat uniformFloat(31, 57);
+  RandUniformFill(uniformFloat, 2024, 5);
+  REQUIRE(arma::approx_equal(arma::conv_to<arma::mat>::from(uniformFloat),
+      uniform, "absdiff", 1e-6));
+
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  for (int threads = 1; threads <= 4; threads *= 2)
+  {
+    omp_set_num_threads(threads);
+    arma::mat uniform2(31, 57), normal2(31, 57);
+    RandUniformFill(uniform2, 2024, 5);
+    RandNormalFill(normal2, 2024, 5);
+    REQUIRE(arma::all(arma::vectorise(uniform2 == uniform)));
+    REQUIRE(arma::all(arma::vectorise(normal2 == normal)));
+  }
+  omp_set_num_threads(oldThreads);
+#endif
+}
+
+// Make sure that bulk Bernoulli samples follow the uniform fill.
+TEST_CASE("RandBernoulliFillTest", "[RandomTest]")
+{
+  arma::mat probabilities(17, 41, arma::fill::randu);
+  probabilities.col(0).zeros();
+  probabilities.col(1).ones();
+
+  arma::mat samples, uniform(17, 41);
+  RandBernoulliFill(samples, probabilities, 77, 2);
+  RandUniformFill(uniform, 77, 2);
+
+  REQUIRE(samples.n_rows == 17);
+  REQUIRE(samples.n_cols == 41);
+  for (size_t i = 0; i < samples.n_elem; ++i)
+    REQUIRE(samples[i] == (uniform[i] < probabilities[i] ? 1.0 : 0.0));
+
+  // The samples can be written over the probabilities.
+  arma::mat inPlace = probabilities;
+  RandBernoulliFill(inPlace, inPlace, 77, 2);
+  REQUIRE(arma::all(arma::vectorise(inPlace == samples)));
+
+  // The mean of many samples approaches the probability.
+  arma::vec p(20000);
+  p.fill(0.3);
+  arma::vec b;
+  RandBernoulliFill(b, p, 5);
+  REQUIRE(arma::mean(b) == Approx(0.3).margin(0.02));
+}
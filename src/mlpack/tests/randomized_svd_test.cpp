@@ -59,3 +59,82 @@ TEST_CASE("RandomizedSVDReconstructionError", "[RandomizedSVDTest]")
       arma::norm(centeredData, "frob");
   REQUIRE(error == Approx(0.0).margin(1e-5));
 }
+
+/**
+ * The randomized SVD should also work in single precision.
+ */
+TEST_CASE("RandomizedSVDFloatReconstructionError", "[RandomizedSVDTest]")
+{
+  arma::fmat U = arma::randn<arma::fmat>(3, 20);
+  arma::fmat V = arma::randn<arma::fmat>(10, 3);
+
+  arma::fmat R;
+  arma::qr_econ(U, R, U);
+  arma::qr_econ(V, R, V);
+
+  arma::fmat data = trans(U * arma::diagmat(arma::fvec("1 0.1 0.01")) * V.t());
+
+  // Center the data into a temporary matrix.
+  arma::fmat centeredData = data.each_col() - arma::mean(data, 1);
+
+  arma::fmat U1, U2, V1, V2;
+  arma::fvec s1, s2;
+
+  arma::svd_econ(U1, s1, V1, centeredData);
+
+  RandomizedSVD rSVD(0, 10);
+  rSVD.Apply(data, U2, s2, V2, 3);
+
+  // The sigular value error should be small.
+  float error = arma::norm(s2 - s1.subvec(0, s2.n_elem - 1), "frob") /
+      arma::norm(s2, "frob");
+  REQUIRE(error == Approx(0.0).margin(1e-3));
+
+  arma::fmat reconstruct = U2 * arma::diagmat(s2) * V2.t();
+
+  // The relative reconstruction error should be small.
+  error = arma::norm(centeredData - reconstruct, "frob") /
+      arma::norm(centeredData, "frob");
+  REQUIRE(error == Approx(0.0).margin(1e-3));
+}
+
+/**
+ * The randomized SVD computed from chunks of the data should give the same
+ * singular values and left singular vectors as the exact SVD of the centered
+ * data.
+ */
+TEST_CASE("RandomizedSVDChunksTest", "[RandomizedSVDTest]")
+{
+  // Low-rank data with a nonzero mean.
+  arma::mat data = arma::randn<arma::mat>(50, 3) *
+      arma::diagmat(arma::vec("10 5 1")) * arma::randn<arma::mat>(3, 1000);
+  data.each_col() += arma::linspace<arma::vec>(-5.0, 5.0, 50);
+
+  arma::mat centeredData = data.each_col() - arma::mean(data, 1);
+
+  arma::mat U1, V1, U2;
+  arma::vec s1, s2;
+  arma::svd_econ(U1, s1, V1, centeredData);
+
+  RandomizedSVD rSVD(0, 4);
+  data::MatrixChunkLoader<arma::mat> loader(data, 64);
+  rSVD.ApplyChunks(loader, U2, s2, 3);
+
+  REQUIRE(U2.n_rows == 50);
+  REQUIRE(U2.n_cols == 3);
+  REQUIRE(s2.n_elem == 3);
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    REQUIRE(s2[i] == Approx(s1[i]).epsilon(1e-5));
+    // The singular vectors may point in the opposite direction.
+    REQUIRE(std::abs(arma::dot(U1.col(i), U2.col(i))) ==
+        Approx(1.0).epsilon(1e-5));
+  }
+
+  // An empty data source cannot be decomposed.
+  arma::mat empty(50, 0);
+  data::MatrixChunkLoader<arma::mat> emptyLoader(empty, 64);
+  REQUIRE_THROWS_AS(rSVD.ApplyChunks(emptyLoader, U2, s2, 3),
+      std::invalid_argument);
+}
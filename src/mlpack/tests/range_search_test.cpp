@@ -1349,6 +1349,66 @@ TEST_CASE("RSModelTest", "[RangeSearchTest]")
   }
 }
 
+/**
+ * Make sure that single-precision RSModels find the same points as a
+ * double-precision search, for every tree type and search mode.
+ */
+TEST_CASE("RSModelSinglePrecisionTest", "[RangeSearchTest]")
+{
+  arma::mat queryData = arma::randu<arma::mat>(10, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(10, 200);
+
+  // Get a baseline.
+  RangeSearch<> rs(referenceData);
+  vector<vector<size_t>> baselineNeighbors;
+  vector<vector<double>> baselineDistances;
+  rs.Search(queryData, Range(0.25, 0.75), baselineNeighbors,
+      baselineDistances);
+
+  vector<vector<pair<double, size_t>>> baselineSorted;
+  SortResults(baselineNeighbors, baselineDistances, baselineSorted);
+
+  util::Timers timers;
+  for (int t = RSModel::KD_TREE; t <= RSModel::OCTREE; ++t)
+  {
+    for (size_t j = 0; j < 3; ++j)
+    {
+      RSModel model((RSModel::TreeTypes) t, false, true);
+
+      arma::mat referenceCopy(referenceData);
+      model.BuildModel(timers, std::move(referenceCopy), 5, (j == 2),
+          (j == 1));
+
+      REQUIRE(model.SinglePrecision() == true);
+      REQUIRE(model.Dimensionality() == 10);
+      REQUIRE(model.NumPoints() == 200);
+
+      vector<vector<size_t>> neighbors;
+      vector<vector<double>> distances;
+      arma::mat queryCopy(queryData);
+      model.Search(timers, std::move(queryCopy), Range(0.25, 0.75),
+          neighbors, distances);
+
+      REQUIRE(neighbors.size() == baselineNeighbors.size());
+      REQUIRE(distances.size() == baselineDistances.size());
+
+      vector<vector<pair<double, size_t>>> sorted;
+      SortResults(neighbors, distances, sorted);
+
+      for (size_t k = 0; k < sorted.size(); ++k)
+      {
+        REQUIRE(sorted[k].size() == baselineSorted[k].size());
+        for (size_t l = 0; l < sorted[k].size(); ++l)
+        {
+          REQUIRE(sorted[k][l].second == baselineSorted[k][l].second);
+          REQUIRE(sorted[k][l].first ==
+              Approx(baselineSorted[k][l].first).epsilon(1e-5));
+        }
+      }
+    }
+  }
+}
+
 TEST_CASE("RSModelMonochromaticTest", "[RangeSearchTest]")
 {
   // Ensure that we can build an RSModel and get correct results.
@@ -1712,3 +1772,163 @@ TEST_CASE("MoveOperatorNaiveTest", "[RangeSearchTest]")
     }
   }
 }
+
+/**
+ * Make sure that the callback and CSR overloads of Search() give the same
+ * results as the vector-of-vectors overload, for each search mode, in both
+ * the bichromatic and monochromatic cases.
+ */
+TEST_CASE("RangeSearchCallbackAndCSRTest", "[RangeSearchTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+  const Range range(0.1, 0.3);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(referenceData, mode == 0, mode == 1);
+
+    for (size_t mono = 0; mono < 2; ++mono)
+    {
+      const size_t numQueries = mono ? referenceData.n_cols : queryData.n_cols;
+
+      vector<vector<size_t>> neighbors;
+      vector<vector<double>> distances;
+      if (mono)
+        rs.Search(range, neighbors, distances);
+      else
+        rs.Search(queryData, range, neighbors, distances);
+
+      vector<vector<pair<double, size_t>>> sorted;
+      SortResults(neighbors, distances, sorted);
+
+      // Collect the results of the callback.
+      vector<vector<size_t>> callbackNeighbors(numQueries);
+      vector<vector<double>> callbackDistances(numQueries);
+      auto callback = [&](const size_t q, const size_t r, const double d)
+      {
+        callbackNeighbors[q].push_back(r);
+        callbackDistances[q].push_back(d);
+      };
+      if (mono)
+        rs.Search(range, callback);
+      else
+        rs.Search(queryData, range, callback);
+
+      vector<vector<pair<double, size_t>>> callbackSorted;
+      SortResults(callbackNeighbors, callbackDistances, callbackSorted);
+
+      // Convert the CSR results.
+      arma::Col<size_t> offsets, csrNeighbors;
+      arma::vec csrDistances;
+      if (mono)
+        rs.Search(range, offsets, csrNeighbors, csrDistances);
+      else
+        rs.Search(queryData, range, offsets, csrNeighbors, csrDistances);
+
+      REQUIRE(offsets.n_elem == numQueries + 1);
+      REQUIRE(offsets[0] == 0);
+      REQUIRE(offsets[numQueries] == csrNeighbors.n_elem);
+      REQUIRE(csrDistances.n_elem == csrNeighbors.n_elem);
+
+      vector<vector<size_t>> csrNeighborsVec(numQueries);
+      vector<vector<double>> csrDistancesVec(numQueries);
+      for (size_t i = 0; i < numQueries; ++i)
+      {
+        for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+        {
+          csrNeighborsVec[i].push_back(csrNeighbors[j]);
+          csrDistancesVec[i].push_back(csrDistances[j]);
+        }
+      }
+
+      vector<vector<pair<double, size_t>>> csrSorted;
+      SortResults(csrNeighborsVec, csrDistancesVec, csrSorted);
+
+      REQUIRE(sorted.size() == numQueries);
+      for (size_t i = 0; i < numQueries; ++i)
+      {
+        REQUIRE(callbackSorted[i].size() == sorted[i].size());
+        REQUIRE(csrSorted[i].size() == sorted[i].size());
+        for (size_t j = 0; j < sorted[i].size(); ++j)
+        {
+          REQUIRE(callbackSorted[i][j].second == sorted[i][j].second);
+          REQUIRE(callbackSorted[i][j].first ==
+              Approx(sorted[i][j].first).epsilon(1e-7));
+          REQUIRE(csrSorted[i][j].second == sorted[i][j].second);
+          REQUIRE(csrSorted[i][j].first ==
+              Approx(sorted[i][j].first).epsilon(1e-7));
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Check the counts of RangeSearch::Count() against the number of results of
+ * Search() with the given tree type, in every mode, with and without a
+ * threshold.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckRangeCounts(const arma::mat& referenceData,
+                      const arma::mat& queryData,
+                      const Range& range)
+{
+  const size_t threshold = 5;
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<EuclideanDistance, arma::mat, TreeType> rs(referenceData,
+        mode == 0, mode == 1);
+
+    for (size_t mono = 0; mono < 2; ++mono)
+    {
+      vector<vector<size_t>> neighbors;
+      vector<vector<double>> distances;
+      arma::Col<size_t> counts, thresholdCounts;
+      if (mono)
+      {
+        rs.Search(range, neighbors, distances);
+        rs.Count(range, counts);
+        rs.Count(range, thresholdCounts, threshold);
+      }
+      else
+      {
+        rs.Search(queryData, range, neighbors, distances);
+        rs.Count(queryData, range, counts);
+        rs.Count(queryData, range, thresholdCounts, threshold);
+      }
+
+      REQUIRE(counts.n_elem == neighbors.size());
+      REQUIRE(thresholdCounts.n_elem == neighbors.size());
+      for (size_t i = 0; i < neighbors.size(); ++i)
+      {
+        REQUIRE(counts[i] == neighbors[i].size());
+        if (neighbors[i].size() < threshold)
+          REQUIRE(thresholdCounts[i] == neighbors[i].size());
+        else
+          REQUIRE(thresholdCounts[i] >= threshold);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that counting the points in range gives the number of results of
+ * a range search, including when whole nodes are in range.
+ */
+TEST_CASE("RangeSearchCountTest", "[RangeSearchTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  // The first range holds whole nodes of the trees; the second range does not
+  // hold the points themselves, in monochromatic search.
+  for (const Range& range : { Range(0.0, 0.4), Range(0.1, 0.3) })
+  {
+    CheckRangeCounts<KDTree>(referenceData, queryData, range);
+    CheckRangeCounts<BallTree>(referenceData, queryData, range);
+    CheckRangeCounts<StandardCoverTree>(referenceData, queryData, range);
+  }
+}
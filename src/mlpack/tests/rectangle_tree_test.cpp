@@ -1353,3 +1353,94 @@ TEST_CASE("RectangleTreeMoveDatasetTest", "[RectangleTreeTraitsTest]")
   REQUIRE(tree.Dataset().n_rows == 3);
   REQUIRE(tree.Dataset().n_cols == 1000);
 }
+
+/**
+ * Bulk load a tree of the given type with the given packing, check that it is
+ * valid and gives the same nearest neighbors as a naive search, and that it is
+ * still valid after points are deleted from and inserted into it.
+ */
+template<template<typename, typename, typename> class TreeType>
+void CheckBulkLoadedTree(const RectangleTreeBulkLoad packing)
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> Tree;
+  Tree tree(dataset, packing, 20, 6, 5, 2);
+
+  REQUIRE(tree.NumDescendants() == 1000);
+  CheckFills(tree);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  REQUIRE(GetMinLevel(tree) == GetMaxLevel(tree));
+  REQUIRE((int) tree.TreeDepth() == GetMinLevel(tree));
+
+  // Delete some points, and insert them again.
+  for (size_t i = 0; i < 50; ++i)
+    tree.DeletePoint(999 - i);
+
+  REQUIRE(tree.NumDescendants() == 950);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckNumDescendants(tree);
+
+  for (size_t i = 0; i < 50; ++i)
+    tree.InsertPoint(950 + i);
+
+  REQUIRE(tree.NumDescendants() == 1000);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  REQUIRE(GetMinLevel(tree) == GetMaxLevel(tree));
+
+  NeighborSearch<NearestNeighborSort, LMetric<2, true>, arma::mat, TreeType>
+      knn1(std::move(tree), DUAL_TREE_MODE);
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  knn1.Search(5, neighbors1, distances1);
+
+  KNN knn2(dataset, NAIVE_MODE);
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+  knn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); ++i)
+  {
+    REQUIRE(neighbors1[i] == neighbors2[i]);
+    REQUIRE(distances1[i] == Approx(distances2[i]).epsilon(1e-7));
+  }
+}
+
+// Test that bulk loading with Sort-Tile-Recursive packing builds valid trees.
+TEST_CASE("RectangleTreeSTRBulkLoadTest", "[RectangleTreeTraitsTest]")
+{
+  CheckBulkLoadedTree<RTree>(RectangleTreeBulkLoad::STR);
+  CheckBulkLoadedTree<RStarTree>(RectangleTreeBulkLoad::STR);
+  CheckBulkLoadedTree<XTree>(RectangleTreeBulkLoad::STR);
+}
+
+// Test that bulk loading with Hilbert packing builds valid trees.
+TEST_CASE("RectangleTreeHilbertBulkLoadTest", "[RectangleTreeTraitsTest]")
+{
+  CheckBulkLoadedTree<RTree>(RectangleTreeBulkLoad::HILBERT);
+  CheckBulkLoadedTree<RStarTree>(RectangleTreeBulkLoad::HILBERT);
+  CheckBulkLoadedTree<XTree>(RectangleTreeBulkLoad::HILBERT);
+}
+
+// Test that bulk loading a dataset that fits in one leaf gives a single leaf.
+TEST_CASE("RectangleTreeSmallBulkLoadTest", "[RectangleTreeTraitsTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 15);
+  typedef RTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  TreeType tree(dataset, RectangleTreeBulkLoad::STR, 20, 6, 5, 2);
+
+  REQUIRE(tree.IsLeaf());
+  REQUIRE(tree.Count() == 15);
+  REQUIRE(tree.NumDescendants() == 15);
+  CheckExactContainment(tree);
+}
@@ -246,6 +246,51 @@ TEST_CASE("RegularizedSVDFunctionOptimize", "[RegularizedSVDTest]")
   REQUIRE(relativeError == Approx(0.0).margin(1e-2));
 }
 
+// Make sure that each rating is in exactly one block of RatingStrata, and that
+// the blocks of a stratum never share a user or an item.
+TEST_CASE("RatingStrataTest", "[RegularizedSVDTest]")
+{
+  const size_t numUsers = 37;
+  const size_t numItems = 23;
+  const size_t numRatings = 500;
+  const size_t numBlocks = 4;
+
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+
+  RatingStrata strata(data, numUsers, numItems, numBlocks);
+  strata.Shuffle();
+  REQUIRE(strata.NumBlocks() == numBlocks);
+
+  arma::uvec visits(numRatings, arma::fill::zeros);
+  for (size_t s = 0; s < numBlocks; ++s)
+  {
+    // The block that each user and item of the stratum is in.
+    arma::uvec userBlocks(numUsers), itemBlocks(numItems);
+    userBlocks.fill(numBlocks);
+    itemBlocks.fill(numBlocks);
+    for (size_t g = 0; g < numBlocks; ++g)
+    {
+      size_t begin, end;
+      strata.Block(strata.Stratum(s), g, begin, end);
+      for (size_t j = begin; j < end; ++j)
+      {
+        const size_t rating = strata.Indices()[j];
+        const size_t user = data(0, rating);
+        const size_t item = data(1, rating);
+        REQUIRE((userBlocks[user] == numBlocks || userBlocks[user] == g));
+        REQUIRE((itemBlocks[item] == numBlocks || itemBlocks[item] == g));
+        userBlocks[user] = g;
+        itemBlocks[item] = g;
+        ++visits[rating];
+      }
+    }
+  }
+
+  REQUIRE(arma::all(visits == 1));
+}
+
 // The test is only compiled if the user has specified OpenMP to be
 // used.
 #ifdef MLPACK_USE_OPENMP
@@ -311,4 +356,65 @@ TEST_CASE("RegularizedSVDFunctionOptimizeHOGWILD", "[RegularizedSVDTest]")
   REQUIRE(relativeError == Approx(0.0).margin(1e-2));
 }
 
+// Test Regularized SVD with the stratified parallel SGD specialization.
+TEST_CASE("RegularizedSVDFunctionOptimizeStratified", "[RegularizedSVDTest]")
+{
+  // Define useful constants.
+  const size_t numUsers = 50;
+  const size_t numItems = 50;
+  const size_t numRatings = 100;
+  const size_t rank = 10;
+  const double alpha = 0.01;
+  const double lambda = 0.01;
+
+  // Initiate random parameters.
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+
+  // Make a random rating dataset.
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+
+  // Manually set last row to maximum user and maximum item.
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+
+  // Make rating entries based on the parameters.
+  for (size_t i = 0; i < numRatings; ++i)
+  {
+    data(2, i) = dot(parameters.col(data(0, i)),
+                           parameters.col(numUsers + data(1, i)));
+  }
+
+  // Make the Reg SVD function and the optimizer.
+  RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, lambda);
+
+  ExponentialBackoff decayPolicy(1000, alpha, 0.5);
+
+  // Iterate till convergence.
+  // The threadShareSize is chosen such that each function gets optimized.
+  ParallelSGD<ExponentialBackoff> optimizer(0,
+      std::ceil((float) rSVDFunc.NumFunctions() / omp_get_max_threads()), 1e-5,
+      true, decayPolicy);
+
+  // Obtain optimized parameters after training.
+  arma::mat optParameters = arma::randu(rank, numUsers + numItems);
+  optimizer.Optimize(rSVDFunc, optParameters);
+
+  // Get predicted ratings from optimized parameters.
+  arma::mat predictedData(1, numRatings);
+  for (size_t i = 0; i < numRatings; ++i)
+  {
+    predictedData(0, i) = dot(optParameters.col(data(0, i)),
+                                    optParameters.col(numUsers + data(1, i)));
+  }
+
+  // Calculate relative error.
+  const double relativeError = arma::norm(data.row(2) - predictedData, "frob") /
+                               arma::norm(data, "frob");
+
+  // Relative error should be small.
+  REQUIRE(relativeError == Approx(0.0).margin(1e-2));
+}
+
 #endif
@@ -166,3 +166,137 @@ TEST_CASE("ZCAWhiteningTest", "[ScalingTest]")
   scale.InverseTransform(output, temp);
   CheckMatrices(dataset, temp);
 }
+
+/**
+ * Check that low-rank PCA and ZCA whitening, fitted with the randomized SVD,
+ * whiten the directions of largest variance of the data and agree with the
+ * full eigendecomposition.
+ */
+TEMPLATE_TEST_CASE("LowRankWhiteningTest", "[ScalingTest]", arma::mat,
+    arma::fmat)
+{
+  typedef TestType MatType;
+
+  // The data has five directions of large variance.
+  arma::mat basis(50, 5, arma::fill::randn);
+  arma::mat fullData = basis * arma::randn<arma::mat>(5, 2000) +
+      0.01 * arma::randn<arma::mat>(50, 2000);
+  fullData.each_col() += arma::randu<arma::vec>(50);
+  const MatType data = arma::conv_to<MatType>::from(fullData);
+
+  data::PCAWhitening full;
+  full.Fit(fullData);
+
+  data::PCAWhitening pca(0.00005, 5);
+  pca.Fit(data);
+  REQUIRE(pca.EigenVectors().n_rows == 50);
+  REQUIRE(pca.EigenVectors().n_cols == 5);
+  for (size_t i = 0; i < 5; ++i)
+  {
+    REQUIRE(pca.EigenValues()[i] ==
+        Approx(full.EigenValues()[45 + i]).epsilon(1e-3));
+  }
+
+  MatType output;
+  pca.Transform(data, output);
+  REQUIRE(output.n_rows == 5);
+  REQUIRE(output.n_cols == 2000);
+  const arma::mat covariance = ColumnCovariance(
+      arma::conv_to<arma::mat>::from(output));
+  REQUIRE(arma::approx_equal(covariance, arma::eye<arma::mat>(5, 5),
+      "absdiff", 1e-3));
+
+  data::ZCAWhitening zca(0.00005, 5);
+  zca.Fit(data);
+  zca.Transform(data, output);
+  REQUIRE(output.n_rows == 50);
+  MatType reconstructed;
+  zca.InverseTransform(output, reconstructed);
+  REQUIRE(arma::norm(arma::conv_to<arma::mat>::from(reconstructed) - fullData,
+      "fro") / arma::norm(fullData, "fro") == Approx(0.0).margin(1e-2));
+}
+
+/**
+ * Check that fitting a scaler one chunk at a time, or merging scalers fitted
+ * on chunks, gives the same scaler as fitting the whole dataset, and that
+ * scaling in place gives the same result as scaling into another matrix.
+ */
+template<typename ScalerType>
+void CheckChunkedScaler()
+{
+  arma::mat data(5, 103, arma::fill::randn);
+  data.row(2).fill(3.0); // A feature with no variance.
+
+  ScalerType scaler;
+  scaler.Fit(data);
+  arma::mat expected;
+  scaler.Transform(data, expected);
+
+  ScalerType partialScaler, merged, first, second;
+  partialScaler.PartialFit(data.cols(0, 39));
+  partialScaler.PartialFit(data.cols(40, 102));
+  first.Fit(data.cols(0, 61));
+  second.Fit(data.cols(62, 102));
+  merged.Merge(first);
+  merged.Merge(second);
+
+  arma::mat partialOutput, mergedOutput;
+  partialScaler.Transform(data, partialOutput);
+  merged.Transform(data, mergedOutput);
+  CheckMatrices(partialOutput, expected);
+  CheckMatrices(mergedOutput, expected);
+
+  arma::mat inPlace(data);
+  scaler.Transform(inPlace);
+  CheckMatrices(inPlace, expected);
+  scaler.InverseTransform(inPlace);
+  CheckMatrices(inPlace, data);
+
+  // Chunks with a different number of dimensions cannot be fitted.
+  REQUIRE_THROWS_AS(partialScaler.PartialFit(arma::mat(4, 10,
+      arma::fill::randu)), std::invalid_argument);
+}
+
+/**
+ * Test chunked fitting and in-place scaling of the scalers.
+ */
+TEST_CASE("ChunkedScalerTest", "[ScalingTest]")
+{
+  CheckChunkedScaler<data::MinMaxScaler>();
+  CheckChunkedScaler<data::MaxAbsScaler>();
+  CheckChunkedScaler<data::StandardScaler>();
+  CheckChunkedScaler<data::MeanNormalization>();
+}
+
+/**
+ * Test that the single-pass Fit() of StandardScaler gives the same mean and
+ * standard deviation as Armadillo.
+ */
+TEST_CASE("StandardScalerSinglePassFitTest", "[ScalingTest]")
+{
+  arma::mat data = 1000.0 + arma::randn<arma::mat>(4, 1000);
+  data::StandardScaler scaler;
+  scaler.Fit(data);
+
+  CheckMatrices(scaler.ItemMean(), arma::vec(arma::mean(data, 1)));
+  CheckMatrices(scaler.ItemStdDev(), arma::vec(arma::stddev(data, 1, 1)));
+  REQUIRE(scaler.Count() == 1000);
+}
+
+/**
+ * Test that the statistics of StandardScaler do not depend on the number of
+ * threads that compute them.
+ */
+TEST_CASE("StandardScalerThreadIndependenceTest", "[ScalingTest]")
+{
+  arma::mat data = 1000.0 + arma::randn<arma::mat>(4, 10000);
+  data::StandardScaler scaler, serialScaler;
+  scaler.Fit(data);
+  {
+    ThreadLimit limit(1);
+    serialScaler.Fit(data);
+  }
+
+  REQUIRE(arma::all(scaler.ItemMean() == serialScaler.ItemMean()));
+  REQUIRE(arma::all(scaler.ItemStdDev() == serialScaler.ItemStdDev()));
+}
@@ -25,6 +25,8 @@
 #include <mlpack/methods/lsh.hpp>
 #include <mlpack/methods/lars.hpp>
 #include <mlpack/methods/bayesian_linear_regression.hpp>
+#include <mlpack/methods/ann/init_rules/gaussian_init.hpp>
+#include <mlpack/methods/ann/rbm/rbm.hpp>
 
 using namespace mlpack;
 
@@ -152,12 +154,12 @@ TEST_CASE("BallBoundTest", "[SerializationTest]")
 
 TEST_CASE("MahalanobisBallBoundTest", "[SerializationTest]")
 {
-  BallBound<MahalanobisDistance<>, arma::vec> b(100);
+  BallBound<MahalanobisDistance<>> b(100);
   b.Center().randu();
   b.Radius() = 14.0;
   b.Metric().Covariance().randu(100, 100);
 
-  BallBound<MahalanobisDistance<>, arma::vec> xmlB, jsonB, binaryB;
+  BallBound<MahalanobisDistance<>> xmlB, jsonB, binaryB;
 
   SerializeObjectAll(b, xmlB, jsonB, binaryB);
 
@@ -1041,16 +1043,48 @@ TEST_CASE("LSHTest", "[SerializationTest]")
   REQUIRE(lsh.BucketSize() == jsonLsh.BucketSize());
   REQUIRE(lsh.BucketSize() == binaryLsh.BucketSize());
 
-  REQUIRE(lsh.SecondHashTable().size() ==
-      xmlLsh.SecondHashTable().size());
-  REQUIRE(lsh.SecondHashTable().size() ==
-      jsonLsh.SecondHashTable().size());
-  REQUIRE(lsh.SecondHashTable().size() ==
-      binaryLsh.SecondHashTable().size());
+  CheckMatrices(lsh.BucketOffsets(), xmlLsh.BucketOffsets(),
+      jsonLsh.BucketOffsets(), binaryLsh.BucketOffsets());
+  REQUIRE(lsh.BucketContents().n_elem == xmlLsh.BucketContents().n_elem);
+  REQUIRE(lsh.BucketContents().n_elem == jsonLsh.BucketContents().n_elem);
+  REQUIRE(lsh.BucketContents().n_elem == binaryLsh.BucketContents().n_elem);
+  REQUIRE(arma::all(lsh.BucketContents() == xmlLsh.BucketContents()));
+  REQUIRE(arma::all(lsh.BucketContents() == jsonLsh.BucketContents()));
+  REQUIRE(arma::all(lsh.BucketContents() == binaryLsh.BucketContents()));
+}
+
+/**
+ * Test that an LSH model that has had points inserted and removed can be
+ * serialized and deserialized.
+ */
+TEST_CASE("LSHInsertRemoveTest", "[SerializationTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 200);
+  arma::mat newData = arma::randu<arma::mat>(5, 50);
+  arma::mat queryData = arma::randu<arma::mat>(5, 20);
+
+  LSHSearch<> lsh(referenceData, 4, 6);
+  lsh.Insert(newData);
+  lsh.Remove(arma::uvec({ 3, 17, 210 }));
+
+  LSHSearch<> xmlLsh, jsonLsh, binaryLsh;
+  SerializeObjectAll(lsh, xmlLsh, jsonLsh, binaryLsh);
+
+  REQUIRE(xmlLsh.NumRemoved() == 3);
+  REQUIRE(jsonLsh.NumRemoved() == 3);
+  REQUIRE(binaryLsh.NumRemoved() == 3);
+  CheckMatrices(lsh.BucketSizes(), xmlLsh.BucketSizes(),
+      jsonLsh.BucketSizes(), binaryLsh.BucketSizes());
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, jsonDistances, binaryDistances;
+  lsh.Search(queryData, 3, neighbors, distances);
+  xmlLsh.Search(queryData, 3, xmlNeighbors, xmlDistances);
+  jsonLsh.Search(queryData, 3, jsonNeighbors, jsonDistances);
+  binaryLsh.Search(queryData, 3, binaryNeighbors, binaryDistances);
 
-  for (size_t i = 0; i < lsh.SecondHashTable().size(); ++i)
-  CheckMatrices(lsh.SecondHashTable()[i], xmlLsh.SecondHashTable()[i],
-      jsonLsh.SecondHashTable()[i], binaryLsh.SecondHashTable()[i]);
+  CheckMatrices(neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, jsonDistances, binaryDistances);
 }
 
 // Make sure serialization works for LARS.
@@ -1452,7 +1486,7 @@ TEST_CASE("HoeffdingTreeTest", "[SerializationTest]")
 /**
  * Build a Binary RBM, then save it and make sure the parameters of the
  * all the RBM are equal.
- *
+ */
 TEST_CASE("BinaryRBMTest", "[SerializationTest]")
 {
   arma::mat data;
@@ -1485,12 +1519,11 @@ TEST_CASE("BinaryRBMTest", "[SerializationTest]")
   CheckMatrices(Rbm.Weight(), RbmText.Weight());
   CheckMatrices(Rbm.Weight(), RbmBinary.Weight());
 }
-*/
 
 /**
  * Build a ssRBM, then save it and make sure the parameters of the
  * all the RBM are equal.
- *
+ */
 TEST_CASE("ssRBMTest", "[SerializationTest]")
 {
   arma::mat data;
@@ -1540,7 +1573,6 @@ TEST_CASE("ssRBMTest", "[SerializationTest]")
   CheckMatrices(Rbm.Weight(), RbmText.Weight());
   CheckMatrices(Rbm.Weight(), RbmBinary.Weight());
 }
-*/
 
 // Make sure serialization works for BayesianLinearRegression.
 TEST_CASE("BayesianLinearRegressionTest", "[SerializationTest]")
@@ -1608,3 +1640,71 @@ TEST_CASE("CerealEmptyArrayWrapperTest", "[SerializationTest]")
   REQUIRE(jsonT.mem == (int*) NULL);
   REQUIRE(jsonT.len == 0);
 }
+
+/**
+ * Make sure that the sections of a sectioned model file can be loaded one by
+ * one, and lazily.
+ */
+TEST_CASE("SectionedModelTest", "[SerializationTest]")
+{
+  arma::mat dataset(10, 50, arma::fill::randu);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(50,
+      arma::distr_param(0, 3));
+  const size_t numClasses = 4;
+
+  data::SectionedModelWriter writer;
+  writer.Add("num_classes", numClasses);
+  writer.Add("labels", labels);
+  writer.Add("dataset", dataset);
+  REQUIRE_THROWS_AS(writer.Add("labels", labels), std::invalid_argument);
+#ifdef MLPACK_HAS_ZLIB
+  writer.Add("compressed", dataset, true);
+#else
+  REQUIRE_THROWS_AS(writer.Add("compressed", dataset, true),
+      std::runtime_error);
+#endif
+  writer.Save("sectioned_model.bin");
+
+  data::SectionedModelReader reader("sectioned_model.bin");
+  REQUIRE(reader.NumSections() == writer.NumSections());
+  REQUIRE(reader.SectionNames()[0] == "num_classes");
+  REQUIRE(reader.HasSection("dataset"));
+  REQUIRE(!reader.HasSection("model"));
+  REQUIRE(!reader.SectionCompressed("dataset"));
+
+  // Load the sections in another order than they were written.
+  arma::mat loadedDataset;
+  reader.Load("dataset", loadedDataset);
+  CheckMatrices(dataset, loadedDataset);
+  size_t loadedClasses = 0;
+  reader.Load("num_classes", loadedClasses);
+  REQUIRE(loadedClasses == numClasses);
+  arma::Row<size_t> loadedLabels;
+  reader.Load("labels", loadedLabels);
+  CheckMatrices(labels, loadedLabels);
+#ifdef MLPACK_HAS_ZLIB
+  REQUIRE(reader.SectionCompressed("compressed"));
+  arma::mat decompressed;
+  reader.Load("compressed", decompressed);
+  CheckMatrices(dataset, decompressed);
+#endif
+  REQUIRE_THROWS_AS(reader.Load("model", loadedDataset),
+      std::invalid_argument);
+
+  // A lazy section is only loaded when it is used.
+  std::shared_ptr<const data::SectionedModelReader> sharedReader =
+      std::make_shared<data::SectionedModelReader>("sectioned_model.bin");
+  data::LazySection<arma::mat> lazyDataset(sharedReader, "dataset");
+  REQUIRE(!lazyDataset.Loaded());
+  CheckMatrices(lazyDataset.Get(), dataset);
+  REQUIRE(lazyDataset.Loaded());
+  REQUIRE(&lazyDataset.Get() == &lazyDataset.Get());
+
+  remove("sectioned_model.bin");
+
+  // Other files are not sectioned model files.
+  data::Save("not_sectioned.bin", "dataset", dataset);
+  REQUIRE_THROWS_AS(data::SectionedModelReader("not_sectioned.bin"),
+      std::runtime_error);
+  remove("not_sectioned.bin");
+}
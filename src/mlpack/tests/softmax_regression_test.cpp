@@ -13,6 +13,7 @@
 #include <mlpack/methods/softmax_regression.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace mlpack;
 
@@ -907,3 +908,131 @@ TEST_CASE("SoftmaxRegressionResetTest", "[SoftmaxRegressionTest]")
   REQUIRE(
       !arma::approx_equal(sr1.Parameters(), sr2.Parameters(), "absdiff", 1e-5));
 }
+
+/**
+ * Make sure that the top-k classes and their probabilities are the k largest
+ * entries of the full class probabilities.
+ */
+TEST_CASE("SoftmaxRegressionTopKClassifyTest", "[SoftmaxRegressionTest]")
+{
+  const size_t points = 1000;
+  const size_t inputSize = 10;
+  const size_t numClasses = 8;
+  const size_t k = 3;
+
+  arma::mat data(inputSize, points, arma::fill::randu);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+    labels(i) = RandInt(0, numClasses);
+
+  // Use an intercept so that both ways of computing the scores are tested.
+  SoftmaxRegression<> sr(data, labels, numClasses, 0.001, true);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  sr.Classify(data, predictions, probabilities);
+
+  arma::Mat<size_t> topClasses;
+  arma::mat topProbabilities;
+  sr.Classify(data, k, topClasses, topProbabilities);
+
+  REQUIRE(topClasses.n_rows == k);
+  REQUIRE(topClasses.n_cols == points);
+  REQUIRE(topProbabilities.n_rows == k);
+  REQUIRE(topProbabilities.n_cols == points);
+
+  for (size_t i = 0; i < points; ++i)
+  {
+    REQUIRE(topClasses(0, i) == predictions(i));
+
+    const arma::uvec order = arma::sort_index(probabilities.col(i),
+        "descend");
+    for (size_t j = 0; j < k; ++j)
+    {
+      REQUIRE(topProbabilities(j, i) ==
+          Approx(probabilities(topClasses(j, i), i)).epsilon(1e-10));
+      REQUIRE(topProbabilities(j, i) ==
+          Approx(probabilities(order[j], i)).epsilon(1e-10));
+      if (j > 0)
+        REQUIRE(topProbabilities(j, i) <= topProbabilities(j - 1, i));
+    }
+  }
+
+  // The labels of the simple overload are the most probable classes.
+  arma::Row<size_t> simplePredictions;
+  sr.Classify(data, simplePredictions);
+  CheckMatrices(simplePredictions, predictions);
+
+  REQUIRE_THROWS_AS(sr.Classify(data, 0, topClasses, topProbabilities),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(sr.Classify(data, numClasses + 1, topClasses,
+      topProbabilities), std::invalid_argument);
+}
+
+/**
+ * Make sure that the objective function and its gradient are the same for
+ * sparse and dense data, and that a model can be trained on sparse data.
+ */
+TEST_CASE("SoftmaxRegressionSparseTrainTest", "[SoftmaxRegressionTest]")
+{
+  const size_t points = 1500;
+  const size_t inputSize = 30;
+  const size_t numClasses = 4;
+
+  arma::sp_mat sparseData;
+  sparseData.sprandu(inputSize, points, 0.2);
+  arma::mat data(sparseData);
+
+  // The label of each point is given by the feature block with the largest
+  // sum, so the classes are separable.
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    arma::vec sums(numClasses);
+    for (size_t c = 0; c < numClasses; ++c)
+      sums[c] = arma::accu(data.submat(c * 7, i, c * 7 + 6, i));
+    labels[i] = sums.index_max();
+  }
+
+  for (const bool fitIntercept : { false, true })
+  {
+    SoftmaxRegressionFunction<arma::mat> denseFunction(data, labels,
+        numClasses, 0.001, fitIntercept);
+    SoftmaxRegressionFunction<arma::sp_mat> sparseFunction(sparseData, labels,
+        numClasses, 0.001, fitIntercept);
+
+    const arma::mat parameters = denseFunction.GetInitialPoint() * 100.0;
+    REQUIRE(sparseFunction.Evaluate(parameters) ==
+        Approx(denseFunction.Evaluate(parameters)).epsilon(1e-10));
+    REQUIRE(sparseFunction.Evaluate(parameters, 100, 400) ==
+        Approx(denseFunction.Evaluate(parameters, 100, 400)).epsilon(1e-10));
+
+    arma::mat denseGradient, sparseGradient;
+    denseFunction.Gradient(parameters, denseGradient);
+    sparseFunction.Gradient(parameters, sparseGradient);
+    CheckMatrices(sparseGradient, denseGradient, 1e-8);
+
+    const double objective = sparseFunction.EvaluateWithGradient(parameters,
+        sparseGradient);
+    REQUIRE(objective ==
+        Approx(denseFunction.Evaluate(parameters)).epsilon(1e-10));
+    CheckMatrices(sparseGradient, denseGradient, 1e-8);
+
+    denseFunction.Gradient(parameters, 200, denseGradient, 300);
+    sparseFunction.Gradient(parameters, 200, sparseGradient, 300);
+    CheckMatrices(sparseGradient, denseGradient, 1e-8);
+
+    // Train on the sparse data, and check the accuracy and that
+    // classification of sparse and dense points agrees.
+    SoftmaxRegression<arma::sp_mat> sparseModel(sparseData, labels,
+        numClasses, 0.0001, fitIntercept);
+    REQUIRE(sparseModel.ComputeAccuracy(sparseData, labels) > 90.0);
+
+    SoftmaxRegression<> denseModel(inputSize, numClasses, fitIntercept);
+    denseModel.Parameters() = sparseModel.Parameters();
+    arma::Row<size_t> densePredictions, sparsePredictions;
+    denseModel.Classify(data, densePredictions);
+    sparseModel.Classify(sparseData, sparsePredictions);
+    CheckMatrices(sparsePredictions, densePredictions);
+  }
+}
@@ -273,3 +273,103 @@ TEST_CASE("SparseAutoencoderFunctionGradient", "[SparseAutoencoderTest]")
     }
   }
 }
+
+TEST_CASE("SparseAutoencoderFunctionEvaluateWithGradient",
+          "[SparseAutoencoderTest]")
+{
+  const size_t points = 1000;
+  const size_t vSize = 20;
+  const size_t hSize = 10;
+
+  arma::mat data;
+  data.randu(vSize, points);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize, 0.5, 3);
+  REQUIRE(saf.NumFunctions() == points);
+
+  arma::mat parameters;
+  parameters.randu(2 * hSize + 1, vSize + 1);
+
+  // The shared feedforward pass must give the same results as Evaluate() and
+  // Gradient().
+  arma::mat gradient, gradient2;
+  saf.Gradient(parameters, gradient);
+  const double objective = saf.EvaluateWithGradient(parameters, gradient2);
+  REQUIRE(objective == Approx(saf.Evaluate(parameters)).epsilon(1e-10));
+  CheckMatrices(gradient, gradient2, 1e-8);
+
+  // A mini-batch with all the points is the full objective.
+  arma::mat batchGradient;
+  const double batchObjective = saf.EvaluateWithGradient(parameters, 0,
+      batchGradient, points);
+  REQUIRE(batchObjective == Approx(objective).epsilon(1e-10));
+  CheckMatrices(gradient, batchGradient, 1e-8);
+
+  // On a mini-batch, the objective is the one of a function that holds only
+  // the points of the mini-batch.
+  arma::mat subset = data.cols(100, 399);
+  SparseAutoencoderFunction subsetSaf(subset, vSize, hSize, 0.5, 3);
+  arma::mat subsetGradient;
+  const double subsetObjective = subsetSaf.EvaluateWithGradient(parameters,
+      subsetGradient);
+  REQUIRE(saf.Evaluate(parameters, 100, 300) ==
+      Approx(subsetObjective).epsilon(1e-10));
+  saf.Gradient(parameters, 100, batchGradient, 300);
+  CheckMatrices(subsetGradient, batchGradient, 1e-8);
+}
+
+TEST_CASE("SparseAutoencoderFunctionSparseFloat", "[SparseAutoencoderTest]")
+{
+  const size_t points = 500;
+  const size_t vSize = 30;
+  const size_t hSize = 8;
+
+  arma::sp_mat sparseData;
+  sparseData.sprandu(vSize, points, 0.1);
+  arma::mat data(sparseData);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize, 0.1, 2);
+  SparseAutoencoderFunctionType<arma::sp_mat> sparseSaf(sparseData, vSize,
+      hSize, 0.1, 2);
+  // The function keeps an alias of the data, so it must outlive the function.
+  arma::fmat floatData = arma::conv_to<arma::fmat>::from(data);
+  SparseAutoencoderFunctionType<arma::fmat> floatSaf(floatData, vSize, hSize,
+      0.1, 2);
+
+  arma::mat parameters;
+  parameters.randu(2 * hSize + 1, vSize + 1);
+
+  arma::mat gradient, sparseGradient;
+  const double objective = saf.EvaluateWithGradient(parameters, gradient);
+  const double sparseObjective = sparseSaf.EvaluateWithGradient(parameters,
+      sparseGradient);
+  REQUIRE(sparseObjective == Approx(objective).epsilon(1e-10));
+  CheckMatrices(gradient, sparseGradient, 1e-8);
+
+  arma::fmat floatGradient;
+  const float floatObjective = floatSaf.EvaluateWithGradient(
+      arma::conv_to<arma::fmat>::from(parameters), floatGradient);
+  REQUIRE(floatObjective == Approx(objective).epsilon(1e-4));
+  REQUIRE(arma::approx_equal(arma::conv_to<arma::mat>::from(floatGradient),
+      gradient, "absdiff", 1e-4));
+}
+
+TEST_CASE("SparseAutoencoderFunctionSGDOptimization", "[SparseAutoencoderTest]")
+{
+  const size_t points = 1000;
+  const size_t vSize = 20;
+  const size_t hSize = 10;
+
+  arma::mat data;
+  data.randu(vSize, points);
+
+  // The function is separable, so it can be optimized with mini-batches.
+  SparseAutoencoderFunction saf(data, vSize, hSize);
+  arma::mat parameters = saf.GetInitialPoint();
+  const double initialObjective = saf.Evaluate(parameters);
+
+  ens::Adam adam(0.01, 32, 0.9, 0.999, 1e-8, 20 * points, 1e-10, true);
+  adam.Optimize(saf, parameters);
+
+  REQUIRE(saf.Evaluate(parameters) < 0.5 * initialObjective);
+}
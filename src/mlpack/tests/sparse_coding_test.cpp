@@ -212,3 +212,48 @@ TEST_CASE("SparseCodingTrainReturnObjective", "[SparseCodingTest]")
 
   REQUIRE(std::isfinite(objVal) == true);
 }
+
+/**
+ * Test that the points encoded in parallel get the same codes as when each
+ * point is encoded on its own, also when some points have empty codes.
+ */
+TEST_CASE("SparseCodingParallelEncodeTest", "[SparseCodingTest]")
+{
+  double lambda1 = 0.1;
+  uword nAtoms = 25;
+
+  mat X;
+  X.load("mnist_first250_training_4s_and_9s.arm");
+  uword nPoints = X.n_cols;
+
+  // Normalize each point since these are images, and make every third point so
+  // small that its code is empty.
+  for (uword i = 0; i < nPoints; ++i)
+  {
+    X.col(i) /= norm(X.col(i), 2);
+    if (i % 3 == 0)
+      X.col(i) *= 1e-3;
+  }
+
+  SparseCoding sc(nAtoms, lambda1);
+  mat Z;
+  DataDependentRandomInitializer::Initialize(X, 25, sc.Dictionary());
+  sc.Encode(X, Z);
+
+  REQUIRE(Z.n_rows == nAtoms);
+  REQUIRE(Z.n_cols == nPoints);
+
+  const mat& D = sc.Dictionary();
+  for (uword i = 0; i < nPoints; ++i)
+  {
+    LARS<> lars(true, lambda1, 0.0, 1e-16, false, false);
+    rowvec responses = trans(X.col(i));
+    lars.Train(D, responses, false);
+
+    if (i % 3 == 0)
+      REQUIRE(accu(Z.col(i) != 0) == 0);
+
+    for (uword j = 0; j < nAtoms; ++j)
+      REQUIRE(Z(j, i) == Approx(lars.Beta()(j)).margin(1e-8));
+  }
+}
@@ -301,3 +301,62 @@ TEST_CASE("SpillTreeMoveDatasetTest", "[SpillTreeTest]")
   REQUIRE(tree.Dataset().n_rows == 3);
   REQUIRE(tree.Dataset().n_cols == 1000);
 }
+
+/**
+ * Make sure that a spill tree built with several threads is the same as a tree
+ * built with one thread, and that copies of a tree (whose leaves may share the
+ * indexes of their parents) are independent of it.
+ */
+TEST_CASE("SpillTreeParallelBuildTest", "[SpillTreeTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 20000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  TreeType serialTree(dataset, 0.05, 20);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(4);
+#endif
+
+  TreeType parallelTree(dataset, 0.05, 20);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+
+  std::stack<std::pair<TreeType*, TreeType*>> nodes;
+  nodes.push(std::make_pair(&serialTree, &parallelTree));
+  while (!nodes.empty())
+  {
+    TreeType* serialNode = nodes.top().first;
+    TreeType* parallelNode = nodes.top().second;
+    nodes.pop();
+
+    REQUIRE(serialNode->IsLeaf() == parallelNode->IsLeaf());
+    REQUIRE(serialNode->Overlap() == parallelNode->Overlap());
+    REQUIRE(serialNode->NumPoints() == parallelNode->NumPoints());
+    REQUIRE(serialNode->NumDescendants() == parallelNode->NumDescendants());
+    for (size_t i = 0; i < serialNode->NumPoints(); ++i)
+      REQUIRE(serialNode->Point(i) == parallelNode->Point(i));
+
+    if (!serialNode->IsLeaf())
+    {
+      nodes.push(std::make_pair(serialNode->Left(), parallelNode->Left()));
+      nodes.push(std::make_pair(serialNode->Right(), parallelNode->Right()));
+    }
+  }
+
+  // A copy of the tree owns its points, so it stays valid without the
+  // original tree.
+  TreeType* original = new TreeType(dataset, 0.05, 20);
+  TreeType copy(*original);
+  delete original;
+  REQUIRE(copy.NumDescendants() == parallelTree.NumDescendants());
+  for (size_t i = 0; i < copy.NumDescendants(); ++i)
+    REQUIRE(copy.Descendant(i) == parallelTree.Descendant(i));
+}
@@ -433,3 +433,62 @@ TEST_CASE("SplitLabeledDataResultField", "[SplitDataTest]")
   CheckFields(input, inputConcat);
   CheckFields(label, labelConcat);
 }
+
+/**
+ * Check that SplitIndices() gives the points that Split() gives.
+ */
+TEST_CASE("SplitIndicesMatchesSplitTest", "[SplitDataTest]")
+{
+  const mat input(3, 50, fill::randu);
+  const Row<size_t> labels = arma::randi<Row<size_t>>(50,
+      arma::distr_param(0, 4));
+
+  RandomSeed(7);
+  mat trainData, testData;
+  Row<size_t> trainLabels, testLabels;
+  Split(input, labels, trainData, testData, trainLabels, testLabels, 0.3);
+
+  RandomSeed(7);
+  uvec trainIndices, testIndices;
+  SplitIndices(input.n_cols, trainIndices, testIndices, 0.3);
+
+  REQUIRE(trainIndices.n_elem == trainData.n_cols);
+  REQUIRE(testIndices.n_elem == testData.n_cols);
+  CheckMatrices(trainData, mat(input.cols(trainIndices)));
+  CheckMatrices(testData, mat(input.cols(testIndices)));
+  CheckMatrices(trainLabels, Row<size_t>(labels.cols(trainIndices)));
+
+  // Together, the indices must be a permutation of all the points.
+  const uvec all = sort(join_cols(trainIndices, testIndices));
+  CheckMatrices(all, linspace<uvec>(0, 49, 50));
+}
+
+/**
+ * Check that SplitInPlace() reorders the data so that the sets given by Split()
+ * are contiguous.
+ */
+TEST_CASE("SplitInPlaceTest", "[SplitDataTest]")
+{
+  mat input(3, 51, fill::randu);
+  Row<size_t> labels = arma::randi<Row<size_t>>(51, arma::distr_param(0, 4));
+
+  RandomSeed(11);
+  mat trainData, testData;
+  Row<size_t> trainLabels, testLabels;
+  Split(input, labels, trainData, testData, trainLabels, testLabels, 0.2);
+
+  RandomSeed(11);
+  const size_t trainSize = SplitInPlace(input, labels, 0.2);
+
+  REQUIRE(trainSize == trainData.n_cols);
+  CheckMatrices(trainData, mat(input.cols(0, trainSize - 1)));
+  CheckMatrices(testData, mat(input.cols(trainSize, input.n_cols - 1)));
+  CheckMatrices(trainLabels, Row<size_t>(labels.cols(0, trainSize - 1)));
+  CheckMatrices(testLabels,
+      Row<size_t>(labels.cols(trainSize, labels.n_cols - 1)));
+
+  // Without shuffling, the data is not changed.
+  const mat original(input);
+  REQUIRE(SplitInPlace(input, 0.5, false) == 26);
+  CheckMatrices(input, original);
+}
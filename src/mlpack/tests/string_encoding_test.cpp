@@ -1427,3 +1427,94 @@ TEST_CASE("SplitByAnyOfTfIdfEncodingSerialization", "[StringEncodingTest]")
 
   CheckMatrices(output, xmlOutput, jsonOutput, binaryOutput);
 }
+
+/**
+ * Make sure that the sparse output of the bag of words and the tf-idf encoding
+ * algorithms is the same as the dense output.
+ */
+TEST_CASE("SparseStringEncodingTest", "[StringEncodingTest]")
+{
+  SplitByAnyOf tokenizer(" ,.");
+
+  arma::mat denseOutput;
+  arma::sp_mat sparseOutput;
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> bagOfWords;
+  bagOfWords.Encode(stringEncodingInput, denseOutput, tokenizer);
+  bagOfWords.Encode(stringEncodingInput, sparseOutput, tokenizer);
+
+  REQUIRE(sparseOutput.n_rows == denseOutput.n_rows);
+  REQUIRE(sparseOutput.n_cols == denseOutput.n_cols);
+  REQUIRE(sparseOutput.n_nonzero == arma::accu(denseOutput != 0));
+  CheckMatrices(arma::mat(sparseOutput), denseOutput);
+
+  const TfIdfEncodingPolicy::TfTypes tfTypes[] = {
+      TfIdfEncodingPolicy::TfTypes::BINARY,
+      TfIdfEncodingPolicy::TfTypes::RAW_COUNT,
+      TfIdfEncodingPolicy::TfTypes::TERM_FREQUENCY,
+      TfIdfEncodingPolicy::TfTypes::SUBLINEAR_TF };
+
+  for (const TfIdfEncodingPolicy::TfTypes tfType : tfTypes)
+  {
+    TfIdfEncoding<SplitByAnyOf::TokenType> tfIdf(tfType, false);
+    tfIdf.Encode(stringEncodingInput, denseOutput, tokenizer);
+    tfIdf.Encode(stringEncodingInput, sparseOutput, tokenizer);
+
+    REQUIRE(sparseOutput.n_nonzero == arma::accu(denseOutput != 0));
+    CheckMatrices(arma::mat(sparseOutput), denseOutput);
+  }
+
+  // Encode individual characters too.
+  CharExtract charTokenizer;
+  TfIdfEncoding<CharExtract::TokenType> charTfIdf;
+  charTfIdf.Encode(stringEncodingInput, denseOutput, charTokenizer);
+  charTfIdf.Encode(stringEncodingInput, sparseOutput, charTokenizer);
+  CheckMatrices(arma::mat(sparseOutput), denseOutput);
+}
+
+/**
+ * Make sure that a large corpus gets the same labels as when the documents
+ * are added to the dictionary one at a time.
+ */
+TEST_CASE("LargeCorpusBagOfWordsEncodingTest", "[StringEncodingTest]")
+{
+  // Each document has words that first appear in it, and words of earlier
+  // documents.
+  vector<string> input;
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    ostringstream oss;
+    for (size_t j = 0; j < 20; ++j)
+      oss << "w" << ((i * 7 + j * j) % (i + 1 + j)) << ((j % 3) ? " " : ", ");
+    input.push_back(oss.str());
+  }
+
+  SplitByAnyOf tokenizer(" ,");
+  arma::sp_mat output;
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> encoder;
+  encoder.Encode(input, output, tokenizer);
+
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> expected;
+  for (size_t i = 0; i < input.size(); ++i)
+    expected.CreateMap(input[i], tokenizer);
+
+  REQUIRE(encoder.Dictionary().Size() == expected.Dictionary().Size());
+  for (const string& token : expected.Dictionary().Tokens())
+  {
+    REQUIRE(encoder.Dictionary().Value(token) ==
+        expected.Dictionary().Value(token));
+  }
+
+  // Check the counts of the tokens of each document.
+  REQUIRE(output.n_rows == expected.Dictionary().Size());
+  REQUIRE(output.n_cols == input.size());
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    arma::vec counts(output.n_rows, arma::fill::zeros);
+    MLPACK_STRING_VIEW strView(input[i]);
+    for (MLPACK_STRING_VIEW token = tokenizer(strView); !token.empty();
+         token = tokenizer(strView))
+      counts[expected.Dictionary().Value(token) - 1] += 1;
+
+    REQUIRE(arma::accu(arma::abs(arma::vec(output.col(i)) - counts)) == 0);
+  }
+}
@@ -87,3 +87,22 @@ TEST_CASE("BatchUpdate", "[SumTreeTest]")
   CHECK(sumtree.FindPrefixSum(2.8) <= 3);
   CHECK(sumtree.FindPrefixSum(3.0) <= 3);
 }
+
+/**
+ * Test that FindPrefixSums() finds the same indices as FindPrefixSum().
+ */
+TEST_CASE("FindPrefixSums", "[SumTreeTest]")
+{
+  SumTree<double> sumtree(16);
+  for (size_t i = 0; i < 16; ++i)
+    sumtree.Set(i, 0.1 + Random());
+
+  arma::vec masses = arma::sort(sumtree.Sum() * arma::randu<arma::vec>(50));
+  arma::vec originalMasses = masses;
+  arma::ucolvec indices;
+  sumtree.FindPrefixSums(masses, indices);
+
+  REQUIRE(indices.n_elem == 50);
+  for (size_t i = 0; i < 50; ++i)
+    CHECK(indices[i] == sumtree.FindPrefixSum(originalMasses[i]));
+}
@@ -0,0 +1,79 @@
+/**
+ * @file tests/thread_all_reduce.hpp
+ *
+ * An all-reduce policy over the threads of one process, to test algorithms that
+ * run on sharded data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_TESTS_THREAD_ALL_REDUCE_HPP
+#define MLPACK_TESTS_THREAD_ALL_REDUCE_HPP
+
+#include <mlpack/core.hpp>
+
+#include <condition_variable>
+#include <mutex>
+
+namespace mlpack {
+
+/**
+ * An all-reduce policy over threads of the same process, to simulate training
+ * over sharded data.  Sum() blocks until every thread has given its matrix.
+ */
+class ThreadAllReduce
+{
+ public:
+  struct State
+  {
+    State(const size_t size) : size(size), arrived(0), round(0) { }
+
+    size_t size;
+    size_t arrived;
+    size_t round;
+    arma::mat sum;
+    arma::mat result;
+    std::mutex mutex;
+    std::condition_variable done;
+  };
+
+  ThreadAllReduce(State& state, const size_t rank) : state(state), rank(rank)
+  { }
+
+  size_t Rank() const { return rank; }
+  size_t Size() const { return state.size; }
+
+  void Sum(arma::mat& values) const
+  {
+    std::unique_lock<std::mutex> lock(state.mutex);
+    if (state.arrived == 0)
+      state.sum = values;
+    else
+      state.sum += values;
+
+    const size_t round = state.round;
+    if (++state.arrived == state.size)
+    {
+      state.result = state.sum;
+      state.arrived = 0;
+      ++state.round;
+      state.done.notify_all();
+    }
+    else
+    {
+      state.done.wait(lock, [&]() { return state.round != round; });
+    }
+
+    values = state.result;
+  }
+
+ private:
+  State& state;
+  size_t rank;
+};
+
+} // namespace mlpack
+
+#endif
@@ -143,3 +143,121 @@ TEST_CASE("DisabledTimingTest", "[TimerTest]")
 
   REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
+
+/**
+ * Make sure that nested scoped timers record their parents, that every thread
+ * records into its own buffer, and that the trace can be exported.
+ */
+TEST_CASE("ScopedTimerTraceTest", "[TimerTest]")
+{
+  Trace::Reset();
+
+  // Nothing is recorded while tracing is disabled.
+  {
+    ScopedTimer t("disabled");
+  }
+  REQUIRE(Trace::Events().size() == 0);
+
+  Trace::Enable();
+  {
+    ScopedTimer outer("outer");
+    for (size_t i = 0; i < 3; ++i)
+    {
+      ScopedTimer inner("inner");
+    }
+  }
+
+  std::thread threads[2];
+  for (size_t i = 0; i < 2; ++i)
+  {
+    threads[i] = std::thread([]()
+        {
+          ScopedTimer t("thread");
+          ScopedTimer u("work");
+        });
+  }
+  for (size_t i = 0; i < 2; ++i)
+    threads[i].join();
+  Trace::Disable();
+
+  const std::vector<TraceEvent> events = Trace::Events();
+  REQUIRE(events.size() == 8);
+  std::map<std::string, size_t> paths;
+  std::set<size_t> threadIds;
+  for (const TraceEvent& e : events)
+  {
+    ++paths[e.path];
+    threadIds.insert(e.thread);
+    REQUIRE(e.end >= e.start);
+    REQUIRE(e.depth == size_t(std::count(e.path.begin(), e.path.end(), '/')));
+  }
+  REQUIRE(paths["outer"] == 1);
+  REQUIRE(paths["outer/inner"] == 3);
+  REQUIRE(paths["thread"] == 2);
+  REQUIRE(paths["thread/work"] == 2);
+  REQUIRE(threadIds.size() == 3);
+
+  // The CSV has one row per path.
+  Trace::Save("trace_test.csv");
+  std::ifstream csv("trace_test.csv");
+  std::string line;
+  std::vector<std::string> lines;
+  while (std::getline(csv, line))
+    lines.push_back(line);
+  REQUIRE(lines.size() == 5);
+  REQUIRE(lines[0] == "path,calls,total_us,self_us");
+  REQUIRE(lines[2].substr(0, 14) == "outer/inner,3,");
+
+  // The Chrome trace has one complete event per interval.
+  Trace::Save("trace_test.json");
+  std::ifstream json("trace_test.json");
+  const std::string contents((std::istreambuf_iterator<char>(json)),
+      std::istreambuf_iterator<char>());
+  size_t numEvents = 0;
+  for (size_t pos = contents.find("\"ph\":\"X\""); pos != std::string::npos;
+      pos = contents.find("\"ph\":\"X\"", pos + 1))
+    ++numEvents;
+  REQUIRE(numEvents == 8);
+  REQUIRE(contents.find("\"path\":\"outer/inner\"") != std::string::npos);
+
+  remove("trace_test.csv");
+  remove("trace_test.json");
+  Trace::Reset();
+}
+
+/**
+ * Make sure the MemoryTracker counts nodes and finds the peak of a phase.
+ */
+TEST_CASE("MemoryTrackerPhaseTest", "[TimerTest]")
+{
+  REQUIRE(MemoryTracker::PrintBytes(512) == "512 B");
+  REQUIRE(MemoryTracker::PrintBytes(1536) == "1.50 KiB");
+  REQUIRE(MemoryTracker::PrintBytes(-3 * 1024 * 1024) == "-3.00 MiB");
+
+  const size_t liveNodes =
+      MemoryTracker::LiveAllocations(MemoryTracker::TreeNodes);
+  {
+    MemoryTracker::NodeCounter a(100);
+    MemoryTracker::NodeCounter b(a);
+    REQUIRE(MemoryTracker::LiveAllocations(MemoryTracker::TreeNodes) ==
+        liveNodes + 2);
+  }
+  REQUIRE(MemoryTracker::LiveAllocations(MemoryTracker::TreeNodes) ==
+      liveNodes);
+
+  // A phase sees the peak of its own allocations, and the enclosing phase sees
+  // it too.
+  const size_t start = MemoryTracker::CurrentBytes();
+  const size_t outer = MemoryTracker::BeginPhase();
+  const size_t inner = MemoryTracker::BeginPhase();
+  MemoryTracker::Allocate(MemoryTracker::TreeNodes, 1000);
+  MemoryTracker::Deallocate(MemoryTracker::TreeNodes, 1000);
+  const size_t innerPeak = MemoryTracker::EndPhase(inner);
+  MemoryTracker::Allocate(MemoryTracker::TreeNodes, 10);
+  MemoryTracker::Deallocate(MemoryTracker::TreeNodes, 10);
+  const size_t outerPeak = MemoryTracker::EndPhase(outer);
+
+  REQUIRE(innerPeak >= start + 1000);
+  REQUIRE(outerPeak >= innerPeak);
+  REQUIRE(MemoryTracker::CurrentBytes() == start);
+}
@@ -1030,6 +1030,56 @@ TEST_CASE("HRectBoundDiameter", "[TreeTest]")
   REQUIRE(d.Diameter() == Approx(0.0).margin(1e-5));
 }
 
+/**
+ * Ensure that the fixed-dimension code paths of HRectBound::MinDistance() and
+ * HRectBound::MaxDistance(), which are used for 2 to 8 dimensions, give the
+ * same results as a brute-force computation.
+ */
+TEST_CASE("HRectBoundFixedDimensionTest", "[TreeTest]")
+{
+  for (size_t d = 1; d <= 10; ++d)
+  {
+    arma::mat points(d, 10, arma::fill::randu);
+    arma::mat otherPoints(d, 10, arma::fill::randu);
+    otherPoints += 0.5;
+
+    HRectBound<EuclideanDistance> a(d), b(d);
+    a |= points;
+    b |= otherPoints;
+
+    arma::vec point(d, arma::fill::randn);
+
+    // The closest point of a bound to a point is the point clamped to the
+    // bound, and the furthest point is the furthest corner.
+    arma::vec closest(d), furthest(d);
+    for (size_t i = 0; i < d; ++i)
+    {
+      closest[i] = std::min(std::max(point[i], a[i].Lo()), a[i].Hi());
+      furthest[i] = (std::abs(point[i] - a[i].Lo()) >
+          std::abs(point[i] - a[i].Hi())) ? a[i].Lo() : a[i].Hi();
+    }
+
+    REQUIRE(a.MinDistance(point) ==
+        Approx(arma::norm(point - closest, 2)).margin(1e-7));
+    REQUIRE(a.MaxDistance(point) ==
+        Approx(arma::norm(point - furthest, 2)).epsilon(1e-7));
+
+    // Do the same for the distance between the two bounds.
+    arma::vec gap(d), span(d);
+    for (size_t i = 0; i < d; ++i)
+    {
+      gap[i] = std::max(0.0, std::max(b[i].Lo() - a[i].Hi(),
+          a[i].Lo() - b[i].Hi()));
+      span[i] = std::max(b[i].Hi() - a[i].Lo(), a[i].Hi() - b[i].Lo());
+    }
+
+    REQUIRE(a.MinDistance(b) == Approx(arma::norm(gap, 2)).margin(1e-7));
+    REQUIRE(b.MinDistance(a) == Approx(arma::norm(gap, 2)).margin(1e-7));
+    REQUIRE(a.MaxDistance(b) == Approx(arma::norm(span, 2)).epsilon(1e-7));
+    REQUIRE(b.MaxDistance(a) == Approx(arma::norm(span, 2)).epsilon(1e-7));
+  }
+}
+
 /**
  * It seems as though Bill has stumbled across a bug where
  * BinarySpaceTree<>::count() returns something different than
@@ -1262,6 +1312,192 @@ TEST_CASE("ParentDistanceTestWithMapping", "[TreeTest]")
   }
 }
 
+/**
+ * Make sure that the mapping returned by a tree that is large enough to be
+ * built in parallel is a correct permutation of the dataset.
+ */
+template<typename TreeType>
+void CheckParallelBuildMapping(const arma::mat& dataset)
+{
+  std::vector<size_t> oldFromNew, newFromOld;
+  TreeType tree(dataset, oldFromNew, newFromOld);
+
+  REQUIRE(tree.NumDescendants() == dataset.n_cols);
+  REQUIRE(oldFromNew.size() == dataset.n_cols);
+  REQUIRE(newFromOld.size() == dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(newFromOld[oldFromNew[i]] == i);
+    for (size_t j = 0; j < dataset.n_rows; ++j)
+      REQUIRE(tree.Dataset()(j, i) == dataset(j, oldFromNew[i]));
+  }
+}
+
+/**
+ * Build trees with every split type on a dataset large enough that the
+ * children of the top nodes are built in parallel, and check the mappings.
+ */
+TEST_CASE("ParallelBuildMappingTest", "[TreeTest]")
+{
+  arma::mat dataset(4, 20000, arma::fill::randu);
+
+  CheckParallelBuildMapping<KDTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>(dataset);
+  CheckParallelBuildMapping<MeanSplitKDTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>(dataset);
+  CheckParallelBuildMapping<BallTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>(dataset);
+  CheckParallelBuildMapping<VPTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>(dataset);
+  CheckParallelBuildMapping<MaxRPTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>(dataset);
+  CheckParallelBuildMapping<RPTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>(dataset);
+  CheckParallelBuildMapping<UBTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>(dataset);
+}
+
+#ifdef MLPACK_USE_OPENMP
+/**
+ * A kd-tree built with several threads should be exactly the same as one built
+ * with a single thread.
+ */
+TEST_CASE("ParallelBuildMatchesSerialBuildTest", "[TreeTest]")
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  arma::mat dataset(3, 30000, arma::fill::randu);
+
+  const int oldThreads = omp_get_max_threads();
+  std::vector<size_t> serialOldFromNew, parallelOldFromNew;
+
+  omp_set_num_threads(1);
+  TreeType serialTree(dataset, serialOldFromNew);
+  omp_set_num_threads(std::max(oldThreads, 4));
+  TreeType parallelTree(dataset, parallelOldFromNew);
+  omp_set_num_threads(oldThreads);
+
+  REQUIRE(serialOldFromNew == parallelOldFromNew);
+
+  std::stack<std::pair<TreeType*, TreeType*>> nodeStack;
+  nodeStack.push(std::make_pair(&serialTree, &parallelTree));
+  while (!nodeStack.empty())
+  {
+    TreeType* a = nodeStack.top().first;
+    TreeType* b = nodeStack.top().second;
+    nodeStack.pop();
+
+    REQUIRE(a->Begin() == b->Begin());
+    REQUIRE(a->Count() == b->Count());
+    REQUIRE(a->NumChildren() == b->NumChildren());
+    if (a->NumChildren() == 2)
+    {
+      nodeStack.push(std::make_pair(a->Left(), b->Left()));
+      nodeStack.push(std::make_pair(a->Right(), b->Right()));
+    }
+  }
+}
+
+/**
+ * The hollow of each right child of a VP-tree is centered at the center of its
+ * left sibling, which may be built at the same time in another task.  Make
+ * sure the bounds of a VP-tree built with several threads are the same as
+ * those of one built with a single thread.
+ */
+TEST_CASE("ParallelBuildVPTreeBoundsTest", "[TreeTest]")
+{
+  typedef VPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  arma::mat dataset(3, 30000, arma::fill::randu);
+
+  const int oldThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  TreeType serialTree(dataset);
+  omp_set_num_threads(std::max(oldThreads, 4));
+  TreeType parallelTree(dataset);
+  omp_set_num_threads(oldThreads);
+
+  std::stack<std::pair<TreeType*, TreeType*>> nodeStack;
+  nodeStack.push(std::make_pair(&serialTree, &parallelTree));
+  while (!nodeStack.empty())
+  {
+    TreeType* a = nodeStack.top().first;
+    TreeType* b = nodeStack.top().second;
+    nodeStack.pop();
+
+    REQUIRE(a->Begin() == b->Begin());
+    REQUIRE(a->Count() == b->Count());
+    REQUIRE(a->NumChildren() == b->NumChildren());
+    REQUIRE(a->Bound().OuterRadius() == b->Bound().OuterRadius());
+    REQUIRE(a->Bound().InnerRadius() == b->Bound().InnerRadius());
+    CheckMatrices(a->Bound().Center(), b->Bound().Center(), 0.0);
+    CheckMatrices(a->Bound().HollowCenter(), b->Bound().HollowCenter(), 0.0);
+    if (a->NumChildren() == 2)
+    {
+      nodeStack.push(std::make_pair(a->Left(), b->Left()));
+      nodeStack.push(std::make_pair(a->Right(), b->Right()));
+    }
+  }
+}
+#endif
+
+/**
+ * Make sure that a compacted tree has the same structure as the original tree,
+ * and that its nodes are stored contiguously in depth-first order.
+ */
+TEST_CASE("CompactTreeTest", "[TreeTest]")
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  arma::mat dataset(4, 2000, arma::fill::randu);
+
+  TreeType tree(dataset);
+  TreeType copy(tree);
+  tree.Compact();
+  REQUIRE(tree.IsCompact());
+  REQUIRE(!copy.IsCompact());
+
+  // Only the root can be compacted.
+  REQUIRE_THROWS_AS(tree.Left()->Compact(), std::invalid_argument);
+
+  const TreeType* last = NULL;
+  std::stack<std::pair<TreeType*, TreeType*>> nodeStack;
+  nodeStack.push(std::make_pair(&tree, &copy));
+  while (!nodeStack.empty())
+  {
+    TreeType* a = nodeStack.top().first;
+    TreeType* b = nodeStack.top().second;
+    nodeStack.pop();
+
+    REQUIRE(a->Begin() == b->Begin());
+    REQUIRE(a->Count() == b->Count());
+    REQUIRE(&a->Dataset() == &tree.Dataset());
+    REQUIRE(a->Bound().Diameter() == Approx(b->Bound().Diameter()));
+
+    // Every non-root node should directly follow the node visited before it.
+    if (last != NULL)
+      REQUIRE(a == last + 1);
+    if (a != &tree)
+      last = a;
+
+    REQUIRE(a->NumChildren() == b->NumChildren());
+    if (a->NumChildren() == 2)
+    {
+      REQUIRE(a->Left()->Parent() == a);
+      REQUIRE(a->Right()->Parent() == a);
+      nodeStack.push(std::make_pair(a->Right(), b->Right()));
+      nodeStack.push(std::make_pair(a->Left(), b->Left()));
+    }
+  }
+
+  // Copying and moving a compact tree should work.
+  TreeType copy2(tree);
+  REQUIRE(!copy2.IsCompact());
+  REQUIRE(copy2.NumDescendants() == tree.NumDescendants());
+  TreeType moved(std::move(tree));
+  REQUIRE(moved.IsCompact());
+  REQUIRE(!tree.IsCompact());
+  REQUIRE(moved.Left()->Parent() == &moved);
+}
+
 // Forward declaration of methods we need for the next test.
 template<typename TreeType>
 bool CheckPointBounds(TreeType& node);
@@ -1784,6 +2020,61 @@ TEST_CASE("ExhaustiveSparseKDTreeTest", "[TreeTest]")
   TreeType root(dataset);
 }
 
+/**
+ * Check that two trees have the same structure and the same bounds.
+ */
+template<typename TreeTypeA, typename TreeTypeB>
+void CheckSameTree(const TreeTypeA& a, const TreeTypeB& b)
+{
+  REQUIRE(a.Begin() == b.Begin());
+  REQUIRE(a.Count() == b.Count());
+  REQUIRE(a.NumChildren() == b.NumChildren());
+  for (size_t d = 0; d < a.Bound().Dim(); ++d)
+  {
+    REQUIRE(a.Bound()[d].Lo() == Approx(b.Bound()[d].Lo()).margin(1e-12));
+    REQUIRE(a.Bound()[d].Hi() == Approx(b.Bound()[d].Hi()).margin(1e-12));
+  }
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that a kd-tree built on a sparse matrix is the same as the one
+ * built on the dense version of the matrix, and that the reordered sparse
+ * matrix holds the right points.  Some dimensions have no nonzero elements at
+ * all, and others only have negative nonzero elements.
+ */
+TEST_CASE("SparseKDTreeMatchesDenseTest", "[TreeTest]")
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(12, 5000, 0.15);
+  dataset.row(3).zeros();
+  dataset.row(7) = -dataset.row(7);
+
+  arma::mat denseDataset(dataset);
+
+  std::vector<size_t> sparseOldFromNew, denseOldFromNew;
+  KDTree<EuclideanDistance, EmptyStatistic, arma::sp_mat> sparseTree(
+      dataset, sparseOldFromNew, 15);
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> denseTree(
+      denseDataset, denseOldFromNew, 15);
+
+  REQUIRE(sparseOldFromNew == denseOldFromNew);
+  CheckSameTree(denseTree, sparseTree);
+
+  const arma::mat treeset(sparseTree.Dataset());
+  REQUIRE(treeset.n_cols == dataset.n_cols);
+  REQUIRE(sparseTree.Dataset().n_nonzero == dataset.n_nonzero);
+  for (size_t i = 0; i < treeset.n_cols; ++i)
+  {
+    REQUIRE(arma::approx_equal(treeset.col(i),
+        arma::vec(dataset.col(sparseOldFromNew[i])), "absdiff", 1e-15));
+  }
+
+  CheckPointBounds(sparseTree);
+}
+
 TEST_CASE("BinarySpaceTreeMoveConstructorTest", "[TreeTest]")
 {
   arma::mat dataset(5, 1000);
@@ -1796,6 +2087,193 @@ TEST_CASE("BinarySpaceTreeMoveConstructorTest", "[TreeTest]")
   REQUIRE(tree2.NumChildren() == 2);
 }
 
+/**
+ * Check that every node of a tree that was updated covers the contiguous range
+ * of its children, that its bound contains its points, and that its cached
+ * distances are consistent.
+ */
+template<typename TreeType>
+void CheckUpdatedTree(TreeType& node, const size_t maxLeafSize)
+{
+  arma::vec center;
+  node.Center(center);
+  for (size_t i = 0; i < node.NumDescendants(); ++i)
+  {
+    const arma::vec point = node.Dataset().col(node.Descendant(i));
+    REQUIRE(node.Bound().Contains(point));
+    REQUIRE(EuclideanDistance::Evaluate(center, point) <=
+        node.FurthestDescendantDistance() * (1 + 1e-10) + 1e-10);
+  }
+
+  if (node.IsLeaf())
+  {
+    REQUIRE(node.Count() <= maxLeafSize);
+    return;
+  }
+
+  REQUIRE(node.Left()->Parent() == &node);
+  REQUIRE(node.Right()->Parent() == &node);
+  REQUIRE(node.Left()->Begin() == node.Begin());
+  REQUIRE(node.Right()->Begin() == node.Begin() + node.Left()->Count());
+  REQUIRE(node.Left()->Count() + node.Right()->Count() == node.Count());
+  REQUIRE(node.Left()->Count() > 0);
+  REQUIRE(node.Right()->Count() > 0);
+
+  arma::vec leftCenter;
+  node.Left()->Center(leftCenter);
+  REQUIRE(node.Left()->ParentDistance() ==
+      Approx(EuclideanDistance::Evaluate(center, leftCenter)).margin(1e-10));
+
+  CheckUpdatedTree(*node.Left(), maxLeafSize);
+  CheckUpdatedTree(*node.Right(), maxLeafSize);
+}
+
+/**
+ * Make sure that points can be inserted into and deleted from kd-trees and
+ * ball trees, and that the mapping to the original indices is kept.
+ */
+TEMPLATE_TEST_CASE("BinarySpaceTreeInsertDeleteTest", "[TreeTest]",
+    (KDTree<EuclideanDistance, EmptyStatistic, arma::mat>),
+    (BallTree<EuclideanDistance, EmptyStatistic, arma::mat>))
+{
+  typedef TestType TreeType;
+
+  arma::mat dataset(3, 1000, arma::fill::randu);
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew, 10);
+  tree.Compact();
+
+  // Insert a batch far away from the existing points, and one inside of them.
+  arma::mat newPoints(3, 300, arma::fill::randu);
+  newPoints.cols(0, 149) += 5.0;
+  tree.InsertPoints(newPoints, oldFromNew, 10);
+  arma::mat original = arma::join_rows(dataset, newPoints);
+
+  REQUIRE(tree.IsCompact());
+  REQUIRE(tree.NumDescendants() == 1300);
+  CheckUpdatedTree(tree, 10);
+
+  // Delete every third point (in original order).
+  std::vector<size_t> newFromOld(oldFromNew.size());
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    newFromOld[oldFromNew[i]] = i;
+
+  std::vector<size_t> positions;
+  arma::uvec kept;
+  std::vector<arma::uword> keptIndices;
+  for (size_t i = 0; i < original.n_cols; ++i)
+  {
+    if (i % 3 == 0)
+      positions.push_back(newFromOld[i]);
+    else
+      keptIndices.push_back(i);
+  }
+  kept = arma::conv_to<arma::uvec>::from(keptIndices);
+  original = arma::mat(original.cols(kept));
+
+  tree.DeletePoints(positions, oldFromNew, 10);
+  REQUIRE(tree.NumDescendants() == original.n_cols);
+  CheckUpdatedTree(tree, 10);
+
+  // The mapping should be a permutation that maps back to the right points.
+  REQUIRE(oldFromNew.size() == original.n_cols);
+  std::vector<bool> seen(original.n_cols, false);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+  {
+    REQUIRE(oldFromNew[i] < original.n_cols);
+    REQUIRE(!seen[oldFromNew[i]]);
+    seen[oldFromNew[i]] = true;
+    for (size_t d = 0; d < original.n_rows; ++d)
+      REQUIRE(tree.Dataset()(d, i) == original(d, oldFromNew[i]));
+  }
+
+  // Deleting every point leaves an empty leaf.
+  std::vector<size_t> all(tree.NumDescendants());
+  for (size_t i = 0; i < all.size(); ++i)
+    all[i] = i;
+  tree.DeletePoints(all, oldFromNew, 10);
+  REQUIRE(tree.NumDescendants() == 0);
+  REQUIRE(tree.IsLeaf());
+  REQUIRE(oldFromNew.empty());
+
+  // Only the root can be updated, and positions must be valid.
+  tree.InsertPoints(newPoints, 10);
+  REQUIRE(tree.NumDescendants() == 300);
+  CheckUpdatedTree(tree, 10);
+  REQUIRE_THROWS_AS(tree.Left()->InsertPoints(newPoints),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(tree.DeletePoints(std::vector<size_t>(1, 300)),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(tree.InsertPoints(arma::mat(2, 5, arma::fill::randu)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that many small updates trigger rebuilds, so that the tree does not
+ * degenerate.
+ */
+TEST_CASE("BinarySpaceTreeRebuildTest", "[TreeTest]")
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset(2, 100, arma::fill::randu);
+  TreeType tree(dataset, 5);
+
+  // Always insert into the same corner, one point at a time.
+  for (size_t i = 0; i < 400; ++i)
+  {
+    arma::mat point(2, 1, arma::fill::randu);
+    point *= 0.01;
+    tree.InsertPoints(point, 5);
+    REQUIRE(tree.Updates() <= TreeType::RebuildFraction * tree.Count());
+  }
+
+  CheckUpdatedTree(tree, 5);
+
+  // The subtrees that were rebuilt should be balanced, so the depth of the tree
+  // should stay logarithmic.
+  size_t maxDepth = 0;
+  std::stack<std::pair<const TreeType*, size_t>> stack;
+  stack.push(std::make_pair(&tree, 0));
+  while (!stack.empty())
+  {
+    const TreeType* node = stack.top().first;
+    const size_t depth = stack.top().second;
+    stack.pop();
+    maxDepth = std::max(maxDepth, depth);
+    if (!node->IsLeaf())
+    {
+      stack.push(std::make_pair(node->Left(), depth + 1));
+      stack.push(std::make_pair(node->Right(), depth + 1));
+    }
+  }
+
+  REQUIRE(maxDepth < 30);
+}
+
+/**
+ * Make sure that refitting a tree after its points were transformed gives
+ * valid bounds and cached distances.
+ */
+TEMPLATE_TEST_CASE("BinarySpaceTreeRefitBoundsTest", "[TreeTest]",
+    (KDTree<EuclideanDistance, EmptyStatistic, arma::mat>),
+    (BallTree<EuclideanDistance, EmptyStatistic, arma::mat>))
+{
+  typedef TestType TreeType;
+
+  arma::mat dataset(3, 500, arma::fill::randu);
+  TreeType tree(dataset, 10);
+  const size_t numDescendants = tree.NumDescendants();
+
+  // Map every point by the same transformation.
+  arma::mat transformation(3, 3, arma::fill::randn);
+  tree.Dataset() = transformation * tree.Dataset();
+  tree.RefitBounds();
+
+  REQUIRE(tree.NumDescendants() == numDescendants);
+  CheckUpdatedTree(tree, 10);
+}
+
 template<typename TreeType>
 void RecurseTreeCountLeaves(const TreeType& node, arma::vec& counts)
 {
@@ -1976,6 +2454,57 @@ TEST_CASE("SparseCoverTreeConstructionTest", "[TreeTest]")
   // in our implementation.
 }
 
+/**
+ * Check that two cover trees have the same structure.
+ */
+template<typename TreeType>
+void CheckSameCoverTree(const TreeType& a, const TreeType& b)
+{
+  REQUIRE(a.Point() == b.Point());
+  REQUIRE(a.Scale() == b.Scale());
+  REQUIRE(a.NumDescendants() == b.NumDescendants());
+  REQUIRE(a.ParentDistance() == b.ParentDistance());
+  REQUIRE(a.FurthestDescendantDistance() == b.FurthestDescendantDistance());
+  REQUIRE(a.NumChildren() == b.NumChildren());
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameCoverTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that building a cover tree with several threads gives the same tree
+ * as building it with one thread.
+ */
+TEST_CASE("CoverTreeParallelConstructionTest", "[TreeTest]")
+{
+  arma::mat dataset;
+  dataset.randu(20, 5000);
+
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+
+#ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  TreeType serialTree(dataset);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(4);
+#endif
+
+  TreeType parallelTree(dataset);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+
+  REQUIRE(serialTree.DistanceComps() == parallelTree.DistanceComps());
+  CheckSameCoverTree(serialTree, parallelTree);
+  CheckCovering<TreeType, LMetric<2, true> >(parallelTree);
+}
+
 /**
  * Test the manual constructor.
  */
@@ -2277,3 +2806,38 @@ TEST_CASE("CoverTreeDescendantTest", "[TreeTest]")
   // using the recursive function above.
   CheckDescendants(&tree);
 }
+
+/**
+ * Make sure that SplitQueryTree() splits a tree into disjoint subtrees that
+ * hold every point, from largest to smallest.
+ */
+TEST_CASE("SplitQueryTreeTest", "[TreeTest]")
+{
+  arma::mat dataset(3, 1000, arma::fill::randu);
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> tree(dataset);
+
+  const size_t maxSubtrees[] = { 1, 2, 7, 16, 10000 };
+  for (const size_t max : maxSubtrees)
+  {
+    std::vector<KDTree<EuclideanDistance, EmptyStatistic, arma::mat>*>
+        subtrees = SplitQueryTree(tree, max);
+    REQUIRE(subtrees.size() >= 1);
+    REQUIRE(subtrees.size() <= max);
+
+    std::vector<size_t> counts(dataset.n_cols, 0);
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      if (i > 0)
+      {
+        REQUIRE(subtrees[i]->NumDescendants() <=
+            subtrees[i - 1]->NumDescendants());
+      }
+
+      for (size_t j = 0; j < subtrees[i]->NumDescendants(); ++j)
+        ++counts[subtrees[i]->Descendant(j)];
+    }
+
+    for (size_t i = 0; i < counts.size(); ++i)
+      REQUIRE(counts[i] == 1);
+  }
+}
@@ -45,3 +45,32 @@ TEST_CASE("TestUnion", "[UnionFindTest]")
   REQUIRE(testUnionFind.Find(1) == testUnionFind.Find(5));
   REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
+
+/**
+ * Make sure that Find() gives the right components when it is called from
+ * several threads at once, while the paths are being compressed.
+ */
+TEST_CASE("TestConcurrentFind", "[UnionFindTest]")
+{
+  static const size_t testSize = 10000;
+  UnionFind testUnionFind(testSize);
+
+  // Make three components; the element i is in the component i % 3.
+  for (size_t i = 3; i < testSize; ++i)
+    testUnionFind.Union(i - 3, i);
+
+  arma::Col<size_t> components(testSize);
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (size_t i = 0; i < testSize; ++i)
+    components[testSize - 1 - i] = testUnionFind.Find(testSize - 1 - i);
+
+  for (size_t i = 0; i < testSize; ++i)
+  {
+    REQUIRE(components[i] == testUnionFind.Find(i % 3));
+    REQUIRE(testUnionFind.Find(i) == components[i]);
+  }
+
+  REQUIRE(components[0] != components[1]);
+  REQUIRE(components[1] != components[2]);
+  REQUIRE(components[0] != components[2]);
+}
@@ -11,9 +11,13 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/xgboost/loss_functions/sse_loss.hpp>
+#include <mlpack/methods/xgboost/xgboost_regressor.hpp>
+
+#include <thread>
 
 #include "catch.hpp"
 #include "serialization.hpp"
+#include "thread_all_reduce.hpp"
 
 using namespace mlpack;
 
@@ -63,3 +67,296 @@ TEST_CASE("SSEGainTest", "[XGBTest]")
   SSELoss Loss;
   REQUIRE(Loss.Evaluate<false>(input, weights) == gain);
 }
+
+/**
+ * Test that the gradient boosting interface of SSE Loss is consistent with its
+ * node interface.
+ */
+TEST_CASE("SSEGradientsTest", "[XGBTest]")
+{
+  arma::rowvec observed = { 1,   3,   2,   2, 5, 6, 9,    11, 8,   8 };
+  arma::rowvec predicted = { 0.5, 1, 2.5, 1.5, 5, 8, 8, 10.75, 9, 9.5 };
+  arma::mat input = arma::join_cols(observed, predicted);
+  arma::vec weights; // dummy weights not used.
+
+  SSELoss loss(0.1, 1.0);
+  const double gain = loss.Evaluate<false>(input, weights);
+  const double leafValue = loss.OutputLeafValue(input, weights);
+
+  arma::vec gradients, hessians;
+  loss.Gradients(observed, predicted, gradients, hessians);
+  REQUIRE(gradients.n_elem == 10);
+  REQUIRE(hessians.n_elem == 10);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    REQUIRE(gradients[i] == Approx(predicted[i] - observed[i]));
+    REQUIRE(hessians[i] == 1.0);
+  }
+
+  REQUIRE(loss.Gain(accu(gradients), accu(hessians)) == Approx(gain));
+  REQUIRE(loss.LeafValue(accu(gradients), accu(hessians)) ==
+      Approx(leafValue));
+  REQUIRE(loss.Loss(observed, predicted) ==
+      Approx(0.5 * accu(arma::square(observed - predicted)) / 10));
+}
+
+/**
+ * Make sure that a depth-one tree finds the obvious split of a step function,
+ * and that its leaves hold the scaled Newton step of each side.
+ */
+TEST_CASE("XGBoostTreeStepTest", "[XGBTest]")
+{
+  arma::mat data(1, 100);
+  arma::rowvec responses(100);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    data(0, i) = i;
+    responses[i] = (i < 30) ? 1.0 : 5.0;
+  }
+
+  XGBoostRegressor<> xgb(1, 0.5, 1, 1.0, 0.0);
+  xgb.Train(data, responses);
+
+  REQUIRE(xgb.NumTreesTrained() == 1);
+  REQUIRE(xgb.Tree(0).NumLeaves() == 2);
+
+  // The initial prediction is the mean, 3.8; each leaf moves half of the way
+  // towards the mean of its side.
+  REQUIRE(xgb.InitialPrediction() == Approx(3.8));
+  arma::vec point(1);
+  point[0] = 10.0;
+  REQUIRE(xgb.Predict(point) == Approx(3.8 + 0.5 * (1.0 - 3.8)));
+  point[0] = 80.0;
+  REQUIRE(xgb.Predict(point) == Approx(3.8 + 0.5 * (5.0 - 3.8)));
+  point[0] = 29.0;
+  REQUIRE(xgb.Predict(point) == Approx(3.8 + 0.5 * (1.0 - 3.8)));
+  point[0] = 30.0;
+  REQUIRE(xgb.Predict(point) == Approx(3.8 + 0.5 * (5.0 - 3.8)));
+}
+
+/**
+ * Make sure that the ensemble fits a nonlinear function, with many more
+ * distinct values than bins, and generalizes to new points.
+ */
+TEST_CASE("XGBoostRegressorFitTest", "[XGBTest]")
+{
+  arma::mat data(3, 4000, arma::fill::randu);
+  arma::rowvec responses = arma::sin(4.0 * data.row(0)) +
+      arma::square(data.row(1)) + 0.01 * arma::randn<arma::rowvec>(4000);
+  arma::mat testData(3, 1000, arma::fill::randu);
+  arma::rowvec testResponses = arma::sin(4.0 * testData.row(0)) +
+      arma::square(testData.row(1));
+
+  XGBoostRegressor<> xgb(100, 0.3, 4);
+  const double trainingLoss = xgb.Train(data, responses);
+
+  arma::rowvec predictions;
+  xgb.Predict(data, predictions);
+  REQUIRE(predictions.n_elem == 4000);
+  REQUIRE(SSELoss().Loss(responses, predictions) == Approx(trainingLoss));
+
+  xgb.Predict(testData, predictions);
+  const double mse = arma::mean(arma::square(predictions - testResponses));
+  REQUIRE(mse < 0.02 * arma::var(testResponses));
+}
+
+/**
+ * Make sure that early stopping truncates the ensemble to the trees with the
+ * best validation loss.
+ */
+TEST_CASE("XGBoostRegressorEarlyStoppingTest", "[XGBTest]")
+{
+  // Pure noise: no tree can improve the validation loss much, so training
+  // should stop long before the maximum number of trees.
+  arma::mat data(2, 500, arma::fill::randu);
+  arma::rowvec responses = arma::randn<arma::rowvec>(500);
+  arma::mat validationData(2, 500, arma::fill::randu);
+  arma::rowvec validationResponses = arma::randn<arma::rowvec>(500);
+
+  XGBoostRegressor<> xgb(500, 0.3, 6, 1.0, 0.0);
+  const double bestLoss = xgb.Train(data, responses, validationData,
+      validationResponses, 5);
+
+  REQUIRE(xgb.NumTreesTrained() < 500);
+
+  // The reported loss is that of the kept trees.
+  arma::rowvec predictions;
+  xgb.Predict(validationData, predictions);
+  REQUIRE(SSELoss().Loss(validationResponses, predictions) ==
+      Approx(bestLoss));
+}
+
+/**
+ * Make sure that training on subsamples of the points and dimensions still
+ * fits the data, and that a subsample is really used.
+ */
+TEST_CASE("XGBoostRegressorSubsampleTest", "[XGBTest]")
+{
+  arma::mat data(4, 2000, arma::fill::randu);
+  arma::rowvec responses = 3.0 * data.row(0) - 2.0 * data.row(3);
+
+  XGBoostRegressor<> full(50, 0.3, 4);
+  full.Train(data, responses);
+  XGBoostRegressor<> subsampled(50, 0.3, 4, 1.0, 0.0, 0.5, 0.5);
+  subsampled.Train(data, responses);
+
+  arma::rowvec fullPredictions, subsampledPredictions;
+  full.Predict(data, fullPredictions);
+  subsampled.Predict(data, subsampledPredictions);
+
+  REQUIRE(arma::mean(arma::square(subsampledPredictions - responses)) <
+      0.05 * arma::var(responses));
+  REQUIRE(arma::abs(fullPredictions - subsampledPredictions).max() > 1e-5);
+}
+
+/**
+ * Make sure the predictions do not depend on the number of threads.
+ */
+TEST_CASE("XGBoostRegressorThreadsTest", "[XGBTest]")
+{
+  arma::mat data(5, 20000, arma::fill::randu);
+  arma::rowvec responses = data.row(0) % data.row(1) + data.row(2);
+
+  RandomSeed(7);
+  XGBoostRegressor<> xgb(10, 0.3, 6, 1.0, 0.0, 0.8, 0.8);
+  xgb.Train(data, responses);
+  arma::rowvec predictions;
+  xgb.Predict(data, predictions);
+
+#ifdef MLPACK_USE_OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  RandomSeed(7);
+  XGBoostRegressor<> serialXgb(10, 0.3, 6, 1.0, 0.0, 0.8, 0.8);
+  serialXgb.Train(data, responses);
+  arma::rowvec serialPredictions;
+  serialXgb.Predict(data, serialPredictions);
+
+#ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(threads);
+#endif
+
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    REQUIRE(predictions[i] == Approx(serialPredictions[i]).epsilon(1e-10));
+}
+
+/**
+ * Make sure that training on shards of the data gives the same model on every
+ * shard, and that it fits as well as training on all the data.
+ */
+TEST_CASE("XGBoostRegressorShardedTest", "[XGBTest]")
+{
+  arma::mat data(4, 6000, arma::fill::randu);
+  arma::rowvec responses = arma::sin(4.0 * data.row(0)) +
+      arma::square(data.row(1)) + 0.5 * data.row(3);
+  arma::mat testData(4, 1000, arma::fill::randu);
+  arma::rowvec testResponses = arma::sin(4.0 * testData.row(0)) +
+      arma::square(testData.row(1)) + 0.5 * testData.row(3);
+
+  // Shards of different sizes, with different value ranges in dimension 0.
+  const arma::uvec order = arma::sort_index(data.row(0) +
+      0.5 * arma::randu<arma::rowvec>(data.n_cols));
+  const size_t bounds[4] = { 0, 1000, 3500, 6000 };
+
+  ThreadAllReduce::State state(3);
+  std::vector<XGBoostRegressor<>> models(3,
+      XGBoostRegressor<>(50, 0.3, 4, 1.0, 0.0, 1.0, 0.75));
+  std::vector<double> losses(3);
+  std::vector<std::thread> threads;
+  for (size_t p = 0; p < 3; ++p)
+  {
+    threads.push_back(std::thread([&, p]()
+    {
+      const arma::uvec shard = order.subvec(bounds[p], bounds[p + 1] - 1);
+      const arma::mat shardData = data.cols(shard);
+      const arma::rowvec shardResponses = responses.cols(shard);
+      losses[p] = models[p].Train(shardData, shardResponses,
+          ThreadAllReduce(state, p));
+    }));
+  }
+  for (size_t p = 0; p < 3; ++p)
+    threads[p].join();
+
+  arma::rowvec predictions;
+  models[0].Predict(data, predictions);
+  REQUIRE(SSELoss().Loss(responses, predictions) == Approx(losses[0]));
+
+  for (size_t p = 1; p < 3; ++p)
+  {
+    REQUIRE(models[p].NumTreesTrained() == 50);
+    REQUIRE(losses[p] == Approx(losses[0]));
+
+    arma::rowvec shardPredictions;
+    models[p].Predict(testData, shardPredictions);
+    models[0].Predict(testData, predictions);
+    for (size_t i = 0; i < predictions.n_elem; ++i)
+      REQUIRE(shardPredictions[i] == Approx(predictions[i]).epsilon(1e-10));
+  }
+
+  XGBoostRegressor<> xgb(50, 0.3, 4);
+  xgb.Train(data, responses);
+  arma::rowvec fullPredictions;
+  xgb.Predict(testData, fullPredictions);
+
+  const double mse = arma::mean(arma::square(predictions - testResponses));
+  const double fullMse = arma::mean(arma::square(fullPredictions -
+      testResponses));
+  REQUIRE(mse < 0.02 * arma::var(testResponses));
+  REQUIRE(mse < 2.0 * fullMse + 1e-4);
+}
+
+/**
+ * Make sure invalid parameters and data are rejected.
+ */
+TEST_CASE("XGBoostRegressorInvalidTest", "[XGBTest]")
+{
+  REQUIRE_THROWS_AS(XGBoostRegressor<>(10, 0.0), std::invalid_argument);
+  REQUIRE_THROWS_AS(XGBoostRegressor<>(10, 0.3, 6, 1.0, 0.0, 1.5),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(XGBoostRegressor<>(10, 0.3, 6, 1.0, 0.0, 1.0, 0.0),
+      std::invalid_argument);
+
+  arma::mat data(2, 10, arma::fill::randu);
+  arma::rowvec responses(9, arma::fill::randu);
+  XGBoostRegressor<> xgb(5);
+  REQUIRE_THROWS_AS(xgb.Train(data, responses), std::invalid_argument);
+
+  responses.randu(10);
+  xgb.Train(data, responses);
+  arma::rowvec predictions;
+  REQUIRE_THROWS_AS(xgb.Predict(arma::mat(3, 5, arma::fill::randu),
+      predictions), std::invalid_argument);
+}
+
+/**
+ * Make sure that a serialized model gives the same predictions.
+ */
+TEST_CASE("XGBoostRegressorSerializationTest", "[XGBTest]")
+{
+  arma::mat data(3, 500, arma::fill::randu);
+  arma::rowvec responses = data.row(0) + arma::square(data.row(2));
+
+  XGBoostRegressor<> xgb(20, 0.3, 4, 1.0, 0.0, 1.0, 1.0, SSELoss(0.1, 1.0));
+  xgb.Train(data, responses);
+
+  arma::rowvec predictions;
+  xgb.Predict(data, predictions);
+
+  XGBoostRegressor<> xmlXgb, jsonXgb, binaryXgb;
+  SerializeObjectAll(xgb, xmlXgb, jsonXgb, binaryXgb);
+
+  REQUIRE(xmlXgb.NumTreesTrained() == 20);
+  REQUIRE(xmlXgb.Loss().Alpha() == 0.1);
+  REQUIRE(jsonXgb.Loss().Lambda() == 1.0);
+  REQUIRE(binaryXgb.MaximumDepth() == 4);
+
+  arma::rowvec xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlXgb.Predict(data, xmlPredictions);
+  jsonXgb.Predict(data, jsonPredictions);
+  binaryXgb.Predict(data, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}